@@ -0,0 +1,198 @@
+/**
+ * @file sha256_bench.c
+ * @brief Замер SHA256 контроллера на целевой плате (make sha256-bench)
+ *
+ * Печатает циклы на transform, на SHA256d заголовка (проверка nonce)
+ * и на midstate (перебор версий, аренда extranonce) для реализации,
+ * выбранной SHA256_IMPL. Перед замером сверяет хеш genesis блока.
+ *
+ * Счётчик циклов: DWT_CYCCNT на Cortex-M, PMCCNTR на ARMv7-A / ARMv8;
+ * на остальных - наносекунды timespec_get (сборка на хосте).
+ */
+
+#include "sha256.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+
+#if !defined(__arm__) && !defined(__aarch64__)
+#include <time.h>
+#endif
+
+#define BENCH_ITERATIONS    10000
+#define BENCH_ROUNDS        5       /* Лучший из повторов */
+
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) || defined(__ARM_ARCH_8M_MAIN__)
+#define CYCLE_UNIT "циклов"
+#define DEMCR       (*(volatile uint32_t*)0xE000EDFC)
+#define DWT_CTRL    (*(volatile uint32_t*)0xE0001000)
+#define DWT_CYCCNT  (*(volatile uint32_t*)0xE0001004)
+
+static void cycles_enable(void) {
+    DEMCR |= 1u << 24;      /* TRCENA */
+    DWT_CYCCNT = 0;
+    DWT_CTRL |= 1u;         /* CYCCNTENA */
+}
+
+static uint32_t cycles(void) {
+    return DWT_CYCCNT;
+}
+#elif defined(__arm__)
+#define CYCLE_UNIT "циклов"
+
+static void cycles_enable(void) {
+    /* PMCR.E, затем PMCNTENSET.C (прошивка работает в привилегированном режиме) */
+    __asm__ volatile("mcr p15, 0, %0, c9, c12, 0" :: "r"(1u));
+    __asm__ volatile("mcr p15, 0, %0, c9, c12, 1" :: "r"(1u << 31));
+}
+
+static uint32_t cycles(void) {
+    uint32_t value;
+    __asm__ volatile("mrc p15, 0, %0, c9, c13, 0" : "=r"(value));
+    return value;
+}
+#elif defined(__aarch64__)
+#define CYCLE_UNIT "циклов"
+
+static void cycles_enable(void) {
+    __asm__ volatile("msr pmcr_el0, %0" :: "r"((uint64_t)1));
+    __asm__ volatile("msr pmcntenset_el0, %0" :: "r"((uint64_t)1 << 31));
+}
+
+static uint32_t cycles(void) {
+    uint64_t value;
+    __asm__ volatile("mrs %0, pmccntr_el0" : "=r"(value));
+    return (uint32_t)value;
+}
+#else
+#define CYCLE_UNIT "нс"
+
+static void cycles_enable(void) {
+}
+
+static uint32_t cycles(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec);
+}
+#endif
+
+/* Заголовок genesis блока (80 байт) */
+static const uint8_t GENESIS_HEADER[80] = {
+    0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x3b, 0xa3, 0xed, 0xfd, 0x7a, 0x7b, 0x12, 0xb2, 0x7a, 0xc7, 0x2c, 0x3e,
+    0x67, 0x76, 0x8f, 0x61, 0x7f, 0xc8, 0x1b, 0xc3, 0x88, 0x8a, 0x51, 0x32,
+    0x3a, 0x9f, 0xb8, 0xaa, 0x4b, 0x1e, 0x5e, 0x4a, 0x29, 0xab, 0x5f, 0x49,
+    0xff, 0xff, 0x00, 0x1d, 0x1d, 0xac, 0x2b, 0x7c
+};
+
+/* SHA256d genesis заголовка (байты хеша, как их выдаёт sha256d) */
+static const uint8_t GENESIS_HASH[32] = {
+    0x6f, 0xe2, 0x8c, 0x0a, 0xb6, 0xf1, 0xb3, 0x72, 0xc1, 0xa6, 0xa2, 0x46,
+    0xae, 0x63, 0xf7, 0x4f, 0x93, 0x1e, 0x83, 0x65, 0xe1, 0x5a, 0x08, 0x9c,
+    0x68, 0xd6, 0x19, 0x00, 0x00, 0x00, 0x00, 0x00
+};
+
+/* Результат не выбрасывается компилятором */
+static volatile uint32_t g_sink;
+
+/**
+ * @brief Midstate заголовка в формате задания (little-endian слова)
+ */
+static void header_midstate(const uint8_t* header, uint8_t* midstate) {
+    sha256_ctx_t ctx;
+    sha256_init(&ctx);
+    sha256_transform(ctx.state, header);
+    for (int i = 0; i < 8; i++) {
+        midstate[i * 4 + 0] = (uint8_t)(ctx.state[i]);
+        midstate[i * 4 + 1] = (uint8_t)(ctx.state[i] >> 8);
+        midstate[i * 4 + 2] = (uint8_t)(ctx.state[i] >> 16);
+        midstate[i * 4 + 3] = (uint8_t)(ctx.state[i] >> 24);
+    }
+}
+
+static int check_vectors(void) {
+    uint8_t hash[32];
+    uint8_t midstate[32];
+
+    sha256d(GENESIS_HEADER, sizeof(GENESIS_HEADER), hash);
+    if (memcmp(hash, GENESIS_HASH, 32) != 0) {
+        printf("[BENCH] sha256d: неверный хеш genesis\n");
+        return -1;
+    }
+
+    header_midstate(GENESIS_HEADER, midstate);
+    sha256_mining_hash(midstate, GENESIS_HEADER + 64, hash);
+    if (memcmp(hash, GENESIS_HASH, 32) != 0) {
+        printf("[BENCH] sha256_mining_hash: неверный хеш genesis\n");
+        return -1;
+    }
+    return 0;
+}
+
+static void report(const char* name, uint32_t best) {
+    printf("[BENCH] %-24s %6u %s\n", name, (unsigned)(best / BENCH_ITERATIONS), CYCLE_UNIT);
+}
+
+int main(void) {
+    uint8_t block[64];
+    uint8_t midstate[32];
+    uint8_t hash[32];
+    uint32_t state[8] = {0};
+    sha256_header_t header;
+    uint32_t best;
+
+    cycles_enable();
+    printf("[BENCH] SHA256: %s\n", sha256_impl_name());
+    if (check_vectors() != 0) {
+        return 1;
+    }
+
+    memcpy(block, GENESIS_HEADER, sizeof(block));
+    header_midstate(GENESIS_HEADER, midstate);
+    sha256_header_prepare(&header, midstate, GENESIS_HEADER + 64);
+
+    /* Сжатие одного блока: midstate версии / аренды */
+    best = UINT32_MAX;
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        uint32_t start = cycles();
+        for (int i = 0; i < BENCH_ITERATIONS; i++) {
+            sha256_transform(state, block);
+        }
+        uint32_t spent = cycles() - start;
+        best = spent < best ? spent : best;
+    }
+    g_sink = state[0];
+    report("transform", best);
+
+    /* Проверка nonce чипа по подготовленному заданию */
+    best = UINT32_MAX;
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        uint32_t start = cycles();
+        for (uint32_t nonce = 0; nonce < BENCH_ITERATIONS; nonce++) {
+            sha256_header_hash(&header, nonce, hash);
+            g_sink = hash[31];
+        }
+        uint32_t spent = cycles() - start;
+        best = spent < best ? spent : best;
+    }
+    report("header_hash (nonce)", best);
+
+    /* То же без подготовки на задание */
+    best = UINT32_MAX;
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        uint32_t start = cycles();
+        for (int i = 0; i < BENCH_ITERATIONS; i++) {
+            sha256_mining_hash(midstate, GENESIS_HEADER + 64, hash);
+            g_sink = hash[31];
+        }
+        uint32_t spent = cycles() - start;
+        best = spent < best ? spent : best;
+    }
+    report("mining_hash", best);
+
+    return 0;
+}
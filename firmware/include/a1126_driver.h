@@ -19,8 +19,10 @@ typedef struct {
     uint8_t  temperature;       /* Температура (°C) */
     uint8_t  voltage;           /* Напряжение (x10 mV) */
     uint8_t  status;            /* Статус: 0=OK, 1=Error */
+    uint16_t frequency_mhz;     /* Последняя заданная частота */
     uint32_t nonce_count;       /* Количество проверенных nonce */
-    uint32_t error_count;       /* Количество ошибок */
+    uint32_t error_count;       /* HW ошибки: nonce не прошёл проверку */
+    uint32_t good_count;        /* Nonce, прошедшие проверку */
 } a1126_chip_status_t;
 
 /**
@@ -29,12 +31,15 @@ typedef struct {
 typedef struct {
     uint8_t  chip_id;           /* ID чипа */
     uint32_t nonce;             /* Найденный nonce */
+    uint8_t  version_slot;      /* Слот версии, который перебирал чип */
     uint8_t  valid;             /* 1 если результат валиден */
 } a1126_result_t;
 
 /**
  * @brief Инициализировать драйвер чипов
  * 
+ * Сбрасывает чипы; самодиагностику ведёт a1126_self_test_poll().
+ * 
  * @return 0 при успехе, -1 при ошибке
  */
 int a1126_init(void);
@@ -42,6 +47,9 @@ int a1126_init(void);
 /**
  * @brief Сбросить все чипы
  * 
+ * Кадр сброса встаёт в очередь DMA (при A1126_BROADCAST_LOAD - один
+ * broadcast); все чипы снова проходят самодиагностику.
+ * 
  * @return 0 при успехе, -1 при ошибке
  */
 int a1126_reset(void);
@@ -49,6 +57,26 @@ int a1126_reset(void);
 /**
  * @brief Загрузить задание во все чипы
  * 
+ * Задание со слотами версий распределяется по чипам: чип i
+ * перебирает midstate слота i % version_count, диапазон nonce делится
+ * между чипами одного слота.
+ * 
+ * При A1126_BROADCAST_LOAD общая часть задания уходит всем чипам одним
+ * broadcast, каждому чипу - только его диапазон nonce (и midstate слота).
+ * 
+ * При A1126_NONCE_REBALANCE диапазоны делятся по nonce, проверенным
+ * чипами с прошлой загрузки (чипы с ошибкой диапазона не получают).
+ * 
+ * Загружаются только чипы, прошедшие самодиагностику. Диапазон чипа,
+ * который ещё проверяется, придерживается: a1126_self_test_poll()
+ * отправит его вместе с заданием, когда чип ответит.
+ * 
+ * При A1126_DOUBLE_BUFFER задание пишется в теневой банк: чипы продолжают
+ * перебирать текущее, новое включает a1126_swap().
+ * 
+ * Запись идёт через очередь DMA: функция возвращается, пока чипы ещё
+ * загружаются. Следующее задание ждёт окончания загрузки предыдущего.
+ * 
  * @param job Указатель на задание
  * @return 0 при успехе, -1 при ошибке
  */
@@ -57,6 +85,8 @@ int a1126_load_job(const quaxis_job_t* job);
 /**
  * @brief Загрузить target во все чипы
  * 
+ * Через очередь DMA, как a1126_load_job.
+ * 
  * @param target 32-байтный target
  * @return 0 при успехе, -1 при ошибке
  */
@@ -65,6 +95,8 @@ int a1126_set_target(const uint8_t* target);
 /**
  * @brief Запустить майнинг на всех чипах
  * 
+ * Команда встаёт в очередь DMA после уже поставленной загрузки задания.
+ * 
  * @return 0 при успехе, -1 при ошибке
  */
 int a1126_start(void);
@@ -77,12 +109,64 @@ int a1126_start(void);
 int a1126_stop(void);
 
 /**
- * @brief Проверить наличие результатов от чипов
+ * @brief Переключить чипы на задание из теневого банка и запустить
+ * 
+ * Команда встаёт в очередь DMA после загрузки задания; при
+ * A1126_BROADCAST_LOAD - одним кадром всем чипам.
+ * 
+ * @return 0 при успехе, -1 при ошибке
+ */
+int a1126_swap(void);
+
+/**
+ * @brief Собрать найденные nonce всех чипов в кольцевой буфер
+ * 
+ * Один проход читает статус каждого чипа и забирает все найденные nonce.
+ * Чтения идут через очереди DMA всех цепочек SPI одновременно. Начало
+ * разбора сдвигается на чип за вызов. При A1126_RESULT_IRQ проход идёт
+ * только после прерывания линии "nonce готов". Пока идут передачи DMA
+ * (чипы получают задание), чипы не опрашиваются.
+ * 
+ * @return Количество собранных nonce
+ */
+int a1126_collect_results(void);
+
+/**
+ * @brief Забрать пачку результатов из буфера
+ * 
+ * @param results Массив для результатов
+ * @param max_results Размер массива
+ * @return Количество результатов, -1 при ошибке
+ */
+int a1126_poll_results(a1126_result_t* results, int max_results);
+
+/**
+ * @brief Обработчик прерывания GPIO линии "nonce готов"
+ */
+void a1126_result_irq_handler(void);
+
+/**
+ * @brief Количество nonce, потерянных из-за полного буфера
+ */
+uint32_t a1126_result_overflows(void);
+
+/**
+ * @brief Учесть nonce чипа, проверенный контроллером
+ * 
+ * Счётчики чипа - в good_count и error_count (HW ошибки)
+ * a1126_get_chip_status().
+ * 
+ * @param chip_id ID чипа
+ * @param good 1 если хеш подходит под target
+ */
+void a1126_record_nonce(uint8_t chip_id, int good);
+
+/**
+ * @brief Проверить, закончили ли все чипы свой диапазон nonce
  * 
- * @param result Указатель на структуру для результата
- * @return 1 если есть результат, 0 если нет, -1 при ошибке
+ * @return 1 если все чипы простаивают, 0 если майнинг идёт
  */
-int a1126_poll_result(a1126_result_t* result);
+int a1126_work_done(void);
 
 /**
  * @brief Получить статус чипа
@@ -93,6 +177,17 @@ int a1126_poll_result(a1126_result_t* result);
  */
 int a1126_get_chip_status(uint8_t chip_id, a1126_chip_status_t* status);
 
+/**
+ * @brief Получить статус всех чипов
+ * 
+ * Как a1126_get_chip_status для каждого чипа, но регистры читаются
+ * проходами по всем цепочкам SPI сразу. Чип, не прошедший
+ * самодиагностику, - без показаний регистров (status=1 если отбракован).
+ * 
+ * @param statuses Массив на A1126_CHIP_COUNT чипов
+ */
+void a1126_get_chips_status(a1126_chip_status_t* statuses);
+
 /**
  * @brief Получить общий хешрейт
  * 
@@ -115,6 +210,15 @@ uint8_t a1126_get_temperature(void);
  */
 int a1126_set_frequency(uint16_t freq_mhz);
 
+/**
+ * @brief Установить частоту одного чипа
+ * 
+ * @param chip_id ID чипа (0-113)
+ * @param freq_mhz Частота в MHz
+ * @return 0 при успехе, -1 при ошибке
+ */
+int a1126_set_chip_frequency(uint8_t chip_id, uint16_t freq_mhz);
+
 /**
  * @brief Установить напряжение чипов
  * 
@@ -124,10 +228,29 @@ int a1126_set_frequency(uint16_t freq_mhz);
 int a1126_set_voltage(uint16_t voltage_mv);
 
 /**
- * @brief Выполнить самодиагностику
+ * @brief Шаг самодиагностики после сброса
+ * 
+ * Разбирает ответы прошлого прохода и раз в A1126_SELF_TEST_PASS_MS
+ * ставит в очередь DMA чтение статуса непроверенных чипов - главный
+ * цикл тем временем занят сетью. Ответивший без ошибки чип сразу
+ * получает target и загруженное задание; не ответивший за
+ * A1126_SELF_TEST_TIMEOUT_MS считается нерабочим.
+ * 
+ * @param now_ms Текущее время (мс)
+ * @return Количество чипов, прошедших проверку на этом шаге, -1 при ошибке
+ */
+int a1126_self_test_poll(uint32_t now_ms);
+
+/**
+ * @brief Закончена ли самодиагностика всех чипов
  * 
- * @return Количество рабочих чипов
+ * @return 1 если все чипы проверены или отбракованы
+ */
+int a1126_self_test_done(void);
+
+/**
+ * @brief Количество чипов, прошедших самодиагностику
  */
-int a1126_self_test(void);
+int a1126_working_chips(void);
 
 #endif /* QUAXIS_A1126_DRIVER_H */
@@ -0,0 +1,111 @@
+/**
+ * @file auto_tune.h
+ * @brief Автонастройка частоты чипов по эффективности
+ *
+ * Замкнутый цикл perturb-and-observe для каждого чипа: окно измерения -
+ * не меньше AUTO_TUNE_INTERVAL_MS и в среднем AUTO_TUNE_MIN_NONCES
+ * проверенных nonce на чип. По итогам окна чип сравнивает верные nonce
+ * со своим прошлым окном, приведённым к той же энергии, и шагает
+ * частотой на AUTO_TUNE_FREQ_STEP_MHZ:
+ * - вверх, пока эффективность не стала хуже прошлой больше чем на
+ *   2 sigma (шум Пуассона); плоская эффективность - тот же расход на
+ *   хеш, но больше хешрейта;
+ * - вниз, только пока это заметно улучшает эффективность;
+ * - сразу вниз при температуре не ниже AUTO_TUNE_TEMP_CEILING, ошибке
+ *   чипа или доле неверных nonce выше AUTO_TUNE_ERROR_PERMILLE; частота
+ *   отказа запоминается на AUTO_TUNE_HOLD_WINDOWS окон.
+ *
+ * Энергия чипа в окне - доля мощности платы по частоте (напряжение у
+ * чипов общее). Без датчика мощности (0 мВт) вместо энергии берётся
+ * МГц × мс: решения те же, эффективность в отчёте - 0.
+ *
+ * Итог - в tuning_metrics_t для health_report_serialize().
+ */
+
+#ifndef QUAXIS_AUTO_TUNE_H
+#define QUAXIS_AUTO_TUNE_H
+
+#include <stdint.h>
+#include "config.h"
+#include "health_reporter.h"
+
+#if AUTO_TUNE_ENABLE && !VERIFY_NONCES
+#error "AUTO_TUNE_ENABLE требует VERIFY_NONCES: верные nonce считает контроллер"
+#endif
+
+/**
+ * @brief Состояние настройки одного чипа
+ */
+typedef struct {
+    uint16_t freq_mhz;      /* Текущая частота */
+    uint16_t freq_limit;    /* Частота отказа (действует hold окон) */
+    int8_t   direction;     /* Следующий шаг: +1 вверх, -1 вниз */
+    uint8_t  hold;          /* Окон до снятия freq_limit */
+    uint8_t  throttled;     /* 1 если прошлое окно упёрлось в температуру */
+    uint32_t good;          /* Верные nonce текущего окна */
+    uint32_t bad;           /* Неверные nonce текущего окна */
+    uint64_t last_good;     /* Верные nonce прошлого окна */
+    uint64_t last_energy;   /* Энергия прошлого окна (0 - нет базы) */
+} auto_tune_chip_t;
+
+/**
+ * @brief Состояние автонастройки
+ */
+typedef struct {
+    auto_tune_chip_t chips[A1126_CHIP_COUNT];
+    uint32_t window_start_ms;   /* Начало текущего окна */
+    uint32_t difficulty;        /* Сложность nonce в окне */
+    tuning_metrics_t metrics;   /* Итог последнего окна */
+} auto_tune_ctx_t;
+
+/**
+ * @brief Начать настройку: все чипы на AUTO_TUNE_FREQ_START_MHZ
+ *
+ * @param ctx Состояние
+ * @param now_ms Текущее время
+ */
+void auto_tune_init(auto_tune_ctx_t* ctx, uint32_t now_ms);
+
+/**
+ * @brief Учесть nonce чипа, проверенный контроллером
+ *
+ * @param ctx Состояние
+ * @param chip_id ID чипа
+ * @param good 1 если хеш подходит под target
+ */
+static inline void auto_tune_record_nonce(auto_tune_ctx_t* ctx, uint8_t chip_id, int good) {
+    if (!ctx || chip_id >= A1126_CHIP_COUNT) return;
+    if (good) {
+        ctx->chips[chip_id].good++;
+    } else {
+        ctx->chips[chip_id].bad++;
+    }
+}
+
+/**
+ * @brief Сменилась сложность nonce: окно и базы сравнения начинаются заново
+ *
+ * @param ctx Состояние
+ * @param difficulty Новая сложность
+ * @param now_ms Текущее время
+ */
+void auto_tune_set_difficulty(auto_tune_ctx_t* ctx, uint32_t difficulty, uint32_t now_ms);
+
+/**
+ * @brief Завершить окно, если пора, и перенастроить чипы
+ *
+ * @param ctx Состояние
+ * @param now_ms Текущее время
+ * @param board_power_mw Мощность платы (0 - датчика нет)
+ * @return Число чипов с новой частотой, 0 если окно не завершено
+ */
+int auto_tune_step(auto_tune_ctx_t* ctx, uint32_t now_ms, uint32_t board_power_mw);
+
+/**
+ * @brief Итог последнего окна для health reporter
+ */
+static inline const tuning_metrics_t* auto_tune_metrics(const auto_tune_ctx_t* ctx) {
+    return ctx ? &ctx->metrics : 0;
+}
+
+#endif /* QUAXIS_AUTO_TUNE_H */
@@ -21,6 +21,35 @@
 #define RECONNECT_DELAY_MS      1000
 #define HEARTBEAT_INTERVAL_MS   30000
 #define RECV_TIMEOUT_MS         5000
+#define JOB_LOADED_ENABLE       1       /* 1 = RSP_JOB_LOADED после загрузки задания сервера */
+
+/*
+ * Возобновление сессии (CMD_SET_SESSION / RSP_HELLO)
+ * 
+ * Сервер с server.session_grace_seconds держит extranonce после обрыва:
+ * чипы не останавливаются, shares копятся до переподключения. Не дольше
+ * grace периода сервера - потом сессия на сервере уже истекла.
+ */
+#define SESSION_GRACE_MS        30000   /* Сколько перебирать задание без сервера */
+#define SESSION_SHARES_MAX      64      /* Shares, найденных без соединения */
+
+/*
+ * Уведомление о новом блоке (CMD_BLOCK_NOTIFY, server.multicast)
+ * 
+ * Датаграмма на multicast группу приходит раньше задания по TCP: чипы
+ * сразу бросают работу прежнего блока, с арендой extranonce - строят
+ * задание нового блока сами. Shares этой работы ждут подтверждения.
+ */
+#define MCAST_ENABLE            1
+#define MCAST_GROUP             "239.255.51.51"
+#define MCAST_PORT              3334
+#define MCAST_SHARES_MAX        16      /* Shares работы, ещё не подтверждённой по TCP */
+
+/*
+ * Главный цикл (events.h)
+ */
+#define EVENT_TICK_MS           1       /* Период тика таймера */
+#define RESULT_POLL_MS          5       /* Опрос nonce и конца работы чипов без IRQ */
 
 /*
  * Конфигурация ASIC чипов
@@ -28,12 +57,45 @@
 #define A1126_CHIP_COUNT        114     /* Количество чипов на плате */
 #define A1126_CORE_PER_CHIP     12      /* Ядер на чип */
 #define A1126_TOTAL_CORES       (A1126_CHIP_COUNT * A1126_CORE_PER_CHIP)
+#define A1126_BROADCAST_LOAD    1       /* 1 = общая часть задания broadcast (CS параллельно) */
+#define A1126_DOUBLE_BUFFER     1       /* 1 = задание грузится в теневой банк, затем swap */
+#define A1126_RESULT_IRQ        0       /* 1 = линия "nonce готов" от чипов на GPIO */
+#define A1126_RESULT_RING_SIZE  64      /* Буфер найденных nonce (степень 2) */
+#define A1126_RESULT_BATCH      16      /* Результатов за одну пачку */
+#define A1126_NONCE_REBALANCE   1       /* 1 = диапазоны nonce по хешрейту чипов */
+#define A1126_SELF_TEST_PASS_MS    10   /* Период опроса статуса чипов после сброса */
+#define A1126_SELF_TEST_TIMEOUT_MS 1000 /* Не ответивший за это время чип - нерабочий */
+
+/*
+ * Автонастройка частоты чипов (auto_tune.h)
+ */
+#define AUTO_TUNE_ENABLE         1       /* 1 = частота каждого чипа по эффективности */
+#define AUTO_TUNE_INTERVAL_MS    60000   /* Минимальное окно измерения */
+#define AUTO_TUNE_MIN_NONCES     256     /* Верных nonce на чип в окне (в среднем) */
+#define AUTO_TUNE_FREQ_START_MHZ 600     /* Частота до первого окна */
+#define AUTO_TUNE_FREQ_MIN_MHZ   400
+#define AUTO_TUNE_FREQ_MAX_MHZ   800
+#define AUTO_TUNE_FREQ_STEP_MHZ  25
+#define AUTO_TUNE_TEMP_CEILING   85      /* °C: с этой температуры - вниз */
+#define AUTO_TUNE_ERROR_PERMILLE 20      /* Неверных nonce на 1000: больше - вниз */
+#define AUTO_TUNE_HOLD_WINDOWS   10      /* Окон без возврата на частоту отказа */
+#define VERIFY_NONCES            1       /* 1 = хеш nonce проверяется до отправки (нужно AUTO_TUNE) */
+
+/*
+ * Телеметрия чипов (telemetry.h)
+ */
+#define TELEMETRY_ENABLE            1       /* 1 = RSP_TELEMETRY раз в TELEMETRY_INTERVAL_MS */
+#define TELEMETRY_INTERVAL_MS       1000
+#define TELEMETRY_KEYFRAME_INTERVAL 60      /* Кадров между полными снимками */
+#define TELEMETRY_PAYLOAD_MAX       1024    /* Байт payload в кадре (сервер принимает до 1536) */
 
 /*
  * Конфигурация SPI
  */
 #define SPI_CLOCK_HZ            10000000    /* 10 MHz */
 #define SPI_MODE                0           /* CPOL=0, CPHA=0 */
+#define SPI_DMA_QUEUE_LEN       512         /* Передач в очереди DMA цепочки (степень 2) */
+#define SPI_CHAIN_COUNT         3           /* Независимых SPI контроллеров (хеш-плат) */
 
 /*
  * Конфигурация очереди заданий
@@ -45,7 +107,13 @@
  * Размеры буферов
  */
 #define RECV_BUFFER_SIZE        1024
-#define SEND_BUFFER_SIZE        256
+
+/*
+ * Отправка: кадры собираются прямо в сегментах кольца TX
+ */
+#define TX_SEGMENT_SIZE         1460    /* Байт в сегменте (MSS Ethernet) */
+#define TX_RING_SEGMENTS        4       /* Собираемый + ждущие ACK стека */
+#define TX_COALESCE_US          500     /* Сколько кадр ждёт попутчиков, пока предыдущий сегмент без ACK */
 
 /*
  * Протокол
@@ -67,6 +135,7 @@
 #define PIN_SPI_CS              3
 #define PIN_CHIP_RESET          4
 #define PIN_STATUS_LED          5
+#define PIN_CHIP_IRQ            6       /* Линия "nonce готов" (A1126_RESULT_IRQ) */
 
 /*
  * Диагностика
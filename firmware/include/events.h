@@ -0,0 +1,46 @@
+/**
+ * @file events.h
+ * @brief Очередь событий главного цикла прошивки
+ * 
+ * Прерывания (приём из сети, завершение очереди DMA SPI, линия
+ * "nonce готов", тик таймера) только взводят бит события; главный цикл
+ * спит в event_wait() и просыпается на первом же событии. Одинаковые
+ * события до обработки сливаются в один бит - очередь не переполняется,
+ * а обработчик всё равно забирает всё накопленное (пакеты, результаты).
+ */
+
+#ifndef QUAXIS_EVENTS_H
+#define QUAXIS_EVENTS_H
+
+#include <stdint.h>
+
+/*
+ * События
+ */
+#define EVENT_NET_RX        (1u << 0)   /* Данные от сервера */
+#define EVENT_SPI_DONE      (1u << 1)   /* Очередь DMA SPI опустела */
+#define EVENT_CHIP_RESULT   (1u << 2)   /* Чип поднял линию "nonce готов" */
+#define EVENT_TIMER         (1u << 3)   /* Тик таймера (EVENT_TICK_MS) */
+
+/**
+ * @brief Отправить события главному циклу
+ * 
+ * Безопасно из прерывания.
+ * 
+ * @param events Биты EVENT_*
+ */
+void event_post(uint32_t events);
+
+/**
+ * @brief Забрать накопленные события, дождавшись хотя бы одного
+ * 
+ * @return Биты EVENT_*
+ */
+uint32_t event_wait(void);
+
+/**
+ * @brief Обработчик прерывания таймера (каждые EVENT_TICK_MS)
+ */
+void event_tick_irq_handler(void);
+
+#endif /* QUAXIS_EVENTS_H */
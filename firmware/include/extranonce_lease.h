@@ -0,0 +1,69 @@
+/**
+ * @file extranonce_lease.h
+ * @brief Перебор extranonce на контроллере (CMD_NEW_JOB_LEASE)
+ * 
+ * Сервер выдаёт диапазон extranonce и данные coinbase/заголовка.
+ * Когда чипы прошли 2^32 nonce текущего extranonce, контроллер
+ * сам строит задание для следующего: txid coinbase (блок пустой,
+ * merkle_root = txid) и midstate первых 64 байт заголовка.
+ * Новое задание от сервера нужно только при смене блока.
+ */
+
+#ifndef QUAXIS_EXTRANONCE_LEASE_H
+#define QUAXIS_EXTRANONCE_LEASE_H
+
+#include <stdint.h>
+#include "protocol.h"
+
+/**
+ * @brief Состояние аренды extranonce
+ */
+typedef struct {
+    quaxis_lease_t lease;       /* Задание с арендой от сервера */
+    uint32_t current_offset;    /* Смещение extranonce загруженного задания */
+    uint32_t next_offset;       /* Следующее смещение */
+    uint8_t  active;            /* 1 пока диапазон не исчерпан */
+} extranonce_lease_ctx_t;
+
+/**
+ * @brief Начать новую аренду (смещение 0)
+ * 
+ * @param ctx Состояние аренды
+ * @param lease Задание CMD_NEW_JOB_LEASE
+ */
+void extranonce_lease_start(extranonce_lease_ctx_t* ctx, const quaxis_lease_t* lease);
+
+/**
+ * @brief Построить задание для extranonce = начало + offset
+ * 
+ * @param lease Задание с арендой
+ * @param offset Смещение extranonce (< extranonce_count)
+ * @param job Задание для чипов
+ * @return 0 при успехе, -1 при ошибке
+ */
+int extranonce_lease_build_job(const quaxis_lease_t* lease, uint32_t offset, quaxis_job_t* job);
+
+/**
+ * @brief Построить задание для следующего extranonce аренды
+ * 
+ * @param ctx Состояние аренды
+ * @param job Задание для чипов
+ * @return 0 при успехе, 1 если диапазон исчерпан (ждать сервер)
+ */
+int extranonce_lease_next_job(extranonce_lease_ctx_t* ctx, quaxis_job_t* job);
+
+/**
+ * @brief Сбросить аренду (пришло обычное задание)
+ */
+static inline void extranonce_lease_stop(extranonce_lease_ctx_t* ctx) {
+    if (ctx) ctx->active = 0;
+}
+
+/**
+ * @brief Смещение extranonce для share текущего задания
+ */
+static inline uint32_t extranonce_lease_offset(const extranonce_lease_ctx_t* ctx) {
+    return (ctx && ctx->active) ? ctx->current_offset : 0;
+}
+
+#endif /* QUAXIS_EXTRANONCE_LEASE_H */
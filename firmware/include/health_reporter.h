@@ -29,11 +29,12 @@
 #define METRIC_TYPE_POWER           0x04
 #define METRIC_TYPE_UPTIME          0x05
 #define METRIC_TYPE_CHIP_STATUS     0x06
+#define METRIC_TYPE_TUNING          0x07
 
 /*
  * Размер сообщения с метриками здоровья
  */
-#define HEALTH_MESSAGE_SIZE         48
+#define HEALTH_MESSAGE_SIZE         64
 
 /*
  * Статус чипа
@@ -82,6 +83,17 @@ typedef struct {
     uint32_t power_mw;      /* Мощность (мВт) */
 } power_metrics_t;
 
+/**
+ * @brief Структура итогов автонастройки частоты (auto_tune.h)
+ */
+typedef struct {
+    uint16_t freq_avg_mhz;      /* Средняя частота чипов */
+    uint16_t freq_min_mhz;      /* Минимальная частота */
+    uint16_t freq_max_mhz;      /* Максимальная частота */
+    uint16_t throttled_chips;   /* Чипов у потолка температуры */
+    uint32_t efficiency_ghj;    /* Верных GH на джоуль (0 - мощность не измерена) */
+} tuning_metrics_t;
+
 /**
  * @brief Структура метрик uptime
  */
@@ -103,7 +115,7 @@ typedef struct {
 } chip_status_t;
 
 /**
- * @brief Полный отчёт о здоровье (48 байт)
+ * @brief Полный отчёт о здоровье (HEALTH_MESSAGE_SIZE байт)
  */
 typedef struct __attribute__((packed)) {
     uint8_t  message_type;      /* 0x83 = MSG_HEALTH_REPORT */
@@ -114,6 +126,7 @@ typedef struct __attribute__((packed)) {
     hashrate_metrics_t hashrate;/* 12 байт */
     error_metrics_t errors;     /* 16 байт */
     power_metrics_t power;      /* 8 байт */
+    tuning_metrics_t tuning;    /* 12 байт, флаг 1 << 5 */
     
     uint16_t active_chips;      /* Количество активных чипов */
     uint16_t total_chips;       /* Общее количество чипов */
@@ -133,6 +146,8 @@ typedef struct {
     error_metrics_t errors;
     power_metrics_t power;
     uptime_metrics_t uptime;
+    tuning_metrics_t tuning;
+    uint8_t has_tuning;
     
     /* Статус чипов */
     uint16_t active_chips;
@@ -238,6 +253,17 @@ void health_reporter_update_power(
     float current_a
 );
 
+/**
+ * @brief Обновить итоги автонастройки частоты
+ * 
+ * @param ctx Контекст
+ * @param tuning Итог последнего окна (auto_tune_metrics)
+ */
+void health_reporter_update_tuning(
+    health_reporter_ctx_t* ctx,
+    const tuning_metrics_t* tuning
+);
+
 /**
  * @brief Обновить статус чипа
  * 
@@ -0,0 +1,46 @@
+/**
+ * @file job_queue.h
+ * @brief Очередь заданий ASIC (CMD_QUEUE_JOB)
+ * 
+ * После CMD_NEW_JOB сервер присылает следующие задания того же
+ * extranonce с timestamp + 1..N (mining.job_prefetch). Когда чипы
+ * прошли 2^32 nonce текущего задания, контроллер берёт следующее из
+ * очереди, не дожидаясь сервера. Новое задание (или CMD_STOP)
+ * очищает очередь.
+ * 
+ * Хранятся payload по 48 байт, задание разбирается при извлечении.
+ */
+
+#ifndef QUAXIS_JOB_QUEUE_H
+#define QUAXIS_JOB_QUEUE_H
+
+#include <stdint.h>
+#include "protocol.h"
+
+/**
+ * @brief Очистить очередь
+ */
+void job_queue_clear(void);
+
+/**
+ * @brief Добавить задание в конец очереди
+ * 
+ * @param payload Payload CMD_QUEUE_JOB (JOB_MESSAGE_SIZE байт)
+ * @return 0 при успехе, -1 если очередь заполнена
+ */
+int job_queue_push(const uint8_t* payload);
+
+/**
+ * @brief Извлечь следующее задание
+ * 
+ * @param job Задание для чипов
+ * @return 1 если задание извлечено, 0 если очередь пуста
+ */
+int job_queue_pop(quaxis_job_t* job);
+
+/**
+ * @brief Количество заданий в очереди
+ */
+uint32_t job_queue_count(void);
+
+#endif /* QUAXIS_JOB_QUEUE_H */
@@ -20,6 +20,15 @@ typedef enum {
     NET_STATE_ERROR
 } net_state_t;
 
+/**
+ * @brief Счётчики отправки
+ */
+typedef struct {
+    uint32_t frames;            /* Кадров протокола */
+    uint32_t segments;          /* Сегментов, отданных стеку */
+    uint32_t bytes;
+} net_tx_stats_t;
+
 /**
  * @brief Инициализировать сетевой стек
  * 
@@ -51,12 +60,66 @@ net_state_t net_get_state(void);
 /**
  * @brief Отправить данные
  * 
+ * Копирует кадр в собираемый сегмент кольца TX: в сеть он уйдёт при
+ * net_tx_poll() или net_tx_flush() вместе с соседними кадрами.
+ * 
  * @param data Данные для отправки
- * @param len Длина данных
- * @return Количество отправленных байт, -1 при ошибке
+ * @param len Длина данных (не больше TX_SEGMENT_SIZE)
+ * @return Количество принятых байт, -1 при ошибке
  */
 int net_send(const uint8_t* data, size_t len);
 
+/**
+ * @brief Место под кадр прямо в собираемом сегменте
+ * 
+ * Если кадр не помещается, сегмент отдаётся стеку и начинается
+ * следующий. Кадр считается добавленным только после net_tx_commit().
+ * 
+ * @param len Наибольшая длина кадра
+ * @return Указатель для сериализации, NULL - нет соединения или все
+ *         сегменты кольца ждут ACK
+ */
+uint8_t* net_tx_reserve(size_t len);
+
+/**
+ * @brief Добавить кадр, записанный по указателю net_tx_reserve()
+ * 
+ * @param len Фактическая длина кадра (0 - кадра нет)
+ */
+void net_tx_commit(size_t len);
+
+/**
+ * @brief Политика склейки (вызывается в конце каждого прохода главного цикла)
+ * 
+ * Как Nagle: пока стек не подтвердил предыдущий сегмент, новые кадры
+ * копятся, но не дольше TX_COALESCE_US; без сегментов в полёте
+ * собранное уходит сразу.
+ * 
+ * @param now_us Текущее время (мкс)
+ * @return 0 при успехе, -1 при ошибке
+ */
+int net_tx_poll(uint32_t now_us);
+
+/**
+ * @brief Отдать собираемый сегмент стеку немедленно
+ * 
+ * @return 0 при успехе (или если все сегменты ждут ACK - кадры
+ *         остаются до следующего вызова), -1 при ошибке
+ */
+int net_tx_flush(void);
+
+/**
+ * @brief Стек подтвердил сегменты (sent callback) - их можно собирать заново
+ * 
+ * @param segments Подтверждённых сегментов
+ */
+void net_tx_acked(uint8_t segments);
+
+/**
+ * @brief Счётчики отправки
+ */
+const net_tx_stats_t* net_tx_stats(void);
+
 /**
  * @brief Получить данные
  * 
@@ -67,6 +130,18 @@ int net_send(const uint8_t* data, size_t len);
  */
 int net_recv(uint8_t* buf, size_t max_len, uint32_t timeout_ms);
 
+/**
+ * @brief Остались ли непрочитанные данные от сервера
+ * 
+ * @return 1 если следующий net_recv() вернёт данные без ожидания
+ */
+int net_rx_pending(void);
+
+/**
+ * @brief Обработчик прерывания приёма: отправляет EVENT_NET_RX
+ */
+void net_rx_irq_handler(void);
+
 /**
  * @brief Отправить share на сервер
  * 
@@ -76,12 +151,156 @@ int net_recv(uint8_t* buf, size_t max_len, uint32_t timeout_ms);
 int net_send_share(const quaxis_share_t* share);
 
 /**
- * @brief Отправить heartbeat на сервер
+ * @brief Поставить share в очередь
+ * 
+ * Без согласованных пакетов (CMD_SET_SHARE_BATCH) отправляет share сразу
+ * через net_send_share(). Иначе копит shares и отправляет RSP_SHARE_BATCH,
+ * когда набрано max_count. Share из слота версии, отличного от 0,
+ * отправляется отдельным RSP_SHARE_SLOT после накопленного пакета,
+ * share с extranonce из аренды - отдельным RSP_SHARE_LEASED,
+ * share версии контроллера - отдельным RSP_SHARE_ROLLED.
+ * 
+ * @param share Указатель на share
+ * @param now_ms Текущее время (для порога flush_ms)
+ * @return 0 при успехе, -1 при ошибке
+ */
+int net_queue_share(const quaxis_share_t* share, uint32_t now_ms);
+
+/**
+ * @brief Отправить накопленный пакет shares, если истёк flush_ms
+ * 
+ * @param now_ms Текущее время
+ * @return 0 при успехе, -1 при ошибке
+ */
+int net_poll_shares(uint32_t now_ms);
+
+/**
+ * @brief Отправить накопленный пакет shares немедленно
+ * 
+ * @return 0 при успехе, -1 при ошибке
+ */
+int net_flush_shares(void);
+
+/**
+ * @brief Применить параметры пакетных shares от сервера
+ * 
+ * @param max_count Shares в пакете (0 или 1 = выключить пакеты)
+ * @param flush_ms Максимальная задержка неполного пакета
+ */
+void net_set_share_batch(uint8_t max_count, uint16_t flush_ms);
+
+/**
+ * @brief Забрать новую сложность shares от сервера (CMD_SET_DIFFICULTY)
+ * 
+ * @param difficulty Куда записать сложность
+ * @return 1 если сервер прислал новую сложность, 0 если нет
+ */
+int net_take_difficulty(uint32_t* difficulty);
+
+/**
+ * @brief Забрать задание с арендой extranonce (CMD_NEW_JOB_LEASE)
+ * 
+ * @param lease Куда записать задание
+ * @return 1 если сервер прислал новое задание с арендой, 0 если нет
+ */
+int net_take_lease(quaxis_lease_t* lease);
+
+/**
+ * @brief Забрать задание с перебором версий (CMD_NEW_JOB_ROLL)
+ * 
+ * @param roll Куда записать задание
+ * @return 1 если сервер прислал новое задание с перебором версий, 0 если нет
+ */
+int net_take_roll(quaxis_roll_t* roll);
+
+/**
+ * @brief Забрать новый timestamp текущего задания (CMD_UPDATE_TIME)
+ * 
+ * @param update Куда записать обновление
+ * @return 1 если сервер прислал новый timestamp, 0 если нет
+ */
+int net_take_time_update(quaxis_time_update_t* update);
+
+/**
+ * @brief Выдал ли сервер токен сессии (CMD_SET_SESSION)
+ * 
+ * @return 1 если после обрыва сервер держит extranonce
+ */
+int net_has_session(void);
+
+/**
+ * @brief Забыть сессию (истёк grace период без соединения)
+ * 
+ * Накопленные без соединения shares сбрасываются.
+ */
+void net_drop_session(void);
+
+/**
+ * @brief Предъявить сессию после переподключения
+ * 
+ * Отправляет RSP_HELLO первым кадром соединения, затем shares,
+ * найденные без соединения, - одним сегментом.
+ * 
+ * @param job_id Задание, которое перебирают чипы (0 - нет)
+ * @return 0 при успехе, -1 при ошибке
+ */
+int net_resume_session(uint32_t job_id);
+
+/**
+ * @brief Подписаться на анонсы блоков (CMD_BLOCK_NOTIFY по UDP multicast)
+ * 
+ * Датаграммы не подписаны: принимаются только с адреса сервера.
+ * 
+ * @param server_ip IP адрес сервера (единственный допустимый источник)
+ * @param group Multicast группа
+ * @param port UDP порт группы
+ * @return 0 при успехе, -1 при ошибке
+ */
+int net_mcast_join(const char* server_ip, const char* group, uint16_t port);
+
+/**
+ * @brief Забрать анонс нового блока
+ * 
+ * Повтор уже принятого поколения отбрасывается.
+ * 
+ * @param notify Куда записать анонс
+ * @return 1 если пришёл анонс нового поколения, 0 если нет
+ */
+int net_take_block_notify(quaxis_block_notify_t* notify);
+
+/**
+ * @brief Отправить heartbeat на сервер (ответ на CMD_HEARTBEAT)
+ * 
+ * Сервер считает ответом любой байт: если в собираемом сегменте есть
+ * кадры, уходят они, без отдельного RSP_HEARTBEAT.
  * 
  * @return 0 при успехе, -1 при ошибке
  */
 int net_send_heartbeat(void);
 
+/**
+ * @brief Heartbeat по сроку HEARTBEAT_INTERVAL_MS
+ * 
+ * Не нужен, если с прошлого вызова уходили сегменты: shares и статус
+ * уже показали серверу, что контроллер жив.
+ * 
+ * @return 0 при успехе, -1 при ошибке
+ */
+int net_keepalive(void);
+
+/**
+ * @brief Подтвердить загрузку задания в чипы (RSP_JOB_LOADED)
+ * 
+ * Уходит сразу, с кадрами собираемого сегмента: сервер меряет по
+ * приходу время перехода на задание.
+ * 
+ * @param job_id Загруженное задание
+ * @param received_us Кадр задания принят (мкс, часы контроллера)
+ * @param started_us Чипы начали перебор (мкс)
+ * @return 0 при успехе, -1 при ошибке
+ */
+int net_send_job_loaded(uint32_t job_id, uint32_t received_us, uint32_t started_us);
+
 /**
  * @brief Отправить статус на сервер
  * 
@@ -76,6 +76,27 @@ void nonce_range_init_interleaved(
     uint16_t total_chips
 );
 
+/**
+ * @brief Разделить [first, last] между чипами пропорционально весам
+ * 
+ * Диапазоны идут подряд (sequential), размер - доля веса чипа в сумме.
+ * Чип с весом 0 получает пустой (исчерпанный) диапазон. Если все
+ * веса 0 - деление поровну.
+ * 
+ * @param ranges Массив диапазонов (chip_id не меняется)
+ * @param weights Веса чипов (например, nonce за прошлое задание)
+ * @param count Количество чипов
+ * @param first Первый nonce
+ * @param last Последний nonce (включительно)
+ */
+void nonce_range_split_weighted(
+    nonce_range_t* ranges,
+    const uint32_t* weights,
+    uint16_t count,
+    uint32_t first,
+    uint32_t last
+);
+
 /**
  * @brief Получить следующий nonce
  * 
@@ -232,6 +253,19 @@ void nonce_distributor_init(
  */
 void nonce_distributor_reset_all(nonce_distributor_ctx_t* ctx);
 
+/**
+ * @brief Перераспределить диапазоны ASIC по хешрейту чипов
+ * 
+ * Общий участок nonce этого ASIC делится заново пропорционально весам:
+ * медленные чипы отдают часть диапазона быстрым, и к следующему заданию
+ * все чипы заканчивают одновременно. Участки других ASIC не меняются.
+ * 
+ * @param ctx Контекст (стратегия sequential)
+ * @param weights Веса чипов ASIC (chips_per_asic элементов)
+ * @return 0 при успехе, -1 для interleaved (шаг не делится по весам)
+ */
+int nonce_distributor_rebalance(nonce_distributor_ctx_t* ctx, const uint32_t* weights);
+
 /**
  * @brief Получить следующий nonce для чипа
  * 
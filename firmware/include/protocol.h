@@ -16,20 +16,179 @@
 #define CMD_HEARTBEAT       0x03    /* Ping */
 #define CMD_SET_TARGET      0x04    /* Установить target */
 #define CMD_SET_DIFFICULTY  0x05    /* Установить difficulty */
+#define CMD_SET_SHARE_BATCH 0x06    /* Разрешить пакетные shares */
+#define CMD_NEW_JOB_SLOTS   0x07    /* Задание с несколькими версиями */
+#define CMD_NEW_JOB_LEASE   0x08    /* Задание с арендой extranonce */
+#define CMD_QUEUE_JOB       0x09    /* Задание в очередь (после текущего) */
+#define CMD_NEW_JOB_ROLL    0x0A    /* Задание с перебором версий на контроллере */
+#define CMD_UPDATE_TIME     0x0B    /* Новый timestamp текущего задания */
+#define CMD_SET_SESSION     0x0C    /* Токен сессии */
+#define CMD_BLOCK_NOTIFY    0x0D    /* Новый блок (multicast UDP) */
 
 /*
  * Коды ответов к серверу
  */
 #define RSP_SHARE           0x81    /* Найден nonce */
+#define RSP_SHARE_BATCH     0x82    /* Несколько shares в одном кадре */
 #define RSP_HEARTBEAT       0x83    /* Pong */
 #define RSP_STATUS          0x84    /* Статус ASIC */
+#define RSP_SHARE_SLOT      0x85    /* Найден nonce в слоте версии */
+#define RSP_SHARE_LEASED    0x86    /* Найден nonce для extranonce из аренды */
+#define RSP_SHARE_ROLLED    0x87    /* Найден nonce для версии контроллера */
+#define RSP_TELEMETRY       0x88    /* Изменения телеметрии чипов */
+#define RSP_HELLO           0x89    /* Токен прежней сессии */
+#define RSP_JOB_LOADED      0x8A    /* Задание загружено в чипы */
 #define RSP_ERROR           0x8F    /* Ошибка */
 
 /*
- * Структура задания (48 байт)
+ * Слоты версий (CMD_NEW_JOB_SLOTS, AsicBoost)
+ * 
+ * Payload: count(1) + merkle_tail(4) + timestamp(4) + bits(4) +
+ * nonce_start(4) + job_id(4) + count × (version(4) + midstate(32)).
+ * Хвост заголовка общий для всех версий.
+ */
+#define VERSION_SLOTS_MAX        4
+#define NEW_JOB_SLOTS_HEADER     21  /* payload до слотов */
+#define NEW_JOB_SLOT_SIZE        36  /* version + midstate */
+
+/*
+ * Аренда extranonce (CMD_NEW_JOB_LEASE)
+ * 
+ * Payload: job_id(4) + version(4) + prev_block(32) + coinbase_midstate(32) +
+ * coinbase_tail(46) + timestamp(4) + bits(4) + extranonce_count(4).
+ * Первые 6 байт coinbase_tail - extranonce начала диапазона (little-endian).
+ * Контроллер сам перебирает extranonce = начало + offset (offset < count)
+ * и строит midstate (см. extranonce_lease.h); shares для offset != 0
+ * уходят в RSP_SHARE_LEASED: job_id(4) + nonce(4) + offset(4).
+ */
+#define COINBASE_TAIL_SIZE       46
+#define EXTRANONCE_SIZE          6
+#define NEW_JOB_LEASE_SIZE       130 /* payload CMD_NEW_JOB_LEASE */
+#define SHARE_LEASED_FRAME_SIZE  13
+
+typedef struct __attribute__((packed)) {
+    uint32_t job_id;                            /* ID задания */
+    uint32_t version;                           /* Версия заголовка */
+    uint8_t  prev_block[32];                    /* Хеш предыдущего блока */
+    uint8_t  coinbase_midstate[32];             /* SHA256 state первых 64 байт coinbase */
+    uint8_t  coinbase_tail[COINBASE_TAIL_SIZE]; /* Остаток coinbase */
+    uint32_t timestamp;                         /* Timestamp блока */
+    uint32_t bits;                              /* Compact target */
+    uint32_t extranonce_count;                  /* Размер диапазона */
+} quaxis_lease_t;
+
+/*
+ * Перебор версий на контроллере (CMD_NEW_JOB_ROLL, BIP320)
+ * 
+ * Payload: job_id(4) + version(4) + prev_block(32) + merkle_root(32) +
+ * timestamp(4) + bits(4) + version_mask(4).
+ * Контроллер сам меняет биты version под маской и строит midstate
+ * первых 64 байт заголовка (см. version_rolling.h); shares уходят
+ * в RSP_SHARE_ROLLED: job_id(4) + nonce(4) + version(4).
+ */
+#define NEW_JOB_ROLL_SIZE        84  /* payload CMD_NEW_JOB_ROLL */
+#define SHARE_ROLLED_FRAME_SIZE  13
+
+typedef struct __attribute__((packed)) {
+    uint32_t job_id;            /* ID задания */
+    uint32_t version;           /* Версия заголовка (начало перебора) */
+    uint8_t  prev_block[32];    /* Хеш предыдущего блока */
+    uint8_t  merkle_root[32];   /* Merkle root */
+    uint32_t timestamp;         /* Timestamp блока */
+    uint32_t bits;              /* Compact target */
+    uint32_t version_mask;      /* Биты version, которые можно менять */
+} quaxis_roll_t;
+
+/*
+ * Новый timestamp задания (CMD_UPDATE_TIME)
+ * 
+ * Payload: job_id(4) + timestamp(4) + flags(1) + nonce_start(4).
+ * Timestamp в хвосте заголовка, midstate прежний: контроллер меняет
+ * хвост текущего задания и перезапускает перебор nonce. Без
+ * UPDATE_TIME_FLAG_NONCE nonce начинается с прежнего nonce_start.
+ */
+#define UPDATE_TIME_SIZE         13  /* payload CMD_UPDATE_TIME */
+#define UPDATE_TIME_FLAG_NONCE   0x01
+
+typedef struct __attribute__((packed)) {
+    uint32_t job_id;            /* ID задания */
+    uint32_t timestamp;         /* Новый timestamp */
+    uint8_t  flags;             /* UPDATE_TIME_FLAG_* */
+    uint32_t nonce_start;       /* Начальный nonce (с UPDATE_TIME_FLAG_NONCE) */
+} quaxis_time_update_t;
+
+/*
+ * Сессия (CMD_SET_SESSION, RSP_HELLO)
+ * 
+ * CMD_SET_SESSION: token(8, little-endian). После переподключения
+ * контроллер первым кадром шлёт RSP_HELLO: token(8) + job_id(4) текущего
+ * задания. Сервер возвращает прежний extranonce и, если задание ещё
+ * текущее, не присылает нового.
+ */
+#define SET_SESSION_SIZE         8   /* payload CMD_SET_SESSION */
+#define HELLO_FRAME_SIZE         13  /* RSP_HELLO + token + job_id */
+
+/*
+ * Подтверждение загрузки задания (RSP_JOB_LOADED, JOB_LOADED_ENABLE)
+ * 
+ * Кадр: RSP_JOB_LOADED(1) + job_id(4) + received_us(4) + started_us(4).
+ * Уходит после a1126_load_job / a1126_start задания, присланного
+ * сервером. Отметки - часы контроллера в мкс (с переполнением): сервер
+ * берёт только их разницу, задержку от отправки меряет по своим часам.
+ */
+#define JOB_LOADED_FRAME_SIZE    13
+
+/*
+ * Уведомление о новом блоке (CMD_BLOCK_NOTIFY, UDP датаграмма на группу)
+ * 
+ * Датаграмма: CMD_BLOCK_NOTIFY(1) + generation(4) + height(4) + flags(1) +
+ * version(4) + prev_block(32) + coinbase_midstate(32) + coinbase_tail(46,
+ * extranonce нулевой) + timestamp(4) + bits(4). С BLOCK_NOTIFY_FLAG_WORK
+ * контроллер с арендой подставляет начало своего диапазона и строит
+ * задание сам; задание по TCP (CMD_NEW_JOB_LEASE) подтверждает его.
+ */
+#define BLOCK_NOTIFY_SIZE            132 /* Датаграмма целиком */
+#define BLOCK_NOTIFY_FLAG_WORK       0x01
+#define BLOCK_NOTIFY_FLAG_SPECULATIVE 0x02
+
+typedef struct __attribute__((packed)) {
+    uint32_t generation;                        /* Поколение заданий сервера */
+    uint32_t height;                            /* Высота блока */
+    uint8_t  flags;                             /* BLOCK_NOTIFY_FLAG_* */
+    uint32_t version;                           /* Версия заголовка */
+    uint8_t  prev_block[32];                    /* Хеш предыдущего блока */
+    uint8_t  coinbase_midstate[32];             /* SHA256 state первых 64 байт coinbase */
+    uint8_t  coinbase_tail[COINBASE_TAIL_SIZE]; /* Остаток coinbase, extranonce = 0 */
+    uint32_t timestamp;                         /* Timestamp блока */
+    uint32_t bits;                              /* Compact target */
+} quaxis_block_notify_t;
+
+/*
+ * Телеметрия чипов (RSP_TELEMETRY)
+ * 
+ * Кадр: RSP_TELEMETRY(1) + len(2, little-endian) + payload(len).
+ * Payload: flags(1) + записи чипов по возрастанию chip_id до конца кадра.
+ * Запись: gap (varint, chip_id - прошлый chip_id - 1) + mask(1) + поля
+ * по маске. Температура и частота - zigzag varint разницы с прошлым
+ * отправленным значением, статус - байт, счётчики - varint прироста.
+ * С TELEMETRY_FLAG_KEYFRAME разницы считаются от нулей (сервер
+ * сбрасывает снимок ASIC); без него приходят только изменившиеся чипы.
+ */
+#define TELEMETRY_HEADER_SIZE       3
+#define TELEMETRY_FLAG_KEYFRAME     0x01
+#define TELEMETRY_FIELD_TEMPERATURE 0x01
+#define TELEMETRY_FIELD_FREQUENCY   0x02
+#define TELEMETRY_FIELD_STATUS      0x04
+#define TELEMETRY_FIELD_HW_ERRORS   0x08
+#define TELEMETRY_FIELD_GOOD_NONCES 0x10
+
+/*
+ * Структура задания
  * 
  * Содержит все данные для вычисления хеша блока.
- * ASIC использует midstate и перебирает nonce.
+ * ASIC использует midstate и перебирает nonce. Первые поля совпадают
+ * с 48-байтным CMD_NEW_JOB; задание CMD_NEW_JOB_SLOTS дополнительно
+ * несёт до VERSION_SLOTS_MAX midstate (version_count = 0 - обычное).
  */
 typedef struct __attribute__((packed)) {
     uint8_t  midstate[32];  /* SHA256 state после первых 64 байт header */
@@ -37,18 +196,48 @@ typedef struct __attribute__((packed)) {
     uint32_t bits;          /* Compact target (little-endian) */
     uint32_t nonce_start;   /* Начальный nonce (little-endian) */
     uint32_t job_id;        /* ID задания (little-endian) */
+    uint8_t  merkle_tail[4];                        /* merkle_root[28:32] */
+    uint8_t  version_count;                         /* Слотов версий */
+    uint32_t versions[VERSION_SLOTS_MAX];           /* Версия слота */
+    uint8_t  version_midstates[VERSION_SLOTS_MAX][32]; /* Midstate слота */
 } quaxis_job_t;
 
 /*
- * Структура share (8 байт)
+ * Структура share
  * 
- * Отправляется на сервер при нахождении валидного nonce.
+ * Отправляется на сервер при нахождении валидного nonce:
+ * RSP_SHARE (8 байт) для слота 0, RSP_SHARE_SLOT (9 байт) для остальных,
+ * RSP_SHARE_LEASED (12 байт) для extranonce_offset != 0,
+ * RSP_SHARE_ROLLED (12 байт) для version != 0.
  */
 typedef struct __attribute__((packed)) {
     uint32_t job_id;        /* ID задания */
     uint32_t nonce;         /* Найденный nonce */
+    uint8_t  version_slot;  /* Слот версии задания */
+    uint32_t extranonce_offset; /* Смещение extranonce в аренде */
+    uint32_t version;       /* Версия, построенная контроллером (0 - нет) */
 } quaxis_share_t;
 
+/*
+ * Пакет shares (RSP_SHARE_BATCH)
+ * 
+ * Кадр: RSP_SHARE_BATCH(1) + count(1) + count × quaxis_share_t (8 байт).
+ * Сервер разрешает пакеты командой CMD_SET_SHARE_BATCH
+ * (max_count(1) + flush_ms(2, little-endian)); без неё shares
+ * отправляются по одному в RSP_SHARE.
+ */
+#define SHARE_BATCH_MAX          32
+#define SHARE_BATCH_HEADER_SIZE  2
+#define SHARE_BATCH_FRAME_MAX    (SHARE_BATCH_HEADER_SIZE + SHARE_BATCH_MAX * 8)
+#define SET_SHARE_BATCH_SIZE     3   /* payload CMD_SET_SHARE_BATCH */
+
+/*
+ * CMD_SET_DIFFICULTY: difficulty (uint32, little-endian).
+ * Сервер подбирает сложность каждому ASIC (vardiff), чип отправляет
+ * только nonce с hash <= diff1_target / difficulty.
+ */
+#define SET_DIFFICULTY_SIZE      4   /* payload CMD_SET_DIFFICULTY */
+
 /*
  * Структура статуса ASIC
  */
@@ -106,9 +295,198 @@ static inline int quaxis_parse_job(const uint8_t* buf, quaxis_job_t* job) {
                   ((uint32_t)buf[46] << 16) |
                   ((uint32_t)buf[47] << 24);
     
+    job->version_count = 0;
+    
+    return 0;
+}
+
+/**
+ * @brief Десериализовать задание CMD_NEW_JOB_SLOTS
+ * 
+ * @param buf Payload после байта команды
+ * @param len Длина payload
+ * @param job Указатель на структуру для заполнения
+ * @return 0 при успехе, 1 если кадр ещё не получен целиком, -1 при ошибке
+ */
+static inline int quaxis_parse_job_slots(const uint8_t* buf, int len, quaxis_job_t* job) {
+    if (!buf || !job) return -1;
+    if (len < 1) return 1;
+    
+    uint8_t count = buf[0];
+    if (count < 2 || count > VERSION_SLOTS_MAX) return -1;
+    if (len < NEW_JOB_SLOTS_HEADER + count * NEW_JOB_SLOT_SIZE) return 1;
+    
+    const uint8_t* p = buf + 1;
+    for (int i = 0; i < 4; i++) {
+        job->merkle_tail[i] = p[i];
+    }
+    job->timestamp = (uint32_t)p[4] | ((uint32_t)p[5] << 8) |
+                     ((uint32_t)p[6] << 16) | ((uint32_t)p[7] << 24);
+    job->bits = (uint32_t)p[8] | ((uint32_t)p[9] << 8) |
+                ((uint32_t)p[10] << 16) | ((uint32_t)p[11] << 24);
+    job->nonce_start = (uint32_t)p[12] | ((uint32_t)p[13] << 8) |
+                       ((uint32_t)p[14] << 16) | ((uint32_t)p[15] << 24);
+    job->job_id = (uint32_t)p[16] | ((uint32_t)p[17] << 8) |
+                  ((uint32_t)p[18] << 16) | ((uint32_t)p[19] << 24);
+    p += NEW_JOB_SLOTS_HEADER - 1;
+    
+    job->version_count = count;
+    for (int s = 0; s < count; s++) {
+        job->versions[s] = (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+                           ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+        for (int i = 0; i < 32; i++) {
+            job->version_midstates[s][i] = p[4 + i];
+        }
+        p += NEW_JOB_SLOT_SIZE;
+    }
+    
+    /* Слот 0 - обычный midstate задания */
+    for (int i = 0; i < 32; i++) {
+        job->midstate[i] = job->version_midstates[0][i];
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief Прочитать uint32 little-endian
+ */
+static inline uint32_t quaxis_read_le32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+           ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/**
+ * @brief Десериализовать задание CMD_NEW_JOB_LEASE
+ * 
+ * @param buf Payload после байта команды
+ * @param len Длина payload
+ * @param lease Указатель на структуру для заполнения
+ * @return 0 при успехе, 1 если кадр ещё не получен целиком, -1 при ошибке
+ */
+static inline int quaxis_parse_job_lease(const uint8_t* buf, int len, quaxis_lease_t* lease) {
+    if (!buf || !lease) return -1;
+    if (len < NEW_JOB_LEASE_SIZE) return 1;
+    
+    const uint8_t* p = buf;
+    lease->job_id = quaxis_read_le32(p);
+    lease->version = quaxis_read_le32(p + 4);
+    p += 8;
+    for (int i = 0; i < 32; i++) {
+        lease->prev_block[i] = p[i];
+        lease->coinbase_midstate[i] = p[32 + i];
+    }
+    p += 64;
+    for (int i = 0; i < COINBASE_TAIL_SIZE; i++) {
+        lease->coinbase_tail[i] = p[i];
+    }
+    p += COINBASE_TAIL_SIZE;
+    lease->timestamp = quaxis_read_le32(p);
+    lease->bits = quaxis_read_le32(p + 4);
+    lease->extranonce_count = quaxis_read_le32(p + 8);
+    
+    return lease->extranonce_count < 2 ? -1 : 0;
+}
+
+/**
+ * @brief Десериализовать датаграмму CMD_BLOCK_NOTIFY
+ * 
+ * @param buf Датаграмма (с байтом команды)
+ * @param len Длина датаграммы
+ * @param notify Указатель на структуру для заполнения
+ * @return 0 при успехе, -1 если это не CMD_BLOCK_NOTIFY
+ */
+static inline int quaxis_parse_block_notify(const uint8_t* buf, int len, quaxis_block_notify_t* notify) {
+    if (!buf || !notify) return -1;
+    if (len < BLOCK_NOTIFY_SIZE || buf[0] != CMD_BLOCK_NOTIFY) return -1;
+    
+    const uint8_t* p = buf + 1;
+    notify->generation = quaxis_read_le32(p);
+    notify->height = quaxis_read_le32(p + 4);
+    notify->flags = p[8];
+    notify->version = quaxis_read_le32(p + 9);
+    p += 13;
+    for (int i = 0; i < 32; i++) {
+        notify->prev_block[i] = p[i];
+        notify->coinbase_midstate[i] = p[32 + i];
+    }
+    p += 64;
+    for (int i = 0; i < COINBASE_TAIL_SIZE; i++) {
+        notify->coinbase_tail[i] = p[i];
+    }
+    p += COINBASE_TAIL_SIZE;
+    notify->timestamp = quaxis_read_le32(p);
+    notify->bits = quaxis_read_le32(p + 4);
+    
+    return 0;
+}
+
+/**
+ * @brief Десериализовать CMD_UPDATE_TIME
+ * 
+ * @param buf Payload после байта команды
+ * @param len Длина payload
+ * @param update Указатель на структуру для заполнения
+ * @return 0 при успехе, 1 если кадр ещё не получен целиком, -1 при ошибке
+ */
+static inline int quaxis_parse_update_time(const uint8_t* buf, int len, quaxis_time_update_t* update) {
+    if (!buf || !update) return -1;
+    if (len < UPDATE_TIME_SIZE) return 1;
+    
+    update->job_id = quaxis_read_le32(buf);
+    update->timestamp = quaxis_read_le32(buf + 4);
+    update->flags = buf[8];
+    update->nonce_start = quaxis_read_le32(buf + 9);
+    
     return 0;
 }
 
+/**
+ * @brief Применить CMD_UPDATE_TIME к заданию
+ * 
+ * @param job Задание (разобранное quaxis_parse_job или слоты версий)
+ * @param update Обновление от сервера
+ * @return 0 если задание обновлено, -1 если обновление для другого задания
+ */
+static inline int quaxis_apply_update_time(quaxis_job_t* job, const quaxis_time_update_t* update) {
+    if (!job || !update || job->job_id != update->job_id) return -1;
+    
+    job->timestamp = update->timestamp;
+    if (update->flags & UPDATE_TIME_FLAG_NONCE) {
+        job->nonce_start = update->nonce_start;
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief Десериализовать задание CMD_NEW_JOB_ROLL
+ * 
+ * @param buf Payload после байта команды
+ * @param len Длина payload
+ * @param roll Указатель на структуру для заполнения
+ * @return 0 при успехе, 1 если кадр ещё не получен целиком, -1 при ошибке
+ */
+static inline int quaxis_parse_job_roll(const uint8_t* buf, int len, quaxis_roll_t* roll) {
+    if (!buf || !roll) return -1;
+    if (len < NEW_JOB_ROLL_SIZE) return 1;
+    
+    const uint8_t* p = buf;
+    roll->job_id = quaxis_read_le32(p);
+    roll->version = quaxis_read_le32(p + 4);
+    p += 8;
+    for (int i = 0; i < 32; i++) {
+        roll->prev_block[i] = p[i];
+        roll->merkle_root[i] = p[32 + i];
+    }
+    p += 64;
+    roll->timestamp = quaxis_read_le32(p);
+    roll->bits = quaxis_read_le32(p + 4);
+    roll->version_mask = quaxis_read_le32(p + 8);
+    
+    return roll->version_mask == 0 ? -1 : 0;
+}
+
 /**
  * @brief Сериализовать share в буфер
  * 
@@ -137,4 +515,161 @@ static inline int quaxis_serialize_share(const quaxis_share_t* share, uint8_t* b
     return 9;
 }
 
+/**
+ * @brief Сериализовать share со слотом версии (RSP_SHARE_SLOT)
+ * 
+ * @param share Указатель на share
+ * @param buf Буфер для записи (минимум 10 байт: 1 + 8 + 1)
+ * @return Количество записанных байт
+ */
+static inline int quaxis_serialize_share_slot(const quaxis_share_t* share, uint8_t* buf) {
+    if (quaxis_serialize_share(share, buf) < 0) return -1;
+    
+    buf[0] = RSP_SHARE_SLOT;
+    buf[9] = share->version_slot;
+    
+    return 10;
+}
+
+/**
+ * @brief Сериализовать share с extranonce из аренды (RSP_SHARE_LEASED)
+ * 
+ * @param share Указатель на share
+ * @param buf Буфер для записи (минимум 13 байт: 1 + 8 + 4)
+ * @return Количество записанных байт
+ */
+static inline int quaxis_serialize_share_leased(const quaxis_share_t* share, uint8_t* buf) {
+    if (quaxis_serialize_share(share, buf) < 0) return -1;
+    
+    buf[0] = RSP_SHARE_LEASED;
+    buf[9] = (uint8_t)(share->extranonce_offset & 0xFF);
+    buf[10] = (uint8_t)((share->extranonce_offset >> 8) & 0xFF);
+    buf[11] = (uint8_t)((share->extranonce_offset >> 16) & 0xFF);
+    buf[12] = (uint8_t)((share->extranonce_offset >> 24) & 0xFF);
+    
+    return SHARE_LEASED_FRAME_SIZE;
+}
+
+/**
+ * @brief Сериализовать share с версией контроллера (RSP_SHARE_ROLLED)
+ * 
+ * @param share Указатель на share
+ * @param buf Буфер для записи (минимум 13 байт: 1 + 8 + 4)
+ * @return Количество записанных байт
+ */
+static inline int quaxis_serialize_share_rolled(const quaxis_share_t* share, uint8_t* buf) {
+    if (quaxis_serialize_share(share, buf) < 0) return -1;
+    
+    buf[0] = RSP_SHARE_ROLLED;
+    buf[9] = (uint8_t)(share->version & 0xFF);
+    buf[10] = (uint8_t)((share->version >> 8) & 0xFF);
+    buf[11] = (uint8_t)((share->version >> 16) & 0xFF);
+    buf[12] = (uint8_t)((share->version >> 24) & 0xFF);
+    
+    return SHARE_ROLLED_FRAME_SIZE;
+}
+
+/**
+ * @brief Сериализовать RSP_HELLO
+ * 
+ * @param token Токен из CMD_SET_SESSION
+ * @param job_id Текущее задание (0 - нет задания)
+ * @param buf Буфер для записи (минимум HELLO_FRAME_SIZE байт)
+ * @return Количество записанных байт
+ */
+static inline int quaxis_serialize_hello(uint64_t token, uint32_t job_id, uint8_t* buf) {
+    if (!buf) return -1;
+    
+    buf[0] = RSP_HELLO;
+    for (int i = 0; i < 8; i++) {
+        buf[1 + i] = (uint8_t)(token >> (8 * i));
+    }
+    buf[9] = (uint8_t)(job_id & 0xFF);
+    buf[10] = (uint8_t)((job_id >> 8) & 0xFF);
+    buf[11] = (uint8_t)((job_id >> 16) & 0xFF);
+    buf[12] = (uint8_t)((job_id >> 24) & 0xFF);
+    
+    return HELLO_FRAME_SIZE;
+}
+
+/**
+ * @brief Сериализовать RSP_JOB_LOADED
+ * 
+ * @param job_id Загруженное задание
+ * @param received_us Кадр задания принят (мкс)
+ * @param started_us Чипы начали перебор (мкс)
+ * @param buf Буфер для записи (минимум JOB_LOADED_FRAME_SIZE байт)
+ * @return Количество записанных байт
+ */
+static inline int quaxis_serialize_job_loaded(uint32_t job_id, uint32_t received_us,
+                                              uint32_t started_us, uint8_t* buf) {
+    if (!buf) return -1;
+    
+    uint32_t words[3] = {job_id, received_us, started_us};
+    buf[0] = RSP_JOB_LOADED;
+    for (int i = 0; i < 3; i++) {
+        buf[1 + i * 4] = (uint8_t)(words[i] & 0xFF);
+        buf[2 + i * 4] = (uint8_t)((words[i] >> 8) & 0xFF);
+        buf[3 + i * 4] = (uint8_t)((words[i] >> 16) & 0xFF);
+        buf[4 + i * 4] = (uint8_t)((words[i] >> 24) & 0xFF);
+    }
+    
+    return JOB_LOADED_FRAME_SIZE;
+}
+
+/**
+ * @brief Сериализовать пакет shares в буфер
+ * 
+ * @param shares Массив shares
+ * @param count Количество (1..SHARE_BATCH_MAX)
+ * @param buf Буфер для записи (минимум 2 + 8 * count байт)
+ * @return Количество записанных байт, -1 при ошибке
+ */
+static inline int quaxis_serialize_share_batch(const quaxis_share_t* shares,
+                                               uint8_t count,
+                                               uint8_t* buf) {
+    if (!shares || !buf || count == 0 || count > SHARE_BATCH_MAX) return -1;
+    
+    buf[0] = RSP_SHARE_BATCH;
+    buf[1] = count;
+    
+    uint8_t* p = buf + SHARE_BATCH_HEADER_SIZE;
+    for (uint8_t i = 0; i < count; i++) {
+        /* job_id, nonce (little-endian) */
+        p[0] = (uint8_t)(shares[i].job_id & 0xFF);
+        p[1] = (uint8_t)((shares[i].job_id >> 8) & 0xFF);
+        p[2] = (uint8_t)((shares[i].job_id >> 16) & 0xFF);
+        p[3] = (uint8_t)((shares[i].job_id >> 24) & 0xFF);
+        p[4] = (uint8_t)(shares[i].nonce & 0xFF);
+        p[5] = (uint8_t)((shares[i].nonce >> 8) & 0xFF);
+        p[6] = (uint8_t)((shares[i].nonce >> 16) & 0xFF);
+        p[7] = (uint8_t)((shares[i].nonce >> 24) & 0xFF);
+        p += 8;
+    }
+    
+    return SHARE_BATCH_HEADER_SIZE + count * 8;
+}
+
+/**
+ * @brief Вычислить target для сложности shares
+ * 
+ * target = diff1_target / difficulty, где diff1_target = 0xFFFF << 208.
+ * Target в little-endian (target[31] - старший байт), как в a1126_set_target.
+ * 
+ * @param difficulty Сложность (0 трактуется как 1)
+ * @param target Буфер для target (32 байта)
+ */
+static inline void quaxis_difficulty_to_target(uint32_t difficulty, uint8_t* target) {
+    if (difficulty == 0) difficulty = 1;
+    
+    /* Деление в столбик от старшего байта */
+    uint64_t rem = 0;
+    for (int i = 31; i >= 0; i--) {
+        uint8_t diff1 = (i == 27 || i == 26) ? 0xFF : 0x00;
+        uint64_t cur = (rem << 8) | diff1;
+        target[i] = (uint8_t)(cur / difficulty);
+        rem = cur % difficulty;
+    }
+}
+
 #endif /* QUAXIS_PROTOCOL_H */
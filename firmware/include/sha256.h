@@ -4,6 +4,13 @@
  * 
  * Облегчённая реализация SHA256 для микроконтроллера.
  * Используется для верификации хешей на стороне контроллера.
+ * 
+ * Реализация сжатия выбирается в Makefile (SHA256_IMPL):
+ * - ref: переносимый цикл по раундам;
+ * - unrolled: развёрнутые раунды и расписание в кольце из 16 слов,
+ *   для заголовка - раунды и слова расписания, не зависящие от nonce,
+ *   считаются один раз на задание (по умолчанию; и для Cortex-M);
+ * - armv8: инструкции SHA-2 ARMv8 (SHA256H / SHA256SU0 / SHA256SU1).
  */
 
 #ifndef QUAXIS_SHA256_H
@@ -12,6 +19,17 @@
 #include <stdint.h>
 #include <stddef.h>
 
+/*
+ * Реализации сжатия (Makefile: SHA256_IMPL=ref|unrolled|armv8)
+ */
+#define SHA256_IMPL_REF         0
+#define SHA256_IMPL_UNROLLED    1
+#define SHA256_IMPL_ARMV8       2
+
+#ifndef SHA256_IMPL
+#define SHA256_IMPL             SHA256_IMPL_UNROLLED
+#endif
+
 /**
  * @brief Состояние SHA256 (midstate)
  */
@@ -21,6 +39,23 @@ typedef struct {
     uint8_t  buffer[64];    /* Буфер для неполного блока */
 } sha256_ctx_t;
 
+/**
+ * @brief Заголовок 80 байт с известным midstate: всё, что не зависит от nonce
+ * 
+ * Второй блок заголовка - merkle_root[28:32] + time + bits + nonce и
+ * постоянное дополнение. Без nonce (W3) известны раунды 0-2 и слова
+ * расписания W16, W17; в W18, W19 nonce входит слагаемым.
+ */
+typedef struct {
+    uint32_t midstate[8];       /* Состояние после первых 64 байт */
+    uint32_t state3[8];         /* Состояние после раундов 0-2 */
+    uint32_t w[3];              /* merkle_root[28:32], time, bits (big-endian слова) */
+    uint32_t w16;
+    uint32_t w17;
+    uint32_t w18_base;          /* W18 без sigma0(nonce) */
+    uint32_t w19_base;          /* W19 без nonce */
+} sha256_header_t;
+
 /**
  * @brief Инициализировать контекст SHA256
  * 
@@ -92,6 +127,31 @@ void sha256_transform(uint32_t* state, const uint8_t* block);
  */
 void sha256_mining_hash(const uint8_t* midstate, const uint8_t* tail, uint8_t* hash);
 
+/**
+ * @brief Подготовить хеширование заголовков задания
+ * 
+ * @param header Куда записать подготовленное состояние
+ * @param midstate 32 байта midstate (как в задании)
+ * @param tail 12 байт хвоста без nonce (merkle[28:32] + time + bits)
+ */
+void sha256_header_prepare(sha256_header_t* header, const uint8_t* midstate, const uint8_t* tail);
+
+/**
+ * @brief SHA256d заголовка с данным nonce
+ * 
+ * Результат совпадает с sha256_mining_hash() для хвоста tail + nonce.
+ * 
+ * @param header Подготовленный заголовок
+ * @param nonce Nonce (как в заголовке, little-endian)
+ * @param hash Буфер для результата (32 байта)
+ */
+void sha256_header_hash(const sha256_header_t* header, uint32_t nonce, uint8_t* hash);
+
+/**
+ * @brief Название выбранной реализации (для логов и замера)
+ */
+const char* sha256_impl_name(void);
+
 /**
  * @brief Сравнить хеш с target
  * 
@@ -1,6 +1,9 @@
 /**
  * @file spi.h
  * @brief SPI драйвер для связи с чипами
+ * 
+ * Чипы поделены между SPI_CHAIN_COUNT цепочками (контроллер SPI и канал
+ * DMA на хеш-плату). Номер чипа глобальный, цепочку выбирает драйвер.
  */
 
 #ifndef QUAXIS_SPI_H
@@ -9,6 +12,19 @@
 #include <stdint.h>
 #include <stddef.h>
 
+/** @brief chip_id передачи всем чипам (CS чипов цепочки подключены параллельно) */
+#define SPI_CHIP_BROADCAST 0xFF
+
+/**
+ * @brief Завершение асинхронной передачи
+ * 
+ * Вызывается из прерывания DMA: только короткая работа (флаги, счётчики).
+ * 
+ * @param ctx Контекст из spi_transfer_async
+ * @param status 0 при успехе, -1 при ошибке
+ */
+typedef void (*spi_done_cb)(void* ctx, int status);
+
 /**
  * @brief Инициализировать SPI интерфейс
  * 
@@ -21,6 +37,9 @@ int spi_init(uint32_t clock_hz, uint8_t mode);
 /**
  * @brief Выбрать чип (активировать CS)
  * 
+ * Ждёт очередь DMA только цепочки этого чипа. spi_transfer и
+ * spi_exchange до spi_deselect идут через её контроллер.
+ * 
  * @param chip_id ID чипа (0-113)
  */
 void spi_select(uint8_t chip_id);
@@ -40,6 +59,50 @@ void spi_deselect(void);
  */
 int spi_transfer(const uint8_t* tx_data, uint8_t* rx_data, size_t len);
 
+/**
+ * @brief Поставить передачу чипу в очередь DMA его цепочки
+ * 
+ * CS чипа держится на всю передачу. Передачи одной цепочки идут в
+ * порядке постановки, разных цепочек - одновременно. Функция
+ * возвращается сразу, буферы должны жить до вызова done. Синхронные
+ * передачи (spi_select, spi_broadcast) сначала дожидаются очереди. При
+ * полной очереди ждёт освобождения места.
+ * 
+ * SPI_CHIP_BROADCAST встаёт в очередь каждой цепочки: done вызывается
+ * SPI_CHAIN_COUNT раз.
+ * 
+ * @param chip_id ID чипа (0-113) или SPI_CHIP_BROADCAST
+ * @param tx_data Данные для передачи (может быть NULL)
+ * @param rx_data Буфер для приёма (может быть NULL)
+ * @param len Длина данных
+ * @param done Callback завершения (может быть NULL)
+ * @param ctx Контекст для done
+ * @return 0 при успехе, -1 при ошибке
+ */
+int spi_transfer_async(uint8_t chip_id, const uint8_t* tx_data, uint8_t* rx_data,
+                       size_t len, spi_done_cb done, void* ctx);
+
+/**
+ * @brief Проверить, идут ли передачи DMA
+ * 
+ * @return 1 если очередь хотя бы одной цепочки не пуста, 0 если нет
+ */
+int spi_busy(void);
+
+/**
+ * @brief Дождаться завершения всех передач DMA всех цепочек
+ */
+void spi_wait(void);
+
+/**
+ * @brief Обработчик прерывания завершения DMA цепочки
+ * 
+ * Снимает CS, вызывает done и запускает следующую передачу очереди.
+ * 
+ * @param chain Номер цепочки (канала DMA)
+ */
+void spi_dma_irq_handler(uint8_t chain);
+
 /**
  * @brief Передать данные
  * 
@@ -69,6 +132,8 @@ uint8_t spi_exchange(uint8_t byte);
 /**
  * @brief Broadcast команды всем чипам
  * 
+ * Кадр уходит по всем цепочкам одновременно; функция ждёт его отправки.
+ * 
  * @param data Данные для передачи
  * @param len Длина данных
  * @return 0 при успехе, -1 при ошибке
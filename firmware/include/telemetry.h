@@ -0,0 +1,68 @@
+/**
+ * @file telemetry.h
+ * @brief Компактная телеметрия чипов с дельта-кодированием
+ *
+ * Раз в TELEMETRY_INTERVAL_MS контроллер снимает температуру, частоту,
+ * статус и счётчики nonce всех чипов и отправляет в RSP_TELEMETRY только
+ * изменившиеся поля (формат - в protocol.h). Снимок отправленного хранится
+ * здесь же: разница считается от него, поэтому в установившемся режиме
+ * кадр - несколько байт на чип с новыми nonce.
+ *
+ * Полный снимок (keyframe) уходит после подключения и раз в
+ * TELEMETRY_KEYFRAME_INTERVAL кадров: сервер, потерявший кадр или
+ * подключившийся заново, восстанавливается не дольше чем за этот интервал.
+ * Не поместившиеся в кадр чипы уходят следующим кадром.
+ */
+
+#ifndef QUAXIS_TELEMETRY_H
+#define QUAXIS_TELEMETRY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "config.h"
+#include "protocol.h"
+
+#if TELEMETRY_PAYLOAD_MAX > 1536
+#error "TELEMETRY_PAYLOAD_MAX больше, чем принимает сервер"
+#endif
+
+/**
+ * @brief Телеметрия одного чипа
+ */
+typedef struct {
+    uint8_t  temperature;       /* Температура (°C) */
+    uint8_t  status;            /* Статус: 0=OK, 1=Error */
+    uint16_t frequency_mhz;     /* Частота */
+    uint32_t hw_errors;         /* HW ошибки с запуска */
+    uint32_t good_nonces;       /* Верные nonce с запуска */
+} telemetry_chip_t;
+
+/**
+ * @brief Состояние кодера
+ */
+typedef struct {
+    telemetry_chip_t sent[A1126_CHIP_COUNT];    /* Что знает сервер */
+    uint32_t frames;                            /* Кадров после keyframe */
+    int keyframe;                               /* 1 - следующий кадр полный */
+} telemetry_ctx_t;
+
+/**
+ * @brief Начать поток заново: следующий кадр - keyframe
+ *
+ * Вызывать после каждого подключения к серверу.
+ */
+void telemetry_reset(telemetry_ctx_t* ctx);
+
+/**
+ * @brief Собрать кадр RSP_TELEMETRY
+ *
+ * @param ctx Состояние
+ * @param current Текущая телеметрия чипов (A1126_CHIP_COUNT)
+ * @param buf Буфер кадра (TELEMETRY_HEADER_SIZE + TELEMETRY_PAYLOAD_MAX)
+ * @return Размер кадра, 0 если отправлять нечего
+ */
+size_t telemetry_build_frame(telemetry_ctx_t* ctx,
+                             const telemetry_chip_t* current,
+                             uint8_t* buf);
+
+#endif /* QUAXIS_TELEMETRY_H */
@@ -10,6 +10,7 @@
 #define QUAXIS_VERSION_ROLLING_H
 
 #include <stdint.h>
+#include "protocol.h"
 
 /*
  * Константы Version Rolling
@@ -63,6 +64,55 @@ typedef struct {
     uint16_t rolling_end;       /* Конец диапазона rolling для этого чипа */
 } version_rolling_ctx_t;
 
+/*
+ * Перебор версий на контроллере (CMD_NEW_JOB_ROLL)
+ * 
+ * Сервер присылает первые 64 байта заголовка (version, prev_block,
+ * merkle_root) и маску BIP320. Когда чипы прошли 2^32 nonce текущей
+ * версии, контроллер меняет биты под маской и сам считает midstate -
+ * один SHA256 transform вместо сообщения от сервера. Счётчик next
+ * раскладывается по битам маски и XOR-ится с исходной версией: значение 0
+ * - версия сервера, всего 2^popcount(mask) версий.
+ */
+typedef struct {
+    quaxis_roll_t roll;         /* Задание от сервера */
+    uint32_t next;              /* Следующее значение счётчика */
+    uint32_t count;             /* Версий под маской (не больше 2^31) */
+    uint32_t current_version;   /* Версия загруженного задания */
+    uint8_t  active;            /* 1 пока версии не исчерпаны */
+} version_roll_ctx_t;
+
+/**
+ * @brief Начать перебор версий задания (счётчик 0 - версия сервера)
+ * 
+ * @param ctx Состояние перебора
+ * @param roll Задание CMD_NEW_JOB_ROLL
+ */
+void version_roll_start(version_roll_ctx_t* ctx, const quaxis_roll_t* roll);
+
+/**
+ * @brief Построить задание для следующей версии
+ * 
+ * @param ctx Состояние перебора
+ * @param job Задание для чипов
+ * @return 0 при успехе, 1 если версии исчерпаны (ждать сервер)
+ */
+int version_roll_next_job(version_roll_ctx_t* ctx, quaxis_job_t* job);
+
+/**
+ * @brief Сбросить перебор (пришло другое задание)
+ */
+static inline void version_roll_stop(version_roll_ctx_t* ctx) {
+    if (ctx) ctx->active = 0;
+}
+
+/**
+ * @brief Версия для share текущего задания (0 - перебора нет)
+ */
+static inline uint32_t version_roll_version(const version_roll_ctx_t* ctx) {
+    return (ctx && ctx->active) ? ctx->current_version : 0;
+}
+
 /**
  * @brief Инициализировать контекст version rolling
  * 
@@ -6,9 +6,11 @@
  */
 
 #include "a1126_driver.h"
+#include "nonce_range.h"
 #include "spi.h"
 #include "sha256.h"
 #include "config.h"
+#include "events.h"
 
 #include <string.h>
 
@@ -18,14 +20,18 @@
 #define A1126_REG_MIDSTATE  0x10    /* Регистры midstate (32 байта) */
 #define A1126_REG_TARGET    0x30    /* Регистры target (32 байта) */
 #define A1126_REG_NONCE     0x50    /* Регистр найденного nonce */
+#define A1126_REG_NONCE_COUNT 0x54  /* Счётчик проверенных nonce (uint32) */
 #define A1126_REG_WORK      0x60    /* Регистры рабочих данных */
+#define A1126_REG_NONCE_START 0x61  /* Начальный nonce (байты 40-43 work), за ним конечный */
 #define A1126_REG_TEMP      0x70    /* Регистр температуры */
 #define A1126_REG_FREQ      0x80    /* Регистр частоты */
+#define A1126_REG_SHADOW    0x08    /* Бит адреса: теневой банк задания */
 
 /* Команды управления */
 #define A1126_CMD_START     0x01
 #define A1126_CMD_STOP      0x02
 #define A1126_CMD_RESET     0x04
+#define A1126_CMD_SWAP      0x08    /* Теневой банк задания становится активным */
 
 /* Статус чипа */
 #define A1126_STATUS_IDLE   0x00
@@ -33,13 +39,152 @@
 #define A1126_STATUS_FOUND  0x02
 #define A1126_STATUS_ERROR  0x80
 
+/* Банк регистров задания для a1126_load_job */
+#if A1126_DOUBLE_BUFFER
+#define A1126_JOB_BANK      A1126_REG_SHADOW
+#else
+#define A1126_JOB_BANK      0
+#endif
+
+/* Кадр записи регистра: команда, длина, данные */
+#define A1126_FRAME_HEADER  2
+#define A1126_WORK_SIZE     44
+
+/* Кадр чтения через DMA: команда, длина, до 4 байт ответа */
+#define A1126_READ_FRAME    (A1126_FRAME_HEADER + 4)
+
 /* Глобальные переменные */
 static uint8_t g_target[32];
+static uint8_t g_slot_count = 1;    /* Слотов версий в текущем задании */
 static uint32_t g_hashrate = 0;
 static uint8_t g_avg_temperature = 0;
 
+/*
+ * Кадры асинхронной записи: живут до завершения DMA. Счётчики ещё не
+ * переданных кадров уменьшает прерывание; главный цикл ждёт нуля перед
+ * перезаписью кадров.
+ */
+static uint8_t g_nonce_frames[A1126_CHIP_COUNT][A1126_FRAME_HEADER + 8];
+#if A1126_BROADCAST_LOAD
+static uint8_t g_midstate_frames[A1126_CHIP_COUNT][A1126_FRAME_HEADER + 32];
+#else
+static uint8_t g_work_frames[A1126_CHIP_COUNT][A1126_FRAME_HEADER + A1126_WORK_SIZE];
+#endif
+static uint8_t g_target_frame[A1126_FRAME_HEADER + 32];
+static volatile int g_work_pending = 0;
+static volatile int g_target_pending = 0;
+static uint8_t g_job_loaded = 0;    /* Кадры задания актуальны (для чипов после самодиагностики) */
+#if A1126_BROADCAST_LOAD
+static uint8_t g_broadcast_frame[A1126_FRAME_HEADER + A1126_WORK_SIZE];
+#endif
+
+/* Состояние чипа после сброса */
+#define A1126_CHIP_TESTING  0       /* Самодиагностика не закончена */
+#define A1126_CHIP_READY    1
+#define A1126_CHIP_FAILED   2
+
+/* Кадров чипу, прошедшему самодиагностику: target, задание, диапазон, запуск */
+#define A1126_JOIN_FRAMES   5
+
+/*
+ * Самодиагностика: сброс уходит всем чипам сразу, затем проходы чтения
+ * статуса ещё не проверенных чипов идут через очередь DMA, пока
+ * контроллер подключается к серверу. Проверенный чип сразу получает
+ * target и, если задание уже загружено, придержанный для него диапазон
+ * nonce. Кадры прохода считает g_test_pending.
+ */
+static uint8_t g_chip_state[A1126_CHIP_COUNT];
+static uint8_t g_status_rx[A1126_CHIP_COUNT][A1126_FRAME_HEADER + 1];
+static volatile int g_test_pending = 0;
+static uint8_t g_test_started = 0;
+static uint8_t g_test_reading = 0;  /* В g_status_rx - ответы последнего прохода */
+static uint8_t g_test_done = 0;
+static uint32_t g_test_start_ms = 0;
+static uint32_t g_test_pass_ms = 0;
+
+_Static_assert((A1126_RESULT_RING_SIZE & (A1126_RESULT_RING_SIZE - 1)) == 0,
+               "A1126_RESULT_RING_SIZE должен быть степенью 2");
+
+/*
+ * Найденные nonce: проход по чипам складывает все, главный цикл забирает
+ * пачками. Линия "nonce готов" (A1126_RESULT_IRQ) только взводит флаг -
+ * проход идёт из главного цикла, прерывание шину SPI не трогает.
+ */
+static a1126_result_t g_ring[A1126_RESULT_RING_SIZE];
+static uint32_t g_ring_head = 0;
+static uint32_t g_ring_tail = 0;
+static uint32_t g_ring_overflows = 0;
+static volatile int g_results_pending = 0;
+static int g_scan_start = 0;
+
+/*
+ * Диапазоны nonce чипов: пространство 2^32 каждого слота версий делится
+ * между его чипами. При A1126_NONCE_REBALANCE доли пропорциональны
+ * nonce, проверенным чипом за прошлое задание: недоделанный остаток
+ * медленных чипов к следующему заданию переходит к быстрым.
+ */
+static nonce_range_t g_chip_ranges[A1126_CHIP_COUNT];
+#if A1126_NONCE_REBALANCE
+static uint32_t g_chip_nonce_count[A1126_CHIP_COUNT];   /* Счётчик на прошлой загрузке */
+#endif
+static uint32_t g_chip_hw_errors[A1126_CHIP_COUNT];     /* Nonce, не прошедшие проверку */
+static uint32_t g_chip_good_nonces[A1126_CHIP_COUNT];   /* Nonce, прошедшие проверку */
+static uint16_t g_chip_freq_mhz[A1126_CHIP_COUNT];      /* Последняя заданная частота */
+
+static const uint8_t g_start_frame[] = {0x80 | A1126_REG_CTRL, 1, A1126_CMD_START};
+static const uint8_t g_stop_frame[] = {0x80 | A1126_REG_CTRL, 1, A1126_CMD_STOP};
+static const uint8_t g_swap_frame[] = {0x80 | A1126_REG_CTRL, 1, A1126_CMD_SWAP | A1126_CMD_START};
+static const uint8_t g_reset_frame[] = {0x80 | A1126_REG_CTRL, 1, A1126_CMD_RESET};
+static const uint8_t g_status_frame[] = {A1126_REG_STATUS, 1, 0};
+static const uint8_t g_nonce_read_frame[] = {A1126_REG_NONCE, 4, 0, 0, 0, 0};
+static const uint8_t g_clear_frame[] = {0x80 | A1126_REG_STATUS, 1, 0};
+
+/*
+ * Опрос чипов (статус, найденные nonce, счётчики, температура) идёт
+ * через очереди DMA: цепочки SPI отвечают одновременно, проход по всем
+ * чипам занимает время самой длинной цепочки. Ответ чипа - с байта
+ * A1126_FRAME_HEADER его буфера.
+ */
+static uint8_t g_scan_rx[A1126_CHIP_COUNT][A1126_READ_FRAME];   /* Статус */
+static uint8_t g_value_rx[A1126_CHIP_COUNT][A1126_READ_FRAME];  /* Nonce, счётчик, температура */
+static volatile int g_read_pending = 0;
+
 /* Внутренние функции */
 
+static void frame_done(void* ctx, int status) {
+    (void)status;
+    volatile int* pending = (volatile int*)ctx;
+    *pending = *pending - 1;
+}
+
+static void wait_frames(volatile int* pending) {
+    while (*pending > 0) {
+        /* Предыдущая запись этих кадров ещё на шине */
+    }
+}
+
+/**
+ * @brief Записать кадр во все чипы через очередь DMA
+ * 
+ * @param frames Кадры (stride > 0 - свой кадр на чип, 0 - общий)
+ * @param pending Счётчик кадров для frame_done (может быть NULL)
+ */
+static int chips_write_async(const uint8_t* frames, size_t stride, size_t len,
+                             volatile int* pending) {
+    if (pending) {
+        *pending = A1126_CHIP_COUNT;
+    }
+    
+    for (int chip = 0; chip < A1126_CHIP_COUNT; chip++) {
+        if (spi_transfer_async((uint8_t)chip, frames + (size_t)chip * stride, NULL, len,
+                               pending ? frame_done : NULL, (void*)pending) != 0) {
+            return -1;
+        }
+    }
+    
+    return 0;
+}
+
 static int chip_write_reg(uint8_t chip_id, uint8_t reg, const uint8_t* data, size_t len) {
     uint8_t cmd[2];
     cmd[0] = 0x80 | reg;  /* Бит записи */
@@ -66,37 +211,244 @@ static int chip_read_reg(uint8_t chip_id, uint8_t reg, uint8_t* data, size_t len
     return 0;
 }
 
+/**
+ * @brief Прочитать регистр всех проверенных чипов через очереди DMA
+ * 
+ * Чтения разных цепочек идут одновременно; возвращается после всех ответов.
+ */
+static void chips_read_reg(uint8_t reg, size_t len, uint8_t (*rx)[A1126_READ_FRAME]) {
+    static uint8_t tx[A1126_READ_FRAME];
+    tx[0] = reg;  /* Бит чтения = 0 */
+    tx[1] = (uint8_t)len;
+    
+    g_read_pending = a1126_working_chips();
+    for (int chip = 0; chip < A1126_CHIP_COUNT; chip++) {
+        if (g_chip_state[chip] == A1126_CHIP_READY) {
+            spi_transfer_async((uint8_t)chip, tx, rx[chip], A1126_FRAME_HEADER + len,
+                               frame_done, (void*)&g_read_pending);
+        }
+    }
+    wait_frames(&g_read_pending);
+}
+
+static uint32_t read_u32(const uint8_t* rx) {
+    const uint8_t* value = rx + A1126_FRAME_HEADER;
+    return (uint32_t)value[0] |
+           ((uint32_t)value[1] << 8) |
+           ((uint32_t)value[2] << 16) |
+           ((uint32_t)value[3] << 24);
+}
+
 static uint8_t chip_read_status(uint8_t chip_id) {
     uint8_t status;
     chip_read_reg(chip_id, A1126_REG_STATUS, &status, 1);
     return status;
 }
 
+static uint32_t chip_read_nonce_count(uint8_t chip_id) {
+    uint8_t count[4];
+    chip_read_reg(chip_id, A1126_REG_NONCE_COUNT, count, 4);
+    return (uint32_t)count[0] |
+           ((uint32_t)count[1] << 8) |
+           ((uint32_t)count[2] << 16) |
+           ((uint32_t)count[3] << 24);
+}
+
+#if A1126_NONCE_REBALANCE
+/**
+ * @brief Веса чипов: nonce, проверенные с прошлой загрузки
+ * 
+ * Чип с ошибкой получает 0 (его диапазон уходит остальным). Исправный,
+ * но отставший чип - не меньше 1/16 среднего: иначе он остался бы без
+ * работы и его хешрейт больше не измерялся бы. Чипу на самодиагностике
+ * придерживается средняя доля; пока счётчиков нет - всем поровну.
+ */
+static void chip_weights(uint32_t* weights) {
+    uint8_t failed[A1126_CHIP_COUNT];
+    uint64_t sum = 0;
+    uint32_t healthy = 0;
+    
+    chips_read_reg(A1126_REG_NONCE_COUNT, 4, g_value_rx);
+    chips_read_reg(A1126_REG_STATUS, 1, g_scan_rx);
+    
+    for (int chip = 0; chip < A1126_CHIP_COUNT; chip++) {
+        weights[chip] = 0;
+        failed[chip] = (g_chip_state[chip] == A1126_CHIP_FAILED) ? 1 : 0;
+        if (g_chip_state[chip] != A1126_CHIP_READY) {
+            continue;
+        }
+        
+        uint32_t count = read_u32(g_value_rx[chip]);
+        weights[chip] = count - g_chip_nonce_count[chip];  /* Переполнение счётчика - по модулю */
+        g_chip_nonce_count[chip] = count;
+        
+        failed[chip] = (g_scan_rx[chip][A1126_FRAME_HEADER] & A1126_STATUS_ERROR) ? 1 : 0;
+        if (failed[chip]) {
+            weights[chip] = 0;
+        } else {
+            sum += weights[chip];
+            healthy++;
+        }
+    }
+    
+    uint32_t mean = healthy ? (uint32_t)(sum / healthy) : 0;
+    uint32_t floor = mean / 16;
+    if (mean == 0) {
+        mean = floor = 1;
+    }
+    for (int chip = 0; chip < A1126_CHIP_COUNT; chip++) {
+        if (failed[chip]) {
+            continue;
+        }
+        if (g_chip_state[chip] == A1126_CHIP_TESTING) {
+            weights[chip] = mean;
+        } else if (weights[chip] < floor) {
+            weights[chip] = floor;
+        }
+    }
+}
+#endif
+
+/**
+ * @brief Разделить nonce каждого слота версий между его чипами
+ * 
+ * Чип chip перебирает слот chip % g_slot_count.
+ */
+static void assign_nonce_ranges(void) {
+    static uint32_t weights[A1126_CHIP_COUNT];
+    static uint32_t slot_weights[A1126_CHIP_COUNT];
+    static nonce_range_t slot_ranges[A1126_CHIP_COUNT];
+    
+#if A1126_NONCE_REBALANCE
+    chip_weights(weights);
+#else
+    /* Поровну между чипами, не отбракованными самодиагностикой */
+    for (int chip = 0; chip < A1126_CHIP_COUNT; chip++) {
+        weights[chip] = (g_chip_state[chip] == A1126_CHIP_FAILED) ? 0 : 1;
+    }
+#endif
+    
+    for (int slot = 0; slot < g_slot_count; slot++) {
+        uint16_t count = 0;
+        for (int chip = slot; chip < A1126_CHIP_COUNT; chip += g_slot_count) {
+            slot_weights[count++] = weights[chip];
+        }
+        
+        nonce_range_split_weighted(slot_ranges, slot_weights, count, 0, 0xFFFFFFFF);
+        
+        count = 0;
+        for (int chip = slot; chip < A1126_CHIP_COUNT; chip += g_slot_count) {
+            g_chip_ranges[chip] = slot_ranges[count++];
+            g_chip_ranges[chip].chip_id = (uint8_t)chip;
+        }
+    }
+}
+
+/**
+ * @brief Кадр диапазона nonce чипа: начальный и конечный nonce
+ */
+static void build_nonce_frame(int chip) {
+    const nonce_range_t* range = &g_chip_ranges[chip];
+    uint8_t* frame = g_nonce_frames[chip];
+    frame[0] = 0x80 | A1126_REG_NONCE_START | A1126_JOB_BANK;
+    frame[1] = 8;
+    frame[2] = (uint8_t)(range->start & 0xFF);
+    frame[3] = (uint8_t)((range->start >> 8) & 0xFF);
+    frame[4] = (uint8_t)((range->start >> 16) & 0xFF);
+    frame[5] = (uint8_t)((range->start >> 24) & 0xFF);
+    frame[6] = (uint8_t)(range->end & 0xFF);
+    frame[7] = (uint8_t)((range->end >> 8) & 0xFF);
+    frame[8] = (uint8_t)((range->end >> 16) & 0xFF);
+    frame[9] = (uint8_t)((range->end >> 24) & 0xFF);
+}
+
+/**
+ * @brief Кадры чипа, прошедшего самодиагностику
+ * 
+ * Target, затем (если задание загружено) задание и придержанный
+ * диапазон nonce из кадров последней загрузки и команда запуска.
+ * 
+ * @return Количество кадров (не больше A1126_JOIN_FRAMES)
+ */
+static int join_frames(int chip, const uint8_t** frames, size_t* lens) {
+    int count = 0;
+    
+    if (g_target_frame[1] != 0) {
+        frames[count] = g_target_frame;
+        lens[count++] = sizeof(g_target_frame);
+    }
+    if (!g_job_loaded) {
+        return count;
+    }
+
+#if A1126_BROADCAST_LOAD
+    frames[count] = g_broadcast_frame;
+    lens[count++] = sizeof(g_broadcast_frame);
+    if (chip % g_slot_count != 0) {
+        frames[count] = g_midstate_frames[chip];
+        lens[count++] = sizeof(g_midstate_frames[chip]);
+    }
+#else
+    frames[count] = g_work_frames[chip];
+    lens[count++] = sizeof(g_work_frames[chip]);
+#endif
+    frames[count] = g_nonce_frames[chip];
+    lens[count++] = sizeof(g_nonce_frames[chip]);
+
+#if A1126_DOUBLE_BUFFER
+    /* Задание записано в теневой банк, как у остальных чипов */
+    frames[count] = g_swap_frame;
+    lens[count++] = sizeof(g_swap_frame);
+#else
+    frames[count] = g_start_frame;
+    lens[count++] = sizeof(g_start_frame);
+#endif
+    return count;
+}
+
 /* Публичные функции */
 
 int a1126_init(void) {
-    /* Сброс всех чипов */
+    /* Сброс всех чипов; самодиагностику ведёт a1126_self_test_poll */
     return a1126_reset();
 }
 
 int a1126_reset(void) {
-    uint8_t cmd = A1126_CMD_RESET;
+    /* Кадры прошлой самодиагностики и загрузки ещё на шине */
+    wait_frames(&g_test_pending);
+    wait_frames(&g_work_pending);
     
-    /* Broadcast сброс на все чипы */
     for (int chip = 0; chip < A1126_CHIP_COUNT; chip++) {
-        chip_write_reg((uint8_t)chip, A1126_REG_CTRL, &cmd, 1);
+        g_chip_state[chip] = A1126_CHIP_TESTING;
+#if A1126_NONCE_REBALANCE
+        g_chip_nonce_count[chip] = 0;
+#endif
     }
-    
-    /* Ждём завершения сброса */
-    /* delay_ms(100); */
-    
-    return 0;
+    g_job_loaded = 0;
+    g_test_started = 0;
+    g_test_reading = 0;
+    g_test_done = 0;
+
+#if A1126_BROADCAST_LOAD
+    /* Один кадр сброса всем чипам */
+    return spi_transfer_async(SPI_CHIP_BROADCAST, g_reset_frame, NULL, sizeof(g_reset_frame),
+                              NULL, NULL);
+#else
+    return chips_write_async(g_reset_frame, 0, sizeof(g_reset_frame), NULL);
+#endif
 }
 
 int a1126_load_job(const quaxis_job_t* job) {
     if (!job) return -1;
     
-    uint8_t work_data[48];
+    /* Предыдущее задание ещё загружается */
+    wait_frames(&g_work_pending);
+    wait_frames(&g_test_pending);
+    
+    /* Nonce старого задания не забраны до переключения - уже не нужны */
+    g_ring_head = g_ring_tail;
+    
+    uint8_t work_data[A1126_WORK_SIZE];
     
     /* Копируем midstate */
     memcpy(work_data, job->midstate, 32);
@@ -119,22 +471,100 @@ int a1126_load_job(const quaxis_job_t* job) {
     
     /* job_id не нужен чипу, он хранится на контроллере */
     
-    /* Загружаем задание во все чипы */
-    /* В реальности каждый чип получает свой диапазон nonce */
-    uint32_t nonce_per_chip = 0xFFFFFFFF / A1126_CHIP_COUNT;
+    /* Слоты версий: чипы делятся между midstate, хвост у всех общий */
+    g_slot_count = (job->version_count > 1) ? job->version_count : 1;
+    
+    /* Каждый чип получает свой диапазон nonce */
+    assign_nonce_ranges();
+    
+#if A1126_BROADCAST_LOAD
+    /*
+     * Общая часть (midstate слота 0 и хвост) уходит всем чипам одним
+     * broadcast, затем каждому чипу - только его диапазон nonce, а чипам
+     * других слотов - их midstate.
+     */
+    if (g_slot_count > 1) {
+        memcpy(work_data, job->version_midstates[0], 32);
+    }
+    
+    g_broadcast_frame[0] = 0x80 | A1126_REG_WORK | A1126_JOB_BANK;
+    g_broadcast_frame[1] = A1126_WORK_SIZE;
+    memcpy(g_broadcast_frame + A1126_FRAME_HEADER, work_data, A1126_WORK_SIZE);
+    spi_broadcast(g_broadcast_frame, sizeof(g_broadcast_frame));
+    
+    /* Кадры чипов на самодиагностике строятся тоже: они уйдут после проверки */
+    int frames = 0;
+    for (int chip = 0; chip < A1126_CHIP_COUNT; chip++) {
+        build_nonce_frame(chip);
+        int ready = g_chip_state[chip] == A1126_CHIP_READY;
+        frames += ready;
+        
+        if (chip % g_slot_count != 0) {
+            uint8_t* frame = g_midstate_frames[chip];
+            frame[0] = 0x80 | A1126_REG_MIDSTATE | A1126_JOB_BANK;
+            frame[1] = 32;
+            memcpy(frame + A1126_FRAME_HEADER, job->version_midstates[chip % g_slot_count], 32);
+            frames += ready;
+        }
+    }
+    g_job_loaded = 1;
+    
+    /* Кадры уходят по DMA, контроллер свободен для сети */
+    g_work_pending = frames;
+    for (int chip = 0; chip < A1126_CHIP_COUNT; chip++) {
+        if (g_chip_state[chip] != A1126_CHIP_READY) {
+            continue;
+        }
+        if (chip % g_slot_count != 0 &&
+            spi_transfer_async((uint8_t)chip, g_midstate_frames[chip], NULL,
+                               sizeof(g_midstate_frames[chip]), frame_done,
+                               (void*)&g_work_pending) != 0) {
+            return -1;
+        }
+        if (spi_transfer_async((uint8_t)chip, g_nonce_frames[chip], NULL,
+                               sizeof(g_nonce_frames[chip]), frame_done,
+                               (void*)&g_work_pending) != 0) {
+            return -1;
+        }
+    }
     
+    return 0;
+#else
+    int frames = 0;
     for (int chip = 0; chip < A1126_CHIP_COUNT; chip++) {
-        /* Устанавливаем начальный nonce для этого чипа */
-        uint32_t start_nonce = (uint32_t)chip * nonce_per_chip;
-        work_data[40] = (uint8_t)(start_nonce & 0xFF);
-        work_data[41] = (uint8_t)((start_nonce >> 8) & 0xFF);
-        work_data[42] = (uint8_t)((start_nonce >> 16) & 0xFF);
-        work_data[43] = (uint8_t)((start_nonce >> 24) & 0xFF);
+        if (g_slot_count > 1) {
+            memcpy(work_data, job->version_midstates[chip % g_slot_count], 32);
+        }
         
-        chip_write_reg((uint8_t)chip, A1126_REG_WORK, work_data, 44);
+        uint8_t* frame = g_work_frames[chip];
+        frame[0] = 0x80 | A1126_REG_WORK | A1126_JOB_BANK;
+        frame[1] = A1126_WORK_SIZE;
+        memcpy(frame + A1126_FRAME_HEADER, work_data, A1126_WORK_SIZE);
+        build_nonce_frame(chip);
+        frames += 2 * (g_chip_state[chip] == A1126_CHIP_READY);
+    }
+    g_job_loaded = 1;
+    
+    /* Чипы загружаются по DMA, контроллер свободен для сети */
+    g_work_pending = frames;
+    for (int chip = 0; chip < A1126_CHIP_COUNT; chip++) {
+        if (g_chip_state[chip] != A1126_CHIP_READY) {
+            continue;
+        }
+        if (spi_transfer_async((uint8_t)chip, g_work_frames[chip], NULL,
+                               sizeof(g_work_frames[chip]), frame_done,
+                               (void*)&g_work_pending) != 0) {
+            return -1;
+        }
+        if (spi_transfer_async((uint8_t)chip, g_nonce_frames[chip], NULL,
+                               sizeof(g_nonce_frames[chip]), frame_done,
+                               (void*)&g_work_pending) != 0) {
+            return -1;
+        }
     }
     
     return 0;
+#endif
 }
 
 int a1126_set_target(const uint8_t* target) {
@@ -142,64 +572,147 @@ int a1126_set_target(const uint8_t* target) {
     
     memcpy(g_target, target, 32);
     
-    /* Отправляем target на все чипы */
-    for (int chip = 0; chip < A1126_CHIP_COUNT; chip++) {
-        chip_write_reg((uint8_t)chip, A1126_REG_TARGET, target, 32);
-    }
+    /* Один кадр target на все чипы */
+    wait_frames(&g_target_pending);
+    wait_frames(&g_test_pending);
+    g_target_frame[0] = 0x80 | A1126_REG_TARGET;
+    g_target_frame[1] = 32;
+    memcpy(g_target_frame + A1126_FRAME_HEADER, target, 32);
     
-    return 0;
+    return chips_write_async(g_target_frame, 0, sizeof(g_target_frame), &g_target_pending);
 }
 
 int a1126_start(void) {
-    uint8_t cmd = A1126_CMD_START;
+    return chips_write_async(g_start_frame, 0, sizeof(g_start_frame), NULL);
+}
+
+int a1126_stop(void) {
+    /* Чип, прошедший самодиагностику после остановки, не запускается */
+    g_job_loaded = 0;
+    return chips_write_async(g_stop_frame, 0, sizeof(g_stop_frame), NULL);
+}
+
+int a1126_swap(void) {
+#if A1126_BROADCAST_LOAD
+    /* Один кадр: все чипы переключаются одновременно */
+    return spi_transfer_async(SPI_CHIP_BROADCAST, g_swap_frame, NULL, sizeof(g_swap_frame),
+                              NULL, NULL);
+#else
+    return chips_write_async(g_swap_frame, 0, sizeof(g_swap_frame), NULL);
+#endif
+}
+
+void a1126_result_irq_handler(void) {
+    /* TODO: Сбросить флаг прерывания GPIO */
+    g_results_pending = 1;
+    event_post(EVENT_CHIP_RESULT);
+}
+
+int a1126_collect_results(void) {
+    /* Чипы ещё получают задание: результатов нового задания нет */
+    if (spi_busy()) return 0;
     
+#if A1126_RESULT_IRQ
+    /* Ни один чип не поднимал линию nonce - шину не трогаем */
+    if (!g_results_pending) return 0;
+#endif
+    /* Сброс до прохода: nonce во время прохода даст следующий */
+    g_results_pending = 0;
+    
+    /* Статус всех чипов - одним проходом по цепочкам */
+    chips_read_reg(A1126_REG_STATUS, 1, g_scan_rx);
+    
+    int found = 0;
     for (int chip = 0; chip < A1126_CHIP_COUNT; chip++) {
-        chip_write_reg((uint8_t)chip, A1126_REG_CTRL, &cmd, 1);
+        found += g_chip_state[chip] == A1126_CHIP_READY &&
+                 (g_scan_rx[chip][A1126_FRAME_HEADER] & A1126_STATUS_FOUND);
     }
+    if (found == 0) return 0;
     
-    return 0;
+    /* Найденный nonce и сброс флага результата - тоже по всем цепочкам сразу */
+    g_read_pending = 2 * found;
+    for (int chip = 0; chip < A1126_CHIP_COUNT; chip++) {
+        if (g_chip_state[chip] != A1126_CHIP_READY ||
+            !(g_scan_rx[chip][A1126_FRAME_HEADER] & A1126_STATUS_FOUND)) {
+            continue;
+        }
+        spi_transfer_async((uint8_t)chip, g_nonce_read_frame, g_value_rx[chip],
+                           sizeof(g_nonce_read_frame), frame_done, (void*)&g_read_pending);
+        spi_transfer_async((uint8_t)chip, g_clear_frame, NULL, sizeof(g_clear_frame),
+                           frame_done, (void*)&g_read_pending);
+    }
+    wait_frames(&g_read_pending);
+    
+    /* Начало разбора сдвигается - при полном буфере теряют чипы по очереди */
+    int collected = 0;
+    int first = g_scan_start;
+    g_scan_start = (g_scan_start + 1) % A1126_CHIP_COUNT;
+    
+    for (int i = 0; i < A1126_CHIP_COUNT; i++) {
+        int chip = (first + i) % A1126_CHIP_COUNT;
+        if (g_chip_state[chip] != A1126_CHIP_READY ||
+            !(g_scan_rx[chip][A1126_FRAME_HEADER] & A1126_STATUS_FOUND)) {
+            continue;
+        }
+        
+        if (g_ring_tail - g_ring_head >= A1126_RESULT_RING_SIZE) {
+            g_ring_overflows++;
+            continue;
+        }
+        
+        a1126_result_t* result = &g_ring[g_ring_tail & (A1126_RESULT_RING_SIZE - 1)];
+        result->chip_id = (uint8_t)chip;
+        result->version_slot = (uint8_t)(chip % g_slot_count);
+        result->nonce = read_u32(g_value_rx[chip]);
+        result->valid = 1;
+        g_ring_tail++;
+        collected++;
+    }
+    
+    return collected;
 }
 
-int a1126_stop(void) {
-    uint8_t cmd = A1126_CMD_STOP;
+int a1126_poll_results(a1126_result_t* results, int max_results) {
+    if (!results || max_results <= 0) return -1;
     
-    for (int chip = 0; chip < A1126_CHIP_COUNT; chip++) {
-        chip_write_reg((uint8_t)chip, A1126_REG_CTRL, &cmd, 1);
+    int count = 0;
+    while (count < max_results && g_ring_head != g_ring_tail) {
+        results[count++] = g_ring[g_ring_head & (A1126_RESULT_RING_SIZE - 1)];
+        g_ring_head++;
     }
     
-    return 0;
+    return count;
+}
+
+uint32_t a1126_result_overflows(void) {
+    return g_ring_overflows;
+}
+
+void a1126_record_nonce(uint8_t chip_id, int good) {
+    if (chip_id >= A1126_CHIP_COUNT) return;
+    
+    if (good) {
+        g_chip_good_nonces[chip_id]++;
+    } else {
+        g_chip_hw_errors[chip_id]++;
+    }
 }
 
-int a1126_poll_result(a1126_result_t* result) {
-    if (!result) return -1;
+int a1126_work_done(void) {
+    if (spi_busy()) return 0;
     
-    result->valid = 0;
+    /* Придержанный диапазон чипа на самодиагностике ещё не перебран */
+    if (!g_test_done) return 0;
     
-    /* Опрашиваем каждый чип */
+    chips_read_reg(A1126_REG_STATUS, 1, g_scan_rx);
     for (int chip = 0; chip < A1126_CHIP_COUNT; chip++) {
-        uint8_t status = chip_read_status((uint8_t)chip);
-        
-        if (status & A1126_STATUS_FOUND) {
-            /* Читаем найденный nonce */
-            uint8_t nonce_bytes[4];
-            chip_read_reg((uint8_t)chip, A1126_REG_NONCE, nonce_bytes, 4);
-            
-            result->chip_id = (uint8_t)chip;
-            result->nonce = (uint32_t)nonce_bytes[0] |
-                           ((uint32_t)nonce_bytes[1] << 8) |
-                           ((uint32_t)nonce_bytes[2] << 16) |
-                           ((uint32_t)nonce_bytes[3] << 24);
-            result->valid = 1;
-            
-            /* Сбрасываем флаг найденного результата */
-            uint8_t clear = 0;
-            chip_write_reg((uint8_t)chip, A1126_REG_STATUS, &clear, 1);
-            
-            return 1;
+        if (g_chip_state[chip] == A1126_CHIP_READY &&
+            (g_scan_rx[chip][A1126_FRAME_HEADER] & (A1126_STATUS_MINING | A1126_STATUS_FOUND))) {
+            return 0;
         }
     }
     
-    return 0;
+    return 1;
 }
 
 int a1126_get_chip_status(uint8_t chip_id, a1126_chip_status_t* status) {
@@ -216,12 +729,40 @@ int a1126_get_chip_status(uint8_t chip_id, a1126_chip_status_t* status) {
     
     /* Остальные поля */
     status->voltage = 0;  /* TODO */
-    status->nonce_count = 0;  /* TODO */
-    status->error_count = 0;  /* TODO */
+    status->nonce_count = chip_read_nonce_count(chip_id);
+    status->error_count = g_chip_hw_errors[chip_id];
+    status->good_count = g_chip_good_nonces[chip_id];
+    status->frequency_mhz = g_chip_freq_mhz[chip_id];
     
     return 0;
 }
 
+void a1126_get_chips_status(a1126_chip_status_t* statuses) {
+    if (!statuses) return;
+    
+    /* Три прохода по всем цепочкам вместо трёх чтений на чип подряд */
+    chips_read_reg(A1126_REG_STATUS, 1, g_scan_rx);
+    chips_read_reg(A1126_REG_TEMP, 1, g_value_rx);
+    for (int chip = 0; chip < A1126_CHIP_COUNT; chip++) {
+        a1126_chip_status_t* status = &statuses[chip];
+        int ready = g_chip_state[chip] == A1126_CHIP_READY;
+        status->chip_id = (uint8_t)chip;
+        status->temperature = ready ? g_value_rx[chip][A1126_FRAME_HEADER] : 0;
+        status->status = ready ? ((g_scan_rx[chip][A1126_FRAME_HEADER] & A1126_STATUS_ERROR) ? 1 : 0)
+                               : (g_chip_state[chip] == A1126_CHIP_FAILED);
+        status->voltage = 0;  /* TODO */
+        status->error_count = g_chip_hw_errors[chip];
+        status->good_count = g_chip_good_nonces[chip];
+        status->frequency_mhz = g_chip_freq_mhz[chip];
+    }
+    
+    chips_read_reg(A1126_REG_NONCE_COUNT, 4, g_value_rx);
+    for (int chip = 0; chip < A1126_CHIP_COUNT; chip++) {
+        statuses[chip].nonce_count = g_chip_state[chip] == A1126_CHIP_READY
+            ? read_u32(g_value_rx[chip]) : 0;
+    }
+}
+
 uint32_t a1126_get_hashrate(void) {
     /* В реальности нужно измерять на основе времени и количества проверенных nonce */
     /* Для Avalon 1126 Pro: ~90 TH/s = 90 * 10^12 H/s */
@@ -232,9 +773,12 @@ uint8_t a1126_get_temperature(void) {
     uint32_t sum = 0;
     int count = 0;
     
+    chips_read_reg(A1126_REG_TEMP, 1, g_value_rx);
     for (int chip = 0; chip < A1126_CHIP_COUNT; chip++) {
-        uint8_t temp;
-        chip_read_reg((uint8_t)chip, A1126_REG_TEMP, &temp, 1);
+        if (g_chip_state[chip] != A1126_CHIP_READY) {
+            continue;
+        }
+        uint8_t temp = g_value_rx[chip][A1126_FRAME_HEADER];
         if (temp > 0 && temp < 150) {  /* Фильтруем невалидные значения */
             sum += temp;
             count++;
@@ -245,13 +789,21 @@ uint8_t a1126_get_temperature(void) {
     return g_avg_temperature;
 }
 
-int a1126_set_frequency(uint16_t freq_mhz) {
+int a1126_set_chip_frequency(uint8_t chip_id, uint16_t freq_mhz) {
+    if (chip_id >= A1126_CHIP_COUNT) return -1;
+    
     uint8_t freq_data[2];
     freq_data[0] = (uint8_t)(freq_mhz & 0xFF);
     freq_data[1] = (uint8_t)((freq_mhz >> 8) & 0xFF);
+    chip_write_reg(chip_id, A1126_REG_FREQ, freq_data, 2);
+    g_chip_freq_mhz[chip_id] = freq_mhz;
     
+    return 0;
+}
+
+int a1126_set_frequency(uint16_t freq_mhz) {
     for (int chip = 0; chip < A1126_CHIP_COUNT; chip++) {
-        chip_write_reg((uint8_t)chip, A1126_REG_FREQ, freq_data, 2);
+        a1126_set_chip_frequency((uint8_t)chip, freq_mhz);
     }
     
     return 0;
@@ -263,17 +815,99 @@ int a1126_set_voltage(uint16_t voltage_mv) {
     return 0;
 }
 
-int a1126_self_test(void) {
-    int working = 0;
+int a1126_self_test_poll(uint32_t now_ms) {
+    static uint8_t joined[A1126_CHIP_COUNT];
+    const uint8_t* frames[A1126_JOIN_FRAMES];
+    size_t lens[A1126_JOIN_FRAMES];
     
+    if (g_test_done) return 0;
+    
+    if (!g_test_started) {
+        g_test_started = 1;
+        g_test_start_ms = now_ms;
+        g_test_pass_ms = now_ms - A1126_SELF_TEST_PASS_MS;  /* Первый проход - сразу */
+    }
+    
+    /* Проход ещё на шине */
+    if (g_test_pending > 0) return 0;
+    
+    int verified = 0;
+    int testing = 0;
+    int count = 0;
     for (int chip = 0; chip < A1126_CHIP_COUNT; chip++) {
-        uint8_t status = chip_read_status((uint8_t)chip);
+        if (g_chip_state[chip] != A1126_CHIP_TESTING) {
+            continue;
+        }
         
-        /* Проверяем, что чип отвечает и нет ошибок */
-        if (status != 0xFF && !(status & A1126_STATUS_ERROR)) {
-            working++;
+        /* Чип отвечает (не 0xFF) и без ошибки; ещё в сбросе - следующий проход */
+        uint8_t status = g_status_rx[chip][A1126_FRAME_HEADER];
+        if (g_test_reading && status != 0xFF) {
+            if (status & A1126_STATUS_ERROR) {
+                g_chip_state[chip] = A1126_CHIP_FAILED;
+            } else {
+                g_chip_state[chip] = A1126_CHIP_READY;
+                joined[verified++] = (uint8_t)chip;
+                count += join_frames(chip, frames, lens);
+            }
+            continue;
+        }
+        testing++;
+    }
+    g_test_reading = 0;
+    
+    if (testing > 0 && now_ms - g_test_start_ms >= A1126_SELF_TEST_TIMEOUT_MS) {
+        for (int chip = 0; chip < A1126_CHIP_COUNT; chip++) {
+            if (g_chip_state[chip] == A1126_CHIP_TESTING) {
+                g_chip_state[chip] = A1126_CHIP_FAILED;
+            }
+        }
+        testing = 0;
+    }
+    
+    int pass = testing > 0 && now_ms - g_test_pass_ms >= A1126_SELF_TEST_PASS_MS;
+    if (pass) {
+        count += testing;
+    }
+    g_test_done = testing == 0;
+    
+    /* Счётчик - до постановки: прерывание уменьшает его с первого кадра */
+    g_test_pending = count;
+    for (int i = 0; i < verified; i++) {
+        int n = join_frames(joined[i], frames, lens);
+        for (int f = 0; f < n; f++) {
+            if (spi_transfer_async(joined[i], frames[f], NULL, lens[f], frame_done,
+                                   (void*)&g_test_pending) != 0) {
+                return -1;
+            }
         }
     }
     
+    if (pass) {
+        g_test_pass_ms = now_ms;
+        g_test_reading = 1;
+        for (int chip = 0; chip < A1126_CHIP_COUNT; chip++) {
+            if (g_chip_state[chip] == A1126_CHIP_TESTING &&
+                spi_transfer_async((uint8_t)chip, g_status_frame, g_status_rx[chip],
+                                   sizeof(g_status_frame), frame_done,
+                                   (void*)&g_test_pending) != 0) {
+                return -1;
+            }
+        }
+    }
+    
+    return verified;
+}
+
+int a1126_self_test_done(void) {
+    return g_test_done;
+}
+
+int a1126_working_chips(void) {
+    int working = 0;
+    
+    for (int chip = 0; chip < A1126_CHIP_COUNT; chip++) {
+        working += g_chip_state[chip] == A1126_CHIP_READY;
+    }
+    
     return working;
 }
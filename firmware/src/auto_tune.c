@@ -0,0 +1,200 @@
+/**
+ * @file auto_tune.c
+ * @brief Реализация автонастройки частоты чипов
+ */
+
+#include "auto_tune.h"
+#include "a1126_driver.h"
+
+#include <string.h>
+
+/**
+ * @brief Целый квадратный корень (вниз)
+ */
+static uint64_t isqrt64(uint64_t value) {
+    uint64_t root = 0;
+    uint64_t bit = 1ULL << 62;
+    while (bit > value) {
+        bit >>= 2;
+    }
+    while (bit != 0) {
+        if (value >= root + bit) {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return root;
+}
+
+/**
+ * @brief Сбросить счётчики окна; с reset_base - и базы сравнения
+ */
+static void start_window(auto_tune_ctx_t* ctx, uint32_t now_ms, int reset_base) {
+    for (int chip = 0; chip < A1126_CHIP_COUNT; chip++) {
+        auto_tune_chip_t* state = &ctx->chips[chip];
+        state->good = 0;
+        state->bad = 0;
+        if (reset_base) {
+            state->last_energy = 0;
+        }
+    }
+    ctx->window_start_ms = now_ms;
+}
+
+void auto_tune_init(auto_tune_ctx_t* ctx, uint32_t now_ms) {
+    if (!ctx) return;
+
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->difficulty = 1;
+    for (int chip = 0; chip < A1126_CHIP_COUNT; chip++) {
+        auto_tune_chip_t* state = &ctx->chips[chip];
+        state->freq_mhz = AUTO_TUNE_FREQ_START_MHZ;
+        state->direction = 1;
+        a1126_set_chip_frequency((uint8_t)chip, state->freq_mhz);
+    }
+
+    ctx->metrics.freq_avg_mhz = AUTO_TUNE_FREQ_START_MHZ;
+    ctx->metrics.freq_min_mhz = AUTO_TUNE_FREQ_START_MHZ;
+    ctx->metrics.freq_max_mhz = AUTO_TUNE_FREQ_START_MHZ;
+    start_window(ctx, now_ms, 1);
+}
+
+void auto_tune_set_difficulty(auto_tune_ctx_t* ctx, uint32_t difficulty, uint32_t now_ms) {
+    if (!ctx) return;
+
+    ctx->difficulty = difficulty > 0 ? difficulty : 1;
+    start_window(ctx, now_ms, 1);
+}
+
+/**
+ * @brief Следующая частота чипа по итогам окна
+ *
+ * @param state Состояние чипа
+ * @param energy Энергия чипа в окне
+ * @param fault 1 если чип перегрет, с ошибкой или с неверными nonce
+ * @return Новая частота
+ */
+static uint16_t next_frequency(auto_tune_chip_t* state, uint64_t energy, int fault) {
+    int32_t freq = state->freq_mhz;
+    int32_t step = AUTO_TUNE_FREQ_STEP_MHZ;
+
+    if (fault) {
+        /* Отказ: вниз и не возвращаться на эту частоту hold окон */
+        state->freq_limit = state->freq_mhz;
+        state->hold = AUTO_TUNE_HOLD_WINDOWS;
+        state->direction = -1;
+        state->last_energy = 0;
+    } else {
+        if (state->last_energy == 0 || energy == 0) {
+            /* Нет базы сравнения: окно на этой частоте становится базой */
+            step = 0;
+        } else {
+            /* Сколько верных nonce дала бы прошлая эффективность на этой энергии */
+            uint64_t expected = state->last_good * energy / state->last_energy;
+            uint64_t sigma2 = 2 * isqrt64(expected);
+            int worse = state->good + sigma2 < expected;
+            int better = state->good > expected + sigma2;
+
+            if (state->direction > 0) {
+                state->direction = worse ? -1 : 1;
+            } else {
+                state->direction = better ? -1 : 1;
+            }
+        }
+        state->last_good = state->good;
+        state->last_energy = energy;
+        if (state->hold > 0) {
+            state->hold--;
+        }
+    }
+
+    int32_t limit = AUTO_TUNE_FREQ_MAX_MHZ;
+    if (state->hold > 0 && state->freq_limit - AUTO_TUNE_FREQ_STEP_MHZ < limit) {
+        limit = state->freq_limit - AUTO_TUNE_FREQ_STEP_MHZ;
+    }
+
+    freq += state->direction * step;
+    if (freq > limit) {
+        freq = limit;
+        state->direction = -1;
+    }
+    if (freq < AUTO_TUNE_FREQ_MIN_MHZ) {
+        freq = AUTO_TUNE_FREQ_MIN_MHZ;
+        state->direction = 1;
+    }
+    return (uint16_t)freq;
+}
+
+int auto_tune_step(auto_tune_ctx_t* ctx, uint32_t now_ms, uint32_t board_power_mw) {
+    if (!ctx) return 0;
+
+    uint32_t elapsed_ms = now_ms - ctx->window_start_ms;
+    if (elapsed_ms < AUTO_TUNE_INTERVAL_MS) return 0;
+
+    uint64_t total_good = 0;
+    uint64_t total_freq = 0;
+    for (int chip = 0; chip < A1126_CHIP_COUNT; chip++) {
+        total_good += ctx->chips[chip].good;
+        total_freq += ctx->chips[chip].freq_mhz;
+    }
+
+    /* Мало nonce - решения тонут в шуме, окно продолжается */
+    if (total_good < (uint64_t)AUTO_TUNE_MIN_NONCES * A1126_CHIP_COUNT) return 0;
+
+    int changed = 0;
+    uint32_t freq_sum = 0;
+    uint16_t freq_min = 0xFFFF;
+    uint16_t freq_max = 0;
+    uint16_t throttled = 0;
+
+    for (int chip = 0; chip < A1126_CHIP_COUNT; chip++) {
+        auto_tune_chip_t* state = &ctx->chips[chip];
+
+        /* Энергия чипа: доля мощности платы (мДж) или МГц × мс */
+        uint64_t energy = board_power_mw > 0
+            ? (uint64_t)board_power_mw * state->freq_mhz * elapsed_ms / (total_freq * 1000)
+            : (uint64_t)state->freq_mhz * elapsed_ms;
+
+        a1126_chip_status_t status;
+        int hot = 0;
+        int fault = a1126_get_chip_status((uint8_t)chip, &status) != 0;
+        if (!fault) {
+            hot = status.temperature >= AUTO_TUNE_TEMP_CEILING;
+            fault = hot || status.status != 0;
+        }
+        uint64_t checked = (uint64_t)state->good + state->bad;
+        if ((uint64_t)state->bad * 1000 > checked * AUTO_TUNE_ERROR_PERMILLE) {
+            fault = 1;
+        }
+
+        uint16_t freq = next_frequency(state, energy, fault);
+        state->throttled = (uint8_t)hot;
+        if (freq != state->freq_mhz) {
+            state->freq_mhz = freq;
+            a1126_set_chip_frequency((uint8_t)chip, freq);
+            changed++;
+        }
+
+        freq_sum += freq;
+        if (freq < freq_min) freq_min = freq;
+        if (freq > freq_max) freq_max = freq;
+        throttled = (uint16_t)(throttled + hot);
+    }
+
+    ctx->metrics.freq_avg_mhz = (uint16_t)(freq_sum / A1126_CHIP_COUNT);
+    ctx->metrics.freq_min_mhz = freq_min;
+    ctx->metrics.freq_max_mhz = freq_max;
+    ctx->metrics.throttled_chips = throttled;
+
+    /* Хешей на nonce сложности D - D × 2^32, то есть D × 4.295 GH */
+    uint64_t energy_mj = (uint64_t)board_power_mw * elapsed_ms / 1000;
+    ctx->metrics.efficiency_ghj = energy_mj > 0
+        ? (uint32_t)(total_good * ctx->difficulty * 4295 / energy_mj)
+        : 0;
+
+    start_window(ctx, now_ms, 0);
+    return changed;
+}
@@ -0,0 +1,29 @@
+/**
+ * @file events.c
+ * @brief Реализация очереди событий главного цикла
+ */
+
+#include "events.h"
+
+/* Необработанные события: прерывания делают OR, главный цикл - exchange */
+static volatile uint32_t g_pending = 0;
+
+void event_post(uint32_t events) {
+    __atomic_fetch_or(&g_pending, events, __ATOMIC_RELEASE);
+    /* TODO: SEV, если ядро спит в WFE */
+}
+
+uint32_t event_wait(void) {
+    for (;;) {
+        uint32_t events = __atomic_exchange_n(&g_pending, 0, __ATOMIC_ACQUIRE);
+        if (events != 0) {
+            return events;
+        }
+        /* TODO: WFI до прерывания (тик таймера будит не реже EVENT_TICK_MS) */
+    }
+}
+
+void event_tick_irq_handler(void) {
+    /* TODO: Сбросить флаг прерывания таймера */
+    event_post(EVENT_TIMER);
+}
@@ -0,0 +1,92 @@
+/**
+ * @file extranonce_lease.c
+ * @brief Реализация перебора extranonce на контроллере
+ */
+
+#include "extranonce_lease.h"
+#include "sha256.h"
+
+#include <string.h>
+
+/**
+ * @brief Записать uint32 little-endian
+ */
+static void write_le32(uint8_t* p, uint32_t value) {
+    p[0] = (uint8_t)(value & 0xFF);
+    p[1] = (uint8_t)((value >> 8) & 0xFF);
+    p[2] = (uint8_t)((value >> 16) & 0xFF);
+    p[3] = (uint8_t)((value >> 24) & 0xFF);
+}
+
+void extranonce_lease_start(extranonce_lease_ctx_t* ctx, const quaxis_lease_t* lease) {
+    if (!ctx || !lease) return;
+    
+    memcpy(&ctx->lease, lease, sizeof(quaxis_lease_t));
+    ctx->current_offset = 0;
+    ctx->next_offset = 0;
+    ctx->active = 1;
+}
+
+int extranonce_lease_build_job(const quaxis_lease_t* lease, uint32_t offset, quaxis_job_t* job) {
+    if (!lease || !job || offset >= lease->extranonce_count) return -1;
+    
+    /* extranonce начала диапазона - первые 6 байт хвоста coinbase */
+    uint8_t tail[COINBASE_TAIL_SIZE];
+    memcpy(tail, lease->coinbase_tail, sizeof(tail));
+    
+    uint64_t extranonce = 0;
+    for (int i = 0; i < EXTRANONCE_SIZE; i++) {
+        extranonce |= (uint64_t)tail[i] << (i * 8);
+    }
+    extranonce += offset;
+    for (int i = 0; i < EXTRANONCE_SIZE; i++) {
+        tail[i] = (uint8_t)((extranonce >> (i * 8)) & 0xFF);
+    }
+    
+    /* txid = SHA256d(coinbase), первые 64 байта уже в coinbase_midstate */
+    sha256_ctx_t ctx;
+    uint8_t first_hash[32];
+    uint8_t merkle_root[32];
+    sha256_init_midstate(&ctx, lease->coinbase_midstate, 64);
+    sha256_update(&ctx, tail, sizeof(tail));
+    sha256_final(&ctx, first_hash);
+    sha256(first_hash, 32, merkle_root);
+    
+    /* Первые 64 байта заголовка: version + prev_block + merkle_root[0:28] */
+    uint8_t block[64];
+    write_le32(block, lease->version);
+    memcpy(block + 4, lease->prev_block, 32);
+    memcpy(block + 36, merkle_root, 28);
+    
+    sha256_init(&ctx);
+    sha256_transform(ctx.state, block);
+    for (int i = 0; i < 8; i++) {
+        write_le32(job->midstate + i * 4, ctx.state[i]);
+    }
+    
+    memcpy(job->merkle_tail, merkle_root + 28, 4);
+    job->timestamp = lease->timestamp;
+    job->bits = lease->bits;
+    job->nonce_start = 0;
+    job->job_id = lease->job_id;
+    job->version_count = 0;
+    
+    return 0;
+}
+
+int extranonce_lease_next_job(extranonce_lease_ctx_t* ctx, quaxis_job_t* job) {
+    if (!ctx || !ctx->active) return 1;
+    
+    if (ctx->next_offset >= ctx->lease.extranonce_count) {
+        ctx->active = 0;
+        return 1;
+    }
+    
+    if (extranonce_lease_build_job(&ctx->lease, ctx->next_offset, job) != 0) {
+        ctx->active = 0;
+        return 1;
+    }
+    
+    ctx->current_offset = ctx->next_offset++;
+    return 0;
+}
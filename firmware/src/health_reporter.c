@@ -8,6 +8,8 @@
 
 #include <string.h>
 
+_Static_assert(sizeof(health_report_t) == HEALTH_MESSAGE_SIZE, "health_report_t size");
+
 /**
  * @brief Инициализировать health reporter
  */
@@ -173,6 +175,19 @@ void health_reporter_update_power(
     ctx->power.power_mw = (uint32_t)(voltage_v * current_a * 1000.0f);
 }
 
+/**
+ * @brief Обновить итоги автонастройки частоты
+ */
+void health_reporter_update_tuning(
+    health_reporter_ctx_t* ctx,
+    const tuning_metrics_t* tuning
+) {
+    if (!ctx || !tuning) return;
+    
+    ctx->tuning = *tuning;
+    ctx->has_tuning = 1;
+}
+
 /**
  * @brief Обновить статус чипа
  */
@@ -230,12 +245,13 @@ void health_reporter_build_report(
     
     report->message_type = 0x83;  /* MSG_HEALTH_REPORT */
     report->overall_status = ctx->overall_status;
-    report->flags = 0x1F;  /* Все метрики включены */
+    report->flags = ctx->has_tuning ? 0x3F : 0x1F;  /* Базовые метрики и автонастройка */
     
     report->temperature = ctx->temp;
     report->hashrate = ctx->hashrate;
     report->errors = ctx->errors;
     report->power = ctx->power;
+    report->tuning = ctx->tuning;
     
     report->active_chips = ctx->active_chips;
     report->total_chips = ctx->total_chips;
@@ -0,0 +1,44 @@
+/**
+ * @file job_queue.c
+ * @brief Реализация очереди заданий ASIC
+ */
+
+#include "job_queue.h"
+#include "config.h"
+
+#include <string.h>
+
+/* Кольцевой буфер payload заданий */
+static uint8_t g_queue[JOB_QUEUE_SIZE][JOB_MESSAGE_SIZE];
+static uint32_t g_head = 0;
+static uint32_t g_count = 0;
+
+void job_queue_clear(void) {
+    g_head = 0;
+    g_count = 0;
+}
+
+int job_queue_push(const uint8_t* payload) {
+    if (!payload || g_count >= JOB_QUEUE_SIZE) {
+        return -1;
+    }
+    
+    memcpy(g_queue[(g_head + g_count) % JOB_QUEUE_SIZE], payload, JOB_MESSAGE_SIZE);
+    g_count++;
+    return 0;
+}
+
+int job_queue_pop(quaxis_job_t* job) {
+    if (!job || g_count == 0) {
+        return 0;
+    }
+    
+    int parsed = quaxis_parse_job(g_queue[g_head], job);
+    g_head = (g_head + 1) % JOB_QUEUE_SIZE;
+    g_count--;
+    return parsed == 0 ? 1 : 0;
+}
+
+uint32_t job_queue_count(void) {
+    return g_count;
+}
@@ -10,13 +10,21 @@
  *    - Загрузка в чипы
  *    - Опрос результатов
  *    - Отправка shares
+ *    - При аренде extranonce: следующий extranonce после 2^32 nonce
  */
 
 #include "config.h"
 #include "protocol.h"
 #include "sha256.h"
 #include "a1126_driver.h"
+#include "auto_tune.h"
+#include "health_reporter.h"
+#include "extranonce_lease.h"
+#include "job_queue.h"
+#include "telemetry.h"
+#include "version_rolling.h"
 #include "network.h"
+#include "events.h"
 #include "spi.h"
 
 #include <stdio.h>
@@ -25,14 +33,39 @@
 
 /* Глобальные переменные */
 static quaxis_job_t g_current_job;
+static extranonce_lease_ctx_t g_lease;
+static version_roll_ctx_t g_roll;
+#if AUTO_TUNE_ENABLE
+static auto_tune_ctx_t g_tune;
+#endif
 static uint8_t g_target[32];
 static volatile int g_running = 1;
 static uint64_t g_shares_found = 0;
 static uint64_t g_shares_sent = 0;
+static health_reporter_ctx_t g_health;
+#if TELEMETRY_ENABLE
+static telemetry_ctx_t g_telemetry;
+static uint32_t g_last_telemetry_time = 0;
+#endif
 
 /* Статистика */
 static uint32_t g_last_log_time = 0;
 
+#if VERIFY_NONCES
+/* Заголовки текущего задания по слотам версий: проверке nonce остаётся его часть */
+static sha256_header_t g_job_headers[VERSION_SLOTS_MAX];
+#endif
+
+/* Текущее задание - аренда extranonce (её можно продолжить по анонсу блока) */
+static uint8_t g_lease_mode = 0;
+#if MCAST_ENABLE
+/* Работа из анонса блока ждёт CMD_NEW_JOB_LEASE: job_id ещё неизвестен */
+static uint8_t g_unconfirmed = 0;
+static quaxis_lease_t g_unconfirmed_lease;
+static quaxis_share_t g_unconfirmed_shares[MCAST_SHARES_MAX];
+static uint8_t g_unconfirmed_count = 0;
+#endif
+
 /**
  * @brief Получить текущее время в миллисекундах
  * 
@@ -44,6 +77,16 @@ static uint32_t get_time_ms(void) {
     return time++;
 }
 
+/**
+ * @brief Получить текущее время в микросекундах (с переполнением)
+ * 
+ * @note Заглушка - нужна реализация для конкретной платформы
+ */
+static uint32_t get_time_us(void) {
+    /* TODO: Реализовать для конкретной платформы (таймер с шагом 1 мкс) */
+    return get_time_ms() * 1000;
+}
+
 /**
  * @brief Задержка в миллисекундах
  */
@@ -71,15 +114,29 @@ static void log_stats(void) {
     uint32_t hashrate = a1126_get_hashrate();
     uint8_t temp = a1126_get_temperature();
     
-    printf("[STATS] Hashrate: %u H/s, Temp: %u°C, Shares: %llu/%llu\n",
+    printf("[STATS] Hashrate: %u H/s, Temp: %u°C, Shares: %llu/%llu, HW errors: %llu\n",
            hashrate, temp, 
            (unsigned long long)g_shares_found,
-           (unsigned long long)g_shares_sent);
+           (unsigned long long)g_shares_sent,
+           (unsigned long long)g_health.errors.hw_errors);
+#if AUTO_TUNE_ENABLE
+    const tuning_metrics_t* tuning = auto_tune_metrics(&g_tune);
+    printf("[TUNE] Частота: %u МГц (%u-%u), у потолка температуры: %u\n",
+           tuning->freq_avg_mhz, tuning->freq_min_mhz, tuning->freq_max_mhz,
+           tuning->throttled_chips);
+#endif
+    const net_tx_stats_t* tx = net_tx_stats();
+    printf("[NET] Кадров: %u, сегментов: %u, байт: %u\n",
+           tx->frames, tx->segments, tx->bytes);
 #endif
 }
 
 /**
  * @brief Инициализация оборудования
+ * 
+ * Самодиагностика чипов только начинается: её проходы идут по DMA,
+ * пока контроллер подключается к серверу, а заканчивает их главный
+ * цикл (check_self_test).
  */
 static int init_hardware(void) {
     log_message("Инициализация SPI...");
@@ -95,17 +152,35 @@ static int init_hardware(void) {
     }
     
     log_message("Самодиагностика чипов...");
-    int working_chips = a1126_self_test();
-    if (working_chips <= 0) {
-        log_message("Не найдено рабочих чипов");
+    if (a1126_self_test_poll(get_time_ms()) < 0) {
+        log_message("Ошибка самодиагностики чипов");
         return -1;
     }
     
-    printf("[INFO] Обнаружено %d рабочих чипов\n", working_chips);
-    
     return 0;
 }
 
+/**
+ * @brief Продолжить самодиагностику чипов
+ * 
+ * Проверенные чипы подключаются к текущему заданию сами
+ * (a1126_self_test_poll); без рабочих чипов прошивка останавливается.
+ */
+static void check_self_test(uint32_t now) {
+    if (a1126_self_test_done()) return;
+    
+    a1126_self_test_poll(now);
+    if (!a1126_self_test_done()) return;
+    
+    int working_chips = a1126_working_chips();
+    if (working_chips <= 0) {
+        log_message("Не найдено рабочих чипов");
+        g_running = 0;
+        return;
+    }
+    printf("[INFO] Обнаружено %d рабочих чипов\n", working_chips);
+}
+
 /**
  * @brief Инициализация сети
  */
@@ -122,35 +197,130 @@ static int init_network(const char* server_ip, uint16_t port) {
         return -1;
     }
     
+#if MCAST_ENABLE
+    /* Без анонсов новый блок придёт по TCP: ошибка не фатальна */
+    if (net_mcast_join(server_ip, MCAST_GROUP, MCAST_PORT) != 0) {
+        log_message("Анонсы блоков недоступны");
+    }
+#endif
+    
     log_message("Подключено к серверу");
+#if TELEMETRY_ENABLE
+    telemetry_reset(&g_telemetry);
+#endif
     return 0;
 }
 
+static void process_results(void);
+
+#if VERIFY_NONCES
+/**
+ * @brief Подготовить проверку nonce задания: раунды и расписание без nonce
+ */
+static void prepare_job_headers(const quaxis_job_t* job) {
+    /* Хвост заголовка без nonce: merkle_root[28:32] + time + bits */
+    uint8_t tail[12];
+    uint32_t words[2] = {job->timestamp, job->bits};
+    memcpy(tail, job->merkle_tail, 4);
+    for (int i = 0; i < 2; i++) {
+        tail[4 + i * 4] = (uint8_t)(words[i] & 0xFF);
+        tail[5 + i * 4] = (uint8_t)((words[i] >> 8) & 0xFF);
+        tail[6 + i * 4] = (uint8_t)((words[i] >> 16) & 0xFF);
+        tail[7 + i * 4] = (uint8_t)((words[i] >> 24) & 0xFF);
+    }
+    
+    if (job->version_count > 1) {
+        for (uint8_t s = 0; s < job->version_count && s < VERSION_SLOTS_MAX; s++) {
+            sha256_header_prepare(&g_job_headers[s], job->version_midstates[s], tail);
+        }
+    } else {
+        sha256_header_prepare(&g_job_headers[0], job->midstate, tail);
+    }
+}
+#endif
+
 /**
  * @brief Обработать полученное задание
+ * 
+ * @return 0 если чипы перебирают задание, -1 при ошибке загрузки
  */
-static void process_job(const quaxis_job_t* job) {
+static int process_job(const quaxis_job_t* job) {
+#if A1126_DOUBLE_BUFFER
+    /* Чипы перебирали старое задание до последнего: его nonce - до смены */
+    process_results();
+#endif
+    
     /* Сохраняем текущее задание */
     memcpy(&g_current_job, job, sizeof(quaxis_job_t));
-    
+
+#if VERIFY_NONCES
+    prepare_job_headers(job);
+#endif
+
 #if ENABLE_DEBUG_LOG
-    printf("[JOB] ID: %u, timestamp: %u, bits: 0x%08X\n",
-           job->job_id, job->timestamp, job->bits);
+    printf("[JOB] ID: %u, timestamp: %u, bits: 0x%08X, versions: %u\n",
+           job->job_id, job->timestamp, job->bits, job->version_count);
 #endif
     
+#if A1126_DOUBLE_BUFFER
+    /* Загружаем в теневой банк, пока чипы хешируют; swap без простоя */
+    if (a1126_load_job(job) != 0) {
+        log_message("Ошибка загрузки задания в чипы");
+        return -1;
+    }
+    
+    a1126_swap();
+#else
     /* Останавливаем текущий майнинг */
     a1126_stop();
     
     /* Загружаем новое задание в чипы */
     if (a1126_load_job(job) != 0) {
         log_message("Ошибка загрузки задания в чипы");
-        return;
+        return -1;
     }
     
     /* Запускаем майнинг */
     a1126_start();
+#endif
+    return 0;
 }
 
+/**
+ * @brief Загрузить задание, присланное сервером, и подтвердить загрузку
+ * 
+ * @param received_us Когда пришёл кадр задания (get_time_us)
+ */
+static void load_server_job(const quaxis_job_t* job, uint32_t received_us) {
+#if JOB_LOADED_ENABLE
+    if (process_job(job) == 0) {
+        /* Сервер меряет по нему переход на задание; ошибку отправки увидит приём */
+        net_send_job_loaded(job->job_id, received_us, get_time_us());
+    }
+#else
+    (void)received_us;
+    process_job(job);
+#endif
+}
+
+#if VERIFY_NONCES
+/**
+ * @brief Проверить nonce чипа: SHA256d заголовка задания под target
+ * 
+ * @return 1 если хеш подходит, 0 если это ошибка чипа
+ */
+static int result_meets_target(const a1126_result_t* result) {
+    const sha256_header_t* header = g_current_job.version_count > 1 &&
+                                    result->version_slot < VERSION_SLOTS_MAX
+        ? &g_job_headers[result->version_slot]
+        : &g_job_headers[0];
+    
+    uint8_t hash[32];
+    sha256_header_hash(header, result->nonce, hash);
+    return sha256_check_target(hash, g_target);
+}
+#endif
+
 /**
  * @brief Обработать результат от чипа
  */
@@ -159,6 +329,22 @@ static void process_result(const a1126_result_t* result) {
         return;
     }
     
+#if VERIFY_NONCES
+    /* Неверный nonce - HW ошибка чипа: на сервер не уходит, серверу не нужен SHA256 */
+    int good = result_meets_target(result);
+#else
+    int good = 1;  /* Без проверки верным считается каждый nonce чипа */
+#endif
+    a1126_record_nonce(result->chip_id, good);
+#if AUTO_TUNE_ENABLE
+    auto_tune_record_nonce(&g_tune, result->chip_id, good);
+#endif
+    if (!good) {
+        health_reporter_record_error(&g_health, 1, 0, 0);
+        return;
+    }
+    health_reporter_record_share(&g_health);
+    
     g_shares_found++;
     
 #if ENABLE_DEBUG_LOG
@@ -170,61 +356,407 @@ static void process_result(const a1126_result_t* result) {
     quaxis_share_t share;
     share.job_id = g_current_job.job_id;
     share.nonce = result->nonce;
+    share.version_slot = result->version_slot;
+    share.extranonce_offset = extranonce_lease_offset(&g_lease);
+    share.version = version_roll_version(&g_roll);
+    
+#if MCAST_ENABLE
+    /* Работа из анонса: share уйдёт, когда TCP задание даст job_id */
+    if (g_unconfirmed) {
+        if (g_unconfirmed_count < MCAST_SHARES_MAX) {
+            g_unconfirmed_shares[g_unconfirmed_count++] = share;
+        }
+        return;
+    }
+#endif
     
-    /* Отправляем на сервер */
-    if (net_send_share(&share) == 0) {
+    /* Отправляем на сервер (или в пакет RSP_SHARE_BATCH) */
+    if (net_queue_share(&share, get_time_ms()) == 0) {
         g_shares_sent++;
     } else {
         log_message("Ошибка отправки share");
     }
 }
 
+/**
+ * @brief Собрать nonce всех чипов одним проходом и обработать пачками
+ */
+static void process_results(void) {
+    a1126_result_t results[A1126_RESULT_BATCH];
+    int count;
+    
+    a1126_collect_results();
+    while ((count = a1126_poll_results(results, A1126_RESULT_BATCH)) > 0) {
+        for (int i = 0; i < count; i++) {
+            process_result(&results[i]);
+        }
+    }
+}
+
+#if MCAST_ENABLE
+/**
+ * @brief Сбросить работу из анонса, не подтверждённую сервером
+ */
+static void drop_unconfirmed(void) {
+    g_unconfirmed = 0;
+    g_unconfirmed_count = 0;
+}
+
+/**
+ * @brief Задание с арендой - та же работа, что построена из анонса
+ */
+static int lease_confirms(const quaxis_lease_t* lease) {
+    return lease->version == g_unconfirmed_lease.version &&
+           lease->timestamp == g_unconfirmed_lease.timestamp &&
+           lease->bits == g_unconfirmed_lease.bits &&
+           memcmp(lease->prev_block, g_unconfirmed_lease.prev_block, 32) == 0 &&
+           memcmp(lease->coinbase_midstate, g_unconfirmed_lease.coinbase_midstate, 32) == 0 &&
+           memcmp(lease->coinbase_tail, g_unconfirmed_lease.coinbase_tail,
+                  COINBASE_TAIL_SIZE) == 0;
+}
+
+/**
+ * @brief Подтвердить работу из анонса: job_id от сервера, отложенные shares
+ */
+static void confirm_unconfirmed(const quaxis_lease_t* lease) {
+    g_lease.lease.job_id = lease->job_id;
+    g_lease.lease.extranonce_count = lease->extranonce_count;
+    g_current_job.job_id = lease->job_id;
+    
+    uint8_t held = g_unconfirmed_count;
+    drop_unconfirmed();
+    for (uint8_t i = 0; i < held; i++) {
+        g_unconfirmed_shares[i].job_id = lease->job_id;
+        if (net_queue_share(&g_unconfirmed_shares[i], get_time_ms()) == 0) {
+            g_shares_sent++;
+        }
+    }
+}
+
+/**
+ * @brief Анонс нового блока по multicast
+ * 
+ * Прежняя работа устарела. В режиме аренды контроллер сам строит работу
+ * нового блока: диапазон extranonce остаётся прежним, coinbase - из
+ * анонса. Иначе чипы останавливаются до задания по TCP.
+ */
+static void handle_block_notify(const quaxis_block_notify_t* notify) {
+    quaxis_job_t new_job;
+    
+    net_flush_shares();
+    version_roll_stop(&g_roll);
+    job_queue_clear();
+    drop_unconfirmed();
+    
+    if ((notify->flags & BLOCK_NOTIFY_FLAG_WORK) && g_lease_mode &&
+        g_lease.lease.extranonce_count >= 2) {
+        quaxis_lease_t lease = g_lease.lease;
+        lease.job_id = 0;
+        lease.version = notify->version;
+        memcpy(lease.prev_block, notify->prev_block, 32);
+        memcpy(lease.coinbase_midstate, notify->coinbase_midstate, 32);
+        /* Первые байты хвоста - начало нашего диапазона extranonce */
+        memcpy(lease.coinbase_tail + EXTRANONCE_SIZE, notify->coinbase_tail + EXTRANONCE_SIZE,
+               COINBASE_TAIL_SIZE - EXTRANONCE_SIZE);
+        lease.timestamp = notify->timestamp;
+        lease.bits = notify->bits;
+        
+        extranonce_lease_start(&g_lease, &lease);
+        if (extranonce_lease_next_job(&g_lease, &new_job) == 0) {
+            g_unconfirmed_lease = lease;
+            g_unconfirmed = 1;
+            process_job(&new_job);
+            return;
+        }
+    }
+    
+    /* Работы в анонсе нет: только перестаём искать shares старого блока */
+    extranonce_lease_stop(&g_lease);
+    g_lease_mode = 0;
+    a1126_stop();
+}
+#endif
+
+/**
+ * @brief Забрать всё, что прислал сервер, и сразу загрузить новое задание
+ */
+static void handle_network(void) {
+    quaxis_job_t new_job;
+    quaxis_lease_t new_lease;
+    quaxis_roll_t new_roll;
+    
+    do {
+        uint32_t received_us = get_time_us();
+
+#if MCAST_ENABLE
+        quaxis_block_notify_t notify;
+        if (net_take_block_notify(&notify)) {
+            handle_block_notify(&notify);
+        }
+#endif
+        
+        int job_result = net_recv_job(&new_job, 0);  /* Без ожидания: данные уже пришли */
+        if (job_result > 0) {
+            /* Shares старого задания уходят до переключения */
+            net_flush_shares();
+            extranonce_lease_stop(&g_lease);
+            version_roll_stop(&g_roll);
+#if MCAST_ENABLE
+            drop_unconfirmed();
+#endif
+            g_lease_mode = 0;
+            load_server_job(&new_job, received_us);
+        } else if (job_result < 0) {
+            log_message("Ошибка получения задания");
+        }
+        
+        /* Задание с арендой extranonce: начинаем с начала диапазона */
+        int lease_result = net_take_lease(&new_lease);
+#if MCAST_ENABLE
+        /* Чипы уже перебирают эту работу: чипы не перезагружаем */
+        if (lease_result && g_unconfirmed && lease_confirms(&new_lease)) {
+            confirm_unconfirmed(&new_lease);
+            lease_result = 0;
+        } else if (lease_result) {
+            drop_unconfirmed();
+        }
+#endif
+        if (lease_result) {
+            net_flush_shares();
+            version_roll_stop(&g_roll);
+            g_lease_mode = 1;
+            extranonce_lease_start(&g_lease, &new_lease);
+            if (extranonce_lease_next_job(&g_lease, &new_job) == 0) {
+                load_server_job(&new_job, received_us);
+            }
+        }
+        
+        /* Задание с перебором версий: начинаем с версии сервера */
+        if (net_take_roll(&new_roll)) {
+            net_flush_shares();
+            extranonce_lease_stop(&g_lease);
+#if MCAST_ENABLE
+            drop_unconfirmed();
+#endif
+            g_lease_mode = 0;
+            version_roll_start(&g_roll, &new_roll);
+            if (version_roll_next_job(&g_roll, &new_job) == 0) {
+                load_server_job(&new_job, received_us);
+            }
+        }
+        
+        /* Новый timestamp: midstate прежний, чипы перебирают nonce заново */
+        quaxis_time_update_t time_update;
+        if (net_take_time_update(&time_update)) {
+            /* Следующие задания аренды и перебора версий - с новым timestamp */
+            if (g_lease.active && g_lease.lease.job_id == time_update.job_id) {
+                g_lease.lease.timestamp = time_update.timestamp;
+            }
+            if (g_roll.active && g_roll.roll.job_id == time_update.job_id) {
+                g_roll.roll.timestamp = time_update.timestamp;
+            }
+            new_job = g_current_job;
+            if (quaxis_apply_update_time(&new_job, &time_update) == 0) {
+                net_flush_shares();
+                process_job(&new_job);
+            }
+        }
+        
+        /* Vardiff: сервер прислал новую сложность shares */
+        uint32_t difficulty;
+        if (net_take_difficulty(&difficulty)) {
+            quaxis_difficulty_to_target(difficulty, g_target);
+            a1126_set_target(g_target);
+#if AUTO_TUNE_ENABLE
+            auto_tune_set_difficulty(&g_tune, difficulty, get_time_ms());
+#endif
+        }
+    } while (net_rx_pending());
+}
+
+/**
+ * @brief Чипы прошли 2^32 nonce: следующее задание без запроса к серверу
+ */
+static void advance_work(void) {
+    quaxis_job_t new_job;
+    
+    if (!g_lease.active && !g_roll.active && job_queue_count() == 0) {
+        return;  /* Ждём сервер - шину не опрашиваем */
+    }
+    if (!a1126_work_done()) {
+        return;
+    }
+    
+    net_flush_shares();
+    if (g_lease.active) {
+        /* Следующий extranonce аренды */
+        if (extranonce_lease_next_job(&g_lease, &new_job) == 0) {
+            process_job(&new_job);
+        }
+    } else if (g_roll.active) {
+        /* Следующая версия под маской: midstate считает контроллер */
+        if (version_roll_next_job(&g_roll, &new_job) == 0) {
+            process_job(&new_job);
+        }
+    } else if (job_queue_pop(&new_job)) {
+        /* Следующее задание из очереди (CMD_QUEUE_JOB): timestamp + 1 */
+        process_job(&new_job);
+    }
+}
+
+#if TELEMETRY_ENABLE
+/**
+ * @brief Отправить изменения телеметрии чипов (RSP_TELEMETRY)
+ */
+static void send_telemetry(void) {
+    static telemetry_chip_t chips[A1126_CHIP_COUNT];
+    static a1126_chip_status_t statuses[A1126_CHIP_COUNT];
+    
+    a1126_get_chips_status(statuses);
+    for (int chip = 0; chip < A1126_CHIP_COUNT; chip++) {
+        const a1126_chip_status_t* status = &statuses[chip];
+        chips[chip].temperature = status->temperature;
+        chips[chip].status = status->status;
+        chips[chip].frequency_mhz = status->frequency_mhz;
+        chips[chip].hw_errors = status->error_count;
+        chips[chip].good_nonces = status->good_count;
+    }
+    
+    /* Кадр строится прямо в сегменте TX; пустая дельта не добавляется */
+    uint8_t* frame = net_tx_reserve(TELEMETRY_HEADER_SIZE + TELEMETRY_PAYLOAD_MAX);
+    if (frame) {
+        net_tx_commit(telemetry_build_frame(&g_telemetry, chips, frame));
+    }
+}
+#endif
+
+/**
+ * @brief Работа по срокам: пакет shares, автонастройка, heartbeat, телеметрия, статистика
+ */
+static void handle_timers(uint32_t now, uint32_t* last_heartbeat) {
+    /* Неполный пакет shares по таймауту */
+    net_poll_shares(now);
+    
+#if AUTO_TUNE_ENABLE
+    /* Частоты чипов по итогам окна измерения (датчика мощности нет) */
+    if (auto_tune_step(&g_tune, now, 0) > 0) {
+        health_reporter_update_tuning(&g_health, auto_tune_metrics(&g_tune));
+    }
+#endif
+    
+    /* Heartbeat (не нужен, если уходили shares или статус) */
+    if (now - *last_heartbeat >= HEARTBEAT_INTERVAL_MS) {
+        net_keepalive();
+        *last_heartbeat = now;
+    }
+    
+#if TELEMETRY_ENABLE
+    if (now - g_last_telemetry_time >= TELEMETRY_INTERVAL_MS) {
+        send_telemetry();
+        g_last_telemetry_time = now;
+    }
+#endif
+    
+    /* Периодический вывод статистики */
+    if (now - g_last_log_time >= LOG_INTERVAL_MS) {
+        log_stats();
+        g_last_log_time = now;
+    }
+}
+
 /**
  * @brief Главный цикл майнинга
+ * 
+ * Цикл спит до события (events.h): задание от сервера загружается в
+ * чипы сразу по прерыванию приёма, nonce забираются по линии "nonce
+ * готов" и по завершении очереди DMA. Конец работы чипов (и nonce без
+ * A1126_RESULT_IRQ) опрашивается раз в RESULT_POLL_MS по тику таймера.
  */
 static void mining_loop(void) {
-    a1126_result_t result;
-    quaxis_job_t new_job;
     uint32_t last_heartbeat = 0;
+    uint32_t last_poll = 0;
+    uint32_t lost_at = 0;           /* Начало обрыва при живой сессии */
+    uint32_t last_reconnect = 0;
     
     while (g_running) {
         /* Проверяем состояние сети */
         if (net_get_state() != NET_STATE_CONNECTED) {
-            log_message("Соединение потеряно, переподключаемся...");
-            a1126_stop();
-            
-            delay_ms(RECONNECT_DELAY_MS);
+            uint32_t now = get_time_ms();
+            if (net_has_session() && lost_at == 0) {
+                /* Сервер держит extranonce: чипы продолжают задание */
+                log_message("Соединение потеряно, задание продолжается до переподключения");
+                lost_at = now;
+                last_reconnect = now;
+            }
+            if (lost_at != 0 && now - lost_at >= SESSION_GRACE_MS) {
+                /* Сессия на сервере уже истекла */
+                net_drop_session();
+                lost_at = 0;
+            }
             
-            if (net_connect(DEFAULT_SERVER_IP, DEFAULT_SERVER_PORT) != 0) {
-                continue;
+            if (lost_at == 0) {
+                log_message("Соединение потеряно, переподключаемся...");
+                a1126_stop();
+                
+                delay_ms(RECONNECT_DELAY_MS);
+                
+                if (net_connect(DEFAULT_SERVER_IP, DEFAULT_SERVER_PORT) != 0) {
+                    continue;
+                }
+#if TELEMETRY_ENABLE
+                telemetry_reset(&g_telemetry);
+#endif
+            } else if (now - last_reconnect >= RECONNECT_DELAY_MS) {
+                last_reconnect = now;
+                if (net_connect(DEFAULT_SERVER_IP, DEFAULT_SERVER_PORT) == 0) {
+                    /* RSP_HELLO - первым кадром, до телеметрии и heartbeat */
+                    if (net_resume_session(g_current_job.job_id) != 0) {
+                        net_disconnect();
+                        continue;
+                    }
+                    lost_at = 0;
+#if TELEMETRY_ENABLE
+                    telemetry_reset(&g_telemetry);
+#endif
+                }
             }
         }
         
-        /* Проверяем новые задания */
-        int job_result = net_recv_job(&new_job, 10);  /* 10ms таймаут */
-        if (job_result > 0) {
-            process_job(&new_job);
-        } else if (job_result < 0) {
-            log_message("Ошибка получения задания");
+        uint32_t events = event_wait();
+        uint32_t now = get_time_ms();
+        
+        /* Новое задание - первым: чипы не должны хешировать старое */
+        if (events & EVENT_NET_RX) {
+            handle_network();
         }
         
-        /* Опрашиваем чипы на наличие результатов */
-        while (a1126_poll_result(&result) > 0) {
-            process_result(&result);
+        /* Конец работы чипов прерывания не даёт - опрос по тику */
+        int poll = (events & EVENT_TIMER) && now - last_poll >= RESULT_POLL_MS;
+        if (poll) {
+            last_poll = now;
         }
         
-        /* Heartbeat */
-        uint32_t now = get_time_ms();
-        if (now - last_heartbeat >= HEARTBEAT_INTERVAL_MS) {
-            net_send_heartbeat();
-            last_heartbeat = now;
+        /* Забираем найденные nonce всех чипов */
+#if A1126_RESULT_IRQ
+        if (events & (EVENT_CHIP_RESULT | EVENT_SPI_DONE)) {
+#else
+        if (poll || (events & EVENT_SPI_DONE)) {
+#endif
+            process_results();
+        }
+        if (poll || (events & EVENT_SPI_DONE)) {
+            advance_work();
+        }
+        if (events & (EVENT_TIMER | EVENT_SPI_DONE)) {
+            check_self_test(now);
         }
         
-        /* Периодический вывод статистики */
-        if (now - g_last_log_time >= LOG_INTERVAL_MS) {
-            log_stats();
-            g_last_log_time = now;
+        if (events & EVENT_TIMER) {
+            handle_timers(now, &last_heartbeat);
         }
+        
+        /* Кадры прохода - одним сегментом (или ждут ACK предыдущего) */
+        net_tx_poll(get_time_us());
     }
 }
 
@@ -253,7 +785,12 @@ int main(void) {
     g_target[31] = 0x00;  /* Минимальная сложность */
     a1126_set_target(g_target);
     
-    /* Подключение к серверу */
+    health_reporter_init(&g_health, A1126_CHIP_COUNT, get_time_ms());
+#if AUTO_TUNE_ENABLE
+    auto_tune_init(&g_tune, get_time_ms());
+#endif
+    
+    /* Подключение к серверу, пока чипы проходят самодиагностику */
     if (init_network(DEFAULT_SERVER_IP, DEFAULT_SERVER_PORT) != 0) {
         printf("[FATAL] Ошибка подключения к серверу\n");
         return 1;
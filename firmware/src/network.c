@@ -6,13 +6,95 @@
  */
 
 #include "network.h"
+#include "job_queue.h"
 #include "config.h"
+#include "events.h"
 
 #include <string.h>
 
 /* Состояние соединения */
 static net_state_t g_state = NET_STATE_DISCONNECTED;
 
+/*
+ * Кольцо отправки: кадры сериализуются прямо в собираемый сегмент,
+ * стек получает сегмент целиком и ссылается на него до ACK
+ */
+static uint8_t g_tx_segments[TX_RING_SEGMENTS][TX_SEGMENT_SIZE];
+static uint16_t g_tx_len[TX_RING_SEGMENTS];
+static uint8_t g_tx_head = 0;               /* Собираемый сегмент */
+static uint8_t g_tx_inflight = 0;           /* Отданы стеку, ACK ещё нет */
+static uint32_t g_tx_first_us = 0;          /* net_tx_poll() впервые увидел кадры сегмента */
+static uint8_t g_tx_timed = 0;
+static uint8_t g_tx_active = 0;             /* Сегменты с прошлого net_keepalive() */
+static net_tx_stats_t g_tx_stats;
+
+/*
+ * Пакетные shares (включаются сервером через CMD_SET_SHARE_BATCH)
+ */
+static uint8_t g_batch_max = 0;             /* 0 = по одному RSP_SHARE */
+static uint16_t g_batch_flush_ms = 0;
+static quaxis_share_t g_batch[SHARE_BATCH_MAX];
+static uint8_t g_batch_count = 0;
+static uint32_t g_batch_started_ms = 0;     /* Время первого share в пакете */
+
+/* Сложность от сервера (vardiff), ещё не применённая к чипам */
+static uint32_t g_pending_difficulty = 0;
+
+/* Задание с арендой extranonce, ещё не загруженное в чипы */
+static quaxis_lease_t g_pending_lease;
+static uint8_t g_has_pending_lease = 0;
+static quaxis_roll_t g_pending_roll;
+static uint8_t g_has_pending_roll = 0;
+
+/* Новый timestamp задания, ещё не загруженный в чипы */
+static quaxis_time_update_t g_pending_time;
+static uint8_t g_has_pending_time = 0;
+
+/* Сессия (CMD_SET_SESSION): 0 - сервер не держит extranonce после обрыва */
+static uint64_t g_session_token = 0;
+static quaxis_share_t g_held_shares[SESSION_SHARES_MAX];
+static uint8_t g_held_count = 0;            /* Shares, найденные без соединения */
+
+/* Анонсы блоков по UDP multicast (CMD_BLOCK_NOTIFY) */
+static char g_mcast_source[16];             /* IP сервера: чужие датаграммы отбрасываются */
+static uint8_t g_mcast_joined = 0;
+static uint32_t g_mcast_generation = 0;     /* Последнее принятое поколение */
+static uint8_t g_mcast_seen = 0;
+
+/**
+ * @brief Накопленный пакет - к shares, ждущим переподключения
+ */
+static void hold_batch(void) {
+    for (uint8_t i = 0; i < g_batch_count && g_held_count < SESSION_SHARES_MAX; i++) {
+        g_held_shares[g_held_count++] = g_batch[i];
+    }
+    g_batch_count = 0;
+}
+
+/**
+ * @brief Начать соединение с пустым кольцом (RSP_HELLO - первым кадром)
+ */
+static void tx_reset(void) {
+    memset(g_tx_len, 0, sizeof(g_tx_len));
+    g_tx_head = 0;
+    g_tx_inflight = 0;
+    g_tx_timed = 0;
+}
+
+/**
+ * @brief Отдать сегмент стеку без копирования
+ * 
+ * @return 0 при успехе, -1 при ошибке
+ */
+static int tx_write_segment(const uint8_t* data, size_t len) {
+    /* TODO: tcp_write() без TCP_WRITE_FLAG_COPY и tcp_output(); sent
+     * callback стека вызывает net_tx_acked() */
+    (void)data;
+    (void)len;
+    net_tx_acked(1);  /* Заглушка: стек подтверждает сразу */
+    return 0;
+}
+
 /* Заглушки для сетевых функций */
 /* TODO: Реализовать для конкретной платформы (lwIP, etc.) */
 
@@ -27,13 +109,27 @@ int net_connect(const char* server_ip, uint16_t port) {
     (void)port;
     
     /* TODO: Реализовать TCP соединение */
+    tx_reset();
     g_state = NET_STATE_CONNECTED;
     return 0;
 }
 
 void net_disconnect(void) {
+    /* Собранные кадры - как данные в сокете перед close() */
+    if (g_state == NET_STATE_CONNECTED) {
+        net_tx_flush();
+    }
+    
     /* TODO: Закрыть соединение */
     g_state = NET_STATE_DISCONNECTED;
+    tx_reset();
+    
+    /* Новый сервер может не поддерживать пакеты: ждём повторного согласования */
+    if (g_session_token != 0) {
+        hold_batch();
+    }
+    g_batch_max = 0;
+    g_batch_count = 0;
 }
 
 net_state_t net_get_state(void) {
@@ -41,13 +137,84 @@ net_state_t net_get_state(void) {
 }
 
 int net_send(const uint8_t* data, size_t len) {
+    uint8_t* frame = net_tx_reserve(len);
+    if (!frame) {
+        return -1;
+    }
+    memcpy(frame, data, len);
+    net_tx_commit(len);
+    return (int)len;
+}
+
+uint8_t* net_tx_reserve(size_t len) {
+    if (g_state != NET_STATE_CONNECTED || len > TX_SEGMENT_SIZE) {
+        return NULL;
+    }
+    if (g_tx_len[g_tx_head] + len > TX_SEGMENT_SIZE) {
+        /* Не помещается: сегмент уходит, кадр начинает следующий */
+        if (net_tx_flush() != 0 || g_tx_len[g_tx_head] != 0) {
+            return NULL;  /* Все сегменты у стека */
+        }
+    }
+    return g_tx_segments[g_tx_head] + g_tx_len[g_tx_head];
+}
+
+void net_tx_commit(size_t len) {
+    if (len == 0) {
+        return;
+    }
+    g_tx_len[g_tx_head] += (uint16_t)len;
+    g_tx_stats.frames++;
+    g_tx_stats.bytes += (uint32_t)len;
+}
+
+int net_tx_poll(uint32_t now_us) {
+    if (g_tx_len[g_tx_head] == 0) {
+        return 0;
+    }
+    if (!g_tx_timed) {
+        g_tx_first_us = now_us;
+        g_tx_timed = 1;
+    }
+    /* Предыдущий сегмент ещё без ACK: ждём попутчиков, но не дольше TX_COALESCE_US */
+    if (g_tx_inflight > 0 && now_us - g_tx_first_us < TX_COALESCE_US) {
+        return 0;
+    }
+    return net_tx_flush();
+}
+
+int net_tx_flush(void) {
+    uint16_t len = g_tx_len[g_tx_head];
+    if (len == 0) {
+        return 0;
+    }
     if (g_state != NET_STATE_CONNECTED) {
         return -1;
     }
+    if (g_tx_inflight >= TX_RING_SEGMENTS - 1) {
+        return 0;  /* Следующий сегмент кольца ещё у стека */
+    }
     
-    /* TODO: Отправить данные через TCP */
-    (void)data;
-    return (int)len;
+    g_tx_inflight++;
+    if (tx_write_segment(g_tx_segments[g_tx_head], len) != 0) {
+        g_tx_inflight--;
+        return -1;
+    }
+    g_tx_stats.segments++;
+    g_tx_active = 1;
+    
+    g_tx_head = (uint8_t)((g_tx_head + 1) % TX_RING_SEGMENTS);
+    g_tx_len[g_tx_head] = 0;
+    g_tx_timed = 0;
+    return 0;
+}
+
+void net_tx_acked(uint8_t segments) {
+    g_tx_inflight = (segments >= g_tx_inflight) ? 0 : (uint8_t)(g_tx_inflight - segments);
+}
+
+const net_tx_stats_t* net_tx_stats(void) {
+    return &g_tx_stats;
 }
 
 int net_recv(uint8_t* buf, size_t max_len, uint32_t timeout_ms) {
@@ -63,22 +230,261 @@ int net_recv(uint8_t* buf, size_t max_len, uint32_t timeout_ms) {
     return 0;  /* Нет данных */
 }
 
+int net_rx_pending(void) {
+    /* TODO: Есть ли непрочитанные данные в буфере TCP */
+    return 0;
+}
+
+void net_rx_irq_handler(void) {
+    /* TODO: Вызывать из прерывания MAC или callback приёма стека */
+    event_post(EVENT_NET_RX);
+}
+
 int net_send_share(const quaxis_share_t* share) {
-    uint8_t buf[9];
-    int len = quaxis_serialize_share(share, buf);
+    /* Наибольший из кадров share */
+    uint8_t* buf = net_tx_reserve(SHARE_LEASED_FRAME_SIZE);
+    if (!buf) return -1;
+    
+    int len;
+    if (share && share->version != 0) {
+        len = quaxis_serialize_share_rolled(share, buf);
+    } else if (share && share->extranonce_offset != 0) {
+        len = quaxis_serialize_share_leased(share, buf);
+    } else if (share && share->version_slot != 0) {
+        len = quaxis_serialize_share_slot(share, buf);
+    } else {
+        len = quaxis_serialize_share(share, buf);
+    }
+    if (len < 0) return -1;
+    
+    net_tx_commit((size_t)len);
+    return len;
+}
+
+void net_set_share_batch(uint8_t max_count, uint16_t flush_ms) {
+    /* Недоотправленный пакет уходит по старым правилам */
+    net_flush_shares();
+    
+    if (max_count > SHARE_BATCH_MAX) {
+        max_count = SHARE_BATCH_MAX;
+    }
+    g_batch_max = (max_count > 1) ? max_count : 0;
+    g_batch_flush_ms = flush_ms;
+}
+
+int net_queue_share(const quaxis_share_t* share, uint32_t now_ms) {
+    if (!share) return -1;
+    
+    /* Обрыв при живой сессии: share уйдёт после RSP_HELLO */
+    if (g_state != NET_STATE_CONNECTED && g_session_token != 0) {
+        if (g_held_count >= SESSION_SHARES_MAX) return -1;
+        g_held_shares[g_held_count++] = *share;
+        return 0;
+    }
+    
+    if (g_batch_max == 0) {
+        return net_send_share(share) > 0 ? 0 : -1;
+    }
+    
+    /* В RSP_SHARE_BATCH нет номера слота, смещения extranonce и версии:
+     * такие shares идут по одному, после уже накопленных */
+    if (share->version_slot != 0 || share->extranonce_offset != 0 || share->version != 0) {
+        if (net_flush_shares() != 0) return -1;
+        return net_send_share(share) > 0 ? 0 : -1;
+    }
+    
+    if (g_batch_count == 0) {
+        g_batch_started_ms = now_ms;
+    }
+    g_batch[g_batch_count++] = *share;
+    
+    if (g_batch_count >= g_batch_max) {
+        return net_flush_shares();
+    }
+    return 0;
+}
+
+int net_flush_shares(void) {
+    if (g_batch_count == 0) {
+        return 0;
+    }
+    if (g_state != NET_STATE_CONNECTED && g_session_token != 0) {
+        hold_batch();
+        return 0;
+    }
+    
+    uint8_t* buf = net_tx_reserve(SHARE_BATCH_FRAME_MAX);
+    if (!buf) {
+        g_batch_count = 0;
+        return -1;
+    }
+    int len = quaxis_serialize_share_batch(g_batch, g_batch_count, buf);
+    g_batch_count = 0;
     if (len < 0) return -1;
     
-    return net_send(buf, (size_t)len);
+    net_tx_commit((size_t)len);
+    return 0;
+}
+
+int net_poll_shares(uint32_t now_ms) {
+    if (g_batch_count > 0 && now_ms - g_batch_started_ms >= g_batch_flush_ms) {
+        return net_flush_shares();
+    }
+    return 0;
+}
+
+int net_take_difficulty(uint32_t* difficulty) {
+    if (!difficulty || g_pending_difficulty == 0) {
+        return 0;
+    }
+    *difficulty = g_pending_difficulty;
+    g_pending_difficulty = 0;
+    return 1;
+}
+
+int net_take_lease(quaxis_lease_t* lease) {
+    if (!lease || !g_has_pending_lease) {
+        return 0;
+    }
+    memcpy(lease, &g_pending_lease, sizeof(quaxis_lease_t));
+    g_has_pending_lease = 0;
+    return 1;
+}
+
+int net_take_roll(quaxis_roll_t* roll) {
+    if (!roll || !g_has_pending_roll) {
+        return 0;
+    }
+    memcpy(roll, &g_pending_roll, sizeof(quaxis_roll_t));
+    g_has_pending_roll = 0;
+    return 1;
+}
+
+int net_take_time_update(quaxis_time_update_t* update) {
+    if (!update || !g_has_pending_time) {
+        return 0;
+    }
+    memcpy(update, &g_pending_time, sizeof(quaxis_time_update_t));
+    g_has_pending_time = 0;
+    return 1;
+}
+
+int net_has_session(void) {
+    return g_session_token != 0;
+}
+
+void net_drop_session(void) {
+    g_session_token = 0;
+    g_held_count = 0;
+}
+
+int net_resume_session(uint32_t job_id) {
+    if (g_session_token == 0) {
+        return 0;
+    }
+    
+    uint8_t* buf = net_tx_reserve(HELLO_FRAME_SIZE);
+    if (!buf) {
+        return -1;
+    }
+    net_tx_commit((size_t)quaxis_serialize_hello(g_session_token, job_id, buf));
+    
+    /* Shares времени обрыва: задания проверяются по job_id, сервер их засчитает */
+    uint8_t held = g_held_count;
+    g_held_count = 0;
+    for (uint8_t i = 0; i < held; i++) {
+        if (net_send_share(&g_held_shares[i]) < 0) {
+            return -1;
+        }
+    }
+    return net_tx_flush();
+}
+
+int net_mcast_join(const char* server_ip, const char* group, uint16_t port) {
+    (void)group;
+    (void)port;
+    
+    if (!server_ip) {
+        return -1;
+    }
+    strncpy(g_mcast_source, server_ip, sizeof(g_mcast_source) - 1);
+    g_mcast_source[sizeof(g_mcast_source) - 1] = '\0';
+    
+    /* TODO: UDP сокет на port, IGMP join группы group */
+    g_mcast_joined = 1;
+    return 0;
+}
+
+/**
+ * @brief Принять датаграмму группы
+ * 
+ * @param source Куда записать IP отправителя
+ * @return Длина датаграммы, 0 если нет данных
+ */
+static int mcast_recv(uint8_t* buf, size_t max_len, char* source, size_t source_len) {
+    /* TODO: recvfrom() без блокировки */
+    (void)buf;
+    (void)max_len;
+    (void)source;
+    (void)source_len;
+    return 0;
+}
+
+int net_take_block_notify(quaxis_block_notify_t* notify) {
+    if (!notify || !g_mcast_joined) {
+        return 0;
+    }
+    
+    uint8_t buf[BLOCK_NOTIFY_SIZE];
+    char source[16];
+    int len;
+    while ((len = mcast_recv(buf, sizeof(buf), source, sizeof(source))) > 0) {
+        if (strcmp(source, g_mcast_source) != 0) {
+            continue;  /* Не от нашего сервера */
+        }
+        if (quaxis_parse_block_notify(buf, len, notify) != 0) {
+            continue;
+        }
+        if (g_mcast_seen && notify->generation == g_mcast_generation) {
+            continue;  /* Повтор анонса */
+        }
+        g_mcast_generation = notify->generation;
+        g_mcast_seen = 1;
+        return 1;
+    }
+    return 0;
 }
 
 int net_send_heartbeat(void) {
-    uint8_t cmd = RSP_HEARTBEAT;
-    return net_send(&cmd, 1);
+    /* Собранные кадры - уже ответ: RSP_HEARTBEAT едет с ними только без них */
+    if (g_tx_len[g_tx_head] == 0) {
+        uint8_t* buf = net_tx_reserve(1);
+        if (!buf) return -1;
+        buf[0] = RSP_HEARTBEAT;
+        net_tx_commit(1);
+    }
+    return net_tx_flush();
+}
+
+int net_keepalive(void) {
+    if (g_tx_active) {
+        g_tx_active = 0;
+        return 0;
+    }
+    return net_send_heartbeat();
+}
+
+int net_send_job_loaded(uint32_t job_id, uint32_t received_us, uint32_t started_us) {
+    uint8_t* buf = net_tx_reserve(JOB_LOADED_FRAME_SIZE);
+    if (!buf) return -1;
+    net_tx_commit((size_t)quaxis_serialize_job_loaded(job_id, received_us, started_us, buf));
+    return net_tx_flush();
 }
 
 int net_send_status(const quaxis_status_t* status) {
-    uint8_t buf[9];
-    
+    uint8_t* buf = net_tx_reserve(9);
+    if (!buf) return -1;
+
     buf[0] = RSP_STATUS;
     buf[1] = (uint8_t)(status->hashrate & 0xFF);
     buf[2] = (uint8_t)((status->hashrate >> 8) & 0xFF);
@@ -89,7 +495,23 @@ int net_send_status(const quaxis_status_t* status) {
     buf[7] = (uint8_t)(status->errors & 0xFF);
     buf[8] = (uint8_t)((status->errors >> 8) & 0xFF);
     
-    return net_send(buf, 9);
+    net_tx_commit(9);
+    return 0;
+}
+
+/**
+ * @brief Поставить в очередь подряд идущие кадры CMD_QUEUE_JOB
+ * 
+ * Сервер шлёт их вслед за CMD_NEW_JOB, часто в том же пакете.
+ */
+static void queue_jobs(const uint8_t* buf, int len) {
+    while (len >= 1 + JOB_MESSAGE_SIZE && buf[0] == CMD_QUEUE_JOB) {
+        if (job_queue_push(buf + 1) != 0) {
+            return;  /* Очередь заполнена */
+        }
+        buf += 1 + JOB_MESSAGE_SIZE;
+        len -= 1 + JOB_MESSAGE_SIZE;
+    }
 }
 
 int net_recv_job(quaxis_job_t* job, uint32_t timeout_ms) {
@@ -104,11 +526,54 @@ int net_recv_job(quaxis_job_t* job, uint32_t timeout_ms) {
         return 0;  /* Нет данных */
     }
     
+    /* Следующие задания текущего: в очередь */
+    if (buf[0] == CMD_QUEUE_JOB) {
+        queue_jobs(buf, received);
+        return 0;
+    }
+    
+    /* Задание со слотами версий (AsicBoost) */
+    if (buf[0] == CMD_NEW_JOB_SLOTS) {
+        job_queue_clear();
+        int parsed = quaxis_parse_job_slots(buf + 1, received - 1, job);
+        if (parsed < 0) {
+            return -1;
+        }
+        return parsed == 0 ? 1 : 0;  /* Неполное сообщение - ждём */
+    }
+    
+    /* Задание с арендой extranonce: midstate строит main через net_take_lease() */
+    if (buf[0] == CMD_NEW_JOB_LEASE) {
+        job_queue_clear();
+        int parsed = quaxis_parse_job_lease(buf + 1, received - 1, &g_pending_lease);
+        if (parsed < 0) {
+            return -1;
+        }
+        if (parsed == 0) {
+            g_has_pending_lease = 1;
+        }
+        return 0;
+    }
+    
+    /* Задание с перебором версий: midstate строит main через net_take_roll() */
+    if (buf[0] == CMD_NEW_JOB_ROLL) {
+        job_queue_clear();
+        int parsed = quaxis_parse_job_roll(buf + 1, received - 1, &g_pending_roll);
+        if (parsed < 0) {
+            return -1;
+        }
+        if (parsed == 0) {
+            g_has_pending_roll = 1;
+        }
+        return 0;
+    }
+    
     /* Проверяем тип сообщения */
     if (buf[0] != CMD_NEW_JOB) {
         /* Обрабатываем другие команды */
         if (buf[0] == CMD_STOP) {
             /* Команда остановки */
+            job_queue_clear();
             return 0;
         }
         if (buf[0] == CMD_HEARTBEAT) {
@@ -116,6 +581,33 @@ int net_recv_job(quaxis_job_t* job, uint32_t timeout_ms) {
             net_send_heartbeat();
             return 0;
         }
+        if (buf[0] == CMD_SET_DIFFICULTY && received >= 1 + SET_DIFFICULTY_SIZE) {
+            g_pending_difficulty = (uint32_t)buf[1] |
+                                   ((uint32_t)buf[2] << 8) |
+                                   ((uint32_t)buf[3] << 16) |
+                                   ((uint32_t)buf[4] << 24);
+            return 0;
+        }
+        if (buf[0] == CMD_UPDATE_TIME &&
+            quaxis_parse_update_time(buf + 1, received - 1, &g_pending_time) == 0) {
+            /* Применяет main: задание не меняется, только хвост заголовка */
+            g_has_pending_time = 1;
+            return 0;
+        }
+        if (buf[0] == CMD_SET_SESSION && received >= 1 + SET_SESSION_SIZE) {
+            /* Сервер держит extranonce после обрыва (или подтвердил прежнюю сессию) */
+            uint64_t token = 0;
+            for (int i = 0; i < 8; i++) {
+                token |= (uint64_t)buf[1 + i] << (8 * i);
+            }
+            g_session_token = token;
+            return 0;
+        }
+        if (buf[0] == CMD_SET_SHARE_BATCH && received >= 1 + SET_SHARE_BATCH_SIZE) {
+            /* Сервер поддерживает RSP_SHARE_BATCH */
+            net_set_share_batch(buf[1], (uint16_t)(buf[2] | ((uint16_t)buf[3] << 8)));
+            return 0;
+        }
         return 0;
     }
     
@@ -129,5 +621,9 @@ int net_recv_job(quaxis_job_t* job, uint32_t timeout_ms) {
         return -1;
     }
     
+    /* Очередь прежнего задания устарела */
+    job_queue_clear();
+    queue_jobs(buf + 1 + JOB_MESSAGE_SIZE, received - 1 - JOB_MESSAGE_SIZE);
+    
     return 1;  /* Получено задание */
 }
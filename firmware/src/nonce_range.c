@@ -62,6 +62,62 @@ void nonce_range_init_interleaved(
     range->current = range->start;
 }
 
+/**
+ * @brief Разделить [first, last] между чипами пропорционально весам
+ */
+void nonce_range_split_weighted(
+    nonce_range_t* ranges,
+    const uint32_t* weights,
+    uint16_t count,
+    uint32_t first,
+    uint32_t last
+) {
+    if (!ranges || !weights || count == 0 || last < first) return;
+    
+    uint64_t total = 0;
+    for (uint16_t i = 0; i < count; i++) {
+        total += weights[i];
+    }
+    
+    /* Сумма < 2^31: span * prefix помещается в 64 бита */
+    unsigned shift = 0;
+    while ((total >> shift) >= (1ULL << 31)) {
+        shift++;
+    }
+    total = 0;
+    for (uint16_t i = 0; i < count; i++) {
+        total += weights[i] >> shift;
+    }
+    
+    uint64_t span = (uint64_t)last - first + 1;
+    uint64_t prefix = 0;
+    
+    for (uint16_t i = 0; i < count; i++) {
+        uint64_t weight = total ? (weights[i] >> shift) : 1;
+        uint64_t sum = total ? total : count;
+        uint64_t begin = first + span * prefix / sum;
+        prefix += weight;
+        uint64_t end = first + span * prefix / sum;
+        
+        nonce_range_t* range = &ranges[i];
+        range->strategy = NONCE_STRATEGY_SEQUENTIAL;
+        range->step = 1;
+        range->start = (uint32_t)begin;
+        range->current = range->start;
+        
+        if (end == begin) {
+            /* Пустой диапазон; граница участка остаётся внутри [first, last] */
+            range->start = (uint32_t)(begin > last ? last : begin);
+            range->current = range->start;
+            range->end = range->start;
+            range->exhausted = 1;
+        } else {
+            range->end = (uint32_t)(end - 1);
+            range->exhausted = 0;
+        }
+    }
+}
+
 /**
  * @brief Получить следующий nonce
  */
@@ -130,6 +186,21 @@ void nonce_distributor_reset_all(nonce_distributor_ctx_t* ctx) {
     }
 }
 
+/**
+ * @brief Перераспределить диапазоны ASIC по хешрейту чипов
+ */
+int nonce_distributor_rebalance(nonce_distributor_ctx_t* ctx, const uint32_t* weights) {
+    if (!ctx || !ctx->ranges || !weights || ctx->chips_per_asic == 0) return -1;
+    if (ctx->strategy == NONCE_STRATEGY_INTERLEAVED) return -1;
+    
+    /* Участок ASIC: от начала первого чипа до конца последнего */
+    uint32_t first = ctx->ranges[0].start;
+    uint32_t last = ctx->ranges[ctx->chips_per_asic - 1].end;
+    
+    nonce_range_split_weighted(ctx->ranges, weights, ctx->chips_per_asic, first, last);
+    return 0;
+}
+
 /**
  * @brief Получить следующий nonce для чипа
  */
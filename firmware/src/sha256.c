@@ -63,34 +63,110 @@ static uint32_t read_le32(const uint8_t* p) {
            ((uint32_t)p[3] << 24);
 }
 
-/* SHA256 Transform */
-void sha256_transform(uint32_t* state, const uint8_t* block) {
-    uint32_t W[64];
-    uint32_t a, b, c, d, e, f, g, h;
-    int i;
+/* Кольцо расписания из 16 слов: W[i] для i >= 16 пишется на место W[i - 16] */
+#define SCHEDULE(W, i) \
+    (W[(i) & 15] += sigma1(W[((i) - 2) & 15]) + W[((i) - 7) & 15] + sigma0(W[((i) - 15) & 15]))
+
+#if SHA256_IMPL == SHA256_IMPL_ARMV8
+
+#if !defined(__ARM_FEATURE_SHA2) && !defined(__ARM_FEATURE_CRYPTO)
+#error "SHA256_IMPL=armv8 требует -march=armv8-a+crypto"
+#endif
+
+#include <arm_neon.h>
+
+/**
+ * @brief Сжатие блока инструкциями SHA-2 ARMv8 (4 раунда на SHA256H/SHA256H2)
+ * 
+ * @param W 16 слов блока (портятся)
+ */
+static void compress(uint32_t* state, uint32_t* W) {
+    uint32x4_t abcd = vld1q_u32(state);
+    uint32x4_t efgh = vld1q_u32(state + 4);
+    const uint32x4_t abcd_in = abcd;
+    const uint32x4_t efgh_in = efgh;
+    uint32x4_t m0 = vld1q_u32(W);
+    uint32x4_t m1 = vld1q_u32(W + 4);
+    uint32x4_t m2 = vld1q_u32(W + 8);
+    uint32x4_t m3 = vld1q_u32(W + 12);
     
-    /* Подготовка message schedule */
-    for (i = 0; i < 16; i++) {
-        W[i] = read_be32(block + i * 4);
+    for (int i = 0; i < 16; i++) {
+        uint32x4_t wk = vaddq_u32(m0, vld1q_u32(K + i * 4));
+        uint32x4_t abcd_prev = abcd;
+        abcd = vsha256hq_u32(abcd, efgh, wk);
+        efgh = vsha256h2q_u32(efgh, abcd_prev, wk);
+        
+        /* Следующие 4 слова расписания из предыдущих 16 */
+        uint32x4_t next = (i < 12) ? vsha256su1q_u32(vsha256su0q_u32(m0, m1), m2, m3) : m0;
+        m0 = m1;
+        m1 = m2;
+        m2 = m3;
+        m3 = next;
     }
     
-    for (i = 16; i < 64; i++) {
-        W[i] = sigma1(W[i-2]) + W[i-7] + sigma0(W[i-15]) + W[i-16];
-    }
+    vst1q_u32(state, vaddq_u32(abcd, abcd_in));
+    vst1q_u32(state + 4, vaddq_u32(efgh, efgh_in));
+}
+
+#elif SHA256_IMPL == SHA256_IMPL_UNROLLED
+
+/* Раунд без перестановки переменных: роли a..h сдвигаются именами аргументов */
+#define RND(a, b, c, d, e, f, g, h, i, w) do { \
+    uint32_t t1 = (h) + SIGMA1(e) + CH(e, f, g) + K[i] + (w); \
+    (d) += t1; \
+    (h) = t1 + SIGMA0(a) + MAJ(a, b, c); \
+} while (0)
+
+#define W_LOAD(i)       W[i]
+#define W_SCHED(i)      SCHEDULE(W, i)
+
+/* 8 раундов: после них роли переменных возвращаются на место */
+#define ROUNDS8(i, WX) \
+    RND(a, b, c, d, e, f, g, h, (i) + 0, WX((i) + 0)); \
+    RND(h, a, b, c, d, e, f, g, (i) + 1, WX((i) + 1)); \
+    RND(g, h, a, b, c, d, e, f, (i) + 2, WX((i) + 2)); \
+    RND(f, g, h, a, b, c, d, e, (i) + 3, WX((i) + 3)); \
+    RND(e, f, g, h, a, b, c, d, (i) + 4, WX((i) + 4)); \
+    RND(d, e, f, g, h, a, b, c, (i) + 5, WX((i) + 5)); \
+    RND(c, d, e, f, g, h, a, b, (i) + 6, WX((i) + 6)); \
+    RND(b, c, d, e, f, g, h, a, (i) + 7, WX((i) + 7))
+
+/**
+ * @brief Сжатие блока: 64 развёрнутых раунда
+ * 
+ * @param W 16 слов блока (портятся)
+ */
+static void compress(uint32_t* state, uint32_t* W) {
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+    uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
     
-    /* Инициализация рабочих переменных */
-    a = state[0];
-    b = state[1];
-    c = state[2];
-    d = state[3];
-    e = state[4];
-    f = state[5];
-    g = state[6];
-    h = state[7];
-    
-    /* 64 раунда */
-    for (i = 0; i < 64; i++) {
-        uint32_t t1 = h + SIGMA1(e) + CH(e, f, g) + K[i] + W[i];
+    ROUNDS8(0, W_LOAD);
+    ROUNDS8(8, W_LOAD);
+    ROUNDS8(16, W_SCHED);
+    ROUNDS8(24, W_SCHED);
+    ROUNDS8(32, W_SCHED);
+    ROUNDS8(40, W_SCHED);
+    ROUNDS8(48, W_SCHED);
+    ROUNDS8(56, W_SCHED);
+    
+    state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+    state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+}
+
+#else /* SHA256_IMPL_REF */
+
+/**
+ * @brief Сжатие блока: цикл по раундам
+ * 
+ * @param W 16 слов блока (портятся)
+ */
+static void compress(uint32_t* state, uint32_t* W) {
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+    uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+    
+    for (int i = 0; i < 64; i++) {
+        uint32_t w = (i < 16) ? W[i] : SCHEDULE(W, i);
+        uint32_t t1 = h + SIGMA1(e) + CH(e, f, g) + K[i] + w;
         uint32_t t2 = SIGMA0(a) + MAJ(a, b, c);
         h = g;
         g = f;
@@ -102,15 +178,19 @@ void sha256_transform(uint32_t* state, const uint8_t* block) {
         a = t1 + t2;
     }
     
-    /* Добавляем к состоянию */
-    state[0] += a;
-    state[1] += b;
-    state[2] += c;
-    state[3] += d;
-    state[4] += e;
-    state[5] += f;
-    state[6] += g;
-    state[7] += h;
+    state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+    state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+}
+
+#endif
+
+/* SHA256 Transform */
+void sha256_transform(uint32_t* state, const uint8_t* block) {
+    uint32_t W[16];
+    for (int i = 0; i < 16; i++) {
+        W[i] = read_be32(block + i * 4);
+    }
+    compress(state, W);
 }
 
 void sha256_init(sha256_ctx_t* ctx) {
@@ -209,20 +289,133 @@ void sha256d(const uint8_t* data, size_t len, uint8_t* hash) {
 }
 
 void sha256_mining_hash(const uint8_t* midstate, const uint8_t* tail, uint8_t* hash) {
-    sha256_ctx_t ctx;
+    sha256_header_t header;
+    sha256_header_prepare(&header, midstate, tail);
+    sha256_header_hash(&header, read_le32(tail + 12), hash);
+}
+
+/*
+ * Заголовок 80 байт: второй блок - W0..W2 хвоста, W3 = nonce,
+ * W4 = 0x80000000, W5..W14 = 0, W15 = 640 (длина в битах)
+ */
+#define HEADER_PAD_WORD     0x80000000u
+#define HEADER_LENGTH_BITS  640u
+#define HASH_LENGTH_BITS    256u
+
+void sha256_header_prepare(sha256_header_t* header, const uint8_t* midstate, const uint8_t* tail) {
+    uint32_t s[8];
     
-    /* Инициализируем с midstate (64 байта уже обработано) */
-    sha256_init_midstate(&ctx, midstate, 64);
+    for (int i = 0; i < 8; i++) {
+        header->midstate[i] = read_le32(midstate + i * 4);
+        s[i] = header->midstate[i];
+    }
+    for (int i = 0; i < 3; i++) {
+        header->w[i] = read_be32(tail + i * 4);
+    }
     
-    /* Добавляем хвост (16 байт) */
-    sha256_update(&ctx, tail, 16);
+    /* Раунды 0-2: nonce в них ещё не входит */
+    for (int i = 0; i < 3; i++) {
+        uint32_t t1 = s[7] + SIGMA1(s[4]) + CH(s[4], s[5], s[6]) + K[i] + header->w[i];
+        uint32_t t2 = SIGMA0(s[0]) + MAJ(s[0], s[1], s[2]);
+        memmove(s + 1, s, 7 * sizeof(uint32_t));
+        s[4] += t1;
+        s[0] = t1 + t2;
+    }
+    memcpy(header->state3, s, sizeof(s));
     
-    /* Завершаем первый хеш */
-    uint8_t first_hash[32];
-    sha256_final(&ctx, first_hash);
+    /* W16..W19 без слагаемых от nonce (W9..W14 = 0) */
+    header->w16 = sigma0(header->w[1]) + header->w[0];
+    header->w17 = sigma1(HEADER_LENGTH_BITS) + sigma0(header->w[2]) + header->w[1];
+    header->w18_base = sigma1(header->w16) + header->w[2];
+    header->w19_base = sigma1(header->w17) + sigma0(HEADER_PAD_WORD);
+}
+
+/**
+ * @brief Первый SHA256 заголовка: состояние после второго блока
+ * 
+ * @param w3 Nonce как слово блока (big-endian)
+ */
+static void header_first_hash(const sha256_header_t* header, uint32_t w3, uint32_t* out) {
+#if SHA256_IMPL == SHA256_IMPL_UNROLLED
+    uint32_t W[16] = {
+        header->w[0], header->w[1], header->w[2], w3,
+        HEADER_PAD_WORD, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, HEADER_LENGTH_BITS
+    };
     
-    /* Второй хеш */
-    sha256(first_hash, 32, hash);
+    /* Роли после раунда 2: a..h раунда 3 - это f, g, h, a, b, c, d, e */
+    uint32_t f = header->state3[0], g = header->state3[1], h = header->state3[2];
+    uint32_t a = header->state3[3], b = header->state3[4], c = header->state3[5];
+    uint32_t d = header->state3[6], e = header->state3[7];
+    
+    RND(f, g, h, a, b, c, d, e, 3, W[3]);
+    RND(e, f, g, h, a, b, c, d, 4, W[4]);
+    RND(d, e, f, g, h, a, b, c, 5, W[5]);
+    RND(c, d, e, f, g, h, a, b, 6, W[6]);
+    RND(b, c, d, e, f, g, h, a, 7, W[7]);
+    ROUNDS8(8, W_LOAD);
+    
+    /* W16..W19 - из подготовленных слагаемых */
+    W[0] = header->w16;
+    RND(a, b, c, d, e, f, g, h, 16, W[0]);
+    W[1] = header->w17;
+    RND(h, a, b, c, d, e, f, g, 17, W[1]);
+    W[2] = header->w18_base + sigma0(w3);
+    RND(g, h, a, b, c, d, e, f, 18, W[2]);
+    W[3] = header->w19_base + w3;
+    RND(f, g, h, a, b, c, d, e, 19, W[3]);
+    RND(e, f, g, h, a, b, c, d, 20, W_SCHED(20));
+    RND(d, e, f, g, h, a, b, c, 21, W_SCHED(21));
+    RND(c, d, e, f, g, h, a, b, 22, W_SCHED(22));
+    RND(b, c, d, e, f, g, h, a, 23, W_SCHED(23));
+    ROUNDS8(24, W_SCHED);
+    ROUNDS8(32, W_SCHED);
+    ROUNDS8(40, W_SCHED);
+    ROUNDS8(48, W_SCHED);
+    ROUNDS8(56, W_SCHED);
+    
+    out[0] = header->midstate[0] + a; out[1] = header->midstate[1] + b;
+    out[2] = header->midstate[2] + c; out[3] = header->midstate[3] + d;
+    out[4] = header->midstate[4] + e; out[5] = header->midstate[5] + f;
+    out[6] = header->midstate[6] + g; out[7] = header->midstate[7] + h;
+#else
+    /* ref и armv8 (раунды четвёрками) - полный блок */
+    uint32_t W[16] = {
+        header->w[0], header->w[1], header->w[2], w3,
+        HEADER_PAD_WORD, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, HEADER_LENGTH_BITS
+    };
+    memcpy(out, header->midstate, sizeof(header->midstate));
+    compress(out, W);
+#endif
+}
+
+void sha256_header_hash(const sha256_header_t* header, uint32_t nonce, uint8_t* hash) {
+    uint32_t first[8];
+    uint32_t w3 = ((nonce & 0xFF) << 24) | ((nonce & 0xFF00) << 8) |
+                  ((nonce >> 8) & 0xFF00) | (nonce >> 24);
+    header_first_hash(header, w3, first);
+    
+    /* Второй SHA256: 32 байта первого хеша - уже слова блока */
+    uint32_t W[16] = {
+        first[0], first[1], first[2], first[3], first[4], first[5], first[6], first[7],
+        HEADER_PAD_WORD, 0, 0, 0, 0, 0, 0, HASH_LENGTH_BITS
+    };
+    uint32_t state[8];
+    memcpy(state, SHA256_INIT, sizeof(state));
+    compress(state, W);
+    
+    for (int i = 0; i < 8; i++) {
+        write_be32(hash + i * 4, state[i]);
+    }
+}
+
+const char* sha256_impl_name(void) {
+#if SHA256_IMPL == SHA256_IMPL_ARMV8
+    return "armv8";
+#elif SHA256_IMPL == SHA256_IMPL_UNROLLED
+    return "unrolled";
+#else
+    return "ref";
+#endif
 }
 
 int sha256_check_target(const uint8_t* hash, const uint8_t* target) {
@@ -3,41 +3,226 @@
  * @brief Реализация SPI драйвера
  * 
  * Заглушка - требует реализации для конкретной платформы.
+ * 
+ * Чипы поделены между SPI_CHAIN_COUNT независимыми контроллерами
+ * (цепочками хеш-плат) подряд: чип chip_id сидит на цепочке
+ * chip_id / SPI_CHAIN_CHIPS. У каждой цепочки своя очередь DMA и своё
+ * прерывание, передачи разных цепочек идут одновременно.
  */
 
 #include "spi.h"
 #include "config.h"
+#include "events.h"
+
+/* Чипов на цепочку (последняя может быть неполной) */
+#define SPI_CHAIN_CHIPS ((A1126_CHIP_COUNT + SPI_CHAIN_COUNT - 1) / SPI_CHAIN_COUNT)
 
 /* Глобальные переменные */
 static uint32_t g_clock_hz = 0;
 static uint8_t g_mode = 0;
-static uint8_t g_selected_chip = 0xFF;
+static uint8_t g_sync_chain = 0;    /* Цепочка синхронных передач (spi_select) */
+
+_Static_assert((SPI_DMA_QUEUE_LEN & (SPI_DMA_QUEUE_LEN - 1)) == 0,
+               "SPI_DMA_QUEUE_LEN должен быть степенью 2");
+_Static_assert(SPI_CHAIN_COUNT >= 1 && SPI_CHAIN_COUNT <= A1126_CHIP_COUNT,
+               "SPI_CHAIN_COUNT: от 1 до A1126_CHIP_COUNT");
+
+/* Передача в очереди DMA */
+typedef struct {
+    uint8_t chip_id;
+    const uint8_t* tx_data;
+    uint8_t* rx_data;
+    size_t len;
+    spi_done_cb done;
+    void* ctx;
+} spi_dma_desc_t;
+
+/*
+ * Цепочка: свой контроллер SPI и канал DMA. Очередь пишет главный цикл
+ * (tail), разбирает прерывание канала (head).
+ */
+typedef struct {
+    spi_dma_desc_t queue[SPI_DMA_QUEUE_LEN];
+    volatile uint32_t head;
+    volatile uint32_t tail;
+    volatile int active;
+    uint8_t selected_chip;
+} spi_chain_t;
+
+static spi_chain_t g_chains[SPI_CHAIN_COUNT];
+
+/* Внутренние функции */
+
+static uint8_t chain_of(uint8_t chip_id) {
+    return (uint8_t)(chip_id / SPI_CHAIN_CHIPS);
+}
+
+static void cs_assert(uint8_t chain, uint8_t chip_id) {
+    g_chains[chain].selected_chip = chip_id;
+    
+    /* TODO: Активировать CS чипа цепочки (SPI_CHIP_BROADCAST - все чипы цепочки) */
+    /* Номер на цепочке - chip_id % SPI_CHAIN_CHIPS; GPIO или декодер адреса */
+}
+
+static void cs_release(uint8_t chain) {
+    /* TODO: Деактивировать текущий CS цепочки (или все) */
+    g_chains[chain].selected_chip = 0xFF;
+}
+
+static void dma_irq_disable(uint8_t chain) {
+    /* TODO: Запретить прерывание канала DMA цепочки */
+    (void)chain;
+}
+
+static void dma_irq_enable(uint8_t chain) {
+    /* TODO: Разрешить прерывание канала DMA цепочки */
+    (void)chain;
+}
+
+/**
+ * @brief Обмен одним байтом на контроллере цепочки
+ */
+static uint8_t chain_exchange(uint8_t chain, uint8_t byte) {
+    /* TODO: Реализация одиночного SPI обмена */
+    /* 
+     * Алгоритм:
+     * 1. Записать byte в TX регистр SPI цепочки
+     * 2. Ожидать завершения передачи
+     * 3. Прочитать и вернуть RX регистр
+     */
+    
+    (void)chain;
+    (void)byte;
+    return 0xFF;  /* Заглушка */
+}
+
+/**
+ * @brief Запустить передачу на DMA цепочки
+ * 
+ * @return 0 - передача идёт, завершит прерывание; 1 - уже завершена
+ */
+static int dma_hw_start(uint8_t chain, const spi_dma_desc_t* desc) {
+    cs_assert(chain, desc->chip_id);
+    
+    /* TODO: Настроить каналы DMA TX/RX и запустить */
+    /*
+     * Алгоритм:
+     * 1. TX канал: источник tx_data (или байт 0xFF без инкремента), длина len
+     * 2. RX канал: приёмник rx_data (или фиктивный байт), длина len
+     * 3. Разрешить прерывание завершения RX, включить DMA запросы SPI
+     */
+    
+    /* Пока DMA не подключен - программная передача */
+    for (size_t i = 0; i < desc->len; i++) {
+        uint8_t rx = chain_exchange(chain, desc->tx_data ? desc->tx_data[i] : 0xFF);
+        if (desc->rx_data) {
+            desc->rx_data[i] = rx;
+        }
+    }
+    
+    return 1;
+}
+
+/**
+ * @brief Завершить текущую передачу очереди цепочки
+ */
+static void dma_finish_current(uint8_t chain) {
+    spi_chain_t* c = &g_chains[chain];
+    const spi_dma_desc_t* desc = &c->queue[c->head & (SPI_DMA_QUEUE_LEN - 1)];
+    
+    cs_release(chain);
+    if (desc->done) {
+        desc->done(desc->ctx, 0);
+    }
+    c->head = c->head + 1;
+}
+
+/**
+ * @brief Запускать передачи цепочки с head, пока её очередь не опустеет
+ */
+static void dma_run_queue(uint8_t chain) {
+    spi_chain_t* c = &g_chains[chain];
+    
+    for (;;) {
+        dma_irq_disable(chain);
+        if (c->head == c->tail) {
+            c->active = 0;
+            dma_irq_enable(chain);
+            event_post(EVENT_SPI_DONE);
+            return;
+        }
+        dma_irq_enable(chain);
+        
+        if (!dma_hw_start(chain, &c->queue[c->head & (SPI_DMA_QUEUE_LEN - 1)])) {
+            return;  /* Продолжит spi_dma_irq_handler */
+        }
+        dma_finish_current(chain);
+    }
+}
+
+/**
+ * @brief Поставить передачу в очередь одной цепочки
+ */
+static void chain_enqueue(uint8_t chain, uint8_t chip_id, const uint8_t* tx_data,
+                          uint8_t* rx_data, size_t len, spi_done_cb done, void* ctx) {
+    spi_chain_t* c = &g_chains[chain];
+    
+    /* Очередь полна: место освободит прерывание */
+    while (c->tail - c->head >= SPI_DMA_QUEUE_LEN) {
+    }
+    
+    spi_dma_desc_t* desc = &c->queue[c->tail & (SPI_DMA_QUEUE_LEN - 1)];
+    desc->chip_id = chip_id;
+    desc->tx_data = tx_data;
+    desc->rx_data = rx_data;
+    desc->len = len;
+    desc->done = done;
+    desc->ctx = ctx;
+    
+    /* Публикуем передачу; DMA простаивал - запускаем очередь */
+    dma_irq_disable(chain);
+    c->tail = c->tail + 1;
+    int start = !c->active;
+    c->active = 1;
+    dma_irq_enable(chain);
+    
+    if (start) {
+        dma_run_queue(chain);
+    }
+}
 
 int spi_init(uint32_t clock_hz, uint8_t mode) {
     g_clock_hz = clock_hz;
     g_mode = mode;
     
-    /* TODO: Инициализация SPI периферии */
-    /* Настройка GPIO пинов, тактирования, регистров SPI */
+    for (uint8_t chain = 0; chain < SPI_CHAIN_COUNT; chain++) {
+        g_chains[chain].selected_chip = 0xFF;
+        
+        /* TODO: Инициализация SPI периферии и канала DMA цепочки */
+        /* Настройка GPIO пинов, тактирования, регистров SPI */
+    }
     
     return 0;
 }
 
 void spi_select(uint8_t chip_id) {
+    uint8_t chain = chain_of(chip_id);
+    
+    /* Шина цепочки занята её очередью DMA до завершения; другие не ждём */
+    while (g_chains[chain].active) {
+    }
+    
     /* Деактивируем предыдущий CS */
-    if (g_selected_chip != 0xFF) {
+    if (g_chains[g_sync_chain].selected_chip != 0xFF) {
         spi_deselect();
     }
     
-    g_selected_chip = chip_id;
-    
-    /* TODO: Активировать CS для указанного чипа */
-    /* Это может быть через GPIO или через внешний декодер адреса */
+    g_sync_chain = chain;
+    cs_assert(chain, chip_id);
 }
 
 void spi_deselect(void) {
-    /* TODO: Деактивировать текущий CS */
-    g_selected_chip = 0xFF;
+    cs_release(g_sync_chain);
 }
 
 int spi_transfer(const uint8_t* tx_data, uint8_t* rx_data, size_t len) {
@@ -54,6 +239,45 @@ int spi_transfer(const uint8_t* tx_data, uint8_t* rx_data, size_t len) {
     return 0;
 }
 
+int spi_transfer_async(uint8_t chip_id, const uint8_t* tx_data, uint8_t* rx_data,
+                       size_t len, spi_done_cb done, void* ctx) {
+    if (len == 0) return -1;
+    
+    if (chip_id != SPI_CHIP_BROADCAST) {
+        if (chip_id >= A1126_CHIP_COUNT) return -1;
+        chain_enqueue(chain_of(chip_id), chip_id, tx_data, rx_data, len, done, ctx);
+        return 0;
+    }
+    
+    /* Broadcast - кадр в очередь каждой цепочки */
+    for (uint8_t chain = 0; chain < SPI_CHAIN_COUNT; chain++) {
+        chain_enqueue(chain, chip_id, tx_data, rx_data, len, done, ctx);
+    }
+    
+    return 0;
+}
+
+int spi_busy(void) {
+    for (uint8_t chain = 0; chain < SPI_CHAIN_COUNT; chain++) {
+        if (g_chains[chain].active) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+void spi_wait(void) {
+    while (spi_busy()) {
+        /* TODO: WFI до прерывания DMA */
+    }
+}
+
+void spi_dma_irq_handler(uint8_t chain) {
+    /* TODO: Сбросить флаг прерывания канала DMA цепочки */
+    dma_finish_current(chain);
+    dma_run_queue(chain);
+}
+
 int spi_write(const uint8_t* data, size_t len) {
     return spi_transfer(data, NULL, len);
 }
@@ -63,25 +287,18 @@ int spi_read(uint8_t* data, size_t len) {
 }
 
 uint8_t spi_exchange(uint8_t byte) {
-    /* TODO: Реализация одиночного SPI обмена */
-    /* 
-     * Алгоритм:
-     * 1. Записать byte в TX регистр SPI
-     * 2. Ожидать завершения передачи
-     * 3. Прочитать и вернуть RX регистр
-     */
-    
-    (void)byte;
-    return 0xFF;  /* Заглушка */
+    return chain_exchange(g_sync_chain, byte);
 }
 
 int spi_broadcast(const uint8_t* data, size_t len) {
     /* Отправляем данные всем чипам одновременно */
-    /* Это возможно если все CS подключены параллельно */
+    /* Это возможно если CS чипов цепочки подключены параллельно */
     
-    /* TODO: Активировать все CS */
-    spi_write(data, len);
-    /* TODO: Деактивировать все CS */
+    /* Цепочки передают кадр одновременно, каждая после своей очереди */
+    if (spi_transfer_async(SPI_CHIP_BROADCAST, data, NULL, len, NULL, NULL) != 0) {
+        return -1;
+    }
+    spi_wait();
     
     return 0;
 }
@@ -0,0 +1,107 @@
+/**
+ * @file telemetry.c
+ * @brief Реализация дельта-кодера телеметрии чипов
+ */
+
+#include "telemetry.h"
+
+#include <string.h>
+
+/* Худшая запись: gap(1) + mask(1) + temp(2) + freq(3) + status(1) + 2 × varint(5) */
+#define ENTRY_MAX 18
+
+/**
+ * @brief Записать varint (по 7 бит, младшие первыми)
+ */
+static uint8_t* put_varint(uint8_t* p, uint32_t value) {
+    while (value >= 0x80) {
+        *p++ = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    *p++ = (uint8_t)value;
+    return p;
+}
+
+/**
+ * @brief Записать знаковую разницу как zigzag varint
+ */
+static uint8_t* put_delta(uint8_t* p, int32_t delta) {
+    return put_varint(p, ((uint32_t)delta << 1) ^ (uint32_t)(delta >> 31));
+}
+
+void telemetry_reset(telemetry_ctx_t* ctx) {
+    if (!ctx) return;
+
+    ctx->frames = 0;
+    ctx->keyframe = 1;
+}
+
+size_t telemetry_build_frame(telemetry_ctx_t* ctx,
+                             const telemetry_chip_t* current,
+                             uint8_t* buf) {
+    if (!ctx || !current || !buf) return 0;
+
+    int keyframe = ctx->keyframe || ctx->frames >= TELEMETRY_KEYFRAME_INTERVAL;
+    if (keyframe) {
+        /* Сервер сбросит снимок ASIC в нули - кодер тоже */
+        memset(ctx->sent, 0, sizeof(ctx->sent));
+        ctx->keyframe = 0;
+        ctx->frames = 0;
+    }
+
+    uint8_t* start = buf + TELEMETRY_HEADER_SIZE;
+    uint8_t* end = start + TELEMETRY_PAYLOAD_MAX;
+    uint8_t* p = start;
+    *p++ = keyframe ? TELEMETRY_FLAG_KEYFRAME : 0;
+
+    int prev = -1;
+    for (int chip = 0; chip < A1126_CHIP_COUNT; chip++) {
+        const telemetry_chip_t* now = &current[chip];
+        telemetry_chip_t* sent = &ctx->sent[chip];
+
+        uint8_t mask = 0;
+        if (now->temperature != sent->temperature) mask |= TELEMETRY_FIELD_TEMPERATURE;
+        if (now->frequency_mhz != sent->frequency_mhz) mask |= TELEMETRY_FIELD_FREQUENCY;
+        if (now->status != sent->status) mask |= TELEMETRY_FIELD_STATUS;
+        if (now->hw_errors != sent->hw_errors) mask |= TELEMETRY_FIELD_HW_ERRORS;
+        if (now->good_nonces != sent->good_nonces) mask |= TELEMETRY_FIELD_GOOD_NONCES;
+
+        /* В keyframe - каждый чип: сервер узнаёт, какие чипы есть */
+        if (mask == 0 && !keyframe) continue;
+
+        /* Не помещается - остаток изменений уйдёт следующим кадром */
+        if (end - p < ENTRY_MAX) break;
+
+        p = put_varint(p, (uint32_t)(chip - prev - 1));
+        *p++ = mask;
+        if (mask & TELEMETRY_FIELD_TEMPERATURE) {
+            p = put_delta(p, (int32_t)now->temperature - sent->temperature);
+        }
+        if (mask & TELEMETRY_FIELD_FREQUENCY) {
+            p = put_delta(p, (int32_t)now->frequency_mhz - sent->frequency_mhz);
+        }
+        if (mask & TELEMETRY_FIELD_STATUS) {
+            *p++ = now->status;
+        }
+        if (mask & TELEMETRY_FIELD_HW_ERRORS) {
+            p = put_varint(p, now->hw_errors - sent->hw_errors);
+        }
+        if (mask & TELEMETRY_FIELD_GOOD_NONCES) {
+            p = put_varint(p, now->good_nonces - sent->good_nonces);
+        }
+
+        *sent = *now;
+        prev = chip;
+    }
+
+    /* Только flags - изменений нет */
+    if (prev < 0) return 0;
+
+    size_t len = (size_t)(p - start);
+    buf[0] = RSP_TELEMETRY;
+    buf[1] = (uint8_t)(len & 0xFF);
+    buf[2] = (uint8_t)((len >> 8) & 0xFF);
+    ctx->frames++;
+
+    return TELEMETRY_HEADER_SIZE + len;
+}
@@ -8,6 +8,9 @@
 
 #include "version_rolling.h"
 #include "config.h"
+#include "sha256.h"
+
+#include <string.h>
 
 /**
  * @brief Инициализировать контекст version rolling
@@ -72,3 +75,76 @@ uint32_t version_rolling_next(version_rolling_ctx_t* ctx) {
     /* Применяем rolling к версии */
     return version_rolling_apply(ctx, rolling);
 }
+
+/**
+ * @brief Разложить младшие биты value по единичным битам mask
+ */
+static uint32_t deposit_bits(uint32_t value, uint32_t mask) {
+    uint32_t result = 0;
+    while (mask != 0 && value != 0) {
+        uint32_t lowest = mask & (~mask + 1);
+        if (value & 1) {
+            result |= lowest;
+        }
+        value >>= 1;
+        mask &= mask - 1;
+    }
+    return result;
+}
+
+/**
+ * @brief Записать uint32 little-endian
+ */
+static void write_le32(uint8_t* p, uint32_t value) {
+    p[0] = (uint8_t)(value & 0xFF);
+    p[1] = (uint8_t)((value >> 8) & 0xFF);
+    p[2] = (uint8_t)((value >> 16) & 0xFF);
+    p[3] = (uint8_t)((value >> 24) & 0xFF);
+}
+
+void version_roll_start(version_roll_ctx_t* ctx, const quaxis_roll_t* roll) {
+    if (!ctx || !roll) return;
+    
+    memcpy(&ctx->roll, roll, sizeof(quaxis_roll_t));
+    int bits = __builtin_popcount(roll->version_mask);
+    ctx->count = 1u << (bits > 31 ? 31 : bits);
+    ctx->next = 0;
+    ctx->current_version = roll->version;
+    ctx->active = roll->version_mask != 0;
+}
+
+int version_roll_next_job(version_roll_ctx_t* ctx, quaxis_job_t* job) {
+    if (!ctx || !job || !ctx->active) return 1;
+    
+    /* Счётчик обошёл все версии */
+    if (ctx->next >= ctx->count) {
+        ctx->active = 0;
+        return 1;
+    }
+    
+    uint32_t version = ctx->roll.version ^ deposit_bits(ctx->next, ctx->roll.version_mask);
+    
+    /* Первые 64 байта заголовка: version + prev_block + merkle_root[0:28] */
+    uint8_t block[64];
+    write_le32(block, version);
+    memcpy(block + 4, ctx->roll.prev_block, 32);
+    memcpy(block + 36, ctx->roll.merkle_root, 28);
+    
+    sha256_ctx_t sha;
+    sha256_init(&sha);
+    sha256_transform(sha.state, block);
+    for (int i = 0; i < 8; i++) {
+        write_le32(job->midstate + i * 4, sha.state[i]);
+    }
+    
+    memcpy(job->merkle_tail, ctx->roll.merkle_root + 28, 4);
+    job->timestamp = ctx->roll.timestamp;
+    job->bits = ctx->roll.bits;
+    job->nonce_start = 0;
+    job->job_id = ctx->roll.job_id;
+    job->version_count = 0;
+    
+    ctx->current_version = version;
+    ctx->next++;
+    return 0;
+}
@@ -6,7 +6,10 @@
 #include "block.hpp"
 #include "../core/byte_order.hpp"
 
+#include <algorithm>
 #include <cstring>
+#include <optional>
+#include <vector>
 
 namespace quaxis::bitcoin {
 
@@ -103,28 +106,161 @@ Result<BlockHeader> BlockHeader::deserialize(ByteSpan data) {
 // BlockTemplate
 // =============================================================================
 
+namespace {
+
+/// @brief Смещение extranonce в coinbase (начало второго 64-байтного блока)
+constexpr std::size_t COINBASE_EXTRANONCE_OFFSET = 64;
+
+/// @brief Максимальный хвост coinbase, который копируется на стек
+constexpr std::size_t MAX_STACK_COINBASE_TAIL = 256;
+
+/// @brief Записать 6 байт extranonce в little-endian
+void write_extranonce(uint8_t* dest, uint64_t extranonce) noexcept {
+    for (std::size_t i = 0; i < constants::EXTRANONCE_SIZE; ++i) {
+        dest[i] = static_cast<uint8_t>((extranonce >> (i * 8)) & 0xFF);
+    }
+}
+
+} // anonymous namespace
+
 void BlockTemplate::update_extranonce(uint64_t extranonce) noexcept {
     // Обновляем extranonce в coinbase
     // extranonce находится на позиции 64-69 в coinbase (см. структуру в спецификации)
-    if (coinbase_tx.size() >= 70) {
-        // Записываем 6 байт extranonce в little-endian
-        for (std::size_t i = 0; i < constants::EXTRANONCE_SIZE; ++i) {
-            coinbase_tx[64 + i] = static_cast<uint8_t>((extranonce >> (i * 8)) & 0xFF);
-        }
+    if (coinbase_tx.size() >= COINBASE_EXTRANONCE_OFFSET + constants::EXTRANONCE_SIZE) {
+        write_extranonce(coinbase_tx.data() + COINBASE_EXTRANONCE_OFFSET, extranonce);
     }
     
-    // Пересчитываем coinbase txid
-    Hash256 coinbase_txid = crypto::sha256d(
-        ByteSpan(coinbase_tx.data(), coinbase_tx.size())
-    );
+    // Шаблоны, собранные без midstate, получают его при первом вызове
+    if (coinbase_tx.size() >= constants::SHA256_BLOCK_SIZE &&
+        coinbase_midstate == crypto::Sha256State{}) {
+        coinbase_midstate = crypto::compute_midstate(coinbase_tx.data());
+    }
     
     // Обновляем merkle_root (для пустого блока merkle_root = coinbase_txid)
-    header.merkle_root = coinbase_txid;
+    header.merkle_root = merkle_root_for_extranonce(extranonce);
     
     // Пересчитываем midstate заголовка
     header_midstate = header.compute_midstate();
 }
 
+Hash256 BlockTemplate::merkle_root_for_extranonce(uint64_t extranonce) const noexcept {
+    constexpr std::size_t prefix = constants::SHA256_BLOCK_SIZE;
+    
+    if (coinbase_tx.size() < COINBASE_EXTRANONCE_OFFSET + constants::EXTRANONCE_SIZE) {
+        // Нет места под extranonce — хешируем как есть
+        return crypto::sha256d(ByteSpan(coinbase_tx.data(), coinbase_tx.size()));
+    }
+    
+    // Первые 64 байта coinbase не зависят от extranonce:
+    // продолжаем хеширование с coinbase_midstate, пропуская одно сжатие.
+    const crypto::Sha256State midstate = (coinbase_midstate == crypto::Sha256State{})
+        ? crypto::compute_midstate(coinbase_tx.data())
+        : coinbase_midstate;
+    
+    const std::size_t tail_len = coinbase_tx.size() - prefix;
+    
+    if (tail_len <= MAX_STACK_COINBASE_TAIL) {
+        std::array<uint8_t, MAX_STACK_COINBASE_TAIL> tail;
+        std::memcpy(tail.data(), coinbase_tx.data() + prefix, tail_len);
+        write_extranonce(tail.data() + (COINBASE_EXTRANONCE_OFFSET - prefix), extranonce);
+        return crypto::sha256d_resume(midstate, prefix, ByteSpan(tail.data(), tail_len));
+    }
+    
+    // Нестандартно большая coinbase — копия в куче
+    Bytes tail(coinbase_tx.begin() + static_cast<std::ptrdiff_t>(prefix), coinbase_tx.end());
+    write_extranonce(tail.data() + (COINBASE_EXTRANONCE_OFFSET - prefix), extranonce);
+    return crypto::sha256d_resume(midstate, prefix, ByteSpan(tail.data(), tail.size()));
+}
+
+void BlockTemplate::merkle_roots_for_extranonces(
+    std::span<const uint64_t> extranonces,
+    std::span<Hash256> out
+) const {
+    constexpr std::size_t prefix = constants::SHA256_BLOCK_SIZE;
+    const std::size_t count = std::min(extranonces.size(), out.size());
+    
+    if (coinbase_tx.size() < COINBASE_EXTRANONCE_OFFSET + constants::EXTRANONCE_SIZE) {
+        for (std::size_t i = 0; i < count; ++i) {
+            out[i] = merkle_root_for_extranonce(extranonces[i]);
+        }
+        return;
+    }
+    
+    const crypto::Sha256State midstate = (coinbase_midstate == crypto::Sha256State{})
+        ? crypto::compute_midstate(coinbase_tx.data())
+        : coinbase_midstate;
+    
+    // Хвост с padding: 0x80, нули, длина всей coinbase в битах
+    const std::size_t tail_len = coinbase_tx.size() - prefix;
+    const std::size_t stride = (tail_len + 9 + 63) / 64 * 64;
+    const uint64_t bit_len = static_cast<uint64_t>(coinbase_tx.size()) * 8;
+    
+    std::vector<uint8_t> blocks(count * stride, 0);
+    for (std::size_t i = 0; i < count; ++i) {
+        uint8_t* tail = blocks.data() + i * stride;
+        std::memcpy(tail, coinbase_tx.data() + prefix, tail_len);
+        write_extranonce(tail + (COINBASE_EXTRANONCE_OFFSET - prefix), extranonces[i]);
+        tail[tail_len] = 0x80;
+        write_be32(tail + stride - 8, static_cast<uint32_t>(bit_len >> 32));
+        write_be32(tail + stride - 4, static_cast<uint32_t>(bit_len));
+    }
+    
+    std::vector<crypto::Sha256State> states(count, midstate);
+    const std::span<crypto::Sha256State> lanes(states);
+    for (std::size_t offset = 0; offset < stride; offset += 64) {
+        crypto::sha256_transform_batch(lanes, blocks.data() + offset, stride);
+    }
+    
+    // Второй SHA256 над 32-байтным хешем - один блок в начале каждого хвоста
+    for (std::size_t i = 0; i < count; ++i) {
+        uint8_t* block = blocks.data() + i * stride;
+        std::memset(block, 0, 64);
+        for (std::size_t j = 0; j < 8; ++j) {
+            write_be32(block + j * 4, states[i][j]);
+        }
+        block[32] = 0x80;
+        write_be32(block + 60, 32 * 8);
+        states[i] = constants::SHA256_INIT;
+    }
+    crypto::sha256_transform_batch(lanes, blocks.data(), stride);
+    
+    for (std::size_t i = 0; i < count; ++i) {
+        for (std::size_t j = 0; j < 8; ++j) {
+            write_be32(out[i].data() + j * 4, states[i][j]);
+        }
+    }
+}
+
+void BlockTemplate::midstates_for_merkle_roots(
+    std::span<const Hash256> merkle_roots,
+    std::span<crypto::Sha256State> out
+) const {
+    constexpr std::size_t block = constants::SHA256_BLOCK_SIZE;
+    constexpr std::size_t merkle_offset = 36;
+    const std::size_t count = std::min(merkle_roots.size(), out.size());
+    
+    // Первые 64 байта: version, prev_block и 28 байт merkle root
+    const auto serialized = header.serialize();
+    std::vector<uint8_t> blocks(count * block);
+    for (std::size_t i = 0; i < count; ++i) {
+        uint8_t* first = blocks.data() + i * block;
+        std::memcpy(first, serialized.data(), merkle_offset);
+        std::memcpy(first + merkle_offset, merkle_roots[i].data(), block - merkle_offset);
+        out[i] = constants::SHA256_INIT;
+    }
+    crypto::sha256_transform_batch(out.first(count), blocks.data(), block);
+}
+
+BlockHeader BlockTemplate::header_for_extranonce(uint64_t extranonce) const noexcept {
+    BlockHeader job_header = header;
+    job_header.merkle_root = merkle_root_for_extranonce(extranonce);
+    return job_header;
+}
+
+crypto::Sha256State BlockTemplate::midstate_for_extranonce(uint64_t extranonce) const noexcept {
+    return header_for_extranonce(extranonce).compute_midstate();
+}
+
 std::array<uint8_t, constants::JOB_MESSAGE_SIZE> BlockTemplate::create_job(
     uint32_t job_id
 ) const noexcept {
@@ -149,6 +285,60 @@ std::array<uint8_t, constants::JOB_MESSAGE_SIZE> BlockTemplate::create_job(
     return job;
 }
 
+// =============================================================================
+// BlockSkeleton
+// =============================================================================
+
+BlockSkeleton::BlockSkeleton(const BlockTemplate& block_template)
+    : height_(block_template.height)
+{
+    const Bytes& coinbase = block_template.coinbase_tx;
+    if (coinbase.size() < COINBASE_EXTRANONCE_OFFSET + constants::EXTRANONCE_SIZE) {
+        return;
+    }
+    
+    auto header = block_template.header.serialize();
+    bytes_.reserve(COINBASE_OFFSET + coinbase.size());
+    bytes_.insert(bytes_.end(), header.begin(), header.end());
+    bytes_.push_back(0x01);  // varint: одна транзакция
+    bytes_.insert(bytes_.end(), coinbase.begin(), coinbase.end());
+    
+    coinbase_midstate_ = (block_template.coinbase_midstate == crypto::Sha256State{})
+        ? crypto::compute_midstate(coinbase.data())
+        : block_template.coinbase_midstate;
+}
+
+Bytes BlockSkeleton::build(
+    uint64_t extranonce,
+    uint32_t version,
+    uint32_t timestamp,
+    uint32_t nonce
+) const {
+    Bytes block = bytes_;
+    if (block.empty()) {
+        return block;
+    }
+    
+    uint8_t* coinbase = block.data() + COINBASE_OFFSET;
+    write_extranonce(coinbase + COINBASE_EXTRANONCE_OFFSET, extranonce);
+    
+    // Merkle root пустого блока = txid coinbase (первые 64 байта не меняются)
+    constexpr std::size_t prefix = constants::SHA256_BLOCK_SIZE;
+    Hash256 merkle_root = crypto::sha256d_resume(
+        coinbase_midstate_,
+        prefix,
+        ByteSpan(coinbase + prefix, block.size() - COINBASE_OFFSET - prefix)
+    );
+    std::memcpy(block.data() + MERKLE_ROOT_OFFSET, merkle_root.data(), merkle_root.size());
+    
+    if (version != 0) {
+        write_le32(block.data() + VERSION_OFFSET, version);
+    }
+    write_le32(block.data() + TIMESTAMP_OFFSET, timestamp);
+    write_le32(block.data() + NONCE_OFFSET, nonce);
+    return block;
+}
+
 // =============================================================================
 // Merkle Root
 // =============================================================================
@@ -168,21 +358,18 @@ Hash256 compute_merkle_root(const std::vector<Hash256>& txids) noexcept {
     std::vector<Hash256> level = txids;
     
     while (level.size() > 1) {
-        std::vector<Hash256> next_level;
-        
-        for (std::size_t i = 0; i < level.size(); i += 2) {
-            Hash256 left = level[i];
-            // Если нечётное количество, дублируем последний элемент
-            Hash256 right = (i + 1 < level.size()) ? level[i + 1] : level[i];
-            
-            // Конкатенация и хеширование
-            std::array<uint8_t, 64> combined{};
-            std::memcpy(combined.data(), left.data(), 32);
-            std::memcpy(combined.data() + 32, right.data(), 32);
-            
-            next_level.push_back(crypto::sha256d(ByteSpan(combined.data(), 64)));
+        // Если нечётное количество, дублируем последний элемент
+        if (level.size() % 2 != 0) {
+            level.push_back(level.back());
         }
         
+        // Пары (left || right) уже лежат подряд: весь уровень - одна пачка
+        std::vector<Hash256> next_level(level.size() / 2);
+        (void)crypto::sha256d64_batch(
+            ByteSpan(level.front().data(), level.size() * sizeof(Hash256)),
+            next_level
+        );
+        
         level = std::move(next_level);
     }
     
@@ -197,4 +384,264 @@ Hash256 compute_merkle_root_single(const Hash256& coinbase_txid) noexcept {
     return coinbase_txid;
 }
 
+namespace {
+
+/// @brief Начальная субсидия (50 BTC)
+constexpr int64_t INITIAL_SUBSIDY = 50'00000000LL;
+
+/**
+ * @brief Курсор разбора транзакций блока (без исключений)
+ */
+class TxReader {
+public:
+    explicit TxReader(ByteSpan data, std::size_t pos) noexcept
+        : data_(data), pos_(pos) {}
+    
+    [[nodiscard]] std::size_t pos() const noexcept { return pos_; }
+    [[nodiscard]] bool ok() const noexcept { return ok_; }
+    
+    /// @brief Следующий байт без сдвига (0 за концом данных)
+    [[nodiscard]] uint8_t peek(std::size_t offset = 0) const noexcept {
+        return pos_ + offset < data_.size() ? data_[pos_ + offset] : 0;
+    }
+    
+    void skip(uint64_t count) noexcept {
+        if (!ok_ || count > data_.size() - pos_) {
+            ok_ = false;
+            return;
+        }
+        pos_ += static_cast<std::size_t>(count);
+    }
+    
+    [[nodiscard]] uint64_t read_varint() noexcept {
+        if (!ok_ || pos_ >= data_.size()) {
+            ok_ = false;
+            return 0;
+        }
+        const uint8_t prefix = data_[pos_++];
+        std::size_t width = prefix == 0xFD ? 2 : prefix == 0xFE ? 4 : prefix == 0xFF ? 8 : 0;
+        if (width == 0) {
+            return prefix;
+        }
+        if (width > data_.size() - pos_) {
+            ok_ = false;
+            return 0;
+        }
+        uint64_t value = 0;
+        for (std::size_t i = 0; i < width; ++i) {
+            value |= static_cast<uint64_t>(data_[pos_ + i]) << (8 * i);
+        }
+        pos_ += width;
+        return value;
+    }
+    
+private:
+    ByteSpan data_;
+    std::size_t pos_;
+    bool ok_{true};
+};
+
+/**
+ * @brief Границы транзакции в блоке
+ */
+struct TxBounds {
+    /// @brief Начало и конец сериализации (с witness)
+    std::size_t start{0};
+    std::size_t end{0};
+    
+    /// @brief Входы и выходы (без version, marker / flag, witness, locktime)
+    std::size_t body_start{0};
+    std::size_t body_end{0};
+    
+    bool segwit{false};
+};
+
+/**
+ * @brief Разобрать одну транзакцию
+ */
+std::optional<TxBounds> read_tx_bounds(TxReader& reader) {
+    TxBounds bounds;
+    bounds.start = reader.pos();
+    reader.skip(4);  // version
+    
+    // marker 0x00 + flag 0x01: у legacy транзакции здесь ненулевое число входов
+    bounds.segwit = reader.peek() == 0x00 && reader.peek(1) == 0x01;
+    if (bounds.segwit) {
+        reader.skip(2);
+    }
+    
+    bounds.body_start = reader.pos();
+    const uint64_t inputs = reader.read_varint();
+    for (uint64_t i = 0; i < inputs && reader.ok(); ++i) {
+        reader.skip(36);  // prevout
+        reader.skip(reader.read_varint());  // scriptSig
+        reader.skip(4);  // sequence
+    }
+    const uint64_t outputs = reader.read_varint();
+    for (uint64_t i = 0; i < outputs && reader.ok(); ++i) {
+        reader.skip(8);  // value
+        reader.skip(reader.read_varint());  // scriptPubKey
+    }
+    bounds.body_end = reader.pos();
+    
+    if (bounds.segwit) {
+        for (uint64_t i = 0; i < inputs && reader.ok(); ++i) {
+            const uint64_t items = reader.read_varint();
+            for (uint64_t j = 0; j < items && reader.ok(); ++j) {
+                reader.skip(reader.read_varint());
+            }
+        }
+    }
+    reader.skip(4);  // locktime
+    if (!reader.ok()) {
+        return std::nullopt;
+    }
+    bounds.end = reader.pos();
+    return bounds;
+}
+
+/**
+ * @brief Разобрать одну транзакцию и вычислить её txid
+ */
+std::optional<Hash256> read_txid(ByteSpan block, TxReader& reader) {
+    const auto bounds = read_tx_bounds(reader);
+    if (!bounds) {
+        return std::nullopt;
+    }
+    
+    if (!bounds->segwit) {
+        return crypto::sha256d(block.subspan(bounds->start, bounds->end - bounds->start));
+    }
+    
+    // txid - без marker, flag и witness
+    Bytes stripped;
+    stripped.reserve(bounds->body_end - bounds->body_start + 8);
+    stripped.insert(stripped.end(), block.begin() + static_cast<std::ptrdiff_t>(bounds->start),
+                    block.begin() + static_cast<std::ptrdiff_t>(bounds->start + 4));
+    stripped.insert(stripped.end(), block.begin() + static_cast<std::ptrdiff_t>(bounds->body_start),
+                    block.begin() + static_cast<std::ptrdiff_t>(bounds->body_end));
+    stripped.insert(stripped.end(), block.begin() + static_cast<std::ptrdiff_t>(bounds->end - 4),
+                    block.begin() + static_cast<std::ptrdiff_t>(bounds->end));
+    return crypto::sha256d(stripped);
+}
+
+} // anonymous namespace
+
+Result<Hash256> compute_block_merkle_root(ByteSpan block, bool allow_zero_padding) {
+    if (block.size() < constants::BLOCK_HEADER_SIZE) {
+        return Err<Hash256>(ErrorCode::CryptoInvalidLength, "Блок короче заголовка");
+    }
+    TxReader reader(block, constants::BLOCK_HEADER_SIZE);
+    
+    const uint64_t count = reader.read_varint();
+    if (!reader.ok() || count == 0) {
+        return Err<Hash256>(ErrorCode::CryptoInvalidLength, "Блок без транзакций");
+    }
+    
+    std::vector<Hash256> txids;
+    for (uint64_t i = 0; i < count; ++i) {
+        auto txid = read_txid(block, reader);
+        if (!txid) {
+            return Err<Hash256>(ErrorCode::CryptoInvalidLength, "Обрезанная транзакция в блоке");
+        }
+        txids.push_back(*txid);
+    }
+    const auto tail = block.subspan(reader.pos());
+    const bool padding_only = allow_zero_padding &&
+        std::all_of(tail.begin(), tail.end(), [](uint8_t byte) { return byte == 0; });
+    if (!tail.empty() && !padding_only) {
+        return Err<Hash256>(ErrorCode::CryptoInvalidLength, "Лишние байты после транзакций блока");
+    }
+    return compute_merkle_root(txids);
+}
+
+Result<std::vector<ByteSpan>> block_transactions(ByteSpan block, bool allow_zero_padding) {
+    if (block.size() < constants::BLOCK_HEADER_SIZE) {
+        return Err<std::vector<ByteSpan>>(ErrorCode::CryptoInvalidLength, "Блок короче заголовка");
+    }
+    TxReader reader(block, constants::BLOCK_HEADER_SIZE);
+    
+    const uint64_t count = reader.read_varint();
+    if (!reader.ok() || count == 0) {
+        return Err<std::vector<ByteSpan>>(ErrorCode::CryptoInvalidLength, "Блок без транзакций");
+    }
+    
+    std::vector<ByteSpan> transactions;
+    for (uint64_t i = 0; i < count; ++i) {
+        auto bounds = read_tx_bounds(reader);
+        if (!bounds) {
+            return Err<std::vector<ByteSpan>>(ErrorCode::CryptoInvalidLength, "Обрезанная транзакция в блоке");
+        }
+        transactions.push_back(block.subspan(bounds->start, bounds->end - bounds->start));
+    }
+    const auto tail = block.subspan(reader.pos());
+    const bool padding_only = allow_zero_padding &&
+        std::all_of(tail.begin(), tail.end(), [](uint8_t byte) { return byte == 0; });
+    if (!tail.empty() && !padding_only) {
+        return Err<std::vector<ByteSpan>>(ErrorCode::CryptoInvalidLength, "Лишние байты после транзакций блока");
+    }
+    return transactions;
+}
+
+Result<Hash256> transaction_txid(ByteSpan tx) {
+    TxReader reader(tx, 0);
+    auto txid = read_txid(tx, reader);
+    if (!txid || reader.pos() != tx.size()) {
+        return Err<Hash256>(ErrorCode::CryptoInvalidLength, "Срез не совпадает с транзакцией");
+    }
+    return *txid;
+}
+
+int64_t block_subsidy(uint32_t height) noexcept {
+    const uint32_t halvings = height / constants::HALVING_INTERVAL;
+    if (halvings >= 64) {
+        return 0;
+    }
+    return INITIAL_SUBSIDY >> halvings;
+}
+
+std::optional<uint32_t> block_coinbase_height(ByteSpan block) noexcept {
+    if (block.size() < constants::BLOCK_HEADER_SIZE) {
+        return std::nullopt;
+    }
+    TxReader reader(block, constants::BLOCK_HEADER_SIZE);
+    if (reader.read_varint() == 0) {
+        return std::nullopt;
+    }
+    reader.skip(4);  // version
+    if (reader.peek() == 0x00 && reader.peek(1) == 0x01) {
+        reader.skip(2);  // segwit marker / flag
+    }
+    if (reader.read_varint() != 1) {
+        return std::nullopt;
+    }
+    reader.skip(36);  // prevout
+    const uint64_t script_size = reader.read_varint();
+    if (!reader.ok() || script_size == 0) {
+        return std::nullopt;
+    }
+    
+    // CScript() << height: OP_0, OP_1..OP_16 или push до 4 байт (LE)
+    const uint8_t opcode = reader.peek();
+    if (opcode == 0x00) {
+        return 0;
+    }
+    if (opcode >= 0x51 && opcode <= 0x60) {
+        return static_cast<uint32_t>(opcode - 0x50);
+    }
+    if (opcode > 4 || opcode >= script_size) {
+        return std::nullopt;
+    }
+    reader.skip(1 + static_cast<uint64_t>(opcode));
+    if (!reader.ok()) {
+        return std::nullopt;
+    }
+    uint32_t height = 0;
+    const std::size_t start = reader.pos() - opcode;
+    for (std::size_t i = 0; i < opcode; ++i) {
+        height |= static_cast<uint32_t>(block[start + i]) << (8 * i);
+    }
+    return height;
+}
+
 } // namespace quaxis::bitcoin
@@ -21,6 +21,8 @@
 
 #include <array>
 #include <cstdint>
+#include <optional>
+#include <span>
 
 namespace quaxis::bitcoin {
 
@@ -140,11 +142,72 @@ struct BlockTemplate {
      * @brief Обновить midstate после изменения extranonce
      * 
      * Пересчитывает merkle_root и header_midstate.
+     * Coinbase txid досчитывается от coinbase_midstate: первые 64 байта
+     * coinbase не содержат extranonce и повторно не хешируются.
      * 
      * @param extranonce Новое значение extranonce (6 байт)
      */
     void update_extranonce(uint64_t extranonce) noexcept;
     
+    /**
+     * @brief Вычислить merkle_root для заданного extranonce
+     * 
+     * Не изменяет шаблон: хвост coinbase копируется во временный буфер
+     * на стеке, поэтому вызов безопасен для разделяемого шаблона и
+     * не выделяет память в куче (для coinbase до 64 + 256 байт).
+     * 
+     * @param extranonce Значение extranonce (6 байт)
+     * @return Hash256 Merkle root (для пустого блока = coinbase txid)
+     */
+    [[nodiscard]] Hash256 merkle_root_for_extranonce(uint64_t extranonce) const noexcept;
+    
+    /**
+     * @brief Заголовок с merkle_root для заданного extranonce
+     * 
+     * Не изменяет шаблон (см. merkle_root_for_extranonce()).
+     * 
+     * @param extranonce Значение extranonce (6 байт)
+     * @return BlockHeader Копия заголовка шаблона
+     */
+    [[nodiscard]] BlockHeader header_for_extranonce(uint64_t extranonce) const noexcept;
+    
+    /**
+     * @brief Вычислить midstate заголовка для заданного extranonce
+     * 
+     * Аналог update_extranonce() без изменения шаблона.
+     * 
+     * @param extranonce Значение extranonce (6 байт)
+     * @return crypto::Sha256State Midstate первых 64 байт заголовка
+     */
+    [[nodiscard]] crypto::Sha256State midstate_for_extranonce(uint64_t extranonce) const noexcept;
+    
+    /**
+     * @brief merkle_root_for_extranonce() для пакета extranonce
+     * 
+     * Хвосты coinbase всех extranonce одной длины: сжатия идут блок за
+     * блоком сразу для всех coinbase (crypto::sha256_transform_batch).
+     * 
+     * @param extranonces Значения extranonce
+     * @param out Merkle roots (min(extranonces.size(), out.size()))
+     */
+    void merkle_roots_for_extranonces(
+        std::span<const uint64_t> extranonces,
+        std::span<Hash256> out
+    ) const;
+    
+    /**
+     * @brief Midstate заголовков шаблона с подставленными merkle roots
+     * 
+     * Пакетный аналог header_for_extranonce(...).compute_midstate().
+     * 
+     * @param merkle_roots Merkle root каждого заголовка
+     * @param out Midstate первых 64 байт (min(merkle_roots.size(), out.size()))
+     */
+    void midstates_for_merkle_roots(
+        std::span<const Hash256> merkle_roots,
+        std::span<crypto::Sha256State> out
+    ) const;
+    
     /**
      * @brief Создать задание для ASIC
      * 
@@ -156,6 +219,68 @@ struct BlockTemplate {
     ) const noexcept;
 };
 
+// =============================================================================
+// Скелет найденного блока
+// =============================================================================
+
+/**
+ * @brief Заранее сериализованный блок шаблона
+ * 
+ * Блоки пустые, поэтому весь блок - заголовок, число транзакций (1) и
+ * coinbase. Скелет сериализуется один раз на шаблон; для найденного
+ * share в копию дописываются extranonce (в coinbase и merkle_root),
+ * version, timestamp и nonce - без сборки блока из полей шаблона.
+ */
+class BlockSkeleton {
+public:
+    /// @brief Смещения полей в сериализованном блоке
+    static constexpr std::size_t VERSION_OFFSET = 0;
+    static constexpr std::size_t MERKLE_ROOT_OFFSET = 36;
+    static constexpr std::size_t TIMESTAMP_OFFSET = 68;
+    static constexpr std::size_t NONCE_OFFSET = 76;
+    static constexpr std::size_t COINBASE_OFFSET = constants::BLOCK_HEADER_SIZE + 1;
+    
+    BlockSkeleton() = default;
+    
+    /**
+     * @brief Сериализовать шаблон
+     * 
+     * @param block_template Шаблон (extranonce в coinbase не важен)
+     */
+    explicit BlockSkeleton(const BlockTemplate& block_template);
+    
+    /**
+     * @brief Скелет не построен (нет шаблона или coinbase без extranonce)
+     */
+    [[nodiscard]] bool empty() const noexcept { return bytes_.empty(); }
+    
+    /**
+     * @brief Высота блока шаблона
+     */
+    [[nodiscard]] uint32_t height() const noexcept { return height_; }
+    
+    /**
+     * @brief Собрать найденный блок
+     * 
+     * @param extranonce Extranonce задания (6 байт)
+     * @param version Версия из слота задания (0 - версия шаблона)
+     * @param timestamp Timestamp задания
+     * @param nonce Найденный nonce
+     * @return Bytes Сериализованный блок (пустой, если скелета нет)
+     */
+    [[nodiscard]] Bytes build(
+        uint64_t extranonce,
+        uint32_t version,
+        uint32_t timestamp,
+        uint32_t nonce
+    ) const;
+    
+private:
+    Bytes bytes_;
+    crypto::Sha256State coinbase_midstate_{};
+    uint32_t height_ = 0;
+};
+
 // =============================================================================
 // Вспомогательные функции
 // =============================================================================
@@ -179,4 +304,63 @@ struct BlockTemplate {
  */
 [[nodiscard]] Hash256 compute_merkle_root_single(const Hash256& coinbase_txid) noexcept;
 
+/**
+ * @brief Merkle root транзакций сериализованного блока
+ * 
+ * Разбирает транзакции после 80-байтного заголовка (legacy и segwit)
+ * и считает txid без witness данных. Используется для проверки тела
+ * блока, полученного по relay, против merkle_root заголовка.
+ * 
+ * @param block Сериализованный блок (header + транзакции)
+ * @param allow_zero_padding Допустить нулевой хвост после транзакций
+ *        (последний чанк, восстановленный FEC, дополнен нулями)
+ * @return Merkle root или ошибку, если блок обрезан или есть лишние байты
+ */
+[[nodiscard]] Result<Hash256> compute_block_merkle_root(
+    ByteSpan block,
+    bool allow_zero_padding = false
+);
+
+/**
+ * @brief Транзакции сериализованного блока
+ * 
+ * Полные сериализации (с witness) в порядке блока - по ним считаются
+ * wtxid и short id компактного блока.
+ * 
+ * @param block Сериализованный блок (header + транзакции)
+ * @param allow_zero_padding Допустить нулевой хвост после транзакций
+ * @return Срезы транзакций внутри block или ошибку разбора
+ */
+[[nodiscard]] Result<std::vector<ByteSpan>> block_transactions(
+    ByteSpan block,
+    bool allow_zero_padding = false
+);
+
+/**
+ * @brief Txid одной сериализованной транзакции
+ * 
+ * У segwit транзакции хешируется сериализация без marker, flag и
+ * witness. Транзакции блока независимы: txid можно считать параллельно
+ * по срезам из block_transactions.
+ * 
+ * @param tx Ровно одна транзакция
+ * @return Txid или ошибку, если tx обрезана или длиннее транзакции
+ */
+[[nodiscard]] Result<Hash256> transaction_txid(ByteSpan tx);
+
+/**
+ * @brief Субсидия блока на высоте height (без комиссий), сатоши
+ */
+[[nodiscard]] int64_t block_subsidy(uint32_t height) noexcept;
+
+/**
+ * @brief Высота блока из BIP34 префикса scriptSig coinbase
+ * 
+ * Читает только начало первой транзакции, без разбора остальных.
+ * 
+ * @param block Сериализованный блок (header + транзакции)
+ * @return Высота или nullopt (блок обрезан, scriptSig без высоты)
+ */
+[[nodiscard]] std::optional<uint32_t> block_coinbase_height(ByteSpan block) noexcept;
+
 } // namespace quaxis::bitcoin
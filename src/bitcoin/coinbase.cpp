@@ -7,10 +7,60 @@
 #include "address.hpp"
 #include "../core/byte_order.hpp"
 
+#include <algorithm>
+#include <array>
 #include <cstring>
 
 namespace quaxis::bitcoin {
 
+// =============================================================================
+// CoinbaseTemplate
+// =============================================================================
+
+CoinbaseTemplate::CoinbaseTemplate(ByteSpan prefix, std::size_t extranonce_size, ByteSpan suffix)
+    : extranonce_offset_(prefix.size())
+    , extranonce_size_(extranonce_size)
+{
+    bytes_.reserve(prefix.size() + extranonce_size + suffix.size());
+    bytes_.insert(bytes_.end(), prefix.begin(), prefix.end());
+    bytes_.resize(bytes_.size() + extranonce_size, 0);
+    bytes_.insert(bytes_.end(), suffix.begin(), suffix.end());
+    
+    // Сворачиваются только блоки целиком до extranonce
+    hashed_size_ = prefix.size() - prefix.size() % constants::SHA256_BLOCK_SIZE;
+    rehash_prefix();
+}
+
+void CoinbaseTemplate::rehash_prefix() noexcept {
+    prefix_state_ = constants::SHA256_INIT;
+    for (std::size_t offset = 0; offset < hashed_size_; offset += constants::SHA256_BLOCK_SIZE) {
+        crypto::sha256_transform(prefix_state_, bytes_.data() + offset);
+    }
+}
+
+void CoinbaseTemplate::patch(std::size_t offset, ByteSpan data) noexcept {
+    if (offset >= bytes_.size()) {
+        return;
+    }
+    const std::size_t size = std::min(data.size(), bytes_.size() - offset);
+    std::memcpy(bytes_.data() + offset, data.data(), size);
+    if (offset < hashed_size_) {
+        rehash_prefix();
+    }
+}
+
+void CoinbaseTemplate::set_extranonce(ByteSpan data) noexcept {
+    std::memcpy(extranonce_data(), data.data(), std::min(data.size(), extranonce_size_));
+}
+
+Hash256 CoinbaseTemplate::txid() const noexcept {
+    return crypto::sha256d_resume(
+        prefix_state_,
+        hashed_size_,
+        ByteSpan(bytes_.data() + hashed_size_, bytes_.size() - hashed_size_)
+    );
+}
+
 // =============================================================================
 // CoinbaseBuilder
 // =============================================================================
@@ -25,6 +75,9 @@ CoinbaseBuilder::CoinbaseBuilder(
     if (coinbase_tag_.size() > constants::COINBASE_TAG_SIZE) {
         coinbase_tag_.resize(constants::COINBASE_TAG_SIZE);
     }
+    
+    // Постоянные части сериализуются один раз, build() только правит поля
+    base_ = serialize(0, 0, 0);
 }
 
 Result<CoinbaseBuilder> CoinbaseBuilder::from_address(
@@ -44,6 +97,72 @@ Bytes CoinbaseBuilder::build(
     uint32_t height,
     int64_t value,
     uint64_t extranonce
+) const {
+    Bytes tx = base_;
+    write_fields(tx.data(), height, value, extranonce);
+    return tx;
+}
+
+CoinbaseTemplate CoinbaseBuilder::make_template(
+    uint32_t height,
+    int64_t value,
+    uint64_t extranonce
+) const {
+    const ByteSpan base(base_.data(), base_.size());
+    constexpr std::size_t suffix_offset = EXTRANONCE_OFFSET + constants::EXTRANONCE_SIZE;
+    CoinbaseTemplate tmpl(
+        base.first(EXTRANONCE_OFFSET),
+        constants::EXTRANONCE_SIZE,
+        base.subspan(suffix_offset)
+    );
+    update_template(tmpl, height, value, extranonce);
+    return tmpl;
+}
+
+void CoinbaseBuilder::update_template(
+    CoinbaseTemplate& tmpl,
+    uint32_t height,
+    int64_t value,
+    uint64_t extranonce
+) noexcept {
+    std::array<uint8_t, 3> height_bytes{};
+    for (std::size_t i = 0; i < height_bytes.size(); ++i) {
+        height_bytes[i] = static_cast<uint8_t>(height >> (i * 8));
+    }
+    // Высота в свёрнутом блоке: правка только если она сменилась
+    if (std::memcmp(tmpl.bytes().data() + HEIGHT_OFFSET, height_bytes.data(), height_bytes.size()) != 0) {
+        tmpl.patch(HEIGHT_OFFSET, height_bytes);
+    }
+    
+    std::array<uint8_t, 8> value_bytes{};
+    write_le64(value_bytes.data(), static_cast<uint64_t>(value));
+    tmpl.patch(VALUE_OFFSET, value_bytes);
+    
+    uint8_t* dest = tmpl.extranonce_data();
+    for (std::size_t i = 0; i < constants::EXTRANONCE_SIZE; ++i) {
+        dest[i] = static_cast<uint8_t>(extranonce >> (i * 8));
+    }
+}
+
+void CoinbaseBuilder::write_fields(
+    uint8_t* tx,
+    uint32_t height,
+    int64_t value,
+    uint64_t extranonce
+) noexcept {
+    for (std::size_t i = 0; i < 3; ++i) {
+        tx[HEIGHT_OFFSET + i] = static_cast<uint8_t>(height >> (i * 8));
+    }
+    for (std::size_t i = 0; i < constants::EXTRANONCE_SIZE; ++i) {
+        tx[EXTRANONCE_OFFSET + i] = static_cast<uint8_t>(extranonce >> (i * 8));
+    }
+    write_le64(tx + VALUE_OFFSET, static_cast<uint64_t>(value));
+}
+
+Bytes CoinbaseBuilder::serialize(
+    uint32_t height,
+    int64_t value,
+    uint64_t extranonce
 ) const {
     Bytes tx;
     tx.reserve(constants::COINBASE_SIZE);
@@ -70,9 +189,9 @@ Bytes CoinbaseBuilder::build(
     tx.push_back(0xFF);
     tx.push_back(0xFF);
     
-    // [41] scriptsig_len = 26 байт (0x1A)
-    // scriptsig = height_push(1) + height(3) + tag(6) + padding(10) + extranonce(6) = 26
-    tx.push_back(0x1A);
+    // [41] scriptsig_len = 28 байт (0x1C)
+    // scriptsig = height_push(1) + height(3) + tag(6) + padding(12) + extranonce(6) = 28
+    tx.push_back(static_cast<uint8_t>(CoinbaseLayout{}.scriptsig_length()));
     
     // [42] height_push = OP_PUSH3 (0x03) - высота занимает 3 байта
     tx.push_back(0x03);
@@ -92,9 +211,7 @@ Bytes CoinbaseBuilder::build(
     }
     
     // [52-63] padding (12 байт нулей чтобы заполнить до 64 байт)
-    for (int i = 0; i < 12; ++i) {
-        tx.push_back(0x00);
-    }
+    tx.insert(tx.end(), CoinbaseLayout::PADDING_SIZE, 0x00);
     
     // === ЧАСТЬ 2: Следующие 46 байт (содержит extranonce) ===
     
@@ -14,7 +14,7 @@
  * [4]      input_count     = 01
  * [5-36]   prev_tx_hash    = 00 × 32
  * [37-40]  prev_tx_index   = FF FF FF FF
- * [41]     scriptsig_len   = 1A (26 байт)
+ * [41]     scriptsig_len   = 1C (28 байт)
  * [42]     height_push     = 03
  * [43-45]  height          = XX XX XX (LE)
  * [46-51]  "quaxis"        = 71 75 61 78 69 73
@@ -28,6 +28,10 @@
  * [83]     script_len      = 16 (22 байта)
  * [84-105] scriptPubKey    = 00 14 [pubkey_hash × 20]
  * [106-109] locktime       = 00 00 00 00
+ * 
+ * Раскладку задаёт CoinbaseLayout: в первом блоке только поля,
+ * постоянные за жизнь блока, изменяемые внутри блока (extranonce, AuxPoW
+ * commitment merged mining) начинаются с границы 64 байт.
  */
 
 #pragma once
@@ -41,6 +45,162 @@
 
 namespace quaxis::bitcoin {
 
+// =============================================================================
+// Coinbase Template
+// =============================================================================
+
+/**
+ * @brief Сериализованная coinbase с midstate префикса
+ * 
+ * Coinbase = prefix | extranonce | suffix. Байты хранятся подряд, целые
+ * 64-байтные блоки префикса свёрнуты в prefix_state(). Новые высота,
+ * награда и extranonce - правка байт на месте: сериализация не
+ * повторяется, midstate пересчитывается, только если правка задела
+ * свёрнутые блоки. txid() сжимает лишь хвост после свёрнутых блоков.
+ * 
+ * Общая форма для coinbase соло режима (CoinbaseBuilder::make_template)
+ * и coinb1 | extranonce1 | extranonce2 | coinb2 пула Stratum.
+ */
+class CoinbaseTemplate {
+public:
+    CoinbaseTemplate() = default;
+    
+    /**
+     * @param prefix Байты до extranonce
+     * @param extranonce_size Размер места под extranonce (заполняется нулями)
+     * @param suffix Байты после extranonce
+     */
+    CoinbaseTemplate(ByteSpan prefix, std::size_t extranonce_size, ByteSpan suffix);
+    
+    /**
+     * @brief Заменить байты с offset (за пределами coinbase - обрезаются)
+     */
+    void patch(std::size_t offset, ByteSpan data) noexcept;
+    
+    /**
+     * @brief Записать extranonce (первые extranonce_size() байт data)
+     */
+    void set_extranonce(ByteSpan data) noexcept;
+    
+    /**
+     * @brief Место extranonce в coinbase
+     * 
+     * Для горячих циклов, которые кодируют extranonce сами. Место всегда
+     * за свёрнутыми блоками: запись не требует пересчёта midstate.
+     */
+    [[nodiscard]] uint8_t* extranonce_data() noexcept {
+        return bytes_.data() + extranonce_offset_;
+    }
+    
+    /**
+     * @brief txid = SHA256d(coinbase) с продолжением от prefix_state()
+     */
+    [[nodiscard]] Hash256 txid() const noexcept;
+    
+    /// @brief Вся сериализованная coinbase
+    [[nodiscard]] const Bytes& bytes() const noexcept { return bytes_; }
+    
+    /// @brief Состояние SHA256 после первых hashed_size() байт
+    [[nodiscard]] const crypto::Sha256State& prefix_state() const noexcept { return prefix_state_; }
+    
+    /// @brief Байт, свёрнутых в prefix_state() (кратно 64)
+    [[nodiscard]] std::size_t hashed_size() const noexcept { return hashed_size_; }
+    
+    [[nodiscard]] std::size_t extranonce_offset() const noexcept { return extranonce_offset_; }
+    
+    [[nodiscard]] std::size_t extranonce_size() const noexcept { return extranonce_size_; }
+    
+    /// @brief Байты после extranonce (выходы, locktime)
+    [[nodiscard]] ByteSpan suffix() const noexcept {
+        const std::size_t begin = extranonce_offset_ + extranonce_size_;
+        return ByteSpan(bytes_.data() + begin, bytes_.size() - begin);
+    }
+    
+private:
+    /// @brief Свернуть целые блоки префикса заново
+    void rehash_prefix() noexcept;
+    
+    Bytes bytes_;
+    crypto::Sha256State prefix_state_ = constants::SHA256_INIT;
+    std::size_t hashed_size_ = 0;
+    std::size_t extranonce_offset_ = 0;
+    std::size_t extranonce_size_ = 0;
+};
+
+// =============================================================================
+// Coinbase Layout
+// =============================================================================
+
+/**
+ * @brief Раскладка полей coinbase по времени их жизни
+ * 
+ * Первый 64-байтный блок - поля, постоянные за жизнь блока: версия,
+ * вход, длина scriptsig, BIP34 высота, тег и выравнивание нулями до
+ * границы блока. С границы 64 байт - поля, меняющиеся внутри блока:
+ * extranonce (каждое задание), за ним место под AuxPoW commitment
+ * (fabe6d6d + aux root, меняется с шаблонами aux chains), затем
+ * sequence, выходы и locktime. Смена extranonce или aux root
+ * пересчитывает только хвост после coinbase midstate.
+ * 
+ * Длина scriptsig зависит от наличия commitment: его появление или
+ * исчезновение (нет aux chains) меняет первый блок, смена aux root - нет.
+ */
+struct CoinbaseLayout {
+    /// @brief Смещение длины scriptsig
+    static constexpr std::size_t SCRIPTSIG_LEN_OFFSET = 41;
+    
+    /// @brief Смещение BIP34 высоты (после OP_PUSH3)
+    static constexpr std::size_t HEIGHT_OFFSET = SCRIPTSIG_LEN_OFFSET + 2;
+    
+    /// @brief Смещение тега
+    static constexpr std::size_t TAG_OFFSET = HEIGHT_OFFSET + 3;
+    
+    /// @brief Смещение extranonce - начало второго блока SHA256
+    static constexpr std::size_t EXTRANONCE_OFFSET = constants::SHA256_BLOCK_SIZE;
+    
+    /// @brief Нулей между тегом и extranonce
+    static constexpr std::size_t PADDING_SIZE = EXTRANONCE_OFFSET - TAG_OFFSET - constants::COINBASE_TAG_SIZE;
+    
+    /// @brief Смещение AuxPoW commitment (сразу за extranonce)
+    static constexpr std::size_t COMMITMENT_OFFSET = EXTRANONCE_OFFSET + constants::EXTRANONCE_SIZE;
+    
+    /// @brief Размер commitment в scriptsig (0 - без merged mining)
+    std::size_t commitment_size{0};
+    
+    /// @brief Длина scriptsig (от OP_PUSH3 высоты до конца commitment)
+    [[nodiscard]] constexpr std::size_t scriptsig_length() const noexcept {
+        return COMMITMENT_OFFSET + commitment_size - (SCRIPTSIG_LEN_OFFSET + 1);
+    }
+    
+    /// @brief Смещение sequence входа
+    [[nodiscard]] constexpr std::size_t sequence_offset() const noexcept {
+        return COMMITMENT_OFFSET + commitment_size;
+    }
+    
+    /// @brief Смещение числа выходов
+    [[nodiscard]] constexpr std::size_t output_count_offset() const noexcept {
+        return sequence_offset() + 4;
+    }
+    
+    /// @brief Смещение награды (value первого выхода)
+    [[nodiscard]] constexpr std::size_t value_offset() const noexcept {
+        return output_count_offset() + 1;
+    }
+    
+    /// @brief Размер coinbase с одним P2WPKH выходом
+    [[nodiscard]] constexpr std::size_t size() const noexcept {
+        return value_offset() + 8 + 1 + 22 + 4;
+    }
+    
+    /// @brief Байт, постоянных за жизнь блока (свёрнуты в midstate)
+    [[nodiscard]] static constexpr std::size_t fixed_size() noexcept {
+        return EXTRANONCE_OFFSET;
+    }
+};
+
+static_assert(CoinbaseLayout{}.size() == constants::COINBASE_SIZE);
+static_assert(CoinbaseLayout::TAG_OFFSET + constants::COINBASE_TAG_SIZE <= CoinbaseLayout::EXTRANONCE_OFFSET);
+
 // =============================================================================
 // Coinbase Builder
 // =============================================================================
@@ -79,6 +239,36 @@ public:
         std::string_view coinbase_tag = "quaxis"
     );
     
+    /// @brief Смещения изменяемых полей coinbase (CoinbaseLayout без commitment)
+    static constexpr std::size_t HEIGHT_OFFSET = CoinbaseLayout::HEIGHT_OFFSET;
+    static constexpr std::size_t EXTRANONCE_OFFSET = CoinbaseLayout::EXTRANONCE_OFFSET;
+    static constexpr std::size_t VALUE_OFFSET = CoinbaseLayout{}.value_offset();
+    
+    /**
+     * @brief Coinbase как шаблон для правок на месте
+     * 
+     * Префикс - первые 64 байта (один блок, свёрнут в midstate),
+     * extranonce - 6 байт со смещения 64, суффикс - sequence, выход, locktime.
+     */
+    [[nodiscard]] CoinbaseTemplate make_template(
+        uint32_t height,
+        int64_t value,
+        uint64_t extranonce
+    ) const;
+    
+    /**
+     * @brief Подставить высоту, награду и extranonce в шаблон make_template()
+     * 
+     * Смена высоты пересчитывает midstate (одно сжатие), награда и
+     * extranonce лежат за свёрнутым блоком.
+     */
+    static void update_template(
+        CoinbaseTemplate& tmpl,
+        uint32_t height,
+        int64_t value,
+        uint64_t extranonce
+    ) noexcept;
+    
     /**
      * @brief Построить coinbase транзакцию
      * 
@@ -120,11 +310,20 @@ public:
     }
     
 private:
+    /// @brief Сериализовать coinbase целиком
+    [[nodiscard]] Bytes serialize(uint32_t height, int64_t value, uint64_t extranonce) const;
+    
+    /// @brief Записать изменяемые поля в готовую coinbase
+    static void write_fields(uint8_t* tx, uint32_t height, int64_t value, uint64_t extranonce) noexcept;
+    
     /// @brief 20-байтный хеш публичного ключа для P2WPKH
     Hash160 pubkey_hash_;
     
     /// @brief Тег coinbase (обычно "quaxis")
     std::string coinbase_tag_;
+    
+    /// @brief Coinbase с нулевыми высотой, наградой и extranonce
+    Bytes base_;
 };
 
 // =============================================================================
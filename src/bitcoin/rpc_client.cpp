@@ -8,10 +8,15 @@
 
 #include "rpc_client.hpp"
 #include "../core/byte_order.hpp"
+#include "../core/serialization/json.hpp"
 
 #include <curl/curl.h>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
 #include <format>
-#include <sstream>
+#include <mutex>
+#include <thread>
 
 namespace quaxis::bitcoin {
 
@@ -24,6 +29,16 @@ struct RpcClient::Impl {
     std::string auth;  // Base64 encoded "user:password"
     CURL* curl = nullptr;
     
+    // set_abort_flag(): запрос прерывается, когда флаг поднят
+    const std::atomic<bool>* abort = nullptr;
+    
+    // Заголовки (с Authorization) собираются один раз, буферы запроса и
+    // ответа переиспользуются; handle не сбрасывается - соединение с
+    // нодой остаётся открытым (keep-alive) между вызовами
+    struct curl_slist* headers = nullptr;
+    std::string request;
+    std::string response;
+    
     Impl(const RpcConfig& config) {
         url = config.get_url();
         
@@ -31,6 +46,12 @@ struct RpcClient::Impl {
         std::string credentials = config.user + ":" + config.password;
         auth = base64_encode(credentials);
         
+        // "Expect:" отключает 100-continue: submitblock с телом больше
+        // 1 КБ иначе ждёт ответа ноды лишний RTT
+        headers = curl_slist_append(headers, "Content-Type: application/json");
+        headers = curl_slist_append(headers, ("Authorization: Basic " + auth).c_str());
+        headers = curl_slist_append(headers, "Expect:");
+        
         curl = curl_easy_init();
         if (curl) {
             // Установка базовых опций
@@ -38,6 +59,10 @@ struct RpcClient::Impl {
             curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
             curl_easy_setopt(curl, CURLOPT_TIMEOUT, static_cast<long>(config.timeout));
             curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, 5L);
+            curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+            curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+            curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_callback);
+            curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
         }
     }
     
@@ -45,6 +70,7 @@ struct RpcClient::Impl {
         if (curl) {
             curl_easy_cleanup(curl);
         }
+        curl_slist_free_all(headers);
     }
     
     /**
@@ -83,6 +109,14 @@ struct RpcClient::Impl {
         return result;
     }
     
+    /**
+     * @brief Callback прогресса: ненулевой результат прерывает запрос
+     */
+    static int progress_callback(void* data, curl_off_t, curl_off_t, curl_off_t, curl_off_t) {
+        const auto* flag = static_cast<const std::atomic<bool>*>(data);
+        return flag->load(std::memory_order_relaxed) ? 1 : 0;
+    }
+    
     /**
      * @brief Callback для записи ответа
      */
@@ -101,30 +135,23 @@ struct RpcClient::Impl {
         }
         
         // Формируем JSON-RPC запрос
-        std::string request = std::format(
-            R"({{"jsonrpc":"1.0","id":"quaxis","method":"{}","params":{}}})",
-            method, params
-        );
+        request.clear();
+        request.append(R"({"jsonrpc":"1.0","id":"quaxis","method":")");
+        request.append(method);
+        request.append(R"(","params":)");
+        request.append(params);
+        request.push_back('}');
         
-        // Заголовки
-        struct curl_slist* headers = nullptr;
-        headers = curl_slist_append(headers, "Content-Type: application/json");
-        std::string auth_header = std::format("Authorization: Basic {}", auth);
-        headers = curl_slist_append(headers, auth_header.c_str());
-        
-        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
         curl_easy_setopt(curl, CURLOPT_POSTFIELDS, request.c_str());
         curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, static_cast<long>(request.size()));
         
-        // Буфер для ответа
-        std::string response;
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_callback);
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
-        
         // Выполняем запрос
+        response.clear();
         CURLcode res = curl_easy_perform(curl);
-        curl_slist_free_all(headers);
         
+        if (res == CURLE_ABORTED_BY_CALLBACK) {
+            return Err<std::string>(ErrorCode::RpcConnectionFailed, "RPC запрос прерван");
+        }
         if (res != CURLE_OK) {
             return Err<std::string>(
                 ErrorCode::RpcConnectionFailed,
@@ -151,86 +178,24 @@ struct RpcClient::Impl {
     }
     
     /**
-     * @brief Простой парсер JSON для извлечения значения по ключу
-     * 
-     * Минималистичный парсер, не использует внешние библиотеки.
-     * Подходит для простых случаев RPC ответов.
+     * @brief Поле result ответа (Invalid, если ответа нет)
      */
-    static std::string extract_string(const std::string& json, std::string_view key) {
-        std::string search = std::format("\"{}\":", key);
-        auto pos = json.find(search);
-        if (pos == std::string::npos) return "";
-        
-        pos += search.size();
-        
-        // Пропускаем пробелы
-        while (pos < json.size() && std::isspace(json[pos])) ++pos;
-        
-        if (pos >= json.size()) return "";
-        
-        if (json[pos] == '"') {
-            // Строковое значение
-            ++pos;
-            auto end = json.find('"', pos);
-            if (end == std::string::npos) return "";
-            return json.substr(pos, end - pos);
-        } else if (json[pos] == '{' || json[pos] == '[') {
-            // Объект или массив - ищем соответствующую закрывающую скобку
-            char open = json[pos];
-            char close = (open == '{') ? '}' : ']';
-            int depth = 1;
-            auto start = pos;
-            ++pos;
-            while (pos < json.size() && depth > 0) {
-                if (json[pos] == open) ++depth;
-                else if (json[pos] == close) --depth;
-                else if (json[pos] == '"') {
-                    // Пропускаем строки
-                    ++pos;
-                    while (pos < json.size() && json[pos] != '"') {
-                        if (json[pos] == '\\') ++pos;
-                        ++pos;
-                    }
-                }
-                ++pos;
-            }
-            return json.substr(start, pos - start);
-        } else {
-            // Число, bool или null
-            auto end = json.find_first_of(",}]", pos);
-            if (end == std::string::npos) end = json.size();
-            auto result = json.substr(pos, end - pos);
-            // Убираем trailing whitespace
-            while (!result.empty() && std::isspace(result.back())) {
-                result.pop_back();
-            }
-            return result;
-        }
-    }
-    
-    static int64_t extract_int(const std::string& json, std::string_view key) {
-        auto str = extract_string(json, key);
-        if (str.empty()) return 0;
-        try {
-            return std::stoll(str);
-        } catch (...) {
-            return 0;
-        }
+    static core::json::Value result_of(const std::string& response) {
+        return core::json::Value::parse(response)["result"];
     }
     
-    static double extract_double(const std::string& json, std::string_view key) {
-        auto str = extract_string(json, key);
-        if (str.empty()) return 0.0;
-        try {
-            return std::stod(str);
-        } catch (...) {
-            return 0.0;
-        }
+    /**
+     * @brief Текст ошибки RPC из поля error
+     */
+    static std::string error_of(const std::string& response) {
+        return std::string(core::json::Value::parse(response)["error"].raw());
     }
     
-    static bool extract_bool(const std::string& json, std::string_view key) {
-        auto str = extract_string(json, key);
-        return str == "true";
+    /**
+     * @brief 64 hex символа в Hash256 (хеш отображается в reversed формате)
+     */
+    static bool parse_hash(std::string_view hex, Hash256& out) {
+        return hex.size() == 64 && hex_decode_reversed(hex, out.data());
     }
 };
 
@@ -255,20 +220,19 @@ Result<BlockchainInfo> RpcClient::get_blockchain_info() {
     }
     
     // Извлекаем result
-    auto result = Impl::extract_string(*response, "result");
-    if (result.empty()) {
-        auto error = Impl::extract_string(*response, "error");
-        return Err<BlockchainInfo>(ErrorCode::RpcInternalError, error);
+    auto result = Impl::result_of(*response);
+    if (result.type() != core::json::Type::Object) {
+        return Err<BlockchainInfo>(ErrorCode::RpcInternalError, Impl::error_of(*response));
     }
     
     BlockchainInfo info;
-    info.chain = Impl::extract_string(result, "chain");
-    info.blocks = static_cast<uint32_t>(Impl::extract_int(result, "blocks"));
-    info.headers = static_cast<uint32_t>(Impl::extract_int(result, "headers"));
-    info.best_blockhash = Impl::extract_string(result, "bestblockhash");
-    info.difficulty = Impl::extract_double(result, "difficulty");
-    info.median_time = static_cast<uint64_t>(Impl::extract_int(result, "mediantime"));
-    info.initial_block_download = Impl::extract_bool(result, "initialblockdownload");
+    info.chain = std::string(result["chain"].as_string().value_or(""));
+    info.blocks = static_cast<uint32_t>(result["blocks"].as_int64().value_or(0));
+    info.headers = static_cast<uint32_t>(result["headers"].as_int64().value_or(0));
+    info.best_blockhash = std::string(result["bestblockhash"].as_string().value_or(""));
+    info.difficulty = result["difficulty"].as_double().value_or(0.0);
+    info.median_time = static_cast<uint64_t>(result["mediantime"].as_int64().value_or(0));
+    info.initial_block_download = result["initialblockdownload"].as_bool().value_or(false);
     
     return info;
 }
@@ -279,57 +243,60 @@ Result<Hash256> RpcClient::get_best_block_hash() {
         return Err<Hash256>(response.error().code, response.error().message);
     }
     
-    auto result = Impl::extract_string(*response, "result");
-    if (result.empty() || result.size() != 64) {
-        return Err<Hash256>(ErrorCode::RpcParseError, "Неверный формат хеша блока");
-    }
-    
     // Конвертируем hex в Hash256
     Hash256 hash{};
-    for (std::size_t i = 0; i < 32; ++i) {
-        std::string byte_str = result.substr(i * 2, 2);
-        // Хеш отображается в reversed формате
-        hash[31 - i] = static_cast<uint8_t>(std::stoul(byte_str, nullptr, 16));
+    auto result = Impl::result_of(*response).as_string();
+    if (!result || !Impl::parse_hash(*result, hash)) {
+        return Err<Hash256>(ErrorCode::RpcParseError, "Неверный формат хеша блока");
     }
     
     return hash;
 }
 
-Result<BlockTemplateData> RpcClient::get_block_template() {
-    // Параметры для getblocktemplate
-    std::string params = R"([{"rules":["segwit"]}])";
+Result<BlockTemplateData> RpcClient::get_block_template(std::string_view longpoll_id) {
+    // Параметры для getblocktemplate; longpollid - ответ при смене шаблона
+    std::string params = R"([{"rules":["segwit"])";
+    if (!longpoll_id.empty()) {
+        params.append(R"(,"longpollid":")").append(longpoll_id).push_back('"');
+    }
+    params.append("}]");
     
     auto response = impl_->call("getblocktemplate", params);
     if (!response) {
         return Err<BlockTemplateData>(response.error().code, response.error().message);
     }
     
-    auto result = Impl::extract_string(*response, "result");
-    if (result.empty()) {
-        auto error = Impl::extract_string(*response, "error");
-        return Err<BlockTemplateData>(ErrorCode::RpcInternalError, error);
+    auto result = Impl::result_of(*response);
+    if (result.type() != core::json::Type::Object) {
+        return Err<BlockTemplateData>(ErrorCode::RpcInternalError, Impl::error_of(*response));
     }
     
-    BlockTemplateData data;
-    data.version = static_cast<uint32_t>(Impl::extract_int(result, "version"));
-    data.curtime = static_cast<uint32_t>(Impl::extract_int(result, "curtime"));
-    data.height = static_cast<uint32_t>(Impl::extract_int(result, "height"));
-    data.coinbase_value = Impl::extract_int(result, "coinbasevalue");
-    data.target = Impl::extract_string(result, "target");
-    data.mintime = static_cast<uint64_t>(Impl::extract_int(result, "mintime"));
-    
-    // bits в hex формате
-    auto bits_hex = Impl::extract_string(result, "bits");
-    if (bits_hex.size() == 8) {
-        data.bits = static_cast<uint32_t>(std::stoul(bits_hex, nullptr, 16));
-    }
-    
-    // previousblockhash
-    auto prev_hash_hex = Impl::extract_string(result, "previousblockhash");
-    if (prev_hash_hex.size() == 64) {
-        for (std::size_t i = 0; i < 32; ++i) {
-            std::string byte_str = prev_hash_hex.substr(i * 2, 2);
-            data.prev_blockhash[31 - i] = static_cast<uint8_t>(std::stoul(byte_str, nullptr, 16));
+    // Один проход по членам: transactions (основная часть ответа)
+    // пропускается один раз, а не на каждое поле
+    BlockTemplateData data{};
+    for (const auto& [key, value] : result.members()) {
+        if (key == "version") {
+            data.version = static_cast<uint32_t>(value.as_int64().value_or(0));
+        } else if (key == "curtime") {
+            data.curtime = static_cast<uint32_t>(value.as_int64().value_or(0));
+        } else if (key == "height") {
+            data.height = static_cast<uint32_t>(value.as_int64().value_or(0));
+        } else if (key == "coinbasevalue") {
+            data.coinbase_value = value.as_int64().value_or(0);
+        } else if (key == "target") {
+            data.target = std::string(value.as_string().value_or(""));
+        } else if (key == "mintime") {
+            data.mintime = static_cast<uint64_t>(value.as_int64().value_or(0));
+        } else if (key == "bits") {
+            // bits в hex формате
+            auto bits_hex = value.as_string().value_or("");
+            if (bits_hex.size() == 8) {
+                std::from_chars(bits_hex.data(), bits_hex.data() + 8, data.bits, 16);
+            }
+        } else if (key == "previousblockhash") {
+            (void)Impl::parse_hash(value.as_string().value_or(""), data.prev_blockhash);
+        } else if (key == "longpollid") {
+            data.longpollid = std::string(value.as_string().value_or(""));
         }
     }
     
@@ -337,23 +304,24 @@ Result<BlockTemplateData> RpcClient::get_block_template() {
 }
 
 Result<void> RpcClient::submit_block(std::string_view block_hex) {
-    std::string params = std::format("[\"{}\"]", block_hex);
+    std::string params;
+    params.reserve(block_hex.size() + 4);
+    params.append("[\"").append(block_hex).append("\"]");
     
     auto response = impl_->call("submitblock", params);
     if (!response) {
         return Err<void>(response.error().code, response.error().message);
     }
     
-    // Проверяем результат
-    auto result = Impl::extract_string(*response, "result");
-    
-    // null означает успех
-    if (result == "null" || result.empty()) {
+    // Проверяем результат: null означает успех
+    auto result = Impl::result_of(*response);
+    if (!result || result.is_null()) {
         return {};
     }
     
     // Иначе это ошибка
-    return Err<void>(ErrorCode::MiningBlockRejected, result);
+    return Err<void>(ErrorCode::MiningBlockRejected,
+                     std::string(result.as_string().value_or(result.raw())));
 }
 
 Result<void> RpcClient::ping() {
@@ -364,4 +332,143 @@ Result<void> RpcClient::ping() {
     return {};
 }
 
+void RpcClient::set_abort_flag(const std::atomic<bool>* abort) {
+    impl_->abort = abort;
+    if (!impl_->curl) {
+        return;
+    }
+    if (abort) {
+        curl_easy_setopt(impl_->curl, CURLOPT_XFERINFOFUNCTION, &Impl::progress_callback);
+        curl_easy_setopt(impl_->curl, CURLOPT_XFERINFODATA, abort);
+        curl_easy_setopt(impl_->curl, CURLOPT_NOPROGRESS, 0L);
+    } else {
+        curl_easy_setopt(impl_->curl, CURLOPT_NOPROGRESS, 1L);
+    }
+}
+
+// =============================================================================
+// RpcLongPoller
+// =============================================================================
+
+namespace {
+
+/// @brief Пауза после ошибки и между опросами узла без longpoll
+constexpr auto LONGPOLL_RETRY = std::chrono::seconds(1);
+
+/// @brief Конфигурация соединения longpoll: таймаут запроса - longpoll_timeout
+RpcConfig longpoll_config(const RpcConfig& config) {
+    RpcConfig result = config;
+    result.timeout = config.longpoll_timeout;
+    return result;
+}
+
+} // anonymous namespace
+
+struct RpcLongPoller::Impl {
+    RpcClient client;
+    RpcTemplateCallback callback;
+    
+    std::atomic<bool> running{false};
+    
+    // Поднимается в stop(): прерывает висящий запрос и паузу
+    std::atomic<bool> abort{false};
+    
+    std::atomic<bool> connected{false};
+    std::atomic<bool> longpolling{false};
+    std::atomic<uint64_t> templates{0};
+    
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::thread thread;
+    
+    explicit Impl(const RpcConfig& config) : client(longpoll_config(config)) {
+        client.set_abort_flag(&abort);
+    }
+    
+    void run() {
+        std::string longpoll_id;
+        while (!abort.load(std::memory_order_relaxed)) {
+            auto data = client.get_block_template(longpoll_id);
+            if (abort.load(std::memory_order_relaxed)) {
+                return;
+            }
+            if (!data) {
+                // Узел недоступен или таймаут: подписка заново
+                connected.store(false, std::memory_order_relaxed);
+                longpoll_id.clear();
+                pause();
+                continue;
+            }
+            
+            connected.store(true, std::memory_order_relaxed);
+            longpolling.store(!data->longpollid.empty(), std::memory_order_relaxed);
+            if (callback) {
+                callback(*data);
+            }
+            templates.fetch_add(1, std::memory_order_relaxed);
+            
+            longpoll_id = std::move(data->longpollid);
+            if (longpoll_id.empty()) {
+                pause();  // Узел без longpoll - опрос
+            }
+        }
+    }
+    
+    void pause() {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait_for(lock, LONGPOLL_RETRY, [this] { return abort.load(std::memory_order_relaxed); });
+    }
+};
+
+RpcLongPoller::RpcLongPoller(const RpcConfig& config)
+    : impl_(std::make_unique<Impl>(config))
+{
+}
+
+RpcLongPoller::~RpcLongPoller() {
+    stop();
+}
+
+void RpcLongPoller::set_callback(RpcTemplateCallback callback) {
+    impl_->callback = std::move(callback);
+}
+
+void RpcLongPoller::start() {
+    if (impl_->running.exchange(true)) {
+        return;
+    }
+    impl_->abort.store(false, std::memory_order_relaxed);
+    impl_->thread = std::thread([this] { impl_->run(); });
+}
+
+void RpcLongPoller::stop() {
+    if (!impl_->running.exchange(false)) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(impl_->mutex);
+        impl_->abort.store(true, std::memory_order_relaxed);
+    }
+    impl_->cv.notify_all();
+    if (impl_->thread.joinable()) {
+        impl_->thread.join();
+    }
+}
+
+bool RpcLongPoller::is_running() const noexcept {
+    return impl_->running.load(std::memory_order_relaxed);
+}
+
+bool RpcLongPoller::is_connected() const noexcept {
+    return impl_->connected.load(std::memory_order_relaxed);
+}
+
+bool RpcLongPoller::is_longpolling() const noexcept {
+    return impl_->longpolling.load(std::memory_order_relaxed);
+}
+
+uint64_t RpcLongPoller::templates_received() const noexcept {
+    return impl_->templates.load(std::memory_order_relaxed);
+}
+
 } // namespace quaxis::bitcoin
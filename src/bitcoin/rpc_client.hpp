@@ -11,6 +11,11 @@
  * - submitblock: отправка найденного блока
  * - getblockchaininfo: информация о блокчейне
  * - getbestblockhash: хеш лучшего блока
+ * 
+ * RpcLongPoller держит getblocktemplate longpoll (BIP 22/23) на отдельном
+ * соединении: узел отвечает на запрос с longpollid только при новом tip
+ * (или обновлении mempool), и шаблон доставляется сразу, а не через
+ * интервал опроса.
  */
 
 #pragma once
@@ -18,6 +23,7 @@
 #include "../core/types.hpp"
 #include "block.hpp"
 
+#include <atomic>
 #include <memory>
 #include <functional>
 #include <optional>
@@ -49,6 +55,9 @@ struct RpcConfig {
     /// @brief Таймаут в секундах
     uint32_t timeout = 30;
     
+    /// @brief Таймаут longpoll запроса (секунды): узел держит его до нового блока
+    uint32_t longpoll_timeout = 120;
+    
     /**
      * @brief Получить URL для RPC запросов
      */
@@ -87,6 +96,7 @@ struct BlockTemplateData {
     std::string target;        ///< Target в hex
     uint64_t mintime;          ///< Минимальный допустимый timestamp
     std::vector<std::string> transactions;  ///< Транзакции в hex (для полного блока)
+    std::string longpollid;    ///< Идентификатор для longpoll (пусто - узел без longpoll)
 };
 
 // =============================================================================
@@ -141,9 +151,11 @@ public:
     /**
      * @brief Получить шаблон блока для майнинга
      * 
+     * @param longpoll_id longpollid прошлого шаблона: узел ответит, когда
+     *        шаблон изменится (пусто - ответ сразу)
      * @return Result<BlockTemplateData> Шаблон или ошибка
      */
-    [[nodiscard]] Result<BlockTemplateData> get_block_template();
+    [[nodiscard]] Result<BlockTemplateData> get_block_template(std::string_view longpoll_id = {});
     
     /**
      * @brief Отправить найденный блок
@@ -160,6 +172,82 @@ public:
      */
     [[nodiscard]] Result<void> ping();
     
+    /**
+     * @brief Прерывать запросы, пока *abort == true
+     * 
+     * Флаг проверяется во время передачи (не реже раза в секунду), поэтому
+     * висящий longpoll снимается без ожидания таймаута.
+     * 
+     * @param abort Флаг (живёт дольше клиента) или nullptr
+     */
+    void set_abort_flag(const std::atomic<bool>* abort);
+    
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+// =============================================================================
+// Longpoll
+// =============================================================================
+
+/**
+ * @brief Callback при новом шаблоне от узла
+ */
+using RpcTemplateCallback = std::function<void(const BlockTemplateData&)>;
+
+/**
+ * @brief getblocktemplate longpoll в отдельном потоке
+ * 
+ * Своё соединение с таймаутом RpcConfig::longpoll_timeout: submitblock и
+ * прочие вызовы основного RpcClient не ждут за висящим запросом. Первый
+ * шаблон запрашивается сразу, следующие - с longpollid предыдущего.
+ * Узел без longpollid и ошибки возвращают к опросу раз в секунду.
+ */
+class RpcLongPoller {
+public:
+    explicit RpcLongPoller(const RpcConfig& config);
+    
+    /**
+     * @brief Деструктор - останавливает поток
+     */
+    ~RpcLongPoller();
+    
+    RpcLongPoller(const RpcLongPoller&) = delete;
+    RpcLongPoller& operator=(const RpcLongPoller&) = delete;
+    
+    /**
+     * @brief Установить callback (до start(); вызывается из потока опроса)
+     */
+    void set_callback(RpcTemplateCallback callback);
+    
+    /**
+     * @brief Запустить поток
+     */
+    void start();
+    
+    /**
+     * @brief Остановить поток, прервав висящий запрос
+     */
+    void stop();
+    
+    [[nodiscard]] bool is_running() const noexcept;
+    
+    /**
+     * @brief Последний запрос к узлу успешен
+     */
+    [[nodiscard]] bool is_connected() const noexcept;
+    
+    /**
+     * @brief Узел поддерживает longpoll (последний шаблон с longpollid)
+     */
+    [[nodiscard]] bool is_longpolling() const noexcept;
+    
+    /**
+     * @brief Получено шаблонов
+     */
+    [[nodiscard]] uint64_t templates_received() const noexcept;
+    
 private:
     struct Impl;
     std::unique_ptr<Impl> impl_;
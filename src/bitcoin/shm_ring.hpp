@@ -0,0 +1,355 @@
+/**
+ * @file shm_ring.hpp
+ * @brief Кольцо событий блоков в shared memory
+ *
+ * QuaxisSharedBlock хранит ровно один заголовок: если издатель успел
+ * записать несколько состояний (speculative, confirmed, конкурирующий
+ * tip) до пробуждения подписчика, промежуточные события теряются.
+ *
+ * QuaxisSharedRing хранит последние SHM_RING_SLOTS событий:
+ * - Событие с номером seq (1, 2, ...) пишется в слот seq % SHM_RING_SLOTS
+ * - Слот защищён seqlock'ом с версией, привязанной к номеру события:
+ *   2 * seq - 1 во время записи, 2 * seq после. По версии читатель
+ *   отличает своё событие от перезаписанного более новым
+ * - sequence - номер последнего опубликованного события; это же слово
+ *   служит futex для гибридного ожидания (shm::publish_sequence)
+ *
+ * Читатель получает события строго по порядку. Если издатель обогнал
+ * его больше чем на размер кольца, пропущенные события считаются
+ * (overrun), а чтение продолжается с самого старого сохранившегося.
+ *
+ * Как и в JobTable, содержимое слота копируется relaxed-операциями над
+ * std::atomic<uint64_t> между двумя чтениями версии.
+ */
+
+#pragma once
+
+#include "../core/types.hpp"
+#include "../shm/sequence_futex.hpp"
+
+#include <atomic>
+#include <cstring>
+#include <type_traits>
+
+namespace quaxis::bitcoin {
+
+// =============================================================================
+// Константы Shared Memory
+// =============================================================================
+
+/**
+ * @brief Состояние блока в shared memory
+ */
+enum class ShmBlockState : uint8_t {
+    Empty = 0,       ///< Нет данных
+    Speculative = 1, ///< Spy mining: блок получен, но не валидирован
+    Confirmed = 2,   ///< Блок полностью валидирован
+    Invalid = 3      ///< Блок оказался невалидным
+};
+
+/// @brief Сигнатура сегмента-кольца ("QRNG")
+inline constexpr uint32_t SHM_RING_MAGIC = 0x474E5251;
+
+/// @brief Версия раскладки кольца
+inline constexpr uint32_t SHM_RING_LAYOUT_VERSION = 1;
+
+/// @brief Слотов в кольце
+inline constexpr std::size_t SHM_RING_SLOTS = 16;
+
+// =============================================================================
+// Одиночный блок (исходная раскладка)
+// =============================================================================
+
+/**
+ * @brief Структура данных в shared memory
+ * 
+ * Выравнивание по 64-байтным cache lines для избежания false sharing.
+ */
+struct alignas(64) QuaxisSharedBlock {
+    /// @brief Атомарный sequence counter для детекции изменений
+    alignas(64) std::atomic<uint64_t> sequence;
+    
+    /// @brief Состояние блока
+    alignas(64) std::atomic<uint8_t> state;
+    
+    /// @brief Заголовок блока (80 байт)
+    alignas(64) uint8_t header_raw[80];
+    
+    /// @brief Высота блока
+    uint32_t height;
+    
+    /// @brief Compact target (bits)
+    uint32_t bits;
+    
+    /// @brief Timestamp блока
+    uint32_t timestamp;
+    
+    /// @brief Padding для выравнивания
+    uint32_t reserved;
+    
+    /// @brief Награда за блок (satoshi)
+    int64_t coinbase_value;
+    
+    /// @brief Хеш блока
+    uint8_t block_hash[32];
+};
+
+// Размер структуры увеличен до 512 байт из-за выравнивания полей по 64-байтным cache lines
+// (alignas(64) на sequence, state и header_raw добавляет padding)
+static_assert(sizeof(QuaxisSharedBlock) <= 512, "QuaxisSharedBlock превышает 512 байт");
+
+// =============================================================================
+// Раскладка кольца
+// =============================================================================
+
+/**
+ * @brief Событие блока (содержимое слота)
+ */
+struct ShmBlockEvent {
+    /// @brief Номер события (1, 2, ...)
+    uint64_t sequence{0};
+
+    /// @brief Состояние блока
+    ShmBlockState state{ShmBlockState::Empty};
+
+    uint8_t reserved[3]{};
+
+    /// @brief Высота блока
+    uint32_t height{0};
+
+    /// @brief Compact target (bits)
+    uint32_t bits{0};
+
+    /// @brief Timestamp блока
+    uint32_t timestamp{0};
+
+    /// @brief Награда за блок (satoshi)
+    int64_t coinbase_value{0};
+
+    /// @brief Заголовок блока (80 байт)
+    uint8_t header_raw[80]{};
+
+    /// @brief Хеш блока
+    uint8_t block_hash[32]{};
+};
+
+static_assert(std::is_trivially_copyable_v<ShmBlockEvent>,
+              "ShmBlockEvent должен быть trivially copyable для seqlock");
+
+/**
+ * @brief Слот кольца с seqlock
+ */
+struct alignas(64) ShmRingSlot {
+    /// @brief Количество 64-битных слов под событие
+    static constexpr std::size_t WORDS = (sizeof(ShmBlockEvent) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    /// @brief 2 * seq - 1 во время записи события seq, 2 * seq после
+    std::atomic<uint64_t> version;
+
+    std::atomic<uint64_t> words[WORDS];
+};
+
+/**
+ * @brief Сегмент shared memory с кольцом событий
+ *
+ * sequence лежит в начале, как и в QuaxisSharedBlock; в старой раскладке
+ * байты 8..63 - padding (нули), поэтому по magic раскладки различимы.
+ */
+struct alignas(64) QuaxisSharedRing {
+    /// @brief Номер последнего опубликованного события (слово futex)
+    std::atomic<uint64_t> sequence;
+
+    /// @brief SHM_RING_MAGIC
+    uint32_t magic;
+
+    /// @brief SHM_RING_LAYOUT_VERSION
+    uint32_t layout_version;
+
+    /// @brief SHM_RING_SLOTS
+    uint32_t slot_count;
+
+    /// @brief Слоты событий
+    alignas(64) ShmRingSlot slots[SHM_RING_SLOTS];
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "атомики в shared memory должны быть lock-free");
+
+/**
+ * @brief Проверить, что память - инициализированное кольцо
+ */
+[[nodiscard]] inline bool is_shm_ring(const QuaxisSharedRing& ring) noexcept {
+    return ring.magic == SHM_RING_MAGIC
+        && ring.layout_version == SHM_RING_LAYOUT_VERSION
+        && ring.slot_count == SHM_RING_SLOTS;
+}
+
+/**
+ * @brief Разметить обнулённую память как пустое кольцо
+ */
+inline void init_shm_ring(QuaxisSharedRing& ring) noexcept {
+    ring.magic = SHM_RING_MAGIC;
+    ring.layout_version = SHM_RING_LAYOUT_VERSION;
+    ring.slot_count = static_cast<uint32_t>(SHM_RING_SLOTS);
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+// =============================================================================
+// Писатель
+// =============================================================================
+
+/**
+ * @brief Издатель событий (патч Bitcoin Core, тесты)
+ *
+ * Писатель один; читателей может быть сколько угодно, они не пишут
+ * в сегмент.
+ */
+class ShmRingWriter {
+public:
+    explicit ShmRingWriter(QuaxisSharedRing& ring) noexcept : ring_(ring) {}
+
+    /**
+     * @brief Опубликовать событие и разбудить подписчиков
+     *
+     * @param event Событие (поле sequence заполняется здесь)
+     * @return uint64_t Номер события
+     */
+    uint64_t publish(ShmBlockEvent event) noexcept {
+        const uint64_t seq = ring_.sequence.load(std::memory_order_relaxed) + 1;
+        event.sequence = seq;
+
+        uint64_t buf[ShmRingSlot::WORDS]{};
+        std::memcpy(buf, &event, sizeof(event));
+
+        ShmRingSlot& slot = ring_.slots[seq % SHM_RING_SLOTS];
+        slot.version.store(2 * seq - 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (std::size_t w = 0; w < ShmRingSlot::WORDS; ++w) {
+            slot.words[w].store(buf[w], std::memory_order_relaxed);
+        }
+        slot.version.store(2 * seq, std::memory_order_release);
+
+        ring_.sequence.store(seq, std::memory_order_release);
+        shm::wake_sequence(ring_.sequence);
+        return seq;
+    }
+
+private:
+    QuaxisSharedRing& ring_;
+};
+
+// =============================================================================
+// Читатель
+// =============================================================================
+
+/**
+ * @brief Подписчик на события кольца (по порядку, с детекцией overrun)
+ */
+class ShmRingReader {
+public:
+    /**
+     * @brief Начать чтение с событий, опубликованных после создания
+     */
+    explicit ShmRingReader(const QuaxisSharedRing& ring) noexcept
+        : ring_(ring)
+        , next_(ring.sequence.load(std::memory_order_acquire) + 1)
+    {}
+
+    /**
+     * @brief Начать чтение с события first (1 - с самого старого)
+     */
+    ShmRingReader(const QuaxisSharedRing& ring, uint64_t first) noexcept
+        : ring_(ring)
+        , next_(first == 0 ? 1 : first)
+    {}
+
+    /**
+     * @brief Доставить все новые события по порядку
+     *
+     * @param fn Функция void(const ShmBlockEvent&)
+     * @return std::size_t Количество доставленных событий
+     */
+    template<typename Fn>
+    std::size_t drain(Fn&& fn) {
+        std::size_t delivered = 0;
+        ShmBlockEvent event;
+        for (;;) {
+            const uint64_t head = ring_.sequence.load(std::memory_order_acquire);
+            if (next_ > head) {
+                return delivered;
+            }
+            if (head - next_ >= SHM_RING_SLOTS) {
+                // Издатель обогнал читателя на кольцо: старые слоты перезаписаны
+                const uint64_t oldest = head - SHM_RING_SLOTS + 1;
+                lost_.fetch_add(oldest - next_, std::memory_order_relaxed);
+                next_ = oldest;
+            }
+            if (!read(next_, event)) {
+                // Слот уже занят более новым событием
+                lost_.fetch_add(1, std::memory_order_relaxed);
+                ++next_;
+                continue;
+            }
+            ++next_;
+            ++delivered;
+            fn(event);
+        }
+    }
+
+    /**
+     * @brief Номер последнего опубликованного события
+     */
+    [[nodiscard]] uint64_t head() const noexcept {
+        return ring_.sequence.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Номер следующего ожидаемого события
+     */
+    [[nodiscard]] uint64_t next_sequence() const noexcept {
+        return next_;
+    }
+
+    /**
+     * @brief События, перезаписанные до прочтения
+     */
+    [[nodiscard]] uint64_t lost_events() const noexcept {
+        return lost_.load(std::memory_order_relaxed);
+    }
+
+private:
+    /**
+     * @brief Прочитать событие seq
+     *
+     * @return false если слот перезаписан событием новее seq
+     */
+    [[nodiscard]] bool read(uint64_t seq, ShmBlockEvent& event) const noexcept {
+        const ShmRingSlot& slot = ring_.slots[seq % SHM_RING_SLOTS];
+        const uint64_t expected = 2 * seq;
+        uint64_t buf[ShmRingSlot::WORDS];
+        for (;;) {
+            const uint64_t v1 = slot.version.load(std::memory_order_acquire);
+            if (v1 > expected) {
+                return false;
+            }
+            if (v1 != expected) {
+                continue;  // Писатель в процессе записи
+            }
+            for (std::size_t w = 0; w < ShmRingSlot::WORDS; ++w) {
+                buf[w] = slot.words[w].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.version.load(std::memory_order_relaxed) == v1) {
+                break;
+            }
+        }
+        std::memcpy(&event, buf, sizeof(event));
+        return true;
+    }
+
+    const QuaxisSharedRing& ring_;
+    uint64_t next_;
+    std::atomic<uint64_t> lost_{0};
+};
+
+} // namespace quaxis::bitcoin
@@ -0,0 +1,293 @@
+/**
+ * @file shm_submit.hpp
+ * @brief Кольцо отправки найденных блоков майнер -> узел в shared memory
+ *
+ * Сегменты блока и шаблона идут только от узла к майнеру; найденный блок
+ * уходил в узел через RPC submitblock (hex, libcurl, разбор JSON на
+ * стороне bitcoind). QuaxisSharedSubmit - обратный канал: майнер пишет
+ * заголовок и coinbase (блоки майнера пустые, см. BlockSkeleton), плагин
+ * узла забирает их и отдаёт в ProcessNewBlock за микросекунды. RPC
+ * остаётся параллельным каналом и подтверждением.
+ *
+ * Раскладка - как у QuaxisSharedRing: событие seq пишется в слот
+ * seq % SHM_SUBMIT_SLOTS под seqlock с версией 2 * seq - 1 / 2 * seq,
+ * sequence - последнее опубликованное событие и слово futex. Писатель
+ * один (майнер), читатель один (узел); читатель публикует в consumed
+ * номер последнего забранного события. Блок не должен теряться, поэтому
+ * писатель не перезаписывает незабранные слоты: при полном кольце
+ * (узел не читает) publish() отказывает, и блок уходит только по RPC.
+ */
+
+#pragma once
+
+#include "../core/types.hpp"
+#include "../core/constants.hpp"
+#include "../shm/sequence_futex.hpp"
+
+#include <atomic>
+#include <cstring>
+#include <type_traits>
+
+namespace quaxis::bitcoin {
+
+// =============================================================================
+// Константы кольца отправки
+// =============================================================================
+
+/// @brief Сигнатура сегмента отправки ("QSUB")
+inline constexpr uint32_t SHM_SUBMIT_MAGIC = 0x42555351;
+
+/// @brief Версия раскладки сегмента отправки
+inline constexpr uint32_t SHM_SUBMIT_LAYOUT_VERSION = 1;
+
+/// @brief Слотов в кольце
+inline constexpr std::size_t SHM_SUBMIT_SLOTS = 8;
+
+/// @brief Максимальный размер coinbase в слоте
+inline constexpr std::size_t SHM_SUBMIT_MAX_COINBASE = 2048;
+
+// =============================================================================
+// Раскладка
+// =============================================================================
+
+/**
+ * @brief Найденный блок (содержимое слота)
+ *
+ * Блок = header_raw | 0x01 (одна транзакция) | coinbase.
+ */
+struct ShmSubmitEvent {
+    /// @brief Номер события (1, 2, ...)
+    uint64_t sequence{0};
+
+    /// @brief Длина coinbase
+    uint32_t coinbase_size{0};
+
+    uint32_t reserved{0};
+
+    /// @brief Заголовок блока (80 байт)
+    uint8_t header_raw[constants::BLOCK_HEADER_SIZE]{};
+
+    /// @brief Хеш блока
+    uint8_t block_hash[32]{};
+
+    /// @brief Сериализованная coinbase
+    uint8_t coinbase[SHM_SUBMIT_MAX_COINBASE]{};
+};
+
+static_assert(std::is_trivially_copyable_v<ShmSubmitEvent>,
+              "ShmSubmitEvent должен быть trivially copyable для seqlock");
+
+/**
+ * @brief Слот кольца отправки с seqlock
+ */
+struct alignas(64) ShmSubmitSlot {
+    /// @brief Количество 64-битных слов под событие
+    static constexpr std::size_t WORDS = (sizeof(ShmSubmitEvent) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    /// @brief 2 * seq - 1 во время записи события seq, 2 * seq после
+    std::atomic<uint64_t> version;
+
+    std::atomic<uint64_t> words[WORDS];
+};
+
+/**
+ * @brief Сегмент shared memory с кольцом отправки
+ */
+struct alignas(64) QuaxisSharedSubmit {
+    /// @brief Номер последнего опубликованного блока (пишет майнер, слово futex)
+    std::atomic<uint64_t> sequence;
+
+    /// @brief SHM_SUBMIT_MAGIC
+    uint32_t magic;
+
+    /// @brief SHM_SUBMIT_LAYOUT_VERSION
+    uint32_t layout_version;
+
+    /// @brief SHM_SUBMIT_SLOTS
+    uint32_t slot_count;
+
+    /// @brief Номер последнего забранного блока (пишет узел)
+    alignas(64) std::atomic<uint64_t> consumed;
+
+    /// @brief Слоты
+    alignas(64) ShmSubmitSlot slots[SHM_SUBMIT_SLOTS];
+};
+
+/**
+ * @brief Проверить, что память - инициализированный сегмент отправки
+ */
+[[nodiscard]] inline bool is_shm_submit(const QuaxisSharedSubmit& segment) noexcept {
+    return segment.magic == SHM_SUBMIT_MAGIC
+        && segment.layout_version == SHM_SUBMIT_LAYOUT_VERSION
+        && segment.slot_count == SHM_SUBMIT_SLOTS;
+}
+
+/**
+ * @brief Разметить обнулённую память как пустое кольцо отправки
+ */
+inline void init_shm_submit(QuaxisSharedSubmit& segment) noexcept {
+    segment.magic = SHM_SUBMIT_MAGIC;
+    segment.layout_version = SHM_SUBMIT_LAYOUT_VERSION;
+    segment.slot_count = static_cast<uint32_t>(SHM_SUBMIT_SLOTS);
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+/**
+ * @brief Сериализованный блок события: заголовок, 0x01, coinbase
+ */
+[[nodiscard]] inline Bytes submit_event_block(const ShmSubmitEvent& event) {
+    Bytes block;
+    block.reserve(constants::BLOCK_HEADER_SIZE + 1 + event.coinbase_size);
+    block.insert(block.end(), event.header_raw, event.header_raw + constants::BLOCK_HEADER_SIZE);
+    block.push_back(0x01);
+    block.insert(block.end(), event.coinbase, event.coinbase + event.coinbase_size);
+    return block;
+}
+
+// =============================================================================
+// Писатель (майнер)
+// =============================================================================
+
+/**
+ * @brief Публикация найденных блоков
+ *
+ * Писатель один: вызовы publish() не должны пересекаться.
+ */
+class ShmSubmitWriter {
+public:
+    explicit ShmSubmitWriter(QuaxisSharedSubmit& segment) noexcept : segment_(segment) {}
+
+    /**
+     * @brief Опубликовать блок и разбудить узел
+     *
+     * @param event Блок (поле sequence заполняется здесь)
+     * @return uint64_t Номер события или 0 (кольцо полно: узел не забрал
+     *         SHM_SUBMIT_SLOTS блоков, либо coinbase не помещается)
+     */
+    uint64_t publish(ShmSubmitEvent& event) noexcept {
+        const uint64_t seq = segment_.sequence.load(std::memory_order_relaxed) + 1;
+        if (event.coinbase_size > SHM_SUBMIT_MAX_COINBASE ||
+            seq - segment_.consumed.load(std::memory_order_acquire) > SHM_SUBMIT_SLOTS) {
+            return 0;
+        }
+        event.sequence = seq;
+
+        uint64_t buf[ShmSubmitSlot::WORDS]{};
+        std::memcpy(buf, &event, sizeof(event));
+
+        ShmSubmitSlot& slot = segment_.slots[seq % SHM_SUBMIT_SLOTS];
+        slot.version.store(2 * seq - 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (std::size_t w = 0; w < ShmSubmitSlot::WORDS; ++w) {
+            slot.words[w].store(buf[w], std::memory_order_relaxed);
+        }
+        slot.version.store(2 * seq, std::memory_order_release);
+
+        segment_.sequence.store(seq, std::memory_order_release);
+        shm::wake_sequence(segment_.sequence);
+        return seq;
+    }
+
+    /**
+     * @brief Опубликовано, но не забрано узлом
+     */
+    [[nodiscard]] uint64_t pending() const noexcept {
+        return segment_.sequence.load(std::memory_order_relaxed) -
+               segment_.consumed.load(std::memory_order_acquire);
+    }
+
+private:
+    QuaxisSharedSubmit& segment_;
+};
+
+// =============================================================================
+// Читатель (плагин узла)
+// =============================================================================
+
+/**
+ * @brief Приём найденных блоков на стороне узла
+ *
+ * Начинает с первого незабранного блока: блоки, опубликованные до
+ * запуска узла, не теряются (пока помещаются в кольцо).
+ */
+class ShmSubmitReader {
+public:
+    explicit ShmSubmitReader(QuaxisSharedSubmit& segment) noexcept
+        : segment_(segment)
+        , next_(segment.consumed.load(std::memory_order_acquire) + 1)
+    {}
+
+    /**
+     * @brief Доставить все новые блоки по порядку и отметить их забранными
+     *
+     * @param fn Функция void(const ShmSubmitEvent&)
+     * @return std::size_t Количество доставленных блоков
+     */
+    template<typename Fn>
+    std::size_t drain(Fn&& fn) {
+        std::size_t delivered = 0;
+        for (;;) {
+            if (next_ > segment_.sequence.load(std::memory_order_acquire)) {
+                return delivered;
+            }
+            const bool ok = read(next_, event_);
+            segment_.consumed.store(next_, std::memory_order_release);
+            ++next_;
+            if (!ok) {
+                ++corrupted_;
+                continue;
+            }
+            ++delivered;
+            fn(event_);
+        }
+    }
+
+    /**
+     * @brief Слоты с чужой версией или неверной длиной coinbase (пропущены)
+     */
+    [[nodiscard]] uint64_t corrupted() const noexcept {
+        return corrupted_;
+    }
+
+    /**
+     * @brief Номер последнего опубликованного блока (слово futex)
+     */
+    [[nodiscard]] const std::atomic<uint64_t>& sequence() const noexcept {
+        return segment_.sequence;
+    }
+
+private:
+    /**
+     * @brief Прочитать событие seq
+     *
+     * Писатель не трогает слот до consumed >= seq, а sequence публикует
+     * после записи слота: другая версия - только порча сегмента.
+     */
+    [[nodiscard]] bool read(uint64_t seq, ShmSubmitEvent& event) noexcept {
+        const ShmSubmitSlot& slot = segment_.slots[seq % SHM_SUBMIT_SLOTS];
+        const uint64_t expected = 2 * seq;
+        for (;;) {
+            const uint64_t v1 = slot.version.load(std::memory_order_acquire);
+            if (v1 != expected) {
+                return false;
+            }
+            for (std::size_t w = 0; w < ShmSubmitSlot::WORDS; ++w) {
+                buf_[w] = slot.words[w].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.version.load(std::memory_order_relaxed) == v1) {
+                break;
+            }
+        }
+        std::memcpy(&event, buf_, sizeof(event));
+        return event.sequence == seq && event.coinbase_size <= SHM_SUBMIT_MAX_COINBASE;
+    }
+
+    QuaxisSharedSubmit& segment_;
+    uint64_t next_;
+    uint64_t corrupted_{0};
+    uint64_t buf_[ShmSubmitSlot::WORDS]{};
+    ShmSubmitEvent event_{};
+};
+
+} // namespace quaxis::bitcoin
@@ -7,7 +7,13 @@
  */
 
 #include "shm_subscriber.hpp"
+#include "shm_template.hpp"
 #include "../core/byte_order.hpp"
+#include "../core/latency_trace.hpp"
+#include "../core/thread_plan.hpp"
+#include "../shm/adaptive_spin.hpp"
+#include "../shm/placement.hpp"
+#include "../shm/sequence_futex.hpp"
 
 #include <fcntl.h>
 #include <sys/mman.h>
@@ -27,9 +33,18 @@ namespace quaxis::bitcoin {
 struct ShmSubscriber::Impl {
     ShmConfig config;
     NewBlockCallback callback;
+    BlockStateCallback state_callback;
     
     int shm_fd = -1;
-    QuaxisSharedBlock* shm_block = nullptr;
+    void* shm_map = nullptr;
+    std::size_t shm_map_size = 0;
+    
+    /// @brief Одиночный блок (старая раскладка)
+    const QuaxisSharedBlock* shm_block = nullptr;
+    
+    /// @brief Кольцо событий (если сегмент размечен как кольцо)
+    const QuaxisSharedRing* shm_ring = nullptr;
+    std::unique_ptr<ShmRingReader> ring_reader;
     
     std::thread worker_thread;
     std::atomic<bool> running{false};
@@ -38,6 +53,9 @@ struct ShmSubscriber::Impl {
     BlockHeader last_block;
     std::mutex last_block_mutex;
     
+    /// @brief Хеш последнего speculative блока (ждёт confirm / invalid)
+    std::optional<Hash256> speculative_hash;
+    
     explicit Impl(const ShmConfig& cfg) : config(cfg) {}
     
     ~Impl() {
@@ -46,10 +64,14 @@ struct ShmSubscriber::Impl {
     }
     
     void cleanup() {
-        if (shm_block && shm_block != MAP_FAILED) {
-            munmap(shm_block, sizeof(QuaxisSharedBlock));
-            shm_block = nullptr;
+        ring_reader.reset();
+        if (shm_map && shm_map != MAP_FAILED) {
+            munmap(shm_map, shm_map_size);
         }
+        shm_map = nullptr;
+        shm_map_size = 0;
+        shm_block = nullptr;
+        shm_ring = nullptr;
         if (shm_fd >= 0) {
             close(shm_fd);
             shm_fd = -1;
@@ -57,80 +79,184 @@ struct ShmSubscriber::Impl {
     }
     
     Result<void> open_shm() {
-        // Открываем shared memory
-        shm_fd = shm_open(config.path.c_str(), O_RDONLY, 0);
-        if (shm_fd < 0) {
+        // Открываем shared memory (/dev/shm или hugetlbfs)
+        const auto placement = segment_placement(config);
+        auto fd = shm::open_segment(placement, config.path, O_RDONLY);
+        if (!fd) {
+            return std::unexpected(fd.error());
+        }
+        shm_fd = *fd;
+        
+        // Размер сегмента определяет, может ли он быть кольцом
+        struct stat st{};
+        if (fstat(shm_fd, &st) < 0) {
+            close(shm_fd);
+            shm_fd = -1;
             return Err<void>(
                 ErrorCode::ShmOpenFailed,
-                std::format("Не удалось открыть shared memory '{}': {}", 
-                           config.path, strerror(errno))
+                std::format("Не удалось получить размер shared memory: {}", strerror(errno))
             );
         }
+        const auto segment_size = static_cast<std::size_t>(st.st_size);
+        if (segment_size < sizeof(QuaxisSharedBlock)) {
+            close(shm_fd);
+            shm_fd = -1;
+            return Err<void>(
+                ErrorCode::ShmInvalidState,
+                std::format("Сегмент shared memory слишком мал: {} байт", segment_size)
+            );
+        }
+        const std::size_t layout_size = segment_size >= sizeof(QuaxisSharedRing)
+            ? sizeof(QuaxisSharedRing)
+            : sizeof(QuaxisSharedBlock);
+        // На hugetlbfs отображение кратно huge page
+        shm_map_size = shm::segment_map_length(shm_fd, layout_size);
         
         // Маппим в память
-        void* ptr = mmap(nullptr, sizeof(QuaxisSharedBlock), 
+        void* ptr = mmap(nullptr, shm_map_size, 
                         PROT_READ, MAP_SHARED, shm_fd, 0);
         if (ptr == MAP_FAILED) {
             close(shm_fd);
             shm_fd = -1;
+            shm_map_size = 0;
             return Err<void>(
                 ErrorCode::ShmMapFailed,
                 std::format("Не удалось замапить shared memory: {}", strerror(errno))
             );
         }
+        shm_map = ptr;
+        
+        if (placement.numa_node >= 0) {
+            auto bound = shm::bind_to_numa_node(ptr, shm_map_size, placement.numa_node);
+            if (!bound) {
+                cleanup();
+                return bound;
+            }
+        }
         
-        shm_block = static_cast<QuaxisSharedBlock*>(ptr);
+        const auto* ring = static_cast<const QuaxisSharedRing*>(ptr);
+        if (layout_size == sizeof(QuaxisSharedRing) && is_shm_ring(*ring)) {
+            shm_ring = ring;
+            // Как и для одиночного блока, последнее событие доставляется сразу
+            uint64_t head = ring->sequence.load(std::memory_order_acquire);
+            ring_reader = std::make_unique<ShmRingReader>(*ring, head);
+        } else {
+            shm_block = static_cast<const QuaxisSharedBlock*>(ptr);
+        }
         return {};
     }
     
+    [[nodiscard]] const std::atomic<uint64_t>& sequence_word() const noexcept {
+        return shm_ring ? shm_ring->sequence : shm_block->sequence;
+    }
+    
     void worker_loop() {
+        shm::AdaptiveSpinConfig spin_config;
+        spin_config.spin_phase1_iterations = config.spin_phase1_iterations;
+        spin_config.spin_phase2_iterations = config.spin_phase2_iterations;
+        spin_config.sleep_us = config.sleep_us;
+        spin_config.futex_wait = config.futex_wait;
+        spin_config.futex_spin_iterations = config.futex_spin_iterations;
+        spin_config.futex_timeout_us = config.futex_timeout_us;
+        shm::AdaptiveSpinWait waiter(spin_config);
+        
+        const std::atomic<uint64_t>& sequence = sequence_word();
+        
         while (running.load(std::memory_order_relaxed)) {
             // Читаем sequence
-            uint64_t seq = shm_block->sequence.load(std::memory_order_acquire);
+            uint64_t seq = sequence.load(std::memory_order_acquire);
+            uint64_t last = last_sequence.load(std::memory_order_relaxed);
             
-            if (seq != last_sequence.load(std::memory_order_relaxed)) {
+            if (seq != last) {
                 // Новый блок!
-                process_new_block(seq);
-            } else if (!config.adaptive_spin_enabled) {
+                if (ring_reader) {
+                    process_ring_events();
+                } else {
+                    process_new_block(seq);
+                }
+                waiter.reset();
+            } else if (config.adaptive_spin_enabled || config.futex_wait) {
+                // Spin / yield / sleep или spin / futex_wait
+                waiter.wait_step(sequence, last);
+            } else {
                 // Poll режим - ждём
                 std::this_thread::sleep_for(std::chrono::microseconds(config.sleep_us));
-            } else {
-                // Spin-wait - пауза для CPU
-                std::this_thread::yield();
             }
         }
     }
     
+    void process_ring_events() {
+        ring_reader->drain([this](const ShmBlockEvent& event) {
+            dispatch(event);
+        });
+        last_sequence.store(ring_reader->next_sequence() - 1, std::memory_order_relaxed);
+    }
+    
     void process_new_block(uint64_t seq) {
+        // Обновляем sequence до разбора: невалидное состояние не должно
+        // разбираться повторно на каждой итерации
+        last_sequence.store(seq, std::memory_order_relaxed);
+        
         // Читаем данные блока
-        auto state = static_cast<ShmBlockState>(
+        ShmBlockEvent event;
+        event.sequence = seq;
+        event.state = static_cast<ShmBlockState>(
             shm_block->state.load(std::memory_order_acquire)
         );
+        event.height = shm_block->height;
+        event.bits = shm_block->bits;
+        event.timestamp = shm_block->timestamp;
+        event.coinbase_value = shm_block->coinbase_value;
+        std::memcpy(event.header_raw, shm_block->header_raw, sizeof(event.header_raw));
+        std::memcpy(event.block_hash, shm_block->block_hash, sizeof(event.block_hash));
+        
+        dispatch(event);
+    }
+    
+    void dispatch(const ShmBlockEvent& event) {
+        const uint64_t seen_at = core::trace_timestamp();
         
         // Проверяем валидность состояния
-        if (state != ShmBlockState::Speculative && state != ShmBlockState::Confirmed) {
+        if (event.state != ShmBlockState::Speculative
+            && event.state != ShmBlockState::Confirmed
+            && event.state != ShmBlockState::Invalid) {
             return;
         }
         
         // Десериализуем заголовок
-        std::array<uint8_t, 80> header_raw;
-        std::memcpy(header_raw.data(), shm_block->header_raw, 80);
-        
         auto header_result = BlockHeader::deserialize(
-            ByteSpan(header_raw.data(), header_raw.size())
+            ByteSpan(event.header_raw, sizeof(event.header_raw))
         );
         
         if (!header_result) {
             return;  // Ошибка десериализации
         }
         
-        BlockHeader header = *header_result;
-        uint32_t height = shm_block->height;
-        int64_t coinbase_value = shm_block->coinbase_value;
-        bool is_speculative = (state == ShmBlockState::Speculative);
+        const BlockHeader& header = *header_result;
+        Hash256 hash = header.hash();
         
-        // Обновляем sequence
-        last_sequence.store(seq, std::memory_order_relaxed);
+        // Смена состояния уже разосланного speculative блока
+        if (event.state != ShmBlockState::Speculative && speculative_hash == hash) {
+            speculative_hash.reset();
+            if (state_callback) {
+                state_callback(hash, event.height, event.state);
+            }
+            return;
+        }
+        if (event.state == ShmBlockState::Invalid) {
+            // Невалидный блок, который мы не майнили
+            if (state_callback) {
+                state_callback(hash, event.height, event.state);
+            }
+            return;
+        }
+        
+        bool is_speculative = (event.state == ShmBlockState::Speculative);
+        if (is_speculative) {
+            speculative_hash = hash;
+        } else {
+            speculative_hash.reset();
+        }
         
         // Сохраняем последний блок
         {
@@ -138,14 +264,19 @@ struct ShmSubscriber::Impl {
             last_block = header;
         }
         
+        core::trace_block_arrival(core::TraceStage::ShmBlock, hash, seen_at);
+        
         // Вызываем callback
         if (callback) {
-            callback(header, height, coinbase_value, is_speculative);
+            callback(header, event.height, event.coinbase_value, is_speculative);
         }
     }
     
     void stop() {
         running.store(false, std::memory_order_relaxed);
+        if (shm_map && config.futex_wait) {
+            shm::wake_sequence(sequence_word());  // поток может спать в futex_wait
+        }
         if (worker_thread.joinable()) {
             worker_thread.join();
         }
@@ -167,6 +298,10 @@ void ShmSubscriber::set_callback(NewBlockCallback callback) {
     impl_->callback = std::move(callback);
 }
 
+void ShmSubscriber::set_state_callback(BlockStateCallback callback) {
+    impl_->state_callback = std::move(callback);
+}
+
 Result<void> ShmSubscriber::start() {
     if (impl_->running.load()) {
         return {};  // Уже запущен
@@ -181,9 +316,19 @@ Result<void> ShmSubscriber::start() {
     // Запускаем worker thread
     impl_->running.store(true, std::memory_order_relaxed);
     impl_->worker_thread = std::thread([this] {
+        core::enter_thread_role(core::ThreadRole::BlockPath, impl_->config.cpu_affinity >= 0);
         impl_->worker_loop();
     });
     
+    if (impl_->config.cpu_affinity >= 0) {
+        auto pinned = shm::pin_thread_to_cpu(impl_->worker_thread, impl_->config.cpu_affinity);
+        if (!pinned) {
+            impl_->stop();
+            impl_->cleanup();
+            return pinned;
+        }
+    }
+    
     return {};
 }
 
@@ -207,62 +352,247 @@ std::optional<BlockHeader> ShmSubscriber::get_last_block() const {
     return impl_->last_block;
 }
 
+bool ShmSubscriber::is_ring() const noexcept {
+    return impl_->shm_ring != nullptr;
+}
+
+uint64_t ShmSubscriber::lost_events() const noexcept {
+    return impl_->ring_reader ? impl_->ring_reader->lost_events() : 0;
+}
+
 // =============================================================================
 // Фабричные функции
 // =============================================================================
 
-Result<void> create_shm_segment(std::string_view path) {
-    // Создаём shared memory сегмент
-    int fd = shm_open(path.data(), O_CREAT | O_RDWR, 0644);
-    if (fd < 0) {
-        return Err<void>(
-            ErrorCode::ShmOpenFailed,
-            std::format("Не удалось создать shared memory '{}': {}", 
-                       path, strerror(errno))
-        );
+shm::SegmentPlacement segment_placement(const ShmConfig& config) {
+    return shm::SegmentPlacement{config.hugetlb_dir, config.numa_node};
+}
+
+namespace {
+
+/**
+ * @brief Создать обнулённый сегмент и передать его память init
+ */
+template<typename Init>
+Result<void> create_segment(
+    std::string_view path,
+    const shm::SegmentPlacement& placement,
+    std::size_t size,
+    Init&& init
+) {
+    // Создаём сегмент (/dev/shm или hugetlbfs)
+    auto opened = shm::open_segment(placement, path, O_CREAT | O_RDWR, 0644);
+    if (!opened) {
+        return std::unexpected(opened.error());
     }
+    int fd = *opened;
+    const std::size_t length = shm::segment_map_length(fd, size);
     
     // Устанавливаем размер
-    if (ftruncate(fd, sizeof(QuaxisSharedBlock)) < 0) {
+    if (ftruncate(fd, static_cast<off_t>(length)) < 0) {
+        int saved_errno = errno;
         close(fd);
-        shm_unlink(path.data());
+        (void)shm::unlink_segment(placement, path);
         return Err<void>(
             ErrorCode::ShmOpenFailed,
-            std::format("Не удалось установить размер shared memory: {}", strerror(errno))
+            std::format("Не удалось установить размер shared memory: {}", strerror(saved_errno))
         );
     }
     
     // Маппим и инициализируем
-    void* ptr = mmap(nullptr, sizeof(QuaxisSharedBlock), 
+    void* ptr = mmap(nullptr, length, 
                      PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
     if (ptr == MAP_FAILED) {
+        int saved_errno = errno;
         close(fd);
-        shm_unlink(path.data());
+        (void)shm::unlink_segment(placement, path);
         return Err<void>(
             ErrorCode::ShmMapFailed,
-            std::format("Не удалось замапить shared memory: {}", strerror(errno))
+            std::format("Не удалось замапить shared memory: {}", strerror(saved_errno))
         );
     }
     
+    // Политика NUMA до первой записи: страницы выделятся на узле
+    if (placement.numa_node >= 0) {
+        auto bound = shm::bind_to_numa_node(ptr, length, placement.numa_node);
+        if (!bound) {
+            munmap(ptr, length);
+            close(fd);
+            (void)shm::unlink_segment(placement, path);
+            return bound;
+        }
+    }
+    
     // Инициализируем нулями
-    std::memset(ptr, 0, sizeof(QuaxisSharedBlock));
+    std::memset(ptr, 0, length);
+    init(ptr);
     
     // Закрываем
-    munmap(ptr, sizeof(QuaxisSharedBlock));
+    munmap(ptr, length);
     close(fd);
     
     return {};
 }
 
-Result<void> remove_shm_segment(std::string_view path) {
-    if (shm_unlink(path.data()) < 0 && errno != ENOENT) {
+} // anonymous namespace
+
+Result<void> create_shm_segment(std::string_view path, const shm::SegmentPlacement& placement) {
+    return create_segment(path, placement, sizeof(QuaxisSharedBlock), [](void*) {});
+}
+
+Result<void> create_shm_ring_segment(std::string_view path, const shm::SegmentPlacement& placement) {
+    return create_segment(path, placement, sizeof(QuaxisSharedRing), [](void* ptr) {
+        init_shm_ring(*static_cast<QuaxisSharedRing*>(ptr));
+    });
+}
+
+Result<void> create_shm_submit_segment(std::string_view path, const shm::SegmentPlacement& placement) {
+    return create_segment(path, placement, sizeof(QuaxisSharedSubmit), [](void* ptr) {
+        init_shm_submit(*static_cast<QuaxisSharedSubmit*>(ptr));
+    });
+}
+
+Result<void> create_shm_template_segment(std::string_view path, const shm::SegmentPlacement& placement) {
+    return create_segment(path, placement, sizeof(QuaxisSharedTemplate), [](void* ptr) {
+        auto* segment = static_cast<QuaxisSharedTemplate*>(ptr);
+        segment->magic = SHM_TEMPLATE_MAGIC;
+        segment->layout_version = SHM_TEMPLATE_LAYOUT_VERSION;
+    });
+}
+
+Result<void> remove_shm_segment(std::string_view path, const shm::SegmentPlacement& placement) {
+    return shm::unlink_segment(placement, path);
+}
+
+// =============================================================================
+// ShmBlockSubmitter
+// =============================================================================
+
+struct ShmBlockSubmitter::Impl {
+    ShmConfig config;
+    
+    int fd = -1;
+    void* map = nullptr;
+    std::size_t map_size = 0;
+    std::unique_ptr<ShmSubmitWriter> writer;
+    
+    /// @brief Буфер события (2 КБ - не на стеке потока канала)
+    ShmSubmitEvent event{};
+    
+    explicit Impl(const ShmConfig& cfg) : config(cfg) {}
+    
+    ~Impl() {
+        cleanup();
+    }
+    
+    void cleanup() {
+        writer.reset();
+        if (map && map != MAP_FAILED) {
+            munmap(map, map_size);
+        }
+        map = nullptr;
+        map_size = 0;
+        if (fd >= 0) {
+            close(fd);
+            fd = -1;
+        }
+    }
+};
+
+ShmBlockSubmitter::ShmBlockSubmitter(const ShmConfig& config)
+    : impl_(std::make_unique<Impl>(config))
+{
+}
+
+ShmBlockSubmitter::~ShmBlockSubmitter() = default;
+
+Result<void> ShmBlockSubmitter::open() {
+    if (impl_->writer) {
+        return {};
+    }
+    
+    const auto placement = segment_placement(impl_->config);
+    const std::string& path = impl_->config.submit_path;
+    auto fd = shm::open_segment(placement, path, O_RDWR);
+    if (!fd) {
+        // Узел ещё не создал сегмент - создаём сами, узел его откроет
+        auto created = create_shm_submit_segment(path, placement);
+        if (!created) {
+            return created;
+        }
+        fd = shm::open_segment(placement, path, O_RDWR);
+        if (!fd) {
+            return std::unexpected(fd.error());
+        }
+    }
+    impl_->fd = *fd;
+    
+    struct stat st{};
+    if (fstat(impl_->fd, &st) < 0 || static_cast<std::size_t>(st.st_size) < sizeof(QuaxisSharedSubmit)) {
+        impl_->cleanup();
+        return Err<void>(
+            ErrorCode::ShmInvalidState,
+            std::format("Сегмент '{}' меньше кольца отправки ({} байт)", path, sizeof(QuaxisSharedSubmit))
+        );
+    }
+    impl_->map_size = shm::segment_map_length(impl_->fd, sizeof(QuaxisSharedSubmit));
+    void* ptr = mmap(nullptr, impl_->map_size, PROT_READ | PROT_WRITE, MAP_SHARED, impl_->fd, 0);
+    if (ptr == MAP_FAILED) {
+        int saved_errno = errno;
+        impl_->cleanup();
+        return Err<void>(
+            ErrorCode::ShmMapFailed,
+            std::format("Не удалось замапить shared memory: {}", strerror(saved_errno))
+        );
+    }
+    impl_->map = ptr;
+    
+    auto* segment = static_cast<QuaxisSharedSubmit*>(ptr);
+    if (!is_shm_submit(*segment)) {
+        impl_->cleanup();
+        return Err<void>(
+            ErrorCode::ShmInvalidState,
+            std::format("Сегмент '{}' не размечен как кольцо отправки", path)
+        );
+    }
+    impl_->writer = std::make_unique<ShmSubmitWriter>(*segment);
+    return {};
+}
+
+Result<void> ShmBlockSubmitter::submit(ByteSpan block, const Hash256& block_hash) {
+    if (!impl_->writer) {
+        auto opened = open();
+        if (!opened) {
+            return opened;
+        }
+    }
+    
+    // Блок майнера: заголовок, число транзакций (1), coinbase
+    constexpr std::size_t coinbase_offset = constants::BLOCK_HEADER_SIZE + 1;
+    if (block.size() <= coinbase_offset || block[constants::BLOCK_HEADER_SIZE] != 0x01) {
+        return Err<void>(ErrorCode::ShmInvalidState, "Блок с транзакциями отправляется только по RPC");
+    }
+    const ByteSpan coinbase = block.subspan(coinbase_offset);
+    if (coinbase.size() > SHM_SUBMIT_MAX_COINBASE) {
         return Err<void>(
-            ErrorCode::ShmOpenFailed,
-            std::format("Не удалось удалить shared memory '{}': {}", 
-                       path, strerror(errno))
+            ErrorCode::ShmInvalidState,
+            std::format("Coinbase {} байт не помещается в слот отправки", coinbase.size())
         );
     }
+    
+    ShmSubmitEvent& event = impl_->event;
+    event.coinbase_size = static_cast<uint32_t>(coinbase.size());
+    std::memcpy(event.header_raw, block.data(), constants::BLOCK_HEADER_SIZE);
+    std::memcpy(event.block_hash, block_hash.data(), sizeof(event.block_hash));
+    std::memcpy(event.coinbase, coinbase.data(), coinbase.size());
+    if (impl_->writer->publish(event) == 0) {
+        return Err<void>(ErrorCode::ShmInvalidState, "Кольцо отправки заполнено: узел не забирает блоки");
+    }
     return {};
 }
 
+uint64_t ShmBlockSubmitter::pending() const noexcept {
+    return impl_->writer ? impl_->writer->pending() : 0;
+}
+
 } // namespace quaxis::bitcoin
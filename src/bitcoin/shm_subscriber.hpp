@@ -15,6 +15,13 @@
  * Режимы работы:
  * 1. Spin-wait: минимальная латентность, но высокое использование CPU
  * 2. Poll: периодическая проверка с заданным интервалом
+ * 3. Futex: короткий spin, затем futex_wait до futex_wake издателя
+ *    (shm::publish_sequence) - единицы микросекунд при ~0% CPU
+ *
+ * Раскладка сегмента определяется при подключении: если сегмент вмещает
+ * QuaxisSharedRing и помечен SHM_RING_MAGIC, события читаются из кольца
+ * (shm_ring.hpp) по порядку, без потери переходов speculative ->
+ * confirmed / invalid; иначе - из одиночного QuaxisSharedBlock.
  */
 
 #pragma once
@@ -22,6 +29,9 @@
 #include "../core/types.hpp"
 #include "../core/config.hpp"
 #include "block.hpp"
+#include "shm_ring.hpp"
+#include "shm_submit.hpp"
+#include "../shm/placement.hpp"
 
 #include <atomic>
 #include <functional>
@@ -31,62 +41,6 @@
 
 namespace quaxis::bitcoin {
 
-// =============================================================================
-// Константы Shared Memory
-// =============================================================================
-
-/**
- * @brief Состояние блока в shared memory
- */
-enum class ShmBlockState : uint8_t {
-    Empty = 0,       ///< Нет данных
-    Speculative = 1, ///< Spy mining: блок получен, но не валидирован
-    Confirmed = 2,   ///< Блок полностью валидирован
-    Invalid = 3      ///< Блок оказался невалидным
-};
-
-// =============================================================================
-// Структура Shared Memory блока
-// =============================================================================
-
-/**
- * @brief Структура данных в shared memory
- * 
- * Выравнивание по 64-байтным cache lines для избежания false sharing.
- */
-struct alignas(64) QuaxisSharedBlock {
-    /// @brief Атомарный sequence counter для детекции изменений
-    alignas(64) std::atomic<uint64_t> sequence;
-    
-    /// @brief Состояние блока
-    alignas(64) std::atomic<uint8_t> state;
-    
-    /// @brief Заголовок блока (80 байт)
-    alignas(64) uint8_t header_raw[80];
-    
-    /// @brief Высота блока
-    uint32_t height;
-    
-    /// @brief Compact target (bits)
-    uint32_t bits;
-    
-    /// @brief Timestamp блока
-    uint32_t timestamp;
-    
-    /// @brief Padding для выравнивания
-    uint32_t reserved;
-    
-    /// @brief Награда за блок (satoshi)
-    int64_t coinbase_value;
-    
-    /// @brief Хеш блока
-    uint8_t block_hash[32];
-};
-
-// Размер структуры увеличен до 512 байт из-за выравнивания полей по 64-байтным cache lines
-// (alignas(64) на sequence, state и header_raw добавляет padding)
-static_assert(sizeof(QuaxisSharedBlock) <= 512, "QuaxisSharedBlock превышает 512 байт");
-
 // =============================================================================
 // Callback тип
 // =============================================================================
@@ -106,6 +60,23 @@ using NewBlockCallback = std::function<void(
     bool is_speculative
 )>;
 
+/**
+ * @brief Callback при смене состояния уже известного блока
+ *
+ * Вызывается, когда speculative блок подтверждён (Confirmed с тем же
+ * хешем) или оказался невалидным (Invalid). Confirmed нового блока
+ * по-прежнему приходит в NewBlockCallback.
+ *
+ * @param block_hash Хеш блока
+ * @param height Высота блока
+ * @param state Новое состояние (Confirmed или Invalid)
+ */
+using BlockStateCallback = std::function<void(
+    const Hash256& block_hash,
+    uint32_t height,
+    ShmBlockState state
+)>;
+
 // =============================================================================
 // Shared Memory Subscriber
 // =============================================================================
@@ -141,6 +112,13 @@ public:
      */
     void set_callback(NewBlockCallback callback);
     
+    /**
+     * @brief Установить callback смены состояния блока
+     * 
+     * @param callback Функция обработки confirm / invalidate
+     */
+    void set_state_callback(BlockStateCallback callback);
+    
     /**
      * @brief Запустить подписчик
      * 
@@ -168,6 +146,71 @@ public:
      */
     [[nodiscard]] std::optional<BlockHeader> get_last_block() const;
     
+    /**
+     * @brief Подключён ли сегмент в раскладке кольца
+     */
+    [[nodiscard]] bool is_ring() const noexcept;
+    
+    /**
+     * @brief События кольца, перезаписанные до прочтения (overrun)
+     */
+    [[nodiscard]] uint64_t lost_events() const noexcept;
+    
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+// =============================================================================
+// Отправка блоков в узел
+// =============================================================================
+
+/**
+ * @brief Канал отправки найденных блоков в узел через кольцо QuaxisSharedSubmit
+ *
+ * Открывает сегмент submit_path на запись (создаёт, если узел ещё не
+ * запущен) и публикует блоки ShmSubmitWriter. Блок с транзакциями кроме
+ * coinbase или не помещающийся в слот отклоняется - его отправит RPC.
+ *
+ * Thread-safety: submit() вызывается из одного потока (канал
+ * BlockSubmitter).
+ */
+class ShmBlockSubmitter {
+public:
+    /**
+     * @brief Создать канал
+     *
+     * @param config Конфигурация shared memory (submit_path, размещение)
+     */
+    explicit ShmBlockSubmitter(const ShmConfig& config);
+
+    ~ShmBlockSubmitter();
+
+    ShmBlockSubmitter(const ShmBlockSubmitter&) = delete;
+    ShmBlockSubmitter& operator=(const ShmBlockSubmitter&) = delete;
+
+    /**
+     * @brief Открыть (или создать) сегмент
+     *
+     * @return Result<void> Успех или ошибка shared memory
+     */
+    [[nodiscard]] Result<void> open();
+
+    /**
+     * @brief Опубликовать найденный блок
+     *
+     * @param block Сериализованный блок (заголовок, 1 транзакция, coinbase)
+     * @param block_hash Хеш блока
+     * @return Result<void> Успех, ShmInvalidState (блок не подходит, кольцо
+     *         полно) или ошибка открытия
+     */
+    [[nodiscard]] Result<void> submit(ByteSpan block, const Hash256& block_hash);
+
+    /**
+     * @brief Опубликованные, но не забранные узлом блоки
+     */
+    [[nodiscard]] uint64_t pending() const noexcept;
+
 private:
     struct Impl;
     std::unique_ptr<Impl> impl_;
@@ -177,20 +220,57 @@ private:
 // Фабричные функции
 // =============================================================================
 
+/**
+ * @brief Размещение сегментов из секции [shm] (hugetlb_dir, numa_node)
+ */
+[[nodiscard]] shm::SegmentPlacement segment_placement(const ShmConfig& config);
+
 /**
  * @brief Создать shared memory сегмент (для Bitcoin Core патча)
  * 
  * @param path Путь к shared memory (/quaxis_block)
+ * @param placement hugetlbfs каталог и NUMA узел (по умолчанию /dev/shm)
+ * @return Result<void> Успех или ошибка
+ */
+[[nodiscard]] Result<void> create_shm_segment(
+    std::string_view path,
+    const shm::SegmentPlacement& placement = {}
+);
+
+/**
+ * @brief Создать shared memory сегмент в раскладке кольца событий
+ * 
+ * @param path Путь к shared memory (/quaxis_block)
+ * @param placement hugetlbfs каталог и NUMA узел (по умолчанию /dev/shm)
+ * @return Result<void> Успех или ошибка
+ */
+[[nodiscard]] Result<void> create_shm_ring_segment(
+    std::string_view path,
+    const shm::SegmentPlacement& placement = {}
+);
+
+/**
+ * @brief Создать shared memory сегмент кольца отправки блоков в узел
+ * 
+ * @param path Путь к shared memory (/quaxis_submit)
+ * @param placement hugetlbfs каталог и NUMA узел (по умолчанию /dev/shm)
  * @return Result<void> Успех или ошибка
  */
-[[nodiscard]] Result<void> create_shm_segment(std::string_view path);
+[[nodiscard]] Result<void> create_shm_submit_segment(
+    std::string_view path,
+    const shm::SegmentPlacement& placement = {}
+);
 
 /**
  * @brief Удалить shared memory сегмент
  * 
  * @param path Путь к shared memory
+ * @param placement Размещение, с которым сегмент создан
  * @return Result<void> Успех или ошибка
  */
-[[nodiscard]] Result<void> remove_shm_segment(std::string_view path);
+[[nodiscard]] Result<void> remove_shm_segment(
+    std::string_view path,
+    const shm::SegmentPlacement& placement = {}
+);
 
 } // namespace quaxis::bitcoin
@@ -0,0 +1,296 @@
+/**
+ * @file shm_template.cpp
+ * @brief Реализация сегмента полного шаблона и подписчика на него
+ */
+
+#include "shm_template.hpp"
+#include "shm_subscriber.hpp"
+#include "target.hpp"
+#include "../core/latency_trace.hpp"
+#include "../core/thread_plan.hpp"
+#include "../shm/adaptive_spin.hpp"
+#include "../shm/sequence_futex.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <format>
+#include <mutex>
+#include <thread>
+
+namespace quaxis::bitcoin {
+
+// =============================================================================
+// ShmTemplateData -> BlockTemplate
+// =============================================================================
+
+Result<void> fill_block_template(const ShmTemplateData& data, BlockTemplate& out) {
+    if (data.state != ShmBlockState::Speculative && data.state != ShmBlockState::Confirmed) {
+        return Err<void>(ErrorCode::ShmInvalidState, "Шаблон без состояния speculative/confirmed");
+    }
+    if (data.coinbase_suffix_size > SHM_TEMPLATE_MAX_SUFFIX) {
+        return Err<void>(
+            ErrorCode::ShmInvalidState,
+            std::format("Хвост coinbase шаблона слишком велик: {} байт", data.coinbase_suffix_size)
+        );
+    }
+    if (data.merkle_branch_size != 0) {
+        return Err<void>(
+            ErrorCode::ShmInvalidState,
+            "Шаблон с merkle ветвью не поддерживается: блок собирается только с coinbase"
+        );
+    }
+
+    auto header = BlockHeader::deserialize(ByteSpan(data.header_raw, sizeof(data.header_raw)));
+    if (!header) {
+        return Err<void>(header.error().code, header.error().message);
+    }
+
+    out.height = data.height;
+    out.header = *header;
+    out.header.nonce = 0;
+    out.coinbase_value = data.coinbase_value;
+    out.is_speculative = (data.state == ShmBlockState::Speculative);
+
+    // Coinbase: prefix | extranonce = 0 | suffix
+    out.coinbase_tx.resize(SHM_TEMPLATE_PREFIX_SIZE + constants::EXTRANONCE_SIZE + data.coinbase_suffix_size);
+    std::memcpy(out.coinbase_tx.data(), data.coinbase_prefix, SHM_TEMPLATE_PREFIX_SIZE);
+    std::memset(out.coinbase_tx.data() + SHM_TEMPLATE_PREFIX_SIZE, 0, constants::EXTRANONCE_SIZE);
+    std::memcpy(
+        out.coinbase_tx.data() + SHM_TEMPLATE_PREFIX_SIZE + constants::EXTRANONCE_SIZE,
+        data.coinbase_suffix,
+        data.coinbase_suffix_size
+    );
+    out.coinbase_midstate = crypto::compute_midstate(out.coinbase_tx.data());
+
+    // Merkle root пустого блока = txid coinbase
+    out.header.merkle_root = out.merkle_root_for_extranonce(0);
+    out.header_midstate = out.header.compute_midstate();
+    out.target = bits_to_target(out.header.bits);
+    return {};
+}
+
+// =============================================================================
+// Реализация подписчика (PIMPL)
+// =============================================================================
+
+struct ShmTemplateSubscriber::Impl {
+    ShmConfig config;
+    NewTemplateCallback callback;
+
+    int shm_fd = -1;
+    std::size_t map_length = 0;
+    const QuaxisSharedTemplate* segment = nullptr;
+
+    std::thread worker_thread;
+    std::atomic<bool> running{false};
+    std::atomic<uint64_t> last_sequence{0};
+    std::atomic<uint64_t> rejected{0};
+
+    std::shared_ptr<const BlockTemplate> last_template;
+    mutable std::mutex last_template_mutex;
+
+    explicit Impl(const ShmConfig& cfg) : config(cfg) {}
+
+    ~Impl() {
+        stop();
+        cleanup();
+    }
+
+    void cleanup() {
+        if (segment) {
+            munmap(const_cast<QuaxisSharedTemplate*>(segment), map_length);
+            segment = nullptr;
+            map_length = 0;
+        }
+        if (shm_fd >= 0) {
+            close(shm_fd);
+            shm_fd = -1;
+        }
+    }
+
+    Result<void> open_shm() {
+        const auto placement = segment_placement(config);
+        auto fd = shm::open_segment(placement, config.template_path, O_RDONLY);
+        if (!fd) {
+            return std::unexpected(fd.error());
+        }
+        shm_fd = *fd;
+
+        struct stat st{};
+        if (fstat(shm_fd, &st) < 0 || static_cast<std::size_t>(st.st_size) < sizeof(QuaxisSharedTemplate)) {
+            close(shm_fd);
+            shm_fd = -1;
+            return Err<void>(
+                ErrorCode::ShmInvalidState,
+                std::format("Сегмент '{}' меньше шаблона ({} байт)",
+                           config.template_path, sizeof(QuaxisSharedTemplate))
+            );
+        }
+
+        const std::size_t length = shm::segment_map_length(shm_fd, sizeof(QuaxisSharedTemplate));
+        void* ptr = mmap(nullptr, length,
+                        PROT_READ, MAP_SHARED, shm_fd, 0);
+        if (ptr == MAP_FAILED) {
+            close(shm_fd);
+            shm_fd = -1;
+            return Err<void>(
+                ErrorCode::ShmMapFailed,
+                std::format("Не удалось замапить shared memory: {}", strerror(errno))
+            );
+        }
+
+        segment = static_cast<const QuaxisSharedTemplate*>(ptr);
+        map_length = length;
+        if (placement.numa_node >= 0) {
+            auto bound = shm::bind_to_numa_node(ptr, length, placement.numa_node);
+            if (!bound) {
+                cleanup();
+                return bound;
+            }
+        }
+        if (!is_shm_template(*segment)) {
+            cleanup();
+            return Err<void>(
+                ErrorCode::ShmInvalidState,
+                std::format("Сегмент '{}' не размечен как шаблон", config.template_path)
+            );
+        }
+        return {};
+    }
+
+    void worker_loop() {
+        shm::AdaptiveSpinConfig spin_config;
+        spin_config.spin_phase1_iterations = config.spin_phase1_iterations;
+        spin_config.spin_phase2_iterations = config.spin_phase2_iterations;
+        spin_config.sleep_us = config.sleep_us;
+        spin_config.futex_wait = config.futex_wait;
+        spin_config.futex_spin_iterations = config.futex_spin_iterations;
+        spin_config.futex_timeout_us = config.futex_timeout_us;
+        shm::AdaptiveSpinWait waiter(spin_config);
+
+        while (running.load(std::memory_order_relaxed)) {
+            uint64_t seq = segment->sequence.load(std::memory_order_acquire);
+            uint64_t last = last_sequence.load(std::memory_order_relaxed);
+
+            if (seq != last) {
+                process_template();
+                waiter.reset();
+            } else if (config.adaptive_spin_enabled || config.futex_wait) {
+                waiter.wait_step(segment->sequence, last);
+            } else {
+                std::this_thread::sleep_for(std::chrono::microseconds(config.sleep_us));
+            }
+        }
+    }
+
+    void process_template() {
+        const uint64_t seen_at = core::trace_timestamp();
+        
+        // Копия на стеке живёт только до сборки BlockTemplate
+        ShmTemplateData data;
+        uint64_t seq = read_shm_template(*segment, data);
+        last_sequence.store(seq, std::memory_order_relaxed);
+        if (seq == 0) {
+            return;  // Шаблон ещё не публиковался
+        }
+
+        auto block_template = std::make_shared<BlockTemplate>();
+        if (!fill_block_template(data, *block_template)) {
+            rejected.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        std::shared_ptr<const BlockTemplate> shared = std::move(block_template);
+        
+        // Ключ эпохи - tip, как у события сегмента блока
+        core::trace_block_arrival(core::TraceStage::ShmBlock, shared->header.prev_block, seen_at);
+
+        {
+            std::lock_guard<std::mutex> lock(last_template_mutex);
+            last_template = shared;
+        }
+
+        if (callback) {
+            callback(shared, shared->is_speculative);
+        }
+    }
+
+    void stop() {
+        running.store(false, std::memory_order_relaxed);
+        if (segment && config.futex_wait) {
+            shm::wake_sequence(segment->sequence);  // поток может спать в futex_wait
+        }
+        if (worker_thread.joinable()) {
+            worker_thread.join();
+        }
+    }
+};
+
+// =============================================================================
+// ShmTemplateSubscriber
+// =============================================================================
+
+ShmTemplateSubscriber::ShmTemplateSubscriber(const ShmConfig& config)
+    : impl_(std::make_unique<Impl>(config))
+{
+}
+
+ShmTemplateSubscriber::~ShmTemplateSubscriber() = default;
+
+void ShmTemplateSubscriber::set_callback(NewTemplateCallback callback) {
+    impl_->callback = std::move(callback);
+}
+
+Result<void> ShmTemplateSubscriber::start() {
+    if (impl_->running.load()) {
+        return {};  // Уже запущен
+    }
+
+    auto result = impl_->open_shm();
+    if (!result) {
+        return result;
+    }
+
+    impl_->running.store(true, std::memory_order_relaxed);
+    impl_->worker_thread = std::thread([this] {
+        core::enter_thread_role(core::ThreadRole::BlockPath, impl_->config.cpu_affinity >= 0);
+        impl_->worker_loop();
+    });
+
+    if (impl_->config.cpu_affinity >= 0) {
+        auto pinned = shm::pin_thread_to_cpu(impl_->worker_thread, impl_->config.cpu_affinity);
+        if (!pinned) {
+            impl_->stop();
+            impl_->cleanup();
+            return pinned;
+        }
+    }
+
+    return {};
+}
+
+void ShmTemplateSubscriber::stop() {
+    impl_->stop();
+}
+
+bool ShmTemplateSubscriber::is_running() const noexcept {
+    return impl_->running.load(std::memory_order_relaxed);
+}
+
+uint64_t ShmTemplateSubscriber::get_sequence() const noexcept {
+    return impl_->last_sequence.load(std::memory_order_relaxed);
+}
+
+std::shared_ptr<const BlockTemplate> ShmTemplateSubscriber::get_last_template() const {
+    std::lock_guard<std::mutex> lock(impl_->last_template_mutex);
+    return impl_->last_template;
+}
+
+uint64_t ShmTemplateSubscriber::rejected_templates() const noexcept {
+    return impl_->rejected.load(std::memory_order_relaxed);
+}
+
+} // namespace quaxis::bitcoin
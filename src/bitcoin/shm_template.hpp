@@ -0,0 +1,159 @@
+/**
+ * @file shm_template.hpp
+ * @brief Полный шаблон блока в shared memory
+ *
+ * QuaxisSharedBlock / QuaxisSharedRing несут только заголовок нового tip,
+ * и после пробуждения coinbase (с aux commitment от ChainManager) ещё
+ * нужно собрать - на критическом пути. Второй сегмент несёт готовый к
+ * хешированию шаблон блока height + 1, собранный плагином узла:
+ *
+ * - header_raw: заголовок шаблона (version, prev_block, timestamp, bits;
+ *   merkle_root игнорируется - считается по coinbase)
+ * - coinbase_prefix: первые 64 байта coinbase (до extranonce, как в
+ *   CoinbaseBuilder: длина scriptsig уже учитывает 6 байт extranonce)
+ * - coinbase_suffix: всё после extranonce - sequence, выходы (выплата,
+ *   witness commitment, aux commitment merged mining), locktime
+ * - merkle_branch: ветвь coinbase до merkle root блока с транзакциями
+ *
+ * Coinbase шаблона = prefix | extranonce (6 байт) | suffix; extranonce
+ * лежит на смещении 64, поэтому midstate первых 64 байт считается один
+ * раз на шаблон, как и для собственной coinbase.
+ *
+ * Сегмент защищён seqlock: sequence нечётен во время записи. Это же
+ * слово служит futex (shm::wake_sequence), как и в сегменте блока.
+ * Раскладка и seqlock - в shm_template_layout.hpp.
+ */
+
+#pragma once
+
+#include "../core/types.hpp"
+#include "../core/config.hpp"
+#include "../core/constants.hpp"
+#include "block.hpp"
+#include "shm_ring.hpp"
+#include "shm_template_layout.hpp"
+#include "../shm/placement.hpp"
+
+#include <atomic>
+#include <functional>
+#include <memory>
+
+namespace quaxis::bitcoin {
+
+// =============================================================================
+// ShmTemplateData -> BlockTemplate
+// =============================================================================
+
+/**
+ * @brief Собрать BlockTemplate из шаблона сегмента
+ *
+ * Coinbase собирается из prefix и suffix (extranonce = 0), merkle_root
+ * и оба midstate считаются сразу: задания создаются без построения
+ * coinbase после пробуждения.
+ *
+ * @note Ветвь merkle пока отклоняется: найденный блок собирается
+ *       BlockSkeleton из заголовка и coinbase, транзакций у майнера нет.
+ *
+ * @param data Шаблон из сегмента
+ * @param out Заполняемый шаблон
+ * @return Result<void> Успех или ShmInvalidState
+ */
+[[nodiscard]] Result<void> fill_block_template(const ShmTemplateData& data, BlockTemplate& out);
+
+// =============================================================================
+// Подписчик на шаблоны
+// =============================================================================
+
+/**
+ * @brief Callback при новом шаблоне
+ *
+ * Шаблон неизменяем и разделяемый: его можно сразу отдать
+ * JobManager::on_new_block() без копирования.
+ *
+ * @param block_template Готовый шаблон
+ * @param is_speculative true если tip ещё не валидирован
+ */
+using NewTemplateCallback = std::function<void(
+    std::shared_ptr<const BlockTemplate> block_template,
+    bool is_speculative
+)>;
+
+/**
+ * @brief Подписчик на сегмент шаблона
+ *
+ * Работает в отдельном потоке и ждёт sequence сегмента так же, как
+ * ShmSubscriber (spin / yield / sleep или spin / futex_wait).
+ */
+class ShmTemplateSubscriber {
+public:
+    /**
+     * @brief Создать подписчик
+     *
+     * @param config Конфигурация shared memory (template_path и ожидание)
+     */
+    explicit ShmTemplateSubscriber(const ShmConfig& config);
+
+    /**
+     * @brief Деструктор - останавливает подписчик
+     */
+    ~ShmTemplateSubscriber();
+
+    // Запрещаем копирование
+    ShmTemplateSubscriber(const ShmTemplateSubscriber&) = delete;
+    ShmTemplateSubscriber& operator=(const ShmTemplateSubscriber&) = delete;
+
+    /**
+     * @brief Установить callback для новых шаблонов
+     */
+    void set_callback(NewTemplateCallback callback);
+
+    /**
+     * @brief Запустить подписчик
+     *
+     * @return Result<void> Успех или ошибка открытия shared memory
+     */
+    [[nodiscard]] Result<void> start();
+
+    /**
+     * @brief Остановить подписчик
+     */
+    void stop();
+
+    /**
+     * @brief Проверить, запущен ли подписчик
+     */
+    [[nodiscard]] bool is_running() const noexcept;
+
+    /**
+     * @brief sequence последнего обработанного шаблона
+     */
+    [[nodiscard]] uint64_t get_sequence() const noexcept;
+
+    /**
+     * @brief Последний принятый шаблон (если есть)
+     */
+    [[nodiscard]] std::shared_ptr<const BlockTemplate> get_last_template() const;
+
+    /**
+     * @brief Шаблоны, отклонённые fill_block_template()
+     */
+    [[nodiscard]] uint64_t rejected_templates() const noexcept;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+/**
+ * @brief Создать shared memory сегмент шаблона
+ *
+ * @param path Путь к shared memory (/quaxis_template)
+ * @param placement hugetlbfs каталог и NUMA узел (по умолчанию /dev/shm)
+ * @return Result<void> Успех или ошибка
+ */
+[[nodiscard]] Result<void> create_shm_template_segment(
+    std::string_view path,
+    const shm::SegmentPlacement& placement = {}
+);
+
+} // namespace quaxis::bitcoin
@@ -0,0 +1,165 @@
+/**
+ * @file shm_template_layout.hpp
+ * @brief Раскладка сегмента шаблона и его seqlock
+ *
+ * Только раскладка и протокол записи / чтения, без BlockTemplate и
+ * конфигурации: заголовок подключают и майнер (shm_template.hpp), и
+ * издатель узла (publisher/quaxis_publisher.h), которому не нужны
+ * зависимости майнера.
+ */
+
+#pragma once
+
+#include "../core/constants.hpp"
+#include "../shm/adaptive_spin.hpp"
+#include "../shm/sequence_futex.hpp"
+#include "shm_ring.hpp"
+
+#include <atomic>
+#include <cstring>
+#include <type_traits>
+
+namespace quaxis::bitcoin {
+
+// =============================================================================
+// Константы сегмента шаблона
+// =============================================================================
+
+/// @brief Сигнатура сегмента шаблона ("QTPL")
+inline constexpr uint32_t SHM_TEMPLATE_MAGIC = 0x4C505451;
+
+/// @brief Версия раскладки сегмента шаблона
+inline constexpr uint32_t SHM_TEMPLATE_LAYOUT_VERSION = 1;
+
+/// @brief Размер coinbase до extranonce
+inline constexpr std::size_t SHM_TEMPLATE_PREFIX_SIZE = constants::SHA256_BLOCK_SIZE;
+
+/// @brief Максимальный размер coinbase после extranonce
+inline constexpr std::size_t SHM_TEMPLATE_MAX_SUFFIX = 1024;
+
+/// @brief Максимальная глубина merkle ветви (до 65536 транзакций)
+inline constexpr std::size_t SHM_TEMPLATE_MAX_BRANCH = 16;
+
+// =============================================================================
+// Раскладка сегмента
+// =============================================================================
+
+/**
+ * @brief Содержимое сегмента шаблона
+ */
+struct ShmTemplateData {
+    /// @brief Высота шаблона (следующего блока)
+    uint32_t height{0};
+
+    /// @brief Speculative (tip не валидирован) или Confirmed
+    ShmBlockState state{ShmBlockState::Empty};
+
+    /// @brief Глубина merkle ветви (0 - блок только с coinbase)
+    uint8_t merkle_branch_size{0};
+
+    /// @brief Длина coinbase_suffix
+    uint16_t coinbase_suffix_size{0};
+
+    /// @brief Награда за блок (satoshi)
+    int64_t coinbase_value{0};
+
+    /// @brief Заголовок шаблона (80 байт)
+    uint8_t header_raw[80]{};
+
+    /// @brief Coinbase до extranonce
+    uint8_t coinbase_prefix[SHM_TEMPLATE_PREFIX_SIZE]{};
+
+    /// @brief Coinbase после extranonce
+    uint8_t coinbase_suffix[SHM_TEMPLATE_MAX_SUFFIX]{};
+
+    /// @brief Merkle ветвь coinbase
+    uint8_t merkle_branch[SHM_TEMPLATE_MAX_BRANCH][32]{};
+};
+
+static_assert(std::is_trivially_copyable_v<ShmTemplateData>,
+              "ShmTemplateData должен быть trivially copyable для seqlock");
+
+/**
+ * @brief Сегмент shared memory с шаблоном
+ */
+struct alignas(64) QuaxisSharedTemplate {
+    /// @brief Количество 64-битных слов под шаблон
+    static constexpr std::size_t WORDS = (sizeof(ShmTemplateData) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    /// @brief Seqlock (нечётен во время записи) и слово futex
+    std::atomic<uint64_t> sequence;
+
+    /// @brief SHM_TEMPLATE_MAGIC
+    uint32_t magic;
+
+    /// @brief SHM_TEMPLATE_LAYOUT_VERSION
+    uint32_t layout_version;
+
+    /// @brief Шаблон
+    alignas(64) std::atomic<uint64_t> words[WORDS];
+};
+
+/**
+ * @brief Проверить, что память - инициализированный сегмент шаблона
+ */
+[[nodiscard]] inline bool is_shm_template(const QuaxisSharedTemplate& segment) noexcept {
+    return segment.magic == SHM_TEMPLATE_MAGIC
+        && segment.layout_version == SHM_TEMPLATE_LAYOUT_VERSION;
+}
+
+// =============================================================================
+// Seqlock сегмента
+// =============================================================================
+
+/**
+ * @brief Опубликовать шаблон (плагин узла, тесты)
+ *
+ * Писатель один. После записи будит подписчиков в futex_wait.
+ *
+ * @return uint64_t Новое (чётное) значение sequence
+ */
+inline uint64_t publish_shm_template(QuaxisSharedTemplate& segment, const ShmTemplateData& data) noexcept {
+    uint64_t buf[QuaxisSharedTemplate::WORDS]{};
+    std::memcpy(buf, &data, sizeof(data));
+
+    const uint64_t seq = segment.sequence.load(std::memory_order_relaxed);
+    const uint64_t writing = seq | 1;  // нечётное: идёт запись
+    segment.sequence.store(writing, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (std::size_t w = 0; w < QuaxisSharedTemplate::WORDS; ++w) {
+        segment.words[w].store(buf[w], std::memory_order_relaxed);
+    }
+    segment.sequence.store(writing + 1, std::memory_order_release);
+    shm::wake_sequence(segment.sequence);
+    return writing + 1;
+}
+
+/**
+ * @brief Прочитать согласованную копию шаблона
+ *
+ * @param segment Сегмент
+ * @param out Копия шаблона
+ * @return uint64_t sequence прочитанного шаблона (0 - шаблон не публиковался)
+ */
+inline uint64_t read_shm_template(const QuaxisSharedTemplate& segment, ShmTemplateData& out) noexcept {
+    uint64_t buf[QuaxisSharedTemplate::WORDS];
+    uint64_t s1 = 0;
+    for (;;) {
+        s1 = segment.sequence.load(std::memory_order_acquire);
+        if (s1 & 1) {
+            shm::cpu_pause();  // Писатель в процессе записи
+            continue;
+        }
+        for (std::size_t w = 0; w < QuaxisSharedTemplate::WORDS; ++w) {
+            buf[w] = segment.words[w].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (segment.sequence.load(std::memory_order_relaxed) == s1) {
+            break;
+        }
+    }
+    std::memcpy(&out, buf, sizeof(out));
+    return s1;
+}
+
+} // namespace quaxis::bitcoin
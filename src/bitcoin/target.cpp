@@ -46,17 +46,17 @@ Hash256 bits_to_target(uint32_t bits) noexcept {
         target[1] = static_cast<uint8_t>((mantissa >> 8) & 0xFF);
         target[2] = static_cast<uint8_t>((mantissa >> 16) & 0xFF);
     } else {
-        // Позиция старшего байта мантиссы
+        // Позиция младшего байта мантиссы (target little-endian)
         std::size_t pos = static_cast<std::size_t>(exponent - 3);
         
         if (pos < 32) {
-            target[pos] = static_cast<uint8_t>((mantissa >> 16) & 0xFF);
+            target[pos] = static_cast<uint8_t>(mantissa & 0xFF);
         }
-        if (pos > 0 && pos - 1 < 32) {
-            target[pos - 1] = static_cast<uint8_t>((mantissa >> 8) & 0xFF);
+        if (pos + 1 < 32) {
+            target[pos + 1] = static_cast<uint8_t>((mantissa >> 8) & 0xFF);
         }
-        if (pos > 1 && pos - 2 < 32) {
-            target[pos - 2] = static_cast<uint8_t>(mantissa & 0xFF);
+        if (pos + 2 < 32) {
+            target[pos + 2] = static_cast<uint8_t>((mantissa >> 16) & 0xFF);
         }
     }
     
@@ -138,23 +138,50 @@ double target_to_difficulty(const Hash256& target) noexcept {
     return bits_to_difficulty(bits);
 }
 
+Target256 difficulty_to_target(double difficulty) noexcept {
+    Target256 target;
+    
+    // Очень маленькая сложность: target не помещается в 256 бит
+    if (!(difficulty > 1e-12)) {
+        target.words.fill(~uint64_t{0});
+        return target;
+    }
+    
+    // difficulty = m * 2^e, m в [0.5, 1)
+    // target = 0xFFFF * 2^208 / difficulty = (0xFFFF / m) * 2^(208 - e)
+    // 0xFFFF / m < 2^17, поэтому (0xFFFF / m) * 2^46 помещается в uint64
+    int exponent = 0;
+    double mantissa = std::frexp(difficulty, &exponent);
+    auto value = static_cast<uint64_t>(std::ldexp(static_cast<double>(0xFFFF) / mantissa, 46));
+    int shift = 208 - exponent - 46;
+    
+    if (shift < 0) {
+        // Сложность выше 2^162: target меньше 64 бит
+        target.words[0] = shift > -64 ? value >> -shift : 0;
+        return target;
+    }
+    if (shift + 63 > 256) {
+        // Старший бит value вышел бы за 256 бит
+        target.words.fill(~uint64_t{0});
+        return target;
+    }
+    
+    auto word = static_cast<std::size_t>(shift / 64);
+    int bit = shift % 64;
+    target.words[word] = value << bit;
+    if (bit != 0 && word + 1 < target.words.size()) {
+        target.words[word + 1] = value >> (64 - bit);
+    }
+    return target;
+}
+
 // =============================================================================
 // Проверки
 // =============================================================================
 
 bool meets_target(const Hash256& hash, const Hash256& target) noexcept {
-    // Сравниваем от старших байт к младшим
-    // hash должен быть <= target
-    for (int i = 31; i >= 0; --i) {
-        auto idx = static_cast<std::size_t>(i);
-        if (hash[idx] < target[idx]) {
-            return true;  // hash < target
-        }
-        if (hash[idx] > target[idx]) {
-            return false; // hash > target
-        }
-    }
-    return true;  // hash == target
+    // hash должен быть <= target (сравнение словами от старшего)
+    return meets_target(hash, Target256::from_hash(target));
 }
 
 bool meets_bits(const Hash256& hash, uint32_t bits) noexcept {
@@ -179,14 +206,9 @@ std::string format_difficulty(double difficulty) {
 }
 
 std::string target_to_hex(const Hash256& target) {
-    std::string hex;
-    hex.reserve(64);
-    
     // От старших байт к младшим (обратный порядок для отображения)
-    for (int i = 31; i >= 0; --i) {
-        hex += std::format("{:02x}", target[static_cast<std::size_t>(i)]);
-    }
-    
+    std::string hex(64, '0');
+    hex_encode_reversed(target, hex.data());
     return hex;
 }
 
@@ -199,28 +221,12 @@ Result<Hash256> hex_to_target(std::string_view hex) {
     }
     
     Hash256 target{};
-    
-    for (std::size_t i = 0; i < 32; ++i) {
-        std::string_view byte_hex = hex.substr((31 - i) * 2, 2);
-        
-        unsigned int value = 0;
-        for (char c : byte_hex) {
-            value <<= 4;
-            if (c >= '0' && c <= '9') {
-                value |= static_cast<unsigned int>(c - '0');
-            } else if (c >= 'a' && c <= 'f') {
-                value |= static_cast<unsigned int>(c - 'a' + 10);
-            } else if (c >= 'A' && c <= 'F') {
-                value |= static_cast<unsigned int>(c - 'A' + 10);
-            } else {
-                return Err<Hash256>(
-                    ErrorCode::ConfigParseError,
-                    std::format("Неверный символ в hex строке: '{}'", c)
-                );
-            }
-        }
-        
-        target[i] = static_cast<uint8_t>(value);
+    if (!hex_decode_reversed(hex, target.data())) {
+        const char bad = *std::find_if_not(hex.begin(), hex.end(), is_hex_digit);
+        return Err<Hash256>(
+            ErrorCode::ConfigParseError,
+            std::format("Неверный символ в hex строке: '{}'", bad)
+        );
     }
     
     return target;
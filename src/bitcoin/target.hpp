@@ -21,7 +21,9 @@
 #pragma once
 
 #include "../core/types.hpp"
+#include "../core/byte_order.hpp"
 
+#include <array>
 #include <cstdint>
 #include <string>
 
@@ -84,6 +86,57 @@ namespace quaxis::bitcoin {
  */
 [[nodiscard]] bool meets_target(const Hash256& hash, const Hash256& target) noexcept;
 
+/**
+ * @brief 256-битный target в виде четырёх 64-битных слов
+ * 
+ * words[0] - младшее слово, words[3] - старшее (тот же little-endian,
+ * что и у Hash256). Сравнение идёт словами от старшего: почти всегда
+ * результат известен после первого сравнения uint64, а не после
+ * десятка побайтовых.
+ */
+struct Target256 {
+    std::array<uint64_t, 4> words{};
+    
+    /**
+     * @brief Загрузить target (или хеш) из Hash256
+     */
+    [[nodiscard]] static Target256 from_hash(const Hash256& value) noexcept {
+        Target256 result;
+        for (std::size_t i = 0; i < result.words.size(); ++i) {
+            result.words[i] = read_le64(value.data() + i * 8);
+        }
+        return result;
+    }
+};
+
+/**
+ * @brief Target, соответствующий difficulty
+ * 
+ * target = max_target / difficulty. Для difficulty <= 1e-12 (и не
+ * положительной) возвращается максимальный 256-битный target.
+ * 
+ * @param difficulty Сложность shares
+ * @return Target256 Hash дотягивает до difficulty, если hash <= target
+ */
+[[nodiscard]] Target256 difficulty_to_target(double difficulty) noexcept;
+
+/**
+ * @brief Проверить, что хеш удовлетворяет заранее загруженному target
+ * 
+ * @param hash Хеш блока
+ * @param target Target, подготовленный from_hash() или difficulty_to_target()
+ * @return true если hash <= target
+ */
+[[nodiscard]] inline bool meets_target(const Hash256& hash, const Target256& target) noexcept {
+    for (std::size_t i = target.words.size(); i-- > 0;) {
+        uint64_t word = read_le64(hash.data() + i * 8);
+        if (word != target.words[i]) {
+            return word < target.words[i];
+        }
+    }
+    return true;  // hash == target
+}
+
 /**
  * @brief Проверить, что хеш удовлетворяет compact bits
  * 
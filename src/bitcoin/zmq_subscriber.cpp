@@ -0,0 +1,340 @@
+/**
+ * @file zmq_subscriber.cpp
+ * @brief Реализация подписчика на ZMQ уведомления узла
+ *
+ * Кадры принимаются в zmq_msg_t: для больших сообщений libzmq отдаёт
+ * собственный буфер приёма, и блок разбирается прямо в нём.
+ */
+
+#include "zmq_subscriber.hpp"
+#include "../core/thread_plan.hpp"
+#include "../shm/placement.hpp"
+
+#ifdef QUAXIS_HAS_ZMQ
+#include <zmq.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <format>
+#include <thread>
+
+namespace quaxis::bitcoin {
+
+// =============================================================================
+// Разбор кадров уведомлений
+// =============================================================================
+
+std::optional<ZmqRawBlock> decode_zmq_rawblock(ByteSpan data) noexcept {
+    if (data.size() < constants::BLOCK_HEADER_SIZE) {
+        return std::nullopt;
+    }
+    auto height = block_coinbase_height(data);
+    if (!height) {
+        return std::nullopt;
+    }
+    auto header = BlockHeader::deserialize(data);
+    if (!header) {
+        return std::nullopt;
+    }
+
+    ZmqRawBlock block;
+    block.header = *header;
+    block.hash = crypto::sha256d(data.first(constants::BLOCK_HEADER_SIZE));
+    block.height = *height;
+    return block;
+}
+
+std::optional<Hash256> decode_zmq_hashblock(ByteSpan data) noexcept {
+    Hash256 hash;
+    if (data.size() != hash.size()) {
+        return std::nullopt;
+    }
+    std::reverse_copy(data.begin(), data.end(), hash.begin());
+    return hash;
+}
+
+std::optional<uint32_t> decode_zmq_sequence(ByteSpan data) noexcept {
+    if (data.size() != sizeof(uint32_t)) {
+        return std::nullopt;
+    }
+    return static_cast<uint32_t>(data[0]) |
+           static_cast<uint32_t>(data[1]) << 8 |
+           static_cast<uint32_t>(data[2]) << 16 |
+           static_cast<uint32_t>(data[3]) << 24;
+}
+
+// =============================================================================
+// Реализация (PIMPL)
+// =============================================================================
+
+struct ZmqSubscriber::Impl {
+    ZmqConfig config;
+    NewBlockCallback callback;
+    BlockHashCallback hash_callback;
+    RawTxCallback tx_callback;
+
+    std::atomic<bool> running{false};
+    std::thread worker_thread;
+
+    std::atomic<uint64_t> blocks{0};
+    std::atomic<uint64_t> lost{0};
+    std::atomic<uint64_t> malformed{0};
+
+    // Последний номер сообщения по темам (nullopt - ещё не было)
+    std::optional<uint32_t> last_rawblock_seq;
+    std::optional<uint32_t> last_hashblock_seq;
+    std::optional<uint32_t> last_rawtx_seq;
+
+    void* context = nullptr;
+    void* socket = nullptr;
+
+    explicit Impl(const ZmqConfig& cfg) : config(cfg) {}
+
+    ~Impl() {
+        stop();
+    }
+
+    void stop() {
+        running.store(false, std::memory_order_relaxed);
+        if (worker_thread.joinable()) {
+            worker_thread.join();
+        }
+        close();
+    }
+
+    /**
+     * @brief Учесть номер сообщения темы: пропуски - потерянные уведомления
+     */
+    void track_sequence(std::optional<uint32_t>& last, std::optional<uint32_t> seq) noexcept {
+        if (!seq) {
+            return;
+        }
+        if (last) {
+            const uint32_t gap = *seq - *last;
+            if (gap > 1) {
+                lost.fetch_add(gap - 1, std::memory_order_relaxed);
+            }
+        }
+        last = seq;
+    }
+
+    /**
+     * @brief Обработать сообщение: тема, тело, номер
+     */
+    void handle(ByteSpan topic, ByteSpan body, ByteSpan sequence) {
+        const std::string_view name(reinterpret_cast<const char*>(topic.data()), topic.size());
+        const auto seq = decode_zmq_sequence(sequence);
+
+        if (name == ZMQ_TOPIC_RAWBLOCK) {
+            track_sequence(last_rawblock_seq, seq);
+            auto block = decode_zmq_rawblock(body);
+            if (!block) {
+                malformed.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            blocks.fetch_add(1, std::memory_order_relaxed);
+            if (callback) {
+                callback(block->header, block->height, block_subsidy(block->height + 1), false);
+            }
+        } else if (name == ZMQ_TOPIC_HASHBLOCK) {
+            track_sequence(last_hashblock_seq, seq);
+            auto hash = decode_zmq_hashblock(body);
+            if (!hash) {
+                malformed.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            if (hash_callback) {
+                hash_callback(*hash);
+            }
+        } else if (name == ZMQ_TOPIC_RAWTX) {
+            track_sequence(last_rawtx_seq, seq);
+            if (body.empty()) {
+                malformed.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            if (tx_callback) {
+                tx_callback(body);
+            }
+        }
+    }
+
+#ifdef QUAXIS_HAS_ZMQ
+
+    Result<void> fail(const char* what) {
+        auto message = std::format("ZMQ {}: {}", what, zmq_strerror(zmq_errno()));
+        close();
+        return Err<void>(ErrorCode::NetworkConnectionFailed, message);
+    }
+
+    Result<void> open() {
+        context = zmq_ctx_new();
+        if (context == nullptr) {
+            return fail("zmq_ctx_new");
+        }
+        socket = zmq_socket(context, ZMQ_SUB);
+        if (socket == nullptr) {
+            return fail("zmq_socket");
+        }
+
+        const int timeout = static_cast<int>(config.receive_timeout_ms);
+        const int linger = 0;
+        if (zmq_setsockopt(socket, ZMQ_RCVTIMEO, &timeout, sizeof(timeout)) != 0 ||
+            zmq_setsockopt(socket, ZMQ_LINGER, &linger, sizeof(linger)) != 0) {
+            return fail("zmq_setsockopt");
+        }
+        if (zmq_setsockopt(socket, ZMQ_SUBSCRIBE, ZMQ_TOPIC_RAWBLOCK.data(), ZMQ_TOPIC_RAWBLOCK.size()) != 0) {
+            return fail("subscribe rawblock");
+        }
+        if (hash_callback &&
+            zmq_setsockopt(socket, ZMQ_SUBSCRIBE, ZMQ_TOPIC_HASHBLOCK.data(), ZMQ_TOPIC_HASHBLOCK.size()) != 0) {
+            return fail("subscribe hashblock");
+        }
+        if (tx_callback &&
+            zmq_setsockopt(socket, ZMQ_SUBSCRIBE, ZMQ_TOPIC_RAWTX.data(), ZMQ_TOPIC_RAWTX.size()) != 0) {
+            return fail("subscribe rawtx");
+        }
+        if (zmq_connect(socket, config.endpoint.c_str()) != 0) {
+            return fail(config.endpoint.c_str());
+        }
+        return {};
+    }
+
+    void close() {
+        if (socket != nullptr) {
+            zmq_close(socket);
+            socket = nullptr;
+        }
+        if (context != nullptr) {
+            zmq_ctx_term(context);
+            context = nullptr;
+        }
+    }
+
+    static ByteSpan frame(zmq_msg_t& msg) noexcept {
+        return ByteSpan(static_cast<const uint8_t*>(zmq_msg_data(&msg)), zmq_msg_size(&msg));
+    }
+
+    void worker_loop() {
+        zmq_msg_t parts[3];
+        for (auto& part : parts) {
+            zmq_msg_init(&part);
+        }
+
+        while (running.load(std::memory_order_relaxed)) {
+            // Остальные кадры сообщения приходят вместе с первым
+            if (zmq_msg_recv(&parts[0], socket, 0) < 0) {
+                if (zmq_errno() == EAGAIN || zmq_errno() == EINTR) {
+                    continue;
+                }
+                running.store(false, std::memory_order_relaxed);
+                break;
+            }
+            std::size_t count = 1;
+            bool more = zmq_msg_more(&parts[0]) != 0;
+            while (more) {
+                zmq_msg_t& target = count < 3 ? parts[count] : parts[2];
+                if (zmq_msg_recv(&target, socket, 0) < 0) {
+                    break;
+                }
+                ++count;
+                more = zmq_msg_more(&target) != 0;
+            }
+
+            if (count != 3) {
+                malformed.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+            handle(frame(parts[0]), frame(parts[1]), frame(parts[2]));
+        }
+
+        for (auto& part : parts) {
+            zmq_msg_close(&part);
+        }
+    }
+
+#else // !QUAXIS_HAS_ZMQ
+
+    Result<void> open() {
+        return Err<void>(ErrorCode::NetworkConnectionFailed, "ZMQ не поддерживается сборкой (нет libzmq)");
+    }
+
+    void close() {}
+
+    void worker_loop() {}
+
+#endif // QUAXIS_HAS_ZMQ
+};
+
+// =============================================================================
+// Публичный интерфейс
+// =============================================================================
+
+ZmqSubscriber::ZmqSubscriber(const ZmqConfig& config)
+    : impl_(std::make_unique<Impl>(config))
+{
+}
+
+ZmqSubscriber::~ZmqSubscriber() = default;
+
+void ZmqSubscriber::set_callback(NewBlockCallback callback) {
+    impl_->callback = std::move(callback);
+}
+
+void ZmqSubscriber::set_hash_callback(BlockHashCallback callback) {
+    impl_->hash_callback = std::move(callback);
+}
+
+void ZmqSubscriber::set_tx_callback(RawTxCallback callback) {
+    impl_->tx_callback = std::move(callback);
+}
+
+Result<void> ZmqSubscriber::start() {
+    if (impl_->running.load()) {
+        return {};  // Уже запущен
+    }
+
+    auto result = impl_->open();
+    if (!result) {
+        return result;
+    }
+
+    impl_->running.store(true, std::memory_order_relaxed);
+    impl_->worker_thread = std::thread([this] {
+        core::enter_thread_role(core::ThreadRole::BlockPath, impl_->config.cpu_affinity >= 0);
+        impl_->worker_loop();
+    });
+
+    if (impl_->config.cpu_affinity >= 0) {
+        auto pinned = shm::pin_thread_to_cpu(impl_->worker_thread, impl_->config.cpu_affinity);
+        if (!pinned) {
+            impl_->stop();
+            return pinned;
+        }
+    }
+
+    return {};
+}
+
+void ZmqSubscriber::stop() {
+    impl_->stop();
+}
+
+bool ZmqSubscriber::is_running() const noexcept {
+    return impl_->running.load(std::memory_order_relaxed);
+}
+
+uint64_t ZmqSubscriber::blocks_received() const noexcept {
+    return impl_->blocks.load(std::memory_order_relaxed);
+}
+
+uint64_t ZmqSubscriber::lost_notifications() const noexcept {
+    return impl_->lost.load(std::memory_order_relaxed);
+}
+
+uint64_t ZmqSubscriber::malformed_messages() const noexcept {
+    return impl_->malformed.load(std::memory_order_relaxed);
+}
+
+} // namespace quaxis::bitcoin
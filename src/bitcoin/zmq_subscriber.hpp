@@ -0,0 +1,202 @@
+/**
+ * @file zmq_subscriber.hpp
+ * @brief Подписчик на ZMQ уведомления узла (rawblock / hashblock / rawtx)
+ *
+ * Bitcoin Core с -zmqpubrawblock публикует каждый новый блок тремя
+ * кадрами: тема ("rawblock"), сериализованный блок и 4-байтный номер
+ * сообщения (little-endian, свой счётчик у каждой темы). hashblock
+ * несёт только хеш блока (32 байта в порядке RPC), rawtx (с
+ * -zmqpubrawtx) - сериализованную транзакцию, принятую в mempool.
+ *
+ * ZmqSubscriber - источник новых блоков наравне с ShmSubscriber и с тем
+ * же NewBlockCallback: заголовок разбирается прямо из буфера принятого
+ * zmq_msg_t (без копии блока), высота - из BIP34 префикса coinbase.
+ * Пропуски номера сообщения считаются потерянными уведомлениями
+ * (переполнение очереди ZMQ_RCVHWM, переподключение).
+ *
+ * Без libzmq в сборке (QUAXIS_HAS_ZMQ не определён) start() возвращает
+ * ошибку; разбор кадров доступен всегда.
+ */
+
+#pragma once
+
+#include "../core/types.hpp"
+#include "../core/config.hpp"
+#include "block.hpp"
+#include "shm_subscriber.hpp"
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string_view>
+
+namespace quaxis::bitcoin {
+
+// =============================================================================
+// Разбор кадров уведомлений
+// =============================================================================
+
+/// @brief Тема уведомления с сериализованным блоком
+inline constexpr std::string_view ZMQ_TOPIC_RAWBLOCK = "rawblock";
+
+/// @brief Тема уведомления с хешем блока
+inline constexpr std::string_view ZMQ_TOPIC_HASHBLOCK = "hashblock";
+
+/// @brief Тема уведомления с транзакцией mempool
+inline constexpr std::string_view ZMQ_TOPIC_RAWTX = "rawtx";
+
+/**
+ * @brief Новый блок из кадра rawblock
+ */
+struct ZmqRawBlock {
+    /// @brief Заголовок блока
+    BlockHeader header;
+
+    /// @brief Хеш блока (внутренний порядок байт)
+    Hash256 hash{};
+
+    /// @brief Высота блока (BIP34)
+    uint32_t height{0};
+};
+
+/**
+ * @brief Разобрать кадр rawblock
+ *
+ * Читает заголовок и начало coinbase прямо из data; остальные
+ * транзакции не разбираются.
+ *
+ * @param data Сериализованный блок
+ * @return Блок или nullopt (короче заголовка, coinbase без высоты)
+ */
+[[nodiscard]] std::optional<ZmqRawBlock> decode_zmq_rawblock(ByteSpan data) noexcept;
+
+/**
+ * @brief Разобрать кадр hashblock
+ *
+ * @param data 32 байта хеша в порядке RPC (big-endian)
+ * @return Хеш во внутреннем порядке или nullopt (неверная длина)
+ */
+[[nodiscard]] std::optional<Hash256> decode_zmq_hashblock(ByteSpan data) noexcept;
+
+/**
+ * @brief Разобрать кадр номера сообщения
+ *
+ * @param data 4 байта little-endian
+ * @return Номер или nullopt (неверная длина)
+ */
+[[nodiscard]] std::optional<uint32_t> decode_zmq_sequence(ByteSpan data) noexcept;
+
+// =============================================================================
+// Callback тип
+// =============================================================================
+
+/**
+ * @brief Callback для уведомления hashblock
+ *
+ * @param block_hash Хеш нового блока (внутренний порядок байт)
+ */
+using BlockHashCallback = std::function<void(const Hash256& block_hash)>;
+
+/**
+ * @brief Callback для уведомления rawtx
+ *
+ * @param raw_tx Сериализованная транзакция (действительна только внутри вызова)
+ */
+using RawTxCallback = std::function<void(ByteSpan raw_tx)>;
+
+// =============================================================================
+// ZMQ Subscriber
+// =============================================================================
+
+/**
+ * @brief Подписчик на ZMQ уведомления узла о новых блоках
+ *
+ * Работает в отдельном потоке: ждёт сообщение не дольше
+ * receive_timeout_ms, чтобы заметить stop(). Блоки из ZMQ узел уже
+ * проверил: NewBlockCallback вызывается с is_speculative = false и
+ * coinbase_value = субсидия следующего блока (без комиссий).
+ */
+class ZmqSubscriber {
+public:
+    /**
+     * @brief Создать подписчик
+     *
+     * @param config Конфигурация ZMQ
+     */
+    explicit ZmqSubscriber(const ZmqConfig& config);
+
+    /**
+     * @brief Деструктор - останавливает подписчик
+     */
+    ~ZmqSubscriber();
+
+    // Запрещаем копирование
+    ZmqSubscriber(const ZmqSubscriber&) = delete;
+    ZmqSubscriber& operator=(const ZmqSubscriber&) = delete;
+
+    /**
+     * @brief Установить callback для новых блоков (rawblock)
+     *
+     * @param callback Функция обработки новых блоков
+     */
+    void set_callback(NewBlockCallback callback);
+
+    /**
+     * @brief Установить callback для hashblock
+     *
+     * Подписка на hashblock оформляется в start(), только если callback
+     * установлен.
+     *
+     * @param callback Функция обработки хеша нового блока
+     */
+    void set_hash_callback(BlockHashCallback callback);
+    
+    /**
+     * @brief Установить callback для rawtx
+     *
+     * Подписка на rawtx оформляется в start(), только если callback
+     * установлен.
+     *
+     * @param callback Функция обработки транзакции mempool
+     */
+    void set_tx_callback(RawTxCallback callback);
+
+    /**
+     * @brief Подключиться к узлу и запустить поток приёма
+     *
+     * @return Result<void> Успех или ошибка создания сокета / подключения
+     */
+    [[nodiscard]] Result<void> start();
+
+    /**
+     * @brief Остановить подписчик
+     */
+    void stop();
+
+    /**
+     * @brief Проверить, запущен ли подписчик
+     */
+    [[nodiscard]] bool is_running() const noexcept;
+
+    /**
+     * @brief Принятые блоки (rawblock)
+     */
+    [[nodiscard]] uint64_t blocks_received() const noexcept;
+
+    /**
+     * @brief Уведомления, пропущенные по номеру сообщения
+     */
+    [[nodiscard]] uint64_t lost_notifications() const noexcept;
+
+    /**
+     * @brief Сообщения, которые не удалось разобрать
+     */
+    [[nodiscard]] uint64_t malformed_messages() const noexcept;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace quaxis::bitcoin
@@ -4,11 +4,27 @@
  */
 
 #include "bitcoin_bridge.hpp"
+#include "../core/async_log.hpp"
+#include "../core/byte_order.hpp"
 
-#include <iostream>
 
 namespace quaxis::bridge {
 
+namespace {
+
+/**
+ * @brief Хеш из hex в том же порядке байт (поля Stratum V2)
+ */
+[[nodiscard]] std::optional<Hash256> hash_from_hex(std::string_view hex) {
+    Hash256 hash{};
+    if (hex.size() != hash.size() * 2 || !hex_decode(hex, hash.data())) {
+        return std::nullopt;
+    }
+    return hash;
+}
+
+} // anonymous namespace
+
 // =============================================================================
 // Реализация
 // =============================================================================
@@ -22,13 +38,28 @@ struct BitcoinBridge::Impl {
     // SHM подписчик
     std::unique_ptr<bitcoin::ShmSubscriber> shm_subscriber;
     
+    // Подписчик на полный шаблон (второй сегмент SHM)
+    std::unique_ptr<bitcoin::ShmTemplateSubscriber> template_subscriber;
+    
+    // getblocktemplate longpoll узла
+    std::unique_ptr<bitcoin::RpcLongPoller> rpc_poller;
+    
     // Fallback менеджер
     std::unique_ptr<fallback::FallbackManager> fallback_manager;
     
     // Текущий шаблон
     std::optional<BlockTemplate> current_template;
+    
+    // Hot standby: последнее задание Stratum, пока пул не активен
+    std::optional<BlockTemplate> standby_template;
+    
+    // Hot standby: последний шаблон RPC, пока активен SHM
+    std::optional<BlockTemplate> rpc_standby_template;
     mutable std::mutex template_mutex;
     
+    // Гонка источников нового блока
+    TipRace race;
+    
     // Callbacks
     NewTemplateCallback template_callback;
     SourceChangeCallback source_change_callback;
@@ -40,7 +71,55 @@ struct BitcoinBridge::Impl {
         // Создаём SHM подписчик если включён
         if (config.shm.enabled) {
             shm_subscriber = std::make_unique<bitcoin::ShmSubscriber>(config.shm);
+            if (config.shm.template_enabled) {
+                template_subscriber = std::make_unique<bitcoin::ShmTemplateSubscriber>(config.shm);
+            }
+        }
+        
+        if (config.rpc) {
+            rpc_poller = std::make_unique<bitcoin::RpcLongPoller>(*config.rpc);
+        }
+    }
+    
+    void publish_template(const BlockTemplate& tmpl, bool signal_source = true) {
+        // Обновляем шаблон
+        {
+            std::lock_guard<std::mutex> lock(template_mutex);
+            current_template = tmpl;
+        }
+        
+        // Сигнализируем о получении
+        if (fallback_manager && signal_source) {
+            fallback_manager->signal_job_received(tmpl.source);
+        }
+        
+        // Вызываем callback
+        if (template_callback) {
+            template_callback(tmpl);
+        }
+    }
+    
+    void on_shm_template(std::shared_ptr<const bitcoin::BlockTemplate> full, bool is_speculative) {
+        // Полный шаблон публикуется всегда: он заменяет задания по одному
+        // заголовку, даже если о блоке первым сообщил другой источник
+        if (config.race_sources) {
+            (void)race.report(TipSource::Shm, full->header.prev_block);
         }
+        
+        BlockTemplate tmpl;
+        tmpl.header = full->header;
+        tmpl.height = full->height;
+        tmpl.bits = full->header.bits;
+        tmpl.target = full->target;
+        tmpl.coinbase_value = full->coinbase_value;
+        tmpl.prev_block_hash = full->header.prev_block;
+        tmpl.merkle_root = full->header.merkle_root;
+        tmpl.received_at = std::chrono::steady_clock::now();
+        tmpl.source = fallback::FallbackMode::PrimarySHM;
+        tmpl.is_speculative = is_speculative;
+        tmpl.full_template = std::move(full);
+        
+        publish_template(tmpl);
     }
     
     void on_shm_block(
@@ -49,6 +128,11 @@ struct BitcoinBridge::Impl {
         int64_t coinbase_value,
         bool is_speculative
     ) {
+        if (config.race_sources) {
+            on_raced_tip(TipSource::Shm, header, height, coinbase_value, is_speculative);
+            return;
+        }
+        
         BlockTemplate tmpl;
         tmpl.header = header;
         tmpl.height = height;
@@ -60,24 +144,101 @@ struct BitcoinBridge::Impl {
         tmpl.source = fallback::FallbackMode::PrimarySHM;
         tmpl.is_speculative = is_speculative;
         
-        // Обновляем шаблон
-        {
-            std::lock_guard<std::mutex> lock(template_mutex);
-            current_template = tmpl;
+        publish_template(tmpl);
+    }
+    
+    /**
+     * @brief Сообщение о новом блоке в режиме гонки
+     * 
+     * Ключ гонки - хеш самого блока: прочие источники знают его,
+     * даже когда передают только хеш (ZMQ hashblock).
+     */
+    bool on_raced_tip(
+        TipSource source,
+        const bitcoin::BlockHeader& header,
+        uint32_t height,
+        int64_t coinbase_value,
+        bool is_speculative
+    ) {
+        auto received_at = std::chrono::steady_clock::now();
+        if (!race.report(source, header.hash(), received_at)) {
+            return false;
         }
         
-        // Сигнализируем о получении
-        if (fallback_manager) {
-            fallback_manager->signal_job_received();
+        BlockTemplate tmpl;
+        tmpl.header = header;
+        tmpl.height = height;
+        tmpl.bits = header.bits;
+        tmpl.coinbase_value = coinbase_value;
+        tmpl.prev_block_hash = header.prev_block;
+        tmpl.merkle_root = header.merkle_root;
+        tmpl.received_at = received_at;
+        tmpl.is_speculative = is_speculative;
+        tmpl.tip_source = source;
+        
+        // Здоровье fallback ведётся только для источников с режимом
+        bool signal_source = true;
+        switch (source) {
+            case TipSource::Shm:          tmpl.source = fallback::FallbackMode::PrimarySHM; break;
+            case TipSource::ZmqHashblock: tmpl.source = fallback::FallbackMode::FallbackZMQ; break;
+            default:
+                tmpl.source = fallback::FallbackMode::PrimarySHM;
+                signal_source = false;
+                break;
         }
         
-        // Вызываем callback
-        if (template_callback) {
-            template_callback(tmpl);
+        publish_template(tmpl, signal_source);
+        return true;
+    }
+    
+    /**
+     * @brief Шаблон getblocktemplate (longpoll)
+     * 
+     * Ключ гонки - previousblockhash: это хеш нового tip, тот же, что
+     * сообщают остальные источники.
+     */
+    void on_rpc_template(const bitcoin::BlockTemplateData& data) {
+        auto received_at = std::chrono::steady_clock::now();
+        
+        BlockTemplate tmpl;
+        tmpl.header.version = data.version;
+        tmpl.header.prev_block = data.prev_blockhash;
+        tmpl.header.timestamp = data.curtime;
+        tmpl.header.bits = data.bits;
+        tmpl.height = data.height;
+        tmpl.bits = data.bits;
+        tmpl.coinbase_value = data.coinbase_value;
+        tmpl.prev_block_hash = data.prev_blockhash;
+        tmpl.received_at = received_at;
+        tmpl.source = fallback::FallbackMode::FallbackZMQ;
+        tmpl.is_speculative = false;
+        tmpl.tip_source = TipSource::Rpc;
+        
+        if (config.race_sources) {
+            if (race.report(TipSource::Rpc, data.prev_blockhash, received_at)) {
+                publish_template(tmpl, false);
+            }
+            return;
         }
+        
+        // Узел без SHM - режим ZMQ: шаблоны RPC становятся заданиями
+        if (fallback_manager->current_mode() != fallback::FallbackMode::FallbackZMQ) {
+            {
+                std::lock_guard<std::mutex> lock(template_mutex);
+                rpc_standby_template = std::move(tmpl);
+            }
+            fallback_manager->signal_job_received(fallback::FallbackMode::FallbackZMQ);
+            return;
+        }
+        
+        publish_template(tmpl);
     }
     
-    void on_stratum_job(const fallback::StratumJob& job) {
+    void on_stratum_job(
+        const fallback::StratumJob& job,
+        const std::string& extranonce1,
+        uint32_t extranonce2_size
+    ) {
         BlockTemplate tmpl;
         tmpl.job_id = job.job_id;
         tmpl.coinbase1 = job.coinbase1;
@@ -85,13 +246,8 @@ struct BitcoinBridge::Impl {
         tmpl.received_at = std::chrono::steady_clock::now();
         tmpl.source = fallback::FallbackMode::FallbackStratum;
         tmpl.is_speculative = false;
-        
-        // Получаем extranonce из клиента
-        auto* client = fallback_manager->get_stratum_client();
-        if (client) {
-            tmpl.extranonce1 = client->get_extranonce1();
-            tmpl.extranonce2_size = client->get_extranonce2_size();
-        }
+        tmpl.extranonce1 = extranonce1;
+        tmpl.extranonce2_size = extranonce2_size;
         
         // Парсим hex данные из job
         // version
@@ -116,19 +272,56 @@ struct BitcoinBridge::Impl {
             );
         }
         
-        // Обновляем шаблон
-        {
-            std::lock_guard<std::mutex> lock(template_mutex);
-            current_template = tmpl;
+        // Stratum V2 standard channel: заголовок целиком, coinbase не нужен
+        if (!job.merkle_root.empty()) {
+            auto prev_block = hash_from_hex(job.prevhash);
+            auto merkle_root = hash_from_hex(job.merkle_root);
+            if (prev_block && merkle_root) {
+                tmpl.header.prev_block = *prev_block;
+                tmpl.header.merkle_root = *merkle_root;
+                tmpl.prev_block_hash = *prev_block;
+                tmpl.merkle_root = *merkle_root;
+            }
         }
         
-        // Вызываем callback
-        if (template_callback) {
-            template_callback(tmpl);
+        // Hot standby: пул не активен - шаблон ждёт переключения готовым
+        if (fallback_manager->current_mode() != fallback::FallbackMode::FallbackStratum) {
+            {
+                std::lock_guard<std::mutex> lock(template_mutex);
+                standby_template = std::move(tmpl);
+            }
+            fallback_manager->signal_job_received(fallback::FallbackMode::FallbackStratum);
+            return;
         }
+        
+        publish_template(tmpl);
     }
     
     void on_mode_change(fallback::FallbackMode old_mode, fallback::FallbackMode new_mode) {
+        // Переход на пул в hot standby: задание уже готово, майнинг без паузы
+        if (new_mode == fallback::FallbackMode::FallbackStratum) {
+            std::optional<BlockTemplate> standby;
+            {
+                std::lock_guard<std::mutex> lock(template_mutex);
+                standby.swap(standby_template);
+            }
+            if (standby) {
+                publish_template(*standby);
+            }
+        }
+        
+        // Переход на узел без SHM: последний шаблон RPC уже есть
+        if (new_mode == fallback::FallbackMode::FallbackZMQ) {
+            std::optional<BlockTemplate> standby;
+            {
+                std::lock_guard<std::mutex> lock(template_mutex);
+                standby.swap(rpc_standby_template);
+            }
+            if (standby) {
+                publish_template(*standby);
+            }
+        }
+        
         // Вызываем callback
         if (source_change_callback) {
             source_change_callback(old_mode, new_mode);
@@ -164,11 +357,31 @@ Result<void> BitcoinBridge::start() {
         auto result = impl_->shm_subscriber->start();
         if (!result) {
             // SHM не удалось запустить - это нормально, используем fallback
-            std::cerr << "[BitcoinBridge] SHM недоступен: " 
-                      << result.error().message << std::endl;
+            QUAXIS_LOG(Warning, "[BitcoinBridge] SHM недоступен: {}", result.error().message);
         }
     }
     
+    if (impl_->template_subscriber) {
+        impl_->template_subscriber->set_callback(
+            [this](std::shared_ptr<const bitcoin::BlockTemplate> full, bool is_speculative) {
+                impl_->on_shm_template(std::move(full), is_speculative);
+            }
+        );
+        
+        auto result = impl_->template_subscriber->start();
+        if (!result) {
+            // Без сегмента шаблона остаётся сегмент блока
+            QUAXIS_LOG(Warning, "[BitcoinBridge] SHM шаблон недоступен: {}", result.error().message);
+        }
+    }
+    
+    if (impl_->rpc_poller) {
+        impl_->rpc_poller->set_callback([this](const bitcoin::BlockTemplateData& data) {
+            impl_->on_rpc_template(data);
+        });
+        impl_->rpc_poller->start();
+    }
+    
     // Настраиваем health check для fallback
     if (impl_->fallback_manager) {
         impl_->fallback_manager->set_shm_health_check([this]() {
@@ -176,6 +389,13 @@ Result<void> BitcoinBridge::start() {
             return impl_->shm_subscriber->is_running();
         });
         
+        // Режим ZMQ держится на узле: здоров, пока отвечает longpoll
+        if (impl_->rpc_poller) {
+            impl_->fallback_manager->set_zmq_health_check([this]() {
+                return impl_->rpc_poller->is_connected();
+            });
+        }
+        
         impl_->fallback_manager->set_mode_change_callback(
             [this](fallback::FallbackMode old_mode, fallback::FallbackMode new_mode) {
                 impl_->on_mode_change(old_mode, new_mode);
@@ -185,12 +405,26 @@ Result<void> BitcoinBridge::start() {
         // Настраиваем Stratum callback
         auto* client = impl_->fallback_manager->get_stratum_client();
         if (client) {
-            client->set_job_callback([this](const fallback::StratumJob& job) {
-                impl_->on_stratum_job(job);
+            client->set_job_callback([this, client](const fallback::StratumJob& job) {
+                impl_->on_stratum_job(job, client->get_extranonce1(), client->get_extranonce2_size());
             });
             
-            client->set_disconnect_callback([](const std::string& reason) {
-                std::cerr << "[BitcoinBridge] Stratum disconnected: " << reason << std::endl;
+            client->set_disconnect_callback([this](const std::string& reason) {
+                QUAXIS_LOG(Warning, "[BitcoinBridge] Stratum disconnected: {}", reason);
+                impl_->fallback_manager->signal_source_failure(fallback::FallbackMode::FallbackStratum);
+            });
+        }
+        
+        // Параллельные пулы: задание приходит с extranonce выдавшего пула
+        auto* pool_set = impl_->fallback_manager->get_stratum_pool_set();
+        if (pool_set) {
+            pool_set->set_job_callback([this](const fallback::PoolJob& pool_job) {
+                impl_->on_stratum_job(pool_job.job, pool_job.extranonce1, pool_job.extranonce2_size);
+            });
+            
+            pool_set->set_disconnect_callback([this](const std::string& reason) {
+                QUAXIS_LOG(Warning, "[BitcoinBridge] Все Stratum пулы отключены: {}", reason);
+                impl_->fallback_manager->signal_source_failure(fallback::FallbackMode::FallbackStratum);
             });
         }
         
@@ -205,6 +439,13 @@ Result<void> BitcoinBridge::start() {
 void BitcoinBridge::stop() {
     impl_->running = false;
     
+    if (impl_->rpc_poller) {
+        impl_->rpc_poller->stop();
+    }
+    
+    if (impl_->template_subscriber) {
+        impl_->template_subscriber->stop();
+    }
     if (impl_->shm_subscriber) {
         impl_->shm_subscriber->stop();
     }
@@ -253,6 +494,30 @@ bool BitcoinBridge::is_bitcoin_connected() const {
     return false;
 }
 
+std::array<TipSourceStats, TIP_SOURCE_COUNT> BitcoinBridge::get_race_stats() const {
+    return impl_->race.stats();
+}
+
+bool BitcoinBridge::report_tip(
+    TipSource source,
+    const bitcoin::BlockHeader& header,
+    uint32_t height,
+    int64_t coinbase_value,
+    bool is_speculative
+) {
+    if (!impl_->config.race_sources) {
+        return false;
+    }
+    return impl_->on_raced_tip(source, header, height, coinbase_value, is_speculative);
+}
+
+bool BitcoinBridge::report_block_hash(TipSource source, const Hash256& block_hash) {
+    if (!impl_->config.race_sources) {
+        return false;
+    }
+    return impl_->race.report(source, block_hash);
+}
+
 uint64_t BitcoinBridge::get_current_job_age_ms() const {
     std::lock_guard<std::mutex> lock(impl_->template_mutex);
     
@@ -277,6 +542,15 @@ Result<bool> BitcoinBridge::submit_share(
     auto mode = current_source();
     
     if (mode == fallback::FallbackMode::FallbackStratum) {
+        // Параллельные пулы: share уходит пулу, выдавшему задание
+        if (auto* pool_set = impl_->fallback_manager->get_stratum_pool_set()) {
+            auto result = pool_set->submit(job_id, extranonce2, ntime, nonce);
+            if (!result) {
+                return std::unexpected(result.error());
+            }
+            return result->accepted;
+        }
+        
         auto* client = impl_->fallback_manager->get_stratum_client();
         if (!client) {
             return std::unexpected(Error{ErrorCode::NetworkConnectionFailed, 
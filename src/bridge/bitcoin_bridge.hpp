@@ -8,14 +8,28 @@
  * 3. Stratum - второй резерв (пул)
  * 
  * Автоматически переключается между источниками при проблемах.
+ * 
+ * Режим гонки (BridgeConfig::race_sources): источники нового блока
+ * (SHM, FIBRE header, ZMQ hashblock, P2P headers, RPC) открыты
+ * одновременно, шаблон публикуется по первому сообщению о блоке,
+ * повторы отбрасываются по хешу (TipRace).
+ * 
+ * RPC узла (BridgeConfig::rpc) - getblocktemplate longpoll: шаблон
+ * приходит при смене tip, а не по интервалу опроса. Пока активен SHM,
+ * шаблон RPC держится в hot standby и публикуется при переходе в режим
+ * ZMQ (узел доступен без SHM); в режиме гонки RPC участвует наравне с
+ * остальными источниками.
  */
 
 #pragma once
 
 #include "../core/types.hpp"
 #include "../bitcoin/block.hpp"
+#include "../bitcoin/rpc_client.hpp"
 #include "../bitcoin/shm_subscriber.hpp"
+#include "../bitcoin/shm_template.hpp"
 #include "../fallback/fallback_manager.hpp"
+#include "tip_race.hpp"
 
 #include <atomic>
 #include <chrono>
@@ -67,6 +81,9 @@ struct BlockTemplate {
     /// @brief Это speculative (spy mining)?
     bool is_speculative{false};
     
+    /// @brief Источник, первым сообщивший о блоке (режим гонки)
+    std::optional<TipSource> tip_source;
+    
     /// @brief Job ID (для Stratum)
     std::string job_id;
     
@@ -79,6 +96,12 @@ struct BlockTemplate {
     
     /// @brief Размер extranonce2 (для Stratum)
     uint32_t extranonce2_size{4};
+    
+    /// @brief Готовый шаблон из сегмента шаблона SHM (разделяемый, без копии)
+    ///
+    /// Передаётся в JobManager::on_new_block() как есть; nullptr для
+    /// источников, дающих только заголовок.
+    std::shared_ptr<const bitcoin::BlockTemplate> full_template;
 };
 
 // =============================================================================
@@ -115,6 +138,12 @@ struct BridgeConfig {
     /// @brief Включить автоматическое переключение
     bool auto_switch{true};
     
+    /// @brief Гонка источников нового блока вместо одного активного
+    bool race_sources{false};
+    
+    /// @brief RPC узла для getblocktemplate longpoll (nullopt - без RPC)
+    std::optional<bitcoin::RpcConfig> rpc;
+    
     /// @brief Интервал health check (секунды)
     uint32_t health_check_interval{1};
 };
@@ -185,6 +214,50 @@ public:
      */
     [[nodiscard]] uint64_t get_current_job_age_ms() const;
     
+    /**
+     * @brief Статистика гонки источников (победы, проигрыши, отставание)
+     */
+    [[nodiscard]] std::array<TipSourceStats, TIP_SOURCE_COUNT> get_race_stats() const;
+    
+    // ==========================================================================
+    // Внешние источники (режим гонки)
+    // ==========================================================================
+    
+    /**
+     * @brief Сообщить о новом блоке с заголовком (FIBRE header, P2P headers)
+     * 
+     * Первое сообщение о блоке публикует шаблон, как блок из SHM;
+     * повторы от других источников только учитываются в статистике.
+     * 
+     * @param source Источник
+     * @param header Заголовок нового блока
+     * @param height Высота блока
+     * @param coinbase_value Награда за блок
+     * @param is_speculative true, если тело блока ещё не проверено
+     * @return true - источник первым сообщил о блоке
+     *         (false и вне режима гонки)
+     */
+    bool report_tip(
+        TipSource source,
+        const bitcoin::BlockHeader& header,
+        uint32_t height,
+        int64_t coinbase_value,
+        bool is_speculative
+    );
+    
+    /**
+     * @brief Сообщить о новом блоке только хешем (ZMQ hashblock, RPC)
+     * 
+     * Шаблон здесь не публикуется: победивший источник сам запрашивает
+     * заголовок (например, по RPC) и передаёт его в report_tip().
+     * 
+     * @param source Источник
+     * @param block_hash Хеш нового блока
+     * @return true - источник первым сообщил о блоке
+     *         (false и вне режима гонки)
+     */
+    bool report_block_hash(TipSource source, const Hash256& block_hash);
+    
     // ==========================================================================
     // Отправка данных
     // ==========================================================================
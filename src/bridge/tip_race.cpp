@@ -0,0 +1,117 @@
+/**
+ * @file tip_race.cpp
+ * @brief Реализация гонки источников нового блока
+ */
+
+#include "tip_race.hpp"
+
+#include <algorithm>
+#include <mutex>
+
+namespace quaxis::bridge {
+
+// =============================================================================
+// Реализация
+// =============================================================================
+
+struct TipRace::Impl {
+    /// @brief Недавний блок: когда и кем объявлен
+    struct Block {
+        Hash256 hash{};
+        std::chrono::steady_clock::time_point first_seen;
+        TipSource winner{TipSource::Shm};
+        uint32_t reported{0};  // бит на источник
+    };
+
+    struct Counters {
+        uint64_t wins{0};
+        uint64_t losses{0};
+        int64_t average_lag_us{-1};
+    };
+
+    mutable std::mutex mutex;
+
+    // Кольцо последних блоков, blocks[newest] - последний
+    std::array<Block, HISTORY> blocks;
+    std::size_t block_count{0};
+    std::size_t newest{0};
+
+    std::array<Counters, TIP_SOURCE_COUNT> counters;
+
+    [[nodiscard]] Block* find(const Hash256& hash) {
+        for (std::size_t i = 0; i < block_count; ++i) {
+            auto& block = blocks[(newest + HISTORY - i) % HISTORY];
+            if (block.hash == hash) {
+                return &block;
+            }
+        }
+        return nullptr;
+    }
+};
+
+// =============================================================================
+// Публичный API
+// =============================================================================
+
+TipRace::TipRace() : impl_(std::make_unique<Impl>()) {}
+
+TipRace::~TipRace() = default;
+
+bool TipRace::report(
+    TipSource source,
+    const Hash256& block_hash,
+    std::chrono::steady_clock::time_point seen_at
+) {
+    const auto index = static_cast<std::size_t>(source);
+    const uint32_t bit = uint32_t{1} << index;
+
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    auto& counters = impl_->counters[index];
+
+    auto* block = impl_->find(block_hash);
+    if (!block) {
+        impl_->newest = (impl_->newest + 1) % HISTORY;
+        impl_->block_count = std::min(impl_->block_count + 1, HISTORY);
+        impl_->blocks[impl_->newest] = Impl::Block{block_hash, seen_at, source, bit};
+        counters.wins++;
+        return true;
+    }
+
+    // Повтор от того же источника (speculative, затем confirmed) - не проигрыш
+    if (block->reported & bit) {
+        return false;
+    }
+    block->reported |= bit;
+
+    auto lag_us = std::chrono::duration_cast<std::chrono::microseconds>(seen_at - block->first_seen).count();
+    lag_us = std::max<int64_t>(lag_us, 0);
+    counters.losses++;
+    counters.average_lag_us = counters.average_lag_us < 0
+        ? lag_us
+        : (counters.average_lag_us * 7 + lag_us) / 8;
+    return false;
+}
+
+std::array<TipSourceStats, TIP_SOURCE_COUNT> TipRace::stats() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+
+    std::array<TipSourceStats, TIP_SOURCE_COUNT> result;
+    for (std::size_t i = 0; i < TIP_SOURCE_COUNT; ++i) {
+        const auto& counters = impl_->counters[i];
+        result[i].source = static_cast<TipSource>(i);
+        result[i].wins = counters.wins;
+        result[i].losses = counters.losses;
+        result[i].average_lag = std::chrono::microseconds(std::max<int64_t>(counters.average_lag_us, 0));
+    }
+    return result;
+}
+
+std::optional<TipSource> TipRace::last_winner() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    if (impl_->block_count == 0) {
+        return std::nullopt;
+    }
+    return impl_->blocks[impl_->newest].winner;
+}
+
+} // namespace quaxis::bridge
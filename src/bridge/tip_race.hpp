@@ -0,0 +1,124 @@
+/**
+ * @file tip_race.hpp
+ * @brief Гонка источников нового блока
+ *
+ * Все источники tip открыты одновременно: SHM, header из FIBRE, ZMQ
+ * hashblock, P2P headers, RPC. Новый блок запускает рассылку заданий от
+ * того источника, который сообщил о нём первым; повторы того же блока
+ * (по хешу) от остальных отбрасываются. Для каждого источника считаются
+ * победы, проигрыши и среднее отставание от победителя - по ним видно,
+ * какой канал быстрее.
+ */
+
+#pragma once
+
+#include "../core/types.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string_view>
+
+namespace quaxis::bridge {
+
+// =============================================================================
+// Источники
+// =============================================================================
+
+/**
+ * @brief Источник сообщения о новом блоке
+ */
+enum class TipSource : uint8_t {
+    Shm,            ///< Сегмент блока / шаблона SHM
+    FibreHeader,    ///< Header-first из FIBRE relay
+    ZmqHashblock,   ///< ZMQ hashblock узла
+    P2pHeaders,     ///< headers от P2P пиров
+    Rpc             ///< getblocktemplate longpoll / опрос узла
+};
+
+/// @brief Количество источников
+inline constexpr std::size_t TIP_SOURCE_COUNT = 5;
+
+/**
+ * @brief Имя источника (для логов и метрик)
+ */
+[[nodiscard]] constexpr std::string_view to_string(TipSource source) noexcept {
+    switch (source) {
+        case TipSource::Shm:          return "shm";
+        case TipSource::FibreHeader:  return "fibre_header";
+        case TipSource::ZmqHashblock: return "zmq_hashblock";
+        case TipSource::P2pHeaders:   return "p2p_headers";
+        case TipSource::Rpc:          return "rpc";
+        default: return "unknown";
+    }
+}
+
+/**
+ * @brief Статистика источника в гонке
+ */
+struct TipSourceStats {
+    /// @brief Источник
+    TipSource source{TipSource::Shm};
+
+    /// @brief Блоков, о которых источник сообщил первым
+    uint64_t wins{0};
+
+    /// @brief Блоков, о которых источник сообщил не первым
+    uint64_t losses{0};
+
+    /// @brief Среднее отставание от победителя в проигранных гонках
+    std::chrono::microseconds average_lag{0};
+};
+
+// =============================================================================
+// Гонка
+// =============================================================================
+
+/**
+ * @brief Первый источник каждого блока и статистика гонки
+ *
+ * Thread-safe: источники сообщают из своих потоков.
+ */
+class TipRace {
+public:
+    /// @brief Сколько последних блоков помнится для отбрасывания повторов
+    static constexpr std::size_t HISTORY = 16;
+
+    TipRace();
+    ~TipRace();
+
+    TipRace(const TipRace&) = delete;
+    TipRace& operator=(const TipRace&) = delete;
+
+    /**
+     * @brief Сообщить о блоке
+     *
+     * @param source Источник
+     * @param block_hash Хеш нового блока (tip)
+     * @param seen_at Время получения
+     * @return true - источник первым сообщил о блоке, задания за ним
+     */
+    [[nodiscard]] bool report(
+        TipSource source,
+        const Hash256& block_hash,
+        std::chrono::steady_clock::time_point seen_at = std::chrono::steady_clock::now()
+    );
+
+    /**
+     * @brief Статистика всех источников (индекс - значение TipSource)
+     */
+    [[nodiscard]] std::array<TipSourceStats, TIP_SOURCE_COUNT> stats() const;
+
+    /**
+     * @brief Победитель последнего блока
+     */
+    [[nodiscard]] std::optional<TipSource> last_winner() const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace quaxis::bridge
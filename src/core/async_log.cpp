@@ -0,0 +1,456 @@
+/**
+ * @file async_log.cpp
+ * @brief Реализация асинхронного лога
+ */
+
+#include "async_log.hpp"
+#include "thread_plan.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <ctime>
+#include <format>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace quaxis::core {
+
+namespace detail {
+std::atomic<uint8_t> g_log_level{static_cast<uint8_t>(LogLevel::Info)};
+} // namespace detail
+
+namespace {
+
+/// @brief Сокет нативного протокола journald
+constexpr const char* JOURNALD_SOCKET = "/run/systemd/journal/socket";
+
+/**
+ * @brief Кольцо записей одного потока
+ *
+ * Писатель - владелец потока, читатель - фоновый поток. Полное кольцо
+ * не перезаписывается: новое сообщение отбрасывается и учитывается.
+ */
+struct alignas(64) LogRing {
+    std::atomic<uint64_t> head{0};
+    alignas(64) std::atomic<uint64_t> tail{0};
+    alignas(64) std::array<LogRecord, LOG_RING_SIZE> records;
+};
+
+/**
+ * @brief Глобальное состояние лога
+ */
+struct LogState {
+    std::atomic<bool> running{false};
+    LogConfig config;
+
+    // Кольца потоков (живут до конца процесса)
+    std::mutex registry_mutex;
+    std::vector<std::unique_ptr<LogRing>> rings;
+
+    std::atomic<uint64_t> dropped{0};
+    uint64_t reported_dropped = 0;
+
+    // Приёмники (только фоновый поток, кроме открытия / закрытия)
+    int file_fd = -1;
+    int journal_fd = -1;
+    std::thread writer;
+
+    /// @brief Синхронный вывод без фонового потока
+    std::mutex direct_mutex;
+
+    // Выход из main() без stop_log(): дописать накопленное
+    ~LogState() {
+        running.store(false, std::memory_order_release);
+        if (writer.joinable()) {
+            writer.join();
+        }
+    }
+};
+
+LogState& state() {
+    static LogState instance;
+    return instance;
+}
+
+LogRing& thread_ring() {
+    thread_local LogRing* ring = nullptr;
+    if (!ring) {
+        auto& st = state();
+        auto owned = std::make_unique<LogRing>();
+        std::lock_guard<std::mutex> lock(st.registry_mutex);
+        ring = owned.get();
+        st.rings.push_back(std::move(owned));
+    }
+    return *ring;
+}
+
+/**
+ * @brief Записать буфер целиком
+ */
+void write_all(int fd, std::string_view data) noexcept {
+    while (!data.empty()) {
+        const ssize_t written = ::write(fd, data.data(), data.size());
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return;
+        }
+        data.remove_prefix(static_cast<std::size_t>(written));
+    }
+}
+
+/**
+ * @brief Строка сообщения без метки времени: "[LEVEL] текст"
+ */
+void append_message(std::string& out, const LogRecord& record) {
+    out += '[';
+    out += to_string(record.site->level);
+    out += "] ";
+    out += format_log_record(record);
+    if (record.suppressed > 0) {
+        out += std::format(" (ещё {} пропущено)", record.suppressed);
+    }
+}
+
+/**
+ * @brief Метка времени файла: "YYYY-MM-DD HH:MM:SS.mmm "
+ */
+void append_timestamp(std::string& out, int64_t timestamp_ns) {
+    const std::time_t seconds = static_cast<std::time_t>(timestamp_ns / 1'000'000'000);
+    const auto millis = static_cast<int>((timestamp_ns / 1'000'000) % 1000);
+    std::tm tm{};
+    localtime_r(&seconds, &tm);
+    char buffer[32];
+    const std::size_t size = std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &tm);
+    out.append(buffer, size);
+    out += std::format(".{:03} ", millis);
+}
+
+/**
+ * @brief Приоритет syslog уровня
+ */
+int syslog_priority(LogLevel level) noexcept {
+    switch (level) {
+        case LogLevel::Error:   return 3;
+        case LogLevel::Warning: return 4;
+        case LogLevel::Info:    return 6;
+        case LogLevel::Debug:   return 7;
+    }
+    return 6;
+}
+
+/**
+ * @brief Вывести пачку записей одним write() на приёмник
+ */
+void write_batch(LogState& st, const std::vector<LogRecord>& batch) {
+    std::string out;
+    std::string err;
+    std::string line;
+    for (const auto& record : batch) {
+        line.clear();
+        switch (st.config.output) {
+            case LogOutput::Console: {
+                append_message(line, record);
+                line += '\n';
+                (record.site->level <= LogLevel::Warning ? err : out) += line;
+                break;
+            }
+            case LogOutput::File:
+                append_timestamp(line, record.timestamp_ns);
+                append_message(line, record);
+                line += '\n';
+                out += line;
+                break;
+            case LogOutput::Journald: {
+                append_message(line, record);
+                std::replace(line.begin(), line.end(), '\n', ' ');
+                const std::string datagram = std::format(
+                    "PRIORITY={}\nSYSLOG_IDENTIFIER=quaxis\nMESSAGE={}\n",
+                    syslog_priority(record.site->level), line);
+                (void)::send(st.journal_fd, datagram.data(), datagram.size(), MSG_NOSIGNAL);
+                break;
+            }
+        }
+    }
+    if (!err.empty()) {
+        write_all(STDERR_FILENO, err);
+    }
+    if (!out.empty()) {
+        write_all(st.config.output == LogOutput::File ? st.file_fd : STDOUT_FILENO, out);
+    }
+}
+
+/**
+ * @brief Вычитать кольца всех потоков в пачку (по времени записи)
+ */
+void collect(LogState& st, std::vector<LogRecord>& batch) {
+    batch.clear();
+    {
+        std::lock_guard<std::mutex> lock(st.registry_mutex);
+        for (auto& ring : st.rings) {
+            const uint64_t head = ring->head.load(std::memory_order_acquire);
+            uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+            for (; tail < head; ++tail) {
+                batch.push_back(ring->records[tail % LOG_RING_SIZE]);
+            }
+            ring->tail.store(tail, std::memory_order_release);
+        }
+    }
+    std::stable_sort(batch.begin(), batch.end(), [](const LogRecord& a, const LogRecord& b) {
+        return a.timestamp_ns < b.timestamp_ns;
+    });
+}
+
+void writer_loop(LogState& st) {
+    enter_thread_role(ThreadRole::Background);
+
+    static LogSite dropped_site{LogLevel::Warning, "Лог: отброшено {} сообщений (кольцо потока заполнено)"};
+    std::vector<LogRecord> batch;
+    batch.reserve(LOG_RING_SIZE);
+    const auto interval = std::chrono::milliseconds(std::max<uint32_t>(st.config.flush_interval_ms, 1));
+
+    for (;;) {
+        const bool stopping = !st.running.load(std::memory_order_acquire);
+        collect(st, batch);
+
+        const uint64_t dropped = st.dropped.load(std::memory_order_relaxed);
+        if (dropped != st.reported_dropped) {
+            LogRecord record;
+            record.site = &dropped_site;
+            record.timestamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+            record.add(dropped - st.reported_dropped);
+            batch.push_back(record);
+            st.reported_dropped = dropped;
+        }
+
+        if (!batch.empty()) {
+            write_batch(st, batch);
+        }
+        if (stopping) {
+            return;
+        }
+        std::this_thread::sleep_for(interval);
+    }
+}
+
+/**
+ * @brief Отформатировать один аргумент по спецификации "{...}"
+ */
+void append_arg(std::string& out, std::string_view spec, const LogRecord& record, const LogArg& arg) {
+    switch (arg.kind) {
+        case LogArg::Kind::Int:
+            out += std::vformat(spec, std::make_format_args(arg.i));
+            break;
+        case LogArg::Kind::Uint:
+            out += std::vformat(spec, std::make_format_args(arg.u));
+            break;
+        case LogArg::Kind::Double:
+            out += std::vformat(spec, std::make_format_args(arg.d));
+            break;
+        case LogArg::Kind::Bool: {
+            const bool value = arg.u != 0;
+            out += std::vformat(spec, std::make_format_args(value));
+            break;
+        }
+        case LogArg::Kind::Text: {
+            const std::string_view value = record.text_of(arg);
+            out += std::vformat(spec, std::make_format_args(value));
+            break;
+        }
+    }
+}
+
+} // anonymous namespace
+
+// =============================================================================
+// Форматирование
+// =============================================================================
+
+std::string format_log_record(const LogRecord& record) {
+    const std::string_view format = record.site->format;
+    std::string out;
+    out.reserve(format.size() + 32);
+
+    std::size_t next_arg = 0;
+    for (std::size_t i = 0; i < format.size(); ++i) {
+        const char c = format[i];
+        if ((c == '{' || c == '}') && i + 1 < format.size() && format[i + 1] == c) {
+            out += c;
+            ++i;
+            continue;
+        }
+        if (c != '{') {
+            out += c;
+            continue;
+        }
+        const std::size_t close = format.find('}', i);
+        if (close == std::string_view::npos || next_arg >= record.arg_count) {
+            out += "{?}";
+            if (close == std::string_view::npos) {
+                break;
+            }
+            i = close;
+            continue;
+        }
+        try {
+            append_arg(out, format.substr(i, close - i + 1), record, record.args[next_arg]);
+        } catch (const std::format_error&) {
+            out += "{?}";
+        }
+        ++next_arg;
+        i = close;
+    }
+    return out;
+}
+
+std::optional<LogLevel> parse_log_level(std::string_view name) noexcept {
+    if (name == "error") return LogLevel::Error;
+    if (name == "warn" || name == "warning") return LogLevel::Warning;
+    if (name == "info") return LogLevel::Info;
+    if (name == "debug") return LogLevel::Debug;
+    return std::nullopt;
+}
+
+std::optional<LogOutput> parse_log_output(std::string_view name) noexcept {
+    if (name == "console") return LogOutput::Console;
+    if (name == "file") return LogOutput::File;
+    if (name == "journald") return LogOutput::Journald;
+    return std::nullopt;
+}
+
+// =============================================================================
+// Горячий путь
+// =============================================================================
+
+namespace detail {
+
+bool log_throttled(LogSite& site) noexcept {
+    if (site.sample_every > 1 &&
+        site.calls.fetch_add(1, std::memory_order_relaxed) % site.sample_every != 0) {
+        return true;
+    }
+    if (site.rate_per_sec > 0) {
+        const int64_t second = std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+        int64_t window = site.window.load(std::memory_order_relaxed);
+        if (window != second && site.window.compare_exchange_strong(window, second, std::memory_order_relaxed)) {
+            site.in_window.store(0, std::memory_order_relaxed);
+        }
+        if (site.in_window.fetch_add(1, std::memory_order_relaxed) >= site.rate_per_sec) {
+            site.suppressed.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+void log_submit(LogRecord& record) noexcept {
+    auto& st = state();
+    if (!st.running.load(std::memory_order_acquire)) {
+        // Без фонового потока (старт, тесты): сразу в консоль
+        try {
+            std::string line;
+            append_message(line, record);
+            line += '\n';
+            std::lock_guard<std::mutex> lock(st.direct_mutex);
+            write_all(record.site->level <= LogLevel::Warning ? STDERR_FILENO : STDOUT_FILENO, line);
+        } catch (...) {
+        }
+        return;
+    }
+
+    LogRing& ring = thread_ring();
+    const uint64_t head = ring.head.load(std::memory_order_relaxed);
+    if (head - ring.tail.load(std::memory_order_acquire) >= LOG_RING_SIZE) {
+        st.dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    ring.records[head % LOG_RING_SIZE] = record;
+    ring.head.store(head + 1, std::memory_order_release);
+}
+
+} // namespace detail
+
+// =============================================================================
+// Управление
+// =============================================================================
+
+void set_log_level(LogLevel level) noexcept {
+    detail::g_log_level.store(static_cast<uint8_t>(level), std::memory_order_relaxed);
+}
+
+Result<void> start_log(const LogConfig& config) {
+    auto& st = state();
+    if (st.running.load(std::memory_order_relaxed)) {
+        return {};
+    }
+
+    st.config = config;
+    set_log_level(config.level);
+
+    if (config.output == LogOutput::File) {
+        if (config.file.empty()) {
+            return Err<void>(ErrorCode::ConfigInvalidValue, "logging.file: не задан путь файла лога");
+        }
+        st.file_fd = ::open(config.file.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        if (st.file_fd < 0) {
+            return Err<void>(
+                ErrorCode::SystemIOError,
+                std::format("Не удалось открыть файл лога '{}'", config.file)
+            );
+        }
+    } else if (config.output == LogOutput::Journald) {
+        st.journal_fd = ::socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        std::strncpy(addr.sun_path, JOURNALD_SOCKET, sizeof(addr.sun_path) - 1);
+        if (st.journal_fd < 0 ||
+            ::connect(st.journal_fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0) {
+            if (st.journal_fd >= 0) {
+                ::close(st.journal_fd);
+                st.journal_fd = -1;
+            }
+            return Err<void>(
+                ErrorCode::SystemIOError,
+                std::format("journald недоступен: {}", JOURNALD_SOCKET)
+            );
+        }
+    }
+
+    st.running.store(true, std::memory_order_release);
+    st.writer = std::thread([&st] { writer_loop(st); });
+    return {};
+}
+
+void stop_log() {
+    auto& st = state();
+    if (!st.running.exchange(false, std::memory_order_acq_rel)) {
+        return;
+    }
+    if (st.writer.joinable()) {
+        st.writer.join();
+    }
+    if (st.file_fd >= 0) {
+        ::close(st.file_fd);
+        st.file_fd = -1;
+    }
+    if (st.journal_fd >= 0) {
+        ::close(st.journal_fd);
+        st.journal_fd = -1;
+    }
+}
+
+uint64_t log_dropped() noexcept {
+    return state().dropped.load(std::memory_order_relaxed);
+}
+
+} // namespace quaxis::core
@@ -0,0 +1,320 @@
+/**
+ * @file async_log.hpp
+ * @brief Асинхронный лог с отложенным форматированием
+ *
+ * `std::cout << ... << std::endl` блокирует поток на мьютексе потока
+ * вывода и сбрасывает буфер системным вызовом на каждой строке: при
+ * шторме переподключений ASIC и смене блока запись лога сама добавляет
+ * задержку. Здесь вызывающий поток только копирует указатель на место
+ * вызова (строка формата, уровень, ограничения) и аргументы в запись
+ * фиксированного размера своего SPSC кольца. Фоновый поток вычитывает
+ * кольца всех потоков, форматирует и пишет пачкой одним write() в
+ * консоль, файл или journald.
+ *
+ * На месте вызова можно ограничить частоту (сообщений в секунду, лишние
+ * учитываются и выводятся счётчиком со следующим сообщением) или
+ * выводить каждое N-е сообщение (сообщения на каждый share).
+ *
+ * ```cpp
+ * QUAXIS_LOG(Info, "ASIC подключён: {}", addr);
+ * QUAXIS_LOG_RATE(Warning, 10, "Отклонён share от {}: {}", id, reason);
+ * QUAXIS_LOG_SAMPLED(Debug, 1000, "share {} nonce {:#x}", id, nonce);
+ * ```
+ *
+ * До start_log() и после stop_log() сообщения форматируются и пишутся
+ * сразу в вызывающем потоке (старт, тесты).
+ */
+
+#pragma once
+
+#include "types.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace quaxis::core {
+
+// =============================================================================
+// Уровни и приёмники
+// =============================================================================
+
+/**
+ * @brief Уровень сообщения
+ */
+enum class LogLevel : uint8_t {
+    Error = 0,
+    Warning,
+    Info,
+    Debug
+};
+
+/**
+ * @brief Метка уровня в выводе
+ */
+[[nodiscard]] constexpr std::string_view to_string(LogLevel level) noexcept {
+    switch (level) {
+        case LogLevel::Error:   return "ERROR";
+        case LogLevel::Warning: return "WARNING";
+        case LogLevel::Info:    return "INFO";
+        case LogLevel::Debug:   return "DEBUG";
+        default: return "UNKNOWN";
+    }
+}
+
+/**
+ * @brief Уровень по имени из конфигурации ("error", "warn", "info", "debug")
+ */
+[[nodiscard]] std::optional<LogLevel> parse_log_level(std::string_view name) noexcept;
+
+/**
+ * @brief Куда пишет фоновый поток
+ */
+enum class LogOutput : uint8_t {
+    Console,    ///< stdout (Info, Debug) и stderr (Warning, Error)
+    File,       ///< Файл с меткой времени в каждой строке
+    Journald    ///< Нативный сокет systemd-journald (PRIORITY по уровню)
+};
+
+/**
+ * @brief Приёмник по имени из конфигурации ("console", "file", "journald")
+ */
+[[nodiscard]] std::optional<LogOutput> parse_log_output(std::string_view name) noexcept;
+
+// =============================================================================
+// Место вызова и запись
+// =============================================================================
+
+/**
+ * @brief Место вызова лога (статический объект, создаётся макросом)
+ *
+ * Указатель на него - идентификатор строки формата в записи кольца.
+ */
+struct LogSite {
+    LogLevel level;
+    std::string_view format;
+
+    /// @brief Не больше стольких сообщений в секунду (0 - без ограничения)
+    uint32_t rate_per_sec = 0;
+
+    /// @brief Выводить каждое N-е сообщение (0 и 1 - каждое)
+    uint32_t sample_every = 0;
+
+    // Состояние ограничений (общее для всех потоков)
+    std::atomic<int64_t> window{0};         ///< Текущая секунда steady_clock
+    std::atomic<uint32_t> in_window{0};     ///< Сообщений в этой секунде
+    std::atomic<uint64_t> calls{0};         ///< Вызовов (для выборки)
+    std::atomic<uint64_t> suppressed{0};    ///< Отброшено с прошлого вывода
+};
+
+/// @brief Аргументов в одной записи (больше - ошибка компиляции)
+inline constexpr std::size_t LOG_MAX_ARGS = 8;
+
+/// @brief Байт строковых аргументов в записи (длиннее - обрезаются)
+inline constexpr std::size_t LOG_TEXT_SIZE = 256;
+
+/// @brief Записей в кольце одного потока
+inline constexpr std::size_t LOG_RING_SIZE = 512;
+
+/**
+ * @brief Аргумент записи: число или ссылка на текст записи
+ */
+struct LogArg {
+    enum class Kind : uint8_t { Int, Uint, Double, Bool, Text };
+
+    Kind kind = Kind::Int;
+    uint16_t text_offset = 0;
+    uint16_t text_size = 0;
+    union {
+        int64_t i;
+        uint64_t u;
+        double d;
+    };
+
+    LogArg() noexcept : i(0) {}
+};
+
+/**
+ * @brief Запись кольца: место вызова, время и аргументы
+ */
+struct LogRecord {
+    const LogSite* site = nullptr;
+    int64_t timestamp_ns = 0;   ///< system_clock, нс от эпохи
+    uint64_t suppressed = 0;    ///< Отброшено ограничением до этого сообщения
+    uint8_t arg_count = 0;
+    uint16_t text_used = 0;
+    std::array<LogArg, LOG_MAX_ARGS> args;
+    std::array<char, LOG_TEXT_SIZE> text;
+
+    /// @brief Добавить аргумент (типы - числа, bool, строки)
+    template <typename T>
+    void add(const T& value) noexcept {
+        LogArg& arg = args[arg_count++];
+        using U = std::remove_cvref_t<T>;
+        if constexpr (std::same_as<U, bool>) {
+            arg.kind = LogArg::Kind::Bool;
+            arg.u = value ? 1 : 0;
+        } else if constexpr (std::is_enum_v<U>) {
+            add_integer(arg, static_cast<std::underlying_type_t<U>>(value));
+        } else if constexpr (std::integral<U>) {
+            add_integer(arg, value);
+        } else if constexpr (std::floating_point<U>) {
+            arg.kind = LogArg::Kind::Double;
+            arg.d = static_cast<double>(value);
+        } else {
+            static_assert(std::convertible_to<const T&, std::string_view>,
+                          "Аргумент лога: число, bool или строка");
+            add_text(arg, std::string_view(value));
+        }
+    }
+
+    /// @brief Текст строкового аргумента
+    [[nodiscard]] std::string_view text_of(const LogArg& arg) const noexcept {
+        return {text.data() + arg.text_offset, arg.text_size};
+    }
+
+private:
+    template <std::integral I>
+    static void add_integer(LogArg& arg, I value) noexcept {
+        if constexpr (std::is_signed_v<I>) {
+            arg.kind = LogArg::Kind::Int;
+            arg.i = value;
+        } else {
+            arg.kind = LogArg::Kind::Uint;
+            arg.u = value;
+        }
+    }
+
+    void add_text(LogArg& arg, std::string_view value) noexcept {
+        const std::size_t size = std::min(value.size(), LOG_TEXT_SIZE - text_used);
+        arg.kind = LogArg::Kind::Text;
+        arg.text_offset = text_used;
+        arg.text_size = static_cast<uint16_t>(size);
+        std::memcpy(text.data() + text_used, value.data(), size);
+        text_used = static_cast<uint16_t>(text_used + size);
+    }
+};
+
+/**
+ * @brief Отформатировать запись (без уровня и времени)
+ *
+ * Подстановки `{}` и `{:spec}` std::format по порядку аргументов,
+ * `{{` / `}}` - скобки. Неверная спецификация выводится как `{?}`.
+ */
+[[nodiscard]] std::string format_log_record(const LogRecord& record);
+
+// =============================================================================
+// Горячий путь
+// =============================================================================
+
+namespace detail {
+extern std::atomic<uint8_t> g_log_level;
+
+/// @brief Пропустить сообщение по ограничениям места вызова?
+[[nodiscard]] bool log_throttled(LogSite& site) noexcept;
+
+/// @brief Положить запись в кольцо потока (или вывести сразу без фонового потока)
+void log_submit(LogRecord& record) noexcept;
+} // namespace detail
+
+/**
+ * @brief Выводится ли уровень (одна relaxed загрузка)
+ */
+[[nodiscard]] inline bool log_enabled(LogLevel level) noexcept {
+    return static_cast<uint8_t>(level) <= detail::g_log_level.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Записать сообщение места вызова (обычно через QUAXIS_LOG)
+ */
+template <typename... Args>
+void log_write(LogSite& site, const Args&... args) noexcept {
+    static_assert(sizeof...(Args) <= LOG_MAX_ARGS, "Слишком много аргументов лога");
+    if (!log_enabled(site.level) || detail::log_throttled(site)) {
+        return;
+    }
+    LogRecord record;
+    record.site = &site;
+    record.timestamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    record.suppressed = site.suppressed.exchange(0, std::memory_order_relaxed);
+    (record.add(args), ...);
+    detail::log_submit(record);
+}
+
+// =============================================================================
+// Фоновый поток
+// =============================================================================
+
+/**
+ * @brief Параметры фонового вывода
+ */
+struct LogConfig {
+    LogLevel level = LogLevel::Info;
+    LogOutput output = LogOutput::Console;
+
+    /// @brief Файл для LogOutput::File (дописывается)
+    std::string file;
+
+    /// @brief Период вычитывания колец (мс)
+    uint32_t flush_interval_ms = 5;
+};
+
+/**
+ * @brief Установить уровень (действует сразу, в том числе без фонового потока)
+ */
+void set_log_level(LogLevel level) noexcept;
+
+/**
+ * @brief Запустить фоновый поток вывода
+ *
+ * @return Result<void> Успех, SystemIOError (файл не открыт) или
+ *         ConfigInvalidValue (пустой путь файла)
+ */
+[[nodiscard]] Result<void> start_log(const LogConfig& config);
+
+/**
+ * @brief Вывести накопленное и остановить фоновый поток
+ */
+void stop_log();
+
+/**
+ * @brief Сообщений, отброшенных из-за переполненного кольца потока
+ */
+[[nodiscard]] uint64_t log_dropped() noexcept;
+
+} // namespace quaxis::core
+
+/**
+ * @brief Сообщение уровня LEVEL (Error, Warning, Info, Debug)
+ */
+#define QUAXIS_LOG(LEVEL, FORMAT, ...) \
+    QUAXIS_LOG_SITE(LEVEL, 0, 0, FORMAT __VA_OPT__(,) __VA_ARGS__)
+
+/**
+ * @brief Сообщение не чаще PER_SEC раз в секунду на место вызова
+ */
+#define QUAXIS_LOG_RATE(LEVEL, PER_SEC, FORMAT, ...) \
+    QUAXIS_LOG_SITE(LEVEL, PER_SEC, 0, FORMAT __VA_OPT__(,) __VA_ARGS__)
+
+/**
+ * @brief Каждое EVERY-е сообщение места вызова
+ */
+#define QUAXIS_LOG_SAMPLED(LEVEL, EVERY, FORMAT, ...) \
+    QUAXIS_LOG_SITE(LEVEL, 0, EVERY, FORMAT __VA_OPT__(,) __VA_ARGS__)
+
+#define QUAXIS_LOG_SITE(LEVEL, PER_SEC, EVERY, FORMAT, ...)                         \
+    do {                                                                            \
+        static ::quaxis::core::LogSite quaxis_log_site_{                            \
+            ::quaxis::core::LogLevel::LEVEL, FORMAT, PER_SEC, EVERY};               \
+        ::quaxis::core::log_write(quaxis_log_site_ __VA_OPT__(,) __VA_ARGS__);      \
+    } while (false)
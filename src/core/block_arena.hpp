@@ -0,0 +1,115 @@
+/**
+ * @file block_arena.hpp
+ * @brief Арена временных данных одного блока
+ *
+ * Между приходом блока и рассылкой заданий создаются короткоживущие
+ * буферы: coinbase для хеширования, кадры заданий, списки соединений.
+ * Каждый - пара malloc/free на блок. BlockArena выделяет буфер один раз,
+ * раздаёт из него память через std::pmr::monotonic_buffer_resource и
+ * освобождает всё разом в reset() - на следующем блоке.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+
+namespace quaxis::core {
+
+/**
+ * @brief Монотонная арена, сбрасываемая на каждом блоке
+ *
+ * Память арены живёт до следующего reset(): в ней - только данные,
+ * которые не переживают обработку блока (не шаблоны и не задания,
+ * хранимые JobManager). Не потокобезопасна: одна арена - один поток
+ * или одна блокировка владельца.
+ */
+class BlockArena {
+public:
+    /// @brief Размер буфера по умолчанию
+    static constexpr std::size_t DEFAULT_CAPACITY = 64 * 1024;
+
+    /**
+     * @param capacity Размер буфера (сверх него - malloc до reset())
+     */
+    explicit BlockArena(std::size_t capacity = DEFAULT_CAPACITY)
+        : buffer_(std::make_unique<std::byte[]>(capacity))
+        , capacity_(capacity)
+        , resource_(buffer_.get(), capacity_, &overflow_)
+    {}
+
+    BlockArena(const BlockArena&) = delete;
+    BlockArena& operator=(const BlockArena&) = delete;
+
+    /**
+     * @brief Ресурс для std::pmr контейнеров
+     */
+    [[nodiscard]] std::pmr::memory_resource* resource() noexcept {
+        return &resource_;
+    }
+
+    /**
+     * @brief Новый блок: вся память арены снова свободна
+     *
+     * Контейнеры, созданные в арене до reset(), использовать нельзя.
+     */
+    void reset() noexcept {
+        resource_.release();
+        ++generation_;
+    }
+
+    /**
+     * @brief Сколько раз арена сброшена
+     */
+    [[nodiscard]] uint64_t generation() const noexcept {
+        return generation_;
+    }
+
+    /**
+     * @brief Размер буфера арены
+     */
+    [[nodiscard]] std::size_t capacity() const noexcept {
+        return capacity_;
+    }
+
+    /**
+     * @brief Выделения сверх буфера (malloc) за всё время
+     *
+     * Растёт - буфер мал для блока.
+     */
+    [[nodiscard]] uint64_t overflow_allocations() const noexcept {
+        return overflow_.allocations.load(std::memory_order_relaxed);
+    }
+
+private:
+    /**
+     * @brief Upstream арены: new/delete со счётчиком выделений
+     */
+    struct OverflowResource final : std::pmr::memory_resource {
+        std::atomic<uint64_t> allocations{0};
+
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+            allocations.fetch_add(1, std::memory_order_relaxed);
+            return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+            std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+        }
+
+        [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+    };
+
+    std::unique_ptr<std::byte[]> buffer_;
+    std::size_t capacity_;
+    OverflowResource overflow_;
+    std::pmr::monotonic_buffer_resource resource_;
+    uint64_t generation_{0};
+};
+
+} // namespace quaxis::core
@@ -1,16 +1,356 @@
 /**
  * @file byte_order.cpp
- * @brief Реализация функций работы с порядком байт
- * 
+ * @brief Реализация функций работы с порядком байт и hex кодека
+ *
  * Большинство функций определены в header как inline/constexpr.
- * Этот файл содержит только функции, требующие отдельной единицы трансляции.
+ * Здесь - hex кодек: скалярная реализация, NEON и диспетчер ядер
+ * SSSE3 / AVX2 (byte_order_ssse3.cpp, byte_order_avx2.cpp).
  */
 
 #include "byte_order.hpp"
 
+#include <array>
+
+#ifdef __x86_64__
+#include <cpuid.h>
+#endif
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define QUAXIS_HAS_HEX_NEON
+#endif
+
 namespace quaxis {
 
-// Все функции определены в header файле как inline/constexpr
-// Этот файл нужен только для линковки
+// =============================================================================
+// Внешние функции реализаций
+// =============================================================================
+
+#ifdef QUAXIS_HAS_HEX_SSSE3
+namespace hex_ssse3 {
+    std::size_t encode(const uint8_t* data, std::size_t len, char* out) noexcept;
+    std::size_t decode(const char* hex, std::size_t len, uint8_t* out) noexcept;
+}
+#endif
+
+#ifdef QUAXIS_HAS_HEX_AVX2
+namespace hex_avx2 {
+    std::size_t encode(const uint8_t* data, std::size_t len, char* out) noexcept;
+    std::size_t decode(const char* hex, std::size_t len, uint8_t* out) noexcept;
+}
+#endif
+
+namespace {
+
+// =============================================================================
+// Таблицы
+// =============================================================================
+
+constexpr char HEX_DIGITS[] = "0123456789abcdef";
+
+/// @brief Значение hex цифры; 0xFF - не цифра
+constexpr std::array<uint8_t, 256> make_decode_table() noexcept {
+    std::array<uint8_t, 256> table{};
+    for (unsigned c = 0; c < 256; ++c) {
+        table[c] = 0xFF;
+        if (c >= '0' && c <= '9') {
+            table[c] = static_cast<uint8_t>(c - '0');
+        } else if (c >= 'a' && c <= 'f') {
+            table[c] = static_cast<uint8_t>(c - 'a' + 10);
+        } else if (c >= 'A' && c <= 'F') {
+            table[c] = static_cast<uint8_t>(c - 'A' + 10);
+        }
+    }
+    return table;
+}
+
+constexpr std::array<uint8_t, 256> DECODE = make_decode_table();
+
+// =============================================================================
+// Определение возможностей CPU
+// =============================================================================
+
+#if defined(__x86_64__) && defined(QUAXIS_HAS_HEX_AVX2)
+inline uint64_t read_xcr0() noexcept {
+    uint32_t lo, hi;
+    __asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+    return (static_cast<uint64_t>(hi) << 32) | lo;
+}
+#endif
+
+/**
+ * @brief Выбор ядра через CPUID (+ XCR0 для ymm)
+ *
+ * - SSSE3: CPUID.1:ECX[9]
+ * - AVX2: CPUID.7.0:EBX[5], XCR0[2:1]
+ */
+HexImplementation detect_implementation() noexcept {
+#ifdef QUAXIS_HAS_HEX_NEON
+    return HexImplementation::Neon;
+#else
+    HexImplementation best = HexImplementation::Scalar;
+#ifdef __x86_64__
+    unsigned int eax, ebx, ecx, edx;
+    if (__get_cpuid(1, &eax, &ebx, &ecx, &edx) == 0) {
+        return best;
+    }
+#ifdef QUAXIS_HAS_HEX_SSSE3
+    if ((ecx & (1u << 9)) != 0) {
+        best = HexImplementation::Ssse3;
+    }
+#endif
+#ifdef QUAXIS_HAS_HEX_AVX2
+    const bool osxsave = (ecx & (1u << 27)) != 0;
+    if (!osxsave || (read_xcr0() & 0x06) != 0x06) {
+        return best;
+    }
+    if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) != 0 && (ebx & (1u << 5)) != 0) {
+        best = HexImplementation::Avx2;
+    }
+#endif
+#endif
+    return best;
+#endif
+}
+
+/// @brief Кешированный выбор ядра
+const HexImplementation g_implementation = detect_implementation();
+
+// =============================================================================
+// Скалярная реализация
+// =============================================================================
+
+void encode_scalar(const uint8_t* data, std::size_t len, char* out) noexcept {
+    for (std::size_t i = 0; i < len; ++i) {
+        out[i * 2] = HEX_DIGITS[data[i] >> 4];
+        out[i * 2 + 1] = HEX_DIGITS[data[i] & 0x0F];
+    }
+}
+
+bool decode_scalar(const char* hex, std::size_t len, uint8_t* out) noexcept {
+    for (std::size_t i = 0; i < len; ++i) {
+        const uint8_t hi = DECODE[static_cast<uint8_t>(hex[i * 2])];
+        const uint8_t lo = DECODE[static_cast<uint8_t>(hex[i * 2 + 1])];
+        if (hi > 0x0F || lo > 0x0F) {
+            return false;
+        }
+        out[i] = static_cast<uint8_t>((hi << 4) | lo);
+    }
+    return true;
+}
+
+// =============================================================================
+// NEON (aarch64)
+// =============================================================================
+
+#ifdef QUAXIS_HAS_HEX_NEON
+std::size_t encode_neon(const uint8_t* data, std::size_t len, char* out) noexcept {
+    const uint8x16_t digits = vld1q_u8(reinterpret_cast<const uint8_t*>(HEX_DIGITS));
+    const uint8x16_t mask = vdupq_n_u8(0x0F);
+    std::size_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        const uint8x16_t x = vld1q_u8(data + i);
+        uint8x16x2_t chars;
+        chars.val[0] = vqtbl1q_u8(digits, vshrq_n_u8(x, 4));
+        chars.val[1] = vqtbl1q_u8(digits, vandq_u8(x, mask));
+        vst2q_u8(reinterpret_cast<uint8_t*>(out + i * 2), chars);
+    }
+    return i;
+}
+
+/// @brief Значения 16 символов; valid - 0xFF для hex цифр
+inline uint8x16_t nibbles_neon(uint8x16_t c, uint8x16_t& valid) noexcept {
+    const uint8x16_t digit = vsubq_u8(c, vdupq_n_u8('0'));
+    const uint8x16_t letter = vsubq_u8(vorrq_u8(c, vdupq_n_u8(0x20)), vdupq_n_u8('a'));
+    const uint8x16_t is_digit = vcleq_u8(digit, vdupq_n_u8(9));
+    const uint8x16_t is_letter = vcleq_u8(letter, vdupq_n_u8(5));
+    valid = vandq_u8(valid, vorrq_u8(is_digit, is_letter));
+    return vbslq_u8(is_digit, digit, vaddq_u8(letter, vdupq_n_u8(10)));
+}
+
+std::size_t decode_neon(const char* hex, std::size_t len, uint8_t* out) noexcept {
+    std::size_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        const uint8x16x2_t chars = vld2q_u8(reinterpret_cast<const uint8_t*>(hex + i * 2));
+        uint8x16_t valid = vdupq_n_u8(0xFF);
+        const uint8x16_t hi = nibbles_neon(chars.val[0], valid);
+        const uint8x16_t lo = nibbles_neon(chars.val[1], valid);
+        if (vminvq_u8(valid) != 0xFF) {
+            break;
+        }
+        vst1q_u8(out + i, vorrq_u8(vshlq_n_u8(hi, 4), lo));
+    }
+    return i;
+}
+#endif
+
+/// @brief Байт, обработанных ядром; остаток - скалярно
+///
+/// Без SIMD (QUAXIS_ENABLE_HEX_SIMD=OFF или цель без SSSE3/AVX2/NEON)
+/// остаётся только default, отсюда [[maybe_unused]].
+std::size_t encode_kernel([[maybe_unused]] const uint8_t* data,
+                          [[maybe_unused]] std::size_t len,
+                          [[maybe_unused]] char* out,
+                          HexImplementation implementation) noexcept {
+    switch (implementation) {
+#ifdef QUAXIS_HAS_HEX_AVX2
+        case HexImplementation::Avx2: {
+            // Хвост короче 32 байт - 16-байтным шагом SSSE3
+            std::size_t done = hex_avx2::encode(data, len, out);
+#ifdef QUAXIS_HAS_HEX_SSSE3
+            done += hex_ssse3::encode(data + done, len - done, out + done * 2);
+#endif
+            return done;
+        }
+#endif
+#ifdef QUAXIS_HAS_HEX_SSSE3
+        case HexImplementation::Ssse3:
+            return hex_ssse3::encode(data, len, out);
+#endif
+#ifdef QUAXIS_HAS_HEX_NEON
+        case HexImplementation::Neon:
+            return encode_neon(data, len, out);
+#endif
+        default:
+            return 0;
+    }
+}
+
+/// @brief Байт, декодированных ядром до первого блока с не-hex символом
+std::size_t decode_kernel([[maybe_unused]] const char* hex,
+                          [[maybe_unused]] std::size_t len,
+                          [[maybe_unused]] uint8_t* out,
+                          HexImplementation implementation) noexcept {
+    switch (implementation) {
+#ifdef QUAXIS_HAS_HEX_AVX2
+        case HexImplementation::Avx2: {
+            std::size_t done = hex_avx2::decode(hex, len, out);
+#ifdef QUAXIS_HAS_HEX_SSSE3
+            done += hex_ssse3::decode(hex + done * 2, len - done, out + done);
+#endif
+            return done;
+        }
+#endif
+#ifdef QUAXIS_HAS_HEX_SSSE3
+        case HexImplementation::Ssse3:
+            return hex_ssse3::decode(hex, len, out);
+#endif
+#ifdef QUAXIS_HAS_HEX_NEON
+        case HexImplementation::Neon:
+            return decode_neon(hex, len, out);
+#endif
+        default:
+            return 0;
+    }
+}
+
+} // anonymous namespace
+
+// =============================================================================
+// Выбор реализации
+// =============================================================================
+
+HexImplementation get_hex_implementation() noexcept {
+    return g_implementation;
+}
+
+bool has_hex_implementation(HexImplementation implementation) noexcept {
+    switch (implementation) {
+        case HexImplementation::Scalar:
+            return true;
+        case HexImplementation::Ssse3:
+#ifdef QUAXIS_HAS_HEX_SSSE3
+            return g_implementation == HexImplementation::Ssse3 ||
+                   g_implementation == HexImplementation::Avx2;
+#else
+            return false;
+#endif
+        case HexImplementation::Avx2:
+            return g_implementation == HexImplementation::Avx2;
+        case HexImplementation::Neon:
+            return g_implementation == HexImplementation::Neon;
+    }
+    return false;
+}
+
+std::string_view hex_implementation_name(HexImplementation implementation) noexcept {
+    switch (implementation) {
+        case HexImplementation::Avx2: return "avx2";
+        case HexImplementation::Ssse3: return "ssse3";
+        case HexImplementation::Neon: return "neon";
+        case HexImplementation::Scalar: break;
+    }
+    return "scalar";
+}
+
+// =============================================================================
+// Кодирование / декодирование
+// =============================================================================
+
+void hex_encode(std::span<const uint8_t> data, char* out) noexcept {
+    hex_encode(data, out, g_implementation);
+}
+
+void hex_encode(std::span<const uint8_t> data, char* out,
+                HexImplementation implementation) noexcept {
+    if (!has_hex_implementation(implementation)) {
+        implementation = HexImplementation::Scalar;
+    }
+    const std::size_t done = encode_kernel(data.data(), data.size(), out, implementation);
+    encode_scalar(data.data() + done, data.size() - done, out + done * 2);
+}
+
+void hex_encode_reversed(std::span<const uint8_t> data, char* out) noexcept {
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        const uint8_t byte = data[data.size() - 1 - i];
+        out[i * 2] = HEX_DIGITS[byte >> 4];
+        out[i * 2 + 1] = HEX_DIGITS[byte & 0x0F];
+    }
+}
+
+bool hex_decode(std::string_view hex, uint8_t* out) noexcept {
+    return hex_decode(hex, out, g_implementation);
+}
+
+bool hex_decode(std::string_view hex, uint8_t* out,
+                HexImplementation implementation) noexcept {
+    if (hex.size() % 2 != 0) {
+        return false;
+    }
+    if (!has_hex_implementation(implementation)) {
+        implementation = HexImplementation::Scalar;
+    }
+    const std::size_t len = hex.size() / 2;
+    const std::size_t done = decode_kernel(hex.data(), len, out, implementation);
+    return decode_scalar(hex.data() + done * 2, len - done, out + done);
+}
+
+bool hex_decode_reversed(std::string_view hex, uint8_t* out) noexcept {
+    if (hex.size() % 2 != 0) {
+        return false;
+    }
+    const std::size_t len = hex.size() / 2;
+    for (std::size_t i = 0; i < len; ++i) {
+        const uint8_t hi = DECODE[static_cast<uint8_t>(hex[i * 2])];
+        const uint8_t lo = DECODE[static_cast<uint8_t>(hex[i * 2 + 1])];
+        if (hi > 0x0F || lo > 0x0F) {
+            return false;
+        }
+        out[len - 1 - i] = static_cast<uint8_t>((hi << 4) | lo);
+    }
+    return true;
+}
+
+void append_hex(std::string& out, std::span<const uint8_t> data) {
+    const std::size_t offset = out.size();
+    out.resize(offset + data.size() * 2);
+    hex_encode(data, out.data() + offset);
+}
+
+std::string to_hex(std::span<const uint8_t> data) {
+    std::string hex;
+    append_hex(hex, data);
+    return hex;
+}
 
 } // namespace quaxis
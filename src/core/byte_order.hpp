@@ -20,6 +20,8 @@
 #include <span>
 #include <bit>
 #include <concepts>
+#include <string>
+#include <string_view>
 
 namespace quaxis {
 
@@ -298,4 +300,95 @@ template<std::size_t N>
     return result;
 }
 
+// =============================================================================
+// Hex кодек
+// =============================================================================
+
+/**
+ * @brief Реализация hex кодека
+ *
+ * Выбирается по CPUID при старте (Neon - при сборке под aarch64);
+ * все реализации дают одинаковый результат.
+ */
+enum class HexImplementation : uint8_t {
+    Scalar,  ///< Таблицы, байт за шаг
+    Ssse3,   ///< pshufb, 16 байт за шаг
+    Avx2,    ///< vpshufb, 32 байта за шаг
+    Neon     ///< tbl / ld2 / st2, 16 байт за шаг
+};
+
+/**
+ * @brief Лучшая доступная реализация
+ */
+[[nodiscard]] HexImplementation get_hex_implementation() noexcept;
+
+/**
+ * @brief Доступна ли реализация (собрана и поддерживается CPU)
+ */
+[[nodiscard]] bool has_hex_implementation(HexImplementation implementation) noexcept;
+
+/**
+ * @brief Имя реализации для логов
+ */
+[[nodiscard]] std::string_view hex_implementation_name(HexImplementation implementation) noexcept;
+
+/**
+ * @brief Символ - hex цифра (в любом регистре)?
+ */
+[[nodiscard]] constexpr bool is_hex_digit(char c) noexcept {
+    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+}
+
+/**
+ * @brief Байты в hex (строчные), в буфер вызывающего
+ *
+ * @param data Входные байты
+ * @param out Буфер не меньше data.size() * 2 символов (без '\0')
+ */
+void hex_encode(std::span<const uint8_t> data, char* out) noexcept;
+
+/**
+ * @brief hex_encode() заданной реализацией (недоступная - Scalar)
+ */
+void hex_encode(std::span<const uint8_t> data, char* out,
+                HexImplementation implementation) noexcept;
+
+/**
+ * @brief Байты в hex в обратном порядке (отображение хешей и target)
+ */
+void hex_encode_reversed(std::span<const uint8_t> data, char* out) noexcept;
+
+/**
+ * @brief hex в байты, в буфер вызывающего
+ *
+ * Цифры принимаются в любом регистре.
+ *
+ * @param hex Строка чётной длины
+ * @param out Буфер не меньше hex.size() / 2 байт
+ * @return false для нечётной длины или не-hex символа (out тогда
+ *         заполнен частично)
+ */
+[[nodiscard]] bool hex_decode(std::string_view hex, uint8_t* out) noexcept;
+
+/**
+ * @brief hex_decode() заданной реализацией (недоступная - Scalar)
+ */
+[[nodiscard]] bool hex_decode(std::string_view hex, uint8_t* out,
+                              HexImplementation implementation) noexcept;
+
+/**
+ * @brief hex в байты в обратном порядке (хеши и target из RPC)
+ */
+[[nodiscard]] bool hex_decode_reversed(std::string_view hex, uint8_t* out) noexcept;
+
+/**
+ * @brief Дописать hex байтов в конец строки
+ */
+void append_hex(std::string& out, std::span<const uint8_t> data);
+
+/**
+ * @brief Байты в hex строку
+ */
+[[nodiscard]] std::string to_hex(std::span<const uint8_t> data);
+
 } // namespace quaxis
@@ -0,0 +1,73 @@
+/**
+ * @file byte_order_avx2.cpp
+ * @brief Hex кодек на AVX2 (vpshufb, 32 байта за шаг)
+ *
+ * Тот же алгоритм, что в byte_order_ssse3.cpp; unpack и pack работают
+ * внутри 128-битных половин, порядок восстанавливают vperm2i128 и
+ * vpermq.
+ *
+ * @note Этот файл компилируется с флагом -mavx2
+ */
+
+#include <cstddef>
+#include <cstdint>
+
+#include <immintrin.h>
+
+namespace quaxis::hex_avx2 {
+
+namespace {
+
+/// @brief Значения 32 символов; valid - 0xFF для hex цифр
+inline __m256i nibbles(__m256i c, __m256i& valid) noexcept {
+    const __m256i digit = _mm256_sub_epi8(c, _mm256_set1_epi8('0'));
+    const __m256i letter = _mm256_sub_epi8(_mm256_or_si256(c, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+    const __m256i is_digit = _mm256_cmpeq_epi8(_mm256_min_epu8(digit, _mm256_set1_epi8(9)), digit);
+    const __m256i is_letter = _mm256_cmpeq_epi8(_mm256_min_epu8(letter, _mm256_set1_epi8(5)), letter);
+    valid = _mm256_and_si256(valid, _mm256_or_si256(is_digit, is_letter));
+    return _mm256_or_si256(_mm256_and_si256(is_digit, digit),
+                           _mm256_and_si256(is_letter, _mm256_add_epi8(letter, _mm256_set1_epi8(10))));
+}
+
+} // anonymous namespace
+
+std::size_t encode(const uint8_t* data, std::size_t len, char* out) noexcept {
+    const __m256i digits = _mm256_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7',
+                                            '8', '9', 'a', 'b', 'c', 'd', 'e', 'f',
+                                            '0', '1', '2', '3', '4', '5', '6', '7',
+                                            '8', '9', 'a', 'b', 'c', 'd', 'e', 'f');
+    const __m256i mask = _mm256_set1_epi8(0x0F);
+
+    std::size_t i = 0;
+    for (; i + 32 <= len; i += 32) {
+        const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        const __m256i hi = _mm256_shuffle_epi8(digits, _mm256_and_si256(_mm256_srli_epi64(x, 4), mask));
+        const __m256i lo = _mm256_shuffle_epi8(digits, _mm256_and_si256(x, mask));
+        // low: байты 0-7 | 16-23, high: 8-15 | 24-31
+        const __m256i low = _mm256_unpacklo_epi8(hi, lo);
+        const __m256i high = _mm256_unpackhi_epi8(hi, lo);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i * 2), _mm256_permute2x128_si256(low, high, 0x20));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i * 2 + 32), _mm256_permute2x128_si256(low, high, 0x31));
+    }
+    return i;
+}
+
+std::size_t decode(const char* hex, std::size_t len, uint8_t* out) noexcept {
+    const __m256i weights = _mm256_set1_epi16(0x0110);
+
+    std::size_t i = 0;
+    for (; i + 32 <= len; i += 32) {
+        __m256i valid = _mm256_set1_epi8(-1);
+        const __m256i a = nibbles(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(hex + i * 2)), valid);
+        const __m256i b = nibbles(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(hex + i * 2 + 32)), valid);
+        if (_mm256_movemask_epi8(valid) != -1) {
+            break;
+        }
+        // packus: a.lo | b.lo | a.hi | b.hi -> порядок a.lo a.hi b.lo b.hi
+        const __m256i packed = _mm256_packus_epi16(_mm256_maddubs_epi16(a, weights), _mm256_maddubs_epi16(b, weights));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_permute4x64_epi64(packed, 0xD8));
+    }
+    return i;
+}
+
+} // namespace quaxis::hex_avx2
@@ -0,0 +1,68 @@
+/**
+ * @file byte_order_ssse3.cpp
+ * @brief Hex кодек на SSSE3 (pshufb, 16 байт за шаг)
+ *
+ * Кодирование: полубайты выбирают символы из 16-байтной таблицы,
+ * punpck чередует старший и младший. Декодирование: диапазоны '0'..'9'
+ * и 'a'..'f' (регистр снимается | 0x20) проверяются беззнаковым min,
+ * пары полубайтов складываются pmaddubsw (hi * 16 + lo).
+ *
+ * @note Этот файл компилируется с флагом -mssse3
+ */
+
+#include <cstddef>
+#include <cstdint>
+
+#include <immintrin.h>
+
+namespace quaxis::hex_ssse3 {
+
+namespace {
+
+/// @brief Значения 16 символов; valid - 0xFF для hex цифр
+inline __m128i nibbles(__m128i c, __m128i& valid) noexcept {
+    const __m128i digit = _mm_sub_epi8(c, _mm_set1_epi8('0'));
+    const __m128i letter = _mm_sub_epi8(_mm_or_si128(c, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+    const __m128i is_digit = _mm_cmpeq_epi8(_mm_min_epu8(digit, _mm_set1_epi8(9)), digit);
+    const __m128i is_letter = _mm_cmpeq_epi8(_mm_min_epu8(letter, _mm_set1_epi8(5)), letter);
+    valid = _mm_and_si128(valid, _mm_or_si128(is_digit, is_letter));
+    return _mm_or_si128(_mm_and_si128(is_digit, digit),
+                        _mm_and_si128(is_letter, _mm_add_epi8(letter, _mm_set1_epi8(10))));
+}
+
+} // anonymous namespace
+
+std::size_t encode(const uint8_t* data, std::size_t len, char* out) noexcept {
+    const __m128i digits = _mm_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7',
+                                         '8', '9', 'a', 'b', 'c', 'd', 'e', 'f');
+    const __m128i mask = _mm_set1_epi8(0x0F);
+
+    std::size_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        const __m128i hi = _mm_shuffle_epi8(digits, _mm_and_si128(_mm_srli_epi64(x, 4), mask));
+        const __m128i lo = _mm_shuffle_epi8(digits, _mm_and_si128(x, mask));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i * 2), _mm_unpacklo_epi8(hi, lo));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i * 2 + 16), _mm_unpackhi_epi8(hi, lo));
+    }
+    return i;
+}
+
+std::size_t decode(const char* hex, std::size_t len, uint8_t* out) noexcept {
+    const __m128i weights = _mm_set1_epi16(0x0110);
+
+    std::size_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        __m128i valid = _mm_set1_epi8(-1);
+        const __m128i a = nibbles(_mm_loadu_si128(reinterpret_cast<const __m128i*>(hex + i * 2)), valid);
+        const __m128i b = nibbles(_mm_loadu_si128(reinterpret_cast<const __m128i*>(hex + i * 2 + 16)), valid);
+        if (_mm_movemask_epi8(valid) != 0xFFFF) {
+            break;
+        }
+        const __m128i bytes = _mm_packus_epi16(_mm_maddubs_epi16(a, weights), _mm_maddubs_epi16(b, weights));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), bytes);
+    }
+    return i;
+}
+
+} // namespace quaxis::hex_ssse3
@@ -10,6 +10,7 @@
 
 #include "consensus_type.hpp"
 #include "../types.hpp"
+#include "../primitives/block_header.hpp"
 
 #include <string>
 #include <string_view>
@@ -17,6 +18,8 @@
 #include <array>
 #include <cstdint>
 #include <optional>
+#include <span>
+#include <stdexcept>
 
 namespace quaxis::core {
 
@@ -88,6 +91,13 @@ struct DifficultyParams {
     
     /// @brief Время для срабатывания минимальной сложности (секунды)
     uint32_t min_difficulty_time{0};
+    
+    /**
+     * @brief Максимальный target (pow_limit_bits в 256 бит)
+     */
+    [[nodiscard]] constexpr uint256 pow_limit() const noexcept {
+        return bits_to_target(pow_limit_bits);
+    }
 };
 
 /**
@@ -109,6 +119,42 @@ struct RewardParams {
     uint32_t coinbase_maturity{100};
 };
 
+/**
+ * @brief Контрольная точка цепи заголовков
+ * 
+ * Заголовок на этой высоте обязан иметь этот хеш; от контрольной точки
+ * можно начать хранилище заголовков (снапшот) без цепи до неё.
+ */
+struct HeaderCheckpoint {
+    /// @brief Высота блока
+    uint32_t height{0};
+    
+    /// @brief Хеш блока (внутренний порядок байт, как BlockHeader::hash())
+    Hash256 hash{};
+};
+
+/**
+ * @brief Хеш из hex в порядке отображения (как в block explorer)
+ * 
+ * @param hex 64 hex символа, старший байт первым
+ * @return Hash256 Хеш во внутреннем порядке байт
+ */
+[[nodiscard]] consteval Hash256 hash_from_display_hex(std::string_view hex) {
+    if (hex.size() != 64) {
+        throw std::invalid_argument("hash hex must be 64 chars");
+    }
+    auto nibble = [](char c) -> uint8_t {
+        if (c >= '0' && c <= '9') return static_cast<uint8_t>(c - '0');
+        if (c >= 'a' && c <= 'f') return static_cast<uint8_t>(c - 'a' + 10);
+        throw std::invalid_argument("bad hex digit");
+    };
+    Hash256 hash{};
+    for (std::size_t i = 0; i < hash.size(); ++i) {
+        hash[hash.size() - 1 - i] = static_cast<uint8_t>((nibble(hex[2 * i]) << 4) | nibble(hex[2 * i + 1]));
+    }
+    return hash;
+}
+
 /**
  * @brief Универсальная структура параметров блокчейна
  * 
@@ -158,6 +204,13 @@ struct ChainParams {
     /// @brief Параметры testnet (опционально)
     std::optional<NetworkParams> testnet;
     
+    // =========================================================================
+    // Контрольные точки
+    // =========================================================================
+    
+    /// @brief Контрольные точки по возрастанию высоты (constexpr таблица)
+    std::span<const HeaderCheckpoint> checkpoints;
+    
     // =========================================================================
     // Вспомогательные методы
     // =========================================================================
@@ -198,6 +251,36 @@ struct ChainParams {
     [[nodiscard]] double get_miner_reward_share() const noexcept {
         return rewards.miner_share;
     }
+    
+    /**
+     * @brief Контрольная точка на высоте
+     * 
+     * @param height Высота блока
+     * @return Контрольная точка или nullptr
+     */
+    [[nodiscard]] const HeaderCheckpoint* find_checkpoint(uint32_t height) const noexcept {
+        for (const auto& checkpoint : checkpoints) {
+            if (checkpoint.height == height) {
+                return &checkpoint;
+            }
+        }
+        return nullptr;
+    }
+    
+    /**
+     * @brief Контрольная точка по хешу блока
+     * 
+     * @param hash Хеш блока
+     * @return Контрольная точка или nullptr
+     */
+    [[nodiscard]] const HeaderCheckpoint* find_checkpoint(const Hash256& hash) const noexcept {
+        for (const auto& checkpoint : checkpoints) {
+            if (checkpoint.hash == hash) {
+                return &checkpoint;
+            }
+        }
+        return nullptr;
+    }
 };
 
 } // namespace quaxis::core
@@ -4,13 +4,57 @@
  */
 
 #include "chain_registry.hpp"
+#include "../constants.hpp"
 
 #include <algorithm>
 #include <cctype>
-#include <stdexcept>
 
 namespace quaxis::core {
 
+namespace {
+
+/// @brief Контрольные точки Bitcoin mainnet (из Bitcoin Core)
+constexpr std::array BITCOIN_CHECKPOINTS{
+    HeaderCheckpoint{11111, hash_from_display_hex("0000000069e244f73d78e8fd29ba2fd2ed618bd6fa2ee92559f542fdb26e7c1d")},
+    HeaderCheckpoint{33333, hash_from_display_hex("000000002dd5588a74784eaa7ab0507a18ad16a236e7b1ce69f00d7ddfb5d0a6")},
+    HeaderCheckpoint{74000, hash_from_display_hex("0000000000573993a3c9e41ce34471c079dcf5f52a0e824a81e7f953b8661a20")},
+    HeaderCheckpoint{105000, hash_from_display_hex("00000000000291ce28027faea320c8d2b054b2e0fe44a773f3eefb151d6bdc97")},
+    HeaderCheckpoint{134444, hash_from_display_hex("00000000000005b12ffd4cd315cd34ffd4a594f430ac814c91184a0d42d2b0fe")},
+    HeaderCheckpoint{168000, hash_from_display_hex("000000000000099e61ea72015e79632f216fe6cb33d7899acb35b75c8303b763")},
+    HeaderCheckpoint{193000, hash_from_display_hex("000000000000059f452a5f7340de6682a977387c17010ff6e6c3bd83ca8b1317")},
+    HeaderCheckpoint{210000, hash_from_display_hex("000000000000048b95347e83192f69cf0366076336c639f9b7228e9ba171342e")},
+    HeaderCheckpoint{216116, hash_from_display_hex("00000000000001b4f4b433e81ee46494af945cf96014816a4e2370f11b23df4e")},
+    HeaderCheckpoint{225430, hash_from_display_hex("00000000000001c108384350f74090433e7fcf79a606b8e797f065b130575932")},
+    HeaderCheckpoint{250000, hash_from_display_hex("000000000000003887df1f29024b06fc2200b55f8af8f35453d7be294df2d214")},
+    HeaderCheckpoint{279000, hash_from_display_hex("0000000000000001ae8c72a0b0c301f67e3afca10e819efa9041e458e9bd7e40")},
+    HeaderCheckpoint{295000, hash_from_display_hex("00000000000000004d9b4ef50f0f9d686fd69db2e03af35a100370c64632a983")},
+};
+
+/// @brief Хеш каждой контрольной точки проходит pow limit сети
+template<std::size_t N>
+consteval bool checkpoints_meet_pow_limit(const std::array<HeaderCheckpoint, N>& checkpoints, uint32_t pow_limit_bits) {
+    const auto limit = bits_to_target(pow_limit_bits);
+    return std::ranges::all_of(checkpoints, [&](const HeaderCheckpoint& checkpoint) {
+        return uint256{checkpoint.hash} <= limit;
+    });
+}
+
+static_assert(checkpoints_meet_pow_limit(BITCOIN_CHECKPOINTS, 0x1d00ffff),
+              "контрольная точка Bitcoin не проходит pow limit");
+
+/// @brief Параметры с идентификацией из BUILTIN_CHAINS
+ChainParams make_builtin_params(BuiltinChain chain) {
+    const auto& info = builtin_chain_info(chain);
+    ChainParams params;
+    params.name = info.name;
+    params.ticker = info.ticker;
+    params.consensus_type = info.consensus_type;
+    params.auxpow.chain_id = info.chain_id;
+    return params;
+}
+
+} // anonymous namespace
+
 ChainRegistry& ChainRegistry::instance() {
     static ChainRegistry instance;
     return instance;
@@ -23,12 +67,7 @@ ChainRegistry::ChainRegistry() {
 void ChainRegistry::init_builtin_chains() {
     // Bitcoin (родительская chain)
     {
-        ChainParams params;
-        params.name = "bitcoin";
-        params.ticker = "BTC";
-        params.genesis_hash = {};
-        params.consensus_type = ConsensusType::PURE_AUXPOW;
-        params.auxpow.chain_id = 0;
+        auto params = make_builtin_params(BuiltinChain::Bitcoin);
         params.auxpow.magic_bytes = {0xfa, 0xbe, 0x6d, 0x6d};
         params.auxpow.start_height = 0;
         params.auxpow.version_flag = 0x20000000;
@@ -43,16 +82,13 @@ void ChainRegistry::init_builtin_chains() {
         params.mainnet.default_port = 8333;
         params.mainnet.rpc_port = 8332;
         params.mainnet.dns_seeds = {"seed.bitcoin.sipa.be", "dnsseed.bluematt.me"};
+        params.checkpoints = BITCOIN_CHECKPOINTS;
         register_chain(std::move(params));
     }
     
     // Namecoin (chain_id = 1)
     {
-        ChainParams params;
-        params.name = "namecoin";
-        params.ticker = "NMC";
-        params.consensus_type = ConsensusType::PURE_AUXPOW;
-        params.auxpow.chain_id = 1;
+        auto params = make_builtin_params(BuiltinChain::Namecoin);
         params.auxpow.start_height = 19200;
         params.auxpow.version_flag = 0x00620102;
         params.difficulty.target_spacing = 600;
@@ -70,11 +106,7 @@ void ChainRegistry::init_builtin_chains() {
     
     // Syscoin (chain_id = 57)
     {
-        ChainParams params;
-        params.name = "syscoin";
-        params.ticker = "SYS";
-        params.consensus_type = ConsensusType::AUXPOW_CHAINLOCK;
-        params.auxpow.chain_id = 57;
+        auto params = make_builtin_params(BuiltinChain::Syscoin);
         params.auxpow.start_height = 1;
         params.difficulty.target_spacing = 150;
         params.difficulty.adjustment_interval = 1;
@@ -90,11 +122,7 @@ void ChainRegistry::init_builtin_chains() {
     
     // Elastos (chain_id = custom)
     {
-        ChainParams params;
-        params.name = "elastos";
-        params.ticker = "ELA";
-        params.consensus_type = ConsensusType::AUXPOW_HYBRID_BPOS;
-        params.auxpow.chain_id = 0;
+        auto params = make_builtin_params(BuiltinChain::Elastos);
         params.auxpow.start_height = 0;
         params.difficulty.target_spacing = 120;
         params.difficulty.adjustment_interval = 720;
@@ -110,11 +138,7 @@ void ChainRegistry::init_builtin_chains() {
     
     // Emercoin (chain_id = 6)
     {
-        ChainParams params;
-        params.name = "emercoin";
-        params.ticker = "EMC";
-        params.consensus_type = ConsensusType::AUXPOW_HYBRID_POS;
-        params.auxpow.chain_id = 6;
+        auto params = make_builtin_params(BuiltinChain::Emercoin);
         params.auxpow.start_height = 217750;
         params.difficulty.target_spacing = 600;
         params.difficulty.adjustment_interval = 1;
@@ -131,11 +155,7 @@ void ChainRegistry::init_builtin_chains() {
     
     // RSK / Rootstock (chain_id = 30)
     {
-        ChainParams params;
-        params.name = "rsk";
-        params.ticker = "RBTC";
-        params.consensus_type = ConsensusType::AUXPOW_DECOR;
-        params.auxpow.chain_id = 30;
+        auto params = make_builtin_params(BuiltinChain::Rsk);
         params.auxpow.start_height = 0;
         params.difficulty.target_spacing = 30;
         params.difficulty.adjustment_interval = 1;
@@ -151,11 +171,7 @@ void ChainRegistry::init_builtin_chains() {
     
     // Hathor (chain_id = custom)
     {
-        ChainParams params;
-        params.name = "hathor";
-        params.ticker = "HTR";
-        params.consensus_type = ConsensusType::AUXPOW_DAG;
-        params.auxpow.chain_id = 0;
+        auto params = make_builtin_params(BuiltinChain::Hathor);
         params.auxpow.start_height = 0;
         params.difficulty.target_spacing = 30;
         params.difficulty.adjustment_interval = 1;
@@ -172,11 +188,7 @@ void ChainRegistry::init_builtin_chains() {
     
     // VCash (chain_id = 2)
     {
-        ChainParams params;
-        params.name = "vcash";
-        params.ticker = "XVC";
-        params.consensus_type = ConsensusType::PURE_AUXPOW;
-        params.auxpow.chain_id = 2;
+        auto params = make_builtin_params(BuiltinChain::VCash);
         params.auxpow.start_height = 0;
         params.difficulty.target_spacing = 200;
         params.difficulty.adjustment_interval = 2016;
@@ -192,11 +204,7 @@ void ChainRegistry::init_builtin_chains() {
     
     // Fractal Bitcoin (chain_id = custom)
     {
-        ChainParams params;
-        params.name = "fractal";
-        params.ticker = "FB";
-        params.consensus_type = ConsensusType::PURE_AUXPOW;
-        params.auxpow.chain_id = 0;
+        auto params = make_builtin_params(BuiltinChain::Fractal);
         params.auxpow.start_height = 0;
         params.auxpow.version_flag = 0x20000000;
         params.difficulty.target_spacing = 600;
@@ -213,11 +221,7 @@ void ChainRegistry::init_builtin_chains() {
     
     // Myriad (chain_id = 3)
     {
-        ChainParams params;
-        params.name = "myriad";
-        params.ticker = "XMY";
-        params.consensus_type = ConsensusType::PURE_AUXPOW;
-        params.auxpow.chain_id = 3;
+        auto params = make_builtin_params(BuiltinChain::Myriad);
         params.auxpow.start_height = 1402000;
         params.difficulty.target_spacing = 60;
         params.difficulty.adjustment_interval = 1;
@@ -233,11 +237,7 @@ void ChainRegistry::init_builtin_chains() {
     
     // Huntercoin (chain_id = 12)
     {
-        ChainParams params;
-        params.name = "huntercoin";
-        params.ticker = "HUC";
-        params.consensus_type = ConsensusType::PURE_AUXPOW;
-        params.auxpow.chain_id = 12;
+        auto params = make_builtin_params(BuiltinChain::Huntercoin);
         params.auxpow.start_height = 0;
         params.difficulty.target_spacing = 60;
         params.difficulty.adjustment_interval = 1;
@@ -253,11 +253,7 @@ void ChainRegistry::init_builtin_chains() {
     
     // Unobtanium (chain_id = 8)
     {
-        ChainParams params;
-        params.name = "unobtanium";
-        params.ticker = "UNO";
-        params.consensus_type = ConsensusType::PURE_AUXPOW;
-        params.auxpow.chain_id = 8;
+        auto params = make_builtin_params(BuiltinChain::Unobtanium);
         params.auxpow.start_height = 600000;
         params.difficulty.target_spacing = 180;
         params.difficulty.adjustment_interval = 2016;
@@ -273,11 +269,7 @@ void ChainRegistry::init_builtin_chains() {
     
     // Terracoin (chain_id = 5)
     {
-        ChainParams params;
-        params.name = "terracoin";
-        params.ticker = "TRC";
-        params.consensus_type = ConsensusType::PURE_AUXPOW;
-        params.auxpow.chain_id = 5;
+        auto params = make_builtin_params(BuiltinChain::Terracoin);
         params.auxpow.start_height = 833000;
         params.difficulty.target_spacing = 120;
         params.difficulty.adjustment_interval = 2016;
@@ -391,107 +383,71 @@ bool ChainRegistry::register_chain(ChainParams params) {
 
 // Удобные функции доступа
 const ChainParams& bitcoin_params() {
-    const auto* params = ChainRegistry::instance().get_by_name("bitcoin");
-    if (!params) {
-        throw std::runtime_error("Bitcoin params not found");
-    }
-    return *params;
+    return ChainRegistry::instance().get(BuiltinChain::Bitcoin);
 }
 
 const ChainParams& namecoin_params() {
-    const auto* params = ChainRegistry::instance().get_by_name("namecoin");
-    if (!params) {
-        throw std::runtime_error("Namecoin params not found");
-    }
-    return *params;
+    return ChainRegistry::instance().get(BuiltinChain::Namecoin);
 }
 
 const ChainParams& syscoin_params() {
-    const auto* params = ChainRegistry::instance().get_by_name("syscoin");
-    if (!params) {
-        throw std::runtime_error("Syscoin params not found");
-    }
-    return *params;
+    return ChainRegistry::instance().get(BuiltinChain::Syscoin);
 }
 
 const ChainParams& elastos_params() {
-    const auto* params = ChainRegistry::instance().get_by_name("elastos");
-    if (!params) {
-        throw std::runtime_error("Elastos params not found");
-    }
-    return *params;
+    return ChainRegistry::instance().get(BuiltinChain::Elastos);
 }
 
 const ChainParams& emercoin_params() {
-    const auto* params = ChainRegistry::instance().get_by_name("emercoin");
-    if (!params) {
-        throw std::runtime_error("Emercoin params not found");
-    }
-    return *params;
+    return ChainRegistry::instance().get(BuiltinChain::Emercoin);
 }
 
 const ChainParams& rsk_params() {
-    const auto* params = ChainRegistry::instance().get_by_name("rsk");
-    if (!params) {
-        throw std::runtime_error("RSK params not found");
-    }
-    return *params;
+    return ChainRegistry::instance().get(BuiltinChain::Rsk);
 }
 
 const ChainParams& hathor_params() {
-    const auto* params = ChainRegistry::instance().get_by_name("hathor");
-    if (!params) {
-        throw std::runtime_error("Hathor params not found");
-    }
-    return *params;
+    return ChainRegistry::instance().get(BuiltinChain::Hathor);
 }
 
 const ChainParams& vcash_params() {
-    const auto* params = ChainRegistry::instance().get_by_name("vcash");
-    if (!params) {
-        throw std::runtime_error("VCash params not found");
-    }
-    return *params;
+    return ChainRegistry::instance().get(BuiltinChain::VCash);
 }
 
 const ChainParams& fractal_params() {
-    const auto* params = ChainRegistry::instance().get_by_name("fractal");
-    if (!params) {
-        throw std::runtime_error("Fractal params not found");
-    }
-    return *params;
+    return ChainRegistry::instance().get(BuiltinChain::Fractal);
 }
 
 const ChainParams& myriad_params() {
-    const auto* params = ChainRegistry::instance().get_by_name("myriad");
-    if (!params) {
-        throw std::runtime_error("Myriad params not found");
-    }
-    return *params;
+    return ChainRegistry::instance().get(BuiltinChain::Myriad);
 }
 
 const ChainParams& huntercoin_params() {
-    const auto* params = ChainRegistry::instance().get_by_name("huntercoin");
-    if (!params) {
-        throw std::runtime_error("Huntercoin params not found");
-    }
-    return *params;
+    return ChainRegistry::instance().get(BuiltinChain::Huntercoin);
 }
 
 const ChainParams& unobtanium_params() {
-    const auto* params = ChainRegistry::instance().get_by_name("unobtanium");
-    if (!params) {
-        throw std::runtime_error("Unobtanium params not found");
-    }
-    return *params;
+    return ChainRegistry::instance().get(BuiltinChain::Unobtanium);
 }
 
 const ChainParams& terracoin_params() {
-    const auto* params = ChainRegistry::instance().get_by_name("terracoin");
-    if (!params) {
-        throw std::runtime_error("Terracoin params not found");
-    }
-    return *params;
+    return ChainRegistry::instance().get(BuiltinChain::Terracoin);
+}
+
+ChainParams regtest_params(const ChainParams& base) {
+    ChainParams params = base;
+    params.name = base.name + " regtest";
+    params.auxpow.start_height = 0;
+    params.difficulty.pow_limit_bits = 0x207fffff;
+    params.difficulty.allow_min_difficulty = true;
+    params.difficulty.adjustment_interval = 150;
+    params.checkpoints = {};
+    params.mainnet.magic = {0xfa, 0xbf, 0xb5, 0xda};
+    params.mainnet.default_port = 18444;
+    params.mainnet.rpc_port = constants::BITCOIN_RPC_PORT_REGTEST;
+    params.mainnet.dns_seeds.clear();
+    params.testnet.reset();
+    return params;
 }
 
 } // namespace quaxis::core
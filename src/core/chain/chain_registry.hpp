@@ -10,6 +10,8 @@
 
 #include "chain_params.hpp"
 
+#include <array>
+#include <deque>
 #include <string_view>
 #include <optional>
 #include <vector>
@@ -19,6 +21,107 @@
 
 namespace quaxis::core {
 
+// =============================================================================
+// Встроенные chains (таблица при компиляции)
+// =============================================================================
+
+/**
+ * @brief Встроенная chain (индекс в BUILTIN_CHAINS и в ChainRegistry)
+ */
+enum class BuiltinChain : uint8_t {
+    Bitcoin = 0,
+    Namecoin,
+    Syscoin,
+    Elastos,
+    Emercoin,
+    Rsk,
+    Hathor,
+    VCash,
+    Fractal,
+    Myriad,
+    Huntercoin,
+    Unobtanium,
+    Terracoin,
+};
+
+/**
+ * @brief Идентификация встроенной chain
+ * 
+ * Остальные параметры (сеть, сложность, награды) содержат std::string и
+ * std::vector и заполняются в ChainRegistry.
+ */
+struct BuiltinChainInfo {
+    BuiltinChain chain;
+    std::string_view name;
+    std::string_view ticker;
+    uint32_t chain_id;
+    ConsensusType consensus_type;
+};
+
+/// @brief Таблица встроенных chains (порядок - как в BuiltinChain)
+inline constexpr std::array BUILTIN_CHAINS{
+    BuiltinChainInfo{BuiltinChain::Bitcoin, "bitcoin", "BTC", 0, ConsensusType::PURE_AUXPOW},
+    BuiltinChainInfo{BuiltinChain::Namecoin, "namecoin", "NMC", 1, ConsensusType::PURE_AUXPOW},
+    BuiltinChainInfo{BuiltinChain::Syscoin, "syscoin", "SYS", 57, ConsensusType::AUXPOW_CHAINLOCK},
+    BuiltinChainInfo{BuiltinChain::Elastos, "elastos", "ELA", 0, ConsensusType::AUXPOW_HYBRID_BPOS},
+    BuiltinChainInfo{BuiltinChain::Emercoin, "emercoin", "EMC", 6, ConsensusType::AUXPOW_HYBRID_POS},
+    BuiltinChainInfo{BuiltinChain::Rsk, "rsk", "RBTC", 30, ConsensusType::AUXPOW_DECOR},
+    BuiltinChainInfo{BuiltinChain::Hathor, "hathor", "HTR", 0, ConsensusType::AUXPOW_DAG},
+    BuiltinChainInfo{BuiltinChain::VCash, "vcash", "XVC", 2, ConsensusType::PURE_AUXPOW},
+    BuiltinChainInfo{BuiltinChain::Fractal, "fractal", "FB", 0, ConsensusType::PURE_AUXPOW},
+    BuiltinChainInfo{BuiltinChain::Myriad, "myriad", "XMY", 3, ConsensusType::PURE_AUXPOW},
+    BuiltinChainInfo{BuiltinChain::Huntercoin, "huntercoin", "HUC", 12, ConsensusType::PURE_AUXPOW},
+    BuiltinChainInfo{BuiltinChain::Unobtanium, "unobtanium", "UNO", 8, ConsensusType::PURE_AUXPOW},
+    BuiltinChainInfo{BuiltinChain::Terracoin, "terracoin", "TRC", 5, ConsensusType::PURE_AUXPOW},
+};
+
+static_assert([] {
+    for (std::size_t i = 0; i < BUILTIN_CHAINS.size(); ++i) {
+        if (static_cast<std::size_t>(BUILTIN_CHAINS[i].chain) != i) return false;
+    }
+    return true;
+}(), "BUILTIN_CHAINS должна идти в порядке BuiltinChain");
+
+/**
+ * @brief Идентификация встроенной chain
+ */
+[[nodiscard]] constexpr const BuiltinChainInfo& builtin_chain_info(BuiltinChain chain) noexcept {
+    return BUILTIN_CHAINS[static_cast<std::size_t>(chain)];
+}
+
+/**
+ * @brief Встроенная chain по имени (точное совпадение, нижний регистр)
+ * 
+ * @param name Имя chain ("namecoin", "rsk", ...)
+ * @return BuiltinChain или nullopt
+ */
+[[nodiscard]] constexpr std::optional<BuiltinChain> find_builtin_chain(std::string_view name) noexcept {
+    for (const auto& info : BUILTIN_CHAINS) {
+        if (info.name == name) {
+            return info.chain;
+        }
+    }
+    return std::nullopt;
+}
+
+/**
+ * @brief Встроенная chain по chain_id (0 - без собственного id)
+ * 
+ * @param chain_id Идентификатор chain в aux merkle tree
+ * @return BuiltinChain или nullopt
+ */
+[[nodiscard]] constexpr std::optional<BuiltinChain> find_builtin_chain(uint32_t chain_id) noexcept {
+    if (chain_id == 0) {
+        return std::nullopt;
+    }
+    for (const auto& info : BUILTIN_CHAINS) {
+        if (info.chain_id == chain_id) {
+            return info.chain;
+        }
+    }
+    return std::nullopt;
+}
+
 /**
  * @brief Реестр параметров всех поддерживаемых блокчейнов
  * 
@@ -52,6 +155,16 @@ public:
      */
     [[nodiscard]] const ChainParams* get_by_name(std::string_view name) const;
     
+    /**
+     * @brief Получить параметры встроенной chain (O(1), без поиска)
+     * 
+     * @param chain Встроенная chain
+     * @return const ChainParams& Параметры
+     */
+    [[nodiscard]] const ChainParams& get(BuiltinChain chain) const noexcept {
+        return chains_[static_cast<std::size_t>(chain)];
+    }
+    
     /**
      * @brief Получить параметры chain по тикеру
      * 
@@ -130,8 +243,9 @@ private:
     /// @brief Инициализировать встроенные chains
     void init_builtin_chains();
     
-    /// @brief Хранилище параметров chains
-    std::vector<ChainParams> chains_;
+    /// @brief Хранилище параметров chains: сначала встроенные в порядке
+    /// BuiltinChain, затем зарегистрированные (deque - указатели стабильны)
+    std::deque<ChainParams> chains_;
     
     /// @brief Индекс по имени
     std::unordered_map<std::string, std::size_t> name_index_;
@@ -212,4 +326,16 @@ private:
  */
 [[nodiscard]] const ChainParams& terracoin_params();
 
+/**
+ * @brief Параметры regtest на основе chain
+ * 
+ * pow limit 0x207fffff (хеш проходит с вероятностью 1/2), минимальная
+ * сложность разрешена, интервал пересчёта 150 блоков, без контрольных
+ * точек, AuxPoW с генезиса, сеть regtest Bitcoin Core. Для сквозных
+ * тестов с программным хешированием.
+ * 
+ * @param base Chain, правила которой сохраняются (AuxPoW, награды)
+ */
+[[nodiscard]] ChainParams regtest_params(const ChainParams& base = bitcoin_params());
+
 } // namespace quaxis::core
@@ -72,27 +72,82 @@ enum class ConsensusType : uint8_t {
     }
 }
 
+// =============================================================================
+// Свойства консенсуса при компиляции
+// =============================================================================
+
 /**
- * @brief Проверить, поддерживает ли консенсус стандартный AuxPoW
+ * @brief Свойства типа консенсуса (специализация на каждый тип)
+ * 
+ * Код, зависящий от консенсуса, пишется шаблоном по ConsensusTraits<T>
+ * и вызывается через visit_consensus(): один switch на входе вместо
+ * проверок типа внутри.
+ */
+template<ConsensusType T>
+struct ConsensusTraits {
+    /// @brief Стандартный AuxPoW (coinbase commitment + aux branch)
+    static constexpr bool standard_auxpow = true;
+    
+    /// @brief Награда делится с proof-of-stake участниками
+    static constexpr bool reward_splitting = false;
+};
+
+template<>
+struct ConsensusTraits<ConsensusType::AUXPOW_HYBRID_BPOS> {
+    static constexpr bool standard_auxpow = true;
+    static constexpr bool reward_splitting = true;
+};
+
+template<>
+struct ConsensusTraits<ConsensusType::AUXPOW_DECOR> {
+    static constexpr bool standard_auxpow = false;
+    static constexpr bool reward_splitting = false;
+};
+
+template<>
+struct ConsensusTraits<ConsensusType::AUXPOW_DAG> {
+    static constexpr bool standard_auxpow = false;
+    static constexpr bool reward_splitting = false;
+};
+
+/**
+ * @brief Вызвать f.template operator()<T>() для типа консенсуса type
  * 
  * @param type Тип консенсуса
- * @return true если поддерживает стандартный AuxPoW
+ * @param f Обобщённая лямбда []<ConsensusType T>() { ... }
+ * @return Результат f (для неизвестного типа - как для PURE_AUXPOW)
  */
-[[nodiscard]] constexpr bool supports_standard_auxpow(ConsensusType type) noexcept {
+template<typename F>
+constexpr decltype(auto) visit_consensus(ConsensusType type, F&& f) {
     switch (type) {
-        case ConsensusType::PURE_AUXPOW:
         case ConsensusType::AUXPOW_CHAINLOCK:
+            return f.template operator()<ConsensusType::AUXPOW_CHAINLOCK>();
         case ConsensusType::AUXPOW_HYBRID_POS:
+            return f.template operator()<ConsensusType::AUXPOW_HYBRID_POS>();
         case ConsensusType::AUXPOW_HYBRID_BPOS:
-            return true;
+            return f.template operator()<ConsensusType::AUXPOW_HYBRID_BPOS>();
         case ConsensusType::AUXPOW_DECOR:
+            return f.template operator()<ConsensusType::AUXPOW_DECOR>();
         case ConsensusType::AUXPOW_DAG:
-            return false;
+            return f.template operator()<ConsensusType::AUXPOW_DAG>();
+        case ConsensusType::PURE_AUXPOW:
         default:
-            return false;
+            return f.template operator()<ConsensusType::PURE_AUXPOW>();
     }
 }
 
+/**
+ * @brief Проверить, поддерживает ли консенсус стандартный AuxPoW
+ * 
+ * @param type Тип консенсуса
+ * @return true если поддерживает стандартный AuxPoW
+ */
+[[nodiscard]] constexpr bool supports_standard_auxpow(ConsensusType type) noexcept {
+    return visit_consensus(type, []<ConsensusType T>() {
+        return ConsensusTraits<T>::standard_auxpow;
+    });
+}
+
 /**
  * @brief Проверить, требует ли консенсус специальной обработки наград
  * 
@@ -100,7 +155,9 @@ enum class ConsensusType : uint8_t {
  * @return true если требуется специальная обработка наград
  */
 [[nodiscard]] constexpr bool has_reward_splitting(ConsensusType type) noexcept {
-    return type == ConsensusType::AUXPOW_HYBRID_BPOS;
+    return visit_consensus(type, []<ConsensusType T>() {
+        return ConsensusTraits<T>::reward_splitting;
+    });
 }
 
 } // namespace quaxis::core
@@ -0,0 +1,127 @@
+/**
+ * @file difficulty.hpp
+ * @brief Пересчёт сложности (как GetNextWorkRequired в Bitcoin Core)
+ *
+ * Сложность следующего блока считается заранее, при приходе предыдущего:
+ * на высоте пересчёта (height % adjustment_interval == 0) шаблон
+ * получает готовые bits из EpochDifficulty, как на любой другой высоте.
+ */
+
+#pragma once
+
+#include "chain_params.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+
+namespace quaxis::core {
+
+/**
+ * @brief Сложность следующего блока, посчитанная при приходе tip
+ */
+struct EpochDifficulty {
+    /// @brief Высота блока, для которого посчитано (tip + 1)
+    uint32_t height{0};
+
+    /// @brief Родитель этого блока (tip при расчёте)
+    Hash256 prev_hash{};
+
+    /// @brief Compact target, target и сложность следующего блока
+    uint32_t bits{0};
+    uint256 target;
+    double difficulty{0.0};
+
+    /// @brief Первая высота эпохи блока height
+    uint32_t epoch_start{0};
+
+    /**
+     * @brief Правило min-difficulty (testnet): блок с timestamp больше
+     *        этого значения может иметь pow_limit_bits; 0 - правило выключено
+     */
+    uint32_t min_difficulty_after{0};
+
+    /**
+     * @brief Bits блока с данным timestamp
+     */
+    [[nodiscard]] constexpr uint32_t bits_for(uint32_t timestamp, const DifficultyParams& params) const noexcept {
+        return min_difficulty_after != 0 && timestamp > min_difficulty_after ? params.pow_limit_bits : bits;
+    }
+};
+
+/**
+ * @brief Высота, на которой меняется сложность
+ */
+[[nodiscard]] constexpr bool is_retarget_height(const DifficultyParams& params, uint32_t height) noexcept {
+    return params.adjustment_interval != 0 && height % params.adjustment_interval == 0;
+}
+
+/**
+ * @brief Первая высота эпохи, в которую входит height
+ */
+[[nodiscard]] constexpr uint32_t epoch_start_height(const DifficultyParams& params, uint32_t height) noexcept {
+    return params.adjustment_interval == 0 ? 0 : height - height % params.adjustment_interval;
+}
+
+/**
+ * @brief Задержка, после которой testnet разрешает блок минимальной сложности
+ */
+[[nodiscard]] constexpr uint32_t min_difficulty_delay(const DifficultyParams& params) noexcept {
+    return params.min_difficulty_time != 0 ? params.min_difficulty_time : 2 * params.target_spacing;
+}
+
+/**
+ * @brief Target новой эпохи (CalculateNextWorkRequired)
+ *
+ * Время эпохи ограничивается [T/4, 4T], где T = adjustment_interval *
+ * target_spacing; результат не выше pow_limit.
+ *
+ * @param params Параметры сложности
+ * @param last_bits Bits последнего блока эпохи
+ * @param actual_timespan Время от первого до последнего блока эпохи
+ */
+[[nodiscard]] constexpr uint256 calculate_next_target(
+    const DifficultyParams& params,
+    uint32_t last_bits,
+    int64_t actual_timespan
+) noexcept {
+    const int64_t timespan = int64_t{params.adjustment_interval} * params.target_spacing;
+    if (timespan <= 0) {
+        return bits_to_target(last_bits);
+    }
+    const int64_t actual = std::clamp(actual_timespan, timespan / 4, timespan * 4);
+
+    const uint256 limit = params.pow_limit();
+    const auto fits = [actual](const uint256& value) {
+        return value.bits() + static_cast<unsigned>(std::bit_width(static_cast<uint64_t>(actual))) <= 256;
+    };
+    uint256 target = bits_to_target(last_bits);
+    uint64_t remainder = 0;
+    if (fits(target)) {
+        target *= static_cast<uint64_t>(actual);
+        target.divide(static_cast<uint64_t>(timespan), remainder);
+    } else {
+        // Target около 2^255 (regtest): сначала деление, иначе переполнение
+        target.divide(static_cast<uint64_t>(timespan), remainder);
+        if (!fits(target)) {
+            return limit;
+        }
+        target *= static_cast<uint64_t>(actual);
+    }
+    return target > limit ? limit : target;
+}
+
+/**
+ * @brief Bits новой эпохи по timestamps её первого и последнего блока
+ */
+[[nodiscard]] constexpr uint32_t calculate_next_bits(
+    const DifficultyParams& params,
+    uint32_t last_bits,
+    uint32_t first_timestamp,
+    uint32_t last_timestamp
+) noexcept {
+    return target_to_bits(calculate_next_target(
+        params, last_bits, int64_t{last_timestamp} - int64_t{first_timestamp}));
+}
+
+} // namespace quaxis::core
@@ -0,0 +1,38 @@
+/**
+ * @file clock.cpp
+ * @brief Калибровка TscClock
+ */
+
+#include "clock.hpp"
+
+namespace quaxis::core {
+
+namespace {
+
+/**
+ * @brief Частота ticks() по steady_clock за ~2 мс
+ */
+double calibrate() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+    using Clock = std::chrono::steady_clock;
+    const auto wall_start = Clock::now();
+    const uint64_t ticks_start = TscClock::ticks();
+    while (Clock::now() - wall_start < std::chrono::milliseconds(2)) {
+    }
+    const uint64_t ticks = TscClock::ticks() - ticks_start;
+    const double ns = std::chrono::duration<double, std::nano>(Clock::now() - wall_start).count();
+    if (ns > 0.0 && ticks > 0) {
+        return static_cast<double>(ticks) / ns;
+    }
+#endif
+    return 1.0;  // steady_clock: наносекунды
+}
+
+} // anonymous namespace
+
+double TscClock::ticks_per_ns() noexcept {
+    static const double value = calibrate();
+    return value;
+}
+
+} // namespace quaxis::core
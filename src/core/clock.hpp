@@ -0,0 +1,137 @@
+/**
+ * @file clock.hpp
+ * @brief Часы горячего пути: калиброванный TSC и грубые кешированные часы
+ *
+ * Создание задания, проверка share на устаревание, шаблоны aux chains,
+ * учёт активности соединений звали steady_clock::now() на каждый пакет
+ * или share. Точность там нужна разная:
+ * - замер латентности (реконструкция блока, трассировка) - TscClock:
+ *   rdtsc, переведённый в наносекунды по частоте, откалиброванной один
+ *   раз по steady_clock;
+ * - сроки в секундах (возраст задания, шаблона, последний share) -
+ *   CoarseClock: значение steady_clock, которое поток таймеров
+ *   Executor обновляет каждый шаг колеса (timer_tick_ms). Чтение - одна
+ *   relaxed загрузка.
+ *
+ * Пока ни один Executor не запущен (тесты, утилиты), CoarseClock::now()
+ * читает steady_clock напрямую, поэтому поведение без исполнителя не
+ * меняется.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace quaxis::core {
+
+// =============================================================================
+// TSC
+// =============================================================================
+
+/**
+ * @brief Точные метки для замера латентности
+ *
+ * rdtsc на x86 (постоянная частота на современных CPU), иначе
+ * steady_clock в наносекундах. Метки разных процессов не сравниваются.
+ */
+class TscClock {
+public:
+    /**
+     * @brief Текущая метка
+     */
+    [[nodiscard]] static uint64_t ticks() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+    }
+
+    /**
+     * @brief Меток в наносекунде (калибровка ~2 мс при первом вызове)
+     */
+    [[nodiscard]] static double ticks_per_ns() noexcept;
+
+    /**
+     * @brief Перевести разность меток в наносекунды
+     */
+    [[nodiscard]] static uint64_t to_ns(uint64_t ticks) noexcept {
+        return static_cast<uint64_t>(static_cast<double>(ticks) / ticks_per_ns());
+    }
+
+    /**
+     * @brief Наносекунд с метки start
+     */
+    [[nodiscard]] static uint64_t elapsed_ns(uint64_t start) noexcept {
+        return to_ns(ticks() - start);
+    }
+};
+
+// =============================================================================
+// Грубые часы
+// =============================================================================
+
+/**
+ * @brief steady_clock с точностью до шага колеса таймеров Executor
+ *
+ * Для сроков, которые меряются секундами: значение может отставать от
+ * steady_clock::now() на шаг колеса, но никогда не опережает его.
+ */
+class CoarseClock {
+public:
+    using Clock = std::chrono::steady_clock;
+    using time_point = Clock::time_point;
+
+    /**
+     * @brief Текущее время (кешированное, если поток таймеров работает)
+     */
+    [[nodiscard]] static time_point now() noexcept {
+        if (drivers_.load(std::memory_order_relaxed) == 0) {
+            return Clock::now();
+        }
+        return time_point(Clock::duration(cached_.load(std::memory_order_relaxed)));
+    }
+
+    /**
+     * @brief Обновить кешированное время (поток таймеров)
+     */
+    static void update(time_point now = Clock::now()) noexcept {
+        cached_.store(now.time_since_epoch().count(), std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Поток таймеров начал обновлять часы
+     */
+    static void attach() noexcept {
+        update();
+        drivers_.fetch_add(1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Поток таймеров остановлен: now() снова читает steady_clock
+     */
+    static void detach() noexcept {
+        drivers_.fetch_sub(1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Часы обновляются потоком таймеров
+     */
+    [[nodiscard]] static bool cached() noexcept {
+        return drivers_.load(std::memory_order_relaxed) != 0;
+    }
+
+private:
+    static inline std::atomic<Clock::rep> cached_{0};
+    static inline std::atomic<uint32_t> drivers_{0};
+};
+
+} // namespace quaxis::core
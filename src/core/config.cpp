@@ -6,8 +6,11 @@
  */
 
 #include "config.hpp"
+#include "thread_plan.hpp"
+#include "async_log.hpp"
 
 #include <toml++/toml.hpp>
+#include <algorithm>
 #include <format>
 #include <fstream>
 
@@ -43,6 +46,120 @@ Result<Config> Config::load(const std::filesystem::path& path) {
             if (auto val = (*server)["max_connections"].value<int64_t>()) {
                 config.server.max_connections = static_cast<std::size_t>(*val);
             }
+            if (auto val = (*server)["engine"].value<std::string>()) {
+                config.server.engine = *val;
+            }
+            if (auto val = (*server)["worker_threads"].value<int64_t>()) {
+                config.server.worker_threads = static_cast<std::size_t>(*val);
+            }
+            if (auto val = (*server)["listeners"].value<int64_t>()) {
+                config.server.listeners = static_cast<std::size_t>(*val);
+            }
+            if (auto val = (*server)["listen_backlog"].value<int64_t>()) {
+                config.server.listen_backlog = static_cast<uint32_t>(*val);
+            }
+            if (auto val = (*server)["io_uring"].value<bool>()) {
+                config.server.io_uring = *val;
+            }
+            if (auto val = (*server)["share_batch_size"].value<int64_t>()) {
+                config.server.share_batch_size = static_cast<std::size_t>(*val);
+            }
+            if (auto val = (*server)["share_batch_flush_ms"].value<int64_t>()) {
+                config.server.share_batch_flush_ms = static_cast<uint32_t>(*val);
+            }
+            if (auto val = (*server)["session_grace_seconds"].value<int64_t>()) {
+                config.server.session_grace_seconds = static_cast<uint32_t>(*val);
+            }
+            if (auto val = (*server)["heartbeat_interval_seconds"].value<int64_t>()) {
+                config.server.heartbeat_interval_seconds = static_cast<uint32_t>(*val);
+            }
+            if (auto val = (*server)["heartbeat_timeout_seconds"].value<int64_t>()) {
+                config.server.heartbeat_timeout_seconds = static_cast<uint32_t>(*val);
+            }
+            if (auto val = (*server)["ntime_roll_seconds"].value<int64_t>()) {
+                config.server.ntime_roll_seconds = static_cast<uint32_t>(*val);
+            }
+            
+            // === Подсекция [server.vardiff] ===
+            if (auto vardiff = (*server)["vardiff"].as_table()) {
+                auto& vd = config.server.vardiff;
+                if (auto val = (*vardiff)["enabled"].value<bool>()) {
+                    vd.enabled = *val;
+                }
+                if (auto val = (*vardiff)["target_shares_per_minute"].value<double>()) {
+                    vd.target_shares_per_minute = *val;
+                }
+                if (auto val = (*vardiff)["start_difficulty"].value<int64_t>()) {
+                    vd.start_difficulty = static_cast<uint32_t>(*val);
+                }
+                if (auto val = (*vardiff)["min_difficulty"].value<int64_t>()) {
+                    vd.min_difficulty = static_cast<uint32_t>(*val);
+                }
+                if (auto val = (*vardiff)["max_difficulty"].value<int64_t>()) {
+                    vd.max_difficulty = static_cast<uint32_t>(*val);
+                }
+                if (auto val = (*vardiff)["retarget_seconds"].value<int64_t>()) {
+                    vd.retarget_seconds = static_cast<uint32_t>(*val);
+                }
+                if (auto val = (*vardiff)["variance_percent"].value<int64_t>()) {
+                    vd.variance_percent = static_cast<uint32_t>(*val);
+                }
+            }
+            
+            // === Подсекция [server.multicast] ===
+            if (auto multicast = (*server)["multicast"].as_table()) {
+                auto& mc = config.server.multicast;
+                if (auto val = (*multicast)["enabled"].value<bool>()) {
+                    mc.enabled = *val;
+                }
+                if (auto val = (*multicast)["group"].value<std::string>()) {
+                    mc.group = *val;
+                }
+                if (auto val = (*multicast)["port"].value<int64_t>()) {
+                    mc.port = static_cast<uint16_t>(*val);
+                }
+                if (auto val = (*multicast)["interface"].value<std::string>()) {
+                    mc.interface = *val;
+                }
+                if (auto val = (*multicast)["ttl"].value<int64_t>()) {
+                    mc.ttl = static_cast<uint32_t>(*val);
+                }
+            }
+            
+            // === Подсекция [server.socket] ===
+            if (auto socket = (*server)["socket"].as_table()) {
+                auto& sock = config.server.socket;
+                if (auto val = (*socket)["no_delay"].value<bool>()) {
+                    sock.no_delay = *val;
+                }
+                if (auto val = (*socket)["quick_ack"].value<bool>()) {
+                    sock.quick_ack = *val;
+                }
+                if (auto val = (*socket)["busy_poll_us"].value<int64_t>()) {
+                    sock.busy_poll_us = static_cast<uint32_t>(*val);
+                }
+                if (auto val = (*socket)["user_timeout_ms"].value<int64_t>()) {
+                    sock.user_timeout_ms = static_cast<uint32_t>(*val);
+                }
+                if (auto val = (*socket)["keepalive_idle"].value<int64_t>()) {
+                    sock.keepalive_idle = static_cast<uint32_t>(*val);
+                }
+                if (auto val = (*socket)["keepalive_interval"].value<int64_t>()) {
+                    sock.keepalive_interval = static_cast<uint32_t>(*val);
+                }
+                if (auto val = (*socket)["keepalive_count"].value<int64_t>()) {
+                    sock.keepalive_count = static_cast<uint32_t>(*val);
+                }
+                if (auto val = (*socket)["priority"].value<int64_t>()) {
+                    sock.priority = static_cast<int32_t>(*val);
+                }
+                if (auto val = (*socket)["dscp"].value<int64_t>()) {
+                    sock.dscp = static_cast<int32_t>(*val);
+                }
+                if (auto val = (*socket)["send_buffer"].value<int64_t>()) {
+                    sock.send_buffer = static_cast<uint32_t>(*val);
+                }
+            }
         }
         
         // === Секция [parent_chain] ===
@@ -56,6 +173,18 @@ Result<Config> Config::load(const std::filesystem::path& path) {
             if (auto val = (*parent_chain)["payout_address"].value<std::string>()) {
                 config.parent_chain.payout_address = *val;
             }
+            if (auto val = (*parent_chain)["submit_rpc_host"].value<std::string>()) {
+                config.parent_chain.submit_rpc_host = *val;
+            }
+            if (auto val = (*parent_chain)["submit_rpc_port"].value<int64_t>()) {
+                config.parent_chain.submit_rpc_port = static_cast<uint16_t>(*val);
+            }
+            if (auto val = (*parent_chain)["submit_rpc_user"].value<std::string>()) {
+                config.parent_chain.submit_rpc_user = *val;
+            }
+            if (auto val = (*parent_chain)["submit_rpc_password"].value<std::string>()) {
+                config.parent_chain.submit_rpc_password = *val;
+            }
             
             // Парсим seed_nodes
             if (auto nodes = (*parent_chain)["seed_nodes"].as_array()) {
@@ -79,6 +208,9 @@ Result<Config> Config::load(const std::filesystem::path& path) {
             if (auto val = (*mining)["job_queue_size"].value<int64_t>()) {
                 config.mining.job_queue_size = static_cast<std::size_t>(*val);
             }
+            if (auto val = (*mining)["share_difficulty"].value<double>()) {
+                config.mining.share_difficulty = *val;
+            }
             if (auto val = (*mining)["use_spy_mining"].value<bool>()) {
                 config.mining.use_spy_mining = *val;
             }
@@ -88,6 +220,42 @@ Result<Config> Config::load(const std::filesystem::path& path) {
             if (auto val = (*mining)["empty_blocks_only"].value<bool>()) {
                 config.mining.empty_blocks_only = *val;
             }
+            if (auto val = (*mining)["version_slots"].value<int64_t>()) {
+                config.mining.version_slots = static_cast<std::size_t>(*val);
+            }
+            if (auto val = (*mining)["extranonce_lease"].value<int64_t>()) {
+                config.mining.extranonce_lease = static_cast<std::size_t>(*val);
+            }
+            if (auto val = (*mining)["job_prefetch"].value<int64_t>()) {
+                config.mining.job_prefetch = static_cast<std::size_t>(*val);
+            }
+            if (auto val = (*mining)["local_version_rolling"].value<bool>()) {
+                config.mining.local_version_rolling = *val;
+            }
+            if (auto val = (*mining)["version_partition_bits"].value<int64_t>()) {
+                config.mining.version_partition_bits = static_cast<std::size_t>(*val);
+            }
+            if (auto val = (*mining)["validator_threads"].value<int64_t>()) {
+                config.mining.validator_threads = static_cast<std::size_t>(*val);
+            }
+            if (auto val = (*mining)["duplicate_filter_shares"].value<int64_t>()) {
+                config.mining.duplicate_filter_shares = static_cast<std::size_t>(*val);
+            }
+            if (auto val = (*mining)["competing_tips"].value<int64_t>()) {
+                config.mining.competing_tips = static_cast<std::size_t>(*val);
+            }
+            if (auto val = (*mining)["regenerate_threads"].value<int64_t>()) {
+                config.mining.regenerate_threads = static_cast<std::size_t>(*val);
+            }
+            if (auto val = (*mining)["prelease_pool"].value<int64_t>()) {
+                config.mining.prelease_pool = static_cast<std::size_t>(*val);
+            }
+            if (auto val = (*mining)["virtual_asic_threads"].value<int64_t>()) {
+                config.mining.virtual_asic_threads = static_cast<std::size_t>(*val);
+            }
+            if (auto val = (*mining)["virtual_asic_difficulty"].value<double>()) {
+                config.mining.virtual_asic_difficulty = *val;
+            }
         }
         
         // === Секция [shm] ===
@@ -110,6 +278,103 @@ Result<Config> Config::load(const std::filesystem::path& path) {
             if (auto val = (*shm)["sleep_us"].value<int64_t>()) {
                 config.shm.sleep_us = static_cast<uint32_t>(*val);
             }
+            if (auto val = (*shm)["futex_wait"].value<bool>()) {
+                config.shm.futex_wait = *val;
+            }
+            if (auto val = (*shm)["futex_spin_iterations"].value<int64_t>()) {
+                config.shm.futex_spin_iterations = static_cast<uint32_t>(*val);
+            }
+            if (auto val = (*shm)["futex_timeout_us"].value<int64_t>()) {
+                config.shm.futex_timeout_us = static_cast<uint32_t>(*val);
+            }
+            if (auto val = (*shm)["template_enabled"].value<bool>()) {
+                config.shm.template_enabled = *val;
+            }
+            if (auto val = (*shm)["template_path"].value<std::string>()) {
+                config.shm.template_path = *val;
+            }
+            if (auto val = (*shm)["submit_enabled"].value<bool>()) {
+                config.shm.submit_enabled = *val;
+            }
+            if (auto val = (*shm)["submit_path"].value<std::string>()) {
+                config.shm.submit_path = *val;
+            }
+            if (auto val = (*shm)["hugetlb_dir"].value<std::string>()) {
+                config.shm.hugetlb_dir = *val;
+            }
+            if (auto val = (*shm)["numa_node"].value<int64_t>()) {
+                config.shm.numa_node = static_cast<int32_t>(*val);
+            }
+            if (auto val = (*shm)["cpu_affinity"].value<int64_t>()) {
+                config.shm.cpu_affinity = static_cast<int32_t>(*val);
+            }
+        }
+        
+        // === Секция [zmq] ===
+        if (auto zmq = table["zmq"].as_table()) {
+            if (auto val = (*zmq)["enabled"].value<bool>()) {
+                config.zmq.enabled = *val;
+            }
+            if (auto val = (*zmq)["endpoint"].value<std::string>()) {
+                config.zmq.endpoint = *val;
+            }
+            if (auto val = (*zmq)["receive_timeout_ms"].value<int64_t>()) {
+                config.zmq.receive_timeout_ms = static_cast<uint32_t>(*val);
+            }
+            if (auto val = (*zmq)["cpu_affinity"].value<int64_t>()) {
+                config.zmq.cpu_affinity = static_cast<int32_t>(*val);
+            }
+        }
+        
+        // === Секция [executor] ===
+        if (auto executor = table["executor"].as_table()) {
+            if (auto val = (*executor)["workers"].value<int64_t>()) {
+                config.executor.workers = static_cast<std::size_t>(*val);
+            }
+            if (auto val = (*executor)["timer_tick_ms"].value<int64_t>()) {
+                config.executor.timer_tick_ms = static_cast<uint32_t>(*val);
+            }
+            if (auto val = (*executor)["latency_cpu"].value<int64_t>()) {
+                config.executor.latency_cpu = static_cast<int32_t>(*val);
+            }
+        }
+        
+        // === Секция [threads] ===
+        if (auto threads = table["threads"].as_table()) {
+            if (auto val = (*threads)["block_path_cpus"].value<std::string>()) {
+                config.threads.block_path_cpus = *val;
+            }
+            if (auto val = (*threads)["fanout_cpus"].value<std::string>()) {
+                config.threads.fanout_cpus = *val;
+            }
+            if (auto val = (*threads)["background_cpus"].value<std::string>()) {
+                config.threads.background_cpus = *val;
+            }
+            if (auto val = (*threads)["block_path_priority"].value<int64_t>()) {
+                config.threads.block_path_priority = static_cast<int32_t>(*val);
+            }
+            if (auto val = (*threads)["lock_memory"].value<bool>()) {
+                config.threads.lock_memory = *val;
+            }
+            if (auto val = (*threads)["prefault_stack_kb"].value<int64_t>()) {
+                config.threads.prefault_stack_kb = static_cast<uint32_t>(*val);
+            }
+            if (auto val = (*threads)["dump_topology"].value<bool>()) {
+                config.threads.dump_topology = *val;
+            }
+        }
+        
+        // === Секция [handoff] ===
+        if (auto handoff = table["handoff"].as_table()) {
+            if (auto val = (*handoff)["enabled"].value<bool>()) {
+                config.handoff.enabled = *val;
+            }
+            if (auto val = (*handoff)["socket_path"].value<std::string>()) {
+                config.handoff.socket_path = *val;
+            }
+            if (auto val = (*handoff)["timeout_ms"].value<int64_t>()) {
+                config.handoff.timeout_ms = static_cast<uint32_t>(*val);
+            }
         }
         
         // === Секция [logging] ===
@@ -120,12 +385,24 @@ Result<Config> Config::load(const std::filesystem::path& path) {
             if (auto val = (*logging)["level"].value<std::string>()) {
                 config.logging.level = *val;
             }
+            if (auto val = (*logging)["output"].value<std::string>()) {
+                config.logging.output = *val;
+            }
+            if (auto val = (*logging)["file"].value<std::string>()) {
+                config.logging.file = *val;
+            }
+            if (auto val = (*logging)["flush_interval_ms"].value<int64_t>()) {
+                config.logging.flush_interval_ms = static_cast<uint32_t>(*val);
+            }
             if (auto val = (*logging)["event_history"].value<int64_t>()) {
                 config.logging.event_history = static_cast<std::size_t>(*val);
             }
             if (auto val = (*logging)["color"].value<bool>()) {
                 config.logging.color = *val;
             }
+            if (auto val = (*logging)["display"].value<std::string>()) {
+                config.logging.display = *val;
+            }
             if (auto val = (*logging)["show_hashrate"].value<bool>()) {
                 config.logging.show_hashrate = *val;
             }
@@ -135,6 +412,95 @@ Result<Config> Config::load(const std::filesystem::path& path) {
             if (auto val = (*logging)["show_chain_block_counts"].value<bool>()) {
                 config.logging.show_chain_block_counts = *val;
             }
+            if (auto val = (*logging)["latency_trace"].value<bool>()) {
+                config.logging.latency_trace = *val;
+            }
+            if (auto val = (*logging)["latency_trace_dump"].value<std::string>()) {
+                config.logging.latency_trace_dump = *val;
+            }
+            if (auto val = (*logging)["pmu_profile"].value<bool>()) {
+                config.logging.pmu_profile = *val;
+            }
+        }
+        
+        // === Секция [metrics] ===
+        if (auto metrics = table["metrics"].as_table()) {
+            if (auto val = (*metrics)["enabled"].value<bool>()) {
+                config.metrics.enabled = *val;
+            }
+            if (auto val = (*metrics)["bind_address"].value<std::string>()) {
+                config.metrics.bind_address = *val;
+            }
+            if (auto val = (*metrics)["port"].value<int64_t>()) {
+                config.metrics.port = static_cast<uint16_t>(*val);
+            }
+            if (auto val = (*metrics)["shm_path"].value<std::string>()) {
+                config.metrics.shm_path = *val;
+            }
+        }
+        
+        // === Секция [journal] ===
+        if (auto journal = table["journal"].as_table()) {
+            if (auto val = (*journal)["enabled"].value<bool>()) {
+                config.journal.enabled = *val;
+            }
+            if (auto val = (*journal)["directory"].value<std::string>()) {
+                config.journal.directory = *val;
+            }
+            if (auto val = (*journal)["file_mb"].value<int64_t>()) {
+                config.journal.file_mb = static_cast<uint32_t>(*val);
+            }
+            if (auto val = (*journal)["sync_ms"].value<int64_t>()) {
+                config.journal.sync_ms = static_cast<uint32_t>(*val);
+            }
+            if (auto val = (*journal)["max_files"].value<int64_t>()) {
+                config.journal.max_files = static_cast<uint32_t>(*val);
+            }
+        }
+        
+        // === Секция [spool] ===
+        if (auto spool = table["spool"].as_table()) {
+            if (auto val = (*spool)["enabled"].value<bool>()) {
+                config.spool.enabled = *val;
+            }
+            if (auto val = (*spool)["path"].value<std::string>()) {
+                config.spool.path = *val;
+            }
+            if (auto val = (*spool)["slots"].value<int64_t>()) {
+                config.spool.slots = static_cast<uint32_t>(*val);
+            }
+            if (auto val = (*spool)["max_block_mb"].value<int64_t>()) {
+                config.spool.max_block_mb = static_cast<uint32_t>(*val);
+            }
+        }
+        
+        // === Секция [proxy] ===
+        if (auto proxy = table["proxy"].as_table()) {
+            if (auto val = (*proxy)["upstream_host"].value<std::string>()) {
+                config.proxy.upstream_host = *val;
+            }
+            if (auto val = (*proxy)["upstream_port"].value<int64_t>()) {
+                config.proxy.upstream_port = static_cast<uint16_t>(*val);
+            }
+            if (auto val = (*proxy)["site"].value<int64_t>()) {
+                config.proxy.site = static_cast<uint32_t>(*val);
+            }
+            if (auto val = (*proxy)["reconnect_ms"].value<int64_t>()) {
+                config.proxy.reconnect_ms = static_cast<uint32_t>(*val);
+            }
+            if (auto val = (*proxy)["feed_port"].value<int64_t>()) {
+                config.proxy.feed_port = static_cast<uint16_t>(*val);
+            }
+            if (auto val = (*proxy)["feed_bind_address"].value<std::string>()) {
+                config.proxy.feed_bind_address = *val;
+            }
+        }
+        
+        // === Секция [cluster] ===
+        if (auto cluster = table["cluster"].as_table()) {
+            if (auto val = (*cluster)["node"].value<int64_t>()) {
+                config.cluster.node = static_cast<uint32_t>(*val);
+            }
         }
         
         // === Секция [relay] ===
@@ -151,12 +517,93 @@ Result<Config> Config::load(const std::filesystem::path& path) {
             if (auto val = (*relay)["reconstruction_timeout"].value<int64_t>()) {
                 config.relay.reconstruction_timeout = static_cast<uint32_t>(*val);
             }
+            if (auto val = (*relay)["max_inflight_blocks"].value<int64_t>()) {
+                config.relay.max_inflight_blocks = static_cast<uint32_t>(*val);
+            }
             if (auto val = (*relay)["fec_enabled"].value<bool>()) {
                 config.relay.fec_enabled = *val;
             }
             if (auto val = (*relay)["fec_overhead"].value<double>()) {
                 config.relay.fec_overhead = *val;
             }
+            if (auto val = (*relay)["broadcast_burst"].value<int64_t>()) {
+                config.relay.broadcast_burst = static_cast<uint32_t>(*val);
+            }
+            if (auto val = (*relay)["broadcast_rate_mbps"].value<int64_t>()) {
+                config.relay.broadcast_rate_mbps = static_cast<uint32_t>(*val);
+            }
+            if (auto val = (*relay)["fec_scheme"].value<std::string>()) {
+                config.relay.fec_scheme = *val;
+            }
+            if (auto val = (*relay)["recv_batch"].value<int64_t>()) {
+                config.relay.recv_batch = static_cast<uint32_t>(*val);
+            }
+            if (auto val = (*relay)["udp_gro"].value<bool>()) {
+                config.relay.udp_gro = *val;
+            }
+            if (auto val = (*relay)["busy_poll_us"].value<int64_t>()) {
+                config.relay.busy_poll_us = static_cast<uint32_t>(*val);
+            }
+            if (auto val = (*relay)["recv_buffer_size"].value<int64_t>()) {
+                config.relay.recv_buffer_size = static_cast<uint32_t>(*val);
+            }
+            if (auto val = (*relay)["recv_buffer_autotune"].value<bool>()) {
+                config.relay.recv_buffer_autotune = *val;
+            }
+            if (auto val = (*relay)["xdp_interface"].value<std::string>()) {
+                config.relay.xdp_interface = *val;
+            }
+            if (auto val = (*relay)["xdp_queue"].value<int64_t>()) {
+                config.relay.xdp_queue = static_cast<uint32_t>(*val);
+            }
+            if (auto val = (*relay)["worker_busy_poll"].value<bool>()) {
+                config.relay.worker_busy_poll = *val;
+            }
+            if (auto val = (*relay)["worker_cpu_affinity"].value<int64_t>()) {
+                config.relay.worker_cpu_affinity = static_cast<int32_t>(*val);
+            }
+            if (auto val = (*relay)["header_first"].value<bool>()) {
+                config.relay.header_first = *val;
+            }
+            if (auto val = (*relay)["receive_threads"].value<int64_t>()) {
+                config.relay.receive_threads = static_cast<uint32_t>(*val);
+            }
+            if (auto val = (*relay)["receive_cpus"].value<std::string>()) {
+                config.relay.receive_cpus = *val;
+            }
+            if (auto val = (*relay)["receive_steer_cpu"].value<bool>()) {
+                config.relay.receive_steer_cpu = *val;
+            }
+            if (auto val = (*relay)["handoff_queue_size"].value<int64_t>()) {
+                config.relay.handoff_queue_size = static_cast<uint32_t>(*val);
+            }
+            if (auto val = (*relay)["decode_thread"].value<bool>()) {
+                config.relay.decode_thread = *val;
+            }
+            if (auto val = (*relay)["decode_cpu"].value<int64_t>()) {
+                config.relay.decode_cpu = static_cast<int32_t>(*val);
+            }
+            if (auto val = (*relay)["verify_threads"].value<int64_t>()) {
+                config.relay.verify_threads = static_cast<uint32_t>(*val);
+            }
+            if (auto val = (*relay)["mempool_prefill"].value<bool>()) {
+                config.relay.mempool_prefill = *val;
+            }
+            if (auto val = (*relay)["tx_cache_size"].value<int64_t>()) {
+                config.relay.tx_cache_size = static_cast<uint32_t>(*val);
+            }
+            if (auto val = (*relay)["adaptive_peers"].value<bool>()) {
+                config.relay.adaptive_peers = *val;
+            }
+            if (auto val = (*relay)["slow_peer_lag_ms"].value<int64_t>()) {
+                config.relay.slow_peer_lag_ms = static_cast<uint32_t>(*val);
+            }
+            if (auto val = (*relay)["slow_peer_min_blocks"].value<int64_t>()) {
+                config.relay.slow_peer_min_blocks = static_cast<uint32_t>(*val);
+            }
+            if (auto val = (*relay)["slow_peer_drop"].value<bool>()) {
+                config.relay.slow_peer_drop = *val;
+            }
             
             // Парсим пиры из [[relay.peers]]
             if (auto peers = (*relay)["peers"].as_array()) {
@@ -190,6 +637,12 @@ Result<Config> Config::load(const std::filesystem::path& path) {
             if (auto val = (*merged)["health_check_interval"].value<int64_t>()) {
                 config.merged_mining.health_check_interval = static_cast<uint32_t>(*val);
             }
+            if (auto val = (*merged)["template_cache_path"].value<std::string>()) {
+                config.merged_mining.template_cache_path = *val;
+            }
+            if (auto val = (*merged)["template_cache_max_age"].value<int64_t>()) {
+                config.merged_mining.template_cache_max_age = static_cast<uint32_t>(*val);
+            }
             
             // Парсим chains из [[merged_mining.chains]]
             if (auto chains = (*merged)["chains"].as_array()) {
@@ -224,6 +677,18 @@ Result<Config> Config::load(const std::filesystem::path& path) {
                         if (auto update_interval = (*chain_table)["update_interval"].value<int64_t>()) {
                             chain_config.update_interval = static_cast<uint32_t>(*update_interval);
                         }
+                        if (auto deadline = (*chain_table)["template_deadline_ms"].value<int64_t>()) {
+                            chain_config.template_deadline_ms = static_cast<uint32_t>(*deadline);
+                        }
+                        if (auto failures = (*chain_table)["breaker_failures"].value<int64_t>()) {
+                            chain_config.breaker_failures = static_cast<uint32_t>(*failures);
+                        }
+                        if (auto open_seconds = (*chain_table)["breaker_open_seconds"].value<int64_t>()) {
+                            chain_config.breaker_open_seconds = static_cast<uint32_t>(*open_seconds);
+                        }
+                        if (auto longpoll = (*chain_table)["longpoll"].value<bool>()) {
+                            chain_config.longpoll = *longpoll;
+                        }
                         
                         if (!chain_config.name.empty()) {
                             config.merged_mining.chains.push_back(std::move(chain_config));
@@ -310,6 +775,48 @@ Result<void> Config::validate() const {
         );
     }
     
+    // Проверка подписки ZMQ
+    if (zmq.enabled && zmq.endpoint.empty()) {
+        return Err<void>(
+            ErrorCode::ConfigInvalidValue,
+            "zmq.endpoint не указан"
+        );
+    }
+    
+    // Проверка колеса таймеров
+    if (executor.timer_tick_ms == 0) {
+        return Err<void>(
+            ErrorCode::ConfigInvalidValue,
+            "executor.timer_tick_ms должен быть больше 0"
+        );
+    }
+    
+    // Проверка плана размещения потоков
+    for (const auto& [name, list] : {std::pair{"block_path_cpus", &threads.block_path_cpus},
+                                     std::pair{"fanout_cpus", &threads.fanout_cpus},
+                                     std::pair{"background_cpus", &threads.background_cpus}}) {
+        if (auto cpus = core::parse_cpu_set(*list); !cpus) {
+            return Err<void>(
+                ErrorCode::ConfigInvalidValue,
+                std::format("threads.{}: {}", name, cpus.error().message)
+            );
+        }
+    }
+    if (threads.block_path_priority < 0 || threads.block_path_priority > 99) {
+        return Err<void>(
+            ErrorCode::ConfigInvalidValue,
+            "threads.block_path_priority должен быть от 0 до 99"
+        );
+    }
+    
+    // Путь unix сокета ограничен sun_path (108 байт с нулём)
+    if (handoff.enabled && (handoff.socket_path.empty() || handoff.socket_path.size() >= 108)) {
+        return Err<void>(
+            ErrorCode::ConfigInvalidValue,
+            "handoff.socket_path должен быть непустым и короче 108 символов"
+        );
+    }
+    
     // Проверка размера extranonce
     if (mining.extranonce_size < 1 || mining.extranonce_size > 8) {
         return Err<void>(
@@ -318,6 +825,147 @@ Result<void> Config::validate() const {
         );
     }
     
+    // Проверка числа слотов версий
+    if (mining.version_slots < 1 || mining.version_slots > constants::MAX_VERSION_SLOTS) {
+        return Err<void>(
+            ErrorCode::ConfigInvalidValue,
+            "version_slots должен быть от 1 до 4"
+        );
+    }
+    
+    // Проверка аренды extranonce
+    if (mining.extranonce_lease > constants::MAX_EXTRANONCE_LEASE) {
+        return Err<void>(
+            ErrorCode::ConfigInvalidValue,
+            "extranonce_lease должен быть от 0 до 16777216"
+        );
+    }
+    if (mining.extranonce_lease > 0 && mining.version_slots > 1) {
+        return Err<void>(
+            ErrorCode::ConfigInvalidValue,
+            "extranonce_lease нельзя совмещать с version_slots > 1"
+        );
+    }
+    
+    // Проверка очереди заданий ASIC
+    if (mining.job_prefetch > constants::MAX_JOB_PREFETCH) {
+        return Err<void>(
+            ErrorCode::ConfigInvalidValue,
+            "job_prefetch должен быть от 0 до 16"
+        );
+    }
+    if (mining.job_prefetch > 0 && (mining.extranonce_lease > 1 || mining.version_slots > 1)) {
+        return Err<void>(
+            ErrorCode::ConfigInvalidValue,
+            "job_prefetch - только для обычных заданий (без extranonce_lease и version_slots)"
+        );
+    }
+    if (mining.local_version_rolling &&
+        (mining.extranonce_lease > 1 || mining.version_slots > 1 || mining.job_prefetch > 0)) {
+        return Err<void>(
+            ErrorCode::ConfigInvalidValue,
+            "local_version_rolling несовместим с extranonce_lease, version_slots и job_prefetch"
+        );
+    }
+    if (mining.version_partition_bits > 0 &&
+        (!mining.local_version_rolling || mining.version_partition_bits > constants::MAX_VERSION_PARTITION_BITS)) {
+        return Err<void>(
+            ErrorCode::ConfigInvalidValue,
+            "version_partition_bits - от 0 до 8 и только с local_version_rolling"
+        );
+    }
+    
+    // Проверка пула проверки shares
+    if (mining.validator_threads > constants::MAX_VALIDATOR_THREADS) {
+        return Err<void>(
+            ErrorCode::ConfigInvalidValue,
+            "validator_threads должен быть от 0 до 64"
+        );
+    }
+    
+    // Проверка программного ASIC
+    if (mining.virtual_asic_threads > constants::MAX_VIRTUAL_ASIC_THREADS) {
+        return Err<void>(
+            ErrorCode::ConfigInvalidValue,
+            "virtual_asic_threads должен быть от 0 до 256"
+        );
+    }
+    if (mining.virtual_asic_difficulty < 0.0) {
+        return Err<void>(
+            ErrorCode::ConfigInvalidValue,
+            "virtual_asic_difficulty не может быть отрицательной"
+        );
+    }
+    if (!(mining.share_difficulty > 0.0)) {
+        return Err<void>(
+            ErrorCode::ConfigInvalidValue,
+            "mining.share_difficulty должна быть больше 0"
+        );
+    }
+    
+    // Проверка асинхронного лога
+    if (!core::parse_log_level(logging.level)) {
+        return Err<void>(
+            ErrorCode::ConfigInvalidValue,
+            "logging.level должен быть 'error', 'warn', 'info' или 'debug'"
+        );
+    }
+    if (!core::parse_log_output(logging.output)) {
+        return Err<void>(
+            ErrorCode::ConfigInvalidValue,
+            "logging.output должен быть 'console', 'file' или 'journald'"
+        );
+    }
+    if (logging.output == "file" && logging.file.empty()) {
+        return Err<void>(
+            ErrorCode::ConfigInvalidValue,
+            "logging.file не указан для output = 'file'"
+        );
+    }
+    if (logging.display != "auto" && logging.display != "always" && logging.display != "never") {
+        return Err<void>(
+            ErrorCode::ConfigInvalidValue,
+            "logging.display должен быть 'auto', 'always' или 'never'"
+        );
+    }
+    if (logging.flush_interval_ms == 0 || logging.flush_interval_ms > 1000) {
+        return Err<void>(
+            ErrorCode::ConfigInvalidValue,
+            "logging.flush_interval_ms должен быть от 1 до 1000"
+        );
+    }
+    
+    // Проверка фильтра дубликатов
+    if (mining.duplicate_filter_shares > constants::MAX_DUPLICATE_FILTER_SHARES) {
+        return Err<void>(
+            ErrorCode::ConfigInvalidValue,
+            "duplicate_filter_shares должен быть от 0 до 1048576"
+        );
+    }
+    
+    // Проверка числа конкурирующих tip
+    if (mining.competing_tips > constants::MAX_COMPETING_TIPS) {
+        return Err<void>(
+            ErrorCode::ConfigInvalidValue,
+            "competing_tips должен быть от 0 до 8"
+        );
+    }
+    
+    // Проверка пула пересборки заданий
+    if (mining.regenerate_threads > constants::MAX_REGENERATE_THREADS) {
+        return Err<void>(
+            ErrorCode::ConfigInvalidValue,
+            "regenerate_threads должен быть от 0 до 64"
+        );
+    }
+    
+    if (mining.prelease_pool > constants::MAX_PRELEASE_POOL) {
+        return Err<void>(
+            ErrorCode::ConfigInvalidValue,
+            "prelease_pool должен быть от 0 до 4096"
+        );
+    }
+    
     // Проверка размера тега coinbase
     if (mining.coinbase_tag.size() > 20) {
         return Err<void>(
@@ -334,6 +982,304 @@ Result<void> Config::validate() const {
         );
     }
     
+    // Проверка модели ввода-вывода сервера
+    if (server.engine != "threaded" && server.engine != "epoll") {
+        return Err<void>(
+            ErrorCode::ConfigInvalidValue,
+            "server.engine должен быть 'threaded' или 'epoll'"
+        );
+    }
+    
+    if (server.engine == "epoll" && server.worker_threads == 0) {
+        return Err<void>(
+            ErrorCode::ConfigInvalidValue,
+            "server.worker_threads должен быть больше 0"
+        );
+    }
+    
+    if (server.listeners == 0 || server.listeners > constants::MAX_SERVER_LISTENERS) {
+        return Err<void>(
+            ErrorCode::ConfigInvalidValue,
+            std::format("server.listeners должен быть от 1 до {}", constants::MAX_SERVER_LISTENERS)
+        );
+    }
+    
+    if (server.listen_backlog == 0 || server.listen_backlog > constants::MAX_LISTEN_BACKLOG) {
+        return Err<void>(
+            ErrorCode::ConfigInvalidValue,
+            std::format("server.listen_backlog должен быть от 1 до {}", constants::MAX_LISTEN_BACKLOG)
+        );
+    }
+    
+    if (server.session_grace_seconds > constants::MAX_SESSION_GRACE_SECONDS) {
+        return Err<void>(
+            ErrorCode::ConfigInvalidValue,
+            std::format("server.session_grace_seconds не может быть больше {}",
+                        constants::MAX_SESSION_GRACE_SECONDS)
+        );
+    }
+    
+    if (server.heartbeat_timeout_seconds > 0 && server.heartbeat_interval_seconds == 0) {
+        return Err<void>(
+            ErrorCode::ConfigInvalidValue,
+            "server.heartbeat_timeout_seconds требует heartbeat_interval_seconds > 0"
+        );
+    }
+    
+    if (server.ntime_roll_seconds >= constants::MAX_FUTURE_BLOCK_TIME) {
+        return Err<void>(
+            ErrorCode::ConfigInvalidValue,
+            std::format("server.ntime_roll_seconds должен быть меньше {}",
+                        constants::MAX_FUTURE_BLOCK_TIME)
+        );
+    }
+    
+    // Очередь CMD_QUEUE_JOB уже сдвигает timestamp, текущее задание ASIC
+    // сервер в ней не отслеживает
+    if (server.ntime_roll_seconds > 0 && mining.job_prefetch > 0) {
+        return Err<void>(
+            ErrorCode::ConfigInvalidValue,
+            "server.ntime_roll_seconds несовместим с mining.job_prefetch"
+        );
+    }
+    
+    // Проверка схемы FEC relay
+    if (relay.fec_scheme != "reed_solomon" && relay.fec_scheme != "xor") {
+        return Err<void>(
+            ErrorCode::ConfigInvalidValue,
+            "relay.fec_scheme должен быть 'reed_solomon' или 'xor'"
+        );
+    }
+    
+    // Проверка рассылки relay
+    if (relay.fec_overhead < 0.0 || relay.fec_overhead > 1.0) {
+        return Err<void>(
+            ErrorCode::ConfigInvalidValue,
+            "relay.fec_overhead должен быть от 0 до 1"
+        );
+    }
+    if (relay.broadcast_burst == 0) {
+        return Err<void>(
+            ErrorCode::ConfigInvalidValue,
+            "relay.broadcast_burst должен быть больше 0"
+        );
+    }
+    
+    // Проверка пула реконструкторов relay (индекс пула 16-битный)
+    if (relay.max_inflight_blocks == 0 || relay.max_inflight_blocks > 1024) {
+        return Err<void>(
+            ErrorCode::ConfigInvalidValue,
+            "relay.max_inflight_blocks должен быть от 1 до 1024"
+        );
+    }
+    
+    // Проверка потоков приёма relay (маска пробуждений 64-битная)
+    if (relay.receive_threads == 0 || relay.receive_threads > 64) {
+        return Err<void>(
+            ErrorCode::ConfigInvalidValue,
+            "relay.receive_threads должен быть от 1 до 64"
+        );
+    }
+    if (auto cpus = core::parse_cpu_set(relay.receive_cpus); !cpus) {
+        return Err<void>(
+            ErrorCode::ConfigInvalidValue,
+            std::format("relay.receive_cpus: {}", cpus.error().message)
+        );
+    }
+    if (relay.handoff_queue_size < 16 || relay.handoff_queue_size > 65536) {
+        return Err<void>(
+            ErrorCode::ConfigInvalidValue,
+            "relay.handoff_queue_size должен быть от 16 до 65536"
+        );
+    }
+    if (relay.verify_threads > 64) {
+        return Err<void>(
+            ErrorCode::ConfigInvalidValue,
+            "relay.verify_threads должен быть от 0 до 64"
+        );
+    }
+    // Ядро удваивает запрос SO_RCVBUF в int
+    if (relay.recv_buffer_size > (1u << 30)) {
+        return Err<void>(
+            ErrorCode::ConfigInvalidValue,
+            "relay.recv_buffer_size должен быть не больше 1 ГиБ"
+        );
+    }
+    
+    // Проверка ранга пиров relay
+    if (relay.adaptive_peers && (relay.slow_peer_min_blocks == 0 || relay.slow_peer_lag_ms == 0)) {
+        return Err<void>(
+            ErrorCode::ConfigInvalidValue,
+            "relay.slow_peer_min_blocks и relay.slow_peer_lag_ms должны быть больше 0"
+        );
+    }
+    
+    // Проверка пакетных shares (count в кадре 1 байт, flush_ms 2 байта)
+    if (server.share_batch_size > 32) {
+        return Err<void>(
+            ErrorCode::ConfigInvalidValue,
+            "server.share_batch_size не может быть больше 32"
+        );
+    }
+    
+    if (server.share_batch_size > 1 &&
+        (server.share_batch_flush_ms == 0 || server.share_batch_flush_ms > 65535)) {
+        return Err<void>(
+            ErrorCode::ConfigInvalidValue,
+            "server.share_batch_flush_ms должен быть от 1 до 65535"
+        );
+    }
+    
+    // Проверка vardiff
+    if (server.vardiff.enabled) {
+        const auto& vd = server.vardiff;
+        if (vd.target_shares_per_minute <= 0.0) {
+            return Err<void>(
+                ErrorCode::ConfigInvalidValue,
+                "server.vardiff.target_shares_per_minute должен быть больше 0"
+            );
+        }
+        if (vd.min_difficulty == 0 || vd.min_difficulty > vd.max_difficulty ||
+            vd.start_difficulty < vd.min_difficulty || vd.start_difficulty > vd.max_difficulty) {
+            return Err<void>(
+                ErrorCode::ConfigInvalidValue,
+                "server.vardiff: нужно 1 <= min_difficulty <= start_difficulty <= max_difficulty"
+            );
+        }
+        if (vd.retarget_seconds == 0) {
+            return Err<void>(
+                ErrorCode::ConfigInvalidValue,
+                "server.vardiff.retarget_seconds должен быть больше 0"
+            );
+        }
+    }
+    
+    // Проверка multicast-уведомлений (адрес группы проверяет сервер при запуске)
+    if (server.multicast.enabled) {
+        if (server.multicast.port == 0) {
+            return Err<void>(
+                ErrorCode::ConfigInvalidValue,
+                "server.multicast.port не может быть 0"
+            );
+        }
+        if (server.multicast.ttl == 0 || server.multicast.ttl > 255) {
+            return Err<void>(
+                ErrorCode::ConfigInvalidValue,
+                "server.multicast.ttl должен быть от 1 до 255"
+            );
+        }
+    }
+    
+    // Проверка настроек сокетов ASIC
+    if (server.socket.priority < -1 || server.socket.priority > 6) {
+        return Err<void>(
+            ErrorCode::ConfigInvalidValue,
+            "server.socket.priority должен быть от 0 до 6 (-1 - не менять)"
+        );
+    }
+    if (server.socket.dscp < -1 || server.socket.dscp > 63) {
+        return Err<void>(
+            ErrorCode::ConfigInvalidValue,
+            "server.socket.dscp должен быть от 0 до 63 (-1 - не менять)"
+        );
+    }
+    if (server.socket.keepalive_idle > 0 &&
+        (server.socket.keepalive_interval == 0 || server.socket.keepalive_count == 0 ||
+         server.socket.keepalive_count > 127)) {
+        return Err<void>(
+            ErrorCode::ConfigInvalidValue,
+            "server.socket.keepalive_interval должен быть больше 0, keepalive_count - от 1 до 127"
+        );
+    }
+    
+    // Проверка журнала shares
+    if (journal.enabled) {
+        if (journal.directory.empty()) {
+            return Err<void>(
+                ErrorCode::ConfigInvalidValue,
+                "journal.directory не указан"
+            );
+        }
+        if (journal.file_mb == 0 || journal.file_mb > 65536) {
+            return Err<void>(
+                ErrorCode::ConfigInvalidValue,
+                "journal.file_mb должен быть от 1 до 65536"
+            );
+        }
+        if (journal.sync_ms == 0) {
+            return Err<void>(
+                ErrorCode::ConfigInvalidValue,
+                "journal.sync_ms должен быть больше 0"
+            );
+        }
+    }
+    
+    // Проверка spool блоков
+    if (spool.enabled) {
+        if (spool.path.empty()) {
+            return Err<void>(
+                ErrorCode::ConfigInvalidValue,
+                "spool.path не указан"
+            );
+        }
+        if (spool.slots == 0 || spool.slots > 1024) {
+            return Err<void>(
+                ErrorCode::ConfigInvalidValue,
+                "spool.slots должен быть от 1 до 1024"
+            );
+        }
+        if (spool.max_block_mb == 0 || spool.max_block_mb > 32) {
+            return Err<void>(
+                ErrorCode::ConfigInvalidValue,
+                "spool.max_block_mb должен быть от 1 до 32"
+            );
+        }
+    }
+    
+    // Проверка прокси (номер площадки - старший байт делегированного диапазона)
+    if (!proxy.upstream_host.empty()) {
+        if (proxy.site == 0 || proxy.site > 255) {
+            return Err<void>(
+                ErrorCode::ConfigInvalidValue,
+                "proxy.site должен быть от 1 до 255"
+            );
+        }
+        if (proxy.upstream_port == 0) {
+            return Err<void>(
+                ErrorCode::ConfigInvalidValue,
+                "proxy.upstream_port не может быть 0"
+            );
+        }
+        if (proxy.reconnect_ms == 0) {
+            return Err<void>(
+                ErrorCode::ConfigInvalidValue,
+                "proxy.reconnect_ms должен быть больше 0"
+            );
+        }
+    }
+    
+    // Проверка кластера (номер узла - старший байт extranonce)
+    if (cluster.node != 0) {
+        if (cluster.node > 255) {
+            return Err<void>(
+                ErrorCode::ConfigInvalidValue,
+                "cluster.node должен быть от 0 до 255"
+            );
+        }
+        if (mining.extranonce_size < 2) {
+            return Err<void>(
+                ErrorCode::ConfigInvalidValue,
+                "cluster.node требует mining.extranonce_size не меньше 2"
+            );
+        }
+        if (!proxy.upstream_host.empty()) {
+            return Err<void>(
+                ErrorCode::ConfigInvalidValue,
+                "Узлы площадки различаются proxy.site, cluster.node не нужен"
+            );
+        }
+    }
+    
     // Проверка merged mining chains
     if (merged_mining.enabled) {
         for (const auto& chain : merged_mining.chains) {
@@ -356,4 +1302,19 @@ Result<void> Config::validate() const {
     return {};
 }
 
+std::size_t Config::duplicate_filter_shares() const noexcept {
+    if (mining.duplicate_filter_shares > 0) {
+        return mining.duplicate_filter_shares;
+    }
+    if (!server.vardiff.enabled) {
+        return constants::DEFAULT_DUPLICATE_FILTER_SHARES;
+    }
+    double expected = server.vardiff.target_shares_per_minute * constants::DUPLICATE_FILTER_JOB_MINUTES;
+    return std::clamp(
+        static_cast<std::size_t>(std::max(expected, 0.0)),
+        constants::MIN_DUPLICATE_FILTER_SHARES,
+        constants::MAX_DUPLICATE_FILTER_SHARES
+    );
+}
+
 } // namespace quaxis
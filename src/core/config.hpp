@@ -51,9 +51,107 @@ namespace quaxis {
 // Структуры конфигурации
 // =============================================================================
 
+/**
+ * @brief Настройки vardiff (переменной сложности shares по ASIC)
+ * 
+ * Сервер подбирает каждому соединению сложность так, чтобы ASIC
+ * присылал около target_shares_per_minute shares независимо от хешрейта.
+ */
+struct VardiffConfig {
+    /// @brief Включить vardiff (иначе SetDifficulty не отправляется)
+    bool enabled = false;
+    
+    /// @brief Целевое количество shares в минуту от одного ASIC
+    double target_shares_per_minute = 20.0;
+    
+    /// @brief Начальная сложность нового соединения
+    uint32_t start_difficulty = 1;
+    
+    /// @brief Минимальная сложность
+    uint32_t min_difficulty = 1;
+    
+    /// @brief Максимальная сложность
+    uint32_t max_difficulty = 1u << 30;
+    
+    /// @brief Окно измерения частоты shares (секунды)
+    uint32_t retarget_seconds = 30;
+    
+    /// @brief Допустимое отклонение частоты без пересчёта (%)
+    uint32_t variance_percent = 30;
+    
+    bool operator==(const VardiffConfig&) const = default;
+};
+
 /**
  * @brief Настройки TCP сервера для ASIC
  */
+/**
+ * @brief Multicast-уведомление ASIC о новом блоке
+ * 
+ * На новом блоке сервер шлёт одну UDP датаграмму на группу до рассылки
+ * заданий по TCP: прошивка в той же сети переключается сразу, а не
+ * после своей очереди в рассылке.
+ */
+struct MulticastConfig {
+    /// @brief Включить уведомления
+    bool enabled = false;
+    
+    /// @brief Multicast группа IPv4 (224.0.0.0/4)
+    std::string group = "239.255.51.51";
+    
+    /// @brief UDP порт группы
+    uint16_t port = 3334;
+    
+    /// @brief IPv4 адрес интерфейса сети ASIC (пусто - по таблице маршрутов)
+    std::string interface;
+    
+    /// @brief TTL датаграмм (1 - не дальше своей подсети)
+    uint32_t ttl = 1;
+    
+    bool operator==(const MulticastConfig&) const = default;
+};
+
+/**
+ * @brief Настройки TCP сокетов ASIC
+ * 
+ * Значения по умолчанию - прежнее поведение: только TCP_NODELAY.
+ * Keepalive и TCP_USER_TIMEOUT находят выключенный ASIC за секунды,
+ * а не за минуты ретрансмиссий ядра.
+ */
+struct AsicSocketConfig {
+    /// @brief TCP_NODELAY: кадр задания уходит сразу (без Nagle)
+    bool no_delay = true;
+    
+    /// @brief TCP_QUICKACK после каждого чтения: share подтверждается без задержки ACK
+    bool quick_ack = false;
+    
+    /// @brief SO_BUSY_POLL (мкс, 0 - выключено)
+    uint32_t busy_poll_us = 0;
+    
+    /// @brief TCP_USER_TIMEOUT (мс): сколько ждать ACK отправленного (0 - по ядру)
+    uint32_t user_timeout_ms = 0;
+    
+    /// @brief Простой до первой keepalive пробы (с, 0 - без keepalive)
+    uint32_t keepalive_idle = 0;
+    
+    /// @brief Интервал keepalive проб (с)
+    uint32_t keepalive_interval = 5;
+    
+    /// @brief Проб без ответа до разрыва
+    uint32_t keepalive_count = 3;
+    
+    /// @brief SO_PRIORITY кадров (0-6, -1 - не менять)
+    int32_t priority = -1;
+    
+    /// @brief DSCP кадров (0-63, -1 - не менять)
+    int32_t dscp = -1;
+    
+    /// @brief SO_SNDBUF (байт, 0 - по ядру)
+    uint32_t send_buffer = 0;
+    
+    bool operator==(const AsicSocketConfig&) const = default;
+};
+
 struct ServerConfig {
     /// @brief Адрес для прослушивания (по умолчанию "0.0.0.0")
     std::string bind_address = "0.0.0.0";
@@ -63,6 +161,71 @@ struct ServerConfig {
     
     /// @brief Максимальное количество подключений ASIC
     std::size_t max_connections = constants::DEFAULT_MAX_CONNECTIONS;
+    
+    /// @brief Модель ввода-вывода: "threaded" (2 потока на ASIC) или "epoll"
+    std::string engine = "threaded";
+    
+    /// @brief Количество потоков epoll (каждый владеет шардом соединений)
+    std::size_t worker_threads = 1;
+    
+    /**
+     * @brief Listening сокетов на порт (SO_REUSEPORT при > 1)
+     * 
+     * Ядро раскладывает входящие подключения по сокетам, у каждого свой
+     * поток приёма. В engine = "epoll" сокет получает каждый reactor
+     * (reactor'ов не меньше listeners) и принимает соединения в свой шард.
+     */
+    std::size_t listeners = 1;
+    
+    /// @brief Очередь принятых ядром подключений каждого сокета (listen backlog)
+    uint32_t listen_backlog = 1024;
+    
+    /// @brief Рассылать задания одним пакетом io_uring (если доступен)
+    bool io_uring = false;
+    
+    /// @brief Shares в одном RSP_SHARE_BATCH (0 или 1 - без пакетов)
+    std::size_t share_batch_size = 0;
+    
+    /// @brief Максимальная задержка неполного пакета shares (мс)
+    uint32_t share_batch_flush_ms = 20;
+    
+    /**
+     * @brief Сколько секунд держать extranonce и задания оборвавшегося ASIC
+     * 
+     * Прошивка, переподключившись в этот период, предъявляет токен
+     * сессии (RSP_HELLO) и продолжает прежнюю работу. 0 - без сессий.
+     */
+    uint32_t session_grace_seconds = 0;
+    
+    /**
+     * @brief Через сколько секунд тишины ASIC получает CMD_HEARTBEAT (0 - не слать)
+     */
+    uint32_t heartbeat_interval_seconds = constants::HEARTBEAT_INTERVAL_SEC;
+    
+    /**
+     * @brief Сколько секунд ждать ответа на heartbeat до разрыва (0 - не рвать)
+     */
+    uint32_t heartbeat_timeout_seconds = constants::HEARTBEAT_INTERVAL_SEC;
+    
+    /**
+     * @brief Период ntime roll в секундах (0 - не сдвигать)
+     * 
+     * Каждые ntime_roll_seconds текущее задание ASIC получает новый
+     * timestamp командой CMD_UPDATE_TIME: midstate прежний, ASIC
+     * перебирает nonce заново без нового задания.
+     */
+    uint32_t ntime_roll_seconds = 0;
+
+    /// @brief Сложность shares для каждого ASIC отдельно
+    VardiffConfig vardiff;
+    
+    /// @brief Multicast-уведомление о новом блоке
+    MulticastConfig multicast;
+    
+    /// @brief Настройки TCP сокетов ASIC
+    AsicSocketConfig socket;
+    
+    bool operator==(const ServerConfig&) const = default;
 };
 
 /**
@@ -88,6 +251,20 @@ struct ParentChainConfig {
     
     /// @brief Адрес для выплаты награды (P2WPKH формат bc1q...)
     std::string payout_address;
+    
+    /// @brief Хост RPC ноды для submitblock найденного блока (пусто - не отправлять)
+    std::string submit_rpc_host;
+    
+    /// @brief Порт RPC ноды для submitblock
+    uint16_t submit_rpc_port = 8332;
+    
+    /// @brief Имя пользователя RPC для submitblock
+    std::string submit_rpc_user;
+    
+    /// @brief Пароль RPC для submitblock
+    std::string submit_rpc_password;
+    
+    bool operator==(const ParentChainConfig&) const = default;
 };
 
 /**
@@ -103,6 +280,9 @@ struct MiningConfig {
     /// @brief Размер очереди заданий для ASIC
     std::size_t job_queue_size = constants::DEFAULT_JOB_QUEUE_SIZE;
     
+    /// @brief Сложность partial shares без vardiff (ShareValidator)
+    double share_difficulty = 1.0;
+    
     /// @brief Включить spy mining (начинать майнинг до полной валидации)
     bool use_spy_mining = true;
     
@@ -111,6 +291,61 @@ struct MiningConfig {
     
     /// @brief Создавать пустые блоки (только coinbase, без других транзакций)
     bool empty_blocks_only = true;
+    
+    /// @brief Версий (midstate) в одном задании: 1 - обычное задание,
+    /// 2..MAX_VERSION_SLOTS - CMD_NEW_JOB_SLOTS (нужна поддержка прошивкой)
+    std::size_t version_slots = 1;
+    
+    /// @brief Аренда extranonce: 0 - ASIC получает одно extranonce,
+    /// N - диапазон из N extranonce и CMD_NEW_JOB_LEASE, ASIC сам
+    /// перебирает extranonce (нужна поддержка прошивкой)
+    std::size_t extranonce_lease = 0;
+    
+    /// @brief Очередь заданий ASIC: 0 - только текущее задание, N - после
+    /// задания сервер шлёт N следующих (тот же extranonce, timestamp + 1..N)
+    /// в CMD_QUEUE_JOB, ASIC берёт их сам по исчерпании nonce (нужна
+    /// поддержка прошивкой)
+    std::size_t job_prefetch = 0;
+    
+    /// @brief Локальный version rolling: задание CMD_NEW_JOB_ROLL несёт
+    /// начало заголовка, контроллер ASIC сам перебирает биты BIP320 и
+    /// считает midstate (нужна поддержка прошивкой)
+    bool local_version_rolling = false;
+    
+    /// @brief Доли маски BIP320 по соединениям: старшие N бит маски
+    /// закреплены за extranonce соединения, ASIC перебирает остальные
+    /// (0 - вся маска; до 8, только с local_version_rolling)
+    std::size_t version_partition_bits = 0;
+    
+    /// @brief Потоки проверки shares: 0 - проверка в потоке приёма
+    /// соединения, N - пул из N потоков с пакетным хешированием
+    std::size_t validator_threads = 0;
+    
+    /// @brief Shares одного задания в фильтре дубликатов: 0 - по ожидаемой
+    /// частоте shares (vardiff), N - фиксированно
+    std::size_t duplicate_filter_shares = 0;
+    
+    /// @brief Tip одной высоты (гонка блоков), для которых TemplateCache
+    /// держит готовые задания: 0 - не держать
+    std::size_t competing_tips = 2;
+    
+    /// @brief Потоки пакетной пересборки заданий всех соединений на новом
+    /// блоке (JobManager::regenerate_all): 0 - по числу ядер, 1 - в
+    /// вызывающем потоке
+    std::size_t regenerate_threads = 0;
+    
+    /// @brief Extranonce, арендованных заранее с готовым кадром первого
+    /// задания: новое соединение получает задание без сборки (0 - выключено)
+    std::size_t prelease_pool = 0;
+    
+    /// @brief Потоки программного ASIC (VirtualAsic): 0 - выключен, N -
+    /// N псевдо-соединений перебирают nonce на CPU (regtest/signet)
+    std::size_t virtual_asic_threads = 0;
+    
+    /// @brief Сложность shares программного ASIC (0 - только блоки)
+    double virtual_asic_difficulty = 1.0;
+    
+    bool operator==(const MiningConfig&) const = default;
 };
 
 /**
@@ -134,6 +369,124 @@ struct ShmConfig {
     
     /// @brief Время sleep в микросекундах (фаза 3)
     uint32_t sleep_us = 200;
+    
+    /// @brief Гибридное ожидание: короткий spin, затем futex_wait до futex_wake издателя
+    bool futex_wait = false;
+    
+    /// @brief Итерации spin перед futex_wait
+    uint32_t futex_spin_iterations = 200;
+    
+    /// @brief Предел одного futex_wait в микросекундах
+    uint32_t futex_timeout_us = 100000;
+    
+    /// @brief Читать готовый шаблон (coinbase, commitments) из второго сегмента
+    bool template_enabled = false;
+    
+    /// @brief Путь к shared memory с полным шаблоном
+    std::string template_path = constants::DEFAULT_SHM_TEMPLATE_PATH;
+    
+    /// @brief Отправлять найденные блоки в узел через кольцо в shared memory
+    bool submit_enabled = false;
+    
+    /// @brief Путь к кольцу отправки блоков
+    std::string submit_path = constants::DEFAULT_SHM_SUBMIT_PATH;
+    
+    /// @brief Каталог hugetlbfs для сегментов (пусто - /dev/shm через shm_open)
+    std::string hugetlb_dir;
+    
+    /// @brief NUMA узел памяти сегментов (-1 - политика по умолчанию)
+    int32_t numa_node = -1;
+    
+    /// @brief CPU потоков подписчиков (-1 - без закрепления)
+    int32_t cpu_affinity = -1;
+    
+    bool operator==(const ShmConfig&) const = default;
+};
+
+/**
+ * @brief Уведомления узла о блоках через ZMQ (zmqpubrawblock)
+ */
+struct ZmqConfig {
+    /// @brief Подписаться на rawblock узла (источник наравне с SHM)
+    bool enabled = false;
+    
+    /// @brief Endpoint zmqpubrawblock узла
+    std::string endpoint = "tcp://127.0.0.1:28332";
+    
+    /// @brief Предел одного ожидания сообщения (мс): задержка остановки
+    uint32_t receive_timeout_ms = 100;
+    
+    /// @brief CPU потока подписчика (-1 - без закрепления)
+    int32_t cpu_affinity = -1;
+    
+    bool operator==(const ZmqConfig&) const = default;
+};
+
+/**
+ * @brief Общий исполнитель фоновых задач (core::Executor)
+ */
+struct ExecutorConfig {
+    /// @brief Потоков пула (0 - по числу ядер минус один)
+    std::size_t workers = 0;
+    
+    /// @brief Шаг колеса таймеров (мс): точность периодических задач
+    uint32_t timer_tick_ms = 10;
+    
+    /// @brief CPU полосы задержки: приход блока -> задания (-1 - без закрепления)
+    int32_t latency_cpu = -1;
+    
+    bool operator==(const ExecutorConfig&) const = default;
+};
+
+/**
+ * @brief План размещения потоков по CPU (core::apply_thread_plan)
+ *
+ * Наборы CPU - в формате sysfs ("2-3,6"); пустой набор - без закрепления.
+ */
+struct ThreadsConfig {
+    /// @brief CPU пути блока: подписчики SHM/ZMQ, relay, полоса задержки
+    std::string block_path_cpus;
+    
+    /// @brief CPU рассылки ASIC: reactor'ы и потоки соединений сервера, фид
+    std::string fanout_cpus;
+    
+    /// @brief CPU остального: основной поток, экран, RPC, пул исполнителя
+    std::string background_cpus;
+    
+    /// @brief Приоритет SCHED_FIFO пути блока (0 - обычное планирование)
+    int32_t block_path_priority = 0;
+    
+    /// @brief mlockall: память процесса не вытесняется
+    bool lock_memory = false;
+    
+    /// @brief Заранее тронутая глубина стека потоков пути блока и рассылки (КБ)
+    uint32_t prefault_stack_kb = 64;
+    
+    /// @brief Вывести действующую топологию при запуске
+    bool dump_topology = true;
+    
+    bool operator==(const ThreadsConfig&) const = default;
+};
+
+/**
+ * @brief Передача работающего процесса новому бинарнику (network::HandoffListener)
+ *
+ * Работающий процесс слушает unix сокет socket_path. Новый процесс при
+ * запуске подключается к нему и забирает listening сокеты, соединения
+ * ASIC (SCM_RIGHTS), аренды extranonce, задания и шаблон; прежний
+ * процесс завершается, ASIC не переподключаются.
+ */
+struct HandoffConfig {
+    /// @brief Принимать и запрашивать передачу
+    bool enabled = false;
+    
+    /// @brief Unix сокет передачи
+    std::string socket_path = "/run/quaxis/handoff.sock";
+    
+    /// @brief Сколько ждать каждого шага передачи (мс)
+    uint32_t timeout_ms = 5000;
+    
+    bool operator==(const HandoffConfig&) const = default;
 };
 
 /**
@@ -146,12 +499,24 @@ struct LoggingConfig {
     /// @brief Уровень логирования: "error", "warn", "info", "debug"
     std::string level = "info";
     
+    /// @brief Куда пишет асинхронный лог: "console", "file", "journald"
+    std::string output = "console";
+    
+    /// @brief Файл лога для output = "file" (дописывается)
+    std::string file;
+    
+    /// @brief Период вывода накопленных сообщений фоновым потоком (мс)
+    uint32_t flush_interval_ms = 5;
+    
     /// @brief Размер истории событий
     std::size_t event_history = 200;
     
     /// @brief Использовать цветной вывод
     bool color = true;
     
+    /// @brief Экран статуса: "auto" (только в терминал), "always", "never"
+    std::string display = "auto";
+    
     /// @brief Показывать хешрейт
     bool show_hashrate = true;
     
@@ -160,6 +525,129 @@ struct LoggingConfig {
     
     /// @brief Показывать счётчики блоков по chains
     bool show_chain_block_counts = true;
+    
+    /// @brief Трассировка латентности от блока до рассылки заданий
+    bool latency_trace = false;
+    
+    /// @brief Файл сырых событий трассировки (пусто - без дампа)
+    std::string latency_trace_dump;
+    
+    /// @brief Счётчики PMU вокруг SHA-NI, проверки shares и FEC (переключается SIGUSR2)
+    bool pmu_profile = false;
+    
+    bool operator==(const LoggingConfig&) const = default;
+};
+
+/**
+ * @brief Журнал принятых shares (mmap, только дописывание)
+ * 
+ * Записи фиксированного размера: соединение, задание, nonce, сложность,
+ * время. Потоки проверки пишут в свои куски файла без блокировок;
+ * msync и смену файлов делает фоновый поток.
+ */
+struct JournalConfig {
+    /// @brief Включить журнал
+    bool enabled = false;
+    
+    /// @brief Каталог файлов журнала (shares-NNNNNN.qsj)
+    std::string directory = "/var/lib/quaxis/journal";
+    
+    /// @brief Размер одного файла (МБ), затем следующий
+    uint32_t file_mb = 256;
+    
+    /// @brief Период msync (мс)
+    uint32_t sync_ms = 1000;
+    
+    /// @brief Сколько файлов хранить (0 - все)
+    uint32_t max_files = 0;
+    
+    bool operator==(const JournalConfig&) const = default;
+};
+
+/**
+ * @brief Spool найденных блоков до отправки
+ * 
+ * Блок пишется в кольцевой файл (O_DIRECT + fdatasync) параллельно с
+ * первой отправкой в сеть; неотправленные блоки повторяются при запуске.
+ */
+struct SpoolConfig {
+    /// @brief Включить spool
+    bool enabled = false;
+    
+    /// @brief Кольцевой файл
+    std::string path = "/var/lib/quaxis/block_spool.dat";
+    
+    /// @brief Блоков в кольце
+    uint32_t slots = 16;
+    
+    /// @brief Наибольший размер блока (МБ)
+    uint32_t max_block_mb = 4;
+    
+    bool operator==(const SpoolConfig&) const = default;
+};
+
+/**
+ * @brief Экспорт метрик Prometheus (HTTP GET /metrics)
+ */
+struct MetricsConfig {
+    /// @brief Включить HTTP endpoint
+    bool enabled = false;
+    
+    /// @brief Адрес прослушивания (по умолчанию только localhost)
+    std::string bind_address = "127.0.0.1";
+    
+    /// @brief Порт
+    uint16_t port = 9108;
+    
+    /// @brief Сегмент статистики в shared memory (пусто - выключен)
+    std::string shm_path;
+    
+    bool operator==(const MetricsConfig&) const = default;
+};
+
+/**
+ * @brief Иерархия площадок: шаблоны от вышестоящего quaxis
+ * 
+ * Прокси не держит своего узла: шаблоны (заголовок, coinbase с aux
+ * commitment) приходят по бинарному TCP фиду вышестоящего, extranonce
+ * соединений - из диапазона, делегированного площадке. Найденные блоки
+ * уходят вверх по дереву. Тот же узел может раздавать фид нижестоящим.
+ */
+struct ProxyConfig {
+    /// @brief Вышестоящий quaxis (пусто - корень дерева со своим узлом)
+    std::string upstream_host;
+    
+    /// @brief Порт фида вышестоящего
+    uint16_t upstream_port = 3340;
+    
+    /// @brief Номер площадки у вышестоящего (1-255, определяет диапазон extranonce)
+    uint32_t site = 1;
+    
+    /// @brief Пауза между попытками переподключения к вышестоящему (мс)
+    uint32_t reconnect_ms = 1000;
+    
+    /// @brief Порт фида для нижестоящих площадок (0 - не раздавать)
+    uint16_t feed_port = 0;
+    
+    /// @brief Адрес прослушивания фида
+    std::string feed_bind_address = "0.0.0.0";
+    
+    bool operator==(const ProxyConfig&) const = default;
+};
+
+/**
+ * @brief Несколько серверов на одном шаблоне (резерв, масштабирование)
+ * 
+ * Узлы с одной выплатой строят одинаковую coinbase: с одинаковыми
+ * extranonce их ASIC перебирали бы одни хеши. Номер узла статически
+ * делит пространство extranonce, как proxy.site у площадок: на горячем
+ * пути узлы ни о чём не договариваются.
+ */
+struct ClusterConfig {
+    /// @brief Номер узла (1-255, уникален в кластере; 0 - узел один)
+    uint32_t node = 0;
+    
+    bool operator==(const ClusterConfig&) const = default;
 };
 
 /**
@@ -174,6 +662,8 @@ struct RelayPeerConfig {
     
     /// @brief Доверенный пир
     bool trusted{false};
+    
+    bool operator==(const RelayPeerConfig&) const = default;
 };
 
 /**
@@ -195,14 +685,99 @@ struct RelayConfig {
     /// @brief Таймаут реконструкции блока (мс)
     uint32_t reconstruction_timeout{5000};
     
-    /// @brief Включить FEC (Forward Error Correction)
+    /// @brief Блоков в реконструкции одновременно (пул, самый старый вытесняется)
+    uint32_t max_inflight_blocks{8};
+    
+    /// @brief Включить FEC (Forward Error Correction) при рассылке своих блоков
     bool fec_enabled{true};
     
-    /// @brief Избыточность FEC (0.5 = 50%)
+    /// @brief Избыточность FEC рассылки (0.5 = 50%, 0..1)
     double fec_overhead{0.5};
     
+    /// @brief Рассылка: пакетов одному пиру за sendmmsg до перехода к следующему
+    uint32_t broadcast_burst{32};
+    
+    /// @brief Рассылка: темп на пира (Mbps, 0 - без ограничения)
+    uint32_t broadcast_rate_mbps{0};
+    
+    /// @brief Схема FEC: "reed_solomon" (код Коши) или "xor"
+    std::string fec_scheme = "reed_solomon";
+    
+    /// @brief Датаграмм на один recvmmsg
+    uint32_t recv_batch{64};
+    
+    /// @brief UDP_GRO: ядро склеивает chunk'и одного пира (Linux 5.0+)
+    bool udp_gro{false};
+    
+    /// @brief SO_BUSY_POLL для сокетов пиров (мкс, 0 - выключен)
+    uint32_t busy_poll_us{0};
+    
+    /// @brief Начальный SO_RCVBUF сокетов пиров (байт, 0 - по умолчанию ядра)
+    uint32_t recv_buffer_size{0};
+    
+    /// @brief Удваивать SO_RCVBUF пира (до net.core.rmem_max) при потерях в ядре
+    bool recv_buffer_autotune{true};
+    
+    /// @brief AF_XDP: интерфейс приёма FIBRE в обход стека (пусто - выключен)
+    std::string xdp_interface;
+    
+    /// @brief AF_XDP: очередь NIC, куда RSS направляет трафик пиров
+    uint32_t xdp_queue{0};
+    
+    /// @brief Поток relay крутит epoll_wait без сна (занимает ядро целиком)
+    bool worker_busy_poll{false};
+    
+    /// @brief CPU для потока relay (-1 - без привязки)
+    int32_t worker_cpu_affinity = -1;
+    
+    /// @brief Потоков приёма relay: пиры делятся между ними (1 - один поток)
+    uint32_t receive_threads{1};
+    
+    /// @brief CPU потоков приёма по порядку ("2-3,6"; пусто - worker_cpu_affinity у первого)
+    std::string receive_cpus;
+    
+    /// @brief Пир - на поток CPU, где ядро принимает его трафик (SO_INCOMING_CPU)
+    bool receive_steer_cpu{true};
+    
+    /// @brief Чанков в очереди передачи потоку-владельцу блока (на поток)
+    uint32_t handoff_queue_size{1024};
+    
+    /// @brief FEC декодирование в отдельном потоке (приём не ждёт decode)
+    bool decode_thread{false};
+    
+    /// @brief CPU потока декодирования (-1 - без привязки)
+    int32_t decode_cpu = -1;
+    
+    /// @brief Потоки проверки merkle root собранного блока: 0 - по числу
+    /// ядер, 1 - в потоке, собравшем блок
+    uint32_t verify_threads{0};
+    
+    /// @brief Синтез data чанков из mempool узла по наброску блока (short id);
+    /// broadcast_block шлёт набросок перед чанками
+    bool mempool_prefill{false};
+    
+    /// @brief Транзакций в кеше mempool (ZMQ rawtx)
+    uint32_t tx_cache_size{50000};
+    
+    /// @brief Spy mining по header из первых чанков (PoW проверен, тело ещё нет)
+    bool header_first{true};
+    
+    /// @brief Ранг пиров по доставке блоков: порядок опроса, темп keepalive
+    bool adaptive_peers{true};
+    
+    /// @brief Отставание первого чанка (EWMA, мс), с которого пир медленный
+    uint32_t slow_peer_lag_ms{200};
+    
+    /// @brief Блоков в ранге пира до решения о нём
+    uint32_t slow_peer_min_blocks{20};
+    
+    /// @brief Отключать медленных не trusted пиров (возвращаются через 10 минут)
+    bool slow_peer_drop{true};
+    
     /// @brief Список FIBRE пиров
     std::vector<RelayPeerConfig> peers;
+    
+    bool operator==(const RelayConfig&) const = default;
 };
 
 // =============================================================================
@@ -246,6 +821,22 @@ struct MergedChainConfig {
     
     /// @brief Интервал обновления шаблона (секунды)
     uint32_t update_interval{5};
+    
+    /// @brief Крайний срок ответа createauxblock при опросе (мс)
+    uint32_t template_deadline_ms{2000};
+    
+    /// @brief Ошибок опроса подряд до размыкания: chain не опрашивается и
+    /// выходит из aux дерева (0 - не размыкать)
+    uint32_t breaker_failures{3};
+    
+    /// @brief Пауза до пробного опроса разомкнутой chain (секунды)
+    uint32_t breaker_open_seconds{30};
+    
+    /// @brief Обновлять шаблон по уведомлению ноды (getblocktemplate
+    /// longpoll) вместо периодического опроса
+    bool longpoll{false};
+    
+    bool operator==(const MergedChainConfig&) const = default;
 };
 
 /**
@@ -260,6 +851,15 @@ struct MergedMiningConfig {
     
     /// @brief Интервал проверки состояния chains (секунды)
     uint32_t health_check_interval{60};
+    
+    /// @brief Файл кеша последних aux шаблонов для быстрого старта
+    /// (пусто - без кеша)
+    std::string template_cache_path;
+    
+    /// @brief Шаблоны кеша старше - не используются (секунды)
+    uint32_t template_cache_max_age{600};
+    
+    bool operator==(const MergedMiningConfig&) const = default;
 };
 
 /**
@@ -270,7 +870,16 @@ struct Config {
     ParentChainConfig parent_chain;
     MiningConfig mining;
     ShmConfig shm;
+    ZmqConfig zmq;
+    ExecutorConfig executor;
+    ThreadsConfig threads;
+    HandoffConfig handoff;
     LoggingConfig logging;
+    JournalConfig journal;
+    SpoolConfig spool;
+    MetricsConfig metrics;
+    ProxyConfig proxy;
+    ClusterConfig cluster;
     RelayConfig relay;
     MergedMiningConfig merged_mining;
     
@@ -309,6 +918,17 @@ struct Config {
      * @return Result<void> Успех или ошибка валидации
      */
     [[nodiscard]] Result<void> validate() const;
+    
+    /**
+     * @brief Размер фильтра дубликатов (shares на задание)
+     * 
+     * mining.duplicate_filter_shares, если задан. Иначе при vardiff -
+     * shares одного ASIC за DUPLICATE_FILTER_JOB_MINUTES (задание
+     * принадлежит одному соединению), без vardiff - значение по умолчанию.
+     */
+    [[nodiscard]] std::size_t duplicate_filter_shares() const noexcept;
+    
+    bool operator==(const Config&) const = default;
 };
 
 } // namespace quaxis
@@ -0,0 +1,115 @@
+/**
+ * @file config_reload.cpp
+ * @brief Сравнение конфигураций для перезагрузки
+ */
+
+#include "config_reload.hpp"
+
+#include <algorithm>
+
+namespace quaxis {
+
+namespace {
+
+bool contains_peer(const std::vector<RelayPeerConfig>& peers, const RelayPeerConfig& peer) {
+    return std::find(peers.begin(), peers.end(), peer) != peers.end();
+}
+
+MergedChainConfig* find_chain(std::vector<MergedChainConfig>& chains, const std::string& name) {
+    auto it = std::find_if(chains.begin(), chains.end(),
+                           [&name](const MergedChainConfig& chain) { return chain.name == name; });
+    return it != chains.end() ? &*it : nullptr;
+}
+
+/**
+ * @brief Секции, которые различаются и после переноса применимых изменений
+ */
+template<typename Section>
+void compare_section(const char* name, const Section& current, const Section& next,
+                     std::vector<std::string>& restart_required) {
+    if (!(current == next)) {
+        restart_required.emplace_back(name);
+    }
+}
+
+} // anonymous namespace
+
+ConfigChanges diff_config(const Config& current, const Config& next) {
+    ConfigChanges changes;
+
+    if (next.mining.share_difficulty != current.mining.share_difficulty) {
+        changes.share_difficulty = next.mining.share_difficulty;
+    }
+    if (!(next.server.vardiff == current.server.vardiff)) {
+        changes.vardiff = next.server.vardiff;
+    }
+
+    for (const auto& peer : current.relay.peers) {
+        if (!contains_peer(next.relay.peers, peer)) {
+            changes.relay_peers_removed.push_back(peer);
+        }
+    }
+    for (const auto& peer : next.relay.peers) {
+        if (!contains_peer(current.relay.peers, peer)) {
+            changes.relay_peers_added.push_back(peer);
+        }
+    }
+
+    // Остаток новой конфигурации без применимых изменений: всё, что в нём
+    // отличается, требует перезапуска
+    Config residual = next;
+    residual.mining.share_difficulty = current.mining.share_difficulty;
+    residual.server.vardiff = current.server.vardiff;
+    residual.relay.peers = current.relay.peers;
+    for (const auto& chain : current.merged_mining.chains) {
+        if (auto* updated = find_chain(residual.merged_mining.chains, chain.name)) {
+            if (updated->enabled != chain.enabled) {
+                changes.chains_toggled.emplace_back(chain.name, updated->enabled);
+                updated->enabled = chain.enabled;
+            }
+        }
+    }
+
+    auto& restart = changes.restart_required;
+    compare_section("server", current.server, residual.server, restart);
+    compare_section("parent_chain", current.parent_chain, residual.parent_chain, restart);
+    compare_section("mining", current.mining, residual.mining, restart);
+    compare_section("shm", current.shm, residual.shm, restart);
+    compare_section("zmq", current.zmq, residual.zmq, restart);
+    compare_section("executor", current.executor, residual.executor, restart);
+    compare_section("threads", current.threads, residual.threads, restart);
+    compare_section("handoff", current.handoff, residual.handoff, restart);
+    compare_section("logging", current.logging, residual.logging, restart);
+    compare_section("journal", current.journal, residual.journal, restart);
+    compare_section("spool", current.spool, residual.spool, restart);
+    compare_section("metrics", current.metrics, residual.metrics, restart);
+    compare_section("proxy", current.proxy, residual.proxy, restart);
+    compare_section("cluster", current.cluster, residual.cluster, restart);
+    compare_section("relay", current.relay, residual.relay, restart);
+    compare_section("merged_mining", current.merged_mining, residual.merged_mining, restart);
+
+    return changes;
+}
+
+void ConfigChanges::apply_to(Config& config) const {
+    if (share_difficulty) {
+        config.mining.share_difficulty = *share_difficulty;
+    }
+    if (vardiff) {
+        config.server.vardiff = *vardiff;
+    }
+
+    auto& peers = config.relay.peers;
+    std::erase_if(peers, [this](const RelayPeerConfig& peer) {
+        return contains_peer(relay_peers_removed, peer);
+    });
+    peers.insert(peers.end(), relay_peers_added.begin(), relay_peers_added.end());
+
+    for (const auto& [name, enabled] : chains_toggled) {
+        if (auto* chain = find_chain(config.merged_mining.chains, name)) {
+            chain->enabled = enabled;
+        }
+    }
+}
+
+} // namespace quaxis
@@ -0,0 +1,76 @@
+/**
+ * @file config_reload.hpp
+ * @brief Разница конфигураций для перезагрузки без перезапуска (SIGHUP)
+ *
+ * Смена сложности shares, vardiff, списка пиров relay или набора merged
+ * chains требовала перезапуска процесса, а перезапуск - переподключения
+ * всего парка ASIC. По SIGHUP процесс читает файл заново, diff_config()
+ * сравнивает его с действующей конфигурацией, и каждая подсистема
+ * получает только свои изменения через собственные методы
+ * (ShareValidator::set_partial_difficulty, Server::set_vardiff,
+ * RelayManager::add_peer / remove_peer, ChainManager::set_chain_enabled).
+ * Ничего не пересоздаётся.
+ *
+ * Остальные параметры (порты, размеры таблиц, потоки) задают устройство
+ * подсистем при запуске: их изменения перечисляются в restart_required
+ * и не применяются.
+ */
+
+#pragma once
+
+#include "config.hpp"
+
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace quaxis {
+
+/**
+ * @brief Изменения, применимые без перезапуска
+ */
+struct ConfigChanges {
+    /// @brief Новая mining.share_difficulty
+    std::optional<double> share_difficulty;
+
+    /// @brief Новые server.vardiff
+    std::optional<VardiffConfig> vardiff;
+
+    /// @brief Пиры relay, которых не было (или с другими параметрами)
+    std::vector<RelayPeerConfig> relay_peers_added;
+
+    /// @brief Пиры relay, которых больше нет (до добавления новых)
+    std::vector<RelayPeerConfig> relay_peers_removed;
+
+    /// @brief Merged chains, у которых изменился enabled: имя и новое значение
+    std::vector<std::pair<std::string, bool>> chains_toggled;
+
+    /// @brief Изменённые параметры, которые применяются только перезапуском
+    std::vector<std::string> restart_required;
+
+    /**
+     * @brief Применимых изменений нет
+     */
+    [[nodiscard]] bool empty() const noexcept {
+        return !share_difficulty && !vardiff && relay_peers_added.empty() &&
+               relay_peers_removed.empty() && chains_toggled.empty();
+    }
+
+    /**
+     * @brief Перенести применимые изменения в действующую конфигурацию
+     *
+     * После этого следующий diff_config() считается от неё.
+     */
+    void apply_to(Config& config) const;
+};
+
+/**
+ * @brief Сравнить действующую конфигурацию с новой
+ *
+ * @param current Действующая конфигурация
+ * @param next Прочитанная и проверенная (validate) новая
+ */
+[[nodiscard]] ConfigChanges diff_config(const Config& current, const Config& next);
+
+} // namespace quaxis
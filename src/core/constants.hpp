@@ -57,6 +57,42 @@ inline constexpr std::size_t EXTRANONCE_SIZE = 6;
 /// @brief Максимальное значение extranonce (2^48 - 1)
 inline constexpr uint64_t EXTRANONCE_MAX = (1ULL << 48) - 1;
 
+/// @brief Хвост coinbase после первых 64 байт (extranonce + выходы + locktime)
+inline constexpr std::size_t COINBASE_TAIL_SIZE = COINBASE_SIZE - SHA256_BLOCK_SIZE;
+
+/// @brief Максимальная аренда extranonce одному ASIC (2^24 × 2^32 nonce)
+inline constexpr uint32_t MAX_EXTRANONCE_LEASE = 1u << 24;
+
+/// @brief Максимум заданий в очереди ASIC сверх текущего (CMD_QUEUE_JOB)
+inline constexpr std::size_t MAX_JOB_PREFETCH = 16;
+
+/// @brief Максимальное число потоков проверки shares
+inline constexpr std::size_t MAX_VALIDATOR_THREADS = 64;
+
+/// @brief Максимальное число потоков программного ASIC
+inline constexpr std::size_t MAX_VIRTUAL_ASIC_THREADS = 256;
+
+/// @brief Максимальное число потоков пересборки заданий на новом блоке
+inline constexpr std::size_t MAX_REGENERATE_THREADS = 64;
+
+/// @brief Максимальный пул заранее арендованных extranonce
+inline constexpr std::size_t MAX_PRELEASE_POOL = 4096;
+
+/// @brief Максимум конкурирующих tip с готовыми заданиями в TemplateCache
+inline constexpr std::size_t MAX_COMPETING_TIPS = 8;
+
+/// @brief Shares одного задания в фильтре дубликатов (без vardiff)
+inline constexpr std::size_t DEFAULT_DUPLICATE_FILTER_SHARES = 4096;
+
+/// @brief Максимум shares одного задания в фильтре дубликатов
+inline constexpr std::size_t MAX_DUPLICATE_FILTER_SHARES = 1u << 20;
+
+/// @brief Минимум shares одного задания в фильтре дубликатов (vardiff)
+inline constexpr std::size_t MIN_DUPLICATE_FILTER_SHARES = 256;
+
+/// @brief Ожидаемое время жизни задания для размера фильтра (минуты, ~6 блоков)
+inline constexpr double DUPLICATE_FILTER_JOB_MINUTES = 60.0;
+
 /// @brief Размер job_id в байтах
 inline constexpr std::size_t JOB_ID_SIZE = 4;
 
@@ -72,6 +108,12 @@ static_assert(JOB_MESSAGE_SIZE == 48, "Размер задания должен
 inline constexpr std::size_t SHARE_MESSAGE_SIZE = JOB_ID_SIZE + 4;
 static_assert(SHARE_MESSAGE_SIZE == 8, "Размер ответа должен быть 8 байт");
 
+/// @brief Максимум версий (midstate) в одном задании с version rolling
+inline constexpr std::size_t MAX_VERSION_SLOTS = 4;
+
+/// @brief Максимум бит маски BIP320, закрепляемых за соединением
+inline constexpr std::size_t MAX_VERSION_PARTITION_BITS = 8;
+
 // =============================================================================
 // Константы Bitcoin
 // =============================================================================
@@ -104,6 +146,10 @@ inline constexpr std::size_t MAX_BLOCK_SIZE = 1'000'000;
 /// @brief Максимальный вес блока
 inline constexpr std::size_t MAX_BLOCK_WEIGHT = 4'000'000;
 
+/// @brief Насколько timestamp блока может опережать время узла
+/// (MAX_FUTURE_BLOCK_TIME в Bitcoin Core, 2 часа)
+inline constexpr uint32_t MAX_FUTURE_BLOCK_TIME = 2 * 60 * 60;
+
 // =============================================================================
 // Константы Shared Memory
 // =============================================================================
@@ -111,6 +157,12 @@ inline constexpr std::size_t MAX_BLOCK_WEIGHT = 4'000'000;
 /// @brief Путь к shared memory по умолчанию
 inline constexpr const char* DEFAULT_SHM_PATH = "/quaxis_block";
 
+/// @brief Путь к shared memory с полным шаблоном по умолчанию
+inline constexpr const char* DEFAULT_SHM_TEMPLATE_PATH = "/quaxis_template";
+
+/// @brief Путь к кольцу отправки блоков в узел по умолчанию
+inline constexpr const char* DEFAULT_SHM_SUBMIT_PATH = "/quaxis_submit";
+
 /// @brief Размер shared memory структуры (с выравниванием)
 inline constexpr std::size_t SHM_BLOCK_SIZE = 256;
 
@@ -124,6 +176,15 @@ inline constexpr uint16_t DEFAULT_SERVER_PORT = 3333;
 /// @brief Максимальное количество подключений
 inline constexpr std::size_t DEFAULT_MAX_CONNECTIONS = 10;
 
+/// @brief Наибольшее число listening сокетов сервера ASIC (SO_REUSEPORT)
+inline constexpr std::size_t MAX_SERVER_LISTENERS = 64;
+
+/// @brief Наибольший listen backlog (ядро всё равно урежет до somaxconn)
+inline constexpr uint32_t MAX_LISTEN_BACKLOG = 65535;
+
+/// @brief Наибольший grace период сессии ASIC после обрыва (секунды)
+inline constexpr uint32_t MAX_SESSION_GRACE_SECONDS = 3600;
+
 /// @brief Размер очереди заданий по умолчанию
 inline constexpr std::size_t DEFAULT_JOB_QUEUE_SIZE = 100;
 
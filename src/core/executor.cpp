@@ -0,0 +1,506 @@
+/**
+ * @file executor.cpp
+ * @brief Реализация общего исполнителя
+ *
+ * Очередь потока пула - deque под своим mutex: владелец берёт с конца
+ * (последняя поставленная задача ещё в кеше), перехватчик - с начала.
+ * Колесо таймеров - WHEEL_SLOTS слотов по timer_tick_ms; таймер дальше
+ * одного оборота лежит в своём слоте до нужного тика. Каждый тик поток
+ * таймеров обновляет CoarseClock.
+ */
+
+#include "executor.hpp"
+#include "clock.hpp"
+#include "thread_plan.hpp"
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <format>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace quaxis::core {
+
+namespace {
+
+/// @brief Слотов колеса таймеров
+constexpr std::size_t WHEEL_SLOTS = 512;
+
+/// @brief Исполнитель и номер потока пула текущего потока
+thread_local const void* t_executor = nullptr;
+thread_local std::size_t t_worker = 0;
+
+/// @brief Таймер, задача которого выполняется в текущем потоке
+thread_local Executor::TimerId t_running_timer = 0;
+
+/// @brief Текущий поток - полоса задержки исполнителя
+thread_local const void* t_latency_lane = nullptr;
+
+} // anonymous namespace
+
+// =============================================================================
+// Реализация (PIMPL)
+// =============================================================================
+
+struct Executor::Impl {
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Поток пула со своей очередью
+     */
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+        std::thread thread;
+    };
+
+    /**
+     * @brief Запись таймера в слоте колеса
+     */
+    struct TimerEntry {
+        TimerId id;
+        uint64_t deadline_tick;
+    };
+
+    /**
+     * @brief Состояние таймера (под timer_mutex)
+     */
+    struct TimerState {
+        std::shared_ptr<Task> task;
+        uint64_t period_ticks;  // 0 - однократный
+        bool running = false;   // Поставлен в пул
+        bool started = false;   // Задача уже выполняется
+        bool cancelled = false;
+    };
+
+    ExecutorConfig config;
+    const std::chrono::milliseconds tick;
+
+    // Пул
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::mutex idle_mutex;
+    std::condition_variable idle_cv;
+    std::atomic<std::size_t> pending{0};
+    std::atomic<std::size_t> next_queue{0};
+    std::atomic<uint64_t> executed{0};
+    std::atomic<uint64_t> stolen{0};
+
+    // Полоса задержки
+    std::thread lane_thread;
+    std::mutex lane_mutex;
+    std::condition_variable lane_cv;
+    std::deque<Task> lane_tasks;
+
+    // Колесо таймеров
+    std::thread timer_thread;
+    std::mutex timer_mutex;
+    std::condition_variable timer_cv;
+    std::condition_variable timer_done_cv;
+    std::array<std::vector<TimerEntry>, WHEEL_SLOTS> wheel;
+    std::unordered_map<TimerId, TimerState> timers;
+    TimerId next_timer_id = 1;
+    Clock::time_point wheel_start = Clock::now();
+    uint64_t processed_tick = 0;
+
+    std::atomic<bool> running{false};
+    std::atomic<bool> stopping{false};
+
+    explicit Impl(const ExecutorConfig& cfg)
+        : config(cfg)
+        , tick(std::max<uint32_t>(cfg.timer_tick_ms, 1))
+    {
+        std::size_t count = config.workers;
+        if (count == 0) {
+            const std::size_t cores = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+            count = cores > 1 ? cores - 1 : 1;
+        }
+        workers.reserve(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            workers.push_back(std::make_unique<Worker>());
+        }
+    }
+
+    // =========================================================================
+    // Пул
+    // =========================================================================
+
+    void push(Task task) {
+        const std::size_t index = t_executor == this
+            ? t_worker
+            : next_queue.fetch_add(1, std::memory_order_relaxed) % workers.size();
+        {
+            std::lock_guard<std::mutex> lock(workers[index]->mutex);
+            workers[index]->tasks.push_back(std::move(task));
+        }
+        pending.fetch_add(1, std::memory_order_release);
+        {
+            // Пустая секция: поток между проверкой pending и wait не пропустит notify
+            std::lock_guard<std::mutex> lock(idle_mutex);
+        }
+        idle_cv.notify_one();
+    }
+
+    bool pop_local(std::size_t index, Task& task) {
+        auto& worker = *workers[index];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        if (worker.tasks.empty()) {
+            return false;
+        }
+        task = std::move(worker.tasks.back());
+        worker.tasks.pop_back();
+        return true;
+    }
+
+    bool steal(std::size_t thief, Task& task) {
+        for (std::size_t offset = 1; offset < workers.size(); ++offset) {
+            auto& victim = *workers[(thief + offset) % workers.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty()) {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                stolen.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void worker_loop(std::size_t index) {
+        t_executor = this;
+        t_worker = index;
+
+        while (true) {
+            Task task;
+            if (pop_local(index, task) || steal(index, task)) {
+                pending.fetch_sub(1, std::memory_order_acq_rel);
+                task();
+                executed.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(idle_mutex);
+            idle_cv.wait(lock, [this] {
+                return pending.load(std::memory_order_acquire) != 0 ||
+                       stopping.load(std::memory_order_relaxed);
+            });
+            if (stopping.load(std::memory_order_relaxed) &&
+                pending.load(std::memory_order_acquire) == 0) {
+                return;
+            }
+        }
+    }
+
+    // =========================================================================
+    // Полоса задержки
+    // =========================================================================
+
+    void lane_loop() {
+        t_latency_lane = this;
+
+        std::unique_lock<std::mutex> lock(lane_mutex);
+        while (true) {
+            lane_cv.wait(lock, [this] {
+                return !lane_tasks.empty() || stopping.load(std::memory_order_relaxed);
+            });
+            if (lane_tasks.empty()) {
+                return;  // Остановка, очередь пуста
+            }
+            Task task = std::move(lane_tasks.front());
+            lane_tasks.pop_front();
+            lock.unlock();
+            task();
+            lock.lock();
+        }
+    }
+
+    // =========================================================================
+    // Колесо таймеров
+    // =========================================================================
+
+    [[nodiscard]] uint64_t tick_at(Clock::time_point time) const noexcept {
+        return static_cast<uint64_t>((time - wheel_start) / tick);
+    }
+
+    [[nodiscard]] uint64_t ticks_for(std::chrono::milliseconds delay) const noexcept {
+        const auto ticks = (delay + tick - std::chrono::milliseconds(1)) / tick;
+        return std::max<uint64_t>(static_cast<uint64_t>(std::max<int64_t>(ticks, 0)), 1);
+    }
+
+    /**
+     * @brief Положить таймер в колесо (под timer_mutex)
+     *
+     * Текущий тик уже начат: +1, чтобы таймер не сработал раньше задержки.
+     */
+    void arm(TimerId id, uint64_t ticks) {
+        const uint64_t deadline = std::max(processed_tick + 1, tick_at(Clock::now()) + ticks + 1);
+        wheel[deadline % WHEEL_SLOTS].push_back({id, deadline});
+    }
+
+    TimerId add_timer(std::chrono::milliseconds delay, std::chrono::milliseconds period, Task task) {
+        std::lock_guard<std::mutex> lock(timer_mutex);
+        const TimerId id = next_timer_id++;
+        const uint64_t period_ticks = period.count() > 0 ? ticks_for(period) : 0;
+        timers.emplace(id, TimerState{std::make_shared<Task>(std::move(task)), period_ticks});
+        arm(id, ticks_for(delay));
+        return id;
+    }
+
+    /**
+     * @brief Запустить сработавший таймер в пуле (под timer_mutex)
+     */
+    void fire(TimerId id) {
+        auto it = timers.find(id);
+        if (it == timers.end() || it->second.cancelled) {
+            return;  // Снят
+        }
+        it->second.running = true;
+        push([this, id, task = it->second.task] {
+            {
+                // Снят, пока ждал в очереди пула: задача не запускается
+                std::lock_guard<std::mutex> lock(timer_mutex);
+                auto state = timers.find(id);
+                if (state == timers.end() || state->second.cancelled) {
+                    if (state != timers.end()) {
+                        timers.erase(state);
+                    }
+                    timer_done_cv.notify_all();
+                    return;
+                }
+                state->second.started = true;
+            }
+
+            t_running_timer = id;
+            (*task)();
+            t_running_timer = 0;
+
+            std::lock_guard<std::mutex> lock(timer_mutex);
+            auto state = timers.find(id);
+            if (state != timers.end()) {
+                state->second.running = false;
+                state->second.started = false;
+                if (state->second.cancelled || state->second.period_ticks == 0 ||
+                    stopping.load(std::memory_order_relaxed)) {
+                    timers.erase(state);
+                } else {
+                    arm(id, state->second.period_ticks);
+                }
+            }
+            timer_done_cv.notify_all();
+        });
+    }
+
+    void timer_loop() {
+        std::unique_lock<std::mutex> lock(timer_mutex);
+        while (!stopping.load(std::memory_order_relaxed)) {
+            const auto next = wheel_start + tick * static_cast<int64_t>(processed_tick + 1);
+            timer_cv.wait_until(lock, next, [this] {
+                return stopping.load(std::memory_order_relaxed);
+            });
+            if (stopping.load(std::memory_order_relaxed)) {
+                break;
+            }
+            
+            const auto now = Clock::now();
+            CoarseClock::update(now);
+            const uint64_t now_tick = tick_at(now);
+            while (processed_tick < now_tick) {
+                ++processed_tick;
+                auto& slot = wheel[processed_tick % WHEEL_SLOTS];
+                // Сработавшие убираем из слота, дальние остаются
+                std::vector<TimerId> due;
+                std::erase_if(slot, [&](const TimerEntry& entry) {
+                    if (entry.deadline_tick > processed_tick) {
+                        return false;
+                    }
+                    due.push_back(entry.id);
+                    return true;
+                });
+                for (TimerId id : due) {
+                    fire(id);
+                }
+            }
+        }
+    }
+
+    void cancel(TimerId id) {
+        std::unique_lock<std::mutex> lock(timer_mutex);
+        auto it = timers.find(id);
+        if (it == timers.end()) {
+            return;
+        }
+        if (!it->second.running) {
+            timers.erase(it);  // Запись в колесе отбросит fire()
+            return;
+        }
+        it->second.cancelled = true;
+        if (!it->second.started || t_running_timer == id) {
+            // Ещё в очереди пула или снят из своей задачи: запись удалит задача
+            return;
+        }
+        timer_done_cv.wait(lock, [this, id] { return timers.find(id) == timers.end(); });
+    }
+
+    // =========================================================================
+    // Запуск и остановка
+    // =========================================================================
+
+    Result<void> start() {
+        if (running.exchange(true)) {
+            return {};
+        }
+        stopping.store(false, std::memory_order_relaxed);
+        {
+            std::lock_guard<std::mutex> lock(timer_mutex);
+            wheel_start = Clock::now();
+            processed_tick = 0;
+        }
+
+        for (std::size_t i = 0; i < workers.size(); ++i) {
+            workers[i]->thread = std::thread([this, i] {
+                enter_thread_role(ThreadRole::Background);
+                worker_loop(i);
+            });
+        }
+        lane_thread = std::thread([this] {
+            enter_thread_role(ThreadRole::BlockPath, config.latency_cpu >= 0);
+            lane_loop();
+        });
+        timer_thread = std::thread([this] {
+            enter_thread_role(ThreadRole::Background);
+            CoarseClock::attach();
+            timer_loop();
+            CoarseClock::detach();
+        });
+
+        if (config.latency_cpu >= 0) {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(static_cast<std::size_t>(config.latency_cpu), &set);
+            const int rc = pthread_setaffinity_np(lane_thread.native_handle(), sizeof(set), &set);
+            if (rc != 0) {
+                stop();
+                return Err<void>(ErrorCode::ConfigInvalidValue,
+                                 std::format("executor.latency_cpu {}: {}", config.latency_cpu, std::strerror(rc)));
+            }
+        }
+        return {};
+    }
+
+    void stop() {
+        if (!running.exchange(false)) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(timer_mutex);
+            stopping.store(true, std::memory_order_relaxed);
+        }
+        timer_cv.notify_all();
+        if (timer_thread.joinable()) {
+            timer_thread.join();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(lane_mutex);
+        }
+        lane_cv.notify_all();
+        if (lane_thread.joinable()) {
+            lane_thread.join();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(idle_mutex);
+        }
+        idle_cv.notify_all();
+        for (auto& worker : workers) {
+            if (worker->thread.joinable()) {
+                worker->thread.join();
+            }
+        }
+
+        // Таймеры не переживают остановку
+        std::lock_guard<std::mutex> lock(timer_mutex);
+        timers.clear();
+        for (auto& slot : wheel) {
+            slot.clear();
+        }
+        timer_done_cv.notify_all();
+    }
+};
+
+// =============================================================================
+// Публичный интерфейс
+// =============================================================================
+
+Executor::Executor(const ExecutorConfig& config)
+    : impl_(std::make_unique<Impl>(config))
+{
+}
+
+Executor::~Executor() {
+    stop();
+}
+
+Result<void> Executor::start() {
+    return impl_->start();
+}
+
+void Executor::stop() {
+    impl_->stop();
+}
+
+void Executor::post(Task task) {
+    if (impl_->stopping.load(std::memory_order_relaxed)) {
+        return;
+    }
+    impl_->push(std::move(task));
+}
+
+void Executor::post_latency(Task task) {
+    {
+        std::lock_guard<std::mutex> lock(impl_->lane_mutex);
+        if (impl_->stopping.load(std::memory_order_relaxed)) {
+            return;
+        }
+        impl_->lane_tasks.push_back(std::move(task));
+    }
+    impl_->lane_cv.notify_one();
+}
+
+Executor::TimerId Executor::schedule_after(std::chrono::milliseconds delay, Task task) {
+    return impl_->add_timer(delay, std::chrono::milliseconds(0), std::move(task));
+}
+
+Executor::TimerId Executor::schedule_every(std::chrono::milliseconds period, Task task) {
+    return impl_->add_timer(period, period, std::move(task));
+}
+
+void Executor::cancel(TimerId id) {
+    impl_->cancel(id);
+}
+
+std::size_t Executor::worker_count() const noexcept {
+    return impl_->workers.size();
+}
+
+uint64_t Executor::tasks_executed() const noexcept {
+    return impl_->executed.load(std::memory_order_relaxed);
+}
+
+uint64_t Executor::tasks_stolen() const noexcept {
+    return impl_->stolen.load(std::memory_order_relaxed);
+}
+
+bool Executor::in_latency_lane() const noexcept {
+    return t_latency_lane == impl_.get();
+}
+
+} // namespace quaxis::core
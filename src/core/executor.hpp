@@ -0,0 +1,136 @@
+/**
+ * @file executor.hpp
+ * @brief Общий исполнитель: пул с перехватом задач, таймеры, полоса задержки
+ *
+ * Подсистемы заводили по потоку на каждую периодическую работу (очистка
+ * соединений сервера, экран статуса), и большую часть времени эти потоки
+ * спали в sleep_for. Executor держит потоки по числу ядер:
+ * - пул: у каждого потока своя очередь, свободный поток перехватывает
+ *   задачи из чужих (work stealing);
+ * - колесо таймеров: периодические и отложенные задачи без своих потоков;
+ * - полоса задержки: один поток (можно закрепить за CPU) для работы
+ *   "приход блока -> задания", не делящий очередь с фоновой.
+ *
+ * Сетевой ввод-вывод ASIC остаётся в network::EpollReactor
+ * (server.engine = "epoll"): потоков по числу reactor'ов, не соединений.
+ */
+
+#pragma once
+
+#include "types.hpp"
+#include "config.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+namespace quaxis::core {
+
+/**
+ * @brief Пул потоков с колесом таймеров и полосой задержки
+ *
+ * Задачи не должны блокироваться надолго: блокирующий приём (recv, SHM
+ * futex) остаётся в собственных потоках подсистем.
+ */
+class Executor {
+public:
+    using Task = std::function<void()>;
+
+    /// @brief Идентификатор таймера (0 - нет таймера)
+    using TimerId = uint64_t;
+
+    /**
+     * @param config Конфигурация исполнителя
+     */
+    explicit Executor(const ExecutorConfig& config);
+
+    /**
+     * @brief Деструктор - останавливает исполнитель
+     */
+    ~Executor();
+
+    Executor(const Executor&) = delete;
+    Executor& operator=(const Executor&) = delete;
+
+    /**
+     * @brief Запустить потоки пула, колеса таймеров и полосы задержки
+     *
+     * @return Result<void> Ошибка закрепления полосы задержки за CPU
+     */
+    [[nodiscard]] Result<void> start();
+
+    /**
+     * @brief Остановить: таймеры снимаются, поставленные задачи доделываются
+     *
+     * Задачи, поставленные после stop(), не выполняются.
+     */
+    void stop();
+
+    /**
+     * @brief Поставить задачу в пул
+     *
+     * Из потока пула - в его очередь (задача останется в кеше этого ядра),
+     * иначе - в очереди потоков по кругу.
+     */
+    void post(Task task);
+
+    /**
+     * @brief Поставить задачу в полосу задержки
+     *
+     * Задачи полосы выполняются одним потоком строго по порядку.
+     */
+    void post_latency(Task task);
+
+    /**
+     * @brief Выполнить задачу в пуле через delay
+     *
+     * @return TimerId Для cancel()
+     */
+    TimerId schedule_after(std::chrono::milliseconds delay, Task task);
+
+    /**
+     * @brief Выполнять задачу в пуле каждые period
+     *
+     * Следующий запуск отсчитывается от конца предыдущего: запуски одного
+     * таймера не перекрываются.
+     *
+     * @return TimerId Для cancel()
+     */
+    TimerId schedule_every(std::chrono::milliseconds period, Task task);
+
+    /**
+     * @brief Снять таймер
+     *
+     * Если задача таймера выполняется, ждёт её завершения (кроме вызова
+     * из самой задачи): после возврата задача больше не запустится.
+     */
+    void cancel(TimerId id);
+
+    /**
+     * @brief Потоков пула
+     */
+    [[nodiscard]] std::size_t worker_count() const noexcept;
+
+    /**
+     * @brief Выполнено задач пула
+     */
+    [[nodiscard]] uint64_t tasks_executed() const noexcept;
+
+    /**
+     * @brief Задач, перехваченных из чужой очереди
+     */
+    [[nodiscard]] uint64_t tasks_stolen() const noexcept;
+
+    /**
+     * @brief Текущий поток - полоса задержки этого исполнителя
+     */
+    [[nodiscard]] bool in_latency_lane() const noexcept;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace quaxis::core
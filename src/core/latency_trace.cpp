@@ -0,0 +1,307 @@
+/**
+ * @file latency_trace.cpp
+ * @brief Реализация трассировки латентности
+ */
+
+#include "latency_trace.hpp"
+
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <memory>
+#include <mutex>
+
+namespace quaxis::core {
+
+namespace {
+
+/// @brief Эпох, для которых помнится момент прихода блока
+constexpr std::size_t EPOCH_SLOTS = 64;
+
+/**
+ * @brief Кольцо событий одного потока
+ *
+ * Писатель - владелец потока, читатель - сборщик. Слот - два 64-битных
+ * слова (метка и упакованные epoch / stage / thread); запись, которую
+ * писатель мог перезаписать во время чтения, отбрасывается как потерянная.
+ */
+struct alignas(64) TraceRing {
+    std::atomic<uint64_t> head{0};
+    alignas(64) std::atomic<uint64_t> words[TRACE_RING_SIZE * 2]{};
+    
+    /// @brief Позиция сборщика (только под collector_mutex)
+    uint64_t tail = 0;
+    uint8_t thread = 0;
+};
+
+/**
+ * @brief Глобальное состояние трассировки
+ */
+struct TraceState {
+    std::atomic<bool> enabled{false};
+    
+    // Эпохи блоков
+    std::atomic<uint32_t> epoch{0};
+    std::atomic<uint64_t> current_key{0};
+    std::atomic<uint64_t> arrival_timestamp[EPOCH_SLOTS]{};
+    std::atomic<uint32_t> arrival_epoch[EPOCH_SLOTS]{};
+    
+    // Кольца потоков (живут до конца процесса)
+    std::mutex registry_mutex;
+    std::vector<std::unique_ptr<TraceRing>> rings;
+    
+    // Сборщик
+    std::mutex collector_mutex;
+    std::array<LatencyHistogram, TRACE_STAGE_COUNT> histograms{};
+    std::atomic<uint64_t> lost{0};
+    std::ofstream dump;
+    
+    std::once_flag calibrated;
+    std::atomic<double> ticks_per_us{1000.0};  // steady_clock: наносекунды
+};
+
+TraceState& state() {
+    static TraceState instance;
+    return instance;
+}
+
+/**
+ * @brief Частота trace_timestamp() (калибровка TscClock)
+ */
+void calibrate(TraceState& st) {
+    st.ticks_per_us.store(TscClock::ticks_per_ns() * 1000.0, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Кольцо текущего потока (регистрируется при первом событии)
+ */
+TraceRing& thread_ring() {
+    thread_local TraceRing* ring = nullptr;
+    if (!ring) {
+        auto& st = state();
+        auto owned = std::make_unique<TraceRing>();
+        std::lock_guard<std::mutex> lock(st.registry_mutex);
+        owned->thread = static_cast<uint8_t>(st.rings.size());
+        ring = owned.get();
+        st.rings.push_back(std::move(owned));
+    }
+    return *ring;
+}
+
+void record(TraceStage stage, uint32_t epoch, uint64_t timestamp) noexcept {
+    TraceRing& ring = thread_ring();
+    uint64_t head = ring.head.load(std::memory_order_relaxed);
+    auto* slot = &ring.words[(head % TRACE_RING_SIZE) * 2];
+    uint64_t packed = uint64_t{epoch}
+        | (uint64_t{static_cast<uint8_t>(stage)} << 32)
+        | (uint64_t{ring.thread} << 40);
+    slot[0].store(timestamp, std::memory_order_relaxed);
+    slot[1].store(packed, std::memory_order_relaxed);
+    ring.head.store(head + 1, std::memory_order_release);
+}
+
+/**
+ * @brief Вычитать одно кольцо
+ */
+void drain(TraceState& st, TraceRing& ring, std::vector<TraceEvent>& out) {
+    uint64_t head = ring.head.load(std::memory_order_acquire);
+    if (head - ring.tail > TRACE_RING_SIZE) {
+        st.lost.fetch_add(head - ring.tail - TRACE_RING_SIZE, std::memory_order_relaxed);
+        ring.tail = head - TRACE_RING_SIZE;
+    }
+    
+    const std::size_t first = out.size();
+    for (uint64_t i = ring.tail; i < head; ++i) {
+        const auto* slot = &ring.words[(i % TRACE_RING_SIZE) * 2];
+        TraceEvent event{};
+        event.timestamp = slot[0].load(std::memory_order_relaxed);
+        uint64_t packed = slot[1].load(std::memory_order_relaxed);
+        event.epoch = static_cast<uint32_t>(packed);
+        event.stage = static_cast<uint8_t>(packed >> 32);
+        event.thread = static_cast<uint8_t>(packed >> 40);
+        out.push_back(event);
+    }
+    
+    // Записи, которые писатель успел обогнать на круг, недостоверны
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint64_t head_after = ring.head.load(std::memory_order_relaxed);
+    if (head_after > TRACE_RING_SIZE && head_after - TRACE_RING_SIZE > ring.tail) {
+        uint64_t overwritten = std::min(head_after - TRACE_RING_SIZE, head) - ring.tail;
+        out.erase(out.begin() + static_cast<std::ptrdiff_t>(first),
+                  out.begin() + static_cast<std::ptrdiff_t>(first + overwritten));
+        st.lost.fetch_add(overwritten, std::memory_order_relaxed);
+    }
+    ring.tail = head;
+}
+
+} // anonymous namespace
+
+// =============================================================================
+// Запись событий
+// =============================================================================
+
+void set_tracing_enabled(bool enabled) {
+    auto& st = state();
+    if (enabled) {
+        std::call_once(st.calibrated, calibrate, std::ref(st));
+    }
+    st.enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool tracing_enabled() noexcept {
+    return state().enabled.load(std::memory_order_relaxed);
+}
+
+void trace_block_arrival(
+    TraceStage stage,
+    std::span<const uint8_t, 32> block_hash,
+    uint64_t timestamp
+) noexcept {
+    auto& st = state();
+    if (!st.enabled.load(std::memory_order_relaxed)) {
+        return;
+    }
+    
+    uint64_t key = 0;
+    std::memcpy(&key, block_hash.data(), sizeof(key));
+    
+    uint32_t epoch = st.epoch.load(std::memory_order_relaxed);
+    if (epoch == 0 || st.current_key.load(std::memory_order_relaxed) != key) {
+        epoch = st.epoch.fetch_add(1, std::memory_order_relaxed) + 1;
+        std::size_t slot = epoch % EPOCH_SLOTS;
+        st.arrival_timestamp[slot].store(timestamp, std::memory_order_relaxed);
+        st.arrival_epoch[slot].store(epoch, std::memory_order_release);
+        st.current_key.store(key, std::memory_order_relaxed);
+    }
+    record(stage, epoch, timestamp);
+}
+
+void trace_point(TraceStage stage) noexcept {
+    auto& st = state();
+    if (!st.enabled.load(std::memory_order_relaxed)) {
+        return;
+    }
+    record(stage, st.epoch.load(std::memory_order_relaxed), trace_timestamp());
+}
+
+// =============================================================================
+// Сборщик
+// =============================================================================
+
+std::size_t collect_trace() {
+    auto& st = state();
+    std::lock_guard<std::mutex> lock(st.collector_mutex);
+    
+    std::vector<TraceRing*> rings;
+    {
+        std::lock_guard<std::mutex> registry_lock(st.registry_mutex);
+        rings.reserve(st.rings.size());
+        for (auto& ring : st.rings) {
+            rings.push_back(ring.get());
+        }
+    }
+    
+    std::vector<TraceEvent> events;
+    for (auto* ring : rings) {
+        drain(st, *ring, events);
+    }
+    
+    const double ticks_per_ns = st.ticks_per_us.load(std::memory_order_relaxed) / 1000.0;
+    for (const auto& event : events) {
+        if (event.epoch == 0 || event.stage >= TRACE_STAGE_COUNT) {
+            continue;  // точка до первого блока
+        }
+        std::size_t slot = event.epoch % EPOCH_SLOTS;
+        if (st.arrival_epoch[slot].load(std::memory_order_acquire) != event.epoch) {
+            continue;  // приход эпохи уже вытеснен из таблицы
+        }
+        uint64_t arrival = st.arrival_timestamp[slot].load(std::memory_order_relaxed);
+        uint64_t ticks = event.timestamp > arrival ? event.timestamp - arrival : 0;
+        st.histograms[event.stage].record(
+            static_cast<uint64_t>(static_cast<double>(ticks) / ticks_per_ns));
+    }
+    
+    if (st.dump.is_open() && !events.empty()) {
+        st.dump.write(reinterpret_cast<const char*>(events.data()),
+                      static_cast<std::streamsize>(events.size() * sizeof(TraceEvent)));
+        st.dump.flush();
+    }
+    
+    return events.size();
+}
+
+std::vector<TraceStageStats> trace_stage_stats() {
+    auto& st = state();
+    std::lock_guard<std::mutex> lock(st.collector_mutex);
+    
+    std::vector<TraceStageStats> result;
+    for (std::size_t i = 0; i < TRACE_STAGE_COUNT; ++i) {
+        const auto& histogram = st.histograms[i];
+        if (histogram.count() == 0) {
+            continue;
+        }
+        TraceStageStats stats;
+        stats.stage = static_cast<TraceStage>(i);
+        stats.count = histogram.count();
+        stats.p50_us = static_cast<double>(histogram.percentile(0.50)) / 1000.0;
+        stats.p90_us = static_cast<double>(histogram.percentile(0.90)) / 1000.0;
+        stats.p99_us = static_cast<double>(histogram.percentile(0.99)) / 1000.0;
+        stats.max_us = static_cast<double>(histogram.max()) / 1000.0;
+        result.push_back(stats);
+    }
+    return result;
+}
+
+LatencyHistogram trace_stage_histogram(TraceStage stage) {
+    auto& st = state();
+    std::lock_guard<std::mutex> lock(st.collector_mutex);
+    auto index = static_cast<std::size_t>(stage);
+    return index < TRACE_STAGE_COUNT ? st.histograms[index] : LatencyHistogram{};
+}
+
+uint64_t trace_lost_events() noexcept {
+    return state().lost.load(std::memory_order_relaxed);
+}
+
+double trace_ticks_per_us() noexcept {
+    return state().ticks_per_us.load(std::memory_order_relaxed);
+}
+
+void reset_trace_stats() {
+    auto& st = state();
+    std::lock_guard<std::mutex> lock(st.collector_mutex);
+    for (auto& histogram : st.histograms) {
+        histogram.reset();
+    }
+    st.lost.store(0, std::memory_order_relaxed);
+}
+
+Result<void> open_trace_dump(const std::string& path) {
+    auto& st = state();
+    std::lock_guard<std::mutex> lock(st.collector_mutex);
+    
+    st.dump.close();
+    st.dump.open(path, std::ios::binary | std::ios::trunc);
+    if (!st.dump) {
+        return Err<void>(
+            ErrorCode::SystemIOError,
+            std::format("Не удалось открыть файл трассировки '{}'", path)
+        );
+    }
+    
+    TraceDumpHeader header{};
+    header.magic = TRACE_DUMP_MAGIC;
+    header.version = TRACE_DUMP_VERSION;
+    header.ticks_per_us = st.ticks_per_us.load(std::memory_order_relaxed);
+    st.dump.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    st.dump.flush();
+    return {};
+}
+
+void close_trace_dump() {
+    auto& st = state();
+    std::lock_guard<std::mutex> lock(st.collector_mutex);
+    st.dump.close();
+}
+
+} // namespace quaxis::core
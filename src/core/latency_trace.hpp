@@ -0,0 +1,308 @@
+/**
+ * @file latency_trace.hpp
+ * @brief Трассировка латентности от прихода блока до рассылки заданий ASIC
+ *
+ * Отвечает на вопрос "сколько мкс от блока из SHM / FIBRE до последнего
+ * ASIC с новым заданием". Каждый поток пишет события в собственное
+ * кольцо (без блокировок и без общих cache line): метка TSC, эпоха блока
+ * и этап. Сборщик (один на процесс, обычно основной цикл) периодически
+ * вычитывает кольца, считает латентность каждого этапа от прихода блока
+ * той же эпохи в гистограммы и при необходимости дописывает сырые
+ * события в бинарный файл для офлайн анализа.
+ *
+ * Выключенная трассировка стоит одной relaxed загрузки на точку.
+ *
+ * Формат файла дампа: TraceDumpHeader, затем записи TraceEvent
+ * (little-endian, без выравнивания между записями).
+ */
+
+#pragma once
+
+#include "types.hpp"
+#include "clock.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace quaxis::core {
+
+// =============================================================================
+// События
+// =============================================================================
+
+/**
+ * @brief Этап конвейера от блока до заданий
+ */
+enum class TraceStage : uint8_t {
+    ShmBlock = 0,       ///< Блок / шаблон замечен в shared memory
+    RelayBlock,         ///< Блок собран из FIBRE relay
+    TemplateGenerated,  ///< TemplateGenerator построил шаблон
+    JobCreated,         ///< JobManager принял новый шаблон
+    BroadcastBegin,     ///< Server начал рассылку
+    BroadcastDone,      ///< Последний ASIC получил задание
+    Count
+};
+
+/// @brief Количество этапов
+inline constexpr std::size_t TRACE_STAGE_COUNT = static_cast<std::size_t>(TraceStage::Count);
+
+/**
+ * @brief Имя этапа
+ */
+[[nodiscard]] constexpr std::string_view to_string(TraceStage stage) noexcept {
+    switch (stage) {
+        case TraceStage::ShmBlock:          return "shm_block";
+        case TraceStage::RelayBlock:        return "relay_block";
+        case TraceStage::TemplateGenerated: return "template";
+        case TraceStage::JobCreated:        return "job_created";
+        case TraceStage::BroadcastBegin:    return "broadcast_begin";
+        case TraceStage::BroadcastDone:     return "broadcast_done";
+        default: return "unknown";
+    }
+}
+
+/**
+ * @brief Запись события (одна запись файла дампа)
+ */
+struct TraceEvent {
+    uint64_t timestamp;  ///< Метка trace_timestamp() (такты TSC)
+    uint32_t epoch;      ///< Эпоха блока (растёт с каждым новым блоком)
+    uint8_t stage;       ///< TraceStage
+    uint8_t thread;      ///< Номер кольца потока
+    uint8_t reserved[2];
+};
+static_assert(sizeof(TraceEvent) == 16, "TraceEvent должен занимать 16 байт");
+
+/// @brief Magic файла дампа ("QXTR")
+inline constexpr uint32_t TRACE_DUMP_MAGIC = 0x52545851;
+
+/// @brief Версия формата дампа
+inline constexpr uint32_t TRACE_DUMP_VERSION = 1;
+
+/**
+ * @brief Заголовок файла дампа
+ */
+struct TraceDumpHeader {
+    uint32_t magic;
+    uint32_t version;
+    double ticks_per_us;  ///< Частота меток для перевода в мкс
+};
+static_assert(sizeof(TraceDumpHeader) == 16, "TraceDumpHeader должен занимать 16 байт");
+
+/// @brief Ёмкость кольца одного потока (событий)
+inline constexpr std::size_t TRACE_RING_SIZE = 4096;
+
+/**
+ * @brief Метка времени для трассировки (TscClock)
+ */
+[[nodiscard]] inline uint64_t trace_timestamp() noexcept {
+    return TscClock::ticks();
+}
+
+// =============================================================================
+// Гистограмма
+// =============================================================================
+
+/**
+ * @brief Лог-линейная гистограмма латентности (наносекунды)
+ *
+ * 8 корзин на каждую степень двойки: относительная погрешность
+ * перцентиля не больше 12.5%, фиксированный размер без аллокаций.
+ */
+class LatencyHistogram {
+public:
+    static constexpr std::size_t SUB_BUCKETS = 8;
+    static constexpr std::size_t BUCKETS = (64 - 2) * SUB_BUCKETS;
+
+    /**
+     * @brief Учесть значение
+     */
+    void record(uint64_t value_ns) noexcept {
+        ++buckets_[bucket_index(value_ns)];
+        ++count_;
+        sum_ += value_ns;
+        if (value_ns > max_) {
+            max_ = value_ns;
+        }
+    }
+
+    /**
+     * @brief Перцентиль (q в [0, 1]) - верхняя граница корзины
+     */
+    [[nodiscard]] uint64_t percentile(double q) const noexcept {
+        if (count_ == 0) {
+            return 0;
+        }
+        auto rank = static_cast<uint64_t>(q * static_cast<double>(count_ - 1)) + 1;
+        uint64_t seen = 0;
+        for (std::size_t i = 0; i < BUCKETS; ++i) {
+            seen += buckets_[i];
+            if (seen >= rank) {
+                return std::min(bucket_upper(i), max_);
+            }
+        }
+        return max_;
+    }
+
+    /**
+     * @brief Количество значений не больше bound (с точностью до корзины)
+     *
+     * Корзина учитывается, если её верхняя граница не больше bound -
+     * кумулятивные корзины Prometheus histogram.
+     */
+    [[nodiscard]] uint64_t count_at_most(uint64_t bound_ns) const noexcept {
+        uint64_t total = 0;
+        for (std::size_t i = 0; i < BUCKETS && bucket_upper(i) <= bound_ns; ++i) {
+            total += buckets_[i];
+        }
+        return total;
+    }
+
+    [[nodiscard]] uint64_t count() const noexcept { return count_; }
+    [[nodiscard]] uint64_t sum() const noexcept { return sum_; }
+    [[nodiscard]] uint64_t max() const noexcept { return max_; }
+
+    void reset() noexcept {
+        buckets_.fill(0);
+        count_ = 0;
+        sum_ = 0;
+        max_ = 0;
+    }
+
+private:
+    [[nodiscard]] static std::size_t bucket_index(uint64_t value) noexcept {
+        if (value < SUB_BUCKETS) {
+            return static_cast<std::size_t>(value);
+        }
+        const int msb = 63 - std::countl_zero(value);
+        const auto sub = static_cast<std::size_t>((value >> (msb - 3)) & (SUB_BUCKETS - 1));
+        return static_cast<std::size_t>(msb - 2) * SUB_BUCKETS + sub;
+    }
+
+    [[nodiscard]] static uint64_t bucket_upper(std::size_t index) noexcept {
+        if (index < SUB_BUCKETS) {
+            return index;
+        }
+        const int msb = static_cast<int>(index / SUB_BUCKETS) + 2;
+        const uint64_t sub = index % SUB_BUCKETS;
+        const uint64_t width = uint64_t{1} << (msb - 3);
+        return ((SUB_BUCKETS + sub) << (msb - 3)) + width - 1;
+    }
+
+    std::array<uint64_t, BUCKETS> buckets_{};
+    uint64_t count_ = 0;
+    uint64_t sum_ = 0;
+    uint64_t max_ = 0;
+};
+
+// =============================================================================
+// Запись событий (горячий путь)
+// =============================================================================
+
+/**
+ * @brief Включить / выключить трассировку
+ *
+ * При первом включении калибруется частота trace_timestamp() (~2 мс).
+ */
+void set_tracing_enabled(bool enabled);
+
+/**
+ * @brief Включена ли трассировка
+ */
+[[nodiscard]] bool tracing_enabled() noexcept;
+
+/**
+ * @brief Приход блока: начало новой эпохи
+ *
+ * Повторный приход того же блока из другого источника (SHM и FIBRE)
+ * записывается в текущую эпоху - его латентность показывает отставание
+ * второго источника.
+ *
+ * @param stage ShmBlock или RelayBlock
+ * @param block_hash Хеш блока (tip), ключ эпохи
+ * @param timestamp Момент обнаружения (trace_timestamp())
+ */
+void trace_block_arrival(
+    TraceStage stage,
+    std::span<const uint8_t, 32> block_hash,
+    uint64_t timestamp = trace_timestamp()
+) noexcept;
+
+/**
+ * @brief Точка этапа в текущей эпохе
+ */
+void trace_point(TraceStage stage) noexcept;
+
+// =============================================================================
+// Сборщик
+// =============================================================================
+
+/**
+ * @brief Статистика этапа (латентность от прихода блока)
+ */
+struct TraceStageStats {
+    TraceStage stage = TraceStage::ShmBlock;
+    uint64_t count = 0;
+    double p50_us = 0.0;
+    double p90_us = 0.0;
+    double p99_us = 0.0;
+    double max_us = 0.0;
+};
+
+/**
+ * @brief Вычитать кольца всех потоков в гистограммы (и файл дампа)
+ *
+ * Вызывается из одного потока.
+ *
+ * @return std::size_t Количество прочитанных событий
+ */
+std::size_t collect_trace();
+
+/**
+ * @brief Статистика этапов, по которым были события
+ */
+[[nodiscard]] std::vector<TraceStageStats> trace_stage_stats();
+
+/**
+ * @brief Копия гистограммы этапа (наносекунды от прихода блока)
+ */
+[[nodiscard]] LatencyHistogram trace_stage_histogram(TraceStage stage);
+
+/**
+ * @brief События, перезаписанные в кольцах до сбора
+ */
+[[nodiscard]] uint64_t trace_lost_events() noexcept;
+
+/**
+ * @brief Частота меток (тактов на микросекунду)
+ */
+[[nodiscard]] double trace_ticks_per_us() noexcept;
+
+/**
+ * @brief Сбросить гистограммы и счётчик потерь
+ */
+void reset_trace_stats();
+
+/**
+ * @brief Дописывать собранные события в бинарный файл
+ *
+ * @param path Путь к файлу (перезаписывается)
+ * @return Result<void> Успех или SystemIOError
+ */
+[[nodiscard]] Result<void> open_trace_dump(const std::string& path);
+
+/**
+ * @brief Закрыть файл дампа
+ */
+void close_trace_dump();
+
+} // namespace quaxis::core
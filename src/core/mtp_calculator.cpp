@@ -11,41 +11,86 @@
 namespace quaxis::core {
 
 void MtpCalculator::push_timestamp(uint32_t timestamp) {
-    std::lock_guard<std::mutex> lock(mutex_);
+    // Самый старый timestamp окна уходит
+    if (window_ == MTP_BLOCK_COUNT) {
+        erase_sorted(recent(MTP_BLOCK_COUNT - 1));
+    }
+    insert_sorted(timestamp);
     
-    timestamps_[head_] = timestamp;
-    head_ = (head_ + 1) % MTP_BLOCK_COUNT;
+    history_[head_] = timestamp;
+    head_ = (head_ + 1) % MTP_HISTORY;
+    stored_ = std::min(stored_ + 1, MTP_HISTORY);
     
-    if (count_ < MTP_BLOCK_COUNT) {
-        ++count_;
-    }
+    publish();
 }
 
 void MtpCalculator::push_header(const BlockHeader& header) {
     push_timestamp(header.timestamp);
 }
 
-void MtpCalculator::reset() {
-    std::lock_guard<std::mutex> lock(mutex_);
+std::size_t MtpCalculator::pop_headers(std::size_t count) {
+    const std::size_t popped = std::min(count, stored_);
     
-    timestamps_.fill(0);
-    count_ = 0;
-    head_ = 0;
+    for (std::size_t i = 0; i < popped; ++i) {
+        erase_sorted(recent(0));
+        head_ = (head_ + MTP_HISTORY - 1) % MTP_HISTORY;
+        --stored_;
+        
+        // В окно возвращается блок из истории
+        if (stored_ >= MTP_BLOCK_COUNT) {
+            insert_sorted(recent(MTP_BLOCK_COUNT - 1));
+        }
+    }
+    
+    publish();
+    return popped;
 }
 
-uint32_t MtpCalculator::get_mtp() const {
-    std::lock_guard<std::mutex> lock(mutex_);
+void MtpCalculator::reset() {
+    history_.fill(0);
+    head_ = 0;
+    stored_ = 0;
+    sorted_.fill(0);
+    window_ = 0;
     
-    if (count_ < MTP_BLOCK_COUNT) {
-        return 0;
+    publish();
+}
+
+uint32_t MtpCalculator::recent(std::size_t k) const noexcept {
+    return history_[(head_ + MTP_HISTORY - 1 - k) % MTP_HISTORY];
+}
+
+void MtpCalculator::insert_sorted(uint32_t timestamp) noexcept {
+    auto end = sorted_.begin() + static_cast<std::ptrdiff_t>(window_);
+    auto pos = std::upper_bound(sorted_.begin(), end, timestamp);
+    std::copy_backward(pos, end, end + 1);
+    *pos = timestamp;
+    ++window_;
+}
+
+void MtpCalculator::erase_sorted(uint32_t timestamp) noexcept {
+    auto end = sorted_.begin() + static_cast<std::ptrdiff_t>(window_);
+    auto pos = std::lower_bound(sorted_.begin(), end, timestamp);
+    if (pos == end || *pos != timestamp) {
+        return;
     }
-    
-    // Копируем timestamps для сортировки
-    std::array<uint32_t, MTP_BLOCK_COUNT> sorted = timestamps_;
-    std::sort(sorted.begin(), sorted.end());
+    std::copy(pos + 1, end, pos);
+    --window_;
+}
+
+void MtpCalculator::publish() noexcept {
+    Snapshot snapshot;
+    snapshot.window = static_cast<uint32_t>(window_);
     
     // Медиана - средний элемент (индекс MTP_BLOCK_COUNT/2 для нечётного количества)
-    return sorted[MTP_BLOCK_COUNT / 2];
+    if (window_ == MTP_BLOCK_COUNT) {
+        snapshot.mtp = sorted_[MTP_BLOCK_COUNT / 2];
+    }
+    snapshot_.store(snapshot);
+}
+
+uint32_t MtpCalculator::get_mtp() const {
+    return snapshot_.load().mtp;
 }
 
 uint32_t MtpCalculator::get_min_timestamp() const {
@@ -64,13 +109,20 @@ uint32_t MtpCalculator::get_min_timestamp() const {
 }
 
 bool MtpCalculator::has_sufficient_data() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return count_ >= MTP_BLOCK_COUNT;
+    return snapshot_.load().window >= MTP_BLOCK_COUNT;
 }
 
 std::size_t MtpCalculator::count() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return count_;
+    return snapshot_.load().window;
+}
+
+std::optional<uint32_t> roll_block_time(uint32_t current, uint32_t now, uint32_t min_timestamp) noexcept {
+    const uint32_t next = std::max({current + 1, now, min_timestamp});
+    const uint64_t limit = uint64_t{now} + constants::MAX_FUTURE_BLOCK_TIME;
+    if (next <= current || next > limit) {
+        return std::nullopt;
+    }
+    return next;
 }
 
 } // namespace quaxis::core
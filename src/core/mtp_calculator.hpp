@@ -4,16 +4,22 @@
  * 
  * Вычисляет MTP по последним 11 блокам для определения
  * минимально допустимого timestamp нового блока (MTP + 1).
+ * 
+ * Окно 11 timestamps хранится отсортированным и обновляется при каждом
+ * push/pop (вставка и удаление сдвигом, без сортировки). Медиана
+ * публикуется через Seqlock: get_mtp() на каждый новый tip - одно
+ * lock-free чтение без mutex.
  */
 
 #pragma once
 
 #include "types.hpp"
+#include "constants.hpp"
+#include "seqlock.hpp"
 #include "primitives/block_header.hpp"
 
 #include <array>
 #include <cstdint>
-#include <mutex>
 #include <optional>
 
 namespace quaxis::core {
@@ -23,11 +29,20 @@ namespace quaxis::core {
  */
 constexpr std::size_t MTP_BLOCK_COUNT = 11;
 
+/**
+ * @brief Глубина истории timestamps для отката (reorg)
+ */
+constexpr std::size_t MTP_HISTORY = 128;
+
 /**
  * @brief Калькулятор Median Time Past
  * 
- * Хранит timestamps последних 11 блоков и вычисляет медиану.
- * Thread-safe.
+ * Хранит timestamps последних MTP_HISTORY блоков и медиану последних 11.
+ * 
+ * Thread-safety: один писатель (push_*, pop_headers, reset вызывает один
+ * поток или вызовы сериализованы снаружи), читатели (get_mtp,
+ * get_min_timestamp, has_sufficient_data, count) - из любых потоков
+ * без блокировок.
  */
 class MtpCalculator {
 public:
@@ -47,6 +62,17 @@ public:
      */
     void push_header(const BlockHeader& header);
     
+    /**
+     * @brief Откатить последние блоки (reorg)
+     * 
+     * Окно дополняется более старыми timestamps из истории. После отката
+     * глубже MTP_HISTORY - 11 данных не хватит, пока не придут новые блоки.
+     * 
+     * @param count Количество блоков
+     * @return Сколько блоков откачено (не больше сохранённых)
+     */
+    std::size_t pop_headers(std::size_t count);
+    
     /**
      * @brief Сбросить все данные
      */
@@ -74,15 +100,47 @@ public:
     [[nodiscard]] bool has_sufficient_data() const;
     
     /**
-     * @brief Получить количество сохранённых timestamps
+     * @brief Получить количество timestamps в окне (не больше 11)
      */
     [[nodiscard]] std::size_t count() const;
 
 private:
-    mutable std::mutex mutex_;
-    std::array<uint32_t, MTP_BLOCK_COUNT> timestamps_{};
-    std::size_t count_{0};
-    std::size_t head_{0};  // Позиция для следующей записи (кольцевой буфер)
+    /// @brief Опубликованное состояние окна
+    struct Snapshot {
+        uint32_t mtp{0};
+        uint32_t window{0};
+    };
+    
+    /// @brief k-й timestamp с конца (0 - последний блок)
+    [[nodiscard]] uint32_t recent(std::size_t k) const noexcept;
+    void insert_sorted(uint32_t timestamp) noexcept;
+    void erase_sorted(uint32_t timestamp) noexcept;
+    void publish() noexcept;
+    
+    // Состояние писателя
+    std::array<uint32_t, MTP_HISTORY> history_{};
+    std::size_t head_{0};     // Позиция для следующей записи (кольцевой буфер)
+    std::size_t stored_{0};   // Timestamps в истории
+    std::array<uint32_t, MTP_BLOCK_COUNT> sorted_{};
+    std::size_t window_{0};   // Timestamps в отсортированном окне
+    
+    Seqlock<Snapshot> snapshot_;
 };
 
+/**
+ * @brief Следующий timestamp задания при ntime roll
+ * 
+ * Timestamp догоняет now; если уже не отстаёт - уходит на 1 секунду
+ * вперёд. Результат не меньше min_timestamp (MTP + 1) и не больше
+ * now + MAX_FUTURE_BLOCK_TIME.
+ * 
+ * @param current Текущий timestamp задания
+ * @param now Unix время
+ * @param min_timestamp Нижняя граница (0 - без MTP)
+ * @return std::optional<uint32_t> Новый timestamp или nullopt, если
+ *         timestamp уже упёрся в предел будущего
+ */
+[[nodiscard]] std::optional<uint32_t> roll_block_time(
+    uint32_t current, uint32_t now, uint32_t min_timestamp = 0) noexcept;
+
 } // namespace quaxis::core
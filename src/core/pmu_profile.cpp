@@ -0,0 +1,310 @@
+/**
+ * @file pmu_profile.cpp
+ * @brief Реализация счётчиков PMU
+ */
+
+#include "pmu_profile.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include <mutex>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace quaxis::core {
+
+namespace detail {
+
+std::atomic<bool> g_pmu_enabled{false};
+
+/**
+ * @brief Группа счётчиков и суммы участков одного потока
+ *
+ * Суммы пишет только поток-владелец (relaxed), сборка читает их из
+ * другого потока. Живёт до конца процесса: после выхода потока его
+ * суммы остаются в статистике.
+ */
+struct PmuThreadState {
+    int group_fd = -1;                                 ///< Лидер группы (под registry_mutex после открытия)
+    std::array<int, PMU_EVENT_COUNT> fds{};            ///< -1 - событие не открылось
+    std::array<int8_t, PMU_EVENT_COUNT> slot{};        ///< Позиция события в ответе read()
+    std::size_t opened = 0;
+    bool failed = false;
+
+    std::array<std::atomic<uint64_t>, PMU_REGION_COUNT> calls{};
+    std::array<std::atomic<uint64_t>, PMU_REGION_COUNT> units{};
+    std::array<std::array<std::atomic<uint64_t>, PMU_EVENT_COUNT>, PMU_REGION_COUNT> events{};
+};
+
+} // namespace detail
+
+namespace {
+
+using detail::PmuThreadState;
+
+struct PmuState {
+    std::mutex registry_mutex;
+    std::vector<std::unique_ptr<PmuThreadState>> threads;
+    std::string unavailable_reason;
+};
+
+PmuState& state() {
+    static PmuState instance;
+    return instance;
+}
+
+#if defined(__linux__)
+
+constexpr uint64_t EVENT_CONFIG[PMU_EVENT_COUNT] = {
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_BRANCH_MISSES,
+    PERF_COUNT_HW_CACHE_MISSES,
+};
+
+int open_event(uint64_t config, int group_fd) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = config;
+    if (group_fd < 0) {
+        attr.disabled = 1;  // Группа включается целиком через лидера
+    }
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP;
+    return static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, PERF_FLAG_FD_CLOEXEC));
+}
+
+std::string describe_open_error(int err) {
+    switch (err) {
+        case EACCES:
+        case EPERM:
+            return "perf_event_open запрещён (kernel.perf_event_paranoid > 2 или seccomp)";
+        case ENOENT:
+        case EOPNOTSUPP:
+        case ENODEV:
+            return "аппаратные счётчики недоступны (виртуальная машина без vPMU?)";
+        default:
+            return std::string("perf_event_open: ") + std::strerror(err);
+    }
+}
+
+/**
+ * @brief Открыть группу счётчиков текущего потока
+ *
+ * @return std::string Пусто - хотя бы лидер (такты) открыт
+ */
+std::string open_group(PmuThreadState& thread) {
+    thread.fds.fill(-1);
+    thread.slot.fill(-1);
+    for (std::size_t i = 0; i < PMU_EVENT_COUNT; ++i) {
+        const int fd = open_event(EVENT_CONFIG[i], thread.group_fd);
+        if (fd < 0) {
+            if (i == 0) {
+                return describe_open_error(errno);
+            }
+            continue;  // Промахи кеша есть не на каждом PMU
+        }
+        if (thread.group_fd < 0) {
+            thread.group_fd = fd;
+        }
+        thread.fds[i] = fd;
+        thread.slot[i] = static_cast<int8_t>(thread.opened++);
+    }
+    return {};
+}
+
+void close_group(PmuThreadState& thread) {
+    for (int& fd : thread.fds) {
+        if (fd >= 0) {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+    thread.group_fd = -1;
+}
+
+/**
+ * @brief Прочитать все счётчики группы
+ */
+bool read_group(const PmuThreadState& thread, std::array<uint64_t, PMU_EVENT_COUNT>& out) noexcept {
+    uint64_t buffer[1 + PMU_EVENT_COUNT];
+    const auto size = static_cast<ssize_t>(sizeof(uint64_t) * (1 + thread.opened));
+    if (::read(thread.group_fd, buffer, static_cast<std::size_t>(size)) != size) {
+        return false;
+    }
+    for (std::size_t i = 0; i < PMU_EVENT_COUNT; ++i) {
+        out[i] = thread.slot[i] >= 0 ? buffer[1 + thread.slot[i]] : 0;
+    }
+    return true;
+}
+
+#endif
+
+/**
+ * @brief Закрывает группу при выходе потока
+ */
+struct ThreadHolder {
+    PmuThreadState* thread = nullptr;
+
+    ~ThreadHolder() {
+#if defined(__linux__)
+        if (thread != nullptr) {
+            std::lock_guard<std::mutex> lock(state().registry_mutex);
+            close_group(*thread);
+        }
+#endif
+    }
+};
+
+/**
+ * @brief Состояние текущего потока (группа открывается при первом замере)
+ *
+ * @return nullptr - PMU в этом потоке недоступен
+ */
+PmuThreadState* thread_state() noexcept {
+#if defined(__linux__)
+    thread_local ThreadHolder holder;
+    if (holder.thread == nullptr) {
+        auto owned = std::make_unique<PmuThreadState>();
+        std::string error = open_group(*owned);
+        auto& st = state();
+        std::lock_guard<std::mutex> lock(st.registry_mutex);
+        if (!error.empty()) {
+            owned->failed = true;
+            if (st.unavailable_reason.empty()) {
+                st.unavailable_reason = std::move(error);
+            }
+        } else if (pmu_enabled()) {
+            // Группа открыта выключенной; под mutex не разойдётся с set_pmu_enabled()
+            ::ioctl(owned->group_fd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        }
+        holder.thread = owned.get();
+        st.threads.push_back(std::move(owned));
+    }
+    return holder.thread->failed ? nullptr : holder.thread;
+#else
+    return nullptr;
+#endif
+}
+
+} // anonymous namespace
+
+// =============================================================================
+// Включение
+// =============================================================================
+
+bool set_pmu_enabled(bool enabled) {
+#if defined(__linux__)
+    auto& st = state();
+    if (enabled) {
+        // Проверка на вызывающем потоке: без PMU профиль не включается
+        if (thread_state() == nullptr) {
+            return false;
+        }
+    }
+    std::lock_guard<std::mutex> lock(st.registry_mutex);
+    detail::g_pmu_enabled.store(enabled, std::memory_order_relaxed);
+    // Выключенные группы не нагружают переключение контекста
+    for (const auto& thread : st.threads) {
+        if (thread->group_fd >= 0) {
+            ::ioctl(thread->group_fd, enabled ? PERF_EVENT_IOC_ENABLE : PERF_EVENT_IOC_DISABLE,
+                    PERF_IOC_FLAG_GROUP);
+        }
+    }
+    return enabled;
+#else
+    if (enabled) {
+        state().unavailable_reason = "perf_event_open есть только в Linux";
+    }
+    return false;
+#endif
+}
+
+std::string pmu_unavailable_reason() {
+    auto& st = state();
+    std::lock_guard<std::mutex> lock(st.registry_mutex);
+    return st.unavailable_reason;
+}
+
+// =============================================================================
+// Замер
+// =============================================================================
+
+void PmuScope::begin(PmuRegion region, uint64_t units) noexcept {
+#if defined(__linux__)
+    PmuThreadState* thread = thread_state();
+    if (thread == nullptr || !read_group(*thread, start_)) {
+        return;
+    }
+    thread_ = thread;
+    region_ = region;
+    units_ = units;
+#else
+    (void)region;
+    (void)units;
+#endif
+}
+
+void PmuScope::end() noexcept {
+#if defined(__linux__)
+    std::array<uint64_t, PMU_EVENT_COUNT> finish;
+    if (!read_group(*thread_, finish)) {
+        return;
+    }
+    const auto index = static_cast<std::size_t>(region_);
+    thread_->calls[index].fetch_add(1, std::memory_order_relaxed);
+    thread_->units[index].fetch_add(units_, std::memory_order_relaxed);
+    for (std::size_t i = 0; i < PMU_EVENT_COUNT; ++i) {
+        thread_->events[index][i].fetch_add(finish[i] - start_[i], std::memory_order_relaxed);
+    }
+#endif
+}
+
+// =============================================================================
+// Сборка
+// =============================================================================
+
+std::vector<PmuRegionStats> pmu_region_stats() {
+    std::vector<PmuRegionStats> stats(PMU_REGION_COUNT);
+    for (std::size_t r = 0; r < PMU_REGION_COUNT; ++r) {
+        stats[r].region = static_cast<PmuRegion>(r);
+    }
+
+    auto& st = state();
+    std::lock_guard<std::mutex> lock(st.registry_mutex);
+    for (const auto& thread : st.threads) {
+        if (thread->failed) {
+            continue;
+        }
+        for (std::size_t r = 0; r < PMU_REGION_COUNT; ++r) {
+            stats[r].calls += thread->calls[r].load(std::memory_order_relaxed);
+            stats[r].units += thread->units[r].load(std::memory_order_relaxed);
+            for (std::size_t e = 0; e < PMU_EVENT_COUNT; ++e) {
+                stats[r].events[e] += thread->events[r][e].load(std::memory_order_relaxed);
+                stats[r].available[e] = stats[r].available[e] || thread->slot[e] >= 0;
+            }
+        }
+    }
+    return stats;
+}
+
+std::size_t pmu_thread_count() {
+    auto& st = state();
+    std::lock_guard<std::mutex> lock(st.registry_mutex);
+    std::size_t count = 0;
+    for (const auto& thread : st.threads) {
+        count += thread->group_fd >= 0 ? 1 : 0;
+    }
+    return count;
+}
+
+} // namespace quaxis::core
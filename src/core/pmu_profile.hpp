@@ -0,0 +1,174 @@
+/**
+ * @file pmu_profile.hpp
+ * @brief Счётчики PMU (perf_event_open) вокруг горячих участков
+ *
+ * Отвечает на вопрос "сколько тактов на хеш, промахов предсказателя и
+ * кеша в SHA-NI, проверке shares и FEC декодере" на рабочей машине, без
+ * perf record. Каждый поток при первом замере открывает группу счётчиков
+ * (такты, инструкции, промахи ветвлений, промахи кеша; только user
+ * space) и копит дельты по участкам в собственных счётчиках; сборка
+ * (метрики) суммирует потоки.
+ *
+ * Выключенный профиль стоит одной relaxed загрузки на участок.
+ * Включённый - два read() группы на участок: мерить стоит пакеты
+ * (sha256d64 на N блоков), а не отдельные хеши. Вложенные участки
+ * считаются включительно.
+ *
+ * Без PMU (виртуальная машина, kernel.perf_event_paranoid > 2) профиль
+ * не включается, причина - pmu_unavailable_reason().
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace quaxis::core {
+
+/**
+ * @brief Профилируемый участок
+ */
+enum class PmuRegion : uint8_t {
+    Sha256ShaNi = 0,  ///< Пакетный SHA-256d на SHA-NI (единица - 64-байтный блок)
+    ShareValidate,    ///< Проверка shares, одиночная и пакетом (единица - share)
+    FecDecode,        ///< FecDecoder::decode (единица - data чанк блока)
+    Count
+};
+
+/// @brief Количество участков
+inline constexpr std::size_t PMU_REGION_COUNT = static_cast<std::size_t>(PmuRegion::Count);
+
+/**
+ * @brief Аппаратное событие
+ */
+enum class PmuEvent : uint8_t {
+    Cycles = 0,
+    Instructions,
+    BranchMisses,
+    CacheMisses,
+    Count
+};
+
+/// @brief Количество событий
+inline constexpr std::size_t PMU_EVENT_COUNT = static_cast<std::size_t>(PmuEvent::Count);
+
+[[nodiscard]] constexpr std::string_view to_string(PmuRegion region) noexcept {
+    switch (region) {
+        case PmuRegion::Sha256ShaNi:   return "sha256_shani";
+        case PmuRegion::ShareValidate: return "share_validate";
+        case PmuRegion::FecDecode:     return "fec_decode";
+        default: return "unknown";
+    }
+}
+
+[[nodiscard]] constexpr std::string_view to_string(PmuEvent event) noexcept {
+    switch (event) {
+        case PmuEvent::Cycles:       return "cycles";
+        case PmuEvent::Instructions: return "instructions";
+        case PmuEvent::BranchMisses: return "branch_misses";
+        case PmuEvent::CacheMisses:  return "cache_misses";
+        default: return "unknown";
+    }
+}
+
+// =============================================================================
+// Включение
+// =============================================================================
+
+namespace detail {
+extern std::atomic<bool> g_pmu_enabled;
+struct PmuThreadState;
+} // namespace detail
+
+/**
+ * @brief Включить / выключить профиль (в любой момент работы)
+ *
+ * @return bool Профиль включён (false - PMU недоступен или выключение)
+ */
+bool set_pmu_enabled(bool enabled);
+
+/**
+ * @brief Включён ли профиль
+ */
+[[nodiscard]] inline bool pmu_enabled() noexcept {
+    return detail::g_pmu_enabled.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Почему PMU недоступен (пусто - доступен или ещё не проверялся)
+ */
+[[nodiscard]] std::string pmu_unavailable_reason();
+
+// =============================================================================
+// Замер (горячий путь)
+// =============================================================================
+
+/**
+ * @brief Замер участка от конструктора до деструктора
+ *
+ * ```cpp
+ * core::PmuScope pmu(core::PmuRegion::Sha256ShaNi, blocks);
+ * ```
+ */
+class PmuScope {
+public:
+    /**
+     * @param region Участок
+     * @param units Единиц работы (хешей, shares, символов) для нормировки
+     */
+    explicit PmuScope(PmuRegion region, uint64_t units = 1) noexcept {
+        if (pmu_enabled()) [[unlikely]] {
+            begin(region, units);
+        }
+    }
+
+    ~PmuScope() {
+        if (thread_ != nullptr) [[unlikely]] {
+            end();
+        }
+    }
+
+    PmuScope(const PmuScope&) = delete;
+    PmuScope& operator=(const PmuScope&) = delete;
+
+private:
+    void begin(PmuRegion region, uint64_t units) noexcept;
+    void end() noexcept;
+
+    detail::PmuThreadState* thread_ = nullptr;
+    PmuRegion region_ = PmuRegion::Sha256ShaNi;
+    uint64_t units_ = 0;
+    std::array<uint64_t, PMU_EVENT_COUNT> start_{};
+};
+
+// =============================================================================
+// Сборка
+// =============================================================================
+
+/**
+ * @brief Сумма по всем потокам для участка
+ */
+struct PmuRegionStats {
+    PmuRegion region = PmuRegion::Sha256ShaNi;
+    uint64_t calls = 0;
+    uint64_t units = 0;
+    std::array<uint64_t, PMU_EVENT_COUNT> events{};
+    std::array<bool, PMU_EVENT_COUNT> available{};  ///< Событие открылось хотя бы в одном потоке
+};
+
+/**
+ * @brief Статистика всех участков (суммы с запуска процесса)
+ */
+[[nodiscard]] std::vector<PmuRegionStats> pmu_region_stats();
+
+/**
+ * @brief Потоков с открытой группой счётчиков
+ */
+[[nodiscard]] std::size_t pmu_thread_count();
+
+} // namespace quaxis::core
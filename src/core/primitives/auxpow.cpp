@@ -72,27 +72,41 @@ std::optional<AuxPowCommitment> AuxPowCommitment::find_in_coinbase(
     return std::nullopt;
 }
 
-bool AuxPow::verify(const Hash256& aux_hash) const noexcept {
+namespace {
+
+/// @brief Проверка AuxPoW, общая для AuxPow и AuxPowView
+template<typename AuxPowLike>
+bool verify_auxpow(const AuxPowLike& auxpow, const Hash256& aux_hash) noexcept {
     // 1. Проверяем coinbase branch
-    auto computed_merkle_root = coinbase_branch.compute_root(coinbase_hash);
-    if (computed_merkle_root != parent_header.merkle_root) {
+    auto computed_merkle_root = auxpow.coinbase_branch.compute_root(auxpow.coinbase_hash);
+    if (computed_merkle_root != auxpow.parent_header.merkle_root) {
         return false;
     }
     
     // 2. Находим commitment в coinbase
-    auto commitment = AuxPowCommitment::find_in_coinbase(coinbase_tx);
+    auto commitment = AuxPowCommitment::find_in_coinbase(auxpow.coinbase_tx);
     if (!commitment) {
         return false;
     }
     
     // 3. Проверяем aux branch
-    auto computed_aux_root = aux_branch.compute_root(aux_hash);
+    auto computed_aux_root = auxpow.aux_branch.compute_root(aux_hash);
     if (computed_aux_root != commitment->aux_merkle_root) {
         return false;
     }
     
     // 4. Проверяем proof-of-work родительского блока
-    return verify_pow();
+    return auxpow.verify_pow();
+}
+
+bool header_meets_target(const BlockHeader& header, uint32_t target_bits) noexcept {
+    return header.hash_uint256() <= bits_to_target(target_bits);
+}
+
+} // anonymous namespace
+
+bool AuxPow::verify(const Hash256& aux_hash) const noexcept {
+    return verify_auxpow(*this, aux_hash);
 }
 
 bool AuxPow::verify_pow() const noexcept {
@@ -100,9 +114,7 @@ bool AuxPow::verify_pow() const noexcept {
 }
 
 bool AuxPow::meets_target(uint32_t target_bits) const noexcept {
-    auto parent_hash = parent_header.hash_uint256();
-    auto target = bits_to_target(target_bits);
-    return parent_hash <= target;
+    return header_meets_target(parent_header, target_bits);
 }
 
 Hash256 AuxPow::get_parent_hash() const noexcept {
@@ -114,68 +126,92 @@ uint32_t AuxPow::get_chain_id() const noexcept {
 }
 
 Bytes AuxPow::serialize() const {
-    Bytes result;
-    
-    // Coinbase tx length (varint, упрощённо 2 байта)
-    uint16_t tx_len = static_cast<uint16_t>(coinbase_tx.size());
-    result.push_back(static_cast<uint8_t>(tx_len));
-    result.push_back(static_cast<uint8_t>(tx_len >> 8));
-    
-    // Coinbase tx
-    result.insert(result.end(), coinbase_tx.begin(), coinbase_tx.end());
-    
-    // Coinbase hash
-    result.insert(result.end(), coinbase_hash.begin(), coinbase_hash.end());
-    
-    // Coinbase branch
-    auto cb_branch = coinbase_branch.serialize();
-    result.insert(result.end(), cb_branch.begin(), cb_branch.end());
-    
-    // Aux branch
-    auto aux_br = aux_branch.serialize();
-    result.insert(result.end(), aux_br.begin(), aux_br.end());
-    
-    // Parent header
-    auto header = parent_header.serialize();
-    result.insert(result.end(), header.begin(), header.end());
-    
-    return result;
+    serialization::WriteStream out(serialized_length());
+    write_to(out);
+    return out.take_data();
 }
 
 std::optional<AuxPow> AuxPow::deserialize(ByteSpan data) {
-    if (data.size() < 2) {
+    auto view = AuxPowView::parse(data);
+    if (!view) {
         return std::nullopt;
     }
-    
+    return view->to_owned();
+}
+
+// =============================================================================
+// AuxPowView
+// =============================================================================
+
+bool AuxPowView::verify(const Hash256& aux_hash) const noexcept {
+    return verify_auxpow(*this, aux_hash);
+}
+
+bool AuxPowView::verify_pow() const noexcept {
+    return parent_header.check_pow();
+}
+
+bool AuxPowView::meets_target(uint32_t target_bits) const noexcept {
+    return header_meets_target(parent_header, target_bits);
+}
+
+Hash256 AuxPowView::get_parent_hash() const noexcept {
+    return parent_header.hash();
+}
+
+uint32_t AuxPowView::get_chain_id() const noexcept {
+    return parent_header.get_chain_id();
+}
+
+AuxPow AuxPowView::to_owned() const {
     AuxPow auxpow;
-    std::size_t offset = 0;
-    
-    // Coinbase tx length
-    uint16_t low = static_cast<uint16_t>(data[offset]);
-    uint16_t high = static_cast<uint16_t>(data[offset + 1]);
-    uint16_t tx_len = static_cast<uint16_t>(low | (high << 8));
-    offset += 2;
+    auxpow.coinbase_tx.assign(coinbase_tx.begin(), coinbase_tx.end());
+    auxpow.coinbase_hash = coinbase_hash;
+    auxpow.coinbase_branch = coinbase_branch.to_branch();
+    auxpow.aux_branch = aux_branch.to_branch();
+    auxpow.parent_header = parent_header;
+    return auxpow;
+}
+
+std::optional<AuxPowView> AuxPowView::parse(ByteSpan data) noexcept {
+    AuxPowView view;
     
-    if (offset + tx_len > data.size()) {
+    // Coinbase tx (длина - 2 байта, little-endian)
+    if (data.size() < 2) {
+        return std::nullopt;
+    }
+    std::size_t tx_len = static_cast<std::size_t>(data[0]) |
+                         (static_cast<std::size_t>(data[1]) << 8);
+    data = data.subspan(2);
+    if (data.size() < tx_len + 32) {
         return std::nullopt;
     }
+    view.coinbase_tx = data.first(tx_len);
+    std::memcpy(view.coinbase_hash.data(), data.data() + tx_len, 32);
+    data = data.subspan(tx_len + 32);
     
-    // Coinbase tx
-    auxpow.coinbase_tx.assign(data.begin() + static_cast<std::ptrdiff_t>(offset), 
-                              data.begin() + static_cast<std::ptrdiff_t>(offset + tx_len));
-    offset += tx_len;
+    // Branches
+    auto coinbase_branch = MerkleBranchView::parse(data);
+    if (!coinbase_branch) {
+        return std::nullopt;
+    }
+    view.coinbase_branch = *coinbase_branch;
+    data = data.subspan(coinbase_branch->serialized_length());
     
-    // Coinbase hash
-    if (offset + 32 > data.size()) {
+    auto aux_branch = MerkleBranchView::parse(data);
+    if (!aux_branch) {
         return std::nullopt;
     }
-    std::memcpy(auxpow.coinbase_hash.data(), data.data() + offset, 32);
-    offset += 32;
+    view.aux_branch = *aux_branch;
+    data = data.subspan(aux_branch->serialized_length());
     
-    // Остальное требует более сложной десериализации branches
-    // Для простоты возвращаем то, что есть
+    // Parent header
+    if (data.size() < BLOCK_HEADER_SIZE) {
+        return std::nullopt;
+    }
+    view.parent_header = BlockHeader::deserialize(data.data());
     
-    return auxpow;
+    return view;
 }
 
 uint32_t compute_slot_id(
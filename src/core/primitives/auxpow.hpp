@@ -23,6 +23,9 @@ inline constexpr std::array<uint8_t, 4> AUXPOW_MAGIC = {0xfa, 0xbe, 0x6d, 0x6d};
 /// @brief Максимальная глубина Merkle дерева AuxPoW
 inline constexpr std::size_t MAX_AUXPOW_MERKLE_DEPTH = 20;
 
+/// @brief Максимальный размер coinbase родительского блока в AuxPoW
+inline constexpr std::size_t MAX_AUXPOW_COINBASE_SIZE = 1024;
+
 /**
  * @brief Commitment для AuxPoW в coinbase
  * 
@@ -137,6 +140,31 @@ struct AuxPow {
      */
     [[nodiscard]] Bytes serialize() const;
     
+    /**
+     * @brief Записать AuxPoW в поток (WriteStream или FixedWriteStream)
+     * 
+     * Для FixedWriteStream<serialized_size_v<AuxPow>> без кучи, если
+     * coinbase и branches в пределах MAX_AUXPOW_*.
+     */
+    template<typename Stream>
+    void write_to(Stream& out) const {
+        // Длина coinbase (упрощённо 2 байта вместо varint)
+        out.write_u16_le(static_cast<uint16_t>(coinbase_tx.size()));
+        out.write_bytes(coinbase_tx);
+        out.write_hash256(coinbase_hash);
+        coinbase_branch.write_to(out);
+        aux_branch.write_to(out);
+        out.write_bytes(parent_header.serialize());
+    }
+    
+    /**
+     * @brief Размер сериализации (байт)
+     */
+    [[nodiscard]] std::size_t serialized_length() const noexcept {
+        return 2 + coinbase_tx.size() + 32 + coinbase_branch.serialized_length() +
+               aux_branch.serialized_length() + BLOCK_HEADER_SIZE;
+    }
+    
     /**
      * @brief Десериализовать AuxPoW
      * 
@@ -146,6 +174,56 @@ struct AuxPow {
     [[nodiscard]] static std::optional<AuxPow> deserialize(ByteSpan data);
 };
 
+/**
+ * @brief AuxPoW поверх сериализованных данных (формат AuxPow::serialize())
+ * 
+ * coinbase_tx и хеши branches - view во входной буфер, parse() проверяет
+ * только длины полей. Проверка сотен AuxPoW через view не выделяет
+ * память; буфер должен пережить view.
+ */
+struct AuxPowView {
+    /// @brief Coinbase транзакция родительского блока
+    ByteSpan coinbase_tx;
+    
+    /// @brief Хеш coinbase транзакции
+    Hash256 coinbase_hash{};
+    
+    /// @brief Merkle branch от coinbase до merkle root родительского блока
+    MerkleBranchView coinbase_branch;
+    
+    /// @brief Merkle branch от aux chain hash до aux merkle root
+    MerkleBranchView aux_branch;
+    
+    /// @brief Заголовок родительского блока
+    BlockHeader parent_header;
+    
+    /**
+     * @brief Проверить AuxPoW (как AuxPow::verify)
+     */
+    [[nodiscard]] bool verify(const Hash256& aux_hash) const noexcept;
+    
+    [[nodiscard]] bool verify_pow() const noexcept;
+    
+    [[nodiscard]] bool meets_target(uint32_t target_bits) const noexcept;
+    
+    [[nodiscard]] Hash256 get_parent_hash() const noexcept;
+    
+    [[nodiscard]] uint32_t get_chain_id() const noexcept;
+    
+    /**
+     * @brief Скопировать в AuxPow
+     */
+    [[nodiscard]] AuxPow to_owned() const;
+    
+    /**
+     * @brief Разобрать AuxPoW
+     * 
+     * @param data Сериализованные данные
+     * @return View или nullopt при нехватке данных
+     */
+    [[nodiscard]] static std::optional<AuxPowView> parse(ByteSpan data) noexcept;
+};
+
 // =============================================================================
 // Вспомогательные функции
 // =============================================================================
@@ -204,4 +282,21 @@ struct AuxPow {
     uint32_t target_bits
 ) noexcept;
 
+// =============================================================================
+// Границы сериализации
+// =============================================================================
+
+template<>
+struct serialization::serialized_size<MerkleBranch> {
+    static constexpr std::size_t value = 1 + MAX_AUXPOW_MERKLE_DEPTH * 32 + 4;
+};
+
+template<>
+struct serialization::serialized_size<AuxPow> {
+    static constexpr std::size_t value =
+        2 + MAX_AUXPOW_COINBASE_SIZE + 32 +
+        2 * serialization::serialized_size_v<MerkleBranch> +
+        serialization::serialized_size_v<BlockHeader>;
+};
+
 } // namespace quaxis::core
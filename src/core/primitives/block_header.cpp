@@ -6,8 +6,8 @@
 #include "block_header.hpp"
 #include "../../crypto/sha256.hpp"
 
+#include <algorithm>
 #include <cstring>
-#include <cmath>
 
 namespace quaxis::core {
 
@@ -142,102 +142,41 @@ std::array<uint8_t, 16> BlockHeader::get_tail() const noexcept {
     return result;
 }
 
-uint256 bits_to_target(uint32_t bits) noexcept {
-    uint256 target;
-    
-    // Извлекаем экспоненту и мантиссу
-    uint32_t exponent = bits >> 24;
-    uint32_t mantissa = bits & 0x007FFFFF;
-    
-    // Проверяем отрицательный флаг (не должен быть установлен)
-    if (bits & 0x00800000) {
-        return uint256::zero();
-    }
-    
-    // Вычисляем позицию мантиссы
-    if (exponent <= 3) {
-        mantissa >>= 8 * (3 - exponent);
-        target.data()[0] = static_cast<uint8_t>(mantissa);
-        target.data()[1] = static_cast<uint8_t>(mantissa >> 8);
-        target.data()[2] = static_cast<uint8_t>(mantissa >> 16);
-    } else {
-        std::size_t shift = exponent - 3;
-        if (shift < 32 - 3) {
-            target.data()[shift] = static_cast<uint8_t>(mantissa);
-            target.data()[shift + 1] = static_cast<uint8_t>(mantissa >> 8);
-            target.data()[shift + 2] = static_cast<uint8_t>(mantissa >> 16);
-        }
-    }
-    
-    return target;
-}
-
-uint32_t target_to_bits(const uint256& target) noexcept {
-    // Находим старший ненулевой байт
-    int i = 31;
-    while (i > 0 && target[i] == 0) {
-        --i;
-    }
-    
-    uint32_t mantissa;
-    uint32_t exponent;
-    
-    if (i >= 2) {
-        mantissa = (static_cast<uint32_t>(target[i]) << 16) |
-                   (static_cast<uint32_t>(target[i - 1]) << 8) |
-                   static_cast<uint32_t>(target[i - 2]);
-        exponent = static_cast<uint32_t>(i + 1);
-    } else if (i == 1) {
-        mantissa = (static_cast<uint32_t>(target[1]) << 16) |
-                   (static_cast<uint32_t>(target[0]) << 8);
-        exponent = 2;
-    } else {
-        mantissa = static_cast<uint32_t>(target[0]) << 16;
-        exponent = 1;
-    }
-    
-    // Если старший бит мантиссы установлен, сдвигаем
-    if (mantissa & 0x00800000) {
-        mantissa >>= 8;
-        exponent++;
-    }
-    
-    return (exponent << 24) | mantissa;
-}
-
 double bits_to_difficulty(uint32_t bits) noexcept {
     // Difficulty 1 target (Bitcoin genesis)
     constexpr uint32_t DIFF1_BITS = 0x1d00ffff;
+    constexpr double DIFF1_TARGET = bits_to_target(DIFF1_BITS).to_double();
     
-    auto target = bits_to_target(bits);
-    auto diff1_target = bits_to_target(DIFF1_BITS);
-    
-    // Вычисляем difficulty = diff1_target / target
-    // Упрощённая версия для небольших чисел
+    // difficulty = diff1_target / target
+    const double target = bits_to_target(bits).to_double();
+    if (target == 0) return 0;
     
-    // Находим старший байт каждого target
-    int target_msb = 31;
-    while (target_msb > 0 && target[target_msb] == 0) --target_msb;
-    
-    int diff1_msb = 31;
-    while (diff1_msb > 0 && diff1_target[diff1_msb] == 0) --diff1_msb;
+    return DIFF1_TARGET / target;
+}
+
+std::size_t hash_headers(std::span<const BlockHeader> headers, std::span<Hash256> out) noexcept {
+    const std::size_t count = std::min(headers.size(), out.size());
     
-    // Грубое приближение через double
-    double target_approx = 0;
-    for (int j = target_msb; j >= 0 && j > target_msb - 8; --j) {
-        target_approx = target_approx * 256.0 + static_cast<double>(target[j]);
-    }
-    target_approx *= std::pow(256.0, target_msb - 7);
+    // Пачками фиксированного размера, без выделения памяти
+    constexpr std::size_t CHUNK = 64;
+    std::array<crypto::Sha256State, CHUNK> midstates;
+    std::array<crypto::HeaderTail, CHUNK> tails;
     
-    double diff1_approx = 0;
-    for (int j = diff1_msb; j >= 0 && j > diff1_msb - 8; --j) {
-        diff1_approx = diff1_approx * 256.0 + static_cast<double>(diff1_target[j]);
+    for (std::size_t start = 0; start < count; start += CHUNK) {
+        const std::size_t n = std::min(CHUNK, count - start);
+        for (std::size_t i = 0; i < n; ++i) {
+            auto serialized = headers[start + i].serialize();
+            midstates[i] = crypto::compute_midstate(serialized.data());
+            std::memcpy(tails[i].data(), serialized.data() + 64, tails[i].size());
+        }
+        (void)crypto::hash_headers_with_midstate_batch(
+            std::span<const crypto::Sha256State>(midstates.data(), n),
+            std::span<const crypto::HeaderTail>(tails.data(), n),
+            out.subspan(start, n)
+        );
     }
-    diff1_approx *= std::pow(256.0, diff1_msb - 7);
-    
-    if (target_approx == 0) return 0;
     
-    return diff1_approx / target_approx;
+    return count;
 }
 
 } // namespace quaxis::core
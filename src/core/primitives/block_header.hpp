@@ -10,7 +10,9 @@
 
 #include "../types.hpp"
 #include "uint256.hpp"
+#include "../serialization/stream.hpp"
 
+#include <algorithm>
 #include <array>
 #include <cstdint>
 #include <span>
@@ -165,9 +167,26 @@ struct BlockHeader {
  * @brief Преобразовать compact bits в 256-битный target
  * 
  * @param bits Compact representation
- * @return uint256 256-битный target
+ * @return uint256 256-битный target (ноль для отрицательного или
+ *         не помещающегося в 256 бит)
  */
-[[nodiscard]] uint256 bits_to_target(uint32_t bits) noexcept;
+[[nodiscard]] constexpr uint256 bits_to_target(uint32_t bits) noexcept {
+    const uint32_t exponent = bits >> 24;
+    const uint32_t mantissa = bits & 0x007FFFFF;
+    
+    // Отрицательный флаг не должен быть установлен
+    if (bits & 0x00800000) {
+        return uint256::zero();
+    }
+    if (exponent <= 3) {
+        return uint256{uint64_t{mantissa >> (8 * (3 - exponent))}};
+    }
+    // Мантисса (3 байта) должна поместиться целиком
+    if (exponent - 3 > 32 - 3) {
+        return uint256::zero();
+    }
+    return uint256{uint64_t{mantissa}} << (8 * (exponent - 3));
+}
 
 /**
  * @brief Преобразовать 256-битный target в compact bits
@@ -175,7 +194,40 @@ struct BlockHeader {
  * @param target 256-битный target
  * @return uint32_t Compact representation
  */
-[[nodiscard]] uint32_t target_to_bits(const uint256& target) noexcept;
+[[nodiscard]] constexpr uint32_t target_to_bits(const uint256& target) noexcept {
+    // Значащих байт (у нуля - один)
+    uint32_t exponent = std::max((target.bits() + 7) / 8, 1u);
+    
+    uint32_t mantissa = exponent <= 3
+        ? static_cast<uint32_t>(target.low64() << (8 * (3 - exponent)))
+        : static_cast<uint32_t>((target >> (8 * (exponent - 3))).low64());
+    mantissa &= 0x00FFFFFF;
+    
+    // Если старший бит мантиссы установлен, сдвигаем
+    if (mantissa & 0x00800000) {
+        mantissa >>= 8;
+        exponent++;
+    }
+    
+    return (exponent << 24) | mantissa;
+}
+
+/**
+ * @brief Работа блока: ожидаемое число хешей, 2^256 / (target + 1)
+ * 
+ * Как GetBlockProof в Bitcoin Core: ~target / (target + 1) + 1, без
+ * 257-битного делимого. Сумма по цепи - chainwork.
+ * 
+ * @param bits Compact target
+ * @return uint256 Работа (ноль для некорректного target)
+ */
+[[nodiscard]] constexpr uint256 block_work(uint32_t bits) noexcept {
+    const auto target = bits_to_target(bits);
+    if (target.is_zero()) {
+        return uint256::zero();
+    }
+    return ~target / (target + uint256::one()) + uint256::one();
+}
 
 /**
  * @brief Вычислить сложность из compact bits
@@ -185,4 +237,22 @@ struct BlockHeader {
  */
 [[nodiscard]] double bits_to_difficulty(uint32_t bits) noexcept;
 
+/**
+ * @brief Хеши пачки заголовков
+ * 
+ * Для проверки заголовков при синхронизации: midstate каждого
+ * заголовка, затем пакетный SHA256d хвостов
+ * (crypto::hash_headers_with_midstate_batch).
+ * 
+ * @param headers Заголовки
+ * @param out Хеши (out[i] == headers[i].hash())
+ * @return Количество вычисленных хешей (минимум из размеров)
+ */
+std::size_t hash_headers(std::span<const BlockHeader> headers, std::span<Hash256> out) noexcept;
+
+template<>
+struct serialization::serialized_size<BlockHeader> {
+    static constexpr std::size_t value = BLOCK_HEADER_SIZE;
+};
+
 } // namespace quaxis::core
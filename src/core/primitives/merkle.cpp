@@ -6,11 +6,28 @@
 #include "merkle.hpp"
 #include "../../crypto/sha256.hpp"
 
+#include <bit>
 #include <cstring>
 #include <stdexcept>
 
 namespace quaxis::core {
 
+namespace {
+
+static_assert(sizeof(Hash256) == 32, "уровень дерева должен быть непрерывным массивом пар");
+
+/**
+ * @brief Хешировать пары уровня: out[i] = merkle_hash(level[2i], level[2i+1])
+ * 
+ * Соседние хеши уровня уже лежат подряд, и каждая пара - готовое
+ * 64-байтное сообщение.
+ */
+void hash_level(const Hash256* level, std::size_t pairs, Hash256* out) noexcept {
+    (void)crypto::sha256d64_batch(ByteSpan(level->data(), pairs * 64), std::span<Hash256>(out, pairs));
+}
+
+} // anonymous namespace
+
 Hash256 MerkleBranch::compute_root(const Hash256& leaf_hash) const noexcept {
     Hash256 current = leaf_hash;
     uint32_t idx = index;
@@ -38,23 +55,9 @@ bool MerkleBranch::verify(
 }
 
 Bytes MerkleBranch::serialize() const {
-    Bytes result;
-    
-    // Количество хешей (varint, упрощённо 1 байт)
-    result.push_back(static_cast<uint8_t>(hashes.size()));
-    
-    // Хеши
-    for (const auto& hash : hashes) {
-        result.insert(result.end(), hash.begin(), hash.end());
-    }
-    
-    // Индекс (4 байта, little-endian)
-    result.push_back(static_cast<uint8_t>(index));
-    result.push_back(static_cast<uint8_t>(index >> 8));
-    result.push_back(static_cast<uint8_t>(index >> 16));
-    result.push_back(static_cast<uint8_t>(index >> 24));
-    
-    return result;
+    serialization::WriteStream out(serialized_length());
+    write_to(out);
+    return out.take_data();
 }
 
 MerkleBranch MerkleBranch::deserialize(ByteSpan data) {
@@ -89,6 +92,66 @@ MerkleBranch MerkleBranch::deserialize(ByteSpan data) {
     return branch;
 }
 
+Hash256 MerkleBranchView::hash(std::size_t i) const noexcept {
+    Hash256 result;
+    std::memcpy(result.data(), hashes.data() + i * 32, 32);
+    return result;
+}
+
+Hash256 MerkleBranchView::compute_root(const Hash256& leaf_hash) const noexcept {
+    Hash256 current = leaf_hash;
+    uint32_t idx = index;
+    
+    for (std::size_t i = 0; i < size(); ++i) {
+        Hash256 sibling = hash(i);
+        if (idx & 1) {
+            current = merkle_hash(sibling, current);
+        } else {
+            current = merkle_hash(current, sibling);
+        }
+        idx >>= 1;
+    }
+    
+    return current;
+}
+
+bool MerkleBranchView::verify(
+    const Hash256& leaf_hash,
+    const Hash256& expected_root
+) const noexcept {
+    return compute_root(leaf_hash) == expected_root;
+}
+
+MerkleBranch MerkleBranchView::to_branch() const {
+    MerkleBranch branch;
+    branch.hashes.reserve(size());
+    for (std::size_t i = 0; i < size(); ++i) {
+        branch.hashes.push_back(hash(i));
+    }
+    branch.index = index;
+    return branch;
+}
+
+std::optional<MerkleBranchView> MerkleBranchView::parse(ByteSpan data) noexcept {
+    if (data.empty()) {
+        return std::nullopt;
+    }
+    
+    std::size_t hashes_size = static_cast<std::size_t>(data[0]) * 32;
+    if (data.size() < 1 + hashes_size + 4) {
+        return std::nullopt;
+    }
+    
+    MerkleBranchView view;
+    view.hashes = data.subspan(1, hashes_size);
+    const uint8_t* idx = data.data() + 1 + hashes_size;
+    view.index = static_cast<uint32_t>(idx[0]) |
+                 (static_cast<uint32_t>(idx[1]) << 8) |
+                 (static_cast<uint32_t>(idx[2]) << 16) |
+                 (static_cast<uint32_t>(idx[3]) << 24);
+    return view;
+}
+
 MerkleTree::MerkleTree(std::vector<Hash256> leaves) 
     : leaf_count_(leaves.size()) {
     if (leaves.empty()) {
@@ -101,23 +164,18 @@ MerkleTree::MerkleTree(std::vector<Hash256> leaves)
         leaves.push_back(leaves.back());
     }
     
-    // Копируем листья
+    // Копируем листья; полное дерево из n листьев - 2n - 1 узлов
     nodes_ = std::move(leaves);
+    std::size_t level_size = nodes_.size();
+    nodes_.resize(level_size * 2 - 1);
     
-    // Строим дерево снизу вверх
+    // Строим дерево снизу вверх, уровень за раз
     std::size_t level_start = 0;
-    std::size_t level_size = nodes_.size();
     
     while (level_size > 1) {
         std::size_t next_level_size = level_size / 2;
         
-        for (std::size_t i = 0; i < next_level_size; ++i) {
-            auto combined = merkle_hash(
-                nodes_[level_start + i * 2],
-                nodes_[level_start + i * 2 + 1]
-            );
-            nodes_.push_back(combined);
-        }
+        hash_level(nodes_.data() + level_start, next_level_size, nodes_.data() + level_start + level_size);
         
         level_start += level_size;
         level_size = next_level_size;
@@ -186,6 +244,127 @@ const std::vector<Hash256>& MerkleTree::nodes() const noexcept {
     return nodes_;
 }
 
+// =============================================================================
+// IncrementalMerkleTree
+// =============================================================================
+
+IncrementalMerkleTree::IncrementalMerkleTree(std::size_t leaf_count) {
+    reset(leaf_count);
+}
+
+void IncrementalMerkleTree::reset(std::size_t leaf_count) {
+    capacity_ = 0;
+    nodes_.clear();
+    if (leaf_count == 0) {
+        return;
+    }
+    
+    capacity_ = std::bit_ceil(leaf_count);
+    nodes_.assign(capacity_ * 2, Hash256{});
+    
+    // Все листья нулевые: узлы уровня одинаковы, хеш на уровень
+    std::size_t level = capacity_;
+    while (level > 1) {
+        Hash256 parent = merkle_hash(nodes_[level], nodes_[level + 1]);
+        level /= 2;
+        std::fill(nodes_.begin() + static_cast<std::ptrdiff_t>(level),
+                  nodes_.begin() + static_cast<std::ptrdiff_t>(level * 2), parent);
+    }
+}
+
+void IncrementalMerkleTree::rehash(std::size_t node) noexcept {
+    nodes_[node] = merkle_hash(nodes_[node * 2], nodes_[node * 2 + 1]);
+}
+
+void IncrementalMerkleTree::set_leaf(std::size_t index, const Hash256& hash) {
+    if (index >= capacity_) {
+        throw std::out_of_range("IncrementalMerkleTree: leaf index out of range");
+    }
+    
+    std::size_t node = capacity_ + index;
+    if (nodes_[node] == hash) {
+        return;
+    }
+    
+    nodes_[node] = hash;
+    for (node /= 2; node >= 1; node /= 2) {
+        rehash(node);
+    }
+}
+
+std::size_t IncrementalMerkleTree::update(std::span<const Hash256> leaves) {
+    if (leaves.size() > capacity_) {
+        throw std::out_of_range("IncrementalMerkleTree: too many leaves");
+    }
+    
+    // Изменённые листья -> их родители (возрастают, без повторов)
+    dirty_.clear();
+    std::size_t changed = 0;
+    for (std::size_t i = 0; i < capacity_; ++i) {
+        const Hash256 value = i < leaves.size() ? leaves[i] : Hash256{};
+        Hash256& node = nodes_[capacity_ + i];
+        if (node == value) {
+            continue;
+        }
+        node = value;
+        ++changed;
+        std::size_t parent = (capacity_ + i) / 2;
+        if (parent >= 1 && (dirty_.empty() || dirty_.back() != parent)) {
+            dirty_.push_back(parent);
+        }
+    }
+    
+    // Уровень за уровнем: пары детей подряд -> sha256d64_batch
+    while (!dirty_.empty()) {
+        pairs_.resize(dirty_.size() * 2);
+        digests_.resize(dirty_.size());
+        for (std::size_t k = 0; k < dirty_.size(); ++k) {
+            pairs_[2 * k] = nodes_[dirty_[k] * 2];
+            pairs_[2 * k + 1] = nodes_[dirty_[k] * 2 + 1];
+        }
+        hash_level(pairs_.data(), dirty_.size(), digests_.data());
+        
+        std::size_t next = 0;
+        for (std::size_t k = 0; k < dirty_.size(); ++k) {
+            nodes_[dirty_[k]] = digests_[k];
+            std::size_t parent = dirty_[k] / 2;
+            if (parent >= 1 && (next == 0 || dirty_[next - 1] != parent)) {
+                dirty_[next++] = parent;
+            }
+        }
+        dirty_.resize(next);
+    }
+    
+    return changed;
+}
+
+const Hash256& IncrementalMerkleTree::root() const noexcept {
+    // При capacity 1 nodes_[1] - единственный лист
+    return capacity_ == 0 ? empty_root_ : nodes_[1];
+}
+
+const Hash256& IncrementalMerkleTree::leaf(std::size_t index) const noexcept {
+    return index < capacity_ ? nodes_[capacity_ + index] : empty_root_;
+}
+
+MerkleBranch IncrementalMerkleTree::get_branch(std::size_t index) const {
+    MerkleBranch branch;
+    if (index >= capacity_) {
+        return branch;
+    }
+    
+    branch.index = static_cast<uint32_t>(index);
+    branch.hashes.reserve(depth());
+    for (std::size_t node = capacity_ + index; node > 1; node /= 2) {
+        branch.hashes.push_back(nodes_[node ^ 1]);
+    }
+    return branch;
+}
+
+std::size_t IncrementalMerkleTree::depth() const noexcept {
+    return capacity_ > 1 ? static_cast<std::size_t>(std::countr_zero(capacity_)) : 0;
+}
+
 Hash256 compute_merkle_root(std::vector<Hash256> leaves) noexcept {
     if (leaves.empty()) {
         return Hash256{};
@@ -201,12 +380,8 @@ Hash256 compute_merkle_root(std::vector<Hash256> leaves) noexcept {
             leaves.push_back(leaves.back());
         }
         
-        std::vector<Hash256> next_level;
-        next_level.reserve(leaves.size() / 2);
-        
-        for (std::size_t i = 0; i < leaves.size(); i += 2) {
-            next_level.push_back(merkle_hash(leaves[i], leaves[i + 1]));
-        }
+        std::vector<Hash256> next_level(leaves.size() / 2);
+        hash_level(leaves.data(), next_level.size(), next_level.data());
         
         leaves = std::move(next_level);
     }
@@ -10,9 +10,11 @@
 
 #include "../types.hpp"
 #include "uint256.hpp"
+#include "../serialization/stream.hpp"
 
 #include <vector>
 #include <span>
+#include <optional>
 
 namespace quaxis::core {
 
@@ -55,6 +57,27 @@ struct MerkleBranch {
      */
     [[nodiscard]] Bytes serialize() const;
     
+    /**
+     * @brief Записать branch в поток (WriteStream или FixedWriteStream)
+     * 
+     * Формат serialize(): 1 байт количества, хеши, 4 байта индекса.
+     */
+    template<typename Stream>
+    void write_to(Stream& out) const {
+        out.write_u8(static_cast<uint8_t>(hashes.size()));
+        for (const auto& hash : hashes) {
+            out.write_hash256(hash);
+        }
+        out.write_u32_le(index);
+    }
+    
+    /**
+     * @brief Размер сериализации (байт)
+     */
+    [[nodiscard]] std::size_t serialized_length() const noexcept {
+        return 1 + hashes.size() * 32 + 4;
+    }
+    
     /**
      * @brief Десериализовать branch
      * 
@@ -64,6 +87,61 @@ struct MerkleBranch {
     [[nodiscard]] static MerkleBranch deserialize(ByteSpan data);
 };
 
+/**
+ * @brief Merkle branch поверх сериализованных данных
+ * 
+ * Не владеет памятью: hashes - view на хеши во входном буфере (формат
+ * MerkleBranch::serialize()), буфер должен пережить view. parse()
+ * проверяет только длину, хеши читаются при compute_root().
+ */
+struct MerkleBranchView {
+    /// @brief Хеши подряд (size() * 32 байт)
+    ByteSpan hashes;
+    
+    /// @brief Индекс позиции (битовая маска: 0=лево, 1=право)
+    uint32_t index{0};
+    
+    /**
+     * @brief Количество хешей
+     */
+    [[nodiscard]] std::size_t size() const noexcept { return hashes.size() / 32; }
+    
+    /**
+     * @brief Хеш i (копия 32 байт)
+     */
+    [[nodiscard]] Hash256 hash(std::size_t i) const noexcept;
+    
+    /**
+     * @brief Вычислить корень (как MerkleBranch::compute_root)
+     */
+    [[nodiscard]] Hash256 compute_root(const Hash256& leaf_hash) const noexcept;
+    
+    [[nodiscard]] bool verify(
+        const Hash256& leaf_hash,
+        const Hash256& expected_root
+    ) const noexcept;
+    
+    /**
+     * @brief Размер сериализации (байт)
+     */
+    [[nodiscard]] std::size_t serialized_length() const noexcept {
+        return 1 + hashes.size() + 4;
+    }
+    
+    /**
+     * @brief Скопировать в MerkleBranch
+     */
+    [[nodiscard]] MerkleBranch to_branch() const;
+    
+    /**
+     * @brief Разобрать branch с начала data
+     * 
+     * @param data Данные (могут продолжаться после branch)
+     * @return View или nullopt при нехватке данных
+     */
+    [[nodiscard]] static std::optional<MerkleBranchView> parse(ByteSpan data) noexcept;
+};
+
 /**
  * @brief Merkle tree
  * 
@@ -113,6 +191,93 @@ private:
     std::size_t leaf_count_;
 };
 
+/**
+ * @brief Merkle tree с кешированными внутренними узлами
+ * 
+ * Для деревьев, где между запросами меняются один-два листа (дерево
+ * слотов aux chains): set_leaf()/update() пересчитывают только пути от
+ * изменённых листьев к корню, get_branch() - O(log n) без перестройки.
+ * 
+ * Размер - степень двойки, пустые листья нулевые (как слоты AuxPoW
+ * дерева; дублирования последнего листа, как в MerkleTree, нет).
+ * Узлы - куча: nodes_[1] - корень, листья с nodes_[capacity].
+ */
+class IncrementalMerkleTree {
+public:
+    /**
+     * @brief Пустое дерево (capacity 0, нулевой корень)
+     */
+    IncrementalMerkleTree() = default;
+    
+    /**
+     * @brief Дерево из нулевых листьев
+     * 
+     * @param leaf_count Количество листьев (округляется до степени двойки)
+     */
+    explicit IncrementalMerkleTree(std::size_t leaf_count);
+    
+    /**
+     * @brief Перестроить с нулевыми листьями
+     */
+    void reset(std::size_t leaf_count);
+    
+    /**
+     * @brief Заменить лист (O(log n) хешей, без изменений - ничего)
+     * 
+     * @param index Индекс листа (< capacity)
+     * @param hash Новый хеш
+     */
+    void set_leaf(std::size_t index, const Hash256& hash);
+    
+    /**
+     * @brief Привести листья к leaves
+     * 
+     * Листья за leaves.size() обнуляются. Общие родители изменённых
+     * листьев пересчитываются один раз, узлы уровня - пачкой.
+     * 
+     * @param leaves Новые листья (не больше capacity)
+     * @return Количество изменённых листьев
+     */
+    std::size_t update(std::span<const Hash256> leaves);
+    
+    /**
+     * @brief Корень дерева
+     */
+    [[nodiscard]] const Hash256& root() const noexcept;
+    
+    /**
+     * @brief Лист по индексу
+     */
+    [[nodiscard]] const Hash256& leaf(std::size_t index) const noexcept;
+    
+    /**
+     * @brief Branch листа (O(log n))
+     */
+    [[nodiscard]] MerkleBranch get_branch(std::size_t index) const;
+    
+    /**
+     * @brief Количество листьев (степень двойки)
+     */
+    [[nodiscard]] std::size_t capacity() const noexcept { return capacity_; }
+    
+    /**
+     * @brief Глубина (длина branch)
+     */
+    [[nodiscard]] std::size_t depth() const noexcept;
+    
+private:
+    void rehash(std::size_t node) noexcept;
+    
+    std::vector<Hash256> nodes_;
+    std::size_t capacity_{0};
+    Hash256 empty_root_{};
+    
+    // Узлы уровня для пачечного пересчёта в update()
+    std::vector<std::size_t> dirty_;
+    std::vector<Hash256> pairs_;
+    std::vector<Hash256> digests_;
+};
+
 // =============================================================================
 // Вспомогательные функции
 // =============================================================================
@@ -30,7 +30,7 @@ std::string uint256::to_hex() const {
     oss << std::hex << std::setfill('0');
     // Big-endian (старшие байты сначала)
     for (std::size_t i = SIZE; i-- > 0;) {
-        oss << std::setw(2) << static_cast<unsigned>(data_[i]);
+        oss << std::setw(2) << static_cast<unsigned>((*this)[i]);
     }
     return oss.str();
 }
@@ -40,7 +40,7 @@ std::string uint256::to_hex_le() const {
     oss << std::hex << std::setfill('0');
     // Little-endian (младшие байты сначала)
     for (std::size_t i = 0; i < SIZE; ++i) {
-        oss << std::setw(2) << static_cast<unsigned>(data_[i]);
+        oss << std::setw(2) << static_cast<unsigned>((*this)[i]);
     }
     return oss.str();
 }
@@ -55,7 +55,7 @@ uint256 uint256::from_hex(std::string_view hex) {
         std::size_t hex_idx = (SIZE - 1 - i) * 2;
         char high = hex[hex_idx];
         char low = hex[hex_idx + 1];
-        result.data_[i] = static_cast<uint8_t>((hex_char_to_int(high) << 4) | hex_char_to_int(low));
+        result[i] = static_cast<uint8_t>((hex_char_to_int(high) << 4) | hex_char_to_int(low));
     }
     
     return result;
@@ -71,7 +71,7 @@ uint256 uint256::from_hex_le(std::string_view hex) {
         std::size_t hex_idx = i * 2;
         char high = hex[hex_idx];
         char low = hex[hex_idx + 1];
-        result.data_[i] = static_cast<uint8_t>((hex_char_to_int(high) << 4) | hex_char_to_int(low));
+        result[i] = static_cast<uint8_t>((hex_char_to_int(high) << 4) | hex_char_to_int(low));
     }
     
     return result;
@@ -4,6 +4,12 @@
  * 
  * Предоставляет тип для работы с 256-битными числами,
  * используемыми в Bitcoin для хешей и targets.
+ * 
+ * Хранение - 4 слова uint64 (младшее первым), арифметика по словам.
+ * Все операции constexpr: targets и pow limits считаются при компиляции.
+ * Вне constant evaluation сложение и вычитание идут через
+ * _addcarry_u64 / _subborrow_u64, умножение - через _mulx_u64 (BMI2)
+ * или unsigned __int128.
  */
 
 #pragma once
@@ -11,14 +17,77 @@
 #include "../types.hpp"
 
 #include <array>
+#include <bit>
 #include <cstdint>
 #include <string>
 #include <string_view>
 #include <algorithm>
 #include <compare>
 
+#if defined(__x86_64__)
+#include <x86intrin.h>
+#endif
+
 namespace quaxis::core {
 
+static_assert(std::endian::native == std::endian::little,
+              "uint256: байтовый доступ рассчитан на little-endian");
+
+namespace detail {
+
+__extension__ typedef unsigned __int128 uint128_t;
+
+/**
+ * @brief a + b + carry, перенос - в carry
+ */
+[[nodiscard]] constexpr uint64_t add_carry(uint64_t a, uint64_t b, uint8_t& carry) noexcept {
+#if defined(__x86_64__)
+    if !consteval {
+        unsigned long long out;
+        carry = _addcarry_u64(carry, a, b, &out);
+        return out;
+    }
+#endif
+    const uint128_t sum = static_cast<uint128_t>(a) + b + carry;
+    carry = static_cast<uint8_t>(sum >> 64);
+    return static_cast<uint64_t>(sum);
+}
+
+/**
+ * @brief a - b - borrow, заём - в borrow
+ */
+[[nodiscard]] constexpr uint64_t sub_borrow(uint64_t a, uint64_t b, uint8_t& borrow) noexcept {
+#if defined(__x86_64__)
+    if !consteval {
+        unsigned long long out;
+        borrow = _subborrow_u64(borrow, a, b, &out);
+        return out;
+    }
+#endif
+    const uint128_t diff = static_cast<uint128_t>(a) - b - borrow;
+    borrow = static_cast<uint8_t>((diff >> 64) & 1);
+    return static_cast<uint64_t>(diff);
+}
+
+/**
+ * @brief Полное произведение a * b: младшее слово - результат, старшее - в hi
+ */
+[[nodiscard]] constexpr uint64_t mul_wide(uint64_t a, uint64_t b, uint64_t& hi) noexcept {
+#if defined(__x86_64__) && defined(__BMI2__)
+    if !consteval {
+        unsigned long long high;
+        const uint64_t low = _mulx_u64(a, b, &high);
+        hi = high;
+        return low;
+    }
+#endif
+    const uint128_t product = static_cast<uint128_t>(a) * b;
+    hi = static_cast<uint64_t>(product >> 64);
+    return static_cast<uint64_t>(product);
+}
+
+} // namespace detail
+
 /**
  * @brief 256-битное беззнаковое целое число
  * 
@@ -27,31 +96,37 @@ namespace quaxis::core {
  * - Хешей блоков и транзакций
  * - Targets (порогов сложности)
  * - Сравнения proof-of-work
+ * - Работы цепи (chainwork) и пересчёта сложности
+ * 
+ * Арифметика по модулю 2^256 (как у беззнаковых встроенных типов),
+ * деление на ноль даёт ноль.
  */
 class uint256 {
 public:
     /// @brief Размер в байтах
     static constexpr std::size_t SIZE = 32;
     
+    /// @brief Количество 64-битных слов
+    static constexpr std::size_t LIMBS = 4;
+    
+    /// @brief Слова числа, младшее первым
+    using Limbs = std::array<uint64_t, LIMBS>;
+    
     /// @brief Конструктор по умолчанию (нулевое значение)
-    constexpr uint256() noexcept : data_{} {}
+    constexpr uint256() noexcept : limbs_{} {}
     
     /// @brief Конструктор из массива байт
-    constexpr explicit uint256(const Hash256& hash) noexcept : data_(hash) {}
-    
-    /// @brief Конструктор из массива байт (rvalue)
-    constexpr explicit uint256(Hash256&& hash) noexcept : data_(std::move(hash)) {}
+    constexpr explicit uint256(const Hash256& hash) noexcept
+        : limbs_(std::bit_cast<Limbs>(hash)) {}
     
     /// @brief Конструктор из 64-битного числа
-    constexpr explicit uint256(uint64_t value) noexcept : data_{} {
-        data_[0] = static_cast<uint8_t>(value);
-        data_[1] = static_cast<uint8_t>(value >> 8);
-        data_[2] = static_cast<uint8_t>(value >> 16);
-        data_[3] = static_cast<uint8_t>(value >> 24);
-        data_[4] = static_cast<uint8_t>(value >> 32);
-        data_[5] = static_cast<uint8_t>(value >> 40);
-        data_[6] = static_cast<uint8_t>(value >> 48);
-        data_[7] = static_cast<uint8_t>(value >> 56);
+    constexpr explicit uint256(uint64_t value) noexcept : limbs_{value, 0, 0, 0} {}
+    
+    /// @brief Создать из слов (младшее первым)
+    [[nodiscard]] static constexpr uint256 from_limbs(const Limbs& limbs) noexcept {
+        uint256 result;
+        result.limbs_ = limbs;
+        return result;
     }
     
     // =========================================================================
@@ -61,15 +136,15 @@ public:
     /**
      * @brief Получить указатель на данные
      */
-    [[nodiscard]] constexpr const uint8_t* data() const noexcept {
-        return data_.data();
+    [[nodiscard]] const uint8_t* data() const noexcept {
+        return reinterpret_cast<const uint8_t*>(limbs_.data());
     }
     
     /**
      * @brief Получить изменяемый указатель на данные
      */
-    [[nodiscard]] constexpr uint8_t* data() noexcept {
-        return data_.data();
+    [[nodiscard]] uint8_t* data() noexcept {
+        return reinterpret_cast<uint8_t*>(limbs_.data());
     }
     
     /**
@@ -83,31 +158,66 @@ public:
      * @brief Получить байт по индексу
      */
     [[nodiscard]] constexpr uint8_t operator[](std::size_t i) const noexcept {
-        return data_[i];
+        return static_cast<uint8_t>(limbs_[i / 8] >> (8 * (i % 8)));
     }
     
     /**
      * @brief Получить изменяемый байт по индексу
      */
-    [[nodiscard]] constexpr uint8_t& operator[](std::size_t i) noexcept {
-        return data_[i];
+    [[nodiscard]] uint8_t& operator[](std::size_t i) noexcept {
+        return data()[i];
+    }
+    
+    /**
+     * @brief Получить 64-битное слово (0 - младшее)
+     */
+    [[nodiscard]] constexpr uint64_t limb(std::size_t i) const noexcept {
+        return limbs_[i];
+    }
+    
+    /**
+     * @brief Младшие 64 бита
+     */
+    [[nodiscard]] constexpr uint64_t low64() const noexcept {
+        return limbs_[0];
     }
     
     /**
      * @brief Преобразовать в Hash256
      */
-    [[nodiscard]] constexpr const Hash256& to_hash256() const noexcept {
-        return data_;
+    [[nodiscard]] constexpr Hash256 to_hash256() const noexcept {
+        return std::bit_cast<Hash256>(limbs_);
     }
     
     /**
      * @brief Проверить, является ли нулём
      */
     [[nodiscard]] constexpr bool is_zero() const noexcept {
-        for (auto b : data_) {
-            if (b != 0) return false;
+        return (limbs_[0] | limbs_[1] | limbs_[2] | limbs_[3]) == 0;
+    }
+    
+    /**
+     * @brief Количество значащих бит (0 для нуля)
+     */
+    [[nodiscard]] constexpr unsigned bits() const noexcept {
+        for (std::size_t i = LIMBS; i-- > 0;) {
+            if (limbs_[i] != 0) {
+                return static_cast<unsigned>(64 * i) + static_cast<unsigned>(std::bit_width(limbs_[i]));
+            }
         }
-        return true;
+        return 0;
+    }
+    
+    /**
+     * @brief Приближённое значение в double (для сложности)
+     */
+    [[nodiscard]] constexpr double to_double() const noexcept {
+        constexpr double TWO64 = 18446744073709551616.0;
+        double result = 0;
+        for (std::size_t i = LIMBS; i-- > 0;) {
+            result = result * TWO64 + static_cast<double>(limbs_[i]);
+        }
+        return result;
     }
     
     // =========================================================================
@@ -117,26 +227,243 @@ public:
     /**
      * @brief Оператор сравнения (трёхстороннее)
      * 
-     * Сравнивает числа как big-endian (старшие байты сначала).
+     * Сравнивает числа как big-endian (старшие слова сначала).
      */
     [[nodiscard]] constexpr std::strong_ordering operator<=>(
         const uint256& other
     ) const noexcept {
-        // Сравниваем с конца (big-endian)
-        for (std::size_t i = SIZE; i-- > 0;) {
-            if (data_[i] < other.data_[i]) return std::strong_ordering::less;
-            if (data_[i] > other.data_[i]) return std::strong_ordering::greater;
+        for (std::size_t i = LIMBS; i-- > 0;) {
+            if (limbs_[i] != other.limbs_[i]) {
+                return limbs_[i] <=> other.limbs_[i];
+            }
         }
         return std::strong_ordering::equal;
     }
     
+    /**
+     * @brief a < b (без промежуточного strong_ordering)
+     */
+    [[nodiscard]] friend constexpr bool operator<(const uint256& a, const uint256& b) noexcept {
+        for (std::size_t i = LIMBS - 1; i > 0; --i) {
+            if (a.limbs_[i] != b.limbs_[i]) {
+                return a.limbs_[i] < b.limbs_[i];
+            }
+        }
+        return a.limbs_[0] < b.limbs_[0];
+    }
+    
+    [[nodiscard]] friend constexpr bool operator>(const uint256& a, const uint256& b) noexcept { return b < a; }
+    [[nodiscard]] friend constexpr bool operator<=(const uint256& a, const uint256& b) noexcept { return !(b < a); }
+    [[nodiscard]] friend constexpr bool operator>=(const uint256& a, const uint256& b) noexcept { return !(a < b); }
+    
     /**
      * @brief Оператор равенства
      */
     [[nodiscard]] constexpr bool operator==(const uint256& other) const noexcept {
-        return data_ == other.data_;
+        return ((limbs_[0] ^ other.limbs_[0]) | (limbs_[1] ^ other.limbs_[1]) |
+                (limbs_[2] ^ other.limbs_[2]) | (limbs_[3] ^ other.limbs_[3])) == 0;
+    }
+    
+    // =========================================================================
+    // Арифметика
+    // =========================================================================
+    
+    constexpr uint256& operator+=(const uint256& other) noexcept {
+        uint8_t carry = 0;
+        for (std::size_t i = 0; i < LIMBS; ++i) {
+            limbs_[i] = detail::add_carry(limbs_[i], other.limbs_[i], carry);
+        }
+        return *this;
+    }
+    
+    constexpr uint256& operator-=(const uint256& other) noexcept {
+        uint8_t borrow = 0;
+        for (std::size_t i = 0; i < LIMBS; ++i) {
+            limbs_[i] = detail::sub_borrow(limbs_[i], other.limbs_[i], borrow);
+        }
+        return *this;
+    }
+    
+    /**
+     * @brief Умножение на 64-битное число (одна строка произведений)
+     */
+    constexpr uint256& operator*=(uint64_t factor) noexcept {
+        uint64_t carry = 0;
+        for (std::size_t i = 0; i < LIMBS; ++i) {
+            uint64_t hi = 0;
+            const uint64_t lo = detail::mul_wide(limbs_[i], factor, hi);
+            uint8_t c = 0;
+            limbs_[i] = detail::add_carry(lo, carry, c);
+            carry = hi + c;
+        }
+        return *this;
+    }
+    
+    /**
+     * @brief Умножение (младшие 256 бит произведения)
+     * 
+     * Школьное умножение по словам: 10 произведений 64x64 -> 128,
+     * старшие части сразу отбрасываются.
+     */
+    constexpr uint256& operator*=(const uint256& other) noexcept {
+        Limbs result{};
+        for (std::size_t i = 0; i < LIMBS; ++i) {
+            uint64_t carry = 0;
+            for (std::size_t j = 0; i + j < LIMBS; ++j) {
+                uint64_t hi = 0;
+                uint64_t lo = detail::mul_wide(limbs_[i], other.limbs_[j], hi);
+                uint8_t c = 0;
+                lo = detail::add_carry(lo, carry, c);
+                hi += c;
+                c = 0;
+                result[i + j] = detail::add_carry(result[i + j], lo, c);
+                carry = hi + c;
+            }
+        }
+        limbs_ = result;
+        return *this;
+    }
+    
+    /**
+     * @brief Деление на 64-битное число, остаток - в remainder
+     */
+    constexpr uint256& divide(uint64_t divisor, uint64_t& remainder) noexcept {
+        remainder = 0;
+        if (divisor == 0) {
+            limbs_ = {};
+            return *this;
+        }
+        for (std::size_t i = LIMBS; i-- > 0;) {
+            const detail::uint128_t part = (static_cast<detail::uint128_t>(remainder) << 64) | limbs_[i];
+            limbs_[i] = static_cast<uint64_t>(part / divisor);
+            remainder = static_cast<uint64_t>(part % divisor);
+        }
+        return *this;
+    }
+    
+    /**
+     * @brief Деление с остатком
+     * 
+     * Делитель из одного слова - деление по словам через 128/64,
+     * иначе сдвиг-вычитание начиная с разницы длин (не больше 192 шагов:
+     * у делителя не меньше 65 бит).
+     */
+    constexpr uint256& divide(const uint256& divisor, uint256& remainder) noexcept {
+        if (divisor.bits() <= 64) {
+            uint64_t rem = 0;
+            divide(divisor.limbs_[0], rem);
+            remainder = uint256{rem};
+            return *this;
+        }
+        remainder = *this;
+        limbs_ = {};
+        const unsigned divisor_bits = divisor.bits();
+        const unsigned num_bits = remainder.bits();
+        if (num_bits < divisor_bits) {
+            return *this;
+        }
+        unsigned shift = num_bits - divisor_bits;
+        uint256 shifted = divisor << shift;
+        for (;;) {
+            if (remainder >= shifted) {
+                remainder -= shifted;
+                limbs_[shift / 64] |= uint64_t{1} << (shift % 64);
+            }
+            if (shift == 0) {
+                break;
+            }
+            shifted >>= 1;
+            --shift;
+        }
+        return *this;
+    }
+    
+    constexpr uint256& operator/=(const uint256& divisor) noexcept {
+        uint256 remainder;
+        return divide(divisor, remainder);
+    }
+    
+    constexpr uint256& operator%=(const uint256& divisor) noexcept {
+        uint256 remainder;
+        divide(divisor, remainder);
+        return *this = remainder;
     }
     
+    // =========================================================================
+    // Битовые операции
+    // =========================================================================
+    
+    constexpr uint256& operator<<=(unsigned shift) noexcept {
+        if (shift >= 256) {
+            limbs_ = {};
+            return *this;
+        }
+        const std::size_t words = shift / 64;
+        const unsigned offset = shift % 64;
+        for (std::size_t i = LIMBS; i-- > 0;) {
+            uint64_t value = 0;
+            if (i >= words) {
+                value = limbs_[i - words] << offset;
+                if (offset != 0 && i > words) {
+                    value |= limbs_[i - words - 1] >> (64 - offset);
+                }
+            }
+            limbs_[i] = value;
+        }
+        return *this;
+    }
+    
+    constexpr uint256& operator>>=(unsigned shift) noexcept {
+        if (shift >= 256) {
+            limbs_ = {};
+            return *this;
+        }
+        const std::size_t words = shift / 64;
+        const unsigned offset = shift % 64;
+        for (std::size_t i = 0; i < LIMBS; ++i) {
+            uint64_t value = 0;
+            if (i + words < LIMBS) {
+                value = limbs_[i + words] >> offset;
+                if (offset != 0 && i + words + 1 < LIMBS) {
+                    value |= limbs_[i + words + 1] << (64 - offset);
+                }
+            }
+            limbs_[i] = value;
+        }
+        return *this;
+    }
+    
+    constexpr uint256& operator&=(const uint256& other) noexcept {
+        for (std::size_t i = 0; i < LIMBS; ++i) limbs_[i] &= other.limbs_[i];
+        return *this;
+    }
+    
+    constexpr uint256& operator|=(const uint256& other) noexcept {
+        for (std::size_t i = 0; i < LIMBS; ++i) limbs_[i] |= other.limbs_[i];
+        return *this;
+    }
+    
+    constexpr uint256& operator^=(const uint256& other) noexcept {
+        for (std::size_t i = 0; i < LIMBS; ++i) limbs_[i] ^= other.limbs_[i];
+        return *this;
+    }
+    
+    [[nodiscard]] constexpr uint256 operator~() const noexcept {
+        return from_limbs({~limbs_[0], ~limbs_[1], ~limbs_[2], ~limbs_[3]});
+    }
+    
+    [[nodiscard]] friend constexpr uint256 operator+(uint256 a, const uint256& b) noexcept { return a += b; }
+    [[nodiscard]] friend constexpr uint256 operator-(uint256 a, const uint256& b) noexcept { return a -= b; }
+    [[nodiscard]] friend constexpr uint256 operator*(uint256 a, const uint256& b) noexcept { return a *= b; }
+    [[nodiscard]] friend constexpr uint256 operator*(uint256 a, uint64_t b) noexcept { return a *= b; }
+    [[nodiscard]] friend constexpr uint256 operator/(uint256 a, const uint256& b) noexcept { return a /= b; }
+    [[nodiscard]] friend constexpr uint256 operator%(uint256 a, const uint256& b) noexcept { return a %= b; }
+    [[nodiscard]] friend constexpr uint256 operator<<(uint256 a, unsigned shift) noexcept { return a <<= shift; }
+    [[nodiscard]] friend constexpr uint256 operator>>(uint256 a, unsigned shift) noexcept { return a >>= shift; }
+    [[nodiscard]] friend constexpr uint256 operator&(uint256 a, const uint256& b) noexcept { return a &= b; }
+    [[nodiscard]] friend constexpr uint256 operator|(uint256 a, const uint256& b) noexcept { return a |= b; }
+    [[nodiscard]] friend constexpr uint256 operator^(uint256 a, const uint256& b) noexcept { return a ^= b; }
+    
     // =========================================================================
     // Строковое представление
     // =========================================================================
@@ -176,11 +503,7 @@ public:
      * @brief Максимальное значение (все биты = 1)
      */
     [[nodiscard]] static constexpr uint256 max() noexcept {
-        uint256 result;
-        for (auto& b : result.data_) {
-            b = 0xFF;
-        }
-        return result;
+        return from_limbs({UINT64_MAX, UINT64_MAX, UINT64_MAX, UINT64_MAX});
     }
     
     /**
@@ -191,7 +514,7 @@ public:
     }
     
 private:
-    Hash256 data_;
+    Limbs limbs_;
 };
 
 } // namespace quaxis::core
@@ -0,0 +1,96 @@
+/**
+ * @file seqlock.hpp
+ * @brief Seqlock-снимок trivially copyable структуры
+ *
+ * Статистика подсистем обновляется горячими потоками под их собственными
+ * mutex, а читается редко (терминал, /metrics). Seqlock отделяет читателей:
+ * писатель, закончив изменение, публикует копию, читатели копируют её без
+ * блокировок и никогда не задерживают писателя.
+ *
+ * Как в JobTable, содержимое хранится массивом std::atomic<uint64_t> и
+ * копируется relaxed-операциями между двумя чтениями счётчика.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace quaxis::core {
+
+/**
+ * @brief Снимок значения T с lock-free чтением
+ *
+ * store() вызывает один поток за раз (писатели сериализуются своим mutex);
+ * load() - из любых потоков.
+ */
+template<typename T>
+class Seqlock {
+public:
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "Seqlock требует trivially copyable тип");
+
+    Seqlock() noexcept {
+        store(T{});
+    }
+
+    explicit Seqlock(const T& value) noexcept {
+        store(value);
+    }
+
+    Seqlock(const Seqlock&) = delete;
+    Seqlock& operator=(const Seqlock&) = delete;
+
+    /**
+     * @brief Опубликовать значение
+     */
+    void store(const T& value) noexcept {
+        uint64_t buf[WORDS]{};
+        std::memcpy(buf, &value, sizeof(T));
+
+        const uint32_t s = seq_.load(std::memory_order_relaxed);
+        seq_.store(s + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (std::size_t w = 0; w < WORDS; ++w) {
+            words_[w].store(buf[w], std::memory_order_relaxed);
+        }
+
+        seq_.store(s + 2, std::memory_order_release);
+    }
+
+    /**
+     * @brief Прочитать последнее опубликованное значение
+     *
+     * Повторяет копирование, только если писатель публикует в этот момент.
+     */
+    [[nodiscard]] T load() const noexcept {
+        uint64_t buf[WORDS];
+        for (;;) {
+            const uint32_t s1 = seq_.load(std::memory_order_acquire);
+            if (s1 & 1u) {
+                continue;  // Писатель в процессе записи
+            }
+            for (std::size_t w = 0; w < WORDS; ++w) {
+                buf[w] = words_[w].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (seq_.load(std::memory_order_relaxed) == s1) {
+                break;
+            }
+        }
+        T value;
+        std::memcpy(static_cast<void*>(&value), buf, sizeof(T));
+        return value;
+    }
+
+private:
+    static constexpr std::size_t WORDS = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    std::atomic<uint32_t> seq_{0};
+    std::atomic<uint64_t> words_[WORDS]{};
+};
+
+} // namespace quaxis::core
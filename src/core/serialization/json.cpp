@@ -0,0 +1,297 @@
+/**
+ * @file json.cpp
+ * @brief Реализация чтения JSON по требованию
+ */
+
+#include "json.hpp"
+
+#include <charconv>
+#include <cstring>
+#include <type_traits>
+
+namespace quaxis::core::json {
+
+namespace {
+
+constexpr std::size_t npos = std::string_view::npos;
+
+[[nodiscard]] constexpr bool is_space(char c) noexcept {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+[[nodiscard]] std::size_t skip_space(std::string_view text, std::size_t pos) noexcept {
+    while (pos < text.size() && is_space(text[pos])) {
+        ++pos;
+    }
+    return pos;
+}
+
+/**
+ * @brief Конец строки, начинающейся с кавычки в pos (позиция после закрывающей)
+ *
+ * Кавычка ищется memchr; экранирована она, если перед ней нечётное
+ * число обратных слешей.
+ */
+[[nodiscard]] std::size_t string_end(std::string_view text, std::size_t pos) noexcept {
+    const char* begin = text.data();
+    const char* end = begin + text.size();
+    const char* p = begin + pos + 1;
+    while (p < end) {
+        const auto* quote = static_cast<const char*>(
+            std::memchr(p, '"', static_cast<std::size_t>(end - p)));
+        if (!quote) {
+            return npos;
+        }
+        std::size_t slashes = 0;
+        for (const char* q = quote; q > p && q[-1] == '\\'; --q) {
+            ++slashes;
+        }
+        if (slashes % 2 == 0) {
+            return static_cast<std::size_t>(quote - begin) + 1;
+        }
+        p = quote + 1;
+    }
+    return npos;
+}
+
+/**
+ * @brief Конец контейнера, начинающегося со скобки в pos
+ */
+[[nodiscard]] std::size_t container_end(std::string_view text, std::size_t pos) noexcept {
+    std::size_t depth = 0;
+    while (pos < text.size()) {
+        switch (text[pos]) {
+            case '"':
+                pos = string_end(text, pos);
+                if (pos == npos) {
+                    return npos;
+                }
+                continue;
+            case '{':
+            case '[':
+                ++depth;
+                break;
+            case '}':
+            case ']':
+                if (--depth == 0) {
+                    return pos + 1;
+                }
+                break;
+            default:
+                break;
+        }
+        ++pos;
+    }
+    return npos;
+}
+
+/**
+ * @brief Конец скаляра (число, true, false, null)
+ */
+[[nodiscard]] std::size_t scalar_end(std::string_view text, std::size_t pos) noexcept {
+    while (pos < text.size()) {
+        const char c = text[pos];
+        if (c == ',' || c == '}' || c == ']' || is_space(c)) {
+            break;
+        }
+        ++pos;
+    }
+    return pos;
+}
+
+template<typename T>
+[[nodiscard]] std::optional<T> parse_number(std::string_view raw) noexcept {
+    T value{};
+    const char* end = raw.data() + raw.size();
+    auto [ptr, ec] = std::from_chars(raw.data(), end, value);
+    if (ec != std::errc{} || ptr != end) {
+        return std::nullopt;
+    }
+    return value;
+}
+
+} // anonymous namespace
+
+// =============================================================================
+// Value
+// =============================================================================
+
+Value Value::parse(std::string_view document) noexcept {
+    return at(document);
+}
+
+Value Value::at(std::string_view text) noexcept {
+    const std::size_t pos = skip_space(text, 0);
+    if (pos >= text.size()) {
+        return {};
+    }
+
+    Type type = Type::Invalid;
+    std::size_t end = npos;
+    switch (text[pos]) {
+        case '"':
+            type = Type::String;
+            end = string_end(text, pos);
+            break;
+        case '{':
+            type = Type::Object;
+            end = container_end(text, pos);
+            break;
+        case '[':
+            type = Type::Array;
+            end = container_end(text, pos);
+            break;
+        case 't':
+        case 'f':
+            type = Type::Bool;
+            end = scalar_end(text, pos);
+            break;
+        case 'n':
+            type = Type::Null;
+            end = scalar_end(text, pos);
+            break;
+        default:
+            type = Type::Number;
+            end = scalar_end(text, pos);
+            break;
+    }
+
+    if (end == npos || end == pos) {
+        return {};
+    }
+    return Value(type, text.substr(pos, end - pos));
+}
+
+std::string_view Value::body() const noexcept {
+    if (type_ != Type::Object && type_ != Type::Array) {
+        return {};
+    }
+    return raw_.substr(1, raw_.size() - 2);
+}
+
+Value Value::operator[](std::string_view key) const noexcept {
+    for (const auto& member : members()) {
+        if (member.key == key) {
+            return member.value;
+        }
+    }
+    return {};
+}
+
+Value Value::operator[](std::size_t index) const noexcept {
+    for (const auto& element : elements()) {
+        if (index-- == 0) {
+            return element;
+        }
+    }
+    return {};
+}
+
+std::optional<std::string_view> Value::as_string() const noexcept {
+    if (type_ != Type::String) {
+        return std::nullopt;
+    }
+    return raw_.substr(1, raw_.size() - 2);
+}
+
+std::optional<int64_t> Value::as_int64() const noexcept {
+    if (type_ != Type::Number) {
+        return std::nullopt;
+    }
+    return parse_number<int64_t>(raw_);
+}
+
+std::optional<uint64_t> Value::as_uint64() const noexcept {
+    if (type_ != Type::Number) {
+        return std::nullopt;
+    }
+    return parse_number<uint64_t>(raw_);
+}
+
+std::optional<double> Value::as_double() const noexcept {
+    if (type_ != Type::Number) {
+        return std::nullopt;
+    }
+    return parse_number<double>(raw_);
+}
+
+std::optional<bool> Value::as_bool() const noexcept {
+    if (raw_ == "true") {
+        return true;
+    }
+    if (raw_ == "false") {
+        return false;
+    }
+    return std::nullopt;
+}
+
+Value::Range<Value> Value::elements() const noexcept {
+    if (type_ != Type::Array) {
+        return {};
+    }
+    return {Iterator<Value>(body())};
+}
+
+Value::Range<Member> Value::members() const noexcept {
+    if (type_ != Type::Object) {
+        return {};
+    }
+    return {Iterator<Member>(body())};
+}
+
+// =============================================================================
+// Value::Iterator
+// =============================================================================
+
+template<typename Item>
+void Value::Iterator<Item>::advance() noexcept {
+    // rest_ - тело контейнера после предыдущего элемента: ",  <элемент>..."
+    std::size_t pos = skip_space(rest_, 0);
+    if (pos < rest_.size() && rest_[pos] == ',') {
+        pos = skip_space(rest_, pos + 1);
+    }
+    if (pos >= rest_.size()) {
+        done_ = true;
+        return;
+    }
+
+    if constexpr (std::is_same_v<Item, Member>) {
+        if (rest_[pos] != '"') {
+            done_ = true;
+            return;
+        }
+        const std::size_t key_end = string_end(rest_, pos);
+        if (key_end == npos) {
+            done_ = true;
+            return;
+        }
+        item_.key = rest_.substr(pos + 1, key_end - pos - 2);
+
+        pos = skip_space(rest_, key_end);
+        if (pos >= rest_.size() || rest_[pos] != ':') {
+            done_ = true;
+            return;
+        }
+        rest_ = rest_.substr(pos + 1);
+        item_.value = Value::at(rest_);
+        if (!item_.value) {
+            done_ = true;
+            return;
+        }
+        rest_ = rest_.substr(static_cast<std::size_t>(
+            item_.value.raw_.data() + item_.value.raw_.size() - rest_.data()));
+    } else {
+        rest_ = rest_.substr(pos);
+        item_ = Value::at(rest_);
+        if (!item_) {
+            done_ = true;
+            return;
+        }
+        rest_ = rest_.substr(item_.raw_.size());
+    }
+}
+
+template class Value::Iterator<Value>;
+template class Value::Iterator<Member>;
+
+} // namespace quaxis::core::json
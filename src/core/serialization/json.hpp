@@ -0,0 +1,182 @@
+/**
+ * @file json.hpp
+ * @brief Чтение JSON по требованию (без копий)
+ *
+ * json::Value - view на одно значение внутри буфера ответа: разбор не
+ * строит дерево и не копирует строки. Поиск члена / элемента пропускает
+ * соседние значения целиком: строки - memchr до кавычки (векторизован в
+ * libc), вложенные объекты и массивы - счётчик глубины. Буфер должен
+ * жить, пока используются полученные из него Value и string_view.
+ *
+ * Используется для ответов RPC (createauxblock, getblocktemplate) и
+ * сообщений Stratum. Escape-последовательности в строках не
+ * раскрываются: as_string() возвращает содержимое между кавычками как
+ * есть (hex, идентификаторы и имена методов их не содержат).
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+namespace quaxis::core::json {
+
+/**
+ * @brief Тип JSON значения
+ */
+enum class Type : uint8_t {
+    Invalid,  ///< Нет значения (не найдено или разбор не удался)
+    Null,
+    Bool,
+    Number,
+    String,
+    Array,
+    Object
+};
+
+class Value;
+
+/**
+ * @brief Член объекта: ключ (без кавычек) и значение
+ */
+struct Member;
+
+/**
+ * @brief View на JSON значение
+ *
+ * Копируется дёшево (string_view + тип). Обращение к отсутствующему
+ * члену или элементу даёт Invalid, цепочки doc["result"]["hash"]
+ * безопасны.
+ */
+class Value {
+public:
+    constexpr Value() noexcept = default;
+
+    /**
+     * @brief Разобрать документ (верхнее значение, пробелы по краям пропускаются)
+     *
+     * @param document Текст JSON
+     * @return Value Значение или Invalid, если оно не закрыто
+     */
+    [[nodiscard]] static Value parse(std::string_view document) noexcept;
+
+    /// @brief Тип значения
+    [[nodiscard]] Type type() const noexcept { return type_; }
+
+    /// @brief Значение найдено и разобрано
+    [[nodiscard]] bool valid() const noexcept { return type_ != Type::Invalid; }
+    explicit operator bool() const noexcept { return valid(); }
+
+    /// @brief Значение - null
+    [[nodiscard]] bool is_null() const noexcept { return type_ == Type::Null; }
+
+    /// @brief Исходный текст значения (для строки - с кавычками)
+    [[nodiscard]] std::string_view raw() const noexcept { return raw_; }
+
+    /**
+     * @brief Член объекта по ключу (первое совпадение)
+     *
+     * Линейный проход по членам. Для нескольких полей большого объекта
+     * (getblocktemplate с транзакциями) - один проход members().
+     */
+    [[nodiscard]] Value operator[](std::string_view key) const noexcept;
+
+    /// @brief Элемент массива по индексу
+    [[nodiscard]] Value operator[](std::size_t index) const noexcept;
+
+    /// @brief Содержимое строки без кавычек
+    [[nodiscard]] std::optional<std::string_view> as_string() const noexcept;
+
+    /// @brief Целое число
+    [[nodiscard]] std::optional<int64_t> as_int64() const noexcept;
+
+    /// @brief Неотрицательное целое число
+    [[nodiscard]] std::optional<uint64_t> as_uint64() const noexcept;
+
+    /// @brief Число с плавающей точкой
+    [[nodiscard]] std::optional<double> as_double() const noexcept;
+
+    /// @brief true / false
+    [[nodiscard]] std::optional<bool> as_bool() const noexcept;
+
+    // =========================================================================
+    // Обход
+    // =========================================================================
+
+    /**
+     * @brief Итератор по элементам массива или членам объекта
+     *
+     * @tparam Item Value (элементы массива) или Member (члены объекта)
+     */
+    template<typename Item>
+    class Iterator {
+    public:
+        Iterator() noexcept = default;
+
+        [[nodiscard]] const Item& operator*() const noexcept { return item_; }
+        [[nodiscard]] const Item* operator->() const noexcept { return &item_; }
+
+        Iterator& operator++() noexcept {
+            advance();
+            return *this;
+        }
+
+        [[nodiscard]] bool operator==(const Iterator& other) const noexcept {
+            return done_ == other.done_ && (done_ || rest_.data() == other.rest_.data());
+        }
+
+    private:
+        friend class Value;
+
+        explicit Iterator(std::string_view body) noexcept : rest_(body), done_(false) {
+            advance();
+        }
+
+        void advance() noexcept;
+
+        std::string_view rest_;
+        Item item_{};
+        bool done_{true};
+    };
+
+    /**
+     * @brief Диапазон для range-for
+     */
+    template<typename Item>
+    struct Range {
+        Iterator<Item> first;
+
+        [[nodiscard]] Iterator<Item> begin() const noexcept { return first; }
+        [[nodiscard]] Iterator<Item> end() const noexcept { return {}; }
+    };
+
+    /// @brief Элементы массива (пусто, если не массив)
+    [[nodiscard]] Range<Value> elements() const noexcept;
+
+    /// @brief Члены объекта (пусто, если не объект)
+    [[nodiscard]] Range<Member> members() const noexcept;
+
+private:
+    constexpr Value(Type type, std::string_view raw) noexcept : raw_(raw), type_(type) {}
+
+    /// @brief Значение в начале text (после пробелов), длина - до его конца
+    [[nodiscard]] static Value at(std::string_view text) noexcept;
+
+    /// @brief Тело контейнера без скобок
+    [[nodiscard]] std::string_view body() const noexcept;
+
+    std::string_view raw_;
+    Type type_{Type::Invalid};
+};
+
+struct Member {
+    std::string_view key;
+    Value value;
+};
+
+extern template class Value::Iterator<Value>;
+extern template class Value::Iterator<Member>;
+
+} // namespace quaxis::core::json
@@ -4,14 +4,21 @@
  * 
  * Предоставляет классы для чтения и записи бинарных данных
  * в формате Bitcoin (little-endian).
+ *
+ * ReadStream/WriteStream работают с Bytes и выделяют память.
+ * Для горячих путей - FixedWriteStream<N> (буфер на стеке, N - верхняя
+ * граница размера из трейта serialized_size) и SpanReadStream
+ * (read_span() возвращает view, без копии).
  */
 
 #pragma once
 
 #include "../types.hpp"
 
+#include <array>
 #include <span>
 #include <cstdint>
+#include <cstring>
 #include <vector>
 #include <string>
 #include <stdexcept>
@@ -225,6 +232,217 @@ private:
     Bytes data_;
 };
 
+// =============================================================================
+// Потоки без кучи
+// =============================================================================
+
+/**
+ * @brief Верхняя граница размера сериализации типа (байт)
+ * 
+ * Специализации объявляются рядом с типом:
+ * static constexpr std::size_t value.
+ */
+template<typename T>
+struct serialized_size;
+
+template<typename T>
+inline constexpr std::size_t serialized_size_v = serialized_size<T>::value;
+
+/**
+ * @brief Поток записи в буфер фиксированного размера
+ * 
+ * API совпадает с WriteStream, память - std::array внутри объекта.
+ * Выход за N - StreamError (N меньше serialized_size - ошибка вызывающего).
+ * 
+ * @tparam N Ёмкость буфера (байт)
+ */
+template<std::size_t N>
+class FixedWriteStream {
+public:
+    /// @brief Ёмкость буфера
+    static constexpr std::size_t CAPACITY = N;
+    
+    void write_u8(uint8_t value) {
+        ensure_space(1);
+        buffer_[size_++] = value;
+    }
+    
+    void write_u16_le(uint16_t value) {
+        ensure_space(2);
+        buffer_[size_++] = static_cast<uint8_t>(value);
+        buffer_[size_++] = static_cast<uint8_t>(value >> 8);
+    }
+    
+    void write_u32_le(uint32_t value) {
+        ensure_space(4);
+        for (int i = 0; i < 4; ++i) {
+            buffer_[size_++] = static_cast<uint8_t>(value >> (i * 8));
+        }
+    }
+    
+    void write_u64_le(uint64_t value) {
+        ensure_space(8);
+        for (int i = 0; i < 8; ++i) {
+            buffer_[size_++] = static_cast<uint8_t>(value >> (i * 8));
+        }
+    }
+    
+    void write_i32_le(int32_t value) {
+        write_u32_le(static_cast<uint32_t>(value));
+    }
+    
+    void write_i64_le(int64_t value) {
+        write_u64_le(static_cast<uint64_t>(value));
+    }
+    
+    void write_varint(uint64_t value) {
+        if (value < 0xFD) {
+            write_u8(static_cast<uint8_t>(value));
+        } else if (value <= 0xFFFF) {
+            write_u8(0xFD);
+            write_u16_le(static_cast<uint16_t>(value));
+        } else if (value <= 0xFFFFFFFF) {
+            write_u8(0xFE);
+            write_u32_le(static_cast<uint32_t>(value));
+        } else {
+            write_u8(0xFF);
+            write_u64_le(value);
+        }
+    }
+    
+    void write_bytes(ByteSpan data) {
+        ensure_space(data.size());
+        if (!data.empty()) {
+            std::memcpy(buffer_.data() + size_, data.data(), data.size());
+        }
+        size_ += data.size();
+    }
+    
+    void write_hash256(const Hash256& hash) {
+        write_bytes(hash);
+    }
+    
+    void write_string(std::string_view str) {
+        write_varint(str.size());
+        write_bytes(ByteSpan(reinterpret_cast<const uint8_t*>(str.data()), str.size()));
+    }
+    
+    /**
+     * @brief Записанные данные (view на внутренний буфер)
+     */
+    [[nodiscard]] ByteSpan data() const noexcept {
+        return ByteSpan(buffer_.data(), size_);
+    }
+    
+    [[nodiscard]] std::size_t size() const noexcept { return size_; }
+    
+    void clear() noexcept { size_ = 0; }
+    
+private:
+    void ensure_space(std::size_t count) const {
+        if (count > N - size_) {
+            throw StreamError("Fixed stream overflow");
+        }
+    }
+    
+    std::array<uint8_t, N> buffer_;
+    std::size_t size_{0};
+};
+
+/**
+ * @brief Поток чтения без выделения памяти
+ * 
+ * Как ReadStream, но байтовые поля возвращаются view на исходные
+ * данные (read_span), а не копией. Данные должны пережить поток.
+ */
+class SpanReadStream {
+public:
+    explicit SpanReadStream(ByteSpan data) noexcept
+        : data_(data) {}
+    
+    [[nodiscard]] uint8_t read_u8() {
+        ensure_available(1);
+        return data_[pos_++];
+    }
+    
+    [[nodiscard]] uint16_t read_u16_le() {
+        ensure_available(2);
+        uint16_t value = static_cast<uint16_t>(data_[pos_] | (data_[pos_ + 1] << 8));
+        pos_ += 2;
+        return value;
+    }
+    
+    [[nodiscard]] uint32_t read_u32_le() {
+        ensure_available(4);
+        uint32_t value = 0;
+        for (int i = 0; i < 4; ++i) {
+            value |= static_cast<uint32_t>(data_[pos_++]) << (i * 8);
+        }
+        return value;
+    }
+    
+    [[nodiscard]] uint64_t read_u64_le() {
+        ensure_available(8);
+        uint64_t value = 0;
+        for (int i = 0; i < 8; ++i) {
+            value |= static_cast<uint64_t>(data_[pos_++]) << (i * 8);
+        }
+        return value;
+    }
+    
+    [[nodiscard]] int32_t read_i32_le() {
+        return static_cast<int32_t>(read_u32_le());
+    }
+    
+    [[nodiscard]] int64_t read_i64_le() {
+        return static_cast<int64_t>(read_u64_le());
+    }
+    
+    [[nodiscard]] uint64_t read_varint() {
+        uint8_t first = read_u8();
+        if (first < 0xFD) return first;
+        if (first == 0xFD) return read_u16_le();
+        if (first == 0xFE) return read_u32_le();
+        return read_u64_le();
+    }
+    
+    /**
+     * @brief Прочитать count байт (view, без копии)
+     */
+    [[nodiscard]] ByteSpan read_span(std::size_t count) {
+        ensure_available(count);
+        ByteSpan view = data_.subspan(pos_, count);
+        pos_ += count;
+        return view;
+    }
+    
+    [[nodiscard]] Hash256 read_hash256() {
+        Hash256 hash;
+        auto view = read_span(hash.size());
+        std::memcpy(hash.data(), view.data(), hash.size());
+        return hash;
+    }
+    
+    [[nodiscard]] std::size_t remaining() const noexcept { return data_.size() - pos_; }
+    [[nodiscard]] std::size_t position() const noexcept { return pos_; }
+    [[nodiscard]] bool eof() const noexcept { return pos_ >= data_.size(); }
+    
+    void skip(std::size_t count) {
+        ensure_available(count);
+        pos_ += count;
+    }
+    
+private:
+    void ensure_available(std::size_t count) const {
+        if (count > data_.size() - pos_) {
+            throw StreamError("Unexpected end of stream");
+        }
+    }
+    
+    ByteSpan data_;
+    std::size_t pos_{0};
+};
+
 // =============================================================================
 // VarInt утилиты
 // =============================================================================
@@ -0,0 +1,168 @@
+/**
+ * @file startup.cpp
+ * @brief Реализация параллельного запуска подсистем
+ */
+
+#include "startup.hpp"
+#include "thread_plan.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace quaxis::core {
+
+namespace {
+
+double elapsed_ms(StartupGroup::Clock::time_point from, StartupGroup::Clock::time_point to) {
+    return std::chrono::duration<double, std::milli>(to - from).count();
+}
+
+} // anonymous namespace
+
+struct StartupGroup::Impl {
+    struct Entry {
+        StartupReport report;
+        ErrorCode code = ErrorCode::Success;
+        bool done = false;
+        std::thread thread;
+    };
+
+    Clock::time_point origin;
+    ReportCallback report_callback;
+
+    mutable std::mutex mutex;
+    std::condition_variable done_cv;
+    std::vector<std::unique_ptr<Entry>> entries;
+
+    explicit Impl(Clock::time_point start) : origin(start) {}
+
+    /// @brief Шаг по имени (под mutex)
+    Entry* find(std::string_view name) const {
+        auto it = std::find_if(entries.begin(), entries.end(),
+                               [name](const auto& entry) { return entry->report.name == name; });
+        return it == entries.end() ? nullptr : it->get();
+    }
+
+    void run(Entry& entry, const std::vector<std::string>& deps, const Step& step) {
+        enter_thread_role(ThreadRole::Background);
+        const auto queued = Clock::now();
+
+        // Зависимости: все успешны - шаг выполняется, иначе - ошибка первой
+        std::string failed;
+        ErrorCode failed_code = ErrorCode::ConfigInvalidValue;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            for (const auto& dep : deps) {
+                Entry* dependency = find(dep);
+                if (dependency == nullptr || dependency == &entry) {
+                    failed = "неизвестная зависимость " + dep;
+                    break;
+                }
+                done_cv.wait(lock, [dependency] { return dependency->done; });
+                if (!dependency->report.ok) {
+                    failed = "не запущена зависимость " + dep;
+                    failed_code = dependency->code;
+                    break;
+                }
+            }
+        }
+
+        const auto started = Clock::now();
+        Result<void> result = failed.empty()
+            ? step()
+            : Err<void>(failed_code, failed);
+        const auto finished = Clock::now();
+
+        StartupReport report;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            entry.report.ok = result.has_value();
+            if (!result) {
+                entry.code = result.error().code;
+                entry.report.error = result.error().message;
+            }
+            entry.report.wait_ms = elapsed_ms(queued, started);
+            entry.report.run_ms = elapsed_ms(started, finished);
+            entry.report.ready_ms = elapsed_ms(origin, finished);
+            entry.done = true;
+            report = entry.report;
+        }
+        done_cv.notify_all();
+
+        if (report_callback) {
+            report_callback(report);
+        }
+    }
+};
+
+StartupGroup::StartupGroup(Clock::time_point origin)
+    : impl_(std::make_unique<Impl>(origin)) {}
+
+StartupGroup::~StartupGroup() {
+    wait_all();
+}
+
+void StartupGroup::set_report_callback(ReportCallback callback) {
+    impl_->report_callback = std::move(callback);
+}
+
+void StartupGroup::launch(std::string name, std::vector<std::string> deps, Step step) {
+    Impl::Entry* entry;
+    {
+        std::lock_guard<std::mutex> lock(impl_->mutex);
+        auto created = std::make_unique<Impl::Entry>();
+        created->report.name = std::move(name);
+        entry = created.get();
+        impl_->entries.push_back(std::move(created));
+    }
+    // Поток шага видит свою запись: entries хранит указатели, запись не переезжает
+    entry->thread = std::thread([this, entry, deps = std::move(deps), step = std::move(step)] {
+        impl_->run(*entry, deps, step);
+    });
+}
+
+Result<void> StartupGroup::wait(std::string_view name) {
+    std::unique_lock<std::mutex> lock(impl_->mutex);
+    Impl::Entry* entry = impl_->find(name);
+    if (entry == nullptr) {
+        return Err<void>(ErrorCode::ConfigInvalidValue, "Неизвестный шаг запуска: " + std::string(name));
+    }
+    impl_->done_cv.wait(lock, [entry] { return entry->done; });
+    if (!entry->report.ok) {
+        return Err<void>(entry->code, entry->report.error);
+    }
+    return {};
+}
+
+std::vector<StartupReport> StartupGroup::wait_all() {
+    std::vector<std::thread*> threads;
+    {
+        std::lock_guard<std::mutex> lock(impl_->mutex);
+        for (auto& entry : impl_->entries) {
+            threads.push_back(&entry->thread);
+        }
+    }
+    for (auto* thread : threads) {
+        if (thread->joinable()) {
+            thread->join();
+        }
+    }
+
+    std::vector<StartupReport> reports;
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    reports.reserve(impl_->entries.size());
+    for (const auto& entry : impl_->entries) {
+        reports.push_back(entry->report);
+    }
+    return reports;
+}
+
+std::size_t StartupGroup::pending() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    return static_cast<std::size_t>(std::count_if(impl_->entries.begin(), impl_->entries.end(),
+                                                  [](const auto& entry) { return !entry->done; }));
+}
+
+} // namespace quaxis::core
@@ -0,0 +1,100 @@
+/**
+ * @file startup.hpp
+ * @brief Параллельный запуск подсистем с зависимостями
+ *
+ * Последовательный запуск в main держал сервер ASIC, пока подключались
+ * relay (DNS пиров, сокеты), ZMQ, метрики и фид. StartupGroup запускает
+ * такие шаги в фоне: каждый шаг - в своём потоке, как только завершены
+ * его зависимости. Основной поток тем временем поднимает сервер и
+ * первичный источник шаблонов, ASIC получают задания по первому шаблону.
+ *
+ * Шаг с проваленной зависимостью не выполняется (ошибка с именем
+ * зависимости). Деструктор ждёт все шаги.
+ */
+
+#pragma once
+
+#include "types.hpp"
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace quaxis::core {
+
+/**
+ * @brief Итог шага запуска
+ */
+struct StartupReport {
+    std::string name;
+    bool ok = false;
+    std::string error;       ///< Ошибка шага или проваленной зависимости
+    double wait_ms = 0.0;    ///< Ожидание зависимостей
+    double run_ms = 0.0;     ///< Выполнение шага
+    double ready_ms = 0.0;   ///< От создания группы до готовности
+};
+
+/**
+ * @brief Группа шагов запуска, выполняемых параллельно
+ *
+ * launch() и wait() вызываются из одного потока (main).
+ */
+class StartupGroup {
+public:
+    using Step = std::function<Result<void>()>;
+    using ReportCallback = std::function<void(const StartupReport&)>;
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @param origin Начало отсчёта ready_ms (обычно запуск процесса)
+     */
+    explicit StartupGroup(Clock::time_point origin = Clock::now());
+    ~StartupGroup();
+
+    StartupGroup(const StartupGroup&) = delete;
+    StartupGroup& operator=(const StartupGroup&) = delete;
+
+    /**
+     * @brief Итог каждого шага (вызывается из потока шага)
+     *
+     * Задать до первого launch().
+     */
+    void set_report_callback(ReportCallback callback);
+
+    /**
+     * @brief Запустить шаг в фоне
+     *
+     * @param name Уникальное имя шага
+     * @param deps Шаги, запущенные раньше (неизвестное имя - ошибка шага)
+     * @param step Работа шага (поток роли background)
+     */
+    void launch(std::string name, std::vector<std::string> deps, Step step);
+
+    /**
+     * @brief Дождаться шага
+     *
+     * @return Result<void> Ошибка шага, его зависимости или неизвестное имя
+     */
+    [[nodiscard]] Result<void> wait(std::string_view name);
+
+    /**
+     * @brief Дождаться всех шагов
+     *
+     * @return std::vector<StartupReport> Итоги в порядке launch()
+     */
+    std::vector<StartupReport> wait_all();
+
+    /**
+     * @brief Шагов ещё не завершено
+     */
+    [[nodiscard]] std::size_t pending() const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace quaxis::core
@@ -0,0 +1,132 @@
+/**
+ * @file stats_counter.hpp
+ * @brief Счётчики статистики без блокировок
+ *
+ * Потоки ввода-вывода (recv каждого соединения, reactor, рассылка
+ * заданий, relay) обновляют статистику на каждом пакете. Раньше каждое
+ * обновление брало mutex структуры статистики; теперь поля - relaxed
+ * атомики, а снимок (stats()) собирается читателем из них. Читатель
+ * ничего не блокирует и писателей не задерживает.
+ *
+ * Поля, которые пишут разные потоки, разносятся по разным cache line
+ * (alignas(CACHE_LINE_SIZE)), счётчики, общие для многих потоков
+ * (итоги сервера), шардируются по потокам и суммируются при чтении.
+ *
+ * Снимок не атомарен между полями: поля читаются по очереди и могут
+ * отражать немного разные моменты - для статистики это допустимо.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace quaxis::core {
+
+/// @brief Размер cache line для разнесения счётчиков разных потоков
+inline constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+/**
+ * @brief Монотонный счётчик (relaxed fetch_add)
+ */
+class RelaxedCounter {
+public:
+    void add(uint64_t n = 1) noexcept {
+        value_.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] uint64_t load() const noexcept {
+        return value_.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<uint64_t> value_{0};
+};
+
+/**
+ * @brief Последнее значение (gauge) типа T
+ */
+template<typename T>
+class RelaxedValue {
+public:
+    RelaxedValue() noexcept = default;
+    explicit RelaxedValue(T value) noexcept : value_(value) {}
+
+    void store(T value) noexcept {
+        value_.store(value, std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] T load() const noexcept {
+        return value_.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<T> value_{};
+};
+
+/**
+ * @brief Момент времени steady_clock (хранится как число тиков)
+ */
+class RelaxedTimePoint {
+public:
+    using TimePoint = std::chrono::steady_clock::time_point;
+
+    void store(TimePoint tp) noexcept {
+        ticks_.store(tp.time_since_epoch().count(), std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] TimePoint load() const noexcept {
+        return TimePoint(TimePoint::duration(ticks_.load(std::memory_order_relaxed)));
+    }
+
+private:
+    std::atomic<TimePoint::rep> ticks_{0};
+};
+
+/**
+ * @brief Номер шарда текущего потока
+ *
+ * Потоки получают последовательные номера при первом обращении, поэтому
+ * до SHARDS потоков никогда не делят слот.
+ */
+[[nodiscard]] inline std::size_t stats_shard_index() noexcept {
+    static std::atomic<std::size_t> next_index{0};
+    thread_local const std::size_t index = next_index.fetch_add(1, std::memory_order_relaxed);
+    return index;
+}
+
+/**
+ * @brief Счётчик, шардированный по потокам
+ *
+ * Каждый поток увеличивает свой слот на отдельной cache line; load()
+ * суммирует слоты. Для итогов, которые пишут сотни потоков соединений.
+ */
+template<std::size_t SHARDS = 16>
+class ShardedCounter {
+public:
+    static_assert((SHARDS & (SHARDS - 1)) == 0, "SHARDS должно быть степенью двойки");
+
+    void add(uint64_t n = 1) noexcept {
+        slots_[stats_shard_index() & (SHARDS - 1)].value.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] uint64_t load() const noexcept {
+        uint64_t total = 0;
+        for (const auto& slot : slots_) {
+            total += slot.value.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+private:
+    struct alignas(CACHE_LINE_SIZE) Slot {
+        std::atomic<uint64_t> value{0};
+    };
+
+    std::array<Slot, SHARDS> slots_{};
+};
+
+} // namespace quaxis::core
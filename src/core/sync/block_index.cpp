@@ -0,0 +1,107 @@
+/**
+ * @file block_index.cpp
+ * @brief Реализация дерева заголовков
+ */
+
+#include "block_index.hpp"
+
+#include <algorithm>
+
+namespace quaxis::core::sync {
+
+void BlockIndex::reset(const BlockHeader& header, const Hash256& hash, uint32_t height) {
+    entries_.clear();
+    by_hash_.clear();
+
+    BlockIndexEntry root;
+    root.hash = hash;
+    root.header = header;
+    root.height = height;
+    root.parent = NONE;
+    root.skip = NONE;
+    entries_.push_back(root);
+    by_hash_.emplace(hash, 0);
+    best_ = 0;
+}
+
+std::optional<uint32_t> BlockIndex::insert(const BlockHeader& header, const Hash256& hash) {
+    if (auto known = find(hash)) {
+        return known;
+    }
+    auto parent = find(header.prev_hash);
+    if (!parent) {
+        return std::nullopt;
+    }
+
+    const auto node = static_cast<uint32_t>(entries_.size());
+    BlockIndexEntry entry;
+    entry.hash = hash;
+    entry.header = header;
+    entry.height = entries_[*parent].height + 1;
+    entry.parent = *parent;
+    entry.skip = ancestor(*parent, root_height() + skip_height(entry.height - root_height()));
+    entry.chainwork = entries_[*parent].chainwork + block_work(header.bits);
+    entries_.push_back(entry);
+    by_hash_.emplace(hash, node);
+
+    if (entries_[node].chainwork > entries_[best_].chainwork) {
+        best_ = node;
+    }
+    return node;
+}
+
+std::optional<uint32_t> BlockIndex::find(const Hash256& hash) const {
+    auto it = by_hash_.find(hash);
+    if (it == by_hash_.end()) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+uint32_t BlockIndex::ancestor(uint32_t node, uint32_t height) const noexcept {
+    if (node == NONE || height > entries_[node].height || height < root_height()) {
+        return NONE;
+    }
+
+    // Как CBlockIndex::GetAncestor: по skip, пока он не проскакивает цель
+    const uint32_t root = root_height();
+    const uint32_t target = height - root;
+    uint32_t walk = node;
+    uint32_t walk_height = entries_[node].height - root;
+    while (walk_height > target) {
+        const uint32_t skip = skip_height(walk_height);
+        const uint32_t skip_prev = skip_height(walk_height - 1);
+        const auto& entry = entries_[walk];
+        if (entry.skip != NONE &&
+            (skip == target ||
+             (skip > target && !(skip_prev + 2 < skip && skip_prev >= target)))) {
+            walk = entry.skip;
+            walk_height = skip;
+        } else {
+            walk = entry.parent;
+            --walk_height;
+        }
+    }
+    return walk;
+}
+
+uint32_t BlockIndex::fork_point(uint32_t a, uint32_t b) const noexcept {
+    if (a == NONE || b == NONE) {
+        return NONE;
+    }
+
+    // Предки на высоте h совпадают для всех h не выше развилки
+    uint32_t low = root_height();
+    uint32_t high = std::min(entries_[a].height, entries_[b].height);
+    while (low < high) {
+        const uint32_t mid = low + (high - low + 1) / 2;
+        if (ancestor(a, mid) == ancestor(b, mid)) {
+            low = mid;
+        } else {
+            high = mid - 1;
+        }
+    }
+    return ancestor(a, low);
+}
+
+} // namespace quaxis::core::sync
@@ -0,0 +1,128 @@
+/**
+ * @file block_index.hpp
+ * @brief Дерево заголовков с skip-указателями (как CBlockIndex в Bitcoin Core)
+ *
+ * Узел - заголовок с высотой, родителем, skip-указателем и суммарной
+ * работой. Skip ведёт на предка на высоте skip_height(): предок на любой
+ * высоте и общий предок двух вершин находятся за O(log n) переходов,
+ * а не проходом по родителям.
+ *
+ * Дерево начинается с корня - блока активной цепи HeadersStore; высоты
+ * skip считаются от корня, работа - суммарная от корня (для сравнения
+ * вершин, растущих из одного корня, этого достаточно).
+ */
+
+#pragma once
+
+#include "../primitives/block_header.hpp"
+#include "../primitives/uint256.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace quaxis::core::sync {
+
+/**
+ * @brief Узел дерева заголовков
+ */
+struct BlockIndexEntry {
+    Hash256 hash{};
+    BlockHeader header;
+    uint32_t height{0};
+    uint32_t parent{0};     ///< Узел родителя (NONE у корня)
+    uint32_t skip{0};       ///< Узел предка на skip_height (NONE у корня)
+    uint256 chainwork;      ///< Работа от корня до узла включительно
+};
+
+/**
+ * @brief Дерево заголовков: активная цепь и боковые ветви
+ *
+ * Узлы не удаляются (кроме reset()); идентификатор узла - индекс в
+ * порядке добавления, родитель всегда добавлен раньше потомка.
+ *
+ * Thread-safety: нет (защищает владелец, HeadersStore).
+ */
+class BlockIndex {
+public:
+    /// @brief Нет узла
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    /**
+     * @brief Высота skip-предка для высоты height (от корня)
+     *
+     * Как GetSkipHeight в Bitcoin Core: сбрасывает младшие единичные биты,
+     * так что переходы по skip покрывают любую высоту за O(log n).
+     */
+    [[nodiscard]] static constexpr uint32_t skip_height(uint32_t height) noexcept {
+        if (height < 2) {
+            return 0;
+        }
+        auto invert_lowest_one = [](uint32_t n) { return n & (n - 1); };
+        return (height & 1) ? invert_lowest_one(invert_lowest_one(height - 1)) + 1
+                            : invert_lowest_one(height);
+    }
+
+    /**
+     * @brief Начать дерево с корня
+     */
+    void reset(const BlockHeader& header, const Hash256& hash, uint32_t height);
+
+    /**
+     * @brief Добавить заголовок, родитель которого уже в дереве
+     *
+     * @return Узел (прежний, если заголовок уже есть) или nullopt
+     *         (родитель неизвестен)
+     */
+    std::optional<uint32_t> insert(const BlockHeader& header, const Hash256& hash);
+
+    /**
+     * @brief Узел по хешу
+     */
+    [[nodiscard]] std::optional<uint32_t> find(const Hash256& hash) const;
+
+    [[nodiscard]] const BlockIndexEntry& at(uint32_t node) const noexcept { return entries_[node]; }
+
+    /**
+     * @brief Предок узла на высоте height
+     *
+     * @return Узел или NONE (height выше узла или ниже корня)
+     */
+    [[nodiscard]] uint32_t ancestor(uint32_t node, uint32_t height) const noexcept;
+
+    /**
+     * @brief Общий предок двух узлов (точка развилки)
+     *
+     * Бинарный поиск по высоте: O(log² n) переходов по skip.
+     */
+    [[nodiscard]] uint32_t fork_point(uint32_t a, uint32_t b) const noexcept;
+
+    /**
+     * @brief Узел с наибольшей работой (при равенстве - полученный раньше)
+     */
+    [[nodiscard]] uint32_t best() const noexcept { return best_; }
+
+    [[nodiscard]] uint32_t root_height() const noexcept {
+        return entries_.empty() ? 0 : entries_.front().height;
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept { return entries_.size(); }
+
+private:
+    /// @brief Хеш Hash256 для таблицы: первые 8 байт
+    struct HashPrefix {
+        std::size_t operator()(const Hash256& hash) const noexcept {
+            std::size_t prefix;
+            std::memcpy(&prefix, hash.data(), sizeof(prefix));
+            return prefix;
+        }
+    };
+
+    std::vector<BlockIndexEntry> entries_;
+    std::unordered_map<Hash256, uint32_t, HashPrefix> by_hash_;
+    uint32_t best_{NONE};
+};
+
+} // namespace quaxis::core::sync
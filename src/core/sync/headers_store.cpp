@@ -4,11 +4,48 @@
  */
 
 #include "headers_store.hpp"
+#include "../task_pool.hpp"
 
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <cstring>
+#include <format>
 #include <stdexcept>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 namespace quaxis::core::sync {
 
+namespace {
+
+/// @brief Смещение prev_hash в сериализованном заголовке
+constexpr std::size_t PREV_HASH_OFFSET = 4;
+
+/// @brief 64-битный префикс хеша для индекса
+uint64_t hash_prefix(const Hash256& hash) noexcept {
+    uint64_t prefix;
+    std::memcpy(&prefix, hash.data(), sizeof(prefix));
+    return prefix;
+}
+
+/// @brief fn(0) .. fn(count - 1) в пуле или в вызывающем потоке
+void run_tasks(TaskPool* pool, std::size_t count, const TaskPool::Task& fn) {
+    if (pool) {
+        pool->run(count, fn);
+        return;
+    }
+    for (std::size_t i = 0; i < count; ++i) {
+        fn(i);
+    }
+}
+
+} // anonymous namespace
+
 HeadersStore::HeadersStore(const ChainParams& params)
     : params_(params) {
     // Инициализируем genesis
@@ -19,43 +56,651 @@ HeadersStore::HeadersStore(const ChainParams& params)
     genesis_.timestamp = 1231006505;  // Bitcoin genesis timestamp
     genesis_.bits = params_.difficulty.pow_limit_bits;
     genesis_.nonce = 2083236893;
-    
+
     // Добавляем genesis
-    headers_.push_back(genesis_);
-    hash_index_[genesis_.hash()] = 0;
+    auto bytes = genesis_.serialize();
+    memory_.assign(bytes.begin(), bytes.end());
+    count_ = 1;
+    rebuild(nullptr);
 }
 
-bool HeadersStore::add_header(const BlockHeader& header, uint32_t height) {
+HeadersStore::~HeadersStore() {
+    close_file();
+}
+
+// =============================================================================
+// Файл
+// =============================================================================
+
+Result<void> HeadersStore::open(const std::string& path, TaskPool* pool) {
     std::lock_guard<std::mutex> lock(mutex_);
+    close_file();
+
+    auto fail = [this, &path](const char* what) -> Result<void> {
+        int err = errno;
+        close_file();
+        return Err<void>(ErrorCode::SystemIOError,
+                         std::format("{} {}: {}", what, path, strerror(err)));
+    };
+
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd_ < 0) {
+        return fail("Не удалось открыть файл заголовков");
+    }
+    struct stat st{};
+    if (fstat(fd_, &st) < 0) {
+        return fail("fstat");
+    }
+
+    // Запись, оборванная при падении, отрезается
+    auto records = static_cast<uint32_t>(static_cast<std::size_t>(st.st_size) / BLOCK_HEADER_SIZE);
+    if (records == 0) {
+        auto bytes = genesis_.serialize();
+        if (::pwrite(fd_, bytes.data(), bytes.size(), 0) != static_cast<ssize_t>(bytes.size())) {
+            return fail("Не удалось записать genesis в");
+        }
+        records = 1;
+    }
+    if (static_cast<std::size_t>(st.st_size) != std::size_t{records} * BLOCK_HEADER_SIZE &&
+        ftruncate(fd_, static_cast<off_t>(std::size_t{records} * BLOCK_HEADER_SIZE)) < 0) {
+        return fail("ftruncate");
+    }
+    if (!map_file(records)) {
+        return fail("mmap");
+    }
+
+    // Запись 0 - genesis или контрольная точка снапшота
+    uint32_t base = 0;
+    if (std::memcmp(map_, genesis_.serialize().data(), BLOCK_HEADER_SIZE) != 0) {
+        const auto* checkpoint = params_.find_checkpoint(BlockHeader::deserialize(map_).hash());
+        if (!checkpoint) {
+            close_file();
+            return Err<void>(ErrorCode::ConfigInvalidValue,
+                             std::format("Файл заголовков {} от другой сети (genesis)", path));
+        }
+        base = checkpoint->height;
+    }
+
+    // Хвост: prev_hash каждой записи - хеш предыдущей (хеши - одним пакетом)
+    const uint32_t first = records > TAIL_CHECK ? records - TAIL_CHECK : 1;
+    std::vector<BlockHeader> tail(records - first + 1);
+    std::vector<Hash256> tail_hashes(tail.size());
+    for (std::size_t i = 0; i < tail.size(); ++i) {
+        tail[i] = BlockHeader::deserialize(map_ + (first - 1 + i) * BLOCK_HEADER_SIZE);
+    }
+    (void)hash_headers(tail, tail_hashes);
+    for (uint32_t h = first; h < records; ++h) {
+        const Hash256& prev = tail_hashes[h - first];
+        if (std::memcmp(map_ + std::size_t{h} * BLOCK_HEADER_SIZE + PREV_HASH_OFFSET, prev.data(), prev.size()) != 0) {
+            records = h;
+            if (ftruncate(fd_, static_cast<off_t>(std::size_t{records} * BLOCK_HEADER_SIZE)) < 0) {
+                return fail("ftruncate");
+            }
+            break;
+        }
+    }
     
-    // Проверяем что высота соответствует следующему блоку
-    if (height != headers_.size()) {
+    memory_.clear();
+    memory_.shrink_to_fit();
+    base_ = base;
+    count_ = records;
+    rebuild(pool);
+    return {};
+}
+
+bool HeadersStore::is_persistent() const noexcept {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return fd_ >= 0;
+}
+
+Result<void> HeadersStore::reset(uint32_t base_height, std::span<const BlockHeader> headers,
+                                 TaskPool* pool) {
+    if (headers.empty()) {
+        return Err<void>(ErrorCode::BitcoinInvalidBlock, "Пустой снапшот заголовков");
+    }
+    if (base_height == 0
+            ? headers.front().serialize() != genesis_.serialize()
+            : !params_.find_checkpoint(base_height) ||
+              params_.find_checkpoint(base_height)->hash != headers.front().hash()) {
+        return Err<void>(ErrorCode::BitcoinInvalidBlock,
+                         std::format("Снапшот начинается не с контрольной точки (высота {})", base_height));
+    }
+
+    std::vector<uint8_t> bytes(headers.size() * BLOCK_HEADER_SIZE);
+    for (std::size_t i = 0; i < headers.size(); ++i) {
+        auto serialized = headers[i].serialize();
+        std::memcpy(bytes.data() + i * BLOCK_HEADER_SIZE, serialized.data(), serialized.size());
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!replace_records(base_height, bytes.data(), headers.size(), pool)) {
+        return Err<void>(ErrorCode::SystemIOError,
+                         std::format("Не удалось записать снапшот: {}", strerror(errno)));
+    }
+    return {};
+}
+
+uint32_t HeadersStore::base_height() const noexcept {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return base_;
+}
+
+bool HeadersStore::replace_records(uint32_t base, const uint8_t* data, std::size_t records,
+                                   TaskPool* pool) {
+    const std::size_t size = records * BLOCK_HEADER_SIZE;
+    bool written = true;
+    if (fd_ >= 0) {
+        // Обрывок после падения open() отрежет по хвосту или не узнает базу
+        written = ftruncate(fd_, 0) == 0 &&
+                  ::pwrite(fd_, data, size, 0) == static_cast<ssize_t>(size) &&
+                  map_file(records);
+        if (!written) {
+            // Файл в неизвестном состоянии: остаёмся в памяти
+            const int err = errno;
+            close_file();
+            errno = err;
+        }
+    }
+    if (fd_ < 0) {
+        memory_.assign(data, data + size);
+    }
+    base_ = base;
+    count_ = static_cast<uint32_t>(records);
+    rebuild(pool);
+    return written;
+}
+
+bool HeadersStore::map_file(std::size_t records) {
+    // Отображение с запасом: страницы дальше конца файла не читаются
+    std::size_t capacity = std::max(map_records_, MIN_MAP_RECORDS);
+    while (capacity < records) {
+        capacity *= 2;
+    }
+    if (map_ && capacity == map_records_) {
+        return true;
+    }
+
+    void* ptr = mmap(nullptr, capacity * BLOCK_HEADER_SIZE, PROT_READ, MAP_SHARED, fd_, 0);
+    if (ptr == MAP_FAILED) {
         return false;
     }
+    if (map_) {
+        munmap(const_cast<uint8_t*>(map_), map_records_ * BLOCK_HEADER_SIZE);
+    }
+    map_ = static_cast<const uint8_t*>(ptr);
+    map_records_ = capacity;
+    return true;
+}
+
+void HeadersStore::close_file() noexcept {
+    if (map_) {
+        munmap(const_cast<uint8_t*>(map_), map_records_ * BLOCK_HEADER_SIZE);
+        map_ = nullptr;
+        map_records_ = 0;
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+bool HeadersStore::append_record(const uint8_t* data) {
+    if (fd_ < 0) {
+        memory_.insert(memory_.end(), data, data + BLOCK_HEADER_SIZE);
+        return true;
+    }
+
+    // Без fsync: после падения хвост проверит open()
+    const auto offset = static_cast<off_t>(std::size_t{count_} * BLOCK_HEADER_SIZE);
+    if (::pwrite(fd_, data, BLOCK_HEADER_SIZE, offset) != static_cast<ssize_t>(BLOCK_HEADER_SIZE)) {
+        return false;
+    }
+    if (count_ + 1 > map_records_ && !map_file(std::size_t{count_} + 1)) {
+        (void)ftruncate(fd_, offset);
+        return false;
+    }
+    return true;
+}
+
+// =============================================================================
+// Записи и индекс
+// =============================================================================
+
+const uint8_t* HeadersStore::record(uint32_t pos) const noexcept {
+    const uint8_t* base = fd_ >= 0 ? map_ : memory_.data();
+    return base + std::size_t{pos} * BLOCK_HEADER_SIZE;
+}
+
+const HeaderSummary& HeadersStore::summary(uint32_t pos) const noexcept {
+    return (*hot_->chunks[pos / HEADERS_CHUNK])[pos % HEADERS_CHUNK];
+}
+
+Hash256 HeadersStore::hash_at(uint32_t pos) const noexcept {
+    if (pos + 1 == count_) {
+        return tip_hash_;
+    }
+    Hash256 hash;
+    std::memcpy(hash.data(), record(pos + 1) + PREV_HASH_OFFSET, hash.size());
+    return hash;
+}
+
+void HeadersStore::load_tip() {
+    tip_ = BlockHeader::deserialize(record(count_ - 1));
+    tip_hash_ = tip_.hash();
+}
+
+std::optional<uint32_t> HeadersStore::find(const Hash256& hash) const noexcept {
+    const std::size_t mask = index_.size() - 1;
+    const uint64_t prefix = hash_prefix(hash);
+    for (std::size_t slot = prefix & mask; index_[slot] != EMPTY; slot = (slot + 1) & mask) {
+        const uint32_t pos = index_[slot];
+        if (pos < count_ && summary(pos).hash_prefix == prefix && hash_at(pos) == hash) {
+            return index_[slot];
+        }
+    }
+    return std::nullopt;
+}
+
+void HeadersStore::index_insert(uint32_t pos, const Hash256& hash) {
+    // Таблица заполнена не более чем наполовину
+    if ((std::size_t{count_} + index_stale_) * 2 > index_.size()) {
+        rebuild_index(index_.size() * 2);
+        return;  // pos уже < count_ и попал в новую таблицу
+    }
+    const std::size_t mask = index_.size() - 1;
+    std::size_t slot = hash_prefix(hash) & mask;
+    while (index_[slot] != EMPTY) {
+        slot = (slot + 1) & mask;
+    }
+    index_[slot] = pos;
+}
+
+void HeadersStore::rebuild_index(std::size_t slots, TaskPool* pool) {
+    index_.assign(slots, EMPTY);
+    index_stale_ = 0;
+    if (pool && count_ >= PARALLEL_REBUILD_MIN) {
+        rebuild_index_sharded(*pool);
+        return;
+    }
+    
+    // Префиксы - из сводок: 16 байт на запись вместо 80 байт файла
+    const std::size_t mask = slots - 1;
+    for (uint32_t h = 0; h < count_; ++h) {
+        std::size_t slot = summary(h).hash_prefix & mask;
+        while (index_[slot] != EMPTY) {
+            slot = (slot + 1) & mask;
+        }
+        index_[slot] = h;
+    }
+}
+
+void HeadersStore::rebuild_index_sharded(TaskPool& pool) {
+    // Шард - непрерывный диапазон ячеек: записи раскладываются по шардам
+    // домашних ячеек (подсчёт и разброс по кускам арены), затем каждый
+    // шард вставляет свои без блокировок. Проба, дошедшая до конца шарда,
+    // откладывается и вставляется после всех шардов обычной пробой: при
+    // заполнении до половины таких единицы
+    const std::size_t mask = index_.size() - 1;
+    const std::size_t shard_slots = index_.size() / INDEX_SHARDS;
+    const std::size_t chunks = (count_ + HEADERS_CHUNK - 1) / HEADERS_CHUNK;
+    auto shard_of = [&](uint32_t pos) {
+        return (summary(pos).hash_prefix & mask) / shard_slots;
+    };
+    
+    // Начало записей куска c в шарде s: offsets[c * INDEX_SHARDS + s]
+    std::vector<uint32_t> offsets(chunks * INDEX_SHARDS, 0);
+    run_tasks(&pool, chunks, [&](std::size_t c) {
+        const auto last = static_cast<uint32_t>(std::min<std::size_t>(count_, (c + 1) * HEADERS_CHUNK));
+        for (auto pos = static_cast<uint32_t>(c * HEADERS_CHUNK); pos < last; ++pos) {
+            ++offsets[c * INDEX_SHARDS + shard_of(pos)];
+        }
+    });
+    std::vector<uint32_t> shard_begin(INDEX_SHARDS + 1, 0);
+    uint32_t total = 0;
+    for (std::size_t s = 0; s < INDEX_SHARDS; ++s) {
+        shard_begin[s] = total;
+        for (std::size_t c = 0; c < chunks; ++c) {
+            const uint32_t n = offsets[c * INDEX_SHARDS + s];
+            offsets[c * INDEX_SHARDS + s] = total;
+            total += n;
+        }
+    }
+    shard_begin[INDEX_SHARDS] = total;
+    
+    std::vector<uint32_t> order(count_);
+    run_tasks(&pool, chunks, [&](std::size_t c) {
+        const auto last = static_cast<uint32_t>(std::min<std::size_t>(count_, (c + 1) * HEADERS_CHUNK));
+        for (auto pos = static_cast<uint32_t>(c * HEADERS_CHUNK); pos < last; ++pos) {
+            order[offsets[c * INDEX_SHARDS + shard_of(pos)]++] = pos;
+        }
+    });
     
+    std::vector<std::vector<uint32_t>> overflow(INDEX_SHARDS);
+    run_tasks(&pool, INDEX_SHARDS, [&](std::size_t s) {
+        const std::size_t end = (s + 1) * shard_slots;
+        for (uint32_t i = shard_begin[s]; i < shard_begin[s + 1]; ++i) {
+            const uint32_t pos = order[i];
+            std::size_t slot = summary(pos).hash_prefix & mask;
+            while (slot < end && index_[slot] != EMPTY) {
+                ++slot;
+            }
+            if (slot < end) {
+                index_[slot] = pos;
+            } else {
+                overflow[s].push_back(pos);
+            }
+        }
+    });
+    
+    for (const auto& pending : overflow) {
+        for (const uint32_t pos : pending) {
+            std::size_t slot = summary(pos).hash_prefix & mask;
+            while (index_[slot] != EMPTY) {
+                slot = (slot + 1) & mask;
+            }
+            index_[slot] = pos;
+        }
+    }
+}
+
+void HeadersStore::rebuild(TaskPool* pool) {
+    // Сводки первыми: индекс строится по их префиксам
+    load_tip();
+    arena_rebuild(pool);
+    rebuild_index(std::bit_ceil(std::max<std::size_t>(std::size_t{count_} * 2, 16)), pool);
+    reset_tree();
+}
+
+// =============================================================================
+// Доступ
+// =============================================================================
+
+bool HeadersStore::add_header(const BlockHeader& header, uint32_t height) {
+    return add_header(header, height, header.hash());
+}
+
+bool HeadersStore::add_header(const BlockHeader& header, uint32_t height, const Hash256& hash) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // Проверяем что высота соответствует следующему блоку
+    if (height != base_ + count_) {
+        return false;
+    }
+
     // Проверяем prev_hash
-    if (height > 0) {
-        auto tip_hash = headers_.back().hash();
-        if (header.prev_hash != tip_hash) {
+    if (header.prev_hash != tip_hash_) {
+        return false;
+    }
+
+    return extend_locked(header, hash);
+}
+
+bool HeadersStore::push_record(const BlockHeader& header, const Hash256& hash) {
+    auto bytes = header.serialize();
+    if (!append_record(bytes.data())) {
+        return false;
+    }
+    ++count_;
+    tip_ = header;
+    tip_hash_ = hash;
+    arena_append(header, hash);  // До индекса: его перестроение читает сводки
+    index_insert(count_ - 1, hash);
+    return true;
+}
+
+bool HeadersStore::truncate_records(uint32_t records) {
+    if (fd_ >= 0) {
+        // Отображение не сужается: страницы за концом файла не читаются
+        if (ftruncate(fd_, static_cast<off_t>(std::size_t{records} * BLOCK_HEADER_SIZE)) < 0) {
             return false;
         }
+    } else {
+        memory_.resize(std::size_t{records} * BLOCK_HEADER_SIZE);
     }
+    index_stale_ += count_ - records;
+    count_ = records;
+    load_tip();
+    arena_truncate(records);
+    return true;
+}
+
+// =============================================================================
+// Арена снимков
+// =============================================================================
+
+void HeadersStore::arena_rebuild(TaskPool* pool) {
+    auto arena = std::make_shared<HeadersArena>();
+    arena->base = base_;
     
+    // Куски независимы: с пулом - параллельно
+    arena->chunks.resize((count_ + HEADERS_CHUNK - 1) / HEADERS_CHUNK);
+    run_tasks(count_ >= PARALLEL_REBUILD_MIN ? pool : nullptr, arena->chunks.size(), [&](std::size_t c) {
+        auto chunk = std::make_shared<HeadersArena::Chunk>();
+        const auto first = static_cast<uint32_t>(c * HEADERS_CHUNK);
+        const auto last = static_cast<uint32_t>(std::min<std::size_t>(count_, first + HEADERS_CHUNK));
+        for (uint32_t pos = first; pos < last; ++pos) {
+            (*chunk)[pos - first] = HeaderSummary::from(BlockHeader::deserialize(record(pos)), hash_at(pos));
+        }
+        arena->chunks[c] = std::move(chunk);
+    });
+    arena->size.store(count_, std::memory_order_relaxed);
+    hot_ = arena.get();
+    arena_.store(std::move(arena), std::memory_order_release);
+}
+
+void HeadersStore::arena_append(const BlockHeader& header, const Hash256& hash) {
+    auto arena = arena_.load(std::memory_order_relaxed);
+    const uint32_t size = arena->size.load(std::memory_order_relaxed);
+    if (size % HEADERS_CHUNK != 0) {
+        // Ячейка за опубликованным размером: читатели её не видят
+        (*arena->chunks.back())[size % HEADERS_CHUNK] = HeaderSummary::from(header, hash);
+        arena->size.store(size + 1, std::memory_order_release);
+        return;
+    }
+
+    // Новый кусок - новая арена: у прежней размер больше не меняется
+    auto next = std::make_shared<HeadersArena>();
+    next->base = arena->base;
+    next->chunks = arena->chunks;
+    next->chunks.push_back(std::make_shared<HeadersArena::Chunk>());
+    next->chunks.back()->front() = HeaderSummary::from(header, hash);
+    next->size.store(size + 1, std::memory_order_relaxed);
+    hot_ = next.get();
+    arena_.store(std::move(next), std::memory_order_release);
+}
+
+void HeadersStore::arena_truncate(uint32_t records) {
+    // Недописанный кусок копируется: старые снимки видят прежние заголовки
+    auto arena = arena_.load(std::memory_order_relaxed);
+    auto next = std::make_shared<HeadersArena>();
+    next->base = arena->base;
+    const uint32_t full = records / HEADERS_CHUNK;
+    next->chunks.assign(arena->chunks.begin(), arena->chunks.begin() + full);
+    if (records % HEADERS_CHUNK != 0) {
+        next->chunks.push_back(std::make_shared<HeadersArena::Chunk>(*arena->chunks[full]));
+    }
+    next->size.store(records, std::memory_order_relaxed);
+    hot_ = next.get();
+    arena_.store(std::move(next), std::memory_order_release);
+}
+
+HeadersView HeadersStore::view() const noexcept {
+    auto arena = arena_.load(std::memory_order_acquire);
+    const uint32_t size = arena->size.load(std::memory_order_acquire);
+    return HeadersView(std::move(arena), size);
+}
+
+bool HeadersStore::extend_locked(const BlockHeader& header, const Hash256& hash) {
+    // Контрольная точка
+    const uint32_t height = base_ + count_;
+    const auto* checkpoint = params_.find_checkpoint(height);
+    if (checkpoint && checkpoint->hash != hash) {
+        return false;
+    }
+
     // Добавляем заголовок
-    headers_.push_back(header);
-    hash_index_[header.hash()] = height;
+    if (!push_record(header, hash)) {
+        return false;
+    }
     
+    // Окно дерева сдвигается раз в REORG_WINDOW блоков
+    if (height - tree_.root_height() > 2 * REORG_WINDOW) {
+        reset_tree();
+    } else if (auto node = tree_.insert(header, hash)) {
+        tree_tip_ = *node;
+    }
     return true;
 }
 
+bool HeadersStore::is_active(const BlockIndexEntry& entry) const noexcept {
+    return entry.height >= base_ && entry.height - base_ < count_ &&
+           hash_at(entry.height - base_) == entry.hash;
+}
+
+void HeadersStore::reset_tree() {
+    // Ветви прежнего дерева выше нового корня переносятся: родитель
+    // добавлен раньше потомка, ветви ниже корня отбрасывает insert()
+    std::vector<std::pair<BlockHeader, Hash256>> branches;
+    const uint32_t tip_height = base_ + count_ - 1;
+    const uint32_t root = tip_height > base_ + REORG_WINDOW ? tip_height - REORG_WINDOW : base_;
+    for (std::size_t i = 0; i < tree_.size(); ++i) {
+        const auto& entry = tree_.at(static_cast<uint32_t>(i));
+        if (entry.height > root && !is_active(entry)) {
+            branches.emplace_back(entry.header, entry.hash);
+        }
+    }
+
+    tree_.reset(BlockHeader::deserialize(record(root - base_)), hash_at(root - base_), root);
+    tree_tip_ = 0;
+    for (uint32_t pos = root - base_ + 1; pos < count_; ++pos) {
+        if (auto node = tree_.insert(BlockHeader::deserialize(record(pos)), hash_at(pos))) {
+            tree_tip_ = *node;
+        }
+    }
+    for (const auto& [header, hash] : branches) {
+        (void)tree_.insert(header, hash);
+    }
+}
+
+HeaderAccept HeadersStore::accept_header(const BlockHeader& header, const Hash256& hash) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    HeaderAccept result;
+
+    if (auto pos = find(hash)) {
+        result.status = HeaderStatus::Known;
+        result.height = base_ + *pos;
+        return result;
+    }
+    if (auto node = tree_.find(hash)) {
+        result.status = HeaderStatus::Known;
+        result.height = tree_.at(*node).height;
+        return result;
+    }
+
+    // Продление активной цепи
+    if (header.prev_hash == tip_hash_) {
+        result.height = base_ + count_;
+        result.status = extend_locked(header, hash) ? HeaderStatus::Extended : HeaderStatus::Rejected;
+        return result;
+    }
+
+    // Боковая ветвь: родитель в окне дерева
+    auto parent = tree_.find(header.prev_hash);
+    if (!parent) {
+        return result;
+    }
+    result.height = tree_.at(*parent).height + 1;
+    const auto* checkpoint = params_.find_checkpoint(result.height);
+    if (checkpoint && checkpoint->hash != hash) {
+        return result;
+    }
+    const uint32_t node = *tree_.insert(header, hash);
+    if (tree_.at(node).chainwork <= tree_.at(tree_tip_).chainwork) {
+        result.status = HeaderStatus::SideBranch;
+        return result;
+    }
+
+    // Больше работы: ветвь становится активной цепью
+    const uint32_t fork = tree_.fork_point(node, tree_tip_);
+    result.fork_height = tree_.at(fork).height;
+    result.disconnected = base_ + count_ - 1 - result.fork_height;
+    for (uint32_t walk = node; walk != fork; walk = tree_.at(walk).parent) {
+        result.connected.push_back(tree_.at(walk).header);
+    }
+    std::reverse(result.connected.begin(), result.connected.end());
+
+    if (!truncate_records(result.fork_height - base_ + 1)) {
+        result.status = HeaderStatus::Rejected;
+        return result;
+    }
+    for (uint32_t height = result.fork_height + 1; height <= result.height; ++height) {
+        const auto& entry = tree_.at(tree_.ancestor(node, height));
+        if (!push_record(entry.header, entry.hash)) {
+            // Ввод/вывод: активной остаётся записанная часть ветви
+            tree_tip_ = tree_.ancestor(node, height - 1);
+            result.status = HeaderStatus::Rejected;
+            return result;
+        }
+    }
+    tree_tip_ = node;
+    result.status = HeaderStatus::Reorganized;
+    return result;
+}
+
+std::optional<uint32_t> HeadersStore::find_fork(const Hash256& a, const Hash256& b) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // Блок дерева или активной цепи ниже корня (высота)
+    auto node_a = tree_.find(a);
+    auto node_b = tree_.find(b);
+    auto pos_a = node_a ? std::nullopt : find(a);
+    auto pos_b = node_b ? std::nullopt : find(b);
+    if ((!node_a && !pos_a) || (!node_b && !pos_b)) {
+        return std::nullopt;
+    }
+    if (node_a && node_b) {
+        return tree_.at(tree_.fork_point(*node_a, *node_b)).height;
+    }
+
+    // Хотя бы один - ниже корня: дерево растёт из активной цепи выше него
+    const uint32_t height_a = node_a ? tree_.at(*node_a).height : base_ + *pos_a;
+    const uint32_t height_b = node_b ? tree_.at(*node_b).height : base_ + *pos_b;
+    return std::min(height_a, height_b);
+}
+
+std::optional<Hash256> HeadersStore::get_ancestor(const Hash256& hash, uint32_t height) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (auto node = tree_.find(hash)) {
+        if (height > tree_.at(*node).height) {
+            return std::nullopt;
+        }
+        if (height >= tree_.root_height()) {
+            return tree_.at(tree_.ancestor(*node, height)).hash;
+        }
+    } else if (auto pos = find(hash)) {
+        if (height > base_ + *pos) {
+            return std::nullopt;
+        }
+    } else {
+        return std::nullopt;
+    }
+
+    // Ниже корня дерева все ветви - активная цепь
+    if (height < base_) {
+        return std::nullopt;
+    }
+    return hash_at(height - base_);
+}
+
 std::optional<BlockHeader> HeadersStore::get_by_hash(
     const Hash256& hash
 ) const {
     std::lock_guard<std::mutex> lock(mutex_);
-    
-    auto it = hash_index_.find(hash);
-    if (it != hash_index_.end() && it->second < headers_.size()) {
-        return headers_[it->second];
+
+    auto pos = find(hash);
+    if (pos) {
+        return BlockHeader::deserialize(record(*pos));
     }
     return std::nullopt;
 }
@@ -64,9 +709,9 @@ std::optional<BlockHeader> HeadersStore::get_by_height(
     uint32_t height
 ) const {
     std::lock_guard<std::mutex> lock(mutex_);
-    
-    if (height < headers_.size()) {
-        return headers_[height];
+
+    if (height >= base_ && height - base_ < count_) {
+        return BlockHeader::deserialize(record(height - base_));
     }
     return std::nullopt;
 }
@@ -75,64 +720,73 @@ std::optional<uint32_t> HeadersStore::get_height(
     const Hash256& hash
 ) const {
     std::lock_guard<std::mutex> lock(mutex_);
-    
-    auto it = hash_index_.find(hash);
-    if (it != hash_index_.end()) {
-        return it->second;
+
+    auto pos = find(hash);
+    if (pos) {
+        return base_ + *pos;
+    }
+    return std::nullopt;
+}
+
+std::optional<Hash256> HeadersStore::get_hash(uint32_t height) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (height >= base_ && height - base_ < count_) {
+        return hash_at(height - base_);
     }
     return std::nullopt;
 }
 
 const BlockHeader& HeadersStore::get_tip() const {
     std::lock_guard<std::mutex> lock(mutex_);
-    
-    if (headers_.empty()) {
+
+    if (count_ == 0) {
         throw std::runtime_error("Headers store is empty");
     }
-    return headers_.back();
+    return tip_;
 }
 
 uint32_t HeadersStore::get_tip_height() const noexcept {
     std::lock_guard<std::mutex> lock(mutex_);
-    
-    if (headers_.empty()) {
+
+    if (count_ == 0) {
         return 0;
     }
-    return static_cast<uint32_t>(headers_.size() - 1);
+    return base_ + count_ - 1;
 }
 
 Hash256 HeadersStore::get_tip_hash() const {
     std::lock_guard<std::mutex> lock(mutex_);
-    
-    if (headers_.empty()) {
+
+    if (count_ == 0) {
         return Hash256{};
     }
-    return headers_.back().hash();
+    return tip_hash_;
 }
 
 bool HeadersStore::has_header(const Hash256& hash) const {
     std::lock_guard<std::mutex> lock(mutex_);
-    return hash_index_.find(hash) != hash_index_.end();
+    return find(hash).has_value();
 }
 
 std::vector<BlockHeader> HeadersStore::get_recent_headers(
     std::size_t count
 ) const {
     std::lock_guard<std::mutex> lock(mutex_);
-    
+
     std::vector<BlockHeader> result;
-    
-    if (headers_.empty()) {
+
+    if (count_ == 0) {
         return result;
     }
-    
-    std::size_t start = headers_.size() > count ? headers_.size() - count : 0;
-    result.reserve(headers_.size() - start);
-    
-    for (std::size_t i = start; i < headers_.size(); ++i) {
-        result.push_back(headers_[i]);
+
+    std::size_t start = count_ > count ? count_ - count : 0;
+    result.reserve(count_ - start);
+
+    for (std::size_t i = start; i < count_; ++i) {
+        result.push_back(BlockHeader::deserialize(record(static_cast<uint32_t>(i))));
     }
-    
+
     return result;
 }
 
@@ -141,37 +795,35 @@ std::vector<BlockHeader> HeadersStore::get_headers_range(
     uint32_t end_height
 ) const {
     std::lock_guard<std::mutex> lock(mutex_);
-    
+
     std::vector<BlockHeader> result;
-    
-    if (start_height >= headers_.size()) {
+
+    const uint32_t start = std::max(start_height, base_) - base_;
+    if (start >= count_ || end_height < base_) {
         return result;
     }
-    
-    uint32_t actual_end = std::min(end_height + 1, 
-                                    static_cast<uint32_t>(headers_.size()));
-    result.reserve(actual_end - start_height);
-    
-    for (uint32_t i = start_height; i < actual_end; ++i) {
-        result.push_back(headers_[i]);
+
+    uint32_t actual_end = std::min(end_height - base_ + 1, count_);
+    result.reserve(actual_end - start);
+
+    for (uint32_t i = start; i < actual_end; ++i) {
+        result.push_back(BlockHeader::deserialize(record(i)));
     }
-    
+
     return result;
 }
 
 std::size_t HeadersStore::size() const noexcept {
     std::lock_guard<std::mutex> lock(mutex_);
-    return headers_.size();
+    return count_;
 }
 
 void HeadersStore::clear() {
     std::lock_guard<std::mutex> lock(mutex_);
-    headers_.clear();
-    hash_index_.clear();
-    
-    // Восстанавливаем genesis
-    headers_.push_back(genesis_);
-    hash_index_[genesis_.hash()] = 0;
+
+    // Восстанавливаем genesis (файл перезаписывается одной записью)
+    auto bytes = genesis_.serialize();
+    (void)replace_records(0, bytes.data(), 1);
 }
 
 } // namespace quaxis::core::sync
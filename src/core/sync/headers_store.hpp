@@ -2,20 +2,57 @@
  * @file headers_store.hpp
  * @brief Хранилище заголовков блоков
  * 
- * Предоставляет in-memory хранение и доступ к заголовкам блоков
- * для синхронизации и валидации.
+ * Предоставляет хранение и доступ к заголовкам блоков для синхронизации
+ * и валидации. По умолчанию заголовки в памяти; open() переводит
+ * хранилище на файл:
+ * - файл - только добавление, 80 байт сериализованного заголовка на
+ *   высоту, запись 0 - genesis (по ней же отличается чужая сеть)
+ * - файл отображается mmap (MAP_SHARED, только чтение), новые записи
+ *   идут pwrite в конец: память общая с page cache, процессы на одном
+ *   файле не держат по копии
+ * - старт - mmap и проверка хвоста (prev_hash последних TAIL_CHECK
+ *   записей): запись, оборванная падением, отрезается
+ *
+ * Индекс хеш -> высота - открытая адресация по 64-битному префиксу
+ * хеша (4 байта на ячейку). Хеш высоты h - prev_hash записи h + 1,
+ * поэтому индекс строится без пересчёта SHA256d, хешируется только tip.
+ * С пулом потоков сводки и индекс при открытии строятся параллельно:
+ * сводки - по кускам арены, индекс - шардами (непрерывные диапазоны
+ * ячеек), каждый шард вставляет записи со своими домашними ячейками.
+ *
+ * После reset() со снапшота первая запись - заголовок контрольной точки
+ * ChainParams::checkpoints (base_height() > 0), высоты ниже неё не
+ * хранятся. В файле база определяется по хешу записи 0. Заголовок на
+ * высоте контрольной точки с другим хешем add_header() отклоняет.
+ *
+ * Последние REORG_WINDOW блоков активной цепи и боковые ветви от них -
+ * в дереве BlockIndex (skip-указатели, суммарная работа). accept_header()
+ * принимает заголовок любой ветви окна; ветвь, обогнавшая активную цепь
+ * по работе, становится активной сразу: записи выше развилки
+ * заменяются её заголовками. Развилка и предки - за O(log n).
+ *
+ * В памяти - только сводки активной цепи (HeaderSummary, 16 байт на
+ * высоту) и плоский индекс по префиксам хешей; полные заголовки читаются
+ * из отображённого файла. view() отдаёт снимок сводок без mutex и копии.
  */
 
 #pragma once
 
 #include "../primitives/block_header.hpp"
 #include "../chain/chain_params.hpp"
+#include "block_index.hpp"
+#include "headers_view.hpp"
+
+#include <atomic>
+#include <memory>
 
 #include <vector>
 #include <unordered_map>
 #include <optional>
 #include <mutex>
 #include <functional>
+#include <span>
+#include <string>
 
 // Hash для Hash256 - должен быть определён до использования
 namespace std {
@@ -32,22 +69,116 @@ struct hash<quaxis::Hash256> {
 };
 }
 
+namespace quaxis::core {
+class TaskPool;
+}
+
 namespace quaxis::core::sync {
 
+/**
+ * @brief Что accept_header() сделал с заголовком
+ */
+enum class HeaderStatus {
+    Extended,     ///< Продлил активную цепь
+    SideBranch,   ///< Добавлен в боковую ветвь (работы не больше активной)
+    Reorganized,  ///< Боковая ветвь обогнала активную цепь и стала активной
+    Known,        ///< Уже известен
+    Rejected      ///< Родитель неизвестен (или ниже окна), контрольная точка, ввод/вывод
+};
+
+/**
+ * @brief Результат accept_header()
+ */
+struct HeaderAccept {
+    HeaderStatus status{HeaderStatus::Rejected};
+    
+    /// @brief Высота заголовка
+    uint32_t height{0};
+    
+    /// @brief Reorganized: высота общего предка прежней и новой цепи
+    uint32_t fork_height{0};
+    
+    /// @brief Reorganized: блоков снято с активной цепи
+    std::size_t disconnected{0};
+    
+    /// @brief Reorganized: новые блоки активной цепи, fork_height + 1 .. tip
+    std::vector<BlockHeader> connected;
+};
+
 /**
  * @brief Хранилище заголовков блоков
  * 
- * Хранит заголовки в памяти с индексацией по хешу и высоте.
+ * Хранит заголовки в памяти или в файле с индексацией по хешу и высоте.
+ * 
+ * Thread-safety: методы thread-safe (mutex); view() mutex не берёт.
  */
 class HeadersStore {
 public:
+    /// @brief Записей хвоста, проверяемых при открытии файла
+    static constexpr uint32_t TAIL_CHECK = 64;
+    
+    /// @brief Глубина активной цепи в дереве ветвей (глубже reorg не бывает)
+    static constexpr uint32_t REORG_WINDOW = 2016;
+    
+    /// @brief Шардов индекса при параллельном перестроении
+    static constexpr std::size_t INDEX_SHARDS = 64;
+    
+    /// @brief Меньшие цепи перестраиваются в вызывающем потоке
+    static constexpr uint32_t PARALLEL_REBUILD_MIN = 4 * HEADERS_CHUNK;
+    
     /**
-     * @brief Создать хранилище для chain
+     * @brief Создать хранилище для chain (в памяти, только genesis)
      * 
      * @param params Параметры chain
      */
     explicit HeadersStore(const ChainParams& params);
     
+    ~HeadersStore();
+    
+    // Запрещаем копирование
+    HeadersStore(const HeadersStore&) = delete;
+    HeadersStore& operator=(const HeadersStore&) = delete;
+    
+    /**
+     * @brief Перейти на файл заголовков
+     * 
+     * Несуществующий файл создаётся с одним genesis. Существующий
+     * отображается в память, обрезанная запись и хвост с разрывом цепи
+     * prev_hash отрезаются. Заголовки, добавленные в память до open(),
+     * отбрасываются: источник - файл.
+     * 
+     * @param path Путь к файлу
+     * @param pool Потоки перестроения сводок и индекса (nullptr - в
+     *        вызывающем потоке)
+     * @return Успех или ошибка (ввод/вывод, genesis другой сети)
+     */
+    [[nodiscard]] Result<void> open(const std::string& path, TaskPool* pool = nullptr);
+    
+    /**
+     * @brief Хранилище на файле?
+     */
+    [[nodiscard]] bool is_persistent() const noexcept;
+    
+    /**
+     * @brief Заменить содержимое цепью заголовков (снапшот)
+     * 
+     * Связность и PoW проверяет вызывающий. Первый заголовок - genesis
+     * (base_height == 0) или заголовок контрольной точки base_height.
+     * Файл хранилища перезаписывается.
+     * 
+     * @param base_height Высота первого заголовка
+     * @param headers Заголовки base_height, base_height + 1, ...
+     * @param pool Потоки перестроения сводок и индекса (как в open())
+     * @return Успех или ошибка (не контрольная точка, ввод/вывод)
+     */
+    [[nodiscard]] Result<void> reset(uint32_t base_height, std::span<const BlockHeader> headers,
+                                     TaskPool* pool = nullptr);
+    
+    /**
+     * @brief Высота первой хранимой записи (0 - с genesis)
+     */
+    [[nodiscard]] uint32_t base_height() const noexcept;
+    
     /**
      * @brief Добавить заголовок
      * 
@@ -57,6 +188,42 @@ public:
      */
     bool add_header(const BlockHeader& header, uint32_t height);
     
+    /**
+     * @brief Добавить заголовок с заранее вычисленным хешем
+     * 
+     * @param header Заголовок блока
+     * @param height Высота блока
+     * @param hash header.hash() (например, из hash_headers())
+     * @return true если успешно добавлен
+     */
+    bool add_header(const BlockHeader& header, uint32_t height, const Hash256& hash);
+    
+    /**
+     * @brief Принять заголовок любой ветви окна REORG_WINDOW
+     * 
+     * Заголовок на tip продлевает цепь, на другой известный блок -
+     * боковую ветвь. Ветвь с большей суммарной работой становится
+     * активной: записи выше развилки заменяются (результат Reorganized).
+     * 
+     * @param header Заголовок (PoW проверяет вызывающий)
+     * @param hash header.hash()
+     */
+    [[nodiscard]] HeaderAccept accept_header(const BlockHeader& header, const Hash256& hash);
+    
+    /**
+     * @brief Высота общего предка двух блоков (активной цепи или ветвей окна)
+     * 
+     * @return nullopt если один из блоков неизвестен
+     */
+    [[nodiscard]] std::optional<uint32_t> find_fork(const Hash256& a, const Hash256& b) const;
+    
+    /**
+     * @brief Хеш предка блока на высоте height (O(log n) для ветвей)
+     * 
+     * @return nullopt если блок неизвестен или height выше него
+     */
+    [[nodiscard]] std::optional<Hash256> get_ancestor(const Hash256& hash, uint32_t height) const;
+    
     /**
      * @brief Получить заголовок по хешу
      * 
@@ -87,6 +254,14 @@ public:
         const Hash256& hash
     ) const;
     
+    /**
+     * @brief Получить хеш блока по высоте (без пересчёта SHA256d)
+     * 
+     * @param height Высота блока
+     * @return std::optional<Hash256> Хеш или nullopt
+     */
+    [[nodiscard]] std::optional<Hash256> get_hash(uint32_t height) const;
+    
     /**
      * @brief Получить заголовок вершины цепи
      * 
@@ -116,6 +291,14 @@ public:
      */
     [[nodiscard]] bool has_header(const Hash256& hash) const;
     
+    /**
+     * @brief Снимок сводок активной цепи без блокировки и копирования
+     * 
+     * Снимок не меняется: блоки, добавленные позже, и reorg в нём
+     * не видны. Для MTP и retarget на каждом tip.
+     */
+    [[nodiscard]] HeadersView view() const noexcept;
+    
     /**
      * @brief Получить последние N заголовков
      * 
@@ -149,15 +332,67 @@ public:
     void clear();
     
 private:
+    /// @brief Пустая ячейка индекса
+    static constexpr uint32_t EMPTY = UINT32_MAX;
+    
+    /// @brief Начальное отображение файла (записей), дальше - удвоение
+    static constexpr std::size_t MIN_MAP_RECORDS = 16384;
+    
+    // Позиции записей (pos) считаются от base_
+    [[nodiscard]] const uint8_t* record(uint32_t pos) const noexcept;
+    [[nodiscard]] const HeaderSummary& summary(uint32_t pos) const noexcept;
+    [[nodiscard]] Hash256 hash_at(uint32_t pos) const noexcept;
+    [[nodiscard]] std::optional<uint32_t> find(const Hash256& hash) const noexcept;
+    void index_insert(uint32_t pos, const Hash256& hash);
+    void rebuild_index(std::size_t slots, TaskPool* pool = nullptr);
+    void rebuild_index_sharded(TaskPool& pool);
+    void rebuild(TaskPool* pool);
+    [[nodiscard]] bool append_record(const uint8_t* data);
+    [[nodiscard]] bool push_record(const BlockHeader& header, const Hash256& hash);
+    [[nodiscard]] bool truncate_records(uint32_t records);
+    [[nodiscard]] bool extend_locked(const BlockHeader& header, const Hash256& hash);
+    [[nodiscard]] bool is_active(const BlockIndexEntry& entry) const noexcept;
+    void reset_tree();
+    void arena_rebuild(TaskPool* pool);
+    void arena_append(const BlockHeader& header, const Hash256& hash);
+    void arena_truncate(uint32_t records);
+    [[nodiscard]] bool replace_records(uint32_t base, const uint8_t* data, std::size_t records,
+                                       TaskPool* pool = nullptr);
+    [[nodiscard]] bool map_file(std::size_t records);
+    void load_tip();
+    void close_file() noexcept;
+    
     const ChainParams& params_;
     
     mutable std::mutex mutex_;
     
-    // Заголовки по высоте
-    std::vector<BlockHeader> headers_;
+    // Записи по высоте: memory_ или отображённый файл
+    std::vector<uint8_t> memory_;
+    int fd_{-1};
+    const uint8_t* map_{nullptr};
+    std::size_t map_records_{0};
+    uint32_t base_{0};
+    uint32_t count_{0};
+    
+    // Индекс хеш -> высота (открытая адресация по префиксу хеша, размер -
+    // степень двойки). Префикс сравнивается со сводкой, полный хеш читается
+    // из записи только при совпадении. Ячейки записей, снятых reorg,
+    // остаются занятыми до перестроения.
+    std::vector<uint32_t> index_;
+    uint32_t index_stale_{0};
+    
+    // Окно активной цепи и боковые ветви; tree_tip_ - узел tip
+    BlockIndex tree_;
+    uint32_t tree_tip_{0};
+    
+    // Сводки: снимки для читателей без mutex (пишется под mutex_);
+    // hot_ - текущая арена для писателя и поиска под mutex_
+    std::atomic<std::shared_ptr<HeadersArena>> arena_;
+    HeadersArena* hot_{nullptr};
     
-    // Индекс хеш -> высота
-    std::unordered_map<Hash256, uint32_t> hash_index_;
+    // Заголовок и хеш последней записи (проверка prev_hash без пересчёта)
+    BlockHeader tip_;
+    Hash256 tip_hash_{};
     
     // Genesis заголовок
     BlockHeader genesis_;
@@ -4,26 +4,185 @@
  */
 
 #include "headers_sync.hpp"
+#include "../byte_order.hpp"
+#include "../task_pool.hpp"
 #include "../validation/pow_validator.hpp"
 
+#include <algorithm>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <thread>
+#include <vector>
+
 namespace quaxis::core::sync {
 
-HeadersSync::HeadersSync(const ChainParams& params)
+// =============================================================================
+// HeadersSync
+// =============================================================================
+
+HeadersSync::HeadersSync(const ChainParams& params, std::size_t verify_threads)
     : params_(params)
-    , store_(std::make_unique<HeadersStore>(params)) {}
+    , store_(std::make_unique<HeadersStore>(params))
+    , verify_threads_(verify_threads != 0
+          ? verify_threads
+          : std::max<std::size_t>(std::thread::hardware_concurrency(), 1)) {}
 
 HeadersSync::~HeadersSync() {
     stop();
 }
 
+Result<void> HeadersSync::open_store(const std::string& path) {
+    std::lock_guard<std::mutex> process_lock(process_mutex_);
+    recent_.clear();
+    return store_->open(path, worker_pool());
+}
+
+Result<void> HeadersSync::load_snapshot(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        return Err<void>(ErrorCode::ConfigNotFound,
+                         std::format("Снапшот заголовков {} не найден", path));
+    }
+    std::vector<uint8_t> data{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+    
+    if (data.size() <= HEADERS_SNAPSHOT_PREFIX ||
+        std::memcmp(data.data(), HEADERS_SNAPSHOT_MAGIC.data(), HEADERS_SNAPSHOT_MAGIC.size()) != 0 ||
+        (data.size() - HEADERS_SNAPSHOT_PREFIX) % BLOCK_HEADER_SIZE != 0) {
+        return Err<void>(ErrorCode::BitcoinInvalidBlock,
+                         std::format("Неверный формат снапшота заголовков {}", path));
+    }
+    
+    const uint32_t base = read_le32(data.data() + HEADERS_SNAPSHOT_MAGIC.size());
+    const std::size_t count = (data.size() - HEADERS_SNAPSHOT_PREFIX) / BLOCK_HEADER_SIZE;
+    const uint32_t tip = base + static_cast<uint32_t>(count - 1);
+    if (tip <= store_->get_tip_height()) {
+        return {};  // Своя цепь уже не ниже снапшота
+    }
+    
+    std::vector<BlockHeader> headers(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        headers[i] = BlockHeader::deserialize(data.data() + HEADERS_SNAPSHOT_PREFIX + i * BLOCK_HEADER_SIZE);
+    }
+    
+    // Первый заголовок - genesis или контрольная точка (сверяет reset)
+    if (base != 0 && !params_.find_checkpoint(base)) {
+        return Err<void>(ErrorCode::BitcoinInvalidBlock,
+                         std::format("Снапшот начинается не с контрольной точки (высота {})", base));
+    }
+    
+    // PoW - только после последней контрольной точки снапшота
+    std::size_t pow_from = 1;
+    for (const auto& checkpoint : params_.checkpoints) {
+        if (checkpoint.height >= base && checkpoint.height <= tip) {
+            pow_from = checkpoint.height - base + 1;
+        }
+    }
+    
+    std::vector<Hash256> hashes(count);
+    const std::size_t valid = verify_pow(headers, hashes, pow_from);
+    if (valid != count) {
+        return Err<void>(ErrorCode::BitcoinInvalidBlock,
+                         std::format("Снапшот: невалидный PoW на высоте {}", base + valid));
+    }
+    
+    for (std::size_t i = 0; i < count; ++i) {
+        const uint32_t height = base + static_cast<uint32_t>(i);
+        if (i > 0 && headers[i].prev_hash != hashes[i - 1]) {
+            return Err<void>(ErrorCode::BitcoinInvalidBlock,
+                             std::format("Снапшот: разрыв цепи на высоте {}", height));
+        }
+        const auto* checkpoint = params_.find_checkpoint(height);
+        if (checkpoint && checkpoint->hash != hashes[i]) {
+            return Err<void>(ErrorCode::BitcoinInvalidBlock,
+                             std::format("Снапшот: другой хеш контрольной точки {}", height));
+        }
+    }
+    
+    std::lock_guard<std::mutex> process_lock(process_mutex_);
+    recent_.clear();
+    return store_->reset(base, headers, worker_pool());
+}
+
+Result<void> HeadersSync::save_snapshot(const std::string& path) const {
+    const uint32_t base = store_->base_height();
+    auto headers = store_->get_headers_range(base, store_->get_tip_height());
+    
+    std::vector<uint8_t> data(HEADERS_SNAPSHOT_PREFIX + headers.size() * BLOCK_HEADER_SIZE);
+    std::memcpy(data.data(), HEADERS_SNAPSHOT_MAGIC.data(), HEADERS_SNAPSHOT_MAGIC.size());
+    write_le32(data.data() + HEADERS_SNAPSHOT_MAGIC.size(), base);
+    for (std::size_t i = 0; i < headers.size(); ++i) {
+        auto serialized = headers[i].serialize();
+        std::memcpy(data.data() + HEADERS_SNAPSHOT_PREFIX + i * BLOCK_HEADER_SIZE,
+                    serialized.data(), serialized.size());
+    }
+    
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    if (!out) {
+        return Err<void>(ErrorCode::SystemIOError,
+                         std::format("Не удалось записать снапшот заголовков {}", path));
+    }
+    return {};
+}
+
+void HeadersSync::add_peer(PeerAddress address) {
+    peer_addresses_.push_back(std::move(address));
+}
+
 void HeadersSync::start() {
-    status_.store(SyncStatus::Syncing, std::memory_order_release);
+    if (peer_addresses_.empty()) {
+        status_.store(SyncStatus::Syncing, std::memory_order_release);
+        return;
+    }
+    if (!peers_.empty()) {
+        return;
+    }
+    
+    status_.store(SyncStatus::Connecting, std::memory_order_release);
+    for (const auto& address : peer_addresses_) {
+        peers_.push_back(std::make_unique<P2pPeer>(
+            *this, params_.mainnet, address, [this](PeerState) { update_peer_status(); }));
+    }
+    for (auto& peer : peers_) {
+        peer->start();
+    }
 }
 
 void HeadersSync::stop() {
+    for (auto& peer : peers_) {
+        peer->stop();
+    }
+    peers_.clear();
     status_.store(SyncStatus::Stopped, std::memory_order_release);
 }
 
+std::size_t HeadersSync::connected_peers() const {
+    return static_cast<std::size_t>(std::count_if(peers_.begin(), peers_.end(), [](const auto& peer) {
+        auto state = peer->state();
+        return state == PeerState::Syncing || state == PeerState::Synchronized;
+    }));
+}
+
+void HeadersSync::update_peer_status() {
+    // Лучшее состояние среди peer: хватает одного догнавшего цепь
+    SyncStatus status = SyncStatus::Connecting;
+    for (const auto& peer : peers_) {
+        auto state = peer->state();
+        if (state == PeerState::Synchronized) {
+            status = SyncStatus::Synchronized;
+            break;
+        }
+        if (state == PeerState::Syncing) {
+            status = SyncStatus::Syncing;
+        }
+    }
+    if (status_.load(std::memory_order_acquire) != SyncStatus::Stopped) {
+        status_.store(status, std::memory_order_release);
+    }
+}
+
 SyncStatus HeadersSync::status() const noexcept {
     return status_.load(std::memory_order_acquire);
 }
@@ -71,55 +230,199 @@ std::optional<BlockHeader> HeadersSync::get_header(uint32_t height) const {
     return store_->get_by_height(height);
 }
 
+HeadersView HeadersSync::headers_view() const noexcept {
+    return store_->view();
+}
+
+EpochDifficulty HeadersSync::get_next_work() const {
+    const Hash256 tip_hash = store_->get_tip_hash();
+    {
+        std::lock_guard<std::mutex> lock(work_mutex_);
+        if (next_work_.bits != 0 && next_work_.prev_hash == tip_hash) {
+            return next_work_;
+        }
+    }
+    
+    // Tip сменился без process_headers (снапшот, открытие файла)
+    auto work = compute_next_work();
+    std::lock_guard<std::mutex> lock(work_mutex_);
+    next_work_ = work;
+    return work;
+}
+
+EpochDifficulty HeadersSync::compute_next_work() const {
+    const auto& difficulty = params_.difficulty;
+    const auto headers = store_->view();
+    const uint32_t tip_height = headers.tip_height();
+    const HeaderSummary* tip = headers.get(tip_height);
+    
+    EpochDifficulty work;
+    work.height = tip_height + 1;
+    work.prev_hash = store_->get_hash(tip_height).value_or(Hash256{});
+    work.epoch_start = epoch_start_height(difficulty, work.height);
+    work.bits = tip->bits;
+    
+    if (is_retarget_height(difficulty, work.height)) {
+        // Первый блок эпохи ниже снапшота - остаются bits tip
+        if (const auto* first = headers.get(work.height - difficulty.adjustment_interval)) {
+            work.bits = calculate_next_bits(difficulty, tip->bits, first->timestamp, tip->timestamp);
+        }
+    } else if (difficulty.allow_min_difficulty) {
+        // Bits последнего блока не минимальной сложности (или первого в эпохе)
+        uint32_t height = tip_height;
+        const HeaderSummary* walk = tip;
+        while (height > headers.base_height() && !is_retarget_height(difficulty, height) &&
+               walk->bits == difficulty.pow_limit_bits) {
+            walk = headers.get(--height);
+        }
+        work.bits = walk->bits;
+        work.min_difficulty_after = tip->timestamp + min_difficulty_delay(difficulty);
+    }
+    
+    work.target = bits_to_target(work.bits);
+    work.difficulty = bits_to_difficulty(work.bits);
+    return work;
+}
+
+void HeadersSync::prepare_next_work() {
+    auto work = compute_next_work();
+    std::lock_guard<std::mutex> lock(work_mutex_);
+    next_work_ = work;
+}
+
 void HeadersSync::on_new_block(NewBlockCallback callback) {
     std::lock_guard<std::mutex> lock(callback_mutex_);
     new_block_callback_ = std::move(callback);
 }
 
-bool HeadersSync::process_headers(const std::vector<BlockHeader>& headers) {
+void HeadersSync::on_reorg(ReorgCallback callback) {
+    std::lock_guard<std::mutex> lock(callback_mutex_);
+    reorg_callback_ = std::move(callback);
+}
+
+TaskPool* HeadersSync::worker_pool() {
+    if (verify_threads_ <= 1) {
+        return nullptr;
+    }
+    if (!pool_) {
+        pool_ = std::make_unique<TaskPool>(verify_threads_ - 1);
+    }
+    return pool_.get();
+}
+
+std::size_t HeadersSync::verify_pow(
+    std::span<const BlockHeader> headers,
+    std::span<Hash256> hashes,
+    std::size_t pow_from
+) {
     validation::PowValidator validator(params_);
+    const std::size_t chunks = (headers.size() + VERIFY_CHUNK - 1) / VERIFY_CHUNK;
+    std::atomic<std::size_t> first_invalid{headers.size()};
     
-    uint32_t current_height = store_->get_tip_height();
+    // Кусок: пакетный SHA256d и hash <= target (validate_pow_batch)
+    auto verify_chunk = [&](std::size_t chunk) {
+        const std::size_t start = chunk * VERIFY_CHUNK;
+        const std::size_t n = std::min(VERIFY_CHUNK, headers.size() - start);
+        std::array<uint64_t, validation::pow_bitmap_words(VERIFY_CHUNK)> bitmap{};
+        (void)validator.validate_pow_batch(headers.subspan(start, n), bitmap, hashes.subspan(start, n));
+        for (std::size_t i = std::max(start, pow_from); i < start + n; ++i) {
+            const std::size_t bit = i - start;
+            if (((bitmap[bit / 64] >> (bit % 64)) & 1) == 0) {
+                std::size_t current = first_invalid.load(std::memory_order_relaxed);
+                while (i < current &&
+                       !first_invalid.compare_exchange_weak(current, i, std::memory_order_relaxed)) {
+                }
+                break;
+            }
+        }
+    };
     
-    for (const auto& header : headers) {
-        // Проверяем PoW
-        if (!validator.validate_pow(header)) {
-            return false;
+    if (verify_threads_ <= 1 || headers.size() < PARALLEL_MIN) {
+        for (std::size_t chunk = 0; chunk < chunks; ++chunk) {
+            verify_chunk(chunk);
         }
+    } else {
+        worker_pool()->run(chunks, verify_chunk);
+    }
+    
+    return first_invalid.load(std::memory_order_relaxed);
+}
+
+bool HeadersSync::process_headers(const std::vector<BlockHeader>& headers) {
+    // Повтор недавнего tip от другого peer: ни mutex, ни SHA256d
+    if (!headers.empty() && std::all_of(headers.begin(), headers.end(), [this](const BlockHeader& header) {
+            return recent_.contains(RecentHashFilter::header_key(header));
+        })) {
+        filtered_duplicates_.add();
+        return true;
+    }
+    
+    std::lock_guard<std::mutex> process_lock(process_mutex_);
+    
+    // Хеши и PoW всей пачки сразу: каждый заголовок хешируется один раз
+    std::vector<Hash256> hashes(headers.size());
+    const std::size_t valid = verify_pow(headers, hashes);
+    
+    // Связность и добавление - по порядку
+    for (std::size_t i = 0; i < valid; ++i) {
+        const auto& header = headers[i];
         
-        // Добавляем заголовок
-        uint32_t new_height = current_height + 1;
-        if (!store_->add_header(header, new_height)) {
-            return false;
+        // Активная цепь, боковая ветвь или переключение на ветвь с большей работой
+        const auto accepted = store_->accept_header(header, hashes[i]);
+        if (accepted.status != HeaderStatus::Rejected) {
+            recent_.insert(RecentHashFilter::header_key(header));
+        }
+        switch (accepted.status) {
+            case HeaderStatus::Known:       // объявлен другим peer или повтор getheaders
+            case HeaderStatus::SideBranch:  // ждём, обгонит ли ветвь активную цепь
+                continue;
+            case HeaderStatus::Rejected:
+                return false;
+            case HeaderStatus::Reorganized:
+            case HeaderStatus::Extended:
+                break;
         }
         
-        current_height = new_height;
+        // Сложность следующего блока (и новой эпохи после её последнего
+        // блока) - здесь, в потоке P2P, а не при построении шаблона.
+        // Внутри пачки (начальная синхронизация) - только для последнего
+        if (i + 1 == valid) {
+            prepare_next_work();
+        }
         
-        // Вызываем callback
+        // Вызываем callbacks
         {
             std::lock_guard<std::mutex> lock(callback_mutex_);
+            if (accepted.status == HeaderStatus::Reorganized && reorg_callback_) {
+                reorg_callback_(accepted);
+            }
             if (new_block_callback_) {
-                new_block_callback_(header, new_height);
+                new_block_callback_(header, accepted.height);
             }
         }
     }
     
-    return true;
+    return valid == headers.size();
+}
+
+uint64_t HeadersSync::filtered_duplicates() const noexcept {
+    return filtered_duplicates_.load();
 }
 
 std::vector<Hash256> HeadersSync::get_block_locator() const {
     std::vector<Hash256> locator;
     
+    const uint32_t base = store_->base_height();
     uint32_t height = store_->get_tip_height();
     int step = 1;
     
-    while (height > 0) {
-        auto header = store_->get_by_height(height);
-        if (header) {
-            locator.push_back(header->hash());
+    while (height > base) {
+        auto hash = store_->get_hash(height);
+        if (hash) {
+            locator.push_back(*hash);
         }
         
-        if (height < static_cast<uint32_t>(step)) {
+        if (height - base < static_cast<uint32_t>(step)) {
             break;
         }
         height -= static_cast<uint32_t>(step);
@@ -130,10 +433,10 @@ std::vector<Hash256> HeadersSync::get_block_locator() const {
         }
     }
     
-    // Добавляем genesis
-    auto genesis = store_->get_by_height(0);
+    // Добавляем genesis (или контрольную точку снапшота)
+    auto genesis = store_->get_hash(base);
     if (genesis) {
-        locator.push_back(genesis->hash());
+        locator.push_back(*genesis);
     }
     
     return locator;
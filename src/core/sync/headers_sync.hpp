@@ -3,25 +3,73 @@
  * @brief Универсальный синхронизатор заголовков
  * 
  * Предоставляет синхронизацию заголовков для любой AuxPoW монеты.
+ * 
+ * process_headers() проверяет пачку в две стадии: SHA256d и PoW
+ * (hash <= target из bits) - параллельно на пуле потоков кусками по
+ * VERIFY_CHUNK заголовков (пакетный hash_headers()), связность prev_hash
+ * и добавление в хранилище - последовательно. Пул создаётся при первой
+ * пачке от PARALLEL_MIN заголовков (headers сообщение - до 2000).
+ * 
+ * Снапшот (load_snapshot): цепь заголовков от контрольной точки
+ * ChainParams::checkpoints. Подписи нет - доверие даёт сборка: первый
+ * заголовок и все контрольные точки внутри обязаны совпасть с
+ * вкомпилированными хешами, цепь prev_hash связывает остальное. PoW
+ * проверяется только после последней контрольной точки (assumevalid).
+ * 
+ * P2P (add_peer): start() подключается ко всем peer (P2pPeer) и
+ * запрашивает у них новые блоки в high-bandwidth режиме cmpctblock.
+ * Заголовки поступают в process_headers() из потоков peer, on_new_block
+ * срабатывает там же. Без peer заголовки передаются извне, как раньше.
+ * 
+ * Повторы (тот же tip от нескольких peer) отсекаются на входе
+ * process_headers() фильтром недавних заголовков (RecentHashFilter) -
+ * до mutex, SHA256d и PoW.
  */
 
 #pragma once
 
 #include "../chain/chain_params.hpp"
+#include "../chain/difficulty.hpp"
 #include "../primitives/block_header.hpp"
 #include "headers_store.hpp"
+#include "p2p_peer.hpp"
+#include "recent_hash_filter.hpp"
+#include "../stats_counter.hpp"
 
 #include <functional>
 #include <memory>
 #include <atomic>
+#include <array>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace quaxis::core {
+class TaskPool;
+}
 
 namespace quaxis::core::sync {
 
+/// @brief Magic файла снапшота заголовков
+inline constexpr std::array<uint8_t, 8> HEADERS_SNAPSHOT_MAGIC{'Q', 'X', 'H', 'D', 'R', 'S', '0', '1'};
+
+/// @brief Заголовок файла снапшота: magic + высота первого заголовка (LE)
+inline constexpr std::size_t HEADERS_SNAPSHOT_PREFIX = HEADERS_SNAPSHOT_MAGIC.size() + 4;
+
 /**
  * @brief Callback при получении нового блока
  */
 using NewBlockCallback = std::function<void(const BlockHeader&, uint32_t height)>;
 
+/**
+ * @brief Callback при переключении на ветвь с большей работой
+ * 
+ * Вызывается до new_block_callback нового tip; HeaderAccept содержит
+ * развилку, число снятых блоков и новые блоки активной цепи
+ * (для TemplateGenerator::switch_chain_tip).
+ */
+using ReorgCallback = std::function<void(const HeaderAccept&)>;
+
 /**
  * @brief Статус синхронизации
  */
@@ -53,12 +101,20 @@ enum class SyncStatus {
  */
 class HeadersSync {
 public:
+    /// @brief Заголовков на одну задачу проверки PoW
+    static constexpr std::size_t VERIFY_CHUNK = 128;
+    
+    /// @brief Меньшие пачки проверяются в вызывающем потоке
+    static constexpr std::size_t PARALLEL_MIN = 2 * VERIFY_CHUNK;
+    
     /**
      * @brief Создать синхронизатор для chain
      * 
      * @param params Параметры chain
+     * @param verify_threads Потоков проверки PoW и перестроения индекса
+     *        заголовков при открытии (0 - по числу ядер, 1 - без пула)
      */
-    explicit HeadersSync(const ChainParams& params);
+    explicit HeadersSync(const ChainParams& params, std::size_t verify_threads = 0);
     
     ~HeadersSync();
     
@@ -70,16 +126,61 @@ public:
     // Управление
     // =========================================================================
     
+    /**
+     * @brief Хранить заголовки в файле (см. HeadersStore::open)
+     * 
+     * Сводки и индекс хеш -> высота строятся в пуле verify_threads.
+     * 
+     * @param path Путь к файлу заголовков
+     * @return Успех или ошибка
+     */
+    [[nodiscard]] Result<void> open_store(const std::string& path);
+    
+    /**
+     * @brief Начать цепь со снапшота заголовков
+     * 
+     * Формат: HEADERS_SNAPSHOT_MAGIC, высота первого заголовка (uint32 LE),
+     * затем заголовки по 80 байт. Снапшот не выше текущего tip не
+     * применяется.
+     * 
+     * @param path Путь к файлу снапшота
+     * @return Успех или ошибка (формат, контрольная точка, связность, PoW)
+     */
+    [[nodiscard]] Result<void> load_snapshot(const std::string& path);
+    
+    /**
+     * @brief Записать хранимую цепь как снапшот
+     * 
+     * @param path Путь к файлу снапшота
+     * @return Успех или ошибка ввода/вывода
+     */
+    [[nodiscard]] Result<void> save_snapshot(const std::string& path) const;
+    
+    /**
+     * @brief Добавить P2P peer (до start())
+     * 
+     * @param address Адрес peer (port 0 - порт сети по умолчанию)
+     */
+    void add_peer(PeerAddress address);
+    
     /**
      * @brief Запустить синхронизацию
+     * 
+     * С peer - подключение ко всем (статус Connecting до первого
+     * handshake), без peer - ожидание заголовков извне.
      */
     void start();
     
     /**
-     * @brief Остановить синхронизацию
+     * @brief Остановить синхронизацию (и соединения с peer)
      */
     void stop();
     
+    /**
+     * @brief Количество peer с завершённым handshake
+     */
+    [[nodiscard]] std::size_t connected_peers() const;
+    
     /**
      * @brief Получить текущий статус
      */
@@ -136,6 +237,17 @@ public:
      */
     [[nodiscard]] double get_difficulty() const noexcept;
     
+    /**
+     * @brief Сложность следующего блока (tip + 1)
+     * 
+     * Считается при приходе tip, до new_block_callback: на высоте
+     * пересчёта bits готовы так же, как на любой другой. Для testnet
+     * (allow_min_difficulty) - bits с учётом правила min-difficulty,
+     * блоку позже min_difficulty_after - pow_limit_bits
+     * (EpochDifficulty::bits_for).
+     */
+    [[nodiscard]] EpochDifficulty get_next_work() const;
+    
     /**
      * @brief Получить заголовок по высоте
      * 
@@ -144,6 +256,13 @@ public:
      */
     [[nodiscard]] std::optional<BlockHeader> get_header(uint32_t height) const;
     
+    /**
+     * @brief Снимок сводок активной цепи (timestamp, bits, префикс хеша)
+     * 
+     * Для пересчёта MTP и retarget: см. HeadersStore::view().
+     */
+    [[nodiscard]] HeadersView headers_view() const noexcept;
+    
     // =========================================================================
     // Callbacks
     // =========================================================================
@@ -155,6 +274,13 @@ public:
      */
     void on_new_block(NewBlockCallback callback);
     
+    /**
+     * @brief Установить callback для reorg
+     * 
+     * @param callback Функция, вызываемая при смене активной ветви
+     */
+    void on_reorg(ReorgCallback callback);
+    
     // =========================================================================
     // Обработка сообщений (для P2P модуля)
     // =========================================================================
@@ -162,6 +288,12 @@ public:
     /**
      * @brief Обработать полученные заголовки
      * 
+     * Заголовки до первого невалидного добавляются; PoW проверяется
+     * параллельно, связность - по порядку. Уже известные заголовки
+     * пропускаются (тот же блок от нескольких peer); пачка только из
+     * недавно принятых заголовков отбрасывается сразу, без блокировок.
+     * Потокобезопасно: пачки разных peer обрабатываются по очереди.
+     * 
      * @param headers Список заголовков
      * @return bool true если все заголовки валидны и добавлены
      */
@@ -174,16 +306,73 @@ public:
      */
     [[nodiscard]] std::vector<Hash256> get_block_locator() const;
     
+    /**
+     * @brief Пачек, отброшенных фильтром недавних заголовков
+     */
+    [[nodiscard]] uint64_t filtered_duplicates() const noexcept;
+
 private:
+    /**
+     * @brief Хеши и PoW пачки
+     * 
+     * @param pow_from PoW проверяется с этого индекса (до него - только хеши)
+     * @return Индекс первого заголовка с невалидным PoW (size() если все валидны)
+     */
+    std::size_t verify_pow(
+        std::span<const BlockHeader> headers,
+        std::span<Hash256> hashes,
+        std::size_t pow_from = 0
+    );
+    
+    /**
+     * @brief Статус по состояниям peer
+     */
+    void update_peer_status();
+    
+    /**
+     * @brief Пул проверки PoW и перестроения хранилища (под process_mutex_)
+     * 
+     * @return nullptr при verify_threads = 1
+     */
+    [[nodiscard]] TaskPool* worker_pool();
+    
+    /**
+     * @brief Посчитать сложность блока tip + 1 по сводкам заголовков
+     */
+    [[nodiscard]] EpochDifficulty compute_next_work() const;
+    
+    /**
+     * @brief Обновить кэш next_work_ (после смены tip)
+     */
+    void prepare_next_work();
+    
     const ChainParams& params_;
     
     std::unique_ptr<HeadersStore> store_;
     
+    std::size_t verify_threads_;
+    std::unique_ptr<TaskPool> pool_;
+    
+    // Пачки заголовков от разных peer - по очереди
+    std::mutex process_mutex_;
+    
+    // Недавно принятые заголовки (пишет process_headers под process_mutex_)
+    RecentHashFilter recent_;
+    RelaxedCounter filtered_duplicates_;
+    
+    std::vector<PeerAddress> peer_addresses_;
+    std::vector<std::unique_ptr<P2pPeer>> peers_;
+    
     std::atomic<SyncStatus> status_{SyncStatus::Stopped};
     
     NewBlockCallback new_block_callback_;
+    ReorgCallback reorg_callback_;
     
     mutable std::mutex callback_mutex_;
+    
+    // Сложность блока tip + 1
+    mutable std::mutex work_mutex_;
+    mutable EpochDifficulty next_work_;
 };
 
 } // namespace quaxis::core::sync
@@ -0,0 +1,147 @@
+/**
+ * @file headers_view.hpp
+ * @brief Неизменяемые снимки заголовков HeadersStore без блокировок
+ *
+ * Горячее представление активной цепи - HeaderSummary по 16 байт на
+ * высоту: префикс хеша, timestamp и bits (всё, что нужно MTP и retarget).
+ * Полные заголовки - в отображённом файле (холодные страницы).
+ *
+ * Сводки лежат в кусках по HEADERS_CHUNK, которые не перемещаются и не
+ * переписываются. Писатель (один, под mutex хранилища) дописывает сводку
+ * за опубликованный размер и публикует размер;
+ * новый кусок, reorg и замена цепи публикуют новую арену, куски которой
+ * старые снимки не видят. Читатель берёт снимок - арену и размер - и
+ * получает std::span сводок без mutex и копирования: MTP и retarget на
+ * каждом tip не выделяют память и не трогают файл.
+ */
+
+#pragma once
+
+#include "../primitives/block_header.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace quaxis::core::sync {
+
+/// @brief Сводок в куске арены
+inline constexpr uint32_t HEADERS_CHUNK = 4096;
+
+/**
+ * @brief Горячая сводка заголовка (16 байт вместо 80)
+ */
+struct HeaderSummary {
+    uint64_t hash_prefix{0};  ///< Первые 8 байт хеша (little-endian)
+    uint32_t timestamp{0};
+    uint32_t bits{0};
+
+    [[nodiscard]] static HeaderSummary from(const BlockHeader& header, const Hash256& hash) noexcept {
+        HeaderSummary summary;
+        std::memcpy(&summary.hash_prefix, hash.data(), sizeof(summary.hash_prefix));
+        summary.timestamp = header.timestamp;
+        summary.bits = header.bits;
+        return summary;
+    }
+};
+
+static_assert(sizeof(HeaderSummary) == 16);
+
+/**
+ * @brief Арена сводок активной цепи
+ *
+ * Куски до size неизменны; писатель дописывает только в последний кусок
+ * за size. Арена, вытесненная новой, больше не меняется.
+ */
+struct HeadersArena {
+    using Chunk = std::array<HeaderSummary, HEADERS_CHUNK>;
+
+    std::vector<std::shared_ptr<Chunk>> chunks;
+
+    /// @brief Высота сводки 0 первого куска
+    uint32_t base{0};
+
+    /// @brief Опубликованных сводок (release писателем)
+    std::atomic<uint32_t> size{0};
+};
+
+/**
+ * @brief Снимок активной цепи на момент HeadersStore::view()
+ *
+ * Копируется дёшево (shared_ptr); держит куски, пока жив. Блоки,
+ * добавленные после снимка, в нём не видны, reorg его не меняет.
+ * Полный заголовок - HeadersStore::get_by_height().
+ */
+class HeadersView {
+public:
+    HeadersView() = default;
+
+    HeadersView(std::shared_ptr<const HeadersArena> arena, uint32_t size) noexcept
+        : arena_(std::move(arena)), size_(size) {}
+
+    [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+
+    [[nodiscard]] uint32_t size() const noexcept { return size_; }
+
+    [[nodiscard]] uint32_t base_height() const noexcept { return arena_ ? arena_->base : 0; }
+
+    /// @brief Высота последнего блока (снимок не пуст)
+    [[nodiscard]] uint32_t tip_height() const noexcept { return base_height() + size_ - 1; }
+
+    /**
+     * @brief Сводка на высоте height или nullptr
+     */
+    [[nodiscard]] const HeaderSummary* get(uint32_t height) const noexcept {
+        if (!arena_ || height < arena_->base || height - arena_->base >= size_) {
+            return nullptr;
+        }
+        const uint32_t pos = height - arena_->base;
+        return &(*arena_->chunks[pos / HEADERS_CHUNK])[pos % HEADERS_CHUNK];
+    }
+
+    /**
+     * @brief До count сводок подряд с высоты height
+     *
+     * Span не переходит границу куска: короче count, если диапазон
+     * пересекает её или конец снимка. Весь диапазон - for_each().
+     */
+    [[nodiscard]] std::span<const HeaderSummary> contiguous(uint32_t height, uint32_t count) const noexcept {
+        if (!arena_ || height < arena_->base || height - arena_->base >= size_) {
+            return {};
+        }
+        const uint32_t pos = height - arena_->base;
+        const uint32_t offset = pos % HEADERS_CHUNK;
+        const uint32_t length = std::min({count, size_ - pos, HEADERS_CHUNK - offset});
+        return std::span<const HeaderSummary>(arena_->chunks[pos / HEADERS_CHUNK]->data() + offset, length);
+    }
+
+    /**
+     * @brief Обойти сводки start_height..end_height (включительно) кусками
+     *
+     * @param fn Вызывается с std::span<const HeaderSummary> по порядку высот
+     */
+    template <typename Fn>
+    void for_each(uint32_t start_height, uint32_t end_height, Fn&& fn) const {
+        if (empty() || end_height < base_height()) {
+            return;
+        }
+        uint32_t height = std::max(start_height, base_height());
+        end_height = std::min(end_height, tip_height());
+        while (height <= end_height) {
+            auto span = contiguous(height, end_height - height + 1);
+            fn(span);
+            height += static_cast<uint32_t>(span.size());
+        }
+    }
+
+private:
+    std::shared_ptr<const HeadersArena> arena_;
+    uint32_t size_{0};
+};
+
+} // namespace quaxis::core::sync
@@ -0,0 +1,471 @@
+/**
+ * @file p2p_peer.cpp
+ * @brief Реализация минимального P2P клиента
+ */
+
+#include "p2p_peer.hpp"
+#include "headers_sync.hpp"
+#include "../byte_order.hpp"
+#include "../serialization/stream.hpp"
+#include "../../crypto/sha256.hpp"
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <condition_variable>
+#include <cstring>
+#include <ctime>
+#include <mutex>
+#include <random>
+#include <thread>
+
+namespace quaxis::core::sync {
+
+namespace {
+
+/// @brief Длина поля command в заголовке сообщения
+constexpr std::size_t COMMAND_SIZE = 12;
+
+/// @brief Типы inv блока (MSG_BLOCK и MSG_WITNESS_BLOCK)
+constexpr uint32_t MSG_BLOCK = 2;
+constexpr uint32_t MSG_WITNESS_FLAG = 1u << 30;
+
+/// @brief Поле адреса в version: services, IPv6, порт
+constexpr std::size_t NET_ADDRESS_SIZE = 26;
+
+void write_net_address(serialization::WriteStream& stream) {
+    stream.write_u64_le(0);
+    std::array<uint8_t, 16> ip{};
+    stream.write_bytes(ip);
+    stream.write_u16_le(0);
+}
+
+} // anonymous namespace
+
+// =============================================================================
+// Сообщения
+// =============================================================================
+
+Bytes encode_p2p_message(const NetworkMagic& magic, std::string_view command, ByteSpan payload) {
+    Bytes message(P2P_HEADER_SIZE + payload.size(), 0);
+    std::memcpy(message.data(), magic.data(), magic.size());
+    std::memcpy(message.data() + 4, command.data(), std::min(command.size(), COMMAND_SIZE));
+    write_le32(message.data() + 16, static_cast<uint32_t>(payload.size()));
+
+    auto checksum = crypto::sha256d(payload);
+    std::memcpy(message.data() + 20, checksum.data(), 4);
+    if (!payload.empty()) {
+        std::memcpy(message.data() + P2P_HEADER_SIZE, payload.data(), payload.size());
+    }
+    return message;
+}
+
+void P2pFrameReader::feed(ByteSpan data) {
+    // Прочитанные сообщения больше не нужны - сдвигаем остаток
+    if (begin_ > 0) {
+        buffer_.erase(buffer_.begin(), buffer_.begin() + static_cast<std::ptrdiff_t>(begin_));
+        begin_ = 0;
+    }
+    buffer_.insert(buffer_.end(), data.begin(), data.end());
+}
+
+P2pFrameReader::Status P2pFrameReader::next(P2pMessage& out) {
+    const std::size_t available = buffer_.size() - begin_;
+    if (available < P2P_HEADER_SIZE) {
+        return Status::Incomplete;
+    }
+
+    const uint8_t* header = buffer_.data() + begin_;
+    if (std::memcmp(header, magic_.data(), magic_.size()) != 0) {
+        return Status::Invalid;
+    }
+    const uint32_t length = read_le32(header + 16);
+    if (length > P2P_MAX_PAYLOAD) {
+        return Status::Invalid;
+    }
+    if (available < P2P_HEADER_SIZE + length) {
+        return Status::Incomplete;
+    }
+
+    ByteSpan payload(header + P2P_HEADER_SIZE, length);
+    auto checksum = crypto::sha256d(payload);
+    if (std::memcmp(checksum.data(), header + 20, 4) != 0) {
+        return Status::Invalid;
+    }
+
+    const char* command = reinterpret_cast<const char*>(header + 4);
+    out.command = std::string_view(command, ::strnlen(command, COMMAND_SIZE));
+    out.payload = payload;
+    begin_ += P2P_HEADER_SIZE + length;
+    return Status::Message;
+}
+
+void P2pFrameReader::clear() noexcept {
+    buffer_.clear();
+    begin_ = 0;
+}
+
+Bytes build_version_payload(uint32_t start_height, uint64_t nonce, int64_t timestamp) {
+    serialization::WriteStream stream(128);
+    stream.write_i32_le(P2P_PROTOCOL_VERSION);
+    stream.write_u64_le(0);  // services: NODE_NONE
+    stream.write_i64_le(timestamp);
+    write_net_address(stream);  // addr_recv
+    write_net_address(stream);  // addr_from
+    stream.write_u64_le(nonce);
+    stream.write_string("/quaxis:1.0/");
+    stream.write_i32_le(static_cast<int32_t>(start_height));
+    stream.write_u8(0);  // relay: транзакции не нужны
+    return stream.take_data();
+}
+
+Bytes build_getheaders_payload(std::span<const Hash256> locator) {
+    serialization::WriteStream stream(4 + 9 + (locator.size() + 1) * 32);
+    stream.write_u32_le(static_cast<uint32_t>(P2P_PROTOCOL_VERSION));
+    stream.write_varint(locator.size());
+    for (const auto& hash : locator) {
+        stream.write_hash256(hash);
+    }
+    stream.write_hash256(Hash256{});
+    return stream.take_data();
+}
+
+Bytes build_sendcmpct_payload(bool high_bandwidth, uint64_t version) {
+    serialization::WriteStream stream(9);
+    stream.write_u8(high_bandwidth ? 1 : 0);
+    stream.write_u64_le(version);
+    return stream.take_data();
+}
+
+std::optional<uint32_t> parse_version_start_height(ByteSpan payload) {
+    try {
+        serialization::SpanReadStream stream(payload);
+        stream.skip(4 + 8 + 8 + 2 * NET_ADDRESS_SIZE + 8);
+        stream.skip(stream.read_varint());  // user agent
+        return stream.read_u32_le();
+    } catch (const serialization::StreamError&) {
+        return std::nullopt;
+    }
+}
+
+std::optional<std::vector<BlockHeader>> parse_headers_payload(ByteSpan payload) {
+    try {
+        serialization::SpanReadStream stream(payload);
+        const uint64_t count = stream.read_varint();
+        if (count > P2P_MAX_HEADERS) {
+            return std::nullopt;
+        }
+        std::vector<BlockHeader> headers(static_cast<std::size_t>(count));
+        for (auto& header : headers) {
+            header = BlockHeader::deserialize(stream.read_span(BLOCK_HEADER_SIZE));
+            (void)stream.read_varint();  // tx_count, всегда 0
+        }
+        return headers;
+    } catch (const serialization::StreamError&) {
+        return std::nullopt;
+    }
+}
+
+std::optional<BlockHeader> parse_cmpctblock_header(ByteSpan payload) {
+    if (payload.size() < BLOCK_HEADER_SIZE) {
+        return std::nullopt;
+    }
+    return BlockHeader::deserialize(payload.first(BLOCK_HEADER_SIZE));
+}
+
+bool inv_announces_block(ByteSpan payload) {
+    try {
+        serialization::SpanReadStream stream(payload);
+        const uint64_t count = stream.read_varint();
+        for (uint64_t i = 0; i < count; ++i) {
+            const uint32_t type = stream.read_u32_le();
+            stream.skip(32);
+            if ((type & ~MSG_WITNESS_FLAG) == MSG_BLOCK) {
+                return true;
+            }
+        }
+    } catch (const serialization::StreamError&) {
+    }
+    return false;
+}
+
+// =============================================================================
+// Реализация P2pPeer
+// =============================================================================
+
+struct P2pPeer::Impl {
+    HeadersSync& sync;
+    NetworkMagic magic;
+    PeerAddress address;
+    StateCallback on_state;
+
+    std::atomic<PeerState> state{PeerState::Disconnected};
+    std::atomic<bool> running{false};
+    std::thread thread;
+
+    // Ожидание переподключения (будится stop())
+    std::mutex wait_mutex;
+    std::condition_variable wait_cv;
+
+    // Сокет закрывает поток peer, stop() только будит recv
+    std::mutex socket_mutex;
+    int socket_fd{-1};
+
+    P2pFrameReader reader;
+
+    // Отправлен getheaders, ответ ещё не получен
+    bool awaiting_headers{false};
+
+    Impl(HeadersSync& s, const NetworkParams& network, PeerAddress addr, StateCallback callback)
+        : sync(s)
+        , magic(network.magic)
+        , address(std::move(addr))
+        , on_state(std::move(callback))
+        , reader(network.magic) {
+        if (address.port == 0) {
+            address.port = network.default_port;
+        }
+    }
+
+    void set_state(PeerState next) {
+        if (state.exchange(next, std::memory_order_acq_rel) != next && on_state) {
+            on_state(next);
+        }
+    }
+
+    // =========================================================================
+    // Сокет
+    // =========================================================================
+
+    bool connect_peer() {
+        struct addrinfo hints{};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        struct addrinfo* result = nullptr;
+        const std::string port = std::to_string(address.port);
+        if (::getaddrinfo(address.host.c_str(), port.c_str(), &hints, &result) != 0) {
+            return false;
+        }
+
+        int fd = -1;
+        for (auto* ai = result; ai != nullptr; ai = ai->ai_next) {
+            fd = ::socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+            if (fd < 0) {
+                continue;
+            }
+            if (::connect(fd, ai->ai_addr, ai->ai_addrlen) == 0) {
+                break;
+            }
+            ::close(fd);
+            fd = -1;
+        }
+        ::freeaddrinfo(result);
+        if (fd < 0) {
+            return false;
+        }
+
+        // Объявление блока - одно маленькое сообщение, без Nagle
+        int flag = 1;
+        ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
+
+        std::lock_guard<std::mutex> lock(socket_mutex);
+        if (!running) {
+            ::close(fd);
+            return false;
+        }
+        socket_fd = fd;
+        return true;
+    }
+
+    void close_socket() {
+        std::lock_guard<std::mutex> lock(socket_mutex);
+        if (socket_fd >= 0) {
+            ::close(socket_fd);
+            socket_fd = -1;
+        }
+    }
+
+    void wake_socket() {
+        std::lock_guard<std::mutex> lock(socket_mutex);
+        if (socket_fd >= 0) {
+            ::shutdown(socket_fd, SHUT_RDWR);
+        }
+    }
+
+    bool send_message(std::string_view command, ByteSpan payload = {}) {
+        auto message = encode_p2p_message(magic, command, payload);
+        std::size_t sent = 0;
+        while (sent < message.size()) {
+            ssize_t n = ::send(socket_fd, message.data() + sent, message.size() - sent, MSG_NOSIGNAL);
+            if (n <= 0) {
+                return false;
+            }
+            sent += static_cast<std::size_t>(n);
+        }
+        return true;
+    }
+
+    // =========================================================================
+    // Протокол
+    // =========================================================================
+
+    bool request_headers() {
+        auto locator = sync.get_block_locator();
+        awaiting_headers = true;
+        auto payload = build_getheaders_payload(locator);
+        return send_message("getheaders", payload);
+    }
+
+    /**
+     * @brief Заголовки от peer
+     *
+     * @param solicited Ответ на наш getheaders (а не объявление блока)
+     * @return false - разорвать соединение
+     */
+    bool on_headers(const std::vector<BlockHeader>& headers, bool solicited) {
+        if (headers.empty()) {
+            if (solicited) {
+                awaiting_headers = false;
+                set_state(PeerState::Synchronized);
+            }
+            return true;
+        }
+
+        // Callback on_new_block срабатывает здесь, в потоке приёма
+        if (!sync.process_headers(headers)) {
+            // Ответ на getheaders не связался с цепью - peer на другой цепи;
+            // объявление не связалось - пропущены блоки, догоняем
+            return solicited ? false : request_headers();
+        }
+
+        if (solicited) {
+            if (headers.size() == P2P_MAX_HEADERS) {
+                return request_headers();
+            }
+            awaiting_headers = false;
+            set_state(PeerState::Synchronized);
+        }
+        return true;
+    }
+
+    bool handle(const P2pMessage& message) {
+        const auto& command = message.command;
+        if (command == "version") {
+            return send_message("verack");
+        }
+        if (command == "verack") {
+            // Новые блоки - сразу заголовком или cmpctblock, без inv
+            auto sendcmpct = build_sendcmpct_payload(true);
+            if (!send_message("sendheaders") || !send_message("sendcmpct", sendcmpct)) {
+                return false;
+            }
+            set_state(PeerState::Syncing);
+            return request_headers();
+        }
+        if (command == "ping") {
+            return send_message("pong", message.payload);
+        }
+        if (command == "headers") {
+            auto headers = parse_headers_payload(message.payload);
+            return headers && on_headers(*headers, awaiting_headers);
+        }
+        if (command == "cmpctblock") {
+            auto header = parse_cmpctblock_header(message.payload);
+            return header && on_headers({*header}, false);
+        }
+        if (command == "inv" && inv_announces_block(message.payload)) {
+            return request_headers();
+        }
+        return true;
+    }
+
+    void session() {
+        set_state(PeerState::Connecting);
+        reader.clear();
+        awaiting_headers = false;
+
+        std::random_device random;
+        const uint64_t nonce = (static_cast<uint64_t>(random()) << 32) | random();
+        auto version = build_version_payload(sync.get_tip_height(), nonce, static_cast<int64_t>(std::time(nullptr)));
+        if (!send_message("version", version)) {
+            return;
+        }
+
+        std::array<uint8_t, 64 * 1024> buffer;
+        while (running) {
+            ssize_t n = ::recv(socket_fd, buffer.data(), buffer.size(), 0);
+            if (n <= 0) {
+                return;
+            }
+            reader.feed(ByteSpan(buffer.data(), static_cast<std::size_t>(n)));
+
+            P2pMessage message;
+            while (true) {
+                auto status = reader.next(message);
+                if (status == P2pFrameReader::Status::Incomplete) {
+                    break;
+                }
+                if (status == P2pFrameReader::Status::Invalid || !handle(message)) {
+                    return;
+                }
+            }
+        }
+    }
+
+    void run() {
+        while (running) {
+            if (connect_peer()) {
+                session();
+                close_socket();
+            }
+            set_state(PeerState::Disconnected);
+
+            std::unique_lock<std::mutex> lock(wait_mutex);
+            wait_cv.wait_for(lock, RECONNECT_DELAY, [this] { return !running; });
+        }
+    }
+};
+
+// =============================================================================
+// Публичный API
+// =============================================================================
+
+P2pPeer::P2pPeer(HeadersSync& sync, const NetworkParams& network, PeerAddress address,
+                 StateCallback on_state)
+    : impl_(std::make_unique<Impl>(sync, network, std::move(address), std::move(on_state))) {}
+
+P2pPeer::~P2pPeer() {
+    stop();
+}
+
+void P2pPeer::start() {
+    if (impl_->running.exchange(true)) {
+        return;
+    }
+    impl_->thread = std::thread([this] { impl_->run(); });
+}
+
+void P2pPeer::stop() {
+    {
+        std::lock_guard<std::mutex> lock(impl_->wait_mutex);
+        impl_->running = false;
+    }
+    impl_->wait_cv.notify_all();
+    impl_->wake_socket();
+    if (impl_->thread.joinable()) {
+        impl_->thread.join();
+    }
+}
+
+PeerState P2pPeer::state() const noexcept {
+    return impl_->state.load(std::memory_order_acquire);
+}
+
+const PeerAddress& P2pPeer::address() const noexcept {
+    return impl_->address;
+}
+
+} // namespace quaxis::core::sync
@@ -0,0 +1,251 @@
+/**
+ * @file p2p_peer.hpp
+ * @brief Минимальный P2P клиент Bitcoin для синхронизации заголовков
+ *
+ * Подключение к одному peer: version/verack, затем sendheaders и
+ * sendcmpct в high-bandwidth режиме (BIP130, BIP152). Новый блок peer
+ * присылает сразу как cmpctblock (или headers) - заголовок уходит в
+ * HeadersSync::process_headers() прямо из потока приёма, и callback
+ * on_new_block срабатывает без локального bitcoind.
+ *
+ * Ни транзакции, ни блоки не запрашиваются: relay=0 в version, тело
+ * cmpctblock пропускается, getdata/getheaders от peer игнорируются.
+ *
+ * Кодирование и разбор сообщений - свободные функции ниже, их
+ * проверяют тесты без сети.
+ */
+
+#pragma once
+
+#include "../chain/chain_params.hpp"
+#include "../primitives/block_header.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace quaxis::core::sync {
+
+class HeadersSync;
+
+// =============================================================================
+// Сообщения P2P
+// =============================================================================
+
+/// @brief Версия протокола (sendheaders, cmpctblock v2, wtxidrelay)
+inline constexpr int32_t P2P_PROTOCOL_VERSION = 70016;
+
+/// @brief Размер заголовка сообщения: magic, command, length, checksum
+inline constexpr std::size_t P2P_HEADER_SIZE = 24;
+
+/// @brief Наибольший payload (MAX_PROTOCOL_MESSAGE_LENGTH в Bitcoin Core)
+inline constexpr std::size_t P2P_MAX_PAYLOAD = 4'000'000;
+
+/// @brief Заголовков в одном ответе headers
+inline constexpr std::size_t P2P_MAX_HEADERS = 2000;
+
+/// @brief Магические байты сети
+using NetworkMagic = std::array<uint8_t, 4>;
+
+/**
+ * @brief Сообщение P2P (view на буфер P2pFrameReader)
+ */
+struct P2pMessage {
+    /// @brief Команда без завершающих нулей
+    std::string_view command;
+
+    /// @brief Payload
+    ByteSpan payload;
+};
+
+/**
+ * @brief Закодировать сообщение: заголовок + payload
+ *
+ * @param magic Магические байты сети
+ * @param command Команда (до 12 символов)
+ * @param payload Payload
+ * @return Bytes Сообщение для send
+ */
+[[nodiscard]] Bytes encode_p2p_message(
+    const NetworkMagic& magic,
+    std::string_view command,
+    ByteSpan payload = {}
+);
+
+/**
+ * @brief Выделение сообщений из потока TCP
+ *
+ * Буфер растёт до одного сообщения; прочитанные сообщения сдвигаются
+ * при следующем feed().
+ */
+class P2pFrameReader {
+public:
+    /// @brief Результат next()
+    enum class Status {
+        Incomplete,  ///< Нужно больше данных
+        Message,     ///< Сообщение готово
+        Invalid      ///< Чужой magic, неверная контрольная сумма или размер
+    };
+
+    explicit P2pFrameReader(const NetworkMagic& magic) noexcept : magic_(magic) {}
+
+    /**
+     * @brief Добавить принятые байты
+     */
+    void feed(ByteSpan data);
+
+    /**
+     * @brief Следующее сообщение
+     *
+     * @param out Сообщение (валидно до следующего feed())
+     * @return Status Готовность сообщения
+     */
+    [[nodiscard]] Status next(P2pMessage& out);
+
+    /**
+     * @brief Сбросить буфер (переподключение)
+     */
+    void clear() noexcept;
+
+private:
+    NetworkMagic magic_;
+    Bytes buffer_;
+    std::size_t begin_{0};
+};
+
+/**
+ * @brief Payload version
+ *
+ * @param start_height Высота нашей цепи
+ * @param nonce Случайный nonce соединения
+ * @param timestamp Unix время
+ */
+[[nodiscard]] Bytes build_version_payload(uint32_t start_height, uint64_t nonce, int64_t timestamp);
+
+/**
+ * @brief Payload getheaders (hash_stop нулевой - до 2000 заголовков)
+ */
+[[nodiscard]] Bytes build_getheaders_payload(std::span<const Hash256> locator);
+
+/**
+ * @brief Payload sendcmpct
+ *
+ * @param high_bandwidth true - peer присылает cmpctblock без inv
+ * @param version Версия compact blocks (2 - witness)
+ */
+[[nodiscard]] Bytes build_sendcmpct_payload(bool high_bandwidth, uint64_t version = 2);
+
+/**
+ * @brief Высота из version peer
+ *
+ * @return std::optional<uint32_t> start_height или nullopt (короткий payload)
+ */
+[[nodiscard]] std::optional<uint32_t> parse_version_start_height(ByteSpan payload);
+
+/**
+ * @brief Заголовки из headers
+ *
+ * @return std::optional<std::vector<BlockHeader>> Заголовки или nullopt
+ *         (обрезанный payload, больше P2P_MAX_HEADERS)
+ */
+[[nodiscard]] std::optional<std::vector<BlockHeader>> parse_headers_payload(ByteSpan payload);
+
+/**
+ * @brief Заголовок блока из cmpctblock (первые 80 байт)
+ */
+[[nodiscard]] std::optional<BlockHeader> parse_cmpctblock_header(ByteSpan payload);
+
+/**
+ * @brief Есть ли в inv объявление блока (MSG_BLOCK, MSG_WITNESS_BLOCK)
+ */
+[[nodiscard]] bool inv_announces_block(ByteSpan payload);
+
+// =============================================================================
+// Peer
+// =============================================================================
+
+/**
+ * @brief Состояние соединения с peer
+ */
+enum class PeerState {
+    Disconnected,  ///< Нет соединения (ждёт переподключения)
+    Connecting,    ///< TCP подключение и version/verack
+    Syncing,       ///< Handshake готов, догоняем цепь заголовков
+    Synchronized   ///< Цепь peer догнана, ждём новых блоков
+};
+
+/**
+ * @brief Адрес peer
+ */
+struct PeerAddress {
+    /// @brief Хост (имя или IPv4)
+    std::string host;
+
+    /// @brief Порт (0 - порт сети по умолчанию)
+    uint16_t port{0};
+};
+
+/**
+ * @brief Соединение с одним peer в собственном потоке
+ *
+ * Разорванное соединение восстанавливается через RECONNECT_DELAY.
+ * Заголовки от нескольких peer сходятся в одном HeadersSync: уже
+ * известные отбрасываются по хешу.
+ */
+class P2pPeer {
+public:
+    /// @brief Пауза перед переподключением
+    static constexpr auto RECONNECT_DELAY = std::chrono::seconds(5);
+
+    /**
+     * @brief Callback смены состояния
+     */
+    using StateCallback = std::function<void(PeerState)>;
+
+    /**
+     * @param sync Получатель заголовков (должен пережить peer)
+     * @param network Параметры сети (magic, порт по умолчанию)
+     * @param address Адрес peer
+     * @param on_state Смена состояния (из потока peer)
+     */
+    P2pPeer(HeadersSync& sync, const NetworkParams& network, PeerAddress address,
+            StateCallback on_state = {});
+
+    ~P2pPeer();
+
+    P2pPeer(const P2pPeer&) = delete;
+    P2pPeer& operator=(const P2pPeer&) = delete;
+
+    /**
+     * @brief Запустить поток соединения
+     */
+    void start();
+
+    /**
+     * @brief Остановить и дождаться потока
+     */
+    void stop();
+
+    /**
+     * @brief Текущее состояние
+     */
+    [[nodiscard]] PeerState state() const noexcept;
+
+    /**
+     * @brief Адрес peer
+     */
+    [[nodiscard]] const PeerAddress& address() const noexcept;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace quaxis::core::sync
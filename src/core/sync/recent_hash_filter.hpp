@@ -0,0 +1,155 @@
+/**
+ * @file recent_hash_filter.hpp
+ * @brief Фильтр недавних заголовков на входе синхронизации
+ *
+ * Один и тот же tip приходит от нескольких P2P peer (объявления
+ * high-bandwidth cmpctblock, ответы на getheaders). Каждый повтор
+ * проходил SHA256d, PoW и поиск в HeadersStore под mutex, чтобы в итоге
+ * получить HeaderStatus::Known. Фильтр помнит 64-битные отпечатки
+ * последних принятых заголовков в 4-way set-associative таблице:
+ * проверка - одна строка кеша и четыре сравнения, без блокировок.
+ *
+ * Отпечаток считается по полям заголовка без SHA256d (header_key);
+ * ложное совпадение - вероятность порядка 2^-56 на проверку. В фильтр
+ * попадают только заголовки, уже принятые хранилищем: чужой заголовок
+ * с подобранным отпечатком не может заслонить ещё не пришедший
+ * настоящий.
+ *
+ * Thread-safety: insert() и clear() - один писатель за раз (вызывающий
+ * сериализует их своим mutex), contains() - из любых потоков.
+ */
+
+#pragma once
+
+#include "../byte_order.hpp"
+#include "../primitives/block_header.hpp"
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace quaxis::core::sync {
+
+/// @brief Наборов фильтра заголовков HeadersSync (по 4 отпечатка)
+inline constexpr std::size_t RECENT_HEADER_SETS = 64;
+
+/**
+ * @brief Lock-free множество недавних 64-битных отпечатков
+ */
+class RecentHashFilter {
+public:
+    /// @brief Отпечатков в наборе
+    static constexpr std::size_t WAYS = 4;
+
+    /**
+     * @brief Создать фильтр
+     *
+     * @param sets Наборов (округляется вверх до степени двойки)
+     */
+    explicit RecentHashFilter(std::size_t sets = RECENT_HEADER_SETS)
+        : mask_(std::bit_ceil(sets == 0 ? std::size_t{1} : sets) - 1)
+        , sets_(std::make_unique<Set[]>(mask_ + 1))
+        , next_(std::make_unique<uint8_t[]>(mask_ + 1))
+    {}
+
+    RecentHashFilter(const RecentHashFilter&) = delete;
+    RecentHashFilter& operator=(const RecentHashFilter&) = delete;
+
+    /**
+     * @brief Отпечаток заголовка по его полям (без SHA256d)
+     */
+    [[nodiscard]] static uint64_t header_key(const BlockHeader& header) noexcept {
+        uint64_t key = (uint64_t{header.nonce} << 32) | header.timestamp;
+        for (std::size_t offset = 0; offset < header.merkle_root.size(); offset += 8) {
+            key = std::rotl(key, 23) ^ read_le64(header.merkle_root.data() + offset);
+            key = std::rotl(key, 17) ^ read_le64(header.prev_hash.data() + offset);
+        }
+        key ^= std::rotl((uint64_t{static_cast<uint32_t>(header.version)} << 32) | header.bits, 41);
+        return mix(key);
+    }
+
+    /**
+     * @brief Отпечаток недавно добавлен?
+     */
+    [[nodiscard]] bool contains(uint64_t key) const noexcept {
+        key = tag(key);
+        const Set& set = sets_[key & mask_];
+        for (const auto& way : set.ways) {
+            if (way.load(std::memory_order_acquire) == key) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Добавить отпечаток, вытеснив самый старый в наборе
+     *
+     * @return false - отпечаток уже был
+     */
+    bool insert(uint64_t key) noexcept {
+        key = tag(key);
+        const std::size_t index = key & mask_;
+        Set& set = sets_[index];
+        for (const auto& way : set.ways) {
+            if (way.load(std::memory_order_relaxed) == key) {
+                return false;
+            }
+        }
+        set.ways[next_[index]].store(key, std::memory_order_release);
+        next_[index] = static_cast<uint8_t>((next_[index] + 1) % WAYS);
+        return true;
+    }
+
+    /**
+     * @brief Забыть все отпечатки (цепь заменена целиком)
+     */
+    void clear() noexcept {
+        for (std::size_t i = 0; i <= mask_; ++i) {
+            for (auto& way : sets_[i].ways) {
+                way.store(EMPTY, std::memory_order_release);
+            }
+            next_[i] = 0;
+        }
+    }
+
+    /**
+     * @brief Ёмкость (отпечатков)
+     */
+    [[nodiscard]] std::size_t capacity() const noexcept {
+        return (mask_ + 1) * WAYS;
+    }
+
+private:
+    /// @brief Пустой слот (отпечаток 0 хранится как 1)
+    static constexpr uint64_t EMPTY = 0;
+
+    /// @brief Набор - половина строки кеша
+    struct alignas(32) Set {
+        std::atomic<uint64_t> ways[WAYS]{};
+    };
+
+    /// @brief Перемешивание (финализатор MurmurHash3): индекс набора - младшие биты
+    [[nodiscard]] static uint64_t mix(uint64_t key) noexcept {
+        key ^= key >> 33;
+        key *= 0xFF51AFD7ED558CCDULL;
+        key ^= key >> 33;
+        key *= 0xC4CEB9FE1A85EC53ULL;
+        key ^= key >> 33;
+        return key;
+    }
+
+    [[nodiscard]] static uint64_t tag(uint64_t key) noexcept {
+        return key == EMPTY ? 1 : key;
+    }
+
+    std::size_t mask_;
+    std::unique_ptr<Set[]> sets_;
+    
+    /// @brief Следующий вытесняемый слот набора (только писатель)
+    std::unique_ptr<uint8_t[]> next_;
+};
+
+} // namespace quaxis::core::sync
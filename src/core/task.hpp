@@ -0,0 +1,198 @@
+/**
+ * @file task.hpp
+ * @brief Ленивая корутина Task<T> для асинхронного ввода-вывода
+ *
+ * Task<T> начинает выполняться при co_await. Если задача завершилась
+ * сразу, ожидающая корутина продолжает без приостановки - цикл из
+ * миллиона co_await готовых задач не растит стек и без хвостовых
+ * вызовов (debug сборка). Иначе по завершении задача возобновляет
+ * ожидающую. Запускать корневую задачу - network::IoLoop::spawn() или
+ * IoLoop::block_on().
+ */
+
+#pragma once
+
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+
+namespace quaxis::core {
+
+template<typename T>
+class Task;
+
+namespace detail {
+
+/**
+ * @brief Общая часть promise: продолжение и исключение
+ */
+struct TaskPromiseBase {
+    std::coroutine_handle<> continuation;
+    std::exception_ptr exception;
+
+    /// @brief Второй из (ожидающий приостановлен, задача завершена) продолжает ожидающего
+    std::atomic<bool> handoff{false};
+
+    /**
+     * @brief По завершении - в ожидающую корутину, если она уже ждёт
+     */
+    struct FinalAwaiter {
+        [[nodiscard]] bool await_ready() const noexcept { return false; }
+
+        template<typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+            auto& promise = handle.promise();
+            if (promise.handoff.exchange(true, std::memory_order_acq_rel)) {
+                return promise.continuation;
+            }
+            return std::noop_coroutine();  // Завершилась синхронно: ожидающий не приостановится
+        }
+
+        void await_resume() const noexcept {}
+    };
+
+    [[nodiscard]] std::suspend_always initial_suspend() const noexcept { return {}; }
+    [[nodiscard]] FinalAwaiter final_suspend() const noexcept { return {}; }
+
+    void unhandled_exception() noexcept {
+        exception = std::current_exception();
+    }
+
+    void rethrow_if_failed() const {
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
+    }
+};
+
+template<typename T>
+struct TaskPromise : TaskPromiseBase {
+    std::optional<T> value;
+
+    Task<T> get_return_object() noexcept;
+
+    template<typename U>
+    void return_value(U&& result) {
+        value.emplace(std::forward<U>(result));
+    }
+
+    T take() {
+        rethrow_if_failed();
+        return std::move(*value);
+    }
+};
+
+template<>
+struct TaskPromise<void> : TaskPromiseBase {
+    Task<void> get_return_object() noexcept;
+
+    void return_void() const noexcept {}
+
+    void take() const {
+        rethrow_if_failed();
+    }
+};
+
+} // namespace detail
+
+/**
+ * @brief Ленивая корутина с результатом T
+ *
+ * Владеет кадром корутины: кадр освобождается вместе с Task. Ожидается
+ * не более одного раза.
+ */
+template<typename T = void>
+class [[nodiscard]] Task {
+public:
+    using promise_type = detail::TaskPromise<T>;
+    using Handle = std::coroutine_handle<promise_type>;
+
+    Task() noexcept = default;
+
+    explicit Task(Handle handle) noexcept
+        : handle_(handle)
+    {}
+
+    Task(Task&& other) noexcept
+        : handle_(std::exchange(other.handle_, {}))
+    {}
+
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            destroy();
+            handle_ = std::exchange(other.handle_, {});
+        }
+        return *this;
+    }
+
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    ~Task() {
+        destroy();
+    }
+
+    /**
+     * @brief Задача завершена (или пуста)
+     */
+    [[nodiscard]] bool done() const noexcept {
+        return !handle_ || handle_.done();
+    }
+
+    /**
+     * @brief Ожидание: запуск задачи, продолжение - по её завершении
+     */
+    auto operator co_await() const& noexcept {
+        return Awaiter{handle_};
+    }
+
+    auto operator co_await() const&& noexcept {
+        return Awaiter{handle_};
+    }
+
+private:
+    struct Awaiter {
+        Handle handle;
+
+        [[nodiscard]] bool await_ready() const noexcept {
+            return !handle || handle.done();
+        }
+
+        bool await_suspend(std::coroutine_handle<> awaiting) noexcept {
+            auto& promise = handle.promise();
+            promise.continuation = awaiting;
+            handle.resume();
+            return !promise.handoff.exchange(true, std::memory_order_acq_rel);
+        }
+
+        T await_resume() {
+            return handle.promise().take();
+        }
+    };
+
+    void destroy() noexcept {
+        if (handle_) {
+            handle_.destroy();
+            handle_ = {};
+        }
+    }
+
+    Handle handle_;
+};
+
+namespace detail {
+
+template<typename T>
+Task<T> TaskPromise<T>::get_return_object() noexcept {
+    return Task<T>{std::coroutine_handle<TaskPromise<T>>::from_promise(*this)};
+}
+
+inline Task<void> TaskPromise<void>::get_return_object() noexcept {
+    return Task<void>{std::coroutine_handle<TaskPromise<void>>::from_promise(*this)};
+}
+
+} // namespace detail
+
+} // namespace quaxis::core
@@ -0,0 +1,130 @@
+/**
+ * @file task_pool.hpp
+ * @brief Пул потоков для fork-join пакетов однотипных задач
+ *
+ * Пакетные вычисления на горячем пути (PoW пачки заголовков, задания всех
+ * соединений на новом блоке) делятся на независимые куски. Потоки пула
+ * создаются один раз и спят между запусками: запуск - одно пробуждение,
+ * без создания потоков на каждый блок.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace quaxis::core {
+
+/**
+ * @brief Потоки, разбирающие задачи одного run() по атомарному счётчику
+ *
+ * Вызывающий поток тоже берёт задачи. run() ждёт, пока все потоки,
+ * вошедшие в текущий запуск, выйдут из него, - задача не переживает run().
+ * Запуски из разных потоков выполняются по очереди.
+ */
+class TaskPool {
+public:
+    using Task = std::function<void(std::size_t)>;
+
+    /**
+     * @param threads Потоков кроме вызывающего
+     */
+    explicit TaskPool(std::size_t threads) {
+        workers_.reserve(threads);
+        for (std::size_t i = 0; i < threads; ++i) {
+            workers_.emplace_back([this] { worker_loop(); });
+        }
+    }
+
+    ~TaskPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        wake_cv_.notify_all();
+        for (auto& worker : workers_) {
+            worker.join();
+        }
+    }
+
+    TaskPool(const TaskPool&) = delete;
+    TaskPool& operator=(const TaskPool&) = delete;
+
+    /**
+     * @brief Выполнить fn(0) .. fn(count - 1) и дождаться всех
+     */
+    void run(std::size_t count, const Task& fn) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        idle_cv_.wait(lock, [this] { return task_ == nullptr && active_ == 0; });
+        task_ = &fn;
+        tasks_ = count;
+        next_.store(0, std::memory_order_relaxed);
+        ++generation_;
+        lock.unlock();
+        wake_cv_.notify_all();
+
+        drain(fn, count);
+
+        lock.lock();
+        idle_cv_.wait(lock, [this] { return active_ == 0; });
+        task_ = nullptr;
+        lock.unlock();
+        idle_cv_.notify_all();
+    }
+
+    /**
+     * @brief Потоков кроме вызывающего
+     */
+    [[nodiscard]] std::size_t size() const noexcept { return workers_.size(); }
+
+private:
+    void drain(const Task& fn, std::size_t count) {
+        for (std::size_t i = next_.fetch_add(1, std::memory_order_relaxed); i < count;
+             i = next_.fetch_add(1, std::memory_order_relaxed)) {
+            fn(i);
+        }
+    }
+
+    void worker_loop() {
+        uint64_t seen = 0;
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            wake_cv_.wait(lock, [&] { return stopping_ || generation_ != seen; });
+            if (stopping_) {
+                return;
+            }
+            seen = generation_;
+            if (!task_) {
+                continue;
+            }
+            const Task& fn = *task_;
+            const std::size_t count = tasks_;
+            ++active_;
+            lock.unlock();
+            drain(fn, count);
+            lock.lock();
+            if (--active_ == 0) {
+                idle_cv_.notify_all();
+            }
+        }
+    }
+
+    std::mutex mutex_;
+    std::condition_variable wake_cv_;
+    std::condition_variable idle_cv_;
+    const Task* task_{nullptr};
+    std::size_t tasks_{0};
+    std::atomic<std::size_t> next_{0};
+    std::size_t active_{0};
+    uint64_t generation_{0};
+    bool stopping_{false};
+    std::vector<std::thread> workers_;
+};
+
+} // namespace quaxis::core
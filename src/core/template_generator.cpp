@@ -4,10 +4,13 @@
  */
 
 #include "template_generator.hpp"
+#include "block_arena.hpp"
+#include "latency_trace.hpp"
 #include "primitives/merkle.hpp"
 #include "../crypto/sha256.hpp"
 #include "../bitcoin/address.hpp"
 
+#include <algorithm>
 #include <chrono>
 #include <cstring>
 
@@ -58,6 +61,13 @@ struct TemplateGenerator::Impl {
     int64_t coinbase_value{0};
     bool has_chain_info{false};
     
+    // Правило min-difficulty: шаблону позже min_difficulty_after - min_difficulty_bits
+    uint32_t min_difficulty_after{0};
+    uint32_t min_difficulty_bits{0};
+    
+    // Coinbase для хеширования: живёт до следующего шаблона (под mutex_)
+    BlockArena arena;
+    
     mutable std::mutex mutex_;
     
     explicit Impl(const TemplateGeneratorConfig& cfg) : config(cfg) {
@@ -72,10 +82,13 @@ struct TemplateGenerator::Impl {
     }
     
     /**
-     * @brief Создать coinbase транзакцию
+     * @brief Создать coinbase транзакцию в арене
+     * 
+     * Сбрасывает арену: coinbase прошлого шаблона становится недействительной.
      */
-    Bytes build_coinbase(uint64_t extranonce) const {
-        Bytes coinbase;
+    PmrBytes build_coinbase(uint64_t extranonce) {
+        arena.reset();
+        PmrBytes coinbase(arena.resource());
         coinbase.reserve(128);
         
         // Version (4 bytes, little-endian)
@@ -97,7 +110,8 @@ struct TemplateGenerator::Impl {
         coinbase.push_back(0xFF);
         
         // Build scriptsig
-        Bytes scriptsig;
+        PmrBytes scriptsig(arena.resource());
+        scriptsig.reserve(5 + config.coinbase_tag.size() + config.extranonce_size);
         
         // Block height (BIP34) - serialized as compact size + data
         uint32_t h = height;
@@ -210,6 +224,42 @@ void TemplateGenerator::update_chain_tip(
     impl_->bits = bits;
     impl_->coinbase_value = coinbase_value > 0 ? coinbase_value : calculate_block_reward(height);
     impl_->has_chain_info = true;
+    impl_->min_difficulty_after = 0;
+}
+
+void TemplateGenerator::update_chain_tip(
+    const EpochDifficulty& next,
+    const DifficultyParams& params,
+    int64_t coinbase_value
+) {
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    
+    impl_->prev_hash = next.prev_hash;
+    impl_->height = next.height;
+    impl_->bits = next.bits;
+    impl_->coinbase_value = coinbase_value > 0 ? coinbase_value : calculate_block_reward(next.height);
+    impl_->has_chain_info = true;
+    impl_->min_difficulty_after = next.min_difficulty_after;
+    impl_->min_difficulty_bits = params.pow_limit_bits;
+}
+
+void TemplateGenerator::switch_chain_tip(
+    std::size_t disconnected,
+    std::span<const BlockHeader> connected,
+    uint32_t tip_height,
+    uint32_t bits,
+    int64_t coinbase_value
+) {
+    if (connected.empty()) {
+        return;
+    }
+    
+    auto& mtp = impl_->mtp_calculator;
+    (void)mtp.pop_headers(disconnected);
+    for (const auto& header : connected) {
+        mtp.push_header(header);
+    }
+    update_chain_tip(connected.back().hash(), tip_height + 1, bits, coinbase_value);
 }
 
 MtpCalculator& TemplateGenerator::get_mtp_calculator() {
@@ -245,11 +295,14 @@ std::optional<BlockTemplate> TemplateGenerator::generate_template(uint64_t extra
         );
     }
     
-    tmpl.header.bits = impl_->bits;
+    if (impl_->min_difficulty_after != 0 && tmpl.header.timestamp > impl_->min_difficulty_after) {
+        tmpl.bits = impl_->min_difficulty_bits;
+    }
+    tmpl.header.bits = tmpl.bits;
     tmpl.header.nonce = 0;
     
     // Строим coinbase и вычисляем merkle root
-    Bytes coinbase = impl_->build_coinbase(extranonce);
+    PmrBytes coinbase = impl_->build_coinbase(extranonce);
     
     // Для пустого блока merkle root = hash(coinbase)
     Hash256 coinbase_hash = crypto::sha256d(ByteSpan(coinbase));
@@ -264,6 +317,7 @@ std::optional<BlockTemplate> TemplateGenerator::generate_template(uint64_t extra
     auto header_bytes = tmpl.header.serialize();
     tmpl.header_midstate = impl_->compute_midstate_bytes(header_bytes.data());
     
+    trace_point(TraceStage::TemplateGenerated);
     return tmpl;
 }
 
@@ -306,7 +360,7 @@ std::optional<BlockTemplate> TemplateGenerator::generate_speculative(
     // Строим coinbase (используем новую высоту)
     uint32_t old_height = impl_->height;
     impl_->height = tmpl.height;
-    Bytes coinbase = impl_->build_coinbase(extranonce);
+    PmrBytes coinbase = impl_->build_coinbase(extranonce);
     impl_->height = old_height;
     
     // Для пустого блока merkle root = hash(coinbase)
@@ -322,9 +376,17 @@ std::optional<BlockTemplate> TemplateGenerator::generate_speculative(
     auto header_bytes = tmpl.header.serialize();
     tmpl.header_midstate = impl_->compute_midstate_bytes(header_bytes.data());
     
+    trace_point(TraceStage::TemplateGenerated);
     return tmpl;
 }
 
+std::optional<uint32_t> TemplateGenerator::roll_timestamp(uint32_t current, uint32_t now) const {
+    const uint32_t min_timestamp = impl_->mtp_calculator.has_sufficient_data()
+        ? impl_->mtp_calculator.get_min_timestamp()
+        : 0;
+    return roll_block_time(current, now, min_timestamp);
+}
+
 bool TemplateGenerator::is_ready() const {
     std::lock_guard<std::mutex> lock(impl_->mutex_);
     return impl_->has_chain_info;
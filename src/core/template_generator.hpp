@@ -9,15 +9,20 @@
 #pragma once
 
 #include "types.hpp"
+#include "constants.hpp"
 #include "primitives/block_header.hpp"
 #include "mtp_calculator.hpp"
+#include "chain/difficulty.hpp"
 
 #include <memory>
 #include <optional>
+#include <span>
 #include <string>
 
 namespace quaxis::core {
 
+using constants::MAX_FUTURE_BLOCK_TIME;
+
 /**
  * @brief Шаблон блока для майнинга
  */
@@ -100,9 +105,49 @@ public:
         int64_t coinbase_value
     );
     
+    /**
+     * @brief Обновить предыдущий блок по заранее посчитанной сложности
+     * 
+     * Bits шаблона - next.bits_for(timestamp шаблона): на высоте
+     * пересчёта и с правилом min-difficulty (testnet) без расчёта при
+     * построении шаблона.
+     * 
+     * @param next Сложность блока next.height (HeadersSync::get_next_work)
+     * @param params Параметры сложности chain
+     * @param coinbase_value Награда за блок (0 - по высоте)
+     */
+    void update_chain_tip(
+        const EpochDifficulty& next,
+        const DifficultyParams& params,
+        int64_t coinbase_value
+    );
+    
+    /**
+     * @brief Перейти на ветвь с большей работой (reorg)
+     * 
+     * Окно MTP откатывается на disconnected блоков и дополняется блоками
+     * новой ветви; шаблоны строятся на её tip.
+     * 
+     * @param disconnected Блоков снято с прежней цепи
+     * @param connected Новые блоки от развилки до tip (не пусто)
+     * @param tip_height Высота нового tip
+     * @param bits Target следующего блока в compact формате
+     * @param coinbase_value Награда за блок (0 - по высоте)
+     */
+    void switch_chain_tip(
+        std::size_t disconnected,
+        std::span<const BlockHeader> connected,
+        uint32_t tip_height,
+        uint32_t bits,
+        int64_t coinbase_value
+    );
+    
     /**
      * @brief Получить MTP калькулятор для обновления timestamps
      * 
+     * Писатель (push_header, pop_headers) - один поток; шаблоны читают
+     * MTP без блокировок.
+     * 
      * @return MtpCalculator& Ссылка на калькулятор
      */
     [[nodiscard]] MtpCalculator& get_mtp_calculator();
@@ -127,6 +172,21 @@ public:
         uint64_t extranonce
     );
     
+    /**
+     * @brief Следующий timestamp задания для CMD_UPDATE_TIME
+     * 
+     * Пока timestamp задания отстаёт от часов, он догоняет now; если
+     * ASIC исчерпывает nonce быстрее, чем идут часы, timestamp уходит
+     * вперёд на 1 секунду за вызов. Результат не меньше MTP + 1 и не
+     * больше now + MAX_FUTURE_BLOCK_TIME.
+     * 
+     * @param current Текущий timestamp задания
+     * @param now Unix время
+     * @return std::optional<uint32_t> Новый timestamp или nullopt, если
+     *         timestamp уже упёрся в предел будущего
+     */
+    [[nodiscard]] std::optional<uint32_t> roll_timestamp(uint32_t current, uint32_t now) const;
+    
     /**
      * @brief Проверить, готов ли генератор
      * 
@@ -0,0 +1,298 @@
+/**
+ * @file thread_plan.cpp
+ * @brief Реализация плана размещения потоков
+ */
+
+#include "thread_plan.hpp"
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <mutex>
+
+namespace quaxis::core {
+
+namespace {
+
+/**
+ * @brief Состояние роли: набор CPU и счётчики вступивших потоков
+ */
+struct RoleState {
+    std::vector<int> cpus;
+    std::atomic<uint32_t> threads{0};
+    std::atomic<uint32_t> failures{0};
+    std::mutex mutex;
+    std::string last_error;
+};
+
+struct Plan {
+    std::array<RoleState, THREAD_ROLE_COUNT> roles;
+    int32_t block_path_priority = 0;
+    uint32_t prefault_stack_kb = 0;
+    bool memory_locked = false;
+};
+
+Plan& plan() {
+    static Plan instance;
+    return instance;
+}
+
+std::atomic<bool> g_plan_applied{false};
+
+/**
+ * @brief Первая строка файла sysfs
+ */
+std::string read_line(const std::string& path) {
+    std::ifstream file(path);
+    std::string line;
+    std::getline(file, line);
+    return line;
+}
+
+std::vector<int> read_cpu_file(const std::string& path) {
+    return parse_cpu_set(read_line(path)).value_or(std::vector<int>{});
+}
+
+/**
+ * @brief Набор CPU обратно в строку ("2-3,6")
+ */
+std::string format_cpu_set(const std::vector<int>& cpus) {
+    std::string out;
+    for (std::size_t i = 0; i < cpus.size();) {
+        std::size_t j = i;
+        while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1) {
+            ++j;
+        }
+        if (!out.empty()) {
+            out += ',';
+        }
+        out += j == i ? std::format("{}", cpus[i]) : std::format("{}-{}", cpus[i], cpus[j]);
+        i = j + 1;
+    }
+    return out.empty() ? "-" : out;
+}
+
+void record_failure(RoleState& state, std::string error) {
+    state.failures.fetch_add(1, std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.last_error = std::move(error);
+}
+
+#ifdef __linux__
+int set_affinity(const std::vector<int>& cpus) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus) {
+        CPU_SET(static_cast<std::size_t>(cpu), &set);
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+}
+#endif
+
+/**
+ * @brief Тронуть bytes стека вниз от текущего кадра
+ */
+[[gnu::noinline]] void prefault_stack(std::size_t bytes) {
+    constexpr std::size_t PAGE = 4096;
+    auto* stack = static_cast<volatile uint8_t*>(__builtin_alloca(bytes));
+    for (std::size_t offset = 0; offset < bytes; offset += PAGE) {
+        stack[offset] = 0;
+    }
+}
+
+} // anonymous namespace
+
+Result<std::vector<int>> parse_cpu_set(std::string_view list) {
+    std::vector<int> cpus;
+    while (!list.empty()) {
+        auto comma = list.find(',');
+        auto range = list.substr(0, comma);
+        list = comma == std::string_view::npos ? std::string_view{} : list.substr(comma + 1);
+
+        while (!range.empty() && (range.front() == ' ' || range.front() == '\n')) range.remove_prefix(1);
+        while (!range.empty() && (range.back() == ' ' || range.back() == '\n')) range.remove_suffix(1);
+        if (range.empty()) {
+            continue;
+        }
+
+        int first = -1;
+        int last = -1;
+        auto dash = range.find('-');
+        auto head = range.substr(0, dash);
+        auto [head_end, head_ec] = std::from_chars(head.data(), head.data() + head.size(), first);
+        bool ok = head_ec == std::errc{} && head_end == head.data() + head.size();
+        if (dash == std::string_view::npos) {
+            last = first;
+        } else {
+            auto tail = range.substr(dash + 1);
+            auto [tail_end, tail_ec] = std::from_chars(tail.data(), tail.data() + tail.size(), last);
+            ok = ok && tail_ec == std::errc{} && tail_end == tail.data() + tail.size();
+        }
+#ifdef __linux__
+        ok = ok && last < CPU_SETSIZE;
+#endif
+        if (!ok || first < 0 || last < first) {
+            return Err<std::vector<int>>(ErrorCode::ConfigInvalidValue,
+                                         std::format("Некорректный набор CPU '{}'", range));
+        }
+        for (int cpu = first; cpu <= last; ++cpu) {
+            cpus.push_back(cpu);
+        }
+    }
+    std::sort(cpus.begin(), cpus.end());
+    cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+    return cpus;
+}
+
+Result<void> apply_thread_plan(const ThreadsConfig& config) {
+    auto& state = plan();
+    const std::array<const std::string*, THREAD_ROLE_COUNT> lists{
+        &config.block_path_cpus, &config.fanout_cpus, &config.background_cpus};
+    for (std::size_t i = 0; i < THREAD_ROLE_COUNT; ++i) {
+        auto cpus = parse_cpu_set(*lists[i]);
+        if (!cpus) {
+            return std::unexpected(cpus.error());
+        }
+        state.roles[i].cpus = std::move(*cpus);
+    }
+    state.block_path_priority = config.block_path_priority;
+    state.prefault_stack_kb = config.prefault_stack_kb;
+
+#ifdef __linux__
+    if (config.lock_memory && !state.memory_locked) {
+        // MCL_ONFAULT: стек каждого потока блокируется по мере касания, а не
+        // целиком при создании (иначе 8 МБ на поток)
+        int flags = MCL_CURRENT | MCL_FUTURE;
+#ifdef MCL_ONFAULT
+        flags |= MCL_ONFAULT;
+#endif
+        if (mlockall(flags) != 0) {
+            return Err<void>(ErrorCode::SystemOutOfMemory,
+                             std::format("mlockall: {} (нужен CAP_IPC_LOCK или ulimit -l)", strerror(errno)));
+        }
+        state.memory_locked = true;
+    }
+
+    // Основной поток - в background: потоки без роли наследуют этот набор
+    const auto& background = state.roles[static_cast<std::size_t>(ThreadRole::Background)].cpus;
+    if (!background.empty()) {
+        if (int rc = set_affinity(background); rc != 0) {
+            return Err<void>(ErrorCode::ConfigInvalidValue,
+                             std::format("threads.background_cpus {}: {}", format_cpu_set(background), strerror(rc)));
+        }
+    }
+#else
+    if (config.lock_memory) {
+        return Err<void>(ErrorCode::SystemOutOfMemory, "mlockall недоступен");
+    }
+#endif
+
+    g_plan_applied.store(true, std::memory_order_release);
+    return {};
+}
+
+void enter_thread_role(ThreadRole role, bool keep_affinity) noexcept {
+    if (!g_plan_applied.load(std::memory_order_acquire)) {
+        return;
+    }
+    auto& state = plan();
+    auto& role_state = state.roles[static_cast<std::size_t>(role)];
+    role_state.threads.fetch_add(1, std::memory_order_relaxed);
+
+#ifdef __linux__
+    if (!keep_affinity && !role_state.cpus.empty()) {
+        if (int rc = set_affinity(role_state.cpus); rc != 0) {
+            record_failure(role_state, std::format("affinity: {}", strerror(rc)));
+        }
+    }
+
+    if (role == ThreadRole::BlockPath && state.block_path_priority > 0) {
+        struct sched_param param{};
+        param.sched_priority = state.block_path_priority;
+        if (int rc = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param); rc != 0) {
+            record_failure(role_state, std::format("SCHED_FIFO {}: {}", state.block_path_priority, strerror(rc)));
+        }
+    }
+#else
+    (void)keep_affinity;
+#endif
+
+    if (role != ThreadRole::Background && state.prefault_stack_kb > 0) {
+        prefault_stack(static_cast<std::size_t>(state.prefault_stack_kb) * 1024);
+    }
+}
+
+std::string describe_thread_topology() {
+    auto& state = plan();
+    const auto online = read_cpu_file("/sys/devices/system/cpu/online");
+    const auto isolated = read_cpu_file("/sys/devices/system/cpu/isolated");
+
+    std::string out = std::format("Топология: CPU {}, изолированы {}\n",
+                                  format_cpu_set(online), format_cpu_set(isolated));
+
+    // Физические ядра: гиперпотоки одного ядра
+    std::vector<std::vector<int>> cores;
+    for (int cpu : online) {
+        auto siblings = read_cpu_file(std::format("/sys/devices/system/cpu/cpu{}/topology/thread_siblings_list", cpu));
+        if (siblings.empty()) {
+            siblings.push_back(cpu);
+        }
+        if (std::find(cores.begin(), cores.end(), siblings) == cores.end()) {
+            cores.push_back(std::move(siblings));
+        }
+    }
+    out += "  ядра:";
+    for (const auto& physical : cores) {
+        out += ' ';
+        out += format_cpu_set(physical);
+    }
+    out += '\n';
+
+    for (std::size_t i = 0; i < THREAD_ROLE_COUNT; ++i) {
+        auto& role = state.roles[i];
+        out += std::format("  {}: CPU {}", to_string(static_cast<ThreadRole>(i)),
+                           role.cpus.empty() ? std::string("любые") : format_cpu_set(role.cpus));
+        if (static_cast<ThreadRole>(i) == ThreadRole::BlockPath && state.block_path_priority > 0) {
+            out += std::format(", SCHED_FIFO {}", state.block_path_priority);
+        }
+        out += std::format(", потоков {}", role.threads.load(std::memory_order_relaxed));
+        if (uint32_t failures = role.failures.load(std::memory_order_relaxed); failures > 0) {
+            std::lock_guard<std::mutex> lock(role.mutex);
+            out += std::format(", ошибок {} ({})", failures, role.last_error);
+        }
+        out += '\n';
+    }
+    out += std::format("  mlockall: {}\n", state.memory_locked ? "да" : "нет");
+
+    // Путь блока на одном ядре с другой ролью - гиперпоток делит конвейер
+    const auto& block_path = state.roles[static_cast<std::size_t>(ThreadRole::BlockPath)].cpus;
+    for (std::size_t i = 1; i < THREAD_ROLE_COUNT; ++i) {
+        const auto& other = state.roles[i].cpus;
+        for (const auto& physical : cores) {
+            const bool has_block = std::any_of(physical.begin(), physical.end(), [&](int cpu) {
+                return std::binary_search(block_path.begin(), block_path.end(), cpu);
+            });
+            const bool has_other = std::any_of(physical.begin(), physical.end(), [&](int cpu) {
+                return std::binary_search(other.begin(), other.end(), cpu);
+            });
+            if (has_block && has_other) {
+                out += std::format("  [WARNING] block_path делит ядро {} с {}\n",
+                                   format_cpu_set(physical), to_string(static_cast<ThreadRole>(i)));
+            }
+        }
+    }
+    return out;
+}
+
+} // namespace quaxis::core
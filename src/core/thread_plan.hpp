@@ -0,0 +1,93 @@
+/**
+ * @file thread_plan.hpp
+ * @brief Размещение потоков по CPU: роли, SCHED_FIFO, mlockall
+ *
+ * Без плана подписчик SHM, relay и рассылка заданий делят гиперпоток с
+ * отрисовкой экрана или libcurl. План (секция [threads]) делит потоки на
+ * роли, у каждой - свой набор CPU:
+ * - block_path: приход блока -> задания (подписчики SHM/ZMQ, relay,
+ *   полоса задержки исполнителя), при желании с SCHED_FIFO;
+ * - fanout: рассылка ASIC (reactor'ы и потоки соединений сервера, фид);
+ * - background: всё остальное. Основной поток закрепляется здесь, и
+ *   потоки без роли (RPC, libcurl) наследуют этот набор.
+ *
+ * Поток вызывает enter_thread_role() в начале своей функции. План
+ * применяется один раз при запуске, до создания потоков.
+ */
+
+#pragma once
+
+#include "types.hpp"
+#include "config.hpp"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace quaxis::core {
+
+/**
+ * @brief Роль потока в плане размещения
+ */
+enum class ThreadRole : uint8_t {
+    BlockPath = 0,  ///< Приход блока -> задания
+    Fanout,         ///< Рассылка заданий ASIC
+    Background,     ///< Экран, RPC, периодические задачи
+    Count
+};
+
+/// @brief Количество ролей
+inline constexpr std::size_t THREAD_ROLE_COUNT = static_cast<std::size_t>(ThreadRole::Count);
+
+/**
+ * @brief Имя роли (как в секции [threads])
+ */
+[[nodiscard]] constexpr std::string_view to_string(ThreadRole role) noexcept {
+    switch (role) {
+        case ThreadRole::BlockPath:  return "block_path";
+        case ThreadRole::Fanout:     return "fanout";
+        case ThreadRole::Background: return "background";
+        default: return "unknown";
+    }
+}
+
+/**
+ * @brief Разобрать набор CPU ("2-3,6")
+ *
+ * @return Номера CPU по возрастанию без повторов; пустая строка - пустой набор
+ */
+[[nodiscard]] Result<std::vector<int>> parse_cpu_set(std::string_view list);
+
+/**
+ * @brief Применить план к процессу
+ *
+ * mlockall (если lock_memory), закрепление основного потока за
+ * background_cpus и сохранение плана для enter_thread_role().
+ *
+ * @return Result<void> Ошибка разбора наборов или mlockall
+ */
+[[nodiscard]] Result<void> apply_thread_plan(const ThreadsConfig& config);
+
+/**
+ * @brief Текущий поток вступает в роль
+ *
+ * Закрепляет поток за набором роли, для block_path - SCHED_FIFO, затем
+ * заранее трогает стек (prefault_stack_kb): под mlockall первые
+ * обращения к стеку не дают page fault на горячем пути. Без плана -
+ * ничего. Ошибки считаются и видны в describe_thread_topology().
+ *
+ * @param keep_affinity Поток уже закреплён своим параметром (cpu_affinity):
+ *                      набор роли не применяется
+ */
+void enter_thread_role(ThreadRole role, bool keep_affinity = false) noexcept;
+
+/**
+ * @brief Действующая топология: CPU, гиперпотоки, изолированные CPU, роли
+ *
+ * Многострочный текст для вывода при запуске; предупреждает, если путь
+ * блока делит физическое ядро с другой ролью.
+ */
+[[nodiscard]] std::string describe_thread_topology();
+
+} // namespace quaxis::core
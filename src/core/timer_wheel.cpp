@@ -0,0 +1,88 @@
+/**
+ * @file timer_wheel.cpp
+ * @brief Реализация иерархического колеса таймеров
+ */
+
+#include "timer_wheel.hpp"
+
+#include <algorithm>
+#include <bit>
+
+namespace quaxis::core {
+
+TimerWheel::TimerWheel(uint64_t now) noexcept
+    : now_(now)
+{
+    // Слот - пустой кольцевой список из одного узла-заголовка
+    for (auto& level : slots_) {
+        for (auto& slot : level) {
+            slot.prev_ = &slot;
+            slot.next_ = &slot;
+        }
+    }
+}
+
+void TimerWheel::schedule(TimerNode& node, uint64_t delay) noexcept {
+    cancel(node);
+    node.deadline_ = now_ + std::clamp<uint64_t>(delay, 1, MAX_DELAY);
+    insert(node);
+    ++size_;
+}
+
+void TimerWheel::insert(TimerNode& node) noexcept {
+    // Уровень - старший разряд, в котором срок отличается от текущего шага
+    const uint64_t diff = node.deadline_ ^ now_;
+    // Срок на горизонте может отличаться и выше: ждёт на верхнем уровне
+    const std::size_t level = diff == 0
+        ? 0 : std::min<std::size_t>((std::bit_width(diff) - 1) / SLOT_BITS, LEVELS - 1);
+
+    TimerNode& head = level_slot(level, node.deadline_);
+    node.prev_ = head.prev_;
+    node.next_ = &head;
+    head.prev_->next_ = &node;
+    head.prev_ = &node;
+}
+
+void TimerWheel::cascade() noexcept {
+    // Сверху вниз: разложенные узлы попадают на уровни ниже границы
+    for (std::size_t level = LEVELS - 1; level > 0; --level) {
+        const uint64_t mask = (uint64_t{1} << (SLOT_BITS * level)) - 1;
+        if ((now_ & mask) != 0) {
+            continue;
+        }
+        TimerNode moved;
+        take_slot(level_slot(level, now_), moved);
+        while (moved.next_ != &moved) {
+            TimerNode* node = moved.next_;
+            node->unlink();
+            insert(*node);
+        }
+    }
+}
+
+void TimerWheel::take_slot(TimerNode& slot, TimerNode& out) noexcept {
+    if (slot.next_ == &slot) {
+        out.prev_ = &out;
+        out.next_ = &out;
+        return;
+    }
+    out.next_ = slot.next_;
+    out.prev_ = slot.prev_;
+    out.next_->prev_ = &out;
+    out.prev_->next_ = &out;
+    slot.prev_ = &slot;
+    slot.next_ = &slot;
+}
+
+void TimerWheel::clear() noexcept {
+    for (auto& level : slots_) {
+        for (auto& slot : level) {
+            while (slot.next_ != &slot) {
+                slot.next_->unlink();
+            }
+        }
+    }
+    size_ = 0;
+}
+
+} // namespace quaxis::core
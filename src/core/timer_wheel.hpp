@@ -0,0 +1,184 @@
+/**
+ * @file timer_wheel.hpp
+ * @brief Иерархическое колесо таймеров с интрузивными узлами
+ *
+ * Сроки соединений ASIC (heartbeat, ожидание ответа на него, vardiff,
+ * grace период сессии) проверялись обходом всего списка соединений под
+ * connections_mutex раз в секунду. TimerWheel хранит каждый срок узлом,
+ * встроенным в запись владельца: постановка и снятие - O(1) без
+ * выделения памяти, шаг колеса трогает только сработавшие узлы.
+ *
+ * LEVELS уровней по SLOTS слотов: уровень L покрывает сроки до
+ * SLOTS^(L+1) шагов вперёд. Узел лежит на уровне старшего разряда, в
+ * котором его срок отличается от текущего шага; когда шаг доходит до
+ * границы разряда, слот верхнего уровня раскладывается ниже. Срок дальше
+ * горизонта колеса срабатывает на горизонте.
+ *
+ * Не потокобезопасно: владелец держит свой mutex.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace quaxis::core {
+
+class TimerWheel;
+
+/**
+ * @brief Узел таймера, встроенный в запись владельца
+ *
+ * Владелец наследует узел и в обработчике advance() приводит его к
+ * своему типу. Узел нельзя перемещать и удалять, пока он в колесе.
+ */
+class TimerNode {
+public:
+    TimerNode() = default;
+    TimerNode(const TimerNode&) = delete;
+    TimerNode& operator=(const TimerNode&) = delete;
+
+    /**
+     * @brief Узел стоит в колесе
+     */
+    [[nodiscard]] bool armed() const noexcept { return next_ != nullptr; }
+
+    /**
+     * @brief Шаг, на котором узел сработает
+     */
+    [[nodiscard]] uint64_t deadline() const noexcept { return deadline_; }
+
+private:
+    friend class TimerWheel;
+
+    void unlink() noexcept {
+        prev_->next_ = next_;
+        next_->prev_ = prev_;
+        prev_ = nullptr;
+        next_ = nullptr;
+    }
+
+    TimerNode* prev_ = nullptr;
+    TimerNode* next_ = nullptr;
+    uint64_t deadline_ = 0;
+};
+
+/**
+ * @brief Колесо таймеров: шаги - целые числа, их длительность задаёт владелец
+ */
+class TimerWheel {
+public:
+    /// @brief Бит номера слота на уровень
+    static constexpr unsigned SLOT_BITS = 6;
+
+    /// @brief Слотов на уровне
+    static constexpr std::size_t SLOTS = std::size_t{1} << SLOT_BITS;
+
+    /// @brief Уровней (горизонт - SLOTS^LEVELS шагов)
+    static constexpr std::size_t LEVELS = 4;
+
+    /// @brief Самая дальняя задержка
+    static constexpr uint64_t MAX_DELAY = (uint64_t{1} << (SLOT_BITS * LEVELS)) - 1;
+
+    /**
+     * @param now Текущий шаг
+     */
+    explicit TimerWheel(uint64_t now = 0) noexcept;
+
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    /**
+     * @brief Поставить узел через delay шагов (0 - на следующий шаг)
+     *
+     * Узел, уже стоящий в колесе, переставляется.
+     */
+    void schedule(TimerNode& node, uint64_t delay) noexcept;
+
+    /**
+     * @brief Снять узел (не стоящий в колесе - ничего)
+     */
+    void cancel(TimerNode& node) noexcept {
+        if (node.armed()) {
+            node.unlink();
+            --size_;
+        }
+    }
+
+    /**
+     * @brief Дойти до шага now, вызывая on_fire(TimerNode&) для сработавших
+     *
+     * Узел снят из колеса до вызова: обработчик может поставить его
+     * снова, снять или поставить другие узлы.
+     *
+     * @return std::size_t Сработавших узлов
+     */
+    template<typename OnFire>
+    std::size_t advance(uint64_t now, OnFire&& on_fire) {
+        std::size_t fired = 0;
+        while (now_ < now) {
+            if (size_ == 0) {
+                now_ = now;  // Пустое колесо: шаги без работы не перебираются
+                break;
+            }
+            ++now_;
+            cascade();
+
+            TimerNode due;
+            take_slot(level_slot(0, now_), due);
+            while (due.next_ != &due) {
+                TimerNode* node = due.next_;
+                node->unlink();
+                --size_;
+                ++fired;
+                on_fire(*node);
+            }
+        }
+        return fired;
+    }
+
+    /**
+     * @brief Снять все узлы
+     */
+    void clear() noexcept;
+
+    /**
+     * @brief Текущий шаг
+     */
+    [[nodiscard]] uint64_t now() const noexcept { return now_; }
+
+    /**
+     * @brief Узлов в колесе
+     */
+    [[nodiscard]] std::size_t size() const noexcept { return size_; }
+
+private:
+    /**
+     * @brief Слот уровня level, в который попадает шаг tick
+     */
+    TimerNode& level_slot(std::size_t level, uint64_t tick) noexcept {
+        return slots_[level][(tick >> (SLOT_BITS * level)) & (SLOTS - 1)];
+    }
+
+    /**
+     * @brief Вставить узел по его deadline_ (size_ не меняется)
+     */
+    void insert(TimerNode& node) noexcept;
+
+    /**
+     * @brief Разложить слоты верхних уровней, чья граница - now_
+     */
+    void cascade() noexcept;
+
+    /**
+     * @brief Перенести содержимое слота в пустой список out
+     */
+    static void take_slot(TimerNode& slot, TimerNode& out) noexcept;
+
+    std::array<std::array<TimerNode, SLOTS>, LEVELS> slots_;
+    uint64_t now_;
+    std::size_t size_ = 0;
+};
+
+} // namespace quaxis::core
@@ -6,6 +6,7 @@
  * - Hash256: 32-байтный хеш (SHA256, block hash, txid)
  * - Bytes: динамический массив байт
  * - Result<T>: обёртка std::expected для обработки ошибок
+ * - FastResult<T>: то же без аллокации на пути ошибки (парсеры)
  * 
  * @note Все типы оптимизированы для минимального копирования и
  *       максимальной производительности в критическом пути майнинга.
@@ -15,7 +16,9 @@
 
 #include <array>
 #include <cstdint>
+#include <cstring>
 #include <expected>
+#include <memory_resource>
 #include <span>
 #include <string>
 #include <string_view>
@@ -58,6 +61,14 @@ using Hash160 = std::array<uint8_t, 20>;
  */
 using Bytes = std::vector<uint8_t>;
 
+/**
+ * @brief Массив байт во внешнем memory_resource
+ * 
+ * Временные данные одного блока (core::BlockArena): память
+ * освобождается разом при следующем блоке, без free() на каждый буфер.
+ */
+using PmrBytes = std::pmr::vector<uint8_t>;
+
 /**
  * @brief Представление (view) на массив байт без владения
  * 
@@ -170,6 +181,42 @@ enum class ErrorCode {
 // Result тип (std::expected wrapper)
 // =============================================================================
 
+/**
+ * @brief Ошибка горячего пути: код и статический контекст
+ * 
+ * Error собирает std::string на каждом отказе; парсер кадров или
+ * датаграмм на мусорном трафике превращает путь ошибки в поток
+ * аллокаций. FastError хранит только код, строковый литерал контекста
+ * и errno - текст собирается в message(), когда ошибку выводят.
+ */
+struct FastError {
+    ErrorCode code{ErrorCode::Success};
+    
+    /// @brief Контекст (строковый литерал со статическим временем жизни)
+    const char* context{nullptr};
+    
+    /// @brief errno системного вызова (0 - нет)
+    int system_errno{0};
+    
+    /**
+     * @brief Текст ошибки (аллокация - только здесь)
+     */
+    [[nodiscard]] std::string message() const {
+        std::string text = context != nullptr ? std::string(context) : std::string(to_string(code));
+        if (system_errno != 0) {
+            text.append(": ").append(std::strerror(system_errno));
+        }
+        return text;
+    }
+    
+    /**
+     * @brief Оператор сравнения
+     */
+    [[nodiscard]] bool operator==(const FastError& other) const noexcept {
+        return code == other.code;
+    }
+};
+
 /**
  * @brief Ошибка с кодом и опциональным сообщением
  * 
@@ -179,6 +226,14 @@ struct Error {
     ErrorCode code;
     std::string message;
     
+    /**
+     * @brief Ошибка горячего пути с текстом, собранным сейчас
+     * 
+     * Неявное: FastResult<T> присваивается Result<T> на границе модуля.
+     */
+    Error(const FastError& fast)
+        : code(fast.code), message(fast.message()) {}
+    
     /**
      * @brief Создать ошибку только с кодом
      */
@@ -251,6 +306,29 @@ template<typename T>
     return std::unexpected(Error{code, std::move(message)});
 }
 
+/**
+ * @brief Результат горячего пути: значение или FastError
+ * 
+ * Отказ не аллоцирует; преобразуется в Result<T> неявно.
+ */
+template<typename T>
+using FastResult = std::expected<T, FastError>;
+
+/**
+ * @brief Создать FastResult с ошибкой
+ * 
+ * @param context Строковый литерал (указатель хранится как есть)
+ * @param system_errno errno системного вызова (0 - нет)
+ */
+template<typename T>
+[[nodiscard]] constexpr FastResult<T> FastErr(
+    ErrorCode code,
+    const char* context,
+    int system_errno = 0
+) noexcept {
+    return std::unexpected(FastError{code, context, system_errno});
+}
+
 // =============================================================================
 // Concepts для type constraints
 // =============================================================================
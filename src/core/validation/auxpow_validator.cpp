@@ -4,14 +4,206 @@
  */
 
 #include "auxpow_validator.hpp"
+#include "../../crypto/sha256.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
 
 namespace quaxis::core::validation {
 
+// =============================================================================
+// ParentProofCache
+// =============================================================================
+
+ParentProofCache::ParentProofCache(std::size_t capacity)
+    : capacity_(std::max<std::size_t>(capacity, 1))
+{
+    entries_.reserve(capacity_);
+}
+
+ParentProofCache::Key ParentProofCache::key_of(const AuxPow& auxpow) noexcept {
+    const auto& branch = auxpow.coinbase_branch;
+    return Key{
+        auxpow.parent_header.serialize(),
+        auxpow.coinbase_hash,
+        auxpow.coinbase_tx,
+        ByteSpan(reinterpret_cast<const uint8_t*>(branch.hashes.data()), branch.hashes.size() * 32),
+        branch.index
+    };
+}
+
+ParentProofCache::Key ParentProofCache::key_of(const AuxPowView& auxpow) noexcept {
+    return Key{
+        auxpow.parent_header.serialize(),
+        auxpow.coinbase_hash,
+        auxpow.coinbase_tx,
+        auxpow.coinbase_branch.hashes,
+        auxpow.coinbase_branch.index
+    };
+}
+
+std::optional<ParentProof> ParentProofCache::find(const AuxPow& auxpow) const {
+    return find_key(key_of(auxpow));
+}
+
+std::optional<ParentProof> ParentProofCache::find(const AuxPowView& auxpow) const {
+    return find_key(key_of(auxpow));
+}
+
+void ParentProofCache::insert(const AuxPow& auxpow, const ParentProof& proof) {
+    insert_key(key_of(auxpow), proof);
+}
+
+void ParentProofCache::insert(const AuxPowView& auxpow, const ParentProof& proof) {
+    insert_key(key_of(auxpow), proof);
+}
+
+std::optional<ParentProof> ParentProofCache::find_key(const Key& key) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& entry : entries_) {
+        if (entry.parent_header == key.parent_header &&
+            entry.coinbase_hash == key.coinbase_hash &&
+            entry.branch_index == key.branch_index &&
+            std::ranges::equal(entry.branch_hashes, key.branch_hashes) &&
+            std::ranges::equal(entry.coinbase_tx, key.coinbase_tx)) {
+            hits_.add();
+            return entry.proof;
+        }
+    }
+    misses_.add();
+    return std::nullopt;
+}
+
+void ParentProofCache::insert_key(const Key& key, const ParentProof& proof) {
+    Entry entry;
+    entry.parent_header = key.parent_header;
+    entry.coinbase_hash = key.coinbase_hash;
+    entry.coinbase_tx.assign(key.coinbase_tx.begin(), key.coinbase_tx.end());
+    entry.branch_hashes.assign(key.branch_hashes.begin(), key.branch_hashes.end());
+    entry.branch_index = key.branch_index;
+    entry.proof = proof;
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (entries_.size() < capacity_) {
+        entries_.push_back(std::move(entry));
+        return;
+    }
+    entries_[next_] = std::move(entry);
+    next_ = (next_ + 1) % capacity_;
+}
+
+void ParentProofCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+    next_ = 0;
+}
+
+std::size_t ParentProofCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
+
+// =============================================================================
+// AuxPowValidator
+// =============================================================================
+
 AuxPowValidator::AuxPowValidator(const ChainParams& params)
     : params_(params) {}
 
-AuxPowValidationResult AuxPowValidator::validate(
-    const AuxPow& auxpow,
+namespace {
+
+// Проверки, общие для AuxPow и AuxPowView
+
+template<typename AuxPowLike>
+AuxPowValidationResult check_coinbase_branch(const AuxPowLike& auxpow) {
+    // Проверяем что coinbase branch ведёт к merkle root
+    auto computed_root = auxpow.coinbase_branch.compute_root(auxpow.coinbase_hash);
+    
+    if (computed_root != auxpow.parent_header.merkle_root) {
+        return AuxPowValidationResult::failure(
+            "Coinbase branch does not lead to merkle root"
+        );
+    }
+    
+    return AuxPowValidationResult::success();
+}
+
+template<typename AuxPowLike>
+AuxPowValidationResult check_aux_branch(const AuxPowLike& auxpow, const Hash256& aux_hash) {
+    // Находим commitment в coinbase
+    auto commitment = AuxPowCommitment::find_in_coinbase(auxpow.coinbase_tx);
+    if (!commitment) {
+        return AuxPowValidationResult::failure(
+            "AuxPoW commitment not found in coinbase"
+        );
+    }
+    
+    // Проверяем aux branch
+    auto computed_aux_root = auxpow.aux_branch.compute_root(aux_hash);
+    if (computed_aux_root != commitment->aux_merkle_root) {
+        return AuxPowValidationResult::failure(
+            "Aux branch does not lead to aux merkle root"
+        );
+    }
+    
+    return AuxPowValidationResult::success();
+}
+
+template<typename AuxPowLike>
+AuxPowValidationResult check_chain_id(const AuxPowLike& auxpow, uint32_t chain_id) {
+    uint32_t parent_chain_id = auxpow.get_chain_id();
+    
+    // Chain ID в parent header должен соответствовать нашей chain
+    // или быть 0 (Bitcoin без AuxPoW флага)
+    if (parent_chain_id != 0 && parent_chain_id != chain_id) {
+        return AuxPowValidationResult::failure(
+            "Parent block chain ID mismatch"
+        );
+    }
+    
+    return AuxPowValidationResult::success();
+}
+
+/**
+ * @brief Проверки AuxPoW, не зависящие от aux chain
+ */
+template<typename AuxPowLike>
+ParentProof prove_parent(const AuxPowLike& auxpow) {
+    ParentProof proof;
+    proof.parent_hash = auxpow.parent_header.hash();
+    proof.coinbase_valid =
+        auxpow.coinbase_branch.compute_root(auxpow.coinbase_hash) == auxpow.parent_header.merkle_root;
+    if (auto commitment = AuxPowCommitment::find_in_coinbase(auxpow.coinbase_tx)) {
+        proof.aux_merkle_root = commitment->aux_merkle_root;
+    }
+    proof.pow_valid = uint256{proof.parent_hash} <= auxpow.parent_header.get_target();
+    return proof;
+}
+
+// Доступ к хешам branch для пакетного обхода
+
+std::size_t branch_size(const MerkleBranch& branch) noexcept {
+    return branch.hashes.size();
+}
+
+std::size_t branch_size(const MerkleBranchView& branch) noexcept {
+    return branch.size();
+}
+
+const uint8_t* branch_hash(const MerkleBranch& branch, std::size_t i) noexcept {
+    return branch.hashes[i].data();
+}
+
+const uint8_t* branch_hash(const MerkleBranchView& branch, std::size_t i) noexcept {
+    return branch.hashes.data() + i * 32;
+}
+
+} // anonymous namespace
+
+template<typename AuxPowLike>
+AuxPowValidationResult AuxPowValidator::validate_impl(
+    const AuxPowLike& auxpow,
     const Hash256& aux_hash,
     uint32_t height
 ) const {
@@ -21,20 +213,20 @@ AuxPowValidationResult AuxPowValidator::validate(
     }
     
     // Проверяем coinbase branch
-    auto coinbase_result = validate_coinbase_branch(auxpow);
+    auto coinbase_result = check_coinbase_branch(auxpow);
     if (!coinbase_result) {
         return coinbase_result;
     }
     
     // Проверяем aux branch
-    auto aux_result = validate_aux_branch(auxpow, aux_hash);
+    auto aux_result = check_aux_branch(auxpow, aux_hash);
     if (!aux_result) {
         return aux_result;
     }
     
     // Проверяем chain ID (если требуется)
     if (params_.auxpow.chain_id != 0) {
-        auto chain_id_result = validate_chain_id(auxpow);
+        auto chain_id_result = check_chain_id(auxpow, params_.auxpow.chain_id);
         if (!chain_id_result) {
             return chain_id_result;
         }
@@ -48,65 +240,256 @@ AuxPowValidationResult AuxPowValidator::validate(
     return AuxPowValidationResult::success();
 }
 
-bool AuxPowValidator::validate_pow(
+AuxPowValidationResult AuxPowValidator::validate(
     const AuxPow& auxpow,
-    uint32_t target_bits
-) const noexcept {
-    return auxpow.meets_target(target_bits);
+    const Hash256& aux_hash,
+    uint32_t height
+) const {
+    return validate_impl(auxpow, aux_hash, height);
 }
 
-AuxPowValidationResult AuxPowValidator::validate_coinbase_branch(
-    const AuxPow& auxpow
+AuxPowValidationResult AuxPowValidator::validate(
+    const AuxPowView& auxpow,
+    const Hash256& aux_hash,
+    uint32_t height
 ) const {
-    // Проверяем что coinbase branch ведёт к merkle root
-    auto computed_root = auxpow.coinbase_branch.compute_root(auxpow.coinbase_hash);
+    return validate_impl(auxpow, aux_hash, height);
+}
+
+template<typename AuxPowLike>
+AuxPowValidationResult AuxPowValidator::validate_cached_impl(
+    const AuxPowLike& auxpow,
+    const Hash256& aux_hash,
+    uint32_t height,
+    ParentProofCache& cache
+) const {
+    if (!params_.auxpow.is_active(height)) {
+        return AuxPowValidationResult::failure("AuxPoW not active at this height");
+    }
     
-    if (computed_root != auxpow.parent_header.merkle_root) {
+    // Coinbase branch, commitment и PoW родителя - один раз на находку
+    auto proof = cache.find(auxpow);
+    if (!proof) {
+        proof = prove_parent(auxpow);
+        cache.insert(auxpow, *proof);
+    }
+    
+    // Проверки в порядке validate()
+    if (!proof->coinbase_valid) {
         return AuxPowValidationResult::failure(
             "Coinbase branch does not lead to merkle root"
         );
     }
-    
-    return AuxPowValidationResult::success();
-}
-
-AuxPowValidationResult AuxPowValidator::validate_aux_branch(
-    const AuxPow& auxpow,
-    const Hash256& aux_hash
-) const {
-    // Находим commitment в coinbase
-    auto commitment = AuxPowCommitment::find_in_coinbase(auxpow.coinbase_tx);
-    if (!commitment) {
+    if (!proof->aux_merkle_root) {
         return AuxPowValidationResult::failure(
             "AuxPoW commitment not found in coinbase"
         );
     }
-    
-    // Проверяем aux branch
-    auto computed_aux_root = auxpow.aux_branch.compute_root(aux_hash);
-    if (computed_aux_root != commitment->aux_merkle_root) {
+    if (auxpow.aux_branch.compute_root(aux_hash) != *proof->aux_merkle_root) {
         return AuxPowValidationResult::failure(
             "Aux branch does not lead to aux merkle root"
         );
     }
     
+    if (params_.auxpow.chain_id != 0) {
+        auto chain_id_result = check_chain_id(auxpow, params_.auxpow.chain_id);
+        if (!chain_id_result) {
+            return chain_id_result;
+        }
+    }
+    
+    if (!proof->pow_valid) {
+        return AuxPowValidationResult::failure("Parent block PoW invalid");
+    }
+    
     return AuxPowValidationResult::success();
 }
 
-AuxPowValidationResult AuxPowValidator::validate_chain_id(
-    const AuxPow& auxpow
+AuxPowValidationResult AuxPowValidator::validate(
+    const AuxPow& auxpow,
+    const Hash256& aux_hash,
+    uint32_t height,
+    ParentProofCache& cache
 ) const {
-    uint32_t parent_chain_id = auxpow.get_chain_id();
+    return validate_cached_impl(auxpow, aux_hash, height, cache);
+}
+
+AuxPowValidationResult AuxPowValidator::validate(
+    const AuxPowView& auxpow,
+    const Hash256& aux_hash,
+    uint32_t height,
+    ParentProofCache& cache
+) const {
+    return validate_cached_impl(auxpow, aux_hash, height, cache);
+}
+
+template<typename AuxPowLike>
+std::size_t AuxPowValidator::validate_batch_impl(
+    std::span<const AuxPowLike> auxpows,
+    std::span<const Hash256> aux_hashes,
+    uint32_t height,
+    std::span<AuxPowValidationResult> results
+) const {
+    std::size_t count = std::min({auxpows.size(), aux_hashes.size(), results.size()});
     
-    // Chain ID в parent header должен соответствовать нашей chain
-    // или быть 0 (Bitcoin без AuxPoW флага)
-    if (parent_chain_id != 0 && parent_chain_id != params_.auxpow.chain_id) {
-        return AuxPowValidationResult::failure(
-            "Parent block chain ID mismatch"
-        );
+    // Проверяем активацию AuxPoW
+    if (!params_.auxpow.is_active(height)) {
+        for (std::size_t i = 0; i < count; ++i) {
+            results[i] = AuxPowValidationResult::failure("AuxPoW not active at this height");
+        }
+        return 0;
     }
     
-    return AuxPowValidationResult::success();
+    // Путь 2i - coinbase branch элемента i, 2i + 1 - aux branch.
+    // На каждом уровне пары (left || right) всех ещё не законченных
+    // путей идут подряд в messages и хешируются одним вызовом.
+    std::vector<Hash256> nodes(count * 2);
+    for (std::size_t i = 0; i < count; ++i) {
+        nodes[2 * i] = auxpows[i].coinbase_hash;
+        nodes[2 * i + 1] = aux_hashes[i];
+    }
+    
+    std::vector<uint8_t> messages;
+    std::vector<uint32_t> paths;
+    std::vector<Hash256> digests;
+    messages.reserve(nodes.size() * 64);
+    paths.reserve(nodes.size());
+    
+    for (std::size_t depth = 0;; ++depth) {
+        messages.clear();
+        paths.clear();
+        
+        for (std::size_t path = 0; path < nodes.size(); ++path) {
+            const auto& auxpow = auxpows[path / 2];
+            const auto& branch = (path & 1) ? auxpow.aux_branch : auxpow.coinbase_branch;
+            if (depth >= branch_size(branch)) {
+                continue;
+            }
+            
+            // Бит индекса как в compute_root (после 32 уровней - ноль)
+            bool right = depth < 32 && ((branch.index >> depth) & 1);
+            const uint8_t* sibling = branch_hash(branch, depth);
+            std::size_t offset = messages.size();
+            messages.resize(offset + 64);
+            std::memcpy(messages.data() + offset + (right ? 32 : 0), nodes[path].data(), 32);
+            std::memcpy(messages.data() + offset + (right ? 0 : 32), sibling, 32);
+            paths.push_back(static_cast<uint32_t>(path));
+        }
+        
+        if (paths.empty()) {
+            break;
+        }
+        
+        digests.resize(paths.size());
+        (void)crypto::sha256d64_batch(messages, digests);
+        for (std::size_t k = 0; k < paths.size(); ++k) {
+            nodes[paths[k]] = digests[k];
+        }
+    }
+    
+    // Хеши родительских заголовков пачкой
+    std::vector<BlockHeader> parents(count);
+    std::vector<Hash256> parent_hashes(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        parents[i] = auxpows[i].parent_header;
+    }
+    (void)hash_headers(parents, parent_hashes);
+    
+    // Проверки в порядке validate()
+    std::size_t valid = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        const auto& auxpow = auxpows[i];
+        
+        if (nodes[2 * i] != auxpow.parent_header.merkle_root) {
+            results[i] = AuxPowValidationResult::failure(
+                "Coinbase branch does not lead to merkle root"
+            );
+            continue;
+        }
+        
+        auto commitment = AuxPowCommitment::find_in_coinbase(auxpow.coinbase_tx);
+        if (!commitment) {
+            results[i] = AuxPowValidationResult::failure(
+                "AuxPoW commitment not found in coinbase"
+            );
+            continue;
+        }
+        if (nodes[2 * i + 1] != commitment->aux_merkle_root) {
+            results[i] = AuxPowValidationResult::failure(
+                "Aux branch does not lead to aux merkle root"
+            );
+            continue;
+        }
+        
+        if (params_.auxpow.chain_id != 0) {
+            auto chain_id_result = check_chain_id(auxpow, params_.auxpow.chain_id);
+            if (!chain_id_result) {
+                results[i] = std::move(chain_id_result);
+                continue;
+            }
+        }
+        
+        if (uint256{parent_hashes[i]} > auxpow.parent_header.get_target()) {
+            results[i] = AuxPowValidationResult::failure("Parent block PoW invalid");
+            continue;
+        }
+        
+        results[i] = AuxPowValidationResult::success();
+        ++valid;
+    }
+    
+    return valid;
+}
+
+std::size_t AuxPowValidator::validate_batch(
+    std::span<const AuxPow> auxpows,
+    std::span<const Hash256> aux_hashes,
+    uint32_t height,
+    std::span<AuxPowValidationResult> results
+) const {
+    return validate_batch_impl(auxpows, aux_hashes, height, results);
+}
+
+std::size_t AuxPowValidator::validate_batch(
+    std::span<const AuxPowView> auxpows,
+    std::span<const Hash256> aux_hashes,
+    uint32_t height,
+    std::span<AuxPowValidationResult> results
+) const {
+    return validate_batch_impl(auxpows, aux_hashes, height, results);
+}
+
+bool AuxPowValidator::validate_pow(
+    const AuxPow& auxpow,
+    uint32_t target_bits
+) const noexcept {
+    return auxpow.meets_target(target_bits);
+}
+
+bool AuxPowValidator::validate_pow(
+    const AuxPowView& auxpow,
+    uint32_t target_bits
+) const noexcept {
+    return auxpow.meets_target(target_bits);
+}
+
+AuxPowValidationResult AuxPowValidator::validate_coinbase_branch(
+    const AuxPow& auxpow
+) const {
+    return check_coinbase_branch(auxpow);
+}
+
+AuxPowValidationResult AuxPowValidator::validate_aux_branch(
+    const AuxPow& auxpow,
+    const Hash256& aux_hash
+) const {
+    return check_aux_branch(auxpow, aux_hash);
+}
+
+AuxPowValidationResult AuxPowValidator::validate_chain_id(
+    const AuxPow& auxpow
+) const {
+    return check_chain_id(auxpow, params_.auxpow.chain_id);
 }
 
 uint32_t AuxPowValidator::get_chain_id() const noexcept {
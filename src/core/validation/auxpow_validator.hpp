@@ -3,17 +3,31 @@
  * @brief Валидатор Auxiliary Proof-of-Work
  * 
  * Проверяет корректность AuxPoW для merged mining.
+ * 
+ * Одна находка родителя часто проходит target нескольких aux chains,
+ * и их AuxPoW различаются только aux branch: coinbase branch, commitment
+ * и PoW родителя одинаковы. ParentProofCache задания хранит результат
+ * этих проверок, и validate() с кешем для каждой следующей chain
+ * проверяет только её aux branch.
  */
 
 #pragma once
 
 #include "../chain/chain_params.hpp"
 #include "../primitives/auxpow.hpp"
+#include "../stats_counter.hpp"
 
+#include <array>
+#include <mutex>
 #include <optional>
+#include <span>
+#include <vector>
 
 namespace quaxis::core::validation {
 
+/// @brief Записей в ParentProofCache по умолчанию (находок одного задания)
+inline constexpr std::size_t PARENT_PROOF_CACHE_SIZE = 8;
+
 /**
  * @brief Результат валидации AuxPoW
  */
@@ -32,6 +46,106 @@ struct AuxPowValidationResult {
     }
 };
 
+/**
+ * @brief Проверки родительской части AuxPoW, общие для всех aux chains
+ */
+struct ParentProof {
+    /// @brief Хеш родительского заголовка
+    Hash256 parent_hash{};
+    
+    /// @brief Coinbase branch ведёт к merkle root родителя
+    bool coinbase_valid{false};
+    
+    /// @brief Корень aux дерева из commitment в coinbase (nullopt - не найден)
+    std::optional<Hash256> aux_merkle_root;
+    
+    /// @brief PoW родителя по его собственному bits
+    bool pow_valid{false};
+};
+
+/**
+ * @brief Кеш проверок родителя для находок одного задания
+ * 
+ * Ключ - родительский заголовок (80 байт, его хеш хранится в записи)
+ * вместе с coinbase_tx, coinbase_hash и coinbase branch - всем, кроме
+ * aux branch: другой coinbase или branch с тем же заголовком - другая
+ * запись. Записи вытесняются по кругу; clear() -
+ * при смене задания. Один кеш делят валидаторы всех chains, методы
+ * потокобезопасны.
+ */
+class ParentProofCache {
+public:
+    /**
+     * @brief Создать кеш
+     * 
+     * @param capacity Записей (минимум 1)
+     */
+    explicit ParentProofCache(std::size_t capacity = PARENT_PROOF_CACHE_SIZE);
+    
+    /**
+     * @brief Найти проверки родителя
+     * 
+     * @return Проверки или nullopt (промах)
+     */
+    [[nodiscard]] std::optional<ParentProof> find(const AuxPow& auxpow) const;
+    [[nodiscard]] std::optional<ParentProof> find(const AuxPowView& auxpow) const;
+    
+    /**
+     * @brief Запомнить проверки родителя, вытеснив самую старую запись
+     */
+    void insert(const AuxPow& auxpow, const ParentProof& proof);
+    void insert(const AuxPowView& auxpow, const ParentProof& proof);
+    
+    /**
+     * @brief Забыть все записи (новое задание)
+     */
+    void clear();
+    
+    /**
+     * @brief Записей в кеше
+     */
+    [[nodiscard]] std::size_t size() const;
+    
+    /// @brief Попаданий find()
+    [[nodiscard]] uint64_t hits() const noexcept { return hits_.load(); }
+    
+    /// @brief Промахов find()
+    [[nodiscard]] uint64_t misses() const noexcept { return misses_.load(); }
+
+private:
+    /// @brief Родительская часть AuxPoW (view в AuxPow или AuxPowView)
+    struct Key {
+        std::array<uint8_t, BLOCK_HEADER_SIZE> parent_header;
+        const Hash256& coinbase_hash;
+        ByteSpan coinbase_tx;
+        ByteSpan branch_hashes;
+        uint32_t branch_index;
+    };
+    
+    struct Entry {
+        std::array<uint8_t, BLOCK_HEADER_SIZE> parent_header{};
+        Hash256 coinbase_hash{};
+        Bytes coinbase_tx;
+        Bytes branch_hashes;
+        uint32_t branch_index{0};
+        ParentProof proof;
+    };
+    
+    [[nodiscard]] static Key key_of(const AuxPow& auxpow) noexcept;
+    [[nodiscard]] static Key key_of(const AuxPowView& auxpow) noexcept;
+    
+    [[nodiscard]] std::optional<ParentProof> find_key(const Key& key) const;
+    void insert_key(const Key& key, const ParentProof& proof);
+    
+    std::size_t capacity_;
+    std::size_t next_{0};
+    std::vector<Entry> entries_;
+    mutable std::mutex mutex_;
+    
+    mutable RelaxedCounter hits_;
+    mutable RelaxedCounter misses_;
+};
+
 /**
  * @brief Валидатор AuxPoW
  * 
@@ -64,6 +178,70 @@ public:
         uint32_t height
     ) const;
     
+    /**
+     * @brief Полная валидация AuxPoW без копирования
+     * 
+     * То же, что validate(const AuxPow&, ...), над AuxPowView::parse()
+     * входного буфера: успешная проверка не выделяет память.
+     */
+    [[nodiscard]] AuxPowValidationResult validate(
+        const AuxPowView& auxpow,
+        const Hash256& aux_hash,
+        uint32_t height
+    ) const;
+    
+    /**
+     * @brief Полная валидация AuxPoW с кешем проверок родителя
+     * 
+     * Результат тот же, что validate(auxpow, aux_hash, height). Coinbase
+     * branch, commitment и PoW родителя берутся из cache (при промахе
+     * проверяются и кладутся туда), самостоятельно проверяются только
+     * активация, aux branch этой chain и chain ID.
+     * 
+     * @param cache Кеш задания, общий для валидаторов всех chains
+     */
+    [[nodiscard]] AuxPowValidationResult validate(
+        const AuxPow& auxpow,
+        const Hash256& aux_hash,
+        uint32_t height,
+        ParentProofCache& cache
+    ) const;
+    
+    [[nodiscard]] AuxPowValidationResult validate(
+        const AuxPowView& auxpow,
+        const Hash256& aux_hash,
+        uint32_t height,
+        ParentProofCache& cache
+    ) const;
+    
+    /**
+     * @brief Пакетная валидация AuxPoW
+     * 
+     * Результат results[i] тот же, что validate(auxpows[i], aux_hashes[i],
+     * height), но хеши узлов branches всех элементов считаются по
+     * уровням пачками через crypto::sha256d64_batch, а заголовки
+     * родительских блоков - через hash_headers().
+     * 
+     * @param auxpows AuxPoW для проверки
+     * @param aux_hashes Хеши блоков auxiliary chain (по одному на AuxPoW)
+     * @param height Высота блоков (для проверки активации)
+     * @param results Результаты
+     * @return Количество валидных (проверяется минимум из размеров)
+     */
+    std::size_t validate_batch(
+        std::span<const AuxPow> auxpows,
+        std::span<const Hash256> aux_hashes,
+        uint32_t height,
+        std::span<AuxPowValidationResult> results
+    ) const;
+    
+    std::size_t validate_batch(
+        std::span<const AuxPowView> auxpows,
+        std::span<const Hash256> aux_hashes,
+        uint32_t height,
+        std::span<AuxPowValidationResult> results
+    ) const;
+    
     /**
      * @brief Проверить только PoW (быстрая проверка)
      * 
@@ -76,6 +254,11 @@ public:
         uint32_t target_bits
     ) const noexcept;
     
+    [[nodiscard]] bool validate_pow(
+        const AuxPowView& auxpow,
+        uint32_t target_bits
+    ) const noexcept;
+    
     /**
      * @brief Проверить coinbase branch
      * 
@@ -114,6 +297,29 @@ public:
     [[nodiscard]] uint32_t get_chain_id() const noexcept;
     
 private:
+    template<typename AuxPowLike>
+    [[nodiscard]] AuxPowValidationResult validate_impl(
+        const AuxPowLike& auxpow,
+        const Hash256& aux_hash,
+        uint32_t height
+    ) const;
+    
+    template<typename AuxPowLike>
+    [[nodiscard]] AuxPowValidationResult validate_cached_impl(
+        const AuxPowLike& auxpow,
+        const Hash256& aux_hash,
+        uint32_t height,
+        ParentProofCache& cache
+    ) const;
+    
+    template<typename AuxPowLike>
+    std::size_t validate_batch_impl(
+        std::span<const AuxPowLike> auxpows,
+        std::span<const Hash256> aux_hashes,
+        uint32_t height,
+        std::span<AuxPowValidationResult> results
+    ) const;
+    
     const ChainParams& params_;
 };
 
@@ -4,9 +4,85 @@
  */
 
 #include "pow_validator.hpp"
+#include "../chain/difficulty.hpp"
+
+#include <algorithm>
+#include <array>
 
 namespace quaxis::core::validation {
 
+namespace {
+
+/**
+ * @brief Декодированные target последних значений bits
+ * 
+ * Недопустимые bits (accept() == false) - нулевой target: проверку не
+ * пройдёт ни один хеш.
+ */
+class TargetCache {
+public:
+    template <typename Accept>
+    [[nodiscard]] const uint256& get(uint32_t bits, Accept& accept) noexcept {
+        for (std::size_t i = 0; i < used_; ++i) {
+            if (entries_[i].bits == bits) {
+                return entries_[i].target;
+            }
+        }
+        auto& entry = entries_[next_];
+        entry.bits = bits;
+        entry.target = accept(bits) ? bits_to_target(bits) : uint256::zero();
+        next_ = (next_ + 1) % entries_.size();
+        used_ = std::min(used_ + 1, entries_.size());
+        return entry.target;
+    }
+
+private:
+    struct Entry {
+        uint32_t bits{0};
+        uint256 target;
+    };
+    std::array<Entry, 4> entries_{};
+    std::size_t next_{0};
+    std::size_t used_{0};
+};
+
+/**
+ * @brief Пакетная проверка: хеши кусками, сравнение с target из кэша
+ */
+template <typename Accept>
+std::size_t check_pow_batch(
+    std::span<const BlockHeader> headers,
+    std::span<uint64_t> bitmap,
+    std::span<Hash256> hashes,
+    Accept&& accept
+) noexcept {
+    constexpr std::size_t CHUNK = 64;
+    std::array<Hash256, CHUNK> scratch;
+    TargetCache targets;
+    std::size_t valid = 0;
+    
+    const std::size_t count = std::min(headers.size(), bitmap.size() * 64);
+    std::fill(bitmap.begin(), bitmap.begin() + static_cast<std::ptrdiff_t>(pow_bitmap_words(count)), 0);
+    for (std::size_t start = 0; start < count; start += CHUNK) {
+        const std::size_t n = std::min(CHUNK, count - start);
+        auto out = hashes.size() >= start + n ? hashes.subspan(start, n) : std::span<Hash256>(scratch.data(), n);
+        (void)hash_headers(headers.subspan(start, n), out);
+        
+        uint64_t word = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            const auto& target = targets.get(headers[start + i].bits, accept);
+            if (!target.is_zero() && uint256{out[i]} <= target) {
+                word |= uint64_t{1} << i;
+                ++valid;
+            }
+        }
+        bitmap[start / 64] = word;
+    }
+    return valid;
+}
+
+} // anonymous namespace
+
 PowValidator::PowValidator(const ChainParams& params)
     : params_(params) {}
 
@@ -20,6 +96,21 @@ bool PowValidator::validate_pow(const BlockHeader& header) const noexcept {
     return header.check_pow();
 }
 
+bool PowValidator::validate_pow(const BlockHeader& header, const Hash256& hash) const noexcept {
+    if (!validate_bits(header.bits)) {
+        return false;
+    }
+    return uint256{hash} <= header.get_target();
+}
+
+std::size_t PowValidator::validate_pow_batch(
+    std::span<const BlockHeader> headers,
+    std::span<uint64_t> bitmap,
+    std::span<Hash256> hashes
+) const noexcept {
+    return check_pow_batch(headers, bitmap, hashes, [this](uint32_t bits) { return validate_bits(bits); });
+}
+
 bool PowValidator::check_hash_target(
     const Hash256& hash,
     uint32_t target_bits
@@ -58,27 +149,9 @@ uint32_t PowValidator::calculate_next_target(
     uint32_t last_bits,
     int64_t actual_timespan
 ) const noexcept {
-    auto expected = get_expected_timespan();
-    
-    // Ограничиваем timespan (Bitcoin: 4x max)
-    if (actual_timespan < expected / 4) {
-        actual_timespan = expected / 4;
-    }
-    if (actual_timespan > expected * 4) {
-        actual_timespan = expected * 4;
-    }
-    
-    // ПРИМЕЧАНИЕ: Пересчёт difficulty не требуется для merged mining,
-    // так как target берётся напрямую из шаблона блока auxiliary chain.
-    // Эта функция используется только для валидации исторических блоков
-    // при полной синхронизации, что выходит за рамки данного модуля.
-    // 
-    // Для полной реализации требуется:
-    // 1. uint256 арифметика (умножение/деление)
-    // 2. Учёт специфики каждой chain (разные алгоритмы retarget)
-    (void)actual_timespan;
-    
-    return last_bits;
+    // Для merged mining target берётся из шаблона aux chain; здесь -
+    // проверка исторических блоков при синхронизации
+    return target_to_bits(core::calculate_next_target(params_.difficulty, last_bits, actual_timespan));
 }
 
 int64_t PowValidator::get_expected_timespan() const noexcept {
@@ -90,4 +163,12 @@ bool quick_check_pow(const BlockHeader& header) noexcept {
     return header.check_pow();
 }
 
+std::size_t quick_check_pow_batch(
+    std::span<const BlockHeader> headers,
+    std::span<uint64_t> bitmap,
+    std::span<Hash256> hashes
+) noexcept {
+    return check_pow_batch(headers, bitmap, hashes, [](uint32_t) { return true; });
+}
+
 } // namespace quaxis::core::validation
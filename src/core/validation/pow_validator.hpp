@@ -10,8 +10,21 @@
 #include "../chain/chain_params.hpp"
 #include "../primitives/block_header.hpp"
 
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
 namespace quaxis::core::validation {
 
+/**
+ * @brief Слов битовой карты пакетной проверки для count заголовков
+ * 
+ * Бит i (bitmap[i / 64] >> (i % 64)) - PoW заголовка i валиден.
+ */
+[[nodiscard]] constexpr std::size_t pow_bitmap_words(std::size_t count) noexcept {
+    return (count + 63) / 64;
+}
+
 /**
  * @brief Валидатор Proof-of-Work
  * 
@@ -37,6 +50,32 @@ public:
      */
     [[nodiscard]] bool validate_pow(const BlockHeader& header) const noexcept;
     
+    /**
+     * @brief Проверить proof-of-work по заранее вычисленному хешу
+     * 
+     * @param header Заголовок блока
+     * @param hash header.hash() (например, из hash_headers())
+     * @return true если PoW валиден
+     */
+    [[nodiscard]] bool validate_pow(const BlockHeader& header, const Hash256& hash) const noexcept;
+    
+    /**
+     * @brief Проверить proof-of-work пачки заголовков
+     * 
+     * Как quick_check_pow_batch(), плюс validate_bits() (один раз на
+     * значение bits).
+     * 
+     * @param headers Заголовки
+     * @param bitmap Результат, не меньше pow_bitmap_words(headers.size()) слов
+     * @param hashes Хеши заголовков (пусто - не нужны), не меньше headers.size()
+     * @return Количество заголовков с валидным PoW
+     */
+    std::size_t validate_pow_batch(
+        std::span<const BlockHeader> headers,
+        std::span<uint64_t> bitmap,
+        std::span<Hash256> hashes = {}
+    ) const noexcept;
+    
     /**
      * @brief Проверить, соответствует ли хеш target
      * 
@@ -88,4 +127,22 @@ private:
  */
 [[nodiscard]] bool quick_check_pow(const BlockHeader& header) noexcept;
 
+/**
+ * @brief Быстрая проверка PoW пачки заголовков
+ * 
+ * Хеши - пакетный SHA256d (hash_headers(), multi-buffer), target
+ * декодируется один раз на значение bits: в пачке их обычно одно-два.
+ * Для синхронизации, всплесков FIBRE и гонки нескольких источников.
+ * 
+ * @param headers Заголовки
+ * @param bitmap Результат, не меньше pow_bitmap_words(headers.size()) слов
+ * @param hashes Хеши заголовков (пусто - не нужны), не меньше headers.size()
+ * @return Количество заголовков с hash <= target(bits)
+ */
+std::size_t quick_check_pow_batch(
+    std::span<const BlockHeader> headers,
+    std::span<uint64_t> bitmap,
+    std::span<Hash256> hashes = {}
+) noexcept;
+
 } // namespace quaxis::core::validation
@@ -3,18 +3,27 @@
  * @brief Реализация SHA256 диспетчера
  * 
  * Выбирает оптимальную реализацию SHA256 в зависимости от
- * поддержки аппаратных инструкций CPU.
+ * поддержки аппаратных инструкций CPU. Выбор делается один раз при
+ * загрузке и записывается в таблицу указателей на функции: горячие
+ * функции (transform, заголовок с midstate, sha256d64) вызывают ядро
+ * через указатель, без проверок флагов CPU на каждом хеше.
  */
 
 #include "sha256.hpp"
 #include "../core/byte_order.hpp"
 
+#include <algorithm>
 #include <cstring>
 
 #ifdef __x86_64__
 #include <cpuid.h>
 #endif
 
+#if defined(__aarch64__) && defined(QUAXIS_HAS_ARM_SHA2)
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
+
 namespace quaxis::crypto {
 
 // =============================================================================
@@ -24,12 +33,38 @@ namespace quaxis::crypto {
 // Generic реализация (всегда доступна)
 namespace generic {
     void sha256_transform(Sha256State& state, const uint8_t* block) noexcept;
+    Hash256 hash_header_with_midstate(const Sha256State& midstate, const uint8_t* tail) noexcept;
 }
 
 // SHA-NI реализация (только если поддерживается)
 #ifdef QUAXIS_HAS_SHANI
 namespace shani {
     void sha256_transform(Sha256State& state, const uint8_t* block) noexcept;
+    Hash256 hash_header_with_midstate(const Sha256State& midstate, const uint8_t* tail) noexcept;
+    void sha256d64(Hash256* out, const uint8_t* in, std::size_t count) noexcept;
+}
+#endif
+
+// ARMv8 Crypto Extensions (только aarch64)
+#ifdef QUAXIS_HAS_ARM_SHA2
+namespace arm_sha2 {
+    void sha256_transform(Sha256State& state, const uint8_t* block) noexcept;
+    Hash256 hash_header_with_midstate(const Sha256State& midstate, const uint8_t* tail) noexcept;
+}
+#endif
+
+// Многоканальные реализации (только если поддерживаются компилятором)
+#ifdef QUAXIS_HAS_AVX2
+namespace avx2 {
+    void hash_headers_x8(const Sha256State* midstates, const HeaderTail* tails, Hash256* out) noexcept;
+    void sha256_transform_x8(Sha256State* states, const uint8_t* blocks, std::size_t stride) noexcept;
+}
+#endif
+
+#ifdef QUAXIS_HAS_AVX512
+namespace avx512 {
+    void hash_headers_x16(const Sha256State* midstates, const HeaderTail* tails, Hash256* out) noexcept;
+    void sha256_transform_x16(Sha256State* states, const uint8_t* blocks, std::size_t stride) noexcept;
 }
 #endif
 
@@ -69,6 +104,186 @@ bool detect_sha_ni() noexcept {
 /// @brief Кешированный результат детекции SHA-NI
 const bool g_has_sha_ni = detect_sha_ni();
 
+/**
+ * @brief Проверка SHA2 инструкций ARMv8 через getauxval(AT_HWCAP)
+ * 
+ * На aarch64 чтение ID-регистров из user space эмулирует ядро,
+ * а HWCAP - штатный способ узнать о расширениях CPU.
+ */
+bool detect_arm_sha2() noexcept {
+#if defined(__aarch64__) && defined(QUAXIS_HAS_ARM_SHA2)
+#ifndef HWCAP_SHA2
+#define HWCAP_SHA2 (1 << 6)
+#endif
+    return (getauxval(AT_HWCAP) & HWCAP_SHA2) != 0;
+#else
+    return false;
+#endif
+}
+
+/// @brief Кешированный результат детекции SHA2 ARMv8
+const bool g_has_arm_sha2 = detect_arm_sha2();
+
+#if defined(__x86_64__) && (defined(QUAXIS_HAS_AVX2) || defined(QUAXIS_HAS_AVX512))
+/**
+ * @brief Прочитать XCR0 (какие регистры сохраняет ОС при переключении контекста)
+ * 
+ * Без поддержки со стороны ОС ymm/zmm регистры использовать нельзя,
+ * даже если CPUID сообщает о наличии AVX2/AVX-512.
+ */
+uint64_t read_xcr0() noexcept {
+    uint32_t lo, hi;
+    __asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+    return (static_cast<uint64_t>(hi) << 32) | lo;
+}
+#endif
+
+/**
+ * @brief Выбор пакетной реализации через CPUID + XCR0
+ * 
+ * - AVX2: CPUID.7.0:EBX[5], XCR0[2:1] (xmm + ymm)
+ * - AVX-512F: CPUID.7.0:EBX[16], XCR0[7:5] (opmask + zmm)
+ */
+Sha256BatchImplementation detect_batch_implementation() noexcept {
+#if defined(__x86_64__) && (defined(QUAXIS_HAS_AVX2) || defined(QUAXIS_HAS_AVX512))
+    unsigned int eax, ebx, ecx, edx;
+    
+    // OSXSAVE: CPUID.1:ECX[27]
+    if (__get_cpuid(1, &eax, &ebx, &ecx, &edx) == 0 || (ecx & (1u << 27)) == 0) {
+        return Sha256BatchImplementation::Scalar;
+    }
+    if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) == 0) {
+        return Sha256BatchImplementation::Scalar;
+    }
+    
+    const uint64_t xcr0 = read_xcr0();
+    const bool os_ymm = (xcr0 & 0x06) == 0x06;
+    const bool os_zmm = os_ymm && (xcr0 & 0xE0) == 0xE0;
+    
+#ifdef QUAXIS_HAS_AVX512
+    if (os_zmm && (ebx & (1u << 16)) != 0) {
+        return Sha256BatchImplementation::Avx512;
+    }
+#endif
+#ifdef QUAXIS_HAS_AVX2
+    if (os_ymm && (ebx & (1u << 5)) != 0) {
+        return Sha256BatchImplementation::Avx2;
+    }
+#endif
+    (void)os_zmm;
+#endif
+    return Sha256BatchImplementation::Scalar;
+}
+
+// =============================================================================
+// Таблица диспетчеризации
+// =============================================================================
+
+using TransformFn = void (*)(Sha256State&, const uint8_t*) noexcept;
+using HeaderFn = Hash256 (*)(const Sha256State&, const uint8_t*) noexcept;
+using Sha256d64Fn = void (*)(Hash256*, const uint8_t*, std::size_t) noexcept;
+
+/**
+ * @brief SHA256d 64-байтных сообщений без аппаратного пакетного ядра
+ */
+void sha256d64_scalar(Hash256* out, const uint8_t* in, std::size_t count) noexcept {
+    for (std::size_t i = 0; i < count; ++i) {
+        out[i] = sha256d(ByteSpan(in + 64 * i, 64));
+    }
+}
+
+/**
+ * @brief Ядра выбранной реализации
+ */
+struct Sha256Dispatch {
+    Sha256Implementation implementation;
+    Sha256BatchImplementation batch;
+    TransformFn transform;
+    HeaderFn hash_header;
+    Sha256d64Fn sha256d64;
+};
+
+/**
+ * @brief Таблица ядер
+ * 
+ * До динамической инициализации этой единицы трансляции (хеширование
+ * из статических конструкторов других файлов) работает generic.
+ */
+constinit Sha256Dispatch g_dispatch{
+    Sha256Implementation::Generic,
+    Sha256BatchImplementation::Scalar,
+    &generic::sha256_transform,
+    &generic::hash_header_with_midstate,
+    &sha256d64_scalar,
+};
+
+/**
+ * @brief Заполнить таблицу ядрами реализации (поддержка уже проверена)
+ */
+void install(Sha256Implementation implementation) noexcept {
+    g_dispatch.implementation = implementation;
+    g_dispatch.transform = &generic::sha256_transform;
+    g_dispatch.hash_header = &generic::hash_header_with_midstate;
+    g_dispatch.sha256d64 = &sha256d64_scalar;
+    switch (implementation) {
+#ifdef QUAXIS_HAS_SHANI
+        case Sha256Implementation::ShaNi:
+            g_dispatch.transform = &shani::sha256_transform;
+            g_dispatch.hash_header = &shani::hash_header_with_midstate;
+            g_dispatch.sha256d64 = &shani::sha256d64;
+            break;
+#endif
+#ifdef QUAXIS_HAS_ARM_SHA2
+        case Sha256Implementation::ArmSha2:
+            g_dispatch.transform = &arm_sha2::sha256_transform;
+            g_dispatch.hash_header = &arm_sha2::hash_header_with_midstate;
+            break;
+#endif
+        default:
+            break;
+    }
+}
+
+bool implementation_supported(Sha256Implementation implementation) noexcept {
+    switch (implementation) {
+        case Sha256Implementation::ShaNi: return g_has_sha_ni;
+        case Sha256Implementation::ArmSha2: return g_has_arm_sha2;
+        case Sha256Implementation::Generic: break;
+    }
+    return true;
+}
+
+/**
+ * @brief Выбор по CPU при загрузке
+ */
+bool install_detected() noexcept {
+    install(g_has_sha_ni ? Sha256Implementation::ShaNi
+            : g_has_arm_sha2 ? Sha256Implementation::ArmSha2
+            : Sha256Implementation::Generic);
+    g_dispatch.batch = detect_batch_implementation();
+    return true;
+}
+
+[[maybe_unused]] const bool g_dispatch_installed = install_detected();
+
+std::string_view implementation_name(Sha256Implementation implementation) noexcept {
+    switch (implementation) {
+        case Sha256Implementation::ShaNi: return "sha-ni";
+        case Sha256Implementation::ArmSha2: return "arm-sha2";
+        case Sha256Implementation::Generic: break;
+    }
+    return "generic";
+}
+
+std::string_view batch_implementation_name(Sha256BatchImplementation implementation) noexcept {
+    switch (implementation) {
+        case Sha256BatchImplementation::Avx512: return "avx512";
+        case Sha256BatchImplementation::Avx2: return "avx2";
+        case Sha256BatchImplementation::Scalar: break;
+    }
+    return "scalar";
+}
+
 } // anonymous namespace
 
 // =============================================================================
@@ -79,12 +294,70 @@ bool has_sha_ni_support() noexcept {
     return g_has_sha_ni;
 }
 
+bool has_arm_sha2_support() noexcept {
+    return g_has_arm_sha2;
+}
+
 Sha256Implementation get_sha256_implementation() noexcept {
-    return g_has_sha_ni ? Sha256Implementation::ShaNi : Sha256Implementation::Generic;
+    return g_dispatch.implementation;
 }
 
 std::string_view get_implementation_name() noexcept {
-    return g_has_sha_ni ? "sha-ni" : "generic";
+    return implementation_name(g_dispatch.implementation);
+}
+
+Sha256BatchImplementation get_sha256_batch_implementation() noexcept {
+    return g_dispatch.batch;
+}
+
+std::size_t get_sha256_batch_lanes() noexcept {
+    switch (g_dispatch.batch) {
+        case Sha256BatchImplementation::Avx512: return 16;
+        case Sha256BatchImplementation::Avx2: return 8;
+        case Sha256BatchImplementation::Scalar: break;
+    }
+    return 1;
+}
+
+std::string_view get_batch_implementation_name() noexcept {
+    return batch_implementation_name(g_dispatch.batch);
+}
+
+std::optional<Sha256Implementation> parse_sha256_implementation(std::string_view name) noexcept {
+    for (auto implementation : {Sha256Implementation::Generic, Sha256Implementation::ShaNi,
+                                Sha256Implementation::ArmSha2}) {
+        if (name == implementation_name(implementation)) {
+            return implementation;
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<Sha256BatchImplementation> parse_sha256_batch_implementation(std::string_view name) noexcept {
+    for (auto implementation : {Sha256BatchImplementation::Scalar, Sha256BatchImplementation::Avx2,
+                                Sha256BatchImplementation::Avx512}) {
+        if (name == batch_implementation_name(implementation)) {
+            return implementation;
+        }
+    }
+    return std::nullopt;
+}
+
+bool set_sha256_implementation(Sha256Implementation implementation) noexcept {
+    if (!implementation_supported(implementation)) {
+        return false;
+    }
+    install(implementation);
+    return true;
+}
+
+bool set_sha256_batch_implementation(Sha256BatchImplementation implementation) noexcept {
+    // Пакет не шире обнаруженного: AVX-512 CPU умеет и AVX2, но не наоборот
+    if (static_cast<int>(implementation) > static_cast<int>(detect_batch_implementation())) {
+        return false;
+    }
+    g_dispatch.batch = implementation;
+    return true;
 }
 
 // =============================================================================
@@ -92,13 +365,7 @@ std::string_view get_implementation_name() noexcept {
 // =============================================================================
 
 void sha256_transform(Sha256State& state, const uint8_t* block) noexcept {
-#ifdef QUAXIS_HAS_SHANI
-    if (g_has_sha_ni) {
-        shani::sha256_transform(state, block);
-        return;
-    }
-#endif
-    generic::sha256_transform(state, block);
+    g_dispatch.transform(state, block);
 }
 
 // =============================================================================
@@ -142,16 +409,25 @@ Sha256State bytes_to_state(const Sha256Midstate& bytes) noexcept {
 // =============================================================================
 
 Hash256 sha256(ByteSpan data) noexcept {
-    // Начальное состояние
-    Sha256State state = constants::SHA256_INIT;
+    return sha256_resume(constants::SHA256_INIT, 0, data);
+}
+
+Hash256 sha256_resume(
+    const Sha256State& initial_state,
+    std::size_t prefix_len,
+    ByteSpan tail
+) noexcept {
+    // Состояние после уже обработанного префикса
+    Sha256State state = initial_state;
+    const TransformFn transform = g_dispatch.transform;
     
-    const auto len = data.size();
-    const uint8_t* ptr = data.data();
+    const auto len = tail.size();
+    const uint8_t* ptr = tail.data();
     
     // Обрабатываем полные 64-байтные блоки
     std::size_t blocks = len / 64;
     for (std::size_t i = 0; i < blocks; ++i) {
-        sha256_transform(state, ptr);
+        transform(state, ptr);
         ptr += 64;
     }
     
@@ -160,17 +436,19 @@ Hash256 sha256(ByteSpan data) noexcept {
     std::array<uint8_t, 128> buffer{}; // Максимум 2 блока для padding
     
     // Копируем остаток
-    std::memcpy(buffer.data(), ptr, remaining);
+    if (remaining > 0) {
+        std::memcpy(buffer.data(), ptr, remaining);
+    }
     
     // Добавляем 0x80 (1 бит + 7 нулевых битов)
     buffer[remaining] = 0x80;
     
-    // Длина сообщения в битах (big-endian)
-    uint64_t bit_len = static_cast<uint64_t>(len) * 8;
+    // Длина всего сообщения в битах (big-endian), включая префикс
+    uint64_t bit_len = static_cast<uint64_t>(prefix_len + len) * 8;
     
     if (remaining >= 56) {
         // Нужен дополнительный блок
-        sha256_transform(state, buffer.data());
+        transform(state, buffer.data());
         std::memset(buffer.data(), 0, 64);
         write_be32(buffer.data() + 60, static_cast<uint32_t>(bit_len));
         write_be32(buffer.data() + 56, static_cast<uint32_t>(bit_len >> 32));
@@ -180,7 +458,7 @@ Hash256 sha256(ByteSpan data) noexcept {
         write_be32(buffer.data() + 56, static_cast<uint32_t>(bit_len >> 32));
     }
     
-    sha256_transform(state, buffer.data());
+    transform(state, buffer.data());
     
     // Конвертируем состояние в хеш (big-endian)
     Hash256 result;
@@ -191,6 +469,15 @@ Hash256 sha256(ByteSpan data) noexcept {
     return result;
 }
 
+Hash256 sha256d_resume(
+    const Sha256State& state,
+    std::size_t prefix_len,
+    ByteSpan tail
+) noexcept {
+    Hash256 first = sha256_resume(state, prefix_len, tail);
+    return sha256(ByteSpan(first.data(), first.size()));
+}
+
 Hash256 sha256d(ByteSpan data) noexcept {
     // Первый SHA256
     Hash256 first = sha256(data);
@@ -207,32 +494,93 @@ Hash256 hash_header_with_midstate(
     const Sha256State& midstate,
     std::span<const uint8_t, 16> header_tail
 ) noexcept {
-    // Состояние начинается с midstate
-    Sha256State state = midstate;
-    
-    // Создаём второй 64-байтный блок:
-    // [0-15]  : последние 16 байт заголовка
-    // [16]    : 0x80 (padding)
-    // [17-55] : нули
-    // [56-63] : длина = 80 * 8 = 640 бит = 0x0000000000000280 (big-endian)
-    std::array<uint8_t, 64> block{};
-    std::memcpy(block.data(), header_tail.data(), 16);
-    block[16] = 0x80;
-    // Длина 80 байт = 640 бит = 0x280
-    block[62] = 0x02;
-    block[63] = 0x80;
-    
-    // Первый transform (завершение первого SHA256)
-    sha256_transform(state, block.data());
-    
-    // Конвертируем в hash (big-endian)
-    Hash256 first_hash;
-    for (std::size_t i = 0; i < 8; ++i) {
-        write_be32(first_hash.data() + i * 4, state[i]);
+    // Оба transform специализированы под padding заголовка и хеша
+    return g_dispatch.hash_header(midstate, header_tail.data());
+}
+
+Hash256 hash_header_with_midstate(
+    const Sha256State& midstate,
+    std::span<const uint8_t, 16> header_tail,
+    Sha256Implementation implementation
+) noexcept {
+#ifdef QUAXIS_HAS_SHANI
+    if (implementation == Sha256Implementation::ShaNi && g_has_sha_ni) {
+        return shani::hash_header_with_midstate(midstate, header_tail.data());
     }
+#endif
+#ifdef QUAXIS_HAS_ARM_SHA2
+    if (implementation == Sha256Implementation::ArmSha2 && g_has_arm_sha2) {
+        return arm_sha2::hash_header_with_midstate(midstate, header_tail.data());
+    }
+#endif
+    (void)implementation;
+    return generic::hash_header_with_midstate(midstate, header_tail.data());
+}
+
+std::size_t hash_headers_with_midstate_batch(
+    std::span<const Sha256State> midstates,
+    std::span<const HeaderTail> tails,
+    std::span<Hash256> out
+) noexcept {
+    const std::size_t count = std::min({midstates.size(), tails.size(), out.size()});
+    std::size_t i = 0;
     
-    // Второй SHA256 (double hash)
-    return sha256(ByteSpan(first_hash.data(), 32));
+#ifdef QUAXIS_HAS_AVX512
+    if (g_dispatch.batch == Sha256BatchImplementation::Avx512) {
+        for (; i + 16 <= count; i += 16) {
+            avx512::hash_headers_x16(midstates.data() + i, tails.data() + i, out.data() + i);
+        }
+    }
+#endif
+#ifdef QUAXIS_HAS_AVX2
+    // AVX2 также используется для остатка после AVX-512 (8..15 заголовков)
+    if (g_dispatch.batch != Sha256BatchImplementation::Scalar) {
+        for (; i + 8 <= count; i += 8) {
+            avx2::hash_headers_x8(midstates.data() + i, tails.data() + i, out.data() + i);
+        }
+    }
+#endif
+    
+    // Скалярный остаток
+    for (; i < count; ++i) {
+        out[i] = hash_header_with_midstate(midstates[i], tails[i]);
+    }
+    
+    return count;
+}
+
+void sha256_transform_batch(
+    std::span<Sha256State> states,
+    const uint8_t* blocks,
+    std::size_t stride
+) noexcept {
+    const std::size_t count = states.size();
+    std::size_t i = 0;
+    
+#ifdef QUAXIS_HAS_AVX512
+    if (g_dispatch.batch == Sha256BatchImplementation::Avx512) {
+        for (; i + 16 <= count; i += 16) {
+            avx512::sha256_transform_x16(states.data() + i, blocks + i * stride, stride);
+        }
+    }
+#endif
+#ifdef QUAXIS_HAS_AVX2
+    if (g_dispatch.batch != Sha256BatchImplementation::Scalar) {
+        for (; i + 8 <= count; i += 8) {
+            avx2::sha256_transform_x8(states.data() + i, blocks + i * stride, stride);
+        }
+    }
+#endif
+    
+    for (; i < count; ++i) {
+        sha256_transform(states[i], blocks + i * stride);
+    }
+}
+
+std::size_t sha256d64_batch(ByteSpan in, std::span<Hash256> out) noexcept {
+    const std::size_t count = std::min(in.size() / 64, out.size());
+    g_dispatch.sha256d64(out.data(), in.data(), count);
+    return count;
 }
 
 bool check_hash_target(const Hash256& hash, const Hash256& target) noexcept {
@@ -21,7 +21,9 @@
 #include "../core/constants.hpp"
 
 #include <array>
+#include <optional>
 #include <span>
+#include <string_view>
 #include <cstdint>
 
 namespace quaxis::crypto {
@@ -45,6 +47,14 @@ using Sha256State = std::array<uint32_t, 8>;
  */
 using Sha256Midstate = std::array<uint8_t, constants::SHA256_MIDSTATE_SIZE>;
 
+/**
+ * @brief Хвост заголовка блока (последние 16 байт)
+ * 
+ * merkle[28:32] + time + bits + nonce — вторая половина заголовка,
+ * которая хешируется поверх midstate.
+ */
+using HeaderTail = std::array<uint8_t, 16>;
+
 // =============================================================================
 // Основные функции SHA256
 // =============================================================================
@@ -109,6 +119,41 @@ void sha256_transform(Sha256State& state, const uint8_t* block) noexcept;
  */
 [[nodiscard]] Sha256State compute_midstate(const uint8_t* data) noexcept;
 
+/**
+ * @brief Продолжить SHA256 с известного промежуточного состояния
+ * 
+ * Досчитывает хеш сообщения, первые prefix_len байт которого уже
+ * обработаны и дали состояние state. Обрабатывает только tail и padding.
+ * 
+ * @param state Состояние после обработки первых prefix_len байт
+ * @param prefix_len Длина уже обработанного префикса (кратна 64)
+ * @param tail Оставшиеся байты сообщения
+ * @return Hash256 SHA256 всего сообщения (prefix + tail)
+ */
+[[nodiscard]] Hash256 sha256_resume(
+    const Sha256State& state,
+    std::size_t prefix_len,
+    ByteSpan tail
+) noexcept;
+
+/**
+ * @brief Продолжить SHA256d с известного промежуточного состояния
+ * 
+ * SHA256(sha256_resume(state, prefix_len, tail)).
+ * Используется для пересчёта coinbase txid после смены extranonce:
+ * первые 64 байта coinbase неизменны и уже свёрнуты в coinbase_midstate.
+ * 
+ * @param state Состояние после обработки первых prefix_len байт
+ * @param prefix_len Длина уже обработанного префикса (кратна 64)
+ * @param tail Оставшиеся байты сообщения
+ * @return Hash256 SHA256d всего сообщения
+ */
+[[nodiscard]] Hash256 sha256d_resume(
+    const Sha256State& state,
+    std::size_t prefix_len,
+    ByteSpan tail
+) noexcept;
+
 /**
  * @brief Преобразовать Sha256State в байтовый массив (Midstate)
  * 
@@ -142,6 +187,9 @@ void sha256_transform(Sha256State& state, const uint8_t* block) noexcept;
  * 3. Выполняет один SHA256 transform
  * 4. Выполняет второй SHA256 (для double hash)
  * 
+ * Оба transform специализированы: слова padding известны при компиляции,
+ * их загрузка и расширение расписания пропускаются.
+ * 
  * @param midstate Состояние после первых 64 байт заголовка
  * @param header_tail Последние 16 байт заголовка (merkle[28:32] + time + bits + nonce)
  * @return Hash256 Block hash (double SHA256)
@@ -153,6 +201,65 @@ void sha256_transform(Sha256State& state, const uint8_t* block) noexcept;
     std::span<const uint8_t, 16> header_tail
 ) noexcept;
 
+/**
+ * @brief Пакетное хеширование заголовков с использованием midstate
+ * 
+ * Многоканальный (multi-buffer) вариант hash_header_with_midstate:
+ * несколько независимых заголовков обрабатываются одновременно,
+ * по одному в каждой SIMD-линии (8 линий AVX2, 16 линий AVX-512).
+ * Остаток, не кратный ширине вектора, досчитывается скалярно.
+ * 
+ * Результат для каждого i идентичен
+ * hash_header_with_midstate(midstates[i], tails[i]).
+ * 
+ * @param midstates Состояния после первых 64 байт каждого заголовка
+ * @param tails Последние 16 байт каждого заголовка
+ * @param out Выходные хеши (double SHA256)
+ * @return Количество вычисленных хешей (минимум из размеров входов)
+ * 
+ * @note Используется при пачках шар от множества ASIC после смены задания
+ */
+std::size_t hash_headers_with_midstate_batch(
+    std::span<const Sha256State> midstates,
+    std::span<const HeaderTail> tails,
+    std::span<Hash256> out
+) noexcept;
+
+/**
+ * @brief Одно сжатие SHA256 для каждого из независимых состояний
+ * 
+ * Многоканальный вариант sha256_transform: states[i] сжимается с блоком
+ * blocks + i * stride (по одному состоянию в SIMD-линии, остаток -
+ * скалярно). Для пакетов сообщений одинаковой длины: coinbase и
+ * заголовки заданий всех соединений на новом блоке.
+ * 
+ * @param states Состояния (будут обновлены)
+ * @param blocks Блок для states[0] (64 байта)
+ * @param stride Расстояние между блоками соседних состояний (байт)
+ */
+void sha256_transform_batch(
+    std::span<Sha256State> states,
+    const uint8_t* blocks,
+    std::size_t stride
+) noexcept;
+
+/**
+ * @brief SHA256d независимых 64-байтных сообщений
+ * 
+ * Для узлов Merkle дерева (left || right): уровень дерева - это много
+ * независимых пар. С SHA-NI сообщения обрабатываются по 4 (остаток
+ * по 2 и по 1) с чередованием инструкций, и латентность sha256rnds2
+ * одного сообщения перекрывается раундами остальных. Блок padding
+ * 64-байтного сообщения постоянен и не требует расписания.
+ * 
+ * Результат для каждого i идентичен sha256d(in.subspan(64 * i, 64)).
+ * 
+ * @param in Сообщения подряд, по 64 байта
+ * @param out Выходные хеши
+ * @return Количество вычисленных хешей (min(in.size() / 64, out.size()))
+ */
+std::size_t sha256d64_batch(ByteSpan in, std::span<Hash256> out) noexcept;
+
 /**
  * @brief Проверить, меньше ли хеш заданного target
  * 
@@ -176,7 +283,8 @@ void sha256_transform(Sha256State& state, const uint8_t* block) noexcept;
  */
 enum class Sha256Implementation {
     Generic,    ///< Программная реализация
-    ShaNi       ///< Аппаратная реализация (Intel SHA-NI)
+    ShaNi,      ///< Аппаратная реализация (Intel SHA-NI)
+    ArmSha2     ///< Аппаратная реализация (ARMv8 Crypto Extensions)
 };
 
 /**
@@ -193,11 +301,100 @@ enum class Sha256Implementation {
  */
 [[nodiscard]] bool has_sha_ni_support() noexcept;
 
+/**
+ * @brief Проверить поддержку SHA2 инструкций ARMv8 на текущем CPU
+ * 
+ * @return true если aarch64 CPU поддерживает SHA2 (HWCAP_SHA2)
+ */
+[[nodiscard]] bool has_arm_sha2_support() noexcept;
+
 /**
  * @brief Получить строковое название реализации
  * 
- * @return std::string_view Название ("generic" или "sha-ni")
+ * @return std::string_view Название ("generic", "sha-ni" или "arm-sha2")
  */
 [[nodiscard]] std::string_view get_implementation_name() noexcept;
 
+/**
+ * @brief hash_header_with_midstate() выбранной реализацией
+ * 
+ * Для тестов и бенчмарков: ShaNi / ArmSha2 без поддержки CPU
+ * (или сборки) выполняются generic реализацией.
+ * 
+ * @param midstate Состояние после первых 64 байт заголовка
+ * @param header_tail Последние 16 байт заголовка
+ * @param implementation Реализация
+ * @return Hash256 Block hash (double SHA256)
+ */
+[[nodiscard]] Hash256 hash_header_with_midstate(
+    const Sha256State& midstate,
+    std::span<const uint8_t, 16> header_tail,
+    Sha256Implementation implementation
+) noexcept;
+
+/**
+ * @brief Перечисление реализаций пакетного (multi-buffer) SHA256
+ */
+enum class Sha256BatchImplementation {
+    Scalar,     ///< Последовательный вызов sha256_transform
+    Avx2,       ///< 8 линий AVX2
+    Avx512      ///< 16 линий AVX-512F
+};
+
+/**
+ * @brief Получить реализацию пакетного хеширования
+ * 
+ * Выбирается один раз при старте по CPUID (как и get_sha256_implementation).
+ */
+[[nodiscard]] Sha256BatchImplementation get_sha256_batch_implementation() noexcept;
+
+/**
+ * @brief Количество линий пакетной реализации (1, 8 или 16)
+ */
+[[nodiscard]] std::size_t get_sha256_batch_lanes() noexcept;
+
+/**
+ * @brief Получить строковое название пакетной реализации
+ * 
+ * @return std::string_view Название ("scalar", "avx2" или "avx512")
+ */
+[[nodiscard]] std::string_view get_batch_implementation_name() noexcept;
+
+// =============================================================================
+// Принудительный выбор (бенчмарки, --sha256-impl)
+// =============================================================================
+
+/**
+ * @brief Реализация по названию get_implementation_name()
+ * 
+ * @return std::nullopt - неизвестное название
+ */
+[[nodiscard]] std::optional<Sha256Implementation> parse_sha256_implementation(std::string_view name) noexcept;
+
+/**
+ * @brief Пакетная реализация по названию get_batch_implementation_name()
+ * 
+ * @return std::nullopt - неизвестное название
+ */
+[[nodiscard]] std::optional<Sha256BatchImplementation> parse_sha256_batch_implementation(std::string_view name) noexcept;
+
+/**
+ * @brief Заменить реализацию, выбранную при загрузке
+ * 
+ * Таблица ядер переписывается без синхронизации: вызывать до запуска
+ * потоков, которые хешируют.
+ * 
+ * @return false - реализация недоступна на CPU или в сборке (выбор не меняется)
+ */
+bool set_sha256_implementation(Sha256Implementation implementation) noexcept;
+
+/**
+ * @brief Заменить пакетную реализацию (не шире обнаруженной при загрузке)
+ * 
+ * Те же ограничения, что у set_sha256_implementation().
+ * 
+ * @return false - реализация недоступна (выбор не меняется)
+ */
+bool set_sha256_batch_implementation(Sha256BatchImplementation implementation) noexcept;
+
 } // namespace quaxis::crypto
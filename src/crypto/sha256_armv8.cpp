@@ -0,0 +1,179 @@
+/**
+ * @file sha256_armv8.cpp
+ * @brief SHA256 реализация на ARMv8 Crypto Extensions
+ *
+ * Использует аппаратные SHA256 инструкции aarch64, доступные на:
+ * - AWS Graviton, Ampere Altra / One
+ * - Cortex-A53/A55/A72 и новее (Raspberry Pi 4/5 и другие платы
+ *   контроллеров) - если производитель не отключил Crypto Extensions
+ *
+ * Основные intrinsics:
+ * - vsha256hq_u32 / vsha256h2q_u32: четыре раунда SHA256 (ABCD и EFGH)
+ * - vsha256su0q_u32 / vsha256su1q_u32: расширение расписания сообщения
+ *
+ * В отличие от SHA-NI состояние хранится в естественном порядке
+ * (ABCD / EFGH), перестановки регистров не нужны.
+ *
+ * @note Этот файл компилируется с флагом -march=armv8-a+crypto
+ */
+
+#include "sha256.hpp"
+#include "sha256_precomputed.hpp"
+#include "../core/constants.hpp"
+
+#ifdef QUAXIS_HAS_ARM_SHA2
+
+#include <arm_neon.h>
+
+namespace quaxis::crypto::arm_sha2 {
+
+namespace {
+
+// =============================================================================
+// Общие части transform
+// =============================================================================
+
+/**
+ * @brief Четыре раунда с готовыми K + W
+ */
+inline void rounds4(uint32x4_t& abcd, uint32x4_t& efgh, uint32x4_t kw) noexcept {
+    const uint32x4_t abcd_in = abcd;
+    abcd = vsha256hq_u32(abcd, efgh, kw);
+    efgh = vsha256h2q_u32(efgh, abcd_in, kw);
+}
+
+/**
+ * @brief W[i+16..i+19] по W[i..i+15]
+ */
+inline uint32x4_t schedule(uint32x4_t w0, uint32x4_t w1, uint32x4_t w2, uint32x4_t w3) noexcept {
+    return vsha256su1q_u32(vsha256su0q_u32(w0, w1), w2, w3);
+}
+
+/**
+ * @brief Группы раундов first_group..15 (по 4 раунда)
+ *
+ * w[g % 4] на входе группы g содержит W[4g..4g+3]; после группы
+ * на его место рассчитываются W[4g+16..4g+19].
+ */
+inline void rounds_from(uint32x4_t& abcd, uint32x4_t& efgh, uint32x4_t w[4], int first_group) noexcept {
+    for (int g = first_group; g < 16; ++g) {
+        rounds4(abcd, efgh, vaddq_u32(w[g % 4], vld1q_u32(constants::SHA256_K.data() + 4 * g)));
+        if (g < 12) {
+            w[g % 4] = schedule(w[g % 4], w[(g + 1) % 4], w[(g + 2) % 4], w[(g + 3) % 4]);
+        }
+    }
+}
+
+/// @brief 16 байт big-endian слов
+inline uint32x4_t load_be(const uint8_t* data) noexcept {
+    return vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data)));
+}
+
+/// @brief Вектор {w0, w1, w2, w3}
+inline uint32x4_t make_words(uint32_t w0, uint32_t w1, uint32_t w2, uint32_t w3) noexcept {
+    const uint32_t words[4] = {w0, w1, w2, w3};
+    return vld1q_u32(words);
+}
+
+} // anonymous namespace
+
+// =============================================================================
+// SHA256 Transform с ARMv8 Crypto Extensions
+// =============================================================================
+
+/**
+ * @brief Функция сжатия SHA256 на инструкциях SHA2 aarch64
+ *
+ * @param state Состояние хеша (8 x 32-bit слов)
+ * @param block Указатель на 64 байта данных
+ */
+void sha256_transform(Sha256State& state, const uint8_t* block) noexcept {
+    uint32x4_t abcd = vld1q_u32(state.data());
+    uint32x4_t efgh = vld1q_u32(state.data() + 4);
+    const uint32x4_t abcd_save = abcd;
+    const uint32x4_t efgh_save = efgh;
+
+    uint32x4_t w[4] = {
+        load_be(block),
+        load_be(block + 16),
+        load_be(block + 32),
+        load_be(block + 48)
+    };
+    rounds_from(abcd, efgh, w, 0);
+
+    vst1q_u32(state.data(), vaddq_u32(abcd, abcd_save));
+    vst1q_u32(state.data() + 4, vaddq_u32(efgh, efgh_save));
+}
+
+// =============================================================================
+// SHA256d заголовка с midstate
+// =============================================================================
+
+/**
+ * @brief SHA256d заголовка по midstate и 16-байтному хвосту
+ *
+ * Как и SHA-NI вариант: слова padding не загружаются, раунды с
+ * постоянными словами берут K + W из precomputed, vsha256su0 над
+ * нулевыми словами пропущены, первый хеш идёт во второй SHA256
+ * прямо из регистров.
+ *
+ * @param midstate Состояние после первых 64 байт заголовка
+ * @param tail Последние 16 байт заголовка
+ * @return Hash256 SHA256d заголовка
+ */
+Hash256 hash_header_with_midstate(const Sha256State& midstate, const uint8_t* tail) noexcept {
+    using namespace precomputed;
+
+    // === Второй блок заголовка: W0..W3 - хвост, W4 = PAD, W15 = 640 ===
+    const uint32x4_t abcd_save = vld1q_u32(midstate.data());
+    const uint32x4_t efgh_save = vld1q_u32(midstate.data() + 4);
+    uint32x4_t abcd = abcd_save;
+    uint32x4_t efgh = efgh_save;
+
+    uint32x4_t w[4] = {
+        load_be(tail),
+        make_words(PAD_WORD, 0, 0, 0),
+        vdupq_n_u32(0),
+        make_words(0, 0, 0, HEADER_BITS)
+    };
+
+    rounds4(abcd, efgh, vaddq_u32(w[0], vld1q_u32(constants::SHA256_K.data())));
+    w[0] = schedule(w[0], w[1], w[2], w[3]);
+    rounds4(abcd, efgh, vld1q_u32(HEADER_KW.data() + 4));
+    w[1] = vsha256su1q_u32(w[1], w[3], w[0]);  // su0(W4..W7, W8..W11) = W4..W7
+    rounds4(abcd, efgh, vld1q_u32(HEADER_KW.data() + 8));
+    w[2] = vsha256su1q_u32(w[2], w[0], w[1]);  // su0(W8..W11, W12..W15) = 0
+    rounds4(abcd, efgh, vld1q_u32(HEADER_KW.data() + 12));
+    w[3] = schedule(w[3], w[0], w[1], w[2]);
+    rounds_from(abcd, efgh, w, 4);
+
+    // === Второй SHA256: W0..W7 - первый хеш, W8 = PAD, W15 = 256 ===
+    const uint32x4_t init_abcd = vld1q_u32(constants::SHA256_INIT.data());
+    const uint32x4_t init_efgh = vld1q_u32(constants::SHA256_INIT.data() + 4);
+    w[0] = vaddq_u32(abcd, abcd_save);
+    w[1] = vaddq_u32(efgh, efgh_save);
+    w[2] = make_words(PAD_WORD, 0, 0, 0);
+    w[3] = make_words(0, 0, 0, HASH_BITS);
+    abcd = init_abcd;
+    efgh = init_efgh;
+
+    rounds4(abcd, efgh, vaddq_u32(w[0], vld1q_u32(constants::SHA256_K.data())));
+    w[0] = schedule(w[0], w[1], w[2], w[3]);
+    rounds4(abcd, efgh, vaddq_u32(w[1], vld1q_u32(constants::SHA256_K.data() + 4)));
+    w[1] = schedule(w[1], w[2], w[3], w[0]);
+    rounds4(abcd, efgh, vld1q_u32(HASH_KW.data() + 8));
+    w[2] = vsha256su1q_u32(w[2], w[0], w[1]);  // su0(W8..W11, W12..W15) = W8..W11
+    rounds4(abcd, efgh, vld1q_u32(HASH_KW.data() + 12));
+    w[3] = schedule(w[3], w[0], w[1], w[2]);
+    rounds_from(abcd, efgh, w, 4);
+
+    // Слова состояния -> хеш (big-endian)
+    Hash256 result;
+    vst1q_u8(result.data(), vrev32q_u8(vreinterpretq_u8_u32(vaddq_u32(abcd, init_abcd))));
+    vst1q_u8(result.data() + 16, vrev32q_u8(vreinterpretq_u8_u32(vaddq_u32(efgh, init_efgh))));
+    return result;
+}
+
+} // namespace quaxis::crypto::arm_sha2
+
+#endif // QUAXIS_HAS_ARM_SHA2
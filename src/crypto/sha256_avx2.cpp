@@ -0,0 +1,224 @@
+/**
+ * @file sha256_avx2.cpp
+ * @brief Многоканальная (8 линий) реализация SHA256 на AVX2
+ *
+ * Каждая 32-битная линия регистра __m256i обрабатывает свой независимый
+ * заголовок блока. Используется для пакетной проверки шар, когда
+ * одновременно приходят ответы от множества ASIC.
+ *
+ * Раскладка данных: word-sliced (SoA) — регистр s[j] содержит j-е слово
+ * состояния для всех 8 заголовков.
+ *
+ * @note Этот файл компилируется с флагом -mavx2
+ */
+
+#include "sha256.hpp"
+#include "../core/byte_order.hpp"
+#include "../core/constants.hpp"
+
+#ifdef QUAXIS_HAS_AVX2
+
+#include <immintrin.h>
+
+namespace quaxis::crypto::avx2 {
+
+namespace {
+
+/// @brief Количество линий
+constexpr std::size_t LANES = 8;
+
+// =============================================================================
+// Векторные примитивы SHA256
+// =============================================================================
+
+template<int N>
+inline __m256i rotr(__m256i x) noexcept {
+    return _mm256_or_si256(_mm256_srli_epi32(x, N), _mm256_slli_epi32(x, 32 - N));
+}
+
+inline __m256i broadcast(uint32_t value) noexcept {
+    return _mm256_set1_epi32(static_cast<int>(value));
+}
+
+inline __m256i add(__m256i a, __m256i b) noexcept {
+    return _mm256_add_epi32(a, b);
+}
+
+inline __m256i ch(__m256i x, __m256i y, __m256i z) noexcept {
+    return _mm256_xor_si256(_mm256_and_si256(x, y), _mm256_andnot_si256(x, z));
+}
+
+inline __m256i maj(__m256i x, __m256i y, __m256i z) noexcept {
+    return _mm256_or_si256(_mm256_and_si256(x, y), _mm256_and_si256(z, _mm256_or_si256(x, y)));
+}
+
+inline __m256i big_sigma0(__m256i x) noexcept {
+    return _mm256_xor_si256(_mm256_xor_si256(rotr<2>(x), rotr<13>(x)), rotr<22>(x));
+}
+
+inline __m256i big_sigma1(__m256i x) noexcept {
+    return _mm256_xor_si256(_mm256_xor_si256(rotr<6>(x), rotr<11>(x)), rotr<25>(x));
+}
+
+inline __m256i small_sigma0(__m256i x) noexcept {
+    return _mm256_xor_si256(_mm256_xor_si256(rotr<7>(x), rotr<18>(x)), _mm256_srli_epi32(x, 3));
+}
+
+inline __m256i small_sigma1(__m256i x) noexcept {
+    return _mm256_xor_si256(_mm256_xor_si256(rotr<17>(x), rotr<19>(x)), _mm256_srli_epi32(x, 10));
+}
+
+/**
+ * @brief Функция сжатия SHA256 для 8 блоков одновременно
+ *
+ * @param s Состояние (8 слов x 8 линий), будет обновлено
+ * @param w Первые 16 слов расписания сообщения для каждой линии
+ */
+void transform_x8(__m256i s[8], const __m256i w_in[16]) noexcept {
+    __m256i w[64];
+    for (std::size_t i = 0; i < 16; ++i) {
+        w[i] = w_in[i];
+    }
+    for (std::size_t i = 16; i < 64; ++i) {
+        w[i] = add(add(small_sigma1(w[i - 2]), w[i - 7]), add(small_sigma0(w[i - 15]), w[i - 16]));
+    }
+
+    __m256i a = s[0], b = s[1], c = s[2], d = s[3];
+    __m256i e = s[4], f = s[5], g = s[6], h = s[7];
+
+    for (std::size_t i = 0; i < 64; ++i) {
+        __m256i t1 = add(add(add(h, big_sigma1(e)), add(ch(e, f, g), broadcast(constants::SHA256_K[i]))), w[i]);
+        __m256i t2 = add(big_sigma0(a), maj(a, b, c));
+        h = g;
+        g = f;
+        f = e;
+        e = add(d, t1);
+        d = c;
+        c = b;
+        b = a;
+        a = add(t1, t2);
+    }
+
+    s[0] = add(s[0], a);
+    s[1] = add(s[1], b);
+    s[2] = add(s[2], c);
+    s[3] = add(s[3], d);
+    s[4] = add(s[4], e);
+    s[5] = add(s[5], f);
+    s[6] = add(s[6], g);
+    s[7] = add(s[7], h);
+}
+
+} // anonymous namespace
+
+// =============================================================================
+// Пакетное хеширование заголовков
+// =============================================================================
+
+/**
+ * @brief Хешировать 8 заголовков (SHA256d) по их midstate и хвостам
+ *
+ * @param midstates Указатель на 8 midstate
+ * @param tails Указатель на 8 хвостов заголовков (16 байт)
+ * @param out Указатель на 8 выходных хешей
+ */
+void hash_headers_x8(
+    const Sha256State* midstates,
+    const HeaderTail* tails,
+    Hash256* out
+) noexcept {
+    alignas(32) uint32_t lane[LANES];
+    __m256i s[8];
+    __m256i w[16];
+
+    // === Загрузка midstate (транспонирование AoS -> SoA) ===
+    for (std::size_t j = 0; j < 8; ++j) {
+        for (std::size_t i = 0; i < LANES; ++i) {
+            lane[i] = midstates[i][j];
+        }
+        s[j] = _mm256_load_si256(reinterpret_cast<const __m256i*>(lane));
+    }
+
+    // === Второй блок первого SHA256: хвост заголовка + padding ===
+    for (std::size_t j = 0; j < 4; ++j) {
+        for (std::size_t i = 0; i < LANES; ++i) {
+            lane[i] = read_be32(tails[i].data() + j * 4);
+        }
+        w[j] = _mm256_load_si256(reinterpret_cast<const __m256i*>(lane));
+    }
+    w[4] = broadcast(0x80000000);
+    for (std::size_t j = 5; j < 15; ++j) {
+        w[j] = _mm256_setzero_si256();
+    }
+    w[15] = broadcast(80 * 8);  // Длина 80 байт = 640 бит
+
+    transform_x8(s, w);
+
+    // === Второй SHA256 над 32-байтным хешем ===
+    // Слова первого хеша в big-endian совпадают со словами состояния
+    for (std::size_t j = 0; j < 8; ++j) {
+        w[j] = s[j];
+    }
+    w[8] = broadcast(0x80000000);
+    for (std::size_t j = 9; j < 15; ++j) {
+        w[j] = _mm256_setzero_si256();
+    }
+    w[15] = broadcast(32 * 8);  // Длина 32 байта = 256 бит
+
+    for (std::size_t j = 0; j < 8; ++j) {
+        s[j] = broadcast(constants::SHA256_INIT[j]);
+    }
+
+    transform_x8(s, w);
+
+    // === Выгрузка результата (SoA -> AoS, big-endian) ===
+    for (std::size_t j = 0; j < 8; ++j) {
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lane), s[j]);
+        for (std::size_t i = 0; i < LANES; ++i) {
+            write_be32(out[i].data() + j * 4, lane[i]);
+        }
+    }
+}
+
+/**
+ * @brief Одно сжатие SHA256 для 8 независимых состояний
+ *
+ * @param states Указатель на 8 состояний (будут обновлены)
+ * @param blocks Блок первого состояния (64 байта)
+ * @param stride Расстояние между блоками соседних состояний
+ */
+void sha256_transform_x8(
+    Sha256State* states,
+    const uint8_t* blocks,
+    std::size_t stride
+) noexcept {
+    alignas(32) uint32_t lane[LANES];
+    __m256i s[8];
+    __m256i w[16];
+
+    for (std::size_t j = 0; j < 8; ++j) {
+        for (std::size_t i = 0; i < LANES; ++i) {
+            lane[i] = states[i][j];
+        }
+        s[j] = _mm256_load_si256(reinterpret_cast<const __m256i*>(lane));
+    }
+    for (std::size_t j = 0; j < 16; ++j) {
+        for (std::size_t i = 0; i < LANES; ++i) {
+            lane[i] = read_be32(blocks + i * stride + j * 4);
+        }
+        w[j] = _mm256_load_si256(reinterpret_cast<const __m256i*>(lane));
+    }
+
+    transform_x8(s, w);
+
+    for (std::size_t j = 0; j < 8; ++j) {
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lane), s[j]);
+        for (std::size_t i = 0; i < LANES; ++i) {
+            states[i][j] = lane[i];
+        }
+    }
+}
+
+} // namespace quaxis::crypto::avx2
+
+#endif // QUAXIS_HAS_AVX2
@@ -0,0 +1,222 @@
+/**
+ * @file sha256_avx512.cpp
+ * @brief Многоканальная (16 линий) реализация SHA256 на AVX-512F
+ *
+ * То же, что sha256_avx2.cpp, но в регистрах __m512i. AVX-512F даёт
+ * аппаратный rotate (vprord) и тернарную логику (vpternlogd), поэтому
+ * функции CH и MAJ выполняются одной инструкцией.
+ *
+ * @note Этот файл компилируется с флагом -mavx512f
+ */
+
+#include "sha256.hpp"
+#include "../core/byte_order.hpp"
+#include "../core/constants.hpp"
+
+#ifdef QUAXIS_HAS_AVX512
+
+#include <immintrin.h>
+
+namespace quaxis::crypto::avx512 {
+
+namespace {
+
+/// @brief Количество линий
+constexpr std::size_t LANES = 16;
+
+// =============================================================================
+// Векторные примитивы SHA256
+// =============================================================================
+
+inline __m512i broadcast(uint32_t value) noexcept {
+    return _mm512_set1_epi32(static_cast<int>(value));
+}
+
+inline __m512i add(__m512i a, __m512i b) noexcept {
+    return _mm512_add_epi32(a, b);
+}
+
+/// @brief CH(x, y, z) = (x & y) ^ (~x & z), таблица истинности 0xCA
+inline __m512i ch(__m512i x, __m512i y, __m512i z) noexcept {
+    return _mm512_ternarylogic_epi32(x, y, z, 0xCA);
+}
+
+/// @brief MAJ(x, y, z) = (x & y) ^ (x & z) ^ (y & z), таблица истинности 0xE8
+inline __m512i maj(__m512i x, __m512i y, __m512i z) noexcept {
+    return _mm512_ternarylogic_epi32(x, y, z, 0xE8);
+}
+
+/// @brief XOR трёх значений, таблица истинности 0x96
+inline __m512i xor3(__m512i x, __m512i y, __m512i z) noexcept {
+    return _mm512_ternarylogic_epi32(x, y, z, 0x96);
+}
+
+inline __m512i big_sigma0(__m512i x) noexcept {
+    return xor3(_mm512_ror_epi32(x, 2), _mm512_ror_epi32(x, 13), _mm512_ror_epi32(x, 22));
+}
+
+inline __m512i big_sigma1(__m512i x) noexcept {
+    return xor3(_mm512_ror_epi32(x, 6), _mm512_ror_epi32(x, 11), _mm512_ror_epi32(x, 25));
+}
+
+inline __m512i small_sigma0(__m512i x) noexcept {
+    return xor3(_mm512_ror_epi32(x, 7), _mm512_ror_epi32(x, 18), _mm512_srli_epi32(x, 3));
+}
+
+inline __m512i small_sigma1(__m512i x) noexcept {
+    return xor3(_mm512_ror_epi32(x, 17), _mm512_ror_epi32(x, 19), _mm512_srli_epi32(x, 10));
+}
+
+/**
+ * @brief Функция сжатия SHA256 для 16 блоков одновременно
+ *
+ * @param s Состояние (8 слов x 16 линий), будет обновлено
+ * @param w Первые 16 слов расписания сообщения для каждой линии
+ */
+void transform_x16(__m512i s[8], const __m512i w_in[16]) noexcept {
+    __m512i w[64];
+    for (std::size_t i = 0; i < 16; ++i) {
+        w[i] = w_in[i];
+    }
+    for (std::size_t i = 16; i < 64; ++i) {
+        w[i] = add(add(small_sigma1(w[i - 2]), w[i - 7]), add(small_sigma0(w[i - 15]), w[i - 16]));
+    }
+
+    __m512i a = s[0], b = s[1], c = s[2], d = s[3];
+    __m512i e = s[4], f = s[5], g = s[6], h = s[7];
+
+    for (std::size_t i = 0; i < 64; ++i) {
+        __m512i t1 = add(add(add(h, big_sigma1(e)), add(ch(e, f, g), broadcast(constants::SHA256_K[i]))), w[i]);
+        __m512i t2 = add(big_sigma0(a), maj(a, b, c));
+        h = g;
+        g = f;
+        f = e;
+        e = add(d, t1);
+        d = c;
+        c = b;
+        b = a;
+        a = add(t1, t2);
+    }
+
+    s[0] = add(s[0], a);
+    s[1] = add(s[1], b);
+    s[2] = add(s[2], c);
+    s[3] = add(s[3], d);
+    s[4] = add(s[4], e);
+    s[5] = add(s[5], f);
+    s[6] = add(s[6], g);
+    s[7] = add(s[7], h);
+}
+
+} // anonymous namespace
+
+// =============================================================================
+// Пакетное хеширование заголовков
+// =============================================================================
+
+/**
+ * @brief Хешировать 16 заголовков (SHA256d) по их midstate и хвостам
+ *
+ * @param midstates Указатель на 16 midstate
+ * @param tails Указатель на 16 хвостов заголовков (16 байт)
+ * @param out Указатель на 16 выходных хешей
+ */
+void hash_headers_x16(
+    const Sha256State* midstates,
+    const HeaderTail* tails,
+    Hash256* out
+) noexcept {
+    alignas(64) uint32_t lane[LANES];
+    __m512i s[8];
+    __m512i w[16];
+
+    // === Загрузка midstate (транспонирование AoS -> SoA) ===
+    for (std::size_t j = 0; j < 8; ++j) {
+        for (std::size_t i = 0; i < LANES; ++i) {
+            lane[i] = midstates[i][j];
+        }
+        s[j] = _mm512_load_si512(lane);
+    }
+
+    // === Второй блок первого SHA256: хвост заголовка + padding ===
+    for (std::size_t j = 0; j < 4; ++j) {
+        for (std::size_t i = 0; i < LANES; ++i) {
+            lane[i] = read_be32(tails[i].data() + j * 4);
+        }
+        w[j] = _mm512_load_si512(lane);
+    }
+    w[4] = broadcast(0x80000000);
+    for (std::size_t j = 5; j < 15; ++j) {
+        w[j] = _mm512_setzero_si512();
+    }
+    w[15] = broadcast(80 * 8);  // Длина 80 байт = 640 бит
+
+    transform_x16(s, w);
+
+    // === Второй SHA256 над 32-байтным хешем ===
+    for (std::size_t j = 0; j < 8; ++j) {
+        w[j] = s[j];
+    }
+    w[8] = broadcast(0x80000000);
+    for (std::size_t j = 9; j < 15; ++j) {
+        w[j] = _mm512_setzero_si512();
+    }
+    w[15] = broadcast(32 * 8);  // Длина 32 байта = 256 бит
+
+    for (std::size_t j = 0; j < 8; ++j) {
+        s[j] = broadcast(constants::SHA256_INIT[j]);
+    }
+
+    transform_x16(s, w);
+
+    // === Выгрузка результата (SoA -> AoS, big-endian) ===
+    for (std::size_t j = 0; j < 8; ++j) {
+        _mm512_store_si512(lane, s[j]);
+        for (std::size_t i = 0; i < LANES; ++i) {
+            write_be32(out[i].data() + j * 4, lane[i]);
+        }
+    }
+}
+
+/**
+ * @brief Одно сжатие SHA256 для 16 независимых состояний
+ *
+ * @param states Указатель на 16 состояний (будут обновлены)
+ * @param blocks Блок первого состояния (64 байта)
+ * @param stride Расстояние между блоками соседних состояний
+ */
+void sha256_transform_x16(
+    Sha256State* states,
+    const uint8_t* blocks,
+    std::size_t stride
+) noexcept {
+    alignas(64) uint32_t lane[LANES];
+    __m512i s[8];
+    __m512i w[16];
+
+    for (std::size_t j = 0; j < 8; ++j) {
+        for (std::size_t i = 0; i < LANES; ++i) {
+            lane[i] = states[i][j];
+        }
+        s[j] = _mm512_load_si512(lane);
+    }
+    for (std::size_t j = 0; j < 16; ++j) {
+        for (std::size_t i = 0; i < LANES; ++i) {
+            lane[i] = read_be32(blocks + i * stride + j * 4);
+        }
+        w[j] = _mm512_load_si512(lane);
+    }
+
+    transform_x16(s, w);
+
+    for (std::size_t j = 0; j < 8; ++j) {
+        _mm512_store_si512(lane, s[j]);
+        for (std::size_t i = 0; i < LANES; ++i) {
+            states[i][j] = lane[i];
+        }
+    }
+}
+
+} // namespace quaxis::crypto::avx512
+
+#endif // QUAXIS_HAS_AVX512
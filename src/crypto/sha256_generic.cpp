@@ -9,11 +9,25 @@
  */
 
 #include "sha256.hpp"
+#include "sha256_precomputed.hpp"
 #include "../core/byte_order.hpp"
 #include "../core/constants.hpp"
 
 #include <bit>
 
+/**
+ * @brief Клон функции под BMI2 (rorx вместо пары сдвигов) на x86-64
+ * 
+ * GNU ifunc: версия выбирается загрузчиком один раз, вызов идёт без
+ * проверок. Работает на CPU без SHA-NI (Skylake-SP, Haswell), где
+ * generic - основная реализация.
+ */
+#if defined(__x86_64__) && defined(__linux__) && defined(__GNUC__)
+#define QUAXIS_GENERIC_CLONES __attribute__((target_clones("bmi2", "default")))
+#else
+#define QUAXIS_GENERIC_CLONES
+#endif
+
 namespace quaxis::crypto::generic {
 
 // =============================================================================
@@ -74,6 +88,7 @@ namespace quaxis::crypto::generic {
  * @param state Состояние хеша (8 x 32-bit слов), будет обновлено
  * @param block Указатель на 64 байта данных
  */
+QUAXIS_GENERIC_CLONES
 void sha256_transform(Sha256State& state, const uint8_t* block) noexcept {
     // Расписание сообщения (message schedule)
     uint32_t W[64];
@@ -123,6 +138,142 @@ void sha256_transform(Sha256State& state, const uint8_t* block) noexcept {
     state[7] += h;
 }
 
+// =============================================================================
+// SHA256d заголовка с midstate
+// =============================================================================
+
+/// @brief 8 раундов с переменными словами W[i..i+7]
+#define SHA256_ROUNDS8(W, i) \
+    do { \
+        for (int j = 0; j < 8; ++j) { \
+            SHA256_ROUND(a, b, c, d, e, f, g, h, (W)[(i) + j], K[static_cast<std::size_t>((i) + j)]); \
+        } \
+    } while (0)
+
+/// @brief Шаг расширения расписания (все слагаемые переменные)
+#define SCHEDULE(W, i) \
+    (W)[i] = sigma1((W)[(i) - 2]) + (W)[(i) - 7] + sigma0((W)[(i) - 15]) + (W)[(i) - 16]
+
+/**
+ * @brief SHA256d заголовка по midstate и 16-байтному хвосту
+ * 
+ * То же, что sha256_transform над блоком хвост + padding и затем над
+ * padding первого хеша, но слова padding не читаются и не расширяются:
+ * - W16..W31 считаются без нулевых слагаемых, постоянные берутся готовыми
+ * - В раундах с постоянными словами K + W - константа
+ * - Первый раунд второго SHA256 (состояние SHA256_INIT) наполовину посчитан
+ * 
+ * @param midstate Состояние после первых 64 байт заголовка
+ * @param tail Последние 16 байт заголовка
+ * @return Hash256 SHA256d заголовка
+ */
+QUAXIS_GENERIC_CLONES
+Hash256 hash_header_with_midstate(const Sha256State& midstate, const uint8_t* tail) noexcept {
+    using namespace precomputed;
+    const auto& K = constants::SHA256_K;
+    uint32_t W[64];
+    
+    // === Второй блок заголовка: W0..W3 - хвост, остальное padding ===
+    W[0] = read_be32(tail);
+    W[1] = read_be32(tail + 4);
+    W[2] = read_be32(tail + 8);
+    W[3] = read_be32(tail + 12);
+    W[16] = sigma0(W[1]) + W[0];
+    W[17] = HEADER_W17 + sigma0(W[2]) + W[1];
+    W[18] = sigma1(W[16]) + sigma0(W[3]) + W[2];
+    W[19] = sigma1(W[17]) + HEADER_W19 + W[3];
+    W[20] = sigma1(W[18]) + PAD_WORD;
+    W[21] = sigma1(W[19]);
+    W[22] = sigma1(W[20]) + HEADER_BITS;
+    W[23] = sigma1(W[21]) + W[16];
+    W[24] = sigma1(W[22]) + W[17];
+    W[25] = sigma1(W[23]) + W[18];
+    W[26] = sigma1(W[24]) + W[19];
+    W[27] = sigma1(W[25]) + W[20];
+    W[28] = sigma1(W[26]) + W[21];
+    W[29] = sigma1(W[27]) + W[22];
+    W[30] = sigma1(W[28]) + W[23] + HEADER_W30;
+    W[31] = sigma1(W[29]) + W[24] + sigma0(W[16]) + HEADER_BITS;
+    for (int i = 32; i < 64; ++i) {
+        SCHEDULE(W, i);
+    }
+    
+    uint32_t a = midstate[0], b = midstate[1], c = midstate[2], d = midstate[3];
+    uint32_t e = midstate[4], f = midstate[5], g = midstate[6], h = midstate[7];
+    
+    for (int i = 0; i < 4; ++i) {
+        SHA256_ROUND(a, b, c, d, e, f, g, h, W[i], K[static_cast<std::size_t>(i)]);
+    }
+    for (int i = 4; i < 16; ++i) {
+        SHA256_ROUND(a, b, c, d, e, f, g, h, 0u, HEADER_KW[static_cast<std::size_t>(i)]);
+    }
+    for (int i = 16; i < 64; i += 8) {
+        SHA256_ROUNDS8(W, i);
+    }
+    
+    // === Блок второго SHA256: W0..W7 - первый хеш ===
+    W[0] = midstate[0] + a;
+    W[1] = midstate[1] + b;
+    W[2] = midstate[2] + c;
+    W[3] = midstate[3] + d;
+    W[4] = midstate[4] + e;
+    W[5] = midstate[5] + f;
+    W[6] = midstate[6] + g;
+    W[7] = midstate[7] + h;
+    W[16] = sigma0(W[1]) + W[0];
+    W[17] = HASH_W17 + sigma0(W[2]) + W[1];
+    W[18] = sigma1(W[16]) + sigma0(W[3]) + W[2];
+    W[19] = sigma1(W[17]) + sigma0(W[4]) + W[3];
+    W[20] = sigma1(W[18]) + sigma0(W[5]) + W[4];
+    W[21] = sigma1(W[19]) + sigma0(W[6]) + W[5];
+    W[22] = sigma1(W[20]) + HASH_BITS + sigma0(W[7]) + W[6];
+    W[23] = sigma1(W[21]) + W[16] + HASH_W23 + W[7];
+    W[24] = sigma1(W[22]) + W[17] + PAD_WORD;
+    W[25] = sigma1(W[23]) + W[18];
+    W[26] = sigma1(W[24]) + W[19];
+    W[27] = sigma1(W[25]) + W[20];
+    W[28] = sigma1(W[26]) + W[21];
+    W[29] = sigma1(W[27]) + W[22];
+    W[30] = sigma1(W[28]) + W[23] + HASH_W30;
+    W[31] = sigma1(W[29]) + W[24] + sigma0(W[16]) + HASH_BITS;
+    for (int i = 32; i < 64; ++i) {
+        SCHEDULE(W, i);
+    }
+    
+    // Раунд 0 от SHA256_INIT: переменное только W0
+    const auto& H = constants::SHA256_INIT;
+    const uint32_t round0_t1 = HASH_ROUND0_T1 + W[0];
+    a = round0_t1 + HASH_ROUND0_T2;
+    b = H[0];
+    c = H[1];
+    d = H[2];
+    e = H[3] + round0_t1;
+    f = H[4];
+    g = H[5];
+    h = H[6];
+    
+    for (int i = 1; i < 8; ++i) {
+        SHA256_ROUND(a, b, c, d, e, f, g, h, W[i], K[static_cast<std::size_t>(i)]);
+    }
+    for (int i = 8; i < 16; ++i) {
+        SHA256_ROUND(a, b, c, d, e, f, g, h, 0u, HASH_KW[static_cast<std::size_t>(i)]);
+    }
+    for (int i = 16; i < 64; i += 8) {
+        SHA256_ROUNDS8(W, i);
+    }
+    
+    Hash256 result;
+    write_be32(result.data(), H[0] + a);
+    write_be32(result.data() + 4, H[1] + b);
+    write_be32(result.data() + 8, H[2] + c);
+    write_be32(result.data() + 12, H[3] + d);
+    write_be32(result.data() + 16, H[4] + e);
+    write_be32(result.data() + 20, H[5] + f);
+    write_be32(result.data() + 24, H[6] + g);
+    write_be32(result.data() + 28, H[7] + h);
+    return result;
+}
+
 // Очистка макросов
 #undef ROTR32
 #undef SHR
@@ -133,5 +284,6 @@ void sha256_transform(Sha256State& state, const uint8_t* block) noexcept {
 #undef sigma0
 #undef sigma1
 #undef SHA256_ROUND
+#undef SCHEDULE
 
 } // namespace quaxis::crypto::generic
@@ -0,0 +1,167 @@
+/**
+ * @file sha256_precomputed.hpp
+ * @brief Заранее вычисленные слова расписания для SHA256d заголовка
+ *
+ * При хешировании заголовка с midstate оба оставшихся блока почти
+ * целиком состоят из padding:
+ * - Второй блок заголовка: W0..W3 - хвост (16 байт), W4 = 0x80000000,
+ *   W5..W14 = 0, W15 = 640 (длина 80 байт в битах)
+ * - Блок второго SHA256: W0..W7 - первый хеш, W8 = 0x80000000,
+ *   W9..W14 = 0, W15 = 256 (длина 32 байта в битах)
+ *
+ * Для раундов с постоянными словами K[i] + W[i] известно при компиляции,
+ * как и постоянные слагаемые первых слов расширения расписания и первый
+ * раунд второго SHA256 (его состояние - SHA256_INIT). Используется
+ * специализированными transform generic и SHA-NI реализаций.
+ *
+ * Блок padding 64-байтного сообщения (узел Merkle дерева) не зависит
+ * от данных вовсе: всё его расписание из 64 слов постоянно.
+ *
+ * @note Внутренний заголовок модуля crypto
+ */
+
+#pragma once
+
+#include "../core/constants.hpp"
+
+#include <array>
+#include <bit>
+#include <cstdint>
+
+namespace quaxis::crypto::precomputed {
+
+// =============================================================================
+// Функции SHA256 (FIPS 180-4, секция 4.1.2) для вычислений при компиляции
+// =============================================================================
+
+[[nodiscard]] constexpr uint32_t ch(uint32_t x, uint32_t y, uint32_t z) noexcept {
+    return (x & y) ^ (~x & z);
+}
+
+[[nodiscard]] constexpr uint32_t maj(uint32_t x, uint32_t y, uint32_t z) noexcept {
+    return (x & y) ^ (x & z) ^ (y & z);
+}
+
+[[nodiscard]] constexpr uint32_t big_sigma0(uint32_t x) noexcept {
+    return std::rotr(x, 2) ^ std::rotr(x, 13) ^ std::rotr(x, 22);
+}
+
+[[nodiscard]] constexpr uint32_t big_sigma1(uint32_t x) noexcept {
+    return std::rotr(x, 6) ^ std::rotr(x, 11) ^ std::rotr(x, 25);
+}
+
+[[nodiscard]] constexpr uint32_t small_sigma0(uint32_t x) noexcept {
+    return std::rotr(x, 7) ^ std::rotr(x, 18) ^ (x >> 3);
+}
+
+[[nodiscard]] constexpr uint32_t small_sigma1(uint32_t x) noexcept {
+    return std::rotr(x, 17) ^ std::rotr(x, 19) ^ (x >> 10);
+}
+
+// =============================================================================
+// Padding
+// =============================================================================
+
+/// @brief Первое слово padding (бит 1 после сообщения)
+inline constexpr uint32_t PAD_WORD = 0x80000000;
+
+/// @brief Длина заголовка в битах (W15 второго блока заголовка)
+inline constexpr uint32_t HEADER_BITS = 80 * 8;
+
+/// @brief Длина хеша в битах (W15 блока второго SHA256)
+inline constexpr uint32_t HASH_BITS = 32 * 8;
+
+/// @brief Длина 64-байтного сообщения в битах (W15 блока padding)
+inline constexpr uint32_t BLOCK64_BITS = 64 * 8;
+
+namespace detail {
+
+/**
+ * @brief K[i] + W[i] для слов padding начиная с first_pad
+ *
+ * Слова до first_pad зависят от данных и в таблице равны K[i].
+ */
+[[nodiscard]] constexpr std::array<uint32_t, 16> make_kw(std::size_t first_pad, uint32_t bits) noexcept {
+    std::array<uint32_t, 16> kw{};
+    for (std::size_t i = 0; i < 16; ++i) {
+        uint32_t w = 0;
+        if (i == first_pad) {
+            w = PAD_WORD;
+        } else if (i == 15) {
+            w = bits;
+        }
+        kw[i] = constants::SHA256_K[i] + (i >= first_pad ? w : 0);
+    }
+    return kw;
+}
+
+/**
+ * @brief K[i] + W[i] всех 64 раундов блока, состоящего только из padding
+ */
+[[nodiscard]] constexpr std::array<uint32_t, 64> make_padding_block_kw(uint32_t bits) noexcept {
+    std::array<uint32_t, 64> w{};
+    w[0] = PAD_WORD;
+    w[15] = bits;
+    for (std::size_t i = 16; i < 64; ++i) {
+        w[i] = small_sigma1(w[i - 2]) + w[i - 7] + small_sigma0(w[i - 15]) + w[i - 16];
+    }
+    for (std::size_t i = 0; i < 64; ++i) {
+        w[i] += constants::SHA256_K[i];
+    }
+    return w;
+}
+
+} // namespace detail
+
+// =============================================================================
+// Второй блок заголовка (W4..W15 постоянны)
+// =============================================================================
+
+/// @brief K[i] + W[i] раундов 0..15 (4..15 постоянны)
+alignas(16) inline constexpr std::array<uint32_t, 16> HEADER_KW = detail::make_kw(4, HEADER_BITS);
+
+/// @brief σ1(W15) в W17
+inline constexpr uint32_t HEADER_W17 = small_sigma1(HEADER_BITS);
+
+/// @brief σ0(W4) в W19
+inline constexpr uint32_t HEADER_W19 = small_sigma0(PAD_WORD);
+
+/// @brief σ0(W15) в W30
+inline constexpr uint32_t HEADER_W30 = small_sigma0(HEADER_BITS);
+
+// =============================================================================
+// Блок второго SHA256 (W8..W15 постоянны)
+// =============================================================================
+
+/// @brief K[i] + W[i] раундов 0..15 (8..15 постоянны)
+alignas(16) inline constexpr std::array<uint32_t, 16> HASH_KW = detail::make_kw(8, HASH_BITS);
+
+/// @brief σ1(W15) в W17
+inline constexpr uint32_t HASH_W17 = small_sigma1(HASH_BITS);
+
+/// @brief σ0(W8) в W23
+inline constexpr uint32_t HASH_W23 = small_sigma0(PAD_WORD);
+
+/// @brief σ0(W15) в W30
+inline constexpr uint32_t HASH_W30 = small_sigma0(HASH_BITS);
+
+/// @brief Слагаемые T1 первого раунда без W0 (состояние SHA256_INIT)
+inline constexpr uint32_t HASH_ROUND0_T1 =
+    constants::SHA256_INIT[7]
+    + big_sigma1(constants::SHA256_INIT[4])
+    + ch(constants::SHA256_INIT[4], constants::SHA256_INIT[5], constants::SHA256_INIT[6])
+    + constants::SHA256_K[0];
+
+/// @brief T2 первого раунда (состояние SHA256_INIT)
+inline constexpr uint32_t HASH_ROUND0_T2 =
+    big_sigma0(constants::SHA256_INIT[0])
+    + maj(constants::SHA256_INIT[0], constants::SHA256_INIT[1], constants::SHA256_INIT[2]);
+
+// =============================================================================
+// Блок padding 64-байтного сообщения (все слова постоянны)
+// =============================================================================
+
+/// @brief K[i] + W[i] раундов 0..63 второго блока SHA256(64 байта)
+alignas(16) inline constexpr std::array<uint32_t, 64> BLOCK64_PAD_KW = detail::make_padding_block_kw(BLOCK64_BITS);
+
+} // namespace quaxis::crypto::precomputed
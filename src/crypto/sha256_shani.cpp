@@ -18,12 +18,16 @@
  */
 
 #include "sha256.hpp"
+#include "sha256_precomputed.hpp"
 #include "../core/constants.hpp"
+#include "../core/pmu_profile.hpp"
 
 #ifdef QUAXIS_HAS_SHANI
 
 #include <immintrin.h>
+#include <cstddef>
 #include <cstring>
+#include <utility>
 
 namespace quaxis::crypto::shani {
 
@@ -61,92 +65,27 @@ alignas(16) static const uint8_t BSWAP_MASK[16] = {
 };
 
 // =============================================================================
-// SHA256 Transform с SHA-NI
+// Общие части transform
 // =============================================================================
 
+namespace {
+
 /**
- * @brief Функция сжатия SHA256 с использованием SHA-NI
- * 
- * Алгоритм:
- * 1. Загружаем состояние в SSE регистры
- * 2. Загружаем сообщение и конвертируем в big-endian
- * 3. Выполняем 64 раунда с помощью _mm_sha256rnds2_epu32
- * 4. Добавляем результат к состоянию
+ * @brief Раунды 16-63 (расписание дальше зависит только от W0..W15)
  * 
- * @param state Состояние хеша (8 x 32-bit слов)
- * @param block Указатель на 64 байта данных
+ * На входе msg0 = W16..W19 (уже вычислены), msg3 = W12..W15,
+ * msg1 и msg2 - частичные суммы _mm_sha256msg1_epu32 для W20..W27.
  */
-void sha256_transform(Sha256State& state, const uint8_t* block) noexcept {
-    // Маска для byte swap
-    const __m128i bswap_mask = _mm_load_si128(reinterpret_cast<const __m128i*>(BSWAP_MASK));
-    
-    // === Загрузка начального состояния ===
-    // Состояние SHA256: A B C D E F G H
-    // Загружаем в два 128-битных регистра:
-    // STATE0 = A B C D (позже будет E F G H после shuffle)
-    // STATE1 = E F G H (позже будет A B C D после shuffle)
-    
-    // Загружаем состояние
-    __m128i tmp = _mm_loadu_si128(reinterpret_cast<const __m128i*>(state.data()));
-    __m128i state1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(state.data() + 4));
-    
-    // Сохраняем начальное состояние для финального сложения
-    const __m128i abef_init = tmp;
-    const __m128i cdgh_init = state1;
-    
-    // Переупорядочиваем состояние для SHA-NI
-    // tmp = C D A B
-    tmp = _mm_shuffle_epi32(tmp, 0xB1);        // 10 11 00 01 = 0xB1
-    // state1 = G H E F
-    state1 = _mm_shuffle_epi32(state1, 0xB1);
-    // STATE0 = A B E F
-    __m128i state0 = _mm_alignr_epi8(tmp, state1, 8);
-    // STATE1 = C D G H
-    state1 = _mm_blend_epi16(state1, tmp, 0xF0);
-    
-    // === Загрузка сообщения ===
-    __m128i msg0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block));
-    __m128i msg1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 16));
-    __m128i msg2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 32));
-    __m128i msg3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 48));
-    
-    // Конвертируем в big-endian
-    msg0 = _mm_shuffle_epi8(msg0, bswap_mask);
-    msg1 = _mm_shuffle_epi8(msg1, bswap_mask);
-    msg2 = _mm_shuffle_epi8(msg2, bswap_mask);
-    msg3 = _mm_shuffle_epi8(msg3, bswap_mask);
-    
-    // === Раунды 0-3 ===
+inline void rounds_16_63(
+    __m128i& state0,
+    __m128i& state1,
+    __m128i msg0,
+    __m128i msg1,
+    __m128i msg2,
+    __m128i msg3
+) noexcept {
     __m128i msg_tmp;
-    msg_tmp = _mm_add_epi32(msg0, _mm_load_si128(reinterpret_cast<const __m128i*>(K256)));
-    state1 = _mm_sha256rnds2_epu32(state1, state0, msg_tmp);
-    msg_tmp = _mm_shuffle_epi32(msg_tmp, 0x0E);
-    state0 = _mm_sha256rnds2_epu32(state0, state1, msg_tmp);
-    msg0 = _mm_sha256msg1_epu32(msg0, msg1);
-    
-    // === Раунды 4-7 ===
-    msg_tmp = _mm_add_epi32(msg1, _mm_load_si128(reinterpret_cast<const __m128i*>(K256 + 4)));
-    state1 = _mm_sha256rnds2_epu32(state1, state0, msg_tmp);
-    msg_tmp = _mm_shuffle_epi32(msg_tmp, 0x0E);
-    state0 = _mm_sha256rnds2_epu32(state0, state1, msg_tmp);
-    msg1 = _mm_sha256msg1_epu32(msg1, msg2);
-    
-    // === Раунды 8-11 ===
-    msg_tmp = _mm_add_epi32(msg2, _mm_load_si128(reinterpret_cast<const __m128i*>(K256 + 8)));
-    state1 = _mm_sha256rnds2_epu32(state1, state0, msg_tmp);
-    msg_tmp = _mm_shuffle_epi32(msg_tmp, 0x0E);
-    state0 = _mm_sha256rnds2_epu32(state0, state1, msg_tmp);
-    msg2 = _mm_sha256msg1_epu32(msg2, msg3);
-    
-    // === Раунды 12-15 ===
-    msg_tmp = _mm_add_epi32(msg3, _mm_load_si128(reinterpret_cast<const __m128i*>(K256 + 12)));
-    state1 = _mm_sha256rnds2_epu32(state1, state0, msg_tmp);
-    __m128i tmp_msg = _mm_alignr_epi8(msg3, msg2, 4);
-    msg0 = _mm_add_epi32(msg0, tmp_msg);
-    msg0 = _mm_sha256msg2_epu32(msg0, msg3);
-    msg_tmp = _mm_shuffle_epi32(msg_tmp, 0x0E);
-    state0 = _mm_sha256rnds2_epu32(state0, state1, msg_tmp);
-    msg3 = _mm_sha256msg1_epu32(msg3, msg0);
+    __m128i tmp_msg;
     
     // === Раунды 16-19 ===
     msg_tmp = _mm_add_epi32(msg0, _mm_load_si128(reinterpret_cast<const __m128i*>(K256 + 16)));
@@ -156,7 +95,7 @@ void sha256_transform(Sha256State& state, const uint8_t* block) noexcept {
     msg1 = _mm_sha256msg2_epu32(msg1, msg0);
     msg_tmp = _mm_shuffle_epi32(msg_tmp, 0x0E);
     state0 = _mm_sha256rnds2_epu32(state0, state1, msg_tmp);
-    msg0 = _mm_sha256msg1_epu32(msg0, msg1);
+    msg3 = _mm_sha256msg1_epu32(msg3, msg0);
     
     // === Раунды 20-23 ===
     msg_tmp = _mm_add_epi32(msg1, _mm_load_si128(reinterpret_cast<const __m128i*>(K256 + 20)));
@@ -166,7 +105,7 @@ void sha256_transform(Sha256State& state, const uint8_t* block) noexcept {
     msg2 = _mm_sha256msg2_epu32(msg2, msg1);
     msg_tmp = _mm_shuffle_epi32(msg_tmp, 0x0E);
     state0 = _mm_sha256rnds2_epu32(state0, state1, msg_tmp);
-    msg1 = _mm_sha256msg1_epu32(msg1, msg2);
+    msg0 = _mm_sha256msg1_epu32(msg0, msg1);
     
     // === Раунды 24-27 ===
     msg_tmp = _mm_add_epi32(msg2, _mm_load_si128(reinterpret_cast<const __m128i*>(K256 + 24)));
@@ -176,7 +115,7 @@ void sha256_transform(Sha256State& state, const uint8_t* block) noexcept {
     msg3 = _mm_sha256msg2_epu32(msg3, msg2);
     msg_tmp = _mm_shuffle_epi32(msg_tmp, 0x0E);
     state0 = _mm_sha256rnds2_epu32(state0, state1, msg_tmp);
-    msg2 = _mm_sha256msg1_epu32(msg2, msg3);
+    msg1 = _mm_sha256msg1_epu32(msg1, msg2);
     
     // === Раунды 28-31 ===
     msg_tmp = _mm_add_epi32(msg3, _mm_load_si128(reinterpret_cast<const __m128i*>(K256 + 28)));
@@ -186,7 +125,7 @@ void sha256_transform(Sha256State& state, const uint8_t* block) noexcept {
     msg0 = _mm_sha256msg2_epu32(msg0, msg3);
     msg_tmp = _mm_shuffle_epi32(msg_tmp, 0x0E);
     state0 = _mm_sha256rnds2_epu32(state0, state1, msg_tmp);
-    msg3 = _mm_sha256msg1_epu32(msg3, msg0);
+    msg2 = _mm_sha256msg1_epu32(msg2, msg3);
     
     // === Раунды 32-35 ===
     msg_tmp = _mm_add_epi32(msg0, _mm_load_si128(reinterpret_cast<const __m128i*>(K256 + 32)));
@@ -196,7 +135,7 @@ void sha256_transform(Sha256State& state, const uint8_t* block) noexcept {
     msg1 = _mm_sha256msg2_epu32(msg1, msg0);
     msg_tmp = _mm_shuffle_epi32(msg_tmp, 0x0E);
     state0 = _mm_sha256rnds2_epu32(state0, state1, msg_tmp);
-    msg0 = _mm_sha256msg1_epu32(msg0, msg1);
+    msg3 = _mm_sha256msg1_epu32(msg3, msg0);
     
     // === Раунды 36-39 ===
     msg_tmp = _mm_add_epi32(msg1, _mm_load_si128(reinterpret_cast<const __m128i*>(K256 + 36)));
@@ -206,7 +145,7 @@ void sha256_transform(Sha256State& state, const uint8_t* block) noexcept {
     msg2 = _mm_sha256msg2_epu32(msg2, msg1);
     msg_tmp = _mm_shuffle_epi32(msg_tmp, 0x0E);
     state0 = _mm_sha256rnds2_epu32(state0, state1, msg_tmp);
-    msg1 = _mm_sha256msg1_epu32(msg1, msg2);
+    msg0 = _mm_sha256msg1_epu32(msg0, msg1);
     
     // === Раунды 40-43 ===
     msg_tmp = _mm_add_epi32(msg2, _mm_load_si128(reinterpret_cast<const __m128i*>(K256 + 40)));
@@ -216,7 +155,7 @@ void sha256_transform(Sha256State& state, const uint8_t* block) noexcept {
     msg3 = _mm_sha256msg2_epu32(msg3, msg2);
     msg_tmp = _mm_shuffle_epi32(msg_tmp, 0x0E);
     state0 = _mm_sha256rnds2_epu32(state0, state1, msg_tmp);
-    msg2 = _mm_sha256msg1_epu32(msg2, msg3);
+    msg1 = _mm_sha256msg1_epu32(msg1, msg2);
     
     // === Раунды 44-47 ===
     msg_tmp = _mm_add_epi32(msg3, _mm_load_si128(reinterpret_cast<const __m128i*>(K256 + 44)));
@@ -226,7 +165,7 @@ void sha256_transform(Sha256State& state, const uint8_t* block) noexcept {
     msg0 = _mm_sha256msg2_epu32(msg0, msg3);
     msg_tmp = _mm_shuffle_epi32(msg_tmp, 0x0E);
     state0 = _mm_sha256rnds2_epu32(state0, state1, msg_tmp);
-    msg3 = _mm_sha256msg1_epu32(msg3, msg0);
+    msg2 = _mm_sha256msg1_epu32(msg2, msg3);
     
     // === Раунды 48-51 ===
     msg_tmp = _mm_add_epi32(msg0, _mm_load_si128(reinterpret_cast<const __m128i*>(K256 + 48)));
@@ -236,6 +175,7 @@ void sha256_transform(Sha256State& state, const uint8_t* block) noexcept {
     msg1 = _mm_sha256msg2_epu32(msg1, msg0);
     msg_tmp = _mm_shuffle_epi32(msg_tmp, 0x0E);
     state0 = _mm_sha256rnds2_epu32(state0, state1, msg_tmp);
+    msg3 = _mm_sha256msg1_epu32(msg3, msg0);
     
     // === Раунды 52-55 ===
     msg_tmp = _mm_add_epi32(msg1, _mm_load_si128(reinterpret_cast<const __m128i*>(K256 + 52)));
@@ -260,23 +200,434 @@ void sha256_transform(Sha256State& state, const uint8_t* block) noexcept {
     state1 = _mm_sha256rnds2_epu32(state1, state0, msg_tmp);
     msg_tmp = _mm_shuffle_epi32(msg_tmp, 0x0E);
     state0 = _mm_sha256rnds2_epu32(state0, state1, msg_tmp);
-    
-    // === Добавляем начальное состояние ===
-    // Переупорядочиваем обратно
-    tmp = _mm_shuffle_epi32(state0, 0x1B);        // 00 01 10 11 = 0x1B
-    state1 = _mm_shuffle_epi32(state1, 0xB1);     // 10 11 00 01 = 0xB1
+}
+
+/**
+ * @brief Состояние A..H -> пара регистров ABEF / CDGH
+ */
+inline void load_state(const Sha256State& state, __m128i& state0, __m128i& state1) noexcept {
+    __m128i tmp = _mm_loadu_si128(reinterpret_cast<const __m128i*>(state.data()));
+    state1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(state.data() + 4));
+    tmp = _mm_shuffle_epi32(tmp, 0xB1);
+    state1 = _mm_shuffle_epi32(state1, 0x1B);
+    state0 = _mm_alignr_epi8(tmp, state1, 8);
+    state1 = _mm_blend_epi16(state1, tmp, 0xF0);
+}
+
+/**
+ * @brief Пара регистров ABEF / CDGH -> слова A B C D / E F G H
+ */
+inline void unpack_state(__m128i& state0, __m128i& state1) noexcept {
+    __m128i tmp = _mm_shuffle_epi32(state0, 0x1B);
+    state1 = _mm_shuffle_epi32(state1, 0xB1);
     state0 = _mm_blend_epi16(tmp, state1, 0xF0);
     state1 = _mm_alignr_epi8(state1, tmp, 8);
+}
+
+inline __m128i load_kw(const uint32_t* kw) noexcept {
+    return _mm_load_si128(reinterpret_cast<const __m128i*>(kw));
+}
+
+/**
+ * @brief Очистить верхние половины ymm перед legacy SSE кодом
+ * 
+ * sha256rnds2/sha256msg* есть только в legacy SSE кодировке. При
+ * -march=native вызывающий код (и инлайненный LTO) пишет ymm, и с
+ * грязной верхней половиной каждая SSE инструкция платит за переход
+ * (в compute_midstate - в десятки раз медленнее transform).
+ */
+inline void clear_upper_state() noexcept {
+#ifdef __AVX__
+    _mm256_zeroupper();
+#endif
+}
+
+} // anonymous namespace
+
+// =============================================================================
+// SHA256 Transform с SHA-NI
+// =============================================================================
+
+/**
+ * @brief Функция сжатия SHA256 с использованием SHA-NI
+ * 
+ * Алгоритм:
+ * 1. Загружаем состояние в SSE регистры
+ * 2. Загружаем сообщение и конвертируем в big-endian
+ * 3. Выполняем 64 раунда с помощью _mm_sha256rnds2_epu32
+ * 4. Добавляем результат к состоянию
+ * 
+ * @param state Состояние хеша (8 x 32-bit слов)
+ * @param block Указатель на 64 байта данных
+ */
+void sha256_transform(Sha256State& state, const uint8_t* block) noexcept {
+    clear_upper_state();
+    
+    // Маска для byte swap
+    const __m128i bswap_mask = _mm_load_si128(reinterpret_cast<const __m128i*>(BSWAP_MASK));
+    
+    // === Загрузка начального состояния ===
+    // Состояние SHA256: A B C D E F G H
+    // SHA-NI работает с парой регистров ABEF / CDGH
+    __m128i state0;
+    __m128i state1;
+    load_state(state, state0, state1);
+    
+    // Сохраняем начальное состояние (уже в формате ABEF/CDGH) для финального сложения
+    const __m128i abef_save = state0;
+    const __m128i cdgh_save = state1;
+    
+    // === Загрузка сообщения ===
+    __m128i msg0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block));
+    __m128i msg1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 16));
+    __m128i msg2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 32));
+    __m128i msg3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 48));
+    
+    // Конвертируем в big-endian
+    msg0 = _mm_shuffle_epi8(msg0, bswap_mask);
+    msg1 = _mm_shuffle_epi8(msg1, bswap_mask);
+    msg2 = _mm_shuffle_epi8(msg2, bswap_mask);
+    msg3 = _mm_shuffle_epi8(msg3, bswap_mask);
+    
+    __m128i msg_tmp;
+    __m128i tmp_msg;
+    // === Раунды 0-3 ===
+    msg_tmp = _mm_add_epi32(msg0, _mm_load_si128(reinterpret_cast<const __m128i*>(K256)));
+    state1 = _mm_sha256rnds2_epu32(state1, state0, msg_tmp);
+    msg_tmp = _mm_shuffle_epi32(msg_tmp, 0x0E);
+    state0 = _mm_sha256rnds2_epu32(state0, state1, msg_tmp);
     
-    // Добавляем начальное состояние
-    state0 = _mm_add_epi32(state0, abef_init);
-    state1 = _mm_add_epi32(state1, cdgh_init);
+    // === Раунды 4-7 ===
+    msg_tmp = _mm_add_epi32(msg1, _mm_load_si128(reinterpret_cast<const __m128i*>(K256 + 4)));
+    state1 = _mm_sha256rnds2_epu32(state1, state0, msg_tmp);
+    msg_tmp = _mm_shuffle_epi32(msg_tmp, 0x0E);
+    state0 = _mm_sha256rnds2_epu32(state0, state1, msg_tmp);
+    msg0 = _mm_sha256msg1_epu32(msg0, msg1);
+    
+    // === Раунды 8-11 ===
+    msg_tmp = _mm_add_epi32(msg2, _mm_load_si128(reinterpret_cast<const __m128i*>(K256 + 8)));
+    state1 = _mm_sha256rnds2_epu32(state1, state0, msg_tmp);
+    msg_tmp = _mm_shuffle_epi32(msg_tmp, 0x0E);
+    state0 = _mm_sha256rnds2_epu32(state0, state1, msg_tmp);
+    msg1 = _mm_sha256msg1_epu32(msg1, msg2);
+    
+    // === Раунды 12-15 ===
+    msg_tmp = _mm_add_epi32(msg3, _mm_load_si128(reinterpret_cast<const __m128i*>(K256 + 12)));
+    state1 = _mm_sha256rnds2_epu32(state1, state0, msg_tmp);
+    tmp_msg = _mm_alignr_epi8(msg3, msg2, 4);
+    msg0 = _mm_add_epi32(msg0, tmp_msg);
+    msg0 = _mm_sha256msg2_epu32(msg0, msg3);
+    msg_tmp = _mm_shuffle_epi32(msg_tmp, 0x0E);
+    state0 = _mm_sha256rnds2_epu32(state0, state1, msg_tmp);
+    msg2 = _mm_sha256msg1_epu32(msg2, msg3);
+    
+    rounds_16_63(state0, state1, msg0, msg1, msg2, msg3);
+    
+    // === Добавляем начальное состояние ===
+    state0 = _mm_add_epi32(state0, abef_save);
+    state1 = _mm_add_epi32(state1, cdgh_save);
+    
+    // === Переупорядочиваем обратно в A B C D / E F G H ===
+    unpack_state(state0, state1);
     
     // === Сохраняем результат ===
     _mm_storeu_si128(reinterpret_cast<__m128i*>(state.data()), state0);
     _mm_storeu_si128(reinterpret_cast<__m128i*>(state.data() + 4), state1);
 }
 
+// =============================================================================
+// SHA256d заголовка с midstate
+// =============================================================================
+
+/**
+ * @brief SHA256d заголовка по midstate и 16-байтному хвосту
+ * 
+ * Два transform без чтения и byte swap слов padding:
+ * - Раунды с постоянными словами берут K + W из precomputed
+ * - Шаги _mm_sha256msg1 / сложения над нулевыми словами пропущены
+ * - Первый хеш идёт во второй SHA256 прямо из регистров состояния
+ * 
+ * @param midstate Состояние после первых 64 байт заголовка
+ * @param tail Последние 16 байт заголовка
+ * @return Hash256 SHA256d заголовка
+ */
+Hash256 hash_header_with_midstate(const Sha256State& midstate, const uint8_t* tail) noexcept {
+    clear_upper_state();
+    
+    using namespace precomputed;
+    const __m128i bswap_mask = _mm_load_si128(reinterpret_cast<const __m128i*>(BSWAP_MASK));
+    __m128i msg_tmp;
+    
+    // === Второй блок заголовка: W0..W3 - хвост, W4 = PAD, W15 = 640 ===
+    __m128i state0;
+    __m128i state1;
+    load_state(midstate, state0, state1);
+    const __m128i abef_save = state0;
+    const __m128i cdgh_save = state1;
+    
+    __m128i msg0 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(tail)), bswap_mask);
+    // msg1 = W4..W7; _mm_sha256msg1(msg1, msg2) = W4..W7 (σ0(0) = 0)
+    const __m128i msg1 = _mm_set_epi32(0, 0, 0, static_cast<int>(PAD_WORD));
+    // msg2 = W8..W11 = 0, и _mm_sha256msg1(msg2, msg3) = 0
+    const __m128i msg2 = _mm_setzero_si128();
+    const __m128i msg3 = _mm_set_epi32(static_cast<int>(HEADER_BITS), 0, 0, 0);
+    
+    // Раунды 0-3
+    msg_tmp = _mm_add_epi32(msg0, _mm_load_si128(reinterpret_cast<const __m128i*>(K256)));
+    state1 = _mm_sha256rnds2_epu32(state1, state0, msg_tmp);
+    msg_tmp = _mm_shuffle_epi32(msg_tmp, 0x0E);
+    state0 = _mm_sha256rnds2_epu32(state0, state1, msg_tmp);
+    
+    // Раунды 4-15: K + W постоянны
+    msg_tmp = load_kw(HEADER_KW.data() + 4);
+    state1 = _mm_sha256rnds2_epu32(state1, state0, msg_tmp);
+    msg_tmp = _mm_shuffle_epi32(msg_tmp, 0x0E);
+    state0 = _mm_sha256rnds2_epu32(state0, state1, msg_tmp);
+    msg0 = _mm_sha256msg1_epu32(msg0, msg1);
+    
+    msg_tmp = load_kw(HEADER_KW.data() + 8);
+    state1 = _mm_sha256rnds2_epu32(state1, state0, msg_tmp);
+    msg_tmp = _mm_shuffle_epi32(msg_tmp, 0x0E);
+    state0 = _mm_sha256rnds2_epu32(state0, state1, msg_tmp);
+    
+    msg_tmp = load_kw(HEADER_KW.data() + 12);
+    state1 = _mm_sha256rnds2_epu32(state1, state0, msg_tmp);
+    msg0 = _mm_sha256msg2_epu32(msg0, msg3);  // + W9..W12 = 0 пропущено
+    msg_tmp = _mm_shuffle_epi32(msg_tmp, 0x0E);
+    state0 = _mm_sha256rnds2_epu32(state0, state1, msg_tmp);
+    
+    rounds_16_63(state0, state1, msg0, msg1, msg2, msg3);
+    
+    state0 = _mm_add_epi32(state0, abef_save);
+    state1 = _mm_add_epi32(state1, cdgh_save);
+    unpack_state(state0, state1);
+    
+    // === Второй SHA256: W0..W7 - первый хеш (слова состояния), W8 = PAD, W15 = 256 ===
+    __m128i hash_msg0 = state0;
+    __m128i hash_msg1 = state1;
+    const __m128i hash_msg2 = _mm_set_epi32(0, 0, 0, static_cast<int>(PAD_WORD));
+    const __m128i hash_msg3 = _mm_set_epi32(static_cast<int>(HASH_BITS), 0, 0, 0);
+    
+    // SHA256_INIT в раскладке ABEF / CDGH
+    const auto& H = constants::SHA256_INIT;
+    const __m128i init0 = _mm_set_epi32(static_cast<int>(H[0]), static_cast<int>(H[1]),
+                                        static_cast<int>(H[4]), static_cast<int>(H[5]));
+    const __m128i init1 = _mm_set_epi32(static_cast<int>(H[2]), static_cast<int>(H[3]),
+                                        static_cast<int>(H[6]), static_cast<int>(H[7]));
+    state0 = init0;
+    state1 = init1;
+    
+    // Раунды 0-7
+    msg_tmp = _mm_add_epi32(hash_msg0, _mm_load_si128(reinterpret_cast<const __m128i*>(K256)));
+    state1 = _mm_sha256rnds2_epu32(state1, state0, msg_tmp);
+    msg_tmp = _mm_shuffle_epi32(msg_tmp, 0x0E);
+    state0 = _mm_sha256rnds2_epu32(state0, state1, msg_tmp);
+    
+    msg_tmp = _mm_add_epi32(hash_msg1, _mm_load_si128(reinterpret_cast<const __m128i*>(K256 + 4)));
+    state1 = _mm_sha256rnds2_epu32(state1, state0, msg_tmp);
+    msg_tmp = _mm_shuffle_epi32(msg_tmp, 0x0E);
+    state0 = _mm_sha256rnds2_epu32(state0, state1, msg_tmp);
+    hash_msg0 = _mm_sha256msg1_epu32(hash_msg0, hash_msg1);
+    
+    // Раунды 8-15: K + W постоянны
+    msg_tmp = load_kw(HASH_KW.data() + 8);
+    state1 = _mm_sha256rnds2_epu32(state1, state0, msg_tmp);
+    msg_tmp = _mm_shuffle_epi32(msg_tmp, 0x0E);
+    state0 = _mm_sha256rnds2_epu32(state0, state1, msg_tmp);
+    hash_msg1 = _mm_sha256msg1_epu32(hash_msg1, hash_msg2);
+    
+    msg_tmp = load_kw(HASH_KW.data() + 12);
+    state1 = _mm_sha256rnds2_epu32(state1, state0, msg_tmp);
+    hash_msg0 = _mm_sha256msg2_epu32(hash_msg0, hash_msg3);  // + W9..W12 = 0 пропущено
+    msg_tmp = _mm_shuffle_epi32(msg_tmp, 0x0E);
+    state0 = _mm_sha256rnds2_epu32(state0, state1, msg_tmp);
+    // _mm_sha256msg1(msg2, msg3) = W8..W11 (σ0(0) = 0): hash_msg2 не меняется
+    
+    rounds_16_63(state0, state1, hash_msg0, hash_msg1, hash_msg2, hash_msg3);
+    
+    state0 = _mm_add_epi32(state0, init0);
+    state1 = _mm_add_epi32(state1, init1);
+    unpack_state(state0, state1);
+    
+    // Слова состояния -> хеш (big-endian)
+    Hash256 result;
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(result.data()), _mm_shuffle_epi8(state0, bswap_mask));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(result.data() + 16), _mm_shuffle_epi8(state1, bswap_mask));
+    return result;
+}
+
+// =============================================================================
+// SHA256d независимых 64-байтных сообщений (чередование)
+// =============================================================================
+
+namespace {
+
+/// @brief Сообщений, обрабатываемых одновременно
+constexpr std::size_t MAX_LANES = 4;
+
+/**
+ * @brief SHA256_INIT в раскладке ABEF / CDGH
+ */
+inline void init_state(__m128i& state0, __m128i& state1) noexcept {
+    const auto& H = constants::SHA256_INIT;
+    state0 = _mm_set_epi32(static_cast<int>(H[0]), static_cast<int>(H[1]),
+                           static_cast<int>(H[4]), static_cast<int>(H[5]));
+    state1 = _mm_set_epi32(static_cast<int>(H[2]), static_cast<int>(H[3]),
+                           static_cast<int>(H[6]), static_cast<int>(H[7]));
+}
+
+/**
+ * @brief Четыре раунда всех сообщений с K + W каждого
+ * 
+ * Сначала первая пара раундов всех сообщений, затем вторая: пока
+ * sha256rnds2 одного сообщения ждёт результат, выполняются остальные.
+ */
+template<std::size_t N>
+inline void rounds4_lanes(__m128i (&state0)[N], __m128i (&state1)[N], const __m128i (&kw)[N]) noexcept {
+    for (std::size_t l = 0; l < N; ++l) {
+        state1[l] = _mm_sha256rnds2_epu32(state1[l], state0[l], kw[l]);
+    }
+    for (std::size_t l = 0; l < N; ++l) {
+        state0[l] = _mm_sha256rnds2_epu32(state0[l], state1[l], _mm_shuffle_epi32(kw[l], 0x0E));
+    }
+}
+
+/**
+ * @brief Группа G (раунды 4G..4G+3) и расписание W[4G+16..4G+19]
+ * 
+ * msg[l][G % 4] на входе содержит W[4G..4G+3] сообщения l.
+ */
+template<std::size_t G, std::size_t N>
+inline void group_lanes(__m128i (&state0)[N], __m128i (&state1)[N], __m128i (&msg)[N][4]) noexcept {
+    const __m128i k = _mm_load_si128(reinterpret_cast<const __m128i*>(K256 + 4 * G));
+    __m128i kw[N];
+    for (std::size_t l = 0; l < N; ++l) {
+        kw[l] = _mm_add_epi32(msg[l][G % 4], k);
+    }
+    rounds4_lanes(state0, state1, kw);
+    
+    if constexpr (G < 12) {
+        for (std::size_t l = 0; l < N; ++l) {
+            __m128i next = _mm_sha256msg1_epu32(msg[l][G % 4], msg[l][(G + 1) % 4]);
+            next = _mm_add_epi32(next, _mm_alignr_epi8(msg[l][(G + 3) % 4], msg[l][(G + 2) % 4], 4));
+            msg[l][G % 4] = _mm_sha256msg2_epu32(next, msg[l][(G + 3) % 4]);
+        }
+    }
+}
+
+/**
+ * @brief 64 раунда N независимых блоков (без сложения с исходным состоянием)
+ */
+template<std::size_t N>
+inline void transform_lanes(__m128i (&state0)[N], __m128i (&state1)[N], __m128i (&msg)[N][4]) noexcept {
+    [&]<std::size_t... G>(std::index_sequence<G...>) {
+        (group_lanes<G>(state0, state1, msg), ...);
+    }(std::make_index_sequence<16>{});
+}
+
+/**
+ * @brief 64 раунда блока padding 64-байтного сообщения (K + W постоянны)
+ */
+template<std::size_t N>
+inline void padding_block_lanes(__m128i (&state0)[N], __m128i (&state1)[N]) noexcept {
+    for (std::size_t g = 0; g < 16; ++g) {
+        const __m128i k = load_kw(precomputed::BLOCK64_PAD_KW.data() + 4 * g);
+        __m128i kw[N];
+        for (std::size_t l = 0; l < N; ++l) {
+            kw[l] = k;
+        }
+        rounds4_lanes(state0, state1, kw);
+    }
+}
+
+/**
+ * @brief SHA256d N сообщений по 64 байта
+ */
+template<std::size_t N>
+void sha256d64_lanes(Hash256* out, const uint8_t* in) noexcept {
+    using namespace precomputed;
+    const __m128i bswap_mask = _mm_load_si128(reinterpret_cast<const __m128i*>(BSWAP_MASK));
+    __m128i init0;
+    __m128i init1;
+    init_state(init0, init1);
+    
+    __m128i state0[N];
+    __m128i state1[N];
+    __m128i msg[N][4];
+    
+    // === Первый SHA256: блок данных ===
+    for (std::size_t l = 0; l < N; ++l) {
+        state0[l] = init0;
+        state1[l] = init1;
+        for (std::size_t j = 0; j < 4; ++j) {
+            msg[l][j] = _mm_shuffle_epi8(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 64 * l + 16 * j)), bswap_mask);
+        }
+    }
+    transform_lanes(state0, state1, msg);
+    
+    // === Первый SHA256: блок padding ===
+    __m128i save0[N];
+    __m128i save1[N];
+    for (std::size_t l = 0; l < N; ++l) {
+        state0[l] = _mm_add_epi32(state0[l], init0);
+        state1[l] = _mm_add_epi32(state1[l], init1);
+        save0[l] = state0[l];
+        save1[l] = state1[l];
+    }
+    padding_block_lanes(state0, state1);
+    
+    // === Второй SHA256: W0..W7 - первый хеш, W8 = PAD, W15 = 256 ===
+    for (std::size_t l = 0; l < N; ++l) {
+        state0[l] = _mm_add_epi32(state0[l], save0[l]);
+        state1[l] = _mm_add_epi32(state1[l], save1[l]);
+        unpack_state(state0[l], state1[l]);
+        msg[l][0] = state0[l];
+        msg[l][1] = state1[l];
+        msg[l][2] = _mm_set_epi32(0, 0, 0, static_cast<int>(PAD_WORD));
+        msg[l][3] = _mm_set_epi32(static_cast<int>(HASH_BITS), 0, 0, 0);
+        state0[l] = init0;
+        state1[l] = init1;
+    }
+    transform_lanes(state0, state1, msg);
+    
+    for (std::size_t l = 0; l < N; ++l) {
+        state0[l] = _mm_add_epi32(state0[l], init0);
+        state1[l] = _mm_add_epi32(state1[l], init1);
+        unpack_state(state0[l], state1[l]);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out[l].data()), _mm_shuffle_epi8(state0[l], bswap_mask));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out[l].data() + 16), _mm_shuffle_epi8(state1[l], bswap_mask));
+    }
+}
+
+} // anonymous namespace
+
+/**
+ * @brief SHA256d подряд идущих 64-байтных сообщений
+ * 
+ * По MAX_LANES сообщений одновременно, остаток - по два и по одному.
+ * 
+ * @param out Выходные хеши (count штук)
+ * @param in Сообщения (64 * count байт)
+ * @param count Количество сообщений
+ */
+void sha256d64(Hash256* out, const uint8_t* in, std::size_t count) noexcept {
+    core::PmuScope pmu(core::PmuRegion::Sha256ShaNi, count);
+    clear_upper_state();
+    
+    std::size_t i = 0;
+    for (; i + MAX_LANES <= count; i += MAX_LANES) {
+        sha256d64_lanes<MAX_LANES>(out + i, in + 64 * i);
+    }
+    if (i + 2 <= count) {
+        sha256d64_lanes<2>(out + i, in + 64 * i);
+        i += 2;
+    }
+    if (i < count) {
+        sha256d64_lanes<1>(out + i, in + 64 * i);
+    }
+}
+
 } // namespace quaxis::crypto::shani
 
 #endif // QUAXIS_HAS_SHANI
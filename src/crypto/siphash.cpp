@@ -0,0 +1,78 @@
+/**
+ * @file siphash.cpp
+ * @brief Реализация SipHash-2-4
+ */
+
+#include "siphash.hpp"
+
+#include <bit>
+
+namespace quaxis::crypto {
+
+namespace {
+
+/**
+ * @brief Состояние SipHash (v0..v3)
+ */
+struct SipState {
+    uint64_t v0;
+    uint64_t v1;
+    uint64_t v2;
+    uint64_t v3;
+    
+    void round() noexcept {
+        v0 += v1; v1 = std::rotl(v1, 13); v1 ^= v0; v0 = std::rotl(v0, 32);
+        v2 += v3; v3 = std::rotl(v3, 16); v3 ^= v2;
+        v0 += v3; v3 = std::rotl(v3, 21); v3 ^= v0;
+        v2 += v1; v1 = std::rotl(v1, 17); v1 ^= v2; v2 = std::rotl(v2, 32);
+    }
+    
+    void compress(uint64_t word) noexcept {
+        v3 ^= word;
+        round();
+        round();
+        v0 ^= word;
+    }
+};
+
+/// @brief 8 байт little-endian
+[[nodiscard]] uint64_t load_le64(const uint8_t* data) noexcept {
+    uint64_t value = 0;
+    for (int i = 7; i >= 0; --i) {
+        value = (value << 8) | data[i];
+    }
+    return value;
+}
+
+} // anonymous namespace
+
+uint64_t siphash24(uint64_t k0, uint64_t k1, ByteSpan data) noexcept {
+    SipState state{
+        0x736f6d6570736575ULL ^ k0,
+        0x646f72616e646f6dULL ^ k1,
+        0x6c7967656e657261ULL ^ k0,
+        0x7465646279746573ULL ^ k1,
+    };
+    
+    const std::size_t words = data.size() / 8;
+    for (std::size_t i = 0; i < words; ++i) {
+        state.compress(load_le64(data.data() + i * 8));
+    }
+    
+    // Хвост и длина в старшем байте последнего слова
+    uint64_t last = static_cast<uint64_t>(data.size() & 0xFF) << 56;
+    const std::size_t tail = data.size() - words * 8;
+    for (std::size_t i = 0; i < tail; ++i) {
+        last |= static_cast<uint64_t>(data[words * 8 + i]) << (8 * i);
+    }
+    state.compress(last);
+    
+    state.v2 ^= 0xFF;
+    state.round();
+    state.round();
+    state.round();
+    state.round();
+    return state.v0 ^ state.v1 ^ state.v2 ^ state.v3;
+}
+
+} // namespace quaxis::crypto
@@ -0,0 +1,28 @@
+/**
+ * @file siphash.hpp
+ * @brief SipHash-2-4 (short id компактных блоков BIP152)
+ *
+ * 64-битная ключевая PRF: 2 раунда сжатия на 8-байтное слово и 4
+ * финальных. В FIBRE relay ключ выводится из заголовка блока и nonce
+ * отправителя, хешируется wtxid транзакции (см. relay/compact_block.hpp).
+ */
+
+#pragma once
+
+#include "../core/types.hpp"
+
+#include <cstdint>
+
+namespace quaxis::crypto {
+
+/**
+ * @brief SipHash-2-4 данных произвольной длины
+ *
+ * @param k0 Первая половина 128-битного ключа (little-endian байты 0..7)
+ * @param k1 Вторая половина ключа (байты 8..15)
+ * @param data Входные данные
+ * @return 64-битный хеш
+ */
+[[nodiscard]] uint64_t siphash24(uint64_t k0, uint64_t k1, ByteSpan data) noexcept;
+
+} // namespace quaxis::crypto
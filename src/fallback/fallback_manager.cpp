@@ -4,8 +4,13 @@
  */
 
 #include "fallback_manager.hpp"
+#include "../core/async_log.hpp"
+#include "../core/clock.hpp"
+#include "../core/seqlock.hpp"
 
-#include <iostream>
+#include <algorithm>
+#include <array>
+#include <condition_variable>
 
 namespace quaxis::fallback {
 
@@ -28,10 +33,15 @@ struct FallbackManager::Impl {
     
     // Статистика
     FallbackStats stats;
+    core::Seqlock<FallbackStats> stats_snapshot;  ///< Копия для get_stats() без mutex
+    std::mutex stats_mutex;                      ///< Сериализует писателей stats
     std::chrono::steady_clock::time_point fallback_started;
     
     // Stratum клиент
-    std::unique_ptr<StratumClient> stratum_client;
+    std::unique_ptr<IStratumClient> stratum_client;
+    
+    // config.parallel_pools: все пулы сразу вместо stratum_client
+    std::unique_ptr<StratumPoolSet> pool_set;
     
     // Health check функции
     ShmHealthCheck shm_check;
@@ -43,6 +53,10 @@ struct FallbackManager::Impl {
     // Поток мониторинга
     std::thread monitor_thread;
     
+    // config.hot_standby: поток, держащий Stratum подключённым
+    std::thread standby_thread;
+    std::condition_variable standby_cv;
+    
     // Мьютекс
     mutable std::mutex mutex;
     
@@ -54,159 +68,331 @@ struct FallbackManager::Impl {
         stratum_health.last_check = now;
         
         // Создание Stratum клиента если настроен
-        if (!config.stratum_pools.empty()) {
+        if (config.parallel_pools && !config.stratum_pools.empty()) {
+            pool_set = std::make_unique<StratumPoolSet>(
+                config.stratum_pools, config.timeouts.reconnect_delay);
+            if (pool_set->size() == 0) {
+                pool_set.reset();
+            }
+        } else if (!config.stratum_pools.empty()) {
             const auto* pool = config.get_active_pool();
             if (pool) {
-                stratum_client = std::make_unique<StratumClient>(*pool);
+                stratum_client = make_stratum_client(*pool);
             }
         }
     }
     
-    void monitor_loop() {
-        while (running) {
-            check_health();
-            
-            // Спим интервал проверки
-            std::this_thread::sleep_for(config.timeouts.primary_health_check);
+    /**
+     * @brief Ожидание мониторинга: события будят поток раньше срока
+     *
+     * Под mutex, как и здоровье источников.
+     */
+    std::condition_variable wake_cv;
+    bool wake_pending{false};
+    
+    /// @brief До какого момента спит поток мониторинга
+    std::chrono::steady_clock::time_point armed_deadline{std::chrono::steady_clock::time_point::max()};
+    
+    /// @brief Ошибка источника (signal_source_failure) до следующего задания от него
+    std::array<bool, 3> failure_signalled{};
+    
+    /// @brief С какого момента тишина источника считается (старт, переключение на него)
+    std::array<std::chrono::steady_clock::time_point, 3> watch_since{};
+    
+    [[nodiscard]] static std::size_t index_of(FallbackMode source) noexcept {
+        return static_cast<std::size_t>(to_mode_value(source));
+    }
+    
+    [[nodiscard]] SourceHealth& health_of(FallbackMode source) noexcept {
+        switch (source) {
+            case FallbackMode::FallbackZMQ:     return zmq_health;
+            case FallbackMode::FallbackStratum: return stratum_health;
+            default:                            return shm_health;
         }
     }
     
-    void check_health() {
-        auto now = std::chrono::steady_clock::now();
+    [[nodiscard]] const SourceHealth& health_of(FallbackMode source) const noexcept {
+        return const_cast<Impl*>(this)->health_of(source);
+    }
+    
+    /**
+     * @brief Момент, после которого источник считается замолчавшим
+     *
+     * std::nullopt, если интервал заданий ещё не известен или
+     * отслеживание тишины выключено. Вызывать под mutex.
+     */
+    [[nodiscard]] std::optional<std::chrono::steady_clock::time_point> silence_deadline(
+        FallbackMode source
+    ) const {
+        const auto& health = health_of(source);
+        if (config.timeouts.job_silence_factor == 0 || health.expected_job_interval.count() == 0) {
+            return std::nullopt;
+        }
         
-        // Проверка SHM
-        {
-            std::lock_guard<std::mutex> lock(mutex);
-            shm_health.last_check = now;
-            shm_health.total_checks++;
+        auto quiet = std::max(
+            config.timeouts.primary_timeout,
+            health.expected_job_interval * config.timeouts.job_silence_factor
+        );
+        return std::max(health.last_job_received, watch_since[index_of(source)]) + quiet;
+    }
+    
+    /// @brief Источник молчит дольше срока (под mutex)
+    [[nodiscard]] bool is_quiet(FallbackMode source, std::chrono::steady_clock::time_point now) const {
+        auto deadline = silence_deadline(source);
+        return deadline && now >= *deadline;
+    }
+    
+    /// @brief Разбудить поток мониторинга (под mutex)
+    void wake_locked() {
+        wake_pending = true;
+        wake_cv.notify_one();
+    }
+    
+    void monitor_loop() {
+        auto next_check = std::chrono::steady_clock::now();
+        
+        std::unique_lock<std::mutex> lock(mutex);
+        while (running) {
+            // Ближайший срок: проверка здоровья или тишина доступного источника
+            auto deadline = next_check;
+            auto current = mode.load();
+            for (auto source : {FallbackMode::PrimarySHM, current}) {
+                auto silence = silence_deadline(source);
+                if (silence && health_of(source).available) {
+                    deadline = std::min(deadline, *silence);
+                }
+            }
             
-            bool available = shm_check ? shm_check() : false;
+            armed_deadline = deadline;
+            wake_cv.wait_until(lock, deadline, [this] { return wake_pending || !running; });
+            wake_pending = false;
+            armed_deadline = std::chrono::steady_clock::time_point::max();
+            if (!running) {
+                break;
+            }
             
-            if (available) {
-                shm_health.available = true;
-                shm_health.last_success = now;
-                shm_health.consecutive_failures = 0;
-                shm_health.successful_checks++;
-            } else {
-                shm_health.consecutive_failures++;
-                
-                // Если превышен таймаут, считаем недоступным
-                auto since_last_success = std::chrono::duration_cast<std::chrono::milliseconds>(
-                    now - shm_health.last_success
-                );
-                if (since_last_success > config.timeouts.primary_timeout) {
-                    shm_health.available = false;
-                }
+            const auto now = std::chrono::steady_clock::now();
+            const bool poll = now >= next_check;
+            if (poll) {
+                next_check = now + config.timeouts.primary_health_check;
             }
+            
+            lock.unlock();
+            check_health(poll);
+            lock.lock();
         }
+    }
+    
+    /**
+     * @brief Учесть результат проверки источника (под mutex)
+     *
+     * @param grace Недоступен только после primary_timeout неудач подряд
+     */
+    void record_check(FallbackMode source, bool ok, std::chrono::steady_clock::time_point now, bool grace) {
+        auto& health = health_of(source);
+        health.last_check = now;
+        health.total_checks++;
         
-        // Проверка ZMQ
-        if (config.zmq.enabled) {
-            std::lock_guard<std::mutex> lock(mutex);
-            zmq_health.last_check = now;
-            zmq_health.total_checks++;
-            
-            bool available = zmq_check ? zmq_check() : false;
+        if (ok) {
+            // Проверка не отменяет ни ошибку, ни тишину заданий
+            health.available = !failure_signalled[index_of(source)] && !is_quiet(source, now);
+            health.last_success = now;
+            health.consecutive_failures = 0;
+            health.successful_checks++;
+        } else {
+            health.consecutive_failures++;
             
-            if (available) {
-                zmq_health.available = true;
-                zmq_health.last_success = now;
-                zmq_health.consecutive_failures = 0;
-                zmq_health.successful_checks++;
-            } else {
-                zmq_health.consecutive_failures++;
-                zmq_health.available = false;
+            // Если превышен таймаут, считаем недоступным
+            auto since_last_success = std::chrono::duration_cast<std::chrono::milliseconds>(
+                now - health.last_success
+            );
+            if (!grace || since_last_success > config.timeouts.primary_timeout) {
+                health.available = false;
             }
         }
+    }
+    
+    /**
+     * @brief Проверить источники и переключиться при необходимости
+     *
+     * @param poll Вызвать проверки здоровья; без него учитываются только
+     *             тишина заданий и ошибки, о которых сообщили
+     */
+    void check_health(bool poll = true) {
+        auto now = std::chrono::steady_clock::now();
+        auto current = mode.load();
+        bool shm_available = false;
+        bool zmq_available = false;
+        bool stratum_available = false;
         
-        // Проверка Stratum
-        if (stratum_client) {
+        {
             std::lock_guard<std::mutex> lock(mutex);
-            stratum_health.last_check = now;
-            stratum_health.total_checks++;
             
-            if (stratum_client->is_connected()) {
-                stratum_health.available = true;
-                stratum_health.last_success = now;
-                stratum_health.consecutive_failures = 0;
-                stratum_health.successful_checks++;
-            } else {
-                stratum_health.consecutive_failures++;
-                stratum_health.available = false;
+            if (poll) {
+                record_check(FallbackMode::PrimarySHM, shm_check ? shm_check() : false, now, true);
+                if (config.zmq.enabled) {
+                    record_check(FallbackMode::FallbackZMQ, zmq_check ? zmq_check() : false, now, false);
+                }
+                if (has_stratum()) {
+                    record_check(FallbackMode::FallbackStratum, stratum_connected(), now, false);
+                }
             }
+            
+            // Тишина primary и текущего источника - без ожидания проверки
+            for (auto source : {FallbackMode::PrimarySHM, current}) {
+                if (is_quiet(source, now)) {
+                    health_of(source).available = false;
+                }
+            }
+            
+            shm_available = shm_health.available;
+            zmq_available = zmq_health.available;
+            stratum_available = stratum_health.available;
         }
         
         // Логика переключения
-        auto current = mode.load();
-        
         if (current == FallbackMode::PrimarySHM) {
             // Если primary недоступен, переключаемся
-            if (!shm_health.available) {
+            if (!shm_available) {
                 switch_to_best_fallback();
             }
         } else {
             // Если мы в fallback, пытаемся вернуться к primary
-            if (shm_health.available) {
+            if (shm_available) {
                 restore_primary();
-            } else if (current == FallbackMode::FallbackZMQ && !zmq_health.available) {
+            } else if (current == FallbackMode::FallbackZMQ && !zmq_available) {
                 // ZMQ тоже умер, переключаемся на Stratum
                 switch_to_stratum();
+            } else if (current == FallbackMode::FallbackStratum && !stratum_available && zmq_available) {
+                // Stratum оборвался, а ZMQ снова жив
+                switch_to_best_fallback();
+            }
+        }
+    }
+    
+    /**
+     * @brief Держать Stratum пул подключённым (config.hot_standby)
+     *
+     * Подключение и handshake идут здесь, а не на пути переключения:
+     * поток мониторинга не блокируется на недоступном пуле.
+     */
+    void standby_loop() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (running) {
+            lock.unlock();
+            if (!stratum_client->is_connected()) {
+                auto result = stratum_client->connect();
+                if (!result) {
+                    QUAXIS_LOG_RATE(Warning, 1, "[FallbackManager] Hot standby Stratum: {}", result.error().message);
+                }
             }
+            lock.lock();
+            
+            standby_cv.wait_for(lock, config.timeouts.reconnect_delay, [this] { return !running; });
         }
     }
     
+    /// @brief Настроен ли Stratum (один пул или набор пулов)
+    [[nodiscard]] bool has_stratum() const noexcept {
+        return stratum_client || pool_set;
+    }
+    
+    /// @brief Подключён ли Stratum; у набора - хотя бы один пул
+    [[nodiscard]] bool stratum_connected() const noexcept {
+        if (pool_set) {
+            return pool_set->is_connected();
+        }
+        return stratum_client && stratum_client->is_connected();
+    }
+    
+    /**
+     * @brief Подключён ли Stratum; без hot standby - подключиться
+     *
+     * В hot standby подключает только standby_loop, набор пулов - свои
+     * потоки: переход на пул, который ещё не подключился, откладывается
+     * до следующей проверки.
+     */
+    bool ensure_stratum_connected() {
+        if (stratum_connected()) {
+            return true;
+        }
+        if (config.hot_standby || pool_set) {
+            return false;
+        }
+        
+        auto result = stratum_client->connect();
+        if (!result) {
+            QUAXIS_LOG_RATE(Warning, 1, "[FallbackManager] Не удалось подключиться к Stratum: {}", result.error().message);
+            return false;
+        }
+        return true;
+    }
+    
+    /// @brief Тишина нового источника считается с момента переключения
+    void start_watching(FallbackMode source) {
+        std::lock_guard<std::mutex> lock(mutex);
+        watch_since[index_of(source)] = std::chrono::steady_clock::now();
+    }
+    
+    /**
+     * @brief Изменить статистику и опубликовать снимок
+     *
+     * Переключения идут и из потока мониторинга, и из публичного API.
+     */
+    template<typename F>
+    void update_stats(F&& update) {
+        std::lock_guard<std::mutex> lock(stats_mutex);
+        update(stats);
+        stats_snapshot.store(stats);
+    }
+    
     void switch_to_best_fallback() {
         auto old_mode = mode.load();
         
         // Пробуем ZMQ первым
         if (config.zmq.enabled && zmq_health.available) {
             mode = FallbackMode::FallbackZMQ;
-            stats.zmq_switches++;
-        } else if (stratum_client) {
-            // Пробуем подключиться к Stratum
-            if (!stratum_client->is_connected()) {
-                auto result = stratum_client->connect();
-                if (result) {
-                    stratum_health.available = true;
-                    stratum_health.last_success = std::chrono::steady_clock::now();
-                }
+            update_stats([](FallbackStats& s) { s.zmq_switches++; });
+        } else if (has_stratum()) {
+            // Пробуем подключиться к Stratum (в hot standby уже подключён)
+            bool was_connected = stratum_connected();
+            if (ensure_stratum_connected() && !was_connected) {
+                std::lock_guard<std::mutex> lock(mutex);
+                stratum_health.available = true;
+                stratum_health.last_success = std::chrono::steady_clock::now();
             }
             
-            if (stratum_client->is_connected()) {
+            if (stratum_connected()) {
                 mode = FallbackMode::FallbackStratum;
-                stats.stratum_switches++;
+                update_stats([](FallbackStats& s) { s.stratum_switches++; });
             }
         }
         
         auto new_mode = mode.load();
         if (new_mode != old_mode) {
             fallback_started = std::chrono::steady_clock::now();
+            start_watching(new_mode);
             
             if (mode_change_callback) {
                 mode_change_callback(old_mode, new_mode);
             }
             
-            std::cerr << "[FallbackManager] Переключение: " 
-                      << to_string(old_mode) << " -> " << to_string(new_mode) << std::endl;
+            QUAXIS_LOG(Warning, "[FallbackManager] Переключение: {} -> {}", to_string(old_mode), to_string(new_mode));
         }
     }
     
     void switch_to_stratum() {
-        if (!stratum_client) return;
+        if (!has_stratum()) return;
         
         auto old_mode = mode.load();
         
-        if (!stratum_client->is_connected()) {
-            auto result = stratum_client->connect();
-            if (!result) {
-                std::cerr << "[FallbackManager] Не удалось подключиться к Stratum: " 
-                          << result.error().message << std::endl;
-                return;
-            }
+        if (!ensure_stratum_connected()) {
+            return;
         }
         
         mode = FallbackMode::FallbackStratum;
-        stats.stratum_switches++;
+        update_stats([](FallbackStats& s) { s.stratum_switches++; });
+        start_watching(FallbackMode::FallbackStratum);
         
         if (mode_change_callback && old_mode != FallbackMode::FallbackStratum) {
             mode_change_callback(old_mode, FallbackMode::FallbackStratum);
@@ -219,17 +405,19 @@ struct FallbackManager::Impl {
         if (old_mode == FallbackMode::PrimarySHM) return;
         
         mode = FallbackMode::PrimarySHM;
-        stats.primary_restorations++;
         
         // Обновляем статистику времени в fallback
         auto now = std::chrono::steady_clock::now();
         auto duration = std::chrono::duration_cast<std::chrono::seconds>(
             now - fallback_started
         );
-        stats.fallback_duration_seconds += static_cast<uint64_t>(duration.count());
+        update_stats([&](FallbackStats& s) {
+            s.primary_restorations++;
+            s.fallback_duration_seconds += static_cast<uint64_t>(duration.count());
+        });
         
-        // Отключаем Stratum если был подключён
-        if (stratum_client && stratum_client->is_connected()) {
+        // Отключаем Stratum если был подключён (hot standby держит его)
+        if (!config.hot_standby && stratum_client && stratum_client->is_connected()) {
             stratum_client->disconnect();
         }
         
@@ -237,7 +425,7 @@ struct FallbackManager::Impl {
             mode_change_callback(old_mode, FallbackMode::PrimarySHM);
         }
         
-        std::cerr << "[FallbackManager] Восстановление primary SHM" << std::endl;
+        QUAXIS_LOG(Info, "[FallbackManager] Восстановление primary SHM");
     }
 };
 
@@ -258,24 +446,49 @@ void FallbackManager::start() {
     impl_->running = true;
     
     // Инициализируем здоровье SHM как доступное
-    impl_->shm_health.available = true;
-    impl_->shm_health.last_success = std::chrono::steady_clock::now();
+    {
+        std::lock_guard<std::mutex> lock(impl_->mutex);
+        auto now = std::chrono::steady_clock::now();
+        impl_->shm_health.available = true;
+        impl_->shm_health.last_success = now;
+        impl_->watch_since[Impl::index_of(FallbackMode::PrimarySHM)] = now;
+    }
     
     impl_->monitor_thread = std::thread([this]() {
         impl_->monitor_loop();
     });
+    
+    if (impl_->config.hot_standby && impl_->stratum_client) {
+        impl_->standby_thread = std::thread([this]() {
+            impl_->standby_loop();
+        });
+    }
+    if (impl_->pool_set) {
+        impl_->pool_set->start();
+    }
 }
 
 void FallbackManager::stop() {
-    impl_->running = false;
+    {
+        std::lock_guard<std::mutex> lock(impl_->mutex);
+        impl_->running = false;
+    }
+    impl_->wake_cv.notify_all();
+    impl_->standby_cv.notify_all();
     
     if (impl_->monitor_thread.joinable()) {
         impl_->monitor_thread.join();
     }
+    if (impl_->standby_thread.joinable()) {
+        impl_->standby_thread.join();
+    }
     
     if (impl_->stratum_client) {
         impl_->stratum_client->disconnect();
     }
+    if (impl_->pool_set) {
+        impl_->pool_set->stop();
+    }
 }
 
 bool FallbackManager::is_running() const noexcept {
@@ -295,27 +508,54 @@ void FallbackManager::check_primary_health() {
 }
 
 void FallbackManager::signal_job_received() {
-    auto now = std::chrono::steady_clock::now();
+    signal_job_received(impl_->mode.load());
+}
+
+void FallbackManager::signal_job_received(FallbackMode source) {
+    // На каждое задание: грубых часов достаточно для интервалов в секунды
+    auto now = core::CoarseClock::now();
     
     std::lock_guard<std::mutex> lock(impl_->mutex);
+    auto& health = impl_->health_of(source);
     
-    switch (impl_->mode.load()) {
-        case FallbackMode::PrimarySHM:
-            impl_->shm_health.last_job_received = now;
-            impl_->shm_health.last_success = now;
-            impl_->shm_health.consecutive_failures = 0;
-            impl_->shm_health.available = true;
-            break;
-            
-        case FallbackMode::FallbackZMQ:
-            impl_->zmq_health.last_job_received = now;
-            impl_->zmq_health.last_success = now;
-            break;
-            
-        case FallbackMode::FallbackStratum:
-            impl_->stratum_health.last_job_received = now;
-            impl_->stratum_health.last_success = now;
-            break;
+    // Интервал заданий - только по непрерывной работе источника
+    if (health.available && health.last_job_received != std::chrono::steady_clock::time_point{}) {
+        auto interval = std::chrono::duration_cast<std::chrono::milliseconds>(now - health.last_job_received);
+        health.expected_job_interval = health.expected_job_interval.count() == 0
+            ? interval
+            : (health.expected_job_interval * 7 + interval) / 8;
+    }
+    
+    bool was_available = health.available;
+    health.last_job_received = now;
+    health.last_success = now;
+    health.consecutive_failures = 0;
+    health.available = true;
+    impl_->failure_signalled[Impl::index_of(source)] = false;
+    
+    // Primary снова даёт задания - возврат без ожидания проверки
+    if (source == FallbackMode::PrimarySHM && !was_available &&
+        impl_->mode.load() != FallbackMode::PrimarySHM) {
+        impl_->wake_locked();
+        return;
+    }
+    
+    // Интервал впервые известен или сократился: срок тишины раньше назначенного
+    auto silence = impl_->silence_deadline(source);
+    if (silence && *silence < impl_->armed_deadline) {
+        impl_->wake_locked();
+    }
+}
+
+void FallbackManager::signal_source_failure(FallbackMode source) {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    auto& health = impl_->health_of(source);
+    health.available = false;
+    health.consecutive_failures++;
+    impl_->failure_signalled[Impl::index_of(source)] = true;
+    
+    if (source == impl_->mode.load()) {
+        impl_->wake_locked();
     }
 }
 
@@ -359,20 +599,27 @@ SourceHealth FallbackManager::get_stratum_health() const {
 }
 
 FallbackStats FallbackManager::get_stats() const {
-    std::lock_guard<std::mutex> lock(impl_->mutex);
-    return impl_->stats;
+    return impl_->stats_snapshot.load();
 }
 
 bool FallbackManager::is_stratum_connected() const {
-    if (!impl_->stratum_client) return false;
-    return impl_->stratum_client->is_connected();
+    return impl_->stratum_connected();
 }
 
-StratumClient* FallbackManager::get_stratum_client() {
+IStratumClient* FallbackManager::get_stratum_client() {
     return impl_->stratum_client.get();
 }
 
+StratumPoolSet* FallbackManager::get_stratum_pool_set() {
+    return impl_->pool_set.get();
+}
+
 std::optional<StratumJob> FallbackManager::get_stratum_job() const {
+    if (impl_->pool_set) {
+        auto current = impl_->pool_set->current_job();
+        if (!current) return std::nullopt;
+        return current->job;
+    }
     if (!impl_->stratum_client) return std::nullopt;
     return impl_->stratum_client->get_current_job();
 }
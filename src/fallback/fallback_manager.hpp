@@ -6,6 +6,12 @@
  * - Приоритет: SHM → ZMQ → Stratum Pool
  * - Автоматическое переключение при недоступности
  * - Автоматический возврат к основному источнику
+ * 
+ * Переключение - по событиям, а не по таймеру опроса: поток мониторинга
+ * спит до ближайшего срока (следующая проверка здоровья или момент, когда
+ * источник молчит дольше job_silence_factor ожидаемых интервалов заданий)
+ * и просыпается сразу по signal_source_failure() или по заданию primary
+ * в fallback режиме.
  */
 
 #pragma once
@@ -13,6 +19,7 @@
 #include "../core/types.hpp"
 #include "pool_config.hpp"
 #include "stratum_client.hpp"
+#include "stratum_pool_set.hpp"
 
 #include <atomic>
 #include <chrono>
@@ -83,6 +90,9 @@ struct SourceHealth {
     /// @brief Время последнего полученного задания
     std::chrono::steady_clock::time_point last_job_received;
     
+    /// @brief Ожидаемый интервал между заданиями (0 - ещё не известен)
+    std::chrono::milliseconds expected_job_interval{0};
+    
     /// @brief Общее количество проверок
     uint64_t total_checks{0};
     
@@ -196,6 +206,23 @@ public:
      */
     void signal_job_received();
     
+    /**
+     * @brief Сигнализировать о получении задания от указанного источника
+     * 
+     * Обновляет ожидаемый интервал заданий источника и отодвигает срок
+     * его тишины. Задание primary в fallback режиме сразу будит поток
+     * мониторинга для возврата.
+     */
+    void signal_job_received(FallbackMode source);
+    
+    /**
+     * @brief Сигнализировать об ошибке источника (ошибка сокета, останов SHM)
+     * 
+     * Источник недоступен до следующего задания от него; если это текущий
+     * источник, переключение происходит сразу, не дожидаясь проверки.
+     */
+    void signal_source_failure(FallbackMode source);
+    
     // ==========================================================================
     // Переключение
     // ==========================================================================
@@ -257,8 +284,16 @@ public:
     
     /**
      * @brief Получить Stratum клиент (если активен)
+     *
+     * V1 или V2 - по StratumPoolConfig::protocol активного пула.
+     * С config.parallel_pools - nullptr, пулы в get_stratum_pool_set().
+     */
+    [[nodiscard]] IStratumClient* get_stratum_client();
+    
+    /**
+     * @brief Получить набор параллельных пулов (config.parallel_pools)
      */
-    [[nodiscard]] StratumClient* get_stratum_client();
+    [[nodiscard]] StratumPoolSet* get_stratum_pool_set();
     
     /**
      * @brief Получить текущее задание от Stratum (если есть)
@@ -11,17 +11,18 @@
 namespace quaxis::fallback {
 
 bool StratumPoolConfig::parse_url(const std::string& pool_url) {
-    // Формат: stratum+tcp://host:port или tcp://host:port
+    // Формат: stratum+tcp://host:port, stratum2+tcp://host:port или tcp://host:port
     // Регулярное выражение для парсинга URL
     static const std::regex url_regex(
-        R"((?:stratum\+)?(?:tcp|ssl)://([^:]+):(\d+))",
+        R"((?:stratum(2)?\+)?(?:tcp|ssl)://([^:]+):(\d+))",
         std::regex::icase
     );
     
     std::smatch match;
     if (std::regex_match(pool_url, match, url_regex)) {
-        host = match[1].str();
-        port = static_cast<uint16_t>(std::stoi(match[2].str()));
+        protocol = match[1].matched ? StratumProtocol::V2 : StratumProtocol::V1;
+        host = match[2].str();
+        port = static_cast<uint16_t>(std::stoi(match[3].str()));
         url = pool_url;
         return true;
     }
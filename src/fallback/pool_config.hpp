@@ -18,6 +18,14 @@ namespace quaxis::fallback {
 // Конфигурация Stratum пула
 // =============================================================================
 
+/**
+ * @brief Версия протокола Stratum
+ */
+enum class StratumProtocol : uint8_t {
+    V1,     ///< JSON по строкам (stratum+tcp://)
+    V2      ///< Бинарные кадры SV2, standard channel (stratum2+tcp://)
+};
+
 /**
  * @brief Конфигурация Stratum пула
  */
@@ -25,6 +33,9 @@ struct StratumPoolConfig {
     /// @brief URL пула (например, "stratum+tcp://solo.ckpool.org:3333")
     std::string url;
     
+    /// @brief Версия протокола (по схеме URL)
+    StratumProtocol protocol{StratumProtocol::V1};
+    
     /// @brief Хост
     std::string host;
     
@@ -43,10 +54,15 @@ struct StratumPoolConfig {
     /// @brief Приоритет (меньше = выше приоритет)
     uint32_t priority{100};
     
+    /// @brief Номинальный хешрейт для SV2 OpenStandardMiningChannel, H/s
+    ///
+    /// По нему пул выбирает начальный target канала.
+    float nominal_hashrate{1.0e14f};
+    
     /**
      * @brief Парсинг URL в host:port
      * 
-     * @param url URL вида "stratum+tcp://host:port"
+     * @param url URL вида "stratum+tcp://host:port" или "stratum2+tcp://host:port"
      * @return true если парсинг успешен
      */
     bool parse_url(const std::string& url);
@@ -79,8 +95,17 @@ struct TimeoutConfig {
     std::chrono::milliseconds primary_health_check{1000};
     
     /// @brief Таймаут primary источника до переключения
+    ///
+    /// Также нижняя граница тишины источника: раньше него отсутствие
+    /// заданий переключения не вызывает.
     std::chrono::milliseconds primary_timeout{5000};
     
+    /// @brief Тишина источника в ожидаемых интервалах заданий до переключения
+    ///
+    /// Интервал между заданиями источник набирает сам (скользящее среднее);
+    /// пока он не известен, тишина не отслеживается. 0 - выключено.
+    uint32_t job_silence_factor{6};
+    
     /// @brief Задержка перед повторным подключением
     std::chrono::milliseconds reconnect_delay{1000};
     
@@ -111,6 +136,20 @@ struct FallbackConfig {
     /// @brief Таймауты
     TimeoutConfig timeouts;
     
+    /// @brief Hot standby: Stratum пул подключён и подписан заранее
+    ///
+    /// Пул держится подключённым и в primary режиме (переподключение раз в
+    /// reconnect_delay), его задания копятся как готовый шаблон. Переход на
+    /// FallbackStratum не ждёт TCP и subscribe/authorize, а при возврате
+    /// к primary соединение не рвётся.
+    bool hot_standby{false};
+    
+    /// @brief Все включённые пулы подключены параллельно (StratumPoolSet)
+    ///
+    /// Для каждого нового блока майнится первое пришедшее задание, share
+    /// уходит пулу этого задания. Пулы всегда подключены, как в hot_standby.
+    bool parallel_pools{false};
+    
     /**
      * @brief Получить активный Stratum пул с наивысшим приоритетом
      * 
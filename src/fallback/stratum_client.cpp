@@ -4,6 +4,9 @@
  */
 
 #include "stratum_client.hpp"
+#include "stratum_wire.hpp"
+#include "sv2_client.hpp"
+#include "../core/serialization/json.hpp"
 
 #include <arpa/inet.h>
 #include <netdb.h>
@@ -12,9 +15,9 @@
 #include <sys/socket.h>
 #include <unistd.h>
 
+#include <array>
 #include <cstring>
 #include <sstream>
-#include <queue>
 
 namespace quaxis::fallback {
 
@@ -48,6 +51,10 @@ struct StratumClient::Impl {
     // Мьютекс для потокобезопасности
     mutable std::mutex mutex;
     
+    // Отправка: ID, очередь ответов и send идут в одном порядке
+    std::mutex send_mutex;
+    SubmitEncoder submit_encoder;
+    
     // Callbacks
     JobCallback job_callback;
     DifficultyCallback difficulty_callback;
@@ -56,16 +63,19 @@ struct StratumClient::Impl {
     // Фоновый поток для чтения
     std::thread read_thread;
     
-    // Буфер чтения
-    std::string read_buffer;
+    // Буфер чтения (используется только потоком чтения)
+    LineReader reader;
     
-    // Очередь ожидающих ответов
+    // Кольцо ожидающих ответов (под mutex); method - строковый литерал
     struct PendingRequest {
-        uint64_t id;
-        std::string method;
+        uint64_t id{0};
+        std::string_view method;
         std::chrono::steady_clock::time_point sent_at;
     };
-    std::queue<PendingRequest> pending_requests;
+    static constexpr std::size_t MAX_PENDING = 64;
+    std::array<PendingRequest, MAX_PENDING> pending_requests;
+    std::size_t pending_head{0};
+    std::size_t pending_count{0};
     
     explicit Impl(const StratumPoolConfig& cfg) : config(cfg) {}
     
@@ -75,6 +85,8 @@ struct StratumClient::Impl {
     
     void close_socket() {
         if (socket_fd >= 0) {
+            // shutdown будит recv в read_loop, одного close для этого мало
+            ::shutdown(socket_fd, SHUT_RDWR);
             ::close(socket_fd);
             socket_fd = -1;
         }
@@ -111,141 +123,149 @@ struct StratumClient::Impl {
         return true;
     }
     
-    bool send_json(const std::string& json) {
-        std::string line = json + "\n";
-        ssize_t sent = ::send(socket_fd, line.c_str(), line.size(), 0);
+    /**
+     * @brief Отправить готовую строку (с '\n') одним send
+     */
+    bool send_line(std::string_view line) {
+        ssize_t sent = ::send(socket_fd, line.data(), line.size(), MSG_NOSIGNAL);
         return sent == static_cast<ssize_t>(line.size());
     }
     
-    std::string build_subscribe() {
+    /**
+     * @brief Поставить запрос в очередь ответов (под mutex)
+     *
+     * Переполненное кольцо теряет самый старый запрос: пул на него
+     * уже не ответит.
+     */
+    void push_pending(uint64_t id, std::string_view method) {
+        if (pending_count == MAX_PENDING) {
+            pending_head = (pending_head + 1) % MAX_PENDING;
+            pending_count--;
+        }
+        pending_requests[(pending_head + pending_count) % MAX_PENDING] =
+            PendingRequest{id, method, std::chrono::steady_clock::now()};
+        pending_count++;
+    }
+    
+    /**
+     * @brief Снять самый старый запрос (под mutex)
+     */
+    [[nodiscard]] std::optional<PendingRequest> pop_pending() {
+        if (pending_count == 0) return std::nullopt;
+        auto req = pending_requests[pending_head];
+        pending_head = (pending_head + 1) % MAX_PENDING;
+        pending_count--;
+        return req;
+    }
+    
+    /**
+     * @brief Отправить запрос рукопожатия и поставить его в очередь ответов
+     */
+    bool send_request(std::string_view method, const std::string& params) {
+        std::lock_guard<std::mutex> send_lock(send_mutex);
         uint64_t id = request_id++;
         std::ostringstream ss;
-        ss << R"({"id":)" << id << R"(,"method":"mining.subscribe","params":["quaxis/1.0"]})";
-        
-        std::lock_guard<std::mutex> lock(mutex);
-        pending_requests.push({id, "mining.subscribe", std::chrono::steady_clock::now()});
+        ss << R"({"id":)" << id << R"(,"method":")" << method << R"(","params":)" << params << "}\n";
         
-        return ss.str();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            push_pending(id, method);
+        }
+        return send_line(ss.str());
     }
     
-    std::string build_authorize() {
+    bool send_subscribe() {
+        return send_request("mining.subscribe", R"(["quaxis/1.0"])");
+    }
+    
+    bool send_authorize() {
+        return send_request("mining.authorize",
+            R"([")" + config.user + R"(",")" + config.password + R"("])");
+    }
+    
+    /**
+     * @brief Отправить mining.submit по шаблону задания
+     */
+    bool send_submit(std::string_view job_id,
+                     std::string_view extranonce2,
+                     std::string_view ntime,
+                     std::string_view nonce) {
+        std::lock_guard<std::mutex> send_lock(send_mutex);
         uint64_t id = request_id++;
-        std::ostringstream ss;
-        ss << R"({"id":)" << id << R"(,"method":"mining.authorize","params":[")" 
-           << config.user << R"(",")" << config.password << R"("]})";
-        
-        std::lock_guard<std::mutex> lock(mutex);
-        pending_requests.push({id, "mining.authorize", std::chrono::steady_clock::now()});
+        auto line = submit_encoder.encode(id, config.user, job_id, extranonce2, ntime, nonce);
         
-        return ss.str();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            push_pending(id, "mining.submit");
+        }
+        return send_line(line);
     }
     
-    std::string build_submit(const std::string& job_id, 
-                             const std::string& extranonce2,
-                             const std::string& ntime,
-                             const std::string& nonce) {
-        uint64_t id = request_id++;
-        std::ostringstream ss;
-        ss << R"({"id":)" << id << R"(,"method":"mining.submit","params":[")" 
-           << config.user << R"(",")" << job_id << R"(",")" 
-           << extranonce2 << R"(",")" << ntime << R"(",")" << nonce << R"("]})";
+    /**
+     * @brief Ответ на mining.submit без разбора JSON
+     *
+     * Ответы на share - самые частые строки на пуле с низкой сложностью;
+     * результат share нам не нужен (submit уже вернул успех), достаточно
+     * снять запрос из очереди.
+     */
+    bool try_skip_submit_response(std::string_view line) {
+        if (line.find(R"("method")") != std::string_view::npos) return false;
         
         std::lock_guard<std::mutex> lock(mutex);
-        pending_requests.push({id, "mining.submit", std::chrono::steady_clock::now()});
-        
-        return ss.str();
+        if (pending_count == 0 || pending_requests[pending_head].method != "mining.submit") {
+            return false;
+        }
+        (void)pop_pending();
+        return true;
     }
     
-    void process_line(const std::string& line) {
-        // Простой парсинг JSON ответов
-        // В реальном коде стоит использовать nlohmann/json
+    void process_line(std::string_view line) {
+        if (try_skip_submit_response(line)) return;
         
-        if (line.find("\"method\"") != std::string::npos) {
+        auto doc = core::json::Value::parse(line);
+        
+        if (auto method = doc["method"].as_string()) {
             // Это уведомление от пула
-            if (line.find("mining.notify") != std::string::npos) {
-                process_notify(line);
-            } else if (line.find("mining.set_difficulty") != std::string::npos) {
-                process_set_difficulty(line);
+            if (*method == "mining.notify") {
+                process_notify(doc["params"]);
+            } else if (*method == "mining.set_difficulty") {
+                process_set_difficulty(doc["params"]);
             }
-        } else if (line.find("\"result\"") != std::string::npos) {
+        } else if (doc["result"]) {
             // Это ответ на наш запрос
-            process_response(line);
+            process_response(doc["result"]);
         }
     }
     
-    void process_notify(const std::string& line) {
-        // Парсинг mining.notify
-        // Формат: {"id":null,"method":"mining.notify","params":[...]}
+    void process_notify(const core::json::Value& params) {
+        // Формат: {"id":null,"method":"mining.notify","params":[job_id, prevhash,
+        //   coinbase1, coinbase2, [merkle_branch], version, nbits, ntime, clean_jobs]}
+        if (params.type() != core::json::Type::Array) return;
         
         StratumJob job;
         job.received_at = std::chrono::steady_clock::now();
         
-        // Извлечение параметров (упрощённый парсинг)
-        auto params_start = line.find("\"params\":");
-        if (params_start == std::string::npos) return;
-        
-        auto arr_start = line.find('[', params_start);
-        if (arr_start == std::string::npos) return;
-        
-        // Парсим массив параметров
-        std::vector<std::string> params;
-        auto pos = arr_start + 1;
-        
-        while (pos < line.size()) {
-            // Пропуск пробелов
-            while (pos < line.size() && (line[pos] == ' ' || line[pos] == '\t')) pos++;
-            
-            if (line[pos] == ']') break;
-            if (line[pos] == ',') { pos++; continue; }
-            
-            if (line[pos] == '"') {
-                // Строковый параметр
-                auto end = line.find('"', pos + 1);
-                if (end != std::string::npos) {
-                    params.push_back(line.substr(pos + 1, end - pos - 1));
-                    pos = end + 1;
-                } else {
-                    break;
-                }
-            } else if (line[pos] == '[') {
-                // Массив (merkle_branch)
-                auto end = line.find(']', pos);
-                if (end != std::string::npos) {
-                    // Парсим внутренний массив
-                    std::string arr = line.substr(pos + 1, end - pos - 1);
-                    // Здесь нужен дополнительный парсинг merkle_branch
-                    pos = end + 1;
-                } else {
+        std::size_t index = 0;
+        for (const auto& param : params.elements()) {
+            auto text = std::string(param.as_string().value_or(""));
+            switch (index++) {
+                case 0: job.job_id = std::move(text); break;
+                case 1: job.prevhash = std::move(text); break;
+                case 2: job.coinbase1 = std::move(text); break;
+                case 3: job.coinbase2 = std::move(text); break;
+                case 4:
+                    for (const auto& hash : param.elements()) {
+                        job.merkle_branch.emplace_back(hash.as_string().value_or(""));
+                    }
                     break;
-                }
-            } else if (line[pos] == 't' || line[pos] == 'f') {
-                // boolean
-                if (line.substr(pos, 4) == "true") {
-                    params.emplace_back("true");
-                    pos += 4;
-                } else if (line.substr(pos, 5) == "false") {
-                    params.emplace_back("false");
-                    pos += 5;
-                }
-            } else {
-                pos++;
-            }
-        }
-        
-        // Заполнение структуры job
-        if (params.size() >= 8) {
-            job.job_id = params[0];
-            job.prevhash = params[1];
-            job.coinbase1 = params[2];
-            job.coinbase2 = params[3];
-            // params[4] - merkle_branch (массив)
-            job.version = params[5];
-            job.nbits = params[6];
-            job.ntime = params[7];
-            if (params.size() > 8) {
-                job.clean_jobs = (params[8] == "true");
+                case 5: job.version = std::move(text); break;
+                case 6: job.nbits = std::move(text); break;
+                case 7: job.ntime = std::move(text); break;
+                case 8: job.clean_jobs = param.as_bool().value_or(false); break;
+                default: break;
             }
         }
+        if (index < 8) return;
         
         {
             std::lock_guard<std::mutex> lock(mutex);
@@ -257,82 +277,41 @@ struct StratumClient::Impl {
         }
     }
     
-    void process_set_difficulty(const std::string& line) {
-        // Парсинг mining.set_difficulty
-        auto params_start = line.find("\"params\":");
-        if (params_start == std::string::npos) return;
-        
-        auto num_start = line.find('[', params_start);
-        if (num_start == std::string::npos) return;
-        
-        auto num_end = line.find(']', num_start);
-        if (num_end == std::string::npos) return;
+    void process_set_difficulty(const core::json::Value& params) {
+        // Парсинг mining.set_difficulty: "params":[difficulty]
+        auto diff = params[std::size_t{0}].as_double();
+        if (!diff) return;
         
-        std::string num_str = line.substr(num_start + 1, num_end - num_start - 1);
+        difficulty.store(*diff);
         
-        try {
-            double diff = std::stod(num_str);
-            difficulty.store(diff);
-            
-            if (difficulty_callback) {
-                difficulty_callback(diff);
-            }
-        } catch (...) {
-            // Игнорируем ошибки парсинга
+        if (difficulty_callback) {
+            difficulty_callback(*diff);
         }
     }
     
-    void process_response(const std::string& line) {
+    void process_response(const core::json::Value& result) {
         // Проверяем, есть ли ожидающий запрос
         std::lock_guard<std::mutex> lock(mutex);
         
-        if (pending_requests.empty()) return;
-        
-        auto req = pending_requests.front();
-        pending_requests.pop();
+        auto req = pop_pending();
+        if (!req) return;
         
-        bool success = line.find("\"result\":true") != std::string::npos ||
-                       line.find("\"result\":[") != std::string::npos;
+        bool success = result.as_bool().value_or(false) ||
+                       result.type() == core::json::Type::Array;
         
-        if (req.method == "mining.subscribe" && success) {
-            // Извлекаем extranonce1 и extranonce2_size
-            SubscribeResult result;
-            
-            // Упрощённый парсинг
-            auto result_start = line.find("\"result\":");
-            if (result_start != std::string::npos) {
-                // Ищем extranonce1 (второй элемент)
-                auto first_arr_end = line.find("]", result_start);
-                if (first_arr_end != std::string::npos) {
-                    auto quote1 = line.find('"', first_arr_end);
-                    auto quote2 = line.find('"', quote1 + 1);
-                    if (quote1 != std::string::npos && quote2 != std::string::npos) {
-                        result.extranonce1 = line.substr(quote1 + 1, quote2 - quote1 - 1);
-                    }
-                    
-                    // Ищем extranonce2_size (число после extranonce1)
-                    auto comma = line.find(',', quote2);
-                    if (comma != std::string::npos) {
-                        auto num_start = comma + 1;
-                        while (num_start < line.size() && !std::isdigit(line[num_start])) {
-                            num_start++;
-                        }
-                        auto num_end = num_start;
-                        while (num_end < line.size() && std::isdigit(line[num_end])) {
-                            num_end++;
-                        }
-                        if (num_end > num_start) {
-                            result.extranonce2_size = static_cast<uint32_t>(
-                                std::stoul(line.substr(num_start, num_end - num_start))
-                            );
-                        }
-                    }
-                }
-                
-                subscribe_result = result;
-                state = StratumState::Authorizing;
+        if (req->method == "mining.subscribe" && success) {
+            // result: [[подписки], extranonce1, extranonce2_size]
+            SubscribeResult subscribe;
+            subscribe.session_id = std::string(
+                result[std::size_t{0}][std::size_t{0}][std::size_t{1}].as_string().value_or(""));
+            subscribe.extranonce1 = std::string(result[std::size_t{1}].as_string().value_or(""));
+            if (auto size = result[std::size_t{2}].as_uint64()) {
+                subscribe.extranonce2_size = static_cast<uint32_t>(*size);
             }
-        } else if (req.method == "mining.authorize") {
+            
+            subscribe_result = subscribe;
+            state = StratumState::Authorizing;
+        } else if (req->method == "mining.authorize") {
             if (success) {
                 state = StratumState::Connected;
             } else {
@@ -342,10 +321,20 @@ struct StratumClient::Impl {
     }
     
     void read_loop() {
-        char buffer[4096];
-        
         while (running && socket_fd >= 0) {
-            ssize_t n = ::recv(socket_fd, buffer, sizeof(buffer) - 1, 0);
+            // recv пишет прямо в буфер строк, строки разбираются на месте
+            auto space = reader.writable();
+            if (space.empty()) {
+                if (running) {
+                    state = StratumState::Error;
+                    if (disconnect_callback) {
+                        disconnect_callback("Line exceeds receive buffer");
+                    }
+                }
+                break;
+            }
+            
+            ssize_t n = ::recv(socket_fd, space.data(), space.size(), 0);
             
             if (n <= 0) {
                 if (running) {
@@ -357,17 +346,10 @@ struct StratumClient::Impl {
                 break;
             }
             
-            buffer[n] = '\0';
-            read_buffer += buffer;
-            
-            // Обрабатываем все полные строки
-            size_t pos;
-            while ((pos = read_buffer.find('\n')) != std::string::npos) {
-                std::string line = read_buffer.substr(0, pos);
-                read_buffer.erase(0, pos + 1);
-                
-                if (!line.empty()) {
-                    process_line(line);
+            reader.commit(static_cast<std::size_t>(n));
+            while (auto line = reader.next_line()) {
+                if (!line->empty()) {
+                    process_line(*line);
                 }
             }
         }
@@ -378,6 +360,13 @@ struct StratumClient::Impl {
 // Публичный API
 // =============================================================================
 
+std::unique_ptr<IStratumClient> make_stratum_client(const StratumPoolConfig& config) {
+    if (config.protocol == StratumProtocol::V2) {
+        return std::make_unique<Sv2Client>(config);
+    }
+    return std::make_unique<StratumClient>(config);
+}
+
 StratumClient::StratumClient(const StratumPoolConfig& config)
     : impl_(std::make_unique<Impl>(config)) {}
 
@@ -390,6 +379,17 @@ Result<void> StratumClient::connect() {
         return {};
     }
     
+    // Прошлое соединение оборвал пул: его поток чтения уже завершился
+    if (impl_->read_thread.joinable()) {
+        disconnect();
+    }
+    {
+        std::lock_guard<std::mutex> lock(impl_->mutex);
+        impl_->pending_head = 0;
+        impl_->pending_count = 0;
+        impl_->reader.clear();
+    }
+    
     impl_->state = StratumState::Connecting;
     
     if (!impl_->create_socket()) {
@@ -414,7 +414,7 @@ Result<void> StratumClient::connect() {
     });
     
     // Отправка mining.subscribe
-    if (!impl_->send_json(impl_->build_subscribe())) {
+    if (!impl_->send_subscribe()) {
         disconnect();
         return std::unexpected(Error{ErrorCode::NetworkSendFailed, 
             "Не удалось отправить subscribe"});
@@ -434,7 +434,7 @@ Result<void> StratumClient::connect() {
     }
     
     // Отправка mining.authorize
-    if (!impl_->send_json(impl_->build_authorize())) {
+    if (!impl_->send_authorize()) {
         disconnect();
         return std::unexpected(Error{ErrorCode::NetworkSendFailed, 
             "Не удалось отправить authorize"});
@@ -486,9 +486,7 @@ Result<SubmitResult> StratumClient::submit(
             "Не подключён к пулу"});
     }
     
-    std::string json = impl_->build_submit(job_id, extranonce2, ntime, nonce);
-    
-    if (!impl_->send_json(json)) {
+    if (!impl_->send_submit(job_id, extranonce2, ntime, nonce)) {
         return std::unexpected(Error{ErrorCode::NetworkSendFailed,
             "Не удалось отправить submit"});
     }
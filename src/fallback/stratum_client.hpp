@@ -7,6 +7,9 @@
  * - mining.authorize
  * - mining.notify
  * - mining.submit
+ *
+ * IStratumClient - общий интерфейс клиентов пула: StratumClient (V1) и
+ * Sv2Client (Stratum V2, sv2_client.hpp).
  */
 
 #pragma once
@@ -72,6 +75,12 @@ struct StratumJob {
     /// @brief Timestamp (hex)
     std::string ntime;
     
+    /// @brief Merkle root (hex, порядок заголовка)
+    ///
+    /// Только Stratum V2 standard channel: coinbase собирает пул, задание
+    /// сразу даёт заголовок, coinbase1/coinbase2/merkle_branch пусты.
+    std::string merkle_root;
+    
     /// @brief Сбрасывать ли текущую работу
     bool clean_jobs{false};
     
@@ -143,20 +152,106 @@ enum class StratumState {
     }
 }
 
+/**
+ * @brief Клиент Stratum пула (V1 или V2)
+ *
+ * Задания приходят в JobCallback как StratumJob, share отправляется
+ * через submit() - одинаково для обеих версий протокола.
+ */
+class IStratumClient {
+public:
+    virtual ~IStratumClient() = default;
+    
+    /**
+     * @brief Подключиться к пулу (включая handshake)
+     */
+    [[nodiscard]] virtual Result<void> connect() = 0;
+    
+    /**
+     * @brief Отключиться от пула
+     */
+    virtual void disconnect() = 0;
+    
+    /**
+     * @brief Проверить состояние подключения
+     */
+    [[nodiscard]] virtual bool is_connected() const noexcept = 0;
+    
+    /**
+     * @brief Получить текущее состояние
+     */
+    [[nodiscard]] virtual StratumState get_state() const noexcept = 0;
+    
+    /**
+     * @brief Отправить share
+     * 
+     * @param job_id ID задания
+     * @param extranonce2 Extranonce2 (hex)
+     * @param ntime Timestamp (hex)
+     * @param nonce Nonce (hex)
+     */
+    [[nodiscard]] virtual Result<SubmitResult> submit(
+        const std::string& job_id,
+        const std::string& extranonce2,
+        const std::string& ntime,
+        const std::string& nonce
+    ) = 0;
+    
+    /**
+     * @brief Установить callback для новых заданий
+     */
+    virtual void set_job_callback(JobCallback callback) = 0;
+    
+    /**
+     * @brief Установить callback для изменения сложности
+     */
+    virtual void set_difficulty_callback(DifficultyCallback callback) = 0;
+    
+    /**
+     * @brief Установить callback для отключения
+     */
+    virtual void set_disconnect_callback(DisconnectCallback callback) = 0;
+    
+    /**
+     * @brief Получить текущее задание
+     */
+    [[nodiscard]] virtual std::optional<StratumJob> get_current_job() const = 0;
+    
+    /**
+     * @brief Получить текущую сложность
+     */
+    [[nodiscard]] virtual double get_difficulty() const noexcept = 0;
+    
+    /**
+     * @brief Получить extranonce1 (V2: extranonce prefix канала)
+     */
+    [[nodiscard]] virtual std::string get_extranonce1() const = 0;
+    
+    /**
+     * @brief Получить размер extranonce2 (V2 standard channel: 0)
+     */
+    [[nodiscard]] virtual uint32_t get_extranonce2_size() const noexcept = 0;
+};
+
+/**
+ * @brief Создать клиент по версии протокола пула (config.protocol)
+ */
+[[nodiscard]] std::unique_ptr<IStratumClient> make_stratum_client(const StratumPoolConfig& config);
+
 /**
  * @brief Stratum v1 клиент
  * 
  * Асинхронный клиент для подключения к Stratum пулу.
  * Поддерживает автоматическое переподключение.
  */
-class StratumClient {
+class StratumClient final : public IStratumClient {
 public:
     /**
      * @brief Создать клиент с конфигурацией пула
      */
     explicit StratumClient(const StratumPoolConfig& config);
     
-    ~StratumClient();
+    ~StratumClient() override;
     
     // Запрещаем копирование
     StratumClient(const StratumClient&) = delete;
@@ -171,22 +266,22 @@ public:
      * 
      * @return Result<void> Успех или ошибка
      */
-    [[nodiscard]] Result<void> connect();
+    [[nodiscard]] Result<void> connect() override;
     
     /**
      * @brief Отключиться от пула
      */
-    void disconnect();
+    void disconnect() override;
     
     /**
      * @brief Проверить состояние подключения
      */
-    [[nodiscard]] bool is_connected() const noexcept;
+    [[nodiscard]] bool is_connected() const noexcept override;
     
     /**
      * @brief Получить текущее состояние
      */
-    [[nodiscard]] StratumState get_state() const noexcept;
+    [[nodiscard]] StratumState get_state() const noexcept override;
     
     // ==========================================================================
     // Отправка данных
@@ -206,7 +301,7 @@ public:
         const std::string& extranonce2,
         const std::string& ntime,
         const std::string& nonce
-    );
+    ) override;
     
     // ==========================================================================
     // Callbacks
@@ -215,17 +310,17 @@ public:
     /**
      * @brief Установить callback для новых заданий
      */
-    void set_job_callback(JobCallback callback);
+    void set_job_callback(JobCallback callback) override;
     
     /**
      * @brief Установить callback для изменения сложности
      */
-    void set_difficulty_callback(DifficultyCallback callback);
+    void set_difficulty_callback(DifficultyCallback callback) override;
     
     /**
      * @brief Установить callback для отключения
      */
-    void set_disconnect_callback(DisconnectCallback callback);
+    void set_disconnect_callback(DisconnectCallback callback) override;
     
     // ==========================================================================
     // Информация
@@ -239,22 +334,22 @@ public:
     /**
      * @brief Получить текущее задание
      */
-    [[nodiscard]] std::optional<StratumJob> get_current_job() const;
+    [[nodiscard]] std::optional<StratumJob> get_current_job() const override;
     
     /**
      * @brief Получить текущую сложность
      */
-    [[nodiscard]] double get_difficulty() const noexcept;
+    [[nodiscard]] double get_difficulty() const noexcept override;
     
     /**
      * @brief Получить extranonce1
      */
-    [[nodiscard]] std::string get_extranonce1() const;
+    [[nodiscard]] std::string get_extranonce1() const override;
     
     /**
      * @brief Получить размер extranonce2
      */
-    [[nodiscard]] uint32_t get_extranonce2_size() const noexcept;
+    [[nodiscard]] uint32_t get_extranonce2_size() const noexcept override;
     
 private:
     struct Impl;
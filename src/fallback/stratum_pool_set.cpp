@@ -0,0 +1,357 @@
+/**
+ * @file stratum_pool_set.cpp
+ * @brief Реализация набора параллельных Stratum пулов
+ */
+
+#include "stratum_pool_set.hpp"
+#include "../core/async_log.hpp"
+
+#include <array>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace quaxis::fallback {
+
+// =============================================================================
+// Реализация
+// =============================================================================
+
+struct StratumPoolSet::Impl {
+    /// @brief Пулов не больше, чем бит в маске объявлений блока
+    static constexpr std::size_t MAX_POOLS = 64;
+
+    struct Pool {
+        StratumPoolConfig config;
+        std::unique_ptr<IStratumClient> client;
+
+        // Поток подключения пула
+        std::thread thread;
+
+        // Последнее задание пула для текущего блока (под mutex)
+        std::optional<StratumJob> latest;
+
+        // Статистика (под mutex); отставание - скользящее среднее, мкс
+        uint64_t blocks_seen{0};
+        uint64_t first_announcements{0};
+        int64_t average_lag_us{-1};
+    };
+
+    /// @brief Недавний блок: кто и когда его объявил
+    struct Block {
+        std::string prevhash;
+        std::chrono::steady_clock::time_point first_seen;
+        uint64_t announced{0};  // бит на пул
+    };
+
+    std::vector<Pool> pools;
+    std::chrono::milliseconds reconnect_delay;
+
+    mutable std::mutex mutex;
+    std::condition_variable cv;
+    bool running{false};
+
+    // Кольцо последних блоков, blocks[newest] - текущий
+    std::array<Block, PREVHASH_HISTORY> blocks;
+    std::size_t block_count{0};
+    std::size_t newest{0};
+
+    // Задание для майнинга и выданные майнингу задания (пул, job_id)
+    std::optional<PoolJob> current;
+    std::deque<std::pair<std::size_t, std::string>> issued;
+
+    PoolJobCallback job_callback;
+    DisconnectCallback disconnect_callback;
+
+    Impl(const std::vector<StratumPoolConfig>& configs, std::chrono::milliseconds delay)
+        : reconnect_delay(delay) {
+        for (const auto& config : configs) {
+            if (!config.enabled || pools.size() == MAX_POOLS) continue;
+            Pool pool;
+            pool.config = config;
+            pool.client = make_stratum_client(config);
+            pools.push_back(std::move(pool));
+        }
+    }
+
+    [[nodiscard]] Block* find_block(const std::string& prevhash) {
+        for (std::size_t i = 0; i < block_count; ++i) {
+            auto& block = blocks[(newest + PREVHASH_HISTORY - i) % PREVHASH_HISTORY];
+            if (block.prevhash == prevhash) {
+                return &block;
+            }
+        }
+        return nullptr;
+    }
+
+    void record_lag(Pool& pool, std::chrono::steady_clock::duration lag) {
+        auto lag_us = std::chrono::duration_cast<std::chrono::microseconds>(lag).count();
+        pool.blocks_seen++;
+        pool.average_lag_us = pool.average_lag_us < 0
+            ? lag_us
+            : (pool.average_lag_us * 7 + lag_us) / 8;
+    }
+
+    /**
+     * @brief Подключённый пул с наименьшим отставанием (под mutex)
+     *
+     * @param with_job Только пулы с заданием текущего блока
+     */
+    [[nodiscard]] std::optional<std::size_t> preferred_locked(bool with_job) const {
+        std::optional<std::size_t> best;
+        for (std::size_t i = 0; i < pools.size(); ++i) {
+            const auto& pool = pools[i];
+            if (!pool.client->is_connected() || (with_job && !pool.latest)) continue;
+            if (!best) {
+                best = i;
+                continue;
+            }
+
+            const auto& other = pools[*best];
+            // Без замеров - после замеренных
+            bool known = pool.average_lag_us >= 0;
+            bool other_known = other.average_lag_us >= 0;
+            if (known != other_known) {
+                if (known) best = i;
+            } else if (pool.average_lag_us != other.average_lag_us) {
+                if (pool.average_lag_us < other.average_lag_us) best = i;
+            } else if (pool.config.priority < other.config.priority) {
+                best = i;
+            }
+        }
+        return best;
+    }
+
+    /**
+     * @brief Отдать задание майнингу (под mutex)
+     */
+    void forward(std::size_t index, const StratumJob& job) {
+        const auto& client = *pools[index].client;
+
+        PoolJob pool_job;
+        pool_job.pool = index;
+        pool_job.job = job;
+        pool_job.extranonce1 = client.get_extranonce1();
+        pool_job.extranonce2_size = client.get_extranonce2_size();
+
+        issued.emplace_back(index, job.job_id);
+        if (issued.size() > SUBMIT_HISTORY) {
+            issued.pop_front();
+        }
+        current = pool_job;
+
+        if (job_callback) {
+            job_callback(pool_job);
+        }
+    }
+
+    void on_job(std::size_t index, const StratumJob& job) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto& pool = pools[index];
+        const uint64_t bit = uint64_t{1} << index;
+
+        Block* block = find_block(job.prevhash);
+        if (!block) {
+            // Новый блок: этот пул объявил его первым, задание сразу в работу
+            newest = (newest + 1) % PREVHASH_HISTORY;
+            block_count = std::min(block_count + 1, PREVHASH_HISTORY);
+            blocks[newest] = Block{job.prevhash, job.received_at, bit};
+
+            for (auto& other : pools) {
+                other.latest.reset();
+            }
+            pool.latest = job;
+            pool.first_announcements++;
+            record_lag(pool, std::chrono::steady_clock::duration::zero());
+            forward(index, job);
+            return;
+        }
+
+        if ((block->announced & bit) == 0) {
+            block->announced |= bit;
+            record_lag(pool, job.received_at - block->first_seen);
+        }
+
+        // Запоздавший notify уже сменённого блока не нужен
+        if (block != &blocks[newest]) return;
+
+        pool.latest = job;
+        if (current && current->pool == index) {
+            // Обновление задания от пула, который сейчас майнится
+            forward(index, job);
+        }
+    }
+
+    void on_disconnect(std::size_t index, const std::string& reason) {
+        DisconnectCallback callback;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            pools[index].latest.reset();
+
+            if (current && current->pool == index) {
+                // Работа продолжается на самом быстром пуле с тем же блоком
+                if (auto next = preferred_locked(true)) {
+                    forward(*next, *pools[*next].latest);
+                }
+            }
+
+            bool any_connected = false;
+            for (const auto& pool : pools) {
+                any_connected = any_connected || pool.client->is_connected();
+            }
+            if (!any_connected) {
+                callback = disconnect_callback;
+            }
+        }
+
+        if (callback) {
+            callback(pools[index].config.host + ": " + reason);
+        }
+    }
+
+    void connect_loop(std::size_t index) {
+        auto& client = *pools[index].client;
+        std::unique_lock<std::mutex> lock(mutex);
+        while (running) {
+            lock.unlock();
+            if (!client.is_connected()) {
+                auto result = client.connect();
+                if (!result) {
+                    QUAXIS_LOG_RATE(Warning, 1, "[StratumPoolSet] {}: {}", pools[index].config.host, result.error().message);
+                }
+            }
+            lock.lock();
+
+            cv.wait_for(lock, reconnect_delay, [this] { return !running; });
+        }
+    }
+};
+
+// =============================================================================
+// Публичный API
+// =============================================================================
+
+StratumPoolSet::StratumPoolSet(const std::vector<StratumPoolConfig>& pools,
+                               std::chrono::milliseconds reconnect_delay)
+    : impl_(std::make_unique<Impl>(pools, reconnect_delay)) {
+    for (std::size_t i = 0; i < impl_->pools.size(); ++i) {
+        auto& client = *impl_->pools[i].client;
+        client.set_job_callback([this, i](const StratumJob& job) {
+            impl_->on_job(i, job);
+        });
+        client.set_disconnect_callback([this, i](const std::string& reason) {
+            impl_->on_disconnect(i, reason);
+        });
+    }
+}
+
+StratumPoolSet::~StratumPoolSet() {
+    stop();
+}
+
+void StratumPoolSet::start() {
+    {
+        std::lock_guard<std::mutex> lock(impl_->mutex);
+        if (impl_->running) return;
+        impl_->running = true;
+    }
+
+    for (std::size_t i = 0; i < impl_->pools.size(); ++i) {
+        impl_->pools[i].thread = std::thread([this, i]() {
+            impl_->connect_loop(i);
+        });
+    }
+}
+
+void StratumPoolSet::stop() {
+    {
+        std::lock_guard<std::mutex> lock(impl_->mutex);
+        impl_->running = false;
+    }
+    impl_->cv.notify_all();
+
+    for (auto& pool : impl_->pools) {
+        if (pool.thread.joinable()) {
+            pool.thread.join();
+        }
+        pool.client->disconnect();
+    }
+}
+
+bool StratumPoolSet::is_connected() const noexcept {
+    for (const auto& pool : impl_->pools) {
+        if (pool.client->is_connected()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::size_t StratumPoolSet::size() const noexcept {
+    return impl_->pools.size();
+}
+
+Result<SubmitResult> StratumPoolSet::submit(
+    const std::string& job_id,
+    const std::string& extranonce2,
+    const std::string& ntime,
+    const std::string& nonce
+) {
+    std::optional<std::size_t> index;
+    {
+        std::lock_guard<std::mutex> lock(impl_->mutex);
+        for (auto it = impl_->issued.rbegin(); it != impl_->issued.rend(); ++it) {
+            if (it->second == job_id) {
+                index = it->first;
+                break;
+            }
+        }
+    }
+
+    if (!index) {
+        return Err<SubmitResult>(ErrorCode::MiningStaleJob,
+            "Задание " + job_id + " не выдавалось ни одним пулом");
+    }
+    return impl_->pools[*index].client->submit(job_id, extranonce2, ntime, nonce);
+}
+
+std::optional<PoolJob> StratumPoolSet::current_job() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    return impl_->current;
+}
+
+std::optional<std::size_t> StratumPoolSet::preferred_pool() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    return impl_->preferred_locked(false);
+}
+
+std::vector<PoolStats> StratumPoolSet::stats() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+
+    std::vector<PoolStats> result;
+    result.reserve(impl_->pools.size());
+    for (const auto& pool : impl_->pools) {
+        PoolStats stats;
+        stats.host = pool.config.host;
+        stats.port = pool.config.port;
+        stats.connected = pool.client->is_connected();
+        stats.blocks_seen = pool.blocks_seen;
+        stats.first_announcements = pool.first_announcements;
+        stats.average_lag = std::chrono::microseconds(std::max<int64_t>(pool.average_lag_us, 0));
+        result.push_back(std::move(stats));
+    }
+    return result;
+}
+
+void StratumPoolSet::set_job_callback(PoolJobCallback callback) {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    impl_->job_callback = std::move(callback);
+}
+
+void StratumPoolSet::set_disconnect_callback(DisconnectCallback callback) {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    impl_->disconnect_callback = std::move(callback);
+}
+
+} // namespace quaxis::fallback
@@ -0,0 +1,178 @@
+/**
+ * @file stratum_pool_set.hpp
+ * @brief Параллельные Stratum пулы: первое задание выигрывает
+ *
+ * Держит подключёнными все включённые пулы из FallbackConfig::stratum_pools.
+ * Для каждого нового prevhash майнится то задание, что пришло первым,
+ * независимо от пула; запоздавшие mining.notify того же блока у других
+ * пулов только запоминаются. Share уходит пулу, выдавшему задание.
+ *
+ * По каждому пулу считается отставание его notify от первого объявления
+ * блока (скользящее среднее). Если пул текущего задания отключился, майнинг
+ * продолжается на задании самого быстрого из оставшихся пулов.
+ */
+
+#pragma once
+
+#include "../core/types.hpp"
+#include "pool_config.hpp"
+#include "stratum_client.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace quaxis::fallback {
+
+/**
+ * @brief Задание пула вместе с параметрами подписки этого пула
+ */
+struct PoolJob {
+    /// @brief Индекс пула в StratumPoolSet
+    std::size_t pool{0};
+
+    /// @brief Задание (mining.notify)
+    StratumJob job;
+
+    /// @brief Extranonce1 пула (hex)
+    std::string extranonce1;
+
+    /// @brief Размер extranonce2 пула в байтах
+    uint32_t extranonce2_size{4};
+};
+
+/**
+ * @brief Callback при смене задания для майнинга
+ */
+using PoolJobCallback = std::function<void(const PoolJob&)>;
+
+/**
+ * @brief Статистика одного пула
+ */
+struct PoolStats {
+    /// @brief Хост и порт пула
+    std::string host;
+    uint16_t port{0};
+
+    /// @brief Подключён ли пул
+    bool connected{false};
+
+    /// @brief Блоков (prevhash), объявленных пулом
+    uint64_t blocks_seen{0};
+
+    /// @brief Блоков, объявленных пулом первым
+    uint64_t first_announcements{0};
+
+    /// @brief Среднее отставание notify от первого объявления блока
+    std::chrono::microseconds average_lag{0};
+};
+
+/**
+ * @brief Набор параллельно подключённых Stratum пулов
+ */
+class StratumPoolSet {
+public:
+    /// @brief Сколько последних prevhash помнится (поздние notify старых блоков)
+    static constexpr std::size_t PREVHASH_HISTORY = 8;
+
+    /// @brief Сколько последних заданий помнится для маршрутизации share
+    static constexpr std::size_t SUBMIT_HISTORY = 32;
+
+    /**
+     * @brief Создать набор из включённых пулов
+     *
+     * @param pools Конфигурация пулов (выключенные пропускаются)
+     * @param reconnect_delay Интервал переподключения отключённых пулов
+     */
+    StratumPoolSet(const std::vector<StratumPoolConfig>& pools,
+                   std::chrono::milliseconds reconnect_delay);
+
+    ~StratumPoolSet();
+
+    StratumPoolSet(const StratumPoolSet&) = delete;
+    StratumPoolSet& operator=(const StratumPoolSet&) = delete;
+
+    // ==========================================================================
+    // Управление
+    // ==========================================================================
+
+    /**
+     * @brief Запустить поток подключения пулов
+     */
+    void start();
+
+    /**
+     * @brief Отключить все пулы и остановить поток
+     */
+    void stop();
+
+    /**
+     * @brief Подключён ли хотя бы один пул
+     */
+    [[nodiscard]] bool is_connected() const noexcept;
+
+    /**
+     * @brief Число пулов в наборе
+     */
+    [[nodiscard]] std::size_t size() const noexcept;
+
+    // ==========================================================================
+    // Задания и share
+    // ==========================================================================
+
+    /**
+     * @brief Отправить share пулу, выдавшему задание job_id
+     *
+     * Задания ищутся среди последних SUBMIT_HISTORY отданных майнингу,
+     * при совпадении ID у разных пулов - самое свежее.
+     */
+    [[nodiscard]] Result<SubmitResult> submit(
+        const std::string& job_id,
+        const std::string& extranonce2,
+        const std::string& ntime,
+        const std::string& nonce
+    );
+
+    /**
+     * @brief Текущее задание для майнинга
+     */
+    [[nodiscard]] std::optional<PoolJob> current_job() const;
+
+    /**
+     * @brief Подключённый пул с наименьшим отставанием
+     *
+     * Пулы без замеров идут после замеренных, при равенстве - по priority.
+     */
+    [[nodiscard]] std::optional<std::size_t> preferred_pool() const;
+
+    /**
+     * @brief Статистика по пулам (в порядке индексов)
+     */
+    [[nodiscard]] std::vector<PoolStats> stats() const;
+
+    // ==========================================================================
+    // Callbacks
+    // ==========================================================================
+
+    /**
+     * @brief Callback при смене задания для майнинга
+     *
+     * Вызывается из потоков чтения пулов; задания приходят по порядку.
+     */
+    void set_job_callback(PoolJobCallback callback);
+
+    /**
+     * @brief Callback при отключении последнего подключённого пула
+     */
+    void set_disconnect_callback(DisconnectCallback callback);
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace quaxis::fallback
@@ -0,0 +1,99 @@
+/**
+ * @file stratum_wire.cpp
+ * @brief Реализация приёма строк и кодирования mining.submit
+ */
+
+#include "stratum_wire.hpp"
+
+#include <charconv>
+#include <cstring>
+
+namespace quaxis::fallback {
+
+// =============================================================================
+// LineReader
+// =============================================================================
+
+std::span<char> LineReader::writable() noexcept {
+    if (begin_ > 0) {
+        // Недочитанная строка - в начало, освобождаем хвост
+        std::size_t size = end_ - begin_;
+        if (size > 0) {
+            std::memmove(data_.data(), data_.data() + begin_, size);
+        }
+        scanned_ -= begin_;
+        end_ = size;
+        begin_ = 0;
+    }
+    return {data_.data() + end_, CAPACITY - end_};
+}
+
+void LineReader::clear() noexcept {
+    begin_ = 0;
+    scanned_ = 0;
+    end_ = 0;
+}
+
+// =============================================================================
+// SubmitEncoder
+// =============================================================================
+
+void SubmitEncoder::rebuild(std::string_view user, std::string_view job_id,
+                            std::size_t extranonce2_size, std::size_t ntime_size,
+                            std::size_t nonce_size) {
+    user_.assign(user);
+    job_id_.assign(job_id);
+    extranonce2_size_ = extranonce2_size;
+    ntime_size_ = ntime_size;
+    nonce_size_ = nonce_size;
+
+    buffer_.clear();
+    buffer_ += "{\"params\":[\"";
+    buffer_ += user;
+    buffer_ += "\",\"";
+    buffer_ += job_id;
+    buffer_ += "\",\"";
+    extranonce2_offset_ = buffer_.size();
+    buffer_.append(extranonce2_size, '0');
+    buffer_ += "\",\"";
+    ntime_offset_ = buffer_.size();
+    buffer_.append(ntime_size, '0');
+    buffer_ += "\",\"";
+    nonce_offset_ = buffer_.size();
+    buffer_.append(nonce_size, '0');
+    buffer_ += "\"],\"method\":\"mining.submit\",\"id\":";
+    id_offset_ = buffer_.size();
+
+    // Место под ID (до 20 цифр) и "}\n"
+    buffer_.append(22, '\0');
+    rebuilds_++;
+}
+
+std::string_view SubmitEncoder::encode(
+    uint64_t id,
+    std::string_view user,
+    std::string_view job_id,
+    std::string_view extranonce2,
+    std::string_view ntime,
+    std::string_view nonce
+) {
+    if (job_id != job_id_ || user != user_ ||
+        extranonce2.size() != extranonce2_size_ ||
+        ntime.size() != ntime_size_ ||
+        nonce.size() != nonce_size_) {
+        rebuild(user, job_id, extranonce2.size(), ntime.size(), nonce.size());
+    }
+
+    char* data = buffer_.data();
+    std::memcpy(data + extranonce2_offset_, extranonce2.data(), extranonce2.size());
+    std::memcpy(data + ntime_offset_, ntime.data(), ntime.size());
+    std::memcpy(data + nonce_offset_, nonce.data(), nonce.size());
+
+    auto [end, ec] = std::to_chars(data + id_offset_, data + buffer_.size(), id);
+    (void)ec;  // 22 байт хватает на любой uint64_t
+    *end++ = '}';
+    *end++ = '\n';
+    return {data, static_cast<std::size_t>(end - data)};
+}
+
+} // namespace quaxis::fallback
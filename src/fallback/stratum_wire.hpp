@@ -0,0 +1,140 @@
+/**
+ * @file stratum_wire.hpp
+ * @brief Приём строк и кодирование mining.submit без аллокаций
+ *
+ * LineReader - фиксированный буфер приёма: recv пишет прямо в свободный
+ * хвост, строки выдаются как string_view на месте. Перед следующим recv
+ * недочитанная строка сдвигается в начало буфера (обычно - десятки байт).
+ *
+ * SubmitEncoder - mining.submit, собранный один раз на задание. На каждый
+ * share поверх шаблона копируются только extranonce2, ntime и nonce, и
+ * в конец дописывается ID запроса.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace quaxis::fallback {
+
+// =============================================================================
+// LineReader
+// =============================================================================
+
+/**
+ * @brief Буфер приёма строк Stratum фиксированного размера
+ */
+class LineReader {
+public:
+    /// @brief Размер буфера: самая длинная допустимая строка
+    ///
+    /// mining.notify с полным merkle branch - около 2 КБ.
+    static constexpr std::size_t CAPACITY = 16 * 1024;
+
+    /**
+     * @brief Свободное место для recv
+     *
+     * Сдвигает недочитанную строку в начало; string_view прошлых строк
+     * после этого недействительны. Пустой span - строка длиннее CAPACITY.
+     */
+    [[nodiscard]] std::span<char> writable() noexcept;
+
+    /**
+     * @brief Учесть size байт, записанных в writable()
+     */
+    void commit(std::size_t size) noexcept { end_ += size; }
+
+    /**
+     * @brief Следующая полная строка без '\n' (и без '\r')
+     *
+     * @return nullopt - полной строки нет, ждём ещё данных
+     */
+    [[nodiscard]] std::optional<std::string_view> next_line() noexcept {
+        const char* start = data_.data() + scanned_;
+        auto* newline = static_cast<const char*>(std::memchr(start, '\n', end_ - scanned_));
+        if (!newline) {
+            scanned_ = end_;
+            return std::nullopt;
+        }
+
+        std::size_t line_end = static_cast<std::size_t>(newline - data_.data());
+        std::string_view line(data_.data() + begin_, line_end - begin_);
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+
+        begin_ = line_end + 1;
+        scanned_ = begin_;
+        return line;
+    }
+
+    /**
+     * @brief Сбросить буфер (новое соединение)
+     */
+    void clear() noexcept;
+
+    /// @brief Байт в буфере, ещё не выданных строками
+    [[nodiscard]] std::size_t pending() const noexcept { return end_ - begin_; }
+
+private:
+    std::array<char, CAPACITY> data_{};
+    std::size_t begin_{0};      ///< Начало недочитанной строки
+    std::size_t scanned_{0};    ///< До сюда '\n' уже искали
+    std::size_t end_{0};        ///< Конец принятых данных
+};
+
+// =============================================================================
+// SubmitEncoder
+// =============================================================================
+
+/**
+ * @brief Кодировщик mining.submit по шаблону задания
+ *
+ * Строка: {"params":[user,job_id,extranonce2,ntime,nonce],
+ * "method":"mining.submit","id":N} и '\n'. Шаблон пересобирается, только
+ * если сменились user, job_id или длины hex полей.
+ */
+class SubmitEncoder {
+public:
+    /**
+     * @brief Строка запроса, готовая к send
+     *
+     * @return Вид на внутренний буфер, действителен до следующего encode()
+     */
+    [[nodiscard]] std::string_view encode(
+        uint64_t id,
+        std::string_view user,
+        std::string_view job_id,
+        std::string_view extranonce2,
+        std::string_view ntime,
+        std::string_view nonce
+    );
+
+    /// @brief Сколько раз собирался шаблон
+    [[nodiscard]] uint64_t rebuilds() const noexcept { return rebuilds_; }
+
+private:
+    void rebuild(std::string_view user, std::string_view job_id,
+                 std::size_t extranonce2_size, std::size_t ntime_size, std::size_t nonce_size);
+
+    std::string buffer_;
+    std::string user_;
+    std::string job_id_;
+    std::size_t extranonce2_offset_{0};
+    std::size_t extranonce2_size_{0};
+    std::size_t ntime_offset_{0};
+    std::size_t ntime_size_{0};
+    std::size_t nonce_offset_{0};
+    std::size_t nonce_size_{0};
+    std::size_t id_offset_{0};
+    uint64_t rebuilds_{0};
+};
+
+} // namespace quaxis::fallback
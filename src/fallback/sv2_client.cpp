@@ -0,0 +1,463 @@
+/**
+ * @file sv2_client.cpp
+ * @brief Реализация Stratum V2 клиента
+ */
+
+#include "sv2_client.hpp"
+#include "sv2_codec.hpp"
+#include "../core/byte_order.hpp"
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <charconv>
+#include <condition_variable>
+#include <cstring>
+#include <format>
+#include <unordered_map>
+
+namespace quaxis::fallback {
+
+namespace {
+
+/// @brief Разобрать число из всей строки
+[[nodiscard]] std::optional<uint32_t> parse_u32(std::string_view text, int base) {
+    uint32_t value = 0;
+    auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value, base);
+    if (ec != std::errc{} || end != text.data() + text.size() || text.empty()) {
+        return std::nullopt;
+    }
+    return value;
+}
+
+} // anonymous namespace
+
+// =============================================================================
+// Реализация
+// =============================================================================
+
+struct Sv2Client::Impl {
+    StratumPoolConfig config;
+
+    std::atomic<StratumState> state{StratumState::Disconnected};
+    std::atomic<bool> running{false};
+    int socket_fd{-1};
+
+    // Канал
+    std::atomic<uint32_t> channel_id{0};
+    std::atomic<uint32_t> sequence_number{0};
+    std::atomic<double> difficulty{1.0};
+    std::string extranonce_prefix;  // hex
+    std::string error_message;      // причина отказа пула в handshake
+
+    // Задания канала для текущего prevhash (и future jobs), по ID
+    std::unordered_map<uint32_t, sv2::NewMiningJob> jobs;
+    std::optional<sv2::SetNewPrevHash> prev_hash;
+    std::optional<StratumJob> current_job;
+
+    mutable std::mutex mutex;
+    std::condition_variable state_cv;
+
+    JobCallback job_callback;
+    DifficultyCallback difficulty_callback;
+    DisconnectCallback disconnect_callback;
+
+    std::thread read_thread;
+    Bytes read_buffer;
+
+    explicit Impl(const StratumPoolConfig& cfg) : config(cfg) {}
+
+    ~Impl() {
+        close_socket();
+    }
+
+    void close_socket() {
+        if (socket_fd >= 0) {
+            ::shutdown(socket_fd, SHUT_RDWR);
+            ::close(socket_fd);
+            socket_fd = -1;
+        }
+    }
+
+    bool connect_to_pool() {
+        addrinfo hints{};
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_STREAM;
+        addrinfo* addresses = nullptr;
+        auto port = std::to_string(config.port);
+        if (::getaddrinfo(config.host.c_str(), port.c_str(), &hints, &addresses) != 0) {
+            return false;
+        }
+
+        for (auto* address = addresses; address; address = address->ai_next) {
+            socket_fd = ::socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+            if (socket_fd < 0) continue;
+            if (::connect(socket_fd, address->ai_addr, address->ai_addrlen) == 0) {
+                break;
+            }
+            ::close(socket_fd);
+            socket_fd = -1;
+        }
+        ::freeaddrinfo(addresses);
+
+        if (socket_fd < 0) {
+            return false;
+        }
+
+        // Установить TCP_NODELAY для минимальной латентности
+        int flag = 1;
+        ::setsockopt(socket_fd, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
+        return true;
+    }
+
+    bool send_frame(const Bytes& frame) {
+        ssize_t sent = ::send(socket_fd, frame.data(), frame.size(), MSG_NOSIGNAL);
+        return sent == static_cast<ssize_t>(frame.size());
+    }
+
+    /// @brief Сменить состояние и разбудить connect()
+    void set_state(StratumState next) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            state = next;
+        }
+        state_cv.notify_all();
+    }
+
+    /**
+     * @brief Ждать выхода из состояния step
+     *
+     * @return Пустая строка - перешли в expected, иначе причина отказа
+     */
+    [[nodiscard]] std::string wait_step(StratumState step, StratumState expected) {
+        std::unique_lock<std::mutex> lock(mutex);
+        state_cv.wait_for(lock, HANDSHAKE_TIMEOUT, [&] { return state != step; });
+        if (state == expected) {
+            return {};
+        }
+        return error_message.empty() ? std::string("таймаут") : error_message;
+    }
+
+    /**
+     * @brief Задание канала в StratumJob (под mutex)
+     */
+    [[nodiscard]] StratumJob make_job(const sv2::NewMiningJob& job, uint32_t ntime, bool clean) const {
+        StratumJob result;
+        result.job_id = std::to_string(job.job_id);
+        result.prevhash = to_hex(prev_hash->prev_hash);
+        result.merkle_root = to_hex(job.merkle_root);
+        result.version = std::format("{:08x}", job.version);
+        result.nbits = std::format("{:08x}", prev_hash->nbits);
+        result.ntime = std::format("{:08x}", ntime);
+        result.clean_jobs = clean;
+        result.received_at = std::chrono::steady_clock::now();
+        return result;
+    }
+
+    void process_frame(const sv2::FrameHeader& header, ByteSpan payload) {
+        std::optional<StratumJob> job;
+        std::optional<double> new_difficulty;
+
+        switch (header.msg_type) {
+            case sv2::msg::SETUP_CONNECTION_SUCCESS:
+                set_state(StratumState::Authorizing);
+                return;
+
+            case sv2::msg::SETUP_CONNECTION_ERROR:
+            case sv2::msg::OPEN_MINING_CHANNEL_ERROR: {
+                // SetupConnection.Error: flags + код; OpenMiningChannel.Error: request_id + код
+                sv2::Reader reader(payload);
+                (void)reader.u32();
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    error_message = reader.str0_255();
+                }
+                set_state(StratumState::Error);
+                return;
+            }
+
+            case sv2::msg::OPEN_STANDARD_MINING_CHANNEL_SUCCESS: {
+                auto message = sv2::OpenStandardMiningChannelSuccess::decode(payload);
+                if (!message) return;
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    channel_id = message->channel_id;
+                    extranonce_prefix = to_hex(message->extranonce_prefix);
+                }
+                difficulty = sv2::target_to_difficulty(message->target);
+                set_state(StratumState::Connected);
+                return;
+            }
+
+            case sv2::msg::NEW_MINING_JOB: {
+                auto message = sv2::NewMiningJob::decode(payload);
+                if (!message) return;
+                std::lock_guard<std::mutex> lock(mutex);
+                jobs[message->job_id] = *message;
+                // Задание для текущего prevhash - сразу в работу
+                if (message->min_ntime && prev_hash) {
+                    job = make_job(*message, std::max(*message->min_ntime, prev_hash->min_ntime), false);
+                }
+                break;
+            }
+
+            case sv2::msg::SET_NEW_PREV_HASH: {
+                auto message = sv2::SetNewPrevHash::decode(payload);
+                if (!message) return;
+                std::lock_guard<std::mutex> lock(mutex);
+                prev_hash = *message;
+                // Старые задания недействительны, future job становится текущим
+                auto future = jobs.find(message->job_id);
+                if (future != jobs.end()) {
+                    auto activated = future->second;
+                    jobs.clear();
+                    jobs.emplace(activated.job_id, activated);
+                    job = make_job(activated, message->min_ntime, true);
+                } else {
+                    jobs.clear();
+                }
+                break;
+            }
+
+            case sv2::msg::SET_TARGET: {
+                auto message = sv2::SetTarget::decode(payload);
+                if (!message) return;
+                new_difficulty = sv2::target_to_difficulty(message->maximum_target);
+                difficulty = *new_difficulty;
+                break;
+            }
+
+            default:
+                // SubmitShares.Success/Error: результат share асинхронный, как в V1
+                return;
+        }
+
+        if (job) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                current_job = job;
+            }
+            if (job_callback) {
+                job_callback(*job);
+            }
+        }
+        if (new_difficulty && difficulty_callback) {
+            difficulty_callback(*new_difficulty);
+        }
+    }
+
+    void read_loop() {
+        uint8_t buffer[4096];
+
+        while (running && socket_fd >= 0) {
+            ssize_t n = ::recv(socket_fd, buffer, sizeof(buffer), 0);
+
+            if (n <= 0) {
+                if (running) {
+                    set_state(StratumState::Disconnected);
+                    if (disconnect_callback) {
+                        disconnect_callback("Connection lost");
+                    }
+                }
+                break;
+            }
+
+            read_buffer.insert(read_buffer.end(), buffer, buffer + n);
+
+            // Все полные кадры, обработанная часть удаляется одним erase
+            std::size_t consumed = 0;
+            while (read_buffer.size() - consumed >= sv2::FRAME_HEADER_SIZE) {
+                ByteSpan pending(read_buffer.data() + consumed, read_buffer.size() - consumed);
+                auto header = sv2::parse_frame_header(pending);
+                if (pending.size() < sv2::FRAME_HEADER_SIZE + header->length) break;
+
+                process_frame(*header, pending.subspan(sv2::FRAME_HEADER_SIZE, header->length));
+                consumed += sv2::FRAME_HEADER_SIZE + header->length;
+            }
+            read_buffer.erase(read_buffer.begin(), read_buffer.begin() + static_cast<std::ptrdiff_t>(consumed));
+        }
+    }
+};
+
+// =============================================================================
+// Публичный API
+// =============================================================================
+
+Sv2Client::Sv2Client(const StratumPoolConfig& config)
+    : impl_(std::make_unique<Impl>(config)) {}
+
+Sv2Client::~Sv2Client() {
+    disconnect();
+}
+
+Result<void> Sv2Client::connect() {
+    if (impl_->state == StratumState::Connected) {
+        return {};
+    }
+
+    // Прошлое соединение оборвал пул: его поток чтения уже завершился
+    if (impl_->read_thread.joinable()) {
+        disconnect();
+    }
+    {
+        std::lock_guard<std::mutex> lock(impl_->mutex);
+        impl_->jobs.clear();
+        impl_->prev_hash.reset();
+        impl_->current_job.reset();
+        impl_->error_message.clear();
+        impl_->read_buffer.clear();
+    }
+
+    impl_->state = StratumState::Connecting;
+
+    if (!impl_->connect_to_pool()) {
+        impl_->close_socket();
+        impl_->state = StratumState::Error;
+        return Err<void>(ErrorCode::NetworkConnectionFailed,
+            "Не удалось подключиться к пулу " + impl_->config.host);
+    }
+
+    impl_->running = true;
+    impl_->state = StratumState::Subscribing;
+
+    impl_->read_thread = std::thread([this]() {
+        impl_->read_loop();
+    });
+
+    // SetupConnection: mining, только standard jobs
+    sv2::SetupConnection setup;
+    setup.endpoint_host = impl_->config.host;
+    setup.endpoint_port = impl_->config.port;
+    if (!impl_->send_frame(setup.encode())) {
+        disconnect();
+        return Err<void>(ErrorCode::NetworkSendFailed, "Не удалось отправить SetupConnection");
+    }
+    if (auto reason = impl_->wait_step(StratumState::Subscribing, StratumState::Authorizing);
+        !reason.empty()) {
+        disconnect();
+        return Err<void>(ErrorCode::NetworkTimeout, "SetupConnection не принят: " + reason);
+    }
+
+    // Канал: пул выбирает target по номинальному хешрейту
+    sv2::OpenStandardMiningChannel open;
+    open.request_id = 1;
+    open.user_identity = impl_->config.user;
+    open.nominal_hash_rate = impl_->config.nominal_hashrate;
+    open.max_target.fill(0xFF);
+    if (!impl_->send_frame(open.encode())) {
+        disconnect();
+        return Err<void>(ErrorCode::NetworkSendFailed, "Не удалось отправить OpenStandardMiningChannel");
+    }
+    if (auto reason = impl_->wait_step(StratumState::Authorizing, StratumState::Connected);
+        !reason.empty()) {
+        disconnect();
+        return Err<void>(ErrorCode::RpcAuthFailed, "Канал не открыт: " + reason);
+    }
+
+    return {};
+}
+
+void Sv2Client::disconnect() {
+    impl_->running = false;
+    impl_->close_socket();
+
+    if (impl_->read_thread.joinable()) {
+        impl_->read_thread.join();
+    }
+
+    impl_->state = StratumState::Disconnected;
+}
+
+bool Sv2Client::is_connected() const noexcept {
+    return impl_->state == StratumState::Connected;
+}
+
+StratumState Sv2Client::get_state() const noexcept {
+    return impl_->state;
+}
+
+Result<SubmitResult> Sv2Client::submit(
+    const std::string& job_id,
+    const std::string& extranonce2,
+    const std::string& ntime,
+    const std::string& nonce
+) {
+    if (!is_connected()) {
+        return Err<SubmitResult>(ErrorCode::NetworkConnectionFailed, "Не подключён к пулу");
+    }
+    if (!extranonce2.empty()) {
+        return Err<SubmitResult>(ErrorCode::MiningInvalidJob,
+            "Standard channel SV2 не принимает extranonce2");
+    }
+
+    auto id = parse_u32(job_id, 10);
+    auto time = parse_u32(ntime, 16);
+    auto nonce_value = parse_u32(nonce, 16);
+    if (!id || !time || !nonce_value) {
+        return Err<SubmitResult>(ErrorCode::MiningInvalidNonce, "Некорректный share: " + job_id);
+    }
+
+    sv2::SubmitSharesStandard share;
+    {
+        std::lock_guard<std::mutex> lock(impl_->mutex);
+        auto job = impl_->jobs.find(*id);
+        if (job == impl_->jobs.end()) {
+            return Err<SubmitResult>(ErrorCode::MiningStaleJob, "Задание " + job_id + " устарело");
+        }
+        share.version = job->second.version;
+    }
+    share.channel_id = impl_->channel_id;
+    share.sequence_number = impl_->sequence_number++;
+    share.job_id = *id;
+    share.nonce = *nonce_value;
+    share.ntime = *time;
+
+    if (!impl_->send_frame(share.encode())) {
+        return Err<SubmitResult>(ErrorCode::NetworkSendFailed, "Не удалось отправить share");
+    }
+
+    // Возвращаем успех - реальный результат придёт асинхронно
+    SubmitResult result;
+    result.accepted = true;
+    return result;
+}
+
+void Sv2Client::set_job_callback(JobCallback callback) {
+    impl_->job_callback = std::move(callback);
+}
+
+void Sv2Client::set_difficulty_callback(DifficultyCallback callback) {
+    impl_->difficulty_callback = std::move(callback);
+}
+
+void Sv2Client::set_disconnect_callback(DisconnectCallback callback) {
+    impl_->disconnect_callback = std::move(callback);
+}
+
+std::optional<StratumJob> Sv2Client::get_current_job() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    return impl_->current_job;
+}
+
+double Sv2Client::get_difficulty() const noexcept {
+    return impl_->difficulty;
+}
+
+std::string Sv2Client::get_extranonce1() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    return impl_->extranonce_prefix;
+}
+
+uint32_t Sv2Client::get_extranonce2_size() const noexcept {
+    return 0;
+}
+
+uint32_t Sv2Client::channel_id() const noexcept {
+    return impl_->channel_id;
+}
+
+} // namespace quaxis::fallback
@@ -0,0 +1,78 @@
+/**
+ * @file sv2_client.hpp
+ * @brief Stratum V2 клиент (mining protocol, standard channel)
+ *
+ * Подключение: SetupConnection с флагом REQUIRES_STANDARD_JOBS, затем
+ * OpenStandardMiningChannel. Пул сам собирает coinbase и присылает для
+ * канала готовые version и merkle_root (NewMiningJob), prevhash, ntime и
+ * nBits (SetNewPrevHash) - из этого сразу получается заголовок блока и
+ * 48-байтное задание ASIC, без coinbase и merkle branch на нашей стороне.
+ *
+ * Задания и share - через IStratumClient, как у V1:
+ * - StratumJob: job_id - десятичный ID задания SV2, merkle_root заполнен,
+ *   coinbase1/coinbase2/merkle_branch пусты; clean_jobs - смена prevhash;
+ * - submit(): extranonce2 пустой (standard channel не перебирает
+ *   extranonce), version берётся из задания.
+ *
+ * Кадры идут без шифрования Noise: для пулов, принимающих открытое
+ * соединение, или через локальный SV2 proxy.
+ */
+
+#pragma once
+
+#include "stratum_client.hpp"
+
+#include <memory>
+
+namespace quaxis::fallback {
+
+/**
+ * @brief Stratum V2 клиент
+ */
+class Sv2Client final : public IStratumClient {
+public:
+    /// @brief Таймаут каждого шага handshake
+    static constexpr std::chrono::seconds HANDSHAKE_TIMEOUT{5};
+
+    /**
+     * @brief Создать клиент с конфигурацией пула
+     */
+    explicit Sv2Client(const StratumPoolConfig& config);
+
+    ~Sv2Client() override;
+
+    Sv2Client(const Sv2Client&) = delete;
+    Sv2Client& operator=(const Sv2Client&) = delete;
+
+    [[nodiscard]] Result<void> connect() override;
+    void disconnect() override;
+    [[nodiscard]] bool is_connected() const noexcept override;
+    [[nodiscard]] StratumState get_state() const noexcept override;
+
+    [[nodiscard]] Result<SubmitResult> submit(
+        const std::string& job_id,
+        const std::string& extranonce2,
+        const std::string& ntime,
+        const std::string& nonce
+    ) override;
+
+    void set_job_callback(JobCallback callback) override;
+    void set_difficulty_callback(DifficultyCallback callback) override;
+    void set_disconnect_callback(DisconnectCallback callback) override;
+
+    [[nodiscard]] std::optional<StratumJob> get_current_job() const override;
+    [[nodiscard]] double get_difficulty() const noexcept override;
+    [[nodiscard]] std::string get_extranonce1() const override;
+    [[nodiscard]] uint32_t get_extranonce2_size() const noexcept override;
+
+    /**
+     * @brief ID открытого канала
+     */
+    [[nodiscard]] uint32_t channel_id() const noexcept;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace quaxis::fallback
@@ -0,0 +1,262 @@
+/**
+ * @file sv2_codec.cpp
+ * @brief Реализация кодека Stratum V2
+ */
+
+#include "sv2_codec.hpp"
+#include "../core/byte_order.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+
+namespace quaxis::fallback::sv2 {
+
+// =============================================================================
+// Кадр
+// =============================================================================
+
+std::optional<FrameHeader> parse_frame_header(ByteSpan data) noexcept {
+    if (data.size() < FRAME_HEADER_SIZE) {
+        return std::nullopt;
+    }
+
+    FrameHeader header;
+    header.extension_type = read_le16(data.data());
+    header.msg_type = data[2];
+    header.length = static_cast<uint32_t>(data[3])
+                  | (static_cast<uint32_t>(data[4]) << 8)
+                  | (static_cast<uint32_t>(data[5]) << 16);
+    return header;
+}
+
+Bytes make_frame(uint8_t msg_type, bool channel_msg, ByteSpan payload) {
+    const auto length = static_cast<uint32_t>(std::min<std::size_t>(payload.size(), MAX_PAYLOAD_SIZE));
+
+    Bytes frame(FRAME_HEADER_SIZE + length);
+    write_le16(frame.data(), channel_msg ? CHANNEL_MSG_BIT : uint16_t{0});
+    frame[2] = msg_type;
+    frame[3] = static_cast<uint8_t>(length);
+    frame[4] = static_cast<uint8_t>(length >> 8);
+    frame[5] = static_cast<uint8_t>(length >> 16);
+    std::memcpy(frame.data() + FRAME_HEADER_SIZE, payload.data(), length);
+    return frame;
+}
+
+// =============================================================================
+// Writer
+// =============================================================================
+
+void Writer::u16(uint16_t value) {
+    uint8_t bytes[2];
+    write_le16(bytes, value);
+    data_.insert(data_.end(), bytes, bytes + sizeof(bytes));
+}
+
+void Writer::u32(uint32_t value) {
+    uint8_t bytes[4];
+    write_le32(bytes, value);
+    data_.insert(data_.end(), bytes, bytes + sizeof(bytes));
+}
+
+void Writer::u64(uint64_t value) {
+    uint8_t bytes[8];
+    write_le64(bytes, value);
+    data_.insert(data_.end(), bytes, bytes + sizeof(bytes));
+}
+
+void Writer::f32(float value) {
+    u32(std::bit_cast<uint32_t>(value));
+}
+
+void Writer::u256(const Hash256& value) {
+    data_.insert(data_.end(), value.begin(), value.end());
+}
+
+void Writer::str0_255(std::string_view value) {
+    const auto size = std::min<std::size_t>(value.size(), 255);
+    data_.push_back(static_cast<uint8_t>(size));
+    data_.insert(data_.end(), value.begin(), value.begin() + static_cast<std::ptrdiff_t>(size));
+}
+
+void Writer::b0_32(ByteSpan value) {
+    const auto size = std::min<std::size_t>(value.size(), 32);
+    data_.push_back(static_cast<uint8_t>(size));
+    data_.insert(data_.end(), value.begin(), value.begin() + static_cast<std::ptrdiff_t>(size));
+}
+
+void Writer::option_u32(std::optional<uint32_t> value) {
+    data_.push_back(value ? 1 : 0);
+    if (value) {
+        u32(*value);
+    }
+}
+
+// =============================================================================
+// Reader
+// =============================================================================
+
+const uint8_t* Reader::take(std::size_t size) noexcept {
+    if (!ok_ || data_.size() - pos_ < size) {
+        ok_ = false;
+        return nullptr;
+    }
+    const uint8_t* field = data_.data() + pos_;
+    pos_ += size;
+    return field;
+}
+
+uint8_t Reader::u8() noexcept {
+    const auto* field = take(1);
+    return field ? *field : 0;
+}
+
+uint16_t Reader::u16() noexcept {
+    const auto* field = take(2);
+    return field ? read_le16(field) : 0;
+}
+
+uint32_t Reader::u32() noexcept {
+    const auto* field = take(4);
+    return field ? read_le32(field) : 0;
+}
+
+uint64_t Reader::u64() noexcept {
+    const auto* field = take(8);
+    return field ? read_le64(field) : 0;
+}
+
+Hash256 Reader::u256() noexcept {
+    Hash256 value{};
+    if (const auto* field = take(value.size())) {
+        std::memcpy(value.data(), field, value.size());
+    }
+    return value;
+}
+
+std::string Reader::str0_255() {
+    const auto size = u8();
+    const auto* field = take(size);
+    return field ? std::string(reinterpret_cast<const char*>(field), size) : std::string{};
+}
+
+Bytes Reader::b0_32() {
+    const auto size = u8();
+    if (size > 32) {
+        ok_ = false;
+        return {};
+    }
+    const auto* field = take(size);
+    return field ? Bytes(field, field + size) : Bytes{};
+}
+
+std::optional<uint32_t> Reader::option_u32() noexcept {
+    const auto present = u8();
+    if (present > 1) {
+        ok_ = false;
+        return std::nullopt;
+    }
+    if (present == 0) {
+        return std::nullopt;
+    }
+    return u32();
+}
+
+// =============================================================================
+// Сообщения
+// =============================================================================
+
+Bytes SetupConnection::encode() const {
+    Writer writer;
+    writer.u8(protocol);
+    writer.u16(min_version);
+    writer.u16(max_version);
+    writer.u32(flags);
+    writer.str0_255(endpoint_host);
+    writer.u16(endpoint_port);
+    writer.str0_255(vendor);
+    writer.str0_255(hardware_version);
+    writer.str0_255(firmware);
+    writer.str0_255(device_id);
+    return make_frame(msg::SETUP_CONNECTION, false, writer.data());
+}
+
+Bytes OpenStandardMiningChannel::encode() const {
+    Writer writer;
+    writer.u32(request_id);
+    writer.str0_255(user_identity);
+    writer.f32(nominal_hash_rate);
+    writer.u256(max_target);
+    return make_frame(msg::OPEN_STANDARD_MINING_CHANNEL, false, writer.data());
+}
+
+std::optional<OpenStandardMiningChannelSuccess> OpenStandardMiningChannelSuccess::decode(ByteSpan payload) {
+    Reader reader(payload);
+    OpenStandardMiningChannelSuccess message;
+    message.request_id = reader.u32();
+    message.channel_id = reader.u32();
+    message.target = reader.u256();
+    message.extranonce_prefix = reader.b0_32();
+    message.group_channel_id = reader.u32();
+    if (!reader.ok()) return std::nullopt;
+    return message;
+}
+
+std::optional<NewMiningJob> NewMiningJob::decode(ByteSpan payload) {
+    Reader reader(payload);
+    NewMiningJob message;
+    message.channel_id = reader.u32();
+    message.job_id = reader.u32();
+    message.min_ntime = reader.option_u32();
+    message.version = reader.u32();
+    message.merkle_root = reader.u256();
+    if (!reader.ok()) return std::nullopt;
+    return message;
+}
+
+std::optional<SetNewPrevHash> SetNewPrevHash::decode(ByteSpan payload) {
+    Reader reader(payload);
+    SetNewPrevHash message;
+    message.channel_id = reader.u32();
+    message.job_id = reader.u32();
+    message.prev_hash = reader.u256();
+    message.min_ntime = reader.u32();
+    message.nbits = reader.u32();
+    if (!reader.ok()) return std::nullopt;
+    return message;
+}
+
+std::optional<SetTarget> SetTarget::decode(ByteSpan payload) {
+    Reader reader(payload);
+    SetTarget message;
+    message.channel_id = reader.u32();
+    message.maximum_target = reader.u256();
+    if (!reader.ok()) return std::nullopt;
+    return message;
+}
+
+Bytes SubmitSharesStandard::encode() const {
+    Writer writer;
+    writer.u32(channel_id);
+    writer.u32(sequence_number);
+    writer.u32(job_id);
+    writer.u32(nonce);
+    writer.u32(ntime);
+    writer.u32(version);
+    return make_frame(msg::SUBMIT_SHARES_STANDARD, true, writer.data());
+}
+
+double target_to_difficulty(const Hash256& target) noexcept {
+    // Target сложности 1: 0xFFFF * 2^208
+    long double value = 0;
+    for (std::size_t i = target.size(); i-- > 0;) {
+        value = value * 256 + target[i];
+    }
+    if (value == 0) {
+        return 0.0;
+    }
+    return static_cast<double>(std::ldexp(65535.0L, 208) / value);
+}
+
+} // namespace quaxis::fallback::sv2
@@ -0,0 +1,271 @@
+/**
+ * @file sv2_codec.hpp
+ * @brief Кодек кадров и сообщений Stratum V2 (mining protocol)
+ *
+ * Кадр SV2: заголовок 6 байт и payload.
+ * - extension_type[2] (LE): 0 - базовый протокол, старший бит - сообщение
+ *   канала (channel_msg)
+ * - msg_type[1]
+ * - msg_length[3] (LE): длина payload
+ *
+ * Поля payload - little-endian; STR0_255 и B0_32 - байт длины и данные,
+ * U256 - 32 байта как есть, OPTION[T] - байт 0/1 и T при 1.
+ *
+ * Реализован минимум для standard channel: SetupConnection, открытие
+ * канала, NewMiningJob/SetNewPrevHash/SetTarget и SubmitSharesStandard.
+ * Шифрование Noise не реализовано - кадры идут открытым текстом.
+ */
+
+#pragma once
+
+#include "../core/types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace quaxis::fallback::sv2 {
+
+// =============================================================================
+// Константы
+// =============================================================================
+
+/// @brief Размер заголовка кадра
+inline constexpr std::size_t FRAME_HEADER_SIZE = 6;
+
+/// @brief Наибольшая длина payload (24 бита)
+inline constexpr uint32_t MAX_PAYLOAD_SIZE = 0xFFFFFF;
+
+/// @brief Бит сообщения канала в extension_type
+inline constexpr uint16_t CHANNEL_MSG_BIT = 0x8000;
+
+/// @brief Версия протокола SV2
+inline constexpr uint16_t PROTOCOL_VERSION = 2;
+
+/// @brief Подпротокол mining в SetupConnection
+inline constexpr uint8_t PROTOCOL_MINING = 0;
+
+/// @brief Флаг SetupConnection: только standard jobs (header-only)
+inline constexpr uint32_t FLAG_REQUIRES_STANDARD_JOBS = 0x01;
+
+/**
+ * @brief Типы сообщений
+ */
+namespace msg {
+inline constexpr uint8_t SETUP_CONNECTION = 0x00;
+inline constexpr uint8_t SETUP_CONNECTION_SUCCESS = 0x01;
+inline constexpr uint8_t SETUP_CONNECTION_ERROR = 0x02;
+inline constexpr uint8_t OPEN_STANDARD_MINING_CHANNEL = 0x10;
+inline constexpr uint8_t OPEN_STANDARD_MINING_CHANNEL_SUCCESS = 0x11;
+inline constexpr uint8_t OPEN_MINING_CHANNEL_ERROR = 0x12;
+inline constexpr uint8_t NEW_MINING_JOB = 0x15;
+inline constexpr uint8_t SUBMIT_SHARES_STANDARD = 0x1a;
+inline constexpr uint8_t SUBMIT_SHARES_SUCCESS = 0x1c;
+inline constexpr uint8_t SUBMIT_SHARES_ERROR = 0x1d;
+inline constexpr uint8_t SET_NEW_PREV_HASH = 0x20;
+inline constexpr uint8_t SET_TARGET = 0x21;
+} // namespace msg
+
+// =============================================================================
+// Кадр
+// =============================================================================
+
+/**
+ * @brief Заголовок кадра
+ */
+struct FrameHeader {
+    uint16_t extension_type{0};
+    uint8_t msg_type{0};
+    uint32_t length{0};
+
+    /// @brief Сообщение адресовано каналу
+    [[nodiscard]] bool channel_msg() const noexcept {
+        return (extension_type & CHANNEL_MSG_BIT) != 0;
+    }
+};
+
+/**
+ * @brief Разобрать заголовок кадра
+ *
+ * @param data Не меньше FRAME_HEADER_SIZE байт
+ */
+[[nodiscard]] std::optional<FrameHeader> parse_frame_header(ByteSpan data) noexcept;
+
+/**
+ * @brief Собрать кадр базового протокола
+ *
+ * @param msg_type Тип сообщения
+ * @param channel_msg Сообщение канала
+ * @param payload Payload (не длиннее MAX_PAYLOAD_SIZE)
+ */
+[[nodiscard]] Bytes make_frame(uint8_t msg_type, bool channel_msg, ByteSpan payload);
+
+// =============================================================================
+// Сериализация полей
+// =============================================================================
+
+/**
+ * @brief Запись полей payload
+ */
+class Writer {
+public:
+    void u8(uint8_t value) { data_.push_back(value); }
+    void u16(uint16_t value);
+    void u32(uint32_t value);
+    void u64(uint64_t value);
+    void f32(float value);
+    void u256(const Hash256& value);
+
+    /// @brief STR0_255 (строка длиннее 255 байт обрезается)
+    void str0_255(std::string_view value);
+
+    /// @brief B0_32 (данные длиннее 32 байт обрезаются)
+    void b0_32(ByteSpan value);
+
+    /// @brief OPTION[U32]
+    void option_u32(std::optional<uint32_t> value);
+
+    [[nodiscard]] const Bytes& data() const noexcept { return data_; }
+
+private:
+    Bytes data_;
+};
+
+/**
+ * @brief Чтение полей payload
+ *
+ * Выход за конец payload не бросает: поле читается нулём, ok() - false.
+ */
+class Reader {
+public:
+    explicit Reader(ByteSpan data) noexcept : data_(data) {}
+
+    [[nodiscard]] uint8_t u8() noexcept;
+    [[nodiscard]] uint16_t u16() noexcept;
+    [[nodiscard]] uint32_t u32() noexcept;
+    [[nodiscard]] uint64_t u64() noexcept;
+    [[nodiscard]] Hash256 u256() noexcept;
+    [[nodiscard]] std::string str0_255();
+    [[nodiscard]] Bytes b0_32();
+    [[nodiscard]] std::optional<uint32_t> option_u32() noexcept;
+
+    /// @brief Все поля прочитаны в пределах payload
+    [[nodiscard]] bool ok() const noexcept { return ok_; }
+
+private:
+    [[nodiscard]] const uint8_t* take(std::size_t size) noexcept;
+
+    ByteSpan data_;
+    std::size_t pos_{0};
+    bool ok_{true};
+};
+
+// =============================================================================
+// Сообщения
+// =============================================================================
+
+/**
+ * @brief SetupConnection (клиент -> пул)
+ */
+struct SetupConnection {
+    uint8_t protocol{PROTOCOL_MINING};
+    uint16_t min_version{PROTOCOL_VERSION};
+    uint16_t max_version{PROTOCOL_VERSION};
+    uint32_t flags{FLAG_REQUIRES_STANDARD_JOBS};
+    std::string endpoint_host;
+    uint16_t endpoint_port{0};
+    std::string vendor{"quaxis"};
+    std::string hardware_version;
+    std::string firmware;
+    std::string device_id;
+
+    [[nodiscard]] Bytes encode() const;
+};
+
+/**
+ * @brief OpenStandardMiningChannel (клиент -> пул)
+ */
+struct OpenStandardMiningChannel {
+    uint32_t request_id{0};
+    std::string user_identity;
+    float nominal_hash_rate{0.0f};
+    Hash256 max_target{};
+
+    [[nodiscard]] Bytes encode() const;
+};
+
+/**
+ * @brief OpenStandardMiningChannel.Success (пул -> клиент)
+ */
+struct OpenStandardMiningChannelSuccess {
+    uint32_t request_id{0};
+    uint32_t channel_id{0};
+    Hash256 target{};
+    Bytes extranonce_prefix;
+    uint32_t group_channel_id{0};
+
+    [[nodiscard]] static std::optional<OpenStandardMiningChannelSuccess> decode(ByteSpan payload);
+};
+
+/**
+ * @brief NewMiningJob (пул -> клиент)
+ *
+ * Без min_ntime - future job: станет активным по SetNewPrevHash.
+ */
+struct NewMiningJob {
+    uint32_t channel_id{0};
+    uint32_t job_id{0};
+    std::optional<uint32_t> min_ntime;
+    uint32_t version{0};
+    Hash256 merkle_root{};
+
+    [[nodiscard]] static std::optional<NewMiningJob> decode(ByteSpan payload);
+};
+
+/**
+ * @brief SetNewPrevHash (пул -> клиент)
+ */
+struct SetNewPrevHash {
+    uint32_t channel_id{0};
+    uint32_t job_id{0};
+    Hash256 prev_hash{};
+    uint32_t min_ntime{0};
+    uint32_t nbits{0};
+
+    [[nodiscard]] static std::optional<SetNewPrevHash> decode(ByteSpan payload);
+};
+
+/**
+ * @brief SetTarget (пул -> клиент)
+ */
+struct SetTarget {
+    uint32_t channel_id{0};
+    Hash256 maximum_target{};
+
+    [[nodiscard]] static std::optional<SetTarget> decode(ByteSpan payload);
+};
+
+/**
+ * @brief SubmitSharesStandard (клиент -> пул)
+ */
+struct SubmitSharesStandard {
+    uint32_t channel_id{0};
+    uint32_t sequence_number{0};
+    uint32_t job_id{0};
+    uint32_t nonce{0};
+    uint32_t ntime{0};
+    uint32_t version{0};
+
+    [[nodiscard]] Bytes encode() const;
+};
+
+/**
+ * @brief Сложность share по target (U256, little-endian)
+ *
+ * difficulty = target сложности 1 / target; 0 для нулевого target.
+ */
+[[nodiscard]] double target_to_difficulty(const Hash256& target) noexcept;
+
+} // namespace quaxis::fallback::sv2
@@ -4,14 +4,19 @@
  */
 
 #include "status_reporter.hpp"
+#include "../core/thread_plan.hpp"
 
 #include <algorithm>
+#include <bit>
 #include <chrono>
+#include <cstring>
 #include <format>
 #include <iomanip>
 #include <iostream>
 #include <sstream>
 
+#include <unistd.h>
+
 namespace quaxis::log {
 
 // =============================================================================
@@ -36,10 +41,213 @@ namespace ansi {
     constexpr const char* CLEAR_SCREEN = "\033[2J";
     constexpr const char* HOME = "\033[H";
     constexpr const char* CLEAR_LINE = "\033[2K";
+    constexpr const char* CLEAR_TO_EOL = "\033[K";
+    constexpr const char* CLEAR_TO_END = "\033[J";
     constexpr const char* SAVE_CURSOR = "\033[s";
     constexpr const char* RESTORE_CURSOR = "\033[u";
 }
 
+// =============================================================================
+// Кольцо событий
+// =============================================================================
+
+namespace {
+
+/// @brief Минимальная ёмкость кольца: всплеск событий между кадрами вывода
+constexpr std::size_t MIN_EVENT_RING_CAPACITY = 1024;
+
+/// @brief Интернируемых имён chain (больше - события без имени)
+constexpr std::size_t MAX_CHAIN_NAMES = 64;
+
+/// @brief Байт имени chain (длиннее - обрезается)
+constexpr std::size_t CHAIN_NAME_SIZE = 32;
+
+/**
+ * @brief Кольцо событий: много производителей, один потребитель
+ *
+ * Ограниченная очередь Вьюкова, как ShareQueue: производитель занимает
+ * ячейку одним CAS и пишет запись на месте. Забирает только поток
+ * вывода, поэтому голова - обычный счётчик под его мьютексом.
+ */
+class EventRing {
+public:
+    explicit EventRing(std::size_t capacity)
+        : mask_(std::bit_ceil(std::max(capacity, MIN_EVENT_RING_CAPACITY)) - 1)
+        , cells_(std::make_unique<Cell[]>(mask_ + 1))
+    {
+        for (std::size_t i = 0; i <= mask_; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Добавить запись
+     *
+     * @return false если кольцо заполнено (вывод не успевает забирать)
+     */
+    [[nodiscard]] bool try_push(const EventRecord& record) noexcept {
+        std::size_t pos = tail_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells_[pos & mask_];
+            std::size_t seq = cell.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+            if (diff == 0) {
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.record = record;
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Забрать запись (только один поток одновременно)
+     *
+     * @return false если кольцо пусто или следующая запись ещё пишется
+     */
+    [[nodiscard]] bool try_pop(EventRecord& record) noexcept {
+        Cell& cell = cells_[head_ & mask_];
+        if (cell.sequence.load(std::memory_order_acquire) != head_ + 1) {
+            return false;
+        }
+        record = cell.record;
+        cell.sequence.store(head_ + mask_ + 1, std::memory_order_release);
+        ++head_;
+        return true;
+    }
+
+private:
+    struct Cell {
+        std::atomic<std::size_t> sequence{0};
+        EventRecord record;
+    };
+
+    std::size_t mask_;
+    std::unique_ptr<Cell[]> cells_;
+
+    alignas(64) std::atomic<std::size_t> tail_{0};
+    alignas(64) std::size_t head_ = 0;
+};
+
+/**
+ * @brief Таблица интернированных имён chain
+ *
+ * Поиск без блокировок: имена только добавляются, и слот публикуется
+ * release-записью счётчика после заполнения. Добавление (первое событие
+ * новой chain) сериализуется мьютексом.
+ */
+class ChainNames {
+public:
+    /**
+     * @brief Номер имени (1..MAX_CHAIN_NAMES), 0 - пустое имя или таблица полна
+     */
+    [[nodiscard]] uint16_t intern(std::string_view name) noexcept {
+        if (name.empty()) {
+            return 0;
+        }
+        name = name.substr(0, CHAIN_NAME_SIZE);
+        if (auto id = find(name, count_.load(std::memory_order_acquire))) {
+            return id;
+        }
+
+        std::lock_guard<std::mutex> lock(insert_mutex_);
+        const std::size_t count = count_.load(std::memory_order_relaxed);
+        if (auto id = find(name, count)) {
+            return id;
+        }
+        if (count == MAX_CHAIN_NAMES) {
+            return 0;
+        }
+        std::memcpy(slots_[count].name.data(), name.data(), name.size());
+        slots_[count].size = static_cast<uint8_t>(name.size());
+        count_.store(count + 1, std::memory_order_release);
+        return static_cast<uint16_t>(count + 1);
+    }
+
+    /**
+     * @brief Имя по номеру (пустое для 0)
+     */
+    [[nodiscard]] std::string_view name(uint16_t id) const noexcept {
+        if (id == 0 || id > count_.load(std::memory_order_acquire)) {
+            return {};
+        }
+        const auto& slot = slots_[id - 1];
+        return {slot.name.data(), slot.size};
+    }
+
+private:
+    struct Slot {
+        std::array<char, CHAIN_NAME_SIZE> name{};
+        uint8_t size = 0;
+    };
+
+    [[nodiscard]] uint16_t find(std::string_view name, std::size_t count) const noexcept {
+        for (std::size_t i = 0; i < count; ++i) {
+            if (std::string_view(slots_[i].name.data(), slots_[i].size) == name) {
+                return static_cast<uint16_t>(i + 1);
+            }
+        }
+        return 0;
+    }
+
+    std::array<Slot, MAX_CHAIN_NAMES> slots_{};
+    std::atomic<std::size_t> count_{0};
+    std::mutex insert_mutex_;
+};
+
+/**
+ * @brief Секция экрана (в порядке вывода)
+ */
+enum class Section : uint8_t {
+    Header,
+    Uptime,
+    Bitcoin,    ///< update_bitcoin_stats
+    Asic,       ///< update_asic_stats (хешрейт и ASIC)
+    Source,     ///< update_fallback_mode
+    Shm,        ///< update_shm_stats
+    Latency,    ///< update_latency_stats
+    StaleWork,  ///< update_stale_work_stats
+    Chains,     ///< update_active_chains, update_block_count
+    Events,     ///< Кольцо событий
+    Footer,
+    Count
+};
+
+constexpr std::size_t SECTION_COUNT = static_cast<std::size_t>(Section::Count);
+
+constexpr uint32_t section_bit(Section section) noexcept {
+    return 1u << static_cast<uint32_t>(section);
+}
+
+constexpr uint32_t ALL_SECTIONS = (1u << SECTION_COUNT) - 1;
+
+/// @brief Секции из данных под data_mutex
+constexpr uint32_t DATA_SECTIONS =
+    section_bit(Section::Bitcoin) | section_bit(Section::Asic) | section_bit(Section::Source) |
+    section_bit(Section::Shm) | section_bit(Section::Latency) | section_bit(Section::StaleWork) |
+    section_bit(Section::Chains);
+
+/**
+ * @brief Заполнить запись события (текст обрезается до EVENT_TEXT_SIZE)
+ */
+EventRecord make_record(EventType type, EventFormat format, std::string_view text) noexcept {
+    EventRecord record;
+    record.timestamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    record.type = type;
+    record.format = format;
+    record.text_size = static_cast<uint8_t>(std::min(text.size(), EVENT_TEXT_SIZE));
+    std::memcpy(record.text.data(), text.data(), record.text_size);
+    return record;
+}
+
+} // anonymous namespace
+
 // =============================================================================
 // Реализация
 // =============================================================================
@@ -52,24 +260,92 @@ struct StatusReporter::Impl {
     std::thread render_thread;
     std::chrono::steady_clock::time_point start_time;
     
+    // Общий исполнитель: вывод - таймер колеса вместо render_thread
+    core::Executor* executor = nullptr;
+    core::Executor::TimerId render_timer = 0;
+    
     // Данные
     BitcoinStats bitcoin_stats;
     AsicStats asic_stats;
     ShmStats shm_stats;
+    std::vector<LatencyStats> latency_stats;
+    StaleWorkStats stale_work_stats;
     fallback::FallbackMode fallback_mode = fallback::FallbackMode::PrimarySHM;
     std::vector<std::string> active_chains;
     std::unordered_map<std::string, uint64_t> block_counts;
     
-    // События
-    std::deque<EventRecord> events;
+    // События: производители пишут в ring, поток вывода переносит записи
+    // в events под events_mutex (мьютекс только между потребителями)
+    mutable EventRing ring;
+    ChainNames chain_names;
+    std::atomic<uint64_t> dropped_events{0};
+    mutable std::deque<EventRecord> events;
     mutable std::mutex events_mutex;
     
+    // Разностный вывод: update_* помечают секции, кадр пересобирает только
+    // помеченные и печатает только изменившиеся строки (только поток вывода)
+    std::atomic<uint32_t> dirty_sections{ALL_SECTIONS};
+    bool headless = false;
+    bool frame_cached = false;
+    uint64_t rendered_dropped = 0;
+    std::array<std::string, SECTION_COUNT> section_cache;
+    std::vector<std::string> screen_lines;
+    
     // Защита данных
     mutable std::mutex data_mutex;
     
     explicit Impl(const LoggingConfig& cfg) 
         : config(cfg)
-        , start_time(std::chrono::steady_clock::now()) {}
+        , start_time(std::chrono::steady_clock::now())
+        , ring(cfg.event_history) {}
+    
+    void push_event(const EventRecord& record) noexcept {
+        if (!ring.try_push(record)) {
+            dropped_events.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    
+    /**
+     * @brief Перенести записи из кольца в историю (под events_mutex)
+     */
+    std::size_t drain_events() const {
+        EventRecord record;
+        std::size_t drained = 0;
+        while (ring.try_pop(record)) {
+            events.push_back(record);
+            ++drained;
+        }
+        while (events.size() > config.event_history) {
+            events.pop_front();
+        }
+        return drained;
+    }
+    
+    void mark_dirty(Section section) noexcept {
+        dirty_sections.fetch_or(section_bit(section), std::memory_order_release);
+    }
+    
+    /**
+     * @brief Собрать сообщение записи
+     */
+    static void format_message(std::ostream& out, const EventRecord& event) {
+        switch (event.format) {
+            case EventFormat::Text:
+                out << event.text_view();
+                break;
+            case EventFormat::Height:
+                out << event.text_view() << " at height " << event.height;
+                break;
+            case EventFormat::Fallback:
+                if (event.type == EventType::FALLBACK_EXIT) {
+                    out << "Restored to " << fallback::to_string(event.to_mode);
+                } else {
+                    out << "Switched from " << fallback::to_string(event.from_mode)
+                        << " to " << fallback::to_string(event.to_mode);
+                }
+                break;
+        }
+    }
     
     void render_loop() {
         while (running) {
@@ -80,19 +356,122 @@ struct StatusReporter::Impl {
         }
     }
     
+    /**
+     * @brief Кадр таймера: пересобираются только изменившиеся секции,
+     *        в терминал уходят только изменившиеся строки
+     */
     void render_status() {
-        std::string output = render_impl(config.color);
+        bool changed = false;
+        std::string frame = render_frame(changed);
+        
+        if (!config.color) {
+            // Без управления курсором кадр печатается целиком, поэтому
+            // только если изменилось что-то кроме uptime
+            if (changed) {
+                std::cout << frame << std::flush;
+            }
+            return;
+        }
         
-        // Перемещаем курсор в начало и выводим
-        if (config.color) {
-            std::cout << ansi::HOME << output << std::flush;
-        } else {
-            // В режиме без цветов просто добавляем разделитель
+        std::vector<std::string> lines = split_lines(frame);
+        std::string output;
+        for (std::size_t i = 0; i < lines.size(); ++i) {
+            if (i < screen_lines.size() && screen_lines[i] == lines[i]) {
+                continue;
+            }
+            output += std::format("\033[{};1H", i + 1);
+            output += lines[i];
+            output += ansi::CLEAR_TO_EOL;
+        }
+        if (lines.size() < screen_lines.size()) {
+            output += std::format("\033[{};1H", lines.size() + 1);
+            output += ansi::CLEAR_TO_END;
+        }
+        screen_lines = std::move(lines);
+        
+        if (!output.empty()) {
             std::cout << output << std::flush;
         }
     }
     
+    static std::vector<std::string> split_lines(std::string_view text) {
+        std::vector<std::string> lines;
+        std::size_t start = 0;
+        while (start < text.size()) {
+            std::size_t end = text.find('\n', start);
+            if (end == std::string_view::npos) {
+                end = text.size();
+            }
+            lines.emplace_back(text.substr(start, end - start));
+            start = end + 1;
+        }
+        return lines;
+    }
+    
+    /**
+     * @brief Собрать кадр из кеша секций (только поток вывода)
+     * 
+     * @param changed Изменилось ли что-то кроме uptime
+     */
+    std::string render_frame(bool& changed) {
+        uint32_t dirty = dirty_sections.exchange(0, std::memory_order_acq_rel);
+        if (!frame_cached) {
+            dirty = ALL_SECTIONS;
+            frame_cached = true;
+        }
+        
+        // События: записи в кольце или новые потери
+        {
+            std::lock_guard<std::mutex> events_lock(events_mutex);
+            const uint64_t dropped = dropped_events.load(std::memory_order_relaxed);
+            if (drain_events() > 0 || dropped != rendered_dropped) {
+                dirty |= section_bit(Section::Events);
+                rendered_dropped = dropped;
+            }
+        }
+        changed = dirty != 0;
+        dirty |= section_bit(Section::Uptime);
+        
+        const bool use_color = config.color;
+        if (dirty & DATA_SECTIONS) {
+            std::lock_guard<std::mutex> lock(data_mutex);
+            for (std::size_t i = 0; i < SECTION_COUNT; ++i) {
+                if ((dirty & (1u << i)) && (DATA_SECTIONS & (1u << i))) {
+                    section_cache[i] = render_section(static_cast<Section>(i), use_color);
+                }
+            }
+        }
+        for (std::size_t i = 0; i < SECTION_COUNT; ++i) {
+            if ((dirty & (1u << i)) && !(DATA_SECTIONS & (1u << i))) {
+                section_cache[i] = render_section(static_cast<Section>(i), use_color);
+            }
+        }
+        
+        std::string frame;
+        for (const auto& section : section_cache) {
+            frame += section;
+        }
+        return frame;
+    }
+    
+    /**
+     * @brief Полный кадр без кеша (render() / render_plain())
+     */
     std::string render_impl(bool use_color) const {
+        std::string frame;
+        std::lock_guard<std::mutex> lock(data_mutex);
+        for (std::size_t i = 0; i < SECTION_COUNT; ++i) {
+            frame += render_section(static_cast<Section>(i), use_color);
+        }
+        return frame;
+    }
+    
+    /**
+     * @brief Текст секции
+     * 
+     * Секции данных вызываются под data_mutex, Events берёт events_mutex сама.
+     */
+    std::string render_section(Section section, bool use_color) const {
         std::ostringstream out;
         
         const char* bold = use_color ? ansi::BOLD : "";
@@ -103,108 +482,146 @@ struct StatusReporter::Impl {
         const char* cyan = use_color ? ansi::CYAN : "";
         const char* dim = use_color ? ansi::DIM : "";
         
-        std::lock_guard<std::mutex> lock(data_mutex);
-        
-        // === Заголовок ===
-        out << bold << "═══════════════════════════════════════════════════════════════════\n"
-            << "                    QUAXIS SOLO MINER v1.0.0\n"
-            << "═══════════════════════════════════════════════════════════════════" << reset << "\n\n";
-        
-        // === Uptime ===
-        auto now = std::chrono::steady_clock::now();
-        auto uptime = std::chrono::duration_cast<std::chrono::seconds>(now - start_time);
-        auto hours = uptime.count() / 3600;
-        auto minutes = (uptime.count() % 3600) / 60;
-        auto seconds = uptime.count() % 60;
+        switch (section) {
+        case Section::Header:
+            out << bold << "═══════════════════════════════════════════════════════════════════\n"
+                << "                    QUAXIS SOLO MINER v1.0.0\n"
+                << "═══════════════════════════════════════════════════════════════════" << reset << "\n\n";
+            break;
         
-        out << bold << "Uptime: " << reset
-            << std::setfill('0') << std::setw(2) << hours << ":"
-            << std::setw(2) << minutes << ":"
-            << std::setw(2) << seconds << "\n\n";
-        
-        // === Bitcoin Status ===
-        out << bold << "Bitcoin:" << reset << "\n";
-        out << "  Height: " << bitcoin_stats.height;
-        if (bitcoin_stats.tip_age_seconds > 0) {
-            out << " (tip age: " << bitcoin_stats.tip_age_seconds << "s)";
-        }
-        out << "\n";
-        out << "  Connection: ";
-        if (bitcoin_stats.connected) {
-            out << green << "CONNECTED" << reset;
-        } else {
-            out << red << "DISCONNECTED" << reset;
+        case Section::Uptime: {
+            auto now = std::chrono::steady_clock::now();
+            auto uptime = std::chrono::duration_cast<std::chrono::seconds>(now - start_time);
+            auto hours = uptime.count() / 3600;
+            auto minutes = (uptime.count() % 3600) / 60;
+            auto seconds = uptime.count() % 60;
+            
+            out << bold << "Uptime: " << reset
+                << std::setfill('0') << std::setw(2) << hours << ":"
+                << std::setw(2) << minutes << ":"
+                << std::setw(2) << seconds << "\n\n";
+            break;
         }
-        out << "\n\n";
         
-        // === Hashrate ===
-        if (config.show_hashrate) {
-            out << bold << "Hashrate:" << reset << "\n";
-            double hashrate = asic_stats.estimated_hashrate_ths > 0 
-                ? asic_stats.estimated_hashrate_ths 
-                : config.rated_ths;
-            out << "  " << std::fixed << std::setprecision(1) << hashrate << " TH/s";
-            if (asic_stats.estimated_hashrate_ths == 0) {
-                out << dim << " (rated)" << reset;
+        case Section::Bitcoin:
+            out << bold << "Bitcoin:" << reset << "\n";
+            out << "  Height: " << bitcoin_stats.height;
+            if (bitcoin_stats.tip_age_seconds > 0) {
+                out << " (tip age: " << bitcoin_stats.tip_age_seconds << "s)";
+            }
+            out << "\n";
+            out << "  Connection: ";
+            if (bitcoin_stats.connected) {
+                out << green << "CONNECTED" << reset;
+            } else {
+                out << red << "DISCONNECTED" << reset;
             }
             out << "\n\n";
-        }
+            break;
         
-        // === ASIC Status ===
-        out << bold << "ASIC:" << reset << "\n";
-        out << "  Connected: " << asic_stats.connected_count << "\n";
-        if (asic_stats.temperature_avg > 0) {
-            out << "  Avg Temp: " << std::fixed << std::setprecision(1) 
-                << asic_stats.temperature_avg << "°C\n";
-        }
-        out << "\n";
+        case Section::Asic:
+            if (config.show_hashrate) {
+                out << bold << "Hashrate:" << reset << "\n";
+                double hashrate = asic_stats.estimated_hashrate_ths > 0 
+                    ? asic_stats.estimated_hashrate_ths 
+                    : config.rated_ths;
+                out << "  " << std::fixed << std::setprecision(1) << hashrate << " TH/s";
+                if (asic_stats.estimated_hashrate_ths == 0) {
+                    out << dim << " (rated)" << reset;
+                }
+                out << "\n\n";
+            }
+            
+            out << bold << "ASIC:" << reset << "\n";
+            out << "  Connected: " << asic_stats.connected_count << "\n";
+            if (asic_stats.temperature_avg > 0) {
+                out << "  Avg Temp: " << std::fixed << std::setprecision(1) 
+                    << asic_stats.temperature_avg << "°C\n";
+            }
+            out << "\n";
+            break;
         
-        // === Fallback Status ===
-        out << bold << "Source:" << reset << " ";
-        switch (fallback_mode) {
-            case fallback::FallbackMode::PrimarySHM:
-                out << green << "SHM (Primary)" << reset;
-                break;
-            case fallback::FallbackMode::FallbackZMQ:
-                out << yellow << "ZMQ (Fallback)" << reset;
-                break;
-            case fallback::FallbackMode::FallbackStratum:
-                out << yellow << "Stratum (Fallback)" << reset;
-                break;
-        }
-        out << "\n";
+        case Section::Source:
+            out << bold << "Source:" << reset << " ";
+            switch (fallback_mode) {
+                case fallback::FallbackMode::PrimarySHM:
+                    out << green << "SHM (Primary)" << reset;
+                    break;
+                case fallback::FallbackMode::FallbackZMQ:
+                    out << yellow << "ZMQ (Fallback)" << reset;
+                    break;
+                case fallback::FallbackMode::FallbackStratum:
+                    out << yellow << "Stratum (Fallback)" << reset;
+                    break;
+            }
+            out << "\n";
+            break;
         
-        // === SHM Status ===
-        out << bold << "SHM:" << reset << "\n";
-        out << "  Spin Wait: " << (shm_stats.spin_wait_active ? "active" : "polling") << "\n";
-        if (shm_stats.adaptive_mode) {
-            out << "  Adaptive: enabled\n";
-        }
-        out << "  CPU Usage: " << std::fixed << std::setprecision(1) 
-            << shm_stats.cpu_usage_percent << "%\n\n";
+        case Section::Shm:
+            out << bold << "SHM:" << reset << "\n";
+            out << "  Spin Wait: " << (shm_stats.spin_wait_active ? "active" : "polling") << "\n";
+            if (shm_stats.adaptive_mode) {
+                out << "  Adaptive: enabled\n";
+            }
+            out << "  CPU Usage: " << std::fixed << std::setprecision(1) 
+                << shm_stats.cpu_usage_percent << "%\n\n";
+            break;
         
-        // === Active Merged Chains ===
-        out << bold << "Merged Mining Chains:" << reset << "\n";
-        if (active_chains.empty()) {
-            out << "  " << dim << "(none)" << reset << "\n";
-        } else {
-            for (const auto& chain : active_chains) {
-                out << "  • " << chain;
-                if (config.show_chain_block_counts) {
-                    auto it = block_counts.find(chain);
-                    if (it != block_counts.end() && it->second > 0) {
-                        out << " (" << cyan << it->second << " blocks" << reset << ")";
-                    }
+        case Section::Latency:
+            if (!latency_stats.empty()) {
+                out << bold << "Latency (us from block):" << reset << "\n";
+                for (const auto& stage : latency_stats) {
+                    out << "  " << std::left << std::setfill(' ') << std::setw(16) << stage.stage << std::right
+                        << std::fixed << std::setprecision(1)
+                        << " p50=" << stage.p50_us
+                        << " p90=" << stage.p90_us
+                        << " p99=" << stage.p99_us
+                        << " max=" << stage.max_us
+                        << dim << " (" << stage.count << ")" << reset << "\n";
                 }
                 out << "\n";
             }
-        }
-        out << "\n";
+            break;
         
-        // === Recent Events ===
-        out << bold << "Recent Events:" << reset << "\n";
-        {
+        case Section::StaleWork:
+            if (stale_work_stats.events > 0) {
+                out << bold << "Stale Work (TH):" << reset << "\n";
+                out << std::fixed << std::setprecision(3)
+                    << "  Total: pipeline=" << stale_work_stats.pipeline_th
+                    << " switch=" << stale_work_stats.unit_switch_th
+                    << " speculative=" << stale_work_stats.speculative_th
+                    << dim << " (" << stale_work_stats.events << " blocks)" << reset << "\n";
+                out << "  Last:  " << stale_work_stats.last_th
+                    << " at height " << stale_work_stats.last_height
+                    << " via " << stale_work_stats.last_source << std::setprecision(1)
+                    << dim << " (dispatch " << stale_work_stats.last_pipeline_ms
+                    << " ms, slowest ASIC +" << stale_work_stats.last_switch_max_ms << " ms)" << reset << "\n\n";
+            }
+            break;
+        
+        case Section::Chains:
+            out << bold << "Merged Mining Chains:" << reset << "\n";
+            if (active_chains.empty()) {
+                out << "  " << dim << "(none)" << reset << "\n";
+            } else {
+                for (const auto& chain : active_chains) {
+                    out << "  • " << chain;
+                    if (config.show_chain_block_counts) {
+                        auto it = block_counts.find(chain);
+                        if (it != block_counts.end() && it->second > 0) {
+                            out << " (" << cyan << it->second << " blocks" << reset << ")";
+                        }
+                    }
+                    out << "\n";
+                }
+            }
+            out << "\n";
+            break;
+        
+        case Section::Events: {
+            out << bold << "Recent Events:" << reset << "\n";
             std::lock_guard<std::mutex> events_lock(events_mutex);
+            drain_events();
             if (events.empty()) {
                 out << "  " << dim << "(no events)" << reset << "\n";
             } else {
@@ -214,7 +631,10 @@ struct StatusReporter::Impl {
                     const auto& event = events[i];
                     
                     // Время
-                    auto time = std::chrono::system_clock::to_time_t(event.timestamp);
+                    auto time = std::chrono::system_clock::to_time_t(
+                        std::chrono::system_clock::time_point(
+                            std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                                std::chrono::nanoseconds(event.timestamp_ns))));
                     auto tm = *std::localtime(&time);
                     out << "  " << std::put_time(&tm, "%H:%M:%S") << " ";
                     
@@ -247,16 +667,27 @@ struct StatusReporter::Impl {
                     }
                     
                     // Сообщение
-                    out << " " << event.message;
-                    if (!event.chain_name.empty()) {
-                        out << dim << " (" << event.chain_name << ")" << reset;
+                    out << " ";
+                    format_message(out, event);
+                    if (auto chain = chain_names.name(event.chain_id); !chain.empty()) {
+                        out << dim << " (" << chain << ")" << reset;
                     }
                     out << "\n";
                 }
             }
+            if (auto dropped = dropped_events.load(std::memory_order_relaxed); dropped > 0) {
+                out << "  " << dim << "(" << dropped << " events dropped)" << reset << "\n";
+            }
+            break;
         }
         
-        out << "\n" << bold << "───────────────────────────────────────────────────────────────────" << reset << "\n";
+        case Section::Footer:
+            out << "\n" << bold << "───────────────────────────────────────────────────────────────────" << reset << "\n";
+            break;
+        
+        case Section::Count:
+            break;
+        }
         
         return out.str();
     }
@@ -280,13 +711,32 @@ void StatusReporter::start() {
     
     impl_->running = true;
     impl_->start_time = std::chrono::steady_clock::now();
+    impl_->frame_cached = false;
+    impl_->screen_lines.clear();
+    
+    // Без терминала (systemd, перенаправление в файл) экран не рисуется:
+    // события копятся в истории и доступны через render()
+    impl_->headless = impl_->config.display == DisplayMode::Never ||
+        (impl_->config.display == DisplayMode::Auto && !::isatty(STDOUT_FILENO));
+    if (impl_->headless) {
+        return;
+    }
     
     // Очищаем экран если используются цвета
     if (impl_->config.color) {
         std::cout << ansi::CLEAR_SCREEN << ansi::HOME << std::flush;
     }
     
+    if (impl_->executor) {
+        impl_->render_timer = impl_->executor->schedule_every(
+            std::chrono::milliseconds(impl_->config.refresh_interval_ms),
+            [this] { impl_->render_status(); }
+        );
+        return;
+    }
+    
     impl_->render_thread = std::thread([this]() {
+        core::enter_thread_role(core::ThreadRole::Background);
         impl_->render_loop();
     });
 }
@@ -297,85 +747,117 @@ void StatusReporter::stop() {
     if (impl_->render_thread.joinable()) {
         impl_->render_thread.join();
     }
+    if (impl_->render_timer != 0) {
+        impl_->executor->cancel(impl_->render_timer);
+        impl_->render_timer = 0;
+    }
+}
+
+void StatusReporter::set_executor(core::Executor* executor) {
+    impl_->executor = executor;
 }
 
 bool StatusReporter::is_running() const noexcept {
     return impl_->running;
 }
 
+bool StatusReporter::is_headless() const noexcept {
+    return impl_->headless;
+}
+
+void StatusReporter::render_frame() {
+    impl_->render_status();
+}
+
 void StatusReporter::update_bitcoin_stats(const BitcoinStats& stats) {
     std::lock_guard<std::mutex> lock(impl_->data_mutex);
     impl_->bitcoin_stats = stats;
+    impl_->mark_dirty(Section::Bitcoin);
 }
 
 void StatusReporter::update_asic_stats(const AsicStats& stats) {
     std::lock_guard<std::mutex> lock(impl_->data_mutex);
     impl_->asic_stats = stats;
+    impl_->mark_dirty(Section::Asic);
 }
 
 void StatusReporter::update_shm_stats(const ShmStats& stats) {
     std::lock_guard<std::mutex> lock(impl_->data_mutex);
     impl_->shm_stats = stats;
+    impl_->mark_dirty(Section::Shm);
+}
+
+void StatusReporter::update_latency_stats(const std::vector<LatencyStats>& stats) {
+    std::lock_guard<std::mutex> lock(impl_->data_mutex);
+    impl_->latency_stats = stats;
+    impl_->mark_dirty(Section::Latency);
+}
+
+void StatusReporter::update_stale_work_stats(const StaleWorkStats& stats) {
+    std::lock_guard<std::mutex> lock(impl_->data_mutex);
+    impl_->stale_work_stats = stats;
+    impl_->mark_dirty(Section::StaleWork);
 }
 
 void StatusReporter::update_fallback_mode(fallback::FallbackMode mode) {
     std::lock_guard<std::mutex> lock(impl_->data_mutex);
     impl_->fallback_mode = mode;
+    impl_->mark_dirty(Section::Source);
 }
 
 void StatusReporter::update_active_chains(const std::vector<std::string>& chains) {
+    // Имена интернируются заранее: события этих chains не берут блокировку
+    for (const auto& chain : chains) {
+        (void)impl_->chain_names.intern(chain);
+    }
     std::lock_guard<std::mutex> lock(impl_->data_mutex);
     impl_->active_chains = chains;
+    impl_->mark_dirty(Section::Chains);
 }
 
 void StatusReporter::update_block_count(const std::string& chain_name, uint64_t count) {
+    (void)impl_->chain_names.intern(chain_name);
     std::lock_guard<std::mutex> lock(impl_->data_mutex);
     impl_->block_counts[chain_name] = count;
+    impl_->mark_dirty(Section::Chains);
 }
 
-void StatusReporter::log_event(EventType type, const std::string& message,
-                               const std::string& chain_name) {
-    std::lock_guard<std::mutex> lock(impl_->events_mutex);
-    
-    EventRecord record;
-    record.type = type;
-    record.timestamp = std::chrono::system_clock::now();
-    record.message = message;
-    record.chain_name = chain_name;
-    
-    impl_->events.push_back(std::move(record));
-    
-    // Ограничиваем размер истории
-    while (impl_->events.size() > impl_->config.event_history) {
-        impl_->events.pop_front();
-    }
+void StatusReporter::log_event(EventType type, std::string_view message,
+                               std::string_view chain_name) {
+    EventRecord record = make_record(type, EventFormat::Text, message);
+    record.chain_id = impl_->chain_names.intern(chain_name);
+    impl_->push_event(record);
+}
+
+void StatusReporter::log_height_event(EventType type, std::string_view message, uint32_t height) {
+    EventRecord record = make_record(type, EventFormat::Height, message);
+    record.height = height;
+    impl_->push_event(record);
 }
 
 void StatusReporter::log_new_block(uint32_t height) {
-    log_event(EventType::NEW_BLOCK, "New Bitcoin block at height " + std::to_string(height));
+    log_height_event(EventType::NEW_BLOCK, "New Bitcoin block", height);
 }
 
 void StatusReporter::log_aux_block_found(const std::string& chain_name, uint32_t height) {
-    log_event(EventType::AUX_BLOCK_FOUND, 
-              "Found block at height " + std::to_string(height),
-              chain_name);
+    EventRecord record = make_record(EventType::AUX_BLOCK_FOUND, EventFormat::Height, "Found block");
+    record.height = height;
+    record.chain_id = impl_->chain_names.intern(chain_name);
+    impl_->push_event(record);
 }
 
 void StatusReporter::log_btc_block_found(uint32_t height) {
-    log_event(EventType::BTC_BLOCK_FOUND,
-              "FOUND BITCOIN BLOCK at height " + std::to_string(height));
+    log_height_event(EventType::BTC_BLOCK_FOUND, "FOUND BITCOIN BLOCK", height);
 }
 
 void StatusReporter::log_fallback_change(fallback::FallbackMode old_mode,
                                          fallback::FallbackMode new_mode) {
-    if (new_mode == fallback::FallbackMode::PrimarySHM) {
-        log_event(EventType::FALLBACK_EXIT,
-                  std::string("Restored to ") + std::string(fallback::to_string(new_mode)));
-    } else {
-        log_event(EventType::FALLBACK_ENTER,
-                  std::string("Switched from ") + std::string(fallback::to_string(old_mode)) +
-                  " to " + std::string(fallback::to_string(new_mode)));
-    }
+    EventRecord record = make_record(
+        new_mode == fallback::FallbackMode::PrimarySHM ? EventType::FALLBACK_EXIT : EventType::FALLBACK_ENTER,
+        EventFormat::Fallback, {});
+    record.from_mode = old_mode;
+    record.to_mode = new_mode;
+    impl_->push_event(record);
     
     update_fallback_mode(new_mode);
 }
@@ -388,10 +870,14 @@ void StatusReporter::log_submit(bool success, const std::string& chain_name) {
     }
 }
 
-void StatusReporter::log_error(const std::string& message) {
+void StatusReporter::log_error(std::string_view message) {
     log_event(EventType::ERROR, message);
 }
 
+uint64_t StatusReporter::dropped_events() const noexcept {
+    return impl_->dropped_events.load(std::memory_order_relaxed);
+}
+
 std::string StatusReporter::render_plain() const {
     return impl_->render_impl(false);
 }
@@ -10,14 +10,26 @@
  * - Счётчики найденных блоков по каждой chain
  * - Состояние fallback
  * - Адаптивное состояние spin и примерная загрузка CPU SHM
+ * - Перцентили латентности этапов от прихода блока (если трассировка включена)
  * - Кольцевой буфер событий
+ *
+ * Кадр разностный: update_* помечают свои секции, таймер пересобирает
+ * только помеченные и отправляет в терминал только изменившиеся строки
+ * (позиционирование курсора ANSI). Без терминала экран не рисуется.
+ *
+ * События пишутся из горячих путей (смена tip, отправка блоков), поэтому
+ * log_event() не берёт мьютексов и не аллоцирует: запись фиксированного
+ * размера кладётся в lock-free кольцо (много производителей, один
+ * потребитель), а в строки её форматирует только поток вывода.
  */
 
 #pragma once
 
 #include "../core/types.hpp"
+#include "../core/executor.hpp"
 #include "../fallback/fallback_manager.hpp"
 
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <deque>
@@ -25,7 +37,9 @@
 #include <memory>
 #include <mutex>
 #include <string>
+#include <string_view>
 #include <thread>
+#include <type_traits>
 #include <unordered_map>
 #include <vector>
 
@@ -67,19 +81,56 @@ enum class EventType {
 }
 
 /**
- * @brief Запись события
+ * @brief Как поток вывода собирает сообщение из записи
+ */
+enum class EventFormat : uint8_t {
+    Text,       ///< text как есть
+    Height,     ///< "<text> at height <height>"
+    Fallback    ///< "Restored to <to>" / "Switched from <from> to <to>"
+};
+
+/// @brief Байт текста, хранимых в записи (длиннее - обрезается)
+inline constexpr std::size_t EVENT_TEXT_SIZE = 64;
+
+/**
+ * @brief Запись события фиксированного размера
+ *
+ * Копируется в ячейку кольца целиком, без аллокаций. Имя chain хранится
+ * номером в таблице интернированных имён репортёра.
  */
 struct EventRecord {
-    EventType type;
-    std::chrono::system_clock::time_point timestamp;
-    std::string message;
-    std::string chain_name;  ///< Для событий связанных с chain
+    int64_t timestamp_ns = 0;      ///< system_clock, нс от эпохи
+    uint32_t height = 0;           ///< Для EventFormat::Height
+    uint16_t chain_id = 0;         ///< Интернированное имя chain (0 - нет)
+    EventType type = EventType::ERROR;
+    EventFormat format = EventFormat::Text;
+    fallback::FallbackMode from_mode = fallback::FallbackMode::PrimarySHM;
+    fallback::FallbackMode to_mode = fallback::FallbackMode::PrimarySHM;
+    uint8_t text_size = 0;
+    std::array<char, EVENT_TEXT_SIZE> text{};
+
+    /// @brief Текст записи
+    [[nodiscard]] std::string_view text_view() const noexcept {
+        return {text.data(), text_size};
+    }
 };
 
+static_assert(std::is_trivially_copyable_v<EventRecord>,
+              "EventRecord копируется в ячейку кольца без синхронизации полей");
+
 // =============================================================================
 // Конфигурация
 // =============================================================================
 
+/**
+ * @brief Когда рисовать экран статуса
+ */
+enum class DisplayMode {
+    Auto,       ///< Только если stdout - терминал
+    Always,     ///< Всегда (например, в файл без ANSI)
+    Never       ///< Никогда: только история событий
+};
+
 /**
  * @brief Конфигурация логирования
  */
@@ -96,6 +147,9 @@ struct LoggingConfig {
     /// @brief Использовать цветной вывод
     bool color = true;
     
+    /// @brief Когда рисовать экран
+    DisplayMode display = DisplayMode::Auto;
+    
     /// @brief Показывать хешрейт
     bool show_hashrate = true;
     
@@ -140,6 +194,33 @@ struct ShmStats {
     bool adaptive_mode = false;
 };
 
+/**
+ * @brief Латентность этапа от прихода блока (core::collect_trace)
+ */
+struct LatencyStats {
+    std::string stage;
+    uint64_t count = 0;
+    double p50_us = 0.0;
+    double p90_us = 0.0;
+    double p99_us = 0.0;
+    double max_us = 0.0;
+};
+
+/**
+ * @brief Потерянная работа (mining::StaleWorkAccountant)
+ */
+struct StaleWorkStats {
+    uint64_t events = 0;
+    double pipeline_th = 0.0;        ///< Сумма: приход tip -> рассылка
+    double unit_switch_th = 0.0;     ///< Сумма: рассылка -> загрузка ASIC
+    double speculative_th = 0.0;     ///< Сумма: отменённые speculative блоки
+    uint32_t last_height = 0;        ///< Последнее событие (0 - ещё не было)
+    std::string last_source;
+    double last_th = 0.0;
+    double last_pipeline_ms = 0.0;
+    double last_switch_max_ms = 0.0;
+};
+
 /**
  * @brief Информация о merged chain
  */
@@ -185,11 +266,26 @@ public:
      */
     void stop();
     
+    /**
+     * @brief Выводить статус таймером общего исполнителя
+     * 
+     * Вызывать до start(). Без исполнителя вывод идёт в своём потоке.
+     * Исполнитель должен пережить stop() репортёра.
+     */
+    void set_executor(core::Executor* executor);
+    
     /**
      * @brief Проверить, запущен ли репортёр
      */
     [[nodiscard]] bool is_running() const noexcept;
     
+    /**
+     * @brief Экран не рисуется (DisplayMode::Never или stdout не терминал)
+     * 
+     * Определяется в start().
+     */
+    [[nodiscard]] bool is_headless() const noexcept;
+    
     // ==========================================================================
     // Обновление данных
     // ==========================================================================
@@ -209,6 +305,16 @@ public:
      */
     void update_shm_stats(const ShmStats& stats);
     
+    /**
+     * @brief Обновить латентность этапов (пустой список скрывает секцию)
+     */
+    void update_latency_stats(const std::vector<LatencyStats>& stats);
+    
+    /**
+     * @brief Обновить учёт потерянной работы (без событий секция скрыта)
+     */
+    void update_stale_work_stats(const StaleWorkStats& stats);
+    
     /**
      * @brief Обновить режим fallback
      */
@@ -230,9 +336,21 @@ public:
     
     /**
      * @brief Записать событие
+     * 
+     * Не блокирует и не аллоцирует: message длиннее EVENT_TEXT_SIZE
+     * обрезается, при переполненном кольце событие отбрасывается и
+     * учитывается в dropped_events(). Имя chain интернируется (первое
+     * появление нового имени берёт короткую блокировку).
      */
-    void log_event(EventType type, const std::string& message, 
-                   const std::string& chain_name = "");
+    void log_event(EventType type, std::string_view message, 
+                   std::string_view chain_name = {});
+    
+    /**
+     * @brief Записать событие "<message> at height <height>"
+     * 
+     * Высота форматируется потоком вывода, вызывающему не нужна строка.
+     */
+    void log_height_event(EventType type, std::string_view message, uint32_t height);
     
     /**
      * @brief Записать событие NEW_BLOCK
@@ -263,7 +381,12 @@ public:
     /**
      * @brief Записать ошибку
      */
-    void log_error(const std::string& message);
+    void log_error(std::string_view message);
+    
+    /**
+     * @brief Событий, отброшенных из-за переполненного кольца
+     */
+    [[nodiscard]] uint64_t dropped_events() const noexcept;
     
     // ==========================================================================
     // Рендеринг
@@ -281,6 +404,16 @@ public:
      */
     [[nodiscard]] std::string render() const;
     
+    /**
+     * @brief Вывести кадр в stdout, как по таймеру
+     * 
+     * Пересобираются только секции, помеченные update_* (и uptime), и
+     * печатаются только изменившиеся строки; без цвета кадр печатается
+     * целиком, если изменилось что-то кроме uptime. Вызывать из одного
+     * потока (обычно не нужно: кадры рисует start()).
+     */
+    void render_frame();
+    
 private:
     struct Impl;
     std::unique_ptr<Impl> impl_;
@@ -12,6 +12,7 @@
  * 4. TCP Server - связь с ASIC устройствами
  * 5. Share Validator - проверка найденных nonce
  * 6. Status Reporter - терминальный вывод статуса
+ * 7. Template Feed - шаблоны между площадками (proxy.upstream_host / feed_port)
  * 
  * Использование:
  *   quaxis-miner [options]
@@ -20,25 +21,51 @@
  *   -c, --config PATH    Путь к файлу конфигурации
  *   -h, --help           Показать справку
  *   -v, --version        Показать версию
+ *   --sha256-impl NAME   Реализация SHA256 вместо выбранной по CPU
  */
 
 #include "core/types.hpp"
 #include "core/config.hpp"
+#include "core/config_reload.hpp"
 #include "core/constants.hpp"
+#include "core/byte_order.hpp"
+#include "core/latency_trace.hpp"
+#include "core/pmu_profile.hpp"
+#include "core/async_log.hpp"
+#include "core/executor.hpp"
+#include "core/thread_plan.hpp"
+#include "core/startup.hpp"
 #include "crypto/sha256.hpp"
 #include "bitcoin/shm_subscriber.hpp"
+#include "bitcoin/zmq_subscriber.hpp"
+#include "bitcoin/shm_template.hpp"
 #include "bitcoin/coinbase.hpp"
 #include "bitcoin/target.hpp"
+#include "bitcoin/rpc_client.hpp"
+#include "mining/block_submitter.hpp"
 #include "mining/job_manager.hpp"
 #include "mining/share_validator.hpp"
+#include "mining/virtual_asic.hpp"
+#include "mining/share_journal.hpp"
+#include "mining/block_spool.hpp"
+#include "mining/template_cache.hpp"
+#include "mining/stale_work.hpp"
 #include "network/server.hpp"
+#include "network/handoff.hpp"
+#include "network/template_feed.hpp"
+#include "relay/relay_manager.hpp"
 #include "log/status_reporter.hpp"
+#include "metrics/metrics_server.hpp"
+#include "metrics/sources.hpp"
+#include "metrics/shm_stats_export.hpp"
 
 #include <iostream>
 #include <format>
 #include <csignal>
 #include <atomic>
 #include <thread>
+#include <mutex>
+#include <optional>
 
 namespace {
 
@@ -48,6 +75,12 @@ constexpr std::string_view VERSION = "1.0.0";
 /// @brief Флаг для graceful shutdown
 std::atomic<bool> g_running{true};
 
+/// @brief Запрос переключения профиля PMU (SIGUSR2, обрабатывает основной цикл)
+std::atomic<bool> g_pmu_toggle{false};
+
+/// @brief Запрос перезагрузки конфигурации (SIGHUP, обрабатывает основной цикл)
+std::atomic<bool> g_reload{false};
+
 /**
  * @brief Обработчик сигналов
  */
@@ -55,6 +88,10 @@ void signal_handler(int signum) {
     if (signum == SIGINT || signum == SIGTERM) {
         std::cout << "\n[INFO] Получен сигнал завершения, останавливаем..." << std::endl;
         g_running.store(false, std::memory_order_relaxed);
+    } else if (signum == SIGUSR2) {
+        g_pmu_toggle.store(true, std::memory_order_relaxed);
+    } else if (signum == SIGHUP) {
+        g_reload.store(true, std::memory_order_relaxed);
     }
 }
 
@@ -74,6 +111,9 @@ Universal AuxPoW Core - автономный соло-майнер Bitcoin дл
     -h, --help           Показать эту справку
     -v, --version        Показать версию программы
     --test-config        Проверить конфигурацию и выйти
+    --sha256-impl NAME   Реализация SHA256 вместо выбранной по CPU:
+                         generic, sha-ni, arm-sha2; пакетная - scalar,
+                         avx2, avx512 (опцию можно повторить)
 
 ПРИМЕРЫ:
     quaxis-miner -c /etc/quaxis/quaxis.toml
@@ -123,6 +163,7 @@ struct Args {
     bool show_help = false;
     bool show_version = false;
     bool test_config = false;
+    std::vector<std::string> sha256_impls;
 };
 
 Args parse_args(int argc, char* argv[]) {
@@ -139,6 +180,8 @@ Args parse_args(int argc, char* argv[]) {
             args.test_config = true;
         } else if ((arg == "-c" || arg == "--config") && i + 1 < argc) {
             args.config_path = argv[++i];
+        } else if (arg == "--sha256-impl" && i + 1 < argc) {
+            args.sha256_impls.emplace_back(argv[++i]);
         }
     }
     
@@ -153,6 +196,8 @@ Args parse_args(int argc, char* argv[]) {
 int main(int argc, char* argv[]) {
     using namespace quaxis;
     
+    const auto process_start = std::chrono::steady_clock::now();
+    
     // Парсим аргументы
     auto args = parse_args(argc, argv);
     
@@ -169,18 +214,35 @@ int main(int argc, char* argv[]) {
     // Выводим баннер
     print_banner();
     
-    std::cout << "[INFO] SHA256 реализация: " << crypto::get_implementation_name() << std::endl;
-    std::cout << "[INFO] Universal AuxPoW Core - автономный режим" << std::endl;
+    // Выбор реализации SHA256 вручную - до первого рабочего потока
+    for (const auto& name : args.sha256_impls) {
+        bool applied = false;
+        if (auto impl = crypto::parse_sha256_implementation(name)) {
+            applied = crypto::set_sha256_implementation(*impl);
+        } else if (auto batch = crypto::parse_sha256_batch_implementation(name)) {
+            applied = crypto::set_sha256_batch_implementation(*batch);
+        } else {
+            QUAXIS_LOG(Error, "Неизвестная реализация SHA256: {}", name);
+            return 1;
+        }
+        if (!applied) {
+            QUAXIS_LOG(Error, "Реализация SHA256 недоступна на этом CPU: {}", name);
+            return 1;
+        }
+    }
+    
+    QUAXIS_LOG(Info, "SHA256 реализация: {} (пакетная: {})", crypto::get_implementation_name(), crypto::get_batch_implementation_name());
+    QUAXIS_LOG(Info, "Universal AuxPoW Core - автономный режим");
     
     // Загружаем конфигурацию
-    std::cout << "[INFO] Загрузка конфигурации..." << std::endl;
+    QUAXIS_LOG(Info, "Загрузка конфигурации...");
     
     auto config_result = args.config_path 
         ? Config::load(*args.config_path)
         : Config::load_with_search();
     
     if (!config_result) {
-        std::cerr << "[ERROR] " << config_result.error().message << std::endl;
+        QUAXIS_LOG(Error, "{}", config_result.error().message);
         return 1;
     }
     
@@ -189,19 +251,34 @@ int main(int argc, char* argv[]) {
     // Валидируем конфигурацию
     auto validation = config.validate();
     if (!validation) {
-        std::cerr << "[ERROR] Ошибка валидации конфигурации: " 
-                  << validation.error().message << std::endl;
+        QUAXIS_LOG(Error, "Ошибка валидации конфигурации: {}", validation.error().message);
         return 1;
     }
     
-    std::cout << "[INFO] Конфигурация загружена успешно" << std::endl;
-    std::cout << "[INFO] Источник заголовков: " << config.parent_chain.headers_source << std::endl;
+    QUAXIS_LOG(Info, "Конфигурация загружена успешно");
+    QUAXIS_LOG(Info, "Источник заголовков: {}", config.parent_chain.headers_source);
     
     if (args.test_config) {
-        std::cout << "[INFO] Конфигурация валидна" << std::endl;
+        QUAXIS_LOG(Info, "Конфигурация валидна");
         return 0;
     }
     
+    // Асинхронный лог: дальше сообщения форматирует и пишет фоновый поток
+    core::LogConfig async_log_config;
+    async_log_config.level = *core::parse_log_level(config.logging.level);
+    async_log_config.output = *core::parse_log_output(config.logging.output);
+    async_log_config.file = config.logging.file;
+    async_log_config.flush_interval_ms = config.logging.flush_interval_ms;
+    if (auto log_result = core::start_log(async_log_config); !log_result) {
+        QUAXIS_LOG(Error, "{}", log_result.error().message);
+        return 1;
+    }
+    
+    // План размещения потоков - до создания первого потока
+    if (auto plan_result = core::apply_thread_plan(config.threads); !plan_result) {
+        QUAXIS_LOG(Warning, "План размещения потоков: {}", plan_result.error().message);
+    }
+    
     // Создаём coinbase builder
     auto coinbase_builder_result = bitcoin::CoinbaseBuilder::from_address(
         config.parent_chain.payout_address,
@@ -209,75 +286,555 @@ int main(int argc, char* argv[]) {
     );
     
     if (!coinbase_builder_result) {
-        std::cerr << "[ERROR] Неверный адрес выплаты: "
-                  << coinbase_builder_result.error().message << std::endl;
+        QUAXIS_LOG(Error, "Неверный адрес выплаты: {}", coinbase_builder_result.error().message);
         return 1;
     }
     
     auto coinbase_builder = std::move(*coinbase_builder_result);
     
-    std::cout << "[INFO] Адрес выплаты: " << config.parent_chain.payout_address << std::endl;
-    std::cout << "[INFO] Тег coinbase: " << config.mining.coinbase_tag << std::endl;
+    QUAXIS_LOG(Info, "Адрес выплаты: {}", config.parent_chain.payout_address);
+    QUAXIS_LOG(Info, "Тег coinbase: {}", config.mining.coinbase_tag);
+    
+    // Диапазон extranonce узла: весь у корня, у прокси - от вышестоящего
+    auto extranonce_range = network::ExtranonceRange::root(config.mining.extranonce_size);
+    std::unique_ptr<network::TemplateFeedClient> feed_client;
+    if (!config.proxy.upstream_host.empty()) {
+        feed_client = std::make_unique<network::TemplateFeedClient>(config.proxy);
+        auto delegated = feed_client->connect();
+        if (!delegated) {
+            QUAXIS_LOG(Error, "{}", delegated.error().message);
+            return 1;
+        }
+        extranonce_range = *delegated;
+        QUAXIS_LOG(Info, "Прокси: площадка {} у {}:{}, extranonce от {:#x} ({} бит)",
+                   config.proxy.site, config.proxy.upstream_host,
+                   config.proxy.upstream_port, extranonce_range.base,
+                   extranonce_range.bits);
+    }
+    
+    // Кластер: узел берёт свою часть пространства extranonce без координации
+    if (config.cluster.node != 0) {
+        extranonce_range = *extranonce_range.delegate(static_cast<uint8_t>(config.cluster.node));
+        QUAXIS_LOG(Info, "Кластер: узел {}, extranonce от {:#x} ({} бит)",
+                   config.cluster.node, extranonce_range.base, extranonce_range.bits);
+    }
+    
+    // Кеш шаблонов: готовит задания следующего блока для всех ASIC заранее
+    mining::TemplateCache template_cache(config.mining, coinbase_builder);
+    
+    // Создаём менеджер заданий: extranonce соединений не выходят за долю узла
+    mining::JobManager job_manager(config.mining, std::move(coinbase_builder),
+                                   extranonce_range.first_own(),
+                                   extranonce_range.own_end(config.proxy.feed_port != 0));
+    
+    // Каналы отправки найденного блока: FIBRE пиры, кольцо SHM и RPC submitblock
+    mining::BlockSubmitter block_submitter;
+    
+    std::unique_ptr<relay::RelayManager> relay_manager;
+    std::atomic<bool> relay_ready{false};
+    
+    // Медленные подсистемы (relay, ZMQ, метрики) поднимаются в фоне:
+    // сервер ASIC и первичный источник SHM их не ждут. Группа объявлена
+    // после relay: при раннем выходе она дожидается шага раньше, чем
+    // relay разрушается
+    core::StartupGroup startup(process_start);
+    startup.set_report_callback([](const core::StartupReport& report) {
+        if (report.ok) {
+            QUAXIS_LOG(Info, "{} готов: {:.1f} мс после запуска ({:.1f} мс)",
+                       report.name, report.ready_ms, report.run_ms);
+        } else {
+            QUAXIS_LOG(Warning, "{} недоступен: {}", report.name, report.error);
+        }
+    });
+    
+    // Relay (DNS пиров, сокеты, AF_XDP): канал отправки блоков заводится
+    // сразу и работает, как только relay поднят
+    if (config.relay.enabled) {
+        relay_manager = std::make_unique<relay::RelayManager>(config.relay);
+        startup.launch("FIBRE relay", {}, [&]() -> Result<void> {
+            auto relay_result = relay_manager->start();
+            if (!relay_result) {
+                return relay_result;
+            }
+            if (!config.relay.xdp_interface.empty() && !relay_manager->stats().xdp_active) {
+                QUAXIS_LOG(Warning, "AF_XDP на {} недоступен, приём через сокеты пиров", config.relay.xdp_interface);
+            }
+            relay_ready.store(true, std::memory_order_release);
+            return {};
+        });
+        block_submitter.add_leg("fibre", [&relay_manager, &relay_ready, &job_manager](ByteSpan block,
+                                                                                     const Hash256& hash) {
+            if (!relay_ready.load(std::memory_order_acquire)) {
+                return Err<void>(ErrorCode::NetworkConnectionFailed, "FIBRE relay ещё не запущен");
+            }
+            return relay_manager->broadcast_block(block, hash, job_manager.current_height());
+        });
+    }
+    
+    // Плагин узла забирает блок из кольца SHM и сразу вызывает ProcessNewBlock
+    std::unique_ptr<bitcoin::ShmBlockSubmitter> shm_block_submitter;
+    if (config.shm.enabled && config.shm.submit_enabled) {
+        shm_block_submitter = std::make_unique<bitcoin::ShmBlockSubmitter>(config.shm);
+        if (auto result = shm_block_submitter->open(); !result) {
+            QUAXIS_LOG(Warning, "SHM отправка блоков недоступна: {}", result.error().message);
+        } else {
+            block_submitter.add_leg("shm", [&shm_block_submitter](ByteSpan block, const Hash256& hash) {
+                return shm_block_submitter->submit(block, hash);
+            });
+        }
+    }
     
-    // Создаём менеджер заданий
-    mining::JobManager job_manager(config.mining, std::move(coinbase_builder));
+    std::unique_ptr<bitcoin::RpcClient> submit_rpc;
+    if (!config.parent_chain.submit_rpc_host.empty()) {
+        bitcoin::RpcConfig rpc_config;
+        rpc_config.host = config.parent_chain.submit_rpc_host;
+        rpc_config.port = config.parent_chain.submit_rpc_port;
+        rpc_config.user = config.parent_chain.submit_rpc_user;
+        rpc_config.password = config.parent_chain.submit_rpc_password;
+        submit_rpc = std::make_unique<bitcoin::RpcClient>(rpc_config);
+        block_submitter.add_leg("rpc", [&submit_rpc](ByteSpan block, const Hash256&) {
+            return submit_rpc->submit_block(to_hex(block));
+        });
+    }
     
-    // Создаём валидатор shares
+    // Прокси отдаёт блок вышестоящему: тот отправит его в сеть
+    if (feed_client) {
+        block_submitter.add_leg("upstream", [&feed_client](ByteSpan block, const Hash256&) {
+            return feed_client->submit_block(block);
+        });
+    }
+    
+    // Spool: блок на диск отдельным каналом, параллельно с отправкой в сеть
+    std::unique_ptr<mining::BlockSpool> block_spool;
+    std::vector<mining::SpooledBlock> unsubmitted_blocks;
+    if (config.spool.enabled) {
+        block_spool = std::make_unique<mining::BlockSpool>(config.spool);
+        if (auto result = block_spool->open(); !result) {
+            QUAXIS_LOG(Error, "Spool блоков не открыт: {}", result.error().message);
+            return 1;
+        }
+        if (!block_spool->direct_io()) {
+            QUAXIS_LOG(Warning, "{}: O_DIRECT не поддерживается, spool только с fdatasync", config.spool.path);
+        }
+        unsubmitted_blocks = block_spool->take_pending();
+        block_submitter.add_leg("spool", [&block_spool](ByteSpan block, const Hash256& hash) {
+            return block_spool->append(mining::SpoolKind::Block, hash, block);
+        });
+    }
+    
+    block_submitter.set_report_callback([&block_spool](const mining::SubmitReport& report) {
+        if (report.ok && block_spool && report.leg != "spool") {
+            block_spool->mark_submitted(mining::SpoolKind::Block, report.block_hash);
+        }
+        if (report.ok) {
+            QUAXIS_LOG(Info, "Блок отправлен ({}): начало {:.3f} мс, конец {:.3f} мс",
+                       report.leg, report.started_ms, report.finished_ms);
+        } else {
+            QUAXIS_LOG(Error, "Блок не отправлен ({}): {} ({:.3f} мс)",
+                       report.leg, report.error, report.finished_ms);
+        }
+    });
+    block_submitter.start();
+    QUAXIS_LOG(Info, "Каналов отправки блоков: {}", block_submitter.leg_count());
+    
+    // Блоки, найденные до падения и не подтверждённые ни одним каналом
+    for (auto& spooled : unsubmitted_blocks) {
+        if (spooled.kind != mining::SpoolKind::Block) {
+            continue;  // AuxPow повторяет RewardDispatcher::replay()
+        }
+        QUAXIS_LOG(Info, "Повторная отправка блока из spool: {}", to_hex(quaxis::reverse_copy(spooled.hash)));
+        block_submitter.submit(std::move(spooled.payload));
+    }
+    
+    // Создаём валидатор shares (и пул проверки, если он включён)
     mining::ShareValidator share_validator(job_manager);
+    share_validator.set_valid_block_callback([&job_manager, &block_submitter](
+                                                const mining::ValidationResult& result,
+                                                const bitcoin::BlockHeader&) {
+        auto found_at = mining::BlockSubmitter::Clock::now();
+        auto block = job_manager.build_found_block(
+            result.job_id, result.extranonce, result.version, result.nonce, result.timestamp
+        );
+        QUAXIS_LOG(Info, "Найден блок! job_id={} nonce={}", result.job_id, result.nonce);
+        if (block) {
+            block_submitter.submit(std::move(*block), found_at);
+        } else {
+            QUAXIS_LOG(Error, "Нет шаблона для сборки блока job_id={}", result.job_id);
+        }
+    });
+    share_validator.set_duplicate_filter_size(config.duplicate_filter_shares());
+    share_validator.set_partial_difficulty(config.mining.share_difficulty);
+    
+    // Журнал принятых shares
+    std::unique_ptr<mining::ShareJournal> share_journal;
+    if (config.journal.enabled) {
+        share_journal = std::make_unique<mining::ShareJournal>(config.journal);
+        if (auto result = share_journal->start(); !result) {
+            QUAXIS_LOG(Error, "Журнал shares не запущен: {}", result.error().message);
+            return 1;
+        }
+        share_validator.set_journal(share_journal.get());
+        QUAXIS_LOG(Info, "Журнал shares: {}", config.journal.directory);
+    }
+    share_validator.start_workers(config.mining.validator_threads);
+    
+    // Программный ASIC: перебор nonce на CPU для сквозных замеров на regtest/signet
+    std::unique_ptr<mining::VirtualAsic> virtual_asic;
+    if (config.mining.virtual_asic_threads > 0) {
+        mining::VirtualAsicConfig asic_config;
+        asic_config.threads = config.mining.virtual_asic_threads;
+        asic_config.share_difficulty = config.mining.virtual_asic_difficulty;
+        virtual_asic = std::make_unique<mining::VirtualAsic>(job_manager, share_validator, asic_config);
+        virtual_asic->start();
+        QUAXIS_LOG(Warning, "Программный ASIC: {} потоков перебора на CPU (только для regtest/signet)", asic_config.threads);
+    }
+    
+    // Общий исполнитель: периодическая работа подсистем и полоса "блок -> задания"
+    core::Executor executor(config.executor);
+    if (auto executor_result = executor.start(); !executor_result) {
+        QUAXIS_LOG(Error, "Не удалось запустить исполнитель: {}", executor_result.error().message);
+        return 1;
+    }
     
     // Создаём репортёр статуса
     log::LoggingConfig log_config;
     log_config.refresh_interval_ms = config.logging.refresh_interval_ms;
     log_config.color = config.logging.color;
+    log_config.display = config.logging.display == "always" ? log::DisplayMode::Always
+                       : config.logging.display == "never"  ? log::DisplayMode::Never
+                                                            : log::DisplayMode::Auto;
     log_config.show_hashrate = config.logging.show_hashrate;
     log_config.show_chain_block_counts = config.logging.show_chain_block_counts;
     log_config.event_history = config.logging.event_history;
     log::StatusReporter status_reporter(log_config);
+    status_reporter.set_executor(&executor);
+    
+    // Трассировка латентности: блок -> задания ASIC
+    if (config.logging.latency_trace) {
+        core::set_tracing_enabled(true);
+        if (!config.logging.latency_trace_dump.empty()) {
+            auto dump_result = core::open_trace_dump(config.logging.latency_trace_dump);
+            if (!dump_result) {
+                QUAXIS_LOG(Warning, "{}", dump_result.error().message);
+            }
+        }
+    }
+    
+    // Счётчики PMU горячих участков (переключаются SIGUSR2 без перезапуска)
+    if (config.logging.pmu_profile && !core::set_pmu_enabled(true)) {
+        QUAXIS_LOG(Warning, "Профиль PMU недоступен: {}", core::pmu_unavailable_reason());
+    }
+    
+    // Фид шаблонов нижестоящим площадкам; их блоки уходят нашими каналами
+    std::unique_ptr<network::TemplateFeedServer> feed_server;
+    if (config.proxy.feed_port != 0) {
+        feed_server = std::make_unique<network::TemplateFeedServer>(config.proxy, extranonce_range);
+        feed_server->set_block_callback([&block_submitter](Bytes block, uint8_t site) {
+            QUAXIS_LOG(Info, "Блок от площадки {}", static_cast<int>(site));
+            block_submitter.submit(std::move(block));
+        });
+    }
+    
+    // Новый шаблон - нижестоящим площадкам (после рассылки своим ASIC)
+    auto publish_feed = [&](bool is_speculative) {
+        if (feed_server) {
+            feed_server->publish(job_manager.current_template(), is_speculative);
+        }
+    };
+    
+    // Потерянная работа: приход tip от источников, рассылка, RSP_JOB_LOADED, shares
+    using StaleClock = mining::StaleWorkAccountant::Clock;
+    mining::StaleWorkAccountant stale_work;
+    stale_work.set_event_callback([](const mining::StaleWorkEvent& event) {
+        QUAXIS_LOG(Info, "Tip {} ({}): работа на устаревшем tip {:.3f} TH, рассылка {:.1f} мс, "
+                         "загрузка подтверждена {}/{}{}",
+                   event.height, mining::to_string(event.source), event.total_th(), event.pipeline_ms,
+                   event.units_acked, event.units, event.invalidated ? ", speculative блок отменён" : "");
+    });
     
     // Создаём TCP сервер
     network::Server server(config.server, job_manager);
+    server.set_executor(&executor);
     
     server.set_connected_callback([](const std::string& addr) {
-        std::cout << "[INFO] ASIC подключён: " << addr << std::endl;
+        QUAXIS_LOG_RATE(Info, 20, "ASIC подключён: {}", addr);
     });
     
     server.set_disconnected_callback([](const std::string& addr) {
-        std::cout << "[INFO] ASIC отключён: " << addr << std::endl;
+        QUAXIS_LOG_RATE(Info, 20, "ASIC отключён: {}", addr);
+    });
+    
+    // Shares проверяются по сложности своего ASIC (vardiff) или общей;
+    // с пулом поток приёма только ставит share в очередь
+    server.set_share_callback([&share_validator, &stale_work](const mining::Share& share, uint32_t difficulty) {
+        share_validator.submit(share, static_cast<double>(difficulty));
+        stale_work.on_share(share.connection_id,
+                            difficulty != 0 ? static_cast<double>(difficulty) : share_validator.partial_difficulty(),
+                            StaleClock::now());
     });
     
+    // С какого момента ASIC хеширует новый tip
+    server.set_job_loaded_callback([&stale_work](uint32_t connection_id,
+                                                 std::optional<std::chrono::nanoseconds> since_sent) {
+        if (since_sent) {
+            stale_work.on_job_loaded(connection_id, *since_sent, StaleClock::now());
+        }
+    });
+    
+    // Подтверждённый или отменённый speculative блок - и площадкам.
+    // Отмена возвращает прежний tip: его задания уже готовы в кеше
+    // (retain_rollback), ASIC получают их без пересборки
+    auto resolve_speculative = [&](bool confirmed) {
+        stale_work.on_speculative_resolved(confirmed, StaleClock::now());
+        if (confirmed) {
+            job_manager.confirm_speculative_block();
+            template_cache.drop_rollback();
+        } else {
+            auto previous = template_cache.take_rollback();
+            std::shared_ptr<const bitcoin::BlockTemplate> previous_template;
+            std::span<mining::PrecomputedJob> previous_jobs;
+            if (previous) {
+                previous_template = previous->block_template;
+                previous_jobs = previous->jobs;
+            }
+            if (job_manager.rollback_speculative_block(previous_template, previous_jobs)) {
+                server.broadcast_job_set(previous_jobs);
+            }
+        }
+        if (feed_server) {
+            feed_server->publish_state(confirmed);
+        }
+    };
+    
     // Устанавливаем обработчики сигналов
     std::signal(SIGINT, signal_handler);
     std::signal(SIGTERM, signal_handler);
+    std::signal(SIGUSR2, signal_handler);
+    std::signal(SIGHUP, signal_handler);
     
     // Запускаем сервер
-    std::cout << "[INFO] Запуск сервера на " 
-              << config.server.bind_address << ":" << config.server.port 
-              << "..." << std::endl;
+    QUAXIS_LOG(Info, "Запуск сервера на {}:{}...", config.server.bind_address, config.server.port);
+    
+    // [handoff]: работающий прежний процесс отдаёт сокеты, задания и
+    // аренды extranonce - ASIC не переподключаются
+    std::optional<network::HandoffPackage> handed_off;
+    network::HandoffClient handoff_client(config.handoff);
+    if (config.handoff.enabled) {
+        auto received = handoff_client.receive();
+        if (!received) {
+            QUAXIS_LOG(Warning, "Передача от прежнего процесса не удалась: {}", received.error().message);
+        } else if (*received) {
+            handed_off = std::move(**received);
+        }
+    }
     
-    auto server_result = server.start();
+    Result<void> server_result;
+    if (handed_off) {
+        const std::size_t connections = handed_off->server.connections.size();
+        const std::size_t restored = job_manager.import_handoff(handed_off->jobs);
+        server_result = server.resume(std::move(handed_off->server), restored > 0);
+        if (server_result) {
+            if (auto ack = handoff_client.acknowledge(); !ack) {
+                QUAXIS_LOG(Error, "{}", ack.error().message);
+                return 1;
+            }
+            QUAXIS_LOG(Info, "Работа принята от прежнего процесса: соединений {}, заданий {}", connections, restored);
+        }
+    } else {
+        server_result = server.start();
+    }
     if (!server_result) {
-        std::cerr << "[ERROR] Не удалось запустить сервер: "
-                  << server_result.error().message << std::endl;
+        QUAXIS_LOG(Error, "Не удалось запустить сервер: {}", server_result.error().message);
         return 1;
     }
     
-    std::cout << "[INFO] Сервер запущен" << std::endl;
+    QUAXIS_LOG(Info, "Сервер запущен: {:.1f} мс после запуска",
+               std::chrono::duration<double, std::milli>(
+                   std::chrono::steady_clock::now() - process_start).count());
+    
+    std::optional<network::HandoffListener> handoff_listener;
+    if (config.handoff.enabled) {
+        handoff_listener.emplace(config.handoff);
+        if (auto listen_result = handoff_listener->start(); !listen_result) {
+            QUAXIS_LOG(Warning, "{}", listen_result.error().message);
+            handoff_listener.reset();
+        } else {
+            QUAXIS_LOG(Info, "Передача новому процессу: {}", config.handoff.socket_path);
+        }
+    }
+    
+    if (feed_server) {
+        auto feed_result = feed_server->start();
+        if (!feed_result) {
+            QUAXIS_LOG(Warning, "{}", feed_result.error().message);
+            feed_server.reset();
+        } else {
+            QUAXIS_LOG(Info, "Фид шаблонов площадкам: {}:{}", config.proxy.feed_bind_address, feed_server->port());
+        }
+    }
+    
+    // Шаблоны вышестоящего: та же рассылка, что для шаблона SHM
+    if (feed_client) {
+        feed_client->set_template_callback([&](std::shared_ptr<const bitcoin::BlockTemplate> block_template,
+                                               bool is_speculative) {
+            uint32_t height = block_template->height;
+            const Hash256 tip = block_template->header.prev_block;
+            stale_work.on_tip(mining::TipSource::Upstream, tip, height, is_speculative, StaleClock::now());
+            job_manager.on_new_block(std::move(block_template), is_speculative);
+            server.broadcast_job_set({});
+            stale_work.on_dispatched(tip, StaleClock::now());
+            publish_feed(is_speculative);
+            template_cache.retain_rollback(job_manager.rollback_template(), job_manager.extranonce_manager());
+            status_reporter.log_height_event(log::EventType::NEW_BLOCK,
+                "Upstream template jobs sent", height);
+        });
+        feed_client->set_state_callback(resolve_speculative);
+        feed_client->start();
+    }
     
     // Запускаем репортёр статуса
     status_reporter.start();
     
+    // Prometheus /metrics: источники читают lock-free снимки статистики
+    std::unique_ptr<metrics::MetricsServer> metrics_server;
+    if (config.metrics.enabled) {
+        metrics_server = std::make_unique<metrics::MetricsServer>(config.metrics);
+        metrics_server->add_source([&server](metrics::MetricsWriter& writer) {
+            metrics::write_server_metrics(writer, server);
+        });
+        metrics_server->add_source([&stale_work](metrics::MetricsWriter& writer) {
+            metrics::write_stale_work_metrics(writer, stale_work);
+        });
+        if (relay_manager) {
+            metrics_server->add_source([&relay_manager](metrics::MetricsWriter& writer) {
+                metrics::write_relay_metrics(writer, *relay_manager);
+            });
+        }
+        if (config.logging.latency_trace) {
+            metrics_server->add_source([](metrics::MetricsWriter& writer) {
+                metrics::write_trace_metrics(writer);
+            });
+        }
+        // Профиль включается и сигналом - источник есть всегда
+        metrics_server->add_source([](metrics::MetricsWriter& writer) {
+            metrics::write_pmu_metrics(writer);
+        });
+        startup.launch("Сервер метрик", {}, [&]() -> Result<void> {
+            auto metrics_result = metrics_server->start();
+            if (metrics_result) {
+                QUAXIS_LOG(Info, "Метрики: http://{}:{}/metrics", config.metrics.bind_address, metrics_server->port());
+            }
+            return metrics_result;
+        });
+    }
+    
+    // Снимок статистики в shared memory: агенты читают без HTTP и без
+    // нагрузки на майнер, публикует основной цикл
+    std::unique_ptr<metrics::ShmStatsExporter> shm_stats;
+    if (!config.metrics.shm_path.empty()) {
+        shm_stats = std::make_unique<metrics::ShmStatsExporter>(config.metrics.shm_path);
+        if (auto open_result = shm_stats->open(); open_result) {
+            shm_stats->add_source([&server](metrics::ShmStatsSummary& summary,
+                                            std::vector<metrics::ShmStatsConnection>& connections) {
+                metrics::fill_server_stats(summary, connections, server);
+            });
+            if (relay_manager) {
+                shm_stats->add_source([&relay_manager](metrics::ShmStatsSummary& summary,
+                                                       std::vector<metrics::ShmStatsConnection>&) {
+                    metrics::fill_relay_stats(summary, *relay_manager);
+                });
+            }
+            QUAXIS_LOG(Info, "Статистика в shared memory: {}", shm_stats->path());
+        } else {
+            QUAXIS_LOG(Warning, "Сегмент статистики не создан: {}", open_result.error().message);
+            shm_stats.reset();
+        }
+    }
+
     // Основной цикл - ожидание блоков через SHM или fallback
-    std::cout << "[INFO] Ожидание блоков..." << std::endl;
-    std::cout << "[INFO] Источник: " << config.parent_chain.headers_source << std::endl;
+    QUAXIS_LOG(Info, "Ожидание блоков...");
+    QUAXIS_LOG(Info, "Источник: {}", config.parent_chain.headers_source);
     
-    // Инициализируем SHM подписчик если включён
-    std::unique_ptr<bitcoin::ShmSubscriber> shm_subscriber;
-    if (config.shm.enabled) {
-        shm_subscriber = std::make_unique<bitcoin::ShmSubscriber>(config.shm);
-        shm_subscriber->set_callback([&](const bitcoin::BlockHeader& header, 
-                                          uint32_t height, 
-                                          int64_t coinbase_value,
-                                          bool is_speculative) {
+    // prev_block последнего шаблона из сегмента шаблона SHM: для этого
+    // tip задания уже разосланы, заголовок из сегмента блока не нужен
+    std::mutex shm_template_mutex;
+    std::optional<Hash256> shm_template_prev;
+    
+    // Подписчик на полный шаблон (coinbase и commitments от узла)
+    std::unique_ptr<bitcoin::ShmTemplateSubscriber> shm_template_subscriber;
+    if (config.shm.enabled && config.shm.template_enabled) {
+        shm_template_subscriber = std::make_unique<bitcoin::ShmTemplateSubscriber>(config.shm);
+        shm_template_subscriber->set_callback([&](std::shared_ptr<const bitcoin::BlockTemplate> block_template,
+                                                  bool is_speculative) {
+            const auto arrived = StaleClock::now();
+            const Hash256 tip = block_template->header.prev_block;
+            {
+                std::lock_guard<std::mutex> lock(shm_template_mutex);
+                shm_template_prev = tip;
+            }
+            uint32_t height = block_template->height;
+            stale_work.on_tip(mining::TipSource::ShmTemplate, tip, height, is_speculative, arrived);
+            
+            // Шаблон готов к хешированию: без сборки coinbase и копии.
+            // Задания всех соединений - одним пакетом (regenerate_all)
+            job_manager.on_new_block(std::move(block_template), is_speculative);
+            server.broadcast_job_set({});
+            stale_work.on_dispatched(tip, StaleClock::now());
+            publish_feed(is_speculative);
+            status_reporter.log_height_event(log::EventType::NEW_BLOCK,
+                "Template jobs sent", height);
+        });
+        
+        auto template_result = shm_template_subscriber->start();
+        if (!template_result) {
+            QUAXIS_LOG(Warning, "SHM шаблон недоступен: {}", template_result.error().message);
+        } else {
+            QUAXIS_LOG(Info, "SHM шаблон подключён: {}", config.shm.template_path);
+        }
+    }
+    
+    // Tip, для которого уже разосланы задания: SHM и header-first relay
+    // сообщают об одном блоке независимо
+    std::mutex announced_tip_mutex;
+    std::optional<Hash256> announced_tip;
+    
+    // Новый tip (SHM или speculative header из relay): рассылка заданий
+    auto on_tip = [&](const bitcoin::BlockHeader& header, 
+                      uint32_t height, 
+                      int64_t coinbase_value,
+                      bool is_speculative) {
+        Hash256 tip_hash = header.hash();
+        
+        {
+            std::lock_guard<std::mutex> lock(announced_tip_mutex);
+            if (announced_tip == tip_hash) {
+                // Задания уже разосланы; подтверждённый повтор снимает speculative
+                if (!is_speculative) {
+                    resolve_speculative(true);
+                }
+                return;
+            }
+            announced_tip = tip_hash;
+        }
+        
+        bool have_template = false;
+        {
+            std::lock_guard<std::mutex> lock(shm_template_mutex);
+            have_template = (shm_template_prev == tip_hash);
+        }
+        
+        if (have_template) {
+            // Задания по шаблону узла уже разосланы (shm_template_subscriber)
+        } else if (auto job_set = template_cache.take_next_jobs(tip_hash, height + 1, header.timestamp)) {
+            // Задания готовы заранее: рассылка без хеширования coinbase
+            job_manager.on_new_block(job_set->block_template, is_speculative);
+            job_manager.adopt_precomputed_jobs(job_set->jobs);
+            server.broadcast_job_set(job_set->jobs);
+            stale_work.on_dispatched(tip_hash, StaleClock::now());
+            publish_feed(is_speculative);
+            status_reporter.log_height_event(log::EventType::NEW_BLOCK,
+                "Precomputed jobs sent", height);
+        } else {
             // Создаём BlockTemplate
             bitcoin::BlockTemplate block_template;
             block_template.height = height;
@@ -287,49 +844,338 @@ int main(int argc, char* argv[]) {
             // Обновляем менеджер заданий
             job_manager.on_new_block(block_template, is_speculative);
             
-            // Получаем задание и рассылаем ASIC
-            if (auto job = job_manager.get_next_job()) {
-                server.broadcast_job(*job);
-                status_reporter.log_event(log::EventType::NEW_BLOCK, 
-                    "Job sent at height " + std::to_string(height));
-            }
+            // Задания всех соединений - одним пакетом (regenerate_all)
+            server.broadcast_job_set({});
+            stale_work.on_dispatched(tip_hash, StaleClock::now());
+            status_reporter.log_height_event(log::EventType::NEW_BLOCK,
+                "Jobs sent", height);
             
-            // Обновляем статистику
-            log::BitcoinStats btc_stats;
-            btc_stats.height = height;
-            btc_stats.connected = true;
-            status_reporter.update_bitcoin_stats(btc_stats);
+            template_cache.update_template(
+                tip_hash, height + 1, header.bits, header.timestamp, coinbase_value
+            );
+            template_cache.remember_current_jobs(job_manager.extranonce_manager());
+        }
+        
+        // Уже после рассылки готовим задания для следующего блока, а
+        // speculative блоку - задания прежнего tip на случай отмены
+        template_cache.retain_rollback(job_manager.rollback_template(), job_manager.extranonce_manager());
+        template_cache.precompute_next(height + 2, header.bits);
+        template_cache.precompute_next_jobs(job_manager.extranonce_manager());
+        
+        // Обновляем статистику
+        log::BitcoinStats btc_stats;
+        btc_stats.height = height;
+        btc_stats.connected = true;
+        status_reporter.update_bitcoin_stats(btc_stats);
+    };
+    
+    // on_tip с учётом прихода от источника (до announced_tip: повтор - отставание источника)
+    auto on_tip_from = [&](mining::TipSource source) {
+        return [&on_tip, &stale_work, source](const bitcoin::BlockHeader& header,
+                                              uint32_t height,
+                                              int64_t coinbase_value,
+                                              bool is_speculative) {
+            stale_work.on_tip(source, header.hash(), height + 1, is_speculative, StaleClock::now());
+            on_tip(header, height, coinbase_value, is_speculative);
+        };
+    };
+
+    // Инициализируем SHM подписчик если включён
+    std::unique_ptr<bitcoin::ShmSubscriber> shm_subscriber;
+    if (config.shm.enabled) {
+        shm_subscriber = std::make_unique<bitcoin::ShmSubscriber>(config.shm);
+        shm_subscriber->set_callback(on_tip_from(mining::TipSource::Shm));
+        
+        shm_subscriber->set_state_callback([&](const Hash256& /*block_hash*/,
+                                                uint32_t height,
+                                                bitcoin::ShmBlockState state) {
+            if (state == bitcoin::ShmBlockState::Confirmed) {
+                resolve_speculative(true);
+            } else if (state == bitcoin::ShmBlockState::Invalid) {
+                resolve_speculative(false);
+                status_reporter.log_height_event(log::EventType::ERROR,
+                    "Speculative block invalid", height);
+            }
         });
         
         auto shm_result = shm_subscriber->start();
         if (!shm_result) {
-            std::cerr << "[WARNING] SHM недоступен: " << shm_result.error().message << std::endl;
-            std::cout << "[INFO] Используем fallback режим (Stratum pool)" << std::endl;
+            QUAXIS_LOG(Warning, "SHM недоступен: {}", shm_result.error().message);
+            QUAXIS_LOG(Info, "Используем fallback режим (Stratum pool)");
         } else {
-            std::cout << "[INFO] SHM подключён: " << config.shm.path << std::endl;
+            QUAXIS_LOG(Info, "SHM подключён: {}{}", config.shm.path, (shm_subscriber->is_ring() ? " (кольцо событий)" : ""));
         }
     }
     
+    // ZMQ rawblock узла: тот же on_tip, повторы SHM отсекает announced_tip
+    std::unique_ptr<bitcoin::ZmqSubscriber> zmq_subscriber;
+    if (config.zmq.enabled) {
+        zmq_subscriber = std::make_unique<bitcoin::ZmqSubscriber>(config.zmq);
+        zmq_subscriber->set_callback(on_tip_from(mining::TipSource::Zmq));
+        
+        // rawtx наполняет кеш транзакций FIBRE (шаблон SHM без транзакций)
+        const bool subscribe_rawtx = relay_manager && config.relay.mempool_prefill;
+        if (subscribe_rawtx) {
+            zmq_subscriber->set_tx_callback([&relay_manager](ByteSpan raw_tx) {
+                relay_manager->add_transaction(raw_tx);
+            });
+        }
+        
+        // Вторичный источник: задания уже идут по шаблону SHM
+        startup.launch("ZMQ подписчик", {}, [&, subscribe_rawtx]() -> Result<void> {
+            auto zmq_result = zmq_subscriber->start();
+            if (zmq_result) {
+                QUAXIS_LOG(Info, "ZMQ подписка: {} ({})", config.zmq.endpoint,
+                           subscribe_rawtx ? "rawblock, rawtx" : "rawblock");
+            }
+            return zmq_result;
+        });
+    }
+    
+    // Header-first spy mining: header из FIBRE с проверенным PoW - до тела блока.
+    // Обе реакции - в полосе задержки: поток приёма relay не ждёт рассылку,
+    // а подтверждение блока не обгоняет его speculative задания.
+    if (relay_manager && config.relay.header_first) {
+        relay_manager->set_speculative_callback([&](const bitcoin::BlockHeader& header,
+                                                    uint32_t height,
+                                                    int64_t coinbase_value) {
+            executor.post_latency([&on_tip, &stale_work, header, height, coinbase_value,
+                                   arrived = StaleClock::now()] {
+                stale_work.on_tip(mining::TipSource::Relay, header.hash(), height + 1, true, arrived);
+                on_tip(header, height, coinbase_value, true);
+            });
+        });
+        relay_manager->set_block_state_callback([&](const Hash256& hash,
+                                                    uint32_t height,
+                                                    relay::RelayBlockState state) {
+            executor.post_latency([&, block_hash = hash, height, state] {
+                {
+                    // Tip уже сменился - проверка старого блока заданий не касается
+                    std::lock_guard<std::mutex> lock(announced_tip_mutex);
+                    if (announced_tip != block_hash) {
+                        return;
+                    }
+                    if (state == relay::RelayBlockState::Invalid) {
+                        announced_tip.reset();
+                    }
+                }
+                if (state == relay::RelayBlockState::Confirmed) {
+                    resolve_speculative(true);
+                } else {
+                    resolve_speculative(false);
+                    status_reporter.log_height_event(log::EventType::ERROR,
+                        "Relay block body invalid", height);
+                }
+            });
+        });
+    }
+    
+    // Все потоки запущены: роли и ошибки закрепления видны в дампе
+    if (config.threads.dump_topology) {
+        std::cout << "[INFO] " << core::describe_thread_topology() << std::flush;
+    }
+    
+    // SIGHUP: перечитать файл и отдать каждой подсистеме только её
+    // изменения - соединения ASIC и пиров не трогаются
+    auto reload_config = [&] {
+        auto loaded = args.config_path ? Config::load(*args.config_path) : Config::load_with_search();
+        if (!loaded) {
+            QUAXIS_LOG(Error, "Перезагрузка конфигурации: {}", loaded.error().message);
+            return;
+        }
+        if (auto valid = loaded->validate(); !valid) {
+            QUAXIS_LOG(Error, "Перезагрузка конфигурации: {}", valid.error().message);
+            return;
+        }
+        
+        ConfigChanges changes = diff_config(config, *loaded);
+        for (const auto& section : changes.restart_required) {
+            QUAXIS_LOG(Warning, "Перезагрузка конфигурации: [{}] применится только после перезапуска", section);
+        }
+        
+        if (changes.share_difficulty) {
+            share_validator.set_partial_difficulty(*changes.share_difficulty);
+        }
+        if (changes.vardiff) {
+            server.set_vardiff(*changes.vardiff);
+        }
+        if (relay_manager) {
+            for (const auto& peer : changes.relay_peers_removed) {
+                relay_manager->remove_peer(peer.host, peer.port);
+            }
+            for (const auto& peer : changes.relay_peers_added) {
+                if (auto result = relay_manager->add_peer(peer); !result) {
+                    QUAXIS_LOG(Warning, "Relay пир {}:{} не добавлен: {}", peer.host, peer.port, result.error().message);
+                }
+            }
+        } else if (!changes.relay_peers_added.empty() || !changes.relay_peers_removed.empty()) {
+            QUAXIS_LOG(Warning, "Перезагрузка конфигурации: relay выключен, пиры применятся после перезапуска");
+            changes.relay_peers_added.clear();
+            changes.relay_peers_removed.clear();
+        }
+        // Merged chains опрашивает ChainManager встраивающего процесса:
+        // здесь их некому переключить
+        if (!changes.chains_toggled.empty()) {
+            QUAXIS_LOG(Warning, "Перезагрузка конфигурации: merged mining в этом процессе не запущен, "
+                                "[merged_mining.chains] применится после перезапуска");
+            changes.chains_toggled.clear();
+        }
+        
+        changes.apply_to(config);
+        QUAXIS_LOG(Info, "Конфигурация перечитана");
+    };
+    
+    uint64_t shm_lost_reported = 0;
+    uint64_t zmq_lost_reported = 0;
     while (g_running.load(std::memory_order_relaxed)) {
+        // SIGHUP: перечитать конфигурацию
+        if (g_reload.exchange(false, std::memory_order_relaxed)) {
+            reload_config();
+        }
+        
+        // SIGUSR2: переключить профиль PMU
+        if (g_pmu_toggle.exchange(false, std::memory_order_relaxed)) {
+            const bool enable = !core::pmu_enabled();
+            if (core::set_pmu_enabled(enable)) {
+                QUAXIS_LOG(Info, "Профиль PMU включён");
+            } else if (enable) {
+                QUAXIS_LOG(Warning, "Профиль PMU недоступен: {}", core::pmu_unavailable_reason());
+            } else {
+                QUAXIS_LOG(Info, "Профиль PMU выключен");
+            }
+        }
+        
+        // События SHM, перезаписанные до прочтения
+        if (shm_subscriber) {
+            uint64_t lost = shm_subscriber->lost_events();
+            if (lost != shm_lost_reported) {
+                QUAXIS_LOG(Warning, "SHM: пропущено событий кольца: {}", (lost - shm_lost_reported));
+                shm_lost_reported = lost;
+            }
+        }
+        
+        // Уведомления ZMQ, потерянные по номеру сообщения
+        if (zmq_subscriber) {
+            uint64_t lost = zmq_subscriber->lost_notifications();
+            if (lost != zmq_lost_reported) {
+                QUAXIS_LOG(Warning, "ZMQ: пропущено уведомлений: {}", (lost - zmq_lost_reported));
+                zmq_lost_reported = lost;
+            }
+        }
+        
+        // Перцентили этапов трассировки
+        if (config.logging.latency_trace) {
+            core::collect_trace();
+            std::vector<log::LatencyStats> latency;
+            for (const auto& stage : core::trace_stage_stats()) {
+                latency.push_back({std::string(core::to_string(stage.stage)), stage.count,
+                                   stage.p50_us, stage.p90_us, stage.p99_us, stage.max_us});
+            }
+            status_reporter.update_latency_stats(latency);
+        }
+        
+        // Потерянная работа: событие закрывается по сроку ожидания RSP_JOB_LOADED
+        stale_work.tick(StaleClock::now());
+        if (const auto stale = stale_work.snapshot(); stale.last_event) {
+            log::StaleWorkStats stale_stats;
+            stale_stats.events = stale.events;
+            stale_stats.pipeline_th = stale.wasted_th[static_cast<std::size_t>(mining::StaleCause::Pipeline)];
+            stale_stats.unit_switch_th = stale.wasted_th[static_cast<std::size_t>(mining::StaleCause::UnitSwitch)];
+            stale_stats.speculative_th =
+                stale.wasted_th[static_cast<std::size_t>(mining::StaleCause::SpeculativeInvalid)];
+            stale_stats.last_height = stale.last_event->height;
+            stale_stats.last_source = std::string(mining::to_string(stale.last_event->source));
+            stale_stats.last_th = stale.last_event->total_th();
+            stale_stats.last_pipeline_ms = stale.last_event->pipeline_ms;
+            stale_stats.last_switch_max_ms = stale.last_event->switch_max_ms;
+            status_reporter.update_stale_work_stats(stale_stats);
+        }
+        
         // Обновляем статистику ASIC
         log::AsicStats asic_stats;
         asic_stats.connected_count = static_cast<uint32_t>(server.connection_count());
         status_reporter.update_asic_stats(asic_stats);
         
+        if (shm_stats) {
+            shm_stats->publish();
+        }
+        
+        // Преемник запрошен: сервер отдаёт сокеты, при неудаче - забирает обратно
+        if (handoff_listener && handoff_listener->poll_request()) {
+            QUAXIS_LOG(Info, "Передача работы новому процессу...");
+            network::HandoffPackage package;
+            package.jobs = job_manager.export_handoff();
+            package.server = server.detach_for_handoff();
+            auto transferred = handoff_listener->transfer(package);
+            if (transferred) {
+                // Сокеты остаются открытыми в новом процессе
+                package.close_descriptors();
+                QUAXIS_LOG(Info, "Работа передана новому процессу");
+                break;
+            }
+            QUAXIS_LOG(Warning, "Передача не удалась, работа продолжается: {}", transferred.error().message);
+            if (auto resumed = server.resume(std::move(package.server), true); !resumed) {
+                QUAXIS_LOG(Error, "Сервер не восстановлен: {}", resumed.error().message);
+                break;
+            }
+            if (auto listen_result = handoff_listener->start(); !listen_result) {
+                QUAXIS_LOG(Warning, "{}", listen_result.error().message);
+                handoff_listener.reset();
+            }
+        }
+        
         // Пауза перед следующей итерацией
         std::this_thread::sleep_for(std::chrono::seconds(1));
     }
     
     // Graceful shutdown
-    std::cout << "[INFO] Остановка сервера..." << std::endl;
+    QUAXIS_LOG(Info, "Остановка сервера...");
+    
+    // Фоновые шаги запуска завершаются до остановки своих подсистем
+    startup.wait_all();
     
     if (shm_subscriber) {
         shm_subscriber->stop();
     }
+    if (shm_template_subscriber) {
+        shm_template_subscriber->stop();
+    }
+    if (zmq_subscriber) {
+        zmq_subscriber->stop();
+    }
+    if (handoff_listener) {
+        handoff_listener->stop();
+    }
+    if (metrics_server) {
+        metrics_server->stop();
+    }
     status_reporter.stop();
+    if (feed_client) {
+        feed_client->stop();
+    }
+    if (feed_server) {
+        feed_server->stop();
+    }
     server.stop();
+    if (virtual_asic) {
+        virtual_asic->stop();
+    }
+    share_validator.stop_workers();
+    if (share_journal) {
+        share_journal->stop();
+    }
+    block_submitter.stop();
+    if (relay_manager) {
+        relay_manager->stop();
+    }
+    executor.stop();
+    if (config.logging.latency_trace) {
+        core::collect_trace();  // хвост событий в дамп
+        core::close_trace_dump();
+    }
     
-    std::cout << "[INFO] Quaxis Solo Miner остановлен" << std::endl;
+    QUAXIS_LOG(Info, "Quaxis Solo Miner остановлен");
+    core::stop_log();
     
     return 0;
 }
@@ -9,6 +9,7 @@
 #include "../core/byte_order.hpp"
 
 #include <algorithm>
+#include <bit>
 #include <cstring>
 
 namespace quaxis::merged {
@@ -72,37 +73,72 @@ Bytes MerkleBranch::serialize() const {
 }
 
 Result<MerkleBranch> MerkleBranch::deserialize(ByteSpan data) {
+    auto view = MerkleBranchView::parse(data);
+    if (!view) {
+        return std::unexpected(view.error());
+    }
+    return view->to_branch();
+}
+
+// =============================================================================
+// MerkleBranchView Implementation
+// =============================================================================
+
+Hash256 MerkleBranchView::compute_root(const Hash256& leaf_hash) const noexcept {
+    Hash256 current = leaf_hash;
+    uint32_t idx = index;
+    
+    for (std::size_t i = 0; i < size(); ++i) {
+        const uint8_t* hash = hashes.data() + i * 32;
+        std::array<uint8_t, 64> combined{};
+        
+        if ((idx & 1) == 0) {
+            std::copy_n(current.begin(), 32, combined.begin());
+            std::copy_n(hash, 32, combined.begin() + 32);
+        } else {
+            std::copy_n(hash, 32, combined.begin());
+            std::copy_n(current.begin(), 32, combined.begin() + 32);
+        }
+        
+        current = crypto::sha256d(combined);
+        idx >>= 1;
+    }
+    
+    return current;
+}
+
+bool MerkleBranchView::verify(
+    const Hash256& leaf_hash,
+    const Hash256& expected_root
+) const noexcept {
+    return compute_root(leaf_hash) == expected_root;
+}
+
+MerkleBranch MerkleBranchView::to_branch() const {
+    MerkleBranch result;
+    result.hashes.resize(size());
+    for (std::size_t i = 0; i < size(); ++i) {
+        std::copy_n(hashes.data() + i * 32, 32, result.hashes[i].begin());
+    }
+    result.index = index;
+    return result;
+}
+
+Result<MerkleBranchView> MerkleBranchView::parse(ByteSpan data) {
     if (data.empty()) {
         return std::unexpected(Error{ErrorCode::CryptoInvalidLength, 
             "Пустые данные для десериализации MerkleBranch"});
     }
     
-    MerkleBranch result;
-    std::size_t offset = 0;
-    
-    // Количество хешей
-    std::size_t hash_count = data[offset++];
-    
-    if (data.size() < offset + hash_count * 32 + 4) {
+    std::size_t hashes_size = static_cast<std::size_t>(data[0]) * 32;
+    if (data.size() < 1 + hashes_size + 4) {
         return std::unexpected(Error{ErrorCode::CryptoInvalidLength,
             "Недостаточно данных для десериализации MerkleBranch"});
     }
     
-    // Хеши
-    result.hashes.reserve(hash_count);
-    for (std::size_t i = 0; i < hash_count; ++i) {
-        Hash256 hash;
-        std::copy_n(data.data() + offset, 32, hash.begin());
-        result.hashes.push_back(hash);
-        offset += 32;
-    }
-    
-    // Индекс
-    result.index = static_cast<uint32_t>(data[offset]) |
-                   (static_cast<uint32_t>(data[offset + 1]) << 8) |
-                   (static_cast<uint32_t>(data[offset + 2]) << 16) |
-                   (static_cast<uint32_t>(data[offset + 3]) << 24);
-    
+    MerkleBranchView result;
+    result.hashes = data.subspan(1, hashes_size);
+    result.index = read_le32(data.data() + 1 + hashes_size);
     return result;
 }
 
@@ -110,32 +146,34 @@ Result<MerkleBranch> MerkleBranch::deserialize(ByteSpan data) {
 // AuxPow Implementation
 // =============================================================================
 
-bool AuxPow::verify(const Hash256& aux_hash) const noexcept {
+namespace {
+
+/// @brief Проверка AuxPoW, общая для AuxPow и AuxPowView
+template<typename AuxPowLike>
+bool verify_auxpow(const AuxPowLike& auxpow, const Hash256& aux_hash) noexcept {
     // 1. Проверяем aux_branch: aux_hash должен быть в aux merkle root
     // aux merkle root находится в coinbase после AUXPOW_MAGIC
-    
-    // Найти commitment в coinbase
-    auto commitment = AuxCommitment::find_in_coinbase(coinbase_tx);
+    auto commitment = AuxCommitment::find_in_coinbase(auxpow.coinbase_tx);
     if (!commitment) {
         return false;
     }
     
-    // Проверить aux_branch
-    if (!aux_branch.verify(aux_hash, commitment->aux_merkle_root)) {
+    if (!auxpow.aux_branch.verify(aux_hash, commitment->aux_merkle_root)) {
         return false;
     }
     
     // 2. Проверяем coinbase_branch: coinbase должна быть в merkle root заголовка
-    // Извлекаем merkle root из parent_header
     Hash256 parent_merkle_root;
-    std::copy_n(parent_header.data() + 36, 32, parent_merkle_root.begin());
+    std::copy_n(auxpow.parent_header.data() + 36, 32, parent_merkle_root.begin());
     
-    Hash256 coinbase_txid = crypto::sha256d(coinbase_tx);
-    if (!coinbase_branch.verify(coinbase_txid, parent_merkle_root)) {
-        return false;
-    }
-    
-    return true;
+    Hash256 coinbase_txid = crypto::sha256d(ByteSpan(auxpow.coinbase_tx));
+    return auxpow.coinbase_branch.verify(coinbase_txid, parent_merkle_root);
+}
+
+} // anonymous namespace
+
+bool AuxPow::verify(const Hash256& aux_hash) const noexcept {
+    return verify_auxpow(*this, aux_hash);
 }
 
 Hash256 AuxPow::get_parent_hash() const noexcept {
@@ -172,61 +210,141 @@ Bytes AuxPow::serialize() const {
     return result;
 }
 
+// =============================================================================
+// AuxPowHexBuilder Implementation
+// =============================================================================
+
+AuxPowHexBuilder::AuxPowHexBuilder(const AuxPow& common) : common_(common) {
+    common_.aux_branch = {};
+    encode_prefix();
+    set_parent_header(common.parent_header);
+}
+
+AuxPowHexBuilder::AuxPowHexBuilder(Bytes coinbase_tx, MerkleBranch coinbase_branch) {
+    common_.coinbase_hash = crypto::sha256d(coinbase_tx);
+    common_.coinbase_tx = std::move(coinbase_tx);
+    common_.coinbase_branch = std::move(coinbase_branch);
+    encode_prefix();
+    set_parent_header(common_.parent_header);
+}
+
+void AuxPowHexBuilder::encode_prefix() {
+    // Префикс: длина coinbase (LE), coinbase, coinbase hash, coinbase branch
+    const auto coinbase_len = static_cast<uint32_t>(common_.coinbase_tx.size());
+    const std::array<uint8_t, 4> len_bytes = {
+        static_cast<uint8_t>(coinbase_len & 0xFF),
+        static_cast<uint8_t>((coinbase_len >> 8) & 0xFF),
+        static_cast<uint8_t>((coinbase_len >> 16) & 0xFF),
+        static_cast<uint8_t>((coinbase_len >> 24) & 0xFF)
+    };
+    const auto coinbase_branch_data = common_.coinbase_branch.serialize();
+    
+    prefix_hex_.reserve((4 + common_.coinbase_tx.size() + 32 + coinbase_branch_data.size()) * 2);
+    append_hex(prefix_hex_, len_bytes);
+    append_hex(prefix_hex_, common_.coinbase_tx);
+    append_hex(prefix_hex_, common_.coinbase_hash);
+    append_hex(prefix_hex_, coinbase_branch_data);
+}
+
+void AuxPowHexBuilder::set_parent_header(const std::array<uint8_t, 80>& parent_header) {
+    // Суффикс: parent header (буфер после первого раза не перевыделяется)
+    common_.parent_header = parent_header;
+    suffix_hex_.clear();
+    append_hex(suffix_hex_, parent_header);
+}
+
+std::string AuxPowHexBuilder::build(const MerkleBranch& aux_branch) const {
+    const auto aux_branch_data = aux_branch.serialize();
+    
+    std::string hex;
+    hex.reserve(prefix_hex_.size() + aux_branch_data.size() * 2 + suffix_hex_.size());
+    hex.append(prefix_hex_);
+    append_hex(hex, aux_branch_data);
+    hex.append(suffix_hex_);
+    return hex;
+}
+
 Result<AuxPow> AuxPow::deserialize(ByteSpan data) {
+    auto view = AuxPowView::parse(data);
+    if (!view) {
+        return std::unexpected(view.error());
+    }
+    return view->to_owned();
+}
+
+// =============================================================================
+// AuxPowView Implementation
+// =============================================================================
+
+bool AuxPowView::verify(const Hash256& aux_hash) const noexcept {
+    return verify_auxpow(*this, aux_hash);
+}
+
+Hash256 AuxPowView::get_parent_hash() const noexcept {
+    return crypto::sha256d(parent_header);
+}
+
+AuxPow AuxPowView::to_owned() const {
+    AuxPow result;
+    result.coinbase_tx.assign(coinbase_tx.begin(), coinbase_tx.end());
+    result.coinbase_hash = coinbase_hash;
+    result.coinbase_branch = coinbase_branch.to_branch();
+    result.aux_branch = aux_branch.to_branch();
+    std::copy_n(parent_header.data(), 80, result.parent_header.begin());
+    return result;
+}
+
+Result<AuxPowView> AuxPowView::parse(ByteSpan data) {
     if (data.size() < 4) {
         return std::unexpected(Error{ErrorCode::CryptoInvalidLength,
             "Недостаточно данных для десериализации AuxPow"});
     }
     
-    AuxPow result;
-    std::size_t offset = 0;
+    AuxPowView result;
     
     // Длина coinbase
-    uint32_t coinbase_len = static_cast<uint32_t>(data[offset]) |
-                            (static_cast<uint32_t>(data[offset + 1]) << 8) |
-                            (static_cast<uint32_t>(data[offset + 2]) << 16) |
-                            (static_cast<uint32_t>(data[offset + 3]) << 24);
-    offset += 4;
+    std::size_t coinbase_len = read_le32(data.data());
+    data = data.subspan(4);
     
-    if (data.size() < offset + coinbase_len) {
+    if (data.size() < coinbase_len) {
         return std::unexpected(Error{ErrorCode::CryptoInvalidLength,
             "Недостаточно данных для coinbase"});
     }
     
     // Coinbase
-    result.coinbase_tx.assign(data.data() + offset, data.data() + offset + coinbase_len);
-    offset += coinbase_len;
+    result.coinbase_tx = data.first(coinbase_len);
+    data = data.subspan(coinbase_len);
     
     // Coinbase hash
-    if (data.size() < offset + 32) {
+    if (data.size() < 32) {
         return std::unexpected(Error{ErrorCode::CryptoInvalidLength,
             "Недостаточно данных для coinbase hash"});
     }
-    std::copy_n(data.data() + offset, 32, result.coinbase_hash.begin());
-    offset += 32;
+    std::copy_n(data.data(), 32, result.coinbase_hash.begin());
+    data = data.subspan(32);
     
     // Coinbase branch
-    auto coinbase_branch_result = MerkleBranch::deserialize(data.subspan(offset));
-    if (!coinbase_branch_result) {
-        return std::unexpected(coinbase_branch_result.error());
+    auto coinbase_branch = MerkleBranchView::parse(data);
+    if (!coinbase_branch) {
+        return std::unexpected(coinbase_branch.error());
     }
-    result.coinbase_branch = std::move(*coinbase_branch_result);
-    offset += result.coinbase_branch.serialize().size();
+    result.coinbase_branch = *coinbase_branch;
+    data = data.subspan(coinbase_branch->serialized_length());
     
     // Aux branch
-    auto aux_branch_result = MerkleBranch::deserialize(data.subspan(offset));
-    if (!aux_branch_result) {
-        return std::unexpected(aux_branch_result.error());
+    auto aux_branch = MerkleBranchView::parse(data);
+    if (!aux_branch) {
+        return std::unexpected(aux_branch.error());
     }
-    result.aux_branch = std::move(*aux_branch_result);
-    offset += result.aux_branch.serialize().size();
+    result.aux_branch = *aux_branch;
+    data = data.subspan(aux_branch->serialized_length());
     
     // Parent header
-    if (data.size() < offset + 80) {
+    if (data.size() < 80) {
         return std::unexpected(Error{ErrorCode::CryptoInvalidLength,
             "Недостаточно данных для parent header"});
     }
-    std::copy_n(data.data() + offset, 80, result.parent_header.begin());
+    result.parent_header = data.first(80);
     
     return result;
 }
@@ -394,6 +512,25 @@ uint32_t compute_slot_id(
     return (id ^ nonce) % tree_size;
 }
 
+AuxTreeLayout solve_aux_tree_layout(std::span<const Hash256> chain_ids) {
+    AuxTreeLayout layout;
+    layout.tree_size = static_cast<uint32_t>(std::bit_ceil(std::max<std::size_t>(chain_ids.size(), 1)));
+    
+    std::vector<uint32_t> slots(chain_ids.size());
+    for (uint32_t size = layout.tree_size; size <= (1u << MAX_MERKLE_DEPTH); size *= 2) {
+        for (std::size_t i = 0; i < chain_ids.size(); ++i) {
+            slots[i] = compute_slot_id(chain_ids[i], layout.merkle_nonce, size);
+        }
+        std::sort(slots.begin(), slots.end());
+        if (std::adjacent_find(slots.begin(), slots.end()) == slots.end()) {
+            layout.tree_size = size;
+            return layout;
+        }
+    }
+    
+    return layout;
+}
+
 AuxCommitment create_aux_commitment(
     const std::vector<Hash256>& aux_hashes,
     const std::vector<Hash256>& chain_ids
@@ -404,16 +541,12 @@ AuxCommitment create_aux_commitment(
         return commitment;
     }
     
-    // Вычисляем размер дерева (следующая степень двойки)
-    std::size_t n = 1;
-    while (n < aux_hashes.size()) {
-        n *= 2;
-    }
-    commitment.tree_size = static_cast<uint32_t>(n);
-    
-    // Подбираем nonce чтобы избежать коллизий slot ID
-    // (упрощённая версия - используем 0)
-    commitment.merkle_nonce = 0;
+    // Размер дерева без коллизий slot ID
+    const auto layout = solve_aux_tree_layout(
+        std::span(chain_ids).first(std::min(aux_hashes.size(), chain_ids.size())));
+    commitment.tree_size = layout.tree_size;
+    commitment.merkle_nonce = layout.merkle_nonce;
+    const std::size_t n = commitment.tree_size;
     
     // Размещаем хеши по slot ID
     std::vector<Hash256> slots(n, Hash256{});
@@ -464,7 +597,7 @@ Hash256 bits_to_target(uint32_t bits) noexcept {
         target[2] = static_cast<uint8_t>((mantissa >> 16) & 0xFF);
     } else {
         std::size_t shift = exponent - 3;
-        if (shift < 29) {
+        if (shift <= 29) {
             target[shift] = static_cast<uint8_t>(mantissa & 0xFF);
             target[shift + 1] = static_cast<uint8_t>((mantissa >> 8) & 0xFF);
             target[shift + 2] = static_cast<uint8_t>((mantissa >> 16) & 0xFF);
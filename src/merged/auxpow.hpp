@@ -23,6 +23,7 @@
 
 #include <vector>
 #include <optional>
+#include <span>
 #include <cstdint>
 
 namespace quaxis::merged {
@@ -92,6 +93,52 @@ struct MerkleBranch {
     [[nodiscard]] static Result<MerkleBranch> deserialize(ByteSpan data);
 };
 
+/**
+ * @brief Merkle branch поверх сериализованных данных
+ * 
+ * Не владеет памятью: hashes - view на хеши во входном буфере (формат
+ * MerkleBranch::serialize()). parse() проверяет только длину.
+ */
+struct MerkleBranchView {
+    /// @brief Хеши подряд (size() * 32 байт)
+    ByteSpan hashes;
+    
+    /// @brief Индекс позиции (битовая маска: 0=лево, 1=право)
+    uint32_t index{0};
+    
+    [[nodiscard]] std::size_t size() const noexcept { return hashes.size() / 32; }
+    
+    /**
+     * @brief Вычислить корень (как MerkleBranch::compute_root)
+     */
+    [[nodiscard]] Hash256 compute_root(const Hash256& leaf_hash) const noexcept;
+    
+    [[nodiscard]] bool verify(
+        const Hash256& leaf_hash,
+        const Hash256& expected_root
+    ) const noexcept;
+    
+    /**
+     * @brief Размер сериализации (байт)
+     */
+    [[nodiscard]] std::size_t serialized_length() const noexcept {
+        return 1 + hashes.size() + 4;
+    }
+    
+    /**
+     * @brief Скопировать в MerkleBranch
+     */
+    [[nodiscard]] MerkleBranch to_branch() const;
+    
+    /**
+     * @brief Разобрать branch с начала data
+     * 
+     * @param data Данные (могут продолжаться после branch)
+     * @return Result<MerkleBranchView> View или ошибка
+     */
+    [[nodiscard]] static Result<MerkleBranchView> parse(ByteSpan data);
+};
+
 // =============================================================================
 // AuxPoW структура
 // =============================================================================
@@ -149,6 +196,100 @@ struct AuxPow {
     [[nodiscard]] static Result<AuxPow> deserialize(ByteSpan data);
 };
 
+/**
+ * @brief Hex AuxPoW для нескольких chains одного parent share
+ * 
+ * У chains одного share различается только aux_branch. Части до него
+ * (coinbase, coinbase branch) и после (parent header) кодируются в hex
+ * один раз, AuxPoW chain - склейка с её aux branch.
+ * 
+ * Coinbase и coinbase branch одни на все shares задания: builder,
+ * созданный по ним, переиспользуется между находками, для очередного
+ * share перекодируется только parent header (set_parent_header).
+ */
+class AuxPowHexBuilder {
+public:
+    /**
+     * @brief Закодировать общие части
+     * 
+     * @param common AuxPoW share (aux_branch не используется)
+     */
+    explicit AuxPowHexBuilder(const AuxPow& common);
+    
+    /**
+     * @brief Закодировать части задания (parent header - нулевой)
+     * 
+     * @param coinbase_tx Coinbase транзакция родительского блока
+     * @param coinbase_branch Merkle branch от coinbase до merkle root
+     */
+    AuxPowHexBuilder(Bytes coinbase_tx, MerkleBranch coinbase_branch);
+    
+    /**
+     * @brief Сменить parent header (следующий share того же задания)
+     */
+    void set_parent_header(const std::array<uint8_t, 80>& parent_header);
+    
+    /**
+     * @brief AuxPoW chain в hex (формат AuxPow::serialize())
+     * 
+     * @param aux_branch Branch слота chain в aux дереве
+     */
+    [[nodiscard]] std::string build(const MerkleBranch& aux_branch) const;
+    
+    /// @brief Общая часть AuxPoW (aux_branch пустой)
+    [[nodiscard]] const AuxPow& common() const noexcept { return common_; }
+    
+private:
+    void encode_prefix();
+    
+    AuxPow common_;
+    std::string prefix_hex_;
+    std::string suffix_hex_;
+};
+
+/**
+ * @brief AuxPoW поверх сериализованных данных (формат AuxPow::serialize())
+ * 
+ * Поля - view во входной буфер, буфер должен пережить view. Проверка
+ * через verify() не выделяет память.
+ */
+struct AuxPowView {
+    /// @brief Coinbase транзакция родительского блока
+    ByteSpan coinbase_tx;
+    
+    /// @brief Хеш coinbase транзакции
+    Hash256 coinbase_hash{};
+    
+    /// @brief Merkle branch от coinbase до merkle root родительского блока
+    MerkleBranchView coinbase_branch;
+    
+    /// @brief Merkle branch от aux chain hash до aux merkle root
+    MerkleBranchView aux_branch;
+    
+    /// @brief Заголовок родительского блока (80 байт)
+    ByteSpan parent_header;
+    
+    /**
+     * @brief Проверить AuxPoW (как AuxPow::verify)
+     */
+    [[nodiscard]] bool verify(const Hash256& aux_hash) const noexcept;
+    
+    [[nodiscard]] Hash256 get_parent_hash() const noexcept;
+    
+    /**
+     * @brief Скопировать в AuxPow
+     */
+    [[nodiscard]] AuxPow to_owned() const;
+    
+    /**
+     * @brief Разобрать AuxPoW
+     * 
+     * @param data Сериализованные данные
+     * @return Result<AuxPowView> View или ошибка
+     */
+    [[nodiscard]] static Result<AuxPowView> parse(ByteSpan data);
+};
+
 // =============================================================================
 // AuxPoW Commitment
 // =============================================================================
@@ -168,6 +309,8 @@ struct AuxCommitment {
     /// @brief Nonce для вычисления slot ID
     uint32_t merkle_nonce{0};
     
+    [[nodiscard]] bool operator==(const AuxCommitment&) const = default;
+    
     /**
      * @brief Сериализовать commitment для включения в coinbase
      * 
@@ -229,6 +372,32 @@ struct AuxCommitment {
     uint32_t tree_size
 ) noexcept;
 
+/**
+ * @brief Размер и nonce aux дерева
+ */
+struct AuxTreeLayout {
+    /// @brief Размер Merkle дерева (степень двойки)
+    uint32_t tree_size{1};
+    
+    /// @brief Nonce для вычисления slot ID
+    uint32_t merkle_nonce{0};
+};
+
+/**
+ * @brief Подобрать наименьшее дерево, в котором slot ID chains не совпадают
+ * 
+ * Глубина дерева - длина aux branch каждой chain и число хешей на
+ * пересчёт commitment. Перебираются размеры от bit_ceil(n) до
+ * 2^MAX_MERKLE_DEPTH. Nonce в compute_slot_id входит через XOR, а при
+ * размере - степени двойки XOR с константой переставляет слоты, не
+ * разводя совпавшие: перебирать nonce бесполезно, он остаётся 0.
+ * 
+ * @param chain_ids Идентификаторы chains
+ * @return AuxTreeLayout Размер без коллизий; если его нет (совпадают
+ *         младшие 16 бит id) - bit_ceil(n)
+ */
+[[nodiscard]] AuxTreeLayout solve_aux_tree_layout(std::span<const Hash256> chain_ids);
+
 /**
  * @brief Создать commitment для списка auxiliary chains
  * 
@@ -9,7 +9,9 @@
 #pragma once
 
 #include "../core/types.hpp"
+#include "../core/clock.hpp"
 #include "auxpow.hpp"
+#include "rpc/aux_rpc_client.hpp"
 
 #include <string>
 #include <optional>
@@ -104,9 +106,12 @@ struct AuxBlockTemplate {
     
     /// @brief Время создания шаблона
     std::chrono::steady_clock::time_point created_at{
-        std::chrono::steady_clock::now()
+        core::CoarseClock::now()
     };
     
+    /// @brief Шаблон из кеша прошлого запуска, нода его ещё не подтвердила
+    bool from_cache{false};
+    
     /**
      * @brief Проверить, устарел ли шаблон
      * 
@@ -114,11 +119,30 @@ struct AuxBlockTemplate {
      * @return true если шаблон устарел
      */
     [[nodiscard]] bool is_stale(std::chrono::seconds max_age) const noexcept {
-        auto age = std::chrono::steady_clock::now() - created_at;
+        auto age = core::CoarseClock::now() - created_at;
         return age > max_age;
     }
 };
 
+// =============================================================================
+// Собственный commitment chain
+// =============================================================================
+
+/**
+ * @brief Commitment chain, которая не использует aux дерево (тег fabe6d6d)
+ * 
+ * RSK и Hathor ждут свой тег с хешем блока в coinbase родителя - здесь это
+ * OP_RETURN выход с нулевой суммой. Такие chains не занимают слот aux
+ * дерева, а выходы coinbase лежат после первых 64 байт: смена тега не
+ * меняет midstate coinbase.
+ */
+struct CoinbaseCommitment {
+    /// @brief scriptPubKey выхода (OP_RETURN <тег>)
+    Bytes script;
+    
+    [[nodiscard]] bool operator==(const CoinbaseCommitment&) const = default;
+};
+
 // =============================================================================
 // Интерфейс Chain
 // =============================================================================
@@ -209,6 +233,34 @@ public:
      */
     [[nodiscard]] virtual Result<AuxBlockTemplate> get_block_template() = 0;
     
+    /**
+     * @brief Запрос шаблона для параллельного опроса chains
+     * 
+     * ChainManager выполняет запросы всех chains одним AuxRpcMulti и
+     * отдаёт ответ в accept_template_response().
+     * 
+     * @return Запрос или nullopt (chain опрашивается get_block_template())
+     */
+    [[nodiscard]] virtual std::optional<AuxRpcRequest> template_request() {
+        return std::nullopt;
+    }
+    
+    /**
+     * @brief Шаблон из ответа на template_request()
+     * 
+     * @param response JSON ответ или ошибка вызова
+     * @return Result<AuxBlockTemplate> Шаблон или ошибка
+     */
+    [[nodiscard]] virtual Result<AuxBlockTemplate> accept_template_response(
+        Result<std::string> response
+    ) {
+        if (!response) {
+            return std::unexpected(response.error());
+        }
+        return std::unexpected(Error{ErrorCode::RpcInternalError,
+            "Параллельный опрос не поддерживается"});
+    }
+    
     /**
      * @brief Отправить найденный блок
      * 
@@ -221,6 +273,50 @@ public:
         const AuxBlockTemplate& block_template
     ) = 0;
     
+    /**
+     * @brief Запрос отправки блока для параллельной отправки в chains
+     * 
+     * ChainManager отправляет блок во все подходящие chains одним
+     * AuxRpcMulti и отдаёт ответ в accept_submit_response().
+     * 
+     * @param auxpow_hex AuxPoW chain в hex (формат AuxPow::serialize())
+     * @param block_template Исходный шаблон блока
+     * @return Запрос или nullopt (chain отправляется submit_block())
+     */
+    [[nodiscard]] virtual std::optional<AuxRpcRequest> submit_request(
+        [[maybe_unused]] std::string_view auxpow_hex,
+        [[maybe_unused]] const AuxBlockTemplate& block_template
+    ) {
+        return std::nullopt;
+    }
+    
+    /**
+     * @brief Собственный commitment chain в coinbase родителя
+     * 
+     * @param block_template Текущий шаблон блока
+     * @return Commitment или nullopt (chain - лист aux дерева)
+     */
+    [[nodiscard]] virtual std::optional<CoinbaseCommitment> coinbase_commitment(
+        [[maybe_unused]] const AuxBlockTemplate& block_template
+    ) const {
+        return std::nullopt;
+    }
+    
+    /**
+     * @brief Результат отправки из ответа на submit_request()
+     * 
+     * @param response JSON ответ или ошибка вызова
+     * @return Result<void> Успех или ошибка отправки
+     */
+    [[nodiscard]] virtual Result<void> accept_submit_response(
+        Result<std::string> response
+    ) {
+        if (!response) {
+            return std::unexpected(response.error());
+        }
+        return {};
+    }
+    
     /**
      * @brief Проверить, подходит ли данный хеш для этой chain
      * 
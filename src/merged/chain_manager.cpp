@@ -4,6 +4,8 @@
  */
 
 #include "chain_manager.hpp"
+#include "poll_scheduler.hpp"
+#include "template_cache.hpp"
 #include "chains/base_chain.hpp"
 #include "chains/fractal_chain.hpp"
 #include "chains/rsk_chain.hpp"
@@ -19,6 +21,12 @@
 #include "chains/unobtanium_chain.hpp"
 #include "chains/terracoin_chain.hpp"
 
+#include "../core/primitives/merkle.hpp"
+#include "../core/primitives/uint256.hpp"
+#include "../core/chain/chain_registry.hpp"
+
+#include <algorithm>
+#include <memory>
 #include <thread>
 #include <atomic>
 #include <condition_variable>
@@ -33,44 +41,48 @@ namespace {
 
 /**
  * @brief Создать chain по имени
+ * 
+ * Имя сопоставляется с core::BUILTIN_CHAINS один раз при старте, дальше
+ * chain адресуется индексом.
  */
 std::unique_ptr<IChain> create_chain(const ChainConfig& config) {
-    if (config.name == "fractal") {
-        return std::make_unique<FractalChain>(config);
-    }
-    if (config.name == "rsk" || config.name == "rootstock") {
-        return std::make_unique<RSKChain>(config);
-    }
-    if (config.name == "syscoin") {
-        return std::make_unique<SyscoinChain>(config);
-    }
-    if (config.name == "namecoin") {
-        return std::make_unique<NamecoinChain>(config);
-    }
-    if (config.name == "elastos") {
-        return std::make_unique<ElastosChain>(config);
-    }
-    if (config.name == "hathor") {
-        return std::make_unique<HathorChain>(config);
-    }
-    if (config.name == "vcash") {
-        return std::make_unique<VCashChain>(config);
-    }
-    // Дополнительные chains
-    if (config.name == "myriad") {
-        return std::make_unique<MyriadChain>(config);
-    }
-    if (config.name == "huntercoin") {
-        return std::make_unique<HuntercoinChain>(config);
-    }
-    if (config.name == "emercoin") {
-        return std::make_unique<EmercoinChain>(config);
-    }
-    if (config.name == "unobtanium") {
-        return std::make_unique<UnobtaniumChain>(config);
+    // "rootstock" - второе имя RSK в конфигурации
+    const std::string_view name = config.name == "rootstock"
+        ? std::string_view{"rsk"} : std::string_view{config.name};
+    const auto builtin = core::find_builtin_chain(name);
+    if (!builtin) {
+        return nullptr;
     }
-    if (config.name == "terracoin") {
-        return std::make_unique<TerracoinChain>(config);
+    
+    switch (*builtin) {
+        case core::BuiltinChain::Fractal:
+            return std::make_unique<FractalChain>(config);
+        case core::BuiltinChain::Rsk:
+            return std::make_unique<RSKChain>(config);
+        case core::BuiltinChain::Syscoin:
+            return std::make_unique<SyscoinChain>(config);
+        case core::BuiltinChain::Namecoin:
+            return std::make_unique<NamecoinChain>(config);
+        case core::BuiltinChain::Elastos:
+            return std::make_unique<ElastosChain>(config);
+        case core::BuiltinChain::Hathor:
+            return std::make_unique<HathorChain>(config);
+        case core::BuiltinChain::VCash:
+            return std::make_unique<VCashChain>(config);
+        // Дополнительные chains
+        case core::BuiltinChain::Myriad:
+            return std::make_unique<MyriadChain>(config);
+        case core::BuiltinChain::Huntercoin:
+            return std::make_unique<HuntercoinChain>(config);
+        case core::BuiltinChain::Emercoin:
+            return std::make_unique<EmercoinChain>(config);
+        case core::BuiltinChain::Unobtanium:
+            return std::make_unique<UnobtaniumChain>(config);
+        case core::BuiltinChain::Terracoin:
+            return std::make_unique<TerracoinChain>(config);
+        case core::BuiltinChain::Bitcoin:
+            // Родительская chain, не aux
+            break;
     }
     
     return nullptr;
@@ -90,8 +102,8 @@ struct ChainManager::Impl {
     std::vector<std::unique_ptr<IChain>> chains;
     mutable std::mutex chains_mutex;
     
-    // Текущие шаблоны
-    std::unordered_map<std::string, AuxBlockTemplate> templates;
+    // Текущие шаблоны (индекс - как в chains)
+    std::vector<std::optional<AuxBlockTemplate>> templates;
     mutable std::mutex templates_mutex;
     
     // Статистика
@@ -106,14 +118,152 @@ struct ChainManager::Impl {
     
     // Callbacks
     AuxBlockFoundCallback block_found_callback;
+    AuxCommitmentCallback commitment_callback;
+    
+    // Дерево слотов aux chains (лист - block_hash шаблона) последнего
+    // commitment: при смене шаблона пересчитывается только путь его
+    // слота. Под templates_mutex.
+    mutable core::IncrementalMerkleTree aux_tree;
+    mutable std::vector<Hash256> aux_slots;
+    
+    // Commitment по текущим шаблонам: пересчитывается при приходе нового
+    // шаблона и при включении / выключении chain. Под templates_mutex.
+    mutable std::optional<AuxCommitment> commitment;
+    
+    // Снимок commitments для сборщиков заданий: новый объект на каждое
+    // изменение, читается без мьютексов
+    mutable std::atomic<std::shared_ptr<const AuxCommitmentSnapshot>> commitment_snapshot{
+        std::make_shared<const AuxCommitmentSnapshot>()};
+    
+    // Снимок изменился после последнего вызова commitment_callback
+    // (под templates_mutex)
+    mutable bool commitment_changed{false};
+    
+    // Снимок для отбора chains на каждый share: target активных chains
+    // (включена и есть шаблон) по убыванию - первый самый лёгкий - и индексы
+    // chains параллельным массивом. Публикуется вместе с commitment;
+    // match_chains читает его без мьютексов и виртуальных вызовов IChain.
+    // Target декодируется как в BaseChain::meets_target.
+    struct MatchSnapshot {
+        std::vector<core::uint256> targets;
+        std::vector<uint32_t> chain_indices;
+    };
+    mutable std::atomic<std::shared_ptr<const MatchSnapshot>> match_snapshot{
+        std::make_shared<const MatchSnapshot>()};
+    
+    // Размер aux дерева без коллизий слотов для набора chains-участников
+    // (индексы по возрастанию). Подбирается заново только при смене
+    // набора: включение / выключение chain, первый шаблон chain.
+    mutable AuxTreeLayout tree_layout;
+    mutable std::vector<std::size_t> layout_members;
+    mutable std::vector<std::size_t> members_scratch;
+    mutable std::vector<std::size_t> tree_scratch;
+    
+    // Собственные commitments chains вне aux дерева (RSK, Hathor) в порядке
+    // chains. Пересобираются вместе с commitment, под templates_mutex.
+    mutable std::vector<CoinbaseCommitment> coinbase_commitments;
+    
+    // Параллельный опрос шаблонов (только из worker thread): сроки опроса
+    // каждой chain - по оценке её времени блока
+    PollScheduler poll_schedule;
+    AuxRpcMulti rpc_multi;
+    
+    // Последние шаблоны для быстрого старта (под templates_mutex)
+    TemplateCache template_cache;
+    
+    // Размыкатели опроса (под chains_mutex): недоступная нода не ждёт
+    // крайний срок каждый цикл и не держит шаблон в aux дереве
+    std::vector<CircuitBreaker> breakers;
+    std::vector<AuxRpcRequest> poll_requests;
+    std::vector<std::size_t> poll_indices;
+    
+    // Параллельная отправка найденного блока (под chains_mutex): handles
+    // держат соединения с нодами тёплыми между находками
+    AuxRpcMulti submit_multi;
+    
+    // Уведомления о новом блоке (getblocktemplate longpoll). Клиент - на
+    // chain с longpoll (индекс как в chains), свой: соединение держит
+    // push thread, а не chain.
+    std::vector<std::unique_ptr<AuxRpcClient>> push_clients;
+    std::thread push_thread;
+    
+    // Под cv_mutex: подписка активна (chain не опрашивается по таймеру),
+    // пришло уведомление (опросить chain сразу)
+    std::vector<bool> push_active;
+    std::vector<bool> push_pending;
+    bool push_signal{false};
+    
+    /// @brief Пауза перед повторной подпиской после ошибки
+    static constexpr std::chrono::seconds PUSH_RETRY{5};
     
     explicit Impl(const MergedMiningConfig& cfg) : config(cfg) {
         // Создаём chains из конфигурации
+        const auto now = std::chrono::steady_clock::now();
         for (const auto& chain_config : config.chains) {
             if (auto chain = create_chain(chain_config)) {
                 chains.push_back(std::move(chain));
+                (void)poll_schedule.add_chain(std::chrono::seconds(chain_config.update_interval), now);
+                breakers.emplace_back(chain_config.breaker_failures,
+                                      std::chrono::seconds(chain_config.breaker_open_seconds));
+                push_clients.push_back(chain_config.longpoll
+                    ? std::make_unique<AuxRpcClient>(chain_config.rpc_url, chain_config.rpc_user,
+                                                     chain_config.rpc_password,
+                                                     chain_config.rpc_timeout)
+                    : nullptr);
             }
         }
+        resize_state();
+        load_cached_templates();
+        refresh_commitment();
+    }
+    
+    Impl(const MergedMiningConfig& cfg, std::vector<std::unique_ptr<IChain>> external)
+        : config(cfg), chains(std::move(external)) {
+        const auto now = std::chrono::steady_clock::now();
+        const ChainConfig defaults;
+        for (std::size_t i = 0; i < chains.size(); ++i) {
+            (void)poll_schedule.add_chain(std::chrono::seconds(defaults.update_interval), now);
+            breakers.emplace_back(defaults.breaker_failures,
+                                  std::chrono::seconds(defaults.breaker_open_seconds));
+        }
+        push_clients.resize(chains.size());
+        resize_state();
+        load_cached_templates();
+        refresh_commitment();
+    }
+    
+    /**
+     * @brief Шаблоны прошлого запуска из кеша (при создании, до опроса)
+     * 
+     * Commitment строится по ним сразу; первый опрос chains подтверждает
+     * или заменяет их. Шаблон старше template_cache_max_age или с чужим
+     * chain_id не используется.
+     */
+    void load_cached_templates() {
+        if (config.template_cache_path.empty()) {
+            return;
+        }
+        if (auto opened = template_cache.open(config.template_cache_path); !opened) {
+            return;
+        }
+        const auto oldest = std::chrono::system_clock::now() -
+                            std::chrono::seconds(config.template_cache_max_age);
+        for (std::size_t i = 0; i < chains.size(); ++i) {
+            auto cached = template_cache.load(chains[i]->name());
+            if (cached && cached->saved_at >= oldest &&
+                cached->block_template.chain_id == chains[i]->chain_id()) {
+                templates[i] = std::move(cached->block_template);
+            }
+        }
+    }
+    
+    /**
+     * @brief Состояние по индексу chain - под размер chains
+     */
+    void resize_state() {
+        templates.resize(chains.size());
+        push_active.resize(chains.size(), false);
+        push_pending.resize(chains.size(), false);
     }
     
     ~Impl() {
@@ -136,6 +286,12 @@ struct ChainManager::Impl {
         worker_thread = std::thread([this] {
             worker_loop();
         });
+        
+        if (std::ranges::any_of(push_clients, [](const auto& client) { return client != nullptr; })) {
+            push_thread = std::thread([this] {
+                push_loop();
+            });
+        }
     }
     
     void stop() {
@@ -149,6 +305,9 @@ struct ChainManager::Impl {
         if (worker_thread.joinable()) {
             worker_thread.join();
         }
+        if (push_thread.joinable()) {
+            push_thread.join();
+        }
         
         // Отключаемся от chains
         for (auto& chain : chains) {
@@ -158,103 +317,411 @@ struct ChainManager::Impl {
     
     void worker_loop() {
         while (running) {
-            update_templates();
+            update_templates(take_due(std::chrono::steady_clock::now()));
+            notify_commitment();
             
-            // Ждём интервал или сигнал остановки
+            // Ждём ближайший срок опроса, уведомление или сигнал остановки
+            const auto next_poll = poll_schedule.next_deadline().value_or(
+                std::chrono::steady_clock::now() + std::chrono::seconds(1));
             std::unique_lock<std::mutex> lock(cv_mutex);
-            cv.wait_for(lock, std::chrono::seconds(1), [this] {
-                return !running.load();
+            cv.wait_until(lock, next_poll, [this] {
+                return !running.load() || push_signal;
             });
         }
     }
     
-    void update_templates() {
+    /**
+     * @brief Chains для опроса: с уведомлением, по сроку - без подписки
+     * 
+     * Срок chain с активной подпиской тоже сдвигается: иначе просроченный
+     * срок будил бы worker без дела.
+     */
+    std::vector<bool> take_due(std::chrono::steady_clock::time_point now) {
+        std::lock_guard<std::mutex> lock(cv_mutex);
+        
+        std::vector<bool> due(chains.size());
+        for (std::size_t i = 0; i < chains.size(); ++i) {
+            const bool scheduled = poll_schedule.take_due(i, now);
+            due[i] = push_pending[i] || (scheduled && !push_active[i]);
+            push_pending[i] = false;
+        }
+        push_signal = false;
+        return due;
+    }
+    
+    /**
+     * @brief Держать longpoll подписки chains с longpoll (push thread)
+     * 
+     * Ответ getblocktemplate - сигнал нового блока: chain помечается к
+     * опросу и worker будится сразу, createauxblock уходит только ей.
+     * Пока подписка активна, по таймеру chain не опрашивается. Ошибка
+     * или нода без longpollid возвращают chain к опросу.
+     */
+    void push_loop() {
+        std::vector<AuxRpcRequest> requests;
+        std::vector<std::size_t> indices;
+        for (std::size_t i = 0; i < push_clients.size(); ++i) {
+            if (push_clients[i]) {
+                requests.push_back(AuxRpcRequest{push_clients[i].get(), "getblocktemplate",
+                                                 longpoll_params(""), LONGPOLL_DEADLINE});
+                indices.push_back(i);
+            }
+        }
+        
+        AuxRpcMulti push_multi;
+        push_multi.run(requests, [&](std::size_t k, Result<std::string> response)
+                -> std::optional<std::chrono::milliseconds> {
+            const std::size_t index = indices[k];
+            auto longpoll_id = response ? find_longpoll_id(*response) : std::nullopt;
+            
+            {
+                std::lock_guard<std::mutex> lock(cv_mutex);
+                push_active[index] = longpoll_id.has_value();
+                if (longpoll_id) {
+                    push_pending[index] = true;
+                    push_signal = true;
+                }
+            }
+            
+            if (!response) {
+                // Нода недоступна или deadline: подписка заново
+                requests[k].params = longpoll_params("");
+                return PUSH_RETRY;
+            }
+            if (!longpoll_id) {
+                // Нода без longpoll - только опрос
+                return std::nullopt;
+            }
+            
+            cv.notify_all();
+            requests[k].params = longpoll_params(*longpoll_id);
+            return std::chrono::milliseconds{0};
+        }, running);
+    }
+    
+    /**
+     * @brief Опросить шаблоны chains
+     * 
+     * createauxblock отмеченных chains уходят одним AuxRpcMulti: каждый
+     * шаблон публикуется по приходу ответа, нода, не успевшая к своему
+     * deadline, пропускает цикл и не задерживает остальные. Chain с
+     * разомкнутым размыкателем не опрашивается до пробного опроса.
+     * 
+     * @param due Опрашиваемые chains (индекс как в chains)
+     */
+    void update_templates(const std::vector<bool>& due) {
         std::lock_guard<std::mutex> chains_lock(chains_mutex);
-        std::lock_guard<std::mutex> templates_lock(templates_mutex);
+        const auto now = std::chrono::steady_clock::now();
         
-        for (auto& chain : chains) {
-            if (!chain->is_enabled() || !chain->is_connected()) {
+        poll_requests.clear();
+        poll_indices.clear();
+        for (std::size_t i = 0; i < chains.size(); ++i) {
+            auto& chain = chains[i];
+            if (!due[i] || !chain->is_enabled() || !chain->is_connected() ||
+                !breakers[i].allow(now)) {
                 continue;
             }
             
-            auto result = chain->get_block_template();
-            if (result) {
-                templates[std::string(chain->name())] = std::move(*result);
+            if (auto request = chain->template_request()) {
+                poll_requests.push_back(std::move(*request));
+                poll_indices.push_back(i);
+            } else {
+                accept_poll(i, chain->get_block_template());
+            }
+        }
+        
+        rpc_multi.perform(poll_requests, [this](std::size_t k, Result<std::string> response) {
+            const std::size_t index = poll_indices[k];
+            accept_poll(index, chains[index]->accept_template_response(std::move(response)));
+        });
+    }
+    
+    /**
+     * @brief Результат опроса chain: шаблон или ошибка для размыкателя
+     * 
+     * Разомкнувшаяся chain сразу выходит из aux дерева: commitment
+     * остаётся свежим для доступных chains.
+     */
+    void accept_poll(std::size_t index, Result<AuxBlockTemplate> result) {
+        if (result) {
+            breakers[index].record_success();
+            publish_template(index, std::move(*result));
+            return;
+        }
+        if (breakers[index].record_failure(std::chrono::steady_clock::now())) {
+            std::lock_guard<std::mutex> templates_lock(templates_mutex);
+            if (templates[index]) {
+                templates[index].reset();
+                refresh_commitment();
             }
         }
     }
     
-    std::optional<AuxCommitment> get_aux_commitment() const {
+    /**
+     * @brief Сообщить о новом снимке commitments (без мьютексов ChainManager)
+     * 
+     * Несколько шаблонов одного опроса дают один вызов callback.
+     */
+    void notify_commitment() {
+        {
+            std::lock_guard<std::mutex> lock(templates_mutex);
+            if (!commitment_changed) {
+                return;
+            }
+            commitment_changed = false;
+        }
+        if (commitment_callback) {
+            commitment_callback(commitment_snapshot.load(std::memory_order_acquire));
+        }
+    }
+    
+    /**
+     * @brief Сохранить шаблон и сразу обновить aux commitment
+     */
+    void publish_template(std::size_t index, AuxBlockTemplate block_template) {
+        poll_schedule.observe_height(index, block_template.height, block_template.created_at);
+        
         std::lock_guard<std::mutex> templates_lock(templates_mutex);
-        std::lock_guard<std::mutex> chains_lock(chains_mutex);
         
-        std::vector<Hash256> aux_hashes;
-        std::vector<Hash256> chain_ids;
+        const bool changed = !templates[index] || templates[index]->from_cache ||
+                             templates[index]->block_hash != block_template.block_hash ||
+                             templates[index]->target_bits != block_template.target_bits;
+        if (changed && template_cache.is_open()) {
+            (void)template_cache.store(chains[index]->name(), block_template);
+        }
+        templates[index] = std::move(block_template);
+        if (changed) {
+            refresh_commitment();
+        }
+    }
+    
+    /**
+     * @brief Пересчитать commitment по текущим шаблонам (под templates_mutex)
+     * 
+     * Изменившиеся commitments публикуются новым снимком.
+     */
+    void refresh_commitment() const {
+        rebuild_commitment();
+        const bool from_cache = std::ranges::any_of(members_scratch, [this](std::size_t index) {
+            return templates[index]->from_cache;
+        });
+        
+        const auto current = commitment_snapshot.load(std::memory_order_relaxed);
+        if (current->aux_commitment == commitment &&
+            current->coinbase_commitments == coinbase_commitments &&
+            current->from_cache == from_cache) {
+            return;
+        }
+        auto next = std::make_shared<AuxCommitmentSnapshot>();
+        next->aux_commitment = commitment;
+        next->coinbase_commitments = coinbase_commitments;
+        next->sequence = current->sequence + 1;
+        next->from_cache = from_cache;
+        commitment_snapshot.store(std::move(next), std::memory_order_release);
+        commitment_changed = true;
+    }
+    
+    /**
+     * @brief Пересобрать commitment, дерево и снимок отбора (под templates_mutex)
+     */
+    void rebuild_commitment() const {
+        members_scratch.clear();
+        for (std::size_t i = 0; i < chains.size(); ++i) {
+            if (chains[i]->is_enabled() && templates[i]) {
+                members_scratch.push_back(i);
+            }
+        }
+        publish_match_snapshot();
         
-        for (const auto& chain : chains) {
-            if (!chain->is_enabled()) {
-                continue;
+        // Chains со своим commitment не занимают слот aux дерева
+        coinbase_commitments.clear();
+        tree_scratch.clear();
+        for (auto index : members_scratch) {
+            if (auto own = chains[index]->coinbase_commitment(*templates[index])) {
+                coinbase_commitments.push_back(std::move(*own));
+            } else {
+                tree_scratch.push_back(index);
             }
-            
-            auto it = templates.find(std::string(chain->name()));
-            if (it != templates.end()) {
-                aux_hashes.push_back(it->second.block_hash);
-                chain_ids.push_back(chain->chain_id());
+        }
+        
+        if (tree_scratch.empty()) {
+            layout_members.clear();
+            commitment.reset();
+            return;
+        }
+        
+        if (tree_scratch != layout_members) {
+            std::vector<Hash256> chain_ids;
+            chain_ids.reserve(tree_scratch.size());
+            for (auto index : tree_scratch) {
+                chain_ids.push_back(chains[index]->chain_id());
             }
+            tree_layout = solve_aux_tree_layout(chain_ids);
+            layout_members.swap(tree_scratch);
+        }
+        
+        // Слоты как в create_aux_commitment
+        AuxCommitment next;
+        next.tree_size = tree_layout.tree_size;
+        next.merkle_nonce = tree_layout.merkle_nonce;
+        
+        if (aux_tree.capacity() != next.tree_size) {
+            aux_tree.reset(next.tree_size);
+        }
+        aux_slots.assign(next.tree_size, Hash256{});
+        for (auto index : layout_members) {
+            uint32_t slot = compute_slot_id(chains[index]->chain_id(), next.merkle_nonce,
+                                            next.tree_size);
+            aux_slots[slot] = templates[index]->block_hash;
         }
         
-        if (aux_hashes.empty()) {
-            return std::nullopt;
+        (void)aux_tree.update(aux_slots);
+        next.aux_merkle_root = aux_tree.root();
+        commitment = next;
+    }
+    
+    /**
+     * @brief Aux branch chain в дереве последнего commitment (O(log n))
+     * 
+     * Вызывается под chains_mutex и templates_mutex.
+     */
+    MerkleBranch aux_branch_locked(std::size_t index) const {
+        MerkleBranch branch;
+        if (!commitment ||
+            !std::binary_search(layout_members.begin(), layout_members.end(), index)) {
+            return branch;
         }
         
-        return create_aux_commitment(aux_hashes, chain_ids);
+        uint32_t slot = compute_slot_id(chains[index]->chain_id(), commitment->merkle_nonce,
+                                        commitment->tree_size);
+        auto tree_branch = aux_tree.get_branch(slot);
+        branch.hashes = std::move(tree_branch.hashes);
+        branch.index = tree_branch.index;
+        return branch;
     }
     
-    std::vector<std::string> check_chains(
+    /**
+     * @brief Собрать и опубликовать снимок отбора по members_scratch
+     * 
+     * Вызывается из refresh_commitment (под templates_mutex).
+     */
+    void publish_match_snapshot() const {
+        std::vector<std::pair<core::uint256, uint32_t>> entries;
+        entries.reserve(members_scratch.size());
+        for (auto index : members_scratch) {
+            entries.emplace_back(core::uint256(bits_to_target(templates[index]->target_bits)),
+                                 static_cast<uint32_t>(index));
+        }
+        std::sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) {
+            return a.first > b.first;
+        });
+        
+        auto snapshot = std::make_shared<MatchSnapshot>();
+        snapshot->targets.reserve(entries.size());
+        snapshot->chain_indices.reserve(entries.size());
+        for (const auto& [target, index] : entries) {
+            snapshot->targets.push_back(target);
+            snapshot->chain_indices.push_back(index);
+        }
+        match_snapshot.store(std::move(snapshot), std::memory_order_release);
+    }
+    
+    /**
+     * @brief Индексы chains, чей target проходит хеш родительского блока
+     * 
+     * Одно сравнение с самым лёгким target отсекает почти все shares;
+     * подходящие chains - префикс снимка, его конец ищется бинарным
+     * поиском. Индексы возвращаются по возрастанию (порядок chains).
+     */
+    std::vector<std::size_t> match_chains(
         const std::array<uint8_t, 80>& parent_header
     ) const {
-        std::vector<std::string> matching;
+        std::vector<std::size_t> matching;
         
         // Вычисляем хеш родительского блока
-        Hash256 pow_hash = crypto::sha256d(parent_header);
-        
-        std::lock_guard<std::mutex> chains_lock(chains_mutex);
-        std::lock_guard<std::mutex> templates_lock(templates_mutex);
+        const core::uint256 pow(crypto::sha256d(parent_header));
         
-        for (const auto& chain : chains) {
-            if (!chain->is_enabled()) {
-                continue;
-            }
-            
-            auto it = templates.find(std::string(chain->name()));
-            if (it == templates.end()) {
-                continue;
-            }
-            
-            if (chain->meets_target(pow_hash, it->second)) {
-                matching.push_back(std::string(chain->name()));
-            }
+        const auto snapshot = match_snapshot.load(std::memory_order_acquire);
+        const auto& targets = snapshot->targets;
+        if (targets.empty() || pow > targets.front()) {
+            return matching;
         }
         
+        auto last = std::partition_point(targets.begin(), targets.end(),
+                                         [&pow](const core::uint256& target) {
+                                             return pow <= target;
+                                         });
+        const auto count = static_cast<std::size_t>(last - targets.begin());
+        matching.assign(snapshot->chain_indices.begin(),
+                        snapshot->chain_indices.begin() + static_cast<std::ptrdiff_t>(count));
+        std::sort(matching.begin(), matching.end());
+        
         return matching;
     }
     
-    IChain* find_chain(std::string_view name) {
-        for (auto& chain : chains) {
-            if (chain->name() == name) {
-                return chain.get();
-            }
+    /**
+     * @brief Отправить блок в chain по индексу
+     * 
+     * Вызывается под chains_mutex и templates_mutex.
+     */
+    Result<void> submit_locked(std::size_t index, const AuxPow& auxpow) {
+        auto& chain = chains[index];
+        if (!templates[index]) {
+            return std::unexpected(Error{ErrorCode::MiningInvalidJob,
+                "Нет шаблона для chain: " + std::string(chain->name())});
         }
-        return nullptr;
+        const auto& tmpl = *templates[index];
+        
+        const auto started = std::chrono::steady_clock::now();
+        auto result = chain->submit_block(auxpow, tmpl);
+        
+        if (result) {
+            record_found(index, tmpl, std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - started));
+        }
+        
+        return result;
     }
     
-    const IChain* find_chain(std::string_view name) const {
-        for (const auto& chain : chains) {
-            if (chain->name() == name) {
-                return chain.get();
+    /**
+     * @brief Учесть принятый блок chain: статистика и callback
+     */
+    void record_found(std::size_t index, const AuxBlockTemplate& tmpl,
+                      std::chrono::microseconds submit_latency) {
+        const auto& chain = chains[index];
+        
+        // Обновляем статистику
+        std::lock_guard<std::mutex> stats_lock(stats_mutex);
+        block_counts[std::string(chain->name())]++;
+        
+        // Вызываем callback
+        if (block_found_callback) {
+            block_found_callback(
+                std::string(chain->name()),
+                tmpl.height,
+                tmpl.block_hash,
+                submit_latency
+            );
+        }
+    }
+    
+    std::optional<std::size_t> find_index(std::string_view name) const {
+        for (std::size_t i = 0; i < chains.size(); ++i) {
+            if (chains[i]->name() == name) {
+                return i;
             }
         }
-        return nullptr;
+        return std::nullopt;
+    }
+    
+    IChain* find_chain(std::string_view name) {
+        auto index = find_index(name);
+        return index ? chains[*index].get() : nullptr;
+    }
+    
+    const IChain* find_chain(std::string_view name) const {
+        auto index = find_index(name);
+        return index ? chains[*index].get() : nullptr;
     }
 };
 
@@ -265,6 +732,10 @@ struct ChainManager::Impl {
 ChainManager::ChainManager(const MergedMiningConfig& config)
     : impl_(std::make_unique<Impl>(config)) {}
 
+ChainManager::ChainManager(const MergedMiningConfig& config,
+                           std::vector<std::unique_ptr<IChain>> chains)
+    : impl_(std::make_unique<Impl>(config, std::move(chains))) {}
+
 ChainManager::~ChainManager() = default;
 
 void ChainManager::start() {
@@ -318,10 +789,15 @@ std::vector<ChainInfo> ChainManager::get_all_chain_info() const {
 }
 
 bool ChainManager::set_chain_enabled(std::string_view name, bool enabled) {
-    std::lock_guard<std::mutex> lock(impl_->chains_mutex);
+    std::unique_lock<std::mutex> lock(impl_->chains_mutex);
     
     if (auto* chain = impl_->find_chain(name)) {
         chain->set_enabled(enabled);
+        {
+            // Снимок отбора должен сразу видеть новый набор chains
+            std::lock_guard<std::mutex> templates_lock(impl_->templates_mutex);
+            impl_->refresh_commitment();
+        }
         
         if (enabled && !chain->is_connected()) {
             [[maybe_unused]] auto result = chain->connect();
@@ -329,6 +805,8 @@ bool ChainManager::set_chain_enabled(std::string_view name, bool enabled) {
             chain->disconnect();
         }
         
+        lock.unlock();
+        impl_->notify_commitment();
         return true;
     }
     
@@ -336,7 +814,15 @@ bool ChainManager::set_chain_enabled(std::string_view name, bool enabled) {
 }
 
 std::optional<AuxCommitment> ChainManager::get_aux_commitment() const {
-    return impl_->get_aux_commitment();
+    return impl_->commitment_snapshot.load(std::memory_order_acquire)->aux_commitment;
+}
+
+std::shared_ptr<const AuxCommitmentSnapshot> ChainManager::commitment_snapshot() const noexcept {
+    return impl_->commitment_snapshot.load(std::memory_order_acquire);
+}
+
+std::vector<CoinbaseCommitment> ChainManager::get_coinbase_commitments() const {
+    return impl_->commitment_snapshot.load(std::memory_order_acquire)->coinbase_commitments;
 }
 
 std::vector<std::pair<std::string, AuxBlockTemplate>> 
@@ -346,14 +832,9 @@ ChainManager::get_active_templates() const {
     
     std::vector<std::pair<std::string, AuxBlockTemplate>> result;
     
-    for (const auto& chain : impl_->chains) {
-        if (!chain->is_enabled()) {
-            continue;
-        }
-        
-        auto it = impl_->templates.find(std::string(chain->name()));
-        if (it != impl_->templates.end()) {
-            result.emplace_back(std::string(chain->name()), it->second);
+    for (std::size_t i = 0; i < impl_->chains.size(); ++i) {
+        if (impl_->chains[i]->is_enabled() && impl_->templates[i]) {
+            result.emplace_back(std::string(impl_->chains[i]->name()), *impl_->templates[i]);
         }
     }
     
@@ -365,7 +846,14 @@ std::vector<std::string> ChainManager::check_aux_chains(
     [[maybe_unused]] const Bytes& coinbase_tx,
     [[maybe_unused]] const MerkleBranch& coinbase_branch
 ) const {
-    return impl_->check_chains(parent_header);
+    auto matching = impl_->match_chains(parent_header);
+    
+    std::vector<std::string> names;
+    names.reserve(matching.size());
+    for (auto index : matching) {
+        names.emplace_back(impl_->chains[index]->name());
+    }
+    return names;
 }
 
 Result<void> ChainManager::submit_aux_block(
@@ -375,36 +863,13 @@ Result<void> ChainManager::submit_aux_block(
     std::lock_guard<std::mutex> chains_lock(impl_->chains_mutex);
     std::lock_guard<std::mutex> templates_lock(impl_->templates_mutex);
     
-    auto* chain = impl_->find_chain(chain_name);
-    if (!chain) {
+    auto index = impl_->find_index(chain_name);
+    if (!index) {
         return std::unexpected(Error{ErrorCode::MiningInvalidJob, 
             "Chain не найден: " + std::string(chain_name)});
     }
     
-    auto it = impl_->templates.find(std::string(chain_name));
-    if (it == impl_->templates.end()) {
-        return std::unexpected(Error{ErrorCode::MiningInvalidJob,
-            "Нет шаблона для chain: " + std::string(chain_name)});
-    }
-    
-    auto result = chain->submit_block(auxpow, it->second);
-    
-    if (result) {
-        // Обновляем статистику
-        std::lock_guard<std::mutex> stats_lock(impl_->stats_mutex);
-        impl_->block_counts[std::string(chain_name)]++;
-        
-        // Вызываем callback
-        if (impl_->block_found_callback) {
-            impl_->block_found_callback(
-                std::string(chain_name),
-                it->second.height,
-                it->second.block_hash
-            );
-        }
-    }
-    
-    return result;
+    return impl_->submit_locked(*index, auxpow);
 }
 
 std::vector<std::pair<std::string, bool>> ChainManager::submit_to_matching_chains(
@@ -412,40 +877,143 @@ std::vector<std::pair<std::string, bool>> ChainManager::submit_to_matching_chain
     const Bytes& coinbase_tx,
     const MerkleBranch& coinbase_branch
 ) {
-    auto matching = check_aux_chains(parent_header, coinbase_tx, coinbase_branch);
+    AuxPowHexBuilder auxpow(coinbase_tx, coinbase_branch);
+    auxpow.set_parent_header(parent_header);
+    return submit_to_matching_chains(auxpow);
+}
+
+std::vector<std::pair<std::string, bool>> ChainManager::submit_to_matching_chains(
+    const AuxPowHexBuilder& auxpow_hex
+) {
+    auto matching = impl_->match_chains(auxpow_hex.common().parent_header);
     
     std::vector<std::pair<std::string, bool>> results;
     results.reserve(matching.size());
+    if (matching.empty()) {
+        return results;
+    }
     
-    for (const auto& name : matching) {
-        // Создаём AuxPoW
-        AuxPow auxpow;
-        auxpow.coinbase_tx = coinbase_tx;
-        auxpow.coinbase_hash = crypto::sha256d(coinbase_tx);
-        auxpow.coinbase_branch = coinbase_branch;
-        std::copy(parent_header.begin(), parent_header.end(), 
-                  auxpow.parent_header.begin());
-        
-        // Получаем aux_branch для этой chain
+    // AuxPoW chains различаются только aux branch: общие части уже в hex.
+    // Запросы всех chains уходят одним AuxRpcMulti: отправка в одну chain
+    // не ждёт ответа другой.
+    std::vector<AuxRpcRequest> requests;
+    std::vector<std::size_t> request_slots;
+    std::vector<AuxBlockTemplate> request_templates;
+    
+    std::lock_guard<std::mutex> chains_lock(impl_->chains_mutex);
+    {
         std::lock_guard<std::mutex> templates_lock(impl_->templates_mutex);
-        auto it = impl_->templates.find(name);
-        if (it != impl_->templates.end()) {
-            // Упрощённо: aux_branch будет пустой для single chain
-            // В реальности нужно вычислять branch из aux merkle tree
-            auxpow.aux_branch = MerkleBranch{};
-        }
         
-        auto result = submit_aux_block(name, auxpow);
-        results.emplace_back(name, result.has_value());
+        for (auto index : matching) {
+            auto& chain = impl_->chains[index];
+            results.emplace_back(std::string(chain->name()), false);
+            if (!impl_->templates[index]) {
+                continue;
+            }
+            
+            // Branch слота chain в дереве commitment
+            auto aux_branch = impl_->aux_branch_locked(index);
+            
+            const auto& tmpl = *impl_->templates[index];
+            if (auto request = chain->submit_request(auxpow_hex.build(aux_branch), tmpl)) {
+                requests.push_back(std::move(*request));
+                request_slots.push_back(results.size() - 1);
+                request_templates.push_back(tmpl);
+            } else {
+                AuxPow auxpow = auxpow_hex.common();
+                auxpow.aux_branch = std::move(aux_branch);
+                results.back().second = impl_->submit_locked(index, auxpow).has_value();
+            }
+        }
     }
     
+    const auto started = std::chrono::steady_clock::now();
+    impl_->submit_multi.perform(requests, [&](std::size_t k, Result<std::string> response) {
+        const auto latency = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - started);
+        const std::size_t index = matching[request_slots[k]];
+        if (impl_->chains[index]->accept_submit_response(std::move(response))) {
+            results[request_slots[k]].second = true;
+            impl_->record_found(index, request_templates[k], latency);
+        }
+    });
+    
     return results;
 }
 
+std::vector<AuxSubmission> ChainManager::prepare_submissions(
+    const AuxPowHexBuilder& auxpow_hex
+) const {
+    auto matching = impl_->match_chains(auxpow_hex.common().parent_header);
+    
+    std::vector<AuxSubmission> submissions;
+    submissions.reserve(matching.size());
+    
+    std::lock_guard<std::mutex> chains_lock(impl_->chains_mutex);
+    std::lock_guard<std::mutex> templates_lock(impl_->templates_mutex);
+    for (auto index : matching) {
+        if (!impl_->templates[index]) {
+            continue;
+        }
+        AuxSubmission submission;
+        submission.chain_name = std::string(impl_->chains[index]->name());
+        submission.auxpow = auxpow_hex.common();
+        submission.auxpow.aux_branch = impl_->aux_branch_locked(index);
+        submission.block_template = *impl_->templates[index];
+        submissions.push_back(std::move(submission));
+    }
+    return submissions;
+}
+
+Result<void> ChainManager::submit_prepared(const AuxSubmission& submission) {
+    std::size_t index = 0;
+    {
+        std::lock_guard<std::mutex> chains_lock(impl_->chains_mutex);
+        std::lock_guard<std::mutex> templates_lock(impl_->templates_mutex);
+        
+        auto found = impl_->find_index(submission.chain_name);
+        if (!found) {
+            return std::unexpected(Error{ErrorCode::MiningInvalidJob,
+                "Chain не найден: " + submission.chain_name});
+        }
+        index = *found;
+        const auto& current = impl_->templates[index];
+        if (!impl_->chains[index]->is_enabled() || !current ||
+            current->block_hash != submission.block_template.block_hash) {
+            return std::unexpected(Error{ErrorCode::MiningStaleJob,
+                "Шаблон " + submission.chain_name + " сменился"});
+        }
+    }
+    
+    // Набор chains не меняется после создания ChainManager, chain
+    // сериализует RPC своим мьютексом
+    const auto started = std::chrono::steady_clock::now();
+    auto result = impl_->chains[index]->submit_block(submission.auxpow, submission.block_template);
+    if (result) {
+        impl_->record_found(index, submission.block_template,
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - started));
+    }
+    return result;
+}
+
+std::optional<BreakerState> ChainManager::breaker_state(std::string_view name) const {
+    std::lock_guard<std::mutex> lock(impl_->chains_mutex);
+    auto index = impl_->find_index(name);
+    if (!index) {
+        return std::nullopt;
+    }
+    return impl_->breakers[*index].state();
+}
+
 void ChainManager::set_block_found_callback(AuxBlockFoundCallback callback) {
     impl_->block_found_callback = std::move(callback);
 }
 
+void ChainManager::set_commitment_callback(AuxCommitmentCallback callback) {
+    impl_->commitment_callback = std::move(callback);
+}
+
 std::size_t ChainManager::active_chain_count() const noexcept {
     std::lock_guard<std::mutex> lock(impl_->chains_mutex);
     
@@ -13,6 +13,7 @@
 
 #include "chain_interface.hpp"
 #include "auxpow.hpp"
+#include "circuit_breaker.hpp"
 
 #include <memory>
 #include <vector>
@@ -63,8 +64,23 @@ struct ChainConfig {
     /// @brief Таймаут RPC запросов (секунды)
     uint32_t rpc_timeout{30};
     
-    /// @brief Интервал обновления шаблона (секунды)
+    /// @brief Интервал обновления шаблона до оценки времени блока (секунды);
+    /// дальше интервал подбирает PollScheduler
     uint32_t update_interval{5};
+    
+    /// @brief Крайний срок ответа createauxblock при опросе (мс)
+    uint32_t template_deadline_ms{2000};
+    
+    /// @brief Ошибок опроса подряд до размыкания: chain не опрашивается и
+    /// выходит из aux дерева (0 - не размыкать)
+    uint32_t breaker_failures{3};
+    
+    /// @brief Пауза до пробного опроса разомкнутой chain (секунды)
+    uint32_t breaker_open_seconds{30};
+    
+    /// @brief Обновлять шаблон по уведомлению ноды (getblocktemplate
+    /// longpoll) вместо периодического опроса
+    bool longpoll{false};
 };
 
 /**
@@ -79,6 +95,13 @@ struct MergedMiningConfig {
     
     /// @brief Интервал проверки состояния chains (секунды)
     uint32_t health_check_interval{60};
+    
+    /// @brief Файл кеша последних aux шаблонов для быстрого старта
+    /// (пусто - без кеша)
+    std::string template_cache_path;
+    
+    /// @brief Шаблоны кеша старше - не используются (секунды)
+    uint32_t template_cache_max_age{600};
 };
 
 // =============================================================================
@@ -87,13 +110,63 @@ struct MergedMiningConfig {
 
 /**
  * @brief Callback при нахождении блока auxiliary chain
+ * 
+ * submit_latency - от начала отправки до ответа ноды этой chain (при
+ * отправке сразу в несколько chains - у каждой своё).
  */
 using AuxBlockFoundCallback = std::function<void(
     const std::string& chain_name,
     uint32_t height,
-    const Hash256& block_hash
+    const Hash256& block_hash,
+    std::chrono::microseconds submit_latency
 )>;
 
+/**
+ * @brief Неизменяемый снимок commitments для coinbase
+ * 
+ * Публикуется aux worker'ом целиком при каждом изменении; сборщики
+ * заданий читают его без блокировок.
+ */
+struct AuxCommitmentSnapshot {
+    /// @brief AuxPoW commitment (nullopt - нет chains в aux дереве)
+    std::optional<AuxCommitment> aux_commitment;
+    
+    /// @brief Собственные commitments chains вне aux дерева (RSK, Hathor)
+    std::vector<CoinbaseCommitment> coinbase_commitments;
+    
+    /// @brief Номер снимка, растёт с каждой публикацией
+    uint64_t sequence{0};
+    
+    /// @brief Есть шаблоны из кеша прошлого запуска: commitment может
+    /// указывать на устаревшие блоки, пока chains не ответят
+    bool from_cache{false};
+};
+
+/**
+ * @brief Callback при смене commitments (новый aux шаблон, включение chain)
+ * 
+ * Вызывается из потока aux worker без мьютексов ChainManager: задания
+ * пересобираются одним пакетом, а не при каждом чтении commitment.
+ */
+using AuxCommitmentCallback = std::function<void(std::shared_ptr<const AuxCommitmentSnapshot>)>;
+
+/**
+ * @brief Находка, подготовленная к отправке в одну chain
+ * 
+ * AuxPoW с aux branch и шаблон chain на момент находки: повтор отправки
+ * не зависит от последующих смен aux дерева.
+ */
+struct AuxSubmission {
+    /// @brief Название chain
+    std::string chain_name;
+    
+    /// @brief AuxPoW с aux branch слота chain
+    AuxPow auxpow;
+    
+    /// @brief Шаблон chain, под который найден блок
+    AuxBlockTemplate block_template;
+};
+
 // =============================================================================
 // Chain Manager
 // =============================================================================
@@ -115,6 +188,18 @@ public:
      */
     explicit ChainManager(const MergedMiningConfig& config);
     
+    /**
+     * @brief Создать менеджер с готовыми chains (бенчмарки, тесты)
+     * 
+     * config.chains не используется: chains опрашиваются без longpoll,
+     * до первой оценки времени блока - с интервалом update_interval
+     * по умолчанию.
+     * 
+     * @param config Конфигурация merged mining
+     * @param chains Chains в порядке приоритета конфигурации
+     */
+    ChainManager(const MergedMiningConfig& config, std::vector<std::unique_ptr<IChain>> chains);
+    
     ~ChainManager();
     
     // Запрещаем копирование
@@ -171,6 +256,13 @@ public:
      */
     bool set_chain_enabled(std::string_view name, bool enabled);
     
+    /**
+     * @brief Состояние размыкателя опроса chain
+     * 
+     * @return nullopt - chain не найдена
+     */
+    [[nodiscard]] std::optional<BreakerState> breaker_state(std::string_view name) const;
+    
     // =========================================================================
     // AuxPoW Commitment
     // =========================================================================
@@ -178,12 +270,31 @@ public:
     /**
      * @brief Получить текущий AuxPoW commitment для coinbase
      * 
-     * Создаёт commitment, включающий все активные auxiliary chains.
+     * Commitment, включающий все активные auxiliary chains. Без блокировок:
+     * копия из commitment_snapshot().
      * 
      * @return std::optional<AuxCommitment> Commitment или nullopt если нет активных chains
      */
     [[nodiscard]] std::optional<AuxCommitment> get_aux_commitment() const;
     
+    /**
+     * @brief Собственные commitments chains вне aux дерева (RSK, Hathor)
+     * 
+     * @return std::vector<CoinbaseCommitment> Commitments активных chains
+     *         в порядке конфигурации
+     */
+    [[nodiscard]] std::vector<CoinbaseCommitment> get_coinbase_commitments() const;
+    
+    /**
+     * @brief Текущий снимок commitments (без блокировок и копирования)
+     * 
+     * Снимок неизменяем и заменяется атомарно: aux commitment и
+     * commitments вне дерева всегда из одного пересчёта.
+     * 
+     * @return std::shared_ptr<const AuxCommitmentSnapshot> Никогда не nullptr
+     */
+    [[nodiscard]] std::shared_ptr<const AuxCommitmentSnapshot> commitment_snapshot() const noexcept;
+    
     /**
      * @brief Получить текущие шаблоны всех активных chains
      * 
@@ -239,6 +350,44 @@ public:
         const MerkleBranch& coinbase_branch
     );
     
+    /**
+     * @brief Отправить блок во все подходящие chains (общая часть AuxPoW готова)
+     * 
+     * Для нескольких находок одного задания: coinbase и coinbase branch
+     * закодированы в builder заранее, к ним дописываются aux branch chain.
+     * 
+     * @param auxpow Общая часть AuxPoW с parent header находки
+     * @return std::vector<std::pair<std::string, bool>> Результаты (chain_name, success)
+     */
+    [[nodiscard]] std::vector<std::pair<std::string, bool>> submit_to_matching_chains(
+        const AuxPowHexBuilder& auxpow
+    );
+    
+    /**
+     * @brief Подготовить находку к отправке во все подходящие chains
+     * 
+     * Отбор chains и aux branches - как в submit_to_matching_chains(),
+     * но без RPC: отправляет submit_prepared(), в том числе повторно.
+     * 
+     * @param auxpow Общая часть AuxPoW с parent header находки
+     * @return Отправки по одной на подходящую chain с шаблоном
+     */
+    [[nodiscard]] std::vector<AuxSubmission> prepare_submissions(
+        const AuxPowHexBuilder& auxpow
+    ) const;
+    
+    /**
+     * @brief Отправить подготовленную находку
+     * 
+     * Мьютексы ChainManager не удерживаются во время RPC: отправки в
+     * разные chains идут параллельно из разных потоков.
+     * 
+     * @param submission Отправка prepare_submissions()
+     * @return Успех; ErrorCode::MiningStaleJob - шаблон chain сменился или
+     *         chain выключена (находка устарела), иначе ошибка отправки
+     */
+    [[nodiscard]] Result<void> submit_prepared(const AuxSubmission& submission);
+    
     // =========================================================================
     // Callbacks
     // =========================================================================
@@ -248,6 +397,13 @@ public:
      */
     void set_block_found_callback(AuxBlockFoundCallback callback);
     
+    /**
+     * @brief Установить callback смены commitments
+     * 
+     * Устанавливается до start().
+     */
+    void set_commitment_callback(AuxCommitmentCallback callback);
+    
     // =========================================================================
     // Статистика
     // =========================================================================
@@ -4,11 +4,31 @@
  */
 
 #include "base_chain.hpp"
+#include "../../core/byte_order.hpp"
+#include "../../core/clock.hpp"
+#include "../../core/serialization/json.hpp"
 
 #include <algorithm>
+#include <charconv>
 
 namespace quaxis::merged {
 
+namespace {
+
+/**
+ * @brief 64 hex символа в Hash256 в обратном порядке байт
+ * 
+ * Строка другой длины или с не-hex символом оставляет out без изменений.
+ */
+void parse_reversed_hex(std::string_view hex, Hash256& out) {
+    Hash256 parsed{};
+    if (hex.size() == 64 && hex_decode_reversed(hex, parsed.data())) {
+        out = parsed;
+    }
+}
+
+} // anonymous namespace
+
 // =============================================================================
 // BaseChain Implementation
 // =============================================================================
@@ -151,6 +171,29 @@ Result<AuxBlockTemplate> BaseChain::get_block_template() {
     return parse_aux_block_response(*result);
 }
 
+std::optional<AuxRpcRequest> BaseChain::template_request() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    if (!rpc_client_) {
+        return std::nullopt;
+    }
+    
+    AuxRpcRequest request;
+    request.client = rpc_client_.get();
+    request.method = get_create_aux_block_method();
+    request.deadline = std::chrono::milliseconds(config_.template_deadline_ms);
+    return request;
+}
+
+Result<AuxBlockTemplate> BaseChain::accept_template_response(
+    Result<std::string> response
+) {
+    if (!response) {
+        return std::unexpected(response.error());
+    }
+    return parse_aux_block_response(*response);
+}
+
 Result<void> BaseChain::submit_block(
     const AuxPow& auxpow,
     const AuxBlockTemplate& block_template
@@ -162,45 +205,58 @@ Result<void> BaseChain::submit_block(
             "Нет подключения к " + name_cache_});
     }
     
-    // Сериализуем AuxPoW
-    auto auxpow_data = auxpow.serialize();
-    
-    // Преобразуем в hex
-    std::string auxpow_hex;
-    auxpow_hex.reserve(auxpow_data.size() * 2);
-    static constexpr char hex_chars[] = "0123456789abcdef";
-    for (uint8_t byte : auxpow_data) {
-        auxpow_hex.push_back(hex_chars[byte >> 4]);
-        auxpow_hex.push_back(hex_chars[byte & 0x0F]);
-    }
-    
-    // Преобразуем block_hash в hex
-    std::string hash_hex;
-    hash_hex.reserve(64);
-    for (int i = 31; i >= 0; --i) {
-        hash_hex.push_back(hex_chars[block_template.block_hash[static_cast<std::size_t>(i)] >> 4]);
-        hash_hex.push_back(hex_chars[block_template.block_hash[static_cast<std::size_t>(i)] & 0x0F]);
-    }
-    
     // Вызываем submitauxblock RPC
-    auto method = get_submit_aux_block_method();
-    std::string params = "[\"" + hash_hex + "\", \"" + auxpow_hex + "\"]";
-    
-    auto result = rpc_client_->call(method, params);
+    auto auxpow_hex = AuxPowHexBuilder(auxpow).build(auxpow.aux_branch);
+    auto result = rpc_client_->call(get_submit_aux_block_method(),
+                                    submit_params(auxpow_hex, block_template));
+    return accept_submit_response(std::move(result));
+}
+
+std::optional<AuxRpcRequest> BaseChain::submit_request(
+    std::string_view auxpow_hex,
+    const AuxBlockTemplate& block_template
+) {
+    std::lock_guard<std::mutex> lock(mutex_);
     
-    if (!result) {
-        return std::unexpected(result.error());
+    if (!rpc_client_) {
+        return std::nullopt;
     }
     
-    // Обновляем статистику
-    {
-        std::lock_guard<std::mutex> info_lock(info_mutex_);
-        info_.last_update = std::chrono::steady_clock::now();
+    AuxRpcRequest request;
+    request.client = rpc_client_.get();
+    request.method = get_submit_aux_block_method();
+    request.params = submit_params(auxpow_hex, block_template);
+    request.deadline = std::chrono::seconds(config_.rpc_timeout);
+    return request;
+}
+
+Result<void> BaseChain::accept_submit_response(Result<std::string> response) {
+    if (!response) {
+        return std::unexpected(response.error());
     }
     
+    // Обновляем статистику
+    std::lock_guard<std::mutex> info_lock(info_mutex_);
+    info_.last_update = std::chrono::steady_clock::now();
     return {};
 }
 
+std::string BaseChain::submit_params(
+    std::string_view auxpow_hex,
+    const AuxBlockTemplate& block_template
+) {
+    // ["<block_hash, обратный порядок>", "<auxpow hex>"]
+    std::string params;
+    params.reserve(auxpow_hex.size() + 64 + 8);
+    params.append("[\"");
+    params.resize(params.size() + 64);
+    hex_encode_reversed(block_template.block_hash, params.data() + 2);
+    params.append("\", \"");
+    params.append(auxpow_hex);
+    params.append("\"]");
+    return params;
+}
+
 bool BaseChain::meets_target(
     const Hash256& pow_hash,
     const AuxBlockTemplate& current_template
@@ -239,85 +295,35 @@ std::string BaseChain::get_submit_aux_block_method() const {
 Result<AuxBlockTemplate> BaseChain::parse_aux_block_response(
     const std::string& response
 ) const {
-    // Базовый парсинг JSON ответа
-    // Формат: {"result": {"hash": "...", "chainid": "...", "target": "..."}, ...}
+    // Формат: {"result": {"hash": "...", "chainid": "...", "bits": "...", "height": N}, ...}
+    auto result = core::json::Value::parse(response)["result"];
+    if (result.type() != core::json::Type::Object) {
+        return std::unexpected(Error{ErrorCode::RpcParseError,
+            "Нет result в ответе " + get_create_aux_block_method()});
+    }
     
     AuxBlockTemplate tmpl;
-    tmpl.created_at = std::chrono::steady_clock::now();
+    tmpl.created_at = core::CoarseClock::now();
     
-    // Ищем hash
-    auto hash_pos = response.find("\"hash\"");
-    if (hash_pos != std::string::npos) {
-        auto start = response.find('\"', hash_pos + 6) + 1;
-        auto end = response.find('\"', start);
-        if (start != std::string::npos && end != std::string::npos) {
-            std::string hash_hex = response.substr(start, end - start);
-            
-            // Парсим hex в Hash256 (reverse order for Bitcoin)
-            if (hash_hex.size() == 64) {
-                for (std::size_t i = 0; i < 32; ++i) {
-                    std::size_t hex_idx = (31 - i) * 2;
-                    uint8_t high = (hash_hex[hex_idx] >= 'a') 
-                        ? static_cast<uint8_t>(hash_hex[hex_idx] - 'a' + 10)
-                        : static_cast<uint8_t>(hash_hex[hex_idx] - '0');
-                    uint8_t low = (hash_hex[hex_idx + 1] >= 'a')
-                        ? static_cast<uint8_t>(hash_hex[hex_idx + 1] - 'a' + 10)
-                        : static_cast<uint8_t>(hash_hex[hex_idx + 1] - '0');
-                    tmpl.block_hash[i] = static_cast<uint8_t>((high << 4) | low);
-                }
-            }
-        }
+    // hash и chainid - hex, обратный порядок байт (Bitcoin)
+    if (auto hash_hex = result["hash"].as_string()) {
+        parse_reversed_hex(*hash_hex, tmpl.block_hash);
     }
-    
-    // Ищем chainid
-    auto chainid_pos = response.find("\"chainid\"");
-    if (chainid_pos != std::string::npos) {
-        auto start = response.find('\"', chainid_pos + 9) + 1;
-        auto end = response.find('\"', start);
-        if (start != std::string::npos && end != std::string::npos) {
-            std::string chainid_hex = response.substr(start, end - start);
-            
-            // Парсим hex в chain_id
-            if (chainid_hex.size() == 64) {
-                for (std::size_t i = 0; i < 32; ++i) {
-                    std::size_t hex_idx = (31 - i) * 2;
-                    uint8_t high = (chainid_hex[hex_idx] >= 'a')
-                        ? static_cast<uint8_t>(chainid_hex[hex_idx] - 'a' + 10)
-                        : static_cast<uint8_t>(chainid_hex[hex_idx] - '0');
-                    uint8_t low = (chainid_hex[hex_idx + 1] >= 'a')
-                        ? static_cast<uint8_t>(chainid_hex[hex_idx + 1] - 'a' + 10)
-                        : static_cast<uint8_t>(chainid_hex[hex_idx + 1] - '0');
-                    tmpl.chain_id[i] = static_cast<uint8_t>((high << 4) | low);
-                }
-            }
-        }
+    if (auto chainid_hex = result["chainid"].as_string()) {
+        parse_reversed_hex(*chainid_hex, tmpl.chain_id);
     }
     
-    // Ищем target (bits)
-    auto target_pos = response.find("\"bits\"");
-    if (target_pos != std::string::npos) {
-        auto start = response.find('\"', target_pos + 6) + 1;
-        auto end = response.find('\"', start);
-        if (start != std::string::npos && end != std::string::npos) {
-            std::string bits_hex = response.substr(start, end - start);
-            tmpl.target_bits = static_cast<uint32_t>(std::stoul(bits_hex, nullptr, 16));
+    // target (bits)
+    if (auto bits_hex = result["bits"].as_string()) {
+        uint32_t bits = 0;
+        const char* end = bits_hex->data() + bits_hex->size();
+        if (std::from_chars(bits_hex->data(), end, bits, 16).ptr == end) {
+            tmpl.target_bits = bits;
         }
     }
     
-    // Ищем height
-    auto height_pos = response.find("\"height\"");
-    if (height_pos != std::string::npos) {
-        auto start = response.find(':', height_pos) + 1;
-        // Пропускаем пробелы
-        while (start < response.size() && 
-               (response[start] == ' ' || response[start] == '\t')) {
-            ++start;
-        }
-        auto end = response.find_first_of(",}", start);
-        if (end != std::string::npos) {
-            std::string height_str = response.substr(start, end - start);
-            tmpl.height = static_cast<uint32_t>(std::stoul(height_str));
-        }
+    if (auto height = result["height"].as_uint64()) {
+        tmpl.height = static_cast<uint32_t>(*height);
     }
     
     return tmpl;
@@ -61,10 +61,21 @@ public:
     // =========================================================================
     
     [[nodiscard]] Result<AuxBlockTemplate> get_block_template() override;
+    [[nodiscard]] std::optional<AuxRpcRequest> template_request() override;
+    [[nodiscard]] Result<AuxBlockTemplate> accept_template_response(
+        Result<std::string> response
+    ) override;
     [[nodiscard]] Result<void> submit_block(
         const AuxPow& auxpow,
         const AuxBlockTemplate& block_template
     ) override;
+    [[nodiscard]] std::optional<AuxRpcRequest> submit_request(
+        std::string_view auxpow_hex,
+        const AuxBlockTemplate& block_template
+    ) override;
+    [[nodiscard]] Result<void> accept_submit_response(
+        Result<std::string> response
+    ) override;
     [[nodiscard]] bool meets_target(
         const Hash256& pow_hash,
         const AuxBlockTemplate& current_template
@@ -118,6 +129,14 @@ protected:
         const std::string& response
     ) const;
     
+    /**
+     * @brief JSON параметры submitauxblock: [hash, auxpow hex]
+     */
+    [[nodiscard]] static std::string submit_params(
+        std::string_view auxpow_hex,
+        const AuxBlockTemplate& block_template
+    );
+    
     // Конфигурация
     ChainConfig config_;
     
@@ -30,6 +30,20 @@ Hash256 HathorChain::get_chain_id() const {
     return id;
 }
 
+std::optional<CoinbaseCommitment> HathorChain::coinbase_commitment(
+    const AuxBlockTemplate& block_template
+) const {
+    // OP_RETURN PUSH(36) "Hath" hash (порядок байт - как в ответе ноды)
+    CoinbaseCommitment commitment;
+    commitment.script.reserve(2 + HATHOR_MAGIC.size() + 32);
+    commitment.script.push_back(0x6a);
+    commitment.script.push_back(static_cast<uint8_t>(HATHOR_MAGIC.size() + 32));
+    commitment.script.insert(commitment.script.end(), HATHOR_MAGIC.begin(), HATHOR_MAGIC.end());
+    commitment.script.insert(commitment.script.end(), block_template.block_hash.rbegin(),
+                             block_template.block_hash.rend());
+    return commitment;
+}
+
 std::string HathorChain::get_create_aux_block_method() const {
     // Hathor использует REST API, но мы адаптируем его через RPC клиент
     return "mining/block-template";
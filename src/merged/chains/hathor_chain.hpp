@@ -12,13 +12,23 @@
 
 namespace quaxis::merged {
 
+/// @brief Магия тега Hathor в scriptsig coinbase
+inline constexpr std::array<uint8_t, 4> HATHOR_MAGIC = {'H', 'a', 't', 'h'};
+
 /**
  * @brief Реализация Hathor chain
+ * 
+ * Hathor не использует aux дерево: хеш блока после магии "Hath"
+ * записывается в OP_RETURN выход coinbase.
  */
 class HathorChain : public BaseChain {
 public:
     explicit HathorChain(const ChainConfig& config);
     
+    [[nodiscard]] std::optional<CoinbaseCommitment> coinbase_commitment(
+        const AuxBlockTemplate& block_template
+    ) const override;
+    
 protected:
     [[nodiscard]] std::string get_chain_name() const override;
     [[nodiscard]] std::string get_chain_ticker() const override;
@@ -30,6 +30,20 @@ Hash256 RSKChain::get_chain_id() const {
     return id;
 }
 
+std::optional<CoinbaseCommitment> RSKChain::coinbase_commitment(
+    const AuxBlockTemplate& block_template
+) const {
+    // OP_RETURN PUSH(41) "RSKBLOCK:" hash (порядок байт - как в RPC ответе)
+    CoinbaseCommitment commitment;
+    commitment.script.reserve(2 + RSK_TAG_PREFIX.size() + 32);
+    commitment.script.push_back(0x6a);
+    commitment.script.push_back(static_cast<uint8_t>(RSK_TAG_PREFIX.size() + 32));
+    commitment.script.insert(commitment.script.end(), RSK_TAG_PREFIX.begin(), RSK_TAG_PREFIX.end());
+    commitment.script.insert(commitment.script.end(), block_template.block_hash.rbegin(),
+                             block_template.block_hash.rend());
+    return commitment;
+}
+
 std::string RSKChain::get_create_aux_block_method() const {
     return "mnr_getWork";
 }
@@ -12,13 +12,23 @@
 
 namespace quaxis::merged {
 
+/// @brief Префикс тега RSK в OP_RETURN выходе coinbase
+inline constexpr std::string_view RSK_TAG_PREFIX = "RSKBLOCK:";
+
 /**
  * @brief Реализация RSK chain
+ * 
+ * RSK не использует aux дерево: хеш блока для merged mining
+ * записывается в OP_RETURN выход coinbase ("RSKBLOCK:" || hash).
  */
 class RSKChain : public BaseChain {
 public:
     explicit RSKChain(const ChainConfig& config);
     
+    [[nodiscard]] std::optional<CoinbaseCommitment> coinbase_commitment(
+        const AuxBlockTemplate& block_template
+    ) const override;
+    
 protected:
     [[nodiscard]] std::string get_chain_name() const override;
     [[nodiscard]] std::string get_chain_ticker() const override;
@@ -0,0 +1,57 @@
+/**
+ * @file circuit_breaker.cpp
+ * @brief Реализация размыкателя опроса aux chain
+ */
+
+#include "circuit_breaker.hpp"
+
+#include <algorithm>
+
+namespace quaxis::merged {
+
+bool CircuitBreaker::allow(Clock::time_point now) noexcept {
+    switch (state_) {
+        case BreakerState::Closed:
+            return true;
+        case BreakerState::Open:
+            if (now < retry_at_) {
+                return false;
+            }
+            state_ = BreakerState::HalfOpen;
+            return true;
+        case BreakerState::HalfOpen:
+            // Пробный опрос уже ушёл
+            return false;
+    }
+    return false;
+}
+
+bool CircuitBreaker::record_success() noexcept {
+    const bool recovered = state_ != BreakerState::Closed;
+    state_ = BreakerState::Closed;
+    failures_ = 0;
+    current_interval_ = open_interval_;
+    return recovered;
+}
+
+bool CircuitBreaker::record_failure(Clock::time_point now) noexcept {
+    ++failures_;
+    switch (state_) {
+        case BreakerState::Closed:
+            if (failure_threshold_ == 0 || failures_ < failure_threshold_) {
+                return false;
+            }
+            break;
+        case BreakerState::HalfOpen:
+            // Проба не удалась: пауза длиннее
+            current_interval_ = std::min(current_interval_ * 2, open_interval_ * MAX_OPEN_FACTOR);
+            break;
+        case BreakerState::Open:
+            return false;
+    }
+    state_ = BreakerState::Open;
+    retry_at_ = now + current_interval_;
+    return true;
+}
+
+} // namespace quaxis::merged
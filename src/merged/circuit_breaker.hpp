@@ -0,0 +1,93 @@
+/**
+ * @file circuit_breaker.hpp
+ * @brief Размыкатель опроса недоступной aux chain
+ *
+ * Мёртвая нода отвечает ошибкой только по таймауту: каждый опрос ждал
+ * крайний срок, а её последний шаблон оставался в aux дереве, и
+ * commitment в coinbase указывал на устаревший блок. После
+ * failure_threshold ошибок подряд размыкатель открывается: chain не
+ * опрашивается open_interval и выходит из aux дерева. По истечении
+ * паузы уходит один пробный опрос (half-open): успех замыкает цепь,
+ * ошибка открывает её снова с удвоенной паузой (до MAX_OPEN_FACTOR).
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+namespace quaxis::merged {
+
+/**
+ * @brief Состояние размыкателя
+ */
+enum class BreakerState : uint8_t {
+    Closed,   ///< Chain опрашивается как обычно
+    Open,     ///< Опрос пропускается до retry_at()
+    HalfOpen  ///< Идёт пробный опрос
+};
+
+/**
+ * @brief Размыкатель одной chain
+ *
+ * Thread-safety: нет, используется под chains_mutex ChainManager.
+ */
+class CircuitBreaker {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /// @brief Наибольшая пауза - во столько раз больше open_interval
+    static constexpr uint32_t MAX_OPEN_FACTOR = 8;
+
+    /**
+     * @brief Создать размыкатель
+     *
+     * @param failure_threshold Ошибок подряд до размыкания (0 - никогда)
+     * @param open_interval Пауза до пробного опроса
+     */
+    CircuitBreaker(uint32_t failure_threshold, std::chrono::milliseconds open_interval) noexcept
+        : failure_threshold_(failure_threshold)
+        , open_interval_(open_interval)
+        , current_interval_(open_interval)
+    {}
+
+    /**
+     * @brief Можно ли опросить chain сейчас
+     *
+     * По истечении паузы переводит в HalfOpen и разрешает один опрос.
+     */
+    [[nodiscard]] bool allow(Clock::time_point now) noexcept;
+
+    /**
+     * @brief Учесть удачный опрос
+     *
+     * @return true - размыкатель был открыт и замкнулся
+     */
+    bool record_success() noexcept;
+
+    /**
+     * @brief Учесть ошибку опроса
+     *
+     * @return true - размыкатель только что открылся
+     */
+    bool record_failure(Clock::time_point now) noexcept;
+
+    [[nodiscard]] BreakerState state() const noexcept { return state_; }
+
+    /// @brief Ошибок подряд
+    [[nodiscard]] uint32_t consecutive_failures() const noexcept { return failures_; }
+
+    /// @brief Срок пробного опроса (для Open)
+    [[nodiscard]] Clock::time_point retry_at() const noexcept { return retry_at_; }
+
+private:
+    uint32_t failure_threshold_;
+    std::chrono::milliseconds open_interval_;
+    std::chrono::milliseconds current_interval_;
+
+    BreakerState state_{BreakerState::Closed};
+    uint32_t failures_{0};
+    Clock::time_point retry_at_{};
+};
+
+} // namespace quaxis::merged
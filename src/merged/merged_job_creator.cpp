@@ -5,6 +5,8 @@
 
 #include "merged_job_creator.hpp"
 
+#include <algorithm>
+
 namespace quaxis::merged {
 
 // =============================================================================
@@ -41,98 +43,122 @@ MergedJob MergedJobCreator::create_job(
     job.job_id = job_id;
     job.extranonce = extranonce;
     
-    // Получаем текущий AuxPoW commitment
-    job.aux_commitment = impl_->chain_manager.get_aux_commitment();
+    // AuxPoW commitment и commitments chains вне aux дерева - из одного
+    // снимка, без блокировок ChainManager
+    const auto snapshot = impl_->chain_manager.commitment_snapshot();
+    job.aux_commitment = snapshot->aux_commitment;
+    job.coinbase_commitments = snapshot->coinbase_commitments;
+    job.aux_from_cache = snapshot->from_cache;
     
     // Получаем текущие шаблоны aux chains
     job.aux_templates = impl_->chain_manager.get_active_templates();
     
-    // Строим coinbase с AuxPoW commitment
-    job.coinbase_tx = build_coinbase_with_aux(
+    // Строим coinbase с commitments
+    job.base_coinbase = impl_->coinbase_builder.build(
         bitcoin_template.height,
         bitcoin_template.coinbase_value,
-        extranonce,
-        job.aux_commitment
+        extranonce
+    );
+    job.coinbase_tx = insert_commitments(
+        job.base_coinbase,
+        job.aux_commitment,
+        job.coinbase_commitments
     );
     
     return job;
 }
 
+bool MergedJobCreator::refresh_commitments(MergedJob& job) const {
+    const auto snapshot = impl_->chain_manager.commitment_snapshot();
+    job.aux_from_cache = snapshot->from_cache;
+    if (snapshot->aux_commitment == job.aux_commitment &&
+        snapshot->coinbase_commitments == job.coinbase_commitments) {
+        return true;
+    }
+    
+    Bytes coinbase = insert_commitments(job.base_coinbase, snapshot->aux_commitment,
+                                        snapshot->coinbase_commitments);
+    const bool midstate_kept =
+        coinbase.size() >= constants::SHA256_BLOCK_SIZE && job.coinbase_tx.size() >= constants::SHA256_BLOCK_SIZE &&
+        std::equal(coinbase.begin(), coinbase.begin() + constants::SHA256_BLOCK_SIZE,
+                   job.coinbase_tx.begin());
+    
+    job.aux_commitment = snapshot->aux_commitment;
+    job.coinbase_commitments = snapshot->coinbase_commitments;
+    job.coinbase_tx = std::move(coinbase);
+    return midstate_kept;
+}
+
 Bytes MergedJobCreator::build_coinbase_with_aux(
     uint32_t height,
     int64_t value,
     uint64_t extranonce,
     const std::optional<AuxCommitment>& aux_commitment
 ) const {
-    // Базовая coinbase
-    Bytes coinbase = impl_->coinbase_builder.build(height, value, extranonce);
-    
-    if (!aux_commitment) {
+    return insert_commitments(
+        impl_->coinbase_builder.build(height, value, extranonce),
+        aux_commitment,
+        {}
+    );
+}
+
+Bytes MergedJobCreator::insert_commitments(
+    const Bytes& coinbase,
+    const std::optional<AuxCommitment>& aux_commitment,
+    std::span<const CoinbaseCommitment> coinbase_commitments
+) {
+    // Раскладка coinbase CoinbaseBuilder - bitcoin::CoinbaseLayout,
+    // locktime - последние 4 байта
+    if (!aux_commitment && coinbase_commitments.empty()) {
         return coinbase;
     }
-    
-    // Добавляем AuxPoW commitment в coinbase
-    // Формат: вставляем перед scriptPubKey в output
-    
-    auto commitment_data = aux_commitment->serialize();
-    
-    // Находим позицию для вставки (после scriptsig, перед outputs)
-    // В нашей структуре coinbase это примерно позиция 68-70
-    // (зависит от размера scriptsig)
-    
-    // Упрощённый подход: добавляем commitment как OP_RETURN output
-    // Это стандартный способ для merged mining
-    
-    // Увеличиваем output count
-    // Находим позицию output_count в coinbase
-    // Наша coinbase имеет фиксированную структуру
-    
-    // Вместо модификации существующей coinbase, создаём новую
-    // с дополнительным OP_RETURN output
-    
-    // Позиция output_count в нашей структуре coinbase - байт 74
-    // (version[4] + input_count[1] + prev_hash[32] + prev_index[4] + 
-    //  scriptsig_len[1] + scriptsig[26] + sequence[4] + output_count[1])
-    
-    // Простой подход: добавляем commitment данные в конец scriptsig
-    // Это работает для большинства AuxPoW реализаций
-    
-    Bytes result;
-    result.reserve(coinbase.size() + commitment_data.size());
-    
-    // Копируем coinbase до output section
-    // scriptsig_len находится на позиции 41
-    if (coinbase.size() < 42) {
-        return coinbase; // Coinbase слишком короткая
+    if (coinbase.size() != bitcoin::CoinbaseBuilder::size()) {
+        return coinbase; // Coinbase не от CoinbaseBuilder
     }
     
-    // Увеличиваем scriptsig_len
-    std::size_t original_scriptsig_len = coinbase[41];
-    std::size_t new_scriptsig_len = original_scriptsig_len + commitment_data.size();
-    
-    if (new_scriptsig_len > 100) {
-        // Scriptsig слишком длинный для BIP34
-        return coinbase;
+    // AuxPoW commitment - в scriptsig сразу за extranonce: aux root вместе
+    // с extranonce в хвосте после midstate, первые 64 байта меняет только
+    // длина scriptsig. Вместе с BIP34 scriptsig не длиннее 100 байт
+    std::array<uint8_t, 44> commitment_data{};
+    std::size_t commitment_size = 0;
+    constexpr bitcoin::CoinbaseLayout base_layout{};
+    if (aux_commitment && base_layout.scriptsig_length() + commitment_data.size() <= 100) {
+        commitment_data = aux_commitment->serialize();
+        commitment_size = commitment_data.size();
     }
+    const bitcoin::CoinbaseLayout layout{commitment_size};
     
-    // Копируем начало coinbase до scriptsig_len
-    result.insert(result.end(), coinbase.begin(), coinbase.begin() + 41);
-    
-    // Новая длина scriptsig
-    result.push_back(static_cast<uint8_t>(new_scriptsig_len));
-    
-    // Копируем оригинальный scriptsig
-    std::size_t scriptsig_end = 42 + original_scriptsig_len;
-    result.insert(result.end(), coinbase.begin() + 42, 
-                  coinbase.begin() + static_cast<std::ptrdiff_t>(scriptsig_end));
+    std::size_t outputs_size = 0;
+    for (const auto& commitment : coinbase_commitments) {
+        outputs_size += 8 + 1 + commitment.script.size();
+    }
     
-    // Добавляем commitment
-    result.insert(result.end(), commitment_data.begin(), commitment_data.end());
+    Bytes result;
+    result.reserve(coinbase.size() + commitment_size + outputs_size);
+    
+    // Первый блок и extranonce, новая длина scriptsig
+    constexpr auto commitment_offset = static_cast<std::ptrdiff_t>(bitcoin::CoinbaseLayout::COMMITMENT_OFFSET);
+    result.insert(result.end(), coinbase.begin(), coinbase.begin() + commitment_offset);
+    result[bitcoin::CoinbaseLayout::SCRIPTSIG_LEN_OFFSET] = static_cast<uint8_t>(layout.scriptsig_length());
+    
+    // Commitment, затем остаток до locktime; OP_RETURN выходы chains - после выходов
+    result.insert(result.end(), commitment_data.begin(),
+                  commitment_data.begin() + static_cast<std::ptrdiff_t>(commitment_size));
+    result.insert(result.end(), coinbase.begin() + commitment_offset, coinbase.end() - 4);
+    std::size_t output_count = coinbase[base_layout.output_count_offset()];
+    for (const auto& commitment : coinbase_commitments) {
+        if (output_count + 1 >= 0xfd || commitment.script.size() >= 0xfd) {
+            break;
+        }
+        result.insert(result.end(), 8, 0x00);
+        result.push_back(static_cast<uint8_t>(commitment.script.size()));
+        result.insert(result.end(), commitment.script.begin(), commitment.script.end());
+        ++output_count;
+    }
+    result[layout.output_count_offset()] = static_cast<uint8_t>(output_count);
     
-    // Копируем остаток coinbase (sequence, outputs, locktime)
-    result.insert(result.end(), 
-                  coinbase.begin() + static_cast<std::ptrdiff_t>(scriptsig_end),
-                  coinbase.end());
+    // Locktime
+    result.insert(result.end(), coinbase.end() - 4, coinbase.end());
     
     return result;
 }
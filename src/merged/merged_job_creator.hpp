@@ -15,6 +15,7 @@
 
 #include <memory>
 #include <optional>
+#include <span>
 
 namespace quaxis::merged {
 
@@ -28,12 +29,21 @@ struct MergedJob {
     /// @brief AuxPoW commitment (если есть активные aux chains)
     std::optional<AuxCommitment> aux_commitment;
     
+    /// @brief Commitments chains вне aux дерева (OP_RETURN выходы coinbase)
+    std::vector<CoinbaseCommitment> coinbase_commitments;
+    
     /// @brief Coinbase транзакция с AuxPoW commitment
     Bytes coinbase_tx;
     
+    /// @brief Coinbase без commitments (для refresh_commitments)
+    Bytes base_coinbase;
+    
     /// @brief Шаблоны auxiliary chains
     std::vector<std::pair<std::string, AuxBlockTemplate>> aux_templates;
     
+    /// @brief Commitments частью из кеша прошлого запуска (возможно устарели)
+    bool aux_from_cache{false};
+    
     /// @brief ID задания
     uint32_t job_id{0};
     
@@ -88,6 +98,20 @@ public:
         uint64_t extranonce
     );
     
+    /**
+     * @brief Обновить commitments задания по текущим шаблонам
+     * 
+     * Coinbase пересобирается из base_coinbase без CoinbaseBuilder.
+     * Commitments лежат после первых 64 байт (bitcoin::CoinbaseLayout):
+     * пока длина scriptsig не меняется (aux дерево есть или его нет в
+     * обоих заданиях), смена тега RSK / Hathor или aux root не трогает
+     * midstate coinbase.
+     * 
+     * @param job Задание, созданное create_job()
+     * @return true если первые 64 байта coinbase (midstate) не изменились
+     */
+    [[nodiscard]] bool refresh_commitments(MergedJob& job) const;
+    
     /**
      * @brief Построить coinbase с AuxPoW commitment
      * 
@@ -109,6 +133,25 @@ public:
      */
     [[nodiscard]] std::optional<AuxCommitment> get_current_aux_commitment() const;
     
+    /**
+     * @brief Вставить commitments в coinbase CoinbaseBuilder
+     * 
+     * AuxPoW commitment встаёт в scriptsig сразу за extranonce (оба с
+     * границы 64 байт, см. bitcoin::CoinbaseLayout), commitments chains
+     * вне aux дерева - OP_RETURN выходами перед locktime. Extranonce
+     * остаётся на CoinbaseBuilder::EXTRANONCE_OFFSET.
+     * 
+     * @param coinbase Coinbase без commitments
+     * @param aux_commitment AuxPoW commitment
+     * @param coinbase_commitments Выходы chains вне aux дерева
+     * @return Bytes Coinbase с commitments
+     */
+    [[nodiscard]] static Bytes insert_commitments(
+        const Bytes& coinbase,
+        const std::optional<AuxCommitment>& aux_commitment,
+        std::span<const CoinbaseCommitment> coinbase_commitments
+    );
+    
 private:
     struct Impl;
     std::unique_ptr<Impl> impl_;
@@ -0,0 +1,70 @@
+/**
+ * @file poll_scheduler.cpp
+ * @brief Реализация расписания опроса aux chains
+ */
+
+#include "poll_scheduler.hpp"
+
+#include <algorithm>
+
+namespace quaxis::merged {
+
+std::size_t PollScheduler::add_chain(
+    std::chrono::milliseconds initial_interval,
+    Clock::time_point now
+) {
+    chains_.push_back(ChainSchedule{
+        std::max(initial_interval, MIN_INTERVAL), std::nullopt, std::nullopt, now, now});
+    return chains_.size() - 1;
+}
+
+void PollScheduler::observe_height(std::size_t index, uint32_t height, Clock::time_point now) {
+    auto& chain = chains_[index];
+    if (chain.height && height == *chain.height) {
+        return;
+    }
+
+    if (chain.height && height > *chain.height) {
+        const auto sample = std::chrono::duration_cast<std::chrono::milliseconds>(
+            now - chain.height_changed_at) / (height - *chain.height);
+        chain.block_interval = chain.block_interval
+            ? (*chain.block_interval * 3 + sample) / 4
+            : sample;
+
+        // Новый интервал действует сразу, а не после старого срока
+        chain.deadline = std::min(chain.deadline, now + interval(index));
+    }
+
+    chain.height = height;
+    chain.height_changed_at = now;
+}
+
+bool PollScheduler::take_due(std::size_t index, Clock::time_point now) {
+    auto& chain = chains_[index];
+    if (now < chain.deadline) {
+        return false;
+    }
+    chain.deadline = now + interval(index);
+    return true;
+}
+
+std::optional<PollScheduler::Clock::time_point> PollScheduler::next_deadline() const {
+    if (chains_.empty()) {
+        return std::nullopt;
+    }
+    return std::ranges::min(chains_, {}, &ChainSchedule::deadline).deadline;
+}
+
+std::chrono::milliseconds PollScheduler::interval(std::size_t index) const {
+    const auto& chain = chains_[index];
+    if (!chain.block_interval) {
+        return chain.initial_interval;
+    }
+    return std::clamp(*chain.block_interval / POLLS_PER_BLOCK, MIN_INTERVAL, MAX_INTERVAL);
+}
+
+std::optional<std::chrono::milliseconds> PollScheduler::block_interval(std::size_t index) const {
+    return chains_[index].block_interval;
+}
+
+} // namespace quaxis::merged
@@ -0,0 +1,89 @@
+/**
+ * @file poll_scheduler.hpp
+ * @brief Расписание опроса шаблонов aux chains
+ *
+ * Chains различаются временем блока на порядки: RSK - ~30 с, Syscoin и
+ * Elastos - 1-2 минуты, Namecoin - 10 минут. Один интервал на все chains
+ * либо дёргает медленные ноды зря, либо держит шаблон быстрых chains
+ * устаревшим. PollScheduler оценивает время блока каждой chain по
+ * приращениям высоты шаблона и опрашивает её POLLS_PER_BLOCK раз за блок
+ * в пределах [MIN_INTERVAL, MAX_INTERVAL]. До первой оценки chain
+ * опрашивается с интервалом update_interval из конфигурации.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace quaxis::merged {
+
+/**
+ * @brief Адаптивные сроки опроса chains
+ *
+ * Thread-safety: нет, используется только из worker thread ChainManager.
+ */
+class PollScheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /// @brief Опросов за оценённое время блока
+    static constexpr uint32_t POLLS_PER_BLOCK = 60;
+
+    /// @brief Нижняя граница интервала (быстрые chains)
+    static constexpr std::chrono::milliseconds MIN_INTERVAL{1000};
+
+    /// @brief Верхняя граница интервала (медленные chains)
+    static constexpr std::chrono::milliseconds MAX_INTERVAL{30000};
+
+    /**
+     * @brief Добавить chain
+     *
+     * @param initial_interval Интервал до оценки времени блока
+     * @param now Текущее время (первый опрос - сразу)
+     * @return std::size_t Индекс chain
+     */
+    std::size_t add_chain(std::chrono::milliseconds initial_interval, Clock::time_point now);
+
+    /**
+     * @brief Учесть высоту полученного шаблона
+     *
+     * Рост высоты даёт выборку времени блока: время с прошлой смены
+     * высоты, делённое на приращение. Оценка сглаживается (EWMA 1/4).
+     * Уменьшение высоты (reorg, смена ноды) начинает отсчёт заново.
+     */
+    void observe_height(std::size_t index, uint32_t height, Clock::time_point now);
+
+    /**
+     * @brief Пора ли опрашивать chain; если да - следующий срок от now
+     */
+    [[nodiscard]] bool take_due(std::size_t index, Clock::time_point now);
+
+    /**
+     * @brief Ближайший срок опроса среди всех chains
+     *
+     * @return Срок или nullopt (chains нет)
+     */
+    [[nodiscard]] std::optional<Clock::time_point> next_deadline() const;
+
+    /// @brief Текущий интервал опроса chain
+    [[nodiscard]] std::chrono::milliseconds interval(std::size_t index) const;
+
+    /// @brief Оценка времени блока chain (nullopt - ещё нет)
+    [[nodiscard]] std::optional<std::chrono::milliseconds> block_interval(std::size_t index) const;
+
+private:
+    struct ChainSchedule {
+        std::chrono::milliseconds initial_interval;
+        std::optional<std::chrono::milliseconds> block_interval;
+        std::optional<uint32_t> height;
+        Clock::time_point height_changed_at;
+        Clock::time_point deadline;
+    };
+
+    std::vector<ChainSchedule> chains_;
+};
+
+} // namespace quaxis::merged
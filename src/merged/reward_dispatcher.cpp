@@ -5,11 +5,61 @@
 
 #include "reward_dispatcher.hpp"
 #include "../bitcoin/block.hpp"
+#include "../mining/block_spool.hpp"
+#include "../crypto/sha256.hpp"
+#include "../core/stats_counter.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <mutex>
+#include <optional>
+#include <thread>
 
 namespace quaxis::merged {
 
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief Сбой связи с нодой: отправку стоит повторить
+ */
+bool is_transient(const Error& error) noexcept {
+    return error.code == ErrorCode::RpcConnectionFailed ||
+           error.code == ErrorCode::NetworkTimeout;
+}
+
+/**
+ * @brief Находка, общая для отправок во все chains
+ */
+struct FindRecord {
+    Hash256 parent_hash{};
+    
+    /// @brief Заголовок и coinbase для spool (пусто - без spool)
+    Bytes payload;
+    
+    /// @brief Запись в spool - один раз, до первой отправки
+    std::once_flag spooled;
+    
+    /// @brief Находка уже отмечена в spool принятой
+    std::atomic<bool> accepted{false};
+};
+
+/**
+ * @brief Отправка в очереди chain
+ */
+struct DispatchTask {
+    AuxSubmission submission;
+    std::shared_ptr<FindRecord> find;
+    Clock::time_point next_attempt;
+    Clock::time_point deadline;
+    std::chrono::milliseconds backoff;
+};
+
+} // anonymous namespace
+
 // =============================================================================
 // RewardDispatcher::Impl
 // =============================================================================
@@ -18,11 +68,259 @@ struct RewardDispatcher::Impl {
     ChainManager& chain_manager;
     
     BlockDispatchedCallback dispatch_callback;
+    mining::BlockSpool* spool{nullptr};
     
     std::unordered_map<std::string, uint32_t> dispatch_stats;
     mutable std::mutex stats_mutex;
     
+    // Общая часть AuxPoW последнего задания (coinbase, coinbase branch в
+    // hex): следующая находка того же задания меняет только parent header.
+    std::optional<AuxPowHexBuilder> auxpow_cache;
+    uint32_t cached_job_id{0};
+    std::mutex cache_mutex;
+    
+    /**
+     * @brief Общая часть AuxPoW задания (под cache_mutex)
+     */
+    AuxPowHexBuilder& shared_auxpow(uint32_t job_id, const Bytes& coinbase_tx) {
+        if (!auxpow_cache || cached_job_id != job_id ||
+            auxpow_cache->common().coinbase_tx != coinbase_tx) {
+            // Для блока только с coinbase branch пустой
+            MerkleBranch coinbase_branch;
+            coinbase_branch.index = 0;
+            auxpow_cache.emplace(coinbase_tx, std::move(coinbase_branch));
+            cached_job_id = job_id;
+        }
+        return *auxpow_cache;
+    }
+    
+    /**
+     * @brief Полоса chain: своя очередь и поток отправки
+     */
+    struct Lane {
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::deque<DispatchTask> tasks;
+        
+        /// @brief block_hash шаблона, уже принятого нодой
+        std::optional<Hash256> accepted_block;
+        
+        std::thread worker;
+    };
+    
+    DispatchQueueConfig queue_config;
+    bool running{false};
+    std::atomic<bool> stopping{false};
+    
+    std::unordered_map<std::string, std::unique_ptr<Lane>> lanes;
+    std::deque<Hash256> recent_finds;
+    std::mutex lanes_mutex;
+    
+    core::RelaxedCounter queued;
+    core::RelaxedCounter accepted;
+    core::RelaxedCounter retries;
+    core::RelaxedCounter stale;
+    core::RelaxedCounter failed;
+    core::RelaxedCounter duplicates;
+    core::RelaxedCounter dropped;
+    
     explicit Impl(ChainManager& cm) : chain_manager(cm) {}
+    
+    /**
+     * @brief Результат отправки в одну chain: статистика и callback
+     */
+    void publish(const DispatchResult& result) {
+        if (result.success) {
+            std::lock_guard<std::mutex> lock(stats_mutex);
+            dispatch_stats[result.chain_name]++;
+        }
+        if (dispatch_callback) {
+            dispatch_callback(result);
+        }
+    }
+    
+    /**
+     * @brief Результаты отправки: статистика и callback
+     */
+    std::vector<DispatchResult> report(
+        const std::vector<std::pair<std::string, bool>>& submit_results,
+        const std::vector<std::pair<std::string, AuxBlockTemplate>>& aux_templates
+    ) {
+        std::vector<DispatchResult> results;
+        for (const auto& [chain_name, success] : submit_results) {
+            DispatchResult result;
+            result.chain_name = chain_name;
+            result.success = success;
+            
+            // Находим шаблон для этой chain
+            for (const auto& [name, tmpl] : aux_templates) {
+                if (name == chain_name) {
+                    result.height = tmpl.height;
+                    result.block_hash = tmpl.block_hash;
+                    break;
+                }
+            }
+            
+            if (!success) {
+                result.error_message = "Ошибка отправки блока";
+            }
+            
+            results.push_back(result);
+            publish(result);
+        }
+        return results;
+    }
+    
+    /**
+     * @brief Отметить находку в spool, если её приняла хотя бы одна chain
+     */
+    void mark_spooled(const Hash256& parent_hash,
+                      const std::vector<std::pair<std::string, bool>>& submit_results) {
+        if (!spool) {
+            return;
+        }
+        for (const auto& [chain_name, success] : submit_results) {
+            if (success) {
+                spool->mark_submitted(mining::SpoolKind::AuxPow, parent_hash);
+                return;
+            }
+        }
+    }
+    
+    /**
+     * @brief Полоса chain (создаётся с первой отправкой, под lanes_mutex)
+     */
+    Lane& lane_for(const std::string& chain_name) {
+        auto& lane = lanes[chain_name];
+        if (!lane) {
+            lane = std::make_unique<Lane>();
+            lane->worker = std::thread([this, raw = lane.get()] { run_lane(*raw); });
+        }
+        return *lane;
+    }
+    
+    /**
+     * @brief Находка уже поставлена? Иначе запомнить (под lanes_mutex)
+     */
+    bool seen_find(const Hash256& parent_hash) {
+        if (std::find(recent_finds.begin(), recent_finds.end(), parent_hash) != recent_finds.end()) {
+            return true;
+        }
+        recent_finds.push_back(parent_hash);
+        while (recent_finds.size() > queue_config.recent_finds) {
+            recent_finds.pop_front();
+        }
+        return false;
+    }
+    
+    /**
+     * @brief Поток полосы: отправки по готовности, повторы с паузой
+     */
+    void run_lane(Lane& lane) {
+        std::unique_lock<std::mutex> lock(lane.mutex);
+        while (!stopping.load(std::memory_order_acquire)) {
+            if (lane.tasks.empty()) {
+                lane.cv.wait(lock, [&] {
+                    return stopping.load(std::memory_order_acquire) || !lane.tasks.empty();
+                });
+                continue;
+            }
+            
+            auto next = std::min_element(lane.tasks.begin(), lane.tasks.end(),
+                [](const DispatchTask& a, const DispatchTask& b) {
+                    return a.next_attempt < b.next_attempt;
+                });
+            if (next->next_attempt > Clock::now()) {
+                lane.cv.wait_until(lock, next->next_attempt);
+                continue;
+            }
+            DispatchTask task = std::move(*next);
+            lane.tasks.erase(next);
+            
+            // Нода уже приняла блок этого шаблона - второй ей не нужен
+            if (lane.accepted_block == task.submission.block_template.block_hash) {
+                duplicates.add();
+                continue;
+            }
+            
+            lock.unlock();
+            const auto outcome = attempt(task);
+            lock.lock();
+            
+            if (outcome == Outcome::Retry) {
+                lane.tasks.push_back(std::move(task));
+            } else if (outcome == Outcome::Accepted) {
+                lane.accepted_block = task.submission.block_template.block_hash;
+            }
+        }
+    }
+    
+    enum class Outcome { Accepted, Retry, Done };
+    
+    /**
+     * @brief Одна попытка отправки (без блокировок полосы)
+     */
+    Outcome attempt(DispatchTask& task) {
+        auto& find = *task.find;
+        if (spool && !find.payload.empty()) {
+            std::call_once(find.spooled, [&] {
+                (void)spool->append(mining::SpoolKind::AuxPow, find.parent_hash, find.payload);
+            });
+        }
+        
+        auto result = chain_manager.submit_prepared(task.submission);
+        const auto now = Clock::now();
+        if (!result && is_transient(result.error()) && now + task.backoff < task.deadline &&
+            !stopping.load(std::memory_order_acquire)) {
+            retries.add();
+            task.next_attempt = now + task.backoff;
+            task.backoff = std::min(task.backoff * 2, queue_config.max_backoff);
+            return Outcome::Retry;
+        }
+        
+        DispatchResult dispatched;
+        dispatched.chain_name = task.submission.chain_name;
+        dispatched.success = result.has_value();
+        dispatched.height = task.submission.block_template.height;
+        dispatched.block_hash = task.submission.block_template.block_hash;
+        if (result) {
+            accepted.add();
+            if (spool && !find.accepted.exchange(true)) {
+                spool->mark_submitted(mining::SpoolKind::AuxPow, find.parent_hash);
+            }
+        } else {
+            (result.error().code == ErrorCode::MiningStaleJob ? stale : failed).add();
+            dispatched.error_message = result.error().message;
+        }
+        publish(dispatched);
+        return result ? Outcome::Accepted : Outcome::Done;
+    }
+    
+    /**
+     * @brief Остановить и дождаться полос
+     */
+    void stop_lanes() {
+        std::unordered_map<std::string, std::unique_ptr<Lane>> stopped;
+        {
+            std::lock_guard<std::mutex> lock(lanes_mutex);
+            stopping.store(true, std::memory_order_release);
+            running = false;
+            stopped.swap(lanes);
+        }
+        for (auto& [name, lane] : stopped) {
+            {
+                std::lock_guard<std::mutex> lock(lane->mutex);
+                dropped.add(lane->tasks.size());
+                lane->tasks.clear();
+            }
+            lane->cv.notify_all();
+        }
+        for (auto& [name, lane] : stopped) {
+            if (lane->worker.joinable()) {
+                lane->worker.join();
+            }
+        }
+    }
 };
 
 // =============================================================================
@@ -32,7 +330,9 @@ struct RewardDispatcher::Impl {
 RewardDispatcher::RewardDispatcher(ChainManager& chain_manager)
     : impl_(std::make_unique<Impl>(chain_manager)) {}
 
-RewardDispatcher::~RewardDispatcher() = default;
+RewardDispatcher::~RewardDispatcher() {
+    impl_->stop_lanes();
+}
 
 std::vector<DispatchResult> RewardDispatcher::dispatch_block(
     const bitcoin::BlockHeader& header,
@@ -40,64 +340,147 @@ std::vector<DispatchResult> RewardDispatcher::dispatch_block(
     [[maybe_unused]] uint32_t nonce,
     const MergedJob& merged_job
 ) {
-    std::vector<DispatchResult> results;
-    
-    // Сериализуем заголовок
-    auto header_bytes = header.serialize();
+    const auto header_bytes = header.serialize();
+    const Hash256 parent_hash = crypto::sha256d(header_bytes);
     
-    // Строим coinbase branch (для пустого блока merkle root = txid coinbase)
-    MerkleBranch coinbase_branch;
-    coinbase_branch.index = 0;
-    // Для блока только с coinbase branch пустой
+    // Находка пишется на диск в своём потоке, пока идёт отправка
+    std::thread spool_writer;
+    if (impl_->spool) {
+        Bytes payload(header_bytes.begin(), header_bytes.end());
+        payload.insert(payload.end(), coinbase_tx.begin(), coinbase_tx.end());
+        spool_writer = std::thread([spool = impl_->spool, parent_hash, payload = std::move(payload)] {
+            (void)spool->append(mining::SpoolKind::AuxPow, parent_hash, payload);
+        });
+    }
     
-    // Получаем список chains, которым подходит этот блок
-    auto matching_chains = impl_->chain_manager.check_aux_chains(
-        header_bytes,
-        coinbase_tx,
-        coinbase_branch
-    );
+    // Coinbase и coinbase branch (для пустого блока merkle root = txid
+    // coinbase) кодируются один раз на задание, к ним - заголовок находки
+    std::vector<std::pair<std::string, bool>> submit_results;
+    {
+        std::lock_guard<std::mutex> lock(impl_->cache_mutex);
+        auto& auxpow = impl_->shared_auxpow(merged_job.job_id, coinbase_tx);
+        auxpow.set_parent_header(header_bytes);
+        
+        // Отправляем в каждую подходящую chain (отбор - внутри)
+        submit_results = impl_->chain_manager.submit_to_matching_chains(auxpow);
+    }
     
-    // Отправляем в каждую подходящую chain
-    auto submit_results = impl_->chain_manager.submit_to_matching_chains(
-        header_bytes,
-        coinbase_tx,
-        coinbase_branch
-    );
+    if (spool_writer.joinable()) {
+        spool_writer.join();
+    }
+    impl_->mark_spooled(parent_hash, submit_results);
     
-    // Формируем результаты
-    for (const auto& [chain_name, success] : submit_results) {
-        DispatchResult result;
-        result.chain_name = chain_name;
-        result.success = success;
-        
-        // Находим шаблон для этой chain
-        for (const auto& [name, tmpl] : merged_job.aux_templates) {
-            if (name == chain_name) {
-                result.height = tmpl.height;
-                result.block_hash = tmpl.block_hash;
-                break;
-            }
-        }
-        
-        if (!success) {
-            result.error_message = "Ошибка отправки блока";
+    return impl_->report(submit_results, merged_job.aux_templates);
+}
+
+std::size_t RewardDispatcher::dispatch_async(
+    const bitcoin::BlockHeader& header,
+    const Bytes& coinbase_tx,
+    uint32_t nonce,
+    const MergedJob& merged_job
+) {
+    {
+        std::lock_guard<std::mutex> lock(impl_->lanes_mutex);
+        if (!impl_->running) {
+            return dispatch_block(header, coinbase_tx, nonce, merged_job).size();
         }
-        
-        results.push_back(result);
-        
-        // Обновляем статистику
-        if (success) {
-            std::lock_guard<std::mutex> lock(impl_->stats_mutex);
-            impl_->dispatch_stats[chain_name]++;
+    }
+    
+    const auto header_bytes = header.serialize();
+    auto find = std::make_shared<FindRecord>();
+    find->parent_hash = crypto::sha256d(header_bytes);
+    {
+        std::lock_guard<std::mutex> lock(impl_->lanes_mutex);
+        if (impl_->seen_find(find->parent_hash)) {
+            impl_->duplicates.add();
+            return 0;
         }
-        
-        // Вызываем callback
-        if (impl_->dispatch_callback) {
-            impl_->dispatch_callback(result);
+    }
+    if (impl_->spool) {
+        find->payload.assign(header_bytes.begin(), header_bytes.end());
+        find->payload.insert(find->payload.end(), coinbase_tx.begin(), coinbase_tx.end());
+    }
+    
+    std::vector<AuxSubmission> submissions;
+    {
+        std::lock_guard<std::mutex> lock(impl_->cache_mutex);
+        auto& auxpow = impl_->shared_auxpow(merged_job.job_id, coinbase_tx);
+        auxpow.set_parent_header(header_bytes);
+        submissions = impl_->chain_manager.prepare_submissions(auxpow);
+    }
+    
+    const auto now = Clock::now();
+    const auto& config = impl_->queue_config;
+    std::size_t enqueued = 0;
+    std::lock_guard<std::mutex> lock(impl_->lanes_mutex);
+    if (!impl_->running) {
+        impl_->dropped.add(submissions.size());
+        return 0;
+    }
+    for (auto& submission : submissions) {
+        auto& lane = impl_->lane_for(submission.chain_name);
+        {
+            std::lock_guard<std::mutex> lane_lock(lane.mutex);
+            if (lane.tasks.size() >= config.lane_capacity) {
+                impl_->dropped.add();
+                continue;
+            }
+            lane.tasks.push_back(DispatchTask{
+                std::move(submission), find, now, now + config.deadline, config.initial_backoff
+            });
         }
+        lane.cv.notify_one();
+        impl_->queued.add();
+        ++enqueued;
+    }
+    return enqueued;
+}
+
+void RewardDispatcher::start(const DispatchQueueConfig& config) {
+    std::lock_guard<std::mutex> lock(impl_->lanes_mutex);
+    if (impl_->running) {
+        return;
+    }
+    impl_->queue_config = config;
+    impl_->stopping.store(false, std::memory_order_release);
+    impl_->running = true;
+}
+
+void RewardDispatcher::stop() {
+    impl_->stop_lanes();
+}
+
+DispatchQueueStats RewardDispatcher::queue_stats() const {
+    DispatchQueueStats stats;
+    stats.queued = impl_->queued.load();
+    stats.accepted = impl_->accepted.load();
+    stats.retries = impl_->retries.load();
+    stats.stale = impl_->stale.load();
+    stats.failed = impl_->failed.load();
+    stats.duplicates = impl_->duplicates.load();
+    stats.dropped = impl_->dropped.load();
+    return stats;
+}
+
+std::vector<DispatchResult> RewardDispatcher::replay(const mining::SpooledBlock& spooled) {
+    if (spooled.kind != mining::SpoolKind::AuxPow ||
+        spooled.payload.size() <= constants::BLOCK_HEADER_SIZE) {
+        return {};
     }
     
-    return results;
+    std::array<uint8_t, 80> parent_header{};
+    std::copy_n(spooled.payload.begin(), parent_header.size(), parent_header.begin());
+    const Bytes coinbase_tx(spooled.payload.begin() + constants::BLOCK_HEADER_SIZE,
+                            spooled.payload.end());
+    
+    // Для блока только с coinbase branch пустой
+    MerkleBranch coinbase_branch;
+    coinbase_branch.index = 0;
+    const auto submit_results = impl_->chain_manager.submit_to_matching_chains(
+        parent_header, coinbase_tx, coinbase_branch
+    );
+    impl_->mark_spooled(spooled.hash, submit_results);
+    return impl_->report(submit_results, impl_->chain_manager.get_active_templates());
 }
 
 std::vector<std::string> RewardDispatcher::check_all_chains(
@@ -115,6 +498,10 @@ std::vector<std::string> RewardDispatcher::check_all_chains(
     );
 }
 
+void RewardDispatcher::set_spool(mining::BlockSpool* spool) {
+    impl_->spool = spool;
+}
+
 void RewardDispatcher::set_dispatch_callback(BlockDispatchedCallback callback) {
     impl_->dispatch_callback = std::move(callback);
 }
@@ -4,6 +4,17 @@
  * 
  * Отвечает за проверку найденных блоков и отправку их
  * в соответствующие chains (Bitcoin и auxiliary chains).
+ * 
+ * Со spool (set_spool) находка - заголовок и coinbase - записывается на
+ * диск параллельно с отправкой и повторяется при следующем запуске, если
+ * ни одна chain её не приняла.
+ * 
+ * После start() dispatch_async() только ставит находку в очереди chains и
+ * сразу возвращается: у каждой chain своя полоса - поток и очередь, -
+ * медленная нода не задерживает ни поток share, ни другие chains. Сбой
+ * связи повторяется с растущей паузой, пока шаблон chain не сменился и
+ * не истёк срок; повтор той же находки и отправки в шаблон, уже принятый
+ * нодой, отбрасываются.
  */
 
 #pragma once
@@ -12,10 +23,16 @@
 #include "merged_job_creator.hpp"
 #include "../bitcoin/block.hpp"
 
+#include <chrono>
 #include <memory>
 #include <functional>
 #include <vector>
 
+namespace quaxis::mining {
+class BlockSpool;
+struct SpooledBlock;
+}
+
 namespace quaxis::merged {
 
 /**
@@ -40,11 +57,59 @@ struct DispatchResult {
 
 /**
  * @brief Callback при успешной отправке блока
+ * 
+ * При асинхронной отправке вызывается из потока полосы chain.
  */
 using BlockDispatchedCallback = std::function<void(
     const DispatchResult& result
 )>;
 
+/**
+ * @brief Параметры асинхронной отправки (RewardDispatcher::start)
+ */
+struct DispatchQueueConfig {
+    /// @brief Отправок в очереди одной chain; сверх - отбрасываются
+    std::size_t lane_capacity{32};
+    
+    /// @brief Пауза перед первым повтором (дальше удваивается)
+    std::chrono::milliseconds initial_backoff{200};
+    
+    /// @brief Наибольшая пауза между повторами
+    std::chrono::milliseconds max_backoff{5000};
+    
+    /// @brief Срок попыток одной отправки (смена шаблона chain - раньше)
+    std::chrono::milliseconds deadline{std::chrono::minutes(2)};
+    
+    /// @brief Последних находок, повтор которых отбрасывается
+    std::size_t recent_finds{256};
+};
+
+/**
+ * @brief Статистика асинхронной отправки
+ */
+struct DispatchQueueStats {
+    /// @brief Поставлено отправок (находка × chain)
+    uint64_t queued{0};
+    
+    /// @brief Приняты нодой
+    uint64_t accepted{0};
+    
+    /// @brief Повторов после сбоя связи
+    uint64_t retries{0};
+    
+    /// @brief Брошены: шаблон chain сменился или chain выключена
+    uint64_t stale{0};
+    
+    /// @brief Отклонены нодой или исчерпан срок
+    uint64_t failed{0};
+    
+    /// @brief Отброшены повторы находок и отправки в уже принятый шаблон
+    uint64_t duplicates{0};
+    
+    /// @brief Отброшены: очередь chain полна или остановлена
+    uint64_t dropped{0};
+};
+
 /**
  * @brief Диспетчер отправки блоков
  * 
@@ -84,6 +149,43 @@ public:
         const MergedJob& merged_job
     );
     
+    /**
+     * @brief Поставить найденный блок в очереди отправки chains
+     * 
+     * Chains и aux branches отбираются сразу, RPC - в полосах chains.
+     * Результаты приходят в callback set_dispatch_callback(). Без start()
+     * блок отправляется сразу, как dispatch_block().
+     * 
+     * @param header Заголовок Bitcoin блока (80 байт)
+     * @param coinbase_tx Coinbase транзакция
+     * @param nonce Найденный nonce
+     * @param merged_job Исходное merged mining задание
+     * @return Поставлено отправок (0 - повтор находки или нет подходящих chains)
+     */
+    std::size_t dispatch_async(
+        const bitcoin::BlockHeader& header,
+        const Bytes& coinbase_tx,
+        uint32_t nonce,
+        const MergedJob& merged_job
+    );
+    
+    /**
+     * @brief Запустить асинхронную отправку
+     * 
+     * Полоса chain (поток и очередь) создаётся с первой её находкой.
+     */
+    void start(const DispatchQueueConfig& config = {});
+    
+    /**
+     * @brief Остановить полосы (неотправленное отбрасывается, spool его повторит)
+     */
+    void stop();
+    
+    /**
+     * @brief Статистика асинхронной отправки
+     */
+    [[nodiscard]] DispatchQueueStats queue_stats() const;
+    
     /**
      * @brief Проверить блок для всех chains
      * 
@@ -96,6 +198,21 @@ public:
         const bitcoin::BlockHeader& header
     ) const;
     
+    /**
+     * @brief Повторить находку из spool (SpoolKind::AuxPow)
+     * 
+     * @param spooled Запись take_pending()
+     * @return std::vector<DispatchResult> Результаты отправки (пусто - не AuxPow запись)
+     */
+    [[nodiscard]] std::vector<DispatchResult> replay(const mining::SpooledBlock& spooled);
+    
+    /**
+     * @brief Записывать находки в spool (до первой находки)
+     * 
+     * @param spool Spool (nullptr - без spool)
+     */
+    void set_spool(mining::BlockSpool* spool);
+    
     /**
      * @brief Установить callback для отправленных блоков
      */
@@ -4,10 +4,12 @@
  */
 
 #include "aux_rpc_client.hpp"
+#include "../../core/serialization/json.hpp"
 
 #include <curl/curl.h>
-#include <sstream>
 #include <atomic>
+#include <optional>
+#include <vector>
 
 namespace quaxis::merged {
 
@@ -38,6 +40,103 @@ void ensure_curl_init() {
     }
 }
 
+/**
+ * @brief Буферы одного HTTP вызова (живут до завершения transfer)
+ * 
+ * Переиспользуются между вызовами: после первых запросов память
+ * под тело и ответ уже выделена.
+ */
+struct CallBuffers {
+    std::string request_body;
+    std::string response;
+};
+
+/**
+ * @brief Заголовки запросов клиента, собираются один раз
+ * 
+ * "Expect:" отключает 100-continue: иначе curl перед телом больше
+ * 1 КБ (submitauxblock с AuxPoW) ждёт ответа ноды лишний RTT.
+ */
+struct curl_slist* make_headers() {
+    struct curl_slist* headers = curl_slist_append(nullptr, "Content-Type: application/json");
+    return curl_slist_append(headers, "Expect:");
+}
+
+/**
+ * @brief Настроить easy handle на JSON-RPC вызов
+ * 
+ * Handle не сбрасывается: соединение с нодой (keep-alive) остаётся в
+ * handle и переиспользуется следующим вызовом.
+ */
+void prepare_call(
+    CURL* curl,
+    const std::string& url,
+    const std::string& auth,
+    const struct curl_slist* headers,
+    long timeout_ms,
+    std::string_view method,
+    std::string_view params,
+    CallBuffers& buffers
+) {
+    // Формируем JSON-RPC запрос
+    auto& body = buffers.request_body;
+    body.clear();
+    body.append(R"({"jsonrpc":"2.0","id":1,"method":")");
+    body.append(method);
+    body.append(R"(","params":)");
+    body.append(params);
+    body.push_back('}');
+    buffers.response.clear();
+    
+    // Настраиваем CURL
+    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(curl, CURLOPT_POST, 1L);
+    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, body.c_str());
+    curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, static_cast<long>(body.size()));
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_callback);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &buffers.response);
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, timeout_ms);
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+    
+    // Basic auth
+    curl_easy_setopt(curl, CURLOPT_USERPWD, auth.empty() ? nullptr : auth.c_str());
+}
+
+/**
+ * @brief Проверить результат вызова: CURL код, HTTP код, поле error
+ */
+Result<std::string> finish_call(CURL* curl, CURLcode res, const std::string& response) {
+    if (res != CURLE_OK) {
+        return std::unexpected(Error{ErrorCode::RpcConnectionFailed,
+            std::string("CURL ошибка: ") + curl_easy_strerror(res)});
+    }
+    
+    // Проверяем HTTP код
+    long http_code = 0;
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
+    
+    if (http_code == 401) {
+        return std::unexpected(Error{ErrorCode::RpcAuthFailed,
+            "Ошибка авторизации RPC"});
+    }
+    
+    if (http_code != 200) {
+        return std::unexpected(Error{ErrorCode::RpcInternalError,
+            "HTTP ошибка: " + std::to_string(http_code)});
+    }
+    
+    // Проверяем наличие ошибки в JSON ответе
+    auto error = core::json::Value::parse(response)["error"];
+    if (error && !error.is_null()) {
+        return std::unexpected(Error{ErrorCode::RpcInternalError,
+            "RPC ошибка: " + std::string(error.raw())});
+    }
+    
+    return response;
+}
+
 } // anonymous namespace
 
 // =============================================================================
@@ -46,25 +145,29 @@ void ensure_curl_init() {
 
 struct AuxRpcClient::Impl {
     std::string url;
-    std::string user;
-    std::string password;
+    std::string auth;  // "user:password" или пусто
     uint32_t timeout;
     CURL* curl{nullptr};
+    struct curl_slist* headers{nullptr};
+    CallBuffers buffers;
     
     Impl(std::string u, std::string usr, std::string pwd, uint32_t t)
         : url(std::move(u))
-        , user(std::move(usr))
-        , password(std::move(pwd))
         , timeout(t) {
         
+        if (!usr.empty()) {
+            auth = usr + ":" + pwd;
+        }
         ensure_curl_init();
         curl = curl_easy_init();
+        headers = make_headers();
     }
     
     ~Impl() {
         if (curl) {
             curl_easy_cleanup(curl);
         }
+        curl_slist_free_all(headers);
     }
     
     Result<std::string> call(std::string_view method, std::string_view params) {
@@ -73,73 +176,12 @@ struct AuxRpcClient::Impl {
                 "CURL не инициализирован"});
         }
         
-        // Формируем JSON-RPC запрос
-        std::ostringstream json;
-        json << R"({"jsonrpc":"2.0","id":1,"method":")" << method 
-             << R"(","params":)" << params << "}";
-        std::string request_body = json.str();
-        
-        std::string response;
-        
-        // Настраиваем CURL
-        curl_easy_reset(curl);
-        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-        curl_easy_setopt(curl, CURLOPT_POST, 1L);
-        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, request_body.c_str());
-        curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, 
-                         static_cast<long>(request_body.size()));
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_callback);
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
-        curl_easy_setopt(curl, CURLOPT_TIMEOUT, static_cast<long>(timeout));
-        
-        // Заголовки
-        struct curl_slist* headers = nullptr;
-        headers = curl_slist_append(headers, "Content-Type: application/json");
-        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-        
-        // Basic auth
-        if (!user.empty()) {
-            std::string auth = user + ":" + password;
-            curl_easy_setopt(curl, CURLOPT_USERPWD, auth.c_str());
-        }
+        prepare_call(curl, url, auth, headers, static_cast<long>(timeout) * 1000,
+                     method, params, buffers);
         
         // Выполняем запрос
         CURLcode res = curl_easy_perform(curl);
-        
-        curl_slist_free_all(headers);
-        
-        if (res != CURLE_OK) {
-            return std::unexpected(Error{ErrorCode::RpcConnectionFailed,
-                std::string("CURL ошибка: ") + curl_easy_strerror(res)});
-        }
-        
-        // Проверяем HTTP код
-        long http_code = 0;
-        curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
-        
-        if (http_code == 401) {
-            return std::unexpected(Error{ErrorCode::RpcAuthFailed,
-                "Ошибка авторизации RPC"});
-        }
-        
-        if (http_code != 200) {
-            return std::unexpected(Error{ErrorCode::RpcInternalError,
-                "HTTP ошибка: " + std::to_string(http_code)});
-        }
-        
-        // Проверяем наличие ошибки в JSON ответе
-        if (response.find("\"error\"") != std::string::npos &&
-            response.find("\"error\":null") == std::string::npos) {
-            // Есть ошибка в ответе
-            auto error_start = response.find("\"error\"");
-            auto error_end = response.find('}', error_start);
-            if (error_end != std::string::npos) {
-                return std::unexpected(Error{ErrorCode::RpcInternalError,
-                    "RPC ошибка: " + response.substr(error_start, error_end - error_start + 1)});
-            }
-        }
-        
-        return response;
+        return finish_call(curl, res, buffers.response);
     }
     
     Result<void> ping() {
@@ -189,4 +231,188 @@ const std::string& AuxRpcClient::url() const noexcept {
     return impl_->url;
 }
 
+// =============================================================================
+// AuxRpcMulti
+// =============================================================================
+
+struct AuxRpcMulti::Impl {
+    CURLM* multi{nullptr};
+    
+    // Easy handles и буферы переиспользуются: соединения с нодами
+    // остаются открытыми (keep-alive) между вызовами perform() / run()
+    std::vector<CURL*> handles;
+    std::vector<CallBuffers> buffers;
+    
+    Impl() {
+        ensure_curl_init();
+        multi = curl_multi_init();
+    }
+    
+    ~Impl() {
+        for (auto* handle : handles) {
+            curl_easy_cleanup(handle);
+        }
+        if (multi) {
+            curl_multi_cleanup(multi);
+        }
+    }
+    
+    void reserve(std::size_t count) {
+        while (handles.size() < count) {
+            handles.push_back(curl_easy_init());
+        }
+        if (buffers.size() < count) {
+            buffers.resize(count);
+        }
+    }
+    
+    void start(std::size_t index, const AuxRpcRequest& request) {
+        const auto& client = *request.client->impl_;
+        prepare_call(handles[index], client.url, client.auth, client.headers,
+                     static_cast<long>(request.deadline.count()),
+                     request.method, request.params, buffers[index]);
+        curl_easy_setopt(handles[index], CURLOPT_PRIVATE, reinterpret_cast<char*>(index));
+        curl_multi_add_handle(multi, handles[index]);
+    }
+    
+    void perform(std::span<const AuxRpcRequest> requests, const Completion& on_complete) {
+        reserve(requests.size());
+        
+        std::size_t active = 0;
+        for (std::size_t i = 0; i < requests.size(); ++i) {
+            const auto& request = requests[i];
+            if (!multi || !handles[i] || !request.client) {
+                on_complete(i, std::unexpected(Error{ErrorCode::RpcConnectionFailed,
+                    "CURL не инициализирован"}));
+                continue;
+            }
+            start(i, request);
+            ++active;
+        }
+        
+        // Один цикл на все transfers; таймауты - CURLOPT_TIMEOUT_MS
+        int running = 0;
+        while (active > 0) {
+            curl_multi_perform(multi, &running);
+            
+            int queued = 0;
+            while (CURLMsg* msg = curl_multi_info_read(multi, &queued)) {
+                if (msg->msg != CURLMSG_DONE) {
+                    continue;
+                }
+                char* tag = nullptr;
+                curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE, &tag);
+                const auto index = reinterpret_cast<std::size_t>(tag);
+                const CURLcode res = msg->data.result;
+                
+                curl_multi_remove_handle(multi, msg->easy_handle);
+                --active;
+                on_complete(index, finish_call(msg->easy_handle, res, buffers[index].response));
+            }
+            
+            if (active > 0) {
+                curl_multi_poll(multi, nullptr, 0, 100, nullptr);
+            }
+        }
+    }
+    
+    void run(std::span<AuxRpcRequest> requests, const Rearm& on_complete,
+             const std::atomic<bool>& running) {
+        using Clock = std::chrono::steady_clock;
+        
+        reserve(requests.size());
+        
+        // Время следующего старта; nullopt - запрос в полёте или снят
+        std::vector<std::optional<Clock::time_point>> start_at(requests.size(), Clock::now());
+        std::vector<bool> in_flight(requests.size(), false);
+        std::size_t live = requests.size();
+        
+        int running_handles = 0;
+        while (running && live > 0) {
+            const auto now = Clock::now();
+            for (std::size_t i = 0; i < requests.size(); ++i) {
+                if (!start_at[i] || *start_at[i] > now) {
+                    continue;
+                }
+                start_at[i].reset();
+                const auto& request = requests[i];
+                if (!multi || !handles[i] || !request.client) {
+                    --live;
+                    continue;
+                }
+                start(i, request);
+                in_flight[i] = true;
+            }
+            
+            curl_multi_perform(multi, &running_handles);
+            
+            int queued = 0;
+            while (CURLMsg* msg = curl_multi_info_read(multi, &queued)) {
+                if (msg->msg != CURLMSG_DONE) {
+                    continue;
+                }
+                char* tag = nullptr;
+                curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE, &tag);
+                const auto index = reinterpret_cast<std::size_t>(tag);
+                const CURLcode res = msg->data.result;
+                
+                curl_multi_remove_handle(multi, msg->easy_handle);
+                in_flight[index] = false;
+                auto pause = on_complete(index, finish_call(msg->easy_handle, res,
+                                                            buffers[index].response));
+                if (pause) {
+                    start_at[index] = Clock::now() + *pause;
+                } else {
+                    --live;
+                }
+            }
+            
+            curl_multi_poll(multi, nullptr, 0, 100, nullptr);
+        }
+        
+        // Остановка: незавершённые transfers обрываются
+        for (std::size_t i = 0; i < requests.size(); ++i) {
+            if (in_flight[i]) {
+                curl_multi_remove_handle(multi, handles[i]);
+            }
+        }
+    }
+};
+
+AuxRpcMulti::AuxRpcMulti() : impl_(std::make_unique<Impl>()) {}
+
+AuxRpcMulti::~AuxRpcMulti() = default;
+
+void AuxRpcMulti::perform(std::span<const AuxRpcRequest> requests, const Completion& on_complete) {
+    impl_->perform(requests, on_complete);
+}
+
+void AuxRpcMulti::run(std::span<AuxRpcRequest> requests, const Rearm& on_complete,
+                      const std::atomic<bool>& running) {
+    impl_->run(requests, on_complete, running);
+}
+
+// =============================================================================
+// getblocktemplate longpoll
+// =============================================================================
+
+std::string longpoll_params(std::string_view longpoll_id) {
+    std::string params = R"([{"rules":["segwit"])";
+    if (!longpoll_id.empty()) {
+        params += R"(,"longpollid":")";
+        params += longpoll_id;
+        params += '"';
+    }
+    params += "}]";
+    return params;
+}
+
+std::optional<std::string> find_longpoll_id(std::string_view response) {
+    auto longpoll_id = core::json::Value::parse(response)["result"]["longpollid"].as_string();
+    if (!longpoll_id || longpoll_id->empty()) {
+        return std::nullopt;
+    }
+    return std::string(*longpoll_id);
+}
+
 } // namespace quaxis::merged
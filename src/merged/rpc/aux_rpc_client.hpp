@@ -4,22 +4,36 @@
  * 
  * Универсальный RPC клиент для взаимодействия с нодами auxiliary chains.
  * Поддерживает JSON-RPC и REST API.
+ * 
+ * AuxRpcMulti выполняет вызовы нескольких клиентов параллельно в одном
+ * цикле curl_multi: медленная нода не задерживает ответы остальных.
+ * AuxRpcMulti::run() держит запросы активными постоянно - на нём
+ * построены уведомления о новом блоке через getblocktemplate longpoll.
  */
 
 #pragma once
 
 #include "../../core/types.hpp"
 
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <optional>
+#include <span>
 #include <string>
 #include <memory>
 
 namespace quaxis::merged {
 
+class AuxRpcMulti;
+
 /**
  * @brief RPC клиент для auxiliary chains
  * 
  * Асинхронный HTTP/HTTPS клиент для вызова RPC методов
- * auxiliary chain нод.
+ * auxiliary chain нод. Заголовки собираются один раз, easy handle и
+ * буфер запроса переиспользуются: соединение с нодой остаётся
+ * открытым (keep-alive) между вызовами.
  */
 class AuxRpcClient {
 public:
@@ -72,6 +86,104 @@ public:
      */
     [[nodiscard]] const std::string& url() const noexcept;
     
+private:
+    friend class AuxRpcMulti;
+    
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+/**
+ * @brief Вызов для AuxRpcMulti
+ */
+struct AuxRpcRequest {
+    /// @brief Клиент (URL и авторизация), живёт до конца perform() / run()
+    const AuxRpcClient* client{nullptr};
+    
+    /// @brief Имя метода
+    std::string method;
+    
+    /// @brief JSON параметры
+    std::string params{"[]"};
+    
+    /// @brief Крайний срок ответа от старта запроса
+    std::chrono::milliseconds deadline{1000};
+};
+
+// =============================================================================
+// getblocktemplate longpoll (BIP 22)
+// =============================================================================
+
+/// @brief Крайний срок longpoll запроса: нода держит его до нового блока
+inline constexpr std::chrono::milliseconds LONGPOLL_DEADLINE{120000};
+
+/**
+ * @brief Параметры getblocktemplate с longpollid
+ * 
+ * @param longpoll_id Идентификатор из прошлого ответа (пустой - первый
+ *        запрос, нода отвечает сразу)
+ * @return JSON массив параметров
+ */
+[[nodiscard]] std::string longpoll_params(std::string_view longpoll_id);
+
+/**
+ * @brief Найти longpollid в ответе getblocktemplate
+ * 
+ * @param response JSON ответ
+ * @return Идентификатор или nullopt (нода не поддерживает longpoll)
+ */
+[[nodiscard]] std::optional<std::string> find_longpoll_id(std::string_view response);
+
+/**
+ * @brief Параллельное выполнение RPC вызовов (curl_multi)
+ * 
+ * Все запросы стартуют сразу, результат каждого отдаётся callback по
+ * завершении, не дожидаясь остальных. Запрос, не успевший к deadline,
+ * завершается ошибкой таймаута. Соединения с нодами переиспользуются
+ * между вызовами perform().
+ * 
+ * Thread-safety: один поток на экземпляр.
+ */
+class AuxRpcMulti {
+public:
+    /// @brief Callback завершения: индекс запроса и ответ или ошибка
+    using Completion = std::function<void(std::size_t index, Result<std::string> response)>;
+    
+    AuxRpcMulti();
+    ~AuxRpcMulti();
+    
+    AuxRpcMulti(const AuxRpcMulti&) = delete;
+    AuxRpcMulti& operator=(const AuxRpcMulti&) = delete;
+    
+    /**
+     * @brief Выполнить запросы параллельно
+     * 
+     * Возвращает, когда завершены все запросы (ответ, ошибка или deadline).
+     * 
+     * @param requests Запросы
+     * @param on_complete Вызывается из этого потока для каждого запроса
+     */
+    void perform(std::span<const AuxRpcRequest> requests, const Completion& on_complete);
+    
+    /// @brief Callback run(): пауза до повторного запуска запроса, nullopt - снять запрос
+    using Rearm = std::function<std::optional<std::chrono::milliseconds>(
+        std::size_t index, Result<std::string> response)>;
+    
+    /**
+     * @brief Держать запросы активными, пока running
+     * 
+     * Завершившийся запрос отдаётся callback и запускается снова через
+     * возвращённую паузу; requests[index] читается заново, callback может
+     * поменять params (например, longpollid). Возвращает, когда running
+     * сброшен (проверка - не реже раза в 100 мс) или сняты все запросы.
+     * 
+     * @param requests Запросы
+     * @param on_complete Вызывается из этого потока
+     * @param running Флаг работы
+     */
+    void run(std::span<AuxRpcRequest> requests, const Rearm& on_complete,
+             const std::atomic<bool>& running);
+    
 private:
     struct Impl;
     std::unique_ptr<Impl> impl_;
@@ -0,0 +1,184 @@
+/**
+ * @file template_cache.cpp
+ * @brief Реализация файлового кеша aux шаблонов
+ */
+
+#include "template_cache.hpp"
+#include "../core/byte_order.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <format>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace quaxis::merged {
+
+namespace {
+
+constexpr std::array<uint8_t, 8> MAGIC = {'Q', 'X', 'A', 'U', 'X', 'T', 'P', 'L'};
+constexpr uint32_t VERSION = 1;
+
+/// @brief Заголовок файла: magic, версия, число слотов
+constexpr std::size_t HEADER_SIZE = 64;
+constexpr std::size_t FILE_SIZE = HEADER_SIZE + TemplateCache::MAX_SLOTS * TemplateCache::SLOT_SIZE;
+
+// Поля слота
+constexpr std::size_t NAME_OFFSET = 0;
+constexpr std::size_t BLOCK_HASH_OFFSET = 32;
+constexpr std::size_t CHAIN_ID_OFFSET = 64;
+constexpr std::size_t BITS_OFFSET = 96;
+constexpr std::size_t HEIGHT_OFFSET = 100;
+constexpr std::size_t SAVED_AT_OFFSET = 104;
+constexpr std::size_t CHECKSUM_OFFSET = TemplateCache::SLOT_SIZE - 8;
+
+/**
+ * @brief FNV-1a 64 по полям слота (0 - пустой слот, поэтому не бывает 0)
+ */
+uint64_t slot_checksum(const uint8_t* slot) noexcept {
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    for (std::size_t i = 0; i < CHECKSUM_OFFSET; ++i) {
+        hash = (hash ^ slot[i]) * 0x100000001B3ULL;
+    }
+    return hash == 0 ? 1 : hash;
+}
+
+std::string_view slot_name(const uint8_t* slot) noexcept {
+    const auto* name = reinterpret_cast<const char*>(slot + NAME_OFFSET);
+    return {name, strnlen(name, TemplateCache::MAX_NAME + 1)};
+}
+
+} // anonymous namespace
+
+TemplateCache::~TemplateCache() {
+    close();
+}
+
+void TemplateCache::close() noexcept {
+    if (map_) {
+        munmap(map_, FILE_SIZE);
+        map_ = nullptr;
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+Result<void> TemplateCache::open(const std::string& path) {
+    close();
+
+    auto fail = [this, &path](const char* what) -> Result<void> {
+        int err = errno;
+        close();
+        return Err<void>(ErrorCode::SystemIOError,
+                         std::format("{} {}: {}", what, path, strerror(err)));
+    };
+
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd_ < 0) {
+        return fail("Не удалось открыть кеш aux шаблонов");
+    }
+    struct stat st{};
+    if (fstat(fd_, &st) < 0) {
+        return fail("fstat");
+    }
+    const bool sized = static_cast<std::size_t>(st.st_size) == FILE_SIZE;
+    if (!sized && ftruncate(fd_, static_cast<off_t>(FILE_SIZE)) < 0) {
+        return fail("ftruncate");
+    }
+    void* ptr = mmap(nullptr, FILE_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (ptr == MAP_FAILED) {
+        return fail("mmap");
+    }
+    map_ = static_cast<uint8_t*>(ptr);
+
+    // Новый файл или другой формат - пустой кеш
+    if (!sized || !std::equal(MAGIC.begin(), MAGIC.end(), map_) ||
+        read_le32(map_ + 8) != VERSION || read_le32(map_ + 12) != MAX_SLOTS) {
+        std::memset(map_, 0, FILE_SIZE);
+        std::copy(MAGIC.begin(), MAGIC.end(), map_);
+        write_le32(map_ + 8, VERSION);
+        write_le32(map_ + 12, static_cast<uint32_t>(MAX_SLOTS));
+    }
+    return {};
+}
+
+uint8_t* TemplateCache::slot(std::size_t index) const noexcept {
+    return map_ + HEADER_SIZE + index * SLOT_SIZE;
+}
+
+std::optional<std::size_t> TemplateCache::find_slot(std::string_view chain_name) const noexcept {
+    for (std::size_t i = 0; i < MAX_SLOTS; ++i) {
+        if (read_le64(slot(i) + CHECKSUM_OFFSET) != 0 && slot_name(slot(i)) == chain_name) {
+            return i;
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<CachedTemplate> TemplateCache::load(std::string_view chain_name) const {
+    if (!map_) {
+        return std::nullopt;
+    }
+    auto index = find_slot(chain_name);
+    if (!index) {
+        return std::nullopt;
+    }
+    const uint8_t* entry = slot(*index);
+    if (read_le64(entry + CHECKSUM_OFFSET) != slot_checksum(entry)) {
+        return std::nullopt;
+    }
+
+    CachedTemplate cached;
+    auto& tmpl = cached.block_template;
+    std::copy_n(entry + BLOCK_HASH_OFFSET, tmpl.block_hash.size(), tmpl.block_hash.begin());
+    std::copy_n(entry + CHAIN_ID_OFFSET, tmpl.chain_id.size(), tmpl.chain_id.begin());
+    tmpl.target_bits = read_le32(entry + BITS_OFFSET);
+    tmpl.height = read_le32(entry + HEIGHT_OFFSET);
+    tmpl.from_cache = true;
+    cached.saved_at = std::chrono::system_clock::time_point(
+        std::chrono::seconds(read_le64(entry + SAVED_AT_OFFSET)));
+    return cached;
+}
+
+bool TemplateCache::store(
+    std::string_view chain_name,
+    const AuxBlockTemplate& block_template,
+    std::chrono::system_clock::time_point saved_at
+) {
+    if (!map_ || chain_name.empty() || chain_name.size() > MAX_NAME) {
+        return false;
+    }
+    auto index = find_slot(chain_name);
+    if (!index) {
+        for (std::size_t i = 0; i < MAX_SLOTS && !index; ++i) {
+            if (read_le64(slot(i) + CHECKSUM_OFFSET) == 0) {
+                index = i;
+            }
+        }
+        if (!index) {
+            return false;
+        }
+    }
+
+    // Сумма обнуляется первой: оборванная запись не пройдёт проверку
+    uint8_t* entry = slot(*index);
+    write_le64(entry + CHECKSUM_OFFSET, 0);
+    std::memset(entry, 0, CHECKSUM_OFFSET);
+    std::copy(chain_name.begin(), chain_name.end(), entry + NAME_OFFSET);
+    std::copy(block_template.block_hash.begin(), block_template.block_hash.end(), entry + BLOCK_HASH_OFFSET);
+    std::copy(block_template.chain_id.begin(), block_template.chain_id.end(), entry + CHAIN_ID_OFFSET);
+    write_le32(entry + BITS_OFFSET, block_template.target_bits);
+    write_le32(entry + HEIGHT_OFFSET, block_template.height);
+    write_le64(entry + SAVED_AT_OFFSET, static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::seconds>(saved_at.time_since_epoch()).count()));
+    write_le64(entry + CHECKSUM_OFFSET, slot_checksum(entry));
+    return true;
+}
+
+} // namespace quaxis::merged
@@ -0,0 +1,96 @@
+/**
+ * @file template_cache.hpp
+ * @brief Кеш последних aux шаблонов между запусками
+ *
+ * После перезапуска aux commitment появлялся, только когда ноды chains
+ * ответят на createauxblock: первые задания шли без merged mining. Кеш
+ * хранит последний шаблон каждой chain (block_hash, chain_id, bits,
+ * высота, время) в небольшом файле, отображённом mmap: ChainManager
+ * строит commitment из кеша сразу при создании, помечая шаблоны как
+ * возможно устаревшие, а опрос chains подтверждает или заменяет их.
+ *
+ * Файл: заголовок (magic, версия, число слотов) и MAX_SLOTS слотов по
+ * SLOT_SIZE байт, слот chain ищется по имени. Запись - в отображённую
+ * память без fsync (данные переживают падение процесса через page
+ * cache); слот с оборванной записью отбрасывается по контрольной сумме.
+ */
+
+#pragma once
+
+#include "chain_interface.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace quaxis::merged {
+
+/**
+ * @brief Шаблон из кеша
+ */
+struct CachedTemplate {
+    AuxBlockTemplate block_template;
+
+    /// @brief Когда шаблон был получен от ноды
+    std::chrono::system_clock::time_point saved_at;
+};
+
+/**
+ * @brief Файловый кеш aux шаблонов
+ *
+ * Thread-safety: нет, ChainManager вызывает под templates_mutex.
+ */
+class TemplateCache {
+public:
+    /// @brief Слотов (chains) в файле
+    static constexpr std::size_t MAX_SLOTS = 64;
+
+    /// @brief Размер слота
+    static constexpr std::size_t SLOT_SIZE = 128;
+
+    /// @brief Наибольшая длина имени chain в слоте
+    static constexpr std::size_t MAX_NAME = 31;
+
+    TemplateCache() = default;
+    ~TemplateCache();
+
+    TemplateCache(const TemplateCache&) = delete;
+    TemplateCache& operator=(const TemplateCache&) = delete;
+
+    /**
+     * @brief Открыть или создать файл кеша
+     *
+     * Файл другого формата перезаписывается пустым кешем.
+     */
+    [[nodiscard]] Result<void> open(const std::string& path);
+
+    [[nodiscard]] bool is_open() const noexcept { return map_ != nullptr; }
+
+    /**
+     * @brief Последний шаблон chain
+     *
+     * @return nullopt - нет слота chain или запись повреждена
+     */
+    [[nodiscard]] std::optional<CachedTemplate> load(std::string_view chain_name) const;
+
+    /**
+     * @brief Сохранить шаблон chain
+     *
+     * @return false - кеш закрыт, имя длиннее MAX_NAME или слоты кончились
+     */
+    bool store(std::string_view chain_name, const AuxBlockTemplate& block_template,
+               std::chrono::system_clock::time_point saved_at = std::chrono::system_clock::now());
+
+private:
+    [[nodiscard]] uint8_t* slot(std::size_t index) const noexcept;
+    [[nodiscard]] std::optional<std::size_t> find_slot(std::string_view chain_name) const noexcept;
+    void close() noexcept;
+
+    int fd_{-1};
+    uint8_t* map_{nullptr};
+};
+
+} // namespace quaxis::merged
@@ -0,0 +1,262 @@
+/**
+ * @file metrics_server.cpp
+ * @brief Реализация HTTP endpoint /metrics
+ */
+
+#include "metrics_server.hpp"
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <cerrno>
+#include <cstring>
+
+#include <atomic>
+#include <format>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace quaxis::metrics {
+
+namespace {
+
+/// @brief Таймаут poll цикла (мс) - задержка реакции на stop()
+constexpr int POLL_TIMEOUT_MS = 100;
+
+/// @brief Сколько ждать запрос от клиента (мс)
+constexpr int REQUEST_TIMEOUT_MS = 1000;
+
+/// @brief Максимальный размер заголовков запроса
+constexpr std::size_t MAX_REQUEST_SIZE = 8192;
+
+/**
+ * @brief Отправить буфер целиком (блокирующий сокет)
+ */
+void send_all(int fd, std::string_view data) {
+    while (!data.empty()) {
+        ssize_t sent = send(fd, data.data(), data.size(), MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR) {
+            continue;
+        }
+        if (sent <= 0) {
+            return;
+        }
+        data.remove_prefix(static_cast<std::size_t>(sent));
+    }
+}
+
+/**
+ * @brief HTTP ответ с закрытием соединения
+ */
+std::string http_response(std::string_view status, std::string_view content_type, std::string_view body) {
+    return std::format(
+        "HTTP/1.1 {}\r\n"
+        "Content-Type: {}\r\n"
+        "Content-Length: {}\r\n"
+        "Connection: close\r\n"
+        "\r\n"
+        "{}",
+        status, content_type, body.size(), body
+    );
+}
+
+/**
+ * @brief Путь запроса "GET /path HTTP/1.x" без query string
+ *
+ * @return Путь или пустая строка для не-GET запросов
+ */
+std::string_view request_path(std::string_view request) {
+    constexpr std::string_view GET = "GET ";
+    if (!request.starts_with(GET)) {
+        return {};
+    }
+    request.remove_prefix(GET.size());
+    auto end = request.find_first_of(" ?\r\n");
+    return request.substr(0, end);
+}
+
+} // anonymous namespace
+
+// =============================================================================
+// Impl
+// =============================================================================
+
+struct MetricsServer::Impl {
+    MetricsConfig config;
+
+    int listen_fd = -1;
+    std::atomic<uint16_t> bound_port{0};
+    std::atomic<bool> running{false};
+    std::thread thread;
+
+    mutable std::mutex sources_mutex;
+    std::vector<MetricsSource> sources;
+
+    explicit Impl(const MetricsConfig& cfg) : config(cfg) {}
+
+    ~Impl() {
+        stop();
+    }
+
+    Result<void> start() {
+        if (running.load(std::memory_order_relaxed)) {
+            return {};
+        }
+
+        listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (listen_fd < 0) {
+            return Err<void>(
+                ErrorCode::NetworkConnectionFailed,
+                std::format("Не удалось создать сокет метрик: {}", strerror(errno))
+            );
+        }
+
+        int opt = 1;
+        setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+
+        struct sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(config.port);
+        if (config.bind_address == "0.0.0.0") {
+            addr.sin_addr.s_addr = INADDR_ANY;
+        } else if (inet_pton(AF_INET, config.bind_address.c_str(), &addr.sin_addr) != 1) {
+            close_listen();
+            return Err<void>(
+                ErrorCode::NetworkConnectionFailed,
+                std::format("Некорректный адрес метрик: {}", config.bind_address)
+            );
+        }
+
+        if (bind(listen_fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0 ||
+            listen(listen_fd, 16) < 0) {
+            int err = errno;
+            close_listen();
+            return Err<void>(
+                ErrorCode::NetworkConnectionFailed,
+                std::format("Не удалось открыть {}:{} для метрик: {}",
+                           config.bind_address, config.port, strerror(err))
+            );
+        }
+
+        int flags = fcntl(listen_fd, F_GETFL, 0);
+        fcntl(listen_fd, F_SETFL, flags | O_NONBLOCK);
+
+        socklen_t len = sizeof(addr);
+        if (getsockname(listen_fd, reinterpret_cast<struct sockaddr*>(&addr), &len) == 0) {
+            bound_port.store(ntohs(addr.sin_port), std::memory_order_relaxed);
+        }
+
+        running.store(true, std::memory_order_relaxed);
+        thread = std::thread([this] { serve_loop(); });
+        return {};
+    }
+
+    void stop() {
+        running.store(false, std::memory_order_relaxed);
+        if (thread.joinable()) {
+            thread.join();
+        }
+        close_listen();
+    }
+
+    void close_listen() {
+        if (listen_fd >= 0) {
+            close(listen_fd);
+            listen_fd = -1;
+        }
+    }
+
+    std::string render() const {
+        MetricsWriter writer;
+        std::lock_guard<std::mutex> lock(sources_mutex);
+        for (const auto& source : sources) {
+            source(writer);
+        }
+        return writer.take();
+    }
+
+    void serve_loop() {
+        while (running.load(std::memory_order_relaxed)) {
+            struct pollfd pfd{listen_fd, POLLIN, 0};
+            int rc = poll(&pfd, 1, POLL_TIMEOUT_MS);
+            if (rc <= 0) {
+                continue;
+            }
+            for (;;) {
+                int client = accept(listen_fd, nullptr, nullptr);
+                if (client < 0) {
+                    break;  // EAGAIN - очередь пуста
+                }
+                handle_client(client);
+                close(client);
+            }
+        }
+    }
+
+    void handle_client(int fd) {
+        // Принятый сокет наследует O_NONBLOCK не везде - ждём данные через poll
+        std::string request;
+        char buf[1024];
+        while (request.find("\r\n\r\n") == std::string::npos && request.size() < MAX_REQUEST_SIZE) {
+            struct pollfd pfd{fd, POLLIN, 0};
+            if (poll(&pfd, 1, REQUEST_TIMEOUT_MS) <= 0) {
+                return;
+            }
+            ssize_t n = recv(fd, buf, sizeof(buf), MSG_DONTWAIT);
+            if (n < 0 && (errno == EAGAIN || errno == EINTR)) {
+                continue;
+            }
+            if (n <= 0) {
+                return;
+            }
+            request.append(buf, static_cast<std::size_t>(n));
+        }
+
+        // Ответ пишется блокирующим send: тело метрик - десятки КБ
+        int flags = fcntl(fd, F_GETFL, 0);
+        fcntl(fd, F_SETFL, flags & ~O_NONBLOCK);
+
+        if (request_path(request) == "/metrics") {
+            send_all(fd, http_response("200 OK", "text/plain; version=0.0.4; charset=utf-8", render()));
+        } else {
+            send_all(fd, http_response("404 Not Found", "text/plain", "Not Found\n"));
+        }
+    }
+};
+
+// =============================================================================
+// Публичный API
+// =============================================================================
+
+MetricsServer::MetricsServer(const MetricsConfig& config)
+    : impl_(std::make_unique<Impl>(config)) {}
+
+MetricsServer::~MetricsServer() = default;
+
+void MetricsServer::add_source(MetricsSource source) {
+    std::lock_guard<std::mutex> lock(impl_->sources_mutex);
+    impl_->sources.push_back(std::move(source));
+}
+
+Result<void> MetricsServer::start() {
+    return impl_->start();
+}
+
+void MetricsServer::stop() {
+    impl_->stop();
+}
+
+uint16_t MetricsServer::port() const noexcept {
+    return impl_->bound_port.load(std::memory_order_relaxed);
+}
+
+std::string MetricsServer::render() const {
+    return impl_->render();
+}
+
+} // namespace quaxis::metrics
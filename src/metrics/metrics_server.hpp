@@ -0,0 +1,82 @@
+/**
+ * @file metrics_server.hpp
+ * @brief HTTP endpoint /metrics для Prometheus
+ *
+ * Минимальный HTTP/1.0 сервер в собственном потоке: неблокирующий
+ * listen сокет, poll с таймаутом 100 мс, один запрос на соединение.
+ * Запросы обслуживаются последовательно - scrape раз в несколько секунд
+ * не требует большего.
+ *
+ * Источники метрик читают lock-free снимки подсистем (Seqlock,
+ * атомарные счётчики), поэтому scrape не задерживает горячие потоки.
+ */
+
+#pragma once
+
+#include "openmetrics.hpp"
+#include "../core/config.hpp"
+#include "../core/types.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+namespace quaxis::metrics {
+
+/**
+ * @brief Источник метрик: дописывает свои семейства в writer
+ *
+ * Вызывается из потока сервера метрик.
+ */
+using MetricsSource = std::function<void(MetricsWriter&)>;
+
+/**
+ * @brief Сервер метрик
+ */
+class MetricsServer {
+public:
+    /**
+     * @brief Создать сервер
+     *
+     * @param config Адрес и порт (port = 0 - выбирает ядро)
+     */
+    explicit MetricsServer(const MetricsConfig& config);
+
+    ~MetricsServer();
+
+    MetricsServer(const MetricsServer&) = delete;
+    MetricsServer& operator=(const MetricsServer&) = delete;
+
+    /**
+     * @brief Добавить источник (можно и после start)
+     */
+    void add_source(MetricsSource source);
+
+    /**
+     * @brief Открыть сокет и запустить поток
+     *
+     * @return Result<void> Успех или NetworkConnectionFailed
+     */
+    [[nodiscard]] Result<void> start();
+
+    /**
+     * @brief Остановить поток и закрыть сокет
+     */
+    void stop();
+
+    /**
+     * @brief Фактический порт прослушивания (после start)
+     */
+    [[nodiscard]] uint16_t port() const noexcept;
+
+    /**
+     * @brief Текст метрик всех источников (то, что отдаёт /metrics)
+     */
+    [[nodiscard]] std::string render() const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace quaxis::metrics
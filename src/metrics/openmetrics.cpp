@@ -0,0 +1,129 @@
+/**
+ * @file openmetrics.cpp
+ * @brief Реализация MetricsWriter
+ */
+
+#include "openmetrics.hpp"
+
+#include <charconv>
+#include <cmath>
+#include <format>
+
+namespace quaxis::metrics {
+
+namespace {
+
+/**
+ * @brief Значение образца: кратчайшая точная запись (целые - без дробной части)
+ */
+std::string format_value(double value) {
+    if (std::isnan(value)) {
+        return "NaN";
+    }
+    if (std::isinf(value)) {
+        return value > 0 ? "+Inf" : "-Inf";
+    }
+    char buf[32];
+    auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), value);
+    return ec == std::errc{} ? std::string(buf, end) : std::string("NaN");
+}
+
+/**
+ * @brief Значение метки le: %g-запись ("0.0005", "1e-05")
+ */
+std::string format_bound(double bound) {
+    char buf[32];
+    auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), bound, std::chars_format::general);
+    return ec == std::errc{} ? std::string(buf, end) : format_value(bound);
+}
+
+constexpr double NS_PER_SECOND = 1e9;
+
+} // anonymous namespace
+
+std::string escape_label_value(std::string_view value) {
+    std::string escaped;
+    escaped.reserve(value.size());
+    for (char c : value) {
+        switch (c) {
+            case '\\': escaped += "\\\\"; break;
+            case '"':  escaped += "\\\""; break;
+            case '\n': escaped += "\\n"; break;
+            default:   escaped += c; break;
+        }
+    }
+    return escaped;
+}
+
+// =============================================================================
+// MetricsWriter
+// =============================================================================
+
+void MetricsWriter::counter(std::string_view name, std::string_view help, double value, Labels labels) {
+    declare(name, help, "counter");
+    sample(name, labels, value);
+}
+
+void MetricsWriter::gauge(std::string_view name, std::string_view help, double value, Labels labels) {
+    declare(name, help, "gauge");
+    sample(name, labels, value);
+}
+
+void MetricsWriter::histogram(
+    std::string_view name,
+    std::string_view help,
+    const core::LatencyHistogram& histogram,
+    Labels labels
+) {
+    declare(name, help, "histogram");
+
+    const std::string bucket = std::format("{}_bucket", name);
+    for (double bound : LATENCY_BUCKETS_SECONDS) {
+        auto bound_ns = static_cast<uint64_t>(bound * NS_PER_SECOND);
+        sample(bucket, labels, static_cast<double>(histogram.count_at_most(bound_ns)),
+               "le", format_bound(bound));
+    }
+    sample(bucket, labels, static_cast<double>(histogram.count()), "le", "+Inf");
+    sample(std::format("{}_sum", name), labels,
+           static_cast<double>(histogram.sum()) / NS_PER_SECOND);
+    sample(std::format("{}_count", name), labels, static_cast<double>(histogram.count()));
+}
+
+std::string MetricsWriter::take() noexcept {
+    declared_.clear();
+    return std::move(out_);
+}
+
+void MetricsWriter::declare(std::string_view name, std::string_view help, std::string_view type) {
+    if (!declared_.emplace(name).second) {
+        return;
+    }
+    out_ += std::format("# HELP {} {}\n# TYPE {} {}\n", name, help, name, type);
+}
+
+void MetricsWriter::sample(
+    std::string_view name,
+    Labels labels,
+    double value,
+    std::string_view extra_name,
+    std::string_view extra_value
+) {
+    out_ += name;
+    if (labels.size() != 0 || !extra_name.empty()) {
+        out_ += '{';
+        bool first = true;
+        for (const auto& [label, label_value] : labels) {
+            out_ += std::format("{}{}=\"{}\"", first ? "" : ",", label, escape_label_value(label_value));
+            first = false;
+        }
+        if (!extra_name.empty()) {
+            out_ += std::format("{}{}=\"{}\"", first ? "" : ",", extra_name, extra_value);
+        }
+        out_ += '}';
+    }
+    out_ += ' ';
+    out_ += format_value(value);
+    out_ += '\n';
+}
+
+} // namespace quaxis::metrics
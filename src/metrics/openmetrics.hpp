@@ -0,0 +1,107 @@
+/**
+ * @file openmetrics.hpp
+ * @brief Формирование текста метрик Prometheus (text format 0.0.4)
+ *
+ * MetricsWriter собирает ответ /metrics: для каждого семейства один раз
+ * пишутся строки # HELP и # TYPE, затем образцы. Образцы одного
+ * семейства должны идти подряд (так требует формат), поэтому источники
+ * пишут метрику целиком - например, по всем соединениям - прежде чем
+ * переходить к следующей.
+ */
+
+#pragma once
+
+#include "../core/latency_trace.hpp"
+
+#include <array>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <utility>
+
+namespace quaxis::metrics {
+
+/**
+ * @brief Границы корзин histogram (секунды)
+ *
+ * От 10 мкс до 10 с: рассылка заданий занимает микросекунды, FIBRE
+ * реконструкция - сотни миллисекунд.
+ */
+inline constexpr std::array<double, 19> LATENCY_BUCKETS_SECONDS = {
+    0.00001, 0.000025, 0.00005,
+    0.0001, 0.00025, 0.0005,
+    0.001, 0.0025, 0.005,
+    0.01, 0.025, 0.05,
+    0.1, 0.25, 0.5,
+    1.0, 2.5, 5.0, 10.0
+};
+
+/**
+ * @brief Построитель текста метрик
+ */
+class MetricsWriter {
+public:
+    /// @brief Метки образца: пары (имя, значение)
+    using Labels = std::initializer_list<std::pair<std::string_view, std::string_view>>;
+
+    /**
+     * @brief Счётчик (монотонный, имя с суффиксом _total)
+     */
+    void counter(std::string_view name, std::string_view help, double value, Labels labels = {});
+
+    /**
+     * @brief Мгновенное значение
+     */
+    void gauge(std::string_view name, std::string_view help, double value, Labels labels = {});
+
+    /**
+     * @brief Histogram из LatencyHistogram (наносекунды -> секунды)
+     *
+     * Корзины LATENCY_BUCKETS_SECONDS кумулятивны с точностью до корзины
+     * исходной гистограммы (12.5%), _sum и _count точные.
+     */
+    void histogram(
+        std::string_view name,
+        std::string_view help,
+        const core::LatencyHistogram& histogram,
+        Labels labels = {}
+    );
+
+    /**
+     * @brief Накопленный текст
+     */
+    [[nodiscard]] const std::string& text() const noexcept { return out_; }
+
+    /**
+     * @brief Забрать текст (writer становится пустым)
+     */
+    [[nodiscard]] std::string take() noexcept;
+
+private:
+    /**
+     * @brief # HELP / # TYPE при первом образце семейства
+     */
+    void declare(std::string_view name, std::string_view help, std::string_view type);
+
+    /**
+     * @brief Строка образца: name{labels,extra} value
+     */
+    void sample(
+        std::string_view name,
+        Labels labels,
+        double value,
+        std::string_view extra_name = {},
+        std::string_view extra_value = {}
+    );
+
+    std::string out_;
+    std::unordered_set<std::string> declared_;
+};
+
+/**
+ * @brief Экранировать значение метки (\\, " и перевод строки)
+ */
+[[nodiscard]] std::string escape_label_value(std::string_view value);
+
+} // namespace quaxis::metrics
@@ -0,0 +1,321 @@
+/**
+ * @file shm_stats.hpp
+ * @brief Сегмент статистики в shared memory для внешних агентов
+ *
+ * Агенты мониторинга видели процесс только через экран статуса или
+ * HTTP /metrics: каждый опрос - соединение, разбор текста и работа
+ * потока метрик. QuaxisSharedStats - снимок статистики в /dev/shm,
+ * который агент читает с любой частотой без системных вызовов и без
+ * блокировок в майнере.
+ *
+ * Раскладка - как у QuaxisSharedRing, но слот один:
+ * - version - seqlock: нечётная во время записи, чётная после;
+ * - summary - сводка (сервер, relay, fallback, merged chains);
+ * - connections - первые summary.connection_count записей соединений.
+ * Содержимое копируется relaxed-операциями над std::atomic<uint64_t>
+ * между двумя чтениями версии. Читатель проверяет magic и
+ * layout_version: несовместимая раскладка получит новую версию.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace quaxis::metrics {
+
+// =============================================================================
+// Константы
+// =============================================================================
+
+/// @brief Сигнатура сегмента статистики ("QSTA")
+inline constexpr uint32_t SHM_STATS_MAGIC = 0x41545351;
+
+/// @brief Версия раскладки сегмента статистики
+inline constexpr uint32_t SHM_STATS_LAYOUT_VERSION = 1;
+
+/// @brief Записей соединений в сегменте (остальные не публикуются)
+inline constexpr std::size_t SHM_STATS_MAX_CONNECTIONS = 4096;
+
+/// @brief Записей merged chains в сегменте
+inline constexpr std::size_t SHM_STATS_MAX_CHAINS = 16;
+
+/// @brief Байт адреса соединения (с завершающим нулём)
+inline constexpr std::size_t SHM_STATS_ADDRESS_SIZE = 48;
+
+/// @brief Байт имени chain (с завершающим нулём)
+inline constexpr std::size_t SHM_STATS_NAME_SIZE = 32;
+
+/// @brief Значение fallback_mode: источник заданий не сообщался
+inline constexpr uint8_t SHM_STATS_MODE_UNKNOWN = 0xFF;
+
+// =============================================================================
+// Раскладка
+// =============================================================================
+
+/**
+ * @brief Соединение ASIC
+ */
+struct ShmStatsConnection {
+    char remote_address[SHM_STATS_ADDRESS_SIZE]{};
+    uint64_t shares_received{0};
+    uint64_t jobs_sent{0};
+    uint64_t connected_seconds{0};      ///< Время с подключения
+    uint32_t hashrate_ghs{0};           ///< Последний хешрейт из статуса ASIC
+    uint32_t rtt_us{0};                 ///< Сглаженный RTT (TCP_INFO)
+    uint32_t retransmits{0};
+    uint8_t temperature{0};
+    uint8_t reserved[3]{};
+};
+
+/**
+ * @brief Merged chain
+ */
+struct ShmStatsChain {
+    char name[SHM_STATS_NAME_SIZE]{};
+    uint64_t blocks_found{0};
+    uint32_t height{0};
+    uint8_t status{0};                  ///< merged::ChainStatus
+    uint8_t enabled{0};
+    uint8_t reserved[2]{};
+};
+
+/**
+ * @brief FIBRE relay
+ */
+struct ShmStatsRelay {
+    uint32_t active_peers{0};
+    uint32_t connected_peers{0};
+    uint64_t blocks_received{0};
+    uint64_t duplicate_blocks{0};
+    uint64_t reconstruction_timeouts{0};
+    uint64_t evicted_blocks{0};
+    uint64_t socket_drops{0};
+    uint64_t speculative_headers{0};
+    uint64_t invalid_blocks{0};
+    uint64_t header_p50_ns{0};
+    uint64_t header_p99_ns{0};
+    uint64_t reconstruction_p50_ns{0};
+    uint64_t reconstruction_p99_ns{0};
+};
+
+/**
+ * @brief Сводка процесса
+ */
+struct ShmStatsSummary {
+    uint64_t updated_ns{0};             ///< system_clock публикации, нс от эпохи
+    uint64_t started_ns{0};             ///< system_clock запуска процесса
+    uint32_t pid{0};
+    uint8_t fallback_mode{SHM_STATS_MODE_UNKNOWN};  ///< fallback::FallbackMode
+    uint8_t relay_enabled{0};
+    uint8_t reserved[2]{};
+
+    // Сервер ASIC
+    uint64_t total_connections{0};
+    uint64_t total_shares{0};
+    uint64_t total_jobs_sent{0};
+    uint64_t total_hashrate_ghs{0};
+    uint32_t active_connections{0};
+    uint32_t connection_count{0};       ///< Записей в connections (не больше SHM_STATS_MAX_CONNECTIONS)
+
+    ShmStatsRelay relay;
+
+    uint32_t chain_count{0};
+    uint32_t reserved2{0};
+    ShmStatsChain chains[SHM_STATS_MAX_CHAINS];
+};
+
+static_assert(std::is_trivially_copyable_v<ShmStatsSummary> && sizeof(ShmStatsSummary) % 8 == 0,
+              "ShmStatsSummary копируется словами uint64 под seqlock");
+static_assert(std::is_trivially_copyable_v<ShmStatsConnection> && sizeof(ShmStatsConnection) % 8 == 0,
+              "ShmStatsConnection копируется словами uint64 под seqlock");
+
+/**
+ * @brief Сегмент shared memory со снимком статистики
+ */
+struct alignas(64) QuaxisSharedStats {
+    /// @brief Слов под сводку
+    static constexpr std::size_t SUMMARY_WORDS = sizeof(ShmStatsSummary) / sizeof(uint64_t);
+
+    /// @brief Слов под одно соединение
+    static constexpr std::size_t CONNECTION_WORDS = sizeof(ShmStatsConnection) / sizeof(uint64_t);
+
+    /// @brief Seqlock: нечётная во время записи снимка, чётная после
+    std::atomic<uint64_t> version;
+
+    /// @brief SHM_STATS_MAGIC
+    uint32_t magic;
+
+    /// @brief SHM_STATS_LAYOUT_VERSION
+    uint32_t layout_version;
+
+    /// @brief SHM_STATS_MAX_CONNECTIONS
+    uint32_t max_connections;
+
+    /// @brief SHM_STATS_MAX_CHAINS
+    uint32_t max_chains;
+
+    alignas(64) std::atomic<uint64_t> summary[SUMMARY_WORDS];
+
+    alignas(64) std::atomic<uint64_t> connections[CONNECTION_WORDS * SHM_STATS_MAX_CONNECTIONS];
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "атомики в shared memory должны быть lock-free");
+
+/**
+ * @brief Проверить, что память - инициализированный сегмент статистики
+ */
+[[nodiscard]] inline bool is_shm_stats(const QuaxisSharedStats& segment) noexcept {
+    return segment.magic == SHM_STATS_MAGIC
+        && segment.layout_version == SHM_STATS_LAYOUT_VERSION
+        && segment.max_connections == SHM_STATS_MAX_CONNECTIONS
+        && segment.max_chains == SHM_STATS_MAX_CHAINS;
+}
+
+/**
+ * @brief Разметить обнулённую память как пустой сегмент статистики
+ */
+inline void init_shm_stats(QuaxisSharedStats& segment) noexcept {
+    segment.magic = SHM_STATS_MAGIC;
+    segment.layout_version = SHM_STATS_LAYOUT_VERSION;
+    segment.max_connections = static_cast<uint32_t>(SHM_STATS_MAX_CONNECTIONS);
+    segment.max_chains = static_cast<uint32_t>(SHM_STATS_MAX_CHAINS);
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+/**
+ * @brief Скопировать строку в поле фиксированной длины (с обрезкой)
+ */
+template<std::size_t N>
+inline void copy_shm_string(char (&field)[N], std::string_view text) noexcept {
+    const std::size_t size = std::min(text.size(), N - 1);
+    std::memcpy(field, text.data(), size);
+    std::memset(field + size, 0, N - size);
+}
+
+// =============================================================================
+// Писатель (майнер)
+// =============================================================================
+
+/**
+ * @brief Публикация снимков
+ *
+ * Писатель один: вызовы publish() не должны пересекаться.
+ */
+class ShmStatsWriter {
+public:
+    explicit ShmStatsWriter(QuaxisSharedStats& segment) noexcept : segment_(segment) {}
+
+    /**
+     * @brief Опубликовать снимок
+     *
+     * @param summary Сводка (connection_count заполняется здесь)
+     * @param connections Соединения (сверх SHM_STATS_MAX_CONNECTIONS не публикуются)
+     */
+    void publish(ShmStatsSummary& summary, std::span<const ShmStatsConnection> connections) noexcept {
+        const std::size_t count = std::min(connections.size(), SHM_STATS_MAX_CONNECTIONS);
+        summary.connection_count = static_cast<uint32_t>(count);
+        summary.chain_count = std::min<uint32_t>(summary.chain_count, SHM_STATS_MAX_CHAINS);
+
+        const uint64_t version = segment_.version.load(std::memory_order_relaxed);
+        segment_.version.store(version + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        store_words(segment_.summary, &summary, QuaxisSharedStats::SUMMARY_WORDS);
+        for (std::size_t i = 0; i < count; ++i) {
+            store_words(segment_.connections + i * QuaxisSharedStats::CONNECTION_WORDS,
+                        &connections[i], QuaxisSharedStats::CONNECTION_WORDS);
+        }
+
+        segment_.version.store(version + 2, std::memory_order_release);
+    }
+
+private:
+    static void store_words(std::atomic<uint64_t>* words, const void* data, std::size_t count) noexcept {
+        const auto* bytes = static_cast<const uint8_t*>(data);
+        for (std::size_t w = 0; w < count; ++w) {
+            uint64_t word;
+            std::memcpy(&word, bytes + w * sizeof(uint64_t), sizeof(word));
+            words[w].store(word, std::memory_order_relaxed);
+        }
+    }
+
+    QuaxisSharedStats& segment_;
+};
+
+// =============================================================================
+// Читатель (агент мониторинга)
+// =============================================================================
+
+/**
+ * @brief Чтение снимков без записи в сегмент
+ */
+class ShmStatsReader {
+public:
+    /// @brief Попыток чтения, пересекающихся с записью, до отказа
+    static constexpr unsigned MAX_ATTEMPTS = 1000;
+
+    explicit ShmStatsReader(const QuaxisSharedStats& segment) noexcept : segment_(segment) {}
+
+    /**
+     * @brief Прочитать последний целый снимок
+     *
+     * @return false - сегмент не размечен, снимка ещё нет или писатель
+     *         MAX_ATTEMPTS раз подряд пересёкся с чтением
+     */
+    [[nodiscard]] bool read(ShmStatsSummary& summary, std::vector<ShmStatsConnection>& connections) {
+        if (!is_shm_stats(segment_)) {
+            return false;
+        }
+        for (unsigned attempt = 0; attempt < MAX_ATTEMPTS; ++attempt) {
+            const uint64_t v1 = segment_.version.load(std::memory_order_acquire);
+            if (v1 == 0) {
+                return false;  // Ещё ни одной публикации
+            }
+            if ((v1 & 1) != 0) {
+                continue;
+            }
+            load_words(segment_.summary, &summary, QuaxisSharedStats::SUMMARY_WORDS);
+            // Счётчик из несогласованной копии не должен выйти за сегмент
+            const std::size_t count = std::min<std::size_t>(summary.connection_count, SHM_STATS_MAX_CONNECTIONS);
+            connections.resize(count);
+            for (std::size_t i = 0; i < count; ++i) {
+                load_words(segment_.connections + i * QuaxisSharedStats::CONNECTION_WORDS,
+                           &connections[i], QuaxisSharedStats::CONNECTION_WORDS);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (segment_.version.load(std::memory_order_relaxed) == v1) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Номер снимка (растёт на 2 с каждой публикацией)
+     */
+    [[nodiscard]] uint64_t version() const noexcept {
+        return segment_.version.load(std::memory_order_acquire);
+    }
+
+private:
+    static void load_words(const std::atomic<uint64_t>* words, void* data, std::size_t count) noexcept {
+        auto* bytes = static_cast<uint8_t*>(data);
+        for (std::size_t w = 0; w < count; ++w) {
+            const uint64_t word = words[w].load(std::memory_order_relaxed);
+            std::memcpy(bytes + w * sizeof(uint64_t), &word, sizeof(word));
+        }
+    }
+
+    const QuaxisSharedStats& segment_;
+};
+
+} // namespace quaxis::metrics
@@ -0,0 +1,230 @@
+/**
+ * @file shm_stats_export.cpp
+ * @brief Реализация публикации статистики в shared memory
+ */
+
+#include "shm_stats_export.hpp"
+
+#include "../network/server.hpp"
+#include "../relay/relay_manager.hpp"
+#include "../fallback/fallback_manager.hpp"
+#include "../shm/placement.hpp"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <format>
+
+namespace quaxis::metrics {
+
+namespace {
+
+uint64_t system_ns() noexcept {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
+} // anonymous namespace
+
+struct ShmStatsExporter::Impl {
+    std::string path;
+    shm::SegmentPlacement placement;
+
+    int fd = -1;
+    void* map = nullptr;
+    std::size_t map_size = 0;
+    std::unique_ptr<ShmStatsWriter> writer;
+
+    std::vector<ShmStatsSource> sources;
+    const uint64_t started_ns = system_ns();
+
+    // Буферы снимка переиспользуются между публикациями
+    ShmStatsSummary summary{};
+    std::vector<ShmStatsConnection> connections;
+
+    explicit Impl(std::string segment_path) : path(std::move(segment_path)) {}
+
+    ~Impl() {
+        if (writer && owns_name()) {
+            (void)shm::unlink_segment(placement, path);
+        }
+        cleanup();
+    }
+    
+    /**
+     * @brief Имя сегмента всё ещё указывает на наш файл
+     *
+     * После передачи работы преемнику (handoff) тот создаёт сегмент
+     * заново под тем же именем - удалять его нельзя.
+     */
+    bool owns_name() const {
+        auto current = shm::open_segment(placement, path, O_RDONLY);
+        if (!current) {
+            return false;
+        }
+        struct stat ours{};
+        struct stat named{};
+        const bool same = fstat(fd, &ours) == 0 && fstat(*current, &named) == 0
+            && ours.st_dev == named.st_dev && ours.st_ino == named.st_ino;
+        close(*current);
+        return same;
+    }
+
+    void cleanup() {
+        writer.reset();
+        if (map && map != MAP_FAILED) {
+            munmap(map, map_size);
+        }
+        map = nullptr;
+        map_size = 0;
+        if (fd >= 0) {
+            close(fd);
+            fd = -1;
+        }
+    }
+};
+
+ShmStatsExporter::ShmStatsExporter(std::string path)
+    : impl_(std::make_unique<Impl>(std::move(path)))
+{
+}
+
+ShmStatsExporter::~ShmStatsExporter() = default;
+
+Result<void> ShmStatsExporter::open() {
+    impl_->cleanup();
+
+    // Сегмент прежнего процесса (в том числе старой раскладки) не переиспользуется:
+    // агенты, державшие его, увидят остановившийся updated_ns и откроют новый
+    (void)shm::unlink_segment(impl_->placement, impl_->path);
+    auto fd = shm::open_segment(impl_->placement, impl_->path, O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (!fd) {
+        return std::unexpected(fd.error());
+    }
+    impl_->fd = *fd;
+
+    impl_->map_size = shm::segment_map_length(impl_->fd, sizeof(QuaxisSharedStats));
+    if (ftruncate(impl_->fd, static_cast<off_t>(impl_->map_size)) < 0) {
+        int saved_errno = errno;
+        impl_->cleanup();
+        return Err<void>(
+            ErrorCode::ShmOpenFailed,
+            std::format("Не удалось установить размер сегмента статистики: {}", strerror(saved_errno))
+        );
+    }
+    void* ptr = mmap(nullptr, impl_->map_size, PROT_READ | PROT_WRITE, MAP_SHARED, impl_->fd, 0);
+    if (ptr == MAP_FAILED) {
+        int saved_errno = errno;
+        impl_->cleanup();
+        return Err<void>(
+            ErrorCode::ShmMapFailed,
+            std::format("Не удалось замапить сегмент статистики: {}", strerror(saved_errno))
+        );
+    }
+    impl_->map = ptr;
+
+    auto* segment = static_cast<QuaxisSharedStats*>(ptr);
+    init_shm_stats(*segment);
+    impl_->writer = std::make_unique<ShmStatsWriter>(*segment);
+    return {};
+}
+
+void ShmStatsExporter::add_source(ShmStatsSource source) {
+    impl_->sources.push_back(std::move(source));
+}
+
+void ShmStatsExporter::publish() {
+    if (!impl_->writer) {
+        return;
+    }
+
+    auto& summary = impl_->summary;
+    auto& connections = impl_->connections;
+    summary = ShmStatsSummary{};
+    connections.clear();
+    summary.started_ns = impl_->started_ns;
+    summary.pid = static_cast<uint32_t>(getpid());
+    for (const auto& source : impl_->sources) {
+        source(summary, connections);
+    }
+    summary.updated_ns = system_ns();
+    impl_->writer->publish(summary, connections);
+}
+
+const std::string& ShmStatsExporter::path() const noexcept {
+    return impl_->path;
+}
+
+// =============================================================================
+// Источники
+// =============================================================================
+
+void fill_server_stats(ShmStatsSummary& summary, std::vector<ShmStatsConnection>& connections,
+                       const network::Server& server) {
+    const auto stats = server.stats();
+    summary.total_connections = stats.total_connections;
+    summary.total_shares = stats.total_shares;
+    summary.total_jobs_sent = stats.total_jobs_sent;
+    summary.total_hashrate_ghs = stats.total_hashrate;
+    summary.active_connections = static_cast<uint32_t>(stats.active_connections);
+
+    // Снимок соединений обновляется раз в секунду
+    const auto now = std::chrono::steady_clock::now();
+    for (const auto& c : server.connection_stats()) {
+        ShmStatsConnection& entry = connections.emplace_back();
+        copy_shm_string(entry.remote_address, c.remote_address);
+        entry.shares_received = c.stats.shares_received;
+        entry.jobs_sent = c.stats.jobs_sent;
+        entry.connected_seconds = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::seconds>(now - c.stats.connected_at).count());
+        entry.hashrate_ghs = c.stats.last_hashrate;
+        entry.rtt_us = c.stats.rtt_us;
+        entry.retransmits = c.stats.retransmits;
+        entry.temperature = c.stats.last_temperature;
+    }
+}
+
+void fill_relay_stats(ShmStatsSummary& summary, const relay::RelayManager& relay) {
+    const auto stats = relay.stats();
+    auto& out = summary.relay;
+    summary.relay_enabled = 1;
+    out.active_peers = static_cast<uint32_t>(stats.active_peers);
+    out.connected_peers = static_cast<uint32_t>(stats.connected_peers);
+    out.blocks_received = stats.blocks_received;
+    out.duplicate_blocks = stats.duplicate_blocks;
+    out.reconstruction_timeouts = stats.reconstruction_timeouts;
+    out.evicted_blocks = stats.evicted_blocks;
+    out.socket_drops = stats.socket_drops;
+    out.speculative_headers = stats.speculative_headers;
+    out.invalid_blocks = stats.invalid_blocks;
+
+    const auto latency = relay.latency_histograms();
+    out.header_p50_ns = latency.header_latency.percentile(0.5);
+    out.header_p99_ns = latency.header_latency.percentile(0.99);
+    out.reconstruction_p50_ns = latency.reconstruction_latency.percentile(0.5);
+    out.reconstruction_p99_ns = latency.reconstruction_latency.percentile(0.99);
+}
+
+void fill_fallback_stats(ShmStatsSummary& summary, const fallback::FallbackManager& fallback) {
+    summary.fallback_mode = static_cast<uint8_t>(fallback.current_mode());
+}
+
+void append_chain_stats(ShmStatsSummary& summary, std::string_view name, uint32_t height,
+                        uint8_t status, bool enabled, uint64_t blocks_found) {
+    if (summary.chain_count >= SHM_STATS_MAX_CHAINS) {
+        return;
+    }
+    ShmStatsChain& chain = summary.chains[summary.chain_count++];
+    copy_shm_string(chain.name, name);
+    chain.height = height;
+    chain.status = status;
+    chain.enabled = enabled ? 1 : 0;
+    chain.blocks_found = blocks_found;
+}
+
+} // namespace quaxis::metrics
@@ -0,0 +1,103 @@
+/**
+ * @file shm_stats_export.hpp
+ * @brief Публикация статистики в сегмент shared memory (QuaxisSharedStats)
+ *
+ * Источники заполняют сводку и записи соединений из тех же снимков, что
+ * читают источники /metrics; publish() копирует результат в сегмент под
+ * seqlock. Публикует основной цикл (раз в секунду), читают агенты
+ * (quaxis-stats) с любой частотой.
+ */
+
+#pragma once
+
+#include "shm_stats.hpp"
+#include "../core/types.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace quaxis::network { class Server; }
+namespace quaxis::relay { class RelayManager; }
+namespace quaxis::fallback { class FallbackManager; }
+
+namespace quaxis::metrics {
+
+/**
+ * @brief Источник снимка: дописывает свои поля сводки и соединения
+ */
+using ShmStatsSource = std::function<void(ShmStatsSummary& summary,
+                                          std::vector<ShmStatsConnection>& connections)>;
+
+/**
+ * @brief Владелец сегмента статистики
+ */
+class ShmStatsExporter {
+public:
+    /**
+     * @param path Имя сегмента POSIX shm (например, "/quaxis_stats")
+     */
+    explicit ShmStatsExporter(std::string path);
+
+    /**
+     * @brief Отмапить и удалить сегмент (если имя не занял преемник)
+     */
+    ~ShmStatsExporter();
+
+    ShmStatsExporter(const ShmStatsExporter&) = delete;
+    ShmStatsExporter& operator=(const ShmStatsExporter&) = delete;
+
+    /**
+     * @brief Создать (или пересоздать) сегмент и разметить его
+     *
+     * @return Result<void> Успех, ShmOpenFailed или ShmMapFailed
+     */
+    [[nodiscard]] Result<void> open();
+
+    /**
+     * @brief Добавить источник (до первого publish)
+     */
+    void add_source(ShmStatsSource source);
+
+    /**
+     * @brief Опросить источники и опубликовать снимок
+     *
+     * Вызывается из одного потока; до open() - ничего.
+     */
+    void publish();
+
+    [[nodiscard]] const std::string& path() const noexcept;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+/**
+ * @brief Сервер ASIC: счётчики и записи соединений (connection_stats)
+ */
+void fill_server_stats(ShmStatsSummary& summary, std::vector<ShmStatsConnection>& connections,
+                       const network::Server& server);
+
+/**
+ * @brief FIBRE relay: пиры, блоки, перцентили header / реконструкции
+ */
+void fill_relay_stats(ShmStatsSummary& summary, const relay::RelayManager& relay);
+
+/**
+ * @brief Fallback: текущий источник заданий
+ */
+void fill_fallback_stats(ShmStatsSummary& summary, const fallback::FallbackManager& fallback);
+
+/**
+ * @brief Дописать merged chain (сверх SHM_STATS_MAX_CHAINS - ничего)
+ *
+ * @param status merged::ChainStatus
+ */
+void append_chain_stats(ShmStatsSummary& summary, std::string_view name, uint32_t height,
+                        uint8_t status, bool enabled, uint64_t blocks_found);
+
+} // namespace quaxis::metrics
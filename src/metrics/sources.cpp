@@ -0,0 +1,357 @@
+/**
+ * @file sources.cpp
+ * @brief Реализация источников метрик
+ */
+
+#include "sources.hpp"
+
+#include "../network/server.hpp"
+#include "../relay/relay_manager.hpp"
+#include "../fallback/fallback_manager.hpp"
+#include "../mining/version_rolling.hpp"
+#include "../mining/stale_work.hpp"
+#include "../core/pmu_profile.hpp"
+
+#include <array>
+#include <string_view>
+
+namespace quaxis::metrics {
+
+namespace {
+
+/**
+ * @brief Имя состояния пира для метки
+ */
+constexpr std::string_view peer_state_name(relay::PeerState state) noexcept {
+    switch (state) {
+        case relay::PeerState::Disconnected: return "disconnected";
+        case relay::PeerState::Connecting:   return "connecting";
+        case relay::PeerState::Connected:    return "connected";
+        case relay::PeerState::Stale:        return "stale";
+        case relay::PeerState::Error:        return "error";
+        default: return "unknown";
+    }
+}
+
+} // anonymous namespace
+
+// =============================================================================
+// Сервер ASIC
+// =============================================================================
+
+void write_server_metrics(MetricsWriter& writer, const network::Server& server) {
+    const auto stats = server.stats();
+    writer.gauge("quaxis_asic_connections", "Подключённые ASIC",
+                 static_cast<double>(stats.active_connections));
+    writer.counter("quaxis_asic_connections_total", "Принятые подключения ASIC",
+                   static_cast<double>(stats.total_connections));
+    writer.counter("quaxis_shares_total", "Полученные shares",
+                   static_cast<double>(stats.total_shares));
+    writer.counter("quaxis_jobs_sent_total", "Отправленные задания",
+                   static_cast<double>(stats.total_jobs_sent));
+    writer.gauge("quaxis_hashrate_ghs", "Суммарный хешрейт ASIC (GH/s)",
+                 static_cast<double>(stats.total_hashrate));
+
+    // Снимок соединений обновляется раз в секунду
+    const auto connections = server.connection_stats();
+    for (const auto& c : connections) {
+        writer.counter("quaxis_asic_shares_total", "Shares соединения",
+                       static_cast<double>(c.stats.shares_received), {{"remote", c.remote_address}});
+    }
+    for (const auto& c : connections) {
+        writer.counter("quaxis_asic_jobs_sent_total", "Задания соединения",
+                       static_cast<double>(c.stats.jobs_sent), {{"remote", c.remote_address}});
+    }
+    for (const auto& c : connections) {
+        writer.counter("quaxis_asic_jobs_superseded_total", "Задания, вытесненные до отправки",
+                       static_cast<double>(c.stats.jobs_superseded), {{"remote", c.remote_address}});
+    }
+    for (const auto& c : connections) {
+        writer.counter("quaxis_asic_received_bytes_total", "Байт получено от ASIC",
+                       static_cast<double>(c.stats.bytes_received), {{"remote", c.remote_address}});
+    }
+    for (const auto& c : connections) {
+        writer.counter("quaxis_asic_sent_bytes_total", "Байт отправлено ASIC",
+                       static_cast<double>(c.stats.bytes_sent), {{"remote", c.remote_address}});
+    }
+    for (const auto& c : connections) {
+        writer.gauge("quaxis_asic_hashrate_ghs", "Хешрейт ASIC (GH/s)",
+                     static_cast<double>(c.stats.last_hashrate), {{"remote", c.remote_address}});
+    }
+    for (const auto& c : connections) {
+        writer.gauge("quaxis_asic_temperature_celsius", "Температура ASIC",
+                     static_cast<double>(c.stats.last_temperature), {{"remote", c.remote_address}});
+    }
+    for (const auto& c : connections) {
+        writer.gauge("quaxis_asic_rtt_seconds", "Сглаженный RTT TCP соединения ASIC",
+                     static_cast<double>(c.stats.rtt_us) / 1e6, {{"remote", c.remote_address}});
+    }
+    for (const auto& c : connections) {
+        writer.counter("quaxis_asic_tcp_retransmits_total", "Ретрансмиссии TCP соединения ASIC",
+                       static_cast<double>(c.stats.retransmits), {{"remote", c.remote_address}});
+    }
+
+    // Телеметрия чипов: сводка по плоской таблице, без обхода соединений
+    const auto fleet = server.fleet_telemetry().summary();
+    writer.gauge("quaxis_fleet_asics", "ASIC с актуальной телеметрией чипов",
+                 static_cast<double>(fleet.asics));
+    writer.gauge("quaxis_fleet_stale_asics", "ASIC, ждущие полного снимка телеметрии",
+                 static_cast<double>(fleet.stale_asics));
+    writer.gauge("quaxis_fleet_chips", "Чипы с телеметрией",
+                 static_cast<double>(fleet.chips));
+    writer.gauge("quaxis_fleet_error_chips", "Чипы со статусом ошибки",
+                 static_cast<double>(fleet.error_chips));
+    writer.gauge("quaxis_fleet_chip_temperature_avg_celsius", "Средняя температура чипов",
+                 fleet.temperature_avg);
+    writer.gauge("quaxis_fleet_chip_temperature_max_celsius", "Максимальная температура чипа",
+                 static_cast<double>(fleet.temperature_max));
+    writer.gauge("quaxis_fleet_chip_frequency_avg_mhz", "Средняя частота чипов (МГц)",
+                 fleet.frequency_avg_mhz);
+    writer.counter("quaxis_fleet_chip_hw_errors_total", "HW ошибки чипов",
+                   static_cast<double>(fleet.hw_errors));
+    writer.counter("quaxis_fleet_chip_good_nonces_total", "Верные nonce чипов",
+                   static_cast<double>(fleet.good_nonces));
+    
+    // RSP_JOB_LOADED: только ASIC, прошивка которых его шлёт
+    const auto job_load = server.job_load_latency();
+    for (const auto& c : job_load) {
+        writer.histogram("quaxis_asic_job_dispatch_seconds",
+                         "От отправки задания до RSP_JOB_LOADED (часы сервера)",
+                         c.latency.dispatch, {{"remote", c.remote_address}});
+    }
+    for (const auto& c : job_load) {
+        writer.histogram("quaxis_asic_job_load_seconds",
+                         "От приёма задания до старта чипов (часы контроллера)",
+                         c.latency.load, {{"remote", c.remote_address}});
+    }
+}
+
+// =============================================================================
+// FIBRE relay
+// =============================================================================
+
+void write_relay_metrics(MetricsWriter& writer, const relay::RelayManager& relay) {
+    const auto stats = relay.stats();
+    writer.gauge("quaxis_relay_active_peers", "Активные relay пиры",
+                 static_cast<double>(stats.active_peers));
+    writer.gauge("quaxis_relay_connected_peers", "Подключённые relay пиры",
+                 static_cast<double>(stats.connected_peers));
+    writer.gauge("quaxis_relay_xdp_active", "Приём relay через AF_XDP (1 - активен)",
+                 stats.xdp_active ? 1.0 : 0.0);
+    writer.counter("quaxis_relay_blocks_total", "Блоки, полученные через relay",
+                   static_cast<double>(stats.blocks_received));
+    writer.counter("quaxis_relay_duplicate_blocks_total", "Дубликаты блоков relay",
+                   static_cast<double>(stats.duplicate_blocks));
+    writer.counter("quaxis_relay_duplicate_chunks_total", "Чанки, уже полученные от другого пира",
+                   static_cast<double>(stats.duplicate_chunks));
+    writer.counter("quaxis_relay_reconstruction_timeouts_total", "Таймауты реконструкции",
+                   static_cast<double>(stats.reconstruction_timeouts));
+    writer.counter("quaxis_relay_drop_timeouts_total", "Таймауты реконструкции при потерях в буфере сокета",
+                   static_cast<double>(stats.drop_timeouts));
+    writer.counter("quaxis_relay_socket_drops_total", "Датаграммы пиров, отброшенные ядром",
+                   static_cast<double>(stats.socket_drops));
+    writer.counter("quaxis_relay_evicted_blocks_total", "Блоки, вытесненные из пула реконструкции",
+                   static_cast<double>(stats.evicted_blocks));
+    writer.gauge("quaxis_relay_receive_threads", "Потоков приёма relay",
+                 static_cast<double>(stats.receive_threads));
+    writer.counter("quaxis_relay_handoff_chunks_total", "Чанки, переданные потоку-владельцу блока",
+                   static_cast<double>(stats.handoff_chunks));
+    writer.counter("quaxis_relay_handoff_drops_total", "Чанки, потерянные на заполненной очереди владельца",
+                   static_cast<double>(stats.handoff_drops));
+    writer.counter("quaxis_relay_priority_chunks_total", "Чанки быстрой полосы приёма (header блока, набросок, LastChunk)",
+                   static_cast<double>(stats.priority_chunks));
+    writer.counter("quaxis_relay_xdp_datagrams_total", "Датаграммы, принятые через AF_XDP",
+                   static_cast<double>(stats.xdp_datagrams));
+    writer.counter("quaxis_relay_speculative_headers_total", "Header-first: заголовков в spy mining",
+                   static_cast<double>(stats.speculative_headers));
+    writer.counter("quaxis_relay_rejected_headers_total", "Header-first: отклонённых заголовков",
+                   static_cast<double>(stats.rejected_headers));
+    writer.counter("quaxis_relay_invalid_blocks_total", "Header-first: тело не совпало с заголовком",
+                   static_cast<double>(stats.invalid_blocks));
+    writer.counter("quaxis_relay_sketches_total", "Наброски блоков из mempool",
+                   static_cast<double>(stats.sketches_received));
+    writer.counter("quaxis_relay_prefilled_chunks_total", "Data чанки, синтезированные из кеша транзакций",
+                   static_cast<double>(stats.prefilled_chunks));
+    writer.counter("quaxis_relay_prefill_mismatches_total", "Блоки с коллизией short id (merkle не совпал)",
+                   static_cast<double>(stats.prefill_mismatches));
+    writer.gauge("quaxis_relay_tx_cache_size", "Транзакций в кеше mempool relay",
+                 static_cast<double>(stats.tx_cache_size));
+    writer.gauge("quaxis_relay_uptime_seconds", "Время работы relay",
+                 stats.uptime_seconds);
+
+    const auto latency = relay.latency_histograms();
+    writer.histogram("quaxis_relay_header_latency_seconds",
+                     "От первого пакета блока до header", latency.header_latency);
+    writer.histogram("quaxis_relay_reconstruction_latency_seconds",
+                     "От первого пакета блока до полного блока", latency.reconstruction_latency);
+    writer.histogram("quaxis_relay_decode_latency_seconds",
+                     "От декодируемого набора чанков до полного блока", latency.decode_latency);
+
+    const auto peers = relay.peer_stats();
+    for (const auto& p : peers) {
+        for (auto state : {relay::PeerState::Disconnected, relay::PeerState::Connecting,
+                           relay::PeerState::Connected, relay::PeerState::Stale,
+                           relay::PeerState::Error}) {
+            writer.gauge("quaxis_relay_peer_state", "Состояние пира (1 - текущее)",
+                         p.state == state ? 1.0 : 0.0,
+                         {{"peer", p.address}, {"state", peer_state_name(state)}});
+        }
+    }
+    for (const auto& p : peers) {
+        writer.counter("quaxis_relay_peer_packets_total", "Пакеты от пира",
+                       static_cast<double>(p.stats.packets_received), {{"peer", p.address}});
+    }
+    for (const auto& p : peers) {
+        writer.counter("quaxis_relay_peer_received_bytes_total", "Байт от пира",
+                       static_cast<double>(p.stats.bytes_received), {{"peer", p.address}});
+    }
+    for (const auto& p : peers) {
+        writer.counter("quaxis_relay_peer_recv_syscalls_total", "Системные вызовы приёма пира",
+                       static_cast<double>(p.stats.recv_syscalls), {{"peer", p.address}});
+    }
+    for (const auto& p : peers) {
+        writer.counter("quaxis_relay_peer_kernel_drops_total", "Датаграммы пира, отброшенные ядром (SO_RXQ_OVFL)",
+                       static_cast<double>(p.stats.kernel_drops), {{"peer", p.address}});
+    }
+    for (const auto& p : peers) {
+        writer.gauge("quaxis_relay_peer_recv_buffer_bytes", "Буфер приёма сокета пира (SO_RCVBUF)",
+                     static_cast<double>(p.stats.recv_buffer_bytes), {{"peer", p.address}});
+    }
+    for (const auto& p : peers) {
+        writer.counter("quaxis_relay_peer_blocks_total", "Блоки, реконструкцию которых завершил чанк пира",
+                       static_cast<double>(p.stats.blocks_received), {{"peer", p.address}});
+    }
+    for (const auto& p : peers) {
+        writer.counter("quaxis_relay_peer_chunks_first_total", "Чанки пира, пришедшие первыми",
+                       static_cast<double>(p.stats.chunks_first), {{"peer", p.address}});
+    }
+    for (const auto& p : peers) {
+        writer.counter("quaxis_relay_peer_chunks_duplicate_total", "Чанки пира, уже полученные от других",
+                       static_cast<double>(p.stats.chunks_duplicate), {{"peer", p.address}});
+    }
+    for (const auto& p : peers) {
+        writer.counter("quaxis_relay_peer_headers_first_total", "Блоки, header которых дал пир",
+                       static_cast<double>(p.stats.headers_first), {{"peer", p.address}});
+    }
+    for (const auto& p : peers) {
+        writer.counter("quaxis_relay_peer_blocks_first_total", "Блоки, первый чанк которых пир прислал раньше всех",
+                       static_cast<double>(p.stats.blocks_first), {{"peer", p.address}});
+    }
+    for (const auto& p : peers) {
+        writer.gauge("quaxis_relay_peer_arrival_lag_seconds", "Отставание первого чанка блока от лучшего пира",
+                     p.stats.arrival_lag_ms / 1000.0, {{"peer", p.address}});
+    }
+    for (const auto& p : peers) {
+        writer.gauge("quaxis_relay_peer_latency_seconds", "Сглаженный RTT пира по эхо keepalive",
+                     p.stats.avg_latency_ms / 1000.0, {{"peer", p.address}});
+    }
+    for (const auto& p : peers) {
+        writer.gauge("quaxis_relay_peer_jitter_seconds", "Jitter RTT пира",
+                     p.stats.jitter_ms / 1000.0, {{"peer", p.address}});
+    }
+    for (const auto& p : peers) {
+        writer.gauge("quaxis_relay_peer_packet_loss_ratio", "Потеря пакетов пира (0-1)",
+                     p.stats.packet_loss, {{"peer", p.address}});
+    }
+}
+
+// =============================================================================
+// Fallback
+// =============================================================================
+
+void write_fallback_metrics(MetricsWriter& writer, const fallback::FallbackManager& fallback) {
+    const auto current = fallback.current_mode();
+    for (auto mode : {fallback::FallbackMode::PrimarySHM, fallback::FallbackMode::FallbackZMQ,
+                      fallback::FallbackMode::FallbackStratum}) {
+        writer.gauge("quaxis_fallback_mode", "Источник заданий (1 - текущий)",
+                     mode == current ? 1.0 : 0.0, {{"mode", fallback::to_string(mode)}});
+    }
+
+    const auto stats = fallback.get_stats();
+    writer.counter("quaxis_fallback_zmq_switches_total", "Переключения на ZMQ",
+                   static_cast<double>(stats.zmq_switches));
+    writer.counter("quaxis_fallback_stratum_switches_total", "Переключения на Stratum",
+                   static_cast<double>(stats.stratum_switches));
+    writer.counter("quaxis_fallback_primary_restorations_total", "Возвраты к SHM",
+                   static_cast<double>(stats.primary_restorations));
+    writer.counter("quaxis_fallback_seconds_total", "Время в резервных режимах",
+                   static_cast<double>(stats.fallback_duration_seconds));
+}
+
+// =============================================================================
+// Version rolling
+// =============================================================================
+
+void write_version_rolling_metrics(MetricsWriter& writer, const mining::VersionRollingManager& rolling) {
+    const auto stats = rolling.get_stats();
+    writer.counter("quaxis_version_rolling_generated_total", "Сгенерированные версии",
+                   static_cast<double>(stats.versions_generated));
+    writer.counter("quaxis_version_rolling_validated_total", "Проверенные версии",
+                   static_cast<double>(stats.versions_validated));
+    writer.counter("quaxis_version_rolling_invalid_total", "Невалидные версии",
+                   static_cast<double>(stats.invalid_versions));
+}
+
+// =============================================================================
+// Потерянная работа
+// =============================================================================
+
+void write_stale_work_metrics(MetricsWriter& writer, const mining::StaleWorkAccountant& accountant) {
+    const auto snapshot = accountant.snapshot();
+    for (std::size_t i = 0; i < mining::STALE_CAUSE_COUNT; ++i) {
+        const std::string_view cause = mining::to_string(static_cast<mining::StaleCause>(i));
+        writer.counter("quaxis_stale_work_th_total", "Работа на устаревшем tip, TH",
+                       snapshot.wasted_th[i], {{"cause", cause}});
+        writer.gauge("quaxis_stale_work_last_block_th", "Работа на устаревшем tip в последнем событии, TH",
+                     snapshot.last_event ? snapshot.last_event->wasted_th[i] : 0.0, {{"cause", cause}});
+    }
+    writer.counter("quaxis_stale_work_events_total", "Закрытые события нового tip",
+                   static_cast<double>(snapshot.events));
+    writer.counter("quaxis_stale_work_invalidated_total", "События отменённого speculative блока",
+                   static_cast<double>(snapshot.invalidated));
+    writer.gauge("quaxis_stale_work_hashrate", "Хешрейт парка по сложности shares, H/s",
+                 snapshot.hashrate);
+    for (std::size_t i = 0; i < mining::TIP_SOURCE_COUNT; ++i) {
+        const std::string_view source = mining::to_string(static_cast<mining::TipSource>(i));
+        writer.counter("quaxis_tip_first_arrivals_total", "Источник сообщил о tip первым",
+                       static_cast<double>(snapshot.first_arrivals[i]), {{"source", source}});
+        writer.histogram("quaxis_tip_source_lag_seconds", "Отставание источника от первого сообщения о tip",
+                         snapshot.source_lag[i], {{"source", source}});
+    }
+}
+
+// =============================================================================
+// Трассировка латентности
+// =============================================================================
+
+void write_trace_metrics(MetricsWriter& writer) {
+    for (std::size_t i = 0; i < core::TRACE_STAGE_COUNT; ++i) {
+        const auto stage = static_cast<core::TraceStage>(i);
+        writer.histogram("quaxis_block_latency_seconds", "Латентность этапа от прихода блока",
+                         core::trace_stage_histogram(stage), {{"stage", core::to_string(stage)}});
+    }
+    writer.counter("quaxis_trace_lost_events_total", "События трассировки, потерянные при переполнении",
+                   static_cast<double>(core::trace_lost_events()));
+}
+
+void write_pmu_metrics(MetricsWriter& writer) {
+    writer.gauge("quaxis_pmu_enabled", "Профиль PMU включён (1) или нет (0)",
+                 core::pmu_enabled() ? 1.0 : 0.0);
+    for (const auto& stats : core::pmu_region_stats()) {
+        const std::string_view region = core::to_string(stats.region);
+        writer.counter("quaxis_pmu_calls_total", "Замеры участка",
+                       static_cast<double>(stats.calls), {{"region", region}});
+        writer.counter("quaxis_pmu_units_total", "Единиц работы участка (блоков, shares, чанков)",
+                       static_cast<double>(stats.units), {{"region", region}});
+        for (std::size_t e = 0; e < core::PMU_EVENT_COUNT; ++e) {
+            if (!stats.available[e]) {
+                continue;
+            }
+            writer.counter("quaxis_pmu_events_total", "Аппаратные события участка (user space)",
+                           static_cast<double>(stats.events[e]),
+                           {{"region", region}, {"event", core::to_string(static_cast<core::PmuEvent>(e))}});
+        }
+    }
+}
+
+} // namespace quaxis::metrics
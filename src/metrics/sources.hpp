@@ -0,0 +1,56 @@
+/**
+ * @file sources.hpp
+ * @brief Источники метрик подсистем майнера
+ *
+ * Каждая функция пишет семейства одной подсистемы, читая только её
+ * lock-free снимки. Имена метрик - с префиксом quaxis_, единицы в
+ * суффиксе (_seconds, _bytes), счётчики - с _total.
+ */
+
+#pragma once
+
+#include "openmetrics.hpp"
+
+namespace quaxis::network { class Server; }
+namespace quaxis::relay { class RelayManager; }
+namespace quaxis::fallback { class FallbackManager; }
+namespace quaxis::mining { class VersionRollingManager; class StaleWorkAccountant; }
+
+namespace quaxis::metrics {
+
+/**
+ * @brief Сервер ASIC: соединения, shares, задания, хешрейт по соединениям
+ */
+void write_server_metrics(MetricsWriter& writer, const network::Server& server);
+
+/**
+ * @brief FIBRE relay: блоки, латентность header / реконструкции, пиры
+ */
+void write_relay_metrics(MetricsWriter& writer, const relay::RelayManager& relay);
+
+/**
+ * @brief Fallback: текущий режим и переключения
+ */
+void write_fallback_metrics(MetricsWriter& writer, const fallback::FallbackManager& fallback);
+
+/**
+ * @brief Version rolling: сгенерированные и проверенные версии
+ */
+void write_version_rolling_metrics(MetricsWriter& writer, const mining::VersionRollingManager& rolling);
+
+/**
+ * @brief Потерянная работа: TH по причинам, последнее событие, отставание источников tip
+ */
+void write_stale_work_metrics(MetricsWriter& writer, const mining::StaleWorkAccountant& accountant);
+
+/**
+ * @brief Латентность этапов трассировки (core::latency_trace)
+ */
+void write_trace_metrics(MetricsWriter& writer);
+
+/**
+ * @brief Счётчики PMU горячих участков (core::pmu_profile)
+ */
+void write_pmu_metrics(MetricsWriter& writer);
+
+} // namespace quaxis::metrics
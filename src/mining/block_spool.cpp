@@ -0,0 +1,318 @@
+/**
+ * @file block_spool.cpp
+ * @brief Реализация spool найденных блоков
+ */
+
+#include "block_spool.hpp"
+#include "../crypto/sha256.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <format>
+#include <mutex>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace quaxis::mining {
+
+namespace {
+
+/// @brief Версия раскладки слота
+constexpr uint16_t SLOT_LAYOUT_VERSION = 1;
+
+/// @brief Находок, отправленных раньше записи в spool, которые помнятся
+constexpr std::size_t EARLY_SUBMITTED_LIMIT = 32;
+
+/// @brief Состояние слота
+enum class SlotState : uint8_t {
+    Empty = 0,
+    Pending = 1,    ///< Записан, отправка не подтверждена
+    Submitted = 2,  ///< Отправлен хотя бы по одному каналу
+    Replayed = 3    ///< Повторён при запуске
+};
+
+/**
+ * @brief Заголовок слота (начало страницы заголовка)
+ */
+struct SlotHeader {
+    uint32_t magic = 0;
+    uint16_t layout_version = 0;
+    SpoolKind kind = SpoolKind::Block;
+    SlotState state = SlotState::Empty;
+    uint64_t sequence = 0;
+    uint32_t payload_size = 0;
+    uint32_t reserved = 0;
+    Hash256 hash{};
+    Hash256 digest{};   ///< SHA256 payload: запись, оборванная падением, не повторяется
+};
+
+static_assert(sizeof(SlotHeader) <= BlockSpool::PAGE_SIZE);
+
+constexpr std::size_t round_up_page(std::size_t size) noexcept {
+    return (size + BlockSpool::PAGE_SIZE - 1) / BlockSpool::PAGE_SIZE * BlockSpool::PAGE_SIZE;
+}
+
+/**
+ * @brief Буфер, выровненный по странице (требование O_DIRECT)
+ */
+struct AlignedBuffer {
+    struct Free {
+        void operator()(uint8_t* ptr) const noexcept { std::free(ptr); }
+    };
+    std::unique_ptr<uint8_t, Free> data;
+    std::size_t size = 0;
+
+    explicit AlignedBuffer(std::size_t bytes)
+        : data(static_cast<uint8_t*>(std::aligned_alloc(BlockSpool::PAGE_SIZE, bytes)))
+        , size(data ? bytes : 0)
+    {}
+};
+
+} // anonymous namespace
+
+struct BlockSpool::Impl {
+    SpoolConfig config;
+    std::size_t max_payload;
+    std::size_t slot_size;
+
+    mutable std::mutex mutex;
+    int fd = -1;
+    bool direct = false;
+    std::vector<SlotHeader> slots;
+    uint64_t next_sequence = 1;
+    std::deque<std::pair<SpoolKind, Hash256>> early_submitted;
+    AlignedBuffer buffer;
+
+    std::atomic<uint64_t> spooled_count{0};
+
+    explicit Impl(const SpoolConfig& cfg)
+        : config(cfg)
+        , max_payload(std::size_t{cfg.max_block_mb} * 1024 * 1024)
+        , slot_size(PAGE_SIZE + max_payload)
+        , slots(cfg.slots)
+        , buffer(slot_size)
+    {}
+
+    ~Impl() {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+
+    [[nodiscard]] off_t slot_offset(std::size_t index) const noexcept {
+        return static_cast<off_t>(index * slot_size);
+    }
+
+    [[nodiscard]] std::optional<std::size_t> find(SpoolKind kind, const Hash256& hash) const {
+        for (std::size_t i = 0; i < slots.size(); ++i) {
+            if (slots[i].state != SlotState::Empty && slots[i].kind == kind && slots[i].hash == hash) {
+                return i;
+            }
+        }
+        return std::nullopt;
+    }
+
+    /**
+     * @brief Записать size байт буфера в слот и сбросить на диск (под mutex)
+     */
+    [[nodiscard]] bool write_slot(std::size_t index, std::size_t size) {
+        if (::pwrite(fd, buffer.data.get(), size, slot_offset(index)) != static_cast<ssize_t>(size)) {
+            return false;
+        }
+        return ::fdatasync(fd) == 0;
+    }
+
+    /**
+     * @brief Перезаписать страницу заголовка слота (под mutex)
+     */
+    bool write_header(std::size_t index) {
+        std::memset(buffer.data.get(), 0, PAGE_SIZE);
+        std::memcpy(buffer.data.get(), &slots[index], sizeof(SlotHeader));
+        return write_slot(index, PAGE_SIZE);
+    }
+};
+
+BlockSpool::BlockSpool(const SpoolConfig& config)
+    : impl_(std::make_unique<Impl>(config))
+{}
+
+BlockSpool::~BlockSpool() = default;
+
+Result<void> BlockSpool::open() {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    if (!impl_->buffer.data) {
+        return Err<void>(ErrorCode::SystemOutOfMemory, "Нет памяти под буфер spool");
+    }
+
+    const std::filesystem::path path(impl_->config.path);
+    if (path.has_parent_path()) {
+        std::error_code ec;
+        std::filesystem::create_directories(path.parent_path(), ec);
+    }
+
+    // tmpfs и часть FUSE не поддерживают O_DIRECT: тогда только fdatasync
+    impl_->fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC | O_DIRECT, 0644);
+    if (impl_->fd < 0 && errno == EINVAL) {
+        impl_->fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    } else {
+        impl_->direct = impl_->fd >= 0;
+    }
+    if (impl_->fd < 0) {
+        return Err<void>(ErrorCode::SystemIOError,
+            std::format("Не удалось открыть {}: {}", impl_->config.path, strerror(errno)));
+    }
+
+    const std::size_t file_size = impl_->slots.size() * impl_->slot_size;
+    struct stat st{};
+    if (fstat(impl_->fd, &st) != 0) {
+        return Err<void>(ErrorCode::SystemIOError,
+            std::format("{}: {}", impl_->config.path, strerror(errno)));
+    }
+    if (static_cast<std::size_t>(st.st_size) < file_size) {
+        const int rc = posix_fallocate(impl_->fd, 0, static_cast<off_t>(file_size));
+        if (rc != 0) {
+            return Err<void>(ErrorCode::SystemIOError,
+                std::format("Не удалось выделить {}: {}", impl_->config.path, strerror(rc)));
+        }
+    }
+
+    // Заголовки слотов; чужое содержимое (другой max_block_mb) - пустые слоты
+    for (std::size_t i = 0; i < impl_->slots.size(); ++i) {
+        SlotHeader header{};
+        if (::pread(impl_->fd, impl_->buffer.data.get(), PAGE_SIZE, impl_->slot_offset(i)) ==
+            static_cast<ssize_t>(PAGE_SIZE)) {
+            std::memcpy(&header, impl_->buffer.data.get(), sizeof(header));
+        }
+        const bool valid = header.magic == SLOT_MAGIC &&
+                           header.layout_version == SLOT_LAYOUT_VERSION &&
+                           header.payload_size <= impl_->max_payload &&
+                           header.state != SlotState::Empty &&
+                           header.state <= SlotState::Replayed;
+        impl_->slots[i] = valid ? header : SlotHeader{};
+        if (valid) {
+            impl_->next_sequence = std::max(impl_->next_sequence, header.sequence + 1);
+        }
+    }
+    return {};
+}
+
+Result<void> BlockSpool::append(SpoolKind kind, const Hash256& hash, ByteSpan payload) {
+    if (payload.size() > impl_->max_payload) {
+        return Err<void>(ErrorCode::SystemIOError,
+            std::format("Блок {} байт больше spool.max_block_mb", payload.size()));
+    }
+
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    if (impl_->fd < 0) {
+        return Err<void>(ErrorCode::SystemIOError, "Spool не открыт");
+    }
+    if (impl_->find(kind, hash)) {
+        return {};
+    }
+
+    SlotHeader header;
+    header.magic = SLOT_MAGIC;
+    header.layout_version = SLOT_LAYOUT_VERSION;
+    header.kind = kind;
+    header.state = SlotState::Pending;
+    header.sequence = impl_->next_sequence;
+    header.payload_size = static_cast<uint32_t>(payload.size());
+    header.hash = hash;
+    header.digest = crypto::sha256(payload);
+
+    // Другой канал успел отправить блок раньше, чем он записан сюда
+    auto& early = impl_->early_submitted;
+    auto it = std::find(early.begin(), early.end(), std::make_pair(kind, hash));
+    if (it != early.end()) {
+        header.state = SlotState::Submitted;
+        early.erase(it);
+    }
+
+    const std::size_t index = header.sequence % impl_->slots.size();
+    const std::size_t size = PAGE_SIZE + round_up_page(payload.size());
+    uint8_t* data = impl_->buffer.data.get();
+    std::memset(data, 0, PAGE_SIZE);
+    std::memcpy(data, &header, sizeof(header));
+    if (!payload.empty()) {
+        std::memcpy(data + PAGE_SIZE, payload.data(), payload.size());
+    }
+    std::memset(data + PAGE_SIZE + payload.size(), 0, size - PAGE_SIZE - payload.size());
+
+    if (!impl_->write_slot(index, size)) {
+        return Err<void>(ErrorCode::SystemIOError,
+            std::format("Не удалось записать блок в {}: {}", impl_->config.path, strerror(errno)));
+    }
+    impl_->slots[index] = header;
+    ++impl_->next_sequence;
+    impl_->spooled_count.fetch_add(1, std::memory_order_relaxed);
+    return {};
+}
+
+void BlockSpool::mark_submitted(SpoolKind kind, const Hash256& hash) {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    if (auto index = impl_->find(kind, hash)) {
+        if (impl_->slots[*index].state != SlotState::Submitted) {
+            impl_->slots[*index].state = SlotState::Submitted;
+            (void)impl_->write_header(*index);
+        }
+        return;
+    }
+    auto& early = impl_->early_submitted;
+    early.emplace_back(kind, hash);
+    if (early.size() > EARLY_SUBMITTED_LIMIT) {
+        early.pop_front();
+    }
+}
+
+std::vector<SpooledBlock> BlockSpool::take_pending() {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    std::vector<std::size_t> pending;
+    for (std::size_t i = 0; i < impl_->slots.size(); ++i) {
+        if (impl_->slots[i].state == SlotState::Pending) {
+            pending.push_back(i);
+        }
+    }
+    std::sort(pending.begin(), pending.end(), [this](std::size_t a, std::size_t b) {
+        return impl_->slots[a].sequence < impl_->slots[b].sequence;
+    });
+
+    std::vector<SpooledBlock> blocks;
+    for (std::size_t index : pending) {
+        const SlotHeader& header = impl_->slots[index];
+        const std::size_t size = round_up_page(header.payload_size);
+        const uint8_t* data = impl_->buffer.data.get();
+        if (size == 0 ||
+            ::pread(impl_->fd, impl_->buffer.data.get(), size,
+                    impl_->slot_offset(index) + static_cast<off_t>(PAGE_SIZE)) == static_cast<ssize_t>(size)) {
+            SpooledBlock block;
+            block.kind = header.kind;
+            block.hash = header.hash;
+            block.sequence = header.sequence;
+            block.payload.assign(data, data + header.payload_size);
+            if (crypto::sha256(block.payload) == header.digest) {
+                blocks.push_back(std::move(block));
+            }
+        }
+        impl_->slots[index].state = SlotState::Replayed;
+        (void)impl_->write_header(index);
+    }
+    return blocks;
+}
+
+uint64_t BlockSpool::spooled() const noexcept {
+    return impl_->spooled_count.load(std::memory_order_relaxed);
+}
+
+bool BlockSpool::direct_io() const noexcept {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    return impl_->direct;
+}
+
+} // namespace quaxis::mining
@@ -0,0 +1,112 @@
+/**
+ * @file block_spool.hpp
+ * @brief Spool найденных блоков до подтверждения отправки
+ *
+ * Между находкой блока и успешной отправкой процесс может упасть, а RPC -
+ * зависнуть. Блок записывается в кольцевой файл каналом BlockSubmitter,
+ * находка merged mining (заголовок и coinbase) - RewardDispatcher; оба -
+ * в своём потоке, параллельно с отправкой в сеть, поэтому запись на диск
+ * не задерживает публикацию.
+ *
+ * Файл - slots слотов одного размера: страница заголовка (4096 байт) и
+ * payload, выровненный до страницы. Запись - O_DIRECT (если файловая
+ * система его поддерживает) и fdatasync. Состояние слота меняется
+ * перезаписью страницы заголовка: первая успешная отправка помечает запись
+ * отправленной, запуск отдаёт неотправленные (take_pending()) и помечает
+ * их повторёнными - каждая запись повторяется один раз.
+ */
+
+#pragma once
+
+#include "../core/types.hpp"
+#include "../core/config.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace quaxis::mining {
+
+/// @brief Содержимое записи spool
+enum class SpoolKind : uint8_t {
+    Block = 1,   ///< Сериализованный блок
+    AuxPow = 2   ///< Находка merged mining: заголовок (80) + coinbase
+};
+
+/**
+ * @brief Запись spool
+ */
+struct SpooledBlock {
+    SpoolKind kind = SpoolKind::Block;
+    Hash256 hash{};         ///< Хеш блока (для AuxPow - родительского заголовка)
+    uint64_t sequence = 0;  ///< Порядковый номер записи
+    Bytes payload;
+};
+
+/**
+ * @brief Кольцевой spool найденных блоков
+ *
+ * Все методы thread-safe.
+ */
+class BlockSpool {
+public:
+    /// @brief Страница заголовка слота (выравнивание O_DIRECT)
+    static constexpr std::size_t PAGE_SIZE = 4096;
+
+    /// @brief Сигнатура заголовка слота ("QXBS")
+    static constexpr uint32_t SLOT_MAGIC = 0x53425851;
+
+    explicit BlockSpool(const SpoolConfig& config);
+
+    ~BlockSpool();
+
+    BlockSpool(const BlockSpool&) = delete;
+    BlockSpool& operator=(const BlockSpool&) = delete;
+
+    /**
+     * @brief Открыть (создать) файл и прочитать заголовки слотов
+     */
+    [[nodiscard]] Result<void> open();
+
+    /**
+     * @brief Записать находку на диск
+     *
+     * Повтор той же находки (kind, hash) не пишется. Находка, уже
+     * помеченная mark_submitted(), пишется сразу отправленной.
+     *
+     * @return Result<void> Ошибка записи или блок больше max_block_mb
+     */
+    [[nodiscard]] Result<void> append(SpoolKind kind, const Hash256& hash, ByteSpan payload);
+
+    /**
+     * @brief Отметить находку отправленной
+     */
+    void mark_submitted(SpoolKind kind, const Hash256& hash);
+
+    /**
+     * @brief Неотправленные записи по порядку находок
+     *
+     * Вызывается при запуске, после open() и до первой находки. Записи
+     * помечаются повторёнными: следующий запуск их не вернёт.
+     */
+    [[nodiscard]] std::vector<SpooledBlock> take_pending();
+
+    /**
+     * @brief Записей этого запуска
+     */
+    [[nodiscard]] uint64_t spooled() const noexcept;
+
+    /**
+     * @brief Файл открыт с O_DIRECT
+     */
+    [[nodiscard]] bool direct_io() const noexcept;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace quaxis::mining
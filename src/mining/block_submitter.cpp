@@ -0,0 +1,175 @@
+/**
+ * @file block_submitter.cpp
+ * @brief Реализация отправки найденных блоков
+ */
+
+#include "block_submitter.hpp"
+#include "../core/constants.hpp"
+#include "../crypto/sha256.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace quaxis::mining {
+
+namespace {
+
+/**
+ * @brief Блок, ожидающий отправки (общий для всех каналов)
+ */
+struct PendingBlock {
+    Bytes block;
+    Hash256 hash{};
+    BlockSubmitter::Clock::time_point found_at;
+};
+
+double elapsed_ms(BlockSubmitter::Clock::time_point from, BlockSubmitter::Clock::time_point to) {
+    return std::chrono::duration<double, std::milli>(to - from).count();
+}
+
+/**
+ * @brief Канал со своим потоком и очередью
+ */
+struct Leg {
+    std::string name;
+    SubmitLeg send;
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<std::shared_ptr<const PendingBlock>> queue;
+    bool stopping = false;
+    std::thread thread;
+};
+
+} // anonymous namespace
+
+struct BlockSubmitter::Impl {
+    std::vector<std::unique_ptr<Leg>> legs;
+    SubmitReportCallback report_callback;
+    std::atomic<uint64_t> submitted{0};
+    bool running = false;
+
+    void send(Leg& leg, const PendingBlock& pending) {
+        SubmitReport report;
+        report.leg = leg.name;
+        report.block_hash = pending.hash;
+        report.started_ms = elapsed_ms(pending.found_at, Clock::now());
+
+        auto result = leg.send(ByteSpan(pending.block.data(), pending.block.size()), pending.hash);
+        report.finished_ms = elapsed_ms(pending.found_at, Clock::now());
+        report.ok = result.has_value();
+        if (!result) {
+            report.error = result.error().message;
+        }
+
+        if (report_callback) {
+            report_callback(report);
+        }
+    }
+
+    void leg_loop(Leg& leg) {
+        for (;;) {
+            std::shared_ptr<const PendingBlock> pending;
+            {
+                std::unique_lock<std::mutex> lock(leg.mutex);
+                leg.cv.wait(lock, [&leg] { return leg.stopping || !leg.queue.empty(); });
+                if (leg.queue.empty()) {
+                    return;  // stopping и всё отправлено
+                }
+                pending = std::move(leg.queue.front());
+                leg.queue.pop_front();
+            }
+            send(leg, *pending);
+        }
+    }
+};
+
+BlockSubmitter::BlockSubmitter()
+    : impl_(std::make_unique<Impl>())
+{
+}
+
+BlockSubmitter::~BlockSubmitter() {
+    stop();
+}
+
+void BlockSubmitter::add_leg(std::string name, SubmitLeg leg) {
+    auto entry = std::make_unique<Leg>();
+    entry->name = std::move(name);
+    entry->send = std::move(leg);
+    impl_->legs.push_back(std::move(entry));
+}
+
+void BlockSubmitter::set_report_callback(SubmitReportCallback callback) {
+    impl_->report_callback = std::move(callback);
+}
+
+void BlockSubmitter::start() {
+    if (impl_->running) {
+        return;
+    }
+    impl_->running = true;
+    for (auto& leg : impl_->legs) {
+        leg->stopping = false;
+        leg->thread = std::thread([this, &leg = *leg] { impl_->leg_loop(leg); });
+    }
+}
+
+void BlockSubmitter::stop() {
+    if (!impl_->running) {
+        return;
+    }
+    for (auto& leg : impl_->legs) {
+        {
+            std::lock_guard<std::mutex> lock(leg->mutex);
+            leg->stopping = true;
+        }
+        leg->cv.notify_one();
+    }
+    for (auto& leg : impl_->legs) {
+        leg->thread.join();
+    }
+    impl_->running = false;
+}
+
+void BlockSubmitter::submit(Bytes block, Clock::time_point found_at) {
+    if (block.size() < constants::BLOCK_HEADER_SIZE) {
+        return;
+    }
+
+    auto pending = std::make_shared<PendingBlock>();
+    pending->hash = crypto::sha256d(ByteSpan(block.data(), constants::BLOCK_HEADER_SIZE));
+    pending->block = std::move(block);
+    pending->found_at = found_at;
+    impl_->submitted.fetch_add(1, std::memory_order_relaxed);
+
+    if (!impl_->running) {
+        for (auto& leg : impl_->legs) {
+            impl_->send(*leg, *pending);
+        }
+        return;
+    }
+
+    // Сначала блок попадает во все очереди, затем будятся все потоки
+    for (auto& leg : impl_->legs) {
+        std::lock_guard<std::mutex> lock(leg->mutex);
+        leg->queue.push_back(pending);
+    }
+    for (auto& leg : impl_->legs) {
+        leg->cv.notify_one();
+    }
+}
+
+std::size_t BlockSubmitter::leg_count() const noexcept {
+    return impl_->legs.size();
+}
+
+uint64_t BlockSubmitter::blocks_submitted() const noexcept {
+    return impl_->submitted.load(std::memory_order_relaxed);
+}
+
+} // namespace quaxis::mining
@@ -0,0 +1,113 @@
+/**
+ * @file block_submitter.hpp
+ * @brief Одновременная отправка найденного блока по всем каналам
+ *
+ * Для соло-майнинга каждая миллисекунда между нахождением блока и его
+ * распространением повышает риск orphan. Каждый канал отправки (FIBRE,
+ * RPC submitblock, ...) работает в своём заранее запущенном потоке:
+ * submit() только публикует готовый блок и будит потоки, поэтому
+ * медленный канал не задерживает остальные.
+ *
+ * Для каждого канала сообщается время от нахождения блока до начала
+ * и до конца отправки.
+ */
+
+#pragma once
+
+#include "../core/types.hpp"
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace quaxis::mining {
+
+/**
+ * @brief Канал отправки блока
+ *
+ * Вызывается из потока канала с сериализованным блоком и его хешем.
+ */
+using SubmitLeg = std::function<Result<void>(ByteSpan block, const Hash256& block_hash)>;
+
+/**
+ * @brief Отчёт канала об отправке одного блока
+ */
+struct SubmitReport {
+    std::string leg;           ///< Имя канала
+    Hash256 block_hash{};
+    bool ok = false;
+    std::string error;         ///< Сообщение об ошибке (если !ok)
+    double started_ms = 0.0;   ///< От нахождения блока до начала отправки
+    double finished_ms = 0.0;  ///< От нахождения блока до конца отправки
+};
+
+/**
+ * @brief Callback отчёта канала (вызывается из потока канала)
+ */
+using SubmitReportCallback = std::function<void(const SubmitReport& report)>;
+
+/**
+ * @brief Отправка найденных блоков
+ *
+ * add_leg() и set_report_callback() вызываются до start().
+ */
+class BlockSubmitter {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    BlockSubmitter();
+    ~BlockSubmitter();
+
+    BlockSubmitter(const BlockSubmitter&) = delete;
+    BlockSubmitter& operator=(const BlockSubmitter&) = delete;
+
+    /**
+     * @brief Добавить канал отправки
+     *
+     * @param name Имя для отчётов ("fibre", "rpc", ...)
+     * @param leg Функция отправки
+     */
+    void add_leg(std::string name, SubmitLeg leg);
+
+    /**
+     * @brief Установить callback отчётов
+     */
+    void set_report_callback(SubmitReportCallback callback);
+
+    /**
+     * @brief Запустить потоки каналов
+     */
+    void start();
+
+    /**
+     * @brief Остановить потоки (блоки в очереди отправляются)
+     */
+    void stop();
+
+    /**
+     * @brief Отправить блок по всем каналам одновременно
+     *
+     * Без start() каналы вызываются по очереди в вызывающем потоке.
+     *
+     * @param block Сериализованный блок
+     * @param found_at Момент нахождения блока (начало отсчёта отчётов)
+     */
+    void submit(Bytes block, Clock::time_point found_at = Clock::now());
+
+    /**
+     * @brief Количество каналов
+     */
+    [[nodiscard]] std::size_t leg_count() const noexcept;
+
+    /**
+     * @brief Количество отправленных блоков
+     */
+    [[nodiscard]] uint64_t blocks_submitted() const noexcept;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace quaxis::mining
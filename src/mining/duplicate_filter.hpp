@@ -0,0 +1,237 @@
+/**
+ * @file duplicate_filter.hpp
+ * @brief Детекция дубликатов shares с фиксированной памятью на задание
+ *
+ * Для каждого слота кольца заданий (слот = job_id % job_queue_size, как
+ * в JobTable) хранится своя открытая хеш-таблица 64-битных ключей share
+ * (nonce, смещение extranonce, слот версии):
+ * - Память выделяется один раз при первом share слота и дальше не растёт,
+ *   сколь угодно низкой ни была бы сложность shares
+ * - Таблица сбрасывается, когда в слот приходит share нового задания, -
+ *   то есть ровно тогда, когда прежнее задание вытеснено из JobTable, -
+ *   и когда CMD_UPDATE_TIME сменил timestamp задания: чипы перебирают
+ *   nonce заново, и прежние nonce дают другие хеши
+ * - Проверка точная (без ложных срабатываний): share, принятый за
+ *   дубликат, мог бы оказаться блоком
+ *
+ * Каждый слот под своим mutex, поэтому потоки пула проверки, разбирающие
+ * shares разных заданий, не ждут друг друга.
+ */
+
+#pragma once
+
+#include "job.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+namespace quaxis::mining {
+
+/**
+ * @brief Ключ share внутри задания
+ *
+ * nonce (32 бита) | смещение extranonce (24 бита) | слот версии (8 бит).
+ * Версия локального version rolling занимает старшие 32 бита через XOR:
+ * у таких shares нет ни смещения, ни слота.
+ */
+[[nodiscard]] constexpr uint64_t duplicate_key(const Share& share) noexcept {
+    return (static_cast<uint64_t>(share.nonce)
+         | (static_cast<uint64_t>(share.extranonce_offset & 0xFFFFFFu) << 32)
+         | (static_cast<uint64_t>(share.version_slot) << 56))
+         ^ (static_cast<uint64_t>(share.version) << 32);
+}
+
+/**
+ * @brief Множество ключей shares одного задания (фиксированная ёмкость)
+ *
+ * Линейное пробирование по таблице не более чем наполовину заполненной:
+ * в среднем одна-две соседние ячейки на проверку.
+ */
+class DuplicateFilter {
+public:
+    /**
+     * @brief Создать фильтр
+     *
+     * @param max_shares Сколько shares запоминать (таблица вдвое больше)
+     */
+    explicit DuplicateFilter(std::size_t max_shares)
+        : limit_(std::max<std::size_t>(max_shares, 1))
+        , mask_(std::bit_ceil(std::max<std::size_t>(limit_ * 2, 16)) - 1)
+        , cells_(std::make_unique<uint64_t[]>(mask_ + 1))
+    {}
+
+    DuplicateFilter(const DuplicateFilter&) = delete;
+    DuplicateFilter& operator=(const DuplicateFilter&) = delete;
+
+    /**
+     * @brief Отдать фильтр новому заданию (или заданию с новым timestamp)
+     */
+    void reset(uint32_t job_id, uint32_t timestamp = 0) noexcept {
+        if (count_ > 0) {
+            std::fill(cells_.get(), cells_.get() + mask_ + 1, uint64_t{0});
+            count_ = 0;
+        }
+        job_id_ = job_id;
+        timestamp_ = timestamp;
+    }
+
+    /**
+     * @brief Запомнить share
+     *
+     * Заполненный фильтр новых ключей не запоминает (share принимается):
+     * лишний partial share дешевле потерянного блока.
+     *
+     * @return true если такой share уже был
+     */
+    [[nodiscard]] bool test_and_insert(uint64_t key) noexcept {
+        const uint64_t stored = key + 1;  // 0 - пустая ячейка
+        for (std::size_t i = mix(key) & mask_;; i = (i + 1) & mask_) {
+            if (cells_[i] == stored) {
+                return true;
+            }
+            if (cells_[i] == 0) {
+                if (count_ < limit_) {
+                    cells_[i] = stored;
+                    ++count_;
+                } else {
+                    ++overflows_;
+                }
+                return false;
+            }
+        }
+    }
+
+    /**
+     * @brief Задание, которому принадлежит фильтр
+     */
+    [[nodiscard]] uint32_t job_id() const noexcept { return job_id_; }
+    
+    /**
+     * @brief Timestamp задания, с которым перебирались запомненные nonce
+     */
+    [[nodiscard]] uint32_t timestamp() const noexcept { return timestamp_; }
+
+    /**
+     * @brief Запомненных shares
+     */
+    [[nodiscard]] std::size_t size() const noexcept { return count_; }
+
+    /**
+     * @brief Сколько shares запоминается
+     */
+    [[nodiscard]] std::size_t capacity() const noexcept { return limit_; }
+
+    /**
+     * @brief Shares, не запомненные из-за заполнения
+     */
+    [[nodiscard]] uint64_t overflows() const noexcept { return overflows_; }
+
+private:
+    /// @brief Финализатор splitmix64: соседние nonce в разные ячейки
+    [[nodiscard]] static constexpr uint64_t mix(uint64_t x) noexcept {
+        x ^= x >> 30;
+        x *= 0xBF58476D1CE4E5B9ULL;
+        x ^= x >> 27;
+        x *= 0x94D049BB133111EBULL;
+        x ^= x >> 31;
+        return x;
+    }
+
+    std::size_t limit_;
+    std::size_t mask_;
+    std::unique_ptr<uint64_t[]> cells_;
+    std::size_t count_ = 0;
+    uint64_t overflows_ = 0;
+    uint32_t job_id_ = 0;
+    uint32_t timestamp_ = 0;
+};
+
+/**
+ * @brief Фильтры дубликатов для всего кольца заданий
+ */
+class DuplicateFilterRing {
+public:
+    /**
+     * @brief Создать кольцо
+     *
+     * @param job_slots Слотов (= ёмкость JobTable, job_queue_size)
+     * @param shares_per_job Shares, запоминаемых на задание
+     */
+    DuplicateFilterRing(std::size_t job_slots, std::size_t shares_per_job)
+        : count_(job_slots == 0 ? 1 : job_slots)
+        , shares_per_job_(shares_per_job)
+        , slots_(std::make_unique<Slot[]>(count_))
+    {}
+
+    DuplicateFilterRing(const DuplicateFilterRing&) = delete;
+    DuplicateFilterRing& operator=(const DuplicateFilterRing&) = delete;
+
+    /**
+     * @brief Проверить и запомнить share
+     *
+     * @param share Share
+     * @param timestamp Текущий timestamp задания share
+     * @return true если share - дубликат
+     */
+    [[nodiscard]] bool check(const Share& share, uint32_t timestamp) {
+        Slot& slot = slots_[share.job_id % count_];
+        std::lock_guard<std::mutex> lock(slot.mutex);
+        if (!slot.filter) {
+            slot.filter = std::make_unique<DuplicateFilter>(shares_per_job_);
+            slot.filter->reset(share.job_id, timestamp);
+        } else if (slot.filter->job_id() != share.job_id || slot.filter->timestamp() != timestamp) {
+            // Прежнее задание слота вытеснено из кольца, либо CMD_UPDATE_TIME
+            // перезапустил перебор nonce с новым timestamp
+            slot.filter->reset(share.job_id, timestamp);
+        }
+        uint64_t before = slot.filter->overflows();
+        bool duplicate = slot.filter->test_and_insert(duplicate_key(share));
+        if (slot.filter->overflows() != before) {
+            overflows_.fetch_add(1, std::memory_order_relaxed);
+        }
+        return duplicate;
+    }
+
+    /**
+     * @brief Забыть все shares (память слотов сохраняется)
+     */
+    void clear() {
+        for (std::size_t i = 0; i < count_; ++i) {
+            std::lock_guard<std::mutex> lock(slots_[i].mutex);
+            if (slots_[i].filter) {
+                slots_[i].filter->reset(0);
+            }
+        }
+        overflows_.store(0, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Shares, не запомненные из-за заполнения фильтра задания
+     */
+    [[nodiscard]] uint64_t overflows() const noexcept {
+        return overflows_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Shares, запоминаемых на задание
+     */
+    [[nodiscard]] std::size_t shares_per_job() const noexcept { return shares_per_job_; }
+
+private:
+    struct alignas(64) Slot {
+        std::mutex mutex;
+        std::unique_ptr<DuplicateFilter> filter;  ///< Выделяется при первом share
+    };
+
+    std::size_t count_;
+    std::size_t shares_per_job_;
+    std::unique_ptr<Slot[]> slots_;
+    std::atomic<uint64_t> overflows_{0};
+};
+
+} // namespace quaxis::mining
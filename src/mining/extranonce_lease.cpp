@@ -0,0 +1,75 @@
+/**
+ * @file extranonce_lease.cpp
+ * @brief Реализация аренды диапазона extranonce
+ */
+
+#include "extranonce_lease.hpp"
+
+#include <cstring>
+
+namespace quaxis::mining {
+
+namespace {
+
+/// @brief Записать 6 байт extranonce в little-endian (начало хвоста coinbase)
+void write_extranonce(uint8_t* dest, uint64_t extranonce) noexcept {
+    for (std::size_t i = 0; i < constants::EXTRANONCE_SIZE; ++i) {
+        dest[i] = static_cast<uint8_t>((extranonce >> (i * 8)) & 0xFF);
+    }
+}
+
+} // anonymous namespace
+
+bool assign_extranonce_lease(
+    Job& job,
+    const bitcoin::BlockTemplate& block_template,
+    uint32_t count
+) noexcept {
+    job.extranonce_lease = 0;
+    if (count < 2 || block_template.coinbase_tx.size() != constants::COINBASE_SIZE) {
+        return false;
+    }
+    
+    job.version = block_template.header.version;
+    job.prev_block = block_template.header.prev_block;
+    job.coinbase_midstate = (block_template.coinbase_midstate == crypto::Sha256State{})
+        ? crypto::compute_midstate(block_template.coinbase_tx.data())
+        : block_template.coinbase_midstate;
+    
+    std::memcpy(
+        job.coinbase_tail.data(),
+        block_template.coinbase_tx.data() + constants::SHA256_BLOCK_SIZE,
+        job.coinbase_tail.size()
+    );
+    write_extranonce(job.coinbase_tail.data(), job.extranonce);
+    
+    job.extranonce_lease = count;
+    return true;
+}
+
+std::optional<bitcoin::BlockHeader> leased_header(
+    const Job& job,
+    uint32_t offset
+) noexcept {
+    if (offset >= job.extranonce_lease) {
+        return std::nullopt;
+    }
+    
+    std::array<uint8_t, constants::COINBASE_TAIL_SIZE> tail = job.coinbase_tail;
+    write_extranonce(tail.data(), job.extranonce + offset);
+    
+    bitcoin::BlockHeader header;
+    header.version = job.version;
+    header.prev_block = job.prev_block;
+    header.merkle_root = crypto::sha256d_resume(
+        job.coinbase_midstate,
+        constants::SHA256_BLOCK_SIZE,
+        ByteSpan(tail.data(), tail.size())
+    );
+    header.timestamp = job.timestamp;
+    header.bits = job.bits;
+    header.nonce = 0;
+    return header;
+}
+
+} // namespace quaxis::mining
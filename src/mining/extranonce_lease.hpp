@@ -0,0 +1,62 @@
+/**
+ * @file extranonce_lease.hpp
+ * @brief Аренда диапазона extranonce для перебора на стороне ASIC
+ * 
+ * Обычное задание покрывает 2^32 nonce одного extranonce: быстрый ASIC
+ * исчерпывает его за доли секунды и ждёт новое задание с новым midstate.
+ * При аренде соединение получает диапазон из N extranonce
+ * (ExtrannonceManager::lease_extranonces), а задание CMD_NEW_JOB_LEASE
+ * несёт всё, чтобы контроллер ASIC сам строил midstate для каждого
+ * extranonce диапазона:
+ * - midstate первых 64 байт coinbase (не зависят от extranonce)
+ * - хвост coinbase (46 байт) с extranonce начала диапазона
+ * - version и prev_block заголовка
+ * 
+ * Блоки Quaxis пустые (только coinbase), поэтому merkle path пуст и
+ * merkle_root = txid coinbase. Одно задание покрывает N × 2^32 nonce.
+ */
+
+#pragma once
+
+#include "job.hpp"
+#include "../bitcoin/block.hpp"
+
+#include <cstdint>
+#include <optional>
+
+namespace quaxis::mining {
+
+/**
+ * @brief Заполнить данные аренды extranonce в задании
+ * 
+ * job.extranonce - начало диапазона. Аренда возможна только для
+ * стандартной coinbase (COINBASE_SIZE байт, extranonce в начале хвоста).
+ * 
+ * @param job Задание (extranonce уже назначен)
+ * @param block_template Шаблон, из которого построено задание
+ * @param count Размер диапазона (меньше 2 - задание без аренды)
+ * @return true если аренда записана в задание
+ */
+bool assign_extranonce_lease(
+    Job& job,
+    const bitcoin::BlockTemplate& block_template,
+    uint32_t count
+) noexcept;
+
+/**
+ * @brief Заголовок для extranonce из аренды задания
+ * 
+ * Повторяет вычисление контроллера ASIC: txid coinbase с extranonce
+ * job.extranonce + offset и заголовок с этим merkle_root (nonce = 0).
+ * 
+ * @param job Задание с арендой
+ * @param offset Смещение extranonce от начала диапазона
+ * @return std::optional<bitcoin::BlockHeader> Заголовок или nullopt,
+ *         если offset вне аренды
+ */
+[[nodiscard]] std::optional<bitcoin::BlockHeader> leased_header(
+    const Job& job,
+    uint32_t offset
+) noexcept;
+
+} // namespace quaxis::mining
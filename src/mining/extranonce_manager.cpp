@@ -5,46 +5,161 @@
 
 #include "extranonce_manager.hpp"
 
+#include <algorithm>
+
 namespace quaxis::mining {
 
-ExtrannonceManager::ExtrannonceManager(uint64_t start_value)
-    : next_extranonce_(start_value) {}
+ExtrannonceManager::ExtrannonceManager(uint64_t start_value, uint64_t end_value)
+    : next_extranonce_(start_value)
+    , end_value_(end_value) {}
 
 uint64_t ExtrannonceManager::assign_extranonce(uint32_t connection_id) {
-    std::lock_guard<std::mutex> lock(mutex_);
+    return lease_extranonces(connection_id, 1).start;
+}
+
+ExtranonceLease ExtrannonceManager::lease_extranonces(uint32_t connection_id, uint32_t count) {
+    count = count == 0 ? 1 : count;
     
-    // Get current value and increment atomically
-    uint64_t extranonce = next_extranonce_.fetch_add(1, std::memory_order_relaxed);
+    {
+        Shard& shard = shard_for(connection_id);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        
+        // Prefer a recycled range of the same size, otherwise take fresh values
+        ExtranonceLease lease;
+        auto free_it = std::find_if(shard.free.rbegin(), shard.free.rend(),
+                                    [count](const ExtranonceLease& l) { return l.count == count; });
+        if (free_it != shard.free.rend()) {
+            lease = *free_it;
+            *free_it = shard.free.back();
+            shard.free.pop_back();
+        } else {
+            lease = take_fresh(count);
+        }
+        if (lease.count != 0) {
+            bind_locked(shard, connection_id, lease);
+            return lease;
+        }
+    }
     
-    // Associate with connection
-    connection_extranonces_[connection_id] = extranonce;
+    // Range exhausted: a recycled range from another shard (taken without
+    // holding this shard's lock), otherwise the connection keeps nothing
+    ExtranonceLease lease = reserve_extranonces(count);
+    if (lease.count != 0) {
+        bind_lease(connection_id, lease);
+    }
+    return lease;
+}
+
+ExtranonceLease ExtrannonceManager::reserve_extranonces(uint32_t count) {
+    count = count == 0 ? 1 : count;
+    
+    // No connection ID yet: any shard's recycled range will do
+    for (Shard& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto free_it = std::find_if(shard.free.begin(), shard.free.end(),
+                                    [count](const ExtranonceLease& l) { return l.count == count; });
+        if (free_it != shard.free.end()) {
+            ExtranonceLease lease = *free_it;
+            *free_it = shard.free.back();
+            shard.free.pop_back();
+            return lease;
+        }
+    }
     
-    return extranonce;
+    return take_fresh(count);
+}
+
+ExtranonceLease ExtrannonceManager::take_fresh(uint32_t count) noexcept {
+    // CAS instead of fetch_add: the counter must not run past end_value_
+    uint64_t current = next_extranonce_.load(std::memory_order_relaxed);
+    do {
+        if (current >= end_value_ || end_value_ - current < count) {
+            return ExtranonceLease{0, 0};
+        }
+    } while (!next_extranonce_.compare_exchange_weak(current, current + count, std::memory_order_relaxed));
+    return ExtranonceLease{current, count};
+}
+
+void ExtrannonceManager::bind_lease(uint32_t connection_id, ExtranonceLease lease) {
+    Shard& shard = shard_for(connection_id);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    bind_locked(shard, connection_id, lease);
+}
+
+void ExtrannonceManager::bind_locked(Shard& shard, uint32_t connection_id, ExtranonceLease lease) {
+    // Associate with connection (a reassigned connection's old range is quarantined)
+    auto [it, inserted] = shard.connection_extranonces.try_emplace(connection_id, lease);
+    if (inserted) {
+        active_count_.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        shard.released.push_back(it->second);
+        it->second = lease;
+    }
 }
 
 void ExtrannonceManager::release_extranonce(uint32_t connection_id) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    connection_extranonces_.erase(connection_id);
+    Shard& shard = shard_for(connection_id);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    
+    auto it = shard.connection_extranonces.find(connection_id);
+    if (it == shard.connection_extranonces.end()) {
+        return;
+    }
+    shard.released.push_back(it->second);
+    shard.connection_extranonces.erase(it);
+    active_count_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+std::size_t ExtrannonceManager::recycle_released() {
+    std::size_t recycled = 0;
+    for (Shard& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        recycled += shard.released.size();
+        shard.free.insert(shard.free.end(), shard.released.begin(), shard.released.end());
+        shard.released.clear();
+    }
+    return recycled;
+}
+
+std::size_t ExtrannonceManager::released_count() const {
+    std::size_t count = 0;
+    for (const Shard& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        count += shard.released.size();
+    }
+    return count;
 }
 
 std::optional<uint64_t> ExtrannonceManager::get_extranonce(uint32_t connection_id) const {
-    std::lock_guard<std::mutex> lock(mutex_);
+    const Shard& shard = shard_for(connection_id);
+    std::lock_guard<std::mutex> lock(shard.mutex);
     
-    auto it = connection_extranonces_.find(connection_id);
-    if (it != connection_extranonces_.end()) {
+    auto it = shard.connection_extranonces.find(connection_id);
+    if (it != shard.connection_extranonces.end()) {
+        return it->second.start;
+    }
+    return std::nullopt;
+}
+
+std::optional<ExtranonceLease> ExtrannonceManager::get_lease(uint32_t connection_id) const {
+    const Shard& shard = shard_for(connection_id);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    
+    auto it = shard.connection_extranonces.find(connection_id);
+    if (it != shard.connection_extranonces.end()) {
         return it->second;
     }
     return std::nullopt;
 }
 
 bool ExtrannonceManager::has_extranonce(uint32_t connection_id) const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return connection_extranonces_.contains(connection_id);
+    const Shard& shard = shard_for(connection_id);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    return shard.connection_extranonces.contains(connection_id);
 }
 
 std::size_t ExtrannonceManager::active_count() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return connection_extranonces_.size();
+    return active_count_.load(std::memory_order_relaxed);
 }
 
 uint64_t ExtrannonceManager::peek_next_extranonce() const noexcept {
@@ -52,16 +167,62 @@ uint64_t ExtrannonceManager::peek_next_extranonce() const noexcept {
 }
 
 std::vector<uint32_t> ExtrannonceManager::get_active_connections() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    
     std::vector<uint32_t> connections;
-    connections.reserve(connection_extranonces_.size());
+    connections.reserve(active_count());
     
-    for (const auto& [id, _] : connection_extranonces_) {
-        connections.push_back(id);
+    for (const Shard& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        for (const auto& [id, _] : shard.connection_extranonces) {
+            connections.push_back(id);
+        }
     }
     
     return connections;
 }
 
+std::vector<std::pair<uint32_t, uint64_t>> ExtrannonceManager::get_active_assignments() const {
+    std::vector<std::pair<uint32_t, uint64_t>> assignments;
+    assignments.reserve(active_count());
+    
+    for (const Shard& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        for (const auto& [id, lease] : shard.connection_extranonces) {
+            assignments.emplace_back(id, lease.start);
+        }
+    }
+    
+    std::sort(assignments.begin(), assignments.end());
+    return assignments;
+}
+
+std::vector<std::pair<uint32_t, ExtranonceLease>> ExtrannonceManager::get_active_leases() const {
+    std::vector<std::pair<uint32_t, ExtranonceLease>> leases;
+    leases.reserve(active_count());
+    
+    for (const Shard& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        for (const auto& [id, lease] : shard.connection_extranonces) {
+            leases.emplace_back(id, lease);
+        }
+    }
+    
+    std::sort(leases.begin(), leases.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+    return leases;
+}
+
+void ExtrannonceManager::restore_leases(std::span<const std::pair<uint32_t, ExtranonceLease>> leases,
+                                        uint64_t next_extranonce) {
+    uint64_t end = next_extranonce;
+    for (const auto& [id, lease] : leases) {
+        bind_lease(id, lease);
+        end = std::max(end, lease.start + lease.count);
+    }
+    
+    // The counter only moves forward: values already handed out here stay unique
+    uint64_t current = next_extranonce_.load(std::memory_order_relaxed);
+    while (current < end &&
+           !next_extranonce_.compare_exchange_weak(current, end, std::memory_order_relaxed)) {}
+}
+
 } // namespace quaxis::mining
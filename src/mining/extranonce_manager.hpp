@@ -11,20 +11,64 @@
  * - Tracks active extranonces per connection
  * - Releases extranonces when connections close
  * - Ensures no two connections ever have the same extranonce
+ * 
+ * The table is split into SHARD_COUNT shards keyed by connection ID, each
+ * with its own small mutex, so connects/disconnects of different ASICs
+ * (e.g. a fleet reboot) do not serialize on one lock. Fresh values come
+ * from a single atomic counter.
+ * 
+ * Released extranonces are quarantined and become reusable only after
+ * recycle_released() (called by JobManager on a confirmed new block):
+ * work done with the old value belongs to the previous template, so a
+ * new connection reusing it cannot repeat those hashes.
+ * 
+ * A connection may instead lease a contiguous range of extranonces
+ * (lease_extranonces): the ASIC controller then rolls extranonce itself
+ * inside the range (see extranonce_lease.hpp). A plain assignment is a
+ * lease of one value.
+ * 
+ * Ranges can also be reserved ahead of any connection
+ * (reserve_extranonces) and bound to it on accept (bind_lease).
+ * 
+ * Fresh values never reach end_value: a node that owns only a slice of
+ * the extranonce space (proxy site, cluster node) would otherwise hand
+ * out its neighbour's values. Past the end only recycled ranges are
+ * available; without one the allocation is refused and returns 0
+ * (0 is never a valid extranonce, the space starts at base + 1).
  */
 
 #pragma once
 
 #include "../core/types.hpp"
 
+#include <array>
 #include <atomic>
+#include <limits>
 #include <unordered_map>
 #include <mutex>
 #include <optional>
+#include <span>
+#include <utility>
+#include <vector>
 #include <cstdint>
 
 namespace quaxis::mining {
 
+/**
+ * @brief Contiguous extranonce range held by one connection
+ */
+struct ExtranonceLease {
+    /// @brief First extranonce of the range
+    uint64_t start = 0;
+    
+    /// @brief Number of extranonces in the range (1 for a plain assignment)
+    uint32_t count = 1;
+    
+    [[nodiscard]] bool contains(uint64_t extranonce) const noexcept {
+        return extranonce >= start && extranonce - start < count;
+    }
+};
+
 /**
  * @brief Manager for per-connection extranonce values
  * 
@@ -38,12 +82,17 @@ namespace quaxis::mining {
  */
 class ExtrannonceManager {
 public:
+    /// @brief Number of shards (power of two)
+    static constexpr std::size_t SHARD_COUNT = 16;
+    
     /**
      * @brief Create extranonce manager
      * 
-     * @param start_value Initial extranonce value (default: 1)
+     * @param start_value Initial extranonce value (default: 1, must not be 0)
+     * @param end_value First value past the node's range (exclusive)
      */
-    explicit ExtrannonceManager(uint64_t start_value = 1);
+    explicit ExtrannonceManager(uint64_t start_value = 1,
+                                uint64_t end_value = std::numeric_limits<uint64_t>::max());
     
     ~ExtrannonceManager() = default;
     
@@ -54,25 +103,82 @@ public:
     /**
      * @brief Assign a unique extranonce to a new connection
      * 
-     * Each call returns a new unique extranonce value.
+     * Each call returns a value not held by any other connection:
+     * a recycled one from this connection's shard if available,
+     * otherwise a fresh one from the counter.
      * The value is associated with the given connection ID.
      * 
      * @param connection_id Unique identifier for the ASIC connection
-     * @return uint64_t The assigned extranonce value
+     * @return uint64_t The assigned extranonce value (0 - range exhausted,
+     *         nothing is bound to the connection)
      */
     [[nodiscard]] uint64_t assign_extranonce(uint32_t connection_id);
     
+    /**
+     * @brief Lease a contiguous extranonce range to a connection
+     * 
+     * Same rules as assign_extranonce(): a recycled range of the same
+     * size from this connection's shard, otherwise count fresh values.
+     * No value of the range is held by any other connection.
+     * 
+     * @param connection_id Unique identifier for the ASIC connection
+     * @param count Range size (0 is treated as 1)
+     * @return ExtranonceLease The leased range ({0, 0} - range exhausted,
+     *         nothing is bound to the connection)
+     */
+    [[nodiscard]] ExtranonceLease lease_extranonces(uint32_t connection_id, uint32_t count);
+    
+    /**
+     * @brief Take a range that is not bound to any connection yet
+     * 
+     * Used to pre-lease extranonces before the connection exists
+     * (JobManager pre-lease pool): a recycled range of the same size
+     * from any shard, otherwise count fresh values. The range is held
+     * by nobody until bind_lease().
+     * 
+     * @param count Range size (0 is treated as 1)
+     * @return ExtranonceLease The reserved range ({0, 0} - range exhausted)
+     */
+    [[nodiscard]] ExtranonceLease reserve_extranonces(uint32_t count);
+    
+    /**
+     * @brief Bind a range from reserve_extranonces() to a connection
+     * 
+     * A connection that already held a range has it quarantined, as
+     * in lease_extranonces().
+     * 
+     * @param connection_id Unique identifier for the ASIC connection
+     * @param lease Reserved range
+     */
+    void bind_lease(uint32_t connection_id, ExtranonceLease lease);
+    
     /**
      * @brief Release extranonce when connection closes
      * 
      * Removes the association between connection and extranonce.
-     * Note: The extranonce value is NOT reused to prevent any chance
-     * of duplicate work if connections rapidly reconnect.
+     * Note: The extranonce value is NOT reused until recycle_released()
+     * to prevent any chance of duplicate work if connections rapidly
+     * reconnect within the same block template.
      * 
      * @param connection_id Connection to release
      */
     void release_extranonce(uint32_t connection_id);
     
+    /**
+     * @brief Make released extranonces available for reuse
+     * 
+     * Call only when the block template changes for good (new confirmed
+     * tip): hashes done with released values are then worthless.
+     * 
+     * @return std::size_t Number of ranges moved to the free lists
+     */
+    std::size_t recycle_released();
+    
+    /**
+     * @brief Number of released ranges waiting for recycle_released()
+     */
+    [[nodiscard]] std::size_t released_count() const;
+    
     /**
      * @brief Get extranonce for a connection
      * 
@@ -81,6 +187,14 @@ public:
      */
     [[nodiscard]] std::optional<uint64_t> get_extranonce(uint32_t connection_id) const;
     
+    /**
+     * @brief Get the extranonce range of a connection
+     * 
+     * @param connection_id Connection to look up
+     * @return std::optional<ExtranonceLease> Range or nullopt if not found
+     */
+    [[nodiscard]] std::optional<ExtranonceLease> get_lease(uint32_t connection_id) const;
+    
     /**
      * @brief Check if a connection has an assigned extranonce
      * 
@@ -97,9 +211,11 @@ public:
     [[nodiscard]] std::size_t active_count() const;
     
     /**
-     * @brief Get the next extranonce that will be assigned
+     * @brief Get the next fresh extranonce value
+     * 
+     * Recycled values are handed out before fresh ones.
      * 
-     * @return uint64_t Next extranonce value
+     * @return uint64_t Next extranonce value from the counter
      */
     [[nodiscard]] uint64_t peek_next_extranonce() const noexcept;
     
@@ -109,16 +225,85 @@ public:
      * @return std::vector<uint32_t> List of connection IDs
      */
     [[nodiscard]] std::vector<uint32_t> get_active_connections() const;
+    
+    /**
+     * @brief Get all active (connection_id, extranonce) pairs
+     * 
+     * Snapshot taken shard by shard, sorted by connection ID
+     * (the value is the start of the connection's range).
+     * 
+     * @return std::vector<std::pair<uint32_t, uint64_t>> Assignments
+     */
+    [[nodiscard]] std::vector<std::pair<uint32_t, uint64_t>> get_active_assignments() const;
+    
+    /**
+     * @brief Get all active (connection_id, range) pairs
+     * 
+     * Like get_active_assignments() but with the full range; used to
+     * hand the table over to a new process (see network/handoff.hpp).
+     * 
+     * @return std::vector<std::pair<uint32_t, ExtranonceLease>> Leases sorted by connection ID
+     */
+    [[nodiscard]] std::vector<std::pair<uint32_t, ExtranonceLease>> get_active_leases() const;
+    
+    /**
+     * @brief Restore leases handed over by a previous process
+     * 
+     * Binds each range to its connection as is and moves the fresh
+     * counter to at least next_extranonce, so no restored value (nor
+     * one the previous process quarantined) is handed out again.
+     * 
+     * @param leases Ranges from get_active_leases()
+     * @param next_extranonce peek_next_extranonce() of the previous process
+     */
+    void restore_leases(std::span<const std::pair<uint32_t, ExtranonceLease>> leases,
+                        uint64_t next_extranonce);
 
 private:
+    /**
+     * @brief One shard of the connection table
+     * 
+     * Cache-line aligned so that shards locked by different threads
+     * do not share a line.
+     */
+    struct alignas(64) Shard {
+        /// @brief Protects all fields of the shard
+        mutable std::mutex mutex;
+        
+        /// @brief Map of connection_id -> extranonce range
+        std::unordered_map<uint32_t, ExtranonceLease> connection_extranonces;
+        
+        /// @brief Released ranges waiting for the next template
+        std::vector<ExtranonceLease> released;
+        
+        /// @brief Ranges safe to hand out again
+        std::vector<ExtranonceLease> free;
+    };
+    
+    static_assert((SHARD_COUNT & (SHARD_COUNT - 1)) == 0, "SHARD_COUNT must be a power of two");
+    
+    /// @brief Take count fresh values from the counter ({0, 0} past end_value_)
+    [[nodiscard]] ExtranonceLease take_fresh(uint32_t count) noexcept;
+    
+    /// @brief Associate a range with a connection (caller holds shard.mutex)
+    void bind_locked(Shard& shard, uint32_t connection_id, ExtranonceLease lease);
+    
+    /// @brief Shard for a connection (Fibonacci hashing: IDs are sequential)
+    [[nodiscard]] Shard& shard_for(uint32_t connection_id) const noexcept {
+        return shards_[(connection_id * 2654435769u) >> 28 & (SHARD_COUNT - 1)];
+    }
+    
     /// @brief Next extranonce value to assign
     std::atomic<uint64_t> next_extranonce_;
     
-    /// @brief Map of connection_id -> extranonce
-    std::unordered_map<uint32_t, uint64_t> connection_extranonces_;
+    /// @brief First value past the node's range
+    const uint64_t end_value_;
+    
+    /// @brief Number of connections with an extranonce
+    std::atomic<std::size_t> active_count_{0};
     
-    /// @brief Mutex for thread-safe access to map
-    mutable std::mutex mutex_;
+    /// @brief Connection table shards
+    mutable std::array<Shard, SHARD_COUNT> shards_;
 };
 
 } // namespace quaxis::mining
@@ -15,6 +15,19 @@
  * 2. Для каждого nonce вычисляет SHA256(SHA256(midstate || tail))
  * 3. Сравнивает хеш с target
  * 4. При нахождении валидного nonce отправляет share (job_id + nonce)
+ * 
+ * Задание с version rolling (version_count > 1) несёт до MAX_VERSION_SLOTS
+ * midstate для разных версий при общем хвосте заголовка: за одну
+ * рассылку ASIC получает в K раз больше пространства перебора.
+ * 
+ * Задание с арендой extranonce (extranonce_lease > 0) несёт coinbase и
+ * начало заголовка: ASIC сам перебирает extranonce из диапазона
+ * [extranonce, extranonce + extranonce_lease) и пересчитывает midstate,
+ * не запрашивая новое задание после каждых 2^32 nonce.
+ * 
+ * Задание с локальным version rolling (version_mask != 0) несёт первые
+ * 64 байта заголовка: контроллер ASIC сам перебирает биты маски BIP320
+ * и считает midstate каждой версии - одно задание на блок.
  */
 
 #pragma once
@@ -49,6 +62,9 @@ struct Job {
     /// @brief Timestamp блока
     uint32_t timestamp = 0;
     
+    /// @brief Timestamp до последнего CMD_UPDATE_TIME (0 - не сдвигался)
+    uint32_t previous_timestamp = 0;
+    
     /// @brief Compact target (bits)
     uint32_t bits = 0;
     
@@ -58,15 +74,69 @@ struct Job {
     /// @brief Высота блока
     uint32_t height = 0;
     
+    /// @brief Extranonce, для которого построен midstate (0 - общий шаблон)
+    uint64_t extranonce = 0;
+    
     /// @brief Target в 256-битном формате
     Hash256 target{};
     
     /// @brief Это speculative (spy mining) задание?
     bool is_speculative = false;
     
+    /// @brief Поколение блока (JobTable::generation() на момент создания)
+    uint32_t generation = 0;
+    
     /// @brief Время создания задания
     std::chrono::steady_clock::time_point created_at;
     
+    /// @brief Последние 4 байта merkle root (общие для всех версий)
+    std::array<uint8_t, 4> merkle_tail{};
+    
+    /// @brief Количество слотов версий (0 - обычное задание с одним midstate)
+    uint8_t version_count = 0;
+    
+    /// @brief Версии слотов (BIP320: отличаются только rolling битами)
+    std::array<uint32_t, constants::MAX_VERSION_SLOTS> versions{};
+    
+    /// @brief Midstate для каждой версии (version_midstates[0] == midstate)
+    std::array<crypto::Sha256State, constants::MAX_VERSION_SLOTS> version_midstates{};
+    
+    /// @brief Размер аренды extranonce (0 - ASIC не перебирает extranonce сам)
+    uint32_t extranonce_lease = 0;
+    
+    /// @brief Версия заголовка (задание с арендой)
+    uint32_t version = 0;
+    
+    /// @brief Хеш предыдущего блока (задание с арендой)
+    Hash256 prev_block{};
+    
+    /// @brief Midstate первых 64 байт coinbase (задание с арендой)
+    crypto::Sha256State coinbase_midstate{};
+    
+    /// @brief Coinbase после первых 64 байт, extranonce = this->extranonce
+    std::array<uint8_t, constants::COINBASE_TAIL_SIZE> coinbase_tail{};
+    
+    /// @brief Маска BIP320, перебираемая ASIC (0 - без локального version rolling)
+    uint32_t version_mask = 0;
+    
+    /// @brief Merkle root заголовка (задание с локальным version rolling)
+    Hash256 merkle_root{};
+    
+    /**
+     * @brief Midstate для слота версии из share
+     * 
+     * Обычное задание имеет единственный слот 0.
+     * 
+     * @param slot Номер слота
+     * @return const crypto::Sha256State* Midstate или nullptr для чужого слота
+     */
+    [[nodiscard]] const crypto::Sha256State* slot_midstate(uint8_t slot) const noexcept {
+        if (version_count == 0) {
+            return slot == 0 ? &midstate : nullptr;
+        }
+        return slot < version_count ? &version_midstates[slot] : nullptr;
+    }
+    
     /**
      * @brief Сериализовать задание в 48-байтный формат для ASIC
      * 
@@ -85,9 +155,9 @@ struct Job {
      * @brief Десериализовать задание из 48-байтного формата
      * 
      * @param data 48 байт сериализованного задания
-     * @return Result<Job> Задание или ошибка
+     * @return FastResult<Job> Задание или ошибка
      */
-    [[nodiscard]] static Result<Job> deserialize(ByteSpan data);
+    [[nodiscard]] static FastResult<Job> deserialize(ByteSpan data);
     
     /**
      * @brief Проверить, устарело ли задание
@@ -102,6 +172,33 @@ struct Job {
     [[nodiscard]] bool is_stale(uint32_t max_age = 60) const noexcept;
 };
 
+// =============================================================================
+// Предвычисленное задание
+// =============================================================================
+
+/**
+ * @brief Заранее подготовленное задание для одного соединения
+ * 
+ * Строится TemplateCache для ожидаемого следующего блока, чтобы при его
+ * появлении рассылка сводилась к memcpy готовых 48 байт в сокет.
+ */
+struct PrecomputedJob {
+    /// @brief ID соединения (ключ ExtrannonceManager)
+    uint32_t connection_id = 0;
+    
+    /// @brief Extranonce соединения
+    uint64_t extranonce = 0;
+    
+    /// @brief Merkle root для этого extranonce (coinbase txid)
+    Hash256 merkle_root{};
+    
+    /// @brief Задание (job_id назначается JobManager при активации)
+    Job job{};
+    
+    /// @brief Сериализованное задание, готовое к отправке
+    std::array<uint8_t, constants::JOB_MESSAGE_SIZE> message{};
+};
+
 // =============================================================================
 // Структура share (ответ от ASIC)
 // =============================================================================
@@ -118,6 +215,18 @@ struct Share {
     /// @brief Найденный nonce
     uint32_t nonce = 0;
     
+    /// @brief Слот версии задания (RSP_SHARE_SLOT, иначе 0)
+    uint8_t version_slot = 0;
+    
+    /// @brief Смещение extranonce в аренде задания (RSP_SHARE_LEASED, иначе 0)
+    uint32_t extranonce_offset = 0;
+    
+    /// @brief Версия, перебранная ASIC (RSP_SHARE_ROLLED, иначе 0)
+    uint32_t version = 0;
+    
+    /// @brief Соединение ASIC (заполняет сервер, в протоколе не передаётся)
+    uint32_t connection_id = 0;
+    
     /**
      * @brief Сериализовать share в 8-байтный формат
      * 
@@ -129,9 +238,9 @@ struct Share {
      * @brief Десериализовать share из 8-байтного формата
      * 
      * @param data 8 байт данных
-     * @return Result<Share> Share или ошибка
+     * @return FastResult<Share> Share или ошибка
      */
-    [[nodiscard]] static Result<Share> deserialize(ByteSpan data);
+    [[nodiscard]] static FastResult<Share> deserialize(ByteSpan data);
 };
 
 // =============================================================================
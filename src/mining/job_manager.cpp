@@ -8,9 +8,21 @@
 
 #include "job_manager.hpp"
 #include "extranonce_manager.hpp"
+#include "extranonce_lease.hpp"
+#include "job_table.hpp"
+#include "version_rolling.hpp"
 #include "../core/byte_order.hpp"
+#include "../core/clock.hpp"
+#include "../core/latency_trace.hpp"
+#include "../core/mtp_calculator.hpp"
+#include "../core/task_pool.hpp"
 
 #include <algorithm>
+#include <array>
+#include <cstring>
+#include <optional>
+#include <thread>
+#include <vector>
 
 namespace quaxis::mining {
 
@@ -45,9 +57,9 @@ std::array<uint8_t, constants::JOB_MESSAGE_SIZE> Job::serialize() const noexcept
     return data;
 }
 
-Result<Job> Job::deserialize(ByteSpan data) {
+FastResult<Job> Job::deserialize(ByteSpan data) {
     if (data.size() < constants::JOB_MESSAGE_SIZE) {
-        return Err<Job>(ErrorCode::MiningInvalidJob, "Недостаточно данных для задания");
+        return FastErr<Job>(ErrorCode::MiningInvalidJob, "Недостаточно данных для задания");
     }
     
     Job job;
@@ -74,13 +86,13 @@ Result<Job> Job::deserialize(ByteSpan data) {
     // job_id
     job.job_id = read_le32(ptr);
     
-    job.created_at = std::chrono::steady_clock::now();
+    job.created_at = core::CoarseClock::now();
     
     return job;
 }
 
 bool Job::is_stale(uint32_t max_age) const noexcept {
-    auto now = std::chrono::steady_clock::now();
+    auto now = core::CoarseClock::now();
     auto age = std::chrono::duration_cast<std::chrono::seconds>(now - created_at);
     return age.count() > static_cast<int64_t>(max_age);
 }
@@ -98,9 +110,9 @@ std::array<uint8_t, constants::SHARE_MESSAGE_SIZE> Share::serialize() const noex
     return data;
 }
 
-Result<Share> Share::deserialize(ByteSpan data) {
+FastResult<Share> Share::deserialize(ByteSpan data) {
     if (data.size() < constants::SHARE_MESSAGE_SIZE) {
-        return Err<Share>(ErrorCode::MiningInvalidNonce, "Недостаточно данных для share");
+        return FastErr<Share>(ErrorCode::MiningInvalidNonce, "Недостаточно данных для share");
     }
     
     Share share;
@@ -126,111 +138,299 @@ struct JobManager::Impl {
     // Per-connection extranonce management
     ExtrannonceManager extranonce_manager;
     
-    // Текущий шаблон блока
-    std::optional<bitcoin::BlockTemplate> current_template;
+    // Текущий шаблон блока (неизменяемый, разделяется всеми заданиями)
+    std::shared_ptr<const bitcoin::BlockTemplate> current_template;
     bool is_speculative = false;
     
-    // Активные задания (job_id -> Job)
-    std::unordered_map<uint32_t, Job> jobs;
+    // Сериализованный блок текущего шаблона для быстрой отправки
+    std::shared_ptr<const bitcoin::BlockSkeleton> skeleton;
+    
+    // Шаблон и скелет tip, на котором начался speculative майнинг:
+    // к ним возвращает rollback_speculative_block()
+    std::shared_ptr<const bitcoin::BlockTemplate> rollback_template;
+    std::shared_ptr<const bitcoin::BlockSkeleton> rollback_skeleton;
+    
+    // Скелеты прежних coinbase шаблона (refresh_coinbase), от старых к
+    // новым: задания с job_id до first - по этой coinbase или более старой
+    std::vector<std::pair<uint32_t, std::shared_ptr<const bitcoin::BlockSkeleton>>> previous_skeletons;
+    
+    // Задания с job_id до этого - по вытесненным скелетам
+    std::optional<uint32_t> evicted_before;
+    
+    // Активные задания: кольцевой буфер, слот = job_id % capacity.
+    // Пишется под mutex, читается без блокировок (seqlock на слот).
+    JobTable jobs;
     
     // Счётчики
     uint32_t next_job_id = 1;
     
-    Impl(const MiningConfig& cfg, bitcoin::CoinbaseBuilder builder)
+    // Потоки regenerate_all()
+    std::once_flag regenerate_pool_once;
+    std::unique_ptr<core::TaskPool> pool;
+    
+    // mining.prelease_pool: extranonce без соединения с готовыми кадрами
+    std::vector<PrecomputedJob> prelease;
+    std::shared_ptr<const bitcoin::BlockTemplate> prelease_template;
+    bool prelease_refreshing = false;
+    
+    Impl(const MiningConfig& cfg, bitcoin::CoinbaseBuilder builder,
+         uint64_t extranonce_start, uint64_t extranonce_end)
         : config(cfg)
         , coinbase_builder(std::move(builder))
-        , extranonce_manager(1)  // Start extranonces from 1
+        , extranonce_manager(extranonce_start, extranonce_end)
+        , jobs(cfg.job_queue_size)
     {}
     
-    void clear_jobs() {
-        jobs.clear();
+    /// @brief Размер диапазона extranonce одного соединения
+    [[nodiscard]] uint32_t lease_size() const noexcept {
+        return config.extranonce_lease > 1 ? static_cast<uint32_t>(config.extranonce_lease) : 1;
     }
     
-    Job create_job() {
-        if (!current_template) {
-            return {};
+    /**
+     * @brief Midstate, хвост merkle root и сообщения заданий по шаблону
+     * 
+     * Coinbase txid и midstate заголовков - кусками по REGENERATE_CHUNK
+     * на многоканальном SHA256. job_id не назначается.
+     */
+    static void build_jobs(const bitcoin::BlockTemplate& tmpl, std::span<PrecomputedJob> batch) noexcept {
+        std::array<uint64_t, REGENERATE_CHUNK> extranonces;
+        std::array<Hash256, REGENERATE_CHUNK> merkle_roots;
+        std::array<crypto::Sha256State, REGENERATE_CHUNK> midstates;
+        
+        for (std::size_t start = 0; start < batch.size(); start += REGENERATE_CHUNK) {
+            const std::size_t n = std::min(REGENERATE_CHUNK, batch.size() - start);
+            for (std::size_t i = 0; i < n; ++i) {
+                extranonces[i] = batch[start + i].extranonce;
+            }
+            tmpl.merkle_roots_for_extranonces(std::span(extranonces).first(n), merkle_roots);
+            tmpl.midstates_for_merkle_roots(std::span(merkle_roots).first(n), midstates);
+            
+            for (std::size_t i = 0; i < n; ++i) {
+                PrecomputedJob& pj = batch[start + i];
+                pj.merkle_root = merkle_roots[i];
+                pj.job.midstate = midstates[i];
+                std::memcpy(pj.job.merkle_tail.data(), pj.merkle_root.data() + 28, pj.job.merkle_tail.size());
+                pj.job.timestamp = tmpl.header.timestamp;
+                pj.job.bits = tmpl.header.bits;
+                pj.job.nonce = 0;
+                pj.job.height = tmpl.height;
+                pj.job.extranonce = pj.extranonce;
+                pj.job.target = tmpl.target;
+                pj.message = pj.job.serialize();
+            }
+        }
+    }
+    
+    /// @brief Все задания устарели: O(1), слоты переиспользует кольцо
+    void invalidate_jobs() noexcept {
+        jobs.advance_generation();
+        previous_skeletons.clear();
+        evicted_before.reset();
+    }
+    
+    /// @brief job_id выдан раньше first (с учётом переполнения счётчика)
+    [[nodiscard]] static bool issued_before(uint32_t job_id, uint32_t first) noexcept {
+        return static_cast<int32_t>(job_id - first) < 0;
+    }
+    
+    /**
+     * @brief Скелет coinbase, по которой выдано задание (под mutex)
+     * 
+     * @return nullptr - задание старше COINBASE_REVISIONS смен coinbase
+     */
+    [[nodiscard]] std::shared_ptr<const bitcoin::BlockSkeleton> skeleton_for(uint32_t job_id) const {
+        if (evicted_before && issued_before(job_id, *evicted_before)) {
+            return nullptr;
+        }
+        for (const auto& [until, previous] : previous_skeletons) {
+            if (issued_before(job_id, until)) {
+                return previous;
+            }
+        }
+        return skeleton;
+    }
+    
+    /**
+     * @brief Задания соединений с текущими extranonce, по возрастанию connection_id
+     * 
+     * Вызывается под mutex; midstate и сообщения досчитывает build_jobs().
+     */
+    std::vector<PrecomputedJob> collect_jobs_locked(std::span<const uint32_t> connection_ids) const {
+        std::vector<PrecomputedJob> batch;
+        batch.reserve(connection_ids.size());
+        for (uint32_t connection_id : connection_ids) {
+            if (auto lease = extranonce_manager.get_lease(connection_id)) {
+                PrecomputedJob pj;
+                pj.connection_id = connection_id;
+                pj.extranonce = lease->start;
+                batch.push_back(pj);
+            }
         }
         
+        // Порядок Server::broadcast_job_set
+        std::sort(batch.begin(), batch.end(), [](const PrecomputedJob& a, const PrecomputedJob& b) {
+            return a.connection_id < b.connection_id;
+        });
+        return batch;
+    }
+    
+    [[nodiscard]] uint32_t allocate_job_id() noexcept {
+        uint32_t id = next_job_id++;
+        if (next_job_id == 0) {
+            next_job_id = 1;  // 0 зарезервирован под пустой слот
+        }
+        return id;
+    }
+    
+    Job make_job(
+        const bitcoin::BlockHeader& header,
+        const crypto::Sha256State& midstate,
+        uint64_t extranonce,
+        uint32_t lease = 0,
+        uint32_t ntime_offset = 0
+    ) noexcept {
         Job job;
-        job.job_id = next_job_id++;
-        job.midstate = current_template->header_midstate;
-        job.timestamp = current_template->header.timestamp;
+        job.job_id = allocate_job_id();
+        job.midstate = midstate;
+        std::memcpy(job.merkle_tail.data(), header.merkle_root.data() + 28, job.merkle_tail.size());
+        assign_version_slots(job, header, config.version_slots);
+        job.timestamp = current_template->header.timestamp + ntime_offset;
         job.bits = current_template->header.bits;
         job.nonce = 0;
         job.height = current_template->height;
+        job.extranonce = extranonce;
         job.target = current_template->target;
         job.is_speculative = is_speculative;
-        job.created_at = std::chrono::steady_clock::now();
+        job.generation = jobs.generation();
+        job.created_at = core::CoarseClock::now();
+        assign_extranonce_lease(job, *current_template, lease);
+        if (config.local_version_rolling) {
+            assign_rolling(job, header, extranonce);
+        }
+        jobs.publish(job);
+        return job;
+    }
+    
+    /**
+     * @brief Локальный version rolling: вся маска или доля соединения
+     * 
+     * Доля - по extranonce соединения (mining.version_partition_bits):
+     * соседние extranonce перебирают непересекающиеся версии.
+     */
+    void assign_rolling(Job& job, const bitcoin::BlockHeader& header, uint64_t extranonce) const noexcept {
+        if (config.version_partition_bits == 0) {
+            assign_local_version_rolling(job, header);
+            return;
+        }
+        assign_local_version_rolling(job, header, partition_version_space(
+            VERSION_ROLLING_MASK_DEFAULT, extranonce, static_cast<uint32_t>(config.version_partition_bits)));
+    }
+    
+    /**
+     * @brief Назначить job_id готовым заданиям и опубликовать их (под mutex)
+     * 
+     * @param batch Задания с midstate и сообщением; отключившиеся
+     *        соединения и устаревшие extranonce получают job_id = 0
+     * @return std::size_t Количество принятых заданий
+     */
+    std::size_t adopt_locked(std::span<PrecomputedJob> batch) {
+        if (!current_template) {
+            for (auto& pj : batch) {
+                pj.job.job_id = 0;
+            }
+            return 0;
+        }
         
-        // Сохраняем задание
-        jobs[job.job_id] = job;
+        auto now = core::CoarseClock::now();
+        std::size_t adopted = 0;
         
-        // Ограничиваем количество заданий
-        if (jobs.size() > config.job_queue_size) {
-            // Удаляем самое старое задание
-            auto oldest = std::min_element(jobs.begin(), jobs.end(),
-                [](const auto& a, const auto& b) {
-                    return a.second.job_id < b.second.job_id;
-                });
-            if (oldest != jobs.end()) {
-                jobs.erase(oldest);
+        for (auto& pj : batch) {
+            auto lease = extranonce_manager.get_lease(pj.connection_id);
+            if (!lease || lease->start != pj.extranonce) {
+                pj.job.job_id = 0;
+                continue;
+            }
+        
+            pj.job.job_id = allocate_job_id();
+            pj.job.is_speculative = is_speculative;
+            pj.job.generation = jobs.generation();
+            pj.job.created_at = now;
+        
+            if (config.version_slots > 1) {
+                // Слоты версий досчитываются здесь: кеш строит обычные задания
+                bitcoin::BlockHeader header = current_template->header;
+                header.merkle_root = pj.merkle_root;
+                assign_version_slots(pj.job, header, config.version_slots);
+            }
+            assign_extranonce_lease(pj.job, *current_template, lease->count);
+            if (config.local_version_rolling) {
+                bitcoin::BlockHeader header = current_template->header;
+                header.merkle_root = pj.merkle_root;
+                assign_rolling(pj.job, header, pj.extranonce);
+            }
+            write_le32(pj.message.data() + constants::JOB_MESSAGE_SIZE - constants::JOB_ID_SIZE, pj.job.job_id);
+        
+            jobs.publish(pj.job);
+            ++adopted;
+        
+            if (new_job_callback) {
+                new_job_callback(pj.job);
             }
         }
         
-        return job;
+        return adopted;
+    }
+    
+    /**
+     * @brief Пул regenerate_all() (создаётся при первом большом пакете)
+     * 
+     * @return core::TaskPool* nullptr, если пересборка однопоточная
+     */
+    core::TaskPool* regenerate_pool() {
+        std::call_once(regenerate_pool_once, [this] {
+            const std::size_t threads = config.regenerate_threads != 0
+                ? config.regenerate_threads
+                : std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+            if (threads > 1) {
+                pool = std::make_unique<core::TaskPool>(threads - 1);
+            }
+        });
+        return pool.get();
+    }
+    
+    Job create_job() {
+        if (!current_template) {
+            return {};
+        }
+        return make_job(current_template->header, current_template->header_midstate, 0);
     }
     
     /**
      * @brief Create a job with a specific extranonce
      * 
-     * This updates the template with the given extranonce and creates a job.
+     * Computes the midstate for this extranonce from the shared template
+     * without copying it: only the coinbase tail is hashed, on the stack.
      * Used for per-connection job creation.
      * 
      * @param extranonce The extranonce value for this job
+     * @param lease Size of the connection's extranonce range (ASIC rolls it)
      * @return Job The created job
      */
-    Job create_job_with_extranonce(uint64_t extranonce) {
+    Job create_job_with_extranonce(uint64_t extranonce, uint32_t lease = 0) {
         if (!current_template) {
             return {};
         }
-        
-        // Create a copy of the template and update it with this extranonce
-        auto updated_template = *current_template;
-        updated_template.update_extranonce(extranonce);
-        
-        Job job;
-        job.job_id = next_job_id++;
-        job.midstate = updated_template.header_midstate;
-        job.timestamp = updated_template.header.timestamp;
-        job.bits = updated_template.header.bits;
-        job.nonce = 0;
-        job.height = updated_template.height;
-        job.target = updated_template.target;
-        job.is_speculative = is_speculative;
-        job.created_at = std::chrono::steady_clock::now();
-        
-        // Store the job
-        jobs[job.job_id] = job;
-        
-        // Limit job count
-        if (jobs.size() > config.job_queue_size) {
-            auto oldest = std::min_element(jobs.begin(), jobs.end(),
-                [](const auto& a, const auto& b) {
-                    return a.second.job_id < b.second.job_id;
-                });
-            if (oldest != jobs.end()) {
-                jobs.erase(oldest);
-            }
-        }
-        
-        return job;
+        auto header = current_template->header_for_extranonce(extranonce);
+        return make_job(header, header.compute_midstate(), extranonce, lease);
     }
 };
 
 JobManager::JobManager(
     const MiningConfig& config,
-    bitcoin::CoinbaseBuilder coinbase_builder
-) : impl_(std::make_unique<Impl>(config, std::move(coinbase_builder)))
+    bitcoin::CoinbaseBuilder coinbase_builder,
+    uint64_t extranonce_start,
+    uint64_t extranonce_end
+) : impl_(std::make_unique<Impl>(config, std::move(coinbase_builder), extranonce_start, extranonce_end))
 {
 }
 
@@ -240,13 +440,38 @@ void JobManager::on_new_block(
     const bitcoin::BlockTemplate& block_template,
     bool is_speculative
 ) {
+    on_new_block(std::make_shared<const bitcoin::BlockTemplate>(block_template), is_speculative);
+}
+
+void JobManager::on_new_block(
+    std::shared_ptr<const bitcoin::BlockTemplate> block_template,
+    bool is_speculative
+) {
+    if (!block_template) {
+        return;
+    }
+    
+    // Скелет сериализуется до захвата mutex
+    auto skeleton = std::make_shared<const bitcoin::BlockSkeleton>(*block_template);
+    
     std::lock_guard<std::mutex> lock(impl_->mutex);
     
-    // Очищаем старые задания
-    impl_->clear_jobs();
+    // Старые задания устаревают (shares для них - StaleJob)
+    impl_->invalidate_jobs();
+    
+    // Подтверждённый tip держится до разрешения speculative блока;
+    // speculative поверх speculative откатывается к тому же tip
+    if (!is_speculative) {
+        impl_->rollback_template.reset();
+        impl_->rollback_skeleton.reset();
+    } else if (!impl_->is_speculative) {
+        impl_->rollback_template = impl_->current_template;
+        impl_->rollback_skeleton = impl_->skeleton;
+    }
     
     // Сохраняем новый шаблон
-    impl_->current_template = block_template;
+    impl_->current_template = std::move(block_template);
+    impl_->skeleton = std::move(skeleton);
     impl_->is_speculative = is_speculative;
     
     // NOTE: Do NOT increment a global extranonce here!
@@ -255,11 +480,18 @@ void JobManager::on_new_block(
     // when get_next_job_for_connection() is called.
     //
     // When a new block arrives:
-    // 1. Old jobs are cleared (above)
+    // 1. Old jobs are invalidated (above, one generation bump)
     // 2. New template is stored
     // 3. Each connection will get a new job with THEIR unique extranonce
     //    via get_next_job_for_connection() when the Server broadcasts jobs
     // 4. Extranonces remain stable per-connection across block changes
+    // 5. Extranonces released under the old template become reusable
+    //    (only for a confirmed block: a speculative one may be rolled back)
+    if (!is_speculative) {
+        impl_->extranonce_manager.recycle_released();
+    }
+    
+    core::trace_point(core::TraceStage::JobCreated);
 }
 
 void JobManager::confirm_speculative_block() {
@@ -267,25 +499,148 @@ void JobManager::confirm_speculative_block() {
     
     if (impl_->current_template) {
         impl_->is_speculative = false;
-        impl_->current_template->is_speculative = false;
+        
+        // Шаблон неизменяем — подменяем его подтверждённой копией
+        if (impl_->current_template->is_speculative) {
+            auto confirmed = std::make_shared<bitcoin::BlockTemplate>(*impl_->current_template);
+            confirmed->is_speculative = false;
+            impl_->current_template = std::move(confirmed);
+        }
         
         // Обновляем все задания
-        for (auto& [id, job] : impl_->jobs) {
+        impl_->jobs.update_all([](Job& job) {
             job.is_speculative = false;
-        }
+        });
+        
+        impl_->extranonce_manager.recycle_released();
     }
+    impl_->rollback_template.reset();
+    impl_->rollback_skeleton.reset();
 }
 
 void JobManager::invalidate_speculative_block() {
     std::lock_guard<std::mutex> lock(impl_->mutex);
     
     if (impl_->is_speculative) {
-        impl_->clear_jobs();
-        impl_->current_template = std::nullopt;
+        impl_->invalidate_jobs();
+        impl_->current_template.reset();
+        impl_->skeleton.reset();
+        impl_->rollback_template.reset();
+        impl_->rollback_skeleton.reset();
         impl_->is_speculative = false;
     }
 }
 
+bool JobManager::rollback_speculative_block(
+    const std::shared_ptr<const bitcoin::BlockTemplate>& previous,
+    std::span<PrecomputedJob> jobs
+) {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    
+    if (!impl_->is_speculative) {
+        for (auto& pj : jobs) {
+            pj.job.job_id = 0;
+        }
+        return false;
+    }
+    
+    impl_->invalidate_jobs();
+    impl_->current_template = std::move(impl_->rollback_template);
+    impl_->skeleton = std::move(impl_->rollback_skeleton);
+    impl_->rollback_template.reset();
+    impl_->rollback_skeleton.reset();
+    impl_->is_speculative = false;
+    if (!impl_->current_template) {
+        for (auto& pj : jobs) {
+            pj.job.job_id = 0;
+        }
+        return false;  // Speculative блок пришёл без прежнего tip
+    }
+    impl_->extranonce_manager.recycle_released();
+    
+    // Задания собраны для другого шаблона (или набора нет) - пусть
+    // соединения получат задания regenerate_all()
+    if (previous != impl_->current_template) {
+        for (auto& pj : jobs) {
+            pj.job.job_id = 0;
+        }
+        return true;
+    }
+    impl_->adopt_locked(jobs);
+    return true;
+}
+
+std::shared_ptr<const bitcoin::BlockTemplate> JobManager::rollback_template() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    return impl_->rollback_template;
+}
+
+std::optional<Job> JobManager::update_job_time(
+    uint32_t job_id,
+    uint32_t timestamp,
+    std::optional<uint32_t> nonce_start
+) {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    
+    auto job = impl_->jobs.find(job_id);
+    if (!job || job->timestamp == timestamp) {
+        return std::nullopt;
+    }
+    
+    job->previous_timestamp = job->timestamp;
+    job->timestamp = timestamp;
+    if (nonce_start) {
+        job->nonce = *nonce_start;
+    }
+    impl_->jobs.publish(*job);
+    return job;
+}
+
+std::optional<Job> JobManager::roll_job_time(uint32_t job_id, uint32_t now) {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    
+    auto job = impl_->jobs.find(job_id);
+    if (!job) {
+        return std::nullopt;
+    }
+    
+    const auto next = core::roll_block_time(job->timestamp, now);
+    if (!next) {
+        return std::nullopt;
+    }
+    
+    job->previous_timestamp = job->timestamp;
+    job->timestamp = *next;
+    impl_->jobs.publish(*job);
+    return job;
+}
+
+std::optional<Bytes> JobManager::build_found_block(
+    uint32_t job_id,
+    uint64_t extranonce,
+    uint32_t version,
+    uint32_t nonce,
+    uint32_t timestamp
+) const {
+    auto job = impl_->jobs.find(job_id);
+    if (!job) {
+        return std::nullopt;
+    }
+    
+    std::shared_ptr<const bitcoin::BlockSkeleton> skeleton;
+    {
+        std::lock_guard<std::mutex> lock(impl_->mutex);
+        skeleton = impl_->skeleton_for(job_id);
+    }
+    
+    // Задание от предыдущего шаблона: блок из текущего скелета не собрать
+    if (!skeleton || skeleton->empty() || skeleton->height() != job->height) {
+        return std::nullopt;
+    }
+    
+    return skeleton->build(extranonce, version, timestamp != 0 ? timestamp : job->timestamp, nonce);
+}
+
 std::optional<Job> JobManager::get_next_job() {
     std::lock_guard<std::mutex> lock(impl_->mutex);
     
@@ -310,14 +665,14 @@ std::optional<Job> JobManager::get_next_job_for_connection(uint32_t connection_i
         return std::nullopt;
     }
     
-    // Get this connection's unique extranonce
-    auto extranonce = impl_->extranonce_manager.get_extranonce(connection_id);
-    if (!extranonce) {
+    // Get this connection's unique extranonce (range)
+    auto lease = impl_->extranonce_manager.get_lease(connection_id);
+    if (!lease) {
         return std::nullopt;  // Connection not registered
     }
     
     // Create job with THIS connection's extranonce
-    Job job = impl_->create_job_with_extranonce(*extranonce);
+    Job job = impl_->create_job_with_extranonce(lease->start, lease->count);
     
     // Call callback
     if (impl_->new_job_callback) {
@@ -327,14 +682,238 @@ std::optional<Job> JobManager::get_next_job_for_connection(uint32_t connection_i
     return job;
 }
 
-std::optional<Job> JobManager::get_job(uint32_t job_id) const {
+std::size_t JobManager::get_queued_jobs_for_connection(
+    uint32_t connection_id,
+    std::span<Job> out
+) {
+    if (impl_->config.job_prefetch == 0) {
+        return 0;
+    }
+    
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    
+    if (!impl_->current_template) {
+        return 0;
+    }
+    
+    auto lease = impl_->extranonce_manager.get_lease(connection_id);
+    if (!lease) {
+        return 0;
+    }
+    
+    // timestamp во второй половине заголовка: midstate общий для очереди
+    auto header = impl_->current_template->header_for_extranonce(lease->start);
+    auto midstate = header.compute_midstate();
+    
+    std::size_t count = std::min(out.size(), impl_->config.job_prefetch);
+    for (std::size_t i = 0; i < count; ++i) {
+        out[i] = impl_->make_job(
+            header, midstate, lease->start, 0, static_cast<uint32_t>(i + 1));
+        
+        if (impl_->new_job_callback) {
+            impl_->new_job_callback(out[i]);
+        }
+    }
+    
+    return count;
+}
+
+std::size_t JobManager::adopt_precomputed_jobs(std::span<PrecomputedJob> jobs) {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    return impl_->adopt_locked(jobs);
+}
+
+std::vector<PrecomputedJob> JobManager::regenerate_all(std::span<const uint32_t> connection_ids) {
+    std::vector<PrecomputedJob> jobs;
+    std::shared_ptr<const bitcoin::BlockTemplate> tmpl;
+    {
+        std::lock_guard<std::mutex> lock(impl_->mutex);
+        if (!impl_->current_template) {
+            return jobs;
+        }
+        tmpl = impl_->current_template;
+        jobs = impl_->collect_jobs_locked(connection_ids);
+    }
+
+    // Кусок: coinbase txid и midstate заголовков пакетом, затем сообщения
+    auto build_chunk = [&](std::size_t chunk) {
+        const std::size_t start = chunk * REGENERATE_CHUNK;
+        const std::size_t n = std::min(REGENERATE_CHUNK, jobs.size() - start);
+        Impl::build_jobs(*tmpl, std::span(jobs).subspan(start, n));
+    };
+    
+    const std::size_t chunks = (jobs.size() + REGENERATE_CHUNK - 1) / REGENERATE_CHUNK;
+    if (auto* pool = jobs.size() >= REGENERATE_PARALLEL_MIN ? impl_->regenerate_pool() : nullptr) {
+        pool->run(chunks, build_chunk);
+    } else {
+        for (std::size_t chunk = 0; chunk < chunks; ++chunk) {
+            build_chunk(chunk);
+        }
+    }
+    
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    if (impl_->current_template != tmpl) {
+        // Шаблон сменился во время сборки: задания устарели
+        for (auto& pj : jobs) {
+            pj.job.job_id = 0;
+        }
+        return jobs;
+    }
+    impl_->adopt_locked(jobs);
+    return jobs;
+}
+
+std::vector<PrecomputedJob> JobManager::refresh_coinbase(
+    Bytes coinbase_tx,
+    std::span<const uint32_t> connection_ids
+) {
+    std::vector<PrecomputedJob> jobs;
+    std::shared_ptr<const bitcoin::BlockTemplate> tmpl;
+    uint32_t generation = 0;
+    {
+        std::lock_guard<std::mutex> lock(impl_->mutex);
+        if (!impl_->current_template || impl_->current_template->coinbase_tx == coinbase_tx) {
+            return jobs;
+        }
+        tmpl = impl_->current_template;
+        generation = impl_->jobs.generation();
+        jobs = impl_->collect_jobs_locked(connection_ids);
+    }
+    
+    // Первые 64 байта coinbase те же (commitments - в хвосте): midstate
+    // coinbase прежний, меняются только сжатия хвоста
+    auto refreshed = std::make_shared<bitcoin::BlockTemplate>(*tmpl);
+    const bool prefix_kept =
+        coinbase_tx.size() >= constants::SHA256_BLOCK_SIZE &&
+        tmpl->coinbase_tx.size() >= constants::SHA256_BLOCK_SIZE &&
+        std::equal(coinbase_tx.begin(), coinbase_tx.begin() + constants::SHA256_BLOCK_SIZE,
+                   tmpl->coinbase_tx.begin());
+    refreshed->coinbase_tx = std::move(coinbase_tx);
+    if (!prefix_kept) {
+        refreshed->coinbase_midstate = {};  // Досчитает update_extranonce()
+    }
+    refreshed->update_extranonce(0);
+    auto skeleton = std::make_shared<const bitcoin::BlockSkeleton>(*refreshed);
+    
+    // Пакет - в этом потоке: пул regenerate_all() остаётся новым блокам,
+    // смена поколения обрывает сборку между кусками
+    bool superseded = false;
+    for (std::size_t start = 0; start < jobs.size(); start += REGENERATE_CHUNK) {
+        if (impl_->jobs.generation() != generation) {
+            superseded = true;
+            break;
+        }
+        const std::size_t n = std::min(REGENERATE_CHUNK, jobs.size() - start);
+        Impl::build_jobs(*refreshed, std::span(jobs).subspan(start, n));
+    }
+    
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    if (superseded || impl_->current_template != tmpl) {
+        // Новый блок (или другая coinbase) за время сборки: задания устарели
+        for (auto& pj : jobs) {
+            pj.job.job_id = 0;
+        }
+        return jobs;
+    }
+    
+    // Задания, выданные до этой точки, собираются по прежнему скелету
+    auto& previous = impl_->previous_skeletons;
+    previous.emplace_back(impl_->next_job_id, std::move(impl_->skeleton));
+    if (previous.size() > COINBASE_REVISIONS) {
+        impl_->evicted_before = previous.front().first;
+        previous.erase(previous.begin());
+    }
+    impl_->skeleton = std::move(skeleton);
+    impl_->current_template = std::move(refreshed);
+    impl_->adopt_locked(jobs);
+    return jobs;
+}
+
+std::size_t JobManager::refresh_prelease_pool() {
+    const std::size_t target = impl_->config.prelease_pool;
+    if (target == 0) {
+        return 0;
+    }
+    
+    std::vector<PrecomputedJob> pool;
+    std::shared_ptr<const bitcoin::BlockTemplate> tmpl;
+    std::size_t ready = 0;
+    {
+        std::lock_guard<std::mutex> lock(impl_->mutex);
+        if (!impl_->current_template || impl_->prelease_refreshing) {
+            return 0;
+        }
+        if (impl_->prelease_template == impl_->current_template && impl_->prelease.size() >= target) {
+            return 0;
+        }
+        impl_->prelease_refreshing = true;
+        tmpl = impl_->current_template;
+        pool = std::move(impl_->prelease);
+        impl_->prelease.clear();  // Приём во время сборки идёт обычным путём
+        
+        // Кадры прежнего шаблона пересобираются, текущего - только дополняются
+        ready = impl_->prelease_template == tmpl ? pool.size() : 0;
+    }
+    
+    // Недостающие extranonce арендуются заранее, без соединения
+    const uint32_t lease = impl_->lease_size();
+    pool.reserve(target);
+    while (pool.size() < target) {
+        PrecomputedJob pj;
+        pj.extranonce = impl_->extranonce_manager.reserve_extranonces(lease).start;
+        if (pj.extranonce == 0) {
+            break;  // Диапазон узла исчерпан: пул меньше заданного
+        }
+        pool.push_back(pj);
+    }
+    Impl::build_jobs(*tmpl, std::span(pool).subspan(ready));
+    
     std::lock_guard<std::mutex> lock(impl_->mutex);
+    impl_->prelease_refreshing = false;
+    impl_->prelease = std::move(pool);
+    impl_->prelease_template = std::move(tmpl);  // Сменился - claim соберёт задание заново
+    return impl_->prelease.size() - ready;
+}
+
+std::optional<PrecomputedJob> JobManager::claim_preleased_job(uint32_t connection_id) {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    if (impl_->prelease.empty()) {
+        return std::nullopt;
+    }
     
-    auto it = impl_->jobs.find(job_id);
-    if (it != impl_->jobs.end()) {
-        return it->second;
+    PrecomputedJob pj = impl_->prelease.back();
+    impl_->prelease.pop_back();
+    pj.connection_id = connection_id;
+    impl_->extranonce_manager.bind_lease(connection_id, ExtranonceLease{pj.extranonce, impl_->lease_size()});
+    
+    if (!impl_->current_template) {
+        pj.job.job_id = 0;
+        return pj;
     }
-    return std::nullopt;
+    if (impl_->prelease_template != impl_->current_template) {
+        Impl::build_jobs(*impl_->current_template, std::span(&pj, 1));
+    }
+    impl_->adopt_locked(std::span(&pj, 1));
+    return pj;
+}
+
+std::size_t JobManager::prelease_pool_size() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    return impl_->prelease.size();
+}
+
+std::optional<Job> JobManager::get_job(uint32_t job_id) const {
+    // Без блокировки: таблица заданий читается через seqlock,
+    // поэтому on_new_block не задерживает проверку шар
+    return impl_->jobs.find(job_id);
+}
+
+JobLookup JobManager::lookup_job(uint32_t job_id, Job& out) const noexcept {
+    return impl_->jobs.lookup(job_id, out);
+}
+
+JobLookup JobManager::lookup_job_record(uint32_t job_id, JobRecord& out) const noexcept {
+    return impl_->jobs.lookup_record(job_id, out);
 }
 
 // =========================================================================
@@ -342,25 +921,92 @@ std::optional<Job> JobManager::get_job(uint32_t job_id) const {
 // =========================================================================
 
 uint64_t JobManager::register_connection(uint32_t connection_id) {
-    std::lock_guard<std::mutex> lock(impl_->mutex);
+    if (impl_->config.extranonce_lease > 1) {
+        auto lease = static_cast<uint32_t>(impl_->config.extranonce_lease);
+        return impl_->extranonce_manager.lease_extranonces(connection_id, lease).start;
+    }
     return impl_->extranonce_manager.assign_extranonce(connection_id);
 }
 
 void JobManager::unregister_connection(uint32_t connection_id) {
-    std::lock_guard<std::mutex> lock(impl_->mutex);
     impl_->extranonce_manager.release_extranonce(connection_id);
 }
 
-std::optional<uint64_t> JobManager::get_connection_extranonce(uint32_t connection_id) const {
+JobHandoff JobManager::export_handoff() const {
+    JobHandoff handoff;
+    handoff.leases = impl_->extranonce_manager.get_active_leases();
+    handoff.next_extranonce = impl_->extranonce_manager.peek_next_extranonce();
+    
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    handoff.block_template = impl_->current_template;
+    handoff.is_speculative = impl_->is_speculative;
+    handoff.next_job_id = impl_->next_job_id;
+    if (impl_->current_template) {
+        // Задания прежних coinbase (refresh_coinbase) не переносятся: новый
+        // процесс соберёт блок только по скелету текущего шаблона
+        const auto first = impl_->previous_skeletons.empty()
+            ? std::nullopt : std::optional(impl_->previous_skeletons.back().first);
+        handoff.jobs.reserve(impl_->jobs.size());
+        impl_->jobs.for_each_current([&handoff, first](const Job& job) {
+            if (!first || !Impl::issued_before(job.job_id, *first)) {
+                handoff.jobs.push_back(job);
+            }
+        });
+    }
+    return handoff;
+}
+
+std::size_t JobManager::import_handoff(const JobHandoff& handoff) {
+    impl_->extranonce_manager.restore_leases(handoff.leases, handoff.next_extranonce);
+    
+    std::shared_ptr<const bitcoin::BlockSkeleton> skeleton;
+    if (handoff.block_template) {
+        skeleton = std::make_shared<const bitcoin::BlockSkeleton>(*handoff.block_template);
+    }
+    
     std::lock_guard<std::mutex> lock(impl_->mutex);
+    
+    // Кадры пула построены для extranonce, которые теперь могут быть заняты
+    impl_->prelease.clear();
+    impl_->prelease_template.reset();
+    
+    if (handoff.next_job_id != 0) {
+        impl_->next_job_id = handoff.next_job_id;
+    }
+    if (!handoff.block_template) {
+        return 0;
+    }
+    
+    impl_->invalidate_jobs();
+    impl_->current_template = handoff.block_template;
+    impl_->skeleton = std::move(skeleton);
+    impl_->is_speculative = handoff.is_speculative;
+    
+    const uint32_t generation = impl_->jobs.generation();
+    std::size_t restored = 0;
+    for (Job job : handoff.jobs) {
+        if (job.job_id == 0 || job.height != handoff.block_template->height) {
+            continue;
+        }
+        job.generation = generation;
+        impl_->jobs.publish(job);
+        ++restored;
+    }
+    return restored;
+}
+
+std::optional<uint64_t> JobManager::get_connection_extranonce(uint32_t connection_id) const {
     return impl_->extranonce_manager.get_extranonce(connection_id);
 }
 
 std::size_t JobManager::active_connection_count() const {
-    std::lock_guard<std::mutex> lock(impl_->mutex);
     return impl_->extranonce_manager.active_count();
 }
 
+const ExtrannonceManager& JobManager::extranonce_manager() const noexcept {
+    return impl_->extranonce_manager;
+}
+
 void JobManager::set_new_job_callback(NewJobCallback callback) {
     std::lock_guard<std::mutex> lock(impl_->mutex);
     impl_->new_job_callback = std::move(callback);
@@ -372,13 +1018,15 @@ void JobManager::set_block_found_callback(BlockFoundCallback callback) {
 }
 
 std::size_t JobManager::active_job_count() const {
-    std::lock_guard<std::mutex> lock(impl_->mutex);
     return impl_->jobs.size();
 }
 
+std::size_t JobManager::job_capacity() const noexcept {
+    return impl_->jobs.capacity();
+}
+
 uint64_t JobManager::current_extranonce() const {
-    std::lock_guard<std::mutex> lock(impl_->mutex);
-    // Returns the next extranonce that will be assigned
+    // Returns the next fresh extranonce (recycled values are handed out first)
     return impl_->extranonce_manager.peek_next_extranonce();
 }
 
@@ -392,7 +1040,35 @@ uint32_t JobManager::current_height() const {
 
 bool JobManager::has_template() const {
     std::lock_guard<std::mutex> lock(impl_->mutex);
-    return impl_->current_template.has_value();
+    return impl_->current_template != nullptr;
+}
+
+uint32_t JobManager::job_generation() const noexcept {
+    return impl_->jobs.generation();
+}
+
+std::shared_ptr<const bitcoin::BlockTemplate> JobManager::current_template() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    return impl_->current_template;
+}
+
+std::optional<Job> JobManager::block_announcement() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    if (!impl_->current_template) {
+        return std::nullopt;
+    }
+    
+    const auto& tmpl = *impl_->current_template;
+    Job job;
+    job.timestamp = tmpl.header.timestamp;
+    job.bits = tmpl.header.bits;
+    job.height = tmpl.height;
+    job.target = tmpl.target;
+    job.is_speculative = impl_->is_speculative;
+    job.generation = impl_->jobs.generation();
+    // Любой размер аренды: прошивка берёт свой диапазон из прежнего CMD_NEW_JOB_LEASE
+    assign_extranonce_lease(job, tmpl, 2);
+    return job;
 }
 
 } // namespace quaxis::mining
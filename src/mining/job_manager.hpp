@@ -15,6 +15,7 @@
 #pragma once
 
 #include "job.hpp"
+#include "job_table.hpp"
 #include "extranonce_manager.hpp"
 #include "../core/config.hpp"
 #include "../bitcoin/block.hpp"
@@ -22,9 +23,12 @@
 
 #include <memory>
 #include <functional>
+#include <limits>
 #include <mutex>
 #include <unordered_map>
 #include <queue>
+#include <span>
+#include <vector>
 
 namespace quaxis::mining {
 
@@ -46,6 +50,37 @@ using BlockFoundCallback = std::function<void(
     uint32_t nonce
 )>;
 
+// =============================================================================
+// Передача состояния новому процессу
+// =============================================================================
+
+/**
+ * @brief Состояние JobManager для передачи новому процессу
+ * 
+ * Снимок export_handoff(), переносимый network/handoff.hpp вместе с
+ * сокетами ASIC: новый процесс продолжает те же задания с теми же
+ * extranonce, shares уже выданных заданий остаются валидными.
+ */
+struct JobHandoff {
+    /// @brief Текущий шаблон (nullptr - шаблона нет)
+    std::shared_ptr<const bitcoin::BlockTemplate> block_template;
+    
+    /// @brief Шаблон speculative (spy mining)
+    bool is_speculative = false;
+    
+    /// @brief Задания текущего поколения
+    std::vector<Job> jobs;
+    
+    /// @brief Следующий job_id (новые задания не совпадут с перенесёнными)
+    uint32_t next_job_id = 1;
+    
+    /// @brief Аренды extranonce соединений (в том числе припаркованных сессий)
+    std::vector<std::pair<uint32_t, ExtranonceLease>> leases;
+    
+    /// @brief Следующий свежий extranonce
+    uint64_t next_extranonce = 0;
+};
+
 // =============================================================================
 // Job Manager
 // =============================================================================
@@ -69,10 +104,16 @@ public:
      * 
      * @param config Конфигурация майнинга
      * @param coinbase_builder Построитель coinbase транзакций
+     * @param extranonce_start Первый extranonce соединений (у прокси -
+     *        начало диапазона, делегированного площадке)
+     * @param extranonce_end Первый extranonce за диапазоном узла: дальше
+     *        начинается диапазон соседней площадки или узла кластера
      */
     explicit JobManager(
         const MiningConfig& config,
-        bitcoin::CoinbaseBuilder coinbase_builder
+        bitcoin::CoinbaseBuilder coinbase_builder,
+        uint64_t extranonce_start = 1,
+        uint64_t extranonce_end = std::numeric_limits<uint64_t>::max()
     );
     
     ~JobManager();
@@ -104,6 +145,20 @@ public:
         bool is_speculative = false
     );
     
+    /**
+     * @brief Обработать новый блок с готовым разделяемым шаблоном
+     * 
+     * Шаблон не копируется: задания ссылаются на тот же объект (например,
+     * собранный ShmTemplateSubscriber прямо из shared memory).
+     * 
+     * @param block_template Неизменяемый шаблон блока
+     * @param is_speculative true для spy mining (блок ещё не валидирован)
+     */
+    void on_new_block(
+        std::shared_ptr<const bitcoin::BlockTemplate> block_template,
+        bool is_speculative = false
+    );
+    
     /**
      * @brief Подтвердить speculative блок
      * 
@@ -119,6 +174,36 @@ public:
      */
     void invalidate_speculative_block();
     
+    /**
+     * @brief Отменить speculative блок и вернуться к прежнему tip
+     * 
+     * Шаблон и скелет tip, на котором пришёл speculative блок, держатся
+     * до его подтверждения или отмены. Под одним mutex они снова
+     * становятся текущими (новое поколение заданий), и готовые задания
+     * прежнего tip (TemplateCache::take_rollback) принимаются как в
+     * adopt_precomputed_jobs(): без хеширования, рассылка - сразу.
+     * 
+     * Задания, собранные не для этого шаблона, получают job_id = 0:
+     * Server::broadcast_job_set() соберёт их regenerate_all().
+     * 
+     * @param previous Шаблон, для которого собраны jobs
+     * @param jobs Готовые задания прежнего tip (может быть пусто)
+     * @return true если прежний tip снова текущий; false - блок не
+     *         speculative или прежнего tip не было (как
+     *         invalidate_speculative_block(): шаблона нет)
+     */
+    bool rollback_speculative_block(
+        const std::shared_ptr<const bitcoin::BlockTemplate>& previous,
+        std::span<PrecomputedJob> jobs
+    );
+    
+    /**
+     * @brief Шаблон, к которому вернёт rollback_speculative_block()
+     * 
+     * @return nullptr - майнинг не speculative (или прежнего tip не было)
+     */
+    [[nodiscard]] std::shared_ptr<const bitcoin::BlockTemplate> rollback_template() const;
+    
     /**
      * @brief Получить следующее задание
      * 
@@ -139,19 +224,224 @@ public:
      * This method creates a job with that connection's specific extranonce,
      * ensuring no duplicate work across connections.
      * 
+     * O(1) and allocation-free: the shared template is not copied, the job
+     * record goes into a preallocated ring slot (job_id % job_queue_size).
+     * 
      * @param connection_id Unique identifier for the ASIC connection
      * @return std::optional<Job> Job with this connection's extranonce, or nullopt
      */
     [[nodiscard]] std::optional<Job> get_next_job_for_connection(uint32_t connection_id);
     
+    /**
+     * @brief Задания очереди ASIC (mining.job_prefetch)
+     * 
+     * Следующие задания для extranonce соединения: timestamp текущего
+     * шаблона + 1..N, у каждого свой job_id. ASIC берёт их сам, когда
+     * исчерпан nonce текущего задания, не дожидаясь сервера. Midstate
+     * считается один раз на всю очередь (timestamp не входит в первый блок).
+     * 
+     * @param connection_id Идентификатор соединения
+     * @param out Буфер под задания
+     * @return std::size_t Количество заданий: min(out.size(), job_prefetch),
+     *         0 без шаблона или для незарегистрированного соединения
+     */
+    std::size_t get_queued_jobs_for_connection(uint32_t connection_id, std::span<Job> out);
+    
+    /**
+     * @brief Принять задания, предвычисленные TemplateCache
+     * 
+     * Вызывается после on_new_block() с шаблоном из того же набора.
+     * Каждому заданию назначается job_id (он же записывается в готовое
+     * сообщение), и задание публикуется в таблицу активных заданий.
+     * Задания отключившихся соединений (или с устаревшим extranonce)
+     * помечаются job_id = 0 и не публикуются.
+     * 
+     * @param jobs Предвычисленные задания
+     * @return std::size_t Количество принятых заданий
+     */
+    std::size_t adopt_precomputed_jobs(std::span<PrecomputedJob> jobs);
+    
+    /// @brief Заданий в одном куске regenerate_all() (пакет многоканального SHA256)
+    static constexpr std::size_t REGENERATE_CHUNK = 64;
+    
+    /// @brief Соединений, с которых regenerate_all() делит куски между потоками
+    static constexpr std::size_t REGENERATE_PARALLEL_MIN = 4 * REGENERATE_CHUNK;
+    
+    /**
+     * @brief Пересобрать задания соединений по текущему шаблону одним пакетом
+     * 
+     * Вместо get_next_job_for_connection() по одному: coinbase txid и
+     * midstate заголовков всех соединений считаются кусками по
+     * REGENERATE_CHUNK на многоканальном SHA256 (AVX2/AVX-512), большие
+     * парки - параллельно в пуле MiningConfig::regenerate_threads.
+     * Хеширование идёт без mutex; задания принимаются как
+     * adopt_precomputed_jobs(), если шаблон за это время не сменился.
+     * 
+     * @param connection_ids Соединения (незарегистрированные пропускаются)
+     * @return std::vector<PrecomputedJob> Задания по возрастанию connection_id
+     *         (для Server::broadcast_job_set); job_id = 0 - не приняты
+     */
+    [[nodiscard]] std::vector<PrecomputedJob> regenerate_all(std::span<const uint32_t> connection_ids);
+    
+    /// @brief Прежних coinbase шаблона, по которым ещё собираются найденные блоки
+    static constexpr std::size_t COINBASE_REVISIONS = 8;
+    
+    /**
+     * @brief Сменить coinbase текущего шаблона без смены блока (обновление aux)
+     * 
+     * Быстрый путь merged mining: новый aux root (или тег chain вне aux
+     * дерева) меняет только хвост coinbase после первых 64 байт
+     * (bitcoin::CoinbaseLayout), поэтому midstate coinbase сохраняется, а
+     * задания всех соединений пересобираются как в regenerate_all() -
+     * сжатия хвоста и midstate заголовков многоканальным SHA256.
+     * 
+     * Низкий приоритет: пакет считается в вызывающем потоке без пула
+     * regenerate_all(), поколение заданий не меняется (shares прежних
+     * заданий остаются валидными, их блоки собираются по прежней coinbase).
+     * Если за время сборки пришёл новый блок, задания не принимаются.
+     * 
+     * @param coinbase_tx Coinbase шаблона с новыми commitments
+     *        (merged::MergedJobCreator::insert_commitments)
+     * @param connection_ids Соединения (незарегистрированные пропускаются)
+     * @return std::vector<PrecomputedJob> Задания по возрастанию connection_id
+     *         (для Server::refresh_job_set); пусто - шаблона нет или coinbase
+     *         та же; job_id = 0 - не приняты
+     */
+    [[nodiscard]] std::vector<PrecomputedJob> refresh_coinbase(
+        Bytes coinbase_tx,
+        std::span<const uint32_t> connection_ids
+    );
+    
+    /**
+     * @brief Пополнить пул заранее арендованных extranonce (MiningConfig::prelease_pool)
+     * 
+     * Extranonce пула ещё не принадлежат соединениям; для каждого готов
+     * кадр задания по текущему шаблону. Вызывается вне горячего пути:
+     * после рассылки заданий нового блока и периодически, чтобы вернуть
+     * пул к полному размеру после приёма соединений. Хеширование идёт без
+     * mutex, параллельный вызов ничего не делает.
+     * 
+     * @return std::size_t Кадров пересобрано (0 - пул уже готов или выключен)
+     */
+    std::size_t refresh_prelease_pool();
+    
+    /**
+     * @brief Зарегистрировать соединение extranonce из пула с готовым заданием
+     * 
+     * Замена register_connection() + get_next_job_for_connection() при
+     * приёме подключения: extranonce уже арендован, кадр задания уже
+     * сериализован, остаётся назначить job_id. Задание, собранное по
+     * прежнему шаблону, пересобирается для одного extranonce.
+     * 
+     * @param connection_id Новое соединение
+     * @return std::optional<PrecomputedJob> nullopt - пул пуст (соединение
+     *         не зарегистрировано); job_id = 0 - зарегистрировано, но шаблона нет
+     */
+    [[nodiscard]] std::optional<PrecomputedJob> claim_preleased_job(uint32_t connection_id);
+    
+    /**
+     * @brief Extranonce в пуле заранее арендованных
+     */
+    [[nodiscard]] std::size_t prelease_pool_size() const;
+    
     /**
      * @brief Получить задание по ID
      * 
+     * O(1): задание ищется в слоте job_id % job_queue_size кольцевого буфера.
+     * Задания старше job_queue_size последних считаются вытесненными.
+     * 
+     * Lock-free: не берёт mutex JobManager и может вызываться из любого
+     * числа потоков параллельно с on_new_block / созданием заданий.
+     * 
      * @param job_id ID задания
      * @return std::optional<Job> Задание или nullopt если не найдено
      */
     [[nodiscard]] std::optional<Job> get_job(uint32_t job_id) const;
     
+    /**
+     * @brief Найти задание и отличить устаревшее от неизвестного
+     * 
+     * O(1) и lock-free, как get_job(). Stale - задание прежнего блока
+     * (on_new_block только сменил поколение) или вытесненное из кольца,
+     * Unknown - job_id, который JobManager не выдавал.
+     * 
+     * @param job_id ID задания
+     * @param out Задание (для Current)
+     * @return JobLookup Классификация job_id
+     */
+    [[nodiscard]] JobLookup lookup_job(uint32_t job_id, Job& out) const noexcept;
+    
+    /**
+     * @brief Найти горячие поля задания (одна запись таблицы, без полного Job)
+     * 
+     * Классификация как у lookup_job(). Для задания со слотами версий
+     * (out.has_versions) share нужен полный Job.
+     * 
+     * @param job_id ID задания
+     * @param out Горячие поля задания (для Current)
+     * @return JobLookup Классификация job_id
+     */
+    [[nodiscard]] JobLookup lookup_job_record(uint32_t job_id, JobRecord& out) const noexcept;
+    
+    /**
+     * @brief Сдвинуть timestamp задания без нового midstate (CMD_UPDATE_TIME)
+     * 
+     * Timestamp лежит в хвосте заголовка: задание сохраняет job_id,
+     * midstate и extranonce, меняется только timestamp (и начальный
+     * nonce). Прежний timestamp запоминается в previous_timestamp -
+     * shares, найденные ASIC до команды, остаются валидными.
+     * 
+     * @param job_id ID задания
+     * @param timestamp Новый timestamp (обычно из roll_job_time)
+     * @param nonce_start Начальный nonce (nullopt - прежний)
+     * @return std::optional<Job> Обновлённое задание или nullopt, если
+     *         задания нет, оно уже вытеснено или timestamp не изменился
+     */
+    std::optional<Job> update_job_time(
+        uint32_t job_id,
+        uint32_t timestamp,
+        std::optional<uint32_t> nonce_start = std::nullopt
+    );
+    
+    /**
+     * @brief Сдвинуть timestamp задания вслед за часами (ntime roll)
+     * 
+     * Правило core::roll_block_time, как у TemplateGenerator::roll_timestamp.
+     * Нижнюю границу MTP задание уже соблюдает: шаблон её проверил,
+     * а timestamp только растёт.
+     * 
+     * @param job_id ID задания
+     * @param now Unix время
+     * @return std::optional<Job> Обновлённое задание или nullopt, если
+     *         задания нет или timestamp упёрся в предел будущего
+     */
+    std::optional<Job> roll_job_time(uint32_t job_id, uint32_t now);
+    
+    /**
+     * @brief Собрать найденный блок для отправки
+     * 
+     * Блок собирается из скелета текущего шаблона (BlockSkeleton):
+     * в заранее сериализованную копию дописываются extranonce, версия,
+     * timestamp задания и nonce. Задания, выданные до refresh_coinbase(),
+     * собираются по скелету своей coinbase.
+     * 
+     * @param job_id ID задания, в котором найден блок
+     * @param extranonce Extranonce share (ValidationResult::extranonce)
+     * @param version Версия слота (0 - версия шаблона)
+     * @param nonce Найденный nonce
+     * @param timestamp Timestamp share (ValidationResult::timestamp,
+     *        0 - текущий timestamp задания)
+     * @return std::optional<Bytes> Блок или nullopt, если задания уже нет
+     *         или оно построено по другому шаблону
+     */
+    [[nodiscard]] std::optional<Bytes> build_found_block(
+        uint32_t job_id,
+        uint64_t extranonce,
+        uint32_t version,
+        uint32_t nonce,
+        uint32_t timestamp = 0
+    ) const;
+    
     // =========================================================================
     // Connection Management (ExtrannonceManager integration)
     // =========================================================================
@@ -159,11 +449,15 @@ public:
     /**
      * @brief Register a new ASIC connection
      * 
-     * Assigns a unique extranonce to the connection.
+     * Assigns a unique extranonce to the connection, or a range of
+     * mining.extranonce_lease extranonces that the ASIC rolls itself
+     * (jobs for the connection then carry the lease).
      * Call this when a new ASIC connects.
      * 
      * @param connection_id Unique identifier for the connection
-     * @return uint64_t The assigned extranonce
+     * @return uint64_t The assigned extranonce (start of the range);
+     *         0 - the node's extranonce range is exhausted, the
+     *         connection must be refused
      */
     uint64_t register_connection(uint32_t connection_id);
     
@@ -192,6 +486,39 @@ public:
      */
     [[nodiscard]] std::size_t active_connection_count() const;
     
+    /**
+     * @brief Get the extranonce manager (thread-safe on its own)
+     * 
+     * Used by TemplateCache to precompute jobs for all connections.
+     */
+    [[nodiscard]] const ExtrannonceManager& extranonce_manager() const noexcept;
+    
+    // =========================================================================
+    // Передача новому процессу
+    // =========================================================================
+    
+    /**
+     * @brief Снять состояние для передачи новому процессу
+     * 
+     * Шаблон, задания текущего поколения, аренды extranonce и счётчики.
+     * Менеджер продолжает работать: при неудачной передаче ничего
+     * восстанавливать не нужно.
+     */
+    [[nodiscard]] JobHandoff export_handoff() const;
+    
+    /**
+     * @brief Продолжить работу прежнего процесса
+     * 
+     * Вызывать до приёма соединений. Аренды привязываются к прежним ID
+     * соединений, шаблон становится текущим, задания публикуются с
+     * прежними job_id. Пул mining.prelease_pool сбрасывается: его
+     * extranonce могли совпасть с перенесёнными.
+     * 
+     * @param handoff Снимок export_handoff() прежнего процесса
+     * @return std::size_t Перенесено заданий
+     */
+    std::size_t import_handoff(const JobHandoff& handoff);
+    
     // =========================================================================
     // Callbacks
     // =========================================================================
@@ -215,6 +542,11 @@ public:
      */
     [[nodiscard]] std::size_t active_job_count() const;
     
+    /**
+     * @brief Ёмкость кольца заданий (job_queue_size)
+     */
+    [[nodiscard]] std::size_t job_capacity() const noexcept;
+    
     /**
      * @brief Получить текущий extranonce
      * 
@@ -233,6 +565,35 @@ public:
      */
     [[nodiscard]] bool has_template() const;
     
+    /**
+     * @brief Поколение заданий (растёт при каждой смене блока)
+     * 
+     * Без блокировки: опрашивается горячими потоками, которым нужно
+     * узнать о смене блока (программный ASIC).
+     */
+    [[nodiscard]] uint32_t job_generation() const noexcept;
+    
+    /**
+     * @brief Текущий шаблон (для фида нижестоящих площадок)
+     * 
+     * @return nullptr - шаблона нет
+     */
+    [[nodiscard]] std::shared_ptr<const bitcoin::BlockTemplate> current_template() const;
+    
+    /**
+     * @brief Данные текущего блока для multicast-уведомления ASIC
+     * 
+     * Задание без соединения: высота, поколение, timestamp и bits
+     * шаблона, а для стандартной coinbase - ещё данные аренды
+     * (version, prev_block, midstate и хвост coinbase с нулевым
+     * extranonce), из которых прошивка подставляет свой extranonce.
+     * job_id не выделяется, задание не публикуется.
+     * 
+     * @return std::optional<Job> extranonce_lease = 0 - только сигнал
+     *         смены блока; nullopt - шаблона нет
+     */
+    [[nodiscard]] std::optional<Job> block_announcement() const;
+    
 private:
     struct Impl;
     std::unique_ptr<Impl> impl_;
@@ -0,0 +1,445 @@
+/**
+ * @file job_table.hpp
+ * @brief Таблица активных заданий с lock-free чтением
+ *
+ * Кольцевой буфер заданий фиксированной ёмкости (слот = job_id % capacity),
+ * каждый слот защищён seqlock'ом:
+ * - Писатель один (JobManager под своим mutex) и никогда не ждёт читателей
+ * - Читатели (ShareValidator) не берут блокировок и не пишут в общую память,
+ *   поэтому on_new_block не блокирует проверку шар
+ *
+ * Содержимое слота хранится как массив std::atomic<uint64_t> и копируется
+ * relaxed-операциями между двумя чтениями счётчика последовательности —
+ * формально race-free вариант seqlock (Boehm, "Can Seqlocks Get Along
+ * with Programming Language Memory Models?").
+ *
+ * Смена блока не перебирает слоты: задания помечены поколением (Job::generation),
+ * advance_generation() - один инкремент, а слоты прежних поколений
+ * переиспользуются по мере записи новых заданий. lookup() за O(1) отличает
+ * устаревшее задание (прежнее поколение или вытесненное из кольца) от
+ * job_id, который сервер не выдавал.
+ *
+ * Слоты разложены по столбцам (structure of arrays): Job с версиями,
+ * арендой и заголовком занимает несколько сотен байт, а проверка обычного
+ * share читает только midstate, хвост заголовка, поколение и extranonce.
+ * Горячие поля слота лежат в одной 64-байтной записи вместе с seqlock,
+ * extranonce - в отдельном плотном столбце, полный Job - в холодном
+ * столбце. lookup_record() касается одной-двух кеш-линий независимо от
+ * размера Job, и число заданий, помещающихся в L1/L2, растёт в разы.
+ */
+
+#pragma once
+
+#include "job.hpp"
+#include "../core/clock.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <type_traits>
+
+namespace quaxis::mining {
+
+/**
+ * @brief Результат поиска задания по job_id
+ */
+enum class JobLookup : uint8_t {
+    Current,  ///< Задание текущего поколения
+    Stale,    ///< Выдавалось, но устарело (новый блок или вытеснено из кольца)
+    Unknown   ///< Такой job_id не выдавался
+};
+
+/**
+ * @brief Горячие поля задания для проверки share
+ *
+ * Копия того, что нужно share без слота версии, version и смещения
+ * аренды. Target блока задаётся bits (bits_to_target).
+ */
+struct JobRecord {
+    uint32_t job_id = 0;
+    uint32_t generation = 0;
+    crypto::Sha256State midstate{};
+    std::array<uint8_t, 4> merkle_tail{};
+    uint32_t timestamp = 0;
+    uint32_t previous_timestamp = 0;
+    uint32_t bits = 0;
+    uint64_t extranonce = 0;
+
+    /// @brief Время создания: секунды steady_clock
+    uint32_t created_seconds = 0;
+
+    /// @brief У задания есть слоты версий: нужен полный Job (lookup())
+    bool has_versions = false;
+
+    /**
+     * @brief Секунды steady_clock (для created_seconds)
+     */
+    [[nodiscard]] static uint32_t seconds_of(std::chrono::steady_clock::time_point time) noexcept {
+        return static_cast<uint32_t>(
+            std::chrono::duration_cast<std::chrono::seconds>(time.time_since_epoch()).count());
+    }
+
+    /**
+     * @brief То же, что Job::is_stale(), с точностью до секунды
+     */
+    [[nodiscard]] bool is_stale(uint32_t max_age = 60) const noexcept {
+        const uint32_t now = seconds_of(core::CoarseClock::now());
+        return static_cast<int64_t>(now) - created_seconds > static_cast<int64_t>(max_age);
+    }
+};
+
+/**
+ * @brief Read-mostly таблица заданий
+ *
+ * Все методы, кроме find() / size() / capacity(), должен вызывать
+ * только один поток-писатель (или писатели, сериализованные mutex).
+ */
+class JobTable {
+public:
+    static_assert(std::is_trivially_copyable_v<Job>,
+                  "Job должен быть trivially copyable для seqlock");
+
+    /**
+     * @brief Создать таблицу
+     *
+     * @param capacity Количество слотов (минимум 1)
+     */
+    explicit JobTable(std::size_t capacity)
+        : capacity_(capacity == 0 ? 1 : capacity)
+        , slots_(std::make_unique<Slot[]>(capacity_))
+        , extranonces_(std::make_unique<std::atomic<uint64_t>[]>(capacity_))
+        , cold_(std::make_unique<ColdSlot[]>(capacity_))
+    {}
+
+    JobTable(const JobTable&) = delete;
+    JobTable& operator=(const JobTable&) = delete;
+
+    // =========================================================================
+    // Писатель
+    // =========================================================================
+
+    /**
+     * @brief Опубликовать задание в слот job_id % capacity
+     *
+     * Предыдущее задание в слоте вытесняется. Поколение задания
+     * (job.generation) задаёт писатель, обычно generation().
+     */
+    void publish(const Job& job) noexcept {
+        const std::size_t index = job.job_id % capacity_;
+        Slot& slot = slots_[index];
+        const uint32_t current = generation();
+        if (job.job_id != 0 && job.generation == current &&
+            (slot.peek_job_id() == 0 || slot.peek_generation() != current)) {
+            live_.fetch_add(1, std::memory_order_relaxed);
+        }
+        store(index, job);
+        if (job.job_id != 0 && static_cast<int32_t>(job.job_id - newest_id_.load(std::memory_order_relaxed)) > 0) {
+            newest_id_.store(job.job_id, std::memory_order_release);
+        }
+    }
+
+    /**
+     * @brief Текущее поколение заданий
+     */
+    [[nodiscard]] uint32_t generation() const noexcept {
+        return generation_.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Сделать все задания устаревшими (O(1))
+     *
+     * Слоты не перезаписываются: lookup() отвечает Stale, пока слот не
+     * займёт задание нового поколения.
+     */
+    void advance_generation() noexcept {
+        generation_.fetch_add(1, std::memory_order_acq_rel);
+        live_.store(0, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Очистить все слоты
+     *
+     * Задания, выданные до очистки, остаются устаревшими (Stale).
+     */
+    void clear() noexcept {
+        for (std::size_t i = 0; i < capacity_; ++i) {
+            if (slots_[i].peek_job_id() != 0) {
+                store(i, Job{});
+            }
+        }
+        advance_generation();
+    }
+
+    /**
+     * @brief Изменить все активные задания
+     *
+     * @param fn Функция void(Job&), вызывается для каждого задания
+     *        текущего поколения
+     */
+    template<typename Fn>
+    void update_all(Fn&& fn) noexcept {
+        const uint32_t current = generation();
+        for (std::size_t i = 0; i < capacity_; ++i) {
+            if (slots_[i].peek_job_id() == 0 || slots_[i].peek_generation() != current) {
+                continue;
+            }
+            Job job = cold_[i].load_unsynchronized();
+            fn(job);
+            store(i, job);
+        }
+    }
+
+    /**
+     * @brief Обойти все активные задания (в потоке-писателе)
+     *
+     * @param fn Функция void(const Job&) для каждого задания текущего поколения
+     */
+    template<typename Fn>
+    void for_each_current(Fn&& fn) const {
+        const uint32_t current = generation();
+        for (std::size_t i = 0; i < capacity_; ++i) {
+            if (slots_[i].peek_job_id() == 0 || slots_[i].peek_generation() != current) {
+                continue;
+            }
+            fn(cold_[i].load_unsynchronized());
+        }
+    }
+
+    // =========================================================================
+    // Читатели (lock-free)
+    // =========================================================================
+
+    /**
+     * @brief Найти задание по ID
+     *
+     * Не берёт блокировок. Повторяет чтение только если слот
+     * перезаписывается в этот момент.
+     *
+     * @param job_id ID задания
+     * @return std::optional<Job> Задание текущего поколения или nullopt
+     *         (нет, вытеснено или устарело)
+     */
+    [[nodiscard]] std::optional<Job> find(uint32_t job_id) const noexcept {
+        Job job;
+        if (lookup(job_id, job) != JobLookup::Current) {
+            return std::nullopt;
+        }
+        return job;
+    }
+
+    /**
+     * @brief Найти задание и классифицировать job_id (O(1), без блокировок)
+     *
+     * @param job_id ID задания
+     * @param out Задание (заполняется и для Stale, если слот ещё не занят)
+     * @return JobLookup Current, Stale или Unknown
+     */
+    [[nodiscard]] JobLookup lookup(uint32_t job_id, Job& out) const noexcept {
+        if (job_id == 0) {
+            return JobLookup::Unknown;
+        }
+        // Поколение читается после слота: задание, опубликованное уже для
+        // нового блока, не примется за устаревшее
+        const std::size_t index = job_id % capacity_;
+        const Slot& slot = slots_[index];
+        for (;;) {
+            const uint32_t s1 = slot.begin_read();
+            out = cold_[index].load_unsynchronized();
+            if (slot.end_read(s1)) {
+                break;
+            }
+        }
+        return classify(job_id, out.job_id, out.generation);
+    }
+
+    /**
+     * @brief Найти горячие поля задания (O(1), без блокировок)
+     *
+     * Читает 64-байтную запись слота и столбец extranonce, не трогая
+     * полный Job: путь проверки обычного share.
+     *
+     * @param job_id ID задания
+     * @param out Горячие поля (для Current)
+     * @return JobLookup Current, Stale или Unknown
+     */
+    [[nodiscard]] JobLookup lookup_record(uint32_t job_id, JobRecord& out) const noexcept {
+        if (job_id == 0) {
+            return JobLookup::Unknown;
+        }
+        const std::size_t index = job_id % capacity_;
+        const Slot& slot = slots_[index];
+        for (;;) {
+            const uint32_t s1 = slot.begin_read();
+            slot.read_record(out);
+            out.extranonce = extranonces_[index].load(std::memory_order_relaxed);
+            if (slot.end_read(s1)) {
+                break;
+            }
+        }
+        return classify(job_id, out.job_id, out.generation);
+    }
+
+    /**
+     * @brief Количество активных заданий
+     */
+    [[nodiscard]] std::size_t size() const noexcept {
+        return live_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Ёмкость таблицы
+     */
+    [[nodiscard]] std::size_t capacity() const noexcept {
+        return capacity_;
+    }
+
+private:
+    /// @brief Количество 64-битных слов под Job
+    static constexpr std::size_t WORDS = (sizeof(Job) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    /// @brief Слов горячих полей: midstate (4), merkle_tail + timestamp, bits + previous_timestamp
+    static constexpr std::size_t RECORD_WORDS = 6;
+
+    /// @brief Бит created: у задания есть слоты версий
+    static constexpr uint32_t HAS_VERSIONS_BIT = 1u << 31;
+
+    /**
+     * @brief Горячая запись слота с seqlock (ровно одна кеш-линия)
+     *
+     * seq охраняет и запись, и столбцы extranonce / полного Job этого слота.
+     */
+    struct alignas(64) Slot {
+        std::atomic<uint32_t> seq{0};
+        std::atomic<uint32_t> job_id{0};
+        std::atomic<uint32_t> generation{0};
+        std::atomic<uint32_t> created{0};  ///< created_seconds | HAS_VERSIONS_BIT
+        std::atomic<uint64_t> words[RECORD_WORDS]{};
+
+        [[nodiscard]] uint32_t peek_job_id() const noexcept {
+            return job_id.load(std::memory_order_relaxed);
+        }
+
+        [[nodiscard]] uint32_t peek_generation() const noexcept {
+            return generation.load(std::memory_order_relaxed);
+        }
+
+        /// @brief Начало чтения: ждёт окончания записи
+        [[nodiscard]] uint32_t begin_read() const noexcept {
+            for (;;) {
+                const uint32_t s = seq.load(std::memory_order_acquire);
+                if (!(s & 1u)) {
+                    return s;
+                }
+            }
+        }
+
+        /// @brief Конец чтения: false - слот перезаписан, читать заново
+        [[nodiscard]] bool end_read(uint32_t s1) const noexcept {
+            std::atomic_thread_fence(std::memory_order_acquire);
+            return seq.load(std::memory_order_relaxed) == s1;
+        }
+
+        void write_record(const Job& job) noexcept {
+            uint64_t buf[RECORD_WORDS]{};
+            std::memcpy(buf, job.midstate.data(), sizeof(job.midstate));
+            std::memcpy(&buf[4], job.merkle_tail.data(), job.merkle_tail.size());
+            buf[4] |= uint64_t{job.timestamp} << 32;
+            buf[5] = job.bits | (uint64_t{job.previous_timestamp} << 32);
+            for (std::size_t w = 0; w < RECORD_WORDS; ++w) {
+                words[w].store(buf[w], std::memory_order_relaxed);
+            }
+            job_id.store(job.job_id, std::memory_order_relaxed);
+            generation.store(job.generation, std::memory_order_relaxed);
+            created.store((JobRecord::seconds_of(job.created_at) & ~HAS_VERSIONS_BIT) |
+                          (job.version_count > 0 ? HAS_VERSIONS_BIT : 0), std::memory_order_relaxed);
+        }
+
+        void read_record(JobRecord& out) const noexcept {
+            uint64_t buf[RECORD_WORDS];
+            for (std::size_t w = 0; w < RECORD_WORDS; ++w) {
+                buf[w] = words[w].load(std::memory_order_relaxed);
+            }
+            out.job_id = job_id.load(std::memory_order_relaxed);
+            out.generation = generation.load(std::memory_order_relaxed);
+            const uint32_t stamp = created.load(std::memory_order_relaxed);
+            out.created_seconds = stamp & ~HAS_VERSIONS_BIT;
+            out.has_versions = (stamp & HAS_VERSIONS_BIT) != 0;
+            std::memcpy(out.midstate.data(), buf, sizeof(out.midstate));
+            std::memcpy(out.merkle_tail.data(), &buf[4], out.merkle_tail.size());
+            out.timestamp = static_cast<uint32_t>(buf[4] >> 32);
+            out.bits = static_cast<uint32_t>(buf[5]);
+            out.previous_timestamp = static_cast<uint32_t>(buf[5] >> 32);
+        }
+    };
+    static_assert(sizeof(Slot) == 64, "Горячая запись задания - одна кеш-линия");
+
+    /**
+     * @brief Полный Job слота (холодный столбец)
+     */
+    struct alignas(64) ColdSlot {
+        std::atomic<uint64_t> words[WORDS]{};
+
+        void write(const Job& job) noexcept {
+            uint64_t buf[WORDS]{};
+            std::memcpy(buf, &job, sizeof(Job));
+            for (std::size_t w = 0; w < WORDS; ++w) {
+                words[w].store(buf[w], std::memory_order_relaxed);
+            }
+        }
+
+        /// @brief Копия без seqlock: читатели обрамляют её seq горячей записи
+        [[nodiscard]] Job load_unsynchronized() const noexcept {
+            uint64_t buf[WORDS];
+            for (std::size_t w = 0; w < WORDS; ++w) {
+                buf[w] = words[w].load(std::memory_order_relaxed);
+            }
+            Job job;
+            std::memcpy(&job, buf, sizeof(Job));
+            return job;
+        }
+    };
+
+    /**
+     * @brief Записать задание во все столбцы слота под seqlock
+     */
+    void store(std::size_t index, const Job& job) noexcept {
+        Slot& slot = slots_[index];
+        const uint32_t s = slot.seq.load(std::memory_order_relaxed);
+        slot.seq.store(s + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        slot.write_record(job);
+        extranonces_[index].store(job.extranonce, std::memory_order_relaxed);
+        cold_[index].write(job);
+
+        slot.seq.store(s + 2, std::memory_order_release);
+    }
+
+    /**
+     * @brief Current / Stale / Unknown по прочитанным job_id и поколению слота
+     */
+    [[nodiscard]] JobLookup classify(uint32_t job_id, uint32_t slot_job_id, uint32_t slot_generation) const noexcept {
+        if (slot_job_id == job_id) {
+            return slot_generation == generation() ? JobLookup::Current : JobLookup::Stale;
+        }
+        // Не больше последнего выданного (по модулю 2^32) - вытеснено из кольца
+        const uint32_t newest = newest_id_.load(std::memory_order_acquire);
+        return static_cast<int32_t>(newest - job_id) >= 0 ? JobLookup::Stale : JobLookup::Unknown;
+    }
+
+    std::size_t capacity_;
+    std::unique_ptr<Slot[]> slots_;
+
+    /// @brief Столбец extranonce (8 слотов на кеш-линию)
+    std::unique_ptr<std::atomic<uint64_t>[]> extranonces_;
+
+    std::unique_ptr<ColdSlot[]> cold_;
+    std::atomic<std::size_t> live_{0};
+    std::atomic<uint32_t> generation_{0};
+    std::atomic<uint32_t> newest_id_{0};  ///< Наибольший опубликованный job_id
+};
+
+} // namespace quaxis::mining
@@ -0,0 +1,437 @@
+/**
+ * @file share_journal.cpp
+ * @brief Реализация журнала shares
+ */
+
+#include "share_journal.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace quaxis::mining {
+
+namespace {
+
+/**
+ * @brief Заголовок файла журнала (начало первой страницы)
+ */
+struct FileHeader {
+    uint32_t magic;
+    uint32_t layout_version;
+    uint32_t record_size;
+    uint32_t chunk_records;
+    uint64_t created_ns;
+    uint32_t sequence;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(FileHeader) <= ShareJournal::HEADER_SIZE);
+
+constexpr std::string_view FILE_PREFIX = "shares-";
+constexpr std::string_view FILE_SUFFIX = ".qsj";
+
+/// @brief Номер файла журнала по имени (shares-NNNNNN.qsj)
+std::optional<uint32_t> file_sequence(std::string_view name) {
+    if (name.size() <= FILE_PREFIX.size() + FILE_SUFFIX.size() ||
+        !name.starts_with(FILE_PREFIX) || !name.ends_with(FILE_SUFFIX)) {
+        return std::nullopt;
+    }
+    const auto digits = name.substr(FILE_PREFIX.size(),
+                                    name.size() - FILE_PREFIX.size() - FILE_SUFFIX.size());
+    uint32_t sequence = 0;
+    const auto [end, ec] = std::from_chars(digits.data(), digits.data() + digits.size(), sequence);
+    if (ec != std::errc{} || end != digits.data() + digits.size()) {
+        return std::nullopt;
+    }
+    return sequence;
+}
+
+uint64_t realtime_ns() noexcept {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
+/**
+ * @brief Отображённый файл журнала
+ *
+ * Писатели держат shared_ptr на файл своего куска: файл отображён, пока
+ * последний из них не перешёл на следующий.
+ */
+struct Segment {
+    int fd = -1;
+    uint8_t* map = nullptr;
+    std::size_t size = 0;
+    std::size_t chunks = 0;
+    std::size_t next_chunk = 0;  ///< Под mutex журнала
+    std::string path;
+
+    ~Segment() {
+        if (map) {
+            munmap(map, size);
+        }
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+
+    ShareJournalRecord* chunk(std::size_t index) const noexcept {
+        return reinterpret_cast<ShareJournalRecord*>(
+            map + ShareJournal::HEADER_SIZE +
+            index * ShareJournal::CHUNK_RECORDS * sizeof(ShareJournalRecord));
+    }
+};
+
+/**
+ * @brief Кусок, в который пишет поток
+ */
+struct Cursor {
+    uint64_t owner = 0;
+    std::shared_ptr<Segment> segment;
+    ShareJournalRecord* next = nullptr;
+    ShareJournalRecord* end = nullptr;
+};
+
+thread_local Cursor tls_cursor;
+
+std::atomic<uint64_t> next_journal_id{1};
+
+} // anonymous namespace
+
+struct ShareJournal::Impl {
+    JournalConfig config;
+    const uint64_t id = next_journal_id.fetch_add(1, std::memory_order_relaxed);
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::shared_ptr<Segment> current;
+    std::shared_ptr<Segment> pending;
+    std::vector<std::shared_ptr<Segment>> retired;
+    bool running = false;
+    std::thread thread;
+
+    uint32_t next_sequence = 0;  ///< Только start() и фоновый поток
+
+    std::atomic<uint64_t> records_count{0};
+    std::atomic<uint64_t> dropped_count{0};
+
+    explicit Impl(const JournalConfig& cfg) : config(cfg) {}
+
+    [[nodiscard]] std::string file_path(uint32_t sequence) const {
+        return (std::filesystem::path(config.directory) /
+                std::format("{}{:06}{}", FILE_PREFIX, sequence, FILE_SUFFIX)).string();
+    }
+
+    /**
+     * @brief Создать, выделить на диске и отобразить следующий файл
+     */
+    [[nodiscard]] Result<std::shared_ptr<Segment>> create_segment() {
+        auto segment = std::make_shared<Segment>();
+        const uint32_t sequence = next_sequence++;
+        segment->path = file_path(sequence);
+        segment->size = std::size_t{config.file_mb} * 1024 * 1024;
+        segment->chunks = (segment->size - HEADER_SIZE) / (CHUNK_RECORDS * sizeof(ShareJournalRecord));
+        if (segment->chunks == 0) {
+            return Err<std::shared_ptr<Segment>>(ErrorCode::ConfigInvalidValue,
+                                                 "journal.file_mb меньше одного куска");
+        }
+
+        segment->fd = ::open(segment->path.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+        if (segment->fd < 0) {
+            return Err<std::shared_ptr<Segment>>(ErrorCode::SystemIOError,
+                std::format("Не удалось создать {}: {}", segment->path, strerror(errno)));
+        }
+
+        // Блоки выделяются сразу: запись в отображение не упирается в ENOSPC
+        const int rc = posix_fallocate(segment->fd, 0, static_cast<off_t>(segment->size));
+        if (rc != 0) {
+            ::unlink(segment->path.c_str());
+            return Err<std::shared_ptr<Segment>>(ErrorCode::SystemIOError,
+                std::format("Не удалось выделить {}: {}", segment->path, strerror(rc)));
+        }
+
+        void* ptr = mmap(nullptr, segment->size, PROT_READ | PROT_WRITE, MAP_SHARED, segment->fd, 0);
+        if (ptr == MAP_FAILED) {
+            const int err = errno;
+            ::unlink(segment->path.c_str());
+            return Err<std::shared_ptr<Segment>>(ErrorCode::SystemIOError,
+                std::format("Не удалось отобразить {}: {}", segment->path, strerror(err)));
+        }
+        segment->map = static_cast<uint8_t*>(ptr);
+
+        FileHeader header{};
+        header.magic = FILE_MAGIC;
+        header.layout_version = LAYOUT_VERSION;
+        header.record_size = sizeof(ShareJournalRecord);
+        header.chunk_records = static_cast<uint32_t>(CHUNK_RECORDS);
+        header.created_ns = realtime_ns();
+        header.sequence = sequence;
+        std::memcpy(segment->map, &header, sizeof(header));
+        return segment;
+    }
+
+    /**
+     * @brief Выдать потоку следующий кусок (при необходимости - следующий файл)
+     *
+     * @return false - текущий файл заполнен, а следующий не готов
+     */
+    bool refill(Cursor& cursor) {
+        std::lock_guard<std::mutex> lock(mutex);
+        while (current) {
+            if (current->next_chunk < current->chunks) {
+                cursor.owner = id;
+                cursor.segment = current;
+                cursor.next = current->chunk(current->next_chunk++);
+                cursor.end = cursor.next + CHUNK_RECORDS;
+                return true;
+            }
+            if (!pending) {
+                break;
+            }
+            retired.push_back(std::move(current));
+            current = std::move(pending);
+            cv.notify_one();
+        }
+        cursor = Cursor{};
+        return false;
+    }
+
+    /**
+     * @brief Удалить старые файлы сверх max_files (кроме отображённых)
+     *
+     * Заготовленный следующий файл не считается: в нём ещё нет записей.
+     */
+    void prune_files() {
+        if (config.max_files == 0) {
+            return;
+        }
+        auto files = list_files(config.directory);
+        std::vector<std::string> live;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (pending) {
+                std::erase(files, pending->path);
+            }
+            if (current) {
+                live.push_back(current->path);
+            }
+            for (const auto& segment : retired) {
+                live.push_back(segment->path);
+            }
+        }
+        if (files.size() <= config.max_files) {
+            return;
+        }
+        files.resize(files.size() - config.max_files);
+        for (const auto& path : files) {
+            if (std::find(live.begin(), live.end(), path) == live.end()) {
+                ::unlink(path.c_str());
+            }
+        }
+    }
+
+    void background_loop() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (running) {
+            if (!pending) {
+                lock.unlock();
+                auto segment = create_segment();
+                lock.lock();
+                if (segment) {
+                    pending = std::move(*segment);
+                }
+            }
+
+            // msync текущего и вышедших из записи файлов
+            std::vector<std::shared_ptr<Segment>> dirty = retired;
+            if (current) {
+                dirty.push_back(current);
+            }
+            lock.unlock();
+            for (const auto& segment : dirty) {
+                msync(segment->map, segment->size, MS_SYNC);
+            }
+            dirty.clear();
+            lock.lock();
+
+            // Файлы, на которых не осталось писателей, отображать не нужно
+            std::erase_if(retired, [](const std::shared_ptr<Segment>& segment) {
+                return segment.use_count() == 1;
+            });
+
+            lock.unlock();
+            prune_files();
+            lock.lock();
+
+            cv.wait_for(lock, std::chrono::milliseconds(config.sync_ms),
+                        [this] { return !running || !pending; });
+        }
+    }
+};
+
+ShareJournal::ShareJournal(const JournalConfig& config)
+    : impl_(std::make_unique<Impl>(config))
+{}
+
+ShareJournal::~ShareJournal() {
+    stop();
+}
+
+Result<void> ShareJournal::start() {
+    std::error_code ec;
+    std::filesystem::create_directories(impl_->config.directory, ec);
+    if (ec) {
+        return Err<void>(ErrorCode::SystemIOError,
+            std::format("Не удалось создать {}: {}", impl_->config.directory, ec.message()));
+    }
+
+    // Нумерация продолжается после файлов прежних запусков
+    const auto files = list_files(impl_->config.directory);
+    if (!files.empty()) {
+        const auto name = std::filesystem::path(files.back()).filename().string();
+        impl_->next_sequence = *file_sequence(name) + 1;
+    }
+
+    auto segment = impl_->create_segment();
+    if (!segment) {
+        return std::unexpected(segment.error());
+    }
+
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    impl_->current = std::move(*segment);
+    impl_->running = true;
+    impl_->thread = std::thread([this] { impl_->background_loop(); });
+    return {};
+}
+
+void ShareJournal::stop() {
+    {
+        std::lock_guard<std::mutex> lock(impl_->mutex);
+        if (!impl_->running) {
+            return;
+        }
+        impl_->running = false;
+    }
+    impl_->cv.notify_all();
+    impl_->thread.join();
+
+    std::unique_lock<std::mutex> lock(impl_->mutex);
+    if (impl_->pending) {
+        // Заготовленный файл без записей не оставляем
+        ::unlink(impl_->pending->path.c_str());
+        impl_->pending.reset();
+    }
+    if (impl_->current) {
+        impl_->retired.push_back(std::move(impl_->current));
+    }
+    for (const auto& segment : impl_->retired) {
+        msync(segment->map, segment->size, MS_SYNC);
+    }
+    impl_->retired.clear();
+    lock.unlock();
+    impl_->prune_files();
+}
+
+void ShareJournal::append(const ShareJournalRecord& record, JournalRecordKind kind) noexcept {
+    Cursor& cursor = tls_cursor;
+    if (cursor.owner != impl_->id || cursor.next == cursor.end) {
+        if (!impl_->refill(cursor)) {
+            impl_->dropped_count.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+
+    ShareJournalRecord* slot = cursor.next++;
+    *slot = record;
+    slot->time_ns = realtime_ns();
+    slot->kind = JournalRecordKind::Empty;
+    // Читатель (другой процесс) видит запись только целиком
+    std::atomic_ref<JournalRecordKind>(slot->kind).store(kind, std::memory_order_release);
+    impl_->records_count.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64_t ShareJournal::records() const noexcept {
+    return impl_->records_count.load(std::memory_order_relaxed);
+}
+
+uint64_t ShareJournal::dropped() const noexcept {
+    return impl_->dropped_count.load(std::memory_order_relaxed);
+}
+
+std::vector<std::string> ShareJournal::list_files(const std::string& directory) {
+    std::vector<std::pair<uint32_t, std::string>> found;
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, ec)) {
+        if (auto sequence = file_sequence(entry.path().filename().string())) {
+            found.emplace_back(*sequence, entry.path().string());
+        }
+    }
+    std::sort(found.begin(), found.end());
+
+    std::vector<std::string> files;
+    files.reserve(found.size());
+    for (auto& [sequence, path] : found) {
+        files.push_back(std::move(path));
+    }
+    return files;
+}
+
+Result<std::vector<ShareJournalRecord>> ShareJournal::read_file(const std::string& path) {
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return Err<std::vector<ShareJournalRecord>>(ErrorCode::SystemIOError,
+            std::format("Не удалось открыть {}: {}", path, strerror(errno)));
+    }
+    struct stat st{};
+    if (fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < HEADER_SIZE) {
+        ::close(fd);
+        return Err<std::vector<ShareJournalRecord>>(ErrorCode::SystemIOError,
+            std::format("{}: не журнал shares", path));
+    }
+    const auto size = static_cast<std::size_t>(st.st_size);
+    void* ptr = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (ptr == MAP_FAILED) {
+        return Err<std::vector<ShareJournalRecord>>(ErrorCode::SystemIOError,
+            std::format("Не удалось отобразить {}: {}", path, strerror(errno)));
+    }
+    const auto* data = static_cast<const uint8_t*>(ptr);
+
+    FileHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if (header.magic != FILE_MAGIC || header.layout_version != LAYOUT_VERSION ||
+        header.record_size != sizeof(ShareJournalRecord)) {
+        munmap(ptr, size);
+        return Err<std::vector<ShareJournalRecord>>(ErrorCode::SystemIOError,
+            std::format("{}: не журнал shares или другая версия", path));
+    }
+
+    std::vector<ShareJournalRecord> records;
+    const std::size_t slots = (size - HEADER_SIZE) / sizeof(ShareJournalRecord);
+    for (std::size_t i = 0; i < slots; ++i) {
+        ShareJournalRecord record;
+        std::memcpy(&record, data + HEADER_SIZE + i * sizeof(ShareJournalRecord), sizeof(record));
+        if (record.kind != JournalRecordKind::Empty) {
+            records.push_back(record);
+        }
+    }
+    munmap(ptr, size);
+    return records;
+}
+
+} // namespace quaxis::mining
@@ -0,0 +1,132 @@
+/**
+ * @file share_journal.hpp
+ * @brief Журнал принятых shares (mmap, только дописывание)
+ *
+ * Каждый принятый share и найденный блок - запись фиксированного размера
+ * в файле, отображённом MAP_SHARED: учёт работы по устройствам и аудит
+ * без базы данных и без системных вызовов на пути проверки.
+ *
+ * Файл: заголовок (страница 4096 байт) и куски по CHUNK_RECORDS записей.
+ * Поток-писатель забирает кусок атомарным счётчиком и дальше пишет в него
+ * без синхронизации с другими потоками. Поле kind записывается последним
+ * (release): запись, оборванная падением, или недописанный кусок остаются
+ * нулевыми и при чтении пропускаются.
+ *
+ * Фоновый поток заранее создаёт следующий файл, делает msync раз в
+ * sync_ms и удаляет старые файлы сверх max_files. Файл заполнен, а
+ * следующий ещё не готов - запись теряется (dropped()), проверка shares
+ * не ждёт диска.
+ */
+
+#pragma once
+
+#include "../core/types.hpp"
+#include "../core/config.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace quaxis::mining {
+
+/// @brief Тип записи журнала
+enum class JournalRecordKind : uint8_t {
+    Empty = 0,   ///< Слот не записан
+    Share = 1,   ///< Принятый share (ValidPartial)
+    Block = 2    ///< Найденный блок
+};
+
+/**
+ * @brief Запись журнала (64 байта, little-endian как в памяти)
+ */
+struct ShareJournalRecord {
+    uint64_t time_ns = 0;          ///< Время приёма (CLOCK_REALTIME, нс)
+    uint64_t extranonce = 0;       ///< Extranonce хеша
+    uint32_t connection_id = 0;    ///< Соединение ASIC
+    uint32_t job_id = 0;
+    uint32_t nonce = 0;
+    uint32_t version = 0;          ///< Версия заголовка (0 - версия шаблона)
+    double share_difficulty = 0.0; ///< Назначенная сложность (за неё засчитывается share)
+    double hash_difficulty = 0.0;  ///< Сложность найденного хеша
+    uint32_t timestamp = 0;        ///< Timestamp заголовка
+    uint8_t version_slot = 0;
+    uint8_t reserved[10] = {};
+    JournalRecordKind kind = JournalRecordKind::Empty; ///< Пишется последним
+};
+
+static_assert(sizeof(ShareJournalRecord) == 64, "Запись журнала - 64 байта");
+
+/**
+ * @brief Журнал shares
+ *
+ * append() вызывается из любого числа потоков.
+ */
+class ShareJournal {
+public:
+    /// @brief Сигнатура файла ("QXSJ")
+    static constexpr uint32_t FILE_MAGIC = 0x4A535851;
+
+    /// @brief Версия раскладки записи
+    static constexpr uint32_t LAYOUT_VERSION = 1;
+
+    /// @brief Размер заголовка файла
+    static constexpr std::size_t HEADER_SIZE = 4096;
+
+    /// @brief Записей в куске одного потока
+    static constexpr std::size_t CHUNK_RECORDS = 1024;
+
+    explicit ShareJournal(const JournalConfig& config);
+
+    ~ShareJournal();
+
+    ShareJournal(const ShareJournal&) = delete;
+    ShareJournal& operator=(const ShareJournal&) = delete;
+
+    /**
+     * @brief Создать каталог и первый файл, запустить фоновый поток
+     */
+    [[nodiscard]] Result<void> start();
+
+    /**
+     * @brief Остановить фоновый поток и сбросить файлы на диск
+     *
+     * Вызывается после остановки писателей.
+     */
+    void stop();
+
+    /**
+     * @brief Дописать запись (kind и time_ns заполняются здесь)
+     */
+    void append(const ShareJournalRecord& record, JournalRecordKind kind) noexcept;
+
+    /**
+     * @brief Записано записей
+     */
+    [[nodiscard]] uint64_t records() const noexcept;
+
+    /**
+     * @brief Потеряно записей (следующий файл не был готов)
+     */
+    [[nodiscard]] uint64_t dropped() const noexcept;
+
+    /**
+     * @brief Файлы журнала каталога по возрастанию номера
+     */
+    [[nodiscard]] static std::vector<std::string> list_files(const std::string& directory);
+
+    /**
+     * @brief Прочитать записанные записи файла
+     *
+     * @return Result Записи в порядке кусков (внутри куска - по времени
+     *         одного потока) или ошибка (файл не журнал)
+     */
+    [[nodiscard]] static Result<std::vector<ShareJournalRecord>> read_file(const std::string& path);
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace quaxis::mining
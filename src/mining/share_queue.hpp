@@ -0,0 +1,140 @@
+/**
+ * @file share_queue.hpp
+ * @brief Ограниченная lock-free очередь shares на проверку
+ *
+ * Кольцевой буфер фиксированной ёмкости (степень двойки) со счётчиком
+ * последовательности в каждой ячейке (bounded queue Дмитрия Вьюкова):
+ * - Производители (потоки приёма соединений) занимают ячейку одним CAS
+ *   и никогда не ждут друг друга и проверяющих
+ * - Потребители (потоки ShareValidator) так же забирают ячейки по CAS,
+ *   поэтому один буфер обслуживает весь пул проверки
+ *
+ * Сообщения небольшие и trivially copyable, поэтому хранятся прямо в
+ * ячейках, без аллокаций на share.
+ */
+
+#pragma once
+
+#include "job.hpp"
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+namespace quaxis::mining {
+
+/**
+ * @brief Share, ожидающий проверки
+ */
+struct QueuedShare {
+    Share share;
+    double difficulty = 0.0; ///< Сложность shares ASIC (0 - общая partial difficulty)
+};
+
+/**
+ * @brief Очередь shares: много производителей, много потребителей
+ */
+class ShareQueue {
+public:
+    static_assert(std::is_trivially_copyable_v<QueuedShare>,
+                  "QueuedShare копируется в ячейку без синхронизации полей");
+
+    /**
+     * @brief Создать очередь
+     *
+     * @param capacity Ёмкость (округляется вверх до степени двойки, минимум 2)
+     */
+    explicit ShareQueue(std::size_t capacity)
+        : mask_(std::bit_ceil(capacity < 2 ? std::size_t{2} : capacity) - 1)
+        , cells_(std::make_unique<Cell[]>(mask_ + 1))
+    {
+        for (std::size_t i = 0; i <= mask_; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ShareQueue(const ShareQueue&) = delete;
+    ShareQueue& operator=(const ShareQueue&) = delete;
+
+    /**
+     * @brief Добавить share
+     *
+     * @return false если очередь заполнена
+     */
+    [[nodiscard]] bool try_push(const QueuedShare& item) noexcept {
+        std::size_t pos = tail_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells_[pos & mask_];
+            std::size_t seq = cell.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+            if (diff == 0) {
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.item = item;
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;  // Ячейка ещё не освобождена потребителем
+            } else {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Забрать share
+     *
+     * @return false если очередь пуста
+     */
+    [[nodiscard]] bool try_pop(QueuedShare& item) noexcept {
+        std::size_t pos = head_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells_[pos & mask_];
+            std::size_t seq = cell.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+            if (diff == 0) {
+                if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    item = cell.item;
+                    cell.sequence.store(pos + mask_ + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;  // Производитель ещё не записал ячейку
+            } else {
+                pos = head_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Приблизительное количество shares в очереди
+     */
+    [[nodiscard]] std::size_t size_approx() const noexcept {
+        std::size_t tail = tail_.load(std::memory_order_relaxed);
+        std::size_t head = head_.load(std::memory_order_relaxed);
+        return tail >= head ? tail - head : 0;
+    }
+
+    /**
+     * @brief Ёмкость очереди
+     */
+    [[nodiscard]] std::size_t capacity() const noexcept { return mask_ + 1; }
+
+private:
+    struct Cell {
+        std::atomic<std::size_t> sequence{0};
+        QueuedShare item;
+    };
+
+    std::size_t mask_;
+    std::unique_ptr<Cell[]> cells_;
+
+    // Производители и потребители пишут в разные строки кеша
+    alignas(64) std::atomic<std::size_t> tail_{0};
+    alignas(64) std::atomic<std::size_t> head_{0};
+};
+
+} // namespace quaxis::mining
@@ -4,22 +4,44 @@
  */
 
 #include "share_validator.hpp"
+#include "duplicate_filter.hpp"
+#include "extranonce_lease.hpp"
+#include "share_queue.hpp"
+#include "version_rolling.hpp"
 #include "../bitcoin/target.hpp"
 #include "../core/byte_order.hpp"
+#include "../core/pmu_profile.hpp"
 
+#include <array>
 #include <atomic>
-#include <set>
-#include <mutex>
+#include <cstring>
+#include <thread>
+#include <vector>
 
 namespace quaxis::mining {
 
+/**
+ * @brief Share между проверками до и после хеширования
+ */
+struct PreparedShare {
+    ValidationResult result;
+    crypto::Sha256State midstate{};
+    crypto::HeaderTail tail{};
+    std::optional<bitcoin::BlockHeader> leased;
+    Hash256 target{};
+    uint32_t timestamp = 0;
+    uint32_t previous_timestamp = 0;
+    uint32_t bits = 0;
+    bool has_versions = false;
+};
+
 struct ShareValidator::Impl {
     JobManager& job_manager;
     ValidBlockCallback valid_block_callback;
+    ShareJournal* journal = nullptr;
     
-    double partial_difficulty = 1.0;
-    
-    mutable std::mutex mutex;
+    // Меняется на ходу (перезагрузка конфигурации), читается потоками пула
+    std::atomic<double> partial_difficulty{1.0};
     
     // Статистика
     std::atomic<uint64_t> total_shares_count{0};
@@ -27,27 +49,363 @@ struct ShareValidator::Impl {
     std::atomic<uint64_t> stale_shares_count{0};
     std::atomic<uint64_t> duplicate_shares_count{0};
     
-    // Дедупликация (job_id << 32 | nonce)
-    std::set<uint64_t> seen_shares;
-    static constexpr std::size_t MAX_SEEN_SHARES = 100000;
+    // Пул проверки (submit / submit_batch)
+    static constexpr std::size_t QUEUE_CAPACITY = 8192;
+    static constexpr std::size_t BATCH_SIZE = 64;
+    ShareQueue queue{QUEUE_CAPACITY};
+    std::vector<std::thread> workers;
+    std::atomic<bool> running{false};
+    std::atomic<uint32_t> wakeup{0};
+    
+    // Дедупликация: фильтр фиксированного размера на каждый слот кольца заданий
+    std::unique_ptr<DuplicateFilterRing> duplicates;
+    
+    explicit Impl(JobManager& jm)
+        : job_manager(jm)
+        , duplicates(std::make_unique<DuplicateFilterRing>(
+              jm.job_capacity(), constants::DEFAULT_DUPLICATE_FILTER_SHARES))
+    {}
+    
+    bool check_duplicate(const Share& share, uint32_t timestamp) {
+        return duplicates->check(share, timestamp);
+    }
+    
+    /**
+     * @brief Задание прежнего блока или вытесненное - stale, иначе неизвестное
+     * 
+     * @return false если share отклонён
+     */
+    bool accept_lookup(JobLookup lookup, ValidationResult& result) {
+        switch (lookup) {
+            case JobLookup::Current:
+                return true;
+            case JobLookup::Stale:
+                stale_shares_count.fetch_add(1, std::memory_order_relaxed);
+                result.result = ShareResult::StaleJob;
+                return false;
+            case JobLookup::Unknown:
+                result.result = ShareResult::InvalidJobId;
+                return false;
+        }
+        return false;
+    }
+    
+    /**
+     * @brief Хвост заголовка: последние 4 байта merkle_root + timestamp + bits + nonce
+     */
+    static void fill_tail(PreparedShare& prepared, const std::array<uint8_t, 4>& merkle_tail,
+                          uint32_t timestamp, uint32_t bits, uint32_t nonce) noexcept {
+        std::memcpy(prepared.tail.data(), merkle_tail.data(), merkle_tail.size());
+        write_le32(prepared.tail.data() + 4, timestamp);
+        write_le32(prepared.tail.data() + 8, bits);
+        write_le32(prepared.tail.data() + 12, nonce);
+    }
+    
+    /**
+     * @brief Проверки обычного share по горячей записи задания
+     * 
+     * Share без слота версии, version и смещения аренды к заданию без
+     * слотов версий: midstate, хвост и extranonce - из 64-байтной записи,
+     * target блока - из bits.
+     */
+    bool prepare_record(const Share& share, const JobRecord& record, PreparedShare& prepared) {
+        ValidationResult& result = prepared.result;
+        if (record.is_stale()) {
+            stale_shares_count.fetch_add(1, std::memory_order_relaxed);
+            result.result = ShareResult::StaleJob;
+            return false;
+        }
+        result.version_slot = 0;
+        result.version = 0;
+        result.extranonce = record.extranonce;
+        
+        if (check_duplicate(share, record.timestamp)) {
+            duplicate_shares_count.fetch_add(1, std::memory_order_relaxed);
+            result.result = ShareResult::DuplicateShare;
+            return false;
+        }
+        
+        prepared.midstate = record.midstate;
+        fill_tail(prepared, record.merkle_tail, record.timestamp, record.bits, share.nonce);
+        prepared.target = bitcoin::bits_to_target(record.bits);
+        prepared.timestamp = record.timestamp;
+        prepared.previous_timestamp = record.previous_timestamp;
+        result.timestamp = record.timestamp;
+        prepared.bits = record.bits;
+        prepared.has_versions = false;
+        return true;
+    }
+    
+    /**
+     * @brief Проверки до хеширования: задание, слот, аренда, дубликат
+     * 
+     * @return false если share отклонён (prepared.result окончательный)
+     */
+    bool prepare(const Share& share, PreparedShare& prepared) {
+        ValidationResult& result = prepared.result;
+        result.job_id = share.job_id;
+        result.nonce = share.nonce;
+        result.connection_id = share.connection_id;
+        
+        // Инкрементируем счётчик
+        total_shares_count.fetch_add(1, std::memory_order_relaxed);
+        
+        // Обычному share хватает горячей записи задания, без копии полного Job
+        if (share.version_slot == 0 && share.version == 0 && share.extranonce_offset == 0) {
+            JobRecord record;
+            if (!accept_lookup(job_manager.lookup_job_record(share.job_id, record), result)) {
+                return false;
+            }
+            if (!record.has_versions) {
+                return prepare_record(share, record, prepared);
+            }
+        }
+        
+        Job job;
+        if (!accept_lookup(job_manager.lookup_job(share.job_id, job), result)) {
+            return false;
+        }
+        
+        // Проверяем на stale по возрасту
+        if (job.is_stale()) {
+            stale_shares_count.fetch_add(1, std::memory_order_relaxed);
+            result.result = ShareResult::StaleJob;
+            return false;
+        }
+        
+        // Слот версии: ASIC перебирал midstate именно этой версии
+        const crypto::Sha256State* midstate = job.slot_midstate(share.version_slot);
+        if (!midstate) {
+            // Такого слота в задании нет - ASIC не мог получить эту работу
+            result.result = ShareResult::InvalidJobId;
+            return false;
+        }
+        result.version_slot = share.version_slot;
+        result.version = job.version_count > 0 ? job.versions[share.version_slot] : 0;
+        result.extranonce = job.extranonce;
+        
+        // Версия, перебранная контроллером ASIC: midstate считается здесь
+        std::optional<crypto::Sha256State> rolled;
+        if (share.version != 0) {
+            rolled = rolled_midstate(job, share.version);
+            if (!rolled) {
+                // Задание без маски или версия вне маски - ASIC не мог получить эту работу
+                result.result = ShareResult::InvalidJobId;
+                return false;
+            }
+            midstate = &*rolled;
+            result.version = share.version;
+        }
+        
+        // Extranonce из аренды: ASIC сам построил coinbase и midstate
+        if (share.extranonce_offset != 0) {
+            prepared.leased = leased_header(job, share.extranonce_offset);
+            if (!prepared.leased) {
+                // Смещение вне аренды задания - ASIC не мог получить эту работу
+                result.result = ShareResult::InvalidJobId;
+                return false;
+            }
+            result.extranonce = job.extranonce + share.extranonce_offset;
+        }
+        
+        // Проверяем на дубликат
+        if (check_duplicate(share, job.timestamp)) {
+            duplicate_shares_count.fetch_add(1, std::memory_order_relaxed);
+            result.result = ShareResult::DuplicateShare;
+            return false;
+        }
+        
+        if (prepared.leased) {
+            prepared.leased->nonce = share.nonce;
+        } else {
+            // Хвост заголовка общий для всех слотов версий
+            prepared.midstate = *midstate;
+            fill_tail(prepared, job.merkle_tail, job.timestamp, job.bits, share.nonce);
+        }
+        prepared.target = job.target;
+        prepared.timestamp = job.timestamp;
+        prepared.previous_timestamp = job.previous_timestamp;
+        result.timestamp = job.timestamp;
+        prepared.bits = job.bits;
+        prepared.has_versions = job.version_count > 0 || share.version != 0;
+        return true;
+    }
+    
+    /**
+     * @brief Пересчитать хеш с timestamp до CMD_UPDATE_TIME
+     * 
+     * ASIC мог найти share раньше, чем получил новый timestamp. Второй
+     * хеш считается только для shares, не прошедших порог.
+     * 
+     * @return false если timestamp задания не сдвигался
+     */
+    static bool rehash_previous_timestamp(PreparedShare& prepared) {
+        if (prepared.previous_timestamp == 0) {
+            return false;
+        }
+        prepared.timestamp = prepared.previous_timestamp;
+        prepared.previous_timestamp = 0;
+        prepared.result.timestamp = prepared.timestamp;
+        
+        if (prepared.leased) {
+            prepared.leased->timestamp = prepared.timestamp;
+            prepared.result.hash = prepared.leased->hash();
+        } else {
+            write_le32(prepared.tail.data() + 4, prepared.timestamp);
+            prepared.result.hash = crypto::hash_header_with_midstate(
+                prepared.midstate,
+                std::span<const uint8_t, 16>(prepared.tail)
+            );
+        }
+        return true;
+    }
+    
+    /**
+     * @brief Записать принятый share в журнал
+     */
+    void journal_share(const ValidationResult& result, double share_difficulty, JournalRecordKind kind) {
+        if (!journal) {
+            return;
+        }
+        ShareJournalRecord record;
+        record.extranonce = result.extranonce;
+        record.connection_id = result.connection_id;
+        record.job_id = result.job_id;
+        record.nonce = result.nonce;
+        record.version = result.version;
+        record.share_difficulty = share_difficulty;
+        record.hash_difficulty = result.difficulty;
+        record.timestamp = result.timestamp;
+        record.version_slot = result.version_slot;
+        journal->append(record, kind);
+    }
     
-    explicit Impl(JobManager& jm) : job_manager(jm) {}
+    /**
+     * @brief Проверки после хеширования: порог сложности и найденный блок
+     */
+    void finish(const Share& share, double share_difficulty, PreparedShare& prepared) {
+        ValidationResult& result = prepared.result;
+        
+        // Проверяем соответствие target: сравнение словами uint64, сложность
+        // (double) считается только для shares, прошедших порог
+        const auto block_target = bitcoin::Target256::from_hash(prepared.target);
+        if (!bitcoin::meets_target(result.hash, block_target)) {
+            const auto share_target = bitcoin::difficulty_to_target(share_difficulty);
+            bool is_share = bitcoin::meets_target(result.hash, share_target);
+            bool is_block = false;
+            if (!is_share && rehash_previous_timestamp(prepared)) {
+                is_block = bitcoin::meets_target(result.hash, block_target);
+                is_share = is_block || bitcoin::meets_target(result.hash, share_target);
+            }
+            if (!is_share) {
+                result.result = ShareResult::TargetNotMet;
+                return;
+            }
+            if (!is_block) {
+                result.difficulty = bitcoin::target_to_difficulty(result.hash);
+                result.result = ShareResult::ValidPartial;
+                journal_share(result, share_difficulty, JournalRecordKind::Share);
+                return;
+            }
+        }
+        
+        result.difficulty = bitcoin::target_to_difficulty(result.hash);
+        
+        // БЛОК НАЙДЕН!
+        result.result = ShareResult::Valid;
+        blocks_found_count.fetch_add(1, std::memory_order_relaxed);
+        journal_share(result, share_difficulty, JournalRecordKind::Block);
+        
+        // Вызываем callback
+        if (valid_block_callback) {
+            // Формируем заголовок блока (для аренды он уже полный)
+            bitcoin::BlockHeader header;
+            if (prepared.leased) {
+                header = *prepared.leased;
+            }
+            header.timestamp = prepared.timestamp;
+            header.bits = prepared.bits;
+            header.nonce = share.nonce;
+            if (prepared.has_versions) {
+                header.version = result.version;
+            }
+            // Остальные поля должны быть заполнены из job_manager
+            // (по result.extranonce)
+            
+            valid_block_callback(result, header);
+        }
+    }
     
-    bool check_duplicate(uint32_t job_id, uint32_t nonce) {
-        uint64_t key = (static_cast<uint64_t>(job_id) << 32) | nonce;
+    /**
+     * @brief Проверить пакет из очереди: хеши одним вызовом многоканального SHA256
+     */
+    void validate_batch(std::span<const QueuedShare> batch) {
+        core::PmuScope pmu(core::PmuRegion::ShareValidate, batch.size());
+        std::array<PreparedShare, BATCH_SIZE> prepared;
+        std::array<bool, BATCH_SIZE> ready{};
+        std::array<crypto::Sha256State, BATCH_SIZE> midstates;
+        std::array<crypto::HeaderTail, BATCH_SIZE> tails;
+        std::array<Hash256, BATCH_SIZE> hashes;
+        std::array<std::size_t, BATCH_SIZE> lane_of{};
+        std::size_t lanes = 0;
         
-        std::lock_guard<std::mutex> lock(mutex);
+        for (std::size_t i = 0; i < batch.size(); ++i) {
+            ready[i] = prepare(batch[i].share, prepared[i]);
+            if (!ready[i]) {
+                continue;
+            }
+            if (prepared[i].leased) {
+                // Заголовок аренды строится из coinbase целиком - хешируется отдельно
+                prepared[i].result.hash = prepared[i].leased->hash();
+                continue;
+            }
+            midstates[lanes] = prepared[i].midstate;
+            tails[lanes] = prepared[i].tail;
+            lane_of[lanes++] = i;
+        }
+        
+        crypto::hash_headers_with_midstate_batch(
+            std::span<const crypto::Sha256State>(midstates.data(), lanes),
+            std::span<const crypto::HeaderTail>(tails.data(), lanes),
+            std::span<Hash256>(hashes.data(), lanes)
+        );
+        for (std::size_t lane = 0; lane < lanes; ++lane) {
+            prepared[lane_of[lane]].result.hash = hashes[lane];
+        }
         
-        // Ограничиваем размер
-        if (seen_shares.size() >= MAX_SEEN_SHARES) {
-            // Удаляем старые записи (первые 10%)
-            auto it = seen_shares.begin();
-            std::advance(it, MAX_SEEN_SHARES / 10);
-            seen_shares.erase(seen_shares.begin(), it);
+        for (std::size_t i = 0; i < batch.size(); ++i) {
+            if (ready[i]) {
+                double difficulty = batch[i].difficulty > 0.0
+                    ? batch[i].difficulty : partial_difficulty.load(std::memory_order_relaxed);
+                finish(batch[i].share, difficulty, prepared[i]);
+            }
         }
+    }
+    
+    /**
+     * @brief Поток пула: забирает shares пакетами до BATCH_SIZE
+     */
+    void worker_loop() {
+        std::array<QueuedShare, BATCH_SIZE> batch;
         
-        auto [_, inserted] = seen_shares.insert(key);
-        return !inserted;  // true если дубликат
+        for (;;) {
+            uint32_t seen = wakeup.load(std::memory_order_acquire);
+            
+            std::size_t count = 0;
+            while (count < BATCH_SIZE && queue.try_pop(batch[count])) {
+                ++count;
+            }
+            if (count > 0) {
+                validate_batch(std::span<const QueuedShare>(batch.data(), count));
+                continue;
+            }
+            
+            // Очередь пуста: остановка только после того, как всё проверено
+            if (!running.load(std::memory_order_relaxed)) {
+                return;
+            }
+            wakeup.wait(seen, std::memory_order_acquire);
+        }
     }
 };
 
@@ -56,88 +414,84 @@ ShareValidator::ShareValidator(JobManager& job_manager)
 {
 }
 
-ShareValidator::~ShareValidator() = default;
+ShareValidator::~ShareValidator() {
+    stop_workers();
+}
 
 ValidationResult ShareValidator::validate(const Share& share) {
-    ValidationResult result;
-    result.job_id = share.job_id;
-    result.nonce = share.nonce;
-    
-    // Инкрементируем счётчик
-    impl_->total_shares_count.fetch_add(1, std::memory_order_relaxed);
-    
-    // Получаем задание
-    auto job_opt = impl_->job_manager.get_job(share.job_id);
-    if (!job_opt) {
-        result.result = ShareResult::InvalidJobId;
-        return result;
+    return validate(share, impl_->partial_difficulty.load(std::memory_order_relaxed));
+}
+
+ValidationResult ShareValidator::validate(const Share& share, double share_difficulty) {
+    core::PmuScope pmu(core::PmuRegion::ShareValidate);
+    PreparedShare prepared;
+    if (!impl_->prepare(share, prepared)) {
+        return prepared.result;
     }
     
-    const Job& job = *job_opt;
-    
-    // Проверяем на stale
-    if (job.is_stale()) {
-        impl_->stale_shares_count.fetch_add(1, std::memory_order_relaxed);
-        result.result = ShareResult::StaleJob;
-        return result;
+    if (prepared.leased) {
+        prepared.result.hash = prepared.leased->hash();
+    } else {
+        prepared.result.hash = crypto::hash_header_with_midstate(
+            prepared.midstate,
+            std::span<const uint8_t, 16>(prepared.tail)
+        );
     }
     
-    // Проверяем на дубликат
-    if (impl_->check_duplicate(share.job_id, share.nonce)) {
-        impl_->duplicate_shares_count.fetch_add(1, std::memory_order_relaxed);
-        result.result = ShareResult::DuplicateShare;
-        return result;
+    impl_->finish(share, share_difficulty, prepared);
+    return prepared.result;
+}
+
+void ShareValidator::start_workers(std::size_t threads) {
+    if (threads == 0 || !impl_->workers.empty()) {
+        return;
     }
     
-    // Вычисляем хеш
-    // Формируем хвост заголовка: последние 4 байта merkle_root + timestamp + bits + nonce
-    std::array<uint8_t, 16> header_tail{};
-    
-    // Для правильного вычисления нам нужен полный header
-    // Пока используем упрощённую версию с timestamp + bits + nonce
-    write_le32(header_tail.data() + 0, job.timestamp);
-    write_le32(header_tail.data() + 4, job.bits);
-    write_le32(header_tail.data() + 8, share.nonce);
-    write_le32(header_tail.data() + 12, 0);  // Padding
-    
-    // Вычисляем хеш с использованием midstate
-    result.hash = crypto::hash_header_with_midstate(
-        job.midstate,
-        std::span<const uint8_t, 16>(header_tail)
-    );
+    impl_->running.store(true, std::memory_order_relaxed);
+    for (std::size_t i = 0; i < threads; ++i) {
+        impl_->workers.emplace_back([this] { impl_->worker_loop(); });
+    }
+}
+
+void ShareValidator::stop_workers() {
+    if (impl_->workers.empty()) {
+        return;
+    }
     
-    // Вычисляем сложность найденного хеша
-    result.difficulty = bitcoin::target_to_difficulty(result.hash);
+    impl_->running.store(false, std::memory_order_relaxed);
+    impl_->wakeup.fetch_add(1, std::memory_order_release);
+    impl_->wakeup.notify_all();
     
-    // Проверяем соответствие target
-    if (!bitcoin::meets_target(result.hash, job.target)) {
-        // Проверяем partial difficulty
-        double hash_diff = result.difficulty;
-        if (hash_diff >= impl_->partial_difficulty) {
-            result.result = ShareResult::ValidPartial;
-        } else {
-            result.result = ShareResult::TargetNotMet;
+    for (auto& worker : impl_->workers) {
+        worker.join();
+    }
+    impl_->workers.clear();
+}
+
+void ShareValidator::submit(const Share& share, double share_difficulty) {
+    submit_batch(std::span<const Share>(&share, 1), share_difficulty);
+}
+
+void ShareValidator::submit_batch(std::span<const Share> shares, double share_difficulty) {
+    bool queued = false;
+    for (const Share& share : shares) {
+        if (!impl_->workers.empty() && impl_->queue.try_push(QueuedShare{share, share_difficulty})) {
+            queued = true;
+            continue;
         }
-        return result;
+        // Пул не запущен или очередь заполнена: проверяем в вызывающем потоке
+        (void)validate(share, share_difficulty > 0.0 ? share_difficulty
+                                                     : impl_->partial_difficulty.load(std::memory_order_relaxed));
     }
     
-    // БЛОК НАЙДЕН!
-    result.result = ShareResult::Valid;
-    impl_->blocks_found_count.fetch_add(1, std::memory_order_relaxed);
-    
-    // Вызываем callback
-    if (impl_->valid_block_callback) {
-        // Формируем заголовок блока
-        bitcoin::BlockHeader header;
-        header.timestamp = job.timestamp;
-        header.bits = job.bits;
-        header.nonce = share.nonce;
-        // Остальные поля должны быть заполнены из job_manager
-        
-        impl_->valid_block_callback(result, header);
+    if (queued) {
+        impl_->wakeup.fetch_add(1, std::memory_order_release);
+        impl_->wakeup.notify_one();
     }
-    
-    return result;
+}
+
+std::size_t ShareValidator::pending_shares() const {
+    return impl_->queue.size_approx();
 }
 
 void ShareValidator::set_valid_block_callback(ValidBlockCallback callback) {
@@ -145,7 +499,21 @@ void ShareValidator::set_valid_block_callback(ValidBlockCallback callback) {
 }
 
 void ShareValidator::set_partial_difficulty(double difficulty) {
-    impl_->partial_difficulty = difficulty;
+    impl_->partial_difficulty.store(difficulty, std::memory_order_relaxed);
+}
+
+double ShareValidator::partial_difficulty() const noexcept {
+    return impl_->partial_difficulty.load(std::memory_order_relaxed);
+}
+
+void ShareValidator::set_journal(ShareJournal* journal) {
+    impl_->journal = journal;
+}
+
+void ShareValidator::set_duplicate_filter_size(std::size_t shares_per_job) {
+    impl_->duplicates = std::make_unique<DuplicateFilterRing>(
+        impl_->job_manager.job_capacity(), shares_per_job
+    );
 }
 
 uint64_t ShareValidator::total_shares() const {
@@ -164,14 +532,16 @@ uint64_t ShareValidator::duplicate_shares() const {
     return impl_->duplicate_shares_count.load(std::memory_order_relaxed);
 }
 
+uint64_t ShareValidator::unfiltered_shares() const {
+    return impl_->duplicates->overflows();
+}
+
 void ShareValidator::reset_stats() {
     impl_->total_shares_count.store(0, std::memory_order_relaxed);
     impl_->blocks_found_count.store(0, std::memory_order_relaxed);
     impl_->stale_shares_count.store(0, std::memory_order_relaxed);
     impl_->duplicate_shares_count.store(0, std::memory_order_relaxed);
-    
-    std::lock_guard<std::mutex> lock(impl_->mutex);
-    impl_->seen_shares.clear();
+    impl_->duplicates->clear();
 }
 
 } // namespace quaxis::mining
@@ -7,16 +7,27 @@
  * 2. Вычисление хеша с найденным nonce
  * 3. Проверка соответствия target
  * 4. Детекция дубликатов
+ * 
+ * validate() проверяет share синхронно в вызывающем потоке. submit() и
+ * submit_batch() кладут shares в lock-free очередь, которую разбирает
+ * пул потоков (start_workers): пакетами до 64 shares, с хешированием
+ * через многоканальный SHA256. Потоки приёма соединений тогда не
+ * хешируют сами, а пропускная способность проверки растёт с числом ядер.
+ * Найденные блоки сообщаются через ValidBlockCallback из потока пула.
+ * С журналом (set_journal) принятые shares и блоки дописываются в него
+ * из того же потока, без блокировок.
  */
 
 #pragma once
 
 #include "job.hpp"
 #include "job_manager.hpp"
+#include "share_journal.hpp"
 #include "../bitcoin/block.hpp"
 
 #include <memory>
 #include <functional>
+#include <span>
 
 namespace quaxis::mining {
 
@@ -28,7 +39,12 @@ struct ValidationResult {
     Hash256 hash{};          ///< Вычисленный хеш (если валидация прошла)
     uint32_t job_id = 0;
     uint32_t nonce = 0;
-    double difficulty = 0.0; ///< Сложность найденного хеша
+    uint32_t connection_id = 0; ///< Соединение ASIC (Share::connection_id)
+    double difficulty = 0.0; ///< Сложность найденного хеша (0 для TargetNotMet)
+    uint8_t version_slot = 0; ///< Слот версии задания, из которого пришёл share
+    uint32_t version = 0;    ///< Версия слота (0 для обычного задания)
+    uint64_t extranonce = 0; ///< Extranonce, с которым найден хеш (аренда: начало + смещение)
+    uint32_t timestamp = 0;  ///< Timestamp заголовка share (прежний, если найден до CMD_UPDATE_TIME)
     
     [[nodiscard]] bool is_valid() const noexcept {
         return result == ShareResult::Valid || result == ShareResult::ValidPartial;
@@ -73,18 +89,98 @@ public:
      */
     [[nodiscard]] ValidationResult validate(const Share& share);
     
+    /**
+     * @brief Валидировать share со сложностью соединения (vardiff)
+     * 
+     * Вместо общей partial difficulty используется сложность,
+     * назначенная ASIC, приславшему share.
+     * 
+     * @param share Share от ASIC
+     * @param share_difficulty Сложность shares этого ASIC
+     * @return ValidationResult Результат валидации
+     */
+    [[nodiscard]] ValidationResult validate(const Share& share, double share_difficulty);
+    
+    /**
+     * @brief Запустить пул проверки shares
+     * 
+     * Вызывается до того, как соединения начнут вызывать submit().
+     * 
+     * @param threads Количество потоков (0 - пул не запускается)
+     */
+    void start_workers(std::size_t threads);
+    
+    /**
+     * @brief Остановить пул, проверив shares, оставшиеся в очереди
+     */
+    void stop_workers();
+    
+    /**
+     * @brief Отправить share на проверку пулом
+     * 
+     * Не ждёт хеширования. Без пула или при заполненной очереди share
+     * проверяется в вызывающем потоке, поэтому shares не теряются.
+     * 
+     * @param share Share от ASIC
+     * @param share_difficulty Сложность shares этого ASIC (0 - общая partial difficulty)
+     */
+    void submit(const Share& share, double share_difficulty = 0.0);
+    
+    /**
+     * @brief Отправить пакет shares одного ASIC на проверку пулом
+     * 
+     * @param shares Shares от ASIC
+     * @param share_difficulty Сложность shares этого ASIC (0 - общая partial difficulty)
+     */
+    void submit_batch(std::span<const Share> shares, double share_difficulty = 0.0);
+    
+    /**
+     * @brief Приблизительное количество shares, ожидающих пул
+     */
+    [[nodiscard]] std::size_t pending_shares() const;
+    
     /**
      * @brief Установить callback для валидных блоков
+     * 
+     * При запущенном пуле вызывается из его потоков.
      */
     void set_valid_block_callback(ValidBlockCallback callback);
     
     /**
      * @brief Установить минимальную сложность для partial shares
      * 
+     * Используется validate(share); при vardiff сложность приходит
+     * с каждым share. Можно менять при работающем пуле.
+     * 
      * @param difficulty Минимальная сложность
      */
     void set_partial_difficulty(double difficulty);
     
+    /**
+     * @brief Текущая минимальная сложность для partial shares
+     */
+    [[nodiscard]] double partial_difficulty() const noexcept;
+    
+    /**
+     * @brief Задать размер фильтра дубликатов
+     * 
+     * Вызывается до start_workers() и до первых shares. Память:
+     * job_queue_size × 2 × shares_per_job × 8 байт (слоты выделяются
+     * при первом share).
+     * 
+     * @param shares_per_job Сколько shares каждого задания запоминать
+     */
+    void set_duplicate_filter_size(std::size_t shares_per_job);
+    
+    /**
+     * @brief Дописывать принятые shares и блоки в журнал
+     * 
+     * Вызывается до start_workers(); журнал живёт дольше пула.
+     * 
+     * @param journal Журнал (nullptr - без журнала)
+     */
+    void set_journal(ShareJournal* journal);
+    
     /**
      * @brief Получить количество валидированных shares
      */
@@ -105,6 +201,11 @@ public:
      */
     [[nodiscard]] uint64_t duplicate_shares() const;
     
+    /**
+     * @brief Shares, не запомненные фильтром дубликатов (фильтр задания заполнен)
+     */
+    [[nodiscard]] uint64_t unfiltered_shares() const;
+    
     /**
      * @brief Сбросить статистику
      */
@@ -0,0 +1,289 @@
+/**
+ * @file stale_work.cpp
+ * @brief Реализация учёта потерянной работы
+ */
+
+#include "stale_work.hpp"
+
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+
+namespace quaxis::mining {
+
+namespace {
+
+/// @brief Хешей на share единичной сложности
+constexpr double HASHES_PER_DIFFICULTY = 4294967296.0;
+
+/// @brief Хешей в TH
+constexpr double HASHES_PER_TH = 1e12;
+
+double seconds(StaleWorkAccountant::Clock::duration duration) noexcept {
+    return std::max(std::chrono::duration<double>(duration).count(), 0.0);
+}
+
+double milliseconds(StaleWorkAccountant::Clock::duration duration) noexcept {
+    return seconds(duration) * 1000.0;
+}
+
+uint32_t source_bit(TipSource source) noexcept {
+    return 1u << static_cast<uint32_t>(source);
+}
+
+} // anonymous namespace
+
+std::string_view to_string(TipSource source) noexcept {
+    switch (source) {
+    case TipSource::Shm:         return "shm";
+    case TipSource::ShmTemplate: return "shm_template";
+    case TipSource::Zmq:         return "zmq";
+    case TipSource::Relay:       return "relay";
+    case TipSource::Upstream:    return "upstream";
+    case TipSource::Count:       break;
+    }
+    return "unknown";
+}
+
+std::string_view to_string(StaleCause cause) noexcept {
+    switch (cause) {
+    case StaleCause::Pipeline:           return "pipeline";
+    case StaleCause::UnitSwitch:         return "unit_switch";
+    case StaleCause::SpeculativeInvalid: return "speculative_invalid";
+    case StaleCause::Count:              break;
+    }
+    return "unknown";
+}
+
+struct StaleWorkAccountant::Impl {
+    /**
+     * @brief Оценка хешрейта одного ASIC
+     *
+     * Работа shares копится в окне HASHRATE_WINDOW; по концу окна оценка
+     * сдвигается к его среднему наполовину (первое окно - как есть).
+     */
+    struct Unit {
+        Clock::time_point window_start;
+        Clock::time_point last_share;
+        double window_hashes = 0.0;
+        double rate = 0.0;  ///< H/s, 0 - ещё нет полного окна
+    };
+
+    /**
+     * @brief Текущее событие (последний tip)
+     *
+     * После закрытия остаётся для учёта отставания поздних источников.
+     */
+    struct Event {
+        StaleWorkEvent result;
+        Clock::time_point arrived;
+        std::optional<Clock::time_point> dispatched;
+        std::unordered_map<uint32_t, Clock::time_point> loaded;
+        uint32_t sources_seen = 0;
+        bool confirmed = false;
+        bool closed = false;
+    };
+
+    mutable std::mutex mutex;
+    std::unordered_map<uint32_t, Unit> units;
+    std::optional<Event> current;
+    StaleWorkSnapshot totals;
+    EventCallback event_callback;
+
+    static void roll_window(Unit& unit, Clock::time_point now) noexcept {
+        const double elapsed = seconds(now - unit.window_start);
+        if (elapsed < seconds(HASHRATE_WINDOW)) {
+            return;
+        }
+        const double sample = unit.window_hashes / elapsed;
+        unit.rate = unit.rate > 0.0 ? (unit.rate + sample) / 2.0 : sample;
+        unit.window_hashes = 0.0;
+        unit.window_start = now;
+    }
+
+    /**
+     * @brief Закрыть текущее событие и разнести его потери по причинам
+     *
+     * @param invalidated_at Момент отмены speculative блока
+     */
+    StaleWorkEvent close(Clock::time_point now, std::optional<Clock::time_point> invalidated_at) {
+        Event& event = *current;
+        event.closed = true;
+        StaleWorkEvent& result = event.result;
+        const Clock::time_point dispatched = event.dispatched.value_or(now);
+        result.pipeline_ms = milliseconds(dispatched - event.arrived);
+        result.invalidated = invalidated_at.has_value();
+
+        for (const auto& [id, unit] : units) {
+            if (unit.rate <= 0.0) {
+                continue;
+            }
+            ++result.units;
+            result.hashrate += unit.rate;
+
+            Clock::time_point switched = dispatched;
+            if (auto it = event.loaded.find(id); it != event.loaded.end()) {
+                ++result.units_acked;
+                switched = std::max(it->second, dispatched);
+                result.switch_max_ms = std::max(result.switch_max_ms, milliseconds(switched - dispatched));
+            }
+
+            const double th_per_second = unit.rate / HASHES_PER_TH;
+            if (invalidated_at) {
+                // Старый tip остался действующим: потеряно только время на отменённом
+                result.wasted_th[static_cast<std::size_t>(StaleCause::SpeculativeInvalid)] +=
+                    th_per_second * seconds(*invalidated_at - switched);
+            } else {
+                result.wasted_th[static_cast<std::size_t>(StaleCause::Pipeline)] +=
+                    th_per_second * seconds(dispatched - event.arrived);
+                result.wasted_th[static_cast<std::size_t>(StaleCause::UnitSwitch)] +=
+                    th_per_second * seconds(switched - dispatched);
+            }
+        }
+
+        for (std::size_t i = 0; i < STALE_CAUSE_COUNT; ++i) {
+            totals.wasted_th[i] += result.wasted_th[i];
+        }
+        ++totals.events;
+        if (result.invalidated) {
+            ++totals.invalidated;
+        }
+        totals.last_event = result;
+        event.loaded.clear();
+        return result;
+    }
+
+    void notify(const std::optional<StaleWorkEvent>& closed) const {
+        if (closed && event_callback) {
+            event_callback(*closed);
+        }
+    }
+};
+
+StaleWorkAccountant::StaleWorkAccountant()
+    : impl_(std::make_unique<Impl>())
+{
+}
+
+StaleWorkAccountant::~StaleWorkAccountant() = default;
+
+void StaleWorkAccountant::on_share(uint32_t unit, double difficulty, Clock::time_point now) {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    auto [it, inserted] = impl_->units.try_emplace(unit);
+    Impl::Unit& state = it->second;
+    if (inserted) {
+        state.window_start = now;
+    }
+    state.last_share = now;
+    state.window_hashes += difficulty * HASHES_PER_DIFFICULTY;
+    Impl::roll_window(state, now);
+}
+
+void StaleWorkAccountant::on_tip(TipSource source, const Hash256& tip, uint32_t height,
+                                 bool speculative, Clock::time_point now) {
+    std::optional<StaleWorkEvent> closed;
+    {
+        std::lock_guard<std::mutex> lock(impl_->mutex);
+        auto& current = impl_->current;
+        if (current && current->result.tip == tip) {
+            // Тот же блок от другого источника: его отставание от первого
+            if ((current->sources_seen & source_bit(source)) == 0) {
+                current->sources_seen |= source_bit(source);
+                impl_->totals.source_lag[static_cast<std::size_t>(source)].record(
+                    static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        now - current->arrived).count()));
+            }
+            // Подтверждённый повтор speculative tip
+            if (!speculative) {
+                current->confirmed = true;
+            }
+            return;
+        }
+
+        if (current && !current->closed) {
+            closed = impl_->close(now, std::nullopt);
+        }
+        current.emplace();
+        current->result.tip = tip;
+        current->result.height = height;
+        current->result.source = source;
+        current->result.speculative = speculative;
+        current->arrived = now;
+        current->sources_seen = source_bit(source);
+        ++impl_->totals.first_arrivals[static_cast<std::size_t>(source)];
+    }
+    impl_->notify(closed);
+}
+
+void StaleWorkAccountant::on_dispatched(const Hash256& tip, Clock::time_point now) {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    auto& current = impl_->current;
+    if (current && !current->closed && current->result.tip == tip && !current->dispatched) {
+        current->dispatched = now;
+    }
+}
+
+void StaleWorkAccountant::on_job_loaded(uint32_t unit, Clock::duration since_sent, Clock::time_point now) {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    auto& current = impl_->current;
+    // Задание, отправленное до прихода tip, - работа на старом
+    if (current && !current->closed && now - since_sent >= current->arrived) {
+        current->loaded.try_emplace(unit, now);
+    }
+}
+
+void StaleWorkAccountant::on_speculative_resolved(bool confirmed, Clock::time_point now) {
+    std::optional<StaleWorkEvent> closed;
+    {
+        std::lock_guard<std::mutex> lock(impl_->mutex);
+        auto& current = impl_->current;
+        if (!current || current->closed || !current->result.speculative) {
+            return;
+        }
+        if (confirmed) {
+            current->confirmed = true;
+        } else {
+            closed = impl_->close(now, now);
+        }
+    }
+    impl_->notify(closed);
+}
+
+void StaleWorkAccountant::tick(Clock::time_point now) {
+    std::optional<StaleWorkEvent> closed;
+    {
+        std::lock_guard<std::mutex> lock(impl_->mutex);
+        std::erase_if(impl_->units, [now](const auto& entry) {
+            return now - entry.second.last_share > UNIT_TIMEOUT;
+        });
+        for (auto& [id, unit] : impl_->units) {
+            Impl::roll_window(unit, now);
+        }
+
+        // Speculative событие ждёт решения о блоке или следующего tip
+        auto& current = impl_->current;
+        if (current && !current->closed && (!current->result.speculative || current->confirmed) &&
+            now - current->dispatched.value_or(current->arrived) >= ACK_WINDOW) {
+            closed = impl_->close(now, std::nullopt);
+        }
+    }
+    impl_->notify(closed);
+}
+
+void StaleWorkAccountant::set_event_callback(EventCallback callback) {
+    impl_->event_callback = std::move(callback);
+}
+
+StaleWorkSnapshot StaleWorkAccountant::snapshot() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    StaleWorkSnapshot snapshot = impl_->totals;
+    for (const auto& [id, unit] : impl_->units) {
+        if (unit.rate > 0.0) {
+            snapshot.hashrate += unit.rate;
+            ++snapshot.units;
+        }
+    }
+    return snapshot;
+}
+
+} // namespace quaxis::mining
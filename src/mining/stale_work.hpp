@@ -0,0 +1,195 @@
+/**
+ * @file stale_work.hpp
+ * @brief Учёт работы, потраченной на устаревший tip
+ *
+ * Латентность конвейера видна по этапам (core::LatencyTrace), но не в
+ * потерянном хешрейте: 20 мс рассылки на ферме 100 PH/s и на одном ASIC -
+ * разные потери. StaleWorkAccountant сводит вместе:
+ * - приход каждого tip от каждого источника (первый открывает событие,
+ *   остальные дают отставание источника);
+ * - момент рассылки заданий нового tip;
+ * - RSP_JOB_LOADED каждого ASIC (момент, с которого он хеширует новый tip);
+ * - хешрейт каждого ASIC, оценённый по сложности его shares;
+ * - отмену speculative блока.
+ *
+ * Потерянная работа одного события (блока) делится по причинам:
+ * - Pipeline: от прихода tip до рассылки заданий весь парк хеширует старый;
+ * - UnitSwitch: от рассылки до подтверждения загрузки конкретным ASIC
+ *   (ASIC без RSP_JOB_LOADED считается переключившимся при рассылке);
+ * - SpeculativeInvalid: от загрузки заданий speculative блока до его
+ *   отмены - работа на блоке, который не станет tip. Время на старом tip
+ *   при этом не потеряно и в Pipeline/UnitSwitch не входит.
+ *
+ * Работа - хешрейт × время, в TH (10^12 хешей). Событие закрывается
+ * через ACK_WINDOW после рассылки (speculative - ещё и после решения о
+ * блоке), при отмене speculative блока или с приходом следующего tip.
+ */
+
+#pragma once
+
+#include "../core/latency_trace.hpp"
+#include "../core/types.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string_view>
+
+namespace quaxis::mining {
+
+/**
+ * @brief Источник, сообщивший о новом tip
+ */
+enum class TipSource : uint8_t {
+    Shm,            ///< Заголовок из сегмента блока SHM
+    ShmTemplate,    ///< Шаблон узла из сегмента шаблона SHM
+    Zmq,            ///< ZMQ rawblock
+    Relay,          ///< Header-first из FIBRE relay
+    Upstream,       ///< Шаблон вышестоящего прокси
+    Count
+};
+
+constexpr std::size_t TIP_SOURCE_COUNT = static_cast<std::size_t>(TipSource::Count);
+
+[[nodiscard]] std::string_view to_string(TipSource source) noexcept;
+
+/**
+ * @brief Причина потери работы
+ */
+enum class StaleCause : uint8_t {
+    Pipeline,           ///< Приход tip -> рассылка заданий
+    UnitSwitch,         ///< Рассылка -> RSP_JOB_LOADED ASIC
+    SpeculativeInvalid, ///< Хеширование отменённого speculative блока
+    Count
+};
+
+constexpr std::size_t STALE_CAUSE_COUNT = static_cast<std::size_t>(StaleCause::Count);
+
+[[nodiscard]] std::string_view to_string(StaleCause cause) noexcept;
+
+/**
+ * @brief Итог одного события (нового tip)
+ */
+struct StaleWorkEvent {
+    Hash256 tip{};
+    uint32_t height = 0;                    ///< Высота заданий нового tip
+    TipSource source = TipSource::Shm;      ///< Первый источник
+    bool speculative = false;
+    bool invalidated = false;               ///< Speculative блок отменён
+    double pipeline_ms = 0.0;               ///< Приход -> рассылка
+    double switch_max_ms = 0.0;             ///< Самый поздний RSP_JOB_LOADED после рассылки
+    uint32_t units = 0;                     ///< ASIC с оценкой хешрейта
+    uint32_t units_acked = 0;               ///< Из них подтвердили загрузку
+    double hashrate = 0.0;                  ///< Хешрейт парка, H/s
+    std::array<double, STALE_CAUSE_COUNT> wasted_th{};
+
+    [[nodiscard]] double total_th() const noexcept {
+        double total = 0.0;
+        for (double th : wasted_th) {
+            total += th;
+        }
+        return total;
+    }
+};
+
+/**
+ * @brief Снимок накопленного учёта
+ */
+struct StaleWorkSnapshot {
+    std::array<double, STALE_CAUSE_COUNT> wasted_th{};  ///< Сумма по причинам
+    uint64_t events = 0;                                ///< Закрытых событий
+    uint64_t invalidated = 0;                           ///< Из них отменённых speculative
+    double hashrate = 0.0;                              ///< Текущая оценка парка, H/s
+    std::size_t units = 0;                              ///< ASIC с оценкой хешрейта
+    std::array<uint64_t, TIP_SOURCE_COUNT> first_arrivals{};    ///< Источник был первым
+    std::array<core::LatencyHistogram, TIP_SOURCE_COUNT> source_lag;  ///< Отставание от первого
+    std::optional<StaleWorkEvent> last_event;
+};
+
+/**
+ * @brief Учёт потерянной работы по событиям и причинам
+ *
+ * Thread-safe: входы приходят из потоков источников, соединений и
+ * основного цикла.
+ */
+class StaleWorkAccountant {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /// @brief Окно оценки хешрейта ASIC по shares
+    static constexpr auto HASHRATE_WINDOW = std::chrono::seconds(60);
+
+    /// @brief Сколько после рассылки ждать RSP_JOB_LOADED
+    static constexpr auto ACK_WINDOW = std::chrono::seconds(10);
+
+    /// @brief ASIC без shares дольше этого выпадает из учёта
+    static constexpr auto UNIT_TIMEOUT = std::chrono::minutes(10);
+
+    using EventCallback = std::function<void(const StaleWorkEvent& event)>;
+
+    StaleWorkAccountant();
+    ~StaleWorkAccountant();
+
+    StaleWorkAccountant(const StaleWorkAccountant&) = delete;
+    StaleWorkAccountant& operator=(const StaleWorkAccountant&) = delete;
+
+    /**
+     * @brief Share от ASIC: работа difficulty × 2^32 хешей
+     *
+     * @param unit connection_id соединения
+     * @param difficulty Сложность, по которой ASIC присылает shares
+     */
+    void on_share(uint32_t unit, double difficulty, Clock::time_point now);
+
+    /**
+     * @brief Источник сообщил о tip
+     *
+     * Новый tip закрывает текущее событие и открывает следующее; тот же
+     * tip от другого источника учитывается как его отставание.
+     *
+     * @param height Высота заданий нового tip (tip + 1)
+     */
+    void on_tip(TipSource source, const Hash256& tip, uint32_t height, bool speculative,
+                Clock::time_point now);
+
+    /**
+     * @brief Задания нового tip разосланы (повторы не меняют момент)
+     */
+    void on_dispatched(const Hash256& tip, Clock::time_point now);
+
+    /**
+     * @brief ASIC загрузил задание (RSP_JOB_LOADED)
+     *
+     * @param since_sent Сколько прошло от отправки этого задания
+     */
+    void on_job_loaded(uint32_t unit, Clock::duration since_sent, Clock::time_point now);
+
+    /**
+     * @brief Решение о speculative блоке текущего события
+     */
+    void on_speculative_resolved(bool confirmed, Clock::time_point now);
+
+    /**
+     * @brief Закрыть событие по сроку, обновить оценки хешрейта
+     *
+     * Вызывается периодически (раз в секунду).
+     */
+    void tick(Clock::time_point now);
+
+    /**
+     * @brief Обработчик закрытых событий (вызывается без блокировки)
+     */
+    void set_event_callback(EventCallback callback);
+
+    [[nodiscard]] StaleWorkSnapshot snapshot() const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace quaxis::mining
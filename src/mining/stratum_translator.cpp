@@ -0,0 +1,246 @@
+/**
+ * @file stratum_translator.cpp
+ * @brief Реализация перевода заданий Stratum V1 в задания ASIC
+ */
+
+#include "stratum_translator.hpp"
+#include "../bitcoin/target.hpp"
+#include "../core/byte_order.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+
+namespace quaxis::mining {
+
+namespace {
+
+/// @brief hex -> байты; false для нечётной длины или не-hex символа
+[[nodiscard]] bool decode_hex(std::string_view hex, Bytes& out) {
+    out.resize(hex.size() / 2);
+    return hex_decode(hex, out.data());
+}
+
+/// @brief 8 hex символов big-endian -> uint32
+[[nodiscard]] bool decode_u32(std::string_view hex, uint32_t& out) noexcept {
+    if (hex.size() != 8) {
+        return false;
+    }
+    auto [end, ec] = std::from_chars(hex.data(), hex.data() + hex.size(), out, 16);
+    return ec == std::errc{} && end == hex.data() + hex.size();
+}
+
+/// @brief Высота из BIP34: coinb1 = version | 01 | prevout(36) | len | push(height)
+[[nodiscard]] uint32_t parse_bip34_height(const Bytes& coinbase1) noexcept {
+    constexpr std::size_t PUSH_OFFSET = 42;
+    if (coinbase1.size() <= PUSH_OFFSET) {
+        return 0;
+    }
+    std::size_t size = coinbase1[PUSH_OFFSET];
+    if (size == 0 || size > 4 || coinbase1.size() < PUSH_OFFSET + 1 + size) {
+        return 0;
+    }
+    uint32_t height = 0;
+    for (std::size_t i = 0; i < size; ++i) {
+        height |= static_cast<uint32_t>(coinbase1[PUSH_OFFSET + 1 + i]) << (i * 8);
+    }
+    return height;
+}
+
+[[nodiscard]] Result<StratumWork> invalid(const std::string& message) {
+    return Err<StratumWork>(ErrorCode::MiningInvalidJob, message);
+}
+
+} // anonymous namespace
+
+// =============================================================================
+// Разбор mining.notify
+// =============================================================================
+
+Result<StratumWork> parse_stratum_work(
+    std::string_view job_id,
+    std::string_view prevhash,
+    std::string_view coinbase1,
+    std::string_view coinbase2,
+    std::span<const std::string> merkle_branch,
+    std::string_view version,
+    std::string_view nbits,
+    std::string_view ntime,
+    std::string_view extranonce1,
+    uint32_t extranonce2_size
+) {
+    StratumWork work;
+    work.job_id = std::string(job_id);
+    work.extranonce2_size = extranonce2_size;
+
+    // Слова prevhash - в обратном порядке байт относительно заголовка
+    Hash256 words{};
+    if (prevhash.size() != words.size() * 2 || !hex_decode(prevhash, words.data())) {
+        return invalid("Некорректный prevhash задания " + work.job_id);
+    }
+    for (std::size_t i = 0; i < words.size(); i += 4) {
+        for (std::size_t j = 0; j < 4; ++j) {
+            work.prev_block[i + j] = words[i + 3 - j];
+        }
+    }
+
+    if (!decode_u32(version, work.version) ||
+        !decode_u32(nbits, work.bits) ||
+        !decode_u32(ntime, work.ntime)) {
+        return invalid("Некорректные version/nbits/ntime задания " + work.job_id);
+    }
+
+    if (!decode_hex(coinbase1, work.coinbase1) ||
+        !decode_hex(coinbase2, work.coinbase2) ||
+        !decode_hex(extranonce1, work.extranonce1)) {
+        return invalid("Некорректная coinbase задания " + work.job_id);
+    }
+
+    work.merkle_branch.resize(merkle_branch.size());
+    for (std::size_t i = 0; i < merkle_branch.size(); ++i) {
+        if (merkle_branch[i].size() != 64 || !hex_decode(merkle_branch[i], work.merkle_branch[i].data())) {
+            return invalid("Некорректная merkle branch задания " + work.job_id);
+        }
+    }
+
+    work.height = parse_bip34_height(work.coinbase1);
+    return work;
+}
+
+// =============================================================================
+// StratumJobTranslator
+// =============================================================================
+
+Result<void> StratumJobTranslator::set_work(StratumWork work) {
+    if (work.extranonce2_size == 0 || work.extranonce2_size > MAX_EXTRANONCE2_SIZE) {
+        return Err<void>(ErrorCode::MiningInvalidJob,
+            "Размер extranonce2 вне 1.." + std::to_string(MAX_EXTRANONCE2_SIZE) + ": " +
+            std::to_string(work.extranonce2_size));
+    }
+
+    work_ = std::move(work);
+
+    // Префикс coinb1 | extranonce1 не зависит от extranonce2:
+    // целые блоки по 64 байта сворачиваются один раз на задание
+    Bytes prefix;
+    prefix.reserve(work_.coinbase1.size() + work_.extranonce1.size());
+    prefix.insert(prefix.end(), work_.coinbase1.begin(), work_.coinbase1.end());
+    prefix.insert(prefix.end(), work_.extranonce1.begin(), work_.extranonce1.end());
+    coinbase_ = bitcoin::CoinbaseTemplate(
+        ByteSpan(prefix.data(), prefix.size()),
+        work_.extranonce2_size,
+        ByteSpan(work_.coinbase2.data(), work_.coinbase2.size())
+    );
+
+    header_ = bitcoin::BlockHeader{};
+    header_.version = work_.version;
+    header_.prev_block = work_.prev_block;
+    header_.timestamp = work_.ntime;
+    header_.bits = work_.bits;
+    target_ = bitcoin::bits_to_target(work_.bits);
+
+    has_work_ = true;
+    return {};
+}
+
+void StratumJobTranslator::write_extranonce2(uint8_t* dest, uint64_t extranonce) const noexcept {
+    // Big-endian: hex в mining.submit читается так же, как лежит в coinbase
+    for (uint32_t i = 0; i < work_.extranonce2_size; ++i) {
+        dest[work_.extranonce2_size - 1 - i] = static_cast<uint8_t>(extranonce >> (i * 8));
+    }
+}
+
+std::string StratumJobTranslator::extranonce2_hex(uint64_t extranonce) const {
+    std::array<uint8_t, MAX_EXTRANONCE2_SIZE> bytes{};
+    write_extranonce2(bytes.data(), extranonce);
+
+    std::string hex(work_.extranonce2_size * 2, '0');
+    hex_encode(std::span(bytes).first(work_.extranonce2_size), hex.data());
+    return hex;
+}
+
+std::size_t StratumJobTranslator::merkle_roots(
+    std::span<const uint64_t> extranonces2,
+    std::span<Hash256> out
+) {
+    if (!has_work_) {
+        return 0;
+    }
+    const std::size_t count = std::min(extranonces2.size(), out.size());
+
+    // Coinbase txid: сжатие только хвоста поверх midstate префикса
+    for (std::size_t i = 0; i < count; ++i) {
+        write_extranonce2(coinbase_.extranonce_data(), extranonces2[i]);
+        out[i] = coinbase_.txid();
+    }
+
+    // Ветвь: уровень - count независимых пар (root || branch) для пакетного SHA256d
+    level_.resize(count * 64);
+    for (const auto& branch : work_.merkle_branch) {
+        for (std::size_t i = 0; i < count; ++i) {
+            std::memcpy(level_.data() + i * 64, out[i].data(), 32);
+            std::memcpy(level_.data() + i * 64 + 32, branch.data(), 32);
+        }
+        (void)crypto::sha256d64_batch(ByteSpan(level_.data(), count * 64), out.first(count));
+    }
+
+    return count;
+}
+
+Hash256 StratumJobTranslator::merkle_root(uint64_t extranonce2) {
+    Hash256 root{};
+    (void)merkle_roots(std::span<const uint64_t>(&extranonce2, 1), std::span<Hash256>(&root, 1));
+    return root;
+}
+
+PrecomputedJobSet StratumJobTranslator::translate(
+    std::span<const std::pair<uint32_t, uint64_t>> assignments
+) {
+    PrecomputedJobSet set;
+    if (!has_work_) {
+        return set;
+    }
+
+    // Шаблон без coinbase: блок собирает пул, аренда extranonce недоступна
+    set.block_template.height = work_.height;
+    set.block_template.header = header_;
+    set.block_template.target = target_;
+
+    std::vector<uint64_t> extranonces(assignments.size());
+    std::vector<Hash256> roots(assignments.size());
+    for (std::size_t i = 0; i < assignments.size(); ++i) {
+        extranonces[i] = assignments[i].second;
+    }
+    (void)merkle_roots(extranonces, roots);
+
+    set.jobs.resize(assignments.size());
+    for (std::size_t i = 0; i < assignments.size(); ++i) {
+        auto& pj = set.jobs[i];
+        pj.connection_id = assignments[i].first;
+        pj.extranonce = assignments[i].second;
+        pj.merkle_root = roots[i];
+
+        bitcoin::BlockHeader header = header_;
+        header.merkle_root = roots[i];
+
+        pj.job.midstate = header.compute_midstate();
+        std::memcpy(pj.job.merkle_tail.data(), roots[i].data() + 28, pj.job.merkle_tail.size());
+        pj.job.timestamp = header.timestamp;
+        pj.job.bits = header.bits;
+        pj.job.nonce = 0;
+        pj.job.height = work_.height;
+        pj.job.extranonce = pj.extranonce;
+        pj.job.target = target_;
+        pj.message = pj.job.serialize();
+    }
+
+    return set;
+}
+
+PrecomputedJobSet StratumJobTranslator::translate(const ExtrannonceManager& extranonces) {
+    auto assignments = extranonces.get_active_assignments();
+    std::sort(assignments.begin(), assignments.end());
+    return translate(std::span<const std::pair<uint32_t, uint64_t>>(assignments));
+}
+
+} // namespace quaxis::mining
@@ -0,0 +1,187 @@
+/**
+ * @file stratum_translator.hpp
+ * @brief Перевод заданий Stratum V1 в задания ASIC
+ *
+ * В режиме FallbackStratum задание пула - это части coinbase (coinb1,
+ * coinb2) и merkle branch. Для каждого extranonce2 нужна своя coinbase,
+ * свой merkle root и свой midstate заголовка. Транслятор один раз на
+ * задание готовит:
+ * - midstate префикса coinbase (coinb1 + extranonce1, целые блоки по 64 байта);
+ * - хвост coinbase (остаток префикса, место под extranonce2, coinb2);
+ * - merkle branch и шаблон заголовка.
+ *
+ * Задание соединения тогда стоит сжатий одного хвоста coinbase, прохода
+ * по ветви и одного midstate заголовка. Ветвь проходится уровнями по всем
+ * соединениям сразу: каждый уровень - пакет независимых 64-байтных
+ * сообщений для многоканального sha256d64_batch.
+ *
+ * Результат - PrecomputedJobSet, как у TemplateCache в соло режиме:
+ * JobManager::on_new_block(set.block_template), затем
+ * JobManager::adopt_precomputed_jobs(set.jobs) и рассылка set.jobs.
+ * Шаблон набора без coinbase: блок собирает пул, share уходят в
+ * mining.submit (extranonce2 соединения - extranonce2_hex()).
+ */
+
+#pragma once
+
+#include "job.hpp"
+#include "extranonce_manager.hpp"
+#include "template_cache.hpp"
+#include "../bitcoin/coinbase.hpp"
+#include "../core/types.hpp"
+
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace quaxis::mining {
+
+// =============================================================================
+// Задание пула
+// =============================================================================
+
+/**
+ * @brief Задание Stratum V1 (mining.notify) в бинарном виде
+ */
+struct StratumWork {
+    /// @brief ID задания пула
+    std::string job_id;
+
+    /// @brief Хеш предыдущего блока в порядке заголовка
+    Hash256 prev_block{};
+
+    /// @brief Версия, nBits и nTime заголовка
+    uint32_t version = 0;
+    uint32_t bits = 0;
+    uint32_t ntime = 0;
+
+    /// @brief Высота из BIP34 префикса coinb1 (0 - не удалось разобрать)
+    uint32_t height = 0;
+
+    /// @brief Coinbase: coinbase1 | extranonce1 | extranonce2 | coinbase2
+    Bytes coinbase1;
+    Bytes extranonce1;
+    Bytes coinbase2;
+    uint32_t extranonce2_size = 4;
+
+    /// @brief Merkle branch coinbase (внутренний порядок байт)
+    std::vector<Hash256> merkle_branch;
+};
+
+/**
+ * @brief Разобрать hex поля mining.notify
+ *
+ * prevhash в Stratum - 8 слов по 4 байта с обратным порядком байт в
+ * каждом слове; version, nbits и ntime - big-endian hex.
+ *
+ * @return Result<StratumWork> Задание или MiningInvalidJob
+ */
+[[nodiscard]] Result<StratumWork> parse_stratum_work(
+    std::string_view job_id,
+    std::string_view prevhash,
+    std::string_view coinbase1,
+    std::string_view coinbase2,
+    std::span<const std::string> merkle_branch,
+    std::string_view version,
+    std::string_view nbits,
+    std::string_view ntime,
+    std::string_view extranonce1,
+    uint32_t extranonce2_size
+);
+
+// =============================================================================
+// Транслятор
+// =============================================================================
+
+/**
+ * @brief Кеш задания пула и построение заданий ASIC
+ *
+ * Не потокобезопасен: вызывается из потока, получающего задания пула.
+ */
+class StratumJobTranslator {
+public:
+    /// @brief Наибольший extranonce2, который назначает транслятор
+    static constexpr uint32_t MAX_EXTRANONCE2_SIZE = 8;
+
+    /**
+     * @brief Принять новое задание пула
+     *
+     * Считает midstate префикса coinbase и готовит хвост и шаблон
+     * заголовка. Прежние наборы заданий остаются корректными (они
+     * самодостаточны), новые строятся по этому заданию.
+     *
+     * @return Result<void> MiningInvalidJob при extranonce2 длиннее
+     *         MAX_EXTRANONCE2_SIZE или пустом extranonce2
+     */
+    [[nodiscard]] Result<void> set_work(StratumWork work);
+
+    /**
+     * @brief Есть ли задание
+     */
+    [[nodiscard]] bool has_work() const noexcept { return has_work_; }
+
+    /**
+     * @brief Текущее задание пула
+     */
+    [[nodiscard]] const StratumWork& work() const noexcept { return work_; }
+
+    /**
+     * @brief Merkle root для пачки extranonce2
+     *
+     * @param extranonces2 Значения extranonce2 (младшие extranonce2_size байт)
+     * @param out Выходные merkle root
+     * @return Количество вычисленных (min размеров), 0 без задания
+     */
+    std::size_t merkle_roots(std::span<const uint64_t> extranonces2, std::span<Hash256> out);
+
+    /**
+     * @brief Merkle root для одного extranonce2
+     */
+    [[nodiscard]] Hash256 merkle_root(uint64_t extranonce2);
+
+    /**
+     * @brief Набор заданий для соединений
+     *
+     * Extranonce соединения служит его extranonce2. job_id назначит
+     * JobManager::adopt_precomputed_jobs().
+     *
+     * @param assignments Пары (connection_id, extranonce)
+     * @return PrecomputedJobSet Шаблон и задания (пустой без задания)
+     */
+    [[nodiscard]] PrecomputedJobSet translate(
+        std::span<const std::pair<uint32_t, uint64_t>> assignments
+    );
+
+    /**
+     * @brief Набор заданий для всех соединений ExtrannonceManager
+     */
+    [[nodiscard]] PrecomputedJobSet translate(const ExtrannonceManager& extranonces);
+
+    /**
+     * @brief extranonce2 соединения в hex для mining.submit
+     */
+    [[nodiscard]] std::string extranonce2_hex(uint64_t extranonce) const;
+
+    /**
+     * @brief Шаблон заголовка задания (merkle_root нулевой)
+     */
+    [[nodiscard]] const bitcoin::BlockHeader& header() const noexcept { return header_; }
+
+private:
+    void write_extranonce2(uint8_t* dest, uint64_t extranonce) const noexcept;
+
+    StratumWork work_;
+    bool has_work_ = false;
+
+    // Coinbase: coinb1 | extranonce1 | extranonce2 | coinb2, префикс свёрнут
+    bitcoin::CoinbaseTemplate coinbase_;
+
+    bitcoin::BlockHeader header_;
+    Hash256 target_{};
+
+    // Буфер уровня ветви: пары (root, branch[level]) по 64 байта
+    Bytes level_;
+};
+
+} // namespace quaxis::mining
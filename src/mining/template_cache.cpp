@@ -5,7 +5,9 @@
 
 #include "template_cache.hpp"
 #include "../bitcoin/target.hpp"
+#include "../core/byte_order.hpp"
 
+#include <atomic>
 #include <cstring>
 
 namespace quaxis::mining {
@@ -19,11 +21,24 @@ struct TemplateCache::Impl {
     std::optional<bitcoin::BlockTemplate> current_template;
     std::optional<bitcoin::BlockTemplate> precomputed_template;
     
+    std::vector<PrecomputedJob> precomputed_jobs;
+    std::optional<Hash256> precomputed_prev_hash;
+    
+    // Наборы последних tip, от старых к новым (prev_block шаблона - tip)
+    std::vector<PrecomputedJobSet> competing;
+    
+    // Набор отката speculative блока: забирается без mutex
+    std::atomic<std::shared_ptr<RollbackJobSet>> rollback;
+    
     uint64_t current_extranonce = 0;
     
+    // Сериализованная coinbase: шаблоны блоков только правят её поля
+    bitcoin::CoinbaseTemplate coinbase;
+    
     Impl(const MiningConfig& cfg, bitcoin::CoinbaseBuilder builder)
         : config(cfg)
         , coinbase_builder(std::move(builder))
+        , coinbase(coinbase_builder.make_template(0, 0, 0))
     {}
     
     bitcoin::BlockTemplate create_template(
@@ -45,19 +60,13 @@ struct TemplateCache::Impl {
         tmpl.header.bits = bits;
         tmpl.header.nonce = 0;
         
-        // Создаём coinbase транзакцию
-        auto [coinbase, coinbase_midstate] = coinbase_builder.build_with_midstate(
-            height,
-            coinbase_value,
-            current_extranonce
-        );
-        
-        tmpl.coinbase_tx = std::move(coinbase);
-        tmpl.coinbase_midstate = coinbase_midstate;
+        // Coinbase: правка полей готовой сериализации
+        bitcoin::CoinbaseBuilder::update_template(coinbase, height, coinbase_value, current_extranonce);
+        tmpl.coinbase_tx = coinbase.bytes();
+        tmpl.coinbase_midstate = coinbase.prefix_state();
         
-        // Вычисляем merkle root (для пустого блока = coinbase txid)
-        Hash256 coinbase_txid = bitcoin::compute_txid(tmpl.coinbase_tx);
-        tmpl.header.merkle_root = coinbase_txid;
+        // Merkle root пустого блока = coinbase txid, первый блок уже свёрнут
+        tmpl.header.merkle_root = coinbase.txid();
         
         // Вычисляем midstate заголовка
         tmpl.header_midstate = tmpl.header.compute_midstate();
@@ -67,6 +76,94 @@ struct TemplateCache::Impl {
         
         return tmpl;
     }
+    
+    /**
+     * @brief Досчитать midstate и сообщение задания по готовому merkle root
+     * 
+     * @param tmpl Шаблон с уже подставленным prev_block
+     * @param pj Предвычисленное задание
+     */
+    static void finalize_job(const bitcoin::BlockTemplate& tmpl, PrecomputedJob& pj) noexcept {
+        bitcoin::BlockHeader header = tmpl.header;
+        header.merkle_root = pj.merkle_root;
+        
+        pj.job.midstate = header.compute_midstate();
+        std::memcpy(pj.job.merkle_tail.data(), pj.merkle_root.data() + 28, pj.job.merkle_tail.size());
+        pj.job.timestamp = header.timestamp;
+        pj.job.bits = header.bits;
+        pj.job.nonce = 0;
+        pj.job.height = tmpl.height;
+        pj.job.extranonce = pj.extranonce;
+        pj.job.target = tmpl.target;
+        pj.message = pj.job.serialize();
+    }
+    
+    /**
+     * @brief Перевести набор на tip и timestamp
+     * 
+     * @param set Набор заданий
+     * @param prev_hash Новый prev_block
+     * @param timestamp Новый timestamp
+     * @param prev_matches Задания уже построены для prev_hash
+     */
+    static void retarget(PrecomputedJobSet& set, const Hash256& prev_hash, uint32_t timestamp, bool prev_matches) {
+        auto& tmpl = set.block_template;
+        tmpl.header.timestamp = timestamp;
+        
+        if (!prev_matches) {
+            tmpl.header.prev_block = prev_hash;
+            for (auto& pj : set.jobs) {
+                finalize_job(tmpl, pj);
+            }
+        } else {
+            // Midstate не зависит от timestamp: патчим только хвост сообщения
+            for (auto& pj : set.jobs) {
+                pj.job.timestamp = timestamp;
+                write_le32(pj.message.data() + constants::SHA256_MIDSTATE_SIZE, timestamp);
+            }
+        }
+        
+        // Общий шаблон (extranonce = 0) тоже должен указывать на новый tip
+        tmpl.header.merkle_root = bitcoin::compute_txid(tmpl.coinbase_tx);
+        tmpl.header_midstate = tmpl.header.compute_midstate();
+    }
+    
+    /**
+     * @brief Запомнить набор tip (вытесняя самый старый и низшие высоты)
+     */
+    void remember(const PrecomputedJobSet& set) {
+        if (config.competing_tips == 0) {
+            return;
+        }
+        const auto& tmpl = set.block_template;
+        std::erase_if(competing, [&](const PrecomputedJobSet& other) {
+            return other.block_template.height < tmpl.height ||
+                   other.block_template.header.prev_block == tmpl.header.prev_block;
+        });
+        if (competing.size() >= config.competing_tips) {
+            competing.erase(competing.begin());
+        }
+        competing.push_back(set);
+    }
+    
+    /**
+     * @brief Набор конкурирующего tip для высоты
+     * 
+     * @return Набор этого tip, иначе соседа той же высоты, иначе nullptr
+     */
+    const PrecomputedJobSet* find_competing(const Hash256& prev_hash, uint32_t height) const {
+        const PrecomputedJobSet* sibling = nullptr;
+        for (const auto& set : competing) {
+            if (set.block_template.height != height) {
+                continue;
+            }
+            if (set.block_template.header.prev_block == prev_hash) {
+                return &set;
+            }
+            sibling = &set;
+        }
+        return sibling;
+    }
 };
 
 TemplateCache::TemplateCache(
@@ -124,6 +221,10 @@ void TemplateCache::precompute_next(
     
     uint32_t estimated_timestamp = impl_->current_template->header.timestamp + 600; // ~10 минут
     
+    // Задания старого предвычисленного шаблона больше не действительны
+    impl_->precomputed_jobs.clear();
+    impl_->precomputed_prev_hash.reset();
+    
     impl_->precomputed_template = impl_->create_template(
         estimated_prev_hash,
         estimated_next_height,
@@ -133,6 +234,151 @@ void TemplateCache::precompute_next(
     );
 }
 
+std::size_t TemplateCache::precompute_next_jobs(
+    const ExtrannonceManager& extranonces,
+    const std::optional<Hash256>& expected_prev_hash
+) {
+    // Снимок соединений берём до захвата mutex кеша
+    auto assignments = extranonces.get_active_assignments();
+    
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    
+    impl_->precomputed_jobs.clear();
+    impl_->precomputed_prev_hash.reset();
+    
+    if (!impl_->precomputed_template) {
+        return 0;
+    }
+    
+    auto& tmpl = *impl_->precomputed_template;
+    if (expected_prev_hash) {
+        tmpl.header.prev_block = *expected_prev_hash;
+        impl_->precomputed_prev_hash = expected_prev_hash;
+    }
+    
+    impl_->precomputed_jobs.reserve(assignments.size());
+    for (const auto& [connection_id, extranonce] : assignments) {
+        PrecomputedJob pj;
+        pj.connection_id = connection_id;
+        pj.extranonce = extranonce;
+        pj.merkle_root = tmpl.merkle_root_for_extranonce(extranonce);
+        if (expected_prev_hash) {
+            Impl::finalize_job(tmpl, pj);
+        }
+        impl_->precomputed_jobs.push_back(pj);
+    }
+    
+    return impl_->precomputed_jobs.size();
+}
+
+std::optional<PrecomputedJobSet> TemplateCache::take_next_jobs(
+    const Hash256& prev_hash,
+    uint32_t height,
+    uint32_t timestamp
+) {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    
+    PrecomputedJobSet set;
+    bool prev_matches = false;
+    
+    if (impl_->precomputed_template && impl_->precomputed_template->height == height) {
+        set.block_template = std::move(*impl_->precomputed_template);
+        set.jobs = std::move(impl_->precomputed_jobs);
+        impl_->precomputed_template = std::nullopt;
+        impl_->precomputed_jobs.clear();
+        
+        prev_matches = impl_->precomputed_prev_hash && *impl_->precomputed_prev_hash == prev_hash;
+        impl_->precomputed_prev_hash.reset();
+    } else if (const auto* competing = impl_->find_competing(prev_hash, height)) {
+        // Гонка блоков: tip уже был или его сосед той же высоты
+        set = *competing;
+        prev_matches = set.block_template.header.prev_block == prev_hash;
+    } else {
+        return std::nullopt;
+    }
+    
+    Impl::retarget(set, prev_hash, timestamp, prev_matches);
+    impl_->current_template = set.block_template;
+    impl_->remember(set);
+    
+    return set;
+}
+
+std::size_t TemplateCache::remember_current_jobs(const ExtrannonceManager& extranonces) {
+    if (impl_->config.competing_tips == 0) {
+        return 0;
+    }
+    
+    // Снимок соединений берём до захвата mutex кеша
+    auto assignments = extranonces.get_active_assignments();
+    
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    
+    if (!impl_->current_template) {
+        return 0;
+    }
+    
+    PrecomputedJobSet set;
+    set.block_template = *impl_->current_template;
+    set.jobs.reserve(assignments.size());
+    for (const auto& [connection_id, extranonce] : assignments) {
+        PrecomputedJob pj;
+        pj.connection_id = connection_id;
+        pj.extranonce = extranonce;
+        pj.merkle_root = set.block_template.merkle_root_for_extranonce(extranonce);
+        Impl::finalize_job(set.block_template, pj);
+        set.jobs.push_back(pj);
+    }
+    
+    impl_->remember(set);
+    return set.jobs.size();
+}
+
+std::size_t TemplateCache::retain_rollback(
+    std::shared_ptr<const bitcoin::BlockTemplate> previous,
+    const ExtrannonceManager& extranonces
+) {
+    if (!previous) {
+        drop_rollback();
+        return 0;
+    }
+    if (auto held = impl_->rollback.load(); held && held->block_template == previous) {
+        return held->jobs.size();
+    }
+    
+    // Mutex кеша не нужен: шаблон неизменяем, набор публикуется заменой.
+    // Снимок отсортирован по connection_id (порядок broadcast_job_set)
+    auto assignments = extranonces.get_active_assignments();
+    auto set = std::make_shared<RollbackJobSet>();
+    set->jobs.reserve(assignments.size());
+    for (const auto& [connection_id, extranonce] : assignments) {
+        PrecomputedJob pj;
+        pj.connection_id = connection_id;
+        pj.extranonce = extranonce;
+        pj.merkle_root = previous->merkle_root_for_extranonce(extranonce);
+        Impl::finalize_job(*previous, pj);
+        set->jobs.push_back(pj);
+    }
+    set->block_template = std::move(previous);
+    
+    const std::size_t count = set->jobs.size();
+    impl_->rollback.store(std::move(set));
+    return count;
+}
+
+std::shared_ptr<RollbackJobSet> TemplateCache::take_rollback() {
+    return impl_->rollback.exchange(nullptr);
+}
+
+void TemplateCache::drop_rollback() {
+    impl_->rollback.store(nullptr);
+}
+
+std::size_t TemplateCache::competing_tip_count() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    return impl_->competing.size();
+}
+
 bool TemplateCache::activate_precomputed() {
     std::lock_guard<std::mutex> lock(impl_->mutex);
     
@@ -142,6 +388,8 @@ bool TemplateCache::activate_precomputed() {
     
     impl_->current_template = std::move(impl_->precomputed_template);
     impl_->precomputed_template = std::nullopt;
+    impl_->precomputed_jobs.clear();
+    impl_->precomputed_prev_hash.reset();
     
     return true;
 }
@@ -150,6 +398,10 @@ void TemplateCache::clear() {
     std::lock_guard<std::mutex> lock(impl_->mutex);
     impl_->current_template = std::nullopt;
     impl_->precomputed_template = std::nullopt;
+    impl_->precomputed_jobs.clear();
+    impl_->precomputed_prev_hash.reset();
+    impl_->competing.clear();
+    impl_->rollback.store(nullptr);
 }
 
 uint32_t TemplateCache::current_height() const {
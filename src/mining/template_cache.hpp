@@ -4,10 +4,23 @@
  * 
  * Оптимизация: предвычисляем шаблон блока N+1 пока майним блок N.
  * Это позволяет мгновенно переключиться на новый блок при появлении.
+ * 
+ * Гонка блоков: два блока одной высоты приходят почти одновременно, и
+ * tip может смениться туда и обратно. Кеш держит готовые наборы заданий
+ * (шаблон, coinbase с commitments, merkle root и midstate каждого
+ * соединения) для последних competing_tips tip одной высоты: возврат к
+ * уже виденному tip - копия набора, новый сосед - один SHA256 transform
+ * на соединение.
+ *
+ * Speculative блок (spy mining): пока он не подтверждён, кеш держит
+ * готовые задания tip, на котором он пришёл (retain_rollback). Невалидный
+ * блок откатывается заменой указателя и рассылкой этих заданий.
  */
 
 #pragma once
 
+#include "job.hpp"
+#include "extranonce_manager.hpp"
 #include "../bitcoin/block.hpp"
 #include "../bitcoin/coinbase.hpp"
 #include "../core/config.hpp"
@@ -15,16 +28,42 @@
 #include <memory>
 #include <optional>
 #include <mutex>
+#include <vector>
 
 namespace quaxis::mining {
 
+/**
+ * @brief Набор заданий для следующего блока
+ * 
+ * Шаблон следующего блока и готовые задания для всех соединений,
+ * зарегистрированных в ExtrannonceManager на момент предвычисления.
+ */
+struct PrecomputedJobSet {
+    /// @brief Шаблон блока (prev_block уже подставлен)
+    bitcoin::BlockTemplate block_template;
+    
+    /// @brief Задания, отсортированные по connection_id
+    std::vector<PrecomputedJob> jobs;
+};
+
+/**
+ * @brief Задания tip, к которому откатывается speculative блок
+ */
+struct RollbackJobSet {
+    /// @brief Шаблон tip (тот же объект, что JobManager::rollback_template)
+    std::shared_ptr<const bitcoin::BlockTemplate> block_template;
+    
+    /// @brief Готовые задания (сообщение, extranonce), отсортированные по connection_id
+    std::vector<PrecomputedJob> jobs;
+};
+
 /**
  * @brief Кеш предвычисленных шаблонов блоков
  * 
  * Хранит:
  * - Текущий активный шаблон
  * - Предвычисленный шаблон следующего блока
- * - Историю последних N блоков (для orphan detection)
+ * - Готовые наборы заданий конкурирующих tip (MiningConfig::competing_tips)
  */
 class TemplateCache {
 public:
@@ -90,6 +129,97 @@ public:
         uint32_t estimated_bits
     );
     
+    /**
+     * @brief Предвычислить задания следующего блока для всех соединений
+     * 
+     * Для каждого соединения из ExtrannonceManager заранее считается
+     * coinbase txid (merkle root) предвычисленного шаблона. Если хеш
+     * ожидаемого tip известен, сразу считаются midstate и 48-байтные
+     * сообщения — тогда take_next_jobs() ничего не хеширует.
+     * 
+     * Требует предварительного вызова precompute_next().
+     * 
+     * @param extranonces Менеджер extranonce (источник соединений)
+     * @param expected_prev_hash Хеш ожидаемого следующего tip (если известен)
+     * @return std::size_t Количество подготовленных заданий
+     */
+    std::size_t precompute_next_jobs(
+        const ExtrannonceManager& extranonces,
+        const std::optional<Hash256>& expected_prev_hash = std::nullopt
+    );
+    
+    /**
+     * @brief Забрать предвычисленные задания при появлении блока
+     * 
+     * Если предвычисленный набор построен для этой высоты, шаблон
+     * становится активным, а набор отдаётся вызывающему. Когда prev_hash
+     * не совпал с ожидаемым, для каждого задания пересчитывается только
+     * midstate заголовка (один SHA256 transform); timestamp патчится прямо
+     * в готовом сообщении.
+     * 
+     * Если предвычисленного набора для этой высоты нет, берётся набор
+     * конкурирующего tip: для того же tip - копия с новым timestamp, для
+     * соседа той же высоты - с пересчётом midstate. Отданный набор
+     * запоминается как набор нового tip.
+     * 
+     * @param prev_hash Хеш появившегося блока (prev_block следующего)
+     * @param height Высота следующего блока
+     * @param timestamp Timestamp следующего блока
+     * @return std::optional<PrecomputedJobSet> Набор или nullopt (нет/другая высота)
+     */
+    [[nodiscard]] std::optional<PrecomputedJobSet> take_next_jobs(
+        const Hash256& prev_hash,
+        uint32_t height,
+        uint32_t timestamp
+    );
+    
+    /**
+     * @brief Запомнить задания текущего шаблона как набор его tip
+     * 
+     * Для tip, задания которого собраны без кеша (update_template): при
+     * гонке блоков возврат к нему не потребует пересборки. Вызывается
+     * после рассылки.
+     * 
+     * @param extranonces Менеджер extranonce (источник соединений)
+     * @return std::size_t Количество подготовленных заданий
+     */
+    std::size_t remember_current_jobs(const ExtrannonceManager& extranonces);
+    
+    /**
+     * @brief Количество конкурирующих tip с готовыми наборами
+     */
+    [[nodiscard]] std::size_t competing_tip_count() const;
+    
+    /**
+     * @brief Подготовить задания tip, к которому откатится speculative блок
+     * 
+     * Вызывается после рассылки заданий speculative блока с
+     * JobManager::rollback_template(): шаблон уже со своей coinbase (aux
+     * commitment, транзакции узла), для каждого соединения считаются
+     * merkle root, midstate и готовое сообщение. Набор для того же
+     * шаблона не пересобирается (speculative поверх speculative).
+     * 
+     * @param previous Шаблон прежнего tip (nullptr - сбросить набор)
+     * @param extranonces Менеджер extranonce (источник соединений)
+     * @return std::size_t Количество заданий в наборе
+     */
+    std::size_t retain_rollback(
+        std::shared_ptr<const bitcoin::BlockTemplate> previous,
+        const ExtrannonceManager& extranonces
+    );
+    
+    /**
+     * @brief Забрать набор отката (атомарная замена указателя на nullptr)
+     * 
+     * @return nullptr - набора нет
+     */
+    [[nodiscard]] std::shared_ptr<RollbackJobSet> take_rollback();
+    
+    /**
+     * @brief Сбросить набор отката (speculative блок подтверждён)
+     */
+    void drop_rollback();
+    
     /**
      * @brief Активировать предвычисленный шаблон
      * 
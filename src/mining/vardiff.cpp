@@ -0,0 +1,96 @@
+/**
+ * @file vardiff.cpp
+ * @brief Реализация vardiff
+ */
+
+#include "vardiff.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace quaxis::mining {
+
+VardiffController::VardiffController(const VardiffConfig& config, Clock::time_point now) noexcept
+    : config_(config)
+    , difficulty_(std::clamp(config.start_difficulty, config.min_difficulty, config.max_difficulty))
+    , previous_difficulty_(difficulty_)
+    , changed_at_(now)
+    , window_start_(now)
+{
+}
+
+std::optional<uint32_t> VardiffController::on_share(Clock::time_point now) noexcept {
+    ++window_shares_;
+
+    double elapsed = std::chrono::duration<double>(now - window_start_).count();
+    double expected = config_.target_shares_per_minute * config_.retarget_seconds / 60.0;
+
+    // Конец окна или заметный перебор до конца окна
+    if (elapsed >= config_.retarget_seconds ||
+        static_cast<double>(window_shares_) >= std::max(4.0 * expected, 4.0)) {
+        return retarget(now, std::max(elapsed, 0.001));
+    }
+    return std::nullopt;
+}
+
+std::optional<uint32_t> VardiffController::on_tick(Clock::time_point now) noexcept {
+    double elapsed = std::chrono::duration<double>(now - window_start_).count();
+
+    // Молчащий ASIC: ждём два окна, чтобы не реагировать на случайную паузу
+    if (elapsed >= 2.0 * config_.retarget_seconds) {
+        return retarget(now, elapsed);
+    }
+    return std::nullopt;
+}
+
+uint32_t VardiffController::share_difficulty(Clock::time_point now) const noexcept {
+    if (now - changed_at_ < GRACE_PERIOD) {
+        return std::min(difficulty_, previous_difficulty_);
+    }
+    return difficulty_;
+}
+
+std::optional<uint32_t> VardiffController::reconfigure(const VardiffConfig& config, Clock::time_point now) noexcept {
+    config_ = config;
+    
+    const uint32_t clamped = std::clamp(difficulty_, config_.min_difficulty, config_.max_difficulty);
+    if (clamped == difficulty_) {
+        return std::nullopt;
+    }
+    previous_difficulty_ = difficulty_;
+    difficulty_ = clamped;
+    changed_at_ = now;
+    window_start_ = now;
+    window_shares_ = 0;
+    return difficulty_;
+}
+
+std::optional<uint32_t> VardiffController::retarget(Clock::time_point now, double elapsed_seconds) noexcept {
+    double rate = static_cast<double>(window_shares_) * 60.0 / elapsed_seconds;
+    double ratio = rate / config_.target_shares_per_minute;
+
+    window_start_ = now;
+    window_shares_ = 0;
+
+    double variance = config_.variance_percent / 100.0;
+    if (ratio >= 1.0 - variance && ratio <= 1.0 + variance) {
+        return std::nullopt;
+    }
+
+    ratio = std::clamp(ratio, 1.0 / MAX_STEP, MAX_STEP);
+    double next = std::round(static_cast<double>(difficulty_) * ratio);
+    next = std::clamp(next, static_cast<double>(config_.min_difficulty),
+                      static_cast<double>(config_.max_difficulty));
+
+    auto updated = static_cast<uint32_t>(next);
+    if (updated == difficulty_) {
+        return std::nullopt;
+    }
+
+    previous_difficulty_ = difficulty_;
+    difficulty_ = updated;
+    changed_at_ = now;
+    return difficulty_;
+}
+
+} // namespace quaxis::mining
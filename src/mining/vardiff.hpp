@@ -0,0 +1,106 @@
+/**
+ * @file vardiff.hpp
+ * @brief Переменная сложность shares для одного ASIC
+ *
+ * Глобальная partial difficulty одинакова для всех ASIC, поэтому
+ * быстрые устройства заваливают валидатор shares, а медленные почти
+ * не присылают их (и их хешрейт не виден). Контроллер измеряет частоту
+ * shares соединения и подбирает сложность так, чтобы частота была около
+ * target_shares_per_minute:
+ * - пересчёт раз в retarget_seconds, если частота вышла за variance_percent
+ * - досрочный пересчёт, если окно уже набрало в 4 раза больше ожидаемого
+ *   (новое быстрое устройство успокаивается за несколько shares)
+ * - за один пересчёт сложность меняется не больше чем в MAX_STEP раз
+ *
+ * Нагрузка на валидатор и сеть от каждого ASIC ограничена сверху
+ * независимо от размера фермы и хешрейта устройства.
+ */
+
+#pragma once
+
+#include "../core/config.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+
+namespace quaxis::mining {
+
+/**
+ * @brief Vardiff одного соединения
+ *
+ * Не thread-safe: вызывающий сериализует доступ.
+ */
+class VardiffController {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /// @brief Максимальный множитель изменения за один пересчёт
+    static constexpr double MAX_STEP = 4.0;
+
+    /// @brief Сколько после пересчёта принимаются shares по старой сложности
+    static constexpr auto GRACE_PERIOD = std::chrono::seconds(5);
+
+    /**
+     * @brief Создать контроллер
+     *
+     * @param config Настройки vardiff
+     * @param now Начало первого окна
+     */
+    explicit VardiffController(const VardiffConfig& config, Clock::time_point now = Clock::now()) noexcept;
+
+    /**
+     * @brief Учесть полученный share
+     *
+     * @param now Время получения
+     * @return std::optional<uint32_t> Новая сложность, если её нужно отправить ASIC
+     */
+    [[nodiscard]] std::optional<uint32_t> on_share(Clock::time_point now) noexcept;
+
+    /**
+     * @brief Периодическая проверка без share
+     *
+     * Снижает сложность ASIC, который перестал присылать shares.
+     *
+     * @param now Текущее время
+     * @return std::optional<uint32_t> Новая сложность или nullopt
+     */
+    [[nodiscard]] std::optional<uint32_t> on_tick(Clock::time_point now) noexcept;
+
+    /**
+     * @brief Текущая сложность
+     */
+    [[nodiscard]] uint32_t difficulty() const noexcept { return difficulty_; }
+
+    /**
+     * @brief Сложность, по которой проверять share, полученный в момент now
+     *
+     * В течение GRACE_PERIOD после повышения ASIC ещё может присылать
+     * shares по предыдущей сложности.
+     */
+    [[nodiscard]] uint32_t share_difficulty(Clock::time_point now) const noexcept;
+    
+    /**
+     * @brief Сменить настройки (перезагрузка конфигурации)
+     *
+     * Текущая сложность сохраняется, если входит в новые границы;
+     * start_difficulty действует только для новых соединений.
+     *
+     * @return std::optional<uint32_t> Сложность, приведённая к новым
+     *         границам, если её нужно отправить ASIC
+     */
+    [[nodiscard]] std::optional<uint32_t> reconfigure(const VardiffConfig& config, Clock::time_point now) noexcept;
+
+private:
+    /// @brief Пересчитать сложность по окну длиной elapsed
+    [[nodiscard]] std::optional<uint32_t> retarget(Clock::time_point now, double elapsed_seconds) noexcept;
+
+    VardiffConfig config_;
+    uint32_t difficulty_;
+    uint32_t previous_difficulty_;
+    Clock::time_point changed_at_;
+    Clock::time_point window_start_;
+    uint64_t window_shares_ = 0;
+};
+
+} // namespace quaxis::mining
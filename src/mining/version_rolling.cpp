@@ -10,6 +10,8 @@
 #include "version_rolling.hpp"
 #include "../core/byte_order.hpp"
 
+#include <algorithm>
+#include <bit>
 #include <cstring>
 
 namespace quaxis::mining {
@@ -187,10 +189,7 @@ uint16_t VersionRollingManager::next_rolling_value() noexcept {
     uint16_t current = rolling_counter_.fetch_add(1, std::memory_order_relaxed);
     
     // Обновляем статистику
-    {
-        std::lock_guard<std::mutex> lock(stats_mutex_);
-        stats_.versions_generated++;
-    }
+    versions_generated_.fetch_add(1, std::memory_order_relaxed);
     
     return current & static_cast<uint16_t>(VERSION_ROLLING_MAX);
 }
@@ -199,15 +198,47 @@ void VersionRollingManager::reset_rolling_counter() noexcept {
     rolling_counter_.store(0, std::memory_order_relaxed);
 }
 
+VersionPartition VersionRollingManager::partition(uint64_t slot, uint32_t partition_bits) const noexcept {
+    return partition_version_space(config_.version_mask, slot, partition_bits);
+}
+
 VersionRollingManager::Stats VersionRollingManager::get_stats() const noexcept {
-    std::lock_guard<std::mutex> lock(stats_mutex_);
-    return stats_;
+    Stats stats;
+    stats.versions_generated = versions_generated_.load(std::memory_order_relaxed);
+    stats.versions_validated = versions_validated_.load(std::memory_order_relaxed);
+    stats.invalid_versions = invalid_versions_.load(std::memory_order_relaxed);
+    return stats;
 }
 
 // =============================================================================
 // Вспомогательные функции
 // =============================================================================
 
+VersionPartition partition_version_space(
+    uint32_t version_mask,
+    uint64_t slot,
+    uint32_t partition_bits
+) noexcept {
+    const auto mask_bits = static_cast<uint32_t>(std::popcount(version_mask));
+    partition_bits = std::min({partition_bits, VERSION_PARTITION_MAX_BITS,
+                               mask_bits > 0 ? mask_bits - 1 : 0u});
+    
+    VersionPartition partition;
+    
+    // Старшие биты маски - от старшего к младшему, бит i слота на i-й снизу
+    uint32_t remaining = version_mask;
+    for (uint32_t i = partition_bits; i > 0; --i) {
+        const uint32_t bit = std::bit_floor(remaining);
+        remaining &= ~bit;
+        partition.fixed_mask |= bit;
+        if ((slot >> (i - 1)) & 1) {
+            partition.fixed_bits |= bit;
+        }
+    }
+    partition.mask = remaining;
+    return partition;
+}
+
 crypto::Sha256State compute_versioned_midstate(
     ByteSpan header_data,
     uint32_t version
@@ -252,4 +283,70 @@ MiningJobV2 create_job_v2(
     return job;
 }
 
+void assign_version_slots(
+    Job& job,
+    const bitcoin::BlockHeader& header,
+    std::size_t count,
+    uint32_t version_mask
+) noexcept {
+    count = std::min(count, constants::MAX_VERSION_SLOTS);
+    if (count < 2) {
+        job.version_count = 0;
+        return;
+    }
+    
+    auto serialized = header.serialize();
+    uint32_t base_rolling = (header.version & version_mask) >> 13;
+    
+    for (std::size_t i = 0; i < count; ++i) {
+        uint32_t rolling_bits = ((base_rolling + static_cast<uint32_t>(i)) << 13) & version_mask;
+        uint32_t version = (header.version & ~version_mask) | rolling_bits;
+        
+        job.versions[i] = version;
+        job.version_midstates[i] = compute_versioned_midstate(serialized, version);
+    }
+    
+    job.version_count = static_cast<uint8_t>(count);
+    job.midstate = job.version_midstates[0];
+}
+
+void assign_local_version_rolling(
+    Job& job,
+    const bitcoin::BlockHeader& header,
+    uint32_t version_mask
+) noexcept {
+    job.version_mask = version_mask;
+    job.version = header.version;
+    job.prev_block = header.prev_block;
+    job.merkle_root = header.merkle_root;
+}
+
+void assign_local_version_rolling(
+    Job& job,
+    bitcoin::BlockHeader header,
+    const VersionPartition& partition
+) noexcept {
+    const uint32_t version = partition.apply(header.version);
+    if (version != header.version) {
+        header.version = version;
+        job.midstate = header.compute_midstate();
+    }
+    assign_local_version_rolling(job, header, partition.mask);
+}
+
+std::optional<crypto::Sha256State> rolled_midstate(
+    const Job& job,
+    uint32_t version
+) noexcept {
+    if (job.version_mask == 0 || ((version ^ job.version) & ~job.version_mask) != 0) {
+        return std::nullopt;
+    }
+    
+    bitcoin::BlockHeader header;
+    header.version = version;
+    header.prev_block = job.prev_block;
+    header.merkle_root = job.merkle_root;
+    return header.compute_midstate();
+}
+
 } // namespace quaxis::mining
@@ -18,14 +18,15 @@
 
 #pragma once
 
+#include "job.hpp"
 #include "../core/types.hpp"
 #include "../core/constants.hpp"
 #include "../crypto/sha256.hpp"
+#include "../bitcoin/block.hpp"
 
 #include <cstdint>
 #include <optional>
 #include <atomic>
-#include <mutex>
 
 namespace quaxis::mining {
 
@@ -45,6 +46,10 @@ inline constexpr uint32_t VERSION_ROLLING_BITS = 16;
 /// @brief Максимальное значение version rolling
 inline constexpr uint32_t VERSION_ROLLING_MAX = (1u << VERSION_ROLLING_BITS) - 1;
 
+/// @brief Наибольшее число бит маски, закрепляемых за соединением
+inline constexpr uint32_t VERSION_PARTITION_MAX_BITS =
+    static_cast<uint32_t>(constants::MAX_VERSION_PARTITION_BITS);
+
 // =============================================================================
 // Структуры данных для Version Rolling
 // =============================================================================
@@ -63,6 +68,30 @@ struct VersionRollingConfig {
     uint32_t version_base = VERSION_BASE;
 };
 
+/**
+ * @brief Доля пространства BIP320, выделенная одному соединению
+ * 
+ * Старшие биты маски закреплены за соединением (fixed_bits), младшие
+ * соединение перебирает само (mask). Доли разных слотов не пересекаются.
+ */
+struct VersionPartition {
+    /// @brief Закреплённые биты маски
+    uint32_t fixed_mask = 0;
+    
+    /// @brief Значения закреплённых битов (номер слота)
+    uint32_t fixed_bits = 0;
+    
+    /// @brief Биты, которые перебирает соединение
+    uint32_t mask = VERSION_ROLLING_MASK_DEFAULT;
+    
+    /**
+     * @brief Версия внутри доли: закреплённые биты заменены
+     */
+    [[nodiscard]] uint32_t apply(uint32_t version) const noexcept {
+        return (version & ~fixed_mask) | fixed_bits;
+    }
+};
+
 /**
  * @brief Расширенное задание для ASIC с поддержкой version rolling (56 байт)
  * 
@@ -212,6 +241,15 @@ public:
      */
     void reset_rolling_counter() noexcept;
     
+    /**
+     * @brief Доля маски менеджера для слота соединения
+     * 
+     * Без общего счётчика: доля зависит только от слота.
+     * 
+     * @see partition_version_space
+     */
+    [[nodiscard]] VersionPartition partition(uint64_t slot, uint32_t partition_bits) const noexcept;
+    
     /**
      * @brief Получить статистику
      */
@@ -229,15 +267,35 @@ private:
     /// @brief Атомарный счётчик для version rolling
     std::atomic<uint16_t> rolling_counter_{0};
     
-    /// @brief Статистика
-    mutable std::mutex stats_mutex_;
-    Stats stats_;
+    /// @brief Статистика (атомарные счётчики: next_rolling_value без блокировок)
+    std::atomic<uint64_t> versions_generated_{0};
+    std::atomic<uint64_t> versions_validated_{0};
+    std::atomic<uint64_t> invalid_versions_{0};
 };
 
 // =============================================================================
 // Вспомогательные функции
 // =============================================================================
 
+/**
+ * @brief Разделить маску BIP320 между соединениями
+ * 
+ * partition_bits старших бит маски получают младшие биты slot; в маске
+ * доли остаются прочие биты. Соседние слоты (например, соседние
+ * extranonce) получают непересекающиеся доли, 2^partition_bits слотов
+ * подряд - все различные.
+ * 
+ * @param version_mask Маска BIP320
+ * @param slot Номер слота (берутся младшие partition_bits)
+ * @param partition_bits Закрепляемых бит (не больше VERSION_PARTITION_MAX_BITS
+ *        и на один меньше бит маски; 0 - вся маска)
+ */
+[[nodiscard]] VersionPartition partition_version_space(
+    uint32_t version_mask,
+    uint64_t slot,
+    uint32_t partition_bits
+) noexcept;
+
 /**
  * @brief Вычислить midstate с учётом версии
  * 
@@ -270,4 +328,71 @@ private:
     uint32_t version_mask
 ) noexcept;
 
+/**
+ * @brief Заполнить слоты версий задания (AsicBoost job set)
+ * 
+ * Слот i получает версию заголовка с rolling значением, сдвинутым на i
+ * (слот 0 - исходная версия), и midstate для неё. Хвост заголовка
+ * (merkle_root[28:32] + time + bits) у всех слотов общий, поэтому
+ * ASIC перебирает count × 2^32 хешей по одному заданию.
+ * 
+ * @param job Задание (midstate заменяется midstate слота 0)
+ * @param header Заголовок с merkle_root этого задания
+ * @param count Количество слотов (меньше 2 - обычное задание)
+ * @param version_mask Маска rolling битов
+ */
+void assign_version_slots(
+    Job& job,
+    const bitcoin::BlockHeader& header,
+    std::size_t count,
+    uint32_t version_mask = VERSION_ROLLING_MASK_DEFAULT
+) noexcept;
+
+/**
+ * @brief Включить в задании локальный version rolling (CMD_NEW_JOB_ROLL)
+ * 
+ * Задание получает версию, prev_block и merkle_root заголовка: контроллер
+ * ASIC сам меняет биты маски и считает midstate каждой версии, поэтому
+ * новое задание от сервера нужно только при смене блока.
+ * 
+ * @param job Задание
+ * @param header Заголовок с merkle_root этого задания
+ * @param version_mask Маска BIP320, которую перебирает ASIC
+ */
+void assign_local_version_rolling(
+    Job& job,
+    const bitcoin::BlockHeader& header,
+    uint32_t version_mask = VERSION_ROLLING_MASK_DEFAULT
+) noexcept;
+
+/**
+ * @brief Локальный version rolling в доле соединения
+ * 
+ * Версия задания получает закреплённые биты доли, ASIC перебирает
+ * только partition.mask. Если версия изменилась, midstate задания
+ * пересчитывается (share без версии проверяется по нему).
+ * 
+ * @param job Задание без слотов версий
+ * @param header Заголовок с merkle_root этого задания
+ * @param partition Доля соединения
+ */
+void assign_local_version_rolling(
+    Job& job,
+    bitcoin::BlockHeader header,
+    const VersionPartition& partition
+) noexcept;
+
+/**
+ * @brief Midstate для версии, перебранной ASIC
+ * 
+ * @param job Задание с локальным version rolling
+ * @param version Версия из share
+ * @return Midstate или nullopt, если у задания нет маски или версия
+ *         отличается от версии задания вне маски
+ */
+[[nodiscard]] std::optional<crypto::Sha256State> rolled_midstate(
+    const Job& job,
+    uint32_t version
+) noexcept;
+
 } // namespace quaxis::mining
@@ -0,0 +1,207 @@
+/**
+ * @file virtual_asic.cpp
+ * @brief Реализация программного ASIC
+ */
+
+#include "virtual_asic.hpp"
+#include "../bitcoin/target.hpp"
+#include "../core/byte_order.hpp"
+#include "../core/thread_plan.hpp"
+#include "../crypto/sha256.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <thread>
+
+namespace quaxis::mining {
+
+namespace {
+
+/// @brief Пауза потока без шаблона
+constexpr auto IDLE_SLEEP = std::chrono::milliseconds(1);
+
+/// @brief Верхняя граница пакета (буферы на стеке потока)
+constexpr std::size_t MAX_BATCH = 256;
+
+/**
+ * @brief Счётчики одного потока (пишет только он сам)
+ */
+struct alignas(64) Worker {
+    std::atomic<uint64_t> hashes{0};
+    std::atomic<uint64_t> shares{0};
+    std::atomic<uint64_t> job_switches{0};
+    std::atomic<uint64_t> exhausted{0};
+    std::atomic<uint32_t> generation{0};
+    std::atomic<int64_t> switched_at{0};  ///< steady_clock, нс от эпохи
+    std::thread thread;
+};
+
+} // anonymous namespace
+
+struct VirtualAsic::Impl {
+    JobManager& job_manager;
+    ShareValidator& validator;
+    VirtualAsicConfig config;
+    bitcoin::Target256 share_target{};
+
+    std::atomic<bool> running{false};
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    Impl(JobManager& jm, ShareValidator& v, VirtualAsicConfig cfg)
+        : job_manager(jm), validator(v), config(cfg) {
+        config.threads = std::max<std::size_t>(config.threads, 1);
+        config.batch_size = std::clamp<std::size_t>(config.batch_size, 1, MAX_BATCH);
+        share_target = config.share_difficulty > 0.0
+            ? bitcoin::difficulty_to_target(config.share_difficulty)
+            : bitcoin::Target256{};
+    }
+
+    /**
+     * @brief Поток перебора одного псевдо-соединения
+     */
+    void run(Worker& worker, uint32_t connection_id) {
+        core::enter_thread_role(core::ThreadRole::Background);
+
+        std::array<crypto::Sha256State, MAX_BATCH> midstates;
+        std::array<crypto::HeaderTail, MAX_BATCH> tails;
+        std::array<Hash256, MAX_BATCH> hashes;
+        const std::size_t batch = config.batch_size;
+
+        Job job;
+        bool have_job = false;
+        bitcoin::Target256 block_target{};
+        uint64_t next_nonce = 0;
+
+        while (running.load(std::memory_order_relaxed)) {
+            if (!have_job || job.generation != job_manager.job_generation()) {
+                auto fresh = job_manager.get_next_job_for_connection(connection_id);
+                if (!fresh) {
+                    have_job = false;
+                    std::this_thread::sleep_for(IDLE_SLEEP);
+                    continue;
+                }
+                job = *fresh;
+                have_job = true;
+                next_nonce = job.nonce;
+                block_target = bitcoin::Target256::from_hash(job.target);
+                midstates.fill(job.midstate);
+                for (auto& tail : tails) {
+                    std::memcpy(tail.data(), job.merkle_tail.data(), job.merkle_tail.size());
+                    write_le32(tail.data() + 4, job.timestamp);
+                    write_le32(tail.data() + 8, job.bits);
+                }
+                if (job.generation != worker.generation.load(std::memory_order_relaxed)) {
+                    const auto now = std::chrono::steady_clock::now().time_since_epoch();
+                    worker.switched_at.store(
+                        std::chrono::duration_cast<std::chrono::nanoseconds>(now).count(),
+                        std::memory_order_relaxed);
+                    worker.generation.store(job.generation, std::memory_order_release);
+                    worker.job_switches.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+
+            const std::size_t lanes = static_cast<std::size_t>(
+                std::min<uint64_t>(batch, (uint64_t{1} << 32) - next_nonce));
+            for (std::size_t i = 0; i < lanes; ++i) {
+                write_le32(tails[i].data() + 12, static_cast<uint32_t>(next_nonce + i));
+            }
+            crypto::hash_headers_with_midstate_batch(
+                std::span<const crypto::Sha256State>(midstates.data(), lanes),
+                std::span<const crypto::HeaderTail>(tails.data(), lanes),
+                std::span<Hash256>(hashes.data(), lanes));
+
+            // Как прошивка: отдаются nonce, дотянувшие до сложности shares;
+            // блок легче её (regtest) - каждый такой share, но не чаще
+            const bitcoin::Target256& threshold = config.share_difficulty > 0.0 ? share_target : block_target;
+            uint64_t found = 0;
+            for (std::size_t i = 0; i < lanes; ++i) {
+                if (bitcoin::meets_target(hashes[i], threshold)) {
+                    Share share;
+                    share.job_id = job.job_id;
+                    share.nonce = static_cast<uint32_t>(next_nonce + i);
+                    share.connection_id = connection_id;
+                    validator.submit(share, config.share_difficulty);
+                    ++found;
+                }
+            }
+            worker.hashes.fetch_add(lanes, std::memory_order_relaxed);
+            worker.shares.fetch_add(found, std::memory_order_relaxed);
+
+            next_nonce += lanes;
+            if (next_nonce > UINT32_MAX) {
+                // Задание того же поколения с новым job_id и timestamp шаблона
+                worker.exhausted.fetch_add(1, std::memory_order_relaxed);
+                have_job = false;
+            }
+        }
+    }
+};
+
+VirtualAsic::VirtualAsic(JobManager& job_manager, ShareValidator& validator, VirtualAsicConfig config)
+    : impl_(std::make_unique<Impl>(job_manager, validator, config)) {}
+
+VirtualAsic::~VirtualAsic() {
+    stop();
+}
+
+void VirtualAsic::start() {
+    if (impl_->running.exchange(true)) {
+        return;
+    }
+    impl_->workers.clear();
+    for (std::size_t i = 0; i < impl_->config.threads; ++i) {
+        const auto connection_id = impl_->config.connection_id_base + static_cast<uint32_t>(i);
+        (void)impl_->job_manager.register_connection(connection_id);
+        impl_->workers.push_back(std::make_unique<Worker>());
+    }
+    for (std::size_t i = 0; i < impl_->workers.size(); ++i) {
+        Worker& worker = *impl_->workers[i];
+        const auto connection_id = impl_->config.connection_id_base + static_cast<uint32_t>(i);
+        worker.thread = std::thread([this, &worker, connection_id] {
+            impl_->run(worker, connection_id);
+        });
+    }
+}
+
+void VirtualAsic::stop() {
+    if (!impl_->running.exchange(false)) {
+        return;
+    }
+    for (std::size_t i = 0; i < impl_->workers.size(); ++i) {
+        if (impl_->workers[i]->thread.joinable()) {
+            impl_->workers[i]->thread.join();
+        }
+        impl_->job_manager.unregister_connection(impl_->config.connection_id_base + static_cast<uint32_t>(i));
+    }
+}
+
+bool VirtualAsic::is_running() const noexcept {
+    return impl_->running.load(std::memory_order_relaxed);
+}
+
+VirtualAsicStats VirtualAsic::stats() const {
+    VirtualAsicStats total;
+    for (const auto& worker : impl_->workers) {
+        total.hashes += worker->hashes.load(std::memory_order_relaxed);
+        total.shares += worker->shares.load(std::memory_order_relaxed);
+        total.job_switches += worker->job_switches.load(std::memory_order_relaxed);
+        total.exhausted += worker->exhausted.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+std::vector<VirtualAsicSwitch> VirtualAsic::last_switches() const {
+    std::vector<VirtualAsicSwitch> switches;
+    switches.reserve(impl_->workers.size());
+    for (const auto& worker : impl_->workers) {
+        VirtualAsicSwitch entry;
+        entry.generation = worker->generation.load(std::memory_order_acquire);
+        entry.at = std::chrono::steady_clock::time_point(
+            std::chrono::nanoseconds(worker->switched_at.load(std::memory_order_relaxed)));
+        switches.push_back(entry);
+    }
+    return switches;
+}
+
+} // namespace quaxis::mining
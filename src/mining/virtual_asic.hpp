@@ -0,0 +1,114 @@
+/**
+ * @file virtual_asic.hpp
+ * @brief Программный ASIC для сквозных замеров на regtest/signet
+ *
+ * Перебирает nonce в N потоках и отдаёт найденные shares в
+ * ShareValidator::submit(), как сервер отдаёт shares настоящих ASIC.
+ * Каждый поток - псевдо-соединение JobManager (свой extranonce), задания
+ * берутся через get_next_job_for_connection(). Хеширование - пакетами
+ * через hash_headers_with_midstate_batch (многоканальный SHA256 или
+ * SHA-NI, выбранный при старте).
+ *
+ * Смену блока поток замечает по JobManager::job_generation() между
+ * пакетами и записывает момент переключения: по ним считаются
+ * задержка полного цикла блока и разброс переключения потоков.
+ * Найденные блоки уходят обычным путём ValidBlockCallback.
+ */
+
+#pragma once
+
+#include "job_manager.hpp"
+#include "share_validator.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace quaxis::mining {
+
+/**
+ * @brief Параметры программного ASIC
+ */
+struct VirtualAsicConfig {
+    /// @brief Потоков перебора (псевдо-соединений)
+    std::size_t threads = 1;
+
+    /// @brief ID первого псевдо-соединения (не пересекается с сервером)
+    uint32_t connection_id_base = 0xFFFF0000;
+
+    /// @brief Сложность shares: отдаются nonce, дотянувшие до неё, как у
+    /// прошивки с vardiff (0 - только блоки по target задания)
+    double share_difficulty = 1.0;
+
+    /// @brief Nonce в одном пакете хеширования
+    std::size_t batch_size = 64;
+};
+
+/**
+ * @brief Счётчики программного ASIC
+ */
+struct VirtualAsicStats {
+    uint64_t hashes = 0;        ///< Посчитано заголовков
+    uint64_t shares = 0;        ///< Отдано shares в ShareValidator
+    uint64_t job_switches = 0;  ///< Переходов на новое поколение заданий
+    uint64_t exhausted = 0;     ///< Заданий, у которых кончились nonce
+};
+
+/**
+ * @brief Последнее переключение потока на новое поколение
+ */
+struct VirtualAsicSwitch {
+    uint32_t generation = 0;
+    std::chrono::steady_clock::time_point at{};
+};
+
+/**
+ * @brief Программный ASIC: псевдо-соединения JobManager с перебором nonce
+ */
+class VirtualAsic {
+public:
+    /**
+     * @brief Создать ASIC (потоки не запускаются)
+     *
+     * @param job_manager Источник заданий (живёт дольше ASIC)
+     * @param validator Приёмник shares (пул запущен start_workers)
+     * @param config Параметры
+     */
+    VirtualAsic(JobManager& job_manager, ShareValidator& validator, VirtualAsicConfig config);
+
+    /// @brief Деструктор (останавливает потоки)
+    ~VirtualAsic();
+
+    VirtualAsic(const VirtualAsic&) = delete;
+    VirtualAsic& operator=(const VirtualAsic&) = delete;
+
+    /**
+     * @brief Зарегистрировать псевдо-соединения и запустить потоки
+     */
+    void start();
+
+    /**
+     * @brief Остановить потоки и освободить extranonce псевдо-соединений
+     */
+    void stop();
+
+    /// @brief Потоки запущены?
+    [[nodiscard]] bool is_running() const noexcept;
+
+    /// @brief Суммарные счётчики всех потоков
+    [[nodiscard]] VirtualAsicStats stats() const;
+
+    /**
+     * @brief Последние переключения потоков (по одному на поток)
+     *
+     * Поток, ещё не получивший задание, имеет generation = 0.
+     */
+    [[nodiscard]] std::vector<VirtualAsicSwitch> last_switches() const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace quaxis::mining
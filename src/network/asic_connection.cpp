@@ -4,6 +4,12 @@
  */
 
 #include "asic_connection.hpp"
+#include "send_queue.hpp"
+#include "socket_tuning.hpp"
+#include "../core/async_log.hpp"
+#include "../core/clock.hpp"
+#include "../core/stats_counter.hpp"
+#include "../core/thread_plan.hpp"
 
 #include <sys/socket.h>
 #include <netinet/in.h>
@@ -15,7 +21,12 @@
 #include <thread>
 #include <mutex>
 #include <atomic>
+#include <algorithm>
+#include <array>
 #include <cstring>
+#include <deque>
+#include <optional>
+#include <utility>
 
 namespace quaxis::network {
 
@@ -26,26 +37,105 @@ struct AsicConnection::Impl {
     std::atomic<bool> connected{false};
     std::atomic<bool> running{false};
     
+    /// @brief Сокет передаётся другому процессу: disconnected callback не вызывать
+    std::atomic<bool> detached{false};
+    
+    /// @brief Последнее задание, загруженное сразу (0 - не было)
+    std::atomic<uint32_t> current_job{0};
+    
     std::thread recv_thread;
     std::thread send_thread;
     
     mutable std::mutex send_mutex;
-    std::queue<Bytes> send_queue;
+    SendQueue send_queue;
+    
+    /// @brief Сокет занят: кадр отправляется напрямую (io_uring)
+    bool send_busy = false;
+    
+    /// @brief Ввод-вывод ведёт внешний reactor (без recv/send потоков)
+    bool external_io = false;
+    
+    /// @brief Включать TCP_QUICKACK после каждого чтения
+    bool quick_ack = false;
     
-    ProtocolParser parser;
+    FrameParser parser;
     
     ShareReceivedCallback share_callback;
     DisconnectedCallback disconnected_callback;
     StatusReceivedCallback status_callback;
+    TelemetryReceivedCallback telemetry_callback;
+    HelloReceivedCallback hello_callback;
+    JobLoadedCallback job_loaded_callback;
+
+    /**
+     * @brief Статистика стороны приёма (поток recv или reactor)
+     *
+     * Отдельная cache line от SendStats: приём и рассылка заданий идут
+     * из разных потоков и не должны делить линию.
+     */
+    struct alignas(core::CACHE_LINE_SIZE) RecvStats {
+        core::RelaxedCounter bytes_received;
+        core::RelaxedCounter shares_received;
+        core::RelaxedValue<uint32_t> last_hashrate;
+        core::RelaxedValue<uint8_t> last_temperature;
+        core::RelaxedTimePoint last_share_at;
+    };
+    
+    /**
+     * @brief Статистика стороны отправки (рассылка, поток send)
+     */
+    struct alignas(core::CACHE_LINE_SIZE) SendStats {
+        core::RelaxedCounter bytes_sent;
+        core::RelaxedCounter jobs_sent;
+        core::RelaxedCounter jobs_superseded;
+    };
     
-    mutable std::mutex stats_mutex;
-    ConnectionStats stats;
+    /**
+     * @brief Отправленные задания, ждущие RSP_JOB_LOADED, и задержки
+     * 
+     * Рассылка пишет, поток приёма сверяет: свой mutex, не send_mutex.
+     */
+    struct DispatchTrace {
+        /// @brief Сколько последних заданий помнить (подтверждение старого - без пары)
+        static constexpr std::size_t PENDING = 8;
+        
+        std::mutex mutex;
+        std::array<std::pair<uint32_t, uint64_t>, PENDING> pending{};  ///< job_id и такт отправки (0 - пусто)
+        std::size_t next = 0;
+        JobLoadLatency latency;
+    };
+    
+    RecvStats recv_stats;
+    SendStats send_stats;
+    mutable DispatchTrace dispatch;
+    const std::chrono::steady_clock::time_point connected_at;
     
     Impl(int fd, std::string addr) 
         : socket_fd(fd)
         , remote_addr(std::move(addr))
-    {
-        stats.connected_at = std::chrono::steady_clock::now();
+        , connected_at(std::chrono::steady_clock::now())
+    {}
+    
+    /**
+     * @brief Снимок статистики из счётчиков (без блокировок)
+     */
+    ConnectionStats snapshot() const noexcept {
+        ConnectionStats stats;
+        stats.shares_received = recv_stats.shares_received.load();
+        stats.jobs_sent = send_stats.jobs_sent.load();
+        stats.jobs_superseded = send_stats.jobs_superseded.load();
+        stats.bytes_received = recv_stats.bytes_received.load();
+        stats.bytes_sent = send_stats.bytes_sent.load();
+        stats.last_hashrate = recv_stats.last_hashrate.load();
+        stats.last_temperature = recv_stats.last_temperature.load();
+        stats.connected_at = connected_at;
+        stats.last_share_at = recv_stats.last_share_at.load();
+        if (auto link = read_tcp_info(socket_fd)) {
+            stats.rtt_us = link->rtt_us;
+            stats.rtt_var_us = link->rtt_var_us;
+            stats.retransmits = link->retransmits;
+        }
+        return stats;
     }
     
     ~Impl() {
@@ -100,105 +190,195 @@ struct AsicConnection::Impl {
                 }
                 
                 // Обновляем статистику
-                {
-                    std::lock_guard<std::mutex> lock(stats_mutex);
-                    stats.bytes_received += static_cast<uint64_t>(n);
+                recv_stats.bytes_received.add(static_cast<uint64_t>(n));
+                if (quick_ack) {
+                    rearm_quick_ack(socket_fd);
                 }
                 
-                // Добавляем данные в парсер
-                parser.add_data(ByteSpan(buffer.data(), static_cast<std::size_t>(n)));
-                
-                // Обрабатываем сообщения
-                while (auto msg = parser.try_parse()) {
-                    process_message(*msg);
-                }
+                // Разбираем кадры прямо в кольце парсера
+                parser.feed(
+                    ByteSpan(buffer.data(), static_cast<std::size_t>(n)),
+                    [this](const ParsedMessage& msg) { process_message(msg); }
+                );
             }
         }
         
         connected.store(false, std::memory_order_relaxed);
         
-        if (disconnected_callback) {
+        if (disconnected_callback && !detached.load(std::memory_order_relaxed)) {
             disconnected_callback();
         }
     }
     
     void send_loop() {
         while (running.load(std::memory_order_relaxed)) {
-            Bytes data;
-            
+            bool pending;
             {
+                // Сокет неблокирующий: под mutex пишем только до EAGAIN,
+                // пока ASIC не забирает данные, кадры в очереди сливаются
                 std::lock_guard<std::mutex> lock(send_mutex);
-                if (!send_queue.empty()) {
-                    data = std::move(send_queue.front());
-                    send_queue.pop();
-                }
+                flush_locked();
+                pending = !send_queue.empty();
             }
             
-            if (data.empty()) {
+            if (!pending) {
                 std::this_thread::sleep_for(std::chrono::milliseconds(1));
                 continue;
             }
             
-            // Отправляем данные
-            std::size_t sent = 0;
-            while (sent < data.size() && running.load(std::memory_order_relaxed)) {
-                ssize_t n = send(socket_fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
-                
-                if (n < 0) {
-                    if (errno == EINTR || errno == EAGAIN) continue;
-                    break;
-                }
-                
-                sent += static_cast<std::size_t>(n);
+            struct pollfd pfd;
+            pfd.fd = socket_fd;
+            pfd.events = POLLOUT;
+            (void)poll(&pfd, 1, 10);
+        }
+    }
+    
+    /**
+     * @brief Прочитать сокет до EAGAIN (режим external_io)
+     */
+    bool read_available() {
+        std::array<uint8_t, 1024> buffer;
+        
+        for (;;) {
+            ssize_t n = recv(socket_fd, buffer.data(), buffer.size(), 0);
+            
+            if (n == 0) {
+                return false;  // Соединение закрыто
+            }
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                return errno == EAGAIN || errno == EWOULDBLOCK;
             }
             
-            // Обновляем статистику
-            if (sent > 0) {
-                std::lock_guard<std::mutex> lock(stats_mutex);
-                stats.bytes_sent += sent;
+            recv_stats.bytes_received.add(static_cast<uint64_t>(n));
+            if (quick_ack) {
+                rearm_quick_ack(socket_fd);
             }
+            
+            parser.feed(
+                ByteSpan(buffer.data(), static_cast<std::size_t>(n)),
+                [this](const ParsedMessage& msg) { process_message(msg); }
+            );
         }
     }
     
+    /**
+     * @brief Досылать очередь до EAGAIN (вызывать под send_mutex)
+     * 
+     * EAGAIN: остаток дошлётся по EPOLLOUT (или следующим проходом send-потока).
+     */
+    bool flush_locked() {
+        if (send_busy || send_queue.empty()) {
+            return true;  // Идёт прямая отправка, досылка после неё
+        }
+        
+        ssize_t sent = send_queue.write_to(socket_fd);
+        if (sent < 0) {
+            // Сокет мёртв: закрытие обнаружит reactor через EPOLLHUP/EPOLLERR
+            send_queue.clear();
+            return false;
+        }
+        
+        if (sent > 0) {
+            send_stats.bytes_sent.add(static_cast<uint64_t>(sent));
+        }
+        return true;
+    }
+    
     void process_message(const ParsedMessage& msg) {
         std::visit([this](auto&& m) {
             using T = std::decay_t<decltype(m)>;
             
             if constexpr (std::is_same_v<T, ShareMessage>) {
-                {
-                    std::lock_guard<std::mutex> lock(stats_mutex);
-                    stats.shares_received++;
-                    stats.last_share_at = std::chrono::steady_clock::now();
-                }
+                recv_stats.shares_received.add();
+                recv_stats.last_share_at.store(core::CoarseClock::now());
                 
                 if (share_callback) {
                     share_callback(m.share);
                 }
             }
             else if constexpr (std::is_same_v<T, StatusMessage>) {
-                {
-                    std::lock_guard<std::mutex> lock(stats_mutex);
-                    stats.last_hashrate = m.hashrate;
-                    stats.last_temperature = m.temperature;
-                }
+                recv_stats.last_hashrate.store(m.hashrate);
+                recv_stats.last_temperature.store(m.temperature);
                 
                 if (status_callback) {
                     status_callback(m);
                 }
             }
+            else if constexpr (std::is_same_v<T, TelemetryMessage>) {
+                if (telemetry_callback) {
+                    telemetry_callback(m.payload);
+                }
+            }
+            else if constexpr (std::is_same_v<T, HelloMessage>) {
+                if (hello_callback) {
+                    hello_callback(m);
+                }
+            }
+            else if constexpr (std::is_same_v<T, JobLoadedMessage>) {
+                on_job_loaded(m);
+            }
             else if constexpr (std::is_same_v<T, ErrorMessage>) {
                 // Логируем ошибку
             }
         }, msg);
     }
     
+    /**
+     * @brief Запомнить момент отправки задания, которое ASIC загрузит сразу
+     */
+    void note_job_sent(std::optional<uint32_t> job_id) {
+        if (!job_id) {
+            return;
+        }
+        current_job.store(*job_id, std::memory_order_relaxed);
+        const uint64_t now = core::TscClock::ticks();
+        std::lock_guard<std::mutex> lock(dispatch.mutex);
+        dispatch.pending[dispatch.next++ % DispatchTrace::PENDING] = {*job_id, now};
+    }
+    
+    /**
+     * @brief RSP_JOB_LOADED: задержка от отправки и время загрузки на контроллере
+     */
+    void on_job_loaded(const JobLoadedMessage& msg) {
+        const uint64_t now = core::TscClock::ticks();
+        std::optional<std::chrono::nanoseconds> since_sent;
+        {
+            std::lock_guard<std::mutex> lock(dispatch.mutex);
+            dispatch.latency.load.record(uint64_t{msg.load_us()} * 1000);
+            for (auto& [job_id, sent_at] : dispatch.pending) {
+                if (sent_at != 0 && job_id == msg.job_id) {
+                    const uint64_t dispatch_ns = core::TscClock::to_ns(now - sent_at);
+                    dispatch.latency.dispatch.record(dispatch_ns);
+                    since_sent = std::chrono::nanoseconds(dispatch_ns);
+                    sent_at = 0;
+                    break;
+                }
+            }
+        }
+        if (job_loaded_callback) {
+            job_loaded_callback(msg, since_sent);
+        }
+    }
+    
     bool enqueue_send(Bytes data) {
         if (!connected.load(std::memory_order_relaxed)) {
             return false;
         }
         
         std::lock_guard<std::mutex> lock(send_mutex);
-        send_queue.push(std::move(data));
+        const uint64_t superseded = send_queue.superseded_jobs();
+        if (!send_queue.push(std::move(data))) {
+            return false;  // ASIC не забирает данные: очередь заполнена
+        }
+        if (send_queue.superseded_jobs() != superseded) {
+            send_stats.jobs_superseded.add(send_queue.superseded_jobs() - superseded);
+        }
+        
+        // Без send-потока пишем сразу: задание уходит из вызывающего потока
+        if (external_io) {
+            flush_locked();
+        }
         return true;
     }
 };
@@ -207,12 +387,14 @@ struct AsicConnection::Impl {
 // AsicConnection
 // =============================================================================
 
-AsicConnection::AsicConnection(int socket_fd, std::string remote_addr)
+AsicConnection::AsicConnection(int socket_fd, std::string remote_addr, const AsicSocketConfig& socket)
     : impl_(std::make_unique<Impl>(socket_fd, std::move(remote_addr)))
 {
-    // Настраиваем сокет
-    int flag = 1;
-    setsockopt(socket_fd, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
+    // Настраиваем сокет: ошибка опции не мешает работе соединения
+    if (auto tuned = apply_socket_tuning(socket_fd, socket); !tuned) {
+        QUAXIS_LOG_RATE(Warning, 1, "[AsicConnection] {}: {}", impl_->remote_addr, tuned.error().message);
+    }
+    impl_->quick_ack = socket.quick_ack;
     
     // Устанавливаем non-blocking
     int flags = fcntl(socket_fd, F_GETFL, 0);
@@ -228,30 +410,177 @@ AsicConnection& AsicConnection::operator=(AsicConnection&&) noexcept = default;
 
 void AsicConnection::start() {
     impl_->running.store(true, std::memory_order_relaxed);
-    impl_->recv_thread = std::thread([this] { impl_->recv_loop(); });
-    impl_->send_thread = std::thread([this] { impl_->send_loop(); });
+    impl_->recv_thread = std::thread([this] {
+        core::enter_thread_role(core::ThreadRole::Fanout);
+        impl_->recv_loop();
+    });
+    impl_->send_thread = std::thread([this] {
+        core::enter_thread_role(core::ThreadRole::Fanout);
+        impl_->send_loop();
+    });
 }
 
 void AsicConnection::stop() {
     impl_->stop();
 }
 
+DetachedSocket AsicConnection::detach() {
+    impl_->detached.store(true, std::memory_order_relaxed);
+    impl_->running.store(false, std::memory_order_relaxed);
+    
+    // Потоки выходят по таймауту poll; сокет не закрывается
+    if (impl_->recv_thread.joinable()) {
+        impl_->recv_thread.join();
+    }
+    if (impl_->send_thread.joinable()) {
+        impl_->send_thread.join();
+    }
+    impl_->connected.store(false, std::memory_order_relaxed);
+    
+    DetachedSocket socket;
+    socket.fd = impl_->socket_fd;
+    socket.unparsed = impl_->parser.take_buffered();
+    {
+        std::lock_guard<std::mutex> lock(impl_->send_mutex);
+        socket.unsent = impl_->send_queue.take_pending();
+    }
+    impl_->socket_fd = -1;
+    return socket;
+}
+
+void AsicConnection::restore_io(ByteSpan unparsed, ByteSpan unsent) {
+    (void)impl_->parser.add_data(unparsed);
+    if (!unsent.empty()) {
+        std::lock_guard<std::mutex> lock(impl_->send_mutex);
+        impl_->send_queue.push_front_partial(Bytes(unsent.begin(), unsent.end()));
+    }
+}
+
 bool AsicConnection::is_connected() const noexcept {
     return impl_->connected.load(std::memory_order_relaxed);
 }
 
+void AsicConnection::abort() noexcept {
+    if (impl_->socket_fd >= 0) {
+        shutdown(impl_->socket_fd, SHUT_RDWR);
+    }
+}
+
+void AsicConnection::start_external_io() {
+    impl_->external_io = true;
+    impl_->running.store(true, std::memory_order_relaxed);
+}
+
+int AsicConnection::socket_fd() const noexcept {
+    return impl_->socket_fd;
+}
+
+bool AsicConnection::on_readable() {
+    return impl_->read_available();
+}
+
+bool AsicConnection::on_writable() {
+    std::lock_guard<std::mutex> lock(impl_->send_mutex);
+    return impl_->flush_locked();
+}
+
+void AsicConnection::on_closed() {
+    impl_->running.store(false, std::memory_order_relaxed);
+    
+    if (impl_->disconnected_callback) {
+        impl_->disconnected_callback();
+    }
+    
+    // Последним: после этого сервер может удалить соединение
+    impl_->connected.store(false, std::memory_order_release);
+}
+
 bool AsicConnection::send_job(const mining::Job& job) {
     auto data = serialize_new_job(job);
+    const auto job_id = job_frame_id(data);
+    bool result = impl_->enqueue_send(std::move(data));
+    
+    if (result) {
+        impl_->send_stats.jobs_sent.add();
+        impl_->note_job_sent(job_id);
+    }
+    
+    return result;
+}
+
+bool AsicConnection::send_job_message(const std::array<uint8_t, constants::JOB_MESSAGE_SIZE>& message) {
+    Bytes data(NEW_JOB_FRAME_SIZE);
+    encode_new_job(message, std::span<uint8_t, NEW_JOB_FRAME_SIZE>(data.data(), NEW_JOB_FRAME_SIZE));
+    const auto job_id = job_frame_id(data);
+    
+    bool result = impl_->enqueue_send(std::move(data));
+    
+    if (result) {
+        impl_->send_stats.jobs_sent.add();
+        impl_->note_job_sent(job_id);
+    }
+    
+    return result;
+}
+
+bool AsicConnection::send_queued_jobs(std::span<const mining::Job> jobs) {
+    if (jobs.empty()) {
+        return true;
+    }
+    
+    Bytes data(jobs.size() * NEW_JOB_FRAME_SIZE);
+    for (std::size_t i = 0; i < jobs.size(); ++i) {
+        NewJobMessage msg{jobs[i]};
+        msg.encode_queued(std::span<uint8_t, NEW_JOB_FRAME_SIZE>(
+            data.data() + i * NEW_JOB_FRAME_SIZE, NEW_JOB_FRAME_SIZE));
+    }
+    
     bool result = impl_->enqueue_send(std::move(data));
     
     if (result) {
-        std::lock_guard<std::mutex> lock(impl_->stats_mutex);
-        impl_->stats.jobs_sent++;
+        impl_->send_stats.jobs_sent.add(jobs.size());
     }
     
     return result;
 }
 
+int AsicConnection::begin_direct_job_send() {
+    std::lock_guard<std::mutex> lock(impl_->send_mutex);
+    
+    if (!impl_->connected.load(std::memory_order_relaxed) ||
+        impl_->send_busy || !impl_->send_queue.empty()) {
+        return -1;
+    }
+    
+    impl_->send_busy = true;
+    return impl_->socket_fd;
+}
+
+bool AsicConnection::end_direct_job_send(ByteSpan frame, int written) {
+    std::size_t done = written > 0 ? static_cast<std::size_t>(written) : 0;
+    done = std::min(done, frame.size());
+    
+    {
+        std::lock_guard<std::mutex> lock(impl_->send_mutex);
+        impl_->send_busy = false;
+        
+        // Недоотправленный остаток идёт первым: за ним могли встать новые кадры
+        if (done < frame.size()) {
+            impl_->send_queue.push_front_partial(Bytes(frame.begin() + static_cast<std::ptrdiff_t>(done), frame.end()));
+        }
+        
+        if (impl_->external_io) {
+            impl_->flush_locked();
+        }
+    }
+    
+    impl_->send_stats.bytes_sent.add(done);
+    impl_->send_stats.jobs_sent.add();
+    impl_->note_job_sent(job_frame_id(frame));
+    
+    return done == frame.size();
+}
+
 bool AsicConnection::send_stop() {
     return impl_->enqueue_send(serialize_stop());
 }
@@ -264,6 +593,22 @@ bool AsicConnection::send_target(const Hash256& target) {
     return impl_->enqueue_send(serialize_set_target(target));
 }
 
+bool AsicConnection::send_difficulty(uint32_t difficulty) {
+    return impl_->enqueue_send(serialize_set_difficulty(difficulty));
+}
+
+bool AsicConnection::send_time_update(uint32_t job_id, uint32_t timestamp, std::optional<uint32_t> nonce_start) {
+    return impl_->enqueue_send(serialize_update_time(job_id, timestamp, nonce_start));
+}
+
+bool AsicConnection::send_share_batch_config(uint8_t max_count, uint16_t flush_ms) {
+    return impl_->enqueue_send(serialize_set_share_batch(max_count, flush_ms));
+}
+
+bool AsicConnection::send_session(uint64_t token) {
+    return impl_->enqueue_send(serialize_set_session(token));
+}
+
 void AsicConnection::set_share_callback(ShareReceivedCallback callback) {
     impl_->share_callback = std::move(callback);
 }
@@ -276,13 +621,37 @@ void AsicConnection::set_status_callback(StatusReceivedCallback callback) {
     impl_->status_callback = std::move(callback);
 }
 
+void AsicConnection::set_telemetry_callback(TelemetryReceivedCallback callback) {
+    impl_->telemetry_callback = std::move(callback);
+}
+
+void AsicConnection::set_hello_callback(HelloReceivedCallback callback) {
+    impl_->hello_callback = std::move(callback);
+}
+
+void AsicConnection::set_job_loaded_callback(JobLoadedCallback callback) {
+    impl_->job_loaded_callback = std::move(callback);
+}
+
 const std::string& AsicConnection::remote_address() const noexcept {
     return impl_->remote_addr;
 }
 
 ConnectionStats AsicConnection::stats() const {
-    std::lock_guard<std::mutex> lock(impl_->stats_mutex);
-    return impl_->stats;
+    return impl_->snapshot();
+}
+
+uint64_t AsicConnection::bytes_received() const noexcept {
+    return impl_->recv_stats.bytes_received.load();
+}
+
+uint32_t AsicConnection::current_job_id() const noexcept {
+    return impl_->current_job.load(std::memory_order_relaxed);
+}
+
+JobLoadLatency AsicConnection::job_load_latency() const {
+    std::lock_guard<std::mutex> lock(impl_->dispatch.mutex);
+    return impl_->dispatch.latency;
 }
 
 std::size_t AsicConnection::pending_jobs() const {
@@ -14,9 +14,12 @@
 #include "protocol.hpp"
 #include "../mining/job.hpp"
 #include "../core/config.hpp"
+#include "../core/latency_trace.hpp"
 
+#include <chrono>
 #include <memory>
 #include <functional>
+#include <optional>
 #include <string>
 #include <queue>
 
@@ -41,6 +44,25 @@ using DisconnectedCallback = std::function<void()>;
  */
 using StatusReceivedCallback = std::function<void(const StatusMessage& status)>;
 
+/**
+ * @brief Callback при получении кадра телеметрии (payload RSP_TELEMETRY)
+ */
+using TelemetryReceivedCallback = std::function<void(ByteSpan payload)>;
+
+/**
+ * @brief Callback при получении RSP_HELLO (токен прежней сессии)
+ */
+using HelloReceivedCallback = std::function<void(const HelloMessage& hello)>;
+
+/**
+ * @brief Callback при получении RSP_JOB_LOADED
+ * 
+ * @param since_sent Время от отправки задания (nullopt - задание не из
+ *                   последних отправленных)
+ */
+using JobLoadedCallback = std::function<void(const JobLoadedMessage& msg,
+                                             std::optional<std::chrono::nanoseconds> since_sent)>;
+
 // =============================================================================
 // Статистика соединения
 // =============================================================================
@@ -51,12 +73,45 @@ using StatusReceivedCallback = std::function<void(const StatusMessage& status)>;
 struct ConnectionStats {
     uint64_t shares_received = 0;     ///< Количество полученных shares
     uint64_t jobs_sent = 0;           ///< Количество отправленных заданий
+    uint64_t jobs_superseded = 0;     ///< Задания, вытесненные новыми до отправки
     uint64_t bytes_received = 0;      ///< Байт получено
     uint64_t bytes_sent = 0;          ///< Байт отправлено
     uint32_t last_hashrate = 0;       ///< Последний известный хешрейт
     uint8_t last_temperature = 0;     ///< Последняя температура
     std::chrono::steady_clock::time_point connected_at;  ///< Время подключения
     std::chrono::steady_clock::time_point last_share_at; ///< Время последнего share
+    uint32_t rtt_us = 0;              ///< Сглаженный RTT (TCP_INFO)
+    uint32_t rtt_var_us = 0;          ///< Разброс RTT (TCP_INFO)
+    uint32_t retransmits = 0;         ///< Ретрансмиссий за соединение (TCP_INFO)
+};
+
+/**
+ * @brief Задержки перехода ASIC на новое задание (RSP_JOB_LOADED)
+ * 
+ * dispatch - по часам сервера от отправки кадра задания до прихода
+ * подтверждения: сеть туда и обратно плюс загрузка. load - по часам
+ * контроллера от приёма кадра до старта чипов. Разница показывает,
+ * медленна линия или прошивка.
+ */
+struct JobLoadLatency {
+    core::LatencyHistogram dispatch;  ///< Отправка задания -> RSP_JOB_LOADED (нс)
+    core::LatencyHistogram load;      ///< Приём кадра -> старт чипов на контроллере (нс)
+};
+
+// =============================================================================
+// Передача соединения другому процессу
+// =============================================================================
+
+/**
+ * @brief Сокет соединения с незавершённым вводом-выводом
+ * 
+ * Результат AsicConnection::detach(): сокет открыт, ASIC не замечает
+ * смены процесса, если новый процесс продолжит поток байт с того же места.
+ */
+struct DetachedSocket {
+    int fd = -1;     ///< Сокет (владение у вызывающего)
+    Bytes unparsed;  ///< Принятые, но не разобранные байты (неполный кадр)
+    Bytes unsent;    ///< Неотправленные байты очереди (с остатком начатого кадра)
 };
 
 // =============================================================================
@@ -73,8 +128,9 @@ public:
      * 
      * @param socket_fd Файловый дескриптор сокета
      * @param remote_addr Адрес удалённой стороны
+     * @param socket Профиль сокета (по умолчанию - только TCP_NODELAY)
      */
-    AsicConnection(int socket_fd, std::string remote_addr);
+    AsicConnection(int socket_fd, std::string remote_addr, const AsicSocketConfig& socket = {});
     
     ~AsicConnection();
     
@@ -100,11 +156,77 @@ public:
      */
     void stop();
     
+    /**
+     * @brief Отсоединить сокет, не закрывая его (передача новому процессу)
+     * 
+     * Останавливает потоки соединения (reactor должен быть уже
+     * остановлен), disconnected callback не вызывается. Соединение
+     * больше не владеет сокетом.
+     * 
+     * @return DetachedSocket Сокет и незавершённый ввод-вывод
+     */
+    [[nodiscard]] DetachedSocket detach();
+    
+    /**
+     * @brief Продолжить ввод-вывод отсоединённого сокета (до start())
+     * 
+     * @param unparsed Байты для парсера (DetachedSocket::unparsed)
+     * @param unsent Байты, уходящие в сокет первыми (DetachedSocket::unsent)
+     */
+    void restore_io(ByteSpan unparsed, ByteSpan unsent);
+    
     /**
      * @brief Проверить, активно ли соединение
      */
     [[nodiscard]] bool is_connected() const noexcept;
     
+    /**
+     * @brief Разорвать соединение из любого потока (shutdown сокета)
+     * 
+     * Закрытие обнаружит поток приёма или reactor и вызовет disconnected
+     * callback обычным путём.
+     */
+    void abort() noexcept;
+    
+    // =========================================================================
+    // Внешний цикл событий (EpollReactor)
+    // =========================================================================
+    
+    /**
+     * @brief Запустить соединение без собственных потоков
+     * 
+     * Приём и досылка выполняются внешним reactor через on_readable() /
+     * on_writable(); send_* пишут в сокет сразу из вызывающего потока.
+     * Callbacks вызываются так же, как в потоковом режиме.
+     */
+    void start_external_io();
+    
+    /**
+     * @brief Файловый дескриптор сокета
+     */
+    [[nodiscard]] int socket_fd() const noexcept;
+    
+    /**
+     * @brief Прочитать всё доступное (edge-triggered: до EAGAIN)
+     * 
+     * @return false если соединение закрыто удалённой стороной или ошибка
+     */
+    bool on_readable();
+    
+    /**
+     * @brief Досылать очередь отправки до EAGAIN
+     * 
+     * @return false при фатальной ошибке сокета
+     */
+    bool on_writable();
+    
+    /**
+     * @brief Соединение снято с reactor: вызвать disconnected callback
+     * 
+     * После вызова reactor больше не обращается к соединению.
+     */
+    void on_closed();
+    
     // =========================================================================
     // Отправка данных
     // =========================================================================
@@ -117,6 +239,49 @@ public:
      */
     bool send_job(const mining::Job& job);
     
+    /**
+     * @brief Отправить уже сериализованное задание
+     * 
+     * Без повторной сериализации: 48 байт копируются в кадр как есть.
+     * 
+     * @param message Задание в формате Job::serialize()
+     * @return true если успешно добавлено в очередь
+     */
+    bool send_job_message(const std::array<uint8_t, constants::JOB_MESSAGE_SIZE>& message);
+    
+    /**
+     * @brief Отправить задания в очередь ASIC (кадры QueueJob)
+     * 
+     * Все кадры уходят одним буфером, после текущего задания.
+     * 
+     * @param jobs Задания в порядке исполнения
+     * @return true если успешно добавлено в очередь
+     */
+    bool send_queued_jobs(std::span<const mining::Job> jobs);
+    
+    /**
+     * @brief Захватить сокет для прямой отправки кадра задания
+     * 
+     * Используется пакетной рассылкой (io_uring): кадр пишется в сокет
+     * минуя очередь. Удаётся, только если очередь пуста и сокет не занят,
+     * иначе порядок кадров нарушился бы. До end_direct_job_send() очередь
+     * не отправляется.
+     * 
+     * @return int Дескриптор сокета или -1 (использовать send_job)
+     */
+    [[nodiscard]] int begin_direct_job_send();
+    
+    /**
+     * @brief Завершить прямую отправку
+     * 
+     * Неотправленный остаток кадра ставится в начало очереди.
+     * 
+     * @param frame Кадр (команда + задание)
+     * @param written Результат записи: байт отправлено или -errno
+     * @return true если кадр отправлен целиком
+     */
+    bool end_direct_job_send(ByteSpan frame, int written);
+    
     /**
      * @brief Отправить команду остановки
      */
@@ -132,6 +297,40 @@ public:
      */
     bool send_target(const Hash256& target);
     
+    /**
+     * @brief Отправить сложность shares (vardiff)
+     */
+    bool send_difficulty(uint32_t difficulty);
+    
+    /**
+     * @brief Сдвинуть timestamp задания, которое ASIC уже перебирает
+     * 
+     * Midstate не меняется: ASIC обновляет хвост заголовка и начинает
+     * перебор nonce заново (см. JobManager::update_job_time).
+     * 
+     * @param job_id ID задания
+     * @param timestamp Новый timestamp
+     * @param nonce_start Начальный nonce (nullopt - прежний)
+     */
+    bool send_time_update(uint32_t job_id, uint32_t timestamp, std::optional<uint32_t> nonce_start = std::nullopt);
+    
+    /**
+     * @brief Предложить прошивке пакетные shares (RSP_SHARE_BATCH)
+     * 
+     * Прошивка без поддержки пропускает команду и шлёт RSP_SHARE.
+     * 
+     * @param max_count Shares в одном пакете
+     * @param flush_ms Максимальная задержка неполного пакета
+     */
+    bool send_share_batch_config(uint8_t max_count, uint16_t flush_ms);
+    
+    /**
+     * @brief Выдать прошивке токен сессии (CMD_SET_SESSION)
+     * 
+     * Прошивка без поддержки пропускает команду.
+     */
+    bool send_session(uint64_t token);
+    
     // =========================================================================
     // Callbacks
     // =========================================================================
@@ -139,6 +338,9 @@ public:
     void set_share_callback(ShareReceivedCallback callback);
     void set_disconnected_callback(DisconnectedCallback callback);
     void set_status_callback(StatusReceivedCallback callback);
+    void set_telemetry_callback(TelemetryReceivedCallback callback);
+    void set_hello_callback(HelloReceivedCallback callback);
+    void set_job_loaded_callback(JobLoadedCallback callback);
     
     // =========================================================================
     // Информация
@@ -155,7 +357,27 @@ public:
     [[nodiscard]] ConnectionStats stats() const;
     
     /**
-     * @brief Получить количество заданий в очереди
+     * @brief Байт принято за время соединения (без снимка статистики)
+     */
+    [[nodiscard]] uint64_t bytes_received() const noexcept;
+    
+    /**
+     * @brief ID последнего задания, которое ASIC загрузил сразу (0 - не было)
+     * 
+     * Задания очереди (send_queued_jobs) не учитываются.
+     */
+    [[nodiscard]] uint32_t current_job_id() const noexcept;
+
+    /**
+     * @brief Задержки загрузки заданий (пусто, если прошивка не шлёт RSP_JOB_LOADED)
+     */
+    [[nodiscard]] JobLoadLatency job_load_latency() const;
+    
+    /**
+     * @brief Получить количество кадров в очереди отправки
+     * 
+     * Очередь ограничена SendQueue::DEFAULT_CAPACITY: новое задание
+     * вытесняет неотправленные прежние (см. send_queue.hpp).
      */
     [[nodiscard]] std::size_t pending_jobs() const;
     
@@ -0,0 +1,94 @@
+/**
+ * @file block_multicast.cpp
+ * @brief Реализация multicast-уведомления о новом блоке
+ */
+
+#include "block_multicast.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <string>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace quaxis::network {
+
+BlockMulticast::BlockMulticast(const MulticastConfig& config)
+    : config_(config) {}
+
+BlockMulticast::~BlockMulticast() {
+    close();
+}
+
+Result<void> BlockMulticast::open() {
+    struct in_addr group{};
+    if (inet_pton(AF_INET, config_.group.c_str(), &group) != 1 || !IN_MULTICAST(ntohl(group.s_addr))) {
+        return Err<void>(ErrorCode::ConfigInvalidValue,
+                         "server.multicast.group не multicast адрес IPv4: " + config_.group);
+    }
+    
+    struct in_addr interface{};
+    interface.s_addr = htonl(INADDR_ANY);
+    if (!config_.interface.empty() && inet_pton(AF_INET, config_.interface.c_str(), &interface) != 1) {
+        return Err<void>(ErrorCode::ConfigInvalidValue,
+                         "Некорректный server.multicast.interface: " + config_.interface);
+    }
+    
+    int fd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return Err<void>(ErrorCode::NetworkConnectionFailed,
+                         std::string("Не удалось создать multicast сокет: ") + strerror(errno));
+    }
+    
+    auto ttl = static_cast<unsigned char>(config_.ttl);
+    if (setsockopt(fd, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl)) < 0 ||
+        (!config_.interface.empty() &&
+         setsockopt(fd, IPPROTO_IP, IP_MULTICAST_IF, &interface, sizeof(interface)) < 0)) {
+        std::string reason = strerror(errno);
+        ::close(fd);
+        return Err<void>(ErrorCode::NetworkConnectionFailed, "Не удалось настроить multicast сокет: " + reason);
+    }
+    
+    close();
+    fd_ = fd;
+    group_address_ = group.s_addr;
+    return {};
+}
+
+void BlockMulticast::close() noexcept {
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+bool BlockMulticast::announce(const BlockNotifyMessage& message) {
+    if (fd_ < 0) {
+        return false;
+    }
+    
+    // Одно уведомление на поколение: повторные broadcast_job_set шаблона молчат
+    const uint64_t key = static_cast<uint64_t>(message.generation) + 1;
+    if (last_generation_.exchange(key, std::memory_order_relaxed) == key) {
+        return false;
+    }
+    
+    struct sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(config_.port);
+    addr.sin_addr.s_addr = group_address_;
+    
+    Bytes datagram = message.serialize();
+    ssize_t n = sendto(fd_, datagram.data(), datagram.size(), MSG_DONTWAIT | MSG_NOSIGNAL,
+                       reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr));
+    if (n != static_cast<ssize_t>(datagram.size())) {
+        return false;  // Задания всё равно уйдут по TCP
+    }
+    sent_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+} // namespace quaxis::network
@@ -0,0 +1,78 @@
+/**
+ * @file block_multicast.hpp
+ * @brief Multicast-уведомление ASIC о новом блоке
+ *
+ * Даже с epoll задание нового блока уходит каждому ASIC по его TCP
+ * соединению, одно за другим: последний ASIC парка переключается на
+ * O(N) отправок позже первого. Одна UDP датаграмма CMD_BLOCK_NOTIFY на
+ * multicast группу доходит до всей сети ASIC разом, до рассылки по TCP.
+ * Прошивка бросает работу прежнего блока и, если работает с арендой
+ * extranonce, строит задание нового блока сама; задание по TCP
+ * подтверждает его и даёт shares job_id.
+ *
+ * Датаграмма не подписана: прошивка принимает её только с адреса своего
+ * сервера, а работа по ней без подтверждения по TCP не засчитывается.
+ *
+ * Thread-safe: announce() вызывается из потока, рассылающего задания.
+ */
+
+#pragma once
+
+#include "../core/types.hpp"
+#include "../core/config.hpp"
+#include "protocol.hpp"
+
+#include <atomic>
+#include <cstdint>
+
+namespace quaxis::network {
+
+/**
+ * @brief Отправитель CMD_BLOCK_NOTIFY на multicast группу
+ */
+class BlockMulticast {
+public:
+    explicit BlockMulticast(const MulticastConfig& config);
+    ~BlockMulticast();
+    
+    BlockMulticast(const BlockMulticast&) = delete;
+    BlockMulticast& operator=(const BlockMulticast&) = delete;
+    
+    /**
+     * @brief Открыть UDP сокет группы (TTL, интерфейс)
+     * 
+     * @return Result<void> Ошибка, если адрес группы не multicast IPv4
+     *         или интерфейс задан неверно
+     */
+    [[nodiscard]] Result<void> open();
+    
+    /**
+     * @brief Закрыть сокет
+     */
+    void close() noexcept;
+    
+    /**
+     * @brief Разослать уведомление, если его поколение ещё не объявлено
+     * 
+     * Повторная рассылка заданий того же шаблона датаграмму не шлёт.
+     * 
+     * @return true если датаграмма отправлена
+     */
+    bool announce(const BlockNotifyMessage& message);
+    
+    [[nodiscard]] bool is_open() const noexcept { return fd_ >= 0; }
+    
+    /**
+     * @brief Отправленных уведомлений
+     */
+    [[nodiscard]] uint64_t sent() const noexcept { return sent_.load(std::memory_order_relaxed); }
+    
+private:
+    MulticastConfig config_;
+    int fd_ = -1;
+    uint32_t group_address_ = 0;  ///< Адрес группы (network byte order)
+    std::atomic<uint64_t> sent_{0};
+    std::atomic<uint64_t> last_generation_{0};  ///< generation + 1 последнего уведомления
+};
+
+} // namespace quaxis::network
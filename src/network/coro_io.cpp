@@ -0,0 +1,691 @@
+/**
+ * @file coro_io.cpp
+ * @brief Реализация IoLoop и AsyncSocket
+ */
+
+#include "coro_io.hpp"
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+
+#include <array>
+#include <atomic>
+#include <coroutine>
+#include <deque>
+#include <format>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace quaxis::network {
+
+namespace detail {
+
+/// @brief Чем закончилось ожидание
+enum class WaitResult {
+    Ready,      ///< Сокет готов или срок сна истёк
+    TimedOut,   ///< Таймаут операции
+    Cancelled   ///< Сокет закрыт или loop остановлен
+};
+
+/**
+ * @brief Приостановленная корутина: сокет, таймер или оба
+ */
+struct IoWaiter {
+    std::coroutine_handle<> handle;
+    IoWaiter** slot = nullptr;          ///< reader/writer сокета
+    IoLoop::Clock::time_point deadline;
+    uint64_t timer_seq = 0;             ///< 0 - без таймера
+    bool timeout_is_ready = false;      ///< Сон: срок - это Ready
+    WaitResult result = WaitResult::Ready;
+};
+
+/**
+ * @brief Сокет в epoll: data.ptr указывает сюда
+ */
+struct IoHandle {
+    int fd = -1;
+    IoWaiter* reader = nullptr;
+    IoWaiter* writer = nullptr;
+};
+
+} // namespace detail
+
+using detail::IoHandle;
+using detail::IoWaiter;
+using detail::WaitResult;
+
+namespace {
+
+thread_local const void* t_loop = nullptr;
+
+/**
+ * @brief Корневая корутина spawn(): кадр освобождается сам по завершении
+ */
+struct DetachedTask {
+    struct promise_type {
+        DetachedTask get_return_object() noexcept {
+            return {std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+        std::suspend_always initial_suspend() const noexcept { return {}; }
+        std::suspend_never final_suspend() const noexcept { return {}; }
+        void return_void() const noexcept {}
+        void unhandled_exception() const noexcept { std::terminate(); }
+    };
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+} // anonymous namespace
+
+struct IoLoop::Impl {
+    int epoll_fd = -1;
+    int wake_fd = -1;
+
+    std::atomic<bool> running{false};
+    std::atomic<bool> stopping{false};
+    std::atomic<std::size_t> active{0};
+    std::thread thread;
+
+    // Из других потоков: под queue_mutex, пробуждение через eventfd
+    std::mutex queue_mutex;
+    std::vector<std::function<void()>> posted;
+
+    // Только поток loop
+    std::deque<std::coroutine_handle<>> ready;
+    std::map<std::pair<Clock::time_point, uint64_t>, IoWaiter*> timers;
+    uint64_t next_timer_seq = 1;
+    std::unordered_set<IoHandle*> handles;
+    bool cancelled_all = false;
+
+    ~Impl() {
+        stop();
+        for (auto* handle : handles) {
+            ::close(handle->fd);
+            delete handle;
+        }
+    }
+
+    // =========================================================================
+    // Запуск и остановка
+    // =========================================================================
+
+    Result<void> start() {
+        if (running.load(std::memory_order_relaxed)) {
+            return {};
+        }
+
+        epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        if (epoll_fd < 0) {
+            return Err<void>(
+                ErrorCode::NetworkConnectionFailed,
+                std::format("Не удалось создать epoll: {}", strerror(errno))
+            );
+        }
+
+        wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (wake_fd < 0) {
+            close_fds();
+            return Err<void>(
+                ErrorCode::NetworkConnectionFailed,
+                std::format("Не удалось создать eventfd: {}", strerror(errno))
+            );
+        }
+
+        // data.ptr == nullptr отличает eventfd от сокетов
+        struct epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.ptr = nullptr;
+        if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wake_fd, &ev) < 0) {
+            close_fds();
+            return Err<void>(
+                ErrorCode::NetworkConnectionFailed,
+                std::format("Не удалось зарегистрировать eventfd: {}", strerror(errno))
+            );
+        }
+
+        stopping.store(false, std::memory_order_relaxed);
+        cancelled_all = false;
+        running.store(true, std::memory_order_relaxed);
+        thread = std::thread([this] { loop(); });
+        return {};
+    }
+
+    void stop() {
+        if (!running.load(std::memory_order_relaxed)) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            stopping.store(true, std::memory_order_relaxed);
+        }
+        wake();
+
+        if (thread.joinable()) {
+            thread.join();
+        }
+        running.store(false, std::memory_order_relaxed);
+        close_fds();
+    }
+
+    void close_fds() {
+        if (wake_fd >= 0) {
+            ::close(wake_fd);
+            wake_fd = -1;
+        }
+        if (epoll_fd >= 0) {
+            ::close(epoll_fd);
+            epoll_fd = -1;
+        }
+    }
+
+    void wake() {
+        uint64_t one = 1;
+        [[maybe_unused]] auto n = ::write(wake_fd, &one, sizeof(one));
+    }
+
+    // =========================================================================
+    // Очереди
+    // =========================================================================
+
+    bool spawn(core::Task<void> task) {
+        if (!running.load(std::memory_order_relaxed)) {
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        if (stopping.load(std::memory_order_relaxed)) {
+            return false;
+        }
+        active.fetch_add(1, std::memory_order_relaxed);
+        auto root = run_root(std::move(task));
+        posted.push_back([this, handle = root.handle] { ready.push_back(handle); });
+        wake();
+        return true;
+    }
+
+    DetachedTask run_root(core::Task<void> task) {
+        co_await task;
+        active.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    void post(std::function<void()> fn) {
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            posted.push_back(std::move(fn));
+        }
+        if (running.load(std::memory_order_relaxed)) {
+            wake();
+        }
+    }
+
+    /**
+     * @brief Выполнить post() и готовые корутины
+     *
+     * @return false и очереди пусты, и loop больше нечего ждать
+     */
+    bool run_queued() {
+        std::vector<std::function<void()>> batch;
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            batch.swap(posted);
+        }
+        for (auto& fn : batch) {
+            fn();
+        }
+
+        while (!ready.empty()) {
+            auto handle = ready.front();
+            ready.pop_front();
+            handle.resume();
+        }
+
+        if (stopping.load(std::memory_order_relaxed) && !cancelled_all) {
+            cancel_all();
+            return run_queued();
+        }
+
+        if (stopping.load(std::memory_order_relaxed) &&
+            active.load(std::memory_order_relaxed) == 0) {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            return !posted.empty();
+        }
+        return true;
+    }
+
+    // =========================================================================
+    // Ожидание сокетов и таймеров
+    // =========================================================================
+
+    void arm_timer(IoWaiter& waiter, Clock::time_point deadline) {
+        waiter.deadline = deadline;
+        waiter.timer_seq = next_timer_seq++;
+        timers.emplace(std::make_pair(deadline, waiter.timer_seq), &waiter);
+    }
+
+    void disarm_timer(IoWaiter& waiter) {
+        if (waiter.timer_seq != 0) {
+            timers.erase({waiter.deadline, waiter.timer_seq});
+            waiter.timer_seq = 0;
+        }
+    }
+
+    /**
+     * @brief Снять ожидание и поставить корутину в очередь готовых
+     */
+    void wake_waiter(IoWaiter& waiter, WaitResult result) {
+        if (waiter.slot != nullptr) {
+            *waiter.slot = nullptr;
+            waiter.slot = nullptr;
+        }
+        disarm_timer(waiter);
+        waiter.result = result;
+        ready.push_back(waiter.handle);
+    }
+
+    void on_event(IoHandle& handle, uint32_t mask) {
+        // Обе корутины - в очередь готовых до возобновления: возобновлённая
+        // может закрыть сокет, а события пачки к нему уже не обращаются
+        if (handle.reader && (mask & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR))) {
+            wake_waiter(*handle.reader, WaitResult::Ready);
+        }
+        if (handle.writer && (mask & (EPOLLOUT | EPOLLHUP | EPOLLERR))) {
+            wake_waiter(*handle.writer, WaitResult::Ready);
+        }
+    }
+
+    void expire_timers() {
+        const auto now = Clock::now();
+        while (!timers.empty() && timers.begin()->first.first <= now) {
+            IoWaiter& waiter = *timers.begin()->second;
+            wake_waiter(waiter, waiter.timeout_is_ready ? WaitResult::Ready : WaitResult::TimedOut);
+        }
+    }
+
+    void cancel_all() {
+        cancelled_all = true;
+        for (auto* handle : handles) {
+            if (handle->reader) {
+                wake_waiter(*handle->reader, WaitResult::Cancelled);
+            }
+            if (handle->writer) {
+                wake_waiter(*handle->writer, WaitResult::Cancelled);
+            }
+        }
+        while (!timers.empty()) {
+            wake_waiter(*timers.begin()->second, WaitResult::Cancelled);
+        }
+    }
+
+    [[nodiscard]] int wait_timeout_ms() const {
+        if (!ready.empty()) {
+            return 0;
+        }
+        if (timers.empty()) {
+            return -1;
+        }
+        const auto delay = timers.begin()->first.first - Clock::now();
+        if (delay <= Clock::duration::zero()) {
+            return 0;
+        }
+        // Вверх до миллисекунды: иначе epoll_wait просыпается до срока
+        return static_cast<int>(std::chrono::ceil<std::chrono::milliseconds>(delay).count());
+    }
+
+    void loop() {
+        t_loop = this;
+        std::array<struct epoll_event, 64> events;
+
+        while (run_queued()) {
+            int n = epoll_wait(epoll_fd, events.data(), static_cast<int>(events.size()), wait_timeout_ms());
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                break;
+            }
+
+            for (int i = 0; i < n; ++i) {
+                auto* handle = static_cast<IoHandle*>(events[i].data.ptr);
+                if (handle == nullptr) {
+                    uint64_t value;
+                    [[maybe_unused]] auto r = ::read(wake_fd, &value, sizeof(value));
+                    continue;
+                }
+                on_event(*handle, events[i].events);
+            }
+            expire_timers();
+        }
+        t_loop = nullptr;
+    }
+
+    // =========================================================================
+    // Сокеты
+    // =========================================================================
+
+    Result<IoHandle*> add_socket(int fd) {
+        int flags = fcntl(fd, F_GETFL, 0);
+        if (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0) {
+            return Err<IoHandle*>(
+                ErrorCode::NetworkConnectionFailed,
+                std::format("Не удалось перевести сокет в неблокирующий режим: {}", strerror(errno))
+            );
+        }
+
+        auto* handle = new IoHandle{fd};
+        struct epoll_event ev{};
+        ev.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+        ev.data.ptr = handle;
+        if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+            delete handle;
+            return Err<IoHandle*>(
+                ErrorCode::NetworkConnectionFailed,
+                std::format("epoll_ctl(ADD) для сокета: {}", strerror(errno))
+            );
+        }
+        handles.insert(handle);
+        return handle;
+    }
+
+    void remove_socket(IoHandle* handle) {
+        if (handle->reader) {
+            wake_waiter(*handle->reader, WaitResult::Cancelled);
+        }
+        if (handle->writer) {
+            wake_waiter(*handle->writer, WaitResult::Cancelled);
+        }
+        if (epoll_fd >= 0) {
+            epoll_ctl(epoll_fd, EPOLL_CTL_DEL, handle->fd, nullptr);
+        }
+        ::close(handle->fd);
+        handles.erase(handle);
+        delete handle;
+    }
+
+    /**
+     * @brief Ожидание готовности сокета или срока
+     */
+    struct Awaiter {
+        Impl& loop;
+        IoHandle* handle = nullptr;
+        bool for_write = false;
+        std::optional<Clock::time_point> deadline;
+        IoWaiter waiter{};
+
+        [[nodiscard]] bool await_ready() noexcept {
+            if (loop.stopping.load(std::memory_order_relaxed)) {
+                waiter.result = WaitResult::Cancelled;
+                return true;
+            }
+            return false;
+        }
+
+        void await_suspend(std::coroutine_handle<> awaiting) {
+            waiter.handle = awaiting;
+            if (handle != nullptr) {
+                waiter.slot = for_write ? &handle->writer : &handle->reader;
+                *waiter.slot = &waiter;
+            } else {
+                waiter.timeout_is_ready = true;
+            }
+            if (deadline) {
+                loop.arm_timer(waiter, *deadline);
+            }
+        }
+
+        [[nodiscard]] WaitResult await_resume() const noexcept {
+            return waiter.result;
+        }
+    };
+
+    Awaiter wait(IoHandle* handle, bool for_write, std::optional<Clock::time_point> deadline) {
+        return Awaiter{*this, handle, for_write, deadline};
+    }
+};
+
+namespace {
+
+std::optional<IoLoop::Clock::time_point> deadline_after(std::chrono::milliseconds timeout) {
+    if (timeout.count() <= 0) {
+        return std::nullopt;
+    }
+    return IoLoop::Clock::now() + timeout;
+}
+
+template<typename T>
+Result<T> wait_error(WaitResult result, const char* operation) {
+    if (result == WaitResult::TimedOut) {
+        return Err<T>(ErrorCode::NetworkTimeout, std::format("Таймаут: {}", operation));
+    }
+    return Err<T>(ErrorCode::NetworkConnectionFailed, std::format("Сокет закрыт: {}", operation));
+}
+
+} // anonymous namespace
+
+// =============================================================================
+// IoLoop
+// =============================================================================
+
+IoLoop::IoLoop()
+    : impl_(std::make_unique<Impl>())
+{
+}
+
+IoLoop::~IoLoop() = default;
+
+Result<void> IoLoop::start() {
+    return impl_->start();
+}
+
+void IoLoop::stop() {
+    impl_->stop();
+}
+
+bool IoLoop::spawn(core::Task<void> task) {
+    return impl_->spawn(std::move(task));
+}
+
+void IoLoop::post(std::function<void()> fn) {
+    impl_->post(std::move(fn));
+}
+
+core::Task<bool> IoLoop::sleep_for(std::chrono::milliseconds delay) {
+    auto result = co_await impl_->wait(nullptr, false, Clock::now() + delay);
+    co_return result != WaitResult::Cancelled;
+}
+
+bool IoLoop::in_loop_thread() const noexcept {
+    return t_loop == impl_.get();
+}
+
+std::size_t IoLoop::active_tasks() const noexcept {
+    return impl_->active.load(std::memory_order_relaxed);
+}
+
+// =============================================================================
+// AsyncSocket
+// =============================================================================
+
+AsyncSocket::~AsyncSocket() {
+    close();
+}
+
+AsyncSocket::AsyncSocket(AsyncSocket&& other) noexcept
+    : loop_(std::exchange(other.loop_, nullptr))
+    , handle_(std::exchange(other.handle_, nullptr))
+{
+}
+
+AsyncSocket& AsyncSocket::operator=(AsyncSocket&& other) noexcept {
+    if (this != &other) {
+        close();
+        loop_ = std::exchange(other.loop_, nullptr);
+        handle_ = std::exchange(other.handle_, nullptr);
+    }
+    return *this;
+}
+
+Result<AsyncSocket> AsyncSocket::adopt(IoLoop& loop, int fd) {
+    auto handle = loop.impl_->add_socket(fd);
+    if (!handle) {
+        return std::unexpected(handle.error());
+    }
+    return AsyncSocket(loop, *handle);
+}
+
+core::Task<Result<AsyncSocket>> AsyncSocket::connect(IoLoop& loop, std::string host, uint16_t port,
+                                                     std::chrono::milliseconds timeout) {
+    const auto deadline = deadline_after(timeout);
+
+    struct sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    if (inet_pton(AF_INET, host.c_str(), &addr.sin_addr) != 1) {
+        addrinfo hints{};
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_STREAM;
+        addrinfo* result = nullptr;
+        if (::getaddrinfo(host.c_str(), nullptr, &hints, &result) != 0 || result == nullptr) {
+            co_return Err<AsyncSocket>(ErrorCode::NetworkConnectionFailed,
+                                       std::format("Не удалось разрешить {}", host));
+        }
+        addr.sin_addr = reinterpret_cast<struct sockaddr_in*>(result->ai_addr)->sin_addr;
+        ::freeaddrinfo(result);
+    }
+
+    int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        co_return Err<AsyncSocket>(ErrorCode::NetworkConnectionFailed,
+                                   std::format("Не удалось создать сокет: {}", strerror(errno)));
+    }
+    int flag = 1;
+    ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
+
+    auto adopted = adopt(loop, fd);
+    if (!adopted) {
+        ::close(fd);
+        co_return std::unexpected(adopted.error());
+    }
+    AsyncSocket socket = std::move(*adopted);
+
+    if (::connect(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0) {
+        if (errno != EINPROGRESS) {
+            co_return Err<AsyncSocket>(ErrorCode::NetworkConnectionFailed,
+                                       std::format("Подключение к {}:{}: {}", host, port, strerror(errno)));
+        }
+
+        auto waited = co_await loop.impl_->wait(socket.handle_, true, deadline);
+        if (waited != WaitResult::Ready) {
+            co_return wait_error<AsyncSocket>(waited, "подключение");
+        }
+
+        int error = 0;
+        socklen_t length = sizeof(error);
+        ::getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &length);
+        if (error != 0) {
+            co_return Err<AsyncSocket>(ErrorCode::NetworkConnectionFailed,
+                                       std::format("Подключение к {}:{}: {}", host, port, strerror(error)));
+        }
+    }
+
+    co_return std::move(socket);
+}
+
+core::Task<Result<std::size_t>> AsyncSocket::read_some(MutableByteSpan buffer,
+                                                       std::chrono::milliseconds timeout) {
+    const auto deadline = deadline_after(timeout);
+
+    while (handle_ != nullptr) {
+        ssize_t n = ::recv(handle_->fd, buffer.data(), buffer.size(), 0);
+        if (n > 0) {
+            co_return static_cast<std::size_t>(n);
+        }
+        if (n == 0) {
+            co_return Err<std::size_t>(ErrorCode::NetworkRecvFailed, "Соединение закрыто пиром");
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            co_return Err<std::size_t>(ErrorCode::NetworkRecvFailed,
+                                       std::format("recv: {}", strerror(errno)));
+        }
+
+        auto waited = co_await loop_->impl_->wait(handle_, false, deadline);
+        if (waited != WaitResult::Ready) {
+            co_return wait_error<std::size_t>(waited, "чтение");
+        }
+    }
+    co_return wait_error<std::size_t>(WaitResult::Cancelled, "чтение");
+}
+
+core::Task<Result<void>> AsyncSocket::read_exact(MutableByteSpan buffer, std::chrono::milliseconds timeout) {
+    const auto deadline = deadline_after(timeout);
+
+    std::size_t offset = 0;
+    while (offset < buffer.size()) {
+        auto left = std::chrono::milliseconds(0);
+        if (deadline) {
+            left = std::chrono::ceil<std::chrono::milliseconds>(*deadline - IoLoop::Clock::now());
+            if (left.count() <= 0) {
+                co_return wait_error<void>(WaitResult::TimedOut, "чтение");
+            }
+        }
+        auto n = co_await read_some(buffer.subspan(offset), left);
+        if (!n) {
+            co_return std::unexpected(n.error());
+        }
+        offset += *n;
+    }
+    co_return Result<void>{};
+}
+
+core::Task<Result<void>> AsyncSocket::write_all(ByteSpan data, std::chrono::milliseconds timeout) {
+    const auto deadline = deadline_after(timeout);
+
+    std::size_t offset = 0;
+    while (offset < data.size()) {
+        if (handle_ == nullptr) {
+            co_return wait_error<void>(WaitResult::Cancelled, "запись");
+        }
+        ssize_t n = ::send(handle_->fd, data.data() + offset, data.size() - offset, MSG_NOSIGNAL);
+        if (n >= 0) {
+            offset += static_cast<std::size_t>(n);
+            continue;
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            co_return Err<void>(ErrorCode::NetworkSendFailed, std::format("send: {}", strerror(errno)));
+        }
+
+        auto waited = co_await loop_->impl_->wait(handle_, true, deadline);
+        if (waited != WaitResult::Ready) {
+            co_return wait_error<void>(waited, "запись");
+        }
+    }
+    co_return Result<void>{};
+}
+
+void AsyncSocket::close() noexcept {
+    if (handle_ != nullptr) {
+        loop_->impl_->remove_socket(std::exchange(handle_, nullptr));
+    }
+}
+
+int AsyncSocket::fd() const noexcept {
+    return handle_ ? handle_->fd : -1;
+}
+
+} // namespace quaxis::network
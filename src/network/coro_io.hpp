@@ -0,0 +1,216 @@
+/**
+ * @file coro_io.hpp
+ * @brief Корутинный ввод-вывод поверх epoll: IoLoop и AsyncSocket
+ *
+ * Клиенты узла и пулов (RPC, Stratum, relay) написаны блокирующими
+ * циклами с потоком на соединение. IoLoop - тот же edge-triggered epoll
+ * с eventfd, что и EpollReactor, но вместо обработчиков соединения он
+ * возобновляет корутины core::Task: чтение, запись и подключение с
+ * таймаутом пишутся прямым кодом, а все соединения живут в одном потоке.
+ *
+ * @code
+ * core::Task<Result<void>> ping(IoLoop& loop) {
+ *     auto socket = co_await AsyncSocket::connect(loop, "127.0.0.1", 8332, 1000ms);
+ *     if (!socket) co_return std::unexpected(socket.error());
+ *     co_return co_await socket->write_all(request, 1000ms);
+ * }
+ * @endcode
+ *
+ * Корутины и сокеты выполняются только в потоке IoLoop; spawn(), post()
+ * и block_on() можно вызывать из любого потока.
+ */
+
+#pragma once
+
+#include "../core/task.hpp"
+#include "../core/types.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+#include <type_traits>
+
+namespace quaxis::network {
+
+namespace detail {
+struct IoHandle;
+} // namespace detail
+
+/**
+ * @brief Поток epoll, возобновляющий корутины по готовности сокетов
+ */
+class IoLoop {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    IoLoop();
+    ~IoLoop();
+
+    IoLoop(const IoLoop&) = delete;
+    IoLoop& operator=(const IoLoop&) = delete;
+
+    /**
+     * @brief Создать epoll/eventfd и запустить поток
+     *
+     * @return Result<void> Успех или ошибка
+     */
+    [[nodiscard]] Result<void> start();
+
+    /**
+     * @brief Остановить поток
+     *
+     * Ожидающие операции завершаются ошибкой, новые - сразу ошибкой;
+     * возвращает, когда все запущенные задачи дошли до конца.
+     */
+    void stop();
+
+    /**
+     * @brief Запустить корневую задачу в потоке loop
+     *
+     * Исключение из корневой задачи - std::terminate.
+     *
+     * @return false loop не запущен или останавливается
+     */
+    bool spawn(core::Task<void> task);
+
+    /**
+     * @brief Выполнить функцию в потоке loop
+     */
+    void post(std::function<void()> fn);
+
+    /**
+     * @brief Выполнить задачу в loop и дождаться результата
+     *
+     * Не вызывать из потока loop. Если loop не запущен - std::future_error.
+     */
+    template<typename T>
+    T block_on(core::Task<T> task) {
+        std::promise<T> result;
+        auto future = result.get_future();
+        spawn(deliver(std::move(task), std::move(result)));
+        return future.get();
+    }
+
+    /**
+     * @brief Приостановить корутину на delay
+     *
+     * @return false loop остановлен раньше срока
+     */
+    core::Task<bool> sleep_for(std::chrono::milliseconds delay);
+
+    /**
+     * @brief Текущий поток - поток этого loop
+     */
+    [[nodiscard]] bool in_loop_thread() const noexcept;
+
+    /**
+     * @brief Запущенных и ещё не завершённых корневых задач
+     */
+    [[nodiscard]] std::size_t active_tasks() const noexcept;
+
+private:
+    friend class AsyncSocket;
+
+    template<typename T>
+    static core::Task<void> deliver(core::Task<T> task, std::promise<T> result) {
+        try {
+            if constexpr (std::is_void_v<T>) {
+                co_await task;
+                result.set_value();
+            } else {
+                result.set_value(co_await task);
+            }
+        } catch (...) {
+            result.set_exception(std::current_exception());
+        }
+    }
+
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+/**
+ * @brief Неблокирующий TCP сокет, зарегистрированный в IoLoop
+ *
+ * Операции - корутины; буфер операции должен жить до её завершения.
+ * Одновременно - не больше одного чтения и одной записи. Таймаут 0 -
+ * без ограничения. Закрывать - в потоке loop или после его stop();
+ * сокет не должен переживать свой IoLoop.
+ */
+class AsyncSocket {
+public:
+    AsyncSocket() noexcept = default;
+    ~AsyncSocket();
+
+    AsyncSocket(AsyncSocket&& other) noexcept;
+    AsyncSocket& operator=(AsyncSocket&& other) noexcept;
+
+    AsyncSocket(const AsyncSocket&) = delete;
+    AsyncSocket& operator=(const AsyncSocket&) = delete;
+
+    /**
+     * @brief Взять открытый сокет под управление loop
+     *
+     * Сокет переводится в неблокирующий режим; закрывает его AsyncSocket.
+     */
+    [[nodiscard]] static Result<AsyncSocket> adopt(IoLoop& loop, int fd);
+
+    /**
+     * @brief Подключиться по TCP (IPv4)
+     *
+     * Имя хоста, не являющееся адресом, разрешается getaddrinfo в потоке
+     * loop (блокирующе): на горячем пути задавайте адрес.
+     */
+    static core::Task<Result<AsyncSocket>> connect(IoLoop& loop, std::string host, uint16_t port,
+                                                   std::chrono::milliseconds timeout);
+
+    /**
+     * @brief Прочитать то, что есть (минимум 1 байт)
+     *
+     * @return Прочитано байт; 0 байт (закрытие пиром) - ошибка NetworkRecvFailed
+     */
+    core::Task<Result<std::size_t>> read_some(MutableByteSpan buffer, std::chrono::milliseconds timeout);
+
+    /**
+     * @brief Прочитать ровно buffer.size() байт
+     *
+     * Таймаут - на всю операцию.
+     */
+    core::Task<Result<void>> read_exact(MutableByteSpan buffer, std::chrono::milliseconds timeout);
+
+    /**
+     * @brief Записать все данные
+     *
+     * Таймаут - на всю операцию.
+     */
+    core::Task<Result<void>> write_all(ByteSpan data, std::chrono::milliseconds timeout);
+
+    /**
+     * @brief Закрыть сокет (ожидающие операции завершатся ошибкой)
+     */
+    void close() noexcept;
+
+    [[nodiscard]] bool is_open() const noexcept {
+        return handle_ != nullptr;
+    }
+
+    /**
+     * @brief Дескриптор сокета (-1 - закрыт)
+     */
+    [[nodiscard]] int fd() const noexcept;
+
+private:
+    AsyncSocket(IoLoop& loop, detail::IoHandle* handle) noexcept
+        : loop_(&loop)
+        , handle_(handle)
+    {}
+
+    IoLoop* loop_ = nullptr;
+    detail::IoHandle* handle_ = nullptr;
+};
+
+} // namespace quaxis::network
@@ -0,0 +1,210 @@
+/**
+ * @file epoll_reactor.cpp
+ * @brief Реализация epoll цикла событий
+ */
+
+#include "epoll_reactor.hpp"
+#include "../core/thread_plan.hpp"
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <cstring>
+
+#include <array>
+#include <atomic>
+#include <thread>
+#include <format>
+
+namespace quaxis::network {
+
+struct EpollReactor::Impl {
+    int epoll_fd = -1;
+    int wake_fd = -1;
+
+    std::atomic<bool> running{false};
+    std::atomic<std::size_t> connections{0};
+    std::thread thread;
+
+    // Listening сокет шарда: data.ptr == &listener отличает его от соединений
+    int listener = -1;
+    AcceptCallback on_accept;
+
+    ~Impl() {
+        stop();
+    }
+
+    Result<void> start() {
+        epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        if (epoll_fd < 0) {
+            return Err<void>(
+                ErrorCode::NetworkConnectionFailed,
+                std::format("Не удалось создать epoll: {}", strerror(errno))
+            );
+        }
+
+        wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (wake_fd < 0) {
+            close_fds();
+            return Err<void>(
+                ErrorCode::NetworkConnectionFailed,
+                std::format("Не удалось создать eventfd: {}", strerror(errno))
+            );
+        }
+
+        // data.ptr == nullptr отличает eventfd от соединений
+        struct epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.ptr = nullptr;
+        if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wake_fd, &ev) < 0) {
+            close_fds();
+            return Err<void>(
+                ErrorCode::NetworkConnectionFailed,
+                std::format("Не удалось зарегистрировать eventfd: {}", strerror(errno))
+            );
+        }
+
+        running.store(true, std::memory_order_relaxed);
+        thread = std::thread([this] {
+            core::enter_thread_role(core::ThreadRole::Fanout);
+            loop();
+        });
+
+        return {};
+    }
+
+    void stop() {
+        if (running.exchange(false, std::memory_order_relaxed)) {
+            uint64_t one = 1;
+            [[maybe_unused]] auto n = write(wake_fd, &one, sizeof(one));
+        }
+
+        if (thread.joinable()) {
+            thread.join();
+        }
+
+        close_fds();
+    }
+
+    void close_fds() {
+        if (wake_fd >= 0) {
+            close(wake_fd);
+            wake_fd = -1;
+        }
+        if (epoll_fd >= 0) {
+            close(epoll_fd);
+            epoll_fd = -1;
+        }
+    }
+
+    Result<void> add(AsicConnection& conn) {
+        struct epoll_event ev{};
+        ev.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+        ev.data.ptr = &conn;
+
+        if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, conn.socket_fd(), &ev) < 0) {
+            return Err<void>(
+                ErrorCode::NetworkConnectionFailed,
+                std::format("epoll_ctl(ADD) для {}: {}", conn.remote_address(), strerror(errno))
+            );
+        }
+
+        connections.fetch_add(1, std::memory_order_relaxed);
+        return {};
+    }
+
+    Result<void> set_listener(int listen_fd, AcceptCallback callback) {
+        if (listener >= 0) {
+            return Err<void>(ErrorCode::NetworkConnectionFailed, "Listening сокет reactor уже задан");
+        }
+
+        // Обработчик задаётся до регистрации: событие может прийти сразу
+        on_accept = std::move(callback);
+        listener = listen_fd;
+
+        struct epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.ptr = &listener;
+        if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, listen_fd, &ev) < 0) {
+            listener = -1;
+            return Err<void>(
+                ErrorCode::NetworkConnectionFailed,
+                std::format("epoll_ctl(ADD) для listening сокета: {}", strerror(errno))
+            );
+        }
+        return {};
+    }
+
+    void loop() {
+        std::array<struct epoll_event, 64> events;
+
+        while (running.load(std::memory_order_relaxed)) {
+            int n = epoll_wait(epoll_fd, events.data(), static_cast<int>(events.size()), -1);
+
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                break;
+            }
+
+            for (int i = 0; i < n; ++i) {
+                if (events[i].data.ptr == &listener) {
+                    on_accept();
+                    continue;
+                }
+
+                auto* conn = static_cast<AsicConnection*>(events[i].data.ptr);
+                if (conn == nullptr) {
+                    continue;  // Пробуждение для остановки
+                }
+
+                uint32_t mask = events[i].events;
+                bool alive = true;
+
+                if (mask & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) {
+                    alive = conn->on_readable();
+                }
+                if (alive && (mask & EPOLLOUT)) {
+                    alive = conn->on_writable();
+                }
+                if (alive && (mask & (EPOLLHUP | EPOLLERR))) {
+                    alive = false;
+                }
+
+                if (!alive) {
+                    epoll_ctl(epoll_fd, EPOLL_CTL_DEL, conn->socket_fd(), nullptr);
+                    connections.fetch_sub(1, std::memory_order_relaxed);
+                    conn->on_closed();
+                }
+            }
+        }
+    }
+};
+
+EpollReactor::EpollReactor()
+    : impl_(std::make_unique<Impl>())
+{
+}
+
+EpollReactor::~EpollReactor() = default;
+
+Result<void> EpollReactor::start() {
+    return impl_->start();
+}
+
+void EpollReactor::stop() {
+    impl_->stop();
+}
+
+Result<void> EpollReactor::add(AsicConnection& conn) {
+    return impl_->add(conn);
+}
+
+Result<void> EpollReactor::set_listener(int listen_fd, AcceptCallback on_accept) {
+    return impl_->set_listener(listen_fd, std::move(on_accept));
+}
+
+std::size_t EpollReactor::connection_count() const noexcept {
+    return impl_->connections.load(std::memory_order_relaxed);
+}
+
+} // namespace quaxis::network
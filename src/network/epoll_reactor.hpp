@@ -0,0 +1,92 @@
+/**
+ * @file epoll_reactor.hpp
+ * @brief Edge-triggered epoll цикл событий для ASIC соединений
+ *
+ * Альтернатива модели "2 потока на соединение": один поток обслуживает
+ * целый шард соединений. Сокеты регистрируются один раз с
+ * EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET:
+ * - EPOLLIN: AsicConnection::on_readable() читает до EAGAIN
+ * - EPOLLOUT: AsicConnection::on_writable() досылает очередь
+ * - HUP/ERR/закрытие: соединение снимается с epoll и закрывается
+ *
+ * Reactor может сам принимать соединения своего шарда (set_listener):
+ * accept и весь ввод-вывод соединения идут в одном потоке.
+ *
+ * Остановка мгновенная (eventfd), без таймаутов опроса.
+ */
+
+#pragma once
+
+#include "asic_connection.hpp"
+#include "../core/types.hpp"
+
+#include <functional>
+#include <memory>
+
+namespace quaxis::network {
+
+/**
+ * @brief Один поток epoll, владеющий шардом соединений
+ */
+class EpollReactor {
+public:
+    EpollReactor();
+    ~EpollReactor();
+
+    // Запрещаем копирование
+    EpollReactor(const EpollReactor&) = delete;
+    EpollReactor& operator=(const EpollReactor&) = delete;
+
+    /**
+     * @brief Создать epoll/eventfd и запустить поток
+     *
+     * @return Result<void> Успех или ошибка
+     */
+    [[nodiscard]] Result<void> start();
+
+    /**
+     * @brief Остановить поток
+     *
+     * Соединения остаются открытыми; их закрывает владелец.
+     */
+    void stop();
+
+    /**
+     * @brief Зарегистрировать соединение
+     *
+     * Соединение должно быть запущено через start_external_io() и жить,
+     * пока не вызван on_closed() или пока reactor не остановлен.
+     *
+     * @param conn Соединение
+     * @return Result<void> Успех или ошибка epoll_ctl
+     */
+    [[nodiscard]] Result<void> add(AsicConnection& conn);
+
+    /// @brief Обработчик готовности listening сокета (в потоке reactor)
+    using AcceptCallback = std::function<void()>;
+
+    /**
+     * @brief Принимать соединения в этом потоке
+     *
+     * Listening сокет (свой SO_REUSEPORT на reactor) регистрируется
+     * level-triggered; on_accept вызывается при входящих подключениях и
+     * добавляет принятые соединения в этот же reactor. Один сокет на
+     * reactor; закрывает его владелец после stop().
+     *
+     * @param listen_fd Неблокирующий listening сокет
+     * @param on_accept Приём подключений до EAGAIN
+     * @return Result<void> Успех, ошибка epoll_ctl или сокет уже задан
+     */
+    [[nodiscard]] Result<void> set_listener(int listen_fd, AcceptCallback on_accept);
+
+    /**
+     * @brief Количество соединений в шарде
+     */
+    [[nodiscard]] std::size_t connection_count() const noexcept;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace quaxis::network
@@ -0,0 +1,301 @@
+/**
+ * @file fleet_telemetry.cpp
+ * @brief Реализация таблицы телеметрии фермы
+ */
+
+#include "fleet_telemetry.hpp"
+
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace quaxis::network {
+
+namespace {
+
+// Формат записи - см. RSP_TELEMETRY в protocol.hpp и firmware/include/protocol.h
+constexpr uint8_t FLAG_KEYFRAME = 0x01;
+constexpr uint8_t FIELD_TEMPERATURE = 0x01;
+constexpr uint8_t FIELD_FREQUENCY = 0x02;
+constexpr uint8_t FIELD_STATUS = 0x04;
+constexpr uint8_t FIELD_HW_ERRORS = 0x08;
+constexpr uint8_t FIELD_GOOD_NONCES = 0x10;
+constexpr uint8_t FIELD_ALL = 0x1F;
+
+/**
+ * @brief Чтение varint из payload
+ */
+class Reader {
+public:
+    explicit Reader(ByteSpan data) noexcept : data_(data) {}
+
+    [[nodiscard]] bool empty() const noexcept { return pos_ >= data_.size(); }
+
+    [[nodiscard]] std::optional<uint8_t> byte() noexcept {
+        if (empty()) {
+            return std::nullopt;
+        }
+        return data_[pos_++];
+    }
+
+    /// @brief varint до 32 бит (не длиннее 5 байт)
+    [[nodiscard]] std::optional<uint32_t> varint() noexcept {
+        uint32_t value = 0;
+        for (unsigned shift = 0; shift < 35; shift += 7) {
+            auto b = byte();
+            if (!b) {
+                return std::nullopt;
+            }
+            if (shift == 28 && (*b & 0xF0) != 0) {
+                return std::nullopt;  // Больше 32 бит
+            }
+            value |= static_cast<uint32_t>(*b & 0x7F) << shift;
+            if ((*b & 0x80) == 0) {
+                return value;
+            }
+        }
+        return std::nullopt;
+    }
+
+    /// @brief zigzag varint
+    [[nodiscard]] std::optional<int32_t> delta() noexcept {
+        auto v = varint();
+        if (!v) {
+            return std::nullopt;
+        }
+        return static_cast<int32_t>((*v >> 1) ^ (0U - (*v & 1)));
+    }
+
+private:
+    ByteSpan data_;
+    std::size_t pos_ = 0;
+};
+
+} // anonymous namespace
+
+struct FleetTelemetry::Impl {
+    std::size_t chips_per_asic;
+
+    mutable std::mutex mutex;
+
+    // Блок строк ASIC: slot * chips_per_asic .. + chips_per_asic
+    std::unordered_map<uint32_t, std::size_t> slots;
+    std::vector<std::size_t> free_slots;
+    std::vector<uint8_t> slot_used;
+    std::vector<uint8_t> slot_stale;
+
+    // Столбцы таблицы
+    std::vector<int16_t> temperature;
+    std::vector<uint16_t> frequency;
+    std::vector<uint8_t> status;
+    std::vector<uint32_t> hw_errors;
+    std::vector<uint32_t> good_nonces;
+    std::vector<uint8_t> present;
+
+    explicit Impl(std::size_t chips) : chips_per_asic(std::max<std::size_t>(chips, 1)) {}
+
+    std::size_t acquire_slot(uint32_t asic_id) {
+        auto it = slots.find(asic_id);
+        if (it != slots.end()) {
+            return it->second;
+        }
+
+        std::size_t slot;
+        if (!free_slots.empty()) {
+            slot = free_slots.back();
+            free_slots.pop_back();
+        } else {
+            slot = slot_used.size();
+            slot_used.push_back(0);
+            slot_stale.push_back(0);
+            const std::size_t rows = (slot + 1) * chips_per_asic;
+            temperature.resize(rows);
+            frequency.resize(rows);
+            status.resize(rows);
+            hw_errors.resize(rows);
+            good_nonces.resize(rows);
+            present.resize(rows);
+        }
+
+        slot_used[slot] = 1;
+        // Без keyframe снимку не на что опереться
+        slot_stale[slot] = 1;
+        slots.emplace(asic_id, slot);
+        return slot;
+    }
+
+    void reset_slot(std::size_t slot) {
+        const auto first = static_cast<std::ptrdiff_t>(slot * chips_per_asic);
+        const auto last = first + static_cast<std::ptrdiff_t>(chips_per_asic);
+        std::fill(temperature.begin() + first, temperature.begin() + last, int16_t{0});
+        std::fill(frequency.begin() + first, frequency.begin() + last, uint16_t{0});
+        std::fill(status.begin() + first, status.begin() + last, uint8_t{0});
+        std::fill(hw_errors.begin() + first, hw_errors.begin() + last, 0U);
+        std::fill(good_nonces.begin() + first, good_nonces.begin() + last, 0U);
+        std::fill(present.begin() + first, present.begin() + last, uint8_t{0});
+    }
+
+    /// @brief Разобрать записи чипов; false - кадр повреждён
+    bool decode(std::size_t slot, Reader& reader, std::size_t& updated) {
+        const std::size_t base = slot * chips_per_asic;
+        std::size_t next_chip = 0;
+
+        while (!reader.empty()) {
+            auto gap = reader.varint();
+            auto mask = reader.byte();
+            if (!gap || !mask || (*mask & ~FIELD_ALL) != 0) {
+                return false;
+            }
+            const std::size_t chip = next_chip + *gap;
+            if (chip >= chips_per_asic) {
+                return false;
+            }
+            const std::size_t row = base + chip;
+
+            if (*mask & FIELD_TEMPERATURE) {
+                auto d = reader.delta();
+                if (!d) return false;
+                temperature[row] = static_cast<int16_t>(temperature[row] + *d);
+            }
+            if (*mask & FIELD_FREQUENCY) {
+                auto d = reader.delta();
+                if (!d) return false;
+                frequency[row] = static_cast<uint16_t>(frequency[row] + *d);
+            }
+            if (*mask & FIELD_STATUS) {
+                auto s = reader.byte();
+                if (!s) return false;
+                status[row] = *s;
+            }
+            if (*mask & FIELD_HW_ERRORS) {
+                auto d = reader.varint();
+                if (!d) return false;
+                hw_errors[row] += *d;
+            }
+            if (*mask & FIELD_GOOD_NONCES) {
+                auto d = reader.varint();
+                if (!d) return false;
+                good_nonces[row] += *d;
+            }
+
+            present[row] = 1;
+            next_chip = chip + 1;
+            ++updated;
+        }
+        return true;
+    }
+};
+
+FleetTelemetry::FleetTelemetry(std::size_t chips_per_asic)
+    : impl_(std::make_unique<Impl>(chips_per_asic)) {}
+
+FleetTelemetry::~FleetTelemetry() = default;
+
+Result<std::size_t> FleetTelemetry::apply(uint32_t asic_id, ByteSpan payload) {
+    Reader reader(payload);
+    auto flags = reader.byte();
+    if (!flags) {
+        return Err<std::size_t>(ErrorCode::NetworkRecvFailed, "Пустой кадр телеметрии");
+    }
+
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    const std::size_t slot = impl_->acquire_slot(asic_id);
+
+    if (*flags & FLAG_KEYFRAME) {
+        impl_->reset_slot(slot);
+        impl_->slot_stale[slot] = 0;
+    } else if (impl_->slot_stale[slot]) {
+        // Разницы без опоры: ждём keyframe
+        return std::size_t{0};
+    }
+
+    std::size_t updated = 0;
+    if (!impl_->decode(slot, reader, updated)) {
+        impl_->slot_stale[slot] = 1;
+        return Err<std::size_t>(ErrorCode::NetworkRecvFailed, "Повреждённый кадр телеметрии");
+    }
+    return updated;
+}
+
+void FleetTelemetry::remove(uint32_t asic_id) {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    auto it = impl_->slots.find(asic_id);
+    if (it == impl_->slots.end()) {
+        return;
+    }
+
+    impl_->reset_slot(it->second);
+    impl_->slot_used[it->second] = 0;
+    impl_->slot_stale[it->second] = 0;
+    impl_->free_slots.push_back(it->second);
+    impl_->slots.erase(it);
+}
+
+FleetSummary FleetTelemetry::summary() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    const auto& d = *impl_;
+
+    FleetSummary summary;
+    int64_t temperature_sum = 0;
+    uint64_t frequency_sum = 0;
+    bool any = false;
+
+    for (std::size_t slot = 0; slot < d.slot_used.size(); ++slot) {
+        if (!d.slot_used[slot]) {
+            continue;
+        }
+        if (d.slot_stale[slot]) {
+            ++summary.stale_asics;
+            continue;
+        }
+        ++summary.asics;
+
+        const std::size_t first = slot * d.chips_per_asic;
+        const std::size_t last = first + d.chips_per_asic;
+        for (std::size_t row = first; row < last; ++row) {
+            if (!d.present[row]) {
+                continue;
+            }
+            ++summary.chips;
+            summary.error_chips += d.status[row] != 0;
+            temperature_sum += d.temperature[row];
+            frequency_sum += d.frequency[row];
+            summary.hw_errors += d.hw_errors[row];
+            summary.good_nonces += d.good_nonces[row];
+            if (!any || d.temperature[row] > summary.temperature_max) {
+                summary.temperature_max = d.temperature[row];
+            }
+            any = true;
+        }
+    }
+
+    if (summary.chips > 0) {
+        const auto chips = static_cast<double>(summary.chips);
+        summary.temperature_avg = static_cast<double>(temperature_sum) / chips;
+        summary.frequency_avg_mhz = static_cast<double>(frequency_sum) / chips;
+    }
+    return summary;
+}
+
+std::optional<ChipTelemetry> FleetTelemetry::chip(uint32_t asic_id, std::size_t chip_id) const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    auto it = impl_->slots.find(asic_id);
+    if (it == impl_->slots.end() || impl_->slot_stale[it->second] || chip_id >= impl_->chips_per_asic) {
+        return std::nullopt;
+    }
+
+    const std::size_t row = it->second * impl_->chips_per_asic + chip_id;
+    if (!impl_->present[row]) {
+        return std::nullopt;
+    }
+    return ChipTelemetry{
+        impl_->temperature[row],
+        impl_->frequency[row],
+        impl_->status[row],
+        impl_->hw_errors[row],
+        impl_->good_nonces[row],
+    };
+}
+
+} // namespace quaxis::network
@@ -0,0 +1,108 @@
+/**
+ * @file fleet_telemetry.hpp
+ * @brief Телеметрия чипов всех ASIC в плоской таблице
+ *
+ * Каждый ASIC раз в секунду присылает RSP_TELEMETRY - только изменившиеся
+ * поля чипов, закодированные разницей с прошлым кадром (см. protocol.hpp).
+ * FleetTelemetry применяет эти разницы к снимку фермы, который хранится
+ * по столбцам (structure of arrays): температура, частота, статус и
+ * счётчики - отдельные непрерывные массивы, у ASIC - свой блок строк
+ * по chips_per_asic. Сводка для dashboard проходит столбцы подряд, без
+ * обхода объектов соединений.
+ *
+ * Ошибка разбора кадра помечает ASIC устаревшим: его разницы теряют
+ * опору, поэтому до следующего keyframe ASIC не входит в сводку.
+ *
+ * Thread-safe: кадры приходят из потоков соединений, сводку читают
+ * метрики и dashboard.
+ */
+
+#pragma once
+
+#include "../core/types.hpp"
+
+#include <memory>
+#include <optional>
+
+namespace quaxis::network {
+
+/**
+ * @brief Телеметрия одного чипа
+ */
+struct ChipTelemetry {
+    int16_t temperature = 0;        ///< Температура (°C)
+    uint16_t frequency_mhz = 0;     ///< Частота
+    uint8_t status = 0;             ///< Статус: 0 - OK
+    uint32_t hw_errors = 0;         ///< HW ошибки с запуска ASIC
+    uint32_t good_nonces = 0;       ///< Верные nonce с запуска ASIC
+};
+
+/**
+ * @brief Сводка по ферме
+ */
+struct FleetSummary {
+    std::size_t asics = 0;              ///< ASIC с актуальным снимком
+    std::size_t stale_asics = 0;        ///< ASIC, ждущие keyframe
+    std::size_t chips = 0;              ///< Чипы, приславшие телеметрию
+    std::size_t error_chips = 0;        ///< Чипы со статусом ошибки
+    double temperature_avg = 0.0;       ///< Средняя температура чипов
+    int16_t temperature_max = 0;        ///< Максимальная температура чипа
+    double frequency_avg_mhz = 0.0;     ///< Средняя частота чипов
+    uint64_t hw_errors = 0;             ///< HW ошибки всех чипов
+    uint64_t good_nonces = 0;           ///< Верные nonce всех чипов
+};
+
+/**
+ * @brief Снимок телеметрии фермы
+ */
+class FleetTelemetry {
+public:
+    /// @brief Чипов на ASIC по умолчанию (Avalon 1126 Pro)
+    static constexpr std::size_t DEFAULT_CHIPS_PER_ASIC = 114;
+
+    /**
+     * @brief Создать пустой снимок
+     *
+     * @param chips_per_asic Строк таблицы на ASIC (больший chip_id - ошибка кадра)
+     */
+    explicit FleetTelemetry(std::size_t chips_per_asic = DEFAULT_CHIPS_PER_ASIC);
+
+    ~FleetTelemetry();
+
+    // Запрещаем копирование
+    FleetTelemetry(const FleetTelemetry&) = delete;
+    FleetTelemetry& operator=(const FleetTelemetry&) = delete;
+
+    /**
+     * @brief Применить payload кадра RSP_TELEMETRY
+     *
+     * @param asic_id ID соединения ASIC
+     * @param payload Payload кадра (flags + записи чипов)
+     * @return Result<std::size_t> Число обновлённых чипов или ошибка разбора
+     *         (ASIC устарел до следующего keyframe)
+     */
+    [[nodiscard]] Result<std::size_t> apply(uint32_t asic_id, ByteSpan payload);
+
+    /**
+     * @brief Убрать ASIC из снимка (отключение)
+     */
+    void remove(uint32_t asic_id);
+
+    /**
+     * @brief Сводка по актуальным ASIC
+     */
+    [[nodiscard]] FleetSummary summary() const;
+
+    /**
+     * @brief Телеметрия чипа
+     *
+     * @return std::nullopt если ASIC неизвестен, устарел или чип не присылал данных
+     */
+    [[nodiscard]] std::optional<ChipTelemetry> chip(uint32_t asic_id, std::size_t chip_id) const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace quaxis::network
@@ -0,0 +1,625 @@
+/**
+ * @file handoff.cpp
+ * @brief Реализация передачи работы новому процессу
+ */
+
+#include "handoff.hpp"
+#include "template_feed.hpp"
+
+#include "../core/byte_order.hpp"
+#include "../core/serialization/stream.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <format>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace quaxis::network {
+
+namespace {
+
+/// @brief Запрос преемника: magic + версия
+constexpr std::size_t REQUEST_SIZE = 8;
+
+/// @brief Заголовок ответа: magic, версия, число дескрипторов, длина снимка
+constexpr std::size_t HEADER_SIZE = 16;
+
+/// @brief Подтверждение преемника
+constexpr uint8_t ACK_BYTE = 0x01;
+
+static_assert(std::is_trivially_copyable_v<mining::Job>,
+              "Job переносится побайтно");
+
+/// @brief Закрыть дескриптор, если открыт
+void close_fd(int& fd) noexcept {
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+}
+
+void close_all(std::span<const int> fds) noexcept {
+    for (int fd : fds) {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+}
+
+/// @brief Адрес unix сокета (путь проверен при загрузке конфигурации)
+bool make_address(const std::string& path, sockaddr_un& addr) {
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(addr.sun_path)) {
+        return false;
+    }
+    std::memcpy(addr.sun_path, path.data(), path.size());
+    return true;
+}
+
+/// @brief Дождаться события на сокете
+bool wait_for(int fd, short events, uint32_t timeout_ms) {
+    pollfd pfd{fd, events, 0};
+    while (true) {
+        int rc = ::poll(&pfd, 1, static_cast<int>(timeout_ms));
+        if (rc < 0 && errno == EINTR) {
+            continue;
+        }
+        return rc > 0 && (pfd.revents & events) != 0;
+    }
+}
+
+/// @brief Записать весь буфер (сокет может быть неблокирующим)
+bool send_all(int fd, ByteSpan data, uint32_t timeout_ms) {
+    std::size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            if (!wait_for(fd, POLLOUT, timeout_ms)) {
+                return false;
+            }
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        sent += static_cast<std::size_t>(n);
+    }
+    return true;
+}
+
+/// @brief Прочитать ровно size байт (каждая порция - за timeout_ms)
+bool recv_exact(int fd, uint8_t* out, std::size_t size, uint32_t timeout_ms) {
+    std::size_t received = 0;
+    while (received < size) {
+        if (!wait_for(fd, POLLIN, timeout_ms)) {
+            return false;
+        }
+        ssize_t n = ::recv(fd, out + received, size - received, MSG_DONTWAIT);
+        if (n < 0 && (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK)) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        received += static_cast<std::size_t>(n);
+    }
+    return true;
+}
+
+void write_bytes_field(core::serialization::WriteStream& out, const Bytes& bytes) {
+    out.write_varint(bytes.size());
+    out.write_bytes(bytes);
+}
+
+Bytes read_bytes_field(core::serialization::ReadStream& in) {
+    const uint64_t size = in.read_varint();
+    if (size > in.remaining()) {
+        throw core::serialization::StreamError("Длина поля больше снимка");
+    }
+    return in.read_bytes(static_cast<std::size_t>(size));
+}
+
+/// @brief Число элементов, проверенное по остатку снимка
+std::size_t read_count(core::serialization::ReadStream& in, std::size_t min_item_size) {
+    const uint64_t count = in.read_varint();
+    if (count > in.remaining() / std::max<std::size_t>(min_item_size, 1)) {
+        throw core::serialization::StreamError("Число элементов больше снимка");
+    }
+    return static_cast<std::size_t>(count);
+}
+
+} // anonymous namespace
+
+// =============================================================================
+// Снимок
+// =============================================================================
+
+std::vector<int> HandoffPackage::descriptors() const {
+    std::vector<int> fds(server.listen_fds);
+    fds.reserve(fds.size() + server.connections.size());
+    for (const auto& connection : server.connections) {
+        fds.push_back(connection.socket.fd);
+    }
+    return fds;
+}
+
+void HandoffPackage::close_descriptors() noexcept {
+    for (int& fd : server.listen_fds) {
+        close_fd(fd);
+    }
+    for (auto& connection : server.connections) {
+        close_fd(connection.socket.fd);
+    }
+}
+
+Bytes encode_handoff(const HandoffPackage& package) {
+    core::serialization::WriteStream out;
+
+    // Сервер
+    out.write_varint(package.server.listen_fds.size());
+    out.write_u32_le(package.server.next_connection_id);
+    out.write_varint(package.server.connections.size());
+    for (const auto& connection : package.server.connections) {
+        out.write_string(connection.remote_address);
+        out.write_u32_le(connection.connection_id);
+        out.write_u64_le(connection.session_token);
+        write_bytes_field(out, connection.socket.unparsed);
+        write_bytes_field(out, connection.socket.unsent);
+    }
+    out.write_varint(package.server.parked_sessions.size());
+    for (const auto& session : package.server.parked_sessions) {
+        out.write_u64_le(session.token);
+        out.write_u32_le(session.connection_id);
+    }
+
+    // Шаблон в раскладке кадра Template фида
+    const auto& jobs = package.jobs;
+    Bytes template_payload;
+    if (jobs.block_template) {
+        auto encoded = encode_feed_template(*jobs.block_template, jobs.is_speculative);
+        if (encoded) {
+            template_payload = std::move(*encoded);
+        }
+    }
+    out.write_u8(template_payload.empty() ? 0 : 1);
+    if (!template_payload.empty()) {
+        write_bytes_field(out, template_payload);
+    }
+    out.write_u8(jobs.is_speculative ? 1 : 0);
+    out.write_u32_le(jobs.next_job_id);
+
+    // Задания: без шаблона они бесполезны
+    const std::size_t job_count = template_payload.empty() ? 0 : jobs.jobs.size();
+    out.write_u32_le(static_cast<uint32_t>(sizeof(mining::Job)));
+    out.write_varint(job_count);
+    if (job_count > 0) {
+        out.write_bytes(ByteSpan(reinterpret_cast<const uint8_t*>(jobs.jobs.data()),
+                                 job_count * sizeof(mining::Job)));
+    }
+
+    // Аренды extranonce
+    out.write_varint(jobs.leases.size());
+    for (const auto& [connection_id, lease] : jobs.leases) {
+        out.write_u32_le(connection_id);
+        out.write_u64_le(lease.start);
+        out.write_u32_le(lease.count);
+    }
+    out.write_u64_le(jobs.next_extranonce);
+
+    return out.take_data();
+}
+
+Result<HandoffPackage> decode_handoff(ByteSpan snapshot, std::span<const int> fds) {
+    HandoffPackage package;
+    try {
+        core::serialization::ReadStream in(snapshot);
+
+        const uint64_t listen_count = in.read_varint();
+        package.server.next_connection_id = in.read_u32_le();
+        const std::size_t connection_count = read_count(in, 14);
+        if (listen_count == 0 || listen_count + connection_count != fds.size()) {
+            return Err<HandoffPackage>(ErrorCode::NetworkRecvFailed,
+                std::format("Снимок описывает {} сокетов, получено {}",
+                            listen_count + connection_count, fds.size()));
+        }
+        package.server.listen_fds.assign(fds.begin(), fds.begin() + static_cast<std::ptrdiff_t>(listen_count));
+
+        package.server.connections.reserve(connection_count);
+        for (std::size_t i = 0; i < connection_count; ++i) {
+            HandedOffConnection connection;
+            connection.remote_address = in.read_string();
+            connection.connection_id = in.read_u32_le();
+            connection.session_token = in.read_u64_le();
+            connection.socket.unparsed = read_bytes_field(in);
+            connection.socket.unsent = read_bytes_field(in);
+            connection.socket.fd = fds[listen_count + i];
+            package.server.connections.push_back(std::move(connection));
+        }
+
+        const std::size_t parked_count = read_count(in, 12);
+        package.server.parked_sessions.reserve(parked_count);
+        for (std::size_t i = 0; i < parked_count; ++i) {
+            ParkedSession session;
+            session.token = in.read_u64_le();
+            session.connection_id = in.read_u32_le();
+            package.server.parked_sessions.push_back(session);
+        }
+
+        auto& jobs = package.jobs;
+        if (in.read_u8() != 0) {
+            auto block_template = decode_feed_template(read_bytes_field(in));
+            if (!block_template) {
+                return Err<HandoffPackage>(block_template.error().code,
+                    "Шаблон снимка: " + block_template.error().message);
+            }
+            jobs.block_template = std::move(*block_template);
+        }
+        jobs.is_speculative = in.read_u8() != 0;
+        jobs.next_job_id = in.read_u32_le();
+
+        const uint32_t job_size = in.read_u32_le();
+        const std::size_t job_count = read_count(in, std::max<uint32_t>(job_size, 1));
+        const std::size_t job_bytes = job_count * job_size;
+        if (job_size == sizeof(mining::Job)) {
+            jobs.jobs.resize(job_count);
+            if (job_count > 0) {
+                const Bytes raw = in.read_bytes(job_bytes);
+                std::memcpy(jobs.jobs.data(), raw.data(), job_bytes);
+            }
+        } else {
+            // Раскладка Job другой сборки: ASIC получат новые задания
+            in.skip(job_bytes);
+        }
+
+        const std::size_t lease_count = read_count(in, 16);
+        jobs.leases.reserve(lease_count);
+        for (std::size_t i = 0; i < lease_count; ++i) {
+            const uint32_t connection_id = in.read_u32_le();
+            mining::ExtranonceLease lease;
+            lease.start = in.read_u64_le();
+            lease.count = in.read_u32_le();
+            jobs.leases.emplace_back(connection_id, lease);
+        }
+        jobs.next_extranonce = in.read_u64_le();
+    } catch (const core::serialization::StreamError& e) {
+        return Err<HandoffPackage>(ErrorCode::NetworkRecvFailed,
+                                   std::format("Снимок передачи повреждён: {}", e.what()));
+    }
+    return package;
+}
+
+// =============================================================================
+// Дескрипторы
+// =============================================================================
+
+Result<void> send_descriptors(int socket, std::span<const int> fds) {
+    for (std::size_t offset = 0; offset < fds.size(); offset += HANDOFF_FDS_PER_MESSAGE) {
+        const std::size_t chunk = std::min(HANDOFF_FDS_PER_MESSAGE, fds.size() - offset);
+
+        // Один байт данных несёт пачку дескрипторов
+        uint8_t marker = static_cast<uint8_t>(chunk);
+        iovec iov{&marker, 1};
+        std::vector<uint8_t> control(CMSG_SPACE(chunk * sizeof(int)), 0);
+
+        msghdr msg{};
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = control.data();
+        msg.msg_controllen = control.size();
+
+        cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+        cmsg->cmsg_level = SOL_SOCKET;
+        cmsg->cmsg_type = SCM_RIGHTS;
+        cmsg->cmsg_len = CMSG_LEN(chunk * sizeof(int));
+        std::memcpy(CMSG_DATA(cmsg), fds.data() + offset, chunk * sizeof(int));
+
+        ssize_t n;
+        do {
+            n = ::sendmsg(socket, &msg, MSG_NOSIGNAL);
+        } while (n < 0 && errno == EINTR);
+        if (n != 1) {
+            return Err<void>(ErrorCode::NetworkSendFailed,
+                std::format("Передача сокетов (SCM_RIGHTS): {}", std::strerror(errno)));
+        }
+    }
+    return {};
+}
+
+Result<std::vector<int>> receive_descriptors(int socket, std::size_t count, uint32_t timeout_ms) {
+    std::vector<int> fds;
+    fds.reserve(count);
+    auto fail = [&](ErrorCode code, std::string message) {
+        close_all(fds);
+        return Err<std::vector<int>>(code, std::move(message));
+    };
+
+    std::vector<uint8_t> control(CMSG_SPACE(HANDOFF_FDS_PER_MESSAGE * sizeof(int)));
+    while (fds.size() < count) {
+        const std::size_t expected = std::min(HANDOFF_FDS_PER_MESSAGE, count - fds.size());
+        if (!wait_for(socket, POLLIN, timeout_ms)) {
+            return fail(ErrorCode::NetworkTimeout, "Нет очередной пачки сокетов");
+        }
+
+        uint8_t marker = 0;
+        iovec iov{&marker, 1};
+        msghdr msg{};
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = control.data();
+        msg.msg_controllen = control.size();
+
+        ssize_t n = ::recvmsg(socket, &msg, MSG_CMSG_CLOEXEC | MSG_DONTWAIT);
+        if (n < 0 && (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK)) {
+            continue;
+        }
+        if (n != 1) {
+            return fail(ErrorCode::NetworkRecvFailed, "Соединение передачи закрыто");
+        }
+
+        std::size_t received = 0;
+        for (cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+            if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS) {
+                continue;
+            }
+            const std::size_t in_message = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+            for (std::size_t i = 0; i < in_message; ++i) {
+                int fd;
+                std::memcpy(&fd, CMSG_DATA(cmsg) + i * sizeof(int), sizeof(int));
+                fds.push_back(fd);
+            }
+            received += in_message;
+        }
+        if ((msg.msg_flags & MSG_CTRUNC) != 0 || received != expected || marker != expected) {
+            return fail(ErrorCode::NetworkRecvFailed,
+                std::format("Пачка сокетов: ожидалось {}, получено {} (лимит RLIMIT_NOFILE?)",
+                            expected, received));
+        }
+    }
+    return fds;
+}
+
+// =============================================================================
+// HandoffListener
+// =============================================================================
+
+struct HandoffListener::Impl {
+    HandoffConfig config;
+    int listen_fd = -1;
+    int peer_fd = -1;
+    bool path_owned = false;
+
+    explicit Impl(const HandoffConfig& cfg) : config(cfg) {}
+
+    void release_path() {
+        close_fd(listen_fd);
+        if (path_owned) {
+            ::unlink(config.socket_path.c_str());
+            path_owned = false;
+        }
+    }
+};
+
+HandoffListener::HandoffListener(const HandoffConfig& config)
+    : impl_(std::make_unique<Impl>(config)) {}
+
+HandoffListener::~HandoffListener() {
+    stop();
+}
+
+Result<void> HandoffListener::start() {
+    if (impl_->listen_fd >= 0) {
+        return {};
+    }
+    sockaddr_un addr;
+    if (!make_address(impl_->config.socket_path, addr)) {
+        return Err<void>(ErrorCode::ConfigInvalidValue,
+                         "handoff.socket_path: пустой или длиннее sun_path");
+    }
+
+    int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return Err<void>(ErrorCode::NetworkConnectionFailed,
+                         std::format("Сокет передачи: {}", std::strerror(errno)));
+    }
+    // Файл остался от прежнего процесса (его сокет уже закрыт)
+    ::unlink(impl_->config.socket_path.c_str());
+    if (::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 || ::listen(fd, 1) < 0) {
+        const int err = errno;
+        ::close(fd);
+        return Err<void>(ErrorCode::NetworkConnectionFailed,
+            std::format("Сокет передачи {}: {}", impl_->config.socket_path, std::strerror(err)));
+    }
+    impl_->listen_fd = fd;
+    impl_->path_owned = true;
+    return {};
+}
+
+void HandoffListener::stop() {
+    close_fd(impl_->peer_fd);
+    impl_->release_path();
+}
+
+bool HandoffListener::poll_request() {
+    if (impl_->listen_fd < 0) {
+        return false;
+    }
+    int fd = ::accept4(impl_->listen_fd, nullptr, nullptr, SOCK_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+
+    // Запрос приходит сразу за connect()
+    uint8_t request[REQUEST_SIZE];
+    if (!recv_exact(fd, request, sizeof(request), impl_->config.timeout_ms) ||
+        read_le32(request) != HANDOFF_MAGIC || read_le32(request + 4) != HANDOFF_VERSION) {
+        ::close(fd);
+        return false;
+    }
+
+    close_fd(impl_->peer_fd);
+    impl_->peer_fd = fd;
+    impl_->release_path();
+    return true;
+}
+
+Result<void> HandoffListener::transfer(const HandoffPackage& package) {
+    if (impl_->peer_fd < 0) {
+        return Err<void>(ErrorCode::NetworkConnectionFailed, "Нет запроса преемника");
+    }
+    const int fd = impl_->peer_fd;
+    const uint32_t timeout_ms = impl_->config.timeout_ms;
+    auto fail = [this](ErrorCode code, std::string message) {
+        close_fd(impl_->peer_fd);
+        return Err<void>(code, std::move(message));
+    };
+
+    const Bytes snapshot = encode_handoff(package);
+    if (snapshot.size() > HANDOFF_MAX_SNAPSHOT) {
+        return fail(ErrorCode::NetworkSendFailed,
+                    std::format("Снимок передачи слишком велик: {} байт", snapshot.size()));
+    }
+    const auto fds = package.descriptors();
+
+    uint8_t header[HEADER_SIZE];
+    write_le32(header, HANDOFF_MAGIC);
+    write_le32(header + 4, HANDOFF_VERSION);
+    write_le32(header + 8, static_cast<uint32_t>(fds.size()));
+    write_le32(header + 12, static_cast<uint32_t>(snapshot.size()));
+    if (!send_all(fd, ByteSpan(header, sizeof(header)), timeout_ms)) {
+        return fail(ErrorCode::NetworkSendFailed, "Преемник закрыл соединение передачи");
+    }
+    auto sent = send_descriptors(fd, fds);
+    if (!sent) {
+        return fail(sent.error().code, sent.error().message);
+    }
+    if (!send_all(fd, snapshot, timeout_ms)) {
+        return fail(ErrorCode::NetworkSendFailed, "Снимок передачи не отправлен");
+    }
+
+    // Преемник подтверждает после запуска сервера на полученных сокетах
+    uint8_t ack = 0;
+    if (!recv_exact(fd, &ack, 1, timeout_ms) || ack != ACK_BYTE) {
+        return fail(ErrorCode::NetworkTimeout,
+                    std::format("Преемник не подтвердил запуск за {} мс", timeout_ms));
+    }
+    close_fd(impl_->peer_fd);
+    return {};
+}
+
+// =============================================================================
+// HandoffClient
+// =============================================================================
+
+struct HandoffClient::Impl {
+    HandoffConfig config;
+    int fd = -1;
+
+    explicit Impl(const HandoffConfig& cfg) : config(cfg) {}
+};
+
+HandoffClient::HandoffClient(const HandoffConfig& config)
+    : impl_(std::make_unique<Impl>(config)) {}
+
+HandoffClient::~HandoffClient() {
+    close_fd(impl_->fd);
+}
+
+Result<std::optional<HandoffPackage>> HandoffClient::receive() {
+    using Received = std::optional<HandoffPackage>;
+
+    sockaddr_un addr;
+    if (!make_address(impl_->config.socket_path, addr)) {
+        return Err<Received>(ErrorCode::ConfigInvalidValue,
+                             "handoff.socket_path: пустой или длиннее sun_path");
+    }
+    close_fd(impl_->fd);
+    impl_->fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (impl_->fd < 0) {
+        return Err<Received>(ErrorCode::NetworkConnectionFailed,
+                             std::format("Сокет передачи: {}", std::strerror(errno)));
+    }
+    if (::connect(impl_->fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        const int err = errno;
+        close_fd(impl_->fd);
+        if (err == ENOENT || err == ECONNREFUSED) {
+            return Received{};  // Прежнего процесса нет - обычный запуск
+        }
+        return Err<Received>(ErrorCode::NetworkConnectionFailed,
+            std::format("Сокет передачи {}: {}", impl_->config.socket_path, std::strerror(err)));
+    }
+
+    const int fd = impl_->fd;
+    const uint32_t timeout_ms = impl_->config.timeout_ms;
+    auto fail = [this](ErrorCode code, std::string message) {
+        close_fd(impl_->fd);
+        return Err<Received>(code, std::move(message));
+    };
+
+    uint8_t request[REQUEST_SIZE];
+    write_le32(request, HANDOFF_MAGIC);
+    write_le32(request + 4, HANDOFF_VERSION);
+    if (!send_all(fd, ByteSpan(request, sizeof(request)), timeout_ms)) {
+        return fail(ErrorCode::NetworkSendFailed, "Запрос передачи не отправлен");
+    }
+
+    // Прежний процесс отвечает после остановки своего сервера
+    uint8_t header[HEADER_SIZE];
+    if (!recv_exact(fd, header, sizeof(header), timeout_ms)) {
+        return fail(ErrorCode::NetworkTimeout, "Прежний процесс не начал передачу");
+    }
+    if (read_le32(header) != HANDOFF_MAGIC || read_le32(header + 4) != HANDOFF_VERSION) {
+        return fail(ErrorCode::NetworkRecvFailed, "Заголовок передачи другой версии");
+    }
+    const uint32_t fd_count = read_le32(header + 8);
+    const uint32_t snapshot_size = read_le32(header + 12);
+    if (snapshot_size > HANDOFF_MAX_SNAPSHOT) {
+        return fail(ErrorCode::NetworkRecvFailed,
+                    std::format("Снимок передачи слишком велик: {} байт", snapshot_size));
+    }
+
+    auto fds = receive_descriptors(fd, fd_count, timeout_ms);
+    if (!fds) {
+        return fail(fds.error().code, fds.error().message);
+    }
+    Bytes snapshot(snapshot_size);
+    if (!recv_exact(fd, snapshot.data(), snapshot.size(), timeout_ms)) {
+        close_all(*fds);
+        return fail(ErrorCode::NetworkTimeout, "Снимок передачи не дочитан");
+    }
+
+    auto package = decode_handoff(snapshot, *fds);
+    if (!package) {
+        close_all(*fds);
+        return fail(package.error().code, package.error().message);
+    }
+    return Received{std::move(*package)};
+}
+
+Result<void> HandoffClient::acknowledge() {
+    if (impl_->fd < 0) {
+        return Err<void>(ErrorCode::NetworkConnectionFailed, "Нет соединения передачи");
+    }
+    const uint8_t ack = ACK_BYTE;
+    const bool sent = send_all(impl_->fd, ByteSpan(&ack, 1), impl_->config.timeout_ms);
+    close_fd(impl_->fd);
+    if (!sent) {
+        return Err<void>(ErrorCode::NetworkSendFailed, "Подтверждение передачи не отправлено");
+    }
+    return {};
+}
+
+} // namespace quaxis::network
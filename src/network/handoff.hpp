@@ -0,0 +1,199 @@
+/**
+ * @file handoff.hpp
+ * @brief Передача работы новому бинарнику без переподключения ASIC
+ *
+ * Перезапуск ради новой сборки рвёт все соединения ASIC: extranonce и
+ * задания теряются, весь парк переподключается разом. С [handoff]
+ * работающий процесс слушает unix сокет; новый процесс при запуске
+ * подключается к нему и забирает работу:
+ *
+ * 1. новый -> прежний: запрос (magic + версия);
+ * 2. прежний останавливает приём (Server::detach_for_handoff) и шлёт
+ *    заголовок (magic, версия, число дескрипторов, длина снимка),
+ *    дескрипторы пачками по HANDOFF_FDS_PER_MESSAGE (SCM_RIGHTS) -
+ *    сначала listening сокеты, затем соединения - и снимок;
+ * 3. новый процесс запускает сервер на полученных сокетах и отвечает
+ *    подтверждением; прежний закрывает свои копии сокетов (без
+ *    shutdown) и завершается.
+ *
+ * Снимок: соединения (адрес, ID, токен сессии, неразобранные и
+ * неотправленные байты), припаркованные сессии, шаблон (раскладка
+ * кадра Template фида), задания текущего поколения, аренды extranonce
+ * и счётчики. Задания копируются как есть (Job тривиально копируем):
+ * при другом sizeof(Job) в новой сборке они не переносятся, и ASIC
+ * получают новые задания с прежними extranonce.
+ *
+ * Нет подтверждения за timeout_ms - прежний процесс возвращает сокеты
+ * своему серверу (Server::resume) и продолжает работу.
+ */
+
+#pragma once
+
+#include "server.hpp"
+#include "../core/types.hpp"
+#include "../core/config.hpp"
+#include "../mining/job_manager.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace quaxis::network {
+
+// =============================================================================
+// Протокол передачи
+// =============================================================================
+
+/// @brief Сигнатура запроса и заголовка ("QXHO")
+inline constexpr uint32_t HANDOFF_MAGIC = 0x4F485851;
+
+/// @brief Версия формата снимка
+inline constexpr uint32_t HANDOFF_VERSION = 1;
+
+/// @brief Дескрипторов в одном сообщении SCM_RIGHTS (ядро: SCM_MAX_FD = 253)
+inline constexpr std::size_t HANDOFF_FDS_PER_MESSAGE = 250;
+
+/// @brief Наибольший снимок (задания и аренды 10 тыс. ASIC - единицы МБ)
+inline constexpr std::size_t HANDOFF_MAX_SNAPSHOT = 256 * 1024 * 1024;
+
+/**
+ * @brief Всё, что переходит к новому процессу
+ */
+struct HandoffPackage {
+    ServerHandoff server;
+    mining::JobHandoff jobs;
+
+    /**
+     * @brief Дескрипторы в порядке передачи: listening, затем соединения
+     */
+    [[nodiscard]] std::vector<int> descriptors() const;
+
+    /**
+     * @brief Закрыть все дескрипторы (close без shutdown)
+     *
+     * Сокеты живут, пока открыта копия в другом процессе.
+     */
+    void close_descriptors() noexcept;
+};
+
+/**
+ * @brief Снимок без дескрипторов
+ */
+[[nodiscard]] Bytes encode_handoff(const HandoffPackage& package);
+
+/**
+ * @brief Разобрать снимок и разложить полученные дескрипторы
+ *
+ * @param snapshot Байты encode_handoff()
+ * @param fds Дескрипторы в порядке HandoffPackage::descriptors()
+ * @return Result<HandoffPackage> Ошибка - снимок повреждён или число
+ *         дескрипторов не совпадает (дескрипторы не закрываются)
+ */
+[[nodiscard]] Result<HandoffPackage> decode_handoff(ByteSpan snapshot, std::span<const int> fds);
+
+/**
+ * @brief Отправить дескрипторы (пачками по HANDOFF_FDS_PER_MESSAGE)
+ *
+ * @param socket Unix сокет (SOCK_STREAM)
+ */
+[[nodiscard]] Result<void> send_descriptors(int socket, std::span<const int> fds);
+
+/**
+ * @brief Принять count дескрипторов send_descriptors()
+ *
+ * @param timeout_ms Ожидание каждой пачки
+ * @return Result<std::vector<int>> При ошибке принятые уже закрыты
+ */
+[[nodiscard]] Result<std::vector<int>> receive_descriptors(int socket, std::size_t count, uint32_t timeout_ms);
+
+// =============================================================================
+// Прежний процесс
+// =============================================================================
+
+/**
+ * @brief Unix сокет, на котором работающий процесс ждёт преемника
+ *
+ * Запрос проверяется из основного цикла (poll_request), передача идёт
+ * в том же потоке: подсистемы останавливает и возобновляет main.
+ */
+class HandoffListener {
+public:
+    explicit HandoffListener(const HandoffConfig& config);
+    ~HandoffListener();
+
+    HandoffListener(const HandoffListener&) = delete;
+    HandoffListener& operator=(const HandoffListener&) = delete;
+
+    /**
+     * @brief Занять socket_path (прежний файл сокета удаляется)
+     */
+    [[nodiscard]] Result<void> start();
+
+    /**
+     * @brief Закрыть сокет и удалить файл
+     */
+    void stop();
+
+    /**
+     * @brief Пришёл запрос преемника? (не блокирует)
+     *
+     * С принятым запросом файл сокета удаляется: преемник займёт путь
+     * после подтверждения. Если передача не удастся, start() снова.
+     */
+    [[nodiscard]] bool poll_request();
+
+    /**
+     * @brief Передать работу преемнику и дождаться подтверждения
+     *
+     * @return Result<void> Успех - сокеты у преемника, можно
+     *         закрыть свои копии и завершаться; ошибка - вернуть их серверу
+     */
+    [[nodiscard]] Result<void> transfer(const HandoffPackage& package);
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+// =============================================================================
+// Новый процесс
+// =============================================================================
+
+/**
+ * @brief Запрос работы у прежнего процесса
+ */
+class HandoffClient {
+public:
+    explicit HandoffClient(const HandoffConfig& config);
+
+    /// @brief Без acknowledge() прежний процесс продолжит работу
+    ~HandoffClient();
+
+    HandoffClient(const HandoffClient&) = delete;
+    HandoffClient& operator=(const HandoffClient&) = delete;
+
+    /**
+     * @brief Подключиться к прежнему процессу и получить его работу
+     *
+     * @return Result<std::optional<HandoffPackage>> nullopt - прежнего
+     *         процесса нет (сокета нет или никто не слушает); ошибка -
+     *         передача сорвалась, прежний процесс продолжает работу
+     */
+    [[nodiscard]] Result<std::optional<HandoffPackage>> receive();
+
+    /**
+     * @brief Подтвердить запуск на полученных сокетах
+     *
+     * После подтверждения прежний процесс завершается.
+     */
+    [[nodiscard]] Result<void> acknowledge();
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace quaxis::network
@@ -6,6 +6,7 @@
 #include "protocol.hpp"
 #include "../core/byte_order.hpp"
 
+#include <algorithm>
 #include <cstring>
 
 namespace quaxis::network {
@@ -15,6 +16,12 @@ namespace quaxis::network {
 // =============================================================================
 
 Bytes NewJobMessage::serialize() const {
+    if (!is_plain()) {
+        AnyJobFrame frame;
+        std::size_t size = encode_any(frame);
+        return Bytes(frame.begin(), frame.begin() + static_cast<std::ptrdiff_t>(size));
+    }
+    
     Bytes data;
     data.reserve(1 + constants::JOB_MESSAGE_SIZE);
     
@@ -28,14 +35,199 @@ Bytes NewJobMessage::serialize() const {
     return data;
 }
 
-Result<NewJobMessage> NewJobMessage::deserialize(ByteSpan data) {
+void NewJobMessage::encode(std::span<uint8_t, NEW_JOB_FRAME_SIZE> out) const noexcept {
+    auto job_data = job.serialize();
+    encode_new_job(job_data, out);
+}
+
+void NewJobMessage::encode_queued(std::span<uint8_t, NEW_JOB_FRAME_SIZE> out) const noexcept {
+    encode(out);
+    out[0] = static_cast<uint8_t>(Command::QueueJob);
+}
+
+std::size_t NewJobMessage::encode_any(std::span<uint8_t, MAX_JOB_FRAME_SIZE> out) const noexcept {
+    if (has_rolling()) {
+        uint8_t* ptr = out.data();
+        ptr[0] = static_cast<uint8_t>(Command::NewJobRoll);
+        write_le32(ptr + 1, job.job_id);
+        write_le32(ptr + 5, job.version);
+        ptr += 9;
+        
+        std::memcpy(ptr, job.prev_block.data(), job.prev_block.size());
+        ptr += job.prev_block.size();
+        std::memcpy(ptr, job.merkle_root.data(), job.merkle_root.size());
+        ptr += job.merkle_root.size();
+        
+        write_le32(ptr, job.timestamp);
+        write_le32(ptr + 4, job.bits);
+        write_le32(ptr + 8, job.version_mask);
+        
+        return NEW_JOB_ROLL_FRAME_SIZE;
+    }
+    
+    if (has_lease()) {
+        uint8_t* ptr = out.data();
+        ptr[0] = static_cast<uint8_t>(Command::NewJobLease);
+        write_le32(ptr + 1, job.job_id);
+        write_le32(ptr + 5, job.version);
+        ptr += 9;
+        
+        std::memcpy(ptr, job.prev_block.data(), job.prev_block.size());
+        ptr += job.prev_block.size();
+        
+        auto midstate_bytes = crypto::state_to_bytes(job.coinbase_midstate);
+        std::memcpy(ptr, midstate_bytes.data(), midstate_bytes.size());
+        ptr += midstate_bytes.size();
+        
+        // Хвост coinbase: extranonce начала диапазона в первых 6 байтах
+        std::memcpy(ptr, job.coinbase_tail.data(), job.coinbase_tail.size());
+        ptr += job.coinbase_tail.size();
+        
+        write_le32(ptr, job.timestamp);
+        write_le32(ptr + 4, job.bits);
+        write_le32(ptr + 8, job.extranonce_lease);
+        
+        return NEW_JOB_LEASE_FRAME_SIZE;
+    }
+    
+    if (!has_slots()) {
+        encode(out.first<NEW_JOB_FRAME_SIZE>());
+        return NEW_JOB_FRAME_SIZE;
+    }
+    
+    std::size_t count = std::min<std::size_t>(job.version_count, constants::MAX_VERSION_SLOTS);
+    uint8_t* ptr = out.data();
+    
+    ptr[0] = static_cast<uint8_t>(Command::NewJobSlots);
+    ptr[1] = static_cast<uint8_t>(count);
+    ptr += 2;
+    
+    // Общий хвост: merkle_root[28:32] + timestamp + bits
+    std::memcpy(ptr, job.merkle_tail.data(), job.merkle_tail.size());
+    write_le32(ptr + 4, job.timestamp);
+    write_le32(ptr + 8, job.bits);
+    write_le32(ptr + 12, job.nonce);
+    write_le32(ptr + 16, job.job_id);
+    ptr += NEW_JOB_SLOTS_HEADER_SIZE - 2;
+    
+    for (std::size_t i = 0; i < count; ++i) {
+        write_le32(ptr, job.versions[i]);
+        auto midstate_bytes = crypto::state_to_bytes(job.version_midstates[i]);
+        std::memcpy(ptr + 4, midstate_bytes.data(), midstate_bytes.size());
+        ptr += NEW_JOB_SLOT_SIZE;
+    }
+    
+    return NEW_JOB_SLOTS_HEADER_SIZE + count * NEW_JOB_SLOT_SIZE;
+}
+
+FastResult<NewJobMessage> NewJobMessage::deserialize_slots(ByteSpan data) {
+    if (data.size() < NEW_JOB_SLOTS_HEADER_SIZE - 1) {
+        return FastErr<NewJobMessage>(ErrorCode::NetworkRecvFailed, "Недостаточно данных для NewJobSlots");
+    }
+    
+    std::size_t count = data[0];
+    if (count < 2 || count > constants::MAX_VERSION_SLOTS) {
+        return FastErr<NewJobMessage>(ErrorCode::NetworkRecvFailed, "Некорректное число слотов NewJobSlots");
+    }
+    if (data.size() < NEW_JOB_SLOTS_HEADER_SIZE - 1 + count * NEW_JOB_SLOT_SIZE) {
+        return FastErr<NewJobMessage>(ErrorCode::NetworkRecvFailed, "Недостаточно данных для слотов NewJobSlots");
+    }
+    
+    NewJobMessage msg;
+    const uint8_t* ptr = data.data() + 1;
+    std::memcpy(msg.job.merkle_tail.data(), ptr, msg.job.merkle_tail.size());
+    msg.job.timestamp = read_le32(ptr + 4);
+    msg.job.bits = read_le32(ptr + 8);
+    msg.job.nonce = read_le32(ptr + 12);
+    msg.job.job_id = read_le32(ptr + 16);
+    ptr += NEW_JOB_SLOTS_HEADER_SIZE - 2;
+    
+    msg.job.version_count = static_cast<uint8_t>(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        msg.job.versions[i] = read_le32(ptr);
+        crypto::Sha256Midstate midstate_bytes;
+        std::memcpy(midstate_bytes.data(), ptr + 4, midstate_bytes.size());
+        msg.job.version_midstates[i] = crypto::bytes_to_state(midstate_bytes);
+        ptr += NEW_JOB_SLOT_SIZE;
+    }
+    msg.job.midstate = msg.job.version_midstates[0];
+    
+    return msg;
+}
+
+FastResult<NewJobMessage> NewJobMessage::deserialize_lease(ByteSpan data) {
+    if (data.size() < NEW_JOB_LEASE_FRAME_SIZE - 1) {
+        return FastErr<NewJobMessage>(ErrorCode::NetworkRecvFailed, "Недостаточно данных для NewJobLease");
+    }
+    
+    NewJobMessage msg;
+    const uint8_t* ptr = data.data();
+    msg.job.job_id = read_le32(ptr);
+    msg.job.version = read_le32(ptr + 4);
+    ptr += 8;
+    
+    std::memcpy(msg.job.prev_block.data(), ptr, msg.job.prev_block.size());
+    ptr += msg.job.prev_block.size();
+    
+    crypto::Sha256Midstate midstate_bytes;
+    std::memcpy(midstate_bytes.data(), ptr, midstate_bytes.size());
+    msg.job.coinbase_midstate = crypto::bytes_to_state(midstate_bytes);
+    ptr += midstate_bytes.size();
+    
+    std::memcpy(msg.job.coinbase_tail.data(), ptr, msg.job.coinbase_tail.size());
+    ptr += msg.job.coinbase_tail.size();
+    
+    msg.job.timestamp = read_le32(ptr);
+    msg.job.bits = read_le32(ptr + 4);
+    msg.job.extranonce_lease = read_le32(ptr + 8);
+    if (msg.job.extranonce_lease < 2) {
+        return FastErr<NewJobMessage>(ErrorCode::NetworkRecvFailed, "Некорректный размер аренды NewJobLease");
+    }
+    
+    // Начало диапазона - extranonce в хвосте coinbase
+    for (std::size_t i = 0; i < constants::EXTRANONCE_SIZE; ++i) {
+        msg.job.extranonce |= static_cast<uint64_t>(msg.job.coinbase_tail[i]) << (i * 8);
+    }
+    
+    return msg;
+}
+
+FastResult<NewJobMessage> NewJobMessage::deserialize_roll(ByteSpan data) {
+    if (data.size() < NEW_JOB_ROLL_FRAME_SIZE - 1) {
+        return FastErr<NewJobMessage>(ErrorCode::NetworkRecvFailed, "Недостаточно данных для NewJobRoll");
+    }
+    
+    NewJobMessage msg;
+    const uint8_t* ptr = data.data();
+    msg.job.job_id = read_le32(ptr);
+    msg.job.version = read_le32(ptr + 4);
+    ptr += 8;
+    
+    std::memcpy(msg.job.prev_block.data(), ptr, msg.job.prev_block.size());
+    ptr += msg.job.prev_block.size();
+    std::memcpy(msg.job.merkle_root.data(), ptr, msg.job.merkle_root.size());
+    ptr += msg.job.merkle_root.size();
+    
+    msg.job.timestamp = read_le32(ptr);
+    msg.job.bits = read_le32(ptr + 4);
+    msg.job.version_mask = read_le32(ptr + 8);
+    if (msg.job.version_mask == 0) {
+        return FastErr<NewJobMessage>(ErrorCode::NetworkRecvFailed, "Пустая маска версий NewJobRoll");
+    }
+    
+    std::memcpy(msg.job.merkle_tail.data(), msg.job.merkle_root.data() + 28, msg.job.merkle_tail.size());
+    
+    return msg;
+}
+
+FastResult<NewJobMessage> NewJobMessage::deserialize(ByteSpan data) {
     if (data.size() < constants::JOB_MESSAGE_SIZE) {
-        return Err<NewJobMessage>(ErrorCode::NetworkRecvFailed, "Недостаточно данных для NewJob");
+        return FastErr<NewJobMessage>(ErrorCode::NetworkRecvFailed, "Недостаточно данных для NewJob");
     }
     
     auto job_result = mining::Job::deserialize(data);
     if (!job_result) {
-        return Err<NewJobMessage>(job_result.error().code, job_result.error().message);
+        return std::unexpected(job_result.error());
     }
     
     return NewJobMessage{*job_result};
@@ -46,6 +238,33 @@ Result<NewJobMessage> NewJobMessage::deserialize(ByteSpan data) {
 // =============================================================================
 
 Bytes ShareMessage::serialize() const {
+    if (share.version != 0) {
+        Bytes data(SHARE_ROLLED_FRAME_SIZE);
+        data[0] = static_cast<uint8_t>(Response::ShareRolled);
+        write_le32(data.data() + 1, share.job_id);
+        write_le32(data.data() + 5, share.nonce);
+        write_le32(data.data() + 9, share.version);
+        return data;
+    }
+    
+    if (share.extranonce_offset != 0) {
+        Bytes data(SHARE_LEASED_FRAME_SIZE);
+        data[0] = static_cast<uint8_t>(Response::ShareLeased);
+        write_le32(data.data() + 1, share.job_id);
+        write_le32(data.data() + 5, share.nonce);
+        write_le32(data.data() + 9, share.extranonce_offset);
+        return data;
+    }
+    
+    if (share.version_slot != 0) {
+        Bytes data(SHARE_SLOT_FRAME_SIZE);
+        data[0] = static_cast<uint8_t>(Response::ShareSlot);
+        write_le32(data.data() + 1, share.job_id);
+        write_le32(data.data() + 5, share.nonce);
+        data[9] = share.version_slot;
+        return data;
+    }
+    
     Bytes data;
     data.reserve(1 + constants::SHARE_MESSAGE_SIZE);
     
@@ -59,14 +278,20 @@ Bytes ShareMessage::serialize() const {
     return data;
 }
 
-Result<ShareMessage> ShareMessage::deserialize(ByteSpan data) {
+void ShareMessage::encode(std::span<uint8_t, SHARE_FRAME_SIZE> out) const noexcept {
+    out[0] = static_cast<uint8_t>(Response::Share);
+    write_le32(out.data() + 1, share.job_id);
+    write_le32(out.data() + 5, share.nonce);
+}
+
+FastResult<ShareMessage> ShareMessage::deserialize(ByteSpan data) {
     if (data.size() < constants::SHARE_MESSAGE_SIZE) {
-        return Err<ShareMessage>(ErrorCode::NetworkRecvFailed, "Недостаточно данных для Share");
+        return FastErr<ShareMessage>(ErrorCode::NetworkRecvFailed, "Недостаточно данных для Share");
     }
     
     auto share_result = mining::Share::deserialize(data);
     if (!share_result) {
-        return Err<ShareMessage>(share_result.error().code, share_result.error().message);
+        return std::unexpected(share_result.error());
     }
     
     return ShareMessage{*share_result};
@@ -97,6 +322,216 @@ Result<SetTargetMessage> SetTargetMessage::deserialize(ByteSpan data) {
     return msg;
 }
 
+// =============================================================================
+// SetDifficultyMessage
+// =============================================================================
+
+Bytes SetDifficultyMessage::serialize() const {
+    Bytes data(SET_DIFFICULTY_FRAME_SIZE);
+    
+    data[0] = static_cast<uint8_t>(Command::SetDifficulty);
+    write_le32(data.data() + 1, difficulty);
+    
+    return data;
+}
+
+Result<SetDifficultyMessage> SetDifficultyMessage::deserialize(ByteSpan data) {
+    if (data.size() < SET_DIFFICULTY_FRAME_SIZE - 1) {
+        return Err<SetDifficultyMessage>(ErrorCode::NetworkRecvFailed, "Недостаточно данных для SetDifficulty");
+    }
+    
+    SetDifficultyMessage msg;
+    msg.difficulty = read_le32(data.data());
+    
+    return msg;
+}
+
+// =============================================================================
+// UpdateTimeMessage
+// =============================================================================
+
+Bytes UpdateTimeMessage::serialize() const {
+    Bytes data(UPDATE_TIME_FRAME_SIZE);
+    encode(std::span<uint8_t, UPDATE_TIME_FRAME_SIZE>(data.data(), UPDATE_TIME_FRAME_SIZE));
+    return data;
+}
+
+void UpdateTimeMessage::encode(std::span<uint8_t, UPDATE_TIME_FRAME_SIZE> out) const noexcept {
+    out[0] = static_cast<uint8_t>(Command::UpdateTime);
+    write_le32(out.data() + 1, job_id);
+    write_le32(out.data() + 5, timestamp);
+    out[9] = nonce_start ? UPDATE_TIME_FLAG_NONCE : 0;
+    write_le32(out.data() + 10, nonce_start.value_or(0));
+}
+
+Result<UpdateTimeMessage> UpdateTimeMessage::deserialize(ByteSpan data) {
+    if (data.size() < UPDATE_TIME_FRAME_SIZE - 1) {
+        return Err<UpdateTimeMessage>(ErrorCode::NetworkRecvFailed, "Недостаточно данных для UpdateTime");
+    }
+    
+    UpdateTimeMessage msg;
+    msg.job_id = read_le32(data.data());
+    msg.timestamp = read_le32(data.data() + 4);
+    if (data[8] & UPDATE_TIME_FLAG_NONCE) {
+        msg.nonce_start = read_le32(data.data() + 9);
+    }
+    
+    return msg;
+}
+
+// =============================================================================
+// SetShareBatchMessage
+// =============================================================================
+
+Bytes SetShareBatchMessage::serialize() const {
+    Bytes data(SET_SHARE_BATCH_FRAME_SIZE);
+    
+    data[0] = static_cast<uint8_t>(Command::SetShareBatch);
+    data[1] = max_count;
+    write_le16(data.data() + 2, flush_ms);
+    
+    return data;
+}
+
+Result<SetShareBatchMessage> SetShareBatchMessage::deserialize(ByteSpan data) {
+    if (data.size() < SET_SHARE_BATCH_FRAME_SIZE - 1) {
+        return Err<SetShareBatchMessage>(ErrorCode::NetworkRecvFailed, "Недостаточно данных для SetShareBatch");
+    }
+    
+    SetShareBatchMessage msg;
+    msg.max_count = data[0];
+    msg.flush_ms = read_le16(data.data() + 1);
+    
+    return msg;
+}
+
+// =============================================================================
+// SetSessionMessage / HelloMessage
+// =============================================================================
+
+Bytes SetSessionMessage::serialize() const {
+    Bytes data(SET_SESSION_FRAME_SIZE);
+    data[0] = static_cast<uint8_t>(Command::SetSession);
+    write_le64(data.data() + 1, token);
+    return data;
+}
+
+Result<SetSessionMessage> SetSessionMessage::deserialize(ByteSpan data) {
+    if (data.size() < SET_SESSION_FRAME_SIZE - 1) {
+        return Err<SetSessionMessage>(ErrorCode::NetworkRecvFailed, "Недостаточно данных для SetSession");
+    }
+    return SetSessionMessage{read_le64(data.data())};
+}
+
+Bytes HelloMessage::serialize() const {
+    Bytes data(HELLO_FRAME_SIZE);
+    data[0] = static_cast<uint8_t>(Response::Hello);
+    write_le64(data.data() + 1, token);
+    write_le32(data.data() + 9, job_id);
+    return data;
+}
+
+Result<HelloMessage> HelloMessage::deserialize(ByteSpan data) {
+    if (data.size() < HELLO_FRAME_SIZE - 1) {
+        return Err<HelloMessage>(ErrorCode::NetworkRecvFailed, "Недостаточно данных для Hello");
+    }
+    return HelloMessage{read_le64(data.data()), read_le32(data.data() + 8)};
+}
+
+// =============================================================================
+// JobLoadedMessage
+// =============================================================================
+
+Bytes JobLoadedMessage::serialize() const {
+    Bytes data(JOB_LOADED_FRAME_SIZE);
+    data[0] = static_cast<uint8_t>(Response::JobLoaded);
+    write_le32(data.data() + 1, job_id);
+    write_le32(data.data() + 5, received_us);
+    write_le32(data.data() + 9, started_us);
+    return data;
+}
+
+Result<JobLoadedMessage> JobLoadedMessage::deserialize(ByteSpan data) {
+    if (data.size() < JOB_LOADED_FRAME_SIZE - 1) {
+        return Err<JobLoadedMessage>(ErrorCode::NetworkRecvFailed, "Недостаточно данных для JobLoaded");
+    }
+    return JobLoadedMessage{read_le32(data.data()), read_le32(data.data() + 4), read_le32(data.data() + 8)};
+}
+
+// =============================================================================
+// BlockNotifyMessage
+// =============================================================================
+
+BlockNotifyMessage BlockNotifyMessage::from_job(const mining::Job& job) {
+    BlockNotifyMessage msg;
+    msg.generation = job.generation;
+    msg.height = job.height;
+    msg.timestamp = job.timestamp;
+    msg.bits = job.bits;
+    if (job.is_speculative) {
+        msg.flags |= BLOCK_NOTIFY_FLAG_SPECULATIVE;
+    }
+    if (job.extranonce_lease > 1) {
+        msg.flags |= BLOCK_NOTIFY_FLAG_WORK;
+        msg.version = job.version;
+        msg.prev_block = job.prev_block;
+        msg.coinbase_midstate = job.coinbase_midstate;
+        msg.coinbase_tail = job.coinbase_tail;
+    }
+    return msg;
+}
+
+Bytes BlockNotifyMessage::serialize() const {
+    Bytes data(BLOCK_NOTIFY_FRAME_SIZE);
+    uint8_t* ptr = data.data();
+    ptr[0] = static_cast<uint8_t>(Command::BlockNotify);
+    write_le32(ptr + 1, generation);
+    write_le32(ptr + 5, height);
+    ptr[9] = flags;
+    write_le32(ptr + 10, version);
+    ptr += 14;
+    
+    std::memcpy(ptr, prev_block.data(), prev_block.size());
+    ptr += prev_block.size();
+    auto midstate_bytes = crypto::state_to_bytes(coinbase_midstate);
+    std::memcpy(ptr, midstate_bytes.data(), midstate_bytes.size());
+    ptr += midstate_bytes.size();
+    std::memcpy(ptr, coinbase_tail.data(), coinbase_tail.size());
+    ptr += coinbase_tail.size();
+    
+    write_le32(ptr, timestamp);
+    write_le32(ptr + 4, bits);
+    return data;
+}
+
+Result<BlockNotifyMessage> BlockNotifyMessage::deserialize(ByteSpan data) {
+    if (data.size() < BLOCK_NOTIFY_FRAME_SIZE ||
+        data[0] != static_cast<uint8_t>(Command::BlockNotify)) {
+        return Err<BlockNotifyMessage>(ErrorCode::NetworkRecvFailed, "Некорректная датаграмма BlockNotify");
+    }
+    
+    BlockNotifyMessage msg;
+    const uint8_t* ptr = data.data();
+    msg.generation = read_le32(ptr + 1);
+    msg.height = read_le32(ptr + 5);
+    msg.flags = ptr[9];
+    msg.version = read_le32(ptr + 10);
+    ptr += 14;
+    
+    std::memcpy(msg.prev_block.data(), ptr, msg.prev_block.size());
+    ptr += msg.prev_block.size();
+    crypto::Sha256Midstate midstate_bytes;
+    std::memcpy(midstate_bytes.data(), ptr, midstate_bytes.size());
+    msg.coinbase_midstate = crypto::bytes_to_state(midstate_bytes);
+    ptr += midstate_bytes.size();
+    std::memcpy(msg.coinbase_tail.data(), ptr, msg.coinbase_tail.size());
+    ptr += msg.coinbase_tail.size();
+    
+    msg.timestamp = read_le32(ptr);
+    msg.bits = read_le32(ptr + 4);
+    return msg;
+}
+
 // =============================================================================
 // StatusMessage
 // =============================================================================
@@ -171,6 +606,36 @@ Result<ErrorMessage> ErrorMessage::deserialize(ByteSpan data) {
     return msg;
 }
 
+// =============================================================================
+// TelemetryMessage
+// =============================================================================
+
+Bytes TelemetryMessage::serialize() const {
+    Bytes data(TELEMETRY_HEADER_SIZE);
+    data[0] = static_cast<uint8_t>(Response::Telemetry);
+    write_le16(data.data() + 1, static_cast<uint16_t>(payload.size()));
+    data.insert(data.end(), payload.begin(), payload.end());
+    return data;
+}
+
+Result<TelemetryMessage> TelemetryMessage::deserialize(ByteSpan data) {
+    if (data.size() < 2) {
+        return Err<TelemetryMessage>(ErrorCode::NetworkRecvFailed, "Недостаточно данных для Telemetry");
+    }
+    
+    std::size_t len = read_le16(data.data());
+    if (len > MAX_TELEMETRY_PAYLOAD) {
+        return Err<TelemetryMessage>(ErrorCode::NetworkRecvFailed, "Слишком длинный кадр Telemetry");
+    }
+    if (data.size() < 2 + len) {
+        return Err<TelemetryMessage>(ErrorCode::NetworkRecvFailed, "Недостаточно данных для Telemetry");
+    }
+    
+    TelemetryMessage msg;
+    msg.payload.assign(data.begin() + 2, data.begin() + 2 + static_cast<std::ptrdiff_t>(len));
+    return msg;
+}
+
 // =============================================================================
 // ProtocolParser
 // =============================================================================
@@ -180,6 +645,14 @@ void ProtocolParser::add_data(ByteSpan data) {
 }
 
 std::optional<ParsedMessage> ProtocolParser::try_parse() {
+    if (batch_remaining_ > 0) {
+        // Кадр RSP_SHARE_BATCH уже получен целиком
+        auto result = ShareMessage::deserialize(ByteSpan(buffer_.data(), constants::SHARE_MESSAGE_SIZE));
+        buffer_.erase(buffer_.begin(), buffer_.begin() + constants::SHARE_MESSAGE_SIZE);
+        --batch_remaining_;
+        return *result;
+    }
+    
     if (buffer_.empty()) {
         return std::nullopt;
     }
@@ -203,6 +676,58 @@ std::optional<ParsedMessage> ProtocolParser::try_parse() {
             break;
         }
         
+        case Response::ShareSlot: {
+            if (buffer_.size() < SHARE_SLOT_FRAME_SIZE) {
+                return std::nullopt;
+            }
+            
+            const uint8_t* p = buffer_.data() + 1;
+            ShareMessage msg{mining::Share{read_le32(p), read_le32(p + 4), p[8]}};
+            buffer_.erase(buffer_.begin(), buffer_.begin() + SHARE_SLOT_FRAME_SIZE);
+            return msg;
+        }
+        
+        case Response::ShareLeased: {
+            if (buffer_.size() < SHARE_LEASED_FRAME_SIZE) {
+                return std::nullopt;
+            }
+            
+            const uint8_t* p = buffer_.data() + 1;
+            ShareMessage msg{mining::Share{read_le32(p), read_le32(p + 4), 0, read_le32(p + 8)}};
+            buffer_.erase(buffer_.begin(), buffer_.begin() + SHARE_LEASED_FRAME_SIZE);
+            return msg;
+        }
+        
+        case Response::ShareRolled: {
+            if (buffer_.size() < SHARE_ROLLED_FRAME_SIZE) {
+                return std::nullopt;
+            }
+            
+            const uint8_t* p = buffer_.data() + 1;
+            ShareMessage msg{mining::Share{read_le32(p), read_le32(p + 4), 0, 0, read_le32(p + 8)}};
+            buffer_.erase(buffer_.begin(), buffer_.begin() + SHARE_ROLLED_FRAME_SIZE);
+            return msg;
+        }
+        
+        case Response::ShareBatch: {
+            if (buffer_.size() < SHARE_BATCH_HEADER_SIZE) {
+                return std::nullopt;
+            }
+            
+            std::size_t count = buffer_[1];
+            if (count == 0 || count > SHARE_BATCH_MAX) {
+                buffer_.erase(buffer_.begin());  // Некорректный заголовок
+                break;
+            }
+            if (buffer_.size() < SHARE_BATCH_HEADER_SIZE + count * constants::SHARE_MESSAGE_SIZE) {
+                return std::nullopt;
+            }
+            
+            buffer_.erase(buffer_.begin(), buffer_.begin() + SHARE_BATCH_HEADER_SIZE);
+            batch_remaining_ = count;
+            return try_parse();
+        }
+        
         case Response::Status: {
             if (buffer_.size() < 1 + 8) {
                 return std::nullopt;
@@ -219,6 +744,51 @@ std::optional<ParsedMessage> ProtocolParser::try_parse() {
             break;
         }
         
+        case Response::Telemetry: {
+            if (buffer_.size() < TELEMETRY_HEADER_SIZE) {
+                return std::nullopt;
+            }
+            
+            std::size_t len = read_le16(buffer_.data() + 1);
+            if (len > MAX_TELEMETRY_PAYLOAD) {
+                buffer_.erase(buffer_.begin());  // Некорректный заголовок
+                break;
+            }
+            if (buffer_.size() < TELEMETRY_HEADER_SIZE + len) {
+                return std::nullopt;
+            }
+            
+            auto result = TelemetryMessage::deserialize(
+                ByteSpan(buffer_.data() + 1, 2 + len)
+            );
+            buffer_.erase(buffer_.begin(), buffer_.begin() + static_cast<std::ptrdiff_t>(TELEMETRY_HEADER_SIZE + len));
+            if (result) {
+                return std::move(*result);
+            }
+            break;
+        }
+        
+        case Response::Hello: {
+            if (buffer_.size() < HELLO_FRAME_SIZE) {
+                return std::nullopt;
+            }
+            
+            HelloMessage msg{read_le64(buffer_.data() + 1), read_le32(buffer_.data() + 9)};
+            buffer_.erase(buffer_.begin(), buffer_.begin() + HELLO_FRAME_SIZE);
+            return msg;
+        }
+        
+        case Response::JobLoaded: {
+            if (buffer_.size() < JOB_LOADED_FRAME_SIZE) {
+                return std::nullopt;
+            }
+            
+            JobLoadedMessage msg{read_le32(buffer_.data() + 1), read_le32(buffer_.data() + 5),
+                                 read_le32(buffer_.data() + 9)};
+            buffer_.erase(buffer_.begin(), buffer_.begin() + JOB_LOADED_FRAME_SIZE);
+            return msg;
+        }
+        
         case Response::Heartbeat: {
             buffer_.erase(buffer_.begin());
             // Возвращаем пустой Status как heartbeat
@@ -260,6 +830,218 @@ std::size_t ProtocolParser::buffered_size() const {
 
 void ProtocolParser::clear() {
     buffer_.clear();
+    batch_remaining_ = 0;
+}
+
+// =============================================================================
+// FrameParser
+// =============================================================================
+
+std::size_t FrameParser::add_data(ByteSpan data) noexcept {
+    std::size_t count = std::min(data.size(), CAPACITY - buffered_size());
+    std::size_t pos = tail_ & (CAPACITY - 1);
+    
+    // Не больше двух копий: до конца кольца и с начала
+    std::size_t first = std::min(count, CAPACITY - pos);
+    std::memcpy(ring_.data() + pos, data.data(), first);
+    std::memcpy(ring_.data(), data.data() + first, count - first);
+    
+    tail_ += count;
+    return count;
+}
+
+Bytes FrameParser::take_buffered() {
+    Bytes data(buffered_size());
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        data[i] = peek(i);
+    }
+    clear();
+    return data;
+}
+
+const uint8_t* FrameParser::payload(
+    std::size_t size,
+    std::array<uint8_t, MAX_ERROR_FRAME_SIZE>& scratch
+) const noexcept {
+    std::size_t pos = (head_ + 1) & (CAPACITY - 1);
+    if (pos + size <= CAPACITY) {
+        return ring_.data() + pos;
+    }
+    
+    std::size_t first = CAPACITY - pos;
+    std::memcpy(scratch.data(), ring_.data() + pos, first);
+    std::memcpy(scratch.data() + first, ring_.data(), size - first);
+    return scratch.data();
+}
+
+std::optional<ParsedMessage> FrameParser::try_parse() {
+    // Тот же формат кадров, что и в ProtocolParser
+    std::array<uint8_t, MAX_ERROR_FRAME_SIZE> scratch;
+    
+    if (batch_remaining_ > 0) {
+        // Кадр RSP_SHARE_BATCH уже получен целиком: share без заголовка
+        std::array<uint8_t, constants::SHARE_MESSAGE_SIZE> bytes;
+        for (std::size_t i = 0; i < bytes.size(); ++i) {
+            bytes[i] = peek(i);
+        }
+        consume(constants::SHARE_MESSAGE_SIZE);
+        --batch_remaining_;
+        return ShareMessage{mining::Share{read_le32(bytes.data()), read_le32(bytes.data() + 4)}};
+    }
+    
+    while (buffered_size() > 0) {
+        auto response_type = static_cast<Response>(peek(0));
+        
+        switch (response_type) {
+            case Response::Share: {
+                if (buffered_size() < SHARE_FRAME_SIZE) {
+                    return std::nullopt;
+                }
+                
+                const uint8_t* p = payload(constants::SHARE_MESSAGE_SIZE, scratch);
+                ShareMessage msg{mining::Share{read_le32(p), read_le32(p + 4)}};
+                consume(SHARE_FRAME_SIZE);
+                return msg;
+            }
+            
+            case Response::ShareSlot: {
+                if (buffered_size() < SHARE_SLOT_FRAME_SIZE) {
+                    return std::nullopt;
+                }
+                
+                const uint8_t* p = payload(SHARE_SLOT_FRAME_SIZE - 1, scratch);
+                ShareMessage msg{mining::Share{read_le32(p), read_le32(p + 4), p[8]}};
+                consume(SHARE_SLOT_FRAME_SIZE);
+                return msg;
+            }
+            
+            case Response::ShareLeased: {
+                if (buffered_size() < SHARE_LEASED_FRAME_SIZE) {
+                    return std::nullopt;
+                }
+                
+                const uint8_t* p = payload(SHARE_LEASED_FRAME_SIZE - 1, scratch);
+                ShareMessage msg{mining::Share{read_le32(p), read_le32(p + 4), 0, read_le32(p + 8)}};
+                consume(SHARE_LEASED_FRAME_SIZE);
+                return msg;
+            }
+            
+            case Response::ShareRolled: {
+                if (buffered_size() < SHARE_ROLLED_FRAME_SIZE) {
+                    return std::nullopt;
+                }
+                
+                const uint8_t* p = payload(SHARE_ROLLED_FRAME_SIZE - 1, scratch);
+                ShareMessage msg{mining::Share{read_le32(p), read_le32(p + 4), 0, 0, read_le32(p + 8)}};
+                consume(SHARE_ROLLED_FRAME_SIZE);
+                return msg;
+            }
+            
+            case Response::ShareBatch: {
+                if (buffered_size() < SHARE_BATCH_HEADER_SIZE) {
+                    return std::nullopt;
+                }
+                
+                std::size_t count = peek(1);
+                if (count == 0 || count > SHARE_BATCH_MAX) {
+                    consume(1);  // Некорректный заголовок
+                    break;
+                }
+                if (buffered_size() < SHARE_BATCH_HEADER_SIZE + count * constants::SHARE_MESSAGE_SIZE) {
+                    return std::nullopt;
+                }
+                
+                consume(SHARE_BATCH_HEADER_SIZE);
+                batch_remaining_ = count;
+                return try_parse();
+            }
+            
+            case Response::Status: {
+                if (buffered_size() < STATUS_FRAME_SIZE) {
+                    return std::nullopt;
+                }
+                
+                const uint8_t* p = payload(STATUS_FRAME_SIZE - 1, scratch);
+                StatusMessage msg{read_le32(p), p[4], p[5], read_le16(p + 6)};
+                consume(STATUS_FRAME_SIZE);
+                return msg;
+            }
+            
+            case Response::Telemetry: {
+                if (buffered_size() < TELEMETRY_HEADER_SIZE) {
+                    return std::nullopt;
+                }
+                
+                std::size_t len = static_cast<std::size_t>(peek(1)) | (static_cast<std::size_t>(peek(2)) << 8);
+                if (len > MAX_TELEMETRY_PAYLOAD) {
+                    consume(1);  // Некорректный заголовок
+                    break;
+                }
+                if (buffered_size() < TELEMETRY_HEADER_SIZE + len) {
+                    return std::nullopt;
+                }
+                
+                TelemetryMessage msg;
+                msg.payload.resize(len);
+                for (std::size_t i = 0; i < len; ++i) {
+                    msg.payload[i] = peek(TELEMETRY_HEADER_SIZE + i);
+                }
+                consume(TELEMETRY_HEADER_SIZE + len);
+                return msg;
+            }
+            
+            case Response::Hello: {
+                if (buffered_size() < HELLO_FRAME_SIZE) {
+                    return std::nullopt;
+                }
+                
+                const uint8_t* p = payload(HELLO_FRAME_SIZE - 1, scratch);
+                HelloMessage msg{read_le64(p), read_le32(p + 8)};
+                consume(HELLO_FRAME_SIZE);
+                return msg;
+            }
+            
+            case Response::JobLoaded: {
+                if (buffered_size() < JOB_LOADED_FRAME_SIZE) {
+                    return std::nullopt;
+                }
+                
+                const uint8_t* p = payload(JOB_LOADED_FRAME_SIZE - 1, scratch);
+                JobLoadedMessage msg{read_le32(p), read_le32(p + 4), read_le32(p + 8)};
+                consume(JOB_LOADED_FRAME_SIZE);
+                return msg;
+            }
+            
+            case Response::Heartbeat: {
+                consume(1);
+                // Возвращаем пустой Status как heartbeat
+                return StatusMessage{0, 0, 0, 0};
+            }
+            
+            case Response::Error: {
+                if (buffered_size() < 2) {
+                    return std::nullopt;
+                }
+                
+                std::size_t msg_len = std::min(buffered_size(), MAX_ERROR_FRAME_SIZE);
+                auto result = ErrorMessage::deserialize(
+                    ByteSpan(payload(msg_len - 1, scratch), msg_len - 1)
+                );
+                consume(msg_len);
+                if (result) {
+                    return *result;
+                }
+                break;
+            }
+            
+            default:
+                // Неизвестный тип - пропускаем байт
+                consume(1);
+                break;
+        }
+    }
+    
+    return std::nullopt;
 }
 
 // =============================================================================
@@ -271,6 +1053,86 @@ Bytes serialize_new_job(const mining::Job& job) {
     return msg.serialize();
 }
 
+void encode_new_job(
+    std::span<const uint8_t, constants::JOB_MESSAGE_SIZE> message,
+    std::span<uint8_t, NEW_JOB_FRAME_SIZE> out
+) noexcept {
+    out[0] = static_cast<uint8_t>(Command::NewJob);
+    std::memcpy(out.data() + 1, message.data(), message.size());
+}
+
+std::optional<uint32_t> job_frame_id(ByteSpan frame) noexcept {
+    if (frame.empty()) {
+        return std::nullopt;
+    }
+    
+    // Смещение job_id в кадре каждого формата
+    std::size_t offset = 0;
+    std::size_t min_size = 0;
+    switch (static_cast<Command>(frame[0])) {
+        case Command::NewJob:
+            offset = NEW_JOB_FRAME_SIZE - constants::JOB_ID_SIZE;
+            min_size = NEW_JOB_FRAME_SIZE;
+            break;
+        case Command::NewJobSlots:
+            offset = NEW_JOB_SLOTS_HEADER_SIZE - constants::JOB_ID_SIZE;
+            min_size = NEW_JOB_SLOTS_HEADER_SIZE;
+            break;
+        case Command::NewJobLease:
+        case Command::NewJobRoll:
+            offset = 1;
+            min_size = 1 + constants::JOB_ID_SIZE;
+            break;
+        default:
+            return std::nullopt;
+    }
+    if (frame.size() < min_size) {
+        return std::nullopt;
+    }
+    return read_le32(frame.data() + offset);
+}
+
+std::size_t encode_share_batch(
+    std::span<const mining::Share> shares,
+    std::span<uint8_t> out
+) noexcept {
+    std::size_t size = SHARE_BATCH_HEADER_SIZE + shares.size() * constants::SHARE_MESSAGE_SIZE;
+    if (shares.empty() || shares.size() > SHARE_BATCH_MAX || out.size() < size) {
+        return 0;
+    }
+    
+    out[0] = static_cast<uint8_t>(Response::ShareBatch);
+    out[1] = static_cast<uint8_t>(shares.size());
+    
+    uint8_t* ptr = out.data() + SHARE_BATCH_HEADER_SIZE;
+    for (const auto& share : shares) {
+        write_le32(ptr, share.job_id);
+        write_le32(ptr + 4, share.nonce);
+        ptr += constants::SHARE_MESSAGE_SIZE;
+    }
+    
+    return size;
+}
+
+Bytes serialize_set_difficulty(uint32_t difficulty) {
+    SetDifficultyMessage msg{difficulty};
+    return msg.serialize();
+}
+
+Bytes serialize_update_time(uint32_t job_id, uint32_t timestamp, std::optional<uint32_t> nonce_start) {
+    UpdateTimeMessage msg{job_id, timestamp, nonce_start};
+    return msg.serialize();
+}
+
+Bytes serialize_set_share_batch(uint8_t max_count, uint16_t flush_ms) {
+    SetShareBatchMessage msg{max_count, flush_ms};
+    return msg.serialize();
+}
+
+Bytes serialize_set_session(uint64_t token) {
+    return SetSessionMessage{token}.serialize();
+}
+
 Bytes serialize_stop() {
     return {static_cast<uint8_t>(Command::Stop)};
 }
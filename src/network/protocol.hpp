@@ -17,12 +17,120 @@
  * ├─ CMD_NEW_JOB (0x01)     : новое задание (48 байт)
  * ├─ CMD_STOP (0x02)        : остановить майнинг (0 байт)
  * ├─ CMD_HEARTBEAT (0x03)   : ping (0 байт)
- * └─ CMD_SET_TARGET (0x04)  : установить target (32 байта)
+ * ├─ CMD_SET_TARGET (0x04)  : установить target (32 байта)
+ * ├─ CMD_SET_DIFFICULTY (0x05) : сложность shares (uint32 LE, 4 байта)
+ * ├─ CMD_SET_SHARE_BATCH (0x06) : разрешить RSP_SHARE_BATCH (3 байта)
+ * ├─ CMD_NEW_JOB_SLOTS (0x07) : задание с K midstate (21 + K × 36 байт)
+ * ├─ CMD_NEW_JOB_LEASE (0x08) : задание с арендой extranonce (130 байт)
+ * ├─ CMD_QUEUE_JOB (0x09)   : задание в очередь ASIC (48 байт, как NewJob)
+ * ├─ CMD_NEW_JOB_ROLL (0x0A) : задание с локальным version rolling (84 байта)
+ * ├─ CMD_UPDATE_TIME (0x0B) : новый timestamp задания (13 байт)
+ * └─ CMD_SET_SESSION (0x0C) : токен сессии соединения (8 байт)
  * 
  * Ответы (ASIC -> сервер): 1 байт + payload
  * ├─ RSP_SHARE (0x81)       : найден nonce (8 байт)
+ * ├─ RSP_SHARE_BATCH (0x82) : count(1) + count × share (8 байт)
  * ├─ RSP_HEARTBEAT (0x83)   : pong (0 байт)
- * └─ RSP_STATUS (0x84)      : статус ASIC (переменная длина)
+ * ├─ RSP_STATUS (0x84)      : статус ASIC (переменная длина)
+ * ├─ RSP_SHARE_SLOT (0x85)  : найден nonce в слоте версии (9 байт)
+ * ├─ RSP_SHARE_LEASED (0x86) : найден nonce для extranonce аренды (12 байт)
+ * ├─ RSP_SHARE_ROLLED (0x87) : найден nonce для версии ASIC (12 байт)
+ * ├─ RSP_TELEMETRY (0x88)   : изменения телеметрии чипов (len(2) + payload)
+ * ├─ RSP_HELLO (0x89)       : токен сессии при переподключении (12 байт)
+ * └─ RSP_JOB_LOADED (0x8A)  : задание загружено в чипы (12 байт)
+ * 
+ * Пакетные shares согласуются сервером: если server.share_batch_size > 1,
+ * сразу после подключения сервер шлёт CMD_SET_SHARE_BATCH. Прошивка,
+ * знающая команду, начинает копить shares и отправлять их пакетом по
+ * достижении max_count или через flush_ms. Старая прошивка пропускает
+ * незнакомую команду и продолжает слать RSP_SHARE; сервер принимает оба
+ * формата.
+ * 
+ * Задание с version rolling (mining.version_slots > 1, AsicBoost):
+ * ├─ count[1]         : число слотов K (2..MAX_VERSION_SLOTS)
+ * ├─ header_tail[12]  : merkle_root[28:32] + timestamp(4) + bits(4)
+ * ├─ nonce_start[4]   : начальный nonce
+ * ├─ job_id[4]        : ID задания
+ * └─ K × slot[36]     : version(4) + midstate(32)
+ * Хвост общий для всех версий; ASIC отвечает RSP_SHARE_SLOT с номером
+ * слота (RSP_SHARE и пакеты означают слот 0). Команду понимает только
+ * новая прошивка, поэтому слоты включаются в конфигурации явно.
+ * 
+ * Задание с арендой extranonce (mining.extranonce_lease > 1):
+ * ├─ job_id[4]            : ID задания
+ * ├─ version[4]           : версия заголовка
+ * ├─ prev_block[32]       : хеш предыдущего блока
+ * ├─ coinbase_midstate[32]: SHA256 состояние после первых 64 байт coinbase
+ * ├─ coinbase_tail[46]    : остаток coinbase, extranonce[6] в начале
+ * ├─ timestamp[4], bits[4]
+ * └─ extranonce_count[4]  : размер диапазона
+ * ASIC перебирает extranonce = начало + offset (offset < count): txid
+ * coinbase (merkle path пуст: блок без транзакций) даёт merkle_root и
+ * midstate заголовка. Shares для offset != 0 приходят в RSP_SHARE_LEASED:
+ * job_id(4) + nonce(4) + offset(4).
+ * 
+ * Задание с локальным version rolling (mining.local_version_rolling):
+ * ├─ job_id[4]        : ID задания
+ * ├─ version[4]       : версия заголовка
+ * ├─ prev_block[32]   : хеш предыдущего блока
+ * ├─ merkle_root[32]  : merkle root
+ * ├─ timestamp[4], bits[4]
+ * └─ version_mask[4]  : биты, которые ASIC меняет сам (BIP320)
+ * Контроллер ASIC перебирает версии в пределах маски и считает midstate
+ * первых 64 байт заголовка для каждой. Shares приходят в RSP_SHARE_ROLLED:
+ * job_id(4) + nonce(4) + version(4).
+ * 
+ * Новый timestamp задания (CMD_UPDATE_TIME):
+ * ├─ job_id[4]        : ID задания, которое ASIC уже перебирает
+ * ├─ timestamp[4]     : новый timestamp заголовка
+ * ├─ flags[1]         : бит 0 - nonce_start задан
+ * └─ nonce_start[4]   : начальный nonce (без флага - прежний nonce задания)
+ * Timestamp лежит в хвосте заголовка, а не в midstate: ASIC меняет
+ * хвост и начинает перебор nonce заново, midstate и job_id прежние.
+ * Shares, найденные до команды, сервер проверяет и с прежним timestamp.
+ * 
+ * Телеметрия чипов (RSP_TELEMETRY, раз в секунду):
+ * ├─ len[2]           : размер payload (до MAX_TELEMETRY_PAYLOAD)
+ * ├─ flags[1]         : бит 0 - keyframe (разницы от нулей)
+ * └─ записи чипов     : gap (varint) + mask(1) + поля по маске
+ * Приходят только изменившиеся поля: температура и частота - zigzag
+ * varint разницы, статус - байт, счётчики nonce - varint прироста.
+ * Разбирает FleetTelemetry.
+ * 
+ * Возобновление сессии (server.session_grace_seconds > 0):
+ * сразу после подключения сервер шлёт CMD_SET_SESSION с токеном. После
+ * обрыва сервер держит extranonce и задания соединения grace период;
+ * прошивка, переподключившись, первым кадром шлёт RSP_HELLO:
+ * ├─ token[8]         : токен из CMD_SET_SESSION
+ * └─ job_id[4]        : задание, которое ASIC перебирает
+ * Сервер возвращает соединению прежний extranonce и, если задание ещё
+ * текущее, не шлёт нового: ASIC продолжает начатое, shares, найденные
+ * во время обрыва, засчитываются. Неизвестный или истёкший токен -
+ * обычное подключение.
+ * 
+ * Подтверждение загрузки задания (RSP_JOB_LOADED, необязательно):
+ * ├─ job_id[4]        : задание из CMD_NEW_JOB / SLOTS / LEASE / ROLL
+ * ├─ received_us[4]   : часы контроллера: кадр задания принят
+ * └─ started_us[4]    : часы контроллера: чипы начали перебор
+ * Прошивка шлёт его сразу после a1126_load_job / a1126_start. Часы
+ * контроллера с сервером не сверены, поэтому сервер берёт только их
+ * разницу (загрузка в чипы), а от отправки кадра до прихода ответа
+ * меряет по своим часам.
+ * 
+ * Уведомление о новом блоке (server.multicast, UDP датаграмма на группу):
+ * ├─ команда[1]           : CMD_BLOCK_NOTIFY
+ * ├─ generation[4]        : поколение заданий (растёт с каждым шаблоном)
+ * ├─ height[4]            : высота блока
+ * ├─ flags[1]             : бит 0 - данные аренды заданы, бит 1 - speculative
+ * ├─ version[4]           : версия заголовка
+ * ├─ prev_block[32]       : хеш предыдущего блока
+ * ├─ coinbase_midstate[32]: SHA256 состояние первых 64 байт coinbase
+ * ├─ coinbase_tail[46]    : остаток coinbase с нулевым extranonce
+ * └─ timestamp[4], bits[4]
+ * Одна датаграмма до рассылки заданий по TCP: прошивка сразу бросает
+ * работу прежнего блока, а с арендой extranonce строит задание нового
+ * блока сама, подставив начало своего диапазона. Shares такой работы
+ * ждут CMD_NEW_JOB_LEASE по TCP: совпавшее задание даёт им job_id.
  */
 
 #pragma once
@@ -31,6 +139,9 @@
 #include "../core/constants.hpp"
 #include "../mining/job.hpp"
 
+#include <algorithm>
+#include <array>
+#include <optional>
 #include <span>
 #include <variant>
 
@@ -49,6 +160,14 @@ enum class Command : uint8_t {
     Heartbeat = 0x03,     ///< Ping для проверки соединения
     SetTarget = 0x04,     ///< Установить target
     SetDifficulty = 0x05, ///< Установить difficulty
+    SetShareBatch = 0x06, ///< Разрешить пакетные shares
+    NewJobSlots = 0x07,   ///< Задание с несколькими версиями (version rolling)
+    NewJobLease = 0x08,   ///< Задание с арендой extranonce
+    QueueJob = 0x09,      ///< Задание в очередь ASIC (после текущего)
+    NewJobRoll = 0x0A,    ///< Задание с локальным version rolling
+    UpdateTime = 0x0B,    ///< Новый timestamp (и nonce) текущего задания
+    SetSession = 0x0C,    ///< Токен сессии для возобновления после обрыва
+    BlockNotify = 0x0D,   ///< Новый блок (только multicast UDP)
 };
 
 /**
@@ -56,11 +175,122 @@ enum class Command : uint8_t {
  */
 enum class Response : uint8_t {
     Share = 0x81,         ///< Найден валидный nonce
+    ShareBatch = 0x82,    ///< Несколько shares в одном кадре
     Heartbeat = 0x83,     ///< Pong ответ
     Status = 0x84,        ///< Статус ASIC
+    ShareSlot = 0x85,     ///< Найден nonce в слоте версии
+    ShareLeased = 0x86,   ///< Найден nonce для extranonce из аренды
+    ShareRolled = 0x87,   ///< Найден nonce для версии, перебранной ASIC
+    Telemetry = 0x88,     ///< Изменения телеметрии чипов
+    Hello = 0x89,         ///< Токен прежней сессии после переподключения
+    JobLoaded = 0x8A,     ///< Задание загружено в чипы
     Error = 0x8F,         ///< Ошибка
 };
 
+// =============================================================================
+// Размеры кадров
+// =============================================================================
+
+/// @brief Кадр NewJob: команда (1) + задание (48)
+inline constexpr std::size_t NEW_JOB_FRAME_SIZE = 1 + constants::JOB_MESSAGE_SIZE;
+
+/// @brief Кадр Share: ответ (1) + share (8)
+inline constexpr std::size_t SHARE_FRAME_SIZE = 1 + constants::SHARE_MESSAGE_SIZE;
+
+/// @brief Кадр ShareSlot: ответ (1) + share (8) + слот (1)
+inline constexpr std::size_t SHARE_SLOT_FRAME_SIZE = SHARE_FRAME_SIZE + 1;
+
+/// @brief Заголовок NewJobSlots: команда (1) + count (1) + tail (12) + nonce (4) + job_id (4)
+inline constexpr std::size_t NEW_JOB_SLOTS_HEADER_SIZE = 2 + constants::HEADER_TAIL_SIZE + 4 + constants::JOB_ID_SIZE;
+
+/// @brief Слот NewJobSlots: version (4) + midstate (32)
+inline constexpr std::size_t NEW_JOB_SLOT_SIZE = 4 + constants::SHA256_MIDSTATE_SIZE;
+
+/// @brief Максимальный кадр NewJobSlots
+inline constexpr std::size_t MAX_NEW_JOB_SLOTS_FRAME_SIZE =
+    NEW_JOB_SLOTS_HEADER_SIZE + constants::MAX_VERSION_SLOTS * NEW_JOB_SLOT_SIZE;
+
+/// @brief Кадр ShareLeased: ответ (1) + share (8) + смещение extranonce (4)
+inline constexpr std::size_t SHARE_LEASED_FRAME_SIZE = SHARE_FRAME_SIZE + 4;
+
+/// @brief Кадр NewJobLease: команда (1) + job_id (4) + version (4) + prev_block (32) +
+/// coinbase_midstate (32) + coinbase_tail (46) + timestamp (4) + bits (4) + count (4)
+inline constexpr std::size_t NEW_JOB_LEASE_FRAME_SIZE =
+    1 + constants::JOB_ID_SIZE + 4 + constants::SHA256_SIZE + constants::SHA256_MIDSTATE_SIZE +
+    constants::COINBASE_TAIL_SIZE + 4 + 4 + 4;
+
+/// @brief Кадр ShareRolled: ответ (1) + share (8) + версия (4)
+inline constexpr std::size_t SHARE_ROLLED_FRAME_SIZE = SHARE_FRAME_SIZE + 4;
+
+/// @brief Кадр NewJobRoll: команда (1) + job_id (4) + version (4) + prev_block (32) +
+/// merkle_root (32) + timestamp (4) + bits (4) + version_mask (4)
+inline constexpr std::size_t NEW_JOB_ROLL_FRAME_SIZE =
+    1 + constants::JOB_ID_SIZE + 4 + constants::SHA256_SIZE + constants::SHA256_SIZE + 4 + 4 + 4;
+
+/// @brief Максимальный кадр задания любого вида
+inline constexpr std::size_t MAX_JOB_FRAME_SIZE =
+    std::max({MAX_NEW_JOB_SLOTS_FRAME_SIZE, NEW_JOB_LEASE_FRAME_SIZE, NEW_JOB_ROLL_FRAME_SIZE});
+
+/// @brief Кадр Status: ответ (1) + статус (8)
+inline constexpr std::size_t STATUS_FRAME_SIZE = 1 + 8;
+
+/// @brief Максимум shares в кадре RSP_SHARE_BATCH
+inline constexpr std::size_t SHARE_BATCH_MAX = 32;
+
+/// @brief Заголовок RSP_SHARE_BATCH: ответ (1) + count (1)
+inline constexpr std::size_t SHARE_BATCH_HEADER_SIZE = 2;
+
+/// @brief Максимальный кадр RSP_SHARE_BATCH
+inline constexpr std::size_t MAX_SHARE_BATCH_FRAME_SIZE =
+    SHARE_BATCH_HEADER_SIZE + SHARE_BATCH_MAX * constants::SHARE_MESSAGE_SIZE;
+
+/// @brief Кадр SetShareBatch: команда (1) + max_count (1) + flush_ms (2)
+inline constexpr std::size_t SET_SHARE_BATCH_FRAME_SIZE = 4;
+
+/// @brief Кадр SetDifficulty: команда (1) + difficulty (4)
+inline constexpr std::size_t SET_DIFFICULTY_FRAME_SIZE = 5;
+
+/// @brief Кадр UpdateTime: команда (1) + job_id (4) + timestamp (4) + flags (1) + nonce_start (4)
+inline constexpr std::size_t UPDATE_TIME_FRAME_SIZE = 1 + constants::JOB_ID_SIZE + 4 + 1 + 4;
+
+/// @brief Флаг UpdateTime: nonce_start задан
+inline constexpr uint8_t UPDATE_TIME_FLAG_NONCE = 0x01;
+
+/// @brief Кадр SetSession: команда (1) + токен (8)
+inline constexpr std::size_t SET_SESSION_FRAME_SIZE = 1 + 8;
+
+/// @brief Кадр Hello: ответ (1) + токен (8) + job_id (4)
+inline constexpr std::size_t HELLO_FRAME_SIZE = 1 + 8 + constants::JOB_ID_SIZE;
+
+/// @brief Кадр JobLoaded: ответ (1) + job_id (4) + received_us (4) + started_us (4)
+inline constexpr std::size_t JOB_LOADED_FRAME_SIZE = 1 + constants::JOB_ID_SIZE + 4 + 4;
+
+/// @brief Датаграмма BlockNotify: команда (1) + generation (4) + height (4) + flags (1) +
+/// version (4) + prev_block (32) + coinbase_midstate (32) + coinbase_tail (46) + timestamp (4) + bits (4)
+inline constexpr std::size_t BLOCK_NOTIFY_FRAME_SIZE =
+    1 + 4 + 4 + 1 + 4 + 32 + constants::SHA256_MIDSTATE_SIZE + constants::COINBASE_TAIL_SIZE + 4 + 4;
+
+/// @brief Флаг BlockNotify: version, prev_block и coinbase заданы (прошивка с арендой строит задание)
+inline constexpr uint8_t BLOCK_NOTIFY_FLAG_WORK = 0x01;
+
+/// @brief Флаг BlockNotify: блок ещё не валидирован (spy mining)
+inline constexpr uint8_t BLOCK_NOTIFY_FLAG_SPECULATIVE = 0x02;
+
+/// @brief Максимальный кадр Error (ответ + код + текст)
+inline constexpr std::size_t MAX_ERROR_FRAME_SIZE = 32;
+
+/// @brief Заголовок RSP_TELEMETRY: ответ (1) + len (2)
+inline constexpr std::size_t TELEMETRY_HEADER_SIZE = 3;
+
+/// @brief Максимальный payload RSP_TELEMETRY
+inline constexpr std::size_t MAX_TELEMETRY_PAYLOAD = 1536;
+
+/// @brief Буфер под один кадр NewJob
+using NewJobFrame = std::array<uint8_t, NEW_JOB_FRAME_SIZE>;
+
+/// @brief Буфер под кадр NewJob любого вида (обычный, с версиями, с арендой)
+using AnyJobFrame = std::array<uint8_t, MAX_JOB_FRAME_SIZE>;
+
 // =============================================================================
 // Структуры сообщений
 // =============================================================================
@@ -72,7 +302,67 @@ struct NewJobMessage {
     mining::Job job;
     
     [[nodiscard]] Bytes serialize() const;
-    [[nodiscard]] static Result<NewJobMessage> deserialize(ByteSpan data);
+    
+    /**
+     * @brief Записать кадр в буфер вызывающего (без аллокаций)
+     * 
+     * @param out Буфер кадра (49 байт)
+     */
+    void encode(std::span<uint8_t, NEW_JOB_FRAME_SIZE> out) const noexcept;
+    
+    /**
+     * @brief Записать кадр QueueJob: payload как у NewJob
+     * 
+     * ASIC не прерывает текущее задание, а ставит это в очередь.
+     * 
+     * @param out Буфер кадра (49 байт)
+     */
+    void encode_queued(std::span<uint8_t, NEW_JOB_FRAME_SIZE> out) const noexcept;
+    
+    /**
+     * @brief Есть ли у задания слоты версий (кадр NewJobSlots)
+     */
+    [[nodiscard]] bool has_slots() const noexcept { return job.version_count > 1; }
+    
+    /**
+     * @brief Есть ли у задания аренда extranonce (кадр NewJobLease)
+     */
+    [[nodiscard]] bool has_lease() const noexcept { return job.extranonce_lease > 1; }
+    
+    /**
+     * @brief Перебирает ли ASIC версии сам (кадр NewJobRoll)
+     */
+    [[nodiscard]] bool has_rolling() const noexcept { return job.version_mask != 0; }
+    
+    /**
+     * @brief Помещается ли задание в обычный 48-байтный NewJob
+     */
+    [[nodiscard]] bool is_plain() const noexcept { return !has_slots() && !has_lease() && !has_rolling(); }
+    
+    /**
+     * @brief Записать кадр NewJob, NewJobSlots, NewJobLease или NewJobRoll
+     * 
+     * @param out Буфер кадра
+     * @return std::size_t Размер кадра
+     */
+    [[nodiscard]] std::size_t encode_any(std::span<uint8_t, MAX_JOB_FRAME_SIZE> out) const noexcept;
+    
+    [[nodiscard]] static FastResult<NewJobMessage> deserialize(ByteSpan data);
+    
+    /**
+     * @brief Разобрать payload NewJobSlots (без байта команды)
+     */
+    [[nodiscard]] static FastResult<NewJobMessage> deserialize_slots(ByteSpan data);
+    
+    /**
+     * @brief Разобрать payload NewJobLease (без байта команды)
+     */
+    [[nodiscard]] static FastResult<NewJobMessage> deserialize_lease(ByteSpan data);
+    
+    /**
+     * @brief Разобрать payload NewJobRoll (без байта команды)
+     */
+    [[nodiscard]] static FastResult<NewJobMessage> deserialize_roll(ByteSpan data);
 };
 
 /**
@@ -81,8 +371,18 @@ struct NewJobMessage {
 struct ShareMessage {
     mining::Share share;
     
+    /// @brief Кадр RSP_SHARE, RSP_SHARE_LEASED для share.extranonce_offset != 0,
+    /// RSP_SHARE_SLOT для share.version_slot != 0 или RSP_SHARE_ROLLED для share.version != 0
     [[nodiscard]] Bytes serialize() const;
-    [[nodiscard]] static Result<ShareMessage> deserialize(ByteSpan data);
+    
+    /**
+     * @brief Записать кадр в буфер вызывающего (без аллокаций)
+     * 
+     * @param out Буфер кадра (9 байт)
+     */
+    void encode(std::span<uint8_t, SHARE_FRAME_SIZE> out) const noexcept;
+    
+    [[nodiscard]] static FastResult<ShareMessage> deserialize(ByteSpan data);
 };
 
 /**
@@ -95,6 +395,121 @@ struct SetTargetMessage {
     [[nodiscard]] static Result<SetTargetMessage> deserialize(ByteSpan data);
 };
 
+/**
+ * @brief Сообщение SetDifficulty (vardiff)
+ * 
+ * ASIC отправляет только shares с hash <= diff1_target / difficulty.
+ */
+struct SetDifficultyMessage {
+    uint32_t difficulty = 1;
+    
+    [[nodiscard]] Bytes serialize() const;
+    [[nodiscard]] static Result<SetDifficultyMessage> deserialize(ByteSpan data);
+};
+
+/**
+ * @brief Сообщение UpdateTime (новый хвост задания без нового midstate)
+ */
+struct UpdateTimeMessage {
+    uint32_t job_id = 0;
+    uint32_t timestamp = 0;
+    std::optional<uint32_t> nonce_start;  ///< nullopt - ASIC берёт прежний nonce задания
+    
+    [[nodiscard]] Bytes serialize() const;
+    
+    /**
+     * @brief Записать кадр в буфер вызывающего (без аллокаций)
+     * 
+     * @param out Буфер кадра (14 байт)
+     */
+    void encode(std::span<uint8_t, UPDATE_TIME_FRAME_SIZE> out) const noexcept;
+    
+    /// @param data Payload без байта команды
+    [[nodiscard]] static Result<UpdateTimeMessage> deserialize(ByteSpan data);
+};
+
+/**
+ * @brief Сообщение SetShareBatch (согласование пакетных shares)
+ */
+struct SetShareBatchMessage {
+    uint8_t max_count = 0;   ///< Отправлять пакет при стольких shares
+    uint16_t flush_ms = 0;   ///< Отправлять неполный пакет не позже (мс)
+    
+    [[nodiscard]] Bytes serialize() const;
+    [[nodiscard]] static Result<SetShareBatchMessage> deserialize(ByteSpan data);
+};
+
+/**
+ * @brief Сообщение SetSession (токен для возобновления сессии)
+ */
+struct SetSessionMessage {
+    uint64_t token = 0;
+    
+    [[nodiscard]] Bytes serialize() const;
+    
+    /// @param data Payload без байта команды
+    [[nodiscard]] static Result<SetSessionMessage> deserialize(ByteSpan data);
+};
+
+/**
+ * @brief Сообщение Hello от ASIC (токен прежней сессии)
+ */
+struct HelloMessage {
+    uint64_t token = 0;
+    uint32_t job_id = 0;  ///< Задание ASIC (0 - нет задания)
+    
+    [[nodiscard]] Bytes serialize() const;
+    
+    /// @param data Payload без байта ответа
+    [[nodiscard]] static Result<HelloMessage> deserialize(ByteSpan data);
+};
+
+/**
+ * @brief Подтверждение загрузки задания в чипы (RSP_JOB_LOADED)
+ */
+struct JobLoadedMessage {
+    uint32_t job_id = 0;
+    uint32_t received_us = 0;  ///< Кадр задания принят (часы контроллера, мкс)
+    uint32_t started_us = 0;   ///< Чипы начали перебор (часы контроллера, мкс)
+    
+    /**
+     * @brief Загрузка в чипы по часам контроллера (переполнение учтено)
+     */
+    [[nodiscard]] uint32_t load_us() const noexcept { return started_us - received_us; }
+    
+    [[nodiscard]] Bytes serialize() const;
+    
+    /// @param data Payload без байта ответа
+    [[nodiscard]] static Result<JobLoadedMessage> deserialize(ByteSpan data);
+};
+
+/**
+ * @brief Уведомление о новом блоке (multicast датаграмма)
+ */
+struct BlockNotifyMessage {
+    uint32_t generation = 0;
+    uint32_t height = 0;
+    uint8_t flags = 0;  ///< BLOCK_NOTIFY_FLAG_*
+    uint32_t version = 0;
+    Hash256 prev_block{};
+    crypto::Sha256State coinbase_midstate{};
+    std::array<uint8_t, constants::COINBASE_TAIL_SIZE> coinbase_tail{};
+    uint32_t timestamp = 0;
+    uint32_t bits = 0;
+    
+    /**
+     * @brief Уведомление из JobManager::block_announcement()
+     * 
+     * Данные аренды (BLOCK_NOTIFY_FLAG_WORK) - если они есть в задании.
+     */
+    [[nodiscard]] static BlockNotifyMessage from_job(const mining::Job& job);
+    
+    [[nodiscard]] Bytes serialize() const;
+    
+    /// @param data Датаграмма целиком (с байтом команды)
+    [[nodiscard]] static Result<BlockNotifyMessage> deserialize(ByteSpan data);
+};
+
 /**
  * @brief Сообщение Status от ASIC
  */
@@ -119,6 +534,18 @@ struct ErrorMessage {
     [[nodiscard]] static Result<ErrorMessage> deserialize(ByteSpan data);
 };
 
+/**
+ * @brief Кадр телеметрии чипов (payload без заголовка)
+ */
+struct TelemetryMessage {
+    Bytes payload;
+    
+    [[nodiscard]] Bytes serialize() const;
+    
+    /// @param data len(2) + payload
+    [[nodiscard]] static Result<TelemetryMessage> deserialize(ByteSpan data);
+};
+
 // =============================================================================
 // Парсер протокола
 // =============================================================================
@@ -129,7 +556,10 @@ struct ErrorMessage {
 using ParsedMessage = std::variant<
     ShareMessage,
     StatusMessage,
-    ErrorMessage
+    ErrorMessage,
+    TelemetryMessage,
+    HelloMessage,
+    JobLoadedMessage
 >;
 
 /**
@@ -163,6 +593,119 @@ public:
     
 private:
     Bytes buffer_;
+    
+    /// @brief Сколько shares текущего RSP_SHARE_BATCH ещё не извлечено
+    std::size_t batch_remaining_ = 0;
+};
+
+/**
+ * @brief Парсер на кольцевом буфере фиксированного размера
+ * 
+ * Кадры протокола короткие (телеметрия - не длиннее
+ * TELEMETRY_HEADER_SIZE + MAX_TELEMETRY_PAYLOAD), поэтому данные
+ * хранятся в кольце из CAPACITY байт без роста и без сдвига буфера
+ * после каждого кадра. Share и Status декодируются прямо из кольца,
+ * без аллокаций (ErrorMessage и TelemetryMessage копируют данные).
+ * 
+ * RSP_SHARE_BATCH разбирается целиком только после получения всего
+ * кадра и отдаётся как последовательность ShareMessage.
+ */
+class FrameParser {
+public:
+    /// @brief Размер кольца (степень двойки)
+    static constexpr std::size_t CAPACITY = 4096;
+    
+    /**
+     * @brief Добавить данные в кольцо
+     * 
+     * @param data Входящие байты
+     * @return std::size_t Сколько байт принято (меньше data.size(),
+     *         если кольцо заполнено: разберите кадры и добавьте остаток)
+     */
+    [[nodiscard]] std::size_t add_data(ByteSpan data) noexcept;
+    
+    /**
+     * @brief Попытаться извлечь полное сообщение
+     * 
+     * @return std::optional<ParsedMessage> Сообщение или nullopt
+     */
+    [[nodiscard]] std::optional<ParsedMessage> try_parse();
+    
+    /**
+     * @brief Добавить данные и передать каждое полное сообщение в handler
+     * 
+     * Данные больше свободного места кольца добавляются частями.
+     * 
+     * @param data Входящие байты
+     * @param handler Вызывается как handler(const ParsedMessage&)
+     */
+    template<typename Handler>
+    void feed(ByteSpan data, Handler&& handler) {
+        // После разбора в кольце остаётся не больше одного неполного
+        // кадра, поэтому каждая итерация принимает новые данные
+        do {
+            data = data.subspan(add_data(data));
+            while (auto msg = try_parse()) {
+                handler(*msg);
+            }
+        } while (!data.empty());
+    }
+    
+    /**
+     * @brief Количество байт в кольце
+     */
+    [[nodiscard]] std::size_t buffered_size() const noexcept {
+        return tail_ - head_;
+    }
+    
+    /**
+     * @brief Очистить кольцо
+     */
+    void clear() noexcept {
+        head_ = tail_ = 0;
+        batch_remaining_ = 0;
+    }
+    
+    /**
+     * @brief Забрать неразобранные байты (неполный кадр) и очистить кольцо
+     * 
+     * Вызывать после feed(): извлечённые кадры уже отданы handler.
+     * Байты возвращаются новому парсеру через add_data() при передаче
+     * соединения другому процессу.
+     */
+    [[nodiscard]] Bytes take_buffered();
+    
+private:
+    /// @brief Байт по смещению от начала непрочитанных данных
+    [[nodiscard]] uint8_t peek(std::size_t offset) const noexcept {
+        return ring_[(head_ + offset) & (CAPACITY - 1)];
+    }
+    
+    /**
+     * @brief Указатель на size байт после заголовка кадра
+     * 
+     * Если кадр не переходит через конец кольца, указывает прямо в кольцо,
+     * иначе копирует байты в scratch.
+     */
+    [[nodiscard]] const uint8_t* payload(
+        std::size_t size,
+        std::array<uint8_t, MAX_ERROR_FRAME_SIZE>& scratch
+    ) const noexcept;
+    
+    void consume(std::size_t size) noexcept {
+        head_ += size;
+    }
+    
+    static_assert((CAPACITY & (CAPACITY - 1)) == 0, "CAPACITY должен быть степенью двойки");
+    static_assert(TELEMETRY_HEADER_SIZE + MAX_TELEMETRY_PAYLOAD <= CAPACITY,
+                  "Кадр телеметрии должен помещаться в кольцо");
+    
+    std::array<uint8_t, CAPACITY> ring_{};
+    std::size_t head_ = 0;  ///< Позиция чтения (монотонная)
+    std::size_t tail_ = 0;  ///< Позиция записи (монотонная)
+    
+    /// @brief Сколько shares текущего RSP_SHARE_BATCH ещё не извлечено
+    std::size_t batch_remaining_ = 0;
 };
 
 // =============================================================================
@@ -170,10 +713,65 @@ private:
 // =============================================================================
 
 /**
- * @brief Сериализовать команду NewJob
+ * @brief Сериализовать команду NewJob (NewJobSlots для задания со слотами версий)
  */
 [[nodiscard]] Bytes serialize_new_job(const mining::Job& job);
 
+/**
+ * @brief Записать кадр NewJob из готового 48-байтного задания
+ * 
+ * @param message Задание в формате Job::serialize()
+ * @param out Буфер кадра (49 байт)
+ */
+void encode_new_job(
+    std::span<const uint8_t, constants::JOB_MESSAGE_SIZE> message,
+    std::span<uint8_t, NEW_JOB_FRAME_SIZE> out
+) noexcept;
+
+/**
+ * @brief ID задания в кадре, который ASIC загружает сразу
+ * 
+ * NewJob, NewJobSlots, NewJobLease и NewJobRoll; QueueJob и прочие
+ * кадры - nullopt (задание из очереди ASIC начинает позже).
+ */
+[[nodiscard]] std::optional<uint32_t> job_frame_id(ByteSpan frame) noexcept;
+
+/**
+ * @brief Записать кадр RSP_SHARE_BATCH
+ * 
+ * @param shares Shares (от 1 до SHARE_BATCH_MAX)
+ * @param out Буфер (не меньше SHARE_BATCH_HEADER_SIZE + 8 * shares.size())
+ * @return std::size_t Размер кадра или 0, если shares не помещаются
+ */
+[[nodiscard]] std::size_t encode_share_batch(
+    std::span<const mining::Share> shares,
+    std::span<uint8_t> out
+) noexcept;
+
+/**
+ * @brief Сериализовать команду SetDifficulty
+ */
+[[nodiscard]] Bytes serialize_set_difficulty(uint32_t difficulty);
+
+/**
+ * @brief Сериализовать команду UpdateTime
+ */
+[[nodiscard]] Bytes serialize_update_time(
+    uint32_t job_id,
+    uint32_t timestamp,
+    std::optional<uint32_t> nonce_start = std::nullopt
+);
+
+/**
+ * @brief Сериализовать команду SetShareBatch
+ */
+[[nodiscard]] Bytes serialize_set_share_batch(uint8_t max_count, uint16_t flush_ms);
+
+/**
+ * @brief Сериализовать команду SetSession
+ */
+[[nodiscard]] Bytes serialize_set_session(uint64_t token);
+
 /**
  * @brief Сериализовать команду Stop
  */
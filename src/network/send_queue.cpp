@@ -0,0 +1,159 @@
+/**
+ * @file send_queue.cpp
+ * @brief Реализация очереди отправки со слиянием кадров
+ */
+
+#include "send_queue.hpp"
+#include "protocol.hpp"
+
+#include <array>
+#include <cerrno>
+
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+namespace quaxis::network {
+
+SendQueue::Kind SendQueue::classify(ByteSpan frame) noexcept {
+    if (frame.empty()) {
+        return Kind::Other;
+    }
+    switch (static_cast<Command>(frame[0])) {
+        case Command::NewJob:
+        case Command::NewJobSlots:
+        case Command::NewJobLease:
+        case Command::NewJobRoll:
+            return Kind::Job;
+        case Command::QueueJob:
+            return Kind::QueueJob;
+        case Command::UpdateTime:
+            return Kind::UpdateTime;
+        case Command::Stop:
+            return Kind::Stop;
+        case Command::SetTarget:
+            return Kind::Target;
+        default:
+            return Kind::Other;
+    }
+}
+
+void SendQueue::drop_superseded(Kind kind) noexcept {
+    if (kind == Kind::Other || kind == Kind::QueueJob) {
+        return;  // Очередь ASIC дополняет текущее задание, а не заменяет
+    }
+
+    auto stale = [kind](Kind pending) {
+        if (kind == Kind::Job) {
+            // Новое задание обесценивает прежние вместе с их очередью и timestamp
+            return pending == Kind::Job || pending == Kind::QueueJob || pending == Kind::UpdateTime;
+        }
+        return pending == kind;
+    };
+
+    auto first = frames_.begin();
+    if (front_pinned_ && first != frames_.end()) {
+        ++first;
+    }
+    for (auto it = first; it != frames_.end();) {
+        if (stale(it->kind)) {
+            if (it->kind == Kind::Job) {
+                superseded_jobs_++;
+            }
+            it = frames_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+bool SendQueue::push(Bytes frame) {
+    if (frame.empty()) {
+        return true;
+    }
+    const Kind kind = classify(frame);
+    drop_superseded(kind);
+
+    const std::size_t pinned = front_pinned_ ? 1 : 0;
+    if (frames_.size() - pinned >= capacity_) {
+        return false;
+    }
+    frames_.push_back(Frame{std::move(frame), kind});
+    return true;
+}
+
+void SendQueue::push_front_partial(Bytes rest) {
+    if (front_pinned_ || offset_ > 0) {
+        // Сокет уже дописывает другой кадр: остаток встанет сразу за ним
+        frames_.insert(std::next(frames_.begin()), Frame{std::move(rest), Kind::Other});
+        return;
+    }
+    frames_.push_front(Frame{std::move(rest), Kind::Other});
+    front_pinned_ = true;
+}
+
+ssize_t SendQueue::write_to(int fd) {
+    ssize_t total = 0;
+
+    while (!frames_.empty()) {
+        std::array<iovec, MAX_IOV> iov;
+        std::size_t count = 0;
+        for (auto it = frames_.begin(); it != frames_.end() && count < MAX_IOV; ++it, ++count) {
+            const std::size_t skip = count == 0 ? offset_ : 0;
+            iov[count].iov_base = const_cast<uint8_t*>(it->data.data() + skip);
+            iov[count].iov_len = it->data.size() - skip;
+        }
+
+        msghdr msg{};
+        msg.msg_iov = iov.data();
+        msg.msg_iovlen = count;
+        ssize_t n = sendmsg(fd, &msg, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                break;
+            }
+            return -errno;
+        }
+        if (n == 0) {
+            break;
+        }
+        total += n;
+
+        // Снимаем отправленные кадры, остаток первого - через offset_
+        auto written = static_cast<std::size_t>(n);
+        while (written > 0) {
+            const std::size_t left = frames_.front().data.size() - offset_;
+            if (written < left) {
+                offset_ += written;
+                front_pinned_ = true;
+                break;
+            }
+            written -= left;
+            frames_.pop_front();
+            offset_ = 0;
+            front_pinned_ = false;
+        }
+    }
+
+    return total;
+}
+
+Bytes SendQueue::take_pending() {
+    Bytes pending;
+    for (auto it = frames_.begin(); it != frames_.end(); ++it) {
+        const std::size_t skip = it == frames_.begin() ? offset_ : 0;
+        pending.insert(pending.end(), it->data.begin() + static_cast<std::ptrdiff_t>(skip), it->data.end());
+    }
+    clear();
+    return pending;
+}
+
+void SendQueue::clear() noexcept {
+    frames_.clear();
+    offset_ = 0;
+    front_pinned_ = false;
+}
+
+} // namespace quaxis::network
@@ -0,0 +1,138 @@
+/**
+ * @file send_queue.hpp
+ * @brief Очередь отправки соединения с ASIC со слиянием устаревших кадров
+ *
+ * Медленный или зависший ASIC не успевает забирать кадры, и задания
+ * прошлых блоков копились бы в очереди: после смены блока ASIC сначала
+ * перебирал бы устаревшую работу. Очередь знает тип кадра по байту
+ * команды и при добавлении вытесняет ещё не отправленные кадры, которые
+ * новый делает бессмысленными:
+ * - задание (NewJob, NewJobSlots, NewJobLease, NewJobRoll) - прежние
+ *   задания, их CMD_QUEUE_JOB и CMD_UPDATE_TIME
+ * - Stop, SetTarget, UpdateTime - прежний кадр того же типа
+ *
+ * Первое задание, которое ASIC получит после смены блока, - текущее.
+ * Размер очереди ограничен; накопившиеся кадры уходят одним writev.
+ *
+ * Не потокобезопасна: вызывающий держит mutex соединения.
+ */
+
+#pragma once
+
+#include "../core/types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+
+#include <sys/types.h>
+
+namespace quaxis::network {
+
+/**
+ * @brief Очередь кадров одного соединения
+ */
+class SendQueue {
+public:
+    /// @brief Кадров в очереди по умолчанию
+    static constexpr std::size_t DEFAULT_CAPACITY = 64;
+
+    /// @brief Кадров в одном writev
+    static constexpr std::size_t MAX_IOV = 16;
+
+    /**
+     * @brief Тип кадра для слияния
+     */
+    enum class Kind : uint8_t {
+        Job,       ///< Новое задание любого вида
+        QueueJob,  ///< Задания очереди ASIC (после текущего)
+        UpdateTime,///< Новый timestamp текущего задания
+        Stop,      ///< Остановка
+        Target,    ///< Новый target
+        Other      ///< Не сливается (heartbeat, сложность, пакеты shares)
+    };
+
+    /**
+     * @param capacity Наибольшее число кадров (минимум 1)
+     */
+    explicit SendQueue(std::size_t capacity = DEFAULT_CAPACITY) noexcept
+        : capacity_(capacity == 0 ? 1 : capacity) {}
+
+    /**
+     * @brief Тип кадра по байту команды
+     */
+    [[nodiscard]] static Kind classify(ByteSpan frame) noexcept;
+
+    /**
+     * @brief Добавить кадр в конец, вытеснив устаревшие
+     *
+     * Кадр, уже частично записанный в сокет, не вытесняется.
+     *
+     * @param frame Кадр (команда + payload)
+     * @return false если очередь заполнена кадрами, которые нельзя вытеснить
+     */
+    bool push(Bytes frame);
+
+    /**
+     * @brief Вернуть в начало остаток кадра, отправленного мимо очереди
+     *
+     * Байты этого кадра уже частично в сокете: он не вытесняется и не
+     * учитывается в capacity.
+     */
+    void push_front_partial(Bytes rest);
+
+    /**
+     * @brief Записать кадры в сокет (writev до MAX_IOV кадров за вызов)
+     *
+     * Пишет, пока очередь не опустеет или сокет не вернёт EAGAIN.
+     *
+     * @param fd Неблокирующий сокет
+     * @return ssize_t Байт записано или -errno (кроме EAGAIN)
+     */
+    [[nodiscard]] ssize_t write_to(int fd);
+
+    /**
+     * @brief Очистить очередь
+     */
+    void clear() noexcept;
+
+    /**
+     * @brief Забрать неотправленные байты всех кадров и очистить очередь
+     *
+     * Первый кадр - без уже записанной в сокет части. Новый процесс
+     * возвращает их через push_front_partial(), и поток байт в сокете
+     * продолжается с того же места.
+     */
+    [[nodiscard]] Bytes take_pending();
+
+    [[nodiscard]] bool empty() const noexcept { return frames_.empty(); }
+
+    [[nodiscard]] std::size_t size() const noexcept { return frames_.size(); }
+
+    /**
+     * @brief Сколько заданий вытеснено до отправки
+     */
+    [[nodiscard]] uint64_t superseded_jobs() const noexcept { return superseded_jobs_; }
+
+private:
+    struct Frame {
+        Bytes data;
+        Kind kind{Kind::Other};
+    };
+
+    /// @brief Вытеснить неотправленные кадры, которые устаревают с kind
+    void drop_superseded(Kind kind) noexcept;
+
+    std::deque<Frame> frames_;
+    std::size_t capacity_;
+
+    /// @brief Сколько байт первого кадра уже в сокете
+    std::size_t offset_{0};
+
+    /// @brief Первый кадр нельзя вытеснять (частично отправлен)
+    bool front_pinned_{false};
+
+    uint64_t superseded_jobs_{0};
+};
+
+} // namespace quaxis::network
@@ -7,6 +7,18 @@
  */
 
 #include "server.hpp"
+#include "epoll_reactor.hpp"
+#include "uring_sender.hpp"
+#include "session_table.hpp"
+#include "block_multicast.hpp"
+#include "../mining/vardiff.hpp"
+#include "../core/async_log.hpp"
+#include "../core/block_arena.hpp"
+#include "../core/clock.hpp"
+#include "../core/latency_trace.hpp"
+#include "../core/stats_counter.hpp"
+#include "../core/thread_plan.hpp"
+#include "../core/timer_wheel.hpp"
 
 #include <sys/socket.h>
 #include <netinet/in.h>
@@ -16,6 +28,8 @@
 #include <poll.h>
 #include <cstring>
 
+#include <algorithm>
+#include <array>
 #include <thread>
 #include <mutex>
 #include <atomic>
@@ -25,44 +39,220 @@
 
 namespace quaxis::network {
 
+static_assert(MAX_JOB_FRAME_SIZE <= UringSender::MAX_FRAME_SIZE,
+              "Кадр задания должен помещаться в слот буфера io_uring");
+
 struct Server::Impl {
+    /**
+     * @brief Vardiff соединения
+     * 
+     * Shares приходят из потока соединения, пересчёт по таймеру -
+     * из cleanup_loop, поэтому у каждого контроллера свой mutex.
+     */
+    struct VardiffSlot {
+        std::mutex mutex;
+        mining::VardiffController controller;
+        
+        explicit VardiffSlot(const VardiffConfig& config) : controller(config) {}
+    };
+    
+    /**
+     * @brief ID и токен сессии соединения
+     * 
+     * RSP_HELLO может вернуть соединению прежний ID уже после приёма.
+     * Меняются только в потоке приёма соединения (recv или reactor),
+     * там же их читают callbacks телеметрии и отключения.
+     */
+    struct ConnectionSession {
+        uint32_t connection_id = 0;
+        uint64_t token = 0;  ///< 0 - сессии выключены
+        uint32_t epoch = 0;  ///< SessionTable: владение сессией
+    };
+    
+    struct ConnectionEntry;
+    
+    /**
+     * @brief Таймер колеса сервера
+     */
+    struct ServerTimer : core::TimerNode {
+        enum class Kind : uint8_t {
+            Heartbeat,  ///< ASIC молчит: послать CMD_HEARTBEAT
+            Deadline,   ///< Ответа на heartbeat нет: разорвать
+            Vardiff,    ///< Пересчёт сложности молчащего ASIC
+            TimeRoll,   ///< Сдвинуть timestamp текущего задания (CMD_UPDATE_TIME)
+            Session     ///< Grace период сессии истёк
+        };
+        
+        Kind kind;
+        
+        explicit ServerTimer(Kind k) : kind(k) {}
+    };
+    
+    /// @brief Таймер соединения
+    struct ConnectionTimer : ServerTimer {
+        ConnectionEntry* entry;
+        
+        ConnectionTimer(Kind k, ConnectionEntry* e) : ServerTimer(k), entry(e) {}
+    };
+    
+    /// @brief Таймер припаркованной сессии
+    struct SessionTimer : ServerTimer {
+        uint64_t token;
+        
+        explicit SessionTimer(uint64_t t) : ServerTimer(Kind::Session), token(t) {}
+    };
+    
+    /**
+     * @brief Запись соединения: место в списке, таймеры, список удаления
+     * 
+     * Создаётся в make_connection до запуска ввода-вывода (disconnected
+     * callback уже может сработать), удаляется в cleanup_tick после
+     * отключения. position и published - под connections_mutex, таймеры
+     * и bytes_at_ping - под wheel_mutex.
+     */
+    struct ConnectionEntry {
+        AsicConnection* conn;
+        std::shared_ptr<VardiffSlot> vardiff;
+        std::list<std::unique_ptr<AsicConnection>>::iterator position;
+        bool published = false;
+        
+        ConnectionTimer heartbeat{ServerTimer::Kind::Heartbeat, this};
+        ConnectionTimer deadline{ServerTimer::Kind::Deadline, this};
+        ConnectionTimer vardiff_timer{ServerTimer::Kind::Vardiff, this};
+        ConnectionTimer time_roll{ServerTimer::Kind::TimeRoll, this};
+        uint64_t bytes_at_ping = 0;
+        
+        /// @brief Следующий в списке удаления (reap_head)
+        ConnectionEntry* reap_next = nullptr;
+        
+        ConnectionEntry(AsicConnection* c, std::shared_ptr<VardiffSlot> slot)
+            : conn(c), vardiff(std::move(slot)) {}
+    };
+    
+    /**
+     * @brief Действие сработавшего таймера (выполняется вне wheel_mutex)
+     */
+    struct TimerAction {
+        ServerTimer::Kind kind;
+        AsicConnection* conn = nullptr;
+        std::shared_ptr<VardiffSlot> vardiff;
+        uint64_t token = 0;
+    };
+    
+    /// @brief Шаг колеса таймеров сервера
+    static constexpr auto WHEEL_TICK = std::chrono::seconds(1);
+    
     ServerConfig config;
     mining::JobManager& job_manager;
     
-    int listen_fd = -1;
+    // server.listeners: сокеты одного порта (SO_REUSEPORT при > 1)
+    std::vector<int> listen_fds;
     std::atomic<bool> running{false};
     
-    std::thread accept_thread;
+    // Потоки приёма по одному на сокет (сокеты reactor'ов принимают в них самих)
+    std::vector<std::thread> accept_threads;
     std::thread cleanup_thread;
     
+    // Общий исполнитель: очистка - таймер колеса вместо cleanup_thread
+    core::Executor* executor = nullptr;
+    core::Executor::TimerId cleanup_timer = 0;
+    
+    // engine = "epoll": потоки-reactor'ы; с одним сокетом соединения
+    // раздаются по кругу, с несколькими каждый reactor принимает свои
+    std::vector<std::unique_ptr<EpollReactor>> reactors;
+    std::size_t next_reactor = 0;
+    
+    // io_uring = true: пакетная рассылка заданий (nullptr если недоступен)
+    std::unique_ptr<UringSender> uring;
+    std::mutex uring_mutex;
+    
+    // server.multicast.enabled: CMD_BLOCK_NOTIFY до рассылки по TCP (nullptr - выключено)
+    std::unique_ptr<BlockMulticast> multicast;
+    
     mutable std::mutex connections_mutex;
     std::list<std::unique_ptr<AsicConnection>> connections;
     
+    // Кадры и списки соединений broadcast_job_set (под connections_mutex)
+    core::BlockArena broadcast_arena;
+    
     // Connection ID counter for unique per-connection identification
     std::atomic<uint32_t> next_connection_id{1};
     // Map connection pointer to connection ID for unregistration
     std::unordered_map<AsicConnection*, uint32_t> connection_ids;
     
+    // ID и токен сессии соединения (под connections_mutex): для передачи новому процессу
+    std::unordered_map<AsicConnection*, std::shared_ptr<ConnectionSession>> connection_sessions;
+    
+    // server.vardiff.enabled: контроллер на каждое соединение (под connections_mutex)
+    std::unordered_map<AsicConnection*, std::shared_ptr<VardiffSlot>> vardiff;
+    
+    // Записи соединений для таймеров и удаления (под connections_mutex)
+    std::unordered_map<AsicConnection*, std::unique_ptr<ConnectionEntry>> entries;
+    
+    // Отключившиеся соединения: disconnected callback кладёт запись без
+    // блокировок, cleanup_tick удаляет только их, не обходя весь список
+    std::atomic<ConnectionEntry*> reap_head{nullptr};
+    
+    // Сроки соединений и сессий; порядок блокировок: connections_mutex -> wheel_mutex
+    std::mutex wheel_mutex;
+    core::TimerWheel wheel;
+    const core::CoarseClock::time_point wheel_epoch = core::CoarseClock::now();
+    std::unordered_map<uint64_t, std::unique_ptr<SessionTimer>> session_timers;
+    std::vector<TimerAction> timer_actions;
+    
+    // mining.job_prefetch: буфер очереди заданий ASIC (под connections_mutex)
+    std::vector<mining::Job> queued_jobs = std::vector<mining::Job>(constants::MAX_JOB_PREFETCH);
+    
     AsicConnectedCallback connected_callback;
     AsicDisconnectedCallback disconnected_callback;
+    AsicShareCallback share_callback;
+    AsicJobLoadedCallback job_loaded_callback;
+
+    /**
+     * @brief Счётчики сервера (без блокировок, снимок собирает stats())
+     *
+     * Shares приходят из потоков всех соединений - счётчик шардирован
+     * по потокам; остальные поля пишет один поток (accept, cleanup или
+     * рассылка).
+     */
+    core::ShardedCounter<> total_shares;
+    alignas(core::CACHE_LINE_SIZE) core::RelaxedCounter total_connections;
+    core::RelaxedValue<std::size_t> active_connections;
+    core::RelaxedValue<uint32_t> total_hashrate;
+    alignas(core::CACHE_LINE_SIZE) core::RelaxedCounter total_jobs_sent;
     
-    mutable std::mutex stats_mutex;
-    ServerStats stats;
+    /// @brief Телеметрия чипов по ID соединения
+    FleetTelemetry fleet;
+    
+    /// @brief server.session_grace_seconds: сессии оборвавшихся ASIC
+    SessionTable sessions;
+    
+    /// @brief Статистика соединений (обновляет cleanup_loop раз в секунду)
+    std::atomic<std::shared_ptr<const std::vector<ConnectionSnapshot>>> connection_snapshots{
+        std::make_shared<const std::vector<ConnectionSnapshot>>()};
     
     Impl(const ServerConfig& cfg, mining::JobManager& jm)
         : config(cfg)
         , job_manager(jm)
+        // Кадр и три записи списков на соединение - без выхода за буфер
+        , broadcast_arena(core::BlockArena::DEFAULT_CAPACITY +
+                          cfg.max_connections * (sizeof(AnyJobFrame) + 4 * sizeof(void*)))
+        , sessions(std::chrono::seconds(cfg.session_grace_seconds))
     {}
     
     ~Impl() {
         stop();
     }
     
-    Result<void> start() {
-        // Создаём сокет
-        listen_fd = socket(AF_INET, SOCK_STREAM, 0);
-        if (listen_fd < 0) {
-            return Err<void>(
+    /**
+     * @brief Открыть неблокирующий listening сокет порта
+     * 
+     * @param reuse_port SO_REUSEPORT: несколько сокетов на одном порту
+     */
+    Result<int> open_listener(bool reuse_port) {
+        int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fd < 0) {
+            return Err<int>(
                 ErrorCode::NetworkConnectionFailed,
                 std::format("Не удалось создать сокет: {}", strerror(errno))
             );
@@ -70,10 +260,18 @@ struct Server::Impl {
         
         // Опции сокета
         int opt = 1;
-        setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+        if (reuse_port && setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt)) < 0) {
+            int error = errno;
+            close(fd);
+            return Err<int>(
+                ErrorCode::NetworkConnectionFailed,
+                std::format("SO_REUSEPORT недоступен: {}", strerror(error))
+            );
+        }
         
         // Bind
-        struct sockaddr_in addr;
+        struct sockaddr_in addr{};
         addr.sin_family = AF_INET;
         addr.sin_port = htons(config.port);
         
@@ -83,34 +281,134 @@ struct Server::Impl {
             inet_pton(AF_INET, config.bind_address.c_str(), &addr.sin_addr);
         }
         
-        if (bind(listen_fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0) {
-            close(listen_fd);
-            listen_fd = -1;
-            return Err<void>(
+        if (bind(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0) {
+            int error = errno;
+            close(fd);
+            return Err<int>(
                 ErrorCode::NetworkConnectionFailed,
                 std::format("Не удалось привязать сокет к {}:{}: {}",
-                           config.bind_address, config.port, strerror(errno))
+                           config.bind_address, config.port, strerror(error))
             );
         }
         
-        // Listen
-        if (listen(listen_fd, 16) < 0) {
-            close(listen_fd);
-            listen_fd = -1;
-            return Err<void>(
+        // Listen: очередь переживает волну переподключений после отключения питания
+        if (listen(fd, static_cast<int>(config.listen_backlog)) < 0) {
+            int error = errno;
+            close(fd);
+            return Err<int>(
                 ErrorCode::NetworkConnectionFailed,
-                std::format("Не удалось начать прослушивание: {}", strerror(errno))
+                std::format("Не удалось начать прослушивание: {}", strerror(error))
             );
         }
         
-        // Non-blocking
-        int flags = fcntl(listen_fd, F_GETFL, 0);
-        fcntl(listen_fd, F_SETFL, flags | O_NONBLOCK);
+        return fd;
+    }
+    
+    void close_listeners() {
+        for (int fd : listen_fds) {
+            close(fd);
+        }
+        listen_fds.clear();
+    }
+    
+    Result<void> start() {
+        const std::size_t listeners = std::max<std::size_t>(config.listeners, 1);
+        
+        // Reactor'ы epoll (соединения без собственных потоков);
+        // с несколькими сокетами у каждого reactor свой
+        std::size_t workers = 0;
+        if (config.engine == "epoll") {
+            workers = std::max<std::size_t>(config.worker_threads, 1);
+            if (listeners > 1) {
+                workers = std::max(workers, listeners);
+            }
+        }
+        const std::size_t sockets = listeners > 1 ? std::max(listeners, workers) : 1;
+        
+        for (std::size_t i = 0; i < sockets; ++i) {
+            auto fd = open_listener(sockets > 1);
+            if (!fd) {
+                close_listeners();
+                return Err<void>(fd.error().code, fd.error().message);
+            }
+            listen_fds.push_back(*fd);
+        }
+        
+        return start_io(workers);
+    }
+    
+    /**
+     * @brief Запустить reactor'ы, приём и очистку на открытых listen_fds
+     * 
+     * @param workers Reactor'ов epoll (0 - потоки на соединение); с
+     *        несколькими сокетами - по одному на сокет
+     */
+    Result<void> start_io(std::size_t workers) {
+        const std::size_t sockets = listen_fds.size();
+        
+        if (config.multicast.enabled) {
+            auto notifier = std::make_unique<BlockMulticast>(config.multicast);
+            if (auto result = notifier->open(); !result) {
+                close_listeners();
+                return result;
+            }
+            multicast = std::move(notifier);
+        }
+        
+        for (std::size_t i = 0; i < workers; ++i) {
+            auto reactor = std::make_unique<EpollReactor>();
+            if (auto result = reactor->start(); !result) {
+                reactors.clear();
+                multicast.reset();
+                close_listeners();
+                return result;
+            }
+            reactors.push_back(std::move(reactor));
+        }
+        
+        // io_uring для рассылки заданий; без поддержки ядра — обычная отправка
+        if (config.io_uring) {
+            auto sender = std::make_unique<UringSender>(config.max_connections);
+            if (sender->start()) {
+                uring = std::move(sender);
+            }
+        }
         
-        // Запускаем потоки
         running.store(true, std::memory_order_relaxed);
-        accept_thread = std::thread([this] { accept_loop(); });
-        cleanup_thread = std::thread([this] { cleanup_loop(); });
+        
+        // Reactor принимает соединения своего шарда в собственном потоке
+        if (sockets > 1 && !reactors.empty()) {
+            for (std::size_t i = 0; i < reactors.size(); ++i) {
+                const int fd = listen_fds[i];
+                EpollReactor* reactor = reactors[i].get();
+                auto result = reactor->set_listener(fd, [this, fd, reactor] {
+                    while (accept_connection(fd, reactor)) {}
+                });
+                if (!result) {
+                    running.store(false, std::memory_order_relaxed);
+                    for (auto& r : reactors) {
+                        r->stop();
+                    }
+                    reactors.clear();
+                    uring.reset();
+                    multicast.reset();
+                    close_listeners();
+                    return result;
+                }
+            }
+        } else {
+            for (int fd : listen_fds) {
+                accept_threads.emplace_back([this, fd] {
+                    core::enter_thread_role(core::ThreadRole::Fanout);
+                    accept_loop(fd);
+                });
+            }
+        }
+        if (executor) {
+            cleanup_timer = executor->schedule_every(std::chrono::seconds(1), [this] { cleanup_tick(); });
+        } else {
+            cleanup_thread = std::thread([this] { cleanup_loop(); });
+        }
         
         return {};
     }
@@ -118,17 +416,26 @@ struct Server::Impl {
     void stop() {
         running.store(false, std::memory_order_relaxed);
         
-        if (listen_fd >= 0) {
-            close(listen_fd);
-            listen_fd = -1;
-        }
-        
-        if (accept_thread.joinable()) {
-            accept_thread.join();
+        for (auto& thread : accept_threads) {
+            if (thread.joinable()) {
+                thread.join();
+            }
         }
+        accept_threads.clear();
         if (cleanup_thread.joinable()) {
             cleanup_thread.join();
         }
+        if (cleanup_timer != 0) {
+            executor->cancel(cleanup_timer);
+            cleanup_timer = 0;
+        }
+        
+        // Reactor'ы останавливаем до закрытия соединений и их сокетов приёма
+        for (auto& reactor : reactors) {
+            reactor->stop();
+        }
+        reactors.clear();
+        close_listeners();
         
         // Закрываем все соединения
         std::lock_guard<std::mutex> lock(connections_mutex);
@@ -136,9 +443,27 @@ struct Server::Impl {
             conn->stop();
         }
         connections.clear();
+        clear_entries();
+        
+        // Переподключаться больше некуда: extranonce припаркованных сессий свободны
+        for (uint32_t id : sessions.expire(SessionTable::Clock::time_point::max())) {
+            job_manager.unregister_connection(id);
+        }
     }
     
-    void accept_loop() {
+    /**
+     * @brief CMD_BLOCK_NOTIFY текущего шаблона (одна датаграмма на поколение)
+     */
+    void announce_block() {
+        if (!multicast) {
+            return;
+        }
+        if (auto job = job_manager.block_announcement()) {
+            multicast->announce(BlockNotifyMessage::from_job(*job));
+        }
+    }
+    
+    void accept_loop(int listen_fd) {
         while (running.load(std::memory_order_relaxed)) {
             struct pollfd pfd;
             pfd.fd = listen_fd;
@@ -153,22 +478,31 @@ struct Server::Impl {
             
             if (ret == 0) continue;
             
+            // Волна подключений разбирается целиком за одно пробуждение
             if (pfd.revents & POLLIN) {
-                accept_connection();
+                while (running.load(std::memory_order_relaxed) && accept_connection(listen_fd, nullptr)) {}
             }
         }
     }
     
-    void accept_connection() {
+    /**
+     * @brief Принять одно подключение
+     * 
+     * @param listen_fd Сокет, на котором ждёт подключение
+     * @param owner Reactor, в потоке которого идёт приём (nullptr - поток приёма)
+     * @return false если очередь сокета пуста
+     */
+    bool accept_connection(int listen_fd, EpollReactor* owner) {
         struct sockaddr_in client_addr;
         socklen_t addr_len = sizeof(client_addr);
         
-        int client_fd = accept(listen_fd, 
-                               reinterpret_cast<struct sockaddr*>(&client_addr),
-                               &addr_len);
+        int client_fd = accept4(listen_fd, 
+                                reinterpret_cast<struct sockaddr*>(&client_addr),
+                                &addr_len,
+                                SOCK_CLOEXEC);
         
         if (client_fd < 0) {
-            return;
+            return errno == EINTR || errno == ECONNABORTED;
         }
         
         // Проверяем лимит подключений
@@ -176,7 +510,7 @@ struct Server::Impl {
             std::lock_guard<std::mutex> lock(connections_mutex);
             if (connections.size() >= config.max_connections) {
                 close(client_fd);
-                return;
+                return true;
             }
         }
         
@@ -187,102 +521,797 @@ struct Server::Impl {
                                               addr_str, 
                                               ntohs(client_addr.sin_port));
         
-        // Get a unique connection ID for ExtrannonceManager
-        uint32_t connection_id = next_connection_id.fetch_add(1, std::memory_order_relaxed);
+        // Прошивка с токеном прежней сессии первым кадром шлёт RSP_HELLO:
+        // если он уже в сокете, соединение сразу получает прежний extranonce
+        auto session = std::make_shared<ConnectionSession>();
+        std::optional<HelloMessage> hello;
+        std::optional<ResumedSession> resumed;
+        if (sessions.enabled() && (hello = peek_hello(client_fd))) {
+            resumed = sessions.resume(hello->token, SessionTable::Clock::now());
+            if (resumed) {
+                session->token = hello->token;
+                session->epoch = resumed->epoch;
+            }
+        }
+        
+        std::optional<mining::PrecomputedJob> first_job;
+        if (resumed) {
+            session->connection_id = resumed->connection_id;
+        } else {
+            // Get a unique connection ID for ExtrannonceManager
+            session->connection_id = next_connection_id.fetch_add(1, std::memory_order_relaxed);
+            
+            // Extranonce из пула mining.prelease_pool приходит с готовым кадром
+            // задания; пул пуст - обычная регистрация и сборка задания
+            first_job = job_manager.claim_preleased_job(session->connection_id);
+            if (!first_job && job_manager.register_connection(session->connection_id) == 0) {
+                // Дальше - extranonce соседней площадки или узла кластера
+                QUAXIS_LOG_RATE(Warning, 1, "Диапазон extranonce узла исчерпан, {} отклонён", remote_addr);
+                close(client_fd);
+                return true;
+            }
+            if (sessions.enabled()) {
+                session->token = sessions.open(session->connection_id);
+            }
+        }
+        const uint32_t connection_id = session->connection_id;
+        
+        auto conn = make_connection(client_fd, remote_addr, session, nullptr);
+        AsicConnection* conn_ptr = conn.get();
+        
+        // Согласование пакетных shares и начальная сложность: раньше любого задания
+        if (config.share_batch_size > 1) {
+            conn->send_share_batch_config(
+                static_cast<uint8_t>(config.share_batch_size),
+                static_cast<uint16_t>(config.share_batch_flush_ms)
+            );
+        }
+        send_initial_difficulty(*conn);
+        if (session->token != 0) {
+            conn->send_session(session->token);
+        }
+        
+        if (!publish_connection(std::move(conn), owner)) {
+            return true;
+        }
+        
+        // Обновляем статистику
+        total_connections.add();
+        
+        // Callback
+        if (connected_callback) {
+            connected_callback(remote_addr);
+        }
+        
+        // Send job with this connection's unique extranonce
+        if (resumed) {
+            // ASIC продолжает прежнее задание, если оно ещё текущее
+            if (!job_is_current(connection_id, hello->job_id)) {
+                send_current_job(*conn_ptr, connection_id);
+            }
+        } else if (first_job) {
+            std::lock_guard<std::mutex> lock(connections_mutex);
+            if (first_job->job.job_id != 0 && connection_ids.contains(conn_ptr)) {
+                send_precomputed(*conn_ptr, *first_job);
+                send_job_queue(*conn_ptr, connection_id);
+            }
+        } else {
+            send_current_job(*conn_ptr, connection_id);
+        }
         
-        // Register connection with JobManager to get unique extranonce
-        job_manager.register_connection(connection_id);
+        return true;
+    }
+    
+    /**
+     * @brief Создать соединение с callbacks и запустить его ввод-вывод
+     * 
+     * Соединение ещё не в списке: до publish_connection() ему можно
+     * отправить кадры согласования.
+     * 
+     * @param restored Незавершённый ввод-вывод сокета прежнего процесса
+     */
+    std::unique_ptr<AsicConnection> make_connection(int client_fd,
+                                                    const std::string& remote_addr,
+                                                    std::shared_ptr<ConnectionSession> session,
+                                                    const DetachedSocket* restored) {
+        const uint32_t connection_id = session->connection_id;
         
         // Создаём соединение
-        auto conn = std::make_unique<AsicConnection>(client_fd, remote_addr);
+        auto conn = std::make_unique<AsicConnection>(client_fd, remote_addr, config.socket);
         AsicConnection* conn_ptr = conn.get();
         
+        // config.vardiff меняет set_vardiff() под connections_mutex
+        VardiffConfig vardiff_config;
+        {
+            std::lock_guard<std::mutex> lock(connections_mutex);
+            vardiff_config = config.vardiff;
+        }
+        std::shared_ptr<VardiffSlot> vardiff_slot;
+        if (vardiff_config.enabled) {
+            vardiff_slot = std::make_shared<VardiffSlot>(vardiff_config);
+        }
+        
         // Store connection ID mapping
+        ConnectionEntry* entry = nullptr;
         {
             std::lock_guard<std::mutex> lock(connections_mutex);
             connection_ids[conn_ptr] = connection_id;
+            connection_sessions[conn_ptr] = session;
+            if (vardiff_slot) {
+                vardiff[conn_ptr] = vardiff_slot;
+            }
+            auto& slot = entries[conn_ptr];
+            slot = std::make_unique<ConnectionEntry>(conn_ptr, vardiff_slot);
+            entry = slot.get();
         }
         
         // Устанавливаем callbacks
         std::string addr_copy = remote_addr;
         
-        conn->set_share_callback([this](const mining::Share& share) {
-            on_share_received(share);
+        conn->set_share_callback([this, conn_ptr, vardiff_slot, connection_id](const mining::Share& share) {
+            uint32_t difficulty = 0;
+            if (vardiff_slot) {
+                auto now = mining::VardiffController::Clock::now();
+                std::optional<uint32_t> retarget;
+                {
+                    std::lock_guard<std::mutex> lock(vardiff_slot->mutex);
+                    retarget = vardiff_slot->controller.on_share(now);
+                    difficulty = vardiff_slot->controller.share_difficulty(now);
+                }
+                if (retarget) {
+                    conn_ptr->send_difficulty(*retarget);
+                }
+            }
+            mining::Share tagged = share;
+            tagged.connection_id = connection_id;
+            on_share_received(tagged, difficulty);
+        });
+        
+        conn->set_telemetry_callback([this, session](ByteSpan payload) {
+            // Повреждённый кадр: ASIC выпадает из сводки до keyframe
+            (void)fleet.apply(session->connection_id, payload);
         });
         
-        conn->set_disconnected_callback([this, addr_copy, conn_ptr, connection_id]() {
-            // Unregister connection from JobManager
-            job_manager.unregister_connection(connection_id);
+        conn->set_hello_callback([this, conn_ptr, session](const HelloMessage& msg) {
+            resume_session(*conn_ptr, *session, msg);
+        });
+        
+        conn->set_job_loaded_callback([this, connection_id](const JobLoadedMessage&,
+                                                            std::optional<std::chrono::nanoseconds> since_sent) {
+            if (job_loaded_callback) {
+                job_loaded_callback(connection_id, since_sent);
+            }
+        });
+        
+        conn->set_disconnected_callback([this, addr_copy, conn_ptr, session, entry]() {
+            // Сессия ждёт переподключения: extranonce остаётся за соединением;
+            // сессию, уже забранную новым соединением, не трогаем
+            auto parked = ParkResult::Unknown;
+            if (session->token != 0) {
+                parked = sessions.park(session->token, session->epoch, SessionTable::Clock::now());
+            }
+            if (parked == ParkResult::Parked) {
+                schedule_session_expiry(session->token);
+            }
+            if (parked == ParkResult::Unknown) {
+                // Unregister connection from JobManager
+                job_manager.unregister_connection(session->connection_id);
+            }
+            if (parked != ParkResult::Superseded) {
+                fleet.remove(session->connection_id);
+            }
             
             // Clean up connection ID mapping to prevent memory leak
             {
                 std::lock_guard<std::mutex> lock(connections_mutex);
                 connection_ids.erase(conn_ptr);
+                connection_sessions.erase(conn_ptr);
+                vardiff.erase(conn_ptr);
             }
             
             on_disconnected(addr_copy);
+            
+            // Соединение удалит cleanup_tick
+            push_reap(entry);
         });
         
-        conn->start();
+        // Поток байт прежнего процесса продолжается с того же места
+        if (restored) {
+            conn->restore_io(restored->unparsed, restored->unsent);
+        }
         
-        // Добавляем в список
+        if (reactors.empty()) {
+            conn->start();
+        } else {
+            conn->start_external_io();
+        }
+        
+        return conn;
+    }
+    
+    /**
+     * @brief Начальная сложность vardiff соединения
+     */
+    void send_initial_difficulty(AsicConnection& conn) {
+        std::shared_ptr<VardiffSlot> slot;
+        {
+            std::lock_guard<std::mutex> lock(connections_mutex);
+            if (auto it = vardiff.find(&conn); it != vardiff.end()) {
+                slot = it->second;
+            }
+        }
+        if (slot) {
+            conn.send_difficulty(slot->controller.difficulty());
+        }
+    }
+    
+    /**
+     * @brief Добавить соединение в список и зарегистрировать в reactor
+     * 
+     * @param owner Reactor, в потоке которого идёт приём (nullptr - по кругу)
+     * @return false если reactor не принял сокет (соединение уже закрыто)
+     */
+    bool publish_connection(std::unique_ptr<AsicConnection> conn, EpollReactor* owner) {
+        AsicConnection* conn_ptr = conn.get();
+        
+        EpollReactor* reactor = owner;
+        if (!reactors.empty() && !reactor) {
+            reactor = reactors[next_reactor++ % reactors.size()].get();
+        }
+        
+        // Добавляем в список и ставим таймеры соединения
         {
             std::lock_guard<std::mutex> lock(connections_mutex);
             connections.push_back(std::move(conn));
+            active_connections.store(connections.size());
+            
+            if (auto it = entries.find(conn_ptr); it != entries.end()) {
+                ConnectionEntry& entry = *it->second;
+                entry.position = std::prev(connections.end());
+                entry.published = true;
+                
+                std::lock_guard<std::mutex> wheel_lock(wheel_mutex);
+                if (config.heartbeat_interval_seconds > 0) {
+                    wheel.schedule(entry.heartbeat, config.heartbeat_interval_seconds);
+                }
+                if (entry.vardiff) {
+                    wheel.schedule(entry.vardiff_timer, 1);
+                }
+                if (config.ntime_roll_seconds > 0) {
+                    wheel.schedule(entry.time_roll, config.ntime_roll_seconds);
+                }
+            }
         }
         
-        // Обновляем статистику
+        // Регистрируем в reactor после добавления: при ошибке соединение
+        // закрывается обычным путём и удаляется cleanup_tick
+        if (reactor && !reactor->add(*conn_ptr)) {
+            conn_ptr->on_closed();
+            return false;
+        }
+        return true;
+    }
+    
+    // =========================================================================
+    // Передача новому процессу
+    // =========================================================================
+    
+    /**
+     * @brief Остановить приём и отсоединить сокеты, не закрывая их
+     */
+    ServerHandoff detach_for_handoff() {
+        ServerHandoff handoff;
+        
+        running.store(false, std::memory_order_relaxed);
+        for (auto& thread : accept_threads) {
+            if (thread.joinable()) {
+                thread.join();
+            }
+        }
+        accept_threads.clear();
+        if (cleanup_thread.joinable()) {
+            cleanup_thread.join();
+        }
+        if (cleanup_timer != 0) {
+            executor->cancel(cleanup_timer);
+            cleanup_timer = 0;
+        }
+        
+        // После остановки reactor'ов соединения никто не читает
+        for (auto& reactor : reactors) {
+            reactor->stop();
+        }
+        reactors.clear();
+        uring.reset();
+        multicast.reset();
+        
+        handoff.listen_fds = std::move(listen_fds);
+        listen_fds.clear();
+        handoff.parked_sessions = sessions.take_parked();
+        handoff.next_connection_id = next_connection_id.load(std::memory_order_relaxed);
+        
+        // Потоки соединений (engine = "threaded") могут ещё вызвать
+        // disconnected callback, который берёт connections_mutex
+        std::list<std::unique_ptr<AsicConnection>> detached;
         {
-            std::lock_guard<std::mutex> lock(stats_mutex);
-            stats.total_connections++;
-            stats.active_connections = connections.size();
+            std::lock_guard<std::mutex> lock(connections_mutex);
+            detached.swap(connections);
+            active_connections.store(0);
         }
         
-        // Callback
-        if (connected_callback) {
-            connected_callback(remote_addr);
+        for (auto& conn : detached) {
+            DetachedSocket socket = conn->detach();
+            
+            std::shared_ptr<ConnectionSession> session;
+            {
+                std::lock_guard<std::mutex> lock(connections_mutex);
+                if (auto it = connection_sessions.find(conn.get()); it != connection_sessions.end()) {
+                    session = it->second;
+                }
+            }
+            if (!session || socket.fd < 0) {
+                // Отключилось до остановки: прежний процесс уже всё освободил
+                if (socket.fd >= 0) {
+                    close(socket.fd);
+                }
+                continue;
+            }
+            if (session->token != 0) {
+                sessions.close(session->token);
+            }
+            fleet.remove(session->connection_id);
+            handoff.connections.push_back(HandedOffConnection{
+                std::move(socket), conn->remote_address(), session->connection_id, session->token
+            });
         }
         
-        // Send job with this connection's unique extranonce
+        std::lock_guard<std::mutex> lock(connections_mutex);
+        connection_ids.clear();
+        connection_sessions.clear();
+        vardiff.clear();
+        clear_entries();
+        return handoff;
+    }
+    
+    /**
+     * @brief Запуститься на сокетах прежнего процесса
+     */
+    Result<void> resume(ServerHandoff handoff, bool jobs_restored) {
+        auto close_connections = [&handoff] {
+            for (const auto& handed : handoff.connections) {
+                close(handed.socket.fd);
+            }
+        };
+        if (handoff.listen_fds.empty()) {
+            close_connections();
+            return Err<void>(ErrorCode::NetworkConnectionFailed, "Передача без listening сокетов");
+        }
+        
+        listen_fds = std::move(handoff.listen_fds);
+        next_connection_id.store(std::max<uint32_t>(handoff.next_connection_id, 1),
+                                 std::memory_order_relaxed);
+        
+        // Сокетов столько, сколько открыл прежний процесс: с несколькими
+        // у каждого reactor свой
+        std::size_t workers = 0;
+        if (config.engine == "epoll") {
+            workers = listen_fds.size() > 1 ? listen_fds.size()
+                                            : std::max<std::size_t>(config.worker_threads, 1);
+        }
+        if (auto result = start_io(workers); !result) {
+            close_connections();
+            return result;
+        }
+        
+        const auto now = SessionTable::Clock::now();
+        if (sessions.enabled()) {
+            for (const auto& parked : handoff.parked_sessions) {
+                sessions.adopt(parked.token, parked.connection_id, true, now);
+                schedule_session_expiry(parked.token);
+            }
+        }
+        
+        for (auto& handed : handoff.connections) {
+            // Аренда не перенесена: соединение получает новый extranonce
+            if (!job_manager.get_connection_extranonce(handed.connection_id)) {
+                if (job_manager.register_connection(handed.connection_id) == 0) {
+                    QUAXIS_LOG_RATE(Warning, 1, "Диапазон extranonce узла исчерпан, {} отклонён",
+                                    handed.remote_address);
+                    close(handed.socket.fd);
+                    continue;
+                }
+                jobs_restored = false;
+            }
+            
+            auto session = std::make_shared<ConnectionSession>();
+            session->connection_id = handed.connection_id;
+            if (sessions.enabled() && handed.session_token != 0) {
+                session->token = handed.session_token;
+                sessions.adopt(handed.session_token, handed.connection_id, false, now);
+            }
+            
+            auto conn = make_connection(handed.socket.fd, handed.remote_address, session, &handed.socket);
+            AsicConnection* conn_ptr = conn.get();
+            send_initial_difficulty(*conn);
+            if (!publish_connection(std::move(conn), nullptr)) {
+                continue;
+            }
+            
+            total_connections.add();
+            if (connected_callback) {
+                connected_callback(handed.remote_address);
+            }
+            
+            // Задания не перенесены: ASIC получает задание по текущему шаблону
+            if (!jobs_restored) {
+                send_current_job(*conn_ptr, handed.connection_id);
+            }
+        }
+        
+        return {};
+    }
+    
+    /**
+     * @brief Собрать и отправить задание по текущему шаблону
+     */
+    void send_current_job(AsicConnection& conn, uint32_t connection_id) {
         if (auto job = job_manager.get_next_job_for_connection(connection_id)) {
+            // Соединение живо, пока есть в connection_ids: потоки приёма
+            // добавляют соединения параллельно, back() может быть чужим
             std::lock_guard<std::mutex> lock(connections_mutex);
-            if (!connections.empty()) {
-                connections.back()->send_job(*job);
+            if (connection_ids.contains(&conn)) {
+                conn.send_job(*job);
+                send_job_queue(conn, connection_id);
             }
         }
     }
     
+    /**
+     * @brief Задание ASIC - текущего блока и с extranonce соединения
+     */
+    bool job_is_current(uint32_t connection_id, uint32_t job_id) const {
+        mining::Job job;
+        if (job_id == 0 || job_manager.lookup_job(job_id, job) != mining::JobLookup::Current) {
+            return false;
+        }
+        return job_manager.get_connection_extranonce(connection_id) == job.extranonce;
+    }
+    
+    /**
+     * @brief Токен из RSP_HELLO, уже пришедшего в сокет
+     * 
+     * Кадр не снимается с сокета: парсер соединения разберёт его, и
+     * resume_session() увидит собственный токен.
+     */
+    static std::optional<HelloMessage> peek_hello(int fd) {
+        std::array<uint8_t, HELLO_FRAME_SIZE> frame;
+        ssize_t n = recv(fd, frame.data(), frame.size(), MSG_PEEK | MSG_DONTWAIT);
+        if (n != static_cast<ssize_t>(frame.size()) || frame[0] != static_cast<uint8_t>(Response::Hello)) {
+            return std::nullopt;
+        }
+        auto msg = HelloMessage::deserialize(ByteSpan(frame.data() + 1, frame.size() - 1));
+        if (!msg) {
+            return std::nullopt;
+        }
+        return *msg;
+    }
+    
+    /**
+     * @brief RSP_HELLO после приёма: вернуть соединению прежнюю сессию
+     * 
+     * Соединение уже получило новый extranonce и задание; прежний ID
+     * занимает его место, новый освобождается. Shares обоих заданий
+     * засчитываются: задания проверяются по job_id.
+     */
+    void resume_session(AsicConnection& conn, ConnectionSession& session, const HelloMessage& hello) {
+        if (!sessions.enabled() || hello.token == 0 || hello.token == session.token) {
+            return;  // Возобновлена при приёме (или сессии выключены)
+        }
+        auto resumed = sessions.resume(hello.token, SessionTable::Clock::now());
+        if (!resumed) {
+            return;  // Неизвестный или истёкший токен: остаётся новый extranonce
+        }
+        
+        const uint32_t fresh_id = session.connection_id;
+        sessions.close(session.token);
+        session.connection_id = resumed->connection_id;
+        session.token = hello.token;
+        session.epoch = resumed->epoch;
+        bool alive = false;
+        {
+            std::lock_guard<std::mutex> lock(connections_mutex);
+            if (auto it = connection_ids.find(&conn); it != connection_ids.end()) {
+                it->second = resumed->connection_id;
+                alive = true;
+            }
+        }
+        job_manager.unregister_connection(fresh_id);
+        fleet.remove(fresh_id);
+        if (alive) {
+            conn.send_session(hello.token);
+        }
+    }
+    
+    /**
+     * @brief Отправить готовое задание
+     * 
+     * Задание со слотами версий или арендой не помещается в готовые 48 байт.
+     */
+    static bool send_precomputed(AsicConnection& conn, const mining::PrecomputedJob& pj) {
+        return NewJobMessage{pj.job}.is_plain() ? conn.send_job_message(pj.message) : conn.send_job(pj.job);
+    }
+    
+    /**
+     * @brief Отправить очередь заданий ASIC после текущего (mining.job_prefetch)
+     * 
+     * Вызывается под connections_mutex.
+     * 
+     * @return std::size_t Количество отправленных заданий
+     */
+    std::size_t send_job_queue(AsicConnection& conn, uint32_t connection_id) {
+        auto count = job_manager.get_queued_jobs_for_connection(connection_id, queued_jobs);
+        if (count == 0 || !conn.send_queued_jobs(std::span(queued_jobs).first(count))) {
+            return 0;
+        }
+        return count;
+    }
+    
     void cleanup_loop() {
         while (running.load(std::memory_order_relaxed)) {
             std::this_thread::sleep_for(std::chrono::seconds(1));
-            
-            std::lock_guard<std::mutex> lock(connections_mutex);
-            
-            // Удаляем отключённые соединения
-            connections.remove_if([](const auto& conn) {
-                return !conn->is_connected();
+            cleanup_tick();
+        }
+    }
+    
+    // =========================================================================
+    // Колесо таймеров и удаление соединений
+    // =========================================================================
+    
+    /**
+     * @brief Шаг колеса, соответствующий моменту time
+     */
+    uint64_t wheel_tick(core::CoarseClock::time_point time) const {
+        return static_cast<uint64_t>(std::max<int64_t>((time - wheel_epoch) / WHEEL_TICK, 0));
+    }
+    
+    /**
+     * @brief Поставить таймер истечения припаркованной сессии
+     * 
+     * Срок - от текущего времени, а не от шага колеса: шаг мог не
+     * продвигаться, пока cleanup_tick не шёл.
+     */
+    void schedule_session_expiry(uint64_t token) {
+        const auto expires_at = core::CoarseClock::now() + sessions.grace();
+        // Округление вверх: таймер не срабатывает раньше SessionTable
+        const uint64_t due = wheel_tick(expires_at) + 1;
+        
+        std::lock_guard<std::mutex> lock(wheel_mutex);
+        auto& timer = session_timers[token];
+        if (!timer) {
+            timer = std::make_unique<SessionTimer>(token);
+        }
+        wheel.schedule(*timer, due > wheel.now() ? due - wheel.now() : 1);
+    }
+    
+    /**
+     * @brief Снять все записи и таймеры (вызывать под connections_mutex)
+     */
+    void clear_entries() {
+        {
+            std::lock_guard<std::mutex> lock(wheel_mutex);
+            wheel.clear();
+            session_timers.clear();
+        }
+        reap_head.store(nullptr, std::memory_order_relaxed);
+        entries.clear();
+    }
+    
+    /**
+     * @brief Продвинуть колесо до текущего шага и выполнить сработавшее
+     */
+    void advance_timers() {
+        std::vector<TimerAction> actions;
+        {
+            std::lock_guard<std::mutex> lock(wheel_mutex);
+            wheel.advance(wheel_tick(core::CoarseClock::now()), [this](core::TimerNode& node) {
+                on_timer(static_cast<ServerTimer&>(node));
             });
-            
-            // Обновляем статистику
-            {
-                std::lock_guard<std::mutex> slock(stats_mutex);
-                stats.active_connections = connections.size();
-                
-                // Суммируем хешрейт
-                uint32_t total_hashrate = 0;
-                for (const auto& conn : connections) {
-                    total_hashrate += conn->stats().last_hashrate;
+            actions.swap(timer_actions);
+        }
+        
+        // Отправка и разрыв - без wheel_mutex: записи соединений удаляет
+        // только cleanup_tick, после этого шага
+        auto now = mining::VardiffController::Clock::now();
+        for (auto& action : actions) {
+            switch (action.kind) {
+                case ServerTimer::Kind::Heartbeat:
+                    action.conn->send_heartbeat();
+                    break;
+                case ServerTimer::Kind::Deadline:
+                    QUAXIS_LOG_RATE(Warning, 1, "ASIC {} не ответил на heartbeat, соединение разорвано",
+                                    action.conn->remote_address());
+                    action.conn->abort();
+                    break;
+                case ServerTimer::Kind::Vardiff: {
+                    // Снижаем сложность ASIC, переставших присылать shares
+                    std::optional<uint32_t> retarget;
+                    {
+                        std::lock_guard<std::mutex> slot_lock(action.vardiff->mutex);
+                        retarget = action.vardiff->controller.on_tick(now);
+                    }
+                    if (retarget) {
+                        action.conn->send_difficulty(*retarget);
+                    }
+                    break;
+                }
+                case ServerTimer::Kind::TimeRoll: {
+                    // Текущее задание ASIC догоняет часы без нового midstate
+                    const uint32_t job_id = action.conn->current_job_id();
+                    if (job_id == 0) {
+                        break;
+                    }
+                    if (auto job = job_manager.roll_job_time(job_id, unix_now())) {
+                        action.conn->send_time_update(job_id, job->timestamp);
+                    }
+                    break;
+                }
+                case ServerTimer::Kind::Session:
+                    // ASIC не вернулся за grace период: его extranonce свободен
+                    if (auto id = sessions.expire_one(action.token, SessionTable::Clock::now())) {
+                        job_manager.unregister_connection(*id);
+                    }
+                    break;
+            }
+        }
+        actions.clear();
+        
+        std::lock_guard<std::mutex> lock(wheel_mutex);
+        if (timer_actions.empty()) {
+            timer_actions.swap(actions);  // Буфер переиспользуется следующим шагом
+        }
+    }
+    
+    /// @brief Unix время для ntime roll
+    static uint32_t unix_now() noexcept {
+        return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count());
+    }
+    
+    /**
+     * @brief Сработавший таймер (под wheel_mutex): перепоставить и записать действие
+     */
+    void on_timer(ServerTimer& timer) {
+        if (timer.kind == ServerTimer::Kind::Session) {
+            auto& session_timer = static_cast<SessionTimer&>(timer);
+            const uint64_t token = session_timer.token;
+            timer_actions.push_back({timer.kind, nullptr, nullptr, token});
+            session_timers.erase(token);  // Узел уже снят из колеса
+            return;
+        }
+        
+        ConnectionEntry& entry = *static_cast<ConnectionTimer&>(timer).entry;
+        switch (timer.kind) {
+            case ServerTimer::Kind::Heartbeat: {
+                wheel.schedule(entry.heartbeat, config.heartbeat_interval_seconds);
+                const uint64_t received = entry.conn->bytes_received();
+                if (received != entry.bytes_at_ping) {
+                    entry.bytes_at_ping = received;  // ASIC присылал данные: пинговать незачем
+                } else if (!entry.deadline.armed()) {
+                    timer_actions.push_back({timer.kind, entry.conn, nullptr, 0});
+                    if (config.heartbeat_timeout_seconds > 0) {
+                        wheel.schedule(entry.deadline, config.heartbeat_timeout_seconds);
+                    }
+                }
+                break;
+            }
+            case ServerTimer::Kind::Deadline:
+                // Любой кадр после heartbeat - ответ
+                if (entry.conn->bytes_received() == entry.bytes_at_ping) {
+                    timer_actions.push_back({timer.kind, entry.conn, nullptr, 0});
                 }
-                stats.total_hashrate = total_hashrate;
+                break;
+            case ServerTimer::Kind::Vardiff:
+                wheel.schedule(entry.vardiff_timer, 1);
+                timer_actions.push_back({timer.kind, entry.conn, entry.vardiff});
+                break;
+            case ServerTimer::Kind::TimeRoll:
+                wheel.schedule(entry.time_roll, config.ntime_roll_seconds);
+                timer_actions.push_back({timer.kind, entry.conn, nullptr, 0});
+                break;
+            case ServerTimer::Kind::Session:
+                break;
+        }
+    }
+    
+    /**
+     * @brief Положить запись в список удаления (без блокировок)
+     */
+    void push_reap(ConnectionEntry* entry) {
+        entry->reap_next = reap_head.load(std::memory_order_relaxed);
+        while (!reap_head.compare_exchange_weak(entry->reap_next, entry,
+                                                std::memory_order_release,
+                                                std::memory_order_relaxed)) {}
+    }
+    
+    /**
+     * @brief Удалить соединения из списка удаления
+     * 
+     * Берёт только отключившиеся соединения: O(1) на каждое, весь список
+     * не обходится. Соединения разрушаются вне connections_mutex.
+     */
+    void reap_connections() {
+        ConnectionEntry* entry = reap_head.exchange(nullptr, std::memory_order_acquire);
+        if (!entry) {
+            return;
+        }
+        
+        std::list<std::unique_ptr<AsicConnection>> dead;
+        ConnectionEntry* retry = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(connections_mutex);
+            while (entry) {
+                ConnectionEntry* next = entry->reap_next;
+                // reactor снимает флаг после disconnected callback; ещё не
+                // опубликованное соединение ждёт publish_connection
+                if (!entry->published || entry->conn->is_connected()) {
+                    entry->reap_next = retry;
+                    retry = entry;
+                } else {
+                    {
+                        std::lock_guard<std::mutex> wheel_lock(wheel_mutex);
+                        wheel.cancel(entry->heartbeat);
+                        wheel.cancel(entry->deadline);
+                        wheel.cancel(entry->vardiff_timer);
+                        wheel.cancel(entry->time_roll);
+                    }
+                    dead.splice(dead.end(), connections, entry->position);
+                    entries.erase(entry->conn);
+                }
+                entry = next;
             }
+            active_connections.store(connections.size());
+        }
+        
+        // Отложенные - обратно до следующего шага
+        while (retry) {
+            ConnectionEntry* next = retry->reap_next;
+            push_reap(retry);
+            retry = next;
+        }
+    }
+    
+    /**
+     * @brief Очистка раз в секунду: таймеры, отключённые соединения, статистика
+     */
+    void cleanup_tick() {
+        // Пул заранее арендованных extranonce - снова до полного после приёма
+        job_manager.refresh_prelease_pool();
+        
+        // Heartbeat, vardiff и истёкшие сессии - только сработавшие таймеры
+        advance_timers();
+        reap_connections();
+        
+        std::lock_guard<std::mutex> lock(connections_mutex);
+        
+        // Суммируем хешрейт и снимаем статистику соединений
+        auto snapshots = std::make_shared<std::vector<ConnectionSnapshot>>();
+        snapshots->reserve(connections.size());
+        uint32_t hashrate = 0;
+        for (const auto& conn : connections) {
+            auto conn_stats = conn->stats();
+            hashrate += conn_stats.last_hashrate;
+            snapshots->push_back({conn->remote_address(), conn_stats});
         }
+        total_hashrate.store(hashrate);
+        connection_snapshots.store(std::move(snapshots), std::memory_order_release);
     }
     
-    void on_share_received(const mining::Share& /*share*/) {
-        std::lock_guard<std::mutex> lock(stats_mutex);
-        stats.total_shares++;
+    void on_share_received(const mining::Share& share, uint32_t difficulty) {
+        total_shares.add();
         
-        // Валидация share будет в отдельном компоненте
+        if (share_callback) {
+            share_callback(share, difficulty);
+        }
     }
     
     void on_disconnected(const std::string& addr) {
@@ -291,6 +1320,58 @@ struct Server::Impl {
         }
     }
     
+    /**
+     * @brief Разослать кадры заданий одним пакетом io_uring
+     * 
+     * Вызывается под connections_mutex. Соединения, сокет которых занят
+     * (очередь не пуста), получают задание обычным путём через fallback.
+     * 
+     * @param frame_for Кадр для соединения (пустой span — пропустить)
+     * @param fallback Отправка обычным путём
+     * @return uint64_t Количество разосланных заданий
+     */
+    template<typename FrameFor, typename Fallback>
+    uint64_t uring_broadcast(FrameFor&& frame_for, Fallback&& fallback) {
+        std::vector<AsicConnection*> claimed;
+        std::vector<UringFrame> frames;
+        claimed.reserve(connections.size());
+        frames.reserve(connections.size());
+        uint64_t sent = 0;
+        
+        for (auto& conn : connections) {
+            if (!conn->is_connected()) {
+                continue;
+            }
+            ByteSpan frame = frame_for(*conn);
+            if (frame.empty()) {
+                continue;
+            }
+            int fd = conn->begin_direct_job_send();
+            if (fd < 0) {
+                if (fallback(*conn)) {
+                    ++sent;
+                }
+                continue;
+            }
+            claimed.push_back(conn.get());
+            frames.push_back(UringFrame{fd, frame});
+        }
+        
+        if (!frames.empty()) {
+            std::vector<int> results(frames.size());
+            {
+                std::lock_guard<std::mutex> lock(uring_mutex);
+                uring->submit(frames, results);
+            }
+            for (std::size_t i = 0; i < claimed.size(); ++i) {
+                claimed[i]->end_direct_job_send(frames[i].data, results[i]);
+            }
+            sent += claimed.size();
+        }
+        
+        return sent;
+    }
+    
     void broadcast(const std::function<void(AsicConnection&)>& action) {
         std::lock_guard<std::mutex> lock(connections_mutex);
         for (auto& conn : connections) {
@@ -320,17 +1401,195 @@ void Server::stop() {
     impl_->stop();
 }
 
+void Server::set_executor(core::Executor* executor) {
+    impl_->executor = executor;
+}
+
+ServerHandoff Server::detach_for_handoff() {
+    return impl_->detach_for_handoff();
+}
+
+Result<void> Server::resume(ServerHandoff handoff, bool jobs_restored) {
+    return impl_->resume(std::move(handoff), jobs_restored);
+}
+
 bool Server::is_running() const noexcept {
     return impl_->running.load(std::memory_order_relaxed);
 }
 
 void Server::broadcast_job(const mining::Job& job) {
-    impl_->broadcast([&job](AsicConnection& conn) {
-        conn.send_job(job);
-    });
+    core::trace_point(core::TraceStage::BroadcastBegin);
     
-    std::lock_guard<std::mutex> lock(impl_->stats_mutex);
-    impl_->stats.total_jobs_sent++;
+    if (impl_->uring) {
+        // Один кадр на всех: все сокеты в одном пакете SQE
+        AnyJobFrame frame;
+        ByteSpan data(frame.data(), NewJobMessage{job}.encode_any(frame));
+        std::lock_guard<std::mutex> lock(impl_->connections_mutex);
+        impl_->uring_broadcast(
+            [data](AsicConnection&) { return data; },
+            [&job](AsicConnection& conn) { return conn.send_job(job); }
+        );
+    } else {
+        impl_->broadcast([&job](AsicConnection& conn) {
+            conn.send_job(job);
+        });
+    }
+    
+    core::trace_point(core::TraceStage::BroadcastDone);
+    
+    impl_->total_jobs_sent.add();
+}
+
+void Server::broadcast_job_set(std::span<const mining::PrecomputedJob> jobs) {
+    core::trace_point(core::TraceStage::BroadcastBegin);
+    
+    // Вся сеть ASIC узнаёт о блоке одной датаграммой, TCP задания подтверждают
+    impl_->announce_block();
+    uint64_t sent = 0;
+    
+    {
+        std::lock_guard<std::mutex> lock(impl_->connections_mutex);
+        
+        // Буферы прошлого блока больше не нужны
+        impl_->broadcast_arena.reset();
+        auto* arena = impl_->broadcast_arena.resource();
+        
+        auto find_job = [&](AsicConnection& conn) -> const mining::PrecomputedJob* {
+            auto id_it = impl_->connection_ids.find(&conn);
+            if (id_it == impl_->connection_ids.end()) {
+                return nullptr;
+            }
+            auto it = std::lower_bound(
+                jobs.begin(), jobs.end(), id_it->second,
+                [](const mining::PrecomputedJob& pj, uint32_t id) { return pj.connection_id < id; }
+            );
+            if (it != jobs.end() && it->connection_id == id_it->second && it->job.job_id != 0) {
+                return &*it;
+            }
+            return nullptr;
+        };
+        
+        // Соединения без готового задания (подключились после предвычисления)
+        std::pmr::vector<AsicConnection*> missing(arena);
+        
+        auto send_precomputed = &Impl::send_precomputed;
+        
+        if (impl_->uring) {
+            // Кадры (команда + задание) для пакета SQE
+            std::pmr::vector<AnyJobFrame> frames(impl_->connections.size(), arena);
+            std::size_t next_frame = 0;
+            
+            sent += impl_->uring_broadcast(
+                [&](AsicConnection& conn) -> ByteSpan {
+                    const auto* pj = find_job(conn);
+                    if (!pj) {
+                        missing.push_back(&conn);
+                        return {};
+                    }
+                    auto& frame = frames[next_frame++];
+                    if (NewJobMessage msg{pj->job}; !msg.is_plain()) {
+                        return ByteSpan(frame.data(), msg.encode_any(frame));
+                    }
+                    encode_new_job(pj->message, std::span(frame).first<NEW_JOB_FRAME_SIZE>());
+                    return ByteSpan(frame.data(), NEW_JOB_FRAME_SIZE);
+                },
+                [&](AsicConnection& conn) { return send_precomputed(conn, *find_job(conn)); }
+            );
+        } else {
+            for (auto& conn : impl_->connections) {
+                if (!conn->is_connected()) {
+                    continue;
+                }
+                if (const auto* pj = find_job(*conn)) {
+                    send_precomputed(*conn, *pj);
+                    ++sent;
+                } else {
+                    missing.push_back(conn.get());
+                }
+            }
+        }
+        
+        // Их задания - одним пакетом JobManager::regenerate_all
+        std::pmr::vector<std::pair<uint32_t, AsicConnection*>> missing_ids(arena);
+        missing_ids.reserve(missing.size());
+        for (auto* conn : missing) {
+            auto id_it = impl_->connection_ids.find(conn);
+            if (id_it != impl_->connection_ids.end()) {
+                missing_ids.emplace_back(id_it->second, conn);
+            }
+        }
+        if (!missing_ids.empty()) {
+            std::sort(missing_ids.begin(), missing_ids.end());
+            std::pmr::vector<uint32_t> ids(arena);
+            ids.reserve(missing_ids.size());
+            for (const auto& [id, conn] : missing_ids) {
+                ids.push_back(id);
+            }
+            
+            auto regenerated = impl_->job_manager.regenerate_all(ids);
+            auto it = regenerated.begin();
+            for (const auto& [id, conn] : missing_ids) {
+                while (it != regenerated.end() && it->connection_id < id) {
+                    ++it;
+                }
+                if (it != regenerated.end() && it->connection_id == id && it->job.job_id != 0 &&
+                    send_precomputed(*conn, *it)) {
+                    ++sent;
+                }
+            }
+        }
+        
+        // Очередь заданий ASIC - после текущих заданий всех соединений
+        for (auto& conn : impl_->connections) {
+            auto id_it = impl_->connection_ids.find(conn.get());
+            if (conn->is_connected() && id_it != impl_->connection_ids.end()) {
+                sent += impl_->send_job_queue(*conn, id_it->second);
+            }
+        }
+    }
+    
+    core::trace_point(core::TraceStage::BroadcastDone);
+    
+    impl_->total_jobs_sent.add(sent);
+    
+    // Кадры пула mining.prelease_pool - по новому шаблону, после рассылки
+    impl_->job_manager.refresh_prelease_pool();
+}
+
+std::size_t Server::refresh_job_set(std::span<const mining::PrecomputedJob> jobs) {
+    std::size_t sent = 0;
+    {
+        std::lock_guard<std::mutex> lock(impl_->connections_mutex);
+        
+        for (auto& conn : impl_->connections) {
+            auto id_it = impl_->connection_ids.find(conn.get());
+            if (!conn->is_connected() || id_it == impl_->connection_ids.end()) {
+                continue;
+            }
+            auto it = std::lower_bound(
+                jobs.begin(), jobs.end(), id_it->second,
+                [](const mining::PrecomputedJob& pj, uint32_t id) { return pj.connection_id < id; }
+            );
+            if (it == jobs.end() || it->connection_id != id_it->second || it->job.job_id == 0) {
+                continue;
+            }
+            
+            // Новый блок важнее обновления: его задания уже рассылаются
+            if (it->job.generation != impl_->job_manager.job_generation()) {
+                break;
+            }
+            if (Impl::send_precomputed(*conn, *it)) {
+                ++sent;
+            }
+        }
+    }
+    
+    impl_->total_jobs_sent.add(sent);
+    return sent;
+}
+
+bool Server::io_uring_active() const noexcept {
+    return impl_->uring != nullptr;
 }
 
 void Server::broadcast_stop() {
@@ -353,9 +1612,61 @@ void Server::set_disconnected_callback(AsicDisconnectedCallback callback) {
     impl_->disconnected_callback = std::move(callback);
 }
 
+void Server::set_share_callback(AsicShareCallback callback) {
+    impl_->share_callback = std::move(callback);
+}
+
+void Server::set_job_loaded_callback(AsicJobLoadedCallback callback) {
+    impl_->job_loaded_callback = std::move(callback);
+}
+
 ServerStats Server::stats() const {
-    std::lock_guard<std::mutex> lock(impl_->stats_mutex);
-    return impl_->stats;
+    ServerStats stats;
+    stats.active_connections = impl_->active_connections.load();
+    stats.total_connections = impl_->total_connections.load();
+    stats.total_shares = impl_->total_shares.load();
+    stats.total_jobs_sent = impl_->total_jobs_sent.load();
+    stats.total_hashrate = impl_->total_hashrate.load();
+    stats.block_notifies_sent = impl_->multicast ? impl_->multicast->sent() : 0;
+    return stats;
+}
+
+std::vector<ConnectionSnapshot> Server::connection_stats() const {
+    return *impl_->connection_snapshots.load(std::memory_order_acquire);
+}
+
+const FleetTelemetry& Server::fleet_telemetry() const noexcept {
+    return impl_->fleet;
+}
+
+std::vector<JobLoadSnapshot> Server::job_load_latency() const {
+    std::vector<JobLoadSnapshot> result;
+    std::lock_guard<std::mutex> lock(impl_->connections_mutex);
+    for (const auto& conn : impl_->connections) {
+        auto latency = conn->job_load_latency();
+        if (latency.load.count() != 0) {
+            result.push_back({conn->remote_address(), std::move(latency)});
+        }
+    }
+    return result;
+}
+
+void Server::set_vardiff(const VardiffConfig& vardiff) {
+    // Соединения живы, пока есть в vardiff (под connections_mutex)
+    std::lock_guard<std::mutex> lock(impl_->connections_mutex);
+    impl_->config.vardiff = vardiff;
+    
+    const auto now = mining::VardiffController::Clock::now();
+    for (auto& [conn, slot] : impl_->vardiff) {
+        std::optional<uint32_t> retarget;
+        {
+            std::lock_guard<std::mutex> slot_lock(slot->mutex);
+            retarget = slot->controller.reconfigure(vardiff, now);
+        }
+        if (retarget) {
+            conn->send_difficulty(*retarget);
+        }
+    }
 }
 
 std::size_t Server::connection_count() const {
@@ -9,12 +9,19 @@
 #pragma once
 
 #include "asic_connection.hpp"
+#include "fleet_telemetry.hpp"
+#include "session_table.hpp"
 #include "../mining/job_manager.hpp"
 #include "../core/config.hpp"
+#include "../core/executor.hpp"
 
+#include <chrono>
 #include <memory>
 #include <vector>
 #include <functional>
+#include <optional>
+#include <span>
+#include <string>
 
 namespace quaxis::network {
 
@@ -32,6 +39,28 @@ using AsicConnectedCallback = std::function<void(const std::string& address)>;
  */
 using AsicDisconnectedCallback = std::function<void(const std::string& address)>;
 
+/**
+ * @brief Callback при получении share
+ * 
+ * Вызывается из потока соединения (recv-поток или reactor).
+ * 
+ * @param share Share от ASIC
+ * @param difficulty Сложность, назначенная ASIC (vardiff), 0 если vardiff выключен
+ */
+using AsicShareCallback = std::function<void(const mining::Share& share, uint32_t difficulty)>;
+
+/**
+ * @brief Callback при подтверждении загрузки задания (RSP_JOB_LOADED)
+ * 
+ * Вызывается из потока соединения.
+ * 
+ * @param connection_id Соединение (как Share::connection_id)
+ * @param since_sent Время от отправки задания (nullopt - задание не из
+ *                   последних отправленных)
+ */
+using AsicJobLoadedCallback = std::function<void(uint32_t connection_id,
+                                                 std::optional<std::chrono::nanoseconds> since_sent)>;
+
 // =============================================================================
 // Server Statistics
 // =============================================================================
@@ -45,6 +74,47 @@ struct ServerStats {
     uint64_t total_shares = 0;
     uint64_t total_jobs_sent = 0;
     uint32_t total_hashrate = 0;  ///< Суммарный хешрейт всех ASIC
+    uint64_t block_notifies_sent = 0;  ///< Датаграмм CMD_BLOCK_NOTIFY (server.multicast)
+};
+
+/**
+ * @brief Статистика одного соединения для экспорта
+ */
+struct ConnectionSnapshot {
+    std::string remote_address;
+    ConnectionStats stats;
+};
+
+/**
+ * @brief Задержки загрузки заданий одного ASIC для экспорта
+ */
+struct JobLoadSnapshot {
+    std::string remote_address;
+    JobLoadLatency latency;
+};
+
+// =============================================================================
+// Передача новому процессу
+// =============================================================================
+
+/**
+ * @brief Соединение ASIC, переданное другому процессу
+ */
+struct HandedOffConnection {
+    DetachedSocket socket;
+    std::string remote_address;
+    uint32_t connection_id = 0;  ///< Ключ аренды extranonce в JobManager
+    uint64_t session_token = 0;  ///< Токен сессии (0 - без сессии)
+};
+
+/**
+ * @brief Сокеты и сессии сервера для передачи новому процессу
+ */
+struct ServerHandoff {
+    std::vector<int> listen_fds;
+    std::vector<HandedOffConnection> connections;
+    std::vector<ParkedSession> parked_sessions;
+    uint32_t next_connection_id = 1;
 };
 
 // =============================================================================
@@ -92,6 +162,38 @@ public:
      */
     void stop();
     
+    /**
+     * @brief Остановить сервер, не закрывая сокеты (передача новому процессу)
+     * 
+     * Приём, reactor'ы и очистка останавливаются, соединения отсоединяются
+     * без disconnected callbacks и без освобождения extranonce. Сокеты
+     * принадлежат вызывающему: после передачи их закрывают (close без
+     * shutdown), при неудаче возвращают серверу через resume().
+     */
+    [[nodiscard]] ServerHandoff detach_for_handoff();
+    
+    /**
+     * @brief Запустить сервер на сокетах прежнего процесса (вместо start())
+     * 
+     * Listening сокеты не открываются заново, соединения продолжают
+     * прежние сессии и аренды extranonce (JobManager::import_handoff()
+     * вызывается раньше). Начальная сложность vardiff отправляется заново.
+     * 
+     * @param handoff Сокеты detach_for_handoff()
+     * @param jobs_restored Задания перенесены: ASIC продолжают их без
+     *        нового задания; иначе каждому - задание по текущему шаблону
+     * @return Result<void> Ошибка запуска (сокеты соединений закрыты)
+     */
+    [[nodiscard]] Result<void> resume(ServerHandoff handoff, bool jobs_restored);
+    
+    /**
+     * @brief Выполнять периодическую очистку в общем исполнителе
+     * 
+     * Вызывать до start(). Без исполнителя очистка идёт в своём потоке.
+     * Исполнитель должен пережить stop() сервера.
+     */
+    void set_executor(core::Executor* executor);
+    
     /**
      * @brief Проверить, запущен ли сервер
      */
@@ -108,6 +210,35 @@ public:
      */
     void broadcast_job(const mining::Job& job);
     
+    /**
+     * @brief Разослать предвычисленные per-connection задания
+     * 
+     * Каждое соединение получает своё готовое сообщение (memcpy без
+     * хеширования). Соединениям, которых нет в наборе (подключились
+     * после предвычисления), задания строятся одним пакетом
+     * JobManager::regenerate_all(); пустой набор - новые задания всем.
+     * С server.multicast до рассылки уходит CMD_BLOCK_NOTIFY шаблона.
+     * 
+     * @param jobs Задания после JobManager::adopt_precomputed_jobs(),
+     *             отсортированные по connection_id
+     */
+    void broadcast_job_set(std::span<const mining::PrecomputedJob> jobs);
+    
+    /**
+     * @brief Разослать обновлённые задания того же блока (низкий приоритет)
+     * 
+     * Для JobManager::refresh_coinbase(): готовые сообщения получают только
+     * соединения из набора, без CMD_BLOCK_NOTIFY, очереди заданий ASIC и
+     * досборки недостающих - их текущие задания остаются валидными.
+     * Рассылка обрывается, как только JobManager сменил поколение:
+     * broadcast_job_set() нового блока ждёт connections_mutex не дольше
+     * отправки одного кадра.
+     * 
+     * @param jobs Задания по возрастанию connection_id
+     * @return std::size_t Отправлено заданий
+     */
+    std::size_t refresh_job_set(std::span<const mining::PrecomputedJob> jobs);
+    
     /**
      * @brief Отправить команду остановки всем ASIC
      */
@@ -118,6 +249,19 @@ public:
      */
     void broadcast_target(const Hash256& target);
     
+    // =========================================================================
+    // Перезагрузка конфигурации
+    // =========================================================================
+    
+    /**
+     * @brief Сменить настройки vardiff без переподключения ASIC
+     * 
+     * Контроллеры подключённых ASIC получают новые цель и границы
+     * (сложность вне новых границ сразу уходит ASIC). enabled и
+     * start_difficulty действуют для новых соединений.
+     */
+    void set_vardiff(const VardiffConfig& vardiff);
+    
     // =========================================================================
     // Callbacks
     // =========================================================================
@@ -125,6 +269,16 @@ public:
     void set_connected_callback(AsicConnectedCallback callback);
     void set_disconnected_callback(AsicDisconnectedCallback callback);
     
+    /**
+     * @brief Установить обработчик shares (устанавливать до start())
+     */
+    void set_share_callback(AsicShareCallback callback);
+    
+    /**
+     * @brief Установить обработчик RSP_JOB_LOADED (устанавливать до start())
+     */
+    void set_job_loaded_callback(AsicJobLoadedCallback callback);
+    
     // =========================================================================
     // Информация
     // =========================================================================
@@ -134,6 +288,36 @@ public:
      */
     [[nodiscard]] ServerStats stats() const;
     
+    /**
+     * @brief Статистика соединений
+     * 
+     * Снимок обновляется раз в секунду потоком очистки; чтение не берёт
+     * connections_mutex и не задерживает рассылку заданий.
+     */
+    [[nodiscard]] std::vector<ConnectionSnapshot> connection_stats() const;
+    
+    /**
+     * @brief Телеметрия чипов подключённых ASIC (RSP_TELEMETRY)
+     * 
+     * ID ASIC в таблице - ID соединения; при отключении ASIC убирается.
+     */
+    [[nodiscard]] const FleetTelemetry& fleet_telemetry() const noexcept;
+    
+    /**
+     * @brief Задержки загрузки заданий ASIC, приславших RSP_JOB_LOADED
+     * 
+     * Гистограммы копируются при вызове (экспорт метрик), а не в
+     * ежесекундный снимок connection_stats().
+     */
+    [[nodiscard]] std::vector<JobLoadSnapshot> job_load_latency() const;
+    
+    /**
+     * @brief Рассылка заданий идёт через io_uring?
+     * 
+     * false если io_uring выключен в конфигурации или недоступен в ядре.
+     */
+    [[nodiscard]] bool io_uring_active() const noexcept;
+    
     /**
      * @brief Получить количество активных подключений
      */
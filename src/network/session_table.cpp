@@ -0,0 +1,150 @@
+/**
+ * @file session_table.cpp
+ * @brief Реализация таблицы сессий ASIC
+ */
+
+#include "session_table.hpp"
+
+#include <cerrno>
+#include <random>
+
+#include <sys/random.h>
+
+namespace quaxis::network {
+
+namespace {
+
+/**
+ * @brief 64 бита из CSPRNG ядра
+ *
+ * Токен - единственное, что нужно для захвата сессии, поэтому каждый
+ * берётся из getrandom(2) целиком: по выданным токенам состояние
+ * генератора не восстановить, в отличие от MT19937.
+ */
+uint64_t random_token() {
+    uint64_t token = 0;
+    auto* out = reinterpret_cast<unsigned char*>(&token);
+    std::size_t filled = 0;
+    while (filled < sizeof(token)) {
+        const ssize_t n = ::getrandom(out + filled, sizeof(token) - filled, 0);
+        if (n > 0) {
+            filled += static_cast<std::size_t>(n);
+        } else if (n < 0 && errno != EINTR) {
+            // getrandom недоступен (старое ядро, seccomp) - random_device
+            std::random_device entropy;
+            return (uint64_t{entropy()} << 32) | entropy();
+        }
+    }
+    return token;
+}
+
+} // namespace
+
+SessionTable::SessionTable(std::chrono::seconds grace)
+    : grace_(grace)
+{
+}
+
+uint64_t SessionTable::open(uint32_t connection_id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint64_t token = 0;
+    do {
+        token = random_token();  // Токен не угадать по соседнему соединению
+    } while (token == 0 || sessions_.contains(token));
+    sessions_.emplace(token, Entry{connection_id, 0, std::nullopt});
+    return token;
+}
+
+ParkResult SessionTable::park(uint64_t token, uint32_t epoch, Clock::time_point now) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = sessions_.find(token);
+    if (it == sessions_.end()) {
+        return ParkResult::Unknown;
+    }
+    if (it->second.epoch != epoch) {
+        return ParkResult::Superseded;
+    }
+    it->second.expires_at = now + grace_;
+    return ParkResult::Parked;
+}
+
+std::optional<ResumedSession> SessionTable::resume(uint64_t token, Clock::time_point now) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = sessions_.find(token);
+    if (it == sessions_.end() || (it->second.expires_at && *it->second.expires_at <= now)) {
+        return std::nullopt;
+    }
+    it->second.expires_at.reset();
+    return ResumedSession{it->second.connection_id, ++it->second.epoch};
+}
+
+void SessionTable::close(uint64_t token) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    sessions_.erase(token);
+}
+
+std::vector<uint32_t> SessionTable::expire(Clock::time_point now) {
+    std::vector<uint32_t> expired;
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = sessions_.begin(); it != sessions_.end();) {
+        if (it->second.expires_at && *it->second.expires_at <= now) {
+            expired.push_back(it->second.connection_id);
+            it = sessions_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    return expired;
+}
+
+std::optional<uint32_t> SessionTable::expire_one(uint64_t token, Clock::time_point now) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = sessions_.find(token);
+    if (it == sessions_.end() || !it->second.expires_at || *it->second.expires_at > now) {
+        return std::nullopt;
+    }
+    const uint32_t connection_id = it->second.connection_id;
+    sessions_.erase(it);
+    return connection_id;
+}
+
+std::vector<ParkedSession> SessionTable::take_parked() {
+    std::vector<ParkedSession> parked;
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = sessions_.begin(); it != sessions_.end();) {
+        if (it->second.expires_at) {
+            parked.push_back(ParkedSession{it->first, it->second.connection_id});
+            it = sessions_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    return parked;
+}
+
+void SessionTable::adopt(uint64_t token, uint32_t connection_id, bool parked, Clock::time_point now) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Entry entry{connection_id, 0, std::nullopt};
+    if (parked) {
+        entry.expires_at = now + grace_;
+    }
+    sessions_.insert_or_assign(token, entry);
+}
+
+std::size_t SessionTable::parked_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::size_t parked = 0;
+    for (const auto& [token, entry] : sessions_) {
+        if (entry.expires_at) {
+            ++parked;
+        }
+    }
+    return parked;
+}
+
+std::size_t SessionTable::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return sessions_.size();
+}
+
+} // namespace quaxis::network
@@ -0,0 +1,173 @@
+/**
+ * @file session_table.hpp
+ * @brief Сессии ASIC, переживающие короткий обрыв соединения
+ *
+ * Обрыв Wi-Fi или перезапуск коммутатора рвёт TCP на секунды. Без
+ * сессий сервер сразу освобождает extranonce, а переподключившийся ASIC
+ * получает новый extranonce и новое задание: перебор начинается заново,
+ * shares, найденные во время обрыва, прошивка отправить уже не может.
+ *
+ * При подключении соединение получает случайный токен (CMD_SET_SESSION).
+ * После обрыва сессия паркуется на grace период: extranonce и задания
+ * остаются за прежним connection_id. RSP_HELLO с токеном в этот период
+ * возвращает сессию новому соединению; истёкшую сессию сервер снимает
+ * по её таймеру (expire_one) и только тогда освобождает extranonce.
+ *
+ * Сервер часто узнаёт об обрыве позже ASIC: прежнее соединение ещё
+ * открыто, когда приходит RSP_HELLO. Такую сессию новое соединение
+ * забирает сразу; у сессии растёт epoch, и отключение прежнего
+ * соединения (с прежним epoch) её уже не трогает.
+ *
+ * Thread-safe: открытие - из потока приёма, парковка и возобновление -
+ * из потоков соединений, истечение - из cleanup_loop.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace quaxis::network {
+
+/**
+ * @brief Возобновлённая сессия
+ */
+struct ResumedSession {
+    uint32_t connection_id = 0;  ///< Прежний ID соединения (с его extranonce)
+    uint32_t epoch = 0;          ///< Владение сессией нового соединения
+};
+
+/**
+ * @brief Припаркованная сессия (передача новому процессу)
+ */
+struct ParkedSession {
+    uint64_t token = 0;
+    uint32_t connection_id = 0;
+};
+
+/**
+ * @brief Что стало с сессией при отключении соединения
+ */
+enum class ParkResult : uint8_t {
+    Parked,      ///< Ждёт переподключения: extranonce не освобождать
+    Superseded,  ///< Сессию уже забрало новое соединение: ничего не трогать
+    Unknown      ///< Сессии нет: extranonce освободить
+};
+
+/**
+ * @brief Таблица сессий по токену
+ */
+class SessionTable {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @param grace Сколько сессия ждёт переподключения (0 - сессии выключены)
+     */
+    explicit SessionTable(std::chrono::seconds grace);
+
+    SessionTable(const SessionTable&) = delete;
+    SessionTable& operator=(const SessionTable&) = delete;
+
+    /**
+     * @brief Включены ли сессии
+     */
+    [[nodiscard]] bool enabled() const noexcept { return grace_.count() > 0; }
+
+    /**
+     * @brief Открыть сессию живого соединения (epoch 0)
+     *
+     * @return uint64_t Новый токен (не 0)
+     */
+    [[nodiscard]] uint64_t open(uint32_t connection_id);
+
+    /**
+     * @brief Соединение оборвалось: сессия ждёт переподключения
+     *
+     * @param epoch Epoch, с которым сессию получило соединение
+     */
+    [[nodiscard]] ParkResult park(uint64_t token, uint32_t epoch, Clock::time_point now);
+
+    /**
+     * @brief Вернуть припаркованную сессию новому соединению
+     *
+     * Сессия снова живая, её epoch следующий. Живую сессию (обрыв ещё
+     * не замечен) новое соединение забирает так же. Истёкшая сессия не
+     * возобновляется: её extranonce освободит expire().
+     *
+     * @return std::optional<ResumedSession> nullopt - токен неизвестен
+     *         или сессия истекла
+     */
+    [[nodiscard]] std::optional<ResumedSession> resume(uint64_t token, Clock::time_point now);
+
+    /**
+     * @brief Удалить сессию (живую или припаркованную)
+     */
+    void close(uint64_t token);
+
+    /**
+     * @brief Удалить истёкшие припаркованные сессии
+     *
+     * @return std::vector<uint32_t> ID их соединений: extranonce пора освободить
+     */
+    [[nodiscard]] std::vector<uint32_t> expire(Clock::time_point now);
+    
+    /**
+     * @brief Удалить сессию token, если она припаркована и истекла
+     *
+     * Для таймера сессии: без обхода всей таблицы.
+     *
+     * @return std::optional<uint32_t> ID соединения; nullopt - сессия
+     *         возобновлена, удалена или ещё не истекла
+     */
+    [[nodiscard]] std::optional<uint32_t> expire_one(uint64_t token, Clock::time_point now);
+    
+    /**
+     * @brief Grace период сессий
+     */
+    [[nodiscard]] std::chrono::seconds grace() const noexcept { return grace_; }
+
+    /**
+     * @brief Забрать припаркованные сессии (передача новому процессу)
+     *
+     * Сессии удаляются из таблицы, их extranonce не освобождаются.
+     */
+    [[nodiscard]] std::vector<ParkedSession> take_parked();
+
+    /**
+     * @brief Принять сессию прежнего процесса с тем же токеном
+     *
+     * Живая сессия получает epoch 0, припаркованная - полный grace период
+     * от now (время прежнего процесса не переносится).
+     */
+    void adopt(uint64_t token, uint32_t connection_id, bool parked, Clock::time_point now);
+
+    /**
+     * @brief Сколько сессий ждут переподключения
+     */
+    [[nodiscard]] std::size_t parked_count() const;
+
+    /**
+     * @brief Всего сессий
+     */
+    [[nodiscard]] std::size_t size() const;
+
+private:
+    struct Entry {
+        uint32_t connection_id = 0;
+        uint32_t epoch = 0;
+        std::optional<Clock::time_point> expires_at;  ///< nullopt - соединение живо
+    };
+
+    std::chrono::seconds grace_;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<uint64_t, Entry> sessions_;
+};
+
+} // namespace quaxis::network
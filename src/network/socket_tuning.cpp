@@ -0,0 +1,86 @@
+/**
+ * @file socket_tuning.cpp
+ * @brief Реализация настройки TCP сокетов ASIC
+ */
+
+#include "socket_tuning.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <format>
+
+namespace quaxis::network {
+
+Result<void> apply_socket_tuning(int fd, const AsicSocketConfig& config) {
+    const char* failed = nullptr;
+    int failed_errno = 0;
+
+    auto set = [&](int level, int name, int value, const char* what) {
+        if (setsockopt(fd, level, name, &value, sizeof(value)) < 0 && !failed) {
+            failed = what;
+            failed_errno = errno;
+        }
+    };
+
+    if (config.no_delay) {
+        set(IPPROTO_TCP, TCP_NODELAY, 1, "TCP_NODELAY");
+    }
+    if (config.quick_ack) {
+        set(IPPROTO_TCP, TCP_QUICKACK, 1, "TCP_QUICKACK");
+    }
+    if (config.busy_poll_us > 0) {
+        set(SOL_SOCKET, SO_BUSY_POLL, static_cast<int>(config.busy_poll_us), "SO_BUSY_POLL");
+    }
+    if (config.user_timeout_ms > 0) {
+        set(IPPROTO_TCP, TCP_USER_TIMEOUT, static_cast<int>(config.user_timeout_ms), "TCP_USER_TIMEOUT");
+    }
+    if (config.keepalive_idle > 0) {
+        set(SOL_SOCKET, SO_KEEPALIVE, 1, "SO_KEEPALIVE");
+        set(IPPROTO_TCP, TCP_KEEPIDLE, static_cast<int>(config.keepalive_idle), "TCP_KEEPIDLE");
+        set(IPPROTO_TCP, TCP_KEEPINTVL, static_cast<int>(config.keepalive_interval), "TCP_KEEPINTVL");
+        set(IPPROTO_TCP, TCP_KEEPCNT, static_cast<int>(config.keepalive_count), "TCP_KEEPCNT");
+    }
+    if (config.priority >= 0) {
+        set(SOL_SOCKET, SO_PRIORITY, config.priority, "SO_PRIORITY");
+    }
+    if (config.dscp >= 0) {
+        // DSCP - старшие 6 бит TOS / traffic class
+        struct sockaddr_storage local{};
+        socklen_t length = sizeof(local);
+        const bool ipv6 = getsockname(fd, reinterpret_cast<sockaddr*>(&local), &length) == 0 &&
+                          local.ss_family == AF_INET6;
+        if (ipv6) {
+            set(IPPROTO_IPV6, IPV6_TCLASS, config.dscp << 2, "IPV6_TCLASS");
+        } else {
+            set(IPPROTO_IP, IP_TOS, config.dscp << 2, "IP_TOS");
+        }
+    }
+    if (config.send_buffer > 0) {
+        set(SOL_SOCKET, SO_SNDBUF, static_cast<int>(config.send_buffer), "SO_SNDBUF");
+    }
+
+    if (failed) {
+        return Err<void>(ErrorCode::NetworkConnectionFailed,
+                         std::format("Не удалось установить {}: {}", failed, strerror(failed_errno)));
+    }
+    return {};
+}
+
+std::optional<TcpLinkInfo> read_tcp_info(int fd) noexcept {
+    if (fd < 0) {
+        return std::nullopt;
+    }
+    struct tcp_info info{};
+    socklen_t length = sizeof(info);
+    if (getsockopt(fd, IPPROTO_TCP, TCP_INFO, &info, &length) < 0) {
+        return std::nullopt;
+    }
+    TcpLinkInfo link;
+    link.rtt_us = info.tcpi_rtt;
+    link.rtt_var_us = info.tcpi_rttvar;
+    link.retransmits = info.tcpi_total_retrans;
+    link.unacked = info.tcpi_unacked;
+    return link;
+}
+
+} // namespace quaxis::network
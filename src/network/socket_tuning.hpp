@@ -0,0 +1,62 @@
+/**
+ * @file socket_tuning.hpp
+ * @brief Настройка TCP сокетов ASIC и снимок TCP_INFO
+ *
+ * Сокет ASIC получал только TCP_NODELAY, остальное - по умолчанию ядра:
+ * отложенный ACK на share, буфер отправки в сотни КБ, в котором
+ * задания прежнего блока ждали своей очереди, и минуты ретрансмиссий до
+ * обнаружения выключенного ASIC. Профиль server.socket задаёт это явно
+ * (AsicSocketConfig), а TCP_INFO показывает RTT и ретрансмиссии каждого
+ * соединения в ConnectionStats.
+ */
+
+#pragma once
+
+#include "../core/types.hpp"
+#include "../core/config.hpp"
+
+#include <cstdint>
+#include <optional>
+
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+namespace quaxis::network {
+
+/**
+ * @brief Состояние TCP соединения из TCP_INFO
+ */
+struct TcpLinkInfo {
+    uint32_t rtt_us = 0;       ///< Сглаженный RTT
+    uint32_t rtt_var_us = 0;   ///< Разброс RTT
+    uint32_t retransmits = 0;  ///< Ретрансмиссий за время соединения
+    uint32_t unacked = 0;      ///< Сегментов без ACK сейчас
+};
+
+/**
+ * @brief Применить профиль к сокету ASIC
+ *
+ * Все опции пробуются, даже если одна не применилась (SO_BUSY_POLL и
+ * SO_PRIORITY выше 6 требуют CAP_NET_ADMIN).
+ *
+ * @return Result<void> Первая неудачная опция и errno
+ */
+[[nodiscard]] Result<void> apply_socket_tuning(int fd, const AsicSocketConfig& config);
+
+/**
+ * @brief Снова включить TCP_QUICKACK (ядро сбрасывает его после ACK)
+ */
+inline void rearm_quick_ack(int fd) noexcept {
+    int flag = 1;
+    (void)setsockopt(fd, IPPROTO_TCP, TCP_QUICKACK, &flag, sizeof(flag));
+}
+
+/**
+ * @brief Прочитать TCP_INFO сокета
+ *
+ * @return nullopt - сокет закрыт или не TCP
+ */
+[[nodiscard]] std::optional<TcpLinkInfo> read_tcp_info(int fd) noexcept;
+
+} // namespace quaxis::network
@@ -0,0 +1,703 @@
+/**
+ * @file template_feed.cpp
+ * @brief Реализация фида шаблонов между площадками
+ */
+
+#include "template_feed.hpp"
+
+#include "../core/byte_order.hpp"
+#include "../core/constants.hpp"
+#include "../core/thread_plan.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <format>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace quaxis::network {
+
+namespace {
+
+/// @brief Payload Template без хвоста coinbase
+constexpr std::size_t TEMPLATE_FIXED_SIZE = 1 + 4 + 8 + constants::BLOCK_HEADER_SIZE
+    + bitcoin::SHM_TEMPLATE_PREFIX_SIZE + 2;
+
+/// @brief Payload Hello и Delegation
+constexpr std::size_t HELLO_SIZE = 6;
+constexpr std::size_t DELEGATION_SIZE = 9;
+
+/// @brief Шаг ожидания потоков фида (проверка остановки)
+constexpr int POLL_INTERVAL_MS = 100;
+
+/**
+ * @brief Снять с начала буфера один полный кадр
+ *
+ * @return 1 - кадр снят, 0 - кадр ещё не дочитан, -1 - payload больше FEED_MAX_PAYLOAD
+ */
+int take_frame(Bytes& in, FeedMessage& type, Bytes& payload) {
+    if (in.size() < FEED_FRAME_HEADER_SIZE) {
+        return 0;
+    }
+    const uint32_t length = read_le32(in.data() + 1);
+    if (length > FEED_MAX_PAYLOAD) {
+        return -1;
+    }
+    if (in.size() < FEED_FRAME_HEADER_SIZE + length) {
+        return 0;
+    }
+    type = static_cast<FeedMessage>(in[0]);
+    payload.assign(in.begin() + FEED_FRAME_HEADER_SIZE,
+                   in.begin() + static_cast<std::ptrdiff_t>(FEED_FRAME_HEADER_SIZE + length));
+    in.erase(in.begin(), in.begin() + static_cast<std::ptrdiff_t>(FEED_FRAME_HEADER_SIZE + length));
+    return 1;
+}
+
+/**
+ * @brief Дочитать доступные байты сокета в буфер
+ *
+ * @return false - соединение закрыто или ошибка
+ */
+bool read_available(int fd, Bytes& in) {
+    uint8_t buffer[4096];
+    while (true) {
+        ssize_t n = ::recv(fd, buffer, sizeof(buffer), MSG_DONTWAIT);
+        if (n > 0) {
+            in.insert(in.end(), buffer, buffer + n);
+            if (in.size() > FEED_FRAME_HEADER_SIZE + FEED_MAX_PAYLOAD) {
+                return true;  // take_frame() отклонит кадр
+            }
+            continue;
+        }
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        return n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+    }
+}
+
+/// @brief Записать весь буфер в блокирующий сокет
+bool send_all(int fd, ByteSpan data) {
+    std::size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        sent += static_cast<std::size_t>(n);
+    }
+    return true;
+}
+
+Bytes serialize_delegation(ExtranonceRange range) {
+    uint8_t payload[DELEGATION_SIZE];
+    write_le64(payload, range.base);
+    payload[8] = range.bits;
+    return serialize_feed_frame(FeedMessage::Delegation, ByteSpan(payload, sizeof(payload)));
+}
+
+} // anonymous namespace
+
+// =============================================================================
+// Протокол
+// =============================================================================
+
+ExtranonceRange ExtranonceRange::root(std::size_t extranonce_size) noexcept {
+    return ExtranonceRange{0, static_cast<uint8_t>(std::min<std::size_t>(extranonce_size * 8, 64))};
+}
+
+std::optional<ExtranonceRange> ExtranonceRange::delegate(uint8_t site) const noexcept {
+    if (site == 0 || bits < 2 * FEED_SITE_BITS) {
+        return std::nullopt;
+    }
+    const auto child_bits = static_cast<uint8_t>(bits - FEED_SITE_BITS);
+    return ExtranonceRange{base + (static_cast<uint64_t>(site) << child_bits), child_bits};
+}
+
+uint64_t ExtranonceRange::own_end(bool delegating) const noexcept {
+    const auto own_bits = delegating && bits >= 2 * FEED_SITE_BITS
+        ? static_cast<uint8_t>(bits - FEED_SITE_BITS)
+        : bits;
+    if (own_bits >= 64) {
+        return std::numeric_limits<uint64_t>::max();
+    }
+    return base + (uint64_t{1} << own_bits);
+}
+
+Bytes serialize_feed_frame(FeedMessage type, ByteSpan payload) {
+    Bytes frame(FEED_FRAME_HEADER_SIZE + payload.size());
+    frame[0] = static_cast<uint8_t>(type);
+    write_le32(frame.data() + 1, static_cast<uint32_t>(payload.size()));
+    std::copy(payload.begin(), payload.end(), frame.begin() + FEED_FRAME_HEADER_SIZE);
+    return frame;
+}
+
+Result<Bytes> encode_feed_template(const bitcoin::BlockTemplate& block_template, bool is_speculative) {
+    constexpr std::size_t suffix_offset = bitcoin::SHM_TEMPLATE_PREFIX_SIZE + constants::EXTRANONCE_SIZE;
+    const auto& coinbase = block_template.coinbase_tx;
+    if (coinbase.size() < suffix_offset) {
+        return Err<Bytes>(ErrorCode::MiningInvalidJob, "Шаблон без coinbase: нечего раздавать площадкам");
+    }
+    const std::size_t suffix_size = coinbase.size() - suffix_offset;
+    if (suffix_size > bitcoin::SHM_TEMPLATE_MAX_SUFFIX) {
+        return Err<Bytes>(ErrorCode::MiningInvalidJob,
+                          std::format("Хвост coinbase слишком велик для фида: {} байт", suffix_size));
+    }
+
+    Bytes payload(TEMPLATE_FIXED_SIZE + suffix_size);
+    uint8_t* out = payload.data();
+    out[0] = is_speculative ? 1 : 0;
+    write_le32(out + 1, block_template.height);
+    write_le64(out + 5, static_cast<uint64_t>(block_template.coinbase_value));
+    const auto header = block_template.header.serialize();
+    std::memcpy(out + 13, header.data(), header.size());
+    std::memcpy(out + 13 + header.size(), coinbase.data(), bitcoin::SHM_TEMPLATE_PREFIX_SIZE);
+    write_le16(out + TEMPLATE_FIXED_SIZE - 2, static_cast<uint16_t>(suffix_size));
+    std::memcpy(out + TEMPLATE_FIXED_SIZE, coinbase.data() + suffix_offset, suffix_size);
+    return payload;
+}
+
+Result<std::shared_ptr<const bitcoin::BlockTemplate>> decode_feed_template(ByteSpan payload) {
+    using TemplatePtr = std::shared_ptr<const bitcoin::BlockTemplate>;
+    if (payload.size() < TEMPLATE_FIXED_SIZE) {
+        return Err<TemplatePtr>(ErrorCode::NetworkRecvFailed, "Короткий кадр шаблона фида");
+    }
+    const uint16_t suffix_size = read_le16(payload.data() + TEMPLATE_FIXED_SIZE - 2);
+    if (payload.size() != TEMPLATE_FIXED_SIZE + suffix_size || suffix_size > bitcoin::SHM_TEMPLATE_MAX_SUFFIX) {
+        return Err<TemplatePtr>(ErrorCode::NetworkRecvFailed, "Длина хвоста coinbase не совпадает с кадром");
+    }
+
+    // Раскладка та же, что у сегмента шаблона SHM: сборка - там же
+    auto data = std::make_unique<bitcoin::ShmTemplateData>();
+    data->state = payload[0] ? bitcoin::ShmBlockState::Speculative : bitcoin::ShmBlockState::Confirmed;
+    data->height = read_le32(payload.data() + 1);
+    data->coinbase_value = static_cast<int64_t>(read_le64(payload.data() + 5));
+    std::memcpy(data->header_raw, payload.data() + 13, sizeof(data->header_raw));
+    std::memcpy(data->coinbase_prefix, payload.data() + 13 + sizeof(data->header_raw),
+                sizeof(data->coinbase_prefix));
+    data->coinbase_suffix_size = suffix_size;
+    std::memcpy(data->coinbase_suffix, payload.data() + TEMPLATE_FIXED_SIZE, suffix_size);
+
+    auto block_template = std::make_shared<bitcoin::BlockTemplate>();
+    auto filled = bitcoin::fill_block_template(*data, *block_template);
+    if (!filled) {
+        return Err<TemplatePtr>(filled.error().code, filled.error().message);
+    }
+    return TemplatePtr(std::move(block_template));
+}
+
+// =============================================================================
+// TemplateFeedServer
+// =============================================================================
+
+struct TemplateFeedServer::Impl {
+    /**
+     * @brief Нижестоящая площадка
+     */
+    struct Site {
+        int fd{-1};
+        uint8_t site{0};  ///< 0 - Hello ещё не пришёл
+        Bytes in;
+        bool dead{false};
+    };
+
+    ProxyConfig config;
+    ExtranonceRange range;
+    FeedBlockCallback block_callback;
+
+    int listen_fd{-1};
+    uint16_t bound_port{0};
+    std::atomic<bool> running{false};
+    std::thread worker;
+
+    mutable std::mutex mutex;
+    std::vector<Site> sites;
+    Bytes last_template;  ///< Кадр последнего шаблона для новых площадок
+
+    Impl(const ProxyConfig& cfg, ExtranonceRange r) : config(cfg), range(r) {}
+
+    /// @brief Записать кадр без блокировки; не влезший - площадка отстала (под mutex)
+    static void send_locked(Site& site, ByteSpan frame) {
+        if (site.dead) {
+            return;
+        }
+        ssize_t n = ::send(site.fd, frame.data(), frame.size(), MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (n != static_cast<ssize_t>(frame.size())) {
+            site.dead = true;
+            ::shutdown(site.fd, SHUT_RDWR);
+        }
+    }
+
+    void broadcast(ByteSpan frame) {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto& site : sites) {
+            if (site.site != 0) {
+                send_locked(site, frame);
+            }
+        }
+    }
+
+    /// @brief Hello площадки: диапазон extranonce и последний шаблон (под mutex)
+    void handle_hello(Site& site, ByteSpan payload) {
+        if (payload.size() != HELLO_SIZE || read_le32(payload.data()) != FEED_MAGIC ||
+            payload[4] != FEED_VERSION) {
+            site.dead = true;
+            return;
+        }
+        const uint8_t number = payload[5];
+        const bool taken = std::any_of(sites.begin(), sites.end(), [number](const Site& other) {
+            return other.site == number && !other.dead;
+        });
+        auto delegated = range.delegate(number);
+        if (taken || !delegated) {
+            site.dead = true;  // Два узла с одним site перебирали бы одни extranonce
+            return;
+        }
+        site.site = number;
+        send_locked(site, serialize_delegation(*delegated));
+        if (!last_template.empty()) {
+            send_locked(site, last_template);
+        }
+    }
+
+    void accept_sites() {
+        while (true) {
+            int fd = ::accept4(listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) {
+                return;
+            }
+            int flag = 1;
+            ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
+            std::lock_guard<std::mutex> lock(mutex);
+            sites.push_back(Site{fd, 0, {}, false});
+        }
+    }
+
+    void worker_loop() {
+        std::vector<pollfd> fds;
+        std::vector<std::pair<Bytes, uint8_t>> blocks;
+
+        while (running.load(std::memory_order_relaxed)) {
+            fds.clear();
+            fds.push_back(pollfd{listen_fd, POLLIN, 0});
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                for (const auto& site : sites) {
+                    fds.push_back(pollfd{site.fd, POLLIN, 0});
+                }
+            }
+            if (::poll(fds.data(), fds.size(), POLL_INTERVAL_MS) <= 0) {
+                continue;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                // Площадки добавляет только этот поток: индексы fds совпадают
+                for (std::size_t i = 1; i < fds.size(); ++i) {
+                    Site& site = sites[i - 1];
+                    if (fds[i].revents == 0 || site.dead) {
+                        continue;
+                    }
+                    if (!read_available(site.fd, site.in)) {
+                        site.dead = true;
+                    }
+                    FeedMessage type;
+                    Bytes payload;
+                    int taken;
+                    while (!site.dead && (taken = take_frame(site.in, type, payload)) != 0) {
+                        if (taken < 0) {
+                            site.dead = true;
+                        } else if (type == FeedMessage::Hello && site.site == 0) {
+                            handle_hello(site, payload);
+                        } else if (type == FeedMessage::Block && site.site != 0) {
+                            blocks.emplace_back(std::move(payload), site.site);
+                        } else if (site.site == 0) {
+                            site.dead = true;  // Первым кадром должен быть Hello
+                        }
+                    }
+                }
+                std::erase_if(sites, [](const Site& site) {
+                    if (site.dead) {
+                        ::close(site.fd);
+                    }
+                    return site.dead;
+                });
+            }
+
+            if (fds[0].revents & POLLIN) {
+                accept_sites();
+            }
+
+            for (auto& [block, site] : blocks) {
+                if (block_callback) {
+                    block_callback(std::move(block), site);
+                }
+            }
+            blocks.clear();
+        }
+    }
+};
+
+TemplateFeedServer::TemplateFeedServer(const ProxyConfig& config, ExtranonceRange range)
+    : impl_(std::make_unique<Impl>(config, range)) {}
+
+TemplateFeedServer::~TemplateFeedServer() {
+    stop();
+}
+
+void TemplateFeedServer::set_block_callback(FeedBlockCallback callback) {
+    impl_->block_callback = std::move(callback);
+}
+
+Result<void> TemplateFeedServer::start() {
+    if (impl_->running.load()) {
+        return {};
+    }
+
+    struct sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(impl_->config.feed_port);
+    if (inet_pton(AF_INET, impl_->config.feed_bind_address.c_str(), &addr.sin_addr) != 1) {
+        return Err<void>(ErrorCode::ConfigInvalidValue,
+                         "Некорректный proxy.feed_bind_address: " + impl_->config.feed_bind_address);
+    }
+
+    int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return Err<void>(ErrorCode::NetworkConnectionFailed,
+                         std::string("Не удалось создать сокет фида: ") + strerror(errno));
+    }
+    int reuse = 1;
+    ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    if (::bind(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0 || ::listen(fd, 64) < 0) {
+        std::string reason = strerror(errno);
+        ::close(fd);
+        return Err<void>(ErrorCode::NetworkConnectionFailed,
+                         std::format("Не удалось открыть фид на порту {}: {}", impl_->config.feed_port, reason));
+    }
+
+    socklen_t len = sizeof(addr);
+    ::getsockname(fd, reinterpret_cast<struct sockaddr*>(&addr), &len);
+    impl_->bound_port = ntohs(addr.sin_port);
+    impl_->listen_fd = fd;
+    impl_->running.store(true);
+    impl_->worker = std::thread([this] {
+        core::enter_thread_role(core::ThreadRole::Fanout);
+        impl_->worker_loop();
+    });
+    return {};
+}
+
+void TemplateFeedServer::stop() {
+    if (!impl_->running.exchange(false)) {
+        return;
+    }
+    if (impl_->worker.joinable()) {
+        impl_->worker.join();
+    }
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    for (const auto& site : impl_->sites) {
+        ::close(site.fd);
+    }
+    impl_->sites.clear();
+    ::close(impl_->listen_fd);
+    impl_->listen_fd = -1;
+}
+
+void TemplateFeedServer::publish(const std::shared_ptr<const bitcoin::BlockTemplate>& block_template,
+                                 bool is_speculative) {
+    if (!block_template) {
+        return;
+    }
+    auto payload = encode_feed_template(*block_template, is_speculative);
+    if (!payload) {
+        return;
+    }
+    Bytes frame = serialize_feed_frame(FeedMessage::Template, *payload);
+    {
+        std::lock_guard<std::mutex> lock(impl_->mutex);
+        impl_->last_template = frame;
+    }
+    impl_->broadcast(frame);
+}
+
+void TemplateFeedServer::publish_state(bool confirmed) {
+    const uint8_t payload = confirmed ? 1 : 0;
+    impl_->broadcast(serialize_feed_frame(FeedMessage::TemplateState, ByteSpan(&payload, 1)));
+}
+
+std::size_t TemplateFeedServer::site_count() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    return static_cast<std::size_t>(std::count_if(impl_->sites.begin(), impl_->sites.end(),
+                                                  [](const auto& site) { return site.site != 0; }));
+}
+
+uint16_t TemplateFeedServer::port() const noexcept {
+    return impl_->bound_port;
+}
+
+// =============================================================================
+// TemplateFeedClient
+// =============================================================================
+
+struct TemplateFeedClient::Impl {
+    ProxyConfig config;
+    bitcoin::NewTemplateCallback template_callback;
+    FeedStateCallback state_callback;
+
+    /// @brief Сокет и его смена (submit_block пишет из потоков валидатора)
+    std::mutex fd_mutex;
+    int fd{-1};
+    Bytes in;
+
+    std::optional<ExtranonceRange> delegated;
+    std::atomic<bool> connected{false};
+    std::atomic<bool> running{false};
+    std::atomic<uint64_t> templates{0};
+    std::thread worker;
+
+    explicit Impl(const ProxyConfig& cfg) : config(cfg) {}
+
+    void close_fd() {
+        std::lock_guard<std::mutex> lock(fd_mutex);
+        if (fd >= 0) {
+            ::close(fd);
+            fd = -1;
+        }
+        in.clear();
+        connected.store(false);
+    }
+
+    /**
+     * @brief Подключиться и пройти Hello / Delegation
+     *
+     * Кадры после Delegation (первый шаблон) остаются в in.
+     */
+    Result<ExtranonceRange> handshake(uint32_t timeout_ms) {
+        struct addrinfo hints{};
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_STREAM;
+        struct addrinfo* result = nullptr;
+        const std::string port = std::to_string(config.upstream_port);
+        if (::getaddrinfo(config.upstream_host.c_str(), port.c_str(), &hints, &result) != 0 || !result) {
+            return Err<ExtranonceRange>(ErrorCode::NetworkConnectionFailed,
+                                        "Не удалось разрешить proxy.upstream_host: " + config.upstream_host);
+        }
+
+        int sock = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (sock < 0) {
+            ::freeaddrinfo(result);
+            return Err<ExtranonceRange>(ErrorCode::NetworkConnectionFailed,
+                                        std::string("Не удалось создать сокет фида: ") + strerror(errno));
+        }
+        struct timeval tv{};
+        tv.tv_sec = static_cast<time_t>(timeout_ms / 1000);
+        tv.tv_usec = static_cast<suseconds_t>((timeout_ms % 1000) * 1000);
+        ::setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+        ::setsockopt(sock, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+        int flag = 1;
+        ::setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
+
+        const int connect_result = ::connect(sock, result->ai_addr, result->ai_addrlen);
+        ::freeaddrinfo(result);
+        if (connect_result < 0) {
+            std::string reason = strerror(errno);
+            ::close(sock);
+            return Err<ExtranonceRange>(ErrorCode::NetworkConnectionFailed,
+                                        std::format("Вышестоящий {}:{} недоступен: {}",
+                                                    config.upstream_host, config.upstream_port, reason));
+        }
+
+        uint8_t hello[HELLO_SIZE];
+        write_le32(hello, FEED_MAGIC);
+        hello[4] = FEED_VERSION;
+        hello[5] = static_cast<uint8_t>(config.site);
+        if (!send_all(sock, serialize_feed_frame(FeedMessage::Hello, ByteSpan(hello, sizeof(hello))))) {
+            ::close(sock);
+            return Err<ExtranonceRange>(ErrorCode::NetworkSendFailed, "Не удалось отправить Hello фида");
+        }
+
+        Bytes buffer;
+        FeedMessage type;
+        Bytes payload;
+        while (true) {
+            int taken = take_frame(buffer, type, payload);
+            if (taken > 0) {
+                break;
+            }
+            uint8_t chunk[4096];
+            ssize_t n = taken < 0 ? -1 : ::recv(sock, chunk, sizeof(chunk), 0);
+            if (n <= 0) {
+                ::close(sock);
+                // Занятый site или диапазон, который уже нельзя делить: вышестоящий закрывает соединение
+                return Err<ExtranonceRange>(ErrorCode::NetworkRecvFailed,
+                                            std::format("Вышестоящий не выдал диапазон площадке {}", config.site));
+            }
+            buffer.insert(buffer.end(), chunk, chunk + n);
+        }
+        if (type != FeedMessage::Delegation || payload.size() != DELEGATION_SIZE) {
+            ::close(sock);
+            return Err<ExtranonceRange>(ErrorCode::NetworkRecvFailed, "Ожидался кадр Delegation фида");
+        }
+        ExtranonceRange range{read_le64(payload.data()), payload[8]};
+
+        std::lock_guard<std::mutex> lock(fd_mutex);
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        fd = sock;
+        in = std::move(buffer);
+        connected.store(true);
+        return range;
+    }
+
+    void handle_frames() {
+        FeedMessage type;
+        Bytes payload;
+        int taken;
+        while ((taken = take_frame(in, type, payload)) != 0) {
+            if (taken < 0) {
+                close_fd();
+                return;
+            }
+            if (type == FeedMessage::Template) {
+                auto block_template = decode_feed_template(payload);
+                if (!block_template) {
+                    continue;
+                }
+                templates.fetch_add(1, std::memory_order_relaxed);
+                if (template_callback) {
+                    const bool speculative = (*block_template)->is_speculative;
+                    template_callback(std::move(*block_template), speculative);
+                }
+            } else if (type == FeedMessage::TemplateState && payload.size() == 1) {
+                if (state_callback) {
+                    state_callback(payload[0] != 0);
+                }
+            }
+        }
+    }
+
+    void sleep_reconnect() {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(config.reconnect_ms);
+        while (running.load(std::memory_order_relaxed) && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(POLL_INTERVAL_MS));
+        }
+    }
+
+    void worker_loop() {
+        // Шаблон, пришедший сразу за Delegation в connect()
+        handle_frames();
+
+        while (running.load(std::memory_order_relaxed)) {
+            if (!connected.load()) {
+                sleep_reconnect();
+                if (!running.load(std::memory_order_relaxed)) {
+                    break;
+                }
+                auto range = handshake(config.reconnect_ms);
+                if (range && *range != delegated) {
+                    // JobManager уже раздаёт extranonce прежнего диапазона
+                    close_fd();
+                }
+                handle_frames();
+                continue;
+            }
+
+            pollfd pfd{fd, POLLIN, 0};
+            if (::poll(&pfd, 1, POLL_INTERVAL_MS) <= 0) {
+                continue;
+            }
+            if (!read_available(fd, in)) {
+                close_fd();
+                continue;
+            }
+            handle_frames();
+        }
+    }
+};
+
+TemplateFeedClient::TemplateFeedClient(const ProxyConfig& config)
+    : impl_(std::make_unique<Impl>(config)) {}
+
+TemplateFeedClient::~TemplateFeedClient() {
+    stop();
+    impl_->close_fd();
+}
+
+void TemplateFeedClient::set_template_callback(bitcoin::NewTemplateCallback callback) {
+    impl_->template_callback = std::move(callback);
+}
+
+void TemplateFeedClient::set_state_callback(FeedStateCallback callback) {
+    impl_->state_callback = std::move(callback);
+}
+
+Result<ExtranonceRange> TemplateFeedClient::connect(uint32_t timeout_ms) {
+    auto range = impl_->handshake(timeout_ms);
+    if (range) {
+        impl_->delegated = *range;
+    }
+    return range;
+}
+
+void TemplateFeedClient::start() {
+    if (impl_->running.exchange(true)) {
+        return;
+    }
+    // Шаблоны вышестоящего - приход блока для этой площадки
+    impl_->worker = std::thread([this] {
+        core::enter_thread_role(core::ThreadRole::BlockPath);
+        impl_->worker_loop();
+    });
+}
+
+void TemplateFeedClient::stop() {
+    if (!impl_->running.exchange(false)) {
+        return;
+    }
+    if (impl_->worker.joinable()) {
+        impl_->worker.join();
+    }
+}
+
+Result<void> TemplateFeedClient::submit_block(ByteSpan block) {
+    Bytes frame = serialize_feed_frame(FeedMessage::Block, block);
+    std::lock_guard<std::mutex> lock(impl_->fd_mutex);
+    if (impl_->fd < 0) {
+        return Err<void>(ErrorCode::NetworkSendFailed, "Нет соединения с вышестоящей площадкой");
+    }
+    if (!send_all(impl_->fd, frame)) {
+        return Err<void>(ErrorCode::NetworkSendFailed,
+                         std::string("Блок не отправлен вышестоящей площадке: ") + strerror(errno));
+    }
+    return {};
+}
+
+bool TemplateFeedClient::is_connected() const noexcept {
+    return impl_->connected.load();
+}
+
+uint64_t TemplateFeedClient::templates_received() const noexcept {
+    return impl_->templates.load(std::memory_order_relaxed);
+}
+
+} // namespace quaxis::network
@@ -0,0 +1,257 @@
+/**
+ * @file template_feed.hpp
+ * @brief Фид шаблонов между площадками (иерархический прокси)
+ *
+ * Площадка без своего узла получает шаблоны от вышестоящего quaxis по
+ * TCP и раздаёт задания своим ASIC сама: рассылка нового блока идёт
+ * деревом, каждая площадка - по своей LAN.
+ *
+ * Кадр: тип (1) + длина payload (4, LE) + payload.
+ * - Hello (вниз -> вверх): magic (4) + версия (1) + номер площадки (1)
+ * - Delegation (вверх -> вниз): начало диапазона extranonce (8) + бит (1)
+ * - Template: состояние (1: 0 - confirmed, 1 - speculative) + высота (4) +
+ *   награда (8) + заголовок (80) + coinbase до extranonce (64) +
+ *   длина хвоста (2) + хвост coinbase после extranonce (выплата,
+ *   witness и aux commitment) - раскладка ShmTemplateData без ветви
+ * - TemplateState: 1 - speculative шаблон подтверждён, 0 - отменён
+ * - Block (вниз -> вверх): сериализованный найденный блок
+ *
+ * Диапазон extranonce площадки site - на 8 бит уже диапазона
+ * вышестоящего: [base + site * 2^(bits - 8), ...). Собственным ASIC
+ * узла остаётся поддиапазон site = 0.
+ */
+
+#pragma once
+
+#include "../core/types.hpp"
+#include "../core/config.hpp"
+#include "../bitcoin/block.hpp"
+#include "../bitcoin/shm_template.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+
+namespace quaxis::network {
+
+// =============================================================================
+// Протокол фида
+// =============================================================================
+
+/// @brief Сигнатура Hello ("QXFD")
+inline constexpr uint32_t FEED_MAGIC = 0x44465851;
+
+/// @brief Версия протокола фида
+inline constexpr uint8_t FEED_VERSION = 1;
+
+/// @brief Заголовок кадра: тип + длина payload
+inline constexpr std::size_t FEED_FRAME_HEADER_SIZE = 5;
+
+/// @brief Наибольший payload (блок только с coinbase - около 1.2 КБ)
+inline constexpr std::size_t FEED_MAX_PAYLOAD = 64 * 1024;
+
+/// @brief Бит диапазона extranonce на номер площадки
+inline constexpr uint8_t FEED_SITE_BITS = 8;
+
+/**
+ * @brief Тип кадра фида
+ */
+enum class FeedMessage : uint8_t {
+    Hello = 0x01,
+    Delegation = 0x02,
+    Template = 0x03,
+    TemplateState = 0x04,
+    Block = 0x05
+};
+
+/**
+ * @brief Диапазон extranonce узла дерева: [base, base + 2^bits)
+ */
+struct ExtranonceRange {
+    uint64_t base{0};
+    uint8_t bits{0};
+
+    /**
+     * @brief Диапазон всего extranonce (корень дерева)
+     *
+     * @param extranonce_size Размер extranonce в байтах (1-8)
+     */
+    [[nodiscard]] static ExtranonceRange root(std::size_t extranonce_size) noexcept;
+
+    /**
+     * @brief Диапазон площадки site (1-255)
+     *
+     * @return nullopt - диапазон слишком мал для деления (меньше 16 бит)
+     */
+    [[nodiscard]] std::optional<ExtranonceRange> delegate(uint8_t site) const noexcept;
+
+    /**
+     * @brief Первый extranonce собственных соединений узла
+     */
+    [[nodiscard]] uint64_t first_own() const noexcept { return base + 1; }
+    
+    /**
+     * @brief Конец extranonce собственных соединений узла (не включая)
+     *
+     * Узел, раздающий площадки (delegating), оставляет себе долю site 0:
+     * доли 1-255 отданы delegate(). Иначе весь диапазон - свой.
+     */
+    [[nodiscard]] uint64_t own_end(bool delegating) const noexcept;
+
+    bool operator==(const ExtranonceRange&) const = default;
+};
+
+/**
+ * @brief Кадр фида
+ */
+[[nodiscard]] Bytes serialize_feed_frame(FeedMessage type, ByteSpan payload);
+
+/**
+ * @brief Payload Template из шаблона
+ *
+ * @param block_template Шаблон с собственной coinbase (extranonce на смещении 64)
+ * @param is_speculative Tip шаблона ещё не валидирован
+ * @return Result<Bytes> Payload или ошибка (coinbase без места под extranonce)
+ */
+[[nodiscard]] Result<Bytes> encode_feed_template(
+    const bitcoin::BlockTemplate& block_template,
+    bool is_speculative
+);
+
+/**
+ * @brief Шаблон из payload Template
+ *
+ * Coinbase собирается с extranonce = 0, merkle_root и midstate - сразу
+ * (bitcoin::fill_block_template).
+ */
+[[nodiscard]] Result<std::shared_ptr<const bitcoin::BlockTemplate>> decode_feed_template(ByteSpan payload);
+
+// =============================================================================
+// Сервер фида (вышестоящая площадка)
+// =============================================================================
+
+/**
+ * @brief Callback блока, найденного нижестоящей площадкой
+ */
+using FeedBlockCallback = std::function<void(Bytes block, uint8_t site)>;
+
+/**
+ * @brief Раздача шаблонов нижестоящим площадкам
+ *
+ * Один поток принимает площадки и их блоки. publish() сериализует кадр
+ * один раз и пишет его во все сокеты без блокировки: площадка, которая
+ * не успевает забирать шаблоны, отключается.
+ */
+class TemplateFeedServer {
+public:
+    /**
+     * @param config proxy.feed_port и feed_bind_address
+     * @param range Диапазон extranonce этого узла (делится между площадками)
+     */
+    TemplateFeedServer(const ProxyConfig& config, ExtranonceRange range);
+
+    ~TemplateFeedServer();
+
+    TemplateFeedServer(const TemplateFeedServer&) = delete;
+    TemplateFeedServer& operator=(const TemplateFeedServer&) = delete;
+
+    /**
+     * @brief Установить callback найденных блоков (до start())
+     */
+    void set_block_callback(FeedBlockCallback callback);
+
+    [[nodiscard]] Result<void> start();
+
+    void stop();
+
+    /**
+     * @brief Разослать новый шаблон всем площадкам
+     *
+     * Подключившаяся позже площадка получает последний шаблон сразу
+     * после Delegation.
+     */
+    void publish(const std::shared_ptr<const bitcoin::BlockTemplate>& block_template, bool is_speculative);
+
+    /**
+     * @brief Разослать подтверждение или отмену speculative шаблона
+     */
+    void publish_state(bool confirmed);
+
+    /**
+     * @brief Площадок, прошедших Hello
+     */
+    [[nodiscard]] std::size_t site_count() const;
+
+    /**
+     * @brief Фактический порт (feed_port = 0 в тестах - выбирает ядро)
+     */
+    [[nodiscard]] uint16_t port() const noexcept;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+// =============================================================================
+// Клиент фида (нижестоящая площадка)
+// =============================================================================
+
+/**
+ * @brief Callback подтверждения (true) или отмены (false) speculative шаблона
+ */
+using FeedStateCallback = std::function<void(bool confirmed)>;
+
+/**
+ * @brief Подписка на фид вышестоящей площадки
+ *
+ * connect() проходит Hello синхронно: диапазон extranonce нужен до
+ * создания JobManager. Дальше поток читает шаблоны и при обрыве
+ * переподключается; диапазон после переподключения должен совпасть.
+ */
+class TemplateFeedClient {
+public:
+    explicit TemplateFeedClient(const ProxyConfig& config);
+
+    ~TemplateFeedClient();
+
+    TemplateFeedClient(const TemplateFeedClient&) = delete;
+    TemplateFeedClient& operator=(const TemplateFeedClient&) = delete;
+
+    void set_template_callback(bitcoin::NewTemplateCallback callback);
+
+    void set_state_callback(FeedStateCallback callback);
+
+    /**
+     * @brief Подключиться и получить диапазон extranonce площадки
+     *
+     * @param timeout_ms Сколько ждать Delegation
+     */
+    [[nodiscard]] Result<ExtranonceRange> connect(uint32_t timeout_ms = 5000);
+
+    /**
+     * @brief Запустить поток чтения шаблонов (после connect() и callbacks)
+     */
+    void start();
+
+    void stop();
+
+    /**
+     * @brief Отправить найденный блок вышестоящему
+     */
+    [[nodiscard]] Result<void> submit_block(ByteSpan block);
+
+    [[nodiscard]] bool is_connected() const noexcept;
+
+    /**
+     * @brief Принятых шаблонов
+     */
+    [[nodiscard]] uint64_t templates_received() const noexcept;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace quaxis::network
@@ -0,0 +1,319 @@
+/**
+ * @file uring_sender.cpp
+ * @brief Реализация пакетной отправки через io_uring
+ */
+
+#include "uring_sender.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <format>
+
+#ifdef QUAXIS_HAS_IO_URING
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <atomic>
+
+#endif
+
+namespace quaxis::network {
+
+#ifdef QUAXIS_HAS_IO_URING
+
+namespace {
+
+int sys_io_uring_setup(unsigned entries, struct io_uring_params* params) {
+    return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+int sys_io_uring_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+    return static_cast<int>(syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0));
+}
+
+int sys_io_uring_register(int fd, unsigned opcode, const void* arg, unsigned nr_args) {
+    return static_cast<int>(syscall(__NR_io_uring_register, fd, opcode, arg, nr_args));
+}
+
+/// @brief Загрузка индекса кольца, разделяемого с ядром
+inline unsigned load_acquire(unsigned* p) noexcept {
+    return std::atomic_ref<unsigned>(*p).load(std::memory_order_acquire);
+}
+
+inline void store_release(unsigned* p, unsigned v) noexcept {
+    std::atomic_ref<unsigned>(*p).store(v, std::memory_order_release);
+}
+
+} // anonymous namespace
+
+struct UringSender::Impl {
+    std::size_t capacity;
+    int ring_fd = -1;
+
+    // SQ кольцо
+    void* sq_ptr = nullptr;
+    std::size_t sq_size = 0;
+    unsigned* sq_tail = nullptr;
+    unsigned* sq_mask = nullptr;
+    unsigned* sq_array = nullptr;
+    unsigned sq_entries = 0;
+    struct io_uring_sqe* sqes = nullptr;
+    std::size_t sqes_size = 0;
+
+    // CQ кольцо
+    void* cq_ptr = nullptr;
+    std::size_t cq_size = 0;
+    unsigned* cq_head = nullptr;
+    unsigned* cq_tail = nullptr;
+    unsigned* cq_mask = nullptr;
+    struct io_uring_cqe* cqes = nullptr;
+
+    // Зарегистрированные буферы: capacity слотов по MAX_FRAME_SIZE
+    uint8_t* buffers = nullptr;
+    std::size_t buffers_size = 0;
+
+    explicit Impl(std::size_t cap) : capacity(cap == 0 ? 1 : cap) {}
+
+    ~Impl() {
+        release();
+    }
+
+    Result<void> fail(const char* what) {
+        int err = errno;
+        release();
+        return Err<void>(
+            ErrorCode::NetworkSendFailed,
+            std::format("io_uring: {}: {}", what, strerror(err))
+        );
+    }
+
+    Result<void> start() {
+        struct io_uring_params params{};
+        ring_fd = sys_io_uring_setup(static_cast<unsigned>(capacity), &params);
+        if (ring_fd < 0) {
+            return fail("io_uring_setup");
+        }
+
+        sq_entries = params.sq_entries;
+        sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cq_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+
+        bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (single_mmap) {
+            sq_size = cq_size = std::max(sq_size, cq_size);
+        }
+
+        sq_ptr = mmap(nullptr, sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      ring_fd, IORING_OFF_SQ_RING);
+        if (sq_ptr == MAP_FAILED) {
+            sq_ptr = nullptr;
+            return fail("mmap SQ");
+        }
+
+        if (single_mmap) {
+            cq_ptr = sq_ptr;
+        } else {
+            cq_ptr = mmap(nullptr, cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                          ring_fd, IORING_OFF_CQ_RING);
+            if (cq_ptr == MAP_FAILED) {
+                cq_ptr = nullptr;
+                return fail("mmap CQ");
+            }
+        }
+
+        sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+        void* sqes_ptr = mmap(nullptr, sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                              ring_fd, IORING_OFF_SQES);
+        if (sqes_ptr == MAP_FAILED) {
+            return fail("mmap SQEs");
+        }
+        sqes = static_cast<struct io_uring_sqe*>(sqes_ptr);
+
+        auto* sq = static_cast<uint8_t*>(sq_ptr);
+        sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sq_mask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+
+        auto* cq = static_cast<uint8_t*>(cq_ptr);
+        cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cq_mask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes = reinterpret_cast<struct io_uring_cqe*>(cq + params.cq_off.cqes);
+
+        // Фиксированные буферы кадров
+        buffers_size = static_cast<std::size_t>(sq_entries) * MAX_FRAME_SIZE;
+        void* buf = mmap(nullptr, buffers_size, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+        if (buf == MAP_FAILED) {
+            return fail("mmap buffers");
+        }
+        buffers = static_cast<uint8_t*>(buf);
+
+        struct iovec iov{buffers, buffers_size};
+        if (sys_io_uring_register(ring_fd, IORING_REGISTER_BUFFERS, &iov, 1) < 0) {
+            return fail("IORING_REGISTER_BUFFERS");
+        }
+
+        return {};
+    }
+
+    void release() {
+        if (buffers) {
+            munmap(buffers, buffers_size);
+            buffers = nullptr;
+        }
+        if (sqes) {
+            munmap(sqes, sqes_size);
+            sqes = nullptr;
+        }
+        if (cq_ptr && cq_ptr != sq_ptr) {
+            munmap(cq_ptr, cq_size);
+        }
+        cq_ptr = nullptr;
+        if (sq_ptr) {
+            munmap(sq_ptr, sq_size);
+            sq_ptr = nullptr;
+        }
+        if (ring_fd >= 0) {
+            close(ring_fd);
+            ring_fd = -1;
+        }
+    }
+
+    /**
+     * @brief Один пакет: не больше sq_entries кадров
+     */
+    void submit_chunk(std::span<const UringFrame> frames, std::span<int> results) {
+        unsigned tail = *sq_tail;  // Хвост SQ пишет только приложение
+        const unsigned mask = *sq_mask;
+
+        unsigned count = 0;
+        for (std::size_t i = 0; i < frames.size(); ++i) {
+            const auto& frame = frames[i];
+            if (frame.data.size() > MAX_FRAME_SIZE) {
+                results[i] = -EMSGSIZE;  // Не помещается в слот буфера
+                continue;
+            }
+
+            uint8_t* slot = buffers + i * MAX_FRAME_SIZE;
+            std::memcpy(slot, frame.data.data(), frame.data.size());
+
+            unsigned idx = tail & mask;
+            struct io_uring_sqe* sqe = &sqes[idx];
+            std::memset(sqe, 0, sizeof(*sqe));
+            sqe->opcode = IORING_OP_WRITE_FIXED;
+            sqe->fd = frame.fd;
+            sqe->addr = reinterpret_cast<uint64_t>(slot);
+            sqe->len = static_cast<uint32_t>(frame.data.size());
+            sqe->buf_index = 0;
+            sqe->user_data = i;
+
+            sq_array[idx] = idx;
+            ++tail;
+            ++count;
+        }
+        store_release(sq_tail, tail);
+
+        unsigned completed = 0;
+        unsigned to_submit = count;
+
+        while (completed < count) {
+            int ret = sys_io_uring_enter(ring_fd, to_submit, count - completed, IORING_ENTER_GETEVENTS);
+            if (ret < 0 && errno != EINTR) {
+                // Кольцо неработоспособно: незавершённые кадры считаем неотправленными
+                int err = errno;
+                for (std::size_t i = 0; i < frames.size(); ++i) {
+                    if (results[i] == 0) {
+                        results[i] = -err;
+                    }
+                }
+                return;
+            }
+            if (ret > 0) {
+                to_submit -= std::min(to_submit, static_cast<unsigned>(ret));
+            }
+
+            unsigned head = *cq_head;
+            unsigned ctail = load_acquire(cq_tail);
+            const unsigned cmask = *cq_mask;
+            while (head != ctail) {
+                const struct io_uring_cqe& cqe = cqes[head & cmask];
+                results[cqe.user_data] = cqe.res;
+                ++head;
+                ++completed;
+            }
+            store_release(cq_head, head);
+        }
+    }
+};
+
+#else // !QUAXIS_HAS_IO_URING
+
+struct UringSender::Impl {
+    std::size_t capacity;
+    int ring_fd = -1;
+
+    explicit Impl(std::size_t cap) : capacity(cap) {}
+
+    Result<void> start() {
+        return Err<void>(ErrorCode::NetworkSendFailed, "io_uring не поддерживается сборкой");
+    }
+
+    void submit_chunk(std::span<const UringFrame> frames, std::span<int> results) {
+        for (std::size_t i = 0; i < frames.size(); ++i) {
+            results[i] = -1;
+        }
+    }
+};
+
+#endif // QUAXIS_HAS_IO_URING
+
+UringSender::UringSender(std::size_t capacity)
+    : impl_(std::make_unique<Impl>(capacity))
+{
+}
+
+UringSender::~UringSender() = default;
+
+Result<void> UringSender::start() {
+    return impl_->start();
+}
+
+bool UringSender::is_active() const noexcept {
+    return impl_->ring_fd >= 0;
+}
+
+std::size_t UringSender::submit(std::span<const UringFrame> frames, std::span<int> results) {
+    std::fill(results.begin(), results.begin() + static_cast<std::ptrdiff_t>(frames.size()), 0);
+
+    if (!is_active()) {
+        std::fill(results.begin(), results.begin() + static_cast<std::ptrdiff_t>(frames.size()), -1);
+        return 0;
+    }
+
+#ifdef QUAXIS_HAS_IO_URING
+    const std::size_t chunk = impl_->sq_entries;
+#else
+    const std::size_t chunk = impl_->capacity;
+#endif
+
+    for (std::size_t offset = 0; offset < frames.size(); offset += chunk) {
+        std::size_t n = std::min(chunk, frames.size() - offset);
+        impl_->submit_chunk(frames.subspan(offset, n), results.subspan(offset, n));
+    }
+
+    std::size_t sent = 0;
+    for (std::size_t i = 0; i < frames.size(); ++i) {
+        if (results[i] == static_cast<int>(frames[i].data.size())) {
+            ++sent;
+        }
+    }
+    return sent;
+}
+
+} // namespace quaxis::network
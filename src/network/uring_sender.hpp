@@ -0,0 +1,90 @@
+/**
+ * @file uring_sender.hpp
+ * @brief Пакетная отправка кадров через io_uring
+ *
+ * При новом блоке все ASIC должны получить задание практически
+ * одновременно. Вместо N вызовов send() (или N пробуждений send-потоков)
+ * все кадры отправляются одним io_uring_enter():
+ * - кадры копируются в заранее зарегистрированные буферы
+ *   (IORING_REGISTER_BUFFERS), ядро не пинит страницы на каждый вызов
+ * - на каждый кадр одна SQE IORING_OP_WRITE_FIXED
+ * - вызывающий ждёт все CQE и получает результат по каждому сокету
+ *
+ * Используются системные вызовы напрямую (linux/io_uring.h), без liburing.
+ * Если ядро не поддерживает io_uring (или он запрещён seccomp), start()
+ * возвращает ошибку и вызывающий использует обычный путь.
+ */
+
+#pragma once
+
+#include "../core/types.hpp"
+
+#include <memory>
+#include <span>
+
+namespace quaxis::network {
+
+/**
+ * @brief Кадр для пакетной отправки
+ */
+struct UringFrame {
+    /// @brief Сокет назначения
+    int fd = -1;
+
+    /// @brief Данные кадра (не длиннее UringSender::MAX_FRAME_SIZE)
+    ByteSpan data;
+};
+
+/**
+ * @brief Отправитель кадров одним пакетом SQE
+ *
+ * Не thread-safe: вызывающий сериализует submit().
+ */
+class UringSender {
+public:
+    /// @brief Размер слота зарегистрированного буфера (с запасом под NewJobSlots)
+    static constexpr std::size_t MAX_FRAME_SIZE = 192;
+
+    /**
+     * @brief Создать отправитель
+     *
+     * @param capacity Максимум кадров в одном пакете (размер SQ)
+     */
+    explicit UringSender(std::size_t capacity = 1024);
+
+    ~UringSender();
+
+    // Запрещаем копирование
+    UringSender(const UringSender&) = delete;
+    UringSender& operator=(const UringSender&) = delete;
+
+    /**
+     * @brief Создать кольцо и зарегистрировать буферы
+     *
+     * @return Result<void> Успех или ошибка (io_uring недоступен)
+     */
+    [[nodiscard]] Result<void> start();
+
+    /**
+     * @brief Готов ли отправитель
+     */
+    [[nodiscard]] bool is_active() const noexcept;
+
+    /**
+     * @brief Отправить кадры одним пакетом и дождаться завершения
+     *
+     * Пакеты больше capacity отправляются несколькими io_uring_enter().
+     *
+     * @param frames Кадры
+     * @param results Результат по каждому кадру: отправлено байт или -errno
+     *                (размер не меньше frames.size())
+     * @return std::size_t Количество кадров, отправленных целиком
+     */
+    std::size_t submit(std::span<const UringFrame> frames, std::span<int> results);
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace quaxis::network
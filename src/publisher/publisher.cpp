@@ -0,0 +1,383 @@
+/**
+ * @file publisher.cpp
+ * @brief Реализация C ABI издателя shared memory
+ *
+ * Протоколы не дублируются: канал блоков пишет через ShmRingWriter,
+ * канал шаблонов - через publish_shm_template, канал отправки читает
+ * через ShmSubmitReader. Отсюда только отображение сегментов и
+ * перевод ошибок в errno.
+ */
+
+#include "quaxis_publisher.h"
+
+#include "../bitcoin/shm_ring.hpp"
+#include "../bitcoin/shm_submit.hpp"
+#include "../bitcoin/shm_template_layout.hpp"
+#include "../shm/placement.hpp"
+#include "../shm/sequence_futex.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <new>
+#include <optional>
+#include <string>
+
+namespace qb = quaxis::bitcoin;
+namespace qs = quaxis::shm;
+
+static_assert(QUAXIS_BLOCK_SPECULATIVE == static_cast<int>(qb::ShmBlockState::Speculative));
+static_assert(QUAXIS_BLOCK_CONFIRMED == static_cast<int>(qb::ShmBlockState::Confirmed));
+static_assert(QUAXIS_BLOCK_INVALID == static_cast<int>(qb::ShmBlockState::Invalid));
+static_assert(QUAXIS_HEADER_SIZE == sizeof(qb::ShmBlockEvent::header_raw));
+static_assert(QUAXIS_TEMPLATE_PREFIX_SIZE == qb::SHM_TEMPLATE_PREFIX_SIZE);
+static_assert(QUAXIS_TEMPLATE_MAX_SUFFIX == qb::SHM_TEMPLATE_MAX_SUFFIX);
+static_assert(QUAXIS_TEMPLATE_MAX_BRANCH == qb::SHM_TEMPLATE_MAX_BRANCH);
+static_assert(QUAXIS_SUBMIT_MAX_COINBASE == qb::SHM_SUBMIT_MAX_COINBASE);
+
+namespace {
+
+// =============================================================================
+// Отображение сегментов
+// =============================================================================
+
+/**
+ * @brief Отображённый сегмент
+ */
+struct Mapping {
+    std::string path;
+    qs::SegmentPlacement placement;
+    void* ptr{nullptr};
+    std::size_t length{0};
+
+    ~Mapping() {
+        if (ptr != nullptr) {
+            munmap(ptr, length);
+        }
+    }
+};
+
+qs::SegmentPlacement to_placement(const quaxis_placement* placement) {
+    qs::SegmentPlacement result;
+    if (placement != nullptr) {
+        if (placement->hugetlb_dir != nullptr) {
+            result.hugetlb_dir = placement->hugetlb_dir;
+        }
+        result.numa_node = placement->numa_node;
+    }
+    return result;
+}
+
+/**
+ * @brief Отобразить сегмент
+ *
+ * create: сегмент создаётся (или перезаписывается) обнулённым, страницы
+ * привязываются к NUMA узлу до первой записи. Иначе - открывается
+ * существующий не меньше size байт.
+ *
+ * @return 0 или код errno
+ */
+int map_segment(Mapping& mapping, std::size_t size, bool create) {
+    errno = 0;
+    auto opened = qs::open_segment(
+        mapping.placement, mapping.path, create ? O_CREAT | O_RDWR : O_RDWR, 0644);
+    if (!opened) {
+        return errno != 0 ? errno : EIO;
+    }
+    const int fd = *opened;
+
+    int error = 0;
+    std::size_t length = qs::segment_map_length(fd, size);
+    if (create) {
+        if (ftruncate(fd, static_cast<off_t>(length)) < 0) {
+            error = errno;
+        }
+    } else {
+        struct stat st{};
+        if (fstat(fd, &st) < 0) {
+            error = errno;
+        } else if (static_cast<std::size_t>(st.st_size) < size) {
+            error = EINVAL;
+        } else {
+            length = static_cast<std::size_t>(st.st_size);
+        }
+    }
+
+    void* ptr = MAP_FAILED;
+    if (error == 0) {
+        ptr = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (ptr == MAP_FAILED) {
+            error = errno;
+        }
+    }
+    close(fd);
+    if (error != 0) {
+        if (create) {
+            (void)qs::unlink_segment(mapping.placement, mapping.path);
+        }
+        return error;
+    }
+
+    mapping.ptr = ptr;
+    mapping.length = length;
+    if (create) {
+        if (mapping.placement.numa_node >= 0 &&
+            !qs::bind_to_numa_node(ptr, length, mapping.placement.numa_node)) {
+            (void)qs::unlink_segment(mapping.placement, mapping.path);
+            return EINVAL;
+        }
+        std::memset(ptr, 0, length);
+    }
+    return 0;
+}
+
+/**
+ * @brief Создать канал T поверх сегмента размера size
+ *
+ * @return Канал или nullptr (errno)
+ */
+template<typename Channel, typename Init>
+Channel* create_channel(
+    const char* path,
+    const quaxis_placement* placement,
+    std::size_t size,
+    bool create,
+    Init&& init
+) noexcept {
+    if (path == nullptr || *path == '\0') {
+        errno = EINVAL;
+        return nullptr;
+    }
+    try {
+        auto* channel = new Channel();
+        channel->mapping.path = path;
+        channel->mapping.placement = to_placement(placement);
+        const int error = map_segment(channel->mapping, size, create);
+        if (error != 0 || !init(*channel)) {
+            const int saved = error != 0 ? error : EINVAL;
+            delete channel;
+            errno = saved;
+            return nullptr;
+        }
+        return channel;
+    } catch (const std::bad_alloc&) {
+        errno = ENOMEM;
+        return nullptr;
+    }
+}
+
+void close_mapping(Mapping& mapping, int unlink) noexcept {
+    if (unlink != 0) {
+        (void)qs::unlink_segment(mapping.placement, mapping.path);
+    }
+}
+
+[[nodiscard]] bool is_known_state(uint8_t state) noexcept {
+    return state == QUAXIS_BLOCK_SPECULATIVE
+        || state == QUAXIS_BLOCK_CONFIRMED
+        || state == QUAXIS_BLOCK_INVALID;
+}
+
+} // anonymous namespace
+
+// =============================================================================
+// Каналы
+// =============================================================================
+
+struct quaxis_block_channel {
+    Mapping mapping;
+    bool ring{false};
+};
+
+struct quaxis_template_channel {
+    Mapping mapping;
+};
+
+struct quaxis_submit_channel {
+    Mapping mapping;
+    std::optional<qb::ShmSubmitReader> reader;
+};
+
+extern "C" {
+
+uint32_t quaxis_publisher_abi_version(void) {
+    return QUAXIS_PUBLISHER_ABI_VERSION;
+}
+
+// =============================================================================
+// Канал блоков
+// =============================================================================
+
+quaxis_block_channel* quaxis_block_channel_create(
+    const char* path, int layout, const quaxis_placement* placement) {
+    if (layout != QUAXIS_LAYOUT_SINGLE && layout != QUAXIS_LAYOUT_RING) {
+        errno = EINVAL;
+        return nullptr;
+    }
+    const bool ring = layout == QUAXIS_LAYOUT_RING;
+    return create_channel<quaxis_block_channel>(
+        path, placement, ring ? sizeof(qb::QuaxisSharedRing) : sizeof(qb::QuaxisSharedBlock), true,
+        [ring](quaxis_block_channel& channel) {
+            channel.ring = ring;
+            if (ring) {
+                qb::init_shm_ring(*static_cast<qb::QuaxisSharedRing*>(channel.mapping.ptr));
+            }
+            return true;
+        });
+}
+
+uint64_t quaxis_block_publish(quaxis_block_channel* channel, const quaxis_block* block) {
+    if (channel == nullptr || block == nullptr || !is_known_state(block->state)) {
+        return 0;
+    }
+
+    if (channel->ring) {
+        qb::ShmBlockEvent event;
+        event.state = static_cast<qb::ShmBlockState>(block->state);
+        event.height = block->height;
+        event.bits = block->bits;
+        event.timestamp = block->timestamp;
+        event.coinbase_value = block->coinbase_value;
+        std::memcpy(event.header_raw, block->header, sizeof(event.header_raw));
+        std::memcpy(event.block_hash, block->hash, sizeof(event.block_hash));
+        return qb::ShmRingWriter(*static_cast<qb::QuaxisSharedRing*>(channel->mapping.ptr)).publish(event);
+    }
+
+    // Одиночный блок: поля, затем sequence (подписчик читает после его смены)
+    auto& shared = *static_cast<qb::QuaxisSharedBlock*>(channel->mapping.ptr);
+    std::memcpy(shared.header_raw, block->header, sizeof(shared.header_raw));
+    shared.height = block->height;
+    shared.bits = block->bits;
+    shared.timestamp = block->timestamp;
+    shared.coinbase_value = block->coinbase_value;
+    std::memcpy(shared.block_hash, block->hash, sizeof(shared.block_hash));
+    shared.state.store(block->state, std::memory_order_relaxed);
+    return qs::publish_sequence(shared.sequence);
+}
+
+void quaxis_block_channel_close(quaxis_block_channel* channel, int unlink) {
+    if (channel != nullptr) {
+        close_mapping(channel->mapping, unlink);
+        delete channel;
+    }
+}
+
+// =============================================================================
+// Канал шаблонов
+// =============================================================================
+
+quaxis_template_channel* quaxis_template_channel_create(const char* path, const quaxis_placement* placement) {
+    return create_channel<quaxis_template_channel>(
+        path, placement, sizeof(qb::QuaxisSharedTemplate), true,
+        [](quaxis_template_channel& channel) {
+            auto* segment = static_cast<qb::QuaxisSharedTemplate*>(channel.mapping.ptr);
+            segment->magic = qb::SHM_TEMPLATE_MAGIC;
+            segment->layout_version = qb::SHM_TEMPLATE_LAYOUT_VERSION;
+            std::atomic_thread_fence(std::memory_order_release);
+            return true;
+        });
+}
+
+uint64_t quaxis_template_publish(quaxis_template_channel* channel, const quaxis_template* tmpl) {
+    if (channel == nullptr || tmpl == nullptr ||
+        (tmpl->state != QUAXIS_BLOCK_SPECULATIVE && tmpl->state != QUAXIS_BLOCK_CONFIRMED) ||
+        tmpl->coinbase_suffix_size > qb::SHM_TEMPLATE_MAX_SUFFIX ||
+        tmpl->merkle_branch_size > qb::SHM_TEMPLATE_MAX_BRANCH ||
+        (tmpl->coinbase_suffix_size != 0 && tmpl->coinbase_suffix == nullptr) ||
+        (tmpl->merkle_branch_size != 0 && tmpl->merkle_branch == nullptr)) {
+        return 0;
+    }
+
+    qb::ShmTemplateData data;
+    data.height = tmpl->height;
+    data.state = static_cast<qb::ShmBlockState>(tmpl->state);
+    data.merkle_branch_size = static_cast<uint8_t>(tmpl->merkle_branch_size);
+    data.coinbase_suffix_size = static_cast<uint16_t>(tmpl->coinbase_suffix_size);
+    data.coinbase_value = tmpl->coinbase_value;
+    std::memcpy(data.header_raw, tmpl->header, sizeof(data.header_raw));
+    std::memcpy(data.coinbase_prefix, tmpl->coinbase_prefix, sizeof(data.coinbase_prefix));
+    if (tmpl->coinbase_suffix_size != 0) {
+        std::memcpy(data.coinbase_suffix, tmpl->coinbase_suffix, tmpl->coinbase_suffix_size);
+    }
+    if (tmpl->merkle_branch_size != 0) {
+        std::memcpy(data.merkle_branch, tmpl->merkle_branch, tmpl->merkle_branch_size * 32);
+    }
+    return qb::publish_shm_template(*static_cast<qb::QuaxisSharedTemplate*>(channel->mapping.ptr), data);
+}
+
+void quaxis_template_channel_close(quaxis_template_channel* channel, int unlink) {
+    if (channel != nullptr) {
+        close_mapping(channel->mapping, unlink);
+        delete channel;
+    }
+}
+
+// =============================================================================
+// Канал отправки
+// =============================================================================
+
+quaxis_submit_channel* quaxis_submit_channel_open(const char* path, const quaxis_placement* placement) {
+    const auto attach = [](quaxis_submit_channel& channel) {
+        auto& segment = *static_cast<qb::QuaxisSharedSubmit*>(channel.mapping.ptr);
+        if (!qb::is_shm_submit(segment)) {
+            return false;
+        }
+        channel.reader.emplace(segment);
+        return true;
+    };
+
+    auto* channel = create_channel<quaxis_submit_channel>(
+        path, placement, sizeof(qb::QuaxisSharedSubmit), false, attach);
+    if (channel != nullptr || errno != ENOENT) {
+        return channel;
+    }
+    // Майнер ещё не создавал сегмент
+    return create_channel<quaxis_submit_channel>(
+        path, placement, sizeof(qb::QuaxisSharedSubmit), true,
+        [&attach](quaxis_submit_channel& created) {
+            qb::init_shm_submit(*static_cast<qb::QuaxisSharedSubmit*>(created.mapping.ptr));
+            return attach(created);
+        });
+}
+
+size_t quaxis_submit_poll(quaxis_submit_channel* channel, quaxis_found_block_fn fn, void* context) {
+    if (channel == nullptr || fn == nullptr) {
+        return 0;
+    }
+    return channel->reader->drain([fn, context](const qb::ShmSubmitEvent& event) {
+        quaxis_found_block block;
+        block.sequence = event.sequence;
+        block.header = event.header_raw;
+        block.hash = event.block_hash;
+        block.coinbase = event.coinbase;
+        block.coinbase_size = event.coinbase_size;
+        fn(context, &block);
+    });
+}
+
+int quaxis_submit_wait(quaxis_submit_channel* channel, uint32_t timeout_us) {
+    if (channel == nullptr) {
+        return 0;
+    }
+    const auto& segment = *static_cast<const qb::QuaxisSharedSubmit*>(channel->mapping.ptr);
+    const uint64_t consumed = segment.consumed.load(std::memory_order_acquire);
+    if (segment.sequence.load(std::memory_order_acquire) != consumed) {
+        return 1;
+    }
+    return qs::wait_sequence(segment.sequence, consumed, std::chrono::microseconds(timeout_us)) ? 1 : 0;
+}
+
+uint64_t quaxis_submit_corrupted(const quaxis_submit_channel* channel) {
+    return channel != nullptr ? channel->reader->corrupted() : 0;
+}
+
+void quaxis_submit_channel_close(quaxis_submit_channel* channel) {
+    delete channel;
+}
+
+} // extern "C"
@@ -0,0 +1,243 @@
+/**
+ * @file quaxis_publisher.h
+ * @brief C ABI издателя shared memory для стороны узла
+ *
+ * Запись в сегменты майнера раньше жила только внутри майнера (тесты,
+ * бенчмарки); патчу или плагину bitcoind приходилось повторять
+ * раскладку и протокол вручную. Библиотека quaxis_publisher даёт узлу
+ * ту же реализацию, что проверяется тестами подписчика:
+ *
+ * - Канал блоков: одиночный QuaxisSharedBlock или кольцо
+ *   QuaxisSharedRing (seqlock слота с версией 2 * seq - 1 / 2 * seq)
+ * - Канал шаблонов: QuaxisSharedTemplate под seqlock сегмента
+ * - Канал отправки: приём найденных майнером блоков из QuaxisSharedSubmit
+ * - futex_wake после каждой публикации и futex_wait для приёма
+ *
+ * Зависимости - только libc и pthread: библиотека собирается разделяемой
+ * (libquaxis_publisher.so) и экспортирует лишь функции этого заголовка.
+ * Каналы однопоточные: один писатель на канал блоков / шаблонов, один
+ * читатель на канал отправки.
+ *
+ * Ошибки: функции создания возвращают NULL и выставляют errno,
+ * функции публикации возвращают 0.
+ */
+
+#ifndef QUAXIS_PUBLISHER_H
+#define QUAXIS_PUBLISHER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(QUAXIS_PUBLISHER_BUILD)
+#define QUAXIS_PUBLISHER_API __attribute__((visibility("default")))
+#else
+#define QUAXIS_PUBLISHER_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ========================================================================== */
+/* Константы                                                                  */
+/* ========================================================================== */
+
+/** @brief Версия C ABI (меняется при несовместимых изменениях) */
+#define QUAXIS_PUBLISHER_ABI_VERSION 1
+
+/** @brief Состояния блока (ShmBlockState) */
+#define QUAXIS_BLOCK_SPECULATIVE 1
+#define QUAXIS_BLOCK_CONFIRMED 2
+#define QUAXIS_BLOCK_INVALID 3
+
+/** @brief Раскладки канала блоков */
+#define QUAXIS_LAYOUT_SINGLE 0
+#define QUAXIS_LAYOUT_RING 1
+
+/** @brief Размеры полей шаблона и блока отправки */
+#define QUAXIS_HEADER_SIZE 80
+#define QUAXIS_TEMPLATE_PREFIX_SIZE 64
+#define QUAXIS_TEMPLATE_MAX_SUFFIX 1024
+#define QUAXIS_TEMPLATE_MAX_BRANCH 16
+#define QUAXIS_SUBMIT_MAX_COINBASE 2048
+
+/* ========================================================================== */
+/* Типы                                                                       */
+/* ========================================================================== */
+
+/**
+ * @brief Где создать сегмент
+ *
+ * NULL вместо указателя на структуру - /dev/shm и политика NUMA по
+ * умолчанию.
+ */
+typedef struct quaxis_placement {
+    /** @brief Каталог hugetlbfs; NULL или "" - POSIX shm_open (/dev/shm) */
+    const char* hugetlb_dir;
+
+    /** @brief NUMA узел памяти сегмента (-1 - политика по умолчанию) */
+    int numa_node;
+} quaxis_placement;
+
+/**
+ * @brief Новый tip для канала блоков
+ */
+typedef struct quaxis_block {
+    /** @brief QUAXIS_BLOCK_SPECULATIVE / CONFIRMED / INVALID */
+    uint8_t state;
+
+    uint32_t height;
+    uint32_t bits;
+    uint32_t timestamp;
+
+    /** @brief Награда за блок (satoshi) */
+    int64_t coinbase_value;
+
+    /** @brief Сериализованный заголовок */
+    uint8_t header[QUAXIS_HEADER_SIZE];
+
+    /** @brief Хеш блока (внутренний порядок байт) */
+    uint8_t hash[32];
+} quaxis_block;
+
+/**
+ * @brief Шаблон блока height для канала шаблонов
+ *
+ * Coinbase шаблона = coinbase_prefix | extranonce (6 байт) |
+ * coinbase_suffix, см. shm_template.hpp.
+ */
+typedef struct quaxis_template {
+    /** @brief QUAXIS_BLOCK_SPECULATIVE или QUAXIS_BLOCK_CONFIRMED */
+    uint8_t state;
+
+    uint32_t height;
+
+    /** @brief Награда за блок (satoshi) */
+    int64_t coinbase_value;
+
+    /** @brief Заголовок шаблона (merkle_root игнорируется) */
+    uint8_t header[QUAXIS_HEADER_SIZE];
+
+    /** @brief Coinbase до extranonce */
+    uint8_t coinbase_prefix[QUAXIS_TEMPLATE_PREFIX_SIZE];
+
+    /** @brief Coinbase после extranonce (до QUAXIS_TEMPLATE_MAX_SUFFIX байт) */
+    const uint8_t* coinbase_suffix;
+    size_t coinbase_suffix_size;
+
+    /** @brief Merkle ветвь coinbase (до QUAXIS_TEMPLATE_MAX_BRANCH хешей) */
+    const uint8_t (*merkle_branch)[32];
+    size_t merkle_branch_size;
+} quaxis_template;
+
+/**
+ * @brief Найденный майнером блок
+ *
+ * Блок = header | 0x01 (одна транзакция) | coinbase. Указатели живут
+ * до возврата из callback.
+ */
+typedef struct quaxis_found_block {
+    /** @brief Номер блока в канале отправки (1, 2, ...) */
+    uint64_t sequence;
+
+    const uint8_t* header;
+    const uint8_t* hash;
+    const uint8_t* coinbase;
+    size_t coinbase_size;
+} quaxis_found_block;
+
+/** @brief Обработчик найденного блока */
+typedef void (*quaxis_found_block_fn)(void* context, const quaxis_found_block* block);
+
+typedef struct quaxis_block_channel quaxis_block_channel;
+typedef struct quaxis_template_channel quaxis_template_channel;
+typedef struct quaxis_submit_channel quaxis_submit_channel;
+
+/** @brief Версия ABI собранной библиотеки */
+QUAXIS_PUBLISHER_API uint32_t quaxis_publisher_abi_version(void);
+
+/* ========================================================================== */
+/* Канал блоков                                                               */
+/* ========================================================================== */
+
+/**
+ * @brief Создать (перезаписать) сегмент блоков и отобразить его
+ *
+ * @param path Имя сегмента (/quaxis_block)
+ * @param layout QUAXIS_LAYOUT_SINGLE или QUAXIS_LAYOUT_RING
+ * @param placement Размещение или NULL
+ * @return Канал или NULL (errno)
+ */
+QUAXIS_PUBLISHER_API quaxis_block_channel* quaxis_block_channel_create(
+    const char* path, int layout, const quaxis_placement* placement);
+
+/**
+ * @brief Опубликовать tip и разбудить подписчиков
+ *
+ * @return Новый sequence сегмента или 0 (неизвестное состояние)
+ */
+QUAXIS_PUBLISHER_API uint64_t quaxis_block_publish(quaxis_block_channel* channel, const quaxis_block* block);
+
+/**
+ * @brief Закрыть канал; unlink != 0 - удалить сегмент
+ */
+QUAXIS_PUBLISHER_API void quaxis_block_channel_close(quaxis_block_channel* channel, int unlink);
+
+/* ========================================================================== */
+/* Канал шаблонов                                                             */
+/* ========================================================================== */
+
+/**
+ * @brief Создать (перезаписать) сегмент шаблона и отобразить его
+ */
+QUAXIS_PUBLISHER_API quaxis_template_channel* quaxis_template_channel_create(
+    const char* path, const quaxis_placement* placement);
+
+/**
+ * @brief Опубликовать шаблон и разбудить подписчиков
+ *
+ * @return Новый (чётный) sequence сегмента или 0 (состояние, хвост
+ *         coinbase или ветвь вне допустимого)
+ */
+QUAXIS_PUBLISHER_API uint64_t quaxis_template_publish(
+    quaxis_template_channel* channel, const quaxis_template* tmpl);
+
+QUAXIS_PUBLISHER_API void quaxis_template_channel_close(quaxis_template_channel* channel, int unlink);
+
+/* ========================================================================== */
+/* Канал отправки                                                             */
+/* ========================================================================== */
+
+/**
+ * @brief Открыть сегмент отправки (создать, если майнер ещё не создал)
+ *
+ * Блоки, записанные майнером до открытия, не теряются.
+ */
+QUAXIS_PUBLISHER_API quaxis_submit_channel* quaxis_submit_channel_open(
+    const char* path, const quaxis_placement* placement);
+
+/**
+ * @brief Передать fn все новые блоки по порядку и отметить их забранными
+ *
+ * @return Количество переданных блоков
+ */
+QUAXIS_PUBLISHER_API size_t quaxis_submit_poll(
+    quaxis_submit_channel* channel, quaxis_found_block_fn fn, void* context);
+
+/**
+ * @brief Ждать нового блока в futex_wait не дольше timeout_us
+ *
+ * @return 1 если есть незабранные блоки, иначе 0
+ */
+QUAXIS_PUBLISHER_API int quaxis_submit_wait(quaxis_submit_channel* channel, uint32_t timeout_us);
+
+/** @brief Слоты, пропущенные из-за порчи сегмента */
+QUAXIS_PUBLISHER_API uint64_t quaxis_submit_corrupted(const quaxis_submit_channel* channel);
+
+QUAXIS_PUBLISHER_API void quaxis_submit_channel_close(quaxis_submit_channel* channel);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* QUAXIS_PUBLISHER_H */
@@ -8,6 +8,7 @@
 #include "../crypto/sha256.hpp"
 
 #include <algorithm>
+#include <array>
 #include <cstring>
 
 namespace quaxis::relay {
@@ -38,8 +39,11 @@ struct BlockReconstructor::Impl {
     /// @brief Полученный header
     std::optional<bitcoin::BlockHeader> header_;
     
-    /// @brief Полные данные блока
-    std::optional<std::vector<uint8_t>> block_data_;
+    /// @brief Счётчики декодирования
+    FecDecodeResult decoded_;
+    
+    /// @brief Собранный блок в буфере FecDecoder (действителен до reset)
+    ByteSpan block_;
     
     /// @brief Callback для header
     HeaderCallback header_callback_;
@@ -50,6 +54,9 @@ struct BlockReconstructor::Impl {
     /// @brief Callback для таймаута
     TimeoutCallback timeout_callback_;
     
+    /// @brief decode только из try_complete (поток декодирования)
+    bool deferred_decode_{false};
+    
     /// @brief Мьютекс для thread-safety
     mutable std::mutex mutex_;
     
@@ -62,7 +69,24 @@ struct BlockReconstructor::Impl {
         , fec_decoder_(params)
         , timeout_ms_(timeout)
     {
-        stats_.start_time = std::chrono::steady_clock::now();
+        stats_.start_ticks = core::TscClock::ticks();
+    }
+    
+    /**
+     * @brief Начать реконструкцию другого блока
+     * 
+     * Арена FecDecoder и буфер блока сохраняют ёмкость.
+     */
+    void reset(const Hash256& hash, uint32_t height, const FecParams& params, uint32_t timeout) {
+        block_hash_ = hash;
+        height_ = height;
+        timeout_ms_ = timeout;
+        fec_decoder_.reset(params);
+        state_ = ReconstructionState::Waiting;
+        stats_ = ReconstructionStats{};
+        stats_.start_ticks = core::TscClock::ticks();
+        header_.reset();
+        block_ = {};
     }
     
     /**
@@ -76,19 +100,19 @@ struct BlockReconstructor::Impl {
         // Нужно минимум 80 байт для header
         constexpr std::size_t HEADER_SIZE = 80;
         
-        auto first_bytes = fec_decoder_.get_first_n_bytes(HEADER_SIZE);
-        if (!first_bytes) {
+        std::array<uint8_t, HEADER_SIZE> first_bytes;
+        if (!fec_decoder_.copy_prefix(first_bytes)) {
             return;  // Недостаточно данных
         }
         
         // Десериализуем header
-        auto header_result = bitcoin::BlockHeader::deserialize(*first_bytes);
+        auto header_result = bitcoin::BlockHeader::deserialize(first_bytes);
         if (!header_result) {
             return;  // Ошибка десериализации
         }
         
         header_ = *header_result;
-        stats_.header_time = std::chrono::steady_clock::now();
+        stats_.header_ticks = core::TscClock::ticks();
         state_ = ReconstructionState::HeaderReceived;
         
         // Вызываем callback
@@ -105,33 +129,32 @@ struct BlockReconstructor::Impl {
             return false;
         }
         
-        auto decode_result = fec_decoder_.decode();
-        if (!decode_result) {
+        auto decoded = fec_decoder_.decode_in_place(decoded_);
+        if (!decoded) {
             state_ = ReconstructionState::Failed;
             return false;
         }
         
-        block_data_ = std::move(decode_result->data);
-        stats_.chunks_recovered = decode_result->chunks_recovered;
-        stats_.complete_time = std::chrono::steady_clock::now();
+        block_ = *decoded;
+        const ByteSpan block_data = block_;
+        stats_.chunks_recovered = decoded_.chunks_recovered;
+        stats_.complete_ticks = core::TscClock::ticks();
         state_ = ReconstructionState::Complete;
         
         // Извлекаем header если ещё не был извлечён
-        if (!header_ && block_data_->size() >= 80) {
-            auto header_result = bitcoin::BlockHeader::deserialize(
-                ByteSpan{block_data_->data(), 80}
-            );
+        if (!header_ && block_data.size() >= 80) {
+            auto header_result = bitcoin::BlockHeader::deserialize(block_data.first(80));
             if (header_result) {
                 header_ = *header_result;
-                if (stats_.header_time.time_since_epoch().count() == 0) {
-                    stats_.header_time = stats_.complete_time;
+                if (stats_.header_ticks == 0) {
+                    stats_.header_ticks = stats_.complete_ticks;
                 }
             }
         }
         
         // Вызываем callback
         if (block_callback_) {
-            block_callback_(*block_data_, height_, block_hash_);
+            block_callback_(block_data, height_, block_hash_);
         }
         
         return true;
@@ -153,33 +176,70 @@ BlockReconstructor::~BlockReconstructor() = default;
 BlockReconstructor::BlockReconstructor(BlockReconstructor&&) noexcept = default;
 BlockReconstructor& BlockReconstructor::operator=(BlockReconstructor&&) noexcept = default;
 
+void BlockReconstructor::reset(
+    const Hash256& block_hash,
+    uint32_t height,
+    const FecParams& fec_params,
+    uint32_t timeout_ms
+) {
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    impl_->reset(block_hash, height, fec_params, timeout_ms);
+}
+
 bool BlockReconstructor::on_packet(const FibrePacket& packet) {
+    return on_packet(packet.view());
+}
+
+bool BlockReconstructor::on_packet(const FibrePacketView& packet) {
+    return accept(packet) == ChunkOutcome::Accepted;
+}
+
+ChunkOutcome BlockReconstructor::accept(const FibrePacketView& packet) {
     // Проверяем что это наш блок
     if (packet.header.block_hash != impl_->block_hash_) {
-        return false;
+        return ChunkOutcome::Rejected;
     }
     
-    return on_chunk(
-        packet.header.chunk_id,
+    // Все пиры должны резать блок одинаково (params неизменны после reset)
+    const FecParams& params = impl_->fec_decoder_.params();
+    if (packet.header.data_chunks != params.data_chunk_count ||
+        packet.header.fec_chunks() != params.fec_chunk_count) {
+        return ChunkOutcome::Rejected;
+    }
+    
+    // В заголовке FEC чанки нумеруются N..N+M-1, декодер ждёт 0..M-1
+    const uint16_t chunk_id = packet.header.is_fec()
+        ? static_cast<uint16_t>(packet.header.chunk_id - packet.header.data_chunks)
+        : packet.header.chunk_id;
+    
+    return add_chunk(
+        chunk_id,
         packet.header.is_fec(),
         packet.payload
     );
 }
 
 bool BlockReconstructor::on_chunk(uint16_t chunk_id, bool is_fec, ByteSpan data) {
+    return add_chunk(chunk_id, is_fec, data) == ChunkOutcome::Accepted;
+}
+
+ChunkOutcome BlockReconstructor::add_chunk(uint16_t chunk_id, bool is_fec, ByteSpan data) {
     std::lock_guard<std::mutex> lock(impl_->mutex_);
     
     // Проверяем состояние
     if (impl_->state_ == ReconstructionState::Complete ||
         impl_->state_ == ReconstructionState::Timeout ||
         impl_->state_ == ReconstructionState::Failed) {
-        return false;
+        return ChunkOutcome::Rejected;
     }
     
-    // Добавляем чанк
-    bool added = impl_->fec_decoder_.add_chunk(chunk_id, is_fec, data);
+    // Копия от другого пира отбрасывается до копирования payload
+    if (impl_->fec_decoder_.has_chunk(chunk_id, is_fec)) {
+        ++impl_->stats_.duplicates;
+        return ChunkOutcome::Duplicate;
+    }
     
-    if (added) {
+    if (impl_->fec_decoder_.add_chunk(chunk_id, is_fec, data)) {
         if (is_fec) {
             ++impl_->stats_.fec_chunks_received;
         } else {
@@ -190,12 +250,13 @@ bool BlockReconstructor::on_chunk(uint16_t chunk_id, bool is_fec, ByteSpan data)
         impl_->try_extract_header();
         
         // Пытаемся декодировать полный блок
-        impl_->try_decode_block();
-    } else {
-        ++impl_->stats_.duplicates;
+        if (!impl_->deferred_decode_) {
+            impl_->try_decode_block();
+        }
+        return ChunkOutcome::Accepted;
     }
     
-    return added;
+    return ChunkOutcome::Rejected;
 }
 
 void BlockReconstructor::set_header_callback(HeaderCallback callback) {
@@ -213,6 +274,11 @@ void BlockReconstructor::set_timeout_callback(TimeoutCallback callback) {
     impl_->timeout_callback_ = std::move(callback);
 }
 
+void BlockReconstructor::set_deferred_decode(bool deferred) {
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    impl_->deferred_decode_ = deferred;
+}
+
 ReconstructionState BlockReconstructor::state() const {
     std::lock_guard<std::mutex> lock(impl_->mutex_);
     return impl_->state_;
@@ -235,12 +301,7 @@ bool BlockReconstructor::is_timed_out() const {
         return true;
     }
     
-    auto now = std::chrono::steady_clock::now();
-    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
-        now - impl_->stats_.start_time
-    ).count();
-    
-    return static_cast<uint32_t>(elapsed) >= impl_->timeout_ms_;
+    return impl_->stats_.elapsed_ms() >= impl_->timeout_ms_;
 }
 
 bool BlockReconstructor::can_try_decode() const {
@@ -275,12 +336,7 @@ void BlockReconstructor::check_timeout() {
         return;
     }
     
-    auto now = std::chrono::steady_clock::now();
-    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
-        now - impl_->stats_.start_time
-    ).count();
-    
-    if (static_cast<uint32_t>(elapsed) >= impl_->timeout_ms_) {
+    if (impl_->stats_.elapsed_ms() >= impl_->timeout_ms_) {
         impl_->state_ = ReconstructionState::Timeout;
         
         if (impl_->timeout_callback_) {
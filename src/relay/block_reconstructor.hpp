@@ -16,6 +16,7 @@
 #pragma once
 
 #include "../core/types.hpp"
+#include "../core/clock.hpp"
 #include "../bitcoin/block.hpp"
 #include "fec_decoder.hpp"
 #include "fibre_protocol.hpp"
@@ -51,12 +52,13 @@ using HeaderCallback = std::function<void(
 /**
  * @brief Callback при полной реконструкции блока
  * 
- * @param data Полные данные блока
+ * @param data Полные данные блока: буфер FecDecoder, выровненный по
+ *        странице (действителен до reset реконструктора)
  * @param height Высота блока
  * @param block_hash Хеш блока
  */
 using BlockCallback = std::function<void(
-    const std::vector<uint8_t>& data,
+    ByteSpan data,
     uint32_t height,
     const Hash256& block_hash
 )>;
@@ -100,18 +102,32 @@ enum class ReconstructionState {
     Failed
 };
 
+/**
+ * @brief Исход приёма одного чанка
+ */
+enum class ChunkOutcome : uint8_t {
+    /// @brief Новый чанк сохранён
+    Accepted,
+    
+    /// @brief Чанк уже получен - отброшен без копирования (O(1) по битовой карте)
+    Duplicate,
+    
+    /// @brief Чужой блок, другие параметры FEC, блок уже собран или таймаут
+    Rejected
+};
+
 /**
  * @brief Статистика реконструкции
  */
 struct ReconstructionStats {
-    /// @brief Время начала реконструкции
-    std::chrono::steady_clock::time_point start_time;
+    /// @brief Начало реконструкции (метка TscClock)
+    uint64_t start_ticks{0};
     
-    /// @brief Время получения header
-    std::chrono::steady_clock::time_point header_time;
+    /// @brief Получение header (метка TscClock, 0 - ещё нет)
+    uint64_t header_ticks{0};
     
-    /// @brief Время завершения
-    std::chrono::steady_clock::time_point complete_time;
+    /// @brief Завершение (метка TscClock, 0 - ещё нет)
+    uint64_t complete_ticks{0};
     
     /// @brief Количество полученных data чанков
     std::size_t data_chunks_received{0};
@@ -129,16 +145,23 @@ struct ReconstructionStats {
      * @brief Время до получения header (мс)
      */
     [[nodiscard]] double header_latency_ms() const {
-        if (header_time.time_since_epoch().count() == 0) return -1.0;
-        return std::chrono::duration<double, std::milli>(header_time - start_time).count();
+        if (header_ticks == 0) return -1.0;
+        return static_cast<double>(core::TscClock::to_ns(header_ticks - start_ticks)) / 1e6;
     }
     
     /**
      * @brief Время полной реконструкции (мс)
      */
     [[nodiscard]] double total_latency_ms() const {
-        if (complete_time.time_since_epoch().count() == 0) return -1.0;
-        return std::chrono::duration<double, std::milli>(complete_time - start_time).count();
+        if (complete_ticks == 0) return -1.0;
+        return static_cast<double>(core::TscClock::to_ns(complete_ticks - start_ticks)) / 1e6;
+    }
+    
+    /**
+     * @brief Миллисекунд с начала реконструкции
+     */
+    [[nodiscard]] uint64_t elapsed_ms() const noexcept {
+        return core::TscClock::elapsed_ns(start_ticks) / 1'000'000;
     }
 };
 
@@ -184,6 +207,25 @@ public:
     BlockReconstructor(BlockReconstructor&&) noexcept;
     BlockReconstructor& operator=(BlockReconstructor&&) noexcept;
     
+    /**
+     * @brief Переиспользовать реконструктор для другого блока
+     * 
+     * Сбрасывает состояние, статистику и header; callbacks сохраняются.
+     * Арена чанков FecDecoder и буфер собранного блока не освобождаются,
+     * поэтому блок не больше предыдущего собирается без выделения памяти.
+     * 
+     * @param block_hash Хеш нового блока
+     * @param height Высота блока
+     * @param fec_params Параметры FEC
+     * @param timeout_ms Таймаут реконструкции в миллисекундах
+     */
+    void reset(
+        const Hash256& block_hash,
+        uint32_t height,
+        const FecParams& fec_params,
+        uint32_t timeout_ms
+    );
+    
     // =========================================================================
     // Получение чанков
     // =========================================================================
@@ -196,6 +238,31 @@ public:
      */
     bool on_packet(const FibrePacket& packet);
     
+    /**
+     * @brief Обработать FIBRE пакет без копии payload
+     * 
+     * payload копируется в арену FecDecoder (единственная копия от
+     * буфера приёма).
+     * 
+     * @param packet Пакет с payload в буфере приёма
+     * @return true если пакет был обработан
+     */
+    bool on_packet(const FibrePacketView& packet);
+    
+    /**
+     * @brief Принять FIBRE пакет от любого из пиров
+     * 
+     * Чанки всех пиров блока сливаются в одну битовую карту FecDecoder:
+     * побеждает пришедший первым, копии от остальных - Duplicate.
+     * Пакет с другим числом data / FEC чанков, чем у первого пакета
+     * блока (иначе нарезанный блок), отклоняется - его чанки не
+     * совместимы с уже полученными.
+     * 
+     * @param packet Пакет с payload в буфере приёма
+     * @return Исход приёма
+     */
+    [[nodiscard]] ChunkOutcome accept(const FibrePacketView& packet);
+    
     /**
      * @brief Обработать чанк напрямую
      * 
@@ -231,6 +298,18 @@ public:
      */
     void set_timeout_callback(TimeoutCallback callback);
     
+    /**
+     * @brief Отложенное декодирование
+     * 
+     * Чанк, после которого блок можно декодировать, не запускает
+     * FecDecoder::decode в потоке приёма: владелец проверяет
+     * can_try_decode() и вызывает try_complete() в потоке декодирования.
+     * Сохраняется при reset, как и callbacks.
+     * 
+     * @param deferred true - decode только из try_complete()
+     */
+    void set_deferred_decode(bool deferred);
+    
     // =========================================================================
     // Статус
     // =========================================================================
@@ -296,6 +375,8 @@ public:
     bool try_complete();
     
 private:
+    [[nodiscard]] ChunkOutcome add_chunk(uint16_t chunk_id, bool is_fec, ByteSpan data);
+    
     struct Impl;
     std::unique_ptr<Impl> impl_;
 };
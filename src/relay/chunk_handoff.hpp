@@ -0,0 +1,165 @@
+/**
+ * @file chunk_handoff.hpp
+ * @brief Передача чанков потоку приёма, владеющему блоком
+ *
+ * В режиме нескольких потоков приёма (`relay.receive_threads`) пиры
+ * распределены по потокам, а каждый блок реконструирует один поток -
+ * владелец по хешу блока. Чанк чужого блока копируется в ячейку очереди
+ * владельца (bounded queue Дмитрия Вьюкова, как mining::ShareQueue):
+ * - Производители (другие потоки приёма) занимают ячейку одним CAS
+ * - Потребитель один - владелец, он забирает ячейки без CAS
+ *
+ * Ячейка вмещает чанк целиком (заголовок и payload до
+ * FIBRE_MAX_PAYLOAD_SIZE), поэтому передача не выделяет память, а
+ * payload не зависит от slab сокета, в который его принял производитель.
+ */
+
+#pragma once
+
+#include "fibre_protocol.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+
+namespace quaxis::relay {
+
+class RelayPeer;
+
+/**
+ * @brief Чанк, переданный владельцу блока
+ */
+struct ChunkHandoff {
+    /// @brief Заголовок FIBRE пакета
+    FibreHeader header;
+
+    /// @brief Пир-источник (счётчики гонки и ранг доставки)
+    RelayPeer* source{nullptr};
+
+    /// @brief Пакет от trusted пира
+    bool trusted{false};
+
+    /// @brief Момент приёма (ранг считается по нему, а не по выемке)
+    std::chrono::steady_clock::time_point received_at;
+
+    /// @brief Payload (header.payload_size байт)
+    std::array<uint8_t, FIBRE_MAX_PAYLOAD_SIZE> payload;
+
+    /**
+     * @brief Представление пакета (действительно, пока жива ячейка)
+     */
+    [[nodiscard]] FibrePacketView view() const noexcept {
+        return {header, ByteSpan(payload.data(), header.payload_size)};
+    }
+};
+
+/**
+ * @brief Очередь чанков владельца: много производителей, один потребитель
+ */
+class ChunkHandoffQueue {
+public:
+    static_assert(std::is_trivially_copyable_v<ChunkHandoff>,
+                  "ChunkHandoff копируется в ячейку без синхронизации полей");
+
+    /**
+     * @brief Создать очередь
+     *
+     * @param capacity Ёмкость (округляется вверх до степени двойки, минимум 2)
+     */
+    explicit ChunkHandoffQueue(std::size_t capacity)
+        : mask_(std::bit_ceil(capacity < 2 ? std::size_t{2} : capacity) - 1)
+        , cells_(std::make_unique<Cell[]>(mask_ + 1))
+    {
+        for (std::size_t i = 0; i <= mask_; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ChunkHandoffQueue(const ChunkHandoffQueue&) = delete;
+    ChunkHandoffQueue& operator=(const ChunkHandoffQueue&) = delete;
+
+    /**
+     * @brief Скопировать чанк в очередь
+     *
+     * @return false если очередь заполнена
+     */
+    [[nodiscard]] bool try_push(
+        const FibrePacketView& packet,
+        RelayPeer* source,
+        bool trusted,
+        std::chrono::steady_clock::time_point received_at
+    ) noexcept {
+        std::size_t pos = tail_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells_[pos & mask_];
+            std::size_t seq = cell.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+            if (diff == 0) {
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    ChunkHandoff& item = cell.item;
+                    item.header = packet.header;
+                    item.header.payload_size = static_cast<uint16_t>(
+                        std::min(packet.payload.size(), item.payload.size()));
+                    item.source = source;
+                    item.trusted = trusted;
+                    item.received_at = received_at;
+                    std::memcpy(item.payload.data(), packet.payload.data(), item.header.payload_size);
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;  // Ячейка ещё не освобождена владельцем
+            } else {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Обработать чанки, накопившиеся в очереди (только владелец)
+     *
+     * @param fn Вызывается для каждого чанка; ячейка освобождается после
+     * @return Количество обработанных чанков
+     */
+    template<typename Fn>
+    std::size_t drain(Fn&& fn) {
+        std::size_t count = 0;
+        for (;;) {
+            Cell& cell = cells_[head_ & mask_];
+            if (cell.sequence.load(std::memory_order_acquire) != head_ + 1) {
+                return count;  // Пусто или производитель ещё пишет ячейку
+            }
+            fn(static_cast<const ChunkHandoff&>(cell.item));
+            cell.sequence.store(head_ + mask_ + 1, std::memory_order_release);
+            ++head_;
+            ++count;
+        }
+    }
+
+    /**
+     * @brief Ёмкость очереди
+     */
+    [[nodiscard]] std::size_t capacity() const noexcept { return mask_ + 1; }
+
+private:
+    struct Cell {
+        std::atomic<std::size_t> sequence{0};
+        ChunkHandoff item;
+    };
+
+    std::size_t mask_;
+    std::unique_ptr<Cell[]> cells_;
+
+    // Производители и владелец пишут в разные строки кеша
+    alignas(64) std::atomic<std::size_t> tail_{0};
+    alignas(64) std::size_t head_{0};
+};
+
+} // namespace quaxis::relay
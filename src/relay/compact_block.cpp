@@ -0,0 +1,319 @@
+/**
+ * @file compact_block.cpp
+ * @brief Реализация наброска блока и синтеза чанков из TxCache
+ */
+
+#include "compact_block.hpp"
+#include "../crypto/sha256.hpp"
+#include "../crypto/siphash.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace quaxis::relay {
+
+namespace {
+
+/// @brief Little-endian запись / чтение width байт
+void put_le(std::vector<uint8_t>& out, uint64_t value, std::size_t width) {
+    for (std::size_t i = 0; i < width; ++i) {
+        out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+}
+
+[[nodiscard]] uint64_t get_le(const uint8_t* data, std::size_t width) noexcept {
+    uint64_t value = 0;
+    for (std::size_t i = 0; i < width; ++i) {
+        value |= static_cast<uint64_t>(data[i]) << (8 * i);
+    }
+    return value;
+}
+
+/// @brief Длина CompactSize числа транзакций
+[[nodiscard]] std::size_t compact_size_length(uint64_t value) noexcept {
+    return value < 0xFD ? 1 : value <= 0xFFFF ? 3 : value <= 0xFFFFFFFF ? 5 : 9;
+}
+
+/// @brief CompactSize числа транзакций
+void put_compact_size(std::vector<uint8_t>& out, uint64_t value) {
+    if (value < 0xFD) {
+        out.push_back(static_cast<uint8_t>(value));
+    } else if (value <= 0xFFFF) {
+        out.push_back(0xFD);
+        put_le(out, value, 2);
+    } else if (value <= 0xFFFFFFFF) {
+        out.push_back(0xFE);
+        put_le(out, value, 4);
+    } else {
+        out.push_back(0xFF);
+        put_le(out, value, 8);
+    }
+}
+
+} // anonymous namespace
+
+// =============================================================================
+// Short id
+// =============================================================================
+
+ShortIdKey short_id_key(const bitcoin::BlockHeader& header, uint64_t nonce) noexcept {
+    std::array<uint8_t, constants::BLOCK_HEADER_SIZE + 8> preimage{};
+    const auto serialized = header.serialize();
+    std::memcpy(preimage.data(), serialized.data(), serialized.size());
+    for (std::size_t i = 0; i < 8; ++i) {
+        preimage[serialized.size() + i] = static_cast<uint8_t>(nonce >> (8 * i));
+    }
+    const Hash256 digest = crypto::sha256(preimage);
+    return {get_le(digest.data(), 8), get_le(digest.data() + 8, 8)};
+}
+
+uint64_t short_id(const ShortIdKey& key, const Hash256& wtxid) noexcept {
+    return crypto::siphash24(key.k0, key.k1, wtxid) & 0xFFFF'FFFF'FFFFULL;
+}
+
+// =============================================================================
+// BlockSketch
+// =============================================================================
+
+std::size_t BlockSketch::block_size() const noexcept {
+    std::size_t size = constants::BLOCK_HEADER_SIZE + compact_size_length(txs.size());
+    for (const auto& tx : txs) {
+        size += tx.size;
+    }
+    return size;
+}
+
+std::size_t BlockSketch::data_chunk_count() const noexcept {
+    if (chunk_size == 0) {
+        return 0;
+    }
+    return (block_size() + chunk_size - 1) / chunk_size;
+}
+
+Result<BlockSketch> make_block_sketch(ByteSpan block, uint64_t nonce, uint16_t chunk_size) {
+    auto header = bitcoin::BlockHeader::deserialize(block);
+    if (!header) {
+        return std::unexpected(header.error());
+    }
+    auto transactions = bitcoin::block_transactions(block);
+    if (!transactions) {
+        return std::unexpected(transactions.error());
+    }
+    if (transactions->size() > MAX_SKETCH_TXS || chunk_size == 0) {
+        return Err<BlockSketch>(ErrorCode::NetworkSendFailed, "Блок не помещается в набросок FIBRE");
+    }
+
+    BlockSketch sketch;
+    sketch.header = *header;
+    sketch.nonce = nonce;
+    sketch.chunk_size = chunk_size;
+    sketch.txs.reserve(transactions->size());
+
+    const ShortIdKey key = short_id_key(sketch.header, nonce);
+    for (const ByteSpan tx : *transactions) {
+        if (tx.size() > MAX_SKETCH_TX_SIZE) {
+            return Err<BlockSketch>(ErrorCode::NetworkSendFailed, "Транзакция больше лимита наброска FIBRE");
+        }
+        sketch.txs.push_back({short_id(key, crypto::sha256d(tx)), static_cast<uint32_t>(tx.size())});
+    }
+    return sketch;
+}
+
+std::vector<std::vector<uint8_t>> serialize_sketch(const BlockSketch& sketch, std::size_t max_payload) {
+    const std::size_t first_room = max_payload > SKETCH_PART_HEADER_SIZE + SKETCH_BLOCK_INFO_SIZE
+        ? (max_payload - SKETCH_PART_HEADER_SIZE - SKETCH_BLOCK_INFO_SIZE) / SKETCH_ENTRY_SIZE
+        : 0;
+    const std::size_t room = max_payload > SKETCH_PART_HEADER_SIZE
+        ? (max_payload - SKETCH_PART_HEADER_SIZE) / SKETCH_ENTRY_SIZE
+        : 0;
+    if (room == 0 || sketch.txs.size() > MAX_SKETCH_TXS) {
+        return {};
+    }
+
+    const std::size_t rest = sketch.txs.size() > first_room ? sketch.txs.size() - first_room : 0;
+    const std::size_t part_count = 1 + (rest + room - 1) / room;
+    if (part_count > MAX_SKETCH_PARTS) {
+        return {};
+    }
+
+    std::vector<std::vector<uint8_t>> parts;
+    parts.reserve(part_count);
+    std::size_t next_tx = 0;
+    for (std::size_t part = 0; part < part_count; ++part) {
+        const std::size_t entries = std::min(part == 0 ? first_room : room, sketch.txs.size() - next_tx);
+
+        std::vector<uint8_t> payload;
+        payload.reserve(SKETCH_PART_HEADER_SIZE + SKETCH_BLOCK_INFO_SIZE + entries * SKETCH_ENTRY_SIZE);
+        put_le(payload, part, 2);
+        put_le(payload, part_count, 2);
+        put_le(payload, next_tx, 4);
+        put_le(payload, entries, 2);
+        if (part == 0) {
+            const auto header = sketch.header.serialize();
+            payload.insert(payload.end(), header.begin(), header.end());
+            put_le(payload, sketch.nonce, 8);
+            put_le(payload, sketch.chunk_size, 2);
+            put_le(payload, sketch.txs.size(), 4);
+        }
+        for (std::size_t i = 0; i < entries; ++i) {
+            const SketchTx& tx = sketch.txs[next_tx + i];
+            put_le(payload, tx.short_id, SHORT_ID_SIZE);
+            put_le(payload, tx.size, 3);
+        }
+        next_tx += entries;
+        parts.push_back(std::move(payload));
+    }
+    return parts;
+}
+
+// =============================================================================
+// SketchAssembler
+// =============================================================================
+
+void SketchAssembler::reset() noexcept {
+    sketch_.txs.clear();
+    parts_.clear();
+    part_count_ = 0;
+    parts_received_ = 0;
+    entries_received_ = 0;
+    tx_count_ = 0;
+    has_info_ = false;
+    complete_ = false;
+}
+
+ChunkOutcome SketchAssembler::add_part(ByteSpan payload) {
+    if (payload.size() < SKETCH_PART_HEADER_SIZE) {
+        return ChunkOutcome::Rejected;
+    }
+    const auto part_index = static_cast<uint16_t>(get_le(payload.data(), 2));
+    const auto part_count = static_cast<uint16_t>(get_le(payload.data() + 2, 2));
+    const auto first_tx = static_cast<std::size_t>(get_le(payload.data() + 4, 4));
+    const auto entries = static_cast<std::size_t>(get_le(payload.data() + 8, 2));
+
+    if (part_count == 0 || part_count > MAX_SKETCH_PARTS || part_index >= part_count ||
+        (part_count_ != 0 && part_count != part_count_)) {
+        return ChunkOutcome::Rejected;
+    }
+    const std::size_t info_size = part_index == 0 ? SKETCH_BLOCK_INFO_SIZE : 0;
+    if (payload.size() != SKETCH_PART_HEADER_SIZE + info_size + entries * SKETCH_ENTRY_SIZE ||
+        first_tx + entries > MAX_SKETCH_TXS || (has_info_ && first_tx + entries > tx_count_)) {
+        return ChunkOutcome::Rejected;
+    }
+    if (part_count_ == 0) {
+        part_count_ = part_count;
+        parts_.assign(part_count, false);
+    }
+    if (parts_[part_index]) {
+        return ChunkOutcome::Duplicate;
+    }
+
+    const uint8_t* cursor = payload.data() + SKETCH_PART_HEADER_SIZE;
+    if (part_index == 0) {
+        auto header = bitcoin::BlockHeader::deserialize(ByteSpan(cursor, constants::BLOCK_HEADER_SIZE));
+        const auto tx_count = static_cast<std::size_t>(get_le(cursor + 90, 4));
+        if (!header || tx_count == 0 || tx_count > MAX_SKETCH_TXS ||
+            sketch_.txs.size() > tx_count || first_tx + entries > tx_count) {
+            return ChunkOutcome::Rejected;
+        }
+        sketch_.header = *header;
+        sketch_.nonce = get_le(cursor + 80, 8);
+        sketch_.chunk_size = static_cast<uint16_t>(get_le(cursor + 88, 2));
+        tx_count_ = tx_count;
+        has_info_ = true;
+        cursor += SKETCH_BLOCK_INFO_SIZE;
+    }
+
+    if (sketch_.txs.size() < first_tx + entries) {
+        sketch_.txs.resize(first_tx + entries);
+    }
+    for (std::size_t i = 0; i < entries; ++i, cursor += SKETCH_ENTRY_SIZE) {
+        sketch_.txs[first_tx + i] = {get_le(cursor, SHORT_ID_SIZE),
+                                     static_cast<uint32_t>(get_le(cursor + SHORT_ID_SIZE, 3))};
+    }
+    parts_[part_index] = true;
+    ++parts_received_;
+    entries_received_ += entries;
+
+    if (has_info_ && parts_received_ == part_count_) {
+        // Части не пересекаются только у честного отправителя
+        complete_ = entries_received_ == tx_count_ && sketch_.txs.size() == tx_count_ &&
+                    sketch_.chunk_size != 0;
+        if (!complete_) {
+            return ChunkOutcome::Rejected;
+        }
+    }
+    return ChunkOutcome::Accepted;
+}
+
+// =============================================================================
+// Синтез чанков
+// =============================================================================
+
+std::size_t synthesize_chunks(
+    const BlockSketch& sketch,
+    std::span<const ByteSpan> txs,
+    const SynthesizedChunkCallback& callback
+) {
+    if (sketch.chunk_size == 0 || sketch.txs.empty()) {
+        return 0;
+    }
+
+    // Префикс (заголовок и число транзакций) и начало каждой транзакции
+    std::vector<uint8_t> prefix;
+    const auto header = sketch.header.serialize();
+    prefix.assign(header.begin(), header.end());
+    put_compact_size(prefix, sketch.txs.size());
+
+    std::vector<std::size_t> offsets(sketch.txs.size() + 1);
+    offsets[0] = prefix.size();
+    for (std::size_t i = 0; i < sketch.txs.size(); ++i) {
+        offsets[i + 1] = offsets[i] + sketch.txs[i].size;
+    }
+    const std::size_t total = offsets.back();
+    const std::size_t chunk_size = sketch.chunk_size;
+    const std::size_t chunks = (total + chunk_size - 1) / chunk_size;
+
+    auto known = [&](std::size_t i) {
+        return i < txs.size() && txs[i].size() == sketch.txs[i].size && !txs[i].empty();
+    };
+
+    std::vector<uint8_t> chunk(chunk_size);
+    std::size_t synthesized = 0;
+    std::size_t tx = 0;
+    for (std::size_t c = 0; c < chunks; ++c) {
+        const std::size_t begin = c * chunk_size;
+        const std::size_t end = std::min(total, begin + chunk_size);
+
+        // Первая транзакция, пересекающая чанк
+        while (tx < sketch.txs.size() && offsets[tx + 1] <= begin) {
+            ++tx;
+        }
+
+        bool covered = true;
+        for (std::size_t i = tx; i < sketch.txs.size() && offsets[i] < end; ++i) {
+            if (!known(i)) {
+                covered = false;
+                break;
+            }
+        }
+        if (!covered) {
+            continue;
+        }
+
+        if (begin < prefix.size()) {
+            const std::size_t n = std::min(end, prefix.size()) - begin;
+            std::memcpy(chunk.data(), prefix.data() + begin, n);
+        }
+        for (std::size_t i = tx; i < sketch.txs.size() && offsets[i] < end; ++i) {
+            const std::size_t from = std::max(begin, offsets[i]);
+            const std::size_t to = std::min(end, offsets[i + 1]);
+            std::memcpy(chunk.data() + (from - begin), txs[i].data() + (from - offsets[i]), to - from);
+        }
+        callback(static_cast<uint16_t>(c), ByteSpan(chunk.data(), end - begin));
+        ++synthesized;
+    }
+    return synthesized;
+}
+
+} // namespace quaxis::relay
@@ -0,0 +1,221 @@
+/**
+ * @file compact_block.hpp
+ * @brief Компактное описание блока для FIBRE (short id в духе BIP152)
+ *
+ * Без него приёмнику нужно около data_chunk_count чанков по сети, даже
+ * если почти все транзакции блока уже лежат у него в TxCache (mempool
+ * узла). Отправитель перед чанками шлёт набросок (пакеты с флагом
+ * Sketch): заголовок, nonce и для каждой транзакции 6-байтный short id
+ * и размер. Размеры дают раскладку сериализованного блока, short id -
+ * транзакции из кеша; data чанки, целиком покрытые известными байтами,
+ * приёмник синтезирует сам, а FEC досылает только остальное.
+ *
+ * Short id (BIP152): SipHash-2-4 от wtxid с ключом из первых 16 байт
+ * SHA256(заголовок || nonce), младшие 48 бит. Nonce случаен на каждый
+ * блок - подобрать коллизию заранее нельзя; случайную коллизию ловит
+ * проверка merkle root собранного блока.
+ *
+ * Формат части наброска (все числа little-endian):
+ * - part_index (2), part_count (2), first_tx (4), entries (2)
+ * - только в части 0: заголовок (80), nonce (8), chunk_size (2),
+ *   tx_count (4)
+ * - entries записей: short id (6), размер транзакции (3)
+ */
+
+#pragma once
+
+#include "../core/types.hpp"
+#include "../bitcoin/block.hpp"
+#include "block_reconstructor.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <vector>
+
+namespace quaxis::relay {
+
+// =============================================================================
+// Константы
+// =============================================================================
+
+/// @brief Байт short id
+inline constexpr std::size_t SHORT_ID_SIZE = 6;
+
+/// @brief Запись транзакции в наброске: short id и 3 байта размера
+inline constexpr std::size_t SKETCH_ENTRY_SIZE = SHORT_ID_SIZE + 3;
+
+/// @brief Заголовок каждой части наброска
+inline constexpr std::size_t SKETCH_PART_HEADER_SIZE = 10;
+
+/// @brief Описание блока в части 0: заголовок, nonce, chunk_size, tx_count
+inline constexpr std::size_t SKETCH_BLOCK_INFO_SIZE = 94;
+
+/// @brief Наибольшее число транзакций в наброске (4 МБ / 60 байт)
+inline constexpr std::size_t MAX_SKETCH_TXS = 70'000;
+
+/// @brief Наибольшее число частей наброска
+inline constexpr std::size_t MAX_SKETCH_PARTS = 1024;
+
+/// @brief Наибольший размер транзакции в наброске (3 байта)
+inline constexpr uint32_t MAX_SKETCH_TX_SIZE = 0xFFFFFF;
+
+// =============================================================================
+// Short id
+// =============================================================================
+
+/**
+ * @brief Ключ SipHash short id блока
+ */
+struct ShortIdKey {
+    uint64_t k0{0};
+    uint64_t k1{0};
+};
+
+/**
+ * @brief Ключ short id: первые 16 байт SHA256(заголовок || nonce)
+ */
+[[nodiscard]] ShortIdKey short_id_key(const bitcoin::BlockHeader& header, uint64_t nonce) noexcept;
+
+/**
+ * @brief Short id транзакции (младшие 48 бит SipHash-2-4 от wtxid)
+ */
+[[nodiscard]] uint64_t short_id(const ShortIdKey& key, const Hash256& wtxid) noexcept;
+
+// =============================================================================
+// Набросок блока
+// =============================================================================
+
+/**
+ * @brief Транзакция наброска
+ */
+struct SketchTx {
+    /// @brief Short id (48 бит)
+    uint64_t short_id{0};
+
+    /// @brief Размер сериализации с witness
+    uint32_t size{0};
+};
+
+/**
+ * @brief Набросок блока: всё, чтобы разложить блок по чанкам
+ */
+struct BlockSketch {
+    /// @brief Заголовок блока (его хеш - хеш блока FIBRE)
+    bitcoin::BlockHeader header;
+
+    /// @brief Nonce ключа short id
+    uint64_t nonce{0};
+
+    /// @brief Размер data чанка отправителя (последний короче)
+    uint16_t chunk_size{0};
+
+    /// @brief Транзакции в порядке блока (0 - coinbase)
+    std::vector<SketchTx> txs;
+
+    /**
+     * @brief Размер сериализованного блока
+     */
+    [[nodiscard]] std::size_t block_size() const noexcept;
+
+    /**
+     * @brief Число data чанков блока
+     */
+    [[nodiscard]] std::size_t data_chunk_count() const noexcept;
+};
+
+/**
+ * @brief Набросок сериализованного блока
+ *
+ * @param block Сериализованный блок
+ * @param nonce Nonce ключа short id (случайный на блок)
+ * @param chunk_size Размер data чанка
+ * @return Набросок или ошибку разбора / лимитов наброска
+ */
+[[nodiscard]] Result<BlockSketch> make_block_sketch(ByteSpan block, uint64_t nonce, uint16_t chunk_size);
+
+/**
+ * @brief Разрезать набросок на payload пакетов
+ *
+ * @param sketch Набросок
+ * @param max_payload Наибольший payload пакета
+ * @return Части по порядку (пусто - набросок не помещается в лимиты)
+ */
+[[nodiscard]] std::vector<std::vector<uint8_t>> serialize_sketch(
+    const BlockSketch& sketch,
+    std::size_t max_payload
+);
+
+/**
+ * @brief Сборка наброска из частей (в любом порядке)
+ *
+ * Буфер транзакций переживает reset: запись пула не выделяет память на
+ * каждый блок.
+ */
+class SketchAssembler {
+public:
+    /**
+     * @brief Начать новый набросок
+     */
+    void reset() noexcept;
+
+    /**
+     * @brief Добавить часть
+     *
+     * @param payload Payload пакета Sketch
+     * @return Accepted, Duplicate (часть уже есть) или Rejected (формат)
+     */
+    ChunkOutcome add_part(ByteSpan payload);
+
+    /**
+     * @brief Все части получены
+     */
+    [[nodiscard]] bool complete() const noexcept { return complete_; }
+
+    /**
+     * @brief Собранный набросок (после complete())
+     */
+    [[nodiscard]] const BlockSketch& sketch() const noexcept { return sketch_; }
+
+private:
+    BlockSketch sketch_;
+    std::vector<bool> parts_;
+    uint16_t part_count_{0};
+    std::size_t parts_received_{0};
+    std::size_t entries_received_{0};
+    std::size_t tx_count_{0};
+    bool has_info_{false};
+    bool complete_{false};
+};
+
+// =============================================================================
+// Синтез чанков
+// =============================================================================
+
+/**
+ * @brief Получатель синтезированного data чанка
+ *
+ * @param chunk_id Номер data чанка
+ * @param data Чанк (действителен только внутри вызова)
+ */
+using SynthesizedChunkCallback = std::function<void(uint16_t chunk_id, ByteSpan data)>;
+
+/**
+ * @brief Синтезировать data чанки, целиком покрытые известными байтами
+ *
+ * Заголовок и число транзакций известны всегда; транзакция i - если
+ * txs[i] не пуст и его размер совпал с наброском.
+ *
+ * @param sketch Набросок блока
+ * @param txs Транзакции из кеша по индексу наброска (пустые - неизвестны)
+ * @param callback Вызывается для каждого синтезированного чанка
+ * @return Число синтезированных чанков
+ */
+std::size_t synthesize_chunks(
+    const BlockSketch& sketch,
+    std::span<const ByteSpan> txs,
+    const SynthesizedChunkCallback& callback
+);
+
+} // namespace quaxis::relay
@@ -0,0 +1,131 @@
+/**
+ * @file decode_pipeline.hpp
+ * @brief Конвейер приём -> FEC декодирование (`relay.decode_thread`)
+ *
+ * FecDecoder::decode блока с потерями - сотни микросекунд решения
+ * системы над GF(2^8); в потоке приёма за это время сокеты пиров
+ * переполняются чанками других блоков. С потоком декодирования поток
+ * приёма, приняв чанк, после которого блок можно декодировать
+ * (can_try_decode), кладёт задачу в своё SPSC кольцо и идёт дальше.
+ * Поток декодирования собирает блок (try_complete) и возвращает исход
+ * во второе кольцо - владелец освобождает запись пула у себя.
+ *
+ * Кольца - по паре на поток приёма: у каждого ровно один писатель и
+ * один читатель, поэтому хватает двух счётчиков без CAS.
+ */
+
+#pragma once
+
+#include "../core/types.hpp"
+
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+namespace quaxis::relay {
+
+class RelayPeer;
+struct InflightBlock;
+
+/**
+ * @brief Задача потоку декодирования
+ */
+struct DecodeTask {
+    /// @brief Запись пула (владелец не трогает её до DecodeOutcome)
+    InflightBlock* entry{nullptr};
+
+    /// @brief Хеш блока
+    Hash256 block_hash{};
+
+    /// @brief Пир, чанк которого сделал блок декодируемым
+    RelayPeer* source{nullptr};
+};
+
+/**
+ * @brief Исход декодирования для владельца записи
+ */
+struct DecodeOutcome {
+    /// @brief Запись пула
+    InflightBlock* entry{nullptr};
+
+    /// @brief Хеш блока
+    Hash256 block_hash{};
+
+    /// @brief Пир, чанк которого сделал блок декодируемым
+    RelayPeer* source{nullptr};
+
+    /// @brief Блок собран (иначе decode не удался)
+    bool complete{false};
+};
+
+/**
+ * @brief Кольцо один писатель - один читатель фиксированной ёмкости
+ */
+template<typename T>
+class SpscRing {
+public:
+    static_assert(std::is_trivially_copyable_v<T>, "Элемент кольца копируется без синхронизации полей");
+
+    /**
+     * @brief Создать кольцо
+     *
+     * @param capacity Ёмкость (округляется вверх до степени двойки, минимум 2)
+     */
+    explicit SpscRing(std::size_t capacity)
+        : mask_(std::bit_ceil(capacity < 2 ? std::size_t{2} : capacity) - 1)
+        , items_(std::make_unique<T[]>(mask_ + 1))
+    {}
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    /**
+     * @brief Положить элемент (только писатель)
+     *
+     * @return false если кольцо заполнено
+     */
+    [[nodiscard]] bool try_push(const T& item) noexcept {
+        const std::size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_.load(std::memory_order_acquire) > mask_) {
+            return false;
+        }
+        items_[tail & mask_] = item;
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Обработать накопившиеся элементы (только читатель)
+     *
+     * @param fn Вызывается для каждого элемента по порядку
+     * @return Количество обработанных элементов
+     */
+    template<typename Fn>
+    std::size_t drain(Fn&& fn) {
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        const std::size_t tail = tail_.load(std::memory_order_acquire);
+        for (std::size_t pos = head; pos != tail; ++pos) {
+            fn(static_cast<const T&>(items_[pos & mask_]));
+        }
+        head_.store(tail, std::memory_order_release);
+        return tail - head;
+    }
+
+    /**
+     * @brief Ёмкость кольца
+     */
+    [[nodiscard]] std::size_t capacity() const noexcept { return mask_ + 1; }
+
+private:
+    std::size_t mask_;
+    std::unique_ptr<T[]> items_;
+
+    // Писатель и читатель пишут в разные строки кеша
+    alignas(64) std::atomic<std::size_t> tail_{0};
+    alignas(64) std::atomic<std::size_t> head_{0};
+};
+
+} // namespace quaxis::relay
@@ -2,15 +2,17 @@
  * @file fec_decoder.cpp
  * @brief Реализация Forward Error Correction (FEC) декодера
  * 
- * Реализует простой XOR-based FEC для восстановления данных при потере пакетов.
- * Для полноценной реализации Reed-Solomon рекомендуется использовать cm256.
+ * Код Коши над GF(2^8) (любые N из N + M чанков) и простой XOR-based FEC.
  */
 
 #include "fec_decoder.hpp"
+#include "gf256.hpp"
+#include "../core/pmu_profile.hpp"
 
 #include <algorithm>
 #include <bitset>
 #include <cstring>
+#include <new>
 #include <stdexcept>
 
 namespace quaxis::relay {
@@ -20,10 +22,7 @@ namespace quaxis::relay {
 // =============================================================================
 
 void xor_bytes(MutableByteSpan dst, ByteSpan src) noexcept {
-    const std::size_t len = std::min(dst.size(), src.size());
-    for (std::size_t i = 0; i < len; ++i) {
-        dst[i] ^= src[i];
-    }
+    gf_xor(dst, src);
 }
 
 std::vector<uint8_t> xor_chunks(
@@ -39,19 +38,180 @@ std::vector<uint8_t> xor_chunks(
     return result;
 }
 
+uint8_t cauchy_coefficient(
+    uint16_t data_chunk_count,
+    uint16_t fec_index,
+    uint16_t data_index
+) noexcept {
+    const auto n = static_cast<uint8_t>(data_chunk_count);
+    const auto x = static_cast<uint8_t>(data_chunk_count + fec_index);
+    const auto y = static_cast<uint8_t>(data_index);
+    return gf_div(static_cast<uint8_t>(y ^ n), static_cast<uint8_t>(x ^ y));
+}
+
+Result<std::vector<std::vector<uint8_t>>> encode_fec_chunks(
+    const FecParams& params,
+    const std::vector<ByteSpan>& data_chunks
+) {
+    if (data_chunks.empty() || data_chunks.size() != params.data_chunk_count) {
+        return std::unexpected(Error{
+            ErrorCode::CryptoInvalidLength,
+            "Количество data чанков не совпадает с FecParams"
+        });
+    }
+    if (params.scheme == FecScheme::CauchyReedSolomon &&
+        params.total_chunks() > MAX_CAUCHY_CHUNKS) {
+        return std::unexpected(Error{
+            ErrorCode::CryptoInvalidLength,
+            "Код Коши: data + FEC чанков больше 256"
+        });
+    }
+    
+    std::size_t length = 0;
+    for (const auto& chunk : data_chunks) {
+        length = std::max(length, chunk.size());
+    }
+    
+    std::vector<std::vector<uint8_t>> parity(params.fec_chunk_count, std::vector<uint8_t>(length, 0));
+    for (uint16_t f = 0; f < params.fec_chunk_count; ++f) {
+        for (uint16_t j = 0; j < params.data_chunk_count; ++j) {
+            const uint8_t coef = params.scheme == FecScheme::Xor
+                ? uint8_t{1}
+                : cauchy_coefficient(params.data_chunk_count, f, j);
+            gf_mul_add(parity[f], data_chunks[j], coef);
+        }
+    }
+    return parity;
+}
+
+namespace {
+
+/**
+ * @brief Обратить матрицу k x k над GF(2^8) (Гаусс-Жордан)
+ *
+ * @return Обратная матрица (построчно) или nullopt если вырождена
+ */
+std::optional<std::vector<uint8_t>> invert_matrix(std::vector<uint8_t> m, std::size_t k) {
+    std::vector<uint8_t> inv(k * k, 0);
+    for (std::size_t i = 0; i < k; ++i) {
+        inv[i * k + i] = 1;
+    }
+    
+    for (std::size_t col = 0; col < k; ++col) {
+        std::size_t pivot = col;
+        while (pivot < k && m[pivot * k + col] == 0) {
+            ++pivot;
+        }
+        if (pivot == k) {
+            return std::nullopt;
+        }
+        if (pivot != col) {
+            for (std::size_t j = 0; j < k; ++j) {
+                std::swap(m[pivot * k + j], m[col * k + j]);
+                std::swap(inv[pivot * k + j], inv[col * k + j]);
+            }
+        }
+        
+        const uint8_t scale = gf_inv(m[col * k + col]);
+        for (std::size_t j = 0; j < k; ++j) {
+            m[col * k + j] = gf_mul(m[col * k + j], scale);
+            inv[col * k + j] = gf_mul(inv[col * k + j], scale);
+        }
+        
+        for (std::size_t row = 0; row < k; ++row) {
+            const uint8_t factor = m[row * k + col];
+            if (row == col || factor == 0) {
+                continue;
+            }
+            for (std::size_t j = 0; j < k; ++j) {
+                m[row * k + j] ^= gf_mul(factor, m[col * k + j]);
+                inv[row * k + j] ^= gf_mul(factor, inv[col * k + j]);
+            }
+        }
+    }
+    return inv;
+}
+
+} // anonymous namespace
+
 // =============================================================================
 // Реализация FecDecoder
 // =============================================================================
 
+namespace {
+
+/// @brief Шаг слота арены: MAX_CHUNK_SIZE, округлённый до кэш-линии
+constexpr std::size_t SLOT_STRIDE = (MAX_CHUNK_SIZE + 63) / 64 * 64;
+
+/// @brief Выравнивание арены (кэш-линия, загрузки AVX2 не пересекают её)
+constexpr std::size_t ARENA_ALIGNMENT = 64;
+
+/**
+ * @brief Освобождение памяти, выделенной ::operator new[] с выравниванием
+ */
+template <std::size_t Alignment>
+struct AlignedDeleter {
+    void operator()(uint8_t* ptr) const noexcept {
+        ::operator delete[](ptr, std::align_val_t{Alignment});
+    }
+};
+
+template <std::size_t Alignment>
+using AlignedBuffer = std::unique_ptr<uint8_t[], AlignedDeleter<Alignment>>;
+
+template <std::size_t Alignment>
+AlignedBuffer<Alignment> allocate_aligned(std::size_t size) {
+    return AlignedBuffer<Alignment>(static_cast<uint8_t*>(
+        ::operator new[](size, std::align_val_t{Alignment})));
+}
+
+} // anonymous namespace
+
 struct FecDecoder::Impl {
     /// @brief Параметры FEC
     FecParams params;
     
-    /// @brief Полученные data чанки (индексированы по chunk_id)
-    std::vector<std::optional<std::vector<uint8_t>>> data_chunks;
+    /**
+     * @brief Буфер блока: data чанк i лежит по смещению i * stride
+     *
+     * add_chunk копирует payload из буфера приёма сразу на его место в
+     * блоке, восстановление пишет потерянные чанки туда же - собранный
+     * блок и есть начало буфера. Выровнен по странице (vmsplice, SHM);
+     * reset() его не освобождает - следующий блок переиспользует его.
+     */
+    AlignedBuffer<BLOCK_BUFFER_ALIGNMENT> block;
+    
+    /// @brief Ёмкость буфера блока в байтах
+    std::size_t block_capacity{0};
+    
+    /// @brief Размер data чанка отправителя (0 - ещё не известен)
+    std::size_t stride{0};
+    
+    /**
+     * @brief Арена FEC чанков и слот последнего data чанка
+     *
+     * Последний data чанк короче остальных: пришедший раньше всех
+     * полноразмерных, он ждёт stride в слоте за FEC слотами.
+     */
+    AlignedBuffer<ARENA_ALIGNMENT> arena;
+    
+    /// @brief Ёмкость арены в слотах
+    std::size_t slot_capacity{0};
+    
+    /// @brief Последний data чанк ждёт stride в арене
+    bool tail_pending{false};
+    
+    /// @brief Число data слотов (min(data_chunk_count, MAX_DATA_CHUNKS))
+    std::size_t data_slots{0};
     
-    /// @brief Полученные FEC чанки (индексированы по chunk_id - data_chunk_count)
-    std::vector<std::optional<std::vector<uint8_t>>> fec_chunks;
+    /// @brief Число FEC слотов (min(fec_chunk_count, MAX_FEC_CHUNKS))
+    std::size_t fec_slots{0};
+    
+    /// @brief Длина чанка в каждом слоте
+    std::vector<uint16_t> lengths;
+    
+    /// @brief Буфер синдромов кода Коши (k * length, переиспользуется)
+    std::vector<uint8_t> scratch;
     
     /// @brief Битовая маска полученных data чанков
     std::bitset<MAX_DATA_CHUNKS> data_received;
@@ -68,25 +228,223 @@ struct FecDecoder::Impl {
     /**
      * @brief Инициализация с параметрами
      */
-    explicit Impl(const FecParams& p) 
-        : params(p)
-        , data_chunks(p.data_chunk_count)
-        , fec_chunks(p.fec_chunk_count)
-    {
-        data_received.reset();
-        fec_received.reset();
+    explicit Impl(const FecParams& p) {
+        reset(p);
     }
     
     /**
-     * @brief Сброс состояния
+     * @brief Место data чанка в буфере блока
      */
-    void reset() {
-        for (auto& chunk : data_chunks) {
-            chunk.reset();
+    [[nodiscard]] uint8_t* data_slot(std::size_t index) const noexcept {
+        return block.get() + index * stride;
+    }
+    
+    /**
+     * @brief Слот FEC чанка в арене
+     */
+    [[nodiscard]] uint8_t* fec_slot(std::size_t index) const noexcept {
+        return arena.get() + index * SLOT_STRIDE;
+    }
+    
+    /**
+     * @brief Слот последнего data чанка до stride (за FEC слотами)
+     */
+    [[nodiscard]] uint8_t* tail_slot() const noexcept {
+        return fec_slot(fec_slots);
+    }
+    
+    /**
+     * @brief Полученный data чанк
+     */
+    [[nodiscard]] ByteSpan data_chunk(std::size_t index) const noexcept {
+        return {data_slot(index), lengths[index]};
+    }
+    
+    /**
+     * @brief Полученный FEC чанк
+     */
+    [[nodiscard]] ByteSpan fec_chunk(std::size_t index) const noexcept {
+        return {fec_slot(index), lengths[data_slots + index]};
+    }
+    
+    /**
+     * @brief Записать data чанк на его место в блоке
+     */
+    void store_data(std::size_t index, ByteSpan data) noexcept {
+        std::memcpy(data_slot(index), data.data(), data.size());
+        lengths[index] = static_cast<uint16_t>(data.size());
+    }
+    
+    /**
+     * @brief Записать FEC чанк в слот арены
+     */
+    void store_fec(std::size_t index, ByteSpan data) noexcept {
+        std::memcpy(fec_slot(index), data.data(), data.size());
+        lengths[data_slots + index] = static_cast<uint16_t>(data.size());
+    }
+    
+    /**
+     * @brief Запомнить размер чанка отправителя
+     *
+     * Отложенный последний чанк переезжает на место; длиннее stride - не
+     * из этого блока и отбрасывается.
+     */
+    void set_stride(std::size_t size) noexcept {
+        stride = size;
+        if (!tail_pending) {
+            return;
+        }
+        tail_pending = false;
+        const std::size_t last = params.data_chunk_count - 1u;
+        if (lengths[last] <= stride) {
+            std::memcpy(data_slot(last), tail_slot(), lengths[last]);
+        } else {
+            lengths[last] = 0;
+            data_received.reset(last);
+            --data_count;
         }
-        for (auto& chunk : fec_chunks) {
-            chunk.reset();
+    }
+    
+    /**
+     * @brief Принять data чанк: все, кроме последнего, длиной ровно stride
+     */
+    bool place_data(uint16_t index, ByteSpan data) noexcept {
+        const bool last = index + 1u == params.data_chunk_count;
+        if (!last) {
+            if (stride == 0) {
+                set_stride(data.size());
+            } else if (data.size() != stride) {
+                return false;
+            }
+        } else if (index != 0 && stride == 0) {
+            std::memcpy(tail_slot(), data.data(), data.size());
+            lengths[index] = static_cast<uint16_t>(data.size());
+            tail_pending = true;
+            return true;
+        } else if (index != 0 && data.size() > stride) {
+            return false;
+        }
+        store_data(index, data);
+        return true;
+    }
+    
+    /**
+     * @brief Принять FEC чанк: длина - самый длинный data чанк, то есть stride
+     */
+    bool place_fec(uint16_t index, ByteSpan data) noexcept {
+        if (stride == 0) {
+            set_stride(data.size());
+        } else if (data.size() != stride) {
+            return false;
+        }
+        store_fec(index, data);
+        return true;
+    }
+    
+    /**
+     * @brief Собранный блок в буфере (все data чанки получены)
+     */
+    [[nodiscard]] ByteSpan block_view() const noexcept {
+        std::size_t total = 0;
+        for (std::size_t i = 0; i < data_slots; ++i) {
+            total += lengths[i];
+        }
+        return {block.get(), total};
+    }
+    
+    /**
+     * @brief Восстановить потерянные data чанки кодом Коши
+     *
+     * Для k потерянных чанков берутся первые k полученных FEC чанков:
+     * из каждого вычитается вклад полученных data чанков (синдром),
+     * затем синдромы умножаются на обратную k x k подматрицу Коши.
+     * Восстановленные чанки имеют длину FEC чанка (с нулевым хвостом).
+     */
+    FastResult<std::size_t> recover_cauchy() {
+        const uint16_t n = params.data_chunk_count;
+        if (params.total_chunks() > MAX_CAUCHY_CHUNKS) {
+            return std::unexpected(FastError{
+                ErrorCode::CryptoInvalidLength,
+                "Код Коши: data + FEC чанков больше 256"
+            });
+        }
+        
+        std::vector<uint16_t> missing;
+        for (uint16_t i = 0; i < n; ++i) {
+            if (!data_received.test(i)) {
+                missing.push_back(i);
+            }
+        }
+        const std::size_t k = missing.size();
+        
+        std::vector<uint16_t> rows;
+        for (uint16_t f = 0; f < fec_slots && rows.size() < k; ++f) {
+            if (fec_received.test(f)) {
+                rows.push_back(f);
+            }
+        }
+        if (rows.size() < k) {
+            return std::unexpected(FastError{
+                ErrorCode::CryptoInvalidLength,
+                "Недостаточно FEC чанков для восстановления"
+            });
+        }
+        
+        std::size_t length = 0;
+        for (uint16_t f : rows) {
+            length = std::max(length, fec_chunk(f).size());
+        }
+        
+        // Синдромы: FEC чанк минус вклад полученных data чанков
+        scratch.assign(k * length, 0);
+        for (std::size_t a = 0; a < k; ++a) {
+            MutableByteSpan syndrome{scratch.data() + a * length, length};
+            const auto fec = fec_chunk(rows[a]);
+            std::memcpy(syndrome.data(), fec.data(), fec.size());
+            for (uint16_t j = 0; j < n; ++j) {
+                if (data_received.test(j)) {
+                    gf_mul_add(syndrome, data_chunk(j), cauchy_coefficient(n, rows[a], j));
+                }
+            }
+        }
+        
+        // Подматрица Коши по потерянным столбцам всегда обратима
+        std::vector<uint8_t> matrix(k * k);
+        for (std::size_t a = 0; a < k; ++a) {
+            for (std::size_t b = 0; b < k; ++b) {
+                matrix[a * k + b] = cauchy_coefficient(n, rows[a], missing[b]);
+            }
+        }
+        auto inverse = invert_matrix(std::move(matrix), k);
+        if (!inverse) {
+            return std::unexpected(FastError{
+                ErrorCode::CryptoInvalidLength,
+                "Вырожденная матрица FEC"
+            });
+        }
+        
+        // Восстановленные чанки пишутся прямо на их место в блоке
+        for (std::size_t b = 0; b < k; ++b) {
+            MutableByteSpan recovered{data_slot(missing[b]), length};
+            std::memset(recovered.data(), 0, length);
+            for (std::size_t a = 0; a < k; ++a) {
+                gf_mul_add(recovered, ByteSpan{scratch.data() + a * length, length},
+                           (*inverse)[b * k + a]);
+            }
+            lengths[missing[b]] = static_cast<uint16_t>(length);
+            data_received.set(missing[b]);
+            ++data_count;
         }
+        return k;
+    }
+    
+    /**
+     * @brief Сброс состояния
+     */
+    void reset() {
+        stride = 0;
+        tail_pending = false;
+        std::fill(lengths.begin(), lengths.end(), uint16_t{0});
         data_received.reset();
         fec_received.reset();
         data_count = 0;
@@ -95,17 +453,28 @@ struct FecDecoder::Impl {
     
     /**
      * @brief Сброс с новыми параметрами
+     *
+     * Буфер блока (под data_chunk_count чанков наибольшего размера) и
+     * арена перевыделяются только если новому блоку их не хватает.
      */
     void reset(const FecParams& p) {
         params = p;
-        data_chunks.clear();
-        data_chunks.resize(p.data_chunk_count);
-        fec_chunks.clear();
-        fec_chunks.resize(p.fec_chunk_count);
-        data_received.reset();
-        fec_received.reset();
-        data_count = 0;
-        fec_count = 0;
+        data_slots = std::min<std::size_t>(p.data_chunk_count, MAX_DATA_CHUNKS);
+        fec_slots = std::min<std::size_t>(p.fec_chunk_count, MAX_FEC_CHUNKS);
+        
+        const std::size_t block_size = (std::max<std::size_t>(data_slots, 1) * MAX_CHUNK_SIZE +
+            BLOCK_BUFFER_ALIGNMENT - 1) / BLOCK_BUFFER_ALIGNMENT * BLOCK_BUFFER_ALIGNMENT;
+        if (block_size > block_capacity) {
+            block = allocate_aligned<BLOCK_BUFFER_ALIGNMENT>(block_size);
+            block_capacity = block_size;
+        }
+        const std::size_t slots = fec_slots + 1;
+        if (slots > slot_capacity) {
+            arena = allocate_aligned<ARENA_ALIGNMENT>(slots * SLOT_STRIDE);
+            slot_capacity = slots;
+        }
+        lengths.assign(data_slots + fec_slots, 0);
+        reset();
     }
 };
 
@@ -127,7 +496,7 @@ bool FecDecoder::add_chunk(uint16_t chunk_id, bool is_fec, ByteSpan data) {
     if (is_fec) {
         // FEC чанк
         const uint16_t fec_idx = chunk_id;
-        if (fec_idx >= impl_->params.fec_chunk_count) {
+        if (fec_idx >= impl_->fec_slots) {
             return false;
         }
         
@@ -135,12 +504,14 @@ bool FecDecoder::add_chunk(uint16_t chunk_id, bool is_fec, ByteSpan data) {
             return false;  // Дубликат
         }
         
-        impl_->fec_chunks[fec_idx] = std::vector<uint8_t>(data.begin(), data.end());
+        if (!impl_->place_fec(fec_idx, data)) {
+            return false;  // Длина не совпала с чанком блока
+        }
         impl_->fec_received.set(fec_idx);
         ++impl_->fec_count;
     } else {
         // Data чанк
-        if (chunk_id >= impl_->params.data_chunk_count) {
+        if (chunk_id >= impl_->data_slots) {
             return false;
         }
         
@@ -148,7 +519,9 @@ bool FecDecoder::add_chunk(uint16_t chunk_id, bool is_fec, ByteSpan data) {
             return false;  // Дубликат
         }
         
-        impl_->data_chunks[chunk_id] = std::vector<uint8_t>(data.begin(), data.end());
+        if (!impl_->place_data(chunk_id, data)) {
+            return false;  // Длина не совпала с чанком блока
+        }
         impl_->data_received.set(chunk_id);
         ++impl_->data_count;
     }
@@ -160,11 +533,16 @@ bool FecDecoder::add_chunk(const FecChunk& chunk) {
     return add_chunk(chunk.chunk_id, chunk.is_fec, chunk.data);
 }
 
+bool FecDecoder::has_chunk(uint16_t chunk_id, bool is_fec) const noexcept {
+    if (is_fec) {
+        return chunk_id < impl_->fec_slots && impl_->fec_received.test(chunk_id);
+    }
+    return chunk_id < impl_->data_slots && impl_->data_received.test(chunk_id);
+}
+
 bool FecDecoder::can_decode() const noexcept {
-    // Для простого XOR FEC: нужны все data чанки или data + fec >= total
-    // Для полноценного Reed-Solomon: нужны любые data_chunk_count чанков
-    
-    // Простая проверка: достаточно ли чанков в сумме
+    // Код Коши: нужны любые data_chunk_count чанков
+    // Для простого XOR FEC проверка оптимистична (decode может не справиться)
     const std::size_t total = impl_->data_count + impl_->fec_count;
     return total >= impl_->params.data_chunk_count;
 }
@@ -189,47 +567,62 @@ const FecParams& FecDecoder::params() const noexcept {
     return impl_->params;
 }
 
-Result<FecDecodeResult> FecDecoder::decode() {
+FastResult<FecDecodeResult> FecDecoder::decode() {
     FecDecodeResult result;
+    auto decoded = decode(result);
+    if (!decoded) {
+        return std::unexpected(decoded.error());
+    }
+    return result;
+}
+
+FastResult<void> FecDecoder::decode(FecDecodeResult& result) {
+    auto block = decode_in_place(result);
+    if (!block) {
+        return std::unexpected(block.error());
+    }
+    result.data.assign(block->begin(), block->end());
+    return {};
+}
+
+FastResult<ByteSpan> FecDecoder::decode_in_place(FecDecodeResult& result) {
+    core::PmuScope pmu(core::PmuRegion::FecDecode, impl_->data_count);
+    result.data_chunks_used = 0;
+    result.fec_chunks_used = 0;
+    result.chunks_recovered = 0;
     
     if (has_all_data_chunks()) {
-        // Все data чанки есть - просто собираем
-        result.data.reserve(
-            static_cast<std::size_t>(impl_->params.data_chunk_count) * 
-            static_cast<std::size_t>(impl_->params.chunk_size)
-        );
-        
-        for (uint16_t i = 0; i < impl_->params.data_chunk_count; ++i) {
-            if (impl_->data_chunks[i]) {
-                result.data.insert(
-                    result.data.end(),
-                    impl_->data_chunks[i]->begin(),
-                    impl_->data_chunks[i]->end()
-                );
-            }
-        }
-        
+        // Все data чанки уже на своих местах в буфере блока
         result.data_chunks_used = impl_->data_count;
-        result.fec_chunks_used = 0;
-        result.chunks_recovered = 0;
-        
-        return result;
+        return impl_->block_view();
     }
     
     if (!can_decode()) {
-        return std::unexpected(Error{
+        return std::unexpected(FastError{
             ErrorCode::CryptoInvalidLength,
             "Недостаточно чанков для декодирования FEC"
         });
     }
     
+    if (impl_->params.scheme == FecScheme::CauchyReedSolomon) {
+        const std::size_t received = impl_->data_count;
+        auto recovered = impl_->recover_cauchy();
+        if (!recovered) {
+            return std::unexpected(recovered.error());
+        }
+        result.data_chunks_used = received;
+        result.fec_chunks_used = *recovered;
+        result.chunks_recovered = *recovered;
+        return impl_->block_view();
+    }
+    
     // Нужно использовать FEC для восстановления
     // Простая XOR реализация: восстанавливаем один потерянный чанк
     // Для полноценной реализации нужна библиотека cm256 или wirehair
     
     // Находим отсутствующие data чанки
     std::vector<uint16_t> missing_chunks;
-    for (uint16_t i = 0; i < impl_->params.data_chunk_count; ++i) {
+    for (uint16_t i = 0; i < impl_->data_slots; ++i) {
         if (!impl_->data_received.test(i)) {
             missing_chunks.push_back(i);
         }
@@ -237,7 +630,7 @@ Result<FecDecodeResult> FecDecoder::decode() {
     
     // Простая XOR реализация работает только для одного потерянного чанка
     if (missing_chunks.size() > 1 && impl_->fec_count < missing_chunks.size()) {
-        return std::unexpected(Error{
+        return std::unexpected(FastError{
             ErrorCode::CryptoInvalidLength,
             "Слишком много потерянных чанков для простого XOR FEC"
         });
@@ -256,96 +649,73 @@ Result<FecDecodeResult> FecDecoder::decode() {
         
         // Находим первый доступный FEC чанк
         std::size_t fec_idx = 0;
-        while (fec_idx < impl_->params.fec_chunk_count && 
+        while (fec_idx < impl_->fec_slots && 
                !impl_->fec_received.test(fec_idx)) {
             ++fec_idx;
         }
         
-        if (fec_idx >= impl_->params.fec_chunk_count) {
+        if (fec_idx >= impl_->fec_slots) {
             break;  // Нет доступных FEC чанков
         }
         
-        // Копируем FEC чанк как начальное значение
-        std::vector<uint8_t> recovered = *impl_->fec_chunks[fec_idx];
+        // FEC чанк как начальное значение - прямо на место потерянного чанка
+        impl_->store_data(missing_idx, impl_->fec_chunk(fec_idx));
+        const MutableByteSpan recovered{impl_->data_slot(missing_idx), impl_->lengths[missing_idx]};
         
         // XOR со всеми имеющимися data чанками
-        for (uint16_t i = 0; i < impl_->params.data_chunk_count; ++i) {
+        for (uint16_t i = 0; i < impl_->data_slots; ++i) {
             if (i != missing_idx && impl_->data_received.test(i)) {
-                xor_bytes(recovered, *impl_->data_chunks[i]);
+                xor_bytes(recovered, impl_->data_chunk(i));
             }
         }
         
-        // Сохраняем восстановленный чанк
-        impl_->data_chunks[missing_idx] = std::move(recovered);
         impl_->data_received.set(missing_idx);
         ++impl_->data_count;
         ++result.chunks_recovered;
         
         // Помечаем FEC как использованный
         impl_->fec_received.reset(fec_idx);
-        impl_->fec_chunks[fec_idx].reset();
+        impl_->lengths[impl_->data_slots + fec_idx] = 0;
         --impl_->fec_count;
     }
     
     // Проверяем, все ли чанки восстановлены
     if (!has_all_data_chunks()) {
-        return std::unexpected(Error{
+        return std::unexpected(FastError{
             ErrorCode::CryptoInvalidLength,
             "Не удалось восстановить все чанки"
         });
     }
     
-    // Собираем данные
-    result.data.reserve(
-        static_cast<std::size_t>(impl_->params.data_chunk_count) * 
-        static_cast<std::size_t>(impl_->params.chunk_size)
-    );
-    
-    for (uint16_t i = 0; i < impl_->params.data_chunk_count; ++i) {
-        if (impl_->data_chunks[i]) {
-            result.data.insert(
-                result.data.end(),
-                impl_->data_chunks[i]->begin(),
-                impl_->data_chunks[i]->end()
-            );
-        }
-    }
-    
     result.data_chunks_used = impl_->data_count;
     result.fec_chunks_used = result.chunks_recovered;
     
-    return result;
+    return impl_->block_view();
 }
 
-std::optional<std::vector<uint8_t>> FecDecoder::get_first_n_bytes(std::size_t n) const {
-    if (n == 0) {
-        return std::vector<uint8_t>{};
-    }
-    
-    std::vector<uint8_t> result;
-    result.reserve(n);
+bool FecDecoder::copy_prefix(MutableByteSpan out) const noexcept {
+    std::size_t copied = 0;
     
-    // Собираем данные из первых чанков
-    for (uint16_t i = 0; i < impl_->params.data_chunk_count && result.size() < n; ++i) {
+    // Только непрерывный префикс из полученных data чанков
+    for (uint16_t i = 0; i < impl_->data_slots && copied < out.size(); ++i) {
         if (!impl_->data_received.test(i)) {
-            // Нет последовательных чанков - не можем гарантировать начало
-            if (result.empty()) {
-                return std::nullopt;
-            }
-            break;
+            return false;
         }
         
-        const auto& chunk = *impl_->data_chunks[i];
-        const std::size_t need = n - result.size();
-        const std::size_t take = std::min(need, chunk.size());
-        
-        result.insert(result.end(), chunk.begin(), chunk.begin() + take);
+        const auto chunk = impl_->data_chunk(i);
+        const std::size_t take = std::min(out.size() - copied, chunk.size());
+        std::memcpy(out.data() + copied, chunk.data(), take);
+        copied += take;
     }
     
-    if (result.size() < n) {
+    return copied == out.size();
+}
+
+std::optional<std::vector<uint8_t>> FecDecoder::get_first_n_bytes(std::size_t n) const {
+    std::vector<uint8_t> result(n);
+    if (!copy_prefix(result)) {
         return std::nullopt;
     }
-    
     return result;
 }
 
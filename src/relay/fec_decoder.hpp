@@ -12,8 +12,13 @@
  * - Для восстановления нужны любые N из (N+M) чанков
  * - Типичное соотношение: N=100, M=50 (можно потерять до 33% пакетов)
  * 
- * @note Текущая реализация использует простой XOR-based FEC.
- *       Для полноценной реализации рекомендуется библиотека cm256.
+ * Схемы (FecParams::scheme):
+ * - CauchyReedSolomon: систематический код Коши над GF(2^8) (матрица как
+ *   в cm256, первая строка - чистый XOR). Восстанавливает данные из любых
+ *   data_chunk_count чанков, ограничение N + M <= 256
+ * - Xor: каждый FEC чанк - XOR всех data чанков (один потерянный чанк)
+ *
+ * Умножение на константу по всему чанку - SIMD ядра из gf256.hpp.
  */
 
 #pragma once
@@ -43,6 +48,12 @@ inline constexpr std::size_t MAX_DATA_CHUNKS = 256;
 /// @brief Максимальное количество FEC chunks
 inline constexpr std::size_t MAX_FEC_CHUNKS = 128;
 
+/// @brief Предел N + M для кода Коши (элементы GF(2^8) различны)
+inline constexpr std::size_t MAX_CAUCHY_CHUNKS = 256;
+
+/// @brief Выравнивание буфера собранного блока (страница)
+inline constexpr std::size_t BLOCK_BUFFER_ALIGNMENT = 4096;
+
 // =============================================================================
 // Структуры данных
 // =============================================================================
@@ -88,6 +99,17 @@ struct FecDecodeResult {
     std::size_t chunks_recovered{0};
 };
 
+/**
+ * @brief Схема FEC кода
+ */
+enum class FecScheme : uint8_t {
+    /// @brief Каждый FEC чанк - XOR всех data чанков
+    Xor,
+    
+    /// @brief Код Коши над GF(2^8): любые N из N + M чанков
+    CauchyReedSolomon
+};
+
 /**
  * @brief Параметры FEC кодирования
  */
@@ -101,6 +123,9 @@ struct FecParams {
     /// @brief Размер одного чанка
     uint16_t chunk_size{1400};
     
+    /// @brief Схема кода
+    FecScheme scheme{FecScheme::CauchyReedSolomon};
+    
     /**
      * @brief Общее количество чанков
      */
@@ -127,6 +152,12 @@ struct FecParams {
  * Собирает чанки и пытается восстановить оригинальные данные,
  * используя FEC коды при необходимости.
  * 
+ * Data чанки сразу ложатся на своё смещение в выровненном по странице
+ * буфере блока: размер чанка отправителя (stride) берётся из первого
+ * полноразмерного data или FEC чанка, короче stride может быть только
+ * последний data чанк. Чанк другой длины отклоняется. Декодирование
+ * лишь заполняет пропуски на месте.
+ * 
  * Thread-safety: класс НЕ является потокобезопасным.
  * Внешняя синхронизация требуется при использовании из нескольких потоков.
  */
@@ -187,6 +218,15 @@ public:
      */
     [[nodiscard]] bool can_decode() const noexcept;
     
+    /**
+     * @brief Чанк уже получен?
+     * 
+     * @param chunk_id ID чанка (для FEC - 0..M-1)
+     * @param is_fec FEC чанк?
+     * @return true если чанк в битовой карте (вне диапазона - false)
+     */
+    [[nodiscard]] bool has_chunk(uint16_t chunk_id, bool is_fec) const noexcept;
+    
     /**
      * @brief Все ли data чанки получены?
      * 
@@ -223,7 +263,31 @@ public:
      * 
      * @return Результат декодирования или ошибка
      */
-    [[nodiscard]] Result<FecDecodeResult> decode();
+    [[nodiscard]] FastResult<FecDecodeResult> decode();
+    
+    /**
+     * @brief Декодировать в существующий результат
+     * 
+     * То же, что decode(), но данные пишутся в result.data с
+     * переиспользованием его ёмкости: повторное декодирование блока того
+     * же размера не выделяет память.
+     * 
+     * @param result Результат (перезаписывается)
+     * @return Успех или ошибка
+     */
+    [[nodiscard]] FastResult<void> decode(FecDecodeResult& result);
+    
+    /**
+     * @brief Декодировать на месте, без копии блока
+     * 
+     * Потерянные data чанки восстанавливаются прямо в буфере блока.
+     * Восстановленный последний чанк дополнен нулями до stride.
+     * 
+     * @param result Счётчики чанков (result.data не меняется)
+     * @return Блок в буфере декодера (начало выровнено по
+     *         BLOCK_BUFFER_ALIGNMENT; действителен до reset) или ошибка
+     */
+    [[nodiscard]] FastResult<ByteSpan> decode_in_place(FecDecodeResult& result);
     
     /**
      * @brief Получить первые N байт данных (если доступны)
@@ -236,6 +300,16 @@ public:
      */
     [[nodiscard]] std::optional<std::vector<uint8_t>> get_first_n_bytes(std::size_t n) const;
     
+    /**
+     * @brief Скопировать первые out.size() байт данных в буфер
+     * 
+     * Вариант get_first_n_bytes без выделения памяти.
+     * 
+     * @param out Буфер назначения
+     * @return true если непрерывное начало данных получено
+     */
+    [[nodiscard]] bool copy_prefix(MutableByteSpan out) const noexcept;
+    
     // =========================================================================
     // Управление состоянием
     // =========================================================================
@@ -264,7 +338,8 @@ private:
 /**
  * @brief XOR двух массивов байт
  * 
- * Простейшая операция для FEC восстановления.
+ * Простейшая операция для FEC восстановления. Векторизована:
+ * AVX2 / SSE2 / NEON (см. gf_xor).
  * 
  * @param dst Массив-приёмник (будет модифицирован)
  * @param src Массив-источник
@@ -283,4 +358,34 @@ void xor_bytes(MutableByteSpan dst, ByteSpan src) noexcept;
     std::size_t chunk_size
 );
 
+/**
+ * @brief Коэффициент кода Коши для FEC чанка и data чанка
+ *
+ * (j ^ N) / ((N + f) ^ j) в GF(2^8): при f = 0 все коэффициенты равны 1.
+ *
+ * @param data_chunk_count N
+ * @param fec_index Индекс FEC чанка f (0..M-1)
+ * @param data_index Индекс data чанка j (0..N-1)
+ */
+[[nodiscard]] uint8_t cauchy_coefficient(
+    uint16_t data_chunk_count,
+    uint16_t fec_index,
+    uint16_t data_index
+) noexcept;
+
+/**
+ * @brief Сгенерировать FEC чанки по схеме params.scheme
+ *
+ * Длина FEC чанка - длина самого длинного data чанка (короткие
+ * дополняются нулями).
+ *
+ * @param params Параметры (data_chunk_count, fec_chunk_count, scheme)
+ * @param data_chunks Data чанки, ровно data_chunk_count
+ * @return fec_chunk_count FEC чанков или ошибка параметров
+ */
+[[nodiscard]] Result<std::vector<std::vector<uint8_t>>> encode_fec_chunks(
+    const FecParams& params,
+    const std::vector<ByteSpan>& data_chunks
+);
+
 } // namespace quaxis::relay
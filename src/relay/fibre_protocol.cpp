@@ -6,10 +6,16 @@
 #include "fibre_protocol.hpp"
 #include "../core/byte_order.hpp"
 
+#include <algorithm>
+#include <bit>
 #include <cstring>
 #include <format>
 #include <sstream>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 namespace quaxis::relay {
 
 // =============================================================================
@@ -56,73 +62,168 @@ void write_be32(uint8_t* data, uint32_t value) noexcept {
     data[3] = static_cast<uint8_t>(value);
 }
 
+/**
+ * @brief Разобрать заголовок, magic которого уже проверен
+ */
+void decode_header(const uint8_t* ptr, FibreHeader& header) noexcept {
+    header.magic = read_be32(ptr);
+    header.version = ptr[4];
+    header.flags = ptr[5];
+    header.chunk_id = read_be16(ptr + 6);
+    header.block_height = read_be32(ptr + 8);
+    std::memcpy(header.block_hash.data(), ptr + 12, 32);
+    header.total_chunks = read_be16(ptr + 44);
+    header.data_chunks = read_be16(ptr + 46);
+    header.payload_size = read_be16(ptr + 48);
+}
+
+/**
+ * @brief Маска датаграмм [0, count) с корректными magic, версией и флагами
+ *
+ * count не больше 64. Остальные поля проверяет is_valid после чтения.
+ */
+[[nodiscard]] uint64_t prefilter(std::span<const UdpDatagram> datagrams) noexcept {
+    uint64_t mask = 0;
+    std::size_t i = 0;
+    
+#if defined(__SSE2__)
+    // x86 - little-endian: первые 8 байт датаграммы как два u32, magic -
+    // в байтах сети, во втором слове версия (байт 0) и флаги (байт 1).
+    // Короткая датаграмма даёт нули - magic не совпадёт
+    auto load_prefix = [](ByteSpan data) noexcept {
+        uint64_t prefix = 0;
+        if (data.size() >= FIBRE_HEADER_SIZE) {
+            std::memcpy(&prefix, data.data(), sizeof(prefix));
+        }
+        return prefix;
+    };
+    const __m128i magic = _mm_set1_epi32(static_cast<int>(std::byteswap(FIBRE_MAGIC)));
+    const __m128i version_mask = _mm_set1_epi32(0xFF);
+    const __m128i unknown_flags = _mm_set1_epi32(static_cast<int>(uint32_t{static_cast<uint8_t>(~FIBRE_KNOWN_FLAGS)} << 8));
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 4 <= datagrams.size(); i += 4) {
+        uint32_t words[4];
+        uint32_t metas[4];
+        for (std::size_t k = 0; k < 4; ++k) {
+            const uint64_t prefix = load_prefix(datagrams[i + k].data);
+            words[k] = static_cast<uint32_t>(prefix);
+            metas[k] = static_cast<uint32_t>(prefix >> 32);
+        }
+        __m128i w;
+        __m128i m;
+        std::memcpy(&w, words, sizeof(w));
+        std::memcpy(&m, metas, sizeof(m));
+        
+        const __m128i magic_ok = _mm_cmpeq_epi32(w, magic);
+        const __m128i no_version = _mm_cmpeq_epi32(_mm_and_si128(m, version_mask), zero);
+        const __m128i flags_ok = _mm_cmpeq_epi32(_mm_and_si128(m, unknown_flags), zero);
+        const __m128i ok = _mm_andnot_si128(no_version, _mm_and_si128(magic_ok, flags_ok));
+        mask |= static_cast<uint64_t>(_mm_movemask_ps(_mm_castsi128_ps(ok))) << i;
+    }
+#endif
+    
+    for (; i < datagrams.size(); ++i) {
+        const ByteSpan data = datagrams[i].data;
+        if (data.size() >= FIBRE_HEADER_SIZE && read_be32(data.data()) == FIBRE_MAGIC &&
+            data[4] != 0 && (data[5] & ~FIBRE_KNOWN_FLAGS) == 0) {
+            mask |= uint64_t{1} << i;
+        }
+    }
+    return mask;
+}
+
 } // anonymous namespace
 
 // =============================================================================
 // Реализация FibreParser
 // =============================================================================
 
-Result<FibrePacket> FibreParser::parse(ByteSpan data) const {
+FastResult<FibrePacket> FibreParser::parse(ByteSpan data) const {
+    auto view = parse_view(data);
+    if (!view) {
+        return std::unexpected(view.error());
+    }
+    
+    FibrePacket packet;
+    packet.header = view->header;
+    packet.payload.assign(view->payload.begin(), view->payload.end());
+    
+    return packet;
+}
+
+FastResult<FibrePacketView> FibreParser::parse_view(ByteSpan data) const {
     // Парсим заголовок
     auto header_result = parse_header(data);
     if (!header_result) {
         return std::unexpected(header_result.error());
     }
     
-    FibrePacket packet;
+    FibrePacketView packet;
     packet.header = *header_result;
     
-    // Извлекаем payload
+    // Payload - подмассив датаграммы
     if (data.size() < FIBRE_HEADER_SIZE + packet.header.payload_size) {
-        return std::unexpected(Error{
+        return std::unexpected(FastError{
             ErrorCode::CryptoInvalidLength,
             "Недостаточно данных для payload"
         });
     }
     
-    const uint8_t* payload_start = data.data() + FIBRE_HEADER_SIZE;
-    packet.payload.assign(payload_start, payload_start + packet.header.payload_size);
+    packet.payload = data.subspan(FIBRE_HEADER_SIZE, packet.header.payload_size);
     
     return packet;
 }
 
-Result<FibreHeader> FibreParser::parse_header(ByteSpan data) const {
+std::span<FibrePacketView> FibreParser::parse_batch(
+    std::span<const UdpDatagram> datagrams,
+    std::span<FibrePacketView> out
+) const noexcept {
+    constexpr std::size_t GROUP = 64;
+    const std::size_t limit = std::min(datagrams.size(), out.size());
+    std::size_t count = 0;
+    
+    for (std::size_t base = 0; base < limit; base += GROUP) {
+        const auto group = datagrams.subspan(base, std::min(GROUP, limit - base));
+        uint64_t mask = prefilter(group);
+        while (mask != 0) {
+            const auto i = static_cast<std::size_t>(std::countr_zero(mask));
+            mask &= mask - 1;
+            
+            const ByteSpan data = group[i].data;
+            FibrePacketView& packet = out[count];
+            decode_header(data.data(), packet.header);
+            if (!packet.header.is_valid() ||
+                data.size() < FIBRE_HEADER_SIZE + packet.header.payload_size) {
+                continue;
+            }
+            packet.payload = data.subspan(FIBRE_HEADER_SIZE, packet.header.payload_size);
+            ++count;
+        }
+    }
+    return out.first(count);
+}
+
+FastResult<FibreHeader> FibreParser::parse_header(ByteSpan data) const {
     if (data.size() < FIBRE_HEADER_SIZE) {
-        return std::unexpected(Error{
+        return std::unexpected(FastError{
             ErrorCode::CryptoInvalidLength,
             "Пакет слишком короткий для FIBRE заголовка"
         });
     }
     
-    const uint8_t* ptr = data.data();
-    FibreHeader header;
-    
-    // Читаем поля
-    header.magic = read_be32(ptr); ptr += 4;
-    
-    if (header.magic != FIBRE_MAGIC) {
-        return std::unexpected(Error{
+    if (read_be32(data.data()) != FIBRE_MAGIC) {
+        return std::unexpected(FastError{
             ErrorCode::CryptoInvalidLength,
             "Некорректный magic number FIBRE"
         });
     }
     
-    header.version = *ptr++;
-    header.flags = *ptr++;
-    header.chunk_id = read_be16(ptr); ptr += 2;
-    header.block_height = read_be32(ptr); ptr += 4;
-    
-    // Block hash (32 байта)
-    std::memcpy(header.block_hash.data(), ptr, 32);
-    ptr += 32;
-    
-    header.total_chunks = read_be16(ptr); ptr += 2;
-    header.data_chunks = read_be16(ptr); ptr += 2;
-    header.payload_size = read_be16(ptr);
+    FibreHeader header;
+    decode_header(data.data(), header);
     
     // Валидация
     if (!header.is_valid()) {
-        return std::unexpected(Error{
+        return std::unexpected(FastError{
             ErrorCode::CryptoInvalidLength,
             "Некорректный заголовок FIBRE"
         });
@@ -165,7 +266,7 @@ bool FibreParser::check_magic(ByteSpan data) noexcept {
     return read_be32(data.data()) == FIBRE_MAGIC;
 }
 
-std::vector<uint8_t> FibreParser::create_keepalive() {
+std::vector<uint8_t> FibreParser::create_keepalive(uint32_t sequence, uint64_t timestamp_ns) {
     std::vector<uint8_t> data(FIBRE_HEADER_SIZE);
     uint8_t* ptr = data.data();
     
@@ -176,9 +277,24 @@ std::vector<uint8_t> FibreParser::create_keepalive() {
     // Остальные поля нулевые
     std::memset(ptr, 0, FIBRE_HEADER_SIZE - 6);
     
+    write_be32(data.data() + 8, sequence);
+    write_be32(data.data() + 12, static_cast<uint32_t>(timestamp_ns >> 32));
+    write_be32(data.data() + 16, static_cast<uint32_t>(timestamp_ns));
+    
     return data;
 }
 
+std::vector<uint8_t> FibreParser::create_keepalive_echo(const FibreHeader& request) {
+    auto data = create_keepalive(request.block_height, keepalive_timestamp(request));
+    data[5] = static_cast<uint8_t>(FibreFlags::Keepalive) | static_cast<uint8_t>(FibreFlags::Ack);
+    return data;
+}
+
+uint64_t FibreParser::keepalive_timestamp(const FibreHeader& header) noexcept {
+    return (uint64_t{read_be32(header.block_hash.data())} << 32) |
+           read_be32(header.block_hash.data() + 4);
+}
+
 std::vector<uint8_t> FibreParser::create_ack(
     const Hash256& block_hash,
     uint16_t chunk_id
@@ -226,6 +342,7 @@ std::string flags_to_string(uint8_t flags) {
     add_flag(FibreFlags::Retransmit, "Retransmit");
     add_flag(FibreFlags::Keepalive, "Keepalive");
     add_flag(FibreFlags::Ack, "Ack");
+    add_flag(FibreFlags::Sketch, "Sketch");
     
     return oss.str();
 }
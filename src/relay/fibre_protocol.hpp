@@ -16,12 +16,17 @@
  * - Data chunks (2 байта): количество data чанков
  * - Payload size (2 байта): размер полезной нагрузки
  * - Payload (переменный): данные или FEC
+ * 
+ * Пакет с флагом Sketch несёт часть наброска блока (chunk_id - номер
+ * части): по нему приёмник синтезирует data чанки из своего mempool.
  */
 
 #pragma once
 
+#include "../core/constants.hpp"
 #include "../core/types.hpp"
 #include "fec_decoder.hpp"
+#include "udp_socket.hpp"
 
 #include <array>
 #include <cstdint>
@@ -71,8 +76,14 @@ enum class FibreFlags : uint8_t {
     
     /// @brief Пакет-подтверждение
     Ack = 0x10,
+    
+    /// @brief Часть наброска блока (short id транзакций, compact_block.hpp)
+    Sketch = 0x20,
 };
 
+/// @brief Все определённые флаги: пакет с другими битами отбрасывается
+inline constexpr uint8_t FIBRE_KNOWN_FLAGS = 0x3F;
+
 /**
  * @brief Проверить флаг
  */
@@ -136,6 +147,44 @@ struct FibreHeader {
         return has_flag(flags, FibreFlags::Keepalive);
     }
     
+    /**
+     * @brief Это часть наброска блока (не чанк)?
+     */
+    [[nodiscard]] bool is_sketch() const noexcept {
+        return has_flag(flags, FibreFlags::Sketch);
+    }
+    
+    /**
+     * @brief Это эхо нашего keepalive (Keepalive | Ack)?
+     */
+    [[nodiscard]] bool is_keepalive_echo() const noexcept {
+        return is_keepalive() && has_flag(flags, FibreFlags::Ack);
+    }
+    
+    /**
+     * @brief Data чанк несёт байты header блока?
+     *
+     * Data чанки блока одного размера (короче может быть только
+     * последний), поэтому смещение чанка - chunk_id * payload_size.
+     */
+    [[nodiscard]] bool carries_header() const noexcept {
+        return !is_fec() && !is_sketch() && !is_keepalive() &&
+               static_cast<std::size_t>(chunk_id) * payload_size < constants::BLOCK_HEADER_SIZE;
+    }
+    
+    /**
+     * @brief Пакет идёт быстрой полосой приёма?
+     *
+     * Keepalive (замер RTT), чанк с header (по нему срабатывает
+     * header-first), LastChunk и набросок (он тоже несёт header, а data
+     * чанки из mempool синтезируются, только если он пришёл раньше FEC)
+     * обрабатываются раньше прочих чанков пачки и передаются владельцу
+     * блока отдельной очередью.
+     */
+    [[nodiscard]] bool is_priority() const noexcept {
+        return is_keepalive() || is_sketch() || is_last() || carries_header();
+    }
+    
     /**
      * @brief Количество FEC чанков
      */
@@ -145,16 +194,35 @@ struct FibreHeader {
     
     /**
      * @brief Валидный заголовок?
+     *
+     * Keepalive не несёт чанка: поля блока в нём заняты эхо RTT.
      */
     [[nodiscard]] bool is_valid() const noexcept {
         return magic == FIBRE_MAGIC &&
                version >= 1 &&
+               (flags & ~FIBRE_KNOWN_FLAGS) == 0 &&
                payload_size <= FIBRE_MAX_PAYLOAD_SIZE &&
-               chunk_id < total_chunks &&
-               data_chunks <= total_chunks;
+               (is_keepalive()
+                    ? payload_size == 0
+                    : chunk_id < total_chunks && data_chunks <= total_chunks);
     }
 };
 
+/**
+ * @brief FIBRE пакет без копии payload
+ *
+ * payload указывает в буфер приёма (slab UdpSocket) и действителен только
+ * внутри callback'а датаграммы. Реконструктор копирует его один раз - в
+ * арену FecDecoder своего блока.
+ */
+struct FibrePacketView {
+    /// @brief Заголовок
+    FibreHeader header;
+    
+    /// @brief Payload (данные или FEC)
+    ByteSpan payload;
+};
+
 /**
  * @brief Полный FIBRE пакет
  */
@@ -186,6 +254,13 @@ struct FibrePacket {
         return header.is_fec();
     }
     
+    /**
+     * @brief Представление без копии payload
+     */
+    [[nodiscard]] FibrePacketView view() const noexcept {
+        return {header, payload};
+    }
+    
     /**
      * @brief Преобразовать в FEC чанк
      */
@@ -222,7 +297,32 @@ public:
      * @param data Сырые данные UDP пакета
      * @return Распарсенный пакет или ошибка
      */
-    [[nodiscard]] Result<FibrePacket> parse(ByteSpan data) const;
+    [[nodiscard]] FastResult<FibrePacket> parse(ByteSpan data) const;
+    
+    /**
+     * @brief Парсить пакет без копирования payload
+     * 
+     * @param data Сырые данные UDP пакета (должны жить дольше результата)
+     * @return Заголовок и payload внутри data или ошибка
+     */
+    [[nodiscard]] FastResult<FibrePacketView> parse_view(ByteSpan data) const;
+    
+    /**
+     * @brief Разобрать пачку датаграмм без копирования payload
+     * 
+     * magic, версия и флаги всей пачки проверяются SIMD (SSE2 - по 4
+     * датаграммы за сравнение), поля заголовка читаются только у
+     * прошедших. Результат тот же, что у parse_view для каждой
+     * датаграммы: некорректные пропускаются, порядок сохраняется.
+     * 
+     * @param datagrams Датаграммы (например, одного recvmmsg)
+     * @param out Буфер результатов (не меньше datagrams.size())
+     * @return Префикс out с пакетами; payload указывает в data датаграмм
+     */
+    [[nodiscard]] std::span<FibrePacketView> parse_batch(
+        std::span<const UdpDatagram> datagrams,
+        std::span<FibrePacketView> out
+    ) const noexcept;
     
     /**
      * @brief Парсить только заголовок
@@ -230,7 +330,7 @@ public:
      * @param data Данные пакета
      * @return Заголовок или ошибка
      */
-    [[nodiscard]] Result<FibreHeader> parse_header(ByteSpan data) const;
+    [[nodiscard]] FastResult<FibreHeader> parse_header(ByteSpan data) const;
     
     /**
      * @brief Сериализовать пакет
@@ -251,9 +351,31 @@ public:
     /**
      * @brief Создать keepalive пакет
      * 
+     * Номер идёт в block_height, метка времени отправителя - в первые
+     * 8 байт block_hash. Получатель возвращает их без изменений в эхо
+     * (create_keepalive_echo), отправитель по нему считает RTT.
+     * 
+     * @param sequence Номер keepalive
+     * @param timestamp_ns Метка времени отправителя (непрозрачна для пира)
      * @return Keepalive пакет
      */
-    [[nodiscard]] static std::vector<uint8_t> create_keepalive();
+    [[nodiscard]] static std::vector<uint8_t> create_keepalive(
+        uint32_t sequence = 0,
+        uint64_t timestamp_ns = 0
+    );
+    
+    /**
+     * @brief Создать эхо keepalive (Keepalive | Ack с полями запроса)
+     * 
+     * @param request Заголовок принятого keepalive
+     * @return Эхо пакет
+     */
+    [[nodiscard]] static std::vector<uint8_t> create_keepalive_echo(const FibreHeader& request);
+    
+    /**
+     * @brief Метка времени из keepalive или его эхо
+     */
+    [[nodiscard]] static uint64_t keepalive_timestamp(const FibreHeader& header) noexcept;
     
     /**
      * @brief Создать ACK пакет
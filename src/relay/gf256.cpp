@@ -0,0 +1,355 @@
+/**
+ * @file gf256.cpp
+ * @brief Реализация арифметики GF(2^8) и диспетчер ядер mul-add
+ */
+
+#include "gf256.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#ifdef __x86_64__
+#include <cpuid.h>
+#endif
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace quaxis::relay {
+
+// =============================================================================
+// Внешние функции реализаций
+// =============================================================================
+
+#ifdef QUAXIS_HAS_GF256_SSSE3
+namespace gf256_ssse3 {
+    std::size_t mul_add(uint8_t* dst, const uint8_t* src, std::size_t len,
+                        const uint8_t* lo_table, const uint8_t* hi_table) noexcept;
+}
+#endif
+
+#ifdef QUAXIS_HAS_GF256_AVX2
+namespace gf256_avx2 {
+    std::size_t mul_add(uint8_t* dst, const uint8_t* src, std::size_t len,
+                        const uint8_t* lo_table, const uint8_t* hi_table) noexcept;
+    std::size_t xor_add(uint8_t* dst, const uint8_t* src, std::size_t len) noexcept;
+}
+#endif
+
+#ifdef QUAXIS_HAS_GF256_GFNI
+namespace gf256_gfni {
+    std::size_t mul_add(uint8_t* dst, const uint8_t* src, std::size_t len, uint64_t matrix) noexcept;
+}
+#endif
+
+namespace {
+
+// =============================================================================
+// Таблицы log / exp
+// =============================================================================
+
+/// @brief Порождающий многочлен x^8 + x^4 + x^3 + x^2 + 1
+constexpr unsigned GF_POLYNOMIAL = 0x11D;
+
+struct GfTables {
+    /// @brief exp[i] = 2^i, продублирована для log[a] + log[b] без mod 255
+    std::array<uint8_t, 512> exp{};
+    /// @brief log[a] (log[0] не определён)
+    std::array<uint16_t, 256> log{};
+};
+
+constexpr GfTables make_tables() noexcept {
+    GfTables tables;
+    unsigned x = 1;
+    for (unsigned i = 0; i < 255; ++i) {
+        tables.exp[i] = static_cast<uint8_t>(x);
+        tables.log[x] = static_cast<uint16_t>(i);
+        x <<= 1;
+        if (x & 0x100) {
+            x ^= GF_POLYNOMIAL;
+        }
+    }
+    for (unsigned i = 255; i < 512; ++i) {
+        tables.exp[i] = tables.exp[i - 255];
+    }
+    return tables;
+}
+
+constexpr GfTables TABLES = make_tables();
+
+constexpr uint8_t table_mul(uint8_t a, uint8_t b) noexcept {
+    if (a == 0 || b == 0) {
+        return 0;
+    }
+    return TABLES.exp[TABLES.log[a] + TABLES.log[b]];
+}
+
+/**
+ * @brief Таблицы c * x для младшего и старшего полубайта
+ */
+struct NibbleTables {
+    alignas(16) std::array<uint8_t, 16> lo{};
+    alignas(16) std::array<uint8_t, 16> hi{};
+};
+
+constexpr std::array<NibbleTables, 256> make_nibble_tables() noexcept {
+    std::array<NibbleTables, 256> all{};
+    for (unsigned c = 0; c < 256; ++c) {
+        for (unsigned x = 0; x < 16; ++x) {
+            all[c].lo[x] = table_mul(static_cast<uint8_t>(c), static_cast<uint8_t>(x));
+            all[c].hi[x] = table_mul(static_cast<uint8_t>(c), static_cast<uint8_t>(x << 4));
+        }
+    }
+    return all;
+}
+
+/// @brief Таблицы полубайтов для каждого коэффициента (8 КБ)
+constexpr std::array<NibbleTables, 256> NIBBLES = make_nibble_tables();
+
+#ifdef QUAXIS_HAS_GF256_GFNI
+/**
+ * @brief Матрицы vgf2p8affineqb для умножения на каждый коэффициент
+ *
+ * Бит i результата = parity(A.byte[7 - i] & x), поэтому строка i
+ * (биты по j = бит i от c * 2^j) кладётся в байт 7 - i.
+ */
+constexpr std::array<uint64_t, 256> make_affine_matrices() noexcept {
+    std::array<uint64_t, 256> all{};
+    for (unsigned c = 0; c < 256; ++c) {
+        uint64_t matrix = 0;
+        for (unsigned i = 0; i < 8; ++i) {
+            uint64_t row = 0;
+            for (unsigned j = 0; j < 8; ++j) {
+                if ((table_mul(static_cast<uint8_t>(c), static_cast<uint8_t>(1u << j)) >> i) & 1u) {
+                    row |= uint64_t{1} << j;
+                }
+            }
+            matrix |= row << (8 * (7 - i));
+        }
+        all[c] = matrix;
+    }
+    return all;
+}
+
+constexpr std::array<uint64_t, 256> AFFINE = make_affine_matrices();
+#endif
+
+// =============================================================================
+// Определение возможностей CPU
+// =============================================================================
+
+#if defined(__x86_64__) && (defined(QUAXIS_HAS_GF256_AVX2) || defined(QUAXIS_HAS_GF256_GFNI))
+inline uint64_t read_xcr0() noexcept {
+    uint32_t lo, hi;
+    __asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+    return (static_cast<uint64_t>(hi) << 32) | lo;
+}
+#endif
+
+/**
+ * @brief Выбор ядра через CPUID (+ XCR0 для ymm)
+ *
+ * - SSSE3: CPUID.1:ECX[9]
+ * - AVX2: CPUID.7.0:EBX[5], XCR0[2:1]
+ * - GFNI: CPUID.7.0:ECX[8] (256-битная форма требует AVX)
+ */
+Gf256Implementation detect_implementation() noexcept {
+    Gf256Implementation best = Gf256Implementation::Scalar;
+#ifdef __x86_64__
+    unsigned int eax, ebx, ecx, edx;
+    if (__get_cpuid(1, &eax, &ebx, &ecx, &edx) == 0) {
+        return best;
+    }
+#ifdef QUAXIS_HAS_GF256_SSSE3
+    if ((ecx & (1u << 9)) != 0) {
+        best = Gf256Implementation::Ssse3;
+    }
+#endif
+#if defined(QUAXIS_HAS_GF256_AVX2) || defined(QUAXIS_HAS_GF256_GFNI)
+    const bool osxsave = (ecx & (1u << 27)) != 0;
+    if (!osxsave || (read_xcr0() & 0x06) != 0x06) {
+        return best;
+    }
+    if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) == 0 || (ebx & (1u << 5)) == 0) {
+        return best;
+    }
+#ifdef QUAXIS_HAS_GF256_AVX2
+    best = Gf256Implementation::Avx2;
+#endif
+#ifdef QUAXIS_HAS_GF256_GFNI
+    if ((ecx & (1u << 8)) != 0) {
+        best = Gf256Implementation::Gfni;
+    }
+#endif
+#endif
+#endif
+    return best;
+}
+
+/// @brief Кешированный выбор ядра
+const Gf256Implementation g_implementation = detect_implementation();
+
+/**
+ * @brief XOR базовым набором инструкций (SSE2 / NEON), хвост словами
+ */
+void xor_portable(uint8_t* d, const uint8_t* s, std::size_t len) noexcept {
+    std::size_t i = 0;
+#if defined(__SSE2__)
+    for (; i + 16 <= len; i += 16) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+        __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(d + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(d + i), _mm_xor_si128(x, y));
+    }
+#elif defined(__ARM_NEON)
+    for (; i + 16 <= len; i += 16) {
+        vst1q_u8(d + i, veorq_u8(vld1q_u8(d + i), vld1q_u8(s + i)));
+    }
+#endif
+    for (; i + 8 <= len; i += 8) {
+        uint64_t x, y;
+        std::memcpy(&x, s + i, 8);
+        std::memcpy(&y, d + i, 8);
+        y ^= x;
+        std::memcpy(d + i, &y, 8);
+    }
+    for (; i < len; ++i) {
+        d[i] ^= s[i];
+    }
+}
+
+} // anonymous namespace
+
+// =============================================================================
+// Скалярная арифметика
+// =============================================================================
+
+uint8_t gf_mul(uint8_t a, uint8_t b) noexcept {
+    return table_mul(a, b);
+}
+
+uint8_t gf_div(uint8_t a, uint8_t b) noexcept {
+    if (a == 0) {
+        return 0;
+    }
+    return TABLES.exp[TABLES.log[a] + 255u - TABLES.log[b]];
+}
+
+uint8_t gf_inv(uint8_t a) noexcept {
+    return TABLES.exp[255u - TABLES.log[a]];
+}
+
+// =============================================================================
+// Выбор реализации
+// =============================================================================
+
+Gf256Implementation get_gf256_implementation() noexcept {
+    return g_implementation;
+}
+
+bool has_gf256_implementation(Gf256Implementation implementation) noexcept {
+    // Ядра упорядочены: лучшее доступное подразумевает все предыдущие
+    // (кроме сборки без части ядер, см. QUAXIS_HAS_GF256_*)
+    switch (implementation) {
+        case Gf256Implementation::Scalar:
+            return true;
+        case Gf256Implementation::Ssse3:
+#ifdef QUAXIS_HAS_GF256_SSSE3
+            return g_implementation >= Gf256Implementation::Ssse3;
+#else
+            return false;
+#endif
+        case Gf256Implementation::Avx2:
+#ifdef QUAXIS_HAS_GF256_AVX2
+            return g_implementation >= Gf256Implementation::Avx2;
+#else
+            return false;
+#endif
+        case Gf256Implementation::Gfni:
+            return g_implementation == Gf256Implementation::Gfni;
+    }
+    return false;
+}
+
+std::string_view gf256_implementation_name(Gf256Implementation implementation) noexcept {
+    switch (implementation) {
+        case Gf256Implementation::Gfni: return "gfni";
+        case Gf256Implementation::Avx2: return "avx2";
+        case Gf256Implementation::Ssse3: return "ssse3";
+        case Gf256Implementation::Scalar: break;
+    }
+    return "scalar";
+}
+
+// =============================================================================
+// mul-add
+// =============================================================================
+
+void gf_xor(MutableByteSpan dst, ByteSpan src) noexcept {
+    const std::size_t len = std::min(dst.size(), src.size());
+    uint8_t* d = dst.data();
+    const uint8_t* s = src.data();
+    std::size_t done = 0;
+#ifdef QUAXIS_HAS_GF256_AVX2
+    if (g_implementation >= Gf256Implementation::Avx2) {
+        done = gf256_avx2::xor_add(d, s, len);
+    }
+#endif
+    xor_portable(d + done, s + done, len - done);
+}
+
+void gf_mul_add(MutableByteSpan dst, ByteSpan src, uint8_t coef) noexcept {
+    gf_mul_add(dst, src, coef, g_implementation);
+}
+
+void gf_mul_add(MutableByteSpan dst, ByteSpan src, uint8_t coef,
+                Gf256Implementation implementation) noexcept {
+    const std::size_t len = std::min(dst.size(), src.size());
+    if (coef == 0 || len == 0) {
+        return;
+    }
+    if (!has_gf256_implementation(implementation)) {
+        implementation = Gf256Implementation::Scalar;
+    }
+
+    uint8_t* d = dst.data();
+    const uint8_t* s = src.data();
+
+    if (coef == 1) {
+        gf_xor(dst, src);
+        return;
+    }
+
+    const NibbleTables& tables = NIBBLES[coef];
+    std::size_t done = 0;
+
+    switch (implementation) {
+#ifdef QUAXIS_HAS_GF256_GFNI
+        case Gf256Implementation::Gfni:
+            done = gf256_gfni::mul_add(d, s, len, AFFINE[coef]);
+            break;
+#endif
+#ifdef QUAXIS_HAS_GF256_AVX2
+        case Gf256Implementation::Avx2:
+            done = gf256_avx2::mul_add(d, s, len, tables.lo.data(), tables.hi.data());
+            break;
+#endif
+#ifdef QUAXIS_HAS_GF256_SSSE3
+        case Gf256Implementation::Ssse3:
+            done = gf256_ssse3::mul_add(d, s, len, tables.lo.data(), tables.hi.data());
+            break;
+#endif
+        default:
+            break;
+    }
+
+    // Хвост (или всё - для скалярной реализации)
+    for (std::size_t i = done; i < len; ++i) {
+        d[i] ^= static_cast<uint8_t>(tables.lo[s[i] & 0x0F] ^ tables.hi[s[i] >> 4]);
+    }
+}
+
+} // namespace quaxis::relay
@@ -0,0 +1,99 @@
+/**
+ * @file gf256.hpp
+ * @brief Арифметика GF(2^8) для erasure-кода FEC
+ *
+ * Поле GF(2^8) с порождающим многочленом x^8 + x^4 + x^3 + x^2 + 1 (0x11D)
+ * и генератором 2. Сложение - XOR, умножение - через таблицы log / exp.
+ *
+ * Горячая операция декодера - dst ^= c * src по всему чанку (mul-add).
+ * Реализации выбираются по CPUID один раз при загрузке:
+ * - GFNI + AVX2: vgf2p8affineqb (умножение на константу - линейное
+ *   отображение над GF(2), матрица 8x8 строится из c)
+ * - AVX2 / SSSE3: vpshufb / pshufb по двум таблицам полубайтов
+ *   (c * lo и c * (hi << 4))
+ * - Scalar: таблицы полубайтов побайтно
+ *
+ * XOR (коэффициент 1, XOR-схема FEC) - отдельное ядро gf_xor.
+ */
+
+#pragma once
+
+#include "../core/types.hpp"
+
+#include <cstdint>
+#include <string_view>
+
+namespace quaxis::relay {
+
+// =============================================================================
+// Скалярная арифметика
+// =============================================================================
+
+/**
+ * @brief Умножение a * b в GF(2^8)
+ */
+[[nodiscard]] uint8_t gf_mul(uint8_t a, uint8_t b) noexcept;
+
+/**
+ * @brief Деление a / b в GF(2^8) (b != 0)
+ */
+[[nodiscard]] uint8_t gf_div(uint8_t a, uint8_t b) noexcept;
+
+/**
+ * @brief Обратный элемент 1 / a (a != 0)
+ */
+[[nodiscard]] uint8_t gf_inv(uint8_t a) noexcept;
+
+// =============================================================================
+// Векторные ядра
+// =============================================================================
+
+/**
+ * @brief Реализация ядра mul-add
+ */
+enum class Gf256Implementation : uint8_t {
+    Scalar,
+    Ssse3,
+    Avx2,
+    Gfni
+};
+
+/**
+ * @brief Лучшая реализация, доступная на этом CPU
+ */
+[[nodiscard]] Gf256Implementation get_gf256_implementation() noexcept;
+
+/**
+ * @brief Поддерживается ли реализация на этом CPU (и собрана ли)
+ */
+[[nodiscard]] bool has_gf256_implementation(Gf256Implementation implementation) noexcept;
+
+/**
+ * @brief Имя реализации ("gfni", "avx2", "ssse3", "scalar")
+ */
+[[nodiscard]] std::string_view gf256_implementation_name(Gf256Implementation implementation) noexcept;
+
+/**
+ * @brief dst[i] ^= src[i] (min(dst, src) байт)
+ *
+ * AVX2 (по CPUID), иначе SSE2 на x86-64 / NEON на aarch64, хвост -
+ * 64-битными словами и байтами.
+ */
+void gf_xor(MutableByteSpan dst, ByteSpan src) noexcept;
+
+/**
+ * @brief dst[i] ^= coef * src[i] (min(dst, src) байт)
+ *
+ * coef == 0 ничего не делает, coef == 1 - обычный XOR.
+ */
+void gf_mul_add(MutableByteSpan dst, ByteSpan src, uint8_t coef) noexcept;
+
+/**
+ * @brief mul-add конкретной реализацией (тесты и бенчмарки)
+ *
+ * Неподдерживаемая реализация заменяется скалярной.
+ */
+void gf_mul_add(MutableByteSpan dst, ByteSpan src, uint8_t coef,
+                Gf256Implementation implementation) noexcept;
+
+} // namespace quaxis::relay
@@ -0,0 +1,57 @@
+/**
+ * @file gf256_avx2.cpp
+ * @brief mul-add GF(2^8) на AVX2 (vpshufb, 32 байта за шаг)
+ *
+ * Та же схема, что SSSE3: таблицы полубайтов продублированы в обе
+ * 128-битные половины регистра (vpshufb работает внутри половин).
+ * Здесь же XOR по 64 байта за шаг.
+ *
+ * @note Этот файл компилируется с флагом -mavx2
+ */
+
+#include <cstddef>
+#include <cstdint>
+
+#include <immintrin.h>
+
+namespace quaxis::relay::gf256_avx2 {
+
+std::size_t mul_add(uint8_t* dst, const uint8_t* src, std::size_t len,
+                    const uint8_t* lo_table, const uint8_t* hi_table) noexcept {
+    const __m256i lo = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(lo_table)));
+    const __m256i hi = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(hi_table)));
+    const __m256i mask = _mm256_set1_epi8(0x0F);
+
+    std::size_t i = 0;
+    for (; i + 32 <= len; i += 32) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+        __m256i l = _mm256_shuffle_epi8(lo, _mm256_and_si256(x, mask));
+        __m256i h = _mm256_shuffle_epi8(hi, _mm256_and_si256(_mm256_srli_epi64(x, 4), mask));
+        d = _mm256_xor_si256(d, _mm256_xor_si256(l, h));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), d);
+    }
+    return i;
+}
+
+std::size_t xor_add(uint8_t* dst, const uint8_t* src, std::size_t len) noexcept {
+    std::size_t i = 0;
+    for (; i + 64 <= len; i += 64) {
+        __m256i s0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        __m256i s1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + 32));
+        __m256i d0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+        __m256i d1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i + 32));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_xor_si256(d0, s0));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i + 32), _mm256_xor_si256(d1, s1));
+    }
+    for (; i + 32 <= len; i += 32) {
+        __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_xor_si256(d, s));
+    }
+    return i;
+}
+
+} // namespace quaxis::relay::gf256_avx2
@@ -0,0 +1,32 @@
+/**
+ * @file gf256_gfni.cpp
+ * @brief mul-add GF(2^8) на GFNI (vgf2p8affineqb, 32 байта за шаг)
+ *
+ * vgf2p8mulb зашит на многочлен AES (0x11B), поэтому умножение на c в
+ * нашем поле (0x11D) выполняется аффинным преобразованием: матрица 8x8
+ * над GF(2) строится диспетчером из c * 2^j.
+ *
+ * @note Этот файл компилируется с флагами -mgfni -mavx2
+ */
+
+#include <cstddef>
+#include <cstdint>
+
+#include <immintrin.h>
+
+namespace quaxis::relay::gf256_gfni {
+
+std::size_t mul_add(uint8_t* dst, const uint8_t* src, std::size_t len, uint64_t matrix) noexcept {
+    const __m256i m = _mm256_set1_epi64x(static_cast<long long>(matrix));
+
+    std::size_t i = 0;
+    for (; i + 32 <= len; i += 32) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+        d = _mm256_xor_si256(d, _mm256_gf2p8affine_epi64_epi8(x, m, 0));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), d);
+    }
+    return i;
+}
+
+} // namespace quaxis::relay::gf256_gfni
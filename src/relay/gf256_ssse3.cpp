@@ -0,0 +1,36 @@
+/**
+ * @file gf256_ssse3.cpp
+ * @brief mul-add GF(2^8) на SSSE3 (pshufb, 16 байт за шаг)
+ *
+ * c * x = c * lo(x) ^ c * (hi(x) << 4): pshufb выбирает произведения
+ * полубайтов из двух 16-байтных таблиц.
+ *
+ * @note Этот файл компилируется с флагом -mssse3
+ */
+
+#include <cstddef>
+#include <cstdint>
+
+#include <immintrin.h>
+
+namespace quaxis::relay::gf256_ssse3 {
+
+std::size_t mul_add(uint8_t* dst, const uint8_t* src, std::size_t len,
+                    const uint8_t* lo_table, const uint8_t* hi_table) noexcept {
+    const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lo_table));
+    const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(hi_table));
+    const __m128i mask = _mm_set1_epi8(0x0F);
+
+    std::size_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+        __m128i l = _mm_shuffle_epi8(lo, _mm_and_si128(x, mask));
+        __m128i h = _mm_shuffle_epi8(hi, _mm_and_si128(_mm_srli_epi64(x, 4), mask));
+        d = _mm_xor_si128(d, _mm_xor_si128(l, h));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), d);
+    }
+    return i;
+}
+
+} // namespace quaxis::relay::gf256_ssse3
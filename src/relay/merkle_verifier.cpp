@@ -0,0 +1,158 @@
+/**
+ * @file merkle_verifier.cpp
+ * @brief Реализация параллельной проверки merkle root
+ */
+
+#include "merkle_verifier.hpp"
+#include "../core/task_pool.hpp"
+#include "../crypto/sha256.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace quaxis::relay {
+
+namespace {
+
+/// @brief Транзакций в одной задаче пула
+constexpr std::size_t TXS_PER_TASK = 64;
+
+/// @brief Пар уровня дерева в одной задаче пула (одна пачка sha256d64_batch)
+constexpr std::size_t PAIRS_PER_TASK = 2048;
+
+std::size_t task_count(std::size_t items, std::size_t per_task) noexcept {
+    return (items + per_task - 1) / per_task;
+}
+
+} // anonymous namespace
+
+struct MerkleVerifier::Impl {
+    std::size_t threads;
+    std::unique_ptr<core::TaskPool> pool;
+
+    /// @brief Текущий и следующий уровень дерева (уровень 0 - txid)
+    std::vector<Hash256> level;
+    std::vector<Hash256> next;
+
+    std::mutex mutex;
+
+    explicit Impl(std::size_t requested)
+        : threads(requested != 0 ? requested : std::max<std::size_t>(std::thread::hardware_concurrency(), 1))
+    {}
+
+    /**
+     * @brief Пул для блока из tx_count транзакций (nullptr - в вызывающем потоке)
+     */
+    core::TaskPool* pool_for(std::size_t tx_count) {
+        if (threads <= 1 || tx_count < MERKLE_PARALLEL_MIN_TXS) {
+            return nullptr;
+        }
+        if (!pool) {
+            pool = std::make_unique<core::TaskPool>(threads - 1);
+        }
+        return pool.get();
+    }
+
+    /**
+     * @brief Txid всех транзакций в level
+     */
+    bool hash_transactions(const std::vector<ByteSpan>& txs, core::TaskPool* workers) {
+        level.resize(txs.size());
+        std::atomic<bool> valid{true};
+        const auto hash_range = [&](std::size_t task) {
+            const std::size_t begin = task * TXS_PER_TASK;
+            const std::size_t end = std::min(txs.size(), begin + TXS_PER_TASK);
+            for (std::size_t i = begin; i < end; ++i) {
+                auto txid = bitcoin::transaction_txid(txs[i]);
+                if (!txid) {
+                    valid.store(false, std::memory_order_relaxed);
+                    return;
+                }
+                level[i] = *txid;
+            }
+        };
+
+        const std::size_t tasks = task_count(txs.size(), TXS_PER_TASK);
+        if (workers) {
+            workers->run(tasks, hash_range);
+        } else {
+            for (std::size_t task = 0; task < tasks; ++task) {
+                hash_range(task);
+            }
+        }
+        return valid.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Свернуть level до корня: пары уровня - независимые 64-байтные сообщения
+     */
+    Hash256 reduce(core::TaskPool* workers) {
+        while (level.size() > 1) {
+            if (level.size() % 2 != 0) {
+                level.push_back(level.back());
+            }
+            const std::size_t pairs = level.size() / 2;
+            next.resize(pairs);
+
+            const auto hash_pairs = [&](std::size_t task) {
+                const std::size_t begin = task * PAIRS_PER_TASK;
+                const std::size_t count = std::min(pairs - begin, PAIRS_PER_TASK);
+                (void)crypto::sha256d64_batch(
+                    ByteSpan(level[2 * begin].data(), 2 * count * sizeof(Hash256)),
+                    std::span<Hash256>(next.data() + begin, count)
+                );
+            };
+
+            const std::size_t tasks = task_count(pairs, PAIRS_PER_TASK);
+            if (workers && tasks > 1) {
+                workers->run(tasks, hash_pairs);
+            } else {
+                for (std::size_t task = 0; task < tasks; ++task) {
+                    hash_pairs(task);
+                }
+            }
+            level.swap(next);
+        }
+        return level[0];
+    }
+};
+
+MerkleVerifier::MerkleVerifier(std::size_t threads)
+    : impl_(std::make_unique<Impl>(threads))
+{
+}
+
+MerkleVerifier::~MerkleVerifier() = default;
+
+Result<Hash256> MerkleVerifier::merkle_root(ByteSpan block, bool allow_zero_padding) {
+    auto txs = bitcoin::block_transactions(block, allow_zero_padding);
+    if (!txs) {
+        return std::unexpected(txs.error());
+    }
+
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    core::TaskPool* workers = impl_->pool_for(txs->size());
+    if (!impl_->hash_transactions(*txs, workers)) {
+        return Err<Hash256>(ErrorCode::CryptoInvalidLength, "Обрезанная транзакция в блоке");
+    }
+    return impl_->reduce(workers);
+}
+
+bool MerkleVerifier::matches(ByteSpan block, const bitcoin::BlockHeader& header) {
+    const auto expected = header.serialize();
+    if (block.size() < expected.size() ||
+        !std::equal(expected.begin(), expected.end(), block.begin())) {
+        return false;
+    }
+    auto root = merkle_root(block, true);
+    return root && *root == header.merkle_root;
+}
+
+std::size_t MerkleVerifier::threads() const noexcept {
+    return impl_->threads;
+}
+
+} // namespace quaxis::relay
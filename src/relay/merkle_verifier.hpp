@@ -0,0 +1,81 @@
+/**
+ * @file merkle_verifier.hpp
+ * @brief Параллельная проверка merkle root блока, собранного по relay
+ *
+ * Пока тело блока не сверено с заголовком, майнер остаётся на
+ * speculative заданиях (header-first). Проверка - тысячи независимых
+ * txid и уровни дерева, где каждая пара тоже независима: одним потоком
+ * это миллисекунды на полном блоке. MerkleVerifier делит txid между
+ * потоками core::TaskPool, а широкие уровни дерева - на куски по
+ * несколько тысяч пар, каждый одной пачкой crypto::sha256d64_batch
+ * (multi-buffer SHA).
+ *
+ * Разбор границ транзакций остаётся последовательным: это только проход
+ * по varint, без хеширования. Малые блоки считаются в вызывающем потоке -
+ * пробуждение пула дороже их хеширования.
+ *
+ * Thread-safety: вызовы из разных потоков выполняются по очереди (буферы
+ * txid и уровней переиспользуются между блоками).
+ */
+
+#pragma once
+
+#include "../core/types.hpp"
+#include "../bitcoin/block.hpp"
+
+#include <cstddef>
+#include <memory>
+
+namespace quaxis::relay {
+
+/// @brief Транзакций, с которых txid считаются на пуле
+inline constexpr std::size_t MERKLE_PARALLEL_MIN_TXS = 256;
+
+/**
+ * @brief Проверка merkle root тела блока на пуле потоков
+ */
+class MerkleVerifier {
+public:
+    /**
+     * @brief Создать проверку
+     *
+     * @param threads Потоков вместе с вызывающим (0 - по числу ядер, 1 - без пула)
+     */
+    explicit MerkleVerifier(std::size_t threads);
+
+    ~MerkleVerifier();
+
+    MerkleVerifier(const MerkleVerifier&) = delete;
+    MerkleVerifier& operator=(const MerkleVerifier&) = delete;
+
+    /**
+     * @brief Merkle root транзакций сериализованного блока
+     *
+     * Результат совпадает с bitcoin::compute_block_merkle_root.
+     *
+     * @param block Сериализованный блок (header + транзакции)
+     * @param allow_zero_padding Допустить нулевой хвост после транзакций
+     * @return Merkle root или ошибку разбора блока
+     */
+    [[nodiscard]] Result<Hash256> merkle_root(ByteSpan block, bool allow_zero_padding = false);
+
+    /**
+     * @brief Тело блока совпадает с заголовком
+     *
+     * Первые 80 байт - сериализация header, merkle root транзакций - его
+     * merkle_root. Нулевой хвост допускается: последний чанк,
+     * восстановленный FEC, дополнен нулями.
+     */
+    [[nodiscard]] bool matches(ByteSpan block, const bitcoin::BlockHeader& header);
+
+    /**
+     * @brief Потоков вместе с вызывающим
+     */
+    [[nodiscard]] std::size_t threads() const noexcept;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace quaxis::relay
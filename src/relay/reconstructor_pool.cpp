@@ -0,0 +1,144 @@
+/**
+ * @file reconstructor_pool.cpp
+ * @brief Реализация пула реконструкторов блоков
+ */
+
+#include "reconstructor_pool.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+namespace quaxis::relay {
+
+uint64_t block_hash_prefix(const Hash256& block_hash) noexcept {
+    uint64_t prefix;
+    std::memcpy(&prefix, block_hash.data(), sizeof(prefix));
+    return prefix;
+}
+
+ReconstructorPool::ReconstructorPool(std::size_t capacity) {
+    capacity = std::clamp<std::size_t>(capacity, 1, MAX_CAPACITY);
+
+    // Арена FecDecoder сразу под наибольший блок: дальше reset её не растит
+    FecParams max_params;
+    max_params.data_chunk_count = static_cast<uint16_t>(MAX_DATA_CHUNKS);
+    max_params.fec_chunk_count = static_cast<uint16_t>(MAX_FEC_CHUNKS);
+
+    entries_.reserve(capacity);
+    free_.reserve(capacity);
+    for (std::size_t i = 0; i < capacity; ++i) {
+        entries_.push_back(InflightBlock{
+            BlockReconstructor(Hash256{}, 0, max_params),
+            {},
+            false,
+            std::nullopt,
+            {},
+            false,
+            {},
+            0,
+            false,
+            false
+        });
+    }
+    // Стек свободных записей: первой берётся запись 0
+    for (std::size_t i = capacity; i > 0; --i) {
+        free_.push_back(static_cast<uint16_t>(i - 1));
+    }
+
+    index_.resize(std::bit_ceil(std::max<std::size_t>(capacity * 2, 16)));
+    mask_ = index_.size() - 1;
+}
+
+std::size_t ReconstructorPool::probe(const Hash256& block_hash, uint64_t prefix) const noexcept {
+    // Таблица заполнена не более чем наполовину - пустая ячейка найдётся
+    std::size_t pos = static_cast<std::size_t>(prefix) & mask_;
+    while (index_[pos].entry != EMPTY) {
+        const Slot& slot = index_[pos];
+        if (slot.prefix == prefix &&
+            entries_[slot.entry].reconstructor.block_hash() == block_hash) {
+            return pos;
+        }
+        pos = (pos + 1) & mask_;
+    }
+    return pos;
+}
+
+InflightBlock* ReconstructorPool::find(const Hash256& block_hash) noexcept {
+    const std::size_t pos = probe(block_hash, block_hash_prefix(block_hash));
+    if (index_[pos].entry == EMPTY) {
+        return nullptr;
+    }
+    return &entries_[index_[pos].entry];
+}
+
+InflightBlock* ReconstructorPool::acquire(
+    const Hash256& block_hash,
+    uint32_t height,
+    const FecParams& fec_params,
+    uint32_t timeout_ms
+) {
+    if (free_.empty()) {
+        return nullptr;
+    }
+
+    const uint64_t prefix = block_hash_prefix(block_hash);
+    const std::size_t pos = probe(block_hash, prefix);
+    if (index_[pos].entry != EMPTY) {
+        return &entries_[index_[pos].entry];  // Уже в пуле
+    }
+
+    const uint16_t id = free_.back();
+    free_.pop_back();
+    index_[pos] = Slot{prefix, id};
+    ++size_;
+
+    InflightBlock& entry = entries_[id];
+    entry.reconstructor.reset(block_hash, height, fec_params, timeout_ms);
+    entry.started_at = std::chrono::steady_clock::now();
+    entry.trusted = false;
+    entry.speculative_header.reset();
+    entry.decoding = false;
+    entry.sketch.reset();
+    entry.prefilled_chunks = 0;
+    entry.prefill_failed = false;
+    entry.active = true;
+    return &entry;
+}
+
+void ReconstructorPool::release(const Hash256& block_hash) noexcept {
+    std::size_t pos = probe(block_hash, block_hash_prefix(block_hash));
+    if (index_[pos].entry == EMPTY) {
+        return;
+    }
+
+    const uint16_t id = index_[pos].entry;
+    entries_[id].active = false;
+    free_.push_back(id);
+    --size_;
+
+    // Удаление со сдвигом назад: цепочки пробирования остаются без дыр
+    std::size_t next = (pos + 1) & mask_;
+    while (index_[next].entry != EMPTY) {
+        const std::size_t home = static_cast<std::size_t>(index_[next].prefix) & mask_;
+        // Ячейку next можно перенести в pos, если её home не в (pos, next]
+        if (((next - home) & mask_) >= ((next - pos) & mask_)) {
+            index_[pos] = index_[next];
+            pos = next;
+        }
+        next = (next + 1) & mask_;
+    }
+    index_[pos] = Slot{};
+}
+
+InflightBlock* ReconstructorPool::oldest() noexcept {
+    InflightBlock* result = nullptr;
+    for (auto& entry : entries_) {
+        if (entry.active && !entry.decoding && (!result || entry.started_at < result->started_at)) {
+            result = &entry;
+        }
+    }
+    return result;
+}
+
+} // namespace quaxis::relay
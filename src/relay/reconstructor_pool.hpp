@@ -0,0 +1,187 @@
+/**
+ * @file reconstructor_pool.hpp
+ * @brief Пул реконструкторов блоков, находящихся в приёме
+ *
+ * RelayManager держит несколько блоков в реконструкции одновременно
+ * (конкурирующие tip, повторы от разных пиров). Реконструкторы создаются
+ * один раз при старте и переиспользуются через BlockReconstructor::reset:
+ * - Арена чанков FecDecoder выделяется сразу под максимальный блок
+ *   FIBRE, буфер собранного блока растёт до самого большого блока и
+ *   дальше не освобождается
+ * - Поиск по хешу - открытая адресация с линейным пробированием по
+ *   64-битному префиксу хеша (таблица вдвое больше пула), коллизии
+ *   префикса разрешаются сравнением полного хеша
+ *
+ * Так путь пакета (поиск, новый блок, сборка) не выделяет память.
+ *
+ * Thread-safety: нет, пул используется под мьютексом RelayManager.
+ */
+
+#pragma once
+
+#include "../core/types.hpp"
+#include "../bitcoin/block.hpp"
+#include "block_reconstructor.hpp"
+#include "compact_block.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace quaxis::relay {
+
+/**
+ * @brief Блок в реконструкции: реконструктор и состояние менеджера
+ */
+struct InflightBlock {
+    /// @brief Реконструктор (callbacks задаются один раз для записи)
+    BlockReconstructor reconstructor;
+
+    /// @brief Момент первого пакета блока
+    std::chrono::steady_clock::time_point started_at;
+
+    /// @brief Хотя бы один чанк пришёл от trusted пира
+    bool trusted{false};
+
+    /// @brief Header-first: заголовок, ушедший в spy mining, до проверки тела
+    std::optional<bitcoin::BlockHeader> speculative_header;
+
+    /// @brief Момент чанка, после которого блок можно декодировать
+    std::chrono::steady_clock::time_point decodable_at;
+
+    /// @brief Запись у потока декодирования: владелец её не трогает до ответа
+    bool decoding{false};
+    
+    /// @brief Набросок блока (mempool_prefill) и чанков, синтезированных по нему
+    SketchAssembler sketch;
+    uint16_t prefilled_chunks{0};
+    
+    /// @brief Синтезированные чанки дали чужой блок (коллизия short id)
+    bool prefill_failed{false};
+
+    /// @brief Запись занята блоком
+    bool active{false};
+};
+
+/**
+ * @brief Фиксированный пул InflightBlock с плоским индексом по хешу
+ */
+class ReconstructorPool {
+public:
+    /// @brief Наибольшая ёмкость (индекс записи 16-битный)
+    static constexpr std::size_t MAX_CAPACITY = 1024;
+
+    /**
+     * @brief Создать пул
+     *
+     * @param capacity Блоков одновременно (1..MAX_CAPACITY)
+     */
+    explicit ReconstructorPool(std::size_t capacity);
+
+    ReconstructorPool(const ReconstructorPool&) = delete;
+    ReconstructorPool& operator=(const ReconstructorPool&) = delete;
+
+    /**
+     * @brief Найти блок в реконструкции
+     *
+     * @return Запись или nullptr
+     */
+    [[nodiscard]] InflightBlock* find(const Hash256& block_hash) noexcept;
+
+    /**
+     * @brief Занять запись под новый блок
+     *
+     * Реконструктор сбрасывается в этот момент, а не при release: запись,
+     * освобождённая из собственного callback, остаётся целой до возврата.
+     *
+     * @param block_hash Хеш блока (не должен быть в пуле)
+     * @param height Высота блока
+     * @param fec_params Параметры FEC
+     * @param timeout_ms Таймаут реконструкции
+     * @return Запись или nullptr, если пул заполнен
+     */
+    [[nodiscard]] InflightBlock* acquire(
+        const Hash256& block_hash,
+        uint32_t height,
+        const FecParams& fec_params,
+        uint32_t timeout_ms
+    );
+
+    /**
+     * @brief Освободить запись блока (нет в пуле - ничего не делает)
+     */
+    void release(const Hash256& block_hash) noexcept;
+
+    /**
+     * @brief Занятая запись с самым ранним started_at (пустой пул - nullptr)
+     *
+     * Записи в декодировании (decoding) не вытесняются.
+     */
+    [[nodiscard]] InflightBlock* oldest() noexcept;
+
+    /**
+     * @brief Обойти занятые записи
+     *
+     * fn может освобождать записи (в том числе текущую).
+     */
+    template<typename Fn>
+    void for_each(Fn&& fn) {
+        for (auto& entry : entries_) {
+            if (entry.active) {
+                fn(entry);
+            }
+        }
+    }
+
+    /**
+     * @brief Обойти все записи, включая свободные (настройка callbacks)
+     */
+    template<typename Fn>
+    void for_each_entry(Fn&& fn) {
+        for (auto& entry : entries_) {
+            fn(entry);
+        }
+    }
+
+    /**
+     * @brief Занято записей
+     */
+    [[nodiscard]] std::size_t size() const noexcept { return size_; }
+
+    /**
+     * @brief Ёмкость пула
+     */
+    [[nodiscard]] std::size_t capacity() const noexcept { return entries_.size(); }
+
+private:
+    /// @brief Ячейка индекса: префикс хеша и номер записи
+    struct Slot {
+        uint64_t prefix{0};
+        uint16_t entry{EMPTY};
+    };
+
+    static constexpr uint16_t EMPTY = 0xFFFF;
+
+    /**
+     * @brief Ячейка блока или пустая ячейка, где цепочка пробирования кончилась
+     */
+    [[nodiscard]] std::size_t probe(const Hash256& block_hash, uint64_t prefix) const noexcept;
+
+    std::vector<InflightBlock> entries_;
+    std::vector<Slot> index_;
+    std::vector<uint16_t> free_;
+    std::size_t mask_{0};
+    std::size_t size_{0};
+};
+
+/**
+ * @brief 64-битный префикс хеша блока для индекса
+ *
+ * Первые 8 байт во внутреннем порядке: нули PoW - в старших (последних)
+ * байтах, начало хеша равномерно.
+ */
+[[nodiscard]] uint64_t block_hash_prefix(const Hash256& block_hash) noexcept;
+
+} // namespace quaxis::relay
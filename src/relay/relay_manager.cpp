@@ -4,30 +4,185 @@
  */
 
 #include "relay_manager.hpp"
+#include "../core/async_log.hpp"
+#include "../core/latency_trace.hpp"
+#include "../core/seqlock.hpp"
+#include "../core/stats_counter.hpp"
+#include "../core/thread_plan.hpp"
+#include "../core/validation/pow_validator.hpp"
+#include "chunk_handoff.hpp"
+#include "decode_pipeline.hpp"
+#include "merkle_verifier.hpp"
+#include "reconstructor_pool.hpp"
+#include "tx_cache.hpp"
+#include "xdp_socket.hpp"
+#include "../shm/placement.hpp"
 
 #include <algorithm>
+#include <array>
+#include <bit>
+#include <cerrno>
 #include <chrono>
-#include <map>
+#include <cmath>
+#include <memory>
+#include <random>
 #include <set>
+#include <span>
+#include <thread>
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+#endif
 
 namespace quaxis::relay {
 
+namespace {
+
+/// @brief Период таймера: таймауты реконструкции, keepalive, stale пиров
+constexpr auto TIMER_TICK = std::chrono::milliseconds(10);
+
+/// @brief Событий за один epoll_wait
+constexpr int MAX_EPOLL_EVENTS = 32;
+
+/// @brief Датаграмм за один опрос готового пира
+constexpr std::size_t PEER_POLL_BUDGET = 256;
+
+/// @brief Блоков в таблице ранга первых чанков
+constexpr std::size_t ARRIVAL_HISTORY = 16;
+
+/// @brief Доля очереди передачи под быструю полосу (FibreHeader::is_priority)
+constexpr std::size_t PRIORITY_INBOX_DIVISOR = 8;
+
+/// @brief Пиров, ранжируемых в одном блоке (остальные не учитываются)
+constexpr std::size_t MAX_RANKED_PEERS = 16;
+
+/// @brief Пир не дальше стольких мс от лучшего по отставанию - быстрый
+constexpr double FAST_PEER_MARGIN_MS = 2.0;
+
+/// @brief Отключённый медленный пир возвращается через
+constexpr auto SLOW_PEER_COOLDOWN = std::chrono::minutes(10);
+
+/// @brief Нижний предел интервала keepalive политики (мс)
+constexpr uint32_t MIN_KEEPALIVE_INTERVAL_MS = 10;
+
+/**
+ * @brief Приход первых чанков блока от пиров (ранг доставки)
+ */
+struct BlockArrival {
+    Hash256 hash{};
+    std::chrono::steady_clock::time_point first_at;
+    std::array<const RelayPeer*, MAX_RANKED_PEERS> seen{};
+    uint8_t seen_count{0};
+};
+
+/**
+ * @brief Бюджет датаграмм опроса по приоритету пира
+ */
+[[nodiscard]] std::size_t poll_budget(PeerPriority priority) noexcept {
+    switch (priority) {
+        case PeerPriority::Fast: return PEER_POLL_BUDGET * 2;
+        case PeerPriority::Slow: return PEER_POLL_BUDGET / 4;
+        default: return PEER_POLL_BUDGET;
+    }
+}
+
+} // anonymous namespace
+
 // =============================================================================
 // Реализация RelayManager
 // =============================================================================
 
 struct RelayManager::Impl {
+    /**
+     * @brief Поток приёма: свои пиры, свои блоки
+     *
+     * Блок реконструирует один поток - владелец по хешу (shard_for); чанк
+     * чужого блока уходит владельцу через inbox. Состояние потока (пул,
+     * дедупликация, ранг) трогает только он сам.
+     */
+    struct Shard {
+        Shard(std::size_t shard_index, std::size_t inflight_capacity, std::size_t queue_size)
+            : index(shard_index)
+            , inflight(inflight_capacity)
+            , inbox(queue_size)
+            , priority_inbox(queue_size / PRIORITY_INBOX_DIVISOR)
+            , decode_tasks(inflight_capacity)
+            , decode_done(inflight_capacity)
+        {}
+        
+        /// @brief Номер потока (0 - ещё и таймер пиров, AF_XDP, политика)
+        std::size_t index;
+        
+        /// @brief CPU потока (-1 - без привязки)
+        int cpu{-1};
+        
+        /// @brief Блоки в реконструкции (фиксированный пул, без аллокаций на пакет)
+        ReconstructorPool inflight;
+        
+        /// @brief Хеши уже полученных блоков (для дедупликации)
+        std::set<Hash256> received_blocks;
+        
+        /// @brief Пир, пакет которого сейчас обрабатывается (счётчики гонки в callbacks)
+        RelayPeer* packet_source{nullptr};
+        
+        /// @brief Ранг доставки: первые чанки последних блоков от каждого пира
+        std::array<BlockArrival, ARRIVAL_HISTORY> arrivals{};
+        std::size_t next_arrival{0};
+        
+        /// @brief Чанки блоков этого потока, принятые другими потоками
+        ChunkHandoffQueue inbox;
+        
+        /// @brief То же для быстрой полосы: разбирается раньше inbox и
+        /// между опросами пиров
+        ChunkHandoffQueue priority_inbox;
+        
+        /// @brief Владельцы, которым поток передал чанки с последнего пробуждения
+        uint64_t wake_mask{0};
+        
+        /// @brief Блоки потоку декодирования и его ответы (по записи пула
+        /// не больше одной задачи - кольца не переполняются)
+        SpscRing<DecodeTask> decode_tasks;
+        SpscRing<DecodeOutcome> decode_done;
+        
+        /// @brief Транзакции кеша для наброска (буферы переживают блок)
+        std::vector<CachedTx> prefill_txs;
+        std::vector<ByteSpan> prefill_spans;
+        
+        /// @brief Поток
+        std::thread thread;
+
+#ifdef __linux__
+        /// @brief Цикл событий: сокеты своих пиров, таймер и пробуждение
+        int epoll_fd{-1};
+        int timer_fd{-1};
+        int wake_fd{-1};
+#endif
+    };
+    
     /// @brief Конфигурация
     RelayConfig config_;
     
-    /// @brief Пиры
-    std::vector<std::unique_ptr<RelayPeer>> peers_;
+    /// @brief Параметры сети и проверка PoW header-first
+    core::ChainParams chain_params_;
+    core::validation::PowValidator pow_validator_{chain_params_};
+    
+    /// @brief Пиры (потоки держат свои копии списка, см. peers_version_)
+    std::vector<std::shared_ptr<RelayPeer>> peers_;
+    
+    /// @brief Поток приёма каждого пира (параллельно peers_)
+    std::vector<std::size_t> peer_shards_;
     
-    /// @brief Активные реконструкторы блоков (по хешу блока)
-    std::map<Hash256, std::unique_ptr<BlockReconstructor>> reconstructors_;
+    /// @brief Версия списка пиров и распределения (растёт при изменении)
+    std::atomic<uint64_t> peers_version_{0};
     
-    /// @brief Хеши уже полученных блоков (для дедупликации)
-    std::set<Hash256> received_blocks_;
+    /// @brief Потоки приёма (receive_threads; с AF_XDP - один)
+    std::vector<std::unique_ptr<Shard>> shards_;
+    
+    /// @brief Медленные пиры, отключённые политикой, и время отключения
+    std::vector<std::pair<const RelayPeer*, std::chrono::steady_clock::time_point>> dropped_peers_;
     
     /// @brief Callback для header
     RelayHeaderCallback header_callback_;
@@ -35,14 +190,45 @@ struct RelayManager::Impl {
     /// @brief Callback для блока
     RelayBlockCallback block_callback_;
     
-    /// @brief Рабочий поток
-    std::thread worker_thread_;
+    /// @brief Header-first: callbacks spy mining
+    RelaySpeculativeCallback speculative_callback_;
+    RelayBlockStateCallback block_state_callback_;
     
     /// @brief Флаг работы
     std::atomic<bool> running_{false};
     
-    /// @brief Статистика
+    /// @brief Поток FEC декодирования (decode_thread) и счётчик его пробуждений
+    std::thread decode_thread_;
+    std::atomic<uint64_t> decode_signal_{0};
+    
+    /// @brief Кеш mempool узла (mempool_prefill; nullptr - выключен)
+    std::unique_ptr<TxCache> tx_cache_;
+    
+    /// @brief Проверка merkle root собранного блока на пуле потоков
+    MerkleVerifier merkle_verifier_;
+
+#ifdef __linux__
+    /// @brief AF_XDP приём (nullptr - не настроен или не открылся)
+    std::unique_ptr<XdpSocket> xdp_;
+#endif
+    
+    /// @brief Счётчики пути чанка (без mutex_, добавляются в снимок)
+    core::RelaxedCounter duplicate_blocks_;
+    core::RelaxedCounter duplicate_chunks_;
+    core::RelaxedCounter handoff_chunks_;
+    core::RelaxedCounter handoff_drops_;
+    core::RelaxedCounter priority_chunks_;
+    core::RelaxedCounter sketches_;
+    core::RelaxedCounter prefilled_chunks_;
+    
+    /// @brief Статистика (под mutex_; читатели - через снимки)
     RelayManagerStats stats_;
+    core::Seqlock<RelayManagerStats> stats_snapshot_;
+    RelayLatencyHistograms latency_;
+    core::Seqlock<RelayLatencyHistograms> latency_snapshot_;
+    std::atomic<std::shared_ptr<const std::vector<PeerSnapshot>>> peer_snapshots_{
+        std::make_shared<const std::vector<PeerSnapshot>>()};
+    std::chrono::steady_clock::time_point peers_published_at_;
     
     /// @brief Время запуска
     std::chrono::steady_clock::time_point start_time_;
@@ -50,175 +236,1156 @@ struct RelayManager::Impl {
     /// @brief Последняя высота блока
     std::atomic<uint32_t> last_block_height_{0};
     
-    /// @brief Мьютекс
+    /// @brief Мьютекс: список пиров, статистика, callbacks (не путь чанка)
     mutable std::mutex mutex_;
     
     /**
      * @brief Конструктор
      */
-    explicit Impl(const RelayConfig& config)
+    Impl(const RelayConfig& config, const core::ChainParams& chain_params)
         : config_(config)
-    {}
+        , chain_params_(chain_params)
+        , merkle_verifier_(config.verify_threads)
+    {
+        // AF_XDP раздаёт датаграммы пирам из одного потока: пир не
+        // должен одновременно опрашиваться другим
+        std::size_t threads = std::clamp<std::size_t>(config_.receive_threads, 1, 64);
+#ifdef __linux__
+        if (!config_.xdp_interface.empty()) {
+            threads = 1;
+        }
+#else
+        threads = 1;
+#endif
+        if (config_.mempool_prefill) {
+            tx_cache_ = std::make_unique<TxCache>(config_.tx_cache_size);
+        }
+        
+        std::vector<int> cpus;
+        if (auto parsed = core::parse_cpu_set(config_.receive_cpus)) {
+            cpus = std::move(*parsed);
+        }
+        
+        for (std::size_t i = 0; i < threads; ++i) {
+            auto shard = std::make_unique<Shard>(i, config_.max_inflight_blocks, config_.handoff_queue_size);
+            if (i < cpus.size()) {
+                shard->cpu = cpus[i];
+            } else if (i == 0 && cpus.empty()) {
+                shard->cpu = config_.worker_cpu_affinity;
+            }
+            
+            // Callbacks задаются один раз: при reset записи они сохраняются
+            Shard& owner = *shard;
+            owner.inflight.for_each_entry([this, &owner](InflightBlock& entry) {
+                entry.reconstructor.set_deferred_decode(config_.decode_thread);
+                entry.reconstructor.set_header_callback(
+                    [this, &owner, &entry](const bitcoin::BlockHeader& header, uint32_t height, const Hash256& hash) {
+                        on_header_received(owner, entry, header, height, hash);
+                    }
+                );
+                
+                entry.reconstructor.set_block_callback(
+                    [this, &owner, &entry](ByteSpan data, uint32_t height, const Hash256& hash) {
+                        on_block_received(owner, entry, data, height, hash);
+                    }
+                );
+                
+                entry.reconstructor.set_timeout_callback(
+                    [this, &owner, &entry](uint32_t height, const Hash256& hash, std::size_t, std::size_t) {
+                        on_reconstruction_timeout(owner, entry, height, hash);
+                    }
+                );
+            });
+            shards_.push_back(std::move(shard));
+        }
+        stats_.receive_threads = shards_.size();
+    }
     
     /**
-     * @brief Обработать пакет от пира
+     * @brief Поток приёма, владеющий блоком
      */
-    void on_packet(const FibrePacket& packet) {
-        std::lock_guard<std::mutex> lock(mutex_);
+    [[nodiscard]] Shard& shard_for(const Hash256& block_hash) noexcept {
+        if (shards_.size() == 1) {
+            return *shards_[0];
+        }
+        return *shards_[block_hash_prefix(block_hash) % shards_.size()];
+    }
+    
+    /**
+     * @brief Поток приёма вызывающего потока (вне потоков приёма - первый)
+     */
+    [[nodiscard]] Shard& current_shard() noexcept {
+        if (t_shard_ && t_shard_->index < shards_.size() && shards_[t_shard_->index].get() == t_shard_) {
+            return *t_shard_;
+        }
+        return *shards_[0];
+    }
+    
+    /// @brief Поток приёма текущего потока (ставит shard_loop)
+    static thread_local Shard* t_shard_;
+    
+    /// @brief Текущий поток - поток декодирования (ставит decode_loop)
+    static thread_local bool t_decoder_;
+    
+    /**
+     * @brief Обработать пакет от пира (поток, опросивший пира)
+     *
+     * Чанк своего блока обрабатывается сразу, чужого - копируется в
+     * очередь владельца; владелец будится после опроса пира
+     * (flush_wakes), один раз на всплеск. Чанк быстрой полосы
+     * (FibreHeader::is_priority) идёт в priority_inbox владельца, и
+     * тот будится сразу: header не ждёт, пока поток дочитает тело блоков.
+     *
+     * @param trusted Пакет от trusted пира: его header годится для spy mining
+     * @param source Пир-источник (nullptr - без учёта гонки)
+     */
+    void on_packet(const FibrePacketView& packet, bool trusted, RelayPeer* source) {
+        const auto now = std::chrono::steady_clock::now();
+        const bool priority = packet.header.is_priority();
+        if (priority) {
+            priority_chunks_.add();
+        }
+        Shard& self = current_shard();
+        Shard& owner = shard_for(packet.header.block_hash);
+        if (&owner == &self) {
+            accept_chunk(self, packet, trusted, source, now);
+            return;
+        }
+        ChunkHandoffQueue& queue = priority ? owner.priority_inbox : owner.inbox;
+        if (!queue.try_push(packet, source, trusted, now)) {
+            handoff_drops_.add();
+            return;
+        }
+        handoff_chunks_.add();
+        self.wake_mask |= uint64_t{1} << owner.index;
+        if (priority) {
+            flush_wakes(self);
+        }
+    }
+    
+    /**
+     * @brief Разбудить владельцев, получивших чанки от этого потока
+     */
+    void flush_wakes(Shard& self) {
+#ifdef __linux__
+        while (self.wake_mask != 0) {
+            const auto index = static_cast<std::size_t>(std::countr_zero(self.wake_mask));
+            self.wake_mask &= self.wake_mask - 1;
+            wake(*shards_[index]);
+        }
+#else
+        self.wake_mask = 0;
+#endif
+    }
+    
+    /**
+     * @brief Обработать чанки, переданные потоку другими потоками приёма
+     */
+    void drain_inbox(Shard& self) {
+        drain_priority(self);
+        self.inbox.drain([this, &self](const ChunkHandoff& chunk) {
+            accept_chunk(self, chunk.view(), chunk.trusted, chunk.source, chunk.received_at);
+        });
+    }
+    
+    /**
+     * @brief Обработать переданные чанки быстрой полосы
+     *
+     * Вызывается и между опросами пиров: пустая очередь - одна загрузка
+     * atomic.
+     */
+    void drain_priority(Shard& self) {
+        self.priority_inbox.drain([this, &self](const ChunkHandoff& chunk) {
+            accept_chunk(self, chunk.view(), chunk.trusted, chunk.source, chunk.received_at);
+        });
+    }
+    
+    /**
+     * @brief Чанк блока этого потока
+     *
+     * Чанки одного блока от всех пиров идут в один реконструктор; каждый
+     * пакет засчитывается пиру как выигравший или проигравший гонку.
+     *
+     * @param received_at Момент приёма (для ранга доставки)
+     */
+    void accept_chunk(Shard& shard, const FibrePacketView& packet, bool trusted, RelayPeer* source,
+                      std::chrono::steady_clock::time_point received_at) {
+        // Набросок без кеша mempool бесполезен
+        if (packet.header.is_sketch() && !tx_cache_) {
+            return;
+        }
+        rank_arrival(shard, packet.header.block_hash, source, received_at);
         
-        // Ищем или создаём реконструктор
-        auto it = reconstructors_.find(packet.header.block_hash);
+        // Ищем или занимаем запись пула
+        InflightBlock* entry = shard.inflight.find(packet.header.block_hash);
         
-        if (it == reconstructors_.end()) {
+        if (!entry) {
             // Новый блок
             
             // Проверяем, не получили ли мы уже этот блок
-            if (received_blocks_.count(packet.header.block_hash) > 0) {
-                ++stats_.duplicate_blocks;
+            if (shard.received_blocks.count(packet.header.block_hash) > 0) {
+                duplicate_blocks_.add();
+                duplicate_chunks_.add();
+                record_race(source, PeerRaceEvent::ChunkDuplicate);
                 return;
             }
             
-            // Создаём реконструктор
             FecParams fec_params;
             fec_params.data_chunk_count = packet.header.data_chunks;
             fec_params.fec_chunk_count = packet.header.fec_chunks();
+            fec_params.scheme = config_.fec_scheme == "xor"
+                ? FecScheme::Xor
+                : FecScheme::CauchyReedSolomon;
             
-            auto reconstructor = std::make_unique<BlockReconstructor>(
+            // Пул заполнен - вытесняем самый старый незавершённый блок
+            if (shard.inflight.size() == shard.inflight.capacity()) {
+                if (auto* oldest = shard.inflight.oldest()) {
+                    shard.inflight.release(oldest->reconstructor.block_hash());
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    ++stats_.evicted_blocks;
+                    publish_stats();
+                }
+            }
+            
+            entry = shard.inflight.acquire(
                 packet.header.block_hash,
                 packet.header.block_height,
                 fec_params,
                 config_.reconstruction_timeout
             );
-            
-            // Устанавливаем callbacks
-            reconstructor->set_header_callback(
-                [this](const bitcoin::BlockHeader& header, uint32_t height, const Hash256&) {
-                    on_header_received(header, height);
-                }
-            );
-            
-            reconstructor->set_block_callback(
-                [this](const std::vector<uint8_t>& data, uint32_t height, const Hash256& hash) {
-                    on_block_received(data, height, hash);
-                }
-            );
-            
-            reconstructor->set_timeout_callback(
-                [this](uint32_t height, const Hash256& hash, std::size_t, std::size_t) {
-                    on_reconstruction_timeout(height, hash);
+            if (!entry) {
+                return;
+            }
+        }
+        
+        // Блок уже у потока декодирования: чанков хватает, этот опоздал
+        if (entry->decoding) {
+            if (!packet.header.is_sketch()) {
+                duplicate_chunks_.add();
+                record_race(source, PeerRaceEvent::ChunkDuplicate);
+            }
+            return;
+        }
+        
+        if (trusted) {
+            entry->trusted = true;
+        }
+        
+        if (packet.header.is_sketch()) {
+            accept_sketch(shard, *entry, packet, source, received_at);
+            return;
+        }
+        
+        // Передаём пакет реконструктору; callbacks header / блока
+        // засчитывают победу packet_source
+        entry->decodable_at = received_at;
+        shard.packet_source = source;
+        const ChunkOutcome outcome = entry->reconstructor.accept(packet);
+        shard.packet_source = nullptr;
+        
+        if (outcome == ChunkOutcome::Accepted) {
+            record_race(source, PeerRaceEvent::ChunkFirst);
+            if (config_.decode_thread && entry->reconstructor.can_try_decode()) {
+                schedule_decode(shard, *entry, source);
+            }
+        } else if (outcome == ChunkOutcome::Duplicate) {
+            duplicate_chunks_.add();
+            record_race(source, PeerRaceEvent::ChunkDuplicate);
+        }
+    }
+    
+    /**
+     * @brief Часть наброска блока (mempool_prefill)
+     *
+     * Когда набросок собран, транзакции находятся в кеше mempool, и все
+     * data чанки, целиком покрытые ими, добавляются в реконструктор как
+     * принятые - сети остаётся прислать только прочие (или FEC за них).
+     * Набросок, не совпавший с хешем или раскладкой блока, отбрасывается.
+     */
+    void accept_sketch(Shard& shard, InflightBlock& entry, const FibrePacketView& packet, RelayPeer* source,
+                       std::chrono::steady_clock::time_point received_at) {
+        if (entry.sketch.complete() || entry.sketch.add_part(packet.payload) != ChunkOutcome::Accepted ||
+            !entry.sketch.complete()) {
+            return;
+        }
+        const BlockSketch& sketch = entry.sketch.sketch();
+        if (sketch.header.hash() != packet.header.block_hash ||
+            sketch.data_chunk_count() != packet.header.data_chunks) {
+            return;
+        }
+        sketches_.add();
+        
+        tx_cache_->match(sketch, shard.prefill_txs);
+        shard.prefill_spans.clear();
+        for (const auto& tx : shard.prefill_txs) {
+            shard.prefill_spans.push_back(tx ? ByteSpan(*tx) : ByteSpan{});
+        }
+        
+        // Callbacks header / блока засчитывают победу пиру наброска; счётчик
+        // растёт до add_chunk - блок может собраться на этом же чанке
+        entry.decodable_at = received_at;
+        shard.packet_source = source;
+        synthesize_chunks(sketch, shard.prefill_spans, [&](uint16_t chunk_id, ByteSpan data) {
+            ++entry.prefilled_chunks;
+            if (!entry.reconstructor.on_chunk(chunk_id, false, data)) {
+                --entry.prefilled_chunks;
+            }
+        });
+        shard.packet_source = nullptr;
+        
+        prefilled_chunks_.add(entry.prefilled_chunks);
+        if (entry.prefilled_chunks > 0 && config_.decode_thread && entry.active &&
+            entry.reconstructor.can_try_decode()) {
+            schedule_decode(shard, entry, source);
+        }
+    }
+    
+    /**
+     * @brief Отдать декодируемый блок потоку декодирования
+     *
+     * До ответа (drain_decoded) запись не вытесняется, таймаут её не
+     * проверяет, а чанки блока считаются опоздавшими.
+     */
+    void schedule_decode(Shard& shard, InflightBlock& entry, RelayPeer* source) {
+        entry.decoding = true;
+        if (shard.decode_tasks.try_push({&entry, entry.reconstructor.block_hash(), source})) {
+            decode_signal_.fetch_add(1, std::memory_order_release);
+            decode_signal_.notify_one();
+            return;
+        }
+        // Кольцо заполнено (не бывает: задача на запись одна) - собираем сами
+        entry.decoding = false;
+        shard.packet_source = source;
+        (void)entry.reconstructor.try_complete();
+        shard.packet_source = nullptr;
+    }
+    
+    /**
+     * @brief Исходы декодирования: освободить записи пула владельца
+     */
+    static void drain_decoded(Shard& shard) {
+        shard.decode_done.drain([&shard](const DecodeOutcome& outcome) {
+            outcome.entry->decoding = false;
+            if (outcome.complete && !outcome.entry->prefill_failed) {
+                shard.received_blocks.insert(outcome.block_hash);
+                record_race(outcome.source, PeerRaceEvent::BlockCompleted);
+            }
+            // Несобранный блок (decode не удался) тоже освобождается
+            shard.inflight.release(outcome.block_hash);
+        });
+    }
+    
+    /**
+     * @brief Цикл потока декодирования
+     *
+     * Забирает задачи всех потоков приёма, собирает блоки (callbacks
+     * блока вызываются здесь) и будит владельцев с ответами. Без задач
+     * спит на decode_signal_, при worker_busy_poll - крутится.
+     */
+    void decode_loop() {
+        t_decoder_ = true;
+        while (running_.load(std::memory_order_relaxed)) {
+            const uint64_t seen = decode_signal_.load(std::memory_order_acquire);
+            std::size_t decoded = 0;
+            for (auto& shard : shards_) {
+                Shard& owner = *shard;
+                const std::size_t count = owner.decode_tasks.drain([&owner](const DecodeTask& task) {
+                    const bool complete = task.entry->reconstructor.try_complete();
+                    [[maybe_unused]] const bool pushed = owner.decode_done.try_push(
+                        {task.entry, task.block_hash, task.source, complete});
+                });
+                if (count > 0) {
+#ifdef __linux__
+                    wake(owner);
+#endif
+                    decoded += count;
                 }
-            );
-            
-            it = reconstructors_.emplace(
-                packet.header.block_hash,
-                std::move(reconstructor)
-            ).first;
+            }
+            if (decoded == 0 && !config_.worker_busy_poll) {
+                decode_signal_.wait(seen, std::memory_order_acquire);
+            }
+        }
+        t_decoder_ = false;
+    }
+    
+    /**
+     * @brief Первый чанк блока от пира: засчитать отставание от самого раннего
+     *
+     * Таблица переживает реконструкцию блока: пир, приславший первый чанк
+     * уже собранного блока, тоже получает своё (большое) отставание.
+     */
+    static void rank_arrival(Shard& shard, const Hash256& hash, RelayPeer* source,
+                             std::chrono::steady_clock::time_point received_at) {
+        if (!source) {
+            return;
         }
         
-        // Передаём пакет реконструктору
-        it->second->on_packet(packet);
+        BlockArrival* arrival = nullptr;
+        for (auto& candidate : shard.arrivals) {
+            if (candidate.seen_count > 0 && candidate.hash == hash) {
+                arrival = &candidate;
+                break;
+            }
+        }
+        if (!arrival) {
+            arrival = &shard.arrivals[shard.next_arrival++ % shard.arrivals.size()];
+            arrival->hash = hash;
+            arrival->first_at = received_at;
+            arrival->seen_count = 0;
+        }
+        
+        const auto seen_end = arrival->seen.begin() + arrival->seen_count;
+        if (std::find(arrival->seen.begin(), seen_end, source) != seen_end ||
+            arrival->seen_count == arrival->seen.size()) {
+            return;
+        }
+        arrival->seen[arrival->seen_count++] = source;
+        source->record_block_arrival(received_at - arrival->first_at);
+    }
+    
+    /**
+     * @brief Засчитать исход гонки пиру
+     */
+    static void record_race(RelayPeer* source, PeerRaceEvent event) noexcept {
+        if (source) {
+            source->record_race(event);
+        }
     }
     
     /**
      * @brief Header получен
      */
-    void on_header_received(const bitcoin::BlockHeader& header, uint32_t height) {
+    void on_header_received(
+        Shard& shard,
+        InflightBlock& entry,
+        const bitcoin::BlockHeader& header,
+        uint32_t height,
+        const Hash256& hash
+    ) {
+        std::lock_guard<std::mutex> lock(mutex_);
         last_block_height_.store(height);
         
-        // Обновляем статистику latency
-        // (упрощённо - можно улучшить)
+        record_latency(latency_.header_latency, stats_.avg_header_latency_ms, entry.started_at);
+        record_race(shard.packet_source, PeerRaceEvent::HeaderFirst);
         
         if (header_callback_) {
             header_callback_(header, BlockSource::UdpRelay);
         }
+        
+        if (config_.header_first && entry.trusted) {
+            start_speculative(entry, header, height, hash);
+        }
     }
     
+    /**
+     * @brief Header-first: отдать заголовок в spy mining (под mutex_)
+     *
+     * Заголовок должен хешироваться в объявленный FIBRE хеш и нести PoW
+     * по nBits в пределах pow_limit сети - иначе один пакет от trusted
+     * пира переключил бы все ASIC на произвольный tip.
+     */
+    void start_speculative(
+        InflightBlock& entry,
+        const bitcoin::BlockHeader& header,
+        uint32_t height,
+        const Hash256& hash
+    ) {
+        if (header.hash() != hash ||
+            !pow_validator_.validate_bits(header.bits) ||
+            !pow_validator_.check_hash_target(hash, header.bits)) {
+            ++stats_.rejected_headers;
+            publish_stats();
+            return;
+        }
+        
+        entry.speculative_header = header;
+        ++stats_.speculative_headers;
+        publish_stats();
+        
+        if (speculative_callback_) {
+            speculative_callback_(header, height, bitcoin::block_subsidy(height + 1));
+        }
+    }
+    
+    /**
+     * @brief Тело блока совпадает с заголовком
+     *
+     * Header-first сверяет с заголовком spy mining, синтезированные чанки -
+     * с заголовком самого блока: транзакция кеша под чужим short id
+     * (коллизия 48 бит) даёт другой merkle root. Считается один раз на
+     * блок, на пуле MerkleVerifier и до mutex_.
+     */
+    bool body_matches_header(const InflightBlock& entry, ByteSpan data) {
+        if (entry.speculative_header) {
+            return merkle_verifier_.matches(data, *entry.speculative_header);
+        }
+        auto header = bitcoin::BlockHeader::deserialize(data);
+        return header && merkle_verifier_.matches(data, *header);
+    }
+
     /**
      * @brief Блок полностью получен
      */
     void on_block_received(
-        const std::vector<uint8_t>& data,
+        Shard& shard,
+        InflightBlock& entry,
+        ByteSpan data,
         uint32_t height,
         const Hash256& hash
     ) {
-        // Помечаем блок как полученный
-        received_blocks_.insert(hash);
+        core::trace_block_arrival(core::TraceStage::RelayBlock, hash);
+        
+        // Подтверждение spy mining ждёт только эту проверку
+        const bool verify = entry.speculative_header || entry.prefilled_chunks > 0;
+        const bool body_valid = !verify || body_matches_header(entry, data);
+        
+        // Чужой блок из синтезированных чанков не помечается полученным:
+        // оставшиеся чанки пиров соберут его заново, без наброска
+        entry.prefill_failed = entry.prefilled_chunks > 0 && !body_valid;
+        
+        // В потоке декодирования запись освобождает владелец (drain_decoded)
+        if (!t_decoder_) {
+            // Помечаем блок как полученный
+            if (!entry.prefill_failed) {
+                shard.received_blocks.insert(hash);
+                record_race(shard.packet_source, PeerRaceEvent::BlockCompleted);
+            }
+            
+            // Запись сбрасывается только при следующем acquire: data остаётся
+            // валидной до возврата из callback
+            shard.inflight.release(hash);
+        }
+        
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (entry.prefill_failed) {
+            ++stats_.prefill_mismatches;
+            publish_stats();
+            return;
+        }
         ++stats_.blocks_received;
+        record_latency(latency_.reconstruction_latency, stats_.avg_reconstruction_latency_ms, entry.started_at);
+        record_latency(latency_.decode_latency, stats_.avg_decode_latency_ms, entry.decodable_at);
+        
+        if (entry.speculative_header) {
+            if (!body_valid) {
+                ++stats_.invalid_blocks;
+            }
+            publish_stats();
+            if (block_state_callback_) {
+                block_state_callback_(hash, height, body_valid ? RelayBlockState::Confirmed : RelayBlockState::Invalid);
+            }
+            if (!body_valid) {
+                return;
+            }
+        } else {
+            publish_stats();
+        }
         
         // Вызываем callback
         if (block_callback_) {
             block_callback_(data, height, BlockSource::UdpRelay);
         }
-        
-        // Удаляем реконструктор
-        reconstructors_.erase(hash);
     }
     
     /**
      * @brief Таймаут реконструкции
      */
-    void on_reconstruction_timeout(uint32_t /* height */, const Hash256& hash) {
+    void on_reconstruction_timeout(Shard& shard, InflightBlock& entry, uint32_t /* height */, const Hash256& hash) {
+        // Speculative tip без тела не отменяется: его подтвердит или
+        // сменит следующий источник (SHM, следующий блок relay)
+        const auto started_at = entry.started_at;
+        shard.inflight.release(hash);
+        
+        std::lock_guard<std::mutex> lock(mutex_);
         ++stats_.reconstruction_timeouts;
-        reconstructors_.erase(hash);
+        // Ядро теряло датаграммы, пока блок собирался: чанки потеряны
+        // у нас, а не в сети
+        if (std::any_of(peers_.begin(), peers_.end(), [started_at](const auto& peer) {
+                return peer->last_drop_time() >= started_at;
+            })) {
+            ++stats_.drop_timeouts;
+        }
+        publish_stats();
     }
     
     /**
-     * @brief Рабочий цикл
+     * @brief Учесть латентность от момента since до сейчас (под mutex_)
      */
-    void worker_loop() {
-        while (running_.load()) {
-            // Опрашиваем все пиры
-            for (auto& peer : peers_) {
-                if (peer->is_connected()) {
-                    peer->poll(100);
+    void record_latency(core::LatencyHistogram& histogram, double& average_ms,
+                        std::chrono::steady_clock::time_point since) {
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - since);
+        histogram.record(static_cast<uint64_t>(elapsed.count()));
+        average_ms = static_cast<double>(histogram.sum()) / static_cast<double>(histogram.count()) / 1e6;
+        latency_snapshot_.store(latency_);
+    }
+    
+    /**
+     * @brief Опубликовать снимок счётчиков (под mutex_)
+     */
+    void publish_stats() {
+#ifdef __linux__
+        if (xdp_) {
+            stats_.xdp_datagrams = xdp_->datagrams_received();
+        }
+#endif
+        stats_.duplicate_blocks = duplicate_blocks_.load();
+        stats_.duplicate_chunks = duplicate_chunks_.load();
+        stats_.handoff_chunks = handoff_chunks_.load();
+        stats_.handoff_drops = handoff_drops_.load();
+        stats_.priority_chunks = priority_chunks_.load();
+        stats_.sketches_received = sketches_.load();
+        stats_.prefilled_chunks = prefilled_chunks_.load();
+        stats_.tx_cache_size = tx_cache_ ? tx_cache_->size() : 0;
+        stats_.active_peers = peers_.size();
+        stats_.socket_drops = 0;
+        for (const auto& peer : peers_) {
+            stats_.socket_drops += peer->stats().kernel_drops;
+        }
+        stats_.connected_peers = static_cast<std::size_t>(std::count_if(
+            peers_.begin(),
+            peers_.end(),
+            [](const auto& peer) { return peer->is_connected(); }
+        ));
+        stats_snapshot_.store(stats_);
+    }
+    
+    /**
+     * @brief Политика пиров по рангу доставки и RTT (под mutex_, раз в секунду)
+     *
+     * Пир с ранжированными slow_peer_min_blocks блоками и отставанием не
+     * дальше FAST_PEER_MARGIN_MS от лучшего - Fast: опрашивается первым,
+     * с двойным бюджетом и после каждого другого пира, keepalive вдвое
+     * чаще (свежий RTT, тёплый путь). Отставание больше slow_peer_lag_ms
+     * - Slow: keepalive вдвое реже, не trusted пир при slow_peer_drop
+     * отключается, если остаётся другой не медленный пир. Без эхо на два
+     * последних keepalive у отвечавшего раньше пира keepalive идёт в
+     * 4 раза чаще, чтобы быстрее увидеть потерю пути.
+     */
+    void apply_peer_policy(const std::vector<std::shared_ptr<RelayPeer>>& peers,
+                           std::chrono::steady_clock::time_point now) {
+        if (!config_.adaptive_peers) {
+            return;
+        }
+        readmit_dropped_peers(peers, now);
+        
+        double best_lag_ms = -1.0;
+        for (const auto& peer : peers) {
+            const auto stats = peer->stats();
+            if (peer->is_connected() && stats.blocks_ranked >= config_.slow_peer_min_blocks &&
+                (best_lag_ms < 0.0 || stats.arrival_lag_ms < best_lag_ms)) {
+                best_lag_ms = stats.arrival_lag_ms;
+            }
+        }
+        
+        for (const auto& peer : peers) {
+            if (!peer->is_connected()) {
+                continue;
+            }
+            const auto stats = peer->stats();
+            PeerPriority priority = PeerPriority::Normal;
+            if (best_lag_ms >= 0.0 && stats.blocks_ranked >= config_.slow_peer_min_blocks) {
+                if (stats.arrival_lag_ms > static_cast<double>(config_.slow_peer_lag_ms)) {
+                    priority = PeerPriority::Slow;
+                } else if (stats.arrival_lag_ms <= best_lag_ms + FAST_PEER_MARGIN_MS) {
+                    priority = PeerPriority::Fast;
                 }
             }
+            peer->set_priority(priority);
             
-            // Обновляем состояние пиров
-            for (auto& peer : peers_) {
+            if (priority == PeerPriority::Slow && config_.slow_peer_drop && !peer->is_trusted() &&
+                has_other_good_peer(peers, *peer)) {
+                QUAXIS_LOG(Warning, "[Relay] Медленный пир {} отключён: отставание блоков {:.1f} мс",
+                           peer->address_string(), stats.arrival_lag_ms);
+                peer->disconnect();
+                dropped_peers_.emplace_back(peer.get(), now);
+                ++stats_.dropped_peers;
+                continue;
+            }
+            
+            const uint32_t base = peer->config().keepalive_interval_ms;
+            uint32_t interval = base;
+            if (stats.keepalives_unanswered >= 2) {
+                interval = base / 4;
+            } else if (priority == PeerPriority::Fast) {
+                interval = base / 2;
+            } else if (priority == PeerPriority::Slow) {
+                interval = base * 2;
+            }
+            peer->set_keepalive_interval(std::max(interval, MIN_KEEPALIVE_INTERVAL_MS));
+        }
+    }
+    
+    /**
+     * @brief Есть подключённый пир, кроме exclude, не помеченный медленным?
+     */
+    static bool has_other_good_peer(const std::vector<std::shared_ptr<RelayPeer>>& peers,
+                                    const RelayPeer& exclude) {
+        return std::any_of(peers.begin(), peers.end(), [&exclude](const auto& peer) {
+            return peer.get() != &exclude && peer->is_connected() &&
+                   peer->priority() != PeerPriority::Slow;
+        });
+    }
+    
+    /**
+     * @brief Вернуть медленных пиров, отключённых SLOW_PEER_COOLDOWN назад
+     *
+     * Ранг сбрасывается: путь до пира мог измениться.
+     */
+    void readmit_dropped_peers(const std::vector<std::shared_ptr<RelayPeer>>& peers,
+                               std::chrono::steady_clock::time_point now) {
+        std::erase_if(dropped_peers_, [&](const auto& dropped) {
+            auto it = std::find_if(peers.begin(), peers.end(),
+                                   [&](const auto& peer) { return peer.get() == dropped.first; });
+            if (it == peers.end()) {
+                return true;  // Пир удалён из списка
+            }
+            if (now - dropped.second < SLOW_PEER_COOLDOWN) {
+                return false;
+            }
+            (*it)->reset_ranking();
+            (void)(*it)->connect();
+            return true;
+        });
+    }
+    
+    /**
+     * @brief Опубликовать статистику пиров (под mutex_)
+     */
+    void publish_peers() {
+        auto snapshots = std::make_shared<std::vector<PeerSnapshot>>();
+        snapshots->reserve(peers_.size());
+        for (const auto& peer : peers_) {
+            snapshots->push_back({peer->address_string(), peer->state(), peer->stats()});
+        }
+        peer_snapshots_.store(std::move(snapshots), std::memory_order_release);
+        publish_stats();
+    }
+    
+    /**
+     * @brief Распределить пиров по потокам приёма (под mutex_)
+     *
+     * По кругу, а с receive_steer_cpu пир, датаграммы которого ядро
+     * обрабатывает на CPU одного из потоков (SO_INCOMING_CPU), уходит в
+     * этот поток: сокет читается там же, где прошёл softirq, без
+     * переноса строк кеша между ядрами. Переезжающий пир на время
+     * смены может опрашиваться двумя потоками - RelayPeer::poll это
+     * допускает.
+     */
+    void assign_peer_shards() {
+        bool changed = peer_shards_.size() != peers_.size();
+        peer_shards_.resize(peers_.size());
+        for (std::size_t i = 0; i < peers_.size(); ++i) {
+            std::size_t target = i % shards_.size();
+            if (config_.receive_steer_cpu && shards_.size() > 1) {
+                const int cpu = peers_[i]->incoming_cpu();
+                for (const auto& shard : shards_) {
+                    if (cpu >= 0 && shard->cpu == cpu) {
+                        target = shard->index;
+                        break;
+                    }
+                }
+            }
+            if (peer_shards_[i] != target) {
+                peer_shards_[i] = target;
+                changed = true;
+            }
+        }
+        if (changed) {
+            peers_version_.fetch_add(1, std::memory_order_release);
+            wake_all();
+        }
+    }
+    
+    /**
+     * @brief Разбудить все потоки приёма (stop, изменение списка пиров)
+     */
+    void wake_all() {
+#ifdef __linux__
+        for (const auto& shard : shards_) {
+            wake(*shard);
+        }
+#endif
+    }
+
+#ifdef __linux__
+    /**
+     * @brief Создать epoll, timerfd (TIMER_TICK) и eventfd пробуждения потока
+     */
+    Result<void> open_event_loop(Shard& shard) {
+        shard.epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        shard.timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        shard.wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (shard.epoll_fd < 0 || shard.timer_fd < 0 || shard.wake_fd < 0) {
+            close_event_loop(shard);
+            return Err<void>(ErrorCode::SystemIOError, "Не удалось создать цикл событий relay");
+        }
+        
+        constexpr auto tick_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(TIMER_TICK).count();
+        struct itimerspec spec{};
+        spec.it_interval.tv_nsec = tick_ns;
+        spec.it_value.tv_nsec = tick_ns;
+        timerfd_settime(shard.timer_fd, 0, &spec, nullptr);
+        
+        // Метки событий: адреса дескрипторов, у пиров - RelayPeer*
+        struct epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.ptr = &shard.timer_fd;
+        epoll_ctl(shard.epoll_fd, EPOLL_CTL_ADD, shard.timer_fd, &ev);
+        ev.data.ptr = &shard.wake_fd;
+        epoll_ctl(shard.epoll_fd, EPOLL_CTL_ADD, shard.wake_fd, &ev);
+        return {};
+    }
+    
+    /**
+     * @brief Открыть AF_XDP сокет и добавить его в epoll первого потока
+     *
+     * Ошибка не фатальна: датаграммы продолжают идти в сокеты пиров (XDP
+     * программа не подключена), stats().xdp_active остаётся false.
+     */
+    void open_xdp() {
+        XdpSocketConfig xdp_config;
+        xdp_config.interface = config_.xdp_interface;
+        xdp_config.queue = config_.xdp_queue;
+        auto socket = std::make_unique<XdpSocket>(xdp_config);
+        if (!socket->open()) {
+            return;
+        }
+        
+        struct epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.ptr = &xdp_;
+        epoll_ctl(shards_[0]->epoll_fd, EPOLL_CTL_ADD, socket->native_handle(), &ev);
+        xdp_ = std::move(socket);
+        
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.xdp_active = true;
+        stats_.xdp_zero_copy = xdp_->is_zero_copy();
+        publish_stats();
+    }
+    
+    /**
+     * @brief Раздать датаграммы AF_XDP пирам по адресу отправителя
+     */
+    void poll_xdp(const std::vector<std::shared_ptr<RelayPeer>>& peers) {
+        xdp_->receive_batch(
+            [&peers](const UdpDatagram& datagram) {
+                for (const auto& peer : peers) {
+                    if (peer->is_connected() && peer->matches(datagram.sender_ip, datagram.sender_port)) {
+                        peer->deliver(datagram);
+                        return;
+                    }
+                }
+            },
+            PEER_POLL_BUDGET
+        );
+    }
+    
+    /**
+     * @brief Закрыть дескрипторы цикла событий потока
+     */
+    static void close_event_loop(Shard& shard) {
+        for (int* fd : {&shard.epoll_fd, &shard.timer_fd, &shard.wake_fd}) {
+            if (*fd >= 0) {
+                ::close(*fd);
+                *fd = -1;
+            }
+        }
+    }
+    
+    /**
+     * @brief Разбудить поток приёма
+     */
+    static void wake(Shard& shard) {
+        if (shard.wake_fd >= 0) {
+            uint64_t one = 1;
+            [[maybe_unused]] auto written = ::write(shard.wake_fd, &one, sizeof(one));
+        }
+    }
+    
+    /**
+     * @brief Зарегистрировать сокеты подключенных пиров потока в epoll
+     *
+     * Вызывается при каждом срабатывании таймера: переподключённый пир
+     * мог получить новый сокет с тем же номером дескриптора, а закрытый
+     * дескриптор epoll забывает сам. Уже зарегистрированный даёт EEXIST.
+     */
+    static void register_peers(Shard& shard, const std::vector<std::shared_ptr<RelayPeer>>& peers) {
+        for (const auto& peer : peers) {
+            int fd = peer->native_handle();
+            if (fd < 0 || !peer->is_connected()) {
+                continue;
+            }
+            struct epoll_event ev{};
+            ev.events = EPOLLIN;
+            ev.data.ptr = peer.get();
+            epoll_ctl(shard.epoll_fd, EPOLL_CTL_ADD, fd, &ev);
+        }
+    }
+    
+    /**
+     * @brief Убрать из epoll сокеты пиров, ушедших в другой поток
+     */
+    static void unregister_moved(Shard& shard,
+                                 const std::vector<std::shared_ptr<RelayPeer>>& before,
+                                 const std::vector<std::shared_ptr<RelayPeer>>& after) {
+        for (const auto& peer : before) {
+            if (std::find(after.begin(), after.end(), peer) == after.end() && peer->native_handle() >= 0) {
+                epoll_ctl(shard.epoll_fd, EPOLL_CTL_DEL, peer->native_handle(), nullptr);
+            }
+        }
+    }
+    
+    /**
+     * @brief Прочитать счётчик eventfd / timerfd
+     */
+    static void drain(int fd) {
+        uint64_t value = 0;
+        [[maybe_unused]] auto n = ::read(fd, &value, sizeof(value));
+    }
+#endif
+    
+    /**
+     * @brief Срабатывание таймера потока
+     *
+     * Таймауты реконструкторов своего пула. Первый поток ещё и ведёт
+     * пиров: keepalive и stale, раз в секунду - политика ранга,
+     * распределение по потокам и снимок пиров. Пакеты пиров
+     * обрабатываются вне таймера, по готовности сокета.
+     */
+    void on_timer(Shard& shard, const std::vector<std::shared_ptr<RelayPeer>>& all_peers) {
+        if (shard.index == 0) {
+            for (const auto& peer : all_peers) {
                 peer->update();
             }
+        }
+        
+        // Callback таймаута освобождает свою запись пула
+        // Блок, который не удалось декодировать, таймаута уже не дождётся
+        // Запись у потока декодирования ждёт ответа, а не таймаута
+        shard.inflight.for_each([&shard](InflightBlock& entry) {
+            if (entry.decoding) {
+                return;
+            }
+            entry.reconstructor.check_timeout();
+            if (entry.active && entry.reconstructor.state() == ReconstructionState::Failed) {
+                shard.inflight.release(entry.reconstructor.block_hash());
+            }
+        });
+        
+        if (shard.index != 0) {
+            return;
+        }
+        auto now = std::chrono::steady_clock::now();
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (now - peers_published_at_ >= std::chrono::seconds(1)) {
+            peers_published_at_ = now;
+            apply_peer_policy(all_peers, now);
+            assign_peer_shards();
+            publish_peers();
+        }
+    }
+    
+    /**
+     * @brief Быстрые подключённые пиры (для дополнительного опроса)
+     */
+    static void collect_fast_peers(const std::vector<std::shared_ptr<RelayPeer>>& peers,
+                                   std::vector<RelayPeer*>& fast) {
+        fast.clear();
+        for (const auto& peer : peers) {
+            if (peer->priority() == PeerPriority::Fast && peer->is_connected()) {
+                fast.push_back(peer.get());
+            }
+        }
+    }
+    
+    /**
+     * @brief Обновить локальные копии списка пиров, если он менялся
+     *
+     * @param own Пиры этого потока
+     * @param all Все пиры (таймер и AF_XDP первого потока)
+     */
+    void refresh_peers(const Shard& shard,
+                       std::vector<std::shared_ptr<RelayPeer>>& own,
+                       std::vector<std::shared_ptr<RelayPeer>>& all,
+                       uint64_t& version) {
+        uint64_t current = peers_version_.load(std::memory_order_acquire);
+        if (current == version) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        version = peers_version_.load(std::memory_order_relaxed);
+        all = peers_;
+        own.clear();
+        for (std::size_t i = 0; i < peers_.size() && i < peer_shards_.size(); ++i) {
+            if (peer_shards_[i] == shard.index) {
+                own.push_back(peers_[i]);
+            }
+        }
+    }
+    
+    /**
+     * @brief Цикл потока приёма
+     *
+     * Linux: epoll по сокетам пиров потока, пакет обрабатывается сразу по
+     * готовности сокета; чанки чужих блоков уходят владельцу, владелец
+     * разбирает свою очередь после каждой пачки событий. Периодическая
+     * работа - по timerfd в том же epoll. При worker_busy_poll epoll_wait
+     * не спит (таймаут 0), поток занимает ядро целиком - его стоит
+     * закрепить worker_cpu_affinity / receive_cpus.
+     *
+     * Готовые сокеты быстрых пиров (apply_peer_policy) обрабатываются
+     * первыми, а после каждого другого пира они опрашиваются ещё раз:
+     * чанк лучшего пира не ждёт всплеска дубликатов от медленного.
+     * Переданные чанки быстрой полосы разбираются после каждого пира.
+     */
+    void shard_loop(Shard& shard) {
+        t_shard_ = &shard;
+        std::vector<std::shared_ptr<RelayPeer>> peers;
+        std::vector<std::shared_ptr<RelayPeer>> all;
+        std::vector<RelayPeer*> fast;
+        uint64_t version = ~uint64_t{0};
+
+#ifdef __linux__
+        std::vector<std::shared_ptr<RelayPeer>> before;
+        std::array<struct epoll_event, MAX_EPOLL_EVENTS> events{};
+        const int timeout_ms = config_.worker_busy_poll ? 0 : -1;
+        
+        while (running_.load(std::memory_order_relaxed)) {
+            uint64_t old_version = version;
+            before = peers;
+            refresh_peers(shard, peers, all, version);
+            if (version != old_version) {
+                unregister_moved(shard, before, peers);
+                register_peers(shard, peers);
+                collect_fast_peers(peers, fast);
+            }
             
-            // Проверяем таймауты реконструкторов
-            {
-                std::lock_guard<std::mutex> lock(mutex_);
-                for (auto& [hash, reconstructor] : reconstructors_) {
-                    reconstructor->check_timeout();
+            int n = epoll_wait(shard.epoll_fd, events.data(), MAX_EPOLL_EVENTS, timeout_ms);
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
                 }
+                break;
             }
             
-            // Небольшая пауза
-            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            if (!fast.empty() && n > 1) {
+                std::stable_partition(events.begin(), events.begin() + n, [&fast](const auto& event) {
+                    return std::find(fast.begin(), fast.end(), event.data.ptr) != fast.end();
+                });
+            }
+            
+            for (int i = 0; i < n; ++i) {
+                void* tag = events[static_cast<std::size_t>(i)].data.ptr;
+                if (tag == &shard.wake_fd) {
+                    drain(shard.wake_fd);
+                    drain_priority(shard);
+                } else if (tag == &xdp_) {
+                    poll_xdp(all);
+                    flush_wakes(shard);
+                } else if (tag == &shard.timer_fd) {
+                    drain(shard.timer_fd);
+                    on_timer(shard, all);
+                    register_peers(shard, peers);
+                    collect_fast_peers(peers, fast);
+                } else {
+                    auto* peer = static_cast<RelayPeer*>(tag);
+                    if (!peer->is_connected()) {
+                        // Иначе level-triggered epoll будет будить поток
+                        // непрочитанными датаграммами отключённого пира
+                        epoll_ctl(shard.epoll_fd, EPOLL_CTL_DEL, peer->native_handle(), nullptr);
+                        continue;
+                    }
+                    const PeerPriority priority = peer->priority();
+                    peer->poll(poll_budget(priority));
+                    if (priority != PeerPriority::Fast) {
+                        for (RelayPeer* fast_peer : fast) {
+                            fast_peer->poll(poll_budget(PeerPriority::Fast));
+                        }
+                    }
+                    flush_wakes(shard);
+                    drain_priority(shard);
+                }
+            }
+            drain_inbox(shard);
+            drain_decoded(shard);
+        }
+#else
+        auto next_tick = std::chrono::steady_clock::now();
+        while (running_.load(std::memory_order_relaxed)) {
+            refresh_peers(shard, peers, all, version);
+            collect_fast_peers(peers, fast);
+            for (RelayPeer* peer : fast) {
+                peer->poll(poll_budget(PeerPriority::Fast));
+            }
+            for (auto& peer : peers) {
+                if (peer->is_connected() && peer->priority() != PeerPriority::Fast) {
+                    peer->poll(poll_budget(peer->priority()));
+                }
+            }
+            flush_wakes(shard);
+            drain_inbox(shard);
+            drain_decoded(shard);
+            auto now = std::chrono::steady_clock::now();
+            if (now >= next_tick) {
+                next_tick = now + TIMER_TICK;
+                on_timer(shard, all);
+            }
+            if (!config_.worker_busy_poll) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
         }
+#endif
+        t_shard_ = nullptr;
     }
     
     /**
      * @brief Очистка старых данных
      */
-    void cleanup_old_blocks() {
+    static void cleanup_old_blocks(Shard& shard) {
         // Ограничиваем размер кэша полученных блоков
         constexpr std::size_t MAX_RECEIVED_BLOCKS = 1000;
         
-        if (received_blocks_.size() > MAX_RECEIVED_BLOCKS) {
-            received_blocks_.clear();  // Простая очистка
+        if (shard.received_blocks.size() > MAX_RECEIVED_BLOCKS) {
+            shard.received_blocks.clear();  // Простая очистка
         }
     }
 };
 
-RelayManager::RelayManager(const RelayConfig& config)
-    : impl_(std::make_unique<Impl>(config))
+thread_local RelayManager::Impl::Shard* RelayManager::Impl::t_shard_ = nullptr;
+thread_local bool RelayManager::Impl::t_decoder_ = false;
+
+namespace {
+
+/**
+ * @brief Конвертировать quaxis::RelayPeerConfig в relay::RelayPeerConfig
+ * 
+ * Параметры сокета - общие из [relay], остальные поля используют
+ * значения по умолчанию из RelayPeerConfig.
+ */
+RelayPeerConfig make_peer_config(const quaxis::RelayPeerConfig& peer_config, const RelayConfig& config) {
+    RelayPeerConfig cfg;
+    cfg.host = peer_config.host;
+    cfg.port = peer_config.port;
+    cfg.trusted = peer_config.trusted;
+    cfg.recv_batch = config.recv_batch;
+    cfg.udp_gro = config.udp_gro;
+    cfg.busy_poll_us = config.busy_poll_us;
+    cfg.recv_buffer_size = config.recv_buffer_size;
+    cfg.recv_buffer_autotune = config.recv_buffer_autotune;
+    return cfg;
+}
+
+} // anonymous namespace
+
+RelayManager::RelayManager(const RelayConfig& config, const core::ChainParams& chain_params)
+    : impl_(std::make_unique<Impl>(config, chain_params))
 {
     // Создаём пиры из конфигурации
-    // Конвертируем quaxis::RelayPeerConfig в relay::RelayPeerConfig
     for (const auto& peer_config : config.peers) {
-        RelayPeerConfig cfg;
-        cfg.host = peer_config.host;
-        cfg.port = peer_config.port;
-        cfg.trusted = peer_config.trusted;
-        // Остальные поля используют значения по умолчанию из RelayPeerConfig
-        
-        impl_->peers_.push_back(std::make_unique<RelayPeer>(cfg));
+        impl_->peers_.push_back(std::make_shared<RelayPeer>(make_peer_config(peer_config, config)));
     }
+    impl_->assign_peer_shards();
 }
 
 RelayManager::~RelayManager() {
@@ -234,9 +1401,11 @@ Result<void> RelayManager::start() {
     
     // Подключаемся ко всем пирам
     for (auto& peer : impl_->peers_) {
-        peer->set_packet_callback([this](const FibrePacket& packet) {
-            impl_->on_packet(packet);
-        });
+        peer->set_packet_callback(
+            [this, trusted = peer->is_trusted(), source = peer.get()](const FibrePacketView& packet) {
+                impl_->on_packet(packet, trusted, source);
+            }
+        );
         
         auto result = peer->connect();
         if (!result) {
@@ -244,11 +1413,54 @@ Result<void> RelayManager::start() {
         }
     }
     
-    // Запускаем рабочий поток
+#ifdef __linux__
+    for (auto& shard : impl_->shards_) {
+        auto loop_result = impl_->open_event_loop(*shard);
+        if (!loop_result) {
+            for (auto& opened : impl_->shards_) {
+                Impl::close_event_loop(*opened);
+            }
+            return loop_result;
+        }
+    }
+    if (!impl_->config_.xdp_interface.empty()) {
+        impl_->open_xdp();
+    }
+#endif
+    
+    // Запускаем потоки приёма
     impl_->running_.store(true);
-    impl_->worker_thread_ = std::thread([this]() {
-        impl_->worker_loop();
-    });
+    for (auto& shard : impl_->shards_) {
+        Impl::Shard* owner = shard.get();
+        owner->thread = std::thread([this, owner]() {
+            core::enter_thread_role(core::ThreadRole::BlockPath, owner->cpu >= 0);
+            impl_->shard_loop(*owner);
+        });
+        
+        if (owner->cpu >= 0) {
+            auto pinned = shm::pin_thread_to_cpu(owner->thread, owner->cpu);
+            if (!pinned) {
+                stop();
+                return pinned;
+            }
+        }
+    }
+    
+    // Поток FEC декодирования
+    if (impl_->config_.decode_thread) {
+        const int cpu = impl_->config_.decode_cpu;
+        impl_->decode_thread_ = std::thread([this, cpu]() {
+            core::enter_thread_role(core::ThreadRole::BlockPath, cpu >= 0);
+            impl_->decode_loop();
+        });
+        if (cpu >= 0) {
+            auto pinned = shm::pin_thread_to_cpu(impl_->decode_thread_, cpu);
+            if (!pinned) {
+                stop();
+                return pinned;
+            }
+        }
+    }
     
     return {};
 }
@@ -259,10 +1471,24 @@ void RelayManager::stop() {
     }
     
     impl_->running_.store(false);
+    impl_->wake_all();
+    impl_->decode_signal_.fetch_add(1, std::memory_order_release);
+    impl_->decode_signal_.notify_all();
+    if (impl_->decode_thread_.joinable()) {
+        impl_->decode_thread_.join();
+    }
     
-    if (impl_->worker_thread_.joinable()) {
-        impl_->worker_thread_.join();
+    for (auto& shard : impl_->shards_) {
+        if (shard->thread.joinable()) {
+            shard->thread.join();
+        }
+    }
+#ifdef __linux__
+    impl_->xdp_.reset();
+    for (auto& shard : impl_->shards_) {
+        Impl::close_event_loop(*shard);
     }
+#endif
     
     // Отключаемся от всех пиров
     for (auto& peer : impl_->peers_) {
@@ -284,6 +1510,20 @@ void RelayManager::set_block_callback(RelayBlockCallback callback) {
     impl_->block_callback_ = std::move(callback);
 }
 
+void RelayManager::set_speculative_callback(RelaySpeculativeCallback callback) {
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    impl_->speculative_callback_ = std::move(callback);
+}
+
+void RelayManager::set_block_state_callback(RelayBlockStateCallback callback) {
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    impl_->block_state_callback_ = std::move(callback);
+}
+
+Result<void> RelayManager::add_peer(const quaxis::RelayPeerConfig& config) {
+    return add_peer(make_peer_config(config, impl_->config_));
+}
+
 Result<void> RelayManager::add_peer(const RelayPeerConfig& config) {
     std::lock_guard<std::mutex> lock(impl_->mutex_);
     
@@ -297,11 +1537,13 @@ Result<void> RelayManager::add_peer(const RelayPeerConfig& config) {
         }
     }
     
-    auto peer = std::make_unique<RelayPeer>(config);
+    auto peer = std::make_shared<RelayPeer>(config);
     
-    peer->set_packet_callback([this](const FibrePacket& packet) {
-        impl_->on_packet(packet);
-    });
+    peer->set_packet_callback(
+        [this, trusted = config.trusted, source = peer.get()](const FibrePacketView& packet) {
+            impl_->on_packet(packet, trusted, source);
+        }
+    );
     
     if (impl_->running_.load()) {
         auto result = peer->connect();
@@ -311,6 +1553,8 @@ Result<void> RelayManager::add_peer(const RelayPeerConfig& config) {
     }
     
     impl_->peers_.push_back(std::move(peer));
+    impl_->assign_peer_shards();
+    impl_->publish_peers();
     
     return {};
 }
@@ -326,7 +1570,10 @@ void RelayManager::remove_peer(const std::string& host, uint16_t port) {
         }
     );
     
+    // Потоки приёма отпустят свои копии пира при следующем пробуждении
     impl_->peers_.erase(it, impl_->peers_.end());
+    impl_->assign_peer_shards();
+    impl_->publish_peers();
 }
 
 std::size_t RelayManager::peer_count() const {
@@ -344,16 +1591,166 @@ std::size_t RelayManager::connected_peer_count() const {
     ));
 }
 
-RelayManagerStats RelayManager::stats() const {
-    std::lock_guard<std::mutex> lock(impl_->mutex_);
+Result<void> RelayManager::broadcast_block(
+    ByteSpan block,
+    const Hash256& block_hash,
+    uint32_t height
+) {
+    const auto& config = impl_->config_;
     
-    RelayManagerStats stats = impl_->stats_;
-    stats.active_peers = impl_->peers_.size();
-    stats.connected_peers = static_cast<std::size_t>(std::count_if(
-        impl_->peers_.begin(),
-        impl_->peers_.end(),
-        [](const auto& peer) { return peer->is_connected(); }
-    ));
+    // Чанк не больше MAX_CHUNK_SIZE - иначе FecDecoder пира его отбросит
+    constexpr std::size_t CHUNK_SIZE = std::min(FIBRE_MAX_PAYLOAD_SIZE, MAX_CHUNK_SIZE);
+    const std::size_t chunks = (block.size() + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    if (chunks == 0 || chunks > 0xFFFF) {
+        return Err<void>(ErrorCode::NetworkSendFailed, "Недопустимый размер блока для FIBRE");
+    }
+    
+    FecParams params;
+    params.data_chunk_count = static_cast<uint16_t>(chunks);
+    params.fec_chunk_count = 0;
+    params.scheme = config.fec_scheme == "xor" ? FecScheme::Xor : FecScheme::CauchyReedSolomon;
+    if (config.fec_enabled && config.fec_overhead > 0.0) {
+        std::size_t fec = static_cast<std::size_t>(
+            std::ceil(static_cast<double>(chunks) * config.fec_overhead));
+        if (params.scheme == FecScheme::Xor) {
+            fec = std::min<std::size_t>(fec, 1);  // XOR-чанки одинаковы
+        } else {
+            // Код Коши: data + FEC не больше 256, приёмник держит до MAX_FEC_CHUNKS
+            fec = chunks >= MAX_CAUCHY_CHUNKS ? 0
+                : std::min({fec, MAX_FEC_CHUNKS, MAX_CAUCHY_CHUNKS - chunks});
+        }
+        params.fec_chunk_count = static_cast<uint16_t>(fec);
+    }
+    
+    std::vector<ByteSpan> data_chunks;
+    data_chunks.reserve(chunks);
+    for (std::size_t i = 0; i < chunks; ++i) {
+        const std::size_t offset = i * CHUNK_SIZE;
+        data_chunks.push_back(block.subspan(offset, std::min(CHUNK_SIZE, block.size() - offset)));
+    }
+    
+    std::vector<std::vector<uint8_t>> parity;
+    if (params.fec_chunk_count > 0) {
+        auto encoded = encode_fec_chunks(params, data_chunks);
+        if (!encoded) {
+            return std::unexpected(encoded.error());
+        }
+        parity = std::move(*encoded);
+    }
+    
+    // Data чанки (header блока - в первом), затем FEC
+    const std::size_t total = chunks + parity.size();
+    FibreParser parser;
+    std::vector<std::vector<uint8_t>> packets;
+    packets.reserve(total);
+    
+    // Набросок - перед чанками: приёмник синтезирует чанки из mempool,
+    // пока остальные ещё в пути. Номер части - в chunk_id
+    if (config.mempool_prefill) {
+        std::random_device entropy;
+        const uint64_t nonce = (uint64_t{entropy()} << 32) | entropy();
+        auto sketch = make_block_sketch(block, nonce, static_cast<uint16_t>(CHUNK_SIZE));
+        auto parts = sketch ? serialize_sketch(*sketch, FIBRE_MAX_PAYLOAD_SIZE)
+                            : std::vector<std::vector<uint8_t>>{};
+        if (parts.size() <= total) {
+            for (std::size_t i = 0; i < parts.size(); ++i) {
+                FibrePacket packet;
+                packet.header.magic = FIBRE_MAGIC;
+                packet.header.version = FIBRE_VERSION;
+                packet.header.flags = static_cast<uint8_t>(FibreFlags::Sketch);
+                packet.header.chunk_id = static_cast<uint16_t>(i);
+                packet.header.block_height = height;
+                packet.header.block_hash = block_hash;
+                packet.header.total_chunks = static_cast<uint16_t>(total);
+                packet.header.data_chunks = static_cast<uint16_t>(chunks);
+                packet.header.payload_size = static_cast<uint16_t>(parts[i].size());
+                packet.payload = std::move(parts[i]);
+                packets.push_back(parser.serialize(packet));
+            }
+        }
+    }
+    for (std::size_t i = 0; i < total; ++i) {
+        const bool is_fec = i >= chunks;
+        const ByteSpan payload = is_fec ? ByteSpan(parity[i - chunks]) : data_chunks[i];
+        
+        FibrePacket packet;
+        packet.header.magic = FIBRE_MAGIC;
+        packet.header.version = FIBRE_VERSION;
+        uint8_t flags = is_fec ? static_cast<uint8_t>(FibreFlags::FecChunk) : 0;
+        if (i + 1 == total) {
+            flags |= static_cast<uint8_t>(FibreFlags::LastChunk);
+        }
+        packet.header.flags = flags;
+        packet.header.chunk_id = static_cast<uint16_t>(i);
+        packet.header.block_height = height;
+        packet.header.block_hash = block_hash;
+        packet.header.total_chunks = static_cast<uint16_t>(total);
+        packet.header.data_chunks = static_cast<uint16_t>(chunks);
+        packet.header.payload_size = static_cast<uint16_t>(payload.size());
+        packet.payload.assign(payload.begin(), payload.end());
+        packets.push_back(parser.serialize(packet));
+    }
+    std::vector<ByteSpan> views(packets.begin(), packets.end());
+    
+    // Получатели: подключённые trusted пиры, без них - все подключённые
+    std::vector<std::shared_ptr<RelayPeer>> targets;
+    {
+        std::lock_guard<std::mutex> lock(impl_->mutex_);
+        for (const auto& peer : impl_->peers_) {
+            if (peer->is_connected() && peer->is_trusted()) {
+                targets.push_back(peer);
+            }
+        }
+        if (targets.empty()) {
+            for (const auto& peer : impl_->peers_) {
+                if (peer->is_connected()) {
+                    targets.push_back(peer);
+                }
+            }
+        }
+    }
+    if (targets.empty()) {
+        return Err<void>(ErrorCode::NetworkSendFailed, "Нет подключенных FIBRE пиров");
+    }
+    
+    // Раунды по broadcast_burst пакетов каждому пиру по очереди: первые
+    // чанки получают все пиры, а не только первый в списке
+    const std::size_t burst = std::max<uint32_t>(config.broadcast_burst, 1);
+    const auto started = std::chrono::steady_clock::now();
+    std::vector<std::size_t> delivered(targets.size(), 0);
+    std::size_t bytes = 0;
+    for (std::size_t offset = 0; offset < views.size(); offset += burst) {
+        const auto round = std::span<const ByteSpan>(views).subspan(
+            offset, std::min(burst, views.size() - offset));
+        for (std::size_t t = 0; t < targets.size(); ++t) {
+            auto sent = targets[t]->send_batch(round);
+            delivered[t] += sent ? *sent : 0;
+        }
+        
+        if (config.broadcast_rate_mbps > 0) {
+            for (const auto& view : round) {
+                bytes += view.size();
+            }
+            // Мбит/с = бит/мкс
+            std::this_thread::sleep_until(started + std::chrono::microseconds(
+                bytes * 8 / config.broadcast_rate_mbps));
+        }
+    }
+    
+    const bool any = std::any_of(delivered.begin(), delivered.end(),
+                                 [&](std::size_t n) { return n == views.size(); });
+    if (!any) {
+        return Err<void>(ErrorCode::NetworkSendFailed, "Блок не отправлен ни одному FIBRE пиру");
+    }
+    return {};
+}
+
+bool RelayManager::add_transaction(ByteSpan raw_tx) {
+    return impl_->tx_cache_ && impl_->tx_cache_->add(raw_tx);
+}
+
+RelayManagerStats RelayManager::stats() const {
+    RelayManagerStats stats = impl_->stats_snapshot_.load();
     
     if (impl_->start_time_.time_since_epoch().count() > 0) {
         stats.uptime_seconds = std::chrono::duration<double>(
@@ -364,6 +1761,14 @@ RelayManagerStats RelayManager::stats() const {
     return stats;
 }
 
+RelayLatencyHistograms RelayManager::latency_histograms() const {
+    return impl_->latency_snapshot_.load();
+}
+
+std::vector<PeerSnapshot> RelayManager::peer_stats() const {
+    return *impl_->peer_snapshots_.load(std::memory_order_acquire);
+}
+
 const RelayConfig& RelayManager::config() const noexcept {
     return impl_->config_;
 }
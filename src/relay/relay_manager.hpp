@@ -16,17 +16,43 @@
  *     └── RelayPeer 3 (fibre.us.bitcoinfibre.org)
  *           │
  *           ▼
- *     BlockReconstructor (для каждого блока)
+ *     BlockReconstructor (для каждого блока, чанки всех пиров сливаются)
  *           │
  *           ▼
  *     HeaderCallback / BlockCallback
  * ```
+ * 
+ * AF_XDP (`xdp_interface`): FIBRE датаграммы одной очереди NIC
+ * принимаются XdpSocket в обход стека и раздаются пирам по адресу
+ * отправителя; без прав или поддержки ядра остаются сокеты пиров.
+ * 
+ * Ранг пиров (`adaptive_peers`): для каждого блока пиру засчитывается
+ * отставание его первого чанка от самого раннего, по нему пиры делятся
+ * на быстрых (опрашиваются первыми и чаще) и медленных (keepalive реже,
+ * не trusted - отключаются). RTT и jitter - по эхо keepalive.
+ * 
+ * Несколько потоков приёма (`receive_threads`): пиры распределены по
+ * потокам (с `receive_steer_cpu` - по CPU, на котором ядро принимает их
+ * датаграммы), блок реконструирует поток-владелец по хешу, чанки чужих
+ * блоков передаются ему через ChunkHandoffQueue.
+ * 
+ * Mempool prefill (`mempool_prefill`): транзакции mempool узла (ZMQ
+ * rawtx) лежат в TxCache; по наброску блока (short id, compact_block.hpp)
+ * data чанки, покрытые ими, синтезируются локально, и для сборки хватает
+ * чанков остальной части блока и FEC.
+ * 
+ * Header-first (`header_first`): header из первых чанков блока от
+ * trusted пира с валидным PoW сразу уходит в SpeculativeCallback (spy
+ * mining), а после реконструкции тело проверяется (заголовок и merkle
+ * root) и результат приходит в BlockStateCallback.
  */
 
 #pragma once
 
 #include "../core/types.hpp"
 #include "../core/config.hpp"
+#include "../core/latency_trace.hpp"
+#include "../core/chain/chain_registry.hpp"
 #include "../bitcoin/block.hpp"
 #include "relay_peer.hpp"
 #include "block_reconstructor.hpp"
@@ -36,6 +62,7 @@
 #include <vector>
 #include <thread>
 #include <atomic>
+#include <string>
 
 namespace quaxis::relay {
 
@@ -75,16 +102,53 @@ using RelayHeaderCallback = std::function<void(
 /**
  * @brief Callback при получении полного блока
  * 
- * @param data Данные блока
+ * @param data Данные блока (действительны только внутри вызова)
  * @param height Высота блока
  * @param source Источник блока
  */
 using RelayBlockCallback = std::function<void(
-    const std::vector<uint8_t>& data,
+    ByteSpan data,
     uint32_t height,
     BlockSource source
 )>;
 
+/**
+ * @brief Результат проверки блока после speculative header
+ */
+enum class RelayBlockState : uint8_t {
+    /// @brief Тело блока совпало с заголовком
+    Confirmed,
+    
+    /// @brief Тело не совпало с заголовком (merkle root, header)
+    Invalid
+};
+
+/**
+ * @brief Callback speculative header (header-first spy mining)
+ * 
+ * @param header Заголовок нового tip (PoW проверен)
+ * @param height Высота блока
+ * @param coinbase_value Субсидия следующего блока (комиссий нет - пустой блок)
+ */
+using RelaySpeculativeCallback = std::function<void(
+    const bitcoin::BlockHeader& header,
+    uint32_t height,
+    int64_t coinbase_value
+)>;
+
+/**
+ * @brief Callback проверки блока, объявленного speculative
+ * 
+ * @param block_hash Хеш блока
+ * @param height Высота блока
+ * @param state Confirmed или Invalid
+ */
+using RelayBlockStateCallback = std::function<void(
+    const Hash256& block_hash,
+    uint32_t height,
+    RelayBlockState state
+)>;
+
 // =============================================================================
 // Статистика менеджера
 // =============================================================================
@@ -105,19 +169,103 @@ struct RelayManagerStats {
     /// @brief Количество дубликатов блоков
     uint64_t duplicate_blocks{0};
     
+    /// @brief Чанков, уже полученных от другого пира (проиграли гонку)
+    uint64_t duplicate_chunks{0};
+    
     /// @brief Среднее время получения header (мс)
     double avg_header_latency_ms{0.0};
     
     /// @brief Среднее время полной реконструкции (мс)
     double avg_reconstruction_latency_ms{0.0};
     
+    /// @brief Среднее время от декодируемого набора чанков до блока (мс)
+    double avg_decode_latency_ms{0.0};
+    
     /// @brief Количество таймаутов реконструкции
     uint64_t reconstruction_timeouts{0};
     
+    /// @brief Таймаутов, во время сборки которых ядро теряло датаграммы пиров
+    uint64_t drop_timeouts{0};
+    
+    /// @brief Датаграмм пиров, отброшенных ядром на переполненном буфере сокета
+    uint64_t socket_drops{0};
+    
+    /// @brief Незавершённых блоков, вытесненных из заполненного пула
+    uint64_t evicted_blocks{0};
+    
+    /// @brief Медленных пиров, отключённых политикой ранга (slow_peer_drop)
+    uint64_t dropped_peers{0};
+    
+    /// @brief Потоков приёма (receive_threads; с AF_XDP - один)
+    std::size_t receive_threads{1};
+    
+    /// @brief Чанков, переданных потоку-владельцу блока
+    uint64_t handoff_chunks{0};
+    
+    /// @brief Чанков, потерянных на заполненной очереди владельца
+    uint64_t handoff_drops{0};
+    
+    /// @brief Чанков быстрой полосы (с header блока, наброска, LastChunk)
+    uint64_t priority_chunks{0};
+    
+    /// @brief Собранных набросков блоков (mempool_prefill)
+    uint64_t sketches_received{0};
+    
+    /// @brief Data чанков, синтезированных из кеша mempool
+    uint64_t prefilled_chunks{0};
+    
+    /// @brief Блоков с синтезированными чанками и чужим merkle root (коллизия short id)
+    uint64_t prefill_mismatches{0};
+    
+    /// @brief Транзакций в кеше mempool
+    std::size_t tx_cache_size{0};
+    
+    /// @brief AF_XDP сокет открыт и XDP программа подключена
+    bool xdp_active{false};
+    
+    /// @brief NIC пишет кадры прямо в UMEM (XDP_ZEROCOPY)
+    bool xdp_zero_copy{false};
+    
+    /// @brief Датаграмм, принятых через AF_XDP
+    uint64_t xdp_datagrams{0};
+    
+    /// @brief Header-first: заголовков, отданных в spy mining
+    uint64_t speculative_headers{0};
+    
+    /// @brief Header-first: заголовков с невалидным PoW или чужим хешем
+    uint64_t rejected_headers{0};
+    
+    /// @brief Header-first: блоков, тело которых не совпало с заголовком
+    uint64_t invalid_blocks{0};
+    
     /// @brief Время работы (секунды)
     double uptime_seconds{0.0};
 };
 
+/**
+ * @brief Распределения латентности relay (наносекунды от первого пакета блока)
+ */
+struct RelayLatencyHistograms {
+    /// @brief До извлечения header
+    core::LatencyHistogram header_latency;
+    
+    /// @brief До полной реконструкции
+    core::LatencyHistogram reconstruction_latency;
+    
+    /// @brief От чанка, после которого блок декодируем, до собранного блока
+    /// (с decode_thread - ещё и ожидание в очереди потока декодирования)
+    core::LatencyHistogram decode_latency;
+};
+
+/**
+ * @brief Статистика пира для экспорта
+ */
+struct PeerSnapshot {
+    std::string address;
+    PeerState state{PeerState::Disconnected};
+    PeerStats stats;
+};
+
 // =============================================================================
 // Класс RelayManager
 // =============================================================================
@@ -136,8 +284,12 @@ public:
      * @brief Создать менеджер relay
      * 
      * @param config Конфигурация relay
+     * @param chain_params Параметры сети для проверки PoW header-first
      */
-    explicit RelayManager(const RelayConfig& config);
+    explicit RelayManager(
+        const RelayConfig& config,
+        const core::ChainParams& chain_params = core::bitcoin_params()
+    );
     
     /**
      * @brief Деструктор - останавливает менеджер
@@ -193,6 +345,27 @@ public:
      */
     void set_block_callback(RelayBlockCallback callback);
     
+    /**
+     * @brief Установить callback speculative header (header_first)
+     * 
+     * Вызывается из рабочего потока, как только header блока от trusted
+     * пира извлечён и его PoW проверен - до реконструкции тела.
+     * 
+     * @param callback Функция обработки
+     */
+    void set_speculative_callback(RelaySpeculativeCallback callback);
+    
+    /**
+     * @brief Установить callback проверки speculative блока
+     * 
+     * Confirmed / Invalid приходит после реконструкции блока, заголовок
+     * которого ушёл в SpeculativeCallback. Невалидный блок в
+     * BlockCallback не передаётся.
+     * 
+     * @param callback Функция обработки
+     */
+    void set_block_state_callback(RelayBlockStateCallback callback);
+    
     // =========================================================================
     // Управление пирами
     // =========================================================================
@@ -205,6 +378,11 @@ public:
      */
     [[nodiscard]] Result<void> add_peer(const RelayPeerConfig& config);
     
+    /**
+     * @brief Добавить пир из [[relay.peers]] (параметры сокета - из [relay])
+     */
+    [[nodiscard]] Result<void> add_peer(const quaxis::RelayPeerConfig& config);
+    
     /**
      * @brief Удалить пир
      * 
@@ -223,6 +401,42 @@ public:
      */
     [[nodiscard]] std::size_t connected_peer_count() const;
     
+    /**
+     * @brief Разослать найденный блок подключённым trusted пирам
+     * 
+     * Блок режется на data чанки по MAX_CHUNK_SIZE, к ним добавляются
+     * FEC чанки (fec_enabled, fec_overhead, fec_scheme; код Коши - до
+     * 256 чанков на блок). С mempool_prefill первыми идут пакеты
+     * наброска блока. Пакеты сериализуются один раз и уходят
+     * раундами: broadcast_burst пакетов каждому пиру одним sendmmsg, затем
+     * следующий раунд; broadcast_rate_mbps ограничивает темп. Без
+     * подключённых trusted пиров блок получают все подключённые.
+     * 
+     * Вызывающий поток блокируется на время рассылки (с темпом - на
+     * размер блока / broadcast_rate_mbps).
+     * 
+     * @param block Сериализованный блок
+     * @param block_hash Хеш блока
+     * @param height Высота блока
+     * @return Успех, если блок целиком ушёл хотя бы одному пиру
+     */
+    [[nodiscard]] Result<void> broadcast_block(
+        ByteSpan block,
+        const Hash256& block_hash,
+        uint32_t height
+    );
+    
+    /**
+     * @brief Добавить транзакцию mempool узла в кеш (mempool_prefill)
+     * 
+     * Источник - ZMQ rawtx. Вызывается из любого потока; кеш
+     * фиксированной ёмкости (tx_cache_size) вытесняет самые старые.
+     * 
+     * @param raw_tx Сериализация транзакции с witness
+     * @return false если кеш выключен или транзакция уже в нём
+     */
+    bool add_transaction(ByteSpan raw_tx);
+    
     // =========================================================================
     // Информация
     // =========================================================================
@@ -232,6 +446,19 @@ public:
      */
     [[nodiscard]] RelayManagerStats stats() const;
     
+    /**
+     * @brief Гистограммы латентности header / реконструкции (lock-free)
+     */
+    [[nodiscard]] RelayLatencyHistograms latency_histograms() const;
+    
+    /**
+     * @brief Статистика пиров
+     * 
+     * Снимок обновляется рабочим потоком раз в секунду; чтение не берёт
+     * мьютекс менеджера.
+     */
+    [[nodiscard]] std::vector<PeerSnapshot> peer_stats() const;
+    
     /**
      * @brief Конфигурация
      */
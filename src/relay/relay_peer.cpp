@@ -4,11 +4,38 @@
  */
 
 #include "relay_peer.hpp"
+#include "../core/stats_counter.hpp"
 
 #include <algorithm>
 
+#include <arpa/inet.h>
+
 namespace quaxis::relay {
 
+namespace {
+
+/// @brief Время steady_clock в наносекундах
+[[nodiscard]] uint64_t steady_ns(std::chrono::steady_clock::time_point at) noexcept {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(at.time_since_epoch()).count());
+}
+
+/// @brief Наносекунды в миллисекунды
+[[nodiscard]] double to_ms(uint64_t ns) noexcept {
+    return static_cast<double>(ns) / 1e6;
+}
+
+/// @brief Шаг EWMA с весом 1/2^shift (первая выборка - как есть)
+[[nodiscard]] uint64_t ewma(uint64_t average, uint64_t sample, bool first, unsigned shift) noexcept {
+    if (first) {
+        return sample;
+    }
+    const auto diff = static_cast<int64_t>(sample) - static_cast<int64_t>(average);
+    return static_cast<uint64_t>(static_cast<int64_t>(average) + (diff >> shift));
+}
+
+} // anonymous namespace
+
 // =============================================================================
 // Реализация RelayPeer
 // =============================================================================
@@ -23,11 +50,56 @@ struct RelayPeer::Impl {
     /// @brief Парсер FIBRE протокола
     FibreParser parser_;
     
+    /// @brief Разобранные пакеты пачки (ёмкость переиспользуется)
+    std::vector<FibrePacketView> views_;
+    
     /// @brief Текущее состояние
     std::atomic<PeerState> state_{PeerState::Disconnected};
     
-    /// @brief Статистика
-    PeerStats stats_;
+    /// @brief Счётчики статистики (пишет поток relay, снимок собирает stats())
+    core::RelaxedCounter packets_received_;
+    core::RelaxedCounter bytes_received_;
+    core::RelaxedCounter keepalives_received_;
+    core::RelaxedCounter keepalives_sent_;
+    core::RelaxedCounter recv_syscalls_;
+    core::RelaxedCounter chunks_first_;
+    core::RelaxedCounter chunks_duplicate_;
+    core::RelaxedCounter headers_first_;
+    core::RelaxedCounter blocks_completed_;
+    core::RelaxedTimePoint last_packet_time_;
+    core::RelaxedTimePoint connected_at_;
+    
+    /// @brief Потери ядра и буфер приёма (пишет поток, опрашивающий пира)
+    core::RelaxedValue<uint64_t> kernel_drops_;
+    core::RelaxedValue<uint64_t> recv_buffer_bytes_;
+    core::RelaxedCounter recv_buffer_grows_;
+    core::RelaxedTimePoint last_drop_time_;
+    
+    /// @brief Предел роста SO_RCVBUF (net.core.rmem_max; 0 - не растёт)
+    std::size_t recv_buffer_limit_{0};
+    
+    /// @brief RTT по эхо keepalive (нс; пишет поток relay)
+    core::RelaxedValue<uint32_t> keepalive_sequence_;
+    core::RelaxedValue<uint32_t> echoed_sequence_;
+    core::RelaxedValue<uint64_t> srtt_ns_;
+    core::RelaxedValue<uint64_t> rttvar_ns_;
+    core::RelaxedValue<uint64_t> min_rtt_ns_;
+    core::RelaxedValue<uint64_t> max_rtt_ns_;
+    
+    /// @brief Ранг доставки блоков (пишет поток relay под мьютексом менеджера)
+    core::RelaxedValue<uint32_t> blocks_first_;
+    core::RelaxedValue<uint32_t> blocks_ranked_;
+    core::RelaxedValue<uint64_t> arrival_lag_ns_;
+    
+    /// @brief Политика менеджера: интервал keepalive (0 - из конфигурации) и приоритет
+    core::RelaxedValue<uint32_t> keepalive_interval_ms_;
+    core::RelaxedValue<PeerPriority> priority_;
+    
+    /// @brief Пира опрашивает какой-то поток (poll не входит повторно)
+    std::atomic<bool> polling_{false};
+    
+    /// @brief IPv4 пира (network byte order, 0 - не разрезолвлен) для AF_XDP
+    std::atomic<uint32_t> remote_ip_{0};
     
     /// @brief Callback для пакетов
     PeerPacketCallback packet_callback_;
@@ -61,29 +133,120 @@ struct RelayPeer::Impl {
     }
     
     /**
-     * @brief Обработать полученный UDP пакет
+     * @brief Эхо нашего keepalive: выборка RTT и jitter
+     *
+     * Учитывается только эхо keepalive новее уже учтённого: повтор и
+     * запоздавшее после следующего keepalive эхо не искажают RTT.
      */
-    void handle_packet(const UdpPacket& udp_packet) {
-        // Парсим FIBRE пакет
-        auto parse_result = parser_.parse(udp_packet.data);
-        if (!parse_result) {
-            return;  // Некорректный пакет
+    void on_keepalive_echo(const FibreHeader& header, std::chrono::steady_clock::time_point received_at) {
+        const uint32_t sequence = header.block_height;
+        const uint32_t sent = keepalive_sequence_.load();
+        const uint32_t echoed = echoed_sequence_.load();
+        const uint64_t sent_ns = FibreParser::keepalive_timestamp(header);
+        const uint64_t now_ns = steady_ns(received_at);
+        if (sequence == 0 || sequence > sent || sequence <= echoed || sent_ns > now_ns) {
+            return;
         }
+        echoed_sequence_.store(sequence);
+        keepalives_received_.add();
         
-        const FibrePacket& packet = *parse_result;
+        // RFC 6298: rttvar = 3/4 rttvar + 1/4 |srtt - rtt|, srtt = 7/8 srtt + 1/8 rtt
+        const uint64_t rtt = now_ns - sent_ns;
+        const bool first = echoed == 0;
+        const uint64_t srtt = srtt_ns_.load();
+        const uint64_t deviation = first ? rtt / 2 : (srtt > rtt ? srtt - rtt : rtt - srtt);
+        rttvar_ns_.store(ewma(rttvar_ns_.load(), deviation, first, 2));
+        srtt_ns_.store(ewma(srtt, rtt, first, 3));
+        if (first || rtt < min_rtt_ns_.load()) {
+            min_rtt_ns_.store(rtt);
+        }
+        if (rtt > max_rtt_ns_.load()) {
+            max_rtt_ns_.store(rtt);
+        }
+    }
+    
+    /**
+     * @brief Обработать keepalive: эхо нашего - RTT, keepalive пира - ответить эхо
+     */
+    void on_keepalive(const FibreHeader& header, std::chrono::steady_clock::time_point received_at) {
+        if (header.is_keepalive_echo()) {
+            on_keepalive_echo(header, received_at);
+            return;
+        }
+        auto echo = FibreParser::create_keepalive_echo(header);
+        (void)socket_.send(config_.host, config_.port, echo);
+    }
+    
+    /**
+     * @brief Ядро теряло датаграммы пира: удвоить буфер приёма
+     *
+     * Всплеск FIBRE блока - сотни датаграмм подряд; всё, что не влезло
+     * в буфер сокета, приходится восстанавливать FEC. Буфер растёт
+     * до net.core.rmem_max: выше без CAP_NET_ADMIN ядро не поднимет.
+     *
+     * @param drops Накопленные потери сокета
+     */
+    void on_kernel_drops(uint64_t drops) {
+        kernel_drops_.store(drops);
+        last_drop_time_.store(std::chrono::steady_clock::now());
+        if (recv_buffer_limit_ == 0) {
+            return;
+        }
+        // getsockopt отдаёт удвоенный запрос (ядро учитывает служебные данные)
+        const std::size_t requested = socket_.recv_buffer_size() / 2;
+        const std::size_t target = std::min(requested * 2, recv_buffer_limit_);
+        if (target <= requested || !socket_.set_recv_buffer_size(target)) {
+            return;
+        }
+        recv_buffer_grows_.add();
+        recv_buffer_bytes_.store(socket_.recv_buffer_size());
+    }
+    
+    /**
+     * @brief Обработать пачку датаграмм (один recvmmsg)
+     */
+    void handle_burst(std::span<const UdpDatagram> datagrams) {
+        if (views_.size() < datagrams.size()) {
+            views_.resize(datagrams.size());
+        }
+        // Заголовки пачки разбираются разом, payload остаётся в slab сокета
+        const auto packets = parser_.parse_batch(datagrams, views_);
+        if (packets.empty()) {
+            return;  // Некорректные пакеты
+        }
         
         // Обновляем статистику
-        ++stats_.packets_received;
-        stats_.bytes_received += udp_packet.data.size();
-        stats_.last_packet_time = udp_packet.received_at;
+        std::size_t bytes = 0;
+        for (const auto& packet : packets) {
+            bytes += FIBRE_HEADER_SIZE + packet.payload.size();
+        }
+        packets_received_.add(packets.size());
+        bytes_received_.add(bytes);
+        const auto received_at = datagrams.back().received_at;
+        last_packet_time_.store(received_at);
         
-        // Обрабатываем keepalive
+        // Быстрая полоса: keepalive, чанки с header и LastChunk - раньше
+        // тела блоков, сколько бы чанков ни пришло в пачке перед ними
+        for (const auto& packet : packets) {
+            if (packet.header.is_priority()) {
+                dispatch(packet, received_at);
+            }
+        }
+        for (const auto& packet : packets) {
+            if (!packet.header.is_priority()) {
+                dispatch(packet, received_at);
+            }
+        }
+    }
+    
+    /**
+     * @brief Передать разобранный пакет: keepalive - себе, чанк - менеджеру
+     */
+    void dispatch(const FibrePacketView& packet, std::chrono::steady_clock::time_point received_at) {
         if (packet.header.is_keepalive()) {
-            ++stats_.keepalives_received;
+            on_keepalive(packet.header, received_at);
             return;
         }
-        
-        // Вызываем callback
         if (packet_callback_) {
             packet_callback_(packet);
         }
@@ -118,10 +281,33 @@ Result<void> RelayPeer::connect() {
         return bind_result;
     }
     
-    // Устанавливаем callback для приёма
-    impl_->socket_.set_receive_callback([this](const UdpPacket& packet) {
-        impl_->handle_packet(packet);
-    });
+    // Пакетный приём: FIBRE блок приходит всплеском из сотен chunk'ов
+    impl_->socket_.set_recv_batch_size(impl_->config_.recv_batch);
+    // Обе опции необязательны: без UDP_GRO остаётся обычный recvmmsg, а
+    // busy poll выше net.core.busy_read без CAP_NET_ADMIN не поднять
+    if (impl_->config_.udp_gro) {
+        (void)impl_->socket_.set_gro(true);
+    }
+    if (impl_->config_.busy_poll_us > 0) {
+        (void)impl_->socket_.set_busy_poll(impl_->config_.busy_poll_us);
+    }
+    // Потери на переполненном буфере видны по SO_RXQ_OVFL; без него
+    // (не Linux) буфер остаётся начальным
+    if (impl_->config_.recv_buffer_size > 0) {
+        (void)impl_->socket_.set_recv_buffer_size(impl_->config_.recv_buffer_size);
+    }
+    const bool drops_visible = impl_->socket_.set_drop_monitoring(true).has_value();
+    impl_->recv_buffer_limit_ = drops_visible && impl_->config_.recv_buffer_autotune
+        ? max_recv_buffer_size() : 0;
+    impl_->recv_buffer_bytes_.store(impl_->socket_.recv_buffer_size());
+    
+    // Адрес для сопоставления датаграмм AF_XDP (IPv6 и ошибки - только сокет)
+    if (auto ip = resolve_hostname(impl_->config_.host)) {
+        struct in_addr addr{};
+        if (inet_pton(AF_INET, ip->c_str(), &addr) == 1) {
+            impl_->remote_ip_.store(addr.s_addr, std::memory_order_relaxed);
+        }
+    }
     
     // Отправляем первый keepalive
     auto keepalive_result = send_keepalive();
@@ -130,7 +316,7 @@ Result<void> RelayPeer::connect() {
         return keepalive_result;
     }
     
-    impl_->stats_.connected_at = std::chrono::steady_clock::now();
+    impl_->connected_at_.store(std::chrono::steady_clock::now());
     impl_->set_state(PeerState::Connected);
     
     return {};
@@ -163,13 +349,44 @@ std::size_t RelayPeer::poll(std::size_t max_packets) {
         impl_->state_.load() != PeerState::Stale) {
         return 0;
     }
+    if (impl_->polling_.exchange(true, std::memory_order_acquire)) {
+        return 0;
+    }
     
-    return impl_->socket_.poll_receive(max_packets);
+    const uint64_t syscalls_before = impl_->socket_.stats().recv_syscalls;
+    std::size_t count = impl_->socket_.receive_burst(
+        [this](std::span<const UdpDatagram> datagrams) { impl_->handle_burst(datagrams); },
+        max_packets
+    );
+    impl_->recv_syscalls_.add(impl_->socket_.stats().recv_syscalls - syscalls_before);
+    const uint64_t drops = impl_->socket_.stats().kernel_drops;
+    if (drops != impl_->kernel_drops_.load()) {
+        impl_->on_kernel_drops(drops);
+    }
+    impl_->polling_.store(false, std::memory_order_release);
+    return count;
+}
+
+void RelayPeer::deliver(const UdpDatagram& datagram) {
+    impl_->handle_burst(std::span<const UdpDatagram>(&datagram, 1));
+}
+
+void RelayPeer::deliver(std::span<const UdpDatagram> datagrams) {
+    impl_->handle_burst(datagrams);
+}
+
+bool RelayPeer::matches(uint32_t sender_ip, uint16_t sender_port) const noexcept {
+    const uint32_t ip = impl_->remote_ip_.load(std::memory_order_relaxed);
+    return ip != 0 && ip == sender_ip && sender_port == impl_->config_.port;
 }
 
 Result<void> RelayPeer::send_keepalive() {
-    auto keepalive = FibreParser::create_keepalive();
+    const uint32_t sequence = impl_->keepalive_sequence_.load() + 1;
+    const auto now = std::chrono::steady_clock::now();
+    auto keepalive = FibreParser::create_keepalive(sequence, steady_ns(now));
     
+    // Номер публикуется до отправки: эхо может прийти раньше возврата send
+    impl_->keepalive_sequence_.store(sequence);
     auto result = impl_->socket_.send(
         impl_->config_.host,
         impl_->config_.port,
@@ -177,13 +394,21 @@ Result<void> RelayPeer::send_keepalive() {
     );
     
     if (result) {
-        ++impl_->stats_.keepalives_sent;
-        impl_->last_keepalive_time_ = std::chrono::steady_clock::now();
+        impl_->keepalives_sent_.add();
+        impl_->last_keepalive_time_ = now;
     }
     
     return result;
 }
 
+Result<void> RelayPeer::send(ByteSpan packet) {
+    return impl_->socket_.send(impl_->config_.host, impl_->config_.port, packet);
+}
+
+Result<std::size_t> RelayPeer::send_batch(std::span<const ByteSpan> packets) {
+    return impl_->socket_.send_batch(UdpEndpoint(impl_->config_.host, impl_->config_.port), packets);
+}
+
 void RelayPeer::update() {
     std::lock_guard<std::mutex> lock(impl_->mutex_);
     
@@ -192,7 +417,7 @@ void RelayPeer::update() {
     // Проверяем неактивность
     if (impl_->state_.load() == PeerState::Connected) {
         auto since_last_packet = std::chrono::duration_cast<std::chrono::milliseconds>(
-            now - impl_->stats_.last_packet_time
+            now - impl_->last_packet_time_.load()
         ).count();
         
         if (static_cast<uint32_t>(since_last_packet) > impl_->config_.stale_timeout_ms) {
@@ -205,9 +430,12 @@ void RelayPeer::update() {
         now - impl_->last_keepalive_time_
     ).count();
     
-    if (static_cast<uint32_t>(since_last_keepalive) >= impl_->config_.keepalive_interval_ms) {
-        // Отправляем keepalive без блокировки мьютекса
-        // (вызываем без lock, чтобы избежать deadlock)
+    const uint32_t interval = impl_->keepalive_interval_ms_.load();
+    if (is_connected() &&
+        static_cast<uint32_t>(since_last_keepalive) >=
+            (interval > 0 ? interval : impl_->config_.keepalive_interval_ms)) {
+        // send_keepalive() не берёт mutex_, поэтому вызов под lock безопасен
+        (void)send_keepalive();
     }
 }
 
@@ -232,13 +460,90 @@ bool RelayPeer::is_connected() const noexcept {
     return state == PeerState::Connected || state == PeerState::Stale;
 }
 
+int RelayPeer::native_handle() const noexcept {
+    return impl_->socket_.native_handle();
+}
+
+int RelayPeer::incoming_cpu() const noexcept {
+    return impl_->socket_.incoming_cpu();
+}
+
+std::chrono::steady_clock::time_point RelayPeer::last_drop_time() const noexcept {
+    return impl_->last_drop_time_.load();
+}
+
 const RelayPeerConfig& RelayPeer::config() const noexcept {
     return impl_->config_;
 }
 
 PeerStats RelayPeer::stats() const {
-    std::lock_guard<std::mutex> lock(impl_->mutex_);
-    return impl_->stats_;
+    PeerStats stats;
+    stats.packets_received = impl_->packets_received_.load();
+    stats.bytes_received = impl_->bytes_received_.load();
+    stats.keepalives_sent = static_cast<uint32_t>(impl_->keepalives_sent_.load());
+    stats.keepalives_received = static_cast<uint32_t>(impl_->keepalives_received_.load());
+    stats.recv_syscalls = impl_->recv_syscalls_.load();
+    stats.kernel_drops = impl_->kernel_drops_.load();
+    stats.recv_buffer_bytes = impl_->recv_buffer_bytes_.load();
+    stats.recv_buffer_grows = static_cast<uint32_t>(impl_->recv_buffer_grows_.load());
+    stats.chunks_first = impl_->chunks_first_.load();
+    stats.chunks_duplicate = impl_->chunks_duplicate_.load();
+    stats.headers_first = static_cast<uint32_t>(impl_->headers_first_.load());
+    stats.blocks_received = static_cast<uint32_t>(impl_->blocks_completed_.load());
+    stats.last_packet_time = impl_->last_packet_time_.load();
+    stats.connected_at = impl_->connected_at_.load();
+    stats.avg_latency_ms = to_ms(impl_->srtt_ns_.load());
+    stats.min_latency_ms = to_ms(impl_->min_rtt_ns_.load());
+    stats.max_latency_ms = to_ms(impl_->max_rtt_ns_.load());
+    stats.jitter_ms = to_ms(impl_->rttvar_ns_.load());
+    const uint32_t echoed = impl_->echoed_sequence_.load();
+    stats.keepalives_unanswered = echoed == 0 ? 0 : impl_->keepalive_sequence_.load() - echoed;
+    stats.blocks_first = impl_->blocks_first_.load();
+    stats.blocks_ranked = impl_->blocks_ranked_.load();
+    stats.arrival_lag_ms = to_ms(impl_->arrival_lag_ns_.load());
+    const uint32_t interval = impl_->keepalive_interval_ms_.load();
+    stats.keepalive_interval_ms = interval > 0 ? interval : impl_->config_.keepalive_interval_ms;
+    stats.priority = priority();
+    return stats;
+}
+
+void RelayPeer::record_race(PeerRaceEvent event) noexcept {
+    switch (event) {
+        case PeerRaceEvent::ChunkFirst: impl_->chunks_first_.add(); break;
+        case PeerRaceEvent::ChunkDuplicate: impl_->chunks_duplicate_.add(); break;
+        case PeerRaceEvent::HeaderFirst: impl_->headers_first_.add(); break;
+        case PeerRaceEvent::BlockCompleted: impl_->blocks_completed_.add(); break;
+    }
+}
+
+void RelayPeer::record_block_arrival(std::chrono::nanoseconds lag) noexcept {
+    const auto lag_ns = static_cast<uint64_t>(std::max<int64_t>(lag.count(), 0));
+    const bool first = impl_->blocks_ranked_.load() == 0;
+    impl_->arrival_lag_ns_.store(ewma(impl_->arrival_lag_ns_.load(), lag_ns, first, 3));
+    impl_->blocks_ranked_.store(impl_->blocks_ranked_.load() + 1);
+    if (lag_ns == 0) {
+        impl_->blocks_first_.store(impl_->blocks_first_.load() + 1);
+    }
+}
+
+void RelayPeer::reset_ranking() noexcept {
+    impl_->blocks_first_.store(0);
+    impl_->blocks_ranked_.store(0);
+    impl_->arrival_lag_ns_.store(0);
+    impl_->priority_.store(PeerPriority::Normal);
+    impl_->keepalive_interval_ms_.store(0);
+}
+
+void RelayPeer::set_keepalive_interval(uint32_t interval_ms) noexcept {
+    impl_->keepalive_interval_ms_.store(interval_ms);
+}
+
+void RelayPeer::set_priority(PeerPriority priority) noexcept {
+    impl_->priority_.store(priority);
+}
+
+PeerPriority RelayPeer::priority() const noexcept {
+    return impl_->priority_.load();
 }
 
 std::string RelayPeer::address_string() const {
@@ -5,9 +5,13 @@
  * Отвечает за:
  * - UDP подключение к FIBRE пиру
  * - Heartbeat / keepalive
- * - Статистика (latency, packet loss)
+ * - Статистика (RTT и jitter по эхо keepalive, ранг доставки блоков)
  * - Автоматическое переподключение
  * 
+ * keepalive несёт номер и метку времени отправки; пир возвращает их
+ * в эхо (Keepalive | Ack), и по эхо считается RTT. keepalive пира
+ * RelayPeer отвечает тем же эхо.
+ * 
  * FIBRE пиры - это серверы, распространяющие новые блоки
  * через UDP с использованием FEC для надёжности.
  */
@@ -21,6 +25,7 @@
 #include <chrono>
 #include <functional>
 #include <memory>
+#include <span>
 #include <string>
 #include <atomic>
 
@@ -50,6 +55,20 @@ enum class PeerState {
     Error
 };
 
+/**
+ * @brief Приоритет пира в опросе (выставляет политика RelayManager)
+ */
+enum class PeerPriority : uint8_t {
+    /// @brief Без данных или в середине ранга
+    Normal,
+    
+    /// @brief Первым доставляет блоки: опрашивается чаще и первым
+    Fast,
+    
+    /// @brief Стабильно отстаёт: опрашивается последним, keepalive реже
+    Slow
+};
+
 /**
  * @brief Статистика пира
  */
@@ -57,36 +76,97 @@ struct PeerStats {
     /// @brief Всего получено пакетов
     uint64_t packets_received{0};
     
-    /// @brief Всего получено байт
+    /// @brief Всего получено байт FIBRE пакетов (заголовок + payload)
     uint64_t bytes_received{0};
     
-    /// @brief Количество полученных блоков
+    /// @brief Блоков, реконструкцию которых завершил чанк этого пира
     uint32_t blocks_received{0};
     
+    /// @brief Чанков, пришедших от пира раньше, чем от остальных
+    uint64_t chunks_first{0};
+    
+    /// @brief Чанков, уже полученных от другого пира (или повторно)
+    uint64_t chunks_duplicate{0};
+    
+    /// @brief Блоков, header которых стал доступен по чанку этого пира
+    uint32_t headers_first{0};
+    
     /// @brief Количество keepalive
     uint32_t keepalives_sent{0};
     
-    /// @brief Количество keepalive ответов
+    /// @brief Количество keepalive ответов (эхо с RTT)
     uint32_t keepalives_received{0};
     
-    /// @brief Средняя задержка (мс)
+    /// @brief keepalive без эхо подряд (0 - пир ещё ни разу не ответил)
+    uint32_t keepalives_unanswered{0};
+    
+    /// @brief Сглаженный RTT по эхо keepalive (мс, EWMA 1/8)
     double avg_latency_ms{0.0};
     
-    /// @brief Минимальная задержка (мс)
+    /// @brief Минимальный RTT (мс)
     double min_latency_ms{0.0};
     
-    /// @brief Максимальная задержка (мс)
+    /// @brief Максимальный RTT (мс)
     double max_latency_ms{0.0};
     
+    /// @brief Jitter: сглаженное отклонение RTT (мс, RFC 6298)
+    double jitter_ms{0.0};
+    
+    /// @brief Блоков, первый чанк которых пришёл от этого пира раньше всех
+    uint32_t blocks_first{0};
+    
+    /// @brief Блоков, хотя бы один чанк которых пришёл от пира
+    uint32_t blocks_ranked{0};
+    
+    /// @brief Отставание первого чанка блока от самого раннего (мс, EWMA 1/8)
+    double arrival_lag_ms{0.0};
+    
+    /// @brief Текущий интервал keepalive (мс, с учётом политики менеджера)
+    uint32_t keepalive_interval_ms{0};
+    
+    /// @brief Приоритет в опросе
+    PeerPriority priority{PeerPriority::Normal};
+    
     /// @brief Потеря пакетов (0.0 - 1.0)
     double packet_loss{0.0};
     
+    /// @brief Системных вызовов приёма
+    uint64_t recv_syscalls{0};
+    
+    /// @brief Датаграмм, отброшенных ядром на переполненном буфере сокета
+    uint64_t kernel_drops{0};
+    
+    /// @brief Фактический буфер приёма сокета (байт, SO_RCVBUF)
+    uint64_t recv_buffer_bytes{0};
+    
+    /// @brief Увеличений буфера приёма после потерь (recv_buffer_autotune)
+    uint32_t recv_buffer_grows{0};
+    
     /// @brief Время последнего пакета
     std::chrono::steady_clock::time_point last_packet_time;
     
     /// @brief Время подключения
     std::chrono::steady_clock::time_point connected_at;
     
+    /// @brief Доля чанков пира, выигравших гонку (0.0 - 1.0)
+    [[nodiscard]] double first_chunk_ratio() const noexcept {
+        const uint64_t total = chunks_first + chunks_duplicate;
+        return total == 0 ? 0.0
+            : static_cast<double>(chunks_first) / static_cast<double>(total);
+    }
+    
+    /// @brief Доля блоков, которые пир доставил первым (0.0 - 1.0)
+    [[nodiscard]] double first_block_ratio() const noexcept {
+        return blocks_ranked == 0 ? 0.0
+            : static_cast<double>(blocks_first) / static_cast<double>(blocks_ranked);
+    }
+    
+    /// @brief Пакетов на системный вызов приёма (эффективность recvmmsg)
+    [[nodiscard]] double packets_per_syscall() const noexcept {
+        return recv_syscalls == 0 ? 0.0
+            : static_cast<double>(packets_received) / static_cast<double>(recv_syscalls);
+    }
+    
     /// @brief Время работы в секундах
     [[nodiscard]] double uptime_seconds() const {
         if (connected_at.time_since_epoch().count() == 0) {
@@ -98,14 +178,33 @@ struct PeerStats {
     }
 };
 
+/**
+ * @brief Исход гонки за чанк между пирами одного блока
+ */
+enum class PeerRaceEvent : uint8_t {
+    /// @brief Чанк пришёл первым
+    ChunkFirst,
+    
+    /// @brief Чанк уже был получен (от другого пира или повтор)
+    ChunkDuplicate,
+    
+    /// @brief Чанк пира дал header блока
+    HeaderFirst,
+    
+    /// @brief Чанк пира завершил реконструкцию блока
+    BlockCompleted
+};
+
 // =============================================================================
 // Callback типы
 // =============================================================================
 
 /**
  * @brief Callback при получении FIBRE пакета
+ *
+ * payload пакета действителен только во время вызова.
  */
-using PeerPacketCallback = std::function<void(const FibrePacket& packet)>;
+using PeerPacketCallback = std::function<void(const FibrePacketView& packet)>;
 
 /**
  * @brief Callback при изменении состояния пира
@@ -140,6 +239,21 @@ struct RelayPeerConfig {
     
     /// @brief Включить автопереподключение
     bool auto_reconnect{true};
+    
+    /// @brief Датаграмм на один recvmmsg
+    std::size_t recv_batch{DEFAULT_UDP_RECV_BATCH};
+    
+    /// @brief Включить UDP_GRO (если ядро поддерживает)
+    bool udp_gro{false};
+    
+    /// @brief SO_BUSY_POLL (мкс, 0 - выключен)
+    uint32_t busy_poll_us{0};
+    
+    /// @brief Начальный SO_RCVBUF (байт, 0 - по умолчанию ядра)
+    std::size_t recv_buffer_size{0};
+    
+    /// @brief Удваивать SO_RCVBUF (до net.core.rmem_max), когда ядро теряет датаграммы
+    bool recv_buffer_autotune{true};
 };
 
 // =============================================================================
@@ -217,7 +331,9 @@ public:
     /**
      * @brief Обработать входящие пакеты
      * 
-     * Должен вызываться периодически из event loop.
+     * Должен вызываться периодически из event loop. Вызов из второго
+     * потока, пока первый ещё опрашивает пира (пир переходит между
+     * потоками приёма), сразу возвращает 0.
      * 
      * @param max_packets Максимальное количество пакетов
      * @return Количество обработанных пакетов
@@ -225,16 +341,56 @@ public:
     std::size_t poll(std::size_t max_packets = 100);
     
     /**
-     * @brief Отправить keepalive
+     * @brief Обработать датаграмму, принятую в обход сокета пира (AF_XDP)
+     * 
+     * @param datagram Датаграмма от этого пира (см. matches)
+     */
+    void deliver(const UdpDatagram& datagram);
+    
+    /**
+     * @brief Обработать пачку датаграмм как один recvmmsg
+     * 
+     * Чанки пачки идут в callback в порядке полос (FibreHeader::is_priority).
+     */
+    void deliver(std::span<const UdpDatagram> datagrams);
+    
+    /**
+     * @brief Датаграмма с этого адреса - от пира?
+     * 
+     * Адрес пира резолвится в connect(); до подключения - false.
+     * 
+     * @param sender_ip IPv4 отправителя (network byte order)
+     * @param sender_port Порт отправителя
+     */
+    [[nodiscard]] bool matches(uint32_t sender_ip, uint16_t sender_port) const noexcept;
+    
+    /**
+     * @brief Отправить keepalive (номер и метка времени для RTT)
      * 
      * @return Успех или ошибка
      */
     [[nodiscard]] Result<void> send_keepalive();
     
     /**
-     * @brief Обновить состояние (проверить таймауты)
+     * @brief Отправить готовый FIBRE пакет
+     * 
+     * @param packet Сериализованный пакет
+     * @return Успех или ошибка
+     */
+    [[nodiscard]] Result<void> send(ByteSpan packet);
+    
+    /**
+     * @brief Отправить пачку пакетов пиру (sendmmsg)
      * 
-     * Должен вызываться периодически.
+     * @param packets Сериализованные пакеты
+     * @return Сколько отправлено или ошибка
+     */
+    [[nodiscard]] Result<std::size_t> send_batch(std::span<const ByteSpan> packets);
+    
+    /**
+     * @brief Обновить состояние (проверить таймауты, отправить keepalive)
+     * 
+     * Должен вызываться периодически (таймер RelayManager).
      */
     void update();
     
@@ -267,6 +423,21 @@ public:
      */
     [[nodiscard]] bool is_connected() const noexcept;
     
+    /**
+     * @brief Дескриптор UDP сокета пира (-1 если не подключен)
+     */
+    [[nodiscard]] int native_handle() const noexcept;
+    
+    /**
+     * @brief CPU, на котором ядро принимает трафик пира (-1 - неизвестно)
+     */
+    [[nodiscard]] int incoming_cpu() const noexcept;
+    
+    /**
+     * @brief Момент, когда poll последний раз увидел потери ядра (epoch - не было)
+     */
+    [[nodiscard]] std::chrono::steady_clock::time_point last_drop_time() const noexcept;
+    
     /**
      * @brief Конфигурация пира
      */
@@ -277,6 +448,41 @@ public:
      */
     [[nodiscard]] PeerStats stats() const;
     
+    /**
+     * @brief Учесть исход гонки за чанк (вызывает RelayManager)
+     * 
+     * По этим счётчикам пиры ранжируются по реальной латентности блоков:
+     * медленный пир почти все чанки отдаёт дубликатами.
+     */
+    void record_race(PeerRaceEvent event) noexcept;
+    
+    /**
+     * @brief Учесть приход первого чанка блока от пира (вызывает RelayManager)
+     * 
+     * @param lag Отставание от самого раннего первого чанка блока (0 - пир первый)
+     */
+    void record_block_arrival(std::chrono::nanoseconds lag) noexcept;
+    
+    /**
+     * @brief Сбросить ранг доставки блоков (пир вернулся после отключения)
+     */
+    void reset_ranking() noexcept;
+    
+    /**
+     * @brief Интервал keepalive (мс, 0 - из конфигурации)
+     */
+    void set_keepalive_interval(uint32_t interval_ms) noexcept;
+    
+    /**
+     * @brief Приоритет в опросе
+     */
+    void set_priority(PeerPriority priority) noexcept;
+    
+    /**
+     * @brief Текущий приоритет (одна relaxed загрузка)
+     */
+    [[nodiscard]] PeerPriority priority() const noexcept;
+    
     /**
      * @brief Адрес пира как строка
      */
@@ -0,0 +1,143 @@
+/**
+ * @file tx_cache.cpp
+ * @brief Реализация кеша транзакций mempool
+ */
+
+#include "tx_cache.hpp"
+#include "../crypto/sha256.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <unordered_map>
+
+namespace quaxis::relay {
+
+namespace {
+
+/// @brief wtxid уже случаен: хеш таблицы - его первые 8 байт
+struct WtxidHash {
+    std::size_t operator()(const Hash256& wtxid) const noexcept {
+        uint64_t prefix;
+        std::memcpy(&prefix, wtxid.data(), sizeof(prefix));
+        return static_cast<std::size_t>(prefix);
+    }
+};
+
+/// @brief Short id не найден или неоднозначен
+constexpr uint32_t NO_TX = std::numeric_limits<uint32_t>::max();
+
+} // anonymous namespace
+
+struct TxCache::Impl {
+    struct Slot {
+        Hash256 wtxid{};
+        CachedTx tx;
+    };
+
+    std::size_t capacity;
+
+    /// @brief Кольцо транзакций и следующая вытесняемая ячейка
+    std::vector<Slot> slots;
+    std::size_t next{0};
+
+    /// @brief wtxid -> ячейка (дедупликация повторных rawtx)
+    std::unordered_map<Hash256, std::size_t, WtxidHash> index;
+
+    mutable std::mutex mutex;
+
+    explicit Impl(std::size_t cap)
+        : capacity(cap)
+        , slots(cap)
+    {
+        index.reserve(cap);
+    }
+};
+
+TxCache::TxCache(std::size_t capacity)
+    : impl_(std::make_unique<Impl>(capacity))
+{
+}
+
+TxCache::~TxCache() = default;
+
+bool TxCache::add(ByteSpan raw_tx) {
+    if (impl_->capacity == 0 || raw_tx.empty() || raw_tx.size() > MAX_SKETCH_TX_SIZE) {
+        return false;
+    }
+    // Хеш и копия - до мьютекса: match() не ждёт их
+    const Hash256 wtxid = crypto::sha256d(raw_tx);
+    auto tx = std::make_shared<const Bytes>(raw_tx.begin(), raw_tx.end());
+
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    if (impl_->index.contains(wtxid)) {
+        return false;
+    }
+    Impl::Slot& slot = impl_->slots[impl_->next];
+    if (slot.tx) {
+        impl_->index.erase(slot.wtxid);
+    }
+    slot.wtxid = wtxid;
+    slot.tx = std::move(tx);
+    impl_->index.emplace(wtxid, impl_->next);
+    impl_->next = (impl_->next + 1) % impl_->capacity;
+    return true;
+}
+
+std::size_t TxCache::match(const BlockSketch& sketch, std::vector<CachedTx>& out) const {
+    out.assign(sketch.txs.size(), nullptr);
+    if (sketch.txs.empty()) {
+        return 0;
+    }
+
+    // Short id блока -> индекс (совпавшие внутри блока - неоднозначны)
+    std::unordered_map<uint64_t, uint32_t> wanted;
+    wanted.reserve(sketch.txs.size());
+    for (std::size_t i = 0; i < sketch.txs.size(); ++i) {
+        auto [it, inserted] = wanted.emplace(sketch.txs[i].short_id, static_cast<uint32_t>(i));
+        if (!inserted) {
+            it->second = NO_TX;
+        }
+    }
+
+    const ShortIdKey key = short_id_key(sketch.header, sketch.nonce);
+    std::vector<uint8_t> hits(sketch.txs.size(), 0);
+    {
+        std::lock_guard<std::mutex> lock(impl_->mutex);
+        for (const auto& slot : impl_->slots) {
+            if (!slot.tx) {
+                continue;
+            }
+            auto it = wanted.find(short_id(key, slot.wtxid));
+            if (it == wanted.end() || it->second == NO_TX) {
+                continue;
+            }
+            // Вторая транзакция кеша под тем же short id - обе неизвестны
+            const uint32_t index = it->second;
+            hits[index] = static_cast<uint8_t>(std::min(hits[index] + 1, 2));
+            if (hits[index] > 1) {
+                out[index] = nullptr;
+            } else if (slot.tx->size() == sketch.txs[index].size) {
+                out[index] = slot.tx;
+            }
+        }
+    }
+    
+    std::size_t found = 0;
+    for (const auto& tx : out) {
+        found += tx ? 1 : 0;
+    }
+    return found;
+}
+
+std::size_t TxCache::size() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    return impl_->index.size();
+}
+
+std::size_t TxCache::capacity() const noexcept {
+    return impl_->capacity;
+}
+
+} // namespace quaxis::relay
@@ -0,0 +1,88 @@
+/**
+ * @file tx_cache.hpp
+ * @brief Кеш транзакций mempool узла для синтеза FIBRE чанков
+ *
+ * Узел публикует каждую транзакцию, принятую в mempool (ZMQ rawtx), -
+ * к приходу блока большая часть его транзакций уже здесь. По наброску
+ * блока (compact_block.hpp) кеш находит их по short id, и RelayManager
+ * синтезирует покрытые ими data чанки сам вместо ожидания сети.
+ *
+ * Кеш - кольцо фиксированной ёмкости: новая транзакция вытесняет самую
+ * старую. Поиск по short id как в Bitcoin Core для BIP152: ключ свой у
+ * каждого блока, поэтому short id всего кеша пересчитываются на блок
+ * (SipHash 32 байт - десятки наносекунд на транзакцию).
+ *
+ * Thread-safety: add() (поток ZMQ) и match() (поток приёма) - под
+ * мьютексом кеша.
+ */
+
+#pragma once
+
+#include "../core/types.hpp"
+#include "compact_block.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace quaxis::relay {
+
+/**
+ * @brief Транзакция кеша (сериализация с witness)
+ */
+using CachedTx = std::shared_ptr<const Bytes>;
+
+/**
+ * @brief Кольцевой кеш транзакций по wtxid
+ */
+class TxCache {
+public:
+    /**
+     * @brief Создать кеш
+     *
+     * @param capacity Транзакций одновременно (0 - кеш выключен)
+     */
+    explicit TxCache(std::size_t capacity);
+
+    ~TxCache();
+
+    TxCache(const TxCache&) = delete;
+    TxCache& operator=(const TxCache&) = delete;
+
+    /**
+     * @brief Добавить транзакцию
+     *
+     * @param raw_tx Сериализация с witness (как в ZMQ rawtx)
+     * @return false если транзакция уже есть, пуста или больше лимита наброска
+     */
+    bool add(ByteSpan raw_tx);
+
+    /**
+     * @brief Найти транзакции наброска
+     *
+     * Short id, под который попали две транзакции кеша или две
+     * транзакции блока, считается неизвестным; размер найденной
+     * транзакции должен совпасть с наброском.
+     *
+     * @param sketch Набросок блока
+     * @param out Транзакции по индексу наброска (nullptr - не найдена)
+     * @return Число найденных
+     */
+    std::size_t match(const BlockSketch& sketch, std::vector<CachedTx>& out) const;
+
+    /**
+     * @brief Транзакций в кеше
+     */
+    [[nodiscard]] std::size_t size() const;
+
+    /**
+     * @brief Ёмкость кеша
+     */
+    [[nodiscard]] std::size_t capacity() const noexcept;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace quaxis::relay
@@ -9,7 +9,10 @@
 #include "udp_socket.hpp"
 
 #include <algorithm>
+#include <array>
+#include <cerrno>
 #include <cstring>
+#include <fstream>
 #include <stdexcept>
 
 // POSIX сокеты
@@ -19,8 +22,22 @@
 #include <netinet/in.h>
 #include <poll.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
+#ifdef __linux__
+#include <netinet/udp.h>
+#ifndef UDP_GRO
+#define UDP_GRO 104  // linux/udp.h, glibc < 2.31 не экспортирует
+#endif
+#ifndef SOL_UDP
+#define SOL_UDP 17
+#endif
+#ifndef SO_RXQ_OVFL
+#define SO_RXQ_OVFL 40  // asm-generic/socket.h
+#endif
+#endif
+
 namespace quaxis::relay {
 
 // =============================================================================
@@ -79,6 +96,23 @@ bool is_valid_ip(const std::string& address) {
     return false;
 }
 
+UdpEndpoint UdpDatagram::sender() const {
+    struct in_addr addr{};
+    addr.s_addr = sender_ip;
+    char ip_str[INET_ADDRSTRLEN];
+    inet_ntop(AF_INET, &addr, ip_str, sizeof(ip_str));
+    return UdpEndpoint(ip_str, sender_port);
+}
+
+std::size_t max_recv_buffer_size() noexcept {
+    std::ifstream file("/proc/sys/net/core/rmem_max");
+    std::size_t size = 0;
+    if (!(file >> size)) {
+        return 0;
+    }
+    return size;
+}
+
 // =============================================================================
 // Реализация UdpSocket
 // =============================================================================
@@ -102,11 +136,118 @@ struct UdpSocket::Impl {
     /// @brief Буфер приёма
     std::vector<uint8_t> recv_buffer;
     
+    /// @brief Датаграмм на recvmmsg
+    std::size_t batch_size{DEFAULT_UDP_RECV_BATCH};
+    
+    /// @brief Включён UDP_GRO
+    bool gro{false};
+    
+    /// @brief Включён SO_RXQ_OVFL
+    bool drop_monitoring{false};
+    
+    /// @brief Последнее значение счётчика потерь ядра (накопительный, u32)
+    uint32_t kernel_drop_counter{0};
+
+#ifdef __linux__
+    /// @brief Размер буфера ancillary данных одного сообщения (UDP_GRO + SO_RXQ_OVFL)
+    static constexpr std::size_t CONTROL_SIZE = CMSG_SPACE(sizeof(int)) + CMSG_SPACE(sizeof(uint32_t));
+    
+    /**
+     * @brief Заранее выделенные буферы recvmmsg
+     */
+    struct RecvSlab {
+        std::size_t slot_size{0};
+        std::vector<uint8_t> data;
+        std::vector<uint8_t> control;
+        std::vector<struct mmsghdr> messages;
+        std::vector<struct iovec> iovecs;
+        std::vector<struct sockaddr_in> addresses;
+    };
+    RecvSlab slab;
+#endif
+    
+    /// @brief Датаграммы одного recvmmsg для receive_burst (ёмкость переиспользуется)
+    std::vector<UdpDatagram> burst;
+    
+    /// @brief Пакет для poll_receive (буфер переиспользуется)
+    UdpPacket packet;
+    
     /**
      * @brief Конструктор
      */
     Impl() : recv_buffer(UDP_RECV_BUFFER_SIZE) {}
     
+#ifdef __linux__
+    /**
+     * @brief Выделить slab под текущие batch_size / gro
+     */
+    void allocate_slab() {
+        const std::size_t slots = gro ? std::min(batch_size, UDP_GRO_SLOTS) : batch_size;
+        slab.slot_size = gro ? UDP_GRO_SLOT_SIZE : UDP_RECV_SLOT_SIZE;
+        slab.data.assign(slots * slab.slot_size, 0);
+        slab.control.assign(slots * CONTROL_SIZE, 0);
+        slab.messages.assign(slots, mmsghdr{});
+        slab.iovecs.assign(slots, iovec{});
+        slab.addresses.assign(slots, sockaddr_in{});
+        
+        for (std::size_t i = 0; i < slots; ++i) {
+            slab.iovecs[i].iov_base = slab.data.data() + i * slab.slot_size;
+            slab.iovecs[i].iov_len = slab.slot_size;
+            
+            auto& hdr = slab.messages[i].msg_hdr;
+            hdr.msg_iov = &slab.iovecs[i];
+            hdr.msg_iovlen = 1;
+            hdr.msg_name = &slab.addresses[i];
+        }
+    }
+    
+    /**
+     * @brief Сбросить поля, которые recvmmsg перезаписывает
+     */
+    void rearm(std::size_t count) {
+        const bool control = gro || drop_monitoring;
+        for (std::size_t i = 0; i < count; ++i) {
+            auto& hdr = slab.messages[i].msg_hdr;
+            hdr.msg_namelen = sizeof(struct sockaddr_in);
+            hdr.msg_control = control ? slab.control.data() + i * CONTROL_SIZE : nullptr;
+            hdr.msg_controllen = control ? CONTROL_SIZE : 0;
+            hdr.msg_flags = 0;
+        }
+    }
+    
+    /**
+     * @brief Размер сегмента GRO сообщения (0 - сообщение не склеено)
+     */
+    static std::size_t gro_segment_size(struct msghdr& hdr) {
+        for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr); cmsg != nullptr; cmsg = CMSG_NXTHDR(&hdr, cmsg)) {
+            if (cmsg->cmsg_level == SOL_UDP && cmsg->cmsg_type == UDP_GRO) {
+                int segment = 0;
+                std::memcpy(&segment, CMSG_DATA(cmsg), sizeof(segment));
+                return segment > 0 ? static_cast<std::size_t>(segment) : 0;
+            }
+        }
+        return 0;
+    }
+    
+    /**
+     * @brief Учесть счётчик потерь из SO_RXQ_OVFL cmsg сообщения
+     *
+     * Ядро прикладывает cmsg, только когда потери уже были; счётчик
+     * накопительный, прирост считается по модулю 2^32.
+     */
+    void account_drops(struct msghdr& hdr) {
+        for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr); cmsg != nullptr; cmsg = CMSG_NXTHDR(&hdr, cmsg)) {
+            if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SO_RXQ_OVFL) {
+                uint32_t counter = 0;
+                std::memcpy(&counter, CMSG_DATA(cmsg), sizeof(counter));
+                stats_.kernel_drops += counter - kernel_drop_counter;
+                kernel_drop_counter = counter;
+                return;
+            }
+        }
+    }
+#endif
+    
     /**
      * @brief Деструктор
      */
@@ -123,6 +264,14 @@ struct UdpSocket::Impl {
             fd = -1;
         }
         local_port_ = 0;
+        drop_monitoring = false;
+        kernel_drop_counter = 0;
+        if (gro) {
+            gro = false;  // Новый сокет создаётся без UDP_GRO
+#ifdef __linux__
+            slab = {};
+#endif
+        }
     }
     
     /**
@@ -224,6 +373,10 @@ bool UdpSocket::is_open() const noexcept {
     return impl_->fd >= 0;
 }
 
+int UdpSocket::native_handle() const noexcept {
+    return impl_->fd;
+}
+
 uint16_t UdpSocket::local_port() const noexcept {
     return impl_->local_port_;
 }
@@ -244,6 +397,7 @@ std::optional<UdpPacket> UdpSocket::try_receive() {
         reinterpret_cast<struct sockaddr*>(&sender_addr),
         &sender_len
     );
+    ++impl_->stats_.recv_syscalls;
     
     if (received < 0) {
         if (errno == EAGAIN || errno == EWOULDBLOCK) {
@@ -279,9 +433,9 @@ std::optional<UdpPacket> UdpSocket::try_receive() {
     return packet;
 }
 
-Result<UdpPacket> UdpSocket::receive(uint32_t timeout_ms) {
+FastResult<UdpPacket> UdpSocket::receive(uint32_t timeout_ms) {
     if (impl_->fd < 0) {
-        return std::unexpected(Error{
+        return std::unexpected(FastError{
             ErrorCode::NetworkConnectionFailed,
             "Сокет не открыт"
         });
@@ -295,14 +449,11 @@ Result<UdpPacket> UdpSocket::receive(uint32_t timeout_ms) {
     int ret = poll(&pfd, 1, static_cast<int>(timeout_ms));
     
     if (ret < 0) {
-        return std::unexpected(Error{
-            ErrorCode::NetworkRecvFailed,
-            "Ошибка poll: " + std::string(strerror(errno))
-        });
+        return FastErr<UdpPacket>(ErrorCode::NetworkRecvFailed, "Ошибка poll", errno);
     }
     
     if (ret == 0) {
-        return std::unexpected(Error{
+        return std::unexpected(FastError{
             ErrorCode::NetworkTimeout,
             "Таймаут ожидания данных"
         });
@@ -311,7 +462,7 @@ Result<UdpPacket> UdpSocket::receive(uint32_t timeout_ms) {
     // Есть данные
     auto packet = try_receive();
     if (!packet) {
-        return std::unexpected(Error{
+        return std::unexpected(FastError{
             ErrorCode::NetworkRecvFailed,
             "Не удалось получить данные"
         });
@@ -325,22 +476,137 @@ void UdpSocket::set_receive_callback(UdpReceiveCallback callback) {
 }
 
 std::size_t UdpSocket::poll_receive(std::size_t max_packets) {
-    std::size_t count = 0;
+    if (!impl_->receive_callback) {
+        return receive_batch({}, max_packets);
+    }
     
-    while (count < max_packets) {
-        auto packet = try_receive();
-        if (!packet) {
+    return receive_batch([this](const UdpDatagram& datagram) {
+        UdpPacket& packet = impl_->packet;
+        packet.data.assign(datagram.data.begin(), datagram.data.end());
+        packet.sender = datagram.sender();
+        packet.received_at = datagram.received_at;
+        impl_->receive_callback(packet);
+    }, max_packets);
+}
+
+std::size_t UdpSocket::receive_batch(const UdpBatchCallback& callback, std::size_t max_datagrams) {
+    if (!callback) {
+        return receive_burst({}, max_datagrams);
+    }
+    return receive_burst([&callback](std::span<const UdpDatagram> datagrams) {
+        for (const auto& datagram : datagrams) {
+            callback(datagram);
+        }
+    }, max_datagrams);
+}
+
+std::size_t UdpSocket::receive_burst(const UdpBurstCallback& callback, std::size_t max_datagrams) {
+    if (impl_->fd < 0) {
+        return 0;
+    }
+    auto& burst = impl_->burst;
+    
+#ifdef __linux__
+    auto& slab = impl_->slab;
+    if (slab.messages.empty()) {
+        impl_->allocate_slab();
+    }
+    
+    std::size_t delivered = 0;
+    while (delivered < max_datagrams) {
+        const std::size_t want = std::min(slab.messages.size(), max_datagrams - delivered);
+        impl_->rearm(want);
+        
+        int n = recvmmsg(impl_->fd, slab.messages.data(), static_cast<unsigned int>(want),
+                         MSG_DONTWAIT, nullptr);
+        ++impl_->stats_.recv_syscalls;
+        
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                ++impl_->stats_.recv_errors;
+                impl_->report_error("Ошибка приёма: " + std::string(strerror(errno)));
+            }
+            break;
+        }
+        if (n == 0) {
             break;
         }
         
-        ++count;
+        UdpDatagram datagram;
+        datagram.received_at = std::chrono::steady_clock::now();
+        burst.clear();
+        
+        for (int i = 0; i < n; ++i) {
+            auto& message = slab.messages[static_cast<std::size_t>(i)];
+            if (message.msg_hdr.msg_flags & MSG_TRUNC) {
+                ++impl_->stats_.recv_errors;  // Больше слота: не FIBRE chunk
+                continue;
+            }
+            
+            const auto* base = slab.data.data() + static_cast<std::size_t>(i) * slab.slot_size;
+            const std::size_t length = message.msg_len;
+            std::size_t segment = impl_->gro ? Impl::gro_segment_size(message.msg_hdr) : 0;
+            if (segment == 0) {
+                segment = length;
+            }
+            
+            const auto& address = slab.addresses[static_cast<std::size_t>(i)];
+            datagram.sender_ip = address.sin_addr.s_addr;
+            datagram.sender_port = ntohs(address.sin_port);
+            
+            for (std::size_t offset = 0; offset < length; offset += segment) {
+                datagram.data = ByteSpan(base + offset, std::min(segment, length - offset));
+                ++impl_->stats_.packets_received;
+                impl_->stats_.bytes_received += datagram.data.size();
+                ++delivered;
+                burst.push_back(datagram);
+            }
+        }
+        impl_->stats_.last_packet_time = datagram.received_at;
+        if (impl_->drop_monitoring) {
+            // Счётчик накопительный: достаточно последнего сообщения пачки
+            impl_->account_drops(slab.messages[static_cast<std::size_t>(n) - 1].msg_hdr);
+        }
+        if (callback) {
+            callback(burst);
+        }
         
-        if (impl_->receive_callback) {
-            impl_->receive_callback(*packet);
+        if (static_cast<std::size_t>(n) < want) {
+            break;  // Очередь опустела
         }
     }
     
-    return count;
+    return delivered;
+#else
+    // Без recvmmsg: по одному recvfrom на датаграмму
+    std::size_t delivered = 0;
+    while (delivered < max_datagrams) {
+        auto packet = try_receive();
+        if (!packet) {
+            break;
+        }
+        UdpDatagram datagram;
+        datagram.data = ByteSpan(packet->data.data(), packet->data.size());
+        inet_pton(AF_INET, packet->sender.host.c_str(), &datagram.sender_ip);
+        datagram.sender_port = packet->sender.port;
+        datagram.received_at = packet->received_at;
+        ++delivered;
+        if (callback) {
+            callback(std::span<const UdpDatagram>(&datagram, 1));
+        }
+    }
+    return delivered;
+#endif
+}
+
+void UdpSocket::set_recv_batch_size(std::size_t size) {
+    impl_->batch_size = std::clamp<std::size_t>(size, 1, MAX_UDP_RECV_BATCH);
+#ifdef __linux__
+    impl_->slab = {};  // Перевыделится при следующем приёме
+#endif
 }
 
 Result<void> UdpSocket::send(const UdpEndpoint& endpoint, ByteSpan data) {
@@ -390,6 +656,108 @@ Result<void> UdpSocket::send(const std::string& host, uint16_t port, ByteSpan da
     return {};
 }
 
+Result<std::size_t> UdpSocket::send_batch(
+    const UdpEndpoint& endpoint,
+    std::span<const ByteSpan> datagrams
+) {
+    if (datagrams.empty()) {
+        return std::size_t{0};
+    }
+    if (impl_->fd < 0) {
+        auto result = impl_->create_socket();
+        if (!result) {
+            return std::unexpected(result.error());
+        }
+    }
+    
+    auto ip_result = resolve_hostname(endpoint.host);
+    if (!ip_result) {
+        return std::unexpected(ip_result.error());
+    }
+    
+    struct sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(endpoint.port);
+    inet_pton(AF_INET, ip_result->c_str(), &addr.sin_addr);
+    
+    std::size_t sent = 0;
+    int error = 0;
+    
+#ifdef __linux__
+    std::array<struct mmsghdr, UDP_SEND_BATCH> messages{};
+    std::array<struct iovec, UDP_SEND_BATCH> iov{};
+    
+    while (sent < datagrams.size()) {
+        const std::size_t count = std::min(UDP_SEND_BATCH, datagrams.size() - sent);
+        for (std::size_t i = 0; i < count; ++i) {
+            const ByteSpan data = datagrams[sent + i];
+            iov[i].iov_base = const_cast<uint8_t*>(data.data());
+            iov[i].iov_len = data.size();
+            messages[i] = {};
+            messages[i].msg_hdr.msg_name = &addr;
+            messages[i].msg_hdr.msg_namelen = sizeof(addr);
+            messages[i].msg_hdr.msg_iov = &iov[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+        }
+        
+        int n = sendmmsg(impl_->fd, messages.data(), static_cast<unsigned int>(count), 0);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                struct pollfd pfd{impl_->fd, POLLOUT, 0};
+                if (poll(&pfd, 1, UDP_SEND_WAIT_MS) > 0) {
+                    continue;
+                }
+            }
+            error = errno;
+            break;
+        }
+        
+        for (int i = 0; i < n; ++i) {
+            impl_->stats_.bytes_sent += messages[static_cast<std::size_t>(i)].msg_len;
+        }
+        impl_->stats_.packets_sent += static_cast<uint64_t>(n);
+        sent += static_cast<std::size_t>(n);
+    }
+#else
+    while (sent < datagrams.size()) {
+        const ByteSpan data = datagrams[sent];
+        ssize_t n = sendto(impl_->fd, data.data(), data.size(), 0,
+                           reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr));
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                struct pollfd pfd{impl_->fd, POLLOUT, 0};
+                if (poll(&pfd, 1, UDP_SEND_WAIT_MS) > 0) {
+                    continue;
+                }
+            }
+            error = errno;
+            break;
+        }
+        ++impl_->stats_.packets_sent;
+        impl_->stats_.bytes_sent += static_cast<uint64_t>(n);
+        ++sent;
+    }
+#endif
+    
+    if (sent < datagrams.size()) {
+        ++impl_->stats_.send_errors;
+        if (sent == 0) {
+            return std::unexpected(Error{
+                ErrorCode::NetworkSendFailed,
+                "Ошибка отправки: " + std::string(strerror(error))
+            });
+        }
+    }
+    
+    return sent;
+}
+
 Result<void> UdpSocket::set_recv_buffer_size(std::size_t size) {
     if (impl_->fd < 0) {
         return std::unexpected(Error{ErrorCode::NetworkConnectionFailed, "Сокет не открыт"});
@@ -406,6 +774,18 @@ Result<void> UdpSocket::set_recv_buffer_size(std::size_t size) {
     return {};
 }
 
+std::size_t UdpSocket::recv_buffer_size() const noexcept {
+    if (impl_->fd < 0) {
+        return 0;
+    }
+    int buf_size = 0;
+    socklen_t len = sizeof(buf_size);
+    if (getsockopt(impl_->fd, SOL_SOCKET, SO_RCVBUF, &buf_size, &len) < 0 || buf_size < 0) {
+        return 0;
+    }
+    return static_cast<std::size_t>(buf_size);
+}
+
 Result<void> UdpSocket::set_send_buffer_size(std::size_t size) {
     if (impl_->fd < 0) {
         return std::unexpected(Error{ErrorCode::NetworkConnectionFailed, "Сокет не открыт"});
@@ -454,6 +834,85 @@ Result<void> UdpSocket::set_reuse_address(bool enable) {
     return {};
 }
 
+Result<void> UdpSocket::set_gro(bool enable) {
+    if (impl_->fd < 0) {
+        return std::unexpected(Error{ErrorCode::NetworkConnectionFailed, "Сокет не открыт"});
+    }
+    
+#ifdef __linux__
+    int val = enable ? 1 : 0;
+    if (setsockopt(impl_->fd, SOL_UDP, UDP_GRO, &val, sizeof(val)) < 0) {
+        return std::unexpected(Error{
+            ErrorCode::NetworkConnectionFailed,
+            "Не удалось установить UDP_GRO: " + std::string(strerror(errno))
+        });
+    }
+    impl_->gro = enable;
+    impl_->slab = {};
+    return {};
+#else
+    (void)enable;
+    return std::unexpected(Error{ErrorCode::NetworkConnectionFailed, "UDP_GRO недоступен"});
+#endif
+}
+
+Result<void> UdpSocket::set_busy_poll(uint32_t usec) {
+    if (impl_->fd < 0) {
+        return std::unexpected(Error{ErrorCode::NetworkConnectionFailed, "Сокет не открыт"});
+    }
+    
+#ifdef SO_BUSY_POLL
+    int val = static_cast<int>(usec);
+    if (setsockopt(impl_->fd, SOL_SOCKET, SO_BUSY_POLL, &val, sizeof(val)) < 0) {
+        return std::unexpected(Error{
+            ErrorCode::NetworkConnectionFailed,
+            "Не удалось установить SO_BUSY_POLL: " + std::string(strerror(errno))
+        });
+    }
+    return {};
+#else
+    (void)usec;
+    return std::unexpected(Error{ErrorCode::NetworkConnectionFailed, "SO_BUSY_POLL недоступен"});
+#endif
+}
+
+Result<void> UdpSocket::set_drop_monitoring(bool enable) {
+    if (impl_->fd < 0) {
+        return std::unexpected(Error{ErrorCode::NetworkConnectionFailed, "Сокет не открыт"});
+    }
+
+#ifdef __linux__
+    int val = enable ? 1 : 0;
+    if (setsockopt(impl_->fd, SOL_SOCKET, SO_RXQ_OVFL, &val, sizeof(val)) < 0) {
+        return std::unexpected(Error{
+            ErrorCode::NetworkConnectionFailed,
+            "Не удалось установить SO_RXQ_OVFL: " + std::string(strerror(errno))
+        });
+    }
+    impl_->drop_monitoring = enable;
+    return {};
+#else
+    (void)enable;
+    return std::unexpected(Error{ErrorCode::NetworkConnectionFailed, "SO_RXQ_OVFL недоступен"});
+#endif
+}
+
+int UdpSocket::incoming_cpu() const noexcept {
+#ifdef SO_INCOMING_CPU
+    if (impl_->fd < 0) {
+        return -1;
+    }
+    int cpu = -1;
+    socklen_t len = sizeof(cpu);
+    if (getsockopt(impl_->fd, SOL_SOCKET, SO_INCOMING_CPU, &cpu, &len) < 0) {
+        return -1;
+    }
+    return cpu;
+#else
+    return -1;
+#endif
+}
+
 const UdpStats& UdpSocket::stats() const noexcept {
     return impl_->stats_;
 }
@@ -4,6 +4,7 @@
  * 
  * Обёртка над системными UDP сокетами с поддержкой:
  * - Асинхронного приёма пакетов
+ * - Пакетного приёма (recvmmsg в заранее выделенный slab, UDP_GRO)
  * - Множественных endpoint'ов
  * - Статистики (latency, packet loss)
  * - Non-blocking операций
@@ -20,8 +21,10 @@
 #include <functional>
 #include <memory>
 #include <optional>
+#include <span>
 #include <string>
 #include <chrono>
+#include <vector>
 
 namespace quaxis::relay {
 
@@ -38,6 +41,27 @@ inline constexpr std::size_t UDP_RECV_BUFFER_SIZE = 65536;
 /// @brief Таймаут по умолчанию для операций
 inline constexpr uint32_t DEFAULT_UDP_TIMEOUT_MS = 5000;
 
+/// @brief Датаграмм на один recvmmsg по умолчанию
+inline constexpr std::size_t DEFAULT_UDP_RECV_BATCH = 64;
+
+/// @brief Верхняя граница размера пакета приёма
+inline constexpr std::size_t MAX_UDP_RECV_BATCH = 1024;
+
+/// @brief Датаграмм на один sendmmsg
+inline constexpr std::size_t UDP_SEND_BATCH = 64;
+
+/// @brief Ожидание места в буфере отправки перед отказом (мс)
+inline constexpr int UDP_SEND_WAIT_MS = 20;
+
+/// @brief Слот slab без GRO (FIBRE chunk + заголовок с запасом до MTU)
+inline constexpr std::size_t UDP_RECV_SLOT_SIZE = 2048;
+
+/// @brief Слот slab с GRO: ядро склеивает сегменты до 64 КБ
+inline constexpr std::size_t UDP_GRO_SLOT_SIZE = 65536;
+
+/// @brief Слотов slab с GRO (каждый вмещает десятки датаграмм)
+inline constexpr std::size_t UDP_GRO_SLOTS = 8;
+
 // =============================================================================
 // Структуры данных
 // =============================================================================
@@ -102,6 +126,30 @@ struct UdpPacket {
     [[nodiscard]] bool empty() const noexcept { return data.empty(); }
 };
 
+/**
+ * @brief Датаграмма пакетного приёма
+ *
+ * data указывает в slab сокета и действительна только внутри callback.
+ */
+struct UdpDatagram {
+    /// @brief Данные (view в slab)
+    ByteSpan data;
+    
+    /// @brief IPv4 адрес отправителя (network byte order)
+    uint32_t sender_ip{0};
+    
+    /// @brief Порт отправителя
+    uint16_t sender_port{0};
+    
+    /// @brief Время получения (общее для датаграмм одного recvmmsg)
+    std::chrono::steady_clock::time_point received_at;
+    
+    /**
+     * @brief Адрес отправителя строкой (inet_ntop)
+     */
+    [[nodiscard]] UdpEndpoint sender() const;
+};
+
 /**
  * @brief Статистика UDP сокета
  */
@@ -124,6 +172,13 @@ struct UdpStats {
     /// @brief Количество ошибок отправки
     uint64_t send_errors{0};
     
+    /// @brief Системных вызовов приёма (recvmmsg / recvfrom)
+    uint64_t recv_syscalls{0};
+    
+    /// @brief Датаграмм, отброшенных ядром на переполненном буфере приёма
+    /// (SO_RXQ_OVFL, см. set_drop_monitoring)
+    uint64_t kernel_drops{0};
+    
     /// @brief Время последнего пакета
     std::chrono::steady_clock::time_point last_packet_time;
 };
@@ -139,6 +194,20 @@ struct UdpStats {
  */
 using UdpReceiveCallback = std::function<void(const UdpPacket& packet)>;
 
+/**
+ * @brief Callback пакетного приёма (без копирования данных)
+ * 
+ * @param datagram Датаграмма; data действительна только на время вызова
+ */
+using UdpBatchCallback = std::function<void(const UdpDatagram& datagram)>;
+
+/**
+ * @brief Callback пакетного приёма: все датаграммы одного recvmmsg
+ * 
+ * @param datagrams Датаграммы; data действительна только на время вызова
+ */
+using UdpBurstCallback = std::function<void(std::span<const UdpDatagram> datagrams)>;
+
 /**
  * @brief Callback при ошибке
  * 
@@ -205,6 +274,13 @@ public:
      */
     [[nodiscard]] bool is_open() const noexcept;
     
+    /**
+     * @brief Дескриптор сокета (-1 если закрыт)
+     *
+     * Для регистрации в epoll внешнего цикла событий.
+     */
+    [[nodiscard]] int native_handle() const noexcept;
+    
     /**
      * @brief Получить локальный порт
      */
@@ -227,7 +303,7 @@ public:
      * @param timeout_ms Таймаут в миллисекундах
      * @return Пакет или ошибка
      */
-    [[nodiscard]] Result<UdpPacket> receive(uint32_t timeout_ms = DEFAULT_UDP_TIMEOUT_MS);
+    [[nodiscard]] FastResult<UdpPacket> receive(uint32_t timeout_ms = DEFAULT_UDP_TIMEOUT_MS);
     
     /**
      * @brief Установить callback для асинхронного приёма
@@ -239,13 +315,46 @@ public:
     /**
      * @brief Обработать входящие пакеты (вызывает callbacks)
      * 
-     * Должен вызываться периодически из event loop.
+     * Должен вызываться периодически из event loop. Читает пакетами
+     * через receive_batch и копирует каждую датаграмму в UdpPacket.
      * 
      * @param max_packets Максимальное количество пакетов за вызов
      * @return Количество обработанных пакетов
      */
     std::size_t poll_receive(std::size_t max_packets = 100);
     
+    /**
+     * @brief Принять доступные датаграммы пакетами (non-blocking)
+     * 
+     * Один recvmmsg забирает до recv_batch_size датаграмм в заранее
+     * выделенный slab; с GRO одно сообщение ядра разрезается на сегменты.
+     * Читает, пока очередь не опустеет или не наберётся max_datagrams.
+     * 
+     * @param callback Обработчик (может быть пустым - датаграммы отбрасываются)
+     * @param max_datagrams Ограничение за вызов (с GRO может быть превышено
+     *                      на сегменты последнего сообщения)
+     * @return Количество датаграмм
+     */
+    std::size_t receive_batch(const UdpBatchCallback& callback, std::size_t max_datagrams = 100);
+    
+    /**
+     * @brief Принять доступные датаграммы, отдавая их пачками
+     * 
+     * То же, что receive_batch, но callback получает сразу все датаграммы
+     * одного recvmmsg (с GRO - все сегменты): разбор FIBRE заголовков идёт
+     * пачкой (FibreParser::parse_batch) прямо по slab.
+     * 
+     * @param callback Обработчик пачки (может быть пустым)
+     * @param max_datagrams Ограничение за вызов
+     * @return Количество датаграмм
+     */
+    std::size_t receive_burst(const UdpBurstCallback& callback, std::size_t max_datagrams = 100);
+    
+    /**
+     * @brief Датаграмм на один recvmmsg (1..MAX_UDP_RECV_BATCH)
+     */
+    void set_recv_batch_size(std::size_t size);
+    
     // =========================================================================
     // Отправка пакетов
     // =========================================================================
@@ -269,6 +378,22 @@ public:
      */
     [[nodiscard]] Result<void> send(const std::string& host, uint16_t port, ByteSpan data);
     
+    /**
+     * @brief Отправить пачку датаграмм одному получателю
+     * 
+     * Адрес резолвится один раз, датаграммы уходят через sendmmsg по
+     * UDP_SEND_BATCH за вызов (без Linux - sendto на каждую). Заполненный
+     * буфер отправки ждётся poll(POLLOUT) до UDP_SEND_WAIT_MS.
+     * 
+     * @param endpoint Адрес получателя
+     * @param datagrams Датаграммы в порядке отправки
+     * @return Сколько датаграмм отправлено (ошибка - если ни одной)
+     */
+    [[nodiscard]] Result<std::size_t> send_batch(
+        const UdpEndpoint& endpoint,
+        std::span<const ByteSpan> datagrams
+    );
+    
     // =========================================================================
     // Опции сокета
     // =========================================================================
@@ -281,6 +406,16 @@ public:
      */
     [[nodiscard]] Result<void> set_recv_buffer_size(std::size_t size);
     
+    /**
+     * @brief Фактический размер буфера приёма (getsockopt SO_RCVBUF)
+     * 
+     * Ядро удваивает запрошенное (учёт служебных данных) и ограничивает
+     * запрос net.core.rmem_max.
+     * 
+     * @return Размер в байтах или 0, если сокет не открыт
+     */
+    [[nodiscard]] std::size_t recv_buffer_size() const noexcept;
+    
     /**
      * @brief Установить размер буфера отправки
      * 
@@ -305,6 +440,50 @@ public:
      */
     [[nodiscard]] Result<void> set_reuse_address(bool enable);
     
+    /**
+     * @brief Включить UDP_GRO (Linux 5.0+)
+     * 
+     * Ядро склеивает последовательные датаграммы одного потока в одно
+     * сообщение; receive_batch разрезает его по размеру сегмента.
+     * 
+     * @param enable Включить GRO
+     * @return Успех или ошибка (ядро без UDP_GRO)
+     */
+    [[nodiscard]] Result<void> set_gro(bool enable);
+    
+    /**
+     * @brief Busy polling очереди NIC при приёме (SO_BUSY_POLL)
+     * 
+     * @param usec Время опроса в микросекундах (0 - выключить); значения
+     *             выше net.core.busy_read требуют CAP_NET_ADMIN
+     * @return Успех или ошибка
+     */
+    [[nodiscard]] Result<void> set_busy_poll(uint32_t usec);
+    
+    /**
+     * @brief Счётчик отброшенных ядром датаграмм (SO_RXQ_OVFL, Linux 2.6.33+)
+     * 
+     * Ядро прикладывает к сообщениям recvmmsg накопленное число потерь
+     * сокета на момент постановки датаграммы в очередь: потери видны с
+     * первой датаграммой, принятой после них. Прирост попадает в
+     * UdpStats::kernel_drops. Приём через recvfrom (try_receive) потери
+     * не видит.
+     * 
+     * @param enable Включить учёт потерь
+     * @return Успех или ошибка
+     */
+    [[nodiscard]] Result<void> set_drop_monitoring(bool enable);
+    
+    /**
+     * @brief CPU, на котором ядро обработало последние датаграммы (SO_INCOMING_CPU)
+     * 
+     * Это CPU очереди NIC (RSS / RPS) трафика сокета: поток приёма на
+     * нём читает данные из того же кеша.
+     * 
+     * @return Номер CPU или -1 (не открыт, нет данных, ядро без опции)
+     */
+    [[nodiscard]] int incoming_cpu() const noexcept;
+    
     // =========================================================================
     // Статистика
     // =========================================================================
@@ -353,4 +532,11 @@ private:
  */
 [[nodiscard]] bool is_valid_ip(const std::string& address);
 
+/**
+ * @brief Предел буфера приёма без CAP_NET_ADMIN (net.core.rmem_max)
+ * 
+ * @return Байт или 0, если значение недоступно
+ */
+[[nodiscard]] std::size_t max_recv_buffer_size() noexcept;
+
 } // namespace quaxis::relay
@@ -0,0 +1,577 @@
+/**
+ * @file xdp_socket.cpp
+ * @brief Реализация приёма FIBRE через AF_XDP
+ */
+
+#include "xdp_socket.hpp"
+#include "fibre_protocol.hpp"
+#include "../core/stats_counter.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <format>
+#include <optional>
+
+#ifdef QUAXIS_HAS_AF_XDP
+
+#include <arpa/inet.h>
+#include <linux/bpf.h>
+#include <linux/if_link.h>
+#include <linux/if_xdp.h>
+#include <net/if.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#endif
+
+namespace quaxis::relay {
+
+#ifdef QUAXIS_HAS_AF_XDP
+
+namespace {
+
+// Смещения в кадре: Ethernet (14) + IPv4 без опций (20) + UDP (8)
+constexpr std::size_t ETH_HEADER_SIZE = 14;
+constexpr std::size_t IP_OFFSET = ETH_HEADER_SIZE;
+constexpr std::size_t UDP_OFFSET = IP_OFFSET + 20;
+constexpr std::size_t PAYLOAD_OFFSET = UDP_OFFSET + 8;
+
+/// @brief Байт версии/IHL IPv4 без опций
+constexpr uint8_t IPV4_NO_OPTIONS = 0x45;
+
+/// @brief Лицензия программы (helper'ы XDP доступны не только GPL)
+constexpr char BPF_LICENSE[] = "Dual MIT/GPL";
+
+/// @brief Размер журнала верификатора при повторной загрузке
+constexpr std::size_t BPF_LOG_SIZE = 4096;
+
+/// @brief Ожидание очереди, которую ещё держит закрытый сокет
+constexpr auto BIND_BUSY_WAIT = std::chrono::milliseconds(500);
+
+int sys_bpf(int cmd, union bpf_attr* attr) {
+    return static_cast<int>(syscall(__NR_bpf, cmd, attr, sizeof(*attr)));
+}
+
+uint64_t ptr_to_u64(const void* ptr) noexcept {
+    return static_cast<uint64_t>(reinterpret_cast<uintptr_t>(ptr));
+}
+
+/// @brief Индексы колец, разделяемых с ядром
+inline uint32_t load_acquire(uint32_t* p) noexcept {
+    return std::atomic_ref<uint32_t>(*p).load(std::memory_order_acquire);
+}
+
+inline void store_release(uint32_t* p, uint32_t v) noexcept {
+    std::atomic_ref<uint32_t>(*p).store(v, std::memory_order_release);
+}
+
+bool is_power_of_two(uint32_t v) noexcept {
+    return v != 0 && (v & (v - 1)) == 0;
+}
+
+// =============================================================================
+// XDP программа
+// =============================================================================
+
+/**
+ * @brief Сборщик BPF инструкций
+ *
+ * Переходы на метку PASS копятся и проставляются в finish().
+ */
+class BpfProgram {
+public:
+    void emit(uint8_t code, uint8_t dst, uint8_t src, int16_t off, int32_t imm) {
+        struct bpf_insn insn{};
+        insn.code = code;
+        insn.dst_reg = dst & 0x0F;
+        insn.src_reg = src & 0x0F;
+        insn.off = off;
+        insn.imm = imm;
+        insns_.push_back(insn);
+    }
+
+    /// @brief dst = *(size *)(src + off)
+    void load(uint8_t size, uint8_t dst, uint8_t src, int16_t off) {
+        emit(BPF_LDX | size | BPF_MEM, dst, src, off, 0);
+    }
+
+    /// @brief if (u32)dst != imm goto PASS
+    void pass_unless_equal(uint8_t dst, uint32_t imm) {
+        pass_jumps_.push_back(insns_.size());
+        emit(BPF_JMP32 | BPF_JNE | BPF_K, dst, 0, 0, static_cast<int32_t>(imm));
+    }
+
+    /// @brief if dst > src goto PASS
+    void pass_if_greater(uint8_t dst, uint8_t src) {
+        pass_jumps_.push_back(insns_.size());
+        emit(BPF_JMP | BPF_JGT | BPF_X, dst, src, 0, 0);
+    }
+
+    /// @brief dst = адрес map (две инструкции ld_imm64)
+    void load_map_fd(uint8_t dst, int map_fd) {
+        emit(BPF_LD | BPF_DW | BPF_IMM, dst, BPF_PSEUDO_MAP_FD, 0, map_fd);
+        emit(0, 0, 0, 0, 0);
+    }
+
+    /// @brief Метка PASS: return XDP_PASS
+    const std::vector<struct bpf_insn>& finish() {
+        const std::size_t pass = insns_.size();
+        for (std::size_t at : pass_jumps_) {
+            insns_[at].off = static_cast<int16_t>(pass - at - 1);
+        }
+        emit(BPF_ALU64 | BPF_MOV | BPF_K, BPF_REG_0, 0, 0, XDP_PASS);
+        emit(BPF_JMP | BPF_EXIT, 0, 0, 0, 0);
+        return insns_;
+    }
+
+private:
+    std::vector<struct bpf_insn> insns_;
+    std::vector<std::size_t> pass_jumps_;
+};
+
+/**
+ * @brief Программа: FIBRE датаграммы в XSKMAP, остальное - в стек
+ *
+ * Проверяется Ethernet IPv4 без опций и без фрагментации, UDP и magic
+ * FibreHeader в первых 4 байтах payload; очередь берётся из
+ * xdp_md.rx_queue_index (нет сокета на очереди - XDP_PASS).
+ */
+std::vector<struct bpf_insn> build_fibre_filter(int map_fd) {
+    BpfProgram prog;
+    // r6 = ctx, r2 = data, r3 = data_end
+    prog.emit(BPF_ALU64 | BPF_MOV | BPF_X, BPF_REG_6, BPF_REG_1, 0, 0);
+    prog.load(BPF_W, BPF_REG_2, BPF_REG_6, static_cast<int16_t>(offsetof(struct xdp_md, data)));
+    prog.load(BPF_W, BPF_REG_3, BPF_REG_6, static_cast<int16_t>(offsetof(struct xdp_md, data_end)));
+
+    // Заголовки и magic целиком в кадре
+    prog.emit(BPF_ALU64 | BPF_MOV | BPF_X, BPF_REG_4, BPF_REG_2, 0, 0);
+    prog.emit(BPF_ALU64 | BPF_ADD | BPF_K, BPF_REG_4, 0, 0, static_cast<int32_t>(PAYLOAD_OFFSET + 4));
+    prog.pass_if_greater(BPF_REG_4, BPF_REG_3);
+
+    // Загрузки u16/u32 идут в порядке хоста: сравниваем с байтами сети
+    prog.load(BPF_H, BPF_REG_5, BPF_REG_2, 12);
+    prog.pass_unless_equal(BPF_REG_5, htons(0x0800));
+    prog.load(BPF_B, BPF_REG_5, BPF_REG_2, static_cast<int16_t>(IP_OFFSET));
+    prog.pass_unless_equal(BPF_REG_5, IPV4_NO_OPTIONS);
+    prog.load(BPF_B, BPF_REG_5, BPF_REG_2, static_cast<int16_t>(IP_OFFSET + 9));
+    prog.pass_unless_equal(BPF_REG_5, IPPROTO_UDP);
+
+    // Фрагменты (MF или ненулевое смещение) собирает стек
+    prog.load(BPF_H, BPF_REG_5, BPF_REG_2, static_cast<int16_t>(IP_OFFSET + 6));
+    prog.emit(BPF_ALU | BPF_AND | BPF_K, BPF_REG_5, 0, 0, htons(0x3FFF));
+    prog.pass_unless_equal(BPF_REG_5, 0);
+
+    prog.load(BPF_W, BPF_REG_5, BPF_REG_2, static_cast<int16_t>(PAYLOAD_OFFSET));
+    prog.pass_unless_equal(BPF_REG_5, htonl(FIBRE_MAGIC));
+
+    // return bpf_redirect_map(&xsks, ctx->rx_queue_index, XDP_PASS)
+    prog.load(BPF_W, BPF_REG_2, BPF_REG_6, static_cast<int16_t>(offsetof(struct xdp_md, rx_queue_index)));
+    prog.load_map_fd(BPF_REG_1, map_fd);
+    prog.emit(BPF_ALU64 | BPF_MOV | BPF_K, BPF_REG_3, 0, 0, XDP_PASS);
+    prog.emit(BPF_JMP | BPF_CALL, 0, 0, 0, BPF_FUNC_redirect_map);
+    prog.emit(BPF_JMP | BPF_EXIT, 0, 0, 0, 0);
+
+    return prog.finish();
+}
+
+/**
+ * @brief Кольцо AF_XDP (fill, completion или RX)
+ */
+struct XdpRing {
+    void* map = nullptr;
+    std::size_t map_size = 0;
+    uint32_t* producer = nullptr;
+    uint32_t* consumer = nullptr;
+    uint32_t* flags = nullptr;
+    void* desc = nullptr;
+    uint32_t mask = 0;
+};
+
+} // anonymous namespace
+
+struct XdpSocket::Impl {
+    XdpSocketConfig config;
+    int fd = -1;
+    int map_fd = -1;
+    int prog_fd = -1;
+    int link_fd = -1;
+    bool zero_copy = false;
+
+    uint8_t* umem = nullptr;
+    std::size_t umem_size = 0;
+
+    XdpRing fill;
+    XdpRing completion;
+    XdpRing rx;
+
+    core::RelaxedCounter received;
+
+    explicit Impl(const XdpSocketConfig& cfg) : config(cfg) {}
+
+    ~Impl() {
+        release();
+    }
+
+    Result<void> fail(const char* what) {
+        int err = errno;
+        release();
+        return Err<void>(
+            ErrorCode::NetworkConnectionFailed,
+            std::format("AF_XDP {}: {}: {}", config.interface, what, strerror(err))
+        );
+    }
+
+    Result<void> open() {
+        if (!is_power_of_two(config.frame_count) || !is_power_of_two(config.ring_size)) {
+            return Err<void>(ErrorCode::ConfigInvalidValue, "AF_XDP: размеры колец должны быть степенью двойки");
+        }
+        const unsigned ifindex = if_nametoindex(config.interface.c_str());
+        if (ifindex == 0) {
+            return fail("if_nametoindex");
+        }
+
+        fd = ::socket(AF_XDP, SOCK_RAW | SOCK_CLOEXEC, 0);
+        if (fd < 0) {
+            return fail("socket");
+        }
+
+        // UMEM: все фреймы сразу в fill ring, fill ring вмещает их все
+        umem_size = std::size_t{config.frame_count} * XDP_FRAME_SIZE;
+        void* area = mmap(nullptr, umem_size, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+        if (area == MAP_FAILED) {
+            return fail("mmap UMEM");
+        }
+        umem = static_cast<uint8_t*>(area);
+
+        struct xdp_umem_reg reg{};
+        reg.addr = ptr_to_u64(umem);
+        reg.len = umem_size;
+        reg.chunk_size = static_cast<uint32_t>(XDP_FRAME_SIZE);
+        if (setsockopt(fd, SOL_XDP, XDP_UMEM_REG, &reg, sizeof(reg)) < 0) {
+            return fail("XDP_UMEM_REG");
+        }
+
+        // Completion ring обязателен для UMEM, хотя передачи нет
+        const uint32_t fill_size = config.frame_count;
+        const uint32_t rx_size = config.ring_size;
+        if (setsockopt(fd, SOL_XDP, XDP_UMEM_FILL_RING, &fill_size, sizeof(fill_size)) < 0 ||
+            setsockopt(fd, SOL_XDP, XDP_UMEM_COMPLETION_RING, &rx_size, sizeof(rx_size)) < 0 ||
+            setsockopt(fd, SOL_XDP, XDP_RX_RING, &rx_size, sizeof(rx_size)) < 0) {
+            return fail("setsockopt ring");
+        }
+
+        struct xdp_mmap_offsets off{};
+        socklen_t optlen = sizeof(off);
+        if (getsockopt(fd, SOL_XDP, XDP_MMAP_OFFSETS, &off, &optlen) < 0) {
+            return fail("XDP_MMAP_OFFSETS");
+        }
+        if (!map_ring(fill, off.fr, fill_size, sizeof(uint64_t), XDP_UMEM_PGOFF_FILL_RING) ||
+            !map_ring(completion, off.cr, rx_size, sizeof(uint64_t), XDP_UMEM_PGOFF_COMPLETION_RING) ||
+            !map_ring(rx, off.rx, rx_size, sizeof(struct xdp_desc), XDP_PGOFF_RX_RING)) {
+            return fail("mmap ring");
+        }
+
+        auto* fill_addrs = static_cast<uint64_t*>(fill.desc);
+        for (uint32_t i = 0; i < fill_size; ++i) {
+            fill_addrs[i] = uint64_t{i} * XDP_FRAME_SIZE;
+        }
+        store_release(fill.producer, fill_size);
+
+        struct sockaddr_xdp addr{};
+        addr.sxdp_family = AF_XDP;
+        addr.sxdp_ifindex = ifindex;
+        addr.sxdp_queue_id = config.queue;
+        addr.sxdp_flags = XDP_ZEROCOPY | XDP_USE_NEED_WAKEUP;
+        if (!bind_queue(addr)) {
+            // Драйвер без поддержки AF_XDP: ядро копирует кадр в UMEM
+            addr.sxdp_flags = XDP_COPY | XDP_USE_NEED_WAKEUP;
+            if (!bind_queue(addr)) {
+                return fail("bind");
+            }
+        }
+
+        struct xdp_options options{};
+        optlen = sizeof(options);
+        if (getsockopt(fd, SOL_XDP, XDP_OPTIONS, &options, &optlen) == 0) {
+            zero_copy = (options.flags & XDP_OPTIONS_ZEROCOPY) != 0;
+        }
+
+        if (auto attached = attach_program(ifindex); !attached) {
+            return attached;
+        }
+        return {};
+    }
+
+    /**
+     * @brief bind к очереди
+     *
+     * UMEM прошлого сокета очереди ядро освобождает отложенно (после
+     * закрытия, в т.ч. при быстром перезапуске), пока очередь занята -
+     * EBUSY: ждём до BIND_BUSY_WAIT.
+     */
+    bool bind_queue(const struct sockaddr_xdp& addr) {
+        const auto deadline = std::chrono::steady_clock::now() + BIND_BUSY_WAIT;
+        while (::bind(fd, reinterpret_cast<const struct sockaddr*>(&addr), sizeof(addr)) < 0) {
+            if (errno != EBUSY || std::chrono::steady_clock::now() >= deadline) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        return true;
+    }
+
+    bool map_ring(XdpRing& ring, const struct xdp_ring_offset& off, uint32_t size,
+                  std::size_t desc_size, off_t pgoff) {
+        ring.map_size = off.desc + size * desc_size;
+        void* ptr = mmap(nullptr, ring.map_size, PROT_READ | PROT_WRITE,
+                         MAP_SHARED | MAP_POPULATE, fd, pgoff);
+        if (ptr == MAP_FAILED) {
+            return false;
+        }
+        auto* base = static_cast<uint8_t*>(ptr);
+        ring.map = ptr;
+        ring.producer = reinterpret_cast<uint32_t*>(base + off.producer);
+        ring.consumer = reinterpret_cast<uint32_t*>(base + off.consumer);
+        ring.flags = reinterpret_cast<uint32_t*>(base + off.flags);
+        ring.desc = base + off.desc;
+        ring.mask = size - 1;
+        return true;
+    }
+
+    /**
+     * @brief XSKMAP с сокетом на своей очереди, программа и BPF link
+     */
+    Result<void> attach_program(unsigned ifindex) {
+        union bpf_attr attr{};
+        attr.map_type = BPF_MAP_TYPE_XSKMAP;
+        attr.key_size = sizeof(uint32_t);
+        attr.value_size = sizeof(int);
+        attr.max_entries = config.queue + 1;
+        map_fd = sys_bpf(BPF_MAP_CREATE, &attr);
+        if (map_fd < 0) {
+            return fail("BPF_MAP_CREATE");
+        }
+
+        const uint32_t key = config.queue;
+        attr = {};
+        attr.map_fd = static_cast<uint32_t>(map_fd);
+        attr.key = ptr_to_u64(&key);
+        attr.value = ptr_to_u64(&fd);
+        attr.flags = BPF_ANY;
+        if (sys_bpf(BPF_MAP_UPDATE_ELEM, &attr) < 0) {
+            return fail("BPF_MAP_UPDATE_ELEM");
+        }
+
+        const auto insns = build_fibre_filter(map_fd);
+        attr = {};
+        attr.prog_type = BPF_PROG_TYPE_XDP;
+        attr.expected_attach_type = BPF_XDP;
+        attr.insns = ptr_to_u64(insns.data());
+        attr.insn_cnt = static_cast<uint32_t>(insns.size());
+        attr.license = ptr_to_u64(BPF_LICENSE);
+        prog_fd = sys_bpf(BPF_PROG_LOAD, &attr);
+        if (prog_fd < 0) {
+            // Повтор с журналом верификатора - только ради сообщения об ошибке
+            std::vector<char> log(BPF_LOG_SIZE, '\0');
+            attr.log_level = 1;
+            attr.log_buf = ptr_to_u64(log.data());
+            attr.log_size = static_cast<uint32_t>(log.size());
+            prog_fd = sys_bpf(BPF_PROG_LOAD, &attr);
+            if (prog_fd < 0) {
+                int err = errno;
+                release();
+                return Err<void>(
+                    ErrorCode::NetworkConnectionFailed,
+                    std::format("AF_XDP {}: BPF_PROG_LOAD: {}: {}",
+                                config.interface, strerror(err), log.data())
+                );
+            }
+        }
+
+        // Драйверный режим, без поддержки драйвера - generic (SKB)
+        for (uint32_t mode : {uint32_t{XDP_FLAGS_DRV_MODE}, uint32_t{XDP_FLAGS_SKB_MODE}}) {
+            attr = {};
+            attr.link_create.prog_fd = static_cast<uint32_t>(prog_fd);
+            attr.link_create.target_ifindex = ifindex;
+            attr.link_create.attach_type = BPF_XDP;
+            attr.link_create.flags = mode;
+            link_fd = sys_bpf(BPF_LINK_CREATE, &attr);
+            if (link_fd >= 0) {
+                return {};
+            }
+        }
+        return fail("BPF_LINK_CREATE");
+    }
+
+    std::size_t receive_batch(const UdpBatchCallback& callback, std::size_t max_datagrams) {
+        std::size_t delivered = 0;
+        const auto* descs = static_cast<const struct xdp_desc*>(rx.desc);
+        auto* fill_addrs = static_cast<uint64_t*>(fill.desc);
+
+        while (delivered < max_datagrams) {
+            const uint32_t cons = *rx.consumer;
+            const uint32_t available = load_acquire(rx.producer) - cons;
+            if (available == 0) {
+                break;
+            }
+            const uint32_t n = static_cast<uint32_t>(
+                std::min<std::size_t>(available, max_datagrams - delivered));
+            const auto now = std::chrono::steady_clock::now();
+
+            // Фреймы ещё в RX кольце: payload действителен до возврата в fill
+            uint32_t fill_prod = *fill.producer;
+            for (uint32_t i = 0; i < n; ++i) {
+                const struct xdp_desc& desc = descs[(cons + i) & rx.mask];
+                const uint8_t* frame = umem + desc.addr;
+                if (auto datagram = parse_frame(frame, desc.len, now)) {
+                    if (callback) {
+                        callback(*datagram);
+                    }
+                    ++delivered;
+                }
+                // Фреймов столько же, сколько мест в fill ring - место есть всегда
+                fill_addrs[fill_prod++ & fill.mask] = desc.addr & ~uint64_t{XDP_FRAME_SIZE - 1};
+            }
+            store_release(rx.consumer, cons + n);
+            store_release(fill.producer, fill_prod);
+
+            if (load_acquire(fill.flags) & XDP_RING_NEED_WAKEUP) {
+                ::recvfrom(fd, nullptr, 0, MSG_DONTWAIT, nullptr, nullptr);
+            }
+        }
+
+        received.add(delivered);
+        return delivered;
+    }
+
+    /**
+     * @brief Ethernet/IPv4/UDP кадр в датаграмму (XDP программа уже проверила заголовки)
+     */
+    static std::optional<UdpDatagram> parse_frame(
+        const uint8_t* frame,
+        uint32_t len,
+        std::chrono::steady_clock::time_point now
+    ) {
+        if (len < PAYLOAD_OFFSET || frame[IP_OFFSET] != IPV4_NO_OPTIONS ||
+            frame[IP_OFFSET + 9] != IPPROTO_UDP) {
+            return std::nullopt;
+        }
+        uint16_t udp_len = 0;
+        std::memcpy(&udp_len, frame + UDP_OFFSET + 4, sizeof(udp_len));
+        udp_len = ntohs(udp_len);
+        if (udp_len < PAYLOAD_OFFSET - UDP_OFFSET || UDP_OFFSET + udp_len > len) {
+            return std::nullopt;
+        }
+
+        UdpDatagram datagram;
+        datagram.data = ByteSpan(frame + PAYLOAD_OFFSET, udp_len - (PAYLOAD_OFFSET - UDP_OFFSET));
+        std::memcpy(&datagram.sender_ip, frame + IP_OFFSET + 12, sizeof(datagram.sender_ip));
+        uint16_t port = 0;
+        std::memcpy(&port, frame + UDP_OFFSET, sizeof(port));
+        datagram.sender_port = ntohs(port);
+        datagram.received_at = now;
+        return datagram;
+    }
+
+    void release() {
+        // link первым: программа снимается с интерфейса до закрытия сокета
+        for (int* p : {&link_fd, &prog_fd, &map_fd}) {
+            if (*p >= 0) {
+                ::close(*p);
+                *p = -1;
+            }
+        }
+        for (XdpRing* ring : {&fill, &completion, &rx}) {
+            if (ring->map) {
+                munmap(ring->map, ring->map_size);
+            }
+            *ring = XdpRing{};
+        }
+        if (fd >= 0) {
+            ::close(fd);
+            fd = -1;
+        }
+        if (umem) {
+            munmap(umem, umem_size);
+            umem = nullptr;
+        }
+        zero_copy = false;
+    }
+};
+
+#else // !QUAXIS_HAS_AF_XDP
+
+struct XdpSocket::Impl {
+    XdpSocketConfig config;
+    int fd = -1;
+    int link_fd = -1;
+    bool zero_copy = false;
+    core::RelaxedCounter received;
+
+    explicit Impl(const XdpSocketConfig& cfg) : config(cfg) {}
+
+    Result<void> open() {
+        return Err<void>(ErrorCode::NetworkConnectionFailed, "AF_XDP не поддерживается сборкой");
+    }
+
+    std::size_t receive_batch(const UdpBatchCallback&, std::size_t) {
+        return 0;
+    }
+
+    void release() {}
+};
+
+#endif // QUAXIS_HAS_AF_XDP
+
+XdpSocket::XdpSocket(const XdpSocketConfig& config)
+    : impl_(std::make_unique<Impl>(config))
+{
+}
+
+XdpSocket::~XdpSocket() = default;
+
+Result<void> XdpSocket::open() {
+    if (is_active()) {
+        return {};
+    }
+    return impl_->open();
+}
+
+void XdpSocket::close() {
+    impl_->release();
+}
+
+bool XdpSocket::is_active() const noexcept {
+    return impl_->link_fd >= 0;
+}
+
+bool XdpSocket::is_zero_copy() const noexcept {
+    return impl_->zero_copy;
+}
+
+int XdpSocket::native_handle() const noexcept {
+    return impl_->fd;
+}
+
+std::size_t XdpSocket::receive_batch(const UdpBatchCallback& callback, std::size_t max_datagrams) {
+    if (!is_active()) {
+        return 0;
+    }
+    return impl_->receive_batch(callback, max_datagrams);
+}
+
+uint64_t XdpSocket::datagrams_received() const noexcept {
+    return impl_->received.load();
+}
+
+} // namespace quaxis::relay
@@ -0,0 +1,129 @@
+/**
+ * @file xdp_socket.hpp
+ * @brief Приём FIBRE в обход сетевого стека (AF_XDP)
+ *
+ * Всплеск блока FIBRE - сотни датаграмм за миллисекунды; через обычный
+ * сокет каждая проходит IP/UDP стек и копируется в slab recvmmsg.
+ * XdpSocket забирает их раньше:
+ * - на интерфейс вешается XDP программа (собрана здесь же, без clang и
+ *   libbpf), которая по magic FibreHeader в UDP payload перенаправляет
+ *   кадр в XSKMAP, остальной трафик идёт в стек как обычно (XDP_PASS)
+ * - кадр попадает в UMEM - область памяти процесса, разделяемую с
+ *   драйвером; при поддержке драйвера (XDP_ZEROCOPY) NIC пишет прямо в
+ *   неё, иначе ядро копирует кадр один раз (XDP_COPY)
+ * - receive_batch разбирает Ethernet/IPv4/UDP и отдаёт датаграммы тем же
+ *   UdpBatchCallback, что и UdpSocket: payload - view во фрейм UMEM
+ *
+ * Используются системные вызовы напрямую (linux/if_xdp.h, linux/bpf.h).
+ * Без CAP_NET_ADMIN / CAP_BPF, без поддержки ядра или если на интерфейсе
+ * уже стоит XDP программа, open() возвращает ошибку и вызывающий
+ * остаётся на обычных сокетах. Программа снимается при закрытии сокета
+ * (BPF link).
+ *
+ * Обрабатывается одна очередь NIC: кадры других очередей программа
+ * пропускает в стек, и их принимают сокеты пиров.
+ */
+
+#pragma once
+
+#include "../core/types.hpp"
+#include "udp_socket.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace quaxis::relay {
+
+/// @brief Размер фрейма UMEM (кадр до MTU 1500 с запасом)
+inline constexpr std::size_t XDP_FRAME_SIZE = 2048;
+
+/**
+ * @brief Параметры AF_XDP сокета
+ */
+struct XdpSocketConfig {
+    /// @brief Сетевой интерфейс (например, "eth0")
+    std::string interface;
+
+    /// @brief Очередь NIC
+    uint32_t queue{0};
+
+    /// @brief Фреймов UMEM (степень двойки, все сразу в fill ring)
+    uint32_t frame_count{4096};
+
+    /// @brief Размер RX кольца (степень двойки)
+    uint32_t ring_size{2048};
+};
+
+/**
+ * @brief AF_XDP сокет одной очереди NIC с фильтром FIBRE
+ *
+ * Thread-safety: нет, используется рабочим потоком RelayManager.
+ */
+class XdpSocket {
+public:
+    /**
+     * @brief Создать сокет (ресурсы выделяет open())
+     */
+    explicit XdpSocket(const XdpSocketConfig& config);
+
+    ~XdpSocket();
+
+    // Запрещаем копирование
+    XdpSocket(const XdpSocket&) = delete;
+    XdpSocket& operator=(const XdpSocket&) = delete;
+
+    /**
+     * @brief Создать UMEM и кольца, загрузить и подключить XDP программу
+     *
+     * Сначала пробуется XDP_ZEROCOPY и драйверный режим XDP, затем
+     * XDP_COPY и generic (SKB) режим.
+     *
+     * @return Успех или ошибка (нет прав, поддержки ядра или интерфейса)
+     */
+    [[nodiscard]] Result<void> open();
+
+    /**
+     * @brief Закрыть сокет и снять XDP программу
+     */
+    void close();
+
+    /**
+     * @brief Сокет открыт и программа подключена?
+     */
+    [[nodiscard]] bool is_active() const noexcept;
+
+    /**
+     * @brief NIC пишет кадры прямо в UMEM (XDP_ZEROCOPY)?
+     */
+    [[nodiscard]] bool is_zero_copy() const noexcept;
+
+    /**
+     * @brief Дескриптор сокета для epoll (-1 если закрыт)
+     */
+    [[nodiscard]] int native_handle() const noexcept;
+
+    /**
+     * @brief Принять кадры из RX кольца (non-blocking)
+     *
+     * data датаграммы указывает во фрейм UMEM; фрейм возвращается в fill
+     * ring после callback. Не-UDP и обрезанные кадры отбрасываются.
+     *
+     * @param callback Обработчик
+     * @param max_datagrams Ограничение за вызов
+     * @return Количество датаграмм
+     */
+    std::size_t receive_batch(const UdpBatchCallback& callback, std::size_t max_datagrams = 256);
+
+    /**
+     * @brief Принято датаграмм (пишет только поток приёма)
+     */
+    [[nodiscard]] uint64_t datagrams_received() const noexcept;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace quaxis::relay
@@ -4,6 +4,7 @@
  */
 
 #include "adaptive_spin.hpp"
+#include "sequence_futex.hpp"
 
 #include <thread>
 
@@ -28,10 +29,14 @@ uint64_t AdaptiveSpinWait::wait_for_change(
         }
         
         // Выполняем шаг ожидания
-        do_wait_step();
+        do_wait_step(sequence, expected);
     }
 }
 
+void AdaptiveSpinWait::wait_step(const std::atomic<uint64_t>& sequence, uint64_t expected) {
+    do_wait_step(sequence, expected);
+}
+
 void AdaptiveSpinWait::reset() {
     phase_ = 1;
     iteration_ = 0;
@@ -45,7 +50,7 @@ double AdaptiveSpinWait::estimated_cpu_percent() const noexcept {
     switch (phase_) {
         case 1: return 100.0;
         case 2: return 50.0;
-        case 3: return 5.0;
+        case 3: return config_.futex_wait ? 0.0 : 5.0;
         default: return 0.0;
     }
 }
@@ -58,7 +63,7 @@ const AdaptiveSpinConfig& AdaptiveSpinWait::config() const noexcept {
     return config_;
 }
 
-bool AdaptiveSpinWait::do_wait_step() {
+bool AdaptiveSpinWait::do_wait_step(const std::atomic<uint64_t>& sequence, uint64_t expected) {
     if (!config_.enabled) {
         // Если адаптивный режим отключён - всегда spin
         cpu_pause();
@@ -67,6 +72,20 @@ bool AdaptiveSpinWait::do_wait_step() {
     
     ++iteration_;
     
+    if (config_.futex_wait) {
+        // Гибридный режим: spin (фаза 1), затем futex (фаза 3)
+        if (phase_ == 1) {
+            cpu_pause();
+            if (iteration_ >= config_.futex_spin_iterations) {
+                phase_ = 3;
+                iteration_ = 0;
+            }
+        } else {
+            wait_sequence(sequence, expected, std::chrono::microseconds(config_.futex_timeout_us));
+        }
+        return true;
+    }
+    
     switch (phase_) {
         case 1:
             // Фаза 1: Spin с pause
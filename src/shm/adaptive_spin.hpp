@@ -7,6 +7,10 @@
  * - Фаза 2: Yield (~2000 итераций)
  * - Фаза 3: Sleep (200 мкс)
  * 
+ * Гибридный режим (futex_wait = true): короткий spin, затем ожидание
+ * в futex_wait на слове sequence до futex_wake издателя
+ * (см. sequence_futex.hpp) - без фазы yield и без латентности sleep.
+ * 
  * Сброс при обнаружении изменения.
  */
 
@@ -33,6 +37,16 @@ struct AdaptiveSpinConfig {
     
     /// @brief Время sleep в микросекундах (фаза 3)
     uint32_t sleep_us = 200;
+    
+    /// @brief Гибридный режим: spin, затем futex_wait
+    bool futex_wait = false;
+    
+    /// @brief Итерации spin-pause перед futex_wait
+    uint32_t futex_spin_iterations = 200;
+    
+    /// @brief Предел одного futex_wait в микросекундах
+    /// (латентность с издателем без futex_wake)
+    uint32_t futex_timeout_us = 100000;
 };
 
 /**
@@ -66,6 +80,18 @@ public:
         uint64_t expected
     );
     
+    /**
+     * @brief Один шаг ожидания текущей фазы
+     * 
+     * Для циклов, которые между шагами проверяют флаг остановки:
+     * в фазе futex блокирует не дольше futex_timeout_us (раньше -
+     * при wake_sequence()).
+     * 
+     * @param sequence Атомарная переменная для отслеживания
+     * @param expected Ожидаемое текущее значение
+     */
+    void wait_step(const std::atomic<uint64_t>& sequence, uint64_t expected);
+    
     /**
      * @brief Сбросить состояние ожидания
      * 
@@ -84,7 +110,7 @@ public:
      * Основано на текущей фазе:
      * - Фаза 1: ~100%
      * - Фаза 2: ~50%
-     * - Фаза 3: ~5%
+     * - Фаза 3: ~5% (futex: ~0%)
      */
     [[nodiscard]] double estimated_cpu_percent() const noexcept;
     
@@ -110,7 +136,7 @@ private:
      * 
      * @return true если нужно продолжать ожидание
      */
-    bool do_wait_step();
+    bool do_wait_step(const std::atomic<uint64_t>& sequence, uint64_t expected);
     
     /**
      * @brief Перейти к следующей фазе
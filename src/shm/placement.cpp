@@ -0,0 +1,242 @@
+/**
+ * @file placement.cpp
+ * @brief Реализация размещения сегментов и потоков
+ */
+
+#include "placement.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/magic.h>
+#include <linux/mempolicy.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <sys/vfs.h>
+#endif
+
+#include <cerrno>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <sstream>
+
+namespace quaxis::shm {
+
+namespace {
+
+/**
+ * @brief Путь файла сегмента в каталоге hugetlbfs
+ */
+std::string hugetlb_file(const SegmentPlacement& placement, std::string_view name) {
+    while (!name.empty() && name.front() == '/') {
+        name.remove_prefix(1);
+    }
+    std::string path = placement.hugetlb_dir;
+    if (!path.empty() && path.back() != '/') {
+        path += '/';
+    }
+    path += name;
+    return path;
+}
+
+/**
+ * @brief Разобрать список CPU sysfs ("0-3,8-11")
+ */
+std::vector<int> parse_cpu_list(const std::string& list) {
+    std::vector<int> cpus;
+    std::stringstream stream(list);
+    std::string range;
+    while (std::getline(stream, range, ',')) {
+        if (range.empty() || range == "\n") {
+            continue;
+        }
+        int first = 0;
+        int last = 0;
+        auto dash = range.find('-');
+        try {
+            first = std::stoi(range.substr(0, dash));
+            last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+        } catch (const std::exception&) {
+            continue;
+        }
+        for (int cpu = first; cpu <= last; ++cpu) {
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+/**
+ * @brief Прочитать первую строку файла sysfs
+ */
+std::string read_line(const std::string& path) {
+    std::ifstream file(path);
+    std::string line;
+    std::getline(file, line);
+    return line;
+}
+
+#ifdef __linux__
+/**
+ * @brief Закрепить pthread на одном CPU
+ */
+Result<void> pin_native_thread(pthread_t thread, int cpu) {
+    if (cpu < 0 || cpu >= CPU_SETSIZE) {
+        return Err<void>(ErrorCode::ShmInvalidState, std::format("Некорректный CPU {}", cpu));
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    int rc = pthread_setaffinity_np(thread, sizeof(set), &set);
+    if (rc != 0) {
+        return Err<void>(
+            ErrorCode::ShmInvalidState,
+            std::format("Не удалось закрепить поток на CPU {}: {}", cpu, strerror(rc))
+        );
+    }
+    return {};
+}
+#endif
+
+} // anonymous namespace
+
+// =============================================================================
+// Сегменты
+// =============================================================================
+
+Result<int> open_segment(
+    const SegmentPlacement& placement,
+    std::string_view name,
+    int flags,
+    mode_t mode
+) {
+    int fd = -1;
+    std::string path;
+    if (placement.hugetlb_dir.empty()) {
+        path = std::string(name);
+        fd = shm_open(path.c_str(), flags, mode);
+    } else {
+        path = hugetlb_file(placement, name);
+        fd = open(path.c_str(), flags, mode);
+    }
+    if (fd < 0) {
+        return Err<int>(
+            ErrorCode::ShmOpenFailed,
+            std::format("Не удалось открыть shared memory '{}': {}", path, strerror(errno))
+        );
+    }
+    return fd;
+}
+
+Result<void> unlink_segment(const SegmentPlacement& placement, std::string_view name) {
+    std::string path;
+    int rc = 0;
+    if (placement.hugetlb_dir.empty()) {
+        path = std::string(name);
+        rc = shm_unlink(path.c_str());
+    } else {
+        path = hugetlb_file(placement, name);
+        rc = unlink(path.c_str());
+    }
+    if (rc < 0 && errno != ENOENT) {
+        return Err<void>(
+            ErrorCode::ShmOpenFailed,
+            std::format("Не удалось удалить shared memory '{}': {}", path, strerror(errno))
+        );
+    }
+    return {};
+}
+
+bool is_hugetlbfs(int fd) noexcept {
+#ifdef __linux__
+    struct statfs fs{};
+    if (fstatfs(fd, &fs) == 0) {
+        return static_cast<unsigned long>(fs.f_type) == HUGETLBFS_MAGIC;
+    }
+#else
+    (void)fd;
+#endif
+    return false;
+}
+
+std::size_t segment_map_length(int fd, std::size_t size) noexcept {
+#ifdef __linux__
+    struct statfs fs{};
+    if (fstatfs(fd, &fs) == 0 && static_cast<unsigned long>(fs.f_type) == HUGETLBFS_MAGIC && fs.f_bsize > 0) {
+        const auto page = static_cast<std::size_t>(fs.f_bsize);  // размер huge page
+        return (size + page - 1) / page * page;
+    }
+#else
+    (void)fd;
+#endif
+    return size;
+}
+
+// =============================================================================
+// NUMA и CPU
+// =============================================================================
+
+Result<void> bind_to_numa_node(void* addr, std::size_t length, int node) {
+#ifdef __linux__
+    constexpr int MAX_NODES = 1024;
+    constexpr int BITS = static_cast<int>(sizeof(unsigned long) * 8);
+    if (node < 0 || node >= MAX_NODES) {
+        return Err<void>(ErrorCode::ShmMapFailed, std::format("Некорректный NUMA узел {}", node));
+    }
+    unsigned long mask[MAX_NODES / BITS]{};
+    mask[node / BITS] = 1UL << (node % BITS);
+    // maxnode - число бит маски; ядро учитывает maxnode - 1 бит
+    if (syscall(SYS_mbind, addr, length, MPOL_BIND, mask, MAX_NODES, MPOL_MF_MOVE) != 0) {
+        return Err<void>(
+            ErrorCode::ShmMapFailed,
+            std::format("mbind на NUMA узел {} не удался: {}", node, strerror(errno))
+        );
+    }
+    return {};
+#else
+    (void)addr;
+    (void)length;
+    return Err<void>(ErrorCode::ShmMapFailed, std::format("NUMA узел {}: mbind недоступен", node));
+#endif
+}
+
+Result<void> pin_thread_to_cpu(std::thread& thread, int cpu) {
+#ifdef __linux__
+    return pin_native_thread(thread.native_handle(), cpu);
+#else
+    (void)thread;
+    return Err<void>(ErrorCode::ShmInvalidState, std::format("CPU {}: affinity недоступна", cpu));
+#endif
+}
+
+Result<void> pin_current_thread_to_cpu(int cpu) {
+#ifdef __linux__
+    return pin_native_thread(pthread_self(), cpu);
+#else
+    return Err<void>(ErrorCode::ShmInvalidState, std::format("CPU {}: affinity недоступна", cpu));
+#endif
+}
+
+std::vector<int> numa_nodes() {
+    std::vector<int> nodes = parse_cpu_list(read_line("/sys/devices/system/node/online"));
+    if (nodes.empty()) {
+        nodes.push_back(0);
+    }
+    return nodes;
+}
+
+std::vector<int> numa_node_cpus(int node) {
+    std::vector<int> cpus = parse_cpu_list(
+        read_line(std::format("/sys/devices/system/node/node{}/cpulist", node)));
+    if (cpus.empty() && node == 0) {
+        cpus = parse_cpu_list(read_line("/sys/devices/system/cpu/online"));
+    }
+    return cpus;
+}
+
+} // namespace quaxis::shm
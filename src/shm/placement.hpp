@@ -0,0 +1,116 @@
+/**
+ * @file placement.hpp
+ * @brief Размещение сегментов shared memory и потоков подписчиков
+ *
+ * На двухсокетных хостах издатель (bitcoind) и подписчик нередко
+ * оказываются на разных NUMA узлах, и каждый опрос sequence становится
+ * межсокетной передачей cache line. Этот модуль позволяет:
+ *
+ * - Держать сегмент на hugetlbfs (каталог вроде /dev/hugepages) вместо
+ *   /dev/shm: одна страница TLB на сегмент, без вытеснения в swap
+ * - Привязать память сегмента к NUMA узлу (mbind). Страницы выделяются
+ *   при первой записи, поэтому узел надёжно задаётся при создании
+ *   сегмента; подписчик переносит страницы, только если отображает их
+ *   один (MPOL_MF_MOVE)
+ * - Закрепить поток подписчика на CPU того же узла
+ */
+
+#pragma once
+
+#include "../core/types.hpp"
+
+#include <sys/types.h>
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace quaxis::shm {
+
+/**
+ * @brief Где живёт сегмент
+ */
+struct SegmentPlacement {
+    /// @brief Каталог hugetlbfs; пусто - POSIX shm_open (/dev/shm)
+    std::string hugetlb_dir;
+
+    /// @brief NUMA узел памяти сегмента (-1 - политика по умолчанию)
+    int numa_node = -1;
+};
+
+// =============================================================================
+// Сегменты
+// =============================================================================
+
+/**
+ * @brief Открыть сегмент
+ *
+ * Без hugetlb_dir - shm_open(name); иначе open() файла name в каталоге
+ * hugetlbfs (ведущий '/' имени отбрасывается).
+ *
+ * @return Result<int> Файловый дескриптор или ShmOpenFailed
+ */
+[[nodiscard]] Result<int> open_segment(
+    const SegmentPlacement& placement,
+    std::string_view name,
+    int flags,
+    mode_t mode = 0
+);
+
+/**
+ * @brief Удалить сегмент (отсутствующий - не ошибка)
+ */
+[[nodiscard]] Result<void> unlink_segment(const SegmentPlacement& placement, std::string_view name);
+
+/**
+ * @brief Длина отображения / файла для структуры размера size
+ *
+ * На hugetlbfs длина округляется вверх до размера huge page - иначе
+ * ftruncate и mmap отказывают; для остальных ФС возвращается size.
+ */
+[[nodiscard]] std::size_t segment_map_length(int fd, std::size_t size) noexcept;
+
+/**
+ * @brief Лежит ли файл на hugetlbfs
+ */
+[[nodiscard]] bool is_hugetlbfs(int fd) noexcept;
+
+// =============================================================================
+// NUMA и CPU
+// =============================================================================
+
+/**
+ * @brief Привязать отображение к NUMA узлу
+ *
+ * Ещё не выделенные страницы будут выделены на узле; уже выделенные
+ * переносятся, если их отображает только этот процесс.
+ *
+ * @return Result<void> Успех или ShmMapFailed (нет узла, нет прав)
+ */
+[[nodiscard]] Result<void> bind_to_numa_node(void* addr, std::size_t length, int node);
+
+/**
+ * @brief Закрепить поток на CPU
+ *
+ * @return Result<void> Успех или ShmInvalidState (CPU недоступен)
+ */
+[[nodiscard]] Result<void> pin_thread_to_cpu(std::thread& thread, int cpu);
+
+/**
+ * @brief Закрепить текущий поток на CPU
+ */
+[[nodiscard]] Result<void> pin_current_thread_to_cpu(int cpu);
+
+/**
+ * @brief Онлайн NUMA узлы (без sysfs NUMA - один узел 0)
+ */
+[[nodiscard]] std::vector<int> numa_nodes();
+
+/**
+ * @brief CPU узла (без sysfs NUMA - все онлайн CPU для узла 0)
+ */
+[[nodiscard]] std::vector<int> numa_node_cpus(int node);
+
+} // namespace quaxis::shm
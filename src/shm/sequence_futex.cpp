@@ -0,0 +1,79 @@
+/**
+ * @file sequence_futex.cpp
+ * @brief Реализация futex ожидания sequence
+ */
+
+#include "sequence_futex.hpp"
+
+#include <bit>
+#include <climits>
+#include <thread>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+namespace quaxis::shm {
+
+namespace {
+
+static_assert(sizeof(std::atomic<uint64_t>) == sizeof(uint64_t), "sequence должен быть 64-битным словом");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "sequence в shared memory должен быть lock-free");
+
+/**
+ * @brief Младшие 32 бита sequence (слово futex)
+ */
+uint32_t* futex_word(const std::atomic<uint64_t>& sequence) noexcept {
+    // futex_wait / futex_wake память не меняют; const снимается ради сигнатуры syscall
+    auto* words = reinterpret_cast<uint32_t*>(const_cast<std::atomic<uint64_t>*>(&sequence));
+    return std::endian::native == std::endian::little ? words : words + 1;
+}
+
+} // anonymous namespace
+
+uint64_t publish_sequence(std::atomic<uint64_t>& sequence) noexcept {
+    uint64_t next = sequence.fetch_add(1, std::memory_order_release) + 1;
+    wake_sequence(sequence);
+    return next;
+}
+
+void wake_sequence(const std::atomic<uint64_t>& sequence) noexcept {
+#ifdef __linux__
+    // Не FUTEX_PRIVATE_FLAG: подписчик - другой процесс
+    syscall(SYS_futex, futex_word(sequence), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+#else
+    (void)sequence;
+#endif
+}
+
+bool wait_sequence(
+    const std::atomic<uint64_t>& sequence,
+    uint64_t expected,
+    std::chrono::microseconds timeout
+) noexcept {
+    if (sequence.load(std::memory_order_acquire) != expected) {
+        return true;
+    }
+    
+#ifdef __linux__
+    auto seconds = std::chrono::duration_cast<std::chrono::seconds>(timeout);
+    timespec ts{};
+    ts.tv_sec = static_cast<time_t>(seconds.count());
+    ts.tv_nsec = static_cast<long>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(timeout - seconds).count());
+    
+    // Ядро сравнивает слово с expected атомарно с постановкой в очередь:
+    // инкремент между load выше и засыпанием не теряется (EAGAIN)
+    syscall(SYS_futex, futex_word(sequence), FUTEX_WAIT,
+            static_cast<uint32_t>(expected), &ts, nullptr, 0);
+#else
+    std::this_thread::sleep_for(timeout);
+#endif
+    
+    return sequence.load(std::memory_order_acquire) != expected;
+}
+
+} // namespace quaxis::shm
@@ -0,0 +1,62 @@
+/**
+ * @file sequence_futex.hpp
+ * @brief Ожидание sequence в shared memory через futex
+ * 
+ * Подписчик, исчерпавший короткий spin, засыпает в futex_wait на слове
+ * sequence, а издатель после инкремента будит его futex_wake. Ожидание
+ * не тратит CPU, а пробуждение занимает единицы микросекунд (против
+ * sleep фазы 3, добавляющей до sleep_us латентности).
+ * 
+ * Futex работает с 32-битным словом: ожидание идёт на младшей половине
+ * 64-битного sequence, которая меняется при каждом инкременте. Ключ
+ * futex - физическая страница, поэтому ожидание работает между
+ * процессами, отобразившими один сегмент (в том числе PROT_READ).
+ * 
+ * Издатель без futex_wake (старый патч Bitcoin Core) не ломает
+ * подписчика: ожидание ограничено таймаутом, и латентность
+ * деградирует до таймаута. Будить можно и без права записи в
+ * сегмент, поэтому подписчик сам прерывает ожидание при остановке.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace quaxis::shm {
+
+/**
+ * @brief Увеличить sequence и разбудить ожидающих
+ * 
+ * @param sequence Счётчик в shared memory
+ * @return uint64_t Новое значение sequence
+ */
+uint64_t publish_sequence(std::atomic<uint64_t>& sequence) noexcept;
+
+/**
+ * @brief Разбудить всех ожидающих изменения sequence
+ * 
+ * Для издателей, которые меняют sequence сами, и для остановки
+ * подписчика (память не меняется).
+ */
+void wake_sequence(const std::atomic<uint64_t>& sequence) noexcept;
+
+/**
+ * @brief Ждать изменения sequence в futex_wait
+ * 
+ * Возвращается при изменении sequence, по таймауту, сигналу или
+ * ложному пробуждению - вызывающий проверяет результат и повторяет.
+ * 
+ * @param sequence Счётчик в shared memory
+ * @param expected Текущее (уже виденное) значение
+ * @param timeout Предел ожидания
+ * @return true если sequence отличается от expected
+ */
+bool wait_sequence(
+    const std::atomic<uint64_t>& sequence,
+    uint64_t expected,
+    std::chrono::microseconds timeout
+) noexcept;
+
+} // namespace quaxis::shm
@@ -0,0 +1,196 @@
+/**
+ * @file quaxis_stats.cpp
+ * @brief quaxis-stats: чтение сегмента статистики майнера (QuaxisSharedStats)
+ *
+ * Печатает снимок строками "ключ значение" (соединения и chains - по
+ * строке на запись), с --watch - повторяет через заданный интервал.
+ * Сегмент только читается: майнер не замечает опросов.
+ */
+
+#include "metrics/shm_stats.hpp"
+#include "shm/placement.hpp"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using namespace quaxis;
+
+/// @brief Сегмент по умолчанию ([metrics] shm_path)
+constexpr std::string_view DEFAULT_PATH = "/quaxis_stats";
+
+/// @brief Имена fallback::FallbackMode (инструмент не зависит от библиотек майнера)
+constexpr std::array<std::string_view, 3> MODE_NAMES = {"PrimarySHM", "FallbackZMQ", "FallbackStratum"};
+
+/// @brief Имена merged::ChainStatus
+constexpr std::array<std::string_view, 5> CHAIN_STATUS_NAMES = {
+    "Disconnected", "Connecting", "Syncing", "Ready", "Error"};
+
+struct Args {
+    std::string path{DEFAULT_PATH};
+    std::optional<unsigned> watch_ms;
+    bool connections = true;
+    bool show_help = false;
+};
+
+void print_help() {
+    std::cout << R"(
+ИСПОЛЬЗОВАНИЕ:
+    quaxis-stats [ОПЦИИ]
+
+ОПЦИИ:
+    -p, --path NAME      Сегмент статистики (по умолчанию /quaxis_stats)
+    -w, --watch MS       Печатать снимок каждые MS миллисекунд
+    --summary            Без строк соединений
+    -h, --help           Показать эту справку
+
+)";
+}
+
+Args parse_args(int argc, char* argv[]) {
+    Args args;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        if (arg == "-h" || arg == "--help") {
+            args.show_help = true;
+        } else if ((arg == "-p" || arg == "--path") && i + 1 < argc) {
+            args.path = argv[++i];
+        } else if ((arg == "-w" || arg == "--watch") && i + 1 < argc) {
+            args.watch_ms = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--summary") {
+            args.connections = false;
+        }
+    }
+    return args;
+}
+
+template<std::size_t N>
+std::string_view field_string(const char (&field)[N]) {
+    return std::string_view(field, strnlen(field, N));
+}
+
+template<std::size_t N>
+std::string_view name_of(const std::array<std::string_view, N>& names, uint8_t value) {
+    return value < N ? names[value] : std::string_view("unknown");
+}
+
+void print_snapshot(const metrics::ShmStatsSummary& s, const std::vector<metrics::ShmStatsConnection>& connections,
+                    uint64_t version, bool with_connections) {
+    const auto now_ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+    const double age_s = now_ns > s.updated_ns ? static_cast<double>(now_ns - s.updated_ns) / 1e9 : 0.0;
+
+    std::cout << "version " << version << "\n"
+              << "pid " << s.pid << "\n"
+              << "age_seconds " << age_s << "\n"
+              << "uptime_seconds " << (s.updated_ns - s.started_ns) / 1'000'000'000 << "\n"
+              << "fallback_mode " << name_of(MODE_NAMES, s.fallback_mode) << "\n"
+              << "asic_connections " << s.active_connections << "\n"
+              << "asic_connections_total " << s.total_connections << "\n"
+              << "shares_total " << s.total_shares << "\n"
+              << "jobs_sent_total " << s.total_jobs_sent << "\n"
+              << "hashrate_ghs " << s.total_hashrate_ghs << "\n";
+    if (s.relay_enabled) {
+        const auto& r = s.relay;
+        std::cout << "relay_active_peers " << r.active_peers << "\n"
+                  << "relay_connected_peers " << r.connected_peers << "\n"
+                  << "relay_blocks_total " << r.blocks_received << "\n"
+                  << "relay_duplicate_blocks_total " << r.duplicate_blocks << "\n"
+                  << "relay_reconstruction_timeouts_total " << r.reconstruction_timeouts << "\n"
+                  << "relay_evicted_blocks_total " << r.evicted_blocks << "\n"
+                  << "relay_socket_drops_total " << r.socket_drops << "\n"
+                  << "relay_speculative_headers_total " << r.speculative_headers << "\n"
+                  << "relay_invalid_blocks_total " << r.invalid_blocks << "\n"
+                  << "relay_header_p50_us " << r.header_p50_ns / 1000 << "\n"
+                  << "relay_header_p99_us " << r.header_p99_ns / 1000 << "\n"
+                  << "relay_reconstruction_p50_us " << r.reconstruction_p50_ns / 1000 << "\n"
+                  << "relay_reconstruction_p99_us " << r.reconstruction_p99_ns / 1000 << "\n";
+    }
+    for (uint32_t i = 0; i < s.chain_count && i < metrics::SHM_STATS_MAX_CHAINS; ++i) {
+        const auto& c = s.chains[i];
+        std::cout << "chain " << field_string(c.name)
+                  << " status=" << name_of(CHAIN_STATUS_NAMES, c.status)
+                  << " enabled=" << static_cast<int>(c.enabled)
+                  << " height=" << c.height
+                  << " blocks=" << c.blocks_found << "\n";
+    }
+    if (with_connections) {
+        for (const auto& c : connections) {
+            std::cout << "asic " << field_string(c.remote_address)
+                      << " hashrate_ghs=" << c.hashrate_ghs
+                      << " shares=" << c.shares_received
+                      << " jobs=" << c.jobs_sent
+                      << " temperature=" << static_cast<int>(c.temperature)
+                      << " rtt_us=" << c.rtt_us
+                      << " retransmits=" << c.retransmits
+                      << " connected_seconds=" << c.connected_seconds << "\n";
+        }
+    }
+    std::cout << std::flush;
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    const Args args = parse_args(argc, argv);
+    if (args.show_help) {
+        print_help();
+        return 0;
+    }
+
+    const shm::SegmentPlacement placement;
+    auto fd = shm::open_segment(placement, args.path, O_RDONLY);
+    if (!fd) {
+        std::cerr << "quaxis-stats: " << fd.error().message << "\n";
+        return 1;
+    }
+    struct stat st{};
+    if (fstat(*fd, &st) < 0 || static_cast<std::size_t>(st.st_size) < sizeof(metrics::QuaxisSharedStats)) {
+        std::cerr << "quaxis-stats: сегмент " << args.path << " меньше QuaxisSharedStats\n";
+        close(*fd);
+        return 1;
+    }
+    void* ptr = mmap(nullptr, sizeof(metrics::QuaxisSharedStats), PROT_READ, MAP_SHARED, *fd, 0);
+    close(*fd);
+    if (ptr == MAP_FAILED) {
+        std::cerr << "quaxis-stats: не удалось замапить " << args.path << "\n";
+        return 1;
+    }
+
+    const auto& segment = *static_cast<const metrics::QuaxisSharedStats*>(ptr);
+    if (!metrics::is_shm_stats(segment)) {
+        std::cerr << "quaxis-stats: " << args.path << " - не сегмент статистики или другая версия раскладки\n";
+        return 1;
+    }
+
+    metrics::ShmStatsReader reader(segment);
+    metrics::ShmStatsSummary summary;
+    std::vector<metrics::ShmStatsConnection> connections;
+    for (;;) {
+        if (reader.read(summary, connections)) {
+            print_snapshot(summary, connections, reader.version(), args.connections);
+        } else {
+            std::cerr << "quaxis-stats: снимка ещё нет\n";
+        }
+        if (!args.watch_ms) {
+            break;
+        }
+        std::cout << "\n";
+        std::this_thread::sleep_for(std::chrono::milliseconds(*args.watch_ms));
+    }
+    munmap(ptr, sizeof(metrics::QuaxisSharedStats));
+    return 0;
+}
@@ -0,0 +1,24 @@
+/**
+ * @file alloc_counter.hpp
+ * @brief Счётчик аллокаций для бенчмарков
+ *
+ * alloc_counter.cpp подменяет все формы глобальных operator new/delete,
+ * поэтому подключается только в бенчмарки, которые считают аллокации
+ * (benchmark_protocol, benchmark_tip_to_asic, benchmark_coro_io).
+ * Счёт общий для всех потоков процесса.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace quaxis::benchmark {
+
+/**
+ * @brief Число вызовов operator new с запуска процесса
+ *
+ * Разность двух значений - аллокации на измеряемом участке.
+ */
+[[nodiscard]] uint64_t allocation_count() noexcept;
+
+} // namespace quaxis::benchmark
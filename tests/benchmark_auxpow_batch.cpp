@@ -0,0 +1,146 @@
+/**
+ * @file benchmark_auxpow_batch.cpp
+ * @brief Бенчмарк пакетной проверки AuxPoW
+ *
+ * Набор валидных AuxPoW (coinbase branch глубины 12, aux branch 3 -
+ * как у блока с парой тысяч транзакций и дерева на 8 aux chains)
+ * проверяется двумя путями:
+ * 1. AuxPowValidator::validate по одному (скалярный SHA256d на узел)
+ * 2. AuxPowValidator::validate_batch (узлы уровня всех элементов
+ *    пачкой через sha256d64_batch, заголовки через hash_headers)
+ *
+ * Выводится AuxPoW в секунду для нескольких размеров пачки.
+ */
+
+#include <iostream>
+#include <chrono>
+#include <iomanip>
+#include <vector>
+
+#include "core/validation/auxpow_validator.hpp"
+#include "core/chain/chain_registry.hpp"
+#include "crypto/sha256.hpp"
+
+namespace quaxis::benchmark {
+
+using namespace quaxis::core;
+using namespace quaxis::core::validation;
+
+using Clock = std::chrono::steady_clock;
+
+/// @brief Длительность одного прогона
+constexpr auto RUN_TIME = std::chrono::milliseconds(500);
+
+/// @brief Высота после активации AuxPoW Namecoin
+constexpr uint32_t HEIGHT = 500000;
+
+/// @brief Глубины branches
+constexpr std::size_t COINBASE_DEPTH = 12;
+constexpr std::size_t AUX_DEPTH = 3;
+
+/// @brief Приёмник результатов: не даёт компилятору выбросить проверку
+volatile std::size_t g_sink = 0;
+
+AuxPow make_auxpow(uint32_t seed, const Hash256& aux_hash) {
+    AuxPow auxpow;
+    auxpow.coinbase_hash[0] = static_cast<uint8_t>(seed);
+    auxpow.coinbase_hash[1] = static_cast<uint8_t>(seed >> 8);
+    for (std::size_t i = 0; i < COINBASE_DEPTH; ++i) {
+        Hash256 hash{};
+        hash[0] = static_cast<uint8_t>(seed);
+        hash[1] = static_cast<uint8_t>(i);
+        auxpow.coinbase_branch.hashes.push_back(hash);
+    }
+    auxpow.coinbase_branch.index = seed % 4096;
+    for (std::size_t i = 0; i < AUX_DEPTH; ++i) {
+        Hash256 hash{};
+        hash[2] = static_cast<uint8_t>(seed);
+        hash[3] = static_cast<uint8_t>(i);
+        auxpow.aux_branch.hashes.push_back(hash);
+    }
+    auxpow.aux_branch.index = seed % 8;
+
+    AuxPowCommitment commitment;
+    commitment.aux_merkle_root = auxpow.aux_branch.compute_root(aux_hash);
+    auto committed = commitment.serialize();
+    auxpow.coinbase_tx.assign(committed.begin(), committed.end());
+
+    auxpow.parent_header.version = 0x20000000;
+    auxpow.parent_header.merkle_root = auxpow.coinbase_branch.compute_root(auxpow.coinbase_hash);
+    auxpow.parent_header.bits = 0x207fffff;
+    while (!auxpow.parent_header.check_pow()) {
+        ++auxpow.parent_header.nonce;
+    }
+    return auxpow;
+}
+
+/**
+ * @brief Повторять проверку набора, пока не истечёт RUN_TIME
+ *
+ * @return double AuxPoW в секунду
+ */
+template<typename Validate>
+double run(std::size_t items, Validate validate) {
+    uint64_t count = 0;
+    std::size_t sink = 0;
+    auto start = Clock::now();
+    while (Clock::now() - start < RUN_TIME) {
+        sink += validate();
+        count += items;
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    g_sink = sink;
+    return static_cast<double>(count) / seconds;
+}
+
+} // namespace quaxis::benchmark
+
+int main() {
+    using namespace quaxis;
+    using namespace quaxis::benchmark;
+
+    std::cout << "=== Бенчмарк пакетной проверки AuxPoW ===" << std::endl;
+    std::cout << "SHA256: " << crypto::get_implementation_name() << std::endl;
+    std::cout << "branches: coinbase " << COINBASE_DEPTH << ", aux " << AUX_DEPTH << std::endl;
+    std::cout << std::endl;
+
+    AuxPowValidator validator(namecoin_params());
+
+    for (std::size_t items : {1u, 8u, 64u, 512u}) {
+        std::vector<AuxPow> auxpows;
+        std::vector<Hash256> aux_hashes;
+        for (uint32_t i = 0; i < items; ++i) {
+            Hash256 aux_hash{};
+            aux_hash[0] = static_cast<uint8_t>(i);
+            aux_hash[31] = 0x5a;
+            auxpows.push_back(make_auxpow(i, aux_hash));
+            aux_hashes.push_back(aux_hash);
+        }
+        std::vector<AuxPowValidationResult> results(items);
+
+        // Оба пути должны принять весь набор
+        if (validator.validate_batch(auxpows, aux_hashes, HEIGHT, results) != items) {
+            std::cerr << "ОШИБКА: validate_batch отклонил валидный AuxPoW" << std::endl;
+            return 1;
+        }
+
+        double single = run(items, [&] {
+            std::size_t valid = 0;
+            for (std::size_t i = 0; i < items; ++i) {
+                valid += validator.validate(auxpows[i], aux_hashes[i], HEIGHT) ? 1 : 0;
+            }
+            return valid;
+        });
+        double batch = run(items, [&] {
+            return validator.validate_batch(auxpows, aux_hashes, HEIGHT, results);
+        });
+
+        std::cout << "  пачка " << std::setw(4) << items
+                  << "  по одному=" << std::setw(10) << std::fixed << std::setprecision(0) << single << "/s"
+                  << "  batch=" << std::setw(10) << batch << "/s"
+                  << "  x" << std::setprecision(2) << batch / single
+                  << std::endl;
+    }
+
+    return 0;
+}
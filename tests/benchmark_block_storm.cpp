@@ -0,0 +1,585 @@
+/**
+ * @file benchmark_block_storm.cpp
+ * @brief Сценарный бенчмарк "шторм блоков" на параметрах regtest
+ *
+ * Крайние случаи латентности почти не встречаются в mainnet: блоки с
+ * интервалом в секунды, гонка tip, speculative блок, оказавшийся
+ * невалидным. Бенчмарк проигрывает их сценарием через тот же путь, что
+ * on_tip в main.cpp: TemplateCache::take_next_jobs, иначе
+ * core::TemplateGenerator + JobManager::on_new_block, рассылка
+ * Server::broadcast_job_set, затем предвычисление следующего блока.
+ *
+ * Цикл сценария (высота h - текущий tip):
+ * 1. tip     - A1 (h+1), через --interval-ms A2 (h+2)
+ * 2. reorg   - реорганизация на 2 блока: B2 той же высоты, что A2
+ *              (конкурирующий tip), и сразу B3 (h+3). B1 не объявляется:
+ *              tip с меньшей работой узел не сообщает
+ * 3. invalid - speculative S (h+4), через --validation-ms отмена
+ *              (invalidate_speculative_block) и повторное объявление B3
+ *
+ * Симулированные ASIC двух видов:
+ * - N TCP соединений с сервером (как в benchmark_tip_to_asic): время
+ *   прихода кадра задания у каждого
+ * - mining::VirtualAsic: потоки перебора nonce на CPU, отдающие shares в
+ *   ShareValidator; момент переключения каждого потока на новое поколение
+ *
+ * Для каждого события - p50/p99/max (мс):
+ * - stale  - от события до перехода последнего потока VirtualAsic на
+ *            новое задание (для invalid - от объявления S: хеширование
+ *            невалидного блока входит в потерянную работу)
+ * - frame  - от события до кадра задания у последнего TCP ASIC
+ * - frame_skew / hash_skew - разброс по ASIC (первый - последний)
+ * и stale shares, отклонённые валидатором после события.
+ *
+ * Target шаблонов - regtest (core::regtest_params): каждый share
+ * VirtualAsic со сложностью --share-difficulty - блок, он уходит в
+ * ValidBlockCallback (считается, не отправляется).
+ *
+ * Запуск: benchmark_block_storm [--asics N] [--hash-threads T]
+ *         [--cycles C] [--interval-ms I] [--validation-ms V]
+ *         [--share-difficulty D] [--json report.json]
+ */
+
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <optional>
+#include <string>
+#include <iomanip>
+#include <atomic>
+
+#include <sys/socket.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+#include "bitcoin/coinbase.hpp"
+#include "bitcoin/target.hpp"
+#include "core/chain/chain_registry.hpp"
+#include "core/template_generator.hpp"
+#include "mining/job_manager.hpp"
+#include "mining/share_validator.hpp"
+#include "mining/template_cache.hpp"
+#include "mining/virtual_asic.hpp"
+#include "network/protocol.hpp"
+#include "network/server.hpp"
+
+namespace quaxis::benchmark {
+
+using Clock = std::chrono::steady_clock;
+
+/// @brief Награда за блок regtest (до первого халвинга)
+constexpr int64_t COINBASE_VALUE = 5'000'000'000;
+
+/// @brief Порт сервера бенчмарка
+constexpr uint16_t PORT = 43460;
+
+/// @brief Сколько ждать переключения всех ASIC
+constexpr auto SWITCH_TIMEOUT = std::chrono::seconds(5);
+
+/// @brief Виды событий сценария
+enum Event : std::size_t { TIP, REORG, INVALID, EVENT_COUNT };
+
+constexpr const char* EVENT_NAMES[EVENT_COUNT] = {"tip", "reorg", "invalid"};
+
+/// @brief Метрики события
+enum Metric : std::size_t { STALE, FRAME, FRAME_SKEW, HASH_SKEW, METRIC_COUNT };
+
+constexpr const char* METRIC_NAMES[METRIC_COUNT] = {"stale", "frame", "frame_skew", "hash_skew"};
+
+/**
+ * @brief Перцентили метрики (мс)
+ */
+struct Percentiles {
+    double p50 = 0;
+    double p99 = 0;
+    double max = 0;
+};
+
+/**
+ * @brief Итог по виду событий
+ */
+struct EventResult {
+    std::size_t count = 0;
+    std::size_t timeouts = 0;       ///< Не все ASIC переключились за SWITCH_TIMEOUT
+    std::size_t cached = 0;         ///< Задания последней рассылки из TemplateCache
+    uint64_t stale_shares = 0;
+    std::array<Percentiles, METRIC_COUNT> metrics{};
+};
+
+/**
+ * @brief Параметры прогона
+ */
+struct Options {
+    std::size_t asics = 16;
+    std::size_t hash_threads = 2;
+    std::size_t cycles = 50;
+    uint32_t interval_ms = 20;
+    uint32_t validation_ms = 5;
+    double share_difficulty = 0.0001;
+    std::string json_path;
+};
+
+// =============================================================================
+// TCP ASIC
+// =============================================================================
+
+void raise_fd_limit() {
+    struct rlimit lim;
+    if (getrlimit(RLIMIT_NOFILE, &lim) == 0) {
+        lim.rlim_cur = lim.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &lim);
+    }
+}
+
+int connect_client(uint16_t port) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return -1;
+    }
+
+    struct sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+
+    if (connect(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0) {
+        close(fd);
+        return -1;
+    }
+
+    int flags = fcntl(fd, F_GETFL, 0);
+    fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+    return fd;
+}
+
+/**
+ * @brief N соединений ASIC: время прихода кадра NewJob у каждого
+ */
+class MockAsics {
+public:
+    MockAsics(network::Server& server, std::size_t count, uint16_t port) {
+        for (std::size_t i = 0; i < count; ++i) {
+            int fd = connect_client(port);
+            if (fd < 0) {
+                break;
+            }
+            clients_.push_back(fd);
+        }
+
+        auto deadline = Clock::now() + std::chrono::seconds(10);
+        while (server.connection_count() < clients_.size() && Clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+
+        epoll_fd_ = epoll_create1(0);
+        for (std::size_t i = 0; i < clients_.size(); ++i) {
+            struct epoll_event ev{};
+            ev.events = EPOLLIN | EPOLLET;
+            ev.data.u64 = (static_cast<uint64_t>(clients_[i]) << 32) | i;
+            epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, clients_[i], &ev);
+        }
+        received_.resize(clients_.size());
+        arrived_.resize(clients_.size());
+    }
+
+    ~MockAsics() {
+        close(epoll_fd_);
+        for (int fd : clients_) {
+            close(fd);
+        }
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept { return clients_.size(); }
+
+    /**
+     * @brief Дождаться кадра задания у всех ASIC
+     *
+     * @return false если кто-то не получил кадр за секунду
+     */
+    bool wait_all() {
+        std::fill(received_.begin(), received_.end(), 0);
+        std::size_t done = 0;
+        std::array<struct epoll_event, 256> events;
+        std::array<uint8_t, 1024> buffer;
+
+        while (done < received_.size()) {
+            int n = epoll_wait(epoll_fd_, events.data(), static_cast<int>(events.size()), 1000);
+            if (n <= 0) {
+                return false;
+            }
+            for (int i = 0; i < n; ++i) {
+                uint64_t key = events[i].data.u64;
+                int fd = static_cast<int>(key >> 32);
+                std::size_t slot = static_cast<std::size_t>(key & 0xFFFFFFFFu);
+                for (;;) {
+                    ssize_t r = recv(fd, buffer.data(), buffer.size(), 0);
+                    if (r <= 0) {
+                        break;
+                    }
+                    std::size_t before = received_[slot];
+                    received_[slot] += static_cast<std::size_t>(r);
+                    if (before < network::NEW_JOB_FRAME_SIZE && received_[slot] >= network::NEW_JOB_FRAME_SIZE) {
+                        arrived_[slot] = Clock::now();
+                        ++done;
+                    }
+                }
+            }
+        }
+        return true;
+    }
+
+    /// @brief Время прихода кадра у каждого ASIC (последний wait_all)
+    [[nodiscard]] const std::vector<Clock::time_point>& arrived() const noexcept { return arrived_; }
+
+private:
+    std::vector<int> clients_;
+    std::vector<std::size_t> received_;
+    std::vector<Clock::time_point> arrived_;
+    int epoll_fd_ = -1;
+};
+
+// =============================================================================
+// Путь нового tip (как on_tip в main.cpp)
+// =============================================================================
+
+/**
+ * @brief Синтетический хеш блока ветки
+ */
+Hash256 block_hash(uint8_t branch, uint32_t height) {
+    Hash256 hash{};
+    hash[0] = branch;
+    hash[1] = static_cast<uint8_t>(height);
+    hash[2] = static_cast<uint8_t>(height >> 8);
+    hash[3] = static_cast<uint8_t>(height >> 16);
+    hash[31] = 0x5a;
+    return hash;
+}
+
+class TipPipeline {
+public:
+    TipPipeline(mining::JobManager& job_manager, mining::TemplateCache& cache,
+                core::TemplateGenerator& generator, network::Server& server, uint32_t bits)
+        : job_manager_(job_manager), cache_(cache), generator_(generator), server_(server), bits_(bits) {}
+
+    /**
+     * @brief Объявить tip: рассылка заданий и предвычисление следующего блока
+     *
+     * @param tip_hash Хеш нового tip
+     * @param height Высота tip
+     * @param is_speculative Spy mining (блок не проверен)
+     * @return true если задания взяты из TemplateCache
+     */
+    bool announce(const Hash256& tip_hash, uint32_t height, bool is_speculative) {
+        const uint32_t timestamp = ++timestamp_;
+        bool cached = false;
+        if (auto job_set = cache_.take_next_jobs(tip_hash, height + 1, timestamp)) {
+            job_manager_.on_new_block(job_set->block_template, is_speculative);
+            job_manager_.adopt_precomputed_jobs(job_set->jobs);
+            server_.broadcast_job_set(job_set->jobs);
+            cached = true;
+        } else {
+            generator_.update_chain_tip(tip_hash, height + 1, bits_, COINBASE_VALUE);
+            auto generated = generator_.generate_template(0);
+            if (!generated) {
+                return false;
+            }
+            bitcoin::BlockTemplate block_template;
+            block_template.height = generated->height;
+            block_template.header.version = static_cast<uint32_t>(generated->header.version);
+            block_template.header.prev_block = generated->header.prev_hash;
+            block_template.header.timestamp = timestamp;
+            block_template.header.bits = generated->header.bits;
+            block_template.target = bitcoin::bits_to_target(generated->header.bits);
+            block_template.coinbase_value = generated->coinbase_value;
+
+            job_manager_.on_new_block(block_template, is_speculative);
+            server_.broadcast_job_set({});
+            cache_.update_template(tip_hash, height + 1, bits_, timestamp, COINBASE_VALUE);
+            cache_.remember_current_jobs(job_manager_.extranonce_manager());
+        }
+        cache_.precompute_next(height + 2, bits_);
+        cache_.precompute_next_jobs(job_manager_.extranonce_manager());
+        return cached;
+    }
+
+private:
+    mining::JobManager& job_manager_;
+    mining::TemplateCache& cache_;
+    core::TemplateGenerator& generator_;
+    network::Server& server_;
+    uint32_t bits_;
+    uint32_t timestamp_ = 1'700'000'000;
+};
+
+// =============================================================================
+// Прогон
+// =============================================================================
+
+double millis(Clock::time_point from, Clock::time_point to) {
+    return std::chrono::duration<double, std::milli>(to - from).count();
+}
+
+Percentiles percentiles(std::vector<double>& samples) {
+    Percentiles result;
+    if (samples.empty()) {
+        return result;
+    }
+    std::sort(samples.begin(), samples.end());
+    result.p50 = samples[samples.size() / 2];
+    result.p99 = samples[std::min(samples.size() - 1, samples.size() * 99 / 100)];
+    result.max = samples.back();
+    return result;
+}
+
+/**
+ * @brief Дождаться перехода всех потоков VirtualAsic на поколение
+ */
+std::optional<std::vector<Clock::time_point>> wait_hashers(const mining::VirtualAsic& asic, uint32_t generation) {
+    const auto deadline = Clock::now() + SWITCH_TIMEOUT;
+    for (;;) {
+        auto switches = asic.last_switches();
+        if (std::all_of(switches.begin(), switches.end(),
+                        [&](const mining::VirtualAsicSwitch& s) { return s.generation == generation; })) {
+            std::vector<Clock::time_point> at;
+            for (const auto& s : switches) {
+                at.push_back(s.at);
+            }
+            return at;
+        }
+        if (Clock::now() > deadline) {
+            return std::nullopt;
+        }
+        std::this_thread::yield();
+    }
+}
+
+struct StormResult {
+    std::array<EventResult, EVENT_COUNT> events{};
+    mining::VirtualAsicStats hashing{};
+    uint64_t blocks_found = 0;
+    double seconds = 0;
+};
+
+StormResult run(const Options& options) {
+    StormResult result;
+    const auto params = core::regtest_params();
+    const uint32_t bits = params.difficulty.pow_limit_bits;
+
+    Hash160 pubkey_hash{};
+    pubkey_hash.fill(0x42);
+    bitcoin::CoinbaseBuilder builder(pubkey_hash);
+    MiningConfig mining_config;
+    mining::JobManager job_manager(mining_config, builder);
+    mining::TemplateCache cache(mining_config, builder);
+    core::TemplateGenerator generator(core::TemplateGeneratorConfig{});
+
+    std::atomic<uint64_t> blocks{0};
+    mining::ShareValidator validator(job_manager);
+    validator.set_valid_block_callback([&blocks](const mining::ValidationResult&, const bitcoin::BlockHeader&) {
+        blocks.fetch_add(1, std::memory_order_relaxed);
+    });
+    validator.start_workers(1);
+
+    ServerConfig config;
+    config.bind_address = "127.0.0.1";
+    config.port = PORT;
+    config.max_connections = options.asics + 16;
+    config.worker_threads = 2;
+    network::Server server(config, job_manager);
+    if (auto started = server.start(); !started) {
+        std::cerr << "Не удалось запустить сервер: " << started.error().message << std::endl;
+        validator.stop_workers();
+        return result;
+    }
+
+    std::array<std::array<std::vector<double>, METRIC_COUNT>, EVENT_COUNT> samples;
+    {
+        MockAsics clients(server, options.asics, PORT);
+        mining::VirtualAsicConfig asic_config;
+        asic_config.threads = options.hash_threads;
+        asic_config.share_difficulty = options.share_difficulty;
+        mining::VirtualAsic hashers(job_manager, validator, asic_config);
+        TipPipeline pipeline(job_manager, cache, generator, server, bits);
+
+        // Генезис regtest: первый tip без замера
+        uint32_t height = 0;
+        pipeline.announce(block_hash(0, height), height, false);
+        hashers.start();
+        (void)clients.wait_all();
+        (void)wait_hashers(hashers, job_manager.job_generation());
+
+        const auto interval = std::chrono::milliseconds(options.interval_ms);
+        const auto started = Clock::now();
+
+        // Событие: рассылки (последняя - итоговая), замеры от t0
+        auto record = [&](Event event, Clock::time_point t0, bool frames_ok, bool cached, uint64_t stale_before) {
+            auto& r = result.events[event];
+            ++r.count;
+            r.cached += cached ? 1 : 0;
+            auto hashed = wait_hashers(hashers, job_manager.job_generation());
+            if (!frames_ok || !hashed) {
+                ++r.timeouts;
+            }
+            if (frames_ok && clients.size() != 0) {
+                const auto [first, last] = std::minmax_element(clients.arrived().begin(), clients.arrived().end());
+                samples[event][FRAME].push_back(millis(t0, *last));
+                samples[event][FRAME_SKEW].push_back(millis(*first, *last));
+            }
+            if (hashed && !hashed->empty()) {
+                const auto [first, last] = std::minmax_element(hashed->begin(), hashed->end());
+                samples[event][STALE].push_back(millis(t0, *last));
+                samples[event][HASH_SKEW].push_back(millis(*first, *last));
+            }
+            std::this_thread::sleep_for(interval);
+            r.stale_shares += validator.stale_shares() - stale_before;
+        };
+
+        for (std::size_t cycle = 0; cycle < options.cycles; ++cycle) {
+            // 1. Быстрые tip: A1, A2
+            for (uint32_t step = 1; step <= 2; ++step) {
+                const uint64_t stale = validator.stale_shares();
+                const auto t0 = Clock::now();
+                const bool cached = pipeline.announce(block_hash(0xA, height + step), height + step, false);
+                record(TIP, t0, clients.wait_all(), cached, stale);
+            }
+
+            // 2. Реорганизация на 2 блока: B2 на высоте A2, сразу B3
+            {
+                const uint64_t stale = validator.stale_shares();
+                const auto t0 = Clock::now();
+                pipeline.announce(block_hash(0xB, height + 2), height + 2, false);
+                bool frames_ok = clients.wait_all();
+                const bool cached = pipeline.announce(block_hash(0xB, height + 3), height + 3, false);
+                frames_ok = clients.wait_all() && frames_ok;
+                record(REORG, t0, frames_ok, cached, stale);
+            }
+            height += 3;
+
+            // 3. Speculative S, отмена после проверки, возврат к B3
+            {
+                const uint64_t stale = validator.stale_shares();
+                const auto t0 = Clock::now();
+                pipeline.announce(block_hash(0x5, height + 1), height + 1, true);
+                bool frames_ok = clients.wait_all();
+                std::this_thread::sleep_for(std::chrono::milliseconds(options.validation_ms));
+                job_manager.invalidate_speculative_block();
+                const bool cached = pipeline.announce(block_hash(0xB, height), height, false);
+                frames_ok = clients.wait_all() && frames_ok;
+                record(INVALID, t0, frames_ok, cached, stale);
+            }
+        }
+
+        result.seconds = std::chrono::duration<double>(Clock::now() - started).count();
+        hashers.stop();
+        result.hashing = hashers.stats();
+    }
+    server.stop();
+    validator.stop_workers();
+    result.blocks_found = blocks.load();
+
+    for (std::size_t event = 0; event < EVENT_COUNT; ++event) {
+        for (std::size_t metric = 0; metric < METRIC_COUNT; ++metric) {
+            result.events[event].metrics[metric] = percentiles(samples[event][metric]);
+        }
+    }
+    return result;
+}
+
+void print_result(const StormResult& r) {
+    for (std::size_t event = 0; event < EVENT_COUNT; ++event) {
+        const auto& e = r.events[event];
+        std::cout << "  " << EVENT_NAMES[event] << " (" << e.count << " событий, из кеша "
+                  << e.cached << ", таймаутов " << e.timeouts << ", stale shares "
+                  << e.stale_shares << ")" << std::endl;
+        for (std::size_t metric = 0; metric < METRIC_COUNT; ++metric) {
+            const auto& p = e.metrics[metric];
+            std::cout << "    " << std::setw(11) << std::left << METRIC_NAMES[metric] << std::right
+                      << std::fixed << std::setprecision(3)
+                      << "  p50=" << std::setw(8) << p.p50 << " мс"
+                      << "  p99=" << std::setw(8) << p.p99 << " мс"
+                      << "  max=" << std::setw(8) << p.max << " мс" << std::endl;
+        }
+    }
+    const double mhs = r.seconds > 0 ? static_cast<double>(r.hashing.hashes) / r.seconds / 1e6 : 0.0;
+    std::cout << std::endl << "  хешрейт " << std::setprecision(2) << mhs << " MH/s, shares "
+              << r.hashing.shares << ", блоков " << r.blocks_found << std::endl;
+}
+
+void write_json(const std::string& path, const Options& options, const StormResult& r) {
+    std::ofstream out(path, std::ios::trunc);
+    out << std::fixed << std::setprecision(3);
+    out << "{\n  \"benchmark\": \"block_storm\",\n"
+        << "  \"asics\": " << options.asics << ",\n"
+        << "  \"hash_threads\": " << options.hash_threads << ",\n"
+        << "  \"interval_ms\": " << options.interval_ms << ",\n"
+        << "  \"validation_ms\": " << options.validation_ms << ",\n"
+        << "  \"unit\": \"ms\",\n"
+        << "  \"hashes\": " << r.hashing.hashes << ",\n"
+        << "  \"shares\": " << r.hashing.shares << ",\n"
+        << "  \"blocks\": " << r.blocks_found << ",\n"
+        << "  \"events\": {\n";
+    for (std::size_t event = 0; event < EVENT_COUNT; ++event) {
+        const auto& e = r.events[event];
+        out << "    \"" << EVENT_NAMES[event] << "\": {\n      \"count\": " << e.count
+            << ", \"cached\": " << e.cached << ", \"timeouts\": " << e.timeouts
+            << ", \"stale_shares\": " << e.stale_shares;
+        for (std::size_t metric = 0; metric < METRIC_COUNT; ++metric) {
+            const auto& p = e.metrics[metric];
+            out << ",\n      \"" << METRIC_NAMES[metric] << "\": {\"p50\": " << p.p50
+                << ", \"p99\": " << p.p99 << ", \"max\": " << p.max << "}";
+        }
+        out << "\n    }" << (event + 1 < EVENT_COUNT ? "," : "") << "\n";
+    }
+    out << "  }\n}\n";
+}
+
+} // namespace quaxis::benchmark
+
+int main(int argc, char* argv[]) {
+    using namespace quaxis::benchmark;
+
+    Options options;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        if (arg == "--asics") {
+            options.asics = std::stoul(argv[i + 1]);
+        } else if (arg == "--hash-threads") {
+            options.hash_threads = std::stoul(argv[i + 1]);
+        } else if (arg == "--cycles") {
+            options.cycles = std::stoul(argv[i + 1]);
+        } else if (arg == "--interval-ms") {
+            options.interval_ms = static_cast<uint32_t>(std::stoul(argv[i + 1]));
+        } else if (arg == "--validation-ms") {
+            options.validation_ms = static_cast<uint32_t>(std::stoul(argv[i + 1]));
+        } else if (arg == "--share-difficulty") {
+            options.share_difficulty = std::stod(argv[i + 1]);
+        } else if (arg == "--json") {
+            options.json_path = argv[i + 1];
+        }
+    }
+
+    raise_fd_limit();
+
+    std::cout << "=== Бенчмарк: шторм блоков (regtest) ===" << std::endl;
+    std::cout << "  TCP ASIC: " << options.asics << ", потоков хеширования: " << options.hash_threads
+              << ", циклов: " << options.cycles << ", интервал: " << options.interval_ms << " мс"
+              << std::endl << std::endl;
+
+    auto result = run(options);
+    print_result(result);
+
+    if (!options.json_path.empty()) {
+        write_json(options.json_path, options, result);
+        std::cout << std::endl << "JSON отчёт: " << options.json_path << std::endl;
+    }
+
+    return 0;
+}
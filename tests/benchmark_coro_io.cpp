@@ -0,0 +1,326 @@
+/**
+ * @file benchmark_coro_io.cpp
+ * @brief Бенчмарк корутинного ввода-вывода против потока на соединение
+ *
+ * 1. Цена кадра корутины: co_await Task<int> против вызова функции
+ *    (время и аллокации operator new на вызов)
+ * 2. Запрос-ответ по 10/100/1000 соединениям (socketpair, эхо в одном
+ *    epoll потоке): клиенты - поток на соединение с блокирующими
+ *    send/recv против корутин IoLoop в одном потоке. Потоки процесса,
+ *    полное время и обменов в секунду.
+ *
+ * Запуск: benchmark_coro_io [max_connections]
+ */
+
+#include <iostream>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <array>
+#include <fstream>
+#include <string>
+#include <iomanip>
+
+#include <sys/socket.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include "alloc_counter.hpp"
+#include "core/task.hpp"
+#include "network/coro_io.hpp"
+
+namespace quaxis::benchmark {
+
+using Clock = std::chrono::steady_clock;
+using namespace std::chrono_literals;
+
+/// @brief Вызовов в замере цены кадра
+constexpr int FRAME_CALLS = 1'000'000;
+
+/// @brief Обменов запрос-ответ на соединение
+constexpr int ROUND_TRIPS = 200;
+
+/// @brief Размер запроса и ответа
+constexpr std::size_t MESSAGE_SIZE = 8;
+
+/**
+ * @brief Количество потоков процесса (/proc/self/status)
+ */
+int thread_count() {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.rfind("Threads:", 0) == 0) {
+            return std::stoi(line.substr(8));
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Поднять лимит файловых дескрипторов до жёсткого
+ */
+void raise_fd_limit() {
+    struct rlimit lim;
+    if (getrlimit(RLIMIT_NOFILE, &lim) == 0) {
+        lim.rlim_cur = lim.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &lim);
+    }
+}
+
+// =============================================================================
+// Цена кадра
+// =============================================================================
+
+[[gnu::noinline]] int plain_value(int x) {
+    return x + 1;
+}
+
+core::Task<int> task_value(int x) {
+    co_return x + 1;
+}
+
+core::Task<long> await_many(int calls) {
+    long sum = 0;
+    for (int i = 0; i < calls; ++i) {
+        sum += co_await task_value(i);
+    }
+    co_return sum;
+}
+
+void bench_frame(network::IoLoop& loop) {
+    long sum = 0;
+    auto start = Clock::now();
+    for (int i = 0; i < FRAME_CALLS; ++i) {
+        sum += plain_value(i);
+    }
+    double plain_ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / FRAME_CALLS;
+
+    uint64_t before = allocation_count();
+    start = Clock::now();
+    sum += loop.block_on(await_many(FRAME_CALLS));
+    double task_ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / FRAME_CALLS;
+    double allocs = static_cast<double>(allocation_count() - before) / FRAME_CALLS;
+
+    std::cout << "  вызов функции     " << std::setw(8) << std::fixed << std::setprecision(1)
+              << plain_ns << " нс" << std::endl;
+    std::cout << "  co_await Task<int>" << std::setw(8) << task_ns << " нс"
+              << "  аллокаций/вызов=" << std::setprecision(2) << allocs
+              << "  (checksum " << (sum & 0xFF) << ")" << std::endl;
+}
+
+// =============================================================================
+// Запрос-ответ
+// =============================================================================
+
+/**
+ * @brief Эхо-сервер: один epoll поток отвечает на всех соединениях
+ */
+class EchoServer {
+public:
+    explicit EchoServer(const std::vector<int>& fds)
+        : epoll_fd_(epoll_create1(0))
+        , wake_fd_{-1, -1}
+    {
+        socketpair(AF_UNIX, SOCK_STREAM, 0, wake_fd_.data());
+        add(wake_fd_[0]);
+        for (int fd : fds) {
+            add(fd);
+        }
+        thread_ = std::thread([this] { run(); });
+    }
+
+    ~EchoServer() {
+        uint8_t byte = 1;
+        [[maybe_unused]] auto n = send(wake_fd_[1], &byte, 1, 0);
+        thread_.join();
+        close(wake_fd_[0]);
+        close(wake_fd_[1]);
+        close(epoll_fd_);
+    }
+
+private:
+    void add(int fd) {
+        struct epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = fd;
+        epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &ev);
+    }
+
+    void run() {
+        std::array<struct epoll_event, 256> events;
+        std::array<uint8_t, 1024> buffer;
+        for (;;) {
+            int n = epoll_wait(epoll_fd_, events.data(), static_cast<int>(events.size()), -1);
+            for (int i = 0; i < n; ++i) {
+                int fd = events[i].data.fd;
+                if (fd == wake_fd_[0]) {
+                    return;
+                }
+                ssize_t r = recv(fd, buffer.data(), buffer.size(), MSG_DONTWAIT);
+                if (r > 0) {
+                    [[maybe_unused]] auto w = send(fd, buffer.data(), static_cast<std::size_t>(r), MSG_NOSIGNAL);
+                } else if (r == 0) {
+                    epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+                }
+            }
+        }
+    }
+
+    int epoll_fd_;
+    std::array<int, 2> wake_fd_;
+    std::thread thread_;
+};
+
+struct RoundTripResult {
+    int threads = 0;
+    double seconds = 0;
+    double round_trips_per_sec = 0;
+};
+
+/**
+ * @brief Пары сокетов: [0] - клиент, [1] - эхо
+ */
+std::vector<std::array<int, 2>> make_pairs(std::size_t connections) {
+    std::vector<std::array<int, 2>> pairs(connections);
+    for (auto& fds : pairs) {
+        socketpair(AF_UNIX, SOCK_STREAM, 0, fds.data());
+    }
+    return pairs;
+}
+
+std::vector<int> echo_ends(const std::vector<std::array<int, 2>>& pairs) {
+    std::vector<int> fds;
+    for (const auto& pair : pairs) {
+        fds.push_back(pair[1]);
+    }
+    return fds;
+}
+
+RoundTripResult run_threaded(std::size_t connections) {
+    RoundTripResult result;
+    auto pairs = make_pairs(connections);
+    EchoServer echo(echo_ends(pairs));
+
+    std::atomic<int> peak_threads{0};
+    std::atomic<std::size_t> started{0};
+    auto start = Clock::now();
+    std::vector<std::thread> clients;
+    clients.reserve(connections);
+    for (const auto& pair : pairs) {
+        int fd = pair[0];
+        clients.emplace_back([fd, connections, &started, &peak_threads] {
+            // Последний запущенный поток снимает число потоков процесса
+            if (started.fetch_add(1) + 1 == connections) {
+                peak_threads = thread_count();
+            }
+            std::array<uint8_t, MESSAGE_SIZE> message{};
+            for (int i = 0; i < ROUND_TRIPS; ++i) {
+                message[0] = static_cast<uint8_t>(i);
+                [[maybe_unused]] auto w = send(fd, message.data(), message.size(), MSG_NOSIGNAL);
+                [[maybe_unused]] auto r = recv(fd, message.data(), message.size(), MSG_WAITALL);
+            }
+        });
+    }
+    for (auto& client : clients) {
+        client.join();
+    }
+    result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    result.threads = peak_threads.load();
+
+    for (auto& pair : pairs) {
+        close(pair[0]);
+        close(pair[1]);
+    }
+    return result;
+}
+
+core::Task<void> coro_client(network::IoLoop& loop, int fd, std::atomic<std::size_t>& done) {
+    auto socket = network::AsyncSocket::adopt(loop, fd);
+    if (socket) {
+        std::array<uint8_t, MESSAGE_SIZE> message{};
+        for (int i = 0; i < ROUND_TRIPS; ++i) {
+            message[0] = static_cast<uint8_t>(i);
+            if (!co_await socket->write_all(message, 5s) || !co_await socket->read_exact(message, 5s)) {
+                break;
+            }
+        }
+    }
+    done.fetch_add(1);
+}
+
+RoundTripResult run_coroutines(std::size_t connections) {
+    RoundTripResult result;
+    auto pairs = make_pairs(connections);
+    EchoServer echo(echo_ends(pairs));
+
+    network::IoLoop loop;
+    if (auto started = loop.start(); !started) {
+        std::cerr << "  Не удалось запустить IoLoop: " << started.error().message << std::endl;
+        return result;
+    }
+
+    std::atomic<std::size_t> done{0};
+    auto start = Clock::now();
+    for (const auto& pair : pairs) {
+        loop.spawn(coro_client(loop, pair[0], done));
+    }
+    result.threads = thread_count();
+    while (done.load() < connections) {
+        std::this_thread::sleep_for(100us);
+    }
+    result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    loop.stop();
+
+    // Клиентские концы закрыл AsyncSocket
+    for (auto& pair : pairs) {
+        close(pair[1]);
+    }
+    return result;
+}
+
+void print_result(const char* model, std::size_t connections, RoundTripResult r) {
+    r.round_trips_per_sec = static_cast<double>(connections * ROUND_TRIPS) / r.seconds;
+    std::cout << "  " << std::setw(10) << model
+              << "  соединений=" << std::setw(4) << connections
+              << "  threads=" << std::setw(5) << r.threads
+              << "  время=" << std::setw(8) << std::fixed << std::setprecision(1) << r.seconds * 1000 << " мс"
+              << "  обменов/с=" << std::setw(10) << std::setprecision(0) << r.round_trips_per_sec
+              << std::endl;
+}
+
+} // namespace quaxis::benchmark
+
+int main(int argc, char* argv[]) {
+    using namespace quaxis::benchmark;
+
+    // Необязательный аргумент: максимальное число соединений (по умолчанию 1000)
+    std::size_t max_connections = argc > 1 ? std::stoul(argv[1]) : 1000;
+
+    raise_fd_limit();
+
+    std::cout << "=== Бенчмарк корутинного ввода-вывода ===" << std::endl;
+    std::cout << std::endl;
+
+    {
+        quaxis::network::IoLoop loop;
+        if (!loop.start()) {
+            return 1;
+        }
+        std::cout << "Цена кадра корутины (" << FRAME_CALLS << " вызовов):" << std::endl;
+        bench_frame(loop);
+    }
+
+    std::cout << std::endl << "Запрос-ответ, " << ROUND_TRIPS << " обменов на соединение:" << std::endl;
+    for (std::size_t connections : {10u, 100u, 1000u}) {
+        if (connections > max_connections) {
+            break;
+        }
+        print_result("threaded", connections, run_threaded(connections));
+        print_result("coroutine", connections, run_coroutines(connections));
+    }
+
+    return 0;
+}
@@ -0,0 +1,175 @@
+/**
+ * @file benchmark_extranonce_churn.cpp
+ * @brief Бенчмарк подключений/отключений ASIC (ExtrannonceManager)
+ *
+ * Перезагрузка фермы даёт тысячи connect/disconnect в секунду из
+ * нескольких потоков сервера. Измеряются:
+ * 1. Устойчивый churn: N потоков циклически assign/get/release
+ * 2. Перезагрузка фермы: 10000 подключений, затем 10000 отключений
+ *
+ * Для сравнения та же нагрузка на одном std::unordered_map под общим
+ * std::mutex (схема до шардирования).
+ */
+
+#include <iostream>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <iomanip>
+
+#include "mining/extranonce_manager.hpp"
+
+namespace quaxis::benchmark {
+
+using Clock = std::chrono::steady_clock;
+
+/// @brief Длительность одного прогона churn
+constexpr auto RUN_TIME = std::chrono::milliseconds(500);
+
+/// @brief Соединений на поток в churn-прогоне
+constexpr uint32_t CONNECTIONS_PER_THREAD = 256;
+
+/// @brief Размер фермы для сценария перезагрузки
+constexpr uint32_t FLEET_SIZE = 10000;
+
+/**
+ * @brief Базовая схема: unordered_map под общим mutex
+ */
+class MutexMapManager {
+public:
+    uint64_t assign_extranonce(uint32_t connection_id) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        uint64_t extranonce = next_++;
+        extranonces_[connection_id] = extranonce;
+        return extranonce;
+    }
+
+    void release_extranonce(uint32_t connection_id) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        extranonces_.erase(connection_id);
+    }
+
+    std::optional<uint64_t> get_extranonce(uint32_t connection_id) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = extranonces_.find(connection_id);
+        if (it != extranonces_.end()) {
+            return it->second;
+        }
+        return std::nullopt;
+    }
+
+    void recycle_released() {}
+
+private:
+    mutable std::mutex mutex_;
+    std::unordered_map<uint32_t, uint64_t> extranonces_;
+    uint64_t next_ = 1;
+};
+
+/**
+ * @brief Устойчивый churn: операций connect+disconnect в секунду
+ */
+template<typename Manager>
+double run_churn(int threads_count) {
+    Manager manager;
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> cycles{0};
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threads_count; ++t) {
+        threads.emplace_back([&, t] {
+            uint32_t base = static_cast<uint32_t>(t) * CONNECTIONS_PER_THREAD;
+            uint64_t local = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                for (uint32_t i = 0; i < CONNECTIONS_PER_THREAD; ++i) {
+                    (void)manager.assign_extranonce(base + i);
+                    (void)manager.get_extranonce(base + i);
+                }
+                for (uint32_t i = 0; i < CONNECTIONS_PER_THREAD; ++i) {
+                    manager.release_extranonce(base + i);
+                }
+                local += CONNECTIONS_PER_THREAD;
+            }
+            cycles.fetch_add(local, std::memory_order_relaxed);
+        });
+    }
+
+    auto start = Clock::now();
+    while (Clock::now() - start < RUN_TIME) {
+        // Смена блока раз в 50 мс: освобождённые значения снова в обороте
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        manager.recycle_released();
+    }
+    stop.store(true);
+
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    return static_cast<double>(cycles.load()) / seconds;
+}
+
+/**
+ * @brief Перезагрузка фермы: время на FLEET_SIZE подключений и отключений, мс
+ */
+template<typename Manager>
+double run_fleet_reboot(int threads_count) {
+    Manager manager;
+    uint32_t per_thread = FLEET_SIZE / static_cast<uint32_t>(threads_count);
+
+    auto phase = [&](bool connect) {
+        std::vector<std::thread> threads;
+        for (int t = 0; t < threads_count; ++t) {
+            threads.emplace_back([&, t] {
+                uint32_t base = static_cast<uint32_t>(t) * per_thread;
+                for (uint32_t i = 0; i < per_thread; ++i) {
+                    if (connect) {
+                        (void)manager.assign_extranonce(base + i);
+                    } else {
+                        manager.release_extranonce(base + i);
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    };
+
+    auto start = Clock::now();
+    phase(true);
+    phase(false);
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+void print_row(const char* name, int threads, double churn_per_sec, double reboot_ms) {
+    std::cout << "  " << std::setw(22) << name
+              << " threads=" << std::setw(2) << threads
+              << "  connect+disconnect/s=" << std::setw(12) << std::fixed << std::setprecision(0) << churn_per_sec
+              << "  reboot " << FLEET_SIZE << "=" << std::setw(8) << std::setprecision(2) << reboot_ms << " мс"
+              << std::endl;
+}
+
+} // namespace quaxis::benchmark
+
+int main() {
+    using namespace quaxis::benchmark;
+    using quaxis::mining::ExtrannonceManager;
+
+    std::cout << "=== Бенчмарк churn соединений (ExtrannonceManager) ===" << std::endl;
+    std::cout << std::endl;
+
+    for (int threads : {1, 2, 4, 8}) {
+        print_row("ExtrannonceManager", threads,
+                  run_churn<ExtrannonceManager>(threads), run_fleet_reboot<ExtrannonceManager>(threads));
+        print_row("unordered_map+mutex", threads,
+                  run_churn<MutexMapManager>(threads), run_fleet_reboot<MutexMapManager>(threads));
+    }
+
+    return 0;
+}
@@ -0,0 +1,150 @@
+/**
+ * @file benchmark_header_hash.cpp
+ * @brief Бенчмарк SHA256d заголовка с midstate
+ *
+ * Прежний путь: второй блок заголовка собирается из хвоста и padding
+ * в 64-байтный буфер, затем полный sha256_transform и sha256() над
+ * 32-байтным первым хешем (снова буфер с padding и полный transform).
+ *
+ * Специализированный путь (hash_header_with_midstate): слова padding
+ * и их вклад в расписание известны при компиляции. Замеряется generic
+ * и SHA-NI (если CPU поддерживает).
+ */
+
+#include <iostream>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <random>
+#include <vector>
+
+#include "crypto/sha256.hpp"
+#include "core/byte_order.hpp"
+
+namespace quaxis::benchmark {
+
+using Clock = std::chrono::steady_clock;
+
+/// @brief Длительность одного прогона
+constexpr auto RUN_TIME = std::chrono::milliseconds(500);
+
+/// @brief Заголовков в наборе
+constexpr std::size_t HEADER_COUNT = 1024;
+
+/// @brief Приёмник результатов: не даёт компилятору выбросить хеширование
+volatile uint8_t g_sink = 0;
+
+struct Header {
+    crypto::Sha256State midstate;
+    crypto::HeaderTail tail;
+};
+
+std::vector<Header> make_headers() {
+    std::mt19937 rng(42);
+    std::vector<Header> headers(HEADER_COUNT);
+    for (auto& header : headers) {
+        std::array<uint8_t, 64> first;
+        for (auto& byte : first) {
+            byte = static_cast<uint8_t>(rng());
+        }
+        header.midstate = crypto::compute_midstate(first.data());
+        for (auto& byte : header.tail) {
+            byte = static_cast<uint8_t>(rng());
+        }
+    }
+    return headers;
+}
+
+/**
+ * @brief Прежняя реализация hash_header_with_midstate
+ *
+ * sha256_transform выбирает SHA-NI сам, поэтому прежний путь
+ * сравнивается с реализацией этого CPU.
+ */
+Hash256 hash_header_reference(const crypto::Sha256State& midstate, const crypto::HeaderTail& tail) {
+    crypto::Sha256State state = midstate;
+    std::array<uint8_t, 64> block{};
+    std::memcpy(block.data(), tail.data(), 16);
+    block[16] = 0x80;
+    block[62] = 0x02;
+    block[63] = 0x80;
+    crypto::sha256_transform(state, block.data());
+
+    Hash256 first_hash;
+    for (std::size_t i = 0; i < 8; ++i) {
+        write_be32(first_hash.data() + i * 4, state[i]);
+    }
+    return crypto::sha256(ByteSpan(first_hash.data(), first_hash.size()));
+}
+
+/**
+ * @brief Хешировать набор, пока не истечёт RUN_TIME
+ *
+ * @return double Заголовков в секунду
+ */
+template<typename Hash>
+double run(const std::vector<Header>& headers, Hash hash) {
+    uint64_t count = 0;
+    uint8_t sink = 0;
+    auto start = Clock::now();
+    while (Clock::now() - start < RUN_TIME) {
+        for (const auto& header : headers) {
+            sink ^= hash(header)[31];
+        }
+        count += headers.size();
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    g_sink = sink;
+    return static_cast<double>(count) / seconds;
+}
+
+void print_row(const char* name, double per_sec, double baseline) {
+    std::cout << "  " << std::setw(28) << name
+              << "  MH/s=" << std::setw(8) << std::fixed << std::setprecision(3) << per_sec / 1e6
+              << "  x" << std::setprecision(2) << per_sec / baseline
+              << std::endl;
+}
+
+} // namespace quaxis::benchmark
+
+int main() {
+    using namespace quaxis;
+    using namespace quaxis::benchmark;
+
+    std::cout << "=== Бенчмарк SHA256d заголовка с midstate ===" << std::endl;
+    std::cout << "SHA256: " << crypto::get_implementation_name() << std::endl;
+    std::cout << std::endl;
+
+    auto headers = make_headers();
+
+    // Реализации должны совпадать
+    for (const auto& h : headers) {
+        auto expected = hash_header_reference(h.midstate, h.tail);
+        if (crypto::hash_header_with_midstate(h.midstate, h.tail, crypto::Sha256Implementation::Generic) != expected ||
+            crypto::hash_header_with_midstate(h.midstate, h.tail, crypto::Sha256Implementation::ShaNi) != expected ||
+            crypto::hash_header_with_midstate(h.midstate, h.tail, crypto::Sha256Implementation::ArmSha2) != expected) {
+            std::cerr << "ОШИБКА: хеши реализаций не совпадают" << std::endl;
+            return 1;
+        }
+    }
+
+    double baseline = run(headers, [](const Header& h) {
+        return hash_header_reference(h.midstate, h.tail);
+    });
+    print_row("прежний путь", baseline, baseline);
+    print_row("специализированный generic", run(headers, [](const Header& h) {
+        return crypto::hash_header_with_midstate(h.midstate, h.tail, crypto::Sha256Implementation::Generic);
+    }), baseline);
+    if (crypto::has_sha_ni_support()) {
+        print_row("специализированный sha-ni", run(headers, [](const Header& h) {
+            return crypto::hash_header_with_midstate(h.midstate, h.tail, crypto::Sha256Implementation::ShaNi);
+        }), baseline);
+    }
+    if (crypto::has_arm_sha2_support()) {
+        print_row("специализированный arm-sha2", run(headers, [](const Header& h) {
+            return crypto::hash_header_with_midstate(h.midstate, h.tail, crypto::Sha256Implementation::ArmSha2);
+        }), baseline);
+    }
+
+    return 0;
+}
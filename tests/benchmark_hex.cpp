@@ -0,0 +1,127 @@
+/**
+ * @file benchmark_hex.cpp
+ * @brief Бенчмарк hex кодека
+ *
+ * Для каждой доступной реализации (scalar / SSSE3 / AVX2 / NEON):
+ * 1. Кодирование блока 1 МБ (submitblock) и заголовка 80 байт
+ * 2. Декодирование coinbase 250 байт и merkle branch 32 байта (Stratum
+ *    mining.notify)
+ * Плюс прежний путь submitblock: std::string push_back по символу.
+ */
+
+#include <iostream>
+#include <chrono>
+#include <iomanip>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "core/byte_order.hpp"
+#include "core/types.hpp"
+
+namespace quaxis::benchmark {
+
+using Clock = std::chrono::steady_clock;
+
+/// @brief Длительность одного прогона
+constexpr auto RUN_TIME = std::chrono::milliseconds(300);
+
+/// @brief Результат, чтобы компилятор не выбросил работу
+volatile uint8_t g_sink = 0;
+
+constexpr HexImplementation ALL[] = {
+    HexImplementation::Scalar,
+    HexImplementation::Ssse3,
+    HexImplementation::Avx2,
+    HexImplementation::Neon,
+};
+
+/**
+ * @brief Повторять op, пока не истечёт RUN_TIME
+ *
+ * @return double Наносекунд на вызов
+ */
+template<typename Op>
+double run(Op op) {
+    uint64_t count = 0;
+    auto start = Clock::now();
+    while (Clock::now() - start < RUN_TIME) {
+        for (int i = 0; i < 16; ++i) {
+            op();
+        }
+        count += 16;
+    }
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / static_cast<double>(count);
+}
+
+/// @brief Прежний to_hex из main.cpp (до общего кодека)
+std::string push_back_hex(ByteSpan data) {
+    static constexpr char DIGITS[] = "0123456789abcdef";
+    std::string hex;
+    hex.reserve(data.size() * 2);
+    for (uint8_t byte : data) {
+        hex.push_back(DIGITS[byte >> 4]);
+        hex.push_back(DIGITS[byte & 0x0F]);
+    }
+    return hex;
+}
+
+void report(const char* name, std::size_t bytes, double ns) {
+    std::cout << "  " << std::left << std::setw(22) << name << std::right
+              << std::setw(12) << std::fixed << std::setprecision(1) << ns << " нс"
+              << std::setw(10) << std::setprecision(0) << static_cast<double>(bytes) / ns * 1e3 << " МБ/с"
+              << std::endl;
+}
+
+} // namespace quaxis::benchmark
+
+int main() {
+    using namespace quaxis;
+    using namespace quaxis::benchmark;
+
+    std::cout << "=== Бенчмарк hex кодека ===" << std::endl;
+    std::cout << "Реализация по CPUID: " << hex_implementation_name(get_hex_implementation()) << std::endl;
+    std::cout << std::endl;
+
+    std::mt19937 rng(16);
+    std::vector<uint8_t> block(1 << 20);
+    for (auto& byte : block) {
+        byte = static_cast<uint8_t>(rng());
+    }
+    const ByteSpan header(block.data(), 80);
+    const ByteSpan coinbase(block.data(), 250);
+    const ByteSpan branch(block.data(), 32);
+    const std::string coinbase_hex = to_hex(coinbase);
+    const std::string branch_hex = to_hex(branch);
+
+    std::string out(block.size() * 2, '\0');
+    std::vector<uint8_t> decoded(block.size());
+
+    std::cout << "Прежний путь submitblock (push_back):" << std::endl;
+    report("encode 1 МБ", block.size(), run([&] { g_sink = static_cast<uint8_t>(push_back_hex(block)[5]); }));
+    std::cout << std::endl;
+
+    for (auto impl : ALL) {
+        if (!has_hex_implementation(impl)) {
+            continue;
+        }
+        std::cout << hex_implementation_name(impl) << ":" << std::endl;
+        report("encode 1 МБ", block.size(), run([&] {
+            hex_encode(block, out.data(), impl);
+            g_sink = static_cast<uint8_t>(out[5]);
+        }));
+        report("encode header 80", header.size(), run([&] {
+            hex_encode(header, out.data(), impl);
+            g_sink = static_cast<uint8_t>(out[5]);
+        }));
+        report("decode coinbase 250", coinbase.size(), run([&] {
+            g_sink = static_cast<uint8_t>(hex_decode(coinbase_hex, decoded.data(), impl) + decoded[3]);
+        }));
+        report("decode branch 32", branch.size(), run([&] {
+            g_sink = static_cast<uint8_t>(hex_decode(branch_hex, decoded.data(), impl) + decoded[3]);
+        }));
+        std::cout << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,240 @@
+/**
+ * @file benchmark_job_fanout.cpp
+ * @brief Бенчмарк разброса доставки задания между ASIC
+ *
+ * При новом блоке важна не только средняя латентность, но и разброс:
+ * сколько проходит между моментом, когда задание получил первый ASIC,
+ * и моментом, когда его получил последний. Сравниваются:
+ * 1. Обычная рассылка (очередь + send-поток / прямой send)
+ * 2. Пакет io_uring (одна SQE IORING_OP_WRITE_FIXED на ASIC)
+ *
+ * Запуск: benchmark_job_fanout [max_asics]
+ */
+
+#include <iostream>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <string>
+#include <iomanip>
+
+#include <sys/socket.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+#include "network/server.hpp"
+#include "mining/job_manager.hpp"
+#include "bitcoin/coinbase.hpp"
+
+namespace quaxis::benchmark {
+
+using Clock = std::chrono::steady_clock;
+
+/// @brief Количество раундов рассылки
+constexpr int ROUNDS = 30;
+
+/// @brief Размер кадра задания (команда + 48 байт)
+constexpr std::size_t JOB_FRAME_SIZE = 1 + constants::JOB_MESSAGE_SIZE;
+
+/**
+ * @brief Результаты прогона
+ */
+struct FanoutResult {
+    bool io_uring = false;
+    double dispatch_us = 0;    ///< Медиана: broadcast_job -> первый ASIC
+    double skew_median_us = 0; ///< Медиана: первый ASIC -> последний ASIC
+    double skew_p99_us = 0;
+};
+
+void raise_fd_limit() {
+    struct rlimit lim;
+    if (getrlimit(RLIMIT_NOFILE, &lim) == 0) {
+        lim.rlim_cur = lim.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &lim);
+    }
+}
+
+int connect_client(uint16_t port) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return -1;
+    }
+
+    struct sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+
+    if (connect(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0) {
+        close(fd);
+        return -1;
+    }
+
+    int flags = fcntl(fd, F_GETFL, 0);
+    fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+    return fd;
+}
+
+/**
+ * @brief Один раунд: время первого и последнего полученного кадра
+ */
+std::pair<Clock::time_point, Clock::time_point> receive_round(
+    int epoll_fd,
+    std::vector<std::size_t>& received
+) {
+    std::fill(received.begin(), received.end(), 0);
+    std::size_t done = 0;
+    std::array<struct epoll_event, 256> events;
+    std::array<uint8_t, 1024> buffer;
+    Clock::time_point first{};
+    Clock::time_point last{};
+
+    while (done < received.size()) {
+        int n = epoll_wait(epoll_fd, events.data(), static_cast<int>(events.size()), 1000);
+        if (n <= 0) {
+            break;
+        }
+        for (int i = 0; i < n; ++i) {
+            // data.u64 = (fd << 32) | индекс клиента
+            uint64_t key = events[i].data.u64;
+            int fd = static_cast<int>(key >> 32);
+            std::size_t slot = static_cast<std::size_t>(key & 0xFFFFFFFFu);
+            for (;;) {
+                ssize_t r = recv(fd, buffer.data(), buffer.size(), 0);
+                if (r <= 0) {
+                    break;
+                }
+                std::size_t before = received[slot];
+                received[slot] += static_cast<std::size_t>(r);
+                if (before < JOB_FRAME_SIZE && received[slot] >= JOB_FRAME_SIZE) {
+                    auto now = Clock::now();
+                    if (done == 0) {
+                        first = now;
+                    }
+                    last = now;
+                    ++done;
+                }
+            }
+        }
+    }
+
+    return {first, last};
+}
+
+FanoutResult run(const std::string& engine, bool io_uring, std::size_t asics, uint16_t port) {
+    FanoutResult result;
+
+    Hash160 pubkey_hash{};
+    pubkey_hash.fill(0x42);
+    mining::JobManager job_manager(MiningConfig{}, bitcoin::CoinbaseBuilder(pubkey_hash));
+
+    ServerConfig config;
+    config.bind_address = "127.0.0.1";
+    config.port = port;
+    config.max_connections = asics + 16;
+    config.engine = engine;
+    config.worker_threads = 2;
+    config.io_uring = io_uring;
+
+    network::Server server(config, job_manager);
+    if (auto started = server.start(); !started) {
+        std::cerr << "  Не удалось запустить сервер: " << started.error().message << std::endl;
+        return result;
+    }
+    result.io_uring = server.io_uring_active();
+
+    std::vector<int> clients;
+    for (std::size_t i = 0; i < asics; ++i) {
+        int fd = connect_client(port);
+        if (fd < 0) {
+            break;
+        }
+        clients.push_back(fd);
+    }
+
+    auto deadline = Clock::now() + std::chrono::seconds(10);
+    while (server.connection_count() < clients.size() && Clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+    int epoll_fd = epoll_create1(0);
+    for (std::size_t i = 0; i < clients.size(); ++i) {
+        struct epoll_event ev{};
+        ev.events = EPOLLIN | EPOLLET;
+        ev.data.u64 = (static_cast<uint64_t>(clients[i]) << 32) | i;
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, clients[i], &ev);
+    }
+
+    mining::Job job;
+    std::vector<std::size_t> received(clients.size());
+    std::vector<double> dispatch;
+    std::vector<double> skew;
+
+    for (int round = 0; round < ROUNDS; ++round) {
+        job.job_id = static_cast<uint32_t>(round + 1);
+        auto start = Clock::now();
+        server.broadcast_job(job);
+        auto [first, last] = receive_round(epoll_fd, received);
+        dispatch.push_back(std::chrono::duration<double, std::micro>(first - start).count());
+        skew.push_back(std::chrono::duration<double, std::micro>(last - first).count());
+    }
+
+    std::sort(dispatch.begin(), dispatch.end());
+    std::sort(skew.begin(), skew.end());
+    result.dispatch_us = dispatch[dispatch.size() / 2];
+    result.skew_median_us = skew[skew.size() / 2];
+    result.skew_p99_us = skew[skew.size() * 99 / 100];
+
+    close(epoll_fd);
+    for (int fd : clients) {
+        close(fd);
+    }
+    server.stop();
+
+    return result;
+}
+
+void print_result(const std::string& engine, bool requested, std::size_t asics, const FanoutResult& r) {
+    std::string mode = requested ? (r.io_uring ? "io_uring" : "io_uring(н/д)") : "обычный";
+    std::cout << "  " << std::setw(8) << engine
+              << "  " << std::setw(14) << mode
+              << "  ASIC=" << std::setw(4) << asics
+              << "  до первого=" << std::setw(9) << std::fixed << std::setprecision(1) << r.dispatch_us << " мкс"
+              << "  разброс median=" << std::setw(9) << r.skew_median_us << " мкс"
+              << "  p99=" << std::setw(9) << r.skew_p99_us << " мкс"
+              << std::endl;
+}
+
+} // namespace quaxis::benchmark
+
+int main(int argc, char* argv[]) {
+    using namespace quaxis::benchmark;
+
+    // Необязательный аргумент: максимальное число ASIC (по умолчанию 1000)
+    std::size_t max_asics = argc > 1 ? std::stoul(argv[1]) : 1000;
+
+    raise_fd_limit();
+
+    std::cout << "=== Бенчмарк разброса рассылки задания (первый -> последний ASIC) ===" << std::endl;
+    std::cout << std::endl;
+
+    uint16_t port = 43350;
+    for (std::size_t asics : {10u, 100u, 1000u}) {
+        if (asics > max_asics) {
+            break;
+        }
+        for (const char* engine : {"threaded", "epoll"}) {
+            for (bool io_uring : {false, true}) {
+                print_result(engine, io_uring, asics, run(engine, io_uring, asics, port++));
+            }
+        }
+    }
+
+    return 0;
+}
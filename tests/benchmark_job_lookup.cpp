@@ -0,0 +1,171 @@
+/**
+ * @file benchmark_job_lookup.cpp
+ * @brief Бенчмарк поиска заданий под конкуренцией
+ *
+ * N потоков-валидаторов вызывают JobManager::get_job() для свежих job_id,
+ * пока один поток-производитель непрерывно создаёт задания и
+ * периодически вызывает on_new_block().
+ *
+ * Для сравнения измеряется та же нагрузка на таблице std::unordered_map
+ * под общим std::mutex (схема до перехода на seqlock).
+ */
+
+#include <iostream>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <mutex>
+#include <unordered_map>
+#include <iomanip>
+
+#include "mining/job_manager.hpp"
+#include "bitcoin/coinbase.hpp"
+
+namespace quaxis::benchmark {
+
+using Clock = std::chrono::steady_clock;
+
+/// @brief Длительность одного прогона
+constexpr auto RUN_TIME = std::chrono::milliseconds(500);
+
+/**
+ * @brief Результаты одного прогона
+ */
+struct LookupResult {
+    double lookups_per_sec;
+    double jobs_per_sec;
+};
+
+/**
+ * @brief Общий цикл: N читателей + 1 писатель
+ *
+ * @param readers Количество потоков-валидаторов
+ * @param produce Создать одно задание, вернуть его job_id
+ * @param new_block Смена блока (очистка заданий)
+ * @param lookup Поиск задания, true если найдено
+ */
+template<typename Produce, typename NewBlock, typename Lookup>
+LookupResult run(int readers, Produce produce, NewBlock new_block, Lookup lookup) {
+    std::atomic<bool> stop{false};
+    std::atomic<uint32_t> latest{0};
+    std::atomic<uint64_t> lookups{0};
+    uint64_t produced = 0;
+
+    std::vector<std::thread> threads;
+    for (int r = 0; r < readers; ++r) {
+        threads.emplace_back([&] {
+            uint64_t local = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                uint32_t id = latest.load(std::memory_order_relaxed);
+                (void)lookup(id);
+                ++local;
+            }
+            lookups.fetch_add(local, std::memory_order_relaxed);
+        });
+    }
+
+    auto start = Clock::now();
+    while (Clock::now() - start < RUN_TIME) {
+        for (int i = 0; i < 64; ++i) {
+            latest.store(produce(), std::memory_order_relaxed);
+            ++produced;
+        }
+        new_block();
+    }
+    stop.store(true);
+
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    return {
+        static_cast<double>(lookups.load()) / seconds,
+        static_cast<double>(produced) / seconds
+    };
+}
+
+/**
+ * @brief JobManager (lock-free get_job)
+ */
+LookupResult benchmark_job_manager(int readers) {
+    MiningConfig config;
+    config.job_queue_size = 100;
+
+    Hash160 pubkey_hash{};
+    pubkey_hash.fill(0x42);
+    bitcoin::CoinbaseBuilder builder(pubkey_hash);
+
+    bitcoin::BlockTemplate tmpl;
+    auto [coinbase, midstate] = builder.build_with_midstate(800000, 625000000, 0);
+    tmpl.height = 800000;
+    tmpl.header.bits = 0x1705ae3a;
+    tmpl.coinbase_tx = std::move(coinbase);
+    tmpl.coinbase_midstate = midstate;
+    tmpl.update_extranonce(0);
+
+    mining::JobManager manager(config, builder);
+    manager.on_new_block(tmpl);
+    manager.register_connection(1);
+
+    return run(
+        readers,
+        [&] { return manager.get_next_job_for_connection(1)->job_id; },
+        [&] { manager.on_new_block(tmpl); },
+        [&](uint32_t id) { return manager.get_job(id).has_value(); }
+    );
+}
+
+/**
+ * @brief Базовая схема: unordered_map под общим mutex
+ */
+LookupResult benchmark_mutex_map(int readers) {
+    std::mutex mutex;
+    std::unordered_map<uint32_t, mining::Job> jobs;
+    uint32_t next_id = 1;
+
+    return run(
+        readers,
+        [&] {
+            std::lock_guard<std::mutex> lock(mutex);
+            mining::Job job;
+            job.job_id = next_id++;
+            job.created_at = Clock::now();
+            jobs[job.job_id] = job;
+            return job.job_id;
+        },
+        [&] {
+            std::lock_guard<std::mutex> lock(mutex);
+            jobs.clear();
+        },
+        [&](uint32_t id) {
+            std::lock_guard<std::mutex> lock(mutex);
+            return jobs.find(id) != jobs.end();
+        }
+    );
+}
+
+void print_row(const char* name, int readers, const LookupResult& r) {
+    std::cout << "  " << std::setw(22) << name
+              << " readers=" << std::setw(2) << readers
+              << "  lookups/s=" << std::setw(14) << std::fixed << std::setprecision(0) << r.lookups_per_sec
+              << "  jobs/s=" << std::setw(12) << r.jobs_per_sec
+              << std::endl;
+}
+
+} // namespace quaxis::benchmark
+
+int main() {
+    using namespace quaxis::benchmark;
+
+    std::cout << "=== Бенчмарк поиска заданий (N валидаторов + 1 производитель) ===" << std::endl;
+    std::cout << std::endl;
+
+    for (int readers : {1, 2, 4, 8}) {
+        print_row("JobManager (seqlock)", readers, benchmark_job_manager(readers));
+        print_row("unordered_map+mutex", readers, benchmark_mutex_map(readers));
+    }
+
+    return 0;
+}
@@ -0,0 +1,155 @@
+/**
+ * @file benchmark_job_table.cpp
+ * @brief Бенчмарк проверки shares по таблице заданий с ростом числа заданий
+ *
+ * Share проверяется по случайному заданию из N активных: поиск задания,
+ * хвост заголовка, SHA256d с midstate. Сравниваются копия полного Job
+ * (JobTable::lookup, несколько сотен байт из холодного столбца) и
+ * горячая 64-байтная запись (JobTable::lookup_record). Пока задания
+ * помещаются в L1/L2, разница мала; с ростом N полный Job вытесняется
+ * из кешей, а записи - нет.
+ *
+ * Отдельно замеряется только поиск, без хеширования.
+ */
+
+#include <iostream>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <random>
+#include <vector>
+
+#include "mining/job_table.hpp"
+#include "crypto/sha256.hpp"
+#include "core/byte_order.hpp"
+
+namespace quaxis::benchmark {
+
+using Clock = std::chrono::steady_clock;
+
+/// @brief Длительность одного прогона
+constexpr auto RUN_TIME = std::chrono::milliseconds(500);
+
+/// @brief Случайных job_id в наборе shares
+constexpr std::size_t SHARE_COUNT = 1 << 16;
+
+volatile uint8_t g_sink = 0;
+
+/**
+ * @brief Таблица из count заданий текущего поколения
+ */
+void fill_table(mining::JobTable& table, std::size_t count) {
+    std::mt19937 rng(7);
+    const auto now = Clock::now();
+    for (std::size_t i = 1; i <= count; ++i) {
+        mining::Job job;
+        job.job_id = static_cast<uint32_t>(i);
+        job.generation = table.generation();
+        for (auto& word : job.midstate) {
+            word = static_cast<uint32_t>(rng());
+        }
+        job.merkle_tail = {static_cast<uint8_t>(i), 0x11, 0x22, 0x33};
+        job.timestamp = 1700000000;
+        job.bits = 0x1705ae3a;
+        job.extranonce = i;
+        job.created_at = now;
+        table.publish(job);
+    }
+}
+
+std::vector<uint32_t> make_share_ids(std::size_t jobs) {
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<uint32_t> dist(1, static_cast<uint32_t>(jobs));
+    std::vector<uint32_t> ids(SHARE_COUNT);
+    for (auto& id : ids) {
+        id = dist(rng);
+    }
+    return ids;
+}
+
+/**
+ * @brief Проверять shares, пока не истечёт RUN_TIME
+ *
+ * @return double Shares в секунду
+ */
+template<typename Check>
+double run(const std::vector<uint32_t>& ids, Check check) {
+    uint64_t count = 0;
+    uint8_t sink = 0;
+    auto start = Clock::now();
+    while (Clock::now() - start < RUN_TIME) {
+        for (uint32_t id : ids) {
+            sink ^= check(id);
+        }
+        count += ids.size();
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    g_sink = sink;
+    return static_cast<double>(count) / seconds;
+}
+
+uint8_t hash_share(const crypto::Sha256State& midstate, const std::array<uint8_t, 4>& merkle_tail,
+                   uint32_t timestamp, uint32_t bits, uint32_t nonce) {
+    crypto::HeaderTail tail;
+    std::memcpy(tail.data(), merkle_tail.data(), merkle_tail.size());
+    write_le32(tail.data() + 4, timestamp);
+    write_le32(tail.data() + 8, bits);
+    write_le32(tail.data() + 12, nonce);
+    return crypto::hash_header_with_midstate(midstate, tail)[31];
+}
+
+void print_row(std::size_t jobs, const char* name, double full, double record) {
+    std::cout << "  jobs=" << std::setw(7) << jobs
+              << "  " << std::setw(14) << name
+              << "  Job: " << std::setw(8) << std::fixed << std::setprecision(2) << full / 1e6 << " M/s"
+              << "  запись: " << std::setw(8) << record / 1e6 << " M/s"
+              << "  x" << std::setprecision(2) << record / full
+              << std::endl;
+}
+
+} // namespace quaxis::benchmark
+
+int main() {
+    using namespace quaxis;
+    using namespace quaxis::benchmark;
+
+    std::cout << "=== Бенчмарк проверки shares: полный Job против 64-байтной записи ===" << std::endl;
+    std::cout << "sizeof(Job) = " << sizeof(mining::Job) << " байт" << std::endl;
+    std::cout << std::endl;
+
+    for (std::size_t jobs : {64u, 1024u, 16384u, 131072u, 524288u}) {
+        mining::JobTable table(jobs);
+        fill_table(table, jobs);
+        const auto ids = make_share_ids(jobs);
+
+        double full_hash = run(ids, [&](uint32_t id) -> uint8_t {
+            mining::Job job;
+            if (table.lookup(id, job) != mining::JobLookup::Current || job.is_stale()) {
+                return 0;
+            }
+            return hash_share(job.midstate, job.merkle_tail, job.timestamp, job.bits, id);
+        });
+        double record_hash = run(ids, [&](uint32_t id) -> uint8_t {
+            mining::JobRecord record;
+            if (table.lookup_record(id, record) != mining::JobLookup::Current || record.is_stale()) {
+                return 0;
+            }
+            return hash_share(record.midstate, record.merkle_tail, record.timestamp, record.bits, id);
+        });
+        print_row(jobs, "поиск+SHA256d", full_hash, record_hash);
+
+        double full_lookup = run(ids, [&](uint32_t id) -> uint8_t {
+            mining::Job job;
+            (void)table.lookup(id, job);
+            return static_cast<uint8_t>(job.midstate[0] ^ job.extranonce);
+        });
+        double record_lookup = run(ids, [&](uint32_t id) -> uint8_t {
+            mining::JobRecord record;
+            (void)table.lookup_record(id, record);
+            return static_cast<uint8_t>(record.midstate[0] ^ record.extranonce);
+        });
+        print_row(jobs, "только поиск", full_lookup, record_lookup);
+    }
+
+    return 0;
+}
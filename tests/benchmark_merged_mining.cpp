@@ -0,0 +1,335 @@
+/**
+ * @file benchmark_merged_mining.cpp
+ * @brief Бенчмарк ChainManager при росте числа aux chains
+ *
+ * ChainManager работает с mock chains: ответ "ноды" задерживается на
+ * заданную латентность RPC, новый блок появляется раз в заданный интервал
+ * (у chain i - интервал * (1 + i % 4), чтобы chains не менялись разом).
+ * Mock chains опрашиваются и отправляются синхронно (get_block_template,
+ * submit_block), без AuxRpcMulti - как chains без параллельного пути.
+ *
+ * Для 1..32 включённых chains выводится:
+ * 1. Пересборка commitment (выключение + включение chain, включая
+ *    раскладку дерева и снимок целей отбора)
+ * 2. Отбор chains по share (check_aux_chains)
+ * 3. Латентность от находки до ответа последней chain
+ *    (submit_to_matching_chains через AuxPowHexBuilder)
+ * 4. CPU процесса на chain при фоновом опросе
+ *
+ * Использование: benchmark_merged_mining [латентность_мс] [интервал_блока_мс]
+ */
+
+#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <iomanip>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "merged/chain_manager.hpp"
+#include "merged/chain_interface.hpp"
+#include "merged/auxpow.hpp"
+
+namespace quaxis::benchmark {
+
+using namespace quaxis::merged;
+using namespace std::chrono_literals;
+
+using Clock = std::chrono::steady_clock;
+
+/// @brief Длительность одного прогона
+constexpr auto RUN_TIME = std::chrono::milliseconds(500);
+
+/// @brief Окно измерения CPU фонового опроса
+constexpr auto CPU_WINDOW = std::chrono::seconds(6);
+
+/// @brief Target chains: хеш подходит с вероятностью 1/2
+constexpr uint32_t TARGET_BITS = 0x207fffff;
+
+/// @brief Приёмник результатов: не даёт компилятору выбросить отбор
+volatile std::size_t g_sink = 0;
+
+/**
+ * @brief Параметры mock "ноды"
+ */
+struct MockBackend {
+    std::chrono::milliseconds rpc_latency{2};
+    std::chrono::milliseconds block_interval{2000};
+};
+
+/**
+ * @brief Aux chain без сети: шаблоны и отправка с задержкой RPC
+ */
+class MockChain final : public IChain {
+public:
+    MockChain(uint32_t index, MockBackend backend)
+        : name_("mock" + std::to_string(index))
+        , backend_(backend)
+        , index_(index)
+        , started_(Clock::now()) {
+        // Chain ID: перемешанный индекс (splitmix64), слоты не совпадают подряд
+        uint64_t x = index + 0x9e3779b97f4a7c15ULL;
+        for (std::size_t i = 0; i < chain_id_.size(); i += 8) {
+            x += 0x9e3779b97f4a7c15ULL;
+            uint64_t z = x;
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+            z ^= z >> 31;
+            for (std::size_t j = 0; j < 8; ++j) {
+                chain_id_[i + j] = static_cast<uint8_t>(z >> (8 * j));
+            }
+        }
+    }
+
+    [[nodiscard]] std::string_view name() const noexcept override { return name_; }
+    [[nodiscard]] std::string_view ticker() const noexcept override { return "MCK"; }
+    [[nodiscard]] const Hash256& chain_id() const noexcept override { return chain_id_; }
+    [[nodiscard]] uint32_t priority() const noexcept override { return 100; }
+
+    [[nodiscard]] ChainInfo get_info() const noexcept override {
+        ChainInfo info;
+        info.name = name_;
+        info.ticker = "MCK";
+        info.status = status();
+        info.height = height();
+        return info;
+    }
+
+    [[nodiscard]] ChainStatus status() const noexcept override {
+        return connected_ ? ChainStatus::Ready : ChainStatus::Disconnected;
+    }
+
+    [[nodiscard]] Result<void> connect() override {
+        connected_ = true;
+        return {};
+    }
+
+    void disconnect() override { connected_ = false; }
+
+    [[nodiscard]] bool is_connected() const noexcept override { return connected_; }
+
+    [[nodiscard]] Result<AuxBlockTemplate> get_block_template() override {
+        std::this_thread::sleep_for(backend_.rpc_latency);
+        polls_.fetch_add(1, std::memory_order_relaxed);
+
+        AuxBlockTemplate tmpl;
+        tmpl.chain_id = chain_id_;
+        tmpl.target_bits = TARGET_BITS;
+        tmpl.height = height();
+        tmpl.block_hash[0] = static_cast<uint8_t>(index_);
+        tmpl.block_hash[1] = static_cast<uint8_t>(index_ >> 8);
+        for (std::size_t i = 0; i < 4; ++i) {
+            tmpl.block_hash[2 + i] = static_cast<uint8_t>(tmpl.height >> (8 * i));
+        }
+        return tmpl;
+    }
+
+    [[nodiscard]] Result<void> submit_block(
+        [[maybe_unused]] const AuxPow& auxpow,
+        [[maybe_unused]] const AuxBlockTemplate& block_template
+    ) override {
+        std::this_thread::sleep_for(backend_.rpc_latency);
+        return {};
+    }
+
+    [[nodiscard]] bool meets_target(
+        const Hash256& pow_hash,
+        const AuxBlockTemplate& current_template
+    ) const noexcept override {
+        return quaxis::merged::meets_target(pow_hash, current_template.target_bits);
+    }
+
+    void set_enabled(bool enabled) override { enabled_ = enabled; }
+    [[nodiscard]] bool is_enabled() const noexcept override { return enabled_; }
+    void set_priority([[maybe_unused]] uint32_t priority) override {}
+
+    /// @brief Число запросов шаблона
+    [[nodiscard]] uint64_t polls() const noexcept {
+        return polls_.load(std::memory_order_relaxed);
+    }
+
+private:
+    /// @brief Высота: новый блок раз в интервал chain
+    [[nodiscard]] uint32_t height() const noexcept {
+        const auto interval = backend_.block_interval * (1 + index_ % 4);
+        return 1000 + static_cast<uint32_t>((Clock::now() - started_) / interval);
+    }
+
+    std::string name_;
+    MockBackend backend_;
+    uint32_t index_;
+    Clock::time_point started_;
+    Hash256 chain_id_{};
+    std::atomic<bool> connected_{false};
+    std::atomic<bool> enabled_{true};
+    std::atomic<uint64_t> polls_{0};
+};
+
+/**
+ * @brief Результат прогона для одного числа chains
+ */
+struct RunResult {
+    double rebuild_us;
+    double match_ns;
+    double submit_us;
+    double cpu_ms_per_chain_s;
+    double polls_per_chain_s;
+};
+
+[[nodiscard]] std::chrono::nanoseconds process_cpu_time() {
+    timespec ts{};
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return std::chrono::seconds(ts.tv_sec) + std::chrono::nanoseconds(ts.tv_nsec);
+}
+
+/**
+ * @brief Заголовок с nonce; подходящий или нет - решает SHA256d
+ */
+[[nodiscard]] std::array<uint8_t, 80> make_header(uint32_t nonce) {
+    std::array<uint8_t, 80> header{};
+    header[0] = 0x20;
+    for (std::size_t i = 0; i < 4; ++i) {
+        header[76 + i] = static_cast<uint8_t>(nonce >> (8 * i));
+    }
+    return header;
+}
+
+RunResult run(std::size_t chain_count, MockBackend backend) {
+    std::vector<std::unique_ptr<IChain>> chains;
+    std::vector<const MockChain*> mocks;
+    for (std::size_t i = 0; i < chain_count; ++i) {
+        auto chain = std::make_unique<MockChain>(static_cast<uint32_t>(i), backend);
+        mocks.push_back(chain.get());
+        chains.push_back(std::move(chain));
+    }
+
+    MergedMiningConfig config;
+    config.enabled = true;
+    ChainManager manager(config, std::move(chains));
+    manager.start();
+
+    // Ждём шаблоны всех chains
+    while (manager.get_active_templates().size() < chain_count) {
+        std::this_thread::sleep_for(1ms);
+    }
+
+    RunResult result{};
+
+    // 1. Пересборка commitment
+    {
+        std::size_t iterations = 0;
+        const auto start = Clock::now();
+        while (Clock::now() - start < RUN_TIME) {
+            (void)manager.set_chain_enabled("mock0", false);
+            (void)manager.set_chain_enabled("mock0", true);
+            iterations += 2;
+        }
+        const std::chrono::duration<double, std::micro> elapsed = Clock::now() - start;
+        result.rebuild_us = elapsed.count() / static_cast<double>(iterations);
+    }
+
+    // 2. Отбор chains по share
+    const Bytes coinbase_tx(100, 0x01);
+    const MerkleBranch coinbase_branch{};
+    {
+        std::size_t iterations = 0;
+        uint32_t nonce = 0;
+        const auto start = Clock::now();
+        while (Clock::now() - start < RUN_TIME) {
+            for (int i = 0; i < 256; ++i) {
+                g_sink = g_sink + manager.check_aux_chains(
+                    make_header(nonce++), coinbase_tx, coinbase_branch).size();
+            }
+            iterations += 256;
+        }
+        const std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+        result.match_ns = elapsed.count() / static_cast<double>(iterations);
+    }
+
+    // 3. Находка -> ответ всех chains
+    {
+        AuxPowHexBuilder auxpow_hex(coinbase_tx, coinbase_branch);
+        std::size_t iterations = 0;
+        uint32_t nonce = 0;
+        const auto start = Clock::now();
+        while (Clock::now() - start < RUN_TIME) {
+            auto header = make_header(nonce++);
+            if (manager.check_aux_chains(header, coinbase_tx, coinbase_branch).empty()) {
+                continue;
+            }
+            auxpow_hex.set_parent_header(header);
+            g_sink = g_sink + manager.submit_to_matching_chains(auxpow_hex).size();
+            ++iterations;
+        }
+        // Время отбора несовпавших заголовков пренебрежимо против RPC
+        const std::chrono::duration<double, std::micro> elapsed = Clock::now() - start;
+        result.submit_us = elapsed.count() / static_cast<double>(std::max<std::size_t>(iterations, 1));
+    }
+
+    // 4. CPU фонового опроса
+    {
+        uint64_t polls_before = 0;
+        for (const auto* mock : mocks) {
+            polls_before += mock->polls();
+        }
+        const auto cpu_before = process_cpu_time();
+        std::this_thread::sleep_for(CPU_WINDOW);
+        const auto cpu = process_cpu_time() - cpu_before;
+        uint64_t polls = 0;
+        for (const auto* mock : mocks) {
+            polls += mock->polls();
+        }
+
+        const double window_s = std::chrono::duration<double>(CPU_WINDOW).count();
+        const double chains_s = static_cast<double>(chain_count) * window_s;
+        result.cpu_ms_per_chain_s = std::chrono::duration<double, std::milli>(cpu).count() / chains_s;
+        result.polls_per_chain_s = static_cast<double>(polls - polls_before) / chains_s;
+    }
+
+    manager.stop();
+    return result;
+}
+
+} // namespace quaxis::benchmark
+
+int main(int argc, char* argv[]) {
+    using namespace quaxis::benchmark;
+
+    // Необязательные аргументы: латентность RPC и интервал блока, мс
+    MockBackend backend;
+    if (argc > 1) {
+        backend.rpc_latency = std::chrono::milliseconds(std::stoul(argv[1]));
+    }
+    if (argc > 2) {
+        backend.block_interval = std::chrono::milliseconds(std::stoul(argv[2]));
+    }
+
+    std::cout << "=== Бенчмарк merged mining (mock chains) ===" << std::endl;
+    std::cout << "Латентность RPC: " << backend.rpc_latency.count() << " мс, "
+              << "интервал блока: " << backend.block_interval.count() << " мс" << std::endl;
+    std::cout << std::endl;
+
+    std::cout << std::setw(8) << "chains"
+              << std::setw(19) << "rebuild, мкс"
+              << std::setw(18) << "match, нс"
+              << std::setw(19) << "submit, мкс"
+              << std::setw(23) << "CPU, мс/с/chain"
+              << std::setw(28) << "опросов/с/chain" << std::endl;
+
+    for (std::size_t chains : {1u, 2u, 4u, 8u, 16u, 32u}) {
+        const auto result = run(chains, backend);
+        std::cout << std::fixed << std::setprecision(2)
+                  << std::setw(8) << chains
+                  << std::setw(16) << result.rebuild_us
+                  << std::setw(16) << result.match_ns
+                  << std::setw(16) << result.submit_us
+                  << std::setw(20) << result.cpu_ms_per_chain_s
+                  << std::setw(20) << result.polls_per_chain_s << std::endl;
+    }
+
+    return 0;
+}
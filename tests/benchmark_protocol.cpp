@@ -0,0 +1,164 @@
+/**
+ * @file benchmark_protocol.cpp
+ * @brief Бенчмарк кодирования и разбора кадров протокола ASIC
+ *
+ * Сравнивает старый путь (Bytes на каждый кадр, ProtocolParser с
+ * растущим буфером и erase() после каждого кадра) с новым
+ * (encode() в буфер вызывающего, FrameParser на кольцевом буфере):
+ * 1. Кадров в секунду (items_per_second)
+ * 2. Аллокаций на кадр (allocs_per_frame)
+ *
+ * BM_RejectShare_* - отказ разбора обрезанного кадра: Result<T>
+ * собирает сообщение ошибки, FastResult<T> - нет.
+ *
+ * Аллокации считаются подменой глобального operator new.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "alloc_counter.hpp"
+#include "network/protocol.hpp"
+
+namespace quaxis::benchmark {
+
+/// @brief Кадров в одном recv() (1024 байт / 9 байт на share)
+constexpr uint32_t SHARES_PER_CHUNK = 113;
+
+/// @brief Поток share-кадров, как его получает recv-поток
+Bytes make_share_chunk() {
+    Bytes chunk;
+    for (uint32_t i = 0; i < SHARES_PER_CHUNK; ++i) {
+        auto frame = network::ShareMessage{mining::Share{i, i * 3}}.serialize();
+        chunk.insert(chunk.end(), frame.begin(), frame.end());
+    }
+    return chunk;
+}
+
+/// @brief Общие счётчики: кадры/с и аллокации на кадр
+void report(::benchmark::State& state, uint64_t frames, uint64_t allocations) {
+    state.SetItemsProcessed(static_cast<int64_t>(frames));
+    state.counters["allocs_per_frame"] = ::benchmark::Counter(
+        static_cast<double>(allocations) / static_cast<double>(frames)
+    );
+}
+
+mining::Job make_job() {
+    mining::Job job;
+    job.job_id = 0x01020304;
+    job.timestamp = 1700000000;
+    job.bits = 0x1705ae3a;
+    return job;
+}
+
+// =============================================================================
+// Кодирование NewJob
+// =============================================================================
+
+void BM_EncodeJob_Bytes(::benchmark::State& state) {
+    mining::Job job = make_job();
+    uint64_t frames = 0;
+    uint64_t before = allocation_count();
+
+    for (auto _ : state) {
+        Bytes frame = network::serialize_new_job(job);
+        ::benchmark::DoNotOptimize(frame.data());
+        ++frames;
+    }
+
+    report(state, frames, allocation_count() - before);
+}
+BENCHMARK(BM_EncodeJob_Bytes);
+
+void BM_EncodeJob_Span(::benchmark::State& state) {
+    mining::Job job = make_job();
+    network::NewJobFrame frame;
+    uint64_t frames = 0;
+    uint64_t before = allocation_count();
+
+    for (auto _ : state) {
+        network::NewJobMessage{job}.encode(frame);
+        ::benchmark::DoNotOptimize(frame.data());
+        ++frames;
+    }
+
+    report(state, frames, allocation_count() - before);
+}
+BENCHMARK(BM_EncodeJob_Span);
+
+// =============================================================================
+// Разбор Share
+// =============================================================================
+
+void BM_ParseShares_ProtocolParser(::benchmark::State& state) {
+    Bytes chunk = make_share_chunk();
+    network::ProtocolParser parser;
+    uint64_t frames = 0;
+    uint64_t before = allocation_count();
+
+    for (auto _ : state) {
+        parser.add_data(chunk);
+        while (auto msg = parser.try_parse()) {
+            ::benchmark::DoNotOptimize(msg);
+            ++frames;
+        }
+    }
+
+    report(state, frames, allocation_count() - before);
+}
+BENCHMARK(BM_ParseShares_ProtocolParser);
+
+void BM_ParseShares_FrameParser(::benchmark::State& state) {
+    Bytes chunk = make_share_chunk();
+    network::FrameParser parser;
+    uint64_t frames = 0;
+    uint64_t before = allocation_count();
+
+    for (auto _ : state) {
+        parser.feed(chunk, [&frames](const network::ParsedMessage& msg) {
+            ::benchmark::DoNotOptimize(&msg);
+            ++frames;
+        });
+    }
+
+    report(state, frames, allocation_count() - before);
+}
+BENCHMARK(BM_ParseShares_FrameParser);
+
+// =============================================================================
+// Отказ разбора: Result<T> против FastResult<T>
+// =============================================================================
+
+void BM_RejectShare_Result(::benchmark::State& state) {
+    const Bytes truncated{0x00, 0x01, 0x02};
+    uint64_t frames = 0;
+    uint64_t before = allocation_count();
+
+    for (auto _ : state) {
+        // Старый путь: сообщение ошибки собирается в std::string
+        Result<network::ShareMessage> result = network::ShareMessage::deserialize(truncated);
+        ::benchmark::DoNotOptimize(result);
+        ++frames;
+    }
+
+    report(state, frames, allocation_count() - before);
+}
+BENCHMARK(BM_RejectShare_Result);
+
+void BM_RejectShare_FastResult(::benchmark::State& state) {
+    const Bytes truncated{0x00, 0x01, 0x02};
+    uint64_t frames = 0;
+    uint64_t before = allocation_count();
+
+    for (auto _ : state) {
+        auto result = network::ShareMessage::deserialize(truncated);
+        ::benchmark::DoNotOptimize(result);
+        ++frames;
+    }
+
+    report(state, frames, allocation_count() - before);
+}
+BENCHMARK(BM_RejectShare_FastResult);
+
+} // namespace quaxis::benchmark
+
+BENCHMARK_MAIN();
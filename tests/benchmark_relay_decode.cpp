@@ -0,0 +1,240 @@
+/**
+ * @file benchmark_relay_decode.cpp
+ * @brief Бенчмарк конвейера приём -> FEC декодирование RelayManager
+ *
+ * Два локальных FIBRE пира всплеском (RATE_MBPS каждый) шлют BLOCKS
+ * блоков N = 200, M = 50 (код Коши) с потерей LOST data чанков - каждый
+ * блок собирается решением системы над GF(2^8). Чанки пиров пересекаются: второй шлёт
+ * тот же набор в обратном порядке, как гонка двух FIBRE нод.
+ *
+ * Для decode_thread = false / true:
+ * - Датаграмм потеряно: отправлено минус принято пирами (переполнение
+ *   буфера сокета, пока поток приёма занят decode)
+ * - Собрано блоков
+ * - p50 / p99 / max реконструкции (от первого пакета блока) и
+ *   декодирования (от декодируемого набора чанков до блока)
+ */
+
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <numeric>
+#include <random>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "relay/fec_decoder.hpp"
+#include "relay/fibre_protocol.hpp"
+#include "relay/relay_manager.hpp"
+#include "relay/udp_socket.hpp"
+
+namespace quaxis::benchmark {
+
+using Clock = std::chrono::steady_clock;
+
+/// @brief Размер чанка FIBRE
+constexpr std::size_t CHUNK = 1400;
+
+/// @brief Блоков во всплеске
+constexpr std::size_t BLOCKS = 16;
+
+/// @brief Data / FEC чанков блока
+constexpr uint16_t DATA_CHUNKS = 200;
+constexpr uint16_t FEC_CHUNKS = 50;
+
+/// @brief Потеряно data чанков блока (восстанавливаются FEC)
+constexpr std::size_t LOST = 25;
+
+/// @brief Датаграмм за sendmmsg
+constexpr std::size_t SEND_BURST = 32;
+
+/// @brief Темп каждого пира (Мбит/с): всплеск, а не мгновенная заливка буфера
+constexpr uint64_t RATE_MBPS = 1000;
+
+/**
+ * @brief Датаграммы одного блока: data без потерянных и все FEC
+ */
+std::vector<std::vector<uint8_t>> make_block_datagrams(std::mt19937& rng, uint32_t height) {
+    relay::FecParams params;
+    params.data_chunk_count = DATA_CHUNKS;
+    params.fec_chunk_count = FEC_CHUNKS;
+
+    std::vector<std::vector<uint8_t>> data(DATA_CHUNKS, std::vector<uint8_t>(CHUNK));
+    for (auto& chunk : data) {
+        for (auto& b : chunk) {
+            b = static_cast<uint8_t>(rng());
+        }
+    }
+    std::vector<ByteSpan> spans(data.begin(), data.end());
+    auto parity = relay::encode_fec_chunks(params, spans);
+    if (!parity) {
+        return {};
+    }
+
+    Hash256 hash{};
+    for (auto& b : hash) {
+        b = static_cast<uint8_t>(rng());
+    }
+
+    relay::FibreParser parser;
+    auto make_datagram = [&](uint16_t chunk_id, bool fec, const std::vector<uint8_t>& payload) {
+        relay::FibrePacket packet;
+        packet.header.magic = relay::FIBRE_MAGIC;
+        packet.header.version = relay::FIBRE_VERSION;
+        packet.header.flags = static_cast<uint8_t>(fec ? relay::FibreFlags::FecChunk : relay::FibreFlags::None);
+        packet.header.chunk_id = chunk_id;
+        packet.header.block_height = height;
+        packet.header.block_hash = hash;
+        packet.header.data_chunks = DATA_CHUNKS;
+        packet.header.total_chunks = DATA_CHUNKS + FEC_CHUNKS;
+        packet.header.payload_size = static_cast<uint16_t>(payload.size());
+        packet.payload = payload;
+        return parser.serialize(packet);
+    };
+
+    std::vector<uint16_t> order(DATA_CHUNKS);
+    std::iota(order.begin(), order.end(), uint16_t{0});
+    std::shuffle(order.begin(), order.end(), rng);
+    std::sort(order.begin() + LOST, order.end());
+
+    std::vector<std::vector<uint8_t>> datagrams;
+    for (std::size_t i = LOST; i < DATA_CHUNKS; ++i) {
+        datagrams.push_back(make_datagram(order[i], false, data[order[i]]));
+    }
+    for (uint16_t f = 0; f < FEC_CHUNKS; ++f) {
+        datagrams.push_back(make_datagram(static_cast<uint16_t>(DATA_CHUNKS + f), true, (*parity)[f]));
+    }
+    return datagrams;
+}
+
+/**
+ * @brief Локальный FIBRE пир: сокет и адрес пира менеджера
+ */
+struct FibreSource {
+    relay::UdpSocket socket;
+    relay::UdpEndpoint peer;
+
+    FibreSource() {
+        (void)socket.bind(0, "127.0.0.1");
+    }
+
+    /**
+     * @brief Дождаться keepalive пира менеджера, запомнить его адрес
+     */
+    bool learn_peer() {
+        auto deadline = Clock::now() + std::chrono::seconds(1);
+        bool found = false;
+        while (!found && Clock::now() < deadline) {
+            socket.receive_batch([&](const relay::UdpDatagram& datagram) {
+                peer = datagram.sender();
+                found = true;
+            });
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+        return found;
+    }
+};
+
+void print_ms(const char* name, const core::LatencyHistogram& histogram) {
+    std::cout << "    " << name << ": " << std::fixed << std::setprecision(2)
+              << "p50 " << std::setw(7) << static_cast<double>(histogram.percentile(0.50)) / 1e6
+              << "  p99 " << std::setw(7) << static_cast<double>(histogram.percentile(0.99)) / 1e6
+              << "  max " << std::setw(7) << static_cast<double>(histogram.max()) / 1e6 << " мс"
+              << std::endl;
+}
+
+void bench_burst(bool decode_thread, const std::vector<std::vector<std::vector<uint8_t>>>& blocks) {
+    RelayConfig config;
+    config.decode_thread = decode_thread;
+    config.max_inflight_blocks = BLOCKS;
+    relay::RelayManager manager(config);
+    if (!manager.start()) {
+        std::cout << "  не удалось запустить RelayManager" << std::endl;
+        return;
+    }
+
+    FibreSource sources[2];
+    for (auto& source : sources) {
+        relay::RelayPeerConfig peer;
+        peer.host = "127.0.0.1";
+        peer.port = source.socket.local_port();
+        peer.keepalive_interval_ms = 20;
+        if (!manager.add_peer(peer) || !source.learn_peer()) {
+            std::cout << "  пир не подключился" << std::endl;
+            return;
+        }
+    }
+
+    // Всплеск: оба пира шлют все блоки подряд, второй - в обратном порядке чанков
+    uint64_t sent = 0;
+    uint64_t bytes = 0;
+    const auto started = Clock::now();
+    for (const auto& block : blocks) {
+        std::vector<ByteSpan> forward(block.begin(), block.end());
+        std::vector<ByteSpan> backward(forward.rbegin(), forward.rend());
+        for (std::size_t offset = 0; offset < forward.size(); offset += SEND_BURST) {
+            const std::size_t count = std::min(SEND_BURST, forward.size() - offset);
+            auto a = sources[0].socket.send_batch(sources[0].peer,
+                                                  std::span<const ByteSpan>(forward).subspan(offset, count));
+            auto b = sources[1].socket.send_batch(sources[1].peer,
+                                                  std::span<const ByteSpan>(backward).subspan(offset, count));
+            sent += (a ? *a : 0) + (b ? *b : 0);
+            for (std::size_t i = offset; i < offset + count; ++i) {
+                bytes += forward[i].size();
+            }
+            // Мбит/с = бит/мкс
+            std::this_thread::sleep_until(started + std::chrono::microseconds(bytes * 8 / RATE_MBPS));
+        }
+    }
+    const double send_ms = std::chrono::duration<double, std::milli>(Clock::now() - started).count();
+
+    auto deadline = Clock::now() + std::chrono::seconds(3);
+    while (manager.stats().blocks_received < BLOCKS && Clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    // Снимок пиров публикуется раз в секунду
+    std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+
+    uint64_t received = 0;
+    for (const auto& peer : manager.peer_stats()) {
+        received += peer.stats.packets_received;
+    }
+    const auto stats = manager.stats();
+    const auto latency = manager.latency_histograms();
+    manager.stop();
+
+    std::cout << "  decode_thread = " << (decode_thread ? "true " : "false") << std::endl;
+    std::cout << "    отправлено     " << sent << " датаграмм за " << std::fixed << std::setprecision(1)
+              << send_ms << " мс" << std::endl;
+    std::cout << "    потеряно       " << (sent > received ? sent - received : 0) << std::endl;
+    std::cout << "    собрано блоков " << stats.blocks_received << " из " << BLOCKS << std::endl;
+    print_ms("реконструкция", latency.reconstruction_latency);
+    print_ms("декодирование", latency.decode_latency);
+}
+
+} // namespace quaxis::benchmark
+
+int main() {
+    using namespace quaxis;
+    using namespace quaxis::benchmark;
+
+    std::cout << "=== Бенчмарк конвейера FEC декодирования relay ===" << std::endl;
+    std::cout << "2 пира, " << BLOCKS << " блоков N=" << DATA_CHUNKS << " M=" << FEC_CHUNKS
+              << ", потеряно " << LOST << " data чанков на блок" << std::endl;
+    std::cout << std::endl;
+
+    std::mt19937 rng(7);
+    std::vector<std::vector<std::vector<uint8_t>>> blocks;
+    for (std::size_t i = 0; i < BLOCKS; ++i) {
+        blocks.push_back(make_block_datagrams(rng, static_cast<uint32_t>(900'000 + i)));
+    }
+
+    for (bool decode_thread : {false, true}) {
+        bench_burst(decode_thread, blocks);
+        std::cout << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,285 @@
+/**
+ * @file benchmark_server_engines.cpp
+ * @brief Бенчмарк моделей ввода-вывода network::Server
+ *
+ * Сравнивает engine = "threaded" (recv/send поток на каждый ASIC)
+ * и engine = "epoll" (edge-triggered reactor) на 10/100/1000
+ * симулированных ASIC, подключённых по loopback:
+ * 1. Количество потоков процесса
+ * 2. Латентность broadcast_job до последнего ASIC
+ * 3. Пропускная способность приёма shares
+ *
+ * Запуск: benchmark_server_engines [max_asics]
+ */
+
+#include <iostream>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <numeric>
+#include <fstream>
+#include <string>
+#include <cstring>
+#include <iomanip>
+
+#include <sys/socket.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+#include "network/server.hpp"
+#include "network/protocol.hpp"
+#include "mining/job_manager.hpp"
+#include "bitcoin/coinbase.hpp"
+
+namespace quaxis::benchmark {
+
+using Clock = std::chrono::steady_clock;
+
+/// @brief Количество раундов broadcast на один прогон
+constexpr int BROADCAST_ROUNDS = 20;
+
+/// @brief Shares от каждого ASIC
+constexpr int SHARES_PER_ASIC = 20;
+
+/// @brief Размер кадра задания (команда + 48 байт)
+constexpr std::size_t JOB_FRAME_SIZE = 1 + constants::JOB_MESSAGE_SIZE;
+
+/**
+ * @brief Результаты одного прогона
+ */
+struct EngineResult {
+    int threads = 0;
+    double broadcast_median_us = 0;
+    double broadcast_p99_us = 0;
+    double shares_per_sec = 0;
+};
+
+/**
+ * @brief Количество потоков процесса (/proc/self/status)
+ */
+int thread_count() {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.rfind("Threads:", 0) == 0) {
+            return std::stoi(line.substr(8));
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Поднять лимит файловых дескрипторов до жёсткого
+ */
+void raise_fd_limit() {
+    struct rlimit lim;
+    if (getrlimit(RLIMIT_NOFILE, &lim) == 0) {
+        lim.rlim_cur = lim.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &lim);
+    }
+}
+
+/**
+ * @brief Подключить симулированный ASIC
+ */
+int connect_client(uint16_t port) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return -1;
+    }
+
+    struct sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+
+    if (connect(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0) {
+        close(fd);
+        return -1;
+    }
+
+    int flags = fcntl(fd, F_GETFL, 0);
+    fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+    return fd;
+}
+
+/**
+ * @brief Дождаться, пока каждый клиент получит кадр задания
+ *
+ * @return Время получения последнего кадра
+ */
+Clock::time_point wait_all_jobs(int epoll_fd, std::size_t clients, std::vector<std::size_t>& received) {
+    std::fill(received.begin(), received.end(), 0);
+    std::size_t done = 0;
+    std::array<struct epoll_event, 256> events;
+    std::array<uint8_t, 1024> buffer;
+    Clock::time_point last = Clock::now();
+
+    while (done < clients) {
+        int n = epoll_wait(epoll_fd, events.data(), static_cast<int>(events.size()), 1000);
+        if (n <= 0) {
+            break;  // Таймаут: часть кадров потеряна
+        }
+        for (int i = 0; i < n; ++i) {
+            // data.u64 = (fd << 32) | индекс клиента
+            uint64_t key = events[i].data.u64;
+            int fd = static_cast<int>(key >> 32);
+            std::size_t slot = static_cast<std::size_t>(key & 0xFFFFFFFFu);
+            for (;;) {
+                ssize_t r = recv(fd, buffer.data(), buffer.size(), 0);
+                if (r <= 0) {
+                    break;
+                }
+                std::size_t before = received[slot];
+                received[slot] += static_cast<std::size_t>(r);
+                if (before < JOB_FRAME_SIZE && received[slot] >= JOB_FRAME_SIZE) {
+                    ++done;
+                    last = Clock::now();
+                }
+            }
+        }
+    }
+
+    return last;
+}
+
+/**
+ * @brief Прогон одного engine на N ASIC
+ */
+EngineResult run_engine(const std::string& engine, std::size_t asics, uint16_t port) {
+    EngineResult result;
+
+    MiningConfig mining_config;
+    Hash160 pubkey_hash{};
+    pubkey_hash.fill(0x42);
+    mining::JobManager job_manager(mining_config, bitcoin::CoinbaseBuilder(pubkey_hash));
+
+    ServerConfig config;
+    config.bind_address = "127.0.0.1";
+    config.port = port;
+    config.max_connections = asics + 16;
+    config.engine = engine;
+    config.worker_threads = 2;
+
+    network::Server server(config, job_manager);
+    if (auto started = server.start(); !started) {
+        std::cerr << "  Не удалось запустить сервер: " << started.error().message << std::endl;
+        return result;
+    }
+
+    // === Подключение клиентов ===
+    std::vector<int> clients;
+    clients.reserve(asics);
+    for (std::size_t i = 0; i < asics; ++i) {
+        int fd = connect_client(port);
+        if (fd < 0) {
+            std::cerr << "  Не удалось подключить клиента " << i << std::endl;
+            break;
+        }
+        clients.push_back(fd);
+    }
+
+    auto deadline = Clock::now() + std::chrono::seconds(10);
+    while (server.connection_count() < clients.size() && Clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+    result.threads = thread_count();
+
+    int epoll_fd = epoll_create1(0);
+    for (std::size_t i = 0; i < clients.size(); ++i) {
+        struct epoll_event ev{};
+        ev.events = EPOLLIN | EPOLLET;
+        ev.data.u64 = (static_cast<uint64_t>(clients[i]) << 32) | i;
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, clients[i], &ev);
+    }
+
+    // === Латентность broadcast ===
+    mining::Job job;
+    job.bits = 0x1705ae3a;
+    std::vector<std::size_t> received(clients.size());
+    std::vector<double> latencies;
+
+    for (int round = 0; round < BROADCAST_ROUNDS; ++round) {
+        job.job_id = static_cast<uint32_t>(round + 1);
+        auto start = Clock::now();
+        server.broadcast_job(job);
+        auto last = wait_all_jobs(epoll_fd, clients.size(), received);
+        latencies.push_back(std::chrono::duration<double, std::micro>(last - start).count());
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    result.broadcast_median_us = latencies[latencies.size() / 2];
+    result.broadcast_p99_us = latencies[latencies.size() * 99 / 100];
+
+    // === Приём shares ===
+    network::ShareMessage share_msg{mining::Share{1, 0}};
+    Bytes frame = share_msg.serialize();
+    uint64_t base = server.stats().total_shares;
+    uint64_t expected = base + static_cast<uint64_t>(clients.size()) * SHARES_PER_ASIC;
+
+    auto start = Clock::now();
+    for (int k = 0; k < SHARES_PER_ASIC; ++k) {
+        for (int fd : clients) {
+            [[maybe_unused]] auto n = send(fd, frame.data(), frame.size(), MSG_NOSIGNAL);
+        }
+    }
+    deadline = Clock::now() + std::chrono::seconds(30);
+    while (server.stats().total_shares < expected && Clock::now() < deadline) {
+        std::this_thread::yield();
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    result.shares_per_sec = static_cast<double>(server.stats().total_shares - base) / seconds;
+
+    // === Завершение ===
+    close(epoll_fd);
+    for (int fd : clients) {
+        close(fd);
+    }
+    server.stop();
+
+    return result;
+}
+
+void print_result(const std::string& engine, std::size_t asics, const EngineResult& r) {
+    std::cout << "  " << std::setw(8) << engine
+              << "  ASIC=" << std::setw(4) << asics
+              << "  threads=" << std::setw(5) << r.threads
+              << "  broadcast median=" << std::setw(9) << std::fixed << std::setprecision(1)
+              << r.broadcast_median_us << " мкс"
+              << "  p99=" << std::setw(9) << r.broadcast_p99_us << " мкс"
+              << "  shares/s=" << std::setw(10) << std::setprecision(0) << r.shares_per_sec
+              << std::endl;
+}
+
+} // namespace quaxis::benchmark
+
+int main(int argc, char* argv[]) {
+    using namespace quaxis::benchmark;
+
+    // Необязательный аргумент: максимальное число ASIC (по умолчанию 1000)
+    std::size_t max_asics = argc > 1 ? std::stoul(argv[1]) : 1000;
+
+    raise_fd_limit();
+
+    std::cout << "=== Бенчмарк network::Server: threaded vs epoll ===" << std::endl;
+    std::cout << std::endl;
+
+    uint16_t port = 43330;
+    for (std::size_t asics : {10u, 100u, 1000u}) {
+        if (asics > max_asics) {
+            break;
+        }
+        for (const char* engine : {"threaded", "epoll"}) {
+            print_result(engine, asics, run_engine(engine, asics, port++));
+        }
+    }
+
+    return 0;
+}
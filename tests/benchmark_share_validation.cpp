@@ -0,0 +1,186 @@
+/**
+ * @file benchmark_share_validation.cpp
+ * @brief Бенчмарк проверки shares (один поток и пул проверки)
+ *
+ * 1. Только проверка порога: прежний путь (target_to_difficulty() для
+ *    каждого хеша + побайтовое сравнение с target блока) против
+ *    сравнения словами uint64 с заранее подготовленным target
+ * 2. Полный ShareValidator::validate() (поиск задания, SHA256d,
+ *    дедупликация, порог)
+ * 3. Пул проверки (submit_batch + N потоков, многоканальный SHA256)
+ *
+ * Хеши случайные, поэтому почти все shares ниже порога - как у реального
+ * ASIC, если считать по всем проверенным хешам.
+ */
+
+#include <iostream>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <vector>
+#include <iomanip>
+#include <string>
+
+#include "mining/job_manager.hpp"
+#include "mining/share_validator.hpp"
+#include "bitcoin/coinbase.hpp"
+#include "bitcoin/target.hpp"
+
+namespace quaxis::benchmark {
+
+using Clock = std::chrono::steady_clock;
+
+/// @brief Длительность одного прогона
+constexpr auto RUN_TIME = std::chrono::milliseconds(500);
+
+/// @brief Количество заранее сгенерированных хешей
+constexpr std::size_t HASH_COUNT = 4096;
+
+/// @brief Сложность shares ASIC
+constexpr double SHARE_DIFFICULTY = 1.0;
+
+/**
+ * @brief Побайтовое сравнение (до Target256)
+ */
+bool meets_target_bytes(const Hash256& hash, const Hash256& target) noexcept {
+    for (int i = 31; i >= 0; --i) {
+        auto idx = static_cast<std::size_t>(i);
+        if (hash[idx] != target[idx]) {
+            return hash[idx] < target[idx];
+        }
+    }
+    return true;
+}
+
+std::vector<Hash256> make_hashes() {
+    std::mt19937_64 rng(42);
+    std::vector<Hash256> hashes(HASH_COUNT);
+    for (auto& hash : hashes) {
+        for (auto& byte : hash) {
+            byte = static_cast<uint8_t>(rng());
+        }
+        // Часть хешей проходит порог сложности 1
+        if ((rng() & 7) == 0) {
+            std::fill(hash.begin() + 28, hash.end(), 0);
+        }
+    }
+    return hashes;
+}
+
+/**
+ * @brief Крутить check, пока не истечёт RUN_TIME
+ *
+ * @return double Проверок в секунду
+ */
+template<typename Check>
+double run(const std::vector<Hash256>& hashes, Check check) {
+    uint64_t checks = 0;
+    uint64_t passed = 0;
+    auto start = Clock::now();
+    while (Clock::now() - start < RUN_TIME) {
+        for (const auto& hash : hashes) {
+            passed += check(hash) ? 1 : 0;
+        }
+        checks += hashes.size();
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    // passed не даёт компилятору выбросить цикл
+    return passed > 0 ? static_cast<double>(checks) / seconds : 0.0;
+}
+
+double benchmark_threshold_bytes(const std::vector<Hash256>& hashes) {
+    Hash256 block_target = bitcoin::bits_to_target(0x1705ae3a);
+    return run(hashes, [&](const Hash256& hash) {
+        double difficulty = bitcoin::target_to_difficulty(hash);
+        if (meets_target_bytes(hash, block_target)) {
+            return true;
+        }
+        return difficulty >= SHARE_DIFFICULTY;
+    });
+}
+
+double benchmark_threshold_words(const std::vector<Hash256>& hashes) {
+    auto block_target = bitcoin::Target256::from_hash(bitcoin::bits_to_target(0x1705ae3a));
+    auto share_target = bitcoin::difficulty_to_target(SHARE_DIFFICULTY);
+    double total = 0.0;
+    double rate = run(hashes, [&](const Hash256& hash) {
+        if (bitcoin::meets_target(hash, block_target) || bitcoin::meets_target(hash, share_target)) {
+            total += bitcoin::target_to_difficulty(hash);
+            return true;
+        }
+        return false;
+    });
+    return total > 0.0 ? rate : 0.0;
+}
+
+/**
+ * @brief Полная проверка shares: синхронно (workers = 0) или пулом
+ */
+double benchmark_validator(std::size_t workers) {
+    MiningConfig config;
+    Hash160 pubkey_hash{};
+    pubkey_hash.fill(0x42);
+    bitcoin::CoinbaseBuilder builder(pubkey_hash);
+
+    bitcoin::BlockTemplate tmpl;
+    auto [coinbase, midstate] = builder.build_with_midstate(800000, 625000000, 0);
+    tmpl.height = 800000;
+    tmpl.header.bits = 0x1705ae3a;
+    tmpl.coinbase_tx = std::move(coinbase);
+    tmpl.coinbase_midstate = midstate;
+    tmpl.update_extranonce(0);
+
+    mining::JobManager manager(config, builder);
+    manager.on_new_block(tmpl);
+    (void)manager.register_connection(1);
+    auto job = manager.get_next_job_for_connection(1);
+
+    mining::ShareValidator validator(manager);
+    validator.set_partial_difficulty(SHARE_DIFFICULTY);
+    validator.start_workers(workers);
+
+    std::vector<mining::Share> batch(64);
+    uint64_t shares = 0;
+    uint32_t nonce = 0;
+    auto start = Clock::now();
+    while (Clock::now() - start < RUN_TIME) {
+        for (auto& share : batch) {
+            share = mining::Share{job->job_id, nonce++};
+        }
+        validator.submit_batch(batch);
+        shares += batch.size();
+        // Не даём очереди переполниться: иначе проверка уходит в этот поток
+        while (validator.pending_shares() > 4096) {
+            std::this_thread::yield();
+        }
+    }
+    validator.stop_workers();
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    return validator.total_shares() == shares ? static_cast<double>(shares) / seconds : 0.0;
+}
+
+void print_row(const char* name, double per_sec) {
+    std::cout << "  " << std::setw(32) << name
+              << "  shares/s=" << std::setw(14) << std::fixed << std::setprecision(0) << per_sec
+              << std::endl;
+}
+
+} // namespace quaxis::benchmark
+
+int main() {
+    using namespace quaxis::benchmark;
+
+    std::cout << "=== Бенчмарк проверки shares ===" << std::endl;
+    std::cout << std::endl;
+
+    auto hashes = make_hashes();
+    print_row("порог: difficulty + байты", benchmark_threshold_bytes(hashes));
+    print_row("порог: слова uint64", benchmark_threshold_words(hashes));
+    print_row("validate (поток приёма)", benchmark_validator(0));
+    for (std::size_t workers : {1u, 2u, 4u}) {
+        std::string name = "пул, потоков: " + std::to_string(workers);
+        print_row(name.c_str(), benchmark_validator(workers));
+    }
+
+    return 0;
+}
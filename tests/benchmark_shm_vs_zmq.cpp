@@ -5,7 +5,23 @@
  * Измеряет латентность уведомлений через:
  * 1. POSIX Shared Memory с spin-wait
  * 2. POSIX Shared Memory с poll
- * 3. ZMQ (если доступен)
+ * 3. POSIX Shared Memory с futex (spin, затем futex_wait / futex_wake)
+ * 4. ZMQ (если доступен)
+ * 
+ * Для futex латентность - от публикации до момента, когда читатель
+ * увидел новый sequence; дополнительно выводится CPU потока читателя.
+ * 
+ * Режим --placement [hugetlb_dir] измеряет ping-pong через сегмент для
+ * разных раскладок потоков по CPU / NUMA узлам (половина round-trip).
+ *
+ * Издатель узла (libquaxis_publisher): латентность от вызова C ABI
+ * публикации до того, как читатель майнера получил событие кольца или
+ * согласованную копию шаблона.
+ *
+ * Подписчики целиком: от публикации до вызова NewBlockCallback у
+ * bitcoin::ShmSubscriber (кольцо, futex) и bitcoin::ZmqSubscriber
+ * (PUB на loopback TCP, как -zmqpubrawblock узла; только со сборкой
+ * с libzmq).
  */
 
 #include <iostream>
@@ -18,12 +34,27 @@
 #include <numeric>
 #include <cstring>
 #include <iomanip>
+#include <string>
 
 #include <sys/mman.h>
 #include <sys/stat.h>
 #include <fcntl.h>
+#include <time.h>
 #include <unistd.h>
 
+#ifdef QUAXIS_HAS_ZMQ
+#include <zmq.h>
+#endif
+
+#include "bitcoin/shm_ring.hpp"
+#include "bitcoin/shm_subscriber.hpp"
+#include "bitcoin/zmq_subscriber.hpp"
+#include "bitcoin/shm_template_layout.hpp"
+#include "publisher/quaxis_publisher.h"
+#include "shm/adaptive_spin.hpp"
+#include "shm/placement.hpp"
+#include "shm/sequence_futex.hpp"
+
 namespace quaxis::benchmark {
 
 /**
@@ -253,6 +284,109 @@ BenchmarkResult benchmark_poll(int iterations, int poll_interval_us) {
     return calculate_stats(name, latencies);
 }
 
+/**
+ * @brief CPU время текущего потока
+ */
+double thread_cpu_seconds() {
+    timespec ts{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<double>(ts.tv_sec) + static_cast<double>(ts.tv_nsec) / 1e9;
+}
+
+/**
+ * @brief Бенчмарк гибридного режима AdaptiveSpinWait (spin + futex)
+ * 
+ * @param cpu_percent CPU потока читателя за время измерений (% ядра)
+ */
+BenchmarkResult benchmark_futex(int iterations, double& cpu_percent) {
+    const char* shm_name = "/quaxis_benchmark_futex";
+    
+    int fd = shm_open(shm_name, O_RDWR | O_CREAT, 0666);
+    if (fd < 0) {
+        return {"futex", 0, 0, 0, 0, 0};
+    }
+    
+    ftruncate(fd, sizeof(TestSharedBlock));
+    
+    auto* shm = static_cast<TestSharedBlock*>(
+        mmap(nullptr, sizeof(TestSharedBlock), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)
+    );
+    
+    if (shm == MAP_FAILED) {
+        close(fd);
+        shm_unlink(shm_name);
+        return {"futex", 0, 0, 0, 0, 0};
+    }
+    
+    new (shm) TestSharedBlock();
+    
+    using Clock = std::chrono::steady_clock;
+    std::vector<double> latencies;
+    latencies.reserve(iterations);
+    
+    std::atomic<bool> reader_ready{false};
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> reader_saw{0};
+    std::atomic<int64_t> seen_at_ns{0};
+    std::atomic<double> reader_cpu{0.0};
+    
+    quaxis::shm::AdaptiveSpinConfig config;
+    config.futex_wait = true;
+    
+    std::thread reader([&]() {
+        quaxis::shm::AdaptiveSpinWait waiter(config);
+        uint64_t last_seq = 0;
+        double cpu_start = thread_cpu_seconds();
+        reader_ready = true;
+        
+        while (!stop.load(std::memory_order_relaxed)) {
+            uint64_t current = shm->sequence.load(std::memory_order_acquire);
+            if (current == last_seq) {
+                waiter.wait_step(shm->sequence, last_seq);
+                continue;
+            }
+            seen_at_ns.store(Clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+            reader_saw.store(current, std::memory_order_release);
+            last_seq = current;
+            waiter.reset();
+        }
+        reader_cpu = thread_cpu_seconds() - cpu_start;
+    });
+    
+    while (!reader_ready) {
+        std::this_thread::yield();
+    }
+    
+    auto wall_start = Clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        // Читатель успевает уснуть в futex_wait
+        std::this_thread::sleep_for(std::chrono::microseconds(500));
+        
+        auto start = Clock::now();
+        uint64_t new_seq = quaxis::shm::publish_sequence(shm->sequence);
+        
+        while (reader_saw.load(std::memory_order_acquire) < new_seq) {
+            std::this_thread::yield();
+        }
+        
+        double latency = static_cast<double>(
+            seen_at_ns.load(std::memory_order_relaxed) - start.time_since_epoch().count());
+        latencies.push_back(latency);
+    }
+    double wall = std::chrono::duration<double>(Clock::now() - wall_start).count();
+    
+    stop = true;
+    quaxis::shm::publish_sequence(shm->sequence);
+    reader.join();
+    cpu_percent = reader_cpu.load() / wall * 100.0;
+    
+    munmap(shm, sizeof(TestSharedBlock));
+    close(fd);
+    shm_unlink(shm_name);
+    
+    return calculate_stats("SHM futex", latencies);
+}
+
 /**
  * @brief Бенчмарк атомарных операций (baseline)
  */
@@ -275,11 +409,525 @@ BenchmarkResult benchmark_atomic_baseline(int iterations) {
     return calculate_stats("atomic baseline", latencies);
 }
 
+// =============================================================================
+// Издатель узла -> подписчик майнера
+// =============================================================================
+
+/**
+ * @brief Отобразить сегмент издателя на чтение, как это делает майнер
+ */
+template<typename T>
+const T* map_reader(const char* shm_name, int& fd) {
+    fd = shm_open(shm_name, O_RDONLY, 0);
+    if (fd < 0) {
+        return nullptr;
+    }
+    void* ptr = mmap(nullptr, sizeof(T), PROT_READ, MAP_SHARED, fd, 0);
+    if (ptr == MAP_FAILED) {
+        close(fd);
+        return nullptr;
+    }
+    return static_cast<const T*>(ptr);
+}
+
+/**
+ * @brief quaxis_block_publish (кольцо) -> ShmRingReader::drain
+ *
+ * @param futex Читатель спит в futex_wait (иначе - spin)
+ */
+BenchmarkResult benchmark_publisher_ring(int iterations, bool futex) {
+    const char* shm_name = "/quaxis_benchmark_publisher";
+    const std::string name = futex ? "publisher ring futex" : "publisher ring spin";
+    
+    quaxis_block_channel* channel = quaxis_block_channel_create(shm_name, QUAXIS_LAYOUT_RING, nullptr);
+    if (channel == nullptr) {
+        return {name, 0, 0, 0, 0, 0};
+    }
+    int fd = -1;
+    const auto* ring = map_reader<quaxis::bitcoin::QuaxisSharedRing>(shm_name, fd);
+    if (ring == nullptr) {
+        quaxis_block_channel_close(channel, 1);
+        return {name, 0, 0, 0, 0, 0};
+    }
+    
+    using Clock = std::chrono::steady_clock;
+    std::vector<double> latencies;
+    latencies.reserve(iterations);
+    
+    std::atomic<bool> reader_ready{false};
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> reader_saw{0};
+    std::atomic<int64_t> seen_at_ns{0};
+    
+    quaxis::shm::AdaptiveSpinConfig config;
+    config.futex_wait = true;
+    
+    std::thread reader([&]() {
+        quaxis::shm::AdaptiveSpinWait waiter(config);
+        quaxis::bitcoin::ShmRingReader events(*ring);
+        reader_ready = true;
+        
+        while (!stop.load(std::memory_order_relaxed)) {
+            uint64_t last = events.next_sequence() - 1;
+            if (ring->sequence.load(std::memory_order_acquire) == last) {
+                if (futex) {
+                    waiter.wait_step(ring->sequence, last);
+                } else {
+                    quaxis::shm::cpu_pause();
+                }
+                continue;
+            }
+            events.drain([&](const quaxis::bitcoin::ShmBlockEvent& event) {
+                seen_at_ns.store(Clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+                reader_saw.store(event.sequence, std::memory_order_release);
+            });
+            waiter.reset();
+        }
+    });
+    
+    while (!reader_ready) {
+        std::this_thread::yield();
+    }
+    
+    quaxis_block block{};
+    block.state = QUAXIS_BLOCK_SPECULATIVE;
+    for (int i = 0; i < iterations; ++i) {
+        // Для futex читатель успевает уснуть
+        std::this_thread::sleep_for(std::chrono::microseconds(futex ? 500 : 50));
+        
+        block.height = static_cast<uint32_t>(i);
+        auto start = Clock::now();
+        uint64_t seq = quaxis_block_publish(channel, &block);
+        
+        while (reader_saw.load(std::memory_order_acquire) < seq) {
+            quaxis::shm::cpu_pause();
+        }
+        
+        latencies.push_back(static_cast<double>(
+            seen_at_ns.load(std::memory_order_relaxed) - start.time_since_epoch().count()));
+    }
+    
+    stop = true;
+    quaxis_block_publish(channel, &block);
+    reader.join();
+    
+    munmap(const_cast<quaxis::bitcoin::QuaxisSharedRing*>(ring), sizeof(quaxis::bitcoin::QuaxisSharedRing));
+    close(fd);
+    quaxis_block_channel_close(channel, 1);
+    
+    return calculate_stats(name, latencies);
+}
+
+/**
+ * @brief quaxis_template_publish -> read_shm_template (futex)
+ */
+BenchmarkResult benchmark_publisher_template(int iterations) {
+    const char* shm_name = "/quaxis_benchmark_publisher_template";
+    const std::string name = "publisher template";
+    
+    quaxis_template_channel* channel = quaxis_template_channel_create(shm_name, nullptr);
+    if (channel == nullptr) {
+        return {name, 0, 0, 0, 0, 0};
+    }
+    int fd = -1;
+    const auto* segment = map_reader<quaxis::bitcoin::QuaxisSharedTemplate>(shm_name, fd);
+    if (segment == nullptr) {
+        quaxis_template_channel_close(channel, 1);
+        return {name, 0, 0, 0, 0, 0};
+    }
+    
+    using Clock = std::chrono::steady_clock;
+    std::vector<double> latencies;
+    latencies.reserve(iterations);
+    
+    std::atomic<bool> reader_ready{false};
+    std::atomic<bool> stop{false};
+    std::atomic<uint32_t> reader_height{0};
+    std::atomic<int64_t> seen_at_ns{0};
+    
+    quaxis::shm::AdaptiveSpinConfig config;
+    config.futex_wait = true;
+    
+    std::thread reader([&]() {
+        quaxis::shm::AdaptiveSpinWait waiter(config);
+        quaxis::bitcoin::ShmTemplateData data;
+        uint64_t last = 0;
+        reader_ready = true;
+        
+        while (!stop.load(std::memory_order_relaxed)) {
+            uint64_t current = segment->sequence.load(std::memory_order_acquire);
+            if (current == last || (current & 1) != 0) {
+                waiter.wait_step(segment->sequence, current);
+                continue;
+            }
+            last = quaxis::bitcoin::read_shm_template(*segment, data);
+            seen_at_ns.store(Clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+            reader_height.store(data.height, std::memory_order_release);
+            waiter.reset();
+        }
+    });
+    
+    while (!reader_ready) {
+        std::this_thread::yield();
+    }
+    
+    // Шаблон обычного размера: coinbase ~ 64 + 6 + 200 байт
+    std::vector<uint8_t> suffix(200, 0x51);
+    quaxis_template tmpl{};
+    tmpl.state = QUAXIS_BLOCK_SPECULATIVE;
+    tmpl.coinbase_suffix = suffix.data();
+    tmpl.coinbase_suffix_size = suffix.size();
+    for (int i = 0; i < iterations; ++i) {
+        std::this_thread::sleep_for(std::chrono::microseconds(500));
+        
+        tmpl.height = static_cast<uint32_t>(i + 1);
+        auto start = Clock::now();
+        quaxis_template_publish(channel, &tmpl);
+        
+        while (reader_height.load(std::memory_order_acquire) < tmpl.height) {
+            quaxis::shm::cpu_pause();
+        }
+        
+        latencies.push_back(static_cast<double>(
+            seen_at_ns.load(std::memory_order_relaxed) - start.time_since_epoch().count()));
+    }
+    
+    stop = true;
+    tmpl.height = 0;
+    quaxis_template_publish(channel, &tmpl);
+    reader.join();
+    
+    munmap(const_cast<quaxis::bitcoin::QuaxisSharedTemplate*>(segment), sizeof(quaxis::bitcoin::QuaxisSharedTemplate));
+    close(fd);
+    quaxis_template_channel_close(channel, 1);
+    
+    return calculate_stats(name, latencies);
+}
+
+// =============================================================================
+// Подписчики целиком: публикация -> NewBlockCallback
+// =============================================================================
+
+/**
+ * @brief Время и высота последнего вызова NewBlockCallback
+ */
+struct CallbackProbe {
+    std::atomic<uint32_t> height{0};
+    std::atomic<int64_t> seen_at_ns{0};
+    
+    quaxis::bitcoin::NewBlockCallback callback() {
+        return [this](const quaxis::bitcoin::BlockHeader&, uint32_t h, int64_t, bool) {
+            seen_at_ns.store(std::chrono::steady_clock::now().time_since_epoch().count(),
+                             std::memory_order_relaxed);
+            height.store(h, std::memory_order_release);
+        };
+    }
+    
+    /// @brief Дождаться вызова с высотой height (false - таймаут 1 с)
+    bool wait_height(uint32_t h) const {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+        while (height.load(std::memory_order_acquire) != h) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                return false;
+            }
+            quaxis::shm::cpu_pause();
+        }
+        return true;
+    }
+};
+
+/**
+ * @brief quaxis_block_publish -> ShmSubscriber (кольцо, futex) -> callback
+ */
+BenchmarkResult benchmark_shm_subscriber(int iterations) {
+    const char* shm_name = "/quaxis_benchmark_shm_subscriber";
+    const std::string name = "ShmSubscriber";
+    
+    quaxis_block_channel* channel = quaxis_block_channel_create(shm_name, QUAXIS_LAYOUT_RING, nullptr);
+    if (channel == nullptr) {
+        return {name, 0, 0, 0, 0, 0};
+    }
+    
+    quaxis::ShmConfig config;
+    config.path = shm_name;
+    config.futex_wait = true;
+    quaxis::bitcoin::ShmSubscriber subscriber(config);
+    CallbackProbe probe;
+    subscriber.set_callback(probe.callback());
+    if (!subscriber.start()) {
+        quaxis_block_channel_close(channel, 1);
+        return {name, 0, 0, 0, 0, 0};
+    }
+    
+    using Clock = std::chrono::steady_clock;
+    std::vector<double> latencies;
+    latencies.reserve(iterations);
+    
+    quaxis_block block{};
+    block.state = QUAXIS_BLOCK_CONFIRMED;
+    for (int i = 0; i < iterations; ++i) {
+        std::this_thread::sleep_for(std::chrono::microseconds(500));
+        
+        block.height = static_cast<uint32_t>(i + 1);
+        block.timestamp = block.height;
+        auto start = Clock::now();
+        quaxis_block_publish(channel, &block);
+        if (!probe.wait_height(block.height)) {
+            continue;
+        }
+        latencies.push_back(static_cast<double>(
+            probe.seen_at_ns.load(std::memory_order_relaxed) - start.time_since_epoch().count()));
+    }
+    
+    subscriber.stop();
+    quaxis_block_channel_close(channel, 1);
+    if (latencies.empty()) {
+        return {name, 0, 0, 0, 0, 0};
+    }
+    return calculate_stats(name, latencies);
+}
+
+#ifdef QUAXIS_HAS_ZMQ
+
+/**
+ * @brief Блок из одной coinbase с BIP34 высотой, дополненный до size байт
+ */
+std::vector<uint8_t> make_rawblock(uint32_t height, std::size_t size) {
+    std::vector<uint8_t> block(80, 0);
+    block.push_back(0x01);                               // одна транзакция
+    block.insert(block.end(), {0x02, 0x00, 0x00, 0x00}); // version
+    block.push_back(0x01);                               // один вход
+    block.insert(block.end(), 36, 0xFF);                 // prevout
+    block.insert(block.end(), {0x04, 0x03,
+                               static_cast<uint8_t>(height),
+                               static_cast<uint8_t>(height >> 8),
+                               static_cast<uint8_t>(height >> 16)});
+    block.insert(block.end(), 4, 0xFF);                  // sequence
+    if (block.size() < size) {
+        block.resize(size, 0x00);                        // остальные транзакции
+    }
+    return block;
+}
+
+/**
+ * @brief PUB rawblock (loopback TCP) -> ZmqSubscriber -> callback
+ * 
+ * @param block_size Размер блока в сообщении (байт)
+ */
+BenchmarkResult benchmark_zmq_subscriber(int iterations, std::size_t block_size) {
+    const std::string name = "ZmqSubscriber " + std::to_string(block_size / 1000) + " KB";
+    
+    void* context = zmq_ctx_new();
+    void* publisher = zmq_socket(context, ZMQ_PUB);
+    char endpoint[256];
+    std::size_t endpoint_size = sizeof(endpoint);
+    if (zmq_bind(publisher, "tcp://127.0.0.1:*") != 0 ||
+        zmq_getsockopt(publisher, ZMQ_LAST_ENDPOINT, endpoint, &endpoint_size) != 0) {
+        zmq_close(publisher);
+        zmq_ctx_term(context);
+        return {name, 0, 0, 0, 0, 0};
+    }
+    
+    quaxis::ZmqConfig config;
+    config.enabled = true;
+    config.endpoint = endpoint;
+    quaxis::bitcoin::ZmqSubscriber subscriber(config);
+    CallbackProbe probe;
+    subscriber.set_callback(probe.callback());
+    
+    using Clock = std::chrono::steady_clock;
+    std::vector<double> latencies;
+    latencies.reserve(iterations);
+    
+    auto send = [&](uint32_t height, uint32_t seq) {
+        auto block = make_rawblock(height, block_size);
+        auto start = Clock::now();
+        zmq_send(publisher, "rawblock", 8, ZMQ_SNDMORE);
+        zmq_send(publisher, block.data(), block.size(), ZMQ_SNDMORE);
+        zmq_send(publisher, &seq, sizeof(seq), 0);
+        return start;
+    };
+    
+    if (subscriber.start()) {
+        // Подписка SUB устанавливается асинхронно
+        uint32_t warmup = 0;
+        while (probe.height.load(std::memory_order_acquire) == 0 && warmup < 500) {
+            send(1, warmup++);
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        
+        for (int i = 0; i < iterations; ++i) {
+            std::this_thread::sleep_for(std::chrono::microseconds(500));
+            
+            const auto height = static_cast<uint32_t>(i + 2);
+            auto start = send(height, warmup + static_cast<uint32_t>(i));
+            if (!probe.wait_height(height)) {
+                continue;
+            }
+            latencies.push_back(static_cast<double>(
+                probe.seen_at_ns.load(std::memory_order_relaxed) - start.time_since_epoch().count()));
+        }
+        subscriber.stop();
+    }
+    
+    zmq_close(publisher);
+    zmq_ctx_term(context);
+    if (latencies.empty()) {
+        return {name, 0, 0, 0, 0, 0};
+    }
+    return calculate_stats(name, latencies);
+}
+
+#endif // QUAXIS_HAS_ZMQ
+
+// =============================================================================
+// Размещение: NUMA узлы и CPU
+// =============================================================================
+
+/**
+ * @brief Две стороны ping-pong на разных cache line
+ */
+struct PingPongBlock {
+    alignas(64) std::atomic<uint64_t> ping{0};
+    alignas(64) std::atomic<uint64_t> pong{0};
+};
+
+/**
+ * @brief Ping-pong между потоками на cpu_a и cpu_b через сегмент
+ * 
+ * @param placement Где создать сегмент (hugetlbfs, NUMA узел)
+ * @return Половина round-trip, нс
+ */
+BenchmarkResult benchmark_ping_pong(
+    const std::string& name,
+    const quaxis::shm::SegmentPlacement& placement,
+    int cpu_a,
+    int cpu_b,
+    int iterations
+) {
+    const char* shm_name = "/quaxis_benchmark_placement";
+    BenchmarkResult failed{name, 0, 0, 0, 0, 0};
+    
+    auto fd = quaxis::shm::open_segment(placement, shm_name, O_RDWR | O_CREAT, 0666);
+    if (!fd) {
+        std::cerr << fd.error().message << std::endl;
+        return failed;
+    }
+    const std::size_t length = quaxis::shm::segment_map_length(*fd, sizeof(PingPongBlock));
+    if (ftruncate(*fd, static_cast<off_t>(length)) < 0) {
+        close(*fd);
+        (void)quaxis::shm::unlink_segment(placement, shm_name);
+        return failed;
+    }
+    void* ptr = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, *fd, 0);
+    if (ptr == MAP_FAILED) {
+        close(*fd);
+        (void)quaxis::shm::unlink_segment(placement, shm_name);
+        return failed;
+    }
+    if (placement.numa_node >= 0) {
+        auto bound = quaxis::shm::bind_to_numa_node(ptr, length, placement.numa_node);
+        if (!bound) {
+            std::cerr << bound.error().message << std::endl;
+        }
+    }
+    auto* block = new (ptr) PingPongBlock();
+    
+    std::vector<double> latencies;
+    latencies.reserve(iterations);
+    
+    std::thread responder([&]() {
+        (void)quaxis::shm::pin_current_thread_to_cpu(cpu_b);
+        for (uint64_t i = 1; i <= static_cast<uint64_t>(iterations) + 100; ++i) {
+            while (block->ping.load(std::memory_order_acquire) != i) {
+                quaxis::shm::cpu_pause();
+            }
+            block->pong.store(i, std::memory_order_release);
+        }
+    });
+    
+    std::thread initiator([&]() {
+        (void)quaxis::shm::pin_current_thread_to_cpu(cpu_a);
+        for (uint64_t i = 1; i <= static_cast<uint64_t>(iterations) + 100; ++i) {
+            auto start = std::chrono::steady_clock::now();
+            block->ping.store(i, std::memory_order_release);
+            while (block->pong.load(std::memory_order_acquire) != i) {
+                quaxis::shm::cpu_pause();
+            }
+            auto end = std::chrono::steady_clock::now();
+            if (i > 100) {  // первые 100 - прогрев
+                latencies.push_back(
+                    std::chrono::duration<double, std::nano>(end - start).count() / 2.0);
+            }
+        }
+    });
+    
+    initiator.join();
+    responder.join();
+    
+    munmap(ptr, length);
+    close(*fd);
+    (void)quaxis::shm::unlink_segment(placement, shm_name);
+    
+    return calculate_stats(name, latencies);
+}
+
+/**
+ * @brief Латентность по раскладкам: один узел, разные узлы
+ */
+void run_placement_benchmarks(const std::string& hugetlb_dir, int iterations) {
+    auto nodes = quaxis::shm::numa_nodes();
+    std::cout << "NUMA узлов: " << nodes.size()
+              << ", сегмент: " << (hugetlb_dir.empty() ? "/dev/shm" : hugetlb_dir) << std::endl;
+    std::cout << std::endl;
+    
+    auto first_cpus = quaxis::shm::numa_node_cpus(nodes.front());
+    if (first_cpus.size() < 2) {
+        std::cout << "Нужно минимум 2 CPU на узле " << nodes.front() << std::endl;
+        return;
+    }
+    
+    quaxis::shm::SegmentPlacement placement;
+    placement.hugetlb_dir = hugetlb_dir;
+    
+    std::cout << "Результаты:" << std::endl;
+    print_result(benchmark_ping_pong("default policy", placement,
+                                     first_cpus[0], first_cpus[1], iterations));
+    
+    placement.numa_node = nodes.front();
+    print_result(benchmark_ping_pong("same node", placement,
+                                     first_cpus[0], first_cpus[1], iterations));
+    
+    if (nodes.size() < 2) {
+        std::cout << "  Один NUMA узел: межузловые раскладки пропущены" << std::endl;
+        return;
+    }
+    auto second_cpus = quaxis::shm::numa_node_cpus(nodes[1]);
+    if (second_cpus.empty()) {
+        return;
+    }
+    
+    // Память на узле писателя, читатель на другом узле
+    print_result(benchmark_ping_pong("cross node", placement,
+                                     first_cpus[0], second_cpus[0], iterations));
+    
+    // Память на чужом узле для обоих потоков
+    placement.numa_node = nodes[1];
+    print_result(benchmark_ping_pong("remote memory", placement,
+                                     first_cpus[0], first_cpus[1], iterations));
+}
+
 } // namespace quaxis::benchmark
 
-int main() {
+int main(int argc, char** argv) {
     using namespace quaxis::benchmark;
     
+    if (argc >= 2 && std::string(argv[1]) == "--placement") {
+        std::cout << "=== Бенчмарк размещения Shared Memory ===" << std::endl;
+        run_placement_benchmarks(argc >= 3 ? argv[2] : "", 100000);
+        return 0;
+    }
+    
     std::cout << "=== Бенчмарк Shared Memory vs ZMQ ===" << std::endl;
     std::cout << std::endl;
     
@@ -301,15 +949,33 @@ int main() {
     print_result(benchmark_poll(iterations, 10));   // 10 мкс
     print_result(benchmark_poll(iterations, 100));  // 100 мкс
     
+    // Spin + futex
+    double futex_cpu = 0.0;
+    print_result(benchmark_futex(iterations, futex_cpu));
+    std::cout << "  " << std::setw(20) << "SHM futex" << ": CPU читателя "
+              << std::setprecision(2) << futex_cpu << "% ядра" << std::endl;
+    
+    // Издатель узла через C ABI
+    print_result(benchmark_publisher_ring(iterations, false));
+    print_result(benchmark_publisher_ring(iterations, true));
+    print_result(benchmark_publisher_template(iterations));
+    
+    // Подписчики целиком: до NewBlockCallback
+    print_result(benchmark_shm_subscriber(iterations));
+#ifdef QUAXIS_HAS_ZMQ
+    print_result(benchmark_zmq_subscriber(iterations, 1000));
+    print_result(benchmark_zmq_subscriber(iterations, 1'500'000));
+#else
     std::cout << std::endl;
-    std::cout << "Примечание: ZMQ бенчмарк требует установленной библиотеки libzmq" << std::endl;
-    std::cout << "Типичная латентность ZMQ: 1-3 мс" << std::endl;
+    std::cout << "Примечание: ZMQ бенчмарк требует сборки с libzmq" << std::endl;
+#endif
     std::cout << std::endl;
     
     std::cout << "Выводы:" << std::endl;
     std::cout << "  - Spin-wait даёт минимальную латентность (~100 нс)" << std::endl;
     std::cout << "  - Poll с интервалом 1 мкс даёт ~1-2 мкс латентность" << std::endl;
-    std::cout << "  - ZMQ даёт 1-3 мс латентность (10000x больше)" << std::endl;
+    std::cout << "  - Futex даёт единицы мкс при ~0% CPU в простое" << std::endl;
+    std::cout << "  - ZMQ: доставка rawblock по TCP и разбор растут с размером блока" << std::endl;
     
     return 0;
 }
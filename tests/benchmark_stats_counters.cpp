@@ -0,0 +1,236 @@
+/**
+ * @file benchmark_stats_counters.cpp
+ * @brief Бенчмарк статистики соединений под нагрузкой 1000 ASIC
+ *
+ * Синтетическая ферма из 1000 соединений:
+ * - I/O потоки (как reactor'ы) делят соединения и на каждый "recv"
+ *   добавляют bytes_received, на каждый 16-й - share
+ * - Поток рассылки обходит все соединения: jobs_sent + bytes_sent
+ * - Репортёр раз в миллисекунду снимает статистику всех соединений
+ *
+ * Сравниваются две схемы статистики соединения:
+ * 1. mutex + структура (как было до lock-free счётчиков)
+ * 2. relaxed атомики, приём и отправка на разных cache line (как
+ *    AsicConnection::Impl), итог shares - ShardedCounter
+ *
+ * Выводятся обновлений в секунду и средняя длительность снимка фермы.
+ */
+
+#include <iostream>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <mutex>
+#include <memory>
+#include <iomanip>
+
+#include "core/stats_counter.hpp"
+
+namespace quaxis::benchmark {
+
+using Clock = std::chrono::steady_clock;
+
+/// @brief Размер фермы
+constexpr std::size_t CONNECTIONS = 1000;
+
+/// @brief Длительность прогона
+constexpr auto RUN_TIME = std::chrono::milliseconds(500);
+
+/// @brief Результат снимков, чтобы компилятор их не выбросил
+volatile uint64_t g_sink = 0;
+
+/**
+ * @brief Снимок статистики соединения
+ */
+struct Snapshot {
+    uint64_t bytes_received = 0;
+    uint64_t bytes_sent = 0;
+    uint64_t shares = 0;
+    uint64_t jobs = 0;
+};
+
+/**
+ * @brief Схема до изменений: mutex на каждое обновление
+ */
+class MutexStats {
+public:
+    void on_recv(uint64_t bytes, bool share) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.bytes_received += bytes;
+        if (share) {
+            stats_.shares++;
+        }
+    }
+
+    void on_job(uint64_t bytes) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.jobs++;
+        stats_.bytes_sent += bytes;
+    }
+
+    Snapshot snapshot() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return stats_;
+    }
+
+private:
+    mutable std::mutex mutex_;
+    Snapshot stats_;
+};
+
+/**
+ * @brief Lock-free схема (раскладка AsicConnection::Impl)
+ */
+class AtomicStats {
+public:
+    void on_recv(uint64_t bytes, bool share) {
+        recv_.bytes_received.add(bytes);
+        if (share) {
+            recv_.shares.add();
+        }
+    }
+
+    void on_job(uint64_t bytes) {
+        send_.jobs.add();
+        send_.bytes_sent.add(bytes);
+    }
+
+    Snapshot snapshot() const {
+        return {recv_.bytes_received.load(), send_.bytes_sent.load(),
+                recv_.shares.load(), send_.jobs.load()};
+    }
+
+private:
+    struct alignas(core::CACHE_LINE_SIZE) Recv {
+        core::RelaxedCounter bytes_received;
+        core::RelaxedCounter shares;
+    };
+    struct alignas(core::CACHE_LINE_SIZE) Send {
+        core::RelaxedCounter bytes_sent;
+        core::RelaxedCounter jobs;
+    };
+
+    Recv recv_;
+    Send send_;
+};
+
+/**
+ * @brief Итог сервера по shares (общий для всех I/O потоков)
+ */
+struct MutexTotal {
+    void add() {
+        std::lock_guard<std::mutex> lock(mutex);
+        ++value;
+    }
+    std::mutex mutex;
+    uint64_t value = 0;
+};
+
+struct ShardedTotal {
+    void add() { value.add(); }
+    core::ShardedCounter<> value;
+};
+
+struct Result {
+    double updates_per_sec = 0.0;
+    double snapshot_us = 0.0;
+};
+
+/**
+ * @brief Прогон фермы: io_threads потоков приёма, рассылка, репортёр
+ */
+template<typename Stats, typename Total>
+Result run_farm(int io_threads) {
+    std::vector<std::unique_ptr<Stats>> farm;
+    farm.reserve(CONNECTIONS);
+    for (std::size_t i = 0; i < CONNECTIONS; ++i) {
+        farm.push_back(std::make_unique<Stats>());
+    }
+    Total total_shares;
+
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> updates{0};
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < io_threads; ++t) {
+        threads.emplace_back([&, t] {
+            uint64_t local = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                for (std::size_t i = static_cast<std::size_t>(t); i < CONNECTIONS;
+                     i += static_cast<std::size_t>(io_threads)) {
+                    bool share = (local & 15) == 0;
+                    farm[i]->on_recv(48, share);
+                    if (share) {
+                        total_shares.add();
+                    }
+                    ++local;
+                }
+            }
+            updates.fetch_add(local, std::memory_order_relaxed);
+        });
+    }
+
+    threads.emplace_back([&] {
+        uint64_t local = 0;
+        while (!stop.load(std::memory_order_relaxed)) {
+            for (auto& conn : farm) {
+                conn->on_job(56);
+                ++local;
+            }
+        }
+        updates.fetch_add(local, std::memory_order_relaxed);
+    });
+
+    uint64_t snapshots = 0;
+    Clock::duration snapshot_time{};
+    uint64_t checksum = 0;
+    auto start = Clock::now();
+    while (Clock::now() - start < RUN_TIME) {
+        auto t0 = Clock::now();
+        for (const auto& conn : farm) {
+            checksum += conn->snapshot().bytes_received;
+        }
+        snapshot_time += Clock::now() - t0;
+        ++snapshots;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    stop.store(true);
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    Result result;
+    result.updates_per_sec = static_cast<double>(updates.load()) / seconds;
+    result.snapshot_us = std::chrono::duration<double, std::micro>(snapshot_time).count() /
+                         static_cast<double>(snapshots == 0 ? 1 : snapshots);
+    g_sink = checksum;
+    return result;
+}
+
+void print_row(const char* name, int threads, const Result& result) {
+    std::cout << "  " << std::setw(16) << name
+              << " io_threads=" << std::setw(2) << threads
+              << "  обновлений/с=" << std::setw(12) << std::fixed << std::setprecision(0) << result.updates_per_sec
+              << "  снимок " << CONNECTIONS << " соединений=" << std::setw(8) << std::setprecision(1)
+              << result.snapshot_us << " мкс"
+              << std::endl;
+}
+
+} // namespace quaxis::benchmark
+
+int main() {
+    using namespace quaxis::benchmark;
+
+    std::cout << "=== Бенчмарк статистики соединений (" << CONNECTIONS << " ASIC) ===" << std::endl;
+    std::cout << std::endl;
+
+    for (int threads : {1, 2, 4, 8}) {
+        print_row("relaxed атомики", threads, run_farm<AtomicStats, ShardedTotal>(threads));
+        print_row("mutex", threads, run_farm<MutexStats, MutexTotal>(threads));
+    }
+
+    return 0;
+}
@@ -0,0 +1,325 @@
+/**
+ * @file benchmark_stratum_submit.cpp
+ * @brief Бенчмарк mining.submit и приёма строк Stratum V1
+ *
+ * На fallback пуле с низкой сложностью share идут сотнями в секунду,
+ * и каждый - это строка mining.submit и строка ответа. Измеряются:
+ * 1. Кодирование submit: ostringstream + json + "\n" (схема до шаблона)
+ *    против SubmitEncoder
+ * 2. Разбор ответов из recv кусками по 1448 байт: std::string с append и
+ *    erase против LineReader
+ * 3. StratumClient::submit целиком через локальный пул на loopback
+ *
+ * Для каждого варианта - операций в секунду и аллокаций на операцию
+ * (счётчик в глобальном operator new).
+ */
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "fallback/stratum_client.hpp"
+#include "fallback/stratum_wire.hpp"
+
+namespace {
+
+std::atomic<uint64_t> g_allocations{0};
+
+} // anonymous namespace
+
+void* operator new(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+namespace quaxis::benchmark {
+
+using Clock = std::chrono::steady_clock;
+
+/// @brief Операций в микро-бенчмарках
+constexpr uint64_t ITERATIONS = 1'000'000;
+
+/// @brief Share через StratumClient
+constexpr uint64_t CLIENT_SUBMITS = 200'000;
+
+/// @brief Размер куска, который отдаёт recv (MSS Ethernet)
+constexpr std::size_t RECV_CHUNK = 1448;
+
+/// @brief Типичный ответ пула на share
+constexpr std::string_view RESPONSE = R"({"id":123456,"result":true,"error":null})" "\n";
+
+const char HEX[] = "0123456789abcdef";
+
+/// @brief 8 hex символов счётчика (как nonce от ASIC)
+void to_hex8(uint32_t value, char* out) {
+    for (int i = 7; i >= 0; --i) {
+        out[i] = HEX[value & 0xF];
+        value >>= 4;
+    }
+}
+
+struct Result {
+    double per_sec;
+    double allocs_per_op;
+};
+
+void print_row(const char* name, const char* unit, Result result) {
+    std::cout << "  " << std::setw(26) << std::left << name << std::right
+              << std::setw(14) << std::fixed << std::setprecision(0) << result.per_sec << " " << unit
+              << "  аллокаций/оп=" << std::setprecision(2) << result.allocs_per_op
+              << std::endl;
+}
+
+template<typename Body>
+Result measure(uint64_t iterations, Body&& body) {
+    uint64_t allocs_before = g_allocations.load();
+    auto start = Clock::now();
+    for (uint64_t i = 0; i < iterations; ++i) {
+        body(i);
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    uint64_t allocs = g_allocations.load() - allocs_before;
+    return {static_cast<double>(iterations) / seconds,
+            static_cast<double>(allocs) / static_cast<double>(iterations)};
+}
+
+// =============================================================================
+// 1. Кодирование submit
+// =============================================================================
+
+void bench_encode() {
+    const std::string user = "bc1qexampleworkeraddress.rig01";
+    const std::string job_id = "6a3f";
+    const std::string ntime = "65a1b2c3";
+    std::string extranonce2 = "00000000";
+    std::string nonce = "00000000";
+    std::size_t sink = 0;
+
+    auto legacy = measure(ITERATIONS, [&](uint64_t i) {
+        to_hex8(static_cast<uint32_t>(i), nonce.data());
+        std::ostringstream ss;
+        ss << R"({"id":)" << i << R"(,"method":"mining.submit","params":[")"
+           << user << R"(",")" << job_id << R"(",")"
+           << extranonce2 << R"(",")" << ntime << R"(",")" << nonce << R"("]})";
+        std::string json = ss.str();
+        std::string line = json + "\n";
+        sink += line.size();
+    });
+
+    fallback::SubmitEncoder encoder;
+    auto encoded = measure(ITERATIONS, [&](uint64_t i) {
+        to_hex8(static_cast<uint32_t>(i), nonce.data());
+        sink += encoder.encode(i, user, job_id, extranonce2, ntime, nonce).size();
+    });
+
+    std::cout << "Кодирование mining.submit:" << std::endl;
+    print_row("ostringstream + \"\\n\"", "submit/с", legacy);
+    print_row("SubmitEncoder", "submit/с", encoded);
+    std::cout << "  (" << sink % 10 << ")" << std::endl << std::endl;
+}
+
+// =============================================================================
+// 2. Разбор строк
+// =============================================================================
+
+void bench_lines() {
+    std::string stream;
+    while (stream.size() < 1024 * 1024) {
+        stream += RESPONSE;
+    }
+    const uint64_t lines = stream.size() / RESPONSE.size();
+    const uint64_t chunks = (stream.size() + RECV_CHUNK - 1) / RECV_CHUNK;
+    std::size_t sink = 0;
+
+    auto chunk_at = [&](uint64_t i) {
+        std::size_t offset = static_cast<std::size_t>(i) * RECV_CHUNK;
+        return std::string_view(stream).substr(offset, RECV_CHUNK);
+    };
+
+    // Прежний read_loop: recv в стековый массив, '\0' и append C-строки
+    std::string buffer;
+    char recv_buffer[4096];
+    auto legacy = measure(chunks, [&](uint64_t i) {
+        auto chunk = chunk_at(i);
+        std::memcpy(recv_buffer, chunk.data(), chunk.size());
+        recv_buffer[chunk.size()] = '\0';
+        buffer += recv_buffer;
+        std::string_view pending(buffer);
+        std::size_t consumed = 0;
+        std::size_t pos;
+        while ((pos = pending.find('\n', consumed)) != std::string_view::npos) {
+            sink += pos - consumed;
+            consumed = pos + 1;
+        }
+        buffer.erase(0, consumed);
+    });
+
+    fallback::LineReader reader;
+    auto in_place = measure(chunks, [&](uint64_t i) {
+        auto chunk = chunk_at(i);
+        auto space = reader.writable();
+        std::memcpy(space.data(), chunk.data(), chunk.size());
+        reader.commit(chunk.size());
+        while (auto line = reader.next_line()) {
+            sink += line->size();
+        }
+    });
+
+    // В строки/с: один прогон - lines строк
+    double scale = static_cast<double>(lines) / static_cast<double>(chunks);
+    legacy.per_sec *= scale;
+    in_place.per_sec *= scale;
+    legacy.allocs_per_op /= scale;
+    in_place.allocs_per_op /= scale;
+
+    std::cout << "Разбор ответов (куски по " << RECV_CHUNK << " байт):" << std::endl;
+    print_row("std::string append/erase", "строк/с", legacy);
+    print_row("LineReader", "строк/с", in_place);
+    std::cout << "  (" << sink % 10 << ")" << std::endl << std::endl;
+}
+
+// =============================================================================
+// 3. StratumClient через loopback
+// =============================================================================
+
+/**
+ * @brief Пул на localhost: рукопожатие и ответ на каждую строку
+ */
+class SinkPool {
+public:
+    SinkPool() {
+        listen_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        ::bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+        ::listen(listen_fd_, 1);
+        socklen_t len = sizeof(addr);
+        ::getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &len);
+        port_ = ntohs(addr.sin_port);
+        thread_ = std::thread([this] { serve(); });
+    }
+
+    ~SinkPool() {
+        if (client_ >= 0) ::shutdown(client_, SHUT_RDWR);
+        ::shutdown(listen_fd_, SHUT_RDWR);
+        thread_.join();
+        if (client_ >= 0) ::close(client_);
+        ::close(listen_fd_);
+    }
+
+    [[nodiscard]] uint16_t port() const noexcept { return port_; }
+    [[nodiscard]] uint64_t received() const noexcept { return received_.load(); }
+
+private:
+    void reply(std::string_view text) {
+        (void)::send(client_, text.data(), text.size(), MSG_NOSIGNAL);
+    }
+
+    void serve() {
+        client_ = ::accept(listen_fd_, nullptr, nullptr);
+        if (client_ < 0) return;
+
+        char buffer[64 * 1024];
+        std::string replies;
+        uint64_t lines = 0;
+        while (true) {
+            ssize_t n = ::recv(client_, buffer, sizeof(buffer), 0);
+            if (n <= 0) return;
+
+            replies.clear();
+            for (ssize_t i = 0; i < n; ++i) {
+                if (buffer[i] != '\n') continue;
+                if (lines == 0) {
+                    replies += R"({"id":1,"result":[[["mining.notify","s"]],"f000000a",4],"error":null})" "\n";
+                } else if (lines == 1) {
+                    replies += R"({"id":2,"result":true,"error":null})" "\n";
+                } else {
+                    replies += RESPONSE;
+                }
+                lines++;
+            }
+            received_.store(lines > 2 ? lines - 2 : 0);
+            reply(replies);
+        }
+    }
+
+    int listen_fd_ = -1;
+    int client_ = -1;
+    uint16_t port_ = 0;
+    std::atomic<uint64_t> received_{0};
+    std::thread thread_;
+};
+
+void bench_client() {
+    SinkPool pool;
+
+    fallback::StratumPoolConfig config;
+    config.host = "127.0.0.1";
+    config.port = pool.port();
+    config.user = "bc1qexampleworkeraddress.rig01";
+    fallback::StratumClient client(config);
+    if (!client.connect()) {
+        std::cout << "StratumClient: не удалось подключиться к локальному пулу" << std::endl;
+        return;
+    }
+
+    const std::string job_id = "6a3f";
+    const std::string extranonce2 = "00000000";
+    const std::string ntime = "65a1b2c3";
+    std::string nonce = "00000000";
+
+    auto result = measure(CLIENT_SUBMITS, [&](uint64_t i) {
+        to_hex8(static_cast<uint32_t>(i), nonce.data());
+        (void)client.submit(job_id, extranonce2, ntime, nonce);
+    });
+
+    auto deadline = Clock::now() + std::chrono::seconds(10);
+    while (pool.received() < CLIENT_SUBMITS && Clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    std::cout << "StratumClient::submit через loopback (с ответами пула):" << std::endl;
+    print_row("StratumClient", "submit/с", result);
+    std::cout << "  пул получил " << pool.received() << " из " << CLIENT_SUBMITS << std::endl;
+
+    client.disconnect();
+}
+
+} // namespace quaxis::benchmark
+
+int main() {
+    using namespace quaxis::benchmark;
+
+    std::cout << "=== Бенчмарк mining.submit (Stratum V1) ===" << std::endl;
+    std::cout << std::endl;
+
+    bench_encode();
+    bench_lines();
+    bench_client();
+
+    return 0;
+}
@@ -0,0 +1,71 @@
+/**
+ * @file benchmark_suite.cpp
+ * @brief Набор микробенчмарков горячих примитивов (Google Benchmark)
+ *
+ * Один исполняемый файл quaxis_benchmarks вместо отдельных программ с
+ * собственным выводом: результаты в JSON сравниваются между коммитами.
+ *
+ * - benchmark_suite_crypto.cpp: SHA256 / SHA256d, заголовок с midstate
+ *   по реализациям, пакетное хеширование, MerkleTree, AuxPoW
+ * - benchmark_suite_relay.cpp: FibreParser::parse, FecDecoder::decode
+ * - benchmark_suite_mining.cpp: ProtocolParser, задания на соединение,
+ *   churn ExtrannonceManager
+ *
+ * ```bash
+ * ./quaxis_benchmarks --benchmark_out=bench.json --benchmark_out_format=json
+ * ./quaxis_benchmarks --sha256-impl=generic --sha256-impl=scalar
+ * ```
+ *
+ * В контекст JSON добавляются выбранные при старте реализации SHA256 и
+ * GF(2^8): без них результаты разных машин не сравнить.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <iostream>
+#include <string>
+#include <string_view>
+
+#include "crypto/sha256.hpp"
+#include "relay/gf256.hpp"
+
+int main(int argc, char** argv) {
+    using namespace quaxis;
+
+    // --sha256-impl=NAME до Initialize: Google Benchmark не знает эту опцию
+    int kept = 1;
+    for (int i = 1; i < argc; ++i) {
+        constexpr std::string_view PREFIX = "--sha256-impl=";
+        const std::string_view arg = argv[i];
+        if (!arg.starts_with(PREFIX)) {
+            argv[kept++] = argv[i];
+            continue;
+        }
+        const auto name = arg.substr(PREFIX.size());
+        bool applied = false;
+        if (auto impl = crypto::parse_sha256_implementation(name)) {
+            applied = crypto::set_sha256_implementation(*impl);
+        } else if (auto batch = crypto::parse_sha256_batch_implementation(name)) {
+            applied = crypto::set_sha256_batch_implementation(*batch);
+        }
+        if (!applied) {
+            std::cerr << "Реализация SHA256 неизвестна или недоступна: " << name << std::endl;
+            return 1;
+        }
+    }
+    argc = kept;
+
+    ::benchmark::Initialize(&argc, argv);
+    if (::benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+
+    ::benchmark::AddCustomContext("sha256", std::string(crypto::get_implementation_name()));
+    ::benchmark::AddCustomContext("sha256_batch", std::string(crypto::get_batch_implementation_name()));
+    ::benchmark::AddCustomContext("gf256",
+        std::string(relay::gf256_implementation_name(relay::get_gf256_implementation())));
+
+    ::benchmark::RunSpecifiedBenchmarks();
+    ::benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,247 @@
+/**
+ * @file benchmark_suite_crypto.cpp
+ * @brief Микробенчмарки SHA256, дерева Меркла и AuxPoW
+ *
+ * hash_header_with_midstate замеряется каждой реализацией (generic,
+ * SHA-NI, ARMv8); реализация, которой нет на CPU, пропускается.
+ * sha256 / sha256d и пакетные функции идут реализацией, выбранной при
+ * старте (она же в контексте JSON).
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+#include "core/chain/chain_registry.hpp"
+#include "core/primitives/merkle.hpp"
+#include "core/validation/auxpow_validator.hpp"
+#include "crypto/sha256.hpp"
+
+namespace quaxis::benchmark {
+
+namespace {
+
+Bytes random_bytes(std::size_t size, uint32_t seed) {
+    std::mt19937 rng(seed);
+    Bytes data(size);
+    for (auto& byte : data) {
+        byte = static_cast<uint8_t>(rng());
+    }
+    return data;
+}
+
+std::vector<Hash256> random_hashes(std::size_t count, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::vector<Hash256> hashes(count);
+    for (auto& hash : hashes) {
+        for (auto& byte : hash) {
+            byte = static_cast<uint8_t>(rng());
+        }
+    }
+    return hashes;
+}
+
+bool implementation_available(crypto::Sha256Implementation impl) {
+    switch (impl) {
+        case crypto::Sha256Implementation::ShaNi:   return crypto::has_sha_ni_support();
+        case crypto::Sha256Implementation::ArmSha2: return crypto::has_arm_sha2_support();
+        default: return true;
+    }
+}
+
+} // anonymous namespace
+
+// =============================================================================
+// SHA256
+// =============================================================================
+
+void BM_Sha256(::benchmark::State& state) {
+    const Bytes data = random_bytes(static_cast<std::size_t>(state.range(0)), 1);
+    for (auto _ : state) {
+        auto hash = crypto::sha256(data);
+        ::benchmark::DoNotOptimize(hash);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+BENCHMARK(BM_Sha256)->Arg(32)->Arg(64)->Arg(80)->Arg(1024)->Arg(1 << 20);
+
+void BM_Sha256d(::benchmark::State& state) {
+    const Bytes data = random_bytes(static_cast<std::size_t>(state.range(0)), 2);
+    for (auto _ : state) {
+        auto hash = crypto::sha256d(data);
+        ::benchmark::DoNotOptimize(hash);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+BENCHMARK(BM_Sha256d)->Arg(64)->Arg(80)->Arg(250)->Arg(1 << 20);
+
+/**
+ * @brief SHA256d заголовка с midstate; аргумент - Sha256Implementation
+ */
+void BM_HashHeaderWithMidstate(::benchmark::State& state) {
+    const auto impl = static_cast<crypto::Sha256Implementation>(state.range(0));
+    if (!implementation_available(impl)) {
+        state.SkipWithError("реализация недоступна на этом CPU");
+        return;
+    }
+    state.SetLabel(impl == crypto::Sha256Implementation::Generic ? "generic"
+                   : impl == crypto::Sha256Implementation::ShaNi ? "sha-ni" : "arm-sha2");
+
+    const Bytes first = random_bytes(64, 3);
+    const auto midstate = crypto::compute_midstate(first.data());
+    crypto::HeaderTail tail{};
+    for (auto _ : state) {
+        auto hash = crypto::hash_header_with_midstate(midstate, tail, impl);
+        ::benchmark::DoNotOptimize(hash);
+        ++tail[12];  // Перебор nonce
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_HashHeaderWithMidstate)
+    ->Arg(static_cast<int>(crypto::Sha256Implementation::Generic))
+    ->Arg(static_cast<int>(crypto::Sha256Implementation::ShaNi))
+    ->Arg(static_cast<int>(crypto::Sha256Implementation::ArmSha2));
+
+void BM_HashHeadersBatch(::benchmark::State& state) {
+    const auto count = static_cast<std::size_t>(state.range(0));
+    std::vector<crypto::Sha256State> midstates(count);
+    std::vector<crypto::HeaderTail> tails(count);
+    std::vector<Hash256> out(count);
+    const Bytes first = random_bytes(64 * count, 4);
+    for (std::size_t i = 0; i < count; ++i) {
+        midstates[i] = crypto::compute_midstate(first.data() + 64 * i);
+        tails[i][12] = static_cast<uint8_t>(i);
+    }
+    for (auto _ : state) {
+        crypto::hash_headers_with_midstate_batch(midstates, tails, out);
+        ::benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * count));
+}
+BENCHMARK(BM_HashHeadersBatch)->Arg(8)->Arg(64)->Arg(512);
+
+void BM_Sha256d64Batch(::benchmark::State& state) {
+    const auto count = static_cast<std::size_t>(state.range(0));
+    const Bytes in = random_bytes(64 * count, 5);
+    std::vector<Hash256> out(count);
+    for (auto _ : state) {
+        crypto::sha256d64_batch(in, out);
+        ::benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * count));
+}
+BENCHMARK(BM_Sha256d64Batch)->Arg(8)->Arg(64)->Arg(512);
+
+// =============================================================================
+// Дерево Меркла
+// =============================================================================
+
+void BM_MerkleTreeBuild(::benchmark::State& state) {
+    const auto leaves = random_hashes(static_cast<std::size_t>(state.range(0)), 6);
+    for (auto _ : state) {
+        core::MerkleTree tree(leaves);
+        ::benchmark::DoNotOptimize(tree.root());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+BENCHMARK(BM_MerkleTreeBuild)->Arg(8)->Arg(256)->Arg(4096);
+
+void BM_MerkleRoot(::benchmark::State& state) {
+    const auto leaves = random_hashes(static_cast<std::size_t>(state.range(0)), 7);
+    for (auto _ : state) {
+        auto root = core::compute_merkle_root(leaves);
+        ::benchmark::DoNotOptimize(root);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+BENCHMARK(BM_MerkleRoot)->Arg(8)->Arg(256)->Arg(4096);
+
+// =============================================================================
+// AuxPoW
+// =============================================================================
+
+namespace {
+
+/// @brief Высота после активации AuxPoW Namecoin
+constexpr uint32_t AUXPOW_HEIGHT = 500000;
+
+/**
+ * @brief Валидный AuxPoW: coinbase branch глубины 12, aux branch 3
+ */
+core::AuxPow make_auxpow(const Hash256& aux_hash) {
+    core::AuxPow auxpow;
+    auxpow.coinbase_hash[0] = 0x5a;
+    for (std::size_t i = 0; i < 12; ++i) {
+        Hash256 hash{};
+        hash[1] = static_cast<uint8_t>(i);
+        auxpow.coinbase_branch.hashes.push_back(hash);
+    }
+    auxpow.coinbase_branch.index = 1234;
+    for (std::size_t i = 0; i < 3; ++i) {
+        Hash256 hash{};
+        hash[3] = static_cast<uint8_t>(i);
+        auxpow.aux_branch.hashes.push_back(hash);
+    }
+    auxpow.aux_branch.index = 5;
+
+    core::AuxPowCommitment commitment;
+    commitment.aux_merkle_root = auxpow.aux_branch.compute_root(aux_hash);
+    auto committed = commitment.serialize();
+    auxpow.coinbase_tx.assign(committed.begin(), committed.end());
+
+    auxpow.parent_header.version = 0x20000000;
+    auxpow.parent_header.merkle_root = auxpow.coinbase_branch.compute_root(auxpow.coinbase_hash);
+    auxpow.parent_header.bits = 0x207fffff;
+    while (!auxpow.parent_header.check_pow()) {
+        ++auxpow.parent_header.nonce;
+    }
+    return auxpow;
+}
+
+Hash256 make_aux_hash() {
+    Hash256 aux_hash{};
+    aux_hash[31] = 0x5a;
+    return aux_hash;
+}
+
+} // anonymous namespace
+
+void BM_AuxPowSerialize(::benchmark::State& state) {
+    const auto auxpow = make_auxpow(make_aux_hash());
+    for (auto _ : state) {
+        Bytes bytes = auxpow.serialize();
+        ::benchmark::DoNotOptimize(bytes.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_AuxPowSerialize);
+
+void BM_AuxPowDeserialize(::benchmark::State& state) {
+    const Bytes bytes = make_auxpow(make_aux_hash()).serialize();
+    for (auto _ : state) {
+        auto auxpow = core::AuxPow::deserialize(bytes);
+        ::benchmark::DoNotOptimize(auxpow);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * bytes.size()));
+}
+BENCHMARK(BM_AuxPowDeserialize);
+
+void BM_AuxPowValidate(::benchmark::State& state) {
+    const Hash256 aux_hash = make_aux_hash();
+    const auto auxpow = make_auxpow(aux_hash);
+    core::validation::AuxPowValidator validator(core::namecoin_params());
+    if (!validator.validate(auxpow, aux_hash, AUXPOW_HEIGHT)) {
+        state.SkipWithError("AuxPoW набора не прошёл проверку");
+        return;
+    }
+    for (auto _ : state) {
+        auto result = validator.validate(auxpow, aux_hash, AUXPOW_HEIGHT);
+        ::benchmark::DoNotOptimize(result);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_AuxPowValidate);
+
+} // namespace quaxis::benchmark
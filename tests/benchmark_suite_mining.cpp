@@ -0,0 +1,156 @@
+/**
+ * @file benchmark_suite_mining.cpp
+ * @brief Микробенчмарки протокола ASIC, заданий и extranonce
+ *
+ * Разбор share-кадров ProtocolParser, задание на соединение из общего
+ * шаблона (по одному и regenerate_all при смене блока) и churn
+ * ExtrannonceManager с нескольких потоков (переподключения ASIC).
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <numeric>
+#include <vector>
+
+#include "bitcoin/coinbase.hpp"
+#include "mining/extranonce_manager.hpp"
+#include "mining/job_manager.hpp"
+#include "network/protocol.hpp"
+
+namespace quaxis::benchmark {
+
+namespace {
+
+/// @brief Кадров в одном recv() (1024 байт / 9 байт на share)
+constexpr uint32_t SHARES_PER_CHUNK = 113;
+
+/// @brief Соединений на поток в churn
+constexpr uint32_t CONNECTIONS_PER_THREAD = 64;
+
+/**
+ * @brief JobManager с шаблоном и зарегистрированными соединениями
+ */
+struct JobFixture {
+    std::unique_ptr<mining::JobManager> manager;
+    std::vector<uint32_t> connection_ids;
+
+    explicit JobFixture(std::size_t connections) {
+        Hash160 pubkey_hash{};
+        pubkey_hash.fill(0x42);
+        bitcoin::CoinbaseBuilder builder(pubkey_hash);
+        auto [coinbase, midstate] = builder.build_with_midstate(800000, 625000000, 0);
+
+        bitcoin::BlockTemplate tmpl;
+        tmpl.height = 800000;
+        tmpl.header.timestamp = 1700000000;
+        tmpl.header.bits = 0x1705ae3a;
+        tmpl.coinbase_tx = std::move(coinbase);
+        tmpl.coinbase_midstate = midstate;
+        tmpl.update_extranonce(0);
+
+        manager = std::make_unique<mining::JobManager>(MiningConfig{}, builder);
+        manager->on_new_block(tmpl);
+        connection_ids.resize(connections);
+        std::iota(connection_ids.begin(), connection_ids.end(), 1u);
+        for (uint32_t id : connection_ids) {
+            (void)manager->register_connection(id);
+        }
+    }
+};
+
+} // anonymous namespace
+
+// =============================================================================
+// ProtocolParser
+// =============================================================================
+
+void BM_ProtocolParserShares(::benchmark::State& state) {
+    Bytes chunk;
+    for (uint32_t i = 0; i < SHARES_PER_CHUNK; ++i) {
+        auto frame = network::ShareMessage{mining::Share{i, i * 3}}.serialize();
+        chunk.insert(chunk.end(), frame.begin(), frame.end());
+    }
+    network::ProtocolParser parser;
+    int64_t frames = 0;
+    for (auto _ : state) {
+        parser.add_data(chunk);
+        while (auto msg = parser.try_parse()) {
+            ::benchmark::DoNotOptimize(msg);
+            ++frames;
+        }
+    }
+    state.SetItemsProcessed(frames);
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * chunk.size()));
+}
+BENCHMARK(BM_ProtocolParserShares);
+
+// =============================================================================
+// Задания
+// =============================================================================
+
+/**
+ * @brief Задание для соединения; аргумент - соединений
+ */
+void BM_JobForConnection(::benchmark::State& state) {
+    JobFixture fixture(static_cast<std::size_t>(state.range(0)));
+    std::size_t next = 0;
+    for (auto _ : state) {
+        auto job = fixture.manager->get_next_job_for_connection(fixture.connection_ids[next]);
+        ::benchmark::DoNotOptimize(job);
+        next = next + 1 == fixture.connection_ids.size() ? 0 : next + 1;
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_JobForConnection)->Arg(1)->Arg(1000);
+
+/**
+ * @brief Задания всем соединениям при смене блока; аргумент - соединений
+ */
+void BM_JobRegenerateAll(::benchmark::State& state) {
+    JobFixture fixture(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        auto jobs = fixture.manager->regenerate_all(fixture.connection_ids);
+        ::benchmark::DoNotOptimize(jobs.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+BENCHMARK(BM_JobRegenerateAll)->Arg(64)->Arg(1000)->UseRealTime();
+
+// =============================================================================
+// ExtrannonceManager
+// =============================================================================
+
+/**
+ * @brief assign / get / release с нескольких потоков, смена блока каждые 64 итерации
+ */
+void BM_ExtranonceChurn(::benchmark::State& state) {
+    static mining::ExtrannonceManager* manager = nullptr;
+    if (state.thread_index() == 0) {
+        manager = new mining::ExtrannonceManager();
+    }
+    // Цикл замера начинается и заканчивается барьером всех потоков:
+    // manager создан до первой итерации и удаляется после последней
+    const uint32_t base = static_cast<uint32_t>(state.thread_index()) * CONNECTIONS_PER_THREAD;
+    uint64_t iteration = 0;
+    for (auto _ : state) {
+        for (uint32_t i = 0; i < CONNECTIONS_PER_THREAD; ++i) {
+            ::benchmark::DoNotOptimize(manager->assign_extranonce(base + i));
+            ::benchmark::DoNotOptimize(manager->get_extranonce(base + i));
+        }
+        for (uint32_t i = 0; i < CONNECTIONS_PER_THREAD; ++i) {
+            manager->release_extranonce(base + i);
+        }
+        if (state.thread_index() == 0 && ++iteration % 64 == 0) {
+            manager->recycle_released();
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * CONNECTIONS_PER_THREAD);
+    if (state.thread_index() == 0) {
+        delete manager;
+        manager = nullptr;
+    }
+}
+BENCHMARK(BM_ExtranonceChurn)->Threads(1)->Threads(4)->Threads(8)->UseRealTime();
+
+} // namespace quaxis::benchmark
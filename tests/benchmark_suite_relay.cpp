@@ -0,0 +1,120 @@
+/**
+ * @file benchmark_suite_relay.cpp
+ * @brief Микробенчмарки разбора FIBRE и FEC декодера
+ *
+ * FecDecoder::decode замеряется отдельно от приёма чанков: reset() и
+ * add_chunk() идут при остановленном таймере. Полный путь приёма блока -
+ * в benchmark_fec.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "relay/fec_decoder.hpp"
+#include "relay/fibre_protocol.hpp"
+
+namespace quaxis::benchmark {
+
+namespace {
+
+/// @brief Размер чанка FIBRE
+constexpr std::size_t CHUNK = 1400;
+
+std::vector<uint8_t> make_datagram(const relay::FibreParser& parser, uint16_t chunk_id, bool fec,
+                                   std::size_t payload_size) {
+    relay::FibrePacket packet;
+    packet.header.magic = relay::FIBRE_MAGIC;
+    packet.header.version = relay::FIBRE_VERSION;
+    packet.header.flags = static_cast<uint8_t>(fec ? relay::FibreFlags::FecChunk : relay::FibreFlags::None);
+    packet.header.chunk_id = chunk_id;
+    packet.header.data_chunks = 100;
+    packet.header.total_chunks = 150;
+    packet.header.payload_size = static_cast<uint16_t>(payload_size);
+    packet.payload.assign(payload_size, static_cast<uint8_t>(chunk_id));
+    return parser.serialize(packet);
+}
+
+} // anonymous namespace
+
+// =============================================================================
+// FibreParser
+// =============================================================================
+
+void BM_FibreParse(::benchmark::State& state) {
+    relay::FibreParser parser;
+    const auto datagram = make_datagram(parser, 7, false, static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        auto packet = parser.parse(datagram);
+        ::benchmark::DoNotOptimize(packet);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * datagram.size()));
+}
+BENCHMARK(BM_FibreParse)->Arg(64)->Arg(CHUNK);
+
+void BM_FibreParseView(::benchmark::State& state) {
+    relay::FibreParser parser;
+    const auto datagram = make_datagram(parser, 7, false, CHUNK);
+    for (auto _ : state) {
+        auto view = parser.parse_view(datagram);
+        ::benchmark::DoNotOptimize(view);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_FibreParseView);
+
+// =============================================================================
+// FecDecoder
+// =============================================================================
+
+/**
+ * @brief Декодирование блока N = 100, M = 50; аргумент - потеряно data чанков
+ */
+void BM_FecDecode(::benchmark::State& state) {
+    const auto lost = static_cast<std::size_t>(state.range(0));
+    relay::FecParams params;
+    params.data_chunk_count = 100;
+    params.fec_chunk_count = 50;
+
+    std::mt19937 rng(2);
+    std::vector<std::vector<uint8_t>> data(100, std::vector<uint8_t>(CHUNK));
+    for (auto& chunk : data) {
+        for (auto& byte : chunk) {
+            byte = static_cast<uint8_t>(rng());
+        }
+    }
+    std::vector<ByteSpan> spans(data.begin(), data.end());
+    auto parity = relay::encode_fec_chunks(params, spans);
+    if (!parity) {
+        state.SkipWithError("encode_fec_chunks не удался");
+        return;
+    }
+    std::vector<uint16_t> order(100);
+    std::iota(order.begin(), order.end(), uint16_t{0});
+    std::shuffle(order.begin(), order.end(), rng);
+
+    relay::FecDecoder decoder(params);
+    relay::FecDecodeResult result;
+    for (auto _ : state) {
+        state.PauseTiming();
+        decoder.reset(params);
+        for (std::size_t i = lost; i < 100; ++i) {
+            decoder.add_chunk(order[i], false, data[order[i]]);
+        }
+        for (uint16_t f = 0; f < lost; ++f) {
+            decoder.add_chunk(f, true, (*parity)[f]);
+        }
+        state.ResumeTiming();
+
+        auto decoded = decoder.decode(result);
+        ::benchmark::DoNotOptimize(decoded);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * 100 * CHUNK));
+}
+BENCHMARK(BM_FecDecode)->Arg(0)->Arg(10)->Arg(50);
+
+} // namespace quaxis::benchmark
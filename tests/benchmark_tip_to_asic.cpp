@@ -0,0 +1,630 @@
+/**
+ * @file benchmark_tip_to_asic.cpp
+ * @brief Сквозной бенчмарк: объявление заголовка -> задание у ASIC
+ *
+ * Последовательность реальных заголовков проигрывается через каждый
+ * источник нового блока, и каждый этап пути до ASIC замеряется отдельно:
+ * 1. source    - байты источника -> bitcoin::BlockHeader
+ *                (SHM: публикация и чтение слота кольца;
+ *                 FIBRE: разбор датаграммы и BlockReconstructor;
+ *                 P2P: кадр cmpctblock через P2pFrameReader)
+ * 2. template  - core::TemplateGenerator (update_chain_tip + generate_template)
+ * 3. job       - JobManager::on_new_block + get_next_job
+ * 4. serialize - кадр NewJob (encode_any в буфер на стеке, как у Server)
+ * 5. write     - Server::broadcast_job -> кадр у последнего из N mock ASIC
+ * total - от начала этапа 1 до кадра у последнего ASIC.
+ *
+ * allocs - среднее число operator new за раунд на этапе (все потоки
+ * процесса; подмена глобального operator new).
+ *
+ * Для каждого этапа - p50/p99/p999 (мкс); --json пишет те же числа в
+ * файл для сравнения между сборками. Источник и конвейер работают в
+ * одном потоке: межъядерная передача SHM замеряется отдельно
+ * (benchmark_shm_vs_zmq).
+ *
+ * Запуск: benchmark_tip_to_asic [--asics N] [--rounds R]
+ *         [--headers snapshot.dat] [--json report.json]
+ * Снапшот - формат HeadersSync::save_snapshot(); без него проигрываются
+ * первые блоки mainnet.
+ */
+
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <cstring>
+#include <iomanip>
+#include <atomic>
+
+#include <sys/socket.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+#include "alloc_counter.hpp"
+#include "bitcoin/block.hpp"
+#include "bitcoin/coinbase.hpp"
+#include "bitcoin/shm_ring.hpp"
+#include "core/byte_order.hpp"
+#include "core/serialization/stream.hpp"
+#include "core/sync/headers_sync.hpp"
+#include "core/sync/p2p_peer.hpp"
+#include "core/template_generator.hpp"
+#include "mining/job_manager.hpp"
+#include "network/protocol.hpp"
+#include "network/server.hpp"
+#include "relay/block_reconstructor.hpp"
+#include "relay/fibre_protocol.hpp"
+
+namespace quaxis::benchmark {
+
+using Clock = std::chrono::steady_clock;
+
+/// @brief Блоки 0..3 mainnet (80 байт, hex)
+constexpr const char* MAINNET_HEADERS[] = {
+    "0100000000000000000000000000000000000000000000000000000000000000000000003ba3edfd7a7b12b2"
+    "7ac72c3e67768f617fc81bc3888a51323a9fb8aa4b1e5e4a29ab5f49ffff001d1dac2b7c",
+    "010000006fe28c0ab6f1b372c1a6a246ae63f74f931e8365e15a089c68d6190000000000982051fd1e4ba744"
+    "bbbe680e1fee14677ba1a3c3540bf7b1cdb606e857233e0e61bc6649ffff001d01e36299",
+    "010000004860eb18bf1b1620e37e9490fc8a427514416fd75159ab86688e9a8300000000d5fdcc541e25de1c"
+    "7a5addedf24858b8bb665c9f36ef744ee42c316022c90f9bb0bc6649ffff001d08d2bd61",
+    "01000000bddd99ccfda39da1b108ce1a5d70038d0a967bacb68b6b63065f626a0000000044f672226090d85d"
+    "b9a9f2fbfe5f0f9609b387af7be5b7fbb7a1767c831c9e995dbe6649ffff001d05e0ed6d",
+};
+
+/// @brief Награда за блок в проигрываемых шаблонах
+constexpr int64_t COINBASE_VALUE = 312'500'000;
+
+/// @brief Этапы конвейера
+enum Stage : std::size_t { SOURCE, TEMPLATE, JOB, SERIALIZE, WRITE, TOTAL, STAGE_COUNT };
+
+constexpr const char* STAGE_NAMES[STAGE_COUNT] = {
+    "source", "template", "job", "serialize", "write", "total"
+};
+
+/// @brief Заголовок из последовательности и его высота
+struct ReplayHeader {
+    std::array<uint8_t, 80> raw{};
+    uint32_t height = 0;
+};
+
+/**
+ * @brief Перцентили этапа (мкс)
+ */
+struct Percentiles {
+    double p50 = 0;
+    double p99 = 0;
+    double p999 = 0;
+};
+
+/**
+ * @brief Результат прогона одного источника
+ */
+struct SourceResult {
+    std::string source;
+    std::size_t rounds = 0;
+    std::array<Percentiles, STAGE_COUNT> stages{};
+    
+    /// @brief Аллокаций на раунд по этапам (среднее)
+    std::array<double, STAGE_COUNT> allocations{};
+};
+
+// =============================================================================
+// Последовательность заголовков
+// =============================================================================
+
+std::vector<ReplayHeader> builtin_headers() {
+    std::vector<ReplayHeader> headers;
+    uint32_t height = 0;
+    for (const char* hex : MAINNET_HEADERS) {
+        ReplayHeader header;
+        for (std::size_t i = 0; i < header.raw.size(); ++i) {
+            header.raw[i] = static_cast<uint8_t>(std::stoul(std::string(hex + i * 2, 2), nullptr, 16));
+        }
+        header.height = height++;
+        headers.push_back(header);
+    }
+    return headers;
+}
+
+std::vector<ReplayHeader> load_snapshot(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    std::vector<uint8_t> data{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+
+    using core::sync::HEADERS_SNAPSHOT_MAGIC;
+    using core::sync::HEADERS_SNAPSHOT_PREFIX;
+    if (data.size() <= HEADERS_SNAPSHOT_PREFIX ||
+        std::memcmp(data.data(), HEADERS_SNAPSHOT_MAGIC.data(), HEADERS_SNAPSHOT_MAGIC.size()) != 0) {
+        std::cerr << "Неверный снапшот заголовков: " << path << std::endl;
+        return {};
+    }
+
+    const uint32_t base = read_le32(data.data() + HEADERS_SNAPSHOT_MAGIC.size());
+    const std::size_t count = (data.size() - HEADERS_SNAPSHOT_PREFIX) / 80;
+    std::vector<ReplayHeader> headers(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        std::memcpy(headers[i].raw.data(), data.data() + HEADERS_SNAPSHOT_PREFIX + i * 80, 80);
+        headers[i].height = base + static_cast<uint32_t>(i);
+    }
+    return headers;
+}
+
+// =============================================================================
+// Источники: байты -> bitcoin::BlockHeader
+// =============================================================================
+
+/**
+ * @brief SHM: событие через кольцо (публикация + drain читателя)
+ */
+class ShmSource {
+public:
+    ShmSource() : ring_(std::make_unique<bitcoin::QuaxisSharedRing>()), writer_(*ring_), reader_(*ring_) {
+        bitcoin::init_shm_ring(*ring_);
+    }
+
+    [[nodiscard]] static const char* name() { return "shm"; }
+
+    void prepare(const ReplayHeader& header) {
+        event_ = {};
+        event_.state = bitcoin::ShmBlockState::Speculative;
+        event_.height = header.height;
+        event_.coinbase_value = COINBASE_VALUE;
+        std::memcpy(event_.header_raw, header.raw.data(), header.raw.size());
+    }
+
+    std::optional<bitcoin::BlockHeader> decode() {
+        writer_.publish(event_);
+        std::optional<bitcoin::BlockHeader> header;
+        reader_.drain([&](const bitcoin::ShmBlockEvent& event) {
+            if (auto parsed = bitcoin::BlockHeader::deserialize(ByteSpan(event.header_raw, 80))) {
+                header = *parsed;
+            }
+        });
+        return header;
+    }
+
+private:
+    std::unique_ptr<bitcoin::QuaxisSharedRing> ring_;
+    bitcoin::ShmRingWriter writer_;
+    bitcoin::ShmRingReader reader_;
+    bitcoin::ShmBlockEvent event_{};
+};
+
+/**
+ * @brief FIBRE: первый data чанк блока -> header из реконструктора
+ */
+class FibreSource {
+public:
+    FibreSource() : reconstructor_(Hash256{}, 0, fec_params()) {
+        reconstructor_.set_header_callback([this](const bitcoin::BlockHeader& header, uint32_t, const Hash256&) {
+            header_ = header;
+        });
+    }
+
+    [[nodiscard]] static const char* name() { return "fibre"; }
+
+    void prepare(const ReplayHeader& header) {
+        relay::FibrePacket packet;
+        packet.header.magic = relay::FIBRE_MAGIC;
+        packet.header.version = relay::FIBRE_VERSION;
+        packet.header.chunk_id = 0;
+        packet.header.block_height = header.height;
+        packet.header.block_hash[0] = static_cast<uint8_t>(header.height);
+        packet.header.block_hash[1] = static_cast<uint8_t>(header.height >> 8);
+        packet.header.total_chunks = fec_params().total_chunks();
+        packet.header.data_chunks = fec_params().data_chunk_count;
+        packet.header.payload_size = fec_params().chunk_size;
+        packet.payload.assign(fec_params().chunk_size, 0);
+        std::memcpy(packet.payload.data(), header.raw.data(), header.raw.size());
+        datagram_ = parser_.serialize(packet);
+        block_hash_ = packet.header.block_hash;
+        height_ = header.height;
+    }
+
+    std::optional<bitcoin::BlockHeader> decode() {
+        header_.reset();
+        auto view = parser_.parse_view(datagram_);
+        if (!view) {
+            return std::nullopt;
+        }
+        reconstructor_.reset(block_hash_, height_, fec_params(), 5000);
+        (void)reconstructor_.accept(*view);
+        return header_;
+    }
+
+private:
+    static relay::FecParams fec_params() {
+        relay::FecParams params;
+        params.data_chunk_count = 4;
+        params.fec_chunk_count = 2;
+        params.chunk_size = 1200;
+        return params;
+    }
+
+    relay::FibreParser parser_;
+    relay::BlockReconstructor reconstructor_;
+    std::vector<uint8_t> datagram_;
+    Hash256 block_hash_{};
+    uint32_t height_ = 0;
+    std::optional<bitcoin::BlockHeader> header_;
+};
+
+/**
+ * @brief P2P: кадр cmpctblock (high-bandwidth) -> header
+ */
+class P2pSource {
+public:
+    P2pSource() : reader_(MAGIC) {}
+
+    [[nodiscard]] static const char* name() { return "p2p"; }
+
+    void prepare(const ReplayHeader& header) {
+        // cmpctblock без коротких ID: header, nonce, 0 shortids, 1 prefilled (coinbase)
+        core::serialization::WriteStream payload;
+        payload.write_bytes(header.raw);
+        payload.write_u64_le(header.height);
+        payload.write_varint(0);
+        payload.write_varint(1);
+        payload.write_varint(0);
+        payload.write_bytes(Bytes(200, 0));
+        message_ = core::sync::encode_p2p_message(MAGIC, "cmpctblock", payload.data());
+    }
+
+    std::optional<bitcoin::BlockHeader> decode() {
+        reader_.feed(message_);
+        core::sync::P2pMessage message;
+        if (reader_.next(message) != core::sync::P2pFrameReader::Status::Message ||
+            message.command != "cmpctblock") {
+            return std::nullopt;
+        }
+        auto header = core::sync::parse_cmpctblock_header(message.payload);
+        if (!header) {
+            return std::nullopt;
+        }
+        auto raw = header->serialize();
+        auto parsed = bitcoin::BlockHeader::deserialize(raw);
+        return parsed ? std::optional<bitcoin::BlockHeader>(*parsed) : std::nullopt;
+    }
+
+private:
+    static constexpr core::sync::NetworkMagic MAGIC{0xf9, 0xbe, 0xb4, 0xd9};
+
+    core::sync::P2pFrameReader reader_;
+    Bytes message_;
+};
+
+// =============================================================================
+// Mock ASIC
+// =============================================================================
+
+void raise_fd_limit() {
+    struct rlimit lim;
+    if (getrlimit(RLIMIT_NOFILE, &lim) == 0) {
+        lim.rlim_cur = lim.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &lim);
+    }
+}
+
+int connect_client(uint16_t port) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return -1;
+    }
+
+    struct sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+
+    if (connect(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0) {
+        close(fd);
+        return -1;
+    }
+
+    int flags = fcntl(fd, F_GETFL, 0);
+    fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+    return fd;
+}
+
+/**
+ * @brief N соединений ASIC: ожидание кадра NewJob у всех
+ */
+class MockAsics {
+public:
+    MockAsics(network::Server& server, std::size_t count, uint16_t port) {
+        for (std::size_t i = 0; i < count; ++i) {
+            int fd = connect_client(port);
+            if (fd < 0) {
+                break;
+            }
+            clients_.push_back(fd);
+        }
+
+        auto deadline = Clock::now() + std::chrono::seconds(10);
+        while (server.connection_count() < clients_.size() && Clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+
+        epoll_fd_ = epoll_create1(0);
+        for (std::size_t i = 0; i < clients_.size(); ++i) {
+            struct epoll_event ev{};
+            ev.events = EPOLLIN | EPOLLET;
+            ev.data.u64 = (static_cast<uint64_t>(clients_[i]) << 32) | i;
+            epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, clients_[i], &ev);
+        }
+        received_.resize(clients_.size());
+    }
+
+    ~MockAsics() {
+        close(epoll_fd_);
+        for (int fd : clients_) {
+            close(fd);
+        }
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept { return clients_.size(); }
+
+    /**
+     * @brief Время, когда кадр задания получил последний ASIC
+     */
+    Clock::time_point wait_all() {
+        std::fill(received_.begin(), received_.end(), 0);
+        std::size_t done = 0;
+        std::array<struct epoll_event, 256> events;
+        std::array<uint8_t, 1024> buffer;
+        Clock::time_point last = Clock::now();
+
+        while (done < received_.size()) {
+            int n = epoll_wait(epoll_fd_, events.data(), static_cast<int>(events.size()), 1000);
+            if (n <= 0) {
+                break;
+            }
+            for (int i = 0; i < n; ++i) {
+                uint64_t key = events[i].data.u64;
+                int fd = static_cast<int>(key >> 32);
+                std::size_t slot = static_cast<std::size_t>(key & 0xFFFFFFFFu);
+                for (;;) {
+                    ssize_t r = recv(fd, buffer.data(), buffer.size(), 0);
+                    if (r <= 0) {
+                        break;
+                    }
+                    std::size_t before = received_[slot];
+                    received_[slot] += static_cast<std::size_t>(r);
+                    if (before < network::NEW_JOB_FRAME_SIZE && received_[slot] >= network::NEW_JOB_FRAME_SIZE) {
+                        last = Clock::now();
+                        ++done;
+                    }
+                }
+            }
+        }
+        return last;
+    }
+
+private:
+    std::vector<int> clients_;
+    std::vector<std::size_t> received_;
+    int epoll_fd_ = -1;
+};
+
+// =============================================================================
+// Прогон
+// =============================================================================
+
+double micros(Clock::time_point from, Clock::time_point to) {
+    return std::chrono::duration<double, std::micro>(to - from).count();
+}
+
+Percentiles percentiles(std::vector<double>& samples) {
+    Percentiles result;
+    if (samples.empty()) {
+        return result;
+    }
+    std::sort(samples.begin(), samples.end());
+    auto at = [&](std::size_t permille) {
+        return samples[std::min(samples.size() - 1, samples.size() * permille / 1000)];
+    };
+    result.p50 = at(500);
+    result.p99 = at(990);
+    result.p999 = at(999);
+    return result;
+}
+
+template<typename Source>
+SourceResult run(const std::vector<ReplayHeader>& headers, std::size_t asics, std::size_t rounds, uint16_t port) {
+    SourceResult result;
+    result.source = Source::name();
+
+    Hash160 pubkey_hash{};
+    pubkey_hash.fill(0x42);
+    mining::JobManager job_manager(MiningConfig{}, bitcoin::CoinbaseBuilder(pubkey_hash));
+    core::TemplateGenerator generator(core::TemplateGeneratorConfig{});
+
+    ServerConfig config;
+    config.bind_address = "127.0.0.1";
+    config.port = port;
+    config.max_connections = asics + 16;
+    config.worker_threads = 2;
+
+    network::Server server(config, job_manager);
+    if (auto started = server.start(); !started) {
+        std::cerr << "  Не удалось запустить сервер: " << started.error().message << std::endl;
+        return result;
+    }
+
+    std::array<std::vector<double>, STAGE_COUNT> samples;
+    std::array<uint64_t, STAGE_COUNT> alloc_totals{};
+    {
+        MockAsics clients(server, asics, port);
+        Source source;
+
+        for (std::size_t round = 0; round < rounds; ++round) {
+            // Подготовка байт источника - вне замера
+            const auto& replay = headers[round % headers.size()];
+            source.prepare(replay);
+
+            const uint64_t a0 = allocation_count();
+            auto t0 = Clock::now();
+            auto header = source.decode();
+            if (!header) {
+                std::cerr << "  " << result.source << ": заголовок не разобран" << std::endl;
+                break;
+            }
+            auto t1 = Clock::now();
+            const uint64_t a1 = allocation_count();
+
+            // Шаблон поверх нового tip
+            generator.update_chain_tip(header->hash(), replay.height + 1, header->bits, COINBASE_VALUE);
+            auto generated = generator.generate_template(round);
+            if (!generated) {
+                break;
+            }
+            bitcoin::BlockTemplate block_template;
+            block_template.height = generated->height;
+            block_template.header.version = static_cast<uint32_t>(generated->header.version);
+            block_template.header.prev_block = generated->header.prev_hash;
+            block_template.header.timestamp = generated->header.timestamp;
+            block_template.header.bits = generated->header.bits;
+            block_template.coinbase_value = generated->coinbase_value;
+            auto t2 = Clock::now();
+            const uint64_t a2 = allocation_count();
+
+            job_manager.on_new_block(block_template, true);
+            auto job = job_manager.get_next_job();
+            if (!job) {
+                break;
+            }
+            auto t3 = Clock::now();
+            const uint64_t a3 = allocation_count();
+
+            network::AnyJobFrame frame;
+            (void)network::NewJobMessage{*job}.encode_any(frame);
+            auto t4 = Clock::now();
+            const uint64_t a4 = allocation_count();
+            (void)frame;
+
+            server.broadcast_job(*job);
+            const uint64_t a5 = allocation_count();
+            auto t5 = clients.wait_all();
+
+            samples[SOURCE].push_back(micros(t0, t1));
+            samples[TEMPLATE].push_back(micros(t1, t2));
+            samples[JOB].push_back(micros(t2, t3));
+            samples[SERIALIZE].push_back(micros(t3, t4));
+            samples[WRITE].push_back(micros(t4, t5));
+            samples[TOTAL].push_back(micros(t0, t5));
+            alloc_totals[SOURCE] += a1 - a0;
+            alloc_totals[TEMPLATE] += a2 - a1;
+            alloc_totals[JOB] += a3 - a2;
+            alloc_totals[SERIALIZE] += a4 - a3;
+            alloc_totals[WRITE] += a5 - a4;
+            alloc_totals[TOTAL] += a5 - a0;
+            ++result.rounds;
+        }
+    }
+
+    for (std::size_t stage = 0; stage < STAGE_COUNT; ++stage) {
+        result.stages[stage] = percentiles(samples[stage]);
+        if (result.rounds != 0) {
+            result.allocations[stage] = static_cast<double>(alloc_totals[stage]) /
+                                        static_cast<double>(result.rounds);
+        }
+    }
+    server.stop();
+    return result;
+}
+
+void print_result(const SourceResult& r) {
+    std::cout << "  " << r.source << " (" << r.rounds << " раундов)" << std::endl;
+    for (std::size_t stage = 0; stage < STAGE_COUNT; ++stage) {
+        const auto& p = r.stages[stage];
+        std::cout << "    " << std::setw(10) << std::left << STAGE_NAMES[stage] << std::right
+                  << std::fixed << std::setprecision(2)
+                  << "  p50=" << std::setw(9) << p.p50 << " мкс"
+                  << "  p99=" << std::setw(9) << p.p99 << " мкс"
+                  << "  p999=" << std::setw(9) << p.p999 << " мкс"
+                  << "  allocs=" << std::setw(6) << r.allocations[stage]
+                  << std::endl;
+    }
+}
+
+void write_json(const std::string& path, const std::vector<SourceResult>& results,
+                std::size_t asics, std::size_t headers) {
+    std::ofstream out(path, std::ios::trunc);
+    out << std::fixed << std::setprecision(3);
+    out << "{\n  \"benchmark\": \"tip_to_asic\",\n"
+        << "  \"asics\": " << asics << ",\n"
+        << "  \"headers\": " << headers << ",\n"
+        << "  \"unit\": \"us\",\n"
+        << "  \"sources\": {\n";
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const auto& r = results[i];
+        out << "    \"" << r.source << "\": {\n      \"rounds\": " << r.rounds;
+        for (std::size_t stage = 0; stage < STAGE_COUNT; ++stage) {
+            const auto& p = r.stages[stage];
+            out << ",\n      \"" << STAGE_NAMES[stage] << "\": {\"p50\": " << p.p50
+                << ", \"p99\": " << p.p99 << ", \"p999\": " << p.p999
+                << ", \"allocs\": " << r.allocations[stage] << "}";
+        }
+        out << "\n    }" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  }\n}\n";
+}
+
+} // namespace quaxis::benchmark
+
+int main(int argc, char* argv[]) {
+    using namespace quaxis::benchmark;
+
+    std::size_t asics = 16;
+    std::size_t rounds = 2000;
+    std::string headers_path;
+    std::string json_path;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        if (arg == "--asics") {
+            asics = std::stoul(argv[i + 1]);
+        } else if (arg == "--rounds") {
+            rounds = std::stoul(argv[i + 1]);
+        } else if (arg == "--headers") {
+            headers_path = argv[i + 1];
+        } else if (arg == "--json") {
+            json_path = argv[i + 1];
+        }
+    }
+
+    auto headers = headers_path.empty() ? builtin_headers() : load_snapshot(headers_path);
+    if (headers.empty()) {
+        return 1;
+    }
+
+    raise_fd_limit();
+
+    std::cout << "=== Бенчмарк: объявление заголовка -> задание у ASIC ===" << std::endl;
+    std::cout << "  заголовков: " << headers.size() << ", ASIC: " << asics
+              << ", раундов на источник: " << rounds << std::endl;
+    std::cout << std::endl;
+
+    std::vector<SourceResult> results;
+    results.push_back(run<ShmSource>(headers, asics, rounds, 43450));
+    results.push_back(run<FibreSource>(headers, asics, rounds, 43451));
+    results.push_back(run<P2pSource>(headers, asics, rounds, 43452));
+    for (const auto& result : results) {
+        print_result(result);
+    }
+
+    if (!json_path.empty()) {
+        write_json(json_path, results, asics, headers.size());
+        std::cout << std::endl << "JSON отчёт: " << json_path << std::endl;
+    }
+
+    return 0;
+}
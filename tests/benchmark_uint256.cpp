@@ -0,0 +1,185 @@
+/**
+ * @file benchmark_uint256.cpp
+ * @brief Бенчмарк 256-битной арифметики
+ *
+ * Сравниваются две реализации на одних и тех же случайных числах:
+ * 1. Байтовая (прежнее хранение uint256 - 32 байта, сравнение с
+ *    конца по байту; сдвиг, умножение и деление - по байтам / битам)
+ * 2. core::uint256 (4 слова uint64, перенос через _addcarry_u64,
+ *    произведения 64x64 -> 128)
+ *
+ * Операции: сравнение, сдвиг, умножение, деление (как в block_work:
+ * ~target / (target + 1)). Выводятся операции в секунду.
+ */
+
+#include <iostream>
+#include <chrono>
+#include <iomanip>
+#include <random>
+#include <vector>
+
+#include "core/primitives/uint256.hpp"
+
+namespace quaxis::benchmark {
+
+using quaxis::core::uint256;
+
+using Clock = std::chrono::steady_clock;
+
+/// @brief Длительность одного прогона
+constexpr auto RUN_TIME = std::chrono::milliseconds(500);
+
+/// @brief Чисел в наборе
+constexpr std::size_t SET_SIZE = 1024;
+
+/// @brief Приёмник результатов: не даёт компилятору выбросить вычисления
+volatile uint64_t g_sink = 0;
+
+/**
+ * @brief Байтовое 256-битное число (little-endian, как прежний uint256)
+ */
+struct ByteUint256 {
+    std::array<uint8_t, 32> bytes{};
+
+    [[nodiscard]] bool less(const ByteUint256& other) const noexcept {
+        for (std::size_t i = 32; i-- > 0;) {
+            if (bytes[i] != other.bytes[i]) return bytes[i] < other.bytes[i];
+        }
+        return false;
+    }
+
+    [[nodiscard]] ByteUint256 shl(unsigned shift) const noexcept {
+        ByteUint256 result;
+        const std::size_t offset = shift / 8;
+        const unsigned bits = shift % 8;
+        for (std::size_t i = 32; i-- > offset;) {
+            unsigned value = static_cast<unsigned>(bytes[i - offset]) << bits;
+            if (bits != 0 && i > offset) value |= bytes[i - offset - 1] >> (8 - bits);
+            result.bytes[i] = static_cast<uint8_t>(value);
+        }
+        return result;
+    }
+
+    [[nodiscard]] ByteUint256 mul(const ByteUint256& other) const noexcept {
+        ByteUint256 result;
+        for (std::size_t i = 0; i < 32; ++i) {
+            uint32_t carry = 0;
+            for (std::size_t j = 0; i + j < 32; ++j) {
+                uint32_t value = result.bytes[i + j] + carry +
+                                 static_cast<uint32_t>(bytes[i]) * other.bytes[j];
+                result.bytes[i + j] = static_cast<uint8_t>(value);
+                carry = value >> 8;
+            }
+        }
+        return result;
+    }
+
+    [[nodiscard]] ByteUint256 sub(const ByteUint256& other) const noexcept {
+        ByteUint256 result;
+        int borrow = 0;
+        for (std::size_t i = 0; i < 32; ++i) {
+            int value = bytes[i] - other.bytes[i] - borrow;
+            borrow = value < 0 ? 1 : 0;
+            result.bytes[i] = static_cast<uint8_t>(value + (borrow << 8));
+        }
+        return result;
+    }
+
+    [[nodiscard]] bool bit(unsigned i) const noexcept {
+        return (bytes[i / 8] >> (i % 8)) & 1;
+    }
+
+    /// @brief Деление сдвигом-вычитанием по одному биту
+    [[nodiscard]] ByteUint256 div(const ByteUint256& divisor) const noexcept {
+        ByteUint256 quotient;
+        ByteUint256 remainder;
+        for (unsigned i = 256; i-- > 0;) {
+            remainder = remainder.shl(1);
+            remainder.bytes[0] = static_cast<uint8_t>(remainder.bytes[0] | (bit(i) ? 1 : 0));
+            if (!remainder.less(divisor)) {
+                remainder = remainder.sub(divisor);
+                quotient.bytes[i / 8] = static_cast<uint8_t>(quotient.bytes[i / 8] | (1u << (i % 8)));
+            }
+        }
+        return quotient;
+    }
+};
+
+ByteUint256 to_bytes(const uint256& value) {
+    ByteUint256 result;
+    for (std::size_t i = 0; i < 32; ++i) result.bytes[i] = value[i];
+    return result;
+}
+
+/**
+ * @brief Повторять проход по набору, пока не истечёт RUN_TIME
+ *
+ * @return double Операций в секунду
+ */
+template<typename Op>
+double run(Op op) {
+    uint64_t count = 0;
+    uint64_t sink = 0;
+    auto start = Clock::now();
+    while (Clock::now() - start < RUN_TIME) {
+        for (std::size_t i = 0; i < SET_SIZE; ++i) {
+            sink += op(i);
+        }
+        count += SET_SIZE;
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    g_sink = sink;
+    return static_cast<double>(count) / seconds;
+}
+
+void report(const char* name, double bytes, double limbs) {
+    std::cout << "  " << std::left << std::setw(10) << name << std::right
+              << "  байты=" << std::setw(12) << std::fixed << std::setprecision(0) << bytes << "/s"
+              << "  слова=" << std::setw(12) << limbs << "/s"
+              << "  x" << std::setprecision(1) << limbs / bytes
+              << std::endl;
+}
+
+} // namespace quaxis::benchmark
+
+int main() {
+    using namespace quaxis::benchmark;
+
+    std::cout << "=== Бенчмарк uint256 (байты vs слова uint64) ===" << std::endl;
+    std::cout << std::endl;
+
+    // Targets около 2^224 (как у Bitcoin) и делители для block_work
+    std::mt19937_64 rng(256);
+    std::vector<uint256> a(SET_SIZE), b(SET_SIZE);
+    std::vector<ByteUint256> a_bytes(SET_SIZE), b_bytes(SET_SIZE);
+    for (std::size_t i = 0; i < SET_SIZE; ++i) {
+        a[i] = uint256::from_limbs({rng(), rng(), rng(), rng()});
+        b[i] = uint256::from_limbs({rng(), rng(), rng(), rng() >> 32});
+        a_bytes[i] = to_bytes(a[i]);
+        b_bytes[i] = to_bytes(b[i]);
+    }
+
+    // Обе реализации должны давать одинаковый результат
+    for (std::size_t i = 0; i < SET_SIZE; ++i) {
+        if (to_bytes(a[i] * b[i]).bytes != a_bytes[i].mul(b_bytes[i]).bytes ||
+            to_bytes(a[i] / b[i]).bytes != a_bytes[i].div(b_bytes[i]).bytes) {
+            std::cerr << "ОШИБКА: реализации расходятся" << std::endl;
+            return 1;
+        }
+    }
+
+    report("compare",
+           run([&](std::size_t i) -> uint64_t { return a_bytes[i].less(b_bytes[i]); }),
+           run([&](std::size_t i) -> uint64_t { return a[i] < b[i]; }));
+    report("shift",
+           run([&](std::size_t i) -> uint64_t { return a_bytes[i].shl(static_cast<unsigned>(i % 200)).bytes[31]; }),
+           run([&](std::size_t i) -> uint64_t { return (a[i] << static_cast<unsigned>(i % 200)).limb(3); }));
+    report("multiply",
+           run([&](std::size_t i) -> uint64_t { return a_bytes[i].mul(b_bytes[i]).bytes[31]; }),
+           run([&](std::size_t i) -> uint64_t { return (a[i] * b[i]).limb(3); }));
+    report("divide",
+           run([&](std::size_t i) -> uint64_t { return a_bytes[i].div(b_bytes[i]).bytes[0]; }),
+           run([&](std::size_t i) -> uint64_t { return (a[i] / b[i]).low64(); }));
+
+    return 0;
+}
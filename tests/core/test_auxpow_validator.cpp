@@ -86,6 +86,221 @@ TEST_F(AuxPowValidatorTest, ValidateAfterActivation) {
     EXPECT_NE(result.error_message, "AuxPoW not active at this height");
 }
 
+namespace {
+
+/// @brief Валидный AuxPoW: пустые branches, commitment на aux_hash, лёгкий PoW
+AuxPow make_valid_auxpow(const Hash256& aux_hash) {
+    AuxPowCommitment commitment;
+    commitment.aux_merkle_root = aux_hash;
+    auto committed = commitment.serialize();
+    
+    AuxPow auxpow;
+    auxpow.coinbase_tx = {0x01, 0x00, 0x00, 0x00};
+    auxpow.coinbase_tx.insert(auxpow.coinbase_tx.end(), committed.begin(), committed.end());
+    auxpow.coinbase_hash[0] = 0x42;
+    auxpow.parent_header.version = 0x20000000;
+    auxpow.parent_header.merkle_root = auxpow.coinbase_hash;
+    auxpow.parent_header.bits = 0x207fffff;
+    while (!auxpow.parent_header.check_pow()) {
+        ++auxpow.parent_header.nonce;
+    }
+    return auxpow;
+}
+
+/// @brief Валидный AuxPoW с branches заданной глубины
+AuxPow make_branched_auxpow(uint8_t seed, std::size_t cb_depth, std::size_t aux_depth,
+                            const Hash256& aux_hash) {
+    AuxPow auxpow;
+    auxpow.coinbase_hash[0] = seed;
+    auxpow.coinbase_hash[31] = 0xCB;
+    for (std::size_t i = 0; i < cb_depth; ++i) {
+        Hash256 hash{};
+        hash[0] = seed;
+        hash[1] = static_cast<uint8_t>(i);
+        auxpow.coinbase_branch.hashes.push_back(hash);
+    }
+    auxpow.coinbase_branch.index = seed * 37u;
+    for (std::size_t i = 0; i < aux_depth; ++i) {
+        Hash256 hash{};
+        hash[2] = seed;
+        hash[3] = static_cast<uint8_t>(i);
+        auxpow.aux_branch.hashes.push_back(hash);
+    }
+    auxpow.aux_branch.index = seed;
+    
+    AuxPowCommitment commitment;
+    commitment.aux_merkle_root = auxpow.aux_branch.compute_root(aux_hash);
+    auto committed = commitment.serialize();
+    auxpow.coinbase_tx.assign(committed.begin(), committed.end());
+    
+    auxpow.parent_header.version = 0x20000000;
+    auxpow.parent_header.merkle_root = auxpow.coinbase_branch.compute_root(auxpow.coinbase_hash);
+    auxpow.parent_header.bits = 0x207fffff;
+    while (!auxpow.parent_header.check_pow()) {
+        ++auxpow.parent_header.nonce;
+    }
+    return auxpow;
+}
+
+} // namespace
+
+TEST_F(AuxPowValidatorTest, BatchMatchesSingleValidation) {
+    std::vector<AuxPow> auxpows;
+    std::vector<Hash256> aux_hashes;
+    for (uint8_t i = 0; i < 12; ++i) {
+        Hash256 aux_hash{};
+        aux_hash[0] = static_cast<uint8_t>(0x80 + i);
+        auxpows.push_back(make_branched_auxpow(i, i % 7, i % 4, aux_hash));
+        aux_hashes.push_back(aux_hash);
+    }
+    // Порча: coinbase branch, aux hash, commitment, PoW
+    auxpows[1].coinbase_branch.index ^= 1;
+    aux_hashes[2][5] ^= 1;
+    auxpows[3].coinbase_tx.clear();
+    auxpows[4].parent_header.bits = 0x03000001;
+    
+    std::vector<AuxPowValidationResult> results(auxpows.size());
+    std::size_t valid = validator_->validate_batch(auxpows, aux_hashes, 50000, results);
+    
+    std::size_t expected_valid = 0;
+    for (std::size_t i = 0; i < auxpows.size(); ++i) {
+        auto single = validator_->validate(auxpows[i], aux_hashes[i], 50000);
+        EXPECT_EQ(results[i].valid, single.valid) << i;
+        EXPECT_EQ(results[i].error_message, single.error_message) << i;
+        expected_valid += single.valid ? 1 : 0;
+    }
+    EXPECT_EQ(valid, expected_valid);
+    EXPECT_EQ(valid, auxpows.size() - 4);
+    
+    // То же через views
+    std::vector<Bytes> buffers;
+    std::vector<AuxPowView> views;
+    for (const auto& auxpow : auxpows) {
+        buffers.push_back(auxpow.serialize());
+    }
+    for (const auto& buffer : buffers) {
+        views.push_back(*AuxPowView::parse(buffer));
+    }
+    std::vector<AuxPowValidationResult> view_results(views.size());
+    EXPECT_EQ(validator_->validate_batch(views, aux_hashes, 50000, view_results), valid);
+    for (std::size_t i = 0; i < views.size(); ++i) {
+        EXPECT_EQ(view_results[i].error_message, results[i].error_message) << i;
+    }
+}
+
+TEST_F(AuxPowValidatorTest, BatchBeforeActivation) {
+    std::vector<AuxPow> auxpows(3);
+    std::vector<Hash256> aux_hashes(3);
+    std::vector<AuxPowValidationResult> results(3);
+    
+    EXPECT_EQ(validator_->validate_batch(auxpows, aux_hashes, 10000, results), 0u);
+    for (const auto& result : results) {
+        EXPECT_EQ(result.error_message, "AuxPoW not active at this height");
+    }
+}
+
+TEST_F(AuxPowValidatorTest, ViewMatchesOwnedValidation) {
+    Hash256 aux_hash{};
+    aux_hash[0] = 0x77;
+    AuxPow auxpow = make_valid_auxpow(aux_hash);
+    Bytes data = auxpow.serialize();
+    
+    auto view = AuxPowView::parse(data);
+    ASSERT_TRUE(view.has_value());
+    EXPECT_EQ(view->coinbase_tx.data(), data.data() + 2);
+    
+    EXPECT_TRUE(validator_->validate(auxpow, aux_hash, 50000));
+    EXPECT_TRUE(validator_->validate(*view, aux_hash, 50000));
+    EXPECT_TRUE(view->verify(aux_hash));
+    
+    Hash256 other_hash{};
+    auto owned_result = validator_->validate(auxpow, other_hash, 50000);
+    auto view_result = validator_->validate(*view, other_hash, 50000);
+    EXPECT_FALSE(view_result);
+    EXPECT_EQ(view_result.error_message, owned_result.error_message);
+}
+
+TEST_F(AuxPowValidatorTest, CachedValidationSharesParentProof) {
+    // Две chains в слотах 0 и 1 aux дерева под одной находкой родителя
+    Hash256 first_hash{};
+    first_hash[0] = 0x91;
+    AuxPow first = make_branched_auxpow(2, 6, 1, first_hash);
+    const Hash256 second_hash = first.aux_branch.hashes[0];
+    AuxPow second = first;
+    second.aux_branch.hashes = {first_hash};
+    second.aux_branch.index = first.aux_branch.index | 1;
+    
+    ParentProofCache cache;
+    EXPECT_TRUE(validator_->validate(first, first_hash, 50000, cache));
+    EXPECT_EQ(cache.misses(), 1u);
+    EXPECT_TRUE(validator_->validate(second, second_hash, 50000, cache));
+    EXPECT_EQ(cache.hits(), 1u);
+    EXPECT_EQ(cache.size(), 1u);
+    
+    // Чужой aux hash - ошибка aux branch из кеша родителя
+    Hash256 other_hash{};
+    auto cached = validator_->validate(second, other_hash, 50000, cache);
+    EXPECT_FALSE(cached);
+    EXPECT_EQ(cached.error_message, validator_->validate(second, other_hash, 50000).error_message);
+    EXPECT_EQ(cache.hits(), 2u);
+    
+    // Другой coinbase при том же заголовке - отдельная запись
+    AuxPow no_commitment = first;
+    no_commitment.coinbase_tx.clear();
+    cached = validator_->validate(no_commitment, first_hash, 50000, cache);
+    EXPECT_EQ(cached.error_message, "AuxPoW commitment not found in coinbase");
+    EXPECT_EQ(cache.misses(), 2u);
+    
+    // Порча coinbase branch и PoW - другие записи, те же ошибки, что без кеша
+    AuxPow bad_branch = first;
+    bad_branch.coinbase_branch.index ^= 1;
+    AuxPow bad_pow = first;
+    bad_pow.parent_header.bits = 0x03000001;
+    for (const auto* auxpow : {&bad_branch, &bad_pow}) {
+        for (int pass = 0; pass < 2; ++pass) {
+            cached = validator_->validate(*auxpow, first_hash, 50000, cache);
+            EXPECT_FALSE(cached);
+            EXPECT_EQ(cached.error_message, validator_->validate(*auxpow, first_hash, 50000).error_message);
+        }
+    }
+    
+    // View попадает в ту же запись, что и владеющий AuxPow
+    Bytes data = second.serialize();
+    auto view = AuxPowView::parse(data);
+    ASSERT_TRUE(view.has_value());
+    const uint64_t hits = cache.hits();
+    EXPECT_TRUE(validator_->validate(*view, second_hash, 50000, cache));
+    EXPECT_EQ(cache.hits(), hits + 1);
+    
+    EXPECT_EQ(validator_->validate(first, first_hash, 10000, cache).error_message,
+              "AuxPoW not active at this height");
+    
+    cache.clear();
+    EXPECT_EQ(cache.size(), 0u);
+}
+
+TEST_F(AuxPowValidatorTest, ParentProofCacheEvictsOldest) {
+    ParentProofCache cache(2);
+    std::vector<AuxPow> auxpows;
+    for (uint8_t seed = 1; seed <= 3; ++seed) {
+        auxpows.push_back(make_branched_auxpow(seed, 2, 0, Hash256{}));
+        cache.insert(auxpows.back(), ParentProof{});
+    }
+    EXPECT_EQ(cache.size(), 2u);
+    EXPECT_FALSE(cache.find(auxpows[0]));
+    EXPECT_TRUE(cache.find(auxpows[1]));
+    EXPECT_TRUE(cache.find(auxpows[2]));
+}
+
+TEST_F(AuxPowValidatorTest, ViewRejectsTruncatedData) {
+    Bytes data = make_valid_auxpow(Hash256{}).serialize();
+    
+    for (std::size_t len : {std::size_t{0}, std::size_t{1}, std::size_t{40}, data.size() - 1}) {
+        EXPECT_FALSE(AuxPowView::parse(ByteSpan(data).first(len)).has_value()) << len;
+    }
+    EXPECT_TRUE(AuxPowView::parse(data).has_value());
+}
+
 // =============================================================================
 // Тесты AuxPowValidationResult
 // =============================================================================
@@ -0,0 +1,240 @@
+/**
+ * @file test_block_index.cpp
+ * @brief Тесты для BlockIndex и ветвей HeadersStore
+ */
+
+#include <gtest/gtest.h>
+
+#include "core/sync/block_index.hpp"
+#include "core/sync/headers_store.hpp"
+#include "core/chain/chain_registry.hpp"
+
+#include <filesystem>
+#include <string>
+
+#include <unistd.h>
+
+namespace quaxis::core::sync::test {
+
+namespace {
+
+/// @brief Заголовок поверх prev; salt различает ветви
+BlockHeader child_of(const Hash256& prev, uint32_t salt, uint32_t bits = 0x1d00ffff) {
+    BlockHeader header;
+    header.version = 1;
+    header.prev_hash = prev;
+    header.timestamp = 1231469665 + salt * 600;
+    header.bits = bits;
+    header.nonce = salt;
+    return header;
+}
+
+/// @brief Цепь count заголовков поверх prev
+std::vector<BlockHeader> branch(Hash256 prev, std::size_t count, uint32_t salt) {
+    std::vector<BlockHeader> chain;
+    for (std::size_t i = 0; i < count; ++i) {
+        chain.push_back(child_of(prev, salt + static_cast<uint32_t>(i)));
+        prev = chain.back().hash();
+    }
+    return chain;
+}
+
+/// @brief Линейный проход по родителям (эталон для skip)
+uint32_t walk_parents(const BlockIndex& index, uint32_t node, uint32_t height) {
+    while (index.at(node).height > height) {
+        node = index.at(node).parent;
+    }
+    return node;
+}
+
+} // anonymous namespace
+
+// =============================================================================
+// Тесты BlockIndex
+// =============================================================================
+
+TEST(BlockIndexTest, SkipHeightMatchesBitcoinCore) {
+    EXPECT_EQ(BlockIndex::skip_height(0), 0u);
+    EXPECT_EQ(BlockIndex::skip_height(1), 0u);
+    EXPECT_EQ(BlockIndex::skip_height(2), 0u);
+    EXPECT_EQ(BlockIndex::skip_height(3), 1u);
+    EXPECT_EQ(BlockIndex::skip_height(4), 0u);
+    EXPECT_EQ(BlockIndex::skip_height(6), 4u);
+    EXPECT_EQ(BlockIndex::skip_height(7), 1u);
+    EXPECT_EQ(BlockIndex::skip_height(1000), 992u);
+    for (uint32_t height = 1; height < 5000; ++height) {
+        EXPECT_LT(BlockIndex::skip_height(height), height);
+    }
+}
+
+TEST(BlockIndexTest, AncestorMatchesParentWalk) {
+    const BlockHeader root = child_of(Hash256{}, 0);
+    BlockIndex index;
+    index.reset(root, root.hash(), 500);
+
+    // Основная цепь и ответвление от её середины
+    auto main = branch(root.hash(), 3000, 1);
+    for (const auto& header : main) {
+        ASSERT_TRUE(index.insert(header, header.hash()).has_value());
+    }
+    auto side = branch(main[1499].hash(), 700, 100000);
+    for (const auto& header : side) {
+        ASSERT_TRUE(index.insert(header, header.hash()).has_value());
+    }
+
+    const uint32_t main_tip = *index.find(main.back().hash());
+    const uint32_t side_tip = *index.find(side.back().hash());
+    EXPECT_EQ(index.at(main_tip).height, 3500u);
+    EXPECT_EQ(index.at(side_tip).height, 2700u);
+    for (uint32_t height = 500; height <= 3500; height += 7) {
+        EXPECT_EQ(index.ancestor(main_tip, height), walk_parents(index, main_tip, height));
+        if (height <= 2700) {
+            EXPECT_EQ(index.ancestor(side_tip, height), walk_parents(index, side_tip, height));
+        }
+    }
+    EXPECT_EQ(index.ancestor(main_tip, 499), BlockIndex::NONE);
+    EXPECT_EQ(index.ancestor(side_tip, 2701), BlockIndex::NONE);
+
+    // Развилка - main[1499] на высоте 500 + 1500
+    const uint32_t fork = index.fork_point(main_tip, side_tip);
+    EXPECT_EQ(index.at(fork).hash, main[1499].hash());
+    EXPECT_EQ(index.at(fork).height, 2000u);
+    EXPECT_EQ(index.fork_point(side_tip, *index.find(main[1200].hash())), *index.find(main[1200].hash()));
+}
+
+TEST(BlockIndexTest, BestFollowsChainwork) {
+    const BlockHeader root = child_of(Hash256{}, 0);
+    BlockIndex index;
+    index.reset(root, root.hash(), 0);
+    EXPECT_EQ(index.best(), 0u);
+
+    auto main = branch(root.hash(), 5, 1);
+    for (const auto& header : main) {
+        (void)index.insert(header, header.hash());
+    }
+    const uint32_t main_tip = *index.find(main.back().hash());
+    EXPECT_EQ(index.best(), main_tip);
+
+    // Равная работа не переключает, большая - переключает
+    auto side = branch(main[1].hash(), 3, 100);
+    for (const auto& header : side) {
+        (void)index.insert(header, header.hash());
+    }
+    EXPECT_EQ(index.best(), main_tip);
+
+    // Один блок с более сложным target перевешивает
+    auto heavy = child_of(side.back().hash(), 200, 0x1c00ffff);
+    const uint32_t heavy_node = *index.insert(heavy, heavy.hash());
+    EXPECT_EQ(index.best(), heavy_node);
+    EXPECT_GT(index.at(heavy_node).chainwork, index.at(main_tip).chainwork);
+
+    // Неизвестный родитель
+    EXPECT_FALSE(index.insert(child_of(Hash256{1}, 300), child_of(Hash256{1}, 300).hash()).has_value());
+}
+
+// =============================================================================
+// Тесты ветвей HeadersStore
+// =============================================================================
+
+TEST(HeadersStoreBranchTest, SideBranchThenReorg) {
+    HeadersStore store(bitcoin_params());
+    auto main = branch(store.get_tip_hash(), 10, 1);
+    for (const auto& header : main) {
+        EXPECT_EQ(store.accept_header(header, header.hash()).status, HeaderStatus::Extended);
+    }
+    EXPECT_EQ(store.accept_header(main[4], main[4].hash()).status, HeaderStatus::Known);
+
+    // Ответвление от высоты 5: до 10 блоков - боковая ветвь
+    auto side = branch(main[4].hash(), 6, 1000);
+    for (std::size_t i = 0; i < 5; ++i) {
+        auto accepted = store.accept_header(side[i], side[i].hash());
+        EXPECT_EQ(accepted.status, HeaderStatus::SideBranch);
+        EXPECT_EQ(accepted.height, 6 + i);
+    }
+    EXPECT_EQ(store.get_tip_hash(), main.back().hash());
+    EXPECT_FALSE(store.has_header(side[0].hash()));
+    EXPECT_EQ(store.find_fork(main.back().hash(), side[4].hash()), 5u);
+    EXPECT_EQ(store.get_ancestor(side[4].hash(), 6), side[0].hash());
+    EXPECT_EQ(store.get_ancestor(side[4].hash(), 3), main[2].hash());
+    EXPECT_FALSE(store.get_ancestor(side[4].hash(), 11).has_value());
+
+    // Шестой блок ветви: работы больше - ветвь становится активной
+    auto accepted = store.accept_header(side[5], side[5].hash());
+    ASSERT_EQ(accepted.status, HeaderStatus::Reorganized);
+    EXPECT_EQ(accepted.height, 11u);
+    EXPECT_EQ(accepted.fork_height, 5u);
+    EXPECT_EQ(accepted.disconnected, 5u);
+    ASSERT_EQ(accepted.connected.size(), 6u);
+    EXPECT_EQ(accepted.connected.front().hash(), side[0].hash());
+    EXPECT_EQ(accepted.connected.back().hash(), side[5].hash());
+
+    EXPECT_EQ(store.get_tip_height(), 11u);
+    EXPECT_EQ(store.get_tip_hash(), side[5].hash());
+    EXPECT_EQ(store.get_height(side[0].hash()), 6u);
+    EXPECT_EQ(*store.get_hash(5), main[4].hash());
+    EXPECT_FALSE(store.has_header(main[5].hash()));
+
+    // Прежняя цепь осталась ветвью; продление её не переключает обратно
+    auto back = child_of(main.back().hash(), 5000);
+    EXPECT_EQ(store.accept_header(back, back.hash()).status, HeaderStatus::SideBranch);
+    EXPECT_EQ(store.get_tip_hash(), side[5].hash());
+    EXPECT_EQ(store.find_fork(back.hash(), side[5].hash()), 5u);
+
+    // Неизвестный родитель
+    auto orphan = child_of(Hash256{7}, 1);
+    EXPECT_EQ(store.accept_header(orphan, orphan.hash()).status, HeaderStatus::Rejected);
+}
+
+TEST(HeadersStoreBranchTest, ReorgRewritesFile) {
+    const auto path = std::filesystem::temp_directory_path() /
+                      ("quaxis_branches_" + std::to_string(getpid()) + ".dat");
+    std::filesystem::remove(path);
+    std::vector<BlockHeader> side;
+    {
+        HeadersStore store(bitcoin_params());
+        ASSERT_TRUE(store.open(path.string()));
+        auto main = branch(store.get_tip_hash(), 300, 1);
+        for (const auto& header : main) {
+            ASSERT_EQ(store.accept_header(header, header.hash()).status, HeaderStatus::Extended);
+        }
+        side = branch(main[199].hash(), 101, 10000);
+        for (const auto& header : side) {
+            (void)store.accept_header(header, header.hash());
+        }
+        EXPECT_EQ(store.get_tip_hash(), side.back().hash());
+        EXPECT_EQ(store.get_tip_height(), 301u);
+    }
+    EXPECT_EQ(std::filesystem::file_size(path), 302 * BLOCK_HEADER_SIZE);
+
+    HeadersStore store(bitcoin_params());
+    ASSERT_TRUE(store.open(path.string()));
+    EXPECT_EQ(store.get_tip_height(), 301u);
+    EXPECT_EQ(store.get_tip_hash(), side.back().hash());
+    EXPECT_EQ(store.get_height(side[50].hash()), 251u);
+
+    // Продление после reorg и повторного открытия
+    auto next = child_of(store.get_tip_hash(), 99999);
+    EXPECT_EQ(store.accept_header(next, next.hash()).status, HeaderStatus::Extended);
+    std::filesystem::remove(path);
+}
+
+TEST(HeadersStoreBranchTest, WindowSlidesWithTip) {
+    HeadersStore store(bitcoin_params());
+    auto main = branch(store.get_tip_hash(), 3 * HeadersStore::REORG_WINDOW, 1);
+    for (const auto& header : main) {
+        ASSERT_TRUE(store.add_header(header, store.get_tip_height() + 1, header.hash()));
+    }
+
+    // Ветвь от блока глубже окна не принимается, от блока в окне - принимается
+    const uint32_t tip = store.get_tip_height();
+    auto deep = child_of(main[tip - 3 * HeadersStore::REORG_WINDOW].hash(), 777777);
+    EXPECT_EQ(store.accept_header(deep, deep.hash()).status, HeaderStatus::Rejected);
+    auto shallow = child_of(main[tip - 10].hash(), 888888);
+    EXPECT_EQ(store.accept_header(shallow, shallow.hash()).status, HeaderStatus::SideBranch);
+    EXPECT_EQ(store.find_fork(shallow.hash(), main.back().hash()), tip - 9);
+
+    // Предки ниже корня окна - по активной цепи
+    EXPECT_EQ(store.get_ancestor(shallow.hash(), 100), main[99].hash());
+}
+
+} // namespace quaxis::core::sync::test
@@ -7,6 +7,7 @@
 
 #include "core/chain/chain_params.hpp"
 #include "core/chain/chain_registry.hpp"
+#include "core/chain/difficulty.hpp"
 
 namespace quaxis::core::test {
 
@@ -206,10 +207,56 @@ TEST(ChainParamsTest, GetMinerRewardShare) {
     EXPECT_DOUBLE_EQ(ela.get_miner_reward_share(), 0.35);
 }
 
+// =============================================================================
+// Тесты BUILTIN_CHAINS
+// =============================================================================
+
+static_assert(find_builtin_chain("namecoin") == BuiltinChain::Namecoin);
+static_assert(find_builtin_chain(uint32_t{57}) == BuiltinChain::Syscoin);
+static_assert(!find_builtin_chain("dogecoin"));
+static_assert(!find_builtin_chain(uint32_t{0}));
+static_assert(builtin_chain_info(BuiltinChain::Rsk).consensus_type == ConsensusType::AUXPOW_DECOR);
+
+TEST(BuiltinChainsTest, RegistryMatchesTable) {
+    auto& registry = ChainRegistry::instance();
+    
+    for (const auto& info : BUILTIN_CHAINS) {
+        const auto& params = registry.get(info.chain);
+        EXPECT_EQ(params.name, info.name);
+        EXPECT_EQ(params.ticker, info.ticker);
+        EXPECT_EQ(params.auxpow.chain_id, info.chain_id);
+        EXPECT_EQ(params.consensus_type, info.consensus_type);
+        EXPECT_EQ(registry.get_by_name(info.name), &params);
+    }
+}
+
+TEST(BuiltinChainsTest, ReferencesSurviveRegistration) {
+    auto& registry = ChainRegistry::instance();
+    const auto* namecoin = &namecoin_params();
+    
+    ChainParams custom;
+    custom.name = "builtin-chains-test";
+    custom.ticker = "BCT";
+    EXPECT_TRUE(registry.register_chain(std::move(custom)));
+    
+    EXPECT_EQ(&namecoin_params(), namecoin);
+    EXPECT_EQ(namecoin->name, "namecoin");
+}
+
 // =============================================================================
 // Тесты ConsensusType
 // =============================================================================
 
+static_assert(ConsensusTraits<ConsensusType::AUXPOW_HYBRID_BPOS>::reward_splitting);
+static_assert(!ConsensusTraits<ConsensusType::AUXPOW_DAG>::standard_auxpow);
+
+TEST(ConsensusTypeTest, VisitDispatchesToSpecialization) {
+    for (const auto& info : BUILTIN_CHAINS) {
+        auto type = visit_consensus(info.consensus_type, []<ConsensusType T>() { return T; });
+        EXPECT_EQ(type, info.consensus_type) << info.name;
+    }
+}
+
 TEST(ConsensusTypeTest, ToString) {
     EXPECT_EQ(to_string(ConsensusType::PURE_AUXPOW), "PURE_AUXPOW");
     EXPECT_EQ(to_string(ConsensusType::AUXPOW_CHAINLOCK), "AUXPOW_CHAINLOCK");
@@ -234,4 +281,33 @@ TEST(ConsensusTypeTest, HasRewardSplitting) {
     EXPECT_TRUE(has_reward_splitting(ConsensusType::AUXPOW_HYBRID_BPOS));
 }
 
+// =============================================================================
+// Тесты пересчёта сложности
+// =============================================================================
+
+TEST(DifficultyTest, RetargetMatchesBitcoinCore) {
+    const auto& difficulty = bitcoin_params().difficulty;
+    EXPECT_TRUE(is_retarget_height(difficulty, 32256));
+    EXPECT_FALSE(is_retarget_height(difficulty, 32255));
+    EXPECT_EQ(epoch_start_height(difficulty, 32255), 30240u);
+    
+    // Блоки 30240 .. 32255 (остальные векторы - Uint256Test.RetargetMatchesBitcoin)
+    EXPECT_EQ(calculate_next_bits(difficulty, 0x1d00ffff, 1261130161, 1262152739), 0x1d00d86au);
+}
+
+TEST(DifficultyTest, MinDifficultyRule) {
+    DifficultyParams difficulty;
+    difficulty.allow_min_difficulty = true;
+    EXPECT_EQ(min_difficulty_delay(difficulty), 1200u);
+    difficulty.min_difficulty_time = 900;
+    EXPECT_EQ(min_difficulty_delay(difficulty), 900u);
+    
+    EpochDifficulty work;
+    work.bits = 0x1c05a3f4;
+    EXPECT_EQ(work.bits_for(2000000000, difficulty), 0x1c05a3f4u);
+    work.min_difficulty_after = 1700000000;
+    EXPECT_EQ(work.bits_for(1700000000, difficulty), 0x1c05a3f4u);
+    EXPECT_EQ(work.bits_for(1700000001, difficulty), difficulty.pow_limit_bits);
+}
+
 } // namespace quaxis::core::test
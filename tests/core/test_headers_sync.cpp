@@ -8,6 +8,13 @@
 #include "core/sync/headers_sync.hpp"
 #include "core/sync/headers_store.hpp"
 #include "core/chain/chain_registry.hpp"
+#include "core/validation/pow_validator.hpp"
+#include "core/task_pool.hpp"
+
+#include <filesystem>
+#include <fstream>
+
+#include <unistd.h>
 
 namespace quaxis::core::sync::test {
 
@@ -20,6 +27,76 @@ protected:
     const ChainParams* params_;
 };
 
+namespace {
+
+/// @brief Временный файл заголовков, удаляется в деструкторе
+struct TempHeadersFile {
+    std::filesystem::path path;
+    
+    explicit TempHeadersFile(const std::string& name = "headers")
+        : path(std::filesystem::temp_directory_path() /
+               ("quaxis_" + name + "_" + std::to_string(getpid()) + ".dat")) {
+        std::filesystem::remove(path);
+    }
+    ~TempHeadersFile() { std::filesystem::remove(path); }
+};
+
+/// @brief Добавить count заголовков поверх tip
+void extend(HeadersStore& store, uint32_t count) {
+    for (uint32_t i = 0; i < count; ++i) {
+        BlockHeader header;
+        header.version = 1;
+        header.prev_hash = store.get_tip_hash();
+        header.timestamp = 1231469665 + i * 600;
+        header.bits = 0x1d00ffff;
+        header.nonce = i;
+        ASSERT_TRUE(store.add_header(header, store.get_tip_height() + 1));
+    }
+}
+
+/// @brief Параметры с pow_limit 0x207fffff: nonce подбирается за пару попыток
+ChainParams easy_params(const ChainParams& base) {
+    ChainParams params = base;
+    params.difficulty.pow_limit_bits = 0x207fffff;
+    params.checkpoints = {};
+    return params;
+}
+
+/// @brief Цепь count заголовков с валидным PoW поверх prev
+std::vector<BlockHeader> mine_headers(const ChainParams& params, Hash256 prev, std::size_t count) {
+    validation::PowValidator validator(params);
+    std::vector<BlockHeader> chain(count);
+    for (std::size_t i = 0; i < chain.size(); ++i) {
+        auto& header = chain[i];
+        header.version = 0x20000000;
+        header.prev_hash = prev;
+        header.merkle_root[0] = static_cast<uint8_t>(i);
+        header.merkle_root[1] = static_cast<uint8_t>(i >> 8);
+        header.timestamp = 1700000000u + static_cast<uint32_t>(i) * 600;
+        header.bits = params.difficulty.pow_limit_bits;
+        while (!validator.validate_pow(header)) {
+            ++header.nonce;
+        }
+        prev = header.hash();
+    }
+    return chain;
+}
+
+/// @brief Файл снапшота: magic, base (LE), заголовки
+void write_snapshot(const std::filesystem::path& path, uint32_t base, std::span<const BlockHeader> headers) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(HEADERS_SNAPSHOT_MAGIC.data()), HEADERS_SNAPSHOT_MAGIC.size());
+    for (int shift = 0; shift < 32; shift += 8) {
+        out.put(static_cast<char>(base >> shift));
+    }
+    for (const auto& header : headers) {
+        auto bytes = header.serialize();
+        out.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+    }
+}
+
+} // anonymous namespace
+
 // =============================================================================
 // Тесты HeadersStore
 // =============================================================================
@@ -91,6 +168,56 @@ TEST_F(HeadersSyncTest, HeadersStoreRecentHeaders) {
     EXPECT_EQ(recent.size(), 3);
 }
 
+TEST_F(HeadersSyncTest, HeadersStoreViewIsStableSnapshot) {
+    HeadersStore store(*params_);
+    extend(store, HEADERS_CHUNK + 100);
+    const auto before = store.view();
+    ASSERT_EQ(before.size(), HEADERS_CHUNK + 101);
+    EXPECT_EQ(before.tip_height(), HEADERS_CHUNK + 100);
+    
+    // Span не переходит границу куска, for_each обходит весь диапазон
+    EXPECT_EQ(before.contiguous(HEADERS_CHUNK - 10, 50).size(), 10u);
+    uint32_t seen = 0;
+    before.for_each(HEADERS_CHUNK - 10, HEADERS_CHUNK + 20, [&](std::span<const HeaderSummary> summaries) {
+        for (const auto& summary : summaries) {
+            const uint32_t height = HEADERS_CHUNK - 10 + seen;
+            const auto expected = HeaderSummary::from(*store.get_by_height(height), *store.get_hash(height));
+            EXPECT_EQ(summary.hash_prefix, expected.hash_prefix);
+            EXPECT_EQ(summary.timestamp, expected.timestamp);
+            EXPECT_EQ(summary.bits, 0x1d00ffffu);
+            ++seen;
+        }
+    });
+    EXPECT_EQ(seen, 31u);
+    EXPECT_EQ(store.get_recent_headers(3).back().hash(), store.get_tip_hash());
+    
+    // Продление и reorg не меняют прежний снимок
+    auto prefix = [](const Hash256& hash) { return HeaderSummary::from(BlockHeader{}, hash).hash_prefix; };
+    const Hash256 old_tip = store.get_tip_hash();
+    extend(store, 5);
+    EXPECT_EQ(before.size(), HEADERS_CHUNK + 101);
+    EXPECT_EQ(before.get(HEADERS_CHUNK + 100)->hash_prefix, prefix(old_tip));
+    EXPECT_EQ(before.get(HEADERS_CHUNK + 101), nullptr);
+    
+    Hash256 prev = *store.get_hash(HEADERS_CHUNK + 99);
+    for (uint32_t i = 0; i < 7; ++i) {
+        BlockHeader header;
+        header.version = 2;
+        header.prev_hash = prev;
+        header.timestamp = 1231469665 + i * 600;
+        header.bits = 0x1d00ffff;
+        header.nonce = 777 + i;
+        (void)store.accept_header(header, header.hash());
+        prev = header.hash();
+    }
+    EXPECT_EQ(store.get_tip_hash(), prev);
+    EXPECT_EQ(before.get(HEADERS_CHUNK + 100)->hash_prefix, prefix(old_tip));
+    EXPECT_EQ(store.view().get(HEADERS_CHUNK + 106)->hash_prefix, prefix(prev));
+    EXPECT_EQ(store.get_by_height(HEADERS_CHUNK + 100)->version, 2);
+    EXPECT_EQ(store.view().get(HEADERS_CHUNK + 100)->hash_prefix,
+              prefix(*store.get_hash(HEADERS_CHUNK + 100)));
+}
+
 TEST_F(HeadersSyncTest, HeadersStoreClear) {
     HeadersStore store(*params_);
     
@@ -112,6 +239,111 @@ TEST_F(HeadersSyncTest, HeadersStoreClear) {
     EXPECT_EQ(store.get_tip_height(), 0);
 }
 
+TEST_F(HeadersSyncTest, HeadersStoreFileSurvivesReopen) {
+    TempHeadersFile file;
+    Hash256 tip_hash{};
+    Hash256 mid_hash{};
+    {
+        HeadersStore store(*params_);
+        ASSERT_TRUE(store.open(file.path.string()));
+        EXPECT_TRUE(store.is_persistent());
+        EXPECT_EQ(store.size(), 1);
+        extend(store, 200);
+        tip_hash = store.get_tip_hash();
+        mid_hash = *store.get_hash(100);
+        EXPECT_EQ(mid_hash, store.get_by_height(100)->hash());
+    }
+    EXPECT_EQ(std::filesystem::file_size(file.path), 201 * BLOCK_HEADER_SIZE);
+    
+    HeadersStore store(*params_);
+    ASSERT_TRUE(store.open(file.path.string()));
+    EXPECT_EQ(store.get_tip_height(), 200);
+    EXPECT_EQ(store.get_tip_hash(), tip_hash);
+    EXPECT_EQ(store.get_height(mid_hash), 100);
+    ASSERT_TRUE(store.get_by_hash(mid_hash).has_value());
+    EXPECT_EQ(store.get_by_hash(mid_hash)->hash(), mid_hash);
+    
+    // Продолжение цепи после открытия
+    extend(store, 5);
+    EXPECT_EQ(store.get_tip_height(), 205);
+    EXPECT_TRUE(store.has_header(tip_hash));
+}
+
+TEST_F(HeadersSyncTest, HeadersStoreFileCutsTornAndBrokenTail) {
+    TempHeadersFile file;
+    {
+        HeadersStore store(*params_);
+        ASSERT_TRUE(store.open(file.path.string()));
+        extend(store, 20);
+    }
+    
+    // Запись 18 с чужим prev_hash, затем обрывок записи
+    {
+        std::fstream out(file.path, std::ios::in | std::ios::out | std::ios::binary);
+        out.seekp(static_cast<std::streamoff>(18 * BLOCK_HEADER_SIZE + 4));
+        out.put(static_cast<char>(0xAA));
+        out.seekp(0, std::ios::end);
+        out.write("torn", 4);
+    }
+    
+    HeadersStore store(*params_);
+    ASSERT_TRUE(store.open(file.path.string()));
+    EXPECT_EQ(store.get_tip_height(), 17);
+    EXPECT_EQ(std::filesystem::file_size(file.path), 18 * BLOCK_HEADER_SIZE);
+    extend(store, 1);
+    EXPECT_EQ(store.get_tip_height(), 18);
+}
+
+TEST_F(HeadersSyncTest, HeadersStoreParallelRebuildMatchesSequential) {
+    TempHeadersFile file;
+    const uint32_t tip = HeadersStore::PARALLEL_REBUILD_MIN + 1234;
+    const ChainParams params = easy_params(*params_);  // Без контрольных точек
+    {
+        HeadersStore store(params);
+        ASSERT_TRUE(store.open(file.path.string()));
+        extend(store, tip);
+    }
+    
+    TaskPool pool(3);
+    HeadersStore sequential(params);
+    HeadersStore parallel(params);
+    ASSERT_TRUE(sequential.open(file.path.string()));
+    ASSERT_TRUE(parallel.open(file.path.string(), &pool));
+    ASSERT_EQ(parallel.get_tip_height(), tip);
+    EXPECT_EQ(parallel.get_tip_hash(), sequential.get_tip_hash());
+    
+    // Каждый хеш находится на своей высоте, сводки совпадают
+    const auto sequential_view = sequential.view();
+    const auto parallel_view = parallel.view();
+    for (uint32_t height = 0; height <= tip; ++height) {
+        const auto hash = parallel.get_hash(height);
+        ASSERT_TRUE(hash.has_value());
+        ASSERT_EQ(parallel.get_height(*hash), height);
+        ASSERT_EQ(parallel_view.get(height)->hash_prefix, sequential_view.get(height)->hash_prefix);
+    }
+    Hash256 unknown{};
+    unknown.fill(0x5A);
+    EXPECT_FALSE(parallel.has_header(unknown));
+    
+    // Индекс после перестроения продолжает расти обычной вставкой
+    extend(parallel, 3);
+    EXPECT_EQ(parallel.get_height(parallel.get_tip_hash()), tip + 3);
+}
+
+TEST_F(HeadersSyncTest, HeadersStoreFileRejectsOtherGenesis) {
+    TempHeadersFile file;
+    {
+        std::ofstream out(file.path, std::ios::binary);
+        std::string junk(BLOCK_HEADER_SIZE * 2, '\x5A');
+        out.write(junk.data(), static_cast<std::streamsize>(junk.size()));
+    }
+    
+    HeadersStore store(*params_);
+    auto result = store.open(file.path.string());
+    EXPECT_FALSE(result);
+    EXPECT_FALSE(store.is_persistent());
+}
+
 // =============================================================================
 // Тесты HeadersSync
 // =============================================================================
@@ -163,6 +395,263 @@ TEST_F(HeadersSyncTest, HeadersSyncProcessHeaders) {
     EXPECT_GE(sync.get_tip_height(), 0);
 }
 
+TEST_F(HeadersSyncTest, HashHeadersMatchesHash) {
+    // Больше одной внутренней пачки hash_headers()
+    std::vector<BlockHeader> headers(70);
+    for (std::size_t i = 0; i < headers.size(); ++i) {
+        headers[i].version = 0x20000000;
+        headers[i].prev_hash[i % 32] = static_cast<uint8_t>(i);
+        headers[i].merkle_root[31 - i % 32] = static_cast<uint8_t>(i * 3);
+        headers[i].timestamp = 1700000000u + static_cast<uint32_t>(i);
+        headers[i].bits = 0x1d00ffff;
+        headers[i].nonce = static_cast<uint32_t>(i * 2654435761u);
+    }
+    
+    std::vector<Hash256> hashes(headers.size());
+    ASSERT_EQ(hash_headers(headers, hashes), headers.size());
+    for (std::size_t i = 0; i < headers.size(); ++i) {
+        EXPECT_EQ(hashes[i], headers[i].hash()) << "header " << i;
+    }
+}
+
+TEST_F(HeadersSyncTest, ParallelPowMatchesSequential) {
+    ChainParams params = easy_params(*params_);
+    validation::PowValidator validator(params);
+    
+    HeadersSync builder(params, 1);
+    auto chain = mine_headers(params, builder.get_tip_hash(), 3 * HeadersSync::PARALLEL_MIN + 7);
+    
+    HeadersSync sequential(params, 1);
+    HeadersSync parallel(params, 4);
+    ASSERT_TRUE(sequential.process_headers(chain));
+    ASSERT_TRUE(parallel.process_headers(chain));
+    EXPECT_EQ(parallel.get_tip_height(), chain.size());
+    EXPECT_EQ(parallel.get_tip_hash(), sequential.get_tip_hash());
+    
+    // Невалидный PoW в середине: добавлено всё до него
+    const std::size_t bad = HeadersSync::PARALLEL_MIN + 3;
+    auto broken = chain;
+    while (validator.validate_pow(broken[bad])) {
+        ++broken[bad].nonce;
+    }
+    HeadersSync partial(params, 4);
+    EXPECT_FALSE(partial.process_headers(broken));
+    EXPECT_EQ(partial.get_tip_height(), bad);
+    
+    // Пул переиспользуется следующей пачкой
+    std::vector<BlockHeader> rest(broken.begin() + static_cast<std::ptrdiff_t>(bad), broken.end());
+    rest.front() = chain[bad];
+    EXPECT_TRUE(partial.process_headers(rest));
+    EXPECT_EQ(partial.get_tip_hash(), sequential.get_tip_hash());
+}
+
+TEST_F(HeadersSyncTest, PowBatchMatchesSingleChecks) {
+    ChainParams params = easy_params(*params_);
+    validation::PowValidator validator(params);
+    auto headers = mine_headers(params, Hash256{}, 150);
+    
+    // Невалидный nonce, bits сложнее (и разных значений больше кэша),
+    // отрицательный флаг, target не в 256 битах
+    for (std::size_t i = 5; i < headers.size(); i += 17) {
+        while (validation::quick_check_pow(headers[i])) {
+            ++headers[i].nonce;
+        }
+    }
+    for (std::size_t i = 0; i < 8; ++i) {
+        headers[60 + i].bits = 0x1f00ffff - static_cast<uint32_t>(i);
+    }
+    headers[100].bits = 0x20800000;
+    headers[101].bits = 0x217fffff;
+    
+    std::array<uint64_t, validation::pow_bitmap_words(150)> bitmap{};
+    std::vector<Hash256> hashes(headers.size());
+    const std::size_t valid = validation::quick_check_pow_batch(headers, bitmap, hashes);
+    std::array<uint64_t, validation::pow_bitmap_words(150)> strict{};
+    const std::size_t strict_valid = validator.validate_pow_batch(headers, strict);
+    
+    std::size_t expected = 0;
+    std::size_t expected_strict = 0;
+    for (std::size_t i = 0; i < headers.size(); ++i) {
+        EXPECT_EQ(hashes[i], headers[i].hash()) << "header " << i;
+        const bool quick = validation::quick_check_pow(headers[i]);
+        const bool full = validator.validate_pow(headers[i]);
+        EXPECT_EQ(((bitmap[i / 64] >> (i % 64)) & 1) != 0, quick) << "header " << i;
+        EXPECT_EQ(((strict[i / 64] >> (i % 64)) & 1) != 0, full) << "header " << i;
+        expected += quick;
+        expected_strict += full;
+    }
+    EXPECT_EQ(valid, expected);
+    EXPECT_EQ(strict_valid, expected_strict);
+    EXPECT_LT(valid, headers.size());
+    
+    // Bits выше pow_limit mainnet: хеши проходят, проверка валидатора - нет
+    validation::PowValidator mainnet(*params_);
+    EXPECT_EQ(mainnet.validate_pow_batch(headers, strict), 0u);
+    EXPECT_EQ(strict[0], 0u);
+}
+
+TEST_F(HeadersSyncTest, CheckpointHashInDisplayOrder) {
+    const auto* checkpoint = params_->find_checkpoint(11111);
+    ASSERT_NE(checkpoint, nullptr);
+    // 0000000069e2...7c1d: старший байт отображения - последний
+    EXPECT_EQ(checkpoint->hash[0], 0x1d);
+    EXPECT_EQ(checkpoint->hash[31], 0x00);
+    EXPECT_EQ(params_->find_checkpoint(checkpoint->hash), checkpoint);
+    EXPECT_EQ(params_->find_checkpoint(11112), nullptr);
+}
+
+TEST_F(HeadersSyncTest, SnapshotStartsFromCheckpoint) {
+    ChainParams params = easy_params(*params_);
+    HeadersSync full(params, 1);
+    auto chain = mine_headers(params, full.get_tip_hash(), 600);  // chain[i] - высота i + 1
+    
+    const std::array<HeaderCheckpoint, 2> checkpoints{
+        HeaderCheckpoint{300, chain[299].hash()},
+        HeaderCheckpoint{450, chain[449].hash()},
+    };
+    params.checkpoints = checkpoints;
+    ASSERT_TRUE(full.process_headers(chain));
+    
+    TempHeadersFile snapshot("snapshot");
+    write_snapshot(snapshot.path, 300, std::span(chain).subspan(299));
+    
+    HeadersSync fresh(params);
+    ASSERT_TRUE(fresh.load_snapshot(snapshot.path.string()));
+    EXPECT_EQ(fresh.get_tip_height(), 600);
+    EXPECT_EQ(fresh.get_tip_hash(), full.get_tip_hash());
+    EXPECT_FALSE(fresh.get_header(299).has_value());
+    ASSERT_TRUE(fresh.get_header(300).has_value());
+    EXPECT_EQ(fresh.get_block_locator().back(), checkpoints[0].hash);
+    
+    // Дальше - обычная синхронизация
+    auto more = mine_headers(params, fresh.get_tip_hash(), 10);
+    EXPECT_TRUE(fresh.process_headers(more));
+    EXPECT_EQ(fresh.get_tip_height(), 610);
+    
+    // Снапшот не выше tip не применяется
+    EXPECT_TRUE(fresh.load_snapshot(snapshot.path.string()));
+    EXPECT_EQ(fresh.get_tip_height(), 610);
+    
+    // Файл хранилища после снапшота узнаёт базу по контрольной точке
+    TempHeadersFile store_file;
+    {
+        HeadersSync persistent(params);
+        ASSERT_TRUE(persistent.open_store(store_file.path.string()));
+        ASSERT_TRUE(persistent.load_snapshot(snapshot.path.string()));
+    }
+    HeadersSync reopened(params);
+    ASSERT_TRUE(reopened.open_store(store_file.path.string()));
+    EXPECT_EQ(reopened.get_tip_height(), 600);
+    EXPECT_EQ(reopened.get_tip_hash(), full.get_tip_hash());
+    EXPECT_FALSE(reopened.get_header(299).has_value());
+    
+    // save_snapshot -> load_snapshot
+    TempHeadersFile resaved("resaved");
+    ASSERT_TRUE(fresh.save_snapshot(resaved.path.string()));
+    HeadersSync copy(params);
+    ASSERT_TRUE(copy.load_snapshot(resaved.path.string()));
+    EXPECT_EQ(copy.get_tip_hash(), fresh.get_tip_hash());
+}
+
+TEST_F(HeadersSyncTest, SnapshotRejectsUntrustedChains) {
+    ChainParams params = easy_params(*params_);
+    HeadersSync builder(params, 1);
+    auto chain = mine_headers(params, builder.get_tip_hash(), 400);
+    
+    const std::array<HeaderCheckpoint, 1> checkpoints{HeaderCheckpoint{200, chain[199].hash()}};
+    params.checkpoints = checkpoints;
+    TempHeadersFile snapshot;
+    
+    // Начало не на контрольной точке
+    write_snapshot(snapshot.path, 201, std::span(chain).subspan(200));
+    HeadersSync not_anchored(params);
+    EXPECT_FALSE(not_anchored.load_snapshot(snapshot.path.string()));
+    EXPECT_EQ(not_anchored.get_tip_height(), 0);
+    
+    // Невалидный PoW после последней контрольной точки
+    auto broken = chain;
+    validation::PowValidator validator(params);
+    while (validator.validate_pow(broken[300])) {
+        ++broken[300].nonce;
+    }
+    write_snapshot(snapshot.path, 200, std::span(broken).subspan(199));
+    HeadersSync bad_pow(params);
+    EXPECT_FALSE(bad_pow.load_snapshot(snapshot.path.string()));
+    EXPECT_EQ(bad_pow.get_tip_height(), 0);
+    
+    // Другой хеш контрольной точки: ни снапшот, ни обычная синхронизация
+    ChainParams other = params;
+    const std::array<HeaderCheckpoint, 2> wrong{checkpoints[0], HeaderCheckpoint{300, Hash256{}}};
+    other.checkpoints = wrong;
+    write_snapshot(snapshot.path, 200, std::span(chain).subspan(199));
+    HeadersSync mismatch(other);
+    EXPECT_FALSE(mismatch.load_snapshot(snapshot.path.string()));
+    EXPECT_FALSE(mismatch.process_headers(chain));
+    EXPECT_EQ(mismatch.get_tip_height(), 299);
+}
+
+TEST_F(HeadersSyncTest, NextWorkPrecomputedAtRetarget) {
+    auto params = easy_params(*params_);
+    params.difficulty.adjustment_interval = 10;
+    params.difficulty.target_spacing = 2160;   // T = 21600 с, эпоха цепи - 5400 с
+    HeadersSync sync(params);
+    auto chain = mine_headers(params, sync.get_tip_hash(), 19);  // chain[i] - высота i + 1
+    
+    // Внутри эпохи - bits tip
+    ASSERT_TRUE(sync.process_headers(std::vector<BlockHeader>(chain.begin(), chain.begin() + 18)));
+    auto work = sync.get_next_work();
+    EXPECT_EQ(work.height, 19u);
+    EXPECT_EQ(work.prev_hash, chain[17].hash());
+    EXPECT_EQ(work.bits, params.difficulty.pow_limit_bits);
+    EXPECT_EQ(work.min_difficulty_after, 0u);
+    
+    // Последний блок эпохи: bits высоты 20 готовы до запроса шаблона
+    ASSERT_TRUE(sync.process_headers(std::vector<BlockHeader>(chain.begin() + 18, chain.end())));
+    work = sync.get_next_work();
+    EXPECT_EQ(work.height, 20u);
+    EXPECT_EQ(work.epoch_start, 20u);
+    EXPECT_EQ(work.prev_hash, chain[18].hash());
+    EXPECT_EQ(work.bits, calculate_next_bits(params.difficulty, chain[18].bits,
+                                             chain[9].timestamp, chain[18].timestamp));
+    EXPECT_NE(work.bits, params.difficulty.pow_limit_bits);
+    EXPECT_EQ(work.target, bits_to_target(work.bits));
+    EXPECT_GT(work.difficulty, bits_to_difficulty(params.difficulty.pow_limit_bits));
+}
+
+TEST_F(HeadersSyncTest, NextWorkMinDifficultyRule) {
+    auto params = easy_params(*params_);
+    params.difficulty.adjustment_interval = 10;
+    params.difficulty.allow_min_difficulty = true;
+    HeadersSync sync(params);
+    
+    // Высоты 1..11 - bits сложнее pow_limit, 12..13 - блоки минимальной сложности
+    constexpr uint32_t HARD_BITS = 0x2000ffff;
+    validation::PowValidator validator(params);
+    std::vector<BlockHeader> chain(13);
+    Hash256 prev = sync.get_tip_hash();
+    for (std::size_t i = 0; i < chain.size(); ++i) {
+        auto& header = chain[i];
+        header.version = 0x20000000;
+        header.prev_hash = prev;
+        header.merkle_root[0] = static_cast<uint8_t>(i);
+        header.timestamp = 1700000000u + static_cast<uint32_t>(i) * 600;
+        header.bits = i < 11 ? HARD_BITS : params.difficulty.pow_limit_bits;
+        while (!validator.validate_pow(header)) {
+            ++header.nonce;
+        }
+        prev = header.hash();
+    }
+    ASSERT_TRUE(sync.process_headers(chain));
+    
+    // Последние bits не минимальной сложности; после паузы - pow_limit
+    const auto work = sync.get_next_work();
+    EXPECT_EQ(work.height, 14u);
+    EXPECT_EQ(work.bits, HARD_BITS);
+    EXPECT_EQ(work.min_difficulty_after, chain.back().timestamp + 1200);
+    EXPECT_EQ(work.bits_for(chain.back().timestamp + 600, params.difficulty), HARD_BITS);
+    EXPECT_EQ(work.bits_for(chain.back().timestamp + 1201, params.difficulty), params.difficulty.pow_limit_bits);
+}
+
 TEST_F(HeadersSyncTest, HeadersSyncGetBlockLocator) {
     HeadersSync sync(*params_);
     
@@ -183,6 +672,75 @@ TEST_F(HeadersSyncTest, HeadersSyncCallback) {
     EXPECT_FALSE(callback_called);  // Пока не вызван
 }
 
+TEST_F(HeadersSyncTest, DuplicateHeadersFilteredBeforeLock) {
+    ChainParams params = easy_params(*params_);
+    HeadersSync sync(params, 1);
+    auto chain = mine_headers(params, sync.get_tip_hash(), 4);
+    
+    int new_blocks = 0;
+    sync.on_new_block([&new_blocks](const BlockHeader&, uint32_t) { ++new_blocks; });
+    
+    std::vector<BlockHeader> first(chain.begin(), chain.begin() + 3);
+    ASSERT_TRUE(sync.process_headers(first));
+    EXPECT_EQ(new_blocks, 3);
+    EXPECT_EQ(sync.filtered_duplicates(), 0u);
+    
+    // Тот же tip от другого peer - отброшен фильтром
+    EXPECT_TRUE(sync.process_headers({chain[2]}));
+    EXPECT_TRUE(sync.process_headers(first));
+    EXPECT_EQ(sync.filtered_duplicates(), 2u);
+    EXPECT_EQ(new_blocks, 3);
+    
+    // Пачка с новым заголовком идёт полным путём
+    EXPECT_TRUE(sync.process_headers({chain[2], chain[3]}));
+    EXPECT_EQ(sync.filtered_duplicates(), 2u);
+    EXPECT_EQ(sync.get_tip_height(), 4u);
+    EXPECT_EQ(new_blocks, 4);
+    
+    // Другой nonce - другой отпечаток: проверяется PoW
+    auto forged = chain[3];
+    validation::PowValidator validator(params);
+    do {
+        ++forged.nonce;
+    } while (validator.validate_pow(forged));
+    EXPECT_FALSE(sync.process_headers({forged}));
+    EXPECT_EQ(sync.filtered_duplicates(), 2u);
+}
+
+TEST(RecentHashFilterTest, EvictsOldestInSet) {
+    RecentHashFilter filter(1);
+    EXPECT_EQ(filter.capacity(), RecentHashFilter::WAYS);
+    
+    // Один набор: пятый отпечаток вытесняет первый
+    for (uint64_t key = 1; key <= RecentHashFilter::WAYS; ++key) {
+        EXPECT_TRUE(filter.insert(key));
+    }
+    EXPECT_FALSE(filter.insert(2));
+    EXPECT_TRUE(filter.contains(1));
+    EXPECT_TRUE(filter.insert(100));
+    EXPECT_FALSE(filter.contains(1));
+    EXPECT_TRUE(filter.contains(2));
+    EXPECT_TRUE(filter.contains(100));
+    
+    filter.clear();
+    EXPECT_FALSE(filter.contains(100));
+    EXPECT_FALSE(filter.contains(2));
+    
+    // Отпечаток зависит от каждого поля заголовка
+    BlockHeader header;
+    header.bits = 0x1d00ffff;
+    const uint64_t key = RecentHashFilter::header_key(header);
+    auto other = header;
+    other.timestamp = 1;
+    EXPECT_NE(RecentHashFilter::header_key(other), key);
+    other = header;
+    other.prev_hash[31] = 1;
+    EXPECT_NE(RecentHashFilter::header_key(other), key);
+    other = header;
+    other.version = 2;
+    EXPECT_NE(RecentHashFilter::header_key(other), key);
+}
+
 TEST_F(HeadersSyncTest, HeadersSyncGetCurrentBits) {
     HeadersSync sync(*params_);
     
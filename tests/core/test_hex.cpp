@@ -0,0 +1,120 @@
+/**
+ * @file test_hex.cpp
+ * @brief Тесты для hex кодека (все доступные реализации)
+ */
+
+#include <gtest/gtest.h>
+
+#include "core/byte_order.hpp"
+
+#include <random>
+#include <string>
+#include <vector>
+
+namespace quaxis::test {
+
+namespace {
+
+constexpr HexImplementation ALL[] = {
+    HexImplementation::Scalar,
+    HexImplementation::Ssse3,
+    HexImplementation::Avx2,
+    HexImplementation::Neon,
+};
+
+/// @brief Эталон: по байту через таблицу
+std::string reference_hex(const std::vector<uint8_t>& data) {
+    static constexpr char DIGITS[] = "0123456789abcdef";
+    std::string hex;
+    for (uint8_t byte : data) {
+        hex.push_back(DIGITS[byte >> 4]);
+        hex.push_back(DIGITS[byte & 0x0F]);
+    }
+    return hex;
+}
+
+std::vector<uint8_t> random_bytes(std::size_t size, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::vector<uint8_t> data(size);
+    for (auto& byte : data) {
+        byte = static_cast<uint8_t>(rng());
+    }
+    return data;
+}
+
+} // anonymous namespace
+
+TEST(HexTest, KnownValues) {
+    const std::vector<uint8_t> data = {0x00, 0x01, 0x7f, 0x80, 0xab, 0xff};
+    EXPECT_EQ(to_hex(data), "00017f80abff");
+
+    std::vector<uint8_t> decoded(6);
+    ASSERT_TRUE(hex_decode("00017F80ABff", decoded.data()));
+    EXPECT_EQ(decoded, data);
+
+    std::string reversed(12, '\0');
+    hex_encode_reversed(data, reversed.data());
+    EXPECT_EQ(reversed, "ffab807f0100");
+    ASSERT_TRUE(hex_decode_reversed(reversed, decoded.data()));
+    EXPECT_EQ(decoded, data);
+
+    std::string appended = "[\"";
+    append_hex(appended, data);
+    EXPECT_EQ(appended, "[\"00017f80abff");
+    EXPECT_TRUE(to_hex({}).empty());
+}
+
+TEST(HexTest, ImplementationsMatchReference) {
+    EXPECT_TRUE(has_hex_implementation(get_hex_implementation()));
+    for (auto impl : ALL) {
+        if (!has_hex_implementation(impl)) {
+            continue;
+        }
+        SCOPED_TRACE(std::string(hex_implementation_name(impl)));
+        // Длины вокруг границ блоков 16 / 32 байт и размер блока
+        for (std::size_t size : {0, 1, 15, 16, 17, 31, 32, 33, 63, 64, 65, 80, 1000, 4099}) {
+            const auto data = random_bytes(size, static_cast<uint32_t>(size));
+            const auto expected = reference_hex(data);
+
+            std::string hex(size * 2, '\0');
+            hex_encode(data, hex.data(), impl);
+            EXPECT_EQ(hex, expected);
+
+            // Декодирование в обоих регистрах
+            std::vector<uint8_t> decoded(size);
+            ASSERT_TRUE(hex_decode(expected, decoded.data(), impl));
+            EXPECT_EQ(decoded, data);
+            std::string upper = expected;
+            for (auto& c : upper) {
+                c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+            }
+            ASSERT_TRUE(hex_decode(upper, decoded.data(), impl));
+            EXPECT_EQ(decoded, data);
+        }
+    }
+}
+
+TEST(HexTest, RejectsInvalidInput) {
+    const auto expected = reference_hex(random_bytes(100, 7));
+    std::vector<uint8_t> decoded(100);
+    for (auto impl : ALL) {
+        if (!has_hex_implementation(impl)) {
+            continue;
+        }
+        SCOPED_TRACE(std::string(hex_implementation_name(impl)));
+        EXPECT_FALSE(hex_decode(std::string_view(expected).substr(0, 199), decoded.data(), impl));
+
+        // Символы у границ диапазонов '0'-'9', 'a'-'f', 'A'-'F' и старшие байты
+        for (char bad : {'/', ':', '@', 'G', '`', 'g', 'x', ' ', '\0', '\x80', '\xc1', '\xff'}) {
+            for (std::size_t pos : {0, 1, 31, 64, 127, 190, 199}) {
+                std::string hex = expected;
+                hex[pos] = bad;
+                EXPECT_FALSE(hex_decode(hex, decoded.data(), impl)) << "pos " << pos << " char " << int(bad);
+            }
+        }
+    }
+    EXPECT_FALSE(hex_decode_reversed("abc", decoded.data()));
+    EXPECT_FALSE(hex_decode_reversed("zz", decoded.data()));
+}
+
+} // namespace quaxis::test
@@ -0,0 +1,314 @@
+/**
+ * @file test_p2p_peer.cpp
+ * @brief Тесты для P2P клиента синхронизации заголовков
+ */
+
+#include <gtest/gtest.h>
+
+#include "core/sync/headers_sync.hpp"
+#include "core/sync/p2p_peer.hpp"
+#include "core/chain/chain_registry.hpp"
+#include "core/serialization/stream.hpp"
+#include "core/validation/pow_validator.hpp"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace quaxis::core::sync::test {
+
+namespace {
+
+/// @brief Параметры с pow_limit 0x207fffff: nonce подбирается за пару попыток
+ChainParams easy_params() {
+    ChainParams params = bitcoin_params();
+    params.difficulty.pow_limit_bits = 0x207fffff;
+    params.checkpoints = {};
+    return params;
+}
+
+/// @brief Цепь count заголовков с валидным PoW поверх prev
+std::vector<BlockHeader> mine_headers(const ChainParams& params, Hash256 prev, std::size_t count) {
+    validation::PowValidator validator(params);
+    std::vector<BlockHeader> chain(count);
+    for (std::size_t i = 0; i < chain.size(); ++i) {
+        auto& header = chain[i];
+        header.version = 0x20000000;
+        header.prev_hash = prev;
+        header.merkle_root[0] = static_cast<uint8_t>(i + 1);
+        header.timestamp = 1700000000u + static_cast<uint32_t>(i) * 600;
+        header.bits = params.difficulty.pow_limit_bits;
+        while (!validator.validate_pow(header)) {
+            ++header.nonce;
+        }
+        prev = header.hash();
+    }
+    return chain;
+}
+
+Bytes headers_payload(std::span<const BlockHeader> headers) {
+    serialization::WriteStream stream;
+    stream.write_varint(headers.size());
+    for (const auto& header : headers) {
+        auto bytes = header.serialize();
+        stream.write_bytes(bytes);
+        stream.write_varint(0);
+    }
+    return stream.take_data();
+}
+
+/// @brief cmpctblock без коротких ID: header, nonce, 0 shortids, 0 prefilled
+Bytes cmpctblock_payload(const BlockHeader& header) {
+    serialization::WriteStream stream;
+    auto bytes = header.serialize();
+    stream.write_bytes(bytes);
+    stream.write_u64_le(42);
+    stream.write_varint(0);
+    stream.write_varint(0);
+    return stream.take_data();
+}
+
+/// @brief Дождаться условия (до 5 секунд)
+template<typename Predicate>
+bool wait_for(Predicate predicate) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!predicate()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+/**
+ * @brief Peer на loopback: отвечает по сценарию теста
+ */
+class FakePeer {
+public:
+    explicit FakePeer(const NetworkMagic& magic) : magic_(magic), reader_(magic) {
+        listen_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = 0;
+        EXPECT_EQ(::bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0);
+        EXPECT_EQ(::listen(listen_fd_, 1), 0);
+        socklen_t size = sizeof(addr);
+        ::getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &size);
+        port_ = ntohs(addr.sin_port);
+    }
+
+    ~FakePeer() {
+        if (fd_ >= 0) ::close(fd_);
+        ::close(listen_fd_);
+    }
+
+    [[nodiscard]] uint16_t port() const noexcept { return port_; }
+
+    void accept() { fd_ = ::accept(listen_fd_, nullptr, nullptr); }
+
+    void send(std::string_view command, ByteSpan payload = {}) {
+        auto message = encode_p2p_message(magic_, command, payload);
+        ASSERT_EQ(::send(fd_, message.data(), message.size(), MSG_NOSIGNAL),
+                  static_cast<ssize_t>(message.size()));
+    }
+
+    /// @brief Читать до команды; пропущенные команды - в seen
+    Bytes read_until(std::string_view command) {
+        std::array<uint8_t, 4096> buffer;
+        while (true) {
+            P2pMessage message;
+            while (reader_.next(message) == P2pFrameReader::Status::Message) {
+                seen.emplace_back(message.command);
+                if (message.command == command) {
+                    return Bytes(message.payload.begin(), message.payload.end());
+                }
+            }
+            ssize_t n = ::recv(fd_, buffer.data(), buffer.size(), 0);
+            if (n <= 0) {
+                return {};
+            }
+            reader_.feed(ByteSpan(buffer.data(), static_cast<std::size_t>(n)));
+        }
+    }
+
+    std::vector<std::string> seen;
+
+private:
+    NetworkMagic magic_;
+    P2pFrameReader reader_;
+    int listen_fd_{-1};
+    int fd_{-1};
+    uint16_t port_{0};
+};
+
+} // anonymous namespace
+
+// =============================================================================
+// Кодирование сообщений
+// =============================================================================
+
+TEST(P2pMessageTest, FrameRoundTripAcrossPartialReads) {
+    const NetworkMagic magic{0xf9, 0xbe, 0xb4, 0xd9};
+    auto ping = encode_p2p_message(magic, "ping", Bytes{1, 2, 3, 4, 5, 6, 7, 8});
+    auto verack = encode_p2p_message(magic, "verack");
+    ASSERT_EQ(ping.size(), P2P_HEADER_SIZE + 8);
+    // Контрольная сумма пустого payload - первые байты sha256d("")
+    EXPECT_EQ(verack[20], 0x5d);
+    EXPECT_EQ(verack[23], 0xe2);
+
+    Bytes stream = ping;
+    stream.insert(stream.end(), verack.begin(), verack.end());
+
+    P2pFrameReader reader(magic);
+    P2pMessage message;
+    reader.feed(ByteSpan(stream.data(), 10));
+    EXPECT_EQ(reader.next(message), P2pFrameReader::Status::Incomplete);
+    reader.feed(ByteSpan(stream.data() + 10, stream.size() - 10));
+
+    ASSERT_EQ(reader.next(message), P2pFrameReader::Status::Message);
+    EXPECT_EQ(message.command, "ping");
+    EXPECT_EQ(message.payload.size(), 8u);
+    EXPECT_EQ(message.payload[7], 8);
+    ASSERT_EQ(reader.next(message), P2pFrameReader::Status::Message);
+    EXPECT_EQ(message.command, "verack");
+    EXPECT_TRUE(message.payload.empty());
+    EXPECT_EQ(reader.next(message), P2pFrameReader::Status::Incomplete);
+
+    // Испорченная контрольная сумма
+    ping[P2P_HEADER_SIZE] ^= 1;
+    reader.feed(ping);
+    EXPECT_EQ(reader.next(message), P2pFrameReader::Status::Invalid);
+
+    // Чужая сеть
+    P2pFrameReader testnet({0x0b, 0x11, 0x09, 0x07});
+    testnet.feed(verack);
+    EXPECT_EQ(testnet.next(message), P2pFrameReader::Status::Invalid);
+}
+
+TEST(P2pMessageTest, PayloadsParse) {
+    auto version = build_version_payload(850000, 7, 1700000000);
+    EXPECT_EQ(parse_version_start_height(version), 850000u);
+    EXPECT_EQ(version.back(), 0);  // relay выключен
+    EXPECT_FALSE(parse_version_start_height(ByteSpan(version.data(), 40)).has_value());
+
+    auto sendcmpct = build_sendcmpct_payload(true);
+    ASSERT_EQ(sendcmpct.size(), 9u);
+    EXPECT_EQ(sendcmpct[0], 1);
+    EXPECT_EQ(sendcmpct[1], 2);
+
+    std::vector<Hash256> locator(3);
+    locator[1][0] = 0xAB;
+    auto getheaders = build_getheaders_payload(locator);
+    EXPECT_EQ(getheaders.size(), 4u + 1 + 4 * 32);
+    EXPECT_EQ(getheaders[4], 3);
+    EXPECT_EQ(getheaders[5 + 32], 0xAB);
+
+    const auto params = easy_params();
+    auto chain = mine_headers(params, Hash256{}, 3);
+    auto headers = parse_headers_payload(headers_payload(chain));
+    ASSERT_TRUE(headers.has_value());
+    ASSERT_EQ(headers->size(), 3u);
+    EXPECT_EQ((*headers)[2].hash(), chain[2].hash());
+
+    auto truncated = headers_payload(chain);
+    truncated.pop_back();
+    EXPECT_FALSE(parse_headers_payload(truncated).has_value());
+
+    auto header = parse_cmpctblock_header(cmpctblock_payload(chain[1]));
+    ASSERT_TRUE(header.has_value());
+    EXPECT_EQ(header->hash(), chain[1].hash());
+
+    serialization::WriteStream inv;
+    inv.write_varint(2);
+    inv.write_u32_le(1);  // MSG_TX
+    inv.write_hash256(Hash256{});
+    inv.write_u32_le(0x40000002);  // MSG_WITNESS_BLOCK
+    inv.write_hash256(Hash256{});
+    EXPECT_TRUE(inv_announces_block(inv.data()));
+    EXPECT_FALSE(inv_announces_block(ByteSpan(inv.data().data(), 1 + 36)));
+}
+
+// =============================================================================
+// Peer на loopback
+// =============================================================================
+
+TEST(P2pPeerTest, CompactBlockFiresNewBlockFromReceiveThread) {
+    const auto params = easy_params();
+    FakePeer fake(params.mainnet.magic);
+
+    HeadersSync sync(params, 1);
+    auto chain = mine_headers(params, sync.get_tip_hash(), 3);
+
+    std::mutex mutex;
+    std::vector<uint32_t> heights;
+    std::thread::id callback_thread;
+    sync.on_new_block([&](const BlockHeader&, uint32_t height) {
+        std::lock_guard<std::mutex> lock(mutex);
+        heights.push_back(height);
+        callback_thread = std::this_thread::get_id();
+    });
+    auto received = [&] {
+        std::lock_guard<std::mutex> lock(mutex);
+        return heights.size();
+    };
+
+    sync.add_peer({"127.0.0.1", fake.port()});
+    sync.start();
+    EXPECT_EQ(sync.status(), SyncStatus::Connecting);
+
+    fake.accept();
+    (void)fake.read_until("version");
+    fake.send("version", build_version_payload(3, 1, 1700000000));
+    fake.send("verack");
+
+    // Handshake: sendheaders и high-bandwidth sendcmpct до getheaders
+    auto getheaders = fake.read_until("getheaders");
+    ASSERT_FALSE(getheaders.empty());
+    EXPECT_NE(std::find(fake.seen.begin(), fake.seen.end(), "verack"), fake.seen.end());
+    EXPECT_NE(std::find(fake.seen.begin(), fake.seen.end(), "sendheaders"), fake.seen.end());
+    EXPECT_NE(std::find(fake.seen.begin(), fake.seen.end(), "sendcmpct"), fake.seen.end());
+    EXPECT_EQ(sync.connected_peers(), 1u);
+
+    fake.send("headers", headers_payload(std::span(chain).first(2)));
+    ASSERT_TRUE(wait_for([&] { return sync.is_synchronized(); }));
+    EXPECT_EQ(sync.get_tip_height(), 2u);
+
+    // Новый блок объявлен cmpctblock; повтор заголовком не дублирует callback
+    fake.send("cmpctblock", cmpctblock_payload(chain[2]));
+    fake.send("headers", headers_payload(std::span(chain).subspan(2)));
+    fake.send("ping", Bytes{1, 2, 3, 4, 5, 6, 7, 8});
+    auto pong = fake.read_until("pong");
+    EXPECT_EQ(pong, (Bytes{1, 2, 3, 4, 5, 6, 7, 8}));
+
+    ASSERT_TRUE(wait_for([&] { return received() == 3; }));
+    EXPECT_EQ(sync.get_tip_hash(), chain[2].hash());
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        EXPECT_EQ(heights, (std::vector<uint32_t>{1, 2, 3}));
+        EXPECT_NE(callback_thread, std::this_thread::get_id());
+    }
+
+    sync.stop();
+    EXPECT_EQ(sync.status(), SyncStatus::Stopped);
+}
+
+TEST(P2pPeerTest, StartWithoutPeersWaitsForExternalHeaders) {
+    const auto params = easy_params();
+    HeadersSync sync(params, 1);
+    sync.start();
+    EXPECT_EQ(sync.status(), SyncStatus::Syncing);
+    EXPECT_EQ(sync.connected_peers(), 0u);
+    sync.stop();
+}
+
+} // namespace quaxis::core::sync::test
@@ -0,0 +1,214 @@
+/**
+ * @file test_serialization.cpp
+ * @brief Тесты для потоков сериализации без кучи и чтения JSON
+ */
+
+#include <gtest/gtest.h>
+
+#include "core/serialization/stream.hpp"
+#include "core/serialization/json.hpp"
+#include "core/primitives/auxpow.hpp"
+
+#include <string>
+#include <vector>
+
+namespace quaxis::core::test {
+
+using serialization::FixedWriteStream;
+using serialization::SpanReadStream;
+using serialization::StreamError;
+using serialization::WriteStream;
+using serialization::serialized_size_v;
+
+namespace {
+
+AuxPow make_auxpow() {
+    AuxPow auxpow;
+    auxpow.coinbase_tx = {0x01, 0x00, 0x00, 0x00, 0xfa, 0xbe, 0x6d, 0x6d};
+    auxpow.coinbase_hash[0] = 0xAA;
+    for (uint8_t i = 0; i < 3; ++i) {
+        Hash256 hash{};
+        hash[0] = i;
+        auxpow.coinbase_branch.hashes.push_back(hash);
+    }
+    auxpow.coinbase_branch.index = 5;
+    auxpow.aux_branch.hashes.push_back(Hash256{0xBB});
+    auxpow.aux_branch.index = 1;
+    auxpow.parent_header.version = 0x20000000;
+    auxpow.parent_header.bits = 0x1d00ffff;
+    auxpow.parent_header.nonce = 42;
+    return auxpow;
+}
+
+} // namespace
+
+// =============================================================================
+// Тесты потоков
+// =============================================================================
+
+TEST(SerializationTest, SizeBoundsAreCompileTime) {
+    static_assert(serialized_size_v<BlockHeader> == BLOCK_HEADER_SIZE);
+    static_assert(serialized_size_v<MerkleBranch> == 1 + MAX_AUXPOW_MERKLE_DEPTH * 32 + 4);
+    static_assert(serialized_size_v<AuxPow> ==
+                  2 + MAX_AUXPOW_COINBASE_SIZE + 32 + 2 * serialized_size_v<MerkleBranch> + 80);
+    SUCCEED();
+}
+
+TEST(SerializationTest, FixedStreamMatchesWriteStream) {
+    FixedWriteStream<64> fixed;
+    WriteStream dynamic;
+    
+    fixed.write_u8(0x7f);
+    dynamic.write_u8(0x7f);
+    fixed.write_u32_le(0xdeadbeef);
+    dynamic.write_u32_le(0xdeadbeef);
+    fixed.write_u64_le(0x0102030405060708ULL);
+    dynamic.write_u64_le(0x0102030405060708ULL);
+    fixed.write_varint(0x12345);
+    dynamic.write_varint(0x12345);
+    fixed.write_string("quaxis");
+    dynamic.write_string("quaxis");
+    
+    ASSERT_EQ(fixed.size(), dynamic.size());
+    EXPECT_TRUE(std::equal(fixed.data().begin(), fixed.data().end(), dynamic.data().begin()));
+}
+
+TEST(SerializationTest, FixedStreamOverflowThrows) {
+    FixedWriteStream<4> stream;
+    stream.write_u32_le(1);
+    EXPECT_THROW(stream.write_u8(0), StreamError);
+    EXPECT_EQ(stream.size(), 4u);
+}
+
+TEST(SerializationTest, SpanReadStreamReturnsViews) {
+    Bytes data = {0x03, 0x00, 0xAA, 0xBB, 0xCC};
+    SpanReadStream in(data);
+    
+    EXPECT_EQ(in.read_u16_le(), 3u);
+    ByteSpan view = in.read_span(3);
+    EXPECT_EQ(view.data(), data.data() + 2);
+    EXPECT_TRUE(in.eof());
+    EXPECT_THROW((void)in.read_u8(), StreamError);
+}
+
+// =============================================================================
+// Тесты AuxPow
+// =============================================================================
+
+TEST(SerializationTest, AuxPowFixedStreamMatchesSerialize) {
+    AuxPow auxpow = make_auxpow();
+    
+    FixedWriteStream<serialized_size_v<AuxPow>> out;
+    auxpow.write_to(out);
+    
+    Bytes bytes = auxpow.serialize();
+    ASSERT_EQ(out.size(), bytes.size());
+    EXPECT_EQ(out.size(), auxpow.serialized_length());
+    EXPECT_TRUE(std::equal(out.data().begin(), out.data().end(), bytes.begin()));
+}
+
+TEST(SerializationTest, AuxPowRoundTrip) {
+    AuxPow auxpow = make_auxpow();
+    
+    auto parsed = AuxPow::deserialize(auxpow.serialize());
+    ASSERT_TRUE(parsed.has_value());
+    EXPECT_EQ(parsed->coinbase_tx, auxpow.coinbase_tx);
+    EXPECT_EQ(parsed->coinbase_hash, auxpow.coinbase_hash);
+    EXPECT_EQ(parsed->coinbase_branch.hashes, auxpow.coinbase_branch.hashes);
+    EXPECT_EQ(parsed->coinbase_branch.index, 5u);
+    EXPECT_EQ(parsed->aux_branch.hashes, auxpow.aux_branch.hashes);
+    EXPECT_EQ(parsed->parent_header.nonce, 42u);
+    EXPECT_EQ(parsed->get_parent_hash(), auxpow.get_parent_hash());
+}
+
+TEST(SerializationTest, AuxPowTruncatedIsRejected) {
+    Bytes bytes = make_auxpow().serialize();
+    bytes.pop_back();
+    
+    EXPECT_FALSE(AuxPow::deserialize(bytes).has_value());
+}
+
+// =============================================================================
+// JSON по требованию
+// =============================================================================
+
+TEST(JsonTest, CreateAuxBlockResponse) {
+    const std::string response = R"({"result": {"hash": "ab01", "chainid": 1,
+        "bits": "207fffff", "height": 42, "coinbasevalue": 5000000000,
+        "_target": "00ff", "flag": true}, "error": null, "id": 1})";
+    
+    auto doc = json::Value::parse(response);
+    ASSERT_EQ(doc.type(), json::Type::Object);
+    auto result = doc["result"];
+    EXPECT_EQ(result["hash"].as_string(), "ab01");
+    EXPECT_EQ(result["bits"].as_string(), "207fffff");
+    EXPECT_EQ(result["height"].as_uint64(), 42u);
+    EXPECT_EQ(result["coinbasevalue"].as_int64(), 5000000000);
+    EXPECT_EQ(result["flag"].as_bool(), true);
+    EXPECT_TRUE(doc["error"].is_null());
+    
+    // Отсутствующие члены и неверный тип - без значения
+    EXPECT_FALSE(result["missing"]);
+    EXPECT_FALSE(doc["result"]["hash"]["deeper"]);
+    EXPECT_FALSE(result["height"].as_string());
+    
+    // Строки указывают в исходный буфер
+    auto hash = *result["hash"].as_string();
+    EXPECT_GE(hash.data(), response.data());
+    EXPECT_LT(hash.data(), response.data() + response.size());
+}
+
+TEST(JsonTest, NestedValuesAreSkipped) {
+    // Ключ "hash" внутри вложенных значений и строк не должен совпасть
+    const std::string text = R"({"transactions": [{"hash": "inner", "data": "x\"hash\"y"}],
+        "note": "{\"hash\": 1}", "hash": "outer"})";
+    
+    auto doc = json::Value::parse(text);
+    EXPECT_EQ(doc["hash"].as_string(), "outer");
+    EXPECT_EQ(doc["transactions"][std::size_t{0}]["hash"].as_string(), "inner");
+    EXPECT_EQ(doc["transactions"][std::size_t{0}]["data"].as_string(), R"(x\"hash\"y)");
+    EXPECT_FALSE(doc["transactions"][std::size_t{1}]);
+}
+
+TEST(JsonTest, StratumNotifyParams) {
+    const std::string line = R"({"id":null,"method":"mining.notify","params":["job1","prev",)"
+                             R"("cb1","cb2",["b1","b2"],"20000000","1d00ffff","5e9a5b00",true]})";
+    
+    auto doc = json::Value::parse(line);
+    EXPECT_EQ(doc["method"].as_string(), "mining.notify");
+    EXPECT_TRUE(doc["id"].is_null());
+    
+    std::vector<std::string_view> fields;
+    for (const auto& param : doc["params"].elements()) {
+        fields.push_back(param.raw());
+    }
+    ASSERT_EQ(fields.size(), 9u);
+    EXPECT_EQ(fields[0], R"("job1")");
+    EXPECT_EQ(fields[4], R"(["b1","b2"])");
+    EXPECT_EQ(fields[8], "true");
+    
+    std::vector<std::string_view> branch;
+    for (const auto& hash : doc["params"][std::size_t{4}].elements()) {
+        branch.push_back(*hash.as_string());
+    }
+    EXPECT_EQ(branch, (std::vector<std::string_view>{"b1", "b2"}));
+}
+
+TEST(JsonTest, MembersAndMalformed) {
+    auto doc = json::Value::parse(R"( {"a": 1.5, "b": [], "c": {}} )");
+    std::vector<std::string_view> keys;
+    for (const auto& member : doc.members()) {
+        keys.push_back(member.key);
+    }
+    EXPECT_EQ(keys, (std::vector<std::string_view>{"a", "b", "c"}));
+    EXPECT_DOUBLE_EQ(*doc["a"].as_double(), 1.5);
+    EXPECT_EQ(doc["b"].elements().begin(), doc["b"].elements().end());
+    
+    // Незакрытые значения - Invalid
+    EXPECT_FALSE(json::Value::parse(R"({"a": [1, 2)"));
+    EXPECT_FALSE(json::Value::parse(R"("open)"));
+    EXPECT_FALSE(json::Value::parse(""));
+    EXPECT_FALSE(json::Value::parse(R"({"a": "x)")["a"]);
+}
+
+} // namespace quaxis::core::test
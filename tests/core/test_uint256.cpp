@@ -0,0 +1,146 @@
+/**
+ * @file test_uint256.cpp
+ * @brief Тесты для 256-битной арифметики и пересчёта сложности
+ */
+
+#include <gtest/gtest.h>
+
+#include "core/primitives/uint256.hpp"
+#include "core/primitives/block_header.hpp"
+#include "core/chain/chain_registry.hpp"
+#include "core/validation/pow_validator.hpp"
+
+#include <random>
+
+namespace quaxis::core::test {
+
+// =============================================================================
+// Вычисление при компиляции
+// =============================================================================
+
+static_assert(bits_to_target(0x1d00ffff) == uint256{uint64_t{0xffff}} << 208);
+static_assert(target_to_bits(bits_to_target(0x1d00ffff)) == 0x1d00ffff);
+static_assert(block_work(0x1d00ffff) == uint256{uint64_t{0x100010001}});
+static_assert(DifficultyParams{}.pow_limit() == bits_to_target(0x1d00ffff));
+static_assert((uint256::max() + uint256::one()).is_zero());
+static_assert(uint256::max() / uint256::max() == uint256::one());
+static_assert((uint256{uint64_t{1}} << 255).bits() == 256);
+
+namespace {
+
+uint256 random_uint256(std::mt19937_64& rng, unsigned bits) {
+    auto value = uint256::from_limbs({rng(), rng(), rng(), rng()});
+    return bits >= 256 ? value : value >> (256 - bits);
+}
+
+} // anonymous namespace
+
+// =============================================================================
+// Арифметика
+// =============================================================================
+
+TEST(Uint256Test, BytesMatchLimbs) {
+    Hash256 hash{};
+    for (std::size_t i = 0; i < hash.size(); ++i) {
+        hash[i] = static_cast<uint8_t>(i + 1);
+    }
+    uint256 value{hash};
+    
+    EXPECT_EQ(value.limb(0), 0x0807060504030201ULL);
+    EXPECT_EQ(value[31], 32);
+    EXPECT_EQ(value.to_hash256(), hash);
+    EXPECT_EQ(value.data()[8], 9);
+    EXPECT_EQ(uint256::from_hex(value.to_hex()), value);
+}
+
+TEST(Uint256Test, CompareUsesMostSignificantLimb) {
+    auto high = uint256{uint64_t{1}} << 192;
+    auto low = uint256{UINT64_MAX};
+    
+    EXPECT_LT(low, high);
+    EXPECT_GT(high, low);
+    EXPECT_EQ(high <=> high, std::strong_ordering::equal);
+}
+
+TEST(Uint256Test, CarryAndBorrowPropagate) {
+    auto value = uint256{UINT64_MAX};
+    value += uint256::one();
+    EXPECT_EQ(value, uint256{uint64_t{1}} << 64);
+    
+    value -= uint256::one();
+    EXPECT_EQ(value, uint256{UINT64_MAX});
+    
+    EXPECT_EQ(uint256::zero() - uint256::one(), uint256::max());
+}
+
+TEST(Uint256Test, ShiftsCrossLimbs) {
+    auto value = uint256{0x8000000000000001ULL};
+    EXPECT_EQ((value << 1).limb(1), 1u);
+    EXPECT_EQ((value << 1).limb(0), 2u);
+    EXPECT_EQ((value << 192) >> 192, value);
+    EXPECT_EQ((value << 193) >> 193, uint256::one());  // бит 63 ушёл за 256
+    EXPECT_TRUE((value << 256).is_zero());
+    EXPECT_EQ((uint256::max() >> 255), uint256::one());
+}
+
+TEST(Uint256Test, DivisionInvertsMultiplication) {
+    std::mt19937_64 rng(47);
+    
+    for (int i = 0; i < 200; ++i) {
+        const auto a = random_uint256(rng, 64 + static_cast<unsigned>(rng() % 193));
+        const auto b = random_uint256(rng, 1 + static_cast<unsigned>(rng() % 200));
+        if (b.is_zero()) {
+            continue;
+        }
+        
+        uint256 remainder;
+        auto quotient = a;
+        quotient.divide(b, remainder);
+        
+        EXPECT_LT(remainder, b);
+        EXPECT_EQ(quotient * b + remainder, a) << "a=" << a.to_hex() << " b=" << b.to_hex();
+    }
+}
+
+TEST(Uint256Test, DivideBySmallWord) {
+    auto value = uint256{uint64_t{1}} << 200;
+    uint64_t remainder = 0;
+    value.divide(uint64_t{3}, remainder);
+    
+    EXPECT_EQ(remainder, 1u);  // 2^200 = 3 * q + 1
+    EXPECT_EQ(value * uint64_t{3} + uint256::one(), uint256{uint64_t{1}} << 200);
+    EXPECT_TRUE((uint256::max() / uint256::zero()).is_zero());
+}
+
+// =============================================================================
+// Compact bits и пересчёт сложности
+// =============================================================================
+
+TEST(Uint256Test, CompactRoundTrip) {
+    for (uint32_t bits : {0x1d00ffffu, 0x1b0404cbu, 0x207fffffu, 0x170331dbu, 0x03123456u}) {
+        EXPECT_EQ(target_to_bits(bits_to_target(bits)), bits) << std::hex << bits;
+    }
+    EXPECT_TRUE(bits_to_target(0x04923456).is_zero());  // отрицательный
+    EXPECT_TRUE(bits_to_target(0xff123456).is_zero());  // за пределами 256 бит
+}
+
+TEST(Uint256Test, DifficultyFromTarget) {
+    EXPECT_DOUBLE_EQ(bits_to_difficulty(0x1d00ffff), 1.0);
+    EXPECT_NEAR(bits_to_difficulty(0x1b0404cb), 16307.420938523983, 1e-6);
+}
+
+TEST(Uint256Test, RetargetMatchesBitcoin) {
+    const auto* params = ChainRegistry::instance().get_by_name("bitcoin");
+    ASSERT_NE(params, nullptr);
+    validation::PowValidator validator(*params);
+    
+    // Блок 32256: первый пересчёт после genesis сложности
+    EXPECT_EQ(validator.calculate_next_target(0x1d00ffff, 1262152739 - 1261130161), 0x1d00d86au);
+    // Не выше pow limit
+    EXPECT_EQ(validator.calculate_next_target(0x1d00ffff, 1233061996 - 1231006505), 0x1d00ffffu);
+    // Ограничение timespan снизу (x1/4) и сверху (x4)
+    EXPECT_EQ(validator.calculate_next_target(0x1c05a3f4, 1279297671 - 1279008237), 0x1c0168fdu);
+    EXPECT_EQ(validator.calculate_next_target(0x1c387f6f, 1269211443 - 1263163443), 0x1d00e1fdu);
+}
+
+} // namespace quaxis::core::test
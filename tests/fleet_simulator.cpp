@@ -0,0 +1,795 @@
+/**
+ * @file fleet_simulator.cpp
+ * @brief Симулятор парка ASIC и генератор нагрузки на network::Server
+ *
+ * Тысячи эмулированных контроллеров Avalon говорят с сервером бинарным
+ * протоколом: получают задания, перебирают nonce (SHA-NI, если есть) и
+ * отправляют shares, которые проходят проверку на заданной сложности.
+ * Дополнительно:
+ * - задержка канала: кадры в обе стороны применяются через --latency-ms
+ * - штормы переподключений: каждые --storm-interval-s секунд доля
+ *   --storm-fraction ASIC рвёт соединение и сразу подключается снова
+ *
+ * Отчёт:
+ * 1. Разброс рассылки задания: первый -> последний ASIC на каждом блоке
+ * 2. Время от переподключения до первого задания
+ * 3. Латентность share: отправка ASIC -> проверка сервером
+ * 4. CPU сервера за прогон
+ *
+ * По умолчанию сервер, JobManager и ShareValidator поднимаются в этом же
+ * процессе, блоки - синтетический шаблон каждые --block-interval-ms.
+ * С --connect host:port нагрузка идёт на внешний сервер (его partial
+ * difficulty должна совпадать с --difficulty), CPU берётся из
+ * /proc/<--server-pid>/stat. В протоколе нет подтверждения share, поэтому
+ * латентность share измеряется только во встроенном режиме - по
+ * share callback сервера.
+ *
+ * Запуск: fleet_simulator [--asics N] [--threads N] [--duration S]
+ *         [--difficulty D] [--latency-ms MS] [--storm-interval-s S]
+ *         [--storm-fraction F] [--block-interval-ms MS] [--engine E] [--port P]
+ *         [--connect HOST:PORT] [--server-pid PID]
+ */
+
+#include <iostream>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <array>
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <random>
+#include <algorithm>
+#include <unordered_map>
+#include <optional>
+#include <memory>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <cstring>
+#include <ctime>
+#include <iomanip>
+
+#include <sys/socket.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+#include "network/server.hpp"
+#include "network/protocol.hpp"
+#include "mining/job_manager.hpp"
+#include "mining/share_validator.hpp"
+#include "bitcoin/coinbase.hpp"
+#include "bitcoin/target.hpp"
+#include "crypto/sha256.hpp"
+#include "core/byte_order.hpp"
+
+namespace quaxis::benchmark {
+
+using Clock = std::chrono::steady_clock;
+
+/// @brief Nonce на один ASIC за проход потока (чередование ASIC потока)
+constexpr uint32_t HASHES_PER_SLICE = 64;
+
+/// @brief Кадры заданий одного блока, пришедшие в пределах окна
+constexpr auto BURST_WINDOW = std::chrono::milliseconds(500);
+
+/**
+ * @brief Параметры прогона
+ */
+struct Options {
+    std::size_t asics = 1000;
+    std::size_t threads = 4;
+    int duration_s = 10;
+    double difficulty = 1e-6;
+    int latency_ms = 0;
+    int storm_interval_s = 0;
+    double storm_fraction = 0.1;
+    int block_interval_ms = 2000;
+    uint16_t port = 43460;
+    std::string engine = "epoll";
+    std::string connect_host;
+    int server_pid = 0;
+};
+
+/**
+ * @brief Кадр или share, ждущий задержки канала
+ */
+struct Delayed {
+    Clock::time_point due;
+    Bytes frame;
+};
+
+/**
+ * @brief Текущая работа эмулированного ASIC
+ */
+struct SimJob {
+    uint32_t job_id = 0;
+    crypto::Sha256State midstate{};
+    std::array<uint8_t, 16> tail{};  ///< merkle[28:32] + timestamp + bits + nonce
+    uint32_t nonce = 0;
+};
+
+/**
+ * @brief Эмулированный контроллер Avalon
+ */
+struct SimAsic {
+    int fd = -1;
+    Bytes inbox;
+    std::deque<Delayed> incoming;  ///< Кадры сервера, ещё «в пути»
+    std::deque<Delayed> outgoing;  ///< Shares, ещё «в пути»
+    std::optional<SimJob> job;
+    Clock::time_point connected_at{};
+    bool awaiting_first_job = true;
+};
+
+/**
+ * @brief Замеры одного потока клиентов
+ */
+struct WorkerStats {
+    std::vector<Clock::time_point> job_receipts;  ///< Кадры заданий, кроме первого после подключения
+    std::vector<double> first_job_ms;             ///< Подключение -> первое задание
+    uint64_t shares_sent = 0;
+    uint64_t hashes = 0;
+    uint64_t reconnects = 0;
+    uint64_t failed_connects = 0;
+    double cpu_seconds = 0.0;
+};
+
+/**
+ * @brief Время отправки shares для латентности до сервера
+ */
+class AckTracker {
+public:
+    void sent(uint32_t job_id, uint32_t nonce, Clock::time_point at) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_[key(job_id, nonce)] = at;
+    }
+
+    void received(uint32_t job_id, uint32_t nonce, Clock::time_point at) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = pending_.find(key(job_id, nonce));
+        if (it == pending_.end()) {
+            return;
+        }
+        latencies_ms_.push_back(std::chrono::duration<double, std::milli>(at - it->second).count());
+        pending_.erase(it);
+    }
+
+    [[nodiscard]] std::vector<double> latencies_ms() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return latencies_ms_;
+    }
+
+private:
+    static uint64_t key(uint32_t job_id, uint32_t nonce) noexcept {
+        return (static_cast<uint64_t>(job_id) << 32) | nonce;
+    }
+
+    std::mutex mutex_;
+    std::unordered_map<uint64_t, Clock::time_point> pending_;
+    std::vector<double> latencies_ms_;
+};
+
+/**
+ * @brief Поднять лимит файловых дескрипторов до жёсткого
+ */
+void raise_fd_limit() {
+    struct rlimit lim;
+    if (getrlimit(RLIMIT_NOFILE, &lim) == 0) {
+        lim.rlim_cur = lim.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &lim);
+    }
+}
+
+/**
+ * @brief Подключиться к серверу (неблокирующий сокет после connect)
+ */
+int connect_client(const std::string& host, uint16_t port) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return -1;
+    }
+
+    struct sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    if (inet_pton(AF_INET, host.c_str(), &addr.sin_addr) != 1 ||
+        connect(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0) {
+        close(fd);
+        return -1;
+    }
+
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    int flags = fcntl(fd, F_GETFL, 0);
+    fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+    return fd;
+}
+
+/**
+ * @brief Длина кадра команды сервера в начале буфера
+ *
+ * @return 0 - кадр ещё не пришёл целиком; nullopt - неизвестная команда
+ */
+std::optional<std::size_t> command_frame_size(ByteSpan data) {
+    using network::Command;
+    std::size_t size = 0;
+    switch (static_cast<Command>(data[0])) {
+        case Command::NewJob:
+        case Command::QueueJob:
+            size = network::NEW_JOB_FRAME_SIZE;
+            break;
+        case Command::Stop:
+        case Command::Heartbeat:
+            size = 1;
+            break;
+        case Command::SetTarget:
+            size = 1 + 32;
+            break;
+        case Command::SetDifficulty:
+            size = network::SET_DIFFICULTY_FRAME_SIZE;
+            break;
+        case Command::SetShareBatch:
+            size = network::SET_SHARE_BATCH_FRAME_SIZE;
+            break;
+        case Command::NewJobSlots:
+            if (data.size() < 2) {
+                return 0;
+            }
+            size = network::NEW_JOB_SLOTS_HEADER_SIZE + data[1] * network::NEW_JOB_SLOT_SIZE;
+            break;
+        case Command::NewJobLease:
+            size = network::NEW_JOB_LEASE_FRAME_SIZE;
+            break;
+        case Command::NewJobRoll:
+            size = network::NEW_JOB_ROLL_FRAME_SIZE;
+            break;
+        case Command::UpdateTime:
+            size = network::UPDATE_TIME_FRAME_SIZE;
+            break;
+        case Command::SetSession:
+            size = network::SET_SESSION_FRAME_SIZE;
+            break;
+        default:
+            return std::nullopt;
+    }
+    return data.size() >= size ? size : 0;
+}
+
+/**
+ * @brief Кадр - новое задание (текущее, не очередь)
+ */
+bool is_job_frame(ByteSpan frame) noexcept {
+    auto command = static_cast<network::Command>(frame[0]);
+    return command == network::Command::NewJob || command == network::Command::NewJobSlots ||
+           command == network::Command::NewJobLease || command == network::Command::NewJobRoll;
+}
+
+/**
+ * @brief Поток клиентов: свой epoll и своя часть парка
+ */
+class Worker {
+public:
+    Worker(const Options& options, std::size_t count, uint64_t seed,
+           const std::atomic<bool>& running, const std::atomic<uint64_t>& storms,
+           AckTracker* acks)
+        : options_(options)
+        , asics_(count)
+        , running_(running)
+        , storms_(storms)
+        , acks_(acks)
+        , rng_(seed)
+        , target_(bitcoin::difficulty_to_target(options.difficulty)) {}
+
+    void run() {
+        epoll_fd_ = epoll_create1(0);
+        for (std::size_t i = 0; i < asics_.size(); ++i) {
+            connect_asic(i);
+        }
+
+        timespec cpu_start{};
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu_start);
+        uint64_t storms_seen = storms_.load(std::memory_order_relaxed);
+
+        std::array<struct epoll_event, 256> events;
+        while (running_.load(std::memory_order_relaxed)) {
+            uint64_t storms = storms_.load(std::memory_order_relaxed);
+            if (storms != storms_seen) {
+                storms_seen = storms;
+                storm();
+            }
+
+            bool mining = std::any_of(asics_.begin(), asics_.end(), [](const SimAsic& a) { return a.job.has_value(); });
+            int n = epoll_wait(epoll_fd_, events.data(), static_cast<int>(events.size()), mining ? 0 : 1);
+            auto now = Clock::now();
+            for (int i = 0; i < n; ++i) {
+                receive(static_cast<std::size_t>(events[i].data.u64), now);
+            }
+
+            for (std::size_t i = 0; i < asics_.size(); ++i) {
+                deliver(i, now);
+                mine(asics_[i], now);
+            }
+        }
+
+        timespec cpu_end{};
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu_end);
+        stats_.cpu_seconds = static_cast<double>(cpu_end.tv_sec - cpu_start.tv_sec) +
+                             static_cast<double>(cpu_end.tv_nsec - cpu_start.tv_nsec) / 1e9;
+
+        for (auto& asic : asics_) {
+            if (asic.fd >= 0) {
+                close(asic.fd);
+            }
+        }
+        close(epoll_fd_);
+    }
+
+    [[nodiscard]] const WorkerStats& stats() const noexcept { return stats_; }
+
+private:
+    void connect_asic(std::size_t index) {
+        SimAsic& asic = asics_[index];
+        asic = SimAsic{};
+        asic.connected_at = Clock::now();
+        asic.fd = connect_client(options_.connect_host, options_.port);
+        if (asic.fd < 0) {
+            stats_.failed_connects++;
+            return;
+        }
+
+        struct epoll_event ev{};
+        ev.events = EPOLLIN | EPOLLET;
+        ev.data.u64 = index;
+        epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, asic.fd, &ev);
+    }
+
+    /// @brief Доля ASIC потока рвёт соединение и подключается заново
+    void storm() {
+        std::bernoulli_distribution hit(options_.storm_fraction);
+        for (std::size_t i = 0; i < asics_.size(); ++i) {
+            if (!hit(rng_)) {
+                continue;
+            }
+            if (asics_[i].fd >= 0) {
+                close(asics_[i].fd);  // close снимает fd с epoll
+            }
+            connect_asic(i);
+            stats_.reconnects++;
+        }
+    }
+
+    /// @brief Прочитать сокет и нарезать кадры (edge-triggered: до EAGAIN)
+    void receive(std::size_t index, Clock::time_point now) {
+        SimAsic& asic = asics_[index];
+        std::array<uint8_t, 4096> buffer;
+        for (;;) {
+            ssize_t r = recv(asic.fd, buffer.data(), buffer.size(), 0);
+            if (r <= 0) {
+                break;
+            }
+            asic.inbox.insert(asic.inbox.end(), buffer.data(), buffer.data() + r);
+        }
+
+        std::size_t offset = 0;
+        while (offset < asic.inbox.size()) {
+            ByteSpan rest(asic.inbox.data() + offset, asic.inbox.size() - offset);
+            auto size = command_frame_size(rest);
+            if (!size) {
+                asic.inbox.clear();  // Рассинхронизация потока: кадры до переподключения теряются
+                return;
+            }
+            if (*size == 0) {
+                break;
+            }
+
+            Bytes frame(rest.begin(), rest.begin() + static_cast<std::ptrdiff_t>(*size));
+            if (is_job_frame(frame)) {
+                if (asic.awaiting_first_job) {
+                    asic.awaiting_first_job = false;
+                    stats_.first_job_ms.push_back(
+                        std::chrono::duration<double, std::milli>(now - asic.connected_at).count());
+                } else {
+                    stats_.job_receipts.push_back(now);
+                }
+            }
+            asic.incoming.push_back({now + std::chrono::milliseconds(options_.latency_ms), std::move(frame)});
+            offset += *size;
+        }
+        asic.inbox.erase(asic.inbox.begin(), asic.inbox.begin() + static_cast<std::ptrdiff_t>(offset));
+    }
+
+    /// @brief Применить дошедшие кадры сервера и отправить дошедшие shares
+    void deliver(std::size_t index, Clock::time_point now) {
+        SimAsic& asic = asics_[index];
+        while (!asic.incoming.empty() && asic.incoming.front().due <= now) {
+            apply(asic, asic.incoming.front().frame);
+            asic.incoming.pop_front();
+        }
+        while (!asic.outgoing.empty() && asic.outgoing.front().due <= now) {
+            const Bytes& frame = asic.outgoing.front().frame;
+            if (acks_) {
+                acks_->sent(read_le32(frame.data() + 1), read_le32(frame.data() + 5), now);
+            }
+            [[maybe_unused]] auto n = send(asic.fd, frame.data(), frame.size(), MSG_NOSIGNAL);
+            stats_.shares_sent++;
+            asic.outgoing.pop_front();
+        }
+    }
+
+    /// @brief Кадр сервера дошёл до ASIC
+    static void apply(SimAsic& asic, const Bytes& frame) {
+        ByteSpan payload(frame.data() + 1, frame.size() - 1);
+        switch (static_cast<network::Command>(frame[0])) {
+            case network::Command::NewJob:
+                if (auto msg = network::NewJobMessage::deserialize(payload)) {
+                    // merkle_tail в простом задании не передаётся - как прошивка, хешируем с нулями
+                    start_job(asic, msg->job, msg->job.midstate);
+                }
+                break;
+            case network::Command::NewJobSlots:
+                if (auto msg = network::NewJobMessage::deserialize_slots(payload)) {
+                    start_job(asic, msg->job, msg->job.version_midstates[0]);
+                }
+                break;
+            case network::Command::NewJobLease:
+            case network::Command::NewJobRoll:
+                asic.job.reset();  // Сборку заголовка на ASIC симулятор не эмулирует
+                break;
+            case network::Command::UpdateTime:
+                if (asic.job && read_le32(payload.data()) == asic.job->job_id) {
+                    std::memcpy(asic.job->tail.data() + 4, payload.data() + 4, 4);
+                    if (payload[8] & network::UPDATE_TIME_FLAG_NONCE) {
+                        asic.job->nonce = read_le32(payload.data() + 9);
+                    }
+                }
+                break;
+            case network::Command::Stop:
+                asic.job.reset();
+                break;
+            default:
+                break;  // Сложность и пакеты shares: shares всегда по одному, на --difficulty
+        }
+    }
+
+    static void start_job(SimAsic& asic, const mining::Job& job, const crypto::Sha256State& midstate) {
+        SimJob sim;
+        sim.job_id = job.job_id;
+        sim.midstate = midstate;
+        std::memcpy(sim.tail.data(), job.merkle_tail.data(), job.merkle_tail.size());
+        write_le32(sim.tail.data() + 4, job.timestamp);
+        write_le32(sim.tail.data() + 8, job.bits);
+        sim.nonce = job.nonce;
+        asic.job = sim;
+    }
+
+    /// @brief Перебрать кусок nonce текущего задания
+    void mine(SimAsic& asic, Clock::time_point now) {
+        if (!asic.job || asic.fd < 0) {
+            return;
+        }
+        SimJob& job = *asic.job;
+        for (uint32_t i = 0; i < HASHES_PER_SLICE; ++i) {
+            uint32_t nonce = job.nonce++;
+            write_le32(job.tail.data() + 12, nonce);
+            Hash256 hash = crypto::hash_header_with_midstate(job.midstate, std::span<const uint8_t, 16>(job.tail));
+            if (bitcoin::meets_target(hash, target_)) {
+                network::ShareMessage msg{mining::Share{job.job_id, nonce}};
+                asic.outgoing.push_back({now + std::chrono::milliseconds(options_.latency_ms), msg.serialize()});
+            }
+        }
+        stats_.hashes += HASHES_PER_SLICE;
+    }
+
+    const Options& options_;
+    std::vector<SimAsic> asics_;
+    const std::atomic<bool>& running_;
+    const std::atomic<uint64_t>& storms_;
+    AckTracker* acks_;
+    std::mt19937_64 rng_;
+    bitcoin::Target256 target_;
+    int epoll_fd_ = -1;
+    WorkerStats stats_;
+};
+
+/**
+ * @brief CPU процесса (встроенный сервер) в секундах
+ */
+double process_cpu_seconds() {
+    struct rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    auto seconds = [](const timeval& tv) {
+        return static_cast<double>(tv.tv_sec) + static_cast<double>(tv.tv_usec) / 1e6;
+    };
+    return seconds(usage.ru_utime) + seconds(usage.ru_stime);
+}
+
+/**
+ * @brief CPU внешнего процесса (utime + stime из /proc/<pid>/stat)
+ */
+double pid_cpu_seconds(int pid) {
+    std::ifstream stat("/proc/" + std::to_string(pid) + "/stat");
+    std::string content((std::istreambuf_iterator<char>(stat)), std::istreambuf_iterator<char>());
+    auto close_paren = content.rfind(')');
+    if (close_paren == std::string::npos) {
+        return 0.0;
+    }
+    // После ")": state(3) ... utime(14) stime(15)
+    std::istringstream fields(content.substr(close_paren + 2));
+    std::string field;
+    double ticks = 0.0;
+    for (int i = 3; i <= 15 && fields >> field; ++i) {
+        if (i >= 14) {
+            ticks += std::stod(field);
+        }
+    }
+    return ticks / static_cast<double>(sysconf(_SC_CLK_TCK));
+}
+
+/**
+ * @brief Синтетический шаблон очередного блока
+ */
+bitcoin::BlockTemplate make_template(bitcoin::CoinbaseBuilder& builder, uint32_t height) {
+    bitcoin::BlockTemplate tmpl;
+    auto [coinbase, midstate] = builder.build_with_midstate(height, 625000000, 0);
+    tmpl.height = height;
+    tmpl.header.bits = 0x1705ae3a;
+    tmpl.header.timestamp = static_cast<uint32_t>(std::time(nullptr));
+    write_le32(tmpl.header.prev_block.data(), height);
+    tmpl.coinbase_tx = std::move(coinbase);
+    tmpl.coinbase_midstate = midstate;
+    tmpl.update_extranonce(0);
+    return tmpl;
+}
+
+double percentile(std::vector<double> values, double p) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    std::sort(values.begin(), values.end());
+    auto index = static_cast<std::size_t>(p * static_cast<double>(values.size() - 1));
+    return values[index];
+}
+
+/**
+ * @brief Подпись строки отчёта, дополненная до width символов (UTF-8)
+ */
+std::string label(const std::string& name, std::size_t width = 34) {
+    std::size_t chars = static_cast<std::size_t>(std::count_if(
+        name.begin(), name.end(), [](char c) { return (static_cast<uint8_t>(c) & 0xC0) != 0x80; }));
+    return "  " + name + std::string(chars < width ? width - chars : 1, ' ');
+}
+
+void print_distribution(const std::string& name, const std::vector<double>& values) {
+    std::cout << label(name);
+    if (values.empty()) {
+        std::cout << "нет данных" << std::endl;
+        return;
+    }
+    std::cout << std::fixed << std::setprecision(2)
+              << "p50=" << std::setw(9) << percentile(values, 0.5) << " мс"
+              << "  p99=" << std::setw(9) << percentile(values, 0.99) << " мс"
+              << "  max=" << std::setw(9) << percentile(values, 1.0) << " мс"
+              << "  (n=" << values.size() << ")" << std::endl;
+}
+
+/**
+ * @brief Разброс рассылки: кадры заданий группируются по блокам
+ *
+ * Блок - кадры в пределах BURST_WINDOW от первого; учитываются блоки,
+ * которые получила хотя бы половина парка (не одиночные задания
+ * переподключившихся ASIC).
+ */
+std::vector<double> dispatch_skew_ms(std::vector<Clock::time_point> receipts, std::size_t asics) {
+    std::sort(receipts.begin(), receipts.end());
+    std::vector<double> skew;
+    for (std::size_t begin = 0; begin < receipts.size();) {
+        std::size_t end = begin;
+        while (end < receipts.size() && receipts[end] - receipts[begin] < BURST_WINDOW) {
+            ++end;
+        }
+        if ((end - begin) * 2 >= asics) {
+            skew.push_back(std::chrono::duration<double, std::milli>(receipts[end - 1] - receipts[begin]).count());
+        }
+        begin = end;
+    }
+    return skew;
+}
+
+Options parse_options(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string key = argv[i];
+        std::string value = argv[i + 1];
+        if (key == "--asics") {
+            options.asics = std::stoul(value);
+        } else if (key == "--threads") {
+            options.threads = std::max<std::size_t>(1, std::stoul(value));
+        } else if (key == "--duration") {
+            options.duration_s = std::stoi(value);
+        } else if (key == "--difficulty") {
+            options.difficulty = std::stod(value);
+        } else if (key == "--latency-ms") {
+            options.latency_ms = std::stoi(value);
+        } else if (key == "--storm-interval-s") {
+            options.storm_interval_s = std::stoi(value);
+        } else if (key == "--storm-fraction") {
+            options.storm_fraction = std::clamp(std::stod(value), 0.0, 1.0);
+        } else if (key == "--block-interval-ms") {
+            options.block_interval_ms = std::max(1, std::stoi(value));
+        } else if (key == "--engine") {
+            options.engine = value;
+        } else if (key == "--port") {
+            options.port = static_cast<uint16_t>(std::stoul(value));
+        } else if (key == "--connect") {
+            auto colon = value.rfind(':');
+            options.connect_host = value.substr(0, colon);
+            if (colon != std::string::npos) {
+                options.port = static_cast<uint16_t>(std::stoul(value.substr(colon + 1)));
+            }
+        } else if (key == "--server-pid") {
+            options.server_pid = std::stoi(value);
+        } else {
+            std::cerr << "Неизвестный параметр: " << key << std::endl;
+        }
+    }
+    return options;
+}
+
+} // namespace quaxis::benchmark
+
+int main(int argc, char* argv[]) {
+    using namespace quaxis;
+    using namespace quaxis::benchmark;
+
+    Options options = parse_options(argc, argv);
+    const bool embedded = options.connect_host.empty();
+    if (embedded) {
+        options.connect_host = "127.0.0.1";
+    }
+
+    raise_fd_limit();
+
+    std::cout << "=== Симулятор парка ASIC ===" << std::endl;
+    std::cout << "  ASIC=" << options.asics << "  потоков=" << options.threads
+              << "  difficulty=" << options.difficulty << "  latency=" << options.latency_ms << " мс"
+              << "  SHA256=" << crypto::get_implementation_name() << std::endl;
+    if (options.storm_interval_s > 0) {
+        std::cout << "  шторм: " << options.storm_fraction * 100.0 << "% ASIC каждые "
+                  << options.storm_interval_s << " с" << std::endl;
+    }
+    std::cout << "  сервер: " << (embedded ? "встроенный (" + options.engine + ")" : options.connect_host)
+              << ":" << options.port
+              << std::endl << std::endl;
+
+    // === Встроенный сервер ===
+    MiningConfig mining_config;
+    mining_config.version_slots = 2;  // NewJobSlots несёт merkle_tail: shares ASIC проходят проверку
+    // Кольцо заданий на несколько блоков всего парка: иначе задания вытесняются и shares устаревают
+    mining_config.job_queue_size = std::max(mining_config.job_queue_size, options.asics * 4);
+    Hash160 pubkey_hash{};
+    pubkey_hash.fill(0x42);
+    bitcoin::CoinbaseBuilder builder(pubkey_hash);
+    mining::JobManager job_manager(mining_config, builder);
+    mining::ShareValidator validator(job_manager);
+    validator.set_partial_difficulty(options.difficulty);
+
+    ServerConfig server_config;
+    server_config.bind_address = "127.0.0.1";
+    server_config.port = options.port;
+    server_config.max_connections = options.asics + 16;
+    server_config.engine = options.engine;
+    network::Server server(server_config, job_manager);
+
+    AckTracker acks;
+    std::atomic<uint64_t> accepted{0};
+    std::atomic<uint64_t> rejected{0};
+    std::vector<Clock::time_point> broadcasts;
+    uint32_t height = 800000;
+
+    if (embedded) {
+        job_manager.on_new_block(make_template(builder, height));
+        server.set_share_callback([&](const mining::Share& share, uint32_t difficulty) {
+            acks.received(share.job_id, share.nonce, Clock::now());
+            auto result = validator.validate(share, static_cast<double>(difficulty));
+            bool ok = result.result == mining::ShareResult::Valid || result.result == mining::ShareResult::ValidPartial;
+            (ok ? accepted : rejected).fetch_add(1, std::memory_order_relaxed);
+        });
+        if (auto started = server.start(); !started) {
+            std::cerr << "Не удалось запустить сервер: " << started.error().message << std::endl;
+            return 1;
+        }
+    }
+
+    // === Парк ===
+    std::atomic<bool> running{true};
+    std::atomic<uint64_t> storms{0};
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < options.threads; ++t) {
+        std::size_t count = options.asics / options.threads + (t < options.asics % options.threads ? 1 : 0);
+        workers.push_back(std::make_unique<Worker>(options, count, 0x5EED + t, running, storms,
+                                                   embedded ? &acks : nullptr));
+    }
+
+    double cpu_start = embedded ? process_cpu_seconds() : pid_cpu_seconds(options.server_pid);
+    auto start = Clock::now();
+    for (auto& worker : workers) {
+        threads.emplace_back([&worker] { worker->run(); });
+    }
+
+    auto deadline = start + std::chrono::seconds(options.duration_s);
+    auto next_block = start + std::chrono::milliseconds(options.block_interval_ms);
+    auto next_storm = start + std::chrono::seconds(options.storm_interval_s);
+    while (Clock::now() < deadline) {
+        auto now = Clock::now();
+        if (embedded && now >= next_block) {
+            job_manager.on_new_block(make_template(builder, ++height));
+            broadcasts.push_back(Clock::now());
+            server.broadcast_job_set({});
+            next_block += std::chrono::milliseconds(options.block_interval_ms);
+        }
+        if (options.storm_interval_s > 0 && now >= next_storm) {
+            storms.fetch_add(1, std::memory_order_relaxed);
+            next_storm += std::chrono::seconds(options.storm_interval_s);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    running.store(false, std::memory_order_relaxed);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    double cpu_end = embedded ? process_cpu_seconds() : pid_cpu_seconds(options.server_pid);
+
+    // === Сводка ===
+    WorkerStats total;
+    for (auto& worker : workers) {
+        const WorkerStats& s = worker->stats();
+        total.job_receipts.insert(total.job_receipts.end(), s.job_receipts.begin(), s.job_receipts.end());
+        total.first_job_ms.insert(total.first_job_ms.end(), s.first_job_ms.begin(), s.first_job_ms.end());
+        total.shares_sent += s.shares_sent;
+        total.hashes += s.hashes;
+        total.reconnects += s.reconnects;
+        total.failed_connects += s.failed_connects;
+        total.cpu_seconds += s.cpu_seconds;
+    }
+
+    if (embedded) {
+        auto wait_until = Clock::now() + std::chrono::seconds(10);
+        while (server.connection_count() > 0 && Clock::now() < wait_until) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        server.stop();
+    }
+
+    std::cout << std::fixed << std::setprecision(1)
+              << "  хешрейт парка:      " << static_cast<double>(total.hashes) / elapsed / 1e6 << " MH/s" << std::endl
+              << "  shares отправлено:  " << total.shares_sent << std::endl;
+    if (embedded) {
+        std::cout << "  shares принято:     " << accepted.load() << "  отклонено: " << rejected.load() << std::endl;
+    }
+    std::cout << "  переподключений:    " << total.reconnects << "  неудачных подключений: "
+              << total.failed_connects << std::endl << std::endl;
+
+    print_distribution("разброс рассылки задания", dispatch_skew_ms(total.job_receipts, options.asics));
+    print_distribution("подключение -> первое задание", total.first_job_ms);
+    print_distribution("share: ASIC -> проверка сервером", acks.latencies_ms());
+
+    if (embedded || options.server_pid > 0) {
+        // Встроенный сервер: CPU процесса без потоков клиентов
+        double server_cpu = cpu_end - cpu_start - (embedded ? total.cpu_seconds : 0.0);
+        std::cout << label("CPU сервера")
+                  << std::setprecision(2) << std::max(0.0, server_cpu) << " с  ("
+                  << std::setprecision(1) << std::max(0.0, server_cpu) / elapsed * 100.0 << "% ядра)"
+                  << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,86 @@
+/**
+ * @file test_adaptive_spin.cpp
+ * @brief Тесты для AdaptiveSpinWait и futex ожидания sequence
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "shm/adaptive_spin.hpp"
+#include "shm/sequence_futex.hpp"
+
+namespace quaxis::tests {
+
+// =============================================================================
+// Тесты futex ожидания
+// =============================================================================
+
+/**
+ * @brief Тест: wait_sequence возвращается сразу, если sequence уже другой
+ */
+TEST(SequenceFutexTest, ChangedSequenceDoesNotWait) {
+    std::atomic<uint64_t> sequence{5};
+    
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_TRUE(shm::wait_sequence(sequence, 4, std::chrono::seconds(5)));
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1));
+    
+    // Без изменений - по таймауту
+    EXPECT_FALSE(shm::wait_sequence(sequence, 5, std::chrono::milliseconds(1)));
+}
+
+/**
+ * @brief Тест: publish_sequence будит поток, уснувший в futex_wait
+ * 
+ * Таймаут ожидания - 10 секунд: возврат раньше означает пробуждение.
+ */
+TEST(SequenceFutexTest, PublishWakesFutexWaiter) {
+    std::atomic<uint64_t> sequence{0};
+    
+    shm::AdaptiveSpinConfig config;
+    config.futex_wait = true;
+    config.futex_spin_iterations = 10;
+    config.futex_timeout_us = 10'000'000;
+    
+    std::atomic<uint64_t> seen{0};
+    std::thread waiter_thread([&] {
+        shm::AdaptiveSpinWait waiter(config);
+        seen = waiter.wait_for_change(sequence, 0);
+    });
+    
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(shm::publish_sequence(sequence), 1u);
+    waiter_thread.join();
+    
+    EXPECT_EQ(seen.load(), 1u);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+}
+
+/**
+ * @brief Тест: в гибридном режиме после spin поток переходит в фазу futex
+ */
+TEST(SequenceFutexTest, HybridModeSkipsYieldPhase) {
+    std::atomic<uint64_t> sequence{0};
+    
+    shm::AdaptiveSpinConfig config;
+    config.futex_wait = true;
+    config.futex_spin_iterations = 3;
+    config.futex_timeout_us = 100;
+    shm::AdaptiveSpinWait waiter(config);
+    
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_EQ(waiter.current_phase(), 1);
+        waiter.wait_step(sequence, 0);
+    }
+    EXPECT_EQ(waiter.current_phase(), 3);
+    EXPECT_DOUBLE_EQ(waiter.estimated_cpu_percent(), 0.0);
+    
+    waiter.wait_step(sequence, 0);  // futex_wait по таймауту
+    EXPECT_EQ(waiter.current_phase(), 3);
+}
+
+} // namespace quaxis::tests
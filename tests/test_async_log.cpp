@@ -0,0 +1,154 @@
+/**
+ * @file test_async_log.cpp
+ * @brief Тесты асинхронного лога
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "core/async_log.hpp"
+
+namespace quaxis::tests {
+
+namespace {
+
+/// @brief Запись места вызова с аргументами
+template <typename... Args>
+core::LogRecord make_record(const core::LogSite& site, const Args&... args) {
+    core::LogRecord record;
+    record.site = &site;
+    (record.add(args), ...);
+    return record;
+}
+
+/// @brief Строки файла
+std::vector<std::string> read_lines(const std::string& path) {
+    std::vector<std::string> lines;
+    std::ifstream in(path);
+    for (std::string line; std::getline(in, line);) {
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+} // anonymous namespace
+
+TEST(AsyncLogTest, FormatsDeferredArguments) {
+    static core::LogSite site{core::LogLevel::Info, "{} {:#x} {:.2f} {} {{{}}} {:>5}"};
+    const std::string owned = "asic-7";
+    const auto record = make_record(site, -3, 255u, 1.5, true, owned, "ab");
+    EXPECT_EQ(core::format_log_record(record), "-3 0xff 1.50 true {asic-7}    ab");
+}
+
+TEST(AsyncLogTest, MalformedPlaceholders) {
+    static core::LogSite missing{core::LogLevel::Info, "a={} b={}"};
+    EXPECT_EQ(core::format_log_record(make_record(missing, 1)), "a=1 b={?}");
+
+    static core::LogSite bad_spec{core::LogLevel::Info, "x={:.3d}"};
+    EXPECT_EQ(core::format_log_record(make_record(bad_spec, 7)), "x={?}");
+}
+
+TEST(AsyncLogTest, LongTextTruncated) {
+    static core::LogSite site{core::LogLevel::Info, "{}|{}"};
+    const std::string big(core::LOG_TEXT_SIZE + 100, 'z');
+    const auto record = make_record(site, big, "tail");
+    const std::string text = core::format_log_record(record);
+    EXPECT_EQ(text, std::string(core::LOG_TEXT_SIZE, 'z') + "|");
+}
+
+TEST(AsyncLogTest, ParseNames) {
+    EXPECT_EQ(core::parse_log_level("warn"), core::LogLevel::Warning);
+    EXPECT_EQ(core::parse_log_level("debug"), core::LogLevel::Debug);
+    EXPECT_FALSE(core::parse_log_level("verbose").has_value());
+    EXPECT_EQ(core::parse_log_output("journald"), core::LogOutput::Journald);
+    EXPECT_FALSE(core::parse_log_output("syslog").has_value());
+}
+
+TEST(AsyncLogTest, RateLimitAndSampling) {
+    core::LogSite limited{core::LogLevel::Info, "x", 3, 0};
+    int passed = 0;
+    for (int i = 0; i < 10; ++i) {
+        passed += core::detail::log_throttled(limited) ? 0 : 1;
+    }
+    // Окно могло смениться посреди цикла
+    EXPECT_GE(passed, 3);
+    EXPECT_LE(passed, 6);
+    EXPECT_EQ(limited.suppressed.load() + static_cast<uint64_t>(passed), 10u);
+
+    core::LogSite sampled{core::LogLevel::Info, "x", 0, 4};
+    passed = 0;
+    for (int i = 0; i < 20; ++i) {
+        passed += core::detail::log_throttled(sampled) ? 0 : 1;
+    }
+    EXPECT_EQ(passed, 5);
+}
+
+TEST(AsyncLogTest, BackgroundWriterToFile) {
+    const auto path = (std::filesystem::temp_directory_path() /
+                       ("quaxis_async_log_" + std::to_string(::getpid()) + ".log")).string();
+    std::filesystem::remove(path);
+
+    core::LogConfig config;
+    config.output = core::LogOutput::File;
+    config.file = path;
+    config.flush_interval_ms = 1;
+    ASSERT_TRUE(core::start_log(config).has_value());
+
+    constexpr int THREADS = 4;
+    constexpr int MESSAGES = 200;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t) {
+        threads.emplace_back([t] {
+            for (int i = 0; i < MESSAGES; ++i) {
+                QUAXIS_LOG(Info, "thread {} message {}", t, i);
+                QUAXIS_LOG(Debug, "hidden {}", i);
+                if (i % 50 == 49) {
+                    // Даём фоновому потоку освободить кольцо
+                    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    core::stop_log();
+
+    const auto lines = read_lines(path);
+    std::filesystem::remove(path);
+
+    EXPECT_EQ(core::log_dropped(), 0u);
+    ASSERT_EQ(lines.size(), static_cast<std::size_t>(THREADS * MESSAGES));
+    for (const auto& line : lines) {
+        EXPECT_NE(line.find("[INFO] thread "), std::string::npos) << line;
+        EXPECT_EQ(line.find("hidden"), std::string::npos);
+    }
+    // Сообщения одного потока в исходном порядке
+    int last = -1;
+    for (const auto& line : lines) {
+        if (line.find("thread 0 message ") != std::string::npos) {
+            const int value = std::stoi(line.substr(line.rfind(' ') + 1));
+            EXPECT_EQ(value, last + 1);
+            last = value;
+        }
+    }
+    EXPECT_EQ(last, MESSAGES - 1);
+}
+
+TEST(AsyncLogTest, FileWithoutPathRejected) {
+    core::LogConfig config;
+    config.output = core::LogOutput::File;
+    auto result = core::start_log(config);
+    ASSERT_FALSE(result.has_value());
+    EXPECT_EQ(result.error().code, ErrorCode::ConfigInvalidValue);
+}
+
+} // namespace quaxis::tests
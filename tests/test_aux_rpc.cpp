@@ -0,0 +1,404 @@
+/**
+ * @file test_aux_rpc.cpp
+ * @brief Тесты для параллельного опроса aux chain нод (AuxRpcMulti), longpoll
+ *        и параллельной отправки aux блоков
+ */
+
+#include <gtest/gtest.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <array>
+#include <chrono>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "merged/rpc/aux_rpc_client.hpp"
+#include "merged/chain_manager.hpp"
+#include "merged/auxpow.hpp"
+#include "crypto/sha256.hpp"
+
+namespace quaxis::tests {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using namespace std::chrono_literals;
+
+/**
+ * @brief Локальная "нода": отвечает на каждый запрос через delay
+ * 
+ * С slow_method задерживаются только запросы этого метода.
+ */
+class FakeRpcNode {
+public:
+    FakeRpcNode(std::string result, std::chrono::milliseconds delay, std::string slow_method = "")
+        : result_(std::move(result)), delay_(delay), slow_method_(std::move(slow_method)) {
+        fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        EXPECT_EQ(::bind(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0);
+        EXPECT_EQ(::listen(fd_, 8), 0);
+        socklen_t len = sizeof(addr);
+        ::getsockname(fd_, reinterpret_cast<sockaddr*>(&addr), &len);
+        port_ = ntohs(addr.sin_port);
+        thread_ = std::thread([this] { serve(); });
+    }
+
+    ~FakeRpcNode() {
+        stop_ = true;
+        ::shutdown(fd_, SHUT_RDWR);
+        ::close(fd_);
+        thread_.join();
+    }
+
+    [[nodiscard]] std::string url() const {
+        return "http://127.0.0.1:" + std::to_string(port_);
+    }
+
+private:
+    void serve() {
+        while (!stop_) {
+            int client = ::accept(fd_, nullptr, nullptr);
+            if (client < 0) {
+                return;
+            }
+            const auto request = read_request(client);
+            const bool slow = slow_method_.empty() ||
+                              request.find("\"" + slow_method_ + "\"") != std::string::npos;
+            auto until = Clock::now() + (slow ? delay_ : 0ms);
+            while (!stop_ && Clock::now() < until) {
+                std::this_thread::sleep_for(5ms);
+            }
+            std::string body = R"({"result":)" + result_ + R"(,"error":null,"id":1})";
+            std::string response = "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\n"
+                                   "Connection: close\r\nContent-Length: " +
+                                   std::to_string(body.size()) + "\r\n\r\n" + body;
+            (void)::send(client, response.data(), response.size(), MSG_NOSIGNAL);
+            ::close(client);
+        }
+    }
+
+    static std::string read_request(int client) {
+        std::string request;
+        char buffer[1024];
+        while (true) {
+            auto header_end = request.find("\r\n\r\n");
+            if (header_end != std::string::npos) {
+                auto pos = request.find("Content-Length: ");
+                std::size_t length = pos == std::string::npos
+                    ? 0 : std::stoul(request.substr(pos + 16));
+                if (request.size() >= header_end + 4 + length) {
+                    return request;
+                }
+            }
+            auto n = ::recv(client, buffer, sizeof(buffer), 0);
+            if (n <= 0) {
+                return request;
+            }
+            request.append(buffer, static_cast<std::size_t>(n));
+        }
+    }
+
+    std::string result_;
+    std::chrono::milliseconds delay_;
+    std::string slow_method_;
+    int fd_{-1};
+    uint16_t port_{0};
+    std::atomic<bool> stop_{false};
+    std::thread thread_;
+};
+
+} // anonymous namespace
+
+TEST(AuxRpcMultiTest, SlowNodeDoesNotDelayOthers) {
+    FakeRpcNode fast_a("\"a\"", 0ms);
+    FakeRpcNode slow("\"slow\"", 2000ms);
+    FakeRpcNode fast_b("\"b\"", 0ms);
+    
+    merged::AuxRpcClient client_a(fast_a.url());
+    merged::AuxRpcClient client_slow(slow.url());
+    merged::AuxRpcClient client_b(fast_b.url());
+    
+    std::vector<merged::AuxRpcRequest> requests(3);
+    requests[0].client = &client_a;
+    requests[1].client = &client_slow;
+    requests[2].client = &client_b;
+    for (auto& request : requests) {
+        request.method = "createauxblock";
+        request.deadline = 300ms;
+    }
+    
+    std::vector<std::chrono::milliseconds> done_at(3);
+    std::vector<bool> ok(3);
+    std::vector<std::string> responses(3);
+    
+    merged::AuxRpcMulti multi;
+    auto start = Clock::now();
+    multi.perform(requests, [&](std::size_t index, Result<std::string> response) {
+        done_at[index] = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start);
+        ok[index] = response.has_value();
+        if (response) {
+            responses[index] = *response;
+        }
+    });
+    auto total = Clock::now() - start;
+    
+    EXPECT_TRUE(ok[0]);
+    EXPECT_TRUE(ok[2]);
+    EXPECT_FALSE(ok[1]);  // deadline
+    EXPECT_NE(responses[0].find("\"a\""), std::string::npos);
+    EXPECT_NE(responses[2].find("\"b\""), std::string::npos);
+    
+    // Быстрые ноды ответили до deadline медленной, общий цикл - один deadline
+    EXPECT_LT(done_at[0], 250ms);
+    EXPECT_LT(done_at[2], 250ms);
+    EXPECT_GE(done_at[1], 250ms);
+    EXPECT_LT(total, 1500ms);
+}
+
+TEST(AuxRpcMultiTest, ReusableAcrossRounds) {
+    FakeRpcNode node("1", 0ms);
+    merged::AuxRpcClient client(node.url());
+    
+    std::vector<merged::AuxRpcRequest> requests(1);
+    requests[0].client = &client;
+    requests[0].method = "getblockcount";
+    
+    merged::AuxRpcMulti multi;
+    for (int round = 0; round < 3; ++round) {
+        std::size_t completed = 0;
+        multi.perform(requests, [&](std::size_t, Result<std::string> response) {
+            EXPECT_TRUE(response.has_value());
+            ++completed;
+        });
+        EXPECT_EQ(completed, 1u);
+    }
+}
+
+TEST(AuxRpcMultiTest, LargeBodyNoContinueWait) {
+    FakeRpcNode node("null", 0ms);
+    merged::AuxRpcClient client(node.url());
+    
+    // submitauxblock с AuxPoW - тело больше 1 КБ: без ожидания 100-continue
+    std::string params = "[\"" + std::string(4096, 'a') + "\"]";
+    auto start = Clock::now();
+    auto response = client.call("submitauxblock", params);
+    auto elapsed = Clock::now() - start;
+    
+    EXPECT_TRUE(response.has_value());
+    EXPECT_LT(elapsed, 500ms);
+}
+
+TEST(AuxRpcMultiTest, EmptyRequestSet) {
+    merged::AuxRpcMulti multi;
+    std::size_t completed = 0;
+    multi.perform({}, [&](std::size_t, Result<std::string>) { ++completed; });
+    EXPECT_EQ(completed, 0u);
+}
+
+TEST(AuxRpcMultiTest, RunRearmsUntilStopped) {
+    FakeRpcNode node(R"({"longpollid":"tip1"})", 20ms);
+    merged::AuxRpcClient client(node.url());
+    
+    std::vector<merged::AuxRpcRequest> requests(1);
+    requests[0].client = &client;
+    requests[0].method = "getblocktemplate";
+    requests[0].params = merged::longpoll_params("");
+    
+    std::atomic<bool> running{true};
+    std::size_t completed = 0;
+    std::thread stopper([&] {
+        std::this_thread::sleep_for(300ms);
+        running = false;
+    });
+    
+    merged::AuxRpcMulti multi;
+    auto start = Clock::now();
+    multi.run(requests, [&](std::size_t index, Result<std::string> response)
+            -> std::optional<std::chrono::milliseconds> {
+        EXPECT_TRUE(response.has_value());
+        ++completed;
+        if (response) {
+            auto id = merged::find_longpoll_id(*response);
+            EXPECT_EQ(id, "tip1");
+            requests[index].params = merged::longpoll_params(id.value_or(""));
+        }
+        return 0ms;
+    }, running);
+    auto elapsed = Clock::now() - start;
+    stopper.join();
+    
+    // Запрос перезапускался, run() вернулся вскоре после сброса флага
+    EXPECT_GE(completed, 3u);
+    EXPECT_LT(elapsed, 800ms);
+    EXPECT_NE(requests[0].params.find("\"longpollid\":\"tip1\""), std::string::npos);
+}
+
+TEST(AuxRpcMultiTest, RunReturnsWhenAllDropped) {
+    FakeRpcNode node("1", 0ms);
+    merged::AuxRpcClient client(node.url());
+    
+    std::vector<merged::AuxRpcRequest> requests(2);
+    for (auto& request : requests) {
+        request.client = &client;
+        request.method = "getblockcount";
+    }
+    
+    std::atomic<bool> running{true};
+    std::vector<std::size_t> completed(2);
+    merged::AuxRpcMulti multi;
+    multi.run(requests, [&](std::size_t index, Result<std::string>)
+            -> std::optional<std::chrono::milliseconds> {
+        // Первый запрос снимается сразу, второй - после повтора с паузой
+        if (++completed[index] == 2 || index == 0) {
+            return std::nullopt;
+        }
+        return 10ms;
+    }, running);
+    
+    EXPECT_EQ(completed[0], 1u);
+    EXPECT_EQ(completed[1], 2u);
+}
+
+TEST(AuxRpcLongpollTest, ParamsAndId) {
+    EXPECT_EQ(merged::longpoll_params(""), R"([{"rules":["segwit"]}])");
+    EXPECT_EQ(merged::longpoll_params("00ab"),
+              R"([{"rules":["segwit"],"longpollid":"00ab"}])");
+    
+    EXPECT_EQ(merged::find_longpoll_id(R"({"result":{"height":5,"longpollid": "00ab12"}})"),
+              "00ab12");
+    EXPECT_FALSE(merged::find_longpoll_id(R"({"result":{"longpollid":null,"x":"y"}})"));
+    EXPECT_FALSE(merged::find_longpoll_id(R"({"result":{"hash":"00"}})"));
+    EXPECT_FALSE(merged::find_longpoll_id(R"({"result":{"longpollid":""}})"));
+}
+
+// =============================================================================
+// Параллельная отправка aux блоков
+// =============================================================================
+
+TEST(AuxSubmitTest, MatchingChainsSubmitConcurrently) {
+    // Ответ годится и как createauxblock (шаблон), и как ответ submitauxblock
+    const std::string tmpl = R"({"hash":")" + std::string(62, '0') + R"(01",)"
+                             R"("bits":"207fffff","height":7})";
+    FakeRpcNode namecoin(tmpl, 300ms, "submitauxblock");
+    FakeRpcNode syscoin(tmpl, 300ms, "submitauxblock");
+    
+    merged::MergedMiningConfig config;
+    config.enabled = true;
+    for (auto [name, node] : {std::pair{"namecoin", &namecoin}, std::pair{"syscoin", &syscoin}}) {
+        merged::ChainConfig chain;
+        chain.name = name;
+        chain.rpc_url = node->url();
+        config.chains.push_back(chain);
+    }
+    
+    merged::ChainManager manager(config);
+    std::mutex found_mutex;
+    std::vector<std::pair<std::string, std::chrono::microseconds>> found;
+    manager.set_block_found_callback([&](const std::string& chain_name, uint32_t height,
+                                         const Hash256&, std::chrono::microseconds latency) {
+        EXPECT_EQ(height, 7u);
+        std::lock_guard<std::mutex> lock(found_mutex);
+        found.emplace_back(chain_name, latency);
+    });
+    manager.start();
+    
+    // Ждём шаблоны обеих chains
+    auto wait_until = Clock::now() + 3s;
+    while (Clock::now() < wait_until && manager.get_active_templates().size() < 2) {
+        std::this_thread::sleep_for(10ms);
+    }
+    ASSERT_EQ(manager.get_active_templates().size(), 2u);
+    
+    // Parent header, проходящий target 0x207fffff
+    std::array<uint8_t, 80> header{};
+    for (uint8_t nonce = 1; !merged::meets_target(crypto::sha256d(header), 0x207fffff); ++nonce) {
+        ASSERT_NE(nonce, 0) << "нет подходящего nonce";
+        header[76] = nonce;
+    }
+    
+    auto start = Clock::now();
+    auto results = manager.submit_to_matching_chains(header, Bytes{0x01, 0x02}, merged::MerkleBranch{});
+    auto elapsed = Clock::now() - start;
+    manager.stop();
+    
+    ASSERT_EQ(results.size(), 2u);
+    EXPECT_TRUE(results[0].second);
+    EXPECT_TRUE(results[1].second);
+    
+    // Обе ноды отвечают через 300 мс: параллельно - один интервал, не два
+    EXPECT_LT(elapsed, 550ms);
+    ASSERT_EQ(found.size(), 2u);
+    for (const auto& [name, latency] : found) {
+        EXPECT_GE(latency, 250ms) << name;
+        EXPECT_LT(latency, 550ms) << name;
+    }
+}
+
+TEST(AuxSubmitTest, MatchChainsByTargetTable) {
+    auto tmpl = [](std::string_view bits) {
+        return R"({"hash":")" + std::string(62, '0') + R"(01","bits":")" +
+               std::string(bits) + R"(","height":7})";
+    };
+    FakeRpcNode namecoin(tmpl("207fffff"), 0ms);
+    FakeRpcNode syscoin(tmpl("1d00ffff"), 0ms);
+    FakeRpcNode emercoin(tmpl("2000ffff"), 0ms);
+    
+    merged::MergedMiningConfig config;
+    config.enabled = true;
+    for (auto [name, node] : {std::pair{"namecoin", &namecoin}, std::pair{"syscoin", &syscoin},
+                              std::pair{"emercoin", &emercoin}}) {
+        merged::ChainConfig chain;
+        chain.name = name;
+        chain.rpc_url = node->url();
+        config.chains.push_back(chain);
+    }
+    
+    merged::ChainManager manager(config);
+    manager.start();
+    auto wait_until = Clock::now() + 3s;
+    while (Clock::now() < wait_until && manager.get_active_templates().size() < 3) {
+        std::this_thread::sleep_for(10ms);
+    }
+    manager.stop();
+    ASSERT_EQ(manager.get_active_templates().size(), 3u);
+    
+    // Заголовки по старшему байту хеша: > 0x7f, (0x00, 0x7f], 0x00
+    std::optional<std::array<uint8_t, 80>> none, easy, medium;
+    std::array<uint8_t, 80> header{};
+    for (uint32_t nonce = 0; nonce < 0x10000 && !(none && easy && medium); ++nonce) {
+        header[76] = static_cast<uint8_t>(nonce);
+        header[77] = static_cast<uint8_t>(nonce >> 8);
+        const uint8_t top = crypto::sha256d(header)[31];
+        auto& slot = top > 0x7f ? none : (top == 0 ? medium : easy);
+        if (!slot) {
+            slot = header;
+        }
+    }
+    ASSERT_TRUE(none && easy && medium);
+    
+    const Bytes coinbase{0x01};
+    EXPECT_TRUE(manager.check_aux_chains(*none, coinbase, {}).empty());
+    EXPECT_EQ(manager.check_aux_chains(*easy, coinbase, {}),
+              (std::vector<std::string>{"namecoin"}));
+    // Порядок - как в конфигурации, а не по сложности
+    EXPECT_EQ(manager.check_aux_chains(*medium, coinbase, {}),
+              (std::vector<std::string>{"namecoin", "emercoin"}));
+    
+    // Выключенная chain сразу пропадает из отбора
+    ASSERT_TRUE(manager.set_chain_enabled("namecoin", false));
+    EXPECT_TRUE(manager.check_aux_chains(*easy, coinbase, {}).empty());
+    EXPECT_EQ(manager.check_aux_chains(*medium, coinbase, {}),
+              (std::vector<std::string>{"emercoin"}));
+}
+
+} // namespace quaxis::tests
@@ -5,6 +5,8 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+
 #include "merged/auxpow.hpp"
 
 using namespace quaxis;
@@ -188,6 +190,106 @@ TEST_F(AuxPowTest, GetParentHash) {
     EXPECT_NE(hash[0], 0);  // Должен быть ненулевым
 }
 
+TEST_F(AuxPowTest, ViewParsesWithoutCopy) {
+    AuxPow original;
+    original.coinbase_tx = {0x01, 0x02, 0x03};
+    original.coinbase_hash[0] = 0xAA;
+    Hash256 branch_hash{};
+    branch_hash[0] = 0xCC;
+    original.coinbase_branch.hashes.push_back(branch_hash);
+    original.coinbase_branch.index = 1;
+    original.parent_header[0] = 0xBB;
+    
+    Bytes serialized = original.serialize();
+    auto view = AuxPowView::parse(serialized);
+    ASSERT_TRUE(view.has_value());
+    
+    EXPECT_EQ(view->coinbase_tx.data(), serialized.data() + 4);
+    EXPECT_EQ(view->coinbase_branch.size(), 1u);
+    EXPECT_EQ(view->coinbase_branch.index, 1u);
+    EXPECT_EQ(view->aux_branch.size(), 0u);
+    EXPECT_EQ(view->parent_header.data(), serialized.data() + serialized.size() - 80);
+    EXPECT_EQ(view->get_parent_hash(), original.get_parent_hash());
+    
+    auto owned = view->to_owned();
+    EXPECT_EQ(owned.serialize(), serialized);
+    
+    EXPECT_FALSE(AuxPowView::parse(ByteSpan(serialized).first(serialized.size() - 1)).has_value());
+}
+
+TEST_F(AuxPowTest, ViewVerifyMatchesOwned) {
+    Hash256 aux_hash{};
+    aux_hash[0] = 0x55;
+    
+    AuxCommitment commitment;
+    commitment.aux_merkle_root = aux_hash;
+    auto committed = commitment.serialize();
+    
+    AuxPow auxpow;
+    auxpow.coinbase_tx.assign(committed.begin(), committed.end());
+    Hash256 txid = crypto::sha256d(auxpow.coinbase_tx);
+    std::copy(txid.begin(), txid.end(), auxpow.parent_header.begin() + 36);
+    
+    Bytes serialized = auxpow.serialize();
+    auto view = AuxPowView::parse(serialized);
+    ASSERT_TRUE(view.has_value());
+    
+    EXPECT_TRUE(auxpow.verify(aux_hash));
+    EXPECT_TRUE(view->verify(aux_hash));
+    EXPECT_FALSE(view->verify(Hash256{}));
+}
+
+TEST_F(AuxPowTest, HexBuilderMatchesSerialize) {
+    AuxPow auxpow;
+    auxpow.coinbase_tx = {0x01, 0x00, 0xfa, 0xbe, 0x6d, 0x6d};
+    auxpow.coinbase_hash[0] = 0xAA;
+    auxpow.coinbase_branch.hashes.assign(2, Hash256{});
+    auxpow.coinbase_branch.hashes[1][31] = 0x0F;
+    auxpow.coinbase_branch.index = 2;
+    auxpow.parent_header[79] = 0xBB;
+    
+    AuxPowHexBuilder builder(auxpow);
+    
+    // Разные aux branch поверх одних общих частей
+    for (uint32_t depth = 0; depth < 3; ++depth) {
+        auxpow.aux_branch.hashes.assign(depth, Hash256{});
+        for (auto& hash : auxpow.aux_branch.hashes) {
+            hash[0] = static_cast<uint8_t>(0xC0 + depth);
+        }
+        auxpow.aux_branch.index = depth;
+        
+        std::string expected;
+        for (uint8_t byte : auxpow.serialize()) {
+            static constexpr char hex_chars[] = "0123456789abcdef";
+            expected.push_back(hex_chars[byte >> 4]);
+            expected.push_back(hex_chars[byte & 0x0F]);
+        }
+        EXPECT_EQ(builder.build(auxpow.aux_branch), expected);
+    }
+}
+
+TEST_F(AuxPowTest, HexBuilderReusedAcrossShares) {
+    MerkleBranch coinbase_branch;
+    coinbase_branch.hashes.assign(1, Hash256{});
+    coinbase_branch.hashes[0][5] = 0x42;
+    AuxPowHexBuilder builder(Bytes{0x01, 0x00, 0xfa, 0xbe}, coinbase_branch);
+    
+    AuxPow auxpow = builder.common();
+    EXPECT_EQ(auxpow.coinbase_hash, crypto::sha256d(auxpow.coinbase_tx));
+    auxpow.aux_branch.hashes.assign(1, Hash256{});
+    
+    // Следующий share того же задания: меняется только parent header
+    for (uint8_t nonce = 1; nonce <= 3; ++nonce) {
+        auxpow.parent_header[76] = nonce;
+        builder.set_parent_header(auxpow.parent_header);
+        
+        EXPECT_EQ(builder.common().parent_header, auxpow.parent_header);
+        // Результат - как у builder, собранного с нуля по полному AuxPoW
+        EXPECT_EQ(builder.build(auxpow.aux_branch),
+                  AuxPowHexBuilder(auxpow).build(auxpow.aux_branch));
+    }
+}
+
 // =============================================================================
 // Merkle Tree Functions Tests
 // =============================================================================
@@ -272,6 +374,15 @@ TEST_F(AuxPowTargetTest, BitsToTarget) {
     EXPECT_FALSE(all_zero);
 }
 
+TEST_F(AuxPowTargetTest, BitsToTargetTopExponent) {
+    // regtest: экспонента 0x20 - мантисса в трёх старших байтах
+    Hash256 target = bits_to_target(0x207fffff);
+    EXPECT_EQ(target[31], 0x7f);
+    EXPECT_EQ(target[30], 0xff);
+    EXPECT_EQ(target[29], 0xff);
+    EXPECT_EQ(target[28], 0x00);
+}
+
 TEST_F(AuxPowTargetTest, MeetsTargetTrue) {
     // Создаём очень большой target (легкий)
     uint32_t easy_bits = 0x1d00ffff;  // Genesis difficulty
@@ -331,6 +442,34 @@ TEST_F(SlotIdTest, DifferentNonceDifferentSlot) {
     EXPECT_LT(slot2, tree_size);
 }
 
+TEST_F(SlotIdTest, LayoutAvoidsCollisions) {
+    auto ids_of = [](std::initializer_list<uint8_t> low_bytes) {
+        std::vector<Hash256> ids;
+        for (uint8_t byte : low_bytes) {
+            ids.emplace_back()[0] = byte;
+        }
+        return ids;
+    };
+    
+    // Без коллизий - наименьшая степень двойки
+    EXPECT_EQ(solve_aux_tree_layout(ids_of({10, 11, 12, 13})).tree_size, 4u);
+    EXPECT_EQ(solve_aux_tree_layout(ids_of({7})).tree_size, 1u);
+    
+    // 0, 4, 8 совпадают по модулю 4 и 8
+    auto ids = ids_of({0, 4, 8});
+    auto layout = solve_aux_tree_layout(ids);
+    EXPECT_EQ(layout.tree_size, 16u);
+    std::vector<uint32_t> slots;
+    for (const auto& id : ids) {
+        slots.push_back(compute_slot_id(id, layout.merkle_nonce, layout.tree_size));
+    }
+    std::sort(slots.begin(), slots.end());
+    EXPECT_EQ(std::adjacent_find(slots.begin(), slots.end()), slots.end());
+    
+    // Одинаковые id не развести - минимальный размер
+    EXPECT_EQ(solve_aux_tree_layout(ids_of({5, 5, 6})).tree_size, 4u);
+}
+
 // =============================================================================
 // Create Aux Commitment Tests
 // =============================================================================
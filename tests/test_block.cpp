@@ -12,6 +12,8 @@
 #include <span>
 
 #include "bitcoin/block.hpp"
+#include "bitcoin/coinbase.hpp"
+#include "core/primitives/merkle.hpp"
 #include "bitcoin/target.hpp"
 #include "crypto/sha256.hpp"
 #include "core/types.hpp"
@@ -133,6 +135,114 @@ TEST_F(BlockTest, MerkleRootSingleTx) {
     EXPECT_EQ(merkle_root, coinbase_hash);
 }
 
+/**
+ * @brief Тест: merkle root нечётного числа транзакций по уровням
+ * 
+ * Эталон - попарный sha256d с дублированием последнего элемента.
+ */
+TEST_F(BlockTest, MerkleRootManyTxMatchesPairwise) {
+    std::vector<Hash256> txids(11);
+    for (size_t i = 0; i < txids.size(); ++i) {
+        std::fill(txids[i].begin(), txids[i].end(), static_cast<uint8_t>(i + 1));
+        txids[i][0] = static_cast<uint8_t>(i * 37);
+    }
+    
+    std::vector<Hash256> level = txids;
+    while (level.size() > 1) {
+        std::vector<Hash256> next;
+        for (size_t i = 0; i < level.size(); i += 2) {
+            const Hash256& right = (i + 1 < level.size()) ? level[i + 1] : level[i];
+            std::array<uint8_t, 64> pair{};
+            std::memcpy(pair.data(), level[i].data(), 32);
+            std::memcpy(pair.data() + 32, right.data(), 32);
+            next.push_back(crypto::sha256d(ByteSpan(pair.data(), pair.size())));
+        }
+        level = std::move(next);
+    }
+    
+    EXPECT_EQ(bitcoin::compute_merkle_root(txids), level[0]);
+}
+
+/**
+ * @brief Тест: core::MerkleTree и core::compute_merkle_root дают тот же корень
+ */
+TEST_F(BlockTest, CoreMerkleTreeMatchesBitcoinRoot) {
+    std::vector<Hash256> leaves(8);
+    for (size_t i = 0; i < leaves.size(); ++i) {
+        leaves[i][0] = static_cast<uint8_t>(i);
+        leaves[i][31] = static_cast<uint8_t>(0xF0 ^ i);
+    }
+    
+    core::MerkleTree tree(leaves);
+    auto expected = bitcoin::compute_merkle_root(leaves);
+    EXPECT_EQ(tree.root(), expected);
+    EXPECT_EQ(tree.nodes().size(), 15u);
+    EXPECT_EQ(core::compute_merkle_root(leaves), expected);
+    for (size_t i = 0; i < leaves.size(); ++i) {
+        EXPECT_TRUE(tree.get_branch(i).verify(leaves[i], expected)) << "leaf " << i;
+    }
+    
+    leaves.resize(5);
+    EXPECT_EQ(core::compute_merkle_root(leaves), bitcoin::compute_merkle_root(leaves));
+}
+
+/**
+ * @brief Тест: IncrementalMerkleTree после точечных изменений совпадает с MerkleTree
+ */
+TEST_F(BlockTest, IncrementalMerkleTreeMatchesRebuild) {
+    std::vector<Hash256> leaves(8);
+    core::IncrementalMerkleTree tree(leaves.size());
+    EXPECT_EQ(tree.capacity(), 8u);
+    EXPECT_EQ(tree.depth(), 3u);
+    EXPECT_EQ(tree.root(), core::MerkleTree(leaves).root());
+    
+    for (size_t step = 0; step < 20; ++step) {
+        size_t index = (step * 5) % leaves.size();
+        leaves[index][0] = static_cast<uint8_t>(step + 1);
+        leaves[index][31] = static_cast<uint8_t>(index);
+        tree.set_leaf(index, leaves[index]);
+        
+        core::MerkleTree rebuilt(leaves);
+        ASSERT_EQ(tree.root(), rebuilt.root()) << "step " << step;
+        auto branch = tree.get_branch(index);
+        EXPECT_EQ(branch.hashes, rebuilt.get_branch(index).hashes);
+        EXPECT_TRUE(branch.verify(leaves[index], rebuilt.root()));
+    }
+    
+    // update(): два листа из восьми, остальные без изменений
+    leaves[2][7] ^= 0xFF;
+    leaves[3][7] ^= 0xFF;
+    EXPECT_EQ(tree.update(leaves), 2u);
+    EXPECT_EQ(tree.root(), core::MerkleTree(leaves).root());
+    EXPECT_EQ(tree.update(leaves), 0u);
+    
+    // Короче capacity - хвост обнуляется
+    std::vector<Hash256> prefix(leaves.begin(), leaves.begin() + 5);
+    tree.update(prefix);
+    prefix.resize(8);
+    EXPECT_EQ(tree.root(), core::MerkleTree(prefix).root());
+}
+
+/**
+ * @brief Тест: IncrementalMerkleTree из одного листа и округление размера
+ */
+TEST_F(BlockTest, IncrementalMerkleTreeSmallSizes) {
+    core::IncrementalMerkleTree empty;
+    EXPECT_EQ(empty.capacity(), 0u);
+    EXPECT_EQ(empty.root(), Hash256{});
+    
+    core::IncrementalMerkleTree single(1);
+    Hash256 leaf{};
+    leaf[0] = 0xAB;
+    single.set_leaf(0, leaf);
+    EXPECT_EQ(single.root(), leaf);
+    EXPECT_TRUE(single.get_branch(0).hashes.empty());
+    
+    core::IncrementalMerkleTree tree(3);
+    EXPECT_EQ(tree.capacity(), 4u);
+    EXPECT_THROW(tree.set_leaf(4, leaf), std::out_of_range);
+}
+
 /**
  * @brief Тест: merkle root для двух транзакций
  */
@@ -231,6 +341,144 @@ TEST_F(BlockTest, HeaderTail) {
     EXPECT_EQ(tail.size(), 16);
 }
 
+/**
+ * @brief Тест: update_extranonce с coinbase midstate совпадает с полным SHA256d
+ */
+TEST_F(BlockTest, UpdateExtranonceUsesCoinbaseMidstate) {
+    bitcoin::BlockTemplate tmpl;
+    tmpl.header.timestamp = 1700000000;
+    tmpl.header.bits = 0x1d00ffff;
+    tmpl.coinbase_tx.resize(constants::COINBASE_SIZE);
+    for (std::size_t i = 0; i < tmpl.coinbase_tx.size(); ++i) {
+        tmpl.coinbase_tx[i] = static_cast<uint8_t>(i * 13);
+    }
+    tmpl.coinbase_midstate = crypto::compute_midstate(tmpl.coinbase_tx.data());
+    
+    for (uint64_t extranonce : {uint64_t{1}, uint64_t{0x0000A1B2C3D4E5F6 & constants::EXTRANONCE_MAX}}) {
+        tmpl.update_extranonce(extranonce);
+        
+        auto expected = crypto::sha256d(ByteSpan(tmpl.coinbase_tx.data(), tmpl.coinbase_tx.size()));
+        EXPECT_EQ(tmpl.header.merkle_root, expected);
+        EXPECT_EQ(tmpl.header_midstate, tmpl.header.compute_midstate());
+    }
+}
+
+/**
+ * @brief Тест: update_extranonce вычисляет coinbase midstate, если он не задан
+ */
+TEST_F(BlockTest, UpdateExtranonceWithoutMidstate) {
+    bitcoin::BlockTemplate tmpl;
+    tmpl.coinbase_tx.assign(constants::COINBASE_SIZE, 0x5A);
+    
+    tmpl.update_extranonce(42);
+    
+    EXPECT_EQ(tmpl.coinbase_midstate, crypto::compute_midstate(tmpl.coinbase_tx.data()));
+    EXPECT_EQ(tmpl.header.merkle_root,
+              crypto::sha256d(ByteSpan(tmpl.coinbase_tx.data(), tmpl.coinbase_tx.size())));
+}
+
+/**
+ * @brief Тест: правки CoinbaseTemplate совпадают с полной сборкой coinbase
+ */
+TEST_F(BlockTest, CoinbaseTemplatePatchesMatchBuild) {
+    Hash160 pubkey_hash{};
+    pubkey_hash.fill(0x42);
+    bitcoin::CoinbaseBuilder builder(pubkey_hash);
+    
+    auto coinbase = builder.make_template(800000, 312500000, 7);
+    EXPECT_EQ(coinbase.bytes(), builder.build(800000, 312500000, 7));
+    EXPECT_EQ(coinbase.extranonce_offset(), bitcoin::CoinbaseBuilder::EXTRANONCE_OFFSET);
+    EXPECT_EQ(coinbase.hashed_size(), constants::SHA256_BLOCK_SIZE);
+    
+    // Новая высота меняет свёрнутый блок, награда и extranonce - хвост
+    bitcoin::CoinbaseBuilder::update_template(coinbase, 800001, 312512345, 0xA1B2C3D4E5F6);
+    const Bytes rebuilt = builder.build(800001, 312512345, 0xA1B2C3D4E5F6);
+    EXPECT_EQ(coinbase.bytes(), rebuilt);
+    EXPECT_EQ(coinbase.prefix_state(), crypto::compute_midstate(rebuilt.data()));
+    EXPECT_EQ(coinbase.txid(), bitcoin::compute_txid(rebuilt));
+    
+    // Длина scriptsig сходится с раскладкой: coinbase разбирается как транзакция
+    EXPECT_EQ(rebuilt[bitcoin::CoinbaseLayout::SCRIPTSIG_LEN_OFFSET], 28);
+    auto parsed = bitcoin::transaction_txid(rebuilt);
+    ASSERT_TRUE(parsed);
+    EXPECT_EQ(*parsed, bitcoin::compute_txid(rebuilt));
+    
+    // Общая форма: префикс не кратен блоку, extranonce в хвосте
+    Bytes prefix(70, 0x11);
+    Bytes suffix(30, 0x22);
+    bitcoin::CoinbaseTemplate generic(ByteSpan(prefix), 4, ByteSpan(suffix));
+    const std::array<uint8_t, 4> extranonce = {0xDE, 0xAD, 0xBE, 0xEF};
+    generic.set_extranonce(extranonce);
+    
+    Bytes full = prefix;
+    full.insert(full.end(), extranonce.begin(), extranonce.end());
+    full.insert(full.end(), suffix.begin(), suffix.end());
+    EXPECT_EQ(generic.bytes(), full);
+    EXPECT_EQ(generic.suffix().size(), suffix.size());
+    EXPECT_EQ(generic.txid(), crypto::sha256d(ByteSpan(full)));
+    
+    // Правка свёрнутого префикса пересчитывает midstate
+    const std::array<uint8_t, 1> byte = {0x99};
+    generic.patch(10, byte);
+    full[10] = 0x99;
+    EXPECT_EQ(generic.txid(), crypto::sha256d(ByteSpan(full)));
+}
+
+/**
+ * @brief Тест: BlockSkeleton собирает блок с extranonce, версией и nonce задания
+ */
+TEST_F(BlockTest, SkeletonBuildMatchesTemplate) {
+    bitcoin::BlockTemplate tmpl;
+    tmpl.height = 800000;
+    tmpl.header.version = 0x20000000;
+    tmpl.header.timestamp = 1700000000;
+    tmpl.header.bits = 0x1d00ffff;
+    tmpl.coinbase_tx.resize(constants::COINBASE_SIZE);
+    for (std::size_t i = 0; i < tmpl.coinbase_tx.size(); ++i) {
+        tmpl.coinbase_tx[i] = static_cast<uint8_t>(i * 7);
+    }
+    tmpl.coinbase_midstate = crypto::compute_midstate(tmpl.coinbase_tx.data());
+    
+    bitcoin::BlockSkeleton skeleton(tmpl);
+    ASSERT_FALSE(skeleton.empty());
+    EXPECT_EQ(skeleton.height(), 800000u);
+    
+    constexpr uint64_t extranonce = 0x0000123456789ABC;
+    constexpr uint32_t version = 0x20002000;
+    auto block = skeleton.build(extranonce, version, 1700000042, 0xDEADBEEF);
+    ASSERT_EQ(block.size(), constants::BLOCK_HEADER_SIZE + 1 + constants::COINBASE_SIZE);
+    
+    auto header = tmpl.header_for_extranonce(extranonce);
+    header.version = version;
+    header.timestamp = 1700000042;
+    header.nonce = 0xDEADBEEF;
+    auto expected_header = header.serialize();
+    EXPECT_TRUE(std::equal(expected_header.begin(), expected_header.end(), block.begin()));
+    EXPECT_EQ(block[constants::BLOCK_HEADER_SIZE], 0x01);
+    
+    // Coinbase в блоке содержит extranonce задания
+    bitcoin::BlockTemplate patched = tmpl;
+    patched.update_extranonce(extranonce);
+    EXPECT_TRUE(std::equal(patched.coinbase_tx.begin(), patched.coinbase_tx.end(),
+                           block.begin() + constants::BLOCK_HEADER_SIZE + 1));
+    
+    // version = 0 - версия шаблона
+    auto plain = skeleton.build(extranonce, 0, 1700000042, 0xDEADBEEF);
+    header.version = tmpl.header.version;
+    expected_header = header.serialize();
+    EXPECT_TRUE(std::equal(expected_header.begin(), expected_header.end(), plain.begin()));
+}
+
+/**
+ * @brief Тест: без coinbase скелет пустой
+ */
+TEST_F(BlockTest, SkeletonWithoutCoinbaseIsEmpty) {
+    bitcoin::BlockTemplate tmpl;
+    bitcoin::BlockSkeleton skeleton(tmpl);
+    EXPECT_TRUE(skeleton.empty());
+    EXPECT_TRUE(skeleton.build(1, 0, 0, 0).empty());
+}
+
 /**
  * @brief Тест: проверка PoW
  */
@@ -249,4 +497,68 @@ TEST_F(BlockTest, ProofOfWork) {
     EXPECT_EQ(target.size(), 32);
 }
 
+namespace {
+
+/**
+ * @brief Транзакция с одним входом и одним выходом (witness - по желанию)
+ */
+Bytes make_test_tx(uint8_t tag, bool segwit) {
+    Bytes tx = {0x02, 0x00, 0x00, 0x00};
+    if (segwit) {
+        tx.insert(tx.end(), {0x00, 0x01});
+    }
+    tx.push_back(0x01);                      // входов
+    tx.insert(tx.end(), 32, tag);            // prevout txid
+    tx.insert(tx.end(), {0x00, 0x00, 0x00, 0x00});
+    tx.insert(tx.end(), {0x02, tag, tag});   // scriptSig
+    tx.insert(tx.end(), 4, 0xFF);            // sequence
+    tx.push_back(0x01);                      // выходов
+    tx.insert(tx.end(), 8, tag);             // value
+    tx.insert(tx.end(), {0x01, 0x51});       // scriptPubKey
+    if (segwit) {
+        tx.insert(tx.end(), {0x01, 0x03, tag, tag, tag});  // witness
+    }
+    tx.insert(tx.end(), 4, 0x00);            // locktime
+    return tx;
+}
+
+} // anonymous namespace
+
+/**
+ * @brief Тест: merkle root тела блока по txid (witness не входит в txid)
+ */
+TEST_F(BlockTest, BlockMerkleRootFromTransactions) {
+    Bytes block(constants::BLOCK_HEADER_SIZE, 0);
+    block.push_back(0x02);
+    auto legacy = make_test_tx(0x11, false);
+    auto segwit = make_test_tx(0x22, true);
+    block.insert(block.end(), legacy.begin(), legacy.end());
+    block.insert(block.end(), segwit.begin(), segwit.end());
+    
+    auto root = bitcoin::compute_block_merkle_root(block);
+    ASSERT_TRUE(root) << root.error().message;
+    
+    auto stripped = make_test_tx(0x22, false);
+    auto expected = bitcoin::compute_merkle_root({crypto::sha256d(legacy), crypto::sha256d(stripped)});
+    EXPECT_EQ(*root, expected);
+    
+    // Обрезанный блок и лишние байты - ошибка
+    Bytes truncated(block.begin(), block.end() - 1);
+    EXPECT_FALSE(bitcoin::compute_block_merkle_root(truncated));
+    block.push_back(0x00);
+    EXPECT_FALSE(bitcoin::compute_block_merkle_root(block));
+    EXPECT_TRUE(bitcoin::compute_block_merkle_root(block, true));
+    block.push_back(0x01);
+    EXPECT_FALSE(bitcoin::compute_block_merkle_root(block, true));
+}
+
+/**
+ * @brief Тест: субсидия блока по halving
+ */
+TEST_F(BlockTest, BlockSubsidyHalves) {
+    EXPECT_EQ(bitcoin::block_subsidy(0), 50'00000000LL);
+    EXPECT_EQ(bitcoin::block_subsidy(840'000), constants::BLOCK_REWARD_SATOSHI);
+    EXPECT_EQ(bitcoin::block_subsidy(64 * constants::HALVING_INTERVAL), 0);
+}
+
 } // namespace quaxis::tests
@@ -0,0 +1,72 @@
+/**
+ * @file test_block_arena.cpp
+ * @brief Тесты арены временных данных блока (BlockArena)
+ */
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "core/block_arena.hpp"
+#include "core/template_generator.hpp"
+
+namespace quaxis::tests {
+
+/**
+ * @brief Тест: после reset() арена раздаёт тот же буфер заново
+ */
+TEST(BlockArenaTest, ResetReusesBuffer) {
+    core::BlockArena arena(4096);
+    const void* first = nullptr;
+    {
+        PmrBytes bytes(arena.resource());
+        bytes.resize(512);
+        first = bytes.data();
+    }
+    arena.reset();
+    EXPECT_EQ(arena.generation(), 1u);
+
+    PmrBytes bytes(arena.resource());
+    bytes.resize(512);
+    EXPECT_EQ(bytes.data(), first);
+    EXPECT_EQ(arena.overflow_allocations(), 0u);
+}
+
+/**
+ * @brief Тест: выделения сверх буфера считаются и освобождаются в reset()
+ */
+TEST(BlockArenaTest, CountsOverflowAllocations) {
+    core::BlockArena arena(256);
+    {
+        std::pmr::vector<uint32_t> values(arena.resource());
+        values.resize(1024);
+        EXPECT_EQ(values[1023], 0u);
+    }
+    EXPECT_GT(arena.overflow_allocations(), 0u);
+
+    const uint64_t overflow = arena.overflow_allocations();
+    arena.reset();
+    PmrBytes small(arena.resource());
+    small.resize(64);
+    EXPECT_EQ(arena.overflow_allocations(), overflow);
+}
+
+/**
+ * @brief Тест: coinbase в арене генератора - шаблоны не зависят от прошлых
+ */
+TEST(BlockArenaTest, TemplateGeneratorCoinbaseSurvivesReset) {
+    core::TemplateGenerator generator(core::TemplateGeneratorConfig{});
+    Hash256 prev{};
+    prev.fill(0x11);
+    generator.update_chain_tip(prev, 800'000, 0x17034219, 312'500'000);
+
+    auto first = generator.generate_template(1);
+    auto other = generator.generate_template(2);
+    auto again = generator.generate_template(1);
+    ASSERT_TRUE(first && other && again);
+    EXPECT_NE(first->header.merkle_root, other->header.merkle_root);
+    EXPECT_EQ(again->header.merkle_root, first->header.merkle_root);
+    EXPECT_EQ(again->coinbase_midstate, first->coinbase_midstate);
+}
+
+} // namespace quaxis::tests
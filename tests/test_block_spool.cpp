@@ -0,0 +1,150 @@
+/**
+ * @file test_block_spool.cpp
+ * @brief Тесты spool найденных блоков
+ */
+
+#include <gtest/gtest.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <filesystem>
+#include <string>
+
+#include "mining/block_spool.hpp"
+
+namespace quaxis::tests {
+
+namespace {
+
+/// @brief Временный файл spool, удаляется в деструкторе
+struct TempSpoolFile {
+    std::filesystem::path path;
+
+    explicit TempSpoolFile(const std::string& name)
+        : path(std::filesystem::temp_directory_path() /
+               ("quaxis_spool_" + name + "_" + std::to_string(getpid()) + ".dat")) {
+        std::filesystem::remove(path);
+    }
+    ~TempSpoolFile() { std::filesystem::remove(path); }
+
+    [[nodiscard]] SpoolConfig config(uint32_t slots = 4) const {
+        SpoolConfig config;
+        config.enabled = true;
+        config.path = path.string();
+        config.slots = slots;
+        config.max_block_mb = 1;
+        return config;
+    }
+};
+
+Bytes block_bytes(uint8_t fill, std::size_t size = 5000) {
+    return Bytes(size, fill);
+}
+
+Hash256 block_hash(uint8_t value) {
+    Hash256 hash{};
+    hash[0] = value;
+    return hash;
+}
+
+} // anonymous namespace
+
+TEST(BlockSpoolTest, UnsubmittedBlockIsReplayedOnce) {
+    TempSpoolFile file("replay");
+    {
+        mining::BlockSpool spool(file.config());
+        ASSERT_TRUE(spool.open());
+        ASSERT_TRUE(spool.append(mining::SpoolKind::Block, block_hash(1), block_bytes(0xA1)));
+        ASSERT_TRUE(spool.append(mining::SpoolKind::Block, block_hash(2), block_bytes(0xA2)));
+        // Повтор той же находки не занимает слот
+        ASSERT_TRUE(spool.append(mining::SpoolKind::Block, block_hash(2), block_bytes(0xA2)));
+        EXPECT_EQ(spool.spooled(), 2u);
+        spool.mark_submitted(mining::SpoolKind::Block, block_hash(2));
+    }
+    {
+        // "Падение" до подтверждения блока 1
+        mining::BlockSpool spool(file.config());
+        ASSERT_TRUE(spool.open());
+        auto pending = spool.take_pending();
+        ASSERT_EQ(pending.size(), 1u);
+        EXPECT_EQ(pending[0].kind, mining::SpoolKind::Block);
+        EXPECT_EQ(pending[0].hash, block_hash(1));
+        EXPECT_EQ(pending[0].payload, block_bytes(0xA1));
+    }
+    {
+        mining::BlockSpool spool(file.config());
+        ASSERT_TRUE(spool.open());
+        EXPECT_TRUE(spool.take_pending().empty());
+    }
+}
+
+TEST(BlockSpoolTest, SubmittedBeforeSpooledIsNotReplayed) {
+    TempSpoolFile file("early");
+    {
+        mining::BlockSpool spool(file.config());
+        ASSERT_TRUE(spool.open());
+        // Сеть приняла блок раньше, чем канал spool его записал
+        spool.mark_submitted(mining::SpoolKind::Block, block_hash(7));
+        ASSERT_TRUE(spool.append(mining::SpoolKind::Block, block_hash(7), block_bytes(0x07)));
+        // Тот же хеш, но находка merged mining - отдельная запись
+        ASSERT_TRUE(spool.append(mining::SpoolKind::AuxPow, block_hash(7), block_bytes(0x17, 300)));
+    }
+    mining::BlockSpool spool(file.config());
+    ASSERT_TRUE(spool.open());
+    auto pending = spool.take_pending();
+    ASSERT_EQ(pending.size(), 1u);
+    EXPECT_EQ(pending[0].kind, mining::SpoolKind::AuxPow);
+    EXPECT_EQ(pending[0].payload.size(), 300u);
+}
+
+TEST(BlockSpoolTest, RingKeepsNewestInOrder) {
+    TempSpoolFile file("ring");
+    {
+        mining::BlockSpool spool(file.config(2));
+        ASSERT_TRUE(spool.open());
+        for (uint8_t i = 1; i <= 3; ++i) {
+            ASSERT_TRUE(spool.append(mining::SpoolKind::Block, block_hash(i), block_bytes(i)));
+        }
+    }
+    mining::BlockSpool spool(file.config(2));
+    ASSERT_TRUE(spool.open());
+    auto pending = spool.take_pending();
+    ASSERT_EQ(pending.size(), 2u);
+    EXPECT_EQ(pending[0].hash, block_hash(2));
+    EXPECT_EQ(pending[1].hash, block_hash(3));
+    EXPECT_LT(pending[0].sequence, pending[1].sequence);
+}
+
+TEST(BlockSpoolTest, TornPayloadIsSkipped) {
+    TempSpoolFile file("torn");
+    {
+        mining::BlockSpool spool(file.config());
+        ASSERT_TRUE(spool.open());
+        ASSERT_TRUE(spool.append(mining::SpoolKind::Block, block_hash(1), block_bytes(0x11)));
+    }
+    // Запись 1 - в слоте 1: портим payload после страницы заголовка
+    const int fd = ::open(file.path.c_str(), O_WRONLY);
+    ASSERT_GE(fd, 0);
+    const uint8_t garbage = 0xFF;
+    const off_t offset = static_cast<off_t>(mining::BlockSpool::PAGE_SIZE + 1024 * 1024 +
+                                            mining::BlockSpool::PAGE_SIZE + 100);
+    ASSERT_EQ(::pwrite(fd, &garbage, 1, offset), 1);
+    ::close(fd);
+
+    mining::BlockSpool spool(file.config());
+    ASSERT_TRUE(spool.open());
+    EXPECT_TRUE(spool.take_pending().empty());
+}
+
+TEST(BlockSpoolTest, RejectsOversizedBlock) {
+    TempSpoolFile file("oversized");
+    mining::BlockSpool spool(file.config());
+    ASSERT_TRUE(spool.open());
+    EXPECT_FALSE(spool.append(mining::SpoolKind::Block, block_hash(1),
+                              block_bytes(0, 1024 * 1024 + 1)));
+    EXPECT_TRUE(spool.append(mining::SpoolKind::Block, block_hash(1),
+                             block_bytes(0, 1024 * 1024)));
+}
+
+} // namespace quaxis::tests
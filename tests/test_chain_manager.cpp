@@ -7,6 +7,16 @@
 
 #include "merged/chain_manager.hpp"
 #include "merged/chain_interface.hpp"
+#include "merged/template_cache.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
 
 using namespace quaxis;
 using namespace quaxis::merged;
@@ -290,7 +300,8 @@ TEST_F(ChainManagerCallbackTest, SetBlockFoundCallback) {
     manager.set_block_found_callback([this](
         const std::string& chain_name,
         [[maybe_unused]] uint32_t height,
-        [[maybe_unused]] const Hash256& block_hash
+        [[maybe_unused]] const Hash256& block_hash,
+        [[maybe_unused]] std::chrono::microseconds submit_latency
     ) {
         callback_called = true;
         last_chain_name = chain_name;
@@ -300,6 +311,220 @@ TEST_F(ChainManagerCallbackTest, SetBlockFoundCallback) {
     EXPECT_FALSE(callback_called);
 }
 
+namespace {
+
+/**
+ * @brief Aux chain без сети: шаблон с постоянным block_hash
+ */
+class StaticChain final : public IChain {
+public:
+    [[nodiscard]] std::string_view name() const noexcept override { return "static"; }
+    [[nodiscard]] std::string_view ticker() const noexcept override { return "STC"; }
+    [[nodiscard]] const Hash256& chain_id() const noexcept override { return chain_id_; }
+    [[nodiscard]] uint32_t priority() const noexcept override { return 100; }
+    
+    [[nodiscard]] ChainInfo get_info() const noexcept override {
+        ChainInfo info;
+        info.name = "static";
+        info.status = status();
+        return info;
+    }
+    
+    [[nodiscard]] ChainStatus status() const noexcept override {
+        return connected_ ? ChainStatus::Ready : ChainStatus::Disconnected;
+    }
+    
+    [[nodiscard]] Result<void> connect() override {
+        connected_ = true;
+        return {};
+    }
+    
+    void disconnect() override { connected_ = false; }
+    [[nodiscard]] bool is_connected() const noexcept override { return connected_; }
+    
+    [[nodiscard]] Result<AuxBlockTemplate> get_block_template() override {
+        AuxBlockTemplate tmpl;
+        tmpl.chain_id = chain_id_;
+        tmpl.target_bits = 0x207fffff;
+        tmpl.height = 1000;
+        tmpl.block_hash.fill(0xAB);
+        return tmpl;
+    }
+    
+    [[nodiscard]] Result<void> submit_block(
+        [[maybe_unused]] const AuxPow& auxpow,
+        [[maybe_unused]] const AuxBlockTemplate& block_template
+    ) override {
+        return {};
+    }
+    
+    [[nodiscard]] bool meets_target(
+        const Hash256& pow_hash,
+        const AuxBlockTemplate& current_template
+    ) const noexcept override {
+        return quaxis::merged::meets_target(pow_hash, current_template.target_bits);
+    }
+    
+    void set_enabled(bool enabled) override { enabled_ = enabled; }
+    [[nodiscard]] bool is_enabled() const noexcept override { return enabled_; }
+    void set_priority([[maybe_unused]] uint32_t priority) override {}
+    
+private:
+    Hash256 chain_id_{0x01, 0x02, 0x03};
+    std::atomic<bool> connected_{false};
+    std::atomic<bool> enabled_{true};
+};
+
+} // anonymous namespace
+
+TEST_F(ChainManagerCallbackTest, CommitmentSnapshotPublishedOnChange) {
+    std::vector<std::unique_ptr<IChain>> chains;
+    chains.push_back(std::make_unique<StaticChain>());
+    ChainManager manager(config, std::move(chains));
+    
+    auto initial = manager.commitment_snapshot();
+    ASSERT_NE(initial, nullptr);
+    EXPECT_FALSE(initial->aux_commitment.has_value());
+    
+    std::atomic<int> notifications{0};
+    manager.set_commitment_callback([&](std::shared_ptr<const AuxCommitmentSnapshot> snapshot) {
+        EXPECT_NE(snapshot, nullptr);
+        notifications.fetch_add(1);
+    });
+    manager.start();
+    
+    for (int i = 0; i < 2000 && notifications.load() == 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ASSERT_EQ(notifications.load(), 1);
+    
+    // Новый снимок; прежний, удерживаемый читателем, не изменился
+    auto published = manager.commitment_snapshot();
+    ASSERT_TRUE(published->aux_commitment.has_value());
+    EXPECT_GT(published->sequence, initial->sequence);
+    EXPECT_FALSE(initial->aux_commitment.has_value());
+    EXPECT_EQ(manager.get_aux_commitment(), published->aux_commitment);
+    
+    // Выключение и включение chain - по одному снимку и вызову callback
+    ASSERT_TRUE(manager.set_chain_enabled("static", false));
+    EXPECT_EQ(notifications.load(), 2);
+    EXPECT_FALSE(manager.get_aux_commitment().has_value());
+    ASSERT_TRUE(manager.set_chain_enabled("static", true));
+    EXPECT_EQ(notifications.load(), 3);
+    EXPECT_EQ(manager.get_aux_commitment(), published->aux_commitment);
+    
+    manager.stop();
+}
+
+namespace {
+
+/// @brief Временный файл кеша шаблонов, удаляется в деструкторе
+struct TempCacheFile {
+    std::filesystem::path path{std::filesystem::temp_directory_path() /
+                               ("quaxis_aux_templates_" + std::to_string(getpid()) + ".dat")};
+    
+    TempCacheFile() { std::filesystem::remove(path); }
+    ~TempCacheFile() { std::filesystem::remove(path); }
+};
+
+} // anonymous namespace
+
+TEST(TemplateCacheTest, RoundTripAndCorruption) {
+    TempCacheFile file;
+    AuxBlockTemplate tmpl;
+    tmpl.block_hash.fill(0x5A);
+    tmpl.chain_id.fill(0x07);
+    tmpl.target_bits = 0x1b0404cb;
+    tmpl.height = 712345;
+    const auto saved_at = std::chrono::system_clock::time_point(std::chrono::seconds(1700000000));
+    
+    {
+        TemplateCache cache;
+        ASSERT_TRUE(cache.open(file.path.string()));
+        EXPECT_FALSE(cache.load("namecoin").has_value());
+        EXPECT_TRUE(cache.store("namecoin", tmpl, saved_at));
+        EXPECT_FALSE(cache.store(std::string(TemplateCache::MAX_NAME + 1, 'x'), tmpl));
+    }
+    
+    // Другой процесс видит запись после повторного открытия
+    TemplateCache cache;
+    ASSERT_TRUE(cache.open(file.path.string()));
+    auto loaded = cache.load("namecoin");
+    ASSERT_TRUE(loaded.has_value());
+    EXPECT_EQ(loaded->block_template.block_hash, tmpl.block_hash);
+    EXPECT_EQ(loaded->block_template.chain_id, tmpl.chain_id);
+    EXPECT_EQ(loaded->block_template.target_bits, tmpl.target_bits);
+    EXPECT_EQ(loaded->block_template.height, tmpl.height);
+    EXPECT_TRUE(loaded->block_template.from_cache);
+    EXPECT_EQ(loaded->saved_at, saved_at);
+    
+    // Повреждённый слот не читается
+    {
+        std::FILE* raw = std::fopen(file.path.c_str(), "r+b");
+        ASSERT_NE(raw, nullptr);
+        std::fseek(raw, 64 + 40, SEEK_SET);
+        std::fputc(0xFF, raw);
+        std::fclose(raw);
+    }
+    EXPECT_FALSE(cache.load("namecoin").has_value());
+}
+
+TEST_F(ChainManagerCallbackTest, WarmStartFromTemplateCache) {
+    TempCacheFile file;
+    config.template_cache_path = file.path.string();
+    
+    // Первый запуск: шаблон ноды попадает в кеш
+    std::optional<AuxCommitment> commitment;
+    {
+        std::vector<std::unique_ptr<IChain>> chains;
+        chains.push_back(std::make_unique<StaticChain>());
+        ChainManager manager(config, std::move(chains));
+        EXPECT_FALSE(manager.commitment_snapshot()->aux_commitment.has_value());
+        manager.start();
+        for (int i = 0; i < 2000 && !manager.get_aux_commitment(); ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        commitment = manager.get_aux_commitment();
+        ASSERT_TRUE(commitment.has_value());
+        EXPECT_FALSE(manager.commitment_snapshot()->from_cache);
+        manager.stop();
+    }
+    
+    // Перезапуск: commitment из кеша сразу, до ответа ноды
+    std::vector<std::unique_ptr<IChain>> chains;
+    chains.push_back(std::make_unique<StaticChain>());
+    ChainManager manager(config, std::move(chains));
+    auto warm = manager.commitment_snapshot();
+    EXPECT_EQ(warm->aux_commitment, commitment);
+    EXPECT_TRUE(warm->from_cache);
+    
+    // Опрос подтверждает шаблон: тот же commitment, уже не из кеша
+    manager.start();
+    for (int i = 0; i < 2000 && manager.commitment_snapshot()->from_cache; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    auto confirmed = manager.commitment_snapshot();
+    EXPECT_FALSE(confirmed->from_cache);
+    EXPECT_EQ(confirmed->aux_commitment, commitment);
+    EXPECT_GT(confirmed->sequence, warm->sequence);
+    manager.stop();
+    
+    // Устаревший кеш не используется
+    config.template_cache_max_age = 0;
+    {
+        TemplateCache cache;
+        ASSERT_TRUE(cache.open(file.path.string()));
+        AuxBlockTemplate old;
+        old.chain_id = Hash256{0x01, 0x02, 0x03};
+        old.target_bits = 0x207fffff;
+        ASSERT_TRUE(cache.store("static", old, std::chrono::system_clock::now() - std::chrono::hours(1)));
+    }
+    std::vector<std::unique_ptr<IChain>> stale_chains;
+    stale_chains.push_back(std::make_unique<StaticChain>());
+    ChainManager cold(config, std::move(stale_chains));
+    EXPECT_FALSE(cold.commitment_snapshot()->aux_commitment.has_value());
+}
+
 // =============================================================================
 // ChainConfig Tests
 // =============================================================================
@@ -0,0 +1,77 @@
+/**
+ * @file test_circuit_breaker.cpp
+ * @brief Тесты для размыкателя опроса aux chain
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+
+#include "merged/circuit_breaker.hpp"
+
+namespace quaxis::tests {
+
+using namespace std::chrono_literals;
+using merged::BreakerState;
+using merged::CircuitBreaker;
+
+TEST(CircuitBreakerTest, OpensAfterConsecutiveFailures) {
+    CircuitBreaker breaker(3, 30s);
+    const auto t0 = CircuitBreaker::Clock::time_point{} + 1h;
+
+    EXPECT_TRUE(breaker.allow(t0));
+    EXPECT_FALSE(breaker.record_failure(t0));
+    EXPECT_FALSE(breaker.record_failure(t0));
+
+    // Успех сбрасывает счёт
+    EXPECT_FALSE(breaker.record_success());
+    EXPECT_EQ(breaker.consecutive_failures(), 0u);
+    EXPECT_FALSE(breaker.record_failure(t0));
+    EXPECT_FALSE(breaker.record_failure(t0));
+    EXPECT_TRUE(breaker.record_failure(t0));
+
+    EXPECT_EQ(breaker.state(), BreakerState::Open);
+    EXPECT_EQ(breaker.retry_at(), t0 + 30s);
+    EXPECT_FALSE(breaker.allow(t0 + 29s));
+}
+
+TEST(CircuitBreakerTest, HalfOpenProbeClosesOrBacksOff) {
+    CircuitBreaker breaker(1, 10s);
+    const auto t0 = CircuitBreaker::Clock::time_point{} + 1h;
+    EXPECT_TRUE(breaker.record_failure(t0));
+
+    // По истечении паузы - ровно один пробный опрос
+    EXPECT_TRUE(breaker.allow(t0 + 10s));
+    EXPECT_EQ(breaker.state(), BreakerState::HalfOpen);
+    EXPECT_FALSE(breaker.allow(t0 + 10s));
+
+    // Неудачная проба удваивает паузу, до MAX_OPEN_FACTOR
+    auto now = t0 + 10s;
+    auto expected = 20s;
+    for (int i = 0; i < 5; ++i) {
+        EXPECT_TRUE(breaker.record_failure(now));
+        EXPECT_EQ(breaker.retry_at(), now + expected);
+        now = breaker.retry_at();
+        EXPECT_TRUE(breaker.allow(now));
+        expected = std::min<std::chrono::seconds>(expected * 2, 80s);
+    }
+
+    // Удачная проба замыкает и возвращает исходную паузу
+    EXPECT_TRUE(breaker.record_success());
+    EXPECT_EQ(breaker.state(), BreakerState::Closed);
+    EXPECT_TRUE(breaker.allow(now));
+    EXPECT_TRUE(breaker.record_failure(now));
+    EXPECT_EQ(breaker.retry_at(), now + 10s);
+}
+
+TEST(CircuitBreakerTest, ZeroThresholdNeverOpens) {
+    CircuitBreaker breaker(0, 10s);
+    const auto t0 = CircuitBreaker::Clock::time_point{} + 1h;
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_FALSE(breaker.record_failure(t0));
+    }
+    EXPECT_EQ(breaker.state(), BreakerState::Closed);
+    EXPECT_TRUE(breaker.allow(t0));
+}
+
+} // namespace quaxis::tests
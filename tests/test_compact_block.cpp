@@ -0,0 +1,241 @@
+/**
+ * @file test_compact_block.cpp
+ * @brief Тесты для наброска блока, кеша mempool и синтеза FIBRE чанков
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "bitcoin/block.hpp"
+#include "crypto/siphash.hpp"
+#include "relay/block_reconstructor.hpp"
+#include "relay/compact_block.hpp"
+#include "relay/tx_cache.hpp"
+
+namespace quaxis::tests {
+
+namespace {
+
+/**
+ * @brief Legacy транзакция: один вход и один выход, scriptSig заданной длины
+ */
+Bytes make_tx(uint32_t seed, std::size_t script_size) {
+    Bytes tx = {0x01, 0x00, 0x00, 0x00, 0x01};
+    for (std::size_t i = 0; i < 32; ++i) {
+        tx.push_back(static_cast<uint8_t>(seed * 31 + i));
+    }
+    tx.insert(tx.end(), 4, 0x00);
+    tx.push_back(static_cast<uint8_t>(script_size));
+    for (std::size_t i = 0; i < script_size; ++i) {
+        tx.push_back(static_cast<uint8_t>(seed + i * 7));
+    }
+    tx.insert(tx.end(), 4, 0xFF);
+    tx.insert(tx.end(), {0x01, 0x00, 0xE1, 0xF5, 0x05, 0x00, 0x00, 0x00, 0x00, 0x01, 0x51});
+    tx.insert(tx.end(), 4, 0x00);
+    return tx;
+}
+
+/**
+ * @brief Блок из транзакций txs с верным merkle root
+ */
+Bytes make_block(const std::vector<Bytes>& txs) {
+    Bytes body;
+    body.push_back(static_cast<uint8_t>(txs.size()));
+    for (const auto& tx : txs) {
+        body.insert(body.end(), tx.begin(), tx.end());
+    }
+
+    bitcoin::BlockHeader header;
+    header.version = 0x20000000;
+    header.timestamp = 1700000000;
+    header.bits = 0x207fffff;
+    auto serialized = header.serialize();
+    Bytes block(serialized.begin(), serialized.end());
+    block.insert(block.end(), body.begin(), body.end());
+
+    header.merkle_root = *bitcoin::compute_block_merkle_root(block);
+    serialized = header.serialize();
+    std::copy(serialized.begin(), serialized.end(), block.begin());
+    return block;
+}
+
+std::vector<Bytes> make_txs(std::size_t count) {
+    std::vector<Bytes> txs;
+    for (std::size_t i = 0; i < count; ++i) {
+        txs.push_back(make_tx(static_cast<uint32_t>(i + 1), 40 + (i * 37) % 200));
+    }
+    return txs;
+}
+
+} // anonymous namespace
+
+TEST(CompactBlockTest, SipHashReferenceVectors) {
+    // Векторы из статьи SipHash: ключ 00..0f, сообщение 00..(n-1)
+    const uint64_t k0 = 0x0706050403020100ULL;
+    const uint64_t k1 = 0x0F0E0D0C0B0A0908ULL;
+    Bytes message;
+    EXPECT_EQ(crypto::siphash24(k0, k1, message), 0x726FDB47DD0E0E31ULL);
+    for (uint8_t i = 0; i < 15; ++i) {
+        message.push_back(i);
+    }
+    EXPECT_EQ(crypto::siphash24(k0, k1, message), 0xA129CA6149BE45E5ULL);
+}
+
+TEST(CompactBlockTest, BlockTransactionsSplitsBlock) {
+    const auto txs = make_txs(5);
+    const auto block = make_block(txs);
+    auto split = bitcoin::block_transactions(block);
+    ASSERT_TRUE(split);
+    ASSERT_EQ(split->size(), txs.size());
+    for (std::size_t i = 0; i < txs.size(); ++i) {
+        EXPECT_TRUE(std::equal((*split)[i].begin(), (*split)[i].end(), txs[i].begin(), txs[i].end()));
+    }
+
+    auto truncated = block;
+    truncated.pop_back();
+    EXPECT_FALSE(bitcoin::block_transactions(truncated));
+}
+
+TEST(CompactBlockTest, SketchSurvivesPartsInAnyOrder) {
+    const auto block = make_block(make_txs(60));
+    auto sketch = relay::make_block_sketch(block, 0x1122334455667788ULL, 256);
+    ASSERT_TRUE(sketch);
+    EXPECT_EQ(sketch->block_size(), block.size());
+    EXPECT_EQ(sketch->data_chunk_count(), (block.size() + 255) / 256);
+
+    auto parts = relay::serialize_sketch(*sketch, 200);
+    ASSERT_GT(parts.size(), 2u);
+
+    relay::SketchAssembler assembler;
+    for (std::size_t i = parts.size(); i > 0; --i) {
+        EXPECT_FALSE(assembler.complete());
+        EXPECT_EQ(assembler.add_part(parts[i - 1]), relay::ChunkOutcome::Accepted);
+    }
+    ASSERT_TRUE(assembler.complete());
+    EXPECT_EQ(assembler.add_part(parts[0]), relay::ChunkOutcome::Duplicate);
+
+    const auto& rebuilt = assembler.sketch();
+    EXPECT_EQ(rebuilt.header.hash(), sketch->header.hash());
+    EXPECT_EQ(rebuilt.nonce, sketch->nonce);
+    EXPECT_EQ(rebuilt.chunk_size, 256u);
+    ASSERT_EQ(rebuilt.txs.size(), sketch->txs.size());
+    for (std::size_t i = 0; i < rebuilt.txs.size(); ++i) {
+        EXPECT_EQ(rebuilt.txs[i].short_id, sketch->txs[i].short_id);
+        EXPECT_EQ(rebuilt.txs[i].size, sketch->txs[i].size);
+    }
+
+    // Обрезанная часть отбрасывается
+    relay::SketchAssembler other;
+    auto truncated = parts[1];
+    truncated.pop_back();
+    EXPECT_EQ(other.add_part(truncated), relay::ChunkOutcome::Rejected);
+}
+
+TEST(CompactBlockTest, TxCacheMatchesByShortIdAndEvictsOldest) {
+    const auto txs = make_txs(20);
+    const auto block = make_block(txs);
+    auto sketch = relay::make_block_sketch(block, 42, 256);
+    ASSERT_TRUE(sketch);
+
+    relay::TxCache cache(64);
+    for (std::size_t i = 1; i < txs.size(); ++i) {
+        if (i != 7) {
+            EXPECT_TRUE(cache.add(txs[i]));
+        }
+    }
+    EXPECT_FALSE(cache.add(txs[3]));
+    EXPECT_TRUE(cache.add(make_tx(999, 50)));  // не из блока
+    EXPECT_EQ(cache.size(), 19u);
+
+    std::vector<relay::CachedTx> found;
+    EXPECT_EQ(cache.match(*sketch, found), txs.size() - 2);
+    ASSERT_EQ(found.size(), txs.size());
+    EXPECT_EQ(found[0], nullptr);  // coinbase
+    EXPECT_EQ(found[7], nullptr);
+    ASSERT_NE(found[5], nullptr);
+    EXPECT_EQ(*found[5], txs[5]);
+
+    // Другой nonce - другие short id, те же транзакции
+    auto resketch = relay::make_block_sketch(block, 43, 256);
+    ASSERT_TRUE(resketch);
+    EXPECT_EQ(cache.match(*resketch, found), txs.size() - 2);
+
+    relay::TxCache small(2);
+    EXPECT_TRUE(small.add(txs[1]));
+    EXPECT_TRUE(small.add(txs[2]));
+    EXPECT_TRUE(small.add(txs[3]));
+    EXPECT_EQ(small.size(), 2u);
+    EXPECT_TRUE(small.add(txs[1]));  // вытеснена - снова добавляется
+
+    relay::TxCache disabled(0);
+    EXPECT_FALSE(disabled.add(txs[1]));
+}
+
+TEST(CompactBlockTest, SynthesizedChunksLeaveOnlyGapsToFec) {
+    const auto txs = make_txs(80);
+    const auto block = make_block(txs);
+    constexpr uint16_t CHUNK = 256;
+    auto sketch = relay::make_block_sketch(block, 7, CHUNK);
+    ASSERT_TRUE(sketch);
+    const auto data_chunks = static_cast<uint16_t>(sketch->data_chunk_count());
+
+    // Кеш без coinbase и двух транзакций
+    relay::TxCache cache(128);
+    for (std::size_t i = 1; i < txs.size(); ++i) {
+        if (i != 20 && i != 55) {
+            cache.add(txs[i]);
+        }
+    }
+    std::vector<relay::CachedTx> found;
+    cache.match(*sketch, found);
+    std::vector<ByteSpan> spans;
+    for (const auto& tx : found) {
+        spans.push_back(tx ? ByteSpan(*tx) : ByteSpan{});
+    }
+
+    relay::FecParams params;
+    params.data_chunk_count = data_chunks;
+    params.fec_chunk_count = 12;
+    relay::BlockReconstructor reconstructor(sketch->header.hash(), 100, params);
+    Bytes assembled;
+    reconstructor.set_block_callback([&](ByteSpan data, uint32_t, const Hash256&) {
+        assembled.assign(data.begin(), data.end());
+    });
+
+    std::vector<uint16_t> synthesized_ids;
+    const std::size_t synthesized = relay::synthesize_chunks(*sketch, spans, [&](uint16_t id, ByteSpan data) {
+        // Синтезированный чанк совпадает с чанком отправителя
+        const std::size_t begin = std::size_t{id} * CHUNK;
+        const std::size_t end = std::min(block.size(), begin + CHUNK);
+        EXPECT_TRUE(std::equal(data.begin(), data.end(), block.begin() + static_cast<std::ptrdiff_t>(begin),
+                               block.begin() + static_cast<std::ptrdiff_t>(end)));
+        EXPECT_TRUE(reconstructor.on_chunk(id, false, data));
+        synthesized_ids.push_back(id);
+    });
+    EXPECT_EQ(synthesized, synthesized_ids.size());
+    const std::size_t missing = data_chunks - synthesized;
+    ASSERT_GT(missing, 0u);
+    ASSERT_LE(missing, 12u);
+    EXPECT_GT(synthesized, std::size_t{data_chunks} * 3 / 4);
+    EXPECT_FALSE(reconstructor.is_complete());
+
+    // Сеть досылает только missing FEC чанков
+    std::vector<ByteSpan> chunks;
+    for (std::size_t i = 0; i < data_chunks; ++i) {
+        const std::size_t begin = i * CHUNK;
+        chunks.emplace_back(block.data() + begin, std::min<std::size_t>(CHUNK, block.size() - begin));
+    }
+    auto parity = relay::encode_fec_chunks(params, chunks);
+    ASSERT_TRUE(parity);
+    for (std::size_t f = 0; f < missing; ++f) {
+        EXPECT_TRUE(reconstructor.on_chunk(static_cast<uint16_t>(f), true, (*parity)[f]));
+    }
+    ASSERT_TRUE(reconstructor.is_complete());
+    ASSERT_GE(assembled.size(), block.size());
+    EXPECT_TRUE(std::equal(block.begin(), block.end(), assembled.begin()));
+}
+
+} // namespace quaxis::tests
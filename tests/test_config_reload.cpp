@@ -0,0 +1,91 @@
+/**
+ * @file test_config_reload.cpp
+ * @brief Тесты сравнения конфигураций для перезагрузки (SIGHUP)
+ */
+
+#include <gtest/gtest.h>
+
+#include "core/config_reload.hpp"
+
+namespace quaxis::tests {
+
+namespace {
+
+Config make_config() {
+    Config config;
+    config.relay.peers = {{"10.0.0.1", 8336, false}, {"10.0.0.2", 8336, true}};
+    MergedChainConfig chain;
+    chain.name = "namecoin";
+    config.merged_mining.chains.push_back(chain);
+    chain.name = "syscoin";
+    config.merged_mining.chains.push_back(chain);
+    return config;
+}
+
+} // anonymous namespace
+
+/**
+ * @brief Тест: одинаковые конфигурации - изменений нет
+ */
+TEST(ConfigReloadTest, IdenticalConfigsHaveNoChanges) {
+    const Config config = make_config();
+    const auto changes = diff_config(config, config);
+    EXPECT_TRUE(changes.empty());
+    EXPECT_TRUE(changes.restart_required.empty());
+}
+
+/**
+ * @brief Тест: каждая применимая группа попадает в свои поля
+ */
+TEST(ConfigReloadTest, CollectsHotChanges) {
+    const Config current = make_config();
+    Config next = current;
+    next.mining.share_difficulty = 64.0;
+    next.server.vardiff.target_shares_per_minute = 6.0;
+    next.relay.peers[1].trusted = false;
+    next.relay.peers.push_back({"10.0.0.3", 9000, false});
+    next.relay.peers.erase(next.relay.peers.begin());
+    next.merged_mining.chains[1].enabled = false;
+
+    const auto changes = diff_config(current, next);
+    EXPECT_EQ(changes.share_difficulty, std::optional<double>{64.0});
+    ASSERT_TRUE(changes.vardiff.has_value());
+    EXPECT_EQ(changes.vardiff->target_shares_per_minute, 6.0);
+
+    // Пир с другими параметрами - удалить и добавить заново
+    ASSERT_EQ(changes.relay_peers_removed.size(), 2u);
+    EXPECT_EQ(changes.relay_peers_removed[0].host, "10.0.0.1");
+    EXPECT_EQ(changes.relay_peers_removed[1].host, "10.0.0.2");
+    ASSERT_EQ(changes.relay_peers_added.size(), 2u);
+    EXPECT_FALSE(changes.relay_peers_added[0].trusted);
+    EXPECT_EQ(changes.relay_peers_added[1].port, 9000);
+
+    ASSERT_EQ(changes.chains_toggled.size(), 1u);
+    EXPECT_EQ(changes.chains_toggled[0], (std::pair<std::string, bool>{"syscoin", false}));
+
+    // Всё применимо без перезапуска
+    EXPECT_TRUE(changes.restart_required.empty());
+
+    // После применения следующий diff пуст
+    Config applied = current;
+    changes.apply_to(applied);
+    EXPECT_TRUE(applied == next);
+}
+
+/**
+ * @brief Тест: параметры устройства подсистем требуют перезапуска
+ */
+TEST(ConfigReloadTest, ReportsRestartOnlySections) {
+    const Config current = make_config();
+    Config next = current;
+    next.mining.job_queue_size = current.mining.job_queue_size * 2;
+    next.server.port = static_cast<uint16_t>(current.server.port + 1);
+    next.merged_mining.chains.pop_back();  // Набор chains изменился
+
+    const auto changes = diff_config(current, next);
+    EXPECT_TRUE(changes.empty());
+    EXPECT_EQ(changes.restart_required,
+              (std::vector<std::string>{"server", "mining", "merged_mining"}));
+}
+
+} // namespace quaxis::tests
@@ -0,0 +1,245 @@
+/**
+ * @file test_coro_io.cpp
+ * @brief Тесты корутин Task и ввода-вывода IoLoop/AsyncSocket
+ */
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+
+#include "core/task.hpp"
+#include "network/coro_io.hpp"
+
+namespace quaxis::tests {
+
+using namespace std::chrono_literals;
+
+namespace {
+
+core::Task<int> answer() {
+    co_return 42;
+}
+
+core::Task<int> add_nested(int depth) {
+    if (depth == 0) {
+        co_return 0;
+    }
+    int below = co_await add_nested(depth - 1);
+    co_return below + 1;
+}
+
+core::Task<void> nothing() {
+    co_return;
+}
+
+core::Task<int> failing() {
+    throw std::runtime_error("boom");
+    co_return 0;
+}
+
+/**
+ * @brief Пара соединённых сокетов: [0] под loop, [1] - обычный блокирующий
+ */
+std::array<int, 2> make_pair() {
+    std::array<int, 2> fds{-1, -1};
+    EXPECT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds.data()), 0);
+    return fds;
+}
+
+/**
+ * @brief Listening сокет на свободном порту loopback
+ */
+int listen_loopback(uint16_t& port) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = 0;
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+    bind(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr));
+    listen(fd, 4);
+    socklen_t length = sizeof(addr);
+    getsockname(fd, reinterpret_cast<struct sockaddr*>(&addr), &length);
+    port = ntohs(addr.sin_port);
+    return fd;
+}
+
+} // anonymous namespace
+
+// =============================================================================
+// Task
+// =============================================================================
+
+/**
+ * @brief Тест: результат и вложенные co_await
+ */
+TEST(CoroTaskTest, ReturnsValuesThroughNestedAwaits) {
+    network::IoLoop loop;
+    ASSERT_TRUE(loop.start().has_value());
+
+    EXPECT_EQ(loop.block_on(answer()), 42);
+    EXPECT_EQ(loop.block_on(add_nested(1000)), 1000);
+}
+
+/**
+ * @brief Тест: исключение задачи доходит до block_on
+ */
+TEST(CoroTaskTest, PropagatesExceptions) {
+    network::IoLoop loop;
+    ASSERT_TRUE(loop.start().has_value());
+    EXPECT_THROW(loop.block_on(failing()), std::runtime_error);
+}
+
+// =============================================================================
+// IoLoop / AsyncSocket
+// =============================================================================
+
+/**
+ * @brief Тест: запись и чтение прямым кодом через один поток loop
+ */
+TEST(CoroIoTest, ReadsAndWritesSocketPair) {
+    network::IoLoop loop;
+    ASSERT_TRUE(loop.start().has_value());
+    auto fds = make_pair();
+
+    auto exchange = [&]() -> core::Task<Result<std::vector<uint8_t>>> {
+        EXPECT_TRUE(loop.in_loop_thread());
+        auto socket = network::AsyncSocket::adopt(loop, fds[0]);
+        if (!socket) co_return std::unexpected(socket.error());
+
+        const std::vector<uint8_t> request{1, 2, 3, 4};
+        if (auto sent = co_await socket->write_all(request, 1000ms); !sent) {
+            co_return std::unexpected(sent.error());
+        }
+        std::vector<uint8_t> reply(4);
+        if (auto got = co_await socket->read_exact(reply, 1000ms); !got) {
+            co_return std::unexpected(got.error());
+        }
+        co_return reply;
+    };
+
+    // Эхо на блокирующей стороне: ответ приходит позже запроса
+    std::thread peer([&] {
+        std::array<uint8_t, 4> buffer{};
+        ASSERT_EQ(recv(fds[1], buffer.data(), buffer.size(), MSG_WAITALL), 4);
+        for (auto& byte : buffer) {
+            byte = static_cast<uint8_t>(byte * 10);
+        }
+        std::this_thread::sleep_for(10ms);
+        ASSERT_EQ(send(fds[1], buffer.data(), 2, 0), 2);
+        std::this_thread::sleep_for(10ms);
+        ASSERT_EQ(send(fds[1], buffer.data() + 2, 2, 0), 2);
+    });
+
+    auto reply = loop.block_on(exchange());
+    peer.join();
+    ASSERT_TRUE(reply.has_value()) << reply.error().message;
+    EXPECT_EQ(*reply, (std::vector<uint8_t>{10, 20, 30, 40}));
+    close(fds[1]);
+}
+
+/**
+ * @brief Тест: чтение без данных завершается таймаутом
+ */
+TEST(CoroIoTest, ReadTimesOut) {
+    network::IoLoop loop;
+    ASSERT_TRUE(loop.start().has_value());
+    auto fds = make_pair();
+
+    auto read = [&]() -> core::Task<Result<std::size_t>> {
+        auto socket = network::AsyncSocket::adopt(loop, fds[0]);
+        std::array<uint8_t, 8> buffer{};
+        co_return co_await socket->read_some(buffer, 20ms);
+    };
+
+    const auto started = std::chrono::steady_clock::now();
+    auto result = loop.block_on(read());
+    ASSERT_FALSE(result.has_value());
+    EXPECT_EQ(result.error().code, ErrorCode::NetworkTimeout);
+    EXPECT_GE(std::chrono::steady_clock::now() - started, 20ms);
+    close(fds[1]);
+}
+
+/**
+ * @brief Тест: connect по TCP к слушающему порту и к закрытому
+ */
+TEST(CoroIoTest, ConnectsOverTcp) {
+    network::IoLoop loop;
+    ASSERT_TRUE(loop.start().has_value());
+    uint16_t port = 0;
+    int listener = listen_loopback(port);
+
+    auto connect = [&](uint16_t target) -> core::Task<Result<void>> {
+        auto socket = co_await network::AsyncSocket::connect(loop, "127.0.0.1", target, 1000ms);
+        if (!socket) co_return std::unexpected(socket.error());
+        const std::array<uint8_t, 1> byte{0x7F};
+        co_return co_await socket->write_all(byte, 1000ms);
+    };
+
+    ASSERT_TRUE(loop.block_on(connect(port)).has_value());
+    int accepted = accept(listener, nullptr, nullptr);
+    ASSERT_GE(accepted, 0);
+    uint8_t byte = 0;
+    EXPECT_EQ(recv(accepted, &byte, 1, MSG_WAITALL), 1);
+    EXPECT_EQ(byte, 0x7F);
+    close(accepted);
+    close(listener);
+
+    // Порт больше не слушается: отказ в подключении
+    auto refused = loop.block_on(connect(port));
+    ASSERT_FALSE(refused.has_value());
+    EXPECT_EQ(refused.error().code, ErrorCode::NetworkConnectionFailed);
+}
+
+/**
+ * @brief Тест: сотни соединений ждут в одном потоке, stop() будит их ошибкой
+ */
+TEST(CoroIoTest, StopCancelsPendingOperations) {
+    network::IoLoop loop;
+    ASSERT_TRUE(loop.start().has_value());
+
+    constexpr int CONNECTIONS = 256;
+    std::vector<std::array<int, 2>> pairs;
+    std::atomic<int> cancelled{0};
+    for (int i = 0; i < CONNECTIONS; ++i) {
+        auto fds = make_pair();
+        pairs.push_back(fds);
+        ASSERT_TRUE(loop.spawn([](network::IoLoop& io, int fd, std::atomic<int>& counter) -> core::Task<void> {
+            auto socket = network::AsyncSocket::adopt(io, fd);
+            std::array<uint8_t, 16> buffer{};
+            auto result = co_await socket->read_some(buffer, 0ms);
+            if (!result && result.error().code == ErrorCode::NetworkConnectionFailed) {
+                counter.fetch_add(1);
+            }
+        }(loop, fds[0], cancelled)));
+    }
+
+    // Сон тоже прерывается остановкой
+    std::atomic<bool> slept_full{true};
+    ASSERT_TRUE(loop.spawn([](network::IoLoop& io, std::atomic<bool>& full) -> core::Task<void> {
+        full = co_await io.sleep_for(10s);
+    }(loop, slept_full)));
+
+    std::this_thread::sleep_for(50ms);
+    EXPECT_EQ(loop.active_tasks(), static_cast<std::size_t>(CONNECTIONS + 1));
+    loop.stop();
+
+    EXPECT_EQ(cancelled.load(), CONNECTIONS);
+    EXPECT_FALSE(slept_full.load());
+    EXPECT_EQ(loop.active_tasks(), 0u);
+    EXPECT_FALSE(loop.spawn(nothing()));
+    for (auto& fds : pairs) {
+        close(fds[1]);
+    }
+}
+
+} // namespace quaxis::tests
@@ -0,0 +1,225 @@
+/**
+ * @file test_executor.cpp
+ * @brief Тесты общего исполнителя (Executor)
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "core/clock.hpp"
+#include "core/executor.hpp"
+
+namespace quaxis::tests {
+
+namespace {
+
+/**
+ * @brief Ждать условие не дольше timeout
+ */
+template<typename Predicate>
+bool wait_for(Predicate predicate, std::chrono::milliseconds timeout = std::chrono::seconds(5)) {
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (!predicate()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+ExecutorConfig make_config(std::size_t workers) {
+    ExecutorConfig config;
+    config.workers = workers;
+    config.timer_tick_ms = 1;
+    return config;
+}
+
+} // anonymous namespace
+
+/**
+ * @brief Тест: все задачи пула выполняются, простаивающий поток перехватывает
+ */
+TEST(ExecutorTest, RunsAndStealsPoolTasks) {
+    core::Executor executor(make_config(2));
+    ASSERT_TRUE(executor.start().has_value());
+    EXPECT_EQ(executor.worker_count(), 2u);
+
+    constexpr int TASKS = 32;
+    std::atomic<int> done{0};
+    // Задачи, поставленные из потока пула, ложатся в его очередь
+    executor.post([&] {
+        for (int i = 0; i < TASKS; ++i) {
+            executor.post([&] {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                done.fetch_add(1);
+            });
+        }
+    });
+
+    ASSERT_TRUE(wait_for([&] { return done.load() == TASKS; }));
+    executor.stop();
+    EXPECT_EQ(executor.tasks_executed(), static_cast<uint64_t>(TASKS + 1));
+    EXPECT_GT(executor.tasks_stolen(), 0u);
+}
+
+/**
+ * @brief Тест: schedule_after срабатывает один раз не раньше задержки
+ */
+TEST(ExecutorTest, ScheduleAfterFiresOnce) {
+    core::Executor executor(make_config(1));
+    ASSERT_TRUE(executor.start().has_value());
+
+    std::atomic<int> fired{0};
+    const auto started = std::chrono::steady_clock::now();
+    std::atomic<int64_t> elapsed_ms{0};
+    executor.schedule_after(std::chrono::milliseconds(20), [&] {
+        elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - started).count();
+        fired.fetch_add(1);
+    });
+
+    ASSERT_TRUE(wait_for([&] { return fired.load() == 1; }));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(fired.load(), 1);
+    EXPECT_GE(elapsed_ms.load(), 20);
+}
+
+/**
+ * @brief Тест: периодический таймер повторяется, после cancel() - нет
+ */
+TEST(ExecutorTest, ScheduleEveryRepeatsUntilCancelled) {
+    core::Executor executor(make_config(1));
+    ASSERT_TRUE(executor.start().has_value());
+
+    std::atomic<int> fired{0};
+    auto id = executor.schedule_every(std::chrono::milliseconds(2), [&] { fired.fetch_add(1); });
+    ASSERT_NE(id, 0u);
+
+    ASSERT_TRUE(wait_for([&] { return fired.load() >= 3; }));
+    executor.cancel(id);
+    const int after_cancel = fired.load();
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    EXPECT_EQ(fired.load(), after_cancel);
+}
+
+/**
+ * @brief Тест: таймер снимает сам себя из своей задачи
+ */
+TEST(ExecutorTest, CancelFromOwnTask) {
+    core::Executor executor(make_config(1));
+    ASSERT_TRUE(executor.start().has_value());
+
+    std::atomic<int> fired{0};
+    std::atomic<core::Executor::TimerId> id{0};
+    std::mutex mutex;
+    std::unique_lock<std::mutex> setup(mutex);
+    id = executor.schedule_every(std::chrono::milliseconds(1), [&] {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (fired.fetch_add(1) == 1) {
+            executor.cancel(id.load());
+        }
+    });
+    setup.unlock();
+
+    ASSERT_TRUE(wait_for([&] { return fired.load() >= 2; }));
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    EXPECT_EQ(fired.load(), 2);
+}
+
+/**
+ * @brief Тест: полоса задержки - один поток, строгий порядок
+ */
+TEST(ExecutorTest, LatencyLaneKeepsOrder) {
+    core::Executor executor(make_config(2));
+    ASSERT_TRUE(executor.start().has_value());
+    EXPECT_FALSE(executor.in_latency_lane());
+
+    std::mutex mutex;
+    std::vector<int> order;
+    std::atomic<bool> in_lane{true};
+    for (int i = 0; i < 100; ++i) {
+        executor.post_latency([&, i] {
+            if (!executor.in_latency_lane()) {
+                in_lane = false;
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            order.push_back(i);
+        });
+    }
+    executor.stop();
+
+    EXPECT_TRUE(in_lane.load());
+    ASSERT_EQ(order.size(), 100u);
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(order[static_cast<std::size_t>(i)], i);
+    }
+}
+
+/**
+ * @brief Тест: после stop() задачи и таймеры не принимаются
+ */
+TEST(ExecutorTest, IgnoresWorkAfterStop) {
+    core::Executor executor(make_config(1));
+    ASSERT_TRUE(executor.start().has_value());
+    executor.stop();
+
+    std::atomic<int> ran{0};
+    executor.post([&] { ran.fetch_add(1); });
+    executor.post_latency([&] { ran.fetch_add(1); });
+    executor.schedule_after(std::chrono::milliseconds(1), [&] { ran.fetch_add(1); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(ran.load(), 0);
+}
+
+/**
+ * @brief Тест: поток таймеров ведёт CoarseClock, без исполнителя - steady_clock
+ */
+TEST(ExecutorTest, DrivesCoarseClock) {
+    using Clock = std::chrono::steady_clock;
+    const bool cached_before = core::CoarseClock::cached();
+    const auto before = Clock::now();
+    if (!cached_before) {
+        EXPECT_GE(core::CoarseClock::now(), before);
+    }
+    
+    {
+        core::Executor executor(make_config(1));
+        ASSERT_TRUE(executor.start().has_value());
+        ASSERT_TRUE(wait_for([] { return core::CoarseClock::cached(); }));
+        
+        // Отстаёт не больше чем на пару шагов колеса и не опережает
+        const auto start = core::CoarseClock::now();
+        ASSERT_TRUE(wait_for([&] { return core::CoarseClock::now() > start; }));
+        const auto coarse = core::CoarseClock::now();
+        const auto precise = Clock::now();
+        EXPECT_LE(coarse, precise);
+        EXPECT_LT(precise - coarse, std::chrono::milliseconds(50));
+        executor.stop();
+    }
+    EXPECT_EQ(core::CoarseClock::cached(), cached_before);
+}
+
+/**
+ * @brief Тест: TscClock переводит метки в наносекунды steady_clock
+ */
+TEST(ClockTest, TscMatchesSteadyClock) {
+    using Clock = std::chrono::steady_clock;
+    EXPECT_GT(core::TscClock::ticks_per_ns(), 0.0);
+    
+    const uint64_t start = core::TscClock::ticks();
+    const auto wall_start = Clock::now();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    const uint64_t tsc_ns = core::TscClock::elapsed_ns(start);
+    const auto wall_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - wall_start).count();
+    
+    // Погрешность калибровки за 2 мс - доли процента
+    EXPECT_NEAR(static_cast<double>(tsc_ns), static_cast<double>(wall_ns), static_cast<double>(wall_ns) * 0.05);
+}
+
+} // namespace quaxis::tests
@@ -8,6 +8,9 @@
 
 #include <gtest/gtest.h>
 #include <algorithm>
+#include <set>
+#include <thread>
+#include <vector>
 #include "mining/extranonce_manager.hpp"
 
 namespace quaxis::tests {
@@ -120,6 +123,33 @@ TEST(ExtrannonceManagerStartValueTest, CustomStartValue) {
     EXPECT_EQ(ext, 1000);
 }
 
+/**
+ * @brief Test: fresh values stop at the end of the node's range
+ */
+TEST(ExtrannonceManagerStartValueTest, EndValueRefusesPastRange) {
+    mining::ExtrannonceManager manager(1000, 1010);
+    
+    auto lease = manager.lease_extranonces(1, 8);
+    EXPECT_EQ(lease.start, 1000u);
+    
+    // 2 values left: a lease of 8 and a reservation of 4 do not fit
+    auto refused = manager.lease_extranonces(2, 8);
+    EXPECT_EQ(refused.start, 0u);
+    EXPECT_EQ(refused.count, 0u);
+    EXPECT_FALSE(manager.has_extranonce(2));
+    EXPECT_EQ(manager.reserve_extranonces(4).count, 0u);
+    
+    EXPECT_EQ(manager.assign_extranonce(3), 1008u);
+    EXPECT_EQ(manager.assign_extranonce(4), 1009u);
+    EXPECT_EQ(manager.assign_extranonce(5), 0u);
+    EXPECT_EQ(manager.peek_next_extranonce(), 1010u);
+    
+    // Recycled ranges are still handed out
+    manager.release_extranonce(1);
+    (void)manager.recycle_released();
+    EXPECT_EQ(manager.lease_extranonces(2, 8).start, 1000u);
+}
+
 /**
  * @brief Test: concurrent access simulation
  * 
@@ -147,4 +177,123 @@ TEST_F(ExtrannonceManagerTest, RapidAssignRelease) {
     EXPECT_EQ(manager_.active_count(), 50);
 }
 
+/**
+ * @brief Test: released extranonces are reused only after recycle_released()
+ */
+TEST_F(ExtrannonceManagerTest, RecycleReleased) {
+    auto ext = manager_.assign_extranonce(100);
+    manager_.release_extranonce(100);
+    EXPECT_EQ(manager_.released_count(), 1);
+    
+    // Still quarantined: a new connection gets a fresh value
+    auto fresh = manager_.assign_extranonce(100);
+    EXPECT_NE(fresh, ext);
+    manager_.release_extranonce(100);
+    
+    EXPECT_EQ(manager_.recycle_released(), 2);
+    EXPECT_EQ(manager_.released_count(), 0);
+    
+    // After the template change the value comes back instead of a fresh one
+    auto next_fresh = manager_.peek_next_extranonce();
+    auto reused = manager_.assign_extranonce(100);
+    EXPECT_TRUE(reused == ext || reused == fresh);
+    EXPECT_EQ(manager_.peek_next_extranonce(), next_fresh);
+}
+
+/**
+ * @brief Test: reassigning a connection quarantines its old value
+ */
+TEST_F(ExtrannonceManagerTest, ReassignQuarantinesOldValue) {
+    auto first = manager_.assign_extranonce(100);
+    auto second = manager_.assign_extranonce(100);
+    
+    EXPECT_NE(first, second);
+    EXPECT_EQ(manager_.active_count(), 1);
+    EXPECT_EQ(manager_.released_count(), 1);
+}
+
+/**
+ * @brief Test: a reserved range is held by nobody until bound, then behaves as a lease
+ */
+TEST_F(ExtrannonceManagerTest, ReserveThenBind) {
+    auto reserved = manager_.reserve_extranonces(1);
+    EXPECT_EQ(manager_.active_count(), 0);
+    EXPECT_NE(manager_.assign_extranonce(1), reserved.start);
+    
+    manager_.bind_lease(2, reserved);
+    EXPECT_EQ(manager_.get_extranonce(2), reserved.start);
+    EXPECT_EQ(manager_.active_count(), 2);
+    
+    // Recycled ranges of any shard are reserved before fresh values
+    manager_.release_extranonce(2);
+    manager_.recycle_released();
+    auto next_fresh = manager_.peek_next_extranonce();
+    EXPECT_EQ(manager_.reserve_extranonces(1).start, reserved.start);
+    EXPECT_EQ(manager_.peek_next_extranonce(), next_fresh);
+}
+
+/**
+ * @brief Test: leased ranges never overlap and are recycled by size
+ */
+TEST_F(ExtrannonceManagerTest, LeaseRanges) {
+    auto a = manager_.lease_extranonces(100, 1000);
+    auto b = manager_.lease_extranonces(200, 1000);
+    EXPECT_EQ(a.count, 1000u);
+    EXPECT_EQ(b.start, a.start + 1000);
+    EXPECT_FALSE(a.contains(b.start));
+    
+    ASSERT_TRUE(manager_.get_lease(100).has_value());
+    EXPECT_EQ(manager_.get_lease(100)->start, a.start);
+    EXPECT_EQ(*manager_.get_extranonce(200), b.start);
+    
+    manager_.release_extranonce(100);
+    manager_.recycle_released();
+    
+    // Диапазон другого размера не берётся из свободных
+    auto single = manager_.lease_extranonces(100, 1);
+    EXPECT_EQ(single.start, b.start + 1000);
+    manager_.release_extranonce(100);
+    
+    auto again = manager_.lease_extranonces(100, 1000);
+    EXPECT_EQ(again.start, a.start);
+}
+
+/**
+ * @brief Test: concurrent churn across shards never duplicates a live value
+ */
+TEST_F(ExtrannonceManagerTest, ConcurrentChurnKeepsValuesUnique) {
+    constexpr uint32_t THREADS = 4;
+    constexpr uint32_t CONNECTIONS_PER_THREAD = 64;
+    constexpr int ROUNDS = 200;
+    
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < THREADS; ++t) {
+        threads.emplace_back([this, t] {
+            for (int round = 0; round < ROUNDS; ++round) {
+                for (uint32_t i = 0; i < CONNECTIONS_PER_THREAD; ++i) {
+                    (void)manager_.assign_extranonce(t * CONNECTIONS_PER_THREAD + i);
+                }
+                for (uint32_t i = 0; i < CONNECTIONS_PER_THREAD; i += 2) {
+                    manager_.release_extranonce(t * CONNECTIONS_PER_THREAD + i);
+                }
+                if (t == 0 && round % 16 == 0) {
+                    manager_.recycle_released();
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    
+    auto assignments = manager_.get_active_assignments();
+    EXPECT_EQ(assignments.size(), manager_.active_count());
+    EXPECT_EQ(assignments.size(), THREADS * CONNECTIONS_PER_THREAD / 2);
+    
+    std::set<uint64_t> values;
+    for (const auto& [id, ext] : assignments) {
+        EXPECT_TRUE(values.insert(ext).second) << "duplicate extranonce " << ext;
+    }
+}
+
 } // namespace quaxis::tests
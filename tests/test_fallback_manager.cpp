@@ -5,8 +5,22 @@
 
 #include <gtest/gtest.h>
 
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
 #include "fallback/fallback_manager.hpp"
 #include "fallback/pool_config.hpp"
+#include "fallback/stratum_pool_set.hpp"
 
 namespace quaxis::tests {
 
@@ -204,6 +218,252 @@ TEST_F(FallbackManagerTest, ModeChangeCallback) {
     EXPECT_EQ(new_mode_received, fallback::FallbackMode::FallbackZMQ);
 }
 
+namespace {
+
+/// @brief Дождаться режима (не дольше timeout)
+bool wait_for_mode(const fallback::FallbackManager& manager,
+                   fallback::FallbackMode mode,
+                   std::chrono::milliseconds timeout) {
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (manager.current_mode() != mode) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+/**
+ * @brief Stratum пул на localhost: отвечает на subscribe и authorize
+ */
+class FakePool {
+public:
+    FakePool() {
+        listen_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        ::bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+        ::listen(listen_fd_, 4);
+        socklen_t len = sizeof(addr);
+        ::getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &len);
+        port_ = ntohs(addr.sin_port);
+        thread_ = std::thread([this] { run(); });
+    }
+    
+    ~FakePool() {
+        running_ = false;
+        thread_.join();
+        ::close(listen_fd_);
+    }
+    
+    [[nodiscard]] uint16_t port() const noexcept { return port_; }
+    [[nodiscard]] int connections() const noexcept { return connections_; }
+    [[nodiscard]] int submits() const noexcept { return submits_; }
+    
+    /// @brief Отправить mining.notify подключённому клиенту
+    void notify(const std::string& prevhash, const std::string& job_id) {
+        send_line(R"({"id":null,"method":"mining.notify","params":[")" + job_id + R"(",")" + prevhash +
+                  R"(","01","02",[],"20000000","1d00ffff","5f5e1000",true]})");
+    }
+    
+    /// @brief Оборвать соединение с клиентом и больше не принимать новые
+    void drop() {
+        accepting_ = false;
+        ::shutdown(listen_fd_, SHUT_RDWR);
+        std::lock_guard<std::mutex> lock(send_mutex_);
+        if (client_ >= 0) {
+            ::shutdown(client_, SHUT_RDWR);
+        }
+    }
+    
+private:
+    void send_line(std::string line) {
+        line += "\n";
+        std::lock_guard<std::mutex> lock(send_mutex_);
+        if (client_ >= 0) {
+            (void)::send(client_, line.data(), line.size(), MSG_NOSIGNAL);
+        }
+    }
+    
+    void run() {
+        int client = -1;
+        std::string buffer;
+        while (running_) {
+            if (client < 0 && !accepting_) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                continue;
+            }
+            pollfd pfd{client >= 0 ? client : listen_fd_, POLLIN, 0};
+            if (::poll(&pfd, 1, 10) <= 0) {
+                continue;
+            }
+            if (client < 0) {
+                client = ::accept(listen_fd_, nullptr, nullptr);
+                std::lock_guard<std::mutex> lock(send_mutex_);
+                client_ = client;
+                ++connections_;
+                continue;
+            }
+            
+            char data[512];
+            ssize_t n = ::recv(client, data, sizeof(data), 0);
+            if (n <= 0) {
+                std::lock_guard<std::mutex> lock(send_mutex_);
+                ::close(client);
+                client = client_ = -1;
+                continue;
+            }
+            buffer.append(data, static_cast<std::size_t>(n));
+            
+            std::size_t pos;
+            while ((pos = buffer.find('\n')) != std::string::npos) {
+                std::string line = buffer.substr(0, pos);
+                buffer.erase(0, pos + 1);
+                
+                auto id_start = line.find(':') + 1;
+                std::string id = line.substr(id_start, line.find(',') - id_start);
+                if (line.find("mining.submit") != std::string::npos) {
+                    ++submits_;
+                }
+                send_line(line.find("mining.subscribe") != std::string::npos
+                    ? R"({"id":)" + id + R"(,"result":[[["mining.notify","s1"]],"abcd0001",4],"error":null})"
+                    : R"({"id":)" + id + R"(,"result":true,"error":null})");
+            }
+        }
+        if (client >= 0) {
+            ::close(client);
+        }
+    }
+    
+    int listen_fd_ = -1;
+    int client_ = -1;
+    uint16_t port_ = 0;
+    std::atomic<bool> running_{true};
+    std::atomic<bool> accepting_{true};
+    std::atomic<int> connections_{0};
+    std::atomic<int> submits_{0};
+    std::mutex send_mutex_;
+    std::thread thread_;
+};
+
+} // anonymous namespace
+
+/**
+ * @brief Тест: hot standby держит пул подключённым, переключение без handshake
+ */
+TEST_F(FallbackManagerTest, HotStandbyKeepsPoolConnected) {
+    FakePool pool;
+    
+    config_.zmq.enabled = false;
+    config_.hot_standby = true;
+    config_.timeouts.primary_health_check = std::chrono::seconds(10);
+    config_.timeouts.reconnect_delay = std::chrono::milliseconds(20);
+    fallback::StratumPoolConfig pool_config;
+    pool_config.host = "127.0.0.1";
+    pool_config.port = pool.port();
+    config_.stratum_pools = {pool_config};
+    
+    fallback::FallbackManager manager(config_);
+    manager.set_shm_health_check([] { return true; });
+    manager.start();
+    
+    // Пул подключается заранее, режим остаётся primary
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!manager.is_stratum_connected() && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ASSERT_TRUE(manager.is_stratum_connected());
+    EXPECT_EQ(manager.current_mode(), fallback::FallbackMode::PrimarySHM);
+    
+    // Переключение - без нового подключения к пулу
+    auto started = std::chrono::steady_clock::now();
+    manager.signal_source_failure(fallback::FallbackMode::PrimarySHM);
+    ASSERT_TRUE(wait_for_mode(manager, fallback::FallbackMode::FallbackStratum, std::chrono::seconds(5)));
+    EXPECT_LT(std::chrono::steady_clock::now() - started, std::chrono::milliseconds(500));
+    
+    // Возврат к primary не рвёт соединение
+    manager.signal_job_received(fallback::FallbackMode::PrimarySHM);
+    ASSERT_TRUE(wait_for_mode(manager, fallback::FallbackMode::PrimarySHM, std::chrono::seconds(5)));
+    EXPECT_TRUE(manager.is_stratum_connected());
+    EXPECT_EQ(pool.connections(), 1);
+    EXPECT_EQ(manager.get_stats().stratum_switches, 1u);
+    
+    manager.stop();
+}
+
+/**
+ * @brief Тест: тишина primary переключает на ZMQ раньше проверки здоровья
+ */
+TEST_F(FallbackManagerTest, SilenceSwitchesBeforeHealthCheck) {
+    config_.timeouts.primary_health_check = std::chrono::seconds(10);
+    config_.timeouts.primary_timeout = std::chrono::milliseconds(200);
+    config_.timeouts.job_silence_factor = 4;
+    
+    fallback::FallbackManager manager(config_);
+    manager.set_shm_health_check([] { return true; });
+    manager.set_zmq_health_check([] { return true; });
+    manager.start();
+    
+    // Задания каждые 10 мс: срок тишины - max(200 мс, 4 × 10 мс)
+    for (int i = 0; i < 10; ++i) {
+        manager.signal_job_received(fallback::FallbackMode::PrimarySHM);
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    auto health = manager.get_shm_health();
+    EXPECT_GT(health.expected_job_interval.count(), 0);
+    EXPECT_LT(health.expected_job_interval, std::chrono::milliseconds(200));
+    
+    auto last_job = health.last_job_received;
+    ASSERT_TRUE(wait_for_mode(manager, fallback::FallbackMode::FallbackZMQ, std::chrono::seconds(5)));
+    auto elapsed = std::chrono::steady_clock::now() - last_job;
+    EXPECT_GE(elapsed, config_.timeouts.primary_timeout);
+    EXPECT_LT(elapsed, config_.timeouts.primary_health_check);
+    EXPECT_FALSE(manager.get_shm_health().available);
+    EXPECT_EQ(manager.get_stats().zmq_switches, 1u);
+    
+    manager.stop();
+}
+
+/**
+ * @brief Тест: ошибка источника и новое задание primary - без ожидания проверки
+ */
+TEST_F(FallbackManagerTest, FailureAndRecoveryAreImmediate) {
+    config_.timeouts.primary_health_check = std::chrono::seconds(10);
+    
+    fallback::FallbackManager manager(config_);
+    manager.set_shm_health_check([] { return true; });
+    manager.set_zmq_health_check([] { return true; });
+    manager.start();
+    
+    // Ждём первую проверку: ZMQ должен быть известен как доступный
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (manager.get_zmq_health().total_checks == 0 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    
+    manager.signal_source_failure(fallback::FallbackMode::PrimarySHM);
+    ASSERT_TRUE(wait_for_mode(manager, fallback::FallbackMode::FallbackZMQ, std::chrono::seconds(5)));
+    
+    // Проверка здоровья SHM не отменяет ошибку до задания от него
+    manager.check_primary_health();
+    EXPECT_EQ(manager.current_mode(), fallback::FallbackMode::FallbackZMQ);
+    
+    // Задание ZMQ не возвращает primary
+    manager.signal_job_received(fallback::FallbackMode::FallbackZMQ);
+    EXPECT_EQ(manager.current_mode(), fallback::FallbackMode::FallbackZMQ);
+    
+    manager.signal_job_received(fallback::FallbackMode::PrimarySHM);
+    ASSERT_TRUE(wait_for_mode(manager, fallback::FallbackMode::PrimarySHM, std::chrono::seconds(5)));
+    
+    auto stats = manager.get_stats();
+    EXPECT_EQ(stats.zmq_switches, 1u);
+    EXPECT_EQ(stats.primary_restorations, 1u);
+    
+    manager.stop();
+}
+
 // =============================================================================
 // Тесты преобразования режимов
 // =============================================================================
@@ -220,4 +480,187 @@ TEST(FallbackModeTest, ToModeValue) {
     EXPECT_EQ(fallback::to_mode_value(fallback::FallbackMode::FallbackStratum), 2);
 }
 
+// =============================================================================
+// Тесты StratumPoolSet
+// =============================================================================
+
+namespace {
+
+/// @brief Конфигурация пула на FakePool
+fallback::StratumPoolConfig local_pool(const FakePool& pool) {
+    fallback::StratumPoolConfig config;
+    config.host = "127.0.0.1";
+    config.port = pool.port();
+    return config;
+}
+
+/// @brief Ждать условия (до 5 секунд)
+bool wait_until(const std::function<bool()>& condition) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!condition()) {
+        if (std::chrono::steady_clock::now() > deadline) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+/**
+ * @brief Набор пулов с записью отданных майнингу заданий
+ */
+class RecordingPoolSet {
+public:
+    explicit RecordingPoolSet(const std::vector<fallback::StratumPoolConfig>& pools)
+        : set(pools, std::chrono::milliseconds(20)) {
+        set.set_job_callback([this](const fallback::PoolJob& job) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            jobs_.push_back(job);
+        });
+        set.start();
+    }
+    
+    [[nodiscard]] std::vector<fallback::PoolJob> jobs() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return jobs_;
+    }
+    
+    [[nodiscard]] bool all_connected() const {
+        for (const auto& pool : set.stats()) {
+            if (!pool.connected) return false;
+        }
+        return true;
+    }
+    
+    fallback::StratumPoolSet set;
+    
+private:
+    mutable std::mutex mutex_;
+    std::vector<fallback::PoolJob> jobs_;
+};
+
+} // anonymous namespace
+
+/**
+ * @brief Тест: новый блок майнится с первого пула, share - пулу задания
+ */
+TEST(StratumPoolSetTest, FirstJobWinsAndSharesGoToIssuingPool) {
+    FakePool a;
+    FakePool b;
+    RecordingPoolSet pools({local_pool(a), local_pool(b)});
+    ASSERT_TRUE(wait_until([&] { return pools.all_connected(); }));
+    
+    // Блок p1 первым объявляет a
+    a.notify("p1", "a1");
+    ASSERT_TRUE(wait_until([&] { return pools.jobs().size() == 1; }));
+    EXPECT_EQ(pools.jobs()[0].pool, 0u);
+    EXPECT_EQ(pools.jobs()[0].job.job_id, "a1");
+    EXPECT_EQ(pools.jobs()[0].extranonce1, "abcd0001");
+    
+    // Запоздавший p1 от b только замеряется
+    b.notify("p1", "b1");
+    ASSERT_TRUE(wait_until([&] { return pools.set.stats()[1].blocks_seen == 1; }));
+    
+    // Блок p2 первым объявляет b, обновления идут только от b
+    b.notify("p2", "b2");
+    ASSERT_TRUE(wait_until([&] { return pools.jobs().size() == 2; }));
+    a.notify("p2", "a2");
+    ASSERT_TRUE(wait_until([&] { return pools.set.stats()[0].blocks_seen == 2; }));
+    b.notify("p2", "b3");
+    ASSERT_TRUE(wait_until([&] { return pools.jobs().size() == 3; }));
+    
+    auto jobs = pools.jobs();
+    EXPECT_EQ(jobs[1].pool, 1u);
+    EXPECT_EQ(jobs[1].job.job_id, "b2");
+    EXPECT_EQ(jobs[2].job.job_id, "b3");
+    
+    auto stats = pools.set.stats();
+    EXPECT_EQ(stats[0].first_announcements, 1u);
+    EXPECT_EQ(stats[1].first_announcements, 1u);
+    
+    // Share уходит пулу, выдавшему задание
+    ASSERT_TRUE(pools.set.submit("a1", "00000000", "5f5e1000", "00000001").has_value());
+    ASSERT_TRUE(pools.set.submit("b3", "00000000", "5f5e1000", "00000002").has_value());
+    ASSERT_TRUE(wait_until([&] { return a.submits() == 1 && b.submits() == 1; }));
+    
+    // Задание, не выданное майнингу, не отправляется
+    auto unknown = pools.set.submit("a2", "00000000", "5f5e1000", "00000003");
+    ASSERT_FALSE(unknown.has_value());
+    EXPECT_EQ(unknown.error().code, ErrorCode::MiningStaleJob);
+    
+    pools.set.stop();
+}
+
+/**
+ * @brief Тест: пул задания отключился - работа на самом быстром из оставшихся
+ */
+TEST(StratumPoolSetTest, FailoverToFastestPoolOnDisconnect) {
+    FakePool a;
+    FakePool b;
+    FakePool c;
+    RecordingPoolSet pools({local_pool(a), local_pool(b), local_pool(c)});
+    std::atomic<int> all_down{0};
+    pools.set.set_disconnect_callback([&](const std::string&) { ++all_down; });
+    ASSERT_TRUE(wait_until([&] { return pools.all_connected(); }));
+    
+    // Объявляет a, затем c, затем b: b - самый медленный
+    a.notify("p1", "a1");
+    ASSERT_TRUE(wait_until([&] { return pools.jobs().size() == 1; }));
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    c.notify("p1", "c1");
+    ASSERT_TRUE(wait_until([&] { return pools.set.stats()[2].blocks_seen == 1; }));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    b.notify("p1", "b1");
+    ASSERT_TRUE(wait_until([&] { return pools.set.stats()[1].blocks_seen == 1; }));
+    
+    auto stats = pools.set.stats();
+    EXPECT_LT(stats[2].average_lag, stats[1].average_lag);
+    EXPECT_EQ(pools.set.preferred_pool(), 0u);
+    
+    // a отключился: задание c, а не b
+    a.drop();
+    ASSERT_TRUE(wait_until([&] { return pools.jobs().size() == 2; }));
+    EXPECT_EQ(pools.jobs()[1].pool, 2u);
+    EXPECT_EQ(pools.jobs()[1].job.job_id, "c1");
+    EXPECT_EQ(pools.set.preferred_pool(), 2u);
+    EXPECT_EQ(all_down, 0);
+    
+    // Последний пул отключился - сообщаем
+    b.drop();
+    c.drop();
+    ASSERT_TRUE(wait_until([&] { return all_down == 1; }));
+    EXPECT_FALSE(pools.set.is_connected());
+    
+    pools.set.stop();
+}
+
+/**
+ * @brief Тест: с parallel_pools FallbackManager работает через набор пулов
+ */
+TEST_F(FallbackManagerTest, ParallelPoolsUsePoolSet) {
+    FakePool a;
+    FakePool b;
+    
+    config_.zmq.enabled = false;
+    config_.parallel_pools = true;
+    config_.timeouts.reconnect_delay = std::chrono::milliseconds(20);
+    config_.stratum_pools = {local_pool(a), local_pool(b)};
+    
+    fallback::FallbackManager manager(config_);
+    ASSERT_NE(manager.get_stratum_pool_set(), nullptr);
+    EXPECT_EQ(manager.get_stratum_client(), nullptr);
+    EXPECT_EQ(manager.get_stratum_pool_set()->size(), 2u);
+    
+    manager.set_shm_health_check([] { return true; });
+    manager.start();
+    ASSERT_TRUE(wait_until([&] { return manager.is_stratum_connected(); }));
+    
+    a.notify("p1", "a1");
+    ASSERT_TRUE(wait_until([&] { return manager.get_stratum_job().has_value(); }));
+    EXPECT_EQ(manager.get_stratum_job()->job_id, "a1");
+    
+    manager.signal_source_failure(fallback::FallbackMode::PrimarySHM);
+    EXPECT_TRUE(wait_for_mode(manager, fallback::FallbackMode::FallbackStratum, std::chrono::seconds(5)));
+    
+    manager.stop();
+}
+
 } // namespace quaxis::tests
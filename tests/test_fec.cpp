@@ -0,0 +1,408 @@
+/**
+ * @file test_fec.cpp
+ * @brief Тесты для erasure-кода FEC (GF(2^8), код Коши)
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "relay/block_reconstructor.hpp"
+#include "relay/fec_decoder.hpp"
+#include "relay/gf256.hpp"
+
+namespace quaxis::tests {
+
+namespace {
+
+/**
+ * @brief Случайные data чанки (последний короче)
+ */
+std::vector<std::vector<uint8_t>> make_chunks(std::size_t count, std::size_t size,
+                                               std::size_t last_size, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::vector<std::vector<uint8_t>> chunks(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        chunks[i].resize(i + 1 == count ? last_size : size);
+        for (auto& byte : chunks[i]) {
+            byte = static_cast<uint8_t>(rng());
+        }
+    }
+    return chunks;
+}
+
+std::vector<ByteSpan> as_spans(const std::vector<std::vector<uint8_t>>& chunks) {
+    return {chunks.begin(), chunks.end()};
+}
+
+std::vector<uint8_t> concat(const std::vector<std::vector<uint8_t>>& chunks) {
+    std::vector<uint8_t> out;
+    for (const auto& chunk : chunks) {
+        out.insert(out.end(), chunk.begin(), chunk.end());
+    }
+    return out;
+}
+
+} // anonymous namespace
+
+// =============================================================================
+// GF(2^8)
+// =============================================================================
+
+TEST(Gf256Test, FieldAxioms) {
+    for (unsigned a = 1; a < 256; ++a) {
+        auto x = static_cast<uint8_t>(a);
+        EXPECT_EQ(relay::gf_mul(x, relay::gf_inv(x)), 1);
+        EXPECT_EQ(relay::gf_mul(x, 1), x);
+        EXPECT_EQ(relay::gf_mul(x, 0), 0);
+        for (unsigned b = 1; b < 256; b += 7) {
+            auto y = static_cast<uint8_t>(b);
+            EXPECT_EQ(relay::gf_div(relay::gf_mul(x, y), y), x);
+        }
+    }
+    // 2 * 0x80 = x^8 = x^4 + x^3 + x^2 + 1 (многочлен 0x11D)
+    EXPECT_EQ(relay::gf_mul(2, 0x80), 0x1D);
+}
+
+TEST(Gf256Test, KernelsMatchScalar) {
+    std::mt19937 rng(7);
+    std::vector<uint8_t> src(1403);
+    std::vector<uint8_t> base(src.size());
+    for (std::size_t i = 0; i < src.size(); ++i) {
+        src[i] = static_cast<uint8_t>(rng());
+        base[i] = static_cast<uint8_t>(rng());
+    }
+
+    for (auto impl : {relay::Gf256Implementation::Ssse3, relay::Gf256Implementation::Avx2,
+                      relay::Gf256Implementation::Gfni}) {
+        if (!relay::has_gf256_implementation(impl)) {
+            continue;
+        }
+        for (uint8_t coef : {uint8_t{2}, uint8_t{0x53}, uint8_t{0xFF}}) {
+            auto expected = base;
+            auto actual = base;
+            relay::gf_mul_add(expected, src, coef, relay::Gf256Implementation::Scalar);
+            relay::gf_mul_add(actual, src, coef, impl);
+            EXPECT_EQ(actual, expected) << relay::gf256_implementation_name(impl)
+                                        << " coef=" << int(coef);
+        }
+    }
+}
+
+TEST(Gf256Test, ScalarMulAddMatchesGfMul) {
+    std::vector<uint8_t> src(256);
+    std::iota(src.begin(), src.end(), uint8_t{0});
+    std::vector<uint8_t> dst(256, 0);
+    relay::gf_mul_add(dst, src, 0x8E, relay::Gf256Implementation::Scalar);
+    for (unsigned i = 0; i < 256; ++i) {
+        EXPECT_EQ(dst[i], relay::gf_mul(0x8E, static_cast<uint8_t>(i)));
+    }
+}
+
+TEST(Gf256Test, XorMatchesScalar) {
+    std::mt19937 rng(11);
+    for (std::size_t size : {std::size_t{1}, std::size_t{31}, std::size_t{64}, std::size_t{1400}}) {
+        std::vector<uint8_t> src(size);
+        std::vector<uint8_t> dst(size);
+        for (std::size_t i = 0; i < size; ++i) {
+            src[i] = static_cast<uint8_t>(rng());
+            dst[i] = static_cast<uint8_t>(rng());
+        }
+        auto expected = dst;
+        for (std::size_t i = 0; i < size; ++i) {
+            expected[i] ^= src[i];
+        }
+        relay::gf_xor(dst, src);
+        EXPECT_EQ(dst, expected) << "size=" << size;
+    }
+}
+
+// =============================================================================
+// Код Коши
+// =============================================================================
+
+TEST(FecTest, FirstCauchyRowIsXorParity) {
+    for (uint16_t j = 0; j < 100; ++j) {
+        EXPECT_EQ(relay::cauchy_coefficient(100, 0, j), 1);
+    }
+}
+
+TEST(FecTest, RecoversFromAnyDataChunkCountChunks) {
+    relay::FecParams params;
+    params.data_chunk_count = 100;
+    params.fec_chunk_count = 50;
+
+    auto data = make_chunks(100, 1400, 1400, 1);
+    auto parity = relay::encode_fec_chunks(params, as_spans(data));
+    ASSERT_TRUE(parity);
+    ASSERT_EQ(parity->size(), 50u);
+
+    // Теряем 50 случайных data чанков, FEC чанки приходят все
+    std::vector<uint16_t> order(100);
+    std::iota(order.begin(), order.end(), uint16_t{0});
+    std::shuffle(order.begin(), order.end(), std::mt19937(2));
+    std::vector<bool> lost(100, false);
+    for (std::size_t i = 0; i < 50; ++i) {
+        lost[order[i]] = true;
+    }
+
+    relay::FecDecoder decoder(params);
+    for (uint16_t i = 0; i < 100; ++i) {
+        if (!lost[i]) {
+            ASSERT_TRUE(decoder.add_chunk(i, false, data[i]));
+        }
+    }
+    for (uint16_t f = 0; f < 50; ++f) {
+        ASSERT_TRUE(decoder.add_chunk(f, true, (*parity)[f]));
+    }
+
+    ASSERT_TRUE(decoder.can_decode());
+    auto result = decoder.decode();
+    ASSERT_TRUE(result) << result.error().message();
+    EXPECT_EQ(result->data, concat(data));
+    EXPECT_EQ(result->chunks_recovered, 50u);
+    EXPECT_EQ(result->data_chunks_used, 50u);
+}
+
+TEST(FecTest, RecoversWithSparseFecSubset) {
+    relay::FecParams params;
+    params.data_chunk_count = 20;
+    params.fec_chunk_count = 20;
+
+    auto data = make_chunks(20, 600, 250, 3);
+    auto parity = relay::encode_fec_chunks(params, as_spans(data));
+    ASSERT_TRUE(parity);
+
+    // Все data чанки, кроме 0, 7 и 13; FEC - только 5, 11 и 19
+    relay::FecDecoder decoder(params);
+    for (uint16_t i = 0; i < 20; ++i) {
+        if (i != 0 && i != 7 && i != 13) {
+            decoder.add_chunk(i, false, data[i]);
+        }
+    }
+    for (uint16_t f : {uint16_t{5}, uint16_t{11}, uint16_t{19}}) {
+        decoder.add_chunk(f, true, (*parity)[f]);
+    }
+
+    auto result = decoder.decode();
+    ASSERT_TRUE(result) << result.error().message();
+    EXPECT_EQ(result->data, concat(data));
+}
+
+TEST(FecTest, RecoveredShortChunkIsZeroPadded) {
+    relay::FecParams params;
+    params.data_chunk_count = 4;
+    params.fec_chunk_count = 2;
+
+    auto data = make_chunks(4, 100, 40, 4);
+    auto parity = relay::encode_fec_chunks(params, as_spans(data));
+    ASSERT_TRUE(parity);
+
+    relay::FecDecoder decoder(params);
+    for (uint16_t i = 0; i < 3; ++i) {
+        decoder.add_chunk(i, false, data[i]);
+    }
+    decoder.add_chunk(1, true, (*parity)[1]);
+
+    auto result = decoder.decode();
+    ASSERT_TRUE(result);
+    auto expected = concat(data);
+    expected.resize(400, 0);
+    EXPECT_EQ(result->data, expected);
+}
+
+TEST(FecTest, FailsWithTooFewChunks) {
+    relay::FecParams params;
+    params.data_chunk_count = 10;
+    params.fec_chunk_count = 5;
+
+    auto data = make_chunks(10, 64, 64, 5);
+    relay::FecDecoder decoder(params);
+    for (uint16_t i = 0; i < 8; ++i) {
+        decoder.add_chunk(i, false, data[i]);
+    }
+    EXPECT_FALSE(decoder.can_decode());
+    EXPECT_FALSE(decoder.decode());
+}
+
+TEST(FecTest, RejectsTooManyChunksForCauchy) {
+    relay::FecParams params;
+    params.data_chunk_count = 200;
+    params.fec_chunk_count = 100;
+
+    auto data = make_chunks(200, 8, 8, 6);
+    EXPECT_FALSE(relay::encode_fec_chunks(params, as_spans(data)));
+}
+
+TEST(FecTest, XorSchemeRecoversSingleChunk) {
+    relay::FecParams params;
+    params.data_chunk_count = 8;
+    params.fec_chunk_count = 1;
+    params.scheme = relay::FecScheme::Xor;
+
+    auto data = make_chunks(8, 128, 128, 8);
+    auto parity = relay::encode_fec_chunks(params, as_spans(data));
+    ASSERT_TRUE(parity);
+
+    relay::FecDecoder decoder(params);
+    for (uint16_t i = 0; i < 8; ++i) {
+        if (i != 3) {
+            decoder.add_chunk(i, false, data[i]);
+        }
+    }
+    decoder.add_chunk(0, true, (*parity)[0]);
+
+    auto result = decoder.decode();
+    ASSERT_TRUE(result);
+    EXPECT_EQ(result->data, concat(data));
+}
+
+TEST(FecTest, DecoderReusesArenaAcrossBlocks) {
+    relay::FecParams small;
+    small.data_chunk_count = 4;
+    small.fec_chunk_count = 2;
+    relay::FecParams large;
+    large.data_chunk_count = 30;
+    large.fec_chunk_count = 10;
+
+    relay::FecDecoder decoder(small);
+    for (const auto& params : {small, large, small}) {
+        decoder.reset(params);
+        auto data = make_chunks(params.data_chunk_count, 300, 120, params.data_chunk_count);
+        auto parity = relay::encode_fec_chunks(params, as_spans(data));
+        ASSERT_TRUE(parity);
+
+        for (uint16_t i = 1; i < params.data_chunk_count; ++i) {
+            ASSERT_TRUE(decoder.add_chunk(i, false, data[i]));
+        }
+        ASSERT_TRUE(decoder.add_chunk(0, true, (*parity)[0]));
+        EXPECT_FALSE(decoder.add_chunk(params.fec_chunk_count, true, (*parity)[0]));
+
+        auto result = decoder.decode();
+        ASSERT_TRUE(result) << result.error().message();
+        EXPECT_EQ(result->data, concat(data));
+    }
+}
+
+TEST(FecTest, DecodesInPlaceIntoAlignedBlockBuffer) {
+    relay::FecParams params;
+    params.data_chunk_count = 5;
+    params.fec_chunk_count = 2;
+    
+    auto data = make_chunks(5, 300, 120, 10);
+    auto parity = relay::encode_fec_chunks(params, as_spans(data));
+    ASSERT_TRUE(parity);
+    
+    relay::FecDecoder decoder(params);
+    // Последний чанк раньше полноразмерных: ждёт размер чанка отправителя
+    ASSERT_TRUE(decoder.add_chunk(4, false, data[4]));
+    ASSERT_TRUE(decoder.add_chunk(1, true, (*parity)[1]));
+    // Чанк другой длины - не из этого блока
+    EXPECT_FALSE(decoder.add_chunk(2, false, ByteSpan(data[2]).first(200)));
+    EXPECT_FALSE(decoder.add_chunk(0, true, ByteSpan((*parity)[0]).first(120)));
+    for (uint16_t i = 1; i < 4; ++i) {
+        ASSERT_TRUE(decoder.add_chunk(i, false, data[i]));
+    }
+    
+    relay::FecDecodeResult result;
+    auto block = decoder.decode_in_place(result);
+    ASSERT_TRUE(block) << block.error().message();
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(block->data()) % relay::BLOCK_BUFFER_ALIGNMENT, 0u);
+    EXPECT_TRUE(result.data.empty());
+    EXPECT_EQ(result.chunks_recovered, 1u);
+    const auto expected = concat(data);
+    ASSERT_EQ(block->size(), expected.size());
+    EXPECT_TRUE(std::equal(block->begin(), block->end(), expected.begin()));
+    
+    // Следующий блок - в тот же буфер
+    decoder.reset(params);
+    for (uint16_t i = 0; i < 5; ++i) {
+        ASSERT_TRUE(decoder.add_chunk(i, false, data[i]));
+    }
+    auto again = decoder.decode_in_place(result);
+    ASSERT_TRUE(again);
+    EXPECT_EQ(again->data(), block->data());
+    EXPECT_EQ(result.chunks_recovered, 0u);
+}
+
+TEST(FecTest, ReconstructorMapsFibreFecChunkIds) {
+    relay::FecParams params;
+    params.data_chunk_count = 3;
+    params.fec_chunk_count = 2;
+
+    auto data = make_chunks(3, 200, 200, 9);
+    auto parity = relay::encode_fec_chunks(params, as_spans(data));
+    ASSERT_TRUE(parity);
+
+    Hash256 hash{};
+    hash[0] = 0x11;
+    relay::BlockReconstructor reconstructor(hash, 100, params, 5000);
+
+    std::vector<uint8_t> block;
+    reconstructor.set_block_callback([&](ByteSpan bytes, uint32_t, const Hash256&) {
+        block.assign(bytes.begin(), bytes.end());
+    });
+
+    // Data чанк 1 потерян; FEC чанки в заголовке FIBRE - chunk_id N..N+M-1
+    auto make_packet = [&](uint16_t chunk_id, bool fec, const std::vector<uint8_t>& payload) {
+        relay::FibrePacket packet;
+        packet.header.flags = static_cast<uint8_t>(fec ? relay::FibreFlags::FecChunk : relay::FibreFlags::None);
+        packet.header.chunk_id = chunk_id;
+        packet.header.block_hash = hash;
+        packet.header.data_chunks = 3;
+        packet.header.total_chunks = 5;
+        packet.payload = payload;
+        return packet;
+    };
+    reconstructor.on_packet(make_packet(0, false, data[0]));
+    reconstructor.on_packet(make_packet(2, false, data[2]));
+    reconstructor.on_packet(make_packet(4, true, (*parity)[1]));
+
+    EXPECT_EQ(block, concat(data));
+}
+
+TEST(FecTest, ReconstructorDropsDuplicateAndMismatchedChunks) {
+    relay::FecParams params;
+    params.data_chunk_count = 2;
+    params.fec_chunk_count = 1;
+
+    Hash256 hash{};
+    hash[0] = 0x22;
+    relay::BlockReconstructor reconstructor(hash, 100, params, 5000);
+
+    auto make_view = [&](uint16_t chunk_id, uint16_t data_chunks, uint16_t total_chunks,
+                         const std::vector<uint8_t>& payload) {
+        relay::FibrePacketView packet;
+        packet.header.chunk_id = chunk_id;
+        packet.header.block_hash = hash;
+        packet.header.data_chunks = data_chunks;
+        packet.header.total_chunks = total_chunks;
+        packet.payload = payload;
+        return packet;
+    };
+    const std::vector<uint8_t> first(100, 0x01);
+    const std::vector<uint8_t> copy(100, 0x02);
+
+    EXPECT_EQ(reconstructor.accept(make_view(0, 2, 3, first)), relay::ChunkOutcome::Accepted);
+    // Копия того же чанка от другого пира не перезаписывает первый
+    EXPECT_EQ(reconstructor.accept(make_view(0, 2, 3, copy)), relay::ChunkOutcome::Duplicate);
+    // Пир, нарезавший блок иначе, не смешивается с остальными
+    EXPECT_EQ(reconstructor.accept(make_view(1, 3, 4, copy)), relay::ChunkOutcome::Rejected);
+    EXPECT_EQ(reconstructor.accept(make_view(5, 2, 3, copy)), relay::ChunkOutcome::Rejected);
+    EXPECT_EQ(reconstructor.stats().duplicates, 1u);
+
+    std::vector<uint8_t> block;
+    reconstructor.set_block_callback([&](ByteSpan bytes, uint32_t, const Hash256&) {
+        block.assign(bytes.begin(), bytes.end());
+    });
+    EXPECT_EQ(reconstructor.accept(make_view(1, 2, 3, copy)), relay::ChunkOutcome::Accepted);
+    ASSERT_EQ(block.size(), 200u);
+    EXPECT_EQ(block[0], 0x01);
+    EXPECT_EQ(reconstructor.accept(make_view(1, 2, 3, copy)), relay::ChunkOutcome::Rejected);
+}
+
+} // namespace quaxis::tests
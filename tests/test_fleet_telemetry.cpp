@@ -0,0 +1,189 @@
+/**
+ * @file test_fleet_telemetry.cpp
+ * @brief Тесты для таблицы телеметрии чипов фермы
+ */
+
+#include <gtest/gtest.h>
+
+#include "network/fleet_telemetry.hpp"
+
+namespace quaxis::tests {
+
+using network::FleetTelemetry;
+
+namespace {
+
+/// @brief Кодер payload RSP_TELEMETRY, как в прошивке
+class PayloadBuilder {
+public:
+    explicit PayloadBuilder(bool keyframe) { data_.push_back(keyframe ? 0x01 : 0x00); }
+
+    PayloadBuilder& chip(uint32_t chip_id, uint8_t mask) {
+        varint(chip_id - next_chip_);
+        data_.push_back(mask);
+        next_chip_ = chip_id + 1;
+        return *this;
+    }
+
+    PayloadBuilder& delta(int32_t value) {
+        return varint((static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31));
+    }
+
+    PayloadBuilder& byte(uint8_t value) {
+        data_.push_back(value);
+        return *this;
+    }
+
+    PayloadBuilder& varint(uint32_t value) {
+        while (value >= 0x80) {
+            data_.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        data_.push_back(static_cast<uint8_t>(value));
+        return *this;
+    }
+
+    [[nodiscard]] const Bytes& bytes() const { return data_; }
+
+private:
+    Bytes data_;
+    uint32_t next_chip_ = 0;
+};
+
+constexpr uint8_t TEMP = 0x01;
+constexpr uint8_t FREQ = 0x02;
+constexpr uint8_t STATUS = 0x04;
+constexpr uint8_t HW = 0x08;
+constexpr uint8_t GOOD = 0x10;
+
+/// @brief Keyframe: три чипа, 70/71/72 °C, 600 МГц, у чипа 2 ошибка
+Bytes make_keyframe() {
+    PayloadBuilder b(true);
+    b.chip(0, TEMP | FREQ | GOOD).delta(70).delta(600).varint(1000)
+     .chip(1, TEMP | FREQ | GOOD).delta(71).delta(600).varint(1000)
+     .chip(2, TEMP | FREQ | STATUS | GOOD).delta(72).delta(600).byte(1).varint(1000);
+    return b.bytes();
+}
+
+} // anonymous namespace
+
+TEST(FleetTelemetryTest, KeyframeThenDelta) {
+    FleetTelemetry fleet(4);
+
+    // Чип 2 пропущен (gap), чип 3 - без полей
+    PayloadBuilder key(true);
+    key.chip(0, TEMP | FREQ).delta(70).delta(600)
+       .chip(1, TEMP | FREQ | GOOD).delta(71).delta(600).varint(1000)
+       .chip(3, 0);
+    auto applied = fleet.apply(7, key.bytes());
+    ASSERT_TRUE(applied.has_value());
+    EXPECT_EQ(*applied, 3u);
+
+    auto chip1 = fleet.chip(7, 1);
+    ASSERT_TRUE(chip1.has_value());
+    EXPECT_EQ(chip1->temperature, 71);
+    EXPECT_EQ(chip1->frequency_mhz, 600);
+    EXPECT_EQ(chip1->good_nonces, 1000u);
+    EXPECT_FALSE(fleet.chip(7, 2).has_value());  // Чип не присылал данных
+    EXPECT_TRUE(fleet.chip(7, 3).has_value());   // Пустая запись keyframe
+
+    // Дельта: только изменившиеся поля
+    PayloadBuilder delta(false);
+    delta.chip(1, TEMP | HW | GOOD).delta(-3).varint(2).varint(50)
+         .chip(3, FREQ | STATUS).delta(575).byte(1);
+    applied = fleet.apply(7, delta.bytes());
+    ASSERT_TRUE(applied.has_value());
+    EXPECT_EQ(*applied, 2u);
+
+    chip1 = fleet.chip(7, 1);
+    EXPECT_EQ(chip1->temperature, 68);
+    EXPECT_EQ(chip1->hw_errors, 2u);
+    EXPECT_EQ(chip1->good_nonces, 1050u);
+    EXPECT_EQ(fleet.chip(7, 3)->frequency_mhz, 575);
+
+    const auto summary = fleet.summary();
+    EXPECT_EQ(summary.asics, 1u);
+    EXPECT_EQ(summary.chips, 3u);
+    EXPECT_EQ(summary.error_chips, 1u);
+    EXPECT_EQ(summary.temperature_max, 70);
+    EXPECT_DOUBLE_EQ(summary.temperature_avg, (70.0 + 68.0 + 0.0) / 3.0);
+    EXPECT_DOUBLE_EQ(summary.frequency_avg_mhz, (600.0 + 600.0 + 575.0) / 3.0);
+    EXPECT_EQ(summary.hw_errors, 2u);
+    EXPECT_EQ(summary.good_nonces, 1050u);
+
+    // Новый keyframe сбрасывает снимок ASIC
+    ASSERT_TRUE(fleet.apply(7, make_keyframe()).has_value());
+    EXPECT_EQ(fleet.chip(7, 1)->hw_errors, 0u);
+    EXPECT_EQ(fleet.chip(7, 2)->status, 1);
+    EXPECT_FALSE(fleet.chip(7, 3).has_value());
+}
+
+TEST(FleetTelemetryTest, CorruptFrameStaleUntilKeyframe) {
+    FleetTelemetry fleet(4);
+
+    // Дельта до первого keyframe не применяется
+    PayloadBuilder early(false);
+    early.chip(0, TEMP).delta(5);
+    auto applied = fleet.apply(1, early.bytes());
+    ASSERT_TRUE(applied.has_value());
+    EXPECT_EQ(*applied, 0u);
+    EXPECT_EQ(fleet.summary().stale_asics, 1u);
+
+    ASSERT_TRUE(fleet.apply(1, make_keyframe()).has_value());
+    ASSERT_TRUE(fleet.apply(2, make_keyframe()).has_value());
+    EXPECT_EQ(fleet.summary().asics, 2u);
+
+    // Чип за пределами таблицы и обрезанная запись - ошибки кадра
+    PayloadBuilder out_of_range(false);
+    out_of_range.chip(4, TEMP).delta(1);
+    EXPECT_FALSE(fleet.apply(1, out_of_range.bytes()).has_value());
+    PayloadBuilder truncated(false);
+    truncated.chip(0, TEMP | FREQ).delta(1);
+    EXPECT_FALSE(fleet.apply(2, truncated.bytes()).has_value());
+    EXPECT_FALSE(fleet.apply(2, Bytes{}).has_value());
+
+    auto summary = fleet.summary();
+    EXPECT_EQ(summary.asics, 0u);
+    EXPECT_EQ(summary.stale_asics, 2u);
+    EXPECT_FALSE(fleet.chip(1, 0).has_value());
+
+    // Дельты устаревшего ASIC игнорируются до keyframe
+    PayloadBuilder delta(false);
+    delta.chip(0, TEMP).delta(1);
+    EXPECT_EQ(*fleet.apply(1, delta.bytes()), 0u);
+    ASSERT_TRUE(fleet.apply(1, make_keyframe()).has_value());
+    ASSERT_TRUE(fleet.apply(1, delta.bytes()).has_value());
+    EXPECT_EQ(fleet.chip(1, 0)->temperature, 71);
+
+    summary = fleet.summary();
+    EXPECT_EQ(summary.asics, 1u);
+    EXPECT_EQ(summary.stale_asics, 1u);
+}
+
+TEST(FleetTelemetryTest, RemoveReusesRows) {
+    FleetTelemetry fleet(4);
+    ASSERT_TRUE(fleet.apply(10, make_keyframe()).has_value());
+    ASSERT_TRUE(fleet.apply(11, make_keyframe()).has_value());
+    EXPECT_EQ(fleet.summary().chips, 6u);
+
+    fleet.remove(10);
+    fleet.remove(99);  // Неизвестный ASIC
+    EXPECT_FALSE(fleet.chip(10, 0).has_value());
+    EXPECT_EQ(fleet.summary().asics, 1u);
+    EXPECT_EQ(fleet.summary().chips, 3u);
+
+    // Новый ASIC занимает освободившиеся строки уже сброшенными
+    PayloadBuilder key(true);
+    key.chip(1, GOOD).varint(5);
+    ASSERT_TRUE(fleet.apply(12, key.bytes()).has_value());
+    EXPECT_FALSE(fleet.chip(12, 0).has_value());
+    EXPECT_EQ(fleet.chip(12, 1)->temperature, 0);
+    EXPECT_EQ(fleet.chip(12, 1)->good_nonces, 5u);
+
+    const auto summary = fleet.summary();
+    EXPECT_EQ(summary.asics, 2u);
+    EXPECT_EQ(summary.chips, 4u);
+    EXPECT_EQ(summary.good_nonces, 3005u);
+}
+
+} // namespace quaxis::tests
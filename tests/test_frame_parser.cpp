@@ -0,0 +1,586 @@
+/**
+ * @file test_frame_parser.cpp
+ * @brief Tests for fixed-size frame encoding and the ring-buffer FrameParser
+ */
+
+#include <gtest/gtest.h>
+#include <cerrno>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "network/protocol.hpp"
+#include "core/byte_order.hpp"
+
+namespace quaxis::tests {
+
+namespace {
+
+/// @brief Поток из count share-кадров
+Bytes make_share_stream(uint32_t count) {
+    Bytes stream;
+    for (uint32_t i = 0; i < count; ++i) {
+        std::array<uint8_t, network::SHARE_FRAME_SIZE> frame;
+        network::ShareMessage{mining::Share{i, i * 7}}.encode(frame);
+        stream.insert(stream.end(), frame.begin(), frame.end());
+    }
+    return stream;
+}
+
+} // anonymous namespace
+
+/**
+ * @brief Test: encode() produces the same bytes as serialize()
+ */
+TEST(FrameEncodingTest, EncodeMatchesSerialize) {
+    mining::Job job;
+    job.job_id = 0xA1B2C3D4;
+    job.timestamp = 1700000000;
+    job.bits = 0x1705ae3a;
+    
+    network::NewJobFrame frame;
+    network::NewJobMessage{job}.encode(frame);
+    Bytes expected = network::serialize_new_job(job);
+    EXPECT_EQ(Bytes(frame.begin(), frame.end()), expected);
+    
+    network::NewJobFrame from_message;
+    network::encode_new_job(job.serialize(), from_message);
+    EXPECT_EQ(from_message, frame);
+    
+    mining::Share share{42, 0xDEADBEEF};
+    std::array<uint8_t, network::SHARE_FRAME_SIZE> share_frame;
+    network::ShareMessage{share}.encode(share_frame);
+    EXPECT_EQ(Bytes(share_frame.begin(), share_frame.end()), network::ShareMessage{share}.serialize());
+}
+
+/**
+ * @brief Test: frames split at every byte boundary and wrapping the ring
+ */
+TEST(FrameParserTest, DecodesAcrossChunksAndWrap) {
+    constexpr uint32_t COUNT = 1000;  // 9000 байт: кольцо оборачивается дважды
+    Bytes stream = make_share_stream(COUNT);
+    
+    network::FrameParser parser;
+    std::vector<mining::Share> shares;
+    
+    // Куски переменной длины, чтобы кадры разрезались в разных местах
+    std::size_t offset = 0;
+    std::size_t chunk = 1;
+    while (offset < stream.size()) {
+        std::size_t n = std::min(chunk, stream.size() - offset);
+        parser.feed(ByteSpan(stream.data() + offset, n), [&](const network::ParsedMessage& msg) {
+            ASSERT_TRUE(std::holds_alternative<network::ShareMessage>(msg));
+            shares.push_back(std::get<network::ShareMessage>(msg).share);
+        });
+        offset += n;
+        chunk = chunk % 13 + 1;
+    }
+    
+    ASSERT_EQ(shares.size(), COUNT);
+    for (uint32_t i = 0; i < COUNT; ++i) {
+        EXPECT_EQ(shares[i].job_id, i);
+        EXPECT_EQ(shares[i].nonce, i * 7);
+    }
+    EXPECT_EQ(parser.buffered_size(), 0u);
+}
+
+/**
+ * @brief Test: feed() accepts input larger than the ring
+ */
+TEST(FrameParserTest, FeedLargerThanCapacity) {
+    constexpr uint32_t COUNT = 2000;
+    Bytes stream = make_share_stream(COUNT);
+    ASSERT_GT(stream.size(), network::FrameParser::CAPACITY);
+    
+    network::FrameParser parser;
+    uint32_t parsed = 0;
+    parser.feed(stream, [&](const network::ParsedMessage&) { ++parsed; });
+    EXPECT_EQ(parsed, COUNT);
+    
+    // add_data() принимает не больше свободного места
+    EXPECT_EQ(parser.add_data(stream), network::FrameParser::CAPACITY);
+    EXPECT_EQ(parser.add_data(stream), 0u);
+}
+
+/**
+ * @brief Test: status, heartbeat and unknown bytes in one stream
+ */
+TEST(FrameParserTest, MixedFrames) {
+    network::StatusMessage status{123456, 70, 55, 3};
+    Bytes stream = status.serialize();
+    stream.push_back(static_cast<uint8_t>(network::Response::Heartbeat));
+    stream.push_back(0x00);  // Неизвестный байт пропускается
+    Bytes share = network::ShareMessage{mining::Share{5, 6}}.serialize();
+    stream.insert(stream.end(), share.begin(), share.end());
+    
+    network::FrameParser parser;
+    ASSERT_EQ(parser.add_data(stream), stream.size());
+    
+    auto first = parser.try_parse();
+    ASSERT_TRUE(first.has_value());
+    const auto& parsed = std::get<network::StatusMessage>(*first);
+    EXPECT_EQ(parsed.hashrate, 123456u);
+    EXPECT_EQ(parsed.temperature, 70);
+    EXPECT_EQ(parsed.fan_speed, 55);
+    EXPECT_EQ(parsed.errors, 3);
+    
+    auto heartbeat = parser.try_parse();
+    ASSERT_TRUE(heartbeat.has_value());
+    EXPECT_EQ(std::get<network::StatusMessage>(*heartbeat).hashrate, 0u);
+    
+    auto last = parser.try_parse();
+    ASSERT_TRUE(last.has_value());
+    EXPECT_EQ(std::get<network::ShareMessage>(*last).share.job_id, 5u);
+    EXPECT_FALSE(parser.try_parse().has_value());
+}
+
+/**
+ * @brief Test: RSP_SHARE_SLOT keeps the version slot in both parsers
+ */
+TEST(FrameParserTest, ShareSlotCarriesVersionSlot) {
+    Bytes frame = network::ShareMessage{mining::Share{9, 10, 3}}.serialize();
+    ASSERT_EQ(frame.size(), network::SHARE_SLOT_FRAME_SIZE);
+    EXPECT_EQ(frame[0], static_cast<uint8_t>(network::Response::ShareSlot));
+    
+    network::FrameParser ring;
+    network::ProtocolParser legacy;
+    ASSERT_EQ(ring.add_data(frame), frame.size());
+    legacy.add_data(frame);
+    
+    for (auto msg : {ring.try_parse(), legacy.try_parse()}) {
+        ASSERT_TRUE(msg.has_value());
+        const auto& share = std::get<network::ShareMessage>(*msg).share;
+        EXPECT_EQ(share.job_id, 9u);
+        EXPECT_EQ(share.nonce, 10u);
+        EXPECT_EQ(share.version_slot, 3);
+    }
+    EXPECT_EQ(ring.buffered_size(), 0u);
+    EXPECT_EQ(legacy.buffered_size(), 0u);
+}
+
+/**
+ * @brief Test: RSP_HELLO carries the session token and job in both parsers
+ */
+TEST(FrameParserTest, HelloCarriesTokenAndJob) {
+    Bytes frame = network::HelloMessage{0x1122334455667788ULL, 77}.serialize();
+    ASSERT_EQ(frame.size(), network::HELLO_FRAME_SIZE);
+    EXPECT_EQ(frame[0], static_cast<uint8_t>(network::Response::Hello));
+    
+    network::FrameParser ring;
+    network::ProtocolParser legacy;
+    ASSERT_EQ(ring.add_data(ByteSpan(frame).first(5)), 5u);
+    legacy.add_data(ByteSpan(frame).first(5));
+    EXPECT_FALSE(ring.try_parse().has_value());
+    EXPECT_FALSE(legacy.try_parse().has_value());
+    ASSERT_EQ(ring.add_data(ByteSpan(frame).subspan(5)), frame.size() - 5);
+    legacy.add_data(ByteSpan(frame).subspan(5));
+    
+    for (auto msg : {ring.try_parse(), legacy.try_parse()}) {
+        ASSERT_TRUE(msg.has_value());
+        const auto& hello = std::get<network::HelloMessage>(*msg);
+        EXPECT_EQ(hello.token, 0x1122334455667788ULL);
+        EXPECT_EQ(hello.job_id, 77u);
+    }
+    EXPECT_EQ(ring.buffered_size(), 0u);
+    EXPECT_EQ(legacy.buffered_size(), 0u);
+}
+
+/**
+ * @brief Test: RSP_JOB_LOADED carries the job and controller timestamps in both parsers
+ */
+TEST(FrameParserTest, JobLoadedCarriesControllerTimestamps) {
+    Bytes frame = network::JobLoadedMessage{0x0A0B0C0D, 0xFFFFFFF0, 0x10}.serialize();
+    ASSERT_EQ(frame.size(), network::JOB_LOADED_FRAME_SIZE);
+    EXPECT_EQ(frame[0], static_cast<uint8_t>(network::Response::JobLoaded));
+    
+    network::FrameParser ring;
+    network::ProtocolParser legacy;
+    ASSERT_EQ(ring.add_data(frame), frame.size());
+    legacy.add_data(frame);
+    
+    for (auto msg : {ring.try_parse(), legacy.try_parse()}) {
+        ASSERT_TRUE(msg.has_value());
+        const auto& loaded = std::get<network::JobLoadedMessage>(*msg);
+        EXPECT_EQ(loaded.job_id, 0x0A0B0C0Du);
+        EXPECT_EQ(loaded.received_us, 0xFFFFFFF0u);
+        EXPECT_EQ(loaded.started_us, 0x10u);
+        EXPECT_EQ(loaded.load_us(), 0x20u);  // Через переполнение часов
+    }
+    EXPECT_EQ(ring.buffered_size(), 0u);
+    EXPECT_EQ(legacy.buffered_size(), 0u);
+}
+
+/**
+ * @brief Test: job_frame_id() finds the job in every immediate job frame
+ */
+TEST(FrameEncodingTest, JobFrameIdForEachFormat) {
+    mining::Job job;
+    job.job_id = 0x0A0B0C0D;
+    job.bits = 0x1705ae3a;
+    
+    network::AnyJobFrame frame{};
+    std::size_t size = network::NewJobMessage{job}.encode_any(frame);
+    EXPECT_EQ(network::job_frame_id(ByteSpan(frame.data(), size)), job.job_id);
+    
+    job.version_count = 2;
+    size = network::NewJobMessage{job}.encode_any(frame);
+    ASSERT_EQ(frame[0], static_cast<uint8_t>(network::Command::NewJobSlots));
+    EXPECT_EQ(network::job_frame_id(ByteSpan(frame.data(), size)), job.job_id);
+    
+    job.version_count = 0;
+    job.extranonce_lease = 16;
+    size = network::NewJobMessage{job}.encode_any(frame);
+    ASSERT_EQ(frame[0], static_cast<uint8_t>(network::Command::NewJobLease));
+    EXPECT_EQ(network::job_frame_id(ByteSpan(frame.data(), size)), job.job_id);
+    
+    job.extranonce_lease = 0;
+    job.version_mask = 0x1FFFE000;
+    size = network::NewJobMessage{job}.encode_any(frame);
+    ASSERT_EQ(frame[0], static_cast<uint8_t>(network::Command::NewJobRoll));
+    EXPECT_EQ(network::job_frame_id(ByteSpan(frame.data(), size)), job.job_id);
+    
+    // Задание в очередь ASIC, не задание и обрезанный кадр
+    std::array<uint8_t, network::NEW_JOB_FRAME_SIZE> queued{};
+    network::NewJobMessage{mining::Job{}}.encode_queued(queued);
+    EXPECT_FALSE(network::job_frame_id(queued).has_value());
+    EXPECT_FALSE(network::job_frame_id(network::serialize_heartbeat()).has_value());
+    EXPECT_FALSE(network::job_frame_id(ByteSpan(frame.data(), 3)).has_value());
+    EXPECT_FALSE(network::job_frame_id({}).has_value());
+}
+
+/**
+ * @brief Test: ShareLeased carries the extranonce offset
+ */
+TEST(FrameParserTest, ShareLeasedCarriesExtranonceOffset) {
+    Bytes frame = network::ShareMessage{mining::Share{9, 10, 0, 0x01020304}}.serialize();
+    ASSERT_EQ(frame.size(), network::SHARE_LEASED_FRAME_SIZE);
+    EXPECT_EQ(frame[0], static_cast<uint8_t>(network::Response::ShareLeased));
+    
+    network::FrameParser ring;
+    network::ProtocolParser legacy;
+    ASSERT_EQ(ring.add_data(frame), frame.size());
+    legacy.add_data(frame);
+    
+    for (auto msg : {ring.try_parse(), legacy.try_parse()}) {
+        ASSERT_TRUE(msg.has_value());
+        const auto& share = std::get<network::ShareMessage>(*msg).share;
+        EXPECT_EQ(share.job_id, 9u);
+        EXPECT_EQ(share.nonce, 10u);
+        EXPECT_EQ(share.extranonce_offset, 0x01020304u);
+    }
+    EXPECT_EQ(ring.buffered_size(), 0u);
+    EXPECT_EQ(legacy.buffered_size(), 0u);
+}
+
+/**
+ * @brief Test: NewJobLease frame round trip
+ */
+TEST(FrameParserTest, NewJobLeaseRoundTrip) {
+    mining::Job job;
+    job.job_id = 0x0A0B0C0D;
+    job.timestamp = 1700000000;
+    job.bits = 0x1705ae3a;
+    job.version = 0x20000000;
+    job.prev_block.fill(0x5A);
+    job.coinbase_midstate.fill(0x01020304);
+    job.coinbase_tail.fill(0xC3);
+    job.extranonce = 0x0000112233445566;
+    for (std::size_t i = 0; i < constants::EXTRANONCE_SIZE; ++i) {
+        job.coinbase_tail[i] = static_cast<uint8_t>(job.extranonce >> (i * 8));
+    }
+    job.extranonce_lease = 4096;
+    
+    network::NewJobMessage msg{job};
+    ASSERT_TRUE(msg.has_lease());
+    EXPECT_FALSE(msg.is_plain());
+    
+    network::AnyJobFrame frame{};
+    std::size_t size = msg.encode_any(frame);
+    EXPECT_EQ(size, network::NEW_JOB_LEASE_FRAME_SIZE);
+    EXPECT_EQ(frame[0], static_cast<uint8_t>(network::Command::NewJobLease));
+    EXPECT_EQ(Bytes(frame.begin(), frame.begin() + static_cast<std::ptrdiff_t>(size)), msg.serialize());
+    
+    auto parsed = network::NewJobMessage::deserialize_lease(ByteSpan(frame).subspan(1, size - 1));
+    ASSERT_TRUE(parsed.has_value());
+    EXPECT_EQ(parsed->job.job_id, job.job_id);
+    EXPECT_EQ(parsed->job.version, job.version);
+    EXPECT_EQ(parsed->job.prev_block, job.prev_block);
+    EXPECT_EQ(parsed->job.coinbase_midstate, job.coinbase_midstate);
+    EXPECT_EQ(parsed->job.coinbase_tail, job.coinbase_tail);
+    EXPECT_EQ(parsed->job.timestamp, job.timestamp);
+    EXPECT_EQ(parsed->job.bits, job.bits);
+    EXPECT_EQ(parsed->job.extranonce_lease, 4096u);
+    EXPECT_EQ(parsed->job.extranonce, job.extranonce);
+}
+
+/**
+ * @brief Test: ShareRolled carries the version rolled by the ASIC
+ */
+TEST(FrameParserTest, ShareRolledCarriesVersion) {
+    Bytes frame = network::ShareMessage{mining::Share{9, 10, 0, 0, 0x2000E000}}.serialize();
+    ASSERT_EQ(frame.size(), network::SHARE_ROLLED_FRAME_SIZE);
+    EXPECT_EQ(frame[0], static_cast<uint8_t>(network::Response::ShareRolled));
+    
+    network::FrameParser ring;
+    network::ProtocolParser legacy;
+    ASSERT_EQ(ring.add_data(frame), frame.size());
+    legacy.add_data(frame);
+    
+    for (auto msg : {ring.try_parse(), legacy.try_parse()}) {
+        ASSERT_TRUE(msg.has_value());
+        const auto& share = std::get<network::ShareMessage>(*msg).share;
+        EXPECT_EQ(share.job_id, 9u);
+        EXPECT_EQ(share.nonce, 10u);
+        EXPECT_EQ(share.version, 0x2000E000u);
+        EXPECT_EQ(share.extranonce_offset, 0u);
+    }
+    EXPECT_EQ(ring.buffered_size(), 0u);
+    EXPECT_EQ(legacy.buffered_size(), 0u);
+}
+
+/**
+ * @brief Test: NewJobRoll frame round trip
+ */
+TEST(FrameParserTest, NewJobRollRoundTrip) {
+    mining::Job job;
+    job.job_id = 0x0A0B0C0D;
+    job.timestamp = 1700000000;
+    job.bits = 0x1705ae3a;
+    job.version = 0x20000000;
+    job.prev_block.fill(0x5A);
+    job.merkle_root.fill(0xC3);
+    job.merkle_root[31] = 0x7E;
+    job.version_mask = 0x1FFFE000;
+    
+    network::NewJobMessage msg{job};
+    ASSERT_TRUE(msg.has_rolling());
+    EXPECT_FALSE(msg.is_plain());
+    
+    network::AnyJobFrame frame{};
+    std::size_t size = msg.encode_any(frame);
+    EXPECT_EQ(size, network::NEW_JOB_ROLL_FRAME_SIZE);
+    EXPECT_EQ(frame[0], static_cast<uint8_t>(network::Command::NewJobRoll));
+    EXPECT_EQ(Bytes(frame.begin(), frame.begin() + static_cast<std::ptrdiff_t>(size)), msg.serialize());
+    
+    auto parsed = network::NewJobMessage::deserialize_roll(ByteSpan(frame).subspan(1, size - 1));
+    ASSERT_TRUE(parsed.has_value());
+    EXPECT_EQ(parsed->job.job_id, job.job_id);
+    EXPECT_EQ(parsed->job.version, job.version);
+    EXPECT_EQ(parsed->job.prev_block, job.prev_block);
+    EXPECT_EQ(parsed->job.merkle_root, job.merkle_root);
+    EXPECT_EQ(parsed->job.merkle_tail[3], 0x7E);
+    EXPECT_EQ(parsed->job.timestamp, job.timestamp);
+    EXPECT_EQ(parsed->job.bits, job.bits);
+    EXPECT_EQ(parsed->job.version_mask, job.version_mask);
+    
+    // Без маски это не задание для локального перебора
+    frame[size - 4] = frame[size - 3] = frame[size - 2] = frame[size - 1] = 0;
+    EXPECT_FALSE(network::NewJobMessage::deserialize_roll(ByteSpan(frame).subspan(1, size - 1)).has_value());
+}
+
+/**
+ * @brief Test: NewJobSlots frame round trip
+ */
+TEST(FrameParserTest, NewJobSlotsRoundTrip) {
+    mining::Job job;
+    job.job_id = 0x0A0B0C0D;
+    job.timestamp = 1700000000;
+    job.bits = 0x1705ae3a;
+    job.merkle_tail = {1, 2, 3, 4};
+    job.version_count = 3;
+    for (uint32_t i = 0; i < 3; ++i) {
+        job.versions[i] = 0x20000000 | (i << 13);
+        job.version_midstates[i].fill(0x1000 + i);
+    }
+    job.midstate = job.version_midstates[0];
+    
+    network::NewJobMessage msg{job};
+    ASSERT_TRUE(msg.has_slots());
+    
+    network::AnyJobFrame frame{};
+    std::size_t size = msg.encode_any(frame);
+    EXPECT_EQ(size, network::NEW_JOB_SLOTS_HEADER_SIZE + 3 * network::NEW_JOB_SLOT_SIZE);
+    EXPECT_EQ(frame[0], static_cast<uint8_t>(network::Command::NewJobSlots));
+    EXPECT_EQ(Bytes(frame.begin(), frame.begin() + static_cast<std::ptrdiff_t>(size)), msg.serialize());
+    
+    auto parsed = network::NewJobMessage::deserialize_slots(ByteSpan(frame).subspan(1, size - 1));
+    ASSERT_TRUE(parsed.has_value());
+    EXPECT_EQ(parsed->job.job_id, job.job_id);
+    EXPECT_EQ(parsed->job.timestamp, job.timestamp);
+    EXPECT_EQ(parsed->job.bits, job.bits);
+    EXPECT_EQ(parsed->job.merkle_tail, job.merkle_tail);
+    EXPECT_EQ(parsed->job.version_count, 3);
+    EXPECT_EQ(parsed->job.versions, job.versions);
+    EXPECT_EQ(parsed->job.version_midstates, job.version_midstates);
+    
+    // Обычное задание кодируется прежним 49-байтным кадром
+    job.version_count = 0;
+    EXPECT_EQ(network::NewJobMessage{job}.encode_any(frame), network::NEW_JOB_FRAME_SIZE);
+    EXPECT_EQ(frame[0], static_cast<uint8_t>(network::Command::NewJob));
+}
+
+/**
+ * @brief Test: RSP_SHARE_BATCH is delivered as individual shares by both parsers
+ */
+TEST(FrameParserTest, ShareBatchExpandsToShares) {
+    std::vector<mining::Share> batch;
+    for (uint32_t i = 0; i < network::SHARE_BATCH_MAX; ++i) {
+        batch.push_back(mining::Share{100 + i, i});
+    }
+    
+    std::array<uint8_t, network::MAX_SHARE_BATCH_FRAME_SIZE> frame{};
+    std::size_t size = network::encode_share_batch(batch, frame);
+    ASSERT_EQ(size, frame.size());
+    EXPECT_EQ(network::encode_share_batch({}, frame), 0u);
+    
+    // Пакет, за ним одиночный share; пакет приходит двумя кусками
+    Bytes stream(frame.begin(), frame.end());
+    Bytes single = network::ShareMessage{mining::Share{7, 8}}.serialize();
+    stream.insert(stream.end(), single.begin(), single.end());
+    
+    network::FrameParser ring;
+    network::ProtocolParser legacy;
+    std::vector<uint32_t> ring_ids;
+    std::vector<uint32_t> legacy_ids;
+    
+    for (ByteSpan part : {ByteSpan(stream).first(100), ByteSpan(stream).subspan(100)}) {
+        ring.feed(part, [&](const network::ParsedMessage& msg) {
+            ring_ids.push_back(std::get<network::ShareMessage>(msg).share.job_id);
+        });
+        legacy.add_data(part);
+        while (auto msg = legacy.try_parse()) {
+            legacy_ids.push_back(std::get<network::ShareMessage>(*msg).share.job_id);
+        }
+    }
+    
+    ASSERT_EQ(ring_ids.size(), network::SHARE_BATCH_MAX + 1);
+    EXPECT_EQ(ring_ids, legacy_ids);
+    EXPECT_EQ(ring_ids.front(), 100u);
+    EXPECT_EQ(ring_ids.back(), 7u);
+}
+
+/**
+ * @brief Test: RSP_TELEMETRY longer than the share frames is decoded across the ring wrap
+ */
+TEST(FrameParserTest, TelemetryAcrossRingWrap) {
+    network::TelemetryMessage telemetry;
+    for (std::size_t i = 0; i < 1000; ++i) {
+        telemetry.payload.push_back(static_cast<uint8_t>(i * 31));
+    }
+    Bytes frame = telemetry.serialize();
+    ASSERT_EQ(frame.size(), network::TELEMETRY_HEADER_SIZE + 1000);
+    EXPECT_EQ(frame[0], static_cast<uint8_t>(network::Response::Telemetry));
+    
+    // Shares сдвигают кадр телеметрии через конец кольца
+    Bytes stream = make_share_stream(400);
+    stream.insert(stream.end(), frame.begin(), frame.end());
+    stream.insert(stream.end(), frame.begin(), frame.end());
+    
+    network::FrameParser ring;
+    network::ProtocolParser legacy;
+    std::vector<Bytes> ring_payloads;
+    std::vector<Bytes> legacy_payloads;
+    for (std::size_t offset = 0; offset < stream.size(); offset += 700) {
+        ByteSpan part = ByteSpan(stream).subspan(offset, std::min<std::size_t>(700, stream.size() - offset));
+        ring.feed(part, [&](const network::ParsedMessage& msg) {
+            if (auto* t = std::get_if<network::TelemetryMessage>(&msg)) {
+                ring_payloads.push_back(t->payload);
+            }
+        });
+        legacy.add_data(part);
+        while (auto msg = legacy.try_parse()) {
+            if (auto* t = std::get_if<network::TelemetryMessage>(&*msg)) {
+                legacy_payloads.push_back(t->payload);
+            }
+        }
+    }
+    
+    ASSERT_EQ(ring_payloads.size(), 2u);
+    EXPECT_EQ(ring_payloads[0], telemetry.payload);
+    EXPECT_EQ(ring_payloads[1], telemetry.payload);
+    EXPECT_EQ(legacy_payloads, ring_payloads);
+    
+    // Длина больше MAX_TELEMETRY_PAYLOAD - некорректный заголовок
+    Bytes bad = {static_cast<uint8_t>(network::Response::Telemetry), 0xFF, 0xFF};
+    EXPECT_FALSE(network::TelemetryMessage::deserialize(ByteSpan(bad).subspan(1)).has_value());
+}
+
+/**
+ * @brief Test: SetShareBatch round trip
+ */
+TEST(FrameEncodingTest, SetShareBatchRoundTrip) {
+    Bytes data = network::serialize_set_share_batch(16, 250);
+    ASSERT_EQ(data.size(), network::SET_SHARE_BATCH_FRAME_SIZE);
+    EXPECT_EQ(data[0], static_cast<uint8_t>(network::Command::SetShareBatch));
+    
+    auto msg = network::SetShareBatchMessage::deserialize(ByteSpan(data).subspan(1));
+    ASSERT_TRUE(msg.has_value());
+    EXPECT_EQ(msg->max_count, 16);
+    EXPECT_EQ(msg->flush_ms, 250);
+}
+
+/**
+ * @brief Test: UpdateTime round trip with and without nonce_start
+ */
+TEST(FrameEncodingTest, UpdateTimeRoundTrip) {
+    Bytes data = network::serialize_update_time(0x01020304, 1700000123, 0x80000000u);
+    ASSERT_EQ(data.size(), network::UPDATE_TIME_FRAME_SIZE);
+    EXPECT_EQ(data[0], static_cast<uint8_t>(network::Command::UpdateTime));
+    
+    auto msg = network::UpdateTimeMessage::deserialize(ByteSpan(data).subspan(1));
+    ASSERT_TRUE(msg.has_value());
+    EXPECT_EQ(msg->job_id, 0x01020304u);
+    EXPECT_EQ(msg->timestamp, 1700000123u);
+    EXPECT_EQ(msg->nonce_start, 0x80000000u);
+    
+    // Без флага nonce_start не передаётся (даже нулевой)
+    data = network::serialize_update_time(7, 1700000124);
+    msg = network::UpdateTimeMessage::deserialize(ByteSpan(data).subspan(1));
+    ASSERT_TRUE(msg.has_value());
+    EXPECT_FALSE(msg->nonce_start.has_value());
+    msg = network::UpdateTimeMessage::deserialize(ByteSpan(network::serialize_update_time(7, 1, 0u)).subspan(1));
+    ASSERT_TRUE(msg.has_value());
+    EXPECT_EQ(msg->nonce_start, 0u);
+    
+    EXPECT_FALSE(network::UpdateTimeMessage::deserialize(ByteSpan(data).subspan(1, 12)).has_value());
+}
+
+/**
+ * @brief Test: a rejected frame carries the code and a static context, no text
+ */
+TEST(FastErrorTest, MalformedFrameCarriesStaticContext) {
+    const std::array<uint8_t, 3> truncated{0x00, 0x01, 0x02};
+    
+    auto share = network::ShareMessage::deserialize(truncated);
+    ASSERT_FALSE(share.has_value());
+    EXPECT_EQ(share.error().code, ErrorCode::NetworkRecvFailed);
+    EXPECT_EQ(share.error().system_errno, 0);
+    EXPECT_EQ(share.error().message(), "Недостаточно данных для Share");
+    
+    auto job = network::NewJobMessage::deserialize_roll(truncated);
+    ASSERT_FALSE(job.has_value());
+    EXPECT_EQ(job.error().code, ErrorCode::NetworkRecvFailed);
+    EXPECT_STREQ(job.error().context, "Недостаточно данных для NewJobRoll");
+}
+
+/**
+ * @brief Test: FastError formats errno lazily and converts to Result<T>
+ */
+TEST(FastErrorTest, FormatsLazilyAndConvertsToResult) {
+    FastError bare{ErrorCode::NetworkTimeout, nullptr, 0};
+    EXPECT_EQ(bare.message(), to_string(ErrorCode::NetworkTimeout));
+    
+    FastError with_errno{ErrorCode::NetworkRecvFailed, "Ошибка poll", EINTR};
+    EXPECT_EQ(with_errno.message(), std::string("Ошибка poll: ") + std::strerror(EINTR));
+    
+    FastResult<int> fast = FastErr<int>(ErrorCode::NetworkRecvFailed, "Ошибка poll", EINTR);
+    Result<int> result = fast;
+    ASSERT_FALSE(result.has_value());
+    EXPECT_EQ(result.error().code, ErrorCode::NetworkRecvFailed);
+    EXPECT_EQ(result.error().message, with_errno.message());
+    
+    Result<int> value = FastResult<int>(42);
+    EXPECT_EQ(value.value(), 42);
+}
+
+} // namespace quaxis::tests
@@ -0,0 +1,418 @@
+/**
+ * @file test_handoff.cpp
+ * @brief Тесты передачи работы новому процессу
+ */
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <thread>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "bitcoin/coinbase.hpp"
+#include "core/byte_order.hpp"
+#include "core/constants.hpp"
+#include "mining/job_manager.hpp"
+#include "network/handoff.hpp"
+#include "network/protocol.hpp"
+
+namespace quaxis::tests {
+
+namespace {
+
+constexpr uint32_t HEIGHT = 850000;
+constexpr int64_t REWARD = 312'500'000;
+
+std::shared_ptr<const bitcoin::BlockTemplate> make_template() {
+    Hash160 pubkey_hash{};
+    pubkey_hash.fill(0x22);
+    bitcoin::CoinbaseBuilder builder(pubkey_hash);
+
+    auto tmpl = std::make_shared<bitcoin::BlockTemplate>();
+    tmpl->height = HEIGHT;
+    tmpl->coinbase_value = REWARD;
+    tmpl->header.prev_block.fill(0x11);
+    tmpl->header.timestamp = 1'700'000'000;
+    tmpl->header.bits = 0x1705ae3a;
+    tmpl->coinbase_tx = builder.build(HEIGHT, REWARD, 0);
+    return tmpl;
+}
+
+bitcoin::CoinbaseBuilder make_builder() {
+    Hash160 pubkey_hash{};
+    pubkey_hash.fill(0x22);
+    return bitcoin::CoinbaseBuilder(pubkey_hash);
+}
+
+/// @brief Путь unix сокета теста (sun_path - до 108 байт)
+std::string socket_path(const char* name) {
+    return (std::filesystem::temp_directory_path() /
+            (std::string("quaxis_") + name + "_" + std::to_string(::getpid()) + ".sock")).string();
+}
+
+/// @brief Дескриптор ссылается на тот же сокет: байт доходит до пары
+bool same_pipe(int written, int read_end) {
+    const uint8_t byte = 0x5a;
+    if (::send(written, &byte, 1, MSG_NOSIGNAL) != 1) {
+        return false;
+    }
+    uint8_t got = 0;
+    return ::recv(read_end, &got, 1, 0) == 1 && got == byte;
+}
+
+template<typename Pred>
+bool wait_until(Pred pred) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(3);
+    while (!pred()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return true;
+}
+
+int connect_loopback(uint16_t port) {
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+bool recv_frame(int fd, uint8_t* out, std::size_t size) {
+    std::size_t got = 0;
+    while (got < size) {
+        pollfd pfd{fd, POLLIN, 0};
+        if (::poll(&pfd, 1, 3000) <= 0) {
+            return false;
+        }
+        ssize_t n = ::recv(fd, out + got, size - got, 0);
+        if (n <= 0) {
+            return false;
+        }
+        got += static_cast<std::size_t>(n);
+    }
+    return true;
+}
+
+} // anonymous namespace
+
+TEST(HandoffTest, SnapshotRoundTrip) {
+    network::HandoffPackage package;
+    package.server.listen_fds = {10};
+    package.server.next_connection_id = 42;
+    network::HandedOffConnection connection;
+    connection.socket.fd = 11;
+    connection.socket.unparsed = {1, 2, 3};
+    connection.socket.unsent = {4, 5};
+    connection.remote_address = "10.0.0.7:4000";
+    connection.connection_id = 7;
+    connection.session_token = 0xABCDEF;
+    package.server.connections.push_back(connection);
+    package.server.parked_sessions.push_back({0x1234, 9});
+
+    package.jobs.block_template = make_template();
+    package.jobs.is_speculative = true;
+    package.jobs.next_job_id = 100;
+    mining::Job job;
+    job.job_id = 99;
+    job.height = HEIGHT;
+    job.extranonce = 5;
+    package.jobs.jobs.push_back(job);
+    package.jobs.leases.push_back({7, mining::ExtranonceLease{5, 16}});
+    package.jobs.next_extranonce = 21;
+
+    const Bytes snapshot = network::encode_handoff(package);
+    const int fds[] = {20, 21};
+    auto decoded = network::decode_handoff(snapshot, fds);
+    ASSERT_TRUE(decoded.has_value()) << decoded.error().message;
+
+    EXPECT_EQ(decoded->server.listen_fds, std::vector<int>{20});
+    EXPECT_EQ(decoded->server.next_connection_id, 42u);
+    ASSERT_EQ(decoded->server.connections.size(), 1u);
+    const auto& restored = decoded->server.connections[0];
+    EXPECT_EQ(restored.socket.fd, 21);
+    EXPECT_EQ(restored.socket.unparsed, (Bytes{1, 2, 3}));
+    EXPECT_EQ(restored.socket.unsent, (Bytes{4, 5}));
+    EXPECT_EQ(restored.remote_address, "10.0.0.7:4000");
+    EXPECT_EQ(restored.connection_id, 7u);
+    EXPECT_EQ(restored.session_token, 0xABCDEFu);
+    ASSERT_EQ(decoded->server.parked_sessions.size(), 1u);
+    EXPECT_EQ(decoded->server.parked_sessions[0].token, 0x1234u);
+
+    ASSERT_NE(decoded->jobs.block_template, nullptr);
+    EXPECT_EQ(decoded->jobs.block_template->height, HEIGHT);
+    EXPECT_EQ(decoded->jobs.block_template->header.prev_block, package.jobs.block_template->header.prev_block);
+    EXPECT_TRUE(decoded->jobs.is_speculative);
+    EXPECT_EQ(decoded->jobs.next_job_id, 100u);
+    ASSERT_EQ(decoded->jobs.jobs.size(), 1u);
+    EXPECT_EQ(decoded->jobs.jobs[0].job_id, 99u);
+    ASSERT_EQ(decoded->jobs.leases.size(), 1u);
+    EXPECT_EQ(decoded->jobs.leases[0].second.start, 5u);
+    EXPECT_EQ(decoded->jobs.leases[0].second.count, 16u);
+    EXPECT_EQ(decoded->jobs.next_extranonce, 21u);
+
+    // Число дескрипторов не совпадает со снимком
+    EXPECT_FALSE(network::decode_handoff(snapshot, std::span<const int>(fds, 1)).has_value());
+    // Обрезанный снимок
+    EXPECT_FALSE(network::decode_handoff(ByteSpan(snapshot).first(snapshot.size() / 2), fds).has_value());
+}
+
+TEST(HandoffTest, DescriptorsPassInChunks) {
+    int channel[2];
+    ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, channel), 0);
+
+    // Больше одной пачки SCM_RIGHTS
+    const std::size_t count = network::HANDOFF_FDS_PER_MESSAGE + 3;
+    std::vector<int> local;
+    std::vector<int> peers;
+    for (std::size_t i = 0; i < count; ++i) {
+        int pair[2];
+        ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, pair), 0);
+        local.push_back(pair[0]);
+        peers.push_back(pair[1]);
+    }
+
+    ASSERT_TRUE(network::send_descriptors(channel[0], local).has_value());
+    auto received = network::receive_descriptors(channel[1], count, 1000);
+    ASSERT_TRUE(received.has_value()) << received.error().message;
+    ASSERT_EQ(received->size(), count);
+
+    EXPECT_TRUE(same_pipe(received->front(), peers.front()));
+    EXPECT_TRUE(same_pipe(received->back(), peers.back()));
+
+    for (std::size_t i = 0; i < count; ++i) {
+        ::close(local[i]);
+        ::close(peers[i]);
+        ::close((*received)[i]);
+    }
+    ::close(channel[0]);
+    ::close(channel[1]);
+}
+
+TEST(HandoffTest, JobManagerContinuesJobsAndLeases) {
+    MiningConfig config;
+    config.extranonce_lease = 16;
+    mining::JobManager before(config, make_builder());
+    before.on_new_block(make_template(), false);
+    const uint64_t extranonce = before.register_connection(7);
+    auto job = before.get_next_job_for_connection(7);
+    ASSERT_TRUE(job.has_value());
+
+    const auto handoff = before.export_handoff();
+    mining::JobManager after(config, make_builder());
+    EXPECT_EQ(after.import_handoff(handoff), handoff.jobs.size());
+
+    // Выданное задание по-прежнему текущее, аренда - у того же соединения
+    auto found = after.get_job(job->job_id);
+    ASSERT_TRUE(found.has_value());
+    EXPECT_EQ(found->extranonce, job->extranonce);
+    EXPECT_EQ(after.get_connection_extranonce(7), extranonce);
+
+    // Новые соединения и задания не пересекаются с перенесёнными
+    EXPECT_GE(after.register_connection(8), extranonce + config.extranonce_lease);
+    auto next = after.get_next_job_for_connection(8);
+    ASSERT_TRUE(next.has_value());
+    EXPECT_GT(next->job_id, job->job_id);
+}
+
+TEST(HandoffTest, ListenerTransfersToClient) {
+    HandoffConfig config;
+    config.enabled = true;
+    config.socket_path = socket_path("handoff");
+    config.timeout_ms = 2000;
+
+    // Прежнего процесса нет - обычный запуск
+    {
+        network::HandoffClient client(config);
+        auto nothing = client.receive();
+        ASSERT_TRUE(nothing.has_value());
+        EXPECT_FALSE(nothing->has_value());
+    }
+
+    network::HandoffListener listener(config);
+    ASSERT_TRUE(listener.start().has_value());
+
+    int listen_pair[2];
+    int conn_pair[2];
+    ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, listen_pair), 0);
+    ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, conn_pair), 0);
+
+    network::HandoffPackage package;
+    package.server.listen_fds = {listen_pair[0]};
+    network::HandedOffConnection connection;
+    connection.socket.fd = conn_pair[0];
+    connection.socket.unsent = {9, 9};
+    connection.connection_id = 3;
+    package.server.connections.push_back(connection);
+
+    std::optional<network::HandoffPackage> received;
+    std::thread successor([&] {
+        network::HandoffClient client(config);
+        auto result = client.receive();
+        if (result && *result) {
+            received = std::move(**result);
+            (void)client.acknowledge();
+        }
+    });
+
+    bool requested = false;
+    for (int i = 0; i < 200 && !requested; ++i) {
+        requested = listener.poll_request();
+        if (!requested) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+    ASSERT_TRUE(requested);
+    auto transferred = listener.transfer(package);
+    successor.join();
+    ASSERT_TRUE(transferred.has_value()) << transferred.error().message;
+
+    ASSERT_TRUE(received.has_value());
+    ASSERT_EQ(received->server.connections.size(), 1u);
+    EXPECT_EQ(received->server.connections[0].socket.unsent, (Bytes{9, 9}));
+    EXPECT_EQ(received->server.connections[0].connection_id, 3u);
+    EXPECT_TRUE(same_pipe(received->server.connections[0].socket.fd, conn_pair[1]));
+
+    package.close_descriptors();
+    received->close_descriptors();
+    ::close(listen_pair[1]);
+    ::close(conn_pair[1]);
+
+    // Файл сокета освобождён для преемника
+    EXPECT_FALSE(std::filesystem::exists(config.socket_path));
+}
+
+TEST(HandoffTest, MissingAckRollsBack) {
+    HandoffConfig config;
+    config.enabled = true;
+    config.socket_path = socket_path("handoff_noack");
+    config.timeout_ms = 500;
+
+    network::HandoffListener listener(config);
+    ASSERT_TRUE(listener.start().has_value());
+
+    int pair[2];
+    ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, pair), 0);
+    network::HandoffPackage package;
+    package.server.listen_fds = {pair[0]};
+
+    std::thread successor([&] {
+        // Преемник получает работу, но не подтверждает запуск
+        network::HandoffClient client(config);
+        auto result = client.receive();
+        if (result && *result) {
+            (*result)->close_descriptors();
+        }
+    });
+
+    bool requested = false;
+    for (int i = 0; i < 200 && !requested; ++i) {
+        requested = listener.poll_request();
+        if (!requested) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+    ASSERT_TRUE(requested);
+    EXPECT_FALSE(listener.transfer(package).has_value());
+    successor.join();
+
+    // Сокеты по-прежнему у прежнего процесса
+    EXPECT_TRUE(same_pipe(pair[0], pair[1]));
+    ::close(pair[0]);
+    ::close(pair[1]);
+
+    // Слушать можно снова
+    EXPECT_TRUE(listener.start().has_value());
+    listener.stop();
+}
+
+class ServerHandoffTest : public ::testing::TestWithParam<const char*> {};
+
+/**
+ * @brief Соединение переживает передачу серверу с другим JobManager
+ */
+TEST_P(ServerHandoffTest, ConnectionSurvivesHandoff) {
+    const uint16_t port = static_cast<uint16_t>(std::string(GetParam()) == "epoll" ? 43393 : 43394);
+    ServerConfig config;
+    config.bind_address = "127.0.0.1";
+    config.port = port;
+    config.engine = GetParam();
+    config.worker_threads = 2;
+
+    mining::JobManager old_jobs(MiningConfig{}, make_builder());
+    network::Server old_server(config, old_jobs);
+    ASSERT_TRUE(old_server.start().has_value());
+
+    int fd = connect_loopback(port);
+    ASSERT_GE(fd, 0);
+    ASSERT_TRUE(wait_until([&] { return old_server.connection_count() == 1; }));
+    const auto extranonce = old_jobs.get_connection_extranonce(1);
+    ASSERT_TRUE(extranonce.has_value());
+
+    network::HandoffPackage package;
+    package.jobs = old_jobs.export_handoff();
+    package.server = old_server.detach_for_handoff();
+    EXPECT_EQ(old_server.connection_count(), 0u);
+    ASSERT_EQ(package.server.connections.size(), 1u);
+
+    // Снимок проходит тот же путь, что между процессами
+    const Bytes snapshot = network::encode_handoff(package);
+    const auto fds = package.descriptors();
+    auto restored = network::decode_handoff(snapshot, fds);
+    ASSERT_TRUE(restored.has_value());
+
+    mining::JobManager new_jobs(MiningConfig{}, make_builder());
+    new_jobs.import_handoff(restored->jobs);
+    network::Server new_server(config, new_jobs);
+    ASSERT_TRUE(new_server.resume(std::move(restored->server), true).has_value());
+    old_server.stop();
+
+    EXPECT_EQ(new_server.connection_count(), 1u);
+    EXPECT_EQ(new_jobs.get_connection_extranonce(1), extranonce);
+
+    // Тот же TCP поток: задание нового сервера доходит, share принимается
+    mining::Job job;
+    job.job_id = 0x01020304;
+    job.bits = 0x1705ae3a;
+    new_server.broadcast_job(job);
+    std::array<uint8_t, 1 + constants::JOB_MESSAGE_SIZE> frame{};
+    ASSERT_TRUE(recv_frame(fd, frame.data(), frame.size()));
+    EXPECT_EQ(frame[0], static_cast<uint8_t>(network::Command::NewJob));
+    EXPECT_EQ(read_le32(frame.data() + 1 + 44), job.job_id);
+
+    network::ShareMessage share{mining::Share{job.job_id, 42}};
+    auto data = share.serialize();
+    ASSERT_EQ(::send(fd, data.data(), data.size(), 0), static_cast<ssize_t>(data.size()));
+    EXPECT_TRUE(wait_until([&] { return new_server.stats().total_shares == 1; }));
+
+    // Listening сокет тоже передан: новые ASIC принимает новый сервер
+    int second = connect_loopback(port);
+    ASSERT_GE(second, 0);
+    EXPECT_TRUE(wait_until([&] { return new_server.connection_count() == 2; }));
+    EXPECT_NE(new_jobs.get_connection_extranonce(2), extranonce);
+
+    ::close(second);
+    ::close(fd);
+    EXPECT_TRUE(wait_until([&] { return new_server.connection_count() == 0; }));
+    new_server.stop();
+}
+
+INSTANTIATE_TEST_SUITE_P(Engines, ServerHandoffTest, ::testing::Values("threaded", "epoll"));
+
+} // namespace quaxis::tests
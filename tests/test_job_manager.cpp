@@ -0,0 +1,1465 @@
+/**
+ * @file test_job_manager.cpp
+ * @brief Tests for JobManager
+ *
+ * Validates per-connection job creation from the shared block template
+ * and O(1) job lookup through the preallocated job ring.
+ */
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "mining/block_submitter.hpp"
+#include "mining/duplicate_filter.hpp"
+#include "mining/job_manager.hpp"
+#include "mining/extranonce_lease.hpp"
+#include "mining/job_table.hpp"
+#include "mining/share_queue.hpp"
+#include "mining/share_validator.hpp"
+#include "mining/stratum_translator.hpp"
+#include "mining/template_cache.hpp"
+#include "mining/version_rolling.hpp"
+#include "bitcoin/coinbase.hpp"
+#include "bitcoin/target.hpp"
+#include "crypto/sha256.hpp"
+
+namespace quaxis::tests {
+
+class JobManagerTest : public ::testing::Test {
+protected:
+    static constexpr std::size_t QUEUE_SIZE = 8;
+
+    void SetUp() override {
+        MiningConfig config;
+        config.job_queue_size = QUEUE_SIZE;
+
+        Hash160 pubkey_hash{};
+        pubkey_hash.fill(0x11);
+        bitcoin::CoinbaseBuilder builder(pubkey_hash);
+
+        auto [coinbase, midstate] = builder.build_with_midstate(800000, 625000000, 0);
+        tmpl_.height = 800000;
+        tmpl_.header.timestamp = 1700000000;
+        tmpl_.header.bits = 0x1705ae3a;
+        tmpl_.coinbase_tx = std::move(coinbase);
+        tmpl_.coinbase_midstate = midstate;
+        tmpl_.update_extranonce(0);
+
+        manager_ = std::make_unique<mining::JobManager>(config, builder);
+    }
+
+    bitcoin::BlockTemplate tmpl_;
+    std::unique_ptr<mining::JobManager> manager_;
+};
+
+/**
+ * @brief Test: per-connection job midstate matches a template updated in place
+ */
+TEST_F(JobManagerTest, ConnectionJobMatchesUpdatedTemplate) {
+    manager_->on_new_block(tmpl_);
+    auto extranonce = manager_->register_connection(7);
+
+    auto job = manager_->get_next_job_for_connection(7);
+    ASSERT_TRUE(job.has_value());
+
+    auto expected = tmpl_;
+    expected.update_extranonce(extranonce);
+
+    EXPECT_EQ(job->midstate, expected.header_midstate);
+    EXPECT_EQ(job->extranonce, extranonce);
+    EXPECT_EQ(job->height, tmpl_.height);
+    EXPECT_EQ(job->bits, tmpl_.header.bits);
+}
+
+/**
+ * @brief Test: different connections get different midstates
+ */
+TEST_F(JobManagerTest, ConnectionsGetDistinctWork) {
+    manager_->on_new_block(tmpl_);
+    manager_->register_connection(1);
+    manager_->register_connection(2);
+
+    auto job1 = manager_->get_next_job_for_connection(1);
+    auto job2 = manager_->get_next_job_for_connection(2);
+    ASSERT_TRUE(job1 && job2);
+
+    EXPECT_NE(job1->job_id, job2->job_id);
+    EXPECT_NE(job1->midstate, job2->midstate);
+}
+
+/**
+ * @brief Test: the ring keeps only the last job_queue_size jobs
+ */
+TEST_F(JobManagerTest, RingEvictsOldestJobs) {
+    manager_->on_new_block(tmpl_);
+    manager_->register_connection(1);
+
+    std::vector<uint32_t> ids;
+    for (std::size_t i = 0; i < QUEUE_SIZE + 3; ++i) {
+        auto job = manager_->get_next_job_for_connection(1);
+        ASSERT_TRUE(job.has_value());
+        ids.push_back(job->job_id);
+    }
+
+    EXPECT_EQ(manager_->active_job_count(), QUEUE_SIZE);
+
+    // Первые 3 вытеснены, последние QUEUE_SIZE доступны
+    for (std::size_t i = 0; i < 3; ++i) {
+        EXPECT_FALSE(manager_->get_job(ids[i]).has_value());
+    }
+    for (std::size_t i = 3; i < ids.size(); ++i) {
+        auto job = manager_->get_job(ids[i]);
+        ASSERT_TRUE(job.has_value());
+        EXPECT_EQ(job->job_id, ids[i]);
+    }
+}
+
+/**
+ * @brief Test: new block clears all jobs
+ */
+TEST_F(JobManagerTest, NewBlockClearsJobs) {
+    manager_->on_new_block(tmpl_);
+    manager_->register_connection(1);
+    auto job = manager_->get_next_job_for_connection(1);
+    ASSERT_TRUE(job.has_value());
+
+    manager_->on_new_block(tmpl_);
+
+    EXPECT_EQ(manager_->active_job_count(), 0u);
+    EXPECT_FALSE(manager_->get_job(job->job_id).has_value());
+    EXPECT_FALSE(manager_->get_job(0).has_value());
+}
+
+/**
+ * @brief Test: shares for old-block and evicted jobs are stale, unknown ids are invalid
+ */
+TEST_F(JobManagerTest, StaleAndUnknownJobIdsClassified) {
+    manager_->on_new_block(tmpl_);
+    (void)manager_->register_connection(1);
+    auto old_job = manager_->get_next_job_for_connection(1);
+    ASSERT_TRUE(old_job.has_value());
+    
+    mining::ShareValidator validator(*manager_);
+    mining::Job out;
+    EXPECT_EQ(manager_->lookup_job(old_job->job_id, out), mining::JobLookup::Current);
+    
+    // Смена блока только меняет поколение: прежнее задание - stale
+    manager_->on_new_block(tmpl_);
+    EXPECT_EQ(manager_->lookup_job(old_job->job_id, out), mining::JobLookup::Stale);
+    EXPECT_EQ(validator.validate(mining::Share{old_job->job_id, 1}).result,
+              mining::ShareResult::StaleJob);
+    EXPECT_EQ(validator.validate(mining::Share{old_job->job_id + 1000, 1}).result,
+              mining::ShareResult::InvalidJobId);
+    EXPECT_EQ(validator.stale_shares(), 1u);
+    
+    // Вытесненное из кольца заданием нового поколения - тоже stale
+    std::optional<mining::Job> job;
+    for (std::size_t i = 0; i < QUEUE_SIZE + 1; ++i) {
+        job = manager_->get_next_job_for_connection(1);
+        ASSERT_TRUE(job.has_value());
+    }
+    EXPECT_EQ(manager_->active_job_count(), QUEUE_SIZE);
+    EXPECT_EQ(manager_->lookup_job(old_job->job_id, out), mining::JobLookup::Stale);
+    EXPECT_EQ(manager_->lookup_job(job->job_id, out), mining::JobLookup::Current);
+    EXPECT_EQ(out.job_id, job->job_id);
+    EXPECT_EQ(manager_->lookup_job(job->job_id + 1, out), mining::JobLookup::Unknown);
+}
+
+/**
+ * @brief Test: batch coinbase and header hashing matches the per-extranonce path
+ */
+TEST_F(JobManagerTest, BatchMerkleRootsAndMidstates) {
+    std::vector<uint64_t> extranonces(21);
+    for (std::size_t i = 0; i < extranonces.size(); ++i) {
+        extranonces[i] = 0x10000 * i + 7;
+    }
+    std::vector<Hash256> roots(extranonces.size());
+    std::vector<crypto::Sha256State> midstates(extranonces.size());
+    
+    tmpl_.merkle_roots_for_extranonces(extranonces, roots);
+    tmpl_.midstates_for_merkle_roots(roots, midstates);
+    for (std::size_t i = 0; i < extranonces.size(); ++i) {
+        EXPECT_EQ(roots[i], tmpl_.merkle_root_for_extranonce(extranonces[i]));
+        EXPECT_EQ(midstates[i], tmpl_.midstate_for_extranonce(extranonces[i]));
+    }
+}
+
+/**
+ * @brief Test: regenerate_all builds every connection's job like get_next_job_for_connection
+ */
+TEST_F(JobManagerTest, RegenerateAllMatchesPerConnectionJobs) {
+    for (std::size_t threads : {std::size_t{1}, std::size_t{4}}) {
+        MiningConfig config;
+        config.job_queue_size = 1024;
+        config.regenerate_threads = threads;
+        Hash160 pubkey_hash{};
+        pubkey_hash.fill(0x11);
+        mining::JobManager manager(config, bitcoin::CoinbaseBuilder(pubkey_hash));
+        
+        EXPECT_TRUE(manager.regenerate_all(std::vector<uint32_t>{1}).empty());
+        manager.on_new_block(tmpl_);
+        
+        // Больше REGENERATE_PARALLEL_MIN: куски расходятся по потокам пула
+        const std::size_t count = mining::JobManager::REGENERATE_PARALLEL_MIN + 37;
+        std::vector<uint32_t> ids;
+        for (uint32_t id = static_cast<uint32_t>(count); id >= 1; --id) {
+            (void)manager.register_connection(id);
+            ids.push_back(id);
+        }
+        ids.push_back(static_cast<uint32_t>(count + 100));  // Не зарегистрировано
+        
+        auto jobs = manager.regenerate_all(ids);
+        ASSERT_EQ(jobs.size(), count);
+        for (std::size_t i = 0; i < jobs.size(); ++i) {
+            const auto& pj = jobs[i];
+            EXPECT_EQ(pj.connection_id, i + 1);
+            ASSERT_NE(pj.job.job_id, 0u);
+            
+            auto extranonce = manager.get_connection_extranonce(pj.connection_id);
+            ASSERT_TRUE(extranonce.has_value());
+            EXPECT_EQ(pj.extranonce, *extranonce);
+            EXPECT_EQ(pj.job.midstate, tmpl_.midstate_for_extranonce(*extranonce));
+            EXPECT_EQ(pj.merkle_root, tmpl_.merkle_root_for_extranonce(*extranonce));
+            EXPECT_EQ(pj.job.timestamp, tmpl_.header.timestamp);
+            EXPECT_EQ(pj.message, pj.job.serialize());
+            
+            auto stored = manager.get_job(pj.job.job_id);
+            ASSERT_TRUE(stored.has_value());
+            EXPECT_EQ(stored->extranonce, *extranonce);
+        }
+    }
+}
+
+/**
+ * @brief Test: an aux update swaps the coinbase tail without a new block
+ */
+TEST_F(JobManagerTest, RefreshCoinbaseKeepsPreviousJobs) {
+    manager_->on_new_block(tmpl_);
+    std::vector<uint32_t> ids = {3, 1, 2};
+    for (uint32_t id : ids) {
+        (void)manager_->register_connection(id);
+    }
+    auto old_job = manager_->get_next_job_for_connection(1);
+    ASSERT_TRUE(old_job.has_value());
+    const auto generation = manager_->job_generation();
+    
+    // Хвост coinbase (после первых 64 байт) с другим commitment
+    Bytes coinbase = tmpl_.coinbase_tx;
+    coinbase[bitcoin::CoinbaseLayout::COMMITMENT_OFFSET] ^= 0x5a;
+    auto refreshed = tmpl_;
+    refreshed.coinbase_tx = coinbase;
+    
+    EXPECT_TRUE(manager_->refresh_coinbase(tmpl_.coinbase_tx, ids).empty());  // Та же coinbase
+    auto jobs = manager_->refresh_coinbase(coinbase, ids);
+    ASSERT_EQ(jobs.size(), ids.size());
+    EXPECT_EQ(manager_->job_generation(), generation);
+    for (std::size_t i = 0; i < jobs.size(); ++i) {
+        const auto& pj = jobs[i];
+        EXPECT_EQ(pj.connection_id, i + 1);
+        ASSERT_NE(pj.job.job_id, 0u);
+        EXPECT_EQ(pj.job.generation, generation);
+        EXPECT_EQ(pj.job.midstate, refreshed.midstate_for_extranonce(pj.extranonce));
+        EXPECT_EQ(pj.message, pj.job.serialize());
+    }
+    EXPECT_EQ(manager_->current_template()->coinbase_midstate, tmpl_.coinbase_midstate);
+    
+    // Прежнее задание остаётся текущим, его блок - с прежней coinbase
+    mining::Job found;
+    EXPECT_EQ(manager_->lookup_job(old_job->job_id, found), mining::JobLookup::Current);
+    auto coinbase_in = [](const Bytes& block, const Bytes& coinbase_tx) {
+        constexpr auto offset = bitcoin::CoinbaseLayout::COMMITMENT_OFFSET;
+        return std::equal(coinbase_tx.begin() + offset, coinbase_tx.end(),
+                          block.begin() + bitcoin::BlockSkeleton::COINBASE_OFFSET + offset);
+    };
+    auto old_block = manager_->build_found_block(old_job->job_id, old_job->extranonce, 0, 1);
+    ASSERT_TRUE(old_block.has_value());
+    EXPECT_TRUE(coinbase_in(*old_block, tmpl_.coinbase_tx));
+    auto new_block = manager_->build_found_block(jobs[0].job.job_id, jobs[0].extranonce, 0, 1);
+    ASSERT_TRUE(new_block.has_value());
+    EXPECT_TRUE(coinbase_in(*new_block, coinbase));
+    const Hash256 merkle_root = refreshed.merkle_root_for_extranonce(jobs[0].extranonce);
+    EXPECT_TRUE(std::equal(merkle_root.begin(), merkle_root.end(),
+                           new_block->begin() + bitcoin::BlockSkeleton::MERKLE_ROOT_OFFSET));
+}
+
+/**
+ * @brief Test: a pre-leased extranonce comes with a ready job for the current template
+ */
+TEST_F(JobManagerTest, PreleasedJobReadyOnClaim) {
+    MiningConfig config;
+    config.job_queue_size = 64;
+    config.prelease_pool = 4;
+    Hash160 pubkey_hash{};
+    pubkey_hash.fill(0x11);
+    mining::JobManager manager(config, bitcoin::CoinbaseBuilder(pubkey_hash));
+    
+    // Без шаблона пул не собирается: соединение регистрируется обычным путём
+    EXPECT_EQ(manager.refresh_prelease_pool(), 0u);
+    EXPECT_FALSE(manager.claim_preleased_job(1).has_value());
+    
+    manager.on_new_block(tmpl_);
+    EXPECT_EQ(manager.refresh_prelease_pool(), 4u);
+    EXPECT_EQ(manager.refresh_prelease_pool(), 0u);  // Уже готов
+    
+    auto first = manager.claim_preleased_job(7);
+    ASSERT_TRUE(first.has_value());
+    ASSERT_NE(first->job.job_id, 0u);
+    EXPECT_EQ(first->connection_id, 7u);
+    EXPECT_EQ(manager.get_connection_extranonce(7), first->extranonce);
+    EXPECT_EQ(first->job.midstate, tmpl_.midstate_for_extranonce(first->extranonce));
+    EXPECT_EQ(first->message, first->job.serialize());
+    EXPECT_TRUE(manager.get_job(first->job.job_id).has_value());
+    
+    // Дополняется только взятое, extranonce пула не совпадают с выданными
+    EXPECT_EQ(manager.prelease_pool_size(), 3u);
+    EXPECT_EQ(manager.refresh_prelease_pool(), 1u);
+    EXPECT_NE(manager.register_connection(8), first->extranonce);
+    
+    // Кадр прежнего шаблона пересобирается при выдаче
+    auto next = tmpl_;
+    next.header.timestamp += 600;
+    next.update_extranonce(0);
+    manager.on_new_block(next);
+    auto second = manager.claim_preleased_job(9);
+    ASSERT_TRUE(second.has_value());
+    ASSERT_NE(second->job.job_id, 0u);
+    EXPECT_NE(second->extranonce, first->extranonce);
+    EXPECT_EQ(second->job.timestamp, next.header.timestamp);
+    EXPECT_EQ(second->job.midstate, next.midstate_for_extranonce(second->extranonce));
+    EXPECT_EQ(second->message, second->job.serialize());
+    EXPECT_EQ(manager.active_connection_count(), 3u);
+}
+
+/**
+ * @brief Test: confirming a speculative block updates stored jobs
+ */
+TEST_F(JobManagerTest, ConfirmSpeculativeBlock) {
+    manager_->on_new_block(tmpl_, true);
+    manager_->register_connection(1);
+    auto job = manager_->get_next_job_for_connection(1);
+    ASSERT_TRUE(job.has_value());
+    EXPECT_TRUE(job->is_speculative);
+
+    manager_->confirm_speculative_block();
+
+    auto stored = manager_->get_job(job->job_id);
+    ASSERT_TRUE(stored.has_value());
+    EXPECT_FALSE(stored->is_speculative);
+    EXPECT_TRUE(manager_->has_template());
+}
+
+/**
+ * @brief Test: unregistered connection gets no job
+ */
+TEST_F(JobManagerTest, UnregisteredConnectionHasNoJob) {
+    manager_->on_new_block(tmpl_);
+    EXPECT_FALSE(manager_->get_next_job_for_connection(42).has_value());
+}
+
+/**
+ * @brief Test: precomputed next-height jobs match jobs built on block arrival
+ */
+TEST_F(JobManagerTest, PrecomputedJobSetMatchesOnDemandJobs) {
+    Hash160 pubkey_hash{};
+    pubkey_hash.fill(0x11);
+    MiningConfig config;
+    mining::TemplateCache cache(config, bitcoin::CoinbaseBuilder(pubkey_hash));
+    
+    Hash256 tip{};
+    tip.fill(0xAB);
+    
+    manager_->register_connection(1);
+    manager_->register_connection(2);
+    
+    cache.update_template(Hash256{}, 800000, 0x1705ae3a, 1700000000, 625000000);
+    cache.precompute_next(800001, 0x1705ae3a);
+    ASSERT_EQ(cache.precompute_next_jobs(manager_->extranonce_manager()), 2u);
+    
+    // Другая высота — набор не отдаётся
+    EXPECT_FALSE(cache.take_next_jobs(tip, 800002, 1700000600).has_value());
+    
+    auto set = cache.take_next_jobs(tip, 800001, 1700000600);
+    ASSERT_TRUE(set.has_value());
+    ASSERT_EQ(set->jobs.size(), 2u);
+    EXPECT_EQ(set->block_template.header.prev_block, tip);
+    EXPECT_EQ(cache.current_height(), 800001u);
+    
+    manager_->on_new_block(set->block_template);
+    EXPECT_EQ(manager_->adopt_precomputed_jobs(set->jobs), 2u);
+    
+    for (const auto& pj : set->jobs) {
+        ASSERT_NE(pj.job.job_id, 0u);
+        EXPECT_EQ(pj.job.midstate, set->block_template.midstate_for_extranonce(pj.extranonce));
+        EXPECT_EQ(pj.job.timestamp, 1700000600u);
+        
+        auto stored = manager_->get_job(pj.job.job_id);
+        ASSERT_TRUE(stored.has_value());
+        EXPECT_EQ(stored->serialize(), pj.message);
+    }
+}
+
+/**
+ * @brief Test: expected tip known in advance, stale connections are skipped
+ */
+TEST_F(JobManagerTest, PrecomputedJobSetWithExpectedTip) {
+    Hash160 pubkey_hash{};
+    pubkey_hash.fill(0x11);
+    MiningConfig config;
+    mining::TemplateCache cache(config, bitcoin::CoinbaseBuilder(pubkey_hash));
+    
+    Hash256 tip{};
+    tip.fill(0xCD);
+    
+    manager_->register_connection(1);
+    manager_->register_connection(2);
+    
+    cache.update_template(Hash256{}, 800000, 0x1705ae3a, 1700000000, 625000000);
+    cache.precompute_next(800001, 0x1705ae3a);
+    ASSERT_EQ(cache.precompute_next_jobs(manager_->extranonce_manager(), tip), 2u);
+    
+    manager_->unregister_connection(2);
+    
+    auto set = cache.take_next_jobs(tip, 800001, 1700000700);
+    ASSERT_TRUE(set.has_value());
+    
+    manager_->on_new_block(set->block_template);
+    EXPECT_EQ(manager_->adopt_precomputed_jobs(set->jobs), 1u);
+    
+    EXPECT_EQ(set->jobs[0].connection_id, 1u);
+    EXPECT_EQ(set->jobs[0].job.midstate, set->block_template.midstate_for_extranonce(set->jobs[0].extranonce));
+    EXPECT_EQ(manager_->get_job(set->jobs[0].job.job_id)->serialize(), set->jobs[0].message);
+    EXPECT_EQ(set->jobs[1].job.job_id, 0u);
+}
+
+namespace {
+
+std::string to_hex(ByteSpan bytes) {
+    static constexpr char digits[] = "0123456789abcdef";
+    std::string hex;
+    for (uint8_t byte : bytes) {
+        hex += digits[byte >> 4];
+        hex += digits[byte & 0x0F];
+    }
+    return hex;
+}
+
+/// @brief mining.notify пула: BIP34 высота 800001, три уровня ветви
+struct StratumNotify {
+    Bytes coinbase1;
+    Bytes coinbase2;
+    Bytes extranonce1{0xf0, 0x00, 0x00, 0x0a};
+    std::vector<std::string> branch_hex;
+    std::vector<Hash256> branch;
+
+    explicit StratumNotify(std::size_t coinbase2_size) {
+        // version | 1 вход | prevout | длина scriptSig | push высоты
+        coinbase1 = {0x01, 0x00, 0x00, 0x00, 0x01};
+        coinbase1.insert(coinbase1.end(), 32, 0x00);
+        coinbase1.insert(coinbase1.end(), 4, 0xFF);
+        coinbase1.insert(coinbase1.end(), {0x20, 0x03, 0x01, 0x35, 0x0c});
+        coinbase2.resize(coinbase2_size);
+        for (std::size_t i = 0; i < coinbase2.size(); ++i) {
+            coinbase2[i] = static_cast<uint8_t>(i * 7);
+        }
+        for (uint8_t level = 1; level <= 3; ++level) {
+            Hash256 hash{};
+            hash.fill(level);
+            branch.push_back(hash);
+            branch_hex.push_back(to_hex(hash));
+        }
+    }
+
+    /// @brief Merkle root полной сборкой coinbase
+    Hash256 expected_root(uint64_t extranonce2) const {
+        Bytes coinbase = coinbase1;
+        coinbase.insert(coinbase.end(), extranonce1.begin(), extranonce1.end());
+        for (int i = 3; i >= 0; --i) {
+            coinbase.push_back(static_cast<uint8_t>(extranonce2 >> (i * 8)));
+        }
+        coinbase.insert(coinbase.end(), coinbase2.begin(), coinbase2.end());
+
+        Hash256 root = crypto::sha256d(ByteSpan(coinbase.data(), coinbase.size()));
+        for (const auto& hash : branch) {
+            uint8_t pair[64];
+            std::memcpy(pair, root.data(), 32);
+            std::memcpy(pair + 32, hash.data(), 32);
+            root = crypto::sha256d(ByteSpan(pair, sizeof(pair)));
+        }
+        return root;
+    }
+
+    Result<mining::StratumWork> parse() const {
+        return mining::parse_stratum_work(
+            "6a3f",
+            "00112233445566778899aabbccddeeff00112233445566778899aabbccddeeff",
+            to_hex(coinbase1), to_hex(coinbase2), branch_hex,
+            "20000000", "1705ae3a", "65a1b2c3", to_hex(extranonce1), 4);
+    }
+};
+
+} // anonymous namespace
+
+/**
+ * @brief Test: Stratum job fields, merkle roots against a full coinbase rebuild
+ */
+TEST(StratumTranslatorTest, MerkleRootsMatchFullCoinbase) {
+    // Хвост coinbase на несколько блоков и хвост короче одного блока
+    for (std::size_t coinbase2_size : {std::size_t{150}, std::size_t{10}}) {
+        StratumNotify notify(coinbase2_size);
+        auto work = notify.parse();
+        ASSERT_TRUE(work.has_value());
+        EXPECT_EQ(work->version, 0x20000000u);
+        EXPECT_EQ(work->bits, 0x1705ae3au);
+        EXPECT_EQ(work->ntime, 0x65a1b2c3u);
+        EXPECT_EQ(work->height, 800001u);
+        // Слова prevhash переставлены в порядок заголовка
+        EXPECT_EQ(work->prev_block[0], 0x33);
+        EXPECT_EQ(work->prev_block[3], 0x00);
+        EXPECT_EQ(work->prev_block[4], 0x77);
+
+        mining::StratumJobTranslator translator;
+        ASSERT_TRUE(translator.set_work(*work).has_value());
+
+        std::vector<uint64_t> extranonces;
+        for (uint64_t i = 1; i <= 19; ++i) {
+            extranonces.push_back(i * 0x01010101ULL);
+        }
+        std::vector<Hash256> roots(extranonces.size());
+        ASSERT_EQ(translator.merkle_roots(extranonces, roots), extranonces.size());
+        for (std::size_t i = 0; i < extranonces.size(); ++i) {
+            EXPECT_EQ(roots[i], notify.expected_root(extranonces[i])) << i;
+        }
+        EXPECT_EQ(translator.merkle_root(7), notify.expected_root(7));
+        EXPECT_EQ(translator.extranonce2_hex(0x0102), "00000102");
+    }
+
+    // Некорректные поля не принимаются
+    StratumNotify notify(150);
+    EXPECT_FALSE(mining::parse_stratum_work("1", "00", to_hex(notify.coinbase1), "", {},
+        "20000000", "1705ae3a", "65a1b2c3", "", 4).has_value());
+    auto work = notify.parse();
+    ASSERT_TRUE(work.has_value());
+    work->extranonce2_size = 9;
+    mining::StratumJobTranslator translator;
+    EXPECT_EQ(translator.set_work(*work).error().code, ErrorCode::MiningInvalidJob);
+    EXPECT_FALSE(translator.has_work());
+}
+
+/**
+ * @brief Test: translated Stratum jobs are adopted by JobManager like solo precomputed sets
+ */
+TEST_F(JobManagerTest, StratumJobSetAdoptedLikeSoloSet) {
+    StratumNotify notify(150);
+    auto work = notify.parse();
+    ASSERT_TRUE(work.has_value());
+
+    mining::StratumJobTranslator translator;
+    ASSERT_TRUE(translator.set_work(*work).has_value());
+
+    for (uint32_t id = 1; id <= 5; ++id) {
+        manager_->register_connection(id);
+    }
+
+    auto set = translator.translate(manager_->extranonce_manager());
+    ASSERT_EQ(set.jobs.size(), 5u);
+    EXPECT_EQ(set.block_template.height, 800001u);
+
+    manager_->on_new_block(set.block_template);
+    EXPECT_EQ(manager_->adopt_precomputed_jobs(set.jobs), 5u);
+
+    for (const auto& pj : set.jobs) {
+        bitcoin::BlockHeader header = translator.header();
+        header.merkle_root = notify.expected_root(pj.extranonce);
+        EXPECT_EQ(pj.merkle_root, header.merkle_root);
+        EXPECT_EQ(pj.job.midstate, header.compute_midstate());
+        EXPECT_EQ(pj.job.timestamp, 0x65a1b2c3u);
+        EXPECT_EQ(pj.job.bits, 0x1705ae3au);
+
+        auto stored = manager_->get_job(pj.job.job_id);
+        ASSERT_TRUE(stored.has_value());
+        EXPECT_EQ(stored->serialize(), pj.message);
+        EXPECT_EQ(stored->extranonce, pj.extranonce);
+    }
+}
+
+/**
+ * @brief Test: competing tips of one height reuse ready job sets
+ */
+TEST_F(JobManagerTest, CompetingTipsKeepWarmJobSets) {
+    Hash160 pubkey_hash{};
+    pubkey_hash.fill(0x11);
+    MiningConfig config;
+    config.competing_tips = 2;
+    mining::TemplateCache cache(config, bitcoin::CoinbaseBuilder(pubkey_hash));
+    
+    Hash256 tip_a{};
+    tip_a.fill(0xA1);
+    Hash256 tip_b{};
+    tip_b.fill(0xB2);
+    
+    manager_->register_connection(1);
+    manager_->register_connection(2);
+    
+    cache.update_template(Hash256{}, 800000, 0x1705ae3a, 1700000000, 625000000);
+    cache.precompute_next(800001, 0x1705ae3a);
+    ASSERT_EQ(cache.precompute_next_jobs(manager_->extranonce_manager()), 2u);
+    
+    auto set_a = cache.take_next_jobs(tip_a, 800001, 1700000600);
+    ASSERT_TRUE(set_a.has_value());
+    cache.precompute_next(800002, 0x1705ae3a);
+    
+    // Сосед той же высоты: набор A с новым prev_block
+    auto set_b = cache.take_next_jobs(tip_b, 800001, 1700000610);
+    ASSERT_TRUE(set_b.has_value());
+    EXPECT_EQ(set_b->block_template.header.prev_block, tip_b);
+    ASSERT_EQ(set_b->jobs.size(), 2u);
+    for (const auto& pj : set_b->jobs) {
+        EXPECT_EQ(pj.job.midstate, set_b->block_template.midstate_for_extranonce(pj.extranonce));
+        EXPECT_EQ(pj.job.timestamp, 1700000610u);
+    }
+    EXPECT_EQ(cache.competing_tip_count(), 2u);
+    
+    // Возврат к A: те же задания, только timestamp
+    auto again_a = cache.take_next_jobs(tip_a, 800001, 1700000620);
+    ASSERT_TRUE(again_a.has_value());
+    EXPECT_EQ(again_a->block_template.header.prev_block, tip_a);
+    ASSERT_EQ(again_a->jobs.size(), 2u);
+    for (std::size_t i = 0; i < again_a->jobs.size(); ++i) {
+        EXPECT_EQ(again_a->jobs[i].job.midstate, set_a->jobs[i].job.midstate);
+        EXPECT_EQ(again_a->jobs[i].job.timestamp, 1700000620u);
+    }
+    manager_->on_new_block(again_a->block_template);
+    EXPECT_EQ(manager_->adopt_precomputed_jobs(again_a->jobs), 2u);
+    EXPECT_EQ(manager_->get_job(again_a->jobs[0].job.job_id)->serialize(), again_a->jobs[0].message);
+    
+    // Следующая высота вытесняет наборы гонки
+    Hash256 tip_c{};
+    tip_c.fill(0xC3);
+    ASSERT_TRUE(cache.take_next_jobs(tip_c, 800002, 1700001200).has_value());
+    EXPECT_EQ(cache.competing_tip_count(), 1u);
+    EXPECT_FALSE(cache.take_next_jobs(tip_a, 800001, 1700000630).has_value());
+    
+    // Tip, собранный без кеша
+    Hash256 tip_d{};
+    tip_d.fill(0xD4);
+    cache.update_template(tip_d, 800003, 0x1705ae3a, 1700001800, 625000000);
+    EXPECT_EQ(cache.remember_current_jobs(manager_->extranonce_manager()), 2u);
+    auto set_d = cache.take_next_jobs(tip_d, 800003, 1700001810);
+    ASSERT_TRUE(set_d.has_value());
+    EXPECT_EQ(set_d->jobs[1].job.midstate, set_d->block_template.midstate_for_extranonce(set_d->jobs[1].extranonce));
+}
+
+/**
+ * @brief Test: an invalid speculative block rolls back to the retained previous-tip jobs
+ */
+TEST_F(JobManagerTest, SpeculativeRollbackRestoresRetainedJobs) {
+    Hash160 pubkey_hash{};
+    pubkey_hash.fill(0x11);
+    mining::TemplateCache cache(MiningConfig{}, bitcoin::CoinbaseBuilder(pubkey_hash));
+    
+    manager_->on_new_block(tmpl_);
+    manager_->register_connection(1);
+    manager_->register_connection(2);
+    auto previous = manager_->current_template();
+    EXPECT_EQ(manager_->rollback_template(), nullptr);
+    
+    bitcoin::BlockTemplate spy = tmpl_;
+    spy.height = tmpl_.height + 1;
+    spy.header.prev_block.fill(0x5A);
+    spy.update_extranonce(0);
+    manager_->on_new_block(spy, true);
+    EXPECT_EQ(manager_->rollback_template(), previous);
+    EXPECT_EQ(cache.retain_rollback(manager_->rollback_template(), manager_->extranonce_manager()), 2u);
+    
+    // Speculative поверх speculative откатывается к тому же tip, набор не пересобирается
+    spy.height += 1;
+    manager_->on_new_block(spy, true);
+    EXPECT_EQ(manager_->rollback_template(), previous);
+    EXPECT_EQ(cache.retain_rollback(manager_->rollback_template(), manager_->extranonce_manager()), 2u);
+    
+    auto set = cache.take_rollback();
+    ASSERT_NE(set, nullptr);
+    EXPECT_EQ(cache.take_rollback(), nullptr);
+    const uint32_t generation = manager_->job_generation();
+    ASSERT_TRUE(manager_->rollback_speculative_block(set->block_template, set->jobs));
+    EXPECT_NE(manager_->job_generation(), generation);
+    EXPECT_EQ(manager_->current_template(), previous);
+    EXPECT_EQ(manager_->rollback_template(), nullptr);
+    ASSERT_EQ(set->jobs.size(), 2u);
+    for (const auto& pj : set->jobs) {
+        ASSERT_NE(pj.job.job_id, 0u);
+        auto stored = manager_->get_job(pj.job.job_id);
+        ASSERT_TRUE(stored.has_value());
+        EXPECT_FALSE(stored->is_speculative);
+        EXPECT_EQ(stored->serialize(), pj.message);
+        EXPECT_EQ(pj.job.midstate, previous->midstate_for_extranonce(pj.extranonce));
+    }
+    
+    // Набор чужого шаблона не принимается: задания соберёт regenerate_all()
+    manager_->on_new_block(spy, true);
+    EXPECT_EQ(cache.retain_rollback(std::make_shared<const bitcoin::BlockTemplate>(tmpl_),
+                                    manager_->extranonce_manager()), 2u);
+    auto foreign = cache.take_rollback();
+    ASSERT_NE(foreign, nullptr);
+    EXPECT_TRUE(manager_->rollback_speculative_block(foreign->block_template, foreign->jobs));
+    EXPECT_EQ(manager_->current_template(), previous);
+    for (const auto& pj : foreign->jobs) {
+        EXPECT_EQ(pj.job.job_id, 0u);
+    }
+    
+    // Не speculative - откатывать нечего
+    EXPECT_FALSE(manager_->rollback_speculative_block(previous, {}));
+    EXPECT_TRUE(manager_->has_template());
+}
+
+/**
+ * @brief Test: version slots carry one midstate per rolled version over a shared tail
+ */
+TEST_F(JobManagerTest, VersionSlotJobsValidatePerSlot) {
+    MiningConfig config;
+    config.version_slots = 4;
+    Hash160 pubkey_hash{};
+    pubkey_hash.fill(0x11);
+    mining::JobManager manager(config, bitcoin::CoinbaseBuilder(pubkey_hash));
+    
+    manager.on_new_block(tmpl_);
+    auto extranonce = manager.register_connection(1);
+    auto job = manager.get_next_job_for_connection(1);
+    ASSERT_TRUE(job.has_value());
+    ASSERT_EQ(job->version_count, 4);
+    
+    auto header = tmpl_.header_for_extranonce(extranonce);
+    EXPECT_EQ(job->midstate, header.compute_midstate());
+    EXPECT_EQ(job->versions[0], header.version);
+    EXPECT_TRUE(std::equal(job->merkle_tail.begin(), job->merkle_tail.end(), header.merkle_root.begin() + 28));
+    
+    // Share из слота 2 проверяется по midstate своей версии
+    mining::ShareValidator validator(manager);
+    mining::Share share{job->job_id, 0x12345678, 2};
+    auto result = validator.validate(share);
+    
+    header.version = job->versions[2];
+    header.nonce = share.nonce;
+    EXPECT_EQ(result.hash, header.hash());
+    EXPECT_EQ(result.version_slot, 2);
+    EXPECT_EQ(result.version, job->versions[2]);
+    
+    // Тот же nonce в другом слоте - другая работа, а не дубликат
+    share.version_slot = 1;
+    EXPECT_NE(validator.validate(share).result, mining::ShareResult::DuplicateShare);
+    
+    share.version_slot = 4;
+    EXPECT_EQ(validator.validate(share).result, mining::ShareResult::InvalidJobId);
+}
+
+/**
+ * @brief Test: precomputed jobs get version slots when adopted
+ */
+TEST_F(JobManagerTest, PrecomputedJobsGetVersionSlots) {
+    Hash160 pubkey_hash{};
+    pubkey_hash.fill(0x11);
+    MiningConfig config;
+    config.version_slots = 3;
+    mining::JobManager manager(config, bitcoin::CoinbaseBuilder(pubkey_hash));
+    mining::TemplateCache cache(config, bitcoin::CoinbaseBuilder(pubkey_hash));
+    
+    Hash256 tip{};
+    tip.fill(0xEF);
+    
+    manager.register_connection(1);
+    cache.update_template(Hash256{}, 800000, 0x1705ae3a, 1700000000, 625000000);
+    cache.precompute_next(800001, 0x1705ae3a);
+    ASSERT_EQ(cache.precompute_next_jobs(manager.extranonce_manager(), tip), 1u);
+    
+    auto set = cache.take_next_jobs(tip, 800001, 1700000700);
+    ASSERT_TRUE(set.has_value());
+    manager.on_new_block(set->block_template);
+    ASSERT_EQ(manager.adopt_precomputed_jobs(set->jobs), 1u);
+    
+    const auto& pj = set->jobs[0];
+    auto header = set->block_template.header_for_extranonce(pj.extranonce);
+    ASSERT_EQ(pj.job.version_count, 3);
+    EXPECT_EQ(pj.job.midstate, header.compute_midstate());
+    for (std::size_t i = 0; i < 3; ++i) {
+        EXPECT_EQ(pj.job.version_midstates[i], mining::compute_versioned_midstate(header.serialize(), pj.job.versions[i]));
+    }
+    EXPECT_EQ(manager.get_job(pj.job.job_id)->version_count, 3);
+}
+
+/**
+ * @brief Test: a leased job lets the ASIC roll extranonce without a new job
+ */
+TEST_F(JobManagerTest, LeasedJobsValidateRolledExtranonce) {
+    MiningConfig config;
+    config.extranonce_lease = 16;
+    Hash160 pubkey_hash{};
+    pubkey_hash.fill(0x11);
+    mining::JobManager manager(config, bitcoin::CoinbaseBuilder(pubkey_hash));
+    
+    manager.on_new_block(tmpl_);
+    auto first = manager.register_connection(1);
+    auto second = manager.register_connection(2);
+    EXPECT_EQ(second - first, 16u);  // Диапазоны не пересекаются
+    
+    auto job = manager.get_next_job_for_connection(1);
+    ASSERT_TRUE(job.has_value());
+    ASSERT_EQ(job->extranonce_lease, 16u);
+    EXPECT_EQ(job->midstate, tmpl_.header_for_extranonce(first).compute_midstate());
+    
+    // Контроллер ASIC строит тот же заголовок, что и шаблон
+    auto rolled = mining::leased_header(*job, 5);
+    ASSERT_TRUE(rolled.has_value());
+    EXPECT_EQ(rolled->merkle_root, tmpl_.header_for_extranonce(first + 5).merkle_root);
+    EXPECT_FALSE(mining::leased_header(*job, 16).has_value());
+    
+    mining::ShareValidator validator(manager);
+    mining::Share share{job->job_id, 0x12345678, 0, 5};
+    auto result = validator.validate(share);
+    
+    auto header = tmpl_.header_for_extranonce(first + 5);
+    header.nonce = share.nonce;
+    EXPECT_EQ(result.hash, header.hash());
+    EXPECT_EQ(result.extranonce, first + 5);
+    
+    // Тот же nonce с другим extranonce - другая работа
+    share.extranonce_offset = 6;
+    EXPECT_NE(validator.validate(share).result, mining::ShareResult::DuplicateShare);
+    
+    share.extranonce_offset = 16;
+    EXPECT_EQ(validator.validate(share).result, mining::ShareResult::InvalidJobId);
+}
+
+/**
+ * @brief Test: the validator pool gives the same verdicts as validate()
+ */
+TEST_F(JobManagerTest, WorkerPoolValidatesSubmittedShares) {
+    // Regtest target: почти каждый хеш - блок
+    tmpl_.header.bits = 0x207fffff;
+    tmpl_.target = bitcoin::bits_to_target(tmpl_.header.bits);
+    manager_->on_new_block(tmpl_);
+    auto extranonce = manager_->register_connection(1);
+    auto job = manager_->get_next_job_for_connection(1);
+    ASSERT_TRUE(job.has_value());
+    
+    mining::ShareValidator validator(*manager_);
+    std::atomic<uint64_t> blocks{0};
+    std::atomic<uint64_t> wrong_hash{0};
+    validator.set_valid_block_callback([&](const mining::ValidationResult& result, const bitcoin::BlockHeader&) {
+        auto header = tmpl_.header_for_extranonce(extranonce);
+        header.nonce = result.nonce;
+        if (result.hash != header.hash()) {
+            wrong_hash.fetch_add(1, std::memory_order_relaxed);
+        }
+        blocks.fetch_add(1, std::memory_order_relaxed);
+    });
+    validator.start_workers(2);
+    
+    // Shares с разными nonce из нескольких потоков приёма, плюс повторы
+    constexpr uint32_t PER_THREAD = 500;
+    std::vector<std::thread> producers;
+    for (uint32_t t = 0; t < 3; ++t) {
+        producers.emplace_back([&, t] {
+            std::vector<mining::Share> batch;
+            for (uint32_t i = 0; i < PER_THREAD; ++i) {
+                batch.push_back(mining::Share{job->job_id, t * PER_THREAD + i});
+                if (batch.size() == 10) {
+                    validator.submit_batch(batch);
+                    batch.clear();
+                }
+            }
+            validator.submit(mining::Share{job->job_id, t * PER_THREAD});
+        });
+    }
+    for (auto& p : producers) {
+        p.join();
+    }
+    validator.stop_workers();
+    
+    EXPECT_EQ(validator.pending_shares(), 0u);
+    EXPECT_EQ(validator.total_shares(), 3u * PER_THREAD + 3u);
+    EXPECT_EQ(validator.duplicate_shares(), 3u);
+    EXPECT_EQ(wrong_hash.load(), 0u);
+    EXPECT_EQ(blocks.load(), validator.blocks_found());
+    EXPECT_GT(blocks.load(), 0u);
+    
+    // После остановки пула submit() проверяет синхронно
+    validator.submit(mining::Share{job->job_id, 0xFFFFFFFF});
+    EXPECT_EQ(validator.total_shares(), 3u * PER_THREAD + 4u);
+}
+
+/**
+ * @brief Test: duplicate detection follows the job ring and never grows
+ */
+TEST_F(JobManagerTest, DuplicateFilterFollowsJobRing) {
+    manager_->on_new_block(tmpl_);
+    (void)manager_->register_connection(1);
+    auto job = manager_->get_next_job_for_connection(1);
+    ASSERT_TRUE(job.has_value());
+    
+    mining::ShareValidator validator(*manager_);
+    validator.set_duplicate_filter_size(4);
+    
+    for (uint32_t nonce = 0; nonce < 4; ++nonce) {
+        EXPECT_NE(validator.validate(mining::Share{job->job_id, nonce}).result,
+                  mining::ShareResult::DuplicateShare);
+    }
+    EXPECT_EQ(validator.validate(mining::Share{job->job_id, 3}).result,
+              mining::ShareResult::DuplicateShare);
+    
+    // Фильтр задания заполнен: новые shares принимаются, но не запоминаются
+    EXPECT_NE(validator.validate(mining::Share{job->job_id, 100}).result,
+              mining::ShareResult::DuplicateShare);
+    EXPECT_NE(validator.validate(mining::Share{job->job_id, 100}).result,
+              mining::ShareResult::DuplicateShare);
+    EXPECT_EQ(validator.unfiltered_shares(), 2u);
+    
+    // Задание, занявшее тот же слот кольца, начинает с пустого фильтра
+    std::optional<mining::Job> reused;
+    for (std::size_t i = 0; i < QUEUE_SIZE; ++i) {
+        reused = manager_->get_next_job_for_connection(1);
+    }
+    ASSERT_TRUE(reused.has_value());
+    EXPECT_EQ(reused->job_id % QUEUE_SIZE, job->job_id % QUEUE_SIZE);
+    EXPECT_FALSE(manager_->get_job(job->job_id).has_value());
+    EXPECT_NE(validator.validate(mining::Share{reused->job_id, 3}).result,
+              mining::ShareResult::DuplicateShare);
+    EXPECT_EQ(validator.duplicate_shares(), 1u);
+}
+
+/**
+ * @brief Test: DuplicateFilter is exact and keys cover nonce, lease offset and slot
+ */
+TEST(DuplicateFilterTest, ExactAndBounded) {
+    mining::DuplicateFilter filter(1000);
+    filter.reset(7);
+    EXPECT_EQ(filter.job_id(), 7u);
+    
+    for (uint32_t nonce = 0; nonce < 1000; ++nonce) {
+        EXPECT_FALSE(filter.test_and_insert(mining::duplicate_key(mining::Share{7, nonce})));
+    }
+    for (uint32_t nonce = 0; nonce < 1000; ++nonce) {
+        EXPECT_TRUE(filter.test_and_insert(mining::duplicate_key(mining::Share{7, nonce})));
+    }
+    EXPECT_EQ(filter.size(), 1000u);
+    
+    EXPECT_NE(mining::duplicate_key(mining::Share{7, 1, 1}), mining::duplicate_key(mining::Share{7, 1}));
+    EXPECT_NE(mining::duplicate_key(mining::Share{7, 1, 0, 1}), mining::duplicate_key(mining::Share{7, 1}));
+    
+    EXPECT_FALSE(filter.test_and_insert(mining::duplicate_key(mining::Share{7, 5000})));
+    EXPECT_EQ(filter.overflows(), 1u);
+    
+    filter.reset(8);
+    EXPECT_EQ(filter.size(), 0u);
+    EXPECT_FALSE(filter.test_and_insert(mining::duplicate_key(mining::Share{8, 0})));
+}
+
+/**
+ * @brief Test: a found block is built from the skeleton with the share's work
+ */
+TEST_F(JobManagerTest, BuildFoundBlockMatchesValidatedHash) {
+    MiningConfig config;
+    config.version_slots = 2;
+    config.extranonce_lease = 4;
+    Hash160 pubkey_hash{};
+    pubkey_hash.fill(0x11);
+    mining::JobManager manager(config, bitcoin::CoinbaseBuilder(pubkey_hash));
+    
+    manager.on_new_block(tmpl_);
+    (void)manager.register_connection(1);
+    auto job = manager.get_next_job_for_connection(1);
+    ASSERT_TRUE(job.has_value());
+    
+    // Share из слота версии и share с extranonce из аренды
+    mining::ShareValidator validator(manager);
+    mining::ValidationResult result;
+    for (const auto& share : {mining::Share{job->job_id, 0xCAFEBABE, 1, 0},
+                              mining::Share{job->job_id, 0xCAFEBABE, 0, 3}}) {
+        result = validator.validate(share);
+        auto block = manager.build_found_block(result.job_id, result.extranonce, result.version, result.nonce);
+        ASSERT_TRUE(block.has_value());
+        ASSERT_GT(block->size(), constants::BLOCK_HEADER_SIZE);
+        EXPECT_EQ(crypto::sha256d(ByteSpan(block->data(), constants::BLOCK_HEADER_SIZE)), result.hash);
+    }
+    
+    // Задание прежнего блока больше не собирается
+    EXPECT_FALSE(manager.build_found_block(job->job_id + 1000, result.extranonce, 0, 0).has_value());
+    auto next = tmpl_;
+    next.height = tmpl_.height + 1;
+    manager.on_new_block(next);
+    EXPECT_FALSE(manager.build_found_block(job->job_id, result.extranonce, 0, 0).has_value());
+}
+
+/**
+ * @brief Test: shares for versions rolled by the ASIC validate against the job header
+ */
+TEST_F(JobManagerTest, LocalVersionRollingShares) {
+    MiningConfig config;
+    config.job_queue_size = QUEUE_SIZE;
+    config.local_version_rolling = true;
+    Hash160 pubkey_hash{};
+    pubkey_hash.fill(0x11);
+    mining::JobManager manager(config, bitcoin::CoinbaseBuilder(pubkey_hash));
+    
+    manager.on_new_block(tmpl_);
+    auto extranonce = manager.register_connection(1);
+    auto job = manager.get_next_job_for_connection(1);
+    ASSERT_TRUE(job.has_value());
+    ASSERT_EQ(job->version_mask, mining::VERSION_ROLLING_MASK_DEFAULT);
+    
+    auto header = tmpl_.header_for_extranonce(extranonce);
+    EXPECT_EQ(job->merkle_root, header.merkle_root);
+    EXPECT_EQ(job->version, header.version);
+    
+    // Версия с другими rolling битами - свой midstate, свой хеш
+    header.version = header.version ^ (0x1234u << 13);
+    header.timestamp = job->timestamp;
+    header.nonce = 0xCAFEBABE;
+    
+    mining::ShareValidator validator(manager);
+    auto result = validator.validate(mining::Share{job->job_id, header.nonce, 0, 0, header.version});
+    EXPECT_EQ(result.hash, header.hash());
+    EXPECT_EQ(result.version, header.version);
+    
+    auto block = manager.build_found_block(result.job_id, result.extranonce, result.version, result.nonce);
+    ASSERT_TRUE(block.has_value());
+    EXPECT_EQ(crypto::sha256d(ByteSpan(block->data(), constants::BLOCK_HEADER_SIZE)), result.hash);
+    
+    // Та же версия - дубликат, разные версии одного nonce - нет
+    EXPECT_EQ(validator.validate(mining::Share{job->job_id, header.nonce, 0, 0, header.version}).result,
+              mining::ShareResult::DuplicateShare);
+    EXPECT_NE(validator.validate(mining::Share{job->job_id, header.nonce, 0, 0, header.version ^ (1u << 13)}).result,
+              mining::ShareResult::DuplicateShare);
+    
+    // Версия вне маски ASIC получить не мог
+    EXPECT_EQ(validator.validate(mining::Share{job->job_id, 1, 0, 0, header.version ^ 1u}).result,
+              mining::ShareResult::InvalidJobId);
+}
+
+/**
+ * @brief Test: each connection rolls its own slice of the BIP320 mask
+ */
+TEST_F(JobManagerTest, LocalVersionRollingPartitions) {
+    MiningConfig config;
+    config.job_queue_size = QUEUE_SIZE;
+    config.local_version_rolling = true;
+    config.version_partition_bits = 4;
+    Hash160 pubkey_hash{};
+    pubkey_hash.fill(0x11);
+    mining::JobManager manager(config, bitcoin::CoinbaseBuilder(pubkey_hash));
+    
+    manager.on_new_block(tmpl_);
+    const auto first = manager.register_connection(1);
+    const auto second = manager.register_connection(2);
+    auto job1 = manager.get_next_job_for_connection(1);
+    auto job2 = manager.get_next_job_for_connection(2);
+    ASSERT_TRUE(job1.has_value());
+    ASSERT_TRUE(job2.has_value());
+    
+    const auto partition1 = mining::partition_version_space(mining::VERSION_ROLLING_MASK_DEFAULT, first, 4);
+    const auto partition2 = mining::partition_version_space(mining::VERSION_ROLLING_MASK_DEFAULT, second, 4);
+    EXPECT_EQ(job1->version_mask, partition1.mask);
+    EXPECT_EQ(job1->version, partition1.apply(tmpl_.header.version));
+    EXPECT_NE(job1->version & partition1.fixed_mask, job2->version & partition2.fixed_mask);
+    
+    // Midstate задания - для версии доли
+    auto header = tmpl_.header_for_extranonce(first);
+    header.version = job1->version;
+    EXPECT_EQ(job1->midstate, header.compute_midstate());
+    
+    // Версия внутри доли проверяется, чужая доля - нет
+    header.version ^= 0x5u << 13;
+    header.timestamp = job1->timestamp;
+    header.nonce = 0x1234;
+    mining::ShareValidator validator(manager);
+    auto result = validator.validate(mining::Share{job1->job_id, header.nonce, 0, 0, header.version});
+    EXPECT_EQ(result.hash, header.hash());
+    EXPECT_EQ(validator.validate(mining::Share{job1->job_id, 1, 0, 0, job2->version}).result,
+              mining::ShareResult::InvalidJobId);
+}
+
+/**
+ * @brief Test: queued jobs roll ntime on the connection's extranonce
+ */
+TEST_F(JobManagerTest, QueuedJobsRollTimestamp) {
+    MiningConfig config;
+    config.job_queue_size = QUEUE_SIZE;
+    config.job_prefetch = 3;
+    Hash160 pubkey_hash{};
+    pubkey_hash.fill(0x11);
+    mining::JobManager manager(config, bitcoin::CoinbaseBuilder(pubkey_hash));
+    
+    std::vector<mining::Job> queued(5);
+    EXPECT_EQ(manager.get_queued_jobs_for_connection(1, queued), 0u);
+    
+    manager.on_new_block(tmpl_);
+    auto extranonce = manager.register_connection(1);
+    auto job = manager.get_next_job_for_connection(1);
+    ASSERT_TRUE(job.has_value());
+    EXPECT_EQ(manager.get_queued_jobs_for_connection(2, queued), 0u);
+    
+    // Очередь ограничена job_prefetch, а не размером буфера
+    ASSERT_EQ(manager.get_queued_jobs_for_connection(1, queued), 3u);
+    
+    mining::ShareValidator validator(manager);
+    for (uint32_t i = 0; i < 3; ++i) {
+        EXPECT_EQ(queued[i].timestamp, tmpl_.header.timestamp + i + 1);
+        EXPECT_EQ(queued[i].midstate, job->midstate);
+        EXPECT_EQ(queued[i].extranonce, extranonce);
+        EXPECT_NE(queued[i].job_id, job->job_id);
+        ASSERT_TRUE(manager.get_job(queued[i].job_id).has_value());
+        
+        // Share проверяется по timestamp своего задания
+        auto header = tmpl_.header_for_extranonce(extranonce);
+        header.timestamp = queued[i].timestamp;
+        header.nonce = 0x1234 + i;
+        auto result = validator.validate(mining::Share{queued[i].job_id, header.nonce});
+        EXPECT_EQ(result.job_id, queued[i].job_id);
+        EXPECT_EQ(result.hash, header.hash());
+    }
+    EXPECT_NE(queued[0].job_id, queued[1].job_id);
+}
+
+/**
+ * @brief Test: CMD_UPDATE_TIME keeps the job and accepts shares for both timestamps
+ */
+TEST_F(JobManagerTest, UpdateJobTimeKeepsJobAndPreviousShares) {
+    manager_->on_new_block(tmpl_);
+    auto extranonce = manager_->register_connection(1);
+    auto job = manager_->get_next_job_for_connection(1);
+    ASSERT_TRUE(job.has_value());
+    
+    EXPECT_FALSE(manager_->update_job_time(job->job_id + 1000, job->timestamp + 1).has_value());
+    EXPECT_FALSE(manager_->update_job_time(job->job_id, job->timestamp).has_value());
+    
+    auto updated = manager_->update_job_time(job->job_id, job->timestamp + 5, 0x40000000u);
+    ASSERT_TRUE(updated.has_value());
+    EXPECT_EQ(updated->job_id, job->job_id);
+    EXPECT_EQ(updated->midstate, job->midstate);
+    EXPECT_EQ(updated->timestamp, job->timestamp + 5);
+    EXPECT_EQ(updated->previous_timestamp, job->timestamp);
+    EXPECT_EQ(updated->nonce, 0x40000000u);
+    EXPECT_EQ(manager_->get_job(job->job_id)->timestamp, job->timestamp + 5);
+    
+    // Любой хеш проходит порог shares: проверяется только выбранный timestamp
+    mining::ShareValidator validator(*manager_);
+    validator.set_partial_difficulty(1e-12);
+    auto header = tmpl_.header_for_extranonce(extranonce);
+    header.timestamp = updated->timestamp;
+    header.nonce = 0x40000001;
+    auto result = validator.validate(mining::Share{job->job_id, header.nonce});
+    EXPECT_TRUE(result.is_valid());
+    EXPECT_EQ(result.hash, header.hash());
+    EXPECT_EQ(result.timestamp, updated->timestamp);
+    
+    auto block = manager_->build_found_block(result.job_id, result.extranonce, 0, result.nonce, result.timestamp);
+    ASSERT_TRUE(block.has_value());
+    EXPECT_EQ(crypto::sha256d(ByteSpan(block->data(), constants::BLOCK_HEADER_SIZE)), header.hash());
+    
+    // Share, найденный до команды: порог (~1/256 хешей) проходит только прежний timestamp
+    auto second = manager_->get_next_job_for_connection(1);
+    ASSERT_TRUE(second.has_value());
+    constexpr double difficulty = 1.0 / (1u << 24);
+    validator.set_partial_difficulty(difficulty);
+    const auto share_target = bitcoin::difficulty_to_target(difficulty);
+    
+    auto hash_at = [&](uint32_t timestamp, uint32_t nonce) {
+        header.timestamp = timestamp;
+        header.nonce = nonce;
+        return header.hash();
+    };
+    std::optional<uint32_t> before_update;
+    std::optional<uint32_t> neither;
+    for (uint32_t nonce = 0; nonce < 100000 && !(before_update && neither); ++nonce) {
+        bool old_ok = bitcoin::meets_target(hash_at(second->timestamp, nonce), share_target);
+        bool new_ok = bitcoin::meets_target(hash_at(second->timestamp + 5, nonce), share_target);
+        if (old_ok && !new_ok && !before_update) {
+            before_update = nonce;
+        } else if (!old_ok && !new_ok && !neither) {
+            neither = nonce;
+        }
+    }
+    ASSERT_TRUE(before_update && neither);
+    ASSERT_TRUE(manager_->update_job_time(second->job_id, second->timestamp + 5).has_value());
+    
+    result = validator.validate(mining::Share{second->job_id, *before_update});
+    EXPECT_EQ(result.result, mining::ShareResult::ValidPartial);
+    EXPECT_EQ(result.hash, hash_at(second->timestamp, *before_update));
+    EXPECT_EQ(result.timestamp, second->timestamp);
+    
+    EXPECT_EQ(validator.validate(mining::Share{second->job_id, *neither}).result,
+              mining::ShareResult::TargetNotMet);
+}
+
+/**
+ * @brief Test: CMD_UPDATE_TIME restarts the nonce scan, so a repeated nonce is new work
+ */
+TEST_F(JobManagerTest, UpdateJobTimeResetsDuplicateFilter) {
+    manager_->on_new_block(tmpl_);
+    (void)manager_->register_connection(1);
+    auto job = manager_->get_next_job_for_connection(1);
+    ASSERT_TRUE(job.has_value());
+    
+    mining::ShareValidator validator(*manager_);
+    validator.set_partial_difficulty(1e-12);
+    const mining::Share share{job->job_id, 0x1234};
+    EXPECT_EQ(validator.validate(share).result, mining::ShareResult::ValidPartial);
+    EXPECT_EQ(validator.validate(share).result, mining::ShareResult::DuplicateShare);
+    
+    // Тот же nonce с новым timestamp - другой хеш, а не повтор
+    ASSERT_TRUE(manager_->update_job_time(job->job_id, job->timestamp + 5).has_value());
+    auto result = validator.validate(share);
+    EXPECT_EQ(result.result, mining::ShareResult::ValidPartial);
+    EXPECT_EQ(result.timestamp, job->timestamp + 5);
+    EXPECT_EQ(validator.validate(share).result, mining::ShareResult::DuplicateShare);
+}
+
+/**
+ * @brief Test: roll_job_time catches the clock, then steps by a second up to the future limit
+ */
+TEST_F(JobManagerTest, RollJobTimeFollowsClock) {
+    manager_->on_new_block(tmpl_);
+    (void)manager_->register_connection(1);
+    auto job = manager_->get_next_job_for_connection(1);
+    ASSERT_TRUE(job.has_value());
+    const uint32_t start = job->timestamp;
+    
+    // Часы впереди: timestamp догоняет их
+    auto rolled = manager_->roll_job_time(job->job_id, start + 100);
+    ASSERT_TRUE(rolled.has_value());
+    EXPECT_EQ(rolled->timestamp, start + 100);
+    EXPECT_EQ(rolled->previous_timestamp, start);
+    EXPECT_EQ(manager_->get_job(job->job_id)->timestamp, start + 100);
+    
+    // Часы не ушли: шаг на 1 секунду
+    rolled = manager_->roll_job_time(job->job_id, start + 100);
+    ASSERT_TRUE(rolled.has_value());
+    EXPECT_EQ(rolled->timestamp, start + 101);
+    
+    // Дальше now + MAX_FUTURE_BLOCK_TIME не уходит
+    EXPECT_FALSE(manager_->roll_job_time(job->job_id, start + 101 - constants::MAX_FUTURE_BLOCK_TIME).has_value());
+    EXPECT_EQ(manager_->get_job(job->job_id)->timestamp, start + 101);
+    
+    EXPECT_FALSE(manager_->roll_job_time(job->job_id + 1000, start).has_value());
+}
+
+/**
+ * @brief Test: BlockSubmitter hands the same block to every leg and reports each
+ */
+TEST(BlockSubmitterTest, AllLegsReceiveBlock) {
+    Bytes block(constants::BLOCK_HEADER_SIZE + 1, 0x33);
+    auto hash = crypto::sha256d(ByteSpan(block.data(), constants::BLOCK_HEADER_SIZE));
+    
+    for (bool threaded : {false, true}) {
+        mining::BlockSubmitter submitter;
+        std::atomic<int> fibre{0};
+        std::atomic<int> rpc{0};
+        submitter.add_leg("fibre", [&](ByteSpan data, const Hash256& block_hash) -> Result<void> {
+            EXPECT_EQ(data.size(), block.size());
+            EXPECT_EQ(block_hash, hash);
+            fibre.fetch_add(1);
+            return {};
+        });
+        submitter.add_leg("rpc", [&](ByteSpan, const Hash256&) -> Result<void> {
+            rpc.fetch_add(1);
+            return Err<void>(ErrorCode::MiningBlockRejected, "rejected");
+        });
+        
+        std::mutex mutex;
+        std::vector<mining::SubmitReport> reports;
+        submitter.set_report_callback([&](const mining::SubmitReport& report) {
+            std::lock_guard<std::mutex> lock(mutex);
+            reports.push_back(report);
+        });
+        
+        if (threaded) {
+            submitter.start();
+        }
+        submitter.submit(block);
+        submitter.submit(Bytes(10, 0));  // Короче заголовка - не отправляется
+        submitter.stop();  // Дожидается отправки
+        
+        EXPECT_EQ(submitter.leg_count(), 2u);
+        EXPECT_EQ(submitter.blocks_submitted(), 1u);
+        EXPECT_EQ(fibre.load(), 1);
+        EXPECT_EQ(rpc.load(), 1);
+        ASSERT_EQ(reports.size(), 2u);
+        for (const auto& report : reports) {
+            EXPECT_EQ(report.block_hash, hash);
+            EXPECT_LE(report.started_ms, report.finished_ms);
+            EXPECT_EQ(report.ok, report.leg == "fibre");
+            EXPECT_EQ(report.error.empty(), report.ok);
+        }
+    }
+}
+
+/**
+ * @brief Test: ShareQueue keeps every share under concurrent producers and consumers
+ */
+TEST(ShareQueueTest, ConcurrentPushPop) {
+    mining::ShareQueue queue(64);
+    EXPECT_EQ(queue.capacity(), 64u);
+    
+    constexpr uint32_t PER_PRODUCER = 20000;
+    std::atomic<uint64_t> popped{0};
+    std::atomic<uint64_t> nonce_sum{0};
+    std::atomic<bool> done{false};
+    
+    std::vector<std::thread> threads;
+    for (uint32_t p = 0; p < 2; ++p) {
+        threads.emplace_back([&, p] {
+            for (uint32_t i = 0; i < PER_PRODUCER; ++i) {
+                mining::QueuedShare item{mining::Share{p, i}, 1.0};
+                while (!queue.try_push(item)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (int c = 0; c < 2; ++c) {
+        threads.emplace_back([&] {
+            mining::QueuedShare item;
+            while (!done.load(std::memory_order_relaxed) || queue.size_approx() > 0) {
+                if (queue.try_pop(item)) {
+                    popped.fetch_add(1, std::memory_order_relaxed);
+                    nonce_sum.fetch_add(item.share.nonce, std::memory_order_relaxed);
+                }
+            }
+        });
+    }
+    
+    threads[0].join();
+    threads[1].join();
+    done.store(true);
+    threads[2].join();
+    threads[3].join();
+    
+    uint64_t expected_sum = 2ull * (uint64_t{PER_PRODUCER} * (PER_PRODUCER - 1) / 2);
+    EXPECT_EQ(popped.load(), 2u * PER_PRODUCER);
+    EXPECT_EQ(nonce_sum.load(), expected_sum);
+}
+
+/**
+ * @brief Test: JobTable basic publish/find/clear
+ */
+TEST(JobTableTest, PublishFindClear) {
+    mining::JobTable table(4);
+    
+    mining::Job job;
+    job.job_id = 6;
+    job.height = 123;
+    table.publish(job);
+    
+    ASSERT_TRUE(table.find(6).has_value());
+    EXPECT_EQ(table.find(6)->height, 123u);
+    EXPECT_FALSE(table.find(2).has_value());  // Тот же слот, другой id
+    EXPECT_EQ(table.size(), 1u);
+    
+    table.clear();
+    EXPECT_FALSE(table.find(6).has_value());
+    EXPECT_EQ(table.size(), 0u);
+}
+
+/**
+ * @brief Test: JobTable hot record mirrors the published job
+ */
+TEST(JobTableTest, RecordMatchesPublishedJob) {
+    mining::JobTable table(8);
+    
+    mining::Job job;
+    job.job_id = 9;
+    job.generation = table.generation();
+    job.midstate = {1, 2, 3, 4, 5, 6, 7, 8};
+    job.merkle_tail = {0xAA, 0xBB, 0xCC, 0xDD};
+    job.timestamp = 1700000000;
+    job.previous_timestamp = 1699999990;
+    job.bits = 0x1705ae3a;
+    job.extranonce = 0x1122334455667788ULL;
+    job.created_at = std::chrono::steady_clock::now();
+    table.publish(job);
+    
+    mining::JobRecord record;
+    ASSERT_EQ(table.lookup_record(9, record), mining::JobLookup::Current);
+    EXPECT_EQ(record.job_id, 9u);
+    EXPECT_EQ(record.midstate, job.midstate);
+    EXPECT_EQ(record.merkle_tail, job.merkle_tail);
+    EXPECT_EQ(record.timestamp, job.timestamp);
+    EXPECT_EQ(record.previous_timestamp, job.previous_timestamp);
+    EXPECT_EQ(record.bits, job.bits);
+    EXPECT_EQ(record.extranonce, job.extranonce);
+    EXPECT_FALSE(record.has_versions);
+    EXPECT_FALSE(record.is_stale());
+    
+    // Задание со слотами версий отмечено, полный Job - в холодном столбце
+    job.job_id = 10;
+    job.version_count = 2;
+    job.versions[1] = 0x20002000;
+    table.publish(job);
+    ASSERT_EQ(table.lookup_record(10, record), mining::JobLookup::Current);
+    EXPECT_TRUE(record.has_versions);
+    ASSERT_TRUE(table.find(10).has_value());
+    EXPECT_EQ(table.find(10)->versions[1], 0x20002000u);
+    
+    EXPECT_EQ(table.lookup_record(2, record), mining::JobLookup::Stale);   // Вытеснено 10
+    EXPECT_EQ(table.lookup_record(11, record), mining::JobLookup::Unknown);
+    table.advance_generation();
+    EXPECT_EQ(table.lookup_record(9, record), mining::JobLookup::Stale);
+}
+
+/**
+ * @brief Test: readers never observe a torn job while the writer overwrites slots
+ */
+TEST(JobTableTest, ConcurrentReadersSeeConsistentJobs) {
+    mining::JobTable table(16);
+    std::atomic<bool> stop{false};
+    std::atomic<uint32_t> latest{0};
+    std::atomic<uint64_t> torn{0};
+    
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 3; ++r) {
+        readers.emplace_back([&] {
+            while (!stop.load(std::memory_order_relaxed)) {
+                uint32_t id = latest.load(std::memory_order_relaxed);
+                for (uint32_t k = 0; k < 16 && id > k; ++k) {
+                    if (auto job = table.find(id - k)) {
+                        if (job->height != job->job_id || job->extranonce != uint64_t{job->job_id} * 3 ||
+                            job->timestamp != ~job->job_id) {
+                            torn.fetch_add(1, std::memory_order_relaxed);
+                        }
+                    }
+                    mining::JobRecord record;
+                    if (table.lookup_record(id - k, record) == mining::JobLookup::Current &&
+                        (record.extranonce != uint64_t{record.job_id} * 3 ||
+                         record.timestamp != ~record.job_id || record.bits != record.job_id)) {
+                        torn.fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+            }
+        });
+    }
+    
+    for (uint32_t id = 1; id <= 200000; ++id) {
+        mining::Job job;
+        job.job_id = id;
+        job.height = id;
+        job.extranonce = uint64_t{id} * 3;
+        job.timestamp = ~id;
+        job.bits = id;
+        job.target.fill(static_cast<uint8_t>(id));
+        table.publish(job);
+        latest.store(id, std::memory_order_relaxed);
+    }
+    
+    stop.store(true);
+    for (auto& t : readers) {
+        t.join();
+    }
+    
+    EXPECT_EQ(torn.load(), 0u);
+}
+
+} // namespace quaxis::tests
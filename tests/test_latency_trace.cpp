@@ -0,0 +1,174 @@
+/**
+ * @file test_latency_trace.cpp
+ * @brief Тесты для трассировки латентности блок -> задания
+ */
+
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/latency_trace.hpp"
+
+namespace quaxis::tests {
+
+namespace {
+
+/**
+ * @brief Трассировка включена на время теста, статистика чистая
+ */
+class LatencyTraceTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        core::set_tracing_enabled(true);
+        core::collect_trace();  // события предыдущих тестов
+        core::reset_trace_stats();
+    }
+
+    void TearDown() override {
+        core::set_tracing_enabled(false);
+        core::close_trace_dump();
+    }
+};
+
+const core::TraceStageStats* find_stage(const std::vector<core::TraceStageStats>& stats,
+                                        core::TraceStage stage) {
+    auto it = std::find_if(stats.begin(), stats.end(),
+                           [stage](const auto& s) { return s.stage == stage; });
+    return it == stats.end() ? nullptr : &*it;
+}
+
+} // anonymous namespace
+
+// =============================================================================
+// Тесты LatencyHistogram
+// =============================================================================
+
+/**
+ * @brief Тест: перцентили в пределах точности корзины
+ */
+TEST(LatencyHistogramTest, PercentilesWithinBucketPrecision) {
+    core::LatencyHistogram histogram;
+    EXPECT_EQ(histogram.percentile(0.5), 0u);
+
+    for (uint64_t v = 1; v <= 1000; ++v) {
+        histogram.record(v * 1000);  // 1..1000 мкс
+    }
+    EXPECT_EQ(histogram.count(), 1000u);
+    EXPECT_EQ(histogram.max(), 1'000'000u);
+
+    auto p50 = static_cast<double>(histogram.percentile(0.50));
+    auto p99 = static_cast<double>(histogram.percentile(0.99));
+    EXPECT_GE(p50, 500'000.0);
+    EXPECT_LE(p50, 500'000.0 * 1.125);
+    EXPECT_GE(p99, 990'000.0);
+    EXPECT_LE(p99, 1'000'000.0);
+    EXPECT_EQ(histogram.percentile(1.0), 1'000'000u);
+
+    histogram.reset();
+    EXPECT_EQ(histogram.count(), 0u);
+}
+
+// =============================================================================
+// Тесты трассировки
+// =============================================================================
+
+/**
+ * @brief Тест: этапы из разных потоков считаются от прихода блока
+ */
+TEST_F(LatencyTraceTest, StagesMeasuredFromArrival) {
+    Hash256 block{};
+    block.fill(0x5A);
+    core::trace_block_arrival(core::TraceStage::ShmBlock, block);
+
+    std::thread worker([] {
+        core::trace_point(core::TraceStage::JobCreated);
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        core::trace_point(core::TraceStage::BroadcastDone);
+    });
+    worker.join();
+
+    // Тот же блок из второго источника - та же эпоха
+    core::trace_block_arrival(core::TraceStage::RelayBlock, block);
+
+    EXPECT_EQ(core::collect_trace(), 4u);
+    auto stats = core::trace_stage_stats();
+
+    const auto* done = find_stage(stats, core::TraceStage::BroadcastDone);
+    ASSERT_NE(done, nullptr);
+    EXPECT_EQ(done->count, 1u);
+    EXPECT_GE(done->max_us, 1500.0);
+
+    const auto* relay = find_stage(stats, core::TraceStage::RelayBlock);
+    ASSERT_NE(relay, nullptr);
+    EXPECT_GE(relay->max_us, done->max_us);
+
+    EXPECT_NE(find_stage(stats, core::TraceStage::JobCreated), nullptr);
+    EXPECT_EQ(find_stage(stats, core::TraceStage::TemplateGenerated), nullptr);
+}
+
+/**
+ * @brief Тест: переполненное кольцо считает потери
+ */
+TEST_F(LatencyTraceTest, OverflowIsCounted) {
+    Hash256 block{};
+    block.fill(0x11);
+    core::trace_block_arrival(core::TraceStage::ShmBlock, block);
+    for (std::size_t i = 0; i < core::TRACE_RING_SIZE + 10; ++i) {
+        core::trace_point(core::TraceStage::BroadcastBegin);
+    }
+
+    EXPECT_EQ(core::collect_trace(), core::TRACE_RING_SIZE);
+    EXPECT_EQ(core::trace_lost_events(), 11u);
+}
+
+/**
+ * @brief Тест: выключенная трассировка не пишет событий
+ */
+TEST_F(LatencyTraceTest, DisabledRecordsNothing) {
+    core::set_tracing_enabled(false);
+    core::trace_point(core::TraceStage::JobCreated);
+    EXPECT_EQ(core::collect_trace(), 0u);
+}
+
+/**
+ * @brief Тест: дамп - заголовок и сырые события
+ */
+TEST_F(LatencyTraceTest, DumpContainsEvents) {
+    auto path = std::filesystem::temp_directory_path() / ("quaxis_trace_" + std::to_string(getpid()));
+    ASSERT_TRUE(core::open_trace_dump(path.string()).has_value());
+
+    Hash256 block{};
+    block.fill(0x77);
+    core::trace_block_arrival(core::TraceStage::ShmBlock, block);
+    core::trace_point(core::TraceStage::JobCreated);
+    EXPECT_EQ(core::collect_trace(), 2u);
+    core::close_trace_dump();
+
+    std::ifstream file(path, std::ios::binary);
+    core::TraceDumpHeader header{};
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    EXPECT_EQ(header.magic, core::TRACE_DUMP_MAGIC);
+    EXPECT_EQ(header.version, core::TRACE_DUMP_VERSION);
+    EXPECT_GT(header.ticks_per_us, 0.0);
+
+    core::TraceEvent events[2]{};
+    file.read(reinterpret_cast<char*>(events), sizeof(events));
+    ASSERT_TRUE(file.good());
+    EXPECT_EQ(events[0].stage, static_cast<uint8_t>(core::TraceStage::ShmBlock));
+    EXPECT_EQ(events[1].stage, static_cast<uint8_t>(core::TraceStage::JobCreated));
+    EXPECT_EQ(events[0].epoch, events[1].epoch);
+    EXPECT_LE(events[0].timestamp, events[1].timestamp);
+
+    file.close();
+    std::filesystem::remove(path);
+}
+
+} // namespace quaxis::tests
@@ -9,12 +9,119 @@
 #include "merged/chain_manager.hpp"
 #include "merged/merged_job_creator.hpp"
 #include "merged/reward_dispatcher.hpp"
+#include "merged/chains/rsk_chain.hpp"
+#include "merged/chains/hathor_chain.hpp"
+#include "merged/chains/namecoin_chain.hpp"
 #include "bitcoin/coinbase.hpp"
 #include "bitcoin/block.hpp"
+#include "crypto/sha256.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
 
 using namespace quaxis;
 using namespace quaxis::merged;
 
+namespace {
+
+/**
+ * @brief Chain без RPC: первые failures отправок - сбой связи
+ */
+class FlakyChain final : public IChain {
+public:
+    explicit FlakyChain(int failures) : failures_(failures) {}
+    
+    [[nodiscard]] std::string_view name() const noexcept override { return "flaky"; }
+    [[nodiscard]] std::string_view ticker() const noexcept override { return "FLK"; }
+    [[nodiscard]] const Hash256& chain_id() const noexcept override { return chain_id_; }
+    [[nodiscard]] uint32_t priority() const noexcept override { return 100; }
+    
+    [[nodiscard]] ChainInfo get_info() const noexcept override {
+        ChainInfo info;
+        info.name = "flaky";
+        info.status = status();
+        return info;
+    }
+    
+    [[nodiscard]] ChainStatus status() const noexcept override {
+        return connected_ ? ChainStatus::Ready : ChainStatus::Disconnected;
+    }
+    
+    [[nodiscard]] Result<void> connect() override {
+        connected_ = true;
+        return {};
+    }
+    
+    void disconnect() override { connected_ = false; }
+    [[nodiscard]] bool is_connected() const noexcept override { return connected_; }
+    
+    [[nodiscard]] Result<AuxBlockTemplate> get_block_template() override {
+        AuxBlockTemplate tmpl;
+        tmpl.chain_id = chain_id_;
+        tmpl.target_bits = 0x207fffff;
+        tmpl.height = 2000;
+        tmpl.block_hash.fill(0xCD);
+        return tmpl;
+    }
+    
+    [[nodiscard]] Result<void> submit_block(
+        [[maybe_unused]] const AuxPow& auxpow,
+        [[maybe_unused]] const AuxBlockTemplate& block_template
+    ) override {
+        if (submits_.fetch_add(1) < failures_) {
+            return std::unexpected(Error{ErrorCode::RpcConnectionFailed, "connection refused"});
+        }
+        return {};
+    }
+    
+    [[nodiscard]] bool meets_target(
+        const Hash256& pow_hash,
+        const AuxBlockTemplate& current_template
+    ) const noexcept override {
+        return quaxis::merged::meets_target(pow_hash, current_template.target_bits);
+    }
+    
+    void set_enabled(bool enabled) override { enabled_ = enabled; }
+    [[nodiscard]] bool is_enabled() const noexcept override { return enabled_; }
+    void set_priority([[maybe_unused]] uint32_t priority) override {}
+    
+    [[nodiscard]] int submits() const noexcept { return submits_.load(); }
+
+private:
+    Hash256 chain_id_{0x0F, 0x0E, 0x0D};
+    int failures_;
+    std::atomic<int> submits_{0};
+    std::atomic<bool> connected_{false};
+    std::atomic<bool> enabled_{true};
+};
+
+/**
+ * @brief Заголовок, хеш которого проходит target 0x207fffff
+ */
+bitcoin::BlockHeader find_header(uint32_t start_nonce) {
+    bitcoin::BlockHeader header;
+    header.version = 0x20000000;
+    header.timestamp = 1700000000;
+    header.bits = 0x207fffff;
+    for (header.nonce = start_nonce;; ++header.nonce) {
+        if (meets_target(crypto::sha256d(header.serialize()), header.bits)) {
+            return header;
+        }
+    }
+}
+
+template<typename Predicate>
+bool wait_for(Predicate predicate) {
+    for (int i = 0; i < 5000 && !predicate(); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return predicate();
+}
+
+} // anonymous namespace
+
 // =============================================================================
 // Integration Test Fixtures
 // =============================================================================
@@ -135,6 +242,96 @@ TEST_F(MergedMiningIntegrationTest, DispatcherCallback) {
     EXPECT_FALSE(callback_called);
 }
 
+TEST_F(MergedMiningIntegrationTest, AsyncDispatchRetriesConnectionFailures) {
+    std::vector<std::unique_ptr<IChain>> chains;
+    auto flaky = std::make_unique<FlakyChain>(2);
+    auto* chain = flaky.get();
+    chains.push_back(std::move(flaky));
+    ChainManager chain_manager(MergedMiningConfig{}, std::move(chains));
+    chain_manager.start();
+    ASSERT_TRUE(wait_for([&] { return chain_manager.get_aux_commitment().has_value(); }));
+    
+    RewardDispatcher dispatcher(chain_manager);
+    std::mutex results_mutex;
+    std::vector<DispatchResult> results;
+    dispatcher.set_dispatch_callback([&](const DispatchResult& result) {
+        std::lock_guard<std::mutex> lock(results_mutex);
+        results.push_back(result);
+    });
+    
+    DispatchQueueConfig queue_config;
+    queue_config.initial_backoff = std::chrono::milliseconds(2);
+    queue_config.max_backoff = std::chrono::milliseconds(10);
+    dispatcher.start(queue_config);
+    
+    MergedJob job;
+    job.job_id = 1;
+    const Bytes coinbase_tx(100, 0x11);
+    const auto header = find_header(0);
+    
+    // Отправка - в полосе chain, повтор находки отбрасывается сразу
+    EXPECT_EQ(dispatcher.dispatch_async(header, coinbase_tx, header.nonce, job), 1u);
+    EXPECT_EQ(dispatcher.dispatch_async(header, coinbase_tx, header.nonce, job), 0u);
+    ASSERT_TRUE(wait_for([&] { return dispatcher.queue_stats().accepted == 1; }));
+    EXPECT_EQ(chain->submits(), 3);
+    
+    // Вторая находка в уже принятый шаблон ноде не отправляется
+    const auto second = find_header(header.nonce + 1);
+    EXPECT_EQ(dispatcher.dispatch_async(second, coinbase_tx, second.nonce, job), 1u);
+    ASSERT_TRUE(wait_for([&] { return dispatcher.queue_stats().duplicates == 2; }));
+    dispatcher.stop();
+    
+    const auto stats = dispatcher.queue_stats();
+    EXPECT_EQ(stats.queued, 2u);
+    EXPECT_EQ(stats.retries, 2u);
+    EXPECT_EQ(stats.failed, 0u);
+    EXPECT_EQ(chain->submits(), 3);
+    
+    std::lock_guard<std::mutex> lock(results_mutex);
+    ASSERT_EQ(results.size(), 1u);
+    EXPECT_TRUE(results[0].success);
+    EXPECT_EQ(results[0].chain_name, "flaky");
+    EXPECT_EQ(results[0].height, 2000u);
+    EXPECT_EQ(dispatcher.get_dispatch_stats().at("flaky"), 1u);
+    
+    chain_manager.stop();
+}
+
+TEST_F(MergedMiningIntegrationTest, AsyncDispatchDropsStaleFind) {
+    std::vector<std::unique_ptr<IChain>> chains;
+    chains.push_back(std::make_unique<FlakyChain>(1 << 30));
+    ChainManager chain_manager(MergedMiningConfig{}, std::move(chains));
+    chain_manager.start();
+    ASSERT_TRUE(wait_for([&] { return chain_manager.get_aux_commitment().has_value(); }));
+    
+    RewardDispatcher dispatcher(chain_manager);
+    std::atomic<int> failures{0};
+    dispatcher.set_dispatch_callback([&](const DispatchResult& result) {
+        EXPECT_FALSE(result.success);
+        failures.fetch_add(1);
+    });
+    
+    DispatchQueueConfig queue_config;
+    queue_config.initial_backoff = std::chrono::milliseconds(2);
+    queue_config.max_backoff = std::chrono::milliseconds(2);
+    dispatcher.start(queue_config);
+    
+    MergedJob job;
+    job.job_id = 1;
+    const auto header = find_header(0);
+    ASSERT_EQ(dispatcher.dispatch_async(header, Bytes(100, 0x22), header.nonce, job), 1u);
+    ASSERT_TRUE(wait_for([&] { return dispatcher.queue_stats().retries >= 2; }));
+    
+    // Chain выключена - находка устарела, повторы прекращаются
+    ASSERT_TRUE(chain_manager.set_chain_enabled("flaky", false));
+    ASSERT_TRUE(wait_for([&] { return dispatcher.queue_stats().stale == 1; }));
+    EXPECT_EQ(failures.load(), 1);
+    EXPECT_EQ(dispatcher.queue_stats().failed, 0u);
+    
+    dispatcher.stop();
+    chain_manager.stop();
+}
+
 // =============================================================================
 // End-to-End Flow Tests
 // =============================================================================
@@ -269,6 +466,124 @@ TEST_F(MergedMiningIntegrationTest, AuxPowVerification) {
     [[maybe_unused]] bool result = auxpow.verify(test_aux_hash);
 }
 
+// =============================================================================
+// Commitments chains вне aux дерева
+// =============================================================================
+
+TEST_F(MergedMiningIntegrationTest, RskAndHathorCommitmentScripts) {
+    AuxBlockTemplate tmpl;
+    for (std::size_t i = 0; i < tmpl.block_hash.size(); ++i) {
+        tmpl.block_hash[i] = static_cast<uint8_t>(i);
+    }
+    
+    ChainConfig rsk_config;
+    rsk_config.name = "rsk";
+    auto rsk = RSKChain(rsk_config).coinbase_commitment(tmpl);
+    ASSERT_TRUE(rsk.has_value());
+    ASSERT_EQ(rsk->script.size(), 2u + 9u + 32u);
+    EXPECT_EQ(rsk->script[0], 0x6a);
+    EXPECT_EQ(rsk->script[1], 41);
+    EXPECT_EQ(std::string(rsk->script.begin() + 2, rsk->script.begin() + 11), "RSKBLOCK:");
+    // Хеш - в порядке RPC ответа (обратном внутреннему)
+    EXPECT_EQ(rsk->script[11], 31);
+    EXPECT_EQ(rsk->script.back(), 0);
+    
+    ChainConfig hathor_config;
+    hathor_config.name = "hathor";
+    auto hathor = HathorChain(hathor_config).coinbase_commitment(tmpl);
+    ASSERT_TRUE(hathor.has_value());
+    ASSERT_EQ(hathor->script.size(), 2u + 4u + 32u);
+    EXPECT_EQ(std::string(hathor->script.begin() + 2, hathor->script.begin() + 6), "Hath");
+    
+    // Namecoin-style chains остаются в aux дереве
+    ChainConfig namecoin_config;
+    namecoin_config.name = "namecoin";
+    EXPECT_FALSE(NamecoinChain(namecoin_config).coinbase_commitment(tmpl).has_value());
+}
+
+TEST_F(MergedMiningIntegrationTest, CommitmentsKeepCoinbaseMidstate) {
+    bitcoin::CoinbaseBuilder coinbase_builder(test_pubkey_hash, "quaxis");
+    const Bytes base = coinbase_builder.build(850000, 625000000, 7);
+    
+    AuxCommitment aux;
+    aux.aux_merkle_root[0] = 0xAB;
+    CoinbaseCommitment first{Bytes{0x6a, 0x02, 0x01, 0x02}};
+    CoinbaseCommitment second{Bytes{0x6a, 0x02, 0x03, 0x04}};
+    
+    const std::vector<CoinbaseCommitment> outputs{first};
+    Bytes coinbase = MergedJobCreator::insert_commitments(base, aux, outputs);
+    ASSERT_EQ(coinbase.size(), base.size() + 44 + 8 + 1 + first.script.size());
+    EXPECT_TRUE(AuxCommitment::find_in_coinbase(coinbase).has_value());
+    
+    // Второй выход: output_count (после scriptsig с commitment), locktime в конце
+    EXPECT_EQ(coinbase[74 + 44], 2);
+    EXPECT_TRUE(std::equal(base.end() - 4, base.end(), coinbase.end() - 4));
+    EXPECT_TRUE(std::equal(first.script.begin(), first.script.end(),
+                           coinbase.end() - 4 - static_cast<std::ptrdiff_t>(first.script.size())));
+    
+    // Смена тега и aux root не трогает первые 64 байта
+    aux.aux_merkle_root[0] = 0xCD;
+    const std::vector<CoinbaseCommitment> changed{second};
+    Bytes next = MergedJobCreator::insert_commitments(base, aux, changed);
+    ASSERT_EQ(next.size(), coinbase.size());
+    EXPECT_TRUE(std::equal(next.begin(), next.begin() + 64, coinbase.begin()));
+    EXPECT_NE(next, coinbase);
+    
+    // Без commitments coinbase не меняется
+    EXPECT_EQ(MergedJobCreator::insert_commitments(base, std::nullopt, {}), base);
+}
+
+TEST_F(MergedMiningIntegrationTest, AuxCommitmentFollowsExtranonce) {
+    bitcoin::CoinbaseBuilder coinbase_builder(test_pubkey_hash, "quaxis");
+    const Bytes base = coinbase_builder.build(850000, 625000000, 0x0A0B0C0D0E0F);
+    
+    AuxCommitment aux;
+    aux.aux_merkle_root.fill(0x5A);
+    const Bytes coinbase = MergedJobCreator::insert_commitments(base, aux, {});
+    
+    // Первый блок - постоянные поля, extranonce и commitment - с границы 64 байт
+    const bitcoin::CoinbaseLayout layout{44};
+    ASSERT_EQ(coinbase.size(), layout.size());
+    EXPECT_EQ(coinbase[bitcoin::CoinbaseLayout::SCRIPTSIG_LEN_OFFSET], layout.scriptsig_length());
+    EXPECT_TRUE(std::equal(base.begin() + 64, base.begin() + 70, coinbase.begin() + 64));
+    const std::array<uint8_t, 4> magic = {0xfa, 0xbe, 0x6d, 0x6d};
+    EXPECT_TRUE(std::equal(magic.begin(), magic.end(),
+                           coinbase.begin() + bitcoin::CoinbaseLayout::COMMITMENT_OFFSET));
+    auto txid = bitcoin::transaction_txid(coinbase);
+    ASSERT_TRUE(txid);
+    EXPECT_EQ(*txid, bitcoin::compute_txid(coinbase));
+    
+    // Extranonce на месте CoinbaseBuilder не задевает commitment
+    bitcoin::BlockTemplate tmpl;
+    tmpl.coinbase_tx = coinbase;
+    tmpl.update_extranonce(0x112233445566);
+    auto found = AuxCommitment::find_in_coinbase(tmpl.coinbase_tx);
+    ASSERT_TRUE(found.has_value());
+    EXPECT_EQ(found->aux_merkle_root, aux.aux_merkle_root);
+    EXPECT_EQ(tmpl.coinbase_tx, MergedJobCreator::insert_commitments(
+        coinbase_builder.build(850000, 625000000, 0x112233445566), aux, {}));
+    
+    // Смена aux root - те же первые 64 байта, midstate coinbase прежний
+    aux.aux_merkle_root.fill(0xA5);
+    const Bytes next = MergedJobCreator::insert_commitments(base, aux, {});
+    EXPECT_TRUE(std::equal(next.begin(), next.begin() + 64, coinbase.begin()));
+}
+
+TEST_F(MergedMiningIntegrationTest, RefreshCommitmentsWithoutChanges) {
+    ChainManager chain_manager(config);
+    bitcoin::CoinbaseBuilder coinbase_builder(test_pubkey_hash, "quaxis");
+    MergedJobCreator job_creator(chain_manager, coinbase_builder);
+    
+    bitcoin::BlockTemplate btc_template;
+    btc_template.height = 850000;
+    btc_template.coinbase_value = 625000000;
+    MergedJob job = job_creator.create_job(btc_template, 1, 0);
+    const Bytes coinbase = job.coinbase_tx;
+    
+    EXPECT_TRUE(job_creator.refresh_commitments(job));
+    EXPECT_EQ(job.coinbase_tx, coinbase);
+}
+
 // =============================================================================
 // Performance Tests
 // =============================================================================
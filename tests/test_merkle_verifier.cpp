@@ -0,0 +1,144 @@
+/**
+ * @file test_merkle_verifier.cpp
+ * @brief Тесты для параллельной проверки merkle root блока relay
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "bitcoin/block.hpp"
+#include "relay/merkle_verifier.hpp"
+
+namespace quaxis::tests {
+
+namespace {
+
+/**
+ * @brief Транзакция: один вход и один выход; segwit - с одним witness элементом
+ */
+Bytes make_tx(uint32_t seed, bool segwit) {
+    Bytes tx = {0x02, 0x00, 0x00, 0x00};
+    if (segwit) {
+        tx.insert(tx.end(), {0x00, 0x01});
+    }
+    tx.push_back(0x01);
+    for (std::size_t i = 0; i < 32; ++i) {
+        tx.push_back(static_cast<uint8_t>(seed * 13 + i));
+    }
+    tx.insert(tx.end(), 4, static_cast<uint8_t>(seed));
+    tx.push_back(static_cast<uint8_t>(4 + seed % 40));
+    for (std::size_t i = 0; i < 4 + seed % 40; ++i) {
+        tx.push_back(static_cast<uint8_t>(seed >> (i % 3 * 8)));
+    }
+    tx.insert(tx.end(), 4, 0xFF);
+    tx.insert(tx.end(), {0x01, 0x10, 0x27, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x51});
+    if (segwit) {
+        tx.insert(tx.end(), {0x01, 0x20});
+        tx.insert(tx.end(), 32, static_cast<uint8_t>(seed));
+    }
+    tx.insert(tx.end(), 4, 0x00);
+    return tx;
+}
+
+/**
+ * @brief Блок из count транзакций (каждая третья - segwit) с верным merkle root
+ */
+Bytes make_block(std::size_t count) {
+    bitcoin::BlockHeader header;
+    header.version = 0x20000000;
+    header.timestamp = 1700000000;
+    header.bits = 0x207fffff;
+    auto serialized = header.serialize();
+    Bytes block(serialized.begin(), serialized.end());
+
+    if (count < 0xFD) {
+        block.push_back(static_cast<uint8_t>(count));
+    } else {
+        block.insert(block.end(), {0xFD, static_cast<uint8_t>(count), static_cast<uint8_t>(count >> 8)});
+    }
+    for (std::size_t i = 0; i < count; ++i) {
+        const auto tx = make_tx(static_cast<uint32_t>(i + 1), i % 3 == 1);
+        block.insert(block.end(), tx.begin(), tx.end());
+    }
+
+    header.merkle_root = *bitcoin::compute_block_merkle_root(block);
+    serialized = header.serialize();
+    std::copy(serialized.begin(), serialized.end(), block.begin());
+    return block;
+}
+
+} // anonymous namespace
+
+TEST(MerkleVerifierTest, MatchesSerialMerkleRoot) {
+    relay::MerkleVerifier verifier(4);
+    EXPECT_EQ(verifier.threads(), 4u);
+
+    // Малые блоки - в вызывающем потоке, крупные - на пуле
+    for (std::size_t count : {1u, 2u, 3u, 7u, 255u, 256u, 257u, 1000u, 5001u}) {
+        const auto block = make_block(count);
+        auto root = verifier.merkle_root(block);
+        ASSERT_TRUE(root) << count;
+        EXPECT_EQ(*root, *bitcoin::compute_block_merkle_root(block)) << count;
+    }
+}
+
+TEST(MerkleVerifierTest, TransactionTxidStripsWitness) {
+    const auto legacy = make_tx(5, false);
+    const auto segwit = make_tx(5, true);
+    auto legacy_txid = bitcoin::transaction_txid(legacy);
+    auto segwit_txid = bitcoin::transaction_txid(segwit);
+    ASSERT_TRUE(legacy_txid);
+    ASSERT_TRUE(segwit_txid);
+    EXPECT_EQ(*legacy_txid, *segwit_txid);
+
+    auto longer = legacy;
+    longer.push_back(0x00);
+    EXPECT_FALSE(bitcoin::transaction_txid(longer));
+    EXPECT_FALSE(bitcoin::transaction_txid(ByteSpan(legacy).first(legacy.size() - 1)));
+}
+
+TEST(MerkleVerifierTest, MatchesHeaderWithFecPadding) {
+    relay::MerkleVerifier verifier(3);
+    auto block = make_block(600);
+    auto header = bitcoin::BlockHeader::deserialize(block);
+    ASSERT_TRUE(header);
+
+    EXPECT_TRUE(verifier.matches(block, *header));
+
+    // Последний чанк, восстановленный FEC, дополнен нулями
+    auto padded = block;
+    padded.insert(padded.end(), 100, 0x00);
+    EXPECT_TRUE(verifier.matches(padded, *header));
+    EXPECT_FALSE(verifier.merkle_root(padded));
+
+    // Подменённая транзакция - другой merkle root
+    auto tampered = block;
+    tampered[tampered.size() / 2] ^= 0x01;
+    EXPECT_FALSE(verifier.matches(tampered, *header));
+
+    // Чужой заголовок
+    auto other = *header;
+    other.nonce = 1;
+    EXPECT_FALSE(verifier.matches(block, other));
+
+    // Обрезанный блок
+    auto truncated = block;
+    truncated.resize(truncated.size() - 10);
+    EXPECT_FALSE(verifier.matches(truncated, *header));
+}
+
+TEST(MerkleVerifierTest, SingleThreadVerifierHasNoPool) {
+    relay::MerkleVerifier verifier(1);
+    const auto block = make_block(2000);
+    auto root = verifier.merkle_root(block);
+    ASSERT_TRUE(root);
+    EXPECT_EQ(*root, *bitcoin::compute_block_merkle_root(block));
+
+    relay::MerkleVerifier automatic(0);
+    EXPECT_GE(automatic.threads(), 1u);
+}
+
+} // namespace quaxis::tests
@@ -0,0 +1,163 @@
+/**
+ * @file test_metrics.cpp
+ * @brief Тесты для экспорта метрик Prometheus
+ */
+
+#include <gtest/gtest.h>
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <string>
+#include <thread>
+
+#include "core/seqlock.hpp"
+#include "metrics/metrics_server.hpp"
+#include "metrics/openmetrics.hpp"
+
+namespace quaxis::tests {
+
+namespace {
+
+/**
+ * @brief HTTP запрос к локальному порту, ответ целиком
+ */
+std::string http_get(uint16_t port, const std::string& path) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return {};
+    }
+    struct sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+    if (connect(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0) {
+        close(fd);
+        return {};
+    }
+    std::string request = "GET " + path + " HTTP/1.1\r\nHost: localhost\r\n\r\n";
+    send(fd, request.data(), request.size(), MSG_NOSIGNAL);
+
+    std::string response;
+    char buf[4096];
+    ssize_t n = 0;
+    while ((n = recv(fd, buf, sizeof(buf), 0)) > 0) {
+        response.append(buf, static_cast<std::size_t>(n));
+    }
+    close(fd);
+    return response;
+}
+
+struct Pair {
+    uint64_t a;
+    uint64_t b;
+    uint32_t c;
+};
+
+} // anonymous namespace
+
+// =============================================================================
+// MetricsWriter
+// =============================================================================
+
+TEST(MetricsWriterTest, CounterAndGaugeFormat) {
+    metrics::MetricsWriter writer;
+    writer.counter("quaxis_shares_total", "Shares", 42);
+    writer.gauge("quaxis_temp", "Temp", 1.5, {{"remote", "10.0.0.1"}});
+    writer.gauge("quaxis_temp", "Temp", 2, {{"remote", "10.0.0.2"}});
+
+    const std::string& text = writer.text();
+    EXPECT_NE(text.find("# TYPE quaxis_shares_total counter\nquaxis_shares_total 42\n"), std::string::npos);
+    EXPECT_NE(text.find("quaxis_temp{remote=\"10.0.0.1\"} 1.5\n"), std::string::npos);
+    EXPECT_NE(text.find("quaxis_temp{remote=\"10.0.0.2\"} 2\n"), std::string::npos);
+
+    // HELP / TYPE один раз на семейство
+    EXPECT_EQ(text.find("# TYPE quaxis_temp gauge"), text.rfind("# TYPE quaxis_temp gauge"));
+}
+
+TEST(MetricsWriterTest, EscapesLabelValues) {
+    EXPECT_EQ(metrics::escape_label_value("a\"b\\c\nd"), "a\\\"b\\\\c\\nd");
+}
+
+TEST(MetricsWriterTest, HistogramBuckets) {
+    core::LatencyHistogram histogram;
+    histogram.record(5'000);        // 5 мкс
+    histogram.record(300'000);      // 300 мкс
+    histogram.record(2'000'000'000);  // 2 с
+
+    metrics::MetricsWriter writer;
+    writer.histogram("quaxis_test_seconds", "Test", histogram, {{"stage", "x"}});
+    const std::string& text = writer.text();
+
+    EXPECT_NE(text.find("# TYPE quaxis_test_seconds histogram"), std::string::npos);
+    EXPECT_NE(text.find("quaxis_test_seconds_bucket{stage=\"x\",le=\"1e-05\"} 1\n"), std::string::npos);
+    EXPECT_NE(text.find("quaxis_test_seconds_bucket{stage=\"x\",le=\"0.0005\"} 2\n"), std::string::npos);
+    EXPECT_NE(text.find("quaxis_test_seconds_bucket{stage=\"x\",le=\"1\"} 2\n"), std::string::npos);
+    EXPECT_NE(text.find("quaxis_test_seconds_bucket{stage=\"x\",le=\"+Inf\"} 3\n"), std::string::npos);
+    EXPECT_NE(text.find("quaxis_test_seconds_count{stage=\"x\"} 3\n"), std::string::npos);
+
+    const std::string sum_prefix = "quaxis_test_seconds_sum{stage=\"x\"} ";
+    auto sum_pos = text.find(sum_prefix);
+    ASSERT_NE(sum_pos, std::string::npos);
+    EXPECT_NEAR(std::stod(text.substr(sum_pos + sum_prefix.size())), 2.000305, 1e-9);
+}
+
+// =============================================================================
+// MetricsServer
+// =============================================================================
+
+TEST(MetricsServerTest, ServesMetricsOverHttp) {
+    MetricsConfig config;
+    config.port = 0;  // свободный порт
+    metrics::MetricsServer server(config);
+    server.add_source([](metrics::MetricsWriter& writer) {
+        writer.counter("quaxis_test_total", "Test", 7);
+    });
+
+    ASSERT_TRUE(server.start());
+    ASSERT_NE(server.port(), 0);
+
+    std::string response = http_get(server.port(), "/metrics");
+    EXPECT_EQ(response.rfind("HTTP/1.1 200 OK\r\n", 0), 0u);
+    EXPECT_NE(response.find("text/plain; version=0.0.4"), std::string::npos);
+    EXPECT_NE(response.find("\r\n\r\n# HELP quaxis_test_total Test\n"), std::string::npos);
+    EXPECT_NE(response.find("quaxis_test_total 7\n"), std::string::npos);
+
+    response = http_get(server.port(), "/other");
+    EXPECT_EQ(response.rfind("HTTP/1.1 404", 0), 0u);
+
+    server.stop();
+}
+
+// =============================================================================
+// Seqlock
+// =============================================================================
+
+TEST(SeqlockTest, ReadersNeverSeeTornValues) {
+    core::Seqlock<Pair> lock;
+    std::atomic<bool> done{false};
+    std::atomic<bool> torn{false};
+
+    std::thread reader([&] {
+        while (!done.load(std::memory_order_relaxed)) {
+            Pair p = lock.load();
+            if (p.a != p.b || p.c != static_cast<uint32_t>(p.a)) {
+                torn.store(true);
+            }
+        }
+    });
+
+    for (uint64_t i = 1; i <= 200'000; ++i) {
+        lock.store(Pair{i, i, static_cast<uint32_t>(i)});
+    }
+    done.store(true);
+    reader.join();
+
+    EXPECT_FALSE(torn.load());
+    EXPECT_EQ(lock.load().a, 200'000u);
+}
+
+} // namespace quaxis::tests
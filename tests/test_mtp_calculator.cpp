@@ -0,0 +1,144 @@
+/**
+ * @file test_mtp_calculator.cpp
+ * @brief Тесты для инкрементального Median Time Past
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "core/mtp_calculator.hpp"
+#include "core/template_generator.hpp"
+
+namespace quaxis::tests {
+
+namespace {
+
+/// @brief Медиана последних 11 сортировкой копии
+uint32_t reference_mtp(const std::vector<uint32_t>& chain) {
+    if (chain.size() < core::MTP_BLOCK_COUNT) {
+        return 0;
+    }
+    std::vector<uint32_t> window(chain.end() - core::MTP_BLOCK_COUNT, chain.end());
+    std::sort(window.begin(), window.end());
+    return window[core::MTP_BLOCK_COUNT / 2];
+}
+
+} // anonymous namespace
+
+TEST(MtpCalculatorTest, NeedsElevenBlocks) {
+    core::MtpCalculator mtp;
+    for (uint32_t i = 0; i < 10; ++i) {
+        mtp.push_timestamp(1000 + i);
+    }
+    EXPECT_FALSE(mtp.has_sufficient_data());
+    EXPECT_EQ(mtp.get_mtp(), 0u);
+    EXPECT_EQ(mtp.count(), 10u);
+    
+    mtp.push_timestamp(1010);
+    EXPECT_TRUE(mtp.has_sufficient_data());
+    EXPECT_EQ(mtp.get_mtp(), 1005u);
+    EXPECT_EQ(mtp.get_min_timestamp(), 1006u);
+    
+    mtp.reset();
+    EXPECT_EQ(mtp.count(), 0u);
+    EXPECT_FALSE(mtp.has_sufficient_data());
+}
+
+TEST(MtpCalculatorTest, MatchesSortOnRandomChainWithReorgs) {
+    core::MtpCalculator mtp;
+    std::vector<uint32_t> chain;
+    std::size_t stored = 0;
+    std::minstd_rand rng(7);
+    
+    // Timestamps не монотонны (допустимо в Bitcoin), есть повторы
+    for (int step = 0; step < 5000; ++step) {
+        if (rng() % 8 == 0) {
+            const std::size_t depth = 1 + rng() % 6;
+            const std::size_t popped = mtp.pop_headers(depth);
+            ASSERT_EQ(popped, std::min(depth, stored));
+            chain.resize(chain.size() - popped);
+            stored -= popped;
+        } else {
+            uint32_t ts = 1'600'000'000u + static_cast<uint32_t>(step) * 600u + static_cast<uint32_t>(rng() % 7200u);
+            if (rng() % 16 == 0 && !chain.empty()) {
+                ts = chain.back();
+            }
+            mtp.push_timestamp(ts);
+            chain.push_back(ts);
+            stored = std::min(stored + 1, core::MTP_HISTORY);
+        }
+        
+        ASSERT_EQ(mtp.has_sufficient_data(), stored >= core::MTP_BLOCK_COUNT) << "step " << step;
+        if (stored >= core::MTP_BLOCK_COUNT) {
+            ASSERT_EQ(mtp.get_mtp(), reference_mtp(chain)) << "step " << step;
+        }
+    }
+}
+
+TEST(MtpCalculatorTest, PopBeyondHistoryNeedsRefill) {
+    core::MtpCalculator mtp;
+    for (uint32_t i = 0; i < 200; ++i) {
+        mtp.push_timestamp(1000 + i);
+    }
+    EXPECT_EQ(mtp.pop_headers(core::MTP_HISTORY - core::MTP_BLOCK_COUNT), core::MTP_HISTORY - core::MTP_BLOCK_COUNT);
+    EXPECT_TRUE(mtp.has_sufficient_data());
+    EXPECT_EQ(mtp.get_mtp(), 1000u + 200 - core::MTP_HISTORY + core::MTP_BLOCK_COUNT / 2);
+    
+    EXPECT_EQ(mtp.pop_headers(100), core::MTP_BLOCK_COUNT);
+    EXPECT_FALSE(mtp.has_sufficient_data());
+    EXPECT_EQ(mtp.count(), 0u);
+}
+
+TEST(MtpCalculatorTest, ReadersSeeConsistentMedian) {
+    core::MtpCalculator mtp;
+    std::atomic<bool> done{false};
+    std::atomic<bool> bad{false};
+    
+    // Монотонная цепь: медиана = timestamp шестого с конца, растёт
+    std::thread reader([&] {
+        uint32_t last = 0;
+        while (!done.load(std::memory_order_relaxed)) {
+            const uint32_t current = mtp.get_mtp();
+            if (current < last) {
+                bad.store(true);
+            }
+            last = current;
+        }
+    });
+    
+    for (uint32_t i = 1; i <= 200'000; ++i) {
+        mtp.push_timestamp(i);
+    }
+    done.store(true);
+    reader.join();
+    
+    EXPECT_FALSE(bad.load());
+    EXPECT_EQ(mtp.get_mtp(), 200'000u - core::MTP_BLOCK_COUNT / 2);
+}
+
+TEST(MtpCalculatorTest, RollTimestampStaysWithinLimits) {
+    core::TemplateGenerator generator(core::TemplateGeneratorConfig{});
+    constexpr uint32_t now = 1'700'000'000;
+    
+    // Отстающий timestamp догоняет часы, догнавший - идёт вперёд по секунде
+    EXPECT_EQ(generator.roll_timestamp(now - 30, now), now);
+    EXPECT_EQ(generator.roll_timestamp(now, now), now + 1);
+    
+    // Не дальше MAX_FUTURE_BLOCK_TIME от часов
+    EXPECT_EQ(generator.roll_timestamp(now + core::MAX_FUTURE_BLOCK_TIME - 1, now),
+              now + core::MAX_FUTURE_BLOCK_TIME);
+    EXPECT_FALSE(generator.roll_timestamp(now + core::MAX_FUTURE_BLOCK_TIME, now).has_value());
+    
+    // Не раньше MTP + 1, даже если часы узла отстают от цепи
+    for (uint32_t i = 0; i < core::MTP_BLOCK_COUNT; ++i) {
+        generator.get_mtp_calculator().push_timestamp(now + 600 + i);
+    }
+    EXPECT_EQ(generator.roll_timestamp(now - 30, now), now + 600 + core::MTP_BLOCK_COUNT / 2 + 1);
+}
+
+} // namespace quaxis::tests
@@ -0,0 +1,72 @@
+/**
+ * @file test_pmu_profile.cpp
+ * @brief Тесты счётчиков PMU
+ */
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+#include "core/pmu_profile.hpp"
+
+namespace quaxis::tests {
+
+using core::PmuRegion;
+using core::PmuScope;
+
+namespace {
+
+core::PmuRegionStats region_stats(PmuRegion region) {
+    return core::pmu_region_stats()[static_cast<std::size_t>(region)];
+}
+
+/// @brief Работа, которую не выкинет оптимизатор
+uint64_t busy_work(uint64_t n) {
+    volatile uint64_t acc = 0;
+    for (uint64_t i = 0; i < n; ++i) {
+        acc = acc + i * 2654435761u;
+    }
+    return acc;
+}
+
+} // anonymous namespace
+
+TEST(PmuProfileTest, DisabledScopeRecordsNothing) {
+    core::set_pmu_enabled(false);
+    const auto before = region_stats(PmuRegion::FecDecode);
+    {
+        PmuScope pmu(PmuRegion::FecDecode, 10);
+        busy_work(1000);
+    }
+    const auto after = region_stats(PmuRegion::FecDecode);
+    EXPECT_EQ(after.calls, before.calls);
+    EXPECT_EQ(after.units, before.units);
+}
+
+TEST(PmuProfileTest, EnabledScopeAccumulatesEvents) {
+    if (!core::set_pmu_enabled(true)) {
+        EXPECT_FALSE(core::pmu_unavailable_reason().empty());
+        GTEST_SKIP() << "PMU недоступен: " << core::pmu_unavailable_reason();
+    }
+    const auto before = region_stats(PmuRegion::ShareValidate);
+    for (int i = 0; i < 3; ++i) {
+        PmuScope pmu(PmuRegion::ShareValidate, 4);
+        busy_work(100000);
+    }
+    // Поток со своей группой: суммы остаются после его выхода
+    std::thread([] {
+        PmuScope pmu(PmuRegion::ShareValidate, 4);
+        busy_work(100000);
+    }).join();
+    core::set_pmu_enabled(false);
+
+    const auto after = region_stats(PmuRegion::ShareValidate);
+    EXPECT_EQ(after.calls - before.calls, 4u);
+    EXPECT_EQ(after.units - before.units, 16u);
+    ASSERT_TRUE(after.available[static_cast<std::size_t>(core::PmuEvent::Cycles)]);
+    EXPECT_GT(after.events[static_cast<std::size_t>(core::PmuEvent::Cycles)],
+              before.events[static_cast<std::size_t>(core::PmuEvent::Cycles)]);
+    EXPECT_GE(core::pmu_thread_count(), 1u);
+}
+
+} // namespace quaxis::tests
@@ -0,0 +1,96 @@
+/**
+ * @file test_poll_scheduler.cpp
+ * @brief Тесты для адаптивного расписания опроса aux chains
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+
+#include "merged/poll_scheduler.hpp"
+
+namespace quaxis::tests {
+
+using namespace std::chrono_literals;
+using merged::PollScheduler;
+
+TEST(PollSchedulerTest, InitialIntervalUntilLearned) {
+    PollScheduler schedule;
+    const auto t0 = PollScheduler::Clock::time_point{} + 1h;
+    const auto index = schedule.add_chain(5s, t0);
+
+    // Первый опрос - сразу, следующий - через initial interval
+    EXPECT_TRUE(schedule.take_due(index, t0));
+    EXPECT_FALSE(schedule.take_due(index, t0 + 4s));
+    EXPECT_TRUE(schedule.take_due(index, t0 + 5s));
+    EXPECT_EQ(schedule.interval(index), 5000ms);
+    EXPECT_FALSE(schedule.block_interval(index).has_value());
+
+    // Одна высота - ещё не оценка
+    schedule.observe_height(index, 100, t0);
+    EXPECT_FALSE(schedule.block_interval(index).has_value());
+}
+
+TEST(PollSchedulerTest, LearnsBlockIntervalPerChain) {
+    PollScheduler schedule;
+    const auto t0 = PollScheduler::Clock::time_point{} + 1h;
+    const auto fast = schedule.add_chain(5s, t0);
+    const auto slow = schedule.add_chain(5s, t0);
+
+    schedule.observe_height(fast, 10, t0);
+    schedule.observe_height(slow, 10, t0);
+
+    // Быстрая chain: блок за 150 с, медленная: два блока за 1200 с
+    schedule.observe_height(fast, 11, t0 + 150s);
+    schedule.observe_height(slow, 12, t0 + 1200s);
+
+    EXPECT_EQ(schedule.block_interval(fast), 150000ms);
+    EXPECT_EQ(schedule.block_interval(slow), 600000ms);
+    EXPECT_EQ(schedule.interval(fast), 150000ms / PollScheduler::POLLS_PER_BLOCK);
+    EXPECT_EQ(schedule.interval(slow), 600000ms / PollScheduler::POLLS_PER_BLOCK);
+    EXPECT_LT(schedule.interval(fast), schedule.interval(slow));
+
+    // Следующая выборка сглаживается: (3 * 150 + 250) / 4
+    schedule.observe_height(fast, 12, t0 + 400s);
+    EXPECT_EQ(schedule.block_interval(fast), 175000ms);
+}
+
+TEST(PollSchedulerTest, IntervalClampedAndReorgResets) {
+    PollScheduler schedule;
+    const auto t0 = PollScheduler::Clock::time_point{} + 1h;
+    const auto index = schedule.add_chain(5s, t0);
+
+    // Очень частые блоки - не чаще MIN_INTERVAL
+    schedule.observe_height(index, 1, t0);
+    schedule.observe_height(index, 11, t0 + 10s);
+    EXPECT_EQ(schedule.interval(index), PollScheduler::MIN_INTERVAL);
+
+    // Высота уменьшилась: без выборки, отсчёт от новой высоты
+    schedule.observe_height(index, 5, t0 + 20s);
+    EXPECT_EQ(schedule.block_interval(index), 1000ms);
+
+    // Редкие блоки - не реже MAX_INTERVAL
+    schedule.observe_height(index, 6, t0 + 20s + 10h);
+    EXPECT_EQ(schedule.interval(index), PollScheduler::MAX_INTERVAL);
+}
+
+TEST(PollSchedulerTest, NextDeadlineIsEarliestChain) {
+    PollScheduler schedule;
+    EXPECT_FALSE(schedule.next_deadline().has_value());
+
+    const auto t0 = PollScheduler::Clock::time_point{} + 1h;
+    const auto fast = schedule.add_chain(2s, t0);
+    const auto slow = schedule.add_chain(10s, t0);
+    ASSERT_TRUE(schedule.take_due(fast, t0));
+    ASSERT_TRUE(schedule.take_due(slow, t0));
+    EXPECT_EQ(schedule.next_deadline(), t0 + 2s);
+
+    // Новая оценка сокращает уже назначенный срок (t0 + 10 с)
+    schedule.observe_height(slow, 1, t0);
+    schedule.observe_height(slow, 2, t0 + 1s);
+    EXPECT_EQ(schedule.interval(slow), PollScheduler::MIN_INTERVAL);
+    EXPECT_FALSE(schedule.take_due(slow, t0 + 1500ms));
+    EXPECT_TRUE(schedule.take_due(slow, t0 + 2s));
+}
+
+} // namespace quaxis::tests
@@ -0,0 +1,202 @@
+/**
+ * @file test_reconstructor_pool.cpp
+ * @brief Тесты для пула реконструкторов блоков relay
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "relay/reconstructor_pool.hpp"
+
+namespace quaxis::tests {
+
+namespace {
+
+/**
+ * @brief Хеш с заданными префиксом и хвостом
+ */
+Hash256 make_hash(uint64_t prefix, uint8_t tail) {
+    Hash256 hash{};
+    std::memcpy(hash.data(), &prefix, sizeof(prefix));
+    hash[31] = tail;
+    return hash;
+}
+
+relay::FecParams small_params() {
+    relay::FecParams params;
+    params.data_chunk_count = 2;
+    params.fec_chunk_count = 1;
+    return params;
+}
+
+} // anonymous namespace
+
+TEST(ReconstructorPoolTest, AcquireFindRelease) {
+    relay::ReconstructorPool pool(4);
+    EXPECT_EQ(pool.capacity(), 4u);
+
+    const Hash256 hash = make_hash(0x1234, 1);
+    EXPECT_EQ(pool.find(hash), nullptr);
+
+    auto* entry = pool.acquire(hash, 100, small_params(), 5000);
+    ASSERT_NE(entry, nullptr);
+    EXPECT_TRUE(entry->active);
+    EXPECT_EQ(entry->reconstructor.block_hash(), hash);
+    EXPECT_EQ(entry->reconstructor.height(), 100u);
+    EXPECT_EQ(pool.find(hash), entry);
+    EXPECT_EQ(pool.size(), 1u);
+
+    // Повторный acquire того же хеша возвращает ту же запись
+    EXPECT_EQ(pool.acquire(hash, 100, small_params(), 5000), entry);
+    EXPECT_EQ(pool.size(), 1u);
+
+    pool.release(hash);
+    EXPECT_EQ(pool.find(hash), nullptr);
+    EXPECT_FALSE(entry->active);
+    EXPECT_EQ(pool.size(), 0u);
+}
+
+TEST(ReconstructorPoolTest, PrefixCollisionUsesFullHash) {
+    relay::ReconstructorPool pool(4);
+
+    // Одинаковый 64-битный префикс, разный хвост
+    const Hash256 first = make_hash(0xABCDEF, 1);
+    const Hash256 second = make_hash(0xABCDEF, 2);
+
+    auto* a = pool.acquire(first, 1, small_params(), 5000);
+    auto* b = pool.acquire(second, 2, small_params(), 5000);
+    ASSERT_NE(a, nullptr);
+    ASSERT_NE(b, nullptr);
+    EXPECT_NE(a, b);
+    EXPECT_EQ(pool.find(first), a);
+    EXPECT_EQ(pool.find(second), b);
+
+    pool.release(first);
+    EXPECT_EQ(pool.find(first), nullptr);
+    EXPECT_EQ(pool.find(second), b);
+}
+
+TEST(ReconstructorPoolTest, ReleaseKeepsProbeChains) {
+    constexpr std::size_t COUNT = 8;
+    relay::ReconstructorPool pool(COUNT);
+
+    // Все хеши в одной начальной ячейке: одна длинная цепочка
+    std::vector<Hash256> hashes;
+    for (std::size_t i = 0; i < COUNT; ++i) {
+        hashes.push_back(make_hash(uint64_t{i} << 32, static_cast<uint8_t>(i)));
+        ASSERT_NE(pool.acquire(hashes.back(), 0, small_params(), 5000), nullptr);
+    }
+
+    pool.release(hashes[2]);
+    pool.release(hashes[5]);
+    for (std::size_t i = 0; i < COUNT; ++i) {
+        if (i == 2 || i == 5) {
+            EXPECT_EQ(pool.find(hashes[i]), nullptr);
+        } else {
+            ASSERT_NE(pool.find(hashes[i]), nullptr) << i;
+            EXPECT_EQ(pool.find(hashes[i])->reconstructor.block_hash(), hashes[i]);
+        }
+    }
+}
+
+TEST(ReconstructorPoolTest, FullPoolRefusesAndReportsOldest) {
+    relay::ReconstructorPool pool(2);
+
+    const Hash256 first = make_hash(1, 1);
+    const Hash256 second = make_hash(2, 2);
+    ASSERT_NE(pool.acquire(first, 1, small_params(), 5000), nullptr);
+    ASSERT_NE(pool.acquire(second, 2, small_params(), 5000), nullptr);
+    EXPECT_EQ(pool.acquire(make_hash(3, 3), 3, small_params(), 5000), nullptr);
+
+    auto* oldest = pool.oldest();
+    ASSERT_NE(oldest, nullptr);
+    EXPECT_EQ(oldest->reconstructor.block_hash(), first);
+
+    pool.release(first);
+    auto* third = pool.acquire(make_hash(3, 3), 3, small_params(), 5000);
+    ASSERT_NE(third, nullptr);
+    EXPECT_EQ(third->reconstructor.height(), 3u);
+    EXPECT_FALSE(third->trusted);
+    EXPECT_FALSE(third->speculative_header.has_value());
+}
+
+TEST(ReconstructorPoolTest, ReusedEntryKeepsBlockBuffer) {
+    relay::ReconstructorPool pool(1);
+
+    std::vector<const uint8_t*> buffers;
+    std::vector<std::vector<uint8_t>> blocks;
+    pool.for_each_entry([&](relay::InflightBlock& entry) {
+        entry.reconstructor.set_block_callback(
+            [&](ByteSpan data, uint32_t, const Hash256&) {
+                buffers.push_back(data.data());
+                blocks.emplace_back(data.begin(), data.end());
+            }
+        );
+    });
+
+    const std::vector<uint8_t> chunk_a(400, 0xAA);
+    const std::vector<uint8_t> chunk_b(400, 0xBB);
+    for (uint8_t round = 0; round < 2; ++round) {
+        const Hash256 hash = make_hash(round + 1, round);
+        auto* entry = pool.acquire(hash, round, small_params(), 5000);
+        ASSERT_NE(entry, nullptr);
+        ASSERT_TRUE(entry->reconstructor.on_chunk(0, false, round == 0 ? chunk_a : chunk_b));
+        ASSERT_TRUE(entry->reconstructor.on_chunk(1, false, chunk_a));
+        EXPECT_TRUE(entry->reconstructor.is_complete());
+        pool.release(hash);
+    }
+
+    ASSERT_EQ(buffers.size(), 2u);
+    EXPECT_EQ(buffers[0], buffers[1]);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(buffers[0]) % relay::BLOCK_BUFFER_ALIGNMENT, 0u);
+    EXPECT_EQ(blocks[1].size(), 800u);
+    EXPECT_EQ(blocks[1][0], 0xBB);
+    EXPECT_EQ(blocks[1][400], 0xAA);
+}
+
+TEST(ReconstructorPoolTest, DeferredDecodeWaitsForTryComplete) {
+    relay::ReconstructorPool pool(2);
+
+    int completed = 0;
+    pool.for_each_entry([&](relay::InflightBlock& entry) {
+        entry.reconstructor.set_deferred_decode(true);
+        entry.reconstructor.set_block_callback(
+            [&](ByteSpan, uint32_t, const Hash256&) { ++completed; }
+        );
+    });
+
+    const Hash256 first = make_hash(1, 1);
+    auto* entry = pool.acquire(first, 1, small_params(), 5000);
+    ASSERT_NE(entry, nullptr);
+    ASSERT_NE(pool.acquire(make_hash(2, 2), 2, small_params(), 5000), nullptr);
+
+    const std::vector<uint8_t> chunk(400, 0xCC);
+    ASSERT_TRUE(entry->reconstructor.on_chunk(0, false, chunk));
+    ASSERT_TRUE(entry->reconstructor.on_chunk(1, false, chunk));
+    EXPECT_TRUE(entry->reconstructor.can_try_decode());
+    EXPECT_FALSE(entry->reconstructor.is_complete());
+    EXPECT_EQ(completed, 0);
+
+    // Запись у потока декодирования не вытесняется
+    entry->decoding = true;
+    auto* oldest = pool.oldest();
+    ASSERT_NE(oldest, nullptr);
+    EXPECT_NE(oldest, entry);
+
+    EXPECT_TRUE(entry->reconstructor.try_complete());
+    EXPECT_EQ(completed, 1);
+    pool.release(first);
+
+    // reset сохраняет режим, новая запись не помечена decoding
+    auto* reused = pool.acquire(make_hash(3, 3), 3, small_params(), 5000);
+    ASSERT_EQ(reused, entry);
+    EXPECT_FALSE(reused->decoding);
+    ASSERT_TRUE(reused->reconstructor.on_chunk(0, false, chunk));
+    ASSERT_TRUE(reused->reconstructor.on_chunk(1, false, chunk));
+    EXPECT_EQ(completed, 1);
+}
+
+} // namespace quaxis::tests
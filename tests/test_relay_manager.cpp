@@ -0,0 +1,1002 @@
+/**
+ * @file test_relay_manager.cpp
+ * @brief Тесты для цикла событий RelayManager
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <optional>
+#include <string>
+#include <thread>
+
+#include "core/validation/pow_validator.hpp"
+#include "crypto/sha256.hpp"
+#include "relay/relay_manager.hpp"
+#include "relay/udp_socket.hpp"
+
+namespace quaxis::tests {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief Локальный "FIBRE сервер": сокет, в который пишет пир менеджера
+ */
+class FakeFibreServer {
+public:
+    FakeFibreServer() {
+        EXPECT_TRUE(socket_.bind(0, "127.0.0.1"));
+    }
+
+    [[nodiscard]] uint16_t port() const noexcept { return socket_.local_port(); }
+
+    /**
+     * @brief Собрать keepalive от пира за время timeout, запомнить его адрес
+     */
+    std::size_t collect_keepalives(std::chrono::milliseconds timeout) {
+        std::size_t count = 0;
+        auto deadline = Clock::now() + timeout;
+        while (Clock::now() < deadline) {
+            socket_.receive_batch([&](const relay::UdpDatagram& datagram) {
+                peer_ = datagram.sender();
+                ++count;
+            });
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+        return count;
+    }
+
+    /**
+     * @brief Отвечать эхо на keepalive пира в течение timeout
+     */
+    std::size_t echo_keepalives(std::chrono::milliseconds timeout) {
+        std::size_t count = 0;
+        relay::FibreParser parser;
+        auto deadline = Clock::now() + timeout;
+        while (Clock::now() < deadline) {
+            socket_.receive_batch([&](const relay::UdpDatagram& datagram) {
+                auto header = parser.parse_header(datagram.data);
+                if (header && header->is_keepalive()) {
+                    peer_ = datagram.sender();
+                    auto echo = relay::FibreParser::create_keepalive_echo(*header);
+                    (void)socket_.send(peer_, ByteSpan(echo.data(), echo.size()));
+                    ++count;
+                }
+            });
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return count;
+    }
+
+    [[nodiscard]] const relay::UdpEndpoint& peer() const noexcept { return peer_; }
+
+    relay::UdpSocket& socket() noexcept { return socket_; }
+
+private:
+    relay::UdpSocket socket_;
+    relay::UdpEndpoint peer_;
+};
+
+relay::RelayPeerConfig peer_config(uint16_t port) {
+    relay::RelayPeerConfig config;
+    config.host = "127.0.0.1";
+    config.port = port;
+    config.keepalive_interval_ms = 20;
+    return config;
+}
+
+/**
+ * @brief Параметры сети с regtest pow_limit: PoW находится за пару nonce
+ */
+core::ChainParams regtest_params() {
+    core::ChainParams params = core::bitcoin_params();
+    params.difficulty.pow_limit_bits = 0x207fffff;
+    return params;
+}
+
+/**
+ * @brief Блок из одной транзакции с валидным merkle root и PoW под regtest
+ */
+std::vector<uint8_t> make_block(const core::ChainParams& params, bitcoin::BlockHeader& header) {
+    std::vector<uint8_t> tx = {0x01, 0x00, 0x00, 0x00, 0x01};
+    tx.insert(tx.end(), 32, 0x00);
+    tx.insert(tx.end(), 4, 0xFF);
+    tx.insert(tx.end(), {0x03, 0x51, 0x52, 0x53});
+    tx.insert(tx.end(), 4, 0xFF);
+    tx.insert(tx.end(), {0x01, 0x00, 0xF2, 0x05, 0x2A, 0x01, 0x00, 0x00, 0x00, 0x01, 0x51});
+    tx.insert(tx.end(), 4, 0x00);
+    
+    header = {};
+    header.version = 0x20000000;
+    header.merkle_root = crypto::sha256d(tx);
+    header.timestamp = 1700000000;
+    header.bits = 0x207fffff;
+    core::validation::PowValidator validator(params);
+    while (!validator.check_hash_target(header.hash(), header.bits)) {
+        ++header.nonce;
+    }
+    
+    auto serialized = header.serialize();
+    std::vector<uint8_t> block(serialized.begin(), serialized.end());
+    block.push_back(0x01);
+    block.insert(block.end(), tx.begin(), tx.end());
+    return block;
+}
+
+/**
+ * @brief Блок из count транзакций (coinbase и count - 1 для mempool)
+ */
+std::vector<uint8_t> make_mempool_block(std::size_t count, std::vector<std::vector<uint8_t>>& txs) {
+    txs.clear();
+    for (std::size_t i = 0; i < count; ++i) {
+        std::vector<uint8_t> tx = {0x01, 0x00, 0x00, 0x00, 0x01};
+        tx.insert(tx.end(), 32, static_cast<uint8_t>(i));
+        tx.insert(tx.end(), 4, 0x00);
+        tx.push_back(0x80);
+        tx.insert(tx.end(), 0x80, static_cast<uint8_t>(i * 3));
+        tx.insert(tx.end(), 4, 0xFF);
+        tx.insert(tx.end(), {0x01, 0x00, 0xF2, 0x05, 0x2A, 0x01, 0x00, 0x00, 0x00, 0x01, 0x51});
+        tx.insert(tx.end(), 4, 0x00);
+        txs.push_back(std::move(tx));
+    }
+    
+    bitcoin::BlockHeader header;
+    header.version = 0x20000000;
+    header.timestamp = 1700000000;
+    header.bits = 0x207fffff;
+    std::vector<uint8_t> block(constants::BLOCK_HEADER_SIZE);
+    block.push_back(static_cast<uint8_t>(count));
+    for (const auto& tx : txs) {
+        block.insert(block.end(), tx.begin(), tx.end());
+    }
+    header.merkle_root = *bitcoin::compute_block_merkle_root(block);
+    const auto serialized = header.serialize();
+    std::copy(serialized.begin(), serialized.end(), block.begin());
+    return block;
+}
+
+/**
+ * @brief Отправить data чанк index из count равных частей блока (без FEC)
+ */
+void send_chunk(FakeFibreServer& server, const std::vector<uint8_t>& block,
+                const Hash256& hash, uint32_t height, uint16_t index, uint16_t count) {
+    const std::size_t size = (block.size() + count - 1) / count;
+    const std::size_t begin = std::min(block.size(), index * size);
+    const std::size_t end = std::min(block.size(), begin + size);
+    
+    relay::FibrePacket packet;
+    packet.header.magic = relay::FIBRE_MAGIC;
+    packet.header.version = relay::FIBRE_VERSION;
+    packet.header.block_height = height;
+    packet.header.block_hash = hash;
+    packet.header.chunk_id = index;
+    packet.header.total_chunks = count;
+    packet.header.data_chunks = count;
+    packet.header.payload_size = static_cast<uint16_t>(end - begin);
+    packet.payload.assign(block.begin() + static_cast<std::ptrdiff_t>(begin),
+                          block.begin() + static_cast<std::ptrdiff_t>(end));
+    
+    relay::FibreParser parser;
+    auto data = parser.serialize(packet);
+    ASSERT_TRUE(server.socket().send(server.peer(), ByteSpan(data.data(), data.size())));
+}
+
+/**
+ * @brief Отправить блок одним data чанком FIBRE
+ */
+void send_block(FakeFibreServer& server, const std::vector<uint8_t>& block,
+                const Hash256& hash, uint32_t height) {
+    send_chunk(server, block, hash, height, 0, 1);
+}
+
+/**
+ * @brief Дождаться снимка пира (обновляется раз в секунду)
+ */
+relay::PeerStats wait_peer_stats(const relay::RelayManager& manager, uint16_t port,
+                                 uint64_t min_chunks) {
+    const std::string address = "127.0.0.1:" + std::to_string(port);
+    auto deadline = Clock::now() + std::chrono::seconds(3);
+    relay::PeerStats stats;
+    while (Clock::now() < deadline) {
+        for (const auto& peer : manager.peer_stats()) {
+            if (peer.address == address) {
+                stats = peer.stats;
+            }
+        }
+        if (stats.chunks_first + stats.chunks_duplicate >= min_chunks) {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    return stats;
+}
+
+/**
+ * @brief Снимок пира по порту (пустой, если пира нет в снимке)
+ */
+std::optional<relay::PeerSnapshot> find_peer(const relay::RelayManager& manager, uint16_t port) {
+    const std::string address = "127.0.0.1:" + std::to_string(port);
+    for (const auto& peer : manager.peer_stats()) {
+        if (peer.address == address) {
+            return peer;
+        }
+    }
+    return std::nullopt;
+}
+
+/**
+ * @brief Результаты header-first callbacks
+ */
+struct HeaderFirstRecorder {
+    std::atomic<int> speculative{0};
+    std::atomic<int> blocks{0};
+    std::atomic<int> states{0};
+    std::atomic<int64_t> coinbase_value{0};
+    std::atomic<relay::RelayBlockState> state{relay::RelayBlockState::Confirmed};
+    
+    void attach(relay::RelayManager& manager) {
+        manager.set_speculative_callback([this](const bitcoin::BlockHeader&, uint32_t, int64_t value) {
+            coinbase_value.store(value);
+            speculative.fetch_add(1);
+        });
+        manager.set_block_state_callback([this](const Hash256&, uint32_t, relay::RelayBlockState s) {
+            state.store(s);
+            states.fetch_add(1);
+        });
+        manager.set_block_callback([this](ByteSpan, uint32_t, relay::BlockSource) {
+            blocks.fetch_add(1);
+        });
+    }
+    
+    void wait_for_blocks_or_states() const {
+        auto deadline = Clock::now() + std::chrono::seconds(1);
+        while (blocks.load() + states.load() == 0 && Clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        // Callbacks одного пакета идут подряд в рабочем потоке
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+};
+
+} // anonymous namespace
+
+TEST(RelayManagerTest, BroadcastBlockSpraysFecChunksToTrustedPeers) {
+    FakeFibreServer trusted;
+    FakeFibreServer other;
+    RelayConfig config;
+    config.fec_overhead = 0.5;
+    config.broadcast_burst = 2;
+    relay::RelayManager manager(config);
+
+    ASSERT_TRUE(manager.start());
+    auto trusted_config = peer_config(trusted.port());
+    trusted_config.trusted = true;
+    ASSERT_TRUE(manager.add_peer(trusted_config));
+    ASSERT_TRUE(manager.add_peer(peer_config(other.port())));
+
+    // 4 data чанка по MAX_CHUNK_SIZE (последний короче) и 2 FEC
+    std::vector<uint8_t> block(3 * relay::MAX_CHUNK_SIZE + 500);
+    for (std::size_t i = 0; i < block.size(); ++i) {
+        block[i] = static_cast<uint8_t>(i * 7);
+    }
+    Hash256 hash{};
+    hash[0] = 0x42;
+    ASSERT_TRUE(manager.broadcast_block(block, hash, 900'000));
+
+    auto collect = [](FakeFibreServer& server) {
+        std::vector<relay::FibrePacket> packets;
+        relay::FibreParser parser;
+        auto deadline = Clock::now() + std::chrono::milliseconds(100);
+        while (Clock::now() < deadline) {
+            server.socket().receive_batch([&](const relay::UdpDatagram& datagram) {
+                auto packet = parser.parse(datagram.data);
+                if (packet && !packet->header.is_keepalive()) {
+                    packets.push_back(std::move(*packet));
+                }
+            });
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+        return packets;
+    };
+    auto packets = collect(trusted);
+    EXPECT_TRUE(collect(other).empty());
+    ASSERT_EQ(packets.size(), 6u);
+    EXPECT_TRUE(relay::has_flag(packets.back().header.flags, relay::FibreFlags::LastChunk));
+
+    // Пир восстанавливает блок без двух data чанков
+    relay::FecParams params;
+    params.data_chunk_count = packets[0].header.data_chunks;
+    params.fec_chunk_count = packets[0].header.fec_chunks();
+    ASSERT_EQ(params.data_chunk_count, 4);
+    ASSERT_EQ(params.fec_chunk_count, 2);
+    relay::FecDecoder decoder(params);
+    for (const auto& packet : packets) {
+        if (packet.header.chunk_id == 1 || packet.header.chunk_id == 3) {
+            continue;
+        }
+        const uint16_t id = packet.header.is_fec()
+            ? static_cast<uint16_t>(packet.header.chunk_id - packet.header.data_chunks)
+            : packet.header.chunk_id;
+        ASSERT_TRUE(decoder.add_chunk(id, packet.header.is_fec(), packet.payload));
+    }
+    auto decoded = decoder.decode();
+    ASSERT_TRUE(decoded) << decoded.error().message();
+    ASSERT_GE(decoded->data.size(), block.size());
+    EXPECT_TRUE(std::equal(block.begin(), block.end(), decoded->data.begin()));
+    manager.stop();
+}
+
+TEST(RelayManagerTest, ChunksFromPeersMergeIntoOneBlock) {
+    FakeFibreServer fast;
+    FakeFibreServer slow;
+    auto params = regtest_params();
+    relay::RelayManager manager(RelayConfig{}, params);
+    HeaderFirstRecorder recorder;
+    recorder.attach(manager);
+
+    ASSERT_TRUE(manager.start());
+    ASSERT_TRUE(manager.add_peer(peer_config(fast.port())));
+    ASSERT_TRUE(manager.add_peer(peer_config(slow.port())));
+    ASSERT_GE(fast.collect_keepalives(std::chrono::milliseconds(30)), 1u);
+    ASSERT_GE(slow.collect_keepalives(std::chrono::milliseconds(30)), 1u);
+
+    bitcoin::BlockHeader header;
+    auto block = make_block(params, header);
+    const Hash256 hash = header.hash();
+    const auto step = std::chrono::milliseconds(20);
+
+    // fast: 0, 2; slow: 0 (копия), 1; блок собирается из чанков обоих
+    send_chunk(fast, block, hash, 900'000, 0, 3);
+    std::this_thread::sleep_for(step);
+    send_chunk(slow, block, hash, 900'000, 0, 3);
+    std::this_thread::sleep_for(step);
+    send_chunk(slow, block, hash, 900'000, 1, 3);
+    std::this_thread::sleep_for(step);
+    send_chunk(fast, block, hash, 900'000, 2, 3);
+    recorder.wait_for_blocks_or_states();
+    EXPECT_EQ(recorder.blocks.load(), 1);
+
+    // Чанк уже собранного блока - тоже проигравшая копия
+    send_chunk(slow, block, hash, 900'000, 2, 3);
+    std::this_thread::sleep_for(step);
+
+    auto fast_stats = wait_peer_stats(manager, fast.port(), 2);
+    auto slow_stats = wait_peer_stats(manager, slow.port(), 3);
+    EXPECT_EQ(fast_stats.chunks_first, 2u);
+    EXPECT_EQ(fast_stats.chunks_duplicate, 0u);
+    EXPECT_EQ(fast_stats.headers_first, 0u);
+    EXPECT_EQ(fast_stats.blocks_received, 1u);
+    EXPECT_EQ(slow_stats.chunks_first, 1u);
+    EXPECT_EQ(slow_stats.chunks_duplicate, 2u);
+    // Чанк ~47 байт: 80 байт header набираются только с чанком 1
+    EXPECT_EQ(slow_stats.headers_first, 1u);
+    EXPECT_EQ(manager.stats().duplicate_chunks, 2u);
+    EXPECT_EQ(manager.stats().blocks_received, 1u);
+    manager.stop();
+}
+
+TEST(RelayManagerTest, ReceiveThreadsHandOffChunksToBlockOwner) {
+    FakeFibreServer first;
+    FakeFibreServer second;
+    auto params = regtest_params();
+    RelayConfig config;
+    config.receive_threads = 2;
+    config.receive_steer_cpu = false;
+    relay::RelayManager manager(config, params);
+    HeaderFirstRecorder recorder;
+    recorder.attach(manager);
+
+    ASSERT_TRUE(manager.start());
+    // По кругу: first - поток 0, second - поток 1
+    ASSERT_TRUE(manager.add_peer(peer_config(first.port())));
+    ASSERT_TRUE(manager.add_peer(peer_config(second.port())));
+    ASSERT_GE(first.collect_keepalives(std::chrono::milliseconds(30)), 1u);
+    ASSERT_GE(second.collect_keepalives(std::chrono::milliseconds(30)), 1u);
+
+    bitcoin::BlockHeader header;
+    auto block = make_block(params, header);
+    const Hash256 hash = header.hash();
+    const auto step = std::chrono::milliseconds(20);
+
+    // Чанки одного блока приходят в оба потока, собирает их владелец
+    send_chunk(first, block, hash, 900'000, 0, 4);
+    send_chunk(second, block, hash, 900'000, 1, 4);
+    send_chunk(second, block, hash, 900'000, 0, 4);
+    send_chunk(first, block, hash, 900'000, 2, 4);
+    std::this_thread::sleep_for(step);
+    send_chunk(second, block, hash, 900'000, 3, 4);
+    recorder.wait_for_blocks_or_states();
+    EXPECT_EQ(recorder.blocks.load(), 1);
+
+    auto first_stats = wait_peer_stats(manager, first.port(), 2);
+    auto second_stats = wait_peer_stats(manager, second.port(), 3);
+    EXPECT_EQ(first_stats.chunks_first + second_stats.chunks_first, 4u);
+    EXPECT_EQ(first_stats.chunks_duplicate + second_stats.chunks_duplicate, 1u);
+
+    const auto stats = manager.stats();
+    EXPECT_EQ(stats.receive_threads, 2u);
+    EXPECT_EQ(stats.blocks_received, 1u);
+    EXPECT_EQ(stats.duplicate_chunks, 1u);
+    // Владелец - один поток: чанки пира другого потока переданы ему
+    EXPECT_GE(stats.handoff_chunks, 2u);
+    EXPECT_EQ(stats.handoff_drops, 0u);
+    manager.stop();
+}
+
+TEST(RelayManagerTest, DecodeThreadCompletesBlock) {
+    FakeFibreServer first;
+    FakeFibreServer second;
+    auto params = regtest_params();
+    RelayConfig config;
+    config.decode_thread = true;
+    relay::RelayManager manager(config, params);
+    HeaderFirstRecorder recorder;
+    recorder.attach(manager);
+
+    ASSERT_TRUE(manager.start());
+    ASSERT_TRUE(manager.add_peer(peer_config(first.port())));
+    ASSERT_TRUE(manager.add_peer(peer_config(second.port())));
+    ASSERT_GE(first.collect_keepalives(std::chrono::milliseconds(30)), 1u);
+    ASSERT_GE(second.collect_keepalives(std::chrono::milliseconds(30)), 1u);
+
+    bitcoin::BlockHeader header;
+    auto block = make_block(params, header);
+    const Hash256 hash = header.hash();
+    const auto step = std::chrono::milliseconds(20);
+
+    send_chunk(first, block, hash, 900'000, 0, 3);
+    send_chunk(second, block, hash, 900'000, 1, 3);
+    std::this_thread::sleep_for(step);
+    send_chunk(second, block, hash, 900'000, 2, 3);
+    recorder.wait_for_blocks_or_states();
+    EXPECT_EQ(recorder.blocks.load(), 1);
+
+    // Чанк собранного блока - проигравшая копия, блок не собирается снова
+    send_chunk(first, block, hash, 900'000, 2, 3);
+    std::this_thread::sleep_for(step);
+    EXPECT_EQ(recorder.blocks.load(), 1);
+
+    // Победа в сборке засчитана пиру, чанк которого сделал блок декодируемым
+    auto second_stats = wait_peer_stats(manager, second.port(), 2);
+    auto first_stats = wait_peer_stats(manager, first.port(), 2);
+    EXPECT_EQ(second_stats.blocks_received, 1u);
+    EXPECT_EQ(first_stats.blocks_received, 0u);
+    EXPECT_EQ(first_stats.chunks_duplicate, 1u);
+
+    EXPECT_EQ(manager.stats().blocks_received, 1u);
+    EXPECT_EQ(manager.latency_histograms().decode_latency.count(), 1u);
+    manager.stop();
+}
+
+TEST(RelayManagerTest, MempoolPrefillRebuildsBlockFromSketchAndFec) {
+    FakeFibreServer hop;
+    FakeFibreServer source;
+
+    RelayConfig sender_config;
+    sender_config.mempool_prefill = true;
+    sender_config.fec_overhead = 0.5;
+    relay::RelayManager sender(sender_config);
+    ASSERT_TRUE(sender.start());
+    ASSERT_TRUE(sender.add_peer(peer_config(hop.port())));
+
+    RelayConfig receiver_config;
+    receiver_config.mempool_prefill = true;
+    relay::RelayManager receiver(receiver_config);
+    std::atomic<int> blocks{0};
+    std::vector<uint8_t> received;
+    receiver.set_block_callback([&](ByteSpan data, uint32_t, relay::BlockSource) {
+        received.assign(data.begin(), data.end());
+        blocks.fetch_add(1);
+    });
+    ASSERT_TRUE(receiver.start());
+    ASSERT_TRUE(receiver.add_peer(peer_config(source.port())));
+    ASSERT_GE(source.collect_keepalives(std::chrono::milliseconds(30)), 1u);
+
+    // Mempool приёмника - все транзакции блока, кроме coinbase
+    std::vector<std::vector<uint8_t>> txs;
+    auto block = make_mempool_block(24, txs);
+    for (std::size_t i = 1; i < txs.size(); ++i) {
+        EXPECT_TRUE(receiver.add_transaction(txs[i]));
+    }
+    EXPECT_FALSE(receiver.add_transaction(txs[1]));
+
+    auto header = bitcoin::BlockHeader::deserialize(block);
+    ASSERT_TRUE(header);
+    const Hash256 hash = header->hash();
+    ASSERT_TRUE(sender.broadcast_block(block, hash, 900'000));
+
+    // До приёмника доходят только набросок и FEC: data чанков нет вовсе
+    std::size_t sketches = 0;
+    std::size_t fec = 0;
+    relay::FibreParser parser;
+    auto deadline = Clock::now() + std::chrono::milliseconds(100);
+    while (Clock::now() < deadline) {
+        hop.socket().receive_batch([&](const relay::UdpDatagram& datagram) {
+            auto packet_header = parser.parse_header(datagram.data);
+            if (!packet_header || !(packet_header->is_sketch() || packet_header->is_fec())) {
+                return;
+            }
+            if (packet_header->is_sketch()) {
+                EXPECT_EQ(fec, 0u);  // набросок идёт первым
+                ++sketches;
+            } else {
+                ++fec;
+            }
+            (void)source.socket().send(source.peer(), datagram.data);
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    EXPECT_GE(sketches, 1u);
+    EXPECT_GE(fec, 1u);
+
+    deadline = Clock::now() + std::chrono::seconds(1);
+    while (blocks.load() == 0 && Clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    ASSERT_EQ(blocks.load(), 1);
+    ASSERT_GE(received.size(), block.size());
+    EXPECT_TRUE(std::equal(block.begin(), block.end(), received.begin()));
+
+    const auto stats = receiver.stats();
+    EXPECT_EQ(stats.sketches_received, 1u);
+    EXPECT_GT(stats.prefilled_chunks, 0u);
+    EXPECT_EQ(stats.prefill_mismatches, 0u);
+    EXPECT_EQ(stats.tx_cache_size, txs.size() - 1);
+
+    // Без mempool_prefill кеша нет
+    relay::RelayManager plain(RelayConfig{});
+    EXPECT_FALSE(plain.add_transaction(txs[1]));
+
+    receiver.stop();
+    sender.stop();
+}
+
+TEST(RelayManagerTest, TimerSendsKeepalives) {
+    FakeFibreServer server;
+    relay::RelayManager manager(RelayConfig{});
+    ASSERT_TRUE(manager.start());
+    ASSERT_TRUE(manager.add_peer(peer_config(server.port())));
+
+    // Первый keepalive при connect, дальше - таймер каждые 20 мс
+    EXPECT_GE(server.collect_keepalives(std::chrono::milliseconds(200)), 3u);
+    manager.stop();
+}
+
+TEST(RelayManagerTest, HeaderDeliveredOnSocketReadiness) {
+    FakeFibreServer server;
+    relay::RelayManager manager(RelayConfig{});
+
+    std::atomic<int> headers{0};
+    manager.set_header_callback([&](const bitcoin::BlockHeader&, relay::BlockSource source) {
+        EXPECT_EQ(source, relay::BlockSource::UdpRelay);
+        headers.fetch_add(1);
+    });
+
+    ASSERT_TRUE(manager.start());
+    ASSERT_TRUE(manager.add_peer(peer_config(server.port())));
+    ASSERT_GE(server.collect_keepalives(std::chrono::milliseconds(30)), 1u);
+
+    // Первый чанк двухчанкового блока содержит header
+    relay::FibrePacket packet;
+    packet.header.magic = relay::FIBRE_MAGIC;
+    packet.header.version = relay::FIBRE_VERSION;
+    packet.header.chunk_id = 0;
+    packet.header.block_height = 900'000;
+    packet.header.block_hash[0] = 0x42;
+    packet.header.total_chunks = 2;
+    packet.header.data_chunks = 2;
+    packet.header.payload_size = 100;
+    packet.payload.assign(100, 0);
+
+    relay::FibreParser parser;
+    auto data = parser.serialize(packet);
+    ASSERT_TRUE(server.socket().send(server.peer(), ByteSpan(data.data(), data.size())));
+
+    auto deadline = Clock::now() + std::chrono::seconds(1);
+    while (headers.load() == 0 && Clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(headers.load(), 1);
+    EXPECT_EQ(manager.last_block_height(), 900'000u);
+    manager.stop();
+}
+
+TEST(RelayManagerTest, XdpDatagramsReachMatchingPeer) {
+    FakeFibreServer server;
+    RelayConfig config;
+    config.xdp_interface = "lo";
+    // keepalive - тоже FIBRE пакет: после подключения программы его
+    // забрал бы AF_XDP, поэтому пир подключается в start() до неё
+    config.peers.push_back({"127.0.0.1", server.port(), false});
+    relay::RelayManager manager(config);
+
+    std::atomic<int> headers{0};
+    manager.set_header_callback([&](const bitcoin::BlockHeader&, relay::BlockSource) {
+        headers.fetch_add(1);
+    });
+
+    ASSERT_TRUE(manager.start());
+    if (!manager.stats().xdp_active) {
+        manager.stop();
+        GTEST_SKIP() << "AF_XDP недоступен";
+    }
+    ASSERT_GE(server.collect_keepalives(std::chrono::milliseconds(30)), 1u);
+
+    std::vector<uint8_t> block(200, 0x33);
+    Hash256 hash{};
+    hash[0] = 0x77;
+    send_chunk(server, block, hash, 900'001, 0, 2);
+
+    auto deadline = Clock::now() + std::chrono::seconds(1);
+    while (headers.load() == 0 && Clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(headers.load(), 1);
+
+    // Датаграмма пришла через AF_XDP, а не через сокет пира
+    auto stats = wait_peer_stats(manager, server.port(), 1);
+    EXPECT_EQ(stats.chunks_first, 1u);
+    EXPECT_EQ(stats.recv_syscalls, 0u);
+    deadline = Clock::now() + std::chrono::seconds(2);
+    while (manager.stats().xdp_datagrams == 0 && Clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    EXPECT_EQ(manager.stats().xdp_datagrams, 1u);
+    manager.stop();
+}
+
+TEST(RelayManagerTest, StopWakesIdleWorker) {
+    relay::RelayManager manager(RelayConfig{});
+    ASSERT_TRUE(manager.start());
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    auto started = Clock::now();
+    manager.stop();
+    EXPECT_LT(Clock::now() - started, std::chrono::milliseconds(100));
+    EXPECT_FALSE(manager.is_running());
+}
+
+TEST(RelayManagerTest, RemovePeerWhileRunning) {
+    FakeFibreServer server;
+    relay::RelayManager manager(RelayConfig{});
+    ASSERT_TRUE(manager.start());
+    ASSERT_TRUE(manager.add_peer(peer_config(server.port())));
+    ASSERT_GE(server.collect_keepalives(std::chrono::milliseconds(30)), 1u);
+
+    manager.remove_peer("127.0.0.1", server.port());
+    EXPECT_EQ(manager.peer_count(), 0u);
+
+    // Пир удалён - keepalive больше не приходят
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    (void)server.collect_keepalives(std::chrono::milliseconds(5));
+    EXPECT_EQ(server.collect_keepalives(std::chrono::milliseconds(60)), 0u);
+    manager.stop();
+}
+
+TEST(RelayManagerTest, ParseViewPointsIntoDatagram) {
+    relay::FibrePacket packet;
+    packet.header.magic = relay::FIBRE_MAGIC;
+    packet.header.version = relay::FIBRE_VERSION;
+    packet.header.chunk_id = 7;
+    packet.header.total_chunks = 10;
+    packet.header.data_chunks = 8;
+    packet.header.payload_size = 32;
+    packet.payload.assign(32, 0x3C);
+
+    relay::FibreParser parser;
+    auto data = parser.serialize(packet);
+    auto view = parser.parse_view(ByteSpan(data.data(), data.size()));
+    ASSERT_TRUE(view) << view.error().message();
+
+    // payload - окно в датаграмму, без копии
+    EXPECT_EQ(view->header.chunk_id, 7);
+    ASSERT_EQ(view->payload.size(), 32u);
+    EXPECT_EQ(view->payload.data(), data.data() + relay::FIBRE_HEADER_SIZE);
+}
+
+TEST(RelayManagerTest, ParseBatchMatchesParseView) {
+    relay::FibreParser parser;
+    auto make = [&](uint16_t chunk_id, uint8_t flags) {
+        relay::FibrePacket packet;
+        packet.header.magic = relay::FIBRE_MAGIC;
+        packet.header.version = relay::FIBRE_VERSION;
+        packet.header.flags = flags;
+        packet.header.chunk_id = chunk_id;
+        packet.header.total_chunks = 100;
+        packet.header.data_chunks = 80;
+        packet.header.payload_size = 16;
+        packet.payload.assign(16, static_cast<uint8_t>(chunk_id));
+        return parser.serialize(packet);
+    };
+
+    // 70 датаграмм: больше группы prefilter и хвост вне SIMD
+    std::vector<std::vector<uint8_t>> buffers;
+    for (uint16_t i = 0; i < 70; ++i) {
+        auto data = make(i, static_cast<uint8_t>(i % 2 ? relay::FibreFlags::FecChunk : relay::FibreFlags::None));
+        switch (i % 7) {
+            case 1: data[0] ^= 0xFF; break;          // magic
+            case 2: data[4] = 0; break;              // версия
+            case 3: data[5] = 0x80; break;           // неизвестный флаг
+            case 4: data.resize(30); break;          // короче заголовка
+            case 5: data.resize(relay::FIBRE_HEADER_SIZE + 8); break;  // обрезан payload
+            default: break;
+        }
+        buffers.push_back(std::move(data));
+    }
+
+    std::vector<relay::UdpDatagram> datagrams(buffers.size());
+    for (std::size_t i = 0; i < buffers.size(); ++i) {
+        datagrams[i].data = ByteSpan(buffers[i].data(), buffers[i].size());
+    }
+    std::vector<relay::FibrePacketView> out(datagrams.size());
+    auto packets = parser.parse_batch(datagrams, out);
+
+    std::vector<relay::FibrePacketView> expected;
+    for (const auto& datagram : datagrams) {
+        if (auto view = parser.parse_view(datagram.data)) {
+            expected.push_back(*view);
+        }
+    }
+    ASSERT_EQ(packets.size(), expected.size());
+    EXPECT_EQ(packets.size(), 20u);
+    for (std::size_t i = 0; i < packets.size(); ++i) {
+        EXPECT_EQ(packets[i].header.chunk_id, expected[i].header.chunk_id);
+        EXPECT_EQ(packets[i].header.flags, expected[i].header.flags);
+        EXPECT_EQ(packets[i].payload.data(), expected[i].payload.data());
+        EXPECT_EQ(packets[i].payload.size(), 16u);
+    }
+}
+
+TEST(RelayManagerTest, BurstDeliversPriorityChunksFirst) {
+    relay::FibreParser parser;
+    auto make = [&](uint8_t block, uint16_t chunk_id, uint8_t flags) {
+        relay::FibrePacket packet;
+        packet.header.magic = relay::FIBRE_MAGIC;
+        packet.header.version = relay::FIBRE_VERSION;
+        packet.header.flags = flags;
+        packet.header.chunk_id = chunk_id;
+        packet.header.block_hash[0] = block;
+        packet.header.total_chunks = 12;
+        packet.header.data_chunks = 10;
+        packet.header.payload_size = 64;
+        packet.payload.assign(64, block);
+        return parser.serialize(packet);
+    };
+    const auto none = static_cast<uint8_t>(relay::FibreFlags::None);
+    const auto fec = static_cast<uint8_t>(relay::FibreFlags::FecChunk);
+    const auto last = static_cast<uint8_t>(relay::FibreFlags::LastChunk);
+    
+    // Тело блока 1, затем header блока 2 (чанки 0 и 1: 64 байта на чанк)
+    // и LastChunk блока 1
+    std::vector<std::vector<uint8_t>> buffers = {
+        make(1, 5, none), make(1, 10, fec), make(1, 6, none), make(2, 0, none),
+        make(1, 7, none), make(2, 1, none), make(1, 9, last), make(1, 8, none),
+    };
+    std::vector<relay::UdpDatagram> datagrams(buffers.size());
+    for (std::size_t i = 0; i < buffers.size(); ++i) {
+        datagrams[i].data = ByteSpan(buffers[i].data(), buffers[i].size());
+        datagrams[i].received_at = Clock::now();
+    }
+    
+    auto header = parser.parse_header(datagrams[3].data);
+    ASSERT_TRUE(header);
+    EXPECT_TRUE(header->carries_header());
+    header = parser.parse_header(datagrams[1].data);
+    ASSERT_TRUE(header);
+    EXPECT_FALSE(header->carries_header());  // FEC чанк с chunk_id 10
+    
+    relay::RelayPeer peer(peer_config(9));
+    std::vector<std::pair<uint8_t, uint16_t>> order;
+    peer.set_packet_callback([&](const relay::FibrePacketView& packet) {
+        order.emplace_back(packet.header.block_hash[0], packet.header.chunk_id);
+    });
+    peer.deliver(std::span<const relay::UdpDatagram>(datagrams));
+    
+    // Быстрая полоса в порядке прихода, затем остальные
+    const std::vector<std::pair<uint8_t, uint16_t>> expected = {
+        {2, 0}, {2, 1}, {1, 9}, {1, 5}, {1, 10}, {1, 6}, {1, 7}, {1, 8},
+    };
+    EXPECT_EQ(order, expected);
+}
+
+TEST(RelayManagerTest, HeaderFirstSpeculativeThenConfirmed) {
+    FakeFibreServer server;
+    auto params = regtest_params();
+    relay::RelayManager manager(RelayConfig{}, params);
+    HeaderFirstRecorder recorder;
+    recorder.attach(manager);
+
+    ASSERT_TRUE(manager.start());
+    auto config = peer_config(server.port());
+    config.trusted = true;
+    ASSERT_TRUE(manager.add_peer(config));
+    ASSERT_GE(server.collect_keepalives(std::chrono::milliseconds(30)), 1u);
+
+    bitcoin::BlockHeader header;
+    auto block = make_block(params, header);
+    send_block(server, block, header.hash(), 900'000);
+    recorder.wait_for_blocks_or_states();
+
+    EXPECT_EQ(recorder.speculative.load(), 1);
+    EXPECT_EQ(recorder.coinbase_value.load(), bitcoin::block_subsidy(900'001));
+    EXPECT_EQ(recorder.states.load(), 1);
+    EXPECT_EQ(recorder.state.load(), relay::RelayBlockState::Confirmed);
+    EXPECT_EQ(recorder.blocks.load(), 1);
+    EXPECT_EQ(manager.stats().speculative_headers, 1u);
+    manager.stop();
+}
+
+TEST(RelayManagerTest, HeaderFirstInvalidBodyIsReported) {
+    FakeFibreServer server;
+    auto params = regtest_params();
+    relay::RelayManager manager(RelayConfig{}, params);
+    HeaderFirstRecorder recorder;
+    recorder.attach(manager);
+
+    ASSERT_TRUE(manager.start());
+    auto config = peer_config(server.port());
+    config.trusted = true;
+    ASSERT_TRUE(manager.add_peer(config));
+    ASSERT_GE(server.collect_keepalives(std::chrono::milliseconds(30)), 1u);
+
+    // Заголовок с PoW, но тело подменено: merkle root не сходится
+    bitcoin::BlockHeader header;
+    auto block = make_block(params, header);
+    block.back() ^= 0x01;
+    send_block(server, block, header.hash(), 900'000);
+    recorder.wait_for_blocks_or_states();
+
+    EXPECT_EQ(recorder.speculative.load(), 1);
+    EXPECT_EQ(recorder.states.load(), 1);
+    EXPECT_EQ(recorder.state.load(), relay::RelayBlockState::Invalid);
+    EXPECT_EQ(recorder.blocks.load(), 0);
+    EXPECT_EQ(manager.stats().invalid_blocks, 1u);
+    manager.stop();
+}
+
+TEST(RelayManagerTest, HeaderFirstIgnoresUntrustedAndBadPow) {
+    FakeFibreServer server;
+    auto params = regtest_params();
+    relay::RelayManager manager(RelayConfig{}, params);
+    HeaderFirstRecorder recorder;
+    recorder.attach(manager);
+
+    ASSERT_TRUE(manager.start());
+    ASSERT_TRUE(manager.add_peer(peer_config(server.port())));
+    ASSERT_GE(server.collect_keepalives(std::chrono::milliseconds(30)), 1u);
+
+    // Пир не trusted: блок доходит, но spy mining не включается
+    bitcoin::BlockHeader header;
+    auto block = make_block(params, header);
+    send_block(server, block, header.hash(), 900'000);
+    recorder.wait_for_blocks_or_states();
+
+    EXPECT_EQ(recorder.speculative.load(), 0);
+    EXPECT_EQ(recorder.states.load(), 0);
+    EXPECT_EQ(recorder.blocks.load(), 1);
+
+    // С mainnet pow_limit тот же заголовок отклоняется
+    FakeFibreServer trusted_server;
+    relay::RelayManager mainnet(RelayConfig{});
+    HeaderFirstRecorder mainnet_recorder;
+    mainnet_recorder.attach(mainnet);
+    ASSERT_TRUE(mainnet.start());
+    auto config = peer_config(trusted_server.port());
+    config.trusted = true;
+    ASSERT_TRUE(mainnet.add_peer(config));
+    ASSERT_GE(trusted_server.collect_keepalives(std::chrono::milliseconds(30)), 1u);
+    send_block(trusted_server, block, header.hash(), 900'000);
+    mainnet_recorder.wait_for_blocks_or_states();
+
+    EXPECT_EQ(mainnet_recorder.speculative.load(), 0);
+    EXPECT_EQ(mainnet.stats().rejected_headers, 1u);
+    mainnet.stop();
+    manager.stop();
+}
+
+TEST(RelayManagerTest, KeepaliveEchoRoundTrip) {
+    constexpr uint64_t TIMESTAMP = 0x0123456789ABCDEFull;
+    relay::FibreParser parser;
+    auto keepalive = relay::FibreParser::create_keepalive(7, TIMESTAMP);
+    auto request = parser.parse_header(keepalive);
+    ASSERT_TRUE(request.has_value());
+    EXPECT_FALSE(request->is_keepalive_echo());
+    
+    // Эхо возвращает номер и метку времени запроса
+    auto echo = relay::FibreParser::create_keepalive_echo(*request);
+    auto reply = parser.parse_header(echo);
+    ASSERT_TRUE(reply.has_value());
+    EXPECT_TRUE(reply->is_keepalive_echo());
+    EXPECT_EQ(reply->block_height, 7u);
+    EXPECT_EQ(relay::FibreParser::keepalive_timestamp(*reply), TIMESTAMP);
+    
+    // keepalive с payload некорректен
+    request->payload_size = 1;
+    EXPECT_FALSE(request->is_valid());
+}
+
+TEST(RelayManagerTest, KeepaliveEchoMeasuresRtt) {
+    FakeFibreServer server;
+    relay::RelayManager manager(RelayConfig{});
+    ASSERT_TRUE(manager.start());
+    ASSERT_TRUE(manager.add_peer(peer_config(server.port())));
+
+    // keepalive каждые 20 мс, снимок пиров - раз в секунду
+    ASSERT_GE(server.echo_keepalives(std::chrono::milliseconds(1200)), 3u);
+    auto deadline = Clock::now() + std::chrono::seconds(2);
+    std::optional<relay::PeerSnapshot> peer;
+    while (Clock::now() < deadline) {
+        (void)server.echo_keepalives(std::chrono::milliseconds(50));
+        peer = find_peer(manager, server.port());
+        if (peer && peer->stats.keepalives_received >= 3) {
+            break;
+        }
+    }
+    ASSERT_TRUE(peer.has_value());
+    const auto& stats = peer->stats;
+    EXPECT_GE(stats.keepalives_received, 3u);
+    EXPECT_LE(stats.keepalives_received, stats.keepalives_sent);
+    EXPECT_GT(stats.avg_latency_ms, 0.0);
+    EXPECT_LE(stats.min_latency_ms, stats.avg_latency_ms);
+    EXPECT_GE(stats.max_latency_ms, stats.avg_latency_ms);
+    EXPECT_LT(stats.max_latency_ms, 1000.0);
+    EXPECT_GE(stats.jitter_ms, 0.0);
+    manager.stop();
+}
+
+TEST(RelayManagerTest, SlowPeerRankedAndDropped) {
+    FakeFibreServer fast;
+    FakeFibreServer slow;
+    RelayConfig config;
+    config.slow_peer_min_blocks = 3;
+    config.slow_peer_lag_ms = 10;
+    relay::RelayManager manager(config);
+
+    ASSERT_TRUE(manager.start());
+    ASSERT_TRUE(manager.add_peer(peer_config(fast.port())));
+    ASSERT_TRUE(manager.add_peer(peer_config(slow.port())));
+    ASSERT_GE(fast.collect_keepalives(std::chrono::milliseconds(30)), 1u);
+    ASSERT_GE(slow.collect_keepalives(std::chrono::milliseconds(30)), 1u);
+
+    // Каждый блок: сначала fast, через 30 мс тот же чанк от slow
+    const std::vector<uint8_t> block(200, 0x5A);
+    for (uint8_t i = 0; i < 3; ++i) {
+        Hash256 hash{};
+        hash[0] = static_cast<uint8_t>(0x70 + i);
+        send_block(fast, block, hash, 900'000 + i);
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+        send_block(slow, block, hash, 900'000 + i);
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    // Политика применяется раз в секунду
+    auto deadline = Clock::now() + std::chrono::seconds(3);
+    while (manager.stats().dropped_peers == 0 && Clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(manager.stats().dropped_peers, 1u);
+
+    auto fast_peer = find_peer(manager, fast.port());
+    auto slow_peer = find_peer(manager, slow.port());
+    ASSERT_TRUE(fast_peer.has_value());
+    ASSERT_TRUE(slow_peer.has_value());
+    EXPECT_EQ(fast_peer->stats.blocks_first, 3u);
+    EXPECT_EQ(fast_peer->stats.blocks_ranked, 3u);
+    EXPECT_DOUBLE_EQ(fast_peer->stats.arrival_lag_ms, 0.0);
+    EXPECT_EQ(fast_peer->stats.priority, relay::PeerPriority::Fast);
+    EXPECT_EQ(fast_peer->stats.keepalive_interval_ms, 10u);  // 20 / 2
+    EXPECT_EQ(slow_peer->stats.blocks_first, 0u);
+    EXPECT_EQ(slow_peer->stats.blocks_ranked, 3u);
+    EXPECT_GE(slow_peer->stats.arrival_lag_ms, 20.0);
+    EXPECT_EQ(slow_peer->stats.priority, relay::PeerPriority::Slow);
+    EXPECT_EQ(slow_peer->state, relay::PeerState::Disconnected);
+    EXPECT_EQ(manager.connected_peer_count(), 1u);
+    manager.stop();
+}
+
+} // namespace quaxis::tests
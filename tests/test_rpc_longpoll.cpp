@@ -0,0 +1,240 @@
+/**
+ * @file test_rpc_longpoll.cpp
+ * @brief Тесты getblocktemplate longpoll (RpcLongPoller)
+ */
+
+#include <gtest/gtest.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bitcoin/rpc_client.hpp"
+
+namespace quaxis::tests {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using namespace std::chrono_literals;
+
+/**
+ * @brief Локальный узел с longpoll
+ *
+ * Запрос без longpollid получает tip 0x11 и longpollid "lp1"; запрос с
+ * "lp1" держится hold и получает tip 0x22 и "lp2"; запрос с "lp2"
+ * держится до разрушения узла.
+ */
+class FakeLongpollNode {
+public:
+    explicit FakeLongpollNode(std::chrono::milliseconds hold) : hold_(hold) {
+        fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        EXPECT_EQ(::bind(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0);
+        EXPECT_EQ(::listen(fd_, 8), 0);
+        socklen_t len = sizeof(addr);
+        ::getsockname(fd_, reinterpret_cast<sockaddr*>(&addr), &len);
+        port_ = ntohs(addr.sin_port);
+        thread_ = std::thread([this] { serve(); });
+    }
+
+    ~FakeLongpollNode() {
+        stop_ = true;
+        ::shutdown(fd_, SHUT_RDWR);
+        ::close(fd_);
+        thread_.join();
+    }
+
+    [[nodiscard]] bitcoin::RpcConfig config() const {
+        bitcoin::RpcConfig config;
+        config.host = "127.0.0.1";
+        config.port = port_;
+        config.longpoll_timeout = 30;
+        return config;
+    }
+
+    [[nodiscard]] std::vector<std::string> requests() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return requests_;
+    }
+
+private:
+    void serve() {
+        while (!stop_) {
+            int client = ::accept(fd_, nullptr, nullptr);
+            if (client < 0) {
+                return;
+            }
+            const auto request = read_request(client);
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                requests_.push_back(request);
+            }
+
+            char tip = '1';
+            std::string next_id = "lp1";
+            auto until = Clock::now();
+            if (request.find(R"("longpollid":"lp1")") != std::string::npos) {
+                tip = '2';
+                next_id = "lp2";
+                until += hold_;
+            } else if (request.find(R"("longpollid":"lp2")") != std::string::npos) {
+                until = Clock::time_point::max();
+            }
+            while (!stop_ && Clock::now() < until) {
+                std::this_thread::sleep_for(5ms);
+            }
+            if (stop_) {
+                ::close(client);
+                return;
+            }
+
+            std::string body = R"({"result":{"version":536870912,"previousblockhash":")" +
+                               std::string(64, tip) +
+                               R"(","curtime":1700000000,"bits":"1d00ffff","height":)" +
+                               (tip == '1' ? "100" : "101") +
+                               R"(,"coinbasevalue":312500000,"longpollid":")" + next_id +
+                               R"("},"error":null,"id":1})";
+            std::string response = "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\n"
+                                   "Connection: close\r\nContent-Length: " +
+                                   std::to_string(body.size()) + "\r\n\r\n" + body;
+            (void)::send(client, response.data(), response.size(), MSG_NOSIGNAL);
+            ::close(client);
+        }
+    }
+
+    static std::string read_request(int client) {
+        std::string request;
+        char buffer[1024];
+        while (true) {
+            auto header_end = request.find("\r\n\r\n");
+            if (header_end != std::string::npos) {
+                auto pos = request.find("Content-Length: ");
+                std::size_t length = pos == std::string::npos
+                    ? 0 : std::stoul(request.substr(pos + 16));
+                if (request.size() >= header_end + 4 + length) {
+                    return request;
+                }
+            }
+            auto n = ::recv(client, buffer, sizeof(buffer), 0);
+            if (n <= 0) {
+                return request;
+            }
+            request.append(buffer, static_cast<std::size_t>(n));
+        }
+    }
+
+    std::chrono::milliseconds hold_;
+    int fd_{-1};
+    uint16_t port_{0};
+    std::atomic<bool> stop_{false};
+    std::thread thread_;
+    mutable std::mutex mutex_;
+    std::vector<std::string> requests_;
+};
+
+/**
+ * @brief Дождаться условия (не дольше 5 секунд)
+ */
+template<typename Pred>
+bool wait_until(Pred&& pred) {
+    auto deadline = Clock::now() + 5s;
+    while (!pred()) {
+        if (Clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(1ms);
+    }
+    return true;
+}
+
+} // anonymous namespace
+
+/**
+ * @brief Тест: новый шаблон приходит по ответу longpoll, без интервала опроса
+ */
+TEST(RpcLongPollerTest, DeliversTemplateWhenNodeReleasesLongpoll) {
+    FakeLongpollNode node(300ms);
+    bitcoin::RpcLongPoller poller(node.config());
+
+    std::mutex mutex;
+    std::vector<std::pair<bitcoin::BlockTemplateData, Clock::time_point>> templates;
+    poller.set_callback([&](const bitcoin::BlockTemplateData& data) {
+        std::lock_guard<std::mutex> lock(mutex);
+        templates.emplace_back(data, Clock::now());
+    });
+    poller.start();
+
+    ASSERT_TRUE(wait_until([&] { return poller.templates_received() == 2; }));
+    EXPECT_TRUE(poller.is_connected());
+    EXPECT_TRUE(poller.is_longpolling());
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ASSERT_EQ(templates.size(), 2u);
+        EXPECT_EQ(templates[0].first.height, 100u);
+        EXPECT_EQ(templates[0].first.longpollid, "lp1");
+        EXPECT_EQ(templates[1].first.height, 101u);
+        EXPECT_EQ(templates[1].first.bits, 0x1d00ffffu);
+        EXPECT_NE(templates[0].first.prev_blockhash, templates[1].first.prev_blockhash);
+        // Второй шаблон - ответ на висящий запрос, а не повторный опрос
+        EXPECT_GE(templates[1].second - templates[0].second, 250ms);
+    }
+
+    // Третий запрос висит на "lp2"
+    ASSERT_TRUE(wait_until([&] { return node.requests().size() == 3; }));
+    const auto requests = node.requests();
+    EXPECT_EQ(requests[0].find("longpollid"), std::string::npos);
+    EXPECT_NE(requests[1].find(R"("longpollid":"lp1")"), std::string::npos);
+    EXPECT_NE(requests[2].find(R"("longpollid":"lp2")"), std::string::npos);
+
+    poller.stop();
+    EXPECT_FALSE(poller.is_running());
+}
+
+/**
+ * @brief Тест: stop() прерывает висящий longpoll, не дожидаясь таймаута
+ */
+TEST(RpcLongPollerTest, StopAbortsPendingLongpoll) {
+    FakeLongpollNode node(0ms);
+    bitcoin::RpcLongPoller poller(node.config());
+    poller.set_callback([](const bitcoin::BlockTemplateData&) {});
+    poller.start();
+
+    ASSERT_TRUE(wait_until([&] { return node.requests().size() == 3; }));
+    std::this_thread::sleep_for(50ms);
+
+    auto start = Clock::now();
+    poller.stop();
+    EXPECT_LT(Clock::now() - start, 2s);
+    EXPECT_EQ(poller.templates_received(), 2u);
+}
+
+/**
+ * @brief Тест: недоступный узел - не connected, поток продолжает попытки
+ */
+TEST(RpcLongPollerTest, UnreachableNodeIsNotConnected) {
+    bitcoin::RpcConfig config;
+    config.host = "127.0.0.1";
+    config.port = 1;
+    config.longpoll_timeout = 1;
+    bitcoin::RpcLongPoller poller(config);
+    poller.start();
+    std::this_thread::sleep_for(100ms);
+    EXPECT_TRUE(poller.is_running());
+    EXPECT_FALSE(poller.is_connected());
+    EXPECT_EQ(poller.templates_received(), 0u);
+    poller.stop();
+}
+
+} // namespace quaxis::tests
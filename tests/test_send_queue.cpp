@@ -0,0 +1,134 @@
+/**
+ * @file test_send_queue.cpp
+ * @brief Тесты очереди отправки со слиянием устаревших кадров
+ */
+
+#include <gtest/gtest.h>
+
+#include <sys/socket.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <vector>
+
+#include "network/protocol.hpp"
+#include "network/send_queue.hpp"
+
+namespace quaxis::tests {
+
+namespace {
+
+/// @brief Кадр команды с payload из size байт value
+Bytes frame(network::Command command, std::size_t size, uint8_t value = 0) {
+    Bytes data(1 + size, value);
+    data[0] = static_cast<uint8_t>(command);
+    return data;
+}
+
+/// @brief Неблокирующая пара сокетов
+struct SocketPair {
+    int fds[2] = {-1, -1};
+
+    SocketPair() {
+        EXPECT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+        fcntl(fds[0], F_SETFL, fcntl(fds[0], F_GETFL, 0) | O_NONBLOCK);
+        fcntl(fds[1], F_SETFL, fcntl(fds[1], F_GETFL, 0) | O_NONBLOCK);
+    }
+
+    ~SocketPair() {
+        close(fds[0]);
+        close(fds[1]);
+    }
+
+    Bytes read_all() const {
+        Bytes out;
+        uint8_t buffer[4096];
+        ssize_t n;
+        while ((n = read(fds[1], buffer, sizeof(buffer))) > 0) {
+            out.insert(out.end(), buffer, buffer + n);
+        }
+        return out;
+    }
+};
+
+} // anonymous namespace
+
+TEST(SendQueueTest, NewJobSupersedesPendingJobWork) {
+    network::SendQueue queue;
+    const Bytes old_job = frame(network::Command::NewJob, 48, 0xA1);
+    const Bytes difficulty = frame(network::Command::SetDifficulty, 4, 0x05);
+    const Bytes new_job = frame(network::Command::NewJobSlots, 93, 0xB2);
+    const Bytes target = frame(network::Command::SetTarget, 32, 0x22);
+
+    EXPECT_TRUE(queue.push(old_job));
+    EXPECT_TRUE(queue.push(frame(network::Command::QueueJob, 48, 0xA2)));
+    EXPECT_TRUE(queue.push(network::serialize_update_time(1, 1700000001)));
+    EXPECT_TRUE(queue.push(difficulty));
+    EXPECT_TRUE(queue.push(frame(network::Command::SetTarget, 32, 0x11)));
+    EXPECT_TRUE(queue.push(frame(network::Command::Stop, 0)));
+    EXPECT_TRUE(queue.push(new_job));
+    EXPECT_TRUE(queue.push(target));
+    EXPECT_TRUE(queue.push(frame(network::Command::Stop, 0)));
+
+    // Прежнее задание, его очередь и timestamp вытеснены, target и Stop - последние
+    EXPECT_EQ(queue.superseded_jobs(), 1u);
+    ASSERT_EQ(queue.size(), 4u);
+
+    SocketPair sockets;
+    Bytes expected = difficulty;
+    expected.insert(expected.end(), new_job.begin(), new_job.end());
+    expected.insert(expected.end(), target.begin(), target.end());
+    expected.push_back(static_cast<uint8_t>(network::Command::Stop));
+
+    EXPECT_EQ(queue.write_to(sockets.fds[0]), static_cast<ssize_t>(expected.size()));
+    EXPECT_TRUE(queue.empty());
+    EXPECT_EQ(sockets.read_all(), expected);
+}
+
+TEST(SendQueueTest, PartiallySentFrameIsKept) {
+    network::SendQueue queue;
+    const Bytes rest = {0x01, 0x02, 0x03};
+
+    // Остаток задания, ушедшего мимо очереди, не вытесняется следующим
+    queue.push_front_partial(rest);
+    const Bytes job = frame(network::Command::NewJob, 48, 0x33);
+    EXPECT_TRUE(queue.push(job));
+    EXPECT_EQ(queue.superseded_jobs(), 0u);
+    ASSERT_EQ(queue.size(), 2u);
+
+    SocketPair sockets;
+    ASSERT_GT(queue.write_to(sockets.fds[0]), 0);
+    Bytes expected = rest;
+    expected.insert(expected.end(), job.begin(), job.end());
+    EXPECT_EQ(sockets.read_all(), expected);
+}
+
+TEST(SendQueueTest, BoundedButJobsStillReplace) {
+    network::SendQueue queue(2);
+
+    EXPECT_TRUE(queue.push(frame(network::Command::NewJob, 48, 1)));
+    EXPECT_TRUE(queue.push(frame(network::Command::Heartbeat, 0)));
+    EXPECT_FALSE(queue.push(frame(network::Command::Heartbeat, 0)));
+
+    // Новое задание занимает место прежнего
+    EXPECT_TRUE(queue.push(frame(network::Command::NewJob, 48, 2)));
+    EXPECT_EQ(queue.size(), 2u);
+    EXPECT_EQ(queue.superseded_jobs(), 1u);
+}
+
+TEST(SendQueueTest, BurstLongerThanIovLimit) {
+    network::SendQueue queue;
+    Bytes expected;
+    for (std::size_t i = 0; i < network::SendQueue::MAX_IOV * 3 + 1; ++i) {
+        auto data = frame(network::Command::SetDifficulty, 4, static_cast<uint8_t>(i));
+        expected.insert(expected.end(), data.begin(), data.end());
+        ASSERT_TRUE(queue.push(std::move(data)));
+    }
+
+    SocketPair sockets;
+    EXPECT_EQ(queue.write_to(sockets.fds[0]), static_cast<ssize_t>(expected.size()));
+    EXPECT_TRUE(queue.empty());
+    EXPECT_EQ(sockets.read_all(), expected);
+}
+
+} // namespace quaxis::tests
@@ -0,0 +1,751 @@
+/**
+ * @file test_server.cpp
+ * @brief Tests for network::Server engines
+ *
+ * Loopback round trip (job out, share in, disconnect) for both the
+ * thread-per-connection engine and the epoll reactor, plus the io_uring
+ * batched job fan-out.
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <poll.h>
+
+#include "network/server.hpp"
+#include "network/protocol.hpp"
+#include "network/uring_sender.hpp"
+#include "network/socket_tuning.hpp"
+#include "mining/job_manager.hpp"
+#include "bitcoin/coinbase.hpp"
+#include "core/byte_order.hpp"
+#include "core/constants.hpp"
+#include "core/executor.hpp"
+
+namespace quaxis::tests {
+
+namespace {
+
+/// @brief Ждать условие не дольше timeout
+template<typename Pred>
+bool wait_for(Pred pred, std::chrono::milliseconds timeout = std::chrono::milliseconds(3000)) {
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (!pred()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return true;
+}
+
+int connect_loopback(uint16_t port) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+    if (connect(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/// @brief Прочитать ровно size байт (с таймаутом)
+bool recv_exact(int fd, uint8_t* out, std::size_t size) {
+    std::size_t got = 0;
+    while (got < size) {
+        struct pollfd pfd{fd, POLLIN, 0};
+        if (poll(&pfd, 1, 3000) <= 0) {
+            return false;
+        }
+        ssize_t n = recv(fd, out + got, size - got, 0);
+        if (n <= 0) {
+            return false;
+        }
+        got += static_cast<std::size_t>(n);
+    }
+    return true;
+}
+
+} // anonymous namespace
+
+class ServerEngineTest : public ::testing::TestWithParam<const char*> {
+protected:
+    void SetUp() override {
+        Hash160 pubkey_hash{};
+        pubkey_hash.fill(0x22);
+        job_manager_ = std::make_unique<mining::JobManager>(MiningConfig{}, bitcoin::CoinbaseBuilder(pubkey_hash));
+
+        // Свой порт на каждый engine, чтобы прогоны не пересекались
+        port_ = static_cast<uint16_t>(std::string(GetParam()) == "epoll" ? 43391 : 43392);
+
+        ServerConfig config;
+        config.bind_address = "127.0.0.1";
+        config.port = port_;
+        config.engine = GetParam();
+        config.worker_threads = 2;
+
+        server_ = std::make_unique<network::Server>(config, *job_manager_);
+        ASSERT_TRUE(server_->start().has_value());
+    }
+
+    void TearDown() override {
+        if (server_) {
+            server_->stop();
+        }
+    }
+
+    uint16_t port_ = 0;
+    std::unique_ptr<mining::JobManager> job_manager_;
+    std::unique_ptr<network::Server> server_;
+};
+
+/**
+ * @brief Test: job broadcast, share receipt and disconnect through the engine
+ */
+TEST_P(ServerEngineTest, RoundTrip) {
+    int fd = connect_loopback(port_);
+    ASSERT_GE(fd, 0);
+    ASSERT_TRUE(wait_for([&] { return server_->connection_count() == 1; }));
+    EXPECT_EQ(job_manager_->active_connection_count(), 1u);
+
+    // Сервер -> ASIC
+    mining::Job job;
+    job.job_id = 0x01020304;
+    job.bits = 0x1705ae3a;
+    server_->broadcast_job(job);
+
+    std::array<uint8_t, 1 + constants::JOB_MESSAGE_SIZE> frame{};
+    ASSERT_TRUE(recv_exact(fd, frame.data(), frame.size()));
+    EXPECT_EQ(frame[0], static_cast<uint8_t>(network::Command::NewJob));
+    EXPECT_EQ(read_le32(frame.data() + 1 + 44), job.job_id);
+
+    // ASIC -> сервер
+    network::ShareMessage share{mining::Share{job.job_id, 42}};
+    auto data = share.serialize();
+    ASSERT_EQ(send(fd, data.data(), data.size(), 0), static_cast<ssize_t>(data.size()));
+    EXPECT_TRUE(wait_for([&] { return server_->stats().total_shares == 1; }));
+
+    // Отключение снимает extranonce и удаляет соединение
+    close(fd);
+    EXPECT_TRUE(wait_for([&] { return job_manager_->active_connection_count() == 0; }));
+    EXPECT_TRUE(wait_for([&] { return server_->connection_count() == 0; }));
+}
+
+INSTANTIATE_TEST_SUITE_P(Engines, ServerEngineTest, ::testing::Values("threaded", "epoll"));
+
+/**
+ * @brief Test: SO_REUSEPORT listeners accept a burst and each connection gets its job
+ */
+TEST_P(ServerEngineTest, ReusePortListenersAcceptBurst) {
+    Hash160 pubkey_hash{};
+    pubkey_hash.fill(0x33);
+    mining::JobManager job_manager(MiningConfig{}, bitcoin::CoinbaseBuilder(pubkey_hash));
+    
+    ServerConfig config;
+    config.bind_address = "127.0.0.1";
+    config.port = static_cast<uint16_t>(std::string(GetParam()) == "epoll" ? 43396 : 43397);
+    config.engine = GetParam();
+    config.worker_threads = 1;
+    config.listeners = 3;
+    config.listen_backlog = 64;
+    config.max_connections = 64;
+    
+    network::Server server(config, job_manager);
+    ASSERT_TRUE(server.start().has_value());
+    
+    constexpr std::size_t clients = 24;
+    std::vector<int> fds;
+    for (std::size_t i = 0; i < clients; ++i) {
+        int fd = connect_loopback(config.port);
+        ASSERT_GE(fd, 0);
+        fds.push_back(fd);
+    }
+    ASSERT_TRUE(wait_for([&] { return server.connection_count() == clients; }));
+    EXPECT_EQ(job_manager.active_connection_count(), clients);
+    
+    // Задание доходит до каждого соединения, каким бы сокетом оно ни пришло
+    mining::Job job;
+    job.job_id = 0x0A0B0C0D;
+    server.broadcast_job(job);
+    for (int fd : fds) {
+        std::array<uint8_t, 1 + constants::JOB_MESSAGE_SIZE> frame{};
+        ASSERT_TRUE(recv_exact(fd, frame.data(), frame.size()));
+        EXPECT_EQ(read_le32(frame.data() + 1 + 44), job.job_id);
+        close(fd);
+    }
+    
+    EXPECT_TRUE(wait_for([&] { return job_manager.active_connection_count() == 0; }));
+    server.stop();
+}
+
+/**
+ * @brief Test: with a shared executor the cleanup tick runs on its timer wheel
+ */
+TEST(ServerExecutorTest, CleanupRunsOnExecutorTimer) {
+    Hash160 pubkey_hash{};
+    pubkey_hash.fill(0x55);
+    mining::JobManager job_manager(MiningConfig{}, bitcoin::CoinbaseBuilder(pubkey_hash));
+
+    core::Executor executor(ExecutorConfig{});
+    ASSERT_TRUE(executor.start().has_value());
+
+    ServerConfig config;
+    config.bind_address = "127.0.0.1";
+    config.port = 43400;
+    config.engine = "epoll";
+    config.worker_threads = 1;
+
+    network::Server server(config, job_manager);
+    server.set_executor(&executor);
+    ASSERT_TRUE(server.start().has_value());
+
+    int fd = connect_loopback(config.port);
+    ASSERT_GE(fd, 0);
+    ASSERT_TRUE(wait_for([&] { return server.connection_count() == 1; }));
+    close(fd);
+
+    // Отключённое соединение убирает только очистка - здесь задача таймера
+    EXPECT_TRUE(wait_for([&] { return server.connection_count() == 0; }));
+    EXPECT_GT(executor.tasks_executed(), 0u);
+    server.stop();
+    executor.stop();
+}
+
+/**
+ * @brief Test: share batching is offered on connect and batched shares are accepted
+ */
+TEST(ServerShareBatchTest, NegotiatesAndAcceptsBatches) {
+    Hash160 pubkey_hash{};
+    pubkey_hash.fill(0x22);
+    mining::JobManager job_manager(MiningConfig{}, bitcoin::CoinbaseBuilder(pubkey_hash));
+    
+    ServerConfig config;
+    config.bind_address = "127.0.0.1";
+    config.port = 43394;
+    config.share_batch_size = 8;
+    config.share_batch_flush_ms = 50;
+    
+    network::Server server(config, job_manager);
+    ASSERT_TRUE(server.start().has_value());
+    
+    int fd = connect_loopback(config.port);
+    ASSERT_GE(fd, 0);
+    
+    // Первым кадром приходит предложение пакетов
+    std::array<uint8_t, network::SET_SHARE_BATCH_FRAME_SIZE> offer{};
+    ASSERT_TRUE(recv_exact(fd, offer.data(), offer.size()));
+    EXPECT_EQ(offer[0], static_cast<uint8_t>(network::Command::SetShareBatch));
+    EXPECT_EQ(offer[1], 8);
+    EXPECT_EQ(read_le16(offer.data() + 2), 50);
+    
+    // Пакет из 8 shares и одиночный share старого формата
+    std::vector<mining::Share> batch(8, mining::Share{1, 0});
+    std::array<uint8_t, network::MAX_SHARE_BATCH_FRAME_SIZE> frame{};
+    std::size_t size = network::encode_share_batch(batch, frame);
+    ASSERT_EQ(send(fd, frame.data(), size, 0), static_cast<ssize_t>(size));
+    
+    auto single = network::ShareMessage{mining::Share{1, 1}}.serialize();
+    ASSERT_EQ(send(fd, single.data(), single.size(), 0), static_cast<ssize_t>(single.size()));
+    
+    EXPECT_TRUE(wait_for([&] { return server.stats().total_shares == 9; }));
+    
+    close(fd);
+    server.stop();
+}
+
+/**
+ * @brief Test: vardiff sends the start difficulty and raises it for a flooding ASIC
+ */
+TEST(ServerVardiffTest, PushesDifficultyPerConnection) {
+    Hash160 pubkey_hash{};
+    pubkey_hash.fill(0x22);
+    mining::JobManager job_manager(MiningConfig{}, bitcoin::CoinbaseBuilder(pubkey_hash));
+    
+    ServerConfig config;
+    config.bind_address = "127.0.0.1";
+    config.port = 43395;
+    config.vardiff.enabled = true;
+    config.vardiff.start_difficulty = 8;
+    config.vardiff.target_shares_per_minute = 6.0;  // 1 share за 10-секундное окно
+    config.vardiff.retarget_seconds = 10;
+    
+    std::atomic<uint32_t> last_difficulty{0};
+    network::Server server(config, job_manager);
+    server.set_share_callback([&](const mining::Share&, uint32_t difficulty) {
+        last_difficulty = difficulty;
+    });
+    ASSERT_TRUE(server.start().has_value());
+    
+    int fd = connect_loopback(config.port);
+    ASSERT_GE(fd, 0);
+    
+    std::array<uint8_t, network::SET_DIFFICULTY_FRAME_SIZE> frame{};
+    ASSERT_TRUE(recv_exact(fd, frame.data(), frame.size()));
+    EXPECT_EQ(frame[0], static_cast<uint8_t>(network::Command::SetDifficulty));
+    EXPECT_EQ(read_le32(frame.data() + 1), 8u);
+    
+    // Поток shares: досрочный пересчёт на 4-м share
+    auto share = network::ShareMessage{mining::Share{1, 0}}.serialize();
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_EQ(send(fd, share.data(), share.size(), 0), static_cast<ssize_t>(share.size()));
+    }
+    EXPECT_TRUE(wait_for([&] { return server.stats().total_shares == 4; }));
+    EXPECT_EQ(last_difficulty.load(), 8u);  // Grace: сложность до повышения
+    
+    ASSERT_TRUE(recv_exact(fd, frame.data(), frame.size()));
+    EXPECT_EQ(frame[0], static_cast<uint8_t>(network::Command::SetDifficulty));
+    EXPECT_EQ(read_le32(frame.data() + 1), 32u);
+    
+    close(fd);
+    server.stop();
+}
+
+/**
+ * @brief Test: a reconnecting ASIC presenting its token keeps its extranonce
+ */
+TEST(ServerSessionTest, ResumesSessionAfterReconnect) {
+    Hash160 pubkey_hash{};
+    pubkey_hash.fill(0x22);
+    mining::JobManager job_manager(MiningConfig{}, bitcoin::CoinbaseBuilder(pubkey_hash));
+    
+    ServerConfig config;
+    config.bind_address = "127.0.0.1";
+    config.port = 43398;
+    config.session_grace_seconds = 30;
+    
+    network::Server server(config, job_manager);
+    ASSERT_TRUE(server.start().has_value());
+    
+    auto read_token = [](int fd) -> std::optional<uint64_t> {
+        std::array<uint8_t, network::SET_SESSION_FRAME_SIZE> frame{};
+        if (!recv_exact(fd, frame.data(), frame.size()) ||
+            frame[0] != static_cast<uint8_t>(network::Command::SetSession)) {
+            return std::nullopt;
+        }
+        return read_le64(frame.data() + 1);
+    };
+    
+    int fd = connect_loopback(config.port);
+    ASSERT_GE(fd, 0);
+    auto token = read_token(fd);
+    ASSERT_TRUE(token.has_value());
+    auto extranonce = job_manager.extranonce_manager().get_extranonce(1);
+    ASSERT_TRUE(extranonce.has_value());
+    
+    // Обрыв: соединение удалено, extranonce ждёт переподключения
+    close(fd);
+    ASSERT_TRUE(wait_for([&] { return server.connection_count() == 0; }));
+    EXPECT_EQ(job_manager.active_connection_count(), 1u);
+    
+    fd = connect_loopback(config.port);
+    ASSERT_GE(fd, 0);
+    auto hello = network::HelloMessage{*token, 0}.serialize();
+    ASSERT_EQ(send(fd, hello.data(), hello.size(), 0), static_cast<ssize_t>(hello.size()));
+    
+    // Сессия подтверждена прежним токеном (при позднем RSP_HELLO - после нового)
+    auto confirmed = read_token(fd);
+    ASSERT_TRUE(confirmed.has_value());
+    if (*confirmed != *token) {
+        confirmed = read_token(fd);
+    }
+    EXPECT_EQ(confirmed, token);
+    EXPECT_TRUE(wait_for([&] { return job_manager.active_connection_count() == 1; }));
+    EXPECT_EQ(job_manager.extranonce_manager().get_extranonce(1), extranonce);
+    
+    // Чужой токен - обычное подключение со своим extranonce
+    int other = connect_loopback(config.port);
+    ASSERT_GE(other, 0);
+    auto unknown = network::HelloMessage{*token + 1, 0}.serialize();
+    ASSERT_EQ(send(other, unknown.data(), unknown.size(), 0), static_cast<ssize_t>(unknown.size()));
+    auto other_token = read_token(other);
+    ASSERT_TRUE(other_token.has_value());
+    EXPECT_NE(*other_token, *token);
+    EXPECT_TRUE(wait_for([&] { return job_manager.active_connection_count() == 2; }));
+    
+    close(fd);
+    close(other);
+    ASSERT_TRUE(wait_for([&] { return server.connection_count() == 0; }));
+    
+    // Остановка освобождает extranonce припаркованных сессий
+    server.stop();
+    EXPECT_EQ(job_manager.active_connection_count(), 0u);
+}
+
+/**
+ * @brief Test: a new block goes out as one multicast datagram before the TCP jobs
+ */
+TEST(ServerMulticastTest, AnnouncesEachBlockOnce) {
+    constexpr uint16_t GROUP_PORT = 43453;
+    
+    int listener = socket(AF_INET, SOCK_DGRAM, 0);
+    ASSERT_GE(listener, 0);
+    int one = 1;
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    struct sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(GROUP_PORT);
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    ASSERT_EQ(bind(listener, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)), 0);
+    struct ip_mreq membership{};
+    inet_pton(AF_INET, "239.255.51.51", &membership.imr_multiaddr);
+    inet_pton(AF_INET, "127.0.0.1", &membership.imr_interface);
+    if (setsockopt(listener, IPPROTO_IP, IP_ADD_MEMBERSHIP, &membership, sizeof(membership)) < 0) {
+        close(listener);
+        GTEST_SKIP() << "Multicast на loopback недоступен";
+    }
+    
+    Hash160 pubkey_hash{};
+    pubkey_hash.fill(0x33);
+    bitcoin::CoinbaseBuilder builder(pubkey_hash);
+    mining::JobManager job_manager(MiningConfig{}, builder);
+    
+    ServerConfig config;
+    config.bind_address = "127.0.0.1";
+    config.port = 43399;
+    config.multicast.enabled = true;
+    config.multicast.port = GROUP_PORT;
+    config.multicast.interface = "127.0.0.1";
+    
+    network::Server server(config, job_manager);
+    ASSERT_TRUE(server.start().has_value());
+    
+    bitcoin::BlockTemplate tmpl;
+    auto [coinbase, midstate] = builder.build_with_midstate(800000, 625000000, 0);
+    tmpl.height = 800000;
+    tmpl.header.version = 0x20000000;
+    tmpl.header.bits = 0x1705ae3a;
+    tmpl.header.timestamp = 1700000000;
+    tmpl.header.prev_block.fill(0xAB);
+    tmpl.coinbase_tx = std::move(coinbase);
+    tmpl.coinbase_midstate = midstate;
+    tmpl.update_extranonce(0);
+    job_manager.on_new_block(tmpl);
+    
+    // Повторная рассылка того же шаблона датаграмму не шлёт
+    server.broadcast_job_set({});
+    server.broadcast_job_set({});
+    EXPECT_EQ(server.stats().block_notifies_sent, 1u);
+    
+    std::array<uint8_t, 512> buffer{};
+    struct pollfd pfd{listener, POLLIN, 0};
+    ASSERT_EQ(poll(&pfd, 1, 3000), 1);
+    ssize_t n = recv(listener, buffer.data(), buffer.size(), 0);
+    ASSERT_EQ(n, static_cast<ssize_t>(network::BLOCK_NOTIFY_FRAME_SIZE));
+    
+    auto notify = network::BlockNotifyMessage::deserialize(ByteSpan(buffer.data(), static_cast<std::size_t>(n)));
+    ASSERT_TRUE(notify.has_value());
+    EXPECT_EQ(notify->height, 800000u);
+    EXPECT_EQ(notify->timestamp, 1700000000u);
+    EXPECT_EQ(notify->bits, 0x1705ae3au);
+    EXPECT_TRUE(notify->flags & network::BLOCK_NOTIFY_FLAG_WORK);
+    EXPECT_EQ(notify->prev_block, tmpl.header.prev_block);
+    EXPECT_EQ(notify->coinbase_midstate, tmpl.coinbase_midstate);
+    
+    // Хвост coinbase - шаблона с нулевым extranonce: его подставляет прошивка
+    EXPECT_TRUE(std::equal(notify->coinbase_tail.begin() + constants::EXTRANONCE_SIZE,
+                           notify->coinbase_tail.end(),
+                           tmpl.coinbase_tx.begin() + constants::SHA256_BLOCK_SIZE + constants::EXTRANONCE_SIZE));
+    EXPECT_TRUE(std::all_of(notify->coinbase_tail.begin(),
+                            notify->coinbase_tail.begin() + constants::EXTRANONCE_SIZE,
+                            [](uint8_t b) { return b == 0; }));
+    
+    // Новый блок - новое поколение и новая датаграмма
+    tmpl.header.prev_block.fill(0xCD);
+    job_manager.on_new_block(tmpl);
+    server.broadcast_job_set({});
+    EXPECT_EQ(server.stats().block_notifies_sent, 2u);
+    ASSERT_EQ(poll(&pfd, 1, 3000), 1);
+    n = recv(listener, buffer.data(), buffer.size(), 0);
+    auto next = network::BlockNotifyMessage::deserialize(ByteSpan(buffer.data(), static_cast<std::size_t>(n)));
+    ASSERT_TRUE(next.has_value());
+    EXPECT_NE(next->generation, notify->generation);
+    EXPECT_EQ(next->prev_block, tmpl.header.prev_block);
+    
+    server.stop();
+    close(listener);
+}
+
+/**
+ * @brief Test: one io_uring batch writes every frame to its own socket
+ */
+TEST(UringSenderTest, BatchWritesEachFrame) {
+    network::UringSender sender(8);
+    if (!sender.start()) {
+        GTEST_SKIP() << "io_uring недоступен";
+    }
+
+    constexpr std::size_t PAIRS = 3;
+    int fds[PAIRS][2];
+    std::array<std::array<uint8_t, 49>, PAIRS> payloads{};
+    std::vector<network::UringFrame> frames;
+
+    for (std::size_t i = 0; i < PAIRS; ++i) {
+        ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds[i]), 0);
+        payloads[i].fill(static_cast<uint8_t>(0x10 + i));
+        frames.push_back({fds[i][0], ByteSpan(payloads[i])});
+    }
+
+    // Слишком длинный кадр отклоняется, остальные уходят
+    std::array<uint8_t, network::UringSender::MAX_FRAME_SIZE + 1> oversized{};
+    frames.push_back({fds[0][0], ByteSpan(oversized)});
+
+    std::vector<int> results(frames.size());
+    EXPECT_EQ(sender.submit(frames, results), PAIRS);
+    EXPECT_LT(results[PAIRS], 0);
+
+    for (std::size_t i = 0; i < PAIRS; ++i) {
+        EXPECT_EQ(results[i], 49);
+        std::array<uint8_t, 49> got{};
+        ASSERT_TRUE(recv_exact(fds[i][1], got.data(), got.size()));
+        EXPECT_EQ(got, payloads[i]);
+        close(fds[i][0]);
+        close(fds[i][1]);
+    }
+}
+
+/**
+ * @brief Test: broadcast through io_uring reaches every connected ASIC
+ */
+TEST(ServerIoUringTest, BroadcastReachesAllClients) {
+    Hash160 pubkey_hash{};
+    pubkey_hash.fill(0x22);
+    mining::JobManager job_manager(MiningConfig{}, bitcoin::CoinbaseBuilder(pubkey_hash));
+
+    ServerConfig config;
+    config.bind_address = "127.0.0.1";
+    config.port = 43393;
+    config.io_uring = true;
+
+    network::Server server(config, job_manager);
+    ASSERT_TRUE(server.start().has_value());
+    if (!server.io_uring_active()) {
+        server.stop();
+        GTEST_SKIP() << "io_uring недоступен";
+    }
+
+    std::vector<int> clients;
+    for (int i = 0; i < 3; ++i) {
+        clients.push_back(connect_loopback(config.port));
+        ASSERT_GE(clients.back(), 0);
+    }
+    ASSERT_TRUE(wait_for([&] { return server.connection_count() == clients.size(); }));
+
+    mining::Job job;
+    job.job_id = 77;
+    for (int round = 0; round < 2; ++round) {
+        server.broadcast_job(job);
+    }
+
+    for (int fd : clients) {
+        std::array<uint8_t, 2 * (1 + constants::JOB_MESSAGE_SIZE)> frames{};
+        ASSERT_TRUE(recv_exact(fd, frames.data(), frames.size()));
+        EXPECT_EQ(frames[0], static_cast<uint8_t>(network::Command::NewJob));
+        EXPECT_EQ(read_le32(frames.data() + 1 + 44), 77u);
+        EXPECT_EQ(frames[49], static_cast<uint8_t>(network::Command::NewJob));
+        close(fd);
+    }
+
+    server.stop();
+}
+
+/**
+ * @brief Test: a silent ASIC gets a heartbeat and is dropped without a reply
+ */
+TEST(ServerHeartbeatTest, DropsSilentConnection) {
+    Hash160 pubkey_hash{};
+    pubkey_hash.fill(0x22);
+    mining::JobManager job_manager(MiningConfig{}, bitcoin::CoinbaseBuilder(pubkey_hash));
+    
+    ServerConfig config;
+    config.bind_address = "127.0.0.1";
+    config.port = 43394;
+    config.heartbeat_interval_seconds = 1;
+    config.heartbeat_timeout_seconds = 1;
+    
+    network::Server server(config, job_manager);
+    ASSERT_TRUE(server.start().has_value());
+    
+    int fd = connect_loopback(config.port);
+    ASSERT_GE(fd, 0);
+    ASSERT_TRUE(wait_for([&] { return server.connection_count() == 1; }));
+    
+    // Шаблона нет - заданий тоже: первым кадром молчащий ASIC получает heartbeat
+    uint8_t command = 0;
+    ASSERT_TRUE(recv_exact(fd, &command, 1));
+    EXPECT_EQ(command, static_cast<uint8_t>(network::Command::Heartbeat));
+    
+    // Ответа нет: сервер рвёт соединение и удаляет его
+    EXPECT_TRUE(wait_for([&] { return server.connection_count() == 0; }, std::chrono::milliseconds(6000)));
+    EXPECT_FALSE(recv_exact(fd, &command, 1));
+    close(fd);
+    
+    server.stop();
+}
+
+/**
+ * @brief Test: ntime_roll_seconds moves the ASIC's current job forward with CMD_UPDATE_TIME
+ */
+TEST(ServerTimeRollTest, SendsUpdateTimeForCurrentJob) {
+    Hash160 pubkey_hash{};
+    pubkey_hash.fill(0x22);
+    bitcoin::CoinbaseBuilder builder(pubkey_hash);
+    mining::JobManager job_manager(MiningConfig{}, builder);
+    
+    bitcoin::BlockTemplate tmpl;
+    auto [coinbase, midstate] = builder.build_with_midstate(800000, 625000000, 0);
+    tmpl.height = 800000;
+    tmpl.header.bits = 0x1705ae3a;
+    tmpl.header.timestamp = 1700000000;
+    tmpl.coinbase_tx = std::move(coinbase);
+    tmpl.coinbase_midstate = midstate;
+    tmpl.update_extranonce(0);
+    job_manager.on_new_block(tmpl);
+    
+    ServerConfig config;
+    config.bind_address = "127.0.0.1";
+    config.port = 43402;
+    config.heartbeat_interval_seconds = 0;
+    config.ntime_roll_seconds = 1;
+    
+    network::Server server(config, job_manager);
+    ASSERT_TRUE(server.start().has_value());
+    
+    const auto before = static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+    int fd = connect_loopback(config.port);
+    ASSERT_GE(fd, 0);
+    
+    std::array<uint8_t, network::NEW_JOB_FRAME_SIZE> job_frame{};
+    ASSERT_TRUE(recv_exact(fd, job_frame.data(), job_frame.size()));
+    auto job_id = network::job_frame_id(job_frame);
+    ASSERT_TRUE(job_id.has_value());
+    
+    // Задание по шаблону из прошлого: timestamp догоняет часы
+    std::array<uint8_t, network::UPDATE_TIME_FRAME_SIZE> frame{};
+    ASSERT_TRUE(recv_exact(fd, frame.data(), frame.size()));
+    EXPECT_EQ(frame[0], static_cast<uint8_t>(network::Command::UpdateTime));
+    auto update = network::UpdateTimeMessage::deserialize(ByteSpan(frame.data() + 1, frame.size() - 1));
+    ASSERT_TRUE(update.has_value());
+    EXPECT_EQ(update->job_id, *job_id);
+    EXPECT_GE(update->timestamp, before);
+    EXPECT_FALSE(update->nonce_start.has_value());
+    
+    // JobManager знает новый timestamp: shares ASIC проверяются по нему
+    auto job = job_manager.get_job(*job_id);
+    ASSERT_TRUE(job.has_value());
+    EXPECT_GE(job->timestamp, update->timestamp);
+    
+    close(fd);
+    server.stop();
+}
+
+/**
+ * @brief Test: RSP_JOB_LOADED fills the dispatch and controller load histograms
+ */
+TEST(ServerJobLoadTest, MeasuresDispatchAndLoad) {
+    Hash160 pubkey_hash{};
+    pubkey_hash.fill(0x22);
+    mining::JobManager job_manager(MiningConfig{}, bitcoin::CoinbaseBuilder(pubkey_hash));
+    
+    ServerConfig config;
+    config.bind_address = "127.0.0.1";
+    config.port = 43401;
+    
+    network::Server server(config, job_manager);
+    ASSERT_TRUE(server.start().has_value());
+    
+    int fd = connect_loopback(config.port);
+    ASSERT_GE(fd, 0);
+    ASSERT_TRUE(wait_for([&] { return server.connection_count() == 1; }));
+    EXPECT_TRUE(server.job_load_latency().empty());  // Прошивка без RSP_JOB_LOADED
+    
+    mining::Job job;
+    job.job_id = 0x01020304;
+    job.bits = 0x1705ae3a;
+    server.broadcast_job(job);
+    
+    std::array<uint8_t, network::NEW_JOB_FRAME_SIZE> frame{};
+    ASSERT_TRUE(recv_exact(fd, frame.data(), frame.size()));
+    EXPECT_EQ(network::job_frame_id(frame), job.job_id);
+    
+    // Часы контроллера переполнились между приёмом и стартом: загрузка 250 мкс
+    auto loaded = network::JobLoadedMessage{job.job_id, 0xFFFFFF9C, 150}.serialize();
+    ASSERT_EQ(send(fd, loaded.data(), loaded.size(), 0), static_cast<ssize_t>(loaded.size()));
+    // Задание, которого сервер не отправлял: только время загрузки
+    auto unknown = network::JobLoadedMessage{77, 0, 100}.serialize();
+    ASSERT_EQ(send(fd, unknown.data(), unknown.size(), 0), static_cast<ssize_t>(unknown.size()));
+    
+    std::vector<network::JobLoadSnapshot> latency;
+    ASSERT_TRUE(wait_for([&] {
+        latency = server.job_load_latency();
+        return latency.size() == 1 && latency[0].latency.load.count() == 2;
+    }));
+    EXPECT_EQ(latency[0].latency.dispatch.count(), 1u);
+    EXPECT_GT(latency[0].latency.dispatch.max(), 0u);
+    EXPECT_EQ(latency[0].latency.load.sum(), 350'000u);
+    
+    close(fd);
+    server.stop();
+}
+
+/**
+ * @brief Test: the socket profile reaches the kernel and TCP_INFO is readable
+ */
+TEST(SocketTuningTest, AppliesProfileAndReadsTcpInfo) {
+    int listener = socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT_GE(listener, 0);
+    struct sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+    ASSERT_EQ(bind(listener, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)), 0);
+    ASSERT_EQ(listen(listener, 1), 0);
+    socklen_t length = sizeof(addr);
+    ASSERT_EQ(getsockname(listener, reinterpret_cast<struct sockaddr*>(&addr), &length), 0);
+    
+    int client = connect_loopback(ntohs(addr.sin_port));
+    ASSERT_GE(client, 0);
+    int fd = accept(listener, nullptr, nullptr);
+    ASSERT_GE(fd, 0);
+    
+    AsicSocketConfig profile;
+    profile.user_timeout_ms = 4000;
+    profile.keepalive_idle = 10;
+    profile.dscp = 46;
+    ASSERT_TRUE(network::apply_socket_tuning(fd, profile).has_value());
+    
+    auto option = [&](int level, int name) {
+        int value = 0;
+        socklen_t size = sizeof(value);
+        EXPECT_EQ(getsockopt(fd, level, name, &value, &size), 0);
+        return value;
+    };
+    EXPECT_EQ(option(IPPROTO_TCP, TCP_NODELAY), 1);
+    EXPECT_EQ(option(IPPROTO_TCP, TCP_USER_TIMEOUT), 4000);
+    EXPECT_EQ(option(SOL_SOCKET, SO_KEEPALIVE), 1);
+    EXPECT_EQ(option(IPPROTO_TCP, TCP_KEEPIDLE), 10);
+    EXPECT_EQ(option(IPPROTO_IP, IP_TOS) >> 2, 46);
+    
+    auto info = network::read_tcp_info(fd);
+    ASSERT_TRUE(info.has_value());
+    EXPECT_EQ(info->retransmits, 0u);
+    EXPECT_FALSE(network::read_tcp_info(-1).has_value());
+    
+    close(fd);
+    close(client);
+    close(listener);
+}
+
+} // namespace quaxis::tests
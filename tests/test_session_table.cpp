@@ -0,0 +1,85 @@
+/**
+ * @file test_session_table.cpp
+ * @brief Тесты таблицы сессий ASIC
+ */
+
+#include <gtest/gtest.h>
+
+#include "network/session_table.hpp"
+
+namespace quaxis::tests {
+
+using network::ParkResult;
+using network::SessionTable;
+
+TEST(SessionTableTest, ParkedSessionResumesWithinGrace) {
+    SessionTable sessions(std::chrono::seconds(10));
+    ASSERT_TRUE(sessions.enabled());
+    const auto now = SessionTable::Clock::now();
+
+    const uint64_t token = sessions.open(7);
+    EXPECT_NE(token, 0u);
+    EXPECT_NE(sessions.open(8), token);
+
+    EXPECT_EQ(sessions.park(token, 0, now), ParkResult::Parked);
+    EXPECT_EQ(sessions.parked_count(), 1u);
+    EXPECT_TRUE(sessions.expire(now + std::chrono::seconds(9)).empty());
+
+    auto resumed = sessions.resume(token, now + std::chrono::seconds(9));
+    ASSERT_TRUE(resumed.has_value());
+    EXPECT_EQ(resumed->connection_id, 7u);
+    EXPECT_EQ(resumed->epoch, 1u);
+    EXPECT_EQ(sessions.parked_count(), 0u);
+
+    // Неизвестный токен - обычное подключение
+    EXPECT_FALSE(sessions.resume(token + 1, now).has_value());
+    EXPECT_EQ(sessions.park(token + 1, 0, now), ParkResult::Unknown);
+}
+
+TEST(SessionTableTest, ExpiredSessionReleasesConnection) {
+    SessionTable sessions(std::chrono::seconds(5));
+    const auto now = SessionTable::Clock::now();
+
+    const uint64_t token = sessions.open(3);
+    EXPECT_EQ(sessions.park(token, 0, now), ParkResult::Parked);
+
+    // После grace сессия не возобновляется, а expire() отдаёт её ID
+    EXPECT_FALSE(sessions.resume(token, now + std::chrono::seconds(5)).has_value());
+    EXPECT_EQ(sessions.expire(now + std::chrono::seconds(5)), std::vector<uint32_t>{3});
+    EXPECT_EQ(sessions.size(), 0u);
+    EXPECT_EQ(sessions.park(token, 0, now), ParkResult::Unknown);
+}
+
+TEST(SessionTableTest, LiveSessionTakenOverByReconnect) {
+    SessionTable sessions(std::chrono::seconds(10));
+    const auto now = SessionTable::Clock::now();
+
+    // Сервер ещё не заметил обрыва: новое соединение забирает живую сессию
+    const uint64_t token = sessions.open(5);
+    auto resumed = sessions.resume(token, now);
+    ASSERT_TRUE(resumed.has_value());
+    EXPECT_EQ(resumed->connection_id, 5u);
+
+    // Отключение прежнего соединения сессию не трогает
+    EXPECT_EQ(sessions.park(token, 0, now), ParkResult::Superseded);
+    EXPECT_EQ(sessions.parked_count(), 0u);
+    EXPECT_EQ(sessions.park(token, resumed->epoch, now), ParkResult::Parked);
+}
+
+TEST(SessionTableTest, ExpireOneTouchesOnlyItsSession) {
+    SessionTable sessions(std::chrono::seconds(5));
+    const auto now = SessionTable::Clock::now();
+    const uint64_t parked = sessions.open(7);
+    const uint64_t live = sessions.open(8);
+    ASSERT_EQ(sessions.park(parked, 0, now), ParkResult::Parked);
+    
+    // До конца grace и для живой сессии - ничего
+    EXPECT_FALSE(sessions.expire_one(parked, now + std::chrono::seconds(4)).has_value());
+    EXPECT_FALSE(sessions.expire_one(live, now + std::chrono::seconds(60)).has_value());
+    
+    EXPECT_EQ(sessions.expire_one(parked, now + std::chrono::seconds(5)), std::optional<uint32_t>{7});
+    EXPECT_FALSE(sessions.expire_one(parked, now + std::chrono::seconds(5)).has_value());
+    EXPECT_EQ(sessions.size(), 1u);
+}
+
+} // namespace quaxis::tests
@@ -11,6 +11,7 @@
 #include <string>
 #include <cstring>
 #include <span>
+#include <vector>
 
 #include "crypto/sha256.hpp"
 #include "core/types.hpp"
@@ -196,4 +197,215 @@ TEST_F(SHA256Test, BitcoinBlockHeader) {
     SUCCEED();
 }
 
+/**
+ * @brief Тест: hash_header_with_midstate совпадает с полным SHA256d
+ */
+TEST_F(SHA256Test, HeaderWithMidstateMatchesFullHash) {
+    std::array<uint8_t, 80> header{};
+    for (size_t i = 0; i < header.size(); ++i) {
+        header[i] = static_cast<uint8_t>(i * 7 + 3);
+    }
+    
+    auto midstate = crypto::compute_midstate(header.data());
+    auto hash = crypto::hash_header_with_midstate(
+        midstate, std::span<const uint8_t, 16>(header.data() + 64, 16));
+    
+    EXPECT_EQ(hash, crypto::sha256d(ByteSpan{header.data(), header.size()}));
+}
+
+/**
+ * @brief Тест: специализированные transform generic и SHA-NI совпадают с полным SHA256d
+ * 
+ * Хвосты с крайними значениями слов (0, 0xFFFFFFFF) и разные midstate.
+ */
+TEST_F(SHA256Test, SpecializedHeaderHashMatchesBothImplementations) {
+    for (uint32_t n = 0; n < 64; ++n) {
+        std::array<uint8_t, 80> header{};
+        for (size_t i = 0; i < header.size(); ++i) {
+            header[i] = static_cast<uint8_t>((i * 131 + n * 29) ^ (n << 3));
+        }
+        if (n % 4 == 1) {
+            std::memset(header.data() + 64, 0x00, 16);
+        } else if (n % 4 == 2) {
+            std::memset(header.data() + 64, 0xFF, 16);
+        }
+        
+        auto midstate = crypto::compute_midstate(header.data());
+        std::span<const uint8_t, 16> tail(header.data() + 64, 16);
+        auto expected = crypto::sha256d(ByteSpan{header.data(), header.size()});
+        
+        EXPECT_EQ(crypto::hash_header_with_midstate(midstate, tail, crypto::Sha256Implementation::Generic),
+                  expected) << "header " << n;
+        EXPECT_EQ(crypto::hash_header_with_midstate(midstate, tail, crypto::Sha256Implementation::ShaNi),
+                  expected) << "header " << n << " (sha-ni: " << crypto::has_sha_ni_support() << ")";
+        EXPECT_EQ(crypto::hash_header_with_midstate(midstate, tail, crypto::Sha256Implementation::ArmSha2),
+                  expected) << "header " << n << " (arm-sha2: " << crypto::has_arm_sha2_support() << ")";
+    }
+}
+
+/**
+ * @brief Тест: продолжение хеширования с midstate совпадает с полным хешем
+ */
+TEST_F(SHA256Test, ResumeFromMidstate) {
+    for (size_t len : {size_t{64}, size_t{110}, size_t{119}, size_t{128}, size_t{200}}) {
+        std::vector<uint8_t> data(len);
+        for (size_t i = 0; i < len; ++i) {
+            data[i] = static_cast<uint8_t>(i ^ 0x5C);
+        }
+        
+        auto midstate = crypto::compute_midstate(data.data());
+        ByteSpan tail{data.data() + 64, len - 64};
+        
+        EXPECT_EQ(crypto::sha256_resume(midstate, 64, tail), crypto::sha256(data)) << "len " << len;
+        EXPECT_EQ(crypto::sha256d_resume(midstate, 64, tail), crypto::sha256d(data)) << "len " << len;
+    }
+}
+
+/**
+ * @brief Тест: пакетное хеширование совпадает со скалярным
+ * 
+ * Размеры подобраны так, чтобы задеть полные векторы (8/16 линий)
+ * и скалярный остаток.
+ */
+TEST_F(SHA256Test, BatchMatchesScalar) {
+    for (size_t count : {size_t{1}, size_t{7}, size_t{8}, size_t{15}, size_t{16}, size_t{33}}) {
+        std::vector<crypto::Sha256State> midstates(count);
+        std::vector<crypto::HeaderTail> tails(count);
+        std::vector<Hash256> out(count);
+        
+        for (size_t n = 0; n < count; ++n) {
+            std::array<uint8_t, 64> first{};
+            for (size_t i = 0; i < first.size(); ++i) {
+                first[i] = static_cast<uint8_t>(n * 31 + i);
+            }
+            midstates[n] = crypto::compute_midstate(first.data());
+            for (size_t i = 0; i < 16; ++i) {
+                tails[n][i] = static_cast<uint8_t>(n * 17 + i * 5);
+            }
+        }
+        
+        auto done = crypto::hash_headers_with_midstate_batch(midstates, tails, out);
+        ASSERT_EQ(done, count);
+        
+        for (size_t n = 0; n < count; ++n) {
+            EXPECT_EQ(out[n], crypto::hash_header_with_midstate(midstates[n], tails[n]))
+                << "lane " << n << " of " << count
+                << " (" << crypto::get_batch_implementation_name() << ")";
+        }
+    }
+}
+
+/**
+ * @brief Тест: пакетное хеширование ограничено самым коротким входом
+ */
+TEST_F(SHA256Test, BatchUsesShortestSpan) {
+    std::vector<crypto::Sha256State> midstates(10, constants::SHA256_INIT);
+    std::vector<crypto::HeaderTail> tails(10);
+    std::vector<Hash256> out(4);
+    
+    EXPECT_EQ(crypto::hash_headers_with_midstate_batch(midstates, tails, out), 4u);
+    
+    const auto lanes = crypto::get_sha256_batch_lanes();
+    EXPECT_TRUE(lanes == 1 || lanes == 8 || lanes == 16);
+}
+
+/**
+ * @brief Тест: SHA256d пачки 64-байтных сообщений совпадает с sha256d
+ * 
+ * Размеры покрывают полные четвёрки и остатки по 2 и по 1.
+ */
+TEST_F(SHA256Test, Sha256d64BatchMatchesSha256d) {
+    for (size_t count = 0; count <= 11; ++count) {
+        std::vector<uint8_t> in(count * 64);
+        for (size_t i = 0; i < in.size(); ++i) {
+            in[i] = static_cast<uint8_t>(i * 7 + count * 13);
+        }
+        std::vector<Hash256> out(count);
+        
+        ASSERT_EQ(crypto::sha256d64_batch(in, out), count);
+        for (size_t n = 0; n < count; ++n) {
+            EXPECT_EQ(out[n], crypto::sha256d(ByteSpan(in.data() + n * 64, 64)))
+                << "message " << n << " of " << count;
+        }
+    }
+    
+    // Неполное сообщение не хешируется
+    std::vector<uint8_t> partial(64 * 2 + 10);
+    std::vector<Hash256> out(4);
+    EXPECT_EQ(crypto::sha256d64_batch(partial, out), 2u);
+}
+
+/**
+ * @brief Тест: пакетное сжатие с шагом между блоками совпадает с sha256_transform
+ */
+TEST_F(SHA256Test, TransformBatchMatchesScalar) {
+    constexpr size_t stride = 96;
+    for (size_t count : {size_t{0}, size_t{5}, size_t{8}, size_t{16}, size_t{27}}) {
+        std::vector<uint8_t> blocks(count * stride);
+        for (size_t i = 0; i < blocks.size(); ++i) {
+            blocks[i] = static_cast<uint8_t>(i * 11 + count);
+        }
+        std::vector<crypto::Sha256State> states(count);
+        for (size_t n = 0; n < count; ++n) {
+            states[n] = constants::SHA256_INIT;
+            states[n][n % 8] ^= static_cast<uint32_t>(n);
+        }
+        auto expected = states;
+        
+        crypto::sha256_transform_batch(states, blocks.data(), stride);
+        for (size_t n = 0; n < count; ++n) {
+            crypto::sha256_transform(expected[n], blocks.data() + n * stride);
+            EXPECT_EQ(states[n], expected[n])
+                << "lane " << n << " of " << count
+                << " (" << crypto::get_batch_implementation_name() << ")";
+        }
+    }
+}
+
+/**
+ * @brief Тест: принудительный generic / scalar даёт те же хеши, выбор восстанавливается
+ */
+TEST_F(SHA256Test, ForcedImplementationMatchesDetected) {
+    const auto detected = crypto::get_sha256_implementation();
+    const auto detected_batch = crypto::get_sha256_batch_implementation();
+    
+    std::vector<uint8_t> data(64 * 9);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<uint8_t>(i * 7 + 3);
+    }
+    const auto expected = crypto::sha256d(data);
+    std::vector<Hash256> expected_batch(9);
+    crypto::sha256d64_batch(data, expected_batch);
+    
+    ASSERT_TRUE(crypto::set_sha256_implementation(crypto::Sha256Implementation::Generic));
+    ASSERT_TRUE(crypto::set_sha256_batch_implementation(crypto::Sha256BatchImplementation::Scalar));
+    EXPECT_EQ(crypto::get_implementation_name(), "generic");
+    EXPECT_EQ(crypto::get_batch_implementation_name(), "scalar");
+    EXPECT_EQ(crypto::sha256d(data), expected);
+    std::vector<Hash256> batch(9);
+    crypto::sha256d64_batch(data, batch);
+    EXPECT_EQ(batch, expected_batch);
+    
+    EXPECT_TRUE(crypto::set_sha256_implementation(detected));
+    EXPECT_TRUE(crypto::set_sha256_batch_implementation(detected_batch));
+    EXPECT_EQ(crypto::get_sha256_implementation(), detected);
+}
+
+/**
+ * @brief Тест: названия реализаций и отказ для недоступной
+ */
+TEST_F(SHA256Test, ImplementationNamesAndUnsupportedOverride) {
+    EXPECT_EQ(crypto::parse_sha256_implementation("sha-ni"), crypto::Sha256Implementation::ShaNi);
+    EXPECT_EQ(crypto::parse_sha256_implementation("generic"), crypto::Sha256Implementation::Generic);
+    EXPECT_EQ(crypto::parse_sha256_batch_implementation("avx512"), crypto::Sha256BatchImplementation::Avx512);
+    EXPECT_FALSE(crypto::parse_sha256_implementation("avx2").has_value());
+    EXPECT_FALSE(crypto::parse_sha256_batch_implementation("sha-ni").has_value());
+    
+    const auto detected = crypto::get_sha256_implementation();
+    if (!crypto::has_arm_sha2_support()) {
+        EXPECT_FALSE(crypto::set_sha256_implementation(crypto::Sha256Implementation::ArmSha2));
+        EXPECT_EQ(crypto::get_sha256_implementation(), detected);
+    }
+}
+
 } // namespace quaxis::tests
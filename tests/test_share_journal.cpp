@@ -0,0 +1,161 @@
+/**
+ * @file test_share_journal.cpp
+ * @brief Тесты журнала shares
+ */
+
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+
+#include <array>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "mining/share_journal.hpp"
+
+namespace quaxis::tests {
+
+namespace {
+
+/// @brief Временный каталог журнала, удаляется в деструкторе
+struct TempJournalDir {
+    std::filesystem::path path;
+
+    explicit TempJournalDir(const std::string& name)
+        : path(std::filesystem::temp_directory_path() /
+               ("quaxis_journal_" + name + "_" + std::to_string(getpid()))) {
+        std::filesystem::remove_all(path);
+    }
+    ~TempJournalDir() { std::filesystem::remove_all(path); }
+};
+
+JournalConfig journal_config(const TempJournalDir& dir, uint32_t file_mb) {
+    JournalConfig config;
+    config.enabled = true;
+    config.directory = dir.path.string();
+    config.file_mb = file_mb;
+    config.sync_ms = 10;
+    return config;
+}
+
+/// @brief Все записи всех файлов каталога
+std::vector<mining::ShareJournalRecord> read_all(const TempJournalDir& dir) {
+    std::vector<mining::ShareJournalRecord> records;
+    for (const auto& path : mining::ShareJournal::list_files(dir.path.string())) {
+        auto file = mining::ShareJournal::read_file(path);
+        EXPECT_TRUE(file.has_value()) << path;
+        if (file) {
+            records.insert(records.end(), file->begin(), file->end());
+        }
+    }
+    return records;
+}
+
+} // anonymous namespace
+
+TEST(ShareJournalTest, ConcurrentWritersKeepEveryRecord) {
+    TempJournalDir dir("concurrent");
+    mining::ShareJournal journal(journal_config(dir, 2));
+    ASSERT_TRUE(journal.start());
+
+    constexpr uint32_t THREADS = 4;
+    constexpr uint32_t PER_THREAD = 5000;
+    std::vector<std::thread> writers;
+    for (uint32_t t = 0; t < THREADS; ++t) {
+        writers.emplace_back([&journal, t] {
+            for (uint32_t i = 0; i < PER_THREAD; ++i) {
+                mining::ShareJournalRecord record;
+                record.connection_id = t + 1;
+                record.nonce = i;
+                record.share_difficulty = 512.0;
+                journal.append(record, i == 0 ? mining::JournalRecordKind::Block
+                                              : mining::JournalRecordKind::Share);
+            }
+        });
+    }
+    for (auto& writer : writers) {
+        writer.join();
+    }
+    journal.stop();
+    EXPECT_EQ(journal.records(), uint64_t{THREADS} * PER_THREAD);
+    EXPECT_EQ(journal.dropped(), 0u);
+
+    // Каждое соединение - все свои записи, внутри потока в порядке записи
+    std::array<uint32_t, THREADS> next_nonce{};
+    uint32_t blocks = 0;
+    for (const auto& record : read_all(dir)) {
+        ASSERT_GE(record.connection_id, 1u);
+        ASSERT_LE(record.connection_id, THREADS);
+        EXPECT_EQ(record.nonce, next_nonce[record.connection_id - 1]++);
+        EXPECT_EQ(record.share_difficulty, 512.0);
+        EXPECT_GT(record.time_ns, 0u);
+        blocks += record.kind == mining::JournalRecordKind::Block ? 1 : 0;
+    }
+    for (uint32_t count : next_nonce) {
+        EXPECT_EQ(count, PER_THREAD);
+    }
+    EXPECT_EQ(blocks, THREADS);
+}
+
+TEST(ShareJournalTest, RotatesToPreparedFiles) {
+    TempJournalDir dir("rotate");
+    mining::ShareJournal journal(journal_config(dir, 1));
+    ASSERT_TRUE(journal.start());
+
+    // Файл 1 МБ - 15 кусков; пауза между пачками даёт подготовить следующий
+    constexpr uint32_t BURSTS = 10;
+    constexpr uint32_t BURST = 4096;
+    for (uint32_t b = 0; b < BURSTS; ++b) {
+        for (uint32_t i = 0; i < BURST; ++i) {
+            mining::ShareJournalRecord record;
+            record.nonce = b * BURST + i;
+            journal.append(record, mining::JournalRecordKind::Share);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    }
+    journal.stop();
+
+    EXPECT_EQ(journal.records() + journal.dropped(), uint64_t{BURSTS} * BURST);
+    EXPECT_GE(mining::ShareJournal::list_files(dir.path.string()).size(), 3u);
+    EXPECT_EQ(read_all(dir).size(), journal.records());
+}
+
+TEST(ShareJournalTest, KeepsNewestFilesAndContinuesNumbering) {
+    TempJournalDir dir("prune");
+    auto config = journal_config(dir, 1);
+    config.max_files = 2;
+
+    for (int run = 0; run < 2; ++run) {
+        mining::ShareJournal journal(config);
+        ASSERT_TRUE(journal.start());
+        for (uint32_t i = 0; i < 40000; ++i) {
+            journal.append(mining::ShareJournalRecord{}, mining::JournalRecordKind::Share);
+            if (i % 4096 == 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(30));
+            }
+        }
+        journal.stop();
+    }
+
+    // Второй запуск пишет в файлы после первого, старые удалены
+    const auto files = mining::ShareJournal::list_files(dir.path.string());
+    ASSERT_EQ(files.size(), 2u);
+    EXPECT_GE(std::filesystem::path(files.back()).filename().string(), "shares-000005.qsj");
+}
+
+TEST(ShareJournalTest, RejectsForeignFile) {
+    TempJournalDir dir("foreign");
+    std::filesystem::create_directories(dir.path);
+    const auto path = (dir.path / "shares-000000.qsj").string();
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << std::string(mining::ShareJournal::HEADER_SIZE + 64, 'x');
+    }
+    EXPECT_FALSE(mining::ShareJournal::read_file(path));
+}
+
+} // namespace quaxis::tests
@@ -0,0 +1,117 @@
+/**
+ * @file test_shm_placement.cpp
+ * @brief Тесты для размещения сегментов и потоков подписчика
+ */
+
+#include <gtest/gtest.h>
+
+#include <fcntl.h>
+#include <sched.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <string>
+
+#include "bitcoin/shm_subscriber.hpp"
+#include "shm/placement.hpp"
+
+namespace quaxis::tests {
+
+namespace {
+
+/**
+ * @brief Первый CPU из маски текущего процесса
+ */
+int first_allowed_cpu() {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) != 0) {
+        return -1;
+    }
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (CPU_ISSET(cpu, &set)) {
+            return cpu;
+        }
+    }
+    return -1;
+}
+
+} // anonymous namespace
+
+/**
+ * @brief Тест: топология всегда содержит хотя бы узел с CPU
+ */
+TEST(ShmPlacementTest, TopologyHasNodeWithCpus) {
+    auto nodes = shm::numa_nodes();
+    ASSERT_FALSE(nodes.empty());
+    EXPECT_FALSE(shm::numa_node_cpus(nodes.front()).empty());
+}
+
+/**
+ * @brief Тест: сегмент в каталоге создаётся как файл и открывается подписчиком
+ *
+ * Обычный каталог вместо hugetlbfs проверяет путь open() / unlink();
+ * длина отображения на нём не округляется.
+ */
+TEST(ShmPlacementTest, SegmentInDirectory) {
+    auto dir = std::filesystem::temp_directory_path() / ("quaxis_placement_" + std::to_string(getpid()));
+    std::filesystem::create_directories(dir);
+
+    shm::SegmentPlacement placement;
+    placement.hugetlb_dir = dir.string();
+    ASSERT_TRUE(bitcoin::create_shm_ring_segment("/quaxis_block", placement).has_value());
+    EXPECT_TRUE(std::filesystem::exists(dir / "quaxis_block"));
+
+    auto fd = shm::open_segment(placement, "/quaxis_block", O_RDONLY);
+    ASSERT_TRUE(fd.has_value());
+    EXPECT_FALSE(shm::is_hugetlbfs(*fd));
+    EXPECT_EQ(shm::segment_map_length(*fd, 100), 100u);
+    close(*fd);
+
+    ShmConfig config;
+    config.path = "/quaxis_block";
+    config.hugetlb_dir = dir.string();
+    config.sleep_us = 100;
+    bitcoin::ShmSubscriber subscriber(config);
+    ASSERT_TRUE(subscriber.start().has_value());
+    EXPECT_TRUE(subscriber.is_ring());
+    subscriber.stop();
+
+    EXPECT_TRUE(bitcoin::remove_shm_segment("/quaxis_block", placement).has_value());
+    EXPECT_FALSE(std::filesystem::exists(dir / "quaxis_block"));
+    std::filesystem::remove_all(dir);
+}
+
+/**
+ * @brief Тест: поток подписчика закрепляется на CPU, недоступный CPU - ошибка
+ */
+TEST(ShmPlacementTest, SubscriberCpuAffinity) {
+    const std::string path = "/quaxis_test_placement_" + std::to_string(getpid());
+    ASSERT_TRUE(bitcoin::create_shm_ring_segment(path).has_value());
+
+    int cpu = first_allowed_cpu();
+    ASSERT_GE(cpu, 0);
+
+    ShmConfig config;
+    config.path = path;
+    config.sleep_us = 100;
+    config.cpu_affinity = cpu;
+    {
+        bitcoin::ShmSubscriber subscriber(config);
+        EXPECT_TRUE(subscriber.start().has_value());
+        subscriber.stop();
+    }
+
+    config.cpu_affinity = CPU_SETSIZE;
+    {
+        bitcoin::ShmSubscriber subscriber(config);
+        EXPECT_FALSE(subscriber.start().has_value());
+        EXPECT_FALSE(subscriber.is_running());
+    }
+
+    EXPECT_TRUE(bitcoin::remove_shm_segment(path).has_value());
+}
+
+} // namespace quaxis::tests
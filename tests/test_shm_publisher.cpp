@@ -0,0 +1,257 @@
+/**
+ * @file test_shm_publisher.cpp
+ * @brief Тесты C ABI издателя: подписчики майнера читают то, что пишет узел
+ */
+
+#include <gtest/gtest.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "publisher/quaxis_publisher.h"
+#include "bitcoin/shm_subscriber.hpp"
+#include "bitcoin/shm_template.hpp"
+
+namespace quaxis::tests {
+
+namespace {
+
+/**
+ * @brief Блок издателя с заголовком, различимым по timestamp
+ */
+quaxis_block make_block(uint8_t state, uint32_t height, uint32_t timestamp) {
+    bitcoin::BlockHeader header;
+    header.timestamp = timestamp;
+    header.bits = 0x1d00ffff;
+
+    quaxis_block block{};
+    block.state = state;
+    block.height = height;
+    block.bits = header.bits;
+    block.timestamp = timestamp;
+    block.coinbase_value = 312'500'000;
+    auto raw = header.serialize();
+    std::memcpy(block.header, raw.data(), raw.size());
+    auto hash = header.hash();
+    std::memcpy(block.hash, hash.data(), hash.size());
+    return block;
+}
+
+/**
+ * @brief Дождаться условия (не дольше 5 секунд)
+ */
+template<typename Pred>
+bool wait_until(Pred&& pred) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!pred()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+} // anonymous namespace
+
+// =============================================================================
+// Канал блоков
+// =============================================================================
+
+/**
+ * @brief Тест: кольцо издателя доставляется подписчику без потерь переходов
+ */
+TEST(ShmPublisherTest, RingChannelFeedsSubscriber) {
+    const std::string path = "/quaxis_test_pub_ring_" + std::to_string(getpid());
+    quaxis_block_channel* channel = quaxis_block_channel_create(path.c_str(), QUAXIS_LAYOUT_RING, nullptr);
+    ASSERT_NE(channel, nullptr);
+
+    ShmConfig config;
+    config.path = path;
+    config.sleep_us = 100;
+    config.futex_wait = true;
+    bitcoin::ShmSubscriber subscriber(config);
+
+    std::mutex mutex;
+    std::vector<std::pair<uint32_t, bool>> blocks;
+    std::vector<bitcoin::ShmBlockState> states;
+    subscriber.set_callback([&](const bitcoin::BlockHeader&, uint32_t height, int64_t, bool is_speculative) {
+        std::lock_guard<std::mutex> lock(mutex);
+        blocks.emplace_back(height, is_speculative);
+    });
+    subscriber.set_state_callback([&](const Hash256&, uint32_t, bitcoin::ShmBlockState state) {
+        std::lock_guard<std::mutex> lock(mutex);
+        states.push_back(state);
+    });
+    ASSERT_TRUE(subscriber.start().has_value());
+    EXPECT_TRUE(subscriber.is_ring());
+
+    auto speculative = make_block(QUAXIS_BLOCK_SPECULATIVE, 300, 20);
+    auto confirmed = make_block(QUAXIS_BLOCK_CONFIRMED, 300, 20);
+    EXPECT_EQ(quaxis_block_publish(channel, &speculative), 1u);
+    EXPECT_EQ(quaxis_block_publish(channel, &confirmed), 2u);
+
+    // Неизвестное состояние не публикуется
+    auto empty = make_block(0, 301, 21);
+    EXPECT_EQ(quaxis_block_publish(channel, &empty), 0u);
+
+    EXPECT_TRUE(wait_until([&] { return subscriber.get_sequence() == 2; }));
+    subscriber.stop();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    ASSERT_EQ(blocks.size(), 1u);
+    EXPECT_EQ(blocks[0], std::make_pair(300u, true));
+    ASSERT_EQ(states.size(), 1u);
+    EXPECT_EQ(states[0], bitcoin::ShmBlockState::Confirmed);
+    quaxis_block_channel_close(channel, 1);
+}
+
+/**
+ * @brief Тест: одиночная раскладка читается как QuaxisSharedBlock
+ */
+TEST(ShmPublisherTest, SingleChannelFeedsSubscriber) {
+    const std::string path = "/quaxis_test_pub_block_" + std::to_string(getpid());
+    quaxis_block_channel* channel = quaxis_block_channel_create(path.c_str(), QUAXIS_LAYOUT_SINGLE, nullptr);
+    ASSERT_NE(channel, nullptr);
+
+    ShmConfig config;
+    config.path = path;
+    config.sleep_us = 100;
+    bitcoin::ShmSubscriber subscriber(config);
+    std::atomic<uint32_t> height{0};
+    subscriber.set_callback([&](const bitcoin::BlockHeader&, uint32_t h, int64_t, bool) { height = h; });
+    ASSERT_TRUE(subscriber.start().has_value());
+    EXPECT_FALSE(subscriber.is_ring());
+
+    auto block = make_block(QUAXIS_BLOCK_CONFIRMED, 400, 30);
+    EXPECT_EQ(quaxis_block_publish(channel, &block), 1u);
+    EXPECT_TRUE(wait_until([&] { return height.load() == 400; }));
+    subscriber.stop();
+
+    ASSERT_TRUE(subscriber.get_last_block().has_value());
+    EXPECT_EQ(subscriber.get_last_block()->timestamp, 30u);
+    quaxis_block_channel_close(channel, 1);
+
+    // Ошибки создания - через errno
+    EXPECT_EQ(quaxis_block_channel_create(path.c_str(), 7, nullptr), nullptr);
+    EXPECT_EQ(errno, EINVAL);
+    EXPECT_EQ(quaxis_block_channel_create("", QUAXIS_LAYOUT_RING, nullptr), nullptr);
+}
+
+// =============================================================================
+// Каналы шаблонов и отправки
+// =============================================================================
+
+/**
+ * @brief Тест: шаблон издателя совпадает с тем, что читает майнер
+ */
+TEST(ShmPublisherTest, TemplateChannelMatchesLayout) {
+    const std::string path = "/quaxis_test_pub_template_" + std::to_string(getpid());
+    quaxis_template_channel* channel = quaxis_template_channel_create(path.c_str(), nullptr);
+    ASSERT_NE(channel, nullptr);
+
+    std::vector<uint8_t> suffix(120);
+    for (std::size_t i = 0; i < suffix.size(); ++i) {
+        suffix[i] = static_cast<uint8_t>(i);
+    }
+    uint8_t branch[2][32];
+    std::memset(branch, 0xAB, sizeof(branch));
+
+    quaxis_template tmpl{};
+    tmpl.state = QUAXIS_BLOCK_SPECULATIVE;
+    tmpl.height = 500;
+    tmpl.coinbase_value = 625'000'000;
+    std::memset(tmpl.header, 0x11, sizeof(tmpl.header));
+    std::memset(tmpl.coinbase_prefix, 0x22, sizeof(tmpl.coinbase_prefix));
+    tmpl.coinbase_suffix = suffix.data();
+    tmpl.coinbase_suffix_size = suffix.size();
+    tmpl.merkle_branch = branch;
+    tmpl.merkle_branch_size = 2;
+    EXPECT_EQ(quaxis_template_publish(channel, &tmpl), 2u);
+
+    int fd = shm_open(path.c_str(), O_RDONLY, 0);
+    ASSERT_GE(fd, 0);
+    void* ptr = mmap(nullptr, sizeof(bitcoin::QuaxisSharedTemplate), PROT_READ, MAP_SHARED, fd, 0);
+    ASSERT_NE(ptr, MAP_FAILED);
+    const auto& segment = *static_cast<const bitcoin::QuaxisSharedTemplate*>(ptr);
+    EXPECT_TRUE(bitcoin::is_shm_template(segment));
+
+    bitcoin::ShmTemplateData data;
+    EXPECT_EQ(bitcoin::read_shm_template(segment, data), 2u);
+    EXPECT_EQ(data.height, 500u);
+    EXPECT_EQ(data.state, bitcoin::ShmBlockState::Speculative);
+    EXPECT_EQ(data.coinbase_value, 625'000'000);
+    EXPECT_EQ(data.header_raw[79], 0x11);
+    EXPECT_EQ(data.coinbase_prefix[63], 0x22);
+    ASSERT_EQ(data.coinbase_suffix_size, suffix.size());
+    EXPECT_EQ(std::memcmp(data.coinbase_suffix, suffix.data(), suffix.size()), 0);
+    ASSERT_EQ(data.merkle_branch_size, 2u);
+    EXPECT_EQ(data.merkle_branch[1][31], 0xAB);
+
+    // Слишком длинный хвост и состояние invalid не публикуются
+    tmpl.coinbase_suffix_size = QUAXIS_TEMPLATE_MAX_SUFFIX + 1;
+    EXPECT_EQ(quaxis_template_publish(channel, &tmpl), 0u);
+    tmpl.coinbase_suffix_size = suffix.size();
+    tmpl.state = QUAXIS_BLOCK_INVALID;
+    EXPECT_EQ(quaxis_template_publish(channel, &tmpl), 0u);
+    EXPECT_EQ(bitcoin::read_shm_template(segment, data), 2u);
+
+    munmap(ptr, sizeof(bitcoin::QuaxisSharedTemplate));
+    close(fd);
+    quaxis_template_channel_close(channel, 1);
+}
+
+/**
+ * @brief Тест: узел открывает канал отправки первым и забирает блок майнера
+ */
+TEST(ShmPublisherTest, SubmitChannelReceivesMinerBlocks) {
+    const std::string path = "/quaxis_test_pub_submit_" + std::to_string(getpid());
+    quaxis_submit_channel* channel = quaxis_submit_channel_open(path.c_str(), nullptr);
+    ASSERT_NE(channel, nullptr);
+    EXPECT_EQ(quaxis_submit_wait(channel, 0), 0);
+
+    ShmConfig config;
+    config.submit_path = path;
+    bitcoin::ShmBlockSubmitter submitter(config);
+    ASSERT_TRUE(submitter.open().has_value());
+
+    Bytes block(constants::BLOCK_HEADER_SIZE, 0x33);
+    block.push_back(0x01);
+    block.insert(block.end(), 150, 0x44);
+    Hash256 hash{};
+    hash.fill(0x5A);
+    ASSERT_TRUE(submitter.submit(block, hash).has_value());
+
+    EXPECT_EQ(quaxis_submit_wait(channel, 1'000'000), 1);
+    Bytes received;
+    const std::size_t delivered = quaxis_submit_poll(
+        channel,
+        [](void* context, const quaxis_found_block* found) {
+            auto& out = *static_cast<Bytes*>(context);
+            out.assign(found->header, found->header + QUAXIS_HEADER_SIZE);
+            out.push_back(0x01);
+            out.insert(out.end(), found->coinbase, found->coinbase + found->coinbase_size);
+            EXPECT_EQ(found->sequence, 1u);
+            EXPECT_EQ(found->hash[0], 0x5A);
+        },
+        &received);
+    EXPECT_EQ(delivered, 1u);
+    EXPECT_EQ(received, block);
+    EXPECT_EQ(submitter.pending(), 0u);
+    EXPECT_EQ(quaxis_submit_wait(channel, 0), 0);
+    EXPECT_EQ(quaxis_submit_corrupted(channel), 0u);
+
+    quaxis_submit_channel_close(channel);
+    EXPECT_TRUE(bitcoin::remove_shm_segment(path).has_value());
+}
+
+} // namespace quaxis::tests
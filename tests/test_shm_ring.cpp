@@ -0,0 +1,208 @@
+/**
+ * @file test_shm_ring.cpp
+ * @brief Тесты для кольца событий блоков в shared memory
+ */
+
+#include <gtest/gtest.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bitcoin/shm_ring.hpp"
+#include "bitcoin/shm_subscriber.hpp"
+
+namespace quaxis::tests {
+
+namespace {
+
+/**
+ * @brief Событие с заголовком, различимым по timestamp
+ */
+bitcoin::ShmBlockEvent make_event(bitcoin::ShmBlockState state, uint32_t height, uint32_t timestamp) {
+    bitcoin::BlockHeader header;
+    header.timestamp = timestamp;
+    header.bits = 0x1d00ffff;
+
+    bitcoin::ShmBlockEvent event;
+    event.state = state;
+    event.height = height;
+    event.bits = header.bits;
+    event.timestamp = timestamp;
+    event.coinbase_value = 312'500'000;
+    auto raw = header.serialize();
+    std::memcpy(event.header_raw, raw.data(), raw.size());
+    return event;
+}
+
+/**
+ * @brief Кольцо в обычной памяти
+ */
+std::unique_ptr<bitcoin::QuaxisSharedRing> make_ring() {
+    auto ring = std::make_unique<bitcoin::QuaxisSharedRing>();
+    std::memset(static_cast<void*>(ring.get()), 0, sizeof(bitcoin::QuaxisSharedRing));
+    bitcoin::init_shm_ring(*ring);
+    return ring;
+}
+
+/**
+ * @brief Дождаться условия (не дольше 5 секунд)
+ */
+template<typename Pred>
+bool wait_until(Pred&& pred) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!pred()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+} // anonymous namespace
+
+// =============================================================================
+// Тесты ShmRingReader
+// =============================================================================
+
+/**
+ * @brief Тест: события доставляются по порядку, без потерь
+ */
+TEST(ShmRingTest, DeliversEventsInOrder) {
+    auto ring = make_ring();
+    ASSERT_TRUE(bitcoin::is_shm_ring(*ring));
+
+    bitcoin::ShmRingWriter writer(*ring);
+    bitcoin::ShmRingReader reader(*ring);
+
+    writer.publish(make_event(bitcoin::ShmBlockState::Speculative, 100, 1));
+    writer.publish(make_event(bitcoin::ShmBlockState::Confirmed, 100, 1));
+    writer.publish(make_event(bitcoin::ShmBlockState::Speculative, 101, 2));
+
+    std::vector<bitcoin::ShmBlockEvent> events;
+    EXPECT_EQ(reader.drain([&](const bitcoin::ShmBlockEvent& e) { events.push_back(e); }), 3u);
+
+    ASSERT_EQ(events.size(), 3u);
+    EXPECT_EQ(events[0].sequence, 1u);
+    EXPECT_EQ(events[0].state, bitcoin::ShmBlockState::Speculative);
+    EXPECT_EQ(events[1].sequence, 2u);
+    EXPECT_EQ(events[1].state, bitcoin::ShmBlockState::Confirmed);
+    EXPECT_EQ(events[2].sequence, 3u);
+    EXPECT_EQ(events[2].height, 101u);
+    EXPECT_EQ(reader.lost_events(), 0u);
+
+    // Новых событий нет
+    EXPECT_EQ(reader.drain([](const bitcoin::ShmBlockEvent&) {}), 0u);
+}
+
+/**
+ * @brief Тест: отставание больше кольца считается overrun
+ */
+TEST(ShmRingTest, OverrunIsCounted) {
+    auto ring = make_ring();
+    bitcoin::ShmRingWriter writer(*ring);
+    bitcoin::ShmRingReader reader(*ring);
+
+    constexpr uint32_t total = bitcoin::SHM_RING_SLOTS + 5;
+    for (uint32_t i = 1; i <= total; ++i) {
+        writer.publish(make_event(bitcoin::ShmBlockState::Speculative, i, i));
+    }
+
+    std::vector<uint64_t> sequences;
+    reader.drain([&](const bitcoin::ShmBlockEvent& e) { sequences.push_back(e.sequence); });
+
+    // Сохранились последние SHM_RING_SLOTS событий, по порядку
+    ASSERT_EQ(sequences.size(), bitcoin::SHM_RING_SLOTS);
+    EXPECT_EQ(sequences.front(), total - bitcoin::SHM_RING_SLOTS + 1);
+    EXPECT_EQ(sequences.back(), total);
+    EXPECT_EQ(reader.lost_events(), 5u);
+}
+
+// =============================================================================
+// Тесты ShmSubscriber с кольцом
+// =============================================================================
+
+/**
+ * @brief Тест: speculative -> confirmed доходит как новый блок и смена состояния
+ */
+TEST(ShmRingTest, SubscriberDeliversStateTransitions) {
+    const std::string path = "/quaxis_test_ring_" + std::to_string(getpid());
+    ASSERT_TRUE(bitcoin::create_shm_ring_segment(path).has_value());
+
+    int fd = shm_open(path.c_str(), O_RDWR, 0);
+    ASSERT_GE(fd, 0);
+    void* ptr = mmap(nullptr, sizeof(bitcoin::QuaxisSharedRing), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ASSERT_NE(ptr, MAP_FAILED);
+    auto& ring = *static_cast<bitcoin::QuaxisSharedRing*>(ptr);
+    bitcoin::ShmRingWriter writer(ring);
+
+    ShmConfig config;
+    config.path = path;
+    config.sleep_us = 100;
+    bitcoin::ShmSubscriber subscriber(config);
+
+    std::mutex mutex;
+    std::vector<std::pair<uint32_t, bool>> blocks;
+    std::vector<std::pair<uint32_t, bitcoin::ShmBlockState>> states;
+    subscriber.set_callback([&](const bitcoin::BlockHeader&, uint32_t height, int64_t, bool is_speculative) {
+        std::lock_guard<std::mutex> lock(mutex);
+        blocks.emplace_back(height, is_speculative);
+    });
+    subscriber.set_state_callback([&](const Hash256&, uint32_t height, bitcoin::ShmBlockState state) {
+        std::lock_guard<std::mutex> lock(mutex);
+        states.emplace_back(height, state);
+    });
+
+    ASSERT_TRUE(subscriber.start().has_value());
+    EXPECT_TRUE(subscriber.is_ring());
+
+    // Все три события - до того, как подписчик успеет проснуться
+    writer.publish(make_event(bitcoin::ShmBlockState::Speculative, 200, 10));
+    writer.publish(make_event(bitcoin::ShmBlockState::Confirmed, 200, 10));
+    writer.publish(make_event(bitcoin::ShmBlockState::Speculative, 201, 11));
+    writer.publish(make_event(bitcoin::ShmBlockState::Invalid, 201, 11));
+
+    EXPECT_TRUE(wait_until([&] { return subscriber.get_sequence() == 4; }));
+    subscriber.stop();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    ASSERT_EQ(blocks.size(), 2u);
+    EXPECT_EQ(blocks[0], std::make_pair(200u, true));
+    EXPECT_EQ(blocks[1], std::make_pair(201u, true));
+    ASSERT_EQ(states.size(), 2u);
+    EXPECT_EQ(states[0], std::make_pair(200u, bitcoin::ShmBlockState::Confirmed));
+    EXPECT_EQ(states[1], std::make_pair(201u, bitcoin::ShmBlockState::Invalid));
+    EXPECT_EQ(subscriber.lost_events(), 0u);
+
+    munmap(ptr, sizeof(bitcoin::QuaxisSharedRing));
+    close(fd);
+    EXPECT_TRUE(bitcoin::remove_shm_segment(path).has_value());
+}
+
+/**
+ * @brief Тест: сегмент старой раскладки по-прежнему читается как одиночный блок
+ */
+TEST(ShmRingTest, SubscriberFallsBackToSingleBlock) {
+    const std::string path = "/quaxis_test_block_" + std::to_string(getpid());
+    ASSERT_TRUE(bitcoin::create_shm_segment(path).has_value());
+
+    ShmConfig config;
+    config.path = path;
+    bitcoin::ShmSubscriber subscriber(config);
+    ASSERT_TRUE(subscriber.start().has_value());
+    EXPECT_FALSE(subscriber.is_ring());
+    subscriber.stop();
+
+    EXPECT_TRUE(bitcoin::remove_shm_segment(path).has_value());
+}
+
+} // namespace quaxis::tests
@@ -0,0 +1,166 @@
+/**
+ * @file test_shm_stats.cpp
+ * @brief Тесты для сегмента статистики в shared memory
+ */
+
+#include <gtest/gtest.h>
+
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "metrics/shm_stats.hpp"
+#include "metrics/shm_stats_export.hpp"
+#include "shm/placement.hpp"
+
+namespace quaxis::tests {
+
+namespace {
+
+using metrics::QuaxisSharedStats;
+using metrics::ShmStatsConnection;
+using metrics::ShmStatsReader;
+using metrics::ShmStatsSummary;
+using metrics::ShmStatsWriter;
+
+/**
+ * @brief Сегмент в обычной памяти (раскладка та же, что в /dev/shm)
+ */
+std::unique_ptr<QuaxisSharedStats> make_segment() {
+    auto segment = std::make_unique<QuaxisSharedStats>();
+    metrics::init_shm_stats(*segment);
+    return segment;
+}
+
+ShmStatsConnection make_connection(const std::string& address, uint64_t shares) {
+    ShmStatsConnection connection;
+    metrics::copy_shm_string(connection.remote_address, address);
+    connection.shares_received = shares;
+    connection.hashrate_ghs = 100;
+    return connection;
+}
+
+} // anonymous namespace
+
+/**
+ * @brief Тест: снимок читается тем, что записано
+ */
+TEST(ShmStatsTest, RoundTrip) {
+    auto segment = make_segment();
+    ShmStatsWriter writer(*segment);
+    ShmStatsReader reader(*segment);
+
+    ShmStatsSummary summary;
+    std::vector<ShmStatsConnection> connections;
+    EXPECT_FALSE(reader.read(summary, connections));  // Публикаций ещё не было
+
+    ShmStatsSummary published;
+    published.pid = 42;
+    published.total_shares = 7;
+    published.relay_enabled = 1;
+    published.relay.blocks_received = 3;
+    metrics::append_chain_stats(published, "namecoin", 700000, 3, true, 2);
+    std::vector<ShmStatsConnection> sent = {
+        make_connection("10.0.0.1:50001", 5),
+        make_connection("10.0.0.2:50002", 2),
+    };
+    writer.publish(published, sent);
+
+    ASSERT_TRUE(reader.read(summary, connections));
+    EXPECT_EQ(reader.version(), 2u);
+    EXPECT_EQ(summary.pid, 42u);
+    EXPECT_EQ(summary.total_shares, 7u);
+    EXPECT_EQ(summary.connection_count, 2u);
+    EXPECT_EQ(summary.fallback_mode, metrics::SHM_STATS_MODE_UNKNOWN);
+    EXPECT_EQ(summary.relay.blocks_received, 3u);
+    ASSERT_EQ(summary.chain_count, 1u);
+    EXPECT_STREQ(summary.chains[0].name, "namecoin");
+    EXPECT_EQ(summary.chains[0].height, 700000u);
+    ASSERT_EQ(connections.size(), 2u);
+    EXPECT_STREQ(connections[1].remote_address, "10.0.0.2:50002");
+    EXPECT_EQ(connections[1].shares_received, 2u);
+
+    // Следующий снимок с меньшим числом соединений не оставляет старых записей
+    sent.pop_back();
+    writer.publish(published, sent);
+    ASSERT_TRUE(reader.read(summary, connections));
+    EXPECT_EQ(reader.version(), 4u);
+    EXPECT_EQ(connections.size(), 1u);
+}
+
+/**
+ * @brief Тест: соединения сверх SHM_STATS_MAX_CONNECTIONS и длинные адреса обрезаются
+ */
+TEST(ShmStatsTest, TruncatesConnectionsAndAddresses) {
+    auto segment = make_segment();
+    ShmStatsWriter writer(*segment);
+    ShmStatsReader reader(*segment);
+
+    ShmStatsSummary summary;
+    std::vector<ShmStatsConnection> connections(metrics::SHM_STATS_MAX_CONNECTIONS + 10);
+    connections.front() = make_connection(std::string(100, 'a'), 1);
+    writer.publish(summary, connections);
+
+    std::vector<ShmStatsConnection> read;
+    ASSERT_TRUE(reader.read(summary, read));
+    EXPECT_EQ(summary.connection_count, metrics::SHM_STATS_MAX_CONNECTIONS);
+    EXPECT_EQ(read.size(), metrics::SHM_STATS_MAX_CONNECTIONS);
+    EXPECT_EQ(std::string(read.front().remote_address), std::string(metrics::SHM_STATS_ADDRESS_SIZE - 1, 'a'));
+}
+
+/**
+ * @brief Тест: неразмеченная память и запись в процессе не читаются
+ */
+TEST(ShmStatsTest, RejectsUnformattedAndTornSegment) {
+    auto segment = std::make_unique<QuaxisSharedStats>();
+    ShmStatsReader reader(*segment);
+    ShmStatsSummary summary;
+    std::vector<ShmStatsConnection> connections;
+    EXPECT_FALSE(metrics::is_shm_stats(*segment));
+    EXPECT_FALSE(reader.read(summary, connections));
+
+    metrics::init_shm_stats(*segment);
+    segment->version.store(1);  // Писатель остановился посреди записи
+    EXPECT_FALSE(reader.read(summary, connections));
+}
+
+/**
+ * @brief Тест: экспортёр создаёт сегмент, публикует источники и удаляет сегмент
+ */
+TEST(ShmStatsTest, ExporterPublishesSources) {
+    const std::string path = "/quaxis_stats_test_" + std::to_string(getpid());
+    const shm::SegmentPlacement placement;
+    {
+        metrics::ShmStatsExporter exporter(path);
+        ASSERT_TRUE(exporter.open());
+        exporter.add_source([](ShmStatsSummary& summary, std::vector<ShmStatsConnection>& connections) {
+            summary.total_shares = 11;
+            connections.push_back(make_connection("127.0.0.1:3333", 11));
+        });
+        exporter.publish();
+
+        auto fd = shm::open_segment(placement, path, O_RDONLY);
+        ASSERT_TRUE(fd);
+        void* ptr = mmap(nullptr, sizeof(QuaxisSharedStats), PROT_READ, MAP_SHARED, *fd, 0);
+        close(*fd);
+        ASSERT_NE(ptr, MAP_FAILED);
+
+        ShmStatsReader reader(*static_cast<const QuaxisSharedStats*>(ptr));
+        ShmStatsSummary summary;
+        std::vector<ShmStatsConnection> connections;
+        ASSERT_TRUE(reader.read(summary, connections));
+        EXPECT_EQ(summary.total_shares, 11u);
+        EXPECT_EQ(summary.pid, static_cast<uint32_t>(getpid()));
+        EXPECT_GE(summary.updated_ns, summary.started_ns);
+        ASSERT_EQ(connections.size(), 1u);
+        EXPECT_STREQ(connections[0].remote_address, "127.0.0.1:3333");
+        munmap(ptr, sizeof(QuaxisSharedStats));
+    }
+    EXPECT_FALSE(shm::open_segment(placement, path, O_RDONLY));
+}
+
+} // namespace quaxis::tests
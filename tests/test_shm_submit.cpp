@@ -0,0 +1,141 @@
+/**
+ * @file test_shm_submit.cpp
+ * @brief Тесты для кольца отправки найденных блоков в узел
+ */
+
+#include <gtest/gtest.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bitcoin/shm_submit.hpp"
+#include "bitcoin/shm_subscriber.hpp"
+
+namespace quaxis::tests {
+
+namespace {
+
+/// @brief Блок майнера: заголовок, 0x01, coinbase из size байт
+Bytes make_block(std::size_t coinbase_size, uint8_t fill) {
+    Bytes block(constants::BLOCK_HEADER_SIZE, fill);
+    block.push_back(0x01);
+    for (std::size_t i = 0; i < coinbase_size; ++i) {
+        block.push_back(static_cast<uint8_t>(fill + i));
+    }
+    return block;
+}
+
+bitcoin::ShmSubmitEvent make_event(const Bytes& block) {
+    bitcoin::ShmSubmitEvent event;
+    std::memcpy(event.header_raw, block.data(), constants::BLOCK_HEADER_SIZE);
+    event.coinbase_size = static_cast<uint32_t>(block.size() - constants::BLOCK_HEADER_SIZE - 1);
+    std::memcpy(event.coinbase, block.data() + constants::BLOCK_HEADER_SIZE + 1, event.coinbase_size);
+    return event;
+}
+
+} // anonymous namespace
+
+TEST(ShmSubmitTest, WriterReaderRoundTrip) {
+    auto segment = std::make_unique<bitcoin::QuaxisSharedSubmit>();
+    std::memset(static_cast<void*>(segment.get()), 0, sizeof(*segment));
+    bitcoin::init_shm_submit(*segment);
+    ASSERT_TRUE(bitcoin::is_shm_submit(*segment));
+
+    bitcoin::ShmSubmitWriter writer(*segment);
+    const auto first = make_block(120, 1);
+    const auto second = make_block(300, 2);
+    auto event = make_event(first);
+    EXPECT_EQ(writer.publish(event), 1u);
+    event = make_event(second);
+    EXPECT_EQ(writer.publish(event), 2u);
+    EXPECT_EQ(writer.pending(), 2u);
+
+    // Узел, запущенный после публикации, получает оба блока по порядку
+    bitcoin::ShmSubmitReader reader(*segment);
+    std::vector<Bytes> received;
+    EXPECT_EQ(reader.drain([&](const bitcoin::ShmSubmitEvent& e) {
+        received.push_back(bitcoin::submit_event_block(e));
+    }), 2u);
+    ASSERT_EQ(received.size(), 2u);
+    EXPECT_EQ(received[0], first);
+    EXPECT_EQ(received[1], second);
+    EXPECT_EQ(writer.pending(), 0u);
+    EXPECT_EQ(reader.drain([](const bitcoin::ShmSubmitEvent&) {}), 0u);
+}
+
+TEST(ShmSubmitTest, FullRingRefusesInsteadOfOverwriting) {
+    auto segment = std::make_unique<bitcoin::QuaxisSharedSubmit>();
+    std::memset(static_cast<void*>(segment.get()), 0, sizeof(*segment));
+    bitcoin::init_shm_submit(*segment);
+
+    bitcoin::ShmSubmitWriter writer(*segment);
+    for (std::size_t i = 0; i < bitcoin::SHM_SUBMIT_SLOTS; ++i) {
+        auto event = make_event(make_block(100, static_cast<uint8_t>(i)));
+        EXPECT_EQ(writer.publish(event), i + 1);
+    }
+    auto extra = make_event(make_block(100, 0xEE));
+    EXPECT_EQ(writer.publish(extra), 0u);
+
+    // Незабранные блоки целы; после чтения место освобождается
+    bitcoin::ShmSubmitReader reader(*segment);
+    uint8_t expected_fill = 0;
+    reader.drain([&](const bitcoin::ShmSubmitEvent& e) {
+        EXPECT_EQ(e.header_raw[0], expected_fill++);
+    });
+    EXPECT_EQ(expected_fill, bitcoin::SHM_SUBMIT_SLOTS);
+    EXPECT_NE(writer.publish(extra), 0u);
+    EXPECT_EQ(reader.corrupted(), 0u);
+}
+
+TEST(ShmSubmitTest, SubmitterPublishesToNodeSegment) {
+    const std::string path = "/quaxis_test_submit_" + std::to_string(getpid());
+    ShmConfig config;
+    config.submit_path = path;
+
+    // Сегмент ещё не создан узлом: майнер создаёт его сам
+    bitcoin::ShmBlockSubmitter submitter(config);
+    ASSERT_TRUE(submitter.open().has_value());
+
+    int fd = shm_open(path.c_str(), O_RDWR, 0);
+    ASSERT_GE(fd, 0);
+    void* ptr = mmap(nullptr, sizeof(bitcoin::QuaxisSharedSubmit), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ASSERT_NE(ptr, MAP_FAILED);
+    auto* segment = static_cast<bitcoin::QuaxisSharedSubmit*>(ptr);
+    bitcoin::ShmSubmitReader reader(*segment);
+
+    // Поток узла ждёт блок, как плагин в ProcessNewBlock
+    const auto block = make_block(200, 7);
+    Hash256 hash{};
+    hash.fill(0x5A);
+    Bytes received;
+    std::thread node([&] {
+        while (received.empty()) {
+            reader.drain([&](const bitcoin::ShmSubmitEvent& e) {
+                received = bitcoin::submit_event_block(e);
+                EXPECT_EQ(e.block_hash[0], 0x5A);
+            });
+        }
+    });
+    ASSERT_TRUE(submitter.submit(block, hash).has_value());
+    node.join();
+    EXPECT_EQ(received, block);
+    EXPECT_EQ(submitter.pending(), 0u);
+
+    // Блок с транзакциями и слишком длинная coinbase - только RPC
+    auto with_txs = make_block(200, 8);
+    with_txs[constants::BLOCK_HEADER_SIZE] = 0x02;
+    EXPECT_FALSE(submitter.submit(with_txs, hash).has_value());
+    EXPECT_FALSE(submitter.submit(make_block(bitcoin::SHM_SUBMIT_MAX_COINBASE + 1, 9), hash).has_value());
+
+    munmap(ptr, sizeof(bitcoin::QuaxisSharedSubmit));
+    close(fd);
+    EXPECT_TRUE(bitcoin::remove_shm_segment(path).has_value());
+}
+
+} // namespace quaxis::tests
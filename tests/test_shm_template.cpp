@@ -0,0 +1,181 @@
+/**
+ * @file test_shm_template.cpp
+ * @brief Тесты для сегмента полного шаблона в shared memory
+ */
+
+#include <gtest/gtest.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "bitcoin/coinbase.hpp"
+#include "bitcoin/shm_subscriber.hpp"
+#include "bitcoin/shm_template.hpp"
+#include "bitcoin/target.hpp"
+#include "mining/job_manager.hpp"
+
+namespace quaxis::tests {
+
+namespace {
+
+constexpr uint32_t HEIGHT = 850000;
+constexpr int64_t REWARD = 312'500'000;
+
+/**
+ * @brief Шаблон сегмента из coinbase CoinbaseBuilder
+ */
+bitcoin::ShmTemplateData make_data(const Bytes& coinbase) {
+    bitcoin::BlockHeader header;
+    header.prev_block.fill(0xAB);
+    header.timestamp = 1'700'000'000;
+    header.bits = 0x1705ae3a;
+
+    bitcoin::ShmTemplateData data;
+    data.height = HEIGHT;
+    data.state = bitcoin::ShmBlockState::Speculative;
+    data.coinbase_value = REWARD;
+    auto raw = header.serialize();
+    std::memcpy(data.header_raw, raw.data(), raw.size());
+
+    const std::size_t suffix_offset = bitcoin::SHM_TEMPLATE_PREFIX_SIZE + constants::EXTRANONCE_SIZE;
+    std::memcpy(data.coinbase_prefix, coinbase.data(), bitcoin::SHM_TEMPLATE_PREFIX_SIZE);
+    data.coinbase_suffix_size = static_cast<uint16_t>(coinbase.size() - suffix_offset);
+    std::memcpy(data.coinbase_suffix, coinbase.data() + suffix_offset, data.coinbase_suffix_size);
+    return data;
+}
+
+Bytes make_coinbase() {
+    Hash160 pubkey_hash{};
+    pubkey_hash.fill(0x22);
+    bitcoin::CoinbaseBuilder builder(pubkey_hash);
+    return builder.build(HEIGHT, REWARD, 0);
+}
+
+} // anonymous namespace
+
+// =============================================================================
+// Тесты fill_block_template
+// =============================================================================
+
+/**
+ * @brief Тест: шаблон из prefix / suffix совпадает с собственной coinbase
+ */
+TEST(ShmTemplateTest, FillMatchesLocalCoinbase) {
+    Bytes coinbase = make_coinbase();
+    auto data = make_data(coinbase);
+
+    bitcoin::BlockTemplate tmpl;
+    ASSERT_TRUE(bitcoin::fill_block_template(data, tmpl).has_value());
+
+    EXPECT_EQ(tmpl.height, HEIGHT);
+    EXPECT_EQ(tmpl.coinbase_value, REWARD);
+    EXPECT_TRUE(tmpl.is_speculative);
+    EXPECT_EQ(tmpl.coinbase_tx, coinbase);
+    EXPECT_EQ(tmpl.coinbase_midstate, crypto::compute_midstate(coinbase.data()));
+    EXPECT_EQ(tmpl.header.merkle_root, bitcoin::compute_txid(coinbase));
+    EXPECT_EQ(tmpl.header_midstate, tmpl.header.compute_midstate());
+    EXPECT_EQ(tmpl.target, bitcoin::bits_to_target(0x1705ae3a));
+}
+
+/**
+ * @brief Тест: некорректные шаблоны отклоняются
+ */
+TEST(ShmTemplateTest, FillRejectsUnsupportedTemplates) {
+    auto data = make_data(make_coinbase());
+    bitcoin::BlockTemplate tmpl;
+
+    auto with_branch = data;
+    with_branch.merkle_branch_size = 1;
+    EXPECT_FALSE(bitcoin::fill_block_template(with_branch, tmpl).has_value());
+
+    auto oversized = data;
+    oversized.coinbase_suffix_size = bitcoin::SHM_TEMPLATE_MAX_SUFFIX + 1;
+    EXPECT_FALSE(bitcoin::fill_block_template(oversized, tmpl).has_value());
+
+    auto empty = data;
+    empty.state = bitcoin::ShmBlockState::Empty;
+    EXPECT_FALSE(bitcoin::fill_block_template(empty, tmpl).has_value());
+}
+
+/**
+ * @brief Тест: JobManager принимает разделяемый шаблон без копии
+ */
+TEST(ShmTemplateTest, JobManagerSharesTemplate) {
+    Bytes coinbase = make_coinbase();
+    auto tmpl = std::make_shared<bitcoin::BlockTemplate>();
+    ASSERT_TRUE(bitcoin::fill_block_template(make_data(coinbase), *tmpl).has_value());
+    std::shared_ptr<const bitcoin::BlockTemplate> shared = tmpl;
+
+    MiningConfig config;
+    Hash160 pubkey_hash{};
+    mining::JobManager manager(config, bitcoin::CoinbaseBuilder(pubkey_hash));
+    manager.on_new_block(shared, true);
+
+    // Шаблон не скопирован: владельцы - тест и менеджер
+    EXPECT_GE(shared.use_count(), 2);
+    EXPECT_EQ(manager.current_height(), HEIGHT);
+
+    auto extranonce = manager.register_connection(1);
+    auto job = manager.get_next_job_for_connection(1);
+    ASSERT_TRUE(job.has_value());
+    EXPECT_EQ(job->midstate, shared->midstate_for_extranonce(extranonce));
+    EXPECT_TRUE(job->is_speculative);
+}
+
+// =============================================================================
+// Тесты ShmTemplateSubscriber
+// =============================================================================
+
+/**
+ * @brief Тест: опубликованный шаблон доходит до callback
+ */
+TEST(ShmTemplateTest, SubscriberDeliversTemplate) {
+    const std::string path = "/quaxis_test_template_" + std::to_string(getpid());
+    ASSERT_TRUE(bitcoin::create_shm_template_segment(path).has_value());
+
+    int fd = shm_open(path.c_str(), O_RDWR, 0);
+    ASSERT_GE(fd, 0);
+    void* ptr = mmap(nullptr, sizeof(bitcoin::QuaxisSharedTemplate), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ASSERT_NE(ptr, MAP_FAILED);
+    auto& segment = *static_cast<bitcoin::QuaxisSharedTemplate*>(ptr);
+
+    ShmConfig config;
+    config.template_path = path;
+    config.sleep_us = 100;
+    bitcoin::ShmTemplateSubscriber subscriber(config);
+
+    std::atomic<uint32_t> delivered_height{0};
+    subscriber.set_callback([&](std::shared_ptr<const bitcoin::BlockTemplate> tmpl, bool is_speculative) {
+        EXPECT_TRUE(is_speculative);
+        delivered_height = tmpl->height;
+    });
+    ASSERT_TRUE(subscriber.start().has_value());
+
+    Bytes coinbase = make_coinbase();
+    EXPECT_EQ(bitcoin::publish_shm_template(segment, make_data(coinbase)), 2u);
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (delivered_height.load() == 0 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    subscriber.stop();
+
+    EXPECT_EQ(delivered_height.load(), HEIGHT);
+    ASSERT_NE(subscriber.get_last_template(), nullptr);
+    EXPECT_EQ(subscriber.get_last_template()->coinbase_tx, coinbase);
+    EXPECT_EQ(subscriber.get_sequence(), 2u);
+    EXPECT_EQ(subscriber.rejected_templates(), 0u);
+
+    munmap(ptr, sizeof(bitcoin::QuaxisSharedTemplate));
+    close(fd);
+    EXPECT_TRUE(bitcoin::remove_shm_segment(path).has_value());
+}
+
+} // namespace quaxis::tests
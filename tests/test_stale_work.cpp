@@ -0,0 +1,174 @@
+/**
+ * @file test_stale_work.cpp
+ * @brief Тесты учёта потерянной работы
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <vector>
+
+#include "mining/stale_work.hpp"
+
+namespace quaxis::tests {
+
+namespace {
+
+using mining::StaleCause;
+using mining::StaleWorkAccountant;
+using mining::TipSource;
+using Clock = StaleWorkAccountant::Clock;
+using std::chrono::milliseconds;
+using std::chrono::seconds;
+
+constexpr double HASHES_PER_DIFFICULTY = 4294967296.0;
+
+Hash256 make_tip(uint8_t seed) {
+    Hash256 tip{};
+    tip.fill(seed);
+    return tip;
+}
+
+/**
+ * @brief Два ASIC с известным хешрейтом: 1 TH/s и 3 TH/s
+ *
+ * Shares за одно окно HASHRATE_WINDOW с работой rate × окно.
+ */
+Clock::time_point warm_up(StaleWorkAccountant& accountant, Clock::time_point start) {
+    const double window = std::chrono::duration<double>(StaleWorkAccountant::HASHRATE_WINDOW).count();
+    const double difficulty = 1e12 * window / 10.0 / HASHES_PER_DIFFICULTY;
+    for (int i = 0; i < 10; ++i) {
+        accountant.on_share(1, difficulty, start);
+        accountant.on_share(2, 3.0 * difficulty, start);
+    }
+    const Clock::time_point ready = start + StaleWorkAccountant::HASHRATE_WINDOW;
+    accountant.tick(ready);
+    return ready;
+}
+
+double cause(const mining::StaleWorkEvent& event, StaleCause cause) {
+    return event.wasted_th[static_cast<std::size_t>(cause)];
+}
+
+} // anonymous namespace
+
+/**
+ * @brief Тест: хешрейт по сложности shares
+ */
+TEST(StaleWorkTest, EstimatesHashrateFromShares) {
+    StaleWorkAccountant accountant;
+    warm_up(accountant, Clock::time_point{});
+    const auto snapshot = accountant.snapshot();
+    EXPECT_EQ(snapshot.units, 2u);
+    EXPECT_NEAR(snapshot.hashrate, 4e12, 1e6);
+}
+
+/**
+ * @brief Тест: рассылка и подтверждения загрузки делят потери по причинам
+ */
+TEST(StaleWorkTest, SplitsPipelineAndUnitSwitch) {
+    StaleWorkAccountant accountant;
+    std::vector<mining::StaleWorkEvent> events;
+    accountant.set_event_callback([&](const mining::StaleWorkEvent& event) { events.push_back(event); });
+    const Clock::time_point t0 = warm_up(accountant, Clock::time_point{});
+
+    const Hash256 tip = make_tip(1);
+    accountant.on_tip(TipSource::Zmq, tip, 101, false, t0);
+    accountant.on_tip(TipSource::Shm, tip, 101, false, t0 + milliseconds(5));  // Отставание SHM
+    accountant.on_dispatched(tip, t0 + milliseconds(100));
+    // Задание, отправленное до tip, - не переключение
+    accountant.on_job_loaded(1, seconds(1), t0 + milliseconds(150));
+    accountant.on_job_loaded(1, milliseconds(100), t0 + milliseconds(200));
+    // ASIC 2 без RSP_JOB_LOADED: переключился при рассылке
+
+    accountant.tick(t0 + seconds(5));
+    EXPECT_TRUE(events.empty());
+    accountant.tick(t0 + milliseconds(100) + StaleWorkAccountant::ACK_WINDOW);
+    ASSERT_EQ(events.size(), 1u);
+
+    const auto& event = events[0];
+    EXPECT_EQ(event.source, TipSource::Zmq);
+    EXPECT_EQ(event.height, 101u);
+    EXPECT_EQ(event.units, 2u);
+    EXPECT_EQ(event.units_acked, 1u);
+    EXPECT_NEAR(event.pipeline_ms, 100.0, 1e-6);
+    EXPECT_NEAR(event.switch_max_ms, 100.0, 1e-6);
+    // 4 TH/s × 0.1 с; 1 TH/s × 0.1 с
+    EXPECT_NEAR(cause(event, StaleCause::Pipeline), 0.4, 1e-9);
+    EXPECT_NEAR(cause(event, StaleCause::UnitSwitch), 0.1, 1e-9);
+    EXPECT_DOUBLE_EQ(cause(event, StaleCause::SpeculativeInvalid), 0.0);
+
+    const auto snapshot = accountant.snapshot();
+    EXPECT_EQ(snapshot.events, 1u);
+    EXPECT_EQ(snapshot.first_arrivals[static_cast<std::size_t>(TipSource::Zmq)], 1u);
+    const auto& shm_lag = snapshot.source_lag[static_cast<std::size_t>(TipSource::Shm)];
+    EXPECT_EQ(shm_lag.count(), 1u);
+    EXPECT_EQ(shm_lag.max(), 5'000'000u);
+}
+
+/**
+ * @brief Тест: отменённый speculative блок - потеряно только время на нём
+ */
+TEST(StaleWorkTest, ChargesInvalidatedSpeculativeBlock) {
+    StaleWorkAccountant accountant;
+    std::vector<mining::StaleWorkEvent> events;
+    accountant.set_event_callback([&](const mining::StaleWorkEvent& event) { events.push_back(event); });
+    const Clock::time_point t0 = warm_up(accountant, Clock::time_point{});
+
+    const Hash256 tip = make_tip(2);
+    accountant.on_tip(TipSource::Relay, tip, 102, true, t0);
+    accountant.on_dispatched(tip, t0 + milliseconds(10));
+    accountant.on_job_loaded(2, milliseconds(40), t0 + milliseconds(50));
+
+    // Без решения о блоке событие не закрывается по сроку
+    accountant.tick(t0 + seconds(30));
+    EXPECT_TRUE(events.empty());
+
+    accountant.on_speculative_resolved(false, t0 + seconds(2) + milliseconds(10));
+    ASSERT_EQ(events.size(), 1u);
+    const auto& event = events[0];
+    EXPECT_TRUE(event.invalidated);
+    EXPECT_DOUBLE_EQ(cause(event, StaleCause::Pipeline), 0.0);
+    EXPECT_DOUBLE_EQ(cause(event, StaleCause::UnitSwitch), 0.0);
+    // ASIC 1: 1 TH/s × 2 с; ASIC 2: 3 TH/s × 1.96 с
+    EXPECT_NEAR(cause(event, StaleCause::SpeculativeInvalid), 2.0 + 3.0 * 1.96, 1e-9);
+
+    // Повтор решения и поздние подтверждения ничего не меняют
+    accountant.on_speculative_resolved(false, t0 + seconds(3));
+    accountant.on_job_loaded(1, milliseconds(1), t0 + seconds(3));
+    EXPECT_EQ(events.size(), 1u);
+    EXPECT_EQ(accountant.snapshot().invalidated, 1u);
+}
+
+/**
+ * @brief Тест: следующий tip закрывает неразрешённое событие как обычное
+ */
+TEST(StaleWorkTest, NextTipClosesOpenEvent) {
+    StaleWorkAccountant accountant;
+    std::vector<mining::StaleWorkEvent> events;
+    accountant.set_event_callback([&](const mining::StaleWorkEvent& event) { events.push_back(event); });
+    const Clock::time_point t0 = warm_up(accountant, Clock::time_point{});
+
+    accountant.on_tip(TipSource::Relay, make_tip(3), 103, true, t0);
+    accountant.on_dispatched(make_tip(3), t0 + milliseconds(20));
+    accountant.on_tip(TipSource::ShmTemplate, make_tip(4), 104, false, t0 + seconds(1));
+    ASSERT_EQ(events.size(), 1u);
+    EXPECT_FALSE(events[0].invalidated);
+    EXPECT_NEAR(cause(events[0], StaleCause::Pipeline), 4.0 * 0.02, 1e-9);
+
+    // Решение о прежнем блоке текущего (не speculative) события не касается
+    accountant.on_speculative_resolved(false, t0 + seconds(2));
+    EXPECT_EQ(events.size(), 1u);
+}
+
+/**
+ * @brief Тест: ASIC без shares выпадает из учёта
+ */
+TEST(StaleWorkTest, ForgetsSilentUnits) {
+    StaleWorkAccountant accountant;
+    const Clock::time_point t0 = warm_up(accountant, Clock::time_point{});
+    accountant.tick(t0 + StaleWorkAccountant::UNIT_TIMEOUT + seconds(1));
+    EXPECT_EQ(accountant.snapshot().units, 0u);
+}
+
+} // namespace quaxis::tests
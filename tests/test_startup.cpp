@@ -0,0 +1,91 @@
+/**
+ * @file test_startup.cpp
+ * @brief Тесты параллельного запуска подсистем
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "core/startup.hpp"
+
+namespace quaxis::tests {
+
+using core::StartupGroup;
+
+TEST(StartupGroupTest, IndependentStepsRunInParallel) {
+    StartupGroup startup;
+    const auto begin = StartupGroup::Clock::now();
+    for (const char* name : {"a", "b", "c"}) {
+        startup.launch(name, {}, []() -> Result<void> {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            return {};
+        });
+    }
+    auto reports = startup.wait_all();
+    const auto elapsed = StartupGroup::Clock::now() - begin;
+
+    ASSERT_EQ(reports.size(), 3u);
+    for (const auto& report : reports) {
+        EXPECT_TRUE(report.ok);
+        EXPECT_GE(report.run_ms, 90.0);
+    }
+    EXPECT_LT(elapsed, std::chrono::milliseconds(250));
+    EXPECT_EQ(startup.pending(), 0u);
+}
+
+TEST(StartupGroupTest, StepWaitsForDependencies) {
+    StartupGroup startup;
+    std::atomic<bool> base_done{false};
+    std::atomic<bool> saw_base{false};
+
+    startup.launch("base", {}, [&]() -> Result<void> {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        base_done.store(true);
+        return {};
+    });
+    startup.launch("dependent", {"base"}, [&]() -> Result<void> {
+        saw_base.store(base_done.load());
+        return {};
+    });
+
+    EXPECT_TRUE(startup.wait("dependent").has_value());
+    EXPECT_TRUE(saw_base.load());
+}
+
+TEST(StartupGroupTest, FailedDependencySkipsStep) {
+    StartupGroup startup;
+    std::atomic<bool> ran{false};
+    std::atomic<int> reported{0};
+    startup.set_report_callback([&](const core::StartupReport&) { reported.fetch_add(1); });
+
+    startup.launch("relay", {}, []() -> Result<void> {
+        return Err<void>(ErrorCode::NetworkConnectionFailed, "DNS");
+    });
+    startup.launch("after_relay", {"relay"}, [&]() -> Result<void> {
+        ran.store(true);
+        return {};
+    });
+    startup.launch("unknown_dep", {"missing"}, [&]() -> Result<void> {
+        ran.store(true);
+        return {};
+    });
+
+    auto relay = startup.wait("relay");
+    ASSERT_FALSE(relay.has_value());
+    EXPECT_EQ(relay.error().code, ErrorCode::NetworkConnectionFailed);
+
+    auto dependent = startup.wait("after_relay");
+    ASSERT_FALSE(dependent.has_value());
+    EXPECT_EQ(dependent.error().code, ErrorCode::NetworkConnectionFailed);
+    EXPECT_FALSE(startup.wait("unknown_dep").has_value());
+    EXPECT_FALSE(startup.wait("never_launched").has_value());
+
+    startup.wait_all();
+    EXPECT_FALSE(ran.load());
+    EXPECT_EQ(reported.load(), 3);
+}
+
+} // namespace quaxis::tests
@@ -0,0 +1,63 @@
+/**
+ * @file test_stats_counter.cpp
+ * @brief Тесты для lock-free счётчиков статистики
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "core/stats_counter.hpp"
+
+namespace quaxis::tests {
+
+TEST(StatsCounterTest, RelaxedCounterAdds) {
+    core::RelaxedCounter counter;
+    counter.add();
+    counter.add(41);
+    EXPECT_EQ(counter.load(), 42u);
+}
+
+TEST(StatsCounterTest, ShardedCounterSumsAllThreads) {
+    core::ShardedCounter<4> counter;
+    constexpr int THREADS = 8;  // больше потоков, чем шардов
+    constexpr uint64_t PER_THREAD = 100'000;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t) {
+        threads.emplace_back([&counter] {
+            for (uint64_t i = 0; i < PER_THREAD; ++i) {
+                counter.add();
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(counter.load(), THREADS * PER_THREAD);
+}
+
+TEST(StatsCounterTest, ShardSlotsOnSeparateCacheLines) {
+    EXPECT_GE(sizeof(core::ShardedCounter<4>), 4 * core::CACHE_LINE_SIZE);
+}
+
+TEST(StatsCounterTest, TimePointRoundTrip) {
+    core::RelaxedTimePoint tp;
+    EXPECT_EQ(tp.load().time_since_epoch().count(), 0);
+
+    auto now = std::chrono::steady_clock::now();
+    tp.store(now);
+    EXPECT_EQ(tp.load(), now);
+}
+
+TEST(StatsCounterTest, RelaxedValueStoresLast) {
+    core::RelaxedValue<uint32_t> value(5);
+    EXPECT_EQ(value.load(), 5u);
+    value.store(7);
+    EXPECT_EQ(value.load(), 7u);
+}
+
+} // namespace quaxis::tests
@@ -7,6 +7,11 @@
 
 #include "log/status_reporter.hpp"
 
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
 namespace quaxis::tests {
 
 // =============================================================================
@@ -53,6 +58,19 @@ TEST(EventTypeTest, ToString) {
 // Тесты StatusReporter
 // =============================================================================
 
+namespace {
+
+/// @brief Вывод render_frame() (перехват std::cout)
+std::string capture_frame(log::StatusReporter& reporter) {
+    std::ostringstream captured;
+    auto* previous = std::cout.rdbuf(captured.rdbuf());
+    reporter.render_frame();
+    std::cout.rdbuf(previous);
+    return captured.str();
+}
+
+} // anonymous namespace
+
 class StatusReporterTest : public ::testing::Test {
 protected:
     void SetUp() override {
@@ -207,6 +225,165 @@ TEST_F(StatusReporterTest, EventHistoryLimit) {
     EXPECT_TRUE(output.find("800009") != std::string::npos);  // Последний блок
 }
 
+/**
+ * @brief Тест: секция латентности появляется только с данными
+ */
+TEST_F(StatusReporterTest, LatencySection) {
+    log::StatusReporter reporter(config_);
+    EXPECT_EQ(reporter.render_plain().find("Latency"), std::string::npos);
+    
+    reporter.update_latency_stats({{"broadcast_done", 12, 41.5, 60.0, 88.0, 93.2}});
+    std::string output = reporter.render_plain();
+    EXPECT_NE(output.find("Latency"), std::string::npos);
+    EXPECT_NE(output.find("broadcast_done"), std::string::npos);
+    EXPECT_NE(output.find("p99=88.0"), std::string::npos);
+}
+
+/**
+ * @brief Тест: сообщения собираются при выводе из полей записи
+ */
+TEST_F(StatusReporterTest, EventsFormattedOnRender) {
+    log::StatusReporter reporter(config_);
+    
+    reporter.log_height_event(log::EventType::NEW_BLOCK, "Jobs sent", 850000);
+    reporter.log_aux_block_found("namecoin", 700000);
+    reporter.log_fallback_change(fallback::FallbackMode::PrimarySHM,
+                                 fallback::FallbackMode::FallbackZMQ);
+    reporter.log_event(log::EventType::ERROR, std::string(200, 'x'));
+    
+    std::string output = reporter.render_plain();
+    EXPECT_NE(output.find("Jobs sent at height 850000"), std::string::npos);
+    EXPECT_NE(output.find("Found block at height 700000 (namecoin)"), std::string::npos);
+    EXPECT_NE(output.find("Switched from"), std::string::npos);
+    // Длинный текст обрезается до размера записи
+    EXPECT_NE(output.find(std::string(log::EVENT_TEXT_SIZE, 'x')), std::string::npos);
+    EXPECT_EQ(output.find(std::string(log::EVENT_TEXT_SIZE + 1, 'x')), std::string::npos);
+}
+
+/**
+ * @brief Тест: события из многих потоков не теряются и не блокируют
+ */
+TEST_F(StatusReporterTest, ConcurrentProducers) {
+    log::LoggingConfig config = config_;
+    config.event_history = 100000;
+    log::StatusReporter reporter(config);
+    
+    constexpr int THREADS = 4;
+    constexpr int EVENTS = 5000;
+    std::vector<std::thread> producers;
+    for (int t = 0; t < THREADS; ++t) {
+        producers.emplace_back([&reporter, t] {
+            for (int i = 0; i < EVENTS; ++i) {
+                reporter.log_submit(i % 2 == 0, t % 2 == 0 ? "namecoin" : "syscoin");
+            }
+        });
+    }
+    // Вывод параллельно забирает записи из кольца
+    for (int i = 0; i < 20; ++i) {
+        (void)reporter.render_plain();
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    
+    EXPECT_EQ(reporter.dropped_events(), 0u);
+    
+    // Имена, интернированные из разных потоков, не перепутаны
+    reporter.log_aux_block_found("syscoin", 1);
+    reporter.log_aux_block_found("namecoin", 2);
+    std::string output = reporter.render_plain();
+    EXPECT_NE(output.find("at height 1 (syscoin)"), std::string::npos);
+    EXPECT_NE(output.find("at height 2 (namecoin)"), std::string::npos);
+}
+
+/**
+ * @brief Тест: переполненное кольцо отбрасывает события со счётчиком
+ */
+TEST_F(StatusReporterTest, RingOverflowDropsEvents) {
+    log::LoggingConfig config = config_;
+    config.event_history = 5;
+    log::StatusReporter reporter(config);
+    
+    // Без вывода кольцо не освобождается
+    for (uint32_t i = 0; i < 5000; ++i) {
+        reporter.log_new_block(i);
+    }
+    EXPECT_GT(reporter.dropped_events(), 0u);
+    
+    std::string output = reporter.render_plain();
+    EXPECT_NE(output.find("events dropped"), std::string::npos);
+    
+    // После вывода места снова хватает
+    const uint64_t dropped = reporter.dropped_events();
+    reporter.log_new_block(900000);
+    EXPECT_EQ(reporter.dropped_events(), dropped);
+    EXPECT_NE(reporter.render_plain().find("900000"), std::string::npos);
+}
+
+/**
+ * @brief Тест: ANSI кадр печатает только изменившиеся строки
+ */
+TEST_F(StatusReporterTest, DiffRenderOnlyChangedLines) {
+    log::LoggingConfig config = config_;
+    config.color = true;
+    log::StatusReporter reporter(config);
+    
+    std::string first = capture_frame(reporter);
+    EXPECT_NE(first.find("QUAXIS SOLO MINER"), std::string::npos);
+    EXPECT_NE(first.find("Merged Mining Chains:"), std::string::npos);
+    
+    // Без изменений: разве что строка uptime
+    std::string idle = capture_frame(reporter);
+    EXPECT_EQ(idle.find("QUAXIS SOLO MINER"), std::string::npos);
+    EXPECT_EQ(idle.find("Bitcoin:"), std::string::npos);
+    
+    log::BitcoinStats stats;
+    stats.height = 812345;
+    reporter.update_bitcoin_stats(stats);
+    std::string update = capture_frame(reporter);
+    EXPECT_NE(update.find("Height: 812345"), std::string::npos);
+    EXPECT_EQ(update.find("QUAXIS SOLO MINER"), std::string::npos);
+    EXPECT_EQ(update.find("Merged Mining Chains:"), std::string::npos);
+    // Строка ставится позиционированием курсора и дочищается до конца
+    EXPECT_NE(update.find("\033[K"), std::string::npos);
+    
+    reporter.log_new_block(812346);
+    std::string event = capture_frame(reporter);
+    EXPECT_NE(event.find("812346"), std::string::npos);
+    EXPECT_EQ(event.find("Height: 812345"), std::string::npos);
+}
+
+/**
+ * @brief Тест: без цвета кадр печатается только при изменениях
+ */
+TEST_F(StatusReporterTest, PlainFrameOnlyWhenChanged) {
+    log::StatusReporter reporter(config_);
+    
+    EXPECT_NE(capture_frame(reporter).find("Recent Events:"), std::string::npos);
+    EXPECT_TRUE(capture_frame(reporter).empty());
+    
+    reporter.update_fallback_mode(fallback::FallbackMode::FallbackZMQ);
+    EXPECT_NE(capture_frame(reporter).find("ZMQ (Fallback)"), std::string::npos);
+    EXPECT_TRUE(capture_frame(reporter).empty());
+}
+
+/**
+ * @brief Тест: без экрана репортёр работает, но не рисует
+ */
+TEST_F(StatusReporterTest, HeadlessMode) {
+    log::LoggingConfig config = config_;
+    config.display = log::DisplayMode::Never;
+    log::StatusReporter reporter(config);
+    
+    reporter.start();
+    EXPECT_TRUE(reporter.is_running());
+    EXPECT_TRUE(reporter.is_headless());
+    
+    reporter.log_new_block(1);
+    EXPECT_NE(reporter.render_plain().find("NEW_BLOCK"), std::string::npos);
+    reporter.stop();
+}
+
 /**
  * @brief Тест: рендер содержит основные секции
  */
@@ -0,0 +1,106 @@
+/**
+ * @file test_stratum_wire.cpp
+ * @brief Тесты для приёма строк и кодирования mining.submit
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <string>
+
+#include "core/serialization/json.hpp"
+#include "fallback/stratum_wire.hpp"
+
+namespace quaxis::tests {
+
+using namespace fallback;
+
+namespace {
+
+/// @brief Записать текст в LineReader, как это сделал бы recv
+void feed(LineReader& reader, std::string_view text) {
+    auto space = reader.writable();
+    ASSERT_GE(space.size(), text.size());
+    std::memcpy(space.data(), text.data(), text.size());
+    reader.commit(text.size());
+}
+
+} // anonymous namespace
+
+// =============================================================================
+// LineReader
+// =============================================================================
+
+TEST(LineReaderTest, SplitsLinesAcrossReads) {
+    LineReader reader;
+
+    feed(reader, "{\"id\":1}\n{\"id\"");
+    auto first = reader.next_line();
+    ASSERT_TRUE(first.has_value());
+    EXPECT_EQ(*first, "{\"id\":1}");
+    EXPECT_FALSE(reader.next_line().has_value());
+    EXPECT_EQ(reader.pending(), 5u);
+
+    // Хвост сдвигается в начало, строка дочитывается следующим recv
+    feed(reader, ":2}\r\n\n{\"id\":3}\n");
+    auto second = reader.next_line();
+    ASSERT_TRUE(second.has_value());
+    EXPECT_EQ(*second, "{\"id\":2}");
+    auto empty = reader.next_line();
+    ASSERT_TRUE(empty.has_value());
+    EXPECT_TRUE(empty->empty());
+    auto third = reader.next_line();
+    ASSERT_TRUE(third.has_value());
+    EXPECT_EQ(*third, "{\"id\":3}");
+    EXPECT_FALSE(reader.next_line().has_value());
+    EXPECT_EQ(reader.pending(), 0u);
+}
+
+TEST(LineReaderTest, OverlongLineFillsBuffer) {
+    LineReader reader;
+
+    std::string chunk(LineReader::CAPACITY / 2, 'x');
+    feed(reader, chunk);
+    EXPECT_FALSE(reader.next_line().has_value());
+    feed(reader, chunk);
+    EXPECT_FALSE(reader.next_line().has_value());
+
+    // Строка без '\n' на весь буфер: места для recv больше нет
+    EXPECT_TRUE(reader.writable().empty());
+
+    reader.clear();
+    EXPECT_EQ(reader.writable().size(), LineReader::CAPACITY);
+}
+
+// =============================================================================
+// SubmitEncoder
+// =============================================================================
+
+TEST(SubmitEncoderTest, PatchesTemplateFields) {
+    SubmitEncoder encoder;
+
+    auto line = std::string(encoder.encode(7, "worker.1", "job1", "00000001", "5f5e1000", "deadbeef"));
+    EXPECT_EQ(line,
+        R"({"params":["worker.1","job1","00000001","5f5e1000","deadbeef"],)"
+        R"("method":"mining.submit","id":7})" "\n");
+
+    auto doc = core::json::Value::parse(std::string_view(line).substr(0, line.size() - 1));
+    EXPECT_EQ(doc["method"].as_string().value_or(""), "mining.submit");
+    EXPECT_EQ(doc["id"].as_uint64().value_or(0), 7u);
+
+    // То же задание: шаблон прежний, меняются только поля и ID
+    line = std::string(encoder.encode(12345678901ULL, "worker.1", "job1", "00000002", "5f5e1001", "cafebabe"));
+    EXPECT_EQ(line,
+        R"({"params":["worker.1","job1","00000002","5f5e1001","cafebabe"],)"
+        R"("method":"mining.submit","id":12345678901})" "\n");
+    EXPECT_EQ(encoder.rebuilds(), 1u);
+
+    // Новое задание или другая длина extranonce2 - новый шаблон
+    line = std::string(encoder.encode(8, "worker.1", "job22", "0001", "5f5e1002", "00000001"));
+    EXPECT_EQ(line,
+        R"({"params":["worker.1","job22","0001","5f5e1002","00000001"],)"
+        R"("method":"mining.submit","id":8})" "\n");
+    EXPECT_EQ(encoder.rebuilds(), 2u);
+}
+
+} // namespace quaxis::tests
@@ -0,0 +1,299 @@
+/**
+ * @file test_sv2.cpp
+ * @brief Тесты для кодека и клиента Stratum V2
+ */
+
+#include <gtest/gtest.h>
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "core/byte_order.hpp"
+#include "fallback/sv2_client.hpp"
+#include "fallback/sv2_codec.hpp"
+
+namespace quaxis::tests {
+
+using namespace fallback;
+
+namespace {
+
+/// @brief Target сложности 1 (little-endian)
+Hash256 diff1_target() {
+    Hash256 target{};
+    target[26] = 0xFF;
+    target[27] = 0xFF;
+    return target;
+}
+
+/**
+ * @brief SV2 пул на localhost: принимает SetupConnection и открывает канал
+ */
+class FakeSv2Pool {
+public:
+    FakeSv2Pool() {
+        listen_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        ::bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+        ::listen(listen_fd_, 1);
+        socklen_t len = sizeof(addr);
+        ::getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &len);
+        port_ = ntohs(addr.sin_port);
+        thread_ = std::thread([this] { handshake(); });
+    }
+
+    ~FakeSv2Pool() {
+        if (thread_.joinable()) thread_.join();
+        if (client_ >= 0) ::close(client_);
+        ::close(listen_fd_);
+    }
+
+    [[nodiscard]] uint16_t port() const noexcept { return port_; }
+
+    /// @brief Дождаться конца handshake
+    void join() { thread_.join(); }
+
+    /// @brief Принятые в handshake кадры (SetupConnection, OpenStandardMiningChannel)
+    std::vector<std::pair<sv2::FrameHeader, Bytes>> handshake_frames;
+
+    void send(const Bytes& frame) {
+        (void)::send(client_, frame.data(), frame.size(), MSG_NOSIGNAL);
+    }
+
+    /// @brief Прочитать кадр от клиента
+    std::pair<sv2::FrameHeader, Bytes> read_frame() {
+        uint8_t header_bytes[sv2::FRAME_HEADER_SIZE];
+        read_exact(header_bytes, sizeof(header_bytes));
+        auto header = *sv2::parse_frame_header(header_bytes);
+        Bytes payload(header.length);
+        read_exact(payload.data(), payload.size());
+        return {header, payload};
+    }
+
+private:
+    void read_exact(uint8_t* data, std::size_t size) {
+        std::size_t done = 0;
+        while (done < size) {
+            ssize_t n = ::recv(client_, data + done, size - done, 0);
+            if (n <= 0) return;
+            done += static_cast<std::size_t>(n);
+        }
+    }
+
+    void handshake() {
+        client_ = ::accept(listen_fd_, nullptr, nullptr);
+
+        handshake_frames.push_back(read_frame());
+        sv2::Writer setup_success;
+        setup_success.u16(sv2::PROTOCOL_VERSION);
+        setup_success.u32(0);
+        send(sv2::make_frame(sv2::msg::SETUP_CONNECTION_SUCCESS, false, setup_success.data()));
+
+        handshake_frames.push_back(read_frame());
+        sv2::Writer open_success;
+        open_success.u32(1);                // request_id
+        open_success.u32(7);                // channel_id
+        open_success.u256(diff1_target());
+        const uint8_t prefix[] = {0x01, 0x02, 0x03, 0x04};
+        open_success.b0_32(prefix);
+        open_success.u32(0);                // group_channel_id
+        send(sv2::make_frame(sv2::msg::OPEN_STANDARD_MINING_CHANNEL_SUCCESS, false, open_success.data()));
+    }
+
+    int listen_fd_ = -1;
+    int client_ = -1;
+    uint16_t port_ = 0;
+    std::thread thread_;
+};
+
+} // anonymous namespace
+
+// =============================================================================
+// Кодек
+// =============================================================================
+
+TEST(Sv2CodecTest, SetupConnectionFrameLayout) {
+    sv2::SetupConnection setup;
+    setup.endpoint_host = "pool";
+    setup.endpoint_port = 3336;
+    auto frame = setup.encode();
+
+    auto header = sv2::parse_frame_header(frame);
+    ASSERT_TRUE(header.has_value());
+    EXPECT_EQ(header->extension_type, 0);
+    EXPECT_EQ(header->msg_type, sv2::msg::SETUP_CONNECTION);
+    EXPECT_EQ(header->length, frame.size() - sv2::FRAME_HEADER_SIZE);
+
+    // protocol, min/max version, flags, STR0_255 endpoint_host
+    const uint8_t* payload = frame.data() + sv2::FRAME_HEADER_SIZE;
+    EXPECT_EQ(payload[0], sv2::PROTOCOL_MINING);
+    EXPECT_EQ(read_le16(payload + 1), 2);
+    EXPECT_EQ(read_le16(payload + 3), 2);
+    EXPECT_EQ(read_le32(payload + 5), sv2::FLAG_REQUIRES_STANDARD_JOBS);
+    EXPECT_EQ(payload[9], 4);
+    EXPECT_EQ(std::string(reinterpret_cast<const char*>(payload + 10), 4), "pool");
+    EXPECT_EQ(read_le16(payload + 14), 3336);
+}
+
+TEST(Sv2CodecTest, ChannelMessagesAndTruncation) {
+    sv2::SubmitSharesStandard share;
+    share.channel_id = 7;
+    share.nonce = 0xdeadbeef;
+    auto frame = share.encode();
+    auto header = sv2::parse_frame_header(frame);
+    ASSERT_TRUE(header.has_value());
+    EXPECT_TRUE(header->channel_msg());
+    EXPECT_EQ(header->length, 24u);
+    EXPECT_EQ(read_le32(frame.data() + sv2::FRAME_HEADER_SIZE + 12), 0xdeadbeefu);
+
+    // NewMiningJob с OPTION min_ntime
+    sv2::Writer job;
+    job.u32(7);
+    job.u32(42);
+    job.option_u32(0x5f5e1000);
+    job.u32(0x20000000);
+    Hash256 merkle_root{};
+    merkle_root[0] = 0xAB;
+    job.u256(merkle_root);
+    auto decoded = sv2::NewMiningJob::decode(job.data());
+    ASSERT_TRUE(decoded.has_value());
+    EXPECT_EQ(decoded->job_id, 42u);
+    EXPECT_EQ(decoded->min_ntime, 0x5f5e1000u);
+    EXPECT_EQ(decoded->version, 0x20000000u);
+    EXPECT_EQ(decoded->merkle_root[0], 0xAB);
+
+    // Обрезанный payload не разбирается
+    Bytes truncated(job.data().begin(), job.data().end() - 1);
+    EXPECT_FALSE(sv2::NewMiningJob::decode(truncated).has_value());
+}
+
+TEST(Sv2CodecTest, TargetToDifficulty) {
+    EXPECT_DOUBLE_EQ(sv2::target_to_difficulty(diff1_target()), 1.0);
+
+    Hash256 harder{};
+    harder[25] = 0xFF;
+    harder[26] = 0xFF;
+    EXPECT_DOUBLE_EQ(sv2::target_to_difficulty(harder), 256.0);
+    EXPECT_EQ(sv2::target_to_difficulty(Hash256{}), 0.0);
+}
+
+// =============================================================================
+// Клиент
+// =============================================================================
+
+TEST(Sv2ClientTest, UrlSelectsProtocol) {
+    StratumPoolConfig config;
+    ASSERT_TRUE(config.parse_url("stratum2+tcp://pool.example:3336"));
+    EXPECT_EQ(config.protocol, StratumProtocol::V2);
+    EXPECT_EQ(config.host, "pool.example");
+    EXPECT_EQ(config.port, 3336);
+    EXPECT_NE(dynamic_cast<Sv2Client*>(make_stratum_client(config).get()), nullptr);
+
+    ASSERT_TRUE(config.parse_url("stratum+tcp://pool.example:3333"));
+    EXPECT_EQ(config.protocol, StratumProtocol::V1);
+    EXPECT_EQ(dynamic_cast<Sv2Client*>(make_stratum_client(config).get()), nullptr);
+}
+
+TEST(Sv2ClientTest, StandardChannelJobAndSubmit) {
+    FakeSv2Pool pool;
+
+    StratumPoolConfig config;
+    config.host = "127.0.0.1";
+    config.port = pool.port();
+    config.user = "worker";
+    config.protocol = StratumProtocol::V2;
+    Sv2Client client(config);
+
+    std::mutex mutex;
+    std::vector<StratumJob> jobs;
+    client.set_job_callback([&](const StratumJob& job) {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobs.push_back(job);
+    });
+
+    ASSERT_TRUE(client.connect().has_value());
+    pool.join();
+    EXPECT_TRUE(client.is_connected());
+    EXPECT_EQ(client.channel_id(), 7u);
+    EXPECT_EQ(client.get_extranonce1(), "01020304");
+    EXPECT_EQ(client.get_extranonce2_size(), 0u);
+    EXPECT_DOUBLE_EQ(client.get_difficulty(), 1.0);
+
+    // Канал открыт от имени пользователя пула
+    ASSERT_EQ(pool.handshake_frames.size(), 2u);
+    EXPECT_EQ(pool.handshake_frames[1].first.msg_type, sv2::msg::OPEN_STANDARD_MINING_CHANNEL);
+    sv2::Reader open(pool.handshake_frames[1].second);
+    EXPECT_EQ(open.u32(), 1u);
+    EXPECT_EQ(open.str0_255(), "worker");
+
+    // Future job и prevhash, который его активирует
+    sv2::Writer job;
+    job.u32(7);
+    job.u32(42);
+    job.option_u32(std::nullopt);
+    job.u32(0x20000000);
+    Hash256 merkle_root{};
+    merkle_root[31] = 0x11;
+    job.u256(merkle_root);
+    pool.send(sv2::make_frame(sv2::msg::NEW_MINING_JOB, true, job.data()));
+
+    sv2::Writer prev_hash;
+    prev_hash.u32(7);
+    prev_hash.u32(42);
+    Hash256 prev{};
+    prev[0] = 0x22;
+    prev_hash.u256(prev);
+    prev_hash.u32(0x5f5e1000);
+    prev_hash.u32(0x1d00ffff);
+    pool.send(sv2::make_frame(sv2::msg::SET_NEW_PREV_HASH, true, prev_hash.data()));
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (std::chrono::steady_clock::now() < deadline) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!jobs.empty()) break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ASSERT_EQ(jobs.size(), 1u);
+        EXPECT_EQ(jobs[0].job_id, "42");
+        EXPECT_EQ(jobs[0].version, "20000000");
+        EXPECT_EQ(jobs[0].nbits, "1d00ffff");
+        EXPECT_EQ(jobs[0].ntime, "5f5e1000");
+        EXPECT_TRUE(jobs[0].clean_jobs);
+        EXPECT_EQ(jobs[0].prevhash.substr(0, 2), "22");
+        EXPECT_EQ(jobs[0].merkle_root.substr(62), "11");
+        EXPECT_TRUE(jobs[0].coinbase1.empty());
+    }
+
+    // Share: версия из задания, последовательные номера
+    ASSERT_TRUE(client.submit("42", "", "5f5e1001", "deadbeef").has_value());
+    auto [header, payload] = pool.read_frame();
+    EXPECT_EQ(header.msg_type, sv2::msg::SUBMIT_SHARES_STANDARD);
+    sv2::Reader share(payload);
+    EXPECT_EQ(share.u32(), 7u);
+    EXPECT_EQ(share.u32(), 0u);
+    EXPECT_EQ(share.u32(), 42u);
+    EXPECT_EQ(share.u32(), 0xdeadbeefu);
+    EXPECT_EQ(share.u32(), 0x5f5e1001u);
+    EXPECT_EQ(share.u32(), 0x20000000u);
+    EXPECT_TRUE(share.ok());
+
+    // Неизвестное задание и extranonce2 не отправляются
+    EXPECT_EQ(client.submit("43", "", "5f5e1001", "00000001").error().code, ErrorCode::MiningStaleJob);
+    EXPECT_EQ(client.submit("42", "00", "5f5e1001", "00000001").error().code, ErrorCode::MiningInvalidJob);
+
+    client.disconnect();
+}
+
+} // namespace quaxis::tests
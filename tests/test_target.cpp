@@ -200,7 +200,7 @@ TEST_F(TargetTest, PoWCheck) {
     // Хеш с множеством ведущих нулей (валидный)
     Hash256 valid_hash{};
     std::fill(valid_hash.begin(), valid_hash.end(), 0x00);
-    valid_hash[31] = 0x01; // Только последний байт ненулевой
+    valid_hash[0] = 0x01; // Только младший байт ненулевой (little-endian)
     
     EXPECT_TRUE(bitcoin::meets_bits(valid_hash, bits));
     
@@ -237,4 +237,56 @@ TEST_F(TargetTest, HashEndianness) {
     EXPECT_FALSE(bitcoin::meets_target(hash2, hash1));
 }
 
+/**
+ * @brief Тест: target по difficulty
+ */
+TEST_F(TargetTest, DifficultyToTarget) {
+    // difficulty 1 - genesis target
+    auto genesis = bitcoin::Target256::from_hash(bitcoin::bits_to_target(0x1d00ffff));
+    EXPECT_EQ(bitcoin::difficulty_to_target(1.0).words, genesis.words);
+    
+    // difficulty 256 - target на байт меньше
+    auto harder = bitcoin::Target256::from_hash(bitcoin::bits_to_target(0x1c00ffff));
+    EXPECT_EQ(bitcoin::difficulty_to_target(256.0).words, harder.words);
+    
+    // Почти нулевая сложность - любой хеш подходит
+    Hash256 max_hash{};
+    std::fill(max_hash.begin(), max_hash.end(), 0xFF);
+    EXPECT_TRUE(bitcoin::meets_target(max_hash, bitcoin::difficulty_to_target(0.0)));
+    EXPECT_TRUE(bitcoin::meets_target(max_hash, bitcoin::difficulty_to_target(1e-20)));
+    
+    // Порог сложности совпадает с target_to_difficulty()
+    Hash256 hash{};
+    hash[27] = 0x7F;  // difficulty ~ 2
+    EXPECT_TRUE(bitcoin::meets_target(hash, bitcoin::difficulty_to_target(1.5)));
+    EXPECT_FALSE(bitcoin::meets_target(hash, bitcoin::difficulty_to_target(3.0)));
+    EXPECT_GT(bitcoin::target_to_difficulty(hash), 1.5);
+}
+
+/**
+ * @brief Тест: сравнение словами совпадает с побайтовым
+ */
+TEST_F(TargetTest, WordCompareMatchesBytes) {
+    Hash256 target{};
+    target[20] = 0x10;
+    auto words = bitcoin::Target256::from_hash(target);
+    
+    Hash256 equal = target;
+    EXPECT_TRUE(bitcoin::meets_target(equal, words));
+    
+    // Разница в младшем слове
+    Hash256 above = target;
+    above[0] = 0x01;
+    EXPECT_FALSE(bitcoin::meets_target(above, words));
+    
+    // Разница в старшем слове
+    Hash256 below{};
+    below[19] = 0xFF;
+    EXPECT_TRUE(bitcoin::meets_target(below, words));
+    
+    Hash256 high{};
+    high[31] = 0x01;
+    EXPECT_FALSE(bitcoin::meets_target(high, words));
+}
+
 } // namespace quaxis::tests
@@ -0,0 +1,221 @@
+/**
+ * @file test_template_feed.cpp
+ * @brief Тесты фида шаблонов между площадками
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+#include "bitcoin/coinbase.hpp"
+#include "mining/job_manager.hpp"
+#include "network/template_feed.hpp"
+
+namespace quaxis::tests {
+
+namespace {
+
+constexpr uint32_t HEIGHT = 850000;
+constexpr int64_t REWARD = 312'500'000;
+
+/**
+ * @brief Шаблон с собственной coinbase и заданным prev_block
+ */
+std::shared_ptr<const bitcoin::BlockTemplate> make_template(uint8_t prev) {
+    Hash160 pubkey_hash{};
+    pubkey_hash.fill(0x22);
+    bitcoin::CoinbaseBuilder builder(pubkey_hash);
+
+    auto tmpl = std::make_shared<bitcoin::BlockTemplate>();
+    tmpl->height = HEIGHT;
+    tmpl->coinbase_value = REWARD;
+    tmpl->header.prev_block.fill(prev);
+    tmpl->header.timestamp = 1'700'000'000;
+    tmpl->header.bits = 0x1705ae3a;
+    tmpl->coinbase_tx = builder.build(HEIGHT, REWARD, 0);
+    return tmpl;
+}
+
+template <typename Predicate>
+bool wait_for(Predicate predicate) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!predicate()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return true;
+}
+
+ProxyConfig feed_config() {
+    ProxyConfig config;
+    config.feed_bind_address = "127.0.0.1";
+    config.feed_port = 0;
+    config.reconnect_ms = 50;
+    return config;
+}
+
+} // anonymous namespace
+
+TEST(ExtranonceRangeTest, SitesGetDisjointNarrowerRanges) {
+    auto root = network::ExtranonceRange::root(constants::EXTRANONCE_SIZE);
+    EXPECT_EQ(root.base, 0u);
+    EXPECT_EQ(root.bits, 48);
+    EXPECT_EQ(root.first_own(), 1u);
+
+    auto site1 = root.delegate(1);
+    auto site2 = root.delegate(2);
+    ASSERT_TRUE(site1 && site2);
+    EXPECT_EQ(site1->bits, 40);
+    EXPECT_EQ(site1->base, uint64_t{1} << 40);
+    EXPECT_EQ(site2->base, uint64_t{2} << 40);
+
+    // Уровень ниже делит диапазон площадки, не выходя за него
+    auto nested = site2->delegate(255);
+    ASSERT_TRUE(nested);
+    EXPECT_GT(nested->base, site2->base);
+    EXPECT_LE(nested->base + (uint64_t{1} << nested->bits), site2->base + (uint64_t{1} << site2->bits));
+
+    EXPECT_FALSE(root.delegate(0));
+    EXPECT_FALSE((network::ExtranonceRange{0, 15}.delegate(1)));
+}
+
+TEST(ExtranonceRangeTest, ClusterNodesHandOutDisjointExtranonces) {
+    auto root = network::ExtranonceRange::root(constants::EXTRANONCE_SIZE);
+    MiningConfig config;
+    config.extranonce_lease = 16;
+    Hash160 pubkey_hash{};
+    bitcoin::CoinbaseBuilder builder(pubkey_hash);
+
+    auto node1 = *root.delegate(1);
+    auto node2 = *root.delegate(2);
+    mining::JobManager first(config, builder, node1.first_own(), node1.own_end(false));
+    mining::JobManager second(config, builder, node2.first_own(), node2.own_end(false));
+
+    // Одинаковые connection_id на разных узлах - разные extranonce
+    for (uint32_t id = 1; id <= 100; ++id) {
+        uint64_t a = first.register_connection(id);
+        uint64_t b = second.register_connection(id);
+        EXPECT_GE(a, node1.base);
+        EXPECT_LT(a + config.extranonce_lease, node2.base);
+        EXPECT_GE(b, node2.base);
+    }
+}
+
+TEST(ExtranonceRangeTest, ExhaustedNodeRefusesNeighbourSlice) {
+    // mining.extranonce_size = 2: у узла 8 бит, 255 своих значений
+    auto root = network::ExtranonceRange::root(2);
+    MiningConfig config;
+    config.extranonce_lease = 16;
+    Hash160 pubkey_hash{};
+    bitcoin::CoinbaseBuilder builder(pubkey_hash);
+    
+    auto node1 = *root.delegate(1);
+    auto node2 = *root.delegate(2);
+    EXPECT_EQ(node1.own_end(false), node2.base);
+    mining::JobManager first(config, builder, node1.first_own(), node1.own_end(false));
+    
+    // 255 / 16 = 15 аренд, шестнадцатая залезла бы в долю узла 2
+    uint32_t id = 1;
+    for (; id <= 15; ++id) {
+        uint64_t start = first.register_connection(id);
+        ASSERT_NE(start, 0u);
+        EXPECT_LE(start + config.extranonce_lease, node2.base);
+    }
+    EXPECT_EQ(first.register_connection(id), 0u);
+    EXPECT_FALSE(first.get_connection_extranonce(id).has_value());
+    
+    // Освобождённая аренда - в карантине до нового блока, доля по-прежнему исчерпана
+    first.unregister_connection(1);
+    EXPECT_EQ(first.register_connection(id), 0u);
+}
+
+TEST(ExtranonceRangeTest, DelegatingNodeKeepsSiteZeroSlice) {
+    network::ExtranonceRange node{0x10000, 16};
+    EXPECT_EQ(node.own_end(false), 0x20000u);
+    EXPECT_EQ(node.own_end(true), node.delegate(1)->base);
+    // Слишком узкий для площадок диапазон целиком свой
+    EXPECT_EQ((network::ExtranonceRange{0x100, 8}.own_end(true)), 0x200u);
+    EXPECT_EQ(network::ExtranonceRange::root(8).own_end(false), UINT64_MAX);
+}
+
+TEST(TemplateFeedCodecTest, RoundTripKeepsCoinbaseAndHeader) {
+    auto tmpl = make_template(0xAB);
+    auto payload = network::encode_feed_template(*tmpl, true);
+    ASSERT_TRUE(payload.has_value());
+
+    auto decoded = network::decode_feed_template(*payload);
+    ASSERT_TRUE(decoded.has_value());
+    const auto& got = **decoded;
+    EXPECT_EQ(got.height, HEIGHT);
+    EXPECT_EQ(got.coinbase_value, REWARD);
+    EXPECT_TRUE(got.is_speculative);
+    EXPECT_EQ(got.header.prev_block, tmpl->header.prev_block);
+    EXPECT_EQ(got.header.bits, tmpl->header.bits);
+    EXPECT_EQ(got.coinbase_tx, tmpl->coinbase_tx);
+    EXPECT_EQ(got.header.merkle_root, tmpl->merkle_root_for_extranonce(0));
+
+    // Обрезанный хвост coinbase не принимается
+    Bytes truncated(payload->begin(), payload->end() - 1);
+    EXPECT_FALSE(network::decode_feed_template(truncated).has_value());
+}
+
+TEST(TemplateFeedTest, SiteReceivesTemplatesAndForwardsBlocks) {
+    auto root = network::ExtranonceRange::root(constants::EXTRANONCE_SIZE);
+    network::TemplateFeedServer feed(feed_config(), root);
+
+    std::mutex mutex;
+    Bytes forwarded;
+    uint8_t forwarded_site = 0;
+    feed.set_block_callback([&](Bytes block, uint8_t site) {
+        std::lock_guard<std::mutex> lock(mutex);
+        forwarded = std::move(block);
+        forwarded_site = site;
+    });
+    ASSERT_TRUE(feed.start().has_value());
+    feed.publish(make_template(0x01), false);
+
+    ProxyConfig proxy;
+    proxy.upstream_host = "127.0.0.1";
+    proxy.upstream_port = feed.port();
+    proxy.site = 3;
+    proxy.reconnect_ms = 50;
+
+    network::TemplateFeedClient client(proxy);
+    std::atomic<uint8_t> last_prev{0};
+    client.set_template_callback([&](std::shared_ptr<const bitcoin::BlockTemplate> tmpl, bool) {
+        last_prev.store(tmpl->header.prev_block[0]);
+    });
+    auto range = client.connect();
+    ASSERT_TRUE(range.has_value());
+    EXPECT_EQ(*range, *root.delegate(3));
+    client.start();
+
+    // Последний шаблон приходит сразу за Delegation, новые - по publish
+    EXPECT_TRUE(wait_for([&] { return last_prev.load() == 0x01; }));
+    feed.publish(make_template(0x02), false);
+    EXPECT_TRUE(wait_for([&] { return last_prev.load() == 0x02; }));
+    EXPECT_EQ(client.templates_received(), 2u);
+    EXPECT_EQ(feed.site_count(), 1u);
+
+    // Вторая площадка с тем же номером перебирала бы те же extranonce
+    network::TemplateFeedClient duplicate(proxy);
+    EXPECT_FALSE(duplicate.connect(1000).has_value());
+
+    const Bytes block(200, 0x5A);
+    ASSERT_TRUE(client.submit_block(block).has_value());
+    EXPECT_TRUE(wait_for([&] {
+        std::lock_guard<std::mutex> lock(mutex);
+        return forwarded == block;
+    }));
+    EXPECT_EQ(forwarded_site, 3);
+
+    client.stop();
+    feed.stop();
+}
+
+} // namespace quaxis::tests
@@ -0,0 +1,64 @@
+/**
+ * @file test_thread_plan.cpp
+ * @brief Тесты плана размещения потоков
+ */
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+#include "core/thread_plan.hpp"
+
+namespace quaxis::tests {
+
+/**
+ * @brief Тест: наборы CPU в формате sysfs
+ */
+TEST(ThreadPlanTest, ParsesCpuSets) {
+    auto cpus = core::parse_cpu_set("6, 0-3,2,8\n");
+    ASSERT_TRUE(cpus.has_value());
+    EXPECT_EQ(*cpus, (std::vector<int>{0, 1, 2, 3, 6, 8}));
+
+    auto empty = core::parse_cpu_set("");
+    ASSERT_TRUE(empty.has_value());
+    EXPECT_TRUE(empty->empty());
+
+    EXPECT_FALSE(core::parse_cpu_set("3-1").has_value());
+    EXPECT_FALSE(core::parse_cpu_set("a").has_value());
+    EXPECT_FALSE(core::parse_cpu_set("1-").has_value());
+    EXPECT_FALSE(core::parse_cpu_set("-2").has_value());
+}
+
+/**
+ * @brief Тест: план без закрепления - потоки ролей считаются в дампе
+ */
+TEST(ThreadPlanTest, CountsThreadsPerRole) {
+    ThreadsConfig config;
+    config.prefault_stack_kb = 128;
+    ASSERT_TRUE(core::apply_thread_plan(config).has_value());
+
+    std::thread block_path([] { core::enter_thread_role(core::ThreadRole::BlockPath); });
+    std::thread fanout([] { core::enter_thread_role(core::ThreadRole::Fanout); });
+    block_path.join();
+    fanout.join();
+
+    auto topology = core::describe_thread_topology();
+    EXPECT_NE(topology.find("block_path: CPU любые, потоков"), std::string::npos);
+    EXPECT_NE(topology.find("fanout: CPU любые"), std::string::npos);
+    EXPECT_NE(topology.find("mlockall: нет"), std::string::npos);
+    EXPECT_EQ(topology.find("ошибок"), std::string::npos);
+}
+
+/**
+ * @brief Тест: неверный набор CPU отклоняется при применении плана
+ */
+TEST(ThreadPlanTest, RejectsInvalidCpuSet) {
+    ThreadsConfig config;
+    config.fanout_cpus = "2-x";
+    auto result = core::apply_thread_plan(config);
+    ASSERT_FALSE(result.has_value());
+    EXPECT_EQ(result.error().code, ErrorCode::ConfigInvalidValue);
+}
+
+} // namespace quaxis::tests
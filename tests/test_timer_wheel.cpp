@@ -0,0 +1,144 @@
+/**
+ * @file test_timer_wheel.cpp
+ * @brief Тесты иерархического колеса таймеров
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "core/timer_wheel.hpp"
+
+namespace quaxis::tests {
+
+namespace {
+
+struct TestTimer : core::TimerNode {
+    std::size_t index = 0;
+    uint64_t expected = 0;
+    uint64_t fired_at = 0;
+};
+
+} // anonymous namespace
+
+/**
+ * @brief Тест: узел срабатывает ровно на своём шаге на каждом уровне
+ */
+TEST(TimerWheelTest, FiresOnDeadlineAcrossLevels) {
+    core::TimerWheel wheel(5);
+    std::vector<uint64_t> delays = {1, 2, 63, 64, 65, 4095, 4096, 4097, 300000, 262144};
+    std::vector<TestTimer> timers(delays.size());
+    for (std::size_t i = 0; i < delays.size(); ++i) {
+        timers[i].index = i;
+        timers[i].expected = 5 + delays[i];
+        wheel.schedule(timers[i], delays[i]);
+    }
+    EXPECT_EQ(wheel.size(), delays.size());
+
+    std::size_t fired = 0;
+    for (uint64_t tick = 6; tick <= 5 + 300000; ++tick) {
+        fired += wheel.advance(tick, [&](core::TimerNode& node) {
+            auto& timer = static_cast<TestTimer&>(node);
+            timer.fired_at = wheel.now();
+        });
+    }
+    EXPECT_EQ(fired, delays.size());
+    EXPECT_EQ(wheel.size(), 0u);
+    for (const auto& timer : timers) {
+        EXPECT_EQ(timer.fired_at, timer.expected) << "таймер " << timer.index;
+        EXPECT_FALSE(timer.armed());
+    }
+}
+
+/**
+ * @brief Тест: снятие и перестановка - узел срабатывает только по последней
+ */
+TEST(TimerWheelTest, CancelAndReschedule) {
+    core::TimerWheel wheel;
+    TestTimer cancelled;
+    TestTimer moved;
+    wheel.schedule(cancelled, 10);
+    wheel.schedule(moved, 10);
+    wheel.cancel(cancelled);
+    wheel.cancel(cancelled);  // Повторное снятие - ничего
+    wheel.schedule(moved, 100);
+    EXPECT_FALSE(cancelled.armed());
+    EXPECT_EQ(wheel.size(), 1u);
+
+    std::vector<uint64_t> fired;
+    wheel.advance(200, [&](core::TimerNode&) { fired.push_back(wheel.now()); });
+    ASSERT_EQ(fired.size(), 1u);
+    EXPECT_EQ(fired[0], 100u);
+}
+
+/**
+ * @brief Тест: обработчик ставит свой узел снова (периодический таймер)
+ */
+TEST(TimerWheelTest, HandlerReschedulesItself) {
+    core::TimerWheel wheel;
+    TestTimer periodic;
+    TestTimer other;
+    wheel.schedule(periodic, 30);
+    wheel.schedule(other, 45);
+
+    std::vector<uint64_t> fired;
+    wheel.advance(100, [&](core::TimerNode& node) {
+        if (&node == &periodic) {
+            fired.push_back(wheel.now());
+            wheel.schedule(periodic, 30);
+            wheel.cancel(other);  // Снять ещё не сработавший узел из обработчика
+        }
+    });
+    EXPECT_EQ(fired, (std::vector<uint64_t>{30, 60, 90}));
+    EXPECT_FALSE(other.armed());
+    EXPECT_TRUE(periodic.armed());
+    EXPECT_EQ(periodic.deadline(), 120u);
+}
+
+/**
+ * @brief Тест: случайные сроки и прыжки времени совпадают с эталоном
+ */
+TEST(TimerWheelTest, MatchesReferenceWithJumps) {
+    std::mt19937_64 rng(11);
+    core::TimerWheel wheel(1000);
+    std::vector<TestTimer> timers(2000);
+    for (std::size_t i = 0; i < timers.size(); ++i) {
+        const uint64_t delay = 1 + rng() % (i % 2 == 0 ? 5000 : 400000);
+        timers[i].expected = 1000 + delay;
+        wheel.schedule(timers[i], delay);
+    }
+    // Каждый десятый снят
+    for (std::size_t i = 0; i < timers.size(); i += 10) {
+        wheel.cancel(timers[i]);
+    }
+
+    uint64_t tick = 1000;
+    while (wheel.size() > 0) {
+        tick += 1 + rng() % 700;
+        wheel.advance(tick, [&](core::TimerNode& node) {
+            auto& timer = static_cast<TestTimer&>(node);
+            timer.fired_at = wheel.now();
+        });
+    }
+    for (std::size_t i = 0; i < timers.size(); ++i) {
+        EXPECT_EQ(timers[i].fired_at, i % 10 == 0 ? 0 : timers[i].expected) << "таймер " << i;
+    }
+}
+
+/**
+ * @brief Тест: задержка дальше горизонта срабатывает на горизонте
+ */
+TEST(TimerWheelTest, ClampsToHorizon) {
+    core::TimerWheel wheel(77);
+    TestTimer far;
+    wheel.schedule(far, core::TimerWheel::MAX_DELAY * 4);
+    EXPECT_EQ(far.deadline(), 77 + core::TimerWheel::MAX_DELAY);
+
+    uint64_t fired_at = 0;
+    wheel.advance(77 + core::TimerWheel::MAX_DELAY + 5, [&](core::TimerNode&) { fired_at = wheel.now(); });
+    EXPECT_EQ(fired_at, 77 + core::TimerWheel::MAX_DELAY);
+}
+
+} // namespace quaxis::tests
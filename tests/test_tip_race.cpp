@@ -0,0 +1,137 @@
+/**
+ * @file test_tip_race.cpp
+ * @brief Тесты для гонки источников нового блока
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <vector>
+
+#include "bridge/bitcoin_bridge.hpp"
+#include "bridge/tip_race.hpp"
+
+namespace quaxis::tests {
+
+using namespace bridge;
+
+namespace {
+
+Hash256 make_hash(uint8_t seed) {
+    Hash256 hash{};
+    hash.fill(seed);
+    return hash;
+}
+
+std::size_t index(TipSource source) {
+    return static_cast<std::size_t>(source);
+}
+
+} // anonymous namespace
+
+// =============================================================================
+// TipRace
+// =============================================================================
+
+TEST(TipRaceTest, FirstReportWinsDuplicatesDropped) {
+    TipRace race;
+    auto t0 = std::chrono::steady_clock::now();
+
+    EXPECT_TRUE(race.report(TipSource::FibreHeader, make_hash(1), t0));
+    EXPECT_FALSE(race.report(TipSource::Shm, make_hash(1), t0 + std::chrono::microseconds(400)));
+    EXPECT_FALSE(race.report(TipSource::ZmqHashblock, make_hash(1), t0 + std::chrono::microseconds(2000)));
+
+    ASSERT_TRUE(race.last_winner().has_value());
+    EXPECT_EQ(*race.last_winner(), TipSource::FibreHeader);
+
+    auto stats = race.stats();
+    EXPECT_EQ(stats[index(TipSource::FibreHeader)].wins, 1u);
+    EXPECT_EQ(stats[index(TipSource::FibreHeader)].losses, 0u);
+    EXPECT_EQ(stats[index(TipSource::Shm)].losses, 1u);
+    EXPECT_EQ(stats[index(TipSource::Shm)].average_lag, std::chrono::microseconds(400));
+    EXPECT_EQ(stats[index(TipSource::ZmqHashblock)].average_lag, std::chrono::microseconds(2000));
+
+    // Следующий блок - новая гонка
+    EXPECT_TRUE(race.report(TipSource::Shm, make_hash(2), t0 + std::chrono::seconds(600)));
+    EXPECT_EQ(*race.last_winner(), TipSource::Shm);
+    EXPECT_EQ(race.stats()[index(TipSource::Shm)].wins, 1u);
+}
+
+TEST(TipRaceTest, RepeatFromSameSourceIsNotALoss) {
+    TipRace race;
+
+    // speculative, затем confirmed из того же SHM
+    EXPECT_TRUE(race.report(TipSource::Shm, make_hash(7)));
+    EXPECT_FALSE(race.report(TipSource::Shm, make_hash(7)));
+    EXPECT_FALSE(race.report(TipSource::Rpc, make_hash(7)));
+    EXPECT_FALSE(race.report(TipSource::Rpc, make_hash(7)));
+
+    auto stats = race.stats();
+    EXPECT_EQ(stats[index(TipSource::Shm)].wins, 1u);
+    EXPECT_EQ(stats[index(TipSource::Shm)].losses, 0u);
+    EXPECT_EQ(stats[index(TipSource::Rpc)].losses, 1u);
+}
+
+TEST(TipRaceTest, OldBlocksForgottenAfterHistory) {
+    TipRace race;
+    EXPECT_TRUE(race.report(TipSource::Shm, make_hash(0)));
+    for (uint8_t i = 1; i <= TipRace::HISTORY; ++i) {
+        EXPECT_TRUE(race.report(TipSource::Shm, make_hash(i)));
+    }
+    // Блок 0 вытеснен из кольца, блоки 1..HISTORY помнятся
+    EXPECT_FALSE(race.report(TipSource::P2pHeaders, make_hash(1)));
+    EXPECT_TRUE(race.report(TipSource::P2pHeaders, make_hash(0)));
+}
+
+// =============================================================================
+// BitcoinBridge в режиме гонки
+// =============================================================================
+
+TEST(BitcoinBridgeRaceTest, FirstSourcePublishesTemplate) {
+    BridgeConfig config;
+    config.shm.enabled = false;
+    config.race_sources = true;
+    BitcoinBridge bridge(config);
+
+    std::vector<BlockTemplate> published;
+    bridge.set_template_callback([&](const BlockTemplate& tmpl) {
+        published.push_back(tmpl);
+    });
+
+    bitcoin::BlockHeader header;
+    header.version = 0x20000000;
+    header.prev_block = make_hash(3);
+    header.merkle_root = make_hash(4);
+    header.timestamp = 1700000000;
+    header.bits = 0x17034219;
+
+    // ZMQ знает только хеш и проигрывает заголовку из FIBRE
+    EXPECT_TRUE(bridge.report_tip(TipSource::FibreHeader, header, 900000, 312500000, true));
+    EXPECT_FALSE(bridge.report_block_hash(TipSource::ZmqHashblock, header.hash()));
+    EXPECT_FALSE(bridge.report_tip(TipSource::P2pHeaders, header, 900000, 312500000, false));
+
+    ASSERT_EQ(published.size(), 1u);
+    ASSERT_TRUE(published[0].tip_source.has_value());
+    EXPECT_EQ(*published[0].tip_source, TipSource::FibreHeader);
+    EXPECT_EQ(published[0].height, 900000u);
+    EXPECT_EQ(published[0].prev_block_hash, header.prev_block);
+    EXPECT_TRUE(published[0].is_speculative);
+
+    auto stats = bridge.get_race_stats();
+    EXPECT_EQ(stats[index(TipSource::FibreHeader)].wins, 1u);
+    EXPECT_EQ(stats[index(TipSource::ZmqHashblock)].losses, 1u);
+    EXPECT_EQ(stats[index(TipSource::P2pHeaders)].losses, 1u);
+}
+
+TEST(BitcoinBridgeRaceTest, ReportsIgnoredWithoutRacing) {
+    BridgeConfig config;
+    config.shm.enabled = false;
+    BitcoinBridge bridge(config);
+
+    bitcoin::BlockHeader header;
+    EXPECT_FALSE(bridge.report_tip(TipSource::FibreHeader, header, 1, 0, false));
+    EXPECT_FALSE(bridge.report_block_hash(TipSource::ZmqHashblock, header.hash()));
+    EXPECT_EQ(bridge.get_race_stats()[index(TipSource::FibreHeader)].wins, 0u);
+}
+
+} // namespace quaxis::tests
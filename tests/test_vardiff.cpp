@@ -0,0 +1,116 @@
+/**
+ * @file test_vardiff.cpp
+ * @brief Tests for the per-connection vardiff controller
+ */
+
+#include <gtest/gtest.h>
+
+#include "mining/vardiff.hpp"
+
+namespace quaxis::tests {
+
+using namespace std::chrono_literals;
+using mining::VardiffController;
+
+namespace {
+
+VardiffConfig make_config() {
+    VardiffConfig config;
+    config.enabled = true;
+    config.target_shares_per_minute = 60.0;  // 1 share/с
+    config.start_difficulty = 16;
+    config.min_difficulty = 1;
+    config.max_difficulty = 1024;
+    config.retarget_seconds = 10;
+    config.variance_percent = 30;
+    return config;
+}
+
+} // anonymous namespace
+
+/**
+ * @brief Test: shares at the target rate keep the difficulty
+ */
+TEST(VardiffTest, StableAtTargetRate) {
+    auto t = VardiffController::Clock::time_point{};
+    VardiffController vd(make_config(), t);
+    
+    for (int i = 1; i <= 30; ++i) {
+        EXPECT_FALSE(vd.on_share(t + std::chrono::seconds(i)).has_value());
+    }
+    EXPECT_EQ(vd.difficulty(), 16u);
+}
+
+/**
+ * @brief Test: a flood triggers an early retarget, capped at MAX_STEP
+ */
+TEST(VardiffTest, FloodRaisesEarlyWithCappedStep) {
+    auto t = VardiffController::Clock::time_point{};
+    VardiffController vd(make_config(), t);
+    
+    // Ожидается 10 shares за окно; 40-й share за 1 с вызывает пересчёт
+    std::optional<uint32_t> update;
+    int shares = 0;
+    while (!update && shares < 100) {
+        ++shares;
+        update = vd.on_share(t + std::chrono::milliseconds(25 * shares));
+    }
+    ASSERT_TRUE(update.has_value());
+    EXPECT_EQ(shares, 40);
+    EXPECT_EQ(*update, 64u);  // 16 * MAX_STEP
+    
+    // Сразу после повышения принимаются shares по старой сложности
+    EXPECT_EQ(vd.share_difficulty(t + 2s), 16u);
+    EXPECT_EQ(vd.share_difficulty(t + 10s), 64u);
+}
+
+/**
+ * @brief Test: a slow unit is lowered at the end of the window, bounded by min
+ */
+TEST(VardiffTest, SlowUnitLowered) {
+    auto t = VardiffController::Clock::time_point{};
+    auto config = make_config();
+    config.start_difficulty = 2;
+    VardiffController vd(config, t);
+    
+    // 2 shares за 10 с при цели 10
+    EXPECT_FALSE(vd.on_share(t + 5s).has_value());
+    auto update = vd.on_share(t + 10s);
+    ASSERT_TRUE(update.has_value());
+    EXPECT_EQ(*update, 1u);  // 2 * 0.2 -> min_difficulty
+}
+
+/**
+ * @brief Test: a silent unit is lowered by the periodic tick
+ */
+TEST(VardiffTest, SilentUnitLoweredByTick) {
+    auto t = VardiffController::Clock::time_point{};
+    VardiffController vd(make_config(), t);
+    
+    EXPECT_FALSE(vd.on_tick(t + 15s).has_value());
+    auto update = vd.on_tick(t + 20s);
+    ASSERT_TRUE(update.has_value());
+    EXPECT_EQ(*update, 4u);  // 16 / MAX_STEP
+}
+
+/**
+ * @brief Test: reconfigure keeps the difficulty inside new bounds and clamps it otherwise
+ */
+TEST(VardiffTest, ReconfigureClampsToNewBounds) {
+    auto t = VardiffController::Clock::time_point{};
+    VardiffController vd(make_config(), t);
+    
+    auto config = make_config();
+    config.target_shares_per_minute = 30.0;
+    EXPECT_FALSE(vd.reconfigure(config, t + 1s).has_value());
+    EXPECT_EQ(vd.difficulty(), 16u);
+    
+    config.max_difficulty = 8;
+    auto update = vd.reconfigure(config, t + 2s);
+    ASSERT_TRUE(update.has_value());
+    EXPECT_EQ(*update, 8u);
+    // В GRACE_PERIOD shares проверяются по меньшей из двух сложностей
+    EXPECT_EQ(vd.share_difficulty(t + 3s), 8u);
+}
+
+} // namespace quaxis::tests
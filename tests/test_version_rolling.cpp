@@ -5,6 +5,7 @@
 
 #include <gtest/gtest.h>
 #include <array>
+#include <bit>
 
 #include "mining/version_rolling.hpp"
 
@@ -153,4 +154,78 @@ TEST_F(VersionRollingTest, DefaultMask) {
     EXPECT_EQ((mask >> 29) & 0x7, 0);
 }
 
+/**
+ * @brief Тест: слоты версий задания отличаются только rolling битами
+ */
+TEST_F(VersionRollingTest, AssignVersionSlots) {
+    bitcoin::BlockHeader header;
+    header.version = 0x20000004;
+    header.merkle_root.fill(0x5A);
+    header.timestamp = 1700000000;
+    header.bits = 0x1705ae3a;
+    
+    mining::Job job;
+    mining::assign_version_slots(job, header, 4);
+    ASSERT_EQ(job.version_count, 4);
+    EXPECT_EQ(job.versions[0], header.version);
+    EXPECT_EQ(job.midstate, header.compute_midstate());
+    
+    mining::VersionRollingConfig config = config_;
+    config.version_base = header.version;
+    mining::VersionRollingManager manager(config);
+    auto serialized = header.serialize();
+    
+    for (std::size_t i = 0; i < 4; ++i) {
+        EXPECT_TRUE(manager.validate_version(job.versions[i]));
+        EXPECT_EQ(manager.extract_rolling(job.versions[i]), i);
+        EXPECT_EQ(job.version_midstates[i], mining::compute_versioned_midstate(serialized, job.versions[i]));
+        EXPECT_EQ(job.slot_midstate(static_cast<uint8_t>(i)), &job.version_midstates[i]);
+    }
+    EXPECT_EQ(job.slot_midstate(4), nullptr);
+    
+    // Один слот - обычное задание
+    mining::Job plain;
+    mining::assign_version_slots(plain, header, 1);
+    EXPECT_EQ(plain.version_count, 0);
+    EXPECT_EQ(plain.slot_midstate(0), &plain.midstate);
+    EXPECT_EQ(plain.slot_midstate(1), nullptr);
+}
+
+TEST_F(VersionRollingTest, PartitionsAreDisjoint) {
+    mining::VersionRollingManager manager(config_);
+    
+    // 4 бита: 16 соседних слотов - 16 разных долей по 12 бит
+    for (uint64_t slot = 0; slot < 16; ++slot) {
+        auto partition = manager.partition(slot, 4);
+        EXPECT_EQ(partition.fixed_mask, 0x1E000000u);
+        EXPECT_EQ(partition.mask, 0x01FFE000u);
+        EXPECT_EQ(partition.fixed_bits, static_cast<uint32_t>(slot) << 25);
+        EXPECT_EQ(partition.fixed_mask | partition.mask, mining::VERSION_ROLLING_MASK_DEFAULT);
+        EXPECT_EQ(partition.fixed_mask & partition.mask, 0u);
+        
+        for (uint64_t other = slot + 1; other < 16; ++other) {
+            EXPECT_NE(manager.partition(other, 4).fixed_bits, partition.fixed_bits);
+        }
+    }
+    EXPECT_EQ(manager.partition(17, 4).fixed_bits, manager.partition(1, 4).fixed_bits);
+    
+    // Версия в доле: закреплённые биты заменены, прочие сохранены
+    auto partition = manager.partition(5, 4);
+    const uint32_t version = 0x3FFFE004;
+    EXPECT_EQ(partition.apply(version), (version & ~0x1E000000u) | (5u << 25));
+    EXPECT_TRUE(manager.validate_version(partition.apply(0x20000000)));
+    
+    // Без бит - вся маска; больше предела - VERSION_PARTITION_MAX_BITS
+    EXPECT_EQ(manager.partition(3, 0).mask, mining::VERSION_ROLLING_MASK_DEFAULT);
+    EXPECT_EQ(manager.partition(3, 0).fixed_mask, 0u);
+    EXPECT_EQ(std::popcount(manager.partition(3, 20).fixed_mask),
+              static_cast<int>(mining::VERSION_PARTITION_MAX_BITS));
+    
+    // Маска из двух бит: закрепляется не больше одного
+    auto narrow = mining::partition_version_space(0x00006000, 1, 4);
+    EXPECT_EQ(narrow.fixed_mask, 0x00004000u);
+    EXPECT_EQ(narrow.fixed_bits, 0x00004000u);
+    EXPECT_EQ(narrow.mask, 0x00002000u);
+}
+
 } // namespace quaxis::tests
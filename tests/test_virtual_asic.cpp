@@ -0,0 +1,145 @@
+/**
+ * @file test_virtual_asic.cpp
+ * @brief Тесты программного ASIC и параметров regtest
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "bitcoin/coinbase.hpp"
+#include "bitcoin/target.hpp"
+#include "core/chain/chain_registry.hpp"
+#include "mining/job_manager.hpp"
+#include "mining/share_validator.hpp"
+#include "mining/virtual_asic.hpp"
+
+namespace quaxis::tests {
+
+namespace {
+
+/// @brief Ждать условие не дольше timeout
+template <typename Predicate>
+bool wait_for(Predicate predicate, std::chrono::milliseconds timeout = std::chrono::seconds(10)) {
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (!predicate()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+} // anonymous namespace
+
+class VirtualAsicTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        Hash160 pubkey_hash{};
+        pubkey_hash.fill(0x24);
+        bitcoin::CoinbaseBuilder builder(pubkey_hash);
+
+        auto [coinbase, midstate] = builder.build_with_midstate(100, 5000000000, 0);
+        tmpl_.height = 100;
+        tmpl_.header.timestamp = 1700000000;
+        tmpl_.header.bits = core::regtest_params().difficulty.pow_limit_bits;
+        tmpl_.target = bitcoin::bits_to_target(tmpl_.header.bits);
+        tmpl_.coinbase_tx = std::move(coinbase);
+        tmpl_.coinbase_midstate = midstate;
+        tmpl_.update_extranonce(0);
+
+        manager_ = std::make_unique<mining::JobManager>(MiningConfig{}, builder);
+        validator_ = std::make_unique<mining::ShareValidator>(*manager_);
+        validator_->set_valid_block_callback(
+            [this](const mining::ValidationResult&, const bitcoin::BlockHeader&) {
+                blocks_.fetch_add(1, std::memory_order_relaxed);
+            });
+        validator_->start_workers(1);
+    }
+
+    void TearDown() override {
+        validator_->stop_workers();
+    }
+
+    bitcoin::BlockTemplate tmpl_;
+    std::unique_ptr<mining::JobManager> manager_;
+    std::unique_ptr<mining::ShareValidator> validator_;
+    std::atomic<uint64_t> blocks_{0};
+};
+
+TEST(RegtestParamsTest, MinimalDifficultyWithoutCheckpoints) {
+    const auto params = core::regtest_params(core::namecoin_params());
+    EXPECT_EQ(params.difficulty.pow_limit_bits, 0x207fffffu);
+    EXPECT_TRUE(params.difficulty.allow_min_difficulty);
+    EXPECT_TRUE(params.checkpoints.empty());
+    EXPECT_EQ(params.auxpow.start_height, 0u);
+    EXPECT_FALSE(params.testnet.has_value());
+    EXPECT_EQ(params.mainnet.default_port, 18444);
+    // Правила AuxPoW исходной сети сохраняются
+    EXPECT_EQ(params.auxpow.chain_id, core::namecoin_params().auxpow.chain_id);
+}
+
+TEST_F(VirtualAsicTest, FindsBlocksOnRegtestTarget) {
+    manager_->on_new_block(tmpl_);
+
+    mining::VirtualAsicConfig config;
+    config.threads = 2;
+    config.share_difficulty = 0.0;  // Только блоки: на regtest каждый второй хеш
+    mining::VirtualAsic asic(*manager_, *validator_, config);
+    asic.start();
+    EXPECT_TRUE(asic.is_running());
+    EXPECT_EQ(manager_->active_connection_count(), 2u);
+
+    EXPECT_TRUE(wait_for([&] { return blocks_.load() >= 10; }));
+    asic.stop();
+
+    const auto stats = asic.stats();
+    EXPECT_GT(stats.hashes, 0u);
+    EXPECT_GE(stats.shares, 10u);
+    EXPECT_EQ(stats.job_switches, 2u);
+    EXPECT_EQ(manager_->active_connection_count(), 0u);
+}
+
+TEST_F(VirtualAsicTest, SwitchesToNewBlock) {
+    mining::VirtualAsicConfig config;
+    config.threads = 3;
+    config.share_difficulty = 0.0;
+    mining::VirtualAsic asic(*manager_, *validator_, config);
+    asic.start();
+
+    // Без шаблона потоки ждут
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    EXPECT_EQ(asic.stats().hashes, 0u);
+
+    manager_->on_new_block(tmpl_);
+    const uint32_t first = manager_->job_generation();
+    ASSERT_TRUE(wait_for([&] {
+        for (const auto& entry : asic.last_switches()) {
+            if (entry.generation != first) return false;
+        }
+        return true;
+    }));
+
+    tmpl_.height = 101;
+    tmpl_.header.prev_block[0] ^= 0x01;
+    const auto published = std::chrono::steady_clock::now();
+    manager_->on_new_block(tmpl_);
+    const uint32_t second = manager_->job_generation();
+    EXPECT_NE(second, first);
+    ASSERT_TRUE(wait_for([&] {
+        for (const auto& entry : asic.last_switches()) {
+            if (entry.generation != second) return false;
+        }
+        return true;
+    }));
+    for (const auto& entry : asic.last_switches()) {
+        EXPECT_GE(entry.at, published);
+    }
+    asic.stop();
+    EXPECT_EQ(asic.stats().job_switches, 6u);
+}
+
+} // namespace quaxis::tests
@@ -0,0 +1,250 @@
+/**
+ * @file test_zmq_subscriber.cpp
+ * @brief Тесты разбора ZMQ уведомлений узла и ZmqSubscriber
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifdef QUAXIS_HAS_ZMQ
+#include <zmq.h>
+#endif
+
+#include "bitcoin/zmq_subscriber.hpp"
+
+namespace quaxis::tests {
+
+namespace {
+
+/**
+ * @brief Сериализованный блок с одной coinbase
+ *
+ * @param height_push Начало scriptSig (push высоты BIP34)
+ * @param segwit Coinbase с witness (маркер 00 01 и резерв witness)
+ */
+Bytes make_block(const bitcoin::BlockHeader& header, const Bytes& height_push, bool segwit) {
+    auto raw = header.serialize();
+    Bytes block(raw.begin(), raw.end());
+    block.push_back(0x01);  // одна транзакция
+
+    const Bytes version{0x02, 0x00, 0x00, 0x00};
+    block.insert(block.end(), version.begin(), version.end());
+    if (segwit) {
+        block.push_back(0x00);
+        block.push_back(0x01);
+    }
+    block.push_back(0x01);                   // один вход
+    block.insert(block.end(), 32, 0x00);     // prevout hash
+    block.insert(block.end(), 4, 0xFF);      // prevout index
+    Bytes script = height_push;
+    script.insert(script.end(), {0x08, 'q', 'u', 'a', 'x', 'i', 's', '!', '!'});
+    block.push_back(static_cast<uint8_t>(script.size()));
+    block.insert(block.end(), script.begin(), script.end());
+    block.insert(block.end(), 4, 0xFF);      // sequence
+
+    block.push_back(0x01);                   // один выход
+    block.insert(block.end(), {0x00, 0xF2, 0x05, 0x2A, 0x01, 0x00, 0x00, 0x00});
+    block.push_back(0x16);
+    block.push_back(0x00);
+    block.push_back(0x14);
+    block.insert(block.end(), 20, 0xAB);
+    if (segwit) {
+        block.push_back(0x01);               // witness: один элемент
+        block.push_back(0x20);
+        block.insert(block.end(), 32, 0x00);
+    }
+    block.insert(block.end(), 4, 0x00);      // locktime
+    return block;
+}
+
+bitcoin::BlockHeader make_header(uint32_t timestamp) {
+    bitcoin::BlockHeader header;
+    header.version = 0x20000000;
+    header.prev_block.fill(0x42);
+    header.merkle_root.fill(0x17);
+    header.timestamp = timestamp;
+    header.bits = 0x17034219;
+    header.nonce = 0xDEADBEEF;
+    return header;
+}
+
+} // anonymous namespace
+
+// =============================================================================
+// Разбор кадров
+// =============================================================================
+
+/**
+ * @brief Тест: rawblock даёт заголовок, хеш и высоту BIP34
+ */
+TEST(ZmqDecodeTest, DecodesSegwitRawblock) {
+    auto header = make_header(1'700'000'000);
+    // 900000 = 0x0DBBA0
+    auto block = make_block(header, {0x03, 0xA0, 0xBB, 0x0D}, true);
+
+    auto decoded = bitcoin::decode_zmq_rawblock(block);
+    ASSERT_TRUE(decoded.has_value());
+    EXPECT_EQ(decoded->height, 900'000u);
+    EXPECT_EQ(decoded->hash, header.hash());
+    EXPECT_EQ(decoded->header.prev_block, header.prev_block);
+    EXPECT_EQ(decoded->header.timestamp, header.timestamp);
+    EXPECT_EQ(decoded->header.bits, header.bits);
+    EXPECT_EQ(decoded->header.nonce, header.nonce);
+}
+
+/**
+ * @brief Тест: высоты OP_1..OP_16 и короткий push в legacy coinbase
+ */
+TEST(ZmqDecodeTest, DecodesSmallHeights) {
+    auto header = make_header(1);
+    EXPECT_EQ(bitcoin::block_coinbase_height(make_block(header, {0x51}, false)), 1u);
+    EXPECT_EQ(bitcoin::block_coinbase_height(make_block(header, {0x60}, true)), 16u);
+    EXPECT_EQ(bitcoin::block_coinbase_height(make_block(header, {0x01, 0x11}, false)), 17u);
+    EXPECT_EQ(bitcoin::block_coinbase_height(make_block(header, {0x02, 0x00, 0x01}, false)), 256u);
+}
+
+/**
+ * @brief Тест: обрезанный блок и scriptSig без высоты не разбираются
+ */
+TEST(ZmqDecodeTest, RejectsMalformedBlocks) {
+    auto header = make_header(2);
+    auto raw = header.serialize();
+    EXPECT_FALSE(bitcoin::decode_zmq_rawblock(ByteSpan(raw.data(), raw.size())).has_value());
+
+    auto block = make_block(header, {0x03, 0xA0, 0xBB, 0x0D}, true);
+    EXPECT_FALSE(bitcoin::decode_zmq_rawblock(ByteSpan(block.data(), 100)).has_value());
+
+    // OP_PUSHDATA1 вместо push высоты
+    auto no_height = make_block(header, {0x4C, 0x01, 0x00}, false);
+    EXPECT_FALSE(bitcoin::decode_zmq_rawblock(no_height).has_value());
+}
+
+/**
+ * @brief Тест: hashblock в порядке RPC и номер сообщения
+ */
+TEST(ZmqDecodeTest, DecodesHashAndSequence) {
+    Bytes body(32);
+    for (std::size_t i = 0; i < body.size(); ++i) {
+        body[i] = static_cast<uint8_t>(i);
+    }
+    auto hash = bitcoin::decode_zmq_hashblock(body);
+    ASSERT_TRUE(hash.has_value());
+    EXPECT_EQ((*hash)[0], 31);
+    EXPECT_EQ((*hash)[31], 0);
+    EXPECT_FALSE(bitcoin::decode_zmq_hashblock(ByteSpan(body.data(), 31)).has_value());
+
+    const Bytes seq{0x04, 0x03, 0x02, 0x01};
+    EXPECT_EQ(bitcoin::decode_zmq_sequence(seq), 0x01020304u);
+    EXPECT_FALSE(bitcoin::decode_zmq_sequence(ByteSpan(seq.data(), 3)).has_value());
+}
+
+// =============================================================================
+// ZmqSubscriber
+// =============================================================================
+
+#ifndef QUAXIS_HAS_ZMQ
+
+/**
+ * @brief Тест: сборка без libzmq - start() возвращает ошибку
+ */
+TEST(ZmqSubscriberTest, StartFailsWithoutLibzmq) {
+    ZmqConfig config;
+    bitcoin::ZmqSubscriber subscriber(config);
+    EXPECT_FALSE(subscriber.start().has_value());
+    EXPECT_FALSE(subscriber.is_running());
+    subscriber.stop();
+}
+
+#else
+
+namespace {
+
+void send_notification(void* socket, std::string_view topic, const Bytes& body, uint32_t seq) {
+    const uint8_t seq_le[4] = {
+        static_cast<uint8_t>(seq), static_cast<uint8_t>(seq >> 8),
+        static_cast<uint8_t>(seq >> 16), static_cast<uint8_t>(seq >> 24)};
+    zmq_send(socket, topic.data(), topic.size(), ZMQ_SNDMORE);
+    zmq_send(socket, body.data(), body.size(), ZMQ_SNDMORE);
+    zmq_send(socket, seq_le, sizeof(seq_le), 0);
+}
+
+} // anonymous namespace
+
+/**
+ * @brief Тест: rawblock от PUB узла приходит в NewBlockCallback
+ */
+TEST(ZmqSubscriberTest, DeliversRawblockFromPublisher) {
+    void* context = zmq_ctx_new();
+    void* publisher = zmq_socket(context, ZMQ_PUB);
+    ASSERT_EQ(zmq_bind(publisher, "tcp://127.0.0.1:*"), 0);
+    char endpoint[256];
+    std::size_t endpoint_size = sizeof(endpoint);
+    ASSERT_EQ(zmq_getsockopt(publisher, ZMQ_LAST_ENDPOINT, endpoint, &endpoint_size), 0);
+
+    ZmqConfig config;
+    config.enabled = true;
+    config.endpoint = endpoint;
+    config.receive_timeout_ms = 20;
+    bitcoin::ZmqSubscriber subscriber(config);
+
+    std::mutex mutex;
+    std::vector<std::pair<uint32_t, int64_t>> blocks;
+    std::vector<Hash256> hashes;
+    subscriber.set_callback([&](const bitcoin::BlockHeader&, uint32_t height,
+                                int64_t coinbase_value, bool is_speculative) {
+        EXPECT_FALSE(is_speculative);
+        std::lock_guard<std::mutex> lock(mutex);
+        blocks.emplace_back(height, coinbase_value);
+    });
+    subscriber.set_hash_callback([&](const Hash256& hash) {
+        std::lock_guard<std::mutex> lock(mutex);
+        hashes.push_back(hash);
+    });
+    ASSERT_TRUE(subscriber.start().has_value());
+
+    auto header = make_header(3);
+    auto block = make_block(header, {0x03, 0xA0, 0xBB, 0x0D}, true);
+    Hash256 hash = header.hash();
+    Bytes hash_body(hash.rbegin(), hash.rend());
+
+    // Подписка SUB устанавливается асинхронно: повторяем до первого блока
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    uint32_t seq = 0;
+    while (subscriber.blocks_received() == 0 && std::chrono::steady_clock::now() < deadline) {
+        send_notification(publisher, bitcoin::ZMQ_TOPIC_RAWBLOCK, block, seq++);
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_GT(subscriber.blocks_received(), 0u);
+
+    // Пропуск номера - потерянное уведомление
+    const uint64_t lost_before = subscriber.lost_notifications();
+    const uint64_t received = subscriber.blocks_received();
+    send_notification(publisher, bitcoin::ZMQ_TOPIC_RAWBLOCK, block, seq + 2);
+    send_notification(publisher, bitcoin::ZMQ_TOPIC_HASHBLOCK, hash_body, 0);
+    while (subscriber.blocks_received() == received && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    subscriber.stop();
+
+    EXPECT_EQ(subscriber.lost_notifications() - lost_before, 2u);
+    std::lock_guard<std::mutex> lock(mutex);
+    ASSERT_FALSE(blocks.empty());
+    EXPECT_EQ(blocks.back().first, 900'000u);
+    EXPECT_EQ(blocks.back().second, bitcoin::block_subsidy(900'001));
+    ASSERT_EQ(hashes.size(), 1u);
+    EXPECT_EQ(hashes[0], hash);
+
+    zmq_close(publisher);
+    zmq_ctx_term(context);
+}
+
+#endif // QUAXIS_HAS_ZMQ
+
+} // namespace quaxis::tests